@@ -0,0 +1,443 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Cooks glTF assets ahead of time, on a build machine, instead of the viewer cooking each one on
+// its first launch. Every asset's mesh (optimized, with meshlets and levels of detail) and every
+// one of its images (a streamed texture, BCn with all its mips) goes into the derived data cache
+// under the same keys the viewer looks them up by, so pointing both at the same shared cache
+// leaves the viewer nothing to cook.
+//
+// Assets are cooked side by side on the job system, and each asset's load spreads its buffers,
+// images and accessors over it as well. Rebuilds are incremental: an asset whose mesh and
+// textures the cache already has is skipped without being loaded, and one with only some of its
+// textures missing is loaded for those alone.
+//
+// The inputs are glTF files, directories searched for them, or lists of either with one path a
+// line (relative to the list, # comments). --pack writes everything cooked into one .rpak too,
+// as <asset>/mesh.rmesh and <asset>/textures/<image>.rtex, the asset being the file's name.
+//
+//     asset-cooker sample_assets --shared-cache //build/derived-data
+//     asset-cooker ship_assets.txt --pack build/assets.rpak
+
+#include "gltf-cook.h"
+#include "gltf-load.h"
+
+#include <rsbl-clock.h>
+#include <rsbl-derived-data-cache.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-file.h>
+#include <rsbl-jobs.h>
+#include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-pack.h>
+#include <rsbl-texture-streamer.h>
+
+#include <CLI11.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+bool is_gltf(const std::filesystem::path& path)
+{
+    const std::filesystem::path extension = path.extension();
+    return extension == ".gltf" || extension == ".glb";
+}
+
+// Every glTF under directory, sorted so a pack comes out the same whichever order the file
+// system lists them in
+void add_directory(const std::filesystem::path& directory, std::vector<std::string>& out)
+{
+    std::vector<std::string> found;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error))
+    {
+        if (entry.is_regular_file() && is_gltf(entry.path()))
+        {
+            found.push_back(entry.path().string());
+        }
+    }
+    std::sort(found.begin(), found.end());
+    out.insert(out.end(), found.begin(), found.end());
+}
+
+// A glTF or a directory of them
+bool add_path(const std::filesystem::path& path, std::vector<std::string>& out)
+{
+    if (std::filesystem::is_directory(path))
+    {
+        add_directory(path, out);
+        return true;
+    }
+    if (is_gltf(path) && std::filesystem::is_regular_file(path))
+    {
+        out.push_back(path.string());
+        return true;
+    }
+    return false;
+}
+
+// Each line a glTF or a directory, relative to the list
+bool add_list(const std::filesystem::path& list_path, std::vector<std::string>& out)
+{
+    FILE* file = fopen(list_path.string().c_str(), "r");
+    if (file == nullptr)
+    {
+        RSBL_LOG_ERROR("Failed to open {}", list_path.string());
+        return false;
+    }
+
+    const std::filesystem::path directory = list_path.parent_path();
+    bool ok = true;
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        std::string entry = line;
+        const size_t start = entry.find_first_not_of(" \t");
+        const size_t end = entry.find_last_not_of(" \t\r\n");
+        if (start == std::string::npos || end == std::string::npos || entry[start] == '#')
+        {
+            continue;
+        }
+        entry = entry.substr(start, end - start + 1);
+        if (!add_path(directory / entry, out))
+        {
+            RSBL_LOG_ERROR("{}: {} isn't a glTF or a directory", list_path.string(), entry);
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+enum class CookOutcome : uint32
+{
+    Cached, // The cache had all of it
+    Cooked,
+    Failed,
+};
+
+struct CookAsset
+{
+    std::string path;
+    // Its folder in the pack
+    std::string name;
+    rsbl::DerivedDataKey mesh;
+    // One per image, in asset.images order
+    rsbl::DynamicArray<rsbl::DerivedDataKey> textures;
+    CookOutcome outcome = CookOutcome::Failed;
+};
+
+// Whether the cache has key's artifact, fetching it from the shared cache if only that does
+bool cached(rsbl::DerivedDataCache& cache, const rsbl::DerivedDataKey& key, bool recook)
+{
+    return !recook && cache.Find(key);
+}
+
+// Writes one image's mip chain as a streamed texture into the cache
+bool cook_texture(rsbl::DerivedDataCache& cache,
+                  const rsbl::DerivedDataKey& key,
+                  rsbl::ArrayView<const rsbl::Image> mips)
+{
+    const rsbl::String temp_path = cache.TempPath();
+    if (auto written = rsbl::WriteStreamedTexture(temp_path.CStr(), mips); !written)
+    {
+        RSBL_LOG_ERROR("Failed to write a streamed texture: {}", written.FailureText());
+        return false;
+    }
+    if (auto put = cache.PutFile(key, temp_path.CStr()); !put)
+    {
+        RSBL_LOG_ERROR("Failed to add a texture to the cache: {}", put.FailureText());
+        return false;
+    }
+    return true;
+}
+
+// Cooks what the cache doesn't already have of the asset. Its textures are written on jobs of
+// their own while the mesh cooks on this one.
+CookOutcome cook_asset(rsbl::JobSystem& jobs,
+                       rsbl::DerivedDataCache& cache,
+                       CookAsset& asset,
+                       bool recook)
+{
+    rsbl::MemoryTagScope memory_scope(rsbl::MemoryTag::Asset);
+
+    auto mesh_key = gltf_mesh_key(asset.path);
+    auto texture_keys = gltf_texture_keys(asset.path);
+    if (!mesh_key || !texture_keys)
+    {
+        RSBL_LOG_ERROR("Failed to read {}: {}",
+                       asset.path,
+                       !mesh_key ? mesh_key.FailureText() : texture_keys.FailureText());
+        return CookOutcome::Failed;
+    }
+    asset.mesh = mesh_key.Value();
+    asset.textures = rsblMove(texture_keys.Value());
+
+    const bool cook_mesh = !cached(cache, asset.mesh, recook);
+    rsbl::DynamicArray<uint32> missing_textures;
+    for (uint32 i = 0; i < asset.textures.Size(); ++i)
+    {
+        if (!cached(cache, asset.textures[i], recook))
+        {
+            missing_textures.PushBack(i);
+        }
+    }
+    if (!cook_mesh && missing_textures.IsEmpty())
+    {
+        return CookOutcome::Cached;
+    }
+
+    RSBL_LOG_INFO("Cooking {}", asset.path);
+    LoadedGltf loaded;
+    GltfLoadProgress progress;
+    const GltfTextures textures =
+        missing_textures.IsEmpty() ? GltfTextures::None : GltfTextures::MipChain;
+    if (auto load = load_gltf(jobs, asset.path, loaded, progress, textures); !load)
+    {
+        RSBL_LOG_ERROR("Failed to load {}: {}", asset.path, load.FailureText());
+        return CookOutcome::Failed;
+    }
+
+    // Images that didn't decode were logged by the load, and are left out of the pack
+    std::atomic<uint32> failures{0};
+    rsbl::JobCounter textures_done;
+    for (const uint32 index : missing_textures)
+    {
+        if (loaded.textureMips[index].IsEmpty())
+        {
+            continue;
+        }
+        jobs.Submit(
+            [&, index]()
+            {
+                rsbl::MemoryTagScope job_memory_scope(rsbl::MemoryTag::Asset);
+                if (!cook_texture(cache, asset.textures[index], loaded.textureMips[index]))
+                {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+            },
+            &textures_done,
+            rsbl::JobPriority::Low);
+    }
+
+    if (cook_mesh)
+    {
+        const rsbl::String temp_path = cache.TempPath();
+        if (auto cooked = cook_gltf(loaded, temp_path.CStr(), rsbl::CookedMeshSource{}); !cooked)
+        {
+            RSBL_LOG_ERROR("Failed to cook {}: {}", asset.path, cooked.FailureText());
+            failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (auto put = cache.PutFile(asset.mesh, temp_path.CStr()); !put)
+        {
+            RSBL_LOG_ERROR("Failed to add {} to the cache: {}", asset.path, put.FailureText());
+            failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    jobs.Wait(textures_done);
+    return failures.load(std::memory_order_relaxed) == 0 ? CookOutcome::Cooked
+                                                         : CookOutcome::Failed;
+}
+
+// Copies one artifact out of the cache into the pack
+rsbl::Result<> pack_artifact(rsbl::PackWriter& writer,
+                             rsbl::DerivedDataCache& cache,
+                             const std::string& name,
+                             const rsbl::DerivedDataKey& key)
+{
+    rsbl::Result<rsbl::String> path = cache.Find(key);
+    if (!path)
+    {
+        return rsbl::PendingFailure{path.Category()};
+    }
+    rsbl::Result<rsbl::MappedFile> bytes = rsbl::MapFile(path.Value().CStr());
+    if (!bytes)
+    {
+        return rsbl::PendingFailure{bytes.Category()};
+    }
+    // Packs ship, so they're worth compressing hard
+    return writer.Add(rsbl::StringView(name.c_str()),
+                      bytes.Value().View(),
+                      rsbl::PackCompression::Lz4,
+                      rsbl::CompressionLevel::High);
+}
+
+// Packs every asset that cooked. Textures whose image didn't decode have nothing to pack.
+bool build_pack(rsbl::DerivedDataCache& cache,
+                const rsbl::DynamicArray<CookAsset>& assets,
+                const std::string& pack_path)
+{
+    auto writer = rsbl::PackWriter::Create(pack_path.c_str());
+    if (!writer)
+    {
+        RSBL_LOG_ERROR("Failed to create {}: {}", pack_path, writer.FailureText());
+        return false;
+    }
+
+    for (const CookAsset& asset : assets)
+    {
+        if (asset.outcome == CookOutcome::Failed)
+        {
+            continue;
+        }
+        const std::string mesh_name = asset.name + "/mesh.rmesh";
+        if (auto packed = pack_artifact(*writer.Value(), cache, mesh_name, asset.mesh); !packed)
+        {
+            RSBL_LOG_ERROR("Failed to pack {}: {}", mesh_name, packed.FailureText());
+            return false;
+        }
+        for (uint32 i = 0; i < asset.textures.Size(); ++i)
+        {
+            const std::string texture_name =
+                asset.name + "/textures/" + std::to_string(i) + ".rtex";
+            auto packed = pack_artifact(*writer.Value(), cache, texture_name, asset.textures[i]);
+            if (!packed && packed.Category() != rsbl::ErrorCategory::NotFound)
+            {
+                RSBL_LOG_ERROR("Failed to pack {}: {}", texture_name, packed.FailureText());
+                return false;
+            }
+        }
+    }
+
+    if (auto finished = writer.Value()->Finish(); !finished)
+    {
+        RSBL_LOG_ERROR("Failed to finish {}: {}", pack_path, finished.FailureText());
+        return false;
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    rsbl::LogInit("logs/asset_cooker.log");
+
+    CLI::App app("Asset cooker - cooks glTF meshes and textures into the derived data cache ahead "
+                 "of time, and packs them");
+
+    std::vector<std::string> inputs;
+    app.add_option("inputs", inputs, "glTF files, directories of them, or lists of either")
+        ->required();
+
+    bool recook = false;
+    app.add_flag("--recook", recook, "Cook every asset again even if the cache already has it");
+
+    std::string cache_dir = "derived-data";
+    app.add_option("--cache-dir", cache_dir, "Where cooked assets are kept on this machine");
+
+    std::string shared_cache_dir;
+    app.add_option("--shared-cache",
+                   shared_cache_dir,
+                   "A shared cache, usually a network share, to fetch cooked assets from and add "
+                   "the ones cooked here to");
+
+    bool read_only_shared = false;
+    app.add_flag("--read-only-shared-cache",
+                 read_only_shared,
+                 "Fetch from the shared cache without adding what's cooked here");
+
+    std::string pack_path;
+    app.add_option("--pack", pack_path, "Also write everything cooked into this pack");
+
+    uint32 worker_count = 0;
+    app.add_option("--workers", worker_count, "Job system workers, 0 for one per physical core");
+
+    CLI11_PARSE(app, argc, argv);
+
+    std::vector<std::string> paths;
+    bool inputs_ok = true;
+    for (const std::string& input : inputs)
+    {
+        const std::filesystem::path path(input);
+        if (!add_path(path, paths))
+        {
+            inputs_ok = add_list(path, paths) && inputs_ok;
+        }
+    }
+    if (!inputs_ok)
+    {
+        return 1;
+    }
+    if (paths.empty())
+    {
+        RSBL_LOG_ERROR("No glTF files to cook");
+        return 1;
+    }
+
+    rsbl::JobSystemOptions job_options;
+    job_options.workerCount = worker_count;
+    auto jobs_result = rsbl::JobSystem::Create(job_options);
+    if (!jobs_result)
+    {
+        RSBL_LOG_ERROR("Failed to start the job system: {}", jobs_result.FailureText());
+        return 1;
+    }
+    rsbl::JobSystem& jobs = *jobs_result.Value();
+
+    rsbl::DerivedDataCacheOptions cache_options;
+    cache_options.localDirectory = cache_dir.c_str();
+    cache_options.sharedDirectory = shared_cache_dir.empty() ? nullptr : shared_cache_dir.c_str();
+    cache_options.writeShared = !read_only_shared;
+    auto cache_result = rsbl::DerivedDataCache::Create(cache_options);
+    if (!cache_result)
+    {
+        RSBL_LOG_ERROR("Failed to open the derived data cache: {}", cache_result.FailureText());
+        return 1;
+    }
+    rsbl::DerivedDataCache& cache = *cache_result.Value();
+
+    rsbl::DynamicArray<CookAsset> assets;
+    assets.Resize(paths.size());
+    for (uint64 i = 0; i < assets.Size(); ++i)
+    {
+        assets[i].path = paths[i];
+        assets[i].name = std::filesystem::path(paths[i]).stem().string();
+    }
+
+    // One asset a chunk, so idle workers pick up whole assets while the busy ones' loads fan out
+    const uint64 start_ns = rsbl::Clock::NowNs();
+    jobs.ParallelFor(0,
+                     assets.Size(),
+                     1,
+                     [&](uint64 begin, uint64 end)
+                     {
+                         for (uint64 i = begin; i < end; ++i)
+                         {
+                             assets[i].outcome = cook_asset(jobs, cache, assets[i], recook);
+                         }
+                     });
+    const double seconds = static_cast<double>(rsbl::Clock::NowNs() - start_ns) / 1e9;
+
+    uint32 counts[3] = {};
+    for (const CookAsset& asset : assets)
+    {
+        ++counts[static_cast<uint32>(asset.outcome)];
+    }
+    RSBL_LOG_INFO("{} assets in {:.2f} s: {} cooked, {} already cached, {} failed",
+                  assets.Size(),
+                  seconds,
+                  counts[static_cast<uint32>(CookOutcome::Cooked)],
+                  counts[static_cast<uint32>(CookOutcome::Cached)],
+                  counts[static_cast<uint32>(CookOutcome::Failed)]);
+    const rsbl::DerivedDataCacheStats cache_stats = cache.Stats();
+    RSBL_LOG_INFO("Derived data cache: {} local hits, {} shared hits, {} cooked, {} failed to "
+                  "copy to the shared cache",
+                  cache_stats.localHits,
+                  cache_stats.sharedHits,
+                  cache_stats.puts,
+                  cache_stats.sharedPutFailures);
+
+    bool failed = counts[static_cast<uint32>(CookOutcome::Failed)] != 0;
+    if (!pack_path.empty())
+    {
+        failed = !build_pack(cache, assets, pack_path) || failed;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "gltf-benchmark.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-perf-report.h>
+#include <rsbl-sort.h>
+
+#include <cstdio>
+
+namespace
+{
+double to_ms(uint64 ns)
+{
+    return static_cast<double>(ns) / 1'000'000.0;
+}
+
+// The sorted time below which p percent of the frames are
+uint64 nearest_rank(rsbl::ArrayView<const uint64> sorted, uint32 p)
+{
+    const uint64 rank = (sorted.Size() * p + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// The frame times as milliseconds, with the nearest rank tails the log shows
+void add_frame_metric(rsbl::PerfReport& perf,
+                      const char* name,
+                      rsbl::ArrayView<const uint64> frame_ns,
+                      const FrameTimeStats& stats)
+{
+    rsbl::DynamicArray<double> frame_ms;
+    frame_ms.Reserve(frame_ns.Size());
+    for (const uint64 ns : frame_ns)
+    {
+        frame_ms.PushBack(to_ms(ns));
+    }
+    rsbl::PerfMetric& metric = perf.AddSamples(name, rsbl::PerfUnit::Milliseconds, frame_ms);
+    metric.AddAttribute("meanMs", stats.meanMs);
+    metric.AddAttribute("p95Ms", stats.p95Ms);
+    metric.AddAttribute("p99Ms", stats.p99Ms);
+}
+} // namespace
+
+FrameTimeStats frame_time_stats(rsbl::ArrayView<const uint64> frame_ns)
+{
+    FrameTimeStats stats;
+    stats.frames = frame_ns.Size();
+    if (frame_ns.IsEmpty())
+    {
+        return stats;
+    }
+
+    rsbl::DynamicArray<uint64> sorted;
+    sorted.ResizeUninitialized(frame_ns.Size());
+    uint64 total = 0;
+    for (uint64 i = 0; i < frame_ns.Size(); ++i)
+    {
+        sorted[i] = frame_ns[i];
+        total += frame_ns[i];
+    }
+    rsbl::RadixSort(rsbl::ArrayView<uint64>(sorted));
+
+    stats.minMs = to_ms(sorted[0]);
+    stats.meanMs = to_ms(total) / static_cast<double>(frame_ns.Size());
+    stats.p50Ms = to_ms(nearest_rank(sorted, 50));
+    stats.p95Ms = to_ms(nearest_rank(sorted, 95));
+    stats.p99Ms = to_ms(nearest_rank(sorted, 99));
+    stats.maxMs = to_ms(sorted[sorted.Size() - 1]);
+    return stats;
+}
+
+void log_benchmark_report(const BenchmarkReport& report)
+{
+    const FrameTimeStats& cpu = report.cpu;
+    RSBL_LOG_INFO("Benchmark: {} frames after {} warmup ({} backend){}",
+                  cpu.frames,
+                  report.warmupFrames,
+                  report.backend,
+                  report.complete ? "" : ", stopped early");
+    RSBL_LOG_INFO("  CPU frame ms: min {:.3f} mean {:.3f} p50 {:.3f} p95 {:.3f} p99 {:.3f} "
+                  "max {:.3f}",
+                  cpu.minMs,
+                  cpu.meanMs,
+                  cpu.p50Ms,
+                  cpu.p95Ms,
+                  cpu.p99Ms,
+                  cpu.maxMs);
+    const FrameTimeStats& gpu = report.gpu;
+    if (gpu.frames > 0)
+    {
+        RSBL_LOG_INFO("  GPU frame ms: min {:.3f} mean {:.3f} p50 {:.3f} p95 {:.3f} p99 {:.3f} "
+                      "max {:.3f} ({} frames)",
+                      gpu.minMs,
+                      gpu.meanMs,
+                      gpu.p50Ms,
+                      gpu.p95Ms,
+                      gpu.p99Ms,
+                      gpu.maxMs,
+                      gpu.frames);
+    }
+    RSBL_LOG_INFO("  Interactive after {:.2f} ms, loaded after {:.2f} ms",
+                  report.interactiveMs,
+                  report.loadedMs);
+}
+
+rsbl::Result<> write_benchmark_report(const char* path, const BenchmarkReport& report)
+{
+    rsbl::PerfReport perf("gltf-viewer", "frame");
+    perf.SetConfig("file", report.file);
+    perf.SetConfig("backend", report.backend);
+    perf.SetConfigNumber("warmupFrames", report.warmupFrames);
+    perf.SetConfigFlag("complete", report.complete);
+
+    add_frame_metric(perf, "cpuFrameMs", report.cpuFrameNs, report.cpu);
+    if (report.gpu.frames > 0)
+    {
+        add_frame_metric(perf, "gpuFrameMs", report.gpuFrameNs, report.gpu);
+    }
+    perf.AddValue("load/interactiveMs", rsbl::PerfUnit::Milliseconds, report.interactiveMs);
+    perf.AddValue("load/loadedMs", rsbl::PerfUnit::Milliseconds, report.loadedMs);
+
+    for (uint32 i = 0; i < static_cast<uint32>(rsbl::MemoryTag::Count); ++i)
+    {
+        const rsbl::MemoryTag tag = static_cast<rsbl::MemoryTag>(i);
+        const rsbl::MemoryStats stats = rsbl::GetMemoryStats(tag);
+        const char* name = rsbl::MemoryTagName(tag);
+        char key[96];
+        snprintf(key, sizeof(key), "memory/%s/peakBytes", name);
+        perf.AddValue(key, rsbl::PerfUnit::Bytes, static_cast<double>(stats.peakBytes));
+        snprintf(key, sizeof(key), "memory/%s/peakFrameBytes", name);
+        perf.AddValue(key, rsbl::PerfUnit::Bytes, static_cast<double>(stats.peakFrameBytes));
+        snprintf(key, sizeof(key), "memory/%s/peakFrameAllocations", name);
+        perf.AddValue(
+            key, rsbl::PerfUnit::Count, static_cast<double>(stats.peakFrameAllocations));
+    }
+    return perf.Write(path);
+}
@@ -0,0 +1,53 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-int-types.h>
+#include <rsbl-result.h>
+
+// Benchmark mode: once the scene is fully loaded, the viewer runs a fixed number of warmup
+// frames, then times a fixed number of frames and quits. Each frame spins the scene's roots by
+// an angle that depends only on the frame number, so every frame updates every transform and two
+// runs on the same machine do the same work. The report has the frame time distribution, how
+// long the load stages took, and each memory tag's peaks, in the layout every benchmark writes,
+// see rsbl-perf-report.h.
+
+struct FrameTimeStats
+{
+    uint64 frames = 0;
+    double minMs = 0.0;
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+// Percentiles are nearest rank, so each one is a frame time that was actually measured
+FrameTimeStats frame_time_stats(rsbl::ArrayView<const uint64> frame_ns);
+
+struct BenchmarkReport
+{
+    const char* file = "";
+    const char* backend = "";
+    uint32 warmupFrames = 0;
+    // Fewer frames than asked for when the window was closed early
+    bool complete = false;
+    FrameTimeStats cpu;
+    // The frames' outermost GPU zone. No frames on the null backend, or without timestamps.
+    FrameTimeStats gpu;
+    // Each timed frame's, that the stats came from
+    rsbl::ArrayView<const uint64> cpuFrameNs;
+    rsbl::ArrayView<const uint64> gpuFrameNs;
+    // From the start of loading
+    double interactiveMs = 0.0;
+    double loadedMs = 0.0;
+};
+
+void log_benchmark_report(const BenchmarkReport& report);
+
+// Writes the report as JSON, with every memory tag's peaks as of the call. There's no
+// "gpuFrameMs" metric when there were no GPU frame times.
+rsbl::Result<> write_benchmark_report(const char* path, const BenchmarkReport& report);
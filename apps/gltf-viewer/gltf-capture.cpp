@@ -0,0 +1,200 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "gltf-capture.h"
+
+#include <rsbl-file.h>
+
+#include <cstdio>
+
+namespace
+{
+// Frames of the swapchain's size the ring has room for, enough to cover the frames in flight
+// with some to spare for a slow disk
+constexpr uint64 kCapturedFrames = 6;
+constexpr uint64 kMinRingSize = 16ull << 20;
+
+// Matches what GaReadbackAsync pads rows to
+constexpr uint64 kRowPitchAlignment = 256;
+
+constexpr uint32 kTgaHeaderSize = 18;
+
+bool is_bgra(rsbl::gaFormat format)
+{
+    return format == rsbl::gaFormat::B8G8R8A8Unorm || format == rsbl::gaFormat::B8G8R8A8Srgb;
+}
+
+bool is_rgba(rsbl::gaFormat format)
+{
+    return format == rsbl::gaFormat::R8G8B8A8Unorm || format == rsbl::gaFormat::R8G8B8A8Srgb;
+}
+
+// Uncompressed true colour, 24 bits, top row first. Alpha is left out, nothing composites the
+// back buffer with it.
+rsbl::Result<> write_tga(const char* path,
+                         const FrameCapture::Pending& frame,
+                         rsbl::ByteView pixels,
+                         uint32 row_pitch)
+{
+    uint8 header[kTgaHeaderSize] = {};
+    header[2] = 2; // Uncompressed true colour
+    header[12] = static_cast<uint8>(frame.width);
+    header[13] = static_cast<uint8>(frame.width >> 8);
+    header[14] = static_cast<uint8>(frame.height);
+    header[15] = static_cast<uint8>(frame.height >> 8);
+    header[16] = 24;
+    header[17] = 0x20; // Top left origin
+
+    // BGR, which is the back buffer's order on Vulkan and a swap of it on DX12
+    const uint32 red = is_bgra(frame.format) ? 2 : 0;
+    rsbl::DynamicArray<uint8> bytes;
+    bytes.ResizeUninitialized(uint64(frame.width) * frame.height * 3);
+    uint8* out = bytes.Data();
+    for (uint32 y = 0; y < frame.height; ++y)
+    {
+        const uint8* row = pixels.Data() + uint64(y) * row_pitch;
+        for (uint32 x = 0; x < frame.width; ++x)
+        {
+            const uint8* texel = row + x * 4;
+            out[0] = texel[2 - red];
+            out[1] = texel[1];
+            out[2] = texel[red];
+            out += 3;
+        }
+    }
+
+    auto file = rsbl::OpenFile(path, rsbl::FileOpenMode::Write);
+    if (!file)
+    {
+        return rsbl::PendingFailure{file.Category()};
+    }
+    const rsbl::ByteView buffers[] = {rsbl::AsBytes(header, sizeof(header)),
+                                      rsbl::AsBytes(rsbl::ArrayView(bytes))};
+    auto written = rsbl::WriteFileGather(file.Value(), buffers);
+    rsbl::Result<> closed = rsbl::CloseFile(file.Value());
+    if (!written)
+    {
+        return rsbl::PendingFailure{written.Category()};
+    }
+    return closed;
+}
+} // namespace
+
+rsbl::Result<> create_frame_capture(rsbl::gaDevice* device,
+                                    const rsbl::gaSwapchain* swapchain,
+                                    FrameCapture& capture)
+{
+    if (device->backend == rsbl::gaBackend::Null)
+    {
+        return "The null backend draws no pixels to capture";
+    }
+    if (!is_bgra(swapchain->format) && !is_rgba(swapchain->format))
+    {
+        return "Captures need an 8-bit RGBA or BGRA swapchain";
+    }
+
+    if (capture.everyFrame)
+    {
+        if (auto made = rsbl::MakeDirectory(capture.path.c_str()); !made)
+        {
+            return rsbl::PendingFailure{made.Category()};
+        }
+    }
+
+    const uint64 row_pitch = (uint64(swapchain->width) * 4 + kRowPitchAlignment - 1) /
+                             kRowPitchAlignment * kRowPitchAlignment;
+    const uint64 frame_size = row_pitch * swapchain->height;
+    rsbl::gaReadbackRingCreateInfo ring_info{device};
+    ring_info.size =
+        frame_size * kCapturedFrames > kMinRingSize ? frame_size * kCapturedFrames : kMinRingSize;
+    auto ring = rsbl::GaCreateReadbackRing(ring_info);
+    if (!ring)
+    {
+        return rsbl::PendingFailure{ring.Category()};
+    }
+    capture.ring = ring.Value();
+    return rsbl::ResultCode::Success;
+}
+
+void destroy_frame_capture(FrameCapture& capture)
+{
+    rsbl::GaDestroyReadbackRing(capture.ring);
+    capture.ring = nullptr;
+}
+
+rsbl::Result<> capture_back_buffer(FrameCapture& capture, rsbl::gaSwapchain* swapchain)
+{
+    if (capture.ring == nullptr || !capture.armed || swapchain->backBuffer == nullptr)
+    {
+        return rsbl::ResultCode::Success;
+    }
+
+    rsbl::gaReadbackTexture back_buffer{};
+    back_buffer.texture = swapchain->backBuffer;
+    back_buffer.format = swapchain->format;
+    back_buffer.width = swapchain->width;
+    back_buffer.height = swapchain->height;
+    back_buffer.state = rsbl::gaResourceState::Present;
+    auto future = rsbl::GaReadbackAsync(capture.ring, back_buffer);
+    if (!future)
+    {
+        // The files are behind, or the window grew past what the ring was made for
+        ++capture.skipped;
+        return rsbl::ResultCode::Success;
+    }
+    capture.pending.PushBack(
+        {future.Value(), swapchain->width, swapchain->height, swapchain->format});
+    ++capture.captured;
+    capture.armed = capture.everyFrame;
+    return rsbl::GaFlushReadbacks(capture.ring);
+}
+
+rsbl::Result<> write_captures(FrameCapture& capture, bool wait)
+{
+    uint64 done = 0;
+    rsbl::Result<> result = rsbl::ResultCode::Success;
+    while (done < capture.pending.Size())
+    {
+        const FrameCapture::Pending& frame = capture.pending[done];
+        auto pixels = rsbl::GaGetReadbackData(capture.ring, frame.future, wait);
+        if (!pixels)
+        {
+            // The rest were copied after it, they aren't done either
+            if (pixels.Category() != rsbl::ErrorCategory::Timeout)
+            {
+                result = rsbl::PendingFailure{pixels.Category()};
+            }
+            break;
+        }
+
+        const char* path = capture.path.c_str();
+        char numbered[1024];
+        if (capture.everyFrame)
+        {
+            snprintf(numbered,
+                     sizeof(numbered),
+                     "%s/frame_%06llu.tga",
+                     path,
+                     static_cast<unsigned long long>(capture.written));
+            path = numbered;
+        }
+        rsbl::Result<> written = write_tga(path, frame, pixels.Value(), frame.future.rowPitch);
+        rsbl::GaReleaseReadback(capture.ring, frame.future);
+        ++done;
+        if (!written)
+        {
+            result = rsbl::PendingFailure{written.Category()};
+            break;
+        }
+        ++capture.written;
+    }
+
+    // Only a few are ever waiting, moving them up keeps the array from growing
+    const uint64 left = capture.pending.Size() - done;
+    for (uint64 i = 0; i < left; ++i)
+    {
+        capture.pending[i] = capture.pending[done + i];
+    }
+    capture.pending.Resize(left);
+    return result;
+}
@@ -0,0 +1,57 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-ga.h>
+#include <rsbl-int-types.h>
+#include <rsbl-result.h>
+
+#include <string>
+
+// Captures: --capture writes every frame shown to a directory, numbered, as a video's frames,
+// and --screenshot writes the first frame drawn with the scene loaded, for visual tests and
+// machines with no one watching the screen. The back buffer is copied into a readback ring after
+// the frame's submit, and written out a few frames later once the copy is done, so capturing
+// costs the frames a copy on the GPU and a file write, and never waits for the GPU. When
+// the files can't keep up the ring fills and frames are skipped rather than waited for.
+//
+// Files are uncompressed 24-bit TGAs, top row first, which nearly everything opens.
+
+struct FrameCapture
+{
+    rsbl::gaReadbackRing* ring = nullptr;
+    // The directory every frame goes to, or the screenshot's file
+    std::string path;
+    bool everyFrame = false;
+    // The next frame's back buffer is read back
+    bool armed = false;
+
+    struct Pending
+    {
+        rsbl::gaReadbackFuture future;
+        uint32 width;
+        uint32 height;
+        rsbl::gaFormat format;
+    };
+    rsbl::DynamicArray<Pending> pending; // Oldest first
+
+    uint64 captured = 0; // Read back so far
+    uint64 written = 0;  // Which numbers the files
+    uint64 skipped = 0; // No room in the ring
+};
+
+// Fails on the null backend, whose swapchain has no pixels, and on back buffers in a format a
+// TGA can't hold. The ring holds a few frames of the swapchain's size.
+rsbl::Result<> create_frame_capture(rsbl::gaDevice* device,
+                                    const rsbl::gaSwapchain* swapchain,
+                                    FrameCapture& capture);
+void destroy_frame_capture(FrameCapture& capture);
+
+// Between the frame's submit and its present, with the back buffer in Present: queues its
+// readback when armed, and disarms a screenshot
+rsbl::Result<> capture_back_buffer(FrameCapture& capture, rsbl::gaSwapchain* swapchain);
+
+// Writes the captures the GPU is done with, oldest first. wait waits for the rest, at exit.
+rsbl::Result<> write_captures(FrameCapture& capture, bool wait);
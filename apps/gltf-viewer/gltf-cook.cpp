@@ -0,0 +1,258 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "gltf-cook.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-file.h>
+#include <rsbl-function.h>
+#include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-texture-streamer.h>
+
+#include <fastgltf/core.hpp>
+#include <fastgltf/tools.hpp>
+
+#include <filesystem>
+#include <variant>
+
+namespace
+{
+// Part of the cache key, changing them cooks everything again
+constexpr rsbl::MeshCookerOptions kCookerOptions = {};
+
+rsbl::MeshNodeInput to_node_input(const fastgltf::Node& node)
+{
+    fastgltf::math::fvec3 translation(0.0f);
+    fastgltf::math::fquat rotation(0.0f, 0.0f, 0.0f, 1.0f);
+    fastgltf::math::fvec3 scale(1.0f);
+    if (const auto* trs = std::get_if<fastgltf::TRS>(&node.transform))
+    {
+        translation = trs->translation;
+        rotation = trs->rotation;
+        scale = trs->scale;
+    }
+    else if (const auto* matrix = std::get_if<fastgltf::math::fmat4x4>(&node.transform))
+    {
+        fastgltf::math::decomposeTransformMatrix(*matrix, scale, rotation, translation);
+    }
+
+    rsbl::MeshNodeInput input;
+    input.translation = rsbl::float3(translation[0], translation[1], translation[2]);
+    input.rotation = rsbl::float4(rotation[0], rotation[1], rotation[2], rotation[3]);
+    input.scale = rsbl::float3(scale[0], scale[1], scale[2]);
+    input.mesh = node.meshIndex.has_value() ? static_cast<int32>(*node.meshIndex) : -1;
+    return input;
+}
+
+// Depth first, so every parent is added before its children
+rsbl::Result<> add_node_tree(const fastgltf::Asset& asset,
+                             size_t node_index,
+                             int32 parent,
+                             rsbl::MeshCooker& cooker)
+{
+    const fastgltf::Node& node = asset.nodes[node_index];
+    rsbl::MeshNodeInput input = to_node_input(node);
+    input.parent = parent;
+
+    rsbl::Result<uint32> added = cooker.AddNode(input);
+    if (!added)
+    {
+        return rsbl::PendingFailure{added.Category()};
+    }
+    for (const size_t child : node.children)
+    {
+        rsbl::Result<> child_added =
+            add_node_tree(asset, child, static_cast<int32>(added.Value()), cooker);
+        if (!child_added)
+        {
+            return child_added;
+        }
+    }
+    return rsbl::ResultCode::Success;
+}
+
+// The file an external source points at, empty for anything else
+std::string external_path(const fastgltf::DataSource& source, const std::filesystem::path& dir)
+{
+    const auto* uri = std::get_if<fastgltf::sources::URI>(&source);
+    if (uri == nullptr || !uri->uri.isLocalPath())
+    {
+        return {};
+    }
+    return (dir / uri->uri.fspath()).string();
+}
+
+// Hashes the glTF file and every external buffer it points at into builder. A .glb carries its
+// buffers, a .gltf usually points at .bin files next to it. Reading the JSON for the buffer
+// list is all the parsing it does, nothing is decoded; with_asset gets what was parsed, for
+// anything else a key needs of it.
+rsbl::Result<> hash_gltf_sources(
+    const std::string& file_path,
+    rsbl::DerivedDataKeyBuilder& builder,
+    rsbl::FunctionRef<rsbl::Result<>(const fastgltf::Asset&, const std::filesystem::path&)>
+        with_asset)
+{
+    rsbl::Result<rsbl::MappedFile> source = rsbl::MapFile(file_path.c_str());
+    if (!source)
+    {
+        return rsbl::PendingFailure{source.Category()};
+    }
+    builder.Add(source.Value().View());
+
+    auto data = fastgltf::GltfDataBuffer::FromBytes(
+        reinterpret_cast<const std::byte*>(source.Value().View().Data()),
+        source.Value().View().Size());
+    if (data.error() != fastgltf::Error::None)
+    {
+        return {rsbl::ErrorCategory::Io, "Failed to read glTF"};
+    }
+    const std::filesystem::path directory = std::filesystem::path(file_path).parent_path();
+    fastgltf::Parser parser;
+    auto asset = parser.loadGltf(data.get(), directory, fastgltf::Options::None);
+    if (asset.error() != fastgltf::Error::None)
+    {
+        return {rsbl::ErrorCategory::InvalidArgument, "Failed to parse glTF"};
+    }
+
+    for (const fastgltf::Buffer& buffer : asset->buffers)
+    {
+        const std::string buffer_path = external_path(buffer.data, directory);
+        if (buffer_path.empty())
+        {
+            continue;
+        }
+        rsbl::Result<rsbl::MappedFile> bytes = rsbl::MapFile(buffer_path.c_str());
+        if (!bytes)
+        {
+            return rsbl::PendingFailure{bytes.Category()};
+        }
+        builder.Add(bytes.Value().View());
+    }
+    return with_asset(asset.get(), directory);
+}
+} // namespace
+
+rsbl::Result<> cook_gltf(const LoadedGltf& loaded,
+                         const char* cooked_path,
+                         const rsbl::CookedMeshSource& source)
+{
+    rsbl::MemoryTagScope memory_scope(rsbl::MemoryTag::Asset);
+
+    rsbl::Result<rsbl::UniquePtr<rsbl::MeshCooker>> cooker =
+        rsbl::MeshCooker::Create(kCookerOptions);
+    if (!cooker)
+    {
+        return rsbl::PendingFailure{cooker.Category()};
+    }
+
+    // The primitives are in mesh order, every mesh gets its index even if none of its
+    // primitives made it, so nodes still point at the right one
+    const fastgltf::Asset& asset = loaded.asset;
+    uint64 next = 0;
+    for (size_t mesh_index = 0; mesh_index < asset.meshes.size(); ++mesh_index)
+    {
+        cooker.Value()->BeginMesh();
+        for (; next < loaded.primitives.Size() && loaded.primitives[next].mesh == mesh_index;
+             ++next)
+        {
+            const LoadedPrimitive& primitive = loaded.primitives[next];
+            rsbl::MeshPrimitiveInput input;
+            input.positions = primitive.positions;
+            input.normals = primitive.normals;
+            input.tangents = primitive.tangents;
+            input.uvs = primitive.uvs;
+            input.indices = primitive.indices;
+            input.material = primitive.material;
+
+            rsbl::Result<> added = cooker.Value()->AddPrimitive(input);
+            if (!added)
+            {
+                return added;
+            }
+        }
+    }
+
+    // The default scene, or the first one. A glTF without scenes has nothing to place.
+    if (!asset.scenes.empty())
+    {
+        const size_t scene_index = asset.defaultScene.has_value() ? *asset.defaultScene : 0;
+        for (const size_t root : asset.scenes[scene_index].nodeIndices)
+        {
+            rsbl::Result<> added = add_node_tree(asset, root, -1, *cooker.Value());
+            if (!added)
+            {
+                return added;
+            }
+        }
+    }
+
+    const rsbl::MeshCookerStats& stats = cooker.Value()->Stats();
+    RSBL_LOG_INFO("Reordered {} triangles: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+                  stats.after.triangles,
+                  stats.before.Acmr(),
+                  stats.after.Acmr(),
+                  stats.before.Atvr(),
+                  stats.after.Atvr());
+    RSBL_LOG_INFO("Merged {} duplicate vertices, dropped {} unused",
+                  stats.duplicateVertices,
+                  stats.unusedVertices);
+    RSBL_LOG_INFO("Simplified {} levels of detail, {} triangles between them",
+                  stats.lodLevels,
+                  stats.lodTriangles);
+
+    return cooker.Value()->Write(cooked_path, source);
+}
+
+rsbl::Result<rsbl::DerivedDataKey> gltf_mesh_key(const std::string& file_path)
+{
+    rsbl::MemoryTagScope memory_scope(rsbl::MemoryTag::Asset);
+
+    rsbl::DerivedDataKeyBuilder builder("gltf-mesh", rsbl::kCookedMeshVersion);
+    builder.AddValue(kCookerOptions);
+    rsbl::Result<> hashed = hash_gltf_sources(
+        file_path, builder, [](const fastgltf::Asset&, const std::filesystem::path&) {
+            return rsbl::Result<>(rsbl::ResultCode::Success);
+        });
+    if (!hashed)
+    {
+        return rsbl::PendingFailure{hashed.Category()};
+    }
+    return builder.Finish();
+}
+
+rsbl::Result<rsbl::DynamicArray<rsbl::DerivedDataKey>> gltf_texture_keys(
+    const std::string& file_path)
+{
+    rsbl::MemoryTagScope memory_scope(rsbl::MemoryTag::Asset);
+
+    rsbl::DerivedDataKeyBuilder builder("gltf-texture", rsbl::kStreamedTextureVersion);
+    rsbl::DynamicArray<rsbl::DerivedDataKey> keys;
+    const auto add_images = [&](const fastgltf::Asset& asset,
+                                const std::filesystem::path& directory) -> rsbl::Result<> {
+        keys.Reserve(asset.images.size());
+        for (uint32 i = 0; i < asset.images.size(); ++i)
+        {
+            rsbl::DerivedDataKeyBuilder image_builder = builder;
+            image_builder.AddValue(i);
+            const std::string image_path = external_path(asset.images[i].data, directory);
+            if (!image_path.empty())
+            {
+                rsbl::Result<rsbl::MappedFile> bytes = rsbl::MapFile(image_path.c_str());
+                if (!bytes)
+                {
+                    return rsbl::PendingFailure{bytes.Category()};
+                }
+                image_builder.Add(bytes.Value().View());
+            }
+            keys.PushBack(image_builder.Finish());
+        }
+        return rsbl::ResultCode::Success;
+    };
+    rsbl::Result<> hashed = hash_gltf_sources(file_path, builder, add_images);
+    if (!hashed)
+    {
+        return rsbl::PendingFailure{hashed.Category()};
+    }
+    return keys;
+}
@@ -0,0 +1,32 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "gltf-load.h"
+
+#include <rsbl-cooked-mesh.h>
+#include <rsbl-derived-data-cache.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-result.h>
+
+#include <fastgltf/types.hpp>
+
+#include <string>
+
+// Turns a loaded glTF into a .rmesh: every triangle primitive load_gltf converted, and the
+// default scene's node tree
+rsbl::Result<> cook_gltf(const LoadedGltf& loaded,
+                         const char* cooked_path,
+                         const rsbl::CookedMeshSource& source);
+
+// The derived data key of the glTF's cooked meshes: the cooker's version and settings, the glTF
+// file's bytes and those of every external buffer it points at. Reading the JSON for the buffer
+// list is all the parsing it does, nothing is decoded.
+rsbl::Result<rsbl::DerivedDataKey> gltf_mesh_key(const std::string& file_path);
+
+// The derived data keys of the glTF's streamed textures, one per image in asset.images order: the
+// streamed texture version, the glTF and its buffers as for the meshes (the JSON decides each
+// image's format), the image's index and the bytes of its own file when it has one
+rsbl::Result<rsbl::DynamicArray<rsbl::DerivedDataKey>> gltf_texture_keys(
+    const std::string& file_path);
@@ -0,0 +1,551 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Loads every asset in asset_listing.toml both ways the viewer can: from the glTF, through each
+// load stage and the cook, and from the cooked mesh that produced. Each asset runs a few times
+// and keeps the median of each timing, plus the peak memory of each path. The report is in the
+// layout every benchmark writes, see rsbl-perf-report.h, with a metric per "<asset>/<metric>"
+// that keeps every run's time. --baseline reads one back in: a metric more than --threshold
+// percent over its baseline fails the run, so a startup regression is a nonzero exit rather
+// than something noticed in production. scripts/compare_perf.py compares two reports with a
+// significance test instead, for runs too noisy for a flat threshold.
+//
+//     gltf-load-bench --report baseline.json
+//     gltf-load-bench --baseline baseline.json --threshold 15
+
+#include "gltf-cook.h"
+#include "gltf-load.h"
+
+#include <rsbl-clock.h>
+#include <rsbl-cooked-mesh.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-file.h>
+#include <rsbl-jobs.h>
+#include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-perf-report.h>
+
+#include <CLI11.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+namespace
+{
+// One [[assets]] entry of asset_listing.toml
+struct ListedAsset
+{
+    std::string name;
+    std::string type = "glb";
+    std::string category = "uncategorized"; // What scripts/download_assets.py defaults to
+};
+
+// Reads just the key = "value" lines of each [[assets]] table, all the listing uses
+rsbl::Result<rsbl::DynamicArray<ListedAsset>> read_asset_listing(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        return {rsbl::ErrorCategory::NotFound, "Failed to open the asset listing"};
+    }
+
+    rsbl::DynamicArray<ListedAsset> assets;
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        const char* start = line;
+        while (*start == ' ' || *start == '\t')
+        {
+            ++start;
+        }
+        if (strncmp(start, "[[assets]]", 10) == 0)
+        {
+            assets.EmplaceBack();
+            continue;
+        }
+
+        char key[64];
+        char value[512];
+        if (assets.IsEmpty() || sscanf(start, "%63[a-z_] = \"%511[^\"]\"", key, value) != 2)
+        {
+            continue;
+        }
+        ListedAsset& asset = assets[assets.Size() - 1];
+        if (strcmp(key, "name") == 0)
+        {
+            asset.name = value;
+        }
+        else if (strcmp(key, "type") == 0)
+        {
+            asset.type = value;
+        }
+        else if (strcmp(key, "category") == 0)
+        {
+            asset.category = value;
+        }
+    }
+    fclose(file);
+    return assets;
+}
+
+// Where scripts/download_assets.py put it: <dir>/<category>/<name>/, a .glb named after the
+// asset, or whichever .gltf the directory has. Empty when it hasn't been downloaded.
+std::string find_asset_file(const std::string& assets_dir, const ListedAsset& asset)
+{
+    const std::filesystem::path directory =
+        std::filesystem::path(assets_dir) / asset.category / asset.name;
+    if (asset.type == "glb")
+    {
+        const std::filesystem::path file = directory / (asset.name + ".glb");
+        return std::filesystem::exists(file) ? file.string() : std::string();
+    }
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (entry.path().extension() == ".gltf")
+        {
+            return entry.path().string();
+        }
+    }
+    return std::string();
+}
+
+// For --cold: the glTF and everything next to it, its buffers and images, out of the OS cache
+void drop_asset_from_cache(const std::string& file_path)
+{
+    std::error_code error;
+    const std::filesystem::path directory = std::filesystem::path(file_path).parent_path();
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (entry.is_regular_file())
+        {
+            rsbl::Result<> dropped = rsbl::DropFileCache(entry.path().string().c_str());
+            rsblUnused(dropped);
+        }
+    }
+}
+
+double ns_to_ms(uint64 ns)
+{
+    return static_cast<double>(ns) / 1'000'000.0;
+}
+
+struct MemoryMark
+{
+    uint64 live[static_cast<uint32>(rsbl::MemoryTag::Count)] = {};
+};
+
+// Peaks start over from what's live now
+MemoryMark start_memory_peak()
+{
+    rsbl::ResetMemoryPeaks();
+    MemoryMark mark;
+    for (uint32 i = 0; i < static_cast<uint32>(rsbl::MemoryTag::Count); ++i)
+    {
+        mark.live[i] = rsbl::GetMemoryStats(static_cast<rsbl::MemoryTag>(i)).liveBytes;
+    }
+    return mark;
+}
+
+// How far over what was live at the mark memory went since, summed over the tags
+uint64 peak_bytes_since(const MemoryMark& mark)
+{
+    uint64 peak = 0;
+    for (uint32 i = 0; i < static_cast<uint32>(rsbl::MemoryTag::Count); ++i)
+    {
+        const rsbl::MemoryStats stats = rsbl::GetMemoryStats(static_cast<rsbl::MemoryTag>(i));
+        peak += stats.peakBytes > mark.live[i] ? stats.peakBytes - mark.live[i] : 0;
+    }
+    return peak;
+}
+
+// What's measured, in the order it's reported. Times are medians over the runs, bytes the
+// biggest of them.
+enum class Metric : uint32
+{
+    ReadMs,
+    ParseMs,
+    BuffersMs,
+    ImagesMs,
+    TexturesMs,
+    AccessorsMs,
+    CookMs,
+    GltfTotalMs,
+    GltfPeakBytes,
+    CookedOpenMs,
+    CookedLoadMs,
+    CookedPeakBytes,
+    Count,
+};
+
+constexpr const char* kMetricNames[] = {
+    "gltf.readMs",
+    "gltf.parseMs",
+    "gltf.buffersMs",
+    "gltf.imagesMs",
+    "gltf.texturesMs",
+    "gltf.accessorsMs",
+    "gltf.cookMs",
+    "gltf.totalMs",
+    "gltf.peakBytes",
+    "cooked.openMs",
+    "cooked.loadMs",
+    "cooked.peakBytes",
+};
+static_assert(sizeof(kMetricNames) / sizeof(kMetricNames[0]) ==
+              static_cast<uint32>(Metric::Count));
+
+bool is_bytes(Metric metric)
+{
+    return metric == Metric::GltfPeakBytes || metric == Metric::CookedPeakBytes;
+}
+
+using RunMetrics = double[static_cast<uint32>(Metric::Count)];
+
+double stage_ms(const GltfLoadProgress& progress, GltfLoadStage stage)
+{
+    const GltfLoadProgress::Stage& timing = progress[stage];
+    const uint64 end = timing.endNs.load(std::memory_order_acquire);
+    return end > timing.startNs ? ns_to_ms(end - timing.startNs) : 0.0;
+}
+
+// One load from the glTF, cooked to cooked_path, then one from what that cooked
+bool run_once(rsbl::JobSystem& jobs,
+              const std::string& file_path,
+              const char* cooked_path,
+              bool cold,
+              RunMetrics& metrics)
+{
+    if (cold)
+    {
+        drop_asset_from_cache(file_path);
+    }
+
+    MemoryMark mark = start_memory_peak();
+    const uint64 start_ns = rsbl::Clock::NowNs();
+    {
+        GltfLoadProgress progress;
+        LoadedGltf loaded;
+        if (auto load = load_gltf(jobs, file_path, loaded, progress); !load)
+        {
+            RSBL_LOG_ERROR("Failed to load {}: {}", file_path, load.FailureText());
+            return false;
+        }
+        const uint64 cook_start_ns = rsbl::Clock::NowNs();
+        if (auto cooked = cook_gltf(loaded, cooked_path, rsbl::CookedMeshSource{}); !cooked)
+        {
+            RSBL_LOG_ERROR("Failed to cook {}: {}", file_path, cooked.FailureText());
+            return false;
+        }
+        const uint64 end_ns = rsbl::Clock::NowNs();
+
+        metrics[static_cast<uint32>(Metric::ReadMs)] = stage_ms(progress, GltfLoadStage::Read);
+        metrics[static_cast<uint32>(Metric::ParseMs)] = stage_ms(progress, GltfLoadStage::Parse);
+        metrics[static_cast<uint32>(Metric::BuffersMs)] =
+            stage_ms(progress, GltfLoadStage::Buffers);
+        metrics[static_cast<uint32>(Metric::ImagesMs)] = stage_ms(progress, GltfLoadStage::Images);
+        metrics[static_cast<uint32>(Metric::TexturesMs)] =
+            stage_ms(progress, GltfLoadStage::Textures);
+        metrics[static_cast<uint32>(Metric::AccessorsMs)] =
+            stage_ms(progress, GltfLoadStage::Accessors);
+        metrics[static_cast<uint32>(Metric::CookMs)] = ns_to_ms(end_ns - cook_start_ns);
+        metrics[static_cast<uint32>(Metric::GltfTotalMs)] = ns_to_ms(end_ns - start_ns);
+    }
+    metrics[static_cast<uint32>(Metric::GltfPeakBytes)] =
+        static_cast<double>(peak_bytes_since(mark));
+
+    // The cooked path, as the viewer takes it on a cache hit: open, then fault every section in
+    if (cold)
+    {
+        rsbl::Result<> dropped = rsbl::DropFileCache(cooked_path);
+        rsblUnused(dropped);
+    }
+    mark = start_memory_peak();
+    const uint64 open_start_ns = rsbl::Clock::NowNs();
+    auto opened = rsbl::CookedMesh::Open(cooked_path);
+    if (!opened)
+    {
+        RSBL_LOG_ERROR("Failed to open {}: {}", cooked_path, opened.FailureText());
+        return false;
+    }
+    const uint64 opened_ns = rsbl::Clock::NowNs();
+    const rsbl::CookedMesh& cooked = *opened.Value();
+    cooked.Prefetch();
+    uint64 sum = 0;
+    for (uint32 i = 0; i < static_cast<uint32>(rsbl::CookedMeshSection::Count); ++i)
+    {
+        const rsbl::ByteView section = cooked.Section(static_cast<rsbl::CookedMeshSection>(i));
+        for (uint64 offset = 0; offset < section.Size(); offset += 4096)
+        {
+            sum += static_cast<const volatile uint8*>(section.Data())[offset];
+        }
+    }
+    const uint64 loaded_ns = rsbl::Clock::NowNs();
+    rsblUnused(sum);
+
+    metrics[static_cast<uint32>(Metric::CookedOpenMs)] = ns_to_ms(opened_ns - open_start_ns);
+    metrics[static_cast<uint32>(Metric::CookedLoadMs)] = ns_to_ms(loaded_ns - open_start_ns);
+    metrics[static_cast<uint32>(Metric::CookedPeakBytes)] =
+        static_cast<double>(peak_bytes_since(mark));
+    return true;
+}
+
+struct ReportedMetric
+{
+    std::string key; // "<asset>/<metric>"
+    double value = 0.0;
+    bool bytes = false;
+};
+
+// The metrics of a report --report wrote
+rsbl::Result<rsbl::DynamicArray<ReportedMetric>> read_baseline(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        return {rsbl::ErrorCategory::NotFound, "Failed to open the baseline"};
+    }
+
+    // Each metric is a line of its own, starting with its name. The samples at the end of it
+    // make it as long as the runs are many.
+    rsbl::DynamicArray<ReportedMetric> metrics;
+    std::string line;
+    char chunk[512];
+    while (fgets(chunk, sizeof(chunk), file) != nullptr)
+    {
+        line += chunk;
+        if (line.back() != '\n' && !feof(file))
+        {
+            continue;
+        }
+        constexpr const char kName[] = "{\"name\": \"";
+        constexpr const char kValue[] = "\"value\": ";
+        const size_t name = line.find(kName);
+        const size_t value = line.find(kValue);
+        if (name != std::string::npos && value != std::string::npos)
+        {
+            const size_t start = name + sizeof(kName) - 1;
+            ReportedMetric& metric = metrics.EmplaceBack();
+            metric.key = line.substr(start, line.find('"', start) - start);
+            metric.value = strtod(line.c_str() + value + sizeof(kValue) - 1, nullptr);
+            metric.bytes = line.find("\"unit\": \"bytes\"") != std::string::npos;
+        }
+        line.clear();
+    }
+    fclose(file);
+    return metrics;
+}
+
+// Logs every metric against its baseline. False if any got worse by more than the threshold,
+// and for times by more than min_delta_ms too, so a 0.2 ms stage doubling isn't a failure.
+bool compare_with_baseline(rsbl::ArrayView<const rsbl::PerfMetric> current,
+                           const rsbl::DynamicArray<ReportedMetric>& baseline,
+                           double threshold_percent,
+                           double min_delta_ms)
+{
+    bool passed = true;
+    RSBL_LOG_INFO("{:<40} {:>14} {:>14} {:>9}", "Metric", "Baseline", "Current", "Change");
+    for (const ReportedMetric& base : baseline)
+    {
+        const rsbl::PerfMetric* found = nullptr;
+        for (const rsbl::PerfMetric& metric : current)
+        {
+            if (metric.name == rsbl::StringView(base.key.c_str()))
+            {
+                found = &metric;
+                break;
+            }
+        }
+        if (found == nullptr)
+        {
+            RSBL_LOG_WARNING("{:<40} {:>14.3f} {:>14} (not run)", base.key, base.value, "-");
+            continue;
+        }
+
+        const double change =
+            base.value > 0.0 ? (found->value - base.value) / base.value * 100.0 : 0.0;
+        const bool over = change > threshold_percent &&
+                          (base.bytes || found->value - base.value > min_delta_ms);
+        passed = passed && !over;
+        if (over)
+        {
+            RSBL_LOG_ERROR("{:<40} {:>14.3f} {:>14.3f} {:>+8.1f}% REGRESSED",
+                           base.key,
+                           base.value,
+                           found->value,
+                           change);
+        }
+        else
+        {
+            RSBL_LOG_INFO("{:<40} {:>14.3f} {:>14.3f} {:>+8.1f}%",
+                          base.key,
+                          base.value,
+                          found->value,
+                          change);
+        }
+    }
+    return passed;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    rsbl::LogInit("logs/gltf_load_bench.log");
+
+    CLI::App app("glTF load benchmark - times loading and cooking every listed sample asset, and "
+                 "checks the times against a baseline");
+
+    std::string listing_path = "asset_listing.toml";
+    app.add_option("--listing", listing_path, "The asset listing")->check(CLI::ExistingFile);
+
+    std::string assets_dir = "sample_assets";
+    app.add_option("--assets", assets_dir, "Where scripts/download_assets.py put the assets");
+
+    std::string only;
+    app.add_option("--only", only, "Only load assets whose name contains this");
+
+    uint32 runs = 5;
+    app.add_option("--runs", runs, "Loads of each asset, the medians are reported")
+        ->check(CLI::Range(1u, 100u));
+
+    bool cold = false;
+    app.add_flag("--cold",
+                 cold,
+                 "Drop each asset's files from the OS cache before every load, to time reading "
+                 "them from the disk");
+
+    std::string cooked_dir = "derived-data/bench";
+    app.add_option("--cooked-dir", cooked_dir, "Where the cooked meshes are written");
+
+    std::string report_path;
+    app.add_option("--report", report_path, "Where to write the results as JSON");
+
+    std::string baseline_path;
+    app.add_option("--baseline", baseline_path, "A report to compare against")
+        ->check(CLI::ExistingFile);
+
+    double threshold_percent = 10.0;
+    app.add_option("--threshold",
+                   threshold_percent,
+                   "Percent over the baseline a metric can be before the run fails");
+
+    double min_delta_ms = 1.0;
+    app.add_option("--min-delta-ms",
+                   min_delta_ms,
+                   "Times have to be this much over the baseline to fail too, short stages are "
+                   "noisy");
+
+    CLI11_PARSE(app, argc, argv);
+
+    auto listing = read_asset_listing(listing_path.c_str());
+    if (!listing)
+    {
+        RSBL_LOG_ERROR("{}: {}", listing_path, listing.FailureText());
+        return 1;
+    }
+    if (auto made = rsbl::MakeDirectory(cooked_dir.c_str()); !made)
+    {
+        RSBL_LOG_ERROR("Failed to create {}: {}", cooked_dir, made.FailureText());
+        return 1;
+    }
+
+    auto jobs_result = rsbl::JobSystem::Create();
+    if (!jobs_result)
+    {
+        RSBL_LOG_ERROR("Failed to start the job system: {}", jobs_result.FailureText());
+        return 1;
+    }
+    rsbl::JobSystem& jobs = *jobs_result.Value();
+
+    rsbl::PerfReport report("gltf-load-bench", "load");
+    report.SetConfigNumber("runs", runs);
+    report.SetConfigFlag("cold", cold);
+    bool failed = false;
+    for (const ListedAsset& asset : listing.Value())
+    {
+        if (!only.empty() && asset.name.find(only) == std::string::npos)
+        {
+            continue;
+        }
+        const std::string file_path = find_asset_file(assets_dir, asset);
+        if (file_path.empty())
+        {
+            RSBL_LOG_WARNING("{} isn't in {}, run scripts/download_assets.py", asset.name,
+                             assets_dir);
+            continue;
+        }
+
+        const std::string cooked_path = cooked_dir + "/" + asset.name + ".rmesh";
+        rsbl::DynamicArray<double> samples[static_cast<uint32>(Metric::Count)];
+        bool ok = true;
+        for (uint32 run = 0; run < runs && ok; ++run)
+        {
+            RunMetrics metrics = {};
+            ok = run_once(jobs, file_path, cooked_path.c_str(), cold, metrics);
+            for (uint32 i = 0; ok && i < static_cast<uint32>(Metric::Count); ++i)
+            {
+                samples[i].PushBack(metrics[i]);
+            }
+        }
+        if (!ok)
+        {
+            failed = true;
+            continue;
+        }
+
+        RSBL_LOG_INFO("{} ({} runs{})", asset.name, runs, cold ? ", cold" : "");
+        for (uint32 i = 0; i < static_cast<uint32>(Metric::Count); ++i)
+        {
+            const std::string key = asset.name + "/" + kMetricNames[i];
+            if (is_bytes(static_cast<Metric>(i)))
+            {
+                // Peaks are the worst run's, the one that decides whether it fits
+                double peak = 0.0;
+                for (const double value : samples[i])
+                {
+                    peak = value > peak ? value : peak;
+                }
+                report.AddValue(key.c_str(), rsbl::PerfUnit::Bytes, peak);
+                RSBL_LOG_INFO("  {:<20} {:>10.2f} MB", kMetricNames[i], peak / 1048576.0);
+            }
+            else
+            {
+                const rsbl::PerfMetric& metric =
+                    report.AddSamples(key.c_str(), rsbl::PerfUnit::Milliseconds, samples[i]);
+                RSBL_LOG_INFO("  {:<20} {:>10.3f} ms", kMetricNames[i], metric.value);
+            }
+        }
+    }
+
+    if (!report_path.empty())
+    {
+        if (auto written = report.Write(report_path.c_str()); !written)
+        {
+            RSBL_LOG_ERROR("Failed to write {}: {}", report_path, written.FailureText());
+            failed = true;
+        }
+    }
+
+    if (!baseline_path.empty())
+    {
+        auto baseline = read_baseline(baseline_path.c_str());
+        if (!baseline)
+        {
+            RSBL_LOG_ERROR("{}: {}", baseline_path, baseline.FailureText());
+            return 1;
+        }
+        if (!compare_with_baseline(
+                report.Metrics(), baseline.Value(), threshold_percent, min_delta_ms))
+        {
+            RSBL_LOG_ERROR("Load times regressed more than {:.1f}% against {}",
+                           threshold_percent,
+                           baseline_path);
+            failed = true;
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,593 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "gltf-load.h"
+
+#include <rsbl-clock.h>
+#include <rsbl-file.h>
+#include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+
+#include <fastgltf/core.hpp>
+#include <fastgltf/tools.hpp>
+
+#include <filesystem>
+#include <iterator>
+#include <type_traits>
+#include <variant>
+
+namespace
+{
+// Serves accessor reads from the buffers the jobs read in, in place of fastgltf's own adapter
+// which expects them inside the asset
+struct LoadedBufferAdapter
+{
+    const LoadedGltf* loaded = nullptr;
+
+    fastgltf::span<const std::byte> operator()(const fastgltf::Asset& asset,
+                                               std::size_t buffer_view_index) const
+    {
+        const fastgltf::BufferView& view = asset.bufferViews[buffer_view_index];
+        const rsbl::ByteView buffer = loaded->buffers[view.bufferIndex];
+        return fastgltf::span<const std::byte>(
+            reinterpret_cast<const std::byte*>(buffer.Data()) + view.byteOffset, view.byteLength);
+    }
+};
+
+// The bytes of a source fastgltf already holds in memory, empty for the ones it doesn't
+rsbl::ByteView in_memory_bytes(const fastgltf::DataSource& source)
+{
+    return std::visit(
+        [](const auto& data) -> rsbl::ByteView
+        {
+            using Source = std::decay_t<decltype(data)>;
+            if constexpr (std::is_same_v<Source, fastgltf::sources::Array> ||
+                          std::is_same_v<Source, fastgltf::sources::Vector> ||
+                          std::is_same_v<Source, fastgltf::sources::ByteView>)
+            {
+                return rsbl::ByteView(reinterpret_cast<const uint8*>(data.bytes.data()),
+                                      data.bytes.size());
+            }
+            else
+            {
+                return rsbl::ByteView();
+            }
+        },
+        source);
+}
+
+// The file an external source points at, empty for anything else
+std::string external_path(const fastgltf::DataSource& source, const std::filesystem::path& dir)
+{
+    const auto* uri = std::get_if<fastgltf::sources::URI>(&source);
+    if (uri == nullptr || !uri->uri.isLocalPath())
+    {
+        return {};
+    }
+    return (dir / uri->uri.fspath()).string();
+}
+
+rsbl::Result<> read_whole_file(const char* path, rsbl::DynamicArray<uint8>& out)
+{
+    rsbl::Result<rsbl::FileInfo> info = rsbl::GetFileInfo(path);
+    if (!info)
+    {
+        return rsbl::PendingFailure{info.Category()};
+    }
+    out.ResizeUninitialized(info.Value().size);
+    rsbl::Result<uint64> read =
+        rsbl::OpenAndReadFile(path, rsbl::MutableByteView(out.Data(), out.Size()));
+    if (!read)
+    {
+        return rsbl::PendingFailure{read.Category()};
+    }
+    out.Resize(read.Value());
+    return rsbl::ResultCode::Success;
+}
+
+// Names for the trace captures, so they have to stay around
+constexpr const char* kStageNames[] = {
+    "Read", "Parse", "Buffers", "Images", "Textures", "Accessors", "Cook", "Upload"};
+constexpr const char* kStageByteCounters[] = {"Read bytes",
+                                              "Parse bytes",
+                                              "Buffers bytes",
+                                              "Images bytes",
+                                              "Textures bytes",
+                                              "Accessors bytes",
+                                              "Cook bytes",
+                                              "Upload bytes"};
+static_assert(std::size(kStageNames) == static_cast<uint32>(GltfLoadStage::Count));
+static_assert(std::size(kStageByteCounters) == static_cast<uint32>(GltfLoadStage::Count));
+
+// How an image is compressed, and whether its mips average in linear light
+struct TextureFormat
+{
+    rsbl::ImageFormat format = rsbl::ImageFormat::Bc7;
+    bool srgb = true;
+};
+
+// Picks each image's block format from what the materials use it for. Base color and emissive
+// are sRGB, the rest are data.
+rsbl::DynamicArray<TextureFormat> texture_formats(const fastgltf::Asset& gltf)
+{
+    rsbl::DynamicArray<TextureFormat> formats;
+    formats.Resize(gltf.images.size());
+    rsbl::DynamicArray<bool> used;
+    used.Resize(gltf.images.size());
+
+    const auto image_of = [&gltf](const auto& info) -> uint64
+    {
+        if (!info.has_value())
+        {
+            return gltf.images.size();
+        }
+        const auto& image_index = gltf.textures[info->textureIndex].imageIndex;
+        return image_index.has_value() ? *image_index : gltf.images.size();
+    };
+    const auto use = [&](const auto& info, rsbl::ImageFormat format, bool srgb)
+    {
+        const uint64 image = image_of(info);
+        if (image >= gltf.images.size())
+        {
+            return;
+        }
+        // Base color wins over anything else sharing the image, then normals
+        if (!used[image] || format == rsbl::ImageFormat::Bc7 ||
+            (format == rsbl::ImageFormat::Bc5 && formats[image].format == rsbl::ImageFormat::Bc1))
+        {
+            formats[image] = {format, srgb};
+        }
+        used[image] = true;
+    };
+    for (const fastgltf::Material& material : gltf.materials)
+    {
+        use(material.pbrData.metallicRoughnessTexture, rsbl::ImageFormat::Bc1, false);
+        use(material.occlusionTexture, rsbl::ImageFormat::Bc1, false);
+        use(material.emissiveTexture, rsbl::ImageFormat::Bc1, true);
+        use(material.normalTexture, rsbl::ImageFormat::Bc5, false);
+        use(material.pbrData.baseColorTexture, rsbl::ImageFormat::Bc7, true);
+    }
+    return formats;
+}
+
+// Decodes an image file and compresses it to format. A failure is logged and leaves out empty,
+// the rest of the asset is still usable without it.
+uint64 decode_texture(uint32 index,
+                      rsbl::ByteView file,
+                      rsbl::ImageFormat format,
+                      rsbl::Image& out)
+{
+    rsbl::Image decoded;
+    if (rsbl::Result<> decode = rsbl::DecodeImage(file, decoded); !decode)
+    {
+        RSBL_LOG_WARNING("Failed to decode image {}: {}", index, decode.FailureText());
+        return 0;
+    }
+    if (rsbl::Result<> compress = rsbl::CompressImage(decoded, format, out); !compress)
+    {
+        RSBL_LOG_WARNING("Failed to compress image {}: {}", index, compress.FailureText());
+        return 0;
+    }
+    return out.pixels.Size();
+}
+
+// decode_texture, but compressing every mip below the image too, finest first
+uint64 decode_mip_chain(uint32 index,
+                        rsbl::ByteView file,
+                        const TextureFormat& format,
+                        rsbl::DynamicArray<rsbl::Image>& out)
+{
+    rsbl::Image decoded;
+    if (rsbl::Result<> decode = rsbl::DecodeImage(file, decoded); !decode)
+    {
+        RSBL_LOG_WARNING("Failed to decode image {}: {}", index, decode.FailureText());
+        return 0;
+    }
+    rsbl::DynamicArray<rsbl::Image> mips;
+    if (rsbl::Result<> made = rsbl::GenerateMips(decoded, format.srgb, mips); !made)
+    {
+        RSBL_LOG_WARNING("Failed to make mips of image {}: {}", index, made.FailureText());
+        return 0;
+    }
+
+    out.Resize(mips.Size() + 1);
+    uint64 bytes = 0;
+    for (uint64 mip = 0; mip < out.Size(); ++mip)
+    {
+        const rsbl::Image& source = mip == 0 ? decoded : mips[mip - 1];
+        if (rsbl::Result<> compress = rsbl::CompressImage(source, format.format, out[mip]);
+            !compress)
+        {
+            RSBL_LOG_WARNING("Failed to compress image {}: {}", index, compress.FailureText());
+            out.Clear();
+            return 0;
+        }
+        bytes += out[mip].pixels.Size();
+    }
+    return bytes;
+}
+
+// One image into out.textures or out.textureMips, as asked for
+uint64 decode_image(uint32 index,
+                    rsbl::ByteView file,
+                    const TextureFormat& format,
+                    GltfTextures textures,
+                    LoadedGltf& out)
+{
+    if (textures == GltfTextures::MipChain)
+    {
+        return decode_mip_chain(index, file, format, out.textureMips[index]);
+    }
+    return decode_texture(index, file, format.format, out.textures[index]);
+}
+
+// rsbl::float2/3/4 are plain floats like fastgltf's vectors, so accessors copy straight in
+template <typename T>
+uint64 copy_attribute(const LoadedGltf& loaded,
+                      const fastgltf::Primitive& primitive,
+                      std::string_view name,
+                      rsbl::DynamicArray<T>& out)
+{
+    const auto attribute = primitive.findAttribute(name);
+    if (attribute == primitive.attributes.end())
+    {
+        return 0;
+    }
+    const fastgltf::Accessor& accessor = loaded.asset.accessors[attribute->accessorIndex];
+    out.ResizeUninitialized(accessor.count);
+    fastgltf::copyFromAccessor<T, sizeof(T)>(
+        loaded.asset, accessor, out.Data(), LoadedBufferAdapter{&loaded});
+    return accessor.count * sizeof(T);
+}
+
+uint64 convert_primitive(const LoadedGltf& loaded,
+                         const fastgltf::Primitive& primitive,
+                         LoadedPrimitive& out)
+{
+    uint64 bytes = copy_attribute(loaded, primitive, "POSITION", out.positions);
+    bytes += copy_attribute(loaded, primitive, "NORMAL", out.normals);
+    bytes += copy_attribute(loaded, primitive, "TANGENT", out.tangents);
+    bytes += copy_attribute(loaded, primitive, "TEXCOORD_0", out.uvs);
+    if (primitive.indicesAccessor.has_value())
+    {
+        const fastgltf::Accessor& accessor = loaded.asset.accessors[*primitive.indicesAccessor];
+        out.indices.ResizeUninitialized(accessor.count);
+        fastgltf::copyFromAccessor<uint32>(
+            loaded.asset, accessor, out.indices.Data(), LoadedBufferAdapter{&loaded});
+        bytes += accessor.count * sizeof(uint32);
+    }
+    if (primitive.materialIndex.has_value())
+    {
+        out.material = static_cast<uint32>(*primitive.materialIndex);
+    }
+    return bytes;
+}
+} // namespace
+
+void start_load_stage(GltfLoadProgress& progress, GltfLoadStage stage, uint32 total)
+{
+    GltfLoadProgress::Stage& times = progress[stage];
+    times.total = total;
+    times.startNs = rsbl::Clock::NowNs();
+    if (total == 0)
+    {
+        times.endNs.store(times.startNs, std::memory_order_release);
+    }
+}
+
+GltfLoadItem start_load_item()
+{
+    return {rsbl::Clock::NowTicks(), rsbl::Clock::ThreadCpuNs()};
+}
+
+void finish_load_item(rsbl::JobSystem& jobs,
+                      GltfLoadProgress& progress,
+                      GltfLoadStage stage,
+                      const GltfLoadItem& item,
+                      uint64 bytes)
+{
+    const uint32 index = static_cast<uint32>(stage);
+    GltfLoadProgress::Stage& times = progress[stage];
+    times.busyNs.fetch_add(rsbl::Clock::TicksToNs(rsbl::Clock::NowTicks() - item.startTicks),
+                           std::memory_order_relaxed);
+    times.cpuNs.fetch_add(rsbl::Clock::ThreadCpuNs() - item.startCpuNs, std::memory_order_relaxed);
+    jobs.TraceRegion(kStageNames[index], item.startTicks);
+    const uint64 total_bytes = times.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    jobs.TraceCounter(kStageByteCounters[index], total_bytes);
+    if (times.done.fetch_add(1, std::memory_order_acq_rel) + 1 == times.total)
+    {
+        times.endNs.store(rsbl::Clock::NowNs(), std::memory_order_release);
+    }
+}
+
+rsbl::Result<> load_gltf(rsbl::JobSystem& jobs,
+                         const std::string& file_path,
+                         LoadedGltf& out,
+                         GltfLoadProgress& progress,
+                         GltfTextures textures)
+{
+    rsbl::MemoryTagScope memory_scope(rsbl::MemoryTag::Asset);
+
+    // The JSON, and for a .glb its binary chunk. External files are left to the jobs.
+    start_load_stage(progress, GltfLoadStage::Read, 1);
+    GltfLoadItem item = start_load_item();
+    auto data = fastgltf::GltfDataBuffer::FromPath(file_path);
+    if (data.error() != fastgltf::Error::None)
+    {
+        return rsbl::FailureFormat(rsbl::ErrorCategory::Io,
+                                   "Failed to load file: %s",
+                                   fastgltf::getErrorMessage(data.error()).data());
+    }
+    finish_load_item(jobs, progress, GltfLoadStage::Read, item, data.get().totalSize());
+
+    start_load_stage(progress, GltfLoadStage::Parse, 1);
+    item = start_load_item();
+    const std::filesystem::path directory = std::filesystem::path(file_path).parent_path();
+    fastgltf::Parser parser;
+    auto asset = parser.loadGltf(data.get(), directory, fastgltf::Options::None);
+    if (asset.error() != fastgltf::Error::None)
+    {
+        return rsbl::FailureFormat(rsbl::ErrorCategory::InvalidArgument,
+                                   "Failed to parse glTF: %s",
+                                   fastgltf::getErrorMessage(asset.error()).data());
+    }
+    out.asset = std::move(asset.get());
+    finish_load_item(jobs, progress, GltfLoadStage::Parse, item, data.get().totalSize());
+
+    const fastgltf::Asset& gltf = out.asset;
+    std::atomic<uint32> failures{0};
+
+    // Buffers. In-memory ones are pointed at now, external ones get a job each.
+    out.bufferStorage.Resize(gltf.buffers.size());
+    out.buffers.Resize(gltf.buffers.size());
+    rsbl::DynamicArray<uint32> external_buffers;
+    for (uint32 i = 0; i < gltf.buffers.size(); ++i)
+    {
+        if (!external_path(gltf.buffers[i].data, directory).empty())
+        {
+            external_buffers.PushBack(i);
+        }
+        else
+        {
+            out.buffers[i] = in_memory_bytes(gltf.buffers[i].data);
+            if (out.buffers[i].Size() < gltf.buffers[i].byteLength)
+            {
+                return rsbl::FailureFormat(rsbl::ErrorCategory::InvalidArgument,
+                                           "Buffer %u has no data this loader can read",
+                                           i);
+            }
+        }
+    }
+
+    start_load_stage(
+        progress, GltfLoadStage::Buffers, static_cast<uint32>(external_buffers.Size()));
+    rsbl::JobCounter buffers_done;
+    for (const uint32 index : external_buffers)
+    {
+        jobs.Submit(
+            [&, index]()
+            {
+                rsbl::MemoryTagScope job_memory_scope(rsbl::MemoryTag::Asset);
+                const GltfLoadItem buffer_item = start_load_item();
+                const std::string path = external_path(gltf.buffers[index].data, directory);
+                rsbl::DynamicArray<uint8>& storage = out.bufferStorage[index];
+                if (rsbl::Result<> read = read_whole_file(path.c_str(), storage); !read)
+                {
+                    RSBL_LOG_ERROR("Failed to read buffer {}: {}", path, read.FailureText());
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+                out.buffers[index] = rsbl::ByteView(storage.Data(), storage.Size());
+                finish_load_item(
+                    jobs, progress, GltfLoadStage::Buffers, buffer_item, storage.Size());
+            },
+            &buffers_done);
+    }
+
+    // Images are read and then decoded in the same job. Ones inside a buffer wait for the
+    // buffers, and nothing waits on any of them but the end of the load.
+    out.images.Resize(gltf.images.size());
+    if (textures == GltfTextures::MipChain)
+    {
+        out.textureMips.Resize(gltf.images.size());
+    }
+    else
+    {
+        out.textures.Resize(gltf.images.size());
+    }
+    const rsbl::DynamicArray<TextureFormat> formats = texture_formats(gltf);
+    rsbl::DynamicArray<uint32> external_images;
+    rsbl::DynamicArray<uint32> buffer_images;
+    rsbl::DynamicArray<uint32> memory_images;
+    const uint32 image_count =
+        textures == GltfTextures::None ? 0 : static_cast<uint32>(gltf.images.size());
+    for (uint32 i = 0; i < image_count; ++i)
+    {
+        if (!external_path(gltf.images[i].data, directory).empty())
+        {
+            external_images.PushBack(i);
+        }
+        else if (std::holds_alternative<fastgltf::sources::BufferView>(gltf.images[i].data))
+        {
+            buffer_images.PushBack(i);
+        }
+        else if (in_memory_bytes(gltf.images[i].data).Size() != 0)
+        {
+            memory_images.PushBack(i);
+        }
+    }
+
+    start_load_stage(progress, GltfLoadStage::Images, static_cast<uint32>(external_images.Size()));
+    start_load_stage(progress,
+                     GltfLoadStage::Textures,
+                     static_cast<uint32>(external_images.Size() + buffer_images.Size() +
+                                         memory_images.Size()));
+    rsbl::JobCounter all_done;
+    for (const uint32 index : external_images)
+    {
+        jobs.Submit(
+            [&, index]()
+            {
+                rsbl::MemoryTagScope job_memory_scope(rsbl::MemoryTag::Asset);
+                const GltfLoadItem image_item = start_load_item();
+                const std::string path = external_path(gltf.images[index].data, directory);
+                rsbl::DynamicArray<uint8>& storage = out.images[index];
+                uint64 bytes = 0;
+                if (rsbl::Result<> read = read_whole_file(path.c_str(), storage); !read)
+                {
+                    RSBL_LOG_ERROR("Failed to read image {}: {}", path, read.FailureText());
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+                finish_load_item(
+                    jobs, progress, GltfLoadStage::Images, image_item, storage.Size());
+                const GltfLoadItem texture_item = start_load_item();
+                if (storage.Size() != 0)
+                {
+                    bytes = decode_image(index,
+                                         rsbl::ByteView(storage.Data(), storage.Size()),
+                                         formats[index],
+                                         textures,
+                                         out);
+                }
+                finish_load_item(jobs, progress, GltfLoadStage::Textures, texture_item, bytes);
+            },
+            &all_done,
+            rsbl::JobPriority::Low);
+    }
+    for (const uint32 index : memory_images)
+    {
+        jobs.Submit(
+            [&, index]()
+            {
+                rsbl::MemoryTagScope job_memory_scope(rsbl::MemoryTag::Asset);
+                const GltfLoadItem texture_item = start_load_item();
+                const uint64 bytes = decode_image(index,
+                                                  in_memory_bytes(gltf.images[index].data),
+                                                  formats[index],
+                                                  textures,
+                                                  out);
+                finish_load_item(jobs, progress, GltfLoadStage::Textures, texture_item, bytes);
+            },
+            &all_done,
+            rsbl::JobPriority::Low);
+    }
+    for (const uint32 index : buffer_images)
+    {
+        jobs.SubmitAfter(
+            buffers_done,
+            [&, index]()
+            {
+                rsbl::MemoryTagScope job_memory_scope(rsbl::MemoryTag::Asset);
+                const GltfLoadItem texture_item = start_load_item();
+                const auto& source =
+                    std::get<fastgltf::sources::BufferView>(gltf.images[index].data);
+                const fastgltf::BufferView& view = gltf.bufferViews[source.bufferViewIndex];
+                const rsbl::ByteView buffer = out.buffers[view.bufferIndex];
+                uint64 bytes = 0;
+                if (view.byteOffset + view.byteLength <= buffer.Size())
+                {
+                    bytes = decode_image(
+                        index,
+                        rsbl::ByteView(buffer.Data() + view.byteOffset, view.byteLength),
+                        formats[index],
+                        textures,
+                        out);
+                }
+                finish_load_item(jobs, progress, GltfLoadStage::Textures, texture_item, bytes);
+            },
+            &all_done,
+            rsbl::JobPriority::Low);
+    }
+
+    // Accessors, one job per triangle primitive once the buffers are all in
+    for (uint32 mesh = 0; mesh < gltf.meshes.size(); ++mesh)
+    {
+        for (const fastgltf::Primitive& primitive : gltf.meshes[mesh].primitives)
+        {
+            if (primitive.type != fastgltf::PrimitiveType::Triangles)
+            {
+                RSBL_LOG_WARNING("Mesh {}: skipping a primitive that isn't a triangle list", mesh);
+                continue;
+            }
+            if (primitive.findAttribute("POSITION") == primitive.attributes.end())
+            {
+                RSBL_LOG_WARNING("Mesh {}: skipping a primitive without positions", mesh);
+                continue;
+            }
+            out.primitives.EmplaceBack().mesh = mesh;
+        }
+    }
+
+    start_load_stage(
+        progress, GltfLoadStage::Accessors, static_cast<uint32>(out.primitives.Size()));
+    uint32 primitive_index = 0;
+    for (uint32 mesh = 0; mesh < gltf.meshes.size(); ++mesh)
+    {
+        for (const fastgltf::Primitive& primitive : gltf.meshes[mesh].primitives)
+        {
+            if (primitive.type != fastgltf::PrimitiveType::Triangles ||
+                primitive.findAttribute("POSITION") == primitive.attributes.end())
+            {
+                continue;
+            }
+            LoadedPrimitive& loaded_primitive = out.primitives[primitive_index++];
+            jobs.SubmitAfter(
+                buffers_done,
+                [&, &primitive = primitive, &loaded_primitive = loaded_primitive]()
+                {
+                    rsbl::MemoryTagScope job_memory_scope(rsbl::MemoryTag::Asset);
+                    const GltfLoadItem accessor_item = start_load_item();
+                    uint64 bytes = 0;
+                    // A missing buffer leaves the accessors nothing to read from
+                    if (failures.load(std::memory_order_relaxed) == 0)
+                    {
+                        bytes = convert_primitive(out, primitive, loaded_primitive);
+                    }
+                    finish_load_item(
+                        jobs, progress, GltfLoadStage::Accessors, accessor_item, bytes);
+                },
+                &all_done);
+        }
+    }
+
+    jobs.Wait(buffers_done);
+    jobs.Wait(all_done);
+
+    if (const uint32 failed = failures.load(std::memory_order_relaxed); failed != 0)
+    {
+        return rsbl::FailureFormat(
+            rsbl::ErrorCategory::Io, "%u external files failed to load", failed);
+    }
+    return rsbl::ResultCode::Success;
+}
+
+void log_gltf_load_timings(const GltfLoadProgress& progress)
+{
+    RSBL_LOG_INFO("  {:<10} {:>9} {:>10} {:>10} {:>10} {:>10} {:>7}",
+                  "Stage",
+                  "Items",
+                  "MB",
+                  "Wall ms",
+                  "Busy ms",
+                  "CPU ms",
+                  "Threads");
+    for (uint32 i = 0; i < static_cast<uint32>(GltfLoadStage::Count); ++i)
+    {
+        const GltfLoadProgress::Stage& stage = progress.stages[i];
+        if (stage.startNs == 0)
+        {
+            continue;
+        }
+        const uint64 end = stage.endNs.load(std::memory_order_acquire);
+        const double wall_ms = end >= stage.startNs ? (end - stage.startNs) / 1'000'000.0 : 0.0;
+        const double busy_ms = stage.busyNs.load(std::memory_order_relaxed) / 1'000'000.0;
+        RSBL_LOG_INFO("  {:<10} {:>4}/{:<4} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f} {:>7.2f}",
+                      kStageNames[i],
+                      stage.done.load(std::memory_order_relaxed),
+                      stage.total,
+                      stage.bytes.load(std::memory_order_relaxed) / (1024.0 * 1024.0),
+                      wall_ms,
+                      busy_ms,
+                      stage.cpuNs.load(std::memory_order_relaxed) / 1'000'000.0,
+                      wall_ms > 0.0 ? busy_ms / wall_ms : 0.0);
+    }
+}
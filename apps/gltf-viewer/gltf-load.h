@@ -0,0 +1,151 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-cooked-mesh.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-image.h>
+#include <rsbl-jobs.h>
+#include <rsbl-math-types.h>
+#include <rsbl-result.h>
+
+#include <fastgltf/types.hpp>
+
+#include <atomic>
+#include <string>
+
+// Loads a glTF with the work spread over the job system. Only the JSON is parsed on the calling
+// thread, then:
+//
+//   buffers   one job per external buffer, reading its file
+//   images    one job per external image, reading its file, alongside everything else
+//   textures  one job per image, decoding it and compressing it to BCn once its bytes are in
+//   accessors one job per triangle primitive, converting its attributes and indices once the
+//             buffers it reads from are in
+//
+// fastgltf's own LoadExternalBuffers and LoadExternalImages do the reads one after the other on
+// the calling thread, which for a glTF with many separate textures (FlightHelmet) is most of the
+// load.
+
+// Every stage from the file on disk to the data being GPU-resident, the ones after Accessors
+// filled in by the viewer. A scene found in the derived data cache only goes through Upload.
+enum class GltfLoadStage : uint32
+{
+    Read,  // GltfDataBuffer::FromPath: the JSON, or all of a .glb
+    Parse, // The JSON
+    Buffers,
+    Images,
+    Textures,
+    Accessors,
+    Cook,
+    Upload,
+    Count,
+};
+
+// Filled in by the jobs as they go, so another thread can show progress while the load runs
+struct GltfLoadProgress
+{
+    struct Stage
+    {
+        std::atomic<uint32> done{0};
+        uint32 total = 0;
+        std::atomic<uint64> bytes{0};
+        // Clock::NowNs when the stage's first job was queued and its last one finished
+        uint64 startNs = 0;
+        std::atomic<uint64> endNs{0};
+        // Summed over the stage's items: how long each took, and how much of that the thread
+        // doing it spent on a CPU rather than waiting on IO or locks
+        std::atomic<uint64> busyNs{0};
+        std::atomic<uint64> cpuNs{0};
+    };
+
+    Stage stages[static_cast<uint32>(GltfLoadStage::Count)];
+
+    Stage& operator[](GltfLoadStage stage)
+    {
+        return stages[static_cast<uint32>(stage)];
+    }
+    const Stage& operator[](GltfLoadStage stage) const
+    {
+        return stages[static_cast<uint32>(stage)];
+    }
+};
+
+// When one item of a stage started, on the thread doing it
+struct GltfLoadItem
+{
+    uint64 startTicks = 0;
+    uint64 startCpuNs = 0;
+};
+
+// Before the stage's first item is queued. A stage with no items ends right away.
+void start_load_stage(GltfLoadProgress& progress, GltfLoadStage stage, uint32 total);
+
+GltfLoadItem start_load_item();
+
+// Adds an item's bytes and times to its stage, the stage's last item stamping its end. In a job
+// system trace capture the item is a region named after its stage, and the stage's bytes so far
+// a counter.
+void finish_load_item(rsbl::JobSystem& jobs,
+                      GltfLoadProgress& progress,
+                      GltfLoadStage stage,
+                      const GltfLoadItem& item,
+                      uint64 bytes);
+
+// One triangle primitive's attributes, converted to plain arrays. Missing attributes are empty.
+struct LoadedPrimitive
+{
+    uint32 mesh = 0;
+    uint32 material = rsbl::kNoMaterial;
+    rsbl::DynamicArray<rsbl::float3> positions;
+    rsbl::DynamicArray<rsbl::float3> normals;
+    rsbl::DynamicArray<rsbl::float4> tangents;
+    rsbl::DynamicArray<rsbl::float2> uvs;
+    rsbl::DynamicArray<uint32> indices;
+};
+
+struct LoadedGltf
+{
+    fastgltf::Asset asset;
+
+    // Each buffer's bytes, read in or pointing into the asset for ones it already holds
+    rsbl::DynamicArray<rsbl::DynamicArray<uint8>> bufferStorage;
+    rsbl::DynamicArray<rsbl::ByteView> buffers;
+
+    // Indexed like asset.images, empty for images embedded in a buffer or a data URI
+    rsbl::DynamicArray<rsbl::DynamicArray<uint8>> images;
+
+    // Indexed like asset.images, block compressed for upload. BC5 for normal maps, BC1 for
+    // images only used as metallic-roughness, occlusion or emissive, BC7 for the rest. Images
+    // that failed to decode are left empty.
+    rsbl::DynamicArray<rsbl::Image> textures;
+
+    // Indexed like asset.images, for GltfTextures::MipChain: each image's whole mip chain,
+    // finest first, in the format textures would have. textures is left empty then.
+    rsbl::DynamicArray<rsbl::DynamicArray<rsbl::Image>> textureMips;
+
+    // Triangle primitives in mesh order. Ones without positions are left out.
+    rsbl::DynamicArray<LoadedPrimitive> primitives;
+};
+
+// What the texture jobs make of the images
+enum class GltfTextures : uint32
+{
+    TopMip,   // textures, for upload
+    MipChain, // textureMips, for cooking into streamed textures (rsbl-texture-streamer.h)
+    None,     // Images aren't read at all
+};
+
+// Loads file_path into out, waiting on the jobs it queues. progress can be watched from another
+// thread while this runs.
+rsbl::Result<> load_gltf(rsbl::JobSystem& jobs,
+                         const std::string& file_path,
+                         LoadedGltf& out,
+                         GltfLoadProgress& progress,
+                         GltfTextures textures = GltfTextures::TopMip);
+
+// Logs a table of the stages that ran: items, bytes, wall time, time spent on items, CPU time,
+// and how many threads were busy with the stage on average over its wall time
+void log_gltf_load_timings(const GltfLoadProgress& progress);
@@ -0,0 +1,164 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "gltf-replay.h"
+
+#include "gltf-benchmark.h"
+
+#include <rsbl-file.h>
+#include <rsbl-log.h>
+
+#include <cstring>
+
+namespace
+{
+constexpr uint32 kReplayMagic = 0x594C5052; // "RPLY"
+constexpr uint32 kReplayVersion = 1;
+
+struct ReplayHeader
+{
+    uint32 magic = kReplayMagic;
+    uint32 version = kReplayVersion;
+    rsbl::DerivedDataKey asset;
+    uint32 width = 0;
+    uint32 height = 0;
+    uint32 spinFrames = 0;
+    uint32 frameCount = 0;
+};
+
+// The frames recorded slowest that the comparison lists
+constexpr uint32 kSlowestFrames = 5;
+} // namespace
+
+rsbl::Result<> write_replay(const char* path, const ReplaySession& session)
+{
+    ReplayHeader header;
+    header.asset = session.asset;
+    header.width = session.width;
+    header.height = session.height;
+    header.spinFrames = session.spinFrames;
+    header.frameCount = static_cast<uint32>(session.frames.Size());
+
+    auto file = rsbl::OpenFile(path, rsbl::FileOpenMode::Write);
+    if (!file)
+    {
+        return rsbl::PendingFailure{file.Category()};
+    }
+    const rsbl::ByteView buffers[] = {rsbl::AsBytes(&header, sizeof(header)),
+                                      rsbl::AsBytes(rsbl::ArrayView(session.frames))};
+    auto written = rsbl::WriteFileGather(file.Value(), buffers);
+    rsbl::Result<> closed = rsbl::CloseFile(file.Value());
+    if (!written)
+    {
+        return rsbl::PendingFailure{written.Category()};
+    }
+    return closed;
+}
+
+rsbl::Result<> read_replay(const char* path, ReplaySession& session)
+{
+    auto file = rsbl::OpenFile(path, rsbl::FileOpenMode::Read);
+    if (!file)
+    {
+        return rsbl::PendingFailure{file.Category()};
+    }
+
+    ReplayHeader header;
+    rsbl::Result<> result = rsbl::ResultCode::Success;
+    auto read = rsbl::ReadFile(file.Value(), rsbl::AsWritableBytes(&header, sizeof(header)));
+    if (!read)
+    {
+        result = rsbl::PendingFailure{read.Category()};
+    }
+    else if (read.Value() != sizeof(header) || header.magic != kReplayMagic)
+    {
+        result = {rsbl::ErrorCategory::InvalidArgument, "Not a replay"};
+    }
+    else if (header.version != kReplayVersion)
+    {
+        result = rsbl::FailureFormat(rsbl::ErrorCategory::InvalidArgument,
+                                     "Replay version %u, expected %u",
+                                     header.version,
+                                     kReplayVersion);
+    }
+    else
+    {
+        session.asset = header.asset;
+        session.width = header.width;
+        session.height = header.height;
+        session.spinFrames = header.spinFrames;
+        session.frames.Resize(header.frameCount);
+        const rsbl::MutableByteView frames =
+            rsbl::AsWritableBytes(rsbl::ArrayView(session.frames));
+        read = rsbl::ReadFile(file.Value(), frames, sizeof(header));
+        if (!read)
+        {
+            result = rsbl::PendingFailure{read.Category()};
+        }
+        else if (read.Value() != frames.Size())
+        {
+            result = {rsbl::ErrorCategory::InvalidArgument, "Replay is cut short"};
+        }
+    }
+
+    rsbl::Result<> closed = rsbl::CloseFile(file.Value());
+    if (!result)
+    {
+        return result;
+    }
+    return closed;
+}
+
+void log_replay_comparison(const ReplaySession& session, rsbl::ArrayView<const uint64> replayed_ns)
+{
+    const uint64 count = replayed_ns.Size();
+    rsbl::DynamicArray<uint64> recorded_ns;
+    recorded_ns.Reserve(count);
+    for (uint64 i = 0; i < count; ++i)
+    {
+        recorded_ns.PushBack(session.frames[i].frameNs);
+    }
+
+    RSBL_LOG_INFO("Replayed {} of {} recorded frames", count, session.frames.Size());
+    const FrameTimeStats recorded = frame_time_stats(recorded_ns);
+    const FrameTimeStats replayed = frame_time_stats(replayed_ns);
+    RSBL_LOG_INFO("  Recorded ms: mean {:.3f} p50 {:.3f} p99 {:.3f} max {:.3f}",
+                  recorded.meanMs,
+                  recorded.p50Ms,
+                  recorded.p99Ms,
+                  recorded.maxMs);
+    RSBL_LOG_INFO("  Replayed ms: mean {:.3f} p50 {:.3f} p99 {:.3f} max {:.3f}",
+                  replayed.meanMs,
+                  replayed.p50Ms,
+                  replayed.p99Ms,
+                  replayed.maxMs);
+
+    // The frames that were slowest when recorded, which is where a hitch being replayed shows
+    uint64 slowest[kSlowestFrames];
+    uint32 slowest_count = 0;
+    for (uint64 i = 0; i < count; ++i)
+    {
+        uint32 at = slowest_count;
+        while (at > 0 && recorded_ns[slowest[at - 1]] < recorded_ns[i])
+        {
+            if (at < kSlowestFrames)
+            {
+                slowest[at] = slowest[at - 1];
+            }
+            --at;
+        }
+        if (at < kSlowestFrames)
+        {
+            slowest[at] = i;
+            slowest_count += slowest_count < kSlowestFrames ? 1 : 0;
+        }
+    }
+    for (uint32 i = 0; i < slowest_count; ++i)
+    {
+        const uint64 frame = slowest[i];
+        RSBL_LOG_INFO("  Frame {}: recorded {:.3f} ms, replayed {:.3f} ms",
+                      frame,
+                      recorded_ns[frame] / 1'000'000.0,
+                      replayed_ns[frame] / 1'000'000.0);
+    }
+}
@@ -0,0 +1,52 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-derived-data-cache.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-result.h>
+
+// Replays: --record writes down everything a session's frames took from outside the viewer, so
+// that --replay can run the same frames again on another machine, under a profiler say. That's
+// the glTF's bytes, through its derived data key, the swapchain size each frame ended on, the
+// load stage each frame drew at and how the roots were turning. A replay waits for the load to
+// reach the stage the recorded frame had, and holds back a load that's ahead, so a hitch that
+// came with the scene arriving comes on the same frame. Each frame's recorded time is kept too,
+// to compare the replay's against.
+
+struct ReplayFrame
+{
+    // CPU time from beginning the frame to ending it, when recorded
+    uint64 frameNs = 0;
+    // The swapchain's size once the frame's resizes were done
+    uint32 width = 0;
+    uint32 height = 0;
+    // The SceneLoadStage the frame was drawn at
+    uint32 stage = 0;
+    uint32 pad = 0;
+};
+
+struct ReplaySession
+{
+    // The glTF's cooked mesh key, zero if the session ended before it was known
+    rsbl::DerivedDataKey asset;
+    // The swapchain's size at the start
+    uint32 width = 0;
+    uint32 height = 0;
+    // Frames the roots turn a full turn over once the scene is loaded, 0 if they didn't turn
+    uint32 spinFrames = 0;
+    rsbl::DynamicArray<ReplayFrame> frames;
+};
+
+rsbl::Result<> write_replay(const char* path, const ReplaySession& session);
+
+// Fails on a file that isn't a replay, or is one from another version of the viewer
+rsbl::Result<> read_replay(const char* path, ReplaySession& session);
+
+// Logs the replay's frame times against the recorded ones, overall and for the frames that were
+// slowest when recorded. replayed_ns has a time per frame replayed, fewer than were recorded if
+// the replay was stopped early.
+void log_replay_comparison(const ReplaySession& session, rsbl::ArrayView<const uint64> replayed_ns);
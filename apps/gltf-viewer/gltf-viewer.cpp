@@ -1,17 +1,85 @@
 // Copyright 2025 Robert Srinivasiah
 // Licensed under the MIT License, see the LICENSE file for more info
 
+#include "gltf-benchmark.h"
+#include "gltf-capture.h"
+#include "gltf-cook.h"
+#include "gltf-load.h"
+#include "gltf-replay.h"
+
+#include <rsbl-bootstrap.h>
+#include <rsbl-clock.h>
+#include <rsbl-cooked-mesh.h>
+#include <rsbl-counters.h>
+#include <rsbl-derived-data-cache.h>
+#include <rsbl-file.h>
+#include <rsbl-frame-limiter.h>
+#include <rsbl-frame-pacing.h>
 #include <rsbl-ga.h>
+#include <rsbl-jobs.h>
 #include <rsbl-log.h>
+#include <rsbl-material.h>
+#include <rsbl-memory-tracking.h>
 #include <rsbl-platform.h>
+#include <rsbl-power.h>
 #include <rsbl-ptr.h>
+#include <rsbl-scene-graph.h>
+#include <rsbl-thread.h>
 #include <rsbl-window.h>
 
 #include <CLI11.hpp>
 #include <fastgltf/core.hpp>
 #include <fastgltf/types.hpp>
 
+#include <atomic>
+#include <cstring>
 #include <string>
+#include <vector>
+
+// The glTF texture index stands in for the bindless view index until textures are views
+rsbl::MaterialDesc material_desc(const fastgltf::Material& material)
+{
+    const auto texture = [](const auto& info) -> uint32
+    {
+        return info.has_value() ? static_cast<uint32>(info->textureIndex)
+                                : rsbl::kNoMaterialTexture;
+    };
+
+    rsbl::MaterialDesc desc;
+    const auto& base = material.pbrData.baseColorFactor;
+    desc.baseColorFactor = rsbl::float4(base[0], base[1], base[2], base[3]);
+    const float strength = material.emissiveStrength;
+    desc.emissiveFactor = rsbl::float3(material.emissiveFactor[0] * strength,
+                                       material.emissiveFactor[1] * strength,
+                                       material.emissiveFactor[2] * strength);
+    desc.metallicFactor = material.pbrData.metallicFactor;
+    desc.roughnessFactor = material.pbrData.roughnessFactor;
+    desc.alphaCutoff = material.alphaCutoff;
+    desc.baseColorTexture = texture(material.pbrData.baseColorTexture);
+    desc.metallicRoughnessTexture = texture(material.pbrData.metallicRoughnessTexture);
+    desc.normalTexture = texture(material.normalTexture);
+    desc.occlusionTexture = texture(material.occlusionTexture);
+    desc.emissiveTexture = texture(material.emissiveTexture);
+    if (material.normalTexture.has_value())
+    {
+        desc.normalScale = material.normalTexture->scale;
+    }
+    if (material.occlusionTexture.has_value())
+    {
+        desc.occlusionStrength = material.occlusionTexture->strength;
+    }
+    if (material.alphaMode == fastgltf::AlphaMode::Mask)
+    {
+        desc.alphaMode = rsbl::MaterialAlphaMode::Mask;
+    }
+    else if (material.alphaMode == fastgltf::AlphaMode::Blend)
+    {
+        desc.alphaMode = rsbl::MaterialAlphaMode::Blend;
+    }
+    desc.doubleSided = material.doubleSided;
+    desc.unlit = material.unlit;
+    return desc;
+}
 
 void print_gltf_stats(const fastgltf::Asset& asset)
 {
@@ -71,6 +139,20 @@ void print_gltf_stats(const fastgltf::Asset& asset)
                 RSBL_LOG_INFO("  Material {}", i);
             }
         }
+
+        rsbl::MaterialTable materials;
+        for (const fastgltf::Material& material : asset.materials)
+        {
+            materials.Add(material_desc(material));
+        }
+        uint32 pipelines = 0;
+        for (uint32 pipeline = 0; pipeline < rsbl::kMaterialPipelineCount; ++pipeline)
+        {
+            pipelines += materials.PipelineUseCount(pipeline) > 0 ? 1 : 0;
+        }
+        RSBL_LOG_INFO("  Packed into {} bytes, drawn with {} pipelines",
+                      materials.Materials().Size() * sizeof(rsbl::GpuMaterial),
+                      pipelines);
     }
 
     // Buffer sizes
@@ -101,10 +183,590 @@ void print_gltf_stats(const fastgltf::Asset& asset)
     RSBL_LOG_INFO("");
 }
 
+void print_cooked_stats(const rsbl::CookedMesh& cooked)
+{
+    RSBL_LOG_INFO("Cooked mesh: {} meshes, {} submeshes, {} nodes",
+                  cooked.Meshes().Size(),
+                  cooked.Submeshes().Size(),
+                  cooked.Nodes().Size());
+    RSBL_LOG_INFO("  {} vertices, {} indices, {} meshlets, {} lods",
+                  cooked.Vertices().Size(),
+                  cooked.Indices().Size(),
+                  cooked.Meshlets().Size(),
+                  cooked.Lods().Size());
+
+    // What the uploads will copy out of the mapping
+    uint64 total_bytes = 0;
+    for (uint32 i = 0; i < static_cast<uint32>(rsbl::CookedMeshSection::Count); ++i)
+    {
+        total_bytes += cooked.Section(static_cast<rsbl::CookedMeshSection>(i)).Size();
+    }
+    RSBL_LOG_INFO("  {:.2f} MB of GPU-ready data", total_bytes / (1024.0 * 1024.0));
+}
+
+// Loads the glTF on the job system and cooks it to cooked_path, timing both into progress.
+// Returns false if either step failed.
+bool cook_from_gltf(rsbl::JobSystem& jobs,
+                    const std::string& file_path,
+                    const char* cooked_path,
+                    GltfLoadProgress& progress)
+{
+    LoadedGltf loaded;
+    if (auto load = load_gltf(jobs, file_path, loaded, progress); !load)
+    {
+        RSBL_LOG_ERROR("Failed to load glTF: {}", load.FailureText());
+        return false;
+    }
+
+    RSBL_LOG_INFO("Successfully loaded glTF file!");
+
+    // Print statistics
+    print_gltf_stats(loaded.asset);
+
+    // The cache keys on content, so where the source lives and when it changed stay out of it
+    RSBL_LOG_INFO("Cooking to {}", cooked_path);
+    start_load_stage(progress, GltfLoadStage::Cook, 1);
+    const GltfLoadItem item = start_load_item();
+    if (auto cooked = cook_gltf(loaded, cooked_path, rsbl::CookedMeshSource{}); !cooked)
+    {
+        RSBL_LOG_ERROR("Failed to cook glTF: {}", cooked.FailureText());
+        return false;
+    }
+    const rsbl::Result<rsbl::FileInfo> info = rsbl::GetFileInfo(cooked_path);
+    finish_load_item(jobs, progress, GltfLoadStage::Cook, item, info ? info.Value().size : 0);
+    return true;
+}
+
+// The cooked node tree, flattened for transform updates
+bool build_scene_graph(const rsbl::CookedMesh& cooked, rsbl::SceneGraph& graph)
+{
+    const rsbl::ArrayView<const rsbl::CookedNode> nodes = cooked.Nodes();
+    rsbl::DynamicArray<uint32> parents(rsbl::GetTaggedAllocator(rsbl::MemoryTag::Scene));
+    rsbl::DynamicArray<rsbl::SceneTransform> locals(
+        rsbl::GetTaggedAllocator(rsbl::MemoryTag::Scene));
+    parents.Reserve(nodes.Size());
+    locals.Reserve(nodes.Size());
+    for (const rsbl::CookedNode& node : nodes)
+    {
+        parents.PushBack(node.parent < 0 ? rsbl::SceneGraph::kNoParent
+                                         : static_cast<uint32>(node.parent));
+        rsbl::SceneTransform local;
+        local.translation = rsbl::simd::Load(node.translation);
+        local.rotation = rsbl::simd::quat(rsbl::simd::Load(node.rotation));
+        local.scale = rsbl::simd::Load(node.scale);
+        locals.PushBack(local);
+    }
+
+    if (auto built = graph.Build(parents, locals); !built)
+    {
+        RSBL_LOG_ERROR("Failed to build the scene graph: {}", built.FailureText());
+        return false;
+    }
+    RSBL_LOG_INFO("Scene graph: {} nodes in {} levels", graph.NodeCount(), graph.LevelCount());
+    return true;
+}
+
+// Stops the capture of the load and writes it out, the first time it's called with a path
+void finish_load_trace(rsbl::JobSystem& jobs, std::string& trace_path)
+{
+    if (trace_path.empty())
+    {
+        return;
+    }
+    jobs.StopTrace();
+    if (auto written = jobs.WriteChromeTrace(trace_path.c_str()); !written)
+    {
+        RSBL_LOG_ERROR("Failed to write the trace: {}", written.FailureText());
+    }
+    else
+    {
+        RSBL_LOG_INFO("Wrote the load's trace to {}", trace_path);
+    }
+    trace_path.clear();
+}
+
+// With --pacing, where each frame's time goes on its way to the screen, by device frame. Which
+// device frame each present was is kept a few presents back, to put the displays that present
+// statistics report later back on their frames.
+struct FramePacingState
+{
+    static constexpr uint32 kPresentHistory = 16;
+
+    rsbl::FramePacing pacing{rsbl::Clock::TicksPerSecond()};
+    uint64 presentFrames[kPresentHistory] = {};
+    uint64 lastDisplayed = 0;
+    bool noPresentStats = false;
+    // Logged as it changes, composed presents are a refresh later than they need be
+    rsbl::gaPresentPath path = rsbl::gaPresentPath::Unknown;
+};
+
+const char* present_path_name(rsbl::gaPresentPath path)
+{
+    switch (path)
+    {
+    case rsbl::gaPresentPath::Composed:
+        return "through the compositor";
+    case rsbl::gaPresentPath::IndependentFlip:
+        return "by independent flip";
+    case rsbl::gaPresentPath::Overlay:
+        return "on an overlay plane";
+    default:
+        return "some way unknown";
+    }
+}
+
+// Marks the latest present the display showed on its frame
+void mark_displayed(FramePacingState& state, rsbl::gaSwapchain* swapchain)
+{
+    if (state.noPresentStats)
+    {
+        return;
+    }
+    auto stats = rsbl::GaGetPresentStats(swapchain);
+    if (!stats)
+    {
+        // Not something that comes and goes, so pacing goes on without displays
+        RSBL_LOG_WARNING("No present statistics, pacing is to presents only: {}",
+                         stats.FailureText());
+        state.noPresentStats = true;
+        return;
+    }
+
+    const rsbl::gaPresentStats& shown = stats.Value();
+    if (shown.path != state.path)
+    {
+        RSBL_LOG_INFO("Presents now reach the screen {}", present_path_name(shown.path));
+        state.path = shown.path;
+    }
+    if (shown.displayedPresent > state.lastDisplayed &&
+        shown.displayedPresent + FramePacingState::kPresentHistory > shown.presentCount)
+    {
+        const uint64 frame =
+            state.presentFrames[shown.displayedPresent % FramePacingState::kPresentHistory];
+        state.pacing.Mark(frame, rsbl::FrameStage::Displayed, shown.displayedTicks);
+    }
+    state.lastDisplayed = shown.displayedPresent;
+}
+
+void log_frame_pacing(const FramePacingState& state)
+{
+    rsbl::String text;
+    rsbl::AppendFramePacingReport(text, state.pacing.Report());
+    RSBL_LOG_INFO("{}", text.CStr());
+}
+
+// What --render-scale renders a window of size at. 0 stays 0, a minimized window's size.
+rsbl::uint2 scaled_size(rsbl::uint2 size, float scale)
+{
+    auto scaled = [scale](uint32 pixels) -> uint32 {
+        const uint32 rounded = static_cast<uint32>(static_cast<float>(pixels) * scale + 0.5f);
+        return pixels == 0 ? 0 : (rounded > 0 ? rounded : 1);
+    };
+    return rsbl::uint2(scaled(size.x), scaled(size.y));
+}
+
+// Records the frame's command list and submits it. Nothing is drawn yet, so the list is empty,
+// but its submit is what the next GaBeginFrame on its slot waits for. The back buffer is read
+// back for a capture between the submit and the present.
+bool submit_frame(rsbl::gaDevice* device,
+                  rsbl::gaSwapchain* swapchain,
+                  FramePacingState* pacing,
+                  FrameCapture* capture)
+{
+    auto list = rsbl::GaBeginCommandList(device, rsbl::gaQueueType::Graphics, 0);
+    if (!list)
+    {
+        RSBL_LOG_ERROR("Failed to begin the frame's command list: {}", list.FailureText());
+        return false;
+    }
+
+    // The back buffer's last contents are a frame old, nothing reads them
+    rsbl::gaBarrier to_target{};
+    to_target.resource = swapchain->backBuffer;
+    to_target.before = rsbl::gaResourceState::Present;
+    to_target.after = rsbl::gaResourceState::ColorTarget;
+    to_target.discard = true;
+    rsbl::gaBarrier to_present = to_target;
+    to_present.before = rsbl::gaResourceState::ColorTarget;
+    to_present.after = rsbl::gaResourceState::Present;
+    to_present.discard = false;
+    const bool back_buffer = swapchain->backBuffer != nullptr;
+
+    {
+        // The frame's GPU time, what the benchmark reports
+        GA_GPU_ZONE(list.Value(), "Frame");
+
+        if (back_buffer)
+        {
+            if (auto recorded = rsbl::GaCmdBarriers(list.Value(), {&to_target, 1}); !recorded)
+            {
+                RSBL_LOG_ERROR("Failed to record the frame's barriers: {}",
+                               recorded.FailureText());
+                return false;
+            }
+        }
+
+        // do stuff? Until Loaded, draws stick to each submesh's coarsest lod.
+
+        if (back_buffer)
+        {
+            if (auto recorded = rsbl::GaCmdBarriers(list.Value(), {&to_present, 1}); !recorded)
+            {
+                RSBL_LOG_ERROR("Failed to record the frame's barriers: {}",
+                               recorded.FailureText());
+                return false;
+            }
+        }
+    }
+
+    if (auto resolved = rsbl::GaCmdResolveGpuZones(list.Value()); !resolved)
+    {
+        RSBL_LOG_ERROR("Failed to resolve the frame's GPU zones: {}", resolved.FailureText());
+        return false;
+    }
+
+    if (auto ended = rsbl::GaEndCommandList(list.Value()); !ended)
+    {
+        RSBL_LOG_ERROR("Failed to end the frame's command list: {}", ended.FailureText());
+        return false;
+    }
+    rsbl::gaCommandList* lists[] = {list.Value()};
+    if (pacing != nullptr)
+    {
+        pacing->pacing.Mark(device->frame, rsbl::FrameStage::Submit, rsbl::Clock::NowTicks());
+    }
+    if (auto submitted = rsbl::GaSubmit(device, rsbl::gaQueueType::Graphics, lists); !submitted)
+    {
+        RSBL_LOG_ERROR("Failed to submit the frame: {}", submitted.FailureText());
+        return false;
+    }
+    if (capture != nullptr)
+    {
+        if (auto captured = capture_back_buffer(*capture, swapchain); !captured)
+        {
+            RSBL_LOG_ERROR("Failed to capture the frame: {}", captured.FailureText());
+            return false;
+        }
+    }
+
+    if (pacing != nullptr)
+    {
+        pacing->pacing.Mark(device->frame, rsbl::FrameStage::Present, rsbl::Clock::NowTicks());
+        const uint64 present = swapchain->presentCount + 1;
+        pacing->presentFrames[present % FramePacingState::kPresentHistory] = device->frame;
+    }
+    if (auto presented = rsbl::GaPresent(swapchain); !presented)
+    {
+        RSBL_LOG_ERROR("Failed to present: {}", presented.FailureText());
+        return false;
+    }
+    return true;
+}
+
+// Ends the frame's counters, after gauging what the memory tracking saw of it. Twice a second or
+// so the window's title shows them, until there's a UI to put them in.
+void end_counters_frame(rsbl::Window* window, uint64 frame)
+{
+    uint64 frame_allocations = 0;
+    uint64 live_bytes = 0;
+    for (uint32 tag = 0; tag < static_cast<uint32>(rsbl::MemoryTag::Count); ++tag)
+    {
+        const rsbl::MemoryStats stats = rsbl::GetMemoryStats(static_cast<rsbl::MemoryTag>(tag));
+        frame_allocations += stats.lastFrameAllocations;
+        live_bytes += stats.liveBytes;
+    }
+    RSBL_GAUGE_SET("mem.frame_allocations", frame_allocations);
+    RSBL_GAUGE_SET("mem.live_bytes", live_bytes);
+    rsbl::Counters::EndFrame();
+
+    if (window != nullptr && frame % 30 == 0)
+    {
+        rsbl::String title("gltf-viewer | ");
+        rsbl::Counters::BuildOverlay(title, " | ");
+        window->SetTitle(title.CStr());
+    }
+}
+
+// On battery, in a power saving mode or running hot, only half the workers take jobs and frames
+// are held to kPowerSaveFps at most. Otherwise every worker does, at the --fps-limit.
+void apply_power_policy(bool constrained,
+                        double fps_limit,
+                        rsbl::JobSystem& jobs,
+                        rsbl::FrameLimiter& limiter)
+{
+    constexpr double kPowerSaveFps = 30.0;
+    jobs.SetActiveWorkerLimit(constrained ? jobs.WorkerCount() / 2 : ~0u);
+    const bool capped = constrained && (fps_limit <= 0.0 || fps_limit > kPowerSaveFps);
+    limiter.SetFrameRate(capped ? kPowerSaveFps : fps_limit);
+    RSBL_LOG_INFO("{} power: {} of {} workers take jobs, frames limited to {} fps (0 for none)",
+                  constrained ? "Saving" : "Not saving",
+                  jobs.ActiveWorkerLimit(),
+                  jobs.WorkerCount(),
+                  limiter.FrameRate());
+}
+
+// Benchmark frames turn the roots about y, a full turn over the run, so that every frame
+// recomputes every world transform the same way on every run
+void spin_roots(rsbl::SceneGraph& graph,
+                rsbl::ArrayView<const rsbl::SceneTransform> root_locals,
+                uint32 frame,
+                uint32 frame_count)
+{
+    constexpr float kTwoPi = 6.2831853f;
+    const float angle = kTwoPi * static_cast<float>(frame) / static_cast<float>(frame_count);
+    const rsbl::simd::quat spin =
+        rsbl::simd::QuatFromAxisAngle(rsbl::simd::float4(0.0f, 1.0f, 0.0f, 0.0f), angle);
+    for (uint32 root = 0; root < root_locals.Size(); ++root)
+    {
+        rsbl::SceneTransform local = root_locals[root];
+        local.rotation = spin * local.rotation;
+        local.translation = rsbl::simd::Rotate(spin, local.translation);
+        graph.SetLocal(root, local);
+    }
+}
+
+// Puts the GPU zones just read back on the trace's GPU track, and keeps the benchmark's timed
+// frames' times: their outermost "Frame" zone. Its end is when the GPU finished the frame, for
+// pacing.
+void collect_gpu_zones(rsbl::JobSystem& jobs,
+                       const rsbl::gaGpuProfiler& profiler,
+                       uint64 first_timed_frame,
+                       uint32 timed_frames,
+                       rsbl::DynamicArray<uint64>& gpu_frame_ns,
+                       FramePacingState* pacing)
+{
+    const bool timed = first_timed_frame != 0 && profiler.zoneFrame >= first_timed_frame &&
+                       profiler.zoneFrame < first_timed_frame + timed_frames;
+    const double ns_per_tick = 1e9 / static_cast<double>(rsbl::Clock::TicksPerSecond());
+    for (uint32 i = 0; i < profiler.zoneCount; ++i)
+    {
+        const rsbl::gaGpuZone& zone = profiler.zones[i];
+        jobs.TraceGpuZone(zone.name, zone.startTicks, zone.endTicks);
+        if (zone.depth != 0 || std::strcmp(zone.name, "Frame") != 0)
+        {
+            continue;
+        }
+        if (timed)
+        {
+            gpu_frame_ns.PushBack(static_cast<uint64>(
+                static_cast<double>(zone.endTicks - zone.startTicks) * ns_per_tick));
+        }
+        // Uncalibrated zones don't sit on the CPU's timeline
+        if (pacing != nullptr && !profiler.uncalibrated)
+        {
+            pacing->pacing.Mark(profiler.zoneFrame, rsbl::FrameStage::GpuDone, zone.endTicks);
+        }
+    }
+}
+
+// The pipelines a run asked for, with the driver's compiled copies of them, saved for the next
+// run to compile before anything draws with them (GaSerializePipelineCache). One file per
+// backend, each has driver data of its own.
+std::string pipeline_cache_file(const std::string& cache_dir, rsbl::gaBackend backend)
+{
+    const char* name = backend == rsbl::gaBackend::DX12     ? "dx12"
+                       : backend == rsbl::gaBackend::Vulkan ? "vulkan"
+                                                            : "null";
+    return cache_dir + "/pipelines-" + name + ".bin";
+}
+
+// What the last run saved, left empty when it saved nothing
+rsbl::Result<> read_pipeline_cache(const char* path, rsbl::DynamicArray<uint8>& data)
+{
+    rsbl::Result<rsbl::FileInfo> info = rsbl::GetFileInfo(path);
+    if (!info)
+    {
+        if (info.Category() == rsbl::ErrorCategory::NotFound)
+        {
+            return rsbl::ResultCode::Success;
+        }
+        return rsbl::PendingFailure{info.Category()};
+    }
+    data.ResizeUninitialized(info.Value().size);
+    rsbl::Result<uint64> read =
+        rsbl::OpenAndReadFile(path, rsbl::MutableByteView(data.Data(), data.Size()));
+    if (!read)
+    {
+        data.Clear();
+        return rsbl::PendingFailure{read.Category()};
+    }
+    data.Resize(read.Value());
+    return rsbl::ResultCode::Success;
+}
+
+// Written beside the file and renamed over it, so a run that dies halfway through leaves the
+// last one's
+rsbl::Result<> write_pipeline_cache(const char* path, rsbl::gaPipelineCache* cache)
+{
+    rsbl::DynamicArray<uint8> data;
+    if (auto serialized = rsbl::GaSerializePipelineCache(cache, data); !serialized)
+    {
+        return serialized;
+    }
+
+    const std::string temp_path = std::string(path) + ".tmp";
+    auto file = rsbl::OpenFile(temp_path.c_str(), rsbl::FileOpenMode::Write);
+    if (!file)
+    {
+        return rsbl::PendingFailure{file.Category()};
+    }
+    auto written = rsbl::WriteFile(file.Value(), rsbl::ByteView(data.Data(), data.Size()));
+    rsbl::Result<> closed = rsbl::CloseFile(file.Value());
+    if (!written)
+    {
+        return rsbl::PendingFailure{written.Category()};
+    }
+    if (!closed)
+    {
+        return closed;
+    }
+    return rsbl::RenameFile(temp_path.c_str(), path);
+}
+
+// How far the scene has got. The window presents from the start; the scene can be drawn at its
+// coarsest lods from Interactive on, and at any lod once Loaded.
+enum class SceneLoadStage : uint32
+{
+    Loading,
+    Interactive,
+    Loaded,
+    Failed,
+};
+
+struct SceneLoad
+{
+    std::atomic<SceneLoadStage> stage{SceneLoadStage::Loading};
+    // The glTF's derived data key, set before stage leaves Loading
+    rsbl::DerivedDataKey key;
+    // Set before stage leaves Loading, left alone after
+    rsbl::UniquePtr<rsbl::CookedMesh> cooked;
+    // Clock::NowNs when loading started, became interactive and finished
+    uint64 startNs = 0;
+    uint64 interactiveNs = 0;
+    uint64 loadedNs = 0;
+    // Each stage's times, summed up in the log once loaded
+    GltfLoadProgress progress;
+};
+
+// Touches a byte of every page, so they're all in memory once it returns. Stands in for the
+// uploads, which will copy the sections out of the mapping the same way.
+uint64 fault_in(rsbl::ByteView bytes)
+{
+    constexpr uint64 kPageSize = 4096;
+    uint64 sum = 0;
+    for (uint64 offset = 0; offset < bytes.Size(); offset += kPageSize)
+    {
+        sum += static_cast<const volatile uint8*>(bytes.Data())[offset];
+    }
+    return sum;
+}
+
+// Runs on a job while the window is already presenting: finds the cooked mesh in the cache or
+// cooks it, brings in its coarsest lods and the tables first, then everything else
+void load_scene(rsbl::JobSystem& jobs,
+                rsbl::DerivedDataCache& cache,
+                const std::string& file_path,
+                bool recook,
+                SceneLoad& load)
+{
+    auto key = gltf_mesh_key(file_path);
+    if (!key)
+    {
+        RSBL_LOG_ERROR("Failed to read {}: {}", file_path, key.FailureText());
+        load.stage.store(SceneLoadStage::Failed, std::memory_order_release);
+        return;
+    }
+    load.key = key.Value();
+
+    rsbl::Result<rsbl::String> cooked_path = {rsbl::ErrorCategory::NotFound, "Recooking"};
+    if (!recook)
+    {
+        cooked_path = cache.Find(key.Value());
+    }
+    if (!cooked_path)
+    {
+        RSBL_LOG_INFO("Loading glTF file: {}", file_path);
+        const rsbl::String temp_path = cache.TempPath();
+        if (!cook_from_gltf(jobs, file_path, temp_path.CStr(), load.progress))
+        {
+            load.stage.store(SceneLoadStage::Failed, std::memory_order_release);
+            return;
+        }
+        if (auto put = cache.PutFile(key.Value(), temp_path.CStr()); !put)
+        {
+            RSBL_LOG_ERROR("Failed to add the cooked mesh to the cache: {}", put.FailureText());
+            load.stage.store(SceneLoadStage::Failed, std::memory_order_release);
+            return;
+        }
+        cooked_path = cache.LocalPath(key.Value());
+    }
+
+    auto opened = rsbl::CookedMesh::Open(cooked_path.Value().CStr());
+    if (!opened)
+    {
+        RSBL_LOG_ERROR("Failed to open cooked mesh: {}", opened.FailureText());
+        load.stage.store(SceneLoadStage::Failed, std::memory_order_release);
+        return;
+    }
+    RSBL_LOG_INFO("Loaded cooked mesh: {}", cooked_path.Value().CStr());
+
+    const rsbl::DerivedDataCacheStats cache_stats = cache.Stats();
+    RSBL_LOG_INFO("Derived data cache: {} local hits, {} shared hits, {} cooked",
+                  cache_stats.localHits,
+                  cache_stats.sharedHits,
+                  cache_stats.puts);
+
+    // The node tree and every submesh's coarsest lod are enough for a first frame. The rest
+    // comes in behind them, the finer lods and meshlets being the bulk of the file.
+    const rsbl::CookedMesh& cooked = *opened.Value();
+    start_load_stage(load.progress, GltfLoadStage::Upload, 2);
+    GltfLoadItem item = start_load_item();
+    cooked.PrefetchCoarsestLods();
+    const rsbl::ByteView vertices = cooked.Section(rsbl::CookedMeshSection::Vertices);
+    fault_in(vertices);
+    finish_load_item(jobs, load.progress, GltfLoadStage::Upload, item, vertices.Size());
+    load.cooked = rsblMove(opened.Value());
+    load.interactiveNs = rsbl::Clock::NowNs();
+    load.stage.store(SceneLoadStage::Interactive, std::memory_order_release);
+
+    item = start_load_item();
+    cooked.Prefetch();
+    uint64 rest_bytes = 0;
+    for (uint32 i = 0; i < static_cast<uint32>(rsbl::CookedMeshSection::Count); ++i)
+    {
+        const rsbl::ByteView section = cooked.Section(static_cast<rsbl::CookedMeshSection>(i));
+        fault_in(section);
+        rest_bytes += section.Size();
+    }
+    finish_load_item(
+        jobs, load.progress, GltfLoadStage::Upload, item, rest_bytes - vertices.Size());
+
+    RSBL_LOG_INFO("Load stages:");
+    log_gltf_load_timings(load.progress);
+    load.loadedNs = rsbl::Clock::NowNs();
+    load.stage.store(SceneLoadStage::Loaded, std::memory_order_release);
+}
+
+// The stage a replayed frame draws at: the one it was drawn at when recorded. Waits for a load
+// that hasn't got that far yet, and holds back one that's further along.
+SceneLoadStage replay_stage(const SceneLoad& load, SceneLoadStage recorded)
+{
+    SceneLoadStage stage = load.stage.load(std::memory_order_acquire);
+    while (stage < recorded)
+    {
+        rsbl::Thread::ThreadYield();
+        stage = load.stage.load(std::memory_order_acquire);
+    }
+    return stage == SceneLoadStage::Failed ? stage : recorded;
+}
+
 int main(int argc, char** argv)
 {
     rsbl::LogInit("logs/gltf_viewer.log");
 
+    // Dump per-subsystem memory stats every ~10 seconds at 60Hz
+    rsbl::SetMemoryStatsLogInterval(600);
+
     CLI::App app(
         "GLTF viewer - A real-time glTF renderer supporting D3D12, Vulkan, and Null backends");
 
@@ -115,8 +777,163 @@ int main(int argc, char** argv)
     app.add_option("-b,--backend", backend_str, "Graphics backend (d3d12, vulkan, or null)")
         ->check(CLI::IsMember({"d3d12", "vulkan", "null"}));
 
+    std::string present_str = "vsync";
+    app.add_option("--present",
+                   present_str,
+                   "Present mode (vsync, mailbox, immediate, or vrr), falling back where there's "
+                   "no support")
+        ->check(CLI::IsMember({"vsync", "mailbox", "immediate", "vrr"}));
+
+    std::string adapter_str;
+    app.add_option("--adapter", adapter_str, "Run on the GPU whose name contains this");
+
+    std::string power_str = "high";
+    app.add_option("--power",
+                   power_str,
+                   "Which GPU to prefer: high for discrete ones, low for integrated ones")
+        ->check(CLI::IsMember({"high", "low"}));
+
+    bool recook = false;
+    app.add_flag("--recook", recook, "Cook the glTF again even if the cache already has it");
+
+    std::string cache_dir = "derived-data";
+    app.add_option("--cache-dir", cache_dir, "Where cooked assets are kept on this machine");
+
+    std::string shared_cache_dir;
+    app.add_option("--shared-cache",
+                   shared_cache_dir,
+                   "A shared cache, usually a network share, to fetch cooked assets from");
+
+    bool read_only_shared = false;
+    app.add_flag("--read-only-shared-cache",
+                 read_only_shared,
+                 "Fetch from the shared cache without adding what's cooked here");
+
+    std::string pipeline_cache_path;
+    app.add_option("--pipeline-cache",
+                   pipeline_cache_path,
+                   "Where the pipelines this run makes are saved, for the next run to compile at "
+                   "start-up. Defaults to a file per backend in the cache directory.");
+
+    uint32 benchmark_frames = 0;
+    app.add_option("--benchmark",
+                   benchmark_frames,
+                   "Once loaded, time this many frames of a fixed workload, then quit");
+
+    uint32 warmup_frames = 60;
+    app.add_option("--warmup", warmup_frames, "Frames to run before timing starts");
+
+    std::string report_path;
+    app.add_option("--report", report_path, "Where to write the benchmark results as JSON");
+
+    std::string stats_path;
+    app.add_option("--stats",
+                   stats_path,
+                   "Write each frame's draws, uploads, jobs, IO bytes and allocations here every "
+                   "60 frames, as JSON if it ends in .json and CSV otherwise");
+
+    std::string trace_path;
+    app.add_option("--trace",
+                   trace_path,
+                   "Write the job system's activity while loading as a Chrome trace, with each "
+                   "load stage's items and bytes");
+
+    double fps_limit = 0.0;
+    app.add_option("--fps-limit",
+                   fps_limit,
+                   "Hold frames to this rate on a high resolution timer, with or without vsync");
+
+    std::string fullscreen_str = "windowed";
+    app.add_option("--fullscreen",
+                   fullscreen_str,
+                   "Window mode (windowed, borderless, or exclusive). Borderless and exclusive "
+                   "both cover the monitor; exclusive takes the output over where the backend "
+                   "can, DX12 only, and falls back to borderless")
+        ->check(CLI::IsMember({"windowed", "borderless", "exclusive"}));
+
+    float render_scale = 1.0f;
+    app.add_option("--render-scale",
+                   render_scale,
+                   "Render at this fraction of the window's size, stretched over it when "
+                   "presented. Below 1 on HiDPI displays to not render every physical pixel. "
+                   "DX12 and null only for now.")
+        ->check(CLI::Range(0.25f, 1.0f));
+
+    bool power_aware = false;
+    app.add_flag("--power-aware",
+                 power_aware,
+                 "Use half the workers and at most 30 fps while on battery, in a power saving "
+                 "mode, or with the CPU throttled");
+
+    bool pacing_enabled = false;
+    app.add_flag("--pacing",
+                 pacing_enabled,
+                 "Log where frames' time goes from input to display, and how evenly they're "
+                 "shown, every 600 frames");
+
+    std::string record_path;
+    auto* record_option = app.add_option(
+        "--record",
+        record_path,
+        "Write down what each frame took from the window and the load, for --replay");
+
+    std::string replay_path;
+    app.add_option("--replay",
+                   replay_path,
+                   "Run a recorded session's frames again, with the same sizes, load stages and "
+                   "animation, and compare their times with the recorded ones")
+        ->check(CLI::ExistingFile)
+        ->excludes(record_option);
+
+    std::string capture_dir;
+    auto* capture_option =
+        app.add_option("--capture",
+                       capture_dir,
+                       "Write every frame shown to this directory as numbered TGAs, read back "
+                       "without waiting on the GPU");
+
+    std::string screenshot_path;
+    app.add_option("--screenshot",
+                   screenshot_path,
+                   "Write the first frame drawn with the scene loaded to this TGA, then quit")
+        ->excludes(capture_option);
+
+    bool offscreen = false;
+    app.add_flag("--headless",
+                 offscreen,
+                 "Render offscreen without a window, as fast as the GPU goes, for render farms "
+                 "and CI. Needs --benchmark, --replay or --screenshot to end it.");
+
+    std::vector<uint32> size_arg;
+    app.add_option("--size", size_arg, "Width and height of the window, or of a headless frame")
+        ->expected(2)
+        ->check(CLI::PositiveNumber);
+
     CLI11_PARSE(app, argc, argv);
 
+    const bool replaying = !replay_path.empty();
+    ReplaySession replay;
+    if (replaying)
+    {
+        if (auto read = read_replay(replay_path.c_str(), replay); !read)
+        {
+            RSBL_LOG_ERROR("Failed to read the replay: {}", read.FailureText());
+            return 1;
+        }
+        if (benchmark_frames > 0)
+        {
+            RSBL_LOG_WARNING("Replaying, --benchmark is ignored");
+            benchmark_frames = 0;
+        }
+    }
+
+    // Nothing closes a window that isn't there
+    if (offscreen && benchmark_frames == 0 && !replaying && screenshot_path.empty())
+    {
+        RSBL_LOG_ERROR("--headless needs --benchmark, --replay or --screenshot to end it");
+        return 1;
+    }
+
     // Convert backend string to enum
     rsbl::gaBackend selected_backend = rsbl::gaBackend::DX12; // Default
     if (backend_str == "d3d12")
@@ -125,109 +942,656 @@ int main(int argc, char** argv)
         selected_backend = rsbl::gaBackend::Vulkan;
     else if (backend_str == "null")
         selected_backend = rsbl::gaBackend::Null;
-
-    RSBL_LOG_INFO("Loading glTF file: {}", file_path);
-
-    // Create fastgltf parser
-    fastgltf::Parser parser;
-
-    // Determine file type
-    auto data = fastgltf::GltfDataBuffer::FromPath(file_path);
-    if (data.error() != fastgltf::Error::None)
+    // Vulkan swapchains take the window's own extent until present scaling is in, so a smaller
+    // one would quietly render at full size
+    if (selected_backend == rsbl::gaBackend::Vulkan && render_scale < 1.0f)
     {
-        RSBL_LOG_ERROR("Failed to load file: {}", fastgltf::getErrorMessage(data.error()));
+        RSBL_LOG_ERROR("--render-scale below 1 isn't supported on Vulkan yet");
         return 1;
     }
+    if (pipeline_cache_path.empty())
+    {
+        pipeline_cache_path = pipeline_cache_file(cache_dir, selected_backend);
+    }
 
-    // Parse options
-    constexpr auto gltfOptions =
-        fastgltf::Options::LoadExternalBuffers | fastgltf::Options::LoadExternalImages;
-
-    // Parse the glTF file
-    auto asset =
-        parser.loadGltf(data.get(), std::filesystem::path(file_path).parent_path(), gltfOptions);
-    if (asset.error() != fastgltf::Error::None)
+    rsbl::JobSystemOptions job_options;
+    job_options.traceEventsPerWorker = trace_path.empty() ? 0 : 64 * 1024;
+    auto jobs_result = rsbl::JobSystem::Create(job_options);
+    if (!jobs_result)
     {
-        RSBL_LOG_ERROR("Failed to parse glTF: {}", fastgltf::getErrorMessage(asset.error()));
+        RSBL_LOG_ERROR("Failed to start the job system: {}", jobs_result.FailureText());
         return 1;
     }
-
-    RSBL_LOG_INFO("Successfully loaded glTF file!");
-
-    // Print statistics
-    print_gltf_stats(asset.get());
-
-    RSBL_LOG_INFO("Starting window...");
-    rsbl::UniquePtr<rsbl::Window> window;
-    auto window_create_result = rsbl::Window::Create({640, 480});
-    if (window_create_result)
+    rsbl::UniquePtr<rsbl::JobSystem> jobs = rsblMove(jobs_result.Value());
+    if (!trace_path.empty())
     {
-        RSBL_LOG_INFO("Window created successfully!");
-        window = rsblMove(window_create_result.Value());
+        if (auto started = jobs->StartTrace(); !started)
+        {
+            RSBL_LOG_ERROR("Failed to start the trace: {}", started.FailureText());
+            return 1;
+        }
     }
-    else
+
+    if (!stats_path.empty())
     {
-        RSBL_LOG_ERROR("Failed to create window: {}", window_create_result.FailureText());
-        return 1;
+        const bool json = stats_path.ends_with(".json");
+        rsbl::Counters::SetDump(stats_path.c_str(),
+                                json ? rsbl::CounterDumpFormat::Json : rsbl::CounterDumpFormat::Csv,
+                                60);
     }
 
+    // A frame in flight per back buffer: the CPU records the next frame while the GPU works
+    // through the last, and only waits once it's a whole swapchain ahead
+    constexpr uint32 kSwapchainBuffers = 2;
+
+    // How often a window that's covered over still renders
+    constexpr uint32 kIdleFrameMs = 100;
+
+    // A null backend benchmark or replay has nothing to show, so it runs without a window, which
+    // lets it run on machines without a display. --headless renders to an offscreen swapchain
+    // instead of a window's, on any backend.
+    const bool benchmark = benchmark_frames > 0;
+    const bool headless =
+        offscreen || ((benchmark || replaying) && selected_backend == rsbl::gaBackend::Null);
+    const rsbl::uint2 asked_size =
+        size_arg.size() == 2 ? rsbl::uint2{size_arg[0], size_arg[1]} : rsbl::uint2{640, 480};
+    const rsbl::uint2 start_size =
+        replaying ? rsbl::uint2{replay.width, replay.height} : asked_size;
+
+    // Start-up runs as steps on the job system, so the cache, the driver and adapter start-up,
+    // and the window all come up at once and it only takes as long as the slowest way to a
+    // swapchain. Each step fills in one of these.
+    rsbl::UniquePtr<rsbl::DerivedDataCache> cache;
+    rsbl::UniquePtr<rsbl::Window> window;
     rsbl::gaDevice* device = nullptr;
+    rsbl::gaSwapchain* swapchain = nullptr;
+    rsbl::uint2 swapchain_size = start_size;
+    rsbl::gaGpuProfiler* gpu_profiler = nullptr;
+    rsbl::gaPipelineCache* pipeline_cache = nullptr;
+    rsbl::JobCounter pipeline_compiles;
+    SceneLoad load;
+    rsbl::JobCounter load_done;
+    rsbl::Bootstrap startup;
 
-    rsbl::gaDeviceCreateInfo create_info{};
-    create_info.backend = selected_backend;
+    // Cooked meshes come out of the derived data cache, keyed on the glTF's bytes, so an
+    // unchanged glTF is never parsed again and one cooked on another machine is just copied down.
+    // Presenting starts as soon as there's a swapchain, not once the scene is in: the cook or the
+    // cache lookup runs on the job system from here on and the loop picks up each stage as it's
+    // reached.
+    startup.AddStep("derived data cache", [&]() -> rsbl::Result<> {
+        rsbl::DerivedDataCacheOptions cache_options;
+        cache_options.localDirectory = cache_dir.c_str();
+        cache_options.sharedDirectory =
+            shared_cache_dir.empty() ? nullptr : shared_cache_dir.c_str();
+        cache_options.writeShared = !read_only_shared;
+        auto cache_result = rsbl::DerivedDataCache::Create(cache_options);
+        if (!cache_result)
+        {
+            return rsbl::PendingFailure{cache_result.Category()};
+        }
+        cache = rsblMove(cache_result.Value());
 
-    if (auto device_result = rsbl::GaCreateDevice(create_info))
-    {
+        load.startNs = rsbl::Clock::NowNs();
+        jobs->Submit([&]() { load_scene(*jobs, *cache, file_path, recook, load); },
+                     &load_done,
+                     rsbl::JobPriority::Low);
+        return rsbl::ResultCode::Success;
+    });
+
+    const uint32 device_step = startup.AddStep("device", [&]() -> rsbl::Result<> {
+        rsbl::gaDeviceCreateInfo create_info{};
+        create_info.backend = selected_backend;
+        create_info.framesInFlight = kSwapchainBuffers;
+        create_info.preferredAdapter = adapter_str.empty() ? nullptr : adapter_str.c_str();
+        create_info.powerPreference = power_str == "low"
+                                          ? rsbl::gaPowerPreference::MinimumPower
+                                          : rsbl::gaPowerPreference::HighPerformance;
+        auto device_result = rsbl::GaCreateDevice(create_info);
+        if (!device_result)
+        {
+            return rsbl::PendingFailure{device_result.Category()};
+        }
         device = device_result.Value();
         const char* backend_name = selected_backend == rsbl::gaBackend::DX12     ? "DX12"
                                    : selected_backend == rsbl::gaBackend::Vulkan ? "Vulkan"
                                                                                  : "Null";
-        RSBL_LOG_INFO("Graphics device successfully created (backend: {})", backend_name);
-    }
-    else
-    {
-        RSBL_LOG_ERROR("Failed to create graphics device: {}", device_result.FailureText());
-        return 1; // Fatal error - can't continue without a device
-    }
+        RSBL_LOG_INFO("Graphics device successfully created (backend: {}, adapter: {})",
+                      backend_name,
+                      device->adapterInfo.name);
+        return rsbl::ResultCode::Success;
+    });
 
-    rsbl::gaSwapchain* swapchain = nullptr;
+    // Every pipeline the last run made is compiled again now, on low priority jobs, alongside the
+    // rest of start-up and the scene load. After a driver update, when the driver's own copies
+    // are thrown out, that's what keeps the first frames from stalling on compiles.
+    const uint32 pipeline_step = startup.AddStep("pipeline cache", [&]() -> rsbl::Result<> {
+        rsbl::DynamicArray<uint8> data;
+        if (auto read = read_pipeline_cache(pipeline_cache_path.c_str(), data); !read)
+        {
+            RSBL_LOG_WARNING("Starting without saved pipelines: {}", read.FailureText());
+        }
+        rsbl::gaPipelineCacheCreateInfo cache_info{};
+        cache_info.device = device;
+        cache_info.data = rsbl::ArrayView<const uint8>(data.Data(), data.Size());
+        auto cache_result = rsbl::GaCreatePipelineCache(cache_info);
+        if (!cache_result)
+        {
+            return rsbl::PendingFailure{cache_result.Category()};
+        }
+        pipeline_cache = cache_result.Value();
 
-    rsbl::gaSwapchainCreateInfo swapchain_info{};
-    swapchain_info.device = device;
-    swapchain_info.appHandle = rsbl::GetApplicationHandle();
-    swapchain_info.windowHandle = window->GetNativeData().platform_handle;
-    const rsbl::uint2 window_size = window->Size();
-    swapchain_info.width = window_size.x;
-    swapchain_info.height = window_size.y;
-    swapchain_info.bufferCount = 2; // this is the default, but let's be explicit
+        rsbl::JobSystem* job_system = jobs.Get();
+        rsbl::GaSetPipelineScheduler(
+            pipeline_cache, [job_system, &pipeline_compiles](rsbl::gaPipelineTask&& task) {
+                job_system->Submit(rsblMove(task), &pipeline_compiles, rsbl::JobPriority::Low);
+            });
+        auto left = rsbl::GaPrecompilePipelines(pipeline_cache);
+        if (!left)
+        {
+            return rsbl::PendingFailure{left.Category()};
+        }
+        RSBL_LOG_INFO("Precompiling {} pipelines from the last run", left.Value());
+        return rsbl::ResultCode::Success;
+    });
+    startup.AddDependency(device_step, pipeline_step);
 
-    if (auto swapchain_result = rsbl::GaCreateSwapchain(swapchain_info))
+    // Its messages are pumped on a thread of their own, so the frame loop keeps presenting while
+    // the window is dragged or resized, and so it doesn't matter which thread creates it
+    constexpr uint32 kNoStep = ~0u;
+    uint32 window_step = kNoStep;
+    if (!headless)
     {
+        window_step = startup.AddStep("window", [&]() -> rsbl::Result<> {
+            rsbl::WindowCreateInfo window_info;
+            window_info.size = start_size;
+            window_info.threading = rsbl::WindowThreading::MessageThread;
+            auto window_create_result = rsbl::Window::Create(window_info);
+            if (!window_create_result)
+            {
+                return rsbl::PendingFailure{window_create_result.Category()};
+            }
+            window = rsblMove(window_create_result.Value());
+            RSBL_LOG_INFO("Window created successfully!");
+            return rsbl::ResultCode::Success;
+        });
+    }
+
+    const uint32 swapchain_step = startup.AddStep("swapchain", [&]() -> rsbl::Result<> {
+        rsbl::gaSwapchainCreateInfo swapchain_info{};
+        swapchain_info.device = device;
+        if (window)
+        {
+            const rsbl::WindowNativeData native = window->GetNativeData();
+            swapchain_info.appHandle = native.display_handle;
+            swapchain_info.windowHandle = native.platform_handle;
+        }
+        else
+        {
+            swapchain_info.appHandle = rsbl::GetApplicationHandle();
+            swapchain_info.windowHandle = nullptr;
+        }
+        // A replay draws at the recorded sizes whatever the window here does
+        if (window && !replaying)
+        {
+            swapchain_size = scaled_size(window->Size(), render_scale);
+        }
+        swapchain_info.width = swapchain_size.x;
+        swapchain_info.height = swapchain_size.y;
+        swapchain_info.bufferCount = kSwapchainBuffers;
+        swapchain_info.offscreen = offscreen;
+        swapchain_info.presentMode =
+            present_str == "mailbox"     ? rsbl::gaPresentMode::Mailbox
+            : present_str == "immediate" ? rsbl::gaPresentMode::Immediate
+            : present_str == "vrr"       ? rsbl::gaPresentMode::Vrr
+                                         : rsbl::gaPresentMode::Vsync;
+        auto swapchain_result = rsbl::GaCreateSwapchain(swapchain_info);
+        if (!swapchain_result)
+        {
+            return rsbl::PendingFailure{swapchain_result.Category()};
+        }
         swapchain = swapchain_result.Value();
         RSBL_LOG_INFO("Swapchain successfully created");
+
+        // The resize it brings comes through CheckResize like any other
+        if (window && fullscreen_str != "windowed")
+        {
+            window->SetMode(rsbl::WindowMode::Fullscreen);
+            if (fullscreen_str == "exclusive")
+            {
+                if (auto exclusive = rsbl::GaSetExclusiveFullscreen(swapchain, true); !exclusive)
+                {
+                    RSBL_LOG_WARNING("Staying borderless: {}", exclusive.FailureText());
+                }
+            }
+        }
+        return rsbl::ResultCode::Success;
+    });
+    startup.AddDependency(device_step, swapchain_step);
+    if (window_step != kNoStep)
+    {
+        startup.AddDependency(window_step, swapchain_step);
     }
-    else
+
+    // GPU zones for the trace and the benchmark's GPU frame times. The null backend has no GPU
+    // time to measure, so it doesn't start the profiler at all.
+    if (selected_backend != rsbl::gaBackend::Null)
     {
-        RSBL_LOG_ERROR("Failed to create swapchain: {}", swapchain_result.FailureText());
+        const uint32 profiler_step = startup.AddStep("gpu profiler", [&]() -> rsbl::Result<> {
+            if (auto profiler_result = rsbl::GaCreateGpuProfiler({device}))
+            {
+                gpu_profiler = profiler_result.Value();
+            }
+            else
+            {
+                RSBL_LOG_WARNING("No GPU zones: {}", profiler_result.FailureText());
+            }
+            return rsbl::ResultCode::Success;
+        });
+        startup.AddDependency(device_step, profiler_step);
+    }
+
+    const rsbl::Result<> started = startup.Run(*jobs);
+    rsbl::String timeline;
+    startup.BuildTimeline(timeline);
+    RSBL_LOG_INFO("{}", timeline.CStr());
+    if (!started)
+    {
+        RSBL_LOG_ERROR("Failed to start: {}", started.FailureText());
+        jobs->Wait(pipeline_compiles);
+        rsbl::GaDestroyPipelineCache(pipeline_cache);
+        rsbl::GaDestroyGpuProfiler(gpu_profiler);
+        rsbl::GaDestroySwapchain(swapchain);
         rsbl::GaDestroyDevice(device);
-        return 1; // Fatal error - can't continue without a swapchain
+        jobs->Wait(load_done);
+        return 1;
+    }
+
+    SceneLoadStage seen_stage = SceneLoadStage::Loading;
+    bool pipelines_warming = true;
+    rsbl::SceneGraph scene_graph;
+    uint64 frames = 0;
+    bool failed = false;
+    rsbl::UniquePtr<FramePacingState> pacing;
+    if (pacing_enabled)
+    {
+        pacing = rsbl::MakeUnique<FramePacingState>();
+    }
+    rsbl::UniquePtr<rsbl::FrameLimiter> limiter;
+    if (fps_limit > 0.0 || power_aware)
+    {
+        auto limiter_result = rsbl::FrameLimiter::Create(fps_limit);
+        if (limiter_result)
+        {
+            limiter = rsblMove(limiter_result.Value());
+        }
+        else
+        {
+            RSBL_LOG_WARNING("Frames won't be limited: {}", limiter_result.FailureText());
+        }
+    }
+    // The monitor's thread only says what to do, the frame loop does it
+    std::atomic<bool> power_constrained{false};
+    bool saving_power = false;
+    rsbl::UniquePtr<rsbl::PowerMonitor> power_monitor;
+    if (power_aware && limiter)
+    {
+        auto monitor_result = rsbl::PowerMonitor::Create([&](const rsbl::PowerState& state) {
+            power_constrained.store(rsbl::IsPowerConstrained(state), std::memory_order_relaxed);
+        });
+        if (monitor_result)
+        {
+            power_monitor = rsblMove(monitor_result.Value());
+        }
+        else
+        {
+            RSBL_LOG_WARNING("Power use won't be adjusted: {}", monitor_result.FailureText());
+        }
+    }
+
+    // Benchmark frames are counted from the first one after the scene is fully loaded
+    uint32 benchmark_frame = 0;
+    rsbl::DynamicArray<rsbl::SceneTransform> root_locals;
+    rsbl::DynamicArray<uint64> frame_ns;
+    frame_ns.Reserve(benchmark_frames);
+    // GPU frame times are read back frames late, so the benchmark runs on until the last timed
+    // frame's are in. The device frame the timed frames start at, 0 until then.
+    const uint32 readback_frames = gpu_profiler != nullptr ? device->framesInFlight : 0;
+    uint64 first_timed_frame = 0;
+    rsbl::DynamicArray<uint64> gpu_frame_ns;
+    gpu_frame_ns.Reserve(benchmark_frames);
+    // The roots turn over the benchmark's frames, or as they did in the replay
+    const uint32 spin_frames =
+        replaying ? replay.spinFrames : (benchmark ? warmup_frames + benchmark_frames : 0);
+    uint32 spin_frame = 0;
+    ReplaySession recording;
+    recording.width = swapchain_size.x;
+    recording.height = swapchain_size.y;
+    recording.spinFrames = spin_frames;
+    rsbl::DynamicArray<uint64> replayed_ns;
+    // A screenshot arms the capture once the scene is loaded, --capture every frame from the start
+    const bool capturing = !capture_dir.empty() || !screenshot_path.empty();
+    FrameCapture capture;
+    capture.everyFrame = !capture_dir.empty();
+    capture.path = capture.everyFrame ? capture_dir : screenshot_path;
+    capture.armed = capture.everyFrame;
+    if (capturing)
+    {
+        if (auto created = create_frame_capture(device, swapchain, capture); !created)
+        {
+            RSBL_LOG_ERROR("Failed to start capturing: {}", created.FailureText());
+            failed = true;
+        }
+    }
+    while (!failed)
+    {
+        if (replaying && frames == replay.frames.Size())
+        {
+            break;
+        }
+        // With nothing of the window showing, the loop sleeps in the window's wait for a message
+        // rather than render flat out to nowhere. Minimized, it draws nothing; occluded, a frame
+        // every kIdleFrameMs, whose present finds out when the window shows again. Benchmarks
+        // and replays time every frame, so they render regardless.
+        if (window && !benchmark && !replaying && (window->IsMinimized() || swapchain->occluded))
+        {
+            if (window->WaitForEvents(kIdleFrameMs) == rsbl::WindowMessageResult::Quit)
+            {
+                break;
+            }
+            if (window->IsMinimized())
+            {
+                continue;
+            }
+        }
+        if (power_monitor)
+        {
+            const bool constrained = power_constrained.load(std::memory_order_relaxed);
+            if (constrained != saving_power)
+            {
+                saving_power = constrained;
+                apply_power_policy(saving_power, fps_limit, *jobs, *limiter);
+            }
+        }
+        // Before the swapchain wait, which then has nothing left to wait for unless vsync is
+        // slower still
+        if (limiter)
+        {
+            limiter->WaitForNextFrame();
+        }
+        // Blocks until the swapchain takes another frame, so the input sampled next is as fresh
+        // as it can be by the time the frame shows
+        if (auto waited = rsbl::GaWaitForSwapchain(swapchain); !waited)
+        {
+            RSBL_LOG_ERROR("Failed to wait for the swapchain: {}", waited.FailureText());
+            failed = true;
+            break;
+        }
+        if (window && window->ProcessMessages() == rsbl::WindowMessageResult::Quit)
+        {
+            break;
+        }
+        const uint64 input_ticks = rsbl::Clock::NowTicks();
+
+        const uint64 frame_start_ns = rsbl::Clock::NowNs();
+        if (auto begun = rsbl::GaBeginFrame(device); !begun)
+        {
+            RSBL_LOG_ERROR("Failed to begin the frame: {}", begun.FailureText());
+            failed = true;
+            break;
+        }
+        if (pacing)
+        {
+            pacing->pacing.Mark(device->frame, rsbl::FrameStage::Input, input_ticks);
+            mark_displayed(*pacing, swapchain);
+        }
+        // Files the precompiles that have finished, until none are left
+        if (pipelines_warming)
+        {
+            auto left = rsbl::GaPrecompilePipelines(pipeline_cache, 0);
+            if (!left || left.Value() == 0)
+            {
+                pipelines_warming = false;
+                RSBL_LOG_INFO("Pipelines from the last run compiled after {} frames", frames);
+            }
+        }
+        if (gpu_profiler != nullptr)
+        {
+            if (auto begun = rsbl::GaBeginGpuProfilerFrame(gpu_profiler); !begun)
+            {
+                RSBL_LOG_ERROR("Failed to read the GPU zones back: {}", begun.FailureText());
+                failed = true;
+                break;
+            }
+            collect_gpu_zones(*jobs,
+                              *gpu_profiler,
+                              first_timed_frame,
+                              benchmark_frames,
+                              gpu_frame_ns,
+                              pacing.Get());
+        }
+
+        const SceneLoadStage stage =
+            replaying ? replay_stage(load, static_cast<SceneLoadStage>(replay.frames[frames].stage))
+                      : load.stage.load(std::memory_order_acquire);
+        if (stage == SceneLoadStage::Failed)
+        {
+            failed = true;
+            break;
+        }
+        if (stage != seen_stage && seen_stage == SceneLoadStage::Loading)
+        {
+            RSBL_LOG_INFO("Interactive after {:.2f} ms, {} frames in",
+                          (load.interactiveNs - load.startNs) / 1'000'000.0,
+                          frames);
+            if (replaying && replay.asset != load.key)
+            {
+                RSBL_LOG_ERROR("The replay was recorded with a different {}", file_path);
+                failed = true;
+                break;
+            }
+            print_cooked_stats(*load.cooked);
+            RSBL_GAUGE_SET("scene.triangles", load.cooked->Indices().Size() / 3);
+            if (!build_scene_graph(*load.cooked, scene_graph))
+            {
+                failed = true;
+                break;
+            }
+            seen_stage = SceneLoadStage::Interactive;
+        }
+        if (stage == SceneLoadStage::Loaded && seen_stage == SceneLoadStage::Interactive)
+        {
+            RSBL_LOG_INFO("Fully loaded after {:.2f} ms, {} frames in",
+                          (load.loadedNs - load.startNs) / 1'000'000.0,
+                          frames);
+            seen_stage = SceneLoadStage::Loaded;
+            finish_load_trace(*jobs, trace_path);
+
+            const uint32 roots = scene_graph.LevelCount() > 0 ? scene_graph.LevelOffsets()[1] : 0;
+            for (uint32 root = 0; root < roots; ++root)
+            {
+                root_locals.PushBack(scene_graph.Local(root));
+            }
+        }
+
+        const bool timed = benchmark && seen_stage == SceneLoadStage::Loaded;
+        if (spin_frames > 0 && seen_stage == SceneLoadStage::Loaded)
+        {
+            spin_roots(scene_graph, root_locals, spin_frame++, spin_frames);
+        }
+
+        if (pacing)
+        {
+            pacing->pacing.Mark(
+                device->frame, rsbl::FrameStage::Simulation, rsbl::Clock::NowTicks());
+        }
+        // Only nodes that moved, and what hangs off them, are recomputed
+        scene_graph.UpdateWorldTransforms(*jobs);
+
+        if (capturing && !capture.everyFrame && capture.captured == 0 &&
+            seen_stage == SceneLoadStage::Loaded)
+        {
+            capture.armed = true;
+        }
+        if (!submit_frame(device, swapchain, pacing.Get(), capturing ? &capture : nullptr))
+        {
+            failed = true;
+            break;
+        }
+        if (capturing)
+        {
+            if (auto written = write_captures(capture, false); !written)
+            {
+                RSBL_LOG_ERROR("Failed to write a capture: {}", written.FailureText());
+                failed = true;
+                break;
+            }
+            if (!capture.everyFrame && capture.written > 0)
+            {
+                RSBL_LOG_INFO("Wrote the screenshot to {}", screenshot_path);
+                break;
+            }
+        }
+
+        // However many size messages came in, the swapchain is recreated once, by the next wait
+        const bool window_resized = window && window->CheckResize();
+        const rsbl::uint2 size =
+            replaying ? rsbl::uint2{replay.frames[frames].width, replay.frames[frames].height}
+            : window_resized ? scaled_size(window->Size(), render_scale)
+                             : swapchain_size;
+        if (size.x != swapchain_size.x || size.y != swapchain_size.y)
+        {
+            if (auto resized = rsbl::GaResizeSwapchain(swapchain, size.x, size.y); !resized)
+            {
+                RSBL_LOG_ERROR("Failed to resize the swapchain: {}", resized.FailureText());
+                failed = true;
+                break;
+            }
+            swapchain_size = size;
+        }
+
+        const uint64 elapsed_ns = rsbl::Clock::NowNs() - frame_start_ns;
+        if (replaying)
+        {
+            replayed_ns.PushBack(elapsed_ns);
+        }
+        if (!record_path.empty())
+        {
+            ReplayFrame recorded;
+            recorded.frameNs = elapsed_ns;
+            recorded.width = swapchain_size.x;
+            recorded.height = swapchain_size.y;
+            recorded.stage = static_cast<uint32>(seen_stage);
+            recording.frames.PushBack(recorded);
+        }
+
+        rsbl::MemoryTrackingEndFrame();
+        end_counters_frame(window.Get(), frames);
+        ++frames;
+        if (pacing && frames % 600 == 0)
+        {
+            log_frame_pacing(*pacing);
+        }
+
+        if (timed)
+        {
+            if (benchmark_frame == warmup_frames)
+            {
+                first_timed_frame = device->frame;
+            }
+            if (benchmark_frame >= warmup_frames &&
+                benchmark_frame < warmup_frames + benchmark_frames)
+            {
+                frame_ns.PushBack(rsbl::Clock::NowNs() - frame_start_ns);
+            }
+            if (++benchmark_frame == warmup_frames + benchmark_frames + readback_frames)
+            {
+                break;
+            }
+        }
     }
 
-    while (window->ProcessMessages() != rsbl::WindowMessageResult::Quit)
+    // A cook can't be stopped partway, closing the window early waits it out
+    jobs->Wait(load_done);
+    finish_load_trace(*jobs, trace_path);
+
+    rsbl::LogMemoryStats();
+    if (pacing)
     {
-        // do stuff?
+        log_frame_pacing(*pacing);
+    }
 
-        // TODO: check resize
-        if (window->CheckResize())
+    if (replaying)
+    {
+        log_replay_comparison(replay, replayed_ns);
+    }
+    if (!record_path.empty())
+    {
+        recording.asset = load.key;
+        if (auto written = write_replay(record_path.c_str(), recording); written)
+        {
+            RSBL_LOG_INFO("Recorded {} frames to {}", recording.frames.Size(), record_path);
+        }
+        else
         {
-            RSBL_LOG_INFO("Resized window caught by app!");
+            RSBL_LOG_ERROR("Failed to write the recording: {}", written.FailureText());
+            failed = true;
         }
     }
 
+    if (benchmark && !failed && seen_stage == SceneLoadStage::Loaded)
+    {
+        BenchmarkReport report;
+        report.file = file_path.c_str();
+        report.backend = backend_str.c_str();
+        report.warmupFrames = warmup_frames;
+        report.complete = frame_ns.Size() == benchmark_frames;
+        report.cpu = frame_time_stats(frame_ns);
+        report.gpu = frame_time_stats(gpu_frame_ns);
+        report.cpuFrameNs = frame_ns;
+        report.gpuFrameNs = gpu_frame_ns;
+        report.interactiveMs = (load.interactiveNs - load.startNs) / 1'000'000.0;
+        report.loadedMs = (load.loadedNs - load.startNs) / 1'000'000.0;
+        log_benchmark_report(report);
+        if (!report_path.empty())
+        {
+            if (auto written = write_benchmark_report(report_path.c_str(), report); !written)
+            {
+                RSBL_LOG_ERROR("Failed to write the benchmark report: {}", written.FailureText());
+                failed = true;
+            }
+        }
+    }
+
+    if (capture.ring != nullptr)
+    {
+        if (auto written = write_captures(capture, true); !written)
+        {
+            RSBL_LOG_ERROR("Failed to write a capture: {}", written.FailureText());
+            failed = true;
+        }
+        if (capture.everyFrame)
+        {
+            RSBL_LOG_INFO("Captured {} frames to {}, skipped {} the writes couldn't keep up with",
+                          capture.written,
+                          capture_dir,
+                          capture.skipped);
+        }
+        destroy_frame_capture(capture);
+    }
+
+    // Precompiles the run didn't get to are still recorded, and saved with the rest
+    jobs->Wait(pipeline_compiles);
+    if (auto saved = write_pipeline_cache(pipeline_cache_path.c_str(), pipeline_cache); !saved)
+    {
+        RSBL_LOG_WARNING("Failed to save the pipelines for the next run: {}",
+                         saved.FailureText());
+    }
+    rsbl::GaDestroyPipelineCache(pipeline_cache);
+    rsbl::GaDestroyGpuProfiler(gpu_profiler);
     rsbl::GaDestroySwapchain(swapchain);
     rsbl::GaDestroyDevice(device);
 
     RSBL_LOG_INFO("Window closed, shutting down!");
 
-    return 0;
+    return failed ? 1 : 0;
 }
\ No newline at end of file
@@ -76,3 +76,47 @@ function(rsbl_add_tests)
         )
     endforeach()
 endfunction()
+
+# Function to create a micro-benchmark, built with RSBL_BUILD_BENCHMARKS, see rsbl-bench.h.
+# CTest runs it with --smoke, one iteration of each benchmark under the "bench" label, to keep
+# it building and running; for numbers, run it by hand.
+# Usage:
+#   rsbl_add_benchmark(
+#       NAME bench-name
+#       SOURCES source1.cpp source2.cpp ...
+#       LIBRARIES lib1 lib2 ...
+#   )
+function(rsbl_add_benchmark)
+    set(options "")
+    set(oneValueArgs NAME)
+    set(multiValueArgs SOURCES LIBRARIES)
+
+    cmake_parse_arguments(BENCH "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+    # Validate required arguments
+    if(NOT BENCH_NAME)
+        message(FATAL_ERROR "rsbl_add_benchmark: NAME argument is required")
+    endif()
+
+    if(NOT BENCH_SOURCES)
+        message(FATAL_ERROR "rsbl_add_benchmark: SOURCES argument is required")
+    endif()
+
+    if(NOT RSBL_BUILD_BENCHMARKS)
+        return()
+    endif()
+
+    # Create the benchmark executable
+    add_executable(${BENCH_NAME} ${BENCH_SOURCES})
+
+    # Link libraries (always include rsbl-bench)
+    target_link_libraries(${BENCH_NAME}
+        PRIVATE
+        rsbl-bench
+        ${BENCH_LIBRARIES}
+    )
+
+    # Register the smoke run with CTest
+    add_test(NAME ${BENCH_NAME} COMMAND ${BENCH_NAME} --smoke)
+    set_tests_properties(${BENCH_NAME} PROPERTIES LABELS bench)
+endfunction()
@@ -0,0 +1,313 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-assert.h>
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-jobs.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+#include <rsbl-string-id.h>
+#include <rsbl-string.h>
+
+#include <atomic>
+
+// Loads assets by VFS path (rsbl-vfs.h) on the job system and shares them. Load hands back a
+// handle right away, the read and the loader run on a low priority job, and the handle's Get
+// starts returning the asset once it's done, so nothing on the frame ever waits on a disk.
+// Loading the same path as the same type again, while the first is still loading or after,
+// hands out the same asset.
+//
+// Handles count references. When the last one goes the asset isn't freed but cached, so going
+// back to something that was just closed is free, and cached assets are only freed, least
+// recently released first, once the CPU or GPU memory the loaders reported goes over budget.
+// What's referenced stays whatever the budget, the budget bounds what's kept around for later.
+//
+//     manager->RegisterLoader<Image>([](ByteView bytes, AssetSize& size) {
+//         UniquePtr<Image> image(new Image());
+//         ... DecodeImage(bytes, *image) ...
+//         size.cpuBytes = image->data.Size();
+//         return Result<UniquePtr<Image>>(rsblMove(image));
+//     });
+//     AssetHandle<Image> rock = manager->Load<Image>("textures/rock.png");
+//     ...
+//     if (const Image* image = rock.Get()) { ... }
+//
+// Register loaders up front: loads, handles and the rest can come from any thread, registering
+// can't happen alongside them. Loaders run on several jobs at once, so have to be thread safe.
+
+namespace rsbl
+{
+
+class AssetManager;
+class Vfs;
+
+enum class AssetState : uint8
+{
+    Loading,
+    Ready,
+    // The read or the loader failed, Error says how
+    Failed,
+};
+
+// What a loaded asset holds on to, in bytes, as its loader reports it. gpuBytes is what it
+// uploads, or will.
+struct AssetSize
+{
+    uint64 cpuBytes = 0;
+    uint64 gpuBytes = 0;
+};
+
+// Makes a T of an asset's file. Fills size in alongside.
+template <typename T>
+using AssetLoader =
+    Function<Result<UniquePtr<T>>(ByteView, AssetSize&), 32, FunctionStorage::InlineOrPool>;
+
+namespace Internal
+{
+    struct AssetEntry
+    {
+        AssetManager* manager = nullptr;
+        StringId path;
+        const void* type = nullptr;
+
+        std::atomic<uint32> references{0};
+        std::atomic<AssetState> state{AssetState::Loading};
+        // Set before state goes to Ready or Failed, and never changed after
+        void* object = nullptr;
+        ErrorCategory error = ErrorCategory::None;
+        AssetSize size;
+
+        // Least recently released first, while cached with no references. Under the manager's
+        // lock.
+        AssetEntry* previous = nullptr;
+        AssetEntry* next = nullptr;
+        bool cached = false;
+    };
+
+    // One per type, its address is all that matters
+    template <typename T>
+    const void* AssetTypeKey()
+    {
+        static const char key = 0;
+        return &key;
+    }
+
+    void ReleaseAsset(AssetEntry* entry);
+} // namespace Internal
+
+// A reference to an asset, which keeps it loaded. The default handle refers to nothing.
+template <typename T>
+class AssetHandle
+{
+  public:
+    AssetHandle() = default;
+
+    ~AssetHandle()
+    {
+        Reset();
+    }
+
+    AssetHandle(const AssetHandle& other)
+        : m_entry(other.m_entry)
+    {
+        if (m_entry != nullptr)
+        {
+            m_entry->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    AssetHandle& operator=(const AssetHandle& other)
+    {
+        if (this != &other)
+        {
+            AssetHandle copy(other);
+            Reset();
+            m_entry = copy.m_entry;
+            copy.m_entry = nullptr;
+        }
+        return *this;
+    }
+
+    AssetHandle(AssetHandle&& other)
+        : m_entry(other.m_entry)
+    {
+        other.m_entry = nullptr;
+    }
+
+    AssetHandle& operator=(AssetHandle&& other)
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_entry = other.m_entry;
+            other.m_entry = nullptr;
+        }
+        return *this;
+    }
+
+    bool IsNull() const
+    {
+        return m_entry == nullptr;
+    }
+
+    AssetState State() const
+    {
+        rsblAssert(m_entry != nullptr);
+        return m_entry->state.load(std::memory_order_acquire);
+    }
+
+    // nullptr until it's Ready
+    const T* Get() const
+    {
+        if (m_entry == nullptr ||
+            m_entry->state.load(std::memory_order_acquire) != AssetState::Ready)
+        {
+            return nullptr;
+        }
+        return static_cast<const T*>(m_entry->object);
+    }
+
+    // None unless it Failed
+    ErrorCategory Error() const
+    {
+        return State() == AssetState::Failed ? m_entry->error : ErrorCategory::None;
+    }
+
+    StringId Path() const
+    {
+        return m_entry != nullptr ? m_entry->path : StringId();
+    }
+
+    void Reset()
+    {
+        if (m_entry != nullptr)
+        {
+            Internal::ReleaseAsset(m_entry);
+            m_entry = nullptr;
+        }
+    }
+
+    bool operator==(const AssetHandle& other) const
+    {
+        return m_entry == other.m_entry;
+    }
+
+  private:
+    friend class AssetManager;
+
+    // Takes over a reference the manager already counted
+    explicit AssetHandle(Internal::AssetEntry* entry)
+        : m_entry(entry)
+    {
+    }
+
+    Internal::AssetEntry* m_entry = nullptr;
+};
+
+struct AssetManagerOptions
+{
+    // What loaded assets may take in all before cached ones are freed. Referenced ones never
+    // are, so they alone can still go over.
+    uint64 cpuBudget = 512ull << 20;
+    uint64 gpuBudget = 1024ull << 20;
+
+    JobPriority priority = JobPriority::Low;
+};
+
+struct AssetManagerStats
+{
+    // Every asset loaded and not freed, referenced or cached
+    uint64 cpuBytes = 0;
+    uint64 gpuBytes = 0;
+    uint64 assets = 0;
+    // The ones with no references left
+    uint64 cachedAssets = 0;
+
+    // Loads that started a read, and ones that found the asset already there or on its way
+    uint64 loads = 0;
+    uint64 hits = 0;
+    uint64 evictions = 0;
+};
+
+class AssetManager
+{
+  public:
+    // vfs and jobs have to outlive the manager
+    static Result<UniquePtr<AssetManager>> Create(const Vfs& vfs,
+                                                  JobSystem& jobs,
+                                                  const AssetManagerOptions& options = {});
+
+    // Waits for the loads still going. Every handle has to be gone by then.
+    ~AssetManager();
+
+    // Handles point back at the manager, it can't move
+    AssetManager(AssetManager&&) = delete;
+    AssetManager& operator=(AssetManager&&) = delete;
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    // Replaces any loader T had
+    template <typename T>
+    void RegisterLoader(AssetLoader<T>&& loader)
+    {
+        RegisterLoader(
+            Internal::AssetTypeKey<T>(),
+            [loader = rsblMove(loader)](ByteView bytes, AssetSize& size) -> Result<void*> {
+                Result<UniquePtr<T>> loaded = loader(bytes, size);
+                if (!loaded)
+                {
+                    return PendingFailure{loaded.Category()};
+                }
+                return static_cast<void*>(loaded.Value().Release());
+            },
+            [](void* object) { delete static_cast<T*>(object); });
+    }
+
+    // T needs a loader registered
+    template <typename T>
+    AssetHandle<T> Load(StringView path)
+    {
+        return AssetHandle<T>(Load(path, Internal::AssetTypeKey<T>()));
+    }
+
+    template <typename T>
+    AssetHandle<T> Load(StringId path)
+    {
+        return AssetHandle<T>(Load(path, Internal::AssetTypeKey<T>()));
+    }
+
+    // Waits for every load started so far, running jobs meanwhile. For tools and tests, frames
+    // should poll their handles instead.
+    void WaitForLoads();
+
+    // Frees cached assets until they fit, right away if they already do
+    void SetBudgets(uint64 cpu_budget, uint64 gpu_budget);
+
+    // Frees every cached asset, between levels say
+    void EvictUnused();
+
+    AssetManagerStats Stats() const;
+
+  private:
+    struct State;
+    using ErasedLoader =
+        Function<Result<void*>(ByteView, AssetSize&), 48, FunctionStorage::InlineOrPool>;
+
+    friend void Internal::ReleaseAsset(Internal::AssetEntry* entry);
+
+    AssetManager() = default;
+
+    void RegisterLoader(const void* type, ErasedLoader&& loader, void (*destroy)(void*));
+    Internal::AssetEntry* Load(StringView path, const void* type);
+    Internal::AssetEntry* Load(StringId path, const void* type);
+    void RunLoad(Internal::AssetEntry* entry);
+    void Release(Internal::AssetEntry* entry);
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
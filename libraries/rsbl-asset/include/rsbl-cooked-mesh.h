@@ -0,0 +1,324 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-bounds.h>
+#include <rsbl-file.h>
+#include <rsbl-int-types.h>
+#include <rsbl-math-types.h>
+#include <rsbl-mesh-optimize.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+
+#include <cmath>
+
+// .rmesh cooked meshes: a scene's geometry already in the layout the GPU draws from, so loading
+// one is mapping the file and pointing uploads at it. Parsing glTF and decoding its accessors
+// happens once, in MeshCooker, instead of on every launch.
+//
+// The file is a header, then one section per array below, each 16 byte aligned and stored
+// exactly as the structs are laid out. Vertices are interleaved and quantized to 20 bytes, with
+// duplicates merged, and triangles and vertices are reordered for the vertex cache, overdraw and
+// fetch locality (rsbl-mesh-optimize.h). Every primitive is also cut into meshlets for mesh
+// shaders and cluster culling, each with a bounding sphere and normal cone, next to a plain index
+// buffer for everything else, and simplified into a chain of coarser index buffers over the same
+// vertices for levels of detail (SelectLod). Nodes come parents first, so world transforms are one
+// pass down the array. Little endian, like everything we run on.
+//
+//     Result<UniquePtr<CookedMesh>> mesh = CookedMesh::Open("sponza.rmesh");
+//     ByteView vertices = mesh.Value()->Section(CookedMeshSection::Vertices);
+//     ... copy vertices straight from the mapping into the upload buffer ...
+
+namespace rsbl
+{
+
+// Goes up whenever the file or what MeshCooker puts in it changes, so caches keyed on it
+// (rsbl-derived-data-cache.h) cook again rather than hand back stale meshes
+constexpr uint32 kCookedMeshVersion = 4;
+
+enum class CookedMeshSection : uint32
+{
+    Vertices,         // CookedVertex
+    Indices,          // uint32, relative to the submesh's first vertex
+    Meshlets,         // CookedMeshlet
+    MeshletVertices,  // uint32, relative to the submesh's first vertex
+    MeshletTriangles, // uint8 x 3 per triangle, into the meshlet's vertices
+    Submeshes,        // CookedSubmesh
+    Meshes,           // CookedMeshRange
+    Nodes,            // CookedNode
+    Lods,             // CookedLod
+
+    Count,
+};
+
+// Position as unorm16s over the submesh's bounds (w is 0), the tangent frame as a QTangent
+// (rsbl-packing.h) in snorm16s, and the UV as halves. Matches R16G16B16A16_UNORM,
+// R16G16B16A16_SNORM and R16G16_FLOAT attributes.
+struct CookedVertex
+{
+    uint16 position[4];
+    uint16 qtangent[4];
+    uint16 uv[2];
+};
+
+static_assert(sizeof(CookedVertex) == 20, "CookedVertex is stored as is, it can't change size");
+
+struct CookedMeshlet
+{
+    // Into MeshletVertices, and MeshletTriangles counting in triangles
+    uint32 vertexOffset;
+    uint32 triangleOffset;
+    uint32 vertexCount;
+    uint32 triangleCount;
+    Sphere bounds;
+    // Normal cone, for culling meshlets that face away as a whole: IsMeshletBackfacing. The
+    // cutoff is 1 for meshlets whose triangles face too many ways to ever be culled.
+    float3 coneAxis;
+    float coneCutoff;
+};
+
+static_assert(sizeof(CookedMeshlet) == 48, "CookedMeshlet is stored as is, it can't change size");
+
+// True when no triangle of the meshlet can face the camera. Uses the bounding sphere rather than
+// an apex, which is as conservative as the sphere is tight, and is the same test a cluster culling
+// shader would run.
+inline bool IsMeshletBackfacing(const CookedMeshlet& meshlet, const float3& camera_position)
+{
+    const float3 to_center(meshlet.bounds.center.x - camera_position.x,
+                           meshlet.bounds.center.y - camera_position.y,
+                           meshlet.bounds.center.z - camera_position.z);
+    const float distance = std::sqrt(to_center.x * to_center.x + to_center.y * to_center.y +
+                                     to_center.z * to_center.z);
+    const float along_axis = to_center.x * meshlet.coneAxis.x + to_center.y * meshlet.coneAxis.y +
+                             to_center.z * meshlet.coneAxis.z;
+    return along_axis >= meshlet.coneCutoff * distance + meshlet.bounds.radius;
+}
+
+// One level of detail of a submesh, a triangle list over the same vertices as the full one
+struct CookedLod
+{
+    // Into Indices
+    uint32 indexOffset;
+    uint32 indexCount;
+    // How far the surface strays from the full detail one, in the submesh's units before any
+    // node's scale
+    float error;
+};
+
+static_assert(sizeof(CookedLod) == 12, "CookedLod is stored as is, it can't change size");
+
+constexpr uint32 kNoMaterial = ~0u;
+
+// One glTF primitive: a draw, or a dispatch of its meshlets
+struct CookedSubmesh
+{
+    uint32 vertexOffset;
+    uint32 vertexCount;
+    uint32 indexOffset;
+    uint32 indexCount;
+    uint32 meshletOffset;
+    uint32 meshletCount;
+    // Index into the source's materials, kNoMaterial for none
+    uint32 material;
+    // Into Lods, finest first with error rising. The first is always the full detail indices
+    // above with an error of 0; meshlets are only cut from that one.
+    uint32 lodOffset;
+    uint32 lodCount;
+    // Vertex positions dequantize to bounds.min + position * (bounds.max - bounds.min)
+    Aabb bounds;
+};
+
+static_assert(sizeof(CookedSubmesh) == 60, "CookedSubmesh is stored as is, it can't change size");
+
+// A mesh is the submeshes [submeshOffset, submeshOffset + submeshCount)
+struct CookedMeshRange
+{
+    uint32 submeshOffset;
+    uint32 submeshCount;
+};
+
+struct CookedNode
+{
+    float3 translation;
+    float4 rotation; // Quaternion, xyzw
+    float3 scale;
+    // Always below the node's own index, -1 for a root
+    int32 parent;
+    // -1 for a node without one
+    int32 mesh;
+};
+
+static_assert(sizeof(CookedNode) == 48, "CookedNode is stored as is, it can't change size");
+
+// What a cooked file was made from, to tell when it's out of date
+struct CookedMeshSource
+{
+    int64 modifiedTime = 0;
+    uint64 size = 0;
+};
+
+struct MeshPrimitiveInput
+{
+    ArrayView<const float3> positions;
+    // Each optional, or as many as positions. Missing normals are smoothed from the triangles,
+    // missing tangents made up around the normals.
+    ArrayView<const float3> normals;
+    ArrayView<const float4> tangents; // w is the bitangent's sign, as in glTF
+    ArrayView<const float2> uvs;
+    // Triangle list. Empty for one that isn't indexed, every three positions a triangle.
+    ArrayView<const uint32> indices;
+    uint32 material = kNoMaterial;
+};
+
+struct MeshNodeInput
+{
+    float3 translation = float3(0.0f);
+    float4 rotation = float4(0.0f, 0.0f, 0.0f, 1.0f);
+    float3 scale = float3(1.0f);
+    int32 parent = -1;
+    int32 mesh = -1;
+};
+
+struct MeshCookerOptions
+{
+    // The usual mesh shader limits. Meshlet triangles index their vertices with a byte, so at
+    // most 255 vertices.
+    uint32 maxMeshletVertices = 64;
+    uint32 maxMeshletTriangles = 124;
+    // How far OptimizeOverdraw may push the vertex cache's ACMR up for less overdraw, as a
+    // multiple. 1 keeps the cache order as it is.
+    float overdrawThreshold = 1.05f;
+    // Levels of detail per submesh, counting the full one, so 1 turns them off. Each aims for
+    // lodTriangleRatio of the triangles of the one before, and the chain stops early once
+    // SimplifyMesh can't get there within maxLodError, a fraction of the submesh's bounds
+    // diagonal, or stops making progress.
+    uint32 maxLodCount = 6;
+    float lodTriangleRatio = 0.5f;
+    float maxLodError = 0.05f;
+};
+
+// What the reordering did, over every primitive added so far
+struct MeshCookerStats
+{
+    VertexCacheStats before;
+    VertexCacheStats after;
+    // Vertices merged into another with the same quantized bytes
+    uint64 duplicateVertices = 0;
+    // Vertices no triangle used, left out
+    uint64 unusedVertices = 0;
+    // Levels of detail past the full one, and the triangles in them
+    uint64 lodLevels = 0;
+    uint64 lodTriangles = 0;
+};
+
+// Collects meshes and nodes in memory, and writes them out as a .rmesh
+class MeshCooker
+{
+  public:
+    static Result<UniquePtr<MeshCooker>> Create(const MeshCookerOptions& options = {});
+
+    ~MeshCooker();
+
+    MeshCooker(MeshCooker&&) = delete;
+    MeshCooker& operator=(MeshCooker&&) = delete;
+    MeshCooker(const MeshCooker&) = delete;
+    MeshCooker& operator=(const MeshCooker&) = delete;
+
+    // Starts the next mesh, the primitives added from now on are its. Returns its index.
+    uint32 BeginMesh();
+
+    // Quantizes the primitive, simplifies it into levels of detail and cuts it into meshlets.
+    // InvalidArgument for attributes that
+    // don't match the positions, indices out of range, or a partial triangle.
+    Result<> AddPrimitive(const MeshPrimitiveInput& primitive);
+
+    // Returns the node's index. Parents have to be added before their children.
+    Result<uint32> AddNode(const MeshNodeInput& node);
+
+    Result<> Write(const char* path, const CookedMeshSource& source = {}) const;
+
+    const MeshCookerStats& Stats() const;
+
+  private:
+    struct State;
+
+    MeshCooker() = default;
+
+    State* m_state = nullptr;
+};
+
+// What SelectLod needs of the view
+struct LodSelection
+{
+    float3 cameraPosition;
+    // Pixels per unit of size at a distance of 1: the viewport's height over 2 tan(fov_y / 2)
+    float projectionScale = 1.0f;
+    // How far the surface may be off on screen, in pixels
+    float maxPixelError = 1.0f;
+};
+
+// The coarsest of a submesh's lods whose error projects to at most maxPixelError pixels,
+// measured at the point of bounds nearest the camera. bounds is the submesh's in world space and
+// scale the largest of its node's world scale axes, which the lods' errors are multiplied by.
+// Returns an index into lods, 0 for a camera inside the bounds.
+uint32 SelectLod(ArrayView<const CookedLod> lods,
+                 const Sphere& bounds,
+                 float scale,
+                 const LodSelection& selection);
+
+// SelectLod for a batch of instances of the same submesh, writing each one's level to levels
+void SelectLods(ArrayView<uint8> levels,
+                ArrayView<const CookedLod> lods,
+                ArrayView<const Sphere> bounds,
+                ArrayView<const float> scales,
+                const LodSelection& selection);
+
+// A mapped .rmesh. Open checks the header and that the tables point inside the file, the
+// meshlet and index data is trusted as the cooker wrote it.
+class CookedMesh
+{
+  public:
+    static Result<UniquePtr<CookedMesh>> Open(const char* path);
+
+    ~CookedMesh();
+
+    CookedMesh(CookedMesh&&) = delete;
+    CookedMesh& operator=(CookedMesh&&) = delete;
+    CookedMesh(const CookedMesh&) = delete;
+    CookedMesh& operator=(const CookedMesh&) = delete;
+
+    // A section's bytes in the mapping, what GPU uploads copy from
+    ByteView Section(CookedMeshSection section) const;
+
+    ArrayView<const CookedVertex> Vertices() const;
+    ArrayView<const uint32> Indices() const;
+    ArrayView<const CookedMeshlet> Meshlets() const;
+    ArrayView<const uint32> MeshletVertices() const;
+    ArrayView<const uint8> MeshletTriangles() const;
+    ArrayView<const CookedSubmesh> Submeshes() const;
+    ArrayView<const CookedMeshRange> Meshes() const;
+    ArrayView<const CookedNode> Nodes() const;
+    ArrayView<const CookedLod> Lods() const;
+
+    // True when it was cooked from a file with this size and modified time
+    bool MatchesSource(const FileInfo& source) const;
+
+    // Starts reading the whole file in, ahead of the uploads touching it
+    void Prefetch() const;
+
+    // Starts reading in just what drawing every submesh at its coarsest lod needs: the vertices,
+    // those lods' indices, and the tables, which it reads to find them. Enough to show something
+    // while Prefetch brings in the rest.
+    void PrefetchCoarsestLods() const;
+
+  private:
+    struct State;
+
+    CookedMesh() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
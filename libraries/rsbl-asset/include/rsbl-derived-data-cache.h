@@ -0,0 +1,145 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+#include <rsbl-string.h>
+
+#include <type_traits>
+
+// A content addressed cache of cooked artifacts (meshes, textures, shaders). An artifact is keyed
+// on everything that went into it: which cooker and its version, the cook settings and the source
+// bytes, never on paths or timestamps. The same inputs give the same key on every machine, so an
+// artifact cooked once, by CI or a colleague, is fetched rather than cooked again, and renaming
+// or touching a source costs nothing.
+//
+// Artifacts live in a local directory, and optionally a shared one too (a network share) that
+// local misses fall back to and new artifacts are copied up to. Files only ever appear whole:
+// they're written beside their final name and renamed into place, so several processes can fill
+// the same cache at once and a reader never sees half of one. Artifacts are stored as they are,
+// so loaders map them straight out of the local cache.
+//
+//     DerivedDataKeyBuilder builder("mesh", kCookedMeshVersion);
+//     builder.AddValue(options).Add(source_bytes);
+//     const DerivedDataKey key = builder.Finish();
+//
+//     Result<String> path = cache->Find(key);
+//     if (!path)
+//     {
+//         String temp = cache->TempPath();
+//         ... cook into temp ...
+//         cache->PutFile(key, temp.CStr());
+//         path = cache->Find(key);
+//     }
+
+namespace rsbl
+{
+
+// 128 bits, so two different artifacts sharing a key isn't something to plan for
+struct DerivedDataKey
+{
+    uint64 high = 0;
+    uint64 low = 0;
+
+    bool operator==(const DerivedDataKey&) const = default;
+};
+
+// Characters in a key as hex, without a terminator
+constexpr uint32 kDerivedDataKeyHexSize = 32;
+
+void DerivedDataKeyToHex(const DerivedDataKey& key, char (&hex)[kDerivedDataKeyHexSize + 1]);
+
+// Hashes a cook's inputs into a key, in the order they're added
+class DerivedDataKeyBuilder
+{
+  public:
+    // The cooker's name keeps different kinds of artifact apart. Bump its version whenever what it
+    // writes changes, which leaves every artifact it cooked before behind.
+    DerivedDataKeyBuilder(StringView cooker, uint32 version);
+
+    DerivedDataKeyBuilder& Add(ByteView bytes);
+    DerivedDataKeyBuilder& Add(StringView text);
+
+    // Settings structs, hashed as their bytes. Padding would hash whatever happened to be in it,
+    // so a struct with any needs its fields added one at a time instead.
+    template <typename T>
+    DerivedDataKeyBuilder& AddValue(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain values hash as bytes");
+        return Add(ByteView(reinterpret_cast<const uint8*>(&value), sizeof(T)));
+    }
+
+    DerivedDataKey Finish() const;
+
+  private:
+    DerivedDataKey m_key;
+};
+
+struct DerivedDataCacheOptions
+{
+    // This machine's artifacts, created if it isn't there
+    const char* localDirectory = "derived-data";
+
+    // Everyone's artifacts, a directory on a network share usually. nullptr for none.
+    const char* sharedDirectory = nullptr;
+
+    // Whether artifacts cooked here are copied up to the shared cache. Build machines that cook
+    // everything write, artist machines can be left to only read.
+    bool writeShared = true;
+};
+
+struct DerivedDataCacheStats
+{
+    uint64 localHits = 0;
+    uint64 sharedHits = 0;
+    uint64 misses = 0;
+    uint64 puts = 0;
+    // Copies to the shared cache that failed. The local cache still has the artifact.
+    uint64 sharedPutFailures = 0;
+};
+
+// Safe to use from any number of threads and processes at once
+class DerivedDataCache
+{
+  public:
+    static Result<UniquePtr<DerivedDataCache>> Create(const DerivedDataCacheOptions& options = {});
+
+    ~DerivedDataCache();
+
+    DerivedDataCache(DerivedDataCache&&) = delete;
+    DerivedDataCache& operator=(DerivedDataCache&&) = delete;
+    DerivedDataCache(const DerivedDataCache&) = delete;
+    DerivedDataCache& operator=(const DerivedDataCache&) = delete;
+
+    // Where the artifact is in the local cache, copying it down from the shared cache first when
+    // only that has it. NotFound when neither does: cook it and Put it.
+    Result<String> Find(const DerivedDataKey& key);
+
+    // Stores an artifact under its key, locally and in the shared cache
+    Result<> Put(const DerivedDataKey& key, ByteView data);
+
+    // Moves a file the cooker wrote, at a path from TempPath, into the cache under key. Saves
+    // holding big artifacts in memory just to hand them over.
+    Result<> PutFile(const DerivedDataKey& key, const char* path);
+
+    // A path in the local cache directory nothing else will use, for cooking into before PutFile
+    String TempPath();
+
+    // Where key's artifact goes in the local cache, whether or not it's there
+    String LocalPath(const DerivedDataKey& key) const;
+
+    DerivedDataCacheStats Stats() const;
+
+  private:
+    struct State;
+
+    DerivedDataCache() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
@@ -0,0 +1,178 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-bounds.h>
+#include <rsbl-cooked-mesh.h>
+#include <rsbl-int-types.h>
+#include <rsbl-pack.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+#include <rsbl-string.h>
+
+// Geometry streaming, the meshes' side of rsbl-texture-streamer.h. A cooked mesh goes into a
+// pack (rsbl-pack.h) as pages, each an entry of its own: every submesh's coarser levels of
+// detail are a page each, and its full detail one is pages of meshletsPerPage meshlets. A page
+// carries the vertices its triangles use, so it draws on its own, as a triangle list or as
+// meshlets. Opening a mesh reads its table and every submesh's coarsest lod, which stay resident;
+// finer lods come in on demand, one at a time per submesh and every page of one at once, on the
+// async IO queue (rsbl-async-io.h), and go again once no view picks them and the budget needs
+// the room.
+//
+// The demand is the LOD selection pass's: the finest level SelectLods picked for any instance of
+// a submesh. Until it arrives the submesh draws at the finest lod it has, which is never more
+// than one level coarser per Update than it needs to be once reads keep up.
+//
+//     Result<uint32> city = streamer->Open("meshes/city");
+//     ... every frame, for each submesh ...
+//     SelectLods(levels, streamer->Lods(city, submesh), bounds, scales, selection);
+//     streamer->RequestFromLods(city, submesh, levels);
+//     ... then ...
+//     streamer->Update();
+//     for (const StreamedLod& arrived : streamer->Arrived()) { ... upload its pages ... }
+//     ... draw each submesh at the coarser of what was picked and ResidentLod ...
+//
+// Lods are resident as a contiguous range down from the coarsest, so falling back a level always
+// has one to fall back to. A GeometryStreamer is driven by one thread, the one running the frame.
+
+namespace rsbl
+{
+
+class AsyncIo;
+
+constexpr uint32 kStreamedGeometryVersion = 1;
+
+struct StreamedGeometryOptions
+{
+    // Full detail meshlets per page. 64 of the cooker's meshlets is around 100 KB.
+    uint32 meshletsPerPage = 64;
+    PackCompression compression = PackCompression::Lz4;
+    CompressionLevel level = CompressionLevel::High;
+};
+
+// Writes mesh's pages and its table into pack, the table as name and the pages as name/0,
+// name/1 and so on
+Result<> WriteStreamedGeometry(PackWriter& pack,
+                               StringView name,
+                               const CookedMesh& mesh,
+                               const StreamedGeometryOptions& options = {});
+
+// A submesh as its table has it, stored as is
+struct StreamedSubmesh
+{
+    // Vertex positions dequantize to bounds.min + position * (bounds.max - bounds.min), as in
+    // CookedSubmesh
+    Aabb bounds;
+    uint32 material;
+    // Into the mesh's lods, finest first
+    uint32 lodOffset;
+    uint32 lodCount;
+};
+
+static_assert(sizeof(StreamedSubmesh) == 36,
+              "StreamedSubmesh is stored as is, it can't change size");
+
+// A resident page's arrays, all relative to the page. Meshlets are only in the full detail
+// lod's pages, and index the page's meshlet vertices and triangles as CookedMeshlet does.
+struct GeometryPage
+{
+    ArrayView<const CookedVertex> vertices;
+    ArrayView<const uint32> indices;
+    ArrayView<const CookedMeshlet> meshlets;
+    ArrayView<const uint32> meshletVertices;
+    ArrayView<const uint8> meshletTriangles;
+};
+
+struct StreamedLod
+{
+    uint32 mesh;
+    uint32 submesh;
+    uint32 lod;
+};
+
+struct GeometryStreamerOptions
+{
+    // Memory for the lods finer than the coarsest, resident and being read. The coarsest don't
+    // count, they're small and always there.
+    uint64 budget = 256ull << 20;
+    // Page reads in flight at once, across every mesh
+    uint32 maxReadsInFlight = 32;
+};
+
+struct GeometryStreamerStats
+{
+    uint64 coarsestBytes = 0;
+    uint64 residentBytes = 0;
+    uint64 pendingBytes = 0;
+    uint64 lodsRead = 0;
+    uint64 lodsEvicted = 0;
+    // Updates that left a wanted lod out because what's resident is all wanted too
+    uint64 overBudgetUpdates = 0;
+    uint64 failedReads = 0;
+};
+
+class GeometryStreamer
+{
+  public:
+    // io has to outlive the streamer, and can't be used for anything else meanwhile
+    static Result<UniquePtr<GeometryStreamer>> Create(AsyncIo& io,
+                                                      const char* packPath,
+                                                      const GeometryStreamerOptions& options = {});
+
+    // Waits for the reads in flight, they write into the streamer's memory
+    ~GeometryStreamer();
+
+    GeometryStreamer(GeometryStreamer&&) = delete;
+    GeometryStreamer& operator=(GeometryStreamer&&) = delete;
+    GeometryStreamer(const GeometryStreamer&) = delete;
+    GeometryStreamer& operator=(const GeometryStreamer&) = delete;
+
+    // Reads the table and every submesh's coarsest lod, blocking, and returns the mesh's index.
+    // NotFound when the pack doesn't have it.
+    Result<uint32> Open(StringView name);
+
+    uint32 MeshCount() const;
+
+    // As the cooked mesh had them
+    ArrayView<const StreamedSubmesh> Submeshes(uint32 mesh) const;
+    ArrayView<const CookedMeshRange> Meshes(uint32 mesh) const;
+    ArrayView<const CookedNode> Nodes(uint32 mesh) const;
+
+    // For SelectLods. Each lod's indexCount is over all its pages and its indexOffset is 0.
+    ArrayView<const CookedLod> Lods(uint32 mesh, uint32 submesh) const;
+
+    // Asks for submesh down to lod for the next Update. Several requests keep the finest.
+    void Request(uint32 mesh, uint32 submesh, uint32 lod);
+
+    // The finest of levels, as SelectLods wrote them for the submesh's instances
+    void RequestFromLods(uint32 mesh, uint32 submesh, ArrayView<const uint8> levels);
+
+    // Once a frame: takes in the reads that finished, makes room in the budget by dropping lods
+    // nothing asked for this frame, least recently asked for first, then starts reads for what
+    // was asked for, furthest from its request first
+    void Update();
+
+    // The lods whose last page came in during the last Update, to upload
+    ArrayView<const StreamedLod> Arrived() const;
+
+    // The finest lod in memory, every coarser one is too
+    uint32 ResidentLod(uint32 mesh, uint32 submesh) const;
+
+    uint32 PageCount(uint32 mesh, uint32 submesh, uint32 lod) const;
+
+    // A resident lod's page, empty for one that isn't
+    GeometryPage Page(uint32 mesh, uint32 submesh, uint32 lod, uint32 page) const;
+
+    GeometryStreamerStats Stats() const;
+
+  private:
+    struct State;
+
+    GeometryStreamer() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
@@ -0,0 +1,77 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-result.h>
+
+// Texture decoding and block compression. PNG and JPEG files decode to RGBA8, which then
+// compresses to one of the BCn formats the GPU samples from directly:
+//
+//     BC1  RGB, 4 bits per pixel. Opaque color, and anything else that doesn't need alpha.
+//     BC5  Two channels, 8 bits per pixel. Tangent space normal maps (z is rebuilt in the shader).
+//     BC7  RGBA, 8 bits per pixel. Color with alpha, or color that BC1 bands on.
+//
+// against 32 bits per pixel for RGBA8. Everything here is single threaded and works on one
+// image, so a loader with many textures runs one job per image.
+//
+//     Image decoded;
+//     Result<> decode = DecodeImage(file_bytes, decoded);
+//     Image compressed;
+//     Result<> compress = CompressImage(decoded, ImageFormat::Bc7, compressed);
+//     ... upload compressed.pixels as a BC7 texture ...
+//
+// Decoding covers what asset pipelines write: every PNG color type and bit depth, interlaced or
+// not, and baseline JPEG in grayscale or YCbCr at any chroma subsampling. Progressive and
+// arithmetic coded JPEGs fail with InvalidArgument.
+
+namespace rsbl
+{
+
+enum class ImageFormat : uint32
+{
+    Rgba8,
+    Bc1,
+    Bc5,
+    Bc7,
+};
+
+enum class ImageFileType : uint32
+{
+    Unknown,
+    Png,
+    Jpeg,
+};
+
+struct Image
+{
+    uint32 width = 0;
+    uint32 height = 0;
+    ImageFormat format = ImageFormat::Rgba8;
+    // Rows top to bottom, tightly packed. BCn formats are rows of 4x4 blocks, with the image
+    // padded out to whole blocks.
+    DynamicArray<uint8> pixels;
+};
+
+// Looks at the signature only
+ImageFileType DetectImageFileType(ByteView file);
+
+// Bytes a width x height image takes in format
+uint64 ImageByteSize(uint32 width, uint32 height, ImageFormat format);
+
+// Decodes a PNG or JPEG to RGBA8. Images without alpha get 255.
+Result<> DecodeImage(ByteView file, Image& out);
+
+// Compresses an RGBA8 image to a BCn format. BC1 drops alpha, BC5 keeps red and green.
+Result<> CompressImage(const Image& source, ImageFormat format, Image& out);
+
+// Fills mips with the RGBA8 image's mip chain below it, each half the size of the one before
+// (rounding down, at least 1) down to 1x1, by averaging 2x2 pixels. srgb averages color in
+// linear light, as sampling an sRGB texture does, otherwise the bytes are averaged as they are,
+// which is right for normals and masks. Alpha is always linear.
+Result<> GenerateMips(const Image& image, bool srgb, DynamicArray<Image>& mips);
+
+} // namespace rsbl
@@ -0,0 +1,135 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-int-types.h>
+#include <rsbl-math-types.h>
+
+// Reorders triangle lists and their vertices for how GPUs actually draw them, the passes
+// meshoptimizer runs, in the order to run them:
+//
+//   1. DeduplicateVertices merges vertices with identical bytes, which exporters leave behind
+//      after splitting attributes, so the cache can hit on them at all
+//   2. OptimizeVertexCache orders triangles so the post-transform cache reuses shaded vertices
+//      (Forsyth's linear-speed algorithm)
+//   3. OptimizeOverdraw cuts that order into clusters and sorts the clusters so outward facing
+//      ones draw first, giving up a little cache efficiency for less overdraw (Sander et al.)
+//   4. OptimizeVertexFetch renumbers vertices in the order the indices first use them, so
+//      fetches walk memory forwards, and drops vertices nothing uses
+//
+// None of them change what's drawn, only the order. AnalyzeVertexCache measures the result.
+// SimplifyMesh is the one pass that does change it, for levels of detail.
+//
+//     uint32 unique = DeduplicateVertices(remap, ByteView(vertices), sizeof(Vertex));
+//     RemapIndices(indices, remap);
+//     RemapVertices<Vertex>(vertices_out, vertices_in, remap);
+//     OptimizeVertexCache(indices, unique);
+//     OptimizeOverdraw(indices, positions);
+//     ... OptimizeVertexFetch then remap again ...
+
+namespace rsbl
+{
+
+// Entries of the FIFO cache AnalyzeVertexCache models, and the LRU one OptimizeVertexCache
+// optimizes for. Around what current GPUs reuse within a wave.
+constexpr uint32 kVertexCacheSize = 16;
+
+// What remap tables hold for a vertex no index uses
+constexpr uint32 kUnusedVertex = ~0u;
+
+struct VertexCacheStats
+{
+    uint64 triangles = 0;
+    // Vertices the indices use at least once
+    uint64 vertices = 0;
+    // Cache misses, each one a vertex shader invocation
+    uint64 transforms = 0;
+
+    // Average cache miss ratio, transforms per triangle. 3 is no reuse, about 0.5 the best a
+    // regular grid can do.
+    float Acmr() const
+    {
+        return triangles != 0 ? float(transforms) / float(triangles) : 0.0f;
+    }
+
+    // Average transform to vertex ratio, 1 is every vertex shaded exactly once
+    float Atvr() const
+    {
+        return vertices != 0 ? float(transforms) / float(vertices) : 0.0f;
+    }
+
+    VertexCacheStats& operator+=(const VertexCacheStats& other)
+    {
+        triangles += other.triangles;
+        vertices += other.vertices;
+        transforms += other.transforms;
+        return *this;
+    }
+};
+
+// Simulates a FIFO post-transform cache of cache_size entries over the triangle list
+VertexCacheStats AnalyzeVertexCache(ArrayView<const uint32> indices,
+                                    uint64 vertex_count,
+                                    uint32 cache_size = kVertexCacheSize);
+
+// Fills remap (one per vertex) with each vertex's index among the unique ones, numbered in order
+// of first appearance, and returns how many are unique. vertices is vertex_size bytes each.
+uint32 DeduplicateVertices(ArrayView<uint32> remap, ByteView vertices, uint64 vertex_size);
+
+// Reorders the triangles in place. Every index has to be below vertex_count.
+void OptimizeVertexCache(ArrayView<uint32> indices, uint64 vertex_count);
+
+// Reorders the triangles in place, keeping the ACMR within threshold times what it was. Best run
+// on the output of OptimizeVertexCache, whose order it cuts into clusters.
+void OptimizeOverdraw(ArrayView<uint32> indices,
+                      ArrayView<const float3> positions,
+                      float threshold = 1.05f);
+
+// Fills remap (one per vertex) with the order the indices first use each vertex, kUnusedVertex
+// for ones they never do, and returns how many are used
+uint32 OptimizeVertexFetch(ArrayView<uint32> remap, ArrayView<const uint32> indices);
+
+// Collapses edges, cheapest first by quadric error (Garland and Heckbert), until the triangles
+// are down to target_index_count indices or the next collapse would move the surface further
+// than target_error, in the positions' units. Writes the triangles to destination, which needs
+// room for all of indices, and returns how many indices that is. result_error, when given, gets
+// how far the result strays from the original.
+//
+// Vertices are only ever merged into a neighbour, never moved, so the result indexes the same
+// vertex buffer. Vertices on a border stay put, which includes seams where a UV or normal split
+// left two vertices in the same place, so the mesh can't crack open.
+uint64 SimplifyMesh(ArrayView<uint32> destination,
+                    ArrayView<const uint32> indices,
+                    ArrayView<const float3> positions,
+                    uint64 target_index_count,
+                    float target_error,
+                    float* result_error = nullptr);
+
+// Points every index at its vertex's entry in remap
+inline void RemapIndices(ArrayView<uint32> indices, ArrayView<const uint32> remap)
+{
+    for (uint32& index : indices)
+    {
+        index = remap[index];
+    }
+}
+
+// Moves each vertex to its entry in remap, skipping unused ones. destination needs room for the
+// count DeduplicateVertices or OptimizeVertexFetch returned, and can't be vertices.
+template <typename T>
+void RemapVertices(ArrayView<T> destination,
+                   ArrayView<const T> vertices,
+                   ArrayView<const uint32> remap)
+{
+    for (uint64 i = 0; i < vertices.Size(); ++i)
+    {
+        if (remap[i] != kUnusedVertex)
+        {
+            destination[remap[i]] = vertices[i];
+        }
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,161 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-compression.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+#include <rsbl-string.h>
+
+// .rpak pack files: many assets in one file, so loading thousands of them costs one open and a
+// positional read each instead of an open, a read and a close each.
+//
+// The layout is the assets' bytes one after the other, then the table of contents, then the
+// names, then a fixed size footer saying where those are. The table is an open addressed hash
+// table keyed on the name's hash (the same one StringId keeps), so finding an asset is a probe
+// or two into memory mapped straight from the file, with nothing parsed at open time. Written
+// front to back in one pass, so a pack can be built without holding it all in memory.
+// Little endian, like everything we run on.
+//
+// Compressed assets are cut into blocks of the pack's block size, each compressed on its own, so
+// a big asset can decompress on several threads at once (DecompressBlock) and start while the
+// rest is still being read. Their stored bytes start with a uint64 per block, where that block
+// ends in the blocks that follow. A block that didn't get smaller is stored as is.
+
+namespace rsbl
+{
+
+enum class PackCompression : uint8
+{
+    None,
+    // LZ4 blocks (rsbl-compression.h), at whichever CompressionLevel they were written with
+    Lz4,
+};
+
+// One slot of the table of contents, exactly as stored in the file
+struct PackEntry
+{
+    // Hash<StringView> of the name, StringId::GetHash for an interned one
+    uint64 nameHash = 0;
+    // Where the stored bytes start in the pack
+    uint64 offset = 0;
+    // Bytes in the pack, and bytes once decompressed. The same when not compressed.
+    uint64 storedSize = 0;
+    uint64 size = 0;
+    // Into the names block, kPackEmptySlot for a slot with nothing in it
+    uint32 nameOffset = 0;
+    uint32 nameSize = 0;
+    PackCompression compression = PackCompression::None;
+    uint8 reserved[7] = {};
+};
+
+static_assert(sizeof(PackEntry) == 48, "PackEntry is stored as is, it can't change size");
+
+constexpr uint32 kPackEmptySlot = ~0u;
+
+struct PackWriterOptions
+{
+    // What compressed assets are cut into, a power of two from 4 KB to 16 MB. 64 to 256 KB
+    // decompress quickly on one thread while still compressing well.
+    uint32 blockSize = 128 * 1024;
+};
+
+// Builds a pack. Assets are written as they're added, the table goes on the end in Finish.
+class PackWriter
+{
+  public:
+    static Result<UniquePtr<PackWriter>> Create(const char* path,
+                                                const PackWriterOptions& options = {});
+
+    // Closes the file. A pack that wasn't finished has no table, and won't open.
+    ~PackWriter();
+
+    PackWriter(PackWriter&&) = delete;
+    PackWriter& operator=(PackWriter&&) = delete;
+    PackWriter(const PackWriter&) = delete;
+    PackWriter& operator=(const PackWriter&) = delete;
+
+    // Names are paths with forward slashes, as they'll be asked for. Compressed assets that
+    // don't get any smaller are stored uncompressed. CompressionLevel::Fast suits data that's
+    // rebuilt often, High cold data that ships.
+    Result<> Add(StringView name,
+                 ByteView data,
+                 PackCompression compression = PackCompression::None,
+                 CompressionLevel level = CompressionLevel::Fast);
+
+    // Writes the table of contents. InvalidArgument if a name was added twice.
+    Result<> Finish();
+
+  private:
+    struct State;
+
+    PackWriter() = default;
+
+    State* m_state = nullptr;
+};
+
+// Fills in a pack file that doesn't have all its bytes yet, like a local copy of one on a
+// server that's fetched as it's read (rsbl-remote-pack.h). Called from any thread.
+class PackByteSource
+{
+  public:
+    virtual ~PackByteSource() = default;
+
+    // Once this succeeds, [offset, offset + size) of the file holds the pack's bytes
+    virtual Result<> Ensure(uint64 offset, uint64 size) = 0;
+};
+
+// An open pack. The table of contents is mapped, assets are read with ReadFileAt, so any number
+// of threads can look up and read at once.
+class Pack
+{
+  public:
+    static Result<UniquePtr<Pack>> Open(const char* path);
+
+    // A pack whose file source fills in as it's read: the footer and table of contents before
+    // they're mapped, each asset's stored bytes before they're read. source outlives the pack.
+    static Result<UniquePtr<Pack>> Open(const char* path, PackByteSource* source);
+
+    ~Pack();
+
+    Pack(Pack&&) = delete;
+    Pack& operator=(Pack&&) = delete;
+    Pack(const Pack&) = delete;
+    Pack& operator=(const Pack&) = delete;
+
+    // nullptr when the pack doesn't have it. hash is Hash<StringView> of name.
+    const PackEntry* Find(StringView name, uint64 hash) const;
+    const PackEntry* Find(StringView name) const;
+
+    // Reads the whole asset into the front of buffer, which has to hold entry.size bytes,
+    // decompressing it on this thread. Returns entry.size.
+    Result<uint64> Read(const PackEntry& entry, MutableByteView buffer) const;
+
+    // For splitting decompression up: read the stored bytes (entry.storedSize of them) with
+    // ReadStored, then hand each block to DecompressBlock on whichever thread. out is the whole
+    // asset's buffer, each block writes its own part of it.
+    Result<uint64> ReadStored(const PackEntry& entry, MutableByteView buffer) const;
+    uint32 BlockCount(const PackEntry& entry) const;
+    Result<> DecompressBlock(const PackEntry& entry,
+                             ByteView stored,
+                             uint32 block,
+                             MutableByteView out) const;
+
+    uint32 BlockSize() const;
+
+    uint32 EntryCount() const;
+
+    StringView EntryName(const PackEntry& entry) const;
+
+  private:
+    struct State;
+
+    Pack() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
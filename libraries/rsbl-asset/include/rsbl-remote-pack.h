@@ -0,0 +1,110 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-pack.h"
+
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+#include <rsbl-string.h>
+
+// A pack on a shared cache server, read through a local copy that's filled in as it's read, so
+// a machine only ever downloads the parts of a pack it touches rather than the whole file up
+// front. The local copy is a file as big as the pack, sparse where the file system can be,
+// tracked in chunks: a read fetches the chunks it covers that aren't there yet, neighbouring
+// ones in one request, big reads split across several connections at once. Which chunks are
+// there is kept beside the copy, so what one run fetched the next one already has.
+//
+// The server is anything that serves files over HTTP/1.1 with byte ranges (nginx, a CDN, most
+// artifact caches): a HEAD for the pack's size and ETag, then a "Range: bytes=a-b" GET per
+// fetch, on connections kept open between them.
+//
+//     RemotePackOptions options;
+//     options.host = "assets.build.local";
+//     options.port = 8080;
+//     Result<UniquePtr<RemotePack>> remote =
+//         RemotePack::Open("/packs/base.rpak", "cache/base.rpak", options);
+//     Result<UniquePtr<Pack>> pack =
+//         Pack::Open(remote.Value()->LocalPath(), remote.Value().Get());
+//
+// or Vfs::MountRemotePack, which does both.
+
+namespace rsbl
+{
+
+struct RemotePackOptions
+{
+    // The cache server, a name or an address. Plain HTTP: a server on the studio network, or a
+    // local proxy in front of one that isn't.
+    const char* host = "localhost";
+    uint16 port = 80;
+
+    // Requests in flight at once, each on its own connection
+    uint32 connections = 4;
+
+    // What the local copy is fetched and tracked in, a power of two of at least 4 KB. Smaller
+    // fetches less that isn't needed, bigger makes fewer requests.
+    uint32 chunkSize = 64 * 1024;
+
+    // Neighbouring missing chunks are fetched in one request up to this, a multiple of
+    // chunkSize. A bigger read is split, its pieces spread over the connections.
+    uint32 maxRequestSize = 2 * 1024 * 1024;
+
+    // For connecting, and for every send and receive after
+    uint32 timeoutMs = 10000;
+};
+
+struct RemotePackStats
+{
+    uint64 requests = 0;
+    uint64 bytesFetched = 0;
+    uint32 chunksPresent = 0;
+    uint32 chunkCount = 0;
+};
+
+class RemotePack : public PackByteSource
+{
+  public:
+    // remotePath is the pack's path on the server, "/packs/base.rpak". Asks the server for its
+    // size and ETag, then opens or makes the local copy at localPath and the chunk list beside
+    // it (localPath plus ".chunks"). A copy of a different size or ETag than the server's pack
+    // is started over. A server that sends no ETag can't be told apart from one with a pack
+    // rebuilt at the same size, so serve packs under names that change when they do.
+    static Result<UniquePtr<RemotePack>> Open(StringView remotePath,
+                                              const char* localPath,
+                                              const RemotePackOptions& options = {});
+
+    // Closes the connections. Ensure can't be running.
+    ~RemotePack() override;
+
+    RemotePack(RemotePack&&) = delete;
+    RemotePack& operator=(RemotePack&&) = delete;
+    RemotePack(const RemotePack&) = delete;
+    RemotePack& operator=(const RemotePack&) = delete;
+
+    // Fetches whatever of the range isn't in the local copy yet, and waits for it. From any
+    // number of threads: a chunk another thread is already fetching is waited for rather than
+    // fetched twice.
+    Result<> Ensure(uint64 offset, uint64 size) override;
+
+    // Everything, for a machine that's about to go offline
+    Result<> EnsureAll();
+
+    const char* LocalPath() const;
+
+    // The pack's size, and the local copy's
+    uint64 Size() const;
+
+    RemotePackStats GetStats() const;
+
+  private:
+    struct State;
+
+    RemotePack() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
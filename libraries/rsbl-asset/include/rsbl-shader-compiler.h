@@ -0,0 +1,157 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+#include <rsbl-string.h>
+
+// Compiles HLSL to DXIL (DX12) or SPIR-V (Vulkan) with DXC, once. A shader is keyed on what goes
+// into it: the stage, target, entry point, defines (in any order) and the text of its source and
+// every file it includes. The same permutation asked for twice is compiled once and handed out
+// again, and with a DerivedDataCache the bytecode outlives the process, so a launch where no
+// shader changed doesn't run DXC at all.
+//
+// With hot reload on, a FileWatcher on the source directory notes which files were saved, and
+// ReloadChanged recompiles every shader that includes one of them, in place:
+//
+//     Result<const Shader*> shader = compiler->Compile({"mesh.hlsl", ShaderStage::Pixel,
+//                                                       ShaderTarget::Dxil, defines});
+//     ...
+//     // Once a frame. Pipelines made from a shader whose generation moved get remade.
+//     if (compiler->ReloadChanged() > 0) { ... }
+
+namespace rsbl
+{
+
+class DerivedDataCache;
+
+enum class ShaderStage : uint8
+{
+    Vertex,
+    Pixel,
+    Compute,
+    Amplification,
+    Mesh,
+};
+
+enum class ShaderTarget : uint8
+{
+    Dxil,
+    Spirv,
+};
+
+struct ShaderDefine
+{
+    StringView name;
+    StringView value = "1";
+};
+
+struct ShaderRequest
+{
+    // Relative to the source directory, with '/' separators
+    StringView path;
+    ShaderStage stage = ShaderStage::Vertex;
+    ShaderTarget target = ShaderTarget::Dxil;
+    ArrayView<const ShaderDefine> defines;
+    StringView entryPoint = "main";
+};
+
+struct Shader
+{
+    DynamicArray<uint8> bytecode;
+    // Goes up each time a reload replaces the bytecode
+    uint32 generation = 0;
+};
+
+// Everything a compile gets, defines sorted by name
+struct ShaderCompileInput
+{
+    StringView source;
+    // The main file, for the compiler's messages and for resolving includes next to it
+    StringView path;
+    // Where includes that aren't next to the including file are looked for
+    StringView includeDirectory;
+    StringView entryPoint;
+    ShaderStage stage = ShaderStage::Vertex;
+    ShaderTarget target = ShaderTarget::Dxil;
+    ArrayView<const ShaderDefine> defines;
+};
+
+// Fills bytecode, or errors with the compiler's messages and fails
+using ShaderCompileFunction = PooledFunction<
+    Result<>(const ShaderCompileInput& input, DynamicArray<uint8>& bytecode, String& errors),
+    32>;
+
+struct ShaderCompilerOptions
+{
+    const char* sourceDirectory = "shaders";
+
+    // Where bytecode is kept between runs. nullptr keeps it for this run only.
+    DerivedDataCache* cache = nullptr;
+
+    // Watches sourceDirectory for edits, for ReloadChanged to pick up
+    bool hotReload = false;
+};
+
+struct ShaderCompilerStats
+{
+    // Times the compile function ran
+    uint64 compiles = 0;
+    // Bytecode found in the derived data cache instead
+    uint64 cacheHits = 0;
+    // Requests for a permutation already compiled
+    uint64 deduped = 0;
+    // Shaders recompiled by ReloadChanged
+    uint64 reloads = 0;
+    uint64 failedReloads = 0;
+};
+
+// Compile and ReloadChanged belong to one thread, the one that makes pipelines
+class ShaderCompiler
+{
+  public:
+    // An empty compile function means DXC, which is loaded at runtime (dxcompiler.dll or
+    // libdxcompiler.so) and fails Create when it isn't there. Tests and tools pass their own.
+    static Result<UniquePtr<ShaderCompiler>> Create(const ShaderCompilerOptions& options = {},
+                                                    ShaderCompileFunction&& compile = {});
+
+    // Stops watching before anything is freed
+    ~ShaderCompiler();
+
+    ShaderCompiler(ShaderCompiler&&) = delete;
+    ShaderCompiler& operator=(ShaderCompiler&&) = delete;
+    ShaderCompiler(const ShaderCompiler&) = delete;
+    ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+
+    // The shader stays where it is for the compiler's lifetime, reloads replace its bytecode
+    Result<const Shader*> Compile(const ShaderRequest& request);
+
+    // Recompiles shaders whose source or includes changed since the last call, and returns how
+    // many it replaced. One that fails to compile keeps its old bytecode, and the error is
+    // logged, so a typo mid-edit doesn't take the shader away.
+    uint32 ReloadChanged();
+
+    // Notes a changed file, relative to the source directory. The watcher calls this, and
+    // it's safe from any thread.
+    void MarkChanged(StringView path);
+
+    // Treats every file as changed, for when the watcher lost track
+    void MarkAllChanged();
+
+    ShaderCompilerStats Stats() const;
+
+  private:
+    struct State;
+
+    ShaderCompiler() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
@@ -0,0 +1,141 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-image.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+
+// Mip streaming. A .rtex streamed texture stores its mips coarsest first, so the mip tail, every
+// mip small enough not to be worth streaming, is one read at the front of the file. Opening a
+// texture reads only the tail; finer mips come in on demand, one read each on the async IO queue
+// (rsbl-async-io.h), and go again once they're not sampled and the budget needs the room.
+//
+// The demand is what the GPU actually sampled: the finest mip per texture, as a sampler feedback
+// pass resolves it (D3D12 sampler feedback, or a shader writing the min mip it sampled into a
+// buffer with atomics on Vulkan). Either gets read back a frame or two late, which is fine, the
+// tail covers for it meanwhile.
+//
+//     Result<uint32> rock = streamer->Open("textures/rock.rtex");
+//     ... every frame ...
+//     streamer->RequestFromFeedback(min_mips_read_back);
+//     streamer->Update();
+//     for (const StreamedMip& arrived : streamer->Arrived()) { ... upload it ... }
+//     ... clamp each texture's sampling to ResidentMip, the finest mip it has ...
+//
+// Mips are resident as a contiguous range down from the tail, so trilinear filtering always has
+// the next coarser mip. A TextureStreamer is driven by one thread, the one running the frame.
+
+namespace rsbl
+{
+
+class AsyncIo;
+
+constexpr uint32 kStreamedTextureVersion = 1;
+
+// Enough for a 32768 texel side
+constexpr uint32 kMaxTextureMips = 16;
+
+// What a feedback entry holds for a texture no pixel sampled
+constexpr uint8 kMipNotSampled = 0xFF;
+
+// Writes a streamed texture. mips is the full chain finest first, each the next size down as
+// GenerateMips makes them, all the same format. InvalidArgument for a chain that isn't one.
+Result<> WriteStreamedTexture(const char* path, ArrayView<const Image> mips);
+
+struct StreamedTextureInfo
+{
+    uint32 width = 0;
+    uint32 height = 0;
+    ImageFormat format = ImageFormat::Rgba8;
+    uint32 mipCount = 0;
+    // The first mip of the tail, which stays resident from Open on
+    uint32 tailMip = 0;
+};
+
+struct StreamedMip
+{
+    uint32 texture;
+    uint32 mip;
+};
+
+struct TextureStreamerOptions
+{
+    // Memory for the mips above the tails, resident and being read. Tails don't count, they're
+    // small and always there.
+    uint64 budget = 512ull << 20;
+    // A texture's tail is its coarsest mips up to this many bytes between them, always at least
+    // the 1x1 one
+    uint64 tailBytes = 64 * 1024;
+    // Mip reads in flight at once, across every texture
+    uint32 maxReadsInFlight = 32;
+};
+
+struct TextureStreamerStats
+{
+    uint64 tailBytes = 0;
+    uint64 residentBytes = 0;
+    uint64 pendingBytes = 0;
+    uint64 mipsRead = 0;
+    uint64 mipsEvicted = 0;
+    // Updates that left a wanted mip out because what's resident is all wanted too
+    uint64 overBudgetUpdates = 0;
+    uint64 failedReads = 0;
+};
+
+class TextureStreamer
+{
+  public:
+    // io has to outlive the streamer, and can't be used for anything else meanwhile
+    static Result<UniquePtr<TextureStreamer>> Create(AsyncIo& io,
+                                                     const TextureStreamerOptions& options = {});
+
+    // Waits for the reads in flight, they write into the streamer's memory
+    ~TextureStreamer();
+
+    TextureStreamer(TextureStreamer&&) = delete;
+    TextureStreamer& operator=(TextureStreamer&&) = delete;
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Reads the header and the tail, blocking, and returns the texture's index
+    Result<uint32> Open(const char* path);
+
+    uint32 TextureCount() const;
+    const StreamedTextureInfo& Info(uint32 texture) const;
+
+    // Asks for texture down to mip for the next Update. Several requests keep the finest.
+    void Request(uint32 texture, uint32 mip);
+
+    // A request per texture, one byte each as a min mip feedback pass resolves them, indexed by
+    // texture. kMipNotSampled asks for nothing.
+    void RequestFromFeedback(ArrayView<const uint8> min_mips);
+
+    // Once a frame: takes in the reads that finished, makes room in the budget by dropping mips
+    // nothing asked for this frame, least recently asked for first, then starts reads for what
+    // was asked for, blurriest relative to the request first
+    void Update();
+
+    // The mips that came in during the last Update, to upload
+    ArrayView<const StreamedMip> Arrived() const;
+
+    // The finest mip in memory, every coarser one is too
+    uint32 ResidentMip(uint32 texture) const;
+
+    // A resident mip's bytes as Image::pixels would hold them, empty for one that isn't
+    ByteView MipData(uint32 texture, uint32 mip) const;
+
+    TextureStreamerStats Stats() const;
+
+  private:
+    struct State;
+
+    TextureStreamer() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
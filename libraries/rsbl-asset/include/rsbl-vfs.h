@@ -0,0 +1,84 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-result.h>
+#include <rsbl-string-id.h>
+#include <rsbl-string.h>
+
+// One namespace of asset paths over loose directories and packs (rsbl-pack.h). Paths are
+// relative with forward slashes, "textures/rock.png", and resolve against the mounts newest
+// first, so a directory mounted after a pack overrides what's in it, which is how local edits
+// and patches win over shipped data.
+//
+//     Vfs vfs;
+//     vfs.MountPack("data/base.rpak");
+//     vfs.MountDirectory("data/loose");
+//     DynamicArray<uint8> bytes;
+//     Result<> read = vfs.ReadAll("scenes/sponza.gltf", bytes);
+//
+// Mount everything up front: lookups and reads can come from any number of threads at once,
+// mounting can't happen alongside them.
+
+namespace rsbl
+{
+
+struct RemotePackOptions;
+
+class Vfs
+{
+  public:
+    Vfs();
+    ~Vfs();
+
+    Vfs(Vfs&&) = delete;
+    Vfs& operator=(Vfs&&) = delete;
+    Vfs(const Vfs&) = delete;
+    Vfs& operator=(const Vfs&) = delete;
+
+    // Files under directory, looked up when asked for, so files added later are found
+    Result<> MountDirectory(const char* directory);
+
+    // The pack's table of contents is mapped and checked now, and the file stays open
+    Result<> MountPack(const char* path);
+
+    // A pack on a cache server, read through a local copy at localPath that fills in as it's
+    // read (rsbl-remote-pack.h). Its table of contents is fetched now, assets as they're read.
+    Result<> MountRemotePack(StringView remotePath,
+                             const char* localPath,
+                             const RemotePackOptions& options);
+
+    bool Exists(StringView path) const;
+
+    // Bytes Read needs room for
+    Result<uint64> GetSize(StringView path) const;
+
+    // Reads the whole file into the front of buffer, which needs GetSize bytes. Returns how many
+    // were read. A pack entry is a single positional read.
+    Result<uint64> Read(StringView path, MutableByteView buffer) const;
+
+    // Sizes out to the file and reads it all
+    Result<> ReadAll(StringView path, DynamicArray<uint8>& out) const;
+
+    // The same, with the hash an interned name already has
+    bool Exists(StringId path) const;
+    Result<uint64> GetSize(StringId path) const;
+    Result<uint64> Read(StringId path, MutableByteView buffer) const;
+    Result<> ReadAll(StringId path, DynamicArray<uint8>& out) const;
+
+  private:
+    struct State;
+    struct Location;
+
+    Result<Location> Find(StringView path, uint64 hash) const;
+    Result<uint64> Read(StringView path, uint64 hash, MutableByteView buffer) const;
+    Result<> ReadAll(StringView path, uint64 hash, DynamicArray<uint8>& out) const;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
@@ -0,0 +1,360 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-asset-manager.h"
+
+#include "include/rsbl-vfs.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-hash-map.h>
+#include <rsbl-hash.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-sync.h>
+
+namespace rsbl
+{
+
+using Internal::AssetEntry;
+
+namespace
+{
+struct AssetKey
+{
+    StringId path;
+    const void* type;
+
+    bool operator==(const AssetKey&) const = default;
+};
+} // namespace
+
+template <>
+struct Hash<AssetKey>
+{
+    uint64 operator()(const AssetKey& key) const
+    {
+        return HashCombine(key.path.GetHash(), Hash<const void*>()(key.type));
+    }
+};
+
+struct AssetManager::State
+{
+    struct RegisteredLoader
+    {
+        const void* type;
+        ErasedLoader load;
+        void (*destroy)(void*);
+    };
+
+    const Vfs* vfs = nullptr;
+    JobSystem* jobs = nullptr;
+    AssetManagerOptions options;
+
+    // Only changed before any loads, read without the lock
+    DynamicArray<RegisteredLoader> loaders{GetTaggedAllocator(MemoryTag::Asset)};
+
+    // Everything below is under the lock. A reference count only goes to zero under it too, and
+    // Load only finds entries under it, so an entry with none left can't be picked back up while
+    // it's being freed.
+    mutable Mutex lock;
+    HashMap<AssetKey, AssetEntry*> entries{GetTaggedAllocator(MemoryTag::Asset)};
+    AssetEntry* oldest = nullptr;
+    AssetEntry* newest = nullptr;
+    AssetManagerStats stats;
+
+    JobCounter loads;
+
+    const RegisteredLoader* FindLoader(const void* type) const
+    {
+        for (const RegisteredLoader& loader : loaders)
+        {
+            if (loader.type == type)
+            {
+                return &loader;
+            }
+        }
+        return nullptr;
+    }
+
+    void Cache(AssetEntry* entry)
+    {
+        entry->previous = newest;
+        entry->next = nullptr;
+        (newest != nullptr ? newest->next : oldest) = entry;
+        newest = entry;
+        entry->cached = true;
+        ++stats.cachedAssets;
+    }
+
+    void Uncache(AssetEntry* entry)
+    {
+        (entry->previous != nullptr ? entry->previous->next : oldest) = entry->next;
+        (entry->next != nullptr ? entry->next->previous : newest) = entry->previous;
+        entry->previous = nullptr;
+        entry->next = nullptr;
+        entry->cached = false;
+        --stats.cachedAssets;
+    }
+
+    // Takes the entry out of the table, to be freed once the lock is let go
+    void Remove(AssetEntry* entry, DynamicArray<AssetEntry*>& freed)
+    {
+        if (entry->cached)
+        {
+            Uncache(entry);
+        }
+        entries.Remove(AssetKey{entry->path, entry->type});
+        stats.cpuBytes -= entry->size.cpuBytes;
+        stats.gpuBytes -= entry->size.gpuBytes;
+        --stats.assets;
+        freed.PushBack(entry);
+    }
+
+    // Least recently released first, until the totals fit the limits or nothing's cached
+    void Evict(uint64 cpu_limit, uint64 gpu_limit, DynamicArray<AssetEntry*>& freed)
+    {
+        while (oldest != nullptr && (stats.cpuBytes > cpu_limit || stats.gpuBytes > gpu_limit))
+        {
+            Remove(oldest, freed);
+            ++stats.evictions;
+        }
+    }
+
+    // Destructors can be slow, they run outside the lock
+    void Free(ArrayView<AssetEntry* const> freed) const
+    {
+        for (AssetEntry* entry : freed)
+        {
+            if (entry->object != nullptr)
+            {
+                FindLoader(entry->type)->destroy(entry->object);
+            }
+            delete entry;
+        }
+    }
+};
+
+void Internal::ReleaseAsset(AssetEntry* entry)
+{
+    entry->manager->Release(entry);
+}
+
+Result<UniquePtr<AssetManager>> AssetManager::Create(const Vfs& vfs,
+                                                     JobSystem& jobs,
+                                                     const AssetManagerOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (options.priority >= JobPriority::Count)
+    {
+        return {ErrorCategory::InvalidArgument, "Not a job priority"};
+    }
+
+    UniquePtr<AssetManager> manager(new AssetManager());
+    manager->m_state = new State();
+    manager->m_state->vfs = &vfs;
+    manager->m_state->jobs = &jobs;
+    manager->m_state->options = options;
+    return rsblMove(manager);
+}
+
+AssetManager::~AssetManager()
+{
+    WaitForLoads();
+
+    State* state = m_state;
+    DynamicArray<AssetEntry*> freed(GetTaggedAllocator(MemoryTag::Asset));
+    for (auto& entry : state->entries)
+    {
+        rsblAssertMsg(entry.value->references.load(std::memory_order_relaxed) == 0,
+                      "Asset handles outlived their manager");
+        freed.PushBack(entry.value);
+    }
+    state->Free(freed);
+    delete state;
+}
+
+void AssetManager::RegisterLoader(const void* type, ErasedLoader&& loader, void (*destroy)(void*))
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+
+    for (State::RegisteredLoader& registered : state->loaders)
+    {
+        if (registered.type == type)
+        {
+            registered.load = rsblMove(loader);
+            registered.destroy = destroy;
+            return;
+        }
+    }
+    state->loaders.PushBack(State::RegisteredLoader{type, rsblMove(loader), destroy});
+}
+
+AssetEntry* AssetManager::Load(StringView path, const void* type)
+{
+    return Load(StringId(path), type);
+}
+
+AssetEntry* AssetManager::Load(StringId path, const void* type)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+    rsblAssertMsg(state->FindLoader(type) != nullptr, "No loader registered for the asset type");
+
+    AssetEntry* entry = nullptr;
+    {
+        LockGuard<Mutex> lock(state->lock);
+        AssetEntry** found = state->entries.Find(AssetKey{path, type});
+        if (found != nullptr)
+        {
+            entry = *found;
+            if (entry->references.fetch_add(1, std::memory_order_relaxed) == 0 && entry->cached)
+            {
+                state->Uncache(entry);
+            }
+            ++state->stats.hits;
+            return entry;
+        }
+
+        entry = new AssetEntry();
+        entry->manager = this;
+        entry->path = path;
+        entry->type = type;
+        // The handle's, and the load job's until it's done
+        entry->references.store(2, std::memory_order_relaxed);
+        state->entries.Insert(AssetKey{path, type}, entry);
+        ++state->stats.assets;
+        ++state->stats.loads;
+    }
+
+    // Outside the lock, a full queue runs the job right here
+    state->jobs->Submit(
+        [this, entry]() { RunLoad(entry); }, &state->loads, state->options.priority);
+    return entry;
+}
+
+void AssetManager::RunLoad(AssetEntry* entry)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+
+    AssetSize size;
+    ErrorCategory error = ErrorCategory::None;
+    void* object = nullptr;
+    {
+        DynamicArray<uint8> bytes(GetTaggedAllocator(MemoryTag::Asset));
+        Result<> read = state->vfs->ReadAll(entry->path, bytes);
+        if (read)
+        {
+            Result<void*> loaded = state->FindLoader(entry->type)->load(bytes, size);
+            if (loaded)
+            {
+                object = loaded.Value();
+            }
+            else
+            {
+                error = loaded.Category();
+                size = {};
+            }
+        }
+        else
+        {
+            error = read.Category();
+        }
+    }
+
+    DynamicArray<AssetEntry*> freed(GetTaggedAllocator(MemoryTag::Asset));
+    {
+        LockGuard<Mutex> lock(state->lock);
+        entry->object = object;
+        entry->error = error;
+        entry->size = size;
+        entry->state.store(object != nullptr ? AssetState::Ready : AssetState::Failed,
+                           std::memory_order_release);
+        state->stats.cpuBytes += size.cpuBytes;
+        state->stats.gpuBytes += size.gpuBytes;
+        state->Evict(state->options.cpuBudget, state->options.gpuBudget, freed);
+    }
+    state->Free(freed);
+
+    Release(entry);
+}
+
+void AssetManager::Release(AssetEntry* entry)
+{
+    // Dropping a reference that isn't the last is just the decrement
+    uint32 references = entry->references.load(std::memory_order_relaxed);
+    while (references > 1)
+    {
+        if (entry->references.compare_exchange_weak(
+                references, references - 1, std::memory_order_acq_rel))
+        {
+            return;
+        }
+    }
+
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+    DynamicArray<AssetEntry*> freed(GetTaggedAllocator(MemoryTag::Asset));
+    {
+        LockGuard<Mutex> lock(state->lock);
+        if (entry->references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+        // Failures aren't kept, so loading it again tries again
+        if (entry->state.load(std::memory_order_relaxed) == AssetState::Failed)
+        {
+            state->Remove(entry, freed);
+        }
+        else
+        {
+            state->Cache(entry);
+            state->Evict(state->options.cpuBudget, state->options.gpuBudget, freed);
+        }
+    }
+    state->Free(freed);
+}
+
+void AssetManager::WaitForLoads()
+{
+    m_state->jobs->Wait(m_state->loads);
+}
+
+void AssetManager::SetBudgets(uint64 cpu_budget, uint64 gpu_budget)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+    DynamicArray<AssetEntry*> freed(GetTaggedAllocator(MemoryTag::Asset));
+    {
+        LockGuard<Mutex> lock(state->lock);
+        state->options.cpuBudget = cpu_budget;
+        state->options.gpuBudget = gpu_budget;
+        state->Evict(cpu_budget, gpu_budget, freed);
+    }
+    state->Free(freed);
+}
+
+void AssetManager::EvictUnused()
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+    DynamicArray<AssetEntry*> freed(GetTaggedAllocator(MemoryTag::Asset));
+    {
+        LockGuard<Mutex> lock(state->lock);
+        while (state->oldest != nullptr)
+        {
+            state->Remove(state->oldest, freed);
+            ++state->stats.evictions;
+        }
+    }
+    state->Free(freed);
+}
+
+AssetManagerStats AssetManager::Stats() const
+{
+    LockGuard<Mutex> lock(m_state->lock);
+    return m_state->stats;
+}
+
+} // namespace rsbl
@@ -0,0 +1,311 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-asset-manager.h"
+#include "include/rsbl-vfs.h"
+
+#include <rsbl-file.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kDirectory = "rsbl-asset-manager-test-dir";
+
+// The file's text, 1 CPU byte and 2 GPU bytes per character
+struct TextAsset
+{
+    String text;
+
+    static std::atomic<int32> live;
+
+    TextAsset()
+    {
+        live.fetch_add(1);
+    }
+
+    ~TextAsset()
+    {
+        live.fetch_sub(1);
+    }
+};
+
+std::atomic<int32> TextAsset::live{0};
+
+// A second type over the same files, empty ones fail to load
+struct LengthAsset
+{
+    uint64 length = 0;
+};
+
+void WriteLooseFile(const char* name, const char* text)
+{
+    char path[256];
+    std::snprintf(path, sizeof(path), "%s/%s", kDirectory, name);
+    Result<FileHandle> file = OpenFile(path, FileOpenMode::Write);
+    REQUIRE(file);
+    REQUIRE(WriteFile(file.Value(), AsBytes(text, std::strlen(text))));
+    CHECK(CloseFile(file.Value()));
+}
+
+// Every test gets the same few files, a hundred characters each but for empty.txt
+struct Fixture
+{
+    Vfs vfs;
+    UniquePtr<JobSystem> jobs;
+
+    Fixture()
+    {
+        std::filesystem::remove_all(kDirectory);
+        std::filesystem::create_directories(kDirectory);
+        char text[101];
+        for (const char name : {'a', 'b', 'c', 'd'})
+        {
+            std::memset(text, name, 100);
+            text[100] = 0;
+            char file[8];
+            std::snprintf(file, sizeof(file), "%c.txt", name);
+            WriteLooseFile(file, text);
+        }
+        WriteLooseFile("empty.txt", "");
+        REQUIRE(vfs.MountDirectory(kDirectory));
+
+        JobSystemOptions options;
+        options.workerCount = 3;
+        Result<UniquePtr<JobSystem>> created = JobSystem::Create(options);
+        REQUIRE(created);
+        jobs = rsblMove(created.Value());
+    }
+
+    ~Fixture()
+    {
+        std::filesystem::remove_all(kDirectory);
+    }
+
+    UniquePtr<AssetManager> CreateManager(const AssetManagerOptions& options = {})
+    {
+        Result<UniquePtr<AssetManager>> manager = AssetManager::Create(vfs, *jobs, options);
+        REQUIRE(manager);
+        manager.Value()->RegisterLoader<TextAsset>(
+            [](ByteView bytes, AssetSize& size) -> Result<UniquePtr<TextAsset>> {
+                UniquePtr<TextAsset> asset(new TextAsset());
+                asset->text = String(StringView(reinterpret_cast<const char*>(bytes.Data()),
+                                                bytes.Size()));
+                size.cpuBytes = bytes.Size();
+                size.gpuBytes = bytes.Size() * 2;
+                return rsblMove(asset);
+            });
+        manager.Value()->RegisterLoader<LengthAsset>(
+            [](ByteView bytes, AssetSize& size) -> Result<UniquePtr<LengthAsset>> {
+                if (bytes.IsEmpty())
+                {
+                    return {ErrorCategory::InvalidArgument, "Nothing in it"};
+                }
+                UniquePtr<LengthAsset> asset(new LengthAsset());
+                asset->length = bytes.Size();
+                size.cpuBytes = sizeof(LengthAsset);
+                return rsblMove(asset);
+            });
+        return rsblMove(manager.Value());
+    }
+};
+} // namespace
+
+TEST_SUITE("rsbl::AssetManager")
+{
+    TEST_CASE("Loads are shared and finish on jobs")
+    {
+        Fixture fixture;
+        UniquePtr<AssetManager> manager = fixture.CreateManager();
+
+        AssetHandle<TextAsset> first = manager->Load<TextAsset>("a.txt");
+        AssetHandle<TextAsset> second = manager->Load<TextAsset>(StringId("a.txt"));
+        CHECK(first == second);
+        // Another type is another asset, even from the same file
+        AssetHandle<LengthAsset> length = manager->Load<LengthAsset>("a.txt");
+
+        manager->WaitForLoads();
+        REQUIRE(first.State() == AssetState::Ready);
+        REQUIRE(first.Get() != nullptr);
+        CHECK(first.Get()->text.Size() == 100);
+        CHECK(first.Get()->text.CStr()[0] == 'a');
+        CHECK(first.Error() == ErrorCategory::None);
+        CHECK(std::strcmp(first.Path().CStr(), "a.txt") == 0);
+        REQUIRE(length.Get() != nullptr);
+        CHECK(length.Get()->length == 100);
+
+        AssetManagerStats stats = manager->Stats();
+        CHECK(stats.loads == 2);
+        CHECK(stats.hits == 1);
+        CHECK(stats.assets == 2);
+        CHECK(stats.cachedAssets == 0);
+        CHECK(stats.cpuBytes == 100 + sizeof(LengthAsset));
+        CHECK(stats.gpuBytes == 200);
+
+        // Copies and moves count, the asset stays until the last goes and then stays cached
+        AssetHandle<TextAsset> copy = first;
+        AssetHandle<TextAsset> moved = rsblMove(second);
+        CHECK(second.IsNull());
+        first.Reset();
+        copy = AssetHandle<TextAsset>();
+        CHECK(manager->Stats().cachedAssets == 0);
+        moved.Reset();
+        CHECK(manager->Stats().cachedAssets == 1);
+        CHECK(TextAsset::live.load() == 1);
+
+        // Loading it again finds it cached, ready without a read
+        AssetHandle<TextAsset> again = manager->Load<TextAsset>("a.txt");
+        CHECK(again.Get() != nullptr);
+        stats = manager->Stats();
+        CHECK(stats.loads == 2);
+        CHECK(stats.hits == 2);
+        CHECK(stats.cachedAssets == 0);
+
+        again.Reset();
+        length.Reset();
+        manager->EvictUnused();
+        stats = manager->Stats();
+        CHECK(stats.assets == 0);
+        CHECK(stats.cpuBytes == 0);
+        CHECK(stats.evictions == 2);
+        CHECK(TextAsset::live.load() == 0);
+    }
+
+    TEST_CASE("Failures say why, and aren't kept")
+    {
+        Fixture fixture;
+        UniquePtr<AssetManager> manager = fixture.CreateManager();
+
+        AssetHandle<TextAsset> missing = manager->Load<TextAsset>("missing.txt");
+        AssetHandle<LengthAsset> empty = manager->Load<LengthAsset>("empty.txt");
+        manager->WaitForLoads();
+        CHECK(missing.State() == AssetState::Failed);
+        CHECK(missing.Get() == nullptr);
+        CHECK(missing.Error() == ErrorCategory::NotFound);
+        CHECK(empty.State() == AssetState::Failed);
+        CHECK(empty.Error() == ErrorCategory::InvalidArgument);
+
+        // Still shared while held
+        AssetHandle<TextAsset> same = manager->Load<TextAsset>("missing.txt");
+        CHECK(same == missing);
+        CHECK(manager->Stats().loads == 2);
+
+        // Gone once let go, so the next load tries again and finds the file
+        same.Reset();
+        missing.Reset();
+        CHECK(manager->Stats().assets == 1);
+        WriteLooseFile("missing.txt", "here now");
+        AssetHandle<TextAsset> found = manager->Load<TextAsset>("missing.txt");
+        manager->WaitForLoads();
+        REQUIRE(found.Get() != nullptr);
+        CHECK(found.Get()->text.Size() == 8);
+        CHECK(manager->Stats().loads == 3);
+    }
+
+    TEST_CASE("Cached assets are evicted least recently released first")
+    {
+        Fixture fixture;
+        AssetManagerOptions options;
+        options.cpuBudget = 250;
+        options.gpuBudget = 1000;
+        UniquePtr<AssetManager> manager = fixture.CreateManager(options);
+
+        AssetHandle<TextAsset> a = manager->Load<TextAsset>("a.txt");
+        AssetHandle<TextAsset> b = manager->Load<TextAsset>("b.txt");
+        AssetHandle<TextAsset> c = manager->Load<TextAsset>("c.txt");
+        manager->WaitForLoads();
+
+        // Everything's referenced, so over budget or not it all stays
+        AssetManagerStats stats = manager->Stats();
+        CHECK(stats.cpuBytes == 300);
+        CHECK(stats.evictions == 0);
+
+        // a goes as soon as it's let go, it's what's over. b and c then fit.
+        a.Reset();
+        CHECK(manager->Stats().evictions == 1);
+        b.Reset();
+        c.Reset();
+        stats = manager->Stats();
+        CHECK(stats.cpuBytes == 200);
+        CHECK(stats.cachedAssets == 2);
+
+        // d needs room, b was released before c
+        AssetHandle<TextAsset> d = manager->Load<TextAsset>("d.txt");
+        manager->WaitForLoads();
+        stats = manager->Stats();
+        CHECK(stats.evictions == 2);
+        CHECK(stats.cpuBytes == 200);
+        const uint64 loads = stats.loads;
+        c = manager->Load<TextAsset>("c.txt");
+        CHECK(c.Get() != nullptr);
+        CHECK(manager->Stats().loads == loads);
+        b = manager->Load<TextAsset>("b.txt");
+        CHECK(manager->Stats().loads == loads + 1);
+        manager->WaitForLoads();
+
+        // Tightening the budget evicts right away, but only what isn't referenced
+        b.Reset();
+        c.Reset();
+        manager->SetBudgets(1000, 250);
+        stats = manager->Stats();
+        CHECK(stats.gpuBytes == 200);
+        CHECK(stats.assets == 1);
+        CHECK(d.Get() != nullptr);
+        manager->SetBudgets(0, 0);
+        CHECK(manager->Stats().assets == 1);
+    }
+
+    TEST_CASE("Loads and releases from many threads at once")
+    {
+        Fixture fixture;
+        AssetManagerOptions options;
+        options.cpuBudget = 150;
+        options.priority = JobPriority::High;
+        UniquePtr<AssetManager> manager = fixture.CreateManager(options);
+        AssetManager* shared = manager.Get();
+
+        const char* names[4] = {"a.txt", "b.txt", "c.txt", "d.txt"};
+        std::atomic<uint32> wrong{0};
+        JobCounter counter;
+        for (uint32 job = 0; job < 64; ++job)
+        {
+            fixture.jobs->Submit(
+                [shared, &names, &wrong, job]() {
+                    for (uint32 i = 0; i < 50; ++i)
+                    {
+                        AssetHandle<TextAsset> handle =
+                            shared->Load<TextAsset>(names[(job + i) % 4]);
+                        AssetHandle<TextAsset> copy = handle;
+                        const TextAsset* asset = copy.Get();
+                        if (asset != nullptr && asset->text.Size() != 100)
+                        {
+                            wrong.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                },
+                &counter,
+                JobPriority::Medium);
+        }
+        fixture.jobs->Wait(counter);
+        manager->WaitForLoads();
+
+        // Whatever interleaving, nothing's referenced now, so what's left fits the budget
+        const AssetManagerStats stats = manager->Stats();
+        CHECK(stats.cpuBytes <= 150);
+        CHECK(stats.assets == stats.cachedAssets);
+        CHECK(stats.loads + stats.hits == 64 * 50);
+        CHECK(TextAsset::live.load() == int32(stats.assets));
+        CHECK(wrong.load() == 0);
+
+        manager.Reset();
+        CHECK(TextAsset::live.load() == 0);
+    }
+}
@@ -0,0 +1,825 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-cooked-mesh.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-packing.h>
+#include <rsbl-simd.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kCookedMeshMagic = 0x48534D52; // "RMSH"
+
+// Every section starts on this
+constexpr uint64 kSectionAlignment = 16;
+
+constexpr uint32 kSectionCount = static_cast<uint32>(CookedMeshSection::Count);
+
+struct SectionRange
+{
+    uint64 offset;
+    uint64 size;
+};
+
+// First thing in the file
+struct CookedMeshHeader
+{
+    uint32 magic;
+    uint32 version;
+    int64 sourceModifiedTime;
+    uint64 sourceSize;
+    SectionRange sections[kSectionCount];
+};
+
+// What each section holds, to check its size against
+constexpr uint64 kElementSizes[kSectionCount] = {
+    sizeof(CookedVertex),
+    sizeof(uint32),
+    sizeof(CookedMeshlet),
+    sizeof(uint32),
+    3,
+    sizeof(CookedSubmesh),
+    sizeof(CookedMeshRange),
+    sizeof(CookedNode),
+    sizeof(CookedLod),
+};
+
+// Plenty for halving the triangles each time, and levels have to fit SelectLods' bytes
+constexpr uint32 kMaxLodCount = 16;
+
+// Any unit vector at right angles to normal, for frames without a tangent
+simd::float4 AnyPerpendicular(simd::float4 normal)
+{
+    const simd::float4 axis = simd::Abs(normal).X() < 0.9f ? simd::float4(1.0f, 0.0f, 0.0f, 0.0f)
+                                                           : simd::float4(0.0f, 1.0f, 0.0f, 0.0f);
+    return simd::Normalize3(simd::Cross3(normal, axis));
+}
+
+uint16 QuantizeCoordinate(float value, float min, float extent)
+{
+    return extent > 0.0f ? PackUnorm16((value - min) / extent) : 0;
+}
+} // namespace
+
+struct MeshCooker::State
+{
+    MeshCookerOptions options;
+
+    DynamicArray<CookedVertex> vertices{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<uint32> indices{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<CookedMeshlet> meshlets{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<uint32> meshletVertices{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<uint8> meshletTriangles{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<CookedSubmesh> submeshes{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<CookedMeshRange> meshes{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<CookedNode> nodes{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<CookedLod> lods{GetTaggedAllocator(MemoryTag::Asset)};
+
+    MeshCookerStats stats;
+
+    // The cone's axis is the average of the triangles' unit normals, its cutoff the sine of the
+    // widest angle between the axis and any of them. Past about 84 degrees a cone culls nothing
+    // worth testing for, so the cutoff is left at 1.
+    void ComputeNormalCone(CookedMeshlet& meshlet,
+                           const uint32* vertexIndices,
+                           ArrayView<const float3> positions) const
+    {
+        const uint8* corners = meshletTriangles.Data() + uint64(meshlet.triangleOffset) * 3;
+        simd::float4 normals[255];
+        uint32 normal_count = 0;
+        simd::float4 sum(0.0f);
+        for (uint32 t = 0; t < meshlet.triangleCount; ++t)
+        {
+            const simd::float4 a = simd::Load(positions[vertexIndices[corners[t * 3]]]);
+            const simd::float4 b = simd::Load(positions[vertexIndices[corners[t * 3 + 1]]]);
+            const simd::float4 c = simd::Load(positions[vertexIndices[corners[t * 3 + 2]]]);
+            const simd::float4 normal = simd::Cross3(b - a, c - a);
+            const float length = simd::Length3(normal);
+            // Degenerate triangles are never drawn, they don't face anywhere
+            if (length > 0.0f)
+            {
+                normals[normal_count] = normal / length;
+                sum = sum + normals[normal_count];
+                ++normal_count;
+            }
+        }
+
+        meshlet.coneAxis = float3(0.0f, 0.0f, 1.0f);
+        meshlet.coneCutoff = 1.0f;
+        const float sum_length = simd::Length3(sum);
+        if (normal_count == 0 || sum_length == 0.0f)
+        {
+            return;
+        }
+        const simd::float4 axis = sum / sum_length;
+        float min_dot = 1.0f;
+        for (uint32 i = 0; i < normal_count; ++i)
+        {
+            const float d = simd::Dot3(axis, normals[i]);
+            min_dot = d < min_dot ? d : min_dot;
+        }
+        meshlet.coneAxis = simd::ToFloat3(axis);
+        if (min_dot > 0.1f)
+        {
+            meshlet.coneCutoff = std::sqrt(1.0f - min_dot * min_dot);
+        }
+    }
+
+    // Greedy: triangles go into the current meshlet in index order until one more would take it
+    // over either limit. The triangles are in vertex cache order by now, which keeps neighbours
+    // together well enough.
+    void BuildMeshlets(CookedSubmesh& submesh,
+                       ArrayView<const uint32> triangles,
+                       ArrayView<const float3> positions)
+    {
+        submesh.meshletOffset = static_cast<uint32>(meshlets.Size());
+
+        // Each vertex's index in the current meshlet, 0xFF when it isn't in it
+        DynamicArray<uint8> local(GetTaggedAllocator(MemoryTag::Asset));
+        local.ResizeUninitialized(positions.Size());
+        std::memset(local.Data(), 0xFF, local.Size());
+
+        CookedMeshlet current = {};
+        current.vertexOffset = static_cast<uint32>(meshletVertices.Size());
+        current.triangleOffset = static_cast<uint32>(meshletTriangles.Size() / 3);
+
+        auto finish = [&]() {
+            const uint32* vertexIndices = meshletVertices.Data() + current.vertexOffset;
+            Aabb box = EmptyAabb();
+            for (uint32 i = 0; i < current.vertexCount; ++i)
+            {
+                const float3& p = positions[vertexIndices[i]];
+                box = Merge(box, Aabb{p, p});
+                local[vertexIndices[i]] = 0xFF;
+            }
+            current.bounds = SphereFromAabb(box);
+            ComputeNormalCone(current, vertexIndices, positions);
+            meshlets.PushBack(current);
+
+            current = {};
+            current.vertexOffset = static_cast<uint32>(meshletVertices.Size());
+            current.triangleOffset = static_cast<uint32>(meshletTriangles.Size() / 3);
+        };
+
+        for (uint64 t = 0; t + 2 < triangles.Size(); t += 3)
+        {
+            const uint32 a = triangles[t];
+            const uint32 b = triangles[t + 1];
+            const uint32 c = triangles[t + 2];
+            const uint32 added = (local[a] == 0xFF ? 1 : 0) +
+                                 (local[b] == 0xFF && b != a ? 1 : 0) +
+                                 (local[c] == 0xFF && c != a && c != b ? 1 : 0);
+            if (current.vertexCount + added > options.maxMeshletVertices ||
+                current.triangleCount + 1 > options.maxMeshletTriangles)
+            {
+                finish();
+            }
+
+            for (const uint32 vertex : {a, b, c})
+            {
+                if (local[vertex] == 0xFF)
+                {
+                    local[vertex] = static_cast<uint8>(current.vertexCount++);
+                    meshletVertices.PushBack(vertex);
+                }
+                meshletTriangles.PushBack(local[vertex]);
+            }
+            ++current.triangleCount;
+        }
+        if (current.triangleCount > 0)
+        {
+            finish();
+        }
+
+        submesh.meshletCount = static_cast<uint32>(meshlets.Size()) - submesh.meshletOffset;
+    }
+
+    // Every level is simplified from the full detail triangles rather than the level before, so
+    // errors don't pile up. The triangles have to be in Indices already, they're lod 0.
+    void BuildLods(CookedSubmesh& submesh,
+                   ArrayView<const uint32> triangles,
+                   ArrayView<const float3> positions)
+    {
+        submesh.lodOffset = static_cast<uint32>(lods.Size());
+        lods.PushBack(CookedLod{submesh.indexOffset, submesh.indexCount, 0.0f});
+
+        const float3 extent(submesh.bounds.max.x - submesh.bounds.min.x,
+                            submesh.bounds.max.y - submesh.bounds.min.y,
+                            submesh.bounds.max.z - submesh.bounds.min.z);
+        const float max_error = options.maxLodError * std::sqrt(extent.x * extent.x +
+                                                                extent.y * extent.y +
+                                                                extent.z * extent.z);
+
+        DynamicArray<uint32> simplified(GetTaggedAllocator(MemoryTag::Asset));
+        simplified.ResizeUninitialized(triangles.Size());
+        uint64 previous = triangles.Size();
+        float ratio = 1.0f;
+        for (uint32 level = 1; level < options.maxLodCount; ++level)
+        {
+            ratio *= options.lodTriangleRatio;
+            const uint64 target = uint64(double(triangles.Size() / 3) * ratio) * 3;
+            float error = 0.0f;
+            const uint64 count =
+                SimplifyMesh(simplified, triangles, positions, target, max_error, &error);
+            // Barely any fewer triangles isn't worth a level, and means the error limit is near
+            if (count == 0 || count * 10 > previous * 9)
+            {
+                break;
+            }
+            const ArrayView<uint32> level_indices(simplified.Data(), count);
+            OptimizeVertexCache(level_indices, positions.Size());
+
+            lods.PushBack(
+                CookedLod{static_cast<uint32>(indices.Size()), static_cast<uint32>(count), error});
+            indices.Append(level_indices.Data(), count);
+            ++stats.lodLevels;
+            stats.lodTriangles += count / 3;
+            previous = count;
+        }
+
+        submesh.lodCount = static_cast<uint32>(lods.Size()) - submesh.lodOffset;
+    }
+};
+
+Result<UniquePtr<MeshCooker>> MeshCooker::Create(const MeshCookerOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (options.maxMeshletVertices < 3 || options.maxMeshletVertices > 255 ||
+        options.maxMeshletTriangles == 0)
+    {
+        return {ErrorCategory::InvalidArgument,
+                "Meshlets need 3 to 255 vertices and at least one triangle"};
+    }
+    if (!(options.overdrawThreshold >= 1.0f))
+    {
+        return {ErrorCategory::InvalidArgument, "The overdraw threshold can't be below 1"};
+    }
+    if (options.maxLodCount == 0 || options.maxLodCount > kMaxLodCount ||
+        !(options.lodTriangleRatio > 0.0f && options.lodTriangleRatio < 1.0f) ||
+        !(options.maxLodError >= 0.0f))
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "Lods need a count of 1 to %u, a triangle ratio between 0 and 1 and "
+                             "an error that isn't negative",
+                             kMaxLodCount);
+    }
+
+    UniquePtr<MeshCooker> cooker(new MeshCooker());
+    cooker->m_state = new State();
+    cooker->m_state->options = options;
+    return rsblMove(cooker);
+}
+
+MeshCooker::~MeshCooker()
+{
+    delete m_state;
+}
+
+uint32 MeshCooker::BeginMesh()
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    CookedMeshRange mesh = {};
+    mesh.submeshOffset = static_cast<uint32>(m_state->submeshes.Size());
+    m_state->meshes.PushBack(mesh);
+    return static_cast<uint32>(m_state->meshes.Size() - 1);
+}
+
+Result<> MeshCooker::AddPrimitive(const MeshPrimitiveInput& primitive)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+
+    rsblAssertMsg(!state->meshes.IsEmpty(), "AddPrimitive before BeginMesh");
+
+    const uint64 vertex_count = primitive.positions.Size();
+    if ((!primitive.normals.IsEmpty() && primitive.normals.Size() != vertex_count) ||
+        (!primitive.tangents.IsEmpty() && primitive.tangents.Size() != vertex_count) ||
+        (!primitive.uvs.IsEmpty() && primitive.uvs.Size() != vertex_count))
+    {
+        return {ErrorCategory::InvalidArgument, "Vertex attributes don't match the positions"};
+    }
+    if (vertex_count > ~0u)
+    {
+        return {ErrorCategory::InvalidArgument, "Too many vertices in one primitive"};
+    }
+
+    // Unindexed primitives get the obvious indices, so everything after has one path
+    DynamicArray<uint32> generated(GetTaggedAllocator(MemoryTag::Asset));
+    ArrayView<const uint32> triangles = primitive.indices;
+    if (triangles.IsEmpty())
+    {
+        generated.ResizeUninitialized(vertex_count);
+        for (uint64 i = 0; i < vertex_count; ++i)
+        {
+            generated[i] = static_cast<uint32>(i);
+        }
+        triangles = generated;
+    }
+    if (triangles.Size() % 3 != 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Index count isn't a whole number of triangles"};
+    }
+    for (const uint32 index : triangles)
+    {
+        if (index >= vertex_count)
+        {
+            return FailureFormat(ErrorCategory::InvalidArgument,
+                                 "Index %u out of range of %llu vertices",
+                                 index,
+                                 static_cast<unsigned long long>(vertex_count));
+        }
+    }
+
+    // Area weighted, the cross product's length is twice the triangle's area
+    DynamicArray<float3> smoothed(GetTaggedAllocator(MemoryTag::Asset));
+    ArrayView<const float3> normals = primitive.normals;
+    if (normals.IsEmpty())
+    {
+        smoothed.Resize(vertex_count);
+        for (float3& normal : smoothed)
+        {
+            normal = float3(0.0f);
+        }
+        for (uint64 t = 0; t < triangles.Size(); t += 3)
+        {
+            const simd::float4 a = simd::Load(primitive.positions[triangles[t]]);
+            const simd::float4 b = simd::Load(primitive.positions[triangles[t + 1]]);
+            const simd::float4 c = simd::Load(primitive.positions[triangles[t + 2]]);
+            const simd::float4 face = simd::Cross3(b - a, c - a);
+            for (uint64 corner = 0; corner < 3; ++corner)
+            {
+                float3& normal = smoothed[triangles[t + corner]];
+                normal = simd::ToFloat3(simd::Load(normal) + face);
+            }
+        }
+        normals = smoothed;
+    }
+
+    CookedSubmesh submesh = {};
+    submesh.indexOffset = static_cast<uint32>(state->indices.Size());
+    submesh.indexCount = static_cast<uint32>(triangles.Size());
+    submesh.material = primitive.material;
+    submesh.bounds = AabbFromPoints(primitive.positions);
+
+    const float3 min = submesh.bounds.min;
+    const float3 extent(submesh.bounds.max.x - min.x,
+                        submesh.bounds.max.y - min.y,
+                        submesh.bounds.max.z - min.z);
+
+    DynamicArray<CookedVertex> cooked(GetTaggedAllocator(MemoryTag::Asset));
+    cooked.ResizeUninitialized(vertex_count);
+    for (uint64 i = 0; i < vertex_count; ++i)
+    {
+        const float3& position = primitive.positions[i];
+        CookedVertex vertex = {};
+        vertex.position[0] = QuantizeCoordinate(position.x, min.x, extent.x);
+        vertex.position[1] = QuantizeCoordinate(position.y, min.y, extent.y);
+        vertex.position[2] = QuantizeCoordinate(position.z, min.z, extent.z);
+
+        // Degenerate triangles leave their vertices without a direction, any will do for them
+        simd::float4 normal = simd::Load(normals[i]);
+        const float length = simd::Length3(normal);
+        normal = length > 0.0f ? normal / length : simd::float4(0.0f, 0.0f, 1.0f, 0.0f);
+
+        float3 tangent;
+        float handedness = 1.0f;
+        if (!primitive.tangents.IsEmpty())
+        {
+            const float4& t = primitive.tangents[i];
+            tangent = float3(t.x, t.y, t.z);
+            handedness = t.w;
+            // A tangent along the normal has nothing left once made orthogonal to it
+            const simd::float4 tv = simd::Load(tangent);
+            const simd::float4 rest = tv - normal * simd::Dot3(normal, tv);
+            if (simd::Length3(rest) < 1e-6f)
+            {
+                tangent = simd::ToFloat3(AnyPerpendicular(normal));
+            }
+        }
+        else
+        {
+            tangent = simd::ToFloat3(AnyPerpendicular(normal));
+        }
+
+        const uint64 qtangent =
+            PackQTangent16(QTangentFromFrame(simd::ToFloat3(normal), tangent, handedness));
+        std::memcpy(vertex.qtangent, &qtangent, sizeof(vertex.qtangent));
+
+        if (!primitive.uvs.IsEmpty())
+        {
+            vertex.uv[0] = FloatToHalf(primitive.uvs[i].x);
+            vertex.uv[1] = FloatToHalf(primitive.uvs[i].y);
+        }
+        cooked[i] = vertex;
+    }
+
+    // Vertices that quantized to the same bytes become one, then the triangles are reordered for
+    // the vertex cache and overdraw, then the vertices for the order the triangles fetch them
+    DynamicArray<uint32> indices(GetTaggedAllocator(MemoryTag::Asset));
+    indices.Append(triangles.Data(), triangles.Size());
+    const VertexCacheStats before = AnalyzeVertexCache(indices, vertex_count);
+
+    DynamicArray<uint32> remap(GetTaggedAllocator(MemoryTag::Asset));
+    remap.ResizeUninitialized(vertex_count);
+    const ByteView cooked_bytes(reinterpret_cast<const uint8*>(cooked.Data()),
+                                cooked.Size() * sizeof(CookedVertex));
+    const uint32 unique = DeduplicateVertices(remap, cooked_bytes, sizeof(CookedVertex));
+    RemapIndices(indices, remap);
+    DynamicArray<float3> positions(GetTaggedAllocator(MemoryTag::Asset));
+    positions.ResizeUninitialized(unique);
+    RemapVertices<float3>(positions, primitive.positions, remap);
+
+    OptimizeVertexCache(indices, unique);
+    OptimizeOverdraw(indices, positions, state->options.overdrawThreshold);
+
+    DynamicArray<uint32> fetch(GetTaggedAllocator(MemoryTag::Asset));
+    fetch.ResizeUninitialized(unique);
+    const uint32 used = OptimizeVertexFetch(fetch, indices);
+    RemapIndices(indices, fetch);
+    for (uint32& entry : remap)
+    {
+        entry = fetch[entry];
+    }
+
+    submesh.vertexOffset = static_cast<uint32>(state->vertices.Size());
+    submesh.vertexCount = used;
+    state->vertices.ResizeUninitialized(state->vertices.Size() + used);
+    RemapVertices<CookedVertex>(
+        ArrayView<CookedVertex>(state->vertices.Data() + submesh.vertexOffset, used),
+        cooked,
+        remap);
+    positions.ResizeUninitialized(used);
+    RemapVertices<float3>(positions, primitive.positions, remap);
+
+    MeshCookerStats& stats = state->stats;
+    stats.before += before;
+    stats.after += AnalyzeVertexCache(indices, used);
+    stats.duplicateVertices += vertex_count - unique;
+    stats.unusedVertices += unique - used;
+
+    state->indices.Append(indices.Data(), indices.Size());
+    state->BuildMeshlets(submesh, indices, positions);
+    state->BuildLods(submesh, indices, positions);
+
+    state->submeshes.PushBack(submesh);
+    ++state->meshes[state->meshes.Size() - 1].submeshCount;
+    return ResultCode::Success;
+}
+
+Result<uint32> MeshCooker::AddNode(const MeshNodeInput& node)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+
+    const uint64 index = state->nodes.Size();
+    if (node.parent >= 0 && static_cast<uint64>(node.parent) >= index)
+    {
+        return {ErrorCategory::InvalidArgument, "A node's parent has to be added before it"};
+    }
+    if (node.mesh >= 0 && static_cast<uint64>(node.mesh) >= state->meshes.Size())
+    {
+        return {ErrorCategory::InvalidArgument, "Node refers to a mesh that wasn't added"};
+    }
+
+    CookedNode cooked = {};
+    cooked.translation = node.translation;
+    cooked.rotation = node.rotation;
+    cooked.scale = node.scale;
+    cooked.parent = node.parent;
+    cooked.mesh = node.mesh;
+    state->nodes.PushBack(cooked);
+    return static_cast<uint32>(index);
+}
+
+const MeshCookerStats& MeshCooker::Stats() const
+{
+    return m_state->stats;
+}
+
+Result<> MeshCooker::Write(const char* path, const CookedMeshSource& source) const
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    const State* state = m_state;
+
+    const ByteView sections[kSectionCount] = {
+        AsBytes(ArrayView<const CookedVertex>(state->vertices)),
+        AsBytes(ArrayView<const uint32>(state->indices)),
+        AsBytes(ArrayView<const CookedMeshlet>(state->meshlets)),
+        AsBytes(ArrayView<const uint32>(state->meshletVertices)),
+        AsBytes(ArrayView<const uint8>(state->meshletTriangles)),
+        AsBytes(ArrayView<const CookedSubmesh>(state->submeshes)),
+        AsBytes(ArrayView<const CookedMeshRange>(state->meshes)),
+        AsBytes(ArrayView<const CookedNode>(state->nodes)),
+        AsBytes(ArrayView<const CookedLod>(state->lods)),
+    };
+
+    CookedMeshHeader header = {};
+    header.magic = kCookedMeshMagic;
+    header.version = kCookedMeshVersion;
+    header.sourceModifiedTime = source.modifiedTime;
+    header.sourceSize = source.size;
+
+    // Header, then each section after the padding that aligns it, all in one gathered write
+    static const uint8 kZeros[kSectionAlignment] = {};
+    ByteView parts[1 + 2 * kSectionCount];
+    uint32 part_count = 0;
+    parts[part_count++] = AsBytes(&header, sizeof(header));
+
+    uint64 position = sizeof(header);
+    for (uint32 i = 0; i < kSectionCount; ++i)
+    {
+        const uint64 padding = AlignUp(position, kSectionAlignment) - position;
+        if (padding > 0)
+        {
+            parts[part_count++] = AsBytes(kZeros, padding);
+            position += padding;
+        }
+        header.sections[i].offset = position;
+        header.sections[i].size = sections[i].Size();
+        if (!sections[i].IsEmpty())
+        {
+            parts[part_count++] = sections[i];
+        }
+        position += sections[i].Size();
+    }
+
+    Result<FileHandle> file = OpenFile(path, FileOpenMode::Write);
+    if (!file)
+    {
+        return PendingFailure{file.Category()};
+    }
+
+    Result<uint64> written =
+        WriteFileGather(file.Value(), ArrayView<const ByteView>(parts, part_count));
+    const Result<> closed = CloseFile(file.Value());
+    if (!written)
+    {
+        return PendingFailure{written.Category()};
+    }
+    if (written.Value() != position)
+    {
+        return {ErrorCategory::Io, "Short write of cooked mesh"};
+    }
+    return closed;
+}
+
+struct CookedMesh::State
+{
+    MappedFile mapped;
+    CookedMeshHeader header;
+};
+
+Result<UniquePtr<CookedMesh>> CookedMesh::Open(const char* path)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    Result<MappedFile> mapped = MapFile(path);
+    if (!mapped)
+    {
+        return PendingFailure{mapped.Category()};
+    }
+
+    const ByteView bytes = mapped.Value().View();
+    if (bytes.Size() < sizeof(CookedMeshHeader))
+    {
+        return {ErrorCategory::InvalidArgument, "Too small to be a cooked mesh"};
+    }
+
+    CookedMeshHeader header;
+    std::memcpy(&header, bytes.Data(), sizeof(header));
+    if (header.magic != kCookedMeshMagic)
+    {
+        return {ErrorCategory::InvalidArgument, "Not a cooked mesh"};
+    }
+    if (header.version != kCookedMeshVersion)
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "Cooked mesh version %u, expected %u",
+                             header.version,
+                             kCookedMeshVersion);
+    }
+    for (uint32 i = 0; i < kSectionCount; ++i)
+    {
+        const SectionRange& section = header.sections[i];
+        if (section.offset % kSectionAlignment != 0 || section.offset > bytes.Size() ||
+            section.size > bytes.Size() - section.offset || section.size % kElementSizes[i] != 0)
+        {
+            return {ErrorCategory::InvalidArgument, "Cooked mesh sections are corrupt"};
+        }
+    }
+
+    UniquePtr<CookedMesh> mesh(new CookedMesh());
+    mesh->m_state = new State();
+    mesh->m_state->mapped = rsblMove(mapped.Value());
+    mesh->m_state->header = header;
+
+    // The tables are small, checking them here means walking them later can't go out of bounds
+    const uint64 vertex_count = mesh->Vertices().Size();
+    const uint64 index_count = mesh->Indices().Size();
+    const uint64 meshlet_count = mesh->Meshlets().Size();
+    const uint64 lod_count = mesh->Lods().Size();
+    for (const CookedSubmesh& submesh : mesh->Submeshes())
+    {
+        if (uint64(submesh.vertexOffset) + submesh.vertexCount > vertex_count ||
+            uint64(submesh.indexOffset) + submesh.indexCount > index_count ||
+            uint64(submesh.meshletOffset) + submesh.meshletCount > meshlet_count ||
+            uint64(submesh.lodOffset) + submesh.lodCount > lod_count ||
+            submesh.lodCount == 0 || submesh.lodCount > kMaxLodCount)
+        {
+            return {ErrorCategory::InvalidArgument, "Cooked mesh submesh table is corrupt"};
+        }
+    }
+    for (const CookedLod& lod : mesh->Lods())
+    {
+        if (uint64(lod.indexOffset) + lod.indexCount > index_count)
+        {
+            return {ErrorCategory::InvalidArgument, "Cooked mesh lod table is corrupt"};
+        }
+    }
+    const uint64 submesh_count = mesh->Submeshes().Size();
+    for (const CookedMeshRange& range : mesh->Meshes())
+    {
+        if (uint64(range.submeshOffset) + range.submeshCount > submesh_count)
+        {
+            return {ErrorCategory::InvalidArgument, "Cooked mesh mesh table is corrupt"};
+        }
+    }
+    const ArrayView<const CookedNode> nodes = mesh->Nodes();
+    for (uint64 i = 0; i < nodes.Size(); ++i)
+    {
+        if ((nodes[i].parent >= 0 && static_cast<uint64>(nodes[i].parent) >= i) ||
+            (nodes[i].mesh >= 0 && static_cast<uint64>(nodes[i].mesh) >= mesh->Meshes().Size()))
+        {
+            return {ErrorCategory::InvalidArgument, "Cooked mesh node table is corrupt"};
+        }
+    }
+
+    return rsblMove(mesh);
+}
+
+uint32 SelectLod(ArrayView<const CookedLod> lods,
+                 const Sphere& bounds,
+                 float scale,
+                 const LodSelection& selection)
+{
+    const float dx = bounds.center.x - selection.cameraPosition.x;
+    const float dy = bounds.center.y - selection.cameraPosition.y;
+    const float dz = bounds.center.z - selection.cameraPosition.z;
+    const float distance = std::sqrt(dx * dx + dy * dy + dz * dz) - bounds.radius;
+    if (!(distance > 0.0f))
+    {
+        return 0;
+    }
+
+    // error * scale * projectionScale / distance <= maxPixelError, rearranged so the loop
+    // compares errors only
+    const float max_error = selection.maxPixelError * distance /
+                            (scale * selection.projectionScale);
+    uint32 level = 0;
+    for (uint32 i = 1; i < lods.Size(); ++i)
+    {
+        if (lods[i].error > max_error)
+        {
+            break;
+        }
+        level = i;
+    }
+    return level;
+}
+
+void SelectLods(ArrayView<uint8> levels,
+                ArrayView<const CookedLod> lods,
+                ArrayView<const Sphere> bounds,
+                ArrayView<const float> scales,
+                const LodSelection& selection)
+{
+    rsblAssert(levels.Size() == bounds.Size() && scales.Size() == bounds.Size());
+    for (uint64 i = 0; i < bounds.Size(); ++i)
+    {
+        levels[i] = static_cast<uint8>(SelectLod(lods, bounds[i], scales[i], selection));
+    }
+}
+
+CookedMesh::~CookedMesh()
+{
+    delete m_state;
+}
+
+ByteView CookedMesh::Section(CookedMeshSection section) const
+{
+    const SectionRange& range = m_state->header.sections[static_cast<uint32>(section)];
+    return m_state->mapped.View().Subview(range.offset, range.size);
+}
+
+namespace
+{
+template <typename T>
+ArrayView<const T> SectionAs(ByteView bytes)
+{
+    return ArrayView<const T>(reinterpret_cast<const T*>(bytes.Data()), bytes.Size() / sizeof(T));
+}
+} // namespace
+
+ArrayView<const CookedVertex> CookedMesh::Vertices() const
+{
+    return SectionAs<CookedVertex>(Section(CookedMeshSection::Vertices));
+}
+
+ArrayView<const uint32> CookedMesh::Indices() const
+{
+    return SectionAs<uint32>(Section(CookedMeshSection::Indices));
+}
+
+ArrayView<const CookedMeshlet> CookedMesh::Meshlets() const
+{
+    return SectionAs<CookedMeshlet>(Section(CookedMeshSection::Meshlets));
+}
+
+ArrayView<const uint32> CookedMesh::MeshletVertices() const
+{
+    return SectionAs<uint32>(Section(CookedMeshSection::MeshletVertices));
+}
+
+ArrayView<const uint8> CookedMesh::MeshletTriangles() const
+{
+    return Section(CookedMeshSection::MeshletTriangles);
+}
+
+ArrayView<const CookedSubmesh> CookedMesh::Submeshes() const
+{
+    return SectionAs<CookedSubmesh>(Section(CookedMeshSection::Submeshes));
+}
+
+ArrayView<const CookedMeshRange> CookedMesh::Meshes() const
+{
+    return SectionAs<CookedMeshRange>(Section(CookedMeshSection::Meshes));
+}
+
+ArrayView<const CookedNode> CookedMesh::Nodes() const
+{
+    return SectionAs<CookedNode>(Section(CookedMeshSection::Nodes));
+}
+
+ArrayView<const CookedLod> CookedMesh::Lods() const
+{
+    return SectionAs<CookedLod>(Section(CookedMeshSection::Lods));
+}
+
+bool CookedMesh::MatchesSource(const FileInfo& source) const
+{
+    return m_state->header.sourceModifiedTime == source.modifiedTime &&
+           m_state->header.sourceSize == source.size;
+}
+
+void CookedMesh::Prefetch() const
+{
+    m_state->mapped.Prefetch();
+}
+
+void CookedMesh::PrefetchCoarsestLods() const
+{
+    const State* state = m_state;
+    const SectionRange& vertices =
+        state->header.sections[static_cast<uint32>(CookedMeshSection::Vertices)];
+    state->mapped.Prefetch(vertices.offset, vertices.size);
+
+    // Each submesh's lods follow its full detail indices, so these are one range per submesh,
+    // merged where one submesh's coarsest lod ends where the next one's starts
+    const uint64 indices =
+        state->header.sections[static_cast<uint32>(CookedMeshSection::Indices)].offset;
+    const ArrayView<const CookedLod> lods = Lods();
+    uint64 start = 0;
+    uint64 end = 0;
+    for (const CookedSubmesh& submesh : Submeshes())
+    {
+        const CookedLod& coarsest = lods[submesh.lodOffset + submesh.lodCount - 1];
+        const uint64 lod_start = indices + uint64(coarsest.indexOffset) * sizeof(uint32);
+        const uint64 lod_end = lod_start + uint64(coarsest.indexCount) * sizeof(uint32);
+        if (lod_start != end)
+        {
+            if (end > start)
+            {
+                state->mapped.Prefetch(start, end - start);
+            }
+            start = lod_start;
+        }
+        end = lod_end;
+    }
+    if (end > start)
+    {
+        state->mapped.Prefetch(start, end - start);
+    }
+}
+
+} // namespace rsbl
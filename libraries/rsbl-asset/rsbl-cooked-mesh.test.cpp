@@ -0,0 +1,460 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-cooked-mesh.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-file.h>
+#include <rsbl-packing.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kMeshPath = "rsbl-cooked-mesh-test.rmesh";
+
+// A size x size grid of quads in the xz plane, two triangles each
+struct Grid
+{
+    DynamicArray<float3> positions;
+    DynamicArray<float2> uvs;
+    DynamicArray<uint32> indices;
+
+    explicit Grid(uint32 size)
+    {
+        for (uint32 z = 0; z <= size; ++z)
+        {
+            for (uint32 x = 0; x <= size; ++x)
+            {
+                positions.PushBack(float3(float(x), 0.0f, float(z)));
+                uvs.PushBack(float2(float(x) / float(size), float(z) / float(size)));
+            }
+        }
+        for (uint32 z = 0; z < size; ++z)
+        {
+            for (uint32 x = 0; x < size; ++x)
+            {
+                const uint32 corner = z * (size + 1) + x;
+                const uint32 quad[6] = {corner,
+                                        corner + size + 1,
+                                        corner + 1,
+                                        corner + 1,
+                                        corner + size + 1,
+                                        corner + size + 2};
+                indices.Append(quad, 6);
+            }
+        }
+    }
+
+    MeshPrimitiveInput Input() const
+    {
+        MeshPrimitiveInput input;
+        input.positions = positions;
+        input.uvs = uvs;
+        input.indices = indices;
+        return input;
+    }
+};
+
+float Dequantize(uint16 value, float min, float max)
+{
+    return min + UnpackUnorm16(value) * (max - min);
+}
+} // namespace
+
+TEST_SUITE("rsbl::CookedMesh")
+{
+    TEST_CASE("Cook and map a small scene")
+    {
+        {
+            Result<UniquePtr<MeshCooker>> cooker = MeshCooker::Create();
+            REQUIRE(cooker);
+
+            Grid grid(1);
+            CHECK(cooker.Value()->BeginMesh() == 0);
+            MeshPrimitiveInput input = grid.Input();
+            input.material = 3;
+            REQUIRE(cooker.Value()->AddPrimitive(input));
+
+            MeshNodeInput root;
+            root.translation = float3(1.0f, 2.0f, 3.0f);
+            Result<uint32> root_index = cooker.Value()->AddNode(root);
+            REQUIRE(root_index);
+            MeshNodeInput child;
+            child.parent = static_cast<int32>(root_index.Value());
+            child.mesh = 0;
+            REQUIRE(cooker.Value()->AddNode(child));
+
+            REQUIRE(cooker.Value()->Write(kMeshPath, {1234, 5678}));
+        }
+
+        Result<UniquePtr<CookedMesh>> opened = CookedMesh::Open(kMeshPath);
+        REQUIRE(opened);
+        const CookedMesh& mesh = *opened.Value();
+
+        REQUIRE(mesh.Meshes().Size() == 1);
+        CHECK(mesh.Meshes()[0].submeshCount == 1);
+        REQUIRE(mesh.Submeshes().Size() == 1);
+        const CookedSubmesh& submesh = mesh.Submeshes()[0];
+        CHECK(submesh.vertexCount == 4);
+        CHECK(submesh.indexCount == 6);
+        CHECK(submesh.meshletCount == 1);
+        CHECK(submesh.material == 3);
+        // Two triangles, all border, nothing to simplify
+        REQUIRE(submesh.lodCount == 1);
+        CHECK(mesh.Lods()[submesh.lodOffset].indexCount == 6);
+        CHECK(submesh.bounds.max.x == 1.0f);
+        CHECK(submesh.bounds.max.z == 1.0f);
+
+        // Positions come back through the bounds, the up facing normals through the QTangent.
+        // Vertices are reordered, so the far corner is found by its position.
+        const CookedVertex* far_corner = nullptr;
+        for (const CookedVertex& vertex : mesh.Vertices())
+        {
+            if (vertex.position[0] == 0xFFFF && vertex.position[2] == 0xFFFF)
+            {
+                far_corner = &vertex;
+            }
+        }
+        REQUIRE(far_corner != nullptr);
+        const CookedVertex& corner = *far_corner;
+        CHECK(Dequantize(corner.position[0], submesh.bounds.min.x, submesh.bounds.max.x) ==
+              doctest::Approx(1.0f));
+        CHECK(Dequantize(corner.position[2], submesh.bounds.min.z, submesh.bounds.max.z) ==
+              doctest::Approx(1.0f));
+        CHECK(HalfToFloat(corner.uv[0]) == 1.0f);
+
+        uint64 packed = 0;
+        std::memcpy(&packed, corner.qtangent, sizeof(packed));
+        float3 normal;
+        float3 tangent;
+        float handedness = 0.0f;
+        QTangentToFrame(UnpackQTangent16(packed), normal, tangent, handedness);
+        CHECK(std::abs(normal.y) == doctest::Approx(1.0f).epsilon(0.001));
+
+        REQUIRE(mesh.Nodes().Size() == 2);
+        CHECK(mesh.Nodes()[0].parent == -1);
+        CHECK(mesh.Nodes()[0].translation.y == 2.0f);
+        CHECK(mesh.Nodes()[1].parent == 0);
+        CHECK(mesh.Nodes()[1].mesh == 0);
+
+        FileInfo source;
+        source.modifiedTime = 1234;
+        source.size = 5678;
+        CHECK(mesh.MatchesSource(source));
+        source.size = 5679;
+        CHECK(!mesh.MatchesSource(source));
+
+        // Sections start aligned in the mapping, ready to be copied from
+        CHECK(reinterpret_cast<uintptr_t>(mesh.Section(CookedMeshSection::Vertices).Data()) % 16 ==
+              0);
+        CHECK(mesh.Section(CookedMeshSection::Indices).Size() == 6 * sizeof(uint32));
+
+        opened.Value().Reset();
+        std::remove(kMeshPath);
+    }
+
+    TEST_CASE("Meshlets cover every triangle within the limits")
+    {
+        MeshCookerOptions options;
+        options.maxMeshletVertices = 64;
+        options.maxMeshletTriangles = 124;
+        Grid grid(40);
+        {
+            Result<UniquePtr<MeshCooker>> cooker = MeshCooker::Create(options);
+            REQUIRE(cooker);
+            cooker.Value()->BeginMesh();
+            REQUIRE(cooker.Value()->AddPrimitive(grid.Input()));
+            REQUIRE(cooker.Value()->Write(kMeshPath));
+        }
+
+        Result<UniquePtr<CookedMesh>> opened = CookedMesh::Open(kMeshPath);
+        REQUIRE(opened);
+        const CookedMesh& mesh = *opened.Value();
+        const CookedSubmesh& submesh = mesh.Submeshes()[0];
+        CHECK(submesh.meshletCount > 1);
+
+        // Meshlets in order give back the index buffer triangle for triangle
+        uint64 triangle = 0;
+        for (uint32 m = 0; m < submesh.meshletCount; ++m)
+        {
+            const CookedMeshlet& meshlet = mesh.Meshlets()[submesh.meshletOffset + m];
+            CHECK(meshlet.vertexCount <= options.maxMeshletVertices);
+            CHECK(meshlet.triangleCount <= options.maxMeshletTriangles);
+            for (uint32 t = 0; t < meshlet.triangleCount; ++t, ++triangle)
+            {
+                for (uint32 corner = 0; corner < 3; ++corner)
+                {
+                    const uint8 local = mesh.MeshletTriangles()[(meshlet.triangleOffset + t) * 3 +
+                                                                corner];
+                    REQUIRE(local < meshlet.vertexCount);
+                    const uint32 vertex = mesh.MeshletVertices()[meshlet.vertexOffset + local];
+                    CHECK(vertex == mesh.Indices()[submesh.indexOffset + triangle * 3 + corner]);
+
+                    // Every vertex is inside its meshlet's bounds, give or take quantization
+                    const CookedVertex& cooked = mesh.Vertices()[submesh.vertexOffset + vertex];
+                    const Aabb& box = submesh.bounds;
+                    const float dx = Dequantize(cooked.position[0], box.min.x, box.max.x) -
+                                     meshlet.bounds.center.x;
+                    const float dy = Dequantize(cooked.position[1], box.min.y, box.max.y) -
+                                     meshlet.bounds.center.y;
+                    const float dz = Dequantize(cooked.position[2], box.min.z, box.max.z) -
+                                     meshlet.bounds.center.z;
+                    CHECK(std::sqrt(dx * dx + dy * dy + dz * dz) <= meshlet.bounds.radius + 1e-2f);
+                }
+            }
+        }
+        CHECK(triangle * 3 == submesh.indexCount);
+
+        opened.Value().Reset();
+        std::remove(kMeshPath);
+    }
+
+    TEST_CASE("Meshlet normal cones")
+    {
+        // A flat grid facing +y, and a box whose meshlets wrap around corners
+        Grid grid(4);
+        const float3 cube_positions[8] = {
+            {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}, {0, 0, 1}, {1, 0, 1}, {0, 1, 1}, {1, 1, 1}};
+        const uint32 cube_indices[36] = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4,
+                                         2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+        {
+            Result<UniquePtr<MeshCooker>> cooker = MeshCooker::Create();
+            REQUIRE(cooker);
+            cooker.Value()->BeginMesh();
+            REQUIRE(cooker.Value()->AddPrimitive(grid.Input()));
+            MeshPrimitiveInput cube;
+            cube.positions = cube_positions;
+            cube.indices = cube_indices;
+            REQUIRE(cooker.Value()->AddPrimitive(cube));
+            REQUIRE(cooker.Value()->Write(kMeshPath));
+        }
+
+        Result<UniquePtr<CookedMesh>> opened = CookedMesh::Open(kMeshPath);
+        REQUIRE(opened);
+        const CookedMesh& mesh = *opened.Value();
+        REQUIRE(mesh.Submeshes().Size() == 2);
+
+        const CookedMeshlet& flat = mesh.Meshlets()[mesh.Submeshes()[0].meshletOffset];
+        CHECK(flat.coneAxis.y == doctest::Approx(1.0f));
+        CHECK(flat.coneCutoff == doctest::Approx(0.0f).epsilon(1e-3));
+        CHECK(IsMeshletBackfacing(flat, float3(2.0f, -10.0f, 2.0f)));
+        CHECK(!IsMeshletBackfacing(flat, float3(2.0f, 10.0f, 2.0f)));
+        // Edge on, some of it could still be seen
+        CHECK(!IsMeshletBackfacing(flat, float3(20.0f, -0.1f, 2.0f)));
+
+        // Every direction is in there, nothing can cull it
+        const CookedMeshlet& closed = mesh.Meshlets()[mesh.Submeshes()[1].meshletOffset];
+        CHECK(closed.coneCutoff == 1.0f);
+        for (const float3& camera : {float3(5, 0, 0), float3(0, -5, 0), float3(0.5f, 0.5f, 9)})
+        {
+            CHECK(!IsMeshletBackfacing(closed, camera));
+        }
+
+        opened.Value().Reset();
+        std::remove(kMeshPath);
+    }
+
+    TEST_CASE("Duplicate and unused vertices are dropped, triangles reordered")
+    {
+        // The grid's vertices twice over, the second triangle of every quad using the copies,
+        // and the copies' own unused tail
+        Grid grid(16);
+        const uint64 grid_vertices = grid.positions.Size();
+        for (uint64 i = 0; i < grid_vertices; ++i)
+        {
+            // Copied out first, PushBack can't take a reference into its own array
+            const float3 position = grid.positions[i];
+            const float2 uv = grid.uvs[i];
+            grid.positions.PushBack(position);
+            grid.uvs.PushBack(uv);
+        }
+        for (uint64 t = 3; t < grid.indices.Size(); t += 6)
+        {
+            for (uint64 corner = 0; corner < 3; ++corner)
+            {
+                grid.indices[t + corner] += static_cast<uint32>(grid_vertices);
+            }
+        }
+        grid.positions.PushBack(float3(100.0f, 0.0f, 0.0f));
+        grid.uvs.PushBack(float2(0.0f, 0.0f));
+
+        Result<UniquePtr<MeshCooker>> cooker = MeshCooker::Create();
+        REQUIRE(cooker);
+        cooker.Value()->BeginMesh();
+        REQUIRE(cooker.Value()->AddPrimitive(grid.Input()));
+
+        const MeshCookerStats& stats = cooker.Value()->Stats();
+        CHECK(stats.before.triangles == 16 * 16 * 2);
+        CHECK(stats.after.triangles == 16 * 16 * 2);
+        // The far vertex stretches the bounds, but not enough to merge grid points
+        CHECK(stats.after.vertices == grid_vertices);
+        CHECK(stats.duplicateVertices + stats.unusedVertices == grid_vertices + 1);
+        CHECK(stats.after.transforms < stats.before.transforms);
+        CHECK(stats.after.Acmr() < 1.0f);
+
+        MeshCookerOptions bad;
+        bad.overdrawThreshold = 0.5f;
+        CHECK(!MeshCooker::Create(bad));
+    }
+
+    TEST_CASE("Levels of detail")
+    {
+        // Rolling hills, so the simplification has an error to measure
+        Grid grid(32);
+        for (float3& position : grid.positions)
+        {
+            position.y = std::sin(position.x * 0.3f) * std::cos(position.z * 0.2f);
+        }
+        {
+            Result<UniquePtr<MeshCooker>> cooker = MeshCooker::Create();
+            REQUIRE(cooker);
+            cooker.Value()->BeginMesh();
+            REQUIRE(cooker.Value()->AddPrimitive(grid.Input()));
+            CHECK(cooker.Value()->Stats().lodLevels >= 3);
+            REQUIRE(cooker.Value()->Write(kMeshPath));
+        }
+
+        Result<UniquePtr<CookedMesh>> opened = CookedMesh::Open(kMeshPath);
+        REQUIRE(opened);
+        const CookedMesh& mesh = *opened.Value();
+        const CookedSubmesh& submesh = mesh.Submeshes()[0];
+        REQUIRE(submesh.lodCount >= 4);
+        REQUIRE(submesh.lodCount <= 6);
+        const ArrayView<const CookedLod> lods(mesh.Lods().Data() + submesh.lodOffset,
+                                              submesh.lodCount);
+
+        // The first is the full detail index buffer, each after it has fewer triangles and more
+        // error, all within the default 5% of the diagonal
+        CHECK(lods[0].indexOffset == submesh.indexOffset);
+        CHECK(lods[0].indexCount == submesh.indexCount);
+        CHECK(lods[0].error == 0.0f);
+        const float diagonal = std::sqrt(32.0f * 32.0f * 2.0f + 4.0f);
+        for (uint32 i = 1; i < submesh.lodCount; ++i)
+        {
+            CHECK(lods[i].indexCount % 3 == 0);
+            CHECK(lods[i].indexCount < lods[i - 1].indexCount);
+            CHECK(lods[i].error >= lods[i - 1].error);
+            CHECK(lods[i].error <= 0.05f * diagonal);
+            for (uint32 j = 0; j < lods[i].indexCount; ++j)
+            {
+                CHECK(mesh.Indices()[lods[i].indexOffset + j] < submesh.vertexCount);
+            }
+        }
+        CHECK(lods[submesh.lodCount - 1].error > 0.0f);
+
+        opened.Value().Reset();
+        std::remove(kMeshPath);
+
+        // Turned off, only the full detail is left
+        MeshCookerOptions options;
+        options.maxLodCount = 1;
+        Result<UniquePtr<MeshCooker>> cooker = MeshCooker::Create(options);
+        REQUIRE(cooker);
+        cooker.Value()->BeginMesh();
+        REQUIRE(cooker.Value()->AddPrimitive(grid.Input()));
+        CHECK(cooker.Value()->Stats().lodLevels == 0);
+
+        MeshCookerOptions bad;
+        bad.lodTriangleRatio = 1.0f;
+        CHECK(!MeshCooker::Create(bad));
+        bad = {};
+        bad.maxLodCount = 0;
+        CHECK(!MeshCooker::Create(bad));
+    }
+
+    TEST_CASE("Lods are picked by their error on screen")
+    {
+        const CookedLod lods[4] = {
+            {0, 300, 0.0f}, {300, 150, 0.01f}, {450, 60, 0.1f}, {510, 9, 1.0f}};
+        LodSelection selection;
+        selection.cameraPosition = float3(0.0f);
+        selection.projectionScale = 1000.0f;
+        selection.maxPixelError = 1.0f;
+        const Sphere bounds = {float3(0.0f, 0.0f, 0.0f), 1.0f};
+
+        auto at = [&](float distance, float scale = 1.0f) {
+            Sphere moved = bounds;
+            moved.center.z = distance;
+            return SelectLod(lods, moved, scale, selection);
+        };
+        // 0.01 units at 1000 pixels per unit per unit of distance is a pixel at 10 units from
+        // the nearest point, so 11 from the center
+        CHECK(at(0.5f) == 0);
+        CHECK(at(5.0f) == 0);
+        CHECK(at(11.5f) == 1);
+        CHECK(at(150.0f) == 2);
+        CHECK(at(2000.0f) == 3);
+        // Scaled up, the same error is bigger on screen
+        CHECK(at(150.0f, 10.0f) == 1);
+
+        selection.maxPixelError = 10.0f;
+        CHECK(at(150.0f) == 3);
+
+        uint8 levels[3] = {};
+        Sphere spheres[3] = {bounds, bounds, bounds};
+        spheres[1].center.z = 11.5f;
+        spheres[2].center.z = 2000.0f;
+        const float scales[3] = {1.0f, 10.0f, 1.0f};
+        selection.maxPixelError = 1.0f;
+        SelectLods(levels, lods, spheres, scales, selection);
+        CHECK(levels[0] == 0);
+        CHECK(levels[1] == 0);
+        CHECK(levels[2] == 3);
+    }
+
+    TEST_CASE("Bad input is refused")
+    {
+        Result<UniquePtr<MeshCooker>> cooker = MeshCooker::Create();
+        REQUIRE(cooker);
+        cooker.Value()->BeginMesh();
+
+        const float3 positions[3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+        const uint32 out_of_range[3] = {0, 1, 3};
+        const uint32 partial[2] = {0, 1};
+        const float2 uvs[2] = {};
+
+        MeshPrimitiveInput input;
+        input.positions = positions;
+        input.indices = out_of_range;
+        CHECK(cooker.Value()->AddPrimitive(input).Category() == ErrorCategory::InvalidArgument);
+        input.indices = partial;
+        CHECK(cooker.Value()->AddPrimitive(input).Category() == ErrorCategory::InvalidArgument);
+        input.indices = {};
+        input.uvs = uvs;
+        CHECK(cooker.Value()->AddPrimitive(input).Category() == ErrorCategory::InvalidArgument);
+
+        MeshNodeInput orphan;
+        orphan.parent = 0;
+        CHECK(!cooker.Value()->AddNode(orphan));
+
+        MeshCookerOptions options;
+        options.maxMeshletVertices = 256;
+        CHECK(!MeshCooker::Create(options));
+    }
+
+    TEST_CASE("Files that aren't cooked meshes fail to open")
+    {
+        const char text[] = "definitely not a mesh, but long enough to hold a header of some kind "
+                            "so the magic is what gets checked rather than the size of the file";
+        FILE* file = std::fopen(kMeshPath, "wb");
+        REQUIRE(file != nullptr);
+        std::fwrite(text, 1, sizeof(text), file);
+        std::fclose(file);
+
+        Result<UniquePtr<CookedMesh>> opened = CookedMesh::Open(kMeshPath);
+        CHECK(!opened);
+        CHECK(opened.Category() == ErrorCategory::InvalidArgument);
+        std::remove(kMeshPath);
+
+        CHECK(CookedMesh::Open("rsbl-cooked-mesh-missing.rmesh").Category() ==
+              ErrorCategory::NotFound);
+    }
+}
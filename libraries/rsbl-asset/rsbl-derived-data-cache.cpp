@@ -0,0 +1,328 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-derived-data-cache.h"
+
+#include <rsbl-clock.h>
+#include <rsbl-file.h>
+#include <rsbl-hash.h>
+#include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-thread.h>
+
+#include <atomic>
+
+namespace rsbl
+{
+
+namespace
+{
+// The two halves of a key hash everything with different seeds
+constexpr uint64 kHighSeed = 0x6a09e667f3bcc908ull;
+constexpr uint64 kLowSeed = 0xbb67ae8584caa73bull;
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+void WriteHex(uint64 value, char* out)
+{
+    for (int32 i = 15; i >= 0; --i)
+    {
+        out[i] = kHexDigits[value & 0xf];
+        value >>= 4;
+    }
+}
+
+// <directory>/<first two hex digits>/<all of them>, so no one directory ends up with every
+// artifact in it
+String ArtifactPath(const String& directory, const DerivedDataKey& key)
+{
+    char hex[kDerivedDataKeyHexSize + 1];
+    DerivedDataKeyToHex(key, hex);
+
+    String path(directory.View());
+    path.Append('/');
+    path.Append(StringView(hex, 2));
+    path.Append('/');
+    path.Append(StringView(hex, kDerivedDataKeyHexSize));
+    return path;
+}
+
+// The directory an artifact path sits in
+StringView ParentOf(const String& path)
+{
+    uint64 end = path.Size();
+    while (end > 0 && path[end - 1] != '/')
+    {
+        --end;
+    }
+    return StringView(path.CStr(), end > 0 ? end - 1 : 0);
+}
+} // namespace
+
+void DerivedDataKeyToHex(const DerivedDataKey& key, char (&hex)[kDerivedDataKeyHexSize + 1])
+{
+    WriteHex(key.high, hex);
+    WriteHex(key.low, hex + 16);
+    hex[kDerivedDataKeyHexSize] = '\0';
+}
+
+DerivedDataKeyBuilder::DerivedDataKeyBuilder(StringView cooker, uint32 version)
+{
+    Add(cooker);
+    AddValue(version);
+}
+
+DerivedDataKeyBuilder& DerivedDataKeyBuilder::Add(ByteView bytes)
+{
+    // The size goes in too, so moving bytes from the end of one input to the start of the next
+    // changes the key
+    const uint64 high = HashBytes(bytes.Data(), bytes.Size(), kHighSeed);
+    const uint64 low = HashBytes(bytes.Data(), bytes.Size(), kLowSeed);
+    m_key.high = HashCombine(HashCombine(m_key.high, bytes.Size()), high);
+    m_key.low = HashCombine(HashCombine(m_key.low, bytes.Size()), low);
+    return *this;
+}
+
+DerivedDataKeyBuilder& DerivedDataKeyBuilder::Add(StringView text)
+{
+    return Add(ByteView(reinterpret_cast<const uint8*>(text.Data()), text.Size()));
+}
+
+DerivedDataKey DerivedDataKeyBuilder::Finish() const
+{
+    return m_key;
+}
+
+struct DerivedDataCache::State
+{
+    String localDirectory;
+    String sharedDirectory;
+    bool hasShared = false;
+    bool writeShared = false;
+
+    // Spreads TempPath names, alongside the time and thread, across processes and machines
+    uint64 tempSeed = 0;
+    std::atomic<uint64> tempCounter = 0;
+
+    std::atomic<uint64> localHits = 0;
+    std::atomic<uint64> sharedHits = 0;
+    std::atomic<uint64> misses = 0;
+    std::atomic<uint64> puts = 0;
+    std::atomic<uint64> sharedPutFailures = 0;
+
+    String UniqueSuffix()
+    {
+        uint64 unique = HashCombine(tempSeed, Clock::NowNs());
+        unique = HashCombine(unique, Thread::GetCurrentThreadId());
+        unique = HashCombine(unique, tempCounter.fetch_add(1, std::memory_order_relaxed));
+
+        char hex[17];
+        WriteHex(unique, hex);
+        hex[16] = '\0';
+        String suffix(".");
+        suffix.Append(StringView(hex, 16));
+        suffix.Append(".tmp");
+        return suffix;
+    }
+
+    // Writes next to path under a name nothing else uses, then renames it into place, so readers
+    // only ever see a whole file
+    Result<> WriteWhole(const String& path, ByteView data)
+    {
+        const String parent(ParentOf(path));
+        if (Result<> made = MakeDirectory(parent.CStr()); !made)
+        {
+            return made;
+        }
+
+        String temp(path.View());
+        temp.Append(UniqueSuffix().View());
+
+        Result<FileHandle> file = OpenFile(temp.CStr(), FileOpenMode::Write);
+        if (!file)
+        {
+            return PendingFailure{file.Category()};
+        }
+        Result<uint64> written = WriteFile(file.Value(), data);
+        Result<> closed = CloseFile(file.Value());
+        if (!written || !closed)
+        {
+            (void)RemoveFile(temp.CStr());
+            return {ErrorCategory::Io, "Failed to write derived data"};
+        }
+
+        if (Result<> renamed = RenameFile(temp.CStr(), path.CStr()); !renamed)
+        {
+            (void)RemoveFile(temp.CStr());
+            return renamed;
+        }
+        return ResultCode::Success;
+    }
+
+    // Copies an artifact up to the shared cache, unless someone already has. Failing to is
+    // counted rather than returned, the artifact is safe locally either way.
+    void PutShared(const DerivedDataKey& key, ByteView data)
+    {
+        if (!hasShared || !writeShared)
+        {
+            return;
+        }
+        const String shared_path = ArtifactPath(sharedDirectory, key);
+        if (GetFileInfo(shared_path.CStr()))
+        {
+            return;
+        }
+        if (Result<> written = WriteWhole(shared_path, data); !written)
+        {
+            sharedPutFailures.fetch_add(1, std::memory_order_relaxed);
+            RSBL_LOG_WARNING("Failed to copy {} to the shared derived data cache: {}",
+                             shared_path.CStr(),
+                             written.FailureText());
+        }
+    }
+};
+
+Result<UniquePtr<DerivedDataCache>> DerivedDataCache::Create(
+    const DerivedDataCacheOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (options.localDirectory == nullptr || options.localDirectory[0] == '\0')
+    {
+        return {ErrorCategory::InvalidArgument, "The derived data cache needs a local directory"};
+    }
+    if (Result<> made = MakeDirectory(options.localDirectory); !made)
+    {
+        return PendingFailure{made.Category()};
+    }
+
+    UniquePtr<DerivedDataCache> cache(new DerivedDataCache());
+    cache->m_state = new State();
+    State& state = *cache->m_state;
+    state.localDirectory = options.localDirectory;
+    state.hasShared = options.sharedDirectory != nullptr && options.sharedDirectory[0] != '\0';
+    if (state.hasShared)
+    {
+        state.sharedDirectory = options.sharedDirectory;
+    }
+    state.writeShared = options.writeShared;
+
+    // Heap addresses are randomized per process, so two started in the same tick on different
+    // machines still pick different names
+    const uint64 state_address = reinterpret_cast<uint64>(&state);
+    state.tempSeed = HashCombine(HashMix(state_address), Clock::NowNs());
+    return cache;
+}
+
+DerivedDataCache::~DerivedDataCache()
+{
+    delete m_state;
+}
+
+Result<String> DerivedDataCache::Find(const DerivedDataKey& key)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    String local_path = ArtifactPath(m_state->localDirectory, key);
+    if (GetFileInfo(local_path.CStr()))
+    {
+        m_state->localHits.fetch_add(1, std::memory_order_relaxed);
+        return local_path;
+    }
+
+    if (m_state->hasShared)
+    {
+        const String shared_path = ArtifactPath(m_state->sharedDirectory, key);
+        if (Result<MappedFile> shared = MapFile(shared_path.CStr()))
+        {
+            if (Result<> copied = m_state->WriteWhole(local_path, shared.Value().View()); !copied)
+            {
+                return PendingFailure{copied.Category()};
+            }
+            m_state->sharedHits.fetch_add(1, std::memory_order_relaxed);
+            return local_path;
+        }
+    }
+
+    m_state->misses.fetch_add(1, std::memory_order_relaxed);
+    return {ErrorCategory::NotFound, "Not in the derived data cache"};
+}
+
+Result<> DerivedDataCache::Put(const DerivedDataKey& key, ByteView data)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (Result<> written = m_state->WriteWhole(LocalPath(key), data); !written)
+    {
+        return written;
+    }
+    m_state->puts.fetch_add(1, std::memory_order_relaxed);
+    m_state->PutShared(key, data);
+    return ResultCode::Success;
+}
+
+Result<> DerivedDataCache::PutFile(const DerivedDataKey& key, const char* path)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    const String local_path = LocalPath(key);
+    if (Result<> made = MakeDirectory(String(ParentOf(local_path)).CStr()); !made)
+    {
+        return made;
+    }
+
+    // A rename when the file is on the same volume, which it is when it came from TempPath
+    if (!RenameFile(path, local_path.CStr()))
+    {
+        Result<MappedFile> mapped = MapFile(path);
+        if (!mapped)
+        {
+            return PendingFailure{mapped.Category()};
+        }
+        if (Result<> written = m_state->WriteWhole(local_path, mapped.Value().View()); !written)
+        {
+            return written;
+        }
+        mapped.Value().Unmap();
+        (void)RemoveFile(path);
+    }
+    m_state->puts.fetch_add(1, std::memory_order_relaxed);
+
+    if (m_state->hasShared && m_state->writeShared)
+    {
+        if (Result<MappedFile> mapped = MapFile(local_path.CStr()))
+        {
+            m_state->PutShared(key, mapped.Value().View());
+        }
+    }
+    return ResultCode::Success;
+}
+
+String DerivedDataCache::TempPath()
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    String path(m_state->localDirectory.View());
+    path.Append("/cooking");
+    path.Append(m_state->UniqueSuffix().View());
+    return path;
+}
+
+String DerivedDataCache::LocalPath(const DerivedDataKey& key) const
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    return ArtifactPath(m_state->localDirectory, key);
+}
+
+DerivedDataCacheStats DerivedDataCache::Stats() const
+{
+    DerivedDataCacheStats stats;
+    stats.localHits = m_state->localHits.load(std::memory_order_relaxed);
+    stats.sharedHits = m_state->sharedHits.load(std::memory_order_relaxed);
+    stats.misses = m_state->misses.load(std::memory_order_relaxed);
+    stats.puts = m_state->puts.load(std::memory_order_relaxed);
+    stats.sharedPutFailures = m_state->sharedPutFailures.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace rsbl
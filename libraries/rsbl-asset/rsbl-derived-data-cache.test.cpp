@@ -0,0 +1,237 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-derived-data-cache.h"
+
+#include <rsbl-file.h>
+#include <rsbl-thread.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kLocalDirectory = "rsbl-ddc-test-local";
+constexpr const char* kSharedDirectory = "rsbl-ddc-test-shared";
+
+struct Settings
+{
+    uint32 quality;
+    uint32 flags;
+};
+
+DerivedDataKey KeyFor(const char* source, uint32 quality, uint32 version = 1)
+{
+    DerivedDataKeyBuilder builder("test", version);
+    builder.AddValue(Settings{quality, 0}).Add(StringView(source));
+    return builder.Finish();
+}
+
+String ReadText(const String& path)
+{
+    char buffer[256] = {};
+    Result<uint64> read = OpenAndReadFile(path.CStr(), AsWritableBytes(buffer, sizeof(buffer)));
+    REQUIRE(read);
+    return String(StringView(buffer, read.Value()));
+}
+
+void Reset()
+{
+    std::filesystem::remove_all(kLocalDirectory);
+    std::filesystem::remove_all(kSharedDirectory);
+}
+} // namespace
+
+TEST_SUITE("rsbl::DerivedDataCache")
+{
+    TEST_CASE("Keys follow every input")
+    {
+        const DerivedDataKey key = KeyFor("source", 3);
+        CHECK(key == KeyFor("source", 3));
+        CHECK_FALSE(key == KeyFor("source", 4));
+        CHECK_FALSE(key == KeyFor("sourcE", 3));
+        CHECK_FALSE(key == KeyFor("source", 3, 2));
+
+        // Where one input ends and the next starts matters
+        DerivedDataKeyBuilder ab("test", 1);
+        ab.Add(StringView("ab")).Add(StringView("c"));
+        DerivedDataKeyBuilder a_bc("test", 1);
+        a_bc.Add(StringView("a")).Add(StringView("bc"));
+        CHECK_FALSE(ab.Finish() == a_bc.Finish());
+
+        char hex[kDerivedDataKeyHexSize + 1];
+        DerivedDataKeyToHex(DerivedDataKey{0x0123456789abcdefull, 0xfedcba9876543210ull}, hex);
+        CHECK(std::strcmp(hex, "0123456789abcdeffedcba9876543210") == 0);
+    }
+
+    TEST_CASE("Miss, put, then hit locally")
+    {
+        Reset();
+        DerivedDataCacheOptions options;
+        options.localDirectory = kLocalDirectory;
+        Result<UniquePtr<DerivedDataCache>> cache = DerivedDataCache::Create(options);
+        REQUIRE(cache);
+
+        const DerivedDataKey key = KeyFor("mesh.gltf", 1);
+        CHECK(cache.Value()->Find(key).Category() == ErrorCategory::NotFound);
+
+        const char artifact[] = "cooked bytes";
+        REQUIRE(cache.Value()->Put(key, AsBytes(artifact, sizeof(artifact) - 1)));
+
+        Result<String> found = cache.Value()->Find(key);
+        REQUIRE(found);
+        CHECK(found.Value() == cache.Value()->LocalPath(key));
+        CHECK(ReadText(found.Value()) == StringView("cooked bytes"));
+
+        // A second cache over the same directory, the next run, finds it too
+        Result<UniquePtr<DerivedDataCache>> next_run = DerivedDataCache::Create(options);
+        REQUIRE(next_run);
+        CHECK(next_run.Value()->Find(key));
+
+        const DerivedDataCacheStats stats = cache.Value()->Stats();
+        CHECK(stats.misses == 1);
+        CHECK(stats.puts == 1);
+        CHECK(stats.localHits == 1);
+        Reset();
+    }
+
+    TEST_CASE("Cooking into a temp file and handing it over")
+    {
+        Reset();
+        DerivedDataCacheOptions options;
+        options.localDirectory = kLocalDirectory;
+        options.sharedDirectory = kSharedDirectory;
+        Result<UniquePtr<DerivedDataCache>> cache = DerivedDataCache::Create(options);
+        REQUIRE(cache);
+
+        const String temp = cache.Value()->TempPath();
+        CHECK_FALSE(temp == cache.Value()->TempPath());
+        {
+            Result<FileHandle> file = OpenFile(temp.CStr(), FileOpenMode::Write);
+            REQUIRE(file);
+            REQUIRE(WriteFile(file.Value(), AsBytes("from a file", 11)));
+            CHECK(CloseFile(file.Value()));
+        }
+
+        const DerivedDataKey key = KeyFor("texture.png", 2);
+        REQUIRE(cache.Value()->PutFile(key, temp.CStr()));
+        CHECK(GetFileInfo(temp.CStr()).Category() == ErrorCategory::NotFound);
+
+        Result<String> found = cache.Value()->Find(key);
+        REQUIRE(found);
+        CHECK(ReadText(found.Value()) == StringView("from a file"));
+        Reset();
+    }
+
+    TEST_CASE("A fresh machine fetches from the shared cache")
+    {
+        Reset();
+        const DerivedDataKey key = KeyFor("shader.hlsl", 0);
+        {
+            // The build machine cooks and writes everything up
+            DerivedDataCacheOptions options;
+            options.localDirectory = "rsbl-ddc-test-local/ci";
+            options.sharedDirectory = kSharedDirectory;
+            Result<UniquePtr<DerivedDataCache>> ci = DerivedDataCache::Create(options);
+            REQUIRE(ci);
+            REQUIRE(ci.Value()->Put(key, AsBytes("bytecode", 8)));
+        }
+
+        DerivedDataCacheOptions options;
+        options.localDirectory = "rsbl-ddc-test-local/artist";
+        options.sharedDirectory = kSharedDirectory;
+        options.writeShared = false;
+        Result<UniquePtr<DerivedDataCache>> artist = DerivedDataCache::Create(options);
+        REQUIRE(artist);
+
+        Result<String> found = artist.Value()->Find(key);
+        REQUIRE(found);
+        CHECK(found.Value() == artist.Value()->LocalPath(key));
+        CHECK(ReadText(found.Value()) == StringView("bytecode"));
+
+        // Now local, so the shared cache isn't asked again
+        CHECK(artist.Value()->Find(key));
+        DerivedDataCacheStats stats = artist.Value()->Stats();
+        CHECK(stats.sharedHits == 1);
+        CHECK(stats.localHits == 1);
+
+        // Reading only: what this machine cooks stays here
+        const DerivedDataKey local_only = KeyFor("shader.hlsl", 1);
+        REQUIRE(artist.Value()->Put(local_only, AsBytes("local", 5)));
+        char hex[kDerivedDataKeyHexSize + 1];
+        DerivedDataKeyToHex(local_only, hex);
+        CHECK_FALSE(std::filesystem::exists(std::filesystem::path(kSharedDirectory) /
+                                            std::string(hex, 2) / hex));
+        Reset();
+    }
+
+    TEST_CASE("Threads putting the same key all see a whole artifact")
+    {
+        Reset();
+        DerivedDataCacheOptions options;
+        options.localDirectory = kLocalDirectory;
+        options.sharedDirectory = kSharedDirectory;
+        Result<UniquePtr<DerivedDataCache>> cache = DerivedDataCache::Create(options);
+        REQUIRE(cache);
+        DerivedDataCache& shared_cache = *cache.Value();
+
+        const DerivedDataKey key = KeyFor("contended", 0);
+        char artifact[64 * 1024];
+        for (uint32 i = 0; i < sizeof(artifact); ++i)
+        {
+            artifact[i] = static_cast<char>('a' + i % 26);
+        }
+
+        constexpr uint32 kThreadCount = 4;
+        UniquePtr<Thread> threads[kThreadCount];
+        for (UniquePtr<Thread>& thread : threads)
+        {
+            Result<UniquePtr<Thread>> created = Thread::Create([&]() -> Result<> {
+                const ByteView bytes = AsBytes(artifact, sizeof(artifact));
+                for (uint32 i = 0; i < 20; ++i)
+                {
+                    if (Result<> put = shared_cache.Put(key, bytes); !put)
+                    {
+                        return put;
+                    }
+                    Result<String> found = shared_cache.Find(key);
+                    if (!found)
+                    {
+                        return PendingFailure{found.Category()};
+                    }
+                    Result<FileInfo> info = GetFileInfo(found.Value().CStr());
+                    if (!info || info.Value().size != sizeof(artifact))
+                    {
+                        return {ErrorCategory::Generic, "Saw a partial artifact"};
+                    }
+                }
+                return ResultCode::Success;
+            });
+            REQUIRE(created);
+            thread = rsblMove(created.Value());
+        }
+        for (UniquePtr<Thread>& thread : threads)
+        {
+            CHECK(thread->Join());
+        }
+
+        // Nothing left half written
+        uint32 files = 0;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(kLocalDirectory))
+        {
+            if (entry.is_regular_file())
+            {
+                CHECK(entry.path().extension() != ".tmp");
+                ++files;
+            }
+        }
+        CHECK(files == 1);
+        Reset();
+    }
+}
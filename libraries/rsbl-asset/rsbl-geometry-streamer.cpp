@@ -0,0 +1,874 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-geometry-streamer.h"
+
+#include <rsbl-async-io.h>
+#include <rsbl-bits.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-sort.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kGeometryTableMagic = 0x4F454752; // "RGEO"
+constexpr uint32 kGeometryPageMagic = 0x47504752;  // "RGPG"
+
+// Every array in a table or a page starts on this
+constexpr uint64 kSectionAlignment = 16;
+
+// The table's entry. Then, each aligned: the submeshes, the lods as SelectLod wants them, each
+// lod's pages, and the cooked mesh's mesh ranges and nodes.
+struct GeometryTableHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint32 submeshCount;
+    uint32 lodCount;
+    uint32 meshCount;
+    uint32 nodeCount;
+    uint32 pageCount;
+    uint32 reserved;
+};
+
+struct LodPages
+{
+    uint32 firstPage;
+    uint32 pageCount;
+};
+
+// A page's entry. Then, each aligned: vertices, indices, meshlets, meshlet vertices and meshlet
+// triangles, three bytes each.
+struct GeometryPageHeader
+{
+    uint32 magic;
+    uint32 vertexCount;
+    uint32 indexCount;
+    uint32 meshletCount;
+    uint32 meshletVertexCount;
+    uint32 meshletTriangleCount;
+    uint32 reserved[2];
+};
+
+constexpr uint32 kNoLod = ~0u;
+
+String PageName(StringView mesh, uint32 page)
+{
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "/%u", page);
+    String name(mesh);
+    name.Append(suffix);
+    return name;
+}
+
+void AppendSection(DynamicArray<uint8>& out, ByteView bytes)
+{
+    const uint64 start = AlignUp(out.Size(), kSectionAlignment);
+    out.Resize(start + bytes.Size());
+    if (!bytes.IsEmpty())
+    {
+        std::memcpy(out.Data() + start, bytes.Data(), bytes.Size());
+    }
+}
+
+// Where each section of a table or page is, checked to be inside bytes. Walks them the way
+// AppendSection laid them out.
+class SectionReader
+{
+  public:
+    SectionReader(ByteView bytes, uint64 headerSize)
+        : m_bytes(bytes)
+        , m_position(headerSize)
+    {
+    }
+
+    template <typename T>
+    bool Next(uint64 count, ArrayView<const T>& section)
+    {
+        const uint64 start = AlignUp(m_position, kSectionAlignment);
+        if (start > m_bytes.Size() || count > (m_bytes.Size() - start) / sizeof(T))
+        {
+            return false;
+        }
+        section = ArrayView<const T>(reinterpret_cast<const T*>(m_bytes.Data() + start), count);
+        m_position = start + count * sizeof(T);
+        return true;
+    }
+
+  private:
+    ByteView m_bytes;
+    uint64 m_position;
+};
+
+bool ParsePage(ByteView bytes, GeometryPage& page)
+{
+    GeometryPageHeader header;
+    if (bytes.Size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, bytes.Data(), sizeof(header));
+    SectionReader reader(bytes, sizeof(header));
+    return header.magic == kGeometryPageMagic && reader.Next(header.vertexCount, page.vertices) &&
+           reader.Next(header.indexCount, page.indices) &&
+           reader.Next(header.meshletCount, page.meshlets) &&
+           reader.Next(header.meshletVertexCount, page.meshletVertices) &&
+           reader.Next(uint64(header.meshletTriangleCount) * 3, page.meshletTriangles);
+}
+
+// One page's arrays as they're gathered from a submesh, vertices renumbered in order of first
+// use so the page only has the ones its triangles touch
+struct PageBuilder
+{
+    // Indexed by the submesh's vertex, ~0u for one the page doesn't have yet
+    DynamicArray<uint32> remap;
+    DynamicArray<uint32> used;
+    DynamicArray<CookedVertex> vertices;
+    DynamicArray<uint32> indices;
+    DynamicArray<CookedMeshlet> meshlets;
+    DynamicArray<uint32> meshletVertices;
+    DynamicArray<uint8> meshletTriangles;
+    DynamicArray<uint8> bytes;
+
+    void Begin(uint32 vertexCount)
+    {
+        for (const uint32 vertex : used)
+        {
+            remap[vertex] = ~0u;
+        }
+        if (remap.Size() < vertexCount)
+        {
+            const uint64 start = remap.Size();
+            remap.ResizeUninitialized(vertexCount);
+            for (uint64 i = start; i < vertexCount; ++i)
+            {
+                remap[i] = ~0u;
+            }
+        }
+        used.Clear();
+        vertices.Clear();
+        indices.Clear();
+        meshlets.Clear();
+        meshletVertices.Clear();
+        meshletTriangles.Clear();
+    }
+
+    uint32 AddVertex(ArrayView<const CookedVertex> submeshVertices, uint32 vertex)
+    {
+        if (remap[vertex] == ~0u)
+        {
+            remap[vertex] = static_cast<uint32>(vertices.Size());
+            used.PushBack(vertex);
+            vertices.PushBack(submeshVertices[vertex]);
+        }
+        return remap[vertex];
+    }
+
+    ByteView Serialize()
+    {
+        GeometryPageHeader header = {};
+        header.magic = kGeometryPageMagic;
+        header.vertexCount = static_cast<uint32>(vertices.Size());
+        header.indexCount = static_cast<uint32>(indices.Size());
+        header.meshletCount = static_cast<uint32>(meshlets.Size());
+        header.meshletVertexCount = static_cast<uint32>(meshletVertices.Size());
+        header.meshletTriangleCount = static_cast<uint32>(meshletTriangles.Size() / 3);
+        bytes.Clear();
+        AppendSection(bytes, AsBytes(&header, sizeof(header)));
+        AppendSection(bytes, AsBytes(ArrayView<const CookedVertex>(vertices)));
+        AppendSection(bytes, AsBytes(ArrayView<const uint32>(indices)));
+        AppendSection(bytes, AsBytes(ArrayView<const CookedMeshlet>(meshlets)));
+        AppendSection(bytes, AsBytes(ArrayView<const uint32>(meshletVertices)));
+        AppendSection(bytes, AsBytes(ArrayView<const uint8>(meshletTriangles)));
+        return bytes;
+    }
+};
+} // namespace
+
+Result<> WriteStreamedGeometry(PackWriter& pack,
+                               StringView name,
+                               const CookedMesh& mesh,
+                               const StreamedGeometryOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (options.meshletsPerPage == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Pages need at least one meshlet"};
+    }
+
+    const ArrayView<const CookedVertex> vertices = mesh.Vertices();
+    const ArrayView<const uint32> indices = mesh.Indices();
+    const ArrayView<const CookedMeshlet> meshlets = mesh.Meshlets();
+    const ArrayView<const uint32> meshlet_vertices = mesh.MeshletVertices();
+    const ArrayView<const uint8> meshlet_triangles = mesh.MeshletTriangles();
+    const ArrayView<const CookedLod> lods = mesh.Lods();
+
+    DynamicArray<StreamedSubmesh> table_submeshes;
+    DynamicArray<CookedLod> table_lods;
+    DynamicArray<LodPages> lod_pages;
+    PageBuilder builder;
+    uint32 page_count = 0;
+
+    auto add_page = [&]() -> Result<> {
+        const String page_name = PageName(name, page_count);
+        Result<> added =
+            pack.Add(page_name, builder.Serialize(), options.compression, options.level);
+        ++page_count;
+        return added;
+    };
+
+    for (const CookedSubmesh& submesh : mesh.Submeshes())
+    {
+        if (submesh.lodCount == 0)
+        {
+            return {ErrorCategory::InvalidArgument, "Every submesh needs its full detail lod"};
+        }
+        const ArrayView<const CookedVertex> submesh_vertices =
+            vertices.Subview(submesh.vertexOffset, submesh.vertexCount);
+
+        table_submeshes.PushBack(StreamedSubmesh{submesh.bounds,
+                                                 submesh.material,
+                                                 static_cast<uint32>(table_lods.Size()),
+                                                 submesh.lodCount});
+        for (uint32 lod = 0; lod < submesh.lodCount; ++lod)
+        {
+            const CookedLod& cooked = lods[submesh.lodOffset + lod];
+            table_lods.PushBack(CookedLod{0, cooked.indexCount, cooked.error});
+            LodPages pages{page_count, 0};
+
+            // The full detail lod in runs of meshlets, triangle lists of the same triangles
+            // alongside. The rest are just their triangle lists.
+            if (lod == 0 && submesh.meshletCount > 0)
+            {
+                for (uint32 first = 0; first < submesh.meshletCount;
+                     first += options.meshletsPerPage)
+                {
+                    const uint32 count = submesh.meshletCount - first < options.meshletsPerPage
+                                             ? submesh.meshletCount - first
+                                             : options.meshletsPerPage;
+                    builder.Begin(submesh.vertexCount);
+                    for (uint32 i = 0; i < count; ++i)
+                    {
+                        CookedMeshlet meshlet = meshlets[submesh.meshletOffset + first + i];
+                        const uint32 vertex_offset =
+                            static_cast<uint32>(builder.meshletVertices.Size());
+                        for (uint32 v = 0; v < meshlet.vertexCount; ++v)
+                        {
+                            builder.meshletVertices.PushBack(builder.AddVertex(
+                                submesh_vertices, meshlet_vertices[meshlet.vertexOffset + v]));
+                        }
+                        const uint8* triangles =
+                            meshlet_triangles.Data() + uint64(meshlet.triangleOffset) * 3;
+                        for (uint32 corner = 0; corner < meshlet.triangleCount * 3; ++corner)
+                        {
+                            builder.meshletTriangles.PushBack(triangles[corner]);
+                            builder.indices.PushBack(
+                                builder.meshletVertices[vertex_offset + triangles[corner]]);
+                        }
+                        meshlet.vertexOffset = vertex_offset;
+                        meshlet.triangleOffset =
+                            static_cast<uint32>(builder.meshletTriangles.Size() / 3) -
+                            meshlet.triangleCount;
+                        builder.meshlets.PushBack(meshlet);
+                    }
+                    if (auto added = add_page(); !added)
+                    {
+                        return added;
+                    }
+                    ++pages.pageCount;
+                }
+            }
+            else
+            {
+                builder.Begin(submesh.vertexCount);
+                for (uint32 i = 0; i < cooked.indexCount; ++i)
+                {
+                    builder.indices.PushBack(
+                        builder.AddVertex(submesh_vertices, indices[cooked.indexOffset + i]));
+                }
+                if (auto added = add_page(); !added)
+                {
+                    return added;
+                }
+                pages.pageCount = 1;
+            }
+            lod_pages.PushBack(pages);
+        }
+    }
+
+    const ArrayView<const CookedMeshRange> ranges = mesh.Meshes();
+    const ArrayView<const CookedNode> nodes = mesh.Nodes();
+    GeometryTableHeader header = {};
+    header.magic = kGeometryTableMagic;
+    header.version = kStreamedGeometryVersion;
+    header.submeshCount = static_cast<uint32>(table_submeshes.Size());
+    header.lodCount = static_cast<uint32>(table_lods.Size());
+    header.meshCount = static_cast<uint32>(ranges.Size());
+    header.nodeCount = static_cast<uint32>(nodes.Size());
+    header.pageCount = page_count;
+    DynamicArray<uint8> table;
+    AppendSection(table, AsBytes(&header, sizeof(header)));
+    AppendSection(table, AsBytes(ArrayView<const StreamedSubmesh>(table_submeshes)));
+    AppendSection(table, AsBytes(ArrayView<const CookedLod>(table_lods)));
+    AppendSection(table, AsBytes(ArrayView<const LodPages>(lod_pages)));
+    AppendSection(table, AsBytes(ranges));
+    AppendSection(table, AsBytes(nodes));
+    return pack.Add(name, table, options.compression, options.level);
+}
+
+struct GeometryStreamer::State
+{
+    struct Page
+    {
+        const PackEntry* entry = nullptr;
+        // What the page decompressed to, and its stored bytes while a compressed one's being
+        // read
+        DynamicArray<uint8> data;
+        DynamicArray<uint8> stored;
+        GeometryPage view;
+    };
+
+    struct Mesh
+    {
+        DynamicArray<uint8> table;
+        ArrayView<const StreamedSubmesh> submeshes;
+        ArrayView<const CookedLod> lods;
+        ArrayView<const LodPages> lodPages;
+        ArrayView<const CookedMeshRange> ranges;
+        ArrayView<const CookedNode> nodes;
+        DynamicArray<Page> pages;
+        // The first of its submeshes in State::submeshes
+        uint32 submeshOffset = 0;
+    };
+
+    struct Submesh
+    {
+        uint32 mesh = 0;
+        // Into Mesh::lods and lodPages
+        uint32 lodOffset = 0;
+        uint32 lodCount = 0;
+
+        uint32 residentLod = 0;
+        // Asked for since the last Update, and as of the last Update
+        uint32 requestedLod = kNoLod;
+        uint32 wantedLod = kNoLod;
+        uint64 lastWantedFrame = 0;
+        // The one lod being read, residentLod - 1, or kNoLod. Its pages are queued in order,
+        // as many as there's room for each Update.
+        uint32 readingLod = kNoLod;
+        uint32 nextPage = 0;
+        uint32 pagesInFlight = 0;
+        bool readFailed = false;
+        // A read failed, it stays at what it has
+        bool broken = false;
+    };
+
+    AsyncIo* io = nullptr;
+    UniquePtr<Pack> pack;
+    FileHandle file = 0;
+    GeometryStreamerOptions options;
+
+    DynamicArray<Mesh> meshes;
+    DynamicArray<Submesh> submeshes;
+    DynamicArray<StreamedLod> arrived;
+    // Lod bytes summed over its pages, indexed as Mesh::lods with the mesh's lod offset
+    DynamicArray<uint64> lodBytes;
+    DynamicArray<uint64> meshLodOffsets;
+    uint32 readsInFlight = 0;
+    uint64 frame = 0;
+    GeometryStreamerStats stats;
+
+    uint64 LodBytes(const Submesh& submesh, uint32 lod) const
+    {
+        return lodBytes[meshLodOffsets[submesh.mesh] + submesh.lodOffset + lod];
+    }
+
+    Page& LodPage(const Submesh& submesh, uint32 lod, uint32 page)
+    {
+        Mesh& mesh = meshes[submesh.mesh];
+        return mesh.pages[mesh.lodPages[submesh.lodOffset + lod].firstPage + page];
+    }
+
+    uint32 LodPageCount(const Submesh& submesh, uint32 lod) const
+    {
+        return meshes[submesh.mesh].lodPages[submesh.lodOffset + lod].pageCount;
+    }
+
+    void FreeLod(const Submesh& submesh, uint32 lod)
+    {
+        for (uint32 i = 0; i < LodPageCount(submesh, lod); ++i)
+        {
+            Page& page = LodPage(submesh, lod, i);
+            page.data = DynamicArray<uint8>();
+            page.stored = DynamicArray<uint8>();
+            page.view = GeometryPage();
+        }
+    }
+
+    // Whether the submesh wants its finest resident lod this frame
+    bool Wants(const Submesh& submesh) const
+    {
+        return submesh.lastWantedFrame == frame && submesh.wantedLod <= submesh.residentLod;
+    }
+
+    // Drops the finest resident lod of whichever submesh asked for it longest ago, sparing the
+    // ones that want it this frame. False when there's nothing to drop.
+    bool EvictOne()
+    {
+        Submesh* victim = nullptr;
+        for (Submesh& submesh : submeshes)
+        {
+            if (submesh.residentLod + 1 >= submesh.lodCount || submesh.readingLod != kNoLod ||
+                Wants(submesh))
+            {
+                continue;
+            }
+            if (victim == nullptr || submesh.lastWantedFrame < victim->lastWantedFrame)
+            {
+                victim = &submesh;
+            }
+        }
+        if (victim == nullptr)
+        {
+            return false;
+        }
+
+        FreeLod(*victim, victim->residentLod);
+        stats.residentBytes -= LodBytes(*victim, victim->residentLod);
+        ++victim->residentLod;
+        ++stats.lodsEvicted;
+        return true;
+    }
+
+    // Queues the reading lod's pages that aren't yet, as far as the reads in flight allow.
+    // True when it queued any.
+    bool QueuePages(uint32 index)
+    {
+        Submesh& submesh = submeshes[index];
+        const uint32 page_count = LodPageCount(submesh, submesh.readingLod);
+        bool queued = false;
+        while (submesh.nextPage < page_count && readsInFlight < options.maxReadsInFlight)
+        {
+            Page& page = LodPage(submesh, submesh.readingLod, submesh.nextPage);
+            const PackEntry& entry = *page.entry;
+            DynamicArray<uint8>& buffer =
+                entry.compression == PackCompression::None ? page.data : page.stored;
+            buffer.ResizeUninitialized(entry.storedSize);
+
+            AsyncRead read;
+            read.file = file;
+            read.offset = entry.offset;
+            read.buffer = MutableByteView(buffer.Data(), buffer.Size());
+            read.userData = (uint64(index) << 32) | (&page - meshes[submesh.mesh].pages.Data());
+            if (!io->QueueRead(read))
+            {
+                buffer.Clear();
+                break;
+            }
+            ++readsInFlight;
+            ++submesh.pagesInFlight;
+            ++submesh.nextPage;
+            queued = true;
+        }
+        return queued;
+    }
+
+    // The page's bytes are in, decompresses them if they need it
+    bool FinishPage(Page& page)
+    {
+        const PackEntry& entry = *page.entry;
+        if (entry.compression != PackCompression::None)
+        {
+            page.data.ResizeUninitialized(entry.size);
+            const uint32 block_count = pack->BlockCount(entry);
+            for (uint32 block = 0; block < block_count; ++block)
+            {
+                if (!pack->DecompressBlock(entry, page.stored, block, page.data))
+                {
+                    return false;
+                }
+            }
+            page.stored = DynamicArray<uint8>();
+        }
+        return ParsePage(page.data, page.view);
+    }
+
+    void Reap()
+    {
+        AsyncIoCompletion completions[32];
+        uint32 count = 0;
+        while ((count = io->PollCompletions(completions, 32)) > 0)
+        {
+            for (uint32 i = 0; i < count; ++i)
+            {
+                const uint32 index = static_cast<uint32>(completions[i].userData >> 32);
+                Submesh& submesh = submeshes[index];
+                Page& page =
+                    meshes[submesh.mesh].pages[completions[i].userData & 0xFFFFFFFFu];
+                --readsInFlight;
+                --submesh.pagesInFlight;
+
+                if (!completions[i].succeeded ||
+                    completions[i].bytesRead != page.entry->storedSize || !FinishPage(page))
+                {
+                    submesh.readFailed = true;
+                }
+
+                const uint32 lod = submesh.readingLod;
+                if (submesh.pagesInFlight > 0 ||
+                    (!submesh.readFailed && submesh.nextPage < LodPageCount(submesh, lod)))
+                {
+                    continue;
+                }
+
+                // That was the lod's last page
+                const uint64 bytes = LodBytes(submesh, lod);
+                stats.pendingBytes -= bytes;
+                submesh.readingLod = kNoLod;
+                if (submesh.readFailed)
+                {
+                    FreeLod(submesh, lod);
+                    submesh.broken = true;
+                    ++stats.failedReads;
+                    continue;
+                }
+                submesh.residentLod = lod;
+                stats.residentBytes += bytes;
+                ++stats.lodsRead;
+                arrived.PushBack(StreamedLod{submesh.mesh,
+                                             index - meshes[submesh.mesh].submeshOffset,
+                                             lod});
+            }
+        }
+    }
+};
+
+Result<UniquePtr<GeometryStreamer>> GeometryStreamer::Create(AsyncIo& io,
+                                                             const char* packPath,
+                                                             const GeometryStreamerOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (options.maxReadsInFlight == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Streaming needs at least one read in flight"};
+    }
+
+    Result<UniquePtr<Pack>> pack = Pack::Open(packPath);
+    if (!pack)
+    {
+        return PendingFailure{pack.Category()};
+    }
+    Result<FileHandle> file = io.OpenForRead(packPath);
+    if (!file)
+    {
+        return PendingFailure{file.Category()};
+    }
+
+    UniquePtr<GeometryStreamer> streamer(new GeometryStreamer());
+    streamer->m_state = new State();
+    streamer->m_state->io = &io;
+    streamer->m_state->pack = rsblMove(pack.Value());
+    streamer->m_state->file = file.Value();
+    streamer->m_state->options = options;
+    return rsblMove(streamer);
+}
+
+GeometryStreamer::~GeometryStreamer()
+{
+    State* state = m_state;
+    AsyncIoCompletion completions[32];
+    while (state->io->InFlight() > 0)
+    {
+        state->io->WaitCompletions(completions, 32);
+    }
+    (void)CloseFile(state->file);
+    delete state;
+}
+
+Result<uint32> GeometryStreamer::Open(StringView name)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+    const Pack& pack = *state->pack;
+
+    const PackEntry* table_entry = pack.Find(name);
+    if (table_entry == nullptr)
+    {
+        return {ErrorCategory::NotFound, "The pack has no mesh of that name"};
+    }
+
+    State::Mesh mesh;
+    mesh.table.ResizeUninitialized(table_entry->size);
+    Result<uint64> read = pack.Read(*table_entry, mesh.table);
+    if (!read)
+    {
+        return PendingFailure{read.Category()};
+    }
+
+    GeometryTableHeader header = {};
+    if (mesh.table.Size() >= sizeof(header))
+    {
+        std::memcpy(&header, mesh.table.Data(), sizeof(header));
+    }
+    SectionReader reader(mesh.table, sizeof(header));
+    bool valid = header.magic == kGeometryTableMagic &&
+                 header.version == kStreamedGeometryVersion &&
+                 reader.Next(header.submeshCount, mesh.submeshes) &&
+                 reader.Next(header.lodCount, mesh.lods) &&
+                 reader.Next(header.lodCount, mesh.lodPages) &&
+                 reader.Next(header.meshCount, mesh.ranges) &&
+                 reader.Next(header.nodeCount, mesh.nodes);
+    for (uint32 i = 0; valid && i < header.submeshCount; ++i)
+    {
+        const StreamedSubmesh& submesh = mesh.submeshes[i];
+        valid = submesh.lodCount > 0 && submesh.lodOffset <= header.lodCount &&
+                submesh.lodCount <= header.lodCount - submesh.lodOffset;
+    }
+    for (uint32 i = 0; valid && i < header.lodCount; ++i)
+    {
+        const LodPages& pages = mesh.lodPages[i];
+        valid = pages.pageCount > 0 && pages.firstPage <= header.pageCount &&
+                pages.pageCount <= header.pageCount - pages.firstPage;
+    }
+    if (!valid)
+    {
+        return {ErrorCategory::InvalidArgument, "Not a streamed mesh, or a corrupt one"};
+    }
+
+    mesh.pages.Resize(header.pageCount);
+    for (uint32 i = 0; i < header.pageCount; ++i)
+    {
+        mesh.pages[i].entry = pack.Find(PageName(name, i));
+        if (mesh.pages[i].entry == nullptr)
+        {
+            return FailureFormat(
+                ErrorCategory::InvalidArgument, "The streamed mesh is missing page %u", i);
+        }
+    }
+
+    // Every submesh's coarsest lod, read here and kept
+    const uint32 mesh_index = static_cast<uint32>(state->meshes.Size());
+    const uint64 lod_offset = state->lodBytes.Size();
+    for (uint32 i = 0; i < header.lodCount; ++i)
+    {
+        uint64 bytes = 0;
+        const LodPages& pages = mesh.lodPages[i];
+        for (uint32 page = 0; page < pages.pageCount; ++page)
+        {
+            bytes += mesh.pages[pages.firstPage + page].entry->size;
+        }
+        state->lodBytes.PushBack(bytes);
+    }
+    uint64 coarsest_bytes = 0;
+    for (const StreamedSubmesh& submesh : mesh.submeshes)
+    {
+        const LodPages& pages = mesh.lodPages[submesh.lodOffset + submesh.lodCount - 1];
+        for (uint32 i = 0; i < pages.pageCount; ++i)
+        {
+            State::Page& page = mesh.pages[pages.firstPage + i];
+            page.data.ResizeUninitialized(page.entry->size);
+            read = pack.Read(*page.entry, page.data);
+            if (!read)
+            {
+                state->lodBytes.Resize(lod_offset);
+                return PendingFailure{read.Category()};
+            }
+            if (!ParsePage(page.data, page.view))
+            {
+                state->lodBytes.Resize(lod_offset);
+                return {ErrorCategory::InvalidArgument, "Corrupt page in a streamed mesh"};
+            }
+            coarsest_bytes += page.data.Size();
+        }
+    }
+
+    mesh.submeshOffset = static_cast<uint32>(state->submeshes.Size());
+    for (const StreamedSubmesh& streamed : mesh.submeshes)
+    {
+        State::Submesh submesh;
+        submesh.mesh = mesh_index;
+        submesh.lodOffset = streamed.lodOffset;
+        submesh.lodCount = streamed.lodCount;
+        submesh.residentLod = streamed.lodCount - 1;
+        state->submeshes.PushBack(submesh);
+    }
+    state->meshLodOffsets.PushBack(lod_offset);
+    state->stats.coarsestBytes += coarsest_bytes;
+    state->meshes.PushBack(rsblMove(mesh));
+    return mesh_index;
+}
+
+uint32 GeometryStreamer::MeshCount() const
+{
+    return static_cast<uint32>(m_state->meshes.Size());
+}
+
+ArrayView<const StreamedSubmesh> GeometryStreamer::Submeshes(uint32 mesh) const
+{
+    return m_state->meshes[mesh].submeshes;
+}
+
+ArrayView<const CookedMeshRange> GeometryStreamer::Meshes(uint32 mesh) const
+{
+    return m_state->meshes[mesh].ranges;
+}
+
+ArrayView<const CookedNode> GeometryStreamer::Nodes(uint32 mesh) const
+{
+    return m_state->meshes[mesh].nodes;
+}
+
+ArrayView<const CookedLod> GeometryStreamer::Lods(uint32 mesh, uint32 submesh) const
+{
+    const State::Mesh& streamed = m_state->meshes[mesh];
+    const StreamedSubmesh& info = streamed.submeshes[submesh];
+    return streamed.lods.Subview(info.lodOffset, info.lodCount);
+}
+
+void GeometryStreamer::Request(uint32 mesh, uint32 submesh, uint32 lod)
+{
+    State::Submesh& requested =
+        m_state->submeshes[m_state->meshes[mesh].submeshOffset + submesh];
+    requested.requestedLod = lod < requested.requestedLod ? lod : requested.requestedLod;
+}
+
+void GeometryStreamer::RequestFromLods(uint32 mesh, uint32 submesh, ArrayView<const uint8> levels)
+{
+    uint32 finest = kNoLod;
+    for (const uint8 level : levels)
+    {
+        finest = level < finest ? level : finest;
+    }
+    if (finest != kNoLod)
+    {
+        Request(mesh, submesh, finest);
+    }
+}
+
+void GeometryStreamer::Update()
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+
+    state->arrived.Clear();
+    state->Reap();
+
+    ++state->frame;
+    for (State::Submesh& submesh : state->submeshes)
+    {
+        if (submesh.requestedLod != kNoLod)
+        {
+            submesh.wantedLod = submesh.requestedLod;
+            submesh.lastWantedFrame = state->frame;
+            submesh.requestedLod = kNoLod;
+        }
+    }
+
+    // Lods partway queued go on first, they've already got their share of the budget
+    bool queued = false;
+    for (uint32 i = 0; i < state->submeshes.Size(); ++i)
+    {
+        const State::Submesh& submesh = state->submeshes[i];
+        if (submesh.readingLod != kNoLod && !submesh.readFailed)
+        {
+            queued = state->QueuePages(i) || queued;
+        }
+    }
+
+    // Furthest from what was asked for first, then in index order
+    DynamicArray<uint64> order;
+    for (uint64 i = 0; i < state->submeshes.Size(); ++i)
+    {
+        const State::Submesh& submesh = state->submeshes[i];
+        if (submesh.lastWantedFrame == state->frame && submesh.wantedLod < submesh.residentLod &&
+            submesh.readingLod == kNoLod && !submesh.broken)
+        {
+            const uint64 missing = submesh.residentLod - submesh.wantedLod;
+            order.PushBack(((0xFFFFFFFFull - missing) << 32) | i);
+        }
+    }
+    RadixSort(ArrayView<uint64>(order), GetTaggedAllocator(MemoryTag::Asset));
+
+    for (const uint64 key : order)
+    {
+        if (state->readsInFlight >= state->options.maxReadsInFlight)
+        {
+            break;
+        }
+        const uint32 index = static_cast<uint32>(key & 0xFFFFFFFFu);
+        State::Submesh& submesh = state->submeshes[index];
+        const uint32 lod = submesh.residentLod - 1;
+        const uint64 bytes = state->LodBytes(submesh, lod);
+
+        bool fits = true;
+        while (state->stats.residentBytes + state->stats.pendingBytes + bytes >
+               state->options.budget)
+        {
+            if (!state->EvictOne())
+            {
+                fits = false;
+                break;
+            }
+        }
+        if (!fits)
+        {
+            ++state->stats.overBudgetUpdates;
+            break;
+        }
+
+        submesh.readingLod = lod;
+        submesh.nextPage = 0;
+        submesh.readFailed = false;
+        state->stats.pendingBytes += bytes;
+        queued = state->QueuePages(index) || queued;
+    }
+    if (queued)
+    {
+        // Reads that don't make it in come back as failed completions
+        (void)state->io->Submit();
+    }
+}
+
+ArrayView<const StreamedLod> GeometryStreamer::Arrived() const
+{
+    return m_state->arrived;
+}
+
+uint32 GeometryStreamer::ResidentLod(uint32 mesh, uint32 submesh) const
+{
+    return m_state->submeshes[m_state->meshes[mesh].submeshOffset + submesh].residentLod;
+}
+
+uint32 GeometryStreamer::PageCount(uint32 mesh, uint32 submesh, uint32 lod) const
+{
+    const State::Submesh& streamed =
+        m_state->submeshes[m_state->meshes[mesh].submeshOffset + submesh];
+    return lod < streamed.lodCount ? m_state->LodPageCount(streamed, lod) : 0;
+}
+
+GeometryPage GeometryStreamer::Page(uint32 mesh, uint32 submesh, uint32 lod, uint32 page) const
+{
+    const State::Submesh& streamed =
+        m_state->submeshes[m_state->meshes[mesh].submeshOffset + submesh];
+    if (lod < streamed.residentLod || lod >= streamed.lodCount ||
+        page >= m_state->LodPageCount(streamed, lod))
+    {
+        return GeometryPage();
+    }
+    return m_state->LodPage(streamed, lod, page).view;
+}
+
+GeometryStreamerStats GeometryStreamer::Stats() const
+{
+    return m_state->stats;
+}
+
+} // namespace rsbl
@@ -0,0 +1,354 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-geometry-streamer.h"
+
+#include <rsbl-async-io.h>
+#include <rsbl-dynamic-array.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kMeshPath = "rsbl-geometry-streamer-test.rmesh";
+constexpr const char* kPackPath = "rsbl-geometry-streamer-test.rpak";
+
+// Rolling hills over a size x size grid of quads, so the simplification has lods to make
+struct Hills
+{
+    DynamicArray<float3> positions;
+    DynamicArray<uint32> indices;
+
+    explicit Hills(uint32 size)
+    {
+        for (uint32 z = 0; z <= size; ++z)
+        {
+            for (uint32 x = 0; x <= size; ++x)
+            {
+                const float y = std::sin(float(x) * 0.3f) * std::cos(float(z) * 0.2f);
+                positions.PushBack(float3(float(x), y, float(z)));
+            }
+        }
+        for (uint32 z = 0; z < size; ++z)
+        {
+            for (uint32 x = 0; x < size; ++x)
+            {
+                const uint32 corner = z * (size + 1) + x;
+                const uint32 quad[6] = {corner,
+                                        corner + size + 1,
+                                        corner + 1,
+                                        corner + 1,
+                                        corner + size + 1,
+                                        corner + size + 2};
+                indices.Append(quad, 6);
+            }
+        }
+    }
+
+    MeshPrimitiveInput Input() const
+    {
+        MeshPrimitiveInput input;
+        input.positions = positions;
+        input.indices = indices;
+        return input;
+    }
+};
+
+// Two submeshes of the same hills, cooked and written into a pack as "hills"
+void WritePack(const StreamedGeometryOptions& options = {})
+{
+    {
+        Result<UniquePtr<MeshCooker>> cooker = MeshCooker::Create();
+        REQUIRE(cooker);
+        const Hills hills(32);
+        cooker.Value()->BeginMesh();
+        REQUIRE(cooker.Value()->AddPrimitive(hills.Input()));
+        REQUIRE(cooker.Value()->AddPrimitive(hills.Input()));
+        MeshNodeInput node;
+        node.mesh = 0;
+        REQUIRE(cooker.Value()->AddNode(node));
+        REQUIRE(cooker.Value()->Write(kMeshPath));
+    }
+    Result<UniquePtr<CookedMesh>> mesh = CookedMesh::Open(kMeshPath);
+    REQUIRE(mesh);
+    Result<UniquePtr<PackWriter>> pack = PackWriter::Create(kPackPath);
+    REQUIRE(pack);
+    REQUIRE(WriteStreamedGeometry(*pack.Value(), "hills", *mesh.Value(), options));
+    REQUIRE(pack.Value()->Finish());
+}
+
+bool SameVertex(const CookedVertex& a, const CookedVertex& b)
+{
+    return std::memcmp(&a, &b, sizeof(CookedVertex)) == 0;
+}
+
+// Updates until nothing's being read, asking for lods each time, a few hundred times at most
+template <typename RequestFunction>
+void Settle(GeometryStreamer& streamer, RequestFunction request)
+{
+    for (uint32 i = 0; i < 1000; ++i)
+    {
+        request();
+        streamer.Update();
+        if (streamer.Stats().pendingBytes == 0)
+        {
+            return;
+        }
+    }
+    FAIL("Reads never finished");
+}
+
+struct Fixture
+{
+    UniquePtr<AsyncIo> io;
+
+    Fixture()
+    {
+        Result<UniquePtr<AsyncIo>> created = AsyncIo::Create();
+        REQUIRE(created);
+        io = rsblMove(created.Value());
+    }
+
+    ~Fixture()
+    {
+        std::remove(kMeshPath);
+        std::remove(kPackPath);
+    }
+};
+} // namespace
+
+TEST_SUITE("rsbl::GeometryStreamer")
+{
+    TEST_CASE("Pages hold each lod's triangles, meshlets in the full detail one")
+    {
+        Fixture fixture;
+        StreamedGeometryOptions options;
+        options.meshletsPerPage = 4;
+        WritePack(options);
+
+        Result<UniquePtr<CookedMesh>> opened = CookedMesh::Open(kMeshPath);
+        REQUIRE(opened);
+        const CookedMesh& cooked = *opened.Value();
+        const CookedSubmesh& submesh = cooked.Submeshes()[0];
+        REQUIRE(submesh.lodCount >= 3);
+        REQUIRE(submesh.meshletCount > 8);
+
+        Result<UniquePtr<GeometryStreamer>> created =
+            GeometryStreamer::Create(*fixture.io, kPackPath);
+        REQUIRE(created);
+        GeometryStreamer& streamer = *created.Value();
+        CHECK(streamer.Open("missing").Category() == ErrorCategory::NotFound);
+        Result<uint32> mesh = streamer.Open("hills");
+        REQUIRE(mesh);
+        REQUIRE(streamer.Submeshes(mesh.Value()).Size() == 2);
+        CHECK(streamer.Nodes(mesh.Value()).Size() == 1);
+        CHECK(streamer.Meshes(mesh.Value()).Size() == 1);
+
+        // Only the coarsest is in to start with
+        const uint32 coarsest = submesh.lodCount - 1;
+        CHECK(streamer.ResidentLod(mesh.Value(), 0) == coarsest);
+        CHECK(streamer.Stats().coarsestBytes > 0);
+        CHECK(streamer.Page(mesh.Value(), 0, 0, 0).indices.IsEmpty());
+        CHECK(streamer.PageCount(mesh.Value(), 0, 0) == (submesh.meshletCount + 3) / 4);
+        CHECK(streamer.PageCount(mesh.Value(), 0, 1) == 1);
+
+        // One lod at a time from the coarsest, each arriving before the next is read
+        DynamicArray<uint32> arrived;
+        Settle(streamer, [&]() {
+            streamer.Request(mesh.Value(), 0, 0);
+            for (const StreamedLod& lod : streamer.Arrived())
+            {
+                CHECK(lod.mesh == mesh.Value());
+                CHECK(lod.submesh == 0);
+                arrived.PushBack(lod.lod);
+            }
+        });
+        for (const StreamedLod& lod : streamer.Arrived())
+        {
+            arrived.PushBack(lod.lod);
+        }
+        REQUIRE(arrived.Size() == coarsest);
+        for (uint32 i = 0; i < coarsest; ++i)
+        {
+            CHECK(arrived[i] == coarsest - 1 - i);
+        }
+        CHECK(streamer.ResidentLod(mesh.Value(), 0) == 0);
+        CHECK(streamer.ResidentLod(mesh.Value(), 1) == coarsest);
+
+        // The coarser lods are the cooked triangle lists over vertices of their own
+        const ArrayView<const CookedVertex> vertices =
+            cooked.Vertices().Subview(submesh.vertexOffset, submesh.vertexCount);
+        const ArrayView<const CookedLod> lods = streamer.Lods(mesh.Value(), 0);
+        for (uint32 lod = 1; lod < submesh.lodCount; ++lod)
+        {
+            const CookedLod& source = cooked.Lods()[submesh.lodOffset + lod];
+            CHECK(lods[lod].indexCount == source.indexCount);
+            CHECK(lods[lod].error == source.error);
+            const GeometryPage page = streamer.Page(mesh.Value(), 0, lod, 0);
+            REQUIRE(page.indices.Size() == source.indexCount);
+            CHECK(page.vertices.Size() <= submesh.vertexCount);
+            CHECK(page.meshlets.IsEmpty());
+            for (uint32 i = 0; i < source.indexCount; ++i)
+            {
+                REQUIRE(page.indices[i] < page.vertices.Size());
+                CHECK(SameVertex(page.vertices[page.indices[i]],
+                                 vertices[cooked.Indices()[source.indexOffset + i]]));
+            }
+        }
+
+        // The full detail one is the cooked meshlets, four a page, with their triangles as a
+        // list too
+        uint32 meshlet = 0;
+        uint64 indices = 0;
+        for (uint32 i = 0; i < streamer.PageCount(mesh.Value(), 0, 0); ++i)
+        {
+            const GeometryPage page = streamer.Page(mesh.Value(), 0, 0, i);
+            CHECK(page.meshlets.Size() <= 4);
+            uint64 corner = 0;
+            for (const CookedMeshlet& paged : page.meshlets)
+            {
+                const CookedMeshlet& source = cooked.Meshlets()[submesh.meshletOffset + meshlet];
+                REQUIRE(paged.vertexCount == source.vertexCount);
+                REQUIRE(paged.triangleCount == source.triangleCount);
+                for (uint32 t = 0; t < source.triangleCount * 3; ++t)
+                {
+                    const uint8 local = cooked.MeshletTriangles()[source.triangleOffset * 3 + t];
+                    const uint32 source_vertex =
+                        cooked.MeshletVertices()[source.vertexOffset + local];
+                    const uint8 paged_local = page.meshletTriangles[paged.triangleOffset * 3 + t];
+                    const uint32 paged_vertex =
+                        page.meshletVertices[paged.vertexOffset + paged_local];
+                    CHECK(paged_local == local);
+                    CHECK(page.indices[corner++] == paged_vertex);
+                    CHECK(SameVertex(page.vertices[paged_vertex], vertices[source_vertex]));
+                }
+                ++meshlet;
+            }
+            CHECK(corner == page.indices.Size());
+            indices += page.indices.Size();
+        }
+        CHECK(meshlet == submesh.meshletCount);
+        CHECK(indices == lods[0].indexCount);
+
+        const GeometryStreamerStats stats = streamer.Stats();
+        CHECK(stats.lodsRead == coarsest);
+        CHECK(stats.failedReads == 0);
+        CHECK(stats.residentBytes > 0);
+    }
+
+    TEST_CASE("SelectLods' picks drive it, and the budget drops what was asked for least recently")
+    {
+        Fixture fixture;
+        WritePack();
+
+        // Room for one submesh's lods and no more
+        uint64 one_submesh = 0;
+        {
+            Result<UniquePtr<GeometryStreamer>> created =
+                GeometryStreamer::Create(*fixture.io, kPackPath);
+            REQUIRE(created);
+            GeometryStreamer& streamer = *created.Value();
+            REQUIRE(streamer.Open("hills"));
+            Settle(streamer, [&]() { streamer.Request(0, 0, 0); });
+            one_submesh = streamer.Stats().residentBytes;
+        }
+
+        GeometryStreamerOptions options;
+        options.budget = one_submesh;
+        Result<UniquePtr<GeometryStreamer>> created =
+            GeometryStreamer::Create(*fixture.io, kPackPath, options);
+        REQUIRE(created);
+        GeometryStreamer& streamer = *created.Value();
+        REQUIRE(streamer.Open("hills"));
+        const uint32 coarsest = streamer.Submeshes(0)[0].lodCount - 1;
+
+        // A camera right up against the first submesh's instances picks its full detail, from far
+        // away the second's stay coarse
+        LodSelection near;
+        near.cameraPosition = float3(16.0f, 0.0f, 16.0f);
+        near.projectionScale = 1000.0f;
+        LodSelection far = near;
+        far.cameraPosition = float3(16.0f, 0.0f, 1.0e6f);
+        const Sphere bounds[2] = {{float3(16.0f, 0.0f, 16.0f), 23.0f},
+                                  {float3(16.0f, 0.0f, 48.0f), 23.0f}};
+        const float scales[2] = {1.0f, 1.0f};
+        uint8 levels[2] = {};
+        auto select = [&](uint32 submesh, const LodSelection& selection) {
+            SelectLods(levels, streamer.Lods(0, submesh), bounds, scales, selection);
+            streamer.RequestFromLods(0, submesh, levels);
+        };
+        Settle(streamer, [&]() {
+            select(0, near);
+            select(1, far);
+        });
+        CHECK(streamer.ResidentLod(0, 0) == 0);
+        CHECK(streamer.ResidentLod(0, 1) == coarsest);
+
+        // Still wanted, so the second can't have any
+        Settle(streamer, [&]() {
+            select(0, near);
+            streamer.Request(0, 1, 0);
+        });
+        CHECK(streamer.ResidentLod(0, 0) == 0);
+        CHECK(streamer.ResidentLod(0, 1) == coarsest);
+        CHECK(streamer.Stats().overBudgetUpdates > 0);
+
+        // Once the first isn't picked any more it gives way
+        Settle(streamer, [&]() { streamer.Request(0, 1, 0); });
+        CHECK(streamer.ResidentLod(0, 0) == coarsest);
+        CHECK(streamer.ResidentLod(0, 1) == 0);
+        CHECK(!streamer.Page(0, 1, 0, 0).indices.IsEmpty());
+        CHECK(streamer.Page(0, 0, 0, 0).indices.IsEmpty());
+
+        const GeometryStreamerStats stats = streamer.Stats();
+        CHECK(stats.lodsEvicted == coarsest);
+        CHECK(stats.residentBytes <= options.budget);
+        CHECK(stats.failedReads == 0);
+    }
+
+    TEST_CASE("Tables and pages that aren't streamed meshes fail to open")
+    {
+        Fixture fixture;
+        {
+            Result<UniquePtr<PackWriter>> pack = PackWriter::Create(kPackPath);
+            REQUIRE(pack);
+            REQUIRE(pack.Value()->Add("junk", AsBytes("not a streamed mesh", 19)));
+            REQUIRE(pack.Value()->Finish());
+        }
+        Result<UniquePtr<GeometryStreamer>> created =
+            GeometryStreamer::Create(*fixture.io, kPackPath);
+        REQUIRE(created);
+        CHECK(created.Value()->Open("junk").Category() == ErrorCategory::InvalidArgument);
+        CHECK(created.Value()->MeshCount() == 0);
+
+        GeometryStreamerOptions no_reads;
+        no_reads.maxReadsInFlight = 0;
+        CHECK(!GeometryStreamer::Create(*fixture.io, kPackPath, no_reads));
+        CHECK(!GeometryStreamer::Create(*fixture.io, "missing.rpak"));
+
+        StreamedGeometryOptions no_meshlets;
+        no_meshlets.meshletsPerPage = 0;
+        {
+            Result<UniquePtr<MeshCooker>> cooker = MeshCooker::Create();
+            REQUIRE(cooker);
+            cooker.Value()->BeginMesh();
+            REQUIRE(cooker.Value()->AddPrimitive(Hills(2).Input()));
+            REQUIRE(cooker.Value()->Write(kMeshPath));
+        }
+        Result<UniquePtr<CookedMesh>> mesh = CookedMesh::Open(kMeshPath);
+        REQUIRE(mesh);
+        Result<UniquePtr<PackWriter>> pack = PackWriter::Create("rsbl-geometry-streamer-2.rpak");
+        REQUIRE(pack);
+        CHECK(WriteStreamedGeometry(*pack.Value(), "hills", *mesh.Value(), no_meshlets)
+                  .Category() == ErrorCategory::InvalidArgument);
+        pack.Value().Reset();
+        std::remove("rsbl-geometry-streamer-2.rpak");
+    }
+}
@@ -0,0 +1,509 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-image-codecs.h"
+
+#include <cstring>
+
+// Every BCn block stores two endpoints and, per pixel, an index to a point on the line between
+// them. Picking endpoints is the whole problem: the encoders here take the block's principal
+// axis, put the endpoints at the outermost pixels along it, assign each pixel its nearest
+// point, then refit the endpoints to those assignments with least squares once and keep
+// whichever of the two came out closer. That's the quality of the fast presets in the usual
+// encoders, without their search over BC7's partitioned modes; BC7 is mode 6 only, one subset
+// with 16 levels and alpha alongside color.
+
+namespace rsbl
+{
+namespace image
+{
+
+namespace
+{
+constexpr uint32 kBlockPixels = 16;
+
+// BC7's 4 bit interpolation weights, out of 64
+constexpr uint32 kBc7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct Block
+{
+    float pixels[kBlockPixels][4];
+};
+
+Block LoadBlock(const uint8* pixels, uint64 stride)
+{
+    Block block;
+    for (uint32 y = 0; y < 4; ++y)
+    {
+        for (uint32 x = 0; x < 4; ++x)
+        {
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                block.pixels[y * 4 + x][c] = pixels[y * stride + x * 4 + c];
+            }
+        }
+    }
+    return block;
+}
+
+float Clamp255(float value)
+{
+    return value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+}
+
+float Distance(const float* a, const float* b, uint32 channels)
+{
+    float sum = 0.0f;
+    for (uint32 c = 0; c < channels; ++c)
+    {
+        const float d = a[c] - b[c];
+        sum += d * d;
+    }
+    return sum;
+}
+
+// Endpoints at the block's extremes along its principal axis, found by power iteration on the
+// covariance of the first channels
+void PrincipalEndpoints(const Block& block, uint32 channels, float low[4], float high[4])
+{
+    float mean[4] = {};
+    for (const auto& pixel : block.pixels)
+    {
+        for (uint32 c = 0; c < channels; ++c)
+        {
+            mean[c] += pixel[c] / kBlockPixels;
+        }
+    }
+    float covariance[4][4] = {};
+    for (const auto& pixel : block.pixels)
+    {
+        for (uint32 i = 0; i < channels; ++i)
+        {
+            for (uint32 j = 0; j < channels; ++j)
+            {
+                covariance[i][j] += (pixel[i] - mean[i]) * (pixel[j] - mean[j]);
+            }
+        }
+    }
+
+    // Starting from the row with the most variance keeps the start from being orthogonal to
+    // the answer
+    uint32 widest = 0;
+    for (uint32 c = 1; c < channels; ++c)
+    {
+        if (covariance[c][c] > covariance[widest][widest])
+        {
+            widest = c;
+        }
+    }
+    float axis[4] = {};
+    for (uint32 c = 0; c < channels; ++c)
+    {
+        axis[c] = covariance[widest][c];
+    }
+    for (uint32 iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[4] = {};
+        float largest = 0.0f;
+        for (uint32 i = 0; i < channels; ++i)
+        {
+            for (uint32 j = 0; j < channels; ++j)
+            {
+                next[i] += covariance[i][j] * axis[j];
+            }
+            const float magnitude = next[i] < 0.0f ? -next[i] : next[i];
+            largest = magnitude > largest ? magnitude : largest;
+        }
+        if (largest == 0.0f)
+        {
+            break;
+        }
+        for (uint32 c = 0; c < channels; ++c)
+        {
+            axis[c] = next[c] / largest;
+        }
+    }
+
+    float min_t = 0.0f;
+    float max_t = 0.0f;
+    float length = 0.0f;
+    for (uint32 c = 0; c < channels; ++c)
+    {
+        length += axis[c] * axis[c];
+    }
+    for (const auto& pixel : block.pixels)
+    {
+        float t = 0.0f;
+        for (uint32 c = 0; c < channels; ++c)
+        {
+            t += (pixel[c] - mean[c]) * axis[c];
+        }
+        min_t = t < min_t ? t : min_t;
+        max_t = t > max_t ? t : max_t;
+    }
+    // A flat block has no axis, both endpoints are its color
+    const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+    for (uint32 c = 0; c < channels; ++c)
+    {
+        low[c] = Clamp255(mean[c] + axis[c] * min_t * scale);
+        high[c] = Clamp255(mean[c] + axis[c] * max_t * scale);
+    }
+}
+
+// Least squares endpoints for pixels given where along the line from low (0) to high (1) each
+// sits. False when every pixel sits at the same point, which leaves nothing to fit.
+bool FitEndpoints(
+    const Block& block, const float* positions, uint32 channels, float low[4], float high[4])
+{
+    float aa = 0.0f;
+    float ab = 0.0f;
+    float bb = 0.0f;
+    float low_sum[4] = {};
+    float high_sum[4] = {};
+    for (uint32 i = 0; i < kBlockPixels; ++i)
+    {
+        const float t = positions[i];
+        const float s = 1.0f - t;
+        aa += s * s;
+        ab += s * t;
+        bb += t * t;
+        for (uint32 c = 0; c < channels; ++c)
+        {
+            low_sum[c] += s * block.pixels[i][c];
+            high_sum[c] += t * block.pixels[i][c];
+        }
+    }
+    const float determinant = aa * bb - ab * ab;
+    if (determinant < 1e-6f)
+    {
+        return false;
+    }
+    for (uint32 c = 0; c < channels; ++c)
+    {
+        low[c] = Clamp255((bb * low_sum[c] - ab * high_sum[c]) / determinant);
+        high[c] = Clamp255((aa * high_sum[c] - ab * low_sum[c]) / determinant);
+    }
+    return true;
+}
+
+void WriteLittleEndian16(uint8* out, uint32 value)
+{
+    out[0] = static_cast<uint8>(value);
+    out[1] = static_cast<uint8>(value >> 8);
+}
+
+//
+// BC1
+//
+
+uint32 To565(const float* color)
+{
+    const uint32 r = static_cast<uint32>(color[0] * 31.0f / 255.0f + 0.5f);
+    const uint32 g = static_cast<uint32>(color[1] * 63.0f / 255.0f + 0.5f);
+    const uint32 b = static_cast<uint32>(color[2] * 31.0f / 255.0f + 0.5f);
+    return (r << 11) | (g << 5) | b;
+}
+
+// What a decoder expands a 565 color to
+void From565(uint32 packed, float* color)
+{
+    const uint32 r = (packed >> 11) & 31;
+    const uint32 g = (packed >> 5) & 63;
+    const uint32 b = packed & 31;
+    color[0] = static_cast<float>((r << 3) | (r >> 2));
+    color[1] = static_cast<float>((g << 2) | (g >> 4));
+    color[2] = static_cast<float>((b << 3) | (b >> 2));
+}
+
+struct Bc1Encoding
+{
+    uint32 color0 = 0;
+    uint32 color1 = 0;
+    uint32 indices = 0;
+    float error = 0.0f;
+    // Each pixel's place between color1 (0) and color0 (1), for refitting
+    float positions[kBlockPixels] = {};
+};
+
+// Four color mode, which needs color0 > color1. Equal endpoints decode in three color mode,
+// where index 0 is still color0, so every index is 0.
+Bc1Encoding EncodeBc1(const Block& block, const float low[4], const float high[4])
+{
+    Bc1Encoding encoding;
+    encoding.color0 = To565(high);
+    encoding.color1 = To565(low);
+    if (encoding.color0 < encoding.color1)
+    {
+        const uint32 swap = encoding.color0;
+        encoding.color0 = encoding.color1;
+        encoding.color1 = swap;
+    }
+
+    float palette[4][3];
+    From565(encoding.color0, palette[0]);
+    From565(encoding.color1, palette[1]);
+    const uint32 palette_size = encoding.color0 == encoding.color1 ? 1 : 4;
+    for (uint32 c = 0; c < 3; ++c)
+    {
+        palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+        palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+    }
+    constexpr float kPositions[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+    for (uint32 i = 0; i < kBlockPixels; ++i)
+    {
+        uint32 best = 0;
+        float best_error = Distance(block.pixels[i], palette[0], 3);
+        for (uint32 p = 1; p < palette_size; ++p)
+        {
+            const float error = Distance(block.pixels[i], palette[p], 3);
+            if (error < best_error)
+            {
+                best = p;
+                best_error = error;
+            }
+        }
+        encoding.indices |= best << (i * 2);
+        encoding.error += best_error;
+        encoding.positions[i] = kPositions[best];
+    }
+    return encoding;
+}
+
+//
+// BC4, two of which make BC5
+//
+
+void CompressBc4(const uint8 values[kBlockPixels], uint8* out)
+{
+    uint32 low = 255;
+    uint32 high = 0;
+    for (uint32 i = 0; i < kBlockPixels; ++i)
+    {
+        low = values[i] < low ? values[i] : low;
+        high = values[i] > high ? values[i] : high;
+    }
+
+    // red0 > red1 picks the mode with six points between them rather than four and 0 and 255.
+    // Index 0 is red0, 1 is red1, and 2 to 7 step from red0 towards red1.
+    out[0] = static_cast<uint8>(high);
+    out[1] = static_cast<uint8>(low);
+    uint32 palette[8] = {high, low};
+    for (uint32 i = 2; i < 8; ++i)
+    {
+        palette[i] = ((8 - i) * high + (i - 1) * low + 3) / 7;
+    }
+
+    uint64 indices = 0;
+    if (high != low)
+    {
+        for (uint32 i = 0; i < kBlockPixels; ++i)
+        {
+            uint32 best = 0;
+            uint32 best_error = 256;
+            for (uint32 p = 0; p < 8; ++p)
+            {
+                const uint32 error =
+                    values[i] > palette[p] ? values[i] - palette[p] : palette[p] - values[i];
+                if (error < best_error)
+                {
+                    best = p;
+                    best_error = error;
+                }
+            }
+            indices |= static_cast<uint64>(best) << (i * 3);
+        }
+    }
+    for (uint32 i = 0; i < 6; ++i)
+    {
+        out[2 + i] = static_cast<uint8>(indices >> (i * 8));
+    }
+}
+
+//
+// BC7 mode 6
+//
+
+struct Bc7Encoding
+{
+    uint32 endpoints[2][4] = {};
+    uint32 pbits[2] = {};
+    uint32 indices[kBlockPixels] = {};
+    float error = 0.0f;
+    float positions[kBlockPixels] = {};
+};
+
+// The closest 7 bit value and p-bit pair to color, the two making an 8 bit value. The p-bit is
+// shared by the endpoint's channels, so it's chosen for all four at once.
+void QuantizeBc7Endpoint(const float* color, uint32 quantized[4], uint32& pbit)
+{
+    float best_error = 0.0f;
+    for (uint32 p = 0; p < 2; ++p)
+    {
+        uint32 candidate[4];
+        float error = 0.0f;
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            const float scaled = (color[c] - static_cast<float>(p)) / 2.0f + 0.5f;
+            const uint32 value = scaled <= 0.0f ? 0 : static_cast<uint32>(scaled);
+            candidate[c] = value > 127 ? 127 : value;
+            const float d = static_cast<float>(candidate[c] * 2 + p) - color[c];
+            error += d * d;
+        }
+        if (p == 0 || error < best_error)
+        {
+            best_error = error;
+            pbit = p;
+            std::memcpy(quantized, candidate, sizeof(candidate));
+        }
+    }
+}
+
+Bc7Encoding EncodeBc7(const Block& block, const float low[4], const float high[4])
+{
+    Bc7Encoding encoding;
+    QuantizeBc7Endpoint(low, encoding.endpoints[0], encoding.pbits[0]);
+    QuantizeBc7Endpoint(high, encoding.endpoints[1], encoding.pbits[1]);
+
+    float palette[16][4];
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            const uint32 a = encoding.endpoints[0][c] * 2 + encoding.pbits[0];
+            const uint32 b = encoding.endpoints[1][c] * 2 + encoding.pbits[1];
+            palette[i][c] =
+                static_cast<float>(((64 - kBc7Weights[i]) * a + kBc7Weights[i] * b + 32) >> 6);
+        }
+    }
+
+    for (uint32 i = 0; i < kBlockPixels; ++i)
+    {
+        uint32 best = 0;
+        float best_error = Distance(block.pixels[i], palette[0], 4);
+        for (uint32 p = 1; p < 16; ++p)
+        {
+            const float error = Distance(block.pixels[i], palette[p], 4);
+            if (error < best_error)
+            {
+                best = p;
+                best_error = error;
+            }
+        }
+        encoding.indices[i] = best;
+        encoding.error += best_error;
+        encoding.positions[i] = static_cast<float>(kBc7Weights[best]) / 64.0f;
+    }
+    return encoding;
+}
+
+// Least significant bit first, which is how every BC7 field is laid out
+void WriteBits(uint8* out, uint32& position, uint32 value, uint32 count)
+{
+    for (uint32 i = 0; i < count; ++i, ++position)
+    {
+        if ((value >> i) & 1)
+        {
+            out[position >> 3] |= static_cast<uint8>(1u << (position & 7));
+        }
+    }
+}
+} // namespace
+
+void CompressBc1Block(const uint8* pixels, uint64 stride, uint8* out)
+{
+    const Block block = LoadBlock(pixels, stride);
+    float low[4];
+    float high[4];
+    PrincipalEndpoints(block, 3, low, high);
+    Bc1Encoding encoding = EncodeBc1(block, low, high);
+
+    // positions go from color1 to color0
+    if (encoding.color0 != encoding.color1 && FitEndpoints(block, encoding.positions, 3, low, high))
+    {
+        const Bc1Encoding refit = EncodeBc1(block, low, high);
+        if (refit.error < encoding.error)
+        {
+            encoding = refit;
+        }
+    }
+
+    WriteLittleEndian16(out, encoding.color0);
+    WriteLittleEndian16(out + 2, encoding.color1);
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        out[4 + i] = static_cast<uint8>(encoding.indices >> (i * 8));
+    }
+}
+
+void CompressBc5Block(const uint8* pixels, uint64 stride, uint8* out)
+{
+    uint8 red[kBlockPixels];
+    uint8 green[kBlockPixels];
+    for (uint32 y = 0; y < 4; ++y)
+    {
+        for (uint32 x = 0; x < 4; ++x)
+        {
+            red[y * 4 + x] = pixels[y * stride + x * 4];
+            green[y * 4 + x] = pixels[y * stride + x * 4 + 1];
+        }
+    }
+    CompressBc4(red, out);
+    CompressBc4(green, out + 8);
+}
+
+void CompressBc7Block(const uint8* pixels, uint64 stride, uint8* out)
+{
+    const Block block = LoadBlock(pixels, stride);
+    float low[4];
+    float high[4];
+    PrincipalEndpoints(block, 4, low, high);
+    Bc7Encoding encoding = EncodeBc7(block, low, high);
+    if (FitEndpoints(block, encoding.positions, 4, low, high))
+    {
+        const Bc7Encoding refit = EncodeBc7(block, low, high);
+        if (refit.error < encoding.error)
+        {
+            encoding = refit;
+        }
+    }
+
+    // The first pixel's index drops its top bit, so it has to be under 8. Swapping the
+    // endpoints flips every index to get there.
+    if (encoding.indices[0] >= 8)
+    {
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            const uint32 swap = encoding.endpoints[0][c];
+            encoding.endpoints[0][c] = encoding.endpoints[1][c];
+            encoding.endpoints[1][c] = swap;
+        }
+        const uint32 swap = encoding.pbits[0];
+        encoding.pbits[0] = encoding.pbits[1];
+        encoding.pbits[1] = swap;
+        for (uint32& index : encoding.indices)
+        {
+            index = 15 - index;
+        }
+    }
+
+    // Mode 6 is a 1 after six 0s, then each channel's two endpoints, the p-bits and the indices
+    std::memset(out, 0, 16);
+    uint32 position = 0;
+    WriteBits(out, position, 1u << 6, 7);
+    for (uint32 c = 0; c < 4; ++c)
+    {
+        WriteBits(out, position, encoding.endpoints[0][c], 7);
+        WriteBits(out, position, encoding.endpoints[1][c], 7);
+    }
+    WriteBits(out, position, encoding.pbits[0], 1);
+    WriteBits(out, position, encoding.pbits[1], 1);
+    WriteBits(out, position, encoding.indices[0], 3);
+    for (uint32 i = 1; i < kBlockPixels; ++i)
+    {
+        WriteBits(out, position, encoding.indices[i], 4);
+    }
+}
+
+} // namespace image
+} // namespace rsbl
@@ -0,0 +1,29 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-image.h>
+
+// Internal header between rsbl-image.cpp and the codecs it dispatches to
+
+namespace rsbl
+{
+namespace image
+{
+
+    // Images past this on a side are corrupt headers rather than textures. Decoders check it
+    // before allocating anything.
+    constexpr uint32 kMaxImageSide = 1u << 15;
+
+    // Both decode to RGBA8, file has already been matched by DetectImageFileType
+    Result<> DecodePng(ByteView file, Image& out);
+    Result<> DecodeJpeg(ByteView file, Image& out);
+
+    // One 4x4 block of RGBA8 pixels, rows stride bytes apart, to 8 bytes (BC1) or 16 (BC5, BC7)
+    void CompressBc1Block(const uint8* pixels, uint64 stride, uint8* out);
+    void CompressBc5Block(const uint8* pixels, uint64 stride, uint8* out);
+    void CompressBc7Block(const uint8* pixels, uint64 stride, uint8* out);
+
+} // namespace image
+} // namespace rsbl
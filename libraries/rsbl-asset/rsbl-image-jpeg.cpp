@@ -0,0 +1,996 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-image-codecs.h"
+
+#include <rsbl-ptr.h>
+#include <rsbl-simd-config.h>
+
+#include <cmath>
+#include <cstring>
+
+// Baseline JPEG: marker segments carrying the quantization and Huffman tables and the frame
+// layout, then one or more scans of Huffman coded 8x8 blocks of DCT coefficients. Each
+// component is decoded into its own plane at its own resolution, then the planes are upsampled
+// and converted to RGBA a row at a time. The inverse DCT and the color conversion are the bulk
+// of the time after entropy decoding, and both have SIMD paths.
+
+namespace rsbl
+{
+namespace image
+{
+
+namespace
+{
+constexpr uint32 kMaxComponents = 3;
+constexpr uint32 kMaxSampling = 4;
+constexpr uint32 kHuffmanFastBits = 9;
+
+// Magnitude categories 8 bit samples can produce, anything bigger is corrupt
+constexpr uint32 kMaxDcBits = 11;
+constexpr uint32 kMaxAcBits = 10;
+
+// Coefficients come in zigzag order, this maps each to its place in the block
+constexpr uint8 kZigzag[64] = {
+    0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,  12, 19, 26, 33, 40, 48,
+    41, 34, 27, 20, 13, 6,  7,  14, 21, 28, 35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23,
+    30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+
+// basis[u][x] = c(u) / 2 * cos((2x + 1) u pi / 16), with c(0) = 1 / sqrt(2), so the 2D inverse
+// DCT is basis transposed * coefficients * basis
+struct IdctBasis
+{
+    alignas(16) float rows[8][8];
+};
+
+IdctBasis BuildIdctBasis()
+{
+    IdctBasis basis;
+    for (uint32 u = 0; u < 8; ++u)
+    {
+        const double scale = (u == 0 ? 1.0 / std::sqrt(2.0) : 1.0) / 2.0;
+        for (uint32 x = 0; x < 8; ++x)
+        {
+            const double angle = (2 * x + 1) * u * 3.14159265358979323846 / 16;
+            basis.rows[u][x] = static_cast<float>(scale * std::cos(angle));
+        }
+    }
+    return basis;
+}
+
+const IdctBasis kIdctBasis = BuildIdctBasis();
+
+struct JpegHuffman
+{
+    bool defined = false;
+    // (length << 8) | symbol for codes up to kHuffmanFastBits long, 0 where the code is longer
+    uint16 fast[1 << kHuffmanFastBits];
+    // For each length, the largest code of that length (-1 for none), and what to add to a code
+    // of that length to get its index into symbols
+    int32 maxCode[17];
+    int32 delta[17];
+    uint8 symbols[256];
+};
+
+struct JpegComponent
+{
+    uint8 id = 0;
+    uint32 horizontal = 1;
+    uint32 vertical = 1;
+    uint32 quantTable = 0;
+    uint32 dcTable = 0;
+    uint32 acTable = 0;
+    int32 dcPrediction = 0;
+
+    // Whole MCUs' worth, so blocks past the image edge have somewhere to go
+    DynamicArray<uint8> plane;
+    uint32 planeWidth = 0;
+    uint32 planeHeight = 0;
+};
+
+struct JpegDecoder
+{
+    const uint8* end = nullptr;
+
+    uint16 quant[4][64];
+    bool quantDefined[4] = {};
+    JpegHuffman dc[4];
+    JpegHuffman ac[4];
+    uint32 restartInterval = 0;
+
+    bool seenFrame = false;
+    uint32 width = 0;
+    uint32 height = 0;
+    JpegComponent components[kMaxComponents];
+    uint32 componentCount = 0;
+    uint32 maxHorizontal = 1;
+    uint32 maxVertical = 1;
+    uint32 mcusX = 0;
+    uint32 mcusY = 0;
+    uint32 scans = 0;
+
+    // From Adobe's APP14 marker, -1 without one. 0 means the three components are RGB.
+    int32 adobeTransform = -1;
+};
+
+// Entropy coded data, most significant bit first. 0xff bytes are followed by a 0 to tell them
+// from markers, and a marker ends the data, after which zeros are fed in.
+class JpegBits
+{
+  public:
+    JpegBits(const uint8* data, const uint8* end)
+        : m_data(data)
+        , m_end(end)
+    {
+    }
+
+    void Refill()
+    {
+        while (m_count <= 56)
+        {
+            uint32 byte = 0;
+            if (!m_atMarker && m_data < m_end)
+            {
+                byte = *m_data;
+                if (byte != 0xff)
+                {
+                    ++m_data;
+                }
+                else if (m_data + 1 < m_end && m_data[1] == 0)
+                {
+                    m_data += 2;
+                }
+                else
+                {
+                    m_atMarker = true;
+                    byte = 0;
+                }
+            }
+            m_buffer |= static_cast<uint64>(byte) << (56 - m_count);
+            m_count += 8;
+        }
+    }
+
+    uint32 Peek(uint32 bits) const
+    {
+        return static_cast<uint32>(m_buffer >> (64 - bits));
+    }
+
+    void Consume(uint32 bits)
+    {
+        m_buffer <<= bits;
+        m_count -= bits;
+    }
+
+    uint32 Read(uint32 bits)
+    {
+        if (bits == 0)
+        {
+            return 0;
+        }
+        if (m_count < bits)
+        {
+            Refill();
+        }
+        const uint32 value = Peek(bits);
+        Consume(bits);
+        return value;
+    }
+
+    // A bits long magnitude category value, the top bit clear meaning negative
+    int32 ReadSigned(uint32 bits)
+    {
+        const int32 value = static_cast<int32>(Read(bits));
+        return bits != 0 && value < (1 << (bits - 1)) ? value - (1 << bits) + 1 : value;
+    }
+
+    // Drops what's buffered and steps over the next RSTn marker
+    bool Restart()
+    {
+        m_buffer = 0;
+        m_count = 0;
+        m_atMarker = false;
+        while (m_data + 1 < m_end &&
+               !(m_data[0] == 0xff && m_data[1] >= 0xd0 && m_data[1] <= 0xd7))
+        {
+            ++m_data;
+        }
+        if (m_data + 1 >= m_end)
+        {
+            return false;
+        }
+        m_data += 2;
+        return true;
+    }
+
+    // Where the marker after the entropy coded data starts, or the end for a file cut short
+    const uint8* MarkerPosition() const
+    {
+        for (const uint8* position = m_data; position + 1 < m_end; ++position)
+        {
+            const uint8 next = position[1];
+            if (position[0] == 0xff && next != 0 && (next < 0xd0 || next > 0xd7))
+            {
+                return position;
+            }
+        }
+        return m_end;
+    }
+
+  private:
+    const uint8* m_data;
+    const uint8* m_end;
+    uint64 m_buffer = 0;
+    uint32 m_count = 0;
+    bool m_atMarker = false;
+};
+
+bool BuildHuffman(JpegHuffman& table, const uint8* counts, const uint8* symbols, uint32 total)
+{
+    std::memset(table.fast, 0, sizeof(table.fast));
+    std::memcpy(table.symbols, symbols, total);
+
+    uint32 code = 0;
+    uint32 index = 0;
+    for (uint32 length = 1; length <= 16; ++length)
+    {
+        table.delta[length] = static_cast<int32>(index) - static_cast<int32>(code);
+        for (uint32 i = 0; i < counts[length - 1]; ++i, ++code, ++index)
+        {
+            if (code >= (1u << length))
+            {
+                return false;
+            }
+            if (length <= kHuffmanFastBits)
+            {
+                const uint32 first = code << (kHuffmanFastBits - length);
+                const uint32 fill = 1u << (kHuffmanFastBits - length);
+                for (uint32 j = 0; j < fill; ++j)
+                {
+                    table.fast[first + j] = static_cast<uint16>((length << 8) | symbols[index]);
+                }
+            }
+        }
+        table.maxCode[length] = counts[length - 1] != 0 ? static_cast<int32>(code) - 1 : -1;
+        code <<= 1;
+    }
+    table.defined = true;
+    return true;
+}
+
+// The next symbol, or -1 for a code that isn't in the table
+int32 DecodeHuffman(JpegBits& bits, const JpegHuffman& table)
+{
+    bits.Refill();
+    const uint16 entry = table.fast[bits.Peek(kHuffmanFastBits)];
+    if (entry != 0)
+    {
+        bits.Consume(entry >> 8);
+        return entry & 0xff;
+    }
+    for (uint32 length = kHuffmanFastBits + 1; length <= 16; ++length)
+    {
+        const int32 code = static_cast<int32>(bits.Peek(length));
+        if (code <= table.maxCode[length])
+        {
+            bits.Consume(length);
+            return table.symbols[code + table.delta[length]];
+        }
+    }
+    return -1;
+}
+
+// coefficients are dequantized and in natural order. Writes 8 rows of 8 pixels.
+void InverseDct(const float* coefficients, uint8* out, uint64 stride)
+{
+    // rows[v] = coefficients[v] * basis, then out[y] = sum over v of basis[v][y] * rows[v]
+    alignas(16) float rows[8][8];
+#if RSBL_SIMD_SSE
+    for (uint32 v = 0; v < 8; ++v)
+    {
+        __m128 low = _mm_setzero_ps();
+        __m128 high = _mm_setzero_ps();
+        for (uint32 u = 0; u < 8; ++u)
+        {
+            const float coefficient = coefficients[v * 8 + u];
+            if (coefficient == 0.0f)
+            {
+                continue;
+            }
+            const __m128 scale = _mm_set1_ps(coefficient);
+            low = _mm_add_ps(low, _mm_mul_ps(scale, _mm_load_ps(kIdctBasis.rows[u])));
+            high = _mm_add_ps(high, _mm_mul_ps(scale, _mm_load_ps(kIdctBasis.rows[u] + 4)));
+        }
+        _mm_store_ps(rows[v], low);
+        _mm_store_ps(rows[v] + 4, high);
+    }
+    for (uint32 y = 0; y < 8; ++y)
+    {
+        __m128 low = _mm_set1_ps(128.0f);
+        __m128 high = low;
+        for (uint32 v = 0; v < 8; ++v)
+        {
+            const __m128 scale = _mm_set1_ps(kIdctBasis.rows[v][y]);
+            low = _mm_add_ps(low, _mm_mul_ps(scale, _mm_load_ps(rows[v])));
+            high = _mm_add_ps(high, _mm_mul_ps(scale, _mm_load_ps(rows[v] + 4)));
+        }
+        // The saturating packs clamp to 0-255
+        const __m128i words = _mm_packs_epi32(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + y * stride),
+                         _mm_packus_epi16(words, words));
+    }
+#elif RSBL_SIMD_NEON
+    for (uint32 v = 0; v < 8; ++v)
+    {
+        float32x4_t low = vdupq_n_f32(0.0f);
+        float32x4_t high = vdupq_n_f32(0.0f);
+        for (uint32 u = 0; u < 8; ++u)
+        {
+            const float coefficient = coefficients[v * 8 + u];
+            if (coefficient == 0.0f)
+            {
+                continue;
+            }
+            low = vmlaq_n_f32(low, vld1q_f32(kIdctBasis.rows[u]), coefficient);
+            high = vmlaq_n_f32(high, vld1q_f32(kIdctBasis.rows[u] + 4), coefficient);
+        }
+        vst1q_f32(rows[v], low);
+        vst1q_f32(rows[v] + 4, high);
+    }
+    for (uint32 y = 0; y < 8; ++y)
+    {
+        float32x4_t low = vdupq_n_f32(128.0f);
+        float32x4_t high = low;
+        for (uint32 v = 0; v < 8; ++v)
+        {
+            const float scale = kIdctBasis.rows[v][y];
+            low = vmlaq_n_f32(low, vld1q_f32(rows[v]), scale);
+            high = vmlaq_n_f32(high, vld1q_f32(rows[v] + 4), scale);
+        }
+        const int16x8_t words = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(low)),
+                                             vqmovn_s32(vcvtnq_s32_f32(high)));
+        vst1_u8(out + y * stride, vqmovun_s16(words));
+    }
+#else
+    for (uint32 v = 0; v < 8; ++v)
+    {
+        for (uint32 x = 0; x < 8; ++x)
+        {
+            float sum = 0.0f;
+            for (uint32 u = 0; u < 8; ++u)
+            {
+                sum += coefficients[v * 8 + u] * kIdctBasis.rows[u][x];
+            }
+            rows[v][x] = sum;
+        }
+    }
+    for (uint32 y = 0; y < 8; ++y)
+    {
+        for (uint32 x = 0; x < 8; ++x)
+        {
+            float sum = 128.0f;
+            for (uint32 v = 0; v < 8; ++v)
+            {
+                sum += kIdctBasis.rows[v][y] * rows[v][x];
+            }
+            const float clamped = sum < 0.0f ? 0.0f : (sum > 255.0f ? 255.0f : sum);
+            out[y * stride + x] = static_cast<uint8>(clamped + 0.5f);
+        }
+    }
+#endif
+}
+
+Result<> DecodeBlock(JpegDecoder& decoder,
+                     JpegBits& bits,
+                     JpegComponent& component,
+                     uint32 block_x,
+                     uint32 block_y)
+{
+    const JpegHuffman& dc = decoder.dc[component.dcTable];
+    const JpegHuffman& ac = decoder.ac[component.acTable];
+    const uint16* quant = decoder.quant[component.quantTable];
+
+    // Floats from here, which is what the inverse DCT wants, and which corrupt data can't
+    // overflow
+    float coefficients[64] = {};
+    const int32 dc_bits = DecodeHuffman(bits, dc);
+    if (dc_bits < 0 || dc_bits > static_cast<int32>(kMaxDcBits))
+    {
+        return {ErrorCategory::InvalidArgument, "JPEG DC code is invalid"};
+    }
+    // Kept in range so a long run of corrupt differences can't overflow it
+    const int32 prediction =
+        component.dcPrediction + bits.ReadSigned(static_cast<uint32>(dc_bits));
+    component.dcPrediction =
+        prediction < -65536 ? -65536 : (prediction > 65536 ? 65536 : prediction);
+    coefficients[0] = static_cast<float>(component.dcPrediction) * quant[0];
+
+    for (uint32 k = 1; k < 64;)
+    {
+        const int32 symbol = DecodeHuffman(bits, ac);
+        if (symbol < 0)
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG AC code is invalid"};
+        }
+        const uint32 run = static_cast<uint32>(symbol) >> 4;
+        const uint32 size = static_cast<uint32>(symbol) & 15;
+        if (size > kMaxAcBits)
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG AC code is invalid"};
+        }
+        if (size == 0)
+        {
+            if (run != 15)
+            {
+                break; // End of block, the rest are zero
+            }
+            k += 16;
+            continue;
+        }
+        k += run;
+        if (k > 63)
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG block has too many coefficients"};
+        }
+        const uint32 position = kZigzag[k];
+        coefficients[position] = static_cast<float>(bits.ReadSigned(size)) * quant[position];
+        ++k;
+    }
+
+    InverseDct(coefficients,
+               component.plane.Data() + block_y * 8 * component.planeWidth + block_x * 8,
+               component.planeWidth);
+    return ResultCode::Success;
+}
+
+uint16 ReadBigEndian16(const uint8* bytes)
+{
+    return static_cast<uint16>((bytes[0] << 8) | bytes[1]);
+}
+
+Result<> ReadQuantTables(JpegDecoder& decoder, const uint8* segment, uint32 length)
+{
+    while (length > 0)
+    {
+        const uint32 precision = segment[0] >> 4;
+        const uint32 id = segment[0] & 15;
+        const uint32 size = precision == 0 ? 64 : 128;
+        if (id > 3 || precision > 1 || length < 1 + size)
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG quantization table is invalid"};
+        }
+        for (uint32 k = 0; k < 64; ++k)
+        {
+            const uint16 value =
+                precision == 0 ? segment[1 + k] : ReadBigEndian16(segment + 1 + k * 2);
+            decoder.quant[id][kZigzag[k]] = value;
+        }
+        decoder.quantDefined[id] = true;
+        segment += 1 + size;
+        length -= 1 + size;
+    }
+    return ResultCode::Success;
+}
+
+Result<> ReadHuffmanTables(JpegDecoder& decoder, const uint8* segment, uint32 length)
+{
+    while (length > 0)
+    {
+        if (length < 17)
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG Huffman table is cut short"};
+        }
+        const uint32 table_class = segment[0] >> 4;
+        const uint32 id = segment[0] & 15;
+        const uint8* counts = segment + 1;
+        uint32 total = 0;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            total += counts[i];
+        }
+        if (table_class > 1 || id > 3 || total > 256 || length < 17 + total)
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG Huffman table is invalid"};
+        }
+        JpegHuffman& table = table_class == 0 ? decoder.dc[id] : decoder.ac[id];
+        if (!BuildHuffman(table, counts, segment + 17, total))
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG Huffman table has too many codes"};
+        }
+        segment += 17 + total;
+        length -= 17 + total;
+    }
+    return ResultCode::Success;
+}
+
+Result<> ReadFrame(JpegDecoder& decoder, const uint8* segment, uint32 length)
+{
+    if (decoder.seenFrame)
+    {
+        return {ErrorCategory::InvalidArgument, "JPEG has more than one frame"};
+    }
+    if (length < 6)
+    {
+        return {ErrorCategory::InvalidArgument, "JPEG frame header is cut short"};
+    }
+    const uint32 precision = segment[0];
+    decoder.height = ReadBigEndian16(segment + 1);
+    decoder.width = ReadBigEndian16(segment + 3);
+    decoder.componentCount = segment[5];
+    if (precision != 8)
+    {
+        return {ErrorCategory::InvalidArgument, "Only 8 bit JPEGs are supported"};
+    }
+    // A height of 0 is filled in by a DNL marker after the first scan, which nothing writes
+    if (decoder.width == 0 || decoder.height == 0 || decoder.width > kMaxImageSide ||
+        decoder.height > kMaxImageSide)
+    {
+        return {ErrorCategory::InvalidArgument, "JPEG is empty or too large"};
+    }
+    if (decoder.componentCount != 1 && decoder.componentCount != 3)
+    {
+        return {ErrorCategory::InvalidArgument, "Only grayscale and YCbCr JPEGs are supported"};
+    }
+    if (length < 6 + decoder.componentCount * 3)
+    {
+        return {ErrorCategory::InvalidArgument, "JPEG frame header is cut short"};
+    }
+
+    for (uint32 i = 0; i < decoder.componentCount; ++i)
+    {
+        JpegComponent& component = decoder.components[i];
+        const uint8* spec = segment + 6 + i * 3;
+        component.id = spec[0];
+        component.horizontal = spec[1] >> 4;
+        component.vertical = spec[1] & 15;
+        component.quantTable = spec[2];
+        if (component.horizontal == 0 || component.horizontal > kMaxSampling ||
+            component.vertical == 0 || component.vertical > kMaxSampling ||
+            component.quantTable > 3)
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG component is invalid"};
+        }
+        if (component.horizontal > decoder.maxHorizontal)
+        {
+            decoder.maxHorizontal = component.horizontal;
+        }
+        if (component.vertical > decoder.maxVertical)
+        {
+            decoder.maxVertical = component.vertical;
+        }
+    }
+    if (decoder.componentCount == 1)
+    {
+        // A lone component's MCU is one block, whatever sampling it claims
+        decoder.components[0].horizontal = 1;
+        decoder.components[0].vertical = 1;
+        decoder.maxHorizontal = 1;
+        decoder.maxVertical = 1;
+    }
+
+    decoder.mcusX = (decoder.width + 8 * decoder.maxHorizontal - 1) / (8 * decoder.maxHorizontal);
+    decoder.mcusY = (decoder.height + 8 * decoder.maxVertical - 1) / (8 * decoder.maxVertical);
+    for (uint32 i = 0; i < decoder.componentCount; ++i)
+    {
+        JpegComponent& component = decoder.components[i];
+        component.planeWidth = decoder.mcusX * component.horizontal * 8;
+        component.planeHeight = decoder.mcusY * component.vertical * 8;
+        component.plane.Resize(static_cast<uint64>(component.planeWidth) * component.planeHeight);
+    }
+    decoder.seenFrame = true;
+    return ResultCode::Success;
+}
+
+// Reads the scan header at segment, then the entropy coded data after it. Returns where the
+// next marker starts.
+Result<const uint8*> ReadScan(JpegDecoder& decoder, const uint8* segment, uint32 length)
+{
+    if (!decoder.seenFrame)
+    {
+        return {ErrorCategory::InvalidArgument, "JPEG scan comes before the frame"};
+    }
+    const uint32 count = length > 0 ? segment[0] : 0;
+    if (count == 0 || count > decoder.componentCount || length != 4 + count * 2)
+    {
+        return {ErrorCategory::InvalidArgument, "JPEG scan header is invalid"};
+    }
+
+    JpegComponent* scan_components[kMaxComponents] = {};
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const uint8 id = segment[1 + i * 2];
+        const uint8 tables = segment[2 + i * 2];
+        JpegComponent* found = nullptr;
+        for (uint32 c = 0; c < decoder.componentCount; ++c)
+        {
+            if (decoder.components[c].id == id)
+            {
+                found = &decoder.components[c];
+            }
+        }
+        if (found == nullptr)
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG scan names a missing component"};
+        }
+        found->dcTable = tables >> 4;
+        found->acTable = tables & 15;
+        if (found->dcTable > 3 || found->acTable > 3 || !decoder.dc[found->dcTable].defined ||
+            !decoder.ac[found->acTable].defined || !decoder.quantDefined[found->quantTable])
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG scan uses a missing table"};
+        }
+        found->dcPrediction = 0;
+        scan_components[i] = found;
+    }
+    const uint8* spectral = segment + 1 + count * 2;
+    if (spectral[0] != 0 || spectral[1] != 63 || spectral[2] != 0)
+    {
+        return {ErrorCategory::InvalidArgument, "JPEG scan isn't baseline"};
+    }
+
+    // With one component in the scan its MCU is a block, covering only the component's own
+    // pixels, otherwise each MCU holds horizontal x vertical blocks of every component
+    uint32 units_x = decoder.mcusX;
+    uint32 units_y = decoder.mcusY;
+    if (count == 1)
+    {
+        const JpegComponent& component = *scan_components[0];
+        const uint32 width =
+            (decoder.width * component.horizontal + decoder.maxHorizontal - 1) /
+            decoder.maxHorizontal;
+        const uint32 height =
+            (decoder.height * component.vertical + decoder.maxVertical - 1) / decoder.maxVertical;
+        units_x = (width + 7) / 8;
+        units_y = (height + 7) / 8;
+    }
+
+    JpegBits bits(segment + length, decoder.end);
+    uint32 until_restart = decoder.restartInterval;
+    for (uint32 unit_y = 0; unit_y < units_y; ++unit_y)
+    {
+        for (uint32 unit_x = 0; unit_x < units_x; ++unit_x)
+        {
+            if (decoder.restartInterval != 0 && until_restart == 0)
+            {
+                if (!bits.Restart())
+                {
+                    return {ErrorCategory::InvalidArgument, "JPEG restart marker is missing"};
+                }
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    scan_components[i]->dcPrediction = 0;
+                }
+                until_restart = decoder.restartInterval;
+            }
+
+            if (count == 1)
+            {
+                if (Result<> block =
+                        DecodeBlock(decoder, bits, *scan_components[0], unit_x, unit_y);
+                    !block)
+                {
+                    return PendingFailure{block.Category()};
+                }
+            }
+            else
+            {
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    JpegComponent& component = *scan_components[i];
+                    for (uint32 v = 0; v < component.vertical; ++v)
+                    {
+                        for (uint32 h = 0; h < component.horizontal; ++h)
+                        {
+                            Result<> block = DecodeBlock(decoder,
+                                                         bits,
+                                                         component,
+                                                         unit_x * component.horizontal + h,
+                                                         unit_y * component.vertical + v);
+                            if (!block)
+                            {
+                                return PendingFailure{block.Category()};
+                            }
+                        }
+                    }
+                }
+            }
+            --until_restart;
+        }
+    }
+    ++decoder.scans;
+    return bits.MarkerPosition();
+}
+
+// JFIF's YCbCr: R = Y + 1.402 Cr, G = Y - 0.344136 Cb - 0.714136 Cr, B = Y + 1.772 Cb, with the
+// chroma centered on 128
+void ConvertYCbCrRow(
+    const uint8* luma, const uint8* cb, const uint8* cr, uint8* out, uint32 width)
+{
+    uint32 x = 0;
+#if RSBL_SIMD_SSE
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 center = _mm_set1_ps(128.0f);
+    const __m128 low = _mm_setzero_ps();
+    const __m128 high = _mm_set1_ps(255.0f);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int32>(0xff000000u));
+    const auto widen = [&](const uint8* bytes)
+    {
+        uint32 four;
+        std::memcpy(&four, bytes, sizeof(four));
+        const __m128i words = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int32>(four)), zero);
+        return _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero));
+    };
+    const auto to_channel = [&](__m128 value)
+    {
+        return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(value, low), high));
+    };
+    for (; x + 4 <= width; x += 4)
+    {
+        const __m128 y = widen(luma + x);
+        const __m128 u = _mm_sub_ps(widen(cb + x), center);
+        const __m128 v = _mm_sub_ps(widen(cr + x), center);
+        const __m128 r = _mm_add_ps(y, _mm_mul_ps(v, _mm_set1_ps(1.402f)));
+        const __m128 g = _mm_sub_ps(_mm_sub_ps(y, _mm_mul_ps(u, _mm_set1_ps(0.344136f))),
+                                    _mm_mul_ps(v, _mm_set1_ps(0.714136f)));
+        const __m128 b = _mm_add_ps(y, _mm_mul_ps(u, _mm_set1_ps(1.772f)));
+        __m128i pixels = _mm_or_si128(to_channel(r), _mm_slli_epi32(to_channel(g), 8));
+        pixels = _mm_or_si128(pixels, _mm_or_si128(_mm_slli_epi32(to_channel(b), 16), alpha));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), pixels);
+    }
+#elif RSBL_SIMD_NEON
+    const float32x4_t center = vdupq_n_f32(128.0f);
+    const float32x4_t low = vdupq_n_f32(0.0f);
+    const float32x4_t high = vdupq_n_f32(255.0f);
+    const uint32x4_t alpha = vdupq_n_u32(0xff000000u);
+    const auto widen = [&](const uint8* bytes)
+    {
+        uint32 four;
+        std::memcpy(&four, bytes, sizeof(four));
+        const uint16x8_t words = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(four)));
+        return vcvtq_f32_u32(vmovl_u16(vget_low_u16(words)));
+    };
+    const auto to_channel = [&](float32x4_t value)
+    {
+        return vcvtnq_u32_f32(vminq_f32(vmaxq_f32(value, low), high));
+    };
+    for (; x + 4 <= width; x += 4)
+    {
+        const float32x4_t y = widen(luma + x);
+        const float32x4_t u = vsubq_f32(widen(cb + x), center);
+        const float32x4_t v = vsubq_f32(widen(cr + x), center);
+        const float32x4_t r = vmlaq_n_f32(y, v, 1.402f);
+        const float32x4_t g = vmlsq_n_f32(vmlsq_n_f32(y, u, 0.344136f), v, 0.714136f);
+        const float32x4_t b = vmlaq_n_f32(y, u, 1.772f);
+        uint32x4_t pixels = vorrq_u32(to_channel(r), vshlq_n_u32(to_channel(g), 8));
+        pixels = vorrq_u32(pixels, vorrq_u32(vshlq_n_u32(to_channel(b), 16), alpha));
+        vst1q_u32(reinterpret_cast<uint32*>(out + x * 4), pixels);
+    }
+#endif
+    const auto to_byte = [](float value)
+    {
+        return static_cast<uint8>((value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value)) + 0.5f);
+    };
+    for (; x < width; ++x)
+    {
+        const float y = luma[x];
+        const float u = cb[x] - 128.0f;
+        const float v = cr[x] - 128.0f;
+        out[x * 4 + 0] = to_byte(y + 1.402f * v);
+        out[x * 4 + 1] = to_byte(y - 0.344136f * u - 0.714136f * v);
+        out[x * 4 + 2] = to_byte(y + 1.772f * u);
+        out[x * 4 + 3] = 255;
+    }
+}
+
+// Row y of a component at the image's full resolution. Subsampled components repeat their
+// nearest sample into scratch.
+const uint8* UpsampledRow(const JpegDecoder& decoder,
+                          const JpegComponent& component,
+                          uint32 y,
+                          uint8* scratch)
+{
+    const uint32 source_y = y * component.vertical / decoder.maxVertical;
+    const uint8* row = component.plane.Data() + source_y * component.planeWidth;
+    if (component.horizontal == decoder.maxHorizontal)
+    {
+        return row;
+    }
+    if (component.horizontal * 2 == decoder.maxHorizontal)
+    {
+        for (uint32 x = 0; x < decoder.width; ++x)
+        {
+            scratch[x] = row[x >> 1];
+        }
+        return scratch;
+    }
+    for (uint32 x = 0; x < decoder.width; ++x)
+    {
+        scratch[x] = row[x * component.horizontal / decoder.maxHorizontal];
+    }
+    return scratch;
+}
+
+// Components stored as RGB rather than YCbCr, marked by Adobe's transform flag or, failing
+// that, by the components being named R, G and B
+bool IsRgb(const JpegDecoder& decoder)
+{
+    if (decoder.componentCount != 3)
+    {
+        return false;
+    }
+    if (decoder.adobeTransform >= 0)
+    {
+        return decoder.adobeTransform == 0;
+    }
+    return decoder.components[0].id == 'R' && decoder.components[1].id == 'G' &&
+           decoder.components[2].id == 'B';
+}
+
+void ConvertToRgba(const JpegDecoder& decoder, Image& out)
+{
+    out.width = decoder.width;
+    out.height = decoder.height;
+    out.format = ImageFormat::Rgba8;
+    out.pixels.ResizeUninitialized(ImageByteSize(decoder.width, decoder.height, out.format));
+
+    DynamicArray<uint8> scratch;
+    scratch.ResizeUninitialized(static_cast<uint64>(decoder.width) * kMaxComponents);
+    const uint64 stride = static_cast<uint64>(decoder.width) * 4;
+    const bool rgb = IsRgb(decoder);
+    for (uint32 y = 0; y < decoder.height; ++y)
+    {
+        uint8* out_row = out.pixels.Data() + y * stride;
+        if (decoder.componentCount == 1)
+        {
+            const uint8* gray = decoder.components[0].plane.Data() +
+                                static_cast<uint64>(y) * decoder.components[0].planeWidth;
+            for (uint32 x = 0; x < decoder.width; ++x)
+            {
+                out_row[x * 4 + 0] = gray[x];
+                out_row[x * 4 + 1] = gray[x];
+                out_row[x * 4 + 2] = gray[x];
+                out_row[x * 4 + 3] = 255;
+            }
+            continue;
+        }
+        const uint8* rows[kMaxComponents];
+        for (uint32 c = 0; c < kMaxComponents; ++c)
+        {
+            rows[c] = UpsampledRow(
+                decoder, decoder.components[c], y, scratch.Data() + c * decoder.width);
+        }
+        if (rgb)
+        {
+            for (uint32 x = 0; x < decoder.width; ++x)
+            {
+                out_row[x * 4 + 0] = rows[0][x];
+                out_row[x * 4 + 1] = rows[1][x];
+                out_row[x * 4 + 2] = rows[2][x];
+                out_row[x * 4 + 3] = 255;
+            }
+            continue;
+        }
+        ConvertYCbCrRow(rows[0], rows[1], rows[2], out_row, decoder.width);
+    }
+}
+} // namespace
+
+Result<> DecodeJpeg(ByteView file, Image& out)
+{
+    // Big, with the tables and the planes, and decoders run on job threads with small stacks
+    UniquePtr<JpegDecoder> decoder(new JpegDecoder());
+    decoder->end = file.Data() + file.Size();
+
+    const uint8* position = file.Data() + 2;
+    bool seen_end = false;
+    while (!seen_end && position < decoder->end)
+    {
+        if (position[0] != 0xff)
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG has bytes where a marker should be"};
+        }
+        // Any number of 0xff can pad before a marker
+        while (position < decoder->end && position[0] == 0xff)
+        {
+            ++position;
+        }
+        if (position == decoder->end)
+        {
+            break;
+        }
+        const uint8 marker = *position++;
+        if (marker == 0xd9)
+        {
+            seen_end = true;
+            continue;
+        }
+        if (marker == 0xd8 || (marker >= 0xd0 && marker <= 0xd7))
+        {
+            continue;
+        }
+
+        if (decoder->end - position < 2)
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG ends inside a marker"};
+        }
+        const uint32 segment_length = ReadBigEndian16(position);
+        if (segment_length < 2 || segment_length > static_cast<uint64>(decoder->end - position))
+        {
+            return {ErrorCategory::InvalidArgument, "JPEG marker runs past the end"};
+        }
+        const uint8* segment = position + 2;
+        const uint32 length = segment_length - 2;
+        position += segment_length;
+
+        Result<> read = ResultCode::Success;
+        switch (marker)
+        {
+        case 0xc0: // Baseline
+        case 0xc1: // Extended sequential, which with 8 bit samples only allows more tables
+            read = ReadFrame(*decoder, segment, length);
+            break;
+        case 0xc2:
+            return {ErrorCategory::InvalidArgument, "Progressive JPEGs aren't supported"};
+        case 0xc3:
+        case 0xc5:
+        case 0xc6:
+        case 0xc7:
+        case 0xc9:
+        case 0xca:
+        case 0xcb:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+            return {ErrorCategory::InvalidArgument,
+                    "Lossless, hierarchical and arithmetic coded JPEGs aren't supported"};
+        case 0xc4:
+            read = ReadHuffmanTables(*decoder, segment, length);
+            break;
+        case 0xdb:
+            read = ReadQuantTables(*decoder, segment, length);
+            break;
+        case 0xdd:
+            if (length < 2)
+            {
+                return {ErrorCategory::InvalidArgument, "JPEG restart interval is cut short"};
+            }
+            decoder->restartInterval = ReadBigEndian16(segment);
+            break;
+        case 0xda:
+        {
+            Result<const uint8*> scan = ReadScan(*decoder, segment, length);
+            if (!scan)
+            {
+                return PendingFailure{scan.Category()};
+            }
+            position = scan.Value();
+            break;
+        }
+        case 0xee:
+            // "Adobe", a version, two flag words, then the transform
+            if (length >= 12 && std::memcmp(segment, "Adobe", 5) == 0)
+            {
+                decoder->adobeTransform = segment[11];
+            }
+            break;
+        default:
+            // Other APPn, comments and the rest carry nothing the pixels need
+            break;
+        }
+        if (!read)
+        {
+            return read;
+        }
+    }
+
+    // Files cut off after the last scan are common enough to accept
+    if (decoder->scans == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "JPEG has no image data"};
+    }
+    ConvertToRgba(*decoder, out);
+    return ResultCode::Success;
+}
+
+} // namespace image
+} // namespace rsbl
@@ -0,0 +1,717 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-image-codecs.h"
+
+#include <rsbl-compression.h>
+#include <rsbl-simd-config.h>
+
+#include <cstring>
+
+// A PNG is a signature then chunks: the header, an optional palette and transparency, and the
+// zlib stream split across any number of IDAT chunks. Inflated, each row is a filter byte then
+// the row's samples, stored as differences from the pixel to the left, the one above, or a
+// prediction from both. Undoing that is a dependency chain from left to right, so the SIMD
+// paths work a pixel at a time with every channel in one register rather than across pixels.
+// Up has no chain and goes 16 bytes at a time.
+
+namespace rsbl
+{
+namespace image
+{
+
+namespace
+{
+enum PngColorType : uint8
+{
+    kGray = 0,
+    kRgb = 2,
+    kPalette = 3,
+    kGrayAlpha = 4,
+    kRgbAlpha = 6,
+};
+
+enum PngFilter : uint8
+{
+    kFilterNone = 0,
+    kFilterSub = 1,
+    kFilterUp = 2,
+    kFilterAverage = 3,
+    kFilterPaeth = 4,
+};
+
+struct PngHeader
+{
+    uint32 width = 0;
+    uint32 height = 0;
+    uint32 bitDepth = 0;
+    uint8 colorType = 0;
+    bool interlaced = false;
+    uint32 channels = 0;
+};
+
+struct PngPalette
+{
+    uint8 rgba[256][4];
+    uint32 size = 0;
+
+    // tRNS for gray and RGB images: the one color, at the image's bit depth, that's transparent
+    bool hasColorKey = false;
+    uint16 colorKey[3] = {};
+};
+
+// Adam7 passes: where each starts and how far apart its pixels are
+constexpr uint32 kAdam7StartX[7] = {0, 4, 0, 2, 0, 1, 0};
+constexpr uint32 kAdam7StartY[7] = {0, 0, 4, 0, 2, 0, 1};
+constexpr uint32 kAdam7StepX[7] = {8, 8, 4, 4, 2, 2, 1};
+constexpr uint32 kAdam7StepY[7] = {8, 8, 8, 4, 4, 2, 2};
+
+uint32 ReadBigEndian32(const uint8* bytes)
+{
+    return (static_cast<uint32>(bytes[0]) << 24) | (static_cast<uint32>(bytes[1]) << 16) |
+           (static_cast<uint32>(bytes[2]) << 8) | bytes[3];
+}
+
+uint16 ReadBigEndian16(const uint8* bytes)
+{
+    return static_cast<uint16>((bytes[0] << 8) | bytes[1]);
+}
+
+uint64 RowBytes(const PngHeader& header, uint32 width)
+{
+    return (static_cast<uint64>(width) * header.channels * header.bitDepth + 7) / 8;
+}
+
+bool ValidDepth(uint8 color_type, uint32 depth)
+{
+    switch (color_type)
+    {
+    case kGray:
+        return depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16;
+    case kPalette:
+        return depth == 1 || depth == 2 || depth == 4 || depth == 8;
+    case kRgb:
+    case kGrayAlpha:
+    case kRgbAlpha:
+        return depth == 8 || depth == 16;
+    default:
+        return false;
+    }
+}
+
+uint32 ChannelCount(uint8 color_type)
+{
+    switch (color_type)
+    {
+    case kRgb:
+        return 3;
+    case kGrayAlpha:
+        return 2;
+    case kRgbAlpha:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+// Passes of an interlaced image can be empty when the image is narrower or shorter than 8
+void PassSize(const PngHeader& header, uint32 pass, uint32& width, uint32& height)
+{
+    if (!header.interlaced)
+    {
+        width = header.width;
+        height = header.height;
+        return;
+    }
+    width = header.width > kAdam7StartX[pass]
+                ? (header.width - kAdam7StartX[pass] + kAdam7StepX[pass] - 1) / kAdam7StepX[pass]
+                : 0;
+    height = header.height > kAdam7StartY[pass]
+                 ? (header.height - kAdam7StartY[pass] + kAdam7StepY[pass] - 1) /
+                       kAdam7StepY[pass]
+                 : 0;
+}
+
+uint8 Paeth(uint8 a, uint8 b, uint8 c)
+{
+    const int32 pa = b > c ? b - c : c - b;
+    const int32 pb = a > c ? a - c : c - a;
+    const int32 pc_signed = static_cast<int32>(a) + b - 2 * c;
+    const int32 pc = pc_signed < 0 ? -pc_signed : pc_signed;
+    if (pa <= pb && pa <= pc)
+    {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+#if RSBL_SIMD_SSE || RSBL_SIMD_NEON
+    #if RSBL_SIMD_SSE
+using PixelVector = __m128i;
+
+template <uint32 kBytes>
+PixelVector LoadPixel(const uint8* pixel)
+{
+    uint32 value = 0;
+    std::memcpy(&value, pixel, kBytes);
+    return _mm_cvtsi32_si128(static_cast<int32>(value));
+}
+
+template <uint32 kBytes>
+void StorePixel(uint8* pixel, PixelVector value)
+{
+    const uint32 bytes = static_cast<uint32>(_mm_cvtsi128_si32(value));
+    std::memcpy(pixel, &bytes, kBytes);
+}
+
+PixelVector AddBytes(PixelVector a, PixelVector b)
+{
+    return _mm_add_epi8(a, b);
+}
+
+// (a + b) / 2 rounded down, where pavgb rounds up
+PixelVector AverageBytes(PixelVector a, PixelVector b)
+{
+    const PixelVector rounded = _mm_avg_epu8(a, b);
+    const PixelVector odd = _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1));
+    return _mm_sub_epi8(rounded, odd);
+}
+
+PixelVector PaethBytes(PixelVector a, PixelVector b, PixelVector c)
+{
+    const PixelVector zero = _mm_setzero_si128();
+    const PixelVector a16 = _mm_unpacklo_epi8(a, zero);
+    const PixelVector b16 = _mm_unpacklo_epi8(b, zero);
+    const PixelVector c16 = _mm_unpacklo_epi8(c, zero);
+
+    // pa = |b - c|, pb = |a - c|, pc = |a + b - 2c| = |(b - c) + (a - c)|
+    PixelVector pa = _mm_sub_epi16(b16, c16);
+    PixelVector pb = _mm_sub_epi16(a16, c16);
+    PixelVector pc = _mm_add_epi16(pa, pb);
+    pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+    pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+    pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+
+    // Ties go to a, then b
+    const PixelVector smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+    const PixelVector take_a = _mm_cmpeq_epi16(smallest, pa);
+    const PixelVector take_b = _mm_andnot_si128(take_a, _mm_cmpeq_epi16(smallest, pb));
+    const PixelVector take_c = _mm_andnot_si128(_mm_or_si128(take_a, take_b), _mm_set1_epi16(-1));
+    const PixelVector nearest = _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(take_a, a16), _mm_and_si128(take_b, b16)),
+        _mm_and_si128(take_c, c16));
+    return _mm_packus_epi16(nearest, zero);
+}
+    #else
+using PixelVector = uint8x8_t;
+
+template <uint32 kBytes>
+PixelVector LoadPixel(const uint8* pixel)
+{
+    uint32 value = 0;
+    std::memcpy(&value, pixel, kBytes);
+    return vreinterpret_u8_u32(vdup_n_u32(value));
+}
+
+template <uint32 kBytes>
+void StorePixel(uint8* pixel, PixelVector value)
+{
+    const uint32 bytes = vget_lane_u32(vreinterpret_u32_u8(value), 0);
+    std::memcpy(pixel, &bytes, kBytes);
+}
+
+PixelVector AddBytes(PixelVector a, PixelVector b)
+{
+    return vadd_u8(a, b);
+}
+
+PixelVector AverageBytes(PixelVector a, PixelVector b)
+{
+    return vhadd_u8(a, b);
+}
+
+PixelVector PaethBytes(PixelVector a, PixelVector b, PixelVector c)
+{
+    const uint16x8_t pa = vabdl_u8(b, c);
+    const uint16x8_t pb = vabdl_u8(a, c);
+    const uint16x8_t pc = vabdq_u16(vaddl_u8(a, b), vshll_n_u8(c, 1));
+
+    const uint8x8_t take_a = vmovn_u16(vandq_u16(vcleq_u16(pa, pb), vcleq_u16(pa, pc)));
+    const uint8x8_t take_b = vmovn_u16(vcleq_u16(pb, pc));
+    return vbsl_u8(take_a, a, vbsl_u8(take_b, b, c));
+}
+    #endif
+
+// Sub, Average and Paeth for 3 and 4 byte pixels, the 8 bit RGB and RGBA most textures are
+template <uint32 kBytes>
+void UnfilterPixels(uint8 filter, uint8* row, const uint8* prior, uint64 size)
+{
+    // The first pixel has nothing to its left, which the filters treat as zero
+    switch (filter)
+    {
+    case kFilterAverage:
+        for (uint32 i = 0; i < kBytes; ++i)
+        {
+            row[i] = static_cast<uint8>(row[i] + (prior[i] >> 1));
+        }
+        break;
+    case kFilterPaeth:
+        for (uint32 i = 0; i < kBytes; ++i)
+        {
+            row[i] = static_cast<uint8>(row[i] + prior[i]);
+        }
+        break;
+    default:
+        break;
+    }
+    PixelVector left = LoadPixel<kBytes>(row);
+    PixelVector upper_left = LoadPixel<kBytes>(prior);
+
+    for (uint64 i = kBytes; i + kBytes <= size; i += kBytes)
+    {
+        const PixelVector x = LoadPixel<kBytes>(row + i);
+        switch (filter)
+        {
+        case kFilterSub:
+            left = AddBytes(x, left);
+            break;
+        case kFilterAverage:
+            left = AddBytes(x, AverageBytes(left, LoadPixel<kBytes>(prior + i)));
+            break;
+        default:
+        {
+            const PixelVector upper = LoadPixel<kBytes>(prior + i);
+            left = AddBytes(x, PaethBytes(left, upper, upper_left));
+            upper_left = upper;
+            break;
+        }
+        }
+        StorePixel<kBytes>(row + i, left);
+    }
+}
+#endif
+
+// Undoes one row's filter in place. prior is the row above, already unfiltered, or zeros for
+// the first row. pixel_bytes is the distance to the pixel on the left, at least 1.
+bool UnfilterRow(uint8 filter, uint8* row, const uint8* prior, uint64 size, uint32 pixel_bytes)
+{
+    if (filter == kFilterNone)
+    {
+        return true;
+    }
+    if (filter == kFilterUp)
+    {
+        uint64 i = 0;
+#if RSBL_SIMD_SSE
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prior + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_add_epi8(x, b));
+        }
+#elif RSBL_SIMD_NEON
+        for (; i + 16 <= size; i += 16)
+        {
+            vst1q_u8(row + i, vaddq_u8(vld1q_u8(row + i), vld1q_u8(prior + i)));
+        }
+#endif
+        for (; i < size; ++i)
+        {
+            row[i] = static_cast<uint8>(row[i] + prior[i]);
+        }
+        return true;
+    }
+    if (filter > kFilterPaeth)
+    {
+        return false;
+    }
+
+#if RSBL_SIMD_SSE || RSBL_SIMD_NEON
+    if (pixel_bytes == 4)
+    {
+        UnfilterPixels<4>(filter, row, prior, size);
+        return true;
+    }
+    if (pixel_bytes == 3)
+    {
+        UnfilterPixels<3>(filter, row, prior, size);
+        return true;
+    }
+#endif
+
+    for (uint64 i = 0; i < size; ++i)
+    {
+        const uint8 a = i >= pixel_bytes ? row[i - pixel_bytes] : 0;
+        const uint8 b = prior[i];
+        const uint8 c = i >= pixel_bytes ? prior[i - pixel_bytes] : 0;
+        switch (filter)
+        {
+        case kFilterSub:
+            row[i] = static_cast<uint8>(row[i] + a);
+            break;
+        case kFilterAverage:
+            row[i] = static_cast<uint8>(row[i] + ((a + b) >> 1));
+            break;
+        default:
+            row[i] = static_cast<uint8>(row[i] + Paeth(a, b, c));
+            break;
+        }
+    }
+    return true;
+}
+
+// One sample at bit depths under 8, packed high bits first
+uint32 PackedSample(const uint8* row, uint32 index, uint32 depth)
+{
+    const uint32 bit = index * depth;
+    const uint32 shift = 8 - depth - (bit & 7);
+    return (row[bit >> 3] >> shift) & ((1u << depth) - 1);
+}
+
+// Converts an unfiltered row of width pixels to RGBA8
+void ExpandRow(const PngHeader& header,
+               const PngPalette& palette,
+               const uint8* row,
+               uint32 width,
+               uint8* out)
+{
+    const uint32 depth = header.bitDepth;
+    switch (header.colorType)
+    {
+    case kRgbAlpha:
+        if (depth == 8)
+        {
+            std::memcpy(out, row, static_cast<uint64>(width) * 4);
+            return;
+        }
+        for (uint32 x = 0; x < width; ++x)
+        {
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                out[x * 4 + c] = row[(x * 4 + c) * 2];
+            }
+        }
+        return;
+
+    case kRgb:
+    {
+        const uint32 sample_bytes = depth / 8;
+        for (uint32 x = 0; x < width; ++x)
+        {
+            const uint8* pixel = row + x * 3 * sample_bytes;
+            out[x * 4 + 0] = pixel[0];
+            out[x * 4 + 1] = pixel[sample_bytes];
+            out[x * 4 + 2] = pixel[sample_bytes * 2];
+            out[x * 4 + 3] = 255;
+            if (palette.hasColorKey)
+            {
+                const bool keyed =
+                    depth == 8
+                        ? pixel[0] == palette.colorKey[0] && pixel[1] == palette.colorKey[1] &&
+                              pixel[2] == palette.colorKey[2]
+                        : ReadBigEndian16(pixel) == palette.colorKey[0] &&
+                              ReadBigEndian16(pixel + 2) == palette.colorKey[1] &&
+                              ReadBigEndian16(pixel + 4) == palette.colorKey[2];
+                out[x * 4 + 3] = keyed ? 0 : 255;
+            }
+        }
+        return;
+    }
+
+    case kGrayAlpha:
+    {
+        const uint32 sample_bytes = depth / 8;
+        for (uint32 x = 0; x < width; ++x)
+        {
+            const uint8 gray = row[x * 2 * sample_bytes];
+            out[x * 4 + 0] = gray;
+            out[x * 4 + 1] = gray;
+            out[x * 4 + 2] = gray;
+            out[x * 4 + 3] = row[(x * 2 + 1) * sample_bytes];
+        }
+        return;
+    }
+
+    case kGray:
+    {
+        // 1, 2 and 4 bit levels spread over 0-255: 255, 85 and 17 times
+        const uint32 scale = depth >= 8 ? 1 : 255 / ((1u << depth) - 1);
+        for (uint32 x = 0; x < width; ++x)
+        {
+            uint32 sample = 0;
+            uint8 gray = 0;
+            if (depth == 16)
+            {
+                sample = ReadBigEndian16(row + x * 2);
+                gray = row[x * 2];
+            }
+            else if (depth == 8)
+            {
+                sample = row[x];
+                gray = row[x];
+            }
+            else
+            {
+                sample = PackedSample(row, x, depth);
+                gray = static_cast<uint8>(sample * scale);
+            }
+            out[x * 4 + 0] = gray;
+            out[x * 4 + 1] = gray;
+            out[x * 4 + 2] = gray;
+            out[x * 4 + 3] = palette.hasColorKey && sample == palette.colorKey[0] ? 0 : 255;
+        }
+        return;
+    }
+
+    default:
+        for (uint32 x = 0; x < width; ++x)
+        {
+            const uint32 index = depth == 8 ? row[x] : PackedSample(row, x, depth);
+            // Indices past the palette are an encoder bug, they come out transparent black
+            if (index < palette.size)
+            {
+                std::memcpy(out + x * 4, palette.rgba[index], 4);
+            }
+            else
+            {
+                std::memset(out + x * 4, 0, 4);
+            }
+        }
+        return;
+    }
+}
+
+Result<> ReadHeader(const uint8* data, uint32 length, PngHeader& header)
+{
+    if (length != 13)
+    {
+        return {ErrorCategory::InvalidArgument, "PNG header is the wrong size"};
+    }
+    header.width = ReadBigEndian32(data);
+    header.height = ReadBigEndian32(data + 4);
+    header.bitDepth = data[8];
+    header.colorType = data[9];
+    const uint8 compression = data[10];
+    const uint8 filter = data[11];
+    const uint8 interlace = data[12];
+
+    if (header.width == 0 || header.height == 0 || header.width > kMaxImageSide ||
+        header.height > kMaxImageSide)
+    {
+        return {ErrorCategory::InvalidArgument, "PNG is empty or too large"};
+    }
+    if (!ValidDepth(header.colorType, header.bitDepth))
+    {
+        return {ErrorCategory::InvalidArgument, "PNG color type and bit depth don't go together"};
+    }
+    if (compression != 0 || filter != 0 || interlace > 1)
+    {
+        return {ErrorCategory::InvalidArgument, "PNG uses an unknown method"};
+    }
+    header.interlaced = interlace == 1;
+    header.channels = ChannelCount(header.colorType);
+    return ResultCode::Success;
+}
+} // namespace
+
+Result<> DecodePng(ByteView file, Image& out)
+{
+    PngHeader header;
+    PngPalette palette;
+    for (uint32 i = 0; i < 256; ++i)
+    {
+        palette.rgba[i][3] = 255;
+    }
+
+    // IDAT chunks are usually one after the other, but needn't be
+    DynamicArray<ByteView> image_data;
+    uint64 image_data_size = 0;
+    bool seen_header = false;
+    bool seen_end = false;
+
+    uint64 offset = 8;
+    while (!seen_end)
+    {
+        if (file.Size() - offset < 12)
+        {
+            return {ErrorCategory::InvalidArgument, "PNG ends before its last chunk"};
+        }
+        const uint8* chunk = file.Data() + offset;
+        const uint32 length = ReadBigEndian32(chunk);
+        if (length > file.Size() - offset - 12)
+        {
+            return {ErrorCategory::InvalidArgument, "PNG chunk runs past the end"};
+        }
+        const uint8* type = chunk + 4;
+        const uint8* data = chunk + 8;
+        offset += 12 + static_cast<uint64>(length);
+
+        // The CRC isn't checked, the zlib stream's own checksum covers the pixels
+        if (!seen_header)
+        {
+            if (std::memcmp(type, "IHDR", 4) != 0)
+            {
+                return {ErrorCategory::InvalidArgument, "PNG doesn't start with its header"};
+            }
+            if (Result<> read = ReadHeader(data, length, header); !read)
+            {
+                return read;
+            }
+            seen_header = true;
+        }
+        else if (std::memcmp(type, "PLTE", 4) == 0)
+        {
+            if (length % 3 != 0 || length > 256 * 3)
+            {
+                return {ErrorCategory::InvalidArgument, "PNG palette is the wrong size"};
+            }
+            palette.size = length / 3;
+            for (uint32 i = 0; i < palette.size; ++i)
+            {
+                std::memcpy(palette.rgba[i], data + i * 3, 3);
+            }
+        }
+        else if (std::memcmp(type, "tRNS", 4) == 0)
+        {
+            if (header.colorType == kPalette)
+            {
+                for (uint32 i = 0; i < length && i < 256; ++i)
+                {
+                    palette.rgba[i][3] = data[i];
+                }
+            }
+            else if (header.colorType == kGray && length >= 2)
+            {
+                palette.hasColorKey = true;
+                palette.colorKey[0] = ReadBigEndian16(data);
+            }
+            else if (header.colorType == kRgb && length >= 6)
+            {
+                palette.hasColorKey = true;
+                for (uint32 c = 0; c < 3; ++c)
+                {
+                    palette.colorKey[c] = ReadBigEndian16(data + c * 2);
+                }
+            }
+        }
+        else if (std::memcmp(type, "IDAT", 4) == 0)
+        {
+            image_data.PushBack(ByteView(data, length));
+            image_data_size += length;
+        }
+        else if (std::memcmp(type, "IEND", 4) == 0)
+        {
+            seen_end = true;
+        }
+        else if ((type[0] & 0x20) == 0)
+        {
+            // A lowercase first letter marks a chunk as safe to skip
+            return {ErrorCategory::InvalidArgument, "PNG has a critical chunk this can't read"};
+        }
+    }
+
+    if (image_data.Size() == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "PNG has no image data"};
+    }
+    if (header.colorType == kPalette && palette.size == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "PNG has no palette"};
+    }
+
+    DynamicArray<uint8> joined;
+    ByteView compressed = image_data[0];
+    if (image_data.Size() > 1)
+    {
+        joined.Reserve(image_data_size);
+        for (const ByteView part : image_data)
+        {
+            joined.Append(part.Data(), part.Size());
+        }
+        compressed = ByteView(joined.Data(), joined.Size());
+    }
+
+    // Every pass's rows, each a filter byte then the row
+    const uint32 pass_count = header.interlaced ? 7 : 1;
+    uint64 raw_size = 0;
+    for (uint32 pass = 0; pass < pass_count; ++pass)
+    {
+        uint32 pass_width = 0;
+        uint32 pass_height = 0;
+        PassSize(header, pass, pass_width, pass_height);
+        if (pass_width != 0)
+        {
+            raw_size += (1 + RowBytes(header, pass_width)) * pass_height;
+        }
+    }
+    DynamicArray<uint8> raw;
+    raw.ResizeUninitialized(raw_size);
+    Result<uint64> inflated = ZlibDecompress(compressed, MutableByteView(raw.Data(), raw.Size()));
+    if (!inflated)
+    {
+        return PendingFailure{inflated.Category()};
+    }
+    if (inflated.Value() != raw_size)
+    {
+        return {ErrorCategory::InvalidArgument, "PNG image data is the wrong size"};
+    }
+
+    out.width = header.width;
+    out.height = header.height;
+    out.format = ImageFormat::Rgba8;
+    out.pixels.ResizeUninitialized(ImageByteSize(header.width, header.height, out.format));
+
+    const uint32 pixel_bytes = (header.channels * header.bitDepth + 7) / 8;
+    const uint64 max_row_bytes = RowBytes(header, header.width);
+    DynamicArray<uint8> zero_row;
+    zero_row.Resize(max_row_bytes);
+    DynamicArray<uint8> expanded;
+    if (header.interlaced)
+    {
+        expanded.ResizeUninitialized(static_cast<uint64>(header.width) * 4);
+    }
+
+    const uint64 stride = static_cast<uint64>(header.width) * 4;
+    uint8* row = raw.Data();
+    for (uint32 pass = 0; pass < pass_count; ++pass)
+    {
+        uint32 pass_width = 0;
+        uint32 pass_height = 0;
+        PassSize(header, pass, pass_width, pass_height);
+        if (pass_width == 0 || pass_height == 0)
+        {
+            continue;
+        }
+        const uint64 row_bytes = RowBytes(header, pass_width);
+        const uint8* prior = zero_row.Data();
+        for (uint32 y = 0; y < pass_height; ++y)
+        {
+            if (!UnfilterRow(row[0], row + 1, prior, row_bytes, pixel_bytes))
+            {
+                return {ErrorCategory::InvalidArgument, "PNG row has an unknown filter"};
+            }
+
+            if (!header.interlaced)
+            {
+                ExpandRow(header, palette, row + 1, pass_width, out.pixels.Data() + y * stride);
+            }
+            else
+            {
+                ExpandRow(header, palette, row + 1, pass_width, expanded.Data());
+                const uint32 out_y = kAdam7StartY[pass] + y * kAdam7StepY[pass];
+                uint8* out_row = out.pixels.Data() + out_y * stride;
+                for (uint32 x = 0; x < pass_width; ++x)
+                {
+                    const uint32 out_x = kAdam7StartX[pass] + x * kAdam7StepX[pass];
+                    std::memcpy(out_row + out_x * 4, expanded.Data() + x * 4, 4);
+                }
+            }
+            prior = row + 1;
+            row += 1 + row_bytes;
+        }
+    }
+    return ResultCode::Success;
+}
+
+} // namespace image
+} // namespace rsbl
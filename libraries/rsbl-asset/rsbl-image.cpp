@@ -0,0 +1,237 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-image-codecs.h"
+
+#include <rsbl-memory-tracking.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint8 kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+uint32 BlockBytes(ImageFormat format)
+{
+    return format == ImageFormat::Bc1 ? 8 : 16;
+}
+
+// sRGB bytes to linear, and linear quantized to 12 bits back to sRGB bytes, which is fine enough
+// that no byte is off by more than one
+struct SrgbTables
+{
+    float toLinear[256];
+    uint8 fromLinear[4096];
+
+    SrgbTables()
+    {
+        for (uint32 i = 0; i < 256; ++i)
+        {
+            const float c = float(i) / 255.0f;
+            toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (uint32 i = 0; i < 4096; ++i)
+        {
+            const float l = float(i) / 4095.0f;
+            const float c =
+                l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            fromLinear[i] = static_cast<uint8>(c * 255.0f + 0.5f);
+        }
+    }
+};
+
+const SrgbTables& GetSrgbTables()
+{
+    static const SrgbTables tables;
+    return tables;
+}
+
+void Downsample(const Image& source, bool srgb, Image& out)
+{
+    out.width = source.width > 1 ? source.width / 2 : 1;
+    out.height = source.height > 1 ? source.height / 2 : 1;
+    out.format = ImageFormat::Rgba8;
+    out.pixels.ResizeUninitialized(ImageByteSize(out.width, out.height, ImageFormat::Rgba8));
+
+    const SrgbTables& tables = GetSrgbTables();
+    const uint64 stride = static_cast<uint64>(source.width) * 4;
+    for (uint32 y = 0; y < out.height; ++y)
+    {
+        // An odd row or column at the end is left out, a one pixel wide side repeats itself
+        const uint8* row0 = source.pixels.Data() + uint64(y * 2) * stride;
+        const uint8* row1 = source.height > 1 ? row0 + stride : row0;
+        uint8* destination = out.pixels.Data() + uint64(y) * out.width * 4;
+        for (uint32 x = 0; x < out.width; ++x)
+        {
+            const uint64 x0 = uint64(x) * 8;
+            const uint64 x1 = source.width > 1 ? x0 + 4 : x0;
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                if (srgb && c < 3)
+                {
+                    const float* linear = tables.toLinear;
+                    const float sum = linear[row0[x0 + c]] + linear[row0[x1 + c]] +
+                                      linear[row1[x0 + c]] + linear[row1[x1 + c]];
+                    destination[x * 4 + c] =
+                        tables.fromLinear[static_cast<uint32>(sum * (4095.0f / 4.0f) + 0.5f)];
+                }
+                else
+                {
+                    const uint32 sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                    destination[x * 4 + c] = static_cast<uint8>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+}
+} // namespace
+
+ImageFileType DetectImageFileType(ByteView file)
+{
+    if (file.Size() >= sizeof(kPngSignature) &&
+        std::memcmp(file.Data(), kPngSignature, sizeof(kPngSignature)) == 0)
+    {
+        return ImageFileType::Png;
+    }
+    // Start of image, then the first marker
+    if (file.Size() >= 3 && file[0] == 0xff && file[1] == 0xd8 && file[2] == 0xff)
+    {
+        return ImageFileType::Jpeg;
+    }
+    return ImageFileType::Unknown;
+}
+
+uint64 ImageByteSize(uint32 width, uint32 height, ImageFormat format)
+{
+    if (format == ImageFormat::Rgba8)
+    {
+        return static_cast<uint64>(width) * height * 4;
+    }
+    const uint64 blocks_x = (static_cast<uint64>(width) + 3) / 4;
+    const uint64 blocks_y = (static_cast<uint64>(height) + 3) / 4;
+    return blocks_x * blocks_y * BlockBytes(format);
+}
+
+Result<> DecodeImage(ByteView file, Image& out)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    switch (DetectImageFileType(file))
+    {
+    case ImageFileType::Png:
+        return image::DecodePng(file, out);
+    case ImageFileType::Jpeg:
+        return image::DecodeJpeg(file, out);
+    case ImageFileType::Unknown:
+        break;
+    }
+    return {ErrorCategory::InvalidArgument, "Not a PNG or JPEG"};
+}
+
+Result<> CompressImage(const Image& source, ImageFormat format, Image& out)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (source.format != ImageFormat::Rgba8)
+    {
+        return {ErrorCategory::InvalidArgument, "Only RGBA8 images can be compressed"};
+    }
+    if (format == ImageFormat::Rgba8 || &source == &out)
+    {
+        return {ErrorCategory::InvalidArgument, "Compress to a BCn format, into another image"};
+    }
+    if (source.pixels.Size() < ImageByteSize(source.width, source.height, ImageFormat::Rgba8))
+    {
+        return {ErrorCategory::InvalidArgument, "Image has fewer pixels than its size"};
+    }
+
+    void (*compress_block)(const uint8*, uint64, uint8*) = nullptr;
+    switch (format)
+    {
+    case ImageFormat::Bc1:
+        compress_block = image::CompressBc1Block;
+        break;
+    case ImageFormat::Bc5:
+        compress_block = image::CompressBc5Block;
+        break;
+    case ImageFormat::Bc7:
+        compress_block = image::CompressBc7Block;
+        break;
+    case ImageFormat::Rgba8:
+        break;
+    }
+
+    out.width = source.width;
+    out.height = source.height;
+    out.format = format;
+    out.pixels.ResizeUninitialized(ImageByteSize(source.width, source.height, format));
+
+    const uint64 stride = static_cast<uint64>(source.width) * 4;
+    const uint32 block_bytes = BlockBytes(format);
+    uint8* block_out = out.pixels.Data();
+    for (uint32 y = 0; y < source.height; y += 4)
+    {
+        for (uint32 x = 0; x < source.width; x += 4)
+        {
+            const uint8* corner = source.pixels.Data() + y * stride + x * 4;
+            if (x + 4 <= source.width && y + 4 <= source.height)
+            {
+                compress_block(corner, stride, block_out);
+            }
+            else
+            {
+                // Blocks hanging off the right or bottom edge repeat the last row and column,
+                // so the padding doesn't pull the endpoints away from the real pixels
+                uint8 padded[4 * 4 * 4];
+                for (uint32 row = 0; row < 4; ++row)
+                {
+                    const uint32 source_y = y + row < source.height ? y + row : source.height - 1;
+                    for (uint32 column = 0; column < 4; ++column)
+                    {
+                        const uint32 source_x =
+                            x + column < source.width ? x + column : source.width - 1;
+                        std::memcpy(padded + (row * 4 + column) * 4,
+                                    source.pixels.Data() + source_y * stride + source_x * 4,
+                                    4);
+                    }
+                }
+                compress_block(padded, 16, block_out);
+            }
+            block_out += block_bytes;
+        }
+    }
+    return ResultCode::Success;
+}
+
+Result<> GenerateMips(const Image& image, bool srgb, DynamicArray<Image>& mips)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (image.format != ImageFormat::Rgba8 || image.width == 0 || image.height == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Mips are made from a non-empty RGBA8 image"};
+    }
+    if (image.pixels.Size() < ImageByteSize(image.width, image.height, ImageFormat::Rgba8))
+    {
+        return {ErrorCategory::InvalidArgument, "Image has fewer pixels than its size"};
+    }
+
+    uint32 count = 0;
+    for (uint32 size = image.width > image.height ? image.width : image.height; size > 1; size /= 2)
+    {
+        ++count;
+    }
+    mips.Clear();
+    mips.Resize(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Downsample(i == 0 ? image : mips[i - 1], srgb, mips[i]);
+    }
+    return ResultCode::Success;
+}
+
+} // namespace rsbl
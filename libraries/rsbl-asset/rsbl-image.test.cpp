@@ -0,0 +1,894 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-image.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+//
+// PNGs are written here, with stored deflate blocks, so the tests pick the filters and layout
+//
+
+uint32 Crc32(const uint8* data, uint64 size)
+{
+    uint32 crc = ~0u;
+    for (uint64 i = 0; i < size; ++i)
+    {
+        crc ^= data[i];
+        for (uint32 bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void AppendBigEndian32(DynamicArray<uint8>& out, uint32 value)
+{
+    for (int32 shift = 24; shift >= 0; shift -= 8)
+    {
+        out.PushBack(static_cast<uint8>(value >> shift));
+    }
+}
+
+void AppendChunk(DynamicArray<uint8>& png, const char* type, const uint8* data, uint32 size)
+{
+    AppendBigEndian32(png, size);
+    const uint64 start = png.Size();
+    png.Append(reinterpret_cast<const uint8*>(type), 4);
+    png.Append(data, size);
+    AppendBigEndian32(png, Crc32(png.Data() + start, png.Size() - start));
+}
+
+// zlib with the data in stored blocks
+DynamicArray<uint8> StoredZlib(const DynamicArray<uint8>& data)
+{
+    DynamicArray<uint8> out;
+    out.PushBack(0x78);
+    out.PushBack(0x01);
+    uint64 offset = 0;
+    do
+    {
+        const uint32 size = data.Size() - offset > 65535 ? 65535 : uint32(data.Size() - offset);
+        const bool last = offset + size == data.Size();
+        out.PushBack(last ? 1 : 0);
+        out.PushBack(static_cast<uint8>(size));
+        out.PushBack(static_cast<uint8>(size >> 8));
+        out.PushBack(static_cast<uint8>(~size));
+        out.PushBack(static_cast<uint8>(~size >> 8));
+        out.Append(data.Data() + offset, size);
+        offset += size;
+    } while (offset < data.Size());
+
+    uint32 a = 1;
+    uint32 b = 0;
+    for (const uint8 byte : data)
+    {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    AppendBigEndian32(out, (b << 16) | a);
+    return out;
+}
+
+uint8 Paeth(uint8 a, uint8 b, uint8 c)
+{
+    const int32 p = a + b - c;
+    const int32 pa = std::abs(p - a);
+    const int32 pb = std::abs(p - b);
+    const int32 pc = std::abs(p - c);
+    return pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+}
+
+// Appends the filter byte and the filtered row
+void FilterRow(DynamicArray<uint8>& out,
+               uint8 filter,
+               const uint8* row,
+               const uint8* prior,
+               uint64 size,
+               uint32 pixel_bytes)
+{
+    out.PushBack(filter);
+    for (uint64 i = 0; i < size; ++i)
+    {
+        const uint8 a = i >= pixel_bytes ? row[i - pixel_bytes] : 0;
+        const uint8 b = prior != nullptr ? prior[i] : 0;
+        const uint8 c = i >= pixel_bytes && prior != nullptr ? prior[i - pixel_bytes] : 0;
+        const uint8 predictions[5] = {0, a, b, static_cast<uint8>((a + b) / 2), Paeth(a, b, c)};
+        out.PushBack(static_cast<uint8>(row[i] - predictions[filter]));
+    }
+}
+
+struct PngSource
+{
+    uint32 width = 0;
+    uint32 height = 0;
+    uint8 bitDepth = 8;
+    uint8 colorType = 6;
+    uint32 channels = 4;
+    bool interlaced = false;
+    // Packed rows, as the PNG stores them once unfiltered
+    DynamicArray<uint8> rows;
+    DynamicArray<uint8> palette;
+    DynamicArray<uint8> transparency;
+
+    uint64 RowBytes(uint32 row_width) const
+    {
+        return (uint64(row_width) * channels * bitDepth + 7) / 8;
+    }
+};
+
+// Row y of the source cut down to every step_x pixel from start_x, for the interlaced passes
+DynamicArray<uint8> SubRow(const PngSource& source, uint32 y, uint32 start_x, uint32 step_x)
+{
+    const uint32 bits = source.channels * source.bitDepth;
+    const uint8* row = source.rows.Data() + y * source.RowBytes(source.width);
+    const uint32 width = (source.width - start_x + step_x - 1) / step_x;
+    DynamicArray<uint8> out;
+    out.Resize(source.RowBytes(width));
+    for (uint32 x = 0; x < width; ++x)
+    {
+        for (uint32 bit = 0; bit < bits; ++bit)
+        {
+            const uint32 from = (start_x + x * step_x) * bits + bit;
+            const uint32 to = x * bits + bit;
+            if ((row[from >> 3] >> (7 - (from & 7))) & 1)
+            {
+                out[to >> 3] |= static_cast<uint8>(0x80 >> (to & 7));
+            }
+        }
+    }
+    return out;
+}
+
+// Rows take the filters in turn, starting from first_filter
+DynamicArray<uint8> WritePng(const PngSource& source, uint8 first_filter = 0)
+{
+    const uint32 pixel_bytes = (source.channels * source.bitDepth + 7) / 8;
+    DynamicArray<uint8> raw;
+    uint8 filter = first_filter;
+
+    constexpr uint32 kStartX[7] = {0, 4, 0, 2, 0, 1, 0};
+    constexpr uint32 kStartY[7] = {0, 0, 4, 0, 2, 0, 1};
+    constexpr uint32 kStepX[7] = {8, 8, 4, 4, 2, 2, 1};
+    constexpr uint32 kStepY[7] = {8, 8, 8, 4, 4, 2, 2};
+    const uint32 passes = source.interlaced ? 7 : 1;
+    for (uint32 pass = 0; pass < passes; ++pass)
+    {
+        const uint32 start_x = source.interlaced ? kStartX[pass] : 0;
+        const uint32 start_y = source.interlaced ? kStartY[pass] : 0;
+        const uint32 step_x = source.interlaced ? kStepX[pass] : 1;
+        const uint32 step_y = source.interlaced ? kStepY[pass] : 1;
+        if (start_x >= source.width || start_y >= source.height)
+        {
+            continue;
+        }
+        DynamicArray<uint8> prior;
+        for (uint32 y = start_y; y < source.height; y += step_y)
+        {
+            const DynamicArray<uint8> row = SubRow(source, y, start_x, step_x);
+            FilterRow(raw,
+                      filter,
+                      row.Data(),
+                      prior.Size() != 0 ? prior.Data() : nullptr,
+                      row.Size(),
+                      pixel_bytes);
+            filter = static_cast<uint8>((filter + 1) % 5);
+            prior = row;
+        }
+    }
+
+    DynamicArray<uint8> png;
+    const uint8 signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    png.Append(signature, sizeof(signature));
+    uint8 header[13] = {};
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        header[i] = static_cast<uint8>(source.width >> (24 - i * 8));
+        header[4 + i] = static_cast<uint8>(source.height >> (24 - i * 8));
+    }
+    header[8] = source.bitDepth;
+    header[9] = source.colorType;
+    header[12] = source.interlaced ? 1 : 0;
+    AppendChunk(png, "IHDR", header, sizeof(header));
+    if (source.palette.Size() != 0)
+    {
+        AppendChunk(png, "PLTE", source.palette.Data(), uint32(source.palette.Size()));
+    }
+    if (source.transparency.Size() != 0)
+    {
+        AppendChunk(png, "tRNS", source.transparency.Data(), uint32(source.transparency.Size()));
+    }
+    // Split across two IDATs, which decoders have to join back up
+    const DynamicArray<uint8> compressed = StoredZlib(raw);
+    const uint32 half = uint32(compressed.Size() / 2);
+    AppendChunk(png, "IDAT", compressed.Data(), half);
+    AppendChunk(png, "IDAT", compressed.Data() + half, uint32(compressed.Size()) - half);
+    AppendChunk(png, "IEND", nullptr, 0);
+    return png;
+}
+
+PngSource Rgba8Source(uint32 width, uint32 height)
+{
+    PngSource source;
+    source.width = width;
+    source.height = height;
+    for (uint32 y = 0; y < height; ++y)
+    {
+        for (uint32 x = 0; x < width; ++x)
+        {
+            // Mixed enough that every filter predicts something different
+            source.rows.PushBack(static_cast<uint8>(x * 37 + y * 11));
+            source.rows.PushBack(static_cast<uint8>(x * x + y * 3));
+            source.rows.PushBack(static_cast<uint8>(255 - x * 5 - y * y));
+            source.rows.PushBack(static_cast<uint8>((x ^ y) * 29));
+        }
+    }
+    return source;
+}
+
+Image Decode(const DynamicArray<uint8>& file)
+{
+    Image image;
+    const Result<> decoded = DecodeImage(ByteView(file.Data(), file.Size()), image);
+    REQUIRE(decoded);
+    return image;
+}
+
+//
+// JPEGs from libjpeg at quality 95, 13x11, of the pattern in JpegPattern
+//
+
+// 4:2:0 with a restart marker after every MCU
+const uint8 kJpeg420[] = {
+    0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x02, 0x01, 0x01, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x04, 0x03,
+    0x02, 0x02, 0x02, 0x02, 0x05, 0x04, 0x04, 0x03, 0x04, 0x06, 0x05, 0x06,
+    0x06, 0x06, 0x05, 0x06, 0x06, 0x06, 0x07, 0x09, 0x08, 0x06, 0x07, 0x09,
+    0x07, 0x06, 0x06, 0x08, 0x0B, 0x08, 0x09, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x06, 0x08, 0x0B, 0x0C, 0x0B, 0x0A, 0x0C, 0x09, 0x0A, 0x0A, 0x0A, 0xFF,
+    0xDB, 0x00, 0x43, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x05, 0x03,
+    0x03, 0x05, 0x0A, 0x07, 0x06, 0x07, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0xFF, 0xC0, 0x00, 0x11,
+    0x08, 0x00, 0x0B, 0x00, 0x0D, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01,
+    0x03, 0x11, 0x01, 0xFF, 0xC4, 0x00, 0x16, 0x00, 0x01, 0x01, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x07, 0x06, 0x08, 0xFF, 0xC4, 0x00, 0x20, 0x10, 0x00, 0x01, 0x03, 0x04,
+    0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x05, 0x06, 0x02, 0x07, 0x14, 0x24, 0x04, 0x41, 0x22, 0x51,
+    0xA1, 0xFF, 0xC4, 0x00, 0x15, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x07,
+    0xFF, 0xC4, 0x00, 0x1B, 0x11, 0x00, 0x01, 0x04, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x31, 0x00, 0x01,
+    0x07, 0x14, 0x04, 0x05, 0x06, 0xFF, 0xDD, 0x00, 0x04, 0x00, 0x01, 0xFF,
+    0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F,
+    0x00, 0xC8, 0xD0, 0x8B, 0x3A, 0x3C, 0x35, 0x3E, 0x25, 0x78, 0xF5, 0x9C,
+    0x18, 0x23, 0x57, 0xD7, 0x4A, 0xB6, 0x0C, 0xD6, 0xDE, 0x4D, 0x00, 0xF1,
+    0x28, 0x4B, 0x51, 0xE6, 0x96, 0xDC, 0x11, 0xA9, 0x47, 0x4A, 0x83, 0x24,
+    0xC8, 0xFB, 0x2B, 0x0E, 0x4A, 0x24, 0x2F, 0xDA, 0x66, 0xD3, 0x62, 0x17,
+    0xFF, 0xD9,
+};
+
+const uint8 kJpeg444[] = {
+    0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x02, 0x01, 0x01, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x04, 0x03,
+    0x02, 0x02, 0x02, 0x02, 0x05, 0x04, 0x04, 0x03, 0x04, 0x06, 0x05, 0x06,
+    0x06, 0x06, 0x05, 0x06, 0x06, 0x06, 0x07, 0x09, 0x08, 0x06, 0x07, 0x09,
+    0x07, 0x06, 0x06, 0x08, 0x0B, 0x08, 0x09, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x06, 0x08, 0x0B, 0x0C, 0x0B, 0x0A, 0x0C, 0x09, 0x0A, 0x0A, 0x0A, 0xFF,
+    0xDB, 0x00, 0x43, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x05, 0x03,
+    0x03, 0x05, 0x0A, 0x07, 0x06, 0x07, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A, 0xFF, 0xC0, 0x00, 0x11,
+    0x08, 0x00, 0x0B, 0x00, 0x0D, 0x03, 0x01, 0x11, 0x00, 0x02, 0x11, 0x01,
+    0x03, 0x11, 0x01, 0xFF, 0xC4, 0x00, 0x16, 0x00, 0x01, 0x01, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x07, 0x06, 0x08, 0xFF, 0xC4, 0x00, 0x20, 0x10, 0x00, 0x01, 0x03, 0x04,
+    0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x05, 0x06, 0x02, 0x07, 0x14, 0x24, 0x04, 0x41, 0x22, 0x51,
+    0xA1, 0xFF, 0xC4, 0x00, 0x17, 0x01, 0x01, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x01,
+    0x06, 0x09, 0xFF, 0xC4, 0x00, 0x1D, 0x11, 0x00, 0x01, 0x04, 0x02, 0x03,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06,
+    0x00, 0x04, 0x22, 0x32, 0x01, 0x03, 0x05, 0x14, 0x24, 0xFF, 0xDA, 0x00,
+    0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00, 0xC8,
+    0xD0, 0x8B, 0x3A, 0x3C, 0x35, 0x3E, 0x26, 0x21, 0x49, 0x85, 0xA4, 0xA8,
+    0xE0, 0xA4, 0x75, 0x92, 0x57, 0x8F, 0x59, 0xC1, 0x82, 0x35, 0x7D, 0x74,
+    0x8F, 0x9C, 0xC9, 0x87, 0xAA, 0xC9, 0x72, 0x38, 0x47, 0xE1, 0xB2, 0xAD,
+    0x83, 0x35, 0xB7, 0x93, 0x40, 0x3C, 0x4A, 0x14, 0x94, 0xBA, 0x71, 0x29,
+    0x65, 0x67, 0x38, 0x2B, 0x8D, 0xD0, 0x92, 0x5A, 0x8F, 0x34, 0xB6, 0xE0,
+    0x8D, 0x4A, 0x3A, 0x47, 0xBE, 0x65, 0xDB, 0x9E, 0xD5, 0xB2, 0x97, 0x23,
+    0x8E, 0x37, 0x74, 0x6C, 0xBF, 0xFF, 0xD9,
+};
+
+// Grayscale, the average of the pattern's channels
+const uint8 kJpegGray[] = {
+    0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00, 0x02, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x02, 0x01, 0x01, 0x01, 0x02, 0x02, 0x02, 0x02, 0x02, 0x04, 0x03,
+    0x02, 0x02, 0x02, 0x02, 0x05, 0x04, 0x04, 0x03, 0x04, 0x06, 0x05, 0x06,
+    0x06, 0x06, 0x05, 0x06, 0x06, 0x06, 0x07, 0x09, 0x08, 0x06, 0x07, 0x09,
+    0x07, 0x06, 0x06, 0x08, 0x0B, 0x08, 0x09, 0x0A, 0x0A, 0x0A, 0x0A, 0x0A,
+    0x06, 0x08, 0x0B, 0x0C, 0x0B, 0x0A, 0x0C, 0x09, 0x0A, 0x0A, 0x0A, 0xFF,
+    0xC0, 0x00, 0x0B, 0x08, 0x00, 0x0B, 0x00, 0x0D, 0x01, 0x01, 0x11, 0x00,
+    0xFF, 0xC4, 0x00, 0x15, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0x05, 0xFF,
+    0xC4, 0x00, 0x21, 0x10, 0x00, 0x00, 0x04, 0x05, 0x05, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x06, 0x23,
+    0x03, 0x04, 0x05, 0x14, 0x41, 0x22, 0x24, 0x32, 0x51, 0xA1, 0xFF, 0xDA,
+    0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x3F, 0x00, 0x15, 0x4A, 0x26, 0xB8,
+    0x37, 0xD6, 0x02, 0x1D, 0x19, 0x35, 0xB4, 0x26, 0xFC, 0x13, 0x52, 0x92,
+    0xF0, 0x74, 0x36, 0x58, 0x08, 0x74, 0x69, 0x78, 0x36, 0x84, 0xD9, 0x0F,
+    0xFF, 0xD9,
+};
+
+void JpegPattern(uint32 x, uint32 y, uint8* rgb)
+{
+    rgb[0] = static_cast<uint8>(x * 12 + 20);
+    rgb[1] = static_cast<uint8>(y * 10 + 40);
+    rgb[2] = static_cast<uint8>(200 - x * 5 - y * 4);
+}
+
+// Mean and largest difference from the pattern over the color channels
+void CompareToPattern(const Image& image, bool gray, double& mean, uint32& largest)
+{
+    double total = 0.0;
+    largest = 0;
+    for (uint32 y = 0; y < image.height; ++y)
+    {
+        for (uint32 x = 0; x < image.width; ++x)
+        {
+            uint8 rgb[3];
+            JpegPattern(x, y, rgb);
+            const uint8* pixel = image.pixels.Data() + (y * image.width + x) * 4;
+            CHECK(pixel[3] == 255);
+            for (uint32 c = 0; c < 3; ++c)
+            {
+                const int32 expected = gray ? (rgb[0] + rgb[1] + rgb[2]) / 3 : rgb[c];
+                const uint32 difference = uint32(std::abs(pixel[c] - expected));
+                total += difference;
+                largest = difference > largest ? difference : largest;
+            }
+        }
+    }
+    mean = total / (image.width * image.height * 3);
+}
+
+//
+// Reference BCn decoders
+//
+
+void Expand565(uint32 packed, int32* rgb)
+{
+    const int32 r = (packed >> 11) & 31;
+    const int32 g = (packed >> 5) & 63;
+    const int32 b = packed & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+void DecodeBc1(const uint8* block, uint8 pixels[16][4])
+{
+    const uint32 color0 = block[0] | (block[1] << 8);
+    const uint32 color1 = block[2] | (block[3] << 8);
+    int32 palette[4][3];
+    Expand565(color0, palette[0]);
+    Expand565(color1, palette[1]);
+    for (uint32 c = 0; c < 3; ++c)
+    {
+        if (color0 > color1)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        else
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    const uint32 indices = block[4] | (block[5] << 8) | (block[6] << 16) | (uint32(block[7]) << 24);
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        const uint32 index = (indices >> (i * 2)) & 3;
+        for (uint32 c = 0; c < 3; ++c)
+        {
+            pixels[i][c] = static_cast<uint8>(palette[index][c]);
+        }
+        pixels[i][3] = color0 <= color1 && index == 3 ? 0 : 255;
+    }
+}
+
+void DecodeBc4(const uint8* block, uint8 values[16])
+{
+    const uint32 red0 = block[0];
+    const uint32 red1 = block[1];
+    uint32 palette[8] = {red0, red1};
+    for (uint32 i = 2; i < 8; ++i)
+    {
+        palette[i] = red0 > red1 ? ((8 - i) * red0 + (i - 1) * red1) / 7
+                                 : (i < 6 ? ((6 - i) * red0 + (i - 1) * red1) / 5
+                                          : (i == 6 ? 0 : 255));
+    }
+    uint64 indices = 0;
+    for (uint32 i = 0; i < 6; ++i)
+    {
+        indices |= uint64(block[2 + i]) << (i * 8);
+    }
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        values[i] = static_cast<uint8>(palette[(indices >> (i * 3)) & 7]);
+    }
+}
+
+uint32 ReadBits(const uint8* block, uint32& position, uint32 count)
+{
+    uint32 value = 0;
+    for (uint32 i = 0; i < count; ++i, ++position)
+    {
+        value |= ((block[position >> 3] >> (position & 7)) & 1u) << i;
+    }
+    return value;
+}
+
+// Mode 6 only, which is all CompressImage writes
+void DecodeBc7(const uint8* block, uint8 pixels[16][4])
+{
+    uint32 position = 0;
+    REQUIRE(ReadBits(block, position, 7) == 1u << 6);
+    uint32 endpoints[2][4];
+    for (uint32 c = 0; c < 4; ++c)
+    {
+        endpoints[0][c] = ReadBits(block, position, 7);
+        endpoints[1][c] = ReadBits(block, position, 7);
+    }
+    const uint32 pbits[2] = {ReadBits(block, position, 1), ReadBits(block, position, 1)};
+    constexpr uint32 kWeights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        const uint32 index = ReadBits(block, position, i == 0 ? 3 : 4);
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            const uint32 a = (endpoints[0][c] << 1) | pbits[0];
+            const uint32 b = (endpoints[1][c] << 1) | pbits[1];
+            const uint32 weight = kWeights[index];
+            pixels[i][c] = static_cast<uint8>(((64 - weight) * a + weight * b + 32) >> 6);
+        }
+    }
+    CHECK(position == 128);
+}
+
+// Decodes compressed back to RGBA8 and measures it against source, over the channels the
+// format keeps. Returns the PSNR in dB.
+double CompressedPsnr(const Image& source, const Image& compressed, uint32 channels)
+{
+    const uint32 blocks_x = (source.width + 3) / 4;
+    const uint32 block_bytes = compressed.format == ImageFormat::Bc1 ? 8 : 16;
+    double squared = 0.0;
+    for (uint32 y = 0; y < source.height; ++y)
+    {
+        for (uint32 x = 0; x < source.width; ++x)
+        {
+            const uint8* block =
+                compressed.pixels.Data() + ((y / 4) * blocks_x + x / 4) * block_bytes;
+            uint8 decoded[16][4] = {};
+            if (compressed.format == ImageFormat::Bc1)
+            {
+                DecodeBc1(block, decoded);
+            }
+            else if (compressed.format == ImageFormat::Bc7)
+            {
+                DecodeBc7(block, decoded);
+            }
+            else
+            {
+                uint8 red[16];
+                uint8 green[16];
+                DecodeBc4(block, red);
+                DecodeBc4(block + 8, green);
+                for (uint32 i = 0; i < 16; ++i)
+                {
+                    decoded[i][0] = red[i];
+                    decoded[i][1] = green[i];
+                }
+            }
+            const uint8* pixel = source.pixels.Data() + (y * source.width + x) * 4;
+            for (uint32 c = 0; c < channels; ++c)
+            {
+                const double d = double(decoded[(y % 4) * 4 + x % 4][c]) - pixel[c];
+                squared += d * d;
+            }
+        }
+    }
+    const double mean = squared / (double(source.width) * source.height * channels);
+    return mean == 0.0 ? 100.0 : 10.0 * std::log10(255.0 * 255.0 / mean);
+}
+
+// A tinted gradient with a little noise, like most of a texture
+Image TextureLike(uint32 width, uint32 height)
+{
+    Image image;
+    image.width = width;
+    image.height = height;
+    uint32 noise = 12345;
+    for (uint32 y = 0; y < height; ++y)
+    {
+        for (uint32 x = 0; x < width; ++x)
+        {
+            noise = noise * 1664525 + 1013904223;
+            const uint32 jitter = (noise >> 24) & 7;
+            const uint32 level = x * 6 + y * 4;
+            image.pixels.PushBack(static_cast<uint8>(level + 20 + jitter));
+            image.pixels.PushBack(static_cast<uint8>(level * 3 / 4 + 40 + jitter));
+            image.pixels.PushBack(static_cast<uint8>(level / 2 + 60));
+            image.pixels.PushBack(static_cast<uint8>(255 - level / 2));
+        }
+    }
+    return image;
+}
+} // namespace
+
+TEST_SUITE("rsbl::Image")
+{
+    TEST_CASE("File types and sizes")
+    {
+        const uint8 png[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        CHECK(DetectImageFileType(ByteView(png, sizeof(png))) == ImageFileType::Png);
+        CHECK(DetectImageFileType(ByteView(kJpeg444, sizeof(kJpeg444))) == ImageFileType::Jpeg);
+        CHECK(DetectImageFileType(ByteView(png, 4)) == ImageFileType::Unknown);
+        CHECK(DetectImageFileType(ByteView()) == ImageFileType::Unknown);
+
+        CHECK(ImageByteSize(5, 3, ImageFormat::Rgba8) == 60);
+        CHECK(ImageByteSize(5, 3, ImageFormat::Bc1) == 2 * 8);
+        CHECK(ImageByteSize(8, 8, ImageFormat::Bc5) == 4 * 16);
+        CHECK(ImageByteSize(1, 9, ImageFormat::Bc7) == 3 * 16);
+
+        Image image;
+        CHECK(DecodeImage(ByteView(png, 4), image).Category() == ErrorCategory::InvalidArgument);
+    }
+
+    TEST_CASE("PNG filters")
+    {
+        // Wide enough for the 16 byte Up path and its tail, every filter on every row over
+        // five files
+        const PngSource source = Rgba8Source(13, 9);
+        for (uint8 first = 0; first < 5; ++first)
+        {
+            const Image image = Decode(WritePng(source, first));
+            CHECK(image.width == 13);
+            CHECK(image.height == 9);
+            CHECK(image.format == ImageFormat::Rgba8);
+            REQUIRE(image.pixels.Size() == source.rows.Size());
+            CHECK(std::memcmp(image.pixels.Data(), source.rows.Data(), source.rows.Size()) == 0);
+        }
+
+        // RGB goes through the 3 byte pixel paths and gains an opaque alpha
+        PngSource rgb = source;
+        rgb.colorType = 2;
+        rgb.channels = 3;
+        rgb.rows.Clear();
+        for (uint64 i = 0; i < source.rows.Size(); i += 4)
+        {
+            rgb.rows.Append(source.rows.Data() + i, 3);
+        }
+        for (uint8 first = 0; first < 5; ++first)
+        {
+            const Image image = Decode(WritePng(rgb, first));
+            for (uint64 i = 0; i < source.rows.Size(); i += 4)
+            {
+                CHECK(std::memcmp(image.pixels.Data() + i, source.rows.Data() + i, 3) == 0);
+                CHECK(image.pixels[i + 3] == 255);
+            }
+        }
+    }
+
+    TEST_CASE("PNG color types and bit depths")
+    {
+        // 2 bit gray, which spreads 0-3 over 0-255
+        PngSource gray;
+        gray.width = 5;
+        gray.height = 2;
+        gray.bitDepth = 2;
+        gray.colorType = 0;
+        gray.channels = 1;
+        const uint8 gray_rows[] = {0b00011011, 0b00000000, 0b11100100, 0b01000000};
+        gray.rows.Append(gray_rows, sizeof(gray_rows));
+        Image image = Decode(WritePng(gray, 1));
+        const uint8 expected_gray[] = {0, 85, 170, 255, 0, 255, 170, 85, 0, 85};
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            CHECK(image.pixels[i * 4] == expected_gray[i]);
+            CHECK(image.pixels[i * 4 + 2] == expected_gray[i]);
+            CHECK(image.pixels[i * 4 + 3] == 255);
+        }
+
+        // 4 bit palette with transparency for the first two entries
+        PngSource palette;
+        palette.width = 3;
+        palette.height = 1;
+        palette.bitDepth = 4;
+        palette.colorType = 3;
+        palette.channels = 1;
+        const uint8 palette_row[] = {0x01, 0x20};
+        palette.rows.Append(palette_row, sizeof(palette_row));
+        const uint8 colors[] = {10, 20, 30, 40, 50, 60, 70, 80, 90};
+        palette.palette.Append(colors, sizeof(colors));
+        const uint8 alphas[] = {0, 128};
+        palette.transparency.Append(alphas, sizeof(alphas));
+        image = Decode(WritePng(palette));
+        const uint8 expected_palette[] = {10, 20, 30, 0, 40, 50, 60, 128, 70, 80, 90, 255};
+        CHECK(std::memcmp(image.pixels.Data(), expected_palette, sizeof(expected_palette)) == 0);
+
+        // 16 bit RGB keeps the high bytes, and the tRNS color is compared at full depth
+        PngSource rgb16;
+        rgb16.width = 2;
+        rgb16.height = 1;
+        rgb16.bitDepth = 16;
+        rgb16.colorType = 2;
+        rgb16.channels = 3;
+        const uint8 rgb16_row[] = {
+            0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0x12, 0x35, 0x56, 0x78, 0x9a, 0xbc};
+        rgb16.rows.Append(rgb16_row, sizeof(rgb16_row));
+        const uint8 key[] = {0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc};
+        rgb16.transparency.Append(key, sizeof(key));
+        image = Decode(WritePng(rgb16, 4));
+        const uint8 expected_rgb16[] = {0x12, 0x56, 0x9a, 0, 0x12, 0x56, 0x9a, 255};
+        CHECK(std::memcmp(image.pixels.Data(), expected_rgb16, sizeof(expected_rgb16)) == 0);
+
+        // 16 bit gray with alpha
+        PngSource gray_alpha;
+        gray_alpha.width = 1;
+        gray_alpha.height = 2;
+        gray_alpha.bitDepth = 16;
+        gray_alpha.colorType = 4;
+        gray_alpha.channels = 2;
+        const uint8 gray_alpha_rows[] = {0xff, 0x00, 0x80, 0x01, 0x40, 0xff, 0x00, 0x00};
+        gray_alpha.rows.Append(gray_alpha_rows, sizeof(gray_alpha_rows));
+        image = Decode(WritePng(gray_alpha, 3));
+        const uint8 expected_gray_alpha[] = {0xff, 0xff, 0xff, 0x80, 0x40, 0x40, 0x40, 0x00};
+        CHECK(std::memcmp(image.pixels.Data(), expected_gray_alpha, 8) == 0);
+    }
+
+    TEST_CASE("Interlaced PNGs")
+    {
+        // Sizes where some of the seven passes are empty, and where all are full
+        const uint32 sizes[][2] = {{1, 1}, {3, 2}, {11, 7}, {17, 16}};
+        for (const auto& size : sizes)
+        {
+            PngSource source = Rgba8Source(size[0], size[1]);
+            source.interlaced = true;
+            const Image image = Decode(WritePng(source, 2));
+            REQUIRE(image.pixels.Size() == source.rows.Size());
+            CHECK(std::memcmp(image.pixels.Data(), source.rows.Data(), source.rows.Size()) == 0);
+        }
+    }
+
+    TEST_CASE("Broken PNGs fail")
+    {
+        const DynamicArray<uint8> good = WritePng(Rgba8Source(6, 4));
+        Image image;
+
+        // Cut short anywhere
+        for (uint64 size = 8; size < good.Size(); size += 7)
+        {
+            CHECK_FALSE(DecodeImage(ByteView(good.Data(), size), image));
+        }
+
+        // A filter byte past Paeth. The first IDAT holds the zlib header, a 5 byte stored block
+        // header, then the first row's filter byte.
+        DynamicArray<uint8> bad_filter = good;
+        const uint64 first_idat = 8 + 25 + 8;
+        bad_filter[first_idat + 2 + 5] = 5;
+        CHECK_FALSE(DecodeImage(ByteView(bad_filter.Data(), bad_filter.Size()), image));
+
+        // RGB can't be 4 bit
+        PngSource bad_depth = Rgba8Source(2, 2);
+        bad_depth.colorType = 2;
+        bad_depth.channels = 3;
+        bad_depth.bitDepth = 4;
+        const DynamicArray<uint8> bad_depth_png = WritePng(bad_depth);
+        CHECK_FALSE(DecodeImage(ByteView(bad_depth_png.Data(), bad_depth_png.Size()), image));
+
+        // A critical chunk nothing knows about
+        DynamicArray<uint8> unknown_chunk;
+        unknown_chunk.Append(good.Data(), 8 + 25);
+        AppendChunk(unknown_chunk, "ABCD", nullptr, 0);
+        unknown_chunk.Append(good.Data() + 8 + 25, good.Size() - 8 - 25);
+        CHECK_FALSE(DecodeImage(ByteView(unknown_chunk.Data(), unknown_chunk.Size()), image));
+
+        // An ancillary one is skipped
+        DynamicArray<uint8> ancillary_chunk;
+        ancillary_chunk.Append(good.Data(), 8 + 25);
+        AppendChunk(ancillary_chunk, "abCD", nullptr, 0);
+        ancillary_chunk.Append(good.Data() + 8 + 25, good.Size() - 8 - 25);
+        CHECK(DecodeImage(ByteView(ancillary_chunk.Data(), ancillary_chunk.Size()), image));
+    }
+
+    TEST_CASE("Baseline JPEGs")
+    {
+        struct Case
+        {
+            ByteView file;
+            bool gray;
+            double maxMean;
+            uint32 maxLargest;
+        };
+        // Chroma subsampled to half on both axes loses the most, at the pattern's edges
+        const Case cases[] = {
+            {ByteView(kJpeg420, sizeof(kJpeg420)), false, 4.5, 14},
+            {ByteView(kJpeg444, sizeof(kJpeg444)), false, 1.0, 5},
+            {ByteView(kJpegGray, sizeof(kJpegGray)), true, 0.1, 2},
+        };
+        for (const Case& test : cases)
+        {
+            Image image;
+            REQUIRE(DecodeImage(test.file, image));
+            CHECK(image.width == 13);
+            CHECK(image.height == 11);
+            double mean = 0.0;
+            uint32 largest = 0;
+            CompareToPattern(image, test.gray, mean, largest);
+            CHECK(mean < test.maxMean);
+            CHECK(largest <= test.maxLargest);
+        }
+    }
+
+    TEST_CASE("Broken and unsupported JPEGs fail")
+    {
+        Image image;
+        for (uint64 size = 3; size < sizeof(kJpeg420) - 40; size += 9)
+        {
+            CHECK_FALSE(DecodeImage(ByteView(kJpeg420, size), image));
+        }
+
+        // A progressive frame header
+        const uint8 progressive[] = {0xff, 0xd8, 0xff, 0xc2, 0x00, 0x0b, 0x08, 0x00, 0x10,
+                                     0x00, 0x10, 0x01, 0x01, 0x11, 0x00, 0xff, 0xd9};
+        const Result<> decoded = DecodeImage(ByteView(progressive, sizeof(progressive)), image);
+        CHECK(decoded.Category() == ErrorCategory::InvalidArgument);
+
+        // Corrupt anywhere, it fails or decodes to something, never reading out of bounds
+        for (uint64 i = 2; i < sizeof(kJpeg420); ++i)
+        {
+            uint8 corrupt[sizeof(kJpeg420)];
+            std::memcpy(corrupt, kJpeg420, sizeof(kJpeg420));
+            corrupt[i] ^= 0x5a;
+            (void)DecodeImage(ByteView(corrupt, sizeof(corrupt)), image);
+        }
+    }
+
+    TEST_CASE("Block compression")
+    {
+        // 18x10 leaves partial blocks on the right and bottom
+        const Image source = TextureLike(18, 10);
+
+        Image bc1;
+        REQUIRE(CompressImage(source, ImageFormat::Bc1, bc1));
+        CHECK(bc1.format == ImageFormat::Bc1);
+        CHECK(bc1.width == 18);
+        CHECK(bc1.pixels.Size() == ImageByteSize(18, 10, ImageFormat::Bc1));
+        CHECK(CompressedPsnr(source, bc1, 3) > 38.0);
+
+        Image bc5;
+        REQUIRE(CompressImage(source, ImageFormat::Bc5, bc5));
+        CHECK(CompressedPsnr(source, bc5, 2) > 45.0);
+
+        Image bc7;
+        REQUIRE(CompressImage(source, ImageFormat::Bc7, bc7));
+        CHECK(CompressedPsnr(source, bc7, 4) > 45.0);
+
+        // A flat color comes back within the endpoints' precision
+        Image flat;
+        flat.width = 4;
+        flat.height = 4;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            const uint8 color[4] = {10, 200, 31, 255};
+            flat.pixels.Append(color, 4);
+        }
+        REQUIRE(CompressImage(flat, ImageFormat::Bc7, bc7));
+        uint8 decoded[16][4];
+        DecodeBc7(bc7.pixels.Data(), decoded);
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            CHECK(std::abs(decoded[5][c] - flat.pixels[c]) <= 1);
+        }
+        REQUIRE(CompressImage(flat, ImageFormat::Bc5, bc5));
+        CHECK(bc5.pixels[0] == 10);
+        CHECK(bc5.pixels[8] == 200);
+
+        // Two colors exactly, in BC1's four color mode
+        Image two;
+        two.width = 4;
+        two.height = 4;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            const uint8 color[2][4] = {{255, 0, 0, 255}, {0, 0, 255, 255}};
+            two.pixels.Append(color[(i / 2) % 2], 4);
+        }
+        REQUIRE(CompressImage(two, ImageFormat::Bc1, bc1));
+        CHECK(CompressedPsnr(two, bc1, 3) == 100.0);
+    }
+
+    TEST_CASE("Compressing needs an RGBA8 source and a BCn target")
+    {
+        Image source = TextureLike(4, 4);
+        Image out;
+        CHECK_FALSE(CompressImage(source, ImageFormat::Rgba8, out));
+        CHECK_FALSE(CompressImage(source, ImageFormat::Bc7, source));
+
+        Image compressed;
+        REQUIRE(CompressImage(source, ImageFormat::Bc1, compressed));
+        CHECK_FALSE(CompressImage(compressed, ImageFormat::Bc7, out));
+
+        source.pixels.Resize(8);
+        CHECK_FALSE(CompressImage(source, ImageFormat::Bc1, out));
+    }
+
+    TEST_CASE("Mip chains")
+    {
+        // 6x3 halves to 3x1, then 1x1, the odd column and row left out
+        Image source;
+        source.width = 6;
+        source.height = 3;
+        for (uint32 i = 0; i < 6 * 3; ++i)
+        {
+            const uint8 pixel[4] = {uint8(i * 10), 255, 0, uint8(i < 6 ? 0 : 200)};
+            source.pixels.Append(pixel, 4);
+        }
+        DynamicArray<Image> mips;
+        REQUIRE(GenerateMips(source, false, mips));
+        REQUIRE(mips.Size() == 2);
+        CHECK(mips[0].width == 3);
+        CHECK(mips[0].height == 1);
+        CHECK(mips[1].width == 1);
+        CHECK(mips[1].height == 1);
+        CHECK(mips[0].pixels.Size() == ImageByteSize(3, 1, ImageFormat::Rgba8));
+        // Pixels 0, 1, 6 and 7
+        CHECK(mips[0].pixels[0] == 35);
+        CHECK(mips[0].pixels[1] == 255);
+        CHECK(mips[0].pixels[3] == 100);
+        // The second of 3 columns goes into the 1x1 mip, the third doesn't
+        CHECK(mips[1].pixels[0] == (35 + 55 + 1) / 2);
+
+        // Black and white average to middle grey in linear, which is 188 in sRGB. Alpha stays
+        // linear either way.
+        Image checker;
+        checker.width = 2;
+        checker.height = 2;
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            const uint8 value = i == 0 || i == 3 ? 255 : 0;
+            const uint8 pixel[4] = {value, value, value, value};
+            checker.pixels.Append(pixel, 4);
+        }
+        REQUIRE(GenerateMips(checker, true, mips));
+        REQUIRE(mips.Size() == 1);
+        CHECK(std::abs(int32(mips[0].pixels[0]) - 188) <= 1);
+        CHECK(mips[0].pixels[3] == 128);
+        REQUIRE(GenerateMips(checker, false, mips));
+        CHECK(mips[0].pixels[0] == 128);
+
+        // A 1x1 image has nothing below it
+        Image one = TextureLike(1, 1);
+        REQUIRE(GenerateMips(one, true, mips));
+        CHECK(mips.IsEmpty());
+
+        Image compressed;
+        REQUIRE(CompressImage(TextureLike(4, 4), ImageFormat::Bc1, compressed));
+        CHECK_FALSE(GenerateMips(compressed, false, mips));
+    }
+}
@@ -0,0 +1,814 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-mesh-optimize.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-hash.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-sort.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+// Forsyth's scoring. The three vertices of the last triangle score the same whatever order they
+// went in, older entries score less the further back they are, and vertices with few triangles
+// left score more, so the last ones get used up rather than stranded.
+constexpr uint32 kMaxValence = 32;
+
+struct VertexScoreTables
+{
+    float cache[kVertexCacheSize];
+    float valence[kMaxValence + 1];
+
+    VertexScoreTables()
+    {
+        for (uint32 i = 0; i < kVertexCacheSize; ++i)
+        {
+            cache[i] = i < 3 ? 0.75f
+                             : std::pow(1.0f - float(i - 3) / float(kVertexCacheSize - 3), 1.5f);
+        }
+        valence[0] = 0.0f;
+        for (uint32 i = 1; i <= kMaxValence; ++i)
+        {
+            valence[i] = 2.0f / std::sqrt(float(i));
+        }
+    }
+};
+
+const VertexScoreTables kScores;
+
+// cache_position is -1 for a vertex that isn't in the cache. A vertex with nothing left to draw
+// scores 0, it doesn't matter where it is.
+float VertexScore(int32 cache_position, uint32 live_triangles)
+{
+    if (live_triangles == 0)
+    {
+        return 0.0f;
+    }
+    const float cache = cache_position >= 0 ? kScores.cache[cache_position] : 0.0f;
+    return cache + kScores.valence[live_triangles < kMaxValence ? live_triangles : kMaxValence];
+}
+
+// Each vertex's triangles, as ranges into one array
+struct TriangleAdjacency
+{
+    DynamicArray<uint32> counts{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<uint32> offsets{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<uint32> triangles{GetTaggedAllocator(MemoryTag::Asset)};
+
+    TriangleAdjacency(ArrayView<const uint32> indices, uint64 vertex_count)
+    {
+        counts.Resize(vertex_count);
+        offsets.Resize(vertex_count);
+        triangles.ResizeUninitialized(indices.Size());
+        for (const uint32 index : indices)
+        {
+            ++counts[index];
+        }
+        uint32 offset = 0;
+        for (uint64 v = 0; v < vertex_count; ++v)
+        {
+            offsets[v] = offset;
+            offset += counts[v];
+            counts[v] = 0;
+        }
+        for (uint64 i = 0; i < indices.Size(); ++i)
+        {
+            const uint32 v = indices[i];
+            triangles[offsets[v] + counts[v]++] = static_cast<uint32>(i / 3);
+        }
+    }
+
+    // Swaps the triangle out of the vertex's live range
+    void Remove(uint32 vertex, uint32 triangle)
+    {
+        uint32* list = triangles.Data() + offsets[vertex];
+        for (uint32 i = 0; i < counts[vertex]; ++i)
+        {
+            if (list[i] == triangle)
+            {
+                list[i] = list[--counts[vertex]];
+                return;
+            }
+        }
+    }
+};
+
+// A FIFO cache by timestamps: a vertex is in it while fewer than cache_size misses have happened
+// since its own. Returns the triangle's misses.
+uint32 SimulateTriangle(const uint32* triangle,
+                        DynamicArray<uint32>& cache_times,
+                        uint32& timestamp,
+                        uint32 cache_size)
+{
+    uint32 misses = 0;
+    for (uint32 corner = 0; corner < 3; ++corner)
+    {
+        const uint32 v = triangle[corner];
+        if (timestamp - cache_times[v] > cache_size)
+        {
+            cache_times[v] = timestamp++;
+            ++misses;
+        }
+    }
+    return misses;
+}
+
+// A plane quadric, the symmetric 4x4 matrix summing each plane's squared distance, weighted by
+// the area of the triangle it came from. Doubles, since planes far from the origin cancel out
+// most of a float's precision.
+struct Quadric
+{
+    double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+    double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+    double c = 0.0;
+    double weight = 0.0;
+
+    void AddPlane(const double normal[3], double distance, double area)
+    {
+        a00 += area * normal[0] * normal[0];
+        a11 += area * normal[1] * normal[1];
+        a22 += area * normal[2] * normal[2];
+        a01 += area * normal[0] * normal[1];
+        a02 += area * normal[0] * normal[2];
+        a12 += area * normal[1] * normal[2];
+        b0 += area * normal[0] * distance;
+        b1 += area * normal[1] * distance;
+        b2 += area * normal[2] * distance;
+        c += area * distance * distance;
+        weight += area;
+    }
+
+    Quadric& operator+=(const Quadric& other)
+    {
+        a00 += other.a00;
+        a11 += other.a11;
+        a22 += other.a22;
+        a01 += other.a01;
+        a02 += other.a02;
+        a12 += other.a12;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+        return *this;
+    }
+
+    // Squared distance from p to the planes, averaged over their area
+    double Error(const float3& p) const
+    {
+        const double x = p.x;
+        const double y = p.y;
+        const double z = p.z;
+        const double sum = a00 * x * x + a11 * y * y + a22 * z * z +
+                           2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                           2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return weight > 0.0 ? std::fabs(sum) / weight : 0.0;
+    }
+};
+
+// The triangle's normal, not normalized, twice its area long
+void TriangleNormal(const float3& a, const float3& b, const float3& c, double* normal)
+{
+    const double e1[3] = {double(b.x) - a.x, double(b.y) - a.y, double(b.z) - a.z};
+    const double e2[3] = {double(c.x) - a.x, double(c.y) - a.y, double(c.z) - a.z};
+    normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+double Dot(const double* a, const double* b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+uint64 EdgeKey(uint32 a, uint32 b)
+{
+    return a < b ? (uint64(a) << 32) | b : (uint64(b) << 32) | a;
+}
+
+// Every edge once, sorted
+DynamicArray<uint64> UniqueEdges(ArrayView<const uint32> indices, DynamicArray<uint32>* counts)
+{
+    DynamicArray<uint64> keys(GetTaggedAllocator(MemoryTag::Asset));
+    keys.ResizeUninitialized(indices.Size());
+    for (uint64 t = 0; t < indices.Size(); t += 3)
+    {
+        keys[t] = EdgeKey(indices[t], indices[t + 1]);
+        keys[t + 1] = EdgeKey(indices[t + 1], indices[t + 2]);
+        keys[t + 2] = EdgeKey(indices[t + 2], indices[t]);
+    }
+    RadixSort(ArrayView<uint64>(keys), GetTaggedAllocator(MemoryTag::Asset));
+
+    DynamicArray<uint64> edges(GetTaggedAllocator(MemoryTag::Asset));
+    for (uint64 i = 0; i < keys.Size(); ++i)
+    {
+        if (i == 0 || keys[i] != keys[i - 1])
+        {
+            edges.PushBack(keys[i]);
+            if (counts != nullptr)
+            {
+                counts->PushBack(0);
+            }
+        }
+        if (counts != nullptr)
+        {
+            ++(*counts)[counts->Size() - 1];
+        }
+    }
+    return edges;
+}
+
+// Flips a float's bits so they sort as unsigned integers in the same order
+uint32 SortableFloat(float value)
+{
+    uint32 bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+}
+} // namespace
+
+VertexCacheStats AnalyzeVertexCache(ArrayView<const uint32> indices,
+                                    uint64 vertex_count,
+                                    uint32 cache_size)
+{
+    VertexCacheStats stats;
+    stats.triangles = indices.Size() / 3;
+
+    DynamicArray<uint32> cache_times(GetTaggedAllocator(MemoryTag::Asset));
+    cache_times.Resize(vertex_count);
+    DynamicArray<uint8> used(GetTaggedAllocator(MemoryTag::Asset));
+    used.Resize(vertex_count);
+
+    // Starting past cache_size makes every vertex a miss the first time
+    uint32 timestamp = cache_size + 1;
+    for (uint64 i = 0; i + 2 < indices.Size(); i += 3)
+    {
+        stats.transforms +=
+            SimulateTriangle(indices.Data() + i, cache_times, timestamp, cache_size);
+    }
+    for (const uint32 index : indices)
+    {
+        stats.vertices += used[index] == 0 ? 1 : 0;
+        used[index] = 1;
+    }
+    return stats;
+}
+
+uint32 DeduplicateVertices(ArrayView<uint32> remap, ByteView vertices, uint64 vertex_size)
+{
+    rsblAssert(vertex_size != 0 && vertices.Size() % vertex_size == 0);
+    const uint64 vertex_count = vertices.Size() / vertex_size;
+    rsblAssert(remap.Size() == vertex_count);
+
+    // Open addressing over the first vertex of each kind, at most half full
+    const uint64 table_size = NextPowerOfTwo(vertex_count * 2 > 16 ? vertex_count * 2 : 16);
+    DynamicArray<uint32> table(GetTaggedAllocator(MemoryTag::Asset));
+    table.ResizeUninitialized(table_size);
+    std::memset(table.Data(), 0xFF, table.Size() * sizeof(uint32));
+
+    uint32 unique = 0;
+    for (uint64 v = 0; v < vertex_count; ++v)
+    {
+        const uint8* vertex = vertices.Data() + v * vertex_size;
+        uint64 slot = HashBytes(vertex, vertex_size) & (table_size - 1);
+        while (table[slot] != kUnusedVertex &&
+               std::memcmp(vertices.Data() + table[slot] * vertex_size, vertex, vertex_size) != 0)
+        {
+            slot = (slot + 1) & (table_size - 1);
+        }
+        if (table[slot] == kUnusedVertex)
+        {
+            table[slot] = static_cast<uint32>(v);
+            remap[v] = unique++;
+        }
+        else
+        {
+            remap[v] = remap[table[slot]];
+        }
+    }
+    return unique;
+}
+
+void OptimizeVertexCache(ArrayView<uint32> indices, uint64 vertex_count)
+{
+    const uint64 triangle_count = indices.Size() / 3;
+    if (triangle_count == 0)
+    {
+        return;
+    }
+
+    TriangleAdjacency adjacency(indices, vertex_count);
+
+    DynamicArray<float> vertex_scores(GetTaggedAllocator(MemoryTag::Asset));
+    vertex_scores.ResizeUninitialized(vertex_count);
+    for (uint64 v = 0; v < vertex_count; ++v)
+    {
+        vertex_scores[v] = VertexScore(-1, adjacency.counts[v]);
+    }
+    DynamicArray<float> triangle_scores(GetTaggedAllocator(MemoryTag::Asset));
+    triangle_scores.ResizeUninitialized(triangle_count);
+    for (uint64 t = 0; t < triangle_count; ++t)
+    {
+        triangle_scores[t] = vertex_scores[indices[t * 3]] + vertex_scores[indices[t * 3 + 1]] +
+                             vertex_scores[indices[t * 3 + 2]];
+    }
+
+    DynamicArray<uint8> emitted(GetTaggedAllocator(MemoryTag::Asset));
+    emitted.Resize(triangle_count);
+    DynamicArray<uint32> output(GetTaggedAllocator(MemoryTag::Asset));
+    output.ResizeUninitialized(indices.Size());
+
+    // LRU, most recent first. Three spare entries for the vertices a triangle pushes out.
+    uint32 cache[kVertexCacheSize + 3];
+    uint32 cache_count = 0;
+
+    uint64 next_unemitted = 0;
+    uint32 current = 0;
+    for (uint64 out = 0; out < triangle_count; ++out)
+    {
+        // Nothing in the cache has triangles left, take the next one in input order
+        if (current == kUnusedVertex)
+        {
+            while (emitted[next_unemitted] != 0)
+            {
+                ++next_unemitted;
+            }
+            current = static_cast<uint32>(next_unemitted);
+        }
+
+        const uint32* triangle = indices.Data() + current * 3;
+        std::memcpy(output.Data() + out * 3, triangle, 3 * sizeof(uint32));
+        emitted[current] = 1;
+
+        uint32 new_cache[kVertexCacheSize + 3];
+        uint32 new_count = 0;
+        for (uint32 corner = 0; corner < 3; ++corner)
+        {
+            adjacency.Remove(triangle[corner], current);
+            // Degenerate triangles name a vertex twice, it only takes one entry
+            if (corner == 0 || (triangle[corner] != triangle[0] &&
+                                (corner == 1 || triangle[corner] != triangle[1])))
+            {
+                new_cache[new_count++] = triangle[corner];
+            }
+        }
+        for (uint32 i = 0; i < cache_count; ++i)
+        {
+            const uint32 v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+            {
+                new_cache[new_count++] = v;
+            }
+        }
+
+        // Rescore everything in the cache and whatever just fell out of it, and pass the change
+        // on to their remaining triangles. The best of those still in the cache goes next.
+        for (uint32 i = 0; i < new_count; ++i)
+        {
+            const uint32 v = new_cache[i];
+            const int32 position = i < kVertexCacheSize ? static_cast<int32>(i) : -1;
+            const float score = VertexScore(position, adjacency.counts[v]);
+            const float delta = score - vertex_scores[v];
+            vertex_scores[v] = score;
+
+            const uint32* live = adjacency.triangles.Data() + adjacency.offsets[v];
+            for (uint32 j = 0; j < adjacency.counts[v]; ++j)
+            {
+                triangle_scores[live[j]] += delta;
+            }
+        }
+        float best_score = 0.0f;
+        current = kUnusedVertex;
+        for (uint32 i = 0; i < new_count && i < kVertexCacheSize; ++i)
+        {
+            const uint32 v = new_cache[i];
+            const uint32* live = adjacency.triangles.Data() + adjacency.offsets[v];
+            for (uint32 j = 0; j < adjacency.counts[v]; ++j)
+            {
+                if (triangle_scores[live[j]] > best_score)
+                {
+                    best_score = triangle_scores[live[j]];
+                    current = live[j];
+                }
+            }
+        }
+
+        cache_count = new_count < kVertexCacheSize ? new_count : kVertexCacheSize;
+        std::memcpy(cache, new_cache, cache_count * sizeof(uint32));
+    }
+
+    std::memcpy(indices.Data(), output.Data(), output.Size() * sizeof(uint32));
+}
+
+void OptimizeOverdraw(ArrayView<uint32> indices,
+                      ArrayView<const float3> positions,
+                      float threshold)
+{
+    const uint64 triangle_count = indices.Size() / 3;
+    if (triangle_count < 2)
+    {
+        return;
+    }
+
+    // Hard boundaries are where the cache starts over anyway, a triangle missing on all three
+    // vertices. Within those, a cluster is cut early once its ACMR is down to threshold times
+    // the whole span's, since starting a new one costs about that much again.
+    DynamicArray<uint32> cache_times(GetTaggedAllocator(MemoryTag::Asset));
+    cache_times.Resize(positions.Size());
+    uint32 timestamp = kVertexCacheSize + 1;
+    DynamicArray<uint32> hard(GetTaggedAllocator(MemoryTag::Asset));
+    for (uint64 t = 0; t < triangle_count; ++t)
+    {
+        const uint32 misses =
+            SimulateTriangle(indices.Data() + t * 3, cache_times, timestamp, kVertexCacheSize);
+        if (t == 0 || misses == 3)
+        {
+            hard.PushBack(static_cast<uint32>(t));
+        }
+    }
+    hard.PushBack(static_cast<uint32>(triangle_count));
+
+    DynamicArray<uint32> clusters(GetTaggedAllocator(MemoryTag::Asset));
+    for (uint64 h = 0; h + 1 < hard.Size(); ++h)
+    {
+        const uint32 start = hard[h];
+        const uint32 end = hard[h + 1];
+
+        timestamp += kVertexCacheSize + 1;
+        uint32 span_misses = 0;
+        for (uint32 t = start; t < end; ++t)
+        {
+            span_misses +=
+                SimulateTriangle(indices.Data() + t * 3, cache_times, timestamp, kVertexCacheSize);
+        }
+        const float target = threshold * float(span_misses) / float(end - start);
+
+        timestamp += kVertexCacheSize + 1;
+        clusters.PushBack(start);
+        uint32 cluster_start = start;
+        uint32 cluster_misses = 0;
+        for (uint32 t = start; t < end; ++t)
+        {
+            if (t > cluster_start && float(cluster_misses) <= target * float(t - cluster_start))
+            {
+                clusters.PushBack(t);
+                cluster_start = t;
+                cluster_misses = 0;
+                timestamp += kVertexCacheSize + 1;
+            }
+            cluster_misses +=
+                SimulateTriangle(indices.Data() + t * 3, cache_times, timestamp, kVertexCacheSize);
+        }
+    }
+    const uint64 cluster_count = clusters.Size();
+    clusters.PushBack(static_cast<uint32>(triangle_count));
+    if (cluster_count < 2)
+    {
+        return;
+    }
+
+    // Each cluster's area weighted centroid and normal, and the mesh's centroid
+    DynamicArray<float> centroids(GetTaggedAllocator(MemoryTag::Asset));
+    centroids.Resize(cluster_count * 3);
+    DynamicArray<float> normals(GetTaggedAllocator(MemoryTag::Asset));
+    normals.Resize(cluster_count * 3);
+    float mesh_centroid[3] = {};
+    float mesh_area = 0.0f;
+    for (uint64 cluster = 0; cluster < cluster_count; ++cluster)
+    {
+        float* centroid = centroids.Data() + cluster * 3;
+        float* normal = normals.Data() + cluster * 3;
+        float area_sum = 0.0f;
+        for (uint32 t = clusters[cluster]; t < clusters[cluster + 1]; ++t)
+        {
+            const float3& a = positions[indices[t * 3]];
+            const float3& b = positions[indices[t * 3 + 1]];
+            const float3& c = positions[indices[t * 3 + 2]];
+            const float e1[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+            const float e2[3] = {c.x - a.x, c.y - a.y, c.z - a.z};
+            const float n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                                e1[2] * e2[0] - e1[0] * e2[2],
+                                e1[0] * e2[1] - e1[1] * e2[0]};
+            const float area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            const float center[3] = {
+                (a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f};
+            for (uint32 k = 0; k < 3; ++k)
+            {
+                centroid[k] += center[k] * area;
+                normal[k] += n[k];
+                mesh_centroid[k] += center[k] * area;
+            }
+            area_sum += area;
+        }
+        for (uint32 k = 0; k < 3; ++k)
+        {
+            centroid[k] = area_sum > 0.0f ? centroid[k] / area_sum : 0.0f;
+        }
+        mesh_area += area_sum;
+    }
+    for (float& k : mesh_centroid)
+    {
+        k = mesh_area > 0.0f ? k / mesh_area : 0.0f;
+    }
+
+    // How far out along its own normal a cluster sits. Those furthest out tend to cover the
+    // rest, so they go first: sorting the negated value ascending.
+    DynamicArray<uint32> keys(GetTaggedAllocator(MemoryTag::Asset));
+    keys.ResizeUninitialized(cluster_count);
+    DynamicArray<uint32> order(GetTaggedAllocator(MemoryTag::Asset));
+    order.ResizeUninitialized(cluster_count);
+    for (uint64 cluster = 0; cluster < cluster_count; ++cluster)
+    {
+        const float* centroid = centroids.Data() + cluster * 3;
+        const float* n = normals.Data() + cluster * 3;
+        const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        float outwards = 0.0f;
+        if (length > 0.0f)
+        {
+            for (uint32 k = 0; k < 3; ++k)
+            {
+                outwards += (centroid[k] - mesh_centroid[k]) * n[k] / length;
+            }
+        }
+        keys[cluster] = SortableFloat(-outwards);
+        order[cluster] = static_cast<uint32>(cluster);
+    }
+    RadixSort(ArrayView<uint32>(keys), order, GetTaggedAllocator(MemoryTag::Asset));
+
+    DynamicArray<uint32> output(GetTaggedAllocator(MemoryTag::Asset));
+    output.Reserve(indices.Size());
+    for (const uint32 cluster : order)
+    {
+        const uint32 first = clusters[cluster];
+        output.Append(indices.Data() + first * 3, (clusters[cluster + 1] - first) * 3);
+    }
+    std::memcpy(indices.Data(), output.Data(), output.Size() * sizeof(uint32));
+}
+
+uint32 OptimizeVertexFetch(ArrayView<uint32> remap, ArrayView<const uint32> indices)
+{
+    for (uint32& entry : remap)
+    {
+        entry = kUnusedVertex;
+    }
+    uint32 next = 0;
+    for (const uint32 index : indices)
+    {
+        if (remap[index] == kUnusedVertex)
+        {
+            remap[index] = next++;
+        }
+    }
+    return next;
+}
+
+uint64 SimplifyMesh(ArrayView<uint32> destination,
+                    ArrayView<const uint32> indices,
+                    ArrayView<const float3> positions,
+                    uint64 target_index_count,
+                    float target_error,
+                    float* result_error)
+{
+    rsblAssert(destination.Size() >= indices.Size());
+    const uint64 vertex_count = positions.Size();
+    std::memcpy(destination.Data(), indices.Data(), indices.Size() * sizeof(uint32));
+    uint64 index_count = indices.Size();
+
+    // Each vertex's quadric from the triangles around it
+    DynamicArray<Quadric> quadrics(GetTaggedAllocator(MemoryTag::Asset));
+    quadrics.Resize(vertex_count);
+    for (uint64 t = 0; t < index_count; t += 3)
+    {
+        double normal[3];
+        const float3& a = positions[indices[t]];
+        TriangleNormal(a, positions[indices[t + 1]], positions[indices[t + 2]], normal);
+        const double length = std::sqrt(Dot(normal, normal));
+        if (length == 0.0)
+        {
+            continue;
+        }
+        for (double& n : normal)
+        {
+            n /= length;
+        }
+        const double distance = -(normal[0] * a.x + normal[1] * a.y + normal[2] * a.z);
+        for (uint64 corner = 0; corner < 3; ++corner)
+        {
+            quadrics[indices[t + corner]].AddPlane(normal, distance, length * 0.5);
+        }
+    }
+
+    // An edge with other than two triangles is a border, a seam or worse. Its vertices stay.
+    DynamicArray<uint8> locked(GetTaggedAllocator(MemoryTag::Asset));
+    locked.Resize(vertex_count);
+    {
+        DynamicArray<uint32> counts(GetTaggedAllocator(MemoryTag::Asset));
+        const DynamicArray<uint64> edges = UniqueEdges(indices, &counts);
+        for (uint64 e = 0; e < edges.Size(); ++e)
+        {
+            if (counts[e] != 2)
+            {
+                locked[edges[e] >> 32] = 1;
+                locked[edges[e] & 0xFFFFFFFFu] = 1;
+            }
+        }
+    }
+
+    const double max_error = double(target_error) * double(target_error);
+    double reached_error = 0.0;
+
+    DynamicArray<uint32> remap(GetTaggedAllocator(MemoryTag::Asset));
+    remap.ResizeUninitialized(vertex_count);
+    for (uint64 v = 0; v < vertex_count; ++v)
+    {
+        remap[v] = static_cast<uint32>(v);
+    }
+    DynamicArray<uint8> touched(GetTaggedAllocator(MemoryTag::Asset));
+    touched.Resize(vertex_count);
+    // Stamped with the collapse being checked, for the vertices around its from
+    DynamicArray<uint64> neighbours(GetTaggedAllocator(MemoryTag::Asset));
+    neighbours.Resize(vertex_count);
+    uint64 stamp = 0;
+
+    // Passes over every edge, cheapest collapses first. A collapse makes the triangles around it
+    // stale, so within a pass nothing near one can collapse too, the next pass picks them up.
+    while (index_count > target_index_count)
+    {
+        const ArrayView<const uint32> current(destination.Data(), index_count);
+        const DynamicArray<uint64> edges = UniqueEdges(current, nullptr);
+
+        DynamicArray<uint32> keys(GetTaggedAllocator(MemoryTag::Asset));
+        DynamicArray<uint64> collapses(GetTaggedAllocator(MemoryTag::Asset));
+        DynamicArray<float> costs(GetTaggedAllocator(MemoryTag::Asset));
+        for (const uint64 edge : edges)
+        {
+            const uint32 a = static_cast<uint32>(edge >> 32);
+            const uint32 b = static_cast<uint32>(edge & 0xFFFFFFFFu);
+            Quadric merged = quadrics[a];
+            merged += quadrics[b];
+            // From one vertex onto the other, whichever way is cheaper and allowed
+            const double a_onto_b = locked[a] != 0 ? max_error + 1.0 : merged.Error(positions[b]);
+            const double b_onto_a = locked[b] != 0 ? max_error + 1.0 : merged.Error(positions[a]);
+            const double cost = a_onto_b < b_onto_a ? a_onto_b : b_onto_a;
+            if (cost > max_error)
+            {
+                continue;
+            }
+            keys.PushBack(SortableFloat(float(cost)));
+            costs.PushBack(float(cost));
+            collapses.PushBack(a_onto_b < b_onto_a ? edge : (uint64(b) << 32) | a);
+        }
+        if (collapses.IsEmpty())
+        {
+            break;
+        }
+        DynamicArray<uint32> order(GetTaggedAllocator(MemoryTag::Asset));
+        order.ResizeUninitialized(keys.Size());
+        for (uint64 i = 0; i < order.Size(); ++i)
+        {
+            order[i] = static_cast<uint32>(i);
+        }
+        RadixSort(ArrayView<uint32>(keys), order, GetTaggedAllocator(MemoryTag::Asset));
+
+        TriangleAdjacency adjacency(current, vertex_count);
+        std::memset(touched.Data(), 0, touched.Size());
+
+        // A collapse takes about two triangles with it, stop short of overshooting the target
+        const uint64 triangles_left = (index_count - target_index_count) / 3;
+        uint64 removed = 0;
+        uint64 collapsed = 0;
+        for (uint64 i = 0; i < order.Size() && removed < triangles_left; ++i)
+        {
+            const uint64 collapse = collapses[order[i]];
+            const uint32 from = static_cast<uint32>(collapse >> 32);
+            const uint32 to = static_cast<uint32>(collapse & 0xFFFFFFFFu);
+            if (touched[from] != 0 || touched[to] != 0)
+            {
+                continue;
+            }
+
+            // Moving from onto to mustn't turn any of its other triangles over
+            const uint32* around = adjacency.triangles.Data() + adjacency.offsets[from];
+            bool flips = false;
+            uint32 shared = 0;
+            for (uint32 j = 0; j < adjacency.counts[from] && !flips; ++j)
+            {
+                const uint32* triangle = current.Data() + uint64(around[j]) * 3;
+                if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+                {
+                    ++shared;
+                    continue;
+                }
+                float3 corners[3];
+                for (uint32 k = 0; k < 3; ++k)
+                {
+                    corners[k] = positions[triangle[k]];
+                }
+                double before[3];
+                TriangleNormal(corners[0], corners[1], corners[2], before);
+                for (uint32 k = 0; k < 3; ++k)
+                {
+                    corners[k] = triangle[k] == from ? positions[to] : corners[k];
+                }
+                double after[3];
+                TriangleNormal(corners[0], corners[1], corners[2], after);
+                // More than about 75 degrees of turn counts, slivers flip easily after that
+                const double lengths = std::sqrt(Dot(before, before) * Dot(after, after));
+                flips = Dot(before, after) <= 0.25 * lengths;
+            }
+            if (flips)
+            {
+                continue;
+            }
+
+            // Only the triangles on the edge may share a third vertex with both ends, any other
+            // would end up folded back onto one of them
+            ++stamp;
+            for (uint32 j = 0; j < adjacency.counts[from]; ++j)
+            {
+                const uint32* triangle = current.Data() + uint64(around[j]) * 3;
+                neighbours[triangle[0]] = stamp;
+                neighbours[triangle[1]] = stamp;
+                neighbours[triangle[2]] = stamp;
+            }
+            neighbours[from] = 0;
+            neighbours[to] = 0;
+            uint32 common = 0;
+            const uint32* around_to = adjacency.triangles.Data() + adjacency.offsets[to];
+            for (uint32 j = 0; j < adjacency.counts[to]; ++j)
+            {
+                const uint32* triangle = current.Data() + uint64(around_to[j]) * 3;
+                for (uint32 k = 0; k < 3; ++k)
+                {
+                    if (neighbours[triangle[k]] == stamp)
+                    {
+                        neighbours[triangle[k]] = 0;
+                        ++common;
+                    }
+                }
+            }
+            if (common != shared)
+            {
+                continue;
+            }
+
+            remap[from] = to;
+            quadrics[to] += quadrics[from];
+            const double cost = costs[order[i]];
+            reached_error = cost > reached_error ? cost : reached_error;
+            removed += shared;
+            ++collapsed;
+
+            // Everything sharing a triangle with from is stale until the next pass
+            touched[to] = 1;
+            for (uint32 j = 0; j < adjacency.counts[from]; ++j)
+            {
+                const uint32* triangle = current.Data() + uint64(around[j]) * 3;
+                touched[triangle[0]] = 1;
+                touched[triangle[1]] = 1;
+                touched[triangle[2]] = 1;
+            }
+        }
+        if (collapsed == 0)
+        {
+            break;
+        }
+
+        // Apply the pass, dropping the triangles that collapsed to a line
+        uint64 kept = 0;
+        for (uint64 t = 0; t < index_count; t += 3)
+        {
+            const uint32 a = remap[destination[t]];
+            const uint32 b = remap[destination[t + 1]];
+            const uint32 c = remap[destination[t + 2]];
+            if (a != b && b != c && c != a)
+            {
+                destination[kept++] = a;
+                destination[kept++] = b;
+                destination[kept++] = c;
+            }
+        }
+        index_count = kept;
+        for (uint64 v = 0; v < vertex_count; ++v)
+        {
+            remap[v] = static_cast<uint32>(v);
+        }
+    }
+
+    if (result_error != nullptr)
+    {
+        *result_error = float(std::sqrt(reached_error));
+    }
+    return index_count;
+}
+
+} // namespace rsbl
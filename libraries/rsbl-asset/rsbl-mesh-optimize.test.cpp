@@ -0,0 +1,338 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-mesh-optimize.h"
+
+#include <rsbl-dynamic-array.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace rsbl;
+
+namespace
+{
+// A size x size grid of quads, its triangles shuffled the way a careless exporter might leave
+// them
+struct ShuffledGrid
+{
+    DynamicArray<float3> positions;
+    DynamicArray<uint32> indices;
+
+    explicit ShuffledGrid(uint32 size)
+    {
+        for (uint32 y = 0; y <= size; ++y)
+        {
+            for (uint32 x = 0; x <= size; ++x)
+            {
+                positions.PushBack(float3(float(x), float(y), 0.0f));
+            }
+        }
+        DynamicArray<uint32> quads;
+        for (uint32 i = 0; i < size * size; ++i)
+        {
+            quads.PushBack(i);
+        }
+        uint32 state = 1;
+        for (uint64 i = quads.Size() - 1; i > 0; --i)
+        {
+            state = state * 1664525 + 1013904223;
+            std::swap(quads[i], quads[(state >> 8) % (i + 1)]);
+        }
+        for (const uint32 quad : quads)
+        {
+            const uint32 corner = (quad / size) * (size + 1) + quad % size;
+            const uint32 triangles[6] = {corner,
+                                         corner + 1,
+                                         corner + size + 1,
+                                         corner + 1,
+                                         corner + size + 2,
+                                         corner + size + 1};
+            indices.Append(triangles, 6);
+        }
+    }
+};
+
+// The triangles as sorted corner triples, to check a reorder kept every one of them
+DynamicArray<uint64> TriangleSet(ArrayView<const uint32> indices)
+{
+    DynamicArray<uint64> triangles;
+    for (uint64 t = 0; t < indices.Size(); t += 3)
+    {
+        uint32 corners[3] = {indices[t], indices[t + 1], indices[t + 2]};
+        // Rotations are the same triangle, start from the smallest
+        while (corners[0] > corners[1] || corners[0] > corners[2])
+        {
+            std::rotate(corners, corners + 1, corners + 3);
+        }
+        triangles.PushBack((uint64(corners[0]) << 42) | (uint64(corners[1]) << 21) | corners[2]);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+// The six faces of a cube half_size across from the origin, each a shuffled grid, facing out
+void AddBox(float half_size, DynamicArray<float3>& positions, DynamicArray<uint32>& indices)
+{
+    for (uint32 face = 0; face < 6; ++face)
+    {
+        ShuffledGrid grid(8);
+        const uint32 base = static_cast<uint32>(positions.Size());
+        const uint32 axis = face / 2;
+        const float side = face % 2 == 0 ? -half_size : half_size;
+        for (const float3& p : grid.positions)
+        {
+            const float u = (p.x / 4.0f - 1.0f) * half_size;
+            const float v = (p.y / 4.0f - 1.0f) * half_size;
+            positions.PushBack(axis == 0   ? float3(side, u, v)
+                               : axis == 1 ? float3(u, side, v)
+                                           : float3(u, v, side));
+        }
+        // The grid faces +z. Flip the winding where that comes out facing in.
+        const bool flip = (face % 2 == 0) != (axis == 1);
+        for (uint64 i = 0; i < grid.indices.Size(); i += 3)
+        {
+            indices.PushBack(base + grid.indices[i]);
+            indices.PushBack(base + grid.indices[i + (flip ? 2 : 1)]);
+            indices.PushBack(base + grid.indices[i + (flip ? 1 : 2)]);
+        }
+    }
+}
+
+// A closed sphere of latitude rings, the poles single vertices and the rings wrapping around
+// without a seam
+void Sphere(uint32 rings,
+            uint32 segments,
+            DynamicArray<float3>& positions,
+            DynamicArray<uint32>& indices)
+{
+    positions.PushBack(float3(0.0f, 1.0f, 0.0f));
+    for (uint32 ring = 1; ring < rings; ++ring)
+    {
+        const float theta = 3.14159265f * float(ring) / float(rings);
+        for (uint32 segment = 0; segment < segments; ++segment)
+        {
+            const float phi = 6.2831853f * float(segment) / float(segments);
+            positions.PushBack(float3(
+                std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+    positions.PushBack(float3(0.0f, -1.0f, 0.0f));
+
+    const uint32 bottom = static_cast<uint32>(positions.Size() - 1);
+    for (uint32 segment = 0; segment < segments; ++segment)
+    {
+        const uint32 next = (segment + 1) % segments;
+        const uint32 top[3] = {0, 1 + next, 1 + segment};
+        indices.Append(top, 3);
+        const uint32 last = 1 + (rings - 2) * segments;
+        const uint32 base[3] = {bottom, last + segment, last + next};
+        indices.Append(base, 3);
+        for (uint32 ring = 1; ring + 1 < rings; ++ring)
+        {
+            const uint32 upper = 1 + (ring - 1) * segments;
+            const uint32 lower = upper + segments;
+            const uint32 quad[6] = {upper + segment,
+                                    upper + next,
+                                    lower + segment,
+                                    upper + next,
+                                    lower + next,
+                                    lower + segment};
+            indices.Append(quad, 6);
+        }
+    }
+}
+
+bool SameTriangles(ArrayView<const uint32> indices, const DynamicArray<uint64>& triangles)
+{
+    const DynamicArray<uint64> now = TriangleSet(indices);
+    return now.Size() == triangles.Size() && std::equal(now.begin(), now.end(), triangles.begin());
+}
+} // namespace
+
+TEST_SUITE("rsbl::MeshOptimize")
+{
+    TEST_CASE("Analyzing a triangle list")
+    {
+        // Two triangles sharing an edge: four transforms, whatever the cache size
+        const uint32 quad[6] = {0, 1, 2, 2, 1, 3};
+        VertexCacheStats stats = AnalyzeVertexCache(quad, 4);
+        CHECK(stats.triangles == 2);
+        CHECK(stats.vertices == 4);
+        CHECK(stats.transforms == 4);
+        CHECK(stats.Acmr() == 2.0f);
+        CHECK(stats.Atvr() == 1.0f);
+
+        // A cache of 3 has pushed vertex 0 out again by the time it comes back
+        const uint32 fan[9] = {0, 1, 2, 3, 4, 5, 0, 1, 2};
+        stats = AnalyzeVertexCache(fan, 6, 3);
+        CHECK(stats.transforms == 9);
+        stats = AnalyzeVertexCache(fan, 6, 6);
+        CHECK(stats.transforms == 6);
+
+        CHECK(AnalyzeVertexCache({}, 0).Acmr() == 0.0f);
+    }
+
+    TEST_CASE("Vertex cache order")
+    {
+        ShuffledGrid grid(32);
+        const VertexCacheStats before = AnalyzeVertexCache(grid.indices, grid.positions.Size());
+        const DynamicArray<uint64> triangles = TriangleSet(grid.indices);
+
+        OptimizeVertexCache(grid.indices, grid.positions.Size());
+        const VertexCacheStats after = AnalyzeVertexCache(grid.indices, grid.positions.Size());
+
+        // Shuffled, only the two halves of a quad share anything. A good order on a grid gets
+        // well under 1.
+        CHECK(before.Acmr() > 1.8f);
+        CHECK(after.Acmr() < 0.85f);
+        CHECK(after.Atvr() < 1.5f);
+        CHECK(SameTriangles(grid.indices, triangles));
+    }
+
+    TEST_CASE("Overdraw order puts the outside first, within the threshold")
+    {
+        // A small box inside a big one, the small one first
+        DynamicArray<float3> positions;
+        DynamicArray<uint32> indices;
+        AddBox(1.0f, positions, indices);
+        const uint64 inner_vertices = positions.Size();
+        AddBox(4.0f, positions, indices);
+
+        OptimizeVertexCache(indices, positions.Size());
+        const DynamicArray<uint64> triangles = TriangleSet(indices);
+        const float cache_order = AnalyzeVertexCache(indices, positions.Size()).Acmr();
+
+        OptimizeOverdraw(indices, positions, 1.05f);
+        CHECK(SameTriangles(indices, triangles));
+        CHECK(indices[0] >= inner_vertices);
+        CHECK(indices[indices.Size() - 1] < inner_vertices);
+        // Cutting clusters restarts the cache, which the threshold bounds. The cuts land a
+        // little late, so leave some room.
+        CHECK(AnalyzeVertexCache(indices, positions.Size()).Acmr() <= cache_order * 1.15f);
+
+        OptimizeOverdraw(indices, positions, 1.0f);
+        CHECK(SameTriangles(indices, triangles));
+    }
+
+    TEST_CASE("Deduplicating and fetch order")
+    {
+        struct Vertex
+        {
+            float x;
+            uint32 tag;
+        };
+        const Vertex vertices[6] = {
+            {1.0f, 1}, {2.0f, 2}, {1.0f, 1}, {3.0f, 3}, {2.0f, 2}, {1.0f, 2}};
+        uint32 remap[6];
+        const uint32 unique = DeduplicateVertices(
+            remap,
+            ByteView(reinterpret_cast<const uint8*>(vertices), sizeof(vertices)),
+            sizeof(Vertex));
+        CHECK(unique == 4);
+        const uint32 expected_remap[6] = {0, 1, 0, 2, 1, 3};
+        CHECK(std::equal(remap, remap + 6, expected_remap));
+
+        Vertex merged[4] = {};
+        RemapVertices<Vertex>(merged, vertices, remap);
+        CHECK(merged[2].x == 3.0f);
+        CHECK(merged[3].tag == 2);
+
+        // Vertex 1 unused, the rest in first use order
+        uint32 indices[6] = {3, 0, 2, 2, 0, 3};
+        uint32 fetch[4];
+        CHECK(OptimizeVertexFetch(fetch, indices) == 3);
+        const uint32 expected_fetch[4] = {1, kUnusedVertex, 2, 0};
+        CHECK(std::equal(fetch, fetch + 4, expected_fetch));
+        RemapIndices(indices, fetch);
+        const uint32 expected_indices[6] = {0, 1, 2, 2, 1, 0};
+        CHECK(std::equal(indices, indices + 6, expected_indices));
+    }
+
+    TEST_CASE("Simplifying keeps flat regions flat and borders in place")
+    {
+        ShuffledGrid grid(32);
+        DynamicArray<uint32> simplified;
+        simplified.Resize(grid.indices.Size());
+        float error = -1.0f;
+        const uint64 count = SimplifyMesh(
+            simplified, grid.indices, grid.positions, grid.indices.Size() / 10, 0.01f, &error);
+        CHECK(count % 3 == 0);
+        CHECK(count <= grid.indices.Size() / 4);
+        CHECK(error == doctest::Approx(0.0f));
+
+        // Still covers the square exactly once, facing the same way, and every border vertex
+        // is still used
+        double area = 0.0;
+        DynamicArray<uint8> used;
+        used.Resize(grid.positions.Size());
+        for (uint64 i = 0; i < count; i += 3)
+        {
+            const float3& a = grid.positions[simplified[i]];
+            const float3& b = grid.positions[simplified[i + 1]];
+            const float3& c = grid.positions[simplified[i + 2]];
+            const double z = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+            CHECK(z > 0.0);
+            area += z * 0.5;
+            used[simplified[i]] = used[simplified[i + 1]] = used[simplified[i + 2]] = 1;
+        }
+        CHECK(area == doctest::Approx(32.0 * 32.0));
+        for (uint32 i = 0; i <= 32; ++i)
+        {
+            CHECK(used[i] != 0);
+            CHECK(used[32 * 33 + i] != 0);
+            CHECK(used[i * 33] != 0);
+            CHECK(used[i * 33 + 32] != 0);
+        }
+    }
+
+    TEST_CASE("Simplifying a curved surface stops at the error limit")
+    {
+        DynamicArray<float3> positions;
+        DynamicArray<uint32> indices;
+        Sphere(24, 48, positions, indices);
+        DynamicArray<uint32> simplified;
+        simplified.Resize(indices.Size());
+
+        // A loose limit, it gets down to the target
+        float coarse_error = 0.0f;
+        const uint64 coarse = SimplifyMesh(
+            simplified, indices, positions, indices.Size() / 8, 0.2f, &coarse_error);
+        CHECK(coarse <= indices.Size() / 8 + 3 * 16);
+        CHECK(coarse >= indices.Size() / 16);
+        CHECK(coarse_error > 0.0f);
+        CHECK(coarse_error < 0.1f);
+
+        // Each triangle still faces out
+        for (uint64 i = 0; i < coarse; i += 3)
+        {
+            const float3& a = positions[simplified[i]];
+            const float3& b = positions[simplified[i + 1]];
+            const float3& c = positions[simplified[i + 2]];
+            const float3 e1(b.x - a.x, b.y - a.y, b.z - a.z);
+            const float3 e2(c.x - a.x, c.y - a.y, c.z - a.z);
+            const float3 n(
+                e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x);
+            const float3 center(a.x + b.x + c.x, a.y + b.y + c.y, a.z + b.z + c.z);
+            // Slivers along a meridian end up side on, which is fine, inside out isn't
+            const float lengths = std::sqrt((n.x * n.x + n.y * n.y + n.z * n.z) *
+                                            (center.x * center.x + center.y * center.y +
+                                             center.z * center.z));
+            CHECK(n.x * center.x + n.y * center.y + n.z * center.z > -0.1f * lengths);
+        }
+
+        // A tight limit stops it early, within the limit
+        float fine_error = 0.0f;
+        const uint64 fine = SimplifyMesh(
+            simplified, indices, positions, indices.Size() / 8, 0.002f, &fine_error);
+        CHECK(fine > coarse);
+        CHECK(fine < indices.Size());
+        CHECK(fine_error <= 0.002f);
+
+        // Nothing can go at all under a zero limit
+        CHECK(SimplifyMesh(simplified, indices, positions, 0, 0.0f) == indices.Size());
+    }
+}
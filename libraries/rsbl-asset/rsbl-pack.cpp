@@ -0,0 +1,595 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-pack.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-file.h>
+#include <rsbl-hash.h>
+#include <rsbl-memory-tracking.h>
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kPackMagic = 0x4B415052; // "RPAK"
+// 2 added compressed blocks
+constexpr uint32 kPackVersion = 2;
+
+// Assets start on this, the table of contents on 8
+constexpr uint64 kDataAlignment = 16;
+
+// Last thing in the file
+struct PackFooter
+{
+    uint64 tableOffset;
+    uint64 namesOffset;
+    uint64 namesSize;
+    uint32 entryCount;
+    // Power of two, at least twice entryCount so probes stay short
+    uint32 slotCount;
+    // Decompressed size of every block of a compressed asset but its last
+    uint32 blockSize;
+    uint32 reserved;
+    uint32 version;
+    uint32 magic;
+};
+
+static_assert(sizeof(PackFooter) == 48, "PackFooter is stored as is, it can't change size");
+
+constexpr uint32 kMinBlockSize = 4 * 1024;
+constexpr uint32 kMaxBlockSize = 16 * 1024 * 1024;
+
+uint64 BlockCountFor(uint64 size, uint64 block_size)
+{
+    return (size + block_size - 1) / block_size;
+}
+
+Result<> WritePadding(FileHandle file, uint64& position, uint64 alignment)
+{
+    static const uint8 kZeros[kDataAlignment] = {};
+    const uint64 padding = AlignUp(position, alignment) - position;
+    if (padding == 0)
+    {
+        return ResultCode::Success;
+    }
+    Result<uint64> written = WriteFile(file, ByteView(kZeros, padding));
+    if (!written)
+    {
+        return PendingFailure{written.Category()};
+    }
+    position += padding;
+    return ResultCode::Success;
+}
+} // namespace
+
+struct PackWriter::State
+{
+    FileHandle file = 0;
+    bool open = false;
+    uint32 blockSize = 0;
+    uint64 position = 0;
+    DynamicArray<PackEntry> entries;
+    DynamicArray<char> names;
+
+    // Reused between compressed assets
+    DynamicArray<uint8> stored;
+    DynamicArray<uint8> block;
+
+    // The block table and blocks for data in stored. False when that came out no smaller.
+    bool Compress(ByteView data, CompressionLevel level);
+};
+
+bool PackWriter::State::Compress(ByteView data, CompressionLevel level)
+{
+    const uint64 block_count = BlockCountFor(data.Size(), blockSize);
+    const uint64 table_size = block_count * sizeof(uint64);
+    stored.Resize(table_size);
+    block.Resize(Lz4CompressBound(blockSize));
+
+    for (uint64 i = 0; i < block_count; ++i)
+    {
+        const uint64 start = i * blockSize;
+        const uint64 size = data.Size() - start < blockSize ? data.Size() - start : blockSize;
+        const ByteView input = data.Subview(start, size);
+
+        const uint64 compressed = Lz4Compress(input, MutableByteView(block), level);
+        if (compressed < size)
+        {
+            stored.Append(block.Data(), compressed);
+        }
+        else
+        {
+            stored.Append(input.Data(), size);
+        }
+        if (stored.Size() >= data.Size())
+        {
+            return false;
+        }
+
+        const uint64 end = stored.Size() - table_size;
+        std::memcpy(stored.Data() + i * sizeof(uint64), &end, sizeof(end));
+    }
+    return true;
+}
+
+Result<UniquePtr<PackWriter>> PackWriter::Create(const char* path,
+                                                 const PackWriterOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (!IsPowerOfTwo(options.blockSize) || options.blockSize < kMinBlockSize ||
+        options.blockSize > kMaxBlockSize)
+    {
+        return {ErrorCategory::InvalidArgument, "Pack block size out of range"};
+    }
+
+    Result<FileHandle> file = OpenFile(path, FileOpenMode::Write);
+    if (!file)
+    {
+        return PendingFailure{file.Category()};
+    }
+
+    UniquePtr<PackWriter> writer(new PackWriter());
+    writer->m_state = new State();
+    writer->m_state->file = file.Value();
+    writer->m_state->open = true;
+    writer->m_state->blockSize = options.blockSize;
+    return rsblMove(writer);
+}
+
+PackWriter::~PackWriter()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+    if (m_state->open)
+    {
+        (void)CloseFile(m_state->file);
+    }
+    delete m_state;
+}
+
+Result<> PackWriter::Add(StringView name,
+                         ByteView data,
+                         PackCompression compression,
+                         CompressionLevel level)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    State* state = m_state;
+    if (!state->open)
+    {
+        return {ErrorCategory::InvalidArgument, "Pack is already finished"};
+    }
+
+    Result<> padded = WritePadding(state->file, state->position, kDataAlignment);
+    if (!padded)
+    {
+        return padded;
+    }
+
+    ByteView stored = data;
+    if (compression == PackCompression::Lz4 && !data.IsEmpty() && state->Compress(data, level))
+    {
+        stored = ByteView(state->stored);
+    }
+    else
+    {
+        compression = PackCompression::None;
+    }
+
+    Result<uint64> written = WriteFile(state->file, stored);
+    if (!written)
+    {
+        return PendingFailure{written.Category()};
+    }
+
+    PackEntry entry;
+    entry.nameHash = Hash<StringView>()(name);
+    entry.offset = state->position;
+    entry.storedSize = stored.Size();
+    entry.size = data.Size();
+    entry.compression = compression;
+    entry.nameOffset = static_cast<uint32>(state->names.Size());
+    entry.nameSize = static_cast<uint32>(name.Size());
+    state->entries.PushBack(entry);
+    state->names.Append(name.Data(), name.Size());
+
+    state->position += stored.Size();
+    return ResultCode::Success;
+}
+
+Result<> PackWriter::Finish()
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    State* state = m_state;
+    if (!state->open)
+    {
+        return {ErrorCategory::InvalidArgument, "Pack is already finished"};
+    }
+
+    const uint32 entry_count = static_cast<uint32>(state->entries.Size());
+    const uint32 slot_count =
+        static_cast<uint32>(NextPowerOfTwo(entry_count > 0 ? uint64(entry_count) * 2 : 1));
+    const uint64 mask = slot_count - 1;
+
+    DynamicArray<PackEntry> table;
+    table.Resize(slot_count);
+    for (PackEntry& slot : table)
+    {
+        slot.nameOffset = kPackEmptySlot;
+    }
+
+    for (const PackEntry& entry : state->entries)
+    {
+        uint64 slot = entry.nameHash & mask;
+        while (table[slot].nameOffset != kPackEmptySlot)
+        {
+            const PackEntry& other = table[slot];
+            if (other.nameHash == entry.nameHash && other.nameSize == entry.nameSize &&
+                std::memcmp(state->names.Data() + other.nameOffset,
+                            state->names.Data() + entry.nameOffset,
+                            entry.nameSize) == 0)
+            {
+                return {ErrorCategory::InvalidArgument, "Name added to the pack twice"};
+            }
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = entry;
+    }
+
+    Result<> padded = WritePadding(state->file, state->position, alignof(PackEntry));
+    if (!padded)
+    {
+        return padded;
+    }
+
+    PackFooter footer = {};
+    footer.tableOffset = state->position;
+    footer.namesOffset = footer.tableOffset + table.Size() * sizeof(PackEntry);
+    footer.namesSize = state->names.Size();
+    footer.entryCount = entry_count;
+    footer.slotCount = slot_count;
+    footer.blockSize = state->blockSize;
+    footer.version = kPackVersion;
+    footer.magic = kPackMagic;
+
+    const ByteView parts[] = {
+        ByteView(reinterpret_cast<const uint8*>(table.Data()), table.Size() * sizeof(PackEntry)),
+        ByteView(reinterpret_cast<const uint8*>(state->names.Data()), state->names.Size()),
+        ByteView(reinterpret_cast<const uint8*>(&footer), sizeof(footer)),
+    };
+    Result<uint64> written = WriteFileGather(state->file, parts);
+    if (!written)
+    {
+        return PendingFailure{written.Category()};
+    }
+
+    state->open = false;
+    return CloseFile(state->file);
+}
+
+namespace
+{
+// Has source fill in the footer, then the table and names it points at: everything Open maps.
+// A footer that makes no sense is left for Open to report.
+Result<> EnsureTableOfContents(const char* path, PackByteSource& source)
+{
+    Result<FileHandle> file = OpenFile(path, FileOpenMode::Read);
+    if (!file)
+    {
+        return PendingFailure{file.Category()};
+    }
+    Result<uint64> size = GetFileSize(file.Value());
+    Result<> ensured = ResultCode::Success;
+    PackFooter footer = {};
+    if (!size)
+    {
+        ensured = PendingFailure{size.Category()};
+    }
+    else if (size.Value() >= sizeof(footer))
+    {
+        const uint64 footer_offset = size.Value() - sizeof(footer);
+        ensured = source.Ensure(footer_offset, sizeof(footer));
+        if (ensured)
+        {
+            Result<uint64> read =
+                ReadFileAt(file.Value(), AsWritableBytes(&footer, sizeof(footer)), footer_offset);
+            if (!read)
+            {
+                ensured = PendingFailure{read.Category()};
+            }
+        }
+        const uint64 names_end = footer.namesOffset + footer.namesSize;
+        if (ensured && footer.magic == kPackMagic && footer.tableOffset <= names_end &&
+            names_end <= footer_offset)
+        {
+            ensured = source.Ensure(footer.tableOffset, names_end - footer.tableOffset);
+        }
+    }
+    (void)CloseFile(file.Value());
+    return ensured;
+}
+} // namespace
+
+struct Pack::State
+{
+    // The whole pack is mapped, but only the table and names are ever touched through it
+    MappedFile mapped;
+    FileHandle file = 0;
+    // nullptr when the file is all there
+    PackByteSource* source = nullptr;
+    const PackEntry* table = nullptr;
+    const char* names = nullptr;
+    uint64 namesSize = 0;
+    uint32 entryCount = 0;
+    uint32 slotCount = 0;
+    uint32 blockSize = 0;
+};
+
+Result<UniquePtr<Pack>> Pack::Open(const char* path)
+{
+    return Open(path, nullptr);
+}
+
+Result<UniquePtr<Pack>> Pack::Open(const char* path, PackByteSource* source)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (source != nullptr)
+    {
+        Result<> ensured = EnsureTableOfContents(path, *source);
+        if (!ensured)
+        {
+            return PendingFailure{ensured.Category()};
+        }
+    }
+
+    Result<MappedFile> mapped = MapFile(path);
+    if (!mapped)
+    {
+        return PendingFailure{mapped.Category()};
+    }
+
+    const ByteView bytes = mapped.Value().View();
+    if (bytes.Size() < sizeof(PackFooter))
+    {
+        return {ErrorCategory::InvalidArgument, "Too small to be a pack"};
+    }
+
+    PackFooter footer;
+    std::memcpy(&footer, bytes.Data() + bytes.Size() - sizeof(footer), sizeof(footer));
+    if (footer.magic != kPackMagic)
+    {
+        return {ErrorCategory::InvalidArgument, "Not a pack, or one that was never finished"};
+    }
+    if (footer.version != kPackVersion)
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "Pack version %u, expected %u",
+                             footer.version,
+                             kPackVersion);
+    }
+
+    const uint64 table_end = footer.tableOffset + uint64(footer.slotCount) * sizeof(PackEntry);
+    if (!IsPowerOfTwo(footer.slotCount) || footer.tableOffset % alignof(PackEntry) != 0 ||
+        !IsPowerOfTwo(footer.blockSize) || footer.blockSize < kMinBlockSize ||
+        footer.blockSize > kMaxBlockSize ||
+        footer.namesOffset != table_end ||
+        footer.namesOffset + footer.namesSize > bytes.Size() - sizeof(footer))
+    {
+        return {ErrorCategory::InvalidArgument, "Pack table of contents is corrupt"};
+    }
+
+    Result<FileHandle> file = OpenFile(path, FileOpenMode::Read);
+    if (!file)
+    {
+        return PendingFailure{file.Category()};
+    }
+
+    UniquePtr<Pack> pack(new Pack());
+    pack->m_state = new State();
+    State* state = pack->m_state;
+    state->mapped = rsblMove(mapped.Value());
+    state->file = file.Value();
+    state->source = source;
+    state->table = reinterpret_cast<const PackEntry*>(bytes.Data() + footer.tableOffset);
+    state->names = reinterpret_cast<const char*>(bytes.Data() + footer.namesOffset);
+    state->namesSize = footer.namesSize;
+    state->entryCount = footer.entryCount;
+    state->slotCount = footer.slotCount;
+    state->blockSize = footer.blockSize;
+    return rsblMove(pack);
+}
+
+Pack::~Pack()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+    (void)CloseFile(m_state->file);
+    delete m_state;
+}
+
+const PackEntry* Pack::Find(StringView name, uint64 hash) const
+{
+    const State* state = m_state;
+    const uint64 mask = state->slotCount - 1;
+    uint64 slot = hash & mask;
+    // Always at least one empty slot, so this ends
+    for (;;)
+    {
+        const PackEntry& entry = state->table[slot];
+        if (entry.nameOffset == kPackEmptySlot)
+        {
+            return nullptr;
+        }
+        if (entry.nameHash == hash && EntryName(entry) == name)
+        {
+            return &entry;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+const PackEntry* Pack::Find(StringView name) const
+{
+    return Find(name, Hash<StringView>()(name));
+}
+
+Result<uint64> Pack::Read(const PackEntry& entry, MutableByteView buffer) const
+{
+    if (buffer.Size() < entry.size)
+    {
+        return {ErrorCategory::InvalidArgument, "Buffer too small for the pack entry"};
+    }
+
+    switch (entry.compression)
+    {
+    case PackCompression::None:
+        return ReadStored(entry, buffer);
+    case PackCompression::Lz4:
+        break;
+    default:
+        return {ErrorCategory::InvalidArgument, "Unknown pack compression"};
+    }
+
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    DynamicArray<uint8> stored;
+    stored.ResizeUninitialized(entry.storedSize);
+    Result<uint64> read = ReadStored(entry, MutableByteView(stored));
+    if (!read)
+    {
+        return read;
+    }
+
+    const uint32 block_count = BlockCount(entry);
+    for (uint32 block = 0; block < block_count; ++block)
+    {
+        Result<> decompressed = DecompressBlock(entry, ByteView(stored), block, buffer);
+        if (!decompressed)
+        {
+            return PendingFailure{decompressed.Category()};
+        }
+    }
+    return entry.size;
+}
+
+Result<uint64> Pack::ReadStored(const PackEntry& entry, MutableByteView buffer) const
+{
+    if (buffer.Size() < entry.storedSize)
+    {
+        return {ErrorCategory::InvalidArgument, "Buffer too small for the pack entry"};
+    }
+
+    if (m_state->source != nullptr)
+    {
+        Result<> ensured = m_state->source->Ensure(entry.offset, entry.storedSize);
+        if (!ensured)
+        {
+            return PendingFailure{ensured.Category()};
+        }
+    }
+
+    Result<uint64> read =
+        ReadFileAt(m_state->file, buffer.Subview(0, entry.storedSize), entry.offset);
+    if (!read)
+    {
+        return read;
+    }
+    if (read.Value() != entry.storedSize)
+    {
+        return {ErrorCategory::Io, "Pack entry runs past the end of the file"};
+    }
+    return read;
+}
+
+uint32 Pack::BlockCount(const PackEntry& entry) const
+{
+    if (entry.compression == PackCompression::None)
+    {
+        return 1;
+    }
+    return static_cast<uint32>(BlockCountFor(entry.size, m_state->blockSize));
+}
+
+Result<> Pack::DecompressBlock(const PackEntry& entry,
+                               ByteView stored,
+                               uint32 block,
+                               MutableByteView out) const
+{
+    const uint64 block_size = m_state->blockSize;
+    const uint64 block_count = BlockCount(entry);
+    const uint64 table_size = block_count * sizeof(uint64);
+    if (entry.compression != PackCompression::Lz4 || block >= block_count ||
+        entry.storedSize < table_size || stored.Size() < entry.storedSize ||
+        out.Size() < entry.size)
+    {
+        return {ErrorCategory::InvalidArgument, "Not a block of this pack entry"};
+    }
+
+    uint64 start = 0;
+    uint64 end = 0;
+    if (block > 0)
+    {
+        std::memcpy(&start, stored.Data() + (block - 1) * sizeof(uint64), sizeof(uint64));
+    }
+    std::memcpy(&end, stored.Data() + block * sizeof(uint64), sizeof(uint64));
+    if (start > end || end > entry.storedSize - table_size)
+    {
+        return {ErrorCategory::InvalidArgument, "Pack block table is corrupt"};
+    }
+
+    const uint64 out_start = block * block_size;
+    const uint64 out_size =
+        entry.size - out_start < block_size ? entry.size - out_start : block_size;
+    const ByteView input = stored.Subview(table_size + start, end - start);
+    const MutableByteView output = out.Subview(out_start, out_size);
+
+    // Blocks that didn't compress are stored as is
+    if (input.Size() == out_size)
+    {
+        std::memcpy(output.Data(), input.Data(), out_size);
+        return ResultCode::Success;
+    }
+
+    Result<uint64> decompressed = Lz4Decompress(input, output);
+    if (!decompressed)
+    {
+        return PendingFailure{decompressed.Category()};
+    }
+    if (decompressed.Value() != out_size)
+    {
+        return {ErrorCategory::InvalidArgument, "Pack block decompressed to the wrong size"};
+    }
+    return ResultCode::Success;
+}
+
+uint32 Pack::BlockSize() const
+{
+    return m_state->blockSize;
+}
+
+uint32 Pack::EntryCount() const
+{
+    return m_state->entryCount;
+}
+
+StringView Pack::EntryName(const PackEntry& entry) const
+{
+    if (uint64(entry.nameOffset) + entry.nameSize > m_state->namesSize)
+    {
+        return StringView();
+    }
+    return StringView(m_state->names + entry.nameOffset, entry.nameSize);
+}
+
+} // namespace rsbl
@@ -0,0 +1,236 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-pack.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-file.h>
+#include <rsbl-string-id.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kPackPath = "rsbl-pack-test.rpak";
+
+// Compressible, but not trivially
+DynamicArray<uint8> MakeAsset(uint64 size, uint32 seed)
+{
+    DynamicArray<uint8> data;
+    data.Resize(size);
+    uint32 state = seed;
+    for (uint64 i = 0; i < size; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        data[i] = static_cast<uint8>('a' + (state >> 28));
+    }
+    return data;
+}
+
+DynamicArray<uint8> MakeNoise(uint64 size)
+{
+    DynamicArray<uint8> data;
+    data.Resize(size);
+    uint64 state = 7;
+    for (uint64 i = 0; i < size; ++i)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        data[i] = static_cast<uint8>(state >> 56);
+    }
+    return data;
+}
+} // namespace
+
+TEST_SUITE("rsbl::Pack")
+{
+    TEST_CASE("Writing and reading back a pack")
+    {
+        constexpr uint32 kCount = 500;
+        char name[64];
+        char data[64];
+        {
+            Result<UniquePtr<PackWriter>> writer = PackWriter::Create(kPackPath);
+            REQUIRE(writer);
+            for (uint32 i = 0; i < kCount; ++i)
+            {
+                std::snprintf(name, sizeof(name), "textures/tex-%u.png", i);
+                const int size = std::snprintf(data, sizeof(data), "contents of %u", i);
+                REQUIRE(writer.Value()->Add(StringView(name), AsBytes(data, size)));
+            }
+            // Empty assets are fine
+            REQUIRE(writer.Value()->Add(StringView("empty.bin"), ByteView()));
+            REQUIRE(writer.Value()->Finish());
+            CHECK_FALSE(writer.Value()->Add(StringView("late.bin"), ByteView()));
+        }
+
+        Result<UniquePtr<Pack>> pack = Pack::Open(kPackPath);
+        REQUIRE(pack);
+        CHECK(pack.Value()->EntryCount() == kCount + 1);
+
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            std::snprintf(name, sizeof(name), "textures/tex-%u.png", i);
+            const int size = std::snprintf(data, sizeof(data), "contents of %u", i);
+
+            // Found by the hash StringId already has
+            const StringId id(name);
+            const PackEntry* entry = pack.Value()->Find(id.View(), id.GetHash());
+            REQUIRE(entry != nullptr);
+            CHECK(entry->size == uint64(size));
+            CHECK(entry->offset % 16 == 0);
+            CHECK(pack.Value()->EntryName(*entry) == id.View());
+
+            char buffer[64] = {};
+            Result<uint64> read =
+                pack.Value()->Read(*entry, AsWritableBytes(buffer, sizeof(buffer)));
+            REQUIRE(read);
+            CHECK(read.Value() == uint64(size));
+            CHECK(std::memcmp(buffer, data, size) == 0);
+
+            // Too small a buffer
+            CHECK_FALSE(pack.Value()->Read(*entry, AsWritableBytes(buffer, 2)));
+        }
+
+        const PackEntry* empty = pack.Value()->Find(StringView("empty.bin"));
+        REQUIRE(empty != nullptr);
+        CHECK(empty->size == 0);
+        CHECK(pack.Value()->Find(StringView("textures/tex-500.png")) == nullptr);
+        CHECK(pack.Value()->Find(StringView("")) == nullptr);
+
+        pack.Value().Reset();
+        std::remove(kPackPath);
+    }
+
+    TEST_CASE("Compressed assets")
+    {
+        PackWriterOptions options;
+        options.blockSize = 64 * 1024;
+        const DynamicArray<uint8> fast = MakeAsset(300 * 1024 + 17, 1);
+        const DynamicArray<uint8> high = MakeAsset(200 * 1024, 2);
+        // One block, and short, but repetitive enough to shrink
+        DynamicArray<uint8> small;
+        small.Resize(100);
+        for (uint64 i = 0; i < small.Size(); ++i)
+        {
+            small[i] = static_cast<uint8>('a' + i % 5);
+        }
+        const DynamicArray<uint8> noise = MakeNoise(100 * 1024);
+        {
+            Result<UniquePtr<PackWriter>> writer = PackWriter::Create(kPackPath, options);
+            REQUIRE(writer);
+            PackWriter& w = *writer.Value();
+            REQUIRE(w.Add(StringView("fast.bin"), ByteView(fast), PackCompression::Lz4));
+            REQUIRE(w.Add(StringView("high.bin"),
+                          ByteView(high),
+                          PackCompression::Lz4,
+                          CompressionLevel::High));
+            REQUIRE(w.Add(StringView("small.bin"), ByteView(small), PackCompression::Lz4));
+            REQUIRE(w.Add(StringView("noise.bin"), ByteView(noise), PackCompression::Lz4));
+            REQUIRE(w.Add(StringView("empty.bin"), ByteView(), PackCompression::Lz4));
+            REQUIRE(w.Finish());
+        }
+
+        Result<UniquePtr<Pack>> opened = Pack::Open(kPackPath);
+        REQUIRE(opened);
+        const Pack& pack = *opened.Value();
+        CHECK(pack.BlockSize() == options.blockSize);
+
+        for (const char* name : {"fast.bin", "high.bin", "small.bin"})
+        {
+            const DynamicArray<uint8>& expected =
+                name[0] == 'f' ? fast : (name[0] == 'h' ? high : small);
+            const PackEntry* entry = pack.Find(StringView(name));
+            REQUIRE(entry != nullptr);
+            CHECK(entry->compression == PackCompression::Lz4);
+            CHECK(entry->size == expected.Size());
+            CHECK(entry->storedSize < expected.Size());
+
+            DynamicArray<uint8> out;
+            out.Resize(entry->size);
+            Result<uint64> read = pack.Read(*entry, MutableByteView(out));
+            REQUIRE(read);
+            CHECK(read.Value() == expected.Size());
+            CHECK(std::memcmp(out.Data(), expected.Data(), expected.Size()) == 0);
+        }
+
+        // Blocks decompress in any order, each into its own part of the output
+        const PackEntry* entry = pack.Find(StringView("fast.bin"));
+        REQUIRE(entry != nullptr);
+        CHECK(pack.BlockCount(*entry) == 5);
+        DynamicArray<uint8> stored;
+        stored.Resize(entry->storedSize);
+        REQUIRE(pack.ReadStored(*entry, MutableByteView(stored)));
+        DynamicArray<uint8> out;
+        out.Resize(entry->size);
+        for (uint32 block = pack.BlockCount(*entry); block-- > 0;)
+        {
+            REQUIRE(pack.DecompressBlock(*entry, ByteView(stored), block, MutableByteView(out)));
+        }
+        CHECK(std::memcmp(out.Data(), fast.Data(), fast.Size()) == 0);
+        CHECK_FALSE(pack.DecompressBlock(*entry, ByteView(stored), 5, MutableByteView(out)));
+
+        // Noise doesn't shrink, so it's stored as is
+        const PackEntry* noise_entry = pack.Find(StringView("noise.bin"));
+        REQUIRE(noise_entry != nullptr);
+        CHECK(noise_entry->compression == PackCompression::None);
+        CHECK(noise_entry->storedSize == noise.Size());
+        out.Resize(noise.Size());
+        REQUIRE(pack.Read(*noise_entry, MutableByteView(out)));
+        CHECK(std::memcmp(out.Data(), noise.Data(), noise.Size()) == 0);
+
+        const PackEntry* empty = pack.Find(StringView("empty.bin"));
+        REQUIRE(empty != nullptr);
+        CHECK(empty->compression == PackCompression::None);
+
+        opened.Value().Reset();
+        std::remove(kPackPath);
+    }
+
+    TEST_CASE("Block sizes")
+    {
+        PackWriterOptions options;
+        options.blockSize = 1000;
+        CHECK(PackWriter::Create(kPackPath, options).Category() == ErrorCategory::InvalidArgument);
+        options.blockSize = 1024;
+        CHECK_FALSE(PackWriter::Create(kPackPath, options));
+        std::remove(kPackPath);
+    }
+
+    TEST_CASE("Names added twice")
+    {
+        Result<UniquePtr<PackWriter>> writer = PackWriter::Create(kPackPath);
+        REQUIRE(writer);
+        REQUIRE(writer.Value()->Add(StringView("a.txt"), AsBytes("a", 1)));
+        REQUIRE(writer.Value()->Add(StringView("a.txt"), AsBytes("b", 1)));
+        Result<> finished = writer.Value()->Finish();
+        CHECK_FALSE(finished);
+        CHECK(finished.Category() == ErrorCategory::InvalidArgument);
+        writer.Value().Reset();
+
+        // Never got its table
+        CHECK_FALSE(Pack::Open(kPackPath));
+        std::remove(kPackPath);
+    }
+
+    TEST_CASE("Files that aren't packs")
+    {
+        CHECK(Pack::Open("rsbl-pack-test-missing.rpak").Category() == ErrorCategory::NotFound);
+
+        const char text[] = "Definitely not a pack, just some text that is long enough";
+        Result<FileHandle> file = OpenFile(kPackPath, FileOpenMode::Write);
+        REQUIRE(file);
+        REQUIRE(WriteFile(file.Value(), AsBytes(text, sizeof(text))));
+        CHECK(CloseFile(file.Value()));
+
+        Result<UniquePtr<Pack>> pack = Pack::Open(kPackPath);
+        CHECK_FALSE(pack);
+        CHECK(pack.Category() == ErrorCategory::InvalidArgument);
+        std::remove(kPackPath);
+    }
+}
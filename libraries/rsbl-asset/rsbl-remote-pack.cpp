@@ -0,0 +1,896 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-remote-pack.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-file.h>
+#include <rsbl-format.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-profile.h>
+#include <rsbl-socket.h>
+#include <rsbl-sync.h>
+#include <rsbl-thread-pool.h>
+
+#include <atomic>
+#include <charconv>
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kChunkListMagic = 0x4B435052; // "RPCK"
+constexpr uint32 kChunkListVersion = 1;
+
+// Longer ETags are kept and compared by their start
+constexpr uint32 kMaxETagSize = 112;
+
+// The start of the chunk list, a bit per chunk follows
+struct ChunkListHeader
+{
+    uint32 magic = kChunkListMagic;
+    uint32 version = kChunkListVersion;
+    uint64 size = 0;
+    uint32 chunkSize = 0;
+    uint32 eTagSize = 0;
+    char eTag[kMaxETagSize] = {};
+};
+
+static_assert(sizeof(ChunkListHeader) == 136, "ChunkListHeader is stored as is");
+
+// Response headers have to fit in this, bodies go through it on their way to the file
+constexpr uint64 kReceiveBufferSize = 64 * 1024;
+
+enum class ChunkState : uint8
+{
+    Missing,
+    Fetching,
+    Present,
+};
+
+bool EqualsIgnoringCase(StringView a, StringView b)
+{
+    if (a.Size() != b.Size())
+    {
+        return false;
+    }
+    for (uint64 i = 0; i < a.Size(); ++i)
+    {
+        const char x = a[i] >= 'A' && a[i] <= 'Z' ? static_cast<char>(a[i] - 'A' + 'a') : a[i];
+        const char y = b[i] >= 'A' && b[i] <= 'Z' ? static_cast<char>(b[i] - 'A' + 'a') : b[i];
+        if (x != y)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+StringView Trim(StringView text)
+{
+    uint64 start = 0;
+    uint64 end = text.Size();
+    while (start < end && (text[start] == ' ' || text[start] == '\t'))
+    {
+        ++start;
+    }
+    while (end > start && (text[end - 1] == ' ' || text[end - 1] == '\t'))
+    {
+        --end;
+    }
+    return text.Substring(start, end - start);
+}
+
+// Parses all of text, nothing after the number
+bool ParseUint64(StringView text, uint64& value)
+{
+    const std::from_chars_result result =
+        std::from_chars(text.Data(), text.Data() + text.Size(), value);
+    return !text.IsEmpty() && result.ec == std::errc() && result.ptr == text.Data() + text.Size();
+}
+
+// What's kept of a response's status line and headers
+struct HttpResponse
+{
+    uint32 status = 0;
+    uint64 contentLength = 0;
+    bool hasContentLength = false;
+    // Content-Range: bytes first-last/total
+    uint64 rangeFirst = 0;
+    uint64 rangeLast = 0;
+    bool hasRange = false;
+    bool chunked = false;
+    // Connection: close, or HTTP/1.0 without keep-alive
+    bool close = false;
+    char eTag[kMaxETagSize] = {};
+    uint32 eTagSize = 0;
+    // Body bytes that came in with the headers, at bodyOffset in the receive buffer
+    uint64 bodyOffset = 0;
+    uint64 bodyBuffered = 0;
+};
+
+bool ParseContentRange(StringView value, HttpResponse& response)
+{
+    if (!value.StartsWith("bytes "))
+    {
+        return false;
+    }
+    value = value.Substring(6);
+    const uint64 dash = value.Find('-');
+    const uint64 slash = value.Find('/');
+    if (dash == StringView::kNotFound || slash == StringView::kNotFound || slash < dash)
+    {
+        return false;
+    }
+    const StringView last = value.Substring(dash + 1, slash - dash - 1);
+    response.hasRange = ParseUint64(value.Substring(0, dash), response.rangeFirst) &&
+                        ParseUint64(last, response.rangeLast);
+    return response.hasRange;
+}
+
+bool ParseHeaders(StringView headers, HttpResponse& response)
+{
+    // HTTP/1.1 206 Partial Content
+    const uint64 line_end = headers.Find('\r');
+    const StringView status_line = headers.Substring(0, line_end);
+    uint64 status = 0;
+    if (!status_line.StartsWith("HTTP/1.") || status_line.Size() < 12 ||
+        !ParseUint64(status_line.Substring(9, 3), status))
+    {
+        return false;
+    }
+    response.status = static_cast<uint32>(status);
+    response.close = status_line[7] == '0';
+
+    uint64 start = line_end + 2;
+    while (start < headers.Size())
+    {
+        uint64 end = headers.Find('\r', start);
+        if (end == StringView::kNotFound)
+        {
+            end = headers.Size();
+        }
+        const StringView line = headers.Substring(start, end - start);
+        start = end + 2;
+
+        const uint64 colon = line.Find(':');
+        if (colon == StringView::kNotFound)
+        {
+            continue;
+        }
+        const StringView name = Trim(line.Substring(0, colon));
+        const StringView value = Trim(line.Substring(colon + 1));
+        if (EqualsIgnoringCase(name, "Content-Length"))
+        {
+            response.hasContentLength = ParseUint64(value, response.contentLength);
+            if (!response.hasContentLength)
+            {
+                return false;
+            }
+        }
+        else if (EqualsIgnoringCase(name, "Content-Range"))
+        {
+            if (!ParseContentRange(value, response))
+            {
+                return false;
+            }
+        }
+        else if (EqualsIgnoringCase(name, "ETag"))
+        {
+            response.eTagSize = static_cast<uint32>(
+                value.Size() < kMaxETagSize ? value.Size() : kMaxETagSize);
+            std::memcpy(response.eTag, value.Data(), response.eTagSize);
+        }
+        else if (EqualsIgnoringCase(name, "Connection"))
+        {
+            response.close = EqualsIgnoringCase(value, "close");
+        }
+        else if (EqualsIgnoringCase(name, "Transfer-Encoding"))
+        {
+            response.chunked = !EqualsIgnoringCase(value, "identity");
+        }
+    }
+    return true;
+}
+
+// One connection to the server, and the buffer responses come in through
+struct Connection
+{
+    SocketHandle socket = 0;
+    bool open = false;
+    // Requests made on it since it connected. A server may close a connection that's sat idle,
+    // so a failure on one that's been used is retried on a new one.
+    uint64 requests = 0;
+    uint8 buffer[kReceiveBufferSize];
+
+    void Close()
+    {
+        if (open)
+        {
+            (void)CloseSocket(socket);
+            open = false;
+        }
+    }
+};
+
+// Receives until the end of the headers, which have to fit the buffer
+Result<> ReceiveHeaders(Connection& connection, HttpResponse& response)
+{
+    uint64 received = 0;
+    for (;;)
+    {
+        Result<uint64> count = ReceiveSocket(
+            connection.socket,
+            MutableByteView(connection.buffer + received, kReceiveBufferSize - received));
+        if (!count)
+        {
+            return PendingFailure{count.Category()};
+        }
+        if (count.Value() == 0)
+        {
+            return {ErrorCategory::Io, "Cache server closed the connection"};
+        }
+        const uint64 searched_from = received > 3 ? received - 3 : 0;
+        received += count.Value();
+
+        const StringView text(reinterpret_cast<const char*>(connection.buffer), received);
+        for (uint64 i = searched_from; i + 4 <= received; ++i)
+        {
+            if (std::memcmp(text.Data() + i, "\r\n\r\n", 4) == 0)
+            {
+                if (!ParseHeaders(text.Substring(0, i + 2), response))
+                {
+                    return {ErrorCategory::Io, "Cache server sent a malformed response"};
+                }
+                response.bodyOffset = i + 4;
+                response.bodyBuffered = received - response.bodyOffset;
+                return ResultCode::Success;
+            }
+        }
+        if (received == kReceiveBufferSize)
+        {
+            return {ErrorCategory::Io, "Cache server response headers are too big"};
+        }
+    }
+}
+
+// Writes size bytes of body, what came with the headers and then the rest, to the file at offset
+Result<> ReceiveBody(Connection& connection,
+                     const HttpResponse& response,
+                     uint64 size,
+                     FileHandle file,
+                     uint64 offset)
+{
+    uint64 done = response.bodyBuffered < size ? response.bodyBuffered : size;
+    if (done > 0)
+    {
+        Result<uint64> written =
+            WriteFileAt(file, ByteView(connection.buffer + response.bodyOffset, done), offset);
+        if (!written)
+        {
+            return PendingFailure{written.Category()};
+        }
+    }
+
+    while (done < size)
+    {
+        const uint64 wanted =
+            size - done < kReceiveBufferSize ? size - done : kReceiveBufferSize;
+        Result<uint64> count =
+            ReceiveSocket(connection.socket, MutableByteView(connection.buffer, wanted));
+        if (!count)
+        {
+            return PendingFailure{count.Category()};
+        }
+        if (count.Value() == 0)
+        {
+            return {ErrorCategory::Io, "Cache server closed the connection mid response"};
+        }
+        Result<uint64> written =
+            WriteFileAt(file, ByteView(connection.buffer, count.Value()), offset + done);
+        if (!written)
+        {
+            return PendingFailure{written.Category()};
+        }
+        done += count.Value();
+    }
+    return ResultCode::Success;
+}
+
+Result<> StatusFailure(uint32 status)
+{
+    if (status == 404 || status == 410)
+    {
+        return {ErrorCategory::NotFound, "Cache server doesn't have the pack"};
+    }
+    return FailureFormat(ErrorCategory::Io, "Cache server answered %u", status);
+}
+} // namespace
+
+struct RemotePack::State
+{
+    // Neighbouring chunks one request fetches
+    struct Request
+    {
+        uint32 firstChunk = 0;
+        uint32 chunkCount = 0;
+    };
+
+    // The requests one Ensure waits on. Only touched with mutex held.
+    struct Batch
+    {
+        uint64 remaining = 0;
+        ErrorCategory failure = ErrorCategory::None;
+        char failureText[128] = {};
+    };
+
+    RemotePackOptions options;
+    String host;
+    String remotePath;
+    String localPath;
+    // Host header, with the port unless it's 80
+    String hostHeader;
+    char eTag[kMaxETagSize] = {};
+    uint32 eTagSize = 0;
+
+    uint64 size = 0;
+    uint32 chunkCount = 0;
+    FileHandle file = 0;
+    FileHandle chunkFile = 0;
+    bool fileOpen = false;
+    bool chunkFileOpen = false;
+
+    UniquePtr<ThreadPool> pool;
+
+    Mutex mutex;
+    // The rest is guarded by mutex
+    DynamicArray<ChunkState> chunks;
+    // As stored after ChunkListHeader, a bit per chunk that's there
+    DynamicArray<uint8> bitmap;
+    uint32 chunksPresent = 0;
+    DynamicArray<UniquePtr<Connection>> connections;
+    DynamicArray<Connection*> idle;
+
+    // Bumped whenever chunks finish or a connection frees up, for anything waiting on either
+    std::atomic<uint32> generation{0};
+
+    std::atomic<uint64> requests{0};
+    std::atomic<uint64> bytesFetched{0};
+
+    void Wake()
+    {
+        generation.fetch_add(1, std::memory_order_release);
+        AddressWakeAll(generation);
+    }
+
+    // An idle connection, a new one while there are fewer than options.connections, or else
+    // the next one to free up
+    Connection* AcquireConnection()
+    {
+        for (;;)
+        {
+            uint32 seen;
+            {
+                LockGuard<Mutex> lock(mutex);
+                if (!idle.IsEmpty())
+                {
+                    Connection* connection = idle[idle.Size() - 1];
+                    idle.PopBack();
+                    return connection;
+                }
+                if (connections.Size() < options.connections)
+                {
+                    connections.PushBack(UniquePtr<Connection>(new Connection()));
+                    return connections[connections.Size() - 1].Get();
+                }
+                seen = generation.load(std::memory_order_acquire);
+            }
+            AddressWait(generation, seen);
+        }
+    }
+
+    void ReleaseConnection(Connection* connection)
+    {
+        {
+            LockGuard<Mutex> lock(mutex);
+            idle.PushBack(connection);
+        }
+        Wake();
+    }
+
+    Result<> Connect(Connection& connection)
+    {
+        Result<SocketHandle> socket =
+            ConnectSocket(host.CStr(), options.port, options.timeoutMs);
+        if (!socket)
+        {
+            return PendingFailure{socket.Category()};
+        }
+        connection.socket = socket.Value();
+        connection.open = true;
+        connection.requests = 0;
+        return ResultCode::Success;
+    }
+
+    // One request and its response headers, retried once on a new connection when a kept open
+    // one turns out to have been closed by the server
+    Result<> Exchange(Connection& connection, StringView request, HttpResponse& response)
+    {
+        for (uint32 attempt = 0;; ++attempt)
+        {
+            if (!connection.open)
+            {
+                Result<> connected = Connect(connection);
+                if (!connected)
+                {
+                    return connected;
+                }
+            }
+            const bool reused = connection.requests > 0;
+            ++connection.requests;
+            requests.fetch_add(1, std::memory_order_relaxed);
+
+            Result<> exchanged =
+                SendSocket(connection.socket, AsBytes(request.Data(), request.Size()));
+            if (exchanged)
+            {
+                response = HttpResponse();
+                exchanged = ReceiveHeaders(connection, response);
+            }
+            if (exchanged)
+            {
+                return exchanged;
+            }
+            connection.Close();
+            if (!reused || attempt > 0 || exchanged.Category() != ErrorCategory::Io)
+            {
+                return exchanged;
+            }
+        }
+    }
+
+    // The pack's size and ETag
+    Result<> Head(Connection& connection)
+    {
+        char request[1024];
+        const StringView text = FormatTo(
+            request, "HEAD {} HTTP/1.1\r\nHost: {}\r\n\r\n", remotePath, hostHeader);
+        if (text.Size() + 1 >= sizeof(request))
+        {
+            return {ErrorCategory::InvalidArgument, "Remote pack path is too long"};
+        }
+
+        HttpResponse response;
+        Result<> exchanged = Exchange(connection, text, response);
+        if (!exchanged)
+        {
+            return exchanged;
+        }
+        if (response.close)
+        {
+            connection.Close();
+        }
+        if (response.status != 200)
+        {
+            return StatusFailure(response.status);
+        }
+        if (!response.hasContentLength)
+        {
+            return {ErrorCategory::Io, "Cache server didn't say how big the pack is"};
+        }
+        size = response.contentLength;
+        eTagSize = response.eTagSize;
+        std::memcpy(eTag, response.eTag, eTagSize);
+        return ResultCode::Success;
+    }
+
+    // Fetches the request's chunks into the local copy
+    Result<> FetchRange(Connection& connection, uint64 offset, uint64 count)
+    {
+        RSBL_PROFILE_ZONE("RemotePack::FetchRange");
+
+        char request[1024];
+        const StringView text =
+            FormatTo(request,
+                     "GET {} HTTP/1.1\r\nHost: {}\r\nRange: bytes={}-{}\r\n\r\n",
+                     remotePath,
+                     hostHeader,
+                     offset,
+                     offset + count - 1);
+        if (text.Size() + 1 >= sizeof(request))
+        {
+            return {ErrorCategory::InvalidArgument, "Remote pack path is too long"};
+        }
+
+        HttpResponse response;
+        Result<> exchanged = Exchange(connection, text, response);
+        if (!exchanged)
+        {
+            return exchanged;
+        }
+
+        // Anything but the body asked for, and what's left of the response can't be skipped
+        // reliably, so the connection goes
+        if (response.status != 206)
+        {
+            connection.Close();
+            if (response.status == 200)
+            {
+                return {ErrorCategory::Io, "Cache server doesn't serve byte ranges"};
+            }
+            return StatusFailure(response.status);
+        }
+        if (response.chunked || !response.hasContentLength || response.contentLength != count ||
+            !response.hasRange || response.rangeFirst != offset ||
+            response.rangeLast != offset + count - 1)
+        {
+            connection.Close();
+            return {ErrorCategory::Io, "Cache server sent a different range than asked for"};
+        }
+        if (response.eTagSize != 0 && eTagSize != 0 &&
+            (response.eTagSize != eTagSize || std::memcmp(response.eTag, eTag, eTagSize) != 0))
+        {
+            connection.Close();
+            return {ErrorCategory::InvalidArgument, "Pack changed on the cache server"};
+        }
+
+        Result<> received = ReceiveBody(connection, response, count, file, offset);
+        if (!received || response.close || response.bodyBuffered > count)
+        {
+            connection.Close();
+        }
+        if (received)
+        {
+            bytesFetched.fetch_add(count, std::memory_order_relaxed);
+        }
+        return received;
+    }
+
+    // Fetches a request on whichever thread, then marks its chunks and counts it off the batch
+    void Run(const Request& request, Batch& batch)
+    {
+        const uint64 offset = uint64(request.firstChunk) * options.chunkSize;
+        const uint64 end = uint64(request.firstChunk + request.chunkCount) * options.chunkSize;
+        const uint64 count = (end < size ? end : size) - offset;
+
+        Connection* connection = AcquireConnection();
+        Result<> fetched = FetchRange(*connection, offset, count);
+        ReleaseConnection(connection);
+
+        {
+            LockGuard<Mutex> lock(mutex);
+            const uint32 last = request.firstChunk + request.chunkCount;
+            for (uint32 chunk = request.firstChunk; chunk < last; ++chunk)
+            {
+                chunks[chunk] = fetched ? ChunkState::Present : ChunkState::Missing;
+                if (fetched)
+                {
+                    bitmap[chunk / 8] |= static_cast<uint8>(1u << (chunk % 8));
+                }
+            }
+            if (fetched)
+            {
+                chunksPresent += request.chunkCount;
+                // Only after the data, so the list never claims bytes that aren't there. If it
+                // can't be written, this run still has them and the next fetches them again.
+                const uint32 first_byte = request.firstChunk / 8;
+                const uint32 end_byte = (last + 7) / 8;
+                (void)WriteFileAt(chunkFile,
+                                  ByteView(bitmap.Data() + first_byte, end_byte - first_byte),
+                                  sizeof(ChunkListHeader) + first_byte);
+            }
+            else if (batch.failure == ErrorCategory::None)
+            {
+                batch.failure = fetched.Category();
+                std::strncpy(
+                    batch.failureText, fetched.FailureText(), sizeof(batch.failureText) - 1);
+            }
+            --batch.remaining;
+        }
+        Wake();
+    }
+
+    // Loads the chunk list if it's of this pack, or starts the local copy over
+    Result<> OpenLocalCopy(const char* chunk_path)
+    {
+        Result<FileHandle> opened = OpenFile(localPath.CStr(), FileOpenMode::ReadWriteAppend);
+        if (!opened)
+        {
+            return PendingFailure{opened.Category()};
+        }
+        file = opened.Value();
+        fileOpen = true;
+
+        opened = OpenFile(chunk_path, FileOpenMode::ReadWriteAppend);
+        if (!opened)
+        {
+            return PendingFailure{opened.Category()};
+        }
+        chunkFile = opened.Value();
+        chunkFileOpen = true;
+
+        chunkCount = static_cast<uint32>((size + options.chunkSize - 1) / options.chunkSize);
+        chunks.Resize(chunkCount);
+        bitmap.Resize((chunkCount + 7) / 8);
+        for (uint64 i = 0; i < bitmap.Size(); ++i)
+        {
+            bitmap[i] = 0;
+        }
+
+        ChunkListHeader expected;
+        expected.size = size;
+        expected.chunkSize = options.chunkSize;
+        expected.eTagSize = eTagSize;
+        std::memcpy(expected.eTag, eTag, eTagSize);
+
+        ChunkListHeader stored;
+        Result<uint64> read = ReadFileAt(chunkFile, AsWritableBytes(&stored, sizeof(stored)), 0);
+        Result<uint64> local_size = GetFileSize(file);
+        if (read && read.Value() == sizeof(stored) &&
+            std::memcmp(&stored, &expected, sizeof(stored)) == 0 && local_size &&
+            local_size.Value() == size)
+        {
+            read = ReadFileAt(chunkFile, MutableByteView(bitmap), sizeof(stored));
+            if (read && read.Value() == bitmap.Size())
+            {
+                for (uint32 chunk = 0; chunk < chunkCount; ++chunk)
+                {
+                    if ((bitmap[chunk / 8] >> (chunk % 8)) & 1)
+                    {
+                        chunks[chunk] = ChunkState::Present;
+                        ++chunksPresent;
+                    }
+                }
+                return ResultCode::Success;
+            }
+            for (uint64 i = 0; i < bitmap.Size(); ++i)
+            {
+                bitmap[i] = 0;
+            }
+        }
+
+        // Emptied first so nothing of an old pack is left in it
+        Result<> reset = SetFileSize(file, 0);
+        if (reset)
+        {
+            reset = SetFileSize(file, size);
+        }
+        if (reset)
+        {
+            reset = SetFileSize(chunkFile, 0);
+        }
+        if (!reset)
+        {
+            return reset;
+        }
+        Result<uint64> written = WriteFileAt(chunkFile, AsBytes(&expected, sizeof(expected)), 0);
+        if (written)
+        {
+            written = WriteFileAt(chunkFile, ByteView(bitmap), sizeof(expected));
+        }
+        if (!written)
+        {
+            return PendingFailure{written.Category()};
+        }
+        return ResultCode::Success;
+    }
+};
+
+Result<UniquePtr<RemotePack>> RemotePack::Open(StringView remotePath,
+                                               const char* localPath,
+                                               const RemotePackOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (!IsPowerOfTwo(options.chunkSize) || options.chunkSize < 4096 ||
+        options.maxRequestSize < options.chunkSize ||
+        options.maxRequestSize % options.chunkSize != 0 || options.connections == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Remote pack options are out of range"};
+    }
+    if (!remotePath.StartsWith("/"))
+    {
+        return {ErrorCategory::InvalidArgument, "Remote pack paths start with '/'"};
+    }
+
+    UniquePtr<RemotePack> remote(new RemotePack());
+    remote->m_state = new State();
+    State* state = remote->m_state;
+    state->options = options;
+    state->host = StringView(options.host);
+    state->options.host = state->host.CStr();
+    state->remotePath = remotePath;
+    state->localPath = StringView(localPath);
+    if (options.port == 80)
+    {
+        state->hostHeader = state->host;
+    }
+    else
+    {
+        FormatAppend(state->hostHeader, "{}:{}", state->host, options.port);
+    }
+
+    Connection* connection = state->AcquireConnection();
+    Result<> head = state->Head(*connection);
+    state->ReleaseConnection(connection);
+    if (!head)
+    {
+        return PendingFailure{head.Category()};
+    }
+    if (state->size / options.chunkSize >= ~0u)
+    {
+        return {ErrorCategory::InvalidArgument, "Remote pack has too many chunks, use bigger ones"};
+    }
+
+    String chunk_path = state->localPath;
+    chunk_path.Append(".chunks");
+    Result<> local = state->OpenLocalCopy(chunk_path.CStr());
+    if (!local)
+    {
+        return PendingFailure{local.Category()};
+    }
+
+    ThreadPoolOptions pool_options;
+    pool_options.threadCount = options.connections;
+    pool_options.name = "rsbl-remote-pack";
+    Result<UniquePtr<ThreadPool>> pool = ThreadPool::Create(pool_options);
+    if (!pool)
+    {
+        return PendingFailure{pool.Category()};
+    }
+    state->pool = rsblMove(pool.Value());
+    return rsblMove(remote);
+}
+
+RemotePack::~RemotePack()
+{
+    State* state = m_state;
+    if (state == nullptr)
+    {
+        return;
+    }
+    state->pool.Reset();
+    for (uint64 i = 0; i < state->connections.Size(); ++i)
+    {
+        state->connections[i]->Close();
+    }
+    if (state->fileOpen)
+    {
+        (void)CloseFile(state->file);
+    }
+    if (state->chunkFileOpen)
+    {
+        (void)CloseFile(state->chunkFile);
+    }
+    delete state;
+}
+
+Result<> RemotePack::Ensure(uint64 offset, uint64 size)
+{
+    State* state = m_state;
+    if (size == 0)
+    {
+        return ResultCode::Success;
+    }
+    if (offset > state->size || size > state->size - offset)
+    {
+        return {ErrorCategory::InvalidArgument, "Range runs past the end of the remote pack"};
+    }
+
+    RSBL_PROFILE_ZONE("RemotePack::Ensure");
+    const uint32 chunk_size = state->options.chunkSize;
+    const uint32 first = static_cast<uint32>(offset / chunk_size);
+    const uint32 last = static_cast<uint32>((offset + size - 1) / chunk_size);
+    const uint32 max_chunks = state->options.maxRequestSize / chunk_size;
+
+    DynamicArray<State::Request> requests;
+    for (;;)
+    {
+        // Claims the missing chunks, and notes any another thread is already fetching
+        requests.Clear();
+        State::Batch batch;
+        bool fetched_elsewhere = false;
+        uint32 seen;
+        {
+            LockGuard<Mutex> lock(state->mutex);
+            seen = state->generation.load(std::memory_order_acquire);
+            for (uint32 chunk = first; chunk <= last; ++chunk)
+            {
+                const ChunkState chunk_state = state->chunks[chunk];
+                if (chunk_state == ChunkState::Fetching)
+                {
+                    fetched_elsewhere = true;
+                }
+                if (chunk_state != ChunkState::Missing)
+                {
+                    continue;
+                }
+                state->chunks[chunk] = ChunkState::Fetching;
+                State::Request* previous =
+                    requests.IsEmpty() ? nullptr : &requests[requests.Size() - 1];
+                if (previous != nullptr &&
+                    previous->firstChunk + previous->chunkCount == chunk &&
+                    previous->chunkCount < max_chunks)
+                {
+                    ++previous->chunkCount;
+                }
+                else
+                {
+                    requests.PushBack({chunk, 1});
+                }
+            }
+            batch.remaining = requests.Size();
+        }
+
+        if (requests.IsEmpty())
+        {
+            if (!fetched_elsewhere)
+            {
+                return ResultCode::Success;
+            }
+            AddressWait(state->generation, seen);
+            continue;
+        }
+
+        // The first request is fetched on this thread, the rest on the pool's at the same time
+        for (uint64 i = 1; i < requests.Size(); ++i)
+        {
+            const State::Request* request = &requests[i];
+            State::Batch* waiting = &batch;
+            state->pool->Submit([state, request, waiting]() { state->Run(*request, *waiting); });
+        }
+        state->Run(requests[0], batch);
+
+        for (;;)
+        {
+            {
+                LockGuard<Mutex> lock(state->mutex);
+                if (batch.remaining == 0)
+                {
+                    break;
+                }
+                seen = state->generation.load(std::memory_order_acquire);
+            }
+            AddressWait(state->generation, seen);
+        }
+        if (batch.failure != ErrorCategory::None)
+        {
+            return FailureCopy(batch.failure, batch.failureText);
+        }
+        if (!fetched_elsewhere)
+        {
+            return ResultCode::Success;
+        }
+    }
+}
+
+Result<> RemotePack::EnsureAll()
+{
+    return Ensure(0, m_state->size);
+}
+
+const char* RemotePack::LocalPath() const
+{
+    return m_state->localPath.CStr();
+}
+
+uint64 RemotePack::Size() const
+{
+    return m_state->size;
+}
+
+RemotePackStats RemotePack::GetStats() const
+{
+    RemotePackStats stats;
+    stats.requests = m_state->requests.load(std::memory_order_relaxed);
+    stats.bytesFetched = m_state->bytesFetched.load(std::memory_order_relaxed);
+    stats.chunkCount = m_state->chunkCount;
+    LockGuard<Mutex> lock(m_state->mutex);
+    stats.chunksPresent = m_state->chunksPresent;
+    return stats;
+}
+
+} // namespace rsbl
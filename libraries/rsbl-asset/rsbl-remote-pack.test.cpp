@@ -0,0 +1,505 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-pack.h"
+#include "include/rsbl-remote-pack.h"
+#include "include/rsbl-vfs.h"
+
+#include <rsbl-file.h>
+#include <rsbl-format.h>
+#include <rsbl-socket.h>
+#include <rsbl-sync.h>
+#include <rsbl-thread.h>
+
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kSourcePath = "rsbl-remote-pack-test-source.rpak";
+constexpr const char* kLocalPath = "rsbl-remote-pack-test-local.rpak";
+constexpr const char* kChunkPath = "rsbl-remote-pack-test-local.rpak.chunks";
+constexpr uint32 kAssetCount = 48;
+constexpr uint32 kAssetSize = 40 * 1024;
+
+// Different bytes in every asset, compressible enough for LZ4 to keep some of them
+void FillAsset(uint32 asset, DynamicArray<uint8>& bytes)
+{
+    bytes.Resize(kAssetSize);
+    uint32 state = asset * 2654435761u + 1;
+    for (uint32 i = 0; i < kAssetSize; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        bytes[i] = static_cast<uint8>(i % 7 == 0 ? state >> 24 : asset);
+    }
+}
+
+void AssetName(uint32 asset, char (&name)[64])
+{
+    FormatTo(name, "meshes/asset{}.rmesh", asset);
+}
+
+// The pack the server has, read back whole
+DynamicArray<uint8> WriteSourcePack()
+{
+    {
+        Result<UniquePtr<PackWriter>> writer = PackWriter::Create(kSourcePath);
+        REQUIRE(writer);
+        DynamicArray<uint8> bytes;
+        for (uint32 asset = 0; asset < kAssetCount; ++asset)
+        {
+            char name[64];
+            AssetName(asset, name);
+            FillAsset(asset, bytes);
+            const PackCompression compression =
+                asset % 2 == 0 ? PackCompression::Lz4 : PackCompression::None;
+            REQUIRE(writer.Value()->Add(StringView(name), ByteView(bytes), compression));
+        }
+        REQUIRE(writer.Value()->Finish());
+    }
+
+    Result<FileInfo> info = GetFileInfo(kSourcePath);
+    REQUIRE(info);
+    DynamicArray<uint8> content;
+    content.Resize(info.Value().size);
+    REQUIRE(OpenAndReadFile(kSourcePath, MutableByteView(content)));
+    return content;
+}
+
+void RemoveLocalCopy()
+{
+    std::remove(kLocalPath);
+    std::remove(kChunkPath);
+}
+
+void CheckAsset(const Pack& pack, uint32 asset)
+{
+    char name[64];
+    AssetName(asset, name);
+    const PackEntry* entry = pack.Find(StringView(name));
+    REQUIRE(entry != nullptr);
+
+    DynamicArray<uint8> expected;
+    FillAsset(asset, expected);
+    DynamicArray<uint8> read;
+    read.Resize(entry->size);
+    Result<uint64> size = pack.Read(*entry, MutableByteView(read));
+    REQUIRE(size);
+    REQUIRE(size.Value() == kAssetSize);
+    CHECK(std::memcmp(read.Data(), expected.Data(), kAssetSize) == 0);
+}
+
+bool ParseNumber(StringView text, uint64& value)
+{
+    return std::from_chars(text.Data(), text.Data() + text.Size(), value).ec == std::errc();
+}
+
+// A file server that speaks just enough HTTP/1.1 for RemotePack: HEAD, and GET with a byte
+// range, on kept open connections, a thread each
+class RangeServer
+{
+  public:
+    RangeServer(ByteView content, const char* eTag, bool serveRanges = true)
+        : m_content(content)
+        , m_eTag(eTag)
+        , m_serveRanges(serveRanges)
+    {
+        Result<SocketHandle> listener = ListenSocket(0);
+        REQUIRE(listener);
+        m_listener = listener.Value();
+        m_port = GetSocketPort(m_listener).Value();
+
+        Result<UniquePtr<Thread>> thread = Thread::Create([this]() -> Result<> {
+            for (;;)
+            {
+                Result<SocketHandle> connection = AcceptSocket(m_listener);
+                if (!connection || m_stopping.load())
+                {
+                    if (connection)
+                    {
+                        (void)CloseSocket(connection.Value());
+                    }
+                    return ResultCode::Success;
+                }
+                connections.fetch_add(1);
+                LockGuard<Mutex> lock(m_mutex);
+                m_sockets.PushBack(connection.Value());
+                const SocketHandle socket = connection.Value();
+                Result<UniquePtr<Thread>> handler =
+                    Thread::Create([this, socket]() -> Result<> { return Serve(socket); });
+                if (handler)
+                {
+                    m_handlers.PushBack(rsblMove(handler.Value()));
+                }
+            }
+        });
+        REQUIRE(thread);
+        m_acceptThread = rsblMove(thread.Value());
+    }
+
+    ~RangeServer()
+    {
+        m_stopping.store(true);
+        Result<SocketHandle> wake = ConnectSocket("127.0.0.1", m_port);
+        (void)m_acceptThread->Join();
+        if (wake)
+        {
+            (void)CloseSocket(wake.Value());
+        }
+        for (uint64 i = 0; i < m_sockets.Size(); ++i)
+        {
+            ShutdownSocket(m_sockets[i]);
+        }
+        for (uint64 i = 0; i < m_handlers.Size(); ++i)
+        {
+            (void)m_handlers[i]->Join();
+            (void)CloseSocket(m_sockets[i]);
+        }
+        (void)CloseSocket(m_listener);
+    }
+
+    uint16 Port() const
+    {
+        return m_port;
+    }
+
+    std::atomic<uint32> requests{0};
+    std::atomic<uint32> connections{0};
+
+  private:
+    Result<> Serve(SocketHandle socket)
+    {
+        char request[4096];
+        uint64 received = 0;
+        for (;;)
+        {
+            Result<uint64> count = ReceiveSocket(
+                socket, AsWritableBytes(request + received, sizeof(request) - 1 - received));
+            if (!count || count.Value() == 0)
+            {
+                return ResultCode::Success;
+            }
+            received += count.Value();
+            request[received] = '\0';
+            const char* end = std::strstr(request, "\r\n\r\n");
+            if (end == nullptr)
+            {
+                continue;
+            }
+            requests.fetch_add(1);
+            Respond(socket, StringView(request, static_cast<uint64>(end - request)));
+            received = 0;
+        }
+    }
+
+    void Respond(SocketHandle socket, StringView request)
+    {
+        const bool head = request.StartsWith("HEAD ");
+        const uint64 path_start = head ? 5 : 4;
+        const StringView path =
+            request.Substring(path_start, request.Find(' ', path_start) - path_start);
+        char response[512];
+        if (!(path == StringView("/packs/base.rpak")))
+        {
+            const StringView text = FormatTo(
+                response, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+            (void)SendSocket(socket, AsBytes(text.Data(), text.Size()));
+            return;
+        }
+
+        uint64 first = 0;
+        uint64 last = m_content.Size() - 1;
+        const char* range = std::strstr(request.Data(), "Range: bytes=");
+        const bool ranged = m_serveRanges && range != nullptr;
+        if (ranged)
+        {
+            const StringView value(range + 13);
+            const uint64 dash = value.Find('-');
+            ParseNumber(value.Substring(0, dash), first);
+            ParseNumber(value.Substring(dash + 1), last);
+        }
+
+        StringView text;
+        if (ranged)
+        {
+            text = FormatTo(response,
+                            "HTTP/1.1 206 Partial Content\r\nContent-Length: {}\r\n"
+                            "Content-Range: bytes {}-{}/{}\r\nETag: {}\r\n\r\n",
+                            last - first + 1,
+                            first,
+                            last,
+                            m_content.Size(),
+                            m_eTag);
+        }
+        else
+        {
+            text = FormatTo(response,
+                            "HTTP/1.1 200 OK\r\nContent-Length: {}\r\nETag: {}\r\n\r\n",
+                            m_content.Size(),
+                            m_eTag);
+        }
+        (void)SendSocket(socket, AsBytes(text.Data(), text.Size()));
+        if (!head)
+        {
+            (void)SendSocket(socket, m_content.Subview(first, last - first + 1));
+        }
+    }
+
+    ByteView m_content;
+    const char* m_eTag;
+    bool m_serveRanges;
+    SocketHandle m_listener = 0;
+    uint16 m_port = 0;
+    std::atomic<bool> m_stopping{false};
+    UniquePtr<Thread> m_acceptThread;
+    Mutex m_mutex;
+    DynamicArray<SocketHandle> m_sockets;
+    DynamicArray<UniquePtr<Thread>> m_handlers;
+};
+
+RemotePackOptions TestOptions(const RangeServer& server)
+{
+    RemotePackOptions options;
+    options.host = "127.0.0.1";
+    options.port = server.Port();
+    options.chunkSize = 16 * 1024;
+    options.maxRequestSize = 64 * 1024;
+    return options;
+}
+} // namespace
+
+TEST_SUITE("rsbl::RemotePack")
+{
+    TEST_CASE("Only what's read is fetched, and kept for the next run")
+    {
+        const DynamicArray<uint8> content = WriteSourcePack();
+        RemoveLocalCopy();
+        const RemotePackOptions options = [&]() {
+            RangeServer server(ByteView(content), "\"v1\"");
+            RemotePackOptions result = TestOptions(server);
+
+            Result<UniquePtr<RemotePack>> remote =
+                RemotePack::Open("/packs/base.rpak", kLocalPath, result);
+            REQUIRE(remote);
+            CHECK(remote.Value()->Size() == content.Size());
+            // The local copy is as big as the pack from the start, holes and all
+            CHECK(GetFileInfo(kLocalPath).Value().size == content.Size());
+
+            Result<UniquePtr<Pack>> pack = Pack::Open(kLocalPath, remote.Value().Get());
+            REQUIRE(pack);
+            CHECK(pack.Value()->EntryCount() == kAssetCount);
+            const RemotePackStats opened = remote.Value()->GetStats();
+            CHECK(opened.chunksPresent < 4);
+
+            CheckAsset(*pack.Value(), 3);
+            CheckAsset(*pack.Value(), 20);
+            CheckAsset(*pack.Value(), 21);
+            const RemotePackStats stats = remote.Value()->GetStats();
+            CHECK(stats.chunkCount == (content.Size() + result.chunkSize - 1) / result.chunkSize);
+            CHECK(stats.bytesFetched < content.Size() / 4);
+            CHECK(stats.requests == server.requests.load());
+
+            // Read again, nothing more is fetched
+            CheckAsset(*pack.Value(), 20);
+            CHECK(remote.Value()->GetStats().requests == stats.requests);
+            return result;
+        }();
+
+        // A new run, against the same pack on a server somewhere else
+        {
+            RangeServer server(ByteView(content), "\"v1\"");
+            RemotePackOptions moved = options;
+            moved.port = server.Port();
+            Result<UniquePtr<RemotePack>> remote =
+                RemotePack::Open("/packs/base.rpak", kLocalPath, moved);
+            REQUIRE(remote);
+            Result<UniquePtr<Pack>> pack = Pack::Open(kLocalPath, remote.Value().Get());
+            REQUIRE(pack);
+            CheckAsset(*pack.Value(), 3);
+            CheckAsset(*pack.Value(), 21);
+            // Just the HEAD
+            CHECK(remote.Value()->GetStats().requests == 1);
+            CHECK(remote.Value()->GetStats().bytesFetched == 0);
+        }
+
+        // The pack was rebuilt, what's local is of no use
+        {
+            RangeServer server(ByteView(content), "\"v2\"");
+            RemotePackOptions moved = options;
+            moved.port = server.Port();
+            Result<UniquePtr<RemotePack>> remote =
+                RemotePack::Open("/packs/base.rpak", kLocalPath, moved);
+            REQUIRE(remote);
+            CHECK(remote.Value()->GetStats().chunksPresent == 0);
+        }
+
+        RemoveLocalCopy();
+        std::remove(kSourcePath);
+    }
+
+    TEST_CASE("Big reads are split over several connections")
+    {
+        const DynamicArray<uint8> content = WriteSourcePack();
+        RemoveLocalCopy();
+        {
+            RangeServer server(ByteView(content), "\"v1\"");
+            RemotePackOptions options = TestOptions(server);
+            options.connections = 4;
+
+            Result<UniquePtr<RemotePack>> remote =
+                RemotePack::Open("/packs/base.rpak", kLocalPath, options);
+            REQUIRE(remote);
+            REQUIRE(remote.Value()->EnsureAll());
+
+            const RemotePackStats stats = remote.Value()->GetStats();
+            CHECK(stats.chunksPresent == stats.chunkCount);
+            CHECK(stats.bytesFetched == content.Size());
+            // A HEAD, then a request per 64 KB
+            const uint64 pieces = (content.Size() + options.maxRequestSize - 1) /
+                                  options.maxRequestSize;
+            CHECK(stats.requests == 1 + pieces);
+            CHECK(server.connections.load() > 1);
+            CHECK(server.connections.load() <= options.connections);
+
+            DynamicArray<uint8> local;
+            local.Resize(content.Size());
+            REQUIRE(OpenAndReadFile(kLocalPath, MutableByteView(local)));
+            CHECK(std::memcmp(local.Data(), content.Data(), content.Size()) == 0);
+        }
+        RemoveLocalCopy();
+        std::remove(kSourcePath);
+    }
+
+    TEST_CASE("Threads reading the same chunks fetch them once")
+    {
+        const DynamicArray<uint8> content = WriteSourcePack();
+        RemoveLocalCopy();
+        {
+            RangeServer server(ByteView(content), "\"v1\"");
+            const RemotePackOptions options = TestOptions(server);
+            Result<UniquePtr<RemotePack>> remote =
+                RemotePack::Open("/packs/base.rpak", kLocalPath, options);
+            REQUIRE(remote);
+            RemotePack* source = remote.Value().Get();
+
+            // Overlapping ranges over the first half of the pack
+            const uint64 half = content.Size() / 2;
+            std::atomic<uint32> failures{0};
+            DynamicArray<UniquePtr<Thread>> threads;
+            for (uint32 t = 0; t < 6; ++t)
+            {
+                Result<UniquePtr<Thread>> thread = Thread::Create([&, t]() -> Result<> {
+                    for (uint64 offset = t * 5000; offset < half; offset += 30000)
+                    {
+                        const uint64 size = offset + 40000 < half ? 40000 : half - offset;
+                        if (!source->Ensure(offset, size))
+                        {
+                            failures.fetch_add(1);
+                        }
+                    }
+                    return ResultCode::Success;
+                });
+                REQUIRE(thread);
+                threads.PushBack(rsblMove(thread.Value()));
+            }
+            for (uint64 i = 0; i < threads.Size(); ++i)
+            {
+                CHECK(threads[i]->Join());
+            }
+            CHECK(failures.load() == 0);
+
+            const RemotePackStats stats = source->GetStats();
+            const uint64 chunks = (half + options.chunkSize - 1) / options.chunkSize;
+            CHECK(stats.chunksPresent == chunks);
+            CHECK(stats.bytesFetched == chunks * options.chunkSize);
+
+            DynamicArray<uint8> local;
+            local.Resize(half);
+            REQUIRE(OpenAndReadFile(kLocalPath, MutableByteView(local)));
+            CHECK(std::memcmp(local.Data(), content.Data(), half) == 0);
+        }
+        RemoveLocalCopy();
+        std::remove(kSourcePath);
+    }
+
+    TEST_CASE("Mounted in a vfs")
+    {
+        const DynamicArray<uint8> content = WriteSourcePack();
+        RemoveLocalCopy();
+        {
+            RangeServer server(ByteView(content), "\"v1\"");
+            Vfs vfs;
+            REQUIRE(vfs.MountRemotePack("/packs/base.rpak", kLocalPath, TestOptions(server)));
+
+            DynamicArray<uint8> bytes;
+            REQUIRE(vfs.ReadAll("meshes/asset7.rmesh", bytes));
+            DynamicArray<uint8> expected;
+            FillAsset(7, expected);
+            REQUIRE(bytes.Size() == expected.Size());
+            CHECK(std::memcmp(bytes.Data(), expected.Data(), expected.Size()) == 0);
+            CHECK_FALSE(vfs.Exists("meshes/missing.rmesh"));
+        }
+        RemoveLocalCopy();
+        std::remove(kSourcePath);
+    }
+
+    TEST_CASE("Server failures")
+    {
+        const DynamicArray<uint8> content = WriteSourcePack();
+        RemoveLocalCopy();
+        {
+            RangeServer server(ByteView(content), "\"v1\"");
+            const RemotePackOptions options = TestOptions(server);
+
+            Result<UniquePtr<RemotePack>> missing =
+                RemotePack::Open("/packs/other.rpak", kLocalPath, options);
+            CHECK(missing.Category() == ErrorCategory::NotFound);
+            CHECK(RemotePack::Open("packs/base.rpak", kLocalPath, options).Category() ==
+                  ErrorCategory::InvalidArgument);
+
+            RemotePackOptions bad_chunks = options;
+            bad_chunks.chunkSize = 3000;
+            CHECK(RemotePack::Open("/packs/base.rpak", kLocalPath, bad_chunks).Category() ==
+                  ErrorCategory::InvalidArgument);
+
+            Result<UniquePtr<RemotePack>> remote =
+                RemotePack::Open("/packs/base.rpak", kLocalPath, options);
+            REQUIRE(remote);
+            CHECK(remote.Value()->Ensure(content.Size() - 10, 11).Category() ==
+                  ErrorCategory::InvalidArgument);
+        }
+        RemoveLocalCopy();
+        {
+            // Answers every GET with the whole file
+            RangeServer server(ByteView(content), "\"v1\"", false);
+            Result<UniquePtr<RemotePack>> remote =
+                RemotePack::Open("/packs/base.rpak", kLocalPath, TestOptions(server));
+            REQUIRE(remote);
+            Result<> ensured = remote.Value()->Ensure(0, 100);
+            CHECK(ensured.Category() == ErrorCategory::Io);
+            CHECK(remote.Value()->GetStats().chunksPresent == 0);
+
+            // Nothing was marked, so trying again fails again rather than reading zeros
+            CHECK_FALSE(remote.Value()->Ensure(0, 100));
+        }
+        {
+            // Nothing listening
+            RemotePackOptions options;
+            options.host = "127.0.0.1";
+            Result<SocketHandle> listener = ListenSocket(0);
+            REQUIRE(listener);
+            options.port = GetSocketPort(listener.Value()).Value();
+            CHECK(CloseSocket(listener.Value()));
+            CHECK_FALSE(RemotePack::Open("/packs/base.rpak", kLocalPath, options));
+        }
+        RemoveLocalCopy();
+        std::remove(kSourcePath);
+    }
+}
@@ -0,0 +1,590 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-shader-compiler.h"
+
+#include "rsbl-derived-data-cache.h"
+#include "rsbl-shader-dxc.h"
+
+#include <rsbl-file-watcher.h>
+#include <rsbl-file.h>
+#include <rsbl-hash-map.h>
+#include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-sync.h>
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+// Bump when what goes into a shader's key changes, or when the compiler is upgraded and old
+// bytecode should be left behind
+constexpr uint32 kShaderCacheVersion = 1;
+
+struct SourceFile
+{
+    // Relative to the source directory, normalized
+    String path;
+    String text;
+};
+
+// One permutation. Defines are sorted by name, so the same set in any order is the same shader.
+struct ShaderEntry
+{
+    String path;
+    ShaderStage stage = ShaderStage::Vertex;
+    ShaderTarget target = ShaderTarget::Dxil;
+    String entryPoint;
+    DynamicArray<String> defineNames;
+    DynamicArray<String> defineValues;
+
+    // The source and everything it includes, as of the last successful build
+    DynamicArray<String> dependencies;
+
+    Shader shader;
+};
+
+bool NameLess(StringView a, StringView b)
+{
+    const uint64 common = a.Size() < b.Size() ? a.Size() : b.Size();
+    const int32 order = common > 0 ? std::memcmp(a.Data(), b.Data(), common) : 0;
+    return order < 0 || (order == 0 && a.Size() < b.Size());
+}
+
+// There are only ever a handful of defines
+void SortDefines(DynamicArray<ShaderDefine>& defines)
+{
+    for (uint64 i = 1; i < defines.Size(); ++i)
+    {
+        const ShaderDefine define = defines[i];
+        uint64 j = i;
+        for (; j > 0 && NameLess(define.name, defines[j - 1].name); --j)
+        {
+            defines[j] = defines[j - 1];
+        }
+        defines[j] = define;
+    }
+}
+
+// Everything that picks out a permutation, for deduping in memory
+String PermutationName(const String& path,
+                       const ShaderRequest& request,
+                       const DynamicArray<ShaderDefine>& defines)
+{
+    String name(path.View());
+    name.Append('\n');
+    name.Append(static_cast<char>('0' + static_cast<uint8>(request.stage)));
+    name.Append(static_cast<char>('0' + static_cast<uint8>(request.target)));
+    name.Append(request.entryPoint);
+    for (const ShaderDefine& define : defines)
+    {
+        name.Append('\n');
+        name.Append(define.name);
+        name.Append('=');
+        name.Append(define.value);
+    }
+    return name;
+}
+
+// Collapses "." and ".." out of a '/' separated path. Fails for paths that climb out of the
+// source directory, the watcher wouldn't see them change.
+Result<String> NormalizePath(StringView path)
+{
+    DynamicArray<StringView> parts;
+    uint64 start = 0;
+    while (start <= path.Size())
+    {
+        uint64 end = path.Find('/', start);
+        if (end == StringView::kNotFound)
+        {
+            end = path.Size();
+        }
+
+        const StringView part = path.Substring(start, end - start);
+        if (part == "..")
+        {
+            if (parts.IsEmpty())
+            {
+                return {ErrorCategory::InvalidArgument,
+                        "Shader paths can't leave the source directory"};
+            }
+            parts.PopBack();
+        }
+        else if (!part.IsEmpty() && !(part == "."))
+        {
+            parts.PushBack(part);
+        }
+        start = end + 1;
+    }
+
+    String normalized;
+    for (const StringView& part : parts)
+    {
+        if (!normalized.IsEmpty())
+        {
+            normalized.Append('/');
+        }
+        normalized.Append(part);
+    }
+    return normalized;
+}
+
+StringView DirectoryOf(StringView path)
+{
+    const uint64 slash = path.FindLast('/');
+    return slash == StringView::kNotFound ? StringView() : path.Substring(0, slash);
+}
+
+String FullPath(const String& root, StringView path)
+{
+    String full(root.View());
+    full.Append('/');
+    full.Append(path);
+    return full;
+}
+
+Result<String> ReadText(const String& path)
+{
+    Result<FileInfo> info = GetFileInfo(path.CStr());
+    if (!info)
+    {
+        return PendingFailure{info.Category()};
+    }
+
+    String text;
+    text.Resize(info.Value().size);
+    Result<uint64> read = OpenAndReadFile(path.CStr(), AsWritableBytes(text.Data(), text.Size()));
+    if (!read)
+    {
+        return PendingFailure{read.Category()};
+    }
+    text.Resize(read.Value());
+    return text;
+}
+
+// The quoted includes in source, in order. Angle bracket ones are the compiler's own.
+void FindIncludes(StringView source, DynamicArray<String>& includes)
+{
+    uint64 line = 0;
+    while (line < source.Size())
+    {
+        uint64 end = source.Find('\n', line);
+        if (end == StringView::kNotFound)
+        {
+            end = source.Size();
+        }
+
+        StringView text = source.Substring(line, end - line);
+        line = end + 1;
+
+        uint64 i = 0;
+        while (i < text.Size() && (text[i] == ' ' || text[i] == '\t'))
+        {
+            ++i;
+        }
+        if (!text.Substring(i).StartsWith("#include"))
+        {
+            continue;
+        }
+
+        const uint64 open = text.Find('"', i);
+        const uint64 close = open == StringView::kNotFound ? open : text.Find('"', open + 1);
+        if (close != StringView::kNotFound)
+        {
+            includes.PushBack(String(text.Substring(open + 1, close - open - 1)));
+        }
+    }
+}
+
+// Reads path, normalized, and everything it includes, path first. An include is looked for next
+// to the file including it, then from the source directory, like DXC does.
+Result<> GatherSources(const String& root, const String& path, DynamicArray<SourceFile>& files)
+{
+    files.PushBack({path, String()});
+
+    for (uint64 i = 0; i < files.Size(); ++i)
+    {
+        Result<String> text = ReadText(FullPath(root, files[i].path.View()));
+        if (!text)
+        {
+            if (g_logger != nullptr)
+            {
+                RSBL_LOG_ERROR("Couldn't read shader source {}", files[i].path.CStr());
+            }
+            return PendingFailure{text.Category()};
+        }
+        files[i].text = rsblMove(text.Value());
+
+        DynamicArray<String> includes;
+        FindIncludes(files[i].text.View(), includes);
+        const String directory(DirectoryOf(files[i].path.View()));
+
+        for (const String& include : includes)
+        {
+            String beside(directory.View());
+            if (!beside.IsEmpty())
+            {
+                beside.Append('/');
+            }
+            beside.Append(include.View());
+
+            Result<String> resolved = NormalizePath(beside.View());
+            if (!resolved || !GetFileInfo(FullPath(root, resolved.Value().View()).CStr()))
+            {
+                resolved = NormalizePath(include.View());
+            }
+            if (!resolved || !GetFileInfo(FullPath(root, resolved.Value().View()).CStr()))
+            {
+                if (g_logger != nullptr)
+                {
+                    RSBL_LOG_ERROR("Shader include {} from {} wasn't found",
+                                   include.CStr(),
+                                   files[i].path.CStr());
+                }
+                return {ErrorCategory::NotFound, "A shader include wasn't found"};
+            }
+
+            bool seen = false;
+            for (const SourceFile& file : files)
+            {
+                seen = seen || file.path == resolved.Value();
+            }
+            if (!seen)
+            {
+                files.PushBack({rsblMove(resolved.Value()), String()});
+            }
+        }
+    }
+    return ResultCode::Success;
+}
+
+// Whether a change to changed, a file or a whole directory, touches path
+bool Touches(StringView changed, StringView path)
+{
+    if (!path.StartsWith(changed))
+    {
+        return false;
+    }
+    return path.Size() == changed.Size() || path[changed.Size()] == '/';
+}
+} // namespace
+
+struct ShaderCompiler::State
+{
+    String sourceDirectory;
+    DerivedDataCache* cache = nullptr;
+    ShaderCompileFunction compile;
+
+    // Keyed on PermutationName. Entries don't move, Compile hands out pointers to their shaders.
+    HashMap<String, UniquePtr<ShaderEntry>> shaders;
+
+    UniquePtr<FileWatcher> watcher;
+
+    // Filled by the watcher's thread, emptied by ReloadChanged
+    Mutex changedMutex;
+    DynamicArray<String> changed;
+    bool allChanged = false;
+
+    ShaderCompilerStats stats;
+
+    // Compiles entry's bytecode, or fetches it from the cache when nothing that goes into it has
+    // changed. Dependencies are only updated once it's built.
+    Result<> Build(ShaderEntry& entry, DynamicArray<uint8>& bytecode)
+    {
+        DynamicArray<SourceFile> files;
+        if (Result<> gathered = GatherSources(sourceDirectory, entry.path, files); !gathered)
+        {
+            return gathered;
+        }
+
+        DerivedDataKeyBuilder builder("shader", kShaderCacheVersion);
+        builder.AddValue(entry.stage).AddValue(entry.target).Add(entry.entryPoint.View());
+        for (uint64 i = 0; i < entry.defineNames.Size(); ++i)
+        {
+            builder.Add(entry.defineNames[i].View()).Add(entry.defineValues[i].View());
+        }
+        for (const SourceFile& file : files)
+        {
+            builder.Add(file.path.View()).Add(file.text.View());
+        }
+        const DerivedDataKey key = builder.Finish();
+
+        bool cached = false;
+        if (cache != nullptr)
+        {
+            if (Result<String> path = cache->Find(key))
+            {
+                if (Result<MappedFile> mapped = MapFile(path.Value().CStr()))
+                {
+                    const ByteView view = mapped.Value().View();
+                    bytecode.Clear();
+                    bytecode.Reserve(view.Size());
+                    for (uint8 byte : view)
+                    {
+                        bytecode.PushBack(byte);
+                    }
+                    cached = true;
+                    ++stats.cacheHits;
+                }
+            }
+        }
+
+        if (!cached)
+        {
+            DynamicArray<ShaderDefine> defines;
+            for (uint64 i = 0; i < entry.defineNames.Size(); ++i)
+            {
+                defines.PushBack({entry.defineNames[i].View(), entry.defineValues[i].View()});
+            }
+
+            const String fullPath = FullPath(sourceDirectory, files[0].path.View());
+            ShaderCompileInput input;
+            input.source = files[0].text.View();
+            input.path = fullPath.View();
+            input.includeDirectory = sourceDirectory.View();
+            input.entryPoint = entry.entryPoint.View();
+            input.stage = entry.stage;
+            input.target = entry.target;
+            input.defines = ArrayView<const ShaderDefine>(defines.Data(), defines.Size());
+
+            String errors;
+            ++stats.compiles;
+            if (Result<> compiled = compile(input, bytecode, errors); !compiled)
+            {
+                if (errors.IsEmpty())
+                {
+                    return compiled;
+                }
+                return FailureCopy(compiled.Category(), errors.CStr());
+            }
+            if (!errors.IsEmpty() && g_logger != nullptr)
+            {
+                RSBL_LOG_WARNING("{}: {}", fullPath.CStr(), errors.CStr());
+            }
+
+            if (cache != nullptr)
+            {
+                const ByteView view(bytecode.Data(), bytecode.Size());
+                if (Result<> put = cache->Put(key, view); !put && g_logger != nullptr)
+                {
+                    RSBL_LOG_WARNING("Failed to cache {}: {}", fullPath.CStr(), put.FailureText());
+                }
+            }
+        }
+
+        entry.dependencies.Clear();
+        for (SourceFile& file : files)
+        {
+            entry.dependencies.PushBack(rsblMove(file.path));
+        }
+        return ResultCode::Success;
+    }
+};
+
+Result<UniquePtr<ShaderCompiler>> ShaderCompiler::Create(const ShaderCompilerOptions& options,
+                                                         ShaderCompileFunction&& compile)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (options.sourceDirectory == nullptr || options.sourceDirectory[0] == '\0')
+    {
+        return {ErrorCategory::InvalidArgument, "The shader compiler needs a source directory"};
+    }
+
+    UniquePtr<ShaderCompiler> compiler(new ShaderCompiler());
+    compiler->m_state = new State();
+    State& state = *compiler->m_state;
+    state.sourceDirectory = options.sourceDirectory;
+    state.cache = options.cache;
+    state.compile = rsblMove(compile);
+
+    if (!state.compile)
+    {
+        if (Result<> loaded = shader::LoadDxc(state.compile); !loaded)
+        {
+            return PendingFailure{loaded.Category()};
+        }
+    }
+
+    if (options.hotReload)
+    {
+        ShaderCompiler* watched = compiler.Get();
+        auto handler = [watched](DynamicArray<FileChange>&& changes) {
+            for (const FileChange& change : changes)
+            {
+                if (change.kind == FileChangeKind::Rescan)
+                {
+                    watched->MarkAllChanged();
+                }
+                else
+                {
+                    watched->MarkChanged(change.path.View());
+                }
+            }
+        };
+
+        Result<UniquePtr<FileWatcher>> watcher =
+            FileWatcher::Create(options.sourceDirectory, rsblMove(handler));
+        if (!watcher)
+        {
+            return PendingFailure{watcher.Category()};
+        }
+        state.watcher = rsblMove(watcher.Value());
+    }
+    return compiler;
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+    // The watcher's handler points back at this, so it goes before anything it could touch
+    if (m_state != nullptr)
+    {
+        m_state->watcher.Reset();
+    }
+    delete m_state;
+}
+
+Result<const Shader*> ShaderCompiler::Compile(const ShaderRequest& request)
+{
+    if (request.path.IsEmpty() || request.entryPoint.IsEmpty())
+    {
+        return {ErrorCategory::InvalidArgument, "Shaders need a path and an entry point"};
+    }
+
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    Result<String> path = NormalizePath(request.path);
+    if (!path)
+    {
+        return PendingFailure{path.Category()};
+    }
+
+    DynamicArray<ShaderDefine> defines;
+    for (const ShaderDefine& define : request.defines)
+    {
+        defines.PushBack(define);
+    }
+    SortDefines(defines);
+
+    String name = PermutationName(path.Value(), request, defines);
+    if (UniquePtr<ShaderEntry>* found = m_state->shaders.Find(name))
+    {
+        ++m_state->stats.deduped;
+        return &(*found)->shader;
+    }
+
+    auto entry = MakeUnique<ShaderEntry>();
+    entry->path = rsblMove(path.Value());
+    entry->stage = request.stage;
+    entry->target = request.target;
+    entry->entryPoint = request.entryPoint;
+    for (const ShaderDefine& define : defines)
+    {
+        entry->defineNames.PushBack(String(define.name));
+        entry->defineValues.PushBack(String(define.value));
+    }
+
+    if (Result<> built = m_state->Build(*entry, entry->shader.bytecode); !built)
+    {
+        return PendingFailure{built.Category()};
+    }
+
+    const Shader* shader = &entry->shader;
+    m_state->shaders.Insert(rsblMove(name), rsblMove(entry));
+    return shader;
+}
+
+uint32 ShaderCompiler::ReloadChanged()
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    DynamicArray<String> changed;
+    bool allChanged = false;
+    {
+        LockGuard<Mutex> lock(m_state->changedMutex);
+        changed = rsblMove(m_state->changed);
+        m_state->changed.Clear();
+        allChanged = m_state->allChanged;
+        m_state->allChanged = false;
+    }
+    if (changed.IsEmpty() && !allChanged)
+    {
+        return 0;
+    }
+
+    uint32 reloaded = 0;
+    for (auto& pair : m_state->shaders)
+    {
+        ShaderEntry& entry = *pair.value;
+
+        bool stale = allChanged;
+        for (uint64 i = 0; i < changed.Size() && !stale; ++i)
+        {
+            for (const String& dependency : entry.dependencies)
+            {
+                stale = stale || Touches(changed[i].View(), dependency.View());
+            }
+        }
+        if (!stale)
+        {
+            continue;
+        }
+
+        DynamicArray<uint8> bytecode;
+        if (Result<> built = m_state->Build(entry, bytecode); !built)
+        {
+            ++m_state->stats.failedReloads;
+            if (g_logger != nullptr)
+            {
+                RSBL_LOG_ERROR("Reloading {} failed, keeping its old bytecode: {}",
+                               entry.path.CStr(),
+                               built.FailureText());
+            }
+            continue;
+        }
+
+        // Saving a file without changing what it compiles to isn't worth remaking pipelines over
+        const DynamicArray<uint8>& old = entry.shader.bytecode;
+        if (bytecode.Size() == old.Size() &&
+            (bytecode.IsEmpty() || std::memcmp(bytecode.Data(), old.Data(), old.Size()) == 0))
+        {
+            continue;
+        }
+
+        entry.shader.bytecode = rsblMove(bytecode);
+        ++entry.shader.generation;
+        ++m_state->stats.reloads;
+        ++reloaded;
+    }
+
+    if (reloaded > 0 && g_logger != nullptr)
+    {
+        RSBL_LOG_INFO("Reloaded {} shaders", reloaded);
+    }
+    return reloaded;
+}
+
+void ShaderCompiler::MarkChanged(StringView path)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    String changed(path);
+
+    LockGuard<Mutex> lock(m_state->changedMutex);
+    m_state->changed.PushBack(rsblMove(changed));
+}
+
+void ShaderCompiler::MarkAllChanged()
+{
+    LockGuard<Mutex> lock(m_state->changedMutex);
+    m_state->allChanged = true;
+}
+
+ShaderCompilerStats ShaderCompiler::Stats() const
+{
+    return m_state->stats;
+}
+
+} // namespace rsbl
@@ -0,0 +1,262 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-derived-data-cache.h"
+#include "include/rsbl-shader-compiler.h"
+
+#include <rsbl-file.h>
+#include <rsbl-thread.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kSourceDirectory = "rsbl-shader-test-source";
+constexpr const char* kCacheDirectory = "rsbl-shader-test-cache";
+
+void WriteSource(const char* name, const char* text)
+{
+    const std::filesystem::path path = std::filesystem::path(kSourceDirectory) / name;
+    std::filesystem::create_directories(path.parent_path());
+    FILE* file = std::fopen(path.string().c_str(), "wb");
+    REQUIRE(file != nullptr);
+    std::fwrite(text, 1, std::strlen(text), file);
+    std::fclose(file);
+}
+
+std::string ReadSource(const std::string& path)
+{
+    char buffer[1024] = {};
+    Result<uint64> read = OpenAndReadFile(path.c_str(), AsWritableBytes(buffer, sizeof(buffer)));
+    return read ? std::string(buffer, read.Value()) : std::string();
+}
+
+// Pastes includes in, looking next to the including file first like DXC
+std::string Expand(const std::string& source, const std::filesystem::path& directory)
+{
+    std::string output = source;
+    for (uint64 at = source.find("#include \""); at != std::string::npos;
+         at = source.find("#include \"", at + 1))
+    {
+        const uint64 start = at + 10;
+        const std::string name = source.substr(start, source.find('"', start) - start);
+        std::filesystem::path path = directory / name;
+        if (!std::filesystem::exists(path))
+        {
+            path = std::filesystem::path(kSourceDirectory) / name;
+        }
+        output += Expand(ReadSource(path.string()), path.parent_path());
+    }
+    return output;
+}
+
+// Stands in for DXC: the "bytecode" is the entry point, the defines and the source with its
+// includes pasted in, and a source with "error" in it doesn't compile
+Result<> FakeCompile(const ShaderCompileInput& input, DynamicArray<uint8>& bytecode, String& errors)
+{
+    std::string output(input.entryPoint.Data(), input.entryPoint.Size());
+    for (const ShaderDefine& define : input.defines)
+    {
+        output += " " + std::string(define.name.Data(), define.name.Size()) + "=" +
+                  std::string(define.value.Data(), define.value.Size());
+    }
+
+    const std::string path(input.path.Data(), input.path.Size());
+    output += "\n" + Expand(std::string(input.source.Data(), input.source.Size()),
+                            std::filesystem::path(path).parent_path());
+
+    if (output.find("error") != std::string::npos)
+    {
+        errors = "error: not a shader";
+        return "The shader failed to compile";
+    }
+
+    bytecode.Clear();
+    for (char c : output)
+    {
+        bytecode.PushBack(static_cast<uint8>(c));
+    }
+    return ResultCode::Success;
+}
+
+std::string Bytecode(const Shader* shader)
+{
+    return std::string(reinterpret_cast<const char*>(shader->bytecode.Data()),
+                       shader->bytecode.Size());
+}
+
+UniquePtr<ShaderCompiler> MakeCompiler(DerivedDataCache* cache = nullptr, bool hotReload = false)
+{
+    ShaderCompilerOptions options;
+    options.sourceDirectory = kSourceDirectory;
+    options.cache = cache;
+    options.hotReload = hotReload;
+    Result<UniquePtr<ShaderCompiler>> compiler = ShaderCompiler::Create(options, &FakeCompile);
+    REQUIRE(compiler);
+    return rsblMove(compiler.Value());
+}
+
+void Reset()
+{
+    std::filesystem::remove_all(kSourceDirectory);
+    std::filesystem::remove_all(kCacheDirectory);
+    WriteSource("common.hlsli", "float4 Tint() { return 1; }\n");
+    WriteSource("lighting/brdf.hlsli", "#include \"../common.hlsli\"\n");
+    WriteSource("mesh.hlsl", "  #include \"lighting/brdf.hlsli\"\nfloat4 main() : SV_Target;\n");
+    WriteSource("sky.hlsl", "float4 main() : SV_Target;\n");
+}
+} // namespace
+
+TEST_SUITE("rsbl::ShaderCompiler")
+{
+    TEST_CASE("Each permutation compiles once")
+    {
+        Reset();
+        UniquePtr<ShaderCompiler> compiler = MakeCompiler();
+
+        const ShaderDefine ab[] = {{"A"}, {"B", "2"}};
+        const ShaderDefine ba[] = {{"B", "2"}, {"A"}};
+        Result<const Shader*> first = compiler->Compile({"mesh.hlsl", ShaderStage::Pixel,
+                                                         ShaderTarget::Dxil, ab});
+        REQUIRE(first);
+        CHECK(Bytecode(first.Value()).rfind("main A=1 B=2\n", 0) == 0);
+        CHECK(Bytecode(first.Value()).find("Tint") != std::string::npos);
+
+        // The same path spelled differently, and the same defines in another order, are the
+        // same shader
+        Result<const Shader*> again = compiler->Compile({"./mesh.hlsl", ShaderStage::Pixel,
+                                                         ShaderTarget::Dxil, ba});
+        REQUIRE(again);
+        CHECK(again.Value() == first.Value());
+
+        Result<const Shader*> reordered = compiler->Compile({"mesh.hlsl", ShaderStage::Pixel,
+                                                             ShaderTarget::Dxil, ba});
+        REQUIRE(reordered);
+        CHECK(reordered.Value() == first.Value());
+        CHECK(compiler->Stats().compiles == 1);
+        CHECK(compiler->Stats().deduped == 2);
+
+        // Anything else that goes in is another permutation
+        CHECK(compiler->Compile({"mesh.hlsl", ShaderStage::Pixel, ShaderTarget::Spirv, ab}));
+        CHECK(compiler->Compile({"mesh.hlsl", ShaderStage::Vertex, ShaderTarget::Dxil, ab}));
+        CHECK(compiler->Compile({"mesh.hlsl", ShaderStage::Pixel, ShaderTarget::Dxil, {}}));
+        CHECK(compiler->Stats().compiles == 4);
+        Reset();
+    }
+
+    TEST_CASE("Missing sources and includes fail")
+    {
+        Reset();
+        UniquePtr<ShaderCompiler> compiler = MakeCompiler();
+        CHECK(compiler->Compile({"missing.hlsl"}).Category() == ErrorCategory::NotFound);
+        CHECK(compiler->Compile({"../mesh.hlsl"}).Category() == ErrorCategory::InvalidArgument);
+
+        WriteSource("broken.hlsl", "#include \"nowhere.hlsli\"\n");
+        CHECK(compiler->Compile({"broken.hlsl"}).Category() == ErrorCategory::NotFound);
+
+        WriteSource("error.hlsl", "error\n");
+        Result<const Shader*> failed = compiler->Compile({"error.hlsl"});
+        CHECK_FALSE(failed);
+        CHECK(std::strcmp(failed.FailureText(), "error: not a shader") == 0);
+        CHECK(compiler->Stats().compiles == 1);
+        Reset();
+    }
+
+    TEST_CASE("The next run takes bytecode from the derived data cache")
+    {
+        Reset();
+        DerivedDataCacheOptions cacheOptions;
+        cacheOptions.localDirectory = kCacheDirectory;
+        Result<UniquePtr<DerivedDataCache>> cache = DerivedDataCache::Create(cacheOptions);
+        REQUIRE(cache);
+
+        const ShaderDefine defines[] = {{"SKINNED"}};
+        std::string compiled;
+        {
+            UniquePtr<ShaderCompiler> compiler = MakeCompiler(cache.Value().Get());
+            Result<const Shader*> shader = compiler->Compile({"mesh.hlsl", ShaderStage::Pixel,
+                                                              ShaderTarget::Dxil, defines});
+            REQUIRE(shader);
+            compiled = Bytecode(shader.Value());
+            CHECK(compiler->Stats().compiles == 1);
+        }
+
+        UniquePtr<ShaderCompiler> next_run = MakeCompiler(cache.Value().Get());
+        Result<const Shader*> shader = next_run->Compile({"mesh.hlsl", ShaderStage::Pixel,
+                                                          ShaderTarget::Dxil, defines});
+        REQUIRE(shader);
+        CHECK(Bytecode(shader.Value()) == compiled);
+        CHECK(next_run->Stats().compiles == 0);
+        CHECK(next_run->Stats().cacheHits == 1);
+
+        // Editing an include changes the key, so it compiles again
+        WriteSource("common.hlsli", "float4 Tint() { return 2; }\n");
+        UniquePtr<ShaderCompiler> edited = MakeCompiler(cache.Value().Get());
+        CHECK(edited->Compile({"mesh.hlsl", ShaderStage::Pixel, ShaderTarget::Dxil, defines}));
+        CHECK(edited->Stats().compiles == 1);
+        Reset();
+    }
+
+    TEST_CASE("Reloads follow includes and keep the old bytecode on errors")
+    {
+        Reset();
+        UniquePtr<ShaderCompiler> compiler = MakeCompiler();
+        Result<const Shader*> mesh = compiler->Compile({"mesh.hlsl"});
+        Result<const Shader*> sky = compiler->Compile({"sky.hlsl"});
+        REQUIRE(mesh);
+        REQUIRE(sky);
+        CHECK(compiler->ReloadChanged() == 0);
+
+        WriteSource("common.hlsli", "float4 Tint() { return 3; }\n");
+        compiler->MarkChanged("common.hlsli");
+        CHECK(compiler->ReloadChanged() == 1);
+        CHECK(mesh.Value()->generation == 1);
+        CHECK(sky.Value()->generation == 0);
+        CHECK(Bytecode(mesh.Value()).find("return 3") != std::string::npos);
+
+        // Saved without changing anything, or a directory that holds an include
+        compiler->MarkChanged("common.hlsli");
+        CHECK(compiler->ReloadChanged() == 0);
+        WriteSource("lighting/brdf.hlsli", "#include \"common.hlsli\"\n// brdf\n");
+        compiler->MarkChanged("lighting");
+        CHECK(compiler->ReloadChanged() == 1);
+        CHECK(mesh.Value()->generation == 2);
+
+        const std::string good = Bytecode(mesh.Value());
+        WriteSource("common.hlsli", "error\n");
+        compiler->MarkAllChanged();
+        CHECK(compiler->ReloadChanged() == 0);
+        CHECK(Bytecode(mesh.Value()) == good);
+        CHECK(compiler->Stats().failedReloads == 1);
+        CHECK(compiler->Stats().reloads == 2);
+        Reset();
+    }
+
+    TEST_CASE("The file watcher marks edited sources")
+    {
+        Reset();
+        UniquePtr<ShaderCompiler> compiler = MakeCompiler(nullptr, true);
+        Result<const Shader*> mesh = compiler->Compile({"mesh.hlsl"});
+        REQUIRE(mesh);
+
+        WriteSource("common.hlsli", "float4 Tint() { return 4; }\n");
+        uint32 reloaded = 0;
+        for (uint32 i = 0; i < 500 && reloaded == 0; ++i)
+        {
+            Thread::ThreadSleep(10);
+            reloaded = compiler->ReloadChanged();
+        }
+        CHECK(reloaded == 1);
+        CHECK(mesh.Value()->generation == 1);
+        compiler.Reset();
+        Reset();
+    }
+}
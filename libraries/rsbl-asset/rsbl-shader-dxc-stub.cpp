@@ -0,0 +1,19 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-shader-dxc.h"
+
+namespace rsbl
+{
+namespace shader
+{
+
+    Result<> LoadDxc(ShaderCompileFunction&)
+    {
+        return {ErrorCategory::NotFound,
+                "DXC is not available. Install the Vulkan SDK, or the DirectX Shader Compiler, "
+                "and reconfigure CMake"};
+    }
+
+} // namespace shader
+} // namespace rsbl
@@ -0,0 +1,217 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-shader-dxc.h"
+
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include <dxcapi.h>
+
+namespace rsbl
+{
+namespace shader
+{
+
+    namespace
+    {
+        // Shader model 6.6 for ResourceDescriptorHeap, which the bindless heaps rely on
+        constexpr const wchar_t* kProfiles[] = {
+            L"vs_6_6", L"ps_6_6", L"cs_6_6", L"as_6_6", L"ms_6_6"};
+
+        // The library stays loaded for the process, compile functions can outlive any one
+        // ShaderCompiler
+        DxcCreateInstanceProc LoadCreateInstance()
+        {
+#if defined(_WIN32)
+            HMODULE module = LoadLibraryW(L"dxcompiler.dll");
+            if (module == nullptr)
+            {
+                return nullptr;
+            }
+            return reinterpret_cast<DxcCreateInstanceProc>(
+                GetProcAddress(module, "DxcCreateInstance"));
+#else
+            void* module = dlopen("libdxcompiler.so", RTLD_NOW | RTLD_LOCAL);
+            if (module == nullptr)
+            {
+                return nullptr;
+            }
+            return reinterpret_cast<DxcCreateInstanceProc>(dlsym(module, "DxcCreateInstance"));
+#endif
+        }
+
+        // DXC takes its arguments wide. Everything passed is ASCII, so widening is a copy.
+        struct WideArguments
+        {
+            DynamicArray<DynamicArray<wchar_t>> storage;
+            DynamicArray<LPCWSTR> pointers;
+
+            void Add(StringView text)
+            {
+                DynamicArray<wchar_t> wide;
+                wide.Reserve(text.Size() + 1);
+                for (char c : text)
+                {
+                    wide.PushBack(static_cast<wchar_t>(static_cast<uint8>(c)));
+                }
+                wide.PushBack(L'\0');
+                storage.PushBack(rsblMove(wide));
+            }
+
+            void Add(const wchar_t* text)
+            {
+                DynamicArray<wchar_t> wide;
+                for (; *text != L'\0'; ++text)
+                {
+                    wide.PushBack(*text);
+                }
+                wide.PushBack(L'\0');
+                storage.PushBack(rsblMove(wide));
+            }
+
+            // Pointers are only taken once everything's added, storage doesn't move after
+            ArrayView<LPCWSTR> Finish()
+            {
+                for (const DynamicArray<wchar_t>& argument : storage)
+                {
+                    pointers.PushBack(argument.Data());
+                }
+                return ArrayView<LPCWSTR>(pointers);
+            }
+        };
+
+        struct DxcCompiler
+        {
+            RefPtr<IDxcUtils> utils;
+            RefPtr<IDxcCompiler3> compiler;
+            RefPtr<IDxcIncludeHandler> includeHandler;
+
+            Result<> Compile(const ShaderCompileInput& input,
+                             DynamicArray<uint8>& bytecode,
+                             String& errors)
+            {
+                MemoryTagScope memory_scope(MemoryTag::Asset);
+
+                WideArguments arguments;
+                arguments.Add(input.path);
+                arguments.Add(L"-E");
+                arguments.Add(input.entryPoint);
+                arguments.Add(L"-T");
+                arguments.Add(kProfiles[static_cast<uint32>(input.stage)]);
+                arguments.Add(L"-I");
+                arguments.Add(input.includeDirectory);
+                arguments.Add(L"-HV");
+                arguments.Add(L"2021");
+                if (input.target == ShaderTarget::Spirv)
+                {
+                    arguments.Add(L"-spirv");
+                    arguments.Add(L"-fspv-target-env=vulkan1.3");
+                }
+                for (const ShaderDefine& define : input.defines)
+                {
+                    String text("-D");
+                    text.Append(define.name);
+                    text.Append('=');
+                    text.Append(define.value);
+                    arguments.Add(text.View());
+                }
+                const ArrayView<LPCWSTR> argumentView = arguments.Finish();
+
+                const DxcBuffer source{input.source.Data(), input.source.Size(), DXC_CP_UTF8};
+                RefPtr<IDxcResult> result;
+                HRESULT hr = compiler->Compile(&source,
+                                               argumentView.Data(),
+                                               static_cast<UINT32>(argumentView.Size()),
+                                               includeHandler.Get(),
+                                               __uuidof(IDxcResult),
+                                               reinterpret_cast<void**>(
+                                                   result.ReleaseAndGetAddressOf()));
+                if (FAILED(hr))
+                {
+                    return {ErrorCategory::Platform, "DXC failed to run"};
+                }
+
+                RefPtr<IDxcBlobUtf8> messages;
+                if (SUCCEEDED(result->GetOutput(
+                        DXC_OUT_ERRORS,
+                        __uuidof(IDxcBlobUtf8),
+                        reinterpret_cast<void**>(messages.ReleaseAndGetAddressOf()),
+                        nullptr)) &&
+                    messages.Get() != nullptr && messages->GetStringLength() > 0)
+                {
+                    errors = StringView(messages->GetStringPointer(), messages->GetStringLength());
+                }
+
+                HRESULT status = S_OK;
+                if (FAILED(result->GetStatus(&status)) || FAILED(status))
+                {
+                    return "The shader failed to compile";
+                }
+
+                RefPtr<IDxcBlob> object;
+                if (FAILED(result->GetOutput(
+                        DXC_OUT_OBJECT,
+                        __uuidof(IDxcBlob),
+                        reinterpret_cast<void**>(object.ReleaseAndGetAddressOf()),
+                        nullptr)) ||
+                    object.Get() == nullptr)
+                {
+                    return "DXC produced no bytecode";
+                }
+
+                const uint8* data = static_cast<const uint8*>(object->GetBufferPointer());
+                bytecode.Clear();
+                bytecode.Reserve(object->GetBufferSize());
+                for (uint64 i = 0; i < object->GetBufferSize(); ++i)
+                {
+                    bytecode.PushBack(data[i]);
+                }
+                return ResultCode::Success;
+            }
+        };
+    } // namespace
+
+    Result<> LoadDxc(ShaderCompileFunction& compile)
+    {
+        static const DxcCreateInstanceProc createInstance = LoadCreateInstance();
+        if (createInstance == nullptr)
+        {
+            return {ErrorCategory::NotFound, "Couldn't load the DXC library"};
+        }
+
+        MemoryTagScope memory_scope(MemoryTag::Asset);
+
+        // DXC objects aren't thread safe, which is fine, neither is a ShaderCompiler
+        UniquePtr<DxcCompiler> dxc = MakeUnique<DxcCompiler>();
+        if (FAILED(createInstance(CLSID_DxcUtils,
+                                  __uuidof(IDxcUtils),
+                                  reinterpret_cast<void**>(dxc->utils.ReleaseAndGetAddressOf()))) ||
+            FAILED(createInstance(
+                CLSID_DxcCompiler,
+                __uuidof(IDxcCompiler3),
+                reinterpret_cast<void**>(dxc->compiler.ReleaseAndGetAddressOf()))) ||
+            FAILED(dxc->utils->CreateDefaultIncludeHandler(
+                dxc->includeHandler.ReleaseAndGetAddressOf())))
+        {
+            return {ErrorCategory::Platform, "Failed to create the DXC compiler"};
+        }
+
+        compile = [dxc = rsblMove(dxc)](const ShaderCompileInput& input,
+                                        DynamicArray<uint8>& bytecode,
+                                        String& errors) -> Result<> {
+            return dxc->Compile(input, bytecode, errors);
+        };
+        return ResultCode::Success;
+    }
+
+} // namespace shader
+} // namespace rsbl
@@ -0,0 +1,20 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-shader-compiler.h>
+
+// Internal header between rsbl-shader-compiler.cpp and DXC, or its stub when the build didn't
+// find dxcapi.h
+
+namespace rsbl
+{
+namespace shader
+{
+
+    // Loads DXC and points compile at it. Fails when the library can't be found.
+    Result<> LoadDxc(ShaderCompileFunction& compile);
+
+} // namespace shader
+} // namespace rsbl
@@ -0,0 +1,493 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-texture-streamer.h"
+
+#include <rsbl-async-io.h>
+#include <rsbl-bits.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-file.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-sort.h>
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kStreamedTextureMagic = 0x58455452; // "RTEX"
+
+// Every mip starts on this
+constexpr uint64 kMipAlignment = 16;
+
+struct MipRange
+{
+    uint64 offset;
+    uint64 size;
+};
+
+// First thing in the file. Mips are indexed finest first, but stored coarsest first.
+struct StreamedTextureHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint32 width;
+    uint32 height;
+    uint32 format;
+    uint32 mipCount;
+    MipRange mips[kMaxTextureMips];
+};
+
+constexpr uint32 kNoMip = ~0u;
+
+uint32 MipSize(uint32 size, uint32 mip)
+{
+    return size >> mip > 0 ? size >> mip : 1;
+}
+} // namespace
+
+Result<> WriteStreamedTexture(const char* path, ArrayView<const Image> mips)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (mips.IsEmpty() || mips.Size() > kMaxTextureMips)
+    {
+        return FailureFormat(
+            ErrorCategory::InvalidArgument, "A texture has 1 to %u mips", kMaxTextureMips);
+    }
+    const Image& top = mips[0];
+    for (uint32 mip = 0; mip < mips.Size(); ++mip)
+    {
+        const Image& image = mips[mip];
+        if (image.format != top.format || image.width != MipSize(top.width, mip) ||
+            image.height != MipSize(top.height, mip) ||
+            image.pixels.Size() != ImageByteSize(image.width, image.height, image.format))
+        {
+            return FailureFormat(ErrorCategory::InvalidArgument,
+                                 "Mip %u doesn't follow on from the one before",
+                                 mip);
+        }
+    }
+
+    StreamedTextureHeader header = {};
+    header.magic = kStreamedTextureMagic;
+    header.version = kStreamedTextureVersion;
+    header.width = top.width;
+    header.height = top.height;
+    header.format = static_cast<uint32>(top.format);
+    header.mipCount = static_cast<uint32>(mips.Size());
+
+    // Header, then the mips from the coarsest up, each after the padding that aligns it
+    static const uint8 kZeros[kMipAlignment] = {};
+    ByteView parts[1 + 2 * kMaxTextureMips];
+    uint32 part_count = 0;
+    parts[part_count++] = AsBytes(&header, sizeof(header));
+
+    uint64 position = sizeof(header);
+    for (uint32 i = 0; i < header.mipCount; ++i)
+    {
+        const uint32 mip = header.mipCount - 1 - i;
+        const uint64 padding = AlignUp(position, kMipAlignment) - position;
+        if (padding > 0)
+        {
+            parts[part_count++] = AsBytes(kZeros, padding);
+            position += padding;
+        }
+        header.mips[mip].offset = position;
+        header.mips[mip].size = mips[mip].pixels.Size();
+        parts[part_count++] = AsBytes(ArrayView<const uint8>(mips[mip].pixels));
+        position += mips[mip].pixels.Size();
+    }
+
+    Result<FileHandle> file = OpenFile(path, FileOpenMode::Write);
+    if (!file)
+    {
+        return PendingFailure{file.Category()};
+    }
+
+    Result<uint64> written =
+        WriteFileGather(file.Value(), ArrayView<const ByteView>(parts, part_count));
+    const Result<> closed = CloseFile(file.Value());
+    if (!written)
+    {
+        return PendingFailure{written.Category()};
+    }
+    if (written.Value() != position)
+    {
+        return {ErrorCategory::Io, "Short write of streamed texture"};
+    }
+    return closed;
+}
+
+struct TextureStreamer::State
+{
+    struct Texture
+    {
+        StreamedTextureInfo info;
+        MipRange mips[kMaxTextureMips];
+        FileHandle file = 0;
+
+        // The tail as it is in the file, coarsest first, and the mips above it, each empty
+        // until it's read
+        DynamicArray<uint8> tail{GetTaggedAllocator(MemoryTag::Asset)};
+        DynamicArray<uint8> streamed[kMaxTextureMips];
+
+        uint32 residentMip = 0;
+        // Asked for since the last Update, and as of the last Update
+        uint32 requestedMip = kNoMip;
+        uint32 wantedMip = kNoMip;
+        uint64 lastWantedFrame = 0;
+        // The one mip being read, residentMip - 1, or kNoMip
+        uint32 readingMip = kNoMip;
+        // A read failed, it stays at what it has
+        bool broken = false;
+    };
+
+    AsyncIo* io = nullptr;
+    TextureStreamerOptions options;
+
+    DynamicArray<Texture> textures{GetTaggedAllocator(MemoryTag::Asset)};
+    DynamicArray<StreamedMip> arrived{GetTaggedAllocator(MemoryTag::Asset)};
+    uint32 readsInFlight = 0;
+    uint64 frame = 0;
+    TextureStreamerStats stats;
+
+    // Whether the texture wants its finest resident mip this frame
+    bool Wants(const Texture& texture) const
+    {
+        return texture.lastWantedFrame == frame && texture.wantedMip <= texture.residentMip;
+    }
+
+    // Drops the finest resident mip of whichever texture asked for it longest ago, sparing the
+    // ones that want it this frame. False when there's nothing to drop.
+    bool EvictOne()
+    {
+        Texture* victim = nullptr;
+        for (Texture& texture : textures)
+        {
+            if (texture.residentMip >= texture.info.tailMip || texture.readingMip != kNoMip ||
+                Wants(texture))
+            {
+                continue;
+            }
+            if (victim == nullptr || texture.lastWantedFrame < victim->lastWantedFrame)
+            {
+                victim = &texture;
+            }
+        }
+        if (victim == nullptr)
+        {
+            return false;
+        }
+
+        DynamicArray<uint8>& pixels = victim->streamed[victim->residentMip];
+        stats.residentBytes -= pixels.Size();
+        pixels = DynamicArray<uint8>(GetTaggedAllocator(MemoryTag::Asset));
+        ++victim->residentMip;
+        ++stats.mipsEvicted;
+        return true;
+    }
+
+    void Reap()
+    {
+        AsyncIoCompletion completions[32];
+        uint32 count = 0;
+        while ((count = io->PollCompletions(completions, 32)) > 0)
+        {
+            for (uint32 i = 0; i < count; ++i)
+            {
+                const uint32 index = static_cast<uint32>(completions[i].userData);
+                Texture& texture = textures[index];
+                const uint32 mip = texture.readingMip;
+                DynamicArray<uint8>& pixels = texture.streamed[mip];
+                texture.readingMip = kNoMip;
+                --readsInFlight;
+                stats.pendingBytes -= pixels.Size();
+
+                if (completions[i].succeeded && completions[i].bytesRead == pixels.Size())
+                {
+                    texture.residentMip = mip;
+                    stats.residentBytes += pixels.Size();
+                    ++stats.mipsRead;
+                    arrived.PushBack(StreamedMip{index, mip});
+                }
+                else
+                {
+                    pixels = DynamicArray<uint8>(GetTaggedAllocator(MemoryTag::Asset));
+                    texture.broken = true;
+                    ++stats.failedReads;
+                }
+            }
+        }
+    }
+};
+
+Result<UniquePtr<TextureStreamer>> TextureStreamer::Create(AsyncIo& io,
+                                                           const TextureStreamerOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    if (options.maxReadsInFlight == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Streaming needs at least one read in flight"};
+    }
+
+    UniquePtr<TextureStreamer> streamer(new TextureStreamer());
+    streamer->m_state = new State();
+    streamer->m_state->io = &io;
+    streamer->m_state->options = options;
+    return rsblMove(streamer);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    State* state = m_state;
+    AsyncIoCompletion completions[32];
+    while (state->io->InFlight() > 0)
+    {
+        state->io->WaitCompletions(completions, 32);
+    }
+    for (const State::Texture& texture : state->textures)
+    {
+        (void)CloseFile(texture.file);
+    }
+    delete state;
+}
+
+Result<uint32> TextureStreamer::Open(const char* path)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+
+    Result<FileHandle> file = OpenFile(path, FileOpenMode::Read);
+    if (!file)
+    {
+        return PendingFailure{file.Category()};
+    }
+
+    State::Texture texture;
+    StreamedTextureHeader header = {};
+    Result<uint64> read = ReadFileAt(
+        file.Value(), MutableByteView(reinterpret_cast<uint8*>(&header), sizeof(header)), 0);
+    const bool valid_header = read && read.Value() == sizeof(header) &&
+                              header.magic == kStreamedTextureMagic &&
+                              header.version == kStreamedTextureVersion &&
+                              header.format <= static_cast<uint32>(ImageFormat::Bc7) &&
+                              header.mipCount > 0 && header.mipCount <= kMaxTextureMips;
+    const Result<uint64> file_size = GetFileSize(file.Value());
+    bool valid_mips = valid_header && file_size;
+    for (uint32 mip = 0; valid_mips && mip < header.mipCount; ++mip)
+    {
+        const MipRange& range = header.mips[mip];
+        const ImageFormat format = static_cast<ImageFormat>(header.format);
+        valid_mips = range.offset <= file_size.Value() &&
+                     range.size <= file_size.Value() - range.offset &&
+                     range.size == ImageByteSize(MipSize(header.width, mip),
+                                                 MipSize(header.height, mip),
+                                                 format) &&
+                     (mip == 0 || range.offset < header.mips[mip - 1].offset);
+    }
+    if (!valid_mips)
+    {
+        (void)CloseFile(file.Value());
+        return {ErrorCategory::InvalidArgument, "Not a streamed texture, or a corrupt one"};
+    }
+
+    // The coarsest mips that fit in tailBytes, at least the last, are one read from the front
+    uint32 tail_mip = header.mipCount - 1;
+    uint64 tail_end = header.mips[tail_mip].offset + header.mips[tail_mip].size;
+    while (tail_mip > 0)
+    {
+        const MipRange& next = header.mips[tail_mip - 1];
+        if (next.offset + next.size - header.mips[header.mipCount - 1].offset >
+            state->options.tailBytes)
+        {
+            break;
+        }
+        --tail_mip;
+        tail_end = next.offset + next.size;
+    }
+    const uint64 tail_start = header.mips[header.mipCount - 1].offset;
+    texture.tail.ResizeUninitialized(tail_end - tail_start);
+    read = ReadFileAt(file.Value(), texture.tail, tail_start);
+    (void)CloseFile(file.Value());
+    if (!read)
+    {
+        return PendingFailure{read.Category()};
+    }
+    if (read.Value() != texture.tail.Size())
+    {
+        return {ErrorCategory::Io, "Short read of a streamed texture's tail"};
+    }
+
+    Result<FileHandle> stream = state->io->OpenForRead(path);
+    if (!stream)
+    {
+        return PendingFailure{stream.Category()};
+    }
+
+    texture.info.width = header.width;
+    texture.info.height = header.height;
+    texture.info.format = static_cast<ImageFormat>(header.format);
+    texture.info.mipCount = header.mipCount;
+    texture.info.tailMip = tail_mip;
+    std::memcpy(texture.mips, header.mips, sizeof(texture.mips));
+    texture.file = stream.Value();
+    texture.residentMip = tail_mip;
+    for (DynamicArray<uint8>& pixels : texture.streamed)
+    {
+        pixels = DynamicArray<uint8>(GetTaggedAllocator(MemoryTag::Asset));
+    }
+    state->stats.tailBytes += texture.tail.Size();
+    state->textures.PushBack(rsblMove(texture));
+    return static_cast<uint32>(state->textures.Size() - 1);
+}
+
+uint32 TextureStreamer::TextureCount() const
+{
+    return static_cast<uint32>(m_state->textures.Size());
+}
+
+const StreamedTextureInfo& TextureStreamer::Info(uint32 texture) const
+{
+    return m_state->textures[texture].info;
+}
+
+void TextureStreamer::Request(uint32 texture, uint32 mip)
+{
+    State::Texture& requested = m_state->textures[texture];
+    requested.requestedMip = mip < requested.requestedMip ? mip : requested.requestedMip;
+}
+
+void TextureStreamer::RequestFromFeedback(ArrayView<const uint8> min_mips)
+{
+    const uint64 count =
+        min_mips.Size() < m_state->textures.Size() ? min_mips.Size() : m_state->textures.Size();
+    for (uint64 i = 0; i < count; ++i)
+    {
+        if (min_mips[i] != kMipNotSampled)
+        {
+            Request(static_cast<uint32>(i), min_mips[i]);
+        }
+    }
+}
+
+void TextureStreamer::Update()
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    State* state = m_state;
+
+    state->arrived.Clear();
+    state->Reap();
+
+    ++state->frame;
+    for (State::Texture& texture : state->textures)
+    {
+        if (texture.requestedMip != kNoMip)
+        {
+            texture.wantedMip = texture.requestedMip;
+            texture.lastWantedFrame = state->frame;
+            texture.requestedMip = kNoMip;
+        }
+    }
+
+    // Blurriest relative to what was asked for first, then in index order
+    DynamicArray<uint64> order(GetTaggedAllocator(MemoryTag::Asset));
+    for (uint64 i = 0; i < state->textures.Size(); ++i)
+    {
+        const State::Texture& texture = state->textures[i];
+        if (texture.lastWantedFrame == state->frame && texture.wantedMip < texture.residentMip &&
+            texture.readingMip == kNoMip && !texture.broken)
+        {
+            const uint64 missing = texture.residentMip - texture.wantedMip;
+            order.PushBack(((kMaxTextureMips - missing) << 32) | i);
+        }
+    }
+    RadixSort(ArrayView<uint64>(order), GetTaggedAllocator(MemoryTag::Asset));
+
+    bool queued = false;
+    for (const uint64 key : order)
+    {
+        if (state->readsInFlight >= state->options.maxReadsInFlight)
+        {
+            break;
+        }
+        const uint32 index = static_cast<uint32>(key & 0xFFFFFFFFu);
+        State::Texture& texture = state->textures[index];
+        const uint32 mip = texture.residentMip - 1;
+        const MipRange& range = texture.mips[mip];
+
+        bool fits = true;
+        while (state->stats.residentBytes + state->stats.pendingBytes + range.size >
+               state->options.budget)
+        {
+            if (!state->EvictOne())
+            {
+                fits = false;
+                break;
+            }
+        }
+        if (!fits)
+        {
+            ++state->stats.overBudgetUpdates;
+            break;
+        }
+
+        DynamicArray<uint8>& pixels = texture.streamed[mip];
+        pixels.ResizeUninitialized(range.size);
+        AsyncRead read;
+        read.file = texture.file;
+        read.offset = range.offset;
+        read.buffer = MutableByteView(pixels.Data(), pixels.Size());
+        read.userData = index;
+        if (!state->io->QueueRead(read))
+        {
+            pixels.Clear();
+            break;
+        }
+        texture.readingMip = mip;
+        ++state->readsInFlight;
+        state->stats.pendingBytes += range.size;
+        queued = true;
+    }
+    if (queued)
+    {
+        // Reads that don't make it in come back as failed completions
+        (void)state->io->Submit();
+    }
+}
+
+ArrayView<const StreamedMip> TextureStreamer::Arrived() const
+{
+    return m_state->arrived;
+}
+
+uint32 TextureStreamer::ResidentMip(uint32 texture) const
+{
+    return m_state->textures[texture].residentMip;
+}
+
+ByteView TextureStreamer::MipData(uint32 texture, uint32 mip) const
+{
+    const State::Texture& resident = m_state->textures[texture];
+    if (mip < resident.residentMip || mip >= resident.info.mipCount)
+    {
+        return ByteView();
+    }
+    if (mip < resident.info.tailMip)
+    {
+        return resident.streamed[mip];
+    }
+    const uint64 tail_start = resident.mips[resident.info.mipCount - 1].offset;
+    const uint64 offset = resident.mips[mip].offset - tail_start;
+    return ByteView(resident.tail.Data() + offset, resident.mips[mip].size);
+}
+
+TextureStreamerStats TextureStreamer::Stats() const
+{
+    return m_state->stats;
+}
+
+} // namespace rsbl
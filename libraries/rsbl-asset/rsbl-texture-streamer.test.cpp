@@ -0,0 +1,236 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-texture-streamer.h"
+
+#include <rsbl-async-io.h>
+#include <rsbl-file.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+// A size x size texture and its chain, every byte of mip m is m * 16 + the texture's seed
+DynamicArray<Image> MipChain(uint32 size, uint8 seed)
+{
+    Image top;
+    top.width = size;
+    top.height = size;
+    top.pixels.Resize(ImageByteSize(size, size, ImageFormat::Rgba8));
+    DynamicArray<Image> below;
+    REQUIRE(GenerateMips(top, false, below));
+    DynamicArray<Image> mips;
+    mips.PushBack(rsblMove(top));
+    for (Image& mip : below)
+    {
+        mips.PushBack(rsblMove(mip));
+    }
+    for (uint32 mip = 0; mip < mips.Size(); ++mip)
+    {
+        std::memset(mips[mip].pixels.Data(), mip * 16 + seed, mips[mip].pixels.Size());
+    }
+    return mips;
+}
+
+bool HoldsMip(const TextureStreamer& streamer, uint32 texture, uint32 mip, uint8 seed)
+{
+    const ByteView data = streamer.MipData(texture, mip);
+    const StreamedTextureInfo& info = streamer.Info(texture);
+    const uint32 width = info.width >> mip > 0 ? info.width >> mip : 1;
+    const uint32 height = info.height >> mip > 0 ? info.height >> mip : 1;
+    if (data.Size() != ImageByteSize(width, height, info.format))
+    {
+        return false;
+    }
+    for (const uint8 byte : data)
+    {
+        if (byte != uint8(mip * 16 + seed))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Updates until nothing's being read, a few hundred times at most
+void Settle(TextureStreamer& streamer)
+{
+    for (uint32 i = 0; i < 1000; ++i)
+    {
+        streamer.Update();
+        if (streamer.Stats().pendingBytes == 0)
+        {
+            return;
+        }
+    }
+    FAIL("Reads never finished");
+}
+
+struct Fixture
+{
+    UniquePtr<AsyncIo> io;
+
+    Fixture()
+    {
+        Result<UniquePtr<AsyncIo>> created = AsyncIo::Create();
+        REQUIRE(created);
+        io = rsblMove(created.Value());
+    }
+};
+} // namespace
+
+TEST_SUITE("rsbl::TextureStreamer")
+{
+    TEST_CASE("Writing checks the chain")
+    {
+        const char* path = "rsbl-texture-streamer-test-bad.rtex";
+        DynamicArray<Image> mips = MipChain(16, 1);
+        CHECK_FALSE(WriteStreamedTexture(path, ArrayView<const Image>()));
+
+        // A mip missing from the middle
+        DynamicArray<Image> gap;
+        gap.PushBack(mips[0]);
+        gap.PushBack(mips[2]);
+        CHECK_FALSE(WriteStreamedTexture(path, gap));
+
+        mips[1].pixels.PopBack();
+        CHECK_FALSE(WriteStreamedTexture(path, mips));
+
+        // Nor can a file that isn't one be opened
+        Fixture fixture;
+        Result<UniquePtr<TextureStreamer>> streamer = TextureStreamer::Create(*fixture.io);
+        REQUIRE(streamer);
+        Result<FileHandle> file = OpenFile(path, FileOpenMode::Write);
+        REQUIRE(file);
+        REQUIRE(WriteFile(file.Value(), AsBytes("not a texture", 13)));
+        CHECK(CloseFile(file.Value()));
+        CHECK(streamer.Value()->Open(path).Category() == ErrorCategory::InvalidArgument);
+        CHECK(streamer.Value()->Open("missing.rtex").Category() == ErrorCategory::NotFound);
+        std::remove(path);
+    }
+
+    TEST_CASE("Opening reads the tail, requests stream the rest in")
+    {
+        const char* path = "rsbl-texture-streamer-test.rtex";
+        const DynamicArray<Image> mips = MipChain(64, 1);
+        REQUIRE(WriteStreamedTexture(path, mips));
+
+        Fixture fixture;
+        // 8x8 and down is 352 bytes with the padding between them, 16x16 would take it over
+        TextureStreamerOptions options;
+        options.tailBytes = 400;
+        Result<UniquePtr<TextureStreamer>> created = TextureStreamer::Create(*fixture.io, options);
+        REQUIRE(created);
+        TextureStreamer& streamer = *created.Value();
+
+        Result<uint32> texture = streamer.Open(path);
+        REQUIRE(texture);
+        const StreamedTextureInfo& info = streamer.Info(texture.Value());
+        CHECK(info.width == 64);
+        CHECK(info.mipCount == 7);
+        CHECK(info.tailMip == 3);
+        CHECK(streamer.ResidentMip(texture.Value()) == 3);
+        CHECK(streamer.Stats().tailBytes == 352);
+        for (uint32 mip = 3; mip < 7; ++mip)
+        {
+            CHECK(HoldsMip(streamer, texture.Value(), mip, 1));
+        }
+        CHECK(streamer.MipData(texture.Value(), 2).IsEmpty());
+
+        // Nothing asked for, nothing read
+        streamer.Update();
+        CHECK(streamer.Stats().pendingBytes == 0);
+
+        // One mip at a time, each arriving before the next is read
+        uint32 arrived = 0;
+        for (uint32 i = 0; i < 1000 && streamer.ResidentMip(texture.Value()) > 1; ++i)
+        {
+            streamer.Request(texture.Value(), 2);
+            streamer.Request(texture.Value(), 1);
+            streamer.Update();
+            for (const StreamedMip& mip : streamer.Arrived())
+            {
+                CHECK(mip.texture == texture.Value());
+                CHECK(mip.mip == 2 - arrived);
+                ++arrived;
+            }
+        }
+        CHECK(arrived == 2);
+        CHECK(streamer.ResidentMip(texture.Value()) == 1);
+        CHECK(HoldsMip(streamer, texture.Value(), 1, 1));
+        CHECK(HoldsMip(streamer, texture.Value(), 2, 1));
+        CHECK(streamer.MipData(texture.Value(), 0).IsEmpty());
+        const TextureStreamerStats stats = streamer.Stats();
+        CHECK(stats.mipsRead == 2);
+        CHECK(stats.residentBytes == (32 * 32 + 16 * 16) * 4);
+        CHECK(stats.failedReads == 0);
+        std::remove(path);
+    }
+
+    TEST_CASE("The budget drops what was asked for least recently")
+    {
+        const char* paths[3] = {"rsbl-texture-streamer-test-a.rtex",
+                                "rsbl-texture-streamer-test-b.rtex",
+                                "rsbl-texture-streamer-test-c.rtex"};
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            const DynamicArray<Image> mips = MipChain(32, uint8(i + 1));
+            REQUIRE(WriteStreamedTexture(paths[i], mips));
+        }
+
+        Fixture fixture;
+        // The tail is 8x8 and down, and there's room for two 16x16 mips
+        TextureStreamerOptions options;
+        options.tailBytes = 400;
+        options.budget = 2 * 16 * 16 * 4;
+        Result<UniquePtr<TextureStreamer>> created = TextureStreamer::Create(*fixture.io, options);
+        REQUIRE(created);
+        TextureStreamer& streamer = *created.Value();
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            REQUIRE(streamer.Open(paths[i]));
+        }
+
+        uint8 feedback[3] = {1, 1, kMipNotSampled};
+        streamer.RequestFromFeedback(feedback);
+        Settle(streamer);
+        CHECK(streamer.ResidentMip(0) == 1);
+        CHECK(streamer.ResidentMip(1) == 1);
+        CHECK(streamer.ResidentMip(2) == 2);
+
+        // Still wanted, so the third can't have one
+        streamer.RequestFromFeedback(feedback);
+        streamer.Request(2, 1);
+        Settle(streamer);
+        CHECK(streamer.ResidentMip(2) == 2);
+        CHECK(streamer.Stats().overBudgetUpdates > 0);
+
+        // The second stops being sampled, the first was sampled more recently, so the second
+        // gives way
+        feedback[1] = kMipNotSampled;
+        streamer.RequestFromFeedback(feedback);
+        Settle(streamer);
+        streamer.Request(2, 1);
+        Settle(streamer);
+        CHECK(streamer.ResidentMip(0) == 1);
+        CHECK(streamer.ResidentMip(1) == 2);
+        CHECK(streamer.ResidentMip(2) == 1);
+        CHECK(HoldsMip(streamer, 2, 1, 3));
+        CHECK(HoldsMip(streamer, 1, 2, 2));
+
+        const TextureStreamerStats stats = streamer.Stats();
+        CHECK(stats.mipsRead == 3);
+        CHECK(stats.mipsEvicted == 1);
+        CHECK(stats.residentBytes <= options.budget);
+        for (const char* path : paths)
+        {
+            std::remove(path);
+        }
+    }
+}
@@ -0,0 +1,303 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-vfs.h"
+
+#include "include/rsbl-pack.h"
+#include "include/rsbl-remote-pack.h"
+
+#include <rsbl-file.h>
+#include <rsbl-hash.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+// Longest directory plus path a loose file lookup can build, on the stack
+constexpr uint64 kMaxPathLength = 1024;
+
+// Virtual paths stay inside their mounts: relative, and no ".." anywhere
+bool IsValidPath(StringView path)
+{
+    if (path.IsEmpty() || path[0] == '/' || path[0] == '\\')
+    {
+        return false;
+    }
+    uint64 segment_start = 0;
+    for (uint64 i = 0; i <= path.Size(); ++i)
+    {
+        if (i == path.Size() || path[i] == '/' || path[i] == '\\')
+        {
+            if (path.Substring(segment_start, i - segment_start) == StringView("..", 2))
+            {
+                return false;
+            }
+            segment_start = i + 1;
+        }
+    }
+    return true;
+}
+
+bool JoinPath(const String& directory, StringView path, char (&out)[kMaxPathLength])
+{
+    const uint64 size = directory.Size() + 1 + path.Size();
+    if (size >= kMaxPathLength)
+    {
+        return false;
+    }
+    std::memcpy(out, directory.Data(), directory.Size());
+    out[directory.Size()] = '/';
+    std::memcpy(out + directory.Size() + 1, path.Data(), path.Size());
+    out[size] = '\0';
+    return true;
+}
+} // namespace
+
+struct Vfs::State
+{
+    // Exactly one of pack and directory is set
+    struct Mount
+    {
+        // Where a remote pack's bytes come from, outlives it
+        UniquePtr<RemotePack> remote;
+        UniquePtr<Pack> pack;
+        String directory;
+    };
+
+    // Oldest first, searched from the back
+    DynamicArray<Mount> mounts;
+};
+
+// Where a path resolved to
+struct Vfs::Location
+{
+    const Pack* pack = nullptr;
+    const PackEntry* entry = nullptr;
+    const String* directory = nullptr;
+    uint64 size = 0;
+};
+
+Vfs::Vfs()
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+    m_state = new State();
+}
+
+Vfs::~Vfs()
+{
+    delete m_state;
+}
+
+Result<> Vfs::MountDirectory(const char* directory)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    Result<FileInfo> info = GetFileInfo(directory);
+    if (!info)
+    {
+        return PendingFailure{info.Category()};
+    }
+    if (!info.Value().isDirectory)
+    {
+        return {ErrorCategory::InvalidArgument, "Mounted path isn't a directory"};
+    }
+
+    State::Mount mount;
+    mount.directory = StringView(directory);
+    // Joined back on with a '/'
+    while (mount.directory.Size() > 1 && (mount.directory[mount.directory.Size() - 1] == '/' ||
+                                          mount.directory[mount.directory.Size() - 1] == '\\'))
+    {
+        mount.directory.Resize(mount.directory.Size() - 1);
+    }
+    m_state->mounts.PushBack(rsblMove(mount));
+    return ResultCode::Success;
+}
+
+Result<> Vfs::MountPack(const char* path)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    Result<UniquePtr<Pack>> pack = Pack::Open(path);
+    if (!pack)
+    {
+        return PendingFailure{pack.Category()};
+    }
+
+    State::Mount mount;
+    mount.pack = rsblMove(pack.Value());
+    m_state->mounts.PushBack(rsblMove(mount));
+    return ResultCode::Success;
+}
+
+Result<> Vfs::MountRemotePack(StringView remotePath,
+                              const char* localPath,
+                              const RemotePackOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Asset);
+
+    Result<UniquePtr<RemotePack>> remote = RemotePack::Open(remotePath, localPath, options);
+    if (!remote)
+    {
+        return PendingFailure{remote.Category()};
+    }
+    Result<UniquePtr<Pack>> pack = Pack::Open(localPath, remote.Value().Get());
+    if (!pack)
+    {
+        return PendingFailure{pack.Category()};
+    }
+
+    State::Mount mount;
+    mount.remote = rsblMove(remote.Value());
+    mount.pack = rsblMove(pack.Value());
+    m_state->mounts.PushBack(rsblMove(mount));
+    return ResultCode::Success;
+}
+
+Result<Vfs::Location> Vfs::Find(StringView path, uint64 hash) const
+{
+    if (!IsValidPath(path))
+    {
+        return {ErrorCategory::InvalidArgument, "Virtual paths are relative, without '..'"};
+    }
+
+    const DynamicArray<State::Mount>& mounts = m_state->mounts;
+    for (uint64 i = mounts.Size(); i-- > 0;)
+    {
+        const State::Mount& mount = mounts[i];
+        Location location;
+        if (mount.pack)
+        {
+            location.entry = mount.pack->Find(path, hash);
+            if (location.entry == nullptr)
+            {
+                continue;
+            }
+            location.pack = mount.pack.Get();
+            location.size = location.entry->size;
+            return location;
+        }
+
+        char full_path[kMaxPathLength];
+        if (!JoinPath(mount.directory, path, full_path))
+        {
+            return {ErrorCategory::InvalidArgument, "Path too long"};
+        }
+        Result<FileInfo> info = GetFileInfo(full_path);
+        if (!info || info.Value().isDirectory)
+        {
+            continue;
+        }
+        location.directory = &mount.directory;
+        location.size = info.Value().size;
+        return location;
+    }
+
+    return {ErrorCategory::NotFound, "No mount has the file"};
+}
+
+Result<uint64> Vfs::Read(StringView path, uint64 hash, MutableByteView buffer) const
+{
+    Result<Location> found = Find(path, hash);
+    if (!found)
+    {
+        return PendingFailure{found.Category()};
+    }
+    const Location& location = found.Value();
+    if (location.pack != nullptr)
+    {
+        return location.pack->Read(*location.entry, buffer);
+    }
+
+    char full_path[kMaxPathLength];
+    JoinPath(*location.directory, path, full_path);
+    return OpenAndReadFile(full_path, buffer);
+}
+
+Result<> Vfs::ReadAll(StringView path, uint64 hash, DynamicArray<uint8>& out) const
+{
+    Result<Location> found = Find(path, hash);
+    if (!found)
+    {
+        return PendingFailure{found.Category()};
+    }
+    const Location& location = found.Value();
+    out.Resize(location.size);
+    if (location.pack != nullptr)
+    {
+        Result<uint64> read = location.pack->Read(*location.entry, MutableByteView(out));
+        if (!read)
+        {
+            return PendingFailure{read.Category()};
+        }
+        return ResultCode::Success;
+    }
+
+    char full_path[kMaxPathLength];
+    JoinPath(*location.directory, path, full_path);
+    Result<uint64> read = OpenAndReadFile(full_path, MutableByteView(out));
+    if (!read)
+    {
+        return PendingFailure{read.Category()};
+    }
+    // The file can shrink between the lookup and the read
+    out.Resize(read.Value());
+    return ResultCode::Success;
+}
+
+bool Vfs::Exists(StringView path) const
+{
+    return static_cast<bool>(Find(path, Hash<StringView>()(path)));
+}
+
+Result<uint64> Vfs::GetSize(StringView path) const
+{
+    Result<Location> found = Find(path, Hash<StringView>()(path));
+    if (!found)
+    {
+        return PendingFailure{found.Category()};
+    }
+    return found.Value().size;
+}
+
+Result<uint64> Vfs::Read(StringView path, MutableByteView buffer) const
+{
+    return Read(path, Hash<StringView>()(path), buffer);
+}
+
+Result<> Vfs::ReadAll(StringView path, DynamicArray<uint8>& out) const
+{
+    return ReadAll(path, Hash<StringView>()(path), out);
+}
+
+bool Vfs::Exists(StringId path) const
+{
+    return static_cast<bool>(Find(path.View(), path.GetHash()));
+}
+
+Result<uint64> Vfs::GetSize(StringId path) const
+{
+    Result<Location> found = Find(path.View(), path.GetHash());
+    if (!found)
+    {
+        return PendingFailure{found.Category()};
+    }
+    return found.Value().size;
+}
+
+Result<uint64> Vfs::Read(StringId path, MutableByteView buffer) const
+{
+    return Read(path.View(), path.GetHash(), buffer);
+}
+
+Result<> Vfs::ReadAll(StringId path, DynamicArray<uint8>& out) const
+{
+    return ReadAll(path.View(), path.GetHash(), out);
+}
+
+} // namespace rsbl
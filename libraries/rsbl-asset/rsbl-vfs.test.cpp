@@ -0,0 +1,118 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-pack.h"
+#include "include/rsbl-vfs.h"
+
+#include <rsbl-file.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kPackPath = "rsbl-vfs-test.rpak";
+constexpr const char* kDirectory = "rsbl-vfs-test-dir";
+
+void WriteLooseFile(const char* path, const char* text)
+{
+    Result<FileHandle> file = OpenFile(path, FileOpenMode::Write);
+    REQUIRE(file);
+    REQUIRE(WriteFile(file.Value(), AsBytes(text, std::strlen(text))));
+    CHECK(CloseFile(file.Value()));
+}
+
+StringView AsText(const DynamicArray<uint8>& bytes)
+{
+    return StringView(reinterpret_cast<const char*>(bytes.Data()), bytes.Size());
+}
+} // namespace
+
+TEST_SUITE("rsbl::Vfs")
+{
+    TEST_CASE("Packs and loose directories")
+    {
+        {
+            Result<UniquePtr<PackWriter>> writer = PackWriter::Create(kPackPath);
+            REQUIRE(writer);
+            REQUIRE(writer.Value()->Add(StringView("scenes/a.gltf"), AsBytes("packed a", 8)));
+            REQUIRE(writer.Value()->Add(StringView("scenes/b.gltf"), AsBytes("packed b", 8)));
+            REQUIRE(writer.Value()->Finish());
+        }
+        std::filesystem::remove_all(kDirectory);
+        std::filesystem::create_directories(std::filesystem::path(kDirectory) / "scenes");
+        WriteLooseFile("rsbl-vfs-test-dir/scenes/b.gltf", "loose b, newer");
+        WriteLooseFile("rsbl-vfs-test-dir/scenes/c.gltf", "loose c");
+
+        {
+            Vfs vfs;
+            REQUIRE(vfs.MountPack(kPackPath));
+            REQUIRE(vfs.MountDirectory(kDirectory));
+
+            DynamicArray<uint8> bytes;
+            REQUIRE(vfs.ReadAll("scenes/a.gltf", bytes));
+            CHECK(AsText(bytes) == StringView("packed a"));
+
+            // The directory was mounted last, so it wins
+            REQUIRE(vfs.ReadAll("scenes/b.gltf", bytes));
+            CHECK(AsText(bytes) == StringView("loose b, newer"));
+
+            REQUIRE(vfs.ReadAll(StringId("scenes/c.gltf"), bytes));
+            CHECK(AsText(bytes) == StringView("loose c"));
+
+            Result<uint64> size = vfs.GetSize("scenes/a.gltf");
+            REQUIRE(size);
+            CHECK(size.Value() == 8);
+            size = vfs.GetSize(StringId("scenes/c.gltf"));
+            REQUIRE(size);
+            CHECK(size.Value() == 7);
+
+            char buffer[16] = {};
+            Result<uint64> read = vfs.Read(StringId("scenes/a.gltf"), AsWritableBytes(buffer, 16));
+            REQUIRE(read);
+            CHECK(read.Value() == 8);
+            CHECK(std::memcmp(buffer, "packed a", 8) == 0);
+
+            CHECK(vfs.Exists("scenes/a.gltf"));
+            CHECK_FALSE(vfs.Exists("scenes/d.gltf"));
+            // Directories aren't files
+            CHECK_FALSE(vfs.Exists("scenes"));
+            CHECK(vfs.GetSize("scenes/d.gltf").Category() == ErrorCategory::NotFound);
+
+            // Nothing outside the mounts
+            CHECK(vfs.GetSize("../rsbl-vfs-test.rpak").Category() ==
+                  ErrorCategory::InvalidArgument);
+            CHECK(vfs.GetSize("/etc/passwd").Category() == ErrorCategory::InvalidArgument);
+            CHECK_FALSE(vfs.Exists("scenes/../../rsbl-vfs-test.rpak"));
+        }
+
+        // Mounted the other way round, the pack wins
+        {
+            Vfs vfs;
+            REQUIRE(vfs.MountDirectory("rsbl-vfs-test-dir/"));
+            REQUIRE(vfs.MountPack(kPackPath));
+            DynamicArray<uint8> bytes;
+            REQUIRE(vfs.ReadAll("scenes/b.gltf", bytes));
+            CHECK(AsText(bytes) == StringView("packed b"));
+            REQUIRE(vfs.ReadAll("scenes/c.gltf", bytes));
+            CHECK(AsText(bytes) == StringView("loose c"));
+        }
+
+        std::filesystem::remove_all(kDirectory);
+        std::remove(kPackPath);
+    }
+
+    TEST_CASE("Mounting things that aren't there")
+    {
+        Vfs vfs;
+        CHECK(vfs.MountDirectory("rsbl-vfs-test-missing").Category() == ErrorCategory::NotFound);
+        CHECK(vfs.MountPack("rsbl-vfs-test-missing.rpak").Category() == ErrorCategory::NotFound);
+        CHECK_FALSE(vfs.Exists("anything"));
+    }
+}
@@ -0,0 +1,278 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-clock.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-string.h>
+#include <rsbl-thread.h>
+
+#include <atomic>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+// Micro-benchmarks with numbers that can be compared from run to run. Each benchmark warms up,
+// picks how many iterations a sample takes so that a sample runs long enough for the clock, then
+// takes a number of samples and reports their median time per iteration and how far they spread
+// (the median absolute deviation), which a stray context switch barely moves:
+//
+//     int main(int argc, char** argv)
+//     {
+//         Bench bench("rsbl-sort", argc, argv);
+//         bench.Run("RadixSort", [&]() { ... DoNotOptimize(keys[0]); }, {.items = kCount});
+//         return bench.Finish();
+//     }
+//
+// Benchmark executables take:
+//   --filter <text>  Only run benchmarks whose names contain text
+//   --json <path>    Write every result there too, see rsbl-perf-report.h, to compare runs
+//                    with scripts/compare_perf.py
+//   --min-time <ms>  Time each benchmark's samples take together, 200 by default
+//   --samples <n>    Samples per benchmark, 15 by default
+//   --smoke          One iteration of each, no warmup: only checks they still run, for CTest
+//
+// rsbl_add_benchmark in cmake/test-helpers.cmake builds them and registers the smoke run.
+
+namespace rsbl
+{
+
+namespace Internal
+{
+void UseCharPointer(const volatile char* pointer);
+} // namespace Internal
+
+// Makes the compiler treat value as read, so the work that computed it can't be thrown away
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    Internal::UseCharPointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// And as read and then written, so it can't be assumed to hold what it did before
+template <typename T>
+inline void DoNotOptimize(T& value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    Internal::UseCharPointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : "+r,m"(value) : : "memory");
+#endif
+}
+
+// Makes the compiler finish every store to memory before this point, and read memory again
+// after it
+inline void ClobberMemory()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
+
+// How to read one iteration, both optional
+struct BenchConfig
+{
+    uint64 bytes = 0; // Processed per iteration, for a GB/s figure
+    uint64 items = 0; // Processed per iteration, for an items/s figure
+};
+
+// Nanoseconds per iteration over a benchmark's samples
+struct BenchStats
+{
+    uint32 samples = 0;
+    double medianNs = 0.0;
+    double madNs = 0.0; // Median absolute deviation from the median
+    double meanNs = 0.0;
+    double minNs = 0.0;
+    double p90Ns = 0.0; // Interpolated between the samples either side
+    double p99Ns = 0.0;
+    double maxNs = 0.0;
+};
+
+// Sorts nsPerIteration, which are times and so never negative, and then overwrites them
+BenchStats ComputeBenchStats(ArrayView<double> nsPerIteration);
+
+// Sorts values that are never negative, the way ComputeBenchStats does
+void SortBenchSamples(ArrayView<double> values);
+
+struct BenchResult
+{
+    String name;
+    uint64 iterations = 0; // Per sample
+    BenchConfig config;
+    BenchStats stats;
+    DynamicArray<double> nsPerIteration; // Each sample's, in the order they were taken
+};
+
+class Bench
+{
+  public:
+    // suite names the executable's results, argc and argv are main's
+    Bench(const char* suite, int argc, char** argv);
+
+    // Times f, called over and over. Anything it computes should go to DoNotOptimize.
+    template <typename F>
+    void Run(const char* name, F&& f, const BenchConfig& config = {})
+    {
+        Measure(name, config, [&](uint64 iterations) {
+            const uint64 start = Clock::NowTicks();
+            for (uint64 i = 0; i < iterations; ++i)
+            {
+                f();
+            }
+            return Clock::NowTicks() - start;
+        });
+    }
+
+    // Times f, calling setup untimed before each call: for work that changes what it works on,
+    // like sorting. Each call is timed on its own, so f should take a microsecond or more.
+    template <typename Setup, typename F>
+        requires(!IsSame<Decay<F>, BenchConfig>)
+    void Run(const char* name, Setup&& setup, F&& f, const BenchConfig& config = {})
+    {
+        Measure(name, config, [&](uint64 iterations) {
+            uint64 ticks = 0;
+            for (uint64 i = 0; i < iterations; ++i)
+            {
+                setup();
+                ClobberMemory();
+                const uint64 start = Clock::NowTicks();
+                f();
+                ClobberMemory();
+                ticks += Clock::NowTicks() - start;
+            }
+            return ticks;
+        });
+    }
+
+    // Adds a result timed some other way, one value per iteration: for what can't be repeated
+    // at will, like a read from a cold cache, or for every operation's latency rather than an
+    // average. Prints like the others do.
+    void Record(const char* name, const BenchConfig& config, ArrayView<double> nsPerIteration);
+
+    // Starts a group of benchmarks in the output, e.g. the size they all run at
+    void Section(const char* name);
+
+    // The JSON's kind, see rsbl-perf-report.h: micro unless set
+    void SetKind(const char* kind)
+    {
+        m_kind = kind;
+    }
+
+    // Whether the filter lets name run, to skip setting up what Record would then drop
+    bool Selected(const char* name) const
+    {
+        return !Skip(name);
+    }
+
+    // Benchmarks timed by hand should do as little as gets them through once, too
+    bool Smoke() const
+    {
+        return m_smoke;
+    }
+
+    ArrayView<const BenchResult> Results() const
+    {
+        return m_results;
+    }
+
+    // Writes the JSON if asked for. What main returns: nonzero if the command line or the JSON
+    // were wrong.
+    int Finish();
+
+  private:
+    // Runs a batch of iterations and returns the ticks they took
+    template <typename F>
+    void Measure(const char* name, const BenchConfig& config, F&& batch)
+    {
+        if (Skip(name))
+        {
+            return;
+        }
+        MeasureBatches(name, config, [](void* context, uint64 iterations) {
+            return (*static_cast<F*>(context))(iterations);
+        }, &batch);
+    }
+
+    bool Skip(const char* name) const;
+    BenchResult& AddResult(const char* name, const BenchConfig& config);
+    void MeasureBatches(const char* name,
+                        const BenchConfig& config,
+                        uint64 (*batch)(void* context, uint64 iterations),
+                        void* context);
+
+    String m_suite;
+    String m_kind{"micro"};
+    String m_filter;
+    String m_jsonPath;
+    String m_section;
+    double m_minTimeMs = 200.0;
+    uint32 m_samples = 15;
+    bool m_smoke = false;
+    bool m_badArguments = false;
+    DynamicArray<BenchResult> m_results;
+};
+
+// Threads for a multithreaded benchmark, released together so none gets a head start. Add them
+// in a Run's setup and Start and Join them in the timed part, so creating them isn't timed:
+//
+//     UniquePtr<BenchThreads> threads;
+//     bench.Run("4 threads", [&]() {
+//         threads = MakeUnique<BenchThreads>();
+//         for (uint32 i = 0; i < 4; ++i)
+//         {
+//             threads->Add([&shared]() { ... });
+//         }
+//     }, [&]() {
+//         threads->Start();
+//         threads->Join();
+//     });
+class BenchThreads
+{
+  public:
+    using Body = PooledFunction<void(), 48>;
+
+    explicit BenchThreads(uint32 maxThreads = 64);
+
+    // Releases and joins whatever is still running
+    ~BenchThreads();
+
+    BenchThreads(const BenchThreads&) = delete;
+    BenchThreads& operator=(const BenchThreads&) = delete;
+
+    // Creates a thread that runs body once Start is called. False if it couldn't be created,
+    // or there are already maxThreads.
+    bool Add(Body&& body);
+
+    void Start();
+
+    // Waits for every body to return
+    void Join();
+
+    uint32 Count() const
+    {
+        return static_cast<uint32>(m_threads.Size());
+    }
+
+  private:
+    DynamicArray<Body> m_bodies; // Reserved up front, threads point into it
+    DynamicArray<UniquePtr<Thread>> m_threads;
+    uint32 m_maxThreads;
+    std::atomic<bool> m_started{false};
+};
+
+} // namespace rsbl
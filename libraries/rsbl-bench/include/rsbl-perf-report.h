@@ -0,0 +1,117 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-result.h>
+#include <rsbl-string.h>
+
+// The JSON every benchmark writes its results as, micro-benchmarks, IO, asset loads and frame
+// times alike, so that scripts/compare_perf.py can compare any two runs of one, from different
+// commits or machines. Fields are only ever added to a version; renaming or removing one bumps
+// kPerfReportSchema.
+//
+//     {
+//       "schema": "rsbl-perf/1",
+//       "suite": "rsbl-sort",              What wrote it, usually the executable
+//       "kind": "micro",                   micro, io, load or frame
+//       "timestamp": "2025-06-01T12:00:00Z",
+//       "machine": {"os": "windows", "arch": "x64", "logicalProcessors": 16,
+//                   "physicalCores": 8, "l3Bytes": 33554432, "simd": "AVX2"},
+//       "config": {"smoke": false, ...},  How the run was set up, strings, numbers or bools
+//       "metrics": [
+//         {"name": "RadixSort/1M", "unit": "ns", "better": "lower", "value": 812.5,
+//          "spread": 3.1, "min": 805.0, "max": 840.2, "count": 15,
+//          "attributes": {"items": 1000000}, "samples": [805.0, ...]},
+//         ...
+//       ]
+//     }
+//
+// A metric's value is the median of its samples and spread their median absolute deviation. A
+// metric measured once, a peak byte count say, has that as its value, no spread and a single
+// sample. count is how many samples there were; past kMaxPerfSamples, samples holds evenly
+// spaced quantiles of them instead, sorted, which the comparison's rank test takes just as well.
+// Each metric is on a line of its own, so a baseline can be read back without a JSON parser.
+
+namespace rsbl
+{
+
+constexpr const char* kPerfReportSchema = "rsbl-perf/1";
+constexpr uint32 kMaxPerfSamples = 1000;
+
+enum class PerfUnit : uint8
+{
+    Nanoseconds,
+    Milliseconds,
+    Bytes,
+    Count,
+};
+
+const char* PerfUnitName(PerfUnit unit);
+
+struct PerfAttribute
+{
+    String key;
+    double value = 0.0;
+};
+
+struct PerfMetric
+{
+    String name;
+    PerfUnit unit = PerfUnit::Nanoseconds;
+    bool higherIsBetter = false;
+    double value = 0.0;
+    double spread = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    uint64 count = 0;
+    // Sorted, at most kMaxPerfSamples of them
+    DynamicArray<double> samples;
+    // Whatever else helps read the metric, like the bytes or items an iteration covers
+    DynamicArray<PerfAttribute> attributes;
+
+    void AddAttribute(const char* key, double attributeValue)
+    {
+        PerfAttribute& attribute = attributes.EmplaceBack();
+        attribute.key = key;
+        attribute.value = attributeValue;
+    }
+};
+
+class PerfReport
+{
+  public:
+    PerfReport(const char* suite, const char* kind);
+
+    void SetConfig(const char* key, const char* value);
+    void SetConfigNumber(const char* key, double value);
+    void SetConfigFlag(const char* key, bool value);
+
+    // A metric measured a number of times. samples is left sorted.
+    PerfMetric& AddSamples(const char* name, PerfUnit unit, ArrayView<double> samples);
+
+    // A metric measured once
+    PerfMetric& AddValue(const char* name, PerfUnit unit, double value);
+
+    ArrayView<const PerfMetric> Metrics() const
+    {
+        return m_metrics;
+    }
+
+    // The report as JSON, in the layout above
+    String ToJson() const;
+
+    Result<> Write(const char* path) const;
+
+  private:
+    String m_suite;
+    String m_kind;
+    // Each entry already a "key": value pair
+    DynamicArray<String> m_config;
+    DynamicArray<PerfMetric> m_metrics;
+};
+
+} // namespace rsbl
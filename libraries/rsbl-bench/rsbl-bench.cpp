@@ -0,0 +1,417 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include <rsbl-bench.h>
+
+#include <rsbl-perf-report.h>
+#include <rsbl-sort.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace Internal
+{
+void UseCharPointer(const volatile char* /*pointer*/)
+{
+}
+} // namespace Internal
+
+namespace
+{
+// Warming up takes this much of the time the samples do, however quickly it reaches a sample's
+// length
+constexpr double kWarmupFraction = 0.25;
+
+// Of sorted values, at fraction between the first and last
+double Percentile(ArrayView<const double> sorted, double fraction)
+{
+    const double position = fraction * static_cast<double>(sorted.Size() - 1);
+    const uint64 below = static_cast<uint64>(position);
+    if (below + 1 >= sorted.Size())
+    {
+        return sorted[sorted.Size() - 1];
+    }
+    const double weight = position - static_cast<double>(below);
+    return sorted[below] + (sorted[below + 1] - sorted[below]) * weight;
+}
+
+// A time per iteration in the unit that keeps it readable
+void FormatTime(char (&text)[32], double ns)
+{
+    if (ns < 1e3)
+    {
+        snprintf(text, sizeof(text), "%.2f ns", ns);
+    }
+    else if (ns < 1e6)
+    {
+        snprintf(text, sizeof(text), "%.2f us", ns / 1e3);
+    }
+    else
+    {
+        snprintf(text, sizeof(text), "%.2f ms", ns / 1e6);
+    }
+}
+
+// Under its section's heading, so without the section
+void PrintResult(const BenchResult& result, const char* name)
+{
+    const BenchStats& stats = result.stats;
+    char median[32];
+    FormatTime(median, stats.medianNs);
+    const double spread = stats.medianNs > 0.0 ? stats.madNs / stats.medianNs * 100.0 : 0.0;
+
+    char throughput[48] = "";
+    if (result.config.bytes != 0 && stats.medianNs > 0.0)
+    {
+        snprintf(throughput,
+                 sizeof(throughput),
+                 "%8.2f GB/s",
+                 static_cast<double>(result.config.bytes) / stats.medianNs);
+    }
+    else if (result.config.items != 0 && stats.medianNs > 0.0)
+    {
+        snprintf(throughput,
+                 sizeof(throughput),
+                 "%8.2f M/s",
+                 static_cast<double>(result.config.items) / stats.medianNs * 1e3);
+    }
+
+    printf("  %-44s %12s +-%5.1f%% %13s  (%u x %llu)\n",
+           name,
+           median,
+           spread,
+           throughput,
+           stats.samples,
+           static_cast<unsigned long long>(result.iterations));
+    fflush(stdout);
+}
+} // namespace
+
+// Benchmark samples are a few dozen, insertion sort does. Latencies recorded one per operation
+// can be many thousands: times aren't negative, so their bits sort in the same order as they do.
+void SortBenchSamples(ArrayView<double> values)
+{
+    if (values.Size() > 64)
+    {
+        DynamicArray<uint64> keys;
+        keys.Resize(values.Size());
+        memcpy(keys.Data(), values.Data(), values.Size() * sizeof(double));
+        RadixSort(ArrayView<uint64>(keys.Data(), keys.Size()));
+        memcpy(values.Data(), keys.Data(), values.Size() * sizeof(double));
+        return;
+    }
+
+    for (uint64 i = 1; i < values.Size(); ++i)
+    {
+        const double value = values[i];
+        uint64 j = i;
+        for (; j > 0 && values[j - 1] > value; --j)
+        {
+            values[j] = values[j - 1];
+        }
+        values[j] = value;
+    }
+}
+
+BenchStats ComputeBenchStats(ArrayView<double> nsPerIteration)
+{
+    BenchStats stats;
+    if (nsPerIteration.IsEmpty())
+    {
+        return stats;
+    }
+
+    SortBenchSamples(nsPerIteration);
+    const ArrayView<const double> sorted(nsPerIteration.Data(), nsPerIteration.Size());
+    stats.samples = static_cast<uint32>(sorted.Size());
+    stats.medianNs = Percentile(sorted, 0.5);
+    stats.minNs = sorted[0];
+    stats.maxNs = sorted[sorted.Size() - 1];
+    stats.p90Ns = Percentile(sorted, 0.9);
+    stats.p99Ns = Percentile(sorted, 0.99);
+
+    double sum = 0.0;
+    for (const double value : sorted)
+    {
+        sum += value;
+    }
+    stats.meanNs = sum / static_cast<double>(sorted.Size());
+
+    // The deviations reuse the samples, which aren't needed sorted any more
+    for (double& value : nsPerIteration)
+    {
+        value = std::fabs(value - stats.medianNs);
+    }
+    SortBenchSamples(nsPerIteration);
+    stats.madNs = Percentile(sorted, 0.5);
+    return stats;
+}
+
+Bench::Bench(const char* suite, int argc, char** argv)
+    : m_suite(suite)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* argument = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(argument, "--smoke") == 0)
+        {
+            m_smoke = true;
+            continue;
+        }
+
+        const bool takesValue = strcmp(argument, "--filter") == 0 ||
+                                strcmp(argument, "--json") == 0 ||
+                                strcmp(argument, "--min-time") == 0 ||
+                                strcmp(argument, "--samples") == 0;
+        if (!takesValue || value == nullptr)
+        {
+            fprintf(stderr,
+                    "%s: unknown argument %s\n"
+                    "  --filter <text> --json <path> --min-time <ms> --samples <n> --smoke\n",
+                    suite,
+                    argument);
+            m_badArguments = true;
+            break;
+        }
+        ++i;
+
+        if (strcmp(argument, "--filter") == 0)
+        {
+            m_filter = value;
+        }
+        else if (strcmp(argument, "--json") == 0)
+        {
+            m_jsonPath = value;
+        }
+        else if (strcmp(argument, "--min-time") == 0)
+        {
+            m_minTimeMs = atof(value);
+        }
+        else
+        {
+            m_samples = static_cast<uint32>(strtoul(value, nullptr, 10));
+        }
+    }
+
+    if (m_minTimeMs <= 0.0 || m_samples == 0)
+    {
+        fprintf(stderr, "%s: --min-time and --samples have to be above 0\n", suite);
+        m_badArguments = true;
+    }
+    if (!m_badArguments)
+    {
+        printf("%s\n", suite);
+    }
+}
+
+void Bench::Section(const char* name)
+{
+    m_section = name;
+    if (!m_badArguments)
+    {
+        printf("%s\n", name);
+    }
+}
+
+bool Bench::Skip(const char* name) const
+{
+    if (m_badArguments)
+    {
+        return true;
+    }
+    if (m_filter.IsEmpty())
+    {
+        return false;
+    }
+    // Either part of section/name will do
+    return strstr(name, m_filter.CStr()) == nullptr &&
+           strstr(m_section.CStr(), m_filter.CStr()) == nullptr;
+}
+
+BenchResult& Bench::AddResult(const char* name, const BenchConfig& config)
+{
+    BenchResult& result = m_results.EmplaceBack();
+    if (!m_section.IsEmpty())
+    {
+        result.name = m_section;
+        result.name.Append('/');
+    }
+    result.name.Append(name);
+    result.config = config;
+    return result;
+}
+
+void Bench::Record(const char* name, const BenchConfig& config, ArrayView<double> nsPerIteration)
+{
+    if (Skip(name) || nsPerIteration.IsEmpty())
+    {
+        return;
+    }
+    BenchResult& result = AddResult(name, config);
+    result.iterations = 1;
+    result.nsPerIteration.Append(nsPerIteration.Data(), nsPerIteration.Size());
+    result.stats = ComputeBenchStats(nsPerIteration);
+    PrintResult(result, name);
+}
+
+void Bench::MeasureBatches(const char* name,
+                           const BenchConfig& config,
+                           uint64 (*batch)(void* context, uint64 iterations),
+                           void* context)
+{
+    BenchResult& result = AddResult(name, config);
+
+    const double nsPerTick = 1e9 / static_cast<double>(Clock::TicksPerSecond());
+    DynamicArray<double> nsPerIteration;
+    if (m_smoke)
+    {
+        result.iterations = 1;
+        nsPerIteration.PushBack(static_cast<double>(batch(context, 1)) * nsPerTick);
+        result.nsPerIteration = nsPerIteration;
+        result.stats = ComputeBenchStats(nsPerIteration);
+        PrintResult(result, name);
+        return;
+    }
+
+    const double sampleNs = m_minTimeMs * 1e6 / static_cast<double>(m_samples);
+    const double warmupNs = m_minTimeMs * 1e6 * kWarmupFraction;
+
+    // Warm up caches, branch predictors and clocks, growing the batch until it takes a sample's
+    // time. Batches that grew from short ones can overshoot, so grow at most tenfold at once.
+    uint64 iterations = 1;
+    const uint64 warmupStart = Clock::NowTicks();
+    for (;;)
+    {
+        const double ns = static_cast<double>(batch(context, iterations)) * nsPerTick;
+        if (ns >= sampleNs)
+        {
+            const double warmedNs =
+                static_cast<double>(Clock::NowTicks() - warmupStart) * nsPerTick;
+            if (warmedNs >= warmupNs)
+            {
+                break;
+            }
+            continue;
+        }
+
+        const double wanted = ns > 0.0 ? static_cast<double>(iterations) * sampleNs * 1.2 / ns
+                                       : static_cast<double>(iterations) * 10.0;
+        const double limit = static_cast<double>(iterations) * 10.0;
+        const uint64 next = static_cast<uint64>(wanted < limit ? wanted : limit);
+        iterations = next > iterations ? next : iterations + 1;
+    }
+    result.iterations = iterations;
+
+    nsPerIteration.Reserve(m_samples);
+    for (uint32 sample = 0; sample < m_samples; ++sample)
+    {
+        const double ns = static_cast<double>(batch(context, iterations)) * nsPerTick;
+        nsPerIteration.PushBack(ns / static_cast<double>(iterations));
+    }
+    result.nsPerIteration = nsPerIteration;
+    result.stats = ComputeBenchStats(nsPerIteration);
+    PrintResult(result, name);
+}
+
+int Bench::Finish()
+{
+    if (m_badArguments)
+    {
+        return 2;
+    }
+    if (m_jsonPath.IsEmpty())
+    {
+        return 0;
+    }
+
+    PerfReport report(m_suite.CStr(), m_kind.CStr());
+    report.SetConfigFlag("smoke", m_smoke);
+    report.SetConfigNumber("minTimeMs", m_minTimeMs);
+    report.SetConfigNumber("samples", m_samples);
+    report.SetConfig("filter", m_filter.CStr());
+    for (BenchResult& result : m_results)
+    {
+        PerfMetric& metric =
+            report.AddSamples(result.name.CStr(), PerfUnit::Nanoseconds, result.nsPerIteration);
+        metric.AddAttribute("iterations", static_cast<double>(result.iterations));
+        if (result.config.bytes != 0)
+        {
+            metric.AddAttribute("bytes", static_cast<double>(result.config.bytes));
+        }
+        if (result.config.items != 0)
+        {
+            metric.AddAttribute("items", static_cast<double>(result.config.items));
+        }
+    }
+
+    if (auto written = report.Write(m_jsonPath.CStr()); !written)
+    {
+        fprintf(stderr, "Failed to write %s: %s\n", m_jsonPath.CStr(), written.FailureText());
+        return 1;
+    }
+    return 0;
+}
+
+BenchThreads::BenchThreads(uint32 maxThreads)
+    : m_maxThreads(maxThreads)
+{
+    m_bodies.Reserve(maxThreads);
+    m_threads.Reserve(maxThreads);
+}
+
+BenchThreads::~BenchThreads()
+{
+    Start();
+    Join();
+}
+
+bool BenchThreads::Add(Body&& body)
+{
+    if (m_bodies.Size() == m_maxThreads)
+    {
+        fprintf(stderr, "BenchThreads: more than %u threads\n", m_maxThreads);
+        return false;
+    }
+
+    Body* stored = &m_bodies.EmplaceBack(rsblMove(body));
+    auto thread = Thread::Create([this, stored]() -> Result<> {
+        // Yield rather than spin, there may be more threads than cores
+        while (!m_started.load(std::memory_order_acquire))
+        {
+            Thread::ThreadYield();
+        }
+        (*stored)();
+        return ResultCode::Success;
+    });
+    if (!thread)
+    {
+        fprintf(stderr, "BenchThreads: %s\n", thread.FailureText());
+        m_bodies.PopBack();
+        return false;
+    }
+    m_threads.PushBack(rsblMove(thread.Value()));
+    return true;
+}
+
+void BenchThreads::Start()
+{
+    m_started.store(true, std::memory_order_release);
+}
+
+void BenchThreads::Join()
+{
+    for (UniquePtr<Thread>& thread : m_threads)
+    {
+        Result<> joined = thread->Join();
+        rsblUnused(joined);
+    }
+    m_threads.Clear();
+}
+
+} // namespace rsbl
@@ -0,0 +1,163 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-bench.h"
+
+#include <rsbl-file.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+TEST_SUITE("Bench")
+{
+    TEST_CASE("Stats are robust to an outlier")
+    {
+        double samples[] = {12.0, 10.0, 11.0, 10.0, 500.0, 11.0, 10.0, 12.0, 11.0};
+        const BenchStats stats = ComputeBenchStats(samples);
+        CHECK(stats.samples == 9);
+        CHECK(stats.medianNs == doctest::Approx(11.0));
+        CHECK(stats.madNs == doctest::Approx(1.0));
+        CHECK(stats.minNs == doctest::Approx(10.0));
+        CHECK(stats.maxNs == doctest::Approx(500.0));
+        CHECK(stats.meanNs == doctest::Approx(587.0 / 9.0));
+        // Between the 8th and 9th of 9: 12 + (500 - 12) * 0.2
+        CHECK(stats.p90Ns == doctest::Approx(109.6));
+        CHECK(samples[0] <= samples[8]);
+
+        double one[] = {4.0};
+        const BenchStats single = ComputeBenchStats(one);
+        CHECK(single.medianNs == doctest::Approx(4.0));
+        CHECK(single.p99Ns == doctest::Approx(4.0));
+        CHECK(single.madNs == doctest::Approx(0.0));
+
+        CHECK(ComputeBenchStats({}).samples == 0);
+    }
+
+    TEST_CASE("Many samples sort the same as a few")
+    {
+        // 1000 down to 1, enough to be radix sorted
+        double samples[1000];
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            samples[i] = static_cast<double>(1000 - i);
+        }
+        const BenchStats stats = ComputeBenchStats(samples);
+        CHECK(stats.minNs == doctest::Approx(1.0));
+        CHECK(stats.maxNs == doctest::Approx(1000.0));
+        CHECK(stats.medianNs == doctest::Approx(500.5));
+        CHECK(stats.p99Ns == doctest::Approx(990.01));
+        CHECK(stats.madNs == doctest::Approx(250.0));
+        bool sorted = true;
+        for (uint32 i = 1; i < 1000; ++i)
+        {
+            sorted = sorted && samples[i - 1] <= samples[i];
+        }
+        CHECK(sorted);
+    }
+
+    TEST_CASE("Runs calibrate, filter and write JSON")
+    {
+        const char* path = "rsbl-bench-test.json";
+        const char* argv[] = {"bench", "--min-time", "5", "--samples", "5", "--filter", "sum",
+                              "--json", path};
+        Bench bench("rsbl-bench-test", 9, const_cast<char**>(argv));
+
+        uint64 sum = 0;
+        bench.Run("sum", [&]() {
+            for (uint64 i = 0; i < 100; ++i)
+            {
+                sum += i;
+            }
+            DoNotOptimize(sum);
+        }, {.items = 100});
+        bench.Run("skipped", [&]() { FAIL("Filtered out"); });
+
+        uint32 setups = 0;
+        uint32 calls = 0;
+        bench.Section("sums");
+        bench.Run("with setup", [&]() { ++setups; }, [&]() { ++calls; });
+
+        REQUIRE(bench.Results().Size() == 2);
+        const BenchResult& result = bench.Results()[0];
+        CHECK(result.name == StringView("sum"));
+        CHECK(result.stats.samples == 5);
+        // Enough iterations for a sample to take a millisecond
+        CHECK(result.iterations > 1);
+        CHECK(result.stats.medianNs > 0.0);
+        CHECK(result.stats.minNs <= result.stats.medianNs);
+        CHECK(bench.Results()[1].name == StringView("sums/with setup"));
+        CHECK(setups == calls);
+        CHECK(calls > 5);
+
+        REQUIRE(bench.Finish() == 0);
+        char text[8192] = {};
+        auto read = OpenAndReadFile(path, AsWritableBytes(text, sizeof(text) - 1));
+        REQUIRE(read);
+        CHECK(strstr(text, "\"schema\": \"rsbl-perf/1\"") != nullptr);
+        CHECK(strstr(text, "\"suite\": \"rsbl-bench-test\"") != nullptr);
+        CHECK(strstr(text, "\"kind\": \"micro\"") != nullptr);
+        CHECK(strstr(text, "\"name\": \"sums/with setup\"") != nullptr);
+        CHECK(strstr(text, "\"items\": 100") != nullptr);
+        CHECK(strstr(text, "\"unit\": \"ns\"") != nullptr);
+        std::remove(path);
+    }
+
+    TEST_CASE("Smoke runs run once, bad arguments run nothing")
+    {
+        const char* smokeArgv[] = {"bench", "--smoke"};
+        Bench smoke("smoke", 2, const_cast<char**>(smokeArgv));
+        uint32 calls = 0;
+        smoke.Run("once", [&]() { ++calls; });
+        CHECK(calls == 1);
+        CHECK(smoke.Results()[0].iterations == 1);
+        CHECK(smoke.Smoke());
+
+        // Recorded results skip the filter's and the calibration's work, one value each
+        double latencies[] = {3.0, 1.0, 2.0};
+        smoke.Section("recorded");
+        CHECK(smoke.Selected("latency"));
+        smoke.Record("latency", {.bytes = 4096}, latencies);
+        REQUIRE(smoke.Results().Size() == 2);
+        CHECK(smoke.Results()[1].name == StringView("recorded/latency"));
+        CHECK(smoke.Results()[1].stats.samples == 3);
+        CHECK(smoke.Results()[1].stats.medianNs == doctest::Approx(2.0));
+        CHECK(smoke.Finish() == 0);
+
+        const char* badArgv[] = {"bench", "--fast"};
+        Bench bad("bad", 2, const_cast<char**>(badArgv));
+        bad.Run("never", [&]() { ++calls; });
+        CHECK(calls == 1);
+        CHECK_FALSE(bad.Selected("never"));
+        CHECK(bad.Finish() != 0);
+    }
+
+    TEST_CASE("BenchThreads run their bodies once started, up to their limit")
+    {
+        std::atomic<uint32> ran{0};
+        {
+            BenchThreads threads(2);
+            CHECK(threads.Add([&ran]() { ran.fetch_add(1); }));
+            CHECK(threads.Add([&ran]() { ran.fetch_add(1); }));
+            CHECK_FALSE(threads.Add([&ran]() { ran.fetch_add(1); }));
+            CHECK(threads.Count() == 2);
+            CHECK(ran.load() == 0);
+
+            threads.Start();
+            threads.Join();
+            CHECK(ran.load() == 2);
+            CHECK(threads.Count() == 0);
+        }
+        {
+            // Never started: the destructor starts and joins it
+            BenchThreads threads(1);
+            CHECK(threads.Add([&ran]() { ran.fetch_add(1); }));
+        }
+        CHECK(ran.load() == 3);
+    }
+}
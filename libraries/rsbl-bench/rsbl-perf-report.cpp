@@ -0,0 +1,301 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include <rsbl-perf-report.h>
+
+#include <rsbl-bench.h>
+#include <rsbl-cpu-topology.h>
+#include <rsbl-cpu.h>
+#include <rsbl-file.h>
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <ctime>
+
+namespace rsbl
+{
+
+namespace
+{
+void AppendFormat(String& text, const char* format, ...)
+{
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    const int written = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (written > 0)
+    {
+        const uint64 size = static_cast<uint64>(written) < sizeof(buffer)
+                                ? static_cast<uint64>(written)
+                                : sizeof(buffer) - 1;
+        text.Append(StringView(buffer, size));
+    }
+}
+
+void AppendJsonString(String& json, const char* str)
+{
+    json.Append('"');
+    for (const char* c = str; *c != '\0'; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            json.Append('\\');
+            json.Append(*c);
+        }
+        else if (static_cast<unsigned char>(*c) < 0x20)
+        {
+            AppendFormat(json, "\\u%04x", static_cast<unsigned>(*c));
+        }
+        else
+        {
+            json.Append(*c);
+        }
+    }
+    json.Append('"');
+}
+
+// Whole numbers, byte counts say, come out exact. JSON has no infinity or NaN.
+void AppendJsonNumber(String& json, double value)
+{
+    constexpr double kExactIntegers = 9007199254740992.0; // 2^53
+    if (std::isfinite(value) && value == std::floor(value) && std::fabs(value) < kExactIntegers)
+    {
+        AppendFormat(json, "%.0f", value);
+    }
+    else if (std::isfinite(value))
+    {
+        AppendFormat(json, "%.10g", value);
+    }
+    else
+    {
+        json.Append("null");
+    }
+}
+
+const char* OsName()
+{
+#if defined(_WIN32)
+    return "windows";
+#elif defined(__APPLE__)
+    return "macos";
+#elif defined(__linux__)
+    return "linux";
+#else
+    return "unknown";
+#endif
+}
+
+const char* ArchName()
+{
+#if defined(_M_X64) || defined(__x86_64__)
+    return "x64";
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    return "arm64";
+#else
+    return "unknown";
+#endif
+}
+
+void AppendTimestamp(String& json)
+{
+    const std::time_t now = std::time(nullptr);
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    AppendJsonString(json, text);
+}
+
+// Starts a config entry with its key, for the value to follow
+String& AddConfigKey(DynamicArray<String>& config, const char* key)
+{
+    String& entry = config.EmplaceBack();
+    AppendJsonString(entry, key);
+    entry.Append(": ");
+    return entry;
+}
+} // namespace
+
+const char* PerfUnitName(PerfUnit unit)
+{
+    switch (unit)
+    {
+    case PerfUnit::Nanoseconds:
+        return "ns";
+    case PerfUnit::Milliseconds:
+        return "ms";
+    case PerfUnit::Bytes:
+        return "bytes";
+    case PerfUnit::Count:
+        return "count";
+    }
+    return "";
+}
+
+PerfReport::PerfReport(const char* suite, const char* kind)
+    : m_suite(suite)
+    , m_kind(kind)
+{
+}
+
+void PerfReport::SetConfig(const char* key, const char* value)
+{
+    AppendJsonString(AddConfigKey(m_config, key), value);
+}
+
+void PerfReport::SetConfigNumber(const char* key, double value)
+{
+    AppendJsonNumber(AddConfigKey(m_config, key), value);
+}
+
+void PerfReport::SetConfigFlag(const char* key, bool value)
+{
+    AddConfigKey(m_config, key).Append(value ? "true" : "false");
+}
+
+PerfMetric& PerfReport::AddSamples(const char* name, PerfUnit unit, ArrayView<double> samples)
+{
+    PerfMetric& metric = m_metrics.EmplaceBack();
+    metric.name = name;
+    metric.unit = unit;
+    metric.count = samples.Size();
+    if (samples.IsEmpty())
+    {
+        return metric;
+    }
+
+    SortBenchSamples(samples);
+    metric.min = samples[0];
+    metric.max = samples[samples.Size() - 1];
+    if (samples.Size() <= kMaxPerfSamples)
+    {
+        metric.samples.Append(samples.Data(), samples.Size());
+    }
+    else
+    {
+        // Nearest ranks rather than interpolated, so each one is a value that was measured
+        metric.samples.Reserve(kMaxPerfSamples);
+        const double step =
+            static_cast<double>(samples.Size() - 1) / static_cast<double>(kMaxPerfSamples - 1);
+        for (uint32 i = 0; i < kMaxPerfSamples; ++i)
+        {
+            metric.samples.PushBack(samples[static_cast<uint64>(i * step + 0.5)]);
+        }
+    }
+
+    // The stats overwrite what they're given
+    DynamicArray<double> scratch;
+    scratch.Append(samples.Data(), samples.Size());
+    const BenchStats stats = ComputeBenchStats(scratch);
+    metric.value = stats.medianNs;
+    metric.spread = stats.madNs;
+    return metric;
+}
+
+PerfMetric& PerfReport::AddValue(const char* name, PerfUnit unit, double value)
+{
+    PerfMetric& metric = m_metrics.EmplaceBack();
+    metric.name = name;
+    metric.unit = unit;
+    metric.value = value;
+    metric.min = value;
+    metric.max = value;
+    metric.count = 1;
+    metric.samples.PushBack(value);
+    return metric;
+}
+
+String PerfReport::ToJson() const
+{
+    String json;
+    json.Append("{\n  \"schema\": ");
+    AppendJsonString(json, kPerfReportSchema);
+    json.Append(",\n  \"suite\": ");
+    AppendJsonString(json, m_suite.CStr());
+    json.Append(",\n  \"kind\": ");
+    AppendJsonString(json, m_kind.CStr());
+    json.Append(",\n  \"timestamp\": ");
+    AppendTimestamp(json);
+
+    const CpuTopology& topology = GetCpuTopology();
+    json.Append(",\n  \"machine\": {\"os\": ");
+    AppendJsonString(json, OsName());
+    json.Append(", \"arch\": ");
+    AppendJsonString(json, ArchName());
+    AppendFormat(json,
+                 ", \"logicalProcessors\": %llu, \"physicalCores\": %llu, \"l3Bytes\": %llu, "
+                 "\"simd\": ",
+                 static_cast<unsigned long long>(topology.logical.Size()),
+                 static_cast<unsigned long long>(topology.cores.Size()),
+                 static_cast<unsigned long long>(topology.l3Bytes));
+    AppendJsonString(json, SimdLevelName(GetBestSimdLevel()));
+
+    json.Append("},\n  \"config\": {");
+    for (uint64 i = 0; i < m_config.Size(); ++i)
+    {
+        json.Append(i == 0 ? "" : ", ");
+        json.Append(m_config[i].CStr());
+    }
+
+    json.Append("},\n  \"metrics\": [");
+    for (uint64 i = 0; i < m_metrics.Size(); ++i)
+    {
+        const PerfMetric& metric = m_metrics[i];
+        json.Append(i == 0 ? "\n    {\"name\": " : ",\n    {\"name\": ");
+        AppendJsonString(json, metric.name.CStr());
+        json.Append(", \"unit\": ");
+        AppendJsonString(json, PerfUnitName(metric.unit));
+        json.Append(metric.higherIsBetter ? ", \"better\": \"higher\", \"value\": "
+                                          : ", \"better\": \"lower\", \"value\": ");
+        AppendJsonNumber(json, metric.value);
+        json.Append(", \"spread\": ");
+        AppendJsonNumber(json, metric.spread);
+        json.Append(", \"min\": ");
+        AppendJsonNumber(json, metric.min);
+        json.Append(", \"max\": ");
+        AppendJsonNumber(json, metric.max);
+        AppendFormat(json, ", \"count\": %llu, \"attributes\": {",
+                     static_cast<unsigned long long>(metric.count));
+        for (uint64 a = 0; a < metric.attributes.Size(); ++a)
+        {
+            json.Append(a == 0 ? "" : ", ");
+            AppendJsonString(json, metric.attributes[a].key.CStr());
+            json.Append(": ");
+            AppendJsonNumber(json, metric.attributes[a].value);
+        }
+        json.Append("}, \"samples\": [");
+        for (uint64 s = 0; s < metric.samples.Size(); ++s)
+        {
+            json.Append(s == 0 ? "" : ", ");
+            AppendJsonNumber(json, metric.samples[s]);
+        }
+        json.Append("]}");
+    }
+    json.Append("\n  ]\n}\n");
+    return json;
+}
+
+Result<> PerfReport::Write(const char* path) const
+{
+    const String json = ToJson();
+    auto file = OpenFile(path, FileOpenMode::Write);
+    if (!file)
+    {
+        return PendingFailure{file.Category()};
+    }
+    auto written = WriteFile(file.Value(), AsBytes(json.CStr(), json.Size()));
+    Result<> closed = CloseFile(file.Value());
+    if (!written)
+    {
+        return PendingFailure{written.Category()};
+    }
+    return closed;
+}
+
+} // namespace rsbl
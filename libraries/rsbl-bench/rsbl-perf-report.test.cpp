@@ -0,0 +1,103 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-perf-report.h"
+
+#include <rsbl-file.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+TEST_SUITE("PerfReport")
+{
+    TEST_CASE("Samples are summarised by their median and spread")
+    {
+        PerfReport report("perf-test", "load");
+        double samples[] = {5.0, 1.0, 3.0, 2.0, 400.0};
+        const PerfMetric& metric = report.AddSamples("asset/loadMs", PerfUnit::Milliseconds,
+                                                     samples);
+        CHECK(metric.value == doctest::Approx(3.0));
+        CHECK(metric.spread == doctest::Approx(2.0));
+        CHECK(metric.min == 1.0);
+        CHECK(metric.max == 400.0);
+        CHECK(metric.count == 5);
+        REQUIRE(metric.samples.Size() == 5);
+        CHECK(metric.samples[0] == 1.0);
+        CHECK(metric.samples[4] == 400.0);
+        // Sorted in place
+        CHECK(samples[1] == 2.0);
+
+        const PerfMetric& peak = report.AddValue("asset/peakBytes", PerfUnit::Bytes, 1 << 20);
+        CHECK(peak.value == 1 << 20);
+        CHECK(peak.spread == 0.0);
+        CHECK(peak.count == 1);
+        CHECK(report.Metrics().Size() == 2);
+    }
+
+    TEST_CASE("Many samples are kept as quantiles")
+    {
+        DynamicArray<double> samples;
+        for (uint32 i = 0; i < 10000; ++i)
+        {
+            samples.PushBack(static_cast<double>((i * 7919) % 10000));
+        }
+        PerfReport report("perf-test", "frame");
+        const PerfMetric& metric = report.AddSamples("cpuFrameMs", PerfUnit::Milliseconds,
+                                                     samples);
+        CHECK(metric.count == 10000);
+        REQUIRE(metric.samples.Size() == kMaxPerfSamples);
+        CHECK(metric.samples[0] == 0.0);
+        CHECK(metric.samples[kMaxPerfSamples - 1] == 9999.0);
+        bool sorted = true;
+        for (uint32 i = 1; i < kMaxPerfSamples; ++i)
+        {
+            sorted = sorted && metric.samples[i - 1] <= metric.samples[i];
+        }
+        CHECK(sorted);
+        CHECK(metric.samples[kMaxPerfSamples / 2] == doctest::Approx(5000.0).epsilon(0.01));
+    }
+
+    TEST_CASE("JSON has every field, a metric per line")
+    {
+        PerfReport report("perf-test", "io");
+        report.SetConfig("path", "C:\\data\\\"quoted\"");
+        report.SetConfigNumber("runs", 5);
+        report.SetConfigFlag("cold", true);
+        double samples[] = {1.5, 2.5};
+        PerfMetric& metric = report.AddSamples("read/64 KB", PerfUnit::Nanoseconds, samples);
+        metric.AddAttribute("bytes", 65536);
+        PerfMetric& rate = report.AddValue("throughput", PerfUnit::Count, 12345678901.0);
+        rate.higherIsBetter = true;
+
+        const String json = report.ToJson();
+        const char* text = json.CStr();
+        CHECK(strstr(text, "\"schema\": \"rsbl-perf/1\"") != nullptr);
+        CHECK(strstr(text, "\"suite\": \"perf-test\"") != nullptr);
+        CHECK(strstr(text, "\"kind\": \"io\"") != nullptr);
+        CHECK(strstr(text, "\"timestamp\": \"") != nullptr);
+        CHECK(strstr(text, "\"logicalProcessors\": ") != nullptr);
+        CHECK(strstr(text, "\"path\": \"C:\\\\data\\\\\\\"quoted\\\"\"") != nullptr);
+        CHECK(strstr(text, "\"runs\": 5, \"cold\": true") != nullptr);
+        CHECK(strstr(text,
+                     "{\"name\": \"read/64 KB\", \"unit\": \"ns\", \"better\": \"lower\", "
+                     "\"value\": 2, \"spread\": 0.5, \"min\": 1.5, \"max\": 2.5, \"count\": 2, "
+                     "\"attributes\": {\"bytes\": 65536}, \"samples\": [1.5, 2.5]}") != nullptr);
+        // Whole numbers are exact however big
+        CHECK(strstr(text, "\"better\": \"higher\", \"value\": 12345678901,") != nullptr);
+
+        const char* path = "rsbl-perf-report-test.json";
+        REQUIRE(report.Write(path));
+        char written[4096] = {};
+        auto read = OpenAndReadFile(path, AsWritableBytes(written, sizeof(written) - 1));
+        REQUIRE(read);
+        // The timestamp could have ticked over in between
+        CHECK(strstr(written, "{\"name\": \"read/64 KB\"") != nullptr);
+        CHECK(read.Value() == json.Size());
+        std::remove(path);
+    }
+}
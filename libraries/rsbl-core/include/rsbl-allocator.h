@@ -0,0 +1,170 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-int-types.h"
+
+// TODO: thread-safe arena variant? For now, arenas are expected to be owned by a single thread
+// TODO: virtual memory backed arena that commits pages on demand
+
+namespace rsbl
+{
+
+// Same reasoning as kFunctionBufferAlignment, we always give malloc-style 16 byte alignment
+constexpr uint64 kDefaultAllocationAlignment = 16;
+
+// Minimal allocator interface. Sizes are passed back into Free so allocators don't need to track
+// per-allocation headers (and so arenas can roll back the most recent allocation).
+class Allocator
+{
+  public:
+    virtual ~Allocator() = default;
+
+    virtual void* Allocate(uint64 size, uint64 alignment) = 0;
+    virtual void Free(void* ptr, uint64 size, uint64 alignment) = 0;
+
+    // Resize an allocation, preserving the first min(old_size, new_size) bytes. The contents are
+    // moved with memcpy, so this is only valid for trivially relocatable data. A nullptr ptr acts
+    // like Allocate. The default implementation is Allocate + memcpy + Free.
+    virtual void* Reallocate(void* ptr, uint64 old_size, uint64 new_size, uint64 alignment);
+};
+
+// Global heap allocator, backed by malloc/free. Over-aligned requests are handled internally.
+class HeapAllocator : public Allocator
+{
+  public:
+    void* Allocate(uint64 size, uint64 alignment) override;
+    void Free(void* ptr, uint64 size, uint64 alignment) override;
+    void* Reallocate(void* ptr, uint64 old_size, uint64 new_size, uint64 alignment) override;
+};
+
+// Allocator used by containers when no allocator is given. This is the heap, charged to the
+// current MemoryTagScope (see rsbl-memory-tracking.h), and containers keep the allocator they
+// were constructed with.
+Allocator* GetDefaultAllocator();
+
+// Bump-pointer allocator. Allocations are a pointer increment, and Free is a no-op except for
+// the most recent allocation (which is rolled back, so Grow-style patterns don't waste space).
+// Everything is released in bulk with Reset(). When a block runs out, a new block is chained from
+// the backing allocator, and Reset() coalesces the chain into a single block so the next cycle
+// fits without chaining.
+class LinearArena : public Allocator
+{
+  public:
+    // Arena that allocates its blocks from the backing allocator
+    explicit LinearArena(uint64 block_size, Allocator* backing = GetDefaultAllocator());
+
+    // Arena that starts with caller-owned memory (e.g. a stack buffer). The arena never frees
+    // this buffer, but will chain heap blocks from the backing allocator if it runs out.
+    LinearArena(void* buffer, uint64 buffer_size, Allocator* backing = GetDefaultAllocator());
+
+    ~LinearArena() override;
+
+    // Arenas hand out pointers into their blocks, so they can't move or copy
+    LinearArena(LinearArena&&) = delete;
+    LinearArena& operator=(LinearArena&&) = delete;
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* Allocate(uint64 size, uint64 alignment) override;
+    void Free(void* ptr, uint64 size, uint64 alignment) override;
+
+    // Extends the top-most allocation in place when it fits in the current block
+    void* Reallocate(void* ptr, uint64 old_size, uint64 new_size, uint64 alignment) override;
+
+    template <typename T>
+    T* AllocateArray(uint64 count)
+    {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Release all allocations. Destructors are NOT run for anything allocated in the arena.
+    void Reset();
+
+    // Markers let a caller release everything allocated after a point in time. Any blocks chained
+    // after the marker are released back to the backing allocator, except that a marker taken
+    // before the first allocation resets the arena like Reset, keeping a block around.
+    struct Marker
+    {
+        void* block;
+        uint64 offset;
+    };
+
+    Marker GetMarker() const;
+    void ResetToMarker(Marker marker);
+
+    // Bytes handed out since the last Reset (including alignment padding)
+    uint64 BytesUsed() const;
+
+    // Total bytes reserved across all blocks
+    uint64 Capacity() const;
+
+  private:
+    struct Block
+    {
+        Block* prev;
+        uint8* data;
+        uint64 size;
+        uint64 used; // Only valid once the block is retired
+        bool owned;  // false for the caller-provided buffer
+    };
+
+    bool AddBlock(uint64 min_size);
+    void FreeBlocks();
+
+    Allocator* m_backing = nullptr;
+    Block* m_current = nullptr;
+    uint64 m_offset = 0;
+    uint64 m_blockSize = 0;
+
+    // Caller-provided buffer, which is re-used as the first block on every Reset
+    Block m_externalBlock{};
+};
+
+// Set of LinearArenas that rotate every frame. Allocations made in a frame remain valid until the
+// arena is cycled back around, which is frame_count frames later. This matches frames-in-flight,
+// where the GPU may still be reading data written a couple frames ago.
+class FrameArena : public Allocator
+{
+  public:
+    static constexpr uint32 kMaxFrameCount = 4;
+
+    explicit FrameArena(uint64 block_size,
+                        uint32 frame_count = 2,
+                        Allocator* backing = GetDefaultAllocator());
+    ~FrameArena() override;
+
+    FrameArena(FrameArena&&) = delete;
+    FrameArena& operator=(FrameArena&&) = delete;
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Advance to the next frame, and reset the arena used frame_count frames ago
+    void BeginFrame();
+
+    void* Allocate(uint64 size, uint64 alignment) override;
+    void Free(void* ptr, uint64 size, uint64 alignment) override;
+    void* Reallocate(void* ptr, uint64 old_size, uint64 new_size, uint64 alignment) override;
+
+    template <typename T>
+    T* AllocateArray(uint64 count)
+    {
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    LinearArena& CurrentArena();
+
+    uint32 FrameIndex() const
+    {
+        return m_frameIndex;
+    }
+
+  private:
+    // Arenas aren't movable, so we keep raw storage and construct in place
+    alignas(LinearArena) uint8 m_arenaStorage[kMaxFrameCount][sizeof(LinearArena)];
+    uint32 m_frameCount = 0;
+    uint32 m_frameIndex = 0;
+};
+
+} // namespace rsbl
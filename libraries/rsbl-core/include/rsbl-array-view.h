@@ -0,0 +1,191 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-assert.h"
+#include "rsbl-core.h"
+#include "rsbl-int-types.h"
+
+namespace rsbl
+{
+namespace Internal
+{
+    // Element pointers convert when the types match, and we aren't dropping const. Derived to base
+    // is deliberately rejected, indexing would use the wrong stride.
+    template <typename From, typename To>
+    concept ViewElementCompatible = rsbl::IsSame<rsbl::RemoveCV<From>, rsbl::RemoveCV<To>> &&
+                                    requires(From* from, To*& to) { to = from; };
+
+    template <typename Container>
+    using ContainerElement =
+        rsbl::RemovePointer<decltype(static_cast<Container*>(nullptr)->Data())>;
+
+    // Anything contiguous with Data() and Size(), like DynamicArray, FixedArray and SmallArray
+    template <typename Container, typename T>
+    concept ViewableContainer =
+        requires(Container& container) {
+            container.Data();
+            container.Size();
+        } &&
+        ViewElementCompatible<ContainerElement<Container>, T>;
+} // namespace Internal
+
+// Non-owning view of contiguous elements, for passing arrays around without copying or caring
+// about the container type. Containers convert implicitly, so functions can just take
+// ArrayView<const T>. The view doesn't keep anything alive, so don't hold on to it longer than
+// the underlying storage. Bounds are checked with rsblDebugAssert.
+template <typename T>
+class ArrayView
+{
+  public:
+    constexpr ArrayView() = default;
+
+    constexpr ArrayView(T* data, uint64 size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    template <uint64 N>
+    constexpr ArrayView(T (&array)[N])
+        : m_data(array)
+        , m_size(N)
+    {
+    }
+
+    template <typename Container>
+        requires Internal::ViewableContainer<Container, T>
+    constexpr ArrayView(Container& container)
+        : m_data(container.Data())
+        , m_size(container.Size())
+    {
+    }
+
+    // ArrayView<T> to ArrayView<const T>
+    template <typename U>
+        requires(!IsSame<U, T> && Internal::ViewElementCompatible<U, T>)
+    constexpr ArrayView(const ArrayView<U>& other)
+        : m_data(other.Data())
+        , m_size(other.Size())
+    {
+    }
+
+    constexpr T& operator[](uint64 index) const
+    {
+        rsblDebugAssert(index < m_size);
+        return m_data[index];
+    }
+
+    constexpr T* Data() const
+    {
+        return m_data;
+    }
+
+    constexpr uint64 Size() const
+    {
+        return m_size;
+    }
+
+    constexpr uint64 SizeInBytes() const
+    {
+        return m_size * sizeof(T);
+    }
+
+    constexpr bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    constexpr T& Front() const
+    {
+        rsblDebugAssert(m_size > 0);
+        return m_data[0];
+    }
+
+    constexpr T& Back() const
+    {
+        rsblDebugAssert(m_size > 0);
+        return m_data[m_size - 1];
+    }
+
+    // count elements starting at offset
+    constexpr ArrayView Subview(uint64 offset, uint64 count) const
+    {
+        rsblDebugAssert(offset <= m_size && count <= m_size - offset);
+        return ArrayView(m_data + offset, count);
+    }
+
+    // Everything from offset to the end
+    constexpr ArrayView Subview(uint64 offset) const
+    {
+        rsblDebugAssert(offset <= m_size);
+        return ArrayView(m_data + offset, m_size - offset);
+    }
+
+    constexpr ArrayView First(uint64 count) const
+    {
+        return Subview(0, count);
+    }
+
+    constexpr ArrayView Last(uint64 count) const
+    {
+        rsblDebugAssert(count <= m_size);
+        return Subview(m_size - count, count);
+    }
+
+    constexpr T* begin() const
+    {
+        return m_data;
+    }
+
+    constexpr T* end() const
+    {
+        return m_data + m_size;
+    }
+
+  private:
+    T* m_data = nullptr;
+    uint64 m_size = 0;
+};
+
+// Deduction guides, so ArrayView(container) picks up the element type
+template <typename T, uint64 N>
+ArrayView(T (&)[N]) -> ArrayView<T>;
+
+template <typename Container>
+ArrayView(Container&) -> ArrayView<Internal::ContainerElement<Container>>;
+
+// Raw memory views, for file IO and GPU uploads
+using ByteView = ArrayView<const uint8>;
+using MutableByteView = ArrayView<uint8>;
+
+inline ByteView AsBytes(const void* data, uint64 size)
+{
+    return ByteView(static_cast<const uint8*>(data), size);
+}
+
+inline MutableByteView AsWritableBytes(void* data, uint64 size)
+{
+    return MutableByteView(static_cast<uint8*>(data), size);
+}
+
+template <typename T>
+ByteView AsBytes(ArrayView<T> view)
+{
+    return AsBytes(view.Data(), view.SizeInBytes());
+}
+
+template <typename T>
+MutableByteView AsWritableBytes(ArrayView<T> view)
+{
+    return AsWritableBytes(view.Data(), view.SizeInBytes());
+}
+
+template <typename T>
+struct TriviallyRelocatable<ArrayView<T>>
+{
+    static constexpr bool value = true;
+};
+
+} // namespace rsbl
@@ -11,6 +11,20 @@
     #define RSBL_ASSERTS_ENABLED
 #endif
 
+// Slow asserts go with the rest, and can be dropped on their own for shipping builds, see
+// RSBL_ASSERTS in the top level CMakeLists
+#if defined(RSBL_ASSERTS_ENABLED) && !defined(RSBL_SLOW_ASSERTS_DISABLED)
+    #define RSBL_SLOW_ASSERTS_ENABLED
+#endif
+
+// Failure paths are kept out of line and away from the hot code, so a passing check costs the
+// compare and a not taken branch
+#if defined(_MSC_VER)
+    #define RSBL_COLD __declspec(noinline)
+#else
+    #define RSBL_COLD __attribute__((cold, noinline))
+#endif
+
 namespace rsbl
 {
 namespace Assert
@@ -37,16 +51,21 @@ namespace Assert
                                   const char* file,
                                   int line,
                                   const char* msg);
+
+    // What the macros call on failure, true to break. Condition and msg can be null.
+    RSBL_COLD bool Fail(const char* condition, const char* file, int line, const char* msg);
 } // namespace Assert
 } // namespace rsbl
 
 // great research on different break invocations from https://github.com/scottt/debugbreak
 #if defined(_MSC_VER)
     #define rsblDebugBreak() (__debugbreak())
+#elif defined(__x86_64__) || defined(__i386__)
+    #define rsblDebugBreak() __asm__ volatile("int3")
 #elif defined(__aarch64__)
-    #define rsblDebugBreak() (__asm__ volatile(".inst 0xd4200000"))
+    #define rsblDebugBreak() __asm__ volatile(".inst 0xd4200000")
 #elif defined(__arm__) && !defined(__thumb__)
-    #define rsblDebugBreak() (__asm__ volatile(".inst 0xe7f001f0"))
+    #define rsblDebugBreak() __asm__ volatile(".inst 0xe7f001f0")
 #else
 // TODO: support additional platforms
 static_assert(false, "Missing platform implementation for assert break");
@@ -68,28 +87,20 @@ static_assert(false, "Missing platform implementation for assert break");
 // Note: double paren around condition to avoid clang-tidy warning
 
 #if defined(RSBL_ASSERTS_ENABLED)
-    #define rsblAssert(condition) \
-        do \
-        { \
-            if (!((condition))) \
-            { \
-                if (rsbl::Assert::ReportFailure(#condition, __FILE__, __LINE__, nullptr) == \
-                    rsbl::Assert::FailureBehavior::Halt) \
-                    rsblDebugBreak(); \
-            } \
-        } while (0)
-
     #define rsblAssertMsg(condition, msg) \
         do \
         { \
-            if (!((condition))) \
+            if (!((condition))) [[unlikely]] \
             { \
-                if (rsbl::Assert::ReportFailure(#condition, __FILE__, __LINE__, (msg)) == \
-                    rsbl::Assert::FailureBehavior::Halt) \
+                if (rsbl::Assert::Fail(#condition, __FILE__, __LINE__, (msg))) \
                     rsblDebugBreak(); \
             } \
         } while (0)
 
+    #define rsblAssert(condition) rsblAssertMsg(condition, nullptr)
+
+    #define rsblVerifyMsg(condition, msg) rsblAssertMsg(condition, msg)
+
 #else // defined(RSBL_ASSERTS_ENABLED)
 
     #define rsblAssert(condition) \
@@ -105,4 +116,40 @@ static_assert(false, "Missing platform implementation for assert break");
             rsblUnused(msg); \
         } while (0)
 
+    #define rsblVerifyMsg(condition, msg) \
+        do \
+        { \
+            rsblUnused(msg); \
+            if (!((condition))) [[unlikely]] \
+            { \
+                if (rsbl::Assert::Fail(nullptr, __FILE__, __LINE__, nullptr)) \
+                    rsblDebugBreak(); \
+            } \
+        } while (0)
+
 #endif // defined(RSBL_ASSERTS_ENABLED)
+
+// Checked in every build, so the condition can have side effects. Without asserts the failure
+// is still reported, with the file and line but not the condition or message text.
+#define rsblVerify(condition) rsblVerifyMsg(condition, nullptr)
+
+// Asserts too expensive to leave in what ships, e.g. walking a whole container to check it
+#if defined(RSBL_SLOW_ASSERTS_ENABLED)
+    #define rsblAssertSlow(condition) rsblAssert(condition)
+    #define rsblAssertSlowMsg(condition, msg) rsblAssertMsg(condition, msg)
+#else
+    #define rsblAssertSlow(condition) rsblUnused(condition)
+    #define rsblAssertSlowMsg(condition, msg) \
+        do \
+        { \
+            rsblUnused(condition); \
+            rsblUnused(msg); \
+        } while (0)
+#endif
+
+// Asserts for hot paths (e.g. bounds checks in views), which are compiled out of release builds
+#if defined(RSBL_ASSERTS_ENABLED) && !defined(NDEBUG)
+    #define rsblDebugAssert(condition) rsblAssert(condition)
+#else
+    #define rsblDebugAssert(condition) rsblUnused(condition)
+#endif
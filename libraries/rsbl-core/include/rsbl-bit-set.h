@@ -0,0 +1,680 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-assert.h"
+#include "rsbl-bits.h"
+#include "rsbl-int-types.h"
+
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+    #define RSBL_BIT_SET_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define RSBL_BIT_SET_SSE2 0
+#endif
+
+// Packed bit sets, 64 bits to a word. BitSet<N> has a compile-time size and lives inline,
+// DynamicBitSet is heap allocated and resizable. Both support the same queries:
+// - Count/Any/All work a word at a time with popcount
+// - FindFirstSet/FindFirstClear skip empty (or full) runs 128 bits at a time with SSE2
+// - And/Or/AndNot combine whole sets 128 bits at a time
+// - SetBits() iterates the indices of the set bits, touching each word once
+// Bits past Size() in the last word are always kept clear, so whole-word operations never have to
+// mask them.
+
+namespace rsbl
+{
+namespace Internal
+{
+    constexpr uint64 kBitsPerWord = 64;
+
+    constexpr uint64 BitWordCount(uint64 bitCount)
+    {
+        return (bitCount + kBitsPerWord - 1) / kBitsPerWord;
+    }
+
+    // Mask of the bits of the last word that are inside the set
+    constexpr uint64 BitTailMask(uint64 bitCount)
+    {
+        const uint64 tail = bitCount % kBitsPerWord;
+        return tail == 0 ? ~uint64(0) : (uint64(1) << tail) - 1;
+    }
+
+    inline void BitWordsAnd(uint64* dst, const uint64* src, uint64 wordCount)
+    {
+        uint64 i = 0;
+#if RSBL_BIT_SET_SSE2
+        for (; i + 2 <= wordCount; i += 2)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_and_si128(a, b));
+        }
+#endif
+        for (; i < wordCount; ++i)
+        {
+            dst[i] &= src[i];
+        }
+    }
+
+    inline void BitWordsOr(uint64* dst, const uint64* src, uint64 wordCount)
+    {
+        uint64 i = 0;
+#if RSBL_BIT_SET_SSE2
+        for (; i + 2 <= wordCount; i += 2)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(a, b));
+        }
+#endif
+        for (; i < wordCount; ++i)
+        {
+            dst[i] |= src[i];
+        }
+    }
+
+    // dst = dst & ~src
+    inline void BitWordsAndNot(uint64* dst, const uint64* src, uint64 wordCount)
+    {
+        uint64 i = 0;
+#if RSBL_BIT_SET_SSE2
+        for (; i + 2 <= wordCount; i += 2)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_andnot_si128(b, a));
+        }
+#endif
+        for (; i < wordCount; ++i)
+        {
+            dst[i] &= ~src[i];
+        }
+    }
+
+    inline uint64 BitWordsCount(const uint64* words, uint64 wordCount)
+    {
+        uint64 count = 0;
+        for (uint64 i = 0; i < wordCount; ++i)
+        {
+            count += PopCount64(words[i]);
+        }
+        return count;
+    }
+
+    // Index of the first word at or after start that isn't equal to skip, or wordCount.
+    // skip is either zero or all ones, so a bytewise compare is enough.
+    inline uint64 BitWordsSkip(const uint64* words, uint64 wordCount, uint64 start, uint64 skip)
+    {
+        uint64 i = start;
+#if RSBL_BIT_SET_SSE2
+        const __m128i skipVec = _mm_set1_epi8(static_cast<char>(skip & 0xFF));
+        for (; i + 2 <= wordCount; i += 2)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, skipVec)) != 0xFFFF)
+            {
+                break;
+            }
+        }
+#endif
+        while (i < wordCount && words[i] == skip)
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    // First bit at or after start whose value is set (or clear, when invert is all ones).
+    // Returns bitCount if there isn't one.
+    inline uint64 BitWordsFind(const uint64* words, uint64 bitCount, uint64 start, uint64 invert)
+    {
+        if (start >= bitCount)
+        {
+            return bitCount;
+        }
+
+        const uint64 wordCount = BitWordCount(bitCount);
+        uint64 wordIndex = start / kBitsPerWord;
+        const uint64 first = (words[wordIndex] ^ invert) & (~uint64(0) << (start % kBitsPerWord));
+        if (first != 0)
+        {
+            const uint64 index = wordIndex * kBitsPerWord + CountTrailingZeros64(first);
+            return index < bitCount ? index : bitCount;
+        }
+
+        wordIndex = BitWordsSkip(words, wordCount, wordIndex + 1, invert);
+        if (wordIndex == wordCount)
+        {
+            return bitCount;
+        }
+
+        // The clear tail bits of the last word can look like a hit when searching for clear bits
+        const uint64 index =
+            wordIndex * kBitsPerWord + CountTrailingZeros64(words[wordIndex] ^ invert);
+        return index < bitCount ? index : bitCount;
+    }
+
+    // Sets or clears the bits in [first, first + count)
+    inline void BitWordsFill(uint64* words, uint64 first, uint64 count, bool value)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        const uint64 last = first + count - 1;
+        const uint64 firstWord = first / kBitsPerWord;
+        const uint64 lastWord = last / kBitsPerWord;
+        const uint64 firstMask = ~uint64(0) << (first % kBitsPerWord);
+        const uint64 lastMask = ~uint64(0) >> (kBitsPerWord - 1 - last % kBitsPerWord);
+
+        if (firstWord == lastWord)
+        {
+            const uint64 mask = firstMask & lastMask;
+            words[firstWord] = value ? (words[firstWord] | mask) : (words[firstWord] & ~mask);
+            return;
+        }
+
+        words[firstWord] = value ? (words[firstWord] | firstMask) : (words[firstWord] & ~firstMask);
+        if (lastWord > firstWord + 1)
+        {
+            memset(words + firstWord + 1, value ? 0xFF : 0x00,
+                   (lastWord - firstWord - 1) * sizeof(uint64));
+        }
+        words[lastWord] = value ? (words[lastWord] | lastMask) : (words[lastWord] & ~lastMask);
+    }
+
+    // Walks the indices of the set bits, one word at a time
+    class SetBitIterator
+    {
+      public:
+        SetBitIterator(const uint64* words, uint64 wordCount, uint64 wordIndex)
+            : m_words(words)
+            , m_wordCount(wordCount)
+            , m_wordIndex(wordIndex)
+        {
+            m_current = m_wordIndex < m_wordCount ? m_words[m_wordIndex] : 0;
+            SkipEmptyWords();
+        }
+
+        uint64 operator*() const
+        {
+            return m_wordIndex * kBitsPerWord + CountTrailingZeros64(m_current);
+        }
+
+        SetBitIterator& operator++()
+        {
+            m_current &= m_current - 1;
+            SkipEmptyWords();
+            return *this;
+        }
+
+        bool operator==(const SetBitIterator& other) const
+        {
+            return m_wordIndex == other.m_wordIndex && m_current == other.m_current;
+        }
+
+        bool operator!=(const SetBitIterator& other) const
+        {
+            return !(*this == other);
+        }
+
+      private:
+        void SkipEmptyWords()
+        {
+            if (m_current != 0 || m_wordIndex >= m_wordCount)
+            {
+                return;
+            }
+
+            // Dense sets are the common case here, so a plain loop beats the SSE2 skip
+            while (++m_wordIndex < m_wordCount)
+            {
+                m_current = m_words[m_wordIndex];
+                if (m_current != 0)
+                {
+                    return;
+                }
+            }
+        }
+
+        const uint64* m_words;
+        uint64 m_wordCount;
+        uint64 m_wordIndex;
+        uint64 m_current;
+    };
+
+    struct SetBitRange
+    {
+        const uint64* words;
+        uint64 wordCount;
+
+        SetBitIterator begin() const
+        {
+            return SetBitIterator(words, wordCount, 0);
+        }
+
+        SetBitIterator end() const
+        {
+            return SetBitIterator(words, wordCount, wordCount);
+        }
+    };
+
+    // Shared queries for BitSet and DynamicBitSet. Derived provides Size(), Words() and
+    // WordCount().
+    template <typename Derived>
+    class BitSetBase
+    {
+      public:
+        bool Test(uint64 index) const
+        {
+            rsblDebugAssert(index < Self().Size());
+            return (Self().Words()[index / kBitsPerWord] >> (index % kBitsPerWord)) & 1;
+        }
+
+        bool operator[](uint64 index) const
+        {
+            return Test(index);
+        }
+
+        void Set(uint64 index)
+        {
+            rsblDebugAssert(index < Self().Size());
+            Self().Words()[index / kBitsPerWord] |= uint64(1) << (index % kBitsPerWord);
+        }
+
+        void Set(uint64 index, bool value)
+        {
+            if (value)
+            {
+                Set(index);
+            }
+            else
+            {
+                Reset(index);
+            }
+        }
+
+        void Reset(uint64 index)
+        {
+            rsblDebugAssert(index < Self().Size());
+            Self().Words()[index / kBitsPerWord] &= ~(uint64(1) << (index % kBitsPerWord));
+        }
+
+        void Flip(uint64 index)
+        {
+            rsblDebugAssert(index < Self().Size());
+            Self().Words()[index / kBitsPerWord] ^= uint64(1) << (index % kBitsPerWord);
+        }
+
+        // Sets or clears the bits in [first, first + count)
+        void SetRange(uint64 first, uint64 count, bool value = true)
+        {
+            rsblDebugAssert(first <= Self().Size() && count <= Self().Size() - first);
+            BitWordsFill(Self().Words(), first, count, value);
+        }
+
+        void SetAll()
+        {
+            const uint64 wordCount = Self().WordCount();
+            if (wordCount > 0)
+            {
+                memset(Self().Words(), 0xFF, wordCount * sizeof(uint64));
+                Self().Words()[wordCount - 1] &= BitTailMask(Self().Size());
+            }
+        }
+
+        void ResetAll()
+        {
+            if (Self().WordCount() > 0)
+            {
+                memset(Self().Words(), 0, Self().WordCount() * sizeof(uint64));
+            }
+        }
+
+        // Number of set bits
+        uint64 Count() const
+        {
+            return BitWordsCount(Self().Words(), Self().WordCount());
+        }
+
+        bool Any() const
+        {
+            return BitWordsSkip(Self().Words(), Self().WordCount(), 0, 0) != Self().WordCount();
+        }
+
+        bool None() const
+        {
+            return !Any();
+        }
+
+        bool All() const
+        {
+            return FindFirstClear() == Self().Size();
+        }
+
+        // Index of the first set bit at or after start, or Size() if there isn't one
+        uint64 FindFirstSet(uint64 start = 0) const
+        {
+            return BitWordsFind(Self().Words(), Self().Size(), start, 0);
+        }
+
+        // Index of the first clear bit at or after start, or Size() if there isn't one
+        uint64 FindFirstClear(uint64 start = 0) const
+        {
+            return BitWordsFind(Self().Words(), Self().Size(), start, ~uint64(0));
+        }
+
+        // for (uint64 index : bits.SetBits())
+        SetBitRange SetBits() const
+        {
+            return SetBitRange{Self().Words(), Self().WordCount()};
+        }
+
+        // Bulk operations, both sets must be the same size
+        template <typename Other>
+        Derived& And(const BitSetBase<Other>& other)
+        {
+            rsblDebugAssert(Self().Size() == other.Self().Size());
+            BitWordsAnd(Self().Words(), other.Self().Words(), Self().WordCount());
+            return Self();
+        }
+
+        template <typename Other>
+        Derived& Or(const BitSetBase<Other>& other)
+        {
+            rsblDebugAssert(Self().Size() == other.Self().Size());
+            BitWordsOr(Self().Words(), other.Self().Words(), Self().WordCount());
+            return Self();
+        }
+
+        // Clears every bit that is set in other
+        template <typename Other>
+        Derived& AndNot(const BitSetBase<Other>& other)
+        {
+            rsblDebugAssert(Self().Size() == other.Self().Size());
+            BitWordsAndNot(Self().Words(), other.Self().Words(), Self().WordCount());
+            return Self();
+        }
+
+        template <typename Other>
+        Derived& operator&=(const BitSetBase<Other>& other)
+        {
+            return And(other);
+        }
+
+        template <typename Other>
+        Derived& operator|=(const BitSetBase<Other>& other)
+        {
+            return Or(other);
+        }
+
+        template <typename Other>
+        bool operator==(const BitSetBase<Other>& other) const
+        {
+            return Self().Size() == other.Self().Size() &&
+                   (Self().WordCount() == 0 ||
+                    memcmp(Self().Words(), other.Self().Words(),
+                           Self().WordCount() * sizeof(uint64)) == 0);
+        }
+
+      private:
+        template <typename>
+        friend class BitSetBase;
+
+        Derived& Self()
+        {
+            return static_cast<Derived&>(*this);
+        }
+
+        const Derived& Self() const
+        {
+            return static_cast<const Derived&>(*this);
+        }
+    };
+} // namespace Internal
+
+// Bit set with a compile-time size, stored inline
+template <uint64 N>
+class BitSet : public Internal::BitSetBase<BitSet<N>>
+{
+  public:
+    static constexpr uint64 kWordCount = Internal::BitWordCount(N);
+
+    // All bits clear
+    constexpr BitSet() = default;
+
+    constexpr uint64 Size() const
+    {
+        return N;
+    }
+
+    constexpr uint64 WordCount() const
+    {
+        return kWordCount;
+    }
+
+    uint64* Words()
+    {
+        return m_words;
+    }
+
+    const uint64* Words() const
+    {
+        return m_words;
+    }
+
+  private:
+    uint64 m_words[kWordCount > 0 ? kWordCount : 1] = {};
+};
+
+// Resizable bit set. New bits start clear unless Resize is told otherwise.
+class DynamicBitSet : public Internal::BitSetBase<DynamicBitSet>
+{
+  public:
+    DynamicBitSet() = default;
+
+    explicit DynamicBitSet(uint64 size, bool value = false)
+    {
+        Resize(size, value);
+    }
+
+    // Constructors with a custom allocator. The allocator must outlive the set.
+    explicit DynamicBitSet(Allocator* allocator)
+        : m_allocator(allocator)
+    {
+    }
+
+    DynamicBitSet(uint64 size, Allocator* allocator)
+        : m_allocator(allocator)
+    {
+        Resize(size);
+    }
+
+    ~DynamicBitSet()
+    {
+        FreeWords();
+    }
+
+    DynamicBitSet(const DynamicBitSet& other)
+        : m_allocator(other.m_allocator)
+    {
+        CopyFrom(other);
+    }
+
+    // Keeps our own allocator
+    DynamicBitSet& operator=(const DynamicBitSet& other)
+    {
+        if (this != &other)
+        {
+            m_size = 0;
+            CopyFrom(other);
+        }
+        return *this;
+    }
+
+    DynamicBitSet(DynamicBitSet&& other) noexcept
+        : m_words(other.m_words)
+        , m_size(other.m_size)
+        , m_wordCapacity(other.m_wordCapacity)
+        , m_allocator(other.m_allocator)
+    {
+        other.m_words = nullptr;
+        other.m_size = 0;
+        other.m_wordCapacity = 0;
+    }
+
+    // The words and their allocator come along together
+    DynamicBitSet& operator=(DynamicBitSet&& other) noexcept
+    {
+        if (this != &other)
+        {
+            FreeWords();
+
+            m_words = other.m_words;
+            m_size = other.m_size;
+            m_wordCapacity = other.m_wordCapacity;
+            m_allocator = other.m_allocator;
+
+            other.m_words = nullptr;
+            other.m_size = 0;
+            other.m_wordCapacity = 0;
+        }
+        return *this;
+    }
+
+    uint64 Size() const
+    {
+        return m_size;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    uint64 WordCount() const
+    {
+        return Internal::BitWordCount(m_size);
+    }
+
+    uint64* Words()
+    {
+        return m_words;
+    }
+
+    const uint64* Words() const
+    {
+        return m_words;
+    }
+
+    Allocator* GetAllocator() const
+    {
+        return m_allocator;
+    }
+
+    void Reserve(uint64 bitCapacity)
+    {
+        const uint64 wordCapacity = Internal::BitWordCount(bitCapacity);
+        if (wordCapacity > m_wordCapacity)
+        {
+            Grow(wordCapacity);
+        }
+    }
+
+    // New bits are set to value
+    void Resize(uint64 size, bool value = false)
+    {
+        const uint64 oldSize = m_size;
+        const uint64 oldWordCount = WordCount();
+        const uint64 newWordCount = Internal::BitWordCount(size);
+
+        if (newWordCount > m_wordCapacity)
+        {
+            // Growing one bit at a time shouldn't reallocate every word
+            const uint64 doubled = m_wordCapacity * 2;
+            Grow(newWordCount > doubled ? newWordCount : doubled);
+        }
+
+        if (newWordCount > oldWordCount)
+        {
+            memset(m_words + oldWordCount, 0, (newWordCount - oldWordCount) * sizeof(uint64));
+        }
+
+        m_size = size;
+        if (size > oldSize)
+        {
+            if (value)
+            {
+                Internal::BitWordsFill(m_words, oldSize, size - oldSize, true);
+            }
+        }
+        else if (newWordCount > 0)
+        {
+            m_words[newWordCount - 1] &= Internal::BitTailMask(size);
+        }
+    }
+
+    void PushBack(bool value)
+    {
+        Resize(m_size + 1);
+        if (value)
+        {
+            Set(m_size - 1);
+        }
+    }
+
+    // Keeps the allocation
+    void Clear()
+    {
+        m_size = 0;
+    }
+
+  private:
+    void Grow(uint64 wordCapacity)
+    {
+        if (m_words != nullptr)
+        {
+            m_words = static_cast<uint64*>(
+                m_allocator->Reallocate(m_words, m_wordCapacity * sizeof(uint64),
+                                        wordCapacity * sizeof(uint64), alignof(uint64)));
+        }
+        else
+        {
+            m_words = static_cast<uint64*>(
+                m_allocator->Allocate(wordCapacity * sizeof(uint64), alignof(uint64)));
+        }
+        m_wordCapacity = wordCapacity;
+    }
+
+    void FreeWords()
+    {
+        if (m_words != nullptr)
+        {
+            m_allocator->Free(m_words, m_wordCapacity * sizeof(uint64), alignof(uint64));
+            m_words = nullptr;
+            m_wordCapacity = 0;
+        }
+    }
+
+    void CopyFrom(const DynamicBitSet& other)
+    {
+        Resize(other.m_size);
+        if (other.WordCount() > 0)
+        {
+            memcpy(m_words, other.m_words, other.WordCount() * sizeof(uint64));
+        }
+    }
+
+    uint64* m_words = nullptr;
+    uint64 m_size = 0;
+    uint64 m_wordCapacity = 0;
+    Allocator* m_allocator = GetDefaultAllocator();
+};
+
+} // namespace rsbl
@@ -0,0 +1,80 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-int-types.h"
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+// Bit manipulation helpers that map to single instructions on the platforms we care about.
+// Zero inputs are not allowed for the count functions, same as the underlying intrinsics.
+
+namespace rsbl
+{
+
+inline uint32 CountTrailingZeros32(uint32 value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<uint32>(index);
+#else
+    return static_cast<uint32>(__builtin_ctz(value));
+#endif
+}
+
+inline uint32 CountTrailingZeros64(uint64 value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<uint32>(index);
+#else
+    return static_cast<uint32>(__builtin_ctzll(value));
+#endif
+}
+
+inline uint32 CountLeadingZeros64(uint64 value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - static_cast<uint32>(index);
+#else
+    return static_cast<uint32>(__builtin_clzll(value));
+#endif
+}
+
+inline uint32 PopCount64(uint64 value)
+{
+#if defined(_MSC_VER)
+    return static_cast<uint32>(__popcnt64(value));
+#else
+    return static_cast<uint32>(__builtin_popcountll(value));
+#endif
+}
+
+constexpr bool IsPowerOfTwo(uint64 value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+// Smallest power of two >= value (1 for 0)
+inline uint64 NextPowerOfTwo(uint64 value)
+{
+    if (value <= 1)
+    {
+        return 1;
+    }
+    return uint64(1) << (64 - CountLeadingZeros64(value - 1));
+}
+
+constexpr uint64 AlignUp(uint64 value, uint64 alignment)
+{
+    return (value + (alignment - 1)) & ~(alignment - 1);
+}
+
+} // namespace rsbl
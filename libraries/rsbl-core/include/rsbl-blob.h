@@ -0,0 +1,317 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-array-view.h"
+#include "rsbl-assert.h"
+#include "rsbl-dynamic-array.h"
+#include "rsbl-int-types.h"
+#include "rsbl-result.h"
+#include "rsbl-string.h"
+
+#include <cstring>
+
+// Binary blobs read in place: a file's bytes, mapped or loaded, are the structs the code uses,
+// with no parsing or unpacking. Structs in a blob point at each other with BlobPtr, BlobArray and
+// BlobString, which hold offsets from themselves rather than addresses, so they mean the same
+// wherever the blob lands.
+//
+//     struct MaterialTable
+//     {
+//         uint32 flags;
+//         BlobArray<MaterialEntry> entries;
+//         BlobString name;
+//     };
+//
+//     BlobWriter writer(kMaterialMagic, kMaterialVersion);
+//     const BlobRef<MaterialTable> root = writer.Add<MaterialTable>();
+//     const BlobRef<MaterialEntry> entries = writer.AddArray(ArrayView<const MaterialEntry>(...));
+//     const BlobRef<char> name = writer.AddString("sponza");
+//     MaterialTable* table = writer.Get(root);
+//     writer.Point(table->entries, entries);
+//     writer.Point(table->name, name);
+//     writer.SetRoot(root);
+//     ... WriteFile(file, writer.Finish()) ...
+//
+//     Result<const BlobHeader*> blob = OpenBlob(mapped.View(), kMaterialMagic, kMaterialVersion);
+//     const MaterialTable& table = blob.Value()->Root<MaterialTable>();
+//     for (const MaterialEntry& entry : table.entries) { ... }
+//
+// There's no schema: a struct's layout is the format, so anything stored can't change size
+// without a new version, as with the .rmesh sections. Everything is aligned for its type within
+// the blob, and the blob itself has to start on BlobHeader::alignment, which mapped files and
+// Finish's buffer always do.
+//
+// OpenBlob only checks the header, which is enough for files this build cooked. The writer also
+// lists every reference it set in a table at the end, and ValidateBlob checks all of them in one
+// pass over it, for blobs that might be truncated or corrupt. It can't know about offsets the
+// table doesn't list, so it isn't a defence against hand-crafted files. Offsets are 32 bits, so
+// blobs are up to 2 GB.
+
+namespace rsbl
+{
+
+// The most any type in a blob can be aligned to
+constexpr uint64 kBlobMaxAlignment = 64;
+
+// First thing in the blob
+struct BlobHeader
+{
+    uint32 magic;
+    uint32 version;
+    // Of the whole blob, the reference table included
+    uint64 size;
+    uint32 rootOffset;
+    uint32 referenceTableOffset;
+    uint32 referenceCount;
+    // The most anything in the blob is aligned to
+    uint32 alignment;
+
+    template <typename T>
+    const T& Root() const
+    {
+        return *reinterpret_cast<const T*>(reinterpret_cast<const uint8*>(this) + rootOffset);
+    }
+};
+
+static_assert(sizeof(BlobHeader) == 32, "BlobHeader is stored as is, it can't change size");
+
+enum class BlobReferenceKind : uint16
+{
+    Pointer,
+    Array,
+    // An array of chars with a terminator after the last
+    String,
+};
+
+// One entry of the reference table
+struct BlobReferenceRecord
+{
+    // Where the reference is
+    uint32 offset;
+    uint32 elementSize;
+    uint16 alignment;
+    BlobReferenceKind kind;
+};
+
+static_assert(sizeof(BlobReferenceRecord) == 12, "Stored as is, it can't change size");
+
+// A reference only means something where it is, so none of them can be copied out of the blob
+class BlobReferenceBase
+{
+  public:
+    BlobReferenceBase() = default;
+    BlobReferenceBase(const BlobReferenceBase&) = delete;
+    BlobReferenceBase& operator=(const BlobReferenceBase&) = delete;
+
+  protected:
+    const uint8* Target() const
+    {
+        return m_offset == 0 ? nullptr : reinterpret_cast<const uint8*>(this) + m_offset;
+    }
+
+  private:
+    friend class BlobWriter;
+
+    // From this reference's own address, 0 for none
+    int32 m_offset = 0;
+};
+
+template <typename T>
+class BlobPtr : public BlobReferenceBase
+{
+  public:
+    const T* Get() const
+    {
+        return reinterpret_cast<const T*>(Target());
+    }
+
+    const T* operator->() const
+    {
+        return Get();
+    }
+
+    const T& operator*() const
+    {
+        return *Get();
+    }
+
+    bool IsNull() const
+    {
+        return Get() == nullptr;
+    }
+};
+
+template <typename T>
+class BlobArray : public BlobReferenceBase
+{
+  public:
+    const T* Data() const
+    {
+        return reinterpret_cast<const T*>(Target());
+    }
+
+    uint64 Size() const
+    {
+        return m_count;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_count == 0;
+    }
+
+    const T& operator[](uint64 index) const
+    {
+        rsblDebugAssert(index < m_count);
+        return Data()[index];
+    }
+
+    ArrayView<const T> View() const
+    {
+        return ArrayView<const T>(Data(), m_count);
+    }
+
+    const T* begin() const
+    {
+        return Data();
+    }
+
+    const T* end() const
+    {
+        return Data() + m_count;
+    }
+
+  private:
+    friend class BlobWriter;
+
+    uint32 m_count = 0;
+};
+
+class BlobString : public BlobArray<char>
+{
+  public:
+    // "" for an empty one
+    const char* CStr() const
+    {
+        return Data() != nullptr ? Data() : "";
+    }
+
+    StringView View() const
+    {
+        return StringView(CStr(), Size());
+    }
+};
+
+// Where something is in a BlobWriter's blob, and how many of them. A pointer to it would move as
+// the blob grows.
+template <typename T>
+struct BlobRef
+{
+    uint32 offset = 0;
+    uint32 count = 0;
+};
+
+// Builds a blob in memory
+class BlobWriter
+{
+  public:
+    BlobWriter(uint32 magic, uint32 version, Allocator* allocator = GetDefaultAllocator());
+    ~BlobWriter();
+
+    BlobWriter(const BlobWriter&) = delete;
+    BlobWriter& operator=(const BlobWriter&) = delete;
+
+    // Zero filled room for count Ts, which is also what a null reference and an empty array are
+    template <typename T>
+    BlobRef<T> Add(uint32 count = 1)
+    {
+        static_assert(__has_trivial_destructor(T), "Nothing in a blob is ever destroyed");
+        static_assert(alignof(T) <= kBlobMaxAlignment, "Aligned past what a blob can hold");
+        return BlobRef<T>{Allocate(sizeof(T) * uint64(count), alignof(T)), count};
+    }
+
+    // A copy of values
+    template <typename T>
+    BlobRef<T> AddArray(ArrayView<const T> values)
+    {
+        static_assert(__is_trivially_copyable(T), "Values with references are made with Add");
+        const BlobRef<T> added = Add<T>(static_cast<uint32>(values.Size()));
+        if (!values.IsEmpty())
+        {
+            memcpy(Get(added), values.Data(), values.Size() * sizeof(T));
+        }
+        return added;
+    }
+
+    // A copy of text and a terminator, count being text's length
+    BlobRef<char> AddString(StringView text);
+
+    // Only valid until the next Add, which can move the blob
+    template <typename T>
+    T* Get(BlobRef<T> ref)
+    {
+        return reinterpret_cast<T*>(m_data + ref.offset);
+    }
+
+    // Each reference is one in this blob, from a Get since the last Add
+    template <typename T>
+    void Point(BlobPtr<T>& reference, BlobRef<T> target)
+    {
+        Link(reference, target.offset, BlobReferenceKind::Pointer, sizeof(T), alignof(T));
+    }
+
+    template <typename T>
+    void Point(BlobArray<T>& reference, BlobRef<T> target)
+    {
+        Link(reference, target.offset, BlobReferenceKind::Array, sizeof(T), alignof(T));
+        reference.m_count = target.count;
+    }
+
+    void Point(BlobString& reference, BlobRef<char> target)
+    {
+        Link(reference, target.offset, BlobReferenceKind::String, 1, 1);
+        static_cast<BlobArray<char>&>(reference).m_count = target.count;
+    }
+
+    template <typename T>
+    void SetRoot(BlobRef<T> root)
+    {
+        m_rootOffset = root.offset;
+    }
+
+    // Appends the reference table and fills in the header. The bytes are the writer's, and start
+    // on kBlobMaxAlignment so they can be read in place too. Nothing can be added after.
+    ByteView Finish();
+
+  private:
+    // Offset of size zeroed bytes aligned to alignment
+    uint32 Allocate(uint64 size, uint64 alignment);
+    void Link(BlobReferenceBase& reference,
+              uint32 target,
+              BlobReferenceKind kind,
+              uint32 elementSize,
+              uint32 alignment);
+
+    Allocator* m_allocator;
+    uint8* m_data = nullptr;
+    uint64 m_size = 0;
+    uint64 m_capacity = 0;
+    uint32 m_rootOffset = 0;
+    uint32 m_alignment = alignof(BlobHeader);
+    bool m_finished = false;
+    DynamicArray<BlobReferenceRecord> m_references;
+};
+
+// Checks the header: the magic and version, that the blob fits in bytes and starts aligned, and
+// that the root is inside it. InvalidArgument otherwise.
+Result<const BlobHeader*> OpenBlob(ByteView bytes, uint32 magic, uint32 version);
+
+// Checks every reference the writer set points inside the blob, at data aligned for it, and that
+// strings are terminated. For an already opened blob. InvalidArgument at the first one that
+// doesn't.
+Result<> ValidateBlob(const BlobHeader& blob);
+
+} // namespace rsbl
@@ -0,0 +1,123 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-array-view.h"
+#include "rsbl-bit-set.h"
+#include "rsbl-int-types.h"
+#include "rsbl-math-types.h"
+#include "rsbl-matrix.h"
+#include "rsbl-simd.h"
+
+// Bounding volumes and frustum culling. Aabb, Sphere, Plane and Frustum are storage types like
+// float3, the helpers load them into simd registers as needed.
+// The Cull* kernels take SoA bounds (one array per component, SoaArray columns work) and write
+// one visibility bit per object. They run the widest SIMD the CPU supports, so 4 to 16 objects
+// are tested per instruction. Tests are conservative: an object outside the frustum but close to
+// one of its corners can still be reported visible, nothing visible is ever reported culled.
+
+namespace rsbl
+{
+
+struct Aabb
+{
+    float3 min;
+    float3 max;
+};
+
+struct Sphere
+{
+    float3 center;
+    float radius;
+};
+
+// Points p with Dot(normal, p) + distance >= 0 are inside
+struct Plane
+{
+    float3 normal;
+    float distance;
+};
+
+// Depth range of clip space, which decides where the near plane is
+enum class ClipDepth : uint8
+{
+    ZeroToOne,     // D3D12, Vulkan
+    MinusOneToOne, // OpenGL
+};
+
+struct Frustum
+{
+    enum PlaneIndex : uint32
+    {
+        kLeft,
+        kRight,
+        kBottom,
+        kTop,
+        kNear,
+        kFar,
+
+        kPlaneCount,
+    };
+
+    // Normals point inwards and are unit length
+    Plane planes[kPlaneCount];
+};
+
+// Aabb
+
+// Box with min > max, which Merge treats as nothing
+Aabb EmptyAabb();
+
+// An empty array gives EmptyAabb()
+Aabb AabbFromPoints(ArrayView<const float3> points);
+
+constexpr Aabb Merge(const Aabb& a, const Aabb& b)
+{
+    return Aabb{simd::ToFloat3(simd::Min(simd::Load(a.min), simd::Load(b.min))),
+                simd::ToFloat3(simd::Max(simd::Load(a.max), simd::Load(b.max)))};
+}
+
+constexpr float3 Center(const Aabb& box)
+{
+    return simd::ToFloat3((simd::Load(box.min) + simd::Load(box.max)) * 0.5f);
+}
+
+// Half the size on each axis
+constexpr float3 Extents(const Aabb& box)
+{
+    return simd::ToFloat3((simd::Load(box.max) - simd::Load(box.min)) * 0.5f);
+}
+
+// Box around the transformed box, so it grows under rotation
+Aabb TransformAabb(const Aabb& box, const simd::float4x4& m);
+
+// Sphere through the corners of the box
+Sphere SphereFromAabb(const Aabb& box);
+
+// Frustum
+
+// Planes of the clip volume of a view-projection matrix (Gribb and Hartmann), in the space the
+// matrix transforms from: world space for view * projection, object space for a full MVP.
+// A plane at infinity (infinite far plane, either Z direction) comes out as one that accepts
+// everything.
+Frustum FrustumFromViewProjection(const simd::float4x4& viewProjection,
+                                  ClipDepth depth = ClipDepth::ZeroToOne);
+
+bool Intersects(const Frustum& frustum, const Sphere& sphere);
+bool Intersects(const Frustum& frustum, const Aabb& box);
+
+// Batched culling. Every input array must be the same size, visible is resized to match and bit i
+// is set when object i may be visible.
+
+void CullSpheres(const Frustum& frustum, ArrayView<const float> centerXs,
+                 ArrayView<const float> centerYs, ArrayView<const float> centerZs,
+                 ArrayView<const float> radii, DynamicBitSet& visible);
+
+// Boxes as center and extents (half sizes), which is what a plane test wants
+void CullAabbs(const Frustum& frustum, ArrayView<const float> centerXs,
+               ArrayView<const float> centerYs, ArrayView<const float> centerZs,
+               ArrayView<const float> extentXs, ArrayView<const float> extentYs,
+               ArrayView<const float> extentZs, DynamicBitSet& visible);
+
+} // namespace rsbl
@@ -0,0 +1,56 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-array-view.h"
+#include "rsbl-int-types.h"
+#include "rsbl-result.h"
+
+// LZ4 block compression, the raw block format without the frame around it, so anything that
+// speaks LZ4 can read what this writes. Decompression runs at several GB/s on one core and
+// never reads or writes outside the buffers it's given, whatever the input. Blocks are
+// independent, so splitting data into blocks lets them decompress on as many threads as there
+// are blocks.
+
+namespace rsbl
+{
+
+enum class CompressionLevel : uint8
+{
+    // Greedy single probe matching, for data written often or at load time
+    Fast,
+    // Searches a chain of earlier matches for the longest, several times slower to compress for
+    // a noticeably smaller output, and exactly as fast to decompress. For cooked data.
+    High,
+};
+
+// Biggest compressed size of size bytes, what Lz4Compress needs room for
+constexpr uint64 Lz4CompressBound(uint64 size)
+{
+    return size + size / 255 + 16;
+}
+
+// Compresses src into dst, which holds at least Lz4CompressBound(src.Size()) bytes. Returns the
+// compressed size, which can be bigger than src for incompressible data. Inputs are limited to
+// 2 GB, use blocks for anything bigger.
+uint64 Lz4Compress(ByteView src,
+                   MutableByteView dst,
+                   CompressionLevel level = CompressionLevel::Fast);
+
+// Decompresses one block into dst, returns the decompressed size. InvalidArgument for a
+// malformed block or one that doesn't fit in dst.
+Result<uint64> Lz4Decompress(ByteView src, MutableByteView dst);
+
+// Deflate (RFC 1951) decoding, for the formats that arrive deflated: PNG image data and the zlib
+// streams (RFC 1950) around it. Like Lz4Decompress it never reads or writes outside the buffers
+// it's given, and callers know the decompressed size up front.
+
+// Decompresses a raw deflate stream into dst, returns the decompressed size. InvalidArgument for
+// a malformed stream or one that doesn't fit in dst.
+Result<uint64> InflateDecompress(ByteView src, MutableByteView dst);
+
+// The same for a zlib stream, checking its header and Adler-32 checksum
+Result<uint64> ZlibDecompress(ByteView src, MutableByteView dst);
+
+} // namespace rsbl
@@ -0,0 +1,613 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-assert.h"
+#include "rsbl-bits.h"
+#include "rsbl-core.h"
+#include "rsbl-int-types.h"
+
+#include <atomic>
+#include <new>
+
+// Bounded lock-free queues for handing work between threads. All of them round the capacity up to
+// a power of two so an index maps to a slot with a mask, and keep the producer and consumer
+// indices on separate cache lines so the two sides don't false-share.
+
+namespace rsbl
+{
+
+// Destructive interference size. std::hardware_destructive_interference_size isn't reliably
+// there (and warns on gcc), and 64 is right for every target we care about.
+constexpr uint64 kCacheLineSize = 64;
+
+// Single producer, single consumer ring. Exactly one thread may push and exactly one thread may
+// pop, e.g. the render thread feeding a dedicated upload thread. Each side caches the other's
+// index, so in the common case a push or pop touches no shared cache line besides the slot.
+template <typename T>
+class SpscRing
+{
+  public:
+    // The allocator must outlive the ring
+    explicit SpscRing(uint64 capacity, Allocator* allocator = GetDefaultAllocator())
+        : m_allocator(allocator)
+    {
+        rsblAssert(capacity > 0);
+        m_capacity = NextPowerOfTwo(capacity);
+        m_mask = m_capacity - 1;
+        m_slots = static_cast<T*>(m_allocator->Allocate(m_capacity * sizeof(T), SlotAlignment()));
+        rsblVerifyMsg(m_slots != nullptr, "Failed to allocate SpscRing storage");
+    }
+
+    ~SpscRing()
+    {
+        const uint64 tail = m_tail.load(std::memory_order_relaxed);
+        for (uint64 i = m_head.load(std::memory_order_relaxed); i != tail; ++i)
+        {
+            m_slots[i & m_mask].~T();
+        }
+        m_allocator->Free(m_slots, m_capacity * sizeof(T), SlotAlignment());
+    }
+
+    // Threads hold on to the ring, it can't move
+    SpscRing(SpscRing&&) = delete;
+    SpscRing& operator=(SpscRing&&) = delete;
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer only. Returns false if the ring is full.
+    template <typename... Args>
+    bool TryEmplace(Args&&... args)
+    {
+        const uint64 tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == m_capacity)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == m_capacity)
+            {
+                return false;
+            }
+        }
+
+        new (&m_slots[tail & m_mask]) T(rsblForward(args)...);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T& value)
+    {
+        return TryEmplace(value);
+    }
+
+    bool TryPush(T&& value)
+    {
+        return TryEmplace(rsblMove(value));
+    }
+
+    // Producer only. Moves as many of values as fit, and returns how many were pushed. The whole
+    // batch is published with a single store.
+    uint64 TryPushBatch(T* values, uint64 count)
+    {
+        const uint64 tail = m_tail.load(std::memory_order_relaxed);
+        uint64 free_slots = m_capacity - (tail - m_cachedHead);
+        if (free_slots < count)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            free_slots = m_capacity - (tail - m_cachedHead);
+        }
+
+        const uint64 pushed = count < free_slots ? count : free_slots;
+        for (uint64 i = 0; i < pushed; ++i)
+        {
+            new (&m_slots[(tail + i) & m_mask]) T(rsblMove(values[i]));
+        }
+        if (pushed > 0)
+        {
+            m_tail.store(tail + pushed, std::memory_order_release);
+        }
+        return pushed;
+    }
+
+    // Consumer only. Returns false if the ring is empty.
+    bool TryPop(T& out)
+    {
+        const uint64 head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+            {
+                return false;
+            }
+        }
+
+        T& slot = m_slots[head & m_mask];
+        out = rsblMove(slot);
+        slot.~T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Moves up to max_count values into out, and returns how many were popped.
+    uint64 TryPopBatch(T* out, uint64 max_count)
+    {
+        const uint64 head = m_head.load(std::memory_order_relaxed);
+        uint64 available = m_cachedTail - head;
+        if (available < max_count)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            available = m_cachedTail - head;
+        }
+
+        const uint64 popped = max_count < available ? max_count : available;
+        for (uint64 i = 0; i < popped; ++i)
+        {
+            T& slot = m_slots[(head + i) & m_mask];
+            out[i] = rsblMove(slot);
+            slot.~T();
+        }
+        if (popped > 0)
+        {
+            m_head.store(head + popped, std::memory_order_release);
+        }
+        return popped;
+    }
+
+    // Only a snapshot when the other side is running
+    uint64 SizeApprox() const
+    {
+        const uint64 tail = m_tail.load(std::memory_order_acquire);
+        const uint64 head = m_head.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool IsEmptyApprox() const
+    {
+        return SizeApprox() == 0;
+    }
+
+    uint64 Capacity() const
+    {
+        return m_capacity;
+    }
+
+  private:
+    static constexpr uint64 SlotAlignment()
+    {
+        return alignof(T) > kCacheLineSize ? alignof(T) : kCacheLineSize;
+    }
+
+    // Written by the consumer
+    alignas(kCacheLineSize) std::atomic<uint64> m_head{0};
+    uint64 m_cachedTail = 0;
+
+    // Written by the producer
+    alignas(kCacheLineSize) std::atomic<uint64> m_tail{0};
+    uint64 m_cachedHead = 0;
+
+    // Read-only after construction
+    alignas(kCacheLineSize) T* m_slots = nullptr;
+    uint64 m_capacity = 0;
+    uint64 m_mask = 0;
+    Allocator* m_allocator = nullptr;
+};
+
+// Multi producer, multi consumer queue (Dmitry Vyukov's bounded queue). Any thread can push or
+// pop. Each slot carries a sequence number saying whose turn it is, so producers and consumers
+// only contend on their own index, never on a lock.
+template <typename T>
+class MpmcQueue
+{
+  public:
+    // The allocator must outlive the queue
+    explicit MpmcQueue(uint64 capacity, Allocator* allocator = GetDefaultAllocator())
+        : m_allocator(allocator)
+    {
+        rsblAssert(capacity > 0);
+        m_capacity = NextPowerOfTwo(capacity);
+        m_mask = m_capacity - 1;
+        m_cells =
+            static_cast<Cell*>(m_allocator->Allocate(m_capacity * sizeof(Cell), CellAlignment()));
+        rsblVerifyMsg(m_cells != nullptr, "Failed to allocate MpmcQueue storage");
+
+        for (uint64 i = 0; i < m_capacity; ++i)
+        {
+            new (&m_cells[i].sequence) std::atomic<uint64>(i);
+        }
+    }
+
+    ~MpmcQueue()
+    {
+        // No other threads by now, so whatever is between the indices is still live
+        const uint64 enqueue = m_enqueuePos.load(std::memory_order_relaxed);
+        for (uint64 i = m_dequeuePos.load(std::memory_order_relaxed); i != enqueue; ++i)
+        {
+            m_cells[i & m_mask].Data()->~T();
+        }
+        for (uint64 i = 0; i < m_capacity; ++i)
+        {
+            m_cells[i].sequence.~atomic();
+        }
+        m_allocator->Free(m_cells, m_capacity * sizeof(Cell), CellAlignment());
+    }
+
+    // Threads hold on to the queue, it can't move
+    MpmcQueue(MpmcQueue&&) = delete;
+    MpmcQueue& operator=(MpmcQueue&&) = delete;
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    // Returns false if the queue is full
+    template <typename... Args>
+    bool TryEmplace(Args&&... args)
+    {
+        uint64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            const uint64 sequence = cell->sequence.load(std::memory_order_acquire);
+            const int64 diff = static_cast<int64>(sequence) - static_cast<int64>(pos);
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // The slot still holds a value from the last lap
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->Data()) T(rsblForward(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool TryPush(const T& value)
+    {
+        return TryEmplace(value);
+    }
+
+    bool TryPush(T&& value)
+    {
+        return TryEmplace(rsblMove(value));
+    }
+
+    // Claims a run of free slots with one CAS, then moves values into them. Returns how many were
+    // pushed, which can be less than count when the queue is (nearly) full.
+    uint64 TryPushBatch(T* values, uint64 count)
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        uint64 pos = m_enqueuePos.load(std::memory_order_relaxed);
+        uint64 claimed = 0;
+        for (;;)
+        {
+            // Consumers can free slots out of order, so only the run of free slots right at pos
+            // can be claimed
+            claimed = 0;
+            while (claimed < count &&
+                   m_cells[(pos + claimed) & m_mask].sequence.load(std::memory_order_acquire) ==
+                       pos + claimed)
+            {
+                ++claimed;
+            }
+
+            if (claimed == 0)
+            {
+                const uint64 sequence = m_cells[pos & m_mask].sequence.load(
+                    std::memory_order_acquire);
+                if (static_cast<int64>(sequence) - static_cast<int64>(pos) < 0)
+                {
+                    return 0;
+                }
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        for (uint64 i = 0; i < claimed; ++i)
+        {
+            Cell& cell = m_cells[(pos + i) & m_mask];
+            new (cell.Data()) T(rsblMove(values[i]));
+            cell.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return claimed;
+    }
+
+    // Returns false if the queue is empty
+    bool TryPop(T& out)
+    {
+        uint64 pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            const uint64 sequence = cell->sequence.load(std::memory_order_acquire);
+            const int64 diff = static_cast<int64>(sequence) - static_cast<int64>(pos + 1);
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // Nothing has been published in this slot yet
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* value = cell->Data();
+        out = rsblMove(*value);
+        value->~T();
+        cell->sequence.store(pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Claims a run of published slots with one CAS, then moves them into out. Returns how many
+    // were popped.
+    uint64 TryPopBatch(T* out, uint64 max_count)
+    {
+        if (max_count == 0)
+        {
+            return 0;
+        }
+
+        uint64 pos = m_dequeuePos.load(std::memory_order_relaxed);
+        uint64 claimed = 0;
+        for (;;)
+        {
+            // Producers publish out of order too, stop at the first gap
+            claimed = 0;
+            while (claimed < max_count &&
+                   m_cells[(pos + claimed) & m_mask].sequence.load(std::memory_order_acquire) ==
+                       pos + claimed + 1)
+            {
+                ++claimed;
+            }
+
+            if (claimed == 0)
+            {
+                const uint64 sequence = m_cells[pos & m_mask].sequence.load(
+                    std::memory_order_acquire);
+                if (static_cast<int64>(sequence) - static_cast<int64>(pos + 1) < 0)
+                {
+                    return 0;
+                }
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        for (uint64 i = 0; i < claimed; ++i)
+        {
+            Cell& cell = m_cells[(pos + i) & m_mask];
+            T* value = cell.Data();
+            out[i] = rsblMove(*value);
+            value->~T();
+            cell.sequence.store(pos + i + m_capacity, std::memory_order_release);
+        }
+        return claimed;
+    }
+
+    // Only a snapshot, other threads can be pushing and popping
+    uint64 SizeApprox() const
+    {
+        const uint64 enqueue = m_enqueuePos.load(std::memory_order_acquire);
+        const uint64 dequeue = m_dequeuePos.load(std::memory_order_acquire);
+        return enqueue > dequeue ? enqueue - dequeue : 0;
+    }
+
+    bool IsEmptyApprox() const
+    {
+        return SizeApprox() == 0;
+    }
+
+    uint64 Capacity() const
+    {
+        return m_capacity;
+    }
+
+  private:
+    struct Cell
+    {
+        std::atomic<uint64> sequence;
+        alignas(T) uint8 storage[sizeof(T)];
+
+        T* Data()
+        {
+            return reinterpret_cast<T*>(storage);
+        }
+    };
+
+    static constexpr uint64 CellAlignment()
+    {
+        return alignof(Cell) > kCacheLineSize ? alignof(Cell) : kCacheLineSize;
+    }
+
+    alignas(kCacheLineSize) std::atomic<uint64> m_enqueuePos{0};
+    alignas(kCacheLineSize) std::atomic<uint64> m_dequeuePos{0};
+
+    // Read-only after construction
+    alignas(kCacheLineSize) Cell* m_cells = nullptr;
+    uint64 m_capacity = 0;
+    uint64 m_mask = 0;
+    Allocator* m_allocator = nullptr;
+};
+
+// Work-stealing deque (Chase-Lev, with the memory orderings from Le et al. 2013). One owner thread
+// pushes and pops at the bottom, LIFO, so it keeps working on what's hot in its cache. Any other
+// thread can steal from the top, FIFO, which hands out the oldest and usually biggest pieces of
+// work. The owner only touches a shared cache line when the deque is down to its last item.
+// Values are copied in and out of atomic slots, so T has to be trivially copyable (a pointer to
+// the work, typically).
+template <typename T>
+class WorkStealingDeque
+{
+  public:
+    // The allocator must outlive the deque
+    explicit WorkStealingDeque(uint64 capacity, Allocator* allocator = GetDefaultAllocator())
+        : m_allocator(allocator)
+    {
+        rsblAssert(capacity > 0);
+        m_capacity = NextPowerOfTwo(capacity);
+        m_mask = m_capacity - 1;
+        m_slots = static_cast<Slot*>(
+            m_allocator->Allocate(m_capacity * sizeof(Slot), alignof(Slot)));
+        rsblVerifyMsg(m_slots != nullptr, "Failed to allocate WorkStealingDeque storage");
+
+        for (uint64 i = 0; i < m_capacity; ++i)
+        {
+            new (&m_slots[i]) Slot();
+        }
+    }
+
+    ~WorkStealingDeque()
+    {
+        for (uint64 i = 0; i < m_capacity; ++i)
+        {
+            m_slots[i].~Slot();
+        }
+        m_allocator->Free(m_slots, m_capacity * sizeof(Slot), alignof(Slot));
+    }
+
+    // Threads hold on to the deque, it can't move
+    WorkStealingDeque(WorkStealingDeque&&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only. Returns false if the deque is full.
+    bool TryPush(T value)
+    {
+        const int64 bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64 top = m_top.load(std::memory_order_acquire);
+        if (bottom - top >= static_cast<int64>(m_capacity))
+        {
+            return false;
+        }
+
+        m_slots[bottom & m_mask].store(value, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only. Takes the most recently pushed value, returns false if the deque is empty or a
+    // thief got the last value first.
+    bool TryPop(T& out)
+    {
+        const int64 bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        // The bottom has to be published before the top is read, or the owner and a thief could
+        // both take the last value
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const T value = m_slots[bottom & m_mask].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // Last one, race the thieves for it
+            const bool won = m_top.compare_exchange_strong(
+                top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            if (!won)
+            {
+                return false;
+            }
+        }
+
+        out = value;
+        return true;
+    }
+
+    // Any thread. Takes the oldest value, returns false if the deque is empty or another thread
+    // took it first.
+    bool TrySteal(T& out)
+    {
+        int64 top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64 bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+        {
+            return false;
+        }
+
+        const T value = m_slots[top & m_mask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(
+                top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        out = value;
+        return true;
+    }
+
+    // Only a snapshot, other threads can be stealing
+    uint64 SizeApprox() const
+    {
+        const int64 bottom = m_bottom.load(std::memory_order_acquire);
+        const int64 top = m_top.load(std::memory_order_acquire);
+        return bottom > top ? static_cast<uint64>(bottom - top) : 0;
+    }
+
+    bool IsEmptyApprox() const
+    {
+        return SizeApprox() == 0;
+    }
+
+    uint64 Capacity() const
+    {
+        return m_capacity;
+    }
+
+  private:
+    using Slot = std::atomic<T>;
+
+    // Signed, so the owner's speculative decrement in TryPop can go below the top
+    alignas(kCacheLineSize) std::atomic<int64> m_top{0};
+    alignas(kCacheLineSize) std::atomic<int64> m_bottom{0};
+
+    // Read-only after construction
+    alignas(kCacheLineSize) Slot* m_slots = nullptr;
+    uint64 m_capacity = 0;
+    uint64 m_mask = 0;
+    Allocator* m_allocator = nullptr;
+};
+
+} // namespace rsbl
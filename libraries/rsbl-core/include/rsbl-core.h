@@ -56,6 +56,33 @@ namespace Internal
     {
         using type = typename RemoveCV<typename RemoveReference<T>::type>::type;
     };
+
+    template <class T>
+    struct RemovePointer
+    {
+        using type = T;
+    };
+    template <class T>
+    struct RemovePointer<T*>
+    {
+        using type = T;
+    };
+    template <class T>
+    struct RemovePointer<T* const>
+    {
+        using type = T;
+    };
+
+    template <class T, class U>
+    struct IsSame
+    {
+        static constexpr bool value = false;
+    };
+    template <class T>
+    struct IsSame<T, T>
+    {
+        static constexpr bool value = true;
+    };
 } // namespace Internal
 
 // Basically the same as std::remove_reference except we use the Internal namespace to demarcate
@@ -75,6 +102,12 @@ using RemoveCV = typename Internal::RemoveCV<T>::type;
 template <class T>
 using Decay = typename Internal::Decay<T>::type;
 
+template <class T>
+using RemovePointer = typename Internal::RemovePointer<T>::type;
+
+template <class T, class U>
+constexpr bool IsSame = Internal::IsSame<T, U>::value;
+
 } // namespace rsbl
 
 // Borrowed from and justified by  https://www.foonathan.net/2020/09/move-forward/
@@ -161,4 +194,31 @@ struct UnwrapReference<ReferenceWrapper<T>>
 template <typename T>
 using UnwrapReferenceType = typename UnwrapReference<T>::type;
 
+// Trivially relocatable types can be moved to a new address with memcpy, without running the
+// move constructor on the destination or the destructor on the source. Containers use this to
+// grow with realloc. Trivially copyable types are detected automatically, and other types can opt
+// in by specializing TriviallyRelocatable (or with rsblDeclareTriviallyRelocatable). A type
+// qualifies when it doesn't hold pointers into itself, and doesn't register its address anywhere.
+template <typename T>
+struct TriviallyRelocatable
+{
+    static constexpr bool value = __is_trivially_copyable(T);
+};
+
+template <typename T>
+constexpr bool IsTriviallyRelocatable = TriviallyRelocatable<RemoveCV<T>>::value;
+
+// Types that can be value-initialized by zero filling memory
+template <typename T>
+constexpr bool IsTriviallyZeroConstructible =
+    __is_trivially_constructible(T) && __is_trivially_copyable(T);
+
 } // namespace rsbl
+
+// Must be used at global scope
+#define rsblDeclareTriviallyRelocatable(Type) \
+    template <> \
+    struct rsbl::TriviallyRelocatable<Type> \
+    { \
+        static constexpr bool value = true; \
+    }
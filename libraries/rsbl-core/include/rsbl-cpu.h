@@ -0,0 +1,99 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-int-types.h"
+
+// CPU feature detection, for picking between kernels built for different instruction sets. The
+// features are queried once (cpuid on x64, the OS on ARM64) and cached. The AVX flags also check
+// that the OS saves the wider registers, so a set flag means the instructions are safe to run.
+//
+// To ship one binary that uses what each machine has, build a function once per SimdLevel (in
+// files compiled with that level's flags) and pick with SelectSimdVariant on first use:
+//
+//   using HashFunction = uint64 (*)(const void* data, uint64 size);
+//   uint64 HashScalar(const void* data, uint64 size);
+//   HashFunction GetHashAvx2(); // From a file built with AVX2 flags, null off x64
+//
+//   static const HashFunction s_hash = SelectSimdVariant<HashFunction>({
+//       {SimdLevel::Avx2, GetHashAvx2()},
+//       {SimdLevel::Scalar, &HashScalar},
+//   });
+
+namespace rsbl
+{
+
+struct CpuFeatures
+{
+    bool sse41 = false;
+    bool sse42 = false;
+    bool popcnt = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool f16c = false;
+    bool bmi1 = false;
+    bool bmi2 = false;
+    // AMD before Zen 3 runs pdep/pext in microcode, hundreds of cycles for dense masks. Code
+    // that leans on them should take a software path when this is set.
+    bool slowPdep = false;
+    bool avx512f = false;
+    bool avx512dq = false;
+    bool avx512bw = false;
+    bool avx512vl = false;
+    bool neon = false;
+    // ARMv8.2 sdot/udot, 4-way int8 dot products
+    bool neonDotProd = false;
+};
+
+const CpuFeatures& GetCpuFeatures();
+
+// Instruction set tiers that wide kernels get built for, narrowest first
+enum class SimdLevel : uint8
+{
+    Scalar,
+    Sse2,
+    Neon,
+    Avx2, // Includes FMA, F16C and BMI2
+    Avx512,
+
+    Count,
+};
+
+const char* SimdLevelName(SimdLevel level);
+
+bool IsSimdLevelSupported(SimdLevel level);
+
+// Widest level this CPU can run, whether or not kernels were built for it
+SimdLevel GetBestSimdLevel();
+
+// One build of a function for a SimdLevel. function may be null, for variants whose instruction
+// set isn't compiled for this target.
+template <typename F>
+struct SimdVariant
+{
+    SimdLevel level;
+    F function;
+};
+
+// The non-null variant with the widest level this CPU supports, in any order. Include a Scalar
+// (or Sse2/Neon baseline) variant so there's always one to pick; null when none qualifies.
+template <typename F, uint64 Count>
+F SelectSimdVariant(const SimdVariant<F> (&variants)[Count])
+{
+    F best = nullptr;
+    SimdLevel bestLevel = SimdLevel::Scalar;
+    for (const SimdVariant<F>& variant : variants)
+    {
+        if (variant.function != nullptr && IsSimdLevelSupported(variant.level) &&
+            (best == nullptr || variant.level > bestLevel))
+        {
+            best = variant.function;
+            bestLevel = variant.level;
+        }
+    }
+    return best;
+}
+
+} // namespace rsbl
@@ -3,19 +3,22 @@
 
 #pragma once
 
+#include "rsbl-allocator.h"
 #include "rsbl-core.h"
 #include "rsbl-int-types.h"
 
-#include <cstdlib>
 #include <cstring>
+#include <new>
 
 namespace rsbl
 {
 
 // Simple dynamic array similar to std::vector but with simpler interface
-// no allocator support, no emplace, no insert/erase at arbitrary positions
-
-// TODO: support emplace
+// no insert/erase at arbitrary positions
+// Memory comes from an rsbl::Allocator (global heap by default), so transient arrays can live in
+// a LinearArena/FrameArena. Copies share the source array's allocator.
+// Trivially relocatable element types (see rsbl-core.h) grow with Reallocate instead of
+// per-element move + destroy, and trivially copyable types are copied with memcpy.
 
 template <typename T>
 class DynamicArray
@@ -24,6 +27,39 @@ class DynamicArray
     T* m_data = nullptr;
     uint64 m_size = 0;
     uint64 m_capacity = 0;
+    Allocator* m_allocator = GetDefaultAllocator();
+
+    // Copy-construct count elements from src into our (uninitialized) buffer, starting at dst
+    void CopyElements(const T* src, uint64 count, uint64 dst = 0)
+    {
+        if constexpr (__is_trivially_copyable(T))
+        {
+            if (count > 0)
+            {
+                memcpy(static_cast<void*>(m_data + dst), src, count * sizeof(T));
+            }
+        }
+        else
+        {
+            for (uint64 i = 0; i < count; ++i)
+            {
+                new (&m_data[dst + i]) T(src[i]);
+            }
+        }
+    }
+
+    T* AllocateBuffer(uint64 capacity)
+    {
+        return static_cast<T*>(m_allocator->Allocate(capacity * sizeof(T), alignof(T)));
+    }
+
+    void FreeBuffer()
+    {
+        if (m_data != nullptr)
+        {
+            m_allocator->Free(m_data, m_capacity * sizeof(T), alignof(T));
+        }
+    }
 
     void Grow(uint64 minCapacity)
     {
@@ -33,20 +69,30 @@ class DynamicArray
             newCapacity *= 2;
         }
 
-        T* newData = static_cast<T*>(malloc(newCapacity * sizeof(T)));
-
-        // Move existing elements to new buffer
-        if (m_data != nullptr)
+        if constexpr (IsTriviallyRelocatable<T>)
+        {
+            // One realloc/memcpy for the whole buffer, no per-element moves
+            m_data = static_cast<T*>(m_allocator->Reallocate(
+                m_data, m_capacity * sizeof(T), newCapacity * sizeof(T), alignof(T)));
+        }
+        else
         {
-            for (uint64 i = 0; i < m_size; ++i)
+            T* newData = AllocateBuffer(newCapacity);
+
+            // Move existing elements to new buffer
+            if (m_data != nullptr)
             {
-                new (&newData[i]) T(rsblMove(m_data[i]));
-                m_data[i].~T();
+                for (uint64 i = 0; i < m_size; ++i)
+                {
+                    new (&newData[i]) T(rsblMove(m_data[i]));
+                    m_data[i].~T();
+                }
+                FreeBuffer();
             }
-            free(m_data);
+
+            m_data = newData;
         }
 
-        m_data = newData;
         m_capacity = newCapacity;
     }
 
@@ -59,52 +105,53 @@ class DynamicArray
         Reserve(initialCapacity);
     }
 
+    // Constructors with a custom allocator. The allocator must outlive the array.
+    explicit DynamicArray(Allocator* allocator)
+        : m_allocator(allocator)
+    {
+    }
+
+    DynamicArray(uint64 initialCapacity, Allocator* allocator)
+        : m_allocator(allocator)
+    {
+        Reserve(initialCapacity);
+    }
+
     // Destructor
     ~DynamicArray()
     {
         Clear();
-        if (m_data != nullptr)
-        {
-            free(m_data);
-        }
+        FreeBuffer();
     }
 
     // Copy constructor
     DynamicArray(const DynamicArray& other)
         : m_size(other.m_size)
         , m_capacity(other.m_capacity)
+        , m_allocator(other.m_allocator)
     {
         if (other.m_capacity > 0)
         {
-            m_data = static_cast<T*>(malloc(m_capacity * sizeof(T)));
-            for (uint64 i = 0; i < m_size; ++i)
-            {
-                new (&m_data[i]) T(other.m_data[i]);
-            }
+            m_data = AllocateBuffer(m_capacity);
+            CopyElements(other.m_data, m_size);
         }
     }
 
-    // Copy assignment
+    // Copy assignment (keeps our own allocator)
     DynamicArray& operator=(const DynamicArray& other)
     {
         if (this != &other)
         {
             Clear();
-            if (m_data != nullptr)
-            {
-                free(m_data);
-            }
+            FreeBuffer();
 
             m_size = other.m_size;
             m_capacity = other.m_capacity;
 
             if (other.m_capacity > 0)
             {
-                m_data = static_cast<T*>(malloc(m_capacity * sizeof(T)));
-                for (uint64 i = 0; i < m_size; ++i)
-                {
-                    new (&m_data[i]) T(other.m_data[i]);
-                }
+                m_data = AllocateBuffer(m_capacity);
+                CopyElements(other.m_data, m_size);
             }
             else
             {
@@ -119,26 +166,25 @@ class DynamicArray
         : m_data(other.m_data)
         , m_size(other.m_size)
         , m_capacity(other.m_capacity)
+        , m_allocator(other.m_allocator)
     {
         other.m_data = nullptr;
         other.m_size = 0;
         other.m_capacity = 0;
     }
 
-    // Move assignment
+    // Move assignment (the buffer and its allocator come along together)
     DynamicArray& operator=(DynamicArray&& other) noexcept
     {
         if (this != &other)
         {
             Clear();
-            if (m_data != nullptr)
-            {
-                free(m_data);
-            }
+            FreeBuffer();
 
             m_data = other.m_data;
             m_size = other.m_size;
             m_capacity = other.m_capacity;
+            m_allocator = other.m_allocator;
 
             other.m_data = nullptr;
             other.m_size = 0;
@@ -149,23 +195,45 @@ class DynamicArray
 
     // Add element at end
     void PushBack(const T& value)
+    {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value)
+    {
+        EmplaceBack(rsblMove(value));
+    }
+
+    // Construct element in place at the end, no temporaries or extra moves
+    // Like PushBack, args must not reference elements of this array (they could move on growth)
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args)
     {
         if (m_size >= m_capacity)
         {
             Grow(m_size + 1);
         }
-        new (&m_data[m_size]) T(value);
+        T* element = new (&m_data[m_size]) T(rsblForward(args)...);
         ++m_size;
+        return *element;
     }
 
-    void PushBack(T&& value)
+    // Copy count elements to the end, with a single capacity check. Trivially copyable types
+    // are copied with one memcpy.
+    void Append(const T* first, uint64 count)
     {
-        if (m_size >= m_capacity)
+        if (count == 0)
         {
-            Grow(m_size + 1);
+            return;
         }
-        new (&m_data[m_size]) T(rsblMove(value));
-        ++m_size;
+
+        const uint64 newSize = m_size + count;
+        if (newSize > m_capacity)
+        {
+            Grow(newSize);
+        }
+        CopyElements(first, count, m_size);
+        m_size = newSize;
     }
 
     // Remove last element
@@ -239,14 +307,35 @@ class DynamicArray
             }
 
             // Default-construct new elements
-            for (uint64 i = m_size; i < newSize; ++i)
+            if constexpr (IsTriviallyZeroConstructible<T>)
             {
-                new (&m_data[i]) T();
+                memset(static_cast<void*>(m_data + m_size), 0, (newSize - m_size) * sizeof(T));
+            }
+            else
+            {
+                for (uint64 i = m_size; i < newSize; ++i)
+                {
+                    new (&m_data[i]) T();
+                }
             }
             m_size = newSize;
         }
     }
 
+    // Resize without initializing new elements. Only available for trivial types, where the
+    // caller is about to overwrite the contents anyway (e.g. filling from a file or API query).
+    void ResizeUninitialized(uint64 newSize)
+    {
+        static_assert(IsTriviallyZeroConstructible<T>,
+                      "ResizeUninitialized requires a trivially constructible type");
+
+        if (newSize > m_capacity)
+        {
+            Grow(newSize);
+        }
+        m_size = newSize;
+    }
+
     // Clear all elements
     void Clear()
     {
@@ -257,6 +346,11 @@ class DynamicArray
         m_size = 0;
     }
 
+    Allocator* GetAllocator() const
+    {
+        return m_allocator;
+    }
+
     // Get raw data pointer
     T* Data()
     {
@@ -290,4 +384,11 @@ class DynamicArray
     }
 };
 
+// DynamicArray only holds a pointer into its heap buffer, so it can be relocated with memcpy
+template <typename T>
+struct TriviallyRelocatable<DynamicArray<T>>
+{
+    static constexpr bool value = true;
+};
+
 } // namespace rsbl
@@ -0,0 +1,539 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-result.h"
+#include "rsbl-string.h"
+
+// Text formatting for the hot paths that aren't logging: HUD stats, asset paths, failure text
+// naming a file. Writes into a buffer the caller owns, on the stack, in a String using an arena,
+// or in a FormatBuffer, and never allocates on its own. The format string is parsed at compile
+// time, into the literal runs and placeholders formatting walks, so a bad format string or a
+// placeholder count that doesn't match the arguments is a compile error rather than garbage.
+//
+//     char path[256];
+//     FormatTo(path, "{}/lod{}.rmesh", directory, lod);
+//     String line(&frameArena);
+//     FormatAppend(line, "{:>6.2f} ms  {} draws", frameMs, drawCount);
+//     return FailureFormatCopy(ErrorCategory::NotFound, "No texture {} in {}", name, path);
+//
+// Placeholders are fmt's, in order, without positions or names: {} or {:spec}, with {{ and }}
+// for braces. spec is [<|>][0][width][.precision][type], width and precision up to 255:
+//
+//     <, >   Left or right align in width. Numbers default to the right, the rest to the left.
+//     0      Pad numbers with zeros after the sign instead of spaces
+//     type   x, X or b for integers and pointers in hex or binary, f or e for floats in fixed or
+//            exponent notation with precision digits (6 without one). Floats without a type are
+//            the shortest text that reads back as the same value, or precision significant
+//            digits; strings with a precision are cut to that many chars.
+//
+// Arguments are integers, bool, char, floats, enums (as their value), pointers (in hex),
+// null-terminated strings, StringView and String.
+
+namespace rsbl
+{
+
+// Placeholders and literal runs a format string can have, {{ and }} each ending a run. Every call
+// has the parsed string in hand, so it's kept small.
+constexpr uint32 kMaxFormatArgs = 15;
+constexpr uint32 kMaxFormatSegments = 16;
+
+namespace Internal
+{
+    enum class FormatArgType : uint8
+    {
+        Bool,
+        Char,
+        Int,
+        Uint,
+        Float,
+        Double,
+        String,
+        Pointer,
+    };
+
+    struct FormatArg
+    {
+        FormatArgType type;
+        union
+        {
+            int64 i;
+            uint64 u;
+            float f;
+            double d;
+            const void* p;
+            struct
+            {
+                const char* data;
+                uint64 size;
+            } s;
+        };
+    };
+
+    template <typename T>
+    struct FormatArgTraits;
+
+    // Integers, chars and bool having their own below
+    template <typename T>
+        requires(!__is_enum(T) && requires(T value) { value % value; })
+    struct FormatArgTraits<T>
+    {
+        static constexpr FormatArgType kType =
+            T(-1) < T(0) ? FormatArgType::Int : FormatArgType::Uint;
+        static FormatArg Make(T value)
+        {
+            FormatArg arg;
+            arg.type = kType;
+            if constexpr (kType == FormatArgType::Int)
+            {
+                arg.i = value;
+            }
+            else
+            {
+                arg.u = value;
+            }
+            return arg;
+        }
+    };
+
+    template <>
+    struct FormatArgTraits<bool>
+    {
+        static constexpr FormatArgType kType = FormatArgType::Bool;
+        static FormatArg Make(bool value)
+        {
+            FormatArg arg;
+            arg.type = kType;
+            arg.u = value ? 1 : 0;
+            return arg;
+        }
+    };
+
+    template <>
+    struct FormatArgTraits<char>
+    {
+        static constexpr FormatArgType kType = FormatArgType::Char;
+        static FormatArg Make(char value)
+        {
+            FormatArg arg;
+            arg.type = kType;
+            arg.u = static_cast<unsigned char>(value);
+            return arg;
+        }
+    };
+
+    template <>
+    struct FormatArgTraits<float>
+    {
+        static constexpr FormatArgType kType = FormatArgType::Float;
+        static FormatArg Make(float value)
+        {
+            FormatArg arg;
+            arg.type = kType;
+            arg.f = value;
+            return arg;
+        }
+    };
+
+    template <>
+    struct FormatArgTraits<double>
+    {
+        static constexpr FormatArgType kType = FormatArgType::Double;
+        static FormatArg Make(double value)
+        {
+            FormatArg arg;
+            arg.type = kType;
+            arg.d = value;
+            return arg;
+        }
+    };
+
+    template <>
+    struct FormatArgTraits<StringView>
+    {
+        static constexpr FormatArgType kType = FormatArgType::String;
+        static FormatArg Make(StringView value)
+        {
+            FormatArg arg;
+            arg.type = kType;
+            arg.s.data = value.Data();
+            arg.s.size = value.Size();
+            return arg;
+        }
+    };
+
+    template <>
+    struct FormatArgTraits<String> : FormatArgTraits<StringView>
+    {
+    };
+
+    template <>
+    struct FormatArgTraits<const char*> : FormatArgTraits<StringView>
+    {
+    };
+
+    template <>
+    struct FormatArgTraits<char*> : FormatArgTraits<StringView>
+    {
+    };
+
+    template <uint64 N>
+    struct FormatArgTraits<char[N]> : FormatArgTraits<StringView>
+    {
+    };
+
+    template <typename T>
+    struct FormatArgTraits<T*>
+    {
+        static constexpr FormatArgType kType = FormatArgType::Pointer;
+        static FormatArg Make(const void* value)
+        {
+            FormatArg arg;
+            arg.type = kType;
+            arg.p = value;
+            return arg;
+        }
+    };
+
+    template <typename T>
+        requires(__is_enum(T))
+    struct FormatArgTraits<T> : FormatArgTraits<__underlying_type(T)>
+    {
+        static FormatArg Make(T value)
+        {
+            return FormatArgTraits<__underlying_type(T)>::Make(
+                static_cast<__underlying_type(T)>(value));
+        }
+    };
+
+    template <typename T>
+    struct FormatRemoveConst
+    {
+        using type = T;
+    };
+
+    template <typename T>
+    struct FormatRemoveConst<const T>
+    {
+        using type = T;
+    };
+
+    template <typename T>
+    using FormatTraitsOf = FormatArgTraits<typename FormatRemoveConst<T>::type>;
+
+    template <typename T>
+    struct FormatIdentity
+    {
+        using type = T;
+    };
+
+    // FormatSegment::align
+    constexpr uint8 kFormatAlignDefault = 0;
+    constexpr uint8 kFormatAlignLeft = 1;
+    constexpr uint8 kFormatAlignRight = 2;
+
+    // A literal run of the format string, then the placeholder after it, if any
+    struct FormatSegment
+    {
+        uint16 literalOffset = 0;
+        uint16 literalSize = 0;
+        uint8 width = 0;
+        uint8 precision = 0;
+        char type = 0;
+        uint8 hasArg : 1 = 0;
+        uint8 hasPrecision : 1 = 0;
+        uint8 zeroPad : 1 = 0;
+        uint8 align : 2 = kFormatAlignDefault;
+    };
+
+    static_assert(sizeof(FormatSegment) == 8, "FormatSegment is packed");
+
+    // Not constexpr, so a format string that reaches one fails to compile there, the call naming
+    // what's wrong with it
+    void FormatStringHasUnmatchedBrace();
+    void FormatStringHasTooManySegments();
+    void FormatStringHasBadSpec();
+    void FormatStringArgCountMismatch();
+    void FormatStringTypeDoesNotFitArg();
+    void FormatStringIsTooLong();
+
+    consteval bool FormatTypeFits(char type, FormatArgType arg)
+    {
+        const bool integer = arg == FormatArgType::Int || arg == FormatArgType::Uint ||
+                             arg == FormatArgType::Char || arg == FormatArgType::Bool;
+        const bool floating = arg == FormatArgType::Float || arg == FormatArgType::Double;
+        switch (type)
+        {
+        case 0:
+            return true;
+        case 'x':
+        case 'X':
+        case 'b':
+            return integer || arg == FormatArgType::Pointer;
+        case 'f':
+        case 'e':
+            return floating;
+        default:
+            return false;
+        }
+    }
+
+    // Writes the parsed format into buffer, cut to fit and null terminated when capacity isn't 0.
+    // Returns the length the whole text needs, not counting the terminator.
+    uint64 FormatSegments(char* buffer,
+                          uint64 capacity,
+                          const char* format,
+                          const FormatSegment* segments,
+                          uint32 segmentCount,
+                          const FormatArg* args);
+} // namespace Internal
+
+// A format string parsed at compile time for arguments of types Args
+template <typename... Args>
+class FormatString
+{
+  public:
+    template <uint64 N>
+    consteval FormatString(const char (&format)[N])
+        : m_format(format)
+    {
+        if (N - 1 > 0xffff)
+        {
+            Internal::FormatStringIsTooLong();
+        }
+
+        constexpr Internal::FormatArgType kTypes[] = {
+            Internal::FormatTraitsOf<Args>::kType..., Internal::FormatArgType::Bool};
+        uint32 arg = 0;
+        uint32 literal = 0;
+        uint32 i = 0;
+        while (true)
+        {
+            const bool end = i == N - 1;
+            const char c = end ? '\0' : format[i];
+            if (!end && c != '{' && c != '}')
+            {
+                ++i;
+                continue;
+            }
+            const bool escape = !end && i + 1 < N - 1 && format[i + 1] == c;
+            if (!end && c == '}' && !escape)
+            {
+                Internal::FormatStringHasUnmatchedBrace();
+            }
+
+            if (m_segmentCount == kMaxFormatSegments)
+            {
+                Internal::FormatStringHasTooManySegments();
+            }
+            Internal::FormatSegment& segment = m_segments[m_segmentCount++];
+            segment.literalOffset = static_cast<uint16>(literal);
+            // An escaped brace keeps its first char in the run
+            segment.literalSize = static_cast<uint16>(i - literal + (escape ? 1 : 0));
+            if (end)
+            {
+                break;
+            }
+            if (escape)
+            {
+                i += 2;
+                literal = i;
+                continue;
+            }
+
+            i = ParseSpec(format, N - 1, i + 1, segment);
+            if (arg == sizeof...(Args))
+            {
+                Internal::FormatStringArgCountMismatch();
+            }
+            if (!Internal::FormatTypeFits(segment.type, kTypes[arg]))
+            {
+                Internal::FormatStringTypeDoesNotFitArg();
+            }
+            segment.hasArg = 1;
+            ++arg;
+            literal = i;
+        }
+        if (arg != sizeof...(Args))
+        {
+            Internal::FormatStringArgCountMismatch();
+        }
+    }
+
+    constexpr const char* Format() const
+    {
+        return m_format;
+    }
+
+    constexpr const Internal::FormatSegment* Segments() const
+    {
+        return m_segments;
+    }
+
+    constexpr uint32 SegmentCount() const
+    {
+        return m_segmentCount;
+    }
+
+  private:
+    // Past the placeholder's closing brace, from just after its opening one
+    static consteval uint32 ParseSpec(const char* format,
+                                      uint32 size,
+                                      uint32 i,
+                                      Internal::FormatSegment& segment)
+    {
+        if (i < size && format[i] == ':')
+        {
+            ++i;
+            if (i < size && (format[i] == '<' || format[i] == '>'))
+            {
+                segment.align =
+                    format[i] == '<' ? Internal::kFormatAlignLeft : Internal::kFormatAlignRight;
+                ++i;
+            }
+            if (i < size && format[i] == '0')
+            {
+                segment.zeroPad = 1;
+                ++i;
+            }
+            segment.width = ParseNumber(format, size, i);
+            if (i < size && format[i] == '.')
+            {
+                ++i;
+                if (i == size || format[i] < '0' || format[i] > '9')
+                {
+                    Internal::FormatStringHasBadSpec();
+                }
+                segment.precision = ParseNumber(format, size, i);
+                segment.hasPrecision = 1;
+            }
+            if (i < size && format[i] != '}')
+            {
+                segment.type = format[i++];
+            }
+        }
+        if (i == size || format[i] != '}')
+        {
+            Internal::FormatStringHasBadSpec();
+        }
+        return i + 1;
+    }
+
+    static consteval uint8 ParseNumber(const char* format, uint32 size, uint32& i)
+    {
+        uint32 value = 0;
+        while (i < size && format[i] >= '0' && format[i] <= '9')
+        {
+            value = value * 10 + static_cast<uint32>(format[i++] - '0');
+            if (value > 255)
+            {
+                Internal::FormatStringHasBadSpec();
+            }
+        }
+        return static_cast<uint8>(value);
+    }
+
+    const char* m_format;
+    Internal::FormatSegment m_segments[kMaxFormatSegments] = {};
+    uint32 m_segmentCount = 0;
+};
+
+// Arguments are deduced from the call, not from the format string
+template <typename... Args>
+using FormatStringFor = FormatString<typename Internal::FormatIdentity<Args>::type...>;
+
+// Formats into buffer, cut short to fit and always null terminated. Returns what was written.
+template <typename... Args>
+StringView FormatTo(char* buffer,
+                    uint64 capacity,
+                    const FormatStringFor<Args...>& format,
+                    const Args&... args)
+{
+    static_assert(sizeof...(Args) <= kMaxFormatArgs, "Too many format arguments");
+    const Internal::FormatArg packed[sizeof...(Args) + 1] = {
+        Internal::FormatTraitsOf<Args>::Make(args)..., Internal::FormatArg{}};
+    const uint64 size = Internal::FormatSegments(
+        buffer, capacity, format.Format(), format.Segments(), format.SegmentCount(), packed);
+    return StringView(buffer, capacity == 0 ? 0 : (size < capacity ? size : capacity - 1));
+}
+
+template <uint64 N, typename... Args>
+StringView FormatTo(char (&buffer)[N], const FormatStringFor<Args...>& format, const Args&... args)
+{
+    return FormatTo<Args...>(buffer, N, format, args...);
+}
+
+// Appends to text, which grows with its own allocator, say an arena's, when the text doesn't fit
+// what it has
+template <typename... Args>
+String& FormatAppend(String& text, const FormatStringFor<Args...>& format, const Args&... args)
+{
+    static_assert(sizeof...(Args) <= kMaxFormatArgs, "Too many format arguments");
+    const Internal::FormatArg packed[sizeof...(Args) + 1] = {
+        Internal::FormatTraitsOf<Args>::Make(args)..., Internal::FormatArg{}};
+    // Straight into the spare capacity, and only when that's too small, again once it's grown
+    const uint64 start = text.Size();
+    const uint64 spare = text.Capacity() - start + 1;
+    const uint64 size = Internal::FormatSegments(text.Data() + start,
+                                                 spare,
+                                                 format.Format(),
+                                                 format.Segments(),
+                                                 format.SegmentCount(),
+                                                 packed);
+    if (size >= spare)
+    {
+        text.Reserve(start + size);
+        Internal::FormatSegments(text.Data() + start,
+                                 size + 1,
+                                 format.Format(),
+                                 format.Segments(),
+                                 format.SegmentCount(),
+                                 packed);
+    }
+    text.ResizeForOverwrite(start + size);
+    return text;
+}
+
+// Formatted text on the stack, for passing straight on: Format("{} fps", fps).CStr()
+template <uint64 N>
+struct FormatBuffer
+{
+    char data[N];
+    uint64 size;
+
+    const char* CStr() const
+    {
+        return data;
+    }
+
+    StringView View() const
+    {
+        return StringView(data, size);
+    }
+
+    operator StringView() const
+    {
+        return View();
+    }
+};
+
+template <uint64 N = 256, typename... Args>
+FormatBuffer<N> Format(const FormatStringFor<Args...>& format, const Args&... args)
+{
+    FormatBuffer<N> buffer;
+    buffer.size = FormatTo<Args...>(buffer.data, N, format, args...).Size();
+    return buffer;
+}
+
+// FailureCopy of formatted text, for failures naming strings that FailureFormat can't hold on to.
+// Cut to the failure text buffer's size.
+template <typename... Args>
+PendingFailure FailureFormatCopy(ErrorCategory category,
+                                 const FormatStringFor<Args...>& format,
+                                 const Args&... args)
+{
+    return FailureCopy(category, Format<256, Args...>(format, args...).CStr());
+}
+
+} // namespace rsbl
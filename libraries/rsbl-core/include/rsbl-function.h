@@ -7,6 +7,9 @@
 #include "rsbl-core.h"
 #include "rsbl-int-types.h"
 
+#include <cstring>
+#include <new>
+
 // TODO: Method binder helper in lambda form
 // TODO: Method version of Function constructor
 // TODO: static_assert that storage alignment doesn't conflict with functor alignmenet
@@ -25,11 +28,33 @@ constexpr uint32 kFunctionBufferAlignment = 16;
 // Interestingly, I am allowed to have the parameter pack as NOT last, because default arguments can
 // be last. I might change this because...it's weird. But default template arg followed by parameter
 // pack is also kinda weird
-template <typename ReturnType, uint32 BufferSize = 32, typename... ArgsTypes>
+// What a Function does with a functor that doesn't fit its inline buffer
+enum class FunctionStorage : uint8
+{
+    // Oversized functors don't compile, so the Function never allocates
+    InlineOnly,
+
+    // Oversized (or over-aligned) functors are moved into a pooled allocation, and the buffer just
+    // holds the pointer. Moving the Function then only moves the pointer.
+    InlineOrPool,
+};
+
+namespace Internal
+{
+    // Pooled storage for functors that don't fit inline. Small sizes come from shared
+    // thread-cached pools, anything bigger goes to the default allocator.
+    void* AllocateFunctor(uint64 size, uint64 alignment);
+    void FreeFunctor(void* ptr, uint64 size, uint64 alignment);
+} // namespace Internal
+
+template <typename ReturnType,
+          uint32 BufferSize = 32,
+          FunctionStorage Storage = FunctionStorage::InlineOnly,
+          typename... ArgsTypes>
 class Function;
 
-template <typename ReturnType, uint32 BufferSize, typename... ArgsTypes>
-class Function<ReturnType(ArgsTypes...), BufferSize>
+template <typename ReturnType, uint32 BufferSize, FunctionStorage Storage, typename... ArgsTypes>
+class Function<ReturnType(ArgsTypes...), BufferSize, Storage>
 {
   public:
     Function() noexcept = default;
@@ -40,27 +65,42 @@ class Function<ReturnType(ArgsTypes...), BufferSize>
     }
 
     template <typename FunctorType>
+        requires(!IsSame<Decay<FunctorType>, Function>)
     Function(FunctorType&& functor)
     {
         using StoredType = Decay<FunctorType>;
-        static_assert(sizeof(StoredType) <= BufferSize, "Functor too large for Function buffer");
-        static_assert(alignof(StoredType) <= kFunctionBufferAlignment,
-                      "Functor alignment too strict for Function");
 
-        m_invoker = [](void* functor_buffer, ArgsTypes... args) -> ReturnType {
-            return (*static_cast<StoredType*>(functor_buffer))(rsblForward(args)...);
-        };
+        if constexpr (Storage == FunctionStorage::InlineOnly || FitsInline<StoredType>())
+        {
+            static_assert(sizeof(StoredType) <= BufferSize,
+                          "Functor too large for Function buffer");
+            static_assert(alignof(StoredType) <= kFunctionBufferAlignment,
+                          "Functor alignment too strict for Function");
+
+            // I need to use placement new to manage the functor construction correctly
+            new (m_buffer) StoredType(rsblForward(functor));
+            m_ops = &kInlineOps<StoredType>;
+        }
+        else
+        {
+            static_assert(BufferSize >= sizeof(void*), "Function buffer can't hold a pointer");
 
-        m_destructor = [](void* functor_buffer) {
-            static_cast<StoredType*>(functor_buffer)->~StoredType();
-        };
+            void* memory = Internal::AllocateFunctor(sizeof(StoredType), alignof(StoredType));
+            rsblVerifyMsg(memory != nullptr, "Failed to allocate Function storage");
 
-        m_mover = [](void* dst, void* src) {
-            new (dst) StoredType(rsblMove(*static_cast<StoredType*>(src)));
-        };
+            *reinterpret_cast<StoredType**>(m_buffer) =
+                new (memory) StoredType(rsblForward(functor));
+            m_ops = &kPooledOps<StoredType>;
+        }
+    }
 
-        // I need to use placement new to manage the functor construction correctly
-        new (m_buffer) StoredType(rsblForward(functor));
+    // Whether a functor is stored in the buffer, rather than in pooled storage
+    template <typename FunctorType>
+    static constexpr bool FitsInline()
+    {
+        using StoredType = Decay<FunctorType>;
+        return sizeof(StoredType) <= BufferSize &&
+               alignof(StoredType) <= kFunctionBufferAlignment;
     }
 
     // Type for CallArgsTypes is explicitly different from ArgsTypes to support conversion
@@ -68,16 +108,16 @@ class Function<ReturnType(ArgsTypes...), BufferSize>
     // Having different types here allows for some reasonable implicit conversions.
     // The alternative (which is much more typical) is to NOT have this operator templated, and just
     // use ArgsTypes for the call_args parameter pack. I'm actually slightly surprised the
-    // forwarding works for CallArgsTypes. m_invoker must be doing the correct deduction!
+    // forwarding works for CallArgsTypes. The invoker must be doing the correct deduction!
     // Something else I might have to consider is marking reference args with rsbl::Ref (or
     // something similar to std::ref).
 
     template <typename... CallArgsTypes>
     ReturnType operator()(CallArgsTypes&&... call_args) const
     {
-        rsblAssert(m_invoker != nullptr);
-        return m_invoker(const_cast<void*>(static_cast<const void*>(m_buffer)),
-                         rsblForward(call_args)...);
+        rsblAssert(m_ops != nullptr);
+        return m_ops->invoke(const_cast<void*>(static_cast<const void*>(m_buffer)),
+                             rsblForward(call_args)...);
     }
 
     // No copies
@@ -102,54 +142,176 @@ class Function<ReturnType(ArgsTypes...), BufferSize>
     // I don't love this implicit bool operator, but I see this pattern in other places too
     operator bool() const
     {
-        return m_invoker != nullptr;
+        return m_ops != nullptr;
     }
 
     bool Valid() const
     {
-        return m_invoker != nullptr;
+        return m_ops != nullptr;
     }
 
   protected:
+    // I could just declare these are regular function pointers, but I think the using syntax
+    // makes the member decls easier to read
+    using InvokerType = ReturnType (*)(void*, ArgsTypes...);
+    using RelocatorType = void (*)(void*, void*);
+    using DestructorType = void (*)(void*);
+
+    // One static table per stored type, so a Function only pays for a single pointer.
+    // A null relocate means the buffer can just be memcpy'd, and a null destroy means there's
+    // nothing to do, which is the common case for lambdas capturing pointers and PODs.
+    struct Ops
+    {
+        InvokerType invoke;
+        RelocatorType relocate; // Move-constructs into dst, then destroys src
+        DestructorType destroy;
+    };
+
+    template <typename StoredType>
+    static ReturnType InvokeInline(void* functor_buffer, ArgsTypes... args)
+    {
+        return (*static_cast<StoredType*>(functor_buffer))(rsblForward(args)...);
+    }
+
+    template <typename StoredType>
+    static void RelocateInline(void* dst, void* src)
+    {
+        StoredType* src_functor = static_cast<StoredType*>(src);
+        new (dst) StoredType(rsblMove(*src_functor));
+        src_functor->~StoredType();
+    }
+
+    template <typename StoredType>
+    static void DestroyInline(void* functor_buffer)
+    {
+        static_cast<StoredType*>(functor_buffer)->~StoredType();
+    }
+
+    template <typename StoredType>
+    static constexpr Ops kInlineOps = {
+        InvokeInline<StoredType>,
+        __is_trivially_copyable(StoredType) ? nullptr : RelocateInline<StoredType>,
+        __has_trivial_destructor(StoredType) ? nullptr : DestroyInline<StoredType>,
+    };
+
+    template <typename StoredType>
+    static ReturnType InvokePooled(void* functor_buffer, ArgsTypes... args)
+    {
+        return (**static_cast<StoredType**>(functor_buffer))(rsblForward(args)...);
+    }
+
+    template <typename StoredType>
+    static void DestroyPooled(void* functor_buffer)
+    {
+        StoredType* stored = *static_cast<StoredType**>(functor_buffer);
+        stored->~StoredType();
+        Internal::FreeFunctor(stored, sizeof(StoredType), alignof(StoredType));
+    }
+
+    // The functor stays put, relocating only copies the pointer
+    template <typename StoredType>
+    static constexpr Ops kPooledOps = {
+        InvokePooled<StoredType>,
+        nullptr,
+        DestroyPooled<StoredType>,
+    };
+
     void Reset() noexcept
     {
-        if (m_destructor != nullptr)
+        if (m_ops != nullptr && m_ops->destroy != nullptr)
         {
-            m_destructor(m_buffer);
+            m_ops->destroy(m_buffer);
         }
-        m_invoker = nullptr;
-        m_mover = nullptr;
-        m_destructor = nullptr;
+        m_ops = nullptr;
     }
 
     void MoveFrom(Function& rhs) noexcept
     {
-        // I can check any of the function pointers, since they are set together
-        if (rhs.m_mover == nullptr)
+        if (rhs.m_ops == nullptr)
         {
             return;
         }
 
-        m_invoker = rhs.m_invoker;
-        m_mover = rhs.m_mover;
-        m_destructor = rhs.m_destructor;
-
-        m_mover(m_buffer, rhs.m_buffer);
+        if (rhs.m_ops->relocate != nullptr)
+        {
+            rhs.m_ops->relocate(m_buffer, rhs.m_buffer);
+        }
+        else
+        {
+            memcpy(m_buffer, rhs.m_buffer, BufferSize);
+        }
 
-        rhs.Reset();
+        // The functor now lives here, so rhs is emptied without destroying anything
+        m_ops = rhs.m_ops;
+        rhs.m_ops = nullptr;
     }
 
     // I think better to have the buffer first
     alignas(kFunctionBufferAlignment) uint8 m_buffer[BufferSize]{};
 
-    // I could just declare these are regular function pointers, but I think the using syntax
-    // makes the member decls easier to read
-    using InvokerType = ReturnType (*)(void*, ArgsTypes...);
-    using MoverType = void (*)(void*, void*);
-    using DestructorType = void (*)(void*);
+    const Ops* m_ops = nullptr;
+};
+
+// Function that takes any functor, spilling the ones that don't fit the buffer into a pool
+template <typename Signature, uint32 BufferSize = 32>
+using PooledFunction = Function<Signature, BufferSize, FunctionStorage::InlineOrPool>;
+
+template <typename Signature>
+class FunctionRef;
+
+// Non-owning view of a callable, just an object pointer and a call thunk. There's nothing to move
+// or destroy, so it's as cheap to pass around as a pointer. Meant for parameters (parallel-for
+// bodies, visitors, callbacks) where the callee doesn't hold on to the callable, the referenced
+// callable has to outlive the FunctionRef.
+template <typename ReturnType, typename... ArgsTypes>
+class FunctionRef<ReturnType(ArgsTypes...)>
+{
+  public:
+    template <typename CallableType>
+        requires(!IsSame<Decay<CallableType>, FunctionRef>)
+    FunctionRef(CallableType&& callable) noexcept
+    {
+        using ReferencedType = RemoveReference<CallableType>;
+
+        m_target.object = const_cast<void*>(static_cast<const void*>(&callable));
+        m_invoker = [](Target target, ArgsTypes... args) -> ReturnType {
+            return (*static_cast<ReferencedType*>(target.object))(rsblForward(args)...);
+        };
+    }
+
+    // Free functions are held directly, so passing one doesn't leave a dangling
+    // pointer-to-pointer behind
+    FunctionRef(ReturnType (*function)(ArgsTypes...)) noexcept
+    {
+        rsblAssert(function != nullptr);
+
+        m_target.function = reinterpret_cast<void (*)()>(function);
+        m_invoker = [](Target target, ArgsTypes... args) -> ReturnType {
+            return reinterpret_cast<ReturnType (*)(ArgsTypes...)>(target.function)(
+                rsblForward(args)...);
+        };
+    }
+
+    FunctionRef(const FunctionRef&) noexcept = default;
+    FunctionRef& operator=(const FunctionRef&) noexcept = default;
+
+    ReturnType operator()(ArgsTypes... args) const
+    {
+        return m_invoker(m_target, rsblForward(args)...);
+    }
+
+  private:
+    // Object pointers and function pointers don't have to convert to each other
+    union Target
+    {
+        void* object;
+        void (*function)();
+    };
+
+    using InvokerType = ReturnType (*)(Target, ArgsTypes...);
+
+    Target m_target;
     InvokerType m_invoker = nullptr;
-    MoverType m_mover = nullptr;
-    DestructorType m_destructor = nullptr;
 };
 
 template <auto MemberFunc>
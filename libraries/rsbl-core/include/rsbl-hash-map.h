@@ -0,0 +1,796 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-bits.h"
+#include "rsbl-core.h"
+#include "rsbl-hash.h"
+#include "rsbl-int-types.h"
+
+#include <cstring>
+#include <new>
+
+#if defined(_M_X64) || defined(__SSE2__)
+    #define RSBL_HASH_TABLE_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define RSBL_HASH_TABLE_SSE2 0
+#endif
+
+// Flat open-addressing HashMap and HashSet, in the style of SwissTable. Every slot has a one byte
+// control tag (empty, deleted, or 7 bits of the hash), and lookups compare a whole group of 16
+// tags at once with SSE2. Entries live in one contiguous allocation, so there is no per-entry
+// node allocation like std::unordered_map.
+// Pointers to entries are invalidated by any insert that grows the table.
+
+namespace rsbl
+{
+namespace Internal
+{
+    constexpr int8 kHashCtrlEmpty = -128;
+    constexpr int8 kHashCtrlDeleted = -2;
+    constexpr uint64 kHashGroupWidth = 16;
+
+    // Bitmasks of the tags in a group of 16 that match a condition, bit i is slot i
+    inline uint32 HashGroupMatch(const int8* group, int8 tag)
+    {
+#if RSBL_HASH_TABLE_SSE2
+        const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag))));
+#else
+        uint32 mask = 0;
+        for (uint32 i = 0; i < kHashGroupWidth; ++i)
+        {
+            mask |= uint32(group[i] == tag) << i;
+        }
+        return mask;
+#endif
+    }
+
+    inline uint32 HashGroupMatchEmpty(const int8* group)
+    {
+        return HashGroupMatch(group, kHashCtrlEmpty);
+    }
+
+    // Empty and deleted are the only tags with the high bit set
+    inline uint32 HashGroupMatchEmptyOrDeleted(const int8* group)
+    {
+#if RSBL_HASH_TABLE_SSE2
+        const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<uint32>(_mm_movemask_epi8(ctrl));
+#else
+        uint32 mask = 0;
+        for (uint32 i = 0; i < kHashGroupWidth; ++i)
+        {
+            mask |= uint32(group[i] < 0) << i;
+        }
+        return mask;
+#endif
+    }
+
+    // Shared table for HashMap and HashSet. Policy provides KeyType and a static Key(const Slot&).
+    template <typename Slot, typename Policy, typename Hasher>
+    class HashTable
+    {
+      public:
+        using KeyType = typename Policy::KeyType;
+
+        static constexpr uint64 kNotFound = ~uint64(0);
+
+        struct InsertResult
+        {
+            Slot* slot;
+            bool inserted;
+        };
+
+      private:
+        int8* m_ctrl = nullptr;
+        Slot* m_slots = nullptr;
+        uint64 m_capacity = 0;
+        uint64 m_size = 0;
+        uint64 m_growthLeft = 0;
+        Allocator* m_allocator = GetDefaultAllocator();
+
+        // 7/8 max load factor
+        static uint64 MaxLoad(uint64 capacity)
+        {
+            return capacity - capacity / 8;
+        }
+
+        static uint64 SlotsOffset(uint64 capacity)
+        {
+            return AlignUp(capacity, alignof(Slot));
+        }
+
+        static uint64 AllocationSize(uint64 capacity)
+        {
+            return SlotsOffset(capacity) + capacity * sizeof(Slot);
+        }
+
+        static uint64 AllocationAlignment()
+        {
+            return alignof(Slot) > kHashGroupWidth ? alignof(Slot) : kHashGroupWidth;
+        }
+
+        static int8 HashTag(uint64 hash)
+        {
+            return static_cast<int8>(hash & 0x7f);
+        }
+
+        static uint64 HashKey(const KeyType& key)
+        {
+            return Hasher{}(key);
+        }
+
+        void AllocateStorage(uint64 capacity)
+        {
+            uint8* memory = static_cast<uint8*>(
+                m_allocator->Allocate(AllocationSize(capacity), AllocationAlignment()));
+            m_ctrl = reinterpret_cast<int8*>(memory);
+            m_slots = reinterpret_cast<Slot*>(memory + SlotsOffset(capacity));
+            m_capacity = capacity;
+            memset(m_ctrl, kHashCtrlEmpty, capacity);
+        }
+
+        void FreeStorage()
+        {
+            if (m_ctrl != nullptr)
+            {
+                m_allocator->Free(m_ctrl, AllocationSize(m_capacity), AllocationAlignment());
+                m_ctrl = nullptr;
+                m_slots = nullptr;
+            }
+        }
+
+        void DestroySlots()
+        {
+            if constexpr (!__has_trivial_destructor(Slot))
+            {
+                for (uint64 i = 0; i < m_capacity; ++i)
+                {
+                    if (m_ctrl[i] >= 0)
+                    {
+                        m_slots[i].~Slot();
+                    }
+                }
+            }
+        }
+
+        // Groups are probed triangularly (+1, +2, +3...), which visits every group once when the
+        // group count is a power of two
+        uint64 FindIndex(const KeyType& key, uint64 hash) const
+        {
+            if (m_capacity == 0)
+            {
+                return kNotFound;
+            }
+
+            const uint64 groupMask = m_capacity / kHashGroupWidth - 1;
+            const int8 tag = HashTag(hash);
+            uint64 group = (hash >> 7) & groupMask;
+
+            for (uint64 step = 1;; ++step)
+            {
+                const int8* groupCtrl = m_ctrl + group * kHashGroupWidth;
+                for (uint32 match = HashGroupMatch(groupCtrl, tag); match != 0; match &= match - 1)
+                {
+                    const uint64 index = group * kHashGroupWidth + CountTrailingZeros32(match);
+                    if (Policy::Key(m_slots[index]) == key)
+                    {
+                        return index;
+                    }
+                }
+
+                // An empty slot in the group means the key would have been placed here
+                if (HashGroupMatchEmpty(groupCtrl) != 0 || step > groupMask)
+                {
+                    return kNotFound;
+                }
+                group = (group + step) & groupMask;
+            }
+        }
+
+        uint64 FindInsertIndex(uint64 hash) const
+        {
+            const uint64 groupMask = m_capacity / kHashGroupWidth - 1;
+            uint64 group = (hash >> 7) & groupMask;
+
+            for (uint64 step = 1;; ++step)
+            {
+                const uint32 available =
+                    HashGroupMatchEmptyOrDeleted(m_ctrl + group * kHashGroupWidth);
+                if (available != 0)
+                {
+                    return group * kHashGroupWidth + CountTrailingZeros32(available);
+                }
+                group = (group + step) & groupMask;
+            }
+        }
+
+        void Rehash(uint64 newCapacity)
+        {
+            int8* oldCtrl = m_ctrl;
+            Slot* oldSlots = m_slots;
+            const uint64 oldCapacity = m_capacity;
+
+            AllocateStorage(newCapacity);
+
+            for (uint64 i = 0; i < oldCapacity; ++i)
+            {
+                if (oldCtrl[i] < 0)
+                {
+                    continue;
+                }
+
+                const uint64 hash = HashKey(Policy::Key(oldSlots[i]));
+                const uint64 index = FindInsertIndex(hash);
+                m_ctrl[index] = HashTag(hash);
+
+                if constexpr (IsTriviallyRelocatable<Slot>)
+                {
+                    memcpy(static_cast<void*>(&m_slots[index]),
+                           static_cast<const void*>(&oldSlots[i]), sizeof(Slot));
+                }
+                else
+                {
+                    new (&m_slots[index]) Slot(rsblMove(oldSlots[i]));
+                    oldSlots[i].~Slot();
+                }
+            }
+
+            if (oldCtrl != nullptr)
+            {
+                m_allocator->Free(oldCtrl, AllocationSize(oldCapacity), AllocationAlignment());
+            }
+            m_growthLeft = MaxLoad(m_capacity) - m_size;
+        }
+
+        static uint64 CapacityForCount(uint64 count)
+        {
+            uint64 capacity = kHashGroupWidth;
+            while (MaxLoad(capacity) < count)
+            {
+                capacity *= 2;
+            }
+            return capacity;
+        }
+
+        void MakeRoomForInsert()
+        {
+            if (m_capacity == 0)
+            {
+                Rehash(kHashGroupWidth);
+            }
+            else if (m_size < MaxLoad(m_capacity) / 2)
+            {
+                // Mostly tombstones, so clean up in place instead of growing
+                Rehash(m_capacity);
+            }
+            else
+            {
+                Rehash(m_capacity * 2);
+            }
+        }
+
+        void StealFrom(HashTable& other)
+        {
+            m_ctrl = other.m_ctrl;
+            m_slots = other.m_slots;
+            m_capacity = other.m_capacity;
+            m_size = other.m_size;
+            m_growthLeft = other.m_growthLeft;
+
+            other.m_ctrl = nullptr;
+            other.m_slots = nullptr;
+            other.m_capacity = 0;
+            other.m_size = 0;
+            other.m_growthLeft = 0;
+        }
+
+        void CopyFrom(const HashTable& other)
+        {
+            if (other.m_size == 0)
+            {
+                return;
+            }
+
+            // Same capacity means the same layout, so we can copy control bytes directly
+            AllocateStorage(other.m_capacity);
+            memcpy(m_ctrl, other.m_ctrl, m_capacity);
+            for (uint64 i = 0; i < m_capacity; ++i)
+            {
+                if (m_ctrl[i] >= 0)
+                {
+                    new (&m_slots[i]) Slot(static_cast<const Slot&>(other.m_slots[i]));
+                }
+            }
+            m_size = other.m_size;
+            m_growthLeft = other.m_growthLeft;
+        }
+
+      public:
+        HashTable() = default;
+
+        explicit HashTable(Allocator* allocator)
+            : m_allocator(allocator)
+        {
+        }
+
+        ~HashTable()
+        {
+            DestroySlots();
+            FreeStorage();
+        }
+
+        HashTable(const HashTable& other)
+            : m_allocator(other.m_allocator)
+        {
+            CopyFrom(other);
+        }
+
+        HashTable& operator=(const HashTable& other)
+        {
+            if (this != &other)
+            {
+                DestroySlots();
+                FreeStorage();
+                m_capacity = 0;
+                m_size = 0;
+                m_growthLeft = 0;
+                CopyFrom(other);
+            }
+            return *this;
+        }
+
+        HashTable(HashTable&& other) noexcept
+            : m_allocator(other.m_allocator)
+        {
+            StealFrom(other);
+        }
+
+        HashTable& operator=(HashTable&& other) noexcept
+        {
+            if (this != &other)
+            {
+                DestroySlots();
+                FreeStorage();
+                m_allocator = other.m_allocator;
+                StealFrom(other);
+            }
+            return *this;
+        }
+
+        Slot* Find(const KeyType& key) const
+        {
+            const uint64 index = FindIndex(key, HashKey(key));
+            return index == kNotFound ? nullptr : &m_slots[index];
+        }
+
+        // Constructs Slot(args...) if key isn't present. args may alias key, they are only
+        // consumed after the lookup.
+        template <typename... Args>
+        InsertResult TryEmplace(const KeyType& key, Args&&... args)
+        {
+            const uint64 hash = HashKey(key);
+            const uint64 existing = FindIndex(key, hash);
+            if (existing != kNotFound)
+            {
+                return InsertResult{&m_slots[existing], false};
+            }
+
+            if (m_growthLeft == 0)
+            {
+                MakeRoomForInsert();
+            }
+
+            const uint64 index = FindInsertIndex(hash);
+            if (m_ctrl[index] == kHashCtrlEmpty)
+            {
+                --m_growthLeft;
+            }
+            m_ctrl[index] = HashTag(hash);
+            ++m_size;
+
+            Slot* slot = new (&m_slots[index]) Slot(rsblForward(args)...);
+            return InsertResult{slot, true};
+        }
+
+        bool Remove(const KeyType& key)
+        {
+            const uint64 index = FindIndex(key, HashKey(key));
+            if (index == kNotFound)
+            {
+                return false;
+            }
+
+            m_slots[index].~Slot();
+            --m_size;
+
+            // If the group still has an empty slot, no probe sequence ever continued past it, so
+            // we can skip the tombstone
+            const int8* groupCtrl = m_ctrl + (index & ~(kHashGroupWidth - 1));
+            if (HashGroupMatchEmpty(groupCtrl) != 0)
+            {
+                m_ctrl[index] = kHashCtrlEmpty;
+                ++m_growthLeft;
+            }
+            else
+            {
+                m_ctrl[index] = kHashCtrlDeleted;
+            }
+            return true;
+        }
+
+        void Clear()
+        {
+            DestroySlots();
+            if (m_capacity > 0)
+            {
+                memset(m_ctrl, kHashCtrlEmpty, m_capacity);
+            }
+            m_size = 0;
+            m_growthLeft = MaxLoad(m_capacity);
+        }
+
+        void Reserve(uint64 count)
+        {
+            if (count > m_size + m_growthLeft)
+            {
+                Rehash(CapacityForCount(count));
+            }
+        }
+
+        uint64 Size() const
+        {
+            return m_size;
+        }
+
+        uint64 Capacity() const
+        {
+            return m_capacity;
+        }
+
+        Allocator* GetAllocator() const
+        {
+            return m_allocator;
+        }
+
+        // Iteration visits full slots in table order
+        uint64 NextFullIndex(uint64 index) const
+        {
+            while (index < m_capacity && m_ctrl[index] < 0)
+            {
+                ++index;
+            }
+            return index;
+        }
+
+        Slot& SlotAt(uint64 index) const
+        {
+            return m_slots[index];
+        }
+    };
+
+    template <typename Table, typename Value>
+    class HashTableIterator
+    {
+        const Table* m_table;
+        uint64 m_index;
+
+      public:
+        HashTableIterator(const Table* table, uint64 index)
+            : m_table(table)
+            , m_index(table->NextFullIndex(index))
+        {
+        }
+
+        Value& operator*() const
+        {
+            return m_table->SlotAt(m_index);
+        }
+
+        Value* operator->() const
+        {
+            return &m_table->SlotAt(m_index);
+        }
+
+        HashTableIterator& operator++()
+        {
+            m_index = m_table->NextFullIndex(m_index + 1);
+            return *this;
+        }
+
+        bool operator==(const HashTableIterator& other) const
+        {
+            return m_index == other.m_index;
+        }
+
+        bool operator!=(const HashTableIterator& other) const
+        {
+            return m_index != other.m_index;
+        }
+    };
+} // namespace Internal
+
+template <typename K, typename V>
+struct HashMapEntry
+{
+    K key;
+    V value;
+
+    template <typename KeyArg, typename... ValueArgs>
+    HashMapEntry(KeyArg&& keyArg, ValueArgs&&... valueArgs)
+        : key(rsblForward(keyArg))
+        , value(rsblForward(valueArgs)...)
+    {
+    }
+};
+
+template <typename K, typename V>
+struct TriviallyRelocatable<HashMapEntry<K, V>>
+{
+    static constexpr bool value = IsTriviallyRelocatable<K> && IsTriviallyRelocatable<V>;
+};
+
+namespace Internal
+{
+    template <typename K, typename V>
+    struct HashMapPolicy
+    {
+        using KeyType = K;
+        static const K& Key(const HashMapEntry<K, V>& entry)
+        {
+            return entry.key;
+        }
+    };
+
+    template <typename K>
+    struct HashSetPolicy
+    {
+        using KeyType = K;
+        static const K& Key(const K& key)
+        {
+            return key;
+        }
+    };
+} // namespace Internal
+
+template <typename K, typename V, typename Hasher = Hash<K>>
+class HashMap
+{
+  public:
+    using Entry = HashMapEntry<K, V>;
+
+  private:
+    using Table = Internal::HashTable<Entry, Internal::HashMapPolicy<K, V>, Hasher>;
+    Table m_table;
+
+  public:
+    using Iterator = Internal::HashTableIterator<Table, Entry>;
+    using ConstIterator = Internal::HashTableIterator<Table, const Entry>;
+
+    HashMap() = default;
+
+    // The allocator must outlive the map
+    explicit HashMap(Allocator* allocator)
+        : m_table(allocator)
+    {
+    }
+
+    // Returns nullptr if key isn't in the map
+    V* Find(const K& key)
+    {
+        Entry* entry = m_table.Find(key);
+        return entry != nullptr ? &entry->value : nullptr;
+    }
+
+    const V* Find(const K& key) const
+    {
+        const Entry* entry = m_table.Find(key);
+        return entry != nullptr ? &entry->value : nullptr;
+    }
+
+    bool Contains(const K& key) const
+    {
+        return m_table.Find(key) != nullptr;
+    }
+
+    // Insert only if key isn't already present, returns true if inserted
+    bool Insert(const K& key, const V& value)
+    {
+        return m_table.TryEmplace(key, key, value).inserted;
+    }
+
+    bool Insert(K&& key, V&& value)
+    {
+        return m_table.TryEmplace(key, rsblMove(key), rsblMove(value)).inserted;
+    }
+
+    // Insert or overwrite the existing value
+    V& InsertOrAssign(const K& key, V&& value)
+    {
+        auto result = m_table.TryEmplace(key, key, rsblMove(value));
+        if (!result.inserted)
+        {
+            result.slot->value = rsblMove(value);
+        }
+        return result.slot->value;
+    }
+
+    V& InsertOrAssign(const K& key, const V& value)
+    {
+        auto result = m_table.TryEmplace(key, key, value);
+        if (!result.inserted)
+        {
+            result.slot->value = value;
+        }
+        return result.slot->value;
+    }
+
+    // Construct the value in place from args if key isn't present, otherwise return the existing
+    template <typename... Args>
+    V& Emplace(const K& key, Args&&... args)
+    {
+        return m_table.TryEmplace(key, key, rsblForward(args)...).slot->value;
+    }
+
+    // Find, or insert a default-constructed value
+    V& operator[](const K& key)
+    {
+        return m_table.TryEmplace(key, key).slot->value;
+    }
+
+    bool Remove(const K& key)
+    {
+        return m_table.Remove(key);
+    }
+
+    // Destroys all entries, keeping the storage around for re-use
+    void Clear()
+    {
+        m_table.Clear();
+    }
+
+    // Make room for count entries without rehashing
+    void Reserve(uint64 count)
+    {
+        m_table.Reserve(count);
+    }
+
+    uint64 Size() const
+    {
+        return m_table.Size();
+    }
+
+    uint64 Capacity() const
+    {
+        return m_table.Capacity();
+    }
+
+    bool IsEmpty() const
+    {
+        return m_table.Size() == 0;
+    }
+
+    Allocator* GetAllocator() const
+    {
+        return m_table.GetAllocator();
+    }
+
+    // Iteration order is unspecified. Don't insert or remove while iterating.
+    Iterator begin()
+    {
+        return Iterator(&m_table, 0);
+    }
+
+    Iterator end()
+    {
+        return Iterator(&m_table, m_table.Capacity());
+    }
+
+    ConstIterator begin() const
+    {
+        return ConstIterator(&m_table, 0);
+    }
+
+    ConstIterator end() const
+    {
+        return ConstIterator(&m_table, m_table.Capacity());
+    }
+};
+
+template <typename K, typename Hasher = Hash<K>>
+class HashSet
+{
+    using Table = Internal::HashTable<K, Internal::HashSetPolicy<K>, Hasher>;
+    Table m_table;
+
+  public:
+    // Keys can't be modified in place, that would break the table
+    using Iterator = Internal::HashTableIterator<Table, const K>;
+
+    HashSet() = default;
+
+    // The allocator must outlive the set
+    explicit HashSet(Allocator* allocator)
+        : m_table(allocator)
+    {
+    }
+
+    bool Contains(const K& key) const
+    {
+        return m_table.Find(key) != nullptr;
+    }
+
+    // Returns true if key was inserted, false if it was already present
+    bool Insert(const K& key)
+    {
+        return m_table.TryEmplace(key, key).inserted;
+    }
+
+    bool Insert(K&& key)
+    {
+        return m_table.TryEmplace(key, rsblMove(key)).inserted;
+    }
+
+    bool Remove(const K& key)
+    {
+        return m_table.Remove(key);
+    }
+
+    void Clear()
+    {
+        m_table.Clear();
+    }
+
+    void Reserve(uint64 count)
+    {
+        m_table.Reserve(count);
+    }
+
+    uint64 Size() const
+    {
+        return m_table.Size();
+    }
+
+    uint64 Capacity() const
+    {
+        return m_table.Capacity();
+    }
+
+    bool IsEmpty() const
+    {
+        return m_table.Size() == 0;
+    }
+
+    Allocator* GetAllocator() const
+    {
+        return m_table.GetAllocator();
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(&m_table, 0);
+    }
+
+    Iterator end() const
+    {
+        return Iterator(&m_table, m_table.Capacity());
+    }
+};
+
+template <typename K, typename V, typename Hasher>
+struct TriviallyRelocatable<HashMap<K, V, Hasher>>
+{
+    static constexpr bool value = true;
+};
+
+template <typename K, typename Hasher>
+struct TriviallyRelocatable<HashSet<K, Hasher>>
+{
+    static constexpr bool value = true;
+};
+
+} // namespace rsbl
@@ -0,0 +1,76 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-int-types.h"
+
+namespace rsbl
+{
+
+// Hash an arbitrary run of bytes. Fast at every size (wyhash-style under 256 bytes, an xxh3-style
+// SIMD loop at memory bandwidth above) and the same value on every platform and build, so hashes
+// can key caches on disk. Not for anything that needs to resist an attacker.
+uint64 HashBytes(const void* data, uint64 size, uint64 seed = 0);
+
+// Hash a null-terminated string's contents
+uint64 HashString(const char* str, uint64 seed = 0);
+
+// Finalizer that spreads entropy across all 64 bits. Hash tables use both the low and high bits
+// of a hash, so integer keys can't just be returned as-is.
+constexpr uint64 HashMix(uint64 value)
+{
+    // murmur3 fmix64
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+constexpr uint64 HashCombine(uint64 seed, uint64 value)
+{
+    return HashMix(seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2)));
+}
+
+// Hash functor used by HashMap/HashSet. Specialize this for custom key types.
+template <typename T>
+struct Hash;
+
+#define RSBL_INTEGER_HASH(Type) \
+    template <> \
+    struct Hash<Type> \
+    { \
+        uint64 operator()(Type value) const \
+        { \
+            return HashMix(static_cast<uint64>(value)); \
+        } \
+    }
+
+RSBL_INTEGER_HASH(bool);
+RSBL_INTEGER_HASH(char);
+RSBL_INTEGER_HASH(signed char);
+RSBL_INTEGER_HASH(unsigned char);
+RSBL_INTEGER_HASH(short);
+RSBL_INTEGER_HASH(unsigned short);
+RSBL_INTEGER_HASH(int);
+RSBL_INTEGER_HASH(unsigned int);
+RSBL_INTEGER_HASH(long);
+RSBL_INTEGER_HASH(unsigned long);
+RSBL_INTEGER_HASH(long long);
+RSBL_INTEGER_HASH(unsigned long long);
+
+#undef RSBL_INTEGER_HASH
+
+// Pointers hash by address (not by the pointed-to contents, use HashString for that)
+template <typename T>
+struct Hash<T*>
+{
+    uint64 operator()(const T* value) const
+    {
+        return HashMix(reinterpret_cast<uint64>(value));
+    }
+};
+
+} // namespace rsbl
@@ -7,8 +7,11 @@
 
 // TODO: constructors that take in fixed size arrays
 // TODO: interop with DirectXMath types
-// TODO: float + double vector types
-// TODO: support for SIMD? probably separate types
+// TODO: double vector types
+
+// These are storage types, laid out exactly like their HLSL namesakes so they can go straight
+// into vertex and constant buffers. Math happens on the register types in rsbl-simd.h. Both are
+// constexpr, so tables of either can be built at compile time.
 
 namespace rsbl
 {
@@ -20,12 +23,12 @@ struct uint2
     uint32 y;
 
     uint2() = default;
-    explicit uint2(uint32 v)
+    constexpr explicit uint2(uint32 v)
         : x(v)
         , y(v)
     {
     }
-    uint2(uint32 x_, uint32 y_)
+    constexpr uint2(uint32 x_, uint32 y_)
         : x(x_)
         , y(y_)
     {
@@ -40,13 +43,13 @@ struct uint3
     uint32 z;
 
     uint3() = default;
-    explicit uint3(uint32 v)
+    constexpr explicit uint3(uint32 v)
         : x(v)
         , y(v)
         , z(v)
     {
     }
-    uint3(uint32 x_, uint32 y_, uint32 z_)
+    constexpr uint3(uint32 x_, uint32 y_, uint32 z_)
         : x(x_)
         , y(y_)
         , z(z_)
@@ -63,14 +66,14 @@ struct uint4
     uint32 w;
 
     uint4() = default;
-    explicit uint4(uint32 v)
+    constexpr explicit uint4(uint32 v)
         : x(v)
         , y(v)
         , z(v)
         , w(v)
     {
     }
-    uint4(uint32 x_, uint32 y_, uint32 z_, uint32 w_)
+    constexpr uint4(uint32 x_, uint32 y_, uint32 z_, uint32 w_)
         : x(x_)
         , y(y_)
         , z(z_)
@@ -86,12 +89,12 @@ struct int2
     int32 y;
 
     int2() = default;
-    explicit int2(int32 v)
+    constexpr explicit int2(int32 v)
         : x(v)
         , y(v)
     {
     }
-    int2(int32 x_, int32 y_)
+    constexpr int2(int32 x_, int32 y_)
         : x(x_)
         , y(y_)
     {
@@ -106,13 +109,13 @@ struct int3
     int32 z;
 
     int3() = default;
-    explicit int3(int32 v)
+    constexpr explicit int3(int32 v)
         : x(v)
         , y(v)
         , z(v)
     {
     }
-    int3(int32 x_, int32 y_, int32 z_)
+    constexpr int3(int32 x_, int32 y_, int32 z_)
         : x(x_)
         , y(y_)
         , z(z_)
@@ -129,14 +132,80 @@ struct int4
     int32 w;
 
     int4() = default;
-    explicit int4(int32 v)
+    constexpr explicit int4(int32 v)
+        : x(v)
+        , y(v)
+        , z(v)
+        , w(v)
+    {
+    }
+    constexpr int4(int32 x_, int32 y_, int32 z_, int32 w_)
+        : x(x_)
+        , y(y_)
+        , z(z_)
+        , w(w_)
+    {
+    }
+};
+
+// 2-component float vector
+struct float2
+{
+    float x;
+    float y;
+
+    float2() = default;
+    constexpr explicit float2(float v)
+        : x(v)
+        , y(v)
+    {
+    }
+    constexpr float2(float x_, float y_)
+        : x(x_)
+        , y(y_)
+    {
+    }
+};
+
+// 3-component float vector
+struct float3
+{
+    float x;
+    float y;
+    float z;
+
+    float3() = default;
+    constexpr explicit float3(float v)
+        : x(v)
+        , y(v)
+        , z(v)
+    {
+    }
+    constexpr float3(float x_, float y_, float z_)
+        : x(x_)
+        , y(y_)
+        , z(z_)
+    {
+    }
+};
+
+// 4-component float vector
+struct float4
+{
+    float x;
+    float y;
+    float z;
+    float w;
+
+    float4() = default;
+    constexpr explicit float4(float v)
         : x(v)
         , y(v)
         , z(v)
         , w(v)
     {
     }
-    int4(int32 x_, int32 y_, int32 z_, int32 w_)
+    constexpr float4(float x_, float y_, float z_, float w_)
         : x(x_)
         , y(y_)
         , z(z_)
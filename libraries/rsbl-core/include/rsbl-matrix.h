@@ -0,0 +1,269 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-array-view.h"
+#include "rsbl-int-types.h"
+#include "rsbl-math-types.h"
+#include "rsbl-simd.h"
+
+// Matrices and quaternions on top of simd::float4.
+// - Column vectors: transformed = M * v, and A * B applies B first. float4x4 stores its columns,
+//   so its memory layout is column-major, same as glTF and GLSL.
+// - float3x4 is an affine transform stored as three rows (upper 3x4 of a float4x4), which is the
+//   layout GPU instance and raytracing transforms want. The bottom row is implicitly (0 0 0 1).
+// - quat is (x y z w) with w the scalar part. Rotation functions expect unit quaternions.
+// Small operations are inline and constexpr, apart from the ones that need sinf/cosf. The heavier
+// kernels live in rsbl-matrix.cpp and only run at runtime.
+
+namespace rsbl
+{
+namespace simd
+{
+    struct quat
+    {
+        float4 xyzw;
+
+        quat() = default;
+
+        constexpr explicit quat(float4 v)
+            : xyzw(v)
+        {
+        }
+
+        constexpr quat(float x, float y, float z, float w)
+            : xyzw(x, y, z, w)
+        {
+        }
+    };
+
+    struct float4x4
+    {
+        float4 columns[4];
+
+        float4x4() = default;
+
+        constexpr float4x4(float4 c0, float4 c1, float4 c2, float4 c3)
+            : columns{c0, c1, c2, c3}
+        {
+        }
+    };
+
+    struct float3x4
+    {
+        float4 rows[3];
+
+        float3x4() = default;
+
+        constexpr float3x4(float4 r0, float4 r1, float4 r2)
+            : rows{r0, r1, r2}
+        {
+        }
+    };
+
+    // Quaternions
+
+    constexpr quat QuatIdentity()
+    {
+        return quat(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    // axis must be unit length, angle is in radians
+    inline quat QuatFromAxisAngle(float4 axis, float angle)
+    {
+        const float half = angle * 0.5f;
+        return quat(SetW(axis * sinf(half), cosf(half)));
+    }
+
+    // a * b rotates by b, then by a
+    constexpr quat operator*(quat a, quat b)
+    {
+        const float4 va = a.xyzw;
+        const float4 vb = b.xyzw;
+        const float4 vector = SplatW(va) * vb + SplatW(vb) * va + Cross3(va, vb);
+        return quat(SetW(vector, va.W() * vb.W() - Dot3(va, vb)));
+    }
+
+    constexpr quat Conjugate(quat q)
+    {
+        return quat(q.xyzw * float4(-1.0f, -1.0f, -1.0f, 1.0f));
+    }
+
+    constexpr quat Normalize(quat q)
+    {
+        return quat(Normalize4(q.xyzw));
+    }
+
+    constexpr float Dot(quat a, quat b)
+    {
+        return Dot4(a.xyzw, b.xyzw);
+    }
+
+    // Rotates the xyz of v, w of the result is 0
+    constexpr float4 Rotate(quat q, float4 v)
+    {
+        // v + 2 * cross(q.xyz, cross(q.xyz, v) + q.w * v)
+        const float4 t = Cross3(q.xyzw, v) + SplatW(q.xyzw) * v;
+        return SetW(v + 2.0f * Cross3(q.xyzw, t), 0.0f);
+    }
+
+    // Normalized lerp along the shortest arc. Cheap and good enough for small angles.
+    constexpr quat Nlerp(quat a, quat b, float t)
+    {
+        const float4 target = Dot(a, b) < 0.0f ? -b.xyzw : b.xyzw;
+        return Normalize(quat(Lerp(a.xyzw, target, t)));
+    }
+
+    quat Slerp(quat a, quat b, float t);
+
+    // Matrix 3x3 part must be a pure rotation (orthonormal, no scale)
+    quat QuatFromRotationMatrix(const float4x4& m);
+
+    // float4x4
+
+    constexpr float4x4 Identity4x4()
+    {
+        return float4x4(float4(1.0f, 0.0f, 0.0f, 0.0f), float4(0.0f, 1.0f, 0.0f, 0.0f),
+                        float4(0.0f, 0.0f, 1.0f, 0.0f), float4(0.0f, 0.0f, 0.0f, 1.0f));
+    }
+
+    // 16 floats, column-major (glTF node.matrix order)
+    constexpr float4x4 Load4x4(const float* columnMajor)
+    {
+        return float4x4(LoadUnaligned(columnMajor), LoadUnaligned(columnMajor + 4),
+                        LoadUnaligned(columnMajor + 8), LoadUnaligned(columnMajor + 12));
+    }
+
+    constexpr void Store4x4(const float4x4& m, float* columnMajor)
+    {
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            StoreUnaligned(m.columns[i], columnMajor + i * 4);
+        }
+    }
+
+    // m * v
+    constexpr float4 Transform(const float4x4& m, float4 v)
+    {
+        float4 result = m.columns[0] * SplatX(v);
+        result = MultiplyAdd(m.columns[1], SplatY(v), result);
+        result = MultiplyAdd(m.columns[2], SplatZ(v), result);
+        return MultiplyAdd(m.columns[3], SplatW(v), result);
+    }
+
+    // Treats v as a point (w = 1), w of the result is whatever the matrix makes it
+    constexpr float4 TransformPoint(const float4x4& m, float4 p)
+    {
+        float4 result = MultiplyAdd(m.columns[0], SplatX(p), m.columns[3]);
+        result = MultiplyAdd(m.columns[1], SplatY(p), result);
+        return MultiplyAdd(m.columns[2], SplatZ(p), result);
+    }
+
+    // Treats v as a direction (w = 0), translation doesn't apply
+    constexpr float4 TransformVector(const float4x4& m, float4 v)
+    {
+        float4 result = m.columns[0] * SplatX(v);
+        result = MultiplyAdd(m.columns[1], SplatY(v), result);
+        return MultiplyAdd(m.columns[2], SplatZ(v), result);
+    }
+
+    constexpr float4x4 operator*(const float4x4& a, const float4x4& b)
+    {
+        return float4x4(Transform(a, b.columns[0]), Transform(a, b.columns[1]),
+                        Transform(a, b.columns[2]), Transform(a, b.columns[3]));
+    }
+
+    constexpr float4x4 Transpose(const float4x4& m)
+    {
+        float4x4 result = m;
+        Transpose(result.columns[0], result.columns[1], result.columns[2], result.columns[3]);
+        return result;
+    }
+
+    float Determinant(const float4x4& m);
+
+    // General inverse. Singular matrices give infinities/NaNs, check Determinant first if that can
+    // happen.
+    float4x4 Inverse(const float4x4& m);
+
+    // Much cheaper inverse for matrices with a (0 0 0 1) bottom row, like any TRS
+    float4x4 InverseAffine(const float4x4& m);
+
+    // Scale, then rotate, then translate
+    float4x4 ComposeTrs(float4 translation, quat rotation, float4 scale);
+
+    // Inverse of ComposeTrs. Shear is lost, and a negative determinant is folded into scale.x.
+    void DecomposeTrs(const float4x4& m, float4& translation, quat& rotation, float4& scale);
+
+    // float3x4
+
+    constexpr float3x4 Identity3x4()
+    {
+        return float3x4(float4(1.0f, 0.0f, 0.0f, 0.0f), float4(0.0f, 1.0f, 0.0f, 0.0f),
+                        float4(0.0f, 0.0f, 1.0f, 0.0f));
+    }
+
+    constexpr float3x4 ToFloat3x4(const float4x4& m)
+    {
+        float4x4 rows = Transpose(m);
+        return float3x4(rows.columns[0], rows.columns[1], rows.columns[2]);
+    }
+
+    constexpr float4x4 ToFloat4x4(const float3x4& m)
+    {
+        float4x4 columns(m.rows[0], m.rows[1], m.rows[2], float4(0.0f, 0.0f, 0.0f, 1.0f));
+        return Transpose(columns);
+    }
+
+    constexpr float4 TransformPoint(const float3x4& m, float4 p)
+    {
+        const float4 point = SetW(p, 1.0f);
+        return float4(Dot4(m.rows[0], point), Dot4(m.rows[1], point), Dot4(m.rows[2], point),
+                      1.0f);
+    }
+
+    constexpr float4 TransformVector(const float3x4& m, float4 v)
+    {
+        return float4(Dot3(m.rows[0], v), Dot3(m.rows[1], v), Dot3(m.rows[2], v), 0.0f);
+    }
+
+    constexpr float3x4 operator*(const float3x4& a, const float3x4& b)
+    {
+        const float4 translationOnly(0.0f, 0.0f, 0.0f, 1.0f);
+        float3x4 result;
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            const float4 row = a.rows[i];
+            float4 combined = MultiplyAdd(SplatX(row), b.rows[0], row * translationOnly);
+            combined = MultiplyAdd(SplatY(row), b.rows[1], combined);
+            result.rows[i] = MultiplyAdd(SplatZ(row), b.rows[2], combined);
+        }
+        return result;
+    }
+
+    // Batched kernels
+
+    // Transforms points in place, treating the matrix as affine (bottom row 0 0 0 1)
+    void TransformPoints(ArrayView<rsbl::float3> points, const float4x4& m);
+
+    // Same, from one array into another of the same size. They may be the same array, but must
+    // not partially overlap.
+    void TransformPoints(ArrayView<const rsbl::float3> points, ArrayView<rsbl::float3> out,
+                         const float4x4& m);
+
+    // Same for points stored as separate x, y and z arrays (SoaArray columns, for instance), all
+    // the same size. Outputs may be the input arrays. Runs the widest kernel the CPU supports, up
+    // to 16 points per instruction with AVX-512.
+    void TransformPointsSoa(ArrayView<const float> xs, ArrayView<const float> ys,
+                            ArrayView<const float> zs, ArrayView<float> outXs,
+                            ArrayView<float> outYs, ArrayView<float> outZs, const float4x4& m);
+
+    constexpr uint32 kNoParent = ~0u;
+
+    // world[i] = world[parents[i]] * local[i], or local[i] for roots. Parents must come before
+    // their children, which is how glTF importers and most scene formats can order nodes.
+    void ComputeWorldMatrices(ArrayView<const float4x4> local, ArrayView<const uint32> parents,
+                              ArrayView<float4x4> world);
+} // namespace simd
+} // namespace rsbl
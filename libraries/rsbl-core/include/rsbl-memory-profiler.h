@@ -0,0 +1,82 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-array-view.h"
+#include "rsbl-dynamic-array.h"
+#include "rsbl-int-types.h"
+#include "rsbl-memory-tracking.h"
+#include "rsbl-result.h"
+
+// Sampled allocation call stacks, for finding what leaks or bloats over a long session. While
+// the profiler runs, every Nth allocation on each thread keeps its call stack until it's freed.
+// A snapshot groups the live samples by tag and call stack, and the diff of two snapshots taken
+// minutes apart is what grew in between:
+//
+//     StartMemoryProfiler(64);
+//     MemorySnapshot before = TakeMemorySnapshot();
+//     ... play for a while ...
+//     MemorySnapshot after = TakeMemorySnapshot();
+//     DynamicArray<MemorySiteDiff> grown = DiffMemorySnapshots(before, after);
+//     WriteMemorySnapshotDiff(grown, "memory-diff.txt");
+//
+// Stacks come from RtlCaptureStackBackTrace on Windows and backtrace() elsewhere, and are written
+// out with symbols where the platform has them. Needs memory tracking, with tracking disabled
+// nothing is sampled. Over-aligned new isn't tracked, so it isn't sampled either.
+//
+// Frees look the pointer up in the samples while there are any, so expect allocation heavy code
+// to slow down while it runs. Stopped, the cost is a relaxed load per allocation and free.
+
+namespace rsbl
+{
+
+constexpr uint32 kMemoryStackDepth = 16;
+
+// Allocations made from the same call stack under the same tag
+struct MemoryAllocationSite
+{
+    uint64 key = 0; // Hash of the tag and stack, what diffs match on
+    MemoryTag tag = MemoryTag::Core;
+    uint32 frameCount = 0;
+    void* frames[kMemoryStackDepth] = {}; // Innermost first
+    uint64 count = 0;                     // Live samples
+    uint64 bytes = 0;                     // Their bytes
+};
+
+struct MemorySnapshot
+{
+    uint32 sampleInterval = 0; // Each sample stands for about this many allocations
+    uint64 sampledBytes = 0;
+    uint64 sampledCount = 0;
+    DynamicArray<MemoryAllocationSite> sites; // Largest first
+};
+
+struct MemorySiteDiff
+{
+    MemoryAllocationSite site; // As of the later snapshot, so empty if it's gone since
+    int64 countDelta = 0;
+    int64 bytesDelta = 0;
+};
+
+// Samples one in every sample_interval allocations on each thread, 1 for all of them. Samples
+// from an earlier run are forgotten.
+void StartMemoryProfiler(uint32 sample_interval);
+
+// Stops sampling and forgets the samples
+void StopMemoryProfiler();
+
+bool IsMemoryProfilerRunning();
+
+// The live samples, grouped by site
+MemorySnapshot TakeMemorySnapshot();
+
+// Sites whose live samples changed from before to after, most growth first
+DynamicArray<MemorySiteDiff> DiffMemorySnapshots(const MemorySnapshot& before,
+                                                 const MemorySnapshot& after);
+
+// Text, a site per paragraph with its tag, bytes and count, then a line per frame
+Result<> WriteMemorySnapshot(const MemorySnapshot& snapshot, const char* path);
+Result<> WriteMemorySnapshotDiff(ArrayView<const MemorySiteDiff> diff, const char* path);
+
+} // namespace rsbl
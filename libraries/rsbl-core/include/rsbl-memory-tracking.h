@@ -0,0 +1,126 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-int-types.h"
+
+// Tracking is on unless explicitly disabled, same as asserts. With tracking disabled, the stats
+// all read as zero and GetDefaultAllocator hands out the plain heap allocator.
+#if !defined(RSBL_MEMORY_TRACKING_DISABLED)
+    #define RSBL_MEMORY_TRACKING_ENABLED
+#endif
+
+// TODO: the counters are shared atomics, per-thread counters would be cheaper under contention
+
+namespace rsbl
+{
+
+// Subsystem an allocation is charged to
+enum class MemoryTag : uint8
+{
+    Core,
+    Ga,
+    Platform,
+    Asset,
+    Scene,
+    Jobs,
+
+    Count,
+};
+
+const char* MemoryTagName(MemoryTag tag);
+
+struct MemoryStats
+{
+    uint64 liveBytes = 0;
+    uint64 liveAllocations = 0;
+    uint64 peakBytes = 0; // High-water mark of liveBytes
+    uint64 totalAllocations = 0;
+
+    // Allocations made since the last MemoryTrackingEndFrame
+    uint64 frameAllocations = 0;
+    uint64 frameBytes = 0;
+
+    // The previous frame, and the worst frame seen so far
+    uint64 lastFrameAllocations = 0;
+    uint64 lastFrameBytes = 0;
+    uint64 peakFrameAllocations = 0;
+    uint64 peakFrameBytes = 0;
+
+    uint64 budgetBytes = 0; // 0 means no budget
+};
+
+// Allocations are charged to the tag of the scope they are made in. Each thread starts out in
+// MemoryTag::Core, and anything allocated outside a scope (including third-party code that goes
+// through global new) lands there.
+MemoryTag GetCurrentMemoryTag();
+
+class MemoryTagScope
+{
+  public:
+    explicit MemoryTagScope(MemoryTag tag);
+    ~MemoryTagScope();
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+  private:
+    MemoryTag m_previous;
+};
+
+// Allocator that charges everything it hands out to a fixed tag. The tag is captured when the
+// allocator is picked, so frees are charged back to the same tag no matter which scope they
+// happen in. Wrap arenas or pools in one to track them separately from their backing allocator.
+class TrackingAllocator : public Allocator
+{
+  public:
+    constexpr TrackingAllocator(MemoryTag tag, Allocator* backing)
+        : m_backing(backing)
+        , m_tag(tag)
+    {
+    }
+
+    void* Allocate(uint64 size, uint64 alignment) override;
+    void Free(void* ptr, uint64 size, uint64 alignment) override;
+    void* Reallocate(void* ptr, uint64 old_size, uint64 new_size, uint64 alignment) override;
+
+    MemoryTag Tag() const
+    {
+        return m_tag;
+    }
+
+  private:
+    Allocator* m_backing = nullptr;
+    MemoryTag m_tag = MemoryTag::Core;
+};
+
+// Heap allocator that charges to the given tag. GetDefaultAllocator returns the one for the
+// current scope's tag.
+Allocator* GetTaggedAllocator(MemoryTag tag);
+
+// For memory that doesn't go through an rsbl allocator, e.g. GPU heaps
+void RecordAllocation(MemoryTag tag, uint64 size);
+void RecordFree(MemoryTag tag, uint64 size);
+
+MemoryStats GetMemoryStats(MemoryTag tag);
+
+// Brings every tag's peakBytes down to its liveBytes, so the next peak is that of whatever runs
+// from here, e.g. one asset's load rather than the worst since startup
+void ResetMemoryPeaks();
+
+// A tag over budget is reported with a warning at the end of each frame
+void SetMemoryBudget(MemoryTag tag, uint64 budget_bytes);
+bool IsOverMemoryBudget(MemoryTag tag);
+
+// Call once per frame. Rolls the per-frame counters over, warns about tags over budget, and
+// dumps all stats through RSBL_LOG_INFO every SetMemoryStatsLogInterval frames.
+void MemoryTrackingEndFrame();
+
+// 0 disables the periodic dump
+void SetMemoryStatsLogInterval(uint32 frame_count);
+
+void LogMemoryStats();
+
+} // namespace rsbl
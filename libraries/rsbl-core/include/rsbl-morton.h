@@ -0,0 +1,248 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-array-view.h"
+#include "rsbl-bounds.h"
+#include "rsbl-int-types.h"
+#include "rsbl-math-types.h"
+#include "rsbl-simd-config.h"
+
+// Space filling curves, for sorting things so that neighbours in space end up neighbours in
+// memory: meshlets and draws for GPU cache locality, primitives for a linear BVH.
+// - Morton (Z-order) codes interleave the coordinate bits. Cheap, and a prefix of the code is a
+//   node of the implicit quadtree/octree, which is what LBVH builders split on.
+// - Hilbert indices never jump: consecutive indices are always adjacent cells, so locality is
+//   better than Morton. They loop over the bits though, so cost about 100x a pdep Morton code.
+// 2D codes take the full 32 bits per axis, 3D codes the low 21 bits, both into a uint64.
+//
+// The single value functions are constexpr. At runtime they use pdep/pext when the whole build
+// targets BMI2 (/arch:AVX2), and shifts and masks otherwise. The array versions pick pdep at
+// runtime on CPUs where it's fast.
+
+namespace rsbl
+{
+
+namespace Internal
+{
+    constexpr uint64 kMortonMask2 = 0x5555555555555555ull;
+    constexpr uint64 kMortonMask3 = 0x1249249249249249ull;
+
+    // Bit i of value moves to bit 2i
+    constexpr uint64 SpreadBits2(uint32 value)
+    {
+        uint64 x = value;
+        x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+        x = (x | (x << 8)) & 0x00ff00ff00ff00ffull;
+        x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0full;
+        x = (x | (x << 2)) & 0x3333333333333333ull;
+        x = (x | (x << 1)) & kMortonMask2;
+        return x;
+    }
+
+    // Inverse of SpreadBits2, the odd bits are ignored
+    constexpr uint32 CompactBits2(uint64 x)
+    {
+        x &= kMortonMask2;
+        x = (x | (x >> 1)) & 0x3333333333333333ull;
+        x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0full;
+        x = (x | (x >> 4)) & 0x00ff00ff00ff00ffull;
+        x = (x | (x >> 8)) & 0x0000ffff0000ffffull;
+        x = (x | (x >> 16)) & 0x00000000ffffffffull;
+        return static_cast<uint32>(x);
+    }
+
+    // Bit i of the low 21 bits of value moves to bit 3i
+    constexpr uint64 SpreadBits3(uint32 value)
+    {
+        uint64 x = value & 0x1fffff;
+        x = (x | (x << 32)) & 0x001f00000000ffffull;
+        x = (x | (x << 16)) & 0x001f0000ff0000ffull;
+        x = (x | (x << 8)) & 0x100f00f00f00f00full;
+        x = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+        x = (x | (x << 2)) & kMortonMask3;
+        return x;
+    }
+
+    // Inverse of SpreadBits3
+    constexpr uint32 CompactBits3(uint64 x)
+    {
+        x &= kMortonMask3;
+        x = (x | (x >> 2)) & 0x10c30c30c30c30c3ull;
+        x = (x | (x >> 4)) & 0x100f00f00f00f00full;
+        x = (x | (x >> 8)) & 0x001f0000ff0000ffull;
+        x = (x | (x >> 16)) & 0x001f00000000ffffull;
+        x = (x | (x >> 32)) & 0x00000000001fffffull;
+        return static_cast<uint32>(x);
+    }
+} // namespace Internal
+
+// Morton codes. x lands in the lowest bit.
+
+constexpr uint64 MortonEncode2(uint2 p)
+{
+#if RSBL_SIMD_BMI2
+    if !consteval
+    {
+        return _pdep_u64(p.x, Internal::kMortonMask2) |
+               _pdep_u64(p.y, Internal::kMortonMask2 << 1);
+    }
+#endif
+    return Internal::SpreadBits2(p.x) | (Internal::SpreadBits2(p.y) << 1);
+}
+
+constexpr uint2 MortonDecode2(uint64 code)
+{
+#if RSBL_SIMD_BMI2
+    if !consteval
+    {
+        return uint2(static_cast<uint32>(_pext_u64(code, Internal::kMortonMask2)),
+                     static_cast<uint32>(_pext_u64(code, Internal::kMortonMask2 << 1)));
+    }
+#endif
+    return uint2(Internal::CompactBits2(code), Internal::CompactBits2(code >> 1));
+}
+
+// Only the low 21 bits of each coordinate are used
+constexpr uint64 MortonEncode3(uint3 p)
+{
+#if RSBL_SIMD_BMI2
+    if !consteval
+    {
+        return _pdep_u64(p.x, Internal::kMortonMask3) |
+               _pdep_u64(p.y, Internal::kMortonMask3 << 1) |
+               _pdep_u64(p.z, Internal::kMortonMask3 << 2);
+    }
+#endif
+    return Internal::SpreadBits3(p.x) | (Internal::SpreadBits3(p.y) << 1) |
+           (Internal::SpreadBits3(p.z) << 2);
+}
+
+constexpr uint3 MortonDecode3(uint64 code)
+{
+#if RSBL_SIMD_BMI2
+    if !consteval
+    {
+        return uint3(static_cast<uint32>(_pext_u64(code, Internal::kMortonMask3)),
+                     static_cast<uint32>(_pext_u64(code, Internal::kMortonMask3 << 1)),
+                     static_cast<uint32>(_pext_u64(code, Internal::kMortonMask3 << 2)));
+    }
+#endif
+    return uint3(Internal::CompactBits3(code), Internal::CompactBits3(code >> 1),
+                 Internal::CompactBits3(code >> 2));
+}
+
+// points and codes must be the same size
+void MortonEncode2(ArrayView<const uint2> points, ArrayView<uint64> codes);
+void MortonEncode3(ArrayView<const uint3> points, ArrayView<uint64> codes);
+
+// Quantizes each point to a 21-bit grid over bounds, then takes its Morton code. Points outside
+// bounds clamp to the edge, flat axes map to 0. This is the first step of a linear BVH build.
+void MortonEncode3(ArrayView<const float3> points, const Aabb& bounds, ArrayView<uint64> codes);
+
+// Hilbert indices, using Skilling's transposed form ("Programming the Hilbert curve", 2004). The
+// curve depends on its order, so a point's index is only comparable to others from the same
+// bits. Coordinates must be below 2^bits.
+
+namespace Internal
+{
+    // Coordinates to the transposed Hilbert index, in place
+    template <uint32 N>
+    constexpr void AxesToTranspose(uint32 (&x)[N], uint32 bits)
+    {
+        // Inverse undo
+        for (uint32 q = 1u << (bits - 1); q > 1; q >>= 1)
+        {
+            const uint32 p = q - 1;
+            for (uint32 i = 0; i < N; ++i)
+            {
+                // Invert the low bits of x[0] if bit q of x[i] is set, otherwise swap them with
+                // x[i]'s. Branchless, the bits are random so a branch mispredicts half the time.
+                const uint32 invert = 0u - static_cast<uint32>((x[i] & q) != 0);
+                const uint32 t = (x[0] ^ x[i]) & p & ~invert;
+                x[0] ^= t | (p & invert);
+                x[i] ^= t;
+            }
+        }
+
+        // Gray encode
+        for (uint32 i = 1; i < N; ++i)
+        {
+            x[i] ^= x[i - 1];
+        }
+        uint32 t = 0;
+        for (uint32 q = 1u << (bits - 1); q > 1; q >>= 1)
+        {
+            t ^= (q - 1) & (0u - static_cast<uint32>((x[N - 1] & q) != 0));
+        }
+        for (uint32 i = 0; i < N; ++i)
+        {
+            x[i] ^= t;
+        }
+    }
+
+    // Inverse of AxesToTranspose
+    template <uint32 N>
+    constexpr void TransposeToAxes(uint32 (&x)[N], uint32 bits)
+    {
+        // Gray decode
+        const uint32 t = x[N - 1] >> 1;
+        for (uint32 i = N - 1; i > 0; --i)
+        {
+            x[i] ^= x[i - 1];
+        }
+        x[0] ^= t;
+
+        // Undo excess work
+        for (uint64 q = 2; q < (uint64(1) << bits); q <<= 1)
+        {
+            const uint32 p = static_cast<uint32>(q - 1);
+            for (uint32 i = N; i-- > 0;)
+            {
+                const uint32 invert = 0u - static_cast<uint32>((x[i] & q) != 0);
+                const uint32 swap = (x[0] ^ x[i]) & p & ~invert;
+                x[0] ^= swap | (p & invert);
+                x[i] ^= swap;
+            }
+        }
+    }
+} // namespace Internal
+
+// bits is 1 to 32
+constexpr uint64 HilbertEncode2(uint2 p, uint32 bits = 32)
+{
+    uint32 x[2] = {p.x, p.y};
+    Internal::AxesToTranspose(x, bits);
+    // The transposed form has the top index bit in x[0], so it takes the odd positions
+    return MortonEncode2(uint2(x[1], x[0]));
+}
+
+constexpr uint2 HilbertDecode2(uint64 index, uint32 bits = 32)
+{
+    const uint2 transposed = MortonDecode2(index);
+    uint32 x[2] = {transposed.y, transposed.x};
+    Internal::TransposeToAxes(x, bits);
+    return uint2(x[0], x[1]);
+}
+
+// bits is 1 to 21
+constexpr uint64 HilbertEncode3(uint3 p, uint32 bits = 21)
+{
+    uint32 x[3] = {p.x, p.y, p.z};
+    Internal::AxesToTranspose(x, bits);
+    return MortonEncode3(uint3(x[2], x[1], x[0]));
+}
+
+constexpr uint3 HilbertDecode3(uint64 index, uint32 bits = 21)
+{
+    const uint3 transposed = MortonDecode3(index);
+    uint32 x[3] = {transposed.z, transposed.y, transposed.x};
+    Internal::TransposeToAxes(x, bits);
+    return uint3(x[0], x[1], x[2]);
+}
+
+// points and indices must be the same size
+void HilbertEncode3(ArrayView<const uint3> points, ArrayView<uint64> indices, uint32 bits = 21);
+
+} // namespace rsbl
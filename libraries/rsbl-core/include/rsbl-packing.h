@@ -0,0 +1,140 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-array-view.h"
+#include "rsbl-int-types.h"
+#include "rsbl-math-types.h"
+#include "rsbl-matrix.h"
+
+#include <cmath>
+
+// Vertex attribute quantization: half floats, normalized integers, octahedral normals and
+// quaternion tangent frames. Conversions follow the D3D12/Vulkan rules, so GPU-side decoding
+// through the matching vertex format gets the same values back:
+// - Rounding is to nearest even.
+// - Out of range values clamp, NaN packs as 0.
+// - snorm decodes as max(v / max_value, -1), so the most negative value and the one above it both
+//   mean -1.
+// The single value functions are for odd attributes. The array versions are the fast path:
+// halves go through F16C or NEON, and normalized integers through SSE2 or NEON.
+
+namespace rsbl
+{
+
+// Half floats. Overflow becomes infinity, NaN stays NaN.
+
+uint16 FloatToHalf(float value);
+float HalfToFloat(uint16 half);
+
+// src and dst must be the same size
+void FloatsToHalves(ArrayView<const float> src, ArrayView<uint16> dst);
+void HalvesToFloats(ArrayView<const uint16> src, ArrayView<float> dst);
+
+// Normalized integers
+
+namespace Internal
+{
+    // Clamps to [low, high], NaN becomes 0
+    inline float ClampNormalized(float value, float low, float high)
+    {
+        if (!(value == value))
+        {
+            return 0.0f;
+        }
+        return value < low ? low : (value > high ? high : value);
+    }
+} // namespace Internal
+
+inline int8 PackSnorm8(float value)
+{
+    return static_cast<int8>(lrintf(Internal::ClampNormalized(value, -1.0f, 1.0f) * 127.0f));
+}
+
+inline uint8 PackUnorm8(float value)
+{
+    return static_cast<uint8>(lrintf(Internal::ClampNormalized(value, 0.0f, 1.0f) * 255.0f));
+}
+
+inline int16 PackSnorm16(float value)
+{
+    return static_cast<int16>(lrintf(Internal::ClampNormalized(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+inline uint16 PackUnorm16(float value)
+{
+    return static_cast<uint16>(lrintf(Internal::ClampNormalized(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+inline float UnpackSnorm8(int8 value)
+{
+    const float f = static_cast<float>(value) / 127.0f;
+    return f < -1.0f ? -1.0f : f;
+}
+
+inline float UnpackUnorm8(uint8 value)
+{
+    return static_cast<float>(value) / 255.0f;
+}
+
+inline float UnpackSnorm16(int16 value)
+{
+    const float f = static_cast<float>(value) / 32767.0f;
+    return f < -1.0f ? -1.0f : f;
+}
+
+inline float UnpackUnorm16(uint16 value)
+{
+    return static_cast<float>(value) / 65535.0f;
+}
+
+// src and dst must be the same size
+void PackSnorm8(ArrayView<const float> src, ArrayView<int8> dst);
+void PackUnorm8(ArrayView<const float> src, ArrayView<uint8> dst);
+void PackSnorm16(ArrayView<const float> src, ArrayView<int16> dst);
+void PackUnorm16(ArrayView<const float> src, ArrayView<uint16> dst);
+
+// Two rows of 16 bit codes, interpolated and mapped back through per-column ranges:
+// dst[i] = offsets[i] + scales[i] * lerp(a[i], b[i], t). This is how quantized keyframes decode,
+// t being how far between the two frames; with offsets 0 and scales 1 / 65535 it's a lerp of
+// unorm16 values. All the arrays must be the same size.
+void LerpDequantize16(ArrayView<const uint16> a, ArrayView<const uint16> b, float t,
+                      ArrayView<const float> offsets, ArrayView<const float> scales,
+                      ArrayView<float> dst);
+
+// Octahedral normals: the unit sphere folded onto the [-1, 1] square, which spreads precision
+// evenly over all directions. 2 x 16 bits is plenty for normals, 2 x 8 bits works for
+// tangent-space detail that doesn't need to be smooth.
+
+// normal must be unit length
+float2 OctahedralEncode(float3 normal);
+// Comes back unit length
+float3 OctahedralDecode(float2 encoded);
+
+// Two snorm16s, x in the low half. Matches an R16G16_SNORM attribute.
+uint32 PackOctahedral16(float3 normal);
+float3 UnpackOctahedral16(uint32 packed);
+
+// Two snorm8s, x in the low byte. Matches an R8G8_SNORM attribute.
+uint16 PackOctahedral8(float3 normal);
+float3 UnpackOctahedral8(uint16 packed);
+
+// normals and packed must be the same size
+void PackOctahedral16(ArrayView<const float3> normals, ArrayView<uint32> packed);
+
+// Tangent frames as a single quaternion (QTangent): the rotation from tangent space to the
+// mesh's space, with the sign of w holding the bitangent handedness. Replaces a normal and a
+// tangent with 4 values, 8 bytes as snorm16s.
+
+// handedness is the sign of the bitangent, bitangent = handedness * cross(normal, tangent), same
+// as the w of a glTF tangent. The tangent is made orthogonal to the normal first.
+simd::quat QTangentFromFrame(float3 normal, float3 tangent, float handedness);
+
+void QTangentToFrame(simd::quat qtangent, float3& normal, float3& tangent, float& handedness);
+
+// Four snorm16s, x in the low bits. Matches an R16G16B16A16_SNORM attribute.
+uint64 PackQTangent16(simd::quat qtangent);
+simd::quat UnpackQTangent16(uint64 packed);
+
+} // namespace rsbl
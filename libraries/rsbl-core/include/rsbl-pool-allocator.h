@@ -0,0 +1,140 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-core.h"
+#include "rsbl-int-types.h"
+#include "rsbl-ptr.h"
+
+#include <new>
+
+namespace rsbl
+{
+
+// Allocator for fixed-size slots. Slots are carved out of blocks from the backing allocator and
+// recycled through an intrusive free list, so alloc/free is a pointer pop/push.
+// The pool is thread-safe. With the thread cache enabled, each thread keeps a small magazine of
+// free slots and only takes the shared lock to refill or flush a batch, so high-churn objects
+// from many threads don't fight over a single lock.
+// Blocks are only released when the pool is destroyed, and every slot must be freed back to the
+// pool before then.
+class FixedPoolAllocator : public Allocator
+{
+  public:
+    FixedPoolAllocator(uint64 slot_size,
+                       uint64 slot_alignment,
+                       uint64 slots_per_block = 256,
+                       bool enable_thread_cache = false,
+                       Allocator* backing = GetDefaultAllocator());
+    ~FixedPoolAllocator() override;
+
+    // Slots can be cached per-thread, so the pool can't move or copy
+    FixedPoolAllocator(FixedPoolAllocator&&) = delete;
+    FixedPoolAllocator& operator=(FixedPoolAllocator&&) = delete;
+    FixedPoolAllocator(const FixedPoolAllocator&) = delete;
+    FixedPoolAllocator& operator=(const FixedPoolAllocator&) = delete;
+
+    // size and alignment must fit in a slot
+    void* Allocate(uint64 size, uint64 alignment) override;
+    void Free(void* ptr, uint64 size, uint64 alignment) override;
+
+    void* AllocateSlot();
+    void FreeSlot(void* ptr);
+
+    uint64 SlotSize() const
+    {
+        return m_slotSize;
+    }
+
+    uint64 BlockCount() const;
+
+  private:
+    struct SharedState;
+
+    void* PopShared();
+    void RefillMagazine(uint32 cache_index);
+    void FlushMagazine(uint32 cache_index);
+    bool AddBlock();
+
+    SharedState* m_shared = nullptr;
+    Allocator* m_backing = nullptr;
+    uint64 m_slotSize = 0;
+    uint64 m_slotAlignment = 0;
+    uint64 m_slotsPerBlock = 0;
+};
+
+template <typename T>
+class PoolAllocator;
+
+// Returns objects to the PoolAllocator they came from
+template <typename T>
+struct PoolDeleter
+{
+    PoolAllocator<T>* pool = nullptr;
+
+    void operator()(T* ptr) const
+    {
+        pool->Delete(ptr);
+    }
+};
+
+template <typename T>
+using PoolPtr = UniquePtr<T, PoolDeleter<T>>;
+
+// Typed object pool on top of FixedPoolAllocator
+template <typename T>
+class PoolAllocator
+{
+  public:
+    explicit PoolAllocator(uint64 objects_per_block = 256,
+                           bool enable_thread_cache = false,
+                           Allocator* backing = GetDefaultAllocator())
+        : m_pool(SlotSize(), alignof(T), objects_per_block, enable_thread_cache, backing)
+    {
+    }
+
+    template <typename... Args>
+    T* New(Args&&... args)
+    {
+        void* memory = m_pool.AllocateSlot();
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+        return new (memory) T(rsblForward(args)...);
+    }
+
+    void Delete(T* ptr)
+    {
+        if (ptr != nullptr)
+        {
+            ptr->~T();
+            m_pool.FreeSlot(ptr);
+        }
+    }
+
+    // UniquePtr that hands the object back to this pool
+    template <typename... Args>
+    PoolPtr<T> MakeUnique(Args&&... args)
+    {
+        return PoolPtr<T>(New(rsblForward(args)...), PoolDeleter<T>{this});
+    }
+
+    FixedPoolAllocator& GetAllocator()
+    {
+        return m_pool;
+    }
+
+  private:
+    // Free slots hold the free list link, so they need room for a pointer
+    static constexpr uint64 SlotSize()
+    {
+        return sizeof(T) < sizeof(void*) ? sizeof(void*) : sizeof(T);
+    }
+
+    FixedPoolAllocator m_pool;
+};
+
+} // namespace rsbl
@@ -4,12 +4,27 @@
 #pragma once
 
 #include "rsbl-core.h"
+#include "rsbl-int-types.h"
+
+#include <atomic>
 
 namespace rsbl
 {
 
+// Default UniquePtr deleter
 template <typename T>
-class UniquePtr
+struct DefaultDelete
+{
+    void operator()(T* ptr) const
+    {
+        delete ptr;
+    }
+};
+
+// Deleter decides how the object is destroyed (e.g. returned to a pool). Deleters are stored as
+// an empty base, so stateless deleters don't add to the size of the UniquePtr.
+template <typename T, typename Deleter = DefaultDelete<T>>
+class UniquePtr : private Deleter
 {
   public:
     // Default constructor - creates null pointer
@@ -24,18 +39,26 @@ class UniquePtr
     {
     }
 
+    // Takes ownership, destroying the object through deleter
+    UniquePtr(T* ptr, const Deleter& deleter)
+        : Deleter(deleter)
+        , m_ptr(ptr)
+    {
+    }
+
     // Destructor - deletes managed object
     ~UniquePtr()
     {
         if (m_ptr != nullptr)
         {
-            delete m_ptr;
+            GetDeleter()(m_ptr);
         }
     }
 
     // Move constructor
     UniquePtr(UniquePtr&& other) noexcept
-        : m_ptr(other.m_ptr)
+        : Deleter(rsblMove(other.GetDeleter()))
+        , m_ptr(other.m_ptr)
     {
         other.m_ptr = nullptr;
     }
@@ -48,10 +71,11 @@ class UniquePtr
             // Delete current object
             if (m_ptr != nullptr)
             {
-                delete m_ptr;
+                GetDeleter()(m_ptr);
             }
 
             // Take ownership from other
+            GetDeleter() = rsblMove(other.GetDeleter());
             m_ptr = other.m_ptr;
             other.m_ptr = nullptr;
         }
@@ -93,11 +117,21 @@ class UniquePtr
     {
         if (m_ptr != nullptr)
         {
-            delete m_ptr;
+            GetDeleter()(m_ptr);
         }
         m_ptr = ptr;
     }
 
+    Deleter& GetDeleter()
+    {
+        return *this;
+    }
+
+    const Deleter& GetDeleter() const
+    {
+        return *this;
+    }
+
     // Bool conversion operator
     explicit operator bool() const
     {
@@ -115,4 +149,219 @@ UniquePtr<T> MakeUnique(Args&&... args)
     return UniquePtr<T>(new T(rsblForward(args)...));
 }
 
+// UniquePtr is just a pointer (plus deleter), so it can be relocated with memcpy
+template <typename T, typename Deleter>
+struct TriviallyRelocatable<UniquePtr<T, Deleter>>
+{
+    static constexpr bool value = IsTriviallyRelocatable<Deleter>;
+};
+
+// Intrusive shared pointer. T provides AddRef() and Release(), either by deriving from
+// RefCounted<T> or natively (COM interfaces like ID3D12Device work as-is). There's no separate
+// control block, the refcount lives in the object.
+template <typename T>
+class RefPtr
+{
+  public:
+    RefPtr() = default;
+
+    RefPtr(decltype(nullptr))
+    {
+    }
+
+    // Shares ownership of ptr, adding a reference
+    explicit RefPtr(T* ptr)
+        : m_ptr(ptr)
+    {
+        AddRef();
+    }
+
+    // Takes over a reference the caller already owns (e.g. a freshly created COM object)
+    static RefPtr Adopt(T* ptr)
+    {
+        RefPtr result;
+        result.m_ptr = ptr;
+        return result;
+    }
+
+    ~RefPtr()
+    {
+        ReleaseRef();
+    }
+
+    RefPtr(const RefPtr& other)
+        : m_ptr(other.m_ptr)
+    {
+        AddRef();
+    }
+
+    RefPtr(RefPtr&& other) noexcept
+        : m_ptr(other.m_ptr)
+    {
+        other.m_ptr = nullptr;
+    }
+
+    // Derived to base conversion
+    template <typename U>
+    RefPtr(const RefPtr<U>& other)
+        : m_ptr(other.Get())
+    {
+        AddRef();
+    }
+
+    RefPtr& operator=(const RefPtr& other)
+    {
+        // AddRef first, so self-assignment can't drop the last reference
+        T* ptr = other.m_ptr;
+        if (ptr != nullptr)
+        {
+            ptr->AddRef();
+        }
+        ReleaseRef();
+        m_ptr = ptr;
+        return *this;
+    }
+
+    RefPtr& operator=(RefPtr&& other) noexcept
+    {
+        if (this != &other)
+        {
+            ReleaseRef();
+            m_ptr = other.m_ptr;
+            other.m_ptr = nullptr;
+        }
+        return *this;
+    }
+
+    T& operator*() const
+    {
+        return *m_ptr;
+    }
+
+    T* operator->() const
+    {
+        return m_ptr;
+    }
+
+    T* Get() const
+    {
+        return m_ptr;
+    }
+
+    // Give up our reference without releasing it
+    T* Detach()
+    {
+        T* ptr = m_ptr;
+        m_ptr = nullptr;
+        return ptr;
+    }
+
+    // Release our reference, and optionally share ownership of a new object
+    void Reset(T* ptr = nullptr)
+    {
+        if (ptr != nullptr)
+        {
+            ptr->AddRef();
+        }
+        ReleaseRef();
+        m_ptr = ptr;
+    }
+
+    // For APIs that return an owned reference through a T** out parameter (IID_PPV_ARGS etc)
+    T** ReleaseAndGetAddressOf()
+    {
+        ReleaseRef();
+        m_ptr = nullptr;
+        return &m_ptr;
+    }
+
+    explicit operator bool() const
+    {
+        return m_ptr != nullptr;
+    }
+
+    bool operator==(const RefPtr& other) const
+    {
+        return m_ptr == other.m_ptr;
+    }
+
+    bool operator!=(const RefPtr& other) const
+    {
+        return m_ptr != other.m_ptr;
+    }
+
+  private:
+    void AddRef()
+    {
+        if (m_ptr != nullptr)
+        {
+            m_ptr->AddRef();
+        }
+    }
+
+    void ReleaseRef()
+    {
+        if (m_ptr != nullptr)
+        {
+            m_ptr->Release();
+        }
+    }
+
+    T* m_ptr = nullptr;
+};
+
+// Base class that gives T an atomic refcount for RefPtr. Objects start with no references, and
+// are deleted when the last RefPtr lets go.
+template <typename T>
+class RefCounted
+{
+  public:
+    void AddRef() const
+    {
+        m_refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Release() const
+    {
+        if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete static_cast<const T*>(this);
+        }
+    }
+
+    uint32 RefCount() const
+    {
+        return m_refCount.load(std::memory_order_relaxed);
+    }
+
+  protected:
+    RefCounted() = default;
+    ~RefCounted() = default;
+
+    // Copies are new objects, so they don't inherit references
+    RefCounted(const RefCounted&)
+    {
+    }
+
+    RefCounted& operator=(const RefCounted&)
+    {
+        return *this;
+    }
+
+  private:
+    mutable std::atomic<uint32> m_refCount{0};
+};
+
+template <typename T, typename... Args>
+RefPtr<T> MakeRef(Args&&... args)
+{
+    return RefPtr<T>(new T(rsblForward(args)...));
+}
+
+template <typename T>
+struct TriviallyRelocatable<RefPtr<T>>
+{
+    static constexpr bool value = true;
+};
+
 } // namespace rsbl
@@ -0,0 +1,101 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-dynamic-array.h"
+#include "rsbl-int-types.h"
+
+namespace rsbl
+{
+
+// Hands out offsets into a range of memory it never touches, like a GPU heap, with a two-level
+// segregated fit (TLSF). Free ranges are binned by the log2 of their size and then linearly into
+// 16 sub-bins, with a bit per non-empty bin, so allocating is two bit scans and a split, and
+// freeing merges with the free neighbours and files the result. Both are O(1) however many
+// ranges there are. A fit is good rather than best: a range is only taken from a bin whose
+// every range is big enough, so at worst it's a sixteenth bigger than asked for, and the rest
+// goes back as a free range.
+// The bookkeeping lives in a node array that grows with the number of ranges.
+class RangeAllocator
+{
+  public:
+    static constexpr uint32 kInvalidRange = ~0u;
+
+    struct Range
+    {
+        uint64 offset = 0;
+        uint32 id = kInvalidRange; // For Free, kInvalidRange when nothing fit
+    };
+
+    explicit RangeAllocator(uint64 size = 0, Allocator* allocator = GetDefaultAllocator());
+
+    // Forgets every range, leaving all of [0, size) free
+    void Reset(uint64 size);
+
+    // alignment must be a power of two. Zero sizes are rounded up to one.
+    Range Allocate(uint64 size, uint64 alignment = 1);
+    void Free(uint32 id);
+
+    uint64 Size() const
+    {
+        return m_size;
+    }
+
+    uint64 FreeBytes() const
+    {
+        return m_freeBytes;
+    }
+
+    uint32 AllocationCount() const
+    {
+        return m_allocationCount;
+    }
+
+    // The biggest single allocation that would fit, ignoring alignment
+    uint64 LargestFreeRange() const;
+
+    uint64 RangeSize(uint32 id) const
+    {
+        return m_nodes[id].size;
+    }
+
+  private:
+    static constexpr uint32 kSubBinBits = 4;
+    static constexpr uint32 kSubBins = 1u << kSubBinBits;
+    static constexpr uint32 kBins = 64;
+
+    struct Node
+    {
+        uint64 offset;
+        uint64 size;
+        // Neighbours in the range, by offset
+        uint32 previous;
+        uint32 next;
+        // Neighbours in the free bin, or the next unused node
+        uint32 previousFree;
+        uint32 nextFree;
+        bool free;
+    };
+
+    static void BinOf(uint64 size, uint32& bin, uint32& subBin);
+    static uint64 SmallestInBin(uint32 bin, uint32 subBin);
+
+    uint32 NewNode(uint64 offset, uint64 size);
+    void InsertFree(uint32 id);
+    void RemoveFree(uint32 id);
+
+    DynamicArray<Node> m_nodes;
+    uint32 m_unusedNodes = kInvalidRange;
+
+    uint64 m_binBits = 0;
+    uint32 m_subBinBits[kBins] = {};
+    uint32 m_bins[kBins][kSubBins];
+
+    uint64 m_size = 0;
+    uint64 m_freeBytes = 0;
+    uint32 m_allocationCount = 0;
+};
+
+} // namespace rsbl
@@ -9,6 +9,8 @@
 // I can't use placement new without this, WHOOPS
 #include <new>
 
+#include <cstring>
+
 #if defined(_MSC_VER)
     // I don't care about the padding in Result. C4324 might also appear!
     #pragma warning(disable : 4820)
@@ -23,34 +25,206 @@ enum class ResultCode : uint8
     Failure,
 };
 
+// Coarse reason for a failure, so callers can branch on it without looking at the text
+enum class ErrorCategory : uint8
+{
+    None, // Success
+    Generic,
+    InvalidArgument,
+    OutOfMemory,
+    NotFound,
+    Io,
+    Timeout,
+    Platform,
+    Graphics,
+};
+
+// Returned by FailureFormat and FailureCopy once the text has been stashed. Converts to any
+// Result.
+struct PendingFailure
+{
+    ErrorCategory category;
+};
+
 namespace Internal
 {
-    // Per-thread failure text used by Result
+    // Per-thread failure text used by Result. Only the pointer is stored, the text must have
+    // static storage duration.
     void SetFailureText(const char* text);
     const char* GetFailureText();
 
+    // Copy into a fixed per-thread buffer, for text that won't outlive the call
+    void CopyFailureText(const char* text);
+
+    // Deferred failure formatting. The arguments are copied into per-thread storage, and only
+    // formatted with printf-style rules when GetFailureText is called.
+    constexpr uint64 kFailureFormatArgsSize = 64;
+
+    typedef void (*FailureFormatter)(char* buffer,
+                                     uint64 bufferSize,
+                                     const char* format,
+                                     const void* args);
+
+    void SetFailureFormat(const char* format,
+                          FailureFormatter formatter,
+                          const void* args,
+                          uint64 argsSize);
+
+    // vsnprintf, but keeps <cstdio> out of the header
+    void FormatFailureText(char* buffer, uint64 bufferSize, const char* format, ...);
+
+    // Arithmetic or enum, anything else could refer to memory that's gone by the time the text
+    // is formatted
+    template <typename T>
+    concept FailureFormatArgument =
+        __is_enum(T) || (!__is_class(T) && !__is_union(T) && requires(T value) { value * value; });
+
+    // Enums are passed to printf as their underlying type
+    template <typename T, bool = __is_enum(T)>
+    struct FailureArgType
+    {
+        using type = T;
+    };
+
+    template <typename T>
+    struct FailureArgType<T, true>
+    {
+        using type = __underlying_type(T);
+    };
+
+    template <typename... Args>
+    struct FailureArgPack
+    {
+    };
+
+    template <typename First, typename... Rest>
+    struct FailureArgPack<First, Rest...>
+    {
+        First first;
+        FailureArgPack<Rest...> rest{};
+    };
+
+    // Peel the arguments back out of the pack, in order, and hand them to printf
+    template <typename... Done>
+    void ApplyFailureArgs(const FailureArgPack<>&,
+                          char* buffer,
+                          uint64 bufferSize,
+                          const char* format,
+                          Done... done)
+    {
+        FormatFailureText(buffer, bufferSize, format, done...);
+    }
+
+    template <typename First, typename... Rest, typename... Done>
+    void ApplyFailureArgs(const FailureArgPack<First, Rest...>& pack,
+                          char* buffer,
+                          uint64 bufferSize,
+                          const char* format,
+                          Done... done)
+    {
+        ApplyFailureArgs(pack.rest, buffer, bufferSize, format, done..., pack.first);
+    }
+
+    template <typename... Args>
+    void FormatDeferredFailure(char* buffer,
+                               uint64 bufferSize,
+                               const char* format,
+                               const void* args)
+    {
+        FailureArgPack<Args...> pack;
+        memcpy(&pack, args, sizeof(pack));
+        ApplyFailureArgs(pack, buffer, bufferSize, format);
+    }
+
     // Clients can use any ReturnType without worrying about constructor collisions because of
     // this internal opaque type. 'Empty' results will use this.
     struct DefaultReturnType
     {
         uint8 x;
     };
+
+    // Result<> has no meaningful value, so its continuations take no arguments
+    template <typename F, typename T>
+    decltype(auto) InvokeWithValue(F& f, T&& value)
+    {
+        if constexpr (rsbl::IsSame<rsbl::RemoveCV<rsbl::RemoveReference<T>>, DefaultReturnType>)
+        {
+            return f();
+        }
+        else
+        {
+            return f(rsblForward(value));
+        }
+    }
 } // namespace Internal
 
-// Custom specialization of std::optional specifically for using as an error-handling return
-// type
+// Failure with printf-style text, formatted lazily the first time FailureText() is asked for.
+// Failing costs a few per-thread stores, so it's fine in hot retry loops. Arguments are copied
+// by value, so only arithmetic and enum types are allowed (a string argument could dangle
+// before it gets formatted). The format string must have static storage duration.
+template <Internal::FailureFormatArgument... Args>
+PendingFailure FailureFormat(ErrorCategory category, const char* format, Args... args)
+{
+    using Pack = Internal::FailureArgPack<typename Internal::FailureArgType<Args>::type...>;
+    static_assert(sizeof(Pack) <= Internal::kFailureFormatArgsSize,
+                  "Too many failure format arguments");
+
+    const Pack pack{static_cast<typename Internal::FailureArgType<Args>::type>(args)...};
+    Internal::SetFailureFormat(
+        format,
+        &Internal::FormatDeferredFailure<typename Internal::FailureArgType<Args>::type...>,
+        &pack,
+        sizeof(pack));
+    return PendingFailure{category};
+}
+
+// Failure with text that doesn't have static storage duration. The text is copied (and
+// truncated) into a fixed per-thread buffer, so this never allocates.
+inline PendingFailure FailureCopy(ErrorCategory category, const char* text)
+{
+    Internal::CopyFailureText(text);
+    return PendingFailure{category};
+}
 
 // TODO: default return type?
 template <typename ReturnType = Internal::DefaultReturnType>
+class Result;
+
+namespace Internal
+{
+    // Transform with a void function gives an empty Result
+    template <typename T>
+    struct TransformedResult
+    {
+        using type = Result<T>;
+    };
+
+    template <>
+    struct TransformedResult<void>
+    {
+        using type = Result<>;
+    };
+} // namespace Internal
+
+// Custom specialization of std::optional specifically for using as an error-handling return
+// type
+template <typename ReturnType>
 class [[nodiscard]] Result
 {
   private:
+    // Trivially copyable payloads get trivial copies, moves and destruction, so Result<uint64> or
+    // Result<FileHandle> is just a small struct to the compiler. On SysV that's returned in
+    // registers. MSVC always returns classes with constructors through memory, but the copy still
+    // boils down to a couple of stores.
+    static constexpr bool kTriviallyCopyable = __is_trivially_copyable(ReturnType);
+
     // Instead of keeping an instance of ReturnType, we can use this buffer to control
     // construction time with placement new (borrowed from std::optional)
     alignas(ReturnType) uint8 m_valueBuffer[sizeof(ReturnType)];
 
     // Default to success, for ReturnType construction simplification
     ResultCode m_code = ResultCode::Success;
+    ErrorCategory m_category = ErrorCategory::None;
 
   public:
     // We assume success when passed the ReturnType
@@ -67,6 +241,7 @@ class [[nodiscard]] Result
     // Lightweight code-only constructors. Success invokes default constructor
     Result(ResultCode code)
         : m_code(code)
+        , m_category(code == ResultCode::Success ? ErrorCategory::None : ErrorCategory::Generic)
     {
         if (m_code == ResultCode::Success)
         {
@@ -77,9 +252,14 @@ class [[nodiscard]] Result
     // TODO: compile-time detection constructors (if certain pass/fail types are passed in as
     // args)
 
+    // Trivial moves don't invalidate the moved-from Result, there's nothing to clean up
+    Result(Result&&) requires kTriviallyCopyable = default;
+    Result& operator=(Result&&) requires kTriviallyCopyable = default;
+
     // Moves
     Result(Result&& other) noexcept
         : m_code(other.m_code)
+        , m_category(other.m_category)
     {
         if (m_code == ResultCode::Success)
         {
@@ -100,6 +280,7 @@ class [[nodiscard]] Result
         }
 
         m_code = other.m_code;
+        m_category = other.m_category;
 
         if (m_code == ResultCode::Success)
         {
@@ -109,6 +290,7 @@ class [[nodiscard]] Result
 
         // invalidate the moved-away-from Result
         other.m_code = ResultCode::Failure;
+        other.m_category = ErrorCategory::Generic;
 
         return *this;
     }
@@ -116,18 +298,38 @@ class [[nodiscard]] Result
     // TODO: move overload for Result<> -> Result<ReturnType>
     // TODO: move overload for Result<ReturnType> -> Result<> (preserve error + failure text)
 
-    // Error text
+    // Error text. Only the pointer is kept, so this is meant for string literals. Use FailureCopy
+    // for anything built at runtime.
     Result(const char* text)
         : m_code(ResultCode::Failure)
+        , m_category(ErrorCategory::Generic)
     {
         Internal::SetFailureText(text);
     }
 
-    // No default constructor or copies
+    Result(ErrorCategory category, const char* text)
+        : m_code(ResultCode::Failure)
+        , m_category(category)
+    {
+        Internal::SetFailureText(text);
+    }
+
+    // From FailureFormat/FailureCopy, the text is already stashed
+    Result(PendingFailure failure)
+        : m_code(ResultCode::Failure)
+        , m_category(failure.category)
+    {
+    }
+
+    // No default constructor, and only trivial copies
     Result() = delete;
+    Result(const Result&) requires kTriviallyCopyable = default;
+    Result& operator=(const Result&) requires kTriviallyCopyable = default;
     Result(const Result&) = delete;
     Result& operator=(const Result&) = delete;
 
+    ~Result() requires kTriviallyCopyable = default;
+
     ~Result()
     {
         if (m_code == ResultCode::Success)
@@ -146,6 +348,11 @@ class [[nodiscard]] Result
         return m_code;
     }
 
+    [[nodiscard]] ErrorCategory Category() const
+    {
+        return m_category;
+    }
+
     ReturnType& Value()
     {
         return *reinterpret_cast<ReturnType*>(m_valueBuffer);
@@ -157,11 +364,210 @@ class [[nodiscard]] Result
     }
 
     // I could make this static, but I want it took like we are checking the Result instance for
-    // the text, not some general error buffer
+    // the text, not some general error buffer. Deferred text is formatted here, on first use.
+    const char* FailureText() const
+    {
+        return Internal::GetFailureText();
+    }
+
+    // Monadic helpers, along the lines of std::expected. Failures pass straight through with
+    // their category, the failure text is already stashed per-thread.
+
+    // f(Value()) returns a Result, and is only called on success
+    template <typename F>
+    auto AndThen(F&& f) &
+    {
+        using Next = decltype(Internal::InvokeWithValue(f, Value()));
+        if (m_code == ResultCode::Success)
+        {
+            return Internal::InvokeWithValue(f, Value());
+        }
+        return Next(PendingFailure{m_category});
+    }
+
+    template <typename F>
+    auto AndThen(F&& f) &&
+    {
+        using Next = decltype(Internal::InvokeWithValue(f, rsblMove(Value())));
+        if (m_code == ResultCode::Success)
+        {
+            return Internal::InvokeWithValue(f, rsblMove(Value()));
+        }
+        return Next(PendingFailure{m_category});
+    }
+
+    // f(Value()) returns a plain value (or void), which is wrapped in a Result
+    template <typename F>
+    auto Transform(F&& f) &
+    {
+        using Mapped = decltype(Internal::InvokeWithValue(f, Value()));
+        using Next = typename Internal::TransformedResult<Mapped>::type;
+        if (m_code != ResultCode::Success)
+        {
+            return Next(PendingFailure{m_category});
+        }
+
+        if constexpr (IsSame<Mapped, void>)
+        {
+            Internal::InvokeWithValue(f, Value());
+            return Next(ResultCode::Success);
+        }
+        else
+        {
+            return Next(Internal::InvokeWithValue(f, Value()));
+        }
+    }
+
+    template <typename F>
+    auto Transform(F&& f) &&
+    {
+        using Mapped = decltype(Internal::InvokeWithValue(f, rsblMove(Value())));
+        using Next = typename Internal::TransformedResult<Mapped>::type;
+        if (m_code != ResultCode::Success)
+        {
+            return Next(PendingFailure{m_category});
+        }
+
+        if constexpr (IsSame<Mapped, void>)
+        {
+            Internal::InvokeWithValue(f, rsblMove(Value()));
+            return Next(ResultCode::Success);
+        }
+        else
+        {
+            return Next(Internal::InvokeWithValue(f, rsblMove(Value())));
+        }
+    }
+
+    // f(Category()) returns a Result of the same type, and is only called on failure. The usual
+    // use is a fallback, or retrying with different parameters.
+    template <typename F>
+    Result OrElse(F&& f) &&
+    {
+        if (m_code == ResultCode::Success)
+        {
+            return rsblMove(*this);
+        }
+        return f(m_category);
+    }
+};
+
+// Result of a reference, for lookups that can fail. Just a pointer, and it rebinds on assignment
+// like a pointer would.
+template <typename ReturnType>
+class [[nodiscard]] Result<ReturnType&>
+{
+  private:
+    ReturnType* m_value = nullptr;
+    ResultCode m_code = ResultCode::Failure;
+    ErrorCategory m_category = ErrorCategory::Generic;
+
+  public:
+    Result(ReturnType& value)
+        : m_value(&value)
+        , m_code(ResultCode::Success)
+        , m_category(ErrorCategory::None)
+    {
+    }
+
+    // There's nothing to refer to for a code-only success, so failures need text or a category
+    Result(const char* text)
+    {
+        Internal::SetFailureText(text);
+    }
+
+    Result(ErrorCategory category, const char* text)
+        : m_category(category)
+    {
+        Internal::SetFailureText(text);
+    }
+
+    Result(PendingFailure failure)
+        : m_category(failure.category)
+    {
+    }
+
+    Result() = delete;
+
+    explicit operator bool() const
+    {
+        return m_code == ResultCode::Success;
+    }
+
+    [[nodiscard]] ResultCode Code() const
+    {
+        return m_code;
+    }
+
+    [[nodiscard]] ErrorCategory Category() const
+    {
+        return m_category;
+    }
+
+    ReturnType& Value() const
+    {
+        return *m_value;
+    }
+
     const char* FailureText() const
     {
         return Internal::GetFailureText();
     }
+
+    template <typename F>
+    auto AndThen(F&& f) const
+    {
+        using Next = decltype(f(Value()));
+        if (m_code == ResultCode::Success)
+        {
+            return f(Value());
+        }
+        return Next(PendingFailure{m_category});
+    }
+
+    template <typename F>
+    auto Transform(F&& f) const
+    {
+        using Mapped = decltype(f(Value()));
+        using Next = typename Internal::TransformedResult<Mapped>::type;
+        if (m_code != ResultCode::Success)
+        {
+            return Next(PendingFailure{m_category});
+        }
+
+        if constexpr (IsSame<Mapped, void>)
+        {
+            f(Value());
+            return Next(ResultCode::Success);
+        }
+        else
+        {
+            return Next(f(Value()));
+        }
+    }
+
+    template <typename F>
+    Result OrElse(F&& f) const
+    {
+        if (m_code == ResultCode::Success)
+        {
+            return *this;
+        }
+        return f(m_category);
+    }
+};
+
+// Relocating a Result is relocating its value
+template <typename ReturnType>
+struct TriviallyRelocatable<Result<ReturnType>>
+{
+    static constexpr bool value = IsTriviallyRelocatable<ReturnType>;
+};
+
+template <typename ReturnType>
+struct TriviallyRelocatable<Result<ReturnType&>>
+{
+    static constexpr bool value = true;
 };
 
 } // namespace rsbl
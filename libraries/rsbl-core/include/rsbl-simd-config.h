@@ -0,0 +1,76 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+// Which instruction sets this translation unit is compiled for. Only macros live here, so kernel
+// files built with wider instruction sets can share it without pulling in inline functions.
+// SSE2 on x64, NEON on ARM64, plain floats everywhere else. Define RSBL_SIMD_FORCE_SCALAR to
+// test the fallback on a machine that has SIMD.
+// RSBL_SIMD_AVX2 and RSBL_SIMD_AVX512 follow the compiler flags (/arch:AVX2, -mavx2 -mfma, ...).
+// The library itself is built for the baseline and only turns them on for the kernel files it
+// dispatches to at runtime (see rsbl-cpu.h).
+#if defined(RSBL_SIMD_FORCE_SCALAR)
+    #define RSBL_SIMD_SSE 0
+    #define RSBL_SIMD_NEON 0
+#elif defined(_M_X64) || defined(__SSE2__)
+    #define RSBL_SIMD_SSE 1
+    #define RSBL_SIMD_NEON 0
+    #include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    #define RSBL_SIMD_SSE 0
+    #define RSBL_SIMD_NEON 1
+    #include <arm_neon.h>
+#else
+    #define RSBL_SIMD_SSE 0
+    #define RSBL_SIMD_NEON 0
+#endif
+
+#if RSBL_SIMD_SSE && defined(__AVX2__)
+    #define RSBL_SIMD_AVX2 1
+    #include <immintrin.h>
+#else
+    #define RSBL_SIMD_AVX2 0
+#endif
+
+// MSVC doesn't define __FMA__, but /arch:AVX2 allows FMA instructions
+#if RSBL_SIMD_AVX2 && (defined(__FMA__) || defined(_MSC_VER))
+    #define RSBL_SIMD_FMA 1
+#else
+    #define RSBL_SIMD_FMA 0
+#endif
+
+// Same for F16C, every AVX2 CPU has it
+#if RSBL_SIMD_AVX2 && (defined(__F16C__) || defined(_MSC_VER))
+    #define RSBL_SIMD_F16C 1
+#else
+    #define RSBL_SIMD_F16C 0
+#endif
+
+// And BMI2 (pdep/pext), which came in the same generation
+#if RSBL_SIMD_AVX2 && (defined(__BMI2__) || defined(_MSC_VER))
+    #define RSBL_SIMD_BMI2 1
+#else
+    #define RSBL_SIMD_BMI2 0
+#endif
+
+#if RSBL_SIMD_AVX2 && defined(__AVX512F__)
+    #define RSBL_SIMD_AVX512 1
+#else
+    #define RSBL_SIMD_AVX512 0
+#endif
+
+// Inline namespace that the wide batch types live in. Kernel files compiled for different
+// instruction sets get differently mangled inline functions, so the linker can't fold an AVX2
+// copy into code that has to run on a baseline CPU.
+#if RSBL_SIMD_AVX512
+    #define RSBL_SIMD_ISA avx512
+#elif RSBL_SIMD_AVX2
+    #define RSBL_SIMD_ISA avx2
+#elif RSBL_SIMD_SSE
+    #define RSBL_SIMD_ISA sse2
+#elif RSBL_SIMD_NEON
+    #define RSBL_SIMD_ISA neon
+#else
+    #define RSBL_SIMD_ISA scalar
+#endif
@@ -0,0 +1,1145 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-int-types.h"
+#include "rsbl-simd-config.h"
+
+#include <cmath>
+
+// Batch types for SoA data, one object per lane: FloatxN<W> is a float from W different objects,
+// Vec3xN<W> is W positions, MaskxN<W> is a per-lane comparison result. A kernel loops over its
+// arrays kNativeWidth objects at a time, so culling, bounds tests and skinning handle 4 (SSE2,
+// NEON), 8 (AVX2) or 16 (AVX-512) objects per instruction.
+// kNativeWidth follows what this translation unit is compiled for. Widths without a native
+// register fall back to plain loops, which is also the scalar path.
+// Everything is inline and lives in a per-instruction-set inline namespace, so kernels can be
+// built several times with different flags and dispatched at runtime (see rsbl-cpu.h). Files
+// built with wider flags should include this header and nothing that has other inline functions.
+
+namespace rsbl
+{
+namespace simd
+{
+inline namespace RSBL_SIMD_ISA
+{
+#if RSBL_SIMD_AVX512
+    constexpr uint32 kNativeWidth = 16;
+#elif RSBL_SIMD_AVX2
+    constexpr uint32 kNativeWidth = 8;
+#else
+    constexpr uint32 kNativeWidth = 4;
+#endif
+
+    // Generic lanes. The native widths are specialized below with the same interface, apart from
+    // the storage members.
+
+    // One bit per lane, lane i is bit i
+    template <uint32 Width>
+    class MaskxN
+    {
+      public:
+        static_assert(Width >= 1 && Width <= 32, "Generic masks are stored in one uint32");
+        static constexpr uint32 kWidth = Width;
+        static constexpr uint32 kAllBits = Width == 32 ? ~0u : (1u << Width) - 1;
+
+        uint32 bits;
+    };
+
+    template <uint32 Width>
+    class FloatxN
+    {
+      public:
+        static constexpr uint32 kWidth = Width;
+
+        float lanes[Width];
+
+        // Uninitialized, like float4
+        FloatxN() = default;
+
+        explicit FloatxN(float v)
+        {
+            for (uint32 i = 0; i < Width; ++i)
+            {
+                lanes[i] = v;
+            }
+        }
+
+        static FloatxN LoadUnaligned(const float* ptr)
+        {
+            FloatxN result;
+            for (uint32 i = 0; i < Width; ++i)
+            {
+                result.lanes[i] = ptr[i];
+            }
+            return result;
+        }
+
+        // ptr must be aligned to Width floats
+        static FloatxN LoadAligned(const float* ptr)
+        {
+            return LoadUnaligned(ptr);
+        }
+
+        float Lane(uint32 i) const
+        {
+            return lanes[i];
+        }
+    };
+
+    template <uint32 W>
+    inline void StoreUnaligned(FloatxN<W> v, float* ptr)
+    {
+        for (uint32 i = 0; i < W; ++i)
+        {
+            ptr[i] = v.lanes[i];
+        }
+    }
+
+    template <uint32 W>
+    inline void StoreAligned(FloatxN<W> v, float* ptr)
+    {
+        StoreUnaligned(v, ptr);
+    }
+
+    // Helper for the element-wise generic operations
+    namespace Internal
+    {
+        template <uint32 W, typename Op>
+        inline FloatxN<W> Map(FloatxN<W> a, FloatxN<W> b, Op op)
+        {
+            FloatxN<W> result;
+            for (uint32 i = 0; i < W; ++i)
+            {
+                result.lanes[i] = op(a.lanes[i], b.lanes[i]);
+            }
+            return result;
+        }
+
+        template <uint32 W, typename Op>
+        inline MaskxN<W> Compare(FloatxN<W> a, FloatxN<W> b, Op op)
+        {
+            uint32 bits = 0;
+            for (uint32 i = 0; i < W; ++i)
+            {
+                bits |= (op(a.lanes[i], b.lanes[i]) ? 1u : 0u) << i;
+            }
+            return MaskxN<W>{bits};
+        }
+    } // namespace Internal
+
+    template <uint32 W>
+    inline FloatxN<W> operator+(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Map(a, b, [](float x, float y) { return x + y; });
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> operator-(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Map(a, b, [](float x, float y) { return x - y; });
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> operator*(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Map(a, b, [](float x, float y) { return x * y; });
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> operator/(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Map(a, b, [](float x, float y) { return x / y; });
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> operator-(FloatxN<W> v)
+    {
+        return Internal::Map(v, v, [](float x, float) { return -x; });
+    }
+
+    // a * b + c, fused where the target has FMA
+    template <uint32 W>
+    inline FloatxN<W> MultiplyAdd(FloatxN<W> a, FloatxN<W> b, FloatxN<W> c)
+    {
+        return a * b + c;
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> Min(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Map(a, b, [](float x, float y) { return x < y ? x : y; });
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> Max(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Map(a, b, [](float x, float y) { return x > y ? x : y; });
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> Abs(FloatxN<W> v)
+    {
+        return Internal::Map(v, v, [](float x, float) { return fabsf(x); });
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> Sqrt(FloatxN<W> v)
+    {
+        return Internal::Map(v, v, [](float x, float) { return sqrtf(x); });
+    }
+
+    template <uint32 W>
+    inline MaskxN<W> operator<(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Compare(a, b, [](float x, float y) { return x < y; });
+    }
+
+    template <uint32 W>
+    inline MaskxN<W> operator<=(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Compare(a, b, [](float x, float y) { return x <= y; });
+    }
+
+    template <uint32 W>
+    inline MaskxN<W> operator>(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Compare(a, b, [](float x, float y) { return x > y; });
+    }
+
+    template <uint32 W>
+    inline MaskxN<W> operator>=(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Compare(a, b, [](float x, float y) { return x >= y; });
+    }
+
+    template <uint32 W>
+    inline MaskxN<W> operator==(FloatxN<W> a, FloatxN<W> b)
+    {
+        return Internal::Compare(a, b, [](float x, float y) { return x == y; });
+    }
+
+    template <uint32 W>
+    inline MaskxN<W> operator&(MaskxN<W> a, MaskxN<W> b)
+    {
+        return MaskxN<W>{a.bits & b.bits};
+    }
+
+    template <uint32 W>
+    inline MaskxN<W> operator|(MaskxN<W> a, MaskxN<W> b)
+    {
+        return MaskxN<W>{a.bits | b.bits};
+    }
+
+    template <uint32 W>
+    inline MaskxN<W> operator~(MaskxN<W> m)
+    {
+        return MaskxN<W>{~m.bits & MaskxN<W>::kAllBits};
+    }
+
+    // Lane i of the mask is bit i of the result
+    template <uint32 W>
+    inline uint32 ToBits(MaskxN<W> m)
+    {
+        return m.bits;
+    }
+
+    template <uint32 W>
+    inline bool Any(MaskxN<W> m)
+    {
+        return m.bits != 0;
+    }
+
+    template <uint32 W>
+    inline bool All(MaskxN<W> m)
+    {
+        return m.bits == MaskxN<W>::kAllBits;
+    }
+
+    // Per lane: mask ? a : b
+    template <uint32 W>
+    inline FloatxN<W> Select(MaskxN<W> mask, FloatxN<W> a, FloatxN<W> b)
+    {
+        FloatxN<W> result;
+        for (uint32 i = 0; i < W; ++i)
+        {
+            result.lanes[i] = (mask.bits >> i) & 1 ? a.lanes[i] : b.lanes[i];
+        }
+        return result;
+    }
+
+    // 4 lanes
+
+#if RSBL_SIMD_SSE
+    template <>
+    class MaskxN<4>
+    {
+      public:
+        static constexpr uint32 kWidth = 4;
+
+        MaskxN() = default;
+
+        explicit MaskxN(__m128 value)
+            : m_value(value)
+        {
+        }
+
+        __m128 Native() const
+        {
+            return m_value;
+        }
+
+      private:
+        __m128 m_value;
+    };
+
+    template <>
+    class FloatxN<4>
+    {
+      public:
+        static constexpr uint32 kWidth = 4;
+
+        FloatxN() = default;
+
+        explicit FloatxN(float v)
+            : m_value(_mm_set1_ps(v))
+        {
+        }
+
+        explicit FloatxN(__m128 value)
+            : m_value(value)
+        {
+        }
+
+        static FloatxN LoadUnaligned(const float* ptr)
+        {
+            return FloatxN(_mm_loadu_ps(ptr));
+        }
+
+        static FloatxN LoadAligned(const float* ptr)
+        {
+            return FloatxN(_mm_load_ps(ptr));
+        }
+
+        __m128 Native() const
+        {
+            return m_value;
+        }
+
+        float Lane(uint32 i) const
+        {
+            alignas(16) float values[4];
+            _mm_store_ps(values, m_value);
+            return values[i];
+        }
+
+      private:
+        __m128 m_value;
+    };
+
+    inline void StoreUnaligned(FloatxN<4> v, float* ptr)
+    {
+        _mm_storeu_ps(ptr, v.Native());
+    }
+
+    inline void StoreAligned(FloatxN<4> v, float* ptr)
+    {
+        _mm_store_ps(ptr, v.Native());
+    }
+
+    inline FloatxN<4> operator+(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(_mm_add_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> operator-(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(_mm_sub_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> operator*(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(_mm_mul_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> operator/(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(_mm_div_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> operator-(FloatxN<4> v)
+    {
+        return FloatxN<4>(_mm_xor_ps(v.Native(), _mm_set1_ps(-0.0f)));
+    }
+
+    inline FloatxN<4> MultiplyAdd(FloatxN<4> a, FloatxN<4> b, FloatxN<4> c)
+    {
+    #if RSBL_SIMD_FMA
+        return FloatxN<4>(_mm_fmadd_ps(a.Native(), b.Native(), c.Native()));
+    #else
+        return FloatxN<4>(_mm_add_ps(_mm_mul_ps(a.Native(), b.Native()), c.Native()));
+    #endif
+    }
+
+    inline FloatxN<4> Min(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(_mm_min_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> Max(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(_mm_max_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> Abs(FloatxN<4> v)
+    {
+        return FloatxN<4>(_mm_andnot_ps(_mm_set1_ps(-0.0f), v.Native()));
+    }
+
+    inline FloatxN<4> Sqrt(FloatxN<4> v)
+    {
+        return FloatxN<4>(_mm_sqrt_ps(v.Native()));
+    }
+
+    inline MaskxN<4> operator<(FloatxN<4> a, FloatxN<4> b)
+    {
+        return MaskxN<4>(_mm_cmplt_ps(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator<=(FloatxN<4> a, FloatxN<4> b)
+    {
+        return MaskxN<4>(_mm_cmple_ps(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator>(FloatxN<4> a, FloatxN<4> b)
+    {
+        return MaskxN<4>(_mm_cmpgt_ps(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator>=(FloatxN<4> a, FloatxN<4> b)
+    {
+        return MaskxN<4>(_mm_cmpge_ps(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator==(FloatxN<4> a, FloatxN<4> b)
+    {
+        return MaskxN<4>(_mm_cmpeq_ps(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator&(MaskxN<4> a, MaskxN<4> b)
+    {
+        return MaskxN<4>(_mm_and_ps(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator|(MaskxN<4> a, MaskxN<4> b)
+    {
+        return MaskxN<4>(_mm_or_ps(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator~(MaskxN<4> m)
+    {
+        const __m128 all = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        return MaskxN<4>(_mm_xor_ps(m.Native(), all));
+    }
+
+    inline uint32 ToBits(MaskxN<4> m)
+    {
+        return static_cast<uint32>(_mm_movemask_ps(m.Native()));
+    }
+
+    inline bool Any(MaskxN<4> m)
+    {
+        return ToBits(m) != 0;
+    }
+
+    inline bool All(MaskxN<4> m)
+    {
+        return ToBits(m) == 0xf;
+    }
+
+    inline FloatxN<4> Select(MaskxN<4> mask, FloatxN<4> a, FloatxN<4> b)
+    {
+        const __m128 m = mask.Native();
+        return FloatxN<4>(_mm_or_ps(_mm_and_ps(m, a.Native()), _mm_andnot_ps(m, b.Native())));
+    }
+#elif RSBL_SIMD_NEON
+    template <>
+    class MaskxN<4>
+    {
+      public:
+        static constexpr uint32 kWidth = 4;
+
+        MaskxN() = default;
+
+        explicit MaskxN(uint32x4_t value)
+            : m_value(value)
+        {
+        }
+
+        uint32x4_t Native() const
+        {
+            return m_value;
+        }
+
+      private:
+        uint32x4_t m_value;
+    };
+
+    template <>
+    class FloatxN<4>
+    {
+      public:
+        static constexpr uint32 kWidth = 4;
+
+        FloatxN() = default;
+
+        explicit FloatxN(float v)
+            : m_value(vdupq_n_f32(v))
+        {
+        }
+
+        explicit FloatxN(float32x4_t value)
+            : m_value(value)
+        {
+        }
+
+        static FloatxN LoadUnaligned(const float* ptr)
+        {
+            return FloatxN(vld1q_f32(ptr));
+        }
+
+        static FloatxN LoadAligned(const float* ptr)
+        {
+            return FloatxN(vld1q_f32(ptr));
+        }
+
+        float32x4_t Native() const
+        {
+            return m_value;
+        }
+
+        float Lane(uint32 i) const
+        {
+            float values[4];
+            vst1q_f32(values, m_value);
+            return values[i];
+        }
+
+      private:
+        float32x4_t m_value;
+    };
+
+    inline void StoreUnaligned(FloatxN<4> v, float* ptr)
+    {
+        vst1q_f32(ptr, v.Native());
+    }
+
+    inline void StoreAligned(FloatxN<4> v, float* ptr)
+    {
+        vst1q_f32(ptr, v.Native());
+    }
+
+    inline FloatxN<4> operator+(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(vaddq_f32(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> operator-(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(vsubq_f32(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> operator*(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(vmulq_f32(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> operator/(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(vdivq_f32(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> operator-(FloatxN<4> v)
+    {
+        return FloatxN<4>(vnegq_f32(v.Native()));
+    }
+
+    inline FloatxN<4> MultiplyAdd(FloatxN<4> a, FloatxN<4> b, FloatxN<4> c)
+    {
+        return FloatxN<4>(vfmaq_f32(c.Native(), a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> Min(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(vminq_f32(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> Max(FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(vmaxq_f32(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<4> Abs(FloatxN<4> v)
+    {
+        return FloatxN<4>(vabsq_f32(v.Native()));
+    }
+
+    inline FloatxN<4> Sqrt(FloatxN<4> v)
+    {
+        return FloatxN<4>(vsqrtq_f32(v.Native()));
+    }
+
+    inline MaskxN<4> operator<(FloatxN<4> a, FloatxN<4> b)
+    {
+        return MaskxN<4>(vcltq_f32(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator<=(FloatxN<4> a, FloatxN<4> b)
+    {
+        return MaskxN<4>(vcleq_f32(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator>(FloatxN<4> a, FloatxN<4> b)
+    {
+        return MaskxN<4>(vcgtq_f32(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator>=(FloatxN<4> a, FloatxN<4> b)
+    {
+        return MaskxN<4>(vcgeq_f32(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator==(FloatxN<4> a, FloatxN<4> b)
+    {
+        return MaskxN<4>(vceqq_f32(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator&(MaskxN<4> a, MaskxN<4> b)
+    {
+        return MaskxN<4>(vandq_u32(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator|(MaskxN<4> a, MaskxN<4> b)
+    {
+        return MaskxN<4>(vorrq_u32(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<4> operator~(MaskxN<4> m)
+    {
+        return MaskxN<4>(vmvnq_u32(m.Native()));
+    }
+
+    inline uint32 ToBits(MaskxN<4> m)
+    {
+        const uint32 weights[4] = {1, 2, 4, 8};
+        return vaddvq_u32(vandq_u32(m.Native(), vld1q_u32(weights)));
+    }
+
+    inline bool Any(MaskxN<4> m)
+    {
+        return vmaxvq_u32(m.Native()) != 0;
+    }
+
+    inline bool All(MaskxN<4> m)
+    {
+        return vminvq_u32(m.Native()) != 0;
+    }
+
+    inline FloatxN<4> Select(MaskxN<4> mask, FloatxN<4> a, FloatxN<4> b)
+    {
+        return FloatxN<4>(vbslq_f32(mask.Native(), a.Native(), b.Native()));
+    }
+#endif
+
+    // 8 lanes
+
+#if RSBL_SIMD_AVX2
+    template <>
+    class MaskxN<8>
+    {
+      public:
+        static constexpr uint32 kWidth = 8;
+
+        MaskxN() = default;
+
+        explicit MaskxN(__m256 value)
+            : m_value(value)
+        {
+        }
+
+        __m256 Native() const
+        {
+            return m_value;
+        }
+
+      private:
+        __m256 m_value;
+    };
+
+    template <>
+    class FloatxN<8>
+    {
+      public:
+        static constexpr uint32 kWidth = 8;
+
+        FloatxN() = default;
+
+        explicit FloatxN(float v)
+            : m_value(_mm256_set1_ps(v))
+        {
+        }
+
+        explicit FloatxN(__m256 value)
+            : m_value(value)
+        {
+        }
+
+        static FloatxN LoadUnaligned(const float* ptr)
+        {
+            return FloatxN(_mm256_loadu_ps(ptr));
+        }
+
+        static FloatxN LoadAligned(const float* ptr)
+        {
+            return FloatxN(_mm256_load_ps(ptr));
+        }
+
+        __m256 Native() const
+        {
+            return m_value;
+        }
+
+        float Lane(uint32 i) const
+        {
+            alignas(32) float values[8];
+            _mm256_store_ps(values, m_value);
+            return values[i];
+        }
+
+      private:
+        __m256 m_value;
+    };
+
+    inline void StoreUnaligned(FloatxN<8> v, float* ptr)
+    {
+        _mm256_storeu_ps(ptr, v.Native());
+    }
+
+    inline void StoreAligned(FloatxN<8> v, float* ptr)
+    {
+        _mm256_store_ps(ptr, v.Native());
+    }
+
+    inline FloatxN<8> operator+(FloatxN<8> a, FloatxN<8> b)
+    {
+        return FloatxN<8>(_mm256_add_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<8> operator-(FloatxN<8> a, FloatxN<8> b)
+    {
+        return FloatxN<8>(_mm256_sub_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<8> operator*(FloatxN<8> a, FloatxN<8> b)
+    {
+        return FloatxN<8>(_mm256_mul_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<8> operator/(FloatxN<8> a, FloatxN<8> b)
+    {
+        return FloatxN<8>(_mm256_div_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<8> operator-(FloatxN<8> v)
+    {
+        return FloatxN<8>(_mm256_xor_ps(v.Native(), _mm256_set1_ps(-0.0f)));
+    }
+
+    inline FloatxN<8> MultiplyAdd(FloatxN<8> a, FloatxN<8> b, FloatxN<8> c)
+    {
+    #if RSBL_SIMD_FMA
+        return FloatxN<8>(_mm256_fmadd_ps(a.Native(), b.Native(), c.Native()));
+    #else
+        return FloatxN<8>(_mm256_add_ps(_mm256_mul_ps(a.Native(), b.Native()), c.Native()));
+    #endif
+    }
+
+    inline FloatxN<8> Min(FloatxN<8> a, FloatxN<8> b)
+    {
+        return FloatxN<8>(_mm256_min_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<8> Max(FloatxN<8> a, FloatxN<8> b)
+    {
+        return FloatxN<8>(_mm256_max_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<8> Abs(FloatxN<8> v)
+    {
+        return FloatxN<8>(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), v.Native()));
+    }
+
+    inline FloatxN<8> Sqrt(FloatxN<8> v)
+    {
+        return FloatxN<8>(_mm256_sqrt_ps(v.Native()));
+    }
+
+    inline MaskxN<8> operator<(FloatxN<8> a, FloatxN<8> b)
+    {
+        return MaskxN<8>(_mm256_cmp_ps(a.Native(), b.Native(), _CMP_LT_OQ));
+    }
+
+    inline MaskxN<8> operator<=(FloatxN<8> a, FloatxN<8> b)
+    {
+        return MaskxN<8>(_mm256_cmp_ps(a.Native(), b.Native(), _CMP_LE_OQ));
+    }
+
+    inline MaskxN<8> operator>(FloatxN<8> a, FloatxN<8> b)
+    {
+        return MaskxN<8>(_mm256_cmp_ps(a.Native(), b.Native(), _CMP_GT_OQ));
+    }
+
+    inline MaskxN<8> operator>=(FloatxN<8> a, FloatxN<8> b)
+    {
+        return MaskxN<8>(_mm256_cmp_ps(a.Native(), b.Native(), _CMP_GE_OQ));
+    }
+
+    inline MaskxN<8> operator==(FloatxN<8> a, FloatxN<8> b)
+    {
+        return MaskxN<8>(_mm256_cmp_ps(a.Native(), b.Native(), _CMP_EQ_OQ));
+    }
+
+    inline MaskxN<8> operator&(MaskxN<8> a, MaskxN<8> b)
+    {
+        return MaskxN<8>(_mm256_and_ps(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<8> operator|(MaskxN<8> a, MaskxN<8> b)
+    {
+        return MaskxN<8>(_mm256_or_ps(a.Native(), b.Native()));
+    }
+
+    inline MaskxN<8> operator~(MaskxN<8> m)
+    {
+        const __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        return MaskxN<8>(_mm256_xor_ps(m.Native(), all));
+    }
+
+    inline uint32 ToBits(MaskxN<8> m)
+    {
+        return static_cast<uint32>(_mm256_movemask_ps(m.Native()));
+    }
+
+    inline bool Any(MaskxN<8> m)
+    {
+        return ToBits(m) != 0;
+    }
+
+    inline bool All(MaskxN<8> m)
+    {
+        return ToBits(m) == 0xff;
+    }
+
+    inline FloatxN<8> Select(MaskxN<8> mask, FloatxN<8> a, FloatxN<8> b)
+    {
+        return FloatxN<8>(_mm256_blendv_ps(b.Native(), a.Native(), mask.Native()));
+    }
+#endif
+
+    // 16 lanes
+
+#if RSBL_SIMD_AVX512
+    template <>
+    class MaskxN<16>
+    {
+      public:
+        static constexpr uint32 kWidth = 16;
+
+        MaskxN() = default;
+
+        explicit MaskxN(__mmask16 value)
+            : m_value(value)
+        {
+        }
+
+        __mmask16 Native() const
+        {
+            return m_value;
+        }
+
+      private:
+        __mmask16 m_value;
+    };
+
+    template <>
+    class FloatxN<16>
+    {
+      public:
+        static constexpr uint32 kWidth = 16;
+
+        FloatxN() = default;
+
+        explicit FloatxN(float v)
+            : m_value(_mm512_set1_ps(v))
+        {
+        }
+
+        explicit FloatxN(__m512 value)
+            : m_value(value)
+        {
+        }
+
+        static FloatxN LoadUnaligned(const float* ptr)
+        {
+            return FloatxN(_mm512_loadu_ps(ptr));
+        }
+
+        static FloatxN LoadAligned(const float* ptr)
+        {
+            return FloatxN(_mm512_load_ps(ptr));
+        }
+
+        __m512 Native() const
+        {
+            return m_value;
+        }
+
+        float Lane(uint32 i) const
+        {
+            alignas(64) float values[16];
+            _mm512_store_ps(values, m_value);
+            return values[i];
+        }
+
+      private:
+        __m512 m_value;
+    };
+
+    inline void StoreUnaligned(FloatxN<16> v, float* ptr)
+    {
+        _mm512_storeu_ps(ptr, v.Native());
+    }
+
+    inline void StoreAligned(FloatxN<16> v, float* ptr)
+    {
+        _mm512_store_ps(ptr, v.Native());
+    }
+
+    inline FloatxN<16> operator+(FloatxN<16> a, FloatxN<16> b)
+    {
+        return FloatxN<16>(_mm512_add_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<16> operator-(FloatxN<16> a, FloatxN<16> b)
+    {
+        return FloatxN<16>(_mm512_sub_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<16> operator*(FloatxN<16> a, FloatxN<16> b)
+    {
+        return FloatxN<16>(_mm512_mul_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<16> operator/(FloatxN<16> a, FloatxN<16> b)
+    {
+        return FloatxN<16>(_mm512_div_ps(a.Native(), b.Native()));
+    }
+
+    // Float xor needs AVX512DQ, the integer one is in AVX512F
+    inline FloatxN<16> operator-(FloatxN<16> v)
+    {
+        const __m512i sign = _mm512_set1_epi32(static_cast<int>(0x80000000u));
+        return FloatxN<16>(_mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(v.Native()),
+                                                                sign)));
+    }
+
+    inline FloatxN<16> MultiplyAdd(FloatxN<16> a, FloatxN<16> b, FloatxN<16> c)
+    {
+        return FloatxN<16>(_mm512_fmadd_ps(a.Native(), b.Native(), c.Native()));
+    }
+
+    inline FloatxN<16> Min(FloatxN<16> a, FloatxN<16> b)
+    {
+        return FloatxN<16>(_mm512_min_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<16> Max(FloatxN<16> a, FloatxN<16> b)
+    {
+        return FloatxN<16>(_mm512_max_ps(a.Native(), b.Native()));
+    }
+
+    inline FloatxN<16> Abs(FloatxN<16> v)
+    {
+        return FloatxN<16>(_mm512_abs_ps(v.Native()));
+    }
+
+    inline FloatxN<16> Sqrt(FloatxN<16> v)
+    {
+        return FloatxN<16>(_mm512_sqrt_ps(v.Native()));
+    }
+
+    inline MaskxN<16> operator<(FloatxN<16> a, FloatxN<16> b)
+    {
+        return MaskxN<16>(_mm512_cmp_ps_mask(a.Native(), b.Native(), _CMP_LT_OQ));
+    }
+
+    inline MaskxN<16> operator<=(FloatxN<16> a, FloatxN<16> b)
+    {
+        return MaskxN<16>(_mm512_cmp_ps_mask(a.Native(), b.Native(), _CMP_LE_OQ));
+    }
+
+    inline MaskxN<16> operator>(FloatxN<16> a, FloatxN<16> b)
+    {
+        return MaskxN<16>(_mm512_cmp_ps_mask(a.Native(), b.Native(), _CMP_GT_OQ));
+    }
+
+    inline MaskxN<16> operator>=(FloatxN<16> a, FloatxN<16> b)
+    {
+        return MaskxN<16>(_mm512_cmp_ps_mask(a.Native(), b.Native(), _CMP_GE_OQ));
+    }
+
+    inline MaskxN<16> operator==(FloatxN<16> a, FloatxN<16> b)
+    {
+        return MaskxN<16>(_mm512_cmp_ps_mask(a.Native(), b.Native(), _CMP_EQ_OQ));
+    }
+
+    inline MaskxN<16> operator&(MaskxN<16> a, MaskxN<16> b)
+    {
+        return MaskxN<16>(static_cast<__mmask16>(a.Native() & b.Native()));
+    }
+
+    inline MaskxN<16> operator|(MaskxN<16> a, MaskxN<16> b)
+    {
+        return MaskxN<16>(static_cast<__mmask16>(a.Native() | b.Native()));
+    }
+
+    inline MaskxN<16> operator~(MaskxN<16> m)
+    {
+        return MaskxN<16>(static_cast<__mmask16>(~m.Native()));
+    }
+
+    inline uint32 ToBits(MaskxN<16> m)
+    {
+        return m.Native();
+    }
+
+    inline bool Any(MaskxN<16> m)
+    {
+        return m.Native() != 0;
+    }
+
+    inline bool All(MaskxN<16> m)
+    {
+        return m.Native() == 0xffff;
+    }
+
+    inline FloatxN<16> Select(MaskxN<16> mask, FloatxN<16> a, FloatxN<16> b)
+    {
+        return FloatxN<16>(_mm512_mask_blend_ps(mask.Native(), b.Native(), a.Native()));
+    }
+#endif
+
+    // W positions or directions, built on whichever FloatxN<W> is available
+
+    template <uint32 Width>
+    struct Vec3xN
+    {
+        static constexpr uint32 kWidth = Width;
+
+        FloatxN<Width> x;
+        FloatxN<Width> y;
+        FloatxN<Width> z;
+
+        Vec3xN() = default;
+
+        Vec3xN(FloatxN<Width> vx, FloatxN<Width> vy, FloatxN<Width> vz)
+            : x(vx)
+            , y(vy)
+            , z(vz)
+        {
+        }
+
+        // Same vector in every lane
+        Vec3xN(float vx, float vy, float vz)
+            : x(vx)
+            , y(vy)
+            , z(vz)
+        {
+        }
+
+        // Lanes come from Width consecutive elements of each SoA array
+        static Vec3xN LoadUnaligned(const float* xs, const float* ys, const float* zs)
+        {
+            return Vec3xN(FloatxN<Width>::LoadUnaligned(xs), FloatxN<Width>::LoadUnaligned(ys),
+                          FloatxN<Width>::LoadUnaligned(zs));
+        }
+    };
+
+    template <uint32 W>
+    inline void StoreUnaligned(const Vec3xN<W>& v, float* xs, float* ys, float* zs)
+    {
+        StoreUnaligned(v.x, xs);
+        StoreUnaligned(v.y, ys);
+        StoreUnaligned(v.z, zs);
+    }
+
+    template <uint32 W>
+    inline Vec3xN<W> operator+(const Vec3xN<W>& a, const Vec3xN<W>& b)
+    {
+        return Vec3xN<W>(a.x + b.x, a.y + b.y, a.z + b.z);
+    }
+
+    template <uint32 W>
+    inline Vec3xN<W> operator-(const Vec3xN<W>& a, const Vec3xN<W>& b)
+    {
+        return Vec3xN<W>(a.x - b.x, a.y - b.y, a.z - b.z);
+    }
+
+    template <uint32 W>
+    inline Vec3xN<W> operator*(const Vec3xN<W>& v, FloatxN<W> s)
+    {
+        return Vec3xN<W>(v.x * s, v.y * s, v.z * s);
+    }
+
+    // a * s + b
+    template <uint32 W>
+    inline Vec3xN<W> MultiplyAdd(const Vec3xN<W>& a, FloatxN<W> s, const Vec3xN<W>& b)
+    {
+        return Vec3xN<W>(MultiplyAdd(a.x, s, b.x), MultiplyAdd(a.y, s, b.y),
+                         MultiplyAdd(a.z, s, b.z));
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> Dot(const Vec3xN<W>& a, const Vec3xN<W>& b)
+    {
+        return MultiplyAdd(a.x, b.x, MultiplyAdd(a.y, b.y, a.z * b.z));
+    }
+
+    template <uint32 W>
+    inline Vec3xN<W> Cross(const Vec3xN<W>& a, const Vec3xN<W>& b)
+    {
+        return Vec3xN<W>(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> LengthSquared(const Vec3xN<W>& v)
+    {
+        return Dot(v, v);
+    }
+
+    template <uint32 W>
+    inline FloatxN<W> Length(const Vec3xN<W>& v)
+    {
+        return Sqrt(Dot(v, v));
+    }
+
+    // Zero-length lanes come out as NaN
+    template <uint32 W>
+    inline Vec3xN<W> Normalize(const Vec3xN<W>& v)
+    {
+        return v * (FloatxN<W>(1.0f) / Length(v));
+    }
+} // namespace RSBL_SIMD_ISA
+} // namespace simd
+} // namespace rsbl
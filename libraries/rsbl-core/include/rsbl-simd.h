@@ -0,0 +1,775 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-int-types.h"
+#include "rsbl-math-types.h"
+#include "rsbl-simd-config.h"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+// Register types for vector math. rsbl::float4 and friends are for storage (buffers, components,
+// files), simd::float4 is what you do math with: load, compute, store. Everything is inline and
+// works on whole registers, so a float3 loaded into a simd::float4 carries a w along with it.
+// Functions with a 3 suffix ignore w.
+//
+// Everything here is constexpr, so constants and tables can be built at compile time. Constant
+// evaluation runs the scalar code (the same code a build without SIMD uses), the intrinsics only
+// run at runtime. The two agree bit for bit, except MultiplyAdd on NEON, which fuses at runtime.
+
+namespace rsbl
+{
+namespace simd
+{
+    namespace Internal
+    {
+        struct alignas(16) ScalarFloat4
+        {
+            float v[4];
+        };
+
+        // sqrt for constant evaluation, where sqrtf isn't available. Newton's method in double,
+        // which rounds to the same float sqrtf gives.
+        constexpr float ConstSqrt(float value)
+        {
+            if (!(value > 0.0f) || value == std::numeric_limits<float>::infinity())
+            {
+                // Zeros and infinity are their own square root, negatives and NaN give NaN
+                return value >= 0.0f ? value : std::numeric_limits<float>::quiet_NaN();
+            }
+
+            // Halving the exponent gets within 6% of the root, five steps take that past double
+            // precision
+            const double d = value;
+            double x = std::bit_cast<double>((std::bit_cast<uint64>(d) >> 1) +
+                                             (std::bit_cast<uint64>(1.0) >> 1));
+            for (uint32 i = 0; i < 5; ++i)
+            {
+                x = 0.5 * (x + d / x);
+            }
+            return static_cast<float>(x);
+        }
+
+        constexpr float ConstAbs(float value)
+        {
+            return std::bit_cast<float>(std::bit_cast<uint32>(value) & 0x7fffffffu);
+        }
+    } // namespace Internal
+
+#if RSBL_SIMD_SSE
+    using NativeFloat4 = __m128;
+#elif RSBL_SIMD_NEON
+    using NativeFloat4 = float32x4_t;
+#else
+    using NativeFloat4 = Internal::ScalarFloat4;
+#endif
+
+    class float4
+    {
+      public:
+        // Uninitialized, like the storage types
+        float4() = default;
+
+        constexpr explicit float4(float v)
+        {
+            if consteval
+            {
+                m_lanes = {{v, v, v, v}};
+                return;
+            }
+#if RSBL_SIMD_SSE
+            m_value = _mm_set1_ps(v);
+#elif RSBL_SIMD_NEON
+            m_value = vdupq_n_f32(v);
+#else
+            m_value = {{v, v, v, v}};
+#endif
+        }
+
+        constexpr float4(float x, float y, float z, float w)
+        {
+            if consteval
+            {
+                m_lanes = {{x, y, z, w}};
+                return;
+            }
+#if RSBL_SIMD_SSE
+            m_value = _mm_setr_ps(x, y, z, w);
+#elif RSBL_SIMD_NEON
+            const float values[4] = {x, y, z, w};
+            m_value = vld1q_f32(values);
+#else
+            m_value = {{x, y, z, w}};
+#endif
+        }
+
+        explicit float4(NativeFloat4 value)
+            : m_value(value)
+        {
+        }
+
+        NativeFloat4 Native() const
+        {
+            return m_value;
+        }
+
+        constexpr float X() const
+        {
+            if consteval
+            {
+                return m_lanes.v[0];
+            }
+#if RSBL_SIMD_SSE
+            return _mm_cvtss_f32(m_value);
+#elif RSBL_SIMD_NEON
+            return vgetq_lane_f32(m_value, 0);
+#else
+            return m_value.v[0];
+#endif
+        }
+
+        constexpr float Y() const
+        {
+            if consteval
+            {
+                return m_lanes.v[1];
+            }
+#if RSBL_SIMD_SSE
+            return _mm_cvtss_f32(_mm_shuffle_ps(m_value, m_value, _MM_SHUFFLE(1, 1, 1, 1)));
+#elif RSBL_SIMD_NEON
+            return vgetq_lane_f32(m_value, 1);
+#else
+            return m_value.v[1];
+#endif
+        }
+
+        constexpr float Z() const
+        {
+            if consteval
+            {
+                return m_lanes.v[2];
+            }
+#if RSBL_SIMD_SSE
+            return _mm_cvtss_f32(_mm_movehl_ps(m_value, m_value));
+#elif RSBL_SIMD_NEON
+            return vgetq_lane_f32(m_value, 2);
+#else
+            return m_value.v[2];
+#endif
+        }
+
+        constexpr float W() const
+        {
+            if consteval
+            {
+                return m_lanes.v[3];
+            }
+#if RSBL_SIMD_SSE
+            return _mm_cvtss_f32(_mm_shuffle_ps(m_value, m_value, _MM_SHUFFLE(3, 3, 3, 3)));
+#elif RSBL_SIMD_NEON
+            return vgetq_lane_f32(m_value, 3);
+#else
+            return m_value.v[3];
+#endif
+        }
+
+      private:
+        // Constant evaluation can't touch the native type, so it builds m_lanes instead. A
+        // constexpr float4 that gets used at runtime is read back through m_value, the same
+        // bytes either way.
+        union
+        {
+            NativeFloat4 m_value;
+            Internal::ScalarFloat4 m_lanes;
+        };
+    };
+
+    // Loads and stores
+
+    constexpr float4 Zero()
+    {
+#if RSBL_SIMD_SSE
+        if !consteval
+        {
+            return float4(_mm_setzero_ps());
+        }
+#endif
+        return float4(0.0f);
+    }
+
+    // ptr must be 16 byte aligned
+    constexpr float4 LoadAligned(const float* ptr)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            return float4(_mm_load_ps(ptr));
+#elif RSBL_SIMD_NEON
+            return float4(vld1q_f32(ptr));
+#endif
+        }
+        return float4(ptr[0], ptr[1], ptr[2], ptr[3]);
+    }
+
+    constexpr float4 LoadUnaligned(const float* ptr)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            return float4(_mm_loadu_ps(ptr));
+#elif RSBL_SIMD_NEON
+            return float4(vld1q_f32(ptr));
+#endif
+        }
+        return float4(ptr[0], ptr[1], ptr[2], ptr[3]);
+    }
+
+    constexpr float4 Load(const rsbl::float4& v)
+    {
+        if !consteval
+        {
+            return LoadUnaligned(&v.x);
+        }
+        // Constant evaluation can't index past x
+        return float4(v.x, v.y, v.z, v.w);
+    }
+
+    // Only reads 12 bytes, so it's safe on the last element of an array
+    constexpr float4 Load(const rsbl::float3& v, float w = 0.0f)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            const __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(&v.x)));
+            const __m128 zw = _mm_setr_ps(v.z, w, 0.0f, 0.0f);
+            return float4(_mm_movelh_ps(xy, zw));
+#elif RSBL_SIMD_NEON
+            const float32x2_t xy = vld1_f32(&v.x);
+            const float zw_values[2] = {v.z, w};
+            return float4(vcombine_f32(xy, vld1_f32(zw_values)));
+#endif
+        }
+        return float4(v.x, v.y, v.z, w);
+    }
+
+    constexpr float4 Load(const rsbl::float2& v, float z = 0.0f, float w = 0.0f)
+    {
+        return float4(v.x, v.y, z, w);
+    }
+
+    // ptr must be 16 byte aligned
+    constexpr void StoreAligned(float4 v, float* ptr)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            _mm_store_ps(ptr, v.Native());
+            return;
+#elif RSBL_SIMD_NEON
+            vst1q_f32(ptr, v.Native());
+            return;
+#endif
+        }
+        ptr[0] = v.X();
+        ptr[1] = v.Y();
+        ptr[2] = v.Z();
+        ptr[3] = v.W();
+    }
+
+    constexpr void StoreUnaligned(float4 v, float* ptr)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            _mm_storeu_ps(ptr, v.Native());
+            return;
+#elif RSBL_SIMD_NEON
+            vst1q_f32(ptr, v.Native());
+            return;
+#endif
+        }
+        ptr[0] = v.X();
+        ptr[1] = v.Y();
+        ptr[2] = v.Z();
+        ptr[3] = v.W();
+    }
+
+    constexpr void Store(float4 v, rsbl::float4& out)
+    {
+        if !consteval
+        {
+            StoreUnaligned(v, &out.x);
+            return;
+        }
+        out = rsbl::float4(v.X(), v.Y(), v.Z(), v.W());
+    }
+
+    // Only writes 12 bytes
+    constexpr void Store(float4 v, rsbl::float3& out)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            _mm_store_sd(reinterpret_cast<double*>(&out.x), _mm_castps_pd(v.Native()));
+            _mm_store_ss(&out.z, _mm_movehl_ps(v.Native(), v.Native()));
+            return;
+#elif RSBL_SIMD_NEON
+            vst1_f32(&out.x, vget_low_f32(v.Native()));
+            out.z = vgetq_lane_f32(v.Native(), 2);
+            return;
+#endif
+        }
+        out = rsbl::float3(v.X(), v.Y(), v.Z());
+    }
+
+    constexpr void Store(float4 v, rsbl::float2& out)
+    {
+        out = rsbl::float2(v.X(), v.Y());
+    }
+
+    constexpr rsbl::float4 ToFloat4(float4 v)
+    {
+        if !consteval
+        {
+            rsbl::float4 out;
+            Store(v, out);
+            return out;
+        }
+        return rsbl::float4(v.X(), v.Y(), v.Z(), v.W());
+    }
+
+    constexpr rsbl::float3 ToFloat3(float4 v)
+    {
+        if !consteval
+        {
+            rsbl::float3 out;
+            Store(v, out);
+            return out;
+        }
+        return rsbl::float3(v.X(), v.Y(), v.Z());
+    }
+
+    constexpr rsbl::float2 ToFloat2(float4 v)
+    {
+        return rsbl::float2(v.X(), v.Y());
+    }
+
+    // Shuffles
+
+    namespace Internal
+    {
+        template <uint32 Index>
+        constexpr float Lane(float4 v)
+        {
+            static_assert(Index < 4);
+            if constexpr (Index == 0)
+            {
+                return v.X();
+            }
+            else if constexpr (Index == 1)
+            {
+                return v.Y();
+            }
+            else if constexpr (Index == 2)
+            {
+                return v.Z();
+            }
+            else
+            {
+                return v.W();
+            }
+        }
+    } // namespace Internal
+
+    // Lanes picked by index at compile time, Swizzle<2, 1, 0, 3>(v) is (z y x w). Each pattern
+    // compiles to one shuffle.
+    template <uint32 X, uint32 Y, uint32 Z, uint32 W>
+    constexpr float4 Swizzle(float4 v)
+    {
+        static_assert(X < 4 && Y < 4 && Z < 4 && W < 4, "Swizzle lanes are 0 to 3");
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            return float4(_mm_shuffle_ps(v.Native(), v.Native(), _MM_SHUFFLE(W, Z, Y, X)));
+#elif RSBL_SIMD_NEON
+            if constexpr (X == Y && Y == Z && Z == W)
+            {
+                return float4(vdupq_laneq_f32(v.Native(), X));
+            }
+            else
+            {
+                float32x4_t result = vdupq_n_f32(vgetq_lane_f32(v.Native(), X));
+                result = vsetq_lane_f32(vgetq_lane_f32(v.Native(), Y), result, 1);
+                result = vsetq_lane_f32(vgetq_lane_f32(v.Native(), Z), result, 2);
+                return float4(vsetq_lane_f32(vgetq_lane_f32(v.Native(), W), result, 3));
+            }
+#endif
+        }
+        return float4(Internal::Lane<X>(v), Internal::Lane<Y>(v), Internal::Lane<Z>(v),
+                      Internal::Lane<W>(v));
+    }
+
+    // Broadcast one component to all four
+
+    constexpr float4 SplatX(float4 v)
+    {
+        return Swizzle<0, 0, 0, 0>(v);
+    }
+
+    constexpr float4 SplatY(float4 v)
+    {
+        return Swizzle<1, 1, 1, 1>(v);
+    }
+
+    constexpr float4 SplatZ(float4 v)
+    {
+        return Swizzle<2, 2, 2, 2>(v);
+    }
+
+    constexpr float4 SplatW(float4 v)
+    {
+        return Swizzle<3, 3, 3, 3>(v);
+    }
+
+    // Replaces one component
+
+    constexpr float4 SetW(float4 v, float w)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            // Put w next to z, then pick x y from v and z w from the pair
+            const __m128 zw = _mm_unpackhi_ps(v.Native(), _mm_set1_ps(w));
+            return float4(_mm_shuffle_ps(v.Native(), zw, _MM_SHUFFLE(3, 0, 1, 0)));
+#elif RSBL_SIMD_NEON
+            return float4(vsetq_lane_f32(w, v.Native(), 3));
+#endif
+        }
+        return float4(v.X(), v.Y(), v.Z(), w);
+    }
+
+    // Transposes the 4x4 matrix whose rows (or columns) are a, b, c, d
+    constexpr void Transpose(float4& a, float4& b, float4& c, float4& d)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            __m128 r0 = a.Native();
+            __m128 r1 = b.Native();
+            __m128 r2 = c.Native();
+            __m128 r3 = d.Native();
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            a = float4(r0);
+            b = float4(r1);
+            c = float4(r2);
+            d = float4(r3);
+            return;
+#elif RSBL_SIMD_NEON
+            const float32x4x2_t ab = vtrnq_f32(a.Native(), b.Native());
+            const float32x4x2_t cd = vtrnq_f32(c.Native(), d.Native());
+            a = float4(vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0])));
+            b = float4(vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1])));
+            c = float4(vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0])));
+            d = float4(vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1])));
+            return;
+#endif
+        }
+        const float4 r0(a.X(), b.X(), c.X(), d.X());
+        const float4 r1(a.Y(), b.Y(), c.Y(), d.Y());
+        const float4 r2(a.Z(), b.Z(), c.Z(), d.Z());
+        const float4 r3(a.W(), b.W(), c.W(), d.W());
+        a = r0;
+        b = r1;
+        c = r2;
+        d = r3;
+    }
+
+    // Arithmetic, all component-wise
+
+    namespace Internal
+    {
+        template <typename Op>
+        constexpr float4 ScalarMap(float4 a, float4 b, Op op)
+        {
+            return float4(op(a.X(), b.X()), op(a.Y(), b.Y()), op(a.Z(), b.Z()),
+                          op(a.W(), b.W()));
+        }
+    } // namespace Internal
+
+    constexpr float4 operator+(float4 a, float4 b)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            return float4(_mm_add_ps(a.Native(), b.Native()));
+#elif RSBL_SIMD_NEON
+            return float4(vaddq_f32(a.Native(), b.Native()));
+#endif
+        }
+        return Internal::ScalarMap(a, b, [](float x, float y) { return x + y; });
+    }
+
+    constexpr float4 operator-(float4 a, float4 b)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            return float4(_mm_sub_ps(a.Native(), b.Native()));
+#elif RSBL_SIMD_NEON
+            return float4(vsubq_f32(a.Native(), b.Native()));
+#endif
+        }
+        return Internal::ScalarMap(a, b, [](float x, float y) { return x - y; });
+    }
+
+    constexpr float4 operator*(float4 a, float4 b)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            return float4(_mm_mul_ps(a.Native(), b.Native()));
+#elif RSBL_SIMD_NEON
+            return float4(vmulq_f32(a.Native(), b.Native()));
+#endif
+        }
+        return Internal::ScalarMap(a, b, [](float x, float y) { return x * y; });
+    }
+
+    constexpr float4 operator/(float4 a, float4 b)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            return float4(_mm_div_ps(a.Native(), b.Native()));
+#elif RSBL_SIMD_NEON
+            return float4(vdivq_f32(a.Native(), b.Native()));
+#endif
+        }
+        return Internal::ScalarMap(a, b, [](float x, float y) { return x / y; });
+    }
+
+    constexpr float4 operator-(float4 v)
+    {
+        return Zero() - v;
+    }
+
+    constexpr float4 operator*(float4 v, float s)
+    {
+        return v * float4(s);
+    }
+
+    constexpr float4 operator*(float s, float4 v)
+    {
+        return float4(s) * v;
+    }
+
+    constexpr float4 operator/(float4 v, float s)
+    {
+        return v / float4(s);
+    }
+
+    constexpr float4& operator+=(float4& a, float4 b)
+    {
+        a = a + b;
+        return a;
+    }
+
+    constexpr float4& operator-=(float4& a, float4 b)
+    {
+        a = a - b;
+        return a;
+    }
+
+    constexpr float4& operator*=(float4& a, float4 b)
+    {
+        a = a * b;
+        return a;
+    }
+
+    constexpr float4& operator*=(float4& a, float s)
+    {
+        a = a * s;
+        return a;
+    }
+
+    constexpr float4& operator/=(float4& a, float4 b)
+    {
+        a = a / b;
+        return a;
+    }
+
+    constexpr float4& operator/=(float4& a, float s)
+    {
+        a = a / s;
+        return a;
+    }
+
+    // a * b + c, fused where the target has FMA
+    constexpr float4 MultiplyAdd(float4 a, float4 b, float4 c)
+    {
+#if RSBL_SIMD_NEON
+        if !consteval
+        {
+            return float4(vfmaq_f32(c.Native(), a.Native(), b.Native()));
+        }
+#endif
+        return a * b + c;
+    }
+
+    constexpr float4 Min(float4 a, float4 b)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            return float4(_mm_min_ps(a.Native(), b.Native()));
+#elif RSBL_SIMD_NEON
+            return float4(vminq_f32(a.Native(), b.Native()));
+#endif
+        }
+        return Internal::ScalarMap(a, b, [](float x, float y) { return x < y ? x : y; });
+    }
+
+    constexpr float4 Max(float4 a, float4 b)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            return float4(_mm_max_ps(a.Native(), b.Native()));
+#elif RSBL_SIMD_NEON
+            return float4(vmaxq_f32(a.Native(), b.Native()));
+#endif
+        }
+        return Internal::ScalarMap(a, b, [](float x, float y) { return x > y ? x : y; });
+    }
+
+    constexpr float4 Clamp(float4 v, float4 low, float4 high)
+    {
+        return Min(Max(v, low), high);
+    }
+
+    constexpr float4 Abs(float4 v)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            return float4(_mm_andnot_ps(_mm_set1_ps(-0.0f), v.Native()));
+#elif RSBL_SIMD_NEON
+            return float4(vabsq_f32(v.Native()));
+#endif
+        }
+        return float4(Internal::ConstAbs(v.X()), Internal::ConstAbs(v.Y()),
+                      Internal::ConstAbs(v.Z()), Internal::ConstAbs(v.W()));
+    }
+
+    constexpr float4 Sqrt(float4 v)
+    {
+        if consteval
+        {
+            return float4(Internal::ConstSqrt(v.X()), Internal::ConstSqrt(v.Y()),
+                          Internal::ConstSqrt(v.Z()), Internal::ConstSqrt(v.W()));
+        }
+#if RSBL_SIMD_SSE
+        return float4(_mm_sqrt_ps(v.Native()));
+#elif RSBL_SIMD_NEON
+        return float4(vsqrtq_f32(v.Native()));
+#else
+        return float4(sqrtf(v.X()), sqrtf(v.Y()), sqrtf(v.Z()), sqrtf(v.W()));
+#endif
+    }
+
+    // a + (b - a) * t, t = 0 gives a and t = 1 gives b
+    constexpr float4 Lerp(float4 a, float4 b, float4 t)
+    {
+        return MultiplyAdd(b - a, t, a);
+    }
+
+    constexpr float4 Lerp(float4 a, float4 b, float t)
+    {
+        return Lerp(a, b, float4(t));
+    }
+
+    // Geometry
+
+    constexpr float Dot4(float4 a, float4 b)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            const __m128 product = _mm_mul_ps(a.Native(), b.Native());
+            const __m128 swapped = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1));
+            const __m128 pairs = _mm_add_ps(product, swapped);
+            return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehl_ps(swapped, pairs)));
+#elif RSBL_SIMD_NEON
+            return vaddvq_f32(vmulq_f32(a.Native(), b.Native()));
+#endif
+        }
+        // Pairwise, in the same order as the SSE and NEON reductions
+        return (a.X() * b.X() + a.Y() * b.Y()) + (a.Z() * b.Z() + a.W() * b.W());
+    }
+
+    constexpr float Dot3(float4 a, float4 b)
+    {
+        if !consteval
+        {
+#if RSBL_SIMD_SSE
+            const __m128 product = _mm_mul_ps(a.Native(), b.Native());
+            const __m128 y = _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1));
+            const __m128 z = _mm_movehl_ps(product, product);
+            return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(product, y), z));
+#elif RSBL_SIMD_NEON
+            return vaddvq_f32(vsetq_lane_f32(0.0f, vmulq_f32(a.Native(), b.Native()), 3));
+#endif
+        }
+        return a.X() * b.X() + a.Y() * b.Y() + a.Z() * b.Z();
+    }
+
+    // w of the result is 0
+    constexpr float4 Cross3(float4 a, float4 b)
+    {
+#if RSBL_SIMD_SSE
+        if !consteval
+        {
+            const __m128 aYzx = _mm_shuffle_ps(a.Native(), a.Native(), _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 bYzx = _mm_shuffle_ps(b.Native(), b.Native(), _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 zxy =
+                _mm_sub_ps(_mm_mul_ps(a.Native(), bYzx), _mm_mul_ps(aYzx, b.Native()));
+            return float4(_mm_shuffle_ps(zxy, zxy, _MM_SHUFFLE(3, 0, 2, 1)));
+        }
+#endif
+        return float4(a.Y() * b.Z() - a.Z() * b.Y(), a.Z() * b.X() - a.X() * b.Z(),
+                      a.X() * b.Y() - a.Y() * b.X(), 0.0f);
+    }
+
+    constexpr float Length3(float4 v)
+    {
+        if consteval
+        {
+            return Internal::ConstSqrt(Dot3(v, v));
+        }
+        return sqrtf(Dot3(v, v));
+    }
+
+    constexpr float Length4(float4 v)
+    {
+        if consteval
+        {
+            return Internal::ConstSqrt(Dot4(v, v));
+        }
+        return sqrtf(Dot4(v, v));
+    }
+
+    // Zero length vectors come back as NaN
+    constexpr float4 Normalize3(float4 v)
+    {
+        return v / Length3(v);
+    }
+
+    constexpr float4 Normalize4(float4 v)
+    {
+        return v / Length4(v);
+    }
+} // namespace simd
+} // namespace rsbl
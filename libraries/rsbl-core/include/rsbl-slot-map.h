@@ -0,0 +1,255 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-core.h"
+#include "rsbl-dynamic-array.h"
+#include "rsbl-hash.h"
+#include "rsbl-int-types.h"
+
+namespace rsbl
+{
+
+// Generational handle into a SlotMap. The default handle is never valid.
+struct SlotHandle
+{
+    uint32 index = 0;
+    uint32 generation = 0;
+
+    bool IsNull() const
+    {
+        return generation == 0;
+    }
+
+    bool operator==(const SlotHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const SlotHandle& other) const
+    {
+        return !(*this == other);
+    }
+
+    // Pack into 64 bits for passing across APIs, e.g. as an opaque user pointer
+    uint64 ToUint64() const
+    {
+        return (uint64(generation) << 32) | index;
+    }
+
+    static SlotHandle FromUint64(uint64 packed)
+    {
+        return SlotHandle{static_cast<uint32>(packed), static_cast<uint32>(packed >> 32)};
+    }
+};
+
+template <>
+struct Hash<SlotHandle>
+{
+    uint64 operator()(const SlotHandle& handle) const
+    {
+        return HashMix(handle.ToUint64());
+    }
+};
+
+// Objects are stored densely (removal swaps the last object into the hole), and handed out as
+// SlotHandles that stay stable while the objects move around. Insert, Remove and Get are all
+// O(1), and a handle to a removed object is detected by the generation check.
+// Iterating the SlotMap walks the dense array directly.
+template <typename T>
+class SlotMap
+{
+  private:
+    struct Slot
+    {
+        uint32 denseIndex; // Next free slot while on the free list
+        uint32 generation;
+    };
+
+    static constexpr uint32 kEndOfFreeList = ~uint32(0);
+
+    DynamicArray<T> m_values;
+    DynamicArray<uint32> m_denseToSlot;
+    DynamicArray<Slot> m_slots;
+    uint32 m_freeHead = kEndOfFreeList;
+
+    const Slot* LiveSlot(SlotHandle handle) const
+    {
+        if (handle.index >= m_slots.Size())
+        {
+            return nullptr;
+        }
+
+        const Slot& slot = m_slots[handle.index];
+        if (slot.generation != handle.generation || slot.denseIndex >= m_values.Size() ||
+            m_denseToSlot[slot.denseIndex] != handle.index)
+        {
+            return nullptr;
+        }
+        return &slot;
+    }
+
+  public:
+    SlotMap() = default;
+
+    // The allocator must outlive the SlotMap
+    explicit SlotMap(Allocator* allocator)
+        : m_values(allocator)
+        , m_denseToSlot(allocator)
+        , m_slots(allocator)
+    {
+    }
+
+    template <typename... Args>
+    SlotHandle Emplace(Args&&... args)
+    {
+        uint32 slotIndex;
+        if (m_freeHead != kEndOfFreeList)
+        {
+            slotIndex = m_freeHead;
+            m_freeHead = m_slots[slotIndex].denseIndex;
+        }
+        else
+        {
+            slotIndex = static_cast<uint32>(m_slots.Size());
+            m_slots.PushBack(Slot{0, 1});
+        }
+
+        Slot& slot = m_slots[slotIndex];
+        slot.denseIndex = static_cast<uint32>(m_values.Size());
+        m_values.EmplaceBack(rsblForward(args)...);
+        m_denseToSlot.PushBack(slotIndex);
+
+        return SlotHandle{slotIndex, slot.generation};
+    }
+
+    SlotHandle Insert(const T& value)
+    {
+        return Emplace(value);
+    }
+
+    SlotHandle Insert(T&& value)
+    {
+        return Emplace(rsblMove(value));
+    }
+
+    // Returns false if the handle was stale or null
+    bool Remove(SlotHandle handle)
+    {
+        if (LiveSlot(handle) == nullptr)
+        {
+            return false;
+        }
+
+        Slot& slot = m_slots[handle.index];
+        const uint32 denseIndex = slot.denseIndex;
+        const uint32 lastIndex = static_cast<uint32>(m_values.Size() - 1);
+
+        // Fill the hole with the last object to keep the array dense
+        if (denseIndex != lastIndex)
+        {
+            m_values[denseIndex].~T();
+            new (&m_values[denseIndex]) T(rsblMove(m_values[lastIndex]));
+            m_denseToSlot[denseIndex] = m_denseToSlot[lastIndex];
+            m_slots[m_denseToSlot[denseIndex]].denseIndex = denseIndex;
+        }
+        m_values.PopBack();
+        m_denseToSlot.PopBack();
+
+        // Bump the generation so outstanding handles go stale. Skip 0, that's the null handle.
+        ++slot.generation;
+        if (slot.generation == 0)
+        {
+            slot.generation = 1;
+        }
+        slot.denseIndex = m_freeHead;
+        m_freeHead = handle.index;
+        return true;
+    }
+
+    // Returns nullptr for stale or null handles. Pointers are invalidated by Insert and Remove.
+    T* Get(SlotHandle handle)
+    {
+        const Slot* slot = LiveSlot(handle);
+        return slot != nullptr ? &m_values[slot->denseIndex] : nullptr;
+    }
+
+    const T* Get(SlotHandle handle) const
+    {
+        const Slot* slot = LiveSlot(handle);
+        return slot != nullptr ? &m_values[slot->denseIndex] : nullptr;
+    }
+
+    bool Contains(SlotHandle handle) const
+    {
+        return LiveSlot(handle) != nullptr;
+    }
+
+    // Handle for the object at a dense index, handy while iterating
+    SlotHandle HandleAt(uint64 denseIndex) const
+    {
+        const uint32 slotIndex = m_denseToSlot[denseIndex];
+        return SlotHandle{slotIndex, m_slots[slotIndex].generation};
+    }
+
+    // Destroy all objects. Existing handles go stale.
+    void Clear()
+    {
+        while (!m_values.IsEmpty())
+        {
+            Remove(HandleAt(m_values.Size() - 1));
+        }
+    }
+
+    void Reserve(uint64 count)
+    {
+        m_values.Reserve(count);
+        m_denseToSlot.Reserve(count);
+        m_slots.Reserve(count);
+    }
+
+    uint64 Size() const
+    {
+        return m_values.Size();
+    }
+
+    bool IsEmpty() const
+    {
+        return m_values.IsEmpty();
+    }
+
+    // Dense access to live objects, in no particular order
+    T* Data()
+    {
+        return m_values.Data();
+    }
+
+    const T* Data() const
+    {
+        return m_values.Data();
+    }
+
+    T* begin()
+    {
+        return m_values.begin();
+    }
+
+    const T* begin() const
+    {
+        return m_values.begin();
+    }
+
+    T* end()
+    {
+        return m_values.end();
+    }
+
+    const T* end() const
+    {
+        return m_values.end();
+    }
+};
+
+} // namespace rsbl
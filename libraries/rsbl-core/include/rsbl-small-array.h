@@ -0,0 +1,384 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-core.h"
+#include "rsbl-int-types.h"
+
+#include <cstring>
+#include <new>
+
+namespace rsbl
+{
+
+// Dynamic array with inline storage for the first N elements, and heap (or custom allocator)
+// storage past that. Same interface as DynamicArray, so call sites can switch between the two.
+// Great for short lists like queue families, present modes or swapchain images, which almost
+// never need the heap.
+// Note: moving a SmallArray that is still inline moves each element, unlike DynamicArray which
+// just steals the pointer.
+
+template <typename T, uint64 N>
+class SmallArray
+{
+    static_assert(N > 0, "SmallArray needs at least one inline element, use DynamicArray instead");
+
+  private:
+    T* m_data = InlineData();
+    uint64 m_size = 0;
+    uint64 m_capacity = N;
+    Allocator* m_allocator = GetDefaultAllocator();
+
+    alignas(T) uint8 m_inlineStorage[N * sizeof(T)];
+
+    T* InlineData()
+    {
+        return reinterpret_cast<T*>(m_inlineStorage);
+    }
+
+    bool IsInline() const
+    {
+        return m_data == reinterpret_cast<const T*>(m_inlineStorage);
+    }
+
+    void FreeHeapBuffer()
+    {
+        if (!IsInline())
+        {
+            m_allocator->Free(m_data, m_capacity * sizeof(T), alignof(T));
+        }
+    }
+
+    // Move (or memcpy) count elements from src into uninitialized dst, destroying the source
+    static void RelocateElements(T* dst, T* src, uint64 count)
+    {
+        if constexpr (IsTriviallyRelocatable<T>)
+        {
+            if (count > 0)
+            {
+                memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+            }
+        }
+        else
+        {
+            for (uint64 i = 0; i < count; ++i)
+            {
+                new (&dst[i]) T(rsblMove(src[i]));
+                src[i].~T();
+            }
+        }
+    }
+
+    void CopyElements(const T* src, uint64 count, uint64 dst = 0)
+    {
+        if constexpr (__is_trivially_copyable(T))
+        {
+            if (count > 0)
+            {
+                memcpy(static_cast<void*>(m_data + dst), src, count * sizeof(T));
+            }
+        }
+        else
+        {
+            for (uint64 i = 0; i < count; ++i)
+            {
+                new (&m_data[dst + i]) T(src[i]);
+            }
+        }
+    }
+
+    void Grow(uint64 minCapacity)
+    {
+        uint64 newCapacity = m_capacity * 2;
+        while (newCapacity < minCapacity)
+        {
+            newCapacity *= 2;
+        }
+
+        if constexpr (IsTriviallyRelocatable<T>)
+        {
+            if (!IsInline())
+            {
+                m_data = static_cast<T*>(m_allocator->Reallocate(
+                    m_data, m_capacity * sizeof(T), newCapacity * sizeof(T), alignof(T)));
+                m_capacity = newCapacity;
+                return;
+            }
+        }
+
+        T* newData =
+            static_cast<T*>(m_allocator->Allocate(newCapacity * sizeof(T), alignof(T)));
+        RelocateElements(newData, m_data, m_size);
+        FreeHeapBuffer();
+
+        m_data = newData;
+        m_capacity = newCapacity;
+    }
+
+    // Take over other's elements, leaving it empty (but keeping its allocator)
+    void StealFrom(SmallArray& other)
+    {
+        if (other.IsInline())
+        {
+            RelocateElements(m_data, other.m_data, other.m_size);
+        }
+        else
+        {
+            m_data = other.m_data;
+            m_capacity = other.m_capacity;
+            other.m_data = other.InlineData();
+            other.m_capacity = N;
+        }
+
+        m_size = other.m_size;
+        other.m_size = 0;
+    }
+
+  public:
+    SmallArray() = default;
+
+    // Allocator used once we spill past N elements. The allocator must outlive the array.
+    explicit SmallArray(Allocator* allocator)
+        : m_allocator(allocator)
+    {
+    }
+
+    ~SmallArray()
+    {
+        Clear();
+        FreeHeapBuffer();
+    }
+
+    SmallArray(const SmallArray& other)
+        : m_allocator(other.m_allocator)
+    {
+        Reserve(other.m_size);
+        CopyElements(other.m_data, other.m_size);
+        m_size = other.m_size;
+    }
+
+    SmallArray& operator=(const SmallArray& other)
+    {
+        if (this != &other)
+        {
+            Clear();
+            Reserve(other.m_size);
+            CopyElements(other.m_data, other.m_size);
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    // Heap storage (and its allocator) is stolen, inline elements are moved one by one
+    SmallArray(SmallArray&& other) noexcept
+        : m_allocator(other.m_allocator)
+    {
+        StealFrom(other);
+    }
+
+    SmallArray& operator=(SmallArray&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Clear();
+            FreeHeapBuffer();
+            m_data = InlineData();
+            m_capacity = N;
+            m_allocator = other.m_allocator;
+            StealFrom(other);
+        }
+        return *this;
+    }
+
+    // Add element at end
+    void PushBack(const T& value)
+    {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value)
+    {
+        EmplaceBack(rsblMove(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args)
+    {
+        if (m_size >= m_capacity)
+        {
+            Grow(m_size + 1);
+        }
+        T* element = new (&m_data[m_size]) T(rsblForward(args)...);
+        ++m_size;
+        return *element;
+    }
+
+    void Append(const T* first, uint64 count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        const uint64 newSize = m_size + count;
+        if (newSize > m_capacity)
+        {
+            Grow(newSize);
+        }
+        CopyElements(first, count, m_size);
+        m_size = newSize;
+    }
+
+    // Remove last element
+    void PopBack()
+    {
+        if (m_size > 0)
+        {
+            --m_size;
+            m_data[m_size].~T();
+        }
+    }
+
+    // Access elements
+    T& operator[](uint64 index)
+    {
+        return m_data[index];
+    }
+
+    const T& operator[](uint64 index) const
+    {
+        return m_data[index];
+    }
+
+    uint64 Size() const
+    {
+        return m_size;
+    }
+
+    uint64 Capacity() const
+    {
+        return m_capacity;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    // True while the elements still live in the inline buffer
+    bool IsUsingInlineStorage() const
+    {
+        return IsInline();
+    }
+
+    static constexpr uint64 InlineCapacity()
+    {
+        return N;
+    }
+
+    void Reserve(uint64 newCapacity)
+    {
+        if (newCapacity > m_capacity)
+        {
+            Grow(newCapacity);
+        }
+    }
+
+    // Resize array to new size
+    // If newSize < current size, excess elements are destroyed
+    // If newSize > current size, new elements are default-constructed
+    void Resize(uint64 newSize)
+    {
+        if (newSize < m_size)
+        {
+            for (uint64 i = newSize; i < m_size; ++i)
+            {
+                m_data[i].~T();
+            }
+            m_size = newSize;
+        }
+        else if (newSize > m_size)
+        {
+            if (newSize > m_capacity)
+            {
+                Grow(newSize);
+            }
+
+            if constexpr (IsTriviallyZeroConstructible<T>)
+            {
+                memset(static_cast<void*>(m_data + m_size), 0, (newSize - m_size) * sizeof(T));
+            }
+            else
+            {
+                for (uint64 i = m_size; i < newSize; ++i)
+                {
+                    new (&m_data[i]) T();
+                }
+            }
+            m_size = newSize;
+        }
+    }
+
+    void ResizeUninitialized(uint64 newSize)
+    {
+        static_assert(IsTriviallyZeroConstructible<T>,
+                      "ResizeUninitialized requires a trivially constructible type");
+
+        if (newSize > m_capacity)
+        {
+            Grow(newSize);
+        }
+        m_size = newSize;
+    }
+
+    // Clear all elements, keeping any heap storage around for re-use
+    void Clear()
+    {
+        for (uint64 i = 0; i < m_size; ++i)
+        {
+            m_data[i].~T();
+        }
+        m_size = 0;
+    }
+
+    Allocator* GetAllocator() const
+    {
+        return m_allocator;
+    }
+
+    // Get raw data pointer
+    T* Data()
+    {
+        return m_data;
+    }
+
+    const T* Data() const
+    {
+        return m_data;
+    }
+
+    // Iterator support
+    T* begin()
+    {
+        return m_data;
+    }
+
+    const T* begin() const
+    {
+        return m_data;
+    }
+
+    T* end()
+    {
+        return m_data + m_size;
+    }
+
+    const T* end() const
+    {
+        return m_data + m_size;
+    }
+};
+
+} // namespace rsbl
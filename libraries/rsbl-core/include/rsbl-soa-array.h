@@ -0,0 +1,505 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-array-view.h"
+#include "rsbl-assert.h"
+#include "rsbl-bits.h"
+#include "rsbl-core.h"
+#include "rsbl-int-types.h"
+
+#include <cstring>
+#include <new>
+
+namespace rsbl
+{
+
+// Every column starts on a cache line, which also covers the widest SIMD loads we use
+constexpr uint64 kSoaAlignment = 64;
+
+namespace Internal
+{
+    template <uint32 Index, typename First, typename... Rest>
+    struct SoaFieldType
+    {
+        using type = typename SoaFieldType<Index - 1, Rest...>::type;
+    };
+
+    template <typename First, typename... Rest>
+    struct SoaFieldType<0, First, Rest...>
+    {
+        using type = First;
+    };
+} // namespace Internal
+
+// Structure-of-arrays container. Each field gets its own contiguous, kSoaAlignment-aligned column,
+// so a pass that only reads bounds streams through bounds and nothing else. Rows are still
+// addressed by index, and operator[] hands back a row reference for the occasional per-row access.
+// Use an enum for the field indices to keep call sites readable:
+//
+//   enum NodeField : uint32 { kNodeTransform, kNodeBounds, kNodeParent };
+//   SoaArray<Mat4, Bounds, uint32> nodes;
+//   nodes.PushBack(transform, bounds, parent);
+//   for (Bounds& bounds : nodes.Field<kNodeBounds>()) { ... }
+//
+// All columns live in one allocation from an rsbl::Allocator, and grow together. Same rules as
+// DynamicArray otherwise: copies share the source's allocator, trivially relocatable fields grow
+// with memcpy, and there's no insert/erase in the middle (RemoveSwap moves the last row into the
+// hole instead).
+template <typename... Fields>
+class SoaArray
+{
+    static_assert(sizeof...(Fields) > 0, "SoaArray needs at least one field");
+
+  public:
+    static constexpr uint32 kFieldCount = sizeof...(Fields);
+
+    template <uint32 Index>
+    using FieldType = typename Internal::SoaFieldType<Index, Fields...>::type;
+
+    // Reference to one row. Only valid until the array grows.
+    template <typename ArrayType>
+    class RowReference
+    {
+      public:
+        RowReference(ArrayType* array, uint64 index)
+            : m_array(array)
+            , m_index(index)
+        {
+        }
+
+        template <uint32 Index>
+        auto& Get() const
+        {
+            return m_array->template Data<Index>()[m_index];
+        }
+
+        uint64 Index() const
+        {
+            return m_index;
+        }
+
+      private:
+        ArrayType* m_array;
+        uint64 m_index;
+    };
+
+    using Row = RowReference<SoaArray>;
+    using ConstRow = RowReference<const SoaArray>;
+
+  private:
+    uint8* m_block = nullptr;
+    void* m_columns[kFieldCount] = {};
+    uint64 m_size = 0;
+    uint64 m_capacity = 0;
+    Allocator* m_allocator = GetDefaultAllocator();
+
+    static constexpr uint64 kFieldSizes[kFieldCount] = {sizeof(Fields)...};
+    static constexpr uint64 kFieldAlignments[kFieldCount] = {
+        (alignof(Fields) > kSoaAlignment ? alignof(Fields) : kSoaAlignment)...};
+
+    static constexpr uint64 BlockAlignment()
+    {
+        uint64 alignment = kSoaAlignment;
+        for (uint64 fieldAlignment : kFieldAlignments)
+        {
+            alignment = fieldAlignment > alignment ? fieldAlignment : alignment;
+        }
+        return alignment;
+    }
+
+    // Byte size of a block holding capacity rows, and where each column starts in it
+    static uint64 ComputeLayout(uint64 capacity, uint64 (&offsets)[kFieldCount])
+    {
+        uint64 size = 0;
+        for (uint32 i = 0; i < kFieldCount; ++i)
+        {
+            size = AlignUp(size, kFieldAlignments[i]);
+            offsets[i] = size;
+            size += kFieldSizes[i] * capacity;
+        }
+        return size;
+    }
+
+    static uint64 BlockSize(uint64 capacity)
+    {
+        uint64 offsets[kFieldCount];
+        return ComputeLayout(capacity, offsets);
+    }
+
+    // Calls func.template operator()<Index>() for every field
+    template <uint32 Index = 0, typename Func>
+    static void ForEachField(Func&& func)
+    {
+        if constexpr (Index < kFieldCount)
+        {
+            func.template operator()<Index>();
+            ForEachField<Index + 1>(func);
+        }
+    }
+
+    template <uint32 Index, typename First, typename... Rest>
+    void ConstructFields(uint64 row, First&& first, Rest&&... rest)
+    {
+        new (&Data<Index>()[row]) FieldType<Index>(rsblForward(first));
+        if constexpr (sizeof...(Rest) > 0)
+        {
+            ConstructFields<Index + 1>(row, rsblForward(rest)...);
+        }
+    }
+
+    void DefaultConstructRows(uint64 first, uint64 count)
+    {
+        ForEachField([&]<uint32 Index>() {
+            using T = FieldType<Index>;
+            T* column = Data<Index>();
+            if constexpr (IsTriviallyZeroConstructible<T>)
+            {
+                if (count > 0)
+                {
+                    memset(static_cast<void*>(column + first), 0, count * sizeof(T));
+                }
+            }
+            else
+            {
+                for (uint64 i = first; i < first + count; ++i)
+                {
+                    new (&column[i]) T();
+                }
+            }
+        });
+    }
+
+    void DestroyRows(uint64 first, uint64 count)
+    {
+        ForEachField([&]<uint32 Index>() {
+            using T = FieldType<Index>;
+            if constexpr (!__has_trivial_destructor(T))
+            {
+                T* column = Data<Index>();
+                for (uint64 i = first; i < first + count; ++i)
+                {
+                    column[i].~T();
+                }
+            }
+        });
+    }
+
+    void CopyRowsFrom(const SoaArray& other)
+    {
+        ForEachField([&]<uint32 Index>() {
+            using T = FieldType<Index>;
+            T* dst = Data<Index>();
+            const T* src = other.template Data<Index>();
+            if constexpr (__is_trivially_copyable(T))
+            {
+                if (other.m_size > 0)
+                {
+                    memcpy(static_cast<void*>(dst), src, other.m_size * sizeof(T));
+                }
+            }
+            else
+            {
+                for (uint64 i = 0; i < other.m_size; ++i)
+                {
+                    new (&dst[i]) T(src[i]);
+                }
+            }
+        });
+    }
+
+    void Grow(uint64 minCapacity)
+    {
+        uint64 newCapacity = m_capacity == 0 ? 8 : m_capacity * 2;
+        while (newCapacity < minCapacity)
+        {
+            newCapacity *= 2;
+        }
+
+        uint64 offsets[kFieldCount];
+        const uint64 newBlockSize = ComputeLayout(newCapacity, offsets);
+        uint8* newBlock =
+            static_cast<uint8*>(m_allocator->Allocate(newBlockSize, BlockAlignment()));
+        rsblVerifyMsg(newBlock != nullptr, "Failed to allocate SoaArray storage");
+
+        // Columns move to new offsets, so unlike DynamicArray this can't just Reallocate
+        ForEachField([&]<uint32 Index>() {
+            using T = FieldType<Index>;
+            T* dst = reinterpret_cast<T*>(newBlock + offsets[Index]);
+            T* src = Data<Index>();
+            if constexpr (IsTriviallyRelocatable<T>)
+            {
+                if (m_size > 0)
+                {
+                    memcpy(static_cast<void*>(dst),
+                           static_cast<const void*>(src),
+                           m_size * sizeof(T));
+                }
+            }
+            else
+            {
+                for (uint64 i = 0; i < m_size; ++i)
+                {
+                    new (&dst[i]) T(rsblMove(src[i]));
+                    src[i].~T();
+                }
+            }
+        });
+
+        FreeBlock();
+        m_block = newBlock;
+        m_capacity = newCapacity;
+        for (uint32 i = 0; i < kFieldCount; ++i)
+        {
+            m_columns[i] = newBlock + offsets[i];
+        }
+    }
+
+    void FreeBlock()
+    {
+        if (m_block != nullptr)
+        {
+            m_allocator->Free(m_block, BlockSize(m_capacity), BlockAlignment());
+        }
+    }
+
+    void StealFrom(SoaArray& other)
+    {
+        m_block = other.m_block;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        for (uint32 i = 0; i < kFieldCount; ++i)
+        {
+            m_columns[i] = other.m_columns[i];
+            other.m_columns[i] = nullptr;
+        }
+
+        other.m_block = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
+    }
+
+  public:
+    SoaArray() = default;
+
+    explicit SoaArray(uint64 initialCapacity)
+    {
+        Reserve(initialCapacity);
+    }
+
+    // The allocator must outlive the array
+    explicit SoaArray(Allocator* allocator)
+        : m_allocator(allocator)
+    {
+    }
+
+    SoaArray(uint64 initialCapacity, Allocator* allocator)
+        : m_allocator(allocator)
+    {
+        Reserve(initialCapacity);
+    }
+
+    ~SoaArray()
+    {
+        Clear();
+        FreeBlock();
+    }
+
+    SoaArray(const SoaArray& other)
+        : m_allocator(other.m_allocator)
+    {
+        Reserve(other.m_size);
+        CopyRowsFrom(other);
+        m_size = other.m_size;
+    }
+
+    SoaArray& operator=(const SoaArray& other)
+    {
+        if (this != &other)
+        {
+            Clear();
+            Reserve(other.m_size);
+            CopyRowsFrom(other);
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    SoaArray(SoaArray&& other) noexcept
+        : m_allocator(other.m_allocator)
+    {
+        StealFrom(other);
+    }
+
+    SoaArray& operator=(SoaArray&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Clear();
+            FreeBlock();
+            m_allocator = other.m_allocator;
+            StealFrom(other);
+        }
+        return *this;
+    }
+
+    // One value per field, in field order
+    template <typename... Args>
+    Row EmplaceBack(Args&&... args)
+    {
+        static_assert(sizeof...(Args) == 0 || sizeof...(Args) == kFieldCount,
+                      "EmplaceBack takes no values, or one value per field");
+
+        if (m_size >= m_capacity)
+        {
+            Grow(m_size + 1);
+        }
+
+        if constexpr (sizeof...(Args) == 0)
+        {
+            DefaultConstructRows(m_size, 1);
+        }
+        else
+        {
+            ConstructFields<0>(m_size, rsblForward(args)...);
+        }
+        return Row(this, m_size++);
+    }
+
+    Row PushBack(const Fields&... values)
+    {
+        return EmplaceBack(values...);
+    }
+
+    void PopBack()
+    {
+        if (m_size > 0)
+        {
+            --m_size;
+            DestroyRows(m_size, 1);
+        }
+    }
+
+    // Removes a row by moving the last row into its place. Doesn't keep order, but never shifts
+    // more than one row.
+    void RemoveSwap(uint64 index)
+    {
+        rsblDebugAssert(index < m_size);
+
+        const uint64 last = m_size - 1;
+        if (index != last)
+        {
+            ForEachField([&]<uint32 Index>() {
+                FieldType<Index>* column = Data<Index>();
+                column[index] = rsblMove(column[last]);
+            });
+        }
+        PopBack();
+    }
+
+    // Whole column, for the hot loops
+    template <uint32 Index>
+    FieldType<Index>* Data()
+    {
+        return static_cast<FieldType<Index>*>(m_columns[Index]);
+    }
+
+    template <uint32 Index>
+    const FieldType<Index>* Data() const
+    {
+        return static_cast<const FieldType<Index>*>(m_columns[Index]);
+    }
+
+    template <uint32 Index>
+    ArrayView<FieldType<Index>> Field()
+    {
+        return ArrayView<FieldType<Index>>(Data<Index>(), m_size);
+    }
+
+    template <uint32 Index>
+    ArrayView<const FieldType<Index>> Field() const
+    {
+        return ArrayView<const FieldType<Index>>(Data<Index>(), m_size);
+    }
+
+    // Single element, same as Data<Index>()[row]
+    template <uint32 Index>
+    FieldType<Index>& Get(uint64 row)
+    {
+        rsblDebugAssert(row < m_size);
+        return Data<Index>()[row];
+    }
+
+    template <uint32 Index>
+    const FieldType<Index>& Get(uint64 row) const
+    {
+        rsblDebugAssert(row < m_size);
+        return Data<Index>()[row];
+    }
+
+    Row operator[](uint64 index)
+    {
+        rsblDebugAssert(index < m_size);
+        return Row(this, index);
+    }
+
+    ConstRow operator[](uint64 index) const
+    {
+        rsblDebugAssert(index < m_size);
+        return ConstRow(this, index);
+    }
+
+    uint64 Size() const
+    {
+        return m_size;
+    }
+
+    uint64 Capacity() const
+    {
+        return m_capacity;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    void Reserve(uint64 newCapacity)
+    {
+        if (newCapacity > m_capacity)
+        {
+            Grow(newCapacity);
+        }
+    }
+
+    // New rows are value-initialized
+    void Resize(uint64 newSize)
+    {
+        if (newSize > m_size)
+        {
+            Reserve(newSize);
+            DefaultConstructRows(m_size, newSize - m_size);
+        }
+        else
+        {
+            DestroyRows(newSize, m_size - newSize);
+        }
+        m_size = newSize;
+    }
+
+    // Keeps the capacity
+    void Clear()
+    {
+        DestroyRows(0, m_size);
+        m_size = 0;
+    }
+
+    Allocator* GetAllocator() const
+    {
+        return m_allocator;
+    }
+};
+
+} // namespace rsbl
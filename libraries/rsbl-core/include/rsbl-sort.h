@@ -0,0 +1,197 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-array-view.h"
+#include "rsbl-assert.h"
+#include "rsbl-bits.h"
+#include "rsbl-core.h"
+#include "rsbl-int-types.h"
+
+#include <cstring>
+
+// LSD radix sort for unsigned integer keys, optionally carrying a payload along with each key
+// (draw items, indices, handles). One read builds the histograms for every digit, then each 8-bit
+// digit is a stable scatter pass between the input and a scratch buffer. Passes where every key
+// has the same digit are skipped, which is common for sort keys with unused high bits.
+// Small inputs fall back to an insertion sort. The sort is stable.
+// Scratch memory comes from the allocator argument, a frame arena is a good fit.
+
+namespace rsbl
+{
+namespace Internal
+{
+    constexpr uint32 kRadixBits = 8;
+    constexpr uint32 kRadixBuckets = 1 << kRadixBits;
+    constexpr uint64 kRadixInsertionSortThreshold = 64;
+
+    template <typename Payload>
+    constexpr uint64 kRadixPayloadSize = sizeof(Payload);
+
+    template <>
+    constexpr uint64 kRadixPayloadSize<void> = 0;
+
+    template <typename Key, typename Payload>
+    void InsertionSortByKey(Key* keys, Payload* payloads, uint64 count)
+    {
+        for (uint64 i = 1; i < count; ++i)
+        {
+            const Key key = keys[i];
+            uint64 j = i;
+            while (j > 0 && keys[j - 1] > key)
+            {
+                j--;
+            }
+            if (j == i)
+            {
+                continue;
+            }
+
+            memmove(keys + j + 1, keys + j, (i - j) * sizeof(Key));
+            keys[j] = key;
+            if constexpr (!rsbl::IsSame<Payload, void>)
+            {
+                Payload payload;
+                memcpy(&payload, payloads + i, sizeof(Payload));
+                memmove(payloads + j + 1, payloads + j, (i - j) * sizeof(Payload));
+                memcpy(payloads + j, &payload, sizeof(Payload));
+            }
+        }
+    }
+
+    // Payload is void for a keys-only sort
+    template <typename Key, typename Payload>
+    void RadixSortImpl(Key* keys, Payload* payloads, uint64 count, Allocator* allocator)
+    {
+        constexpr uint32 kPassCount = sizeof(Key) * 8 / kRadixBits;
+        constexpr bool kHasPayload = !rsbl::IsSame<Payload, void>;
+        constexpr uint64 kPayloadSize = kRadixPayloadSize<Payload>;
+
+        if (count <= kRadixInsertionSortThreshold)
+        {
+            InsertionSortByKey(keys, payloads, count);
+            return;
+        }
+
+        uint64 histograms[kPassCount][kRadixBuckets] = {};
+        for (uint64 i = 0; i < count; ++i)
+        {
+            const Key key = keys[i];
+            for (uint32 pass = 0; pass < kPassCount; ++pass)
+            {
+                histograms[pass][(key >> (pass * kRadixBits)) & (kRadixBuckets - 1)]++;
+            }
+        }
+
+        // Keys first, then payloads, in one allocation
+        const uint64 keyBytes = AlignUp(count * sizeof(Key), 16);
+        const uint64 scratchSize = keyBytes + count * kPayloadSize;
+        uint8* scratch = static_cast<uint8*>(allocator->Allocate(scratchSize, 16));
+        rsblVerifyMsg(scratch != nullptr, "Failed to allocate radix sort scratch");
+
+        Key* srcKeys = keys;
+        Key* dstKeys = reinterpret_cast<Key*>(scratch);
+        [[maybe_unused]] uint8* srcPayloads = static_cast<uint8*>(static_cast<void*>(payloads));
+        [[maybe_unused]] uint8* dstPayloads = scratch + keyBytes;
+
+        for (uint32 pass = 0; pass < kPassCount; ++pass)
+        {
+            uint64* histogram = histograms[pass];
+            const uint32 shift = pass * kRadixBits;
+            if (histogram[(srcKeys[0] >> shift) & (kRadixBuckets - 1)] == count)
+            {
+                continue;
+            }
+
+            // Histogram becomes the scatter offset of each bucket
+            uint64 offset = 0;
+            for (uint32 bucket = 0; bucket < kRadixBuckets; ++bucket)
+            {
+                const uint64 bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+
+            for (uint64 i = 0; i < count; ++i)
+            {
+                const Key key = srcKeys[i];
+                const uint64 dst = histogram[(key >> shift) & (kRadixBuckets - 1)]++;
+                dstKeys[dst] = key;
+                if constexpr (kHasPayload)
+                {
+                    memcpy(dstPayloads + dst * kPayloadSize, srcPayloads + i * kPayloadSize,
+                           kPayloadSize);
+                }
+            }
+
+            Key* tempKeys = srcKeys;
+            srcKeys = dstKeys;
+            dstKeys = tempKeys;
+            if constexpr (kHasPayload)
+            {
+                uint8* tempPayloads = srcPayloads;
+                srcPayloads = dstPayloads;
+                dstPayloads = tempPayloads;
+            }
+        }
+
+        // An odd number of passes ran, the result is sitting in scratch
+        if (srcKeys != keys)
+        {
+            memcpy(keys, srcKeys, count * sizeof(Key));
+            if constexpr (kHasPayload)
+            {
+                memcpy(payloads, srcPayloads, count * kPayloadSize);
+            }
+        }
+
+        allocator->Free(scratch, scratchSize, 16);
+    }
+} // namespace Internal
+
+// Sorts keys ascending
+inline void RadixSort(ArrayView<uint32> keys, Allocator* scratchAllocator = GetDefaultAllocator())
+{
+    Internal::RadixSortImpl<uint32, void>(keys.Data(), nullptr, keys.Size(), scratchAllocator);
+}
+
+inline void RadixSort(ArrayView<uint64> keys, Allocator* scratchAllocator = GetDefaultAllocator())
+{
+    Internal::RadixSortImpl<uint64, void>(keys.Data(), nullptr, keys.Size(), scratchAllocator);
+}
+
+// Sorts keys ascending, and applies the same reordering to payloads. Payloads can be any
+// contiguous container (or ArrayView) of trivially copyable elements, the same size as keys.
+template <typename PayloadContainer>
+    requires requires(PayloadContainer& container) {
+        container.Data();
+        container.Size();
+    }
+void RadixSort(ArrayView<uint32> keys, PayloadContainer&& payloads,
+               Allocator* scratchAllocator = GetDefaultAllocator())
+{
+    using Payload = RemovePointer<decltype(payloads.Data())>;
+    static_assert(__is_trivially_copyable(Payload), "Radix sort payloads are moved with memcpy");
+    rsblAssert(payloads.Size() == keys.Size());
+    Internal::RadixSortImpl<uint32, Payload>(keys.Data(), payloads.Data(), keys.Size(),
+                                             scratchAllocator);
+}
+
+template <typename PayloadContainer>
+    requires requires(PayloadContainer& container) {
+        container.Data();
+        container.Size();
+    }
+void RadixSort(ArrayView<uint64> keys, PayloadContainer&& payloads,
+               Allocator* scratchAllocator = GetDefaultAllocator())
+{
+    using Payload = RemovePointer<decltype(payloads.Data())>;
+    static_assert(__is_trivially_copyable(Payload), "Radix sort payloads are moved with memcpy");
+    rsblAssert(payloads.Size() == keys.Size());
+    Internal::RadixSortImpl<uint64, Payload>(keys.Data(), payloads.Data(), keys.Size(),
+                                             scratchAllocator);
+}
+
+} // namespace rsbl
@@ -0,0 +1,98 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-hash.h"
+#include "rsbl-int-types.h"
+#include "rsbl-string.h"
+
+namespace rsbl
+{
+namespace Internal
+{
+    // Header of an interned string, the chars (and a terminator) follow it in memory
+    struct InternedString
+    {
+        uint64 hash;
+        uint64 size;
+
+        const char* Text() const
+        {
+            return reinterpret_cast<const char*>(this + 1);
+        }
+    };
+
+    const InternedString* InternString(StringView str);
+} // namespace Internal
+
+// Handle to a string in the global intern table. Interning the same text always gives the same
+// id, so comparing ids is a pointer compare, and the hash was computed once when the string was
+// first interned. Use them for names that get looked up a lot, like asset names, shader entry
+// points and log tags. Interned strings live until the process exits.
+// Interning is thread-safe. Reading an id's text or hash doesn't touch the table at all.
+class StringId
+{
+  public:
+    // The empty string
+    constexpr StringId() = default;
+
+    explicit StringId(StringView str)
+        : m_entry(Internal::InternString(str))
+    {
+    }
+
+    explicit StringId(const char* str)
+        : StringId(StringView(str))
+    {
+    }
+
+    // Null terminated
+    const char* CStr() const
+    {
+        return m_entry != nullptr ? m_entry->Text() : "";
+    }
+
+    StringView View() const
+    {
+        return m_entry != nullptr ? StringView(m_entry->Text(), m_entry->size) : StringView();
+    }
+
+    uint64 Size() const
+    {
+        return m_entry != nullptr ? m_entry->size : 0;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_entry == nullptr;
+    }
+
+    // Same value as Hash<StringView> of the text, precomputed
+    uint64 GetHash() const
+    {
+        return m_entry != nullptr ? m_entry->hash : Hash<StringView>()(StringView());
+    }
+
+    bool operator==(const StringId& other) const
+    {
+        return m_entry == other.m_entry;
+    }
+
+  private:
+    const Internal::InternedString* m_entry = nullptr;
+};
+
+template <>
+struct Hash<StringId>
+{
+    uint64 operator()(StringId id) const
+    {
+        return id.GetHash();
+    }
+};
+
+// Number of distinct strings interned so far
+uint64 GetStringIdCount();
+
+} // namespace rsbl
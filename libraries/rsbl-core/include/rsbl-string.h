@@ -0,0 +1,322 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-allocator.h"
+#include "rsbl-assert.h"
+#include "rsbl-core.h"
+#include "rsbl-hash.h"
+#include "rsbl-int-types.h"
+
+namespace rsbl
+{
+
+// Non-owning view of a run of chars, not necessarily null terminated. Same rules as ArrayView,
+// don't hold on to it longer than the underlying storage.
+class StringView
+{
+  public:
+    static constexpr uint64 kNotFound = ~uint64(0);
+
+    constexpr StringView() = default;
+
+    constexpr StringView(const char* data, uint64 size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    // Null-terminated string
+    constexpr StringView(const char* str)
+        : m_data(str)
+        , m_size(str != nullptr ? __builtin_strlen(str) : 0)
+    {
+    }
+
+    constexpr char operator[](uint64 index) const
+    {
+        rsblDebugAssert(index < m_size);
+        return m_data[index];
+    }
+
+    constexpr const char* Data() const
+    {
+        return m_data;
+    }
+
+    constexpr uint64 Size() const
+    {
+        return m_size;
+    }
+
+    constexpr bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    // count chars starting at offset, clamped to the end of the view
+    constexpr StringView Substring(uint64 offset, uint64 count = kNotFound) const
+    {
+        rsblDebugAssert(offset <= m_size);
+        const uint64 remaining = m_size - offset;
+        return StringView(m_data + offset, count < remaining ? count : remaining);
+    }
+
+    // Index of the first c at or after offset, or kNotFound
+    constexpr uint64 Find(char c, uint64 offset = 0) const
+    {
+        for (uint64 i = offset; i < m_size; ++i)
+        {
+            if (m_data[i] == c)
+            {
+                return i;
+            }
+        }
+        return kNotFound;
+    }
+
+    // Index of the last c, or kNotFound
+    constexpr uint64 FindLast(char c) const
+    {
+        for (uint64 i = m_size; i > 0; --i)
+        {
+            if (m_data[i - 1] == c)
+            {
+                return i - 1;
+            }
+        }
+        return kNotFound;
+    }
+
+    constexpr bool StartsWith(StringView prefix) const
+    {
+        return prefix.m_size <= m_size && Substring(0, prefix.m_size) == prefix;
+    }
+
+    constexpr bool EndsWith(StringView suffix) const
+    {
+        return suffix.m_size <= m_size && Substring(m_size - suffix.m_size) == suffix;
+    }
+
+    constexpr bool operator==(const StringView& other) const
+    {
+        if (m_size != other.m_size)
+        {
+            return false;
+        }
+        for (uint64 i = 0; i < m_size; ++i)
+        {
+            if (m_data[i] != other.m_data[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr const char* begin() const
+    {
+        return m_data;
+    }
+
+    constexpr const char* end() const
+    {
+        return m_data + m_size;
+    }
+
+  private:
+    const char* m_data = nullptr;
+    uint64 m_size = 0;
+};
+
+// Owning, null-terminated string. Short strings (asset names, entry points, log tags) live in the
+// inline buffer and never touch the allocator. Like SmallArray, moving an inline String copies
+// the chars, while a heap String just hands over its pointer.
+class String
+{
+  public:
+    // Chars that fit inline, not counting the terminator
+    static constexpr uint64 kInlineCapacity = 23;
+
+    String() = default;
+
+    // Allocator used once the string spills out of the inline buffer. It must outlive the string.
+    explicit String(Allocator* allocator)
+        : m_allocator(allocator)
+    {
+    }
+
+    // Explicit, so comparing against a literal doesn't build a temporary String
+    explicit String(StringView str, Allocator* allocator = GetDefaultAllocator());
+
+    explicit String(const char* str, Allocator* allocator = GetDefaultAllocator())
+        : String(StringView(str), allocator)
+    {
+    }
+
+    ~String();
+
+    String(const String& other);
+    String& operator=(const String& other);
+
+    String(String&& other) noexcept;
+    String& operator=(String&& other) noexcept;
+
+    String& operator=(StringView str);
+
+    char& operator[](uint64 index)
+    {
+        rsblDebugAssert(index < m_size);
+        return m_data[index];
+    }
+
+    char operator[](uint64 index) const
+    {
+        rsblDebugAssert(index < m_size);
+        return m_data[index];
+    }
+
+    char* Data()
+    {
+        return m_data;
+    }
+
+    const char* Data() const
+    {
+        return m_data;
+    }
+
+    // Always null terminated
+    const char* CStr() const
+    {
+        return m_data;
+    }
+
+    uint64 Size() const
+    {
+        return m_size;
+    }
+
+    uint64 Capacity() const
+    {
+        return m_capacity;
+    }
+
+    bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    bool IsInline() const
+    {
+        return m_data == m_inlineStorage;
+    }
+
+    Allocator* GetAllocator() const
+    {
+        return m_allocator;
+    }
+
+    StringView View() const
+    {
+        return StringView(m_data, m_size);
+    }
+
+    operator StringView() const
+    {
+        return View();
+    }
+
+    void Reserve(uint64 capacity);
+
+    // New chars are zero filled
+    void Resize(uint64 size);
+
+    // Sets the size, up to Capacity(), leaving the chars as they are, for text written straight
+    // into Data()
+    void ResizeForOverwrite(uint64 size)
+    {
+        rsblAssert(size <= m_capacity);
+        m_size = size;
+        m_data[m_size] = '\0';
+    }
+
+    // Keeps the capacity
+    void Clear();
+
+    String& Append(StringView str);
+    String& Append(char c);
+
+    String& operator+=(StringView str)
+    {
+        return Append(str);
+    }
+
+    String& operator+=(char c)
+    {
+        return Append(c);
+    }
+
+    bool operator==(const String& other) const
+    {
+        return View() == other.View();
+    }
+
+    bool operator==(StringView other) const
+    {
+        return View() == other;
+    }
+
+    char* begin()
+    {
+        return m_data;
+    }
+
+    char* end()
+    {
+        return m_data + m_size;
+    }
+
+    const char* begin() const
+    {
+        return m_data;
+    }
+
+    const char* end() const
+    {
+        return m_data + m_size;
+    }
+
+  private:
+    void Grow(uint64 min_capacity);
+    void FreeHeapBuffer();
+    void StealFrom(String& other);
+
+    char* m_data = m_inlineStorage;
+    uint64 m_size = 0;
+    uint64 m_capacity = kInlineCapacity;
+    Allocator* m_allocator = GetDefaultAllocator();
+
+    char m_inlineStorage[kInlineCapacity + 1] = {};
+};
+
+template <>
+struct Hash<StringView>
+{
+    uint64 operator()(StringView str) const
+    {
+        return HashBytes(str.Data(), str.Size());
+    }
+};
+
+template <>
+struct Hash<String>
+{
+    uint64 operator()(const String& str) const
+    {
+        return HashBytes(str.Data(), str.Size());
+    }
+};
+
+} // namespace rsbl
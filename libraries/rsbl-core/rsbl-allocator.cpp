@@ -0,0 +1,358 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-allocator.h"
+
+#include "include/rsbl-assert.h"
+#include "include/rsbl-bits.h"
+#include "include/rsbl-memory-tracking.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace rsbl
+{
+
+void* Allocator::Reallocate(void* ptr, uint64 old_size, uint64 new_size, uint64 alignment)
+{
+    void* new_ptr = Allocate(new_size, alignment);
+    if (new_ptr != nullptr && ptr != nullptr)
+    {
+        memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+        Free(ptr, old_size, alignment);
+    }
+    return new_ptr;
+}
+
+void* HeapAllocator::Allocate(uint64 size, uint64 alignment)
+{
+    rsblAssert(IsPowerOfTwo(alignment));
+
+    if (alignment <= kDefaultAllocationAlignment)
+    {
+        return malloc(size);
+    }
+
+    // Over-allocate and stash the original pointer right before the aligned block. This avoids
+    // the platform split between _aligned_malloc and aligned_alloc.
+    void* raw = malloc(size + alignment + sizeof(void*));
+    if (raw == nullptr)
+    {
+        return nullptr;
+    }
+
+    const uint64 aligned =
+        AlignUp(reinterpret_cast<uint64>(raw) + sizeof(void*), alignment);
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void HeapAllocator::Free(void* ptr, uint64 size, uint64 alignment)
+{
+    rsblUnused(size);
+
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    if (alignment <= kDefaultAllocationAlignment)
+    {
+        free(ptr);
+        return;
+    }
+
+    free(static_cast<void**>(ptr)[-1]);
+}
+
+void* HeapAllocator::Reallocate(void* ptr, uint64 old_size, uint64 new_size, uint64 alignment)
+{
+    // realloc can often extend in place, or at least avoid a separate alloc + free round trip
+    if (alignment <= kDefaultAllocationAlignment)
+    {
+        return realloc(ptr, new_size);
+    }
+
+    return Allocator::Reallocate(ptr, old_size, new_size, alignment);
+}
+
+Allocator* GetDefaultAllocator()
+{
+    return GetTaggedAllocator(GetCurrentMemoryTag());
+}
+
+// LinearArena
+
+LinearArena::LinearArena(uint64 block_size, Allocator* backing)
+    : m_backing(backing)
+    , m_blockSize(block_size)
+{
+    rsblAssert(m_backing != nullptr);
+}
+
+LinearArena::LinearArena(void* buffer, uint64 buffer_size, Allocator* backing)
+    : m_backing(backing)
+    , m_blockSize(buffer_size)
+{
+    rsblAssert(m_backing != nullptr);
+    rsblAssert(buffer != nullptr);
+
+    m_externalBlock.prev = nullptr;
+    m_externalBlock.data = static_cast<uint8*>(buffer);
+    m_externalBlock.size = buffer_size;
+    m_externalBlock.used = 0;
+    m_externalBlock.owned = false;
+
+    m_current = &m_externalBlock;
+}
+
+LinearArena::~LinearArena()
+{
+    FreeBlocks();
+}
+
+void* LinearArena::Allocate(uint64 size, uint64 alignment)
+{
+    rsblAssert(IsPowerOfTwo(alignment));
+
+    if (m_current != nullptr)
+    {
+        const uint64 base = reinterpret_cast<uint64>(m_current->data);
+        const uint64 aligned_offset = AlignUp(base + m_offset, alignment) - base;
+        if (aligned_offset + size <= m_current->size)
+        {
+            m_offset = aligned_offset + size;
+            return m_current->data + aligned_offset;
+        }
+    }
+
+    // Worst case padding is alignment - 1, so this block is guaranteed to fit the request
+    if (!AddBlock(size + alignment))
+    {
+        return nullptr;
+    }
+
+    const uint64 base = reinterpret_cast<uint64>(m_current->data);
+    const uint64 aligned_offset = AlignUp(base, alignment) - base;
+    m_offset = aligned_offset + size;
+    return m_current->data + aligned_offset;
+}
+
+void LinearArena::Free(void* ptr, uint64 size, uint64 alignment)
+{
+    rsblUnused(alignment);
+
+    if (ptr == nullptr || m_current == nullptr)
+    {
+        return;
+    }
+
+    // Only the top-most allocation can be returned to the arena
+    if (static_cast<uint8*>(ptr) + size == m_current->data + m_offset)
+    {
+        m_offset = static_cast<uint64>(static_cast<uint8*>(ptr) - m_current->data);
+    }
+}
+
+void* LinearArena::Reallocate(void* ptr, uint64 old_size, uint64 new_size, uint64 alignment)
+{
+    if (ptr != nullptr && m_current != nullptr &&
+        static_cast<uint8*>(ptr) + old_size == m_current->data + m_offset)
+    {
+        const uint64 ptr_offset = static_cast<uint64>(static_cast<uint8*>(ptr) - m_current->data);
+        if (ptr_offset + new_size <= m_current->size)
+        {
+            m_offset = ptr_offset + new_size;
+            return ptr;
+        }
+    }
+
+    return Allocator::Reallocate(ptr, old_size, new_size, alignment);
+}
+
+void LinearArena::Reset()
+{
+    if (m_current != nullptr && m_current->prev != nullptr)
+    {
+        // We overflowed the first block. Coalesce the heap blocks into a single block, so this
+        // amount of allocations fit without chaining next time.
+        uint64 owned_capacity = 0;
+        for (Block* block = m_current; block != nullptr; block = block->prev)
+        {
+            if (block->owned)
+            {
+                owned_capacity += block->size;
+            }
+        }
+
+        FreeBlocks();
+        m_blockSize = owned_capacity > m_blockSize ? owned_capacity : m_blockSize;
+
+        if (m_externalBlock.data != nullptr)
+        {
+            m_current = &m_externalBlock;
+        }
+        else
+        {
+            AddBlock(m_blockSize);
+        }
+    }
+
+    m_offset = 0;
+}
+
+LinearArena::Marker LinearArena::GetMarker() const
+{
+    return Marker{m_current, m_offset};
+}
+
+void LinearArena::ResetToMarker(Marker marker)
+{
+    // Nothing was allocated yet, so it's the same as a Reset, which keeps a block for next time
+    // rather than giving every one back. Scopes reset over and over would churn them otherwise.
+    if (marker.block == nullptr)
+    {
+        Reset();
+        return;
+    }
+
+    // Unwind any blocks chained after the marker was taken
+    while (m_current != nullptr && m_current != marker.block)
+    {
+        Block* block = m_current;
+        m_current = block->prev;
+        if (block->owned)
+        {
+            m_backing->Free(block, sizeof(Block) + block->size, kDefaultAllocationAlignment);
+        }
+    }
+
+    rsblAssertMsg(m_current == marker.block, "Marker does not belong to this arena");
+    m_offset = marker.offset;
+}
+
+uint64 LinearArena::BytesUsed() const
+{
+    if (m_current == nullptr)
+    {
+        return 0;
+    }
+
+    uint64 used = m_offset;
+    for (const Block* block = m_current->prev; block != nullptr; block = block->prev)
+    {
+        used += block->used;
+    }
+    return used;
+}
+
+uint64 LinearArena::Capacity() const
+{
+    uint64 capacity = 0;
+    for (const Block* block = m_current; block != nullptr; block = block->prev)
+    {
+        capacity += block->size;
+    }
+    return capacity;
+}
+
+bool LinearArena::AddBlock(uint64 min_size)
+{
+    const uint64 block_size = min_size > m_blockSize ? min_size : m_blockSize;
+
+    // Block header lives at the front of the allocation
+    void* memory = m_backing->Allocate(sizeof(Block) + block_size, kDefaultAllocationAlignment);
+    if (memory == nullptr)
+    {
+        return false;
+    }
+
+    if (m_current != nullptr)
+    {
+        m_current->used = m_offset;
+    }
+
+    Block* block = new (memory) Block;
+    block->prev = m_current;
+    block->data = reinterpret_cast<uint8*>(block + 1);
+    block->size = block_size;
+    block->used = 0;
+    block->owned = true;
+
+    m_current = block;
+    m_offset = 0;
+    return true;
+}
+
+void LinearArena::FreeBlocks()
+{
+    while (m_current != nullptr)
+    {
+        Block* block = m_current;
+        m_current = block->prev;
+        if (block->owned)
+        {
+            m_backing->Free(block, sizeof(Block) + block->size, kDefaultAllocationAlignment);
+        }
+    }
+    m_externalBlock.prev = nullptr;
+    m_offset = 0;
+}
+
+// FrameArena
+
+FrameArena::FrameArena(uint64 block_size, uint32 frame_count, Allocator* backing)
+    : m_frameCount(frame_count)
+{
+    rsblAssert(frame_count > 0 && frame_count <= kMaxFrameCount);
+    if (m_frameCount == 0)
+    {
+        m_frameCount = 1;
+    }
+    else if (m_frameCount > kMaxFrameCount)
+    {
+        m_frameCount = kMaxFrameCount;
+    }
+
+    for (uint32 i = 0; i < m_frameCount; ++i)
+    {
+        new (m_arenaStorage[i]) LinearArena(block_size, backing);
+    }
+}
+
+FrameArena::~FrameArena()
+{
+    for (uint32 i = 0; i < m_frameCount; ++i)
+    {
+        reinterpret_cast<LinearArena*>(m_arenaStorage[i])->~LinearArena();
+    }
+}
+
+void FrameArena::BeginFrame()
+{
+    m_frameIndex = (m_frameIndex + 1) % m_frameCount;
+    CurrentArena().Reset();
+}
+
+void* FrameArena::Allocate(uint64 size, uint64 alignment)
+{
+    return CurrentArena().Allocate(size, alignment);
+}
+
+void FrameArena::Free(void* ptr, uint64 size, uint64 alignment)
+{
+    CurrentArena().Free(ptr, size, alignment);
+}
+
+void* FrameArena::Reallocate(void* ptr, uint64 old_size, uint64 new_size, uint64 alignment)
+{
+    return CurrentArena().Reallocate(ptr, old_size, new_size, alignment);
+}
+
+LinearArena& FrameArena::CurrentArena()
+{
+    return *reinterpret_cast<LinearArena*>(m_arenaStorage[m_frameIndex]);
+}
+
+} // namespace rsbl
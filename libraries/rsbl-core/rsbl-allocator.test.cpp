@@ -0,0 +1,272 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-allocator.h"
+#include "include/rsbl-dynamic-array.h"
+
+using namespace rsbl;
+
+// Counts traffic to the backing allocator so we can verify arenas batch their requests
+class CountingAllocator : public Allocator
+{
+  public:
+    void* Allocate(uint64 size, uint64 alignment) override
+    {
+        allocCalls++;
+        liveBytes += size;
+        return GetDefaultAllocator()->Allocate(size, alignment);
+    }
+
+    void Free(void* ptr, uint64 size, uint64 alignment) override
+    {
+        freeCalls++;
+        liveBytes -= size;
+        GetDefaultAllocator()->Free(ptr, size, alignment);
+    }
+
+    int allocCalls = 0;
+    int freeCalls = 0;
+    uint64 liveBytes = 0;
+};
+
+static bool IsAligned(const void* ptr, uint64 alignment)
+{
+    return (reinterpret_cast<uint64>(ptr) & (alignment - 1)) == 0;
+}
+
+TEST_SUITE("rsbl::HeapAllocator")
+{
+    TEST_CASE("Default allocator is valid")
+    {
+        CHECK(GetDefaultAllocator() != nullptr);
+    }
+
+    TEST_CASE("Allocations respect alignment")
+    {
+        Allocator* heap = GetDefaultAllocator();
+
+        void* small = heap->Allocate(24, 8);
+        void* over_aligned = heap->Allocate(100, 256);
+
+        REQUIRE(small != nullptr);
+        REQUIRE(over_aligned != nullptr);
+        CHECK(IsAligned(small, 8));
+        CHECK(IsAligned(over_aligned, 256));
+
+        heap->Free(small, 24, 8);
+        heap->Free(over_aligned, 100, 256);
+    }
+}
+
+TEST_SUITE("rsbl::LinearArena")
+{
+    TEST_CASE("Allocations are sequential and aligned")
+    {
+        LinearArena arena(1024);
+
+        uint8* a = static_cast<uint8*>(arena.Allocate(3, 1));
+        uint32* b = arena.AllocateArray<uint32>(4);
+        void* c = arena.Allocate(16, 64);
+
+        REQUIRE(a != nullptr);
+        REQUIRE(b != nullptr);
+        REQUIRE(c != nullptr);
+        CHECK(IsAligned(b, alignof(uint32)));
+        CHECK(IsAligned(c, 64));
+        CHECK(reinterpret_cast<uint8*>(b) > a);
+        CHECK(static_cast<uint8*>(c) > reinterpret_cast<uint8*>(b));
+    }
+
+    TEST_CASE("Block is allocated lazily and re-used after Reset")
+    {
+        CountingAllocator backing;
+
+        {
+            LinearArena arena(256, &backing);
+            CHECK(backing.allocCalls == 0);
+
+            arena.Allocate(64, 8);
+            arena.Allocate(64, 8);
+            CHECK(backing.allocCalls == 1);
+            CHECK(arena.BytesUsed() == 128);
+
+            arena.Reset();
+            CHECK(arena.BytesUsed() == 0);
+
+            arena.Allocate(64, 8);
+            CHECK(backing.allocCalls == 1);
+        }
+
+        CHECK(backing.freeCalls == 1);
+        CHECK(backing.liveBytes == 0);
+    }
+
+    TEST_CASE("Overflow chains blocks and Reset coalesces them")
+    {
+        CountingAllocator backing;
+        LinearArena arena(128, &backing);
+
+        for (int i = 0; i < 8; ++i)
+        {
+            CHECK(arena.Allocate(64, 8) != nullptr);
+        }
+        CHECK(backing.allocCalls > 1);
+        CHECK(arena.BytesUsed() == 8 * 64);
+
+        arena.Reset();
+        CHECK(arena.Capacity() >= 8 * 64);
+
+        // Same workload now fits in the single coalesced block
+        const int calls_before = backing.allocCalls;
+        for (int i = 0; i < 8; ++i)
+        {
+            arena.Allocate(64, 8);
+        }
+        CHECK(backing.allocCalls == calls_before);
+    }
+
+    TEST_CASE("Freeing the top allocation rolls the arena back")
+    {
+        LinearArena arena(256);
+
+        void* a = arena.Allocate(32, 8);
+        void* b = arena.Allocate(32, 8);
+        arena.Free(b, 32, 8);
+
+        void* c = arena.Allocate(32, 8);
+        CHECK(c == b);
+
+        // Freeing a non-top allocation does nothing
+        arena.Free(a, 32, 8);
+        CHECK(arena.BytesUsed() == 64);
+    }
+
+    TEST_CASE("Markers release everything allocated after them")
+    {
+        LinearArena arena(64);
+        arena.Allocate(16, 8);
+
+        const LinearArena::Marker marker = arena.GetMarker();
+        const uint64 used = arena.BytesUsed();
+
+        // Overflow into a new block, then unwind it
+        arena.Allocate(48, 8);
+        arena.Allocate(48, 8);
+        arena.ResetToMarker(marker);
+
+        CHECK(arena.BytesUsed() == used);
+    }
+
+    TEST_CASE("A marker from before the first allocation keeps a block")
+    {
+        CountingAllocator backing;
+        LinearArena arena(64, &backing);
+
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            const LinearArena::Marker marker = arena.GetMarker();
+            arena.Allocate(32, 8);
+            arena.ResetToMarker(marker);
+            CHECK(arena.BytesUsed() == 0);
+        }
+        CHECK(backing.allocCalls == 1);
+    }
+
+    TEST_CASE("External buffer is used before the backing allocator")
+    {
+        CountingAllocator backing;
+        alignas(16) uint8 buffer[128];
+
+        LinearArena arena(buffer, sizeof(buffer), &backing);
+        void* a = arena.Allocate(64, 8);
+        CHECK(a == buffer);
+        CHECK(backing.allocCalls == 0);
+
+        // Spill to the heap
+        arena.Allocate(128, 8);
+        CHECK(backing.allocCalls == 1);
+
+        arena.Reset();
+        CHECK(backing.liveBytes == 0);
+        CHECK(arena.Allocate(16, 8) == buffer);
+    }
+}
+
+TEST_SUITE("rsbl::FrameArena")
+{
+    TEST_CASE("Allocations survive until the arena cycles back")
+    {
+        FrameArena frames(256, 2);
+
+        int* frame0 = frames.AllocateArray<int>(1);
+        *frame0 = 42;
+
+        frames.BeginFrame();
+        int* frame1 = frames.AllocateArray<int>(1);
+        *frame1 = 99;
+        CHECK(frame1 != frame0);
+        CHECK(*frame0 == 42);
+
+        // Back to the first arena, which has been reset
+        frames.BeginFrame();
+        CHECK(frames.FrameIndex() == 0);
+        CHECK(frames.CurrentArena().BytesUsed() == 0);
+        CHECK(frames.AllocateArray<int>(1) == frame0);
+    }
+}
+
+TEST_SUITE("rsbl::DynamicArray with Allocator")
+{
+    TEST_CASE("DynamicArray allocates from the given allocator")
+    {
+        CountingAllocator backing;
+
+        {
+            DynamicArray<int> arr(&backing);
+            for (int i = 0; i < 100; ++i)
+            {
+                arr.PushBack(i);
+            }
+
+            CHECK(arr.GetAllocator() == &backing);
+            CHECK(backing.allocCalls > 0);
+            CHECK(arr[99] == 99);
+        }
+
+        CHECK(backing.liveBytes == 0);
+    }
+
+    TEST_CASE("DynamicArray in an arena")
+    {
+        LinearArena arena(4096);
+
+        DynamicArray<int> arr(16, &arena);
+        for (int i = 0; i < 200; ++i)
+        {
+            arr.PushBack(i);
+        }
+
+        CHECK(arr.Size() == 200);
+        CHECK(arr[150] == 150);
+        CHECK(arena.BytesUsed() >= 200 * sizeof(int));
+    }
+
+    TEST_CASE("Copies share the allocator, moves carry it along")
+    {
+        CountingAllocator backing;
+
+        DynamicArray<int> arr(&backing);
+        arr.PushBack(1);
+
+        DynamicArray<int> copy(arr);
+        CHECK(copy.GetAllocator() == &backing);
+
+        DynamicArray<int> moved;
+        moved = rsblMove(copy);
+        CHECK(moved.GetAllocator() == &backing);
+        CHECK(moved[0] == 1);
+    }
+}
@@ -0,0 +1,129 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-array-view.h"
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-fixed-array.h"
+#include "include/rsbl-small-array.h"
+
+using namespace rsbl;
+
+struct Base
+{
+    int a;
+};
+
+struct Derived : Base
+{
+    int b;
+};
+
+// Derived to base would index with the wrong stride, and const can't be dropped
+static_assert(!Internal::ViewableContainer<DynamicArray<Derived>, Base>);
+static_assert(!Internal::ViewableContainer<const DynamicArray<int>, int>);
+static_assert(Internal::ViewableContainer<const DynamicArray<int>, const int>);
+static_assert(sizeof(ArrayView<int>) == sizeof(int*) + sizeof(uint64));
+
+static int Sum(ArrayView<const int> values)
+{
+    int sum = 0;
+    for (int value : values)
+    {
+        sum += value;
+    }
+    return sum;
+}
+
+TEST_SUITE("rsbl::ArrayView")
+{
+    TEST_CASE("Default view is empty")
+    {
+        ArrayView<int> view;
+        CHECK(view.IsEmpty());
+        CHECK(view.Size() == 0);
+        CHECK(view.Data() == nullptr);
+        CHECK(view.begin() == view.end());
+    }
+
+    TEST_CASE("Containers convert implicitly")
+    {
+        DynamicArray<int> dynamic;
+        dynamic.PushBack(1);
+        dynamic.PushBack(2);
+
+        FixedArray<int, 3> fixed = {1, 2, 3};
+
+        SmallArray<int, 4> small;
+        small.PushBack(10);
+
+        int raw[] = {5, 5};
+
+        CHECK(Sum(dynamic) == 3);
+        CHECK(Sum(fixed) == 6);
+        CHECK(Sum(small) == 10);
+        CHECK(Sum(raw) == 10);
+
+        const DynamicArray<int>& constDynamic = dynamic;
+        CHECK(Sum(constDynamic) == 3);
+    }
+
+    TEST_CASE("Views alias the container storage")
+    {
+        DynamicArray<int> arr;
+        arr.Resize(4);
+
+        ArrayView<int> view = arr;
+        view[2] = 42;
+        CHECK(arr[2] == 42);
+        CHECK(view.Data() == arr.Data());
+        CHECK(view.Size() == 4);
+
+        ArrayView<const int> constView = view;
+        CHECK(constView[2] == 42);
+    }
+
+    TEST_CASE("Deduction from containers")
+    {
+        FixedArray<float, 2> fixed = {1.0f, 2.0f};
+        ArrayView view(fixed);
+        static_assert(IsSame<decltype(view), ArrayView<float>>);
+        CHECK(view.Size() == 2);
+    }
+
+    TEST_CASE("Subviews")
+    {
+        int values[] = {0, 1, 2, 3, 4, 5};
+        ArrayView<int> view(values);
+
+        CHECK(view.Front() == 0);
+        CHECK(view.Back() == 5);
+
+        ArrayView<int> middle = view.Subview(2, 3);
+        CHECK(middle.Size() == 3);
+        CHECK(middle[0] == 2);
+        CHECK(middle.Back() == 4);
+
+        CHECK(view.Subview(4).Size() == 2);
+        CHECK(view.First(2).Back() == 1);
+        CHECK(view.Last(2).Front() == 4);
+        CHECK(view.Subview(6).IsEmpty());
+    }
+
+    TEST_CASE("Byte views")
+    {
+        uint32 words[] = {0x04030201, 0x08070605};
+        ByteView bytes = AsBytes(ArrayView<uint32>(words));
+        CHECK(bytes.Size() == 8);
+        CHECK(bytes.Data() == reinterpret_cast<const uint8*>(words));
+
+        MutableByteView writable = AsWritableBytes(ArrayView<uint32>(words));
+        writable[0] = 0xff;
+        CHECK((words[0] & 0xff) == 0xff);
+
+        const char text[] = "abc";
+        CHECK(AsBytes(text, 3).Size() == 3);
+    }
+}
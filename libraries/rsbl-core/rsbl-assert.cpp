@@ -16,6 +16,8 @@ void DebuggerOutput(const char* error_buffer)
 {
 #if defined(_MSC_VER)
     OutputDebugStringA(error_buffer);
+#else
+    (void)error_buffer;
 #endif
 }
 
@@ -30,12 +32,13 @@ rsbl::Assert::FailureBehavior DefaultHandler(const char* condition,
 {
 
     char error_buffer[2048];
-    sprintf_s(error_buffer,
-              "%s(%d): Assert Failure: '%s' %s\n",
-              file,
-              line,
-              condition != nullptr ? condition : "",
-              msg != nullptr ? msg : "");
+    snprintf(error_buffer,
+             sizeof(error_buffer),
+             "%s(%d): Assert Failure: '%s' %s\n",
+             file,
+             line,
+             condition != nullptr ? condition : "",
+             msg != nullptr ? msg : "");
 
     fprintf(stderr, "%s", error_buffer);
     DebuggerOutput(error_buffer);
@@ -68,4 +71,9 @@ rsbl::Assert::FailureBehavior rsbl::Assert::ReportFailure(const char* condition,
                                                           const char* msg)
 {
     return s_assertHandler(condition, msg, file, line);
-}
\ No newline at end of file
+}
+
+bool rsbl::Assert::Fail(const char* condition, const char* file, const int line, const char* msg)
+{
+    return ReportFailure(condition, file, line, msg) == FailureBehavior::Halt;
+}
@@ -0,0 +1,96 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-assert.h"
+
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+int s_failures = 0;
+const char* s_condition = nullptr;
+const char* s_msg = nullptr;
+
+Assert::FailureBehavior CountingHandler(const char* condition,
+                                        const char* msg,
+                                        const char* /*file*/,
+                                        int /*line*/)
+{
+    ++s_failures;
+    s_condition = condition;
+    s_msg = msg;
+    return Assert::FailureBehavior::Continue;
+}
+
+// Installs the counting handler for a test, so failures don't break into the debugger
+struct HandlerScope
+{
+    Assert::Handler previous = Assert::GetHandler();
+
+    HandlerScope()
+    {
+        s_failures = 0;
+        s_condition = nullptr;
+        s_msg = nullptr;
+        Assert::SetHandler(&CountingHandler);
+    }
+
+    ~HandlerScope()
+    {
+        Assert::SetHandler(previous);
+    }
+};
+} // namespace
+
+TEST_SUITE("rsbl::Assert")
+{
+    TEST_CASE("Passing checks don't report")
+    {
+        HandlerScope handler;
+        rsblAssert(1 + 1 == 2);
+        rsblAssertMsg(true, "never shown");
+        rsblAssertSlow(true);
+        rsblVerify(true);
+        CHECK(s_failures == 0);
+    }
+
+    TEST_CASE("Failures reach the handler")
+    {
+        HandlerScope handler;
+        const int value = 3;
+        rsblAssertMsg(value == 4, "value is off");
+#if defined(RSBL_ASSERTS_ENABLED)
+        CHECK(s_failures == 1);
+        CHECK(strcmp(s_condition, "value == 4") == 0);
+        CHECK(strcmp(s_msg, "value is off") == 0);
+#else
+        CHECK(s_failures == 0);
+#endif
+
+        rsblAssertSlow(value == 4);
+#if defined(RSBL_SLOW_ASSERTS_ENABLED)
+        CHECK(s_failures == 2);
+#endif
+    }
+
+    TEST_CASE("Verify checks in every build")
+    {
+        HandlerScope handler;
+        int evaluated = 0;
+        rsblVerifyMsg(++evaluated == 2, "verified");
+        CHECK(evaluated == 1);
+        CHECK(s_failures == 1);
+#if defined(RSBL_ASSERTS_ENABLED)
+        CHECK(strcmp(s_msg, "verified") == 0);
+#else
+        // Just the file and line without asserts
+        CHECK(s_condition == nullptr);
+        CHECK(s_msg == nullptr);
+#endif
+    }
+}
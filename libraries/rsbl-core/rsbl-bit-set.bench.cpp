@@ -0,0 +1,91 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// DynamicBitSet against a DynamicArray<bool> walk, on a 1M entry visibility set where about one
+// in sixteen entries is visible.
+
+#include "include/rsbl-bit-set.h"
+#include "include/rsbl-dynamic-array.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint64 kBitCount = 1 << 20;
+constexpr uint32 kRepeats = 200;
+
+// Stop the optimizer from folding the loops away
+volatile uint64 s_sink = 0;
+
+template <typename F>
+void Time(const char* name, F&& f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32 repeat = 0; repeat < kRepeats; ++repeat)
+    {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double us = std::chrono::duration<double, std::micro>(end - start).count();
+    printf("  %-40s %8.2f us/scan\n", name, us / static_cast<double>(kRepeats));
+}
+} // namespace
+
+int main()
+{
+    DynamicBitSet bits(kBitCount);
+    DynamicBitSet mask(kBitCount);
+    DynamicArray<bool> bools;
+    bools.Resize(kBitCount);
+
+    uint64 state = 1;
+    for (uint64 i = 0; i < kBitCount; ++i)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        const bool visible = (state >> 60) == 0;
+        bits.Set(i, visible);
+        bools[i] = visible;
+        mask.Set(i, (state >> 63) != 0);
+    }
+
+    printf("1M visibility bits, %llu set\n", static_cast<unsigned long long>(bits.Count()));
+
+    Time("DynamicArray<bool> walk", [&]() {
+        uint64 sum = 0;
+        for (uint64 i = 0; i < bools.Size(); ++i)
+        {
+            if (bools[i])
+            {
+                sum += i;
+            }
+        }
+        s_sink = sum;
+    });
+
+    Time("DynamicBitSet::SetBits", [&]() {
+        uint64 sum = 0;
+        for (uint64 index : bits.SetBits())
+        {
+            sum += index;
+        }
+        s_sink = sum;
+    });
+
+    Time("DynamicBitSet::Count", [&]() { s_sink = bits.Count(); });
+
+    DynamicBitSet empty(kBitCount);
+    Time("DynamicBitSet::FindFirstSet (empty)", [&]() { s_sink = empty.FindFirstSet(); });
+
+    DynamicBitSet scratch(kBitCount);
+    Time("DynamicBitSet::AndNot", [&]() {
+        scratch = bits;
+        scratch.AndNot(mask);
+        s_sink = scratch.Words()[0];
+    });
+
+    return 0;
+}
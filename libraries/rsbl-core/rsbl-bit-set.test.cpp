@@ -0,0 +1,308 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-bit-set.h"
+#include "include/rsbl-dynamic-array.h"
+
+using namespace rsbl;
+
+TEST_SUITE("rsbl::BitSet")
+{
+    TEST_CASE("Starts clear")
+    {
+        BitSet<100> bits;
+        CHECK(bits.Size() == 100);
+        CHECK(bits.WordCount() == 2);
+        CHECK(bits.None());
+        CHECK(bits.Count() == 0);
+        CHECK(bits.FindFirstSet() == 100);
+        CHECK(bits.FindFirstClear() == 0);
+    }
+
+    TEST_CASE("Set, Reset and Flip")
+    {
+        BitSet<130> bits;
+        bits.Set(0);
+        bits.Set(64);
+        bits.Set(129);
+        CHECK(bits.Test(0));
+        CHECK(bits[64]);
+        CHECK(bits.Test(129));
+        CHECK_FALSE(bits.Test(1));
+        CHECK(bits.Count() == 3);
+
+        bits.Reset(64);
+        CHECK_FALSE(bits.Test(64));
+        bits.Flip(1);
+        bits.Flip(0);
+        CHECK(bits.Test(1));
+        CHECK_FALSE(bits.Test(0));
+
+        bits.Set(5, true);
+        bits.Set(1, false);
+        CHECK(bits.Test(5));
+        CHECK_FALSE(bits.Test(1));
+    }
+
+    TEST_CASE("SetAll keeps the tail clear")
+    {
+        BitSet<70> bits;
+        bits.SetAll();
+        CHECK(bits.Count() == 70);
+        CHECK(bits.All());
+        CHECK(bits.FindFirstClear() == 70);
+        CHECK(bits.Words()[1] == 0x3F);
+
+        bits.ResetAll();
+        CHECK(bits.None());
+    }
+
+    TEST_CASE("FindFirstSet and FindFirstClear")
+    {
+        BitSet<1000> bits;
+        bits.Set(3);
+        bits.Set(700);
+        bits.Set(999);
+
+        CHECK(bits.FindFirstSet() == 3);
+        CHECK(bits.FindFirstSet(3) == 3);
+        CHECK(bits.FindFirstSet(4) == 700);
+        CHECK(bits.FindFirstSet(701) == 999);
+        CHECK(bits.FindFirstSet(1000) == 1000);
+
+        bits.SetAll();
+        bits.Reset(513);
+        CHECK(bits.FindFirstClear() == 513);
+        CHECK(bits.FindFirstClear(514) == 1000);
+    }
+
+    TEST_CASE("SetRange")
+    {
+        BitSet<300> bits;
+        bits.SetRange(10, 5);
+        CHECK(bits.Count() == 5);
+        CHECK(bits.FindFirstSet() == 10);
+        CHECK(bits.FindFirstClear(10) == 15);
+
+        bits.SetRange(60, 200);
+        CHECK(bits.Count() == 205);
+        CHECK(bits.FindFirstClear(60) == 260);
+
+        bits.SetRange(62, 196, false);
+        CHECK(bits.Count() == 9);
+        CHECK(bits.Test(61));
+        CHECK(bits.Test(258));
+        CHECK_FALSE(bits.Test(62));
+
+        bits.SetRange(0, 0);
+        CHECK(bits.Count() == 9);
+    }
+
+    TEST_CASE("Iterating set bits")
+    {
+        BitSet<512> bits;
+        const uint64 expected[] = {0, 1, 63, 64, 200, 511};
+        for (uint64 index : expected)
+        {
+            bits.Set(index);
+        }
+
+        uint64 i = 0;
+        for (uint64 index : bits.SetBits())
+        {
+            REQUIRE(i < 6);
+            CHECK(index == expected[i]);
+            i++;
+        }
+        CHECK(i == 6);
+
+        BitSet<512> empty;
+        CHECK(empty.SetBits().begin() == empty.SetBits().end());
+    }
+
+    TEST_CASE("Bulk operations")
+    {
+        BitSet<200> a;
+        BitSet<200> b;
+        a.SetRange(0, 100);
+        b.SetRange(50, 100);
+
+        BitSet<200> both = a;
+        both &= b;
+        CHECK(both.Count() == 50);
+        CHECK(both.FindFirstSet() == 50);
+
+        BitSet<200> either = a;
+        either |= b;
+        CHECK(either.Count() == 150);
+
+        BitSet<200> onlyA = a;
+        onlyA.AndNot(b);
+        CHECK(onlyA.Count() == 50);
+        CHECK(onlyA.FindFirstClear() == 50);
+
+        CHECK(both == both);
+        CHECK_FALSE(both == either);
+    }
+}
+
+TEST_SUITE("rsbl::DynamicBitSet")
+{
+    TEST_CASE("Default is empty")
+    {
+        DynamicBitSet bits;
+        CHECK(bits.IsEmpty());
+        CHECK(bits.Count() == 0);
+        CHECK(bits.None());
+        CHECK(bits.All());
+        CHECK(bits.FindFirstSet() == 0);
+        CHECK(bits.SetBits().begin() == bits.SetBits().end());
+    }
+
+    TEST_CASE("Resize fills new bits")
+    {
+        DynamicBitSet bits(10, true);
+        CHECK(bits.Count() == 10);
+
+        bits.Resize(200);
+        CHECK(bits.Count() == 10);
+        CHECK(bits.FindFirstClear() == 10);
+
+        bits.Resize(300, true);
+        CHECK(bits.Count() == 110);
+        CHECK(bits.FindFirstSet(10) == 200);
+
+        // Shrinking then growing again doesn't bring back old bits
+        bits.Resize(5);
+        CHECK(bits.Count() == 5);
+        bits.Resize(300);
+        CHECK(bits.Count() == 5);
+
+        bits.Clear();
+        CHECK(bits.IsEmpty());
+        bits.Resize(64);
+        CHECK(bits.None());
+    }
+
+    TEST_CASE("PushBack")
+    {
+        DynamicBitSet bits;
+        for (uint64 i = 0; i < 1000; ++i)
+        {
+            bits.PushBack(i % 3 == 0);
+        }
+        CHECK(bits.Size() == 1000);
+        CHECK(bits.Count() == 334);
+        CHECK(bits.FindFirstSet(1) == 3);
+    }
+
+    TEST_CASE("Iterating matches a plain scan")
+    {
+        DynamicBitSet bits(5000);
+        DynamicArray<uint64> expected;
+        uint64 state = 12345;
+        for (uint64 i = 0; i < bits.Size(); ++i)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            // Long empty runs exercise the word skipping
+            if ((state >> 60) == 0 && (i < 1000 || i > 4000))
+            {
+                bits.Set(i);
+                expected.PushBack(i);
+            }
+        }
+
+        uint64 i = 0;
+        for (uint64 index : bits.SetBits())
+        {
+            REQUIRE(i < expected.Size());
+            CHECK(index == expected[i]);
+            i++;
+        }
+        CHECK(i == expected.Size());
+        CHECK(bits.Count() == expected.Size());
+
+        // FindFirstSet walks the same bits
+        i = 0;
+        for (uint64 index = bits.FindFirstSet(); index < bits.Size();
+             index = bits.FindFirstSet(index + 1))
+        {
+            CHECK(index == expected[i]);
+            i++;
+        }
+        CHECK(i == expected.Size());
+    }
+
+    TEST_CASE("Free slot search")
+    {
+        DynamicBitSet used(1024);
+        used.SetRange(0, 1000);
+        CHECK(used.FindFirstClear() == 1000);
+
+        used.Reset(517);
+        CHECK(used.FindFirstClear() == 517);
+        used.Set(517);
+
+        used.SetRange(1000, 24);
+        CHECK(used.FindFirstClear() == 1024);
+        CHECK(used.All());
+    }
+
+    TEST_CASE("Bulk operations")
+    {
+        DynamicBitSet visible(1000);
+        DynamicBitSet culled(1000);
+        visible.SetAll();
+        culled.SetRange(100, 50);
+
+        visible.AndNot(culled);
+        CHECK(visible.Count() == 950);
+        CHECK(visible.FindFirstClear() == 100);
+
+        // Fixed and dynamic sets of the same size mix
+        BitSet<1000> dirty;
+        dirty.Set(120);
+        dirty.Set(999);
+        culled |= dirty;
+        CHECK(culled.Count() == 51);
+        culled &= dirty;
+        CHECK(culled.Count() == 2);
+    }
+
+    TEST_CASE("Copy and move")
+    {
+        DynamicBitSet original(300);
+        original.Set(7);
+        original.Set(299);
+
+        DynamicBitSet copy(original);
+        CHECK(copy == original);
+        copy.Reset(7);
+        CHECK_FALSE(copy == original);
+
+        copy = original;
+        CHECK(copy == original);
+
+        const uint64* words = original.Words();
+        DynamicBitSet moved(rsblMove(original));
+        CHECK(moved.Words() == words);
+        CHECK(original.IsEmpty());
+        CHECK(moved.Count() == 2);
+
+        original = rsblMove(moved);
+        CHECK(original.Count() == 2);
+        CHECK(moved.IsEmpty());
+    }
+
+    TEST_CASE("Custom allocator")
+    {
+        HeapAllocator heap;
+        DynamicBitSet bits(100, &heap);
+        CHECK(bits.GetAllocator() == &heap);
+        bits.Set(99);
+        CHECK(bits.FindFirstSet() == 99);
+    }
+}
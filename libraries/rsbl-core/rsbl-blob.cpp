@@ -0,0 +1,218 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-blob.h"
+
+#include "include/rsbl-bits.h"
+
+namespace rsbl
+{
+
+namespace
+{
+// References are an int32 offset, then an array's uint32 count
+constexpr uint64 kReferenceAlignment = alignof(BlobReferenceBase);
+constexpr uint64 kMaxBlobSize = uint64(1) << 31;
+} // namespace
+
+BlobWriter::BlobWriter(uint32 magic, uint32 version, Allocator* allocator)
+    : m_allocator(allocator)
+    , m_references(allocator)
+{
+    const uint32 header_offset = Allocate(sizeof(BlobHeader), alignof(BlobHeader));
+    BlobHeader* header = reinterpret_cast<BlobHeader*>(m_data + header_offset);
+    header->magic = magic;
+    header->version = version;
+}
+
+BlobWriter::~BlobWriter()
+{
+    if (m_data != nullptr)
+    {
+        m_allocator->Free(m_data, m_capacity, kBlobMaxAlignment);
+    }
+}
+
+uint32 BlobWriter::Allocate(uint64 size, uint64 alignment)
+{
+    rsblAssertMsg(!m_finished, "Nothing can be added to a finished blob");
+
+    const uint64 offset = AlignUp(m_size, alignment);
+    const uint64 end = offset + size;
+    rsblVerifyMsg(end < kMaxBlobSize, "Blobs are up to 2 GB");
+    if (end > m_capacity)
+    {
+        uint64 capacity = m_capacity == 0 ? 4096 : m_capacity * 2;
+        while (capacity < end)
+        {
+            capacity *= 2;
+        }
+        uint8* data = static_cast<uint8*>(m_allocator->Allocate(capacity, kBlobMaxAlignment));
+        rsblVerifyMsg(data != nullptr, "Failed to allocate a blob");
+        if (m_data != nullptr)
+        {
+            memcpy(data, m_data, m_size);
+            m_allocator->Free(m_data, m_capacity, kBlobMaxAlignment);
+        }
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    memset(m_data + m_size, 0, end - m_size);
+    m_size = end;
+    m_alignment = alignment > m_alignment ? static_cast<uint32>(alignment) : m_alignment;
+    return static_cast<uint32>(offset);
+}
+
+BlobRef<char> BlobWriter::AddString(StringView text)
+{
+    const BlobRef<char> added{Allocate(text.Size() + 1, 1), static_cast<uint32>(text.Size())};
+    if (!text.IsEmpty())
+    {
+        memcpy(m_data + added.offset, text.Data(), text.Size());
+    }
+    return added;
+}
+
+void BlobWriter::Link(BlobReferenceBase& reference,
+                      uint32 target,
+                      BlobReferenceKind kind,
+                      uint32 elementSize,
+                      uint32 alignment)
+{
+    const uint8* at = reinterpret_cast<const uint8*>(&reference);
+    rsblAssertMsg(at >= m_data && at < m_data + m_size,
+                  "Blob references can only point from inside the blob, from a Get since the "
+                  "last Add");
+    const uint32 offset = static_cast<uint32>(at - m_data);
+    reference.m_offset = static_cast<int32>(int64(target) - int64(offset));
+
+    BlobReferenceRecord& record = m_references.EmplaceBack();
+    record.offset = offset;
+    record.elementSize = elementSize;
+    record.alignment = static_cast<uint16>(alignment);
+    record.kind = kind;
+}
+
+ByteView BlobWriter::Finish()
+{
+    if (!m_finished)
+    {
+        const uint32 table_offset = Allocate(m_references.Size() * sizeof(BlobReferenceRecord),
+                                             alignof(BlobReferenceRecord));
+        if (!m_references.IsEmpty())
+        {
+            memcpy(m_data + table_offset,
+                   m_references.Data(),
+                   m_references.Size() * sizeof(BlobReferenceRecord));
+        }
+
+        BlobHeader* header = reinterpret_cast<BlobHeader*>(m_data);
+        header->size = m_size;
+        header->rootOffset = m_rootOffset;
+        header->referenceTableOffset = table_offset;
+        header->referenceCount = static_cast<uint32>(m_references.Size());
+        header->alignment = m_alignment;
+        m_finished = true;
+    }
+    return ByteView(m_data, m_size);
+}
+
+Result<const BlobHeader*> OpenBlob(ByteView bytes, uint32 magic, uint32 version)
+{
+    if (bytes.Size() < sizeof(BlobHeader) ||
+        reinterpret_cast<uintptr_t>(bytes.Data()) % alignof(BlobHeader) != 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Too small to be a blob, or misaligned"};
+    }
+
+    const BlobHeader* header = reinterpret_cast<const BlobHeader*>(bytes.Data());
+    if (header->magic != magic)
+    {
+        return {ErrorCategory::InvalidArgument, "Not the blob expected"};
+    }
+    if (header->version != version)
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "Blob version %u, expected %u",
+                             header->version,
+                             version);
+    }
+
+    const uint64 table_end = uint64(header->referenceTableOffset) +
+                             uint64(header->referenceCount) * sizeof(BlobReferenceRecord);
+    if (header->size > bytes.Size() || header->size < sizeof(BlobHeader) ||
+        !IsPowerOfTwo(header->alignment) || header->alignment > kBlobMaxAlignment ||
+        header->referenceTableOffset % alignof(BlobReferenceRecord) != 0 ||
+        header->referenceTableOffset < sizeof(BlobHeader) || table_end > header->size ||
+        header->rootOffset < sizeof(BlobHeader) ||
+        header->rootOffset > header->referenceTableOffset)
+    {
+        return {ErrorCategory::InvalidArgument, "Blob header is corrupt"};
+    }
+    if (reinterpret_cast<uintptr_t>(bytes.Data()) % header->alignment != 0)
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "Blob has to start on %u bytes",
+                             header->alignment);
+    }
+    return header;
+}
+
+Result<> ValidateBlob(const BlobHeader& blob)
+{
+    const uint8* base = reinterpret_cast<const uint8*>(&blob);
+    // References only point at data, never at the header or the table
+    const uint64 data_end = blob.referenceTableOffset;
+    const BlobReferenceRecord* records =
+        reinterpret_cast<const BlobReferenceRecord*>(base + blob.referenceTableOffset);
+
+    for (uint32 i = 0; i < blob.referenceCount; ++i)
+    {
+        const BlobReferenceRecord& record = records[i];
+        const uint64 reference_size =
+            record.kind == BlobReferenceKind::Pointer ? sizeof(int32) : 2 * sizeof(uint32);
+        if (record.kind > BlobReferenceKind::String || record.offset % kReferenceAlignment != 0 ||
+            record.offset < sizeof(BlobHeader) || record.offset + reference_size > data_end ||
+            !IsPowerOfTwo(record.alignment) || record.alignment > blob.alignment)
+        {
+            return FailureFormat(ErrorCategory::InvalidArgument,
+                                 "Blob reference %u of %u is corrupt",
+                                 i,
+                                 blob.referenceCount);
+        }
+
+        int32 offset;
+        memcpy(&offset, base + record.offset, sizeof(offset));
+        if (offset == 0)
+        {
+            continue;
+        }
+        uint32 count = 1;
+        if (record.kind != BlobReferenceKind::Pointer)
+        {
+            memcpy(&count, base + record.offset + sizeof(int32), sizeof(count));
+        }
+
+        // A string's terminator has to be in the blob as well
+        const int64 target = int64(record.offset) + offset;
+        const uint64 size = uint64(count) * record.elementSize +
+                            (record.kind == BlobReferenceKind::String ? 1 : 0);
+        if (target < int64(sizeof(BlobHeader)) || uint64(target) + size > data_end ||
+            uint64(target) % record.alignment != 0)
+        {
+            return FailureFormat(ErrorCategory::InvalidArgument,
+                                 "Blob reference at %u points outside the blob's data",
+                                 record.offset);
+        }
+        if (record.kind == BlobReferenceKind::String && base[target + count] != 0)
+        {
+            return FailureFormat(ErrorCategory::InvalidArgument,
+                                 "Blob string at %u isn't terminated",
+                                 record.offset);
+        }
+    }
+    return ResultCode::Success;
+}
+
+} // namespace rsbl
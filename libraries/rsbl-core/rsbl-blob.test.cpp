@@ -0,0 +1,230 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-blob.h"
+
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint32 kTestMagic = 0x54534554; // "TEST"
+constexpr uint32 kTestVersion = 3;
+
+struct alignas(16) Vertex
+{
+    float position[4];
+};
+
+struct Section
+{
+    BlobString name;
+    BlobArray<uint32> indices;
+};
+
+struct Table
+{
+    uint32 flags;
+    BlobArray<Vertex> vertices;
+    BlobArray<Section> sections;
+    BlobPtr<Section> largest;
+    BlobString title;
+    BlobPtr<Table> unused;
+};
+
+struct alignas(kBlobMaxAlignment) CacheLine
+{
+    uint8 bytes[kBlobMaxAlignment];
+};
+
+// A finished blob copied somewhere else, as if read from a file
+struct BlobCopy
+{
+    DynamicArray<CacheLine> lines;
+    uint64 size = 0;
+
+    uint8* Data()
+    {
+        return lines.Data()->bytes;
+    }
+
+    ByteView View(uint64 bytes = ~0ull)
+    {
+        return ByteView(Data(), bytes < size ? bytes : size);
+    }
+};
+
+// A table with two sections
+BlobCopy BuildTable()
+{
+    BlobWriter writer(kTestMagic, kTestVersion);
+    const BlobRef<Table> root = writer.Add<Table>();
+
+    const Vertex vertices[] = {{{0.0f, 1.0f, 2.0f, 3.0f}}, {{4.0f, 5.0f, 6.0f, 7.0f}}};
+    const BlobRef<Vertex> vertex_ref = writer.AddArray(ArrayView<const Vertex>(vertices));
+    const BlobRef<Section> sections = writer.Add<Section>(2);
+    const uint32 first_indices[] = {0, 1, 1};
+    const uint32 second_indices[] = {1, 0, 0, 1, 1};
+    const BlobRef<uint32> first = writer.AddArray(ArrayView<const uint32>(first_indices));
+    const BlobRef<uint32> second = writer.AddArray(ArrayView<const uint32>(second_indices));
+    const BlobRef<char> first_name = writer.AddString("first");
+    const BlobRef<char> second_name = writer.AddString("second");
+    const BlobRef<char> title = writer.AddString("table");
+
+    Table* table = writer.Get(root);
+    table->flags = 0xabcd;
+    writer.Point(table->vertices, vertex_ref);
+    writer.Point(table->sections, sections);
+    writer.Point(table->largest, BlobRef<Section>{sections.offset + uint32(sizeof(Section)), 1});
+    writer.Point(table->title, title);
+
+    Section* section = writer.Get(sections);
+    writer.Point(section[0].name, first_name);
+    writer.Point(section[0].indices, first);
+    writer.Point(section[1].name, second_name);
+    writer.Point(section[1].indices, second);
+    writer.SetRoot(root);
+
+    const ByteView bytes = writer.Finish();
+    BlobCopy copy;
+    copy.size = bytes.Size();
+    copy.lines.Resize((bytes.Size() + kBlobMaxAlignment - 1) / kBlobMaxAlignment);
+    memcpy(copy.Data(), bytes.Data(), bytes.Size());
+    return copy;
+}
+} // namespace
+
+TEST_SUITE("rsbl::Blob")
+{
+    TEST_CASE("Blobs are read in place, wherever they land")
+    {
+        BlobCopy bytes = BuildTable();
+        const Result<const BlobHeader*> opened = OpenBlob(bytes.View(), kTestMagic, kTestVersion);
+        REQUIRE(opened);
+        CHECK(opened.Value()->alignment == 16);
+        CHECK(ValidateBlob(*opened.Value()));
+
+        const Table& table = opened.Value()->Root<Table>();
+        CHECK(table.flags == 0xabcd);
+        REQUIRE(table.vertices.Size() == 2);
+        CHECK(table.vertices[1].position[2] == 6.0f);
+        CHECK(reinterpret_cast<uintptr_t>(table.vertices.Data()) % alignof(Vertex) == 0);
+
+        REQUIRE(table.sections.Size() == 2);
+        CHECK(table.sections[0].name.View() == "first");
+        CHECK(strcmp(table.sections[1].name.CStr(), "second") == 0);
+        uint32 index_sum = 0;
+        for (const uint32 index : table.sections[1].indices)
+        {
+            index_sum += index;
+        }
+        CHECK(index_sum == 3);
+        CHECK(table.largest.Get() == &table.sections[1]);
+        CHECK(table.title.View() == "table");
+
+        // Never pointed anywhere
+        CHECK(table.unused.IsNull());
+    }
+
+    TEST_CASE("Empty arrays and strings read as empty")
+    {
+        BlobWriter writer(kTestMagic, kTestVersion);
+        const BlobRef<Section> root = writer.Add<Section>();
+        const BlobRef<char> name = writer.AddString("");
+        writer.Point(writer.Get(root)->name, name);
+        writer.SetRoot(root);
+        const ByteView bytes = writer.Finish();
+
+        const Result<const BlobHeader*> opened = OpenBlob(bytes, kTestMagic, kTestVersion);
+        REQUIRE(opened);
+        CHECK(ValidateBlob(*opened.Value()));
+        const Section& section = opened.Value()->Root<Section>();
+        CHECK(section.name.IsEmpty());
+        CHECK(section.name.View() == "");
+        CHECK(section.indices.IsEmpty());
+        CHECK(section.indices.begin() == section.indices.end());
+    }
+
+    TEST_CASE("Opening checks the header")
+    {
+        BlobCopy bytes = BuildTable();
+        CHECK(OpenBlob(bytes.View(16), kTestMagic, kTestVersion).Category() ==
+              ErrorCategory::InvalidArgument);
+        CHECK_FALSE(OpenBlob(bytes.View(), kTestMagic + 1, kTestVersion));
+
+        const Result<const BlobHeader*> old = OpenBlob(bytes.View(), kTestMagic, kTestVersion - 1);
+        REQUIRE_FALSE(old);
+        CHECK(strcmp(old.FailureText(), "Blob version 3, expected 2") == 0);
+
+        // Cut short
+        CHECK_FALSE(OpenBlob(bytes.View(bytes.size - 1), kTestMagic, kTestVersion));
+
+        // Off what its vertices need
+        DynamicArray<CacheLine> shifted;
+        shifted.Resize(bytes.lines.Size() + 1);
+        memcpy(shifted.Data()->bytes + 8, bytes.Data(), bytes.size);
+        const Result<const BlobHeader*> misaligned =
+            OpenBlob(ByteView(shifted.Data()->bytes + 8, bytes.size), kTestMagic, kTestVersion);
+        REQUIRE_FALSE(misaligned);
+        CHECK(strcmp(misaligned.FailureText(), "Blob has to start on 16 bytes") == 0);
+
+        BlobHeader* header = reinterpret_cast<BlobHeader*>(bytes.Data());
+        header->rootOffset = static_cast<uint32>(bytes.size);
+        CHECK_FALSE(OpenBlob(bytes.View(), kTestMagic, kTestVersion));
+    }
+
+    TEST_CASE("Validation finds references gone bad")
+    {
+        BlobCopy bytes = BuildTable();
+        const BlobHeader& header = *reinterpret_cast<const BlobHeader*>(bytes.Data());
+        const BlobReferenceRecord* records = reinterpret_cast<const BlobReferenceRecord*>(
+            bytes.Data() + header.referenceTableOffset);
+        REQUIRE(header.referenceCount == 8);
+
+        for (uint32 i = 0; i < header.referenceCount; ++i)
+        {
+            const BlobReferenceRecord& record = records[i];
+            int32 saved;
+            memcpy(&saved, bytes.Data() + record.offset, sizeof(saved));
+
+            // Past the end of the data
+            const int32 outside =
+                static_cast<int32>(header.size) - static_cast<int32>(record.offset);
+            memcpy(bytes.Data() + record.offset, &outside, sizeof(outside));
+            CHECK_FALSE(ValidateBlob(header));
+
+            // Off its alignment, for anything aligned past a byte
+            if (record.alignment > 1)
+            {
+                const int32 misaligned = saved + 1;
+                memcpy(bytes.Data() + record.offset, &misaligned, sizeof(misaligned));
+                CHECK_FALSE(ValidateBlob(header));
+            }
+
+            memcpy(bytes.Data() + record.offset, &saved, sizeof(saved));
+            CHECK(ValidateBlob(header));
+        }
+
+        // An array longer than what's left of the data
+        const Table& table = header.Root<Table>();
+        uint32 huge = 1u << 30;
+        uint8* count = reinterpret_cast<uint8*>(const_cast<BlobArray<Vertex>*>(&table.vertices)) +
+                       sizeof(int32);
+        uint32 saved_count;
+        memcpy(&saved_count, count, sizeof(saved_count));
+        memcpy(count, &huge, sizeof(huge));
+        CHECK_FALSE(ValidateBlob(header));
+        memcpy(count, &saved_count, sizeof(saved_count));
+
+        // A string without its terminator
+        char* title = const_cast<char*>(table.title.Data());
+        title[table.title.Size()] = 'x';
+        const Result<> unterminated = ValidateBlob(header);
+        CHECK_FALSE(unterminated);
+        CHECK(strstr(unterminated.FailureText(), "isn't terminated") != nullptr);
+    }
+}
@@ -0,0 +1,127 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Frustum culling of 100k spheres and boxes: one Intersects call per object against the batched
+// kernels at every SIMD level this CPU runs.
+
+#include "include/rsbl-bounds.h"
+#include "include/rsbl-dynamic-array.h"
+#include "rsbl-wide-kernels.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint32 kObjectCount = 100'000;
+constexpr uint32 kRepeats = 100;
+
+// Stop the optimizer from folding the loops away
+volatile uint64 s_sink = 0;
+
+template <typename F>
+void Time(const char* name, F&& f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32 repeat = 0; repeat < kRepeats; ++repeat)
+    {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double us = std::chrono::duration<double, std::micro>(end - start).count() / kRepeats;
+    printf("  %-40s %8.1f us  (%5.2f ns/object)\n", name, us, us * 1000.0 / kObjectCount);
+}
+} // namespace
+
+int main()
+{
+    // Objects scattered around a camera at the origin looking down +z, a bit under half visible
+    DynamicArray<float> xs;
+    DynamicArray<float> ys;
+    DynamicArray<float> zs;
+    DynamicArray<float> radii;
+    uint64 state = 1;
+    auto next = [&state]() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<float>(state >> 40) / static_cast<float>(1 << 24);
+    };
+    for (uint32 i = 0; i < kObjectCount; ++i)
+    {
+        xs.PushBack(next() * 400.0f - 200.0f);
+        ys.PushBack(next() * 200.0f - 100.0f);
+        zs.PushBack(next() * 400.0f - 100.0f);
+        radii.PushBack(next() * 4.0f);
+    }
+
+    // 90 degree vertical fov, aspect 16:9, depth 0 to 1
+    const float near_z = 0.1f;
+    const float far_z = 250.0f;
+    const float z_scale = far_z / (far_z - near_z);
+    const simd::float4x4 projection(simd::float4(9.0f / 16.0f, 0.0f, 0.0f, 0.0f),
+                                    simd::float4(0.0f, 1.0f, 0.0f, 0.0f),
+                                    simd::float4(0.0f, 0.0f, z_scale, 1.0f),
+                                    simd::float4(0.0f, 0.0f, -near_z * z_scale, 0.0f));
+    const Frustum frustum = FrustumFromViewProjection(projection);
+
+    DynamicBitSet visible;
+    Time("Intersects(Sphere) loop", [&]() {
+        uint64 count = 0;
+        for (uint32 i = 0; i < kObjectCount; ++i)
+        {
+            count += Intersects(frustum, Sphere{float3(xs[i], ys[i], zs[i]), radii[i]}) ? 1 : 0;
+        }
+        s_sink = count;
+    });
+
+    Time("CullSpheres dispatched", [&]() {
+        CullSpheres(frustum, xs, ys, zs, radii, visible);
+        s_sink = visible.Words()[0];
+    });
+    printf("  %llu of %u spheres visible\n", static_cast<unsigned long long>(visible.Count()),
+           kObjectCount);
+
+    Time("CullAabbs dispatched", [&]() {
+        CullAabbs(frustum, xs, ys, zs, radii, radii, radii, visible);
+        s_sink = visible.Words()[0];
+    });
+
+    float planes[Frustum::kPlaneCount * 4];
+    for (uint32 i = 0; i < Frustum::kPlaneCount; ++i)
+    {
+        planes[i * 4 + 0] = frustum.planes[i].normal.x;
+        planes[i * 4 + 1] = frustum.planes[i].normal.y;
+        planes[i * 4 + 2] = frustum.planes[i].normal.z;
+        planes[i * 4 + 3] = frustum.planes[i].distance;
+    }
+    for (uint32 level = 0; level < static_cast<uint32>(SimdLevel::Count); ++level)
+    {
+        const Internal::WideKernels* kernels =
+            Internal::GetWideKernels(static_cast<SimdLevel>(level));
+        if (kernels == nullptr)
+        {
+            continue;
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "CullSpheres %s, %u lanes", SimdLevelName(kernels->level),
+                 kernels->width);
+        Time(name, [&]() {
+            kernels->cullSpheres(planes, xs.Data(), ys.Data(), zs.Data(), radii.Data(),
+                                 kObjectCount, visible.Words());
+            s_sink = visible.Words()[0];
+        });
+
+        snprintf(name, sizeof(name), "CullAabbs %s, %u lanes", SimdLevelName(kernels->level),
+                 kernels->width);
+        Time(name, [&]() {
+            kernels->cullAabbs(planes, xs.Data(), ys.Data(), zs.Data(), radii.Data(),
+                               radii.Data(), radii.Data(), kObjectCount, visible.Words());
+            s_sink = visible.Words()[0];
+        });
+    }
+
+    return 0;
+}
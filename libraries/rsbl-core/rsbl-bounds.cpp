@@ -0,0 +1,183 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-bounds.h"
+
+#include "include/rsbl-assert.h"
+#include "rsbl-wide-kernels.h"
+
+#include <cfloat>
+
+namespace rsbl
+{
+
+namespace
+{
+// Plane as (normal, distance) in one register
+simd::float4 LoadPlane(const Plane& plane)
+{
+    return simd::Load(plane.normal, plane.distance);
+}
+
+// Normal and distance scaled so the normal is unit length
+Plane NormalizePlane(simd::float4 plane)
+{
+    const float length = simd::Length3(plane);
+    if (length < 1e-12f)
+    {
+        // Plane at infinity, nothing is on the wrong side of it
+        return Plane{float3(0.0f), 1.0f};
+    }
+
+    const simd::float4 normalized = plane / length;
+    return Plane{simd::ToFloat3(normalized), normalized.W()};
+}
+
+// 6 planes of (normal xyz, distance), the layout the wide kernels take
+void PackPlanes(const Frustum& frustum, float* planes)
+{
+    for (uint32 i = 0; i < Frustum::kPlaneCount; ++i)
+    {
+        const Plane& plane = frustum.planes[i];
+        planes[i * 4 + 0] = plane.normal.x;
+        planes[i * 4 + 1] = plane.normal.y;
+        planes[i * 4 + 2] = plane.normal.z;
+        planes[i * 4 + 3] = plane.distance;
+    }
+}
+} // namespace
+
+Aabb EmptyAabb()
+{
+    return Aabb{float3(FLT_MAX), float3(-FLT_MAX)};
+}
+
+Aabb AabbFromPoints(ArrayView<const float3> points)
+{
+    if (points.Size() == 0)
+    {
+        return EmptyAabb();
+    }
+
+    simd::float4 min = simd::Load(points[0]);
+    simd::float4 max = min;
+    for (uint64 i = 1; i < points.Size(); ++i)
+    {
+        const simd::float4 point = simd::Load(points[i]);
+        min = simd::Min(min, point);
+        max = simd::Max(max, point);
+    }
+    return Aabb{simd::ToFloat3(min), simd::ToFloat3(max)};
+}
+
+Aabb TransformAabb(const Aabb& box, const simd::float4x4& m)
+{
+    // Arvo: the center moves as a point, the extents through the absolute 3x3
+    const simd::float4 center = simd::TransformPoint(m, simd::Load(Center(box), 1.0f));
+    const simd::float4 extents = simd::Load(Extents(box));
+
+    simd::float4 new_extents = simd::Abs(m.columns[0]) * simd::SplatX(extents);
+    new_extents = simd::MultiplyAdd(simd::Abs(m.columns[1]), simd::SplatY(extents), new_extents);
+    new_extents = simd::MultiplyAdd(simd::Abs(m.columns[2]), simd::SplatZ(extents), new_extents);
+
+    return Aabb{simd::ToFloat3(center - new_extents), simd::ToFloat3(center + new_extents)};
+}
+
+Sphere SphereFromAabb(const Aabb& box)
+{
+    return Sphere{Center(box), simd::Length3(simd::Load(Extents(box)))};
+}
+
+Frustum FrustumFromViewProjection(const simd::float4x4& viewProjection, ClipDepth depth)
+{
+    // A point is inside when -w <= x <= w, same for y, and 0 <= z <= w (or -w <= z <= w). Each
+    // of those is a plane equation in the rows of the matrix.
+    const simd::float4x4 rows = simd::Transpose(viewProjection);
+    const simd::float4 x = rows.columns[0];
+    const simd::float4 y = rows.columns[1];
+    const simd::float4 z = rows.columns[2];
+    const simd::float4 w = rows.columns[3];
+
+    Frustum frustum;
+    frustum.planes[Frustum::kLeft] = NormalizePlane(w + x);
+    frustum.planes[Frustum::kRight] = NormalizePlane(w - x);
+    frustum.planes[Frustum::kBottom] = NormalizePlane(w + y);
+    frustum.planes[Frustum::kTop] = NormalizePlane(w - y);
+    frustum.planes[Frustum::kNear] = NormalizePlane(depth == ClipDepth::ZeroToOne ? z : w + z);
+    frustum.planes[Frustum::kFar] = NormalizePlane(w - z);
+    return frustum;
+}
+
+bool Intersects(const Frustum& frustum, const Sphere& sphere)
+{
+    const simd::float4 center = simd::Load(sphere.center, 1.0f);
+    for (const Plane& plane : frustum.planes)
+    {
+        if (simd::Dot4(LoadPlane(plane), center) < -sphere.radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Intersects(const Frustum& frustum, const Aabb& box)
+{
+    const simd::float4 center = simd::Load(Center(box), 1.0f);
+    const simd::float4 extents = simd::Load(Extents(box));
+    for (const Plane& plane : frustum.planes)
+    {
+        const simd::float4 equation = LoadPlane(plane);
+        // Distance from the center to the box corner furthest along the normal
+        const float reach = simd::Dot3(simd::Abs(equation), extents);
+        if (simd::Dot4(equation, center) < -reach)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CullSpheres(const Frustum& frustum, ArrayView<const float> centerXs,
+                 ArrayView<const float> centerYs, ArrayView<const float> centerZs,
+                 ArrayView<const float> radii, DynamicBitSet& visible)
+{
+    const uint64 count = centerXs.Size();
+    rsblAssert(centerYs.Size() == count && centerZs.Size() == count && radii.Size() == count);
+
+    visible.Resize(count);
+    if (count == 0)
+    {
+        return;
+    }
+
+    float planes[Frustum::kPlaneCount * 4];
+    PackPlanes(frustum, planes);
+    Internal::GetWideKernels().cullSpheres(planes, centerXs.Data(), centerYs.Data(),
+                                           centerZs.Data(), radii.Data(), count,
+                                           visible.Words());
+}
+
+void CullAabbs(const Frustum& frustum, ArrayView<const float> centerXs,
+               ArrayView<const float> centerYs, ArrayView<const float> centerZs,
+               ArrayView<const float> extentXs, ArrayView<const float> extentYs,
+               ArrayView<const float> extentZs, DynamicBitSet& visible)
+{
+    const uint64 count = centerXs.Size();
+    rsblAssert(centerYs.Size() == count && centerZs.Size() == count);
+    rsblAssert(extentXs.Size() == count && extentYs.Size() == count && extentZs.Size() == count);
+
+    visible.Resize(count);
+    if (count == 0)
+    {
+        return;
+    }
+
+    float planes[Frustum::kPlaneCount * 4];
+    PackPlanes(frustum, planes);
+    Internal::GetWideKernels().cullAabbs(planes, centerXs.Data(), centerYs.Data(),
+                                         centerZs.Data(), extentXs.Data(), extentYs.Data(),
+                                         extentZs.Data(), count, visible.Words());
+}
+
+} // namespace rsbl
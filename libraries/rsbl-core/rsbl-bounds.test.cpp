@@ -0,0 +1,276 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-bounds.h"
+#include "include/rsbl-dynamic-array.h"
+#include "rsbl-wide-kernels.h"
+
+using namespace rsbl;
+
+namespace
+{
+// Left-handed perspective looking down +z, 90 degree vertical fov, aspect 2
+simd::float4x4 MakePerspective(float nearZ, float farZ, ClipDepth depth)
+{
+    const float aspect = 2.0f;
+    float z_scale = farZ / (farZ - nearZ);
+    float z_offset = -nearZ * farZ / (farZ - nearZ);
+    if (depth == ClipDepth::MinusOneToOne)
+    {
+        z_scale = (farZ + nearZ) / (farZ - nearZ);
+        z_offset = -2.0f * nearZ * farZ / (farZ - nearZ);
+    }
+    return simd::float4x4(simd::float4(1.0f / aspect, 0.0f, 0.0f, 0.0f),
+                          simd::float4(0.0f, 1.0f, 0.0f, 0.0f),
+                          simd::float4(0.0f, 0.0f, z_scale, 1.0f),
+                          simd::float4(0.0f, 0.0f, z_offset, 0.0f));
+}
+
+void CheckPlane(const Plane& plane, float nx, float ny, float nz, float distance)
+{
+    CHECK(plane.normal.x == doctest::Approx(nx));
+    CHECK(plane.normal.y == doctest::Approx(ny));
+    CHECK(plane.normal.z == doctest::Approx(nz));
+    CHECK(plane.distance == doctest::Approx(distance));
+}
+
+// Deterministic scatter of objects around the frustum, some inside, some out, some straddling
+struct TestObjects
+{
+    DynamicArray<float> xs;
+    DynamicArray<float> ys;
+    DynamicArray<float> zs;
+    DynamicArray<float> sizes;
+
+    explicit TestObjects(uint32 count)
+    {
+        uint64 state = 7;
+        auto next = [&state]() {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<float>(state >> 40) / static_cast<float>(1 << 24);
+        };
+        for (uint32 i = 0; i < count; ++i)
+        {
+            xs.PushBack(next() * 200.0f - 100.0f);
+            ys.PushBack(next() * 100.0f - 50.0f);
+            zs.PushBack(next() * 140.0f - 20.0f);
+            sizes.PushBack(next() * 5.0f);
+        }
+    }
+};
+} // namespace
+
+TEST_SUITE("rsbl::Aabb")
+{
+    TEST_CASE("From points and merge")
+    {
+        const float3 points[] = {float3(1.0f, -2.0f, 3.0f), float3(-1.0f, 5.0f, 0.0f),
+                                 float3(0.0f, 0.0f, 7.0f)};
+        const Aabb box = AabbFromPoints(points);
+        CHECK(box.min.x == -1.0f);
+        CHECK(box.min.y == -2.0f);
+        CHECK(box.min.z == 0.0f);
+        CHECK(box.max.x == 1.0f);
+        CHECK(box.max.y == 5.0f);
+        CHECK(box.max.z == 7.0f);
+
+        const float3 center = Center(box);
+        const float3 extents = Extents(box);
+        CHECK(center.y == 1.5f);
+        CHECK(extents.z == 3.5f);
+
+        // Empty boxes don't contribute
+        const Aabb empty = AabbFromPoints(ArrayView<const float3>());
+        CHECK(empty.min.x > empty.max.x);
+        const Aabb merged = Merge(empty, box);
+        CHECK(merged.min.y == box.min.y);
+        CHECK(merged.max.z == box.max.z);
+
+        const Aabb other{float3(-5.0f, 0.0f, 0.0f), float3(0.0f, 10.0f, 1.0f)};
+        const Aabb both = Merge(box, other);
+        CHECK(both.min.x == -5.0f);
+        CHECK(both.max.y == 10.0f);
+        CHECK(both.max.z == 7.0f);
+    }
+
+    TEST_CASE("Transform")
+    {
+        const Aabb box{float3(-1.0f, -2.0f, -3.0f), float3(1.0f, 2.0f, 3.0f)};
+
+        // 90 degrees around z swaps the x and y extents
+        const simd::float4x4 m = simd::ComposeTrs(
+            simd::float4(10.0f, 0.0f, 0.0f, 0.0f),
+            simd::QuatFromAxisAngle(simd::float4(0.0f, 0.0f, 1.0f, 0.0f), 1.5707963f),
+            simd::float4(1.0f));
+        const Aabb moved = TransformAabb(box, m);
+        CHECK(moved.min.x == doctest::Approx(8.0f));
+        CHECK(moved.max.x == doctest::Approx(12.0f));
+        CHECK(moved.min.y == doctest::Approx(-1.0f));
+        CHECK(moved.max.y == doctest::Approx(1.0f));
+        CHECK(moved.max.z == doctest::Approx(3.0f));
+
+        const Sphere sphere = SphereFromAabb(box);
+        CHECK(sphere.center.x == 0.0f);
+        CHECK(sphere.radius == doctest::Approx(sqrtf(14.0f)));
+    }
+}
+
+TEST_SUITE("rsbl::Frustum")
+{
+    TEST_CASE("Planes from a perspective matrix")
+    {
+        for (ClipDepth depth : {ClipDepth::ZeroToOne, ClipDepth::MinusOneToOne})
+        {
+            CAPTURE(static_cast<int>(depth));
+            const Frustum frustum = FrustumFromViewProjection(MakePerspective(1.0f, 100.0f, depth),
+                                                              depth);
+
+            // 90 degree fov, so the side planes are at 45 degrees (60-ish for the wide x)
+            const float s = sqrtf(0.5f);
+            CheckPlane(frustum.planes[Frustum::kBottom], 0.0f, s, s, 0.0f);
+            CheckPlane(frustum.planes[Frustum::kTop], 0.0f, -s, s, 0.0f);
+            CheckPlane(frustum.planes[Frustum::kNear], 0.0f, 0.0f, 1.0f, -1.0f);
+            CheckPlane(frustum.planes[Frustum::kFar], 0.0f, 0.0f, -1.0f, 100.0f);
+
+            const Plane& left = frustum.planes[Frustum::kLeft];
+            CHECK(left.normal.x > 0.0f);
+            CHECK(left.normal.y == 0.0f);
+            CHECK(left.distance == doctest::Approx(0.0f));
+        }
+    }
+
+    TEST_CASE("Infinite far plane accepts everything")
+    {
+        // Limit of MakePerspective as far goes to infinity
+        const simd::float4x4 infinite(simd::float4(0.5f, 0.0f, 0.0f, 0.0f),
+                                      simd::float4(0.0f, 1.0f, 0.0f, 0.0f),
+                                      simd::float4(0.0f, 0.0f, 1.0f, 1.0f),
+                                      simd::float4(0.0f, 0.0f, -1.0f, 0.0f));
+        const Frustum frustum = FrustumFromViewProjection(infinite);
+        CheckPlane(frustum.planes[Frustum::kFar], 0.0f, 0.0f, 0.0f, 1.0f);
+        CHECK(Intersects(frustum, Sphere{float3(0.0f, 0.0f, 1e9f), 1.0f}));
+    }
+
+    TEST_CASE("Sphere and box tests")
+    {
+        const Frustum frustum =
+            FrustumFromViewProjection(MakePerspective(1.0f, 100.0f, ClipDepth::ZeroToOne));
+
+        CHECK(Intersects(frustum, Sphere{float3(0.0f, 0.0f, 50.0f), 1.0f}));
+        // Behind the camera, past the far plane, off to the side
+        CHECK_FALSE(Intersects(frustum, Sphere{float3(0.0f, 0.0f, -5.0f), 1.0f}));
+        CHECK_FALSE(Intersects(frustum, Sphere{float3(0.0f, 0.0f, 110.0f), 1.0f}));
+        CHECK_FALSE(Intersects(frustum, Sphere{float3(0.0f, 20.0f, 10.0f), 1.0f}));
+        // Center outside, but it reaches back in
+        CHECK(Intersects(frustum, Sphere{float3(0.0f, 0.0f, 101.0f), 2.0f}));
+
+        CHECK(Intersects(frustum, Aabb{float3(-1.0f, -1.0f, 10.0f), float3(1.0f, 1.0f, 12.0f)}));
+        CHECK_FALSE(
+            Intersects(frustum, Aabb{float3(-1.0f, -1.0f, -4.0f), float3(1.0f, 1.0f, -2.0f)}));
+        CHECK_FALSE(
+            Intersects(frustum, Aabb{float3(-1.0f, 20.0f, 5.0f), float3(1.0f, 22.0f, 6.0f)}));
+        // Straddles the near plane
+        CHECK(Intersects(frustum, Aabb{float3(-1.0f, -1.0f, -1.0f), float3(1.0f, 1.0f, 2.0f)}));
+    }
+}
+
+TEST_SUITE("rsbl frustum culling")
+{
+    TEST_CASE("CullSpheres and CullAabbs match the single tests")
+    {
+        const Frustum frustum =
+            FrustumFromViewProjection(MakePerspective(1.0f, 100.0f, ClipDepth::ZeroToOne));
+
+        // Not a multiple of 64, so the last word is partial
+        constexpr uint32 kCount = 1000;
+        const TestObjects objects(kCount);
+
+        DynamicBitSet spheres_visible;
+        CullSpheres(frustum, objects.xs, objects.ys, objects.zs, objects.sizes, spheres_visible);
+        DynamicBitSet boxes_visible;
+        CullAabbs(frustum, objects.xs, objects.ys, objects.zs, objects.sizes, objects.sizes,
+                  objects.sizes, boxes_visible);
+        REQUIRE(spheres_visible.Size() == kCount);
+        REQUIRE(boxes_visible.Size() == kCount);
+
+        uint64 expected_spheres = 0;
+        uint64 expected_boxes = 0;
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            const float3 center(objects.xs[i], objects.ys[i], objects.zs[i]);
+            const float size = objects.sizes[i];
+            const bool sphere = Intersects(frustum, Sphere{center, size});
+            const float3 min(center.x - size, center.y - size, center.z - size);
+            const float3 max(center.x + size, center.y + size, center.z + size);
+            const bool box = Intersects(frustum, Aabb{min, max});
+
+            CHECK(spheres_visible.Test(i) == sphere);
+            CHECK(boxes_visible.Test(i) == box);
+            expected_spheres += sphere ? 1 : 0;
+            expected_boxes += box ? 1 : 0;
+        }
+
+        // The scatter is meant to land on both sides, and tail bits stay clear
+        CHECK(expected_spheres > 0);
+        CHECK(expected_spheres < kCount);
+        CHECK(spheres_visible.Count() == expected_spheres);
+        CHECK(boxes_visible.Count() == expected_boxes);
+
+        // Reusing the bit set with fewer objects resizes it
+        CullSpheres(frustum, ArrayView<const float>(objects.xs.Data(), 10),
+                    ArrayView<const float>(objects.ys.Data(), 10),
+                    ArrayView<const float>(objects.zs.Data(), 10),
+                    ArrayView<const float>(objects.sizes.Data(), 10), spheres_visible);
+        CHECK(spheres_visible.Size() == 10);
+    }
+
+    TEST_CASE("Every SIMD level gives the same bits")
+    {
+        const Frustum frustum =
+            FrustumFromViewProjection(MakePerspective(1.0f, 100.0f, ClipDepth::ZeroToOne));
+        constexpr uint32 kCount = 301;
+        const TestObjects objects(kCount);
+
+        DynamicBitSet expected_spheres;
+        DynamicBitSet expected_boxes;
+        CullSpheres(frustum, objects.xs, objects.ys, objects.zs, objects.sizes, expected_spheres);
+        CullAabbs(frustum, objects.xs, objects.ys, objects.zs, objects.sizes, objects.sizes,
+                  objects.sizes, expected_boxes);
+
+        float planes[Frustum::kPlaneCount * 4];
+        for (uint32 i = 0; i < Frustum::kPlaneCount; ++i)
+        {
+            planes[i * 4 + 0] = frustum.planes[i].normal.x;
+            planes[i * 4 + 1] = frustum.planes[i].normal.y;
+            planes[i * 4 + 2] = frustum.planes[i].normal.z;
+            planes[i * 4 + 3] = frustum.planes[i].distance;
+        }
+
+        for (uint32 level = 0; level < static_cast<uint32>(SimdLevel::Count); ++level)
+        {
+            const Internal::WideKernels* kernels =
+                Internal::GetWideKernels(static_cast<SimdLevel>(level));
+            if (kernels == nullptr)
+            {
+                continue;
+            }
+            CAPTURE(SimdLevelName(kernels->level));
+
+            // Garbage in the words, every one of them gets overwritten
+            DynamicBitSet visible(kCount, true);
+            visible.Words()[visible.WordCount() - 1] = ~uint64(0);
+            kernels->cullSpheres(planes, objects.xs.Data(), objects.ys.Data(), objects.zs.Data(),
+                                 objects.sizes.Data(), kCount, visible.Words());
+            CHECK(visible == expected_spheres);
+
+            visible.SetAll();
+            kernels->cullAabbs(planes, objects.xs.Data(), objects.ys.Data(), objects.zs.Data(),
+                               objects.sizes.Data(), objects.sizes.Data(), objects.sizes.Data(),
+                               kCount, visible.Words());
+            CHECK(visible == expected_boxes);
+        }
+    }
+}
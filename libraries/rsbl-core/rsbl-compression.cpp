@@ -0,0 +1,357 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-compression.h"
+
+#include "include/rsbl-assert.h"
+#include "include/rsbl-dynamic-array.h"
+
+#include <cstring>
+
+// A block is a run of sequences, each a token byte, literals, a 2 byte offset back into the
+// output and a match length. The token's high nibble is the literal count and the low nibble the
+// match length minus 4, with 15 meaning more length bytes follow (each adding up to 255). The
+// last sequence is literals only. The format requires the last 5 bytes to be literals and the
+// last match to start at least 12 bytes from the end, which lets real decoders copy in 8 byte
+// steps.
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint64 kMinMatch = 4;
+constexpr uint64 kMaxOffset = 65535;
+constexpr uint64 kLastLiterals = 5;
+constexpr uint64 kMatchStartLimit = 12;
+
+uint32 Read32(const uint8* data)
+{
+    uint32 value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint32 HashSequence(uint32 sequence, uint32 bits)
+{
+    return (sequence * 2654435761u) >> (32 - bits);
+}
+
+uint8* WriteLength(uint8* out, uint64 length)
+{
+    for (; length >= 255; length -= 255)
+    {
+        *out++ = 255;
+    }
+    *out++ = static_cast<uint8>(length);
+    return out;
+}
+
+// A sequence, match_length 0 for the last one
+uint8* WriteSequence(uint8* out,
+                     const uint8* literals,
+                     uint64 literal_count,
+                     uint64 match_length,
+                     uint64 offset)
+{
+    uint8* token = out++;
+    *token = static_cast<uint8>((literal_count < 15 ? literal_count : 15) << 4);
+    if (literal_count >= 15)
+    {
+        out = WriteLength(out, literal_count - 15);
+    }
+    std::memcpy(out, literals, literal_count);
+    out += literal_count;
+
+    if (match_length == 0)
+    {
+        return out;
+    }
+    *out++ = static_cast<uint8>(offset);
+    *out++ = static_cast<uint8>(offset >> 8);
+    const uint64 length_code = match_length - kMinMatch;
+    *token |= static_cast<uint8>(length_code < 15 ? length_code : 15);
+    if (length_code >= 15)
+    {
+        out = WriteLength(out, length_code - 15);
+    }
+    return out;
+}
+
+// Single probe into a table of the last position each hash was seen at
+class FastMatcher
+{
+  public:
+    static constexpr uint32 kHashBits = 12;
+
+    FastMatcher()
+    {
+        std::memset(m_table, 0, sizeof(m_table));
+    }
+
+    // Returns a candidate for the match at pos and remembers pos
+    uint64 Probe(const uint8* src, uint64 pos)
+    {
+        uint32& slot = m_table[HashSequence(Read32(src + pos), kHashBits)];
+        const uint64 candidate = slot;
+        slot = static_cast<uint32>(pos);
+        return candidate;
+    }
+
+  private:
+    uint32 m_table[1u << kHashBits];
+};
+
+// Every position goes into a hash chain, searched up to kSearchDepth links back for the longest
+// match, like LZ4's HC mode
+class ChainMatcher
+{
+  public:
+    static constexpr uint32 kHashBits = 16;
+    static constexpr uint32 kSearchDepth = 64;
+    // Chain links are distances, which never need to reach past kMaxOffset
+    static constexpr uint64 kWindowMask = 0xFFFF;
+
+    ChainMatcher()
+    {
+        m_head.Resize(1u << kHashBits);
+        m_chain.Resize(kWindowMask + 1);
+        std::memset(m_head.Data(), 0, m_head.Size() * sizeof(uint32));
+    }
+
+    // Longest match for pos among earlier positions, inserting everything up to pos first.
+    // Returns its length, 0 for none.
+    uint64 Find(const uint8* src, uint64 pos, uint64 match_end, uint64& match_position)
+    {
+        for (; m_inserted <= pos; ++m_inserted)
+        {
+            Insert(src, m_inserted);
+        }
+
+        uint64 best_length = 0;
+        const uint32 sequence = Read32(src + pos);
+        uint64 candidate = pos;
+        for (uint32 depth = 0; depth < kSearchDepth; ++depth)
+        {
+            const uint16 step = m_chain[candidate & kWindowMask];
+            if (step == 0 || step > candidate || pos - (candidate - step) > kMaxOffset)
+            {
+                break;
+            }
+            candidate -= step;
+
+            if (Read32(src + candidate) != sequence ||
+                src[candidate + best_length] != src[pos + best_length])
+            {
+                continue;
+            }
+            uint64 length = kMinMatch;
+            while (pos + length < match_end && src[candidate + length] == src[pos + length])
+            {
+                ++length;
+            }
+            if (length > best_length)
+            {
+                best_length = length;
+                match_position = candidate;
+                if (pos + length == match_end)
+                {
+                    break;
+                }
+            }
+        }
+        return best_length;
+    }
+
+    // Skips over a match, keeping its positions in the chains
+    void Skip(const uint8* src, uint64 end)
+    {
+        for (; m_inserted < end; ++m_inserted)
+        {
+            Insert(src, m_inserted);
+        }
+    }
+
+  private:
+    void Insert(const uint8* src, uint64 pos)
+    {
+        uint32& head = m_head[HashSequence(Read32(src + pos), kHashBits)];
+        const uint64 distance = head == 0 ? 0 : pos + 1 - head;
+        m_chain[pos & kWindowMask] = static_cast<uint16>(distance <= kMaxOffset ? distance : 0);
+        head = static_cast<uint32>(pos + 1);
+    }
+
+    // Last position with each hash plus one, 0 for none yet
+    DynamicArray<uint32> m_head;
+    DynamicArray<uint16> m_chain;
+    uint64 m_inserted = 0;
+};
+} // namespace
+
+uint64 Lz4Compress(ByteView src, MutableByteView dst, CompressionLevel level)
+{
+    rsblAssertMsg(dst.Size() >= Lz4CompressBound(src.Size()), "LZ4 output needs the bound");
+    rsblAssertMsg(src.Size() <= 0x7E000000, "LZ4 blocks are limited to 2 GB");
+
+    const uint8* in = src.Data();
+    const uint64 size = src.Size();
+    uint8* out = dst.Data();
+    uint64 anchor = 0;
+
+    if (size > kMatchStartLimit)
+    {
+        const uint64 match_start_limit = size - kMatchStartLimit;
+        const uint64 match_end = size - kLastLiterals;
+
+        if (level == CompressionLevel::Fast)
+        {
+            FastMatcher matcher;
+            uint64 pos = 0;
+            while (pos < match_start_limit)
+            {
+                uint64 candidate = matcher.Probe(in, pos);
+                if (candidate >= pos || pos - candidate > kMaxOffset ||
+                    Read32(in + candidate) != Read32(in + pos))
+                {
+                    // Step faster through data that isn't matching, like LZ4's acceleration
+                    pos += 1 + ((pos - anchor) >> 6);
+                    continue;
+                }
+
+                uint64 length = kMinMatch;
+                while (pos + length < match_end && in[candidate + length] == in[pos + length])
+                {
+                    ++length;
+                }
+                while (pos > anchor && candidate > 0 && in[pos - 1] == in[candidate - 1])
+                {
+                    --pos;
+                    --candidate;
+                    ++length;
+                }
+
+                out = WriteSequence(out, in + anchor, pos - anchor, length, pos - candidate);
+                pos += length;
+                anchor = pos;
+                if (pos - 2 < match_start_limit)
+                {
+                    matcher.Probe(in, pos - 2);
+                }
+            }
+        }
+        else
+        {
+            ChainMatcher matcher;
+            uint64 pos = 0;
+            while (pos < match_start_limit)
+            {
+                uint64 candidate = 0;
+                const uint64 length = matcher.Find(in, pos, match_end, candidate);
+                if (length < kMinMatch)
+                {
+                    ++pos;
+                    continue;
+                }
+
+                out = WriteSequence(out, in + anchor, pos - anchor, length, pos - candidate);
+                pos += length;
+                anchor = pos;
+                matcher.Skip(in, pos < match_start_limit ? pos : match_start_limit);
+            }
+        }
+    }
+
+    out = WriteSequence(out, in + anchor, size - anchor, 0, 0);
+    return static_cast<uint64>(out - dst.Data());
+}
+
+Result<uint64> Lz4Decompress(ByteView src, MutableByteView dst)
+{
+    const uint8* in = src.Data();
+    const uint8* const in_end = in + src.Size();
+    uint8* out = dst.Data();
+    uint8* const out_end = out + dst.Size();
+
+    // Lengths carry on in bytes of 255 until a smaller one
+    auto read_length = [&](uint64& length) {
+        uint8 byte = 255;
+        while (byte == 255)
+        {
+            if (in == in_end)
+            {
+                return false;
+            }
+            byte = *in++;
+            length += byte;
+        }
+        return true;
+    };
+
+    for (;;)
+    {
+        if (in == in_end)
+        {
+            return {ErrorCategory::InvalidArgument, "LZ4 block ends mid-sequence"};
+        }
+        const uint8 token = *in++;
+
+        uint64 literal_count = token >> 4;
+        if (literal_count == 15 && !read_length(literal_count))
+        {
+            return {ErrorCategory::InvalidArgument, "LZ4 block ends mid-length"};
+        }
+        if (literal_count > static_cast<uint64>(in_end - in) ||
+            literal_count > static_cast<uint64>(out_end - out))
+        {
+            return {ErrorCategory::InvalidArgument, "LZ4 literals run past the end"};
+        }
+        std::memcpy(out, in, literal_count);
+        in += literal_count;
+        out += literal_count;
+
+        // The last sequence has no match
+        if (in == in_end)
+        {
+            return static_cast<uint64>(out - dst.Data());
+        }
+
+        if (in_end - in < 2)
+        {
+            return {ErrorCategory::InvalidArgument, "LZ4 block ends mid-offset"};
+        }
+        const uint64 offset = uint64(in[0]) | (uint64(in[1]) << 8);
+        in += 2;
+        if (offset == 0 || offset > static_cast<uint64>(out - dst.Data()))
+        {
+            return {ErrorCategory::InvalidArgument, "LZ4 match offset out of range"};
+        }
+
+        uint64 length = token & 15;
+        if (length == 15 && !read_length(length))
+        {
+            return {ErrorCategory::InvalidArgument, "LZ4 block ends mid-length"};
+        }
+        length += kMinMatch;
+        if (length > static_cast<uint64>(out_end - out))
+        {
+            return {ErrorCategory::InvalidArgument, "LZ4 match runs past the end"};
+        }
+
+        const uint8* match = out - offset;
+        if (offset >= length)
+        {
+            std::memcpy(out, match, length);
+            out += length;
+        }
+        else
+        {
+            // Overlapping, a short offset repeats the bytes just written
+            for (uint64 i = 0; i < length; ++i)
+            {
+                *out++ = match[i];
+            }
+        }
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,266 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-compression.h"
+#include "include/rsbl-dynamic-array.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+// Compresses at both levels, checks both come back intact, returns the High size
+uint64 RoundTrip(const DynamicArray<uint8>& data)
+{
+    DynamicArray<uint8> compressed;
+    compressed.Resize(Lz4CompressBound(data.Size()));
+    DynamicArray<uint8> decompressed;
+    decompressed.Resize(data.Size());
+
+    uint64 high_size = 0;
+    for (CompressionLevel level : {CompressionLevel::Fast, CompressionLevel::High})
+    {
+        const uint64 size = Lz4Compress(ByteView(data), MutableByteView(compressed), level);
+        REQUIRE(size <= compressed.Size());
+        Result<uint64> result =
+            Lz4Decompress(ByteView(compressed.Data(), size), MutableByteView(decompressed));
+        REQUIRE(result);
+        REQUIRE(result.Value() == data.Size());
+        CHECK(std::memcmp(decompressed.Data(), data.Data(), data.Size()) == 0);
+        high_size = size;
+    }
+    return high_size;
+}
+
+// Text-like data, words picked from a small vocabulary
+DynamicArray<uint8> MakeText(uint64 size)
+{
+    const char* words[] = {"vertex ", "index ", "buffer ", "texture ", "mesh ", "the ", "a "};
+    DynamicArray<uint8> data;
+    uint32 state = 12345;
+    while (data.Size() < size)
+    {
+        state = state * 1664525u + 1013904223u;
+        const char* word = words[(state >> 16) % 7];
+        for (const char* c = word; *c != '\0' && data.Size() < size; ++c)
+        {
+            data.PushBack(static_cast<uint8>(*c));
+        }
+    }
+    return data;
+}
+} // namespace
+
+TEST_SUITE("rsbl::Lz4")
+{
+    TEST_CASE("Round trips")
+    {
+        // Sizes around the minimum match and end of block limits
+        for (uint64 size : {0ull, 1ull, 4ull, 12ull, 13ull, 17ull, 100ull, 70000ull})
+        {
+            RoundTrip(MakeText(size));
+        }
+
+        // Incompressible
+        DynamicArray<uint8> noise;
+        uint64 state = 1;
+        for (uint32 i = 0; i < 50000; ++i)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            noise.PushBack(static_cast<uint8>(state >> 56));
+        }
+        CHECK(RoundTrip(noise) <= Lz4CompressBound(noise.Size()));
+
+        // Long runs, matches overlapping themselves
+        DynamicArray<uint8> runs;
+        runs.Resize(100000);
+        for (uint64 i = 0; i < runs.Size(); ++i)
+        {
+            runs[i] = static_cast<uint8>((i / 1000) % 3);
+        }
+        CHECK(RoundTrip(runs) < 2000);
+    }
+
+    TEST_CASE("High compresses smaller than Fast")
+    {
+        const DynamicArray<uint8> text = MakeText(256 * 1024);
+        DynamicArray<uint8> compressed;
+        compressed.Resize(Lz4CompressBound(text.Size()));
+        const uint64 fast =
+            Lz4Compress(ByteView(text), MutableByteView(compressed), CompressionLevel::Fast);
+        const uint64 high =
+            Lz4Compress(ByteView(text), MutableByteView(compressed), CompressionLevel::High);
+        CHECK(fast < text.Size() / 2);
+        CHECK(high < fast);
+    }
+
+    TEST_CASE("Reads a block built by hand")
+    {
+        // "abc", then 18 bytes from 3 back (length code 14), then "-xyz-xyz" as the final
+        // literals
+        const uint8 block[] = {
+            0x3E, 'a', 'b', 'c', 0x03, 0x00, 0x80, '-', 'x', 'y', 'z', '-', 'x', 'y', 'z'};
+        char out[64] = {};
+        Result<uint64> size = Lz4Decompress(ByteView(block, sizeof(block)),
+                                            AsWritableBytes(out, sizeof(out)));
+        REQUIRE(size);
+        CHECK(size.Value() == 29);
+        CHECK(std::memcmp(out, "abcabcabcabcabcabcabc-xyz-xyz", 29) == 0);
+    }
+
+    TEST_CASE("Malformed blocks fail without overrunning")
+    {
+        const DynamicArray<uint8> text = MakeText(5000);
+        DynamicArray<uint8> compressed;
+        compressed.Resize(Lz4CompressBound(text.Size()));
+        const uint64 size = Lz4Compress(ByteView(text), MutableByteView(compressed));
+
+        DynamicArray<uint8> out;
+        out.Resize(text.Size());
+
+        // Too small an output
+        CHECK_FALSE(Lz4Decompress(ByteView(compressed.Data(), size),
+                                  MutableByteView(out.Data(), out.Size() - 1)));
+
+        // Cut short
+        CHECK_FALSE(Lz4Decompress(ByteView(compressed.Data(), size / 2), MutableByteView(out)));
+        CHECK_FALSE(Lz4Decompress(ByteView(), MutableByteView(out)));
+
+        // An offset reaching before the start
+        const uint8 bad_offset[] = {0x10, 'a', 0x05, 0x00, 0x00};
+        CHECK_FALSE(Lz4Decompress(ByteView(bad_offset, sizeof(bad_offset)), MutableByteView(out)));
+
+        // Corrupted bytes anywhere either fail or decode to something, never crash
+        for (uint64 i = 0; i < size; i += 7)
+        {
+            DynamicArray<uint8> corrupt = compressed;
+            corrupt[i] ^= 0x5A;
+            (void)Lz4Decompress(ByteView(corrupt.Data(), size), MutableByteView(out));
+        }
+    }
+}
+
+TEST_SUITE("rsbl::Inflate")
+{
+    TEST_CASE("Fixed and stored blocks")
+    {
+        // zlib at level 9 picks the fixed codes for a short string, level 0 stores it
+        const uint8 fixed[] = {
+            0x78, 0xDA, 0xF3, 0x48, 0xCD, 0xC9, 0xC9, 0xD7, 0x51, 0xC8, 0x40, 0xA2,
+            0x14, 0x15, 0x5C, 0x52, 0xD3, 0x72, 0x12, 0x4B, 0x52, 0x15, 0x72, 0x53,
+            0xF5, 0x00, 0xB4, 0x11, 0x0A, 0xCB,
+        };
+        char out[64] = {};
+        Result<uint64> size =
+            ZlibDecompress(ByteView(fixed, sizeof(fixed)), AsWritableBytes(out, sizeof(out)));
+        REQUIRE(size);
+        CHECK(size.Value() == 32);
+        CHECK(std::memcmp(out, "Hello, hello, hello! Deflate me.", 32) == 0);
+
+        const uint8 stored[] = {
+            0x78, 0x01, 0x01, 0x06, 0x00, 0xF9, 0xFF, 0x73, 0x74, 0x6F, 0x72, 0x65,
+            0x64, 0x09, 0x3C, 0x02, 0x92,
+        };
+        size = ZlibDecompress(ByteView(stored, sizeof(stored)), AsWritableBytes(out, sizeof(out)));
+        REQUIRE(size);
+        CHECK(size.Value() == 6);
+        CHECK(std::memcmp(out, "stored", 6) == 0);
+
+        // The raw stream inside, without the header and checksum
+        size = InflateDecompress(ByteView(fixed + 2, sizeof(fixed) - 6),
+                                 AsWritableBytes(out, sizeof(out)));
+        REQUIRE(size);
+        CHECK(size.Value() == 32);
+    }
+
+    TEST_CASE("Dynamic blocks")
+    {
+        // zlib.compress at level 9 of the lines below
+        const uint8 compressed[] = {
+            0x78, 0xDA, 0x9D, 0xD6, 0x59, 0x52, 0x03, 0x31, 0x0C, 0x45, 0xD1, 0x7F,
+            0x56, 0xE1, 0x25, 0xC4, 0x83, 0x3C, 0xB0, 0x1B, 0x86, 0x06, 0x02, 0x21,
+            0x0D, 0x81, 0x30, 0xAD, 0x9E, 0x82, 0x7E, 0x5A, 0xC0, 0xF5, 0x77, 0xEA,
+            0x95, 0x65, 0xEB, 0x48, 0x9D, 0xC3, 0xFE, 0xB8, 0x84, 0xDD, 0x65, 0x78,
+            0x7F, 0x58, 0xC2, 0xEB, 0x79, 0x7F, 0xF3, 0x14, 0xAE, 0x4F, 0xEB, 0xE7,
+            0x31, 0xDC, 0xAD, 0x5F, 0xE1, 0xF1, 0xFC, 0xFC, 0xF2, 0x16, 0xD6, 0x8F,
+            0xE5, 0xF4, 0xFF, 0xF3, 0xE1, 0xEA, 0xE7, 0x3B, 0xDC, 0xAE, 0xF7, 0x61,
+            0x77, 0x71, 0xF8, 0x4B, 0x45, 0x96, 0x8A, 0x5B, 0x2A, 0xB1, 0x54, 0xD9,
+            0x52, 0x99, 0xA5, 0xC6, 0x96, 0x2A, 0xB0, 0xC2, 0xBA, 0xC5, 0x8C, 0xC5,
+            0x92, 0x6D, 0xB1, 0xCA, 0x62, 0x59, 0xA7, 0x35, 0xF8, 0x20, 0xBA, 0x5B,
+            0x67, 0xB1, 0xAA, 0x87, 0x1C, 0x2C, 0xD6, 0xD5, 0xB5, 0x08, 0x89, 0x64,
+            0xC5, 0xA0, 0x91, 0xA4, 0x2A, 0x23, 0x55, 0xD2, 0x94, 0x83, 0x4E, 0x5A,
+            0x52, 0x0E, 0x4A, 0xF1, 0x18, 0x94, 0x92, 0xFD, 0x35, 0x21, 0x95, 0xEA,
+            0xE7, 0x41, 0x2B, 0x43, 0x32, 0x23, 0xC4, 0x92, 0xBD, 0x7D, 0x50, 0x4B,
+            0xD3, 0x66, 0x48, 0x50, 0x4B, 0xD4, 0xFD, 0x12, 0xE4, 0x62, 0xAA, 0x33,
+            0x41, 0x2E, 0x43, 0xA3, 0x97, 0x20, 0x97, 0x22, 0x9E, 0x09, 0x72, 0x19,
+            0xBE, 0xFB, 0xA0, 0x97, 0xE2, 0xF7, 0x83, 0x5E, 0x86, 0xD7, 0x09, 0xBD,
+            0x98, 0xF7, 0x0F, 0x7A, 0xE9, 0x8A, 0x41, 0x2E, 0x55, 0x3C, 0x33, 0xE4,
+            0x92, 0x34, 0xED, 0x19, 0x72, 0xE9, 0xAA, 0x33, 0x43, 0x2E, 0xE6, 0x1F,
+            0x21, 0xC8, 0x25, 0x89, 0x75, 0x86, 0x5C, 0xBA, 0x56, 0x7C, 0x86, 0x5C,
+            0xAA, 0x98, 0x65, 0xFA, 0x25, 0xF2, 0x3E, 0x40, 0x2E, 0xD1, 0xCF, 0xA3,
+            0x5C, 0x34, 0x7E, 0x99, 0x7A, 0x51, 0xAE, 0x40, 0x2F, 0x45, 0x7D, 0x2F,
+            0xD0, 0x4B, 0x56, 0xFF, 0x0A, 0xF4, 0x12, 0xFD, 0x3C, 0xE8, 0xC5, 0xAF,
+            0x47, 0xB7, 0x8B, 0xB6, 0x44, 0x81, 0x5C, 0xBA, 0xDA, 0x5E, 0x20, 0x97,
+            0xE6, 0xFF, 0xAE, 0x20, 0x97, 0xE6, 0xE7, 0x41, 0x2E, 0xCD, 0xEF, 0x37,
+            0xE6, 0x72, 0xB6, 0x9B, 0xAB, 0xD3, 0xE2, 0xDC, 0xBB, 0x58, 0x9A, 0xEB,
+            0x83, 0xE5, 0xB9, 0xBE, 0x5B, 0x99, 0x62, 0x66, 0x36, 0xA7, 0xDA, 0xEA,
+            0xDC, 0x14, 0x59, 0x9B, 0x9B, 0x5A, 0xEB, 0x73, 0x5B, 0xC2, 0x06, 0xDE,
+            0x4A, 0xBF, 0x8C, 0xE1, 0x75, 0x9A,
+        };
+        DynamicArray<uint8> expected;
+        char line[128];
+        for (uint32 i = 0; i < 60; ++i)
+        {
+            const int length = std::snprintf(
+                line, sizeof(line), "line %u: the quick brown fox jumps over the lazy dog %u\n",
+                i, i * i % 97);
+            expected.Append(reinterpret_cast<const uint8*>(line), static_cast<uint64>(length));
+        }
+
+        DynamicArray<uint8> out;
+        out.Resize(expected.Size());
+        Result<uint64> size =
+            ZlibDecompress(ByteView(compressed, sizeof(compressed)), MutableByteView(out));
+        REQUIRE(size);
+        CHECK(size.Value() == expected.Size());
+        CHECK(std::memcmp(out.Data(), expected.Data(), expected.Size()) == 0);
+
+        // One byte short of room fails rather than writing past the end
+        CHECK_FALSE(ZlibDecompress(ByteView(compressed, sizeof(compressed)),
+                                   MutableByteView(out.Data(), out.Size() - 1)));
+
+        // A flipped bit in the checksum
+        uint8 bad_checksum[sizeof(compressed)];
+        std::memcpy(bad_checksum, compressed, sizeof(compressed));
+        bad_checksum[sizeof(compressed) - 1] ^= 1;
+        CHECK_FALSE(ZlibDecompress(ByteView(bad_checksum, sizeof(bad_checksum)),
+                                   MutableByteView(out)));
+
+        // Cut short anywhere, or corrupted anywhere, it fails or decodes to something, never
+        // reading or writing out of bounds
+        for (uint64 cut = 0; cut < sizeof(compressed); cut += 5)
+        {
+            CHECK_FALSE(ZlibDecompress(ByteView(compressed, cut), MutableByteView(out)));
+        }
+        for (uint64 i = 2; i < sizeof(compressed); ++i)
+        {
+            uint8 corrupt[sizeof(compressed)];
+            std::memcpy(corrupt, compressed, sizeof(compressed));
+            corrupt[i] ^= 0x24;
+            (void)ZlibDecompress(ByteView(corrupt, sizeof(corrupt)), MutableByteView(out));
+        }
+    }
+
+    TEST_CASE("Not zlib")
+    {
+        const uint8 gzip[] = {0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00};
+        uint8 out[16];
+        CHECK_FALSE(ZlibDecompress(ByteView(gzip, sizeof(gzip)), MutableByteView(out)));
+        CHECK_FALSE(ZlibDecompress(ByteView(), MutableByteView(out)));
+    }
+}
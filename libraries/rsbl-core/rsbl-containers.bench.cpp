@@ -0,0 +1,431 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// rsbl's containers against their std equivalents, to keep them honest: DynamicArray and
+// std::vector growing, resizing and iterating, for a trivial type and for types with their own
+// moves, one of them trivially relocatable so Grow can realloc it; SmallArray below its inline
+// size; FixedArray and std::array; HashMap and SlotMap against std::unordered_map.
+
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-fixed-array.h"
+#include "include/rsbl-hash-map.h"
+#include "include/rsbl-slot-map.h"
+#include "include/rsbl-small-array.h"
+
+#include <rsbl-bench.h>
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint64 kCount = 4096;
+
+// Non-trivial moves and destructor, with nothing behind them to allocate, so only the
+// containers' handling of them is timed
+struct Moved
+{
+    uint64 value = 0;
+    uint64 check = 0;
+
+    Moved() = default;
+    explicit Moved(uint64 v)
+        : value(v)
+        , check(~v)
+    {
+    }
+    Moved(const Moved& other)
+        : value(other.value)
+        , check(other.check)
+    {
+    }
+    Moved(Moved&& other) noexcept
+        : value(other.value)
+        , check(other.check)
+    {
+        other.check = 0;
+    }
+    Moved& operator=(const Moved& other)
+    {
+        value = other.value;
+        check = other.check;
+        return *this;
+    }
+    Moved& operator=(Moved&& other) noexcept
+    {
+        value = other.value;
+        check = other.check;
+        other.check = 0;
+        return *this;
+    }
+    ~Moved()
+    {
+        check = 0;
+    }
+};
+
+// The same, but declared safe to memcpy to a new address
+struct Relocated : Moved
+{
+    using Moved::Moved;
+};
+
+uint64 NextRandom(uint64& state)
+{
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state ^ (state >> 29);
+}
+
+template <typename T>
+T Make(uint64 i)
+{
+    return T(i);
+}
+
+uint64 ValueOf(uint64 value)
+{
+    return value;
+}
+
+uint64 ValueOf(const Moved& moved)
+{
+    return moved.value;
+}
+
+// PushBack from empty, growing as it goes; into reserved space; Resize; iterating; and one
+// Grow of a full array, which for types with moves is a move and destroy per element
+template <typename T>
+void ArraySuite(Bench& bench, const char* section)
+{
+    const BenchConfig perElement = {.items = kCount};
+    bench.Section(section);
+
+    bench.Run("DynamicArray PushBack", [&]() {
+        DynamicArray<T> array;
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            array.PushBack(Make<T>(i));
+        }
+        DoNotOptimize(array.Data());
+    }, perElement);
+    bench.Run("std::vector push_back", [&]() {
+        std::vector<T> array;
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            array.push_back(Make<T>(i));
+        }
+        DoNotOptimize(array.data());
+    }, perElement);
+
+    bench.Run("DynamicArray PushBack reserved", [&]() {
+        DynamicArray<T> array;
+        array.Reserve(kCount);
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            array.PushBack(Make<T>(i));
+        }
+        DoNotOptimize(array.Data());
+    }, perElement);
+    bench.Run("std::vector push_back reserved", [&]() {
+        std::vector<T> array;
+        array.reserve(kCount);
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            array.push_back(Make<T>(i));
+        }
+        DoNotOptimize(array.data());
+    }, perElement);
+
+    bench.Run("DynamicArray Resize", [&]() {
+        DynamicArray<T> array;
+        array.Resize(kCount);
+        DoNotOptimize(array.Data());
+    }, perElement);
+    bench.Run("std::vector resize", [&]() {
+        std::vector<T> array;
+        array.resize(kCount);
+        DoNotOptimize(array.data());
+    }, perElement);
+
+    DynamicArray<T> full;
+    std::vector<T> fullVector;
+    for (uint64 i = 0; i < kCount; ++i)
+    {
+        full.PushBack(Make<T>(i));
+        fullVector.push_back(Make<T>(i));
+    }
+
+    bench.Run("DynamicArray iterate", [&]() {
+        uint64 sum = 0;
+        for (const T& element : full)
+        {
+            sum += ValueOf(element);
+        }
+        DoNotOptimize(sum);
+    }, perElement);
+    bench.Run("std::vector iterate", [&]() {
+        uint64 sum = 0;
+        for (const T& element : fullVector)
+        {
+            sum += ValueOf(element);
+        }
+        DoNotOptimize(sum);
+    }, perElement);
+
+    // Arrays exactly full, rebuilt untimed, so the timed Reserve has to move everything
+    DynamicArray<T> growing;
+    std::vector<T> growingVector;
+    bench.Run("DynamicArray grow", [&]() {
+        growing = DynamicArray<T>();
+        growing.Reserve(kCount);
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            growing.PushBack(Make<T>(i));
+        }
+    }, [&]() {
+        growing.Reserve(kCount * 2);
+        DoNotOptimize(growing.Data());
+    }, perElement);
+    bench.Run("std::vector grow", [&]() {
+        growingVector = std::vector<T>();
+        growingVector.reserve(kCount);
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            growingVector.push_back(Make<T>(i));
+        }
+    }, [&]() {
+        growingVector.reserve(kCount * 2);
+        DoNotOptimize(growingVector.data());
+    }, perElement);
+}
+
+void SmallSuite(Bench& bench)
+{
+    // Below the inline size SmallArray never touches the heap
+    constexpr uint64 kSmall = 12;
+    const BenchConfig perElement = {.items = kSmall};
+    bench.Section("12 uint64, inline");
+
+    bench.Run("SmallArray<16> PushBack", [&]() {
+        SmallArray<uint64, 16> array;
+        for (uint64 i = 0; i < kSmall; ++i)
+        {
+            array.PushBack(i);
+        }
+        DoNotOptimize(array.Data());
+    }, perElement);
+    bench.Run("DynamicArray PushBack", [&]() {
+        DynamicArray<uint64> array;
+        for (uint64 i = 0; i < kSmall; ++i)
+        {
+            array.PushBack(i);
+        }
+        DoNotOptimize(array.Data());
+    }, perElement);
+    bench.Run("std::vector push_back", [&]() {
+        std::vector<uint64> array;
+        for (uint64 i = 0; i < kSmall; ++i)
+        {
+            array.push_back(i);
+        }
+        DoNotOptimize(array.data());
+    }, perElement);
+}
+
+void FixedSuite(Bench& bench)
+{
+    constexpr uint64 kFixed = 64;
+    const BenchConfig perElement = {.items = kFixed};
+    bench.Section("64 float, fixed");
+
+    FixedArray<float, kFixed> fixed;
+    std::array<float, kFixed> stdArray;
+    bench.Run("FixedArray fill and sum", [&]() {
+        fixed.Fill(1.5f);
+        DoNotOptimize(fixed);
+        float sum = 0.0f;
+        for (uint64 i = 0; i < fixed.Size(); ++i)
+        {
+            sum += fixed[i];
+        }
+        DoNotOptimize(sum);
+    }, perElement);
+    bench.Run("std::array fill and sum", [&]() {
+        stdArray.fill(1.5f);
+        DoNotOptimize(stdArray);
+        float sum = 0.0f;
+        for (uint64 i = 0; i < stdArray.size(); ++i)
+        {
+            sum += stdArray[i];
+        }
+        DoNotOptimize(sum);
+    }, perElement);
+}
+
+void MapSuite(Bench& bench)
+{
+    const BenchConfig perKey = {.items = kCount};
+    bench.Section("4096 random uint64 keys");
+
+    DynamicArray<uint64> keys;
+    DynamicArray<uint64> missing;
+    uint64 state = 1;
+    for (uint64 i = 0; i < kCount; ++i)
+    {
+        keys.PushBack(NextRandom(state));
+        missing.PushBack(NextRandom(state));
+    }
+
+    bench.Run("HashMap Insert", [&]() {
+        HashMap<uint64, uint64> map;
+        for (uint64 key : keys)
+        {
+            map.Insert(key, key);
+        }
+        DoNotOptimize(map);
+    }, perKey);
+    bench.Run("std::unordered_map insert", [&]() {
+        std::unordered_map<uint64, uint64> map;
+        for (uint64 key : keys)
+        {
+            map.emplace(key, key);
+        }
+        DoNotOptimize(map);
+    }, perKey);
+
+    HashMap<uint64, uint64> map;
+    std::unordered_map<uint64, uint64> stdMap;
+    for (uint64 key : keys)
+    {
+        map.Insert(key, key);
+        stdMap.emplace(key, key);
+    }
+
+    bench.Run("HashMap Find hit", [&]() {
+        uint64 sum = 0;
+        for (uint64 key : keys)
+        {
+            sum += *map.Find(key);
+        }
+        DoNotOptimize(sum);
+    }, perKey);
+    bench.Run("std::unordered_map find hit", [&]() {
+        uint64 sum = 0;
+        for (uint64 key : keys)
+        {
+            sum += stdMap.find(key)->second;
+        }
+        DoNotOptimize(sum);
+    }, perKey);
+
+    bench.Run("HashMap Find miss", [&]() {
+        uint64 found = 0;
+        for (uint64 key : missing)
+        {
+            found += map.Find(key) != nullptr ? 1 : 0;
+        }
+        DoNotOptimize(found);
+    }, perKey);
+    bench.Run("std::unordered_map find miss", [&]() {
+        uint64 found = 0;
+        for (uint64 key : missing)
+        {
+            found += stdMap.find(key) != stdMap.end() ? 1 : 0;
+        }
+        DoNotOptimize(found);
+    }, perKey);
+}
+
+void SlotSuite(Bench& bench)
+{
+    // What a SlotMap replaces: objects behind ids handed out in order
+    const BenchConfig perObject = {.items = kCount};
+    bench.Section("4096 objects by handle");
+
+    bench.Run("SlotMap Insert", [&]() {
+        SlotMap<uint64> slots;
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            DoNotOptimize(slots.Insert(i));
+        }
+    }, perObject);
+    bench.Run("std::unordered_map insert", [&]() {
+        std::unordered_map<uint32, uint64> objects;
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            objects.emplace(static_cast<uint32>(i), i);
+        }
+        DoNotOptimize(objects);
+    }, perObject);
+
+    SlotMap<uint64> slots;
+    DynamicArray<SlotHandle> handles;
+    std::unordered_map<uint32, uint64> objects;
+    for (uint64 i = 0; i < kCount; ++i)
+    {
+        handles.PushBack(slots.Insert(i));
+        objects.emplace(static_cast<uint32>(i), i);
+    }
+
+    bench.Run("SlotMap Get", [&]() {
+        uint64 sum = 0;
+        for (SlotHandle handle : handles)
+        {
+            sum += *slots.Get(handle);
+        }
+        DoNotOptimize(sum);
+    }, perObject);
+    bench.Run("std::unordered_map find", [&]() {
+        uint64 sum = 0;
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            sum += objects.find(static_cast<uint32>(i))->second;
+        }
+        DoNotOptimize(sum);
+    }, perObject);
+
+    bench.Run("SlotMap iterate", [&]() {
+        uint64 sum = 0;
+        for (uint64 value : slots)
+        {
+            sum += value;
+        }
+        DoNotOptimize(sum);
+    }, perObject);
+    bench.Run("std::unordered_map iterate", [&]() {
+        uint64 sum = 0;
+        for (const auto& object : objects)
+        {
+            sum += object.second;
+        }
+        DoNotOptimize(sum);
+    }, perObject);
+}
+} // namespace
+
+namespace rsbl
+{
+template <>
+struct TriviallyRelocatable<Relocated>
+{
+    static constexpr bool value = true;
+};
+} // namespace rsbl
+
+int main(int argc, char** argv)
+{
+    Bench bench("rsbl-containers", argc, argv);
+
+    ArraySuite<uint64>(bench, "4096 uint64");
+    ArraySuite<Moved>(bench, "4096 with moves");
+    ArraySuite<Relocated>(bench, "4096 with moves, trivially relocatable");
+    SmallSuite(bench);
+    FixedSuite(bench);
+    MapSuite(bench);
+    SlotSuite(bench);
+
+    return bench.Finish();
+}
@@ -0,0 +1,189 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-cpu.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define RSBL_CPU_X64 1
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#else
+    #define RSBL_CPU_X64 0
+#endif
+
+#if defined(_M_ARM64)
+    #include <windows.h>
+#elif defined(__aarch64__) && defined(__APPLE__)
+    #include <sys/sysctl.h>
+#elif defined(__aarch64__) && defined(__linux__)
+    #include <sys/auxv.h>
+#endif
+
+namespace rsbl
+{
+
+namespace
+{
+#if RSBL_CPU_X64
+void CpuId(uint32 leaf, uint32 subleaf, uint32 registers[4])
+{
+    #if defined(_MSC_VER)
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        registers[i] = static_cast<uint32>(values[i]);
+    }
+    #else
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+    #endif
+}
+
+// XCR0, which register states the OS saves on a context switch
+uint64 ReadXcr0()
+{
+    #if defined(_MSC_VER)
+    return _xgetbv(0);
+    #else
+    uint32 eax = 0;
+    uint32 edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64>(edx) << 32) | eax;
+    #endif
+}
+
+bool HasBit(uint32 value, uint32 bit)
+{
+    return (value >> bit) & 1;
+}
+#endif
+
+CpuFeatures DetectCpuFeatures()
+{
+    CpuFeatures features;
+
+#if RSBL_CPU_X64
+    uint32 registers[4] = {};
+    CpuId(0, 0, registers);
+    const uint32 max_leaf = registers[0];
+    // "AuthenticAMD" comes back in ebx, edx, ecx
+    const bool is_amd =
+        registers[1] == 0x68747541 && registers[3] == 0x69746e65 && registers[2] == 0x444d4163;
+
+    CpuId(1, 0, registers);
+    const uint32 eax1 = registers[0];
+    const uint32 ecx1 = registers[2];
+    const uint32 base_family = (eax1 >> 8) & 0xf;
+    const uint32 family = base_family == 0xf ? base_family + ((eax1 >> 20) & 0xff) : base_family;
+    features.sse41 = HasBit(ecx1, 19);
+    features.sse42 = HasBit(ecx1, 20);
+    features.popcnt = HasBit(ecx1, 23);
+
+    // SSE and AVX state (XCR0 bits 1 and 2) for anything using ymm registers
+    const bool os_saves_ymm = HasBit(ecx1, 27) && (ReadXcr0() & 0x6) == 0x6;
+    // Plus opmask and the upper zmm halves (bits 5, 6 and 7)
+    const bool os_saves_zmm = os_saves_ymm && (ReadXcr0() & 0xe0) == 0xe0;
+
+    features.avx = os_saves_ymm && HasBit(ecx1, 28);
+    features.fma = features.avx && HasBit(ecx1, 12);
+    features.f16c = features.avx && HasBit(ecx1, 29);
+
+    if (max_leaf >= 7)
+    {
+        CpuId(7, 0, registers);
+        const uint32 ebx7 = registers[1];
+        features.bmi1 = HasBit(ebx7, 3);
+        features.bmi2 = HasBit(ebx7, 8);
+        // Zen 3 is family 0x19
+        features.slowPdep = features.bmi2 && is_amd && family < 0x19;
+        features.avx2 = features.avx && HasBit(ebx7, 5);
+        features.avx512f = os_saves_zmm && HasBit(ebx7, 16);
+        features.avx512dq = features.avx512f && HasBit(ebx7, 17);
+        features.avx512bw = features.avx512f && HasBit(ebx7, 30);
+        features.avx512vl = features.avx512f && HasBit(ebx7, 31);
+    }
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    // Advanced SIMD is mandatory on ARMv8-A. The optional extensions are only visible to the
+    // kernel, so ask the OS.
+    features.neon = true;
+    #if defined(_M_ARM64)
+    // PF_ARM_V82_DP_INSTRUCTIONS_AVAILABLE, missing from older SDKs
+    features.neonDotProd = IsProcessorFeaturePresent(43) != 0;
+    #elif defined(__APPLE__)
+    int dot_prod = 0;
+    size_t size = sizeof(dot_prod);
+    features.neonDotProd =
+        sysctlbyname("hw.optional.arm.FEAT_DotProd", &dot_prod, &size, nullptr, 0) == 0 &&
+        dot_prod != 0;
+    #elif defined(__linux__)
+    // HWCAP_ASIMDDP
+    features.neonDotProd = (getauxval(AT_HWCAP) & (1ul << 20)) != 0;
+    #endif
+#endif
+
+    return features;
+}
+} // namespace
+
+const CpuFeatures& GetCpuFeatures()
+{
+    static const CpuFeatures s_features = DetectCpuFeatures();
+    return s_features;
+}
+
+const char* SimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Scalar:
+        return "Scalar";
+    case SimdLevel::Sse2:
+        return "SSE2";
+    case SimdLevel::Neon:
+        return "NEON";
+    case SimdLevel::Avx2:
+        return "AVX2";
+    case SimdLevel::Avx512:
+        return "AVX-512";
+    default:
+        return "Unknown";
+    }
+}
+
+bool IsSimdLevelSupported(SimdLevel level)
+{
+    const CpuFeatures& features = GetCpuFeatures();
+    switch (level)
+    {
+    case SimdLevel::Scalar:
+        return true;
+    case SimdLevel::Sse2:
+        // Part of the x64 baseline
+        return RSBL_CPU_X64 != 0;
+    case SimdLevel::Neon:
+        return features.neon;
+    case SimdLevel::Avx2:
+        return features.avx2 && features.fma && features.f16c && features.bmi2;
+    case SimdLevel::Avx512:
+        return features.avx512f && IsSimdLevelSupported(SimdLevel::Avx2);
+    default:
+        return false;
+    }
+}
+
+SimdLevel GetBestSimdLevel()
+{
+    for (uint32 level = static_cast<uint32>(SimdLevel::Count); level-- > 0;)
+    {
+        if (IsSimdLevelSupported(static_cast<SimdLevel>(level)))
+        {
+            return static_cast<SimdLevel>(level);
+        }
+    }
+    return SimdLevel::Scalar;
+}
+
+} // namespace rsbl
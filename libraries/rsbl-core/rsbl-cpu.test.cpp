@@ -0,0 +1,92 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-cpu.h"
+
+using namespace rsbl;
+
+TEST_SUITE("rsbl::CpuFeatures")
+{
+    TEST_CASE("Features are consistent")
+    {
+        const CpuFeatures& features = GetCpuFeatures();
+        CHECK(&features == &GetCpuFeatures());
+
+        // Wider extensions imply the narrower ones they build on
+        if (features.avx2 || features.fma || features.f16c)
+        {
+            CHECK(features.avx);
+        }
+        if (features.slowPdep)
+        {
+            CHECK(features.bmi2);
+        }
+        if (features.avx512dq || features.avx512bw || features.avx512vl)
+        {
+            CHECK(features.avx512f);
+        }
+        if (features.neonDotProd)
+        {
+            CHECK(features.neon);
+        }
+
+#if defined(_M_X64) || defined(__x86_64__)
+        CHECK_FALSE(features.neon);
+#elif defined(_M_ARM64) || defined(__aarch64__)
+        CHECK(features.neon);
+        CHECK_FALSE(features.avx);
+#endif
+    }
+
+    TEST_CASE("SIMD levels")
+    {
+        CHECK(IsSimdLevelSupported(SimdLevel::Scalar));
+        CHECK_FALSE(IsSimdLevelSupported(SimdLevel::Count));
+
+        const SimdLevel best = GetBestSimdLevel();
+        CHECK(IsSimdLevelSupported(best));
+        for (uint32 level = static_cast<uint32>(best) + 1;
+             level < static_cast<uint32>(SimdLevel::Count); ++level)
+        {
+            CHECK_FALSE(IsSimdLevelSupported(static_cast<SimdLevel>(level)));
+        }
+
+#if defined(_M_X64) || defined(__x86_64__)
+        CHECK(IsSimdLevelSupported(SimdLevel::Sse2));
+        const bool has_avx2 = GetCpuFeatures().avx2 && GetCpuFeatures().fma &&
+                              GetCpuFeatures().f16c && GetCpuFeatures().bmi2;
+        CHECK(IsSimdLevelSupported(SimdLevel::Avx2) == has_avx2);
+#endif
+
+        CHECK(SimdLevelName(SimdLevel::Avx2) == doctest::String("AVX2"));
+        CHECK(SimdLevelName(SimdLevel::Count) == doctest::String("Unknown"));
+    }
+
+    TEST_CASE("Variant selection")
+    {
+        using Variant = uint32 (*)();
+        const Variant scalar = []() -> uint32 { return 0; };
+        const Variant avx2 = []() -> uint32 { return 1; };
+        const Variant avx512 = []() -> uint32 { return 2; };
+
+        // Order doesn't matter, null variants are skipped
+        const Variant picked = SelectSimdVariant<Variant>({
+            {SimdLevel::Scalar, scalar},
+            {SimdLevel::Avx512, avx512},
+            {SimdLevel::Avx2, avx2},
+            {SimdLevel::Neon, nullptr},
+        });
+        const uint32 expected = IsSimdLevelSupported(SimdLevel::Avx512) ? 2
+                                : IsSimdLevelSupported(SimdLevel::Avx2) ? 1
+                                                                         : 0;
+        REQUIRE(picked != nullptr);
+        CHECK(picked() == expected);
+
+        CHECK(SelectSimdVariant<Variant>({{SimdLevel::Avx2, nullptr}, {SimdLevel::Scalar, scalar}})
+              == scalar);
+        CHECK(SelectSimdVariant<Variant>({{SimdLevel::Count, avx2}}) == nullptr);
+    }
+}
@@ -6,6 +6,7 @@
 
 #include "include/rsbl-core.h"
 #include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-ptr.h"
 
 using namespace rsbl;
 
@@ -53,6 +54,41 @@ struct TestStruct
     }
 };
 
+// Non-trivial type that opts in to relocation, so growth should never call the move constructor
+struct RelocatableStruct
+{
+    int value;
+    static inline int moveConstructorCalls = 0;
+
+    RelocatableStruct(int v = 0)
+        : value(v)
+    {
+    }
+
+    RelocatableStruct(const RelocatableStruct& other) = default;
+
+    RelocatableStruct(RelocatableStruct&& other) noexcept
+        : value(other.value)
+    {
+        moveConstructorCalls++;
+    }
+
+    RelocatableStruct& operator=(const RelocatableStruct&) = delete;
+
+    ~RelocatableStruct()
+    {
+    }
+};
+
+rsblDeclareTriviallyRelocatable(RelocatableStruct);
+
+static_assert(IsTriviallyRelocatable<int>);
+static_assert(IsTriviallyRelocatable<const float>);
+static_assert(IsTriviallyRelocatable<RelocatableStruct>);
+static_assert(IsTriviallyRelocatable<UniquePtr<TestStruct>>);
+static_assert(IsTriviallyRelocatable<DynamicArray<TestStruct>>);
+static_assert(!IsTriviallyRelocatable<TestStruct>);
+
 TEST_SUITE("rsbl::DynamicArray")
 {
     TEST_CASE("Default constructor creates empty array")
@@ -400,4 +436,159 @@ TEST_SUITE("rsbl::DynamicArray")
             }
         }
     }
+
+    TEST_CASE("Relocatable types grow without per-element moves")
+    {
+        DynamicArray<RelocatableStruct> arr;
+        for (int i = 0; i < 100; ++i)
+        {
+            arr.PushBack(RelocatableStruct(i));
+        }
+
+        // One move per PushBack, none from the growth
+        CHECK(RelocatableStruct::moveConstructorCalls == 100);
+        for (int i = 0; i < 100; ++i)
+        {
+            CHECK(arr[static_cast<uint64>(i)].value == i);
+        }
+    }
+
+    TEST_CASE("Non-relocatable types still move on growth")
+    {
+        TestStruct::resetCounters();
+
+        DynamicArray<TestStruct> arr;
+        for (int i = 0; i < 9; ++i)
+        {
+            arr.PushBack(TestStruct(i));
+        }
+
+        // 9 moves from PushBack, plus 8 when the initial capacity of 8 overflows
+        CHECK(TestStruct::moveConstructorCalls == 17);
+        CHECK(arr[8].value == 8);
+    }
+
+    TEST_CASE("UniquePtr elements survive relocation")
+    {
+        TestStruct::resetCounters();
+
+        {
+            DynamicArray<UniquePtr<TestStruct>> arr;
+            for (int i = 0; i < 50; ++i)
+            {
+                arr.PushBack(MakeUnique<TestStruct>(i));
+            }
+
+            CHECK(arr[49]->value == 49);
+            CHECK(TestStruct::destructorCalls == 0);
+        }
+
+        CHECK(TestStruct::destructorCalls == 50);
+    }
+
+    TEST_CASE("Resize zero-initializes trivial types")
+    {
+        DynamicArray<int> arr;
+        arr.PushBack(7);
+        arr.Resize(64);
+
+        CHECK(arr[0] == 7);
+        for (uint64 i = 1; i < arr.Size(); ++i)
+        {
+            CHECK(arr[i] == 0);
+        }
+    }
+
+    TEST_CASE("ResizeUninitialized sets size without construction")
+    {
+        DynamicArray<uint32> arr;
+        arr.ResizeUninitialized(1000);
+
+        CHECK(arr.Size() == 1000);
+        CHECK(arr.Capacity() >= 1000);
+
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            arr[i] = i;
+        }
+        CHECK(arr[999] == 999);
+
+        arr.ResizeUninitialized(10);
+        CHECK(arr.Size() == 10);
+        CHECK(arr[9] == 9);
+    }
+
+    TEST_CASE("EmplaceBack constructs in place")
+    {
+        TestStruct::resetCounters();
+
+        DynamicArray<TestStruct> arr;
+        arr.Reserve(4);
+
+        TestStruct& ref = arr.EmplaceBack(42);
+        CHECK(&ref == &arr[0]);
+        CHECK(arr[0].value == 42);
+        CHECK(TestStruct::constructorCalls == 1);
+        CHECK(TestStruct::moveConstructorCalls == 0);
+        CHECK(TestStruct::copyConstructorCalls == 0);
+    }
+
+    TEST_CASE("EmplaceBack with multiple arguments grows")
+    {
+        struct Pair
+        {
+            int a;
+            float b;
+            Pair(int a_, float b_)
+                : a(a_)
+                , b(b_)
+            {
+            }
+        };
+
+        DynamicArray<Pair> arr;
+        for (int i = 0; i < 20; ++i)
+        {
+            arr.EmplaceBack(i, static_cast<float>(i) * 0.5f);
+        }
+
+        CHECK(arr.Size() == 20);
+        CHECK(arr[19].a == 19);
+        CHECK(arr[19].b == 9.5f);
+    }
+
+    TEST_CASE("Append copies a range in one go")
+    {
+        const int values[] = {1, 2, 3, 4, 5};
+
+        DynamicArray<int> arr;
+        arr.PushBack(0);
+        arr.Append(values, 5);
+        arr.Append(values, 0);
+
+        CHECK(arr.Size() == 6);
+        CHECK(arr[0] == 0);
+        CHECK(arr[5] == 5);
+
+        // Single growth to fit the range
+        DynamicArray<int> big;
+        DynamicArray<int> source;
+        source.Resize(100);
+        big.Append(source.Data(), source.Size());
+        CHECK(big.Size() == 100);
+        CHECK(big.Capacity() >= 100);
+    }
+
+    TEST_CASE("Append copy-constructs non-trivial types")
+    {
+        TestStruct::resetCounters();
+        TestStruct values[3] = {TestStruct(1), TestStruct(2), TestStruct(3)};
+
+        DynamicArray<TestStruct> arr;
+        arr.Append(values, 3);
+
+        CHECK(arr.Size() == 3);
+        CHECK(arr[2].value == 3);
+        CHECK(TestStruct::copyConstructorCalls == 3);
+    }
 }
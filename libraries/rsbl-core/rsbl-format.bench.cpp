@@ -0,0 +1,66 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// FormatTo against snprintf on the text the engine formats most outside logging: a HUD stats
+// line of floats and integers, and an asset path built from strings and a number. Both write to
+// the same stack buffer, so the difference is parsing the format string at run time or not, and
+// the printf machinery against to_chars.
+
+#include "include/rsbl-format.h"
+
+#include <rsbl-bench.h>
+
+#include <cstdio>
+
+using namespace rsbl;
+
+int main(int argc, char** argv)
+{
+    Bench bench("rsbl-format", argc, argv);
+
+    char buffer[256];
+    uint32 frame = 0;
+    float ms = 16.6667f;
+    const char* directory = "content/cooked/sponza";
+    const char* mesh = "arch_column";
+
+    bench.Section("HUD line");
+    bench.Run("snprintf", [&]() {
+        ++frame;
+        DoNotOptimize(ms);
+        DoNotOptimize(snprintf(buffer,
+                               sizeof(buffer),
+                               "frame %u  %6.2f ms  %u draws  %u tris",
+                               frame,
+                               static_cast<double>(ms),
+                               frame & 1023,
+                               frame * 37));
+    });
+    bench.Run("FormatTo", [&]() {
+        ++frame;
+        DoNotOptimize(ms);
+        DoNotOptimize(FormatTo(buffer,
+                               "frame {}  {:6.2f} ms  {} draws  {} tris",
+                               frame,
+                               ms,
+                               frame & 1023,
+                               frame * 37)
+                          .Size());
+    });
+
+    bench.Section("Asset path");
+    bench.Run("snprintf", [&]() {
+        ++frame;
+        DoNotOptimize(directory);
+        DoNotOptimize(snprintf(
+            buffer, sizeof(buffer), "%s/meshes/%s_lod%u.rmesh", directory, mesh, frame & 7));
+    });
+    bench.Run("FormatTo", [&]() {
+        ++frame;
+        DoNotOptimize(directory);
+        DoNotOptimize(
+            FormatTo(buffer, "{}/meshes/{}_lod{}.rmesh", directory, mesh, frame & 7).Size());
+    });
+
+    return bench.Finish();
+}
@@ -0,0 +1,222 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-format.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace rsbl::Internal
+{
+
+namespace
+{
+// Enough for a double in fixed notation at the largest precision
+constexpr uint64 kNumberScratchSize = 1024;
+
+// Writes what fits of the text, counting all of it
+struct Output
+{
+    char* buffer;
+    // Chars that fit, not counting the terminator
+    uint64 room;
+    uint64 size = 0;
+
+    void Put(const char* text, uint64 count)
+    {
+        if (size < room)
+        {
+            const uint64 fits = room - size;
+            memcpy(buffer + size, text, count < fits ? count : fits);
+        }
+        size += count;
+    }
+
+    void Fill(char c, uint64 count)
+    {
+        if (size < room)
+        {
+            const uint64 fits = room - size;
+            memset(buffer + size, c, count < fits ? count : fits);
+        }
+        size += count;
+    }
+};
+
+void Pad(Output& out,
+         const FormatSegment& segment,
+         const char* text,
+         uint64 size,
+         bool number,
+         uint64 signSize)
+{
+    const uint64 padding = segment.width > size ? segment.width - size : 0;
+    if (padding == 0)
+    {
+        out.Put(text, size);
+        return;
+    }
+
+    if (number && segment.zeroPad != 0)
+    {
+        // Zeros go between the sign or 0x and the digits
+        out.Put(text, signSize);
+        out.Fill('0', padding);
+        out.Put(text + signSize, size - signSize);
+        return;
+    }
+
+    const bool right = segment.align == kFormatAlignRight ||
+                       (segment.align == kFormatAlignDefault && number);
+    if (right)
+    {
+        out.Fill(' ', padding);
+        out.Put(text, size);
+    }
+    else
+    {
+        out.Put(text, size);
+        out.Fill(' ', padding);
+    }
+}
+
+uint64 Integer(char* scratch, uint64 scratchSize, const FormatArg& arg, char type)
+{
+    const int base = type == 'x' || type == 'X' ? 16 : (type == 'b' ? 2 : 10);
+    char* end = scratch + scratchSize;
+    std::to_chars_result result;
+    if (arg.type == FormatArgType::Int)
+    {
+        result = std::to_chars(scratch, end, arg.i, base);
+    }
+    else
+    {
+        result = std::to_chars(scratch, end, arg.u, base);
+    }
+    if (type == 'X')
+    {
+        for (char* c = scratch; c != result.ptr; ++c)
+        {
+            if (*c >= 'a' && *c <= 'f')
+            {
+                *c = static_cast<char>(*c - 'a' + 'A');
+            }
+        }
+    }
+    return static_cast<uint64>(result.ptr - scratch);
+}
+
+template <typename T>
+uint64 Floating(char* scratch, T value, const FormatSegment& segment)
+{
+    char* end = scratch + kNumberScratchSize;
+    const int precision = segment.hasPrecision != 0 ? segment.precision : 6;
+    std::to_chars_result result;
+    if (segment.type == 'f')
+    {
+        result = std::to_chars(scratch, end, value, std::chars_format::fixed, precision);
+    }
+    else if (segment.type == 'e')
+    {
+        result = std::to_chars(scratch, end, value, std::chars_format::scientific, precision);
+    }
+    else if (segment.hasPrecision != 0)
+    {
+        result = std::to_chars(scratch, end, value, std::chars_format::general, precision);
+    }
+    else
+    {
+        result = std::to_chars(scratch, end, value);
+    }
+    return static_cast<uint64>(result.ptr - scratch);
+}
+
+void FormatArgument(Output& out, const FormatSegment& segment, const FormatArg& arg)
+{
+    char scratch[kNumberScratchSize];
+    switch (arg.type)
+    {
+    case FormatArgType::String:
+    {
+        uint64 size = arg.s.size;
+        if (segment.hasPrecision != 0 && segment.precision < size)
+        {
+            size = segment.precision;
+        }
+        Pad(out, segment, arg.s.data, size, false, 0);
+        return;
+    }
+    case FormatArgType::Bool:
+    case FormatArgType::Char:
+        if (segment.type == 0)
+        {
+            if (arg.type == FormatArgType::Bool)
+            {
+                Pad(out, segment, arg.u != 0 ? "true" : "false", arg.u != 0 ? 4 : 5, false, 0);
+            }
+            else
+            {
+                scratch[0] = static_cast<char>(arg.u);
+                Pad(out, segment, scratch, 1, false, 0);
+            }
+            return;
+        }
+        [[fallthrough]];
+    case FormatArgType::Int:
+    case FormatArgType::Uint:
+    {
+        const uint64 size = Integer(scratch, sizeof(scratch), arg, segment.type);
+        Pad(out, segment, scratch, size, true, scratch[0] == '-' ? 1 : 0);
+        return;
+    }
+    case FormatArgType::Pointer:
+    {
+        FormatArg address;
+        address.type = FormatArgType::Uint;
+        address.u = reinterpret_cast<uintptr_t>(arg.p);
+        scratch[0] = '0';
+        scratch[1] = segment.type == 'b' ? 'b' : 'x';
+        const char type = segment.type == 0 ? 'x' : segment.type;
+        const uint64 size = Integer(scratch + 2, sizeof(scratch) - 2, address, type);
+        Pad(out, segment, scratch, size + 2, true, 2);
+        return;
+    }
+    case FormatArgType::Float:
+    case FormatArgType::Double:
+    {
+        const uint64 size = arg.type == FormatArgType::Float ? Floating(scratch, arg.f, segment)
+                                                             : Floating(scratch, arg.d, segment);
+        Pad(out, segment, scratch, size, true, scratch[0] == '-' ? 1 : 0);
+        return;
+    }
+    }
+}
+} // namespace
+
+uint64 FormatSegments(char* buffer,
+                      uint64 capacity,
+                      const char* format,
+                      const FormatSegment* segments,
+                      uint32 segmentCount,
+                      const FormatArg* args)
+{
+    Output out{buffer, capacity == 0 ? 0 : capacity - 1};
+    uint32 arg = 0;
+    for (uint32 i = 0; i < segmentCount; ++i)
+    {
+        const FormatSegment& segment = segments[i];
+        out.Put(format + segment.literalOffset, segment.literalSize);
+        if (segment.hasArg != 0)
+        {
+            FormatArgument(out, segment, args[arg++]);
+        }
+    }
+
+    if (capacity != 0)
+    {
+        buffer[out.size < out.room ? out.size : out.room] = '\0';
+    }
+    return out.size;
+}
+
+} // namespace rsbl::Internal
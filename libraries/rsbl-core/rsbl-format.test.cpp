@@ -0,0 +1,167 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-allocator.h"
+#include "include/rsbl-format.h"
+
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+enum class Quality : uint8
+{
+    Low = 1,
+    High = 3,
+};
+
+class CountingAllocator : public Allocator
+{
+  public:
+    void* Allocate(uint64 size, uint64 alignment) override
+    {
+        allocations++;
+        return m_heap.Allocate(size, alignment);
+    }
+
+    void Free(void* ptr, uint64 size, uint64 alignment) override
+    {
+        m_heap.Free(ptr, size, alignment);
+    }
+
+    int allocations = 0;
+
+  private:
+    HeapAllocator m_heap;
+};
+} // namespace
+
+TEST_SUITE("rsbl::Format")
+{
+    TEST_CASE("Arguments fill the placeholders in order")
+    {
+        char buffer[128];
+        CHECK(FormatTo(buffer, "no placeholders") == "no placeholders");
+        CHECK(FormatTo(buffer, "{} + {} = {}", 2, 3u, int64(-5)) == "2 + 3 = -5");
+        CHECK(FormatTo(buffer, "{}/{}/{}", "textures", StringView("brick"), String("albedo")) ==
+              "textures/brick/albedo");
+        CHECK(FormatTo(buffer, "{} {} {}", true, false, 'x') == "true false x");
+        CHECK(FormatTo(buffer, "{}", Quality::High) == "3");
+        CHECK(FormatTo(buffer, "{{{}}} }}{{", 7) == "{7} }{");
+        CHECK(strcmp(buffer, "{7} }{") == 0);
+
+        const char* name = "helmet";
+        char* mutable_name = buffer + 64;
+        strcpy(mutable_name, "sponza");
+        CHECK(FormatTo(buffer, "{} {}", name, static_cast<const char*>(mutable_name)) ==
+              "helmet sponza");
+
+        // Extremes
+        CHECK(FormatTo(buffer, "{} {}", int64(-9223372036854775807 - 1), ~uint64(0)) ==
+              "-9223372036854775808 18446744073709551615");
+        CHECK(FormatTo(buffer, "{} {}", int8(-128), uint8(255)) == "-128 255");
+    }
+
+    TEST_CASE("Specs")
+    {
+        char buffer[128];
+        CHECK(FormatTo(buffer, "[{:5}] [{:<5}] [{:05}] [{:05}]", 42, 42, 42, -42) ==
+              "[   42] [42   ] [00042] [-0042]");
+        CHECK(FormatTo(buffer, "[{:6}] [{:>6}] [{:.3}]", "ab", "ab", "abcdef") ==
+              "[ab    ] [    ab] [abc]");
+        CHECK(FormatTo(buffer, "{:x} {:X} {:08x} {:b}", 255u, 0xbeefu, 0x1234, 5) ==
+              "ff BEEF 00001234 101");
+        CHECK(FormatTo(buffer, "{:x}", -255) == "-ff");
+        CHECK(FormatTo(buffer, "{:x}", 'A') == "41");
+
+        const void* pointer = reinterpret_cast<const void*>(uintptr_t(0xabc0));
+        CHECK(FormatTo(buffer, "{} {:018x}", pointer, pointer) == "0xabc0 0x000000000000abc0");
+    }
+
+    TEST_CASE("Floats")
+    {
+        char buffer[128];
+        // Shortest text that reads back the same, for floats as floats
+        CHECK(FormatTo(buffer, "{} {} {}", 0.1f, 0.1, 1.5f) == "0.1 0.1 1.5");
+        CHECK(FormatTo(buffer, "{:.2f} {:f} {:.0f}", 16.6666f, 2.5, 2.5) ==
+              "16.67 2.500000 2");
+        CHECK(FormatTo(buffer, "{:.3e} {:.3}", 12345.678, 12345.678) == "1.235e+04 1.23e+04");
+        CHECK(FormatTo(buffer, "{:>8.2f}|{:<8.1f}|{:08.3f}", 3.14159, 2.0f, -1.5) ==
+              "    3.14|2.0     |-001.500");
+    }
+
+    TEST_CASE("Text that doesn't fit is cut short and terminated")
+    {
+        char small[8];
+        const StringView cut = FormatTo(small, "{} and {}", "first", "second");
+        CHECK(cut == "first a");
+        CHECK(small[7] == '\0');
+
+        char none[1];
+        CHECK(FormatTo(none, "{}", 12345).IsEmpty());
+        CHECK(none[0] == '\0');
+
+        // Asked for the size of everything, the way FormatAppend grows
+        char exact[6];
+        CHECK(FormatTo(exact, "{}", 12345) == "12345");
+    }
+
+    TEST_CASE("Appending grows with the string's own allocator")
+    {
+        CountingAllocator counting;
+        String text(&counting);
+        FormatAppend(text, "{} fps", 60);
+        CHECK(text == StringView("60 fps"));
+        CHECK(counting.allocations == 0);
+
+        FormatAppend(text, ", {:.2f} ms, {} draws in {} passes", 16.6667, 1234, 7);
+        CHECK(text == StringView("60 fps, 16.67 ms, 1234 draws in 7 passes"));
+        CHECK(counting.allocations == 1);
+        CHECK(text.CStr()[text.Size()] == '\0');
+
+        // An arena string never touches the heap
+        alignas(16) uint8 storage[512];
+        LinearArena arena(storage, sizeof(storage));
+        String path(&arena);
+        for (uint32 lod = 0; lod < 4; ++lod)
+        {
+            path.Clear();
+            FormatAppend(path, "{}/meshes/{}_lod{}.rmesh", "content/cooked/sponza", "arch", lod);
+        }
+        CHECK(path == StringView("content/cooked/sponza/meshes/arch_lod3.rmesh"));
+    }
+
+    TEST_CASE("Format buffers and failures")
+    {
+        const auto text = Format("{}x{}", 1920, 1080);
+        CHECK(text.View() == "1920x1080");
+        CHECK(strcmp(text.CStr(), "1920x1080") == 0);
+
+        const FormatBuffer<16> cut = Format<16>("{} {}", "a long line of", "text");
+        CHECK(cut.View() == "a long line of ");
+
+        Result<uint32> result = FailureFormatCopy(
+            ErrorCategory::NotFound, "No texture {} in {}", String("albedo"), "brick.rmat");
+        REQUIRE_FALSE(result);
+        CHECK(result.Category() == ErrorCategory::NotFound);
+        CHECK(strcmp(result.FailureText(), "No texture albedo in brick.rmat") == 0);
+    }
+
+    TEST_CASE("Format strings are parsed at compile time")
+    {
+        constexpr FormatString<int, float> format("{:>4} {:.1f}{{}}");
+        static_assert(format.SegmentCount() == 5);
+        static_assert(format.Segments()[0].hasArg == 1);
+        static_assert(format.Segments()[0].width == 4);
+        static_assert(format.Segments()[1].literalSize == 1);
+        static_assert(format.Segments()[1].type == 'f');
+        static_assert(format.Segments()[2].literalSize == 1);
+        static_assert(format.Segments()[3].literalSize == 1);
+        static_assert(format.Segments()[4].literalSize == 0);
+        static_assert(format.Segments()[4].hasArg == 0);
+    }
+}
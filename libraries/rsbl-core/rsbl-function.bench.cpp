@@ -0,0 +1,314 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Function against std::function, std::move_only_function and plain function pointers: the cost
+// of a call, of constructing and destroying one around captures of different sizes and buffer
+// sizes, of moving one, and all of them together the way a job queue uses them: construct from a
+// lambda, move into the queue, invoke once, destroy. The queues keep their capacity between
+// runs, like a real job system would, otherwise the timing is mostly page faults.
+
+#include "include/rsbl-function.h"
+
+#include <rsbl-bench.h>
+
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#if defined(_MSC_VER)
+    #define RSBL_BENCH_NOINLINE __declspec(noinline)
+#else
+    #define RSBL_BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint64 kJobCount = 100'000;
+
+#if __cpp_lib_move_only_function >= 202110L
+    #define RSBL_BENCH_MOVE_ONLY_FUNCTION 1
+#endif
+
+RSBL_BENCH_NOINLINE void AddTo(uint64* target, uint64 value)
+{
+    *target += value;
+}
+
+// Captured data, all of it read by the call
+template <uint32 Size>
+struct Capture
+{
+    uint64 words[Size / 8];
+};
+
+// A job whose captures, the target and the data, come to Size bytes
+template <uint32 Size>
+auto MakeJob(uint64* target)
+{
+    Capture<Size - sizeof(uint64*)> capture = {};
+    capture.words[0] = 1;
+    return [target, capture]() {
+        for (uint64 word : capture.words)
+        {
+            *target += word;
+        }
+    };
+}
+
+// Calls through each kind of callable, hidden from the optimizer before every call so it can't
+// be inlined through
+void InvokeSuite(Bench& bench)
+{
+    bench.Section("Invoke, adding to a counter");
+    uint64 counter = 0;
+    uint64* target = &counter;
+
+    void (*pointer)(uint64*, uint64) = &AddTo;
+    bench.Run("function pointer", [&]() {
+        DoNotOptimize(pointer);
+        pointer(target, 1);
+    });
+
+    auto lambda = [target](uint64 value) { AddTo(target, value); };
+    FunctionRef<void(uint64)> ref(lambda);
+    bench.Run("rsbl::FunctionRef", [&]() {
+        DoNotOptimize(ref);
+        ref(1);
+    });
+
+    Function<void(uint64)> function(lambda);
+    bench.Run("rsbl::Function", [&]() {
+        DoNotOptimize(function);
+        function(1);
+    });
+
+    std::function<void(uint64)> stdFunction(lambda);
+    bench.Run("std::function", [&]() {
+        DoNotOptimize(stdFunction);
+        stdFunction(1);
+    });
+
+#if defined(RSBL_BENCH_MOVE_ONLY_FUNCTION)
+    std::move_only_function<void(uint64)> moveOnly(lambda);
+    bench.Run("std::move_only_function", [&]() {
+        DoNotOptimize(moveOnly);
+        moveOnly(1);
+    });
+#endif
+    DoNotOptimize(counter);
+}
+
+// Construct, call and destroy around a Size byte capture. Function<32> can't hold a 64 byte
+// capture inline, so it's pooled there; std::function and std::move_only_function only keep a
+// capture or two of pointers inline.
+template <uint32 Size>
+void ConstructSuite(Bench& bench, const char* section)
+{
+    bench.Section(section);
+    uint64 counter = 0;
+    uint64* target = &counter;
+
+    if constexpr (Size <= 32)
+    {
+        bench.Run("rsbl::Function<32>", [&]() {
+            Function<void()> function(MakeJob<Size>(target));
+            DoNotOptimize(function);
+            function();
+        });
+    }
+    else
+    {
+        bench.Run("rsbl::Function<32, InlineOrPool>", [&]() {
+            Function<void(), 32, FunctionStorage::InlineOrPool> function(MakeJob<Size>(target));
+            DoNotOptimize(function);
+            function();
+        });
+    }
+    bench.Run("rsbl::Function<64>", [&]() {
+        Function<void(), 64> function(MakeJob<Size>(target));
+        DoNotOptimize(function);
+        function();
+    });
+    bench.Run("std::function", [&]() {
+        std::function<void()> function(MakeJob<Size>(target));
+        DoNotOptimize(function);
+        function();
+    });
+#if defined(RSBL_BENCH_MOVE_ONLY_FUNCTION)
+    bench.Run("std::move_only_function", [&]() {
+        std::move_only_function<void()> function(MakeJob<Size>(target));
+        DoNotOptimize(function);
+        function();
+    });
+#endif
+    DoNotOptimize(counter);
+}
+
+// Move one back and forth between two, what handing a job over costs
+template <uint32 Size>
+void MoveSuite(Bench& bench, const char* section)
+{
+    bench.Section(section);
+    uint64 counter = 0;
+    uint64* target = &counter;
+
+    const auto pingPong = [&](auto& first, auto& second) {
+        second = rsblMove(first);
+        DoNotOptimize(second);
+        first = rsblMove(second);
+        DoNotOptimize(first);
+    };
+
+    using Pooled = Function<void(), 32, FunctionStorage::InlineOrPool>;
+    Pooled function(MakeJob<Size>(target));
+    Pooled otherFunction;
+    bench.Run("rsbl::Function<32, InlineOrPool>", [&]() { pingPong(function, otherFunction); });
+
+    Function<void(), 64> wide(MakeJob<Size>(target));
+    Function<void(), 64> otherWide;
+    bench.Run("rsbl::Function<64>", [&]() { pingPong(wide, otherWide); });
+
+    std::function<void()> stdFunction(MakeJob<Size>(target));
+    std::function<void()> otherStdFunction;
+    bench.Run("std::function", [&]() { pingPong(stdFunction, otherStdFunction); });
+
+#if defined(RSBL_BENCH_MOVE_ONLY_FUNCTION)
+    std::move_only_function<void()> moveOnly(MakeJob<Size>(target));
+    std::move_only_function<void()> otherMoveOnly;
+    bench.Run("std::move_only_function", [&]() { pingPong(moveOnly, otherMoveOnly); });
+#endif
+}
+
+// Queues are allocated once and reused, Index separates the two queues of the same job type
+template <typename JobType, uint32 Index = 0>
+std::vector<JobType>& GetQueue()
+{
+    static std::vector<JobType> s_queue = [] {
+        std::vector<JobType> queue;
+        queue.reserve(kJobCount);
+        return queue;
+    }();
+    s_queue.clear();
+    return s_queue;
+}
+
+// Fill a queue with jobs capturing a couple of pointers, then drain it
+template <typename JobType>
+void RunQueue()
+{
+    std::vector<JobType>& queue = GetQueue<JobType>();
+
+    uint64 counter = 0;
+    for (uint64 i = 0; i < kJobCount; ++i)
+    {
+        uint64* target = &counter;
+        queue.emplace_back([target, i]() { *target += i; });
+    }
+
+    for (JobType& job : queue)
+    {
+        job();
+    }
+    queue.clear();
+    DoNotOptimize(counter);
+}
+
+// Same, but the capture is non-trivial so moves and destruction aren't free
+template <typename JobType>
+void RunNonTrivialQueue()
+{
+    struct Payload
+    {
+        uint64* target;
+        uint64 value;
+
+        Payload(uint64* t, uint64 v)
+            : target(t)
+            , value(v)
+        {
+        }
+        Payload(const Payload&) = default;
+        Payload(Payload&& other) noexcept
+            : target(other.target)
+            , value(other.value)
+        {
+        }
+        ~Payload()
+        {
+            value = 0;
+        }
+    };
+
+    std::vector<JobType>& queue = GetQueue<JobType>();
+
+    uint64 counter = 0;
+    for (uint64 i = 0; i < kJobCount; ++i)
+    {
+        Payload payload(&counter, i);
+        queue.emplace_back([payload]() { *payload.target += payload.value; });
+    }
+
+    // Shuffle the whole queue once, like handing a batch to another thread
+    std::vector<JobType>& stolen = GetQueue<JobType, 1>();
+    for (JobType& job : queue)
+    {
+        stolen.push_back(rsblMove(job));
+    }
+
+    for (JobType& job : stolen)
+    {
+        job();
+    }
+    queue.clear();
+    stolen.clear();
+    DoNotOptimize(counter);
+}
+
+void QueueSuite(Bench& bench)
+{
+    const BenchConfig perJob = {.items = kJobCount};
+
+    bench.Section("Queue of 100000 jobs, trivial capture");
+    bench.Run("rsbl::Function", RunQueue<Function<void()>>, perJob);
+    bench.Run("std::function", RunQueue<std::function<void()>>, perJob);
+#if defined(RSBL_BENCH_MOVE_ONLY_FUNCTION)
+    bench.Run("std::move_only_function", RunQueue<std::move_only_function<void()>>, perJob);
+#endif
+
+    bench.Section("Queue of 100000 jobs, non-trivial capture, moved once");
+    bench.Run("rsbl::Function", RunNonTrivialQueue<Function<void()>>, perJob);
+    bench.Run("std::function", RunNonTrivialQueue<std::function<void()>>, perJob);
+#if defined(RSBL_BENCH_MOVE_ONLY_FUNCTION)
+    bench.Run(
+        "std::move_only_function", RunNonTrivialQueue<std::move_only_function<void()>>, perJob);
+#endif
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Bench bench("rsbl-function", argc, argv);
+
+    printf("Layout\n");
+    printf("  %-40s size %2zu\n", "rsbl::Function<void()>", sizeof(Function<void()>));
+    printf("  %-40s size %2zu\n", "rsbl::Function<void(), 64>", sizeof(Function<void(), 64>));
+    printf("  %-40s size %2zu\n", "rsbl::FunctionRef<void()>", sizeof(FunctionRef<void()>));
+    printf("  %-40s size %2zu\n", "std::function<void()>", sizeof(std::function<void()>));
+#if defined(RSBL_BENCH_MOVE_ONLY_FUNCTION)
+    printf("  %-40s size %2zu\n",
+           "std::move_only_function<void()>",
+           sizeof(std::move_only_function<void()>));
+#endif
+
+    InvokeSuite(bench);
+    ConstructSuite<16>(bench, "Construct, call and destroy, 16 byte capture");
+    ConstructSuite<32>(bench, "Construct, call and destroy, 32 byte capture");
+    ConstructSuite<64>(bench, "Construct, call and destroy, 64 byte capture");
+    MoveSuite<16>(bench, "Move there and back, 16 byte capture");
+    MoveSuite<64>(bench, "Move there and back, 64 byte capture");
+    QueueSuite(bench);
+
+    return bench.Finish();
+}
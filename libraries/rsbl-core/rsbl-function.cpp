@@ -0,0 +1,76 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-function.h"
+
+#include "include/rsbl-memory-tracking.h"
+#include "include/rsbl-pool-allocator.h"
+
+namespace
+{
+// Anything that spills out of a Function buffer is typically a lambda with a few extra captures,
+// so a handful of small size classes covers nearly all of it
+constexpr uint64 kFunctorPoolSlotSizes[] = {64, 128, 256};
+constexpr uint32 kFunctorPoolCount = sizeof(kFunctorPoolSlotSizes) / sizeof(uint64);
+constexpr uint64 kFunctorPoolSlotsPerBlock = 64;
+
+rsbl::FixedPoolAllocator* GetFunctorPool(uint64 size, uint64 alignment)
+{
+    // Intentionally never destroyed, a Function living in a static can outlive any pool destructor
+    static rsbl::FixedPoolAllocator* s_pools[kFunctorPoolCount] = {
+        new rsbl::FixedPoolAllocator(kFunctorPoolSlotSizes[0],
+                                     rsbl::kFunctionBufferAlignment,
+                                     kFunctorPoolSlotsPerBlock,
+                                     true,
+                                     rsbl::GetTaggedAllocator(rsbl::MemoryTag::Core)),
+        new rsbl::FixedPoolAllocator(kFunctorPoolSlotSizes[1],
+                                     rsbl::kFunctionBufferAlignment,
+                                     kFunctorPoolSlotsPerBlock,
+                                     true,
+                                     rsbl::GetTaggedAllocator(rsbl::MemoryTag::Core)),
+        new rsbl::FixedPoolAllocator(kFunctorPoolSlotSizes[2],
+                                     rsbl::kFunctionBufferAlignment,
+                                     kFunctorPoolSlotsPerBlock,
+                                     true,
+                                     rsbl::GetTaggedAllocator(rsbl::MemoryTag::Core)),
+    };
+
+    if (alignment > rsbl::kFunctionBufferAlignment)
+    {
+        return nullptr;
+    }
+
+    for (uint32 i = 0; i < kFunctorPoolCount; ++i)
+    {
+        if (size <= kFunctorPoolSlotSizes[i])
+        {
+            return s_pools[i];
+        }
+    }
+    return nullptr;
+}
+} // namespace
+
+namespace rsbl::Internal
+{
+void* AllocateFunctor(uint64 size, uint64 alignment)
+{
+    FixedPoolAllocator* pool = GetFunctorPool(size, alignment);
+    if (pool != nullptr)
+    {
+        return pool->AllocateSlot();
+    }
+    return GetTaggedAllocator(MemoryTag::Core)->Allocate(size, alignment);
+}
+
+void FreeFunctor(void* ptr, uint64 size, uint64 alignment)
+{
+    FixedPoolAllocator* pool = GetFunctorPool(size, alignment);
+    if (pool != nullptr)
+    {
+        pool->FreeSlot(ptr);
+        return;
+    }
+    GetTaggedAllocator(MemoryTag::Core)->Free(ptr, size, alignment);
+}
+} // namespace rsbl::Internal
@@ -12,6 +12,10 @@ using namespace rsbl;
 
 static_assert(alignof(std::max_align_t) <= rsbl::kFunctionBufferAlignment);
 
+// A job is a default Function plus a single ops pointer, one cache line
+static_assert(sizeof(Function<void()>) == 48);
+static_assert(sizeof(Function<void()>) <= 64);
+
 // Test helper struct with tracking capabilities
 struct FunctorTracker
 {
@@ -556,4 +560,220 @@ TEST_SUITE("rsbl::Function")
 
         CHECK(func(10) == 20);
     }
+
+    TEST_CASE("Pooled - small functor stays inline")
+    {
+        auto lambda = [](int x) {
+            return x * 2;
+        };
+        static_assert(PooledFunction<int(int)>::FitsInline<decltype(lambda)>());
+
+        PooledFunction<int(int)> func(lambda);
+        CHECK(func(21) == 42);
+    }
+
+    TEST_CASE("Pooled - large functor spills to the pool")
+    {
+        struct BigFunctor
+        {
+            int values[32] = {};
+
+            int operator()(int x) const
+            {
+                return x + values[0] + values[31];
+            }
+        };
+        static_assert(!PooledFunction<int(int)>::FitsInline<BigFunctor>());
+
+        BigFunctor big;
+        big.values[0] = 1;
+        big.values[31] = 2;
+
+        PooledFunction<int(int)> func(big);
+        CHECK(func.Valid());
+        CHECK(func(10) == 13);
+
+        PooledFunction<int(int)> moved(rsblMove(func));
+        CHECK_FALSE(func.Valid());
+        CHECK(moved(10) == 13);
+    }
+
+    TEST_CASE("Pooled - moving a spilled functor only moves the pointer")
+    {
+        struct BigTracker
+        {
+            FunctorTracker tracker;
+            uint8 padding[128] = {};
+
+            int operator()(int x) const
+            {
+                return tracker(x);
+            }
+        };
+
+        FunctorTracker::resetCounters();
+        {
+            PooledFunction<int(int)> func(BigTracker{FunctorTracker(5)});
+            const int moves_after_construct = FunctorTracker::moveConstructorCalls;
+
+            PooledFunction<int(int)> moved(rsblMove(func));
+            PooledFunction<int(int)> assigned;
+            assigned = rsblMove(moved);
+            CHECK(FunctorTracker::moveConstructorCalls == moves_after_construct);
+            CHECK(assigned(1) == 6);
+        }
+        CHECK(FunctorTracker::destructorCalls ==
+              FunctorTracker::constructorCalls + FunctorTracker::moveConstructorCalls);
+    }
+
+    TEST_CASE("Pooled - very large and over-aligned functors")
+    {
+        struct HugeFunctor
+        {
+            uint8 bytes[1024] = {};
+
+            int operator()() const
+            {
+                return bytes[0] + bytes[1023];
+            }
+        };
+
+        struct alignas(64) AlignedFunctor
+        {
+            int value = 7;
+
+            int operator()() const
+            {
+                return value;
+            }
+        };
+
+        HugeFunctor huge;
+        huge.bytes[0] = 3;
+        huge.bytes[1023] = 4;
+        PooledFunction<int()> huge_func(huge);
+        CHECK(huge_func() == 7);
+
+        PooledFunction<int()> aligned_func(AlignedFunctor{});
+        CHECK(aligned_func() == 7);
+
+        // Lots of churn through the shared pools
+        for (int i = 0; i < 1000; ++i)
+        {
+            PooledFunction<int()> temp(huge);
+            PooledFunction<int()> aligned(AlignedFunctor{});
+            CHECK(temp() + aligned() == 14);
+        }
+    }
+
+    TEST_CASE("FunctionRef - lambda")
+    {
+        static_assert(sizeof(FunctionRef<int(int)>) == 2 * sizeof(void*));
+
+        int calls = 0;
+        auto lambda = [&calls](int x) {
+            calls++;
+            return x + 1;
+        };
+
+        FunctionRef<int(int)> ref(lambda);
+        CHECK(ref(1) == 2);
+        CHECK(ref(2) == 3);
+        CHECK(calls == 2);
+
+        // Copies refer to the same callable
+        FunctionRef<int(int)> copy = ref;
+        CHECK(copy(3) == 4);
+        CHECK(calls == 3);
+    }
+
+    TEST_CASE("FunctionRef - mutable state is shared with the callable")
+    {
+        struct Counter
+        {
+            int count = 0;
+
+            void operator()()
+            {
+                count++;
+            }
+        };
+
+        Counter counter;
+        FunctionRef<void()> ref(counter);
+        ref();
+        ref();
+        CHECK(counter.count == 2);
+    }
+
+    TEST_CASE("FunctionRef - no copies of the callable")
+    {
+        FunctorTracker::resetCounters();
+        const FunctorTracker tracker(10);
+
+        FunctionRef<int(int)> ref(tracker);
+        CHECK(ref(5) == 15);
+        CHECK(FunctorTracker::constructorCalls == 1);
+        CHECK(FunctorTracker::moveConstructorCalls == 0);
+    }
+
+    TEST_CASE("FunctionRef - free function")
+    {
+        FunctionRef<int(int, int)> ref(FreeAdd);
+        CHECK(ref(2, 3) == 5);
+
+        FunctionRef<int(int, int)> ptr_ref(&FreeAdd);
+        CHECK(ptr_ref(4, 5) == 9);
+    }
+
+    TEST_CASE("FunctionRef - as a parameter")
+    {
+        auto for_each = [](int count, FunctionRef<void(int)> body) {
+            for (int i = 0; i < count; ++i)
+            {
+                body(i);
+            }
+        };
+
+        int sum = 0;
+        for_each(5, [&sum](int i) { sum += i; });
+        CHECK(sum == 10);
+
+        Function<int(int)> func([](int x) { return x * 3; });
+        int total = 0;
+        for_each(3, [&](int i) { total += func(i); });
+        CHECK(total == 9);
+    }
+
+    TEST_CASE("Trivially copyable functor survives a chain of moves")
+    {
+        int a = 1, b = 2, c = 3;
+        auto lambda = [a, b, c](int x) {
+            return x + a + b + c;
+        };
+        static_assert(__is_trivially_copyable(decltype(lambda)));
+
+        Function<int(int)> func1(lambda);
+        Function<int(int)> func2(rsblMove(func1));
+        Function<int(int)> func3;
+        func3 = rsblMove(func2);
+
+        CHECK_FALSE(func1.Valid());
+        CHECK_FALSE(func2.Valid());
+        CHECK(func3(4) == 10);
+    }
+
+    TEST_CASE("Non-trivial functor is relocated on move")
+    {
+        FunctorTracker::resetCounters();
+        {
+            Function<int(int)> func1(FunctorTracker(3));
+            Function<int(int)> func2(rsblMove(func1));
+            CHECK(func2(1) == 4);
+        }
+
+        // Every construction (temp, store, move) is matched by exactly one destruction
+        CHECK(FunctorTracker::destructorCalls ==
+              FunctorTracker::constructorCalls + FunctorTracker::moveConstructorCalls);
+    }
 }
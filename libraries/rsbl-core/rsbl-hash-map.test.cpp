@@ -0,0 +1,324 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-hash-map.h"
+#include "include/rsbl-ptr.h"
+
+using namespace rsbl;
+
+// Tracks live instances so we can catch leaks and double destroys across rehashes
+struct TrackedValue
+{
+    int value;
+    static inline int liveCount = 0;
+
+    TrackedValue(int v = 0)
+        : value(v)
+    {
+        liveCount++;
+    }
+
+    TrackedValue(const TrackedValue& other)
+        : value(other.value)
+    {
+        liveCount++;
+    }
+
+    TrackedValue(TrackedValue&& other) noexcept
+        : value(other.value)
+    {
+        liveCount++;
+    }
+
+    TrackedValue& operator=(const TrackedValue&) = default;
+    TrackedValue& operator=(TrackedValue&&) = default;
+
+    ~TrackedValue()
+    {
+        liveCount--;
+    }
+};
+
+// Every key lands in the same group, to exercise probing and tombstones
+struct CollidingHash
+{
+    uint64 operator()(int) const
+    {
+        return 0;
+    }
+};
+
+TEST_SUITE("rsbl::HashMap")
+{
+    TEST_CASE("Default construction")
+    {
+        HashMap<int, int> map;
+        CHECK(map.Size() == 0);
+        CHECK(map.Capacity() == 0);
+        CHECK(map.IsEmpty());
+        CHECK(map.Find(1) == nullptr);
+        CHECK_FALSE(map.Remove(1));
+    }
+
+    TEST_CASE("Insert and Find")
+    {
+        HashMap<int, int> map;
+        CHECK(map.Insert(1, 10));
+        CHECK(map.Insert(2, 20));
+        CHECK_FALSE(map.Insert(1, 99));
+
+        CHECK(map.Size() == 2);
+        REQUIRE(map.Find(1) != nullptr);
+        CHECK(*map.Find(1) == 10);
+        CHECK(*map.Find(2) == 20);
+        CHECK(map.Find(3) == nullptr);
+        CHECK(map.Contains(2));
+        CHECK_FALSE(map.Contains(3));
+    }
+
+    TEST_CASE("InsertOrAssign and operator[]")
+    {
+        HashMap<int, int> map;
+        map.InsertOrAssign(5, 1);
+        map.InsertOrAssign(5, 2);
+        CHECK(*map.Find(5) == 2);
+
+        map[7] += 3;
+        map[7] += 3;
+        CHECK(map[7] == 6);
+        CHECK(map.Size() == 2);
+    }
+
+    TEST_CASE("Remove")
+    {
+        HashMap<int, int> map;
+        for (int i = 0; i < 100; ++i)
+        {
+            map.Insert(i, i * 2);
+        }
+
+        for (int i = 0; i < 100; i += 2)
+        {
+            CHECK(map.Remove(i));
+        }
+        CHECK(map.Size() == 50);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            CHECK(map.Contains(i) == (i % 2 == 1));
+        }
+    }
+
+    TEST_CASE("Large table")
+    {
+        HashMap<uint64, uint64> map;
+        const uint64 count = 100000;
+        for (uint64 i = 0; i < count; ++i)
+        {
+            map.Insert(i * 7919, i);
+        }
+
+        CHECK(map.Size() == count);
+        bool allFound = true;
+        for (uint64 i = 0; i < count; ++i)
+        {
+            const uint64* value = map.Find(i * 7919);
+            allFound = allFound && value != nullptr && *value == i;
+        }
+        CHECK(allFound);
+        CHECK(map.Find(1) == nullptr);
+    }
+
+    TEST_CASE("Reserve avoids rehashing")
+    {
+        HashMap<int, int> map;
+        map.Reserve(1000);
+        const uint64 capacity = map.Capacity();
+        CHECK(capacity >= 1000);
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            map.Insert(i, i);
+        }
+        CHECK(map.Capacity() == capacity);
+    }
+
+    TEST_CASE("Colliding keys and tombstone reuse")
+    {
+        HashMap<int, int, CollidingHash> map;
+        for (int i = 0; i < 40; ++i)
+        {
+            map.Insert(i, i);
+        }
+        for (int i = 0; i < 40; ++i)
+        {
+            REQUIRE(map.Find(i) != nullptr);
+            CHECK(*map.Find(i) == i);
+        }
+
+        // Churn through removes and inserts, which shouldn't grow the table
+        const uint64 capacity = map.Capacity();
+        for (int round = 0; round < 1000; ++round)
+        {
+            CHECK(map.Remove(round % 40));
+            CHECK(map.Insert(round % 40, round));
+        }
+        CHECK(map.Capacity() == capacity);
+        CHECK(map.Size() == 40);
+    }
+
+    TEST_CASE("Move-only values")
+    {
+        HashMap<int, UniquePtr<int>> map;
+        for (int i = 0; i < 64; ++i)
+        {
+            map.Insert(int(i), UniquePtr<int>(new int(i)));
+        }
+
+        REQUIRE(map.Find(42) != nullptr);
+        CHECK(**map.Find(42) == 42);
+
+        HashMap<int, UniquePtr<int>> moved(rsblMove(map));
+        CHECK(map.Size() == 0);
+        CHECK(moved.Size() == 64);
+        CHECK(**moved.Find(63) == 63);
+    }
+
+    TEST_CASE("Emplace constructs values in place")
+    {
+        HashMap<int, UniquePtr<int>> map;
+        map.Emplace(1, new int(5));
+        CHECK(**map.Find(1) == 5);
+    }
+
+    TEST_CASE("Copy")
+    {
+        HashMap<int, int> map;
+        for (int i = 0; i < 50; ++i)
+        {
+            map.Insert(i, i + 1);
+        }
+
+        HashMap<int, int> copy(map);
+        CHECK(copy.Size() == 50);
+        CHECK(*copy.Find(25) == 26);
+
+        copy[25] = 0;
+        CHECK(*map.Find(25) == 26);
+    }
+
+    TEST_CASE("Iteration")
+    {
+        HashMap<int, int> map;
+        for (int i = 0; i < 100; ++i)
+        {
+            map.Insert(i, i);
+        }
+
+        int count = 0;
+        int keySum = 0;
+        for (auto& entry : map)
+        {
+            keySum += entry.key;
+            entry.value = -1;
+            ++count;
+        }
+        CHECK(count == 100);
+        CHECK(keySum == 4950);
+        CHECK(*map.Find(10) == -1);
+    }
+
+    TEST_CASE("Clear and destruction release all values")
+    {
+        {
+            HashMap<int, TrackedValue> map;
+            for (int i = 0; i < 500; ++i)
+            {
+                map.Insert(i, TrackedValue(i));
+            }
+            CHECK(TrackedValue::liveCount == 500);
+
+            map.Remove(3);
+            CHECK(TrackedValue::liveCount == 499);
+
+            map.Clear();
+            CHECK(TrackedValue::liveCount == 0);
+            CHECK(map.Capacity() > 0);
+
+            map.Insert(1, TrackedValue(1));
+        }
+        CHECK(TrackedValue::liveCount == 0);
+    }
+
+    TEST_CASE("Uses the given allocator")
+    {
+        LinearArena arena(1 << 16);
+        HashMap<int, int> map(&arena);
+        map.Insert(1, 1);
+
+        CHECK(map.GetAllocator() == &arena);
+        CHECK(arena.BytesUsed() > 0);
+    }
+}
+
+TEST_SUITE("rsbl::HashSet")
+{
+    TEST_CASE("Insert, Contains and Remove")
+    {
+        HashSet<int> set;
+        CHECK(set.Insert(3));
+        CHECK_FALSE(set.Insert(3));
+        CHECK(set.Contains(3));
+        CHECK_FALSE(set.Contains(4));
+
+        CHECK(set.Remove(3));
+        CHECK_FALSE(set.Contains(3));
+        CHECK(set.IsEmpty());
+    }
+
+    TEST_CASE("Pointer keys")
+    {
+        int values[16];
+        HashSet<int*> set;
+        for (int& value : values)
+        {
+            set.Insert(&value);
+        }
+        CHECK(set.Size() == 16);
+        CHECK(set.Contains(&values[7]));
+
+        int other;
+        CHECK_FALSE(set.Contains(&other));
+    }
+
+    TEST_CASE("Iteration visits every key")
+    {
+        HashSet<uint32> set;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            set.Insert(i);
+        }
+
+        uint64 sum = 0;
+        for (uint32 key : set)
+        {
+            sum += key;
+        }
+        CHECK(sum == 499500);
+    }
+}
+
+TEST_SUITE("rsbl::Hash")
+{
+    TEST_CASE("HashBytes is deterministic and size sensitive")
+    {
+        const char data[] = "the quick brown fox";
+        CHECK(HashBytes(data, sizeof(data)) == HashBytes(data, sizeof(data)));
+        CHECK(HashBytes(data, 4) != HashBytes(data, 5));
+        CHECK(HashBytes(data, 4, 1) != HashBytes(data, 4, 2));
+        CHECK(HashString("abc") == HashBytes("abc", 3));
+    }
+}
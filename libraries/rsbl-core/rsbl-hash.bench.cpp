@@ -0,0 +1,97 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// HashBytes throughput from map keys to asset blobs, against a HashMix per 8 bytes (the loop
+// HashBytes used to be), plus the bulk stripe kernel at every SIMD level this CPU runs.
+
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-hash.h"
+#include "rsbl-wide-kernels.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+// Bytes hashed per measurement, so every size runs about as long. Each hash seeds the next, so
+// short sizes measure latency, as a hash map lookup would see it.
+constexpr uint64 kBytesPerRun = 64ull << 20;
+
+// Stop the optimizer from folding the loops away
+volatile uint64 s_sink = 0;
+
+uint64 HashMixPerWord(const uint8* bytes, uint64 size, uint64 seed)
+{
+    uint64 hash = seed ^ (size * 0x9e3779b97f4a7c15ull);
+    for (; size >= 8; bytes += 8, size -= 8)
+    {
+        uint64 word;
+        memcpy(&word, bytes, sizeof(word));
+        hash = (hash ^ HashMix(word)) * 0x9e3779b97f4a7c15ull;
+    }
+    uint64 tail = 0;
+    memcpy(&tail, bytes, size);
+    return HashMix(hash ^ HashMix(tail));
+}
+
+template <typename F>
+void Time(const char* name, uint64 size, F&& f)
+{
+    const uint64 repeats = kBytesPerRun / size;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64 repeat = 0; repeat < repeats; ++repeat)
+    {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(end - start).count() / repeats;
+    printf("  %-32s %10.1f ns  (%6.2f GB/s)\n", name, ns, size / ns);
+}
+} // namespace
+
+int main()
+{
+    DynamicArray<uint8> bytes;
+    bytes.Resize(16ull << 20);
+    uint64 state = 1;
+    for (uint8& byte : bytes)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        byte = static_cast<uint8>(state >> 56);
+    }
+
+    for (const uint64 size : {8ull, 32ull, 128ull, 1ull << 10, 64ull << 10, 16ull << 20})
+    {
+        printf("%llu bytes\n", static_cast<unsigned long long>(size));
+        Time("HashBytes", size, [&]() { s_sink = HashBytes(bytes.Data(), size, s_sink); });
+        Time("HashMix per word", size,
+             [&]() { s_sink = HashMixPerWord(bytes.Data(), size, s_sink); });
+    }
+
+    printf("hashStripes over 64 KB\n");
+    uint64 keys[16 + 7] = {};
+    for (uint32 level = 0; level < static_cast<uint32>(SimdLevel::Count); ++level)
+    {
+        const Internal::WideKernels* kernels =
+            Internal::GetWideKernels(static_cast<SimdLevel>(level));
+        if (kernels == nullptr)
+        {
+            continue;
+        }
+
+        Time(SimdLevelName(kernels->level), 64 << 10, [&]() {
+            uint64 accumulators[8] = {};
+            for (uint64 block = 0; block < (64 << 10) / 1024; ++block)
+            {
+                kernels->hashStripes(accumulators, bytes.Data() + block * 1024, 16, keys);
+            }
+            s_sink = accumulators[0];
+        });
+    }
+
+    return 0;
+}
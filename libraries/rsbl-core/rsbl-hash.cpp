@@ -0,0 +1,191 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-hash.h"
+
+#include "rsbl-wide-kernels.h"
+
+#include <cstring>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+// Short inputs follow wyhash: a few loads folded through 64x64 -> 128 bit multiplies. Long ones
+// follow the xxh3 long loop: 8 accumulator lanes, each taking a 32x32 -> 64 bit multiply per 8
+// bytes, which vectorizes on every instruction set (rsbl-wide-kernels.h). Every kilobyte the
+// accumulators get scrambled, and at the end they're folded down to 64 bits.
+// Not the reference wyhash or xxh3 values, but the same on every platform and SIMD level.
+
+namespace
+{
+constexpr uint64 kHashMultiplier = 0x9e3779b97f4a7c15ull;
+
+// Longer inputs than this take the bulk loop
+constexpr uint64 kShortLimit = 256;
+
+constexpr uint64 kStripeSize = 64;
+constexpr uint64 kStripesPerBlock = 16;
+constexpr uint64 kBlockSize = kStripeSize * kStripesPerBlock;
+
+// Key words, from splitmix64. The bulk loop slides an 8 word window one word per stripe over the
+// first kStripesPerBlock + 7. The rest each have one use below.
+struct HashKeys
+{
+    uint64 words[64];
+};
+
+constexpr HashKeys MakeHashKeys()
+{
+    HashKeys keys{};
+    uint64 state = 0x243f6a8885a308d3ull;
+    for (uint64& word : keys.words)
+    {
+        state += kHashMultiplier;
+        uint64 z = state;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        word = z ^ (z >> 31);
+    }
+    return keys;
+}
+
+constexpr HashKeys kKeys = MakeHashKeys();
+constexpr const uint64* kStripeKeys = kKeys.words;
+constexpr const uint64* kLastStripeKeys = kKeys.words + 24;
+constexpr const uint64* kScrambleKeys = kKeys.words + 32;
+constexpr const uint64* kStartKeys = kKeys.words + 40;
+constexpr const uint64* kFoldKeys = kKeys.words + 48;
+constexpr const uint64* kShortKeys = kKeys.words + 56;
+
+uint64 Read64(const uint8* bytes)
+{
+    uint64 value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+uint64 Read32(const uint8* bytes)
+{
+    uint32 value;
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+// Full 128 bit product, halves xored together
+uint64 MultiplyFold(uint64 a, uint64 b)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    uint64 high;
+    const uint64 low = _umul128(a, b, &high);
+    return low ^ high;
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    return (a * b) ^ __umulh(a, b);
+#else
+    const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64>(product) ^ static_cast<uint64>(product >> 64);
+#endif
+}
+
+uint64 HashShort(const uint8* bytes, uint64 size, uint64 seed)
+{
+    uint64 hash = seed ^ kShortKeys[0];
+    uint64 a = 0;
+    uint64 b = 0;
+    if (size <= 16)
+    {
+        if (size >= 4)
+        {
+            // Two overlapping pairs of 4 byte reads cover 4 to 16 bytes
+            const uint64 step = (size >> 3) << 2;
+            a = (Read32(bytes) << 32) | Read32(bytes + step);
+            b = (Read32(bytes + size - 4) << 32) | Read32(bytes + size - 4 - step);
+        }
+        else if (size > 0)
+        {
+            a = (static_cast<uint64>(bytes[0]) << 16) |
+                (static_cast<uint64>(bytes[size >> 1]) << 8) | bytes[size - 1];
+        }
+    }
+    else
+    {
+        // Two independent chains over 32 byte runs, then the last 16 bytes, overlapping the
+        // previous run when size isn't a multiple
+        uint64 other = seed ^ kShortKeys[1];
+        uint64 remaining = size;
+        while (remaining > 32)
+        {
+            hash = MultiplyFold(Read64(bytes) ^ kShortKeys[2], Read64(bytes + 8) ^ hash);
+            other = MultiplyFold(Read64(bytes + 16) ^ kShortKeys[3], Read64(bytes + 24) ^ other);
+            bytes += 32;
+            remaining -= 32;
+        }
+        if (remaining > 16)
+        {
+            hash = MultiplyFold(Read64(bytes) ^ kShortKeys[2], Read64(bytes + 8) ^ hash);
+        }
+        hash ^= other;
+        a = Read64(bytes + remaining - 16);
+        b = Read64(bytes + remaining - 8);
+    }
+
+    return rsbl::HashMix(MultiplyFold(a ^ kShortKeys[4], b ^ hash) ^ (size * kHashMultiplier));
+}
+
+uint64 HashLong(const uint8* bytes, uint64 size, uint64 seed)
+{
+    const rsbl::Internal::WideKernels& kernels = rsbl::Internal::GetWideKernels();
+
+    uint64 accumulators[8];
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        accumulators[i] = kStartKeys[i] ^ (seed + i * kHashMultiplier);
+    }
+
+    // Whole blocks, leaving at least one byte for the tail
+    const uint64 block_count = (size - 1) / kBlockSize;
+    for (uint64 block = 0; block < block_count; ++block)
+    {
+        kernels.hashStripes(accumulators, bytes + block * kBlockSize, kStripesPerBlock,
+                            kStripeKeys);
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            uint64 value = accumulators[i];
+            value ^= value >> 47;
+            value ^= kScrambleKeys[i];
+            // 32 bit prime, as in xxh3
+            accumulators[i] = value * 0x9e3779b1ull;
+        }
+    }
+
+    // The whole stripes left, then the last 64 bytes, overlapping them
+    const uint64 tail_start = block_count * kBlockSize;
+    const uint64 stripe_count = (size - 1 - tail_start) / kStripeSize;
+    kernels.hashStripes(accumulators, bytes + tail_start, stripe_count, kStripeKeys);
+    kernels.hashStripes(accumulators, bytes + size - kStripeSize, 1, kLastStripeKeys);
+
+    uint64 hash = size * kHashMultiplier;
+    for (uint32 i = 0; i < 8; i += 2)
+    {
+        hash += MultiplyFold(accumulators[i] ^ kFoldKeys[i],
+                             accumulators[i + 1] ^ kFoldKeys[i + 1]);
+    }
+    return rsbl::HashMix(hash);
+}
+} // namespace
+
+namespace rsbl
+{
+
+uint64 HashBytes(const void* data, uint64 size, uint64 seed)
+{
+    const uint8* bytes = static_cast<const uint8*>(data);
+    return size <= kShortLimit ? HashShort(bytes, size, seed) : HashLong(bytes, size, seed);
+}
+
+uint64 HashString(const char* str, uint64 seed)
+{
+    return HashBytes(str, strlen(str), seed);
+}
+
+} // namespace rsbl
@@ -0,0 +1,163 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-bits.h"
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-hash.h"
+#include "include/rsbl-sort.h"
+#include "rsbl-wide-kernels.h"
+
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+// Deterministic bytes
+DynamicArray<uint8> MakeBytes(uint64 size)
+{
+    DynamicArray<uint8> bytes;
+    bytes.Resize(size);
+    uint64 state = 3;
+    for (uint8& byte : bytes)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        byte = static_cast<uint8>(state >> 56);
+    }
+    return bytes;
+}
+
+// Sizes around every path boundary: the short reads, the 32 byte runs, the bulk loop's stripes
+// and blocks
+constexpr uint64 kSizes[] = {0,   1,   2,   3,   4,    7,    8,    9,    15,   16,   17,
+                             31,  32,  33,  63,  64,   65,   128,  255,  256,  257,  319,
+                             320, 321, 511, 512, 1023, 1024, 1025, 1088, 2048, 2049, 5000};
+} // namespace
+
+TEST_SUITE("rsbl::Hash")
+{
+    TEST_CASE("Pinned values")
+    {
+        // The values are part of the interface, they key caches that outlive a build. Changing
+        // the algorithm means invalidating those.
+        const DynamicArray<uint8> bytes = MakeBytes(5000);
+        CHECK(HashBytes(nullptr, 0) == 0x1ba157954aea51d2ull);
+        CHECK(HashBytes(bytes.Data(), 3) == 0x114f4d62114d6ec4ull);
+        CHECK(HashBytes(bytes.Data(), 16) == 0x11bae4c512229737ull);
+        CHECK(HashBytes(bytes.Data(), 100) == 0x4fd4e431f7f7c664ull);
+        CHECK(HashBytes(bytes.Data(), 5000) == 0xf2578b6e5f881f5full);
+        CHECK(HashBytes(bytes.Data(), 5000, 42) == 0x6da6d42808abdfd2ull);
+    }
+
+    TEST_CASE("Every size and seed hashes differently")
+    {
+        const DynamicArray<uint8> bytes = MakeBytes(5000);
+        DynamicArray<uint64> hashes;
+        for (uint64 size = 0; size <= 2100; ++size)
+        {
+            hashes.PushBack(HashBytes(bytes.Data(), size));
+            hashes.PushBack(HashBytes(bytes.Data(), size, 1));
+        }
+        RadixSort(ArrayView<uint64>(hashes));
+        for (uint64 i = 1; i < hashes.Size(); ++i)
+        {
+            REQUIRE(hashes[i] != hashes[i - 1]);
+        }
+    }
+
+    TEST_CASE("Every input bit matters")
+    {
+        for (const uint64 size : kSizes)
+        {
+            CAPTURE(size);
+            DynamicArray<uint8> bytes = MakeBytes(size);
+            const uint64 hash = HashBytes(bytes.Data(), size);
+            for (uint64 bit = 0; bit < size * 8; bit += size > 100 ? 13 : 1)
+            {
+                CAPTURE(bit);
+                bytes[bit / 8] ^= static_cast<uint8>(1u << (bit % 8));
+                const uint64 flipped = HashBytes(bytes.Data(), size);
+                bytes[bit / 8] ^= static_cast<uint8>(1u << (bit % 8));
+                REQUIRE(flipped != hash);
+                // The change reaches a good share of the output bits
+                REQUIRE(PopCount64(flipped ^ hash) >= 8);
+            }
+        }
+    }
+
+    TEST_CASE("Alignment doesn't matter")
+    {
+        const DynamicArray<uint8> bytes = MakeBytes(5000);
+        DynamicArray<uint8> shifted;
+        shifted.Resize(bytes.Size() + 7);
+        for (const uint64 size : kSizes)
+        {
+            CAPTURE(size);
+            const uint64 expected = HashBytes(bytes.Data(), size);
+            for (uint64 offset = 1; offset < 8; ++offset)
+            {
+                memcpy(shifted.Data() + offset, bytes.Data(), size);
+                REQUIRE(HashBytes(shifted.Data() + offset, size) == expected);
+            }
+        }
+    }
+
+    TEST_CASE("Wide kernels match the scalar stripe loop")
+    {
+        constexpr uint64 kStripes = 37;
+        const DynamicArray<uint8> bytes = MakeBytes(kStripes * 64 + 3);
+        uint64 keys[kStripes + 7];
+        for (uint64 i = 0; i < kStripes + 7; ++i)
+        {
+            keys[i] = HashMix(i + 1);
+        }
+
+        // Reference, from unaligned data
+        uint64 expected[8];
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            expected[i] = i * 1000;
+        }
+        for (uint64 s = 0; s < kStripes; ++s)
+        {
+            uint64 input[8];
+            memcpy(input, bytes.Data() + 3 + s * 64, sizeof(input));
+            for (uint32 i = 0; i < 8; ++i)
+            {
+                const uint64 mixed = input[i] ^ keys[s + i];
+                expected[i] += input[i ^ 1] + (mixed & 0xffffffffull) * (mixed >> 32);
+            }
+        }
+
+        for (uint32 level = 0; level < static_cast<uint32>(SimdLevel::Count); ++level)
+        {
+            const Internal::WideKernels* kernels =
+                Internal::GetWideKernels(static_cast<SimdLevel>(level));
+            if (kernels == nullptr)
+            {
+                continue;
+            }
+            CAPTURE(SimdLevelName(kernels->level));
+
+            uint64 accumulators[8];
+            for (uint32 i = 0; i < 8; ++i)
+            {
+                accumulators[i] = i * 1000;
+            }
+            kernels->hashStripes(accumulators, bytes.Data() + 3, kStripes, keys);
+            for (uint32 i = 0; i < 8; ++i)
+            {
+                CHECK(accumulators[i] == expected[i]);
+            }
+        }
+    }
+
+    TEST_CASE("Combine is order sensitive")
+    {
+        CHECK(HashCombine(HashCombine(0, 1), 2) != HashCombine(HashCombine(0, 2), 1));
+        CHECK(HashCombine(0, 0) != 0);
+    }
+}
@@ -0,0 +1,599 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-compression.h"
+
+#include <cstring>
+
+// A deflate stream is a run of blocks, each stored, or Huffman coded with either the fixed codes
+// or codes described at the start of the block. Symbols are literals, the end of the block, or
+// lengths followed by a distance back into the output. Bits are packed from the low bit of each
+// byte up, while Huffman codes go most significant bit first, so the lookup tables are indexed by
+// codes bit reversed.
+
+namespace rsbl
+{
+
+namespace
+{
+// Codes up to this long decode with one table lookup, longer ones a bit at a time
+constexpr uint32 kFastBits = 10;
+
+constexpr uint32 kMaxCodeLength = 15;
+constexpr uint32 kLiteralCodes = 288;
+constexpr uint32 kDistanceCodes = 32;
+constexpr uint32 kEndOfBlock = 256;
+
+constexpr uint16 kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8 kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16 kDistanceBase[30] = {
+    1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8 kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                      6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Order the code length code lengths are stored in
+constexpr uint8 kCodeLengthOrder[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// Reads bits low first out of a 64 bit buffer. Reading past the end feeds in zeros and counts
+// them, so decoding never branches on the end, and the padding is checked for once a block is
+// done instead.
+class BitReader
+{
+  public:
+    BitReader(const uint8* data, uint64 size)
+        : m_data(data)
+        , m_end(data + size)
+    {
+    }
+
+    // At least 56 bits in the buffer after this
+    void Refill()
+    {
+        if (m_end - m_data >= 8)
+        {
+            uint64 word;
+            std::memcpy(&word, m_data, sizeof(word));
+            m_buffer |= word << m_count;
+            m_data += (63 - m_count) >> 3;
+            m_count |= 56;
+            return;
+        }
+        while (m_count <= 56)
+        {
+            if (m_data < m_end)
+            {
+                m_buffer |= static_cast<uint64>(*m_data++) << m_count;
+            }
+            else
+            {
+                m_padding += 8;
+            }
+            m_count += 8;
+        }
+    }
+
+    // Up to 56 bits, after a Refill
+    uint32 Peek(uint32 bits) const
+    {
+        return static_cast<uint32>(m_buffer & ((1ull << bits) - 1));
+    }
+
+    void Consume(uint32 bits)
+    {
+        m_buffer >>= bits;
+        m_count -= bits;
+    }
+
+    uint32 Read(uint32 bits)
+    {
+        if (m_count < bits)
+        {
+            Refill();
+        }
+        const uint32 value = Peek(bits);
+        Consume(bits);
+        return value;
+    }
+
+    void AlignToByte()
+    {
+        Consume(m_count & 7);
+    }
+
+    // True once bits past the end of the data have been used
+    bool Overran() const
+    {
+        return m_count < m_padding;
+    }
+
+    // Whole bytes left, in the buffer and after it, once byte aligned
+    uint64 BytesLeft() const
+    {
+        return (m_count - m_padding) / 8 + static_cast<uint64>(m_end - m_data);
+    }
+
+    // Copies out whole bytes, the buffered ones first. The caller checks BytesLeft.
+    void CopyBytes(uint8* out, uint64 size)
+    {
+        while (size > 0 && m_count >= 8)
+        {
+            *out++ = static_cast<uint8>(Read(8));
+            --size;
+        }
+        if (size == 0)
+        {
+            return;
+        }
+        // The buffer is empty but can still hold the look ahead from the last refill, which
+        // would be ORed into whatever follows the bytes skipped here
+        m_buffer = 0;
+        std::memcpy(out, m_data, size);
+        m_data += size;
+    }
+
+  private:
+    const uint8* m_data;
+    const uint8* m_end;
+    uint64 m_buffer = 0;
+    uint32 m_count = 0;
+    uint32 m_padding = 0;
+};
+
+struct HuffmanTable
+{
+    // (length << 9) | symbol for codes up to kFastBits long, 0 where the code is longer
+    uint16 fast[1 << kFastBits];
+    uint16 counts[kMaxCodeLength + 1];
+    // Symbols ordered by code
+    uint16 symbols[kLiteralCodes];
+};
+
+uint32 ReverseBits(uint32 code, uint32 length)
+{
+    uint32 reversed = 0;
+    for (uint32 i = 0; i < length; ++i)
+    {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    return reversed;
+}
+
+// Fails for lengths that make more codes than there are bit patterns. Incomplete codes are
+// allowed, a stream that only ever uses one distance has a one code tree.
+bool BuildHuffman(HuffmanTable& table, const uint8* lengths, uint32 count)
+{
+    std::memset(table.counts, 0, sizeof(table.counts));
+    for (uint32 i = 0; i < count; ++i)
+    {
+        ++table.counts[lengths[i]];
+    }
+    table.counts[0] = 0;
+
+    int32 left = 1;
+    for (uint32 length = 1; length <= kMaxCodeLength; ++length)
+    {
+        left = (left << 1) - table.counts[length];
+        if (left < 0)
+        {
+            return false;
+        }
+    }
+
+    uint16 offsets[kMaxCodeLength + 2] = {};
+    uint32 next_code[kMaxCodeLength + 1] = {};
+    uint32 code = 0;
+    for (uint32 length = 1; length <= kMaxCodeLength; ++length)
+    {
+        offsets[length + 1] = static_cast<uint16>(offsets[length] + table.counts[length]);
+        code = (code + table.counts[length - 1]) << 1;
+        next_code[length] = code;
+    }
+
+    std::memset(table.fast, 0, sizeof(table.fast));
+    for (uint32 symbol = 0; symbol < count; ++symbol)
+    {
+        const uint32 length = lengths[symbol];
+        if (length == 0)
+        {
+            continue;
+        }
+        table.symbols[offsets[length]++] = static_cast<uint16>(symbol);
+
+        const uint32 symbol_code = next_code[length]++;
+        if (length <= kFastBits)
+        {
+            const uint16 entry = static_cast<uint16>((length << 9) | symbol);
+            for (uint32 i = ReverseBits(symbol_code, length); i < (1u << kFastBits);
+                 i += 1u << length)
+            {
+                table.fast[i] = entry;
+            }
+        }
+    }
+    return true;
+}
+
+// The next symbol, or -1 for a code that isn't in the table
+int32 Decode(BitReader& bits, const HuffmanTable& table)
+{
+    bits.Refill();
+    const uint16 entry = table.fast[bits.Peek(kFastBits)];
+    if (entry != 0)
+    {
+        bits.Consume(entry >> 9);
+        return entry & 511;
+    }
+
+    // Canonical codes of the same length are consecutive, walk the lengths past the fast ones
+    int32 code = 0;
+    int32 first = 0;
+    int32 index = 0;
+    for (uint32 length = 1; length <= kMaxCodeLength; ++length)
+    {
+        code |= static_cast<int32>(bits.Read(1));
+        const int32 count = table.counts[length];
+        if (code - first < count)
+        {
+            return table.symbols[index + code - first];
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+class Inflater
+{
+  public:
+    Inflater(ByteView src, MutableByteView dst)
+        : m_bits(src.Data(), src.Size())
+        , m_start(dst.Data())
+        , m_out(dst.Data())
+        , m_end(dst.Data() + dst.Size())
+    {
+    }
+
+    Result<uint64> Run()
+    {
+        bool last = false;
+        while (!last)
+        {
+            last = m_bits.Read(1) != 0;
+            const uint32 type = m_bits.Read(2);
+            Result<> block = ResultCode::Success;
+            switch (type)
+            {
+            case 0:
+                block = Stored();
+                break;
+            case 1:
+                BuildFixed();
+                block = Codes();
+                break;
+            case 2:
+                block = Dynamic();
+                if (block)
+                {
+                    block = Codes();
+                }
+                break;
+            default:
+                return {ErrorCategory::InvalidArgument, "Deflate block of an unknown type"};
+            }
+            if (!block)
+            {
+                return PendingFailure{block.Category()};
+            }
+            if (m_bits.Overran())
+            {
+                return {ErrorCategory::InvalidArgument, "Deflate stream ends mid-block"};
+            }
+        }
+        return static_cast<uint64>(m_out - m_start);
+    }
+
+    BitReader& Bits()
+    {
+        return m_bits;
+    }
+
+  private:
+    Result<> Stored()
+    {
+        m_bits.AlignToByte();
+        const uint32 length = m_bits.Read(16);
+        const uint32 inverse = m_bits.Read(16);
+        if (m_bits.Overran())
+        {
+            return {ErrorCategory::InvalidArgument, "Deflate stream ends mid-block"};
+        }
+        if ((length ^ 0xffff) != inverse)
+        {
+            return {ErrorCategory::InvalidArgument, "Stored deflate block has a bad length"};
+        }
+        if (length > m_bits.BytesLeft())
+        {
+            return {ErrorCategory::InvalidArgument, "Stored deflate block runs past the end"};
+        }
+        if (length > static_cast<uint64>(m_end - m_out))
+        {
+            return {ErrorCategory::InvalidArgument, "Deflate output doesn't fit"};
+        }
+        m_bits.CopyBytes(m_out, length);
+        m_out += length;
+        return ResultCode::Success;
+    }
+
+    void BuildFixed()
+    {
+        m_literals = &m_fixedLiterals;
+        m_distances = &m_fixedDistances;
+        if (m_fixedBuilt)
+        {
+            return;
+        }
+        uint8 lengths[kLiteralCodes + kDistanceCodes];
+        std::memset(lengths, 8, 144);
+        std::memset(lengths + 144, 9, 112);
+        std::memset(lengths + 256, 7, 24);
+        std::memset(lengths + 280, 8, 8);
+        std::memset(lengths + kLiteralCodes, 5, kDistanceCodes);
+        BuildHuffman(m_fixedLiterals, lengths, kLiteralCodes);
+        BuildHuffman(m_fixedDistances, lengths + kLiteralCodes, kDistanceCodes);
+        m_fixedBuilt = true;
+    }
+
+    Result<> Dynamic()
+    {
+        const uint32 literal_count = m_bits.Read(5) + 257;
+        const uint32 distance_count = m_bits.Read(5) + 1;
+        const uint32 code_length_count = m_bits.Read(4) + 4;
+        if (literal_count > 286 || distance_count > 30)
+        {
+            return {ErrorCategory::InvalidArgument, "Deflate block has too many codes"};
+        }
+
+        uint8 code_lengths[19] = {};
+        for (uint32 i = 0; i < code_length_count; ++i)
+        {
+            code_lengths[kCodeLengthOrder[i]] = static_cast<uint8>(m_bits.Read(3));
+        }
+        // Built into the literal table, which isn't needed until the lengths are read
+        HuffmanTable& code_length_table = m_dynamicLiterals;
+        if (!BuildHuffman(code_length_table, code_lengths, 19))
+        {
+            return {ErrorCategory::InvalidArgument, "Deflate code length codes are invalid"};
+        }
+
+        // Literal and distance lengths are one run, repeats can cross from one to the other
+        uint8 lengths[kLiteralCodes + kDistanceCodes] = {};
+        const uint32 total = literal_count + distance_count;
+        uint32 index = 0;
+        while (index < total)
+        {
+            const int32 symbol = Decode(m_bits, code_length_table);
+            if (symbol < 0)
+            {
+                return {ErrorCategory::InvalidArgument, "Deflate code lengths are corrupt"};
+            }
+            if (symbol < 16)
+            {
+                lengths[index++] = static_cast<uint8>(symbol);
+                continue;
+            }
+
+            uint8 value = 0;
+            uint32 repeat = 0;
+            if (symbol == 16)
+            {
+                if (index == 0)
+                {
+                    return {ErrorCategory::InvalidArgument, "Deflate repeats a missing length"};
+                }
+                value = lengths[index - 1];
+                repeat = 3 + m_bits.Read(2);
+            }
+            else if (symbol == 17)
+            {
+                repeat = 3 + m_bits.Read(3);
+            }
+            else
+            {
+                repeat = 11 + m_bits.Read(7);
+            }
+            if (index + repeat > total)
+            {
+                return {ErrorCategory::InvalidArgument, "Deflate code lengths run over"};
+            }
+            std::memset(lengths + index, value, repeat);
+            index += repeat;
+        }
+
+        if (lengths[kEndOfBlock] == 0)
+        {
+            return {ErrorCategory::InvalidArgument, "Deflate block has no end code"};
+        }
+        if (!BuildHuffman(m_dynamicLiterals, lengths, literal_count) ||
+            !BuildHuffman(m_dynamicDistances, lengths + literal_count, distance_count))
+        {
+            return {ErrorCategory::InvalidArgument, "Deflate codes are invalid"};
+        }
+        m_literals = &m_dynamicLiterals;
+        m_distances = &m_dynamicDistances;
+        return ResultCode::Success;
+    }
+
+    Result<> Codes()
+    {
+        const HuffmanTable& literals = *m_literals;
+        const HuffmanTable& distances = *m_distances;
+        for (;;)
+        {
+            const int32 symbol = Decode(m_bits, literals);
+            if (symbol < 256)
+            {
+                if (symbol < 0)
+                {
+                    return {ErrorCategory::InvalidArgument, "Deflate literal code is invalid"};
+                }
+                if (m_out == m_end)
+                {
+                    return {ErrorCategory::InvalidArgument, "Deflate output doesn't fit"};
+                }
+                *m_out++ = static_cast<uint8>(symbol);
+                continue;
+            }
+            if (symbol == kEndOfBlock)
+            {
+                return ResultCode::Success;
+            }
+
+            const uint32 length_code = static_cast<uint32>(symbol) - 257;
+            if (length_code >= 29)
+            {
+                return {ErrorCategory::InvalidArgument, "Deflate length code is invalid"};
+            }
+            const uint64 length = kLengthBase[length_code] + m_bits.Read(kLengthExtra[length_code]);
+
+            const int32 distance_code = Decode(m_bits, distances);
+            if (distance_code < 0 || distance_code >= 30)
+            {
+                return {ErrorCategory::InvalidArgument, "Deflate distance code is invalid"};
+            }
+            const uint64 distance =
+                kDistanceBase[distance_code] + m_bits.Read(kDistanceExtra[distance_code]);
+
+            if (distance > static_cast<uint64>(m_out - m_start))
+            {
+                return {ErrorCategory::InvalidArgument, "Deflate match reaches before the start"};
+            }
+            if (length > static_cast<uint64>(m_end - m_out))
+            {
+                return {ErrorCategory::InvalidArgument, "Deflate output doesn't fit"};
+            }
+            Copy(distance, length);
+        }
+    }
+
+    void Copy(uint64 distance, uint64 length)
+    {
+        const uint8* match = m_out - distance;
+        uint8* out = m_out;
+        m_out += length;
+
+        // 8 bytes at a time when the match is at least that far back, so each step only reads
+        // bytes already written, with room left over for the last step to write past the match
+        if (distance >= 8 && static_cast<uint64>(m_end - out) >= length + 8)
+        {
+            while (out < m_out)
+            {
+                uint64 word;
+                std::memcpy(&word, match, sizeof(word));
+                std::memcpy(out, &word, sizeof(word));
+                out += 8;
+                match += 8;
+            }
+            return;
+        }
+        // Overlapping, a short distance repeats the bytes just written
+        while (out < m_out)
+        {
+            *out++ = *match++;
+        }
+    }
+
+    BitReader m_bits;
+    uint8* m_start;
+    uint8* m_out;
+    uint8* m_end;
+
+    // Whichever of the fixed or dynamic tables the current block uses
+    const HuffmanTable* m_literals = nullptr;
+    const HuffmanTable* m_distances = nullptr;
+    HuffmanTable m_dynamicLiterals;
+    HuffmanTable m_dynamicDistances;
+    HuffmanTable m_fixedLiterals;
+    HuffmanTable m_fixedDistances;
+    bool m_fixedBuilt = false;
+};
+
+uint32 Adler32(const uint8* data, uint64 size)
+{
+    // Sums stay under 2^32 for this many bytes before they need reducing
+    constexpr uint64 kMaxRun = 5552;
+    constexpr uint32 kModulus = 65521;
+
+    uint32 a = 1;
+    uint32 b = 0;
+    while (size > 0)
+    {
+        const uint64 run = size < kMaxRun ? size : kMaxRun;
+        for (uint64 i = 0; i < run; ++i)
+        {
+            a += data[i];
+            b += a;
+        }
+        a %= kModulus;
+        b %= kModulus;
+        data += run;
+        size -= run;
+    }
+    return (b << 16) | a;
+}
+} // namespace
+
+Result<uint64> InflateDecompress(ByteView src, MutableByteView dst)
+{
+    Inflater inflater(src, dst);
+    return inflater.Run();
+}
+
+Result<uint64> ZlibDecompress(ByteView src, MutableByteView dst)
+{
+    if (src.Size() < 6)
+    {
+        return {ErrorCategory::InvalidArgument, "Too small to be a zlib stream"};
+    }
+    const uint8 method = src[0];
+    const uint8 flags = src[1];
+    if ((method & 15) != 8 || (method >> 4) > 7 || ((method << 8) | flags) % 31 != 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Not a zlib deflate stream"};
+    }
+    if (flags & 0x20)
+    {
+        return {ErrorCategory::InvalidArgument, "zlib preset dictionaries aren't supported"};
+    }
+
+    Inflater inflater(ByteView(src.Data() + 2, src.Size() - 2), dst);
+    Result<uint64> size = inflater.Run();
+    if (!size)
+    {
+        return size;
+    }
+
+    // The checksum follows the last block, byte aligned and big endian
+    BitReader& bits = inflater.Bits();
+    bits.AlignToByte();
+    if (bits.Overran() || bits.BytesLeft() < 4)
+    {
+        return {ErrorCategory::InvalidArgument, "zlib stream is missing its checksum"};
+    }
+    uint32 expected = 0;
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        expected = (expected << 8) | bits.Read(8);
+    }
+    if (Adler32(dst.Data(), size.Value()) != expected)
+    {
+        return {ErrorCategory::InvalidArgument, "zlib checksum doesn't match"};
+    }
+    return size;
+}
+
+} // namespace rsbl
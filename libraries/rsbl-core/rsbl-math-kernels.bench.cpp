@@ -0,0 +1,543 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// The math kernels side by side: a plain scalar loop, then every build of the wide kernel the
+// CPU can run (the SSE2 or NEON baseline, AVX2, AVX-512), which is what GetWideKernels picks
+// between. Matrix multiply and slerp have no wide kernels, so they compare the scalar loop with
+// the float4 code built for the compile-time instruction set. Every variant's output is checked
+// against the scalar loop's, and a mismatch fails the run, smoke runs included.
+
+#include "include/rsbl-bounds.h"
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-matrix.h"
+#include "include/rsbl-packing.h"
+#include "rsbl-wide-kernels.h"
+
+#include <rsbl-bench.h>
+
+#include <cmath>
+#include <cstdio>
+
+using namespace rsbl;
+
+namespace
+{
+// Odd, so every kernel's tail runs too
+constexpr uint64 kCount = 10'007;
+constexpr uint64 kMatrixCount = 4'093;
+
+#if RSBL_SIMD_SSE
+constexpr const char* kFloat4Name = "float4, SSE";
+#elif RSBL_SIMD_NEON
+constexpr const char* kFloat4Name = "float4, NEON";
+#else
+constexpr const char* kFloat4Name = "float4, scalar";
+#endif
+
+uint64 s_random = 1;
+
+float RandomFloat(float low, float high)
+{
+    s_random = s_random * 6364136223846793005ull + 1442695040888963407ull;
+    return low + (high - low) * static_cast<float>(s_random >> 40) / 16777216.0f;
+}
+
+// Counts the variants whose output isn't the scalar loop's
+class CrossCheck
+{
+  public:
+    // Within tolerance of expected, relative to it once it's over 1
+    void Floats(const char* name, const DynamicArray<float>& expected,
+                const DynamicArray<float>& actual, float tolerance)
+    {
+        for (uint64 i = 0; i < expected.Size(); ++i)
+        {
+            if (actual[i] == expected[i])
+            {
+                continue; // Infinities too
+            }
+            const float scale = fabsf(expected[i]) > 1.0f ? fabsf(expected[i]) : 1.0f;
+            if (!(fabsf(actual[i] - expected[i]) <= tolerance * scale))
+            {
+                Fail(name, i);
+                return;
+            }
+        }
+    }
+
+    void Halves(const char* name, const DynamicArray<uint16>& expected,
+                const DynamicArray<uint16>& actual)
+    {
+        for (uint64 i = 0; i < expected.Size(); ++i)
+        {
+            if (actual[i] != expected[i])
+            {
+                Fail(name, i);
+                return;
+            }
+        }
+    }
+
+    // Objects within a rounding error of a plane can come out either way
+    void Visibility(const char* name, const DynamicArray<uint64>& expected,
+                    const DynamicArray<uint64>& actual, const DynamicArray<float>& margins)
+    {
+        for (uint64 i = 0; i < margins.Size(); ++i)
+        {
+            const bool want = (expected[i / 64] >> (i % 64)) & 1;
+            const bool got = (actual[i / 64] >> (i % 64)) & 1;
+            if (want != got && fabsf(margins[i]) > 1e-3f)
+            {
+                Fail(name, i);
+                return;
+            }
+        }
+    }
+
+    uint32 Failures() const
+    {
+        return m_failures;
+    }
+
+  private:
+    void Fail(const char* name, uint64 index)
+    {
+        printf("  MISMATCH: %s differs from the scalar loop at %llu\n", name,
+               static_cast<unsigned long long>(index));
+        ++m_failures;
+    }
+
+    uint32 m_failures = 0;
+};
+
+// The wide kernels this CPU can run, narrowest first
+DynamicArray<const Internal::WideKernels*> RunnableKernels()
+{
+    DynamicArray<const Internal::WideKernels*> kernels;
+    for (uint32 level = 0; level < static_cast<uint32>(SimdLevel::Count); ++level)
+    {
+        if (const Internal::WideKernels* found =
+                Internal::GetWideKernels(static_cast<SimdLevel>(level)))
+        {
+            kernels.PushBack(found);
+        }
+    }
+    return kernels;
+}
+
+const char* KernelName(const Internal::WideKernels* kernels)
+{
+    static char s_name[32];
+    snprintf(s_name, sizeof(s_name), "%s, %u lanes", SimdLevelName(kernels->level),
+             kernels->width);
+    return s_name;
+}
+
+DynamicArray<float> RandomFloats(uint64 count, float low, float high)
+{
+    DynamicArray<float> values;
+    values.Resize(count);
+    for (float& value : values)
+    {
+        value = RandomFloat(low, high);
+    }
+    return values;
+}
+
+void MatrixMultiplySuite(Bench& bench, CrossCheck& check)
+{
+    bench.Section("Matrix multiply, 4x4");
+    DynamicArray<float> a = RandomFloats(kMatrixCount * 16, -2.0f, 2.0f);
+    DynamicArray<float> b = RandomFloats(kMatrixCount * 16, -2.0f, 2.0f);
+    DynamicArray<float> expected;
+    DynamicArray<float> out;
+    expected.Resize(kMatrixCount * 16);
+    out.Resize(kMatrixCount * 16);
+    const BenchConfig config = {.bytes = kMatrixCount * 48 * sizeof(float), .items = kMatrixCount};
+
+    const auto scalar = [&]() {
+        for (uint64 m = 0; m < kMatrixCount; ++m)
+        {
+            const float* ma = a.Data() + m * 16;
+            const float* mb = b.Data() + m * 16;
+            float* mo = expected.Data() + m * 16;
+            for (uint32 column = 0; column < 4; ++column)
+            {
+                for (uint32 row = 0; row < 4; ++row)
+                {
+                    float sum = 0.0f;
+                    for (uint32 k = 0; k < 4; ++k)
+                    {
+                        sum += ma[k * 4 + row] * mb[column * 4 + k];
+                    }
+                    mo[column * 4 + row] = sum;
+                }
+            }
+        }
+        DoNotOptimize(expected[0]);
+    };
+    scalar();
+    bench.Run("Scalar loop", scalar, config);
+
+    const auto float4Code = [&]() {
+        for (uint64 m = 0; m < kMatrixCount; ++m)
+        {
+            const simd::float4x4 product =
+                simd::Load4x4(a.Data() + m * 16) * simd::Load4x4(b.Data() + m * 16);
+            simd::Store4x4(product, out.Data() + m * 16);
+        }
+        DoNotOptimize(out[0]);
+    };
+    float4Code();
+    check.Floats("Matrix multiply, float4", expected, out, 1e-5f);
+    bench.Run(kFloat4Name, float4Code, config);
+}
+
+void TransformSuite(Bench& bench, CrossCheck& check)
+{
+    bench.Section("Point transform, SoA");
+    DynamicArray<float> xs = RandomFloats(kCount, -100.0f, 100.0f);
+    DynamicArray<float> ys = RandomFloats(kCount, -100.0f, 100.0f);
+    DynamicArray<float> zs = RandomFloats(kCount, -100.0f, 100.0f);
+    float matrix[12];
+    for (float& value : matrix)
+    {
+        value = RandomFloat(-2.0f, 2.0f);
+    }
+
+    DynamicArray<float> expected[3];
+    DynamicArray<float> out[3];
+    for (uint32 axis = 0; axis < 3; ++axis)
+    {
+        expected[axis].Resize(kCount);
+        out[axis].Resize(kCount);
+    }
+    const BenchConfig config = {.bytes = kCount * 6 * sizeof(float), .items = kCount};
+
+    const auto scalar = [&]() {
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            const float x = xs[i];
+            const float y = ys[i];
+            const float z = zs[i];
+            expected[0][i] = matrix[0] * x + matrix[3] * y + matrix[6] * z + matrix[9];
+            expected[1][i] = matrix[1] * x + matrix[4] * y + matrix[7] * z + matrix[10];
+            expected[2][i] = matrix[2] * x + matrix[5] * y + matrix[8] * z + matrix[11];
+        }
+        DoNotOptimize(expected[0][0]);
+    };
+    scalar();
+    bench.Run("Scalar loop", scalar, config);
+
+    for (const Internal::WideKernels* kernels : RunnableKernels())
+    {
+        const auto wide = [&]() {
+            kernels->transformPointsSoa(matrix, xs.Data(), ys.Data(), zs.Data(), kCount,
+                                        out[0].Data(), out[1].Data(), out[2].Data());
+            DoNotOptimize(out[0][0]);
+        };
+        wide();
+        for (uint32 axis = 0; axis < 3; ++axis)
+        {
+            check.Floats(KernelName(kernels), expected[axis], out[axis], 1e-5f);
+        }
+        bench.Run(KernelName(kernels), wide, config);
+    }
+}
+
+void CullSuite(Bench& bench, CrossCheck& check)
+{
+    // A box with two of its sides slanted, so every plane has all three components. Half the
+    // objects straddle a plane or lie outside.
+    float planes[24] = {
+        1.0f, 0.0f, 0.0f, 60.0f,  -1.0f, 0.0f, 0.0f, 60.0f,
+        0.0f, 1.0f, 0.0f, 60.0f,  0.0f, -1.0f, 0.0f, 60.0f,
+        0.0f, 0.0f, 1.0f, 60.0f,  0.0f, 0.0f, -1.0f, 60.0f,
+    };
+    const float slant = 1.0f / sqrtf(3.0f);
+    for (uint32 p = 0; p < 2; ++p)
+    {
+        planes[p * 4 + 0] = p == 0 ? slant : -slant;
+        planes[p * 4 + 1] = slant;
+        planes[p * 4 + 2] = slant;
+    }
+
+    DynamicArray<float> xs = RandomFloats(kCount, -100.0f, 100.0f);
+    DynamicArray<float> ys = RandomFloats(kCount, -100.0f, 100.0f);
+    DynamicArray<float> zs = RandomFloats(kCount, -100.0f, 100.0f);
+    DynamicArray<float> sizes[3] = {RandomFloats(kCount, 0.5f, 10.0f),
+                                    RandomFloats(kCount, 0.5f, 10.0f),
+                                    RandomFloats(kCount, 0.5f, 10.0f)};
+
+    const uint64 wordCount = (kCount + 63) / 64;
+    DynamicArray<uint64> expected;
+    DynamicArray<uint64> out;
+    DynamicArray<float> margins;
+    expected.Resize(wordCount);
+    out.Resize(wordCount);
+    margins.Resize(kCount);
+
+    // How far inside its nearest plane object i is, negative outside
+    const auto scalar = [&](bool boxes) {
+        for (uint64 word = 0; word < wordCount; ++word)
+        {
+            expected[word] = 0;
+        }
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            float margin = INFINITY;
+            for (uint32 p = 0; p < 6; ++p)
+            {
+                const float* plane = planes + p * 4;
+                const float reach = boxes ? fabsf(plane[0]) * sizes[0][i] +
+                                                fabsf(plane[1]) * sizes[1][i] +
+                                                fabsf(plane[2]) * sizes[2][i]
+                                          : sizes[0][i];
+                const float distance =
+                    plane[0] * xs[i] + plane[1] * ys[i] + plane[2] * zs[i] + plane[3];
+                margin = distance + reach < margin ? distance + reach : margin;
+            }
+            margins[i] = margin;
+            expected[i / 64] |= uint64(margin >= 0.0f) << (i % 64);
+        }
+        DoNotOptimize(expected[0]);
+    };
+
+    for (bool boxes : {false, true})
+    {
+        bench.Section(boxes ? "Frustum cull, AABBs" : "Frustum cull, spheres");
+        const BenchConfig config = {.bytes = kCount * (boxes ? 6 : 4) * sizeof(float),
+                                    .items = kCount};
+        scalar(boxes);
+        bench.Run("Scalar loop", [&]() { scalar(boxes); }, config);
+
+        for (const Internal::WideKernels* kernels : RunnableKernels())
+        {
+            const auto wide = [&]() {
+                if (boxes)
+                {
+                    kernels->cullAabbs(planes, xs.Data(), ys.Data(), zs.Data(), sizes[0].Data(),
+                                       sizes[1].Data(), sizes[2].Data(), kCount, out.Data());
+                }
+                else
+                {
+                    kernels->cullSpheres(planes, xs.Data(), ys.Data(), zs.Data(),
+                                         sizes[0].Data(), kCount, out.Data());
+                }
+                DoNotOptimize(out[0]);
+            };
+            wide();
+            check.Visibility(KernelName(kernels), expected, out, margins);
+            bench.Run(KernelName(kernels), wide, config);
+        }
+    }
+}
+
+// Same as simd::Slerp, a float at a time
+void ScalarSlerp(const float* a, const float* b, float t, float* out)
+{
+    float cosTheta = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    const float sign = cosTheta < 0.0f ? -1.0f : 1.0f;
+    cosTheta *= sign;
+
+    float weightA = 1.0f - t;
+    float weightB = t * sign;
+    if (cosTheta <= 0.9995f)
+    {
+        const float theta = acosf(cosTheta);
+        const float invSin = 1.0f / sinf(theta);
+        weightA = sinf((1.0f - t) * theta) * invSin;
+        weightB = sinf(t * theta) * invSin * sign;
+    }
+
+    float length = 0.0f;
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        out[i] = a[i] * weightA + b[i] * weightB;
+        length += out[i] * out[i];
+    }
+    // Only the nearly parallel lerp is normalized
+    if (cosTheta > 0.9995f)
+    {
+        const float invLength = 1.0f / sqrtf(length);
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            out[i] *= invLength;
+        }
+    }
+}
+
+void SlerpSuite(Bench& bench, CrossCheck& check)
+{
+    bench.Section("Quaternion slerp");
+    DynamicArray<float> a;
+    DynamicArray<float> b;
+    a.Resize(kCount * 4);
+    b.Resize(kCount * 4);
+    for (uint64 i = 0; i < kCount; ++i)
+    {
+        const simd::float4 axisA = simd::Normalize3(
+            simd::float4(RandomFloat(-1, 1), RandomFloat(-1, 1), RandomFloat(-1, 1), 0.0f));
+        const simd::float4 axisB = simd::Normalize3(
+            simd::float4(RandomFloat(-1, 1), RandomFloat(-1, 1), RandomFloat(-1, 1), 0.0f));
+        // Every tenth pair nearly parallel, the way neighbouring keyframes often are
+        const float angleA = RandomFloat(-3.0f, 3.0f);
+        const float angleB = i % 10 == 0 ? angleA + 0.01f : RandomFloat(-3.0f, 3.0f);
+        simd::StoreUnaligned(simd::QuatFromAxisAngle(axisA, angleA).xyzw, a.Data() + i * 4);
+        simd::StoreUnaligned(
+            simd::QuatFromAxisAngle(i % 10 == 0 ? axisA : axisB, angleB).xyzw, b.Data() + i * 4);
+    }
+
+    DynamicArray<float> expected;
+    DynamicArray<float> out;
+    expected.Resize(kCount * 4);
+    out.Resize(kCount * 4);
+    const BenchConfig config = {.bytes = kCount * 12 * sizeof(float), .items = kCount};
+    constexpr float kT = 0.3f;
+
+    const auto scalar = [&]() {
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            ScalarSlerp(a.Data() + i * 4, b.Data() + i * 4, kT, expected.Data() + i * 4);
+        }
+        DoNotOptimize(expected[0]);
+    };
+    scalar();
+    bench.Run("Scalar loop", scalar, config);
+
+    const auto float4Code = [&]() {
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            const simd::quat qa(simd::LoadUnaligned(a.Data() + i * 4));
+            const simd::quat qb(simd::LoadUnaligned(b.Data() + i * 4));
+            simd::StoreUnaligned(simd::Slerp(qa, qb, kT).xyzw, out.Data() + i * 4);
+        }
+        DoNotOptimize(out[0]);
+    };
+    float4Code();
+    check.Floats("Slerp, float4", expected, out, 1e-5f);
+    bench.Run(kFloat4Name, float4Code, config);
+}
+
+void PackingSuite(Bench& bench, CrossCheck& check)
+{
+    DynamicArray<float> floats = RandomFloats(kCount, -70000.0f, 70000.0f);
+    // Small values too, down into the denormals
+    for (uint64 i = 0; i < kCount; i += 3)
+    {
+        floats[i] *= 1e-9f;
+    }
+    DynamicArray<uint16> expectedHalves;
+    DynamicArray<uint16> halves;
+    expectedHalves.Resize(kCount);
+    halves.Resize(kCount);
+
+    bench.Section("Floats to halves");
+    const BenchConfig halfConfig = {.bytes = kCount * 6, .items = kCount};
+    const auto toHalves = [&]() {
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            expectedHalves[i] = FloatToHalf(floats[i]);
+        }
+        DoNotOptimize(expectedHalves[0]);
+    };
+    toHalves();
+    bench.Run("Scalar loop", toHalves, halfConfig);
+    for (const Internal::WideKernels* kernels : RunnableKernels())
+    {
+        const auto wide = [&]() {
+            kernels->floatsToHalves(floats.Data(), kCount, halves.Data());
+            DoNotOptimize(halves[0]);
+        };
+        wide();
+        check.Halves(KernelName(kernels), expectedHalves, halves);
+        bench.Run(KernelName(kernels), wide, halfConfig);
+    }
+
+    bench.Section("Halves to floats");
+    DynamicArray<float> expected;
+    DynamicArray<float> out;
+    expected.Resize(kCount);
+    out.Resize(kCount);
+    const auto toFloats = [&]() {
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            expected[i] = HalfToFloat(expectedHalves[i]);
+        }
+        DoNotOptimize(expected[0]);
+    };
+    toFloats();
+    bench.Run("Scalar loop", toFloats, halfConfig);
+    for (const Internal::WideKernels* kernels : RunnableKernels())
+    {
+        const auto wide = [&]() {
+            kernels->halvesToFloats(expectedHalves.Data(), kCount, out.Data());
+            DoNotOptimize(out[0]);
+        };
+        wide();
+        check.Floats(KernelName(kernels), expected, out, 0.0f);
+        bench.Run(KernelName(kernels), wide, halfConfig);
+    }
+
+    bench.Section("LerpDequantize16");
+    DynamicArray<uint16> codesA;
+    DynamicArray<uint16> codesB;
+    codesA.Resize(kCount);
+    codesB.Resize(kCount);
+    for (uint64 i = 0; i < kCount; ++i)
+    {
+        codesA[i] = static_cast<uint16>(RandomFloat(0.0f, 65535.0f));
+        codesB[i] = static_cast<uint16>(RandomFloat(0.0f, 65535.0f));
+    }
+    DynamicArray<float> offsets = RandomFloats(kCount, -10.0f, 10.0f);
+    DynamicArray<float> scales = RandomFloats(kCount, 1e-5f, 1e-3f);
+    constexpr float kT = 0.6f;
+    const BenchConfig dequantizeConfig = {.bytes = kCount * 16, .items = kCount};
+    const auto dequantize = [&]() {
+        for (uint64 i = 0; i < kCount; ++i)
+        {
+            const float codeA = static_cast<float>(codesA[i]);
+            const float codeB = static_cast<float>(codesB[i]);
+            expected[i] = offsets[i] + scales[i] * (codeA + kT * (codeB - codeA));
+        }
+        DoNotOptimize(expected[0]);
+    };
+    dequantize();
+    bench.Run("Scalar loop", dequantize, dequantizeConfig);
+    for (const Internal::WideKernels* kernels : RunnableKernels())
+    {
+        const auto wide = [&]() {
+            kernels->lerpDequantize16(codesA.Data(), codesB.Data(), kT, offsets.Data(),
+                                      scales.Data(), kCount, out.Data());
+            DoNotOptimize(out[0]);
+        };
+        wide();
+        check.Floats(KernelName(kernels), expected, out, 1e-5f);
+        bench.Run(KernelName(kernels), wide, dequantizeConfig);
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Bench bench("rsbl-math-kernels", argc, argv);
+    printf("%llu values, %llu matrices. GetWideKernels picks %s on this CPU.\n",
+           static_cast<unsigned long long>(kCount),
+           static_cast<unsigned long long>(kMatrixCount),
+           SimdLevelName(Internal::GetWideKernels().level));
+
+    CrossCheck check;
+    MatrixMultiplySuite(bench, check);
+    TransformSuite(bench, check);
+    CullSuite(bench, check);
+    SlerpSuite(bench, check);
+    PackingSuite(bench, check);
+
+    const int finished = bench.Finish();
+    if (check.Failures() > 0)
+    {
+        printf("%u variants don't match the scalar loop\n", check.Failures());
+        return 1;
+    }
+    return finished;
+}
@@ -251,3 +251,56 @@ TEST_SUITE("rsbl::int4")
         CHECK(v.w == 0);
     }
 }
+
+TEST_SUITE("rsbl::float2")
+{
+    TEST_CASE("Constructors")
+    {
+        float2 splat(1.5f);
+        CHECK(splat.x == 1.5f);
+        CHECK(splat.y == 1.5f);
+
+        float2 v(1.0f, -2.0f);
+        CHECK(v.x == 1.0f);
+        CHECK(v.y == -2.0f);
+    }
+}
+
+TEST_SUITE("rsbl::float3")
+{
+    TEST_CASE("Constructors")
+    {
+        float3 splat(1.5f);
+        CHECK(splat.x == 1.5f);
+        CHECK(splat.z == 1.5f);
+
+        float3 v(1.0f, -2.0f, 3.0f);
+        CHECK(v.x == 1.0f);
+        CHECK(v.y == -2.0f);
+        CHECK(v.z == 3.0f);
+    }
+
+    TEST_CASE("Tightly packed")
+    {
+        // Matches HLSL, so arrays of them can be uploaded as-is
+        CHECK(sizeof(float3) == 12);
+        CHECK(alignof(float3) == 4);
+    }
+}
+
+TEST_SUITE("rsbl::float4")
+{
+    TEST_CASE("Constructors")
+    {
+        float4 splat(1.5f);
+        CHECK(splat.x == 1.5f);
+        CHECK(splat.w == 1.5f);
+
+        float4 v(1.0f, -2.0f, 3.0f, -4.0f);
+        CHECK(v.x == 1.0f);
+        CHECK(v.y == -2.0f);
+        CHECK(v.z == 3.0f);
+        CHECK(v.w == -4.0f);
+        CHECK(sizeof(float4) == 16);
+    }
+}
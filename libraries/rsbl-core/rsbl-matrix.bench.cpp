@@ -0,0 +1,138 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// World matrix resolution for a 50k node hierarchy, and batched point transforms against one
+// point at a time, and the SoA point transform at every SIMD level this CPU runs.
+
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-matrix.h"
+#include "rsbl-wide-kernels.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace rsbl;
+using namespace rsbl::simd;
+
+namespace
+{
+constexpr uint32 kNodeCount = 50'000;
+constexpr uint32 kPointCount = 100'000;
+constexpr uint32 kRepeats = 100;
+
+// Stop the optimizer from folding the loops away
+volatile float s_sink = 0.0f;
+
+template <typename F>
+void Time(const char* name, double items, const char* unit, F&& f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32 repeat = 0; repeat < kRepeats; ++repeat)
+    {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double us = std::chrono::duration<double, std::micro>(end - start).count() / kRepeats;
+    printf("  %-40s %8.1f us  (%5.2f ns/%s)\n", name, us, us * 1000.0 / items, unit);
+}
+} // namespace
+
+int main()
+{
+    DynamicArray<float4x4> local;
+    DynamicArray<uint32> parents;
+    DynamicArray<float4x4> world;
+    local.Resize(kNodeCount);
+    parents.Resize(kNodeCount);
+    world.Resize(kNodeCount);
+
+    // Shallow, wide tree like a big scene: every node hangs off one of the earlier nodes
+    uint64 state = 1;
+    for (uint32 i = 0; i < kNodeCount; ++i)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        const float angle = static_cast<float>(state >> 40) * 1e-6f;
+        local[i] = ComposeTrs(simd::float4(1.0f, 0.5f, 0.0f, 0.0f),
+                              QuatFromAxisAngle(simd::float4(0.0f, 1.0f, 0.0f, 0.0f), angle),
+                              simd::float4(1.0f));
+        parents[i] = i == 0 ? kNoParent : static_cast<uint32>((state >> 16) % i);
+    }
+
+    DynamicArray<rsbl::float3> points;
+    DynamicArray<rsbl::float3> out;
+    for (uint32 i = 0; i < kPointCount; ++i)
+    {
+        const float f = static_cast<float>(i);
+        points.PushBack(rsbl::float3(f, -f, f * 0.5f));
+    }
+    out.Resize(kPointCount);
+    const float4x4 m = local[17];
+
+    Time("ComputeWorldMatrices (50k nodes)", kNodeCount, "node", [&]() {
+        ComputeWorldMatrices(local, parents, world);
+        s_sink = world[kNodeCount - 1].columns[3].X();
+    });
+
+    Time("TransformPoint loop (100k points)", kPointCount, "point", [&]() {
+        for (uint32 i = 0; i < kPointCount; ++i)
+        {
+            Store(TransformPoint(m, Load(points[i])), out[i]);
+        }
+        s_sink = out[kPointCount - 1].x;
+    });
+
+    Time("TransformPoints (100k points)", kPointCount, "point", [&]() {
+        TransformPoints(points, out, m);
+        s_sink = out[kPointCount - 1].x;
+    });
+
+    DynamicArray<float> xs;
+    DynamicArray<float> ys;
+    DynamicArray<float> zs;
+    for (uint32 i = 0; i < kPointCount; ++i)
+    {
+        xs.PushBack(points[i].x);
+        ys.PushBack(points[i].y);
+        zs.PushBack(points[i].z);
+    }
+    DynamicArray<float> out_xs;
+    DynamicArray<float> out_ys;
+    DynamicArray<float> out_zs;
+    out_xs.Resize(kPointCount);
+    out_ys.Resize(kPointCount);
+    out_zs.Resize(kPointCount);
+
+    Time("TransformPointsSoa dispatched (100k)", kPointCount, "point", [&]() {
+        TransformPointsSoa(xs, ys, zs, out_xs, out_ys, out_zs, m);
+        s_sink = out_xs[kPointCount - 1];
+    });
+
+    float matrix[12];
+    for (uint32 column = 0; column < 4; ++column)
+    {
+        matrix[column * 3 + 0] = m.columns[column].X();
+        matrix[column * 3 + 1] = m.columns[column].Y();
+        matrix[column * 3 + 2] = m.columns[column].Z();
+    }
+    for (uint32 level = 0; level < static_cast<uint32>(SimdLevel::Count); ++level)
+    {
+        const rsbl::Internal::WideKernels* kernels =
+            rsbl::Internal::GetWideKernels(static_cast<SimdLevel>(level));
+        if (kernels == nullptr)
+        {
+            continue;
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "  %s, %u lanes", SimdLevelName(kernels->level),
+                 kernels->width);
+        Time(name, kPointCount, "point", [&]() {
+            kernels->transformPointsSoa(matrix, xs.Data(), ys.Data(), zs.Data(), kPointCount,
+                                        out_xs.Data(), out_ys.Data(), out_zs.Data());
+            s_sink = out_xs[kPointCount - 1];
+        });
+    }
+
+    return 0;
+}
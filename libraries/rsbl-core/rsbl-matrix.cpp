@@ -0,0 +1,314 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-matrix.h"
+
+#include "include/rsbl-assert.h"
+#include "rsbl-wide-kernels.h"
+
+namespace rsbl
+{
+namespace simd
+{
+
+quat Slerp(quat a, quat b, float t)
+{
+    float cos_theta = Dot(a, b);
+    float4 target = b.xyzw;
+    if (cos_theta < 0.0f)
+    {
+        cos_theta = -cos_theta;
+        target = -target;
+    }
+
+    // Nearly parallel, the sin below would divide by ~0
+    if (cos_theta > 0.9995f)
+    {
+        return Normalize(quat(Lerp(a.xyzw, target, t)));
+    }
+
+    const float theta = acosf(cos_theta);
+    const float inv_sin = 1.0f / sinf(theta);
+    const float weight_a = sinf((1.0f - t) * theta) * inv_sin;
+    const float weight_b = sinf(t * theta) * inv_sin;
+    return quat(a.xyzw * weight_a + target * weight_b);
+}
+
+quat QuatFromRotationMatrix(const float4x4& m)
+{
+    // m(row, column)
+    const float m00 = m.columns[0].X();
+    const float m10 = m.columns[0].Y();
+    const float m20 = m.columns[0].Z();
+    const float m01 = m.columns[1].X();
+    const float m11 = m.columns[1].Y();
+    const float m21 = m.columns[1].Z();
+    const float m02 = m.columns[2].X();
+    const float m12 = m.columns[2].Y();
+    const float m22 = m.columns[2].Z();
+
+    // Pick the largest of w, x, y, z to divide by, keeps precision when the others are small
+    const float trace = m00 + m11 + m22;
+    if (trace > 0.0f)
+    {
+        const float s = 0.5f / sqrtf(trace + 1.0f);
+        return quat((m21 - m12) * s, (m02 - m20) * s, (m10 - m01) * s, 0.25f / s);
+    }
+    if (m00 > m11 && m00 > m22)
+    {
+        const float s = 2.0f * sqrtf(1.0f + m00 - m11 - m22);
+        return quat(0.25f * s, (m01 + m10) / s, (m02 + m20) / s, (m21 - m12) / s);
+    }
+    if (m11 > m22)
+    {
+        const float s = 2.0f * sqrtf(1.0f + m11 - m00 - m22);
+        return quat((m01 + m10) / s, 0.25f * s, (m12 + m21) / s, (m02 - m20) / s);
+    }
+    const float s = 2.0f * sqrtf(1.0f + m22 - m00 - m11);
+    return quat((m02 + m20) / s, (m12 + m21) / s, 0.25f * s, (m10 - m01) / s);
+}
+
+namespace
+{
+    // Lengyel's formulation (Foundations of Game Engine Development, vol 1): with columns a b c d
+    // and bottom row x y z w, the inverse falls out of four cross products.
+    struct InverseTerms
+    {
+        float4 s;
+        float4 t;
+        float4 u;
+        float4 v;
+    };
+
+    InverseTerms ComputeInverseTerms(const float4x4& m)
+    {
+        const float4 a = m.columns[0];
+        const float4 b = m.columns[1];
+        const float4 c = m.columns[2];
+        const float4 d = m.columns[3];
+
+        InverseTerms terms;
+        terms.s = Cross3(a, b);
+        terms.t = Cross3(c, d);
+        terms.u = SetW(a * SplatW(b) - b * SplatW(a), 0.0f);
+        terms.v = SetW(c * SplatW(d) - d * SplatW(c), 0.0f);
+        return terms;
+    }
+} // namespace
+
+float Determinant(const float4x4& m)
+{
+    const InverseTerms terms = ComputeInverseTerms(m);
+    return Dot3(terms.s, terms.v) + Dot3(terms.t, terms.u);
+}
+
+float4x4 Inverse(const float4x4& m)
+{
+    const float4 a = m.columns[0];
+    const float4 b = m.columns[1];
+    const float4 c = m.columns[2];
+    const float4 d = m.columns[3];
+
+    InverseTerms terms = ComputeInverseTerms(m);
+    const float inv_det = 1.0f / (Dot3(terms.s, terms.v) + Dot3(terms.t, terms.u));
+    const float4 s = terms.s * inv_det;
+    const float4 t = terms.t * inv_det;
+    const float4 u = terms.u * inv_det;
+    const float4 v = terms.v * inv_det;
+
+    // These are the rows of the inverse
+    float4 r0 = SetW(Cross3(b, v) + t * SplatW(b), -Dot3(b, t));
+    float4 r1 = SetW(Cross3(v, a) - t * SplatW(a), Dot3(a, t));
+    float4 r2 = SetW(Cross3(d, u) + s * SplatW(d), -Dot3(d, s));
+    float4 r3 = SetW(Cross3(u, c) - s * SplatW(c), Dot3(c, s));
+
+    Transpose(r0, r1, r2, r3);
+    return float4x4(r0, r1, r2, r3);
+}
+
+float4x4 InverseAffine(const float4x4& m)
+{
+    const float4 a = m.columns[0];
+    const float4 b = m.columns[1];
+    const float4 c = m.columns[2];
+
+    // Inverse of the 3x3 part, by rows
+    const float4 cross_ab = Cross3(a, b);
+    const float inv_det = 1.0f / Dot3(cross_ab, c);
+    float4 r0 = Cross3(b, c) * inv_det;
+    float4 r1 = Cross3(c, a) * inv_det;
+    float4 r2 = cross_ab * inv_det;
+    float4 r3 = Zero();
+    Transpose(r0, r1, r2, r3);
+
+    // Translation is undone in the rotated/scaled space
+    const float4 translation = m.columns[3];
+    float4 inv_translation = r0 * SplatX(translation);
+    inv_translation = MultiplyAdd(r1, SplatY(translation), inv_translation);
+    inv_translation = MultiplyAdd(r2, SplatZ(translation), inv_translation);
+    return float4x4(r0, r1, r2, SetW(-inv_translation, 1.0f));
+}
+
+float4x4 ComposeTrs(float4 translation, quat rotation, float4 scale)
+{
+    const float x = rotation.xyzw.X();
+    const float y = rotation.xyzw.Y();
+    const float z = rotation.xyzw.Z();
+    const float w = rotation.xyzw.W();
+
+    const float xx = x * x;
+    const float yy = y * y;
+    const float zz = z * z;
+    const float xy = x * y;
+    const float xz = x * z;
+    const float yz = y * z;
+    const float wx = w * x;
+    const float wy = w * y;
+    const float wz = w * z;
+
+    const float4 c0(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f);
+    const float4 c1(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f);
+    const float4 c2(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f);
+
+    return float4x4(c0 * SplatX(scale), c1 * SplatY(scale), c2 * SplatZ(scale),
+                    SetW(translation, 1.0f));
+}
+
+void DecomposeTrs(const float4x4& m, float4& translation, quat& rotation, float4& scale)
+{
+    const float4 c0 = m.columns[0];
+    const float4 c1 = m.columns[1];
+    const float4 c2 = m.columns[2];
+
+    translation = SetW(m.columns[3], 0.0f);
+
+    float sx = Length3(c0);
+    const float sy = Length3(c1);
+    const float sz = Length3(c2);
+
+    // A mirrored basis can't be a rotation, flip one axis so it is
+    if (Dot3(Cross3(c0, c1), c2) < 0.0f)
+    {
+        sx = -sx;
+    }
+    scale = float4(sx, sy, sz, 0.0f);
+
+    const float4x4 rotation_matrix(c0 / sx, c1 / sy, c2 / sz, float4(0.0f, 0.0f, 0.0f, 1.0f));
+    rotation = Normalize(QuatFromRotationMatrix(rotation_matrix));
+}
+
+void TransformPoints(ArrayView<rsbl::float3> points, const float4x4& m)
+{
+    TransformPoints(ArrayView<const rsbl::float3>(points), points, m);
+}
+
+void TransformPoints(ArrayView<const rsbl::float3> points, ArrayView<rsbl::float3> out,
+                     const float4x4& m)
+{
+    rsblAssert(points.Size() == out.Size());
+
+    const uint64 count = points.Size();
+    uint64 i = 0;
+
+#if RSBL_SIMD_SSE
+    // Four points at a time: three loads give x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3, which get
+    // shuffled into xxxx yyyy zzzz, transformed with one lane per point, then shuffled back
+    const __m128 m00 = _mm_set1_ps(m.columns[0].X());
+    const __m128 m10 = _mm_set1_ps(m.columns[0].Y());
+    const __m128 m20 = _mm_set1_ps(m.columns[0].Z());
+    const __m128 m01 = _mm_set1_ps(m.columns[1].X());
+    const __m128 m11 = _mm_set1_ps(m.columns[1].Y());
+    const __m128 m21 = _mm_set1_ps(m.columns[1].Z());
+    const __m128 m02 = _mm_set1_ps(m.columns[2].X());
+    const __m128 m12 = _mm_set1_ps(m.columns[2].Y());
+    const __m128 m22 = _mm_set1_ps(m.columns[2].Z());
+    const __m128 m03 = _mm_set1_ps(m.columns[3].X());
+    const __m128 m13 = _mm_set1_ps(m.columns[3].Y());
+    const __m128 m23 = _mm_set1_ps(m.columns[3].Z());
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const float* src = &points[i].x;
+        const __m128 v0 = _mm_loadu_ps(src);
+        const __m128 v1 = _mm_loadu_ps(src + 4);
+        const __m128 v2 = _mm_loadu_ps(src + 8);
+
+        const __m128 x23 = _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 1, 2, 2));
+        const __m128 x = _mm_shuffle_ps(v0, x23, _MM_SHUFFLE(2, 0, 3, 0));
+        const __m128 y01 = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1));
+        const __m128 y23 = _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 2, 3, 3));
+        const __m128 y = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 z01 = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2));
+        const __m128 z = _mm_shuffle_ps(z01, v2, _MM_SHUFFLE(3, 0, 2, 0));
+
+        const __m128 tx = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)),
+            _mm_add_ps(_mm_mul_ps(m02, z), m03));
+        const __m128 ty = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)),
+            _mm_add_ps(_mm_mul_ps(m12, z), m13));
+        const __m128 tz = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(m20, x), _mm_mul_ps(m21, y)),
+            _mm_add_ps(_mm_mul_ps(m22, z), m23));
+
+        const __m128 xy0 = _mm_shuffle_ps(tx, ty, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 zx0 = _mm_shuffle_ps(tz, tx, _MM_SHUFFLE(1, 1, 0, 0));
+        const __m128 yz1 = _mm_shuffle_ps(ty, tz, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m128 xy2 = _mm_shuffle_ps(tx, ty, _MM_SHUFFLE(2, 2, 2, 2));
+        const __m128 zx2 = _mm_shuffle_ps(tz, tx, _MM_SHUFFLE(3, 3, 2, 2));
+        const __m128 yz3 = _mm_shuffle_ps(ty, tz, _MM_SHUFFLE(3, 3, 3, 3));
+
+        float* dst = &out[i].x;
+        _mm_storeu_ps(dst, _mm_shuffle_ps(xy0, zx0, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(dst + 4, _mm_shuffle_ps(yz1, xy2, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(dst + 8, _mm_shuffle_ps(zx2, yz3, _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        Store(TransformPoint(m, Load(points[i])), out[i]);
+    }
+}
+
+void TransformPointsSoa(ArrayView<const float> xs, ArrayView<const float> ys,
+                        ArrayView<const float> zs, ArrayView<float> outXs, ArrayView<float> outYs,
+                        ArrayView<float> outZs, const float4x4& m)
+{
+    const uint64 count = xs.Size();
+    rsblAssert(ys.Size() == count && zs.Size() == count);
+    rsblAssert(outXs.Size() == count && outYs.Size() == count && outZs.Size() == count);
+
+    const float matrix[12] = {
+        m.columns[0].X(), m.columns[0].Y(), m.columns[0].Z(),
+        m.columns[1].X(), m.columns[1].Y(), m.columns[1].Z(),
+        m.columns[2].X(), m.columns[2].Y(), m.columns[2].Z(),
+        m.columns[3].X(), m.columns[3].Y(), m.columns[3].Z(),
+    };
+    rsbl::Internal::GetWideKernels().transformPointsSoa(matrix, xs.Data(), ys.Data(), zs.Data(),
+                                                        count, outXs.Data(), outYs.Data(),
+                                                        outZs.Data());
+}
+
+void ComputeWorldMatrices(ArrayView<const float4x4> local, ArrayView<const uint32> parents,
+                          ArrayView<float4x4> world)
+{
+    rsblAssert(local.Size() == parents.Size() && local.Size() == world.Size());
+
+    for (uint64 i = 0; i < local.Size(); ++i)
+    {
+        const uint32 parent = parents[i];
+        if (parent == kNoParent)
+        {
+            world[i] = local[i];
+        }
+        else
+        {
+            rsblDebugAssert(parent < i);
+            world[i] = world[parent] * local[i];
+        }
+    }
+}
+
+} // namespace simd
+} // namespace rsbl
@@ -0,0 +1,407 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-matrix.h"
+#include "rsbl-wide-kernels.h"
+
+using namespace rsbl;
+using namespace rsbl::simd;
+
+namespace
+{
+constexpr float kPi = 3.14159265358979f;
+
+void CheckEqual(simd::float4 v, float x, float y, float z, float w)
+{
+    CHECK(v.X() == doctest::Approx(x).epsilon(1e-4));
+    CHECK(v.Y() == doctest::Approx(y).epsilon(1e-4));
+    CHECK(v.Z() == doctest::Approx(z).epsilon(1e-4));
+    CHECK(v.W() == doctest::Approx(w).epsilon(1e-4));
+}
+
+void CheckEqual(const float4x4& a, const float4x4& b)
+{
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        const simd::float4 column = b.columns[i];
+        CheckEqual(a.columns[i], column.X(), column.Y(), column.Z(), column.W());
+    }
+}
+
+// Rotation + non-uniform scale + translation, so nothing is accidentally symmetric
+float4x4 MakeTestMatrix()
+{
+    const quat rotation =
+        QuatFromAxisAngle(Normalize3(simd::float4(1.0f, 2.0f, 3.0f, 0.0f)), 0.7f);
+    return ComposeTrs(simd::float4(1.0f, -2.0f, 3.0f, 0.0f), rotation,
+                      simd::float4(2.0f, 0.5f, 1.5f, 0.0f));
+}
+} // namespace
+
+TEST_SUITE("rsbl::simd::quat")
+{
+    TEST_CASE("Axis angle rotation")
+    {
+        const quat q = QuatFromAxisAngle(simd::float4(0.0f, 0.0f, 1.0f, 0.0f), kPi * 0.5f);
+        CheckEqual(Rotate(q, simd::float4(1.0f, 0.0f, 0.0f, 0.0f)), 0.0f, 1.0f, 0.0f, 0.0f);
+        CheckEqual(Rotate(QuatIdentity(), simd::float4(1.0f, 2.0f, 3.0f, 0.0f)), 1.0f, 2.0f,
+                   3.0f, 0.0f);
+    }
+
+    TEST_CASE("Multiply composes rotations")
+    {
+        const quat around_z = QuatFromAxisAngle(simd::float4(0.0f, 0.0f, 1.0f, 0.0f), kPi * 0.5f);
+        const quat around_x = QuatFromAxisAngle(simd::float4(1.0f, 0.0f, 0.0f, 0.0f), kPi * 0.5f);
+
+        // Rotate by z first, then x: +x -> +y -> +z
+        const quat combined = around_x * around_z;
+        CheckEqual(Rotate(combined, simd::float4(1.0f, 0.0f, 0.0f, 0.0f)), 0.0f, 0.0f, 1.0f,
+                   0.0f);
+
+        const quat back = combined * Conjugate(combined);
+        CheckEqual(back.xyzw, 0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    TEST_CASE("Slerp and Nlerp")
+    {
+        const quat a = QuatIdentity();
+        const quat b = QuatFromAxisAngle(simd::float4(0.0f, 1.0f, 0.0f, 0.0f), kPi * 0.5f);
+        const quat half = QuatFromAxisAngle(simd::float4(0.0f, 1.0f, 0.0f, 0.0f), kPi * 0.25f);
+
+        const quat s = Slerp(a, b, 0.5f);
+        CheckEqual(s.xyzw, half.xyzw.X(), half.xyzw.Y(), half.xyzw.Z(), half.xyzw.W());
+        CheckEqual(Slerp(a, b, 0.0f).xyzw, 0.0f, 0.0f, 0.0f, 1.0f);
+
+        const quat n = Nlerp(a, b, 0.5f);
+        CheckEqual(n.xyzw, half.xyzw.X(), half.xyzw.Y(), half.xyzw.Z(), half.xyzw.W());
+
+        // Opposite sign is the same rotation, both take the short way round
+        const quat negated(-b.xyzw);
+        CHECK(fabsf(Dot(Slerp(a, negated, 0.5f), half)) == doctest::Approx(1.0f));
+    }
+
+    TEST_CASE("From rotation matrix")
+    {
+        const simd::float4 axes[] = {
+            simd::float4(1.0f, 0.0f, 0.0f, 0.0f),
+            simd::float4(0.0f, 1.0f, 0.0f, 0.0f),
+            simd::float4(0.0f, 0.0f, 1.0f, 0.0f),
+            Normalize3(simd::float4(1.0f, -1.0f, 2.0f, 0.0f)),
+        };
+        // Covers every branch of the trace test
+        const float angles[] = {0.3f, 2.0f, 3.1f, -2.5f};
+
+        for (const simd::float4& axis : axes)
+        {
+            for (float angle : angles)
+            {
+                const quat q = QuatFromAxisAngle(axis, angle);
+                const float4x4 m = ComposeTrs(Zero(), q, simd::float4(1.0f));
+                const quat back = QuatFromRotationMatrix(m);
+                CHECK(fabsf(Dot(q, back)) == doctest::Approx(1.0f));
+            }
+        }
+    }
+}
+
+TEST_SUITE("rsbl::simd::float4x4")
+{
+    TEST_CASE("Identity and load/store")
+    {
+        const float columnMajor[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+        const float4x4 m = Load4x4(columnMajor);
+        CheckEqual(m.columns[1], 5.0f, 6.0f, 7.0f, 8.0f);
+
+        float stored[16];
+        Store4x4(m, stored);
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            CHECK(stored[i] == columnMajor[i]);
+        }
+
+        CheckEqual(Identity4x4() * m, m);
+        CheckEqual(m * Identity4x4(), m);
+    }
+
+    TEST_CASE("Transforms")
+    {
+        // Translate by (10, 20, 30)
+        float4x4 m = Identity4x4();
+        m.columns[3] = simd::float4(10.0f, 20.0f, 30.0f, 1.0f);
+
+        CheckEqual(TransformPoint(m, simd::float4(1.0f, 2.0f, 3.0f, 0.0f)), 11.0f, 22.0f, 33.0f,
+                   1.0f);
+        CheckEqual(TransformVector(m, simd::float4(1.0f, 2.0f, 3.0f, 0.0f)), 1.0f, 2.0f, 3.0f,
+                   0.0f);
+        CheckEqual(Transform(m, simd::float4(1.0f, 2.0f, 3.0f, 1.0f)), 11.0f, 22.0f, 33.0f, 1.0f);
+    }
+
+    TEST_CASE("Multiply applies the right matrix first")
+    {
+        float4x4 translate = Identity4x4();
+        translate.columns[3] = simd::float4(5.0f, 0.0f, 0.0f, 1.0f);
+        const float4x4 scale = ComposeTrs(Zero(), QuatIdentity(), simd::float4(2.0f));
+
+        // Scale then translate
+        CheckEqual(TransformPoint(translate * scale, simd::float4(1.0f, 1.0f, 1.0f, 0.0f)), 7.0f,
+                   2.0f, 2.0f, 1.0f);
+        // Translate then scale
+        CheckEqual(TransformPoint(scale * translate, simd::float4(1.0f, 1.0f, 1.0f, 0.0f)),
+                   12.0f, 2.0f, 2.0f, 1.0f);
+    }
+
+    TEST_CASE("Constant evaluation")
+    {
+        // A fixed camera: translate, then a projection, all folded at compile time
+        constexpr simd::float4x4 view(simd::float4(1.0f, 0.0f, 0.0f, 0.0f),
+                                      simd::float4(0.0f, 1.0f, 0.0f, 0.0f),
+                                      simd::float4(0.0f, 0.0f, 1.0f, 0.0f),
+                                      simd::float4(0.0f, -2.0f, 5.0f, 1.0f));
+        constexpr simd::float4x4 projection(simd::float4(0.5f, 0.0f, 0.0f, 0.0f),
+                                            simd::float4(0.0f, 1.0f, 0.0f, 0.0f),
+                                            simd::float4(0.0f, 0.0f, 1.0f, 1.0f),
+                                            simd::float4(0.0f, 0.0f, -1.0f, 0.0f));
+        constexpr simd::float4x4 view_projection = projection * view;
+        constexpr simd::float4 clip =
+            simd::TransformPoint(view_projection, simd::float4(2.0f, 2.0f, 0.0f, 1.0f));
+        static_assert(clip.X() == 1.0f && clip.Y() == 0.0f && clip.Z() == 4.0f &&
+                      clip.W() == 5.0f);
+        static_assert(simd::Transpose(view).columns[3].W() == 1.0f);
+        static_assert(simd::Transpose(view).columns[1].W() == -2.0f);
+
+        constexpr simd::float3x4 affine = simd::ToFloat3x4(view);
+        static_assert(simd::TransformPoint(affine, simd::float4(1.0f)).Z() == 6.0f);
+
+        // 90 degrees about z, written out since sinf/cosf aren't constexpr
+        constexpr float half = 0.70710678f;
+        constexpr simd::quat rotation(0.0f, 0.0f, half, half);
+        constexpr simd::float4 rotated =
+            simd::Rotate(rotation, simd::float4(1.0f, 0.0f, 0.0f, 0.0f));
+        static_assert(rotated.X() < 1e-6f && rotated.X() > -1e-6f);
+        static_assert(rotated.Y() > 0.99999f);
+
+        // Same answer at runtime
+        CheckEqual(view_projection, projection * view);
+    }
+
+    TEST_CASE("Transpose")
+    {
+        const float values[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+        const float4x4 t = Transpose(Load4x4(values));
+        CheckEqual(t.columns[0], 1.0f, 5.0f, 9.0f, 13.0f);
+        CheckEqual(t.columns[3], 4.0f, 8.0f, 12.0f, 16.0f);
+    }
+
+    TEST_CASE("Inverse")
+    {
+        const float4x4 m = MakeTestMatrix();
+        CheckEqual(m * Inverse(m), Identity4x4());
+        CheckEqual(Inverse(m) * m, Identity4x4());
+        CheckEqual(m * InverseAffine(m), Identity4x4());
+        CheckEqual(InverseAffine(m), Inverse(m));
+
+        // Something projective, with a bottom row that isn't 0 0 0 1
+        const float values[16] = {2, 0, 0, 0, 0, 3, 0, 0, 0, 0, 1.5f, 1, 1, 2, -4, 0};
+        const float4x4 projective = Load4x4(values);
+        CheckEqual(projective * Inverse(projective), Identity4x4());
+    }
+
+    TEST_CASE("Determinant")
+    {
+        CHECK(Determinant(Identity4x4()) == doctest::Approx(1.0f));
+        // Scale 2 * 0.5 * 1.5, rotation and translation don't change it
+        CHECK(Determinant(MakeTestMatrix()) == doctest::Approx(1.5f));
+    }
+
+    TEST_CASE("Compose and decompose TRS")
+    {
+        const simd::float4 translation(1.0f, -2.0f, 3.0f, 0.0f);
+        const quat rotation =
+            QuatFromAxisAngle(Normalize3(simd::float4(1.0f, 2.0f, 3.0f, 0.0f)), 0.7f);
+        const simd::float4 scale(2.0f, 0.5f, 1.5f, 0.0f);
+
+        const float4x4 m = ComposeTrs(translation, rotation, scale);
+
+        simd::float4 t;
+        quat r;
+        simd::float4 s;
+        DecomposeTrs(m, t, r, s);
+        CheckEqual(t, 1.0f, -2.0f, 3.0f, 0.0f);
+        CheckEqual(s, 2.0f, 0.5f, 1.5f, 0.0f);
+        CHECK(fabsf(Dot(r, rotation)) == doctest::Approx(1.0f));
+        CheckEqual(ComposeTrs(t, r, s), m);
+
+        // Mirrored matrices still round trip
+        const float4x4 mirrored = ComposeTrs(translation, rotation, simd::float4(-1.0f, 1.0f,
+                                                                               1.0f, 0.0f));
+        DecomposeTrs(mirrored, t, r, s);
+        CheckEqual(ComposeTrs(t, r, s), mirrored);
+    }
+}
+
+TEST_SUITE("rsbl::simd::float3x4")
+{
+    TEST_CASE("Round trip through float4x4")
+    {
+        const float4x4 m = MakeTestMatrix();
+        const float3x4 affine = ToFloat3x4(m);
+        CheckEqual(ToFloat4x4(affine), m);
+        CheckEqual(ToFloat4x4(Identity3x4()), Identity4x4());
+
+        // Rows hold the translation in w
+        CHECK(affine.rows[0].W() == doctest::Approx(1.0f));
+        CHECK(affine.rows[1].W() == doctest::Approx(-2.0f));
+    }
+
+    TEST_CASE("Transforms match float4x4")
+    {
+        const float4x4 m = MakeTestMatrix();
+        const float3x4 affine = ToFloat3x4(m);
+        const simd::float4 p(0.5f, -1.0f, 2.0f, 0.0f);
+
+        const simd::float4 expected = TransformPoint(m, p);
+        CheckEqual(TransformPoint(affine, p), expected.X(), expected.Y(), expected.Z(), 1.0f);
+
+        const simd::float4 expected_vector = TransformVector(m, p);
+        CheckEqual(TransformVector(affine, p), expected_vector.X(), expected_vector.Y(),
+                   expected_vector.Z(), 0.0f);
+    }
+
+    TEST_CASE("Multiply matches float4x4")
+    {
+        const float4x4 a = MakeTestMatrix();
+        const float4x4 b = ComposeTrs(simd::float4(-3.0f, 0.0f, 1.0f, 0.0f),
+                                      QuatFromAxisAngle(simd::float4(0.0f, 1.0f, 0.0f, 0.0f), 1.0f),
+                                      simd::float4(1.0f, 3.0f, 1.0f, 0.0f));
+        CheckEqual(ToFloat4x4(ToFloat3x4(a) * ToFloat3x4(b)), a * b);
+    }
+}
+
+TEST_SUITE("rsbl::simd batched kernels")
+{
+    TEST_CASE("TransformPoints matches TransformPoint")
+    {
+        const float4x4 m = MakeTestMatrix();
+
+        // Not a multiple of four, so the scalar tail runs too
+        DynamicArray<rsbl::float3> points;
+        for (uint32 i = 0; i < 23; ++i)
+        {
+            const float f = static_cast<float>(i);
+            points.PushBack(rsbl::float3(f, f * 0.5f - 3.0f, 10.0f - f));
+        }
+
+        DynamicArray<rsbl::float3> out;
+        out.Resize(points.Size());
+        TransformPoints(points, out, m);
+
+        for (uint64 i = 0; i < points.Size(); ++i)
+        {
+            const simd::float4 expected = TransformPoint(m, Load(points[i]));
+            CHECK(out[i].x == doctest::Approx(expected.X()));
+            CHECK(out[i].y == doctest::Approx(expected.Y()));
+            CHECK(out[i].z == doctest::Approx(expected.Z()));
+        }
+
+        // In place gives the same answer
+        TransformPoints(points, m);
+        for (uint64 i = 0; i < points.Size(); ++i)
+        {
+            CHECK(points[i].x == out[i].x);
+            CHECK(points[i].y == out[i].y);
+            CHECK(points[i].z == out[i].z);
+        }
+    }
+
+    TEST_CASE("TransformPointsSoa matches TransformPoint at every SIMD level")
+    {
+        const float4x4 m = MakeTestMatrix();
+
+        // Two full AVX-512 batches and a tail
+        constexpr uint32 kCount = 37;
+        float xs[kCount];
+        float ys[kCount];
+        float zs[kCount];
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            const float f = static_cast<float>(i);
+            xs[i] = f;
+            ys[i] = f * 0.5f - 3.0f;
+            zs[i] = 10.0f - f;
+        }
+
+        auto check = [&](const float* outXs, const float* outYs, const float* outZs) {
+            for (uint32 i = 0; i < kCount; ++i)
+            {
+                const simd::float4 expected =
+                    TransformPoint(m, simd::float4(xs[i], ys[i], zs[i], 1.0f));
+                CHECK(outXs[i] == doctest::Approx(expected.X()));
+                CHECK(outYs[i] == doctest::Approx(expected.Y()));
+                CHECK(outZs[i] == doctest::Approx(expected.Z()));
+            }
+        };
+
+        float outXs[kCount];
+        float outYs[kCount];
+        float outZs[kCount];
+        TransformPointsSoa(xs, ys, zs, outXs, outYs, outZs, m);
+        check(outXs, outYs, outZs);
+
+        float matrix[12];
+        for (uint32 column = 0; column < 4; ++column)
+        {
+            matrix[column * 3 + 0] = m.columns[column].X();
+            matrix[column * 3 + 1] = m.columns[column].Y();
+            matrix[column * 3 + 2] = m.columns[column].Z();
+        }
+
+        uint32 levels_run = 0;
+        for (uint32 level = 0; level < static_cast<uint32>(SimdLevel::Count); ++level)
+        {
+            const rsbl::Internal::WideKernels* kernels =
+                rsbl::Internal::GetWideKernels(static_cast<SimdLevel>(level));
+            if (kernels == nullptr)
+            {
+                continue;
+            }
+
+            CAPTURE(SimdLevelName(kernels->level));
+            levels_run++;
+            for (uint32 i = 0; i < kCount; ++i)
+            {
+                outXs[i] = outYs[i] = outZs[i] = 0.0f;
+            }
+            kernels->transformPointsSoa(matrix, xs, ys, zs, kCount, outXs, outYs, outZs);
+            check(outXs, outYs, outZs);
+        }
+        CHECK(levels_run >= 1);
+
+        // The dispatched kernels are the widest the CPU runs
+        CHECK(rsbl::Internal::GetWideKernels().level <= GetBestSimdLevel());
+    }
+
+    TEST_CASE("ComputeWorldMatrices")
+    {
+        // root -> child -> grandchild, plus a second root
+        float4x4 translate_x = Identity4x4();
+        translate_x.columns[3] = simd::float4(1.0f, 0.0f, 0.0f, 1.0f);
+        const float4x4 scale = ComposeTrs(Zero(), QuatIdentity(), simd::float4(2.0f));
+
+        const float4x4 local[] = {translate_x, scale, translate_x, scale};
+        const uint32 parents[] = {kNoParent, 0, 1, kNoParent};
+        float4x4 world[4];
+
+        ComputeWorldMatrices(local, parents, world);
+
+        const simd::float4 origin = Zero();
+        CheckEqual(TransformPoint(world[0], origin), 1.0f, 0.0f, 0.0f, 1.0f);
+        CheckEqual(TransformPoint(world[1], origin), 1.0f, 0.0f, 0.0f, 1.0f);
+        // The grandchild's translation is scaled by its parent
+        CheckEqual(TransformPoint(world[2], origin), 3.0f, 0.0f, 0.0f, 1.0f);
+        CheckEqual(world[3], scale);
+    }
+}
@@ -0,0 +1,41 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "include/rsbl-memory-tracking.h"
+
+#include <atomic>
+
+// The memory profiler's hooks into the tracked allocation paths in rsbl-memory-tracking.cpp
+
+namespace rsbl::Internal
+{
+
+// 0 while the profiler is stopped
+extern constinit std::atomic<uint32> g_memorySampleInterval;
+
+// Live samples. Frees only look themselves up while there are any.
+extern constinit std::atomic<uint64> g_memorySampleCount;
+
+// Keeps ptr's call stack if it's the thread's turn, true if it did
+bool SampleAllocation(void* ptr, MemoryTag tag, uint64 size);
+
+// Drops ptr's sample, if it has one
+void ForgetAllocation(void* ptr);
+
+inline bool MaybeSampleAllocation(void* ptr, MemoryTag tag, uint64 size)
+{
+    return g_memorySampleInterval.load(std::memory_order_relaxed) != 0 &&
+           SampleAllocation(ptr, tag, size);
+}
+
+inline void MaybeForgetAllocation(void* ptr)
+{
+    if (g_memorySampleCount.load(std::memory_order_relaxed) != 0)
+    {
+        ForgetAllocation(ptr);
+    }
+}
+
+} // namespace rsbl::Internal
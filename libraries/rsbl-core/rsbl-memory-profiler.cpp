@@ -0,0 +1,582 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-memory-profiler.h"
+
+#include "include/rsbl-assert.h"
+#include "include/rsbl-hash-map.h"
+#include "include/rsbl-hash.h"
+#include "include/rsbl-sort.h"
+#include "rsbl-memory-profiler-internal.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#if defined(_WIN32)
+    #include <windows.h>
+
+    #include <dbghelp.h>
+
+    #pragma comment(lib, "dbghelp.lib")
+#elif __has_include(<execinfo.h>)
+    #include <execinfo.h>
+    #define RSBL_HAS_EXECINFO
+#endif
+
+namespace rsbl
+{
+
+constinit std::atomic<uint32> Internal::g_memorySampleInterval{0};
+constinit std::atomic<uint64> Internal::g_memorySampleCount{0};
+
+namespace
+{
+struct SampleRecord
+{
+    void* ptr = nullptr; // Null for an empty slot
+    uint64 size = 0;
+    MemoryTag tag = MemoryTag::Core;
+    uint32 frameCount = 0;
+    void* frames[kMemoryStackDepth];
+};
+
+// The samples are spread over shards by address, each an open addressed table with linear
+// probing. The tables come straight from malloc, anything tracked would sample itself.
+struct alignas(64) SampleShard
+{
+    std::mutex mutex;
+    SampleRecord* records = nullptr;
+    uint32 capacity = 0; // A power of two
+    uint32 size = 0;
+};
+
+constexpr uint32 kShardBits = 6;
+constexpr uint32 kShardCount = 1u << kShardBits;
+
+// Constant initialized, global new can sample during static init
+constinit SampleShard s_shards[kShardCount];
+
+// Bumped by each start, so threads start their countdowns over
+constinit std::atomic<uint32> s_generation{0};
+
+constinit thread_local uint32 t_countdown = 0;
+constinit thread_local uint32 t_generation = 0;
+// Set while the profiler itself allocates, so it doesn't sample its own snapshots
+constinit thread_local bool t_inProfiler = false;
+
+struct ProfilerScope
+{
+    bool previous = t_inProfiler;
+
+    ProfilerScope()
+    {
+        t_inProfiler = true;
+    }
+
+    ~ProfilerScope()
+    {
+        t_inProfiler = previous;
+    }
+};
+
+uint64 HashPointer(const void* ptr)
+{
+    return HashMix(reinterpret_cast<uint64>(ptr));
+}
+
+SampleShard& ShardFor(uint64 hash)
+{
+    return s_shards[hash >> (64 - kShardBits)];
+}
+
+uint32 CaptureStack(void** frames)
+{
+#if defined(_WIN32)
+    // Skips this and SampleAllocation
+    return RtlCaptureStackBackTrace(2, kMemoryStackDepth, frames, nullptr);
+#elif defined(RSBL_HAS_EXECINFO)
+    void* captured[kMemoryStackDepth + 2];
+    const int count = backtrace(captured, kMemoryStackDepth + 2);
+    if (count <= 2)
+    {
+        return 0;
+    }
+    memcpy(frames, captured + 2, (count - 2) * sizeof(void*));
+    return static_cast<uint32>(count - 2);
+#else
+    rsblUnused(frames);
+    return 0;
+#endif
+}
+
+// Slot ptr is in, or the empty one it would go in
+uint32 FindSlot(const SampleShard& shard, const void* ptr, uint64 hash)
+{
+    const uint32 mask = shard.capacity - 1;
+    uint32 slot = static_cast<uint32>(hash) & mask;
+    while (shard.records[slot].ptr != nullptr && shard.records[slot].ptr != ptr)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void Grow(SampleShard& shard)
+{
+    SampleRecord* old_records = shard.records;
+    const uint32 old_capacity = shard.capacity;
+    shard.capacity = old_capacity == 0 ? 64 : old_capacity * 2;
+    shard.records = static_cast<SampleRecord*>(calloc(shard.capacity, sizeof(SampleRecord)));
+    rsblAssertMsg(shard.records != nullptr, "Out of memory for allocation samples");
+    for (uint32 i = 0; i < old_capacity; ++i)
+    {
+        if (old_records[i].ptr != nullptr)
+        {
+            const SampleRecord& record = old_records[i];
+            shard.records[FindSlot(shard, record.ptr, HashPointer(record.ptr))] = record;
+        }
+    }
+    free(old_records);
+}
+
+// Backward shift deletion, so lookups never need tombstones
+void RemoveSlot(SampleShard& shard, uint32 slot)
+{
+    const uint32 mask = shard.capacity - 1;
+    uint32 hole = slot;
+    for (uint32 next = (hole + 1) & mask; shard.records[next].ptr != nullptr;
+         next = (next + 1) & mask)
+    {
+        const uint32 home = static_cast<uint32>(HashPointer(shard.records[next].ptr)) & mask;
+        // Moves back into the hole unless its home is after the hole, up to where it is
+        const bool stays = hole <= next ? (hole < home && home <= next)
+                                        : (hole < home || home <= next);
+        if (!stays)
+        {
+            shard.records[hole] = shard.records[next];
+            hole = next;
+        }
+    }
+    shard.records[hole].ptr = nullptr;
+    --shard.size;
+}
+
+void ClearShards()
+{
+    for (SampleShard& shard : s_shards)
+    {
+        std::lock_guard lock(shard.mutex);
+        Internal::g_memorySampleCount.fetch_sub(shard.size, std::memory_order_relaxed);
+        free(shard.records);
+        shard.records = nullptr;
+        shard.capacity = 0;
+        shard.size = 0;
+    }
+}
+
+uint64 SiteKey(MemoryTag tag, const void* const* frames, uint32 frame_count)
+{
+    return HashBytes(frames, frame_count * sizeof(void*), static_cast<uint64>(tag) + 1);
+}
+
+// The order of keys from largest to smallest, as indices. Overwrites keys.
+DynamicArray<uint32> OrderDescending(DynamicArray<uint64>& keys)
+{
+    DynamicArray<uint32> order;
+    order.Resize(keys.Size());
+    for (uint32 i = 0; i < order.Size(); ++i)
+    {
+        // Inverted, so the ascending sort puts the largest first
+        keys[i] = ~keys[i];
+        order[i] = i;
+    }
+    RadixSort(ArrayView<uint64>(keys), order);
+    return order;
+}
+
+// Signed values, in the order they compare in as unsigned
+uint64 SignedKey(int64 value)
+{
+    return static_cast<uint64>(value) ^ (uint64(1) << 63);
+}
+
+// Names each frame's function, where the platform knows it
+class Symbolizer
+{
+  public:
+    Symbolizer()
+    {
+#if defined(_WIN32)
+        s_mutex.lock();
+        if (!s_initialized)
+        {
+            SymSetOptions(SymGetOptions() | SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS |
+                          SYMOPT_LOAD_LINES);
+            s_initialized = SymInitialize(GetCurrentProcess(), nullptr, TRUE) != FALSE;
+        }
+#endif
+    }
+
+    ~Symbolizer()
+    {
+#if defined(_WIN32)
+        s_mutex.unlock();
+#endif
+    }
+
+    Symbolizer(const Symbolizer&) = delete;
+    Symbolizer& operator=(const Symbolizer&) = delete;
+
+    void WriteFrames(FILE* file, const MemoryAllocationSite& site)
+    {
+#if defined(_WIN32)
+        alignas(SYMBOL_INFO) char buffer[sizeof(SYMBOL_INFO) + 256];
+        for (uint32 i = 0; i < site.frameCount; ++i)
+        {
+            const DWORD64 address = reinterpret_cast<DWORD64>(site.frames[i]);
+            SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+            memset(symbol, 0, sizeof(SYMBOL_INFO));
+            symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+            symbol->MaxNameLen = 256;
+            DWORD64 displacement = 0;
+            IMAGEHLP_LINE64 line = {};
+            line.SizeOfStruct = sizeof(line);
+            DWORD line_displacement = 0;
+            if (!s_initialized ||
+                !SymFromAddr(GetCurrentProcess(), address, &displacement, symbol))
+            {
+                fprintf(file, "    %p\n", site.frames[i]);
+            }
+            else if (SymGetLineFromAddr64(
+                         GetCurrentProcess(), address, &line_displacement, &line))
+            {
+                fprintf(file,
+                        "    %p %s (%s:%lu)\n",
+                        site.frames[i],
+                        symbol->Name,
+                        line.FileName,
+                        line.LineNumber);
+            }
+            else
+            {
+                fprintf(file, "    %p %s\n", site.frames[i], symbol->Name);
+            }
+        }
+#elif defined(RSBL_HAS_EXECINFO)
+        // Module and symbol, as the dynamic symbol table has them
+        char** names = backtrace_symbols(const_cast<void* const*>(site.frames),
+                                         static_cast<int>(site.frameCount));
+        for (uint32 i = 0; i < site.frameCount; ++i)
+        {
+            fprintf(file, "    %p %s\n", site.frames[i], names != nullptr ? names[i] : "");
+        }
+        free(names);
+#else
+        for (uint32 i = 0; i < site.frameCount; ++i)
+        {
+            fprintf(file, "    %p\n", site.frames[i]);
+        }
+#endif
+    }
+
+  private:
+#if defined(_WIN32)
+    // DbgHelp is single threaded
+    static inline std::mutex s_mutex;
+    static inline bool s_initialized = false;
+#endif
+};
+
+void WriteSiteHeader(FILE* file, const MemoryAllocationSite& site)
+{
+    fprintf(file,
+            "[%s] %llu bytes in %llu samples\n",
+            MemoryTagName(site.tag),
+            static_cast<unsigned long long>(site.bytes),
+            static_cast<unsigned long long>(site.count));
+}
+} // namespace
+
+bool Internal::SampleAllocation(void* ptr, MemoryTag tag, uint64 size)
+{
+    if (t_inProfiler)
+    {
+        return false;
+    }
+
+    const uint32 generation = s_generation.load(std::memory_order_relaxed);
+    if (t_generation != generation)
+    {
+        t_generation = generation;
+        t_countdown = 0;
+    }
+    if (t_countdown > 1)
+    {
+        --t_countdown;
+        return false;
+    }
+    const uint32 interval = g_memorySampleInterval.load(std::memory_order_relaxed);
+    if (interval == 0)
+    {
+        return false;
+    }
+    t_countdown = interval;
+
+    ProfilerScope scope;
+    SampleRecord record;
+    record.ptr = ptr;
+    record.size = size;
+    record.tag = tag;
+    record.frameCount = CaptureStack(record.frames);
+
+    const uint64 hash = HashPointer(ptr);
+    SampleShard& shard = ShardFor(hash);
+    std::lock_guard lock(shard.mutex);
+    // Kept under half full
+    if ((shard.size + 1) * 2 > shard.capacity)
+    {
+        Grow(shard);
+    }
+    const uint32 slot = FindSlot(shard, ptr, hash);
+    if (shard.records[slot].ptr == nullptr)
+    {
+        ++shard.size;
+        g_memorySampleCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    shard.records[slot] = record;
+    return true;
+}
+
+void Internal::ForgetAllocation(void* ptr)
+{
+    const uint64 hash = HashPointer(ptr);
+    SampleShard& shard = ShardFor(hash);
+    std::lock_guard lock(shard.mutex);
+    if (shard.size == 0)
+    {
+        return;
+    }
+    const uint32 slot = FindSlot(shard, ptr, hash);
+    if (shard.records[slot].ptr != nullptr)
+    {
+        RemoveSlot(shard, slot);
+        g_memorySampleCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void StartMemoryProfiler(uint32 sample_interval)
+{
+    rsblAssert(sample_interval > 0);
+    StopMemoryProfiler();
+    s_generation.fetch_add(1, std::memory_order_relaxed);
+    Internal::g_memorySampleInterval.store(sample_interval, std::memory_order_relaxed);
+}
+
+void StopMemoryProfiler()
+{
+    Internal::g_memorySampleInterval.store(0, std::memory_order_relaxed);
+    ClearShards();
+}
+
+bool IsMemoryProfilerRunning()
+{
+    return Internal::g_memorySampleInterval.load(std::memory_order_relaxed) != 0;
+}
+
+MemorySnapshot TakeMemorySnapshot()
+{
+    ProfilerScope scope;
+    MemorySnapshot snapshot;
+    snapshot.sampleInterval = Internal::g_memorySampleInterval.load(std::memory_order_relaxed);
+
+    // Sites by key. Different stacks with the same 64-bit hash would be merged, which isn't
+    // worth guarding against.
+    HashMap<uint64, uint32> site_indices;
+    DynamicArray<MemoryAllocationSite> sites;
+    for (SampleShard& shard : s_shards)
+    {
+        // Nothing can allocate under the lock, the shard's samples are copied out first
+        SampleRecord* records = nullptr;
+        uint32 count = 0;
+        {
+            std::lock_guard lock(shard.mutex);
+            if (shard.size != 0)
+            {
+                records = static_cast<SampleRecord*>(malloc(shard.size * sizeof(SampleRecord)));
+                rsblAssertMsg(records != nullptr, "Out of memory for a memory snapshot");
+                for (uint32 i = 0; i < shard.capacity; ++i)
+                {
+                    if (shard.records[i].ptr != nullptr)
+                    {
+                        records[count++] = shard.records[i];
+                    }
+                }
+            }
+        }
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            const SampleRecord& record = records[i];
+            const uint64 key = SiteKey(record.tag, record.frames, record.frameCount);
+            uint32* index = site_indices.Find(key);
+            if (index == nullptr)
+            {
+                site_indices.Insert(key, static_cast<uint32>(sites.Size()));
+                MemoryAllocationSite site;
+                site.key = key;
+                site.tag = record.tag;
+                site.frameCount = record.frameCount;
+                memcpy(site.frames, record.frames, record.frameCount * sizeof(void*));
+                sites.PushBack(site);
+                index = site_indices.Find(key);
+            }
+            MemoryAllocationSite& site = sites[*index];
+            ++site.count;
+            site.bytes += record.size;
+            ++snapshot.sampledCount;
+            snapshot.sampledBytes += record.size;
+        }
+        free(records);
+    }
+
+    DynamicArray<uint64> keys;
+    keys.Reserve(sites.Size());
+    for (const MemoryAllocationSite& site : sites)
+    {
+        keys.PushBack(site.bytes);
+    }
+    const DynamicArray<uint32> order = OrderDescending(keys);
+    snapshot.sites.Reserve(sites.Size());
+    for (uint32 index : order)
+    {
+        snapshot.sites.PushBack(sites[index]);
+    }
+    return snapshot;
+}
+
+DynamicArray<MemorySiteDiff> DiffMemorySnapshots(const MemorySnapshot& before,
+                                                 const MemorySnapshot& after)
+{
+    ProfilerScope scope;
+    HashMap<uint64, uint32> before_indices;
+    before_indices.Reserve(before.sites.Size());
+    for (uint32 i = 0; i < before.sites.Size(); ++i)
+    {
+        before_indices.Insert(before.sites[i].key, i);
+    }
+
+    DynamicArray<MemorySiteDiff> changed;
+    DynamicArray<bool> matched;
+    matched.Resize(before.sites.Size());
+    memset(matched.Data(), 0, matched.Size());
+    for (const MemoryAllocationSite& site : after.sites)
+    {
+        MemorySiteDiff diff;
+        diff.site = site;
+        diff.countDelta = static_cast<int64>(site.count);
+        diff.bytesDelta = static_cast<int64>(site.bytes);
+        if (const uint32* index = before_indices.Find(site.key))
+        {
+            matched[*index] = true;
+            diff.countDelta -= static_cast<int64>(before.sites[*index].count);
+            diff.bytesDelta -= static_cast<int64>(before.sites[*index].bytes);
+        }
+        if (diff.countDelta != 0 || diff.bytesDelta != 0)
+        {
+            changed.PushBack(diff);
+        }
+    }
+    for (uint32 i = 0; i < before.sites.Size(); ++i)
+    {
+        if (!matched[i])
+        {
+            MemorySiteDiff diff;
+            diff.site = before.sites[i];
+            diff.site.count = 0;
+            diff.site.bytes = 0;
+            diff.countDelta = -static_cast<int64>(before.sites[i].count);
+            diff.bytesDelta = -static_cast<int64>(before.sites[i].bytes);
+            changed.PushBack(diff);
+        }
+    }
+
+    DynamicArray<uint64> keys;
+    keys.Reserve(changed.Size());
+    for (const MemorySiteDiff& diff : changed)
+    {
+        keys.PushBack(SignedKey(diff.bytesDelta));
+    }
+    const DynamicArray<uint32> order = OrderDescending(keys);
+    DynamicArray<MemorySiteDiff> sorted;
+    sorted.Reserve(changed.Size());
+    for (uint32 index : order)
+    {
+        sorted.PushBack(changed[index]);
+    }
+    return sorted;
+}
+
+Result<> WriteMemorySnapshot(const MemorySnapshot& snapshot, const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        return {ErrorCategory::Io, "Failed to open the memory snapshot file"};
+    }
+
+    fprintf(file,
+            "%llu bytes in %llu samples, one in every %u allocations\n\n",
+            static_cast<unsigned long long>(snapshot.sampledBytes),
+            static_cast<unsigned long long>(snapshot.sampledCount),
+            snapshot.sampleInterval);
+    Symbolizer symbolizer;
+    for (const MemoryAllocationSite& site : snapshot.sites)
+    {
+        WriteSiteHeader(file, site);
+        symbolizer.WriteFrames(file, site);
+        fputc('\n', file);
+    }
+
+    const bool failed = ferror(file) != 0;
+    fclose(file);
+    if (failed)
+    {
+        return {ErrorCategory::Io, "Failed to write the memory snapshot"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> WriteMemorySnapshotDiff(ArrayView<const MemorySiteDiff> diff, const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+    {
+        return {ErrorCategory::Io, "Failed to open the memory diff file"};
+    }
+
+    Symbolizer symbolizer;
+    for (const MemorySiteDiff& change : diff)
+    {
+        fprintf(file,
+                "[%s] %+lld bytes, %+lld samples, now %llu bytes in %llu samples\n",
+                MemoryTagName(change.site.tag),
+                static_cast<long long>(change.bytesDelta),
+                static_cast<long long>(change.countDelta),
+                static_cast<unsigned long long>(change.site.bytes),
+                static_cast<unsigned long long>(change.site.count));
+        symbolizer.WriteFrames(file, change.site);
+        fputc('\n', file);
+    }
+
+    const bool failed = ferror(file) != 0;
+    fclose(file);
+    if (failed)
+    {
+        return {ErrorCategory::Io, "Failed to write the memory diff"};
+    }
+    return ResultCode::Success;
+}
+
+} // namespace rsbl
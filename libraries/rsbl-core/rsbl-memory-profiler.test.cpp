@@ -0,0 +1,191 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-memory-profiler.h"
+#include "include/rsbl-ptr.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+// Sites charged to tag, doctest allocates under Core while the tests run
+uint64 BytesUnder(const MemorySnapshot& snapshot, MemoryTag tag)
+{
+    uint64 bytes = 0;
+    for (const MemoryAllocationSite& site : snapshot.sites)
+    {
+        bytes += site.tag == tag ? site.bytes : 0;
+    }
+    return bytes;
+}
+
+// Out of line, so its allocations come from a stack of their own
+[[gnu::noinline]] void* LeakSomething(TrackingAllocator& allocator, uint64 size)
+{
+    return allocator.Allocate(size, 16);
+}
+} // namespace
+
+TEST_SUITE("rsbl::MemoryProfiler")
+{
+    TEST_CASE("Stopped, nothing is sampled")
+    {
+        StopMemoryProfiler();
+        CHECK_FALSE(IsMemoryProfilerRunning());
+        UniquePtr<int> value = MakeUnique<int>(1);
+        const MemorySnapshot snapshot = TakeMemorySnapshot();
+        CHECK(snapshot.sampledCount == 0);
+        CHECK(snapshot.sites.IsEmpty());
+    }
+
+    TEST_CASE("Live allocations are grouped by site until they're freed")
+    {
+        StartMemoryProfiler(1);
+        CHECK(IsMemoryProfilerRunning());
+
+        HeapAllocator heap;
+        TrackingAllocator scene(MemoryTag::Scene, &heap);
+        void* allocations[8];
+        for (void*& allocation : allocations)
+        {
+            allocation = LeakSomething(scene, 100);
+        }
+
+        MemorySnapshot snapshot = TakeMemorySnapshot();
+        CHECK(snapshot.sampleInterval == 1);
+        CHECK(BytesUnder(snapshot, MemoryTag::Scene) == 800);
+        const MemoryAllocationSite* site = nullptr;
+        for (const MemoryAllocationSite& candidate : snapshot.sites)
+        {
+            site = candidate.tag == MemoryTag::Scene ? &candidate : site;
+        }
+        REQUIRE(site != nullptr);
+        CHECK(site->count == 8);
+#if defined(_WIN32) || __has_include(<execinfo.h>)
+        CHECK(site->frameCount > 0);
+#endif
+
+        for (void* allocation : allocations)
+        {
+            scene.Free(allocation, 100, 16);
+        }
+        snapshot = TakeMemorySnapshot();
+        CHECK(BytesUnder(snapshot, MemoryTag::Scene) == 0);
+        StopMemoryProfiler();
+    }
+
+    TEST_CASE("Every Nth allocation is sampled")
+    {
+        StartMemoryProfiler(4);
+        {
+            MemoryTagScope memoryScope(MemoryTag::Asset);
+            DynamicArray<UniquePtr<int>> values;
+            values.Reserve(64);
+            for (int i = 0; i < 64; ++i)
+            {
+                values.PushBack(MakeUnique<int>(i));
+            }
+
+            // The reserve and 64 ints, one in four of them
+            const MemorySnapshot snapshot = TakeMemorySnapshot();
+            const uint64 bytes = BytesUnder(snapshot, MemoryTag::Asset);
+            CHECK(bytes >= 15 * sizeof(int));
+            CHECK(bytes <= 17 * sizeof(int) + 64 * sizeof(UniquePtr<int>));
+        }
+        CHECK(BytesUnder(TakeMemorySnapshot(), MemoryTag::Asset) == 0);
+        StopMemoryProfiler();
+    }
+
+    TEST_CASE("Diffs list what grew and what went")
+    {
+        StartMemoryProfiler(1);
+        HeapAllocator heap;
+        TrackingAllocator platform(MemoryTag::Platform, &heap);
+        TrackingAllocator jobs(MemoryTag::Jobs, &heap);
+
+        void* kept = LeakSomething(jobs, 64);
+        const MemorySnapshot before = TakeMemorySnapshot();
+        void* grown = LeakSomething(platform, 4096);
+        jobs.Free(kept, 64, 16);
+        const MemorySnapshot after = TakeMemorySnapshot();
+
+        const DynamicArray<MemorySiteDiff> diff = DiffMemorySnapshots(before, after);
+        const MemorySiteDiff* platform_change = nullptr;
+        const MemorySiteDiff* jobs_change = nullptr;
+        for (const MemorySiteDiff& change : diff)
+        {
+            platform_change = change.site.tag == MemoryTag::Platform ? &change : platform_change;
+            jobs_change = change.site.tag == MemoryTag::Jobs ? &change : jobs_change;
+        }
+        REQUIRE(platform_change != nullptr);
+        CHECK(platform_change->bytesDelta == 4096);
+        CHECK(platform_change->countDelta == 1);
+        REQUIRE(jobs_change != nullptr);
+        CHECK(jobs_change->bytesDelta == -64);
+        CHECK(jobs_change->site.count == 0);
+        // Most growth first, what went last
+        CHECK(diff[0].bytesDelta >= 4096);
+        CHECK(diff[diff.Size() - 1].bytesDelta <= -64);
+
+        const char* path = "rsbl-memory-profiler-test.txt";
+        REQUIRE(WriteMemorySnapshotDiff(diff, path));
+        FILE* file = fopen(path, "r");
+        REQUIRE(file != nullptr);
+        char text[4096] = {};
+        fread(text, 1, sizeof(text) - 1, file);
+        fclose(file);
+        CHECK(strstr(text, "[Platform] +4096 bytes, +1 samples, now 4096 bytes in 1 samples") !=
+              nullptr);
+        CHECK(strstr(text, "[Jobs] -64 bytes, -1 samples, now 0 bytes in 0 samples") != nullptr);
+
+        REQUIRE(WriteMemorySnapshot(after, path));
+        file = fopen(path, "r");
+        REQUIRE(file != nullptr);
+        memset(text, 0, sizeof(text));
+        fread(text, 1, sizeof(text) - 1, file);
+        fclose(file);
+        CHECK(strstr(text, "one in every 1 allocations") != nullptr);
+        CHECK(strstr(text, "[Platform] 4096 bytes in 1 samples") != nullptr);
+        remove(path);
+
+        platform.Free(grown, 4096, 16);
+        StopMemoryProfiler();
+    }
+
+    TEST_CASE("Many samples survive growing and removal")
+    {
+        StartMemoryProfiler(1);
+        HeapAllocator heap;
+        TrackingAllocator scene(MemoryTag::Scene, &heap);
+        DynamicArray<void*> allocations;
+        {
+            // The array itself isn't what's being counted
+            MemoryTagScope memoryScope(MemoryTag::Core);
+            allocations.Reserve(4096);
+        }
+        for (uint32 i = 0; i < 4096; ++i)
+        {
+            allocations.PushBack(LeakSomething(scene, 8));
+        }
+        CHECK(BytesUnder(TakeMemorySnapshot(), MemoryTag::Scene) == 4096 * 8);
+
+        // Every other one, so removal has to shift neighbours back into place
+        for (uint32 i = 0; i < allocations.Size(); i += 2)
+        {
+            scene.Free(allocations[i], 8, 16);
+        }
+        CHECK(BytesUnder(TakeMemorySnapshot(), MemoryTag::Scene) == 2048 * 8);
+        for (uint32 i = 1; i < allocations.Size(); i += 2)
+        {
+            scene.Free(allocations[i], 8, 16);
+        }
+        CHECK(BytesUnder(TakeMemorySnapshot(), MemoryTag::Scene) == 0);
+        StopMemoryProfiler();
+    }
+}
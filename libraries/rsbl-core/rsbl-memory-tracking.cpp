@@ -0,0 +1,394 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-memory-tracking.h"
+
+#include "include/rsbl-assert.h"
+#include "rsbl-log.h"
+#include "rsbl-memory-profiler-internal.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+constexpr uint32 kTagCount = static_cast<uint32>(rsbl::MemoryTag::Count);
+
+// Each tag on its own cache line, so subsystems allocating on different threads don't contend
+struct alignas(64) TagCounters
+{
+    std::atomic<uint64> liveBytes{0};
+    std::atomic<uint64> liveAllocations{0};
+    std::atomic<uint64> peakBytes{0};
+    std::atomic<uint64> totalAllocations{0};
+    std::atomic<uint64> frameAllocations{0};
+    std::atomic<uint64> frameBytes{0};
+    std::atomic<uint64> lastFrameAllocations{0};
+    std::atomic<uint64> lastFrameBytes{0};
+    std::atomic<uint64> peakFrameAllocations{0};
+    std::atomic<uint64> peakFrameBytes{0};
+    std::atomic<uint64> budgetBytes{0};
+};
+
+constinit TagCounters s_counters[kTagCount];
+
+constinit std::atomic<uint32> s_logInterval{0};
+constinit std::atomic<uint64> s_frameCount{0};
+
+// Constant initialized, so this is safe to touch from global new during static init
+constinit thread_local rsbl::MemoryTag s_currentTag = rsbl::MemoryTag::Core;
+
+// Constant initialized for the same reason, containers can be constructed during static init
+constinit rsbl::HeapAllocator s_heapAllocator;
+constinit rsbl::TrackingAllocator s_taggedAllocators[kTagCount] = {
+    {rsbl::MemoryTag::Core, &s_heapAllocator},
+    {rsbl::MemoryTag::Ga, &s_heapAllocator},
+    {rsbl::MemoryTag::Platform, &s_heapAllocator},
+    {rsbl::MemoryTag::Asset, &s_heapAllocator},
+    {rsbl::MemoryTag::Scene, &s_heapAllocator},
+    {rsbl::MemoryTag::Jobs, &s_heapAllocator},
+};
+
+TagCounters& CountersFor(rsbl::MemoryTag tag)
+{
+    return s_counters[static_cast<uint32>(tag)];
+}
+
+void UpdateMax(std::atomic<uint64>& max, uint64 value)
+{
+    uint64 current = max.load(std::memory_order_relaxed);
+    while (value > current &&
+           !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+} // namespace
+
+namespace rsbl
+{
+
+const char* MemoryTagName(MemoryTag tag)
+{
+    switch (tag)
+    {
+    case MemoryTag::Core:
+        return "Core";
+    case MemoryTag::Ga:
+        return "Ga";
+    case MemoryTag::Platform:
+        return "Platform";
+    case MemoryTag::Asset:
+        return "Asset";
+    case MemoryTag::Scene:
+        return "Scene";
+    case MemoryTag::Jobs:
+        return "Jobs";
+    default:
+        return "Unknown";
+    }
+}
+
+MemoryTag GetCurrentMemoryTag()
+{
+    return s_currentTag;
+}
+
+MemoryTagScope::MemoryTagScope(MemoryTag tag)
+    : m_previous(s_currentTag)
+{
+    s_currentTag = tag;
+}
+
+MemoryTagScope::~MemoryTagScope()
+{
+    s_currentTag = m_previous;
+}
+
+void* TrackingAllocator::Allocate(uint64 size, uint64 alignment)
+{
+    void* ptr = m_backing->Allocate(size, alignment);
+    if (ptr != nullptr)
+    {
+        RecordAllocation(m_tag, size);
+        Internal::MaybeSampleAllocation(ptr, m_tag, size);
+    }
+    return ptr;
+}
+
+void TrackingAllocator::Free(void* ptr, uint64 size, uint64 alignment)
+{
+    if (ptr != nullptr)
+    {
+        RecordFree(m_tag, size);
+        Internal::MaybeForgetAllocation(ptr);
+    }
+    m_backing->Free(ptr, size, alignment);
+}
+
+void* TrackingAllocator::Reallocate(void* ptr, uint64 old_size, uint64 new_size, uint64 alignment)
+{
+    void* new_ptr = m_backing->Reallocate(ptr, old_size, new_size, alignment);
+    if (new_ptr != nullptr)
+    {
+        // Counted as a fresh allocation, a Grow in the middle of a frame is exactly the kind of
+        // spike we're looking for
+        if (ptr != nullptr)
+        {
+            RecordFree(m_tag, old_size);
+            Internal::MaybeForgetAllocation(ptr);
+        }
+        RecordAllocation(m_tag, new_size);
+        Internal::MaybeSampleAllocation(new_ptr, m_tag, new_size);
+    }
+    return new_ptr;
+}
+
+Allocator* GetTaggedAllocator(MemoryTag tag)
+{
+#if defined(RSBL_MEMORY_TRACKING_ENABLED)
+    return &s_taggedAllocators[static_cast<uint32>(tag)];
+#else
+    rsblUnused(tag);
+    return &s_heapAllocator;
+#endif
+}
+
+void RecordAllocation(MemoryTag tag, uint64 size)
+{
+#if defined(RSBL_MEMORY_TRACKING_ENABLED)
+    TagCounters& counters = CountersFor(tag);
+    const uint64 live = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    UpdateMax(counters.peakBytes, live);
+    counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.frameBytes.fetch_add(size, std::memory_order_relaxed);
+#else
+    rsblUnused(tag);
+    rsblUnused(size);
+#endif
+}
+
+void RecordFree(MemoryTag tag, uint64 size)
+{
+#if defined(RSBL_MEMORY_TRACKING_ENABLED)
+    TagCounters& counters = CountersFor(tag);
+    counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+#else
+    rsblUnused(tag);
+    rsblUnused(size);
+#endif
+}
+
+MemoryStats GetMemoryStats(MemoryTag tag)
+{
+    const TagCounters& counters = CountersFor(tag);
+
+    MemoryStats stats;
+    stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    stats.liveAllocations = counters.liveAllocations.load(std::memory_order_relaxed);
+    stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    stats.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+    stats.frameAllocations = counters.frameAllocations.load(std::memory_order_relaxed);
+    stats.frameBytes = counters.frameBytes.load(std::memory_order_relaxed);
+    stats.lastFrameAllocations = counters.lastFrameAllocations.load(std::memory_order_relaxed);
+    stats.lastFrameBytes = counters.lastFrameBytes.load(std::memory_order_relaxed);
+    stats.peakFrameAllocations = counters.peakFrameAllocations.load(std::memory_order_relaxed);
+    stats.peakFrameBytes = counters.peakFrameBytes.load(std::memory_order_relaxed);
+    stats.budgetBytes = counters.budgetBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ResetMemoryPeaks()
+{
+    for (TagCounters& counters : s_counters)
+    {
+        // An allocation racing this can push the peak up again, never below what's live
+        counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+        UpdateMax(counters.peakBytes, counters.liveBytes.load(std::memory_order_relaxed));
+    }
+}
+
+void SetMemoryBudget(MemoryTag tag, uint64 budget_bytes)
+{
+    CountersFor(tag).budgetBytes.store(budget_bytes, std::memory_order_relaxed);
+}
+
+bool IsOverMemoryBudget(MemoryTag tag)
+{
+    const TagCounters& counters = CountersFor(tag);
+    const uint64 budget = counters.budgetBytes.load(std::memory_order_relaxed);
+    return budget != 0 && counters.liveBytes.load(std::memory_order_relaxed) > budget;
+}
+
+void MemoryTrackingEndFrame()
+{
+    for (uint32 i = 0; i < kTagCount; ++i)
+    {
+        TagCounters& counters = s_counters[i];
+        const uint64 allocations = counters.frameAllocations.exchange(0, std::memory_order_relaxed);
+        const uint64 bytes = counters.frameBytes.exchange(0, std::memory_order_relaxed);
+        counters.lastFrameAllocations.store(allocations, std::memory_order_relaxed);
+        counters.lastFrameBytes.store(bytes, std::memory_order_relaxed);
+        UpdateMax(counters.peakFrameAllocations, allocations);
+        UpdateMax(counters.peakFrameBytes, bytes);
+
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        if (IsOverMemoryBudget(tag) && g_logger != nullptr)
+        {
+            RSBL_LOG_WARNING("Memory [{}] over budget: {} live bytes, budget {} bytes",
+                             MemoryTagName(tag),
+                             counters.liveBytes.load(std::memory_order_relaxed),
+                             counters.budgetBytes.load(std::memory_order_relaxed));
+        }
+    }
+
+    const uint64 frame = s_frameCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    const uint32 interval = s_logInterval.load(std::memory_order_relaxed);
+    if (interval != 0 && frame % interval == 0)
+    {
+        LogMemoryStats();
+    }
+}
+
+void SetMemoryStatsLogInterval(uint32 frame_count)
+{
+    s_logInterval.store(frame_count, std::memory_order_relaxed);
+}
+
+void LogMemoryStats()
+{
+    // Tracking can run before LogInit, e.g. from tests
+    if (g_logger == nullptr)
+    {
+        return;
+    }
+
+    for (uint32 i = 0; i < kTagCount; ++i)
+    {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        const MemoryStats stats = GetMemoryStats(tag);
+        RSBL_LOG_INFO("Memory [{}]: {} bytes in {} allocations, peak {} bytes, last frame {} "
+                      "allocations ({} bytes), worst frame {} allocations ({} bytes)",
+                      MemoryTagName(tag),
+                      stats.liveBytes,
+                      stats.liveAllocations,
+                      stats.peakBytes,
+                      stats.lastFrameAllocations,
+                      stats.lastFrameBytes,
+                      stats.peakFrameAllocations,
+                      stats.peakFrameBytes);
+    }
+}
+
+} // namespace rsbl
+
+// Global new/delete, so MakeUnique and any other raw new is charged to the current scope's tag.
+// Delete isn't reliably handed a size, so each allocation carries a small header with the size
+// and tag. The header is 16 bytes to keep the default new alignment. Over-aligned new isn't
+// replaced, it pairs with the runtime's own aligned delete and goes untracked.
+#if defined(RSBL_MEMORY_TRACKING_ENABLED)
+
+namespace
+{
+struct alignas(16) NewHeader
+{
+    uint64 size;
+    rsbl::MemoryTag tag;
+    bool sampled; // Only sampled allocations look themselves up in the profiler when freed
+};
+
+static_assert(sizeof(NewHeader) == 16);
+
+void* TrackedNew(std::size_t size)
+{
+    void* raw = malloc(size + sizeof(NewHeader));
+    if (raw == nullptr)
+    {
+        return nullptr;
+    }
+
+    NewHeader* header = static_cast<NewHeader*>(raw);
+    header->size = size;
+    header->tag = s_currentTag;
+    rsbl::RecordAllocation(header->tag, size);
+    header->sampled = rsbl::Internal::MaybeSampleAllocation(header + 1, header->tag, size);
+    return header + 1;
+}
+
+void TrackedDelete(void* ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    NewHeader* header = static_cast<NewHeader*>(ptr) - 1;
+    rsbl::RecordFree(header->tag, header->size);
+    if (header->sampled)
+    {
+        rsbl::Internal::ForgetAllocation(ptr);
+    }
+    free(header);
+}
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    void* ptr = TrackedNew(size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedNew(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedNew(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    TrackedDelete(ptr);
+}
+
+#endif
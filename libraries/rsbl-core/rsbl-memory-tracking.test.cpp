@@ -0,0 +1,175 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-memory-tracking.h"
+#include "include/rsbl-ptr.h"
+
+using namespace rsbl;
+
+// Other tests (and doctest itself) allocate under Core, so these stick to the other tags and
+// compare against a baseline
+
+TEST_SUITE("rsbl::MemoryTracking")
+{
+    TEST_CASE("TrackingAllocator charges its tag")
+    {
+        HeapAllocator heap;
+        TrackingAllocator tracking(MemoryTag::Asset, &heap);
+        const MemoryStats before = GetMemoryStats(MemoryTag::Asset);
+
+        void* ptr = tracking.Allocate(128, 16);
+        REQUIRE(ptr != nullptr);
+
+        MemoryStats during = GetMemoryStats(MemoryTag::Asset);
+        CHECK(during.liveBytes == before.liveBytes + 128);
+        CHECK(during.liveAllocations == before.liveAllocations + 1);
+        CHECK(during.totalAllocations == before.totalAllocations + 1);
+        CHECK(during.peakBytes >= during.liveBytes);
+
+        ptr = tracking.Reallocate(ptr, 128, 512, 16);
+        REQUIRE(ptr != nullptr);
+        during = GetMemoryStats(MemoryTag::Asset);
+        CHECK(during.liveBytes == before.liveBytes + 512);
+        CHECK(during.liveAllocations == before.liveAllocations + 1);
+
+        tracking.Free(ptr, 512, 16);
+
+        const MemoryStats after = GetMemoryStats(MemoryTag::Asset);
+        CHECK(after.liveBytes == before.liveBytes);
+        CHECK(after.liveAllocations == before.liveAllocations);
+        CHECK(after.peakBytes >= before.liveBytes + 512);
+    }
+
+    TEST_CASE("MemoryTagScope nests and restores")
+    {
+        CHECK(GetCurrentMemoryTag() == MemoryTag::Core);
+        {
+            MemoryTagScope ga_scope(MemoryTag::Ga);
+            CHECK(GetCurrentMemoryTag() == MemoryTag::Ga);
+            CHECK(GetDefaultAllocator() == GetTaggedAllocator(MemoryTag::Ga));
+            {
+                MemoryTagScope platform_scope(MemoryTag::Platform);
+                CHECK(GetCurrentMemoryTag() == MemoryTag::Platform);
+            }
+            CHECK(GetCurrentMemoryTag() == MemoryTag::Ga);
+        }
+        CHECK(GetCurrentMemoryTag() == MemoryTag::Core);
+        CHECK(GetDefaultAllocator() == GetTaggedAllocator(MemoryTag::Core));
+    }
+
+#if defined(RSBL_MEMORY_TRACKING_ENABLED)
+    TEST_CASE("Containers keep the tag they were constructed under")
+    {
+        const MemoryStats before = GetMemoryStats(MemoryTag::Platform);
+
+        DynamicArray<uint64>* array = nullptr;
+        {
+            MemoryTagScope scope(MemoryTag::Platform);
+            array = new DynamicArray<uint64>();
+        }
+
+        // Growing and freeing outside the scope still charges Platform
+        for (uint64 i = 0; i < 100; ++i)
+        {
+            array->PushBack(i);
+        }
+        CHECK(GetMemoryStats(MemoryTag::Platform).liveBytes >=
+              before.liveBytes + 100 * sizeof(uint64));
+
+        MemoryTagScope scope(MemoryTag::Platform);
+        delete array;
+        CHECK(GetMemoryStats(MemoryTag::Platform).liveBytes == before.liveBytes);
+    }
+
+    TEST_CASE("MakeUnique is charged through global new")
+    {
+        struct Payload
+        {
+            uint8 bytes[200];
+        };
+
+        const MemoryStats before = GetMemoryStats(MemoryTag::Ga);
+        UniquePtr<Payload> ptr;
+        {
+            MemoryTagScope scope(MemoryTag::Ga);
+            ptr = MakeUnique<Payload>();
+        }
+        CHECK(GetMemoryStats(MemoryTag::Ga).liveBytes == before.liveBytes + sizeof(Payload));
+
+        // Freed outside the scope, the header remembers the tag
+        ptr.Reset();
+        CHECK(GetMemoryStats(MemoryTag::Ga).liveBytes == before.liveBytes);
+    }
+
+    TEST_CASE("EndFrame rolls the frame counters over")
+    {
+        MemoryTrackingEndFrame();
+        CHECK(GetMemoryStats(MemoryTag::Asset).frameAllocations == 0);
+
+        Allocator* allocator = GetTaggedAllocator(MemoryTag::Asset);
+        void* ptrs[5];
+        for (void*& ptr : ptrs)
+        {
+            ptr = allocator->Allocate(64, 16);
+        }
+
+        MemoryStats stats = GetMemoryStats(MemoryTag::Asset);
+        CHECK(stats.frameAllocations == 5);
+        CHECK(stats.frameBytes == 5 * 64);
+
+        MemoryTrackingEndFrame();
+        stats = GetMemoryStats(MemoryTag::Asset);
+        CHECK(stats.frameAllocations == 0);
+        CHECK(stats.lastFrameAllocations == 5);
+        CHECK(stats.lastFrameBytes == 5 * 64);
+        CHECK(stats.peakFrameAllocations >= 5);
+
+        for (void* ptr : ptrs)
+        {
+            allocator->Free(ptr, 64, 16);
+        }
+        MemoryTrackingEndFrame();
+        CHECK(GetMemoryStats(MemoryTag::Asset).lastFrameAllocations == 0);
+        CHECK(GetMemoryStats(MemoryTag::Asset).peakFrameAllocations >= 5);
+    }
+
+    TEST_CASE("Peaks reset to what's live")
+    {
+        Allocator* allocator = GetTaggedAllocator(MemoryTag::Asset);
+        void* big = allocator->Allocate(1 << 20, 16);
+        allocator->Free(big, 1 << 20, 16);
+        const uint64 live = GetMemoryStats(MemoryTag::Asset).liveBytes;
+        CHECK(GetMemoryStats(MemoryTag::Asset).peakBytes >= live + (1 << 20));
+
+        ResetMemoryPeaks();
+        CHECK(GetMemoryStats(MemoryTag::Asset).peakBytes == live);
+
+        void* small = allocator->Allocate(4096, 16);
+        CHECK(GetMemoryStats(MemoryTag::Asset).peakBytes == live + 4096);
+        allocator->Free(small, 4096, 16);
+    }
+
+    TEST_CASE("Budget")
+    {
+        Allocator* allocator = GetTaggedAllocator(MemoryTag::Asset);
+        const uint64 live = GetMemoryStats(MemoryTag::Asset).liveBytes;
+
+        SetMemoryBudget(MemoryTag::Asset, live + 1024);
+        CHECK(GetMemoryStats(MemoryTag::Asset).budgetBytes == live + 1024);
+        CHECK_FALSE(IsOverMemoryBudget(MemoryTag::Asset));
+
+        void* ptr = allocator->Allocate(2048, 16);
+        CHECK(IsOverMemoryBudget(MemoryTag::Asset));
+
+        allocator->Free(ptr, 2048, 16);
+        CHECK_FALSE(IsOverMemoryBudget(MemoryTag::Asset));
+
+        SetMemoryBudget(MemoryTag::Asset, 0);
+        CHECK_FALSE(IsOverMemoryBudget(MemoryTag::Asset));
+    }
+#endif
+}
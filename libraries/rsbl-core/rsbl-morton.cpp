@@ -0,0 +1,92 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-morton.h"
+
+#include "include/rsbl-assert.h"
+#include "include/rsbl-cpu.h"
+#include "rsbl-wide-kernels.h"
+
+namespace rsbl
+{
+
+namespace
+{
+// The wide builds use pdep, which loses to the baseline's shifts where it's microcoded
+const Internal::WideKernels& MortonKernels()
+{
+    static const Internal::WideKernels& s_kernels = GetCpuFeatures().slowPdep
+                                                        ? *Internal::GetWideKernelsBaseline()
+                                                        : Internal::GetWideKernels();
+    return s_kernels;
+}
+
+// Points get quantized in blocks this size, then encoded in one kernel call
+constexpr uint64 kQuantizeBlock = 256;
+
+uint32 QuantizeAxis(float value, float min, float scale)
+{
+    const float cell = (value - min) * scale;
+    if (!(cell > 0.0f))
+    {
+        // Below the bounds, a flat axis or NaN
+        return 0;
+    }
+    return cell < 2097151.0f ? static_cast<uint32>(cell) : 2097151u;
+}
+
+float AxisScale(float min, float max)
+{
+    return max > min ? 2097151.0f / (max - min) : 0.0f;
+}
+} // namespace
+
+void MortonEncode2(ArrayView<const uint2> points, ArrayView<uint64> codes)
+{
+    rsblAssert(points.Size() == codes.Size());
+    MortonKernels().mortonEncode2(reinterpret_cast<const uint32*>(points.Data()), points.Size(),
+                                  codes.Data());
+}
+
+void MortonEncode3(ArrayView<const uint3> points, ArrayView<uint64> codes)
+{
+    rsblAssert(points.Size() == codes.Size());
+    MortonKernels().mortonEncode3(reinterpret_cast<const uint32*>(points.Data()), points.Size(),
+                                  codes.Data());
+}
+
+void MortonEncode3(ArrayView<const float3> points, const Aabb& bounds, ArrayView<uint64> codes)
+{
+    rsblAssert(points.Size() == codes.Size());
+    const float scale_x = AxisScale(bounds.min.x, bounds.max.x);
+    const float scale_y = AxisScale(bounds.min.y, bounds.max.y);
+    const float scale_z = AxisScale(bounds.min.z, bounds.max.z);
+    const Internal::WideKernels& kernels = MortonKernels();
+
+    uint32 cells[kQuantizeBlock * 3];
+    for (uint64 first = 0; first < points.Size(); first += kQuantizeBlock)
+    {
+        const uint64 count =
+            points.Size() - first < kQuantizeBlock ? points.Size() - first : kQuantizeBlock;
+        for (uint64 i = 0; i < count; ++i)
+        {
+            const float3& point = points[first + i];
+            cells[i * 3 + 0] = QuantizeAxis(point.x, bounds.min.x, scale_x);
+            cells[i * 3 + 1] = QuantizeAxis(point.y, bounds.min.y, scale_y);
+            cells[i * 3 + 2] = QuantizeAxis(point.z, bounds.min.z, scale_z);
+        }
+        kernels.mortonEncode3(cells, count, codes.Data() + first);
+    }
+}
+
+void HilbertEncode3(ArrayView<const uint3> points, ArrayView<uint64> indices, uint32 bits)
+{
+    rsblAssert(points.Size() == indices.Size());
+    rsblAssert(bits >= 1 && bits <= 21);
+    for (uint64 i = 0; i < points.Size(); ++i)
+    {
+        indices[i] = HilbertEncode3(points[i], bits);
+    }
+}
+
+} // namespace rsbl
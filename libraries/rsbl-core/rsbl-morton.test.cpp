@@ -0,0 +1,295 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-morton.h"
+#include "rsbl-wide-kernels.h"
+
+using namespace rsbl;
+
+namespace
+{
+// Deterministic stream of 32-bit values
+struct Random
+{
+    uint64 state = 7;
+
+    uint32 Next()
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<uint32>(state >> 32);
+    }
+};
+
+uint32 Distance(uint32 a, uint32 b)
+{
+    return a > b ? a - b : b - a;
+}
+
+// Compile-time tables, the way a renderer would bake them
+constexpr uint64 kEncoded2 = MortonEncode2(uint2(0xffffffffu, 0));
+constexpr uint64 kEncoded3 = MortonEncode3(uint3(0, 0, 0x1fffff));
+static_assert(kEncoded2 == 0x5555555555555555ull);
+static_assert(kEncoded3 == 0x4924924924924924ull);
+static_assert(MortonDecode3(MortonEncode3(uint3(5, 6, 7))).y == 6);
+static_assert(HilbertDecode2(HilbertEncode2(uint2(3, 9), 4), 4).x == 3);
+} // namespace
+
+TEST_SUITE("rsbl::Morton")
+{
+    TEST_CASE("2D encode and decode")
+    {
+        CHECK(MortonEncode2(uint2(0, 0)) == 0);
+        CHECK(MortonEncode2(uint2(1, 0)) == 1);
+        CHECK(MortonEncode2(uint2(0, 1)) == 2);
+        CHECK(MortonEncode2(uint2(3, 3)) == 15);
+        CHECK(MortonEncode2(uint2(0, 0xffffffffu)) == 0xaaaaaaaaaaaaaaaaull);
+        CHECK(MortonEncode2(uint2(0xffffffffu, 0xffffffffu)) == ~0ull);
+
+        Random random;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            const uint2 p(random.Next(), random.Next());
+            const uint64 code = MortonEncode2(p);
+            REQUIRE(code == (Internal::SpreadBits2(p.x) | (Internal::SpreadBits2(p.y) << 1)));
+            const uint2 decoded = MortonDecode2(code);
+            REQUIRE(decoded.x == p.x);
+            REQUIRE(decoded.y == p.y);
+        }
+    }
+
+    TEST_CASE("3D encode and decode")
+    {
+        CHECK(MortonEncode3(uint3(1, 0, 0)) == 1);
+        CHECK(MortonEncode3(uint3(0, 1, 0)) == 2);
+        CHECK(MortonEncode3(uint3(0, 0, 1)) == 4);
+        CHECK(MortonEncode3(uint3(2, 0, 0)) == 8);
+        CHECK(MortonEncode3(uint3(0x1fffff, 0x1fffff, 0x1fffff)) == 0x7fffffffffffffffull);
+        // Bits past 21 are dropped
+        CHECK(MortonEncode3(uint3(0xffe00000u, 0, 0)) == 0);
+
+        Random random;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            const uint3 p(random.Next() & 0x1fffff, random.Next() & 0x1fffff,
+                          random.Next() & 0x1fffff);
+            const uint3 decoded = MortonDecode3(MortonEncode3(p));
+            REQUIRE(decoded.x == p.x);
+            REQUIRE(decoded.y == p.y);
+            REQUIRE(decoded.z == p.z);
+        }
+    }
+
+    TEST_CASE("Morton order is the octree order")
+    {
+        // Sorting by code groups each 2x2x2 block of cells before moving to the next block
+        for (uint32 code = 0; code < 64; ++code)
+        {
+            const uint3 p = MortonDecode3(code);
+            CHECK(p.x / 2 + (p.y / 2) * 2 + (p.z / 2) * 4 == code / 8);
+        }
+    }
+
+    TEST_CASE("Every SIMD level encodes arrays like the single value functions")
+    {
+        constexpr uint32 kCount = 301;
+        Random random;
+        DynamicArray<uint2> points2;
+        DynamicArray<uint3> points3;
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            points2.PushBack(uint2(random.Next(), random.Next()));
+            points3.PushBack(uint3(random.Next() & 0x1fffff, random.Next() & 0x1fffff,
+                                   random.Next() & 0x1fffff));
+        }
+
+        DynamicArray<uint64> codes;
+        codes.Resize(kCount);
+        MortonEncode2(points2, codes);
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            REQUIRE(codes[i] == MortonEncode2(points2[i]));
+        }
+        MortonEncode3(points3, codes);
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            REQUIRE(codes[i] == MortonEncode3(points3[i]));
+        }
+
+        for (uint32 level = 0; level < static_cast<uint32>(SimdLevel::Count); ++level)
+        {
+            const Internal::WideKernels* kernels =
+                Internal::GetWideKernels(static_cast<SimdLevel>(level));
+            if (kernels == nullptr)
+            {
+                continue;
+            }
+            CAPTURE(SimdLevelName(kernels->level));
+
+            kernels->mortonEncode2(&points2[0].x, kCount, codes.Data());
+            for (uint32 i = 0; i < kCount; ++i)
+            {
+                REQUIRE(codes[i] == MortonEncode2(points2[i]));
+            }
+            kernels->mortonEncode3(&points3[0].x, kCount, codes.Data());
+            for (uint32 i = 0; i < kCount; ++i)
+            {
+                REQUIRE(codes[i] == MortonEncode3(points3[i]));
+            }
+        }
+    }
+
+    TEST_CASE("Quantizing points over bounds")
+    {
+        const Aabb bounds{float3(-1.0f, 0.0f, 10.0f), float3(1.0f, 4.0f, 10.0f)};
+        const float3 points[] = {
+            float3(-1.0f, 0.0f, 10.0f), // Min corner
+            float3(1.0f, 4.0f, 10.0f),  // Max corner, z is flat
+            float3(-5.0f, 9.0f, 3.0f),  // Clamps to (0, max, 0)
+            float3(0.0f, 2.0f, 10.0f),  // Middle
+        };
+        uint64 codes[4];
+        MortonEncode3(points, bounds, codes);
+
+        CHECK(codes[0] == 0);
+        CHECK(codes[1] == MortonEncode3(uint3(0x1fffff, 0x1fffff, 0)));
+        CHECK(codes[2] == MortonEncode3(uint3(0, 0x1fffff, 0)));
+        CHECK(codes[3] == MortonEncode3(uint3(0x0fffff, 0x0fffff, 0)));
+
+        // More points than one quantization block
+        DynamicArray<float3> many;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            many.PushBack(float3(static_cast<float>(i % 10) * 0.2f - 1.0f,
+                                 static_cast<float>(i % 7) * 0.5f, 10.0f));
+        }
+        DynamicArray<uint64> many_codes;
+        many_codes.Resize(many.Size());
+        MortonEncode3(many, bounds, many_codes);
+        for (uint32 i = 0; i < many.Size(); ++i)
+        {
+            const float3 single[] = {many[i]};
+            uint64 single_code[1];
+            MortonEncode3(single, bounds, single_code);
+            REQUIRE(many_codes[i] == single_code[0]);
+        }
+    }
+}
+
+TEST_SUITE("rsbl::Hilbert")
+{
+    TEST_CASE("2D curve visits every cell, one step at a time")
+    {
+        for (uint32 bits = 1; bits <= 5; ++bits)
+        {
+            CAPTURE(bits);
+            const uint32 side = 1u << bits;
+            DynamicArray<bool> seen;
+            seen.Resize(side * side);
+            for (uint32 i = 0; i < side * side; ++i)
+            {
+                seen[i] = false;
+            }
+
+            uint2 previous(0, 0);
+            for (uint64 index = 0; index < side * side; ++index)
+            {
+                const uint2 p = HilbertDecode2(index, bits);
+                REQUIRE(p.x < side);
+                REQUIRE(p.y < side);
+                REQUIRE_FALSE(seen[p.y * side + p.x]);
+                seen[p.y * side + p.x] = true;
+                REQUIRE(HilbertEncode2(p, bits) == index);
+                if (index > 0)
+                {
+                    REQUIRE(Distance(p.x, previous.x) + Distance(p.y, previous.y) == 1);
+                }
+                previous = p;
+            }
+            // Starts and ends on the same edge
+            CHECK(HilbertDecode2(0, bits).x == 0);
+            CHECK(HilbertDecode2(0, bits).y == 0);
+        }
+    }
+
+    TEST_CASE("3D curve visits every cell, one step at a time")
+    {
+        for (uint32 bits = 1; bits <= 3; ++bits)
+        {
+            CAPTURE(bits);
+            const uint32 side = 1u << bits;
+            DynamicArray<bool> seen;
+            seen.Resize(side * side * side);
+            for (uint32 i = 0; i < seen.Size(); ++i)
+            {
+                seen[i] = false;
+            }
+
+            uint3 previous(0, 0, 0);
+            for (uint64 index = 0; index < seen.Size(); ++index)
+            {
+                const uint3 p = HilbertDecode3(index, bits);
+                REQUIRE(p.x < side);
+                REQUIRE(p.y < side);
+                REQUIRE(p.z < side);
+                const uint32 cell = (p.z * side + p.y) * side + p.x;
+                REQUIRE_FALSE(seen[cell]);
+                seen[cell] = true;
+                REQUIRE(HilbertEncode3(p, bits) == index);
+                if (index > 0)
+                {
+                    REQUIRE(Distance(p.x, previous.x) + Distance(p.y, previous.y) +
+                                Distance(p.z, previous.z) ==
+                            1);
+                }
+                previous = p;
+            }
+        }
+    }
+
+    TEST_CASE("Full precision round trips")
+    {
+        Random random;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            const uint2 p2(random.Next(), random.Next());
+            const uint2 decoded2 = HilbertDecode2(HilbertEncode2(p2));
+            REQUIRE(decoded2.x == p2.x);
+            REQUIRE(decoded2.y == p2.y);
+
+            const uint3 p3(random.Next() & 0x1fffff, random.Next() & 0x1fffff,
+                           random.Next() & 0x1fffff);
+            const uint3 decoded3 = HilbertDecode3(HilbertEncode3(p3));
+            REQUIRE(decoded3.x == p3.x);
+            REQUIRE(decoded3.y == p3.y);
+            REQUIRE(decoded3.z == p3.z);
+        }
+
+        // Neighbours along the curve stay neighbours at full precision too
+        const uint64 index = 0x123456789abcull;
+        const uint3 a = HilbertDecode3(index);
+        const uint3 b = HilbertDecode3(index + 1);
+        CHECK(Distance(a.x, b.x) + Distance(a.y, b.y) + Distance(a.z, b.z) == 1);
+    }
+
+    TEST_CASE("Array version")
+    {
+        Random random;
+        DynamicArray<uint3> points;
+        for (uint32 i = 0; i < 50; ++i)
+        {
+            points.PushBack(uint3(random.Next() & 0x3ff, random.Next() & 0x3ff,
+                                  random.Next() & 0x3ff));
+        }
+        DynamicArray<uint64> indices;
+        indices.Resize(points.Size());
+        HilbertEncode3(points, indices, 10);
+        for (uint32 i = 0; i < points.Size(); ++i)
+        {
+            CHECK(indices[i] == HilbertEncode3(points[i], 10));
+        }
+    }
+}
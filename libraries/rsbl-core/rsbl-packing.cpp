@@ -0,0 +1,444 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-packing.h"
+
+#include "include/rsbl-assert.h"
+#include "rsbl-wide-kernels.h"
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+uint32 FloatBits(float value)
+{
+    uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float BitsToFloat(uint32 bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Drops shift bits off value, rounding to nearest even
+uint32 ShiftRightRounded(uint32 value, uint32 shift)
+{
+    const uint32 half = 1u << (shift - 1);
+    const uint32 remainder = value & ((1u << shift) - 1);
+    uint32 result = value >> shift;
+    if (remainder > half || (remainder == half && (result & 1) != 0))
+    {
+        ++result;
+    }
+    return result;
+}
+
+float SignNotZero(float value)
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+float3 Normalized(float x, float y, float z)
+{
+    const float inv_length = 1.0f / sqrtf(x * x + y * y + z * z);
+    return float3(x * inv_length, y * inv_length, z * inv_length);
+}
+
+float Dot(float3 a, float3 b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// Smallest |w| a QTangent keeps, so the handedness sign survives snorm16. One step of snorm16.
+constexpr float kQTangentBias = 1.0f / 32767.0f;
+} // namespace
+
+// Half floats
+
+uint16 FloatToHalf(float value)
+{
+    const uint32 bits = FloatBits(value);
+    const uint32 sign = (bits >> 16) & 0x8000;
+    const uint32 abs = bits & 0x7fffffff;
+
+    if (abs >= 0x7f800000)
+    {
+        // Infinity stays infinity, NaN stays NaN (quiet, top of the payload kept)
+        const uint32 nan_bits = abs > 0x7f800000 ? 0x200 | ((abs >> 13) & 0x3ff) : 0;
+        return static_cast<uint16>(sign | 0x7c00 | nan_bits);
+    }
+    if (abs >= 0x477ff000)
+    {
+        // Rounds past 65504
+        return static_cast<uint16>(sign | 0x7c00);
+    }
+    if (abs < 0x38800000)
+    {
+        // Half denormal or zero. Under half of the smallest denormal rounds to zero.
+        if (abs < 0x33000000)
+        {
+            return static_cast<uint16>(sign);
+        }
+        const uint32 mantissa = (abs & 0x7fffff) | 0x800000;
+        const uint32 shift = 126 - (abs >> 23);
+        return static_cast<uint16>(sign | ShiftRightRounded(mantissa, shift));
+    }
+
+    // Rebias the exponent from 127 to 15. A mantissa carry correctly bumps the exponent.
+    return static_cast<uint16>(sign | ShiftRightRounded(abs - 0x38000000, 13));
+}
+
+float HalfToFloat(uint16 half)
+{
+    const uint32 sign = static_cast<uint32>(half & 0x8000) << 16;
+    const uint32 exponent = (half >> 10) & 0x1f;
+    const uint32 mantissa = half & 0x3ff;
+
+    if (exponent == 0x1f)
+    {
+        return BitsToFloat(sign | 0x7f800000 | (mantissa << 13));
+    }
+    if (exponent == 0)
+    {
+        // Zero or denormal, mantissa * 2^-24 is exact in a float
+        const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+        return sign != 0 ? -magnitude : magnitude;
+    }
+    return BitsToFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+void FloatsToHalves(ArrayView<const float> src, ArrayView<uint16> dst)
+{
+    rsblAssert(src.Size() == dst.Size());
+    Internal::GetWideKernels().floatsToHalves(src.Data(), src.Size(), dst.Data());
+}
+
+void HalvesToFloats(ArrayView<const uint16> src, ArrayView<float> dst)
+{
+    rsblAssert(src.Size() == dst.Size());
+    Internal::GetWideKernels().halvesToFloats(src.Data(), src.Size(), dst.Data());
+}
+
+void LerpDequantize16(ArrayView<const uint16> a, ArrayView<const uint16> b, float t,
+                      ArrayView<const float> offsets, ArrayView<const float> scales,
+                      ArrayView<float> dst)
+{
+    rsblAssert(a.Size() == dst.Size() && b.Size() == dst.Size());
+    rsblAssert(offsets.Size() == dst.Size() && scales.Size() == dst.Size());
+    Internal::GetWideKernels().lerpDequantize16(a.Data(), b.Data(), t, offsets.Data(),
+                                                scales.Data(), dst.Size(), dst.Data());
+}
+
+// Normalized integers. The vector paths clamp, scale and round exactly like the single value
+// functions, which handle the tail.
+
+namespace
+{
+#if RSBL_SIMD_SSE
+// 4 floats clamped to [low, high] and scaled, rounded by the default (nearest even) rounding mode
+__m128i ScaleToInts(const float* src, __m128 low, __m128 high, __m128 scale)
+{
+    __m128 v = _mm_loadu_ps(src);
+    v = _mm_and_ps(v, _mm_cmpord_ps(v, v)); // NaN to 0
+    v = _mm_min_ps(_mm_max_ps(v, low), high);
+    return _mm_cvtps_epi32(_mm_mul_ps(v, scale));
+}
+#elif RSBL_SIMD_NEON
+int32x4_t ScaleToInts(const float* src, float low, float high, float scale)
+{
+    float32x4_t v = vld1q_f32(src);
+    v = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), vceqq_f32(v, v)));
+    v = vminq_f32(vmaxq_f32(v, vdupq_n_f32(low)), vdupq_n_f32(high));
+    return vcvtnq_s32_f32(vmulq_f32(v, vdupq_n_f32(scale)));
+}
+#endif
+} // namespace
+
+void PackSnorm8(ArrayView<const float> src, ArrayView<int8> dst)
+{
+    rsblAssert(src.Size() == dst.Size());
+    const float* in = src.Data();
+    int8* out = dst.Data();
+
+    uint64 i = 0;
+#if RSBL_SIMD_SSE
+    const __m128 low = _mm_set1_ps(-1.0f);
+    const __m128 high = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(127.0f);
+    for (; i + 16 <= src.Size(); i += 16)
+    {
+        const __m128i a = _mm_packs_epi32(ScaleToInts(in + i, low, high, scale),
+                                          ScaleToInts(in + i + 4, low, high, scale));
+        const __m128i b = _mm_packs_epi32(ScaleToInts(in + i + 8, low, high, scale),
+                                          ScaleToInts(in + i + 12, low, high, scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi16(a, b));
+    }
+#elif RSBL_SIMD_NEON
+    for (; i + 8 <= src.Size(); i += 8)
+    {
+        const int16x8_t a = vcombine_s16(vqmovn_s32(ScaleToInts(in + i, -1.0f, 1.0f, 127.0f)),
+                                         vqmovn_s32(ScaleToInts(in + i + 4, -1.0f, 1.0f, 127.0f)));
+        vst1_s8(out + i, vqmovn_s16(a));
+    }
+#endif
+    for (; i < src.Size(); ++i)
+    {
+        out[i] = PackSnorm8(in[i]);
+    }
+}
+
+void PackUnorm8(ArrayView<const float> src, ArrayView<uint8> dst)
+{
+    rsblAssert(src.Size() == dst.Size());
+    const float* in = src.Data();
+    uint8* out = dst.Data();
+
+    uint64 i = 0;
+#if RSBL_SIMD_SSE
+    const __m128 low = _mm_setzero_ps();
+    const __m128 high = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    for (; i + 16 <= src.Size(); i += 16)
+    {
+        const __m128i a = _mm_packs_epi32(ScaleToInts(in + i, low, high, scale),
+                                          ScaleToInts(in + i + 4, low, high, scale));
+        const __m128i b = _mm_packs_epi32(ScaleToInts(in + i + 8, low, high, scale),
+                                          ScaleToInts(in + i + 12, low, high, scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(a, b));
+    }
+#elif RSBL_SIMD_NEON
+    for (; i + 8 <= src.Size(); i += 8)
+    {
+        const int16x8_t a = vcombine_s16(vqmovn_s32(ScaleToInts(in + i, 0.0f, 1.0f, 255.0f)),
+                                         vqmovn_s32(ScaleToInts(in + i + 4, 0.0f, 1.0f, 255.0f)));
+        vst1_u8(out + i, vqmovun_s16(a));
+    }
+#endif
+    for (; i < src.Size(); ++i)
+    {
+        out[i] = PackUnorm8(in[i]);
+    }
+}
+
+void PackSnorm16(ArrayView<const float> src, ArrayView<int16> dst)
+{
+    rsblAssert(src.Size() == dst.Size());
+    const float* in = src.Data();
+    int16* out = dst.Data();
+
+    uint64 i = 0;
+#if RSBL_SIMD_SSE
+    const __m128 low = _mm_set1_ps(-1.0f);
+    const __m128 high = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= src.Size(); i += 8)
+    {
+        const __m128i packed = _mm_packs_epi32(ScaleToInts(in + i, low, high, scale),
+                                               ScaleToInts(in + i + 4, low, high, scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+#elif RSBL_SIMD_NEON
+    for (; i + 8 <= src.Size(); i += 8)
+    {
+        vst1q_s16(out + i,
+                  vcombine_s16(vqmovn_s32(ScaleToInts(in + i, -1.0f, 1.0f, 32767.0f)),
+                               vqmovn_s32(ScaleToInts(in + i + 4, -1.0f, 1.0f, 32767.0f))));
+    }
+#endif
+    for (; i < src.Size(); ++i)
+    {
+        out[i] = PackSnorm16(in[i]);
+    }
+}
+
+void PackUnorm16(ArrayView<const float> src, ArrayView<uint16> dst)
+{
+    rsblAssert(src.Size() == dst.Size());
+    const float* in = src.Data();
+    uint16* out = dst.Data();
+
+    uint64 i = 0;
+#if RSBL_SIMD_SSE
+    const __m128 low = _mm_setzero_ps();
+    const __m128 high = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(65535.0f);
+    // SSE2 has no unsigned 32 to 16 bit pack, so shift into the signed range and flip back
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+    for (; i + 8 <= src.Size(); i += 8)
+    {
+        const __m128i a = _mm_sub_epi32(ScaleToInts(in + i, low, high, scale), bias);
+        const __m128i b = _mm_sub_epi32(ScaleToInts(in + i + 4, low, high, scale), bias);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm_xor_si128(_mm_packs_epi32(a, b), flip));
+    }
+#elif RSBL_SIMD_NEON
+    for (; i + 8 <= src.Size(); i += 8)
+    {
+        vst1q_u16(out + i,
+                  vcombine_u16(vqmovun_s32(ScaleToInts(in + i, 0.0f, 1.0f, 65535.0f)),
+                               vqmovun_s32(ScaleToInts(in + i + 4, 0.0f, 1.0f, 65535.0f))));
+    }
+#endif
+    for (; i < src.Size(); ++i)
+    {
+        out[i] = PackUnorm16(in[i]);
+    }
+}
+
+// Octahedral normals
+
+float2 OctahedralEncode(float3 normal)
+{
+    // Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower half over the diagonals
+    const float inv_l1 = 1.0f / (fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z));
+    const float x = normal.x * inv_l1;
+    const float y = normal.y * inv_l1;
+    if (normal.z >= 0.0f)
+    {
+        return float2(x, y);
+    }
+    return float2((1.0f - fabsf(y)) * SignNotZero(x), (1.0f - fabsf(x)) * SignNotZero(y));
+}
+
+float3 OctahedralDecode(float2 encoded)
+{
+    float x = encoded.x;
+    float y = encoded.y;
+    const float z = 1.0f - fabsf(x) - fabsf(y);
+
+    // Unfold the lower half
+    const float fold = z < 0.0f ? -z : 0.0f;
+    x += x >= 0.0f ? -fold : fold;
+    y += y >= 0.0f ? -fold : fold;
+    return Normalized(x, y, z);
+}
+
+uint32 PackOctahedral16(float3 normal)
+{
+    const float2 encoded = OctahedralEncode(normal);
+    return static_cast<uint16>(PackSnorm16(encoded.x)) |
+           (static_cast<uint32>(static_cast<uint16>(PackSnorm16(encoded.y))) << 16);
+}
+
+float3 UnpackOctahedral16(uint32 packed)
+{
+    const int16 x = static_cast<int16>(packed & 0xffff);
+    const int16 y = static_cast<int16>(packed >> 16);
+    return OctahedralDecode(float2(UnpackSnorm16(x), UnpackSnorm16(y)));
+}
+
+uint16 PackOctahedral8(float3 normal)
+{
+    // At 8 bits plain rounding is visibly off, so try all four neighbouring grid points and keep
+    // the one that decodes closest to the normal (Cigolle et al.)
+    const float2 encoded = OctahedralEncode(normal);
+    const float fx = floorf(encoded.x * 127.0f);
+    const float fy = floorf(encoded.y * 127.0f);
+
+    uint16 best = 0;
+    float best_dot = -2.0f;
+    for (uint32 corner = 0; corner < 4; ++corner)
+    {
+        const float cx = fx + static_cast<float>(corner & 1);
+        const float cy = fy + static_cast<float>(corner >> 1);
+        const uint16 candidate =
+            static_cast<uint8>(PackSnorm8(cx / 127.0f)) |
+            static_cast<uint16>(static_cast<uint8>(PackSnorm8(cy / 127.0f)) << 8);
+        const float dot = Dot(UnpackOctahedral8(candidate), normal);
+        if (dot > best_dot)
+        {
+            best_dot = dot;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+float3 UnpackOctahedral8(uint16 packed)
+{
+    const int8 x = static_cast<int8>(packed & 0xff);
+    const int8 y = static_cast<int8>(packed >> 8);
+    return OctahedralDecode(float2(UnpackSnorm8(x), UnpackSnorm8(y)));
+}
+
+void PackOctahedral16(ArrayView<const float3> normals, ArrayView<uint32> packed)
+{
+    rsblAssert(normals.Size() == packed.Size());
+    for (uint64 i = 0; i < normals.Size(); ++i)
+    {
+        packed[i] = PackOctahedral16(normals[i]);
+    }
+}
+
+// QTangents
+
+simd::quat QTangentFromFrame(float3 normal, float3 tangent, float handedness)
+{
+    const simd::float4 n = simd::Normalize3(simd::Load(normal));
+    // Gram-Schmidt, so the three axes make a proper rotation
+    const simd::float4 t_in = simd::Load(tangent);
+    const simd::float4 t = simd::Normalize3(t_in - n * simd::Dot3(n, t_in));
+    const simd::float4 b = simd::Cross3(n, t);
+
+    const simd::float4x4 frame(t, b, n, simd::float4(0.0f, 0.0f, 0.0f, 1.0f));
+    simd::float4 q = simd::QuatFromRotationMatrix(frame).xyzw;
+
+    // q and -q are the same rotation, so the sign of w is free to carry the handedness. That
+    // needs w to never be zero, even after quantization.
+    if (q.W() < 0.0f)
+    {
+        q = -q;
+    }
+    if (q.W() < kQTangentBias)
+    {
+        const float xyz_scale = sqrtf(1.0f - kQTangentBias * kQTangentBias) / simd::Length3(q);
+        q = simd::SetW(q * xyz_scale, kQTangentBias);
+    }
+    if (handedness < 0.0f)
+    {
+        q = -q;
+    }
+    return simd::quat(q);
+}
+
+void QTangentToFrame(simd::quat qtangent, float3& normal, float3& tangent, float& handedness)
+{
+    normal = simd::ToFloat3(simd::Rotate(qtangent, simd::float4(0.0f, 0.0f, 1.0f, 0.0f)));
+    tangent = simd::ToFloat3(simd::Rotate(qtangent, simd::float4(1.0f, 0.0f, 0.0f, 0.0f)));
+    handedness = qtangent.xyzw.W() < 0.0f ? -1.0f : 1.0f;
+}
+
+uint64 PackQTangent16(simd::quat qtangent)
+{
+    const simd::float4 q = qtangent.xyzw;
+    const float components[4] = {q.X(), q.Y(), q.Z(), q.W()};
+
+    uint64 packed = 0;
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        packed |= static_cast<uint64>(static_cast<uint16>(PackSnorm16(components[i]))) << (i * 16);
+    }
+    return packed;
+}
+
+simd::quat UnpackQTangent16(uint64 packed)
+{
+    float components[4];
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        components[i] = UnpackSnorm16(static_cast<int16>((packed >> (i * 16)) & 0xffff));
+    }
+    // Normalizing keeps the sign of w, and with it the handedness
+    return simd::Normalize(
+        simd::quat(components[0], components[1], components[2], components[3]));
+}
+
+} // namespace rsbl
@@ -0,0 +1,464 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-packing.h"
+#include "rsbl-wide-kernels.h"
+
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+float FromBits(uint32 bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+uint32 ToBits(float value)
+{
+    uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Deterministic stream of values in [0, 1)
+struct Random
+{
+    uint64 state = 7;
+
+    uint32 NextBits()
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<uint32>(state >> 32);
+    }
+
+    float Next()
+    {
+        return static_cast<float>(NextBits() >> 8) / static_cast<float>(1 << 24);
+    }
+
+    float3 NextDirection()
+    {
+        for (;;)
+        {
+            const float x = Next() * 2.0f - 1.0f;
+            const float y = Next() * 2.0f - 1.0f;
+            const float z = Next() * 2.0f - 1.0f;
+            const float length = sqrtf(x * x + y * y + z * z);
+            if (length > 0.1f && length < 1.0f)
+            {
+                return float3(x / length, y / length, z / length);
+            }
+        }
+    }
+};
+
+float Dot(float3 a, float3 b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+float3 Cross(float3 a, float3 b)
+{
+    return float3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+} // namespace
+
+TEST_SUITE("rsbl::Packing")
+{
+    TEST_CASE("Half floats")
+    {
+        CHECK(FloatToHalf(0.0f) == 0x0000);
+        CHECK(FloatToHalf(-0.0f) == 0x8000);
+        CHECK(FloatToHalf(1.0f) == 0x3c00);
+        CHECK(FloatToHalf(-2.0f) == 0xc000);
+        CHECK(FloatToHalf(65504.0f) == 0x7bff);
+        CHECK(FloatToHalf(0.333333f) == 0x3555);
+
+        // Ties go to even
+        CHECK(FloatToHalf(1.0f + 1.0f / 2048.0f) == 0x3c00);
+        CHECK(FloatToHalf(1.0f + 3.0f / 2048.0f) == 0x3c02);
+
+        // Overflow, infinity and NaN
+        CHECK(FloatToHalf(65519.0f) == 0x7bff);
+        CHECK(FloatToHalf(65520.0f) == 0x7c00);
+        CHECK(FloatToHalf(-1e10f) == 0xfc00);
+        CHECK(FloatToHalf(FromBits(0x7f800000)) == 0x7c00);
+        CHECK((FloatToHalf(FromBits(0x7fc00000)) & 0x7fff) > 0x7c00);
+        CHECK((FloatToHalf(FromBits(0x7f800001)) & 0x7fff) > 0x7c00);
+
+        // Denormals
+        CHECK(FloatToHalf(1.0f / 16777216.0f) == 0x0001);
+        CHECK(FloatToHalf(1.0f / 33554432.0f) == 0x0000);
+        CHECK(FloatToHalf(1.5f / 33554432.0f) == 0x0001);
+        CHECK(FloatToHalf(3.0f / 33554432.0f) == 0x0002);
+        CHECK(FloatToHalf(1.0f / 16384.0f) == 0x0400);
+        CHECK(FloatToHalf(1.0f / 16384.0f - 1.0f / 16777216.0f) == 0x03ff);
+        CHECK(FloatToHalf(1e-30f) == 0x0000);
+
+        CHECK(HalfToFloat(0x3c00) == 1.0f);
+        CHECK(HalfToFloat(0x7bff) == 65504.0f);
+        CHECK(HalfToFloat(0x0001) == 1.0f / 16777216.0f);
+        CHECK(ToBits(HalfToFloat(0x8000)) == 0x80000000);
+        CHECK(ToBits(HalfToFloat(0xfc00)) == 0xff800000);
+        CHECK(HalfToFloat(0x7e00) != HalfToFloat(0x7e00));
+    }
+
+    TEST_CASE("Every half survives a round trip")
+    {
+        for (uint32 half = 0; half <= 0xffff; ++half)
+        {
+            const bool is_nan = (half & 0x7c00) == 0x7c00 && (half & 0x3ff) != 0;
+            if (is_nan)
+            {
+                // Signaling NaNs come back quiet
+                REQUIRE(FloatToHalf(HalfToFloat(static_cast<uint16>(half))) == (half | 0x200));
+            }
+            else
+            {
+                REQUIRE(FloatToHalf(HalfToFloat(static_cast<uint16>(half))) == half);
+            }
+        }
+    }
+
+    TEST_CASE("Every SIMD level converts halves like the scalar code")
+    {
+        // Random bit patterns for every class of float, plus plenty of values in the half range
+        constexpr uint32 kCount = 4099;
+        Random random;
+        DynamicArray<float> floats;
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            floats.PushBack(i % 2 == 0 ? FromBits(random.NextBits())
+                                       : (random.Next() - 0.5f) * 140000.0f);
+        }
+
+        DynamicArray<uint16> expected_halves;
+        DynamicArray<float> expected_floats;
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            expected_halves.PushBack(FloatToHalf(floats[i]));
+            expected_floats.PushBack(HalfToFloat(expected_halves[i]));
+        }
+
+        DynamicArray<uint16> halves;
+        DynamicArray<float> back;
+        halves.Resize(kCount);
+        back.Resize(kCount);
+        FloatsToHalves(floats, halves);
+        HalvesToFloats(halves, back);
+        CHECK(memcmp(halves.Data(), expected_halves.Data(), kCount * sizeof(uint16)) == 0);
+        CHECK(memcmp(back.Data(), expected_floats.Data(), kCount * sizeof(float)) == 0);
+
+        for (uint32 level = 0; level < static_cast<uint32>(SimdLevel::Count); ++level)
+        {
+            const Internal::WideKernels* kernels =
+                Internal::GetWideKernels(static_cast<SimdLevel>(level));
+            if (kernels == nullptr)
+            {
+                continue;
+            }
+            CAPTURE(SimdLevelName(kernels->level));
+
+            // Every count up to a couple of blocks, to cover each tail length
+            for (uint64 count : {uint64(0), uint64(1), uint64(7), uint64(15), uint64(33),
+                                 uint64(kCount)})
+            {
+                CAPTURE(count);
+                for (uint32 i = 0; i < kCount; ++i)
+                {
+                    halves[i] = 0xabcd;
+                    back[i] = -1.0f;
+                }
+                kernels->floatsToHalves(floats.Data(), count, halves.Data());
+                kernels->halvesToFloats(halves.Data(), count, back.Data());
+                CHECK(memcmp(halves.Data(), expected_halves.Data(), count * 2) == 0);
+                CHECK(memcmp(back.Data(), expected_floats.Data(), count * 4) == 0);
+                if (count < kCount)
+                {
+                    CHECK(halves[count] == 0xabcd);
+                    CHECK(back[count] == -1.0f);
+                }
+            }
+        }
+    }
+
+    TEST_CASE("Normalized integers")
+    {
+        CHECK(PackSnorm8(1.0f) == 127);
+        CHECK(PackSnorm8(-1.0f) == -127);
+        CHECK(PackSnorm8(-5.0f) == -127);
+        CHECK(PackSnorm8(0.5f) == 64);
+        CHECK(PackSnorm8(0.5f / 127.0f) == 0);
+        CHECK(PackSnorm8(1.5f / 127.0f) == 2);
+        CHECK(PackUnorm8(1.0f) == 255);
+        CHECK(PackUnorm8(-1.0f) == 0);
+        CHECK(PackUnorm8(0.5f) == 128);
+        CHECK(PackSnorm16(-1.0f) == -32767);
+        CHECK(PackSnorm16(2.0f) == 32767);
+        CHECK(PackUnorm16(1.0f) == 65535);
+        CHECK(PackUnorm16(0.5f) == 32768);
+
+        const float nan = FromBits(0x7fc00000);
+        CHECK(PackSnorm8(nan) == 0);
+        CHECK(PackUnorm8(nan) == 0);
+        CHECK(PackSnorm16(nan) == 0);
+        CHECK(PackUnorm16(nan) == 0);
+
+        CHECK(UnpackSnorm8(-128) == -1.0f);
+        CHECK(UnpackSnorm8(-127) == -1.0f);
+        CHECK(UnpackSnorm8(127) == 1.0f);
+        CHECK(UnpackUnorm8(255) == 1.0f);
+        CHECK(UnpackSnorm16(-32768) == -1.0f);
+        CHECK(UnpackSnorm16(32767) == 1.0f);
+        CHECK(UnpackUnorm16(65535) == 1.0f);
+        CHECK(UnpackUnorm16(0) == 0.0f);
+
+        for (int32 i = -127; i <= 127; ++i)
+        {
+            REQUIRE(PackSnorm8(UnpackSnorm8(static_cast<int8>(i))) == i);
+        }
+        for (int32 i = 0; i <= 65535; ++i)
+        {
+            REQUIRE(PackUnorm16(UnpackUnorm16(static_cast<uint16>(i))) == i);
+        }
+    }
+
+    TEST_CASE("Array packing matches the single value functions")
+    {
+        constexpr uint32 kCount = 1003;
+        Random random;
+        DynamicArray<float> values;
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            values.PushBack(random.Next() * 3.0f - 1.5f);
+        }
+        // Exact ties, the limits and NaN
+        values[0] = 0.5f / 127.0f;
+        values[1] = 2.5f / 255.0f;
+        values[2] = -1.0f;
+        values[3] = 1.0f;
+        values[4] = FromBits(0x7fc00000);
+        values[5] = FromBits(0xff800000);
+        values[6] = 0.5f;
+
+        for (uint64 count : {uint64(0), uint64(5), uint64(16), uint64(31), uint64(kCount)})
+        {
+            CAPTURE(count);
+            const ArrayView<const float> src(values.Data(), count);
+
+            DynamicArray<int8> snorm8;
+            DynamicArray<uint8> unorm8;
+            DynamicArray<int16> snorm16;
+            DynamicArray<uint16> unorm16;
+            snorm8.Resize(count);
+            unorm8.Resize(count);
+            snorm16.Resize(count);
+            unorm16.Resize(count);
+            PackSnorm8(src, snorm8);
+            PackUnorm8(src, unorm8);
+            PackSnorm16(src, snorm16);
+            PackUnorm16(src, unorm16);
+
+            for (uint64 i = 0; i < count; ++i)
+            {
+                CAPTURE(values[i]);
+                REQUIRE(snorm8[i] == PackSnorm8(values[i]));
+                REQUIRE(unorm8[i] == PackUnorm8(values[i]));
+                REQUIRE(snorm16[i] == PackSnorm16(values[i]));
+                REQUIRE(unorm16[i] == PackUnorm16(values[i]));
+            }
+        }
+    }
+
+    TEST_CASE("Dequantizing lerp matches at every SIMD level")
+    {
+        constexpr uint32 kCount = 203;
+        Random random;
+        DynamicArray<uint16> a;
+        DynamicArray<uint16> b;
+        DynamicArray<float> offsets;
+        DynamicArray<float> scales;
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            a.PushBack(static_cast<uint16>(random.NextBits()));
+            b.PushBack(static_cast<uint16>(random.NextBits()));
+            offsets.PushBack(random.Next() * 10.0f - 5.0f);
+            scales.PushBack(random.Next() / 65535.0f);
+        }
+        // The extremes of the codes
+        a[0] = 0;
+        b[0] = 65535;
+
+        for (const float t : {0.0f, 0.25f, 1.0f})
+        {
+            CAPTURE(t);
+            DynamicArray<float> expected;
+            for (uint32 i = 0; i < kCount; ++i)
+            {
+                const float from = static_cast<float>(a[i]);
+                expected.PushBack(offsets[i] + scales[i] * (from + (float(b[i]) - from) * t));
+            }
+            DynamicArray<float> dst;
+            dst.Resize(kCount);
+            LerpDequantize16(a, b, t, offsets, scales, dst);
+            for (uint32 i = 0; i < kCount; ++i)
+            {
+                REQUIRE(dst[i] == doctest::Approx(expected[i]).epsilon(1e-5));
+            }
+            // The ends are the codes themselves
+            if (t == 0.0f)
+            {
+                CHECK(dst[0] == offsets[0]);
+            }
+
+            for (uint32 level = 0; level < static_cast<uint32>(SimdLevel::Count); ++level)
+            {
+                const Internal::WideKernels* kernels =
+                    Internal::GetWideKernels(static_cast<SimdLevel>(level));
+                if (kernels == nullptr)
+                {
+                    continue;
+                }
+                CAPTURE(SimdLevelName(kernels->level));
+                for (uint64 count : {uint64(0), uint64(3), uint64(17), uint64(kCount)})
+                {
+                    CAPTURE(count);
+                    for (uint32 i = 0; i < kCount; ++i)
+                    {
+                        dst[i] = -1.0f;
+                    }
+                    kernels->lerpDequantize16(a.Data(), b.Data(), t, offsets.Data(),
+                                              scales.Data(), count, dst.Data());
+                    for (uint64 i = 0; i < count; ++i)
+                    {
+                        REQUIRE(dst[i] == doctest::Approx(expected[i]).epsilon(1e-5));
+                    }
+                    if (count < kCount)
+                    {
+                        CHECK(dst[count] == -1.0f);
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_CASE("Octahedral normals")
+    {
+        // Axes and the folded corners map exactly
+        const float2 up = OctahedralEncode(float3(0.0f, 0.0f, 1.0f));
+        CHECK(up.x == 0.0f);
+        CHECK(up.y == 0.0f);
+        const float2 down = OctahedralEncode(float3(0.0f, 0.0f, -1.0f));
+        CHECK(fabsf(down.x) == 1.0f);
+        CHECK(fabsf(down.y) == 1.0f);
+        const float3 x_axis = OctahedralDecode(OctahedralEncode(float3(1.0f, 0.0f, 0.0f)));
+        CHECK(x_axis.x == doctest::Approx(1.0f));
+        CHECK(x_axis.z == doctest::Approx(0.0f));
+
+        Random random;
+        float worst16 = 1.0f;
+        float worst8 = 1.0f;
+        for (uint32 i = 0; i < 10000; ++i)
+        {
+            const float3 normal = random.NextDirection();
+
+            const float2 encoded = OctahedralEncode(normal);
+            REQUIRE(fabsf(encoded.x) <= 1.0f);
+            REQUIRE(fabsf(encoded.y) <= 1.0f);
+            const float3 decoded = OctahedralDecode(encoded);
+            REQUIRE(Dot(decoded, normal) == doctest::Approx(1.0f).epsilon(1e-5));
+            REQUIRE(Dot(decoded, decoded) == doctest::Approx(1.0f));
+
+            const float3 unpacked16 = UnpackOctahedral16(PackOctahedral16(normal));
+            const float3 unpacked8 = UnpackOctahedral8(PackOctahedral8(normal));
+            REQUIRE(Dot(unpacked16, unpacked16) == doctest::Approx(1.0f));
+            REQUIRE(Dot(unpacked8, unpacked8) == doctest::Approx(1.0f));
+            worst16 = fminf(worst16, Dot(unpacked16, normal));
+            worst8 = fminf(worst8, Dot(unpacked8, normal));
+        }
+
+        // Under 0.06 and 1 degree
+        CHECK(worst16 > cosf(0.001f));
+        CHECK(worst8 > cosf(0.018f));
+
+        DynamicArray<float3> normals;
+        for (uint32 i = 0; i < 37; ++i)
+        {
+            normals.PushBack(random.NextDirection());
+        }
+        DynamicArray<uint32> packed;
+        packed.Resize(normals.Size());
+        PackOctahedral16(normals, packed);
+        for (uint64 i = 0; i < normals.Size(); ++i)
+        {
+            CHECK(packed[i] == PackOctahedral16(normals[i]));
+        }
+    }
+
+    TEST_CASE("QTangents")
+    {
+        Random random;
+        for (uint32 i = 0; i < 2000; ++i)
+        {
+            const float3 normal = random.NextDirection();
+            // Not quite orthogonal, the way interpolated mesh tangents come in
+            float3 tangent = Cross(normal, random.NextDirection());
+            tangent = float3(tangent.x + normal.x * 0.05f, tangent.y + normal.y * 0.05f,
+                             tangent.z + normal.z * 0.05f);
+            const float handedness = i % 3 == 0 ? -1.0f : 1.0f;
+
+            const float3 n_dot_t = float3(normal.x * Dot(normal, tangent),
+                                          normal.y * Dot(normal, tangent),
+                                          normal.z * Dot(normal, tangent));
+            float3 expected_tangent =
+                float3(tangent.x - n_dot_t.x, tangent.y - n_dot_t.y, tangent.z - n_dot_t.z);
+            const float length = sqrtf(Dot(expected_tangent, expected_tangent));
+            expected_tangent = float3(expected_tangent.x / length, expected_tangent.y / length,
+                                      expected_tangent.z / length);
+
+            const simd::quat q = QTangentFromFrame(normal, tangent, handedness);
+            float3 out_normal;
+            float3 out_tangent;
+            float out_handedness;
+            QTangentToFrame(q, out_normal, out_tangent, out_handedness);
+            REQUIRE(Dot(out_normal, normal) == doctest::Approx(1.0f).epsilon(1e-5));
+            REQUIRE(Dot(out_tangent, expected_tangent) == doctest::Approx(1.0f).epsilon(1e-5));
+            REQUIRE(out_handedness == handedness);
+
+            const simd::quat unpacked = UnpackQTangent16(PackQTangent16(q));
+            QTangentToFrame(unpacked, out_normal, out_tangent, out_handedness);
+            REQUIRE(Dot(out_normal, normal) > 0.9999f);
+            REQUIRE(Dot(out_tangent, expected_tangent) > 0.9999f);
+            REQUIRE(out_handedness == handedness);
+        }
+    }
+
+    TEST_CASE("QTangent handedness survives a zero w")
+    {
+        // Rotation of 180 degrees about x: w is exactly 0 before the bias
+        const float3 normal(0.0f, 0.0f, -1.0f);
+        const float3 tangent(1.0f, 0.0f, 0.0f);
+        for (float handedness : {1.0f, -1.0f})
+        {
+            const simd::quat q = UnpackQTangent16(
+                PackQTangent16(QTangentFromFrame(normal, tangent, handedness)));
+            CHECK(q.xyzw.W() != 0.0f);
+
+            float3 out_normal;
+            float3 out_tangent;
+            float out_handedness;
+            QTangentToFrame(q, out_normal, out_tangent, out_handedness);
+            CHECK(out_handedness == handedness);
+            CHECK(out_normal.z == doctest::Approx(-1.0f));
+            CHECK(out_tangent.x == doctest::Approx(1.0f));
+        }
+    }
+}
@@ -0,0 +1,300 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-pool-allocator.h"
+
+#include "include/rsbl-assert.h"
+#include "include/rsbl-bits.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace
+{
+constexpr uint32 kMaxThreadCaches = 64;
+constexpr uint32 kNoThreadCache = ~uint32(0);
+constexpr uint32 kMagazineCapacity = 32;
+
+struct FreeNode
+{
+    FreeNode* next;
+};
+
+// Blocks are chained through a header at the front of the allocation
+struct PoolBlock
+{
+    PoolBlock* next;
+};
+
+// Owned by a single thread, so no locking. Aligned to avoid false sharing between threads.
+struct alignas(64) Magazine
+{
+    uint32 count = 0;
+    void* slots[kMagazineCapacity];
+};
+
+// Each live thread claims one cache index, shared by all pools. Indices are recycled when the
+// thread exits, and a new thread just inherits whatever free slots were left in that magazine.
+std::atomic<uint64> s_claimedCacheIndices{0};
+
+struct ThreadCacheIndex
+{
+    uint32 index = kNoThreadCache;
+
+    ThreadCacheIndex()
+    {
+        uint64 claimed = s_claimedCacheIndices.load(std::memory_order_relaxed);
+        while (claimed != ~uint64(0))
+        {
+            const uint32 free_index = rsbl::CountTrailingZeros64(~claimed);
+            if (s_claimedCacheIndices.compare_exchange_weak(claimed,
+                                                            claimed | (uint64(1) << free_index)))
+            {
+                index = free_index;
+                break;
+            }
+        }
+    }
+
+    ~ThreadCacheIndex()
+    {
+        if (index != kNoThreadCache)
+        {
+            s_claimedCacheIndices.fetch_and(~(uint64(1) << index));
+            // Another thread can claim the index now. Frees from thread_locals destroyed after
+            // this one go through the locked path rather than a magazine that isn't ours.
+            index = kNoThreadCache;
+        }
+    }
+};
+
+uint32 GetThreadCacheIndex()
+{
+    thread_local ThreadCacheIndex s_threadCacheIndex;
+    return s_threadCacheIndex.index;
+}
+
+uint64 BlockHeaderSize(uint64 slot_alignment)
+{
+    return rsbl::AlignUp(sizeof(PoolBlock), slot_alignment);
+}
+
+uint64 BlockAlignment(uint64 slot_alignment)
+{
+    return slot_alignment > rsbl::kDefaultAllocationAlignment ? slot_alignment
+                                                              : rsbl::kDefaultAllocationAlignment;
+}
+} // namespace
+
+namespace rsbl
+{
+
+struct FixedPoolAllocator::SharedState
+{
+    std::mutex mutex;
+    FreeNode* freeList = nullptr;
+    PoolBlock* blocks = nullptr;
+    uint64 blockCount = 0;
+    Magazine* magazines = nullptr;
+};
+
+FixedPoolAllocator::FixedPoolAllocator(uint64 slot_size,
+                                       uint64 slot_alignment,
+                                       uint64 slots_per_block,
+                                       bool enable_thread_cache,
+                                       Allocator* backing)
+    : m_backing(backing)
+    , m_slotSize(AlignUp(slot_size < sizeof(FreeNode) ? sizeof(FreeNode) : slot_size,
+                         slot_alignment < alignof(FreeNode) ? alignof(FreeNode) : slot_alignment))
+    , m_slotAlignment(slot_alignment < alignof(FreeNode) ? alignof(FreeNode) : slot_alignment)
+    , m_slotsPerBlock(slots_per_block > 0 ? slots_per_block : 1)
+{
+    rsblAssert(m_backing != nullptr);
+    rsblAssert(IsPowerOfTwo(slot_alignment));
+
+    void* shared_memory = m_backing->Allocate(sizeof(SharedState), alignof(SharedState));
+    m_shared = new (shared_memory) SharedState;
+
+    if (enable_thread_cache)
+    {
+        void* magazine_memory =
+            m_backing->Allocate(sizeof(Magazine) * kMaxThreadCaches, alignof(Magazine));
+        m_shared->magazines = static_cast<Magazine*>(magazine_memory);
+        for (uint32 i = 0; i < kMaxThreadCaches; ++i)
+        {
+            new (&m_shared->magazines[i]) Magazine;
+        }
+    }
+}
+
+FixedPoolAllocator::~FixedPoolAllocator()
+{
+    const uint64 block_size = BlockHeaderSize(m_slotAlignment) + m_slotSize * m_slotsPerBlock;
+    PoolBlock* block = m_shared->blocks;
+    while (block != nullptr)
+    {
+        PoolBlock* next = block->next;
+        m_backing->Free(block, block_size, BlockAlignment(m_slotAlignment));
+        block = next;
+    }
+
+    if (m_shared->magazines != nullptr)
+    {
+        m_backing->Free(m_shared->magazines, sizeof(Magazine) * kMaxThreadCaches,
+                        alignof(Magazine));
+    }
+
+    m_shared->~SharedState();
+    m_backing->Free(m_shared, sizeof(SharedState), alignof(SharedState));
+}
+
+void* FixedPoolAllocator::Allocate(uint64 size, uint64 alignment)
+{
+    rsblAssertMsg(size <= m_slotSize && alignment <= m_slotAlignment,
+                  "Allocation doesn't fit in a pool slot");
+    return AllocateSlot();
+}
+
+void FixedPoolAllocator::Free(void* ptr, uint64 size, uint64 alignment)
+{
+    rsblUnused(size);
+    rsblUnused(alignment);
+    FreeSlot(ptr);
+}
+
+void* FixedPoolAllocator::AllocateSlot()
+{
+    const uint32 cache_index =
+        m_shared->magazines != nullptr ? GetThreadCacheIndex() : kNoThreadCache;
+
+    if (cache_index == kNoThreadCache)
+    {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        return PopShared();
+    }
+
+    Magazine& magazine = m_shared->magazines[cache_index];
+    if (magazine.count == 0)
+    {
+        RefillMagazine(cache_index);
+        if (magazine.count == 0)
+        {
+            return nullptr;
+        }
+    }
+    return magazine.slots[--magazine.count];
+}
+
+void FixedPoolAllocator::FreeSlot(void* ptr)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    const uint32 cache_index =
+        m_shared->magazines != nullptr ? GetThreadCacheIndex() : kNoThreadCache;
+
+    if (cache_index == kNoThreadCache)
+    {
+        std::lock_guard<std::mutex> lock(m_shared->mutex);
+        FreeNode* node = static_cast<FreeNode*>(ptr);
+        node->next = m_shared->freeList;
+        m_shared->freeList = node;
+        return;
+    }
+
+    Magazine& magazine = m_shared->magazines[cache_index];
+    if (magazine.count == kMagazineCapacity)
+    {
+        FlushMagazine(cache_index);
+    }
+    magazine.slots[magazine.count++] = ptr;
+}
+
+uint64 FixedPoolAllocator::BlockCount() const
+{
+    std::lock_guard<std::mutex> lock(m_shared->mutex);
+    return m_shared->blockCount;
+}
+
+// Caller holds the lock
+void* FixedPoolAllocator::PopShared()
+{
+    if (m_shared->freeList == nullptr && !AddBlock())
+    {
+        return nullptr;
+    }
+
+    FreeNode* node = m_shared->freeList;
+    m_shared->freeList = node->next;
+    return node;
+}
+
+// Grab half a magazine at once, so the next few allocations on this thread are lock-free
+void FixedPoolAllocator::RefillMagazine(uint32 cache_index)
+{
+    Magazine& magazine = m_shared->magazines[cache_index];
+
+    std::lock_guard<std::mutex> lock(m_shared->mutex);
+    while (magazine.count < kMagazineCapacity / 2)
+    {
+        void* slot = PopShared();
+        if (slot == nullptr)
+        {
+            break;
+        }
+        magazine.slots[magazine.count++] = slot;
+    }
+}
+
+// Return the older half of the magazine to the shared list
+void FixedPoolAllocator::FlushMagazine(uint32 cache_index)
+{
+    Magazine& magazine = m_shared->magazines[cache_index];
+    const uint32 flush_count = kMagazineCapacity / 2;
+
+    std::lock_guard<std::mutex> lock(m_shared->mutex);
+    for (uint32 i = 0; i < flush_count; ++i)
+    {
+        FreeNode* node = static_cast<FreeNode*>(magazine.slots[i]);
+        node->next = m_shared->freeList;
+        m_shared->freeList = node;
+    }
+
+    for (uint32 i = flush_count; i < magazine.count; ++i)
+    {
+        magazine.slots[i - flush_count] = magazine.slots[i];
+    }
+    magazine.count -= flush_count;
+}
+
+// Caller holds the lock
+bool FixedPoolAllocator::AddBlock()
+{
+    const uint64 header_size = BlockHeaderSize(m_slotAlignment);
+    const uint64 block_size = header_size + m_slotSize * m_slotsPerBlock;
+
+    void* memory = m_backing->Allocate(block_size, BlockAlignment(m_slotAlignment));
+    if (memory == nullptr)
+    {
+        return false;
+    }
+
+    PoolBlock* block = static_cast<PoolBlock*>(memory);
+    block->next = m_shared->blocks;
+    m_shared->blocks = block;
+    ++m_shared->blockCount;
+
+    // Push in reverse so allocations walk the block front to back
+    uint8* slots = static_cast<uint8*>(memory) + header_size;
+    for (uint64 i = m_slotsPerBlock; i > 0; --i)
+    {
+        FreeNode* node = reinterpret_cast<FreeNode*>(slots + (i - 1) * m_slotSize);
+        node->next = m_shared->freeList;
+        m_shared->freeList = node;
+    }
+    return true;
+}
+
+} // namespace rsbl
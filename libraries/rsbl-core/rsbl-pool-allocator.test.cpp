@@ -0,0 +1,199 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-pool-allocator.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace rsbl;
+
+struct PooledObject
+{
+    uint64 a;
+    uint64 b;
+    static inline std::atomic<int> liveCount = 0;
+
+    PooledObject(uint64 value = 0)
+        : a(value)
+        , b(value * 2)
+    {
+        liveCount++;
+    }
+
+    ~PooledObject()
+    {
+        liveCount--;
+    }
+};
+
+struct alignas(64) OverAligned
+{
+    uint8 data[8];
+};
+
+TEST_SUITE("rsbl::PoolAllocator")
+{
+    TEST_CASE("New and Delete run constructors and destructors")
+    {
+        PoolAllocator<PooledObject> pool;
+        PooledObject* object = pool.New(uint64(21));
+        REQUIRE(object != nullptr);
+        CHECK(object->a == 21);
+        CHECK(object->b == 42);
+        CHECK(PooledObject::liveCount == 1);
+
+        pool.Delete(object);
+        CHECK(PooledObject::liveCount == 0);
+    }
+
+    TEST_CASE("Freed slots are recycled")
+    {
+        PoolAllocator<PooledObject> pool(16);
+        PooledObject* first = pool.New();
+        pool.Delete(first);
+
+        PooledObject* second = pool.New();
+        CHECK(second == first);
+        pool.Delete(second);
+    }
+
+    TEST_CASE("Blocks are added as the pool fills up")
+    {
+        PoolAllocator<PooledObject> pool(8);
+        DynamicArray<PooledObject*> objects;
+        for (uint64 i = 0; i < 20; ++i)
+        {
+            objects.PushBack(pool.New(i));
+        }
+        CHECK(pool.GetAllocator().BlockCount() == 3);
+
+        for (uint64 i = 0; i < 20; ++i)
+        {
+            CHECK(objects[i]->a == i);
+            pool.Delete(objects[i]);
+        }
+        CHECK(PooledObject::liveCount == 0);
+    }
+
+    TEST_CASE("Slots respect alignment")
+    {
+        PoolAllocator<OverAligned> pool(4);
+        OverAligned* objects[10];
+        for (OverAligned*& object : objects)
+        {
+            object = pool.New();
+            CHECK((reinterpret_cast<uint64>(object) & 63) == 0);
+        }
+        for (OverAligned* object : objects)
+        {
+            pool.Delete(object);
+        }
+    }
+
+    TEST_CASE("UniquePtr returns the object to the pool")
+    {
+        PoolAllocator<PooledObject> pool;
+        PooledObject* raw = nullptr;
+        {
+            PoolPtr<PooledObject> ptr = pool.MakeUnique(uint64(5));
+            raw = ptr.Get();
+            CHECK(ptr->a == 5);
+            CHECK(PooledObject::liveCount == 1);
+        }
+        CHECK(PooledObject::liveCount == 0);
+
+        PoolPtr<PooledObject> again = pool.MakeUnique();
+        CHECK(again.Get() == raw);
+    }
+
+    TEST_CASE("Thread cache handles many threads allocating at once")
+    {
+        PoolAllocator<PooledObject> pool(64, true);
+        constexpr int kThreadCount = 8;
+        constexpr int kObjectsPerThread = 2000;
+
+        std::thread threads[kThreadCount];
+        bool results[kThreadCount] = {};
+        for (int t = 0; t < kThreadCount; ++t)
+        {
+            threads[t] = std::thread([&pool, &results, t]() {
+                PooledObject* objects[kObjectsPerThread];
+                for (int round = 0; round < 4; ++round)
+                {
+                    for (int i = 0; i < kObjectsPerThread; ++i)
+                    {
+                        objects[i] = pool.New(uint64(t * kObjectsPerThread + i));
+                    }
+
+                    bool ok = true;
+                    for (int i = 0; i < kObjectsPerThread; ++i)
+                    {
+                        ok = ok && objects[i]->a == uint64(t * kObjectsPerThread + i);
+                        pool.Delete(objects[i]);
+                    }
+                    results[t] = ok;
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (bool result : results)
+        {
+            CHECK(result);
+        }
+        CHECK(PooledObject::liveCount == 0);
+    }
+
+    TEST_CASE("Objects can be freed on a different thread")
+    {
+        PoolAllocator<PooledObject> pool(32, true);
+        DynamicArray<PooledObject*> objects;
+        for (uint64 i = 0; i < 100; ++i)
+        {
+            objects.PushBack(pool.New(i));
+        }
+
+        std::thread freeing_thread([&]() {
+            for (PooledObject* object : objects)
+            {
+                pool.Delete(object);
+            }
+        });
+        freeing_thread.join();
+        CHECK(PooledObject::liveCount == 0);
+
+        // Slots flushed back by the other thread are reused here
+        const uint64 blocks = pool.GetAllocator().BlockCount();
+        for (uint64 i = 0; i < 50; ++i)
+        {
+            objects[i] = pool.New(i);
+        }
+        for (uint64 i = 0; i < 50; ++i)
+        {
+            pool.Delete(objects[i]);
+        }
+        CHECK(pool.GetAllocator().BlockCount() <= blocks + 1);
+    }
+
+    TEST_CASE("FixedPoolAllocator works as a generic Allocator")
+    {
+        FixedPoolAllocator pool(32, 8, 16);
+        Allocator* allocator = &pool;
+
+        void* a = allocator->Allocate(32, 8);
+        void* b = allocator->Allocate(16, 8);
+        CHECK(a != b);
+        allocator->Free(a, 32, 8);
+        allocator->Free(b, 16, 8);
+        CHECK(pool.SlotSize() == 32);
+    }
+}
@@ -6,6 +6,8 @@
 
 #include "include/rsbl-ptr.h"
 
+#include <thread>
+
 using namespace rsbl;
 
 // Test helper struct with tracking capabilities
@@ -248,3 +250,192 @@ TEST_SUITE("rsbl::UniquePtr")
         CHECK(ptr2.Get() == nullptr);
     }
 }
+
+// Stateless deleter that counts instead of deleting from the heap
+struct CountingDeleter
+{
+    static inline int deleteCalls = 0;
+
+    void operator()(int* ptr) const
+    {
+        deleteCalls++;
+        delete ptr;
+    }
+};
+
+// Stateful deleter, which does take up space
+struct RecordingDeleter
+{
+    int* lastDeleted = nullptr;
+
+    void operator()(int* ptr)
+    {
+        lastDeleted = ptr;
+        delete ptr;
+    }
+};
+
+TEST_SUITE("rsbl::UniquePtr deleters")
+{
+    TEST_CASE("Stateless deleters add no size")
+    {
+        static_assert(sizeof(UniquePtr<int>) == sizeof(int*));
+        static_assert(sizeof(UniquePtr<int, CountingDeleter>) == sizeof(int*));
+        static_assert(IsTriviallyRelocatable<UniquePtr<int, CountingDeleter>>);
+    }
+
+    TEST_CASE("Custom deleter is called on destruction and Reset")
+    {
+        CountingDeleter::deleteCalls = 0;
+        {
+            UniquePtr<int, CountingDeleter> ptr(new int(1));
+            ptr.Reset(new int(2));
+            CHECK(CountingDeleter::deleteCalls == 1);
+        }
+        CHECK(CountingDeleter::deleteCalls == 2);
+    }
+
+    TEST_CASE("Stateful deleter moves with the pointer")
+    {
+        int* raw = new int(3);
+        UniquePtr<int, RecordingDeleter> ptr(raw, RecordingDeleter{});
+        UniquePtr<int, RecordingDeleter> moved(rsblMove(ptr));
+        moved.Reset();
+        CHECK(moved.GetDeleter().lastDeleted == raw);
+    }
+}
+
+// Intrusive refcounted test object
+struct RefCountedStruct : public RefCounted<RefCountedStruct>
+{
+    int value;
+    static inline int destructorCalls = 0;
+
+    RefCountedStruct(int v = 0)
+        : value(v)
+    {
+    }
+
+    ~RefCountedStruct()
+    {
+        destructorCalls++;
+    }
+};
+
+struct DerivedRefCounted : public RefCountedStruct
+{
+    DerivedRefCounted()
+        : RefCountedStruct(7)
+    {
+    }
+};
+
+// Mimics a COM interface, which is born with one reference
+struct FakeComObject
+{
+    int refCount = 1;
+    static inline int releasedObjects = 0;
+
+    void AddRef()
+    {
+        refCount++;
+    }
+
+    void Release()
+    {
+        if (--refCount == 0)
+        {
+            releasedObjects++;
+            delete this;
+        }
+    }
+};
+
+TEST_SUITE("rsbl::RefPtr")
+{
+    TEST_CASE("RefPtr is a single pointer")
+    {
+        static_assert(sizeof(RefPtr<RefCountedStruct>) == sizeof(RefCountedStruct*));
+    }
+
+    TEST_CASE("Copies share ownership")
+    {
+        RefCountedStruct::destructorCalls = 0;
+        {
+            RefPtr<RefCountedStruct> a = MakeRef<RefCountedStruct>(5);
+            CHECK(a->RefCount() == 1);
+            {
+                RefPtr<RefCountedStruct> b = a;
+                CHECK(a->RefCount() == 2);
+                CHECK(b->value == 5);
+                CHECK(a == b);
+            }
+            CHECK(a->RefCount() == 1);
+            CHECK(RefCountedStruct::destructorCalls == 0);
+        }
+        CHECK(RefCountedStruct::destructorCalls == 1);
+    }
+
+    TEST_CASE("Move and self-assignment")
+    {
+        RefCountedStruct::destructorCalls = 0;
+        RefPtr<RefCountedStruct> a = MakeRef<RefCountedStruct>(1);
+        RefPtr<RefCountedStruct>& alias = a;
+        a = alias;
+        CHECK(a->RefCount() == 1);
+
+        RefPtr<RefCountedStruct> b(rsblMove(a));
+        CHECK_FALSE(a);
+        CHECK(b->RefCount() == 1);
+
+        b = nullptr;
+        CHECK(RefCountedStruct::destructorCalls == 1);
+    }
+
+    TEST_CASE("Derived to base conversion")
+    {
+        RefPtr<DerivedRefCounted> derived = MakeRef<DerivedRefCounted>();
+        RefPtr<RefCountedStruct> base = derived;
+        CHECK(base->value == 7);
+        CHECK(base->RefCount() == 2);
+    }
+
+    TEST_CASE("COM style objects are adopted without an extra reference")
+    {
+        FakeComObject::releasedObjects = 0;
+        {
+            RefPtr<FakeComObject> ptr = RefPtr<FakeComObject>::Adopt(new FakeComObject);
+            CHECK(ptr->refCount == 1);
+
+            RefPtr<FakeComObject> out;
+            *out.ReleaseAndGetAddressOf() = new FakeComObject;
+            CHECK(out->refCount == 1);
+        }
+        CHECK(FakeComObject::releasedObjects == 2);
+    }
+
+    TEST_CASE("Refcount is thread-safe")
+    {
+        RefCountedStruct::destructorCalls = 0;
+        RefPtr<RefCountedStruct> shared = MakeRef<RefCountedStruct>();
+
+        std::thread threads[4];
+        for (std::thread& thread : threads)
+        {
+            thread = std::thread([shared]() {
+                for (int i = 0; i < 10000; ++i)
+                {
+                    RefPtr<RefCountedStruct> copy = shared;
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        CHECK(shared->RefCount() == 1);
+        shared.Reset();
+        CHECK(RefCountedStruct::destructorCalls == 1);
+    }
+}
@@ -0,0 +1,272 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-range-allocator.h"
+
+#include "include/rsbl-assert.h"
+#include "include/rsbl-bits.h"
+
+namespace rsbl
+{
+
+namespace
+{
+uint32 Log2(uint64 value)
+{
+    return 63 - CountLeadingZeros64(value);
+}
+} // namespace
+
+// Ranges of size are filed in bin log2(size), sub-bin the next kSubBinBits bits. The small bins
+// are too narrow to split and only use sub-bin 0.
+void RangeAllocator::BinOf(uint64 size, uint32& bin, uint32& subBin)
+{
+    bin = Log2(size);
+    subBin = bin < kSubBinBits ? 0 : uint32(size >> (bin - kSubBinBits)) & (kSubBins - 1);
+}
+
+uint64 RangeAllocator::SmallestInBin(uint32 bin, uint32 subBin)
+{
+    return bin < kSubBinBits ? uint64(1) << bin
+                             : (uint64(1) << bin) + (uint64(subBin) << (bin - kSubBinBits));
+}
+
+RangeAllocator::RangeAllocator(uint64 size, Allocator* allocator)
+    : m_nodes(allocator)
+{
+    Reset(size);
+}
+
+void RangeAllocator::Reset(uint64 size)
+{
+    m_nodes.Clear();
+    m_unusedNodes = kInvalidRange;
+    m_binBits = 0;
+    for (uint32 bin = 0; bin < kBins; ++bin)
+    {
+        m_subBinBits[bin] = 0;
+        for (uint32 subBin = 0; subBin < kSubBins; ++subBin)
+        {
+            m_bins[bin][subBin] = kInvalidRange;
+        }
+    }
+
+    m_size = size;
+    m_freeBytes = size;
+    m_allocationCount = 0;
+    if (size > 0)
+    {
+        InsertFree(NewNode(0, size));
+    }
+}
+
+RangeAllocator::Range RangeAllocator::Allocate(uint64 size, uint64 alignment)
+{
+    rsblAssert(IsPowerOfTwo(alignment));
+    size = size == 0 ? 1 : size;
+
+    // Any free range this big fits size wherever alignment puts it
+    const uint64 needed = size + (alignment - 1);
+    if (needed < size || needed > m_size)
+    {
+        return {};
+    }
+
+    // Every range in the bin needed falls in, or any bin above, has to be big enough. The bin
+    // itself only is when needed is the smallest size it takes.
+    uint32 bin = 0;
+    uint32 subBin = 0;
+    BinOf(needed, bin, subBin);
+    if (needed > SmallestInBin(bin, subBin))
+    {
+        if (bin < kSubBinBits || ++subBin == kSubBins)
+        {
+            ++bin;
+            subBin = 0;
+        }
+        if (bin == kBins)
+        {
+            return {};
+        }
+    }
+
+    uint32 subBinBits = m_subBinBits[bin] & (~0u << subBin);
+    if (subBinBits == 0)
+    {
+        const uint64 binBits = bin + 1 < kBins ? m_binBits & (~0ull << (bin + 1)) : 0;
+        if (binBits == 0)
+        {
+            return {};
+        }
+        bin = CountTrailingZeros64(binBits);
+        subBinBits = m_subBinBits[bin];
+    }
+    subBin = CountTrailingZeros32(subBinBits);
+
+    const uint32 id = m_bins[bin][subBin];
+    RemoveFree(id);
+
+    // Nodes are indices rather than references, making new ones can move the array
+    const uint64 offset = AlignUp(m_nodes[id].offset, alignment);
+    const uint64 padding = offset - m_nodes[id].offset;
+    if (padding > 0)
+    {
+        // The front goes back as a range of its own. What's before it is in use, or the two
+        // would have been merged.
+        const uint32 front = NewNode(m_nodes[id].offset, padding);
+        const uint32 previous = m_nodes[id].previous;
+        m_nodes[front].previous = previous;
+        m_nodes[front].next = id;
+        if (previous != kInvalidRange)
+        {
+            m_nodes[previous].next = front;
+        }
+        m_nodes[id].previous = front;
+        m_nodes[id].offset = offset;
+        m_nodes[id].size -= padding;
+        InsertFree(front);
+    }
+
+    if (m_nodes[id].size > size)
+    {
+        const uint32 back = NewNode(offset + size, m_nodes[id].size - size);
+        const uint32 next = m_nodes[id].next;
+        m_nodes[back].previous = id;
+        m_nodes[back].next = next;
+        if (next != kInvalidRange)
+        {
+            m_nodes[next].previous = back;
+        }
+        m_nodes[id].next = back;
+        m_nodes[id].size = size;
+        InsertFree(back);
+    }
+
+    m_freeBytes -= size;
+    ++m_allocationCount;
+    return {offset, id};
+}
+
+void RangeAllocator::Free(uint32 id)
+{
+    rsblAssert(id < m_nodes.Size() && !m_nodes[id].free && m_nodes[id].size > 0);
+    m_freeBytes += m_nodes[id].size;
+    --m_allocationCount;
+
+    const uint32 previous = m_nodes[id].previous;
+    if (previous != kInvalidRange && m_nodes[previous].free)
+    {
+        RemoveFree(previous);
+        m_nodes[id].offset = m_nodes[previous].offset;
+        m_nodes[id].size += m_nodes[previous].size;
+        m_nodes[id].previous = m_nodes[previous].previous;
+        if (m_nodes[id].previous != kInvalidRange)
+        {
+            m_nodes[m_nodes[id].previous].next = id;
+        }
+        m_nodes[previous].size = 0;
+        m_nodes[previous].nextFree = m_unusedNodes;
+        m_unusedNodes = previous;
+    }
+
+    const uint32 next = m_nodes[id].next;
+    if (next != kInvalidRange && m_nodes[next].free)
+    {
+        RemoveFree(next);
+        m_nodes[id].size += m_nodes[next].size;
+        m_nodes[id].next = m_nodes[next].next;
+        if (m_nodes[id].next != kInvalidRange)
+        {
+            m_nodes[m_nodes[id].next].previous = id;
+        }
+        m_nodes[next].size = 0;
+        m_nodes[next].nextFree = m_unusedNodes;
+        m_unusedNodes = next;
+    }
+
+    InsertFree(id);
+}
+
+uint64 RangeAllocator::LargestFreeRange() const
+{
+    if (m_binBits == 0)
+    {
+        return 0;
+    }
+
+    // The largest is somewhere in the top bin
+    const uint32 bin = Log2(m_binBits);
+    uint64 largest = 0;
+    for (uint32 id = m_bins[bin][Log2(m_subBinBits[bin])]; id != kInvalidRange;
+         id = m_nodes[id].nextFree)
+    {
+        largest = m_nodes[id].size > largest ? m_nodes[id].size : largest;
+    }
+    return largest;
+}
+
+uint32 RangeAllocator::NewNode(uint64 offset, uint64 size)
+{
+    const Node node = {offset, size, kInvalidRange, kInvalidRange, kInvalidRange,
+                       kInvalidRange, false};
+    if (m_unusedNodes != kInvalidRange)
+    {
+        const uint32 id = m_unusedNodes;
+        m_unusedNodes = m_nodes[id].nextFree;
+        m_nodes[id] = node;
+        return id;
+    }
+    m_nodes.PushBack(node);
+    return static_cast<uint32>(m_nodes.Size() - 1);
+}
+
+void RangeAllocator::InsertFree(uint32 id)
+{
+    uint32 bin = 0;
+    uint32 subBin = 0;
+    BinOf(m_nodes[id].size, bin, subBin);
+
+    const uint32 head = m_bins[bin][subBin];
+    m_nodes[id].free = true;
+    m_nodes[id].previousFree = kInvalidRange;
+    m_nodes[id].nextFree = head;
+    if (head != kInvalidRange)
+    {
+        m_nodes[head].previousFree = id;
+    }
+    m_bins[bin][subBin] = id;
+    m_subBinBits[bin] |= 1u << subBin;
+    m_binBits |= uint64(1) << bin;
+}
+
+void RangeAllocator::RemoveFree(uint32 id)
+{
+    Node& node = m_nodes[id];
+    node.free = false;
+    if (node.previousFree != kInvalidRange)
+    {
+        m_nodes[node.previousFree].nextFree = node.nextFree;
+    }
+    if (node.nextFree != kInvalidRange)
+    {
+        m_nodes[node.nextFree].previousFree = node.previousFree;
+    }
+
+    uint32 bin = 0;
+    uint32 subBin = 0;
+    BinOf(node.size, bin, subBin);
+    if (m_bins[bin][subBin] == id)
+    {
+        m_bins[bin][subBin] = node.nextFree;
+        if (node.nextFree == kInvalidRange)
+        {
+            m_subBinBits[bin] &= ~(1u << subBin);
+            if (m_subBinBits[bin] == 0)
+            {
+                m_binBits &= ~(uint64(1) << bin);
+            }
+        }
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,132 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-range-allocator.h"
+#include "include/rsbl-sort.h"
+
+using namespace rsbl;
+
+namespace
+{
+uint32 NextRandom(uint32& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+} // namespace
+
+TEST_SUITE("rsbl::RangeAllocator")
+{
+    TEST_CASE("Ranges are aligned, don't overlap, and merge back into one when freed")
+    {
+        constexpr uint64 kSize = 1 << 20;
+        RangeAllocator allocator(kSize);
+        DynamicArray<RangeAllocator::Range> ranges;
+        DynamicArray<uint64> sizes;
+        uint32 random = 0x9e3779b9u;
+
+        // Churn: mostly allocations, some frees, until it's well fragmented
+        for (uint32 step = 0; step < 4000; ++step)
+        {
+            if (!ranges.IsEmpty() && NextRandom(random) % 3 == 0)
+            {
+                const uint64 victim = NextRandom(random) % ranges.Size();
+                allocator.Free(ranges[victim].id);
+                ranges[victim] = ranges[ranges.Size() - 1];
+                sizes[victim] = sizes[sizes.Size() - 1];
+                ranges.PopBack();
+                sizes.PopBack();
+                continue;
+            }
+
+            const uint64 size = 1 + NextRandom(random) % 2048;
+            const uint64 alignment = uint64(1) << (NextRandom(random) % 9);
+            const RangeAllocator::Range range = allocator.Allocate(size, alignment);
+            if (range.id == RangeAllocator::kInvalidRange)
+            {
+                continue;
+            }
+            CHECK(range.offset % alignment == 0);
+            CHECK(range.offset + size <= kSize);
+            CHECK(allocator.RangeSize(range.id) == size);
+            ranges.PushBack(range);
+            sizes.PushBack(size);
+        }
+        REQUIRE(ranges.Size() > 100);
+        CHECK(allocator.AllocationCount() == ranges.Size());
+
+        // Sorted by offset, each range ends before the next starts
+        DynamicArray<uint64> keys;
+        DynamicArray<uint32> order;
+        uint64 used = 0;
+        for (uint64 i = 0; i < ranges.Size(); ++i)
+        {
+            keys.PushBack(ranges[i].offset);
+            order.PushBack(static_cast<uint32>(i));
+            used += sizes[i];
+        }
+        RadixSort(ArrayView<uint64>(keys), order);
+        bool overlapping = false;
+        for (uint64 i = 1; i < order.Size(); ++i)
+        {
+            const uint64 previous = order[i - 1];
+            overlapping |= ranges[previous].offset + sizes[previous] > ranges[order[i]].offset;
+        }
+        CHECK_FALSE(overlapping);
+        CHECK(allocator.FreeBytes() == kSize - used);
+
+        for (const RangeAllocator::Range& range : ranges)
+        {
+            allocator.Free(range.id);
+        }
+        CHECK(allocator.AllocationCount() == 0);
+        CHECK(allocator.FreeBytes() == kSize);
+        CHECK(allocator.LargestFreeRange() == kSize);
+    }
+
+    TEST_CASE("A full range fails cleanly and takes allocations again once freed")
+    {
+        RangeAllocator allocator(4096);
+        const RangeAllocator::Range all = allocator.Allocate(4096);
+        REQUIRE(all.id != RangeAllocator::kInvalidRange);
+        CHECK(all.offset == 0);
+        CHECK(allocator.LargestFreeRange() == 0);
+        CHECK(allocator.Allocate(1).id == RangeAllocator::kInvalidRange);
+
+        allocator.Free(all.id);
+        CHECK(allocator.Allocate(4097).id == RangeAllocator::kInvalidRange);
+        // Fits, but not at that alignment
+        CHECK(allocator.Allocate(4096, 8192).id == RangeAllocator::kInvalidRange);
+        CHECK(allocator.Allocate(4000, 64).id != RangeAllocator::kInvalidRange);
+
+        allocator.Reset(100);
+        CHECK(allocator.Size() == 100);
+        CHECK(allocator.FreeBytes() == 100);
+        CHECK(allocator.AllocationCount() == 0);
+    }
+
+    TEST_CASE("Alignment padding stays free")
+    {
+        RangeAllocator allocator(1 << 16);
+        const RangeAllocator::Range first = allocator.Allocate(1);
+        const RangeAllocator::Range aligned = allocator.Allocate(16, 256);
+        CHECK(first.offset == 0);
+        CHECK(aligned.offset == 256);
+        CHECK(allocator.FreeBytes() == (1 << 16) - 17);
+
+        // Good fit takes the smallest bin that fits, which is the padding
+        const RangeAllocator::Range small = allocator.Allocate(100);
+        CHECK(small.offset == 1);
+
+        // Freeing the middle merges it with the padding left over on both sides
+        allocator.Free(small.id);
+        allocator.Free(first.id);
+        const RangeAllocator::Range gap = allocator.Allocate(256);
+        CHECK(gap.offset == 0);
+    }
+}
@@ -0,0 +1,187 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Size and call overhead of Result against std::expected and a plain error code with an out
+// parameter, on the success path and the failure path, where Result also pays for its text:
+// static text, deferred formatting or a copy. The Produce* functions are kept out of line so
+// their codegen can be compared in a disassembler, and so the timing loop actually pays for the
+// return. Whether they fail is hidden from the optimizer, so neither path is folded away.
+
+#include "include/rsbl-result.h"
+
+#include <rsbl-bench.h>
+
+#include <cstdio>
+#include <expected>
+
+#if defined(_MSC_VER)
+    #define RSBL_BENCH_NOINLINE __declspec(noinline)
+#else
+    #define RSBL_BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+using namespace rsbl;
+
+namespace
+{
+struct Handle
+{
+    void* ptr;
+};
+
+// How a failure's text is given
+enum class FailureText : uint8
+{
+    Static,
+    Format,
+    Copy,
+};
+
+RSBL_BENCH_NOINLINE Result<uint64> ProduceResult(uint64 i, bool fail, FailureText text)
+{
+    if (fail)
+    {
+        switch (text)
+        {
+        case FailureText::Format:
+            return FailureFormat(ErrorCategory::Io, "Simulated failure %llu", i);
+        case FailureText::Copy:
+            return FailureCopy(ErrorCategory::Io, "Simulated failure");
+        default:
+            return {ErrorCategory::Io, "Simulated failure"};
+        }
+    }
+    return i;
+}
+
+RSBL_BENCH_NOINLINE std::expected<uint64, ErrorCategory> ProduceExpected(uint64 i, bool fail)
+{
+    if (fail)
+    {
+        return std::unexpected(ErrorCategory::Io);
+    }
+    return i;
+}
+
+RSBL_BENCH_NOINLINE ErrorCategory ProduceErrorCode(uint64 i, bool fail, uint64& value)
+{
+    if (fail)
+    {
+        return ErrorCategory::Io;
+    }
+    value = i;
+    return ErrorCategory::None;
+}
+
+RSBL_BENCH_NOINLINE Result<Handle> ProduceHandleResult(uint64 i, bool fail)
+{
+    if (fail)
+    {
+        return {ErrorCategory::Io, "Simulated failure"};
+    }
+    return Handle{reinterpret_cast<void*>(i)};
+}
+
+RSBL_BENCH_NOINLINE std::expected<Handle, ErrorCategory> ProduceHandleExpected(uint64 i,
+                                                                               bool fail)
+{
+    if (fail)
+    {
+        return std::unexpected(ErrorCategory::Io);
+    }
+    return Handle{reinterpret_cast<void*>(i)};
+}
+
+// Calls on one path, counting i up and summing what comes back
+void PathSuite(Bench& bench, const char* section, bool failing)
+{
+    bench.Section(section);
+    uint64 i = 0;
+    bool fail = failing;
+
+    const auto run = [&](const char* name, auto&& call) {
+        bench.Run(name, [&]() {
+            DoNotOptimize(fail);
+            DoNotOptimize(call(++i, fail));
+        });
+    };
+
+    // Failing with static text is one per-thread store, SetFailureText
+    run(failing ? "Result<uint64>, static text" : "Result<uint64>", [](uint64 value, bool f) {
+        Result<uint64> result = ProduceResult(value, f, FailureText::Static);
+        return result ? result.Value() : uint64(1);
+    });
+    if (failing)
+    {
+        run("Result<uint64>, FailureFormat", [](uint64 value, bool f) {
+            Result<uint64> result = ProduceResult(value, f, FailureText::Format);
+            return result ? result.Value() : uint64(1);
+        });
+        run("Result<uint64>, FailureCopy", [](uint64 value, bool f) {
+            Result<uint64> result = ProduceResult(value, f, FailureText::Copy);
+            return result ? result.Value() : uint64(1);
+        });
+        // What reporting it costs: deferred formats are formatted here, on the first ask
+        run("Result<uint64>, FailureFormat read", [](uint64 value, bool f) {
+            Result<uint64> result = ProduceResult(value, f, FailureText::Format);
+            return result ? result.Value() : static_cast<uint64>(result.FailureText()[0]);
+        });
+    }
+    run("std::expected<uint64>", [](uint64 value, bool f) {
+        std::expected<uint64, ErrorCategory> result = ProduceExpected(value, f);
+        return result ? *result : uint64(1);
+    });
+    run("error code + out parameter", [](uint64 value, bool f) {
+        uint64 out = 0;
+        return ProduceErrorCode(value, f, out) == ErrorCategory::None ? out : uint64(1);
+    });
+    run("Result<Handle>", [](uint64 value, bool f) {
+        Result<Handle> result = ProduceHandleResult(value, f);
+        return result ? reinterpret_cast<uint64>(result.Value().ptr) : uint64(1);
+    });
+    run("std::expected<Handle>", [](uint64 value, bool f) {
+        std::expected<Handle, ErrorCategory> result = ProduceHandleExpected(value, f);
+        return result ? reinterpret_cast<uint64>(result->ptr) : uint64(1);
+    });
+    run("Result<uint64>::Transform", [](uint64 value, bool f) {
+        Result<uint64> result = ProduceResult(value, f, FailureText::Static).Transform(
+            [](uint64 v) { return v * 3; });
+        return result ? result.Value() : uint64(1);
+    });
+#if __cpp_lib_expected >= 202211L // Monadic operations
+    run("std::expected<uint64>::transform", [](uint64 value, bool f) {
+        auto result = ProduceExpected(value, f).transform([](uint64 v) { return v * 3; });
+        return result ? *result : uint64(1);
+    });
+#endif
+}
+
+template <typename T>
+void PrintLayout(const char* name)
+{
+    printf("  %-32s size %2zu (expected %2zu), trivially copyable %d (expected %d)\n",
+           name,
+           sizeof(Result<T>),
+           sizeof(std::expected<T, ErrorCategory>),
+           __is_trivially_copyable(Result<T>) ? 1 : 0,
+           __is_trivially_copyable(std::expected<T, ErrorCategory>) ? 1 : 0);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Bench bench("rsbl-result", argc, argv);
+
+    printf("Layout\n");
+    PrintLayout<uint8>("uint8");
+    PrintLayout<uint32>("uint32");
+    PrintLayout<uint64>("uint64");
+    PrintLayout<Handle>("Handle");
+    printf("  %-32s size %2zu\n", "Result<>", sizeof(Result<>));
+    printf("  %-32s size %2zu\n", "Result<int&>", sizeof(Result<int&>));
+
+    PathSuite(bench, "Success", false);
+    PathSuite(bench, "Failure", true);
+
+    return bench.Finish();
+}
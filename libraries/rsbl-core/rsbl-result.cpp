@@ -5,30 +5,89 @@
 
 #include "include/rsbl-assert.h"
 
-#include <string>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
 
-// TODO: test sizes of Result with different ReturnTypes
+namespace
+{
+constexpr uint64 kFailureBufferSize = 256;
+
+// Failing should be as cheap as returning an int, so a failure only stores a pointer here. Text
+// that needs copying or formatting goes into the fixed buffer, and never touches the heap.
+struct FailureState
+{
+    const char* text = "";
+
+    // Pending FailureFormat, formatted into buffer on the first GetFailureText
+    const char* format = nullptr;
+    rsbl::Internal::FailureFormatter formatter = nullptr;
+    alignas(16) uint8 args[rsbl::Internal::kFailureFormatArgsSize];
+
+    char buffer[kFailureBufferSize];
+};
 
-// TODO: eventually replace with our own string class. Alternatively, char* buffer?
-static thread_local std::string s_failureTextStr;
+thread_local FailureState s_failureState;
+} // namespace
 
 namespace rsbl::Internal
 {
 void SetFailureText(const char* text)
 {
-    if (text == s_failureTextStr.c_str())
+    rsblAssert(text != nullptr);
+
+    s_failureState.text = text;
+    s_failureState.formatter = nullptr;
+}
+
+const char* GetFailureText()
+{
+    FailureState& state = s_failureState;
+    if (state.formatter != nullptr)
     {
-        // is this possible?
-        return;
+        state.formatter(state.buffer, kFailureBufferSize, state.format, state.args);
+        state.formatter = nullptr;
+        state.text = state.buffer;
     }
+    return state.text;
+}
 
+void CopyFailureText(const char* text)
+{
     rsblAssert(text != nullptr);
 
-    s_failureTextStr = text;
+    FailureState& state = s_failureState;
+
+    // memmove, since this could be re-reporting the buffer's own text from further down the stack
+    const uint64 length = strnlen(text, kFailureBufferSize - 1);
+    memmove(state.buffer, text, length);
+    state.buffer[length] = '\0';
+    state.text = state.buffer;
+    state.formatter = nullptr;
 }
 
-const char* GetFailureText()
+void SetFailureFormat(const char* format,
+                      FailureFormatter formatter,
+                      const void* args,
+                      uint64 args_size)
+{
+    rsblAssert(format != nullptr);
+    rsblAssert(args_size <= kFailureFormatArgsSize);
+
+    FailureState& state = s_failureState;
+    state.format = format;
+    state.formatter = formatter;
+    memcpy(state.args, args, args_size);
+
+    // Until it's formatted, the format string is better than stale text
+    state.text = format;
+}
+
+void FormatFailureText(char* buffer, uint64 buffer_size, const char* format, ...)
 {
-    return s_failureTextStr.c_str();
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, buffer_size, format, args);
+    va_end(args);
 }
-} // namespace rsbl::Internal
\ No newline at end of file
+} // namespace rsbl::Internal
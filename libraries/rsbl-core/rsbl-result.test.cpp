@@ -280,6 +280,231 @@ TEST_SUITE("rsbl::Result")
 
         CHECK(r3.Value() == 99);
         CHECK(r2.Value() == 42);
-        CHECK(r1.Code() == ResultCode::Failure);
+
+        // int is trivially copyable, so the move is a plain copy and r1 is left as it was
+        CHECK(r1.Code() == ResultCode::Success);
+        CHECK(r1.Value() == 42);
+    }
+
+    TEST_CASE("Failure text is not copied")
+    {
+        static const char kText[] = "Static failure";
+        Result<int> result(kText);
+
+        CHECK(result.FailureText() == kText);
+        CHECK(result.Category() == ErrorCategory::Generic);
+    }
+
+    TEST_CASE("ErrorCategory")
+    {
+        Result<int> success(7);
+        CHECK(success.Category() == ErrorCategory::None);
+
+        Result<int> code_failure(ResultCode::Failure);
+        CHECK(code_failure.Category() == ErrorCategory::Generic);
+
+        Result<int> not_found(ErrorCategory::NotFound, "Missing");
+        CHECK(not_found.Code() == ResultCode::Failure);
+        CHECK(not_found.Category() == ErrorCategory::NotFound);
+        CHECK(std::string(not_found.FailureText()) == "Missing");
+
+        Result<int> moved(rsblMove(not_found));
+        CHECK(moved.Category() == ErrorCategory::NotFound);
+    }
+
+    TEST_CASE("FailureFormat is formatted lazily")
+    {
+        enum class Stage : uint8
+        {
+            Load = 3,
+        };
+
+        int attempt = 5;
+        Result<int> result =
+            FailureFormat(ErrorCategory::Timeout, "Attempt %d at stage %d", attempt, Stage::Load);
+        attempt = 6; // Arguments are captured by value
+
+        CHECK(result.Code() == ResultCode::Failure);
+        CHECK(result.Category() == ErrorCategory::Timeout);
+        CHECK(std::string(result.FailureText()) == "Attempt 5 at stage 3");
+
+        // Asking again doesn't re-format
+        CHECK(std::string(result.FailureText()) == "Attempt 5 at stage 3");
+    }
+
+    TEST_CASE("FailureFormat with mixed argument types")
+    {
+        Result<> result = FailureFormat(ErrorCategory::Io, "%llu bytes, %.1f%%",
+                                        static_cast<unsigned long long>(1024), 50.0f);
+        CHECK(std::string(result.FailureText()) == "1024 bytes, 50.0%");
+
+        // A newer failure replaces the pending format
+        Result<> newer("Newer failure");
+        CHECK(std::string(result.FailureText()) == "Newer failure");
+    }
+
+    TEST_CASE("FailureCopy outlives its source")
+    {
+        Result<int> result(ResultCode::Failure);
+        {
+            char buffer[32] = "Temporary text";
+            result = FailureCopy(ErrorCategory::Platform, buffer);
+            buffer[0] = 'X';
+        }
+
+        CHECK(result.Category() == ErrorCategory::Platform);
+        CHECK(std::string(result.FailureText()) == "Temporary text");
+
+        // Long text is truncated rather than overflowing
+        std::string long_text(1000, 'a');
+        Result<int> truncated = FailureCopy(ErrorCategory::Generic, long_text.c_str());
+        CHECK(std::string(truncated.FailureText()).size() < long_text.size());
+        CHECK(std::string(truncated.FailureText()).find_first_not_of('a') == std::string::npos);
+
+        // Re-reporting the current text is fine
+        Result<int> rereported = FailureCopy(ErrorCategory::Generic, truncated.FailureText());
+        CHECK(std::string(rereported.FailureText()) == std::string(truncated.FailureText()));
+    }
+
+    TEST_CASE("Layout and triviality")
+    {
+        struct Handle
+        {
+            void* ptr;
+        };
+
+        // Trivially copyable payloads make trivially copyable Results
+        static_assert(__is_trivially_copyable(Result<>));
+        static_assert(__is_trivially_copyable(Result<uint64>));
+        static_assert(__is_trivially_copyable(Result<Handle>));
+        static_assert(__is_trivially_copyable(Result<int&>));
+        static_assert(!__is_trivially_copyable(Result<TestStruct>));
+
+        // Code and category share the padding after the value
+        static_assert(sizeof(Result<>) == 3);
+        static_assert(sizeof(Result<uint32>) == 8);
+        static_assert(sizeof(Result<uint64>) == 16);
+        static_assert(sizeof(Result<Handle>) == 16);
+        static_assert(sizeof(Result<int&>) == 16);
+
+        static_assert(IsTriviallyRelocatable<Result<uint64>>);
+        static_assert(IsTriviallyRelocatable<Result<TestStruct>> ==
+                      IsTriviallyRelocatable<TestStruct>);
+
+        Result<uint64> original(uint64(7));
+        Result<uint64> copy = original;
+        CHECK(copy.Value() == 7);
+        CHECK(original.Value() == 7);
+    }
+
+    TEST_CASE("Reference results")
+    {
+        int value = 10;
+        Result<int&> result(value);
+        REQUIRE(result);
+        CHECK(&result.Value() == &value);
+
+        result.Value() = 20;
+        CHECK(value == 20);
+
+        // Assignment rebinds, like a pointer
+        int other = 30;
+        result = Result<int&>(other);
+        CHECK(&result.Value() == &other);
+        CHECK(value == 20);
+
+        Result<const int&> failure(ErrorCategory::NotFound, "No such element");
+        CHECK(failure.Code() == ResultCode::Failure);
+        CHECK(failure.Category() == ErrorCategory::NotFound);
+        CHECK(std::string(failure.FailureText()) == "No such element");
+    }
+
+    TEST_CASE("AndThen")
+    {
+        auto half = [](int value) -> Result<int>
+        {
+            if (value % 2 != 0)
+            {
+                return {ErrorCategory::InvalidArgument, "Odd value"};
+            }
+            return value / 2;
+        };
+
+        Result<int> even(8);
+        Result<int> halved = even.AndThen(half);
+        REQUIRE(halved);
+        CHECK(halved.Value() == 4);
+
+        Result<int> odd = Result<int>(8).AndThen(half).AndThen(half).AndThen(half).AndThen(half);
+        CHECK(odd.Category() == ErrorCategory::InvalidArgument);
+        CHECK(std::string(odd.FailureText()) == "Odd value");
+
+        // Failures skip the continuation
+        bool called = false;
+        Result<int> failed(ErrorCategory::Io, "Read failed");
+        Result<float> next = failed.AndThen(
+            [&called](int) -> Result<float>
+            {
+                called = true;
+                return 1.0f;
+            });
+        CHECK_FALSE(called);
+        CHECK(next.Category() == ErrorCategory::Io);
+
+        // Result<> continuations take no arguments
+        Result<> empty(ResultCode::Success);
+        Result<int> from_empty = empty.AndThen([]() -> Result<int> { return 3; });
+        CHECK(from_empty.Value() == 3);
+    }
+
+    TEST_CASE("Transform")
+    {
+        Result<int> value(21);
+        Result<float> doubled = value.Transform([](int v) { return v * 2.0f; });
+        REQUIRE(doubled);
+        CHECK(doubled.Value() == 42.0f);
+
+        int seen = 0;
+        Result<> visited = value.Transform([&seen](int v) { seen = v; });
+        CHECK(visited);
+        CHECK(seen == 21);
+
+        Result<int> failed(ErrorCategory::Timeout, "Timed out");
+        Result<float> skipped = failed.Transform([](int v) { return v * 2.0f; });
+        CHECK(skipped.Category() == ErrorCategory::Timeout);
+
+        // Moving out of an rvalue Result
+        TestStruct::resetCounters();
+        Result<int> moved = Result<TestStruct>(TestStruct(5)).Transform(
+            [](TestStruct&& ts) { return TestStruct(rsblMove(ts)).value; });
+        CHECK(moved.Value() == 5);
+        CHECK(TestStruct::constructorCalls == 1);
+    }
+
+    TEST_CASE("OrElse")
+    {
+        Result<int> fallback = Result<int>(ErrorCategory::NotFound, "Missing")
+                                   .OrElse(
+                                       [](ErrorCategory category) -> Result<int>
+                                       {
+                                           CHECK(category == ErrorCategory::NotFound);
+                                           return -1;
+                                       });
+        REQUIRE(fallback);
+        CHECK(fallback.Value() == -1);
+
+        Result<int> kept = Result<int>(5).OrElse([](ErrorCategory) -> Result<int> { return -1; });
+        CHECK(kept.Value() == 5);
+
+        int value = 1;
+        int backup = 2;
+        Result<int&> missing(ErrorCategory::NotFound, "Missing");
+        Result<int&> found =
+            missing.OrElse([&backup](ErrorCategory) -> Result<int&> { return backup; });
+        CHECK(&found.Value() == &backup);
+
+        Result<int&> present(value);
+        CHECK(present.Transform([](int& v) { return v + 1; }).Value() == 2);
+        CHECK(&present.AndThen([](int& v) -> Result<int&> { return v; }).Value() == &value);
     }
 }
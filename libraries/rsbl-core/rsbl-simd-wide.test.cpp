@@ -0,0 +1,214 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-simd-wide.h"
+
+using namespace rsbl;
+using namespace rsbl::simd;
+
+// Every width goes through the same checks. Which ones hit a native register depends on the
+// compiler flags of this file, the rest run the generic loops.
+
+namespace
+{
+template <uint32 W>
+FloatxN<W> Iota(float start, float step)
+{
+    float values[W];
+    for (uint32 i = 0; i < W; ++i)
+    {
+        values[i] = start + step * static_cast<float>(i);
+    }
+    return FloatxN<W>::LoadUnaligned(values);
+}
+
+template <uint32 W>
+void CheckLanes(FloatxN<W> v, float start, float step)
+{
+    for (uint32 i = 0; i < W; ++i)
+    {
+        CHECK(v.Lane(i) == doctest::Approx(start + step * static_cast<float>(i)));
+    }
+}
+
+template <uint32 W>
+void CheckLoadsAndStores()
+{
+    CAPTURE(W);
+    CheckLanes(FloatxN<W>(3.0f), 3.0f, 0.0f);
+
+    alignas(64) float aligned[W];
+    float unaligned[W + 1];
+    for (uint32 i = 0; i < W; ++i)
+    {
+        aligned[i] = static_cast<float>(i);
+        unaligned[i + 1] = static_cast<float>(i) * 2.0f;
+    }
+    CheckLanes(FloatxN<W>::LoadAligned(aligned), 0.0f, 1.0f);
+    CheckLanes(FloatxN<W>::LoadUnaligned(unaligned + 1), 0.0f, 2.0f);
+
+    unaligned[0] = -1.0f;
+    StoreUnaligned(Iota<W>(5.0f, 1.0f), unaligned + 1);
+    CHECK(unaligned[0] == -1.0f);
+    CHECK(unaligned[1] == 5.0f);
+    CHECK(unaligned[W] == 5.0f + static_cast<float>(W - 1));
+
+    StoreAligned(FloatxN<W>(2.0f), aligned);
+    CHECK(aligned[W - 1] == 2.0f);
+}
+
+template <uint32 W>
+void CheckArithmetic()
+{
+    CAPTURE(W);
+    const FloatxN<W> a = Iota<W>(1.0f, 1.0f);
+    const FloatxN<W> b(2.0f);
+
+    CheckLanes(a + b, 3.0f, 1.0f);
+    CheckLanes(a - b, -1.0f, 1.0f);
+    CheckLanes(a * b, 2.0f, 2.0f);
+    CheckLanes(a / b, 0.5f, 0.5f);
+    CheckLanes(-a, -1.0f, -1.0f);
+    CheckLanes(MultiplyAdd(a, b, FloatxN<W>(1.0f)), 3.0f, 2.0f);
+
+    const FloatxN<W> signs = Iota<W>(-4.0f, 1.0f);
+    for (uint32 i = 0; i < W; ++i)
+    {
+        const float value = -4.0f + static_cast<float>(i);
+        CHECK(Abs(signs).Lane(i) == (value < 0.0f ? -value : value));
+        CHECK(Min(signs, FloatxN<W>(0.0f)).Lane(i) == (value < 0.0f ? value : 0.0f));
+        CHECK(Max(signs, FloatxN<W>(0.0f)).Lane(i) == (value > 0.0f ? value : 0.0f));
+    }
+
+    const FloatxN<W> squares = Iota<W>(1.0f, 1.0f) * Iota<W>(1.0f, 1.0f);
+    CheckLanes(Sqrt(squares), 1.0f, 1.0f);
+}
+
+template <uint32 W>
+void CheckMasks()
+{
+    CAPTURE(W);
+    constexpr uint32 kAll = W == 32 ? ~0u : (1u << W) - 1;
+    const FloatxN<W> a = Iota<W>(0.0f, 1.0f);
+    const FloatxN<W> half(static_cast<float>(W / 2));
+
+    // Lanes below W / 2
+    const uint32 low = (1u << (W / 2)) - 1;
+    CHECK(ToBits(a < half) == low);
+    CHECK(ToBits(a <= half) == (low | (1u << (W / 2))));
+    CHECK(ToBits(a >= half) == (kAll & ~low));
+    CHECK(ToBits(a > half) == (kAll & ~low & ~(1u << (W / 2))));
+    CHECK(ToBits(a == half) == 1u << (W / 2));
+
+    const MaskxN<W> below = a < half;
+    CHECK(ToBits(a == a) == kAll);
+    CHECK(ToBits(below & ~below) == 0);
+    CHECK(ToBits(below | ~below) == kAll);
+    CHECK(ToBits(~below) == (kAll & ~low));
+
+    CHECK(Any(below));
+    CHECK_FALSE(All(below));
+    CHECK(All(below | ~below));
+    CHECK_FALSE(Any(below & ~below));
+
+    const FloatxN<W> selected = Select(below, FloatxN<W>(1.0f), FloatxN<W>(-1.0f));
+    for (uint32 i = 0; i < W; ++i)
+    {
+        CHECK(selected.Lane(i) == (i < W / 2 ? 1.0f : -1.0f));
+    }
+}
+
+template <uint32 W>
+void CheckVec3()
+{
+    CAPTURE(W);
+    float xs[W];
+    float ys[W];
+    float zs[W];
+    for (uint32 i = 0; i < W; ++i)
+    {
+        xs[i] = static_cast<float>(i);
+        ys[i] = 1.0f;
+        zs[i] = 0.0f;
+    }
+
+    const Vec3xN<W> v = Vec3xN<W>::LoadUnaligned(xs, ys, zs);
+    const Vec3xN<W> up(0.0f, 1.0f, 0.0f);
+
+    CheckLanes(Dot(v, up), 1.0f, 0.0f);
+    for (uint32 i = 0; i < W; ++i)
+    {
+        CHECK(LengthSquared(v).Lane(i) == doctest::Approx(1.0f + xs[i] * xs[i]));
+    }
+
+    // x cross y = z, scaled by the x component
+    const Vec3xN<W> cross = Cross(v, up);
+    CheckLanes(cross.x, 0.0f, 0.0f);
+    CheckLanes(cross.y, 0.0f, 0.0f);
+    CheckLanes(cross.z, 0.0f, 1.0f);
+
+    const Vec3xN<W> n = Normalize(v + up);
+    CheckLanes(Length(n), 1.0f, 0.0f);
+
+    const Vec3xN<W> moved = MultiplyAdd(up, FloatxN<W>(2.0f), v);
+    StoreUnaligned(moved - v, xs, ys, zs);
+    for (uint32 i = 0; i < W; ++i)
+    {
+        CHECK(xs[i] == 0.0f);
+        CHECK(ys[i] == 2.0f);
+        CHECK(zs[i] == 0.0f);
+    }
+}
+} // namespace
+
+TEST_SUITE("rsbl::simd::FloatxN")
+{
+    TEST_CASE("Native width matches the compiler flags")
+    {
+#if RSBL_SIMD_AVX512
+        CHECK(kNativeWidth == 16);
+#elif RSBL_SIMD_AVX2
+        CHECK(kNativeWidth == 8);
+#else
+        CHECK(kNativeWidth == 4);
+#endif
+        CHECK(FloatxN<kNativeWidth>::kWidth == kNativeWidth);
+    }
+
+    TEST_CASE("Loads and stores")
+    {
+        CheckLoadsAndStores<4>();
+        CheckLoadsAndStores<8>();
+        CheckLoadsAndStores<16>();
+        CheckLoadsAndStores<3>();
+    }
+
+    TEST_CASE("Arithmetic")
+    {
+        CheckArithmetic<4>();
+        CheckArithmetic<8>();
+        CheckArithmetic<16>();
+        CheckArithmetic<3>();
+    }
+
+    TEST_CASE("Comparisons and masks")
+    {
+        CheckMasks<4>();
+        CheckMasks<8>();
+        CheckMasks<16>();
+        CheckMasks<6>();
+    }
+}
+
+TEST_SUITE("rsbl::simd::Vec3xN")
+{
+    TEST_CASE("Vector math across lanes")
+    {
+        CheckVec3<4>();
+        CheckVec3<8>();
+        CheckVec3<16>();
+    }
+}
@@ -0,0 +1,256 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-simd.h"
+
+#include <bit>
+
+using namespace rsbl;
+
+namespace
+{
+void CheckEqual(simd::float4 v, float x, float y, float z, float w)
+{
+    CHECK(v.X() == doctest::Approx(x));
+    CHECK(v.Y() == doctest::Approx(y));
+    CHECK(v.Z() == doctest::Approx(z));
+    CHECK(v.W() == doctest::Approx(w));
+}
+
+void CheckSameBits(simd::float4 a, simd::float4 b)
+{
+    CHECK(std::bit_cast<uint32>(a.X()) == std::bit_cast<uint32>(b.X()));
+    CHECK(std::bit_cast<uint32>(a.Y()) == std::bit_cast<uint32>(b.Y()));
+    CHECK(std::bit_cast<uint32>(a.Z()) == std::bit_cast<uint32>(b.Z()));
+    CHECK(std::bit_cast<uint32>(a.W()) == std::bit_cast<uint32>(b.W()));
+}
+
+// Opaque to the optimizer, so the runtime side of a comparison really runs the intrinsics
+simd::float4 AtRuntime(simd::float4 v)
+{
+    volatile float lanes[4] = {v.X(), v.Y(), v.Z(), v.W()};
+    return simd::float4(lanes[0], lanes[1], lanes[2], lanes[3]);
+}
+
+constexpr simd::float4 kA(1.5f, -2.25f, 3.0f, 0.1f);
+constexpr simd::float4 kB(-0.3f, 7.0f, 2.5f, -4.0f);
+} // namespace
+
+TEST_SUITE("rsbl::simd::float4")
+{
+    TEST_CASE("Construction and lane access")
+    {
+        CheckEqual(simd::float4(1.0f, 2.0f, 3.0f, 4.0f), 1.0f, 2.0f, 3.0f, 4.0f);
+        CheckEqual(simd::float4(7.0f), 7.0f, 7.0f, 7.0f, 7.0f);
+        CheckEqual(simd::Zero(), 0.0f, 0.0f, 0.0f, 0.0f);
+
+        const simd::float4 v(1.0f, 2.0f, 3.0f, 4.0f);
+        CheckEqual(simd::SplatX(v), 1.0f, 1.0f, 1.0f, 1.0f);
+        CheckEqual(simd::SplatY(v), 2.0f, 2.0f, 2.0f, 2.0f);
+        CheckEqual(simd::SplatZ(v), 3.0f, 3.0f, 3.0f, 3.0f);
+        CheckEqual(simd::SplatW(v), 4.0f, 4.0f, 4.0f, 4.0f);
+    }
+
+    TEST_CASE("Loads and stores")
+    {
+        alignas(16) float aligned[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+        CheckEqual(simd::LoadAligned(aligned), 1.0f, 2.0f, 3.0f, 4.0f);
+
+        float unaligned[5] = {0.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+        CheckEqual(simd::LoadUnaligned(unaligned + 1), 5.0f, 6.0f, 7.0f, 8.0f);
+
+        CheckEqual(simd::Load(float4(1.0f, 2.0f, 3.0f, 4.0f)), 1.0f, 2.0f, 3.0f, 4.0f);
+        CheckEqual(simd::Load(float3(1.0f, 2.0f, 3.0f)), 1.0f, 2.0f, 3.0f, 0.0f);
+        CheckEqual(simd::Load(float3(1.0f, 2.0f, 3.0f), 1.0f), 1.0f, 2.0f, 3.0f, 1.0f);
+        CheckEqual(simd::Load(float2(1.0f, 2.0f)), 1.0f, 2.0f, 0.0f, 0.0f);
+
+        const simd::float4 v(9.0f, 8.0f, 7.0f, 6.0f);
+        simd::StoreAligned(v, aligned);
+        CHECK(aligned[3] == 6.0f);
+        simd::StoreUnaligned(v, unaligned + 1);
+        CHECK(unaligned[0] == 0.0f);
+        CHECK(unaligned[1] == 9.0f);
+        CHECK(unaligned[4] == 6.0f);
+
+        const float4 f4 = simd::ToFloat4(v);
+        CHECK(f4.x == 9.0f);
+        CHECK(f4.w == 6.0f);
+        const float2 f2 = simd::ToFloat2(v);
+        CHECK(f2.y == 8.0f);
+    }
+
+    TEST_CASE("float3 loads and stores stay inside the element")
+    {
+        float3 points[3] = {float3(1.0f, 2.0f, 3.0f), float3(4.0f, 5.0f, 6.0f),
+                            float3(-1.0f, -1.0f, -1.0f)};
+
+        CheckEqual(simd::Load(points[1]), 4.0f, 5.0f, 6.0f, 0.0f);
+
+        simd::Store(simd::float4(7.0f, 8.0f, 9.0f, 100.0f), points[1]);
+        CHECK(points[1].x == 7.0f);
+        CHECK(points[1].y == 8.0f);
+        CHECK(points[1].z == 9.0f);
+        // w didn't spill into the next element
+        CHECK(points[2].x == -1.0f);
+
+        const float3 f3 = simd::ToFloat3(simd::float4(1.0f, 2.0f, 3.0f, 4.0f));
+        CHECK(f3.z == 3.0f);
+    }
+
+    TEST_CASE("Arithmetic")
+    {
+        const simd::float4 a(1.0f, 2.0f, 3.0f, 4.0f);
+        const simd::float4 b(4.0f, 3.0f, 2.0f, 1.0f);
+
+        CheckEqual(a + b, 5.0f, 5.0f, 5.0f, 5.0f);
+        CheckEqual(a - b, -3.0f, -1.0f, 1.0f, 3.0f);
+        CheckEqual(a * b, 4.0f, 6.0f, 6.0f, 4.0f);
+        CheckEqual(a / b, 0.25f, 2.0f / 3.0f, 1.5f, 4.0f);
+        CheckEqual(-a, -1.0f, -2.0f, -3.0f, -4.0f);
+        CheckEqual(a * 2.0f, 2.0f, 4.0f, 6.0f, 8.0f);
+        CheckEqual(2.0f * a, 2.0f, 4.0f, 6.0f, 8.0f);
+        CheckEqual(a / 2.0f, 0.5f, 1.0f, 1.5f, 2.0f);
+        CheckEqual(simd::MultiplyAdd(a, b, simd::float4(1.0f)), 5.0f, 7.0f, 7.0f, 5.0f);
+
+        simd::float4 c = a;
+        c += b;
+        c -= simd::float4(1.0f);
+        c *= 2.0f;
+        c /= simd::float4(2.0f, 4.0f, 8.0f, 1.0f);
+        CheckEqual(c, 4.0f, 2.0f, 1.0f, 8.0f);
+    }
+
+    TEST_CASE("Min, Max, Clamp, Abs, Sqrt")
+    {
+        const simd::float4 a(1.0f, -2.0f, 3.0f, -4.0f);
+        const simd::float4 b(0.0f, 0.0f, 5.0f, -5.0f);
+
+        CheckEqual(simd::Min(a, b), 0.0f, -2.0f, 3.0f, -5.0f);
+        CheckEqual(simd::Max(a, b), 1.0f, 0.0f, 5.0f, -4.0f);
+        CheckEqual(simd::Clamp(a, simd::float4(-1.0f), simd::float4(2.0f)), 1.0f, -1.0f, 2.0f,
+                   -1.0f);
+        CheckEqual(simd::Abs(a), 1.0f, 2.0f, 3.0f, 4.0f);
+        CheckEqual(simd::Sqrt(simd::float4(4.0f, 9.0f, 16.0f, 0.0f)), 2.0f, 3.0f, 4.0f, 0.0f);
+    }
+
+    TEST_CASE("Lerp")
+    {
+        const simd::float4 a(0.0f, 10.0f, -10.0f, 1.0f);
+        const simd::float4 b(10.0f, 20.0f, 10.0f, 1.0f);
+
+        CheckEqual(simd::Lerp(a, b, 0.0f), 0.0f, 10.0f, -10.0f, 1.0f);
+        CheckEqual(simd::Lerp(a, b, 1.0f), 10.0f, 20.0f, 10.0f, 1.0f);
+        CheckEqual(simd::Lerp(a, b, 0.25f), 2.5f, 12.5f, -5.0f, 1.0f);
+        CheckEqual(simd::Lerp(a, b, simd::float4(0.0f, 0.5f, 1.0f, 0.0f)), 0.0f, 15.0f, 10.0f,
+                   1.0f);
+    }
+
+    TEST_CASE("Dot, Cross, Length, Normalize")
+    {
+        const simd::float4 a(1.0f, 2.0f, 3.0f, 4.0f);
+        const simd::float4 b(5.0f, 6.0f, 7.0f, 8.0f);
+
+        CHECK(simd::Dot4(a, b) == doctest::Approx(70.0f));
+        CHECK(simd::Dot3(a, b) == doctest::Approx(38.0f));
+
+        const simd::float4 x(1.0f, 0.0f, 0.0f, 5.0f);
+        const simd::float4 y(0.0f, 1.0f, 0.0f, 5.0f);
+        CheckEqual(simd::Cross3(x, y), 0.0f, 0.0f, 1.0f, 0.0f);
+        CheckEqual(simd::Cross3(y, x), 0.0f, 0.0f, -1.0f, 0.0f);
+        CheckEqual(simd::Cross3(a, b), -4.0f, 8.0f, -4.0f, 0.0f);
+
+        const simd::float4 v(3.0f, 4.0f, 0.0f, 100.0f);
+        CHECK(simd::Length3(v) == doctest::Approx(5.0f));
+        CHECK(simd::Length4(simd::float4(1.0f)) == doctest::Approx(2.0f));
+
+        const simd::float4 n = simd::Normalize3(v);
+        CHECK(n.X() == doctest::Approx(0.6f));
+        CHECK(n.Y() == doctest::Approx(0.8f));
+        CHECK(simd::Length4(simd::Normalize4(a)) == doctest::Approx(1.0f));
+    }
+
+    TEST_CASE("SetW and Transpose")
+    {
+        CheckEqual(simd::SetW(simd::float4(1.0f, 2.0f, 3.0f, 4.0f), 9.0f), 1.0f, 2.0f, 3.0f, 9.0f);
+
+        simd::float4 a(1.0f, 2.0f, 3.0f, 4.0f);
+        simd::float4 b(5.0f, 6.0f, 7.0f, 8.0f);
+        simd::float4 c(9.0f, 10.0f, 11.0f, 12.0f);
+        simd::float4 d(13.0f, 14.0f, 15.0f, 16.0f);
+        simd::Transpose(a, b, c, d);
+        CheckEqual(a, 1.0f, 5.0f, 9.0f, 13.0f);
+        CheckEqual(b, 2.0f, 6.0f, 10.0f, 14.0f);
+        CheckEqual(c, 3.0f, 7.0f, 11.0f, 15.0f);
+        CheckEqual(d, 4.0f, 8.0f, 12.0f, 16.0f);
+    }
+
+    TEST_CASE("Constant evaluation")
+    {
+        static_assert(simd::float4(1.0f, 2.0f, 3.0f, 4.0f).Z() == 3.0f);
+        static_assert((kA + kB).Y() == -2.25f + 7.0f);
+        static_assert(simd::Dot3(simd::float4(1.0f, 2.0f, 3.0f, 4.0f),
+                                 simd::float4(5.0f, 6.0f, 7.0f, 8.0f)) == 38.0f);
+        static_assert(simd::Cross3(simd::float4(1.0f, 0.0f, 0.0f, 0.0f),
+                                   simd::float4(0.0f, 1.0f, 0.0f, 0.0f))
+                          .Z() == 1.0f);
+        static_assert(simd::Swizzle<3, 2, 1, 0>(kA).X() == 0.1f);
+        static_assert(simd::SetW(kA, 9.0f).W() == 9.0f);
+        static_assert(simd::Abs(simd::float4(-0.0f)).X() == 0.0f);
+        static_assert(simd::Length3(simd::float4(3.0f, 4.0f, 12.0f, 100.0f)) == 13.0f);
+        static_assert(simd::ToFloat3(simd::Load(rsbl::float3(1.0f, 2.0f, 3.0f), 4.0f)).y ==
+                      2.0f);
+
+        constexpr rsbl::float4 stored = [] {
+            rsbl::float4 out;
+            simd::Store(simd::Max(kA, kB), out);
+            return out;
+        }();
+        static_assert(stored.x == 1.5f && stored.y == 7.0f && stored.z == 3.0f &&
+                      stored.w == 0.1f);
+
+        // A constexpr value read at runtime goes through the native register
+        CheckEqual(kA, 1.5f, -2.25f, 3.0f, 0.1f);
+        CheckEqual(simd::SplatZ(kA), 3.0f, 3.0f, 3.0f, 3.0f);
+    }
+
+    TEST_CASE("Compile time and runtime agree bit for bit")
+    {
+        const simd::float4 a = AtRuntime(kA);
+        const simd::float4 b = AtRuntime(kB);
+
+        constexpr simd::float4 sum = kA + kB;
+        constexpr simd::float4 quotient = kA / kB;
+        constexpr simd::float4 clamped = simd::Clamp(kA, simd::float4(-1.0f), simd::float4(2.0f));
+        constexpr simd::float4 cross = simd::Cross3(kA, kB);
+        constexpr simd::float4 root = simd::Sqrt(simd::Abs(kA));
+        constexpr simd::float4 normalized = simd::Normalize4(kB);
+        constexpr simd::float4 swizzled = simd::Swizzle<1, 3, 0, 2>(kA);
+        CheckSameBits(sum, a + b);
+        CheckSameBits(quotient, a / b);
+        CheckSameBits(clamped, simd::Clamp(a, simd::float4(-1.0f), simd::float4(2.0f)));
+        CheckSameBits(cross, simd::Cross3(a, b));
+        CheckSameBits(root, simd::Sqrt(simd::Abs(a)));
+        CheckSameBits(normalized, simd::Normalize4(b));
+        CheckSameBits(swizzled, simd::Swizzle<1, 3, 0, 2>(a));
+
+        constexpr float dot4 = simd::Dot4(kA, kB);
+        constexpr float dot3 = simd::Dot3(kA, kB);
+        constexpr float length = simd::Length3(kB);
+        CHECK(std::bit_cast<uint32>(dot4) == std::bit_cast<uint32>(simd::Dot4(a, b)));
+        CHECK(std::bit_cast<uint32>(dot3) == std::bit_cast<uint32>(simd::Dot3(a, b)));
+        CHECK(std::bit_cast<uint32>(length) == std::bit_cast<uint32>(simd::Length3(b)));
+
+        // sqrt at compile time rounds like sqrtf over a spread of magnitudes
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            const float value = std::bit_cast<float>(0x00800000u + i * 2129871u);
+            CAPTURE(value);
+            CHECK(simd::Internal::ConstSqrt(value) == sqrtf(value));
+        }
+        CHECK(simd::Internal::ConstSqrt(0.0f) == 0.0f);
+        CHECK(simd::Internal::ConstSqrt(-1.0f) != simd::Internal::ConstSqrt(-1.0f));
+    }
+}
@@ -0,0 +1,175 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-hash-map.h"
+#include "include/rsbl-ptr.h"
+#include "include/rsbl-slot-map.h"
+
+using namespace rsbl;
+
+struct TrackedObject
+{
+    int value;
+    static inline int liveCount = 0;
+
+    TrackedObject(int v = 0)
+        : value(v)
+    {
+        liveCount++;
+    }
+
+    TrackedObject(TrackedObject&& other) noexcept
+        : value(other.value)
+    {
+        liveCount++;
+    }
+
+    TrackedObject(const TrackedObject&) = delete;
+    TrackedObject& operator=(const TrackedObject&) = delete;
+
+    ~TrackedObject()
+    {
+        liveCount--;
+    }
+};
+
+TEST_SUITE("rsbl::SlotMap")
+{
+    TEST_CASE("Null handle is never valid")
+    {
+        SlotMap<int> map;
+        SlotHandle handle;
+        CHECK(handle.IsNull());
+        CHECK(map.Get(handle) == nullptr);
+        CHECK_FALSE(map.Remove(handle));
+
+        map.Insert(1);
+        CHECK(map.Get(handle) == nullptr);
+    }
+
+    TEST_CASE("Insert and Get")
+    {
+        SlotMap<int> map;
+        SlotHandle a = map.Insert(10);
+        SlotHandle b = map.Insert(20);
+
+        CHECK(map.Size() == 2);
+        CHECK_FALSE(a.IsNull());
+        CHECK(a != b);
+        REQUIRE(map.Get(a) != nullptr);
+        CHECK(*map.Get(a) == 10);
+        CHECK(*map.Get(b) == 20);
+    }
+
+    TEST_CASE("Stale handles are detected after slot reuse")
+    {
+        SlotMap<int> map;
+        SlotHandle a = map.Insert(1);
+        CHECK(map.Remove(a));
+        CHECK_FALSE(map.Remove(a));
+        CHECK(map.Get(a) == nullptr);
+
+        // Same slot, new generation
+        SlotHandle b = map.Insert(2);
+        CHECK(b.index == a.index);
+        CHECK(b.generation != a.generation);
+        CHECK(map.Get(a) == nullptr);
+        CHECK(*map.Get(b) == 2);
+    }
+
+    TEST_CASE("Removal keeps storage dense and handles stable")
+    {
+        SlotMap<int> map;
+        SlotHandle handles[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            handles[i] = map.Insert(i);
+        }
+
+        map.Remove(handles[0]);
+        map.Remove(handles[5]);
+        CHECK(map.Size() == 6);
+
+        int sum = 0;
+        for (int value : map)
+        {
+            sum += value;
+        }
+        CHECK(sum == 1 + 2 + 3 + 4 + 6 + 7);
+
+        for (int i = 0; i < 8; ++i)
+        {
+            if (i == 0 || i == 5)
+            {
+                CHECK(map.Get(handles[i]) == nullptr);
+            }
+            else
+            {
+                REQUIRE(map.Get(handles[i]) != nullptr);
+                CHECK(*map.Get(handles[i]) == i);
+            }
+        }
+    }
+
+    TEST_CASE("HandleAt matches dense iteration")
+    {
+        SlotMap<int> map;
+        for (int i = 0; i < 10; ++i)
+        {
+            map.Insert(i * 3);
+        }
+        map.Remove(map.HandleAt(2));
+
+        for (uint64 i = 0; i < map.Size(); ++i)
+        {
+            CHECK(map.Get(map.HandleAt(i)) == &map.Data()[i]);
+        }
+    }
+
+    TEST_CASE("Move-only objects are destroyed exactly once")
+    {
+        {
+            SlotMap<TrackedObject> map;
+            SlotHandle first = map.Emplace(1);
+            for (int i = 2; i < 100; ++i)
+            {
+                map.Emplace(i);
+            }
+            CHECK(TrackedObject::liveCount == 99);
+
+            map.Remove(first);
+            CHECK(TrackedObject::liveCount == 98);
+
+            map.Clear();
+            CHECK(TrackedObject::liveCount == 0);
+            CHECK(map.IsEmpty());
+
+            map.Emplace(5);
+        }
+        CHECK(TrackedObject::liveCount == 0);
+    }
+
+    TEST_CASE("UniquePtr values")
+    {
+        SlotMap<UniquePtr<int>> map;
+        SlotHandle handle = map.Insert(UniquePtr<int>(new int(7)));
+        map.Insert(UniquePtr<int>(new int(8)));
+        CHECK(**map.Get(handle) == 7);
+        map.Remove(handle);
+        CHECK(**map.Get(map.HandleAt(0)) == 8);
+    }
+
+    TEST_CASE("Handles pack to 64 bits and work as HashMap keys")
+    {
+        SlotMap<int> map;
+        SlotHandle handle = map.Insert(3);
+        CHECK(SlotHandle::FromUint64(handle.ToUint64()) == handle);
+
+        HashMap<SlotHandle, int> lookup;
+        lookup.Insert(handle, 42);
+        CHECK(*lookup.Find(handle) == 42);
+    }
+}
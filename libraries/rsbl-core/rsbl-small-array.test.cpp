@@ -0,0 +1,264 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-core.h"
+#include "include/rsbl-small-array.h"
+
+using namespace rsbl;
+
+// Test helper struct with tracking capabilities
+struct TestStruct
+{
+    int value;
+    static inline int constructorCalls = 0;
+    static inline int destructorCalls = 0;
+    static inline int moveConstructorCalls = 0;
+    static inline int copyConstructorCalls = 0;
+
+    TestStruct(int v = 0)
+        : value(v)
+    {
+        constructorCalls++;
+    }
+
+    TestStruct(const TestStruct& other)
+        : value(other.value)
+    {
+        copyConstructorCalls++;
+    }
+
+    TestStruct(TestStruct&& other) noexcept
+        : value(other.value)
+    {
+        moveConstructorCalls++;
+        other.value = -1; // Mark as moved
+    }
+
+    TestStruct& operator=(const TestStruct&) = delete;
+
+    ~TestStruct()
+    {
+        destructorCalls++;
+    }
+
+    static void resetCounters()
+    {
+        constructorCalls = 0;
+        destructorCalls = 0;
+        moveConstructorCalls = 0;
+        copyConstructorCalls = 0;
+    }
+};
+
+// Fails the test if the array touches the heap
+class FailingAllocator : public Allocator
+{
+  public:
+    void* Allocate(uint64 size, uint64 alignment) override
+    {
+        allocCalls++;
+        return GetDefaultAllocator()->Allocate(size, alignment);
+    }
+
+    void Free(void* ptr, uint64 size, uint64 alignment) override
+    {
+        GetDefaultAllocator()->Free(ptr, size, alignment);
+    }
+
+    int allocCalls = 0;
+};
+
+TEST_SUITE("rsbl::SmallArray")
+{
+    TEST_CASE("Default constructor uses inline storage")
+    {
+        SmallArray<int, 4> arr;
+
+        CHECK(arr.Size() == 0);
+        CHECK(arr.IsEmpty());
+        CHECK(arr.Capacity() == 4);
+        CHECK(arr.IsUsingInlineStorage());
+        CHECK(SmallArray<int, 4>::InlineCapacity() == 4);
+    }
+
+    TEST_CASE("Elements up to N never allocate")
+    {
+        FailingAllocator allocator;
+        SmallArray<int, 4> arr(&allocator);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            arr.PushBack(i);
+        }
+
+        CHECK(arr.Size() == 4);
+        CHECK(arr.IsUsingInlineStorage());
+        CHECK(allocator.allocCalls == 0);
+        CHECK(arr[3] == 3);
+    }
+
+    TEST_CASE("Spills to the heap past N")
+    {
+        FailingAllocator allocator;
+        SmallArray<int, 4> arr(&allocator);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            arr.PushBack(i);
+        }
+
+        CHECK(arr.Size() == 100);
+        CHECK_FALSE(arr.IsUsingInlineStorage());
+        CHECK(allocator.allocCalls > 0);
+        for (int i = 0; i < 100; ++i)
+        {
+            CHECK(arr[static_cast<uint64>(i)] == i);
+        }
+    }
+
+    TEST_CASE("Non-trivial types are moved when spilling")
+    {
+        TestStruct::resetCounters();
+
+        {
+            SmallArray<TestStruct, 2> arr;
+            arr.EmplaceBack(1);
+            arr.EmplaceBack(2);
+            arr.EmplaceBack(3);
+
+            CHECK(arr.Size() == 3);
+            CHECK(arr[0].value == 1);
+            CHECK(arr[2].value == 3);
+            CHECK(TestStruct::moveConstructorCalls == 2);
+        }
+
+        CHECK(TestStruct::constructorCalls + TestStruct::moveConstructorCalls ==
+              TestStruct::destructorCalls);
+    }
+
+    TEST_CASE("PopBack and Clear destroy elements")
+    {
+        TestStruct::resetCounters();
+
+        SmallArray<TestStruct, 4> arr;
+        arr.EmplaceBack(1);
+        arr.EmplaceBack(2);
+        arr.PopBack();
+        CHECK(arr.Size() == 1);
+        CHECK(TestStruct::destructorCalls == 1);
+
+        arr.Clear();
+        CHECK(arr.IsEmpty());
+        CHECK(TestStruct::destructorCalls == 2);
+    }
+
+    TEST_CASE("Resize default-constructs and destroys")
+    {
+        SmallArray<int, 2> arr;
+        arr.Resize(10);
+        CHECK(arr.Size() == 10);
+        CHECK(arr[9] == 0);
+
+        arr.Resize(1);
+        CHECK(arr.Size() == 1);
+    }
+
+    TEST_CASE("Copy is independent, inline and spilled")
+    {
+        SmallArray<int, 2> inline_arr;
+        inline_arr.PushBack(1);
+
+        SmallArray<int, 2> spilled_arr;
+        for (int i = 0; i < 5; ++i)
+        {
+            spilled_arr.PushBack(i);
+        }
+
+        SmallArray<int, 2> inline_copy(inline_arr);
+        SmallArray<int, 2> spilled_copy;
+        spilled_copy = spilled_arr;
+
+        inline_arr[0] = 99;
+        spilled_arr[4] = 99;
+
+        CHECK(inline_copy.IsUsingInlineStorage());
+        CHECK(inline_copy[0] == 1);
+        CHECK(spilled_copy.Size() == 5);
+        CHECK(spilled_copy[4] == 4);
+    }
+
+    TEST_CASE("Move from inline moves elements")
+    {
+        TestStruct::resetCounters();
+
+        SmallArray<TestStruct, 4> arr1;
+        arr1.EmplaceBack(7);
+
+        SmallArray<TestStruct, 4> arr2(rsblMove(arr1));
+        CHECK(arr2.Size() == 1);
+        CHECK(arr2[0].value == 7);
+        CHECK(arr2.IsUsingInlineStorage());
+        CHECK(arr1.Size() == 0);
+        CHECK(TestStruct::moveConstructorCalls == 1);
+    }
+
+    TEST_CASE("Move from heap steals the buffer")
+    {
+        SmallArray<int, 2> arr1;
+        for (int i = 0; i < 10; ++i)
+        {
+            arr1.PushBack(i);
+        }
+        const int* heap_data = arr1.Data();
+
+        SmallArray<int, 2> arr2;
+        arr2.PushBack(42);
+        arr2 = rsblMove(arr1);
+
+        CHECK(arr2.Data() == heap_data);
+        CHECK(arr2.Size() == 10);
+        CHECK(arr1.Size() == 0);
+        CHECK(arr1.IsUsingInlineStorage());
+
+        // Moved-from array is still usable
+        arr1.PushBack(5);
+        CHECK(arr1[0] == 5);
+    }
+
+    TEST_CASE("Append and iteration")
+    {
+        const int values[] = {1, 2, 3, 4, 5, 6};
+
+        SmallArray<int, 4> arr;
+        arr.Append(values, 6);
+
+        int sum = 0;
+        for (int val : arr)
+        {
+            sum += val;
+        }
+        CHECK(sum == 21);
+
+        const SmallArray<int, 4>& const_arr = arr;
+        CHECK(*const_arr.begin() == 1);
+        CHECK(const_arr.end() - const_arr.begin() == 6);
+    }
+
+    TEST_CASE("Over-aligned types stay aligned inline")
+    {
+        struct alignas(32) Aligned
+        {
+            float values[8];
+        };
+
+        SmallArray<Aligned, 2> arr;
+        arr.Resize(2);
+        CHECK((reinterpret_cast<uint64>(arr.Data()) & 31) == 0);
+
+        arr.Resize(3);
+        CHECK((reinterpret_cast<uint64>(arr.Data()) & 31) == 0);
+    }
+}
@@ -0,0 +1,263 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-soa-array.h"
+
+using namespace rsbl;
+
+namespace
+{
+struct Bounds
+{
+    float min[3];
+    float max[3];
+};
+
+enum NodeField : uint32
+{
+    kNodeBounds,
+    kNodeParent,
+    kNodeFlags,
+};
+
+using NodeArray = SoaArray<Bounds, uint32, uint8>;
+
+// Non-trivial field, to check construction and destruction are balanced
+struct Tracked
+{
+    static inline int s_live = 0;
+    int value = 0;
+
+    Tracked()
+    {
+        s_live++;
+    }
+    Tracked(int v)
+        : value(v)
+    {
+        s_live++;
+    }
+    Tracked(const Tracked& other)
+        : value(other.value)
+    {
+        s_live++;
+    }
+    Tracked(Tracked&& other) noexcept
+        : value(other.value)
+    {
+        s_live++;
+        other.value = -1;
+    }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) noexcept = default;
+    ~Tracked()
+    {
+        s_live--;
+    }
+};
+
+bool IsAligned(const void* ptr, uint64 alignment)
+{
+    return (reinterpret_cast<uint64>(ptr) & (alignment - 1)) == 0;
+}
+} // namespace
+
+TEST_SUITE("rsbl::SoaArray")
+{
+    TEST_CASE("Default is empty")
+    {
+        NodeArray nodes;
+        CHECK(nodes.IsEmpty());
+        CHECK(nodes.Size() == 0);
+        CHECK(nodes.Capacity() == 0);
+        CHECK(nodes.Field<kNodeBounds>().IsEmpty());
+        CHECK(NodeArray::kFieldCount == 3);
+    }
+
+    TEST_CASE("PushBack fills every column")
+    {
+        NodeArray nodes;
+        for (uint32 i = 0; i < 100; ++i)
+        {
+            const float f = static_cast<float>(i);
+            nodes.PushBack(Bounds{{f, f, f}, {f + 1, f + 1, f + 1}}, i * 2, static_cast<uint8>(i));
+        }
+
+        REQUIRE(nodes.Size() == 100);
+        for (uint32 i = 0; i < 100; ++i)
+        {
+            CHECK(nodes.Get<kNodeBounds>(i).min[0] == static_cast<float>(i));
+            CHECK(nodes.Get<kNodeParent>(i) == i * 2);
+            CHECK(nodes.Get<kNodeFlags>(i) == static_cast<uint8>(i));
+        }
+    }
+
+    TEST_CASE("Columns are contiguous and aligned")
+    {
+        NodeArray nodes;
+        nodes.Resize(37);
+
+        CHECK(IsAligned(nodes.Data<kNodeBounds>(), kSoaAlignment));
+        CHECK(IsAligned(nodes.Data<kNodeParent>(), kSoaAlignment));
+        CHECK(IsAligned(nodes.Data<kNodeFlags>(), kSoaAlignment));
+
+        uint32* parents = nodes.Data<kNodeParent>();
+        CHECK(&nodes.Get<kNodeParent>(5) == parents + 5);
+
+        // Columns don't overlap
+        const uint8* bounds_end =
+            reinterpret_cast<const uint8*>(nodes.Data<kNodeBounds>() + nodes.Capacity());
+        CHECK(reinterpret_cast<const uint8*>(parents) >= bounds_end);
+    }
+
+    TEST_CASE("Iterating one column")
+    {
+        NodeArray nodes;
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            nodes.EmplaceBack(Bounds{}, i, uint8(0));
+        }
+
+        uint32 sum = 0;
+        for (uint32 parent : nodes.Field<kNodeParent>())
+        {
+            sum += parent;
+        }
+        CHECK(sum == 45);
+
+        for (uint8& flags : nodes.Field<kNodeFlags>())
+        {
+            flags = 1;
+        }
+        CHECK(nodes.Get<kNodeFlags>(9) == 1);
+    }
+
+    TEST_CASE("Row access")
+    {
+        NodeArray nodes;
+        auto row = nodes.EmplaceBack();
+        CHECK(row.Index() == 0);
+        CHECK(row.Get<kNodeParent>() == 0);
+
+        row.Get<kNodeParent>() = 7;
+        row.Get<kNodeBounds>().max[2] = 3.0f;
+        CHECK(nodes[0].Get<kNodeParent>() == 7);
+        CHECK(nodes.Get<kNodeBounds>(0).max[2] == 3.0f);
+
+        const NodeArray& const_nodes = nodes;
+        CHECK(const_nodes[0].Get<kNodeParent>() == 7);
+    }
+
+    TEST_CASE("Resize value-initializes and destroys")
+    {
+        Tracked::s_live = 0;
+        {
+            SoaArray<Tracked, int> array;
+            array.Resize(10);
+            CHECK(array.Size() == 10);
+            CHECK(Tracked::s_live == 10);
+            CHECK(array.Get<1>(9) == 0);
+
+            array.Resize(4);
+            CHECK(Tracked::s_live == 4);
+
+            array.Clear();
+            CHECK(Tracked::s_live == 0);
+            CHECK(array.Capacity() >= 10);
+
+            array.EmplaceBack(Tracked(1), 1);
+            array.EmplaceBack(Tracked(2), 2);
+        }
+        CHECK(Tracked::s_live == 0);
+    }
+
+    TEST_CASE("Growing keeps non-trivial fields intact")
+    {
+        Tracked::s_live = 0;
+        {
+            SoaArray<Tracked, uint64> array;
+            for (int i = 0; i < 1000; ++i)
+            {
+                array.EmplaceBack(i, static_cast<uint64>(i) * 3);
+            }
+            CHECK(Tracked::s_live == 1000);
+            for (int i = 0; i < 1000; ++i)
+            {
+                CHECK(array.Get<0>(i).value == i);
+                CHECK(array.Get<1>(i) == static_cast<uint64>(i) * 3);
+            }
+        }
+        CHECK(Tracked::s_live == 0);
+    }
+
+    TEST_CASE("RemoveSwap")
+    {
+        SoaArray<int, Tracked> array;
+        for (int i = 0; i < 5; ++i)
+        {
+            array.EmplaceBack(i, Tracked(i * 10));
+        }
+
+        array.RemoveSwap(1);
+        CHECK(array.Size() == 4);
+        CHECK(array.Get<0>(1) == 4);
+        CHECK(array.Get<1>(1).value == 40);
+
+        array.RemoveSwap(3);
+        CHECK(array.Size() == 3);
+        CHECK(array.Get<0>(2) == 2);
+
+        array.PopBack();
+        array.PopBack();
+        array.PopBack();
+        CHECK(array.IsEmpty());
+        array.PopBack();
+        CHECK(array.IsEmpty());
+    }
+
+    TEST_CASE("Copy and move")
+    {
+        Tracked::s_live = 0;
+        {
+            SoaArray<Tracked, float> original;
+            original.EmplaceBack(1, 1.5f);
+            original.EmplaceBack(2, 2.5f);
+
+            SoaArray<Tracked, float> copy(original);
+            CHECK(copy.Size() == 2);
+            CHECK(copy.Get<0>(1).value == 2);
+            CHECK(copy.Get<1>(1) == 2.5f);
+            CHECK(copy.Data<0>() != original.Data<0>());
+
+            const Tracked* data = original.Data<0>();
+            SoaArray<Tracked, float> moved(rsblMove(original));
+            CHECK(moved.Data<0>() == data);
+            CHECK(original.IsEmpty());
+            CHECK(original.Data<0>() == nullptr);
+
+            copy = moved;
+            CHECK(copy.Size() == 2);
+            moved = rsblMove(copy);
+            CHECK(moved.Size() == 2);
+            CHECK(copy.IsEmpty());
+
+            // Moved-from arrays are still usable
+            original.EmplaceBack(3, 3.5f);
+            CHECK(original.Get<0>(0).value == 3);
+        }
+        CHECK(Tracked::s_live == 0);
+    }
+
+    TEST_CASE("Custom allocator")
+    {
+        HeapAllocator heap;
+        SoaArray<uint32, uint64> array(16, &heap);
+        CHECK(array.GetAllocator() == &heap);
+        CHECK(array.Capacity() >= 16);
+        array.EmplaceBack(1u, uint64(2));
+        CHECK(array.Get<1>(0) == 2);
+    }
+}
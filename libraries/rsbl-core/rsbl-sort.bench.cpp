@@ -0,0 +1,91 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// RadixSort against std::sort on 500k draw keys, with and without a draw index payload. The keys
+// are packed like a renderer would: pipeline, material, then depth, so the top bits are sparse.
+
+#include "include/rsbl-allocator.h"
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-sort.h"
+
+#include <rsbl-bench.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint64 kDrawCount = 500'000;
+
+uint64 NextRandom(uint64& state)
+{
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state ^ (state >> 29);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Bench bench("rsbl-sort", argc, argv);
+
+    DynamicArray<uint64> drawKeys;
+    DynamicArray<uint64> randomKeys;
+    uint64 state = 1;
+    for (uint64 i = 0; i < kDrawCount; ++i)
+    {
+        const uint64 pipeline = NextRandom(state) % 64;
+        const uint64 material = NextRandom(state) % 2000;
+        const uint64 depth = NextRandom(state) & 0xFFFFFF;
+        drawKeys.PushBack((pipeline << 40) | (material << 24) | depth);
+        randomKeys.PushBack(NextRandom(state));
+    }
+
+    DynamicArray<uint64> keys;
+    DynamicArray<uint32> indices;
+    keys.Resize(kDrawCount);
+    indices.Resize(kDrawCount);
+
+    // Scratch from a reused arena, like a frame allocator would hand out
+    LinearArena arena(kDrawCount * 16 + 1024);
+
+    // Re-copies the unsorted input before every sort, the copy isn't timed
+    auto copyDrawKeys = [&]() {
+        memcpy(keys.Data(), drawKeys.Data(), kDrawCount * sizeof(uint64));
+        for (uint32 i = 0; i < kDrawCount; ++i)
+        {
+            indices[i] = i;
+        }
+        arena.Reset();
+    };
+    auto copyRandomKeys = [&]() {
+        memcpy(keys.Data(), randomKeys.Data(), kDrawCount * sizeof(uint64));
+        arena.Reset();
+    };
+    const BenchConfig perKey = {.items = kDrawCount};
+
+    bench.Section("500000 draw keys");
+    bench.Run("std::sort", copyDrawKeys, [&]() {
+        std::sort(keys.begin(), keys.end());
+        DoNotOptimize(keys[0]);
+    }, perKey);
+
+    bench.Run("RadixSort", copyDrawKeys, [&]() {
+        RadixSort(keys, &arena);
+        DoNotOptimize(keys[0]);
+    }, perKey);
+
+    bench.Run("RadixSort + index payload", copyDrawKeys, [&]() {
+        RadixSort(keys, indices, &arena);
+        DoNotOptimize(indices[0]);
+    }, perKey);
+
+    bench.Section("500000 random 64-bit keys");
+    bench.Run("RadixSort", copyRandomKeys, [&]() {
+        RadixSort(keys, &arena);
+        DoNotOptimize(keys[0]);
+    }, perKey);
+
+    return bench.Finish();
+}
@@ -0,0 +1,234 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-allocator.h"
+#include "include/rsbl-dynamic-array.h"
+#include "include/rsbl-sort.h"
+
+using namespace rsbl;
+
+namespace
+{
+uint64 NextRandom(uint64& state)
+{
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state ^ (state >> 29);
+}
+
+template <typename Key>
+bool IsSorted(const DynamicArray<Key>& keys)
+{
+    for (uint64 i = 1; i < keys.Size(); ++i)
+    {
+        if (keys[i - 1] > keys[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct DrawItem
+{
+    uint32 mesh;
+    uint32 material;
+    float depth;
+};
+} // namespace
+
+TEST_SUITE("rsbl::RadixSort")
+{
+    TEST_CASE("Empty and single element")
+    {
+        DynamicArray<uint64> keys;
+        RadixSort(keys);
+        CHECK(keys.IsEmpty());
+
+        keys.PushBack(42);
+        RadixSort(keys);
+        CHECK(keys[0] == 42);
+    }
+
+    TEST_CASE("Small inputs")
+    {
+        DynamicArray<uint32> keys;
+        const uint32 values[] = {5, 3, 9, 1, 3, 0, 7};
+        for (uint32 value : values)
+        {
+            keys.PushBack(value);
+        }
+
+        RadixSort(keys);
+        CHECK(IsSorted(keys));
+        CHECK(keys[0] == 0);
+        CHECK(keys[6] == 9);
+    }
+
+    TEST_CASE("uint32 keys")
+    {
+        uint64 state = 1;
+        DynamicArray<uint32> keys;
+        uint64 sum = 0;
+        for (uint32 i = 0; i < 10000; ++i)
+        {
+            keys.PushBack(static_cast<uint32>(NextRandom(state)));
+            sum += keys[i];
+        }
+
+        RadixSort(keys);
+        CHECK(IsSorted(keys));
+
+        uint64 sortedSum = 0;
+        for (uint32 key : keys)
+        {
+            sortedSum += key;
+        }
+        CHECK(sortedSum == sum);
+    }
+
+    TEST_CASE("uint64 keys")
+    {
+        uint64 state = 7;
+        DynamicArray<uint64> keys;
+        for (uint32 i = 0; i < 10000; ++i)
+        {
+            keys.PushBack(NextRandom(state));
+        }
+
+        RadixSort(keys);
+        CHECK(IsSorted(keys));
+    }
+
+    TEST_CASE("Keys that only use a few digits")
+    {
+        // Only the second byte varies, so most passes are skipped and the result has to be
+        // copied back out of scratch
+        uint64 state = 3;
+        DynamicArray<uint64> keys;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            keys.PushBack(0xAB00000000000000ull | ((NextRandom(state) & 0xFF) << 8));
+        }
+
+        RadixSort(keys);
+        CHECK(IsSorted(keys));
+
+        // Everything equal skips every pass
+        DynamicArray<uint32> same;
+        same.Resize(500);
+        RadixSort(same);
+        CHECK(IsSorted(same));
+    }
+
+    TEST_CASE("Payloads follow their keys")
+    {
+        uint64 state = 11;
+        DynamicArray<uint64> keys;
+        DynamicArray<uint32> indices;
+        DynamicArray<uint64> original;
+        for (uint32 i = 0; i < 5000; ++i)
+        {
+            keys.PushBack(NextRandom(state) >> 20);
+            indices.PushBack(i);
+        }
+        original = keys;
+
+        RadixSort(keys, indices);
+        CHECK(IsSorted(keys));
+        for (uint64 i = 0; i < keys.Size(); ++i)
+        {
+            CHECK(original[indices[i]] == keys[i]);
+        }
+    }
+
+    TEST_CASE("Sort is stable")
+    {
+        // Lots of duplicate keys, payloads with the same key keep their order
+        uint64 state = 5;
+        DynamicArray<uint32> keys;
+        DynamicArray<uint32> order;
+        for (uint32 i = 0; i < 3000; ++i)
+        {
+            keys.PushBack(static_cast<uint32>(NextRandom(state) % 16) << 12);
+            order.PushBack(i);
+        }
+
+        RadixSort(keys, order);
+        for (uint64 i = 1; i < keys.Size(); ++i)
+        {
+            CHECK(keys[i - 1] <= keys[i]);
+            if (keys[i - 1] == keys[i])
+            {
+                CHECK(order[i - 1] < order[i]);
+            }
+        }
+
+        // Same for the insertion sort path
+        uint32 smallKeys[] = {2, 1, 2, 1, 0, 2};
+        uint32 smallOrder[] = {0, 1, 2, 3, 4, 5};
+        RadixSort(smallKeys, ArrayView<uint32>(smallOrder));
+        CHECK(smallOrder[0] == 4);
+        CHECK(smallOrder[1] == 1);
+        CHECK(smallOrder[2] == 3);
+        CHECK(smallOrder[3] == 0);
+        CHECK(smallOrder[4] == 2);
+        CHECK(smallOrder[5] == 5);
+    }
+
+    TEST_CASE("Struct payloads")
+    {
+        uint64 state = 13;
+        DynamicArray<uint64> keys;
+        DynamicArray<DrawItem> draws;
+        for (uint32 i = 0; i < 2000; ++i)
+        {
+            const uint32 material = static_cast<uint32>(NextRandom(state) % 100);
+            draws.PushBack(DrawItem{i, material, static_cast<float>(i)});
+            keys.PushBack((uint64(material) << 32) | i);
+        }
+
+        RadixSort(keys, draws);
+        for (uint64 i = 0; i < draws.Size(); ++i)
+        {
+            CHECK(draws[i].material == (keys[i] >> 32));
+            CHECK(draws[i].mesh == static_cast<uint32>(keys[i]));
+        }
+    }
+
+    TEST_CASE("Scratch comes from the given allocator")
+    {
+        struct CountingAllocator : public Allocator
+        {
+            uint32 allocations = 0;
+            uint32 frees = 0;
+
+            void* Allocate(uint64 size, uint64 alignment) override
+            {
+                allocations++;
+                return GetDefaultAllocator()->Allocate(size, alignment);
+            }
+
+            void Free(void* ptr, uint64 size, uint64 alignment) override
+            {
+                frees++;
+                GetDefaultAllocator()->Free(ptr, size, alignment);
+            }
+        };
+
+        uint64 state = 17;
+        DynamicArray<uint32> keys;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            keys.PushBack(static_cast<uint32>(NextRandom(state)));
+        }
+
+        CountingAllocator counting;
+        RadixSort(keys, &counting);
+        CHECK(IsSorted(keys));
+        CHECK(counting.allocations == 1);
+        CHECK(counting.frees == 1);
+    }
+}
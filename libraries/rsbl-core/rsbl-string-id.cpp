@@ -0,0 +1,138 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-string-id.h"
+
+#include "include/rsbl-assert.h"
+#include "include/rsbl-bits.h"
+#include "include/rsbl-hash-map.h"
+#include "include/rsbl-memory-tracking.h"
+
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+
+namespace
+{
+using rsbl::Internal::InternedString;
+
+// Interned strings are packed into big chunks that are never freed
+constexpr uint64 kChunkSize = 64 * 1024;
+
+// The hash is computed once up front, and reused for the table lookup
+struct InternKey
+{
+    rsbl::StringView text;
+    uint64 hash;
+
+    bool operator==(const InternKey& other) const
+    {
+        return hash == other.hash && text == other.text;
+    }
+};
+
+struct InternKeyHash
+{
+    uint64 operator()(const InternKey& key) const
+    {
+        return key.hash;
+    }
+};
+
+struct InternTable
+{
+    std::shared_mutex mutex;
+    rsbl::HashMap<InternKey, const InternedString*, InternKeyHash> entries{
+        rsbl::GetTaggedAllocator(rsbl::MemoryTag::Core)};
+
+    uint8* chunk = nullptr;
+    uint64 chunkUsed = kChunkSize;
+
+    // Caller holds the exclusive lock
+    InternedString* AllocateEntry(uint64 size)
+    {
+        const uint64 entry_size =
+            rsbl::AlignUp(sizeof(InternedString) + size + 1, alignof(InternedString));
+
+        // Strings too big to share a chunk get their own allocation
+        rsbl::Allocator* allocator = rsbl::GetTaggedAllocator(rsbl::MemoryTag::Core);
+        if (entry_size > kChunkSize / 4)
+        {
+            return static_cast<InternedString*>(
+                allocator->Allocate(entry_size, alignof(InternedString)));
+        }
+
+        if (chunkUsed + entry_size > kChunkSize)
+        {
+            chunk = static_cast<uint8*>(allocator->Allocate(kChunkSize, alignof(InternedString)));
+            chunkUsed = 0;
+        }
+
+        InternedString* entry = reinterpret_cast<InternedString*>(chunk + chunkUsed);
+        chunkUsed += entry_size;
+        return entry;
+    }
+};
+
+InternTable& GetInternTable()
+{
+    // Intentionally never destroyed, ids in statics must stay valid through exit
+    static InternTable* s_table = new InternTable();
+    return *s_table;
+}
+} // namespace
+
+namespace rsbl
+{
+namespace Internal
+{
+    const InternedString* InternString(StringView str)
+    {
+        if (str.IsEmpty())
+        {
+            return nullptr;
+        }
+
+        const InternKey key{str, Hash<StringView>()(str)};
+        InternTable& table = GetInternTable();
+
+        // Almost every intern is a name we've seen before, so try the shared lock first
+        {
+            std::shared_lock lock(table.mutex);
+            const InternedString* const* existing = table.entries.Find(key);
+            if (existing != nullptr)
+            {
+                return *existing;
+            }
+        }
+
+        std::unique_lock lock(table.mutex);
+        const InternedString* const* existing = table.entries.Find(key);
+        if (existing != nullptr)
+        {
+            return *existing;
+        }
+
+        InternedString* entry = table.AllocateEntry(str.Size());
+        rsblVerifyMsg(entry != nullptr, "Failed to allocate interned string");
+
+        entry->hash = key.hash;
+        entry->size = str.Size();
+        char* text = const_cast<char*>(entry->Text());
+        memcpy(text, str.Data(), str.Size());
+        text[str.Size()] = '\0';
+
+        // The key points at the interned copy, not the caller's buffer
+        table.entries.Insert(InternKey{StringView(text, str.Size()), key.hash}, entry);
+        return entry;
+    }
+} // namespace Internal
+
+uint64 GetStringIdCount()
+{
+    InternTable& table = GetInternTable();
+    std::shared_lock lock(table.mutex);
+    return table.entries.Size();
+}
+
+} // namespace rsbl
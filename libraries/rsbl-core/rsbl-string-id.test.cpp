@@ -0,0 +1,134 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-hash-map.h"
+#include "include/rsbl-string-id.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace rsbl;
+
+TEST_SUITE("rsbl::StringId")
+{
+    TEST_CASE("Same text, same id")
+    {
+        StringId a("VSMain");
+        String text("VSMain");
+        StringId b(text.View());
+
+        CHECK(a == b);
+        CHECK(a.CStr() == b.CStr());
+        CHECK(a != StringId("PSMain"));
+    }
+
+    TEST_CASE("Text and hash")
+    {
+        StringId id("scene/sponza.gltf");
+        CHECK(strcmp(id.CStr(), "scene/sponza.gltf") == 0);
+        CHECK(id.View() == "scene/sponza.gltf");
+        CHECK(id.Size() == 17);
+        CHECK(id.GetHash() == Hash<StringView>()("scene/sponza.gltf"));
+        CHECK(Hash<StringId>()(id) == id.GetHash());
+    }
+
+    TEST_CASE("Interned text doesn't depend on the source buffer")
+    {
+        char buffer[] = "transient";
+        StringId id(buffer);
+        buffer[0] = 'X';
+
+        CHECK(id.View() == "transient");
+        CHECK(id == StringId("transient"));
+    }
+
+    TEST_CASE("Empty")
+    {
+        StringId empty;
+        CHECK(empty.IsEmpty());
+        CHECK(strcmp(empty.CStr(), "") == 0);
+        CHECK(empty.Size() == 0);
+        CHECK(empty == StringId(""));
+        CHECK(empty.GetHash() == Hash<StringView>()(""));
+    }
+
+    TEST_CASE("Views don't need to be null terminated")
+    {
+        StringView path("textures/albedo.png");
+        StringId directory(path.Substring(0, 8));
+        CHECK(directory == StringId("textures"));
+        CHECK(strcmp(directory.CStr(), "textures") == 0);
+    }
+
+    TEST_CASE("Count only grows for new strings")
+    {
+        const uint64 before = GetStringIdCount();
+        StringId first("count-test-unique-string");
+        StringId second("count-test-unique-string");
+        CHECK(GetStringIdCount() == before + 1);
+        CHECK(first == second);
+    }
+
+    TEST_CASE("Large strings")
+    {
+        String big;
+        for (int i = 0; i < 40000; ++i)
+        {
+            big += static_cast<char>('a' + (i % 26));
+        }
+
+        StringId id(big.View());
+        CHECK(id.Size() == 40000);
+        CHECK(id.View() == big.View());
+        CHECK(id == StringId(big.View()));
+    }
+
+    TEST_CASE("HashMap keyed by id")
+    {
+        HashMap<StringId, int> pipelines;
+        pipelines.Insert(StringId("opaque"), 1);
+        pipelines.Insert(StringId("transparent"), 2);
+
+        REQUIRE(pipelines.Find(StringId("opaque")) != nullptr);
+        CHECK(*pipelines.Find(StringId("opaque")) == 1);
+        CHECK(*pipelines.Find(StringId("transparent")) == 2);
+        CHECK(pipelines.Find(StringId("shadow")) == nullptr);
+    }
+
+    TEST_CASE("Concurrent interning")
+    {
+        constexpr int kThreadCount = 4;
+        constexpr int kNameCount = 500;
+
+        std::vector<std::vector<StringId>> results(kThreadCount);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreadCount; ++t)
+        {
+            threads.emplace_back([t, &results]() {
+                for (int i = 0; i < kNameCount; ++i)
+                {
+                    String name("concurrent-");
+                    name += static_cast<char>('a' + (i % 26));
+                    name += static_cast<char>('a' + (i / 26));
+                    results[t].push_back(StringId(name.View()));
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (int t = 1; t < kThreadCount; ++t)
+        {
+            for (int i = 0; i < kNameCount; ++i)
+            {
+                CHECK(results[t][i] == results[0][i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,186 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-string.h"
+
+#include <cstring>
+
+namespace rsbl
+{
+
+String::String(StringView str, Allocator* allocator)
+    : m_allocator(allocator)
+{
+    Append(str);
+}
+
+String::~String()
+{
+    FreeHeapBuffer();
+}
+
+String::String(const String& other)
+    : m_allocator(other.m_allocator)
+{
+    Append(other.View());
+}
+
+String& String::operator=(const String& other)
+{
+    if (this != &other)
+    {
+        Clear();
+        Append(other.View());
+    }
+    return *this;
+}
+
+String::String(String&& other) noexcept
+    : m_allocator(other.m_allocator)
+{
+    StealFrom(other);
+}
+
+String& String::operator=(String&& other) noexcept
+{
+    if (this != &other)
+    {
+        FreeHeapBuffer();
+        m_data = m_inlineStorage;
+        m_capacity = kInlineCapacity;
+        m_allocator = other.m_allocator;
+        StealFrom(other);
+    }
+    return *this;
+}
+
+String& String::operator=(StringView str)
+{
+    // str could point into our own buffer, so build the result before releasing anything
+    if (str.Data() >= m_data && str.Data() < m_data + m_size)
+    {
+        String copy(str, m_allocator);
+        *this = rsblMove(copy);
+        return *this;
+    }
+
+    Clear();
+    return Append(str);
+}
+
+void String::Reserve(uint64 capacity)
+{
+    if (capacity > m_capacity)
+    {
+        Grow(capacity);
+    }
+}
+
+void String::Resize(uint64 size)
+{
+    Reserve(size);
+    if (size > m_size)
+    {
+        memset(m_data + m_size, 0, size - m_size);
+    }
+    m_size = size;
+    m_data[m_size] = '\0';
+}
+
+void String::Clear()
+{
+    m_size = 0;
+    m_data[0] = '\0';
+}
+
+String& String::Append(StringView str)
+{
+    if (str.IsEmpty())
+    {
+        return *this;
+    }
+
+    const uint64 new_size = m_size + str.Size();
+    if (new_size > m_capacity)
+    {
+        // Appending part of ourselves, the view dangles once we grow
+        if (str.Data() >= m_data && str.Data() < m_data + m_size)
+        {
+            const uint64 offset = static_cast<uint64>(str.Data() - m_data);
+            Grow(new_size);
+            str = StringView(m_data + offset, str.Size());
+        }
+        else
+        {
+            Grow(new_size);
+        }
+    }
+
+    memmove(m_data + m_size, str.Data(), str.Size());
+    m_size = new_size;
+    m_data[m_size] = '\0';
+    return *this;
+}
+
+String& String::Append(char c)
+{
+    if (m_size >= m_capacity)
+    {
+        Grow(m_size + 1);
+    }
+    m_data[m_size++] = c;
+    m_data[m_size] = '\0';
+    return *this;
+}
+
+void String::Grow(uint64 min_capacity)
+{
+    uint64 new_capacity = (m_capacity + 1) * 2 - 1;
+    if (new_capacity < min_capacity)
+    {
+        new_capacity = min_capacity;
+    }
+
+    // Capacities don't count the terminator, the buffers do
+    if (!IsInline())
+    {
+        m_data = static_cast<char*>(
+            m_allocator->Reallocate(m_data, m_capacity + 1, new_capacity + 1, alignof(char)));
+    }
+    else
+    {
+        char* new_data = static_cast<char*>(m_allocator->Allocate(new_capacity + 1, alignof(char)));
+        memcpy(new_data, m_data, m_size + 1);
+        m_data = new_data;
+    }
+    m_capacity = new_capacity;
+}
+
+void String::FreeHeapBuffer()
+{
+    if (!IsInline())
+    {
+        m_allocator->Free(m_data, m_capacity + 1, alignof(char));
+    }
+}
+
+void String::StealFrom(String& other)
+{
+    if (other.IsInline())
+    {
+        memcpy(m_inlineStorage, other.m_inlineStorage, other.m_size + 1);
+    }
+    else
+    {
+        m_data = other.m_data;
+        m_capacity = other.m_capacity;
+        other.m_data = other.m_inlineStorage;
+        other.m_capacity = kInlineCapacity;
+    }
+
+    m_size = other.m_size;
+    other.m_size = 0;
+    other.m_data[0] = '\0';
+}
+
+} // namespace rsbl
@@ -0,0 +1,277 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-hash-map.h"
+#include "include/rsbl-string.h"
+
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+class CountingAllocator : public Allocator
+{
+  public:
+    void* Allocate(uint64 size, uint64 alignment) override
+    {
+        allocations++;
+        return m_heap.Allocate(size, alignment);
+    }
+
+    void Free(void* ptr, uint64 size, uint64 alignment) override
+    {
+        if (ptr != nullptr)
+        {
+            frees++;
+        }
+        m_heap.Free(ptr, size, alignment);
+    }
+
+    int allocations = 0;
+    int frees = 0;
+
+  private:
+    HeapAllocator m_heap;
+};
+} // namespace
+
+TEST_SUITE("rsbl::StringView")
+{
+    TEST_CASE("Construction")
+    {
+        constexpr StringView empty;
+        static_assert(empty.IsEmpty());
+
+        constexpr StringView literal("hello");
+        static_assert(literal.Size() == 5);
+        static_assert(literal[1] == 'e');
+
+        const char buffer[] = {'a', 'b', 'c'};
+        StringView sized(buffer, 3);
+        CHECK(sized.Size() == 3);
+        CHECK(sized == "abc");
+
+        const char* null_str = nullptr;
+        CHECK(StringView(null_str).IsEmpty());
+    }
+
+    TEST_CASE("Comparison")
+    {
+        static_assert(StringView("abc") == StringView("abc"));
+        static_assert(!(StringView("abc") == StringView("abd")));
+        static_assert(!(StringView("abc") == StringView("ab")));
+        CHECK(StringView("") == StringView());
+        CHECK(StringView("abc") != "xyz");
+    }
+
+    TEST_CASE("Substring and find")
+    {
+        constexpr StringView path("shaders/mesh.vs.hlsl");
+
+        static_assert(path.Find('/') == 7);
+        static_assert(path.FindLast('.') == 15);
+        static_assert(path.Find('z') == StringView::kNotFound);
+        static_assert(path.Find('.', 13) == 15);
+
+        CHECK(path.Substring(0, 7) == "shaders");
+        CHECK(path.Substring(8) == "mesh.vs.hlsl");
+        CHECK(path.Substring(16, 100) == "hlsl");
+        CHECK(path.Substring(path.Size()).IsEmpty());
+
+        CHECK(path.StartsWith("shaders/"));
+        CHECK_FALSE(path.StartsWith("textures/"));
+        CHECK(path.EndsWith(".hlsl"));
+        CHECK_FALSE(path.EndsWith("a much longer suffix than the path itself"));
+    }
+
+    TEST_CASE("Range for")
+    {
+        int count = 0;
+        for (char c : StringView("abcd"))
+        {
+            CHECK(c == "abcd"[count]);
+            count++;
+        }
+        CHECK(count == 4);
+    }
+
+    TEST_CASE("Hash matches across view, String and HashBytes")
+    {
+        const char* text = "VSMain";
+        CHECK(Hash<StringView>()(text) == HashBytes(text, 6));
+        CHECK(Hash<String>()(String(text)) == Hash<StringView>()(text));
+        CHECK(Hash<StringView>()("VSMain") != Hash<StringView>()("PSMain"));
+    }
+}
+
+TEST_SUITE("rsbl::String")
+{
+    TEST_CASE("Default is empty and inline")
+    {
+        String str;
+        CHECK(str.IsEmpty());
+        CHECK(str.Size() == 0);
+        CHECK(str.IsInline());
+        CHECK(strcmp(str.CStr(), "") == 0);
+    }
+
+    TEST_CASE("Short strings stay inline")
+    {
+        CountingAllocator allocator;
+        {
+            String str("albedo_texture", &allocator);
+            CHECK(str.IsInline());
+            CHECK(str == "albedo_texture");
+            CHECK(strcmp(str.CStr(), "albedo_texture") == 0);
+
+            String exact("01234567890123456789012", &allocator);
+            CHECK(exact.Size() == String::kInlineCapacity);
+            CHECK(exact.IsInline());
+        }
+        CHECK(allocator.allocations == 0);
+    }
+
+    TEST_CASE("Long strings spill to the allocator")
+    {
+        CountingAllocator allocator;
+        {
+            String str("assets/models/sponza/textures/lion_diffuse.png", &allocator);
+            CHECK_FALSE(str.IsInline());
+            CHECK(str.Size() == 46);
+            CHECK(str == "assets/models/sponza/textures/lion_diffuse.png");
+            CHECK(str.CStr()[str.Size()] == '\0');
+            CHECK(allocator.allocations == 1);
+        }
+        CHECK(allocator.frees == 1);
+    }
+
+    TEST_CASE("Append grows past inline")
+    {
+        String str;
+        for (int i = 0; i < 100; ++i)
+        {
+            str += static_cast<char>('a' + (i % 26));
+        }
+        CHECK(str.Size() == 100);
+        CHECK_FALSE(str.IsInline());
+        CHECK(str[0] == 'a');
+        CHECK(str[26] == 'a');
+        CHECK(str[99] == 'v');
+        CHECK(strlen(str.CStr()) == 100);
+
+        str.Append("!").Append(StringView("??", 1));
+        CHECK(str.Size() == 102);
+        CHECK(str.View().EndsWith("!?"));
+    }
+
+    TEST_CASE("Appending part of itself")
+    {
+        String str("abc");
+        str.Append(str.View());
+        CHECK(str == "abcabc");
+
+        // Forces a grow while the source still points into the old buffer
+        for (int i = 0; i < 4; ++i)
+        {
+            str.Append(str.View());
+        }
+        CHECK(str.Size() == 96);
+        CHECK(str.View().Substring(90) == "abcabc");
+
+        str = str.View().Substring(3, 3);
+        CHECK(str == "abc");
+    }
+
+    TEST_CASE("Copy")
+    {
+        String inline_str("short");
+        String heap_str("a string that is definitely longer than the inline buffer");
+
+        String inline_copy(inline_str);
+        String heap_copy(heap_str);
+        CHECK(inline_copy == inline_str);
+        CHECK(heap_copy == heap_str);
+        CHECK(heap_copy.Data() != heap_str.Data());
+
+        inline_copy = heap_str;
+        CHECK(inline_copy == heap_str);
+        heap_copy = inline_str;
+        CHECK(heap_copy == "short");
+    }
+
+    TEST_CASE("Move steals heap buffers and copies inline ones")
+    {
+        CountingAllocator allocator;
+        {
+            String heap_str("a string that is definitely longer than the inline buffer",
+                            &allocator);
+            const char* heap_data = heap_str.Data();
+
+            String moved(rsblMove(heap_str));
+            CHECK(moved.Data() == heap_data);
+            CHECK(heap_str.IsEmpty());
+            CHECK(heap_str.IsInline());
+
+            String inline_str("short", &allocator);
+            String moved_inline(rsblMove(inline_str));
+            CHECK(moved_inline == "short");
+            CHECK(moved_inline.IsInline());
+            CHECK(inline_str.IsEmpty());
+
+            moved_inline = rsblMove(moved);
+            CHECK(moved_inline.Data() == heap_data);
+            CHECK_FALSE(moved_inline.IsInline());
+        }
+        CHECK(allocator.allocations == 1);
+        CHECK(allocator.frees == 1);
+    }
+
+    TEST_CASE("Resize, reserve and clear")
+    {
+        String str("abc");
+        str.Resize(5);
+        CHECK(str.Size() == 5);
+        CHECK(str[3] == '\0');
+        CHECK(str[4] == '\0');
+
+        str.Resize(2);
+        CHECK(str == "ab");
+
+        str.Reserve(200);
+        CHECK(str.Capacity() >= 200);
+        CHECK(str == "ab");
+
+        const uint64 capacity = str.Capacity();
+        str.Clear();
+        CHECK(str.IsEmpty());
+        CHECK(str.Capacity() == capacity);
+        CHECK(strcmp(str.CStr(), "") == 0);
+    }
+
+    TEST_CASE("Comparison with views")
+    {
+        String str("entry");
+        CHECK(str == "entry");
+        CHECK(str != "entr");
+        CHECK("entry" == str);
+        CHECK(StringView("entry") == str);
+        CHECK(str == String("entry"));
+    }
+
+    TEST_CASE("As a HashMap key")
+    {
+        HashMap<String, int> map;
+        map.Insert(String("short"), 1);
+        map.Insert(String("a key that is much too long to fit in the inline buffer"), 2);
+
+        REQUIRE(map.Find(String("short")) != nullptr);
+        CHECK(*map.Find(String("short")) == 1);
+        REQUIRE(map.Find(String("a key that is much too long to fit in the inline buffer")) !=
+                nullptr);
+        CHECK(map.Find(String("missing")) == nullptr);
+    }
+}
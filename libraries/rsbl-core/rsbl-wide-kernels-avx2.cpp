@@ -0,0 +1,33 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Built with AVX2, FMA, F16C and BMI2 enabled on x64 (see CMakeLists.txt). Nothing in here runs
+// unless the CPU reports all of them.
+
+#include "include/rsbl-simd-config.h"
+
+#if RSBL_SIMD_AVX2 && !RSBL_SIMD_AVX512
+
+    #include "rsbl-wide-kernels-impl.h"
+
+namespace rsbl::Internal
+{
+const WideKernels* GetWideKernelsAvx2()
+{
+    return &kWideKernels;
+}
+} // namespace rsbl::Internal
+
+#else
+
+    #include "rsbl-wide-kernels.h"
+
+namespace rsbl::Internal
+{
+const WideKernels* GetWideKernelsAvx2()
+{
+    return nullptr;
+}
+} // namespace rsbl::Internal
+
+#endif
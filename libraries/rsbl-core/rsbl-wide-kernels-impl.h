@@ -0,0 +1,521 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "include/rsbl-simd-wide.h"
+#include "rsbl-wide-kernels.h"
+
+#include <cstring>
+
+#if !RSBL_SIMD_F16C && !RSBL_SIMD_NEON
+    // Only the baseline x64 and scalar builds, which have no half conversion instructions
+    #include "include/rsbl-packing.h"
+#endif
+#if !RSBL_SIMD_BMI2
+    // Same for pdep
+    #include "include/rsbl-morton.h"
+#endif
+
+// Kernel bodies, included by exactly one file per instruction set. Everything is internal to the
+// including file, which exposes kWideKernels through its GetWideKernels* function.
+
+namespace rsbl
+{
+namespace
+{
+constexpr uint32 kWidth = simd::kNativeWidth;
+using Floats = simd::FloatxN<kWidth>;
+using Vec3s = simd::Vec3xN<kWidth>;
+using Masks = simd::MaskxN<kWidth>;
+
+#if RSBL_SIMD_AVX512
+constexpr SimdLevel kLevel = SimdLevel::Avx512;
+#elif RSBL_SIMD_AVX2
+constexpr SimdLevel kLevel = SimdLevel::Avx2;
+#elif RSBL_SIMD_SSE
+constexpr SimdLevel kLevel = SimdLevel::Sse2;
+#elif RSBL_SIMD_NEON
+constexpr SimdLevel kLevel = SimdLevel::Neon;
+#else
+constexpr SimdLevel kLevel = SimdLevel::Scalar;
+#endif
+
+void TransformPointsSoa(const float* matrix, const float* xs, const float* ys, const float* zs,
+                        uint64 count, float* outXs, float* outYs, float* outZs)
+{
+    const Vec3s c0(matrix[0], matrix[1], matrix[2]);
+    const Vec3s c1(matrix[3], matrix[4], matrix[5]);
+    const Vec3s c2(matrix[6], matrix[7], matrix[8]);
+    const Vec3s c3(matrix[9], matrix[10], matrix[11]);
+
+    uint64 i = 0;
+    for (; i + kWidth <= count; i += kWidth)
+    {
+        Vec3s p = simd::MultiplyAdd(c0, Floats::LoadUnaligned(xs + i), c3);
+        p = simd::MultiplyAdd(c1, Floats::LoadUnaligned(ys + i), p);
+        p = simd::MultiplyAdd(c2, Floats::LoadUnaligned(zs + i), p);
+        simd::StoreUnaligned(p, outXs + i, outYs + i, outZs + i);
+    }
+
+    for (; i < count; ++i)
+    {
+        const float x = xs[i];
+        const float y = ys[i];
+        const float z = zs[i];
+        outXs[i] = matrix[0] * x + matrix[3] * y + matrix[6] * z + matrix[9];
+        outYs[i] = matrix[1] * x + matrix[4] * y + matrix[7] * z + matrix[10];
+        outZs[i] = matrix[2] * x + matrix[5] * y + matrix[8] * z + matrix[11];
+    }
+}
+
+// Packs per-object bits into 64-bit words. Every native width divides 64, so a batch never
+// straddles two words.
+class VisibilityWriter
+{
+  public:
+    explicit VisibilityWriter(uint64* words)
+        : m_words(words)
+    {
+    }
+
+    // bits holds objects [first, first + count)
+    void Append(uint64 first, uint64 bits, uint64 count)
+    {
+        m_word |= bits << (first % 64);
+        if ((first + count) % 64 == 0)
+        {
+            m_words[first / 64] = m_word;
+            m_word = 0;
+        }
+    }
+
+    void Finish(uint64 total)
+    {
+        if (total % 64 != 0)
+        {
+            m_words[total / 64] = m_word;
+        }
+    }
+
+  private:
+    uint64* m_words;
+    uint64 m_word = 0;
+};
+
+float PlaneDistance(const float* plane, float x, float y, float z)
+{
+    return plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+}
+
+Floats PlaneDistance(const float* plane, const Vec3s& p)
+{
+    return simd::Dot(Vec3s(plane[0], plane[1], plane[2]), p) + Floats(plane[3]);
+}
+
+// Inside unless even the corner furthest along the normal is behind the plane
+Masks AabbInside(const float* plane, const Vec3s& center, const Vec3s& extents)
+{
+    const Vec3s abs_normal(fabsf(plane[0]), fabsf(plane[1]), fabsf(plane[2]));
+    return PlaneDistance(plane, center) >= -simd::Dot(abs_normal, extents);
+}
+
+void CullSpheres(const float* planes, const float* xs, const float* ys, const float* zs,
+                 const float* radii, uint64 count, uint64* visibleWords)
+{
+    VisibilityWriter writer(visibleWords);
+
+    uint64 i = 0;
+    for (; i + kWidth <= count; i += kWidth)
+    {
+        const Vec3s center = Vec3s::LoadUnaligned(xs + i, ys + i, zs + i);
+        const Floats neg_radius = -Floats::LoadUnaligned(radii + i);
+
+        Masks visible = PlaneDistance(planes, center) >= neg_radius;
+        for (uint32 p = 1; p < 6; ++p)
+        {
+            visible = visible & (PlaneDistance(planes + p * 4, center) >= neg_radius);
+        }
+        writer.Append(i, simd::ToBits(visible), kWidth);
+    }
+
+    for (; i < count; ++i)
+    {
+        bool visible = true;
+        for (uint32 p = 0; p < 6; ++p)
+        {
+            visible &= PlaneDistance(planes + p * 4, xs[i], ys[i], zs[i]) >= -radii[i];
+        }
+        writer.Append(i, visible ? 1 : 0, 1);
+    }
+    writer.Finish(count);
+}
+
+void CullAabbs(const float* planes, const float* xs, const float* ys, const float* zs,
+               const float* extentXs, const float* extentYs, const float* extentZs,
+               uint64 count, uint64* visibleWords)
+{
+    VisibilityWriter writer(visibleWords);
+
+    uint64 i = 0;
+    for (; i + kWidth <= count; i += kWidth)
+    {
+        const Vec3s center = Vec3s::LoadUnaligned(xs + i, ys + i, zs + i);
+        const Vec3s extents = Vec3s::LoadUnaligned(extentXs + i, extentYs + i, extentZs + i);
+
+        Masks visible = AabbInside(planes, center, extents);
+        for (uint32 p = 1; p < 6; ++p)
+        {
+            visible = visible & AabbInside(planes + p * 4, center, extents);
+        }
+        writer.Append(i, simd::ToBits(visible), kWidth);
+    }
+
+    for (; i < count; ++i)
+    {
+        bool visible = true;
+        for (uint32 p = 0; p < 6; ++p)
+        {
+            const float* plane = planes + p * 4;
+            const float reach = fabsf(plane[0]) * extentXs[i] + fabsf(plane[1]) * extentYs[i] +
+                                fabsf(plane[2]) * extentZs[i];
+            visible &= PlaneDistance(plane, xs[i], ys[i], zs[i]) >= -reach;
+        }
+        writer.Append(i, visible ? 1 : 0, 1);
+    }
+    writer.Finish(count);
+}
+
+// Half conversion goes through its own instructions, so it has its own block size
+#if RSBL_SIMD_AVX512
+constexpr uint32 kHalfBlock = 16;
+
+void FloatsToHalvesBlock(const float* src, uint16* dst)
+{
+    const __m256i halves = _mm512_cvtps_ph(_mm512_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), halves);
+}
+
+void HalvesToFloatsBlock(const uint16* src, float* dst)
+{
+    const __m256i halves = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    _mm512_storeu_ps(dst, _mm512_cvtph_ps(halves));
+}
+#elif RSBL_SIMD_F16C
+constexpr uint32 kHalfBlock = 8;
+
+void FloatsToHalvesBlock(const float* src, uint16* dst)
+{
+    const __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), halves);
+}
+
+void HalvesToFloatsBlock(const uint16* src, float* dst)
+{
+    const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    _mm256_storeu_ps(dst, _mm256_cvtph_ps(halves));
+}
+#elif RSBL_SIMD_NEON
+constexpr uint32 kHalfBlock = 4;
+
+void FloatsToHalvesBlock(const float* src, uint16* dst)
+{
+    vst1_u16(dst, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src))));
+}
+
+void HalvesToFloatsBlock(const uint16* src, float* dst)
+{
+    vst1q_f32(dst, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src))));
+}
+#else
+constexpr uint32 kHalfBlock = 1;
+
+void FloatsToHalvesBlock(const float* src, uint16* dst)
+{
+    *dst = FloatToHalf(*src);
+}
+
+void HalvesToFloatsBlock(const uint16* src, float* dst)
+{
+    *dst = HalfToFloat(*src);
+}
+#endif
+
+void FloatsToHalves(const float* src, uint64 count, uint16* dst)
+{
+    uint64 i = 0;
+    for (; i + kHalfBlock <= count; i += kHalfBlock)
+    {
+        FloatsToHalvesBlock(src + i, dst + i);
+    }
+
+    // The rest goes through a padded block, so the tail rounds exactly like the body
+    if (i < count)
+    {
+        float in[kHalfBlock] = {};
+        uint16 out[kHalfBlock];
+        for (uint64 j = i; j < count; ++j)
+        {
+            in[j - i] = src[j];
+        }
+        FloatsToHalvesBlock(in, out);
+        for (uint64 j = i; j < count; ++j)
+        {
+            dst[j] = out[j - i];
+        }
+    }
+}
+
+void HalvesToFloats(const uint16* src, uint64 count, float* dst)
+{
+    uint64 i = 0;
+    for (; i + kHalfBlock <= count; i += kHalfBlock)
+    {
+        HalvesToFloatsBlock(src + i, dst + i);
+    }
+
+    if (i < count)
+    {
+        uint16 in[kHalfBlock] = {};
+        float out[kHalfBlock];
+        for (uint64 j = i; j < count; ++j)
+        {
+            in[j - i] = src[j];
+        }
+        HalvesToFloatsBlock(in, out);
+        for (uint64 j = i; j < count; ++j)
+        {
+            dst[j] = out[j - i];
+        }
+    }
+}
+
+// kWidth 16 bit codes, widened to floats
+#if RSBL_SIMD_AVX512
+Floats LoadCodes(const uint16* src)
+{
+    const __m256i codes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    return Floats(_mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(codes)));
+}
+#elif RSBL_SIMD_AVX2
+Floats LoadCodes(const uint16* src)
+{
+    const __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    return Floats(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(codes)));
+}
+#elif RSBL_SIMD_SSE
+Floats LoadCodes(const uint16* src)
+{
+    const __m128i codes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+    return Floats(_mm_cvtepi32_ps(_mm_unpacklo_epi16(codes, _mm_setzero_si128())));
+}
+#elif RSBL_SIMD_NEON
+Floats LoadCodes(const uint16* src)
+{
+    return Floats(vcvtq_f32_u32(vmovl_u16(vld1_u16(src))));
+}
+#else
+Floats LoadCodes(const uint16* src)
+{
+    Floats result;
+    for (uint32 i = 0; i < kWidth; ++i)
+    {
+        result.lanes[i] = static_cast<float>(src[i]);
+    }
+    return result;
+}
+#endif
+
+void LerpDequantize16(const uint16* a, const uint16* b, float t, const float* offsets,
+                      const float* scales, uint64 count, float* dst)
+{
+    const Floats weight(t);
+
+    uint64 i = 0;
+    for (; i + kWidth <= count; i += kWidth)
+    {
+        const Floats from = LoadCodes(a + i);
+        const Floats code = simd::MultiplyAdd(LoadCodes(b + i) - from, weight, from);
+        const Floats value = simd::MultiplyAdd(code, Floats::LoadUnaligned(scales + i),
+                                               Floats::LoadUnaligned(offsets + i));
+        simd::StoreUnaligned(value, dst + i);
+    }
+
+    for (; i < count; ++i)
+    {
+        const float from = static_cast<float>(a[i]);
+        const float code = from + (static_cast<float>(b[i]) - from) * t;
+        dst[i] = offsets[i] + code * scales[i];
+    }
+}
+
+#if RSBL_SIMD_BMI2
+constexpr uint64 kMortonMask2 = 0x5555555555555555ull;
+constexpr uint64 kMortonMask3 = 0x1249249249249249ull;
+
+void MortonEncode2(const uint32* points, uint64 count, uint64* codes)
+{
+    for (uint64 i = 0; i < count; ++i)
+    {
+        codes[i] = _pdep_u64(points[i * 2], kMortonMask2) |
+                   _pdep_u64(points[i * 2 + 1], kMortonMask2 << 1);
+    }
+}
+
+void MortonEncode3(const uint32* points, uint64 count, uint64* codes)
+{
+    for (uint64 i = 0; i < count; ++i)
+    {
+        codes[i] = _pdep_u64(points[i * 3], kMortonMask3) |
+                   _pdep_u64(points[i * 3 + 1], kMortonMask3 << 1) |
+                   _pdep_u64(points[i * 3 + 2], kMortonMask3 << 2);
+    }
+}
+#else
+void MortonEncode2(const uint32* points, uint64 count, uint64* codes)
+{
+    for (uint64 i = 0; i < count; ++i)
+    {
+        codes[i] = Internal::SpreadBits2(points[i * 2]) |
+                   (Internal::SpreadBits2(points[i * 2 + 1]) << 1);
+    }
+}
+
+void MortonEncode3(const uint32* points, uint64 count, uint64* codes)
+{
+    for (uint64 i = 0; i < count; ++i)
+    {
+        codes[i] = Internal::SpreadBits3(points[i * 3]) |
+                   (Internal::SpreadBits3(points[i * 3 + 1]) << 1) |
+                   (Internal::SpreadBits3(points[i * 3 + 2]) << 2);
+    }
+}
+#endif
+
+// Lane i of a stripe adds data[i ^ 1] and the product of the two halves of data[i] ^ keys[i].
+// Each step is a 32x32 -> 64 bit multiply per lane, which every instruction set here has.
+#if RSBL_SIMD_AVX512
+void HashStripes(uint64* accumulators, const uint8* data, uint64 stripeCount, const uint64* keys)
+{
+    __m512i acc = _mm512_loadu_si512(accumulators);
+    for (uint64 s = 0; s < stripeCount; ++s)
+    {
+        const __m512i input = _mm512_loadu_si512(data + s * 64);
+        const __m512i mixed = _mm512_xor_si512(input, _mm512_loadu_si512(keys + s));
+        const __m512i product =
+            _mm512_mul_epu32(mixed, _mm512_shuffle_epi32(mixed, _MM_PERM_CDAB));
+        const __m512i swapped = _mm512_shuffle_epi32(input, _MM_PERM_BADC);
+        acc = _mm512_add_epi64(acc, _mm512_add_epi64(product, swapped));
+    }
+    _mm512_storeu_si512(accumulators, acc);
+}
+#elif RSBL_SIMD_AVX2
+void HashStripes(uint64* accumulators, const uint8* data, uint64 stripeCount, const uint64* keys)
+{
+    __m256i acc[2];
+    for (uint32 j = 0; j < 2; ++j)
+    {
+        acc[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulators + j * 4));
+    }
+    for (uint64 s = 0; s < stripeCount; ++s)
+    {
+        for (uint32 j = 0; j < 2; ++j)
+        {
+            const __m256i input =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + s * 64 + j * 32));
+            const __m256i key =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + s + j * 4));
+            const __m256i mixed = _mm256_xor_si256(input, key);
+            const __m256i product = _mm256_mul_epu32(
+                mixed, _mm256_shuffle_epi32(mixed, _MM_SHUFFLE(2, 3, 0, 1)));
+            const __m256i swapped = _mm256_shuffle_epi32(input, _MM_SHUFFLE(1, 0, 3, 2));
+            acc[j] = _mm256_add_epi64(acc[j], _mm256_add_epi64(product, swapped));
+        }
+    }
+    for (uint32 j = 0; j < 2; ++j)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulators + j * 4), acc[j]);
+    }
+}
+#elif RSBL_SIMD_SSE
+void HashStripes(uint64* accumulators, const uint8* data, uint64 stripeCount, const uint64* keys)
+{
+    __m128i acc[4];
+    for (uint32 j = 0; j < 4; ++j)
+    {
+        acc[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulators + j * 2));
+    }
+    for (uint64 s = 0; s < stripeCount; ++s)
+    {
+        for (uint32 j = 0; j < 4; ++j)
+        {
+            const __m128i input =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + s * 64 + j * 16));
+            const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + s + j * 2));
+            const __m128i mixed = _mm_xor_si128(input, key);
+            const __m128i product =
+                _mm_mul_epu32(mixed, _mm_shuffle_epi32(mixed, _MM_SHUFFLE(2, 3, 0, 1)));
+            const __m128i swapped = _mm_shuffle_epi32(input, _MM_SHUFFLE(1, 0, 3, 2));
+            acc[j] = _mm_add_epi64(acc[j], _mm_add_epi64(product, swapped));
+        }
+    }
+    for (uint32 j = 0; j < 4; ++j)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(accumulators + j * 2), acc[j]);
+    }
+}
+#elif RSBL_SIMD_NEON
+void HashStripes(uint64* accumulators, const uint8* data, uint64 stripeCount, const uint64* keys)
+{
+    uint64x2_t acc[4];
+    for (uint32 j = 0; j < 4; ++j)
+    {
+        acc[j] = vld1q_u64(accumulators + j * 2);
+    }
+    for (uint64 s = 0; s < stripeCount; ++s)
+    {
+        for (uint32 j = 0; j < 4; ++j)
+        {
+            const uint64x2_t input = vreinterpretq_u64_u8(vld1q_u8(data + s * 64 + j * 16));
+            const uint64x2_t mixed = veorq_u64(input, vld1q_u64(keys + s + j * 2));
+            const uint64x2_t product = vmull_u32(vmovn_u64(mixed), vshrn_n_u64(mixed, 32));
+            const uint64x2_t swapped = vextq_u64(input, input, 1);
+            acc[j] = vaddq_u64(acc[j], vaddq_u64(product, swapped));
+        }
+    }
+    for (uint32 j = 0; j < 4; ++j)
+    {
+        vst1q_u64(accumulators + j * 2, acc[j]);
+    }
+}
+#else
+void HashStripes(uint64* accumulators, const uint8* data, uint64 stripeCount, const uint64* keys)
+{
+    for (uint64 s = 0; s < stripeCount; ++s)
+    {
+        uint64 input[8];
+        memcpy(input, data + s * 64, sizeof(input));
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            const uint64 mixed = input[i] ^ keys[s + i];
+            accumulators[i] += input[i ^ 1] + (mixed & 0xffffffffull) * (mixed >> 32);
+        }
+    }
+}
+#endif
+
+constexpr Internal::WideKernels kWideKernels = {
+    kLevel,
+    kWidth,
+    &TransformPointsSoa,
+    &CullSpheres,
+    &CullAabbs,
+    &FloatsToHalves,
+    &HalvesToFloats,
+    &LerpDequantize16,
+    &MortonEncode2,
+    &MortonEncode3,
+    &HashStripes,
+};
+} // namespace
+} // namespace rsbl
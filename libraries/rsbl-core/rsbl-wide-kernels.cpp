@@ -0,0 +1,49 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-wide-kernels-impl.h"
+
+namespace rsbl::Internal
+{
+
+namespace
+{
+const WideKernels* PickWideKernels()
+{
+    return SelectSimdVariant<const WideKernels*>({
+        {SimdLevel::Avx512, GetWideKernelsAvx512()},
+        {SimdLevel::Avx2, GetWideKernelsAvx2()},
+        {kWideKernels.level, &kWideKernels},
+    });
+}
+} // namespace
+
+const WideKernels* GetWideKernelsBaseline()
+{
+    return &kWideKernels;
+}
+
+const WideKernels* GetWideKernels(SimdLevel level)
+{
+    const WideKernels* candidates[] = {
+        GetWideKernelsAvx512(),
+        GetWideKernelsAvx2(),
+        GetWideKernelsBaseline(),
+    };
+    for (const WideKernels* kernels : candidates)
+    {
+        if (kernels != nullptr && kernels->level == level)
+        {
+            return IsSimdLevelSupported(level) ? kernels : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+const WideKernels& GetWideKernels()
+{
+    static const WideKernels* s_kernels = PickWideKernels();
+    return *s_kernels;
+}
+
+} // namespace rsbl::Internal
@@ -0,0 +1,66 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "include/rsbl-cpu.h"
+#include "include/rsbl-int-types.h"
+
+// Kernels written once against simd::FloatxN (rsbl-wide-kernels-impl.h) and built once per
+// instruction set: rsbl-wide-kernels.cpp for the baseline, plus files compiled with AVX2 and
+// AVX-512 flags on x64. Each build fills in a table, and the public functions call through the
+// widest table the CPU can run. Only plain types cross this interface, since the simd types differ
+// between the builds.
+
+namespace rsbl::Internal
+{
+
+struct WideKernels
+{
+    SimdLevel level;
+    uint32 width;
+
+    // matrix is the upper 3x4 of a column-major float4x4: 4 columns of xyz, 12 floats.
+    // Outputs may alias the inputs.
+    void (*transformPointsSoa)(const float* matrix, const float* xs, const float* ys,
+                               const float* zs, uint64 count, float* outXs, float* outYs,
+                               float* outZs);
+
+    // planes is 6 x (normal xyz, distance) with inward normals. Bit i of visibleWords is set when
+    // object i is on the inside of every plane. Whole words are written, so the bits past count
+    // in the last word come out clear.
+    void (*cullSpheres)(const float* planes, const float* xs, const float* ys, const float* zs,
+                        const float* radii, uint64 count, uint64* visibleWords);
+    void (*cullAabbs)(const float* planes, const float* xs, const float* ys, const float* zs,
+                      const float* extentXs, const float* extentYs, const float* extentZs,
+                      uint64 count, uint64* visibleWords);
+
+    // Round to nearest even, same results as FloatToHalf and HalfToFloat (rsbl-packing.h)
+    void (*floatsToHalves)(const float* src, uint64 count, uint16* dst);
+    void (*halvesToFloats)(const uint16* src, uint64 count, float* dst);
+    // dst[i] = offsets[i] + scales[i] * (a[i] + t * (b[i] - a[i])), with a and b taken as
+    // integers. Decodes quantized keyframes, as LerpDequantize16 (rsbl-packing.h).
+    void (*lerpDequantize16)(const uint16* a, const uint16* b, float t, const float* offsets,
+                             const float* scales, uint64 count, float* dst);
+
+    // points is count (x, y) or (x, y, z) tuples, same codes as MortonEncode2/3 (rsbl-morton.h)
+    void (*mortonEncode2)(const uint32* points, uint64 count, uint64* codes);
+    void (*mortonEncode3)(const uint32* points, uint64 count, uint64* codes);
+    // Bulk loop of HashBytes (rsbl-hash.cpp): folds stripeCount 64 byte stripes of data into 8
+    // accumulators, stripe s mixed with keys[s] to keys[s + 7]. Same results at every level.
+    void (*hashStripes)(uint64* accumulators, const uint8* data, uint64 stripeCount,
+                        const uint64* keys);
+};
+
+// The baseline is always built, the others are null when their instruction set isn't compiled in
+const WideKernels* GetWideKernelsBaseline();
+const WideKernels* GetWideKernelsAvx2();
+const WideKernels* GetWideKernelsAvx512();
+
+// Kernels for exactly this level, null if they weren't built or the CPU can't run them
+const WideKernels* GetWideKernels(SimdLevel level);
+
+// Widest kernels the CPU can run, picked on first use
+const WideKernels& GetWideKernels();
+
+} // namespace rsbl::Internal
@@ -3,13 +3,19 @@
 
 #pragma once
 
+#include <rsbl-array-view.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-function.h>
 #include <rsbl-result.h>
 
-// TODO: check for async compute during device creation?
-
 namespace rsbl
 {
 
+struct gaGpuProfiler;
+struct gaDeferredDestroys;
+struct gaStateTracker;
+enum class gaFormat;
+
 enum class gaBackend
 {
     Null,   // No-op implementation for API validation
@@ -17,12 +23,77 @@ enum class gaBackend
     Vulkan, // Vulkan
 };
 
+// Which GPU a device is made on when there are several, like a laptop's integrated and discrete
+enum class gaPowerPreference : uint8
+{
+    HighPerformance, // Discrete GPUs first
+    MinimumPower,    // Integrated GPUs first
+    Count,
+};
+
+enum class gaAdapterType : uint8
+{
+    Other,
+    Discrete,
+    Integrated,
+    Virtual,
+};
+
+// An adapter the backend can make devices on. Dedicated memory is the device local heaps' size on
+// Vulkan, which for an integrated GPU is system memory.
+// The null backend runs nothing, it only checks API usage. Count also adds up what was submitted
+// (GaGetNullStats), Record keeps each list's commands as well (GaGetNullCommands), and Discard
+// does neither, so the time spent is the engine's own submission path and nothing else's.
+enum class gaNullMode : uint8
+{
+    Count,
+    Record,
+    Discard,
+};
+
+struct gaAdapterInfo
+{
+    char name[128] = {};
+    gaAdapterType type = gaAdapterType::Other;
+    uint64 dedicatedMemory = 0;
+    bool bindless = false;
+    // Which adapter it is, across enumerations: the LUID on DX12, the device UUID on Vulkan
+    uint8 id[16] = {};
+};
+
 struct gaDeviceCreateInfo
 {
     gaBackend backend = gaBackend::Null;
     bool enableValidation = false; // Enable debug/validation layers
     const char* appName = "rsbl Application";
     uint32 appVersion = 1;
+
+    // Turn on DRED's automatic breadcrumbs and page fault reports on DX12, see
+    // GaReportDeviceLost. They cost a few percent, far from the validation layers' slowdown.
+    bool enableDeviceLostReports = false;
+
+    // Command lists that can be recording at the same time, see GaBeginCommandList. Each recorder
+    // has its own command allocator (command pool on Vulkan) per queue per frame in flight, made
+    // the first time the recorder records for the queue.
+    uint32 commandRecorders = 1;
+
+    // Frames the CPU can record ahead of the GPU, 1 to 4. GaBeginFrame waits beyond that. Usually
+    // the swapchain's bufferCount: fewer leaves back buffers idle, more only waits in present.
+    uint32 framesInFlight = 2;
+
+    // The adapter the device is made on, out of those that can run the backend: the first whose
+    // name contains preferredAdapter, ignoring case, if any does. Otherwise the best by type for
+    // powerPreference, then by bindless support, then by dedicated memory. Ties go to the order
+    // the platform lists them in, which on DXGI is its own order for powerPreference.
+    const char* preferredAdapter = nullptr;
+    gaPowerPreference powerPreference = gaPowerPreference::HighPerformance;
+
+    // One of GaEnumerateAdapters' adapters to make the device on, instead of picking one. NotFound
+    // once it's gone, like a GPU that was removed.
+    const gaAdapterInfo* adapter = nullptr;
+
+    // What a Null device does with the commands recorded into it, see gaNullMode
+    gaNullMode nullMode = gaNullMode::Count;
 };
 
 struct gaDevice
@@ -30,31 +101,2316 @@ struct gaDevice
     gaBackend backend;
     void* internalHandle; // Backend-specific device handle
 
+    // The compute and copy queues are queues of their own rather than the graphics queue again.
+    // Always on DX12; Vulkan needs queue families without graphics.
+    bool asyncCompute = false;
+    bool dedicatedCopy = false;
+
+    // Bindless heaps can be created: resource binding tier 2 and shader model 6.6 on DX12,
+    // descriptor indexing with update-after-bind on Vulkan
+    bool bindless = false;
+
+    // GaCmdDrawIndexedIndirect can draw more than one draw at once and take its count from a
+    // buffer. Always on DX12; Vulkan needs multiDrawIndirect and drawIndirectCount.
+    bool drawIndirectCount = false;
+
+    // Graphics pipelines can take amplification and mesh shaders, drawn with GaCmdDispatchMesh.
+    // Mesh shader tier 1 on DX12; VK_EXT_mesh_shader with task shaders on Vulkan.
+    bool meshShaders = false;
+
+    // Reserved resources can be created: tiled resources tier 2 on DX12, sparse residency for
+    // buffers and 2D images with the standard block shapes on Vulkan, bound on the graphics queue
+    bool reservedResources = false;
+
+    // Breadcrumbs are written once the work before them has finished: always on DX12,
+    // VK_AMD_buffer_marker on Vulkan
+    bool bufferMarkers = false;
+
+    // GaCmdSetShadingRate can coarsen shading per draw and through a rate image: VRS tier 2 on
+    // DX12, VK_KHR_fragment_shading_rate with pipeline and attachment rates on Vulkan. Rates up
+    // to 2x2 always, 2x4, 4x2 and 4x4 with largeShadingRates. A rate image texel covers
+    // shadingRateTileSize pixels a side, the texel size to attach it with on Vulkan.
+    bool variableRateShading = false;
+    bool largeShadingRates = false;
+    uint32 shadingRateTileSize = 0;
+
+    // The adapter the device is on
+    gaAdapterInfo adapterInfo;
+
+    // As created
+    uint32 commandRecorders = 0;
+    uint32 framesInFlight = 0;
+
+    // Frames begun so far, GaBeginFrame counts them
+    uint64 frame = 0;
+
+    // The profiler GA_GPU_ZONE times into, while one made for the device is around
+    gaGpuProfiler* gpuProfiler = nullptr;
+
+    // What GaDeferDestroy holds on to, made along with the device
+    gaDeferredDestroys* deferredDestroys = nullptr;
+
     virtual ~gaDevice() = default;
 };
 
+// How presents reach the display. A mode the platform doesn't have falls back to the next one up
+// that it does, ending at Vsync, which is always there; gaSwapchain::presentMode says which.
+enum class gaPresentMode : uint8
+{
+    Vsync,     // Presents queue up and show one per refresh (FIFO)
+    Mailbox,   // No tearing, but a newer present replaces one still waiting for the refresh
+    Immediate, // Shown as soon as it's done, tearing. DXGI's allow tearing.
+    // For variable refresh rate displays, which refresh when a present arrives so nothing tears
+    // in their range. Tearing presents on DXGI, which VRR needs in a window; FIFO on Vulkan,
+    // where the driver turns VRR on.
+    Vrr,
+    Count,
+};
+
 struct gaSwapchainCreateInfo
 {
     gaDevice* device;
-    void* appHandle;    // Platform-specific application handle (HINSTANCE on Windows)
-    void* windowHandle; // Platform-specific window handle (HWND on Windows)
-    uint32 width;       // Window client width
-    uint32 height;      // Window client height
+    // Platform-specific, as rsbl::WindowNativeData has them: HINSTANCE and HWND on Windows, the
+    // X11 Display* and Window (an XID) on Linux
+    void* appHandle;
+    void* windowHandle;
+    // Of the back buffers, usually the window's client size. Smaller renders at a lower
+    // resolution: DXGI stretches the buffers over the window when they're presented. Vulkan's
+    // surfaces are the window's size, and the buffers are created at it whatever's asked for.
+    uint32 width;
+    uint32 height;
     uint32 bufferCount = 2; // Number of swapchain buffers (typically 2-4)
+    gaPresentMode presentMode = gaPresentMode::Vsync;
+    // Presents queued ahead of the display before GaWaitForSwapchain blocks, 1 to bufferCount.
+    // Each one queued is a frame more between sampling input and it showing up on screen.
+    uint32 maxFrameLatency = 1;
+    // No window: the back buffers are render targets of the swapchain's own, R8G8B8A8Unorm on
+    // every backend, which nothing displays. For render farms and CI, with no desktop session or
+    // compositor to present to. The handles are ignored, and so are presentMode and
+    // maxFrameLatency: a present moves on to the next buffer straight away, and the frame loop
+    // runs as fast as the GPU does, held back only by GaBeginFrame's frames in flight. Read the
+    // frames back with GaReadbackAsync before presenting them.
+    bool offscreen = false;
 };
 
 struct gaSwapchain
 {
     gaBackend backend;
     void* internalHandle; // Backend-specific swapchain handle
+    gaPresentMode presentMode; // What it got, see gaPresentMode
+    uint32 currentBuffer;      // The back buffer the frame renders to, until the next present
+    // currentBuffer's ID3D12Resource* or VkImage, as in gaBarrier. Vulkan only knows which it is
+    // once GaWaitForSwapchain has acquired it. Null on the null backend.
+    void* backBuffer;
+
+    // Of the back buffers
+    uint32 width = 0;
+    uint32 height = 0;
+    // The back buffers', R8G8B8A8Unorm on DX12 and offscreen, whatever the surface has on Vulkan
+    gaFormat format{};
+    // Asked for by GaResizeSwapchain, the next GaWaitForSwapchain recreates the buffers at it
+    uint32 resizeWidth = 0;
+    uint32 resizeHeight = 0;
+
+    // GaPresent calls so far, which number the presents from 1
+    uint64 presentCount = 0;
+
+    // The last present found nothing of the window showing, minimized or behind the lock
+    // screen, so a frame loop can render at a trickle until it shows again, which the next
+    // present finds out. Only DXGI says; Vulkan and null swapchains never are.
+    bool occluded = false;
+
+    // Made with gaSwapchainCreateInfo::offscreen, presentMode is Immediate
+    bool offscreen = false;
 
     virtual ~gaSwapchain() = default;
 };
 
-Result<gaDevice*> GaCreateDevice(const gaDeviceCreateInfo& createInfo);
-void GaDestroyDevice(gaDevice* device);
+// How presents get to the screen
+enum class gaPresentPath : uint8
+{
+    Unknown, // The backend doesn't say (Vulkan, null), or there's been nothing shown yet
+    // Drawn into the desktop by the compositor, which shows them a refresh later than need be
+    Composed,
+    // Flipped to the screen directly: a fullscreen window, borderless or exclusive, with nothing
+    // over it
+    IndependentFlip,
+    // Scanned out from a hardware overlay plane over the desktop, as direct as independent flip
+    Overlay,
+};
 
-Result<gaSwapchain*> GaCreateSwapchain(const gaSwapchainCreateInfo& createInfo);
-void GaDestroySwapchain(gaSwapchain* swapchain);
+// How far the display has got through a swapchain's presents
+struct gaPresentStats
+{
+    uint64 presentCount = 0;     // As gaSwapchain::presentCount
+    uint64 displayedPresent = 0; // The latest present shown, 0 before any
+    // When it was shown, on Clock::NowTicks's clock
+    uint64 displayedTicks = 0;
+    // displayedTicks is the refresh it was shown at, rather than when that was found out
+    bool exact = false;
+    // How the latest present shown got there. DXGI switches paths as windows come and go over
+    // the swapchain's, a frame loop that cares checks it every so often.
+    gaPresentPath path = gaPresentPath::Unknown;
+};
+
+// Command lists. Recording is spread over threads by recorders: each recorder has a command
+// allocator (command pool) per queue per frame in flight, which only ever records one list at a
+// time, so any number of threads record at once without sharing one. A job recording part of a
+// pass takes a recorder of its own (the index of its chunk, say), records a list or several one
+// after the other on it, and hands them to the thread that submits.
+//
+//     GaBeginFrame(device);
+//     ... on each of N jobs, recorder = the job's index ...
+//     gaCommandList* list = GaBeginCommandList(device, gaQueueType::Graphics, recorder).Value();
+//     ... record through list->internalHandle ...
+//     GaEndCommandList(list);
+//     ... once they're all done, in the order the GPU should run them ...
+//     GaSubmit(device, gaQueueType::Graphics, lists);
+//
+// Lists belong to the frame they're begun in. Its allocators are reset, and its lists recycled,
+// once the GPU is done with it, by the GaBeginFrame framesInFlight frames later.
+
+// Compute and copy work submitted to queues of their own runs alongside graphics work, on
+// hardware with separate engines for it. Each queue runs its submits in order; work on one queue
+// that needs another's waits on a fence the other signals (GaQueueWaitForFence).
+enum class gaQueueType
+{
+    Graphics, // Anything
+    Compute,  // Dispatches and copies
+    Copy,     // Copies
+    Count,
+};
+
+struct gaCommandList
+{
+    gaBackend backend;
+    void* internalHandle; // ID3D12GraphicsCommandList* or VkCommandBuffer
+    gaDevice* device;
+    gaQueueType queue;
+    uint32 recorder;
+    uint64 frame;   // The gaDevice::frame it was begun in
+    bool recording; // Between GaBeginCommandList and GaEndCommandList
+    bool submitted;
+    bool bundle; // Records into a gaCommandBundle, see GaBeginCommandBundle
+    // Has barriers GaUse queued for the list's next draw, copy or end, null when none are
+    gaStateTracker* stateTracker = nullptr;
+
+    virtual ~gaCommandList() = default;
+};
+
+// Fences. A fence is a counter the GPU moves forward as it works through a queue: GaSignalFence
+// sets it to a value once everything submitted to the queue before it is done, and the CPU reads
+// or waits for the value it has reached. An ID3D12Fence on DX12, a timeline VkSemaphore on Vulkan.
+// Frame pacing runs on the device's own, one per queue, GaBeginFrame waits on them.
+
+struct gaFence
+{
+    gaBackend backend;
+    void* internalHandle; // ID3D12Fence* or VkSemaphore
+    uint64 signalledValue; // The last value given to GaSignalFence
+    // The same fence opened on another device, see gaSharedBuffer. Signalling either signals both.
+    gaFence* shared = nullptr;
+
+    virtual ~gaFence() = default;
+};
+
+Result<gaFence*> GaCreateFence(gaDevice* device, uint64 initialValue = 0);
+void GaDestroyFence(gaFence* fence);
+
+// value must be above every value signalled before
+Result<> GaSignalFence(gaDevice* device, gaQueueType queue, gaFence* fence, uint64 value);
+
+// Makes the queue wait, on the GPU, for the fence to reach value before running what's submitted
+// to it next. value must have been signalled already.
+Result<> GaQueueWaitForFence(gaDevice* device, gaQueueType queue, gaFence* fence, uint64 value);
+
+// The value the GPU has reached
+uint64 GaGetFenceValue(gaFence* fence);
+
+// Blocks until the GPU has reached value
+Result<> GaWaitForFence(gaFence* fence, uint64 value);
+
+// Copies between buffers (ID3D12Resource* or VkBuffer), in CopySource and CopyDest. Buffers in
+// Common promote to those on DX12 by themselves.
+Result<> GaCmdCopyBuffer(gaCommandList* list,
+                         void* destination,
+                         uint64 destinationOffset,
+                         void* source,
+                         uint64 sourceOffset,
+                         uint64 size);
+
+// Work split across GPUs, with a device per adapter. A shared buffer is memory two devices both
+// reach, with a resource on each, and a fence both can signal and wait on. It's in system memory
+// (the OS places cross-adapter heaps there), so it's for copies across, not for rendering from:
+// one device copies its results in and signals, the other waits and copies them out.
+//
+//     GaCmdCopyBuffer(listA, shared->resource, 0, result, 0, size);
+//     GaSubmit(deviceA, gaQueueType::Copy, listsA);
+//     GaSignalFence(deviceA, gaQueueType::Copy, shared->fence, ++value);
+//     GaQueueWaitForFence(deviceB, gaQueueType::Graphics, shared->peerFence, value);
+//     GaCmdCopyBuffer(listB, input, 0, shared->peerResource, 0, size);
+//
+// Cross-adapter heaps and fences on DX12. Vulkan has no way to share memory between devices of
+// different drivers, so it fails with NotFound there. The buffers are in Common, which copies
+// promote from and decay back to.
+
+struct gaSharedBufferCreateInfo
+{
+    gaDevice* device; // Makes the memory
+    gaDevice* peer;   // Opens it, another device of the same backend
+    uint64 size;
+};
+
+struct gaSharedBuffer
+{
+    gaBackend backend;
+    gaDevice* device;
+    gaDevice* peer;
+    uint64 size;
+    void* resource;     // The buffer on device, ID3D12Resource*
+    void* peerResource; // The same memory's buffer on peer
+    gaFence* fence;     // One fence, as device sees it. Both are the buffer's.
+    gaFence* peerFence; // And as peer sees it
+
+    virtual ~gaSharedBuffer() = default;
+};
+
+Result<gaSharedBuffer*> GaCreateSharedBuffer(const gaSharedBufferCreateInfo& createInfo);
+
+// Once neither device uses it any more
+void GaDestroySharedBuffer(gaSharedBuffer* buffer);
+
+// Barriers. A resource is in one state at a time on the GPU, the way the next pass uses it, and
+// moving it between them waits for the work before to finish with it and flushes or
+// decompresses what needs it. GaCmdBarriers records a batch at once, which the driver can
+// overlap; one at a time, each is a separate stall. Legacy ResourceBarrier on DX12, with its
+// split barriers; vkCmdPipelineBarrier2 on Vulkan, where the states pick the stages, accesses
+// and image layouts.
+//
+// A split barrier is begun right after the resource's last use and ended right before its next,
+// giving the GPU the passes between to do the transition in. Vulkan has no equivalent without
+// events, so a begin does nothing there and the end is a whole barrier.
+
+enum class gaResourceState : uint8
+{
+    Common, // Anything, slowly. What placed resources are created in, and copies on any queue.
+    ShaderRead,
+    UnorderedAccess,
+    ColorTarget,
+    DepthWrite,
+    DepthRead,
+    CopySource,
+    CopyDest,
+    IndirectArgument, // Read by GaCmdDrawIndexedIndirect, its arguments and count
+    Present,
+    ShadingRateSource, // A rate image, read by the draws GaCmdSetShadingRate points at it
+    Count,
+};
+
+enum class gaBarrierSplit : uint8
+{
+    None,
+    Begin,
+    End,
+};
+
+struct gaBarrier
+{
+    void* resource; // ID3D12Resource*, VkImage or VkBuffer
+    gaResourceState before;
+    gaResourceState after;
+    bool texture = true;
+    bool depth = false; // A depth texture, for Vulkan's image aspect
+    // The contents are thrown away: the resource's first use in its memory, which other resources
+    // used before (an aliasing barrier on DX12, an undefined old layout on Vulkan). before is
+    // still the state it was last left in, DX12 tracks it.
+    bool discard = false;
+    // UnorderedAccess to UnorderedAccess is a UAV barrier, between dispatches writing the same
+    // resource. Split makes no sense for that, or for a discard.
+    gaBarrierSplit split = gaBarrierSplit::None;
+};
+
+// In one batch. The list is a recording graphics or compute list.
+Result<> GaCmdBarriers(gaCommandList* list, ArrayView<const gaBarrier> barriers);
+
+// Automatic barriers. A state tracker knows the state each of its resources is in, so passes
+// say how they'll use a resource instead of which barrier it needs:
+//
+//     GaUse(list, tracker, shadowMap, gaResourceState::ShaderRead);
+//     GaUse(list, tracker, gbuffer, gaResourceState::ColorTarget);
+//     GaCmdDispatchMesh(list, ...); // Both transitions go first, in one GaCmdBarriers
+//
+// The transitions queue up until the list's next draw, dispatch, copy, bundle or its end, which
+// records them as one batch. A resource already in the state needs nothing, and one used several
+// ways before the batch goes out only moves from where it was to where it ends up. Using a
+// resource as UnorderedAccess again is a UAV barrier, so each dispatch sees the last one's writes.
+//
+// States are whole resources, as gaBarrier's are. The tracker takes the order uses are recorded
+// in as the order the GPU runs them, so it's used for one list at a time, from one thread, with
+// lists submitted in the order they were recorded. Barriers recorded by hand on a tracked
+// resource have to be told to it with GaSetTrackedState.
+
+struct gaTrackedResource
+{
+    void* resource; // ID3D12Resource*, VkImage or VkBuffer, as in gaBarrier
+    gaResourceState state = gaResourceState::Common; // The state it's in now
+    bool texture = true;
+    bool depth = false;
+};
+
+struct gaStateTracker
+{
+    gaDevice* device;
+    uint32 resources;       // Tracked
+    uint32 pendingBarriers; // Queued for the next draw, dispatch, copy or end
+
+    virtual ~gaStateTracker() = default;
+};
+
+Result<gaStateTracker*> GaCreateStateTracker(gaDevice* device);
+
+// Once no list has barriers from it still queued
+void GaDestroyStateTracker(gaStateTracker* tracker);
+
+// Fails for a resource that's tracked already
+Result<> GaTrackResource(gaStateTracker* tracker, const gaTrackedResource& resource);
+
+// Before destroying it. Barriers it has queued still go out.
+void GaUntrackResource(gaStateTracker* tracker, void* resource);
+
+// The state a resource is left in by work the tracker didn't see, with no barrier of its queued.
+// NotFound if it isn't tracked.
+Result<> GaSetTrackedState(gaStateTracker* tracker, void* resource, gaResourceState state);
+
+// Queues what the resource needs to be used as state by the list's next draw, dispatch or copy.
+// The list is a recording graphics or compute list, and the tracker's queued barriers have to
+// have gone out to any other list first.
+Result<> GaUse(gaCommandList* list, gaStateTracker* tracker, void* resource, gaResourceState state);
+
+// Records the queued barriers now, for work the tracker doesn't see, like a render pass begun
+// through the native list. Does nothing when there are none.
+Result<> GaFlushBarriers(gaCommandList* list);
+
+// GPU timing. A query pool holds timestamps the GPU writes as it gets to them in one queue's
+// command lists, timestampsPerFrame for each frame in flight. Reading them back never stalls: a
+// frame's timestamps are read once its slot comes round again, framesInFlight frames on, by when
+// GaBeginFrame has already waited for the GPU to finish it. DX12 resolves them into a readback
+// buffer with a command the frame records after its last timestamp; Vulkan reads the pool itself
+// and resets it from the CPU (hostQueryReset), but the resolve is still recorded, for the same
+// results on both.
+//
+//     GaBeginFrame(device);
+//     GaBeginTimestampFrame(pool); // pool->results is the frame framesInFlight back
+//     uint32 start = GaCmdWriteTimestamp(list, pool).Value();
+//     ... record ...
+//     uint32 end = GaCmdWriteTimestamp(list, pool).Value();
+//     ... in the frame's last list on the queue ...
+//     GaCmdResolveTimestamps(list, pool);
+//
+// Timestamps count GPU ticks, frequency of them a second, and only the differences between them
+// mean anything. GaGetClockCalibration samples the GPU's clock and the CPU's together, which puts
+// timestamps on the CPU's timeline: GetClockCalibration on DX12, VK_EXT_calibrated_timestamps on
+// Vulkan. The Null backend's timestamps and clocks are all 0.
+
+struct gaQueryPoolCreateInfo
+{
+    gaDevice* device = nullptr;
+    // Graphics or compute. Copy queue timestamps need heaps of their own on DX12.
+    gaQueueType queue = gaQueueType::Graphics;
+    uint32 timestampsPerFrame = 256;
+};
+
+struct gaQueryPool
+{
+    gaBackend backend;
+    void* internalHandle; // ID3D12QueryHeap* or VkQueryPool
+    gaDevice* device;
+    gaQueueType queue;
+    uint32 timestampsPerFrame;
+    uint64 frequency; // Ticks a second, of the queue's timestamps
+
+    // What GaBeginTimestampFrame read back: the resolved timestamps resultFrame wrote, by index.
+    // Valid until the next GaBeginTimestampFrame; resultFrame is 0 before any frame comes back.
+    const uint64* results;
+    uint32 resultCount;
+    uint64 resultFrame;
+
+    virtual ~gaQueryPool() = default;
+};
+
+// Both clocks at one moment
+struct gaClockCalibration
+{
+    uint64 gpuTimestamp;
+    uint64 gpuFrequency;
+    // Clock::NowTicks's clock: QueryPerformanceCounter on Windows, CLOCK_MONOTONIC elsewhere
+    uint64 cpuTicks;
+    uint64 cpuFrequency;
+};
+
+Result<gaQueryPool*> GaCreateQueryPool(const gaQueryPoolCreateInfo& createInfo);
+
+// Once the GPU is done with the frames that wrote timestamps to it
+void GaDestroyQueryPool(gaQueryPool* pool);
+
+// Once a frame, after GaBeginFrame and before the frame's first timestamp: reads back the
+// timestamps of the last frame to use this frame's slot into results, and frees the slot for
+// this frame's
+Result<> GaBeginTimestampFrame(gaQueryPool* pool);
+
+// Records a timestamp into a recording list on the pool's queue, written once the GPU is done
+// with everything recorded before it, and returns its index in the frame's. Any thread can
+// record them. OutOfMemory once the frame has used up timestampsPerFrame.
+Result<uint32> GaCmdWriteTimestamp(gaCommandList* list, gaQueryPool* pool);
+
+// Resolves the frame's timestamps so far, so it's recorded after the last of them, into a list
+// submitted after the lists holding them
+Result<> GaCmdResolveTimestamps(gaCommandList* list, gaQueryPool* pool);
+
+// queue is graphics or compute, whose timestamps to calibrate
+Result<gaClockCalibration> GaGetClockCalibration(gaDevice* device, gaQueueType queue);
+
+// GPU zones. A zone is a named stretch of a command list, timed on the GPU with a timestamp at
+// each end: a pass, say, for a per-pass breakdown of the frame's GPU time to show next to the
+// CPU's zones. GA_GPU_ZONE(list, "name") times the rest of the scope it's in. Zones are timed
+// into the device's GPU profiler, and cost a check for null on devices without one.
+//
+//     GaBeginFrame(device);
+//     GaBeginGpuProfilerFrame(profiler); // profiler->zones is the frame framesInFlight back
+//     {
+//         GA_GPU_ZONE(list, "Shadows");
+//         ... record the pass ...
+//     }
+//     ... in the frame's last list on each queue it timed zones on ...
+//     GaCmdResolveGpuZones(list);
+//
+// Zone times are on the CPU's clock (Clock::NowTicks), calibrated every frame, so they line up
+// with CPU zones from the same moment: rsbl-jobs' TraceGpuZone puts them on a track of their own
+// in its captures. Zones on the graphics and compute queues are timed, copy lists' are left out.
+
+struct gaGpuProfilerCreateInfo
+{
+    gaDevice* device = nullptr;
+    uint32 zonesPerFrame = 256;
+};
+
+struct gaGpuZone
+{
+    const char* name; // As given, so a string literal or anything else that outlives it
+    uint64 startTicks;
+    uint64 endTicks;
+    gaQueueType queue;
+    uint32 depth; // Zones it's inside, on the same queue
+};
+
+struct gaGpuProfiler
+{
+    gaDevice* device;
+    uint32 zonesPerFrame;
+
+    // What GaBeginGpuProfilerFrame read back: zoneFrame's zones, ordered by queue then start.
+    // Valid until the next GaBeginGpuProfilerFrame; zoneFrame is 0 before any frame comes back.
+    const gaGpuZone* zones;
+    uint32 zoneCount;
+    uint64 zoneFrame;
+    // The clocks couldn't be calibrated (no VK_EXT_calibrated_timestamps), so zone times are
+    // right as durations, but not where they sit on the CPU's timeline
+    bool uncalibrated;
+
+    virtual ~gaGpuProfiler() = default;
+};
+
+// One per device, which zones are timed into from then on
+Result<gaGpuProfiler*> GaCreateGpuProfiler(const gaGpuProfilerCreateInfo& createInfo);
+
+// Once the GPU is done with the frames that timed zones
+void GaDestroyGpuProfiler(gaGpuProfiler* profiler);
+
+// Once a frame, after GaBeginFrame and before the frame's first zone: reads back the zones of the
+// last frame to use this frame's slot into zones
+Result<> GaBeginGpuProfilerFrame(gaGpuProfiler* profiler);
+
+// The zone to end, or kGaNoGpuZone where there's no profiler, the list is a copy list or the
+// frame is out of zones, which GaEndGpuZone ignores. A zone ends in the list it began in.
+constexpr uint32 kGaNoGpuZone = ~0u;
+uint32 GaBeginGpuZone(gaCommandList* list, const char* name);
+void GaEndGpuZone(gaCommandList* list, uint32 zone);
+
+// GaCmdResolveTimestamps for the profiler's timestamps on the list's queue. Does nothing where
+// there's no profiler.
+Result<> GaCmdResolveGpuZones(gaCommandList* list);
+
+class gaGpuZoneScope
+{
+  public:
+    gaGpuZoneScope(gaCommandList* list, const char* name)
+        : m_list(list)
+        , m_zone(GaBeginGpuZone(list, name))
+    {
+    }
+
+    ~gaGpuZoneScope()
+    {
+        GaEndGpuZone(m_list, m_zone);
+    }
+
+    gaGpuZoneScope(const gaGpuZoneScope&) = delete;
+    gaGpuZoneScope& operator=(const gaGpuZoneScope&) = delete;
+
+  private:
+    gaCommandList* m_list;
+    uint32 m_zone;
+};
+
+// Breadcrumbs, for finding where the GPU was when the device was lost, in release builds without
+// the validation layers. The GPU writes markers into a buffer the CPU keeps mapped as it gets
+// through each list, so once a hang or fault loses the device, each slot holds the last marker
+// it got past. A slot per list recording at once, its markers counting up through the frame:
+//
+//     GaCmdWriteBreadcrumb(list, breadcrumbs, recorder, ++marker); // After each pass, say
+//     ...
+//     if (!GaPresent(swapchain)) // ErrorCategory::Graphics, the device was lost
+//     {
+//         GaReadBreadcrumbs(breadcrumbs, markers); // Log them with what each marker was
+//         GaReportDeviceLost(device);
+//     }
+//
+// WriteBufferImmediate on DX12, written once the work before it has finished. On Vulkan,
+// vkCmdWriteBufferMarkerAMD with gaDevice::bufferMarkers, likewise; vkCmdFillBuffer otherwise,
+// written once the GPU has reached it, and outside render passes only.
+
+struct gaBreadcrumbsCreateInfo
+{
+    gaDevice* device;
+    uint32 slots = 16;
+};
+
+struct gaBreadcrumbs
+{
+    gaBackend backend;
+    void* internalHandle; // The buffer, an ID3D12Resource* or VkBuffer
+    gaDevice* device;
+    uint32 slots;
+
+    virtual ~gaBreadcrumbs() = default;
+};
+
+// Slots start at zero
+Result<gaBreadcrumbs*> GaCreateBreadcrumbs(const gaBreadcrumbsCreateInfo& createInfo);
+void GaDestroyBreadcrumbs(gaBreadcrumbs* breadcrumbs);
+
+// Has the GPU write marker to slot. Not for bundles.
+Result<> GaCmdWriteBreadcrumb(gaCommandList* list,
+                              gaBreadcrumbs* breadcrumbs,
+                              uint32 slot,
+                              uint32 marker);
+
+// Each slot's marker as the GPU last wrote it. Any time, a lost device included.
+Result<> GaReadBreadcrumbs(const gaBreadcrumbs* breadcrumbs, DynamicArray<uint32>& markers);
+
+// Logs what the driver knows of why and where the device was lost. DRED's, on DX12: the
+// operation each list the GPU hadn't finished stopped at, and the allocations at a page fault's
+// address, with enableDeviceLostReports. NotFound while the device isn't lost, and on Vulkan,
+// which has no such report. GaPresent logs it when it finds the device lost.
+Result<> GaReportDeviceLost(gaDevice* device);
+
+#define RSBL_GA_ZONE_CONCAT_INNER(a, b) a##b
+#define RSBL_GA_ZONE_CONCAT(a, b) RSBL_GA_ZONE_CONCAT_INNER(a, b)
+#define GA_GPU_ZONE(list, name)                                                                   \
+    ::rsbl::gaGpuZoneScope RSBL_GA_ZONE_CONCAT(gpuZone, __LINE__)((list), (name))
+
+// GPU memory. Drivers cap how many allocations a process makes (4096 on plenty of them) and round
+// each up to a large page, so resources aren't given memory of their own. A memory allocator
+// creates big heaps per memory type and hands out ranges of them, with a TLSF allocator per heap
+// (see RangeAllocator), and resources are placed at the range's offset. Allocations too big to
+// share a heap get a heap of their own.
+//
+// Linear pools are for memory that lives a frame or so, like upload staging: one heap, bumped
+// through and reset all at once.
+//
+// Defragmentation is incremental. GaBeginDefragmentation plans moves out of the emptiest heap of
+// each type into the others, up to a byte budget, and moves the allocations in the allocator
+// straight away; the caller copies the bytes on the GPU and recreates the resources placed in
+// them. Once the copies are done, GaEndDefragmentation frees the ranges they were copied from and
+// any heap left empty. A pass a frame keeps the cost bounded.
+
+enum class gaMemoryType
+{
+    DeviceLocal, // VRAM, GPU access only
+    Upload,      // CPU writes, GPU reads
+    Readback,    // GPU writes, CPU reads
+    Count,
+};
+
+struct gaMemoryHeap
+{
+    gaBackend backend;
+    void* internalHandle; // ID3D12Heap* or VkDeviceMemory
+    gaMemoryType type;
+    uint64 size;
+
+    virtual ~gaMemoryHeap() = default;
+};
+
+// A range of a heap
+struct gaMemoryAllocation
+{
+    gaMemoryHeap* heap;
+    uint64 offset;
+    uint64 size;
+};
+
+struct gaMemoryAllocatorCreateInfo
+{
+    gaDevice* device;
+    uint64 heapSize = 64ull << 20; // Size of the heaps allocations share
+    // Allocations above this get a heap of their own, 0 for heapSize / 4. Big render targets
+    // and the like, which would otherwise leave a heap mostly empty when freed.
+    uint64 dedicatedThreshold = 0;
+};
+
+struct gaMemoryAllocator
+{
+    gaDevice* device;
+    uint64 heapSize;
+    uint64 dedicatedThreshold;
+
+    virtual ~gaMemoryAllocator() = default;
+};
+
+// Per memory type
+struct gaMemoryStats
+{
+    uint32 heaps = 0; // Shared heaps, dedicated ones are counted as allocations
+    uint32 allocations = 0;
+    uint32 dedicatedAllocations = 0;
+    uint64 heapBytes = 0; // Shared and dedicated heaps
+    uint64 allocatedBytes = 0;
+    uint64 largestFreeRange = 0; // In any shared heap
+};
+
+// What the OS lets the process use and what it uses now, from QueryVideoMemoryInfo on DX12 and
+// VK_EXT_memory_budget on Vulkan (or the heap sizes where the driver doesn't have it). Local is
+// VRAM; on integrated GPUs it's all local. Allocating past the budget doesn't fail straight away,
+// the OS starts paging instead, so keep usage under it.
+struct gaMemoryBudget
+{
+    uint64 localBudget = 0;
+    uint64 localUsage = 0;
+    uint64 nonLocalBudget = 0;
+    uint64 nonLocalUsage = 0;
+};
+
+struct gaLinearPoolCreateInfo
+{
+    gaMemoryAllocator* allocator;
+    gaMemoryType type;
+    uint64 size;
+};
+
+struct gaLinearPool
+{
+    gaMemoryAllocator* allocator;
+    gaMemoryAllocation* memory;
+    uint64 used;
+
+    virtual ~gaLinearPool() = default;
+};
+
+// A planned move. The allocation already has its new heap and offset.
+struct gaDefragmentMove
+{
+    gaMemoryAllocation* allocation;
+    gaMemoryHeap* sourceHeap;
+    uint64 sourceOffset;
+};
+
+Result<gaMemoryAllocator*> GaCreateMemoryAllocator(const gaMemoryAllocatorCreateInfo& createInfo);
+
+// Every allocation must be freed first
+void GaDestroyMemoryAllocator(gaMemoryAllocator* allocator);
+
+// alignment must be a power of two: 64KB for buffers and textures on DX12, the resource's
+// VkMemoryRequirements on Vulkan
+Result<gaMemoryAllocation*> GaAllocateMemory(gaMemoryAllocator* allocator,
+                                             gaMemoryType type,
+                                             uint64 size,
+                                             uint64 alignment);
+void GaFreeMemory(gaMemoryAllocator* allocator, gaMemoryAllocation* allocation);
+
+gaMemoryStats GaGetMemoryStats(gaMemoryAllocator* allocator, gaMemoryType type);
+Result<gaMemoryBudget> GaQueryMemoryBudget(gaDevice* device);
+
+Result<gaLinearPool*> GaCreateLinearPool(const gaLinearPoolCreateInfo& createInfo);
+void GaDestroyLinearPool(gaLinearPool* pool);
+
+// Fails when the pool is full rather than growing it
+Result<gaMemoryAllocation> GaAllocateLinear(gaLinearPool* pool, uint64 size, uint64 alignment);
+
+// Only once the GPU is done with everything allocated from it, a frame fence away
+void GaResetLinearPool(gaLinearPool* pool);
+
+// Plans up to maxBytes of moves, which stay valid until GaEndDefragmentation. Fails while a pass
+// is already begun. No moves means there's nothing worth moving.
+Result<ArrayView<const gaDefragmentMove>> GaBeginDefragmentation(gaMemoryAllocator* allocator,
+                                                                 uint64 maxBytes);
+void GaEndDefragmentation(gaMemoryAllocator* allocator);
+
+// Upload ring. One big upload buffer, mapped for as long as it lives and handed out front to back
+// as a ring. Data is written (memcpy'd, or decompressed) straight into it, with no staging buffer
+// per upload, and the copies out of it are queued and recorded into one command list per flush.
+// Each flush signals the ring's fence, and its space comes back once the GPU passes it. An
+// allocation that doesn't fit waits for the oldest flush to finish.
+//
+//     gaUploadAllocation staging = GaAllocateUpload(ring, size, 16).Value();
+//     ... write size bytes to staging.data ...
+//     GaQueueBufferUpload(ring, buffer, offset, staging);
+//     ... once a frame, before submitting anything that reads the buffers ...
+//     GaFlushUploads(ring);
+//
+// Destinations are native buffers (ID3D12Resource* or VkBuffer) until rsbl-ga has its own.
+
+struct gaUploadRingCreateInfo
+{
+    gaDevice* device;
+    uint64 size = 64ull << 20;
+    uint32 recorder = 0; // Records the copies, the thread flushing must be the one using it
+    // Copy to stream in alongside rendering, with the queues reading the uploads waiting on the
+    // ring's fence
+    gaQueueType queue = gaQueueType::Graphics;
+};
+
+struct gaUploadRing
+{
+    gaBackend backend;
+    void* internalHandle; // The upload buffer, ID3D12Resource* or VkBuffer
+    gaDevice* device;
+    uint64 size;
+    gaQueueType queue;
+    gaFence* fence; // Signalled by each flush once its copies are done
+
+    virtual ~gaUploadRing() = default;
+};
+
+struct gaUploadAllocation
+{
+    uint8* data;   // Mapped, write only: reading upload memory back is very slow
+    uint64 offset; // In the upload buffer
+    uint64 size;
+};
+
+Result<gaUploadRing*> GaCreateUploadRing(const gaUploadRingCreateInfo& createInfo);
+
+// Waits for the GPU to finish the ring's copies
+void GaDestroyUploadRing(gaUploadRing* ring);
+
+// Space for size bytes, valid until the flush after its copies are queued is done on the GPU.
+// Queue its copies before the next flush.
+Result<gaUploadAllocation> GaAllocateUpload(gaUploadRing* ring, uint64 size, uint64 alignment);
+
+// Copies source into destination at destinationOffset when the ring is next flushed
+Result<> GaQueueBufferUpload(gaUploadRing* ring,
+                             void* destination,
+                             uint64 destinationOffset,
+                             const gaUploadAllocation& source);
+
+// Allocates, copies bytes in and queues the copy
+Result<> GaUploadBuffer(gaUploadRing* ring,
+                        void* destination,
+                        uint64 destinationOffset,
+                        ArrayView<const uint8> bytes);
+
+// Records every queued copy into one command list and submits it on the ring's queue, so it's
+// called in a frame (after GaBeginFrame). Does nothing when nothing is queued.
+Result<> GaFlushUploads(gaUploadRing* ring);
+
+// Readback ring. The other way round from the upload ring: one big readback buffer, mapped for as
+// long as it lives, that copies out of buffers and textures land in, so getting results back
+// never maps a resource or waits for the GPU on the spot. Each readback is a future: the copy is
+// queued, recorded with the others at the next flush, and its data is there once the fence that
+// flush signals passes, some frames later. Polling it each frame and taking what's ready keeps
+// the CPU and GPU apart, where a map and wait every frame would drain the GPU's queue each time.
+//
+//     gaReadbackFuture future = GaReadbackAsync(ring, texture).Value();
+//     GaFlushReadbacks(ring);
+//     ... frames later ...
+//     if (GaIsReadbackReady(ring, future))
+//     {
+//         ... read GaGetReadbackData(ring, future).Value() ...
+//         GaReleaseReadback(ring, future);
+//     }
+//
+// Space comes back as readbacks are released, oldest first: one held on to holds up the ones
+// after it, and a readback that doesn't fit fails rather than waits, so a capture can skip a
+// frame instead of stalling.
+
+struct gaReadbackRingCreateInfo
+{
+    gaDevice* device;
+    uint64 size = 64ull << 20;
+    uint32 recorder = 0; // Records the copies, the thread flushing must be the one using it
+    gaQueueType queue = gaQueueType::Graphics;
+};
+
+struct gaReadbackRing
+{
+    gaBackend backend;
+    void* internalHandle; // The readback buffer, ID3D12Resource* or VkBuffer
+    gaDevice* device;
+    uint64 size;
+    gaQueueType queue;
+    gaFence* fence; // Signalled by each flush once its copies are done
+
+    virtual ~gaReadbackRing() = default;
+};
+
+// A texture's mip 0 of layer 0, whole. D24UnormS8Uint and R32G32B32Float can't be read back.
+struct gaReadbackTexture
+{
+    void* texture; // ID3D12Resource* or VkImage
+    gaFormat format;
+    uint32 width;
+    uint32 height;
+    // What it's in when the flush's list runs, it's put in CopySource for the copy and back,
+    // which a copy queue's list can't do
+    gaResourceState state;
+};
+
+struct gaReadbackFuture
+{
+    uint64 serial; // Readbacks queued on the ring before this one
+    uint64 offset; // In the readback buffer
+    uint64 size;
+    // Textures' rows are rowPitch bytes apart, width * texel size of them used. 0 for buffers.
+    uint32 rowPitch;
+};
+
+Result<gaReadbackRing*> GaCreateReadbackRing(const gaReadbackRingCreateInfo& createInfo);
+
+// Waits for the GPU to finish the ring's copies
+void GaDestroyReadbackRing(gaReadbackRing* ring);
+
+// Reads size bytes of a buffer (ID3D12Resource* or VkBuffer) from offset, copied at the next flush
+Result<gaReadbackFuture> GaReadbackAsync(gaReadbackRing* ring,
+                                         void* buffer,
+                                         uint64 offset,
+                                         uint64 size);
+Result<gaReadbackFuture> GaReadbackAsync(gaReadbackRing* ring, const gaReadbackTexture& texture);
+
+// Records every queued copy into one command list and submits it on the ring's queue, after
+// whatever last wrote the sources, so it's called in a frame (after GaBeginFrame). Does nothing
+// when nothing is queued.
+Result<> GaFlushReadbacks(gaReadbackRing* ring);
+
+// Flushed, and the GPU is done with the copy. Never waits.
+bool GaIsReadbackReady(const gaReadbackRing* ring, const gaReadbackFuture& future);
+
+// The readback's bytes, valid until it's released. Not ready yet fails with Timeout, unless wait
+// is set, which waits for the GPU and is only for when there's no frame to come after, at exit
+// say. Never flushed fails either way.
+Result<ByteView> GaGetReadbackData(gaReadbackRing* ring,
+                                   const gaReadbackFuture& future,
+                                   bool wait = false);
+
+// Done with its data, or dropping it unread. Every readback is released once, in any order.
+void GaReleaseReadback(gaReadbackRing* ring, const gaReadbackFuture& future);
+
+// Bindless resources. A bindless heap is one big shader-visible descriptor table. A resource's
+// views are registered in it once, when the resource is made, and shaders look them up by the
+// index registering returns, which goes to the GPU in constants or buffers like any other data.
+// Binding the heap is once per command list, so nothing is bound per draw, and a shader can pick
+// its resources from GPU-written data, which GPU-driven rendering needs.
+//
+// On DX12 it's one CBV/SRV/UAV descriptor heap, indexed with ResourceDescriptorHeap[index] (root
+// signatures need D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED). On Vulkan it's
+// one update-after-bind descriptor set, set 0 of the pipeline layouts using it, with an array
+// per kind of descriptor, each capacity long, sharing the indices:
+//
+//     binding 0: storage buffers (buffer views)
+//     binding 1: sampled images (texture SRVs)
+//     binding 2: storage images (texture UAVs)
+//     binding 3: the heap's samplers
+//
+// Released indices are reused framesInFlight frames later, once the GPU is done with the frames
+// that could have read them. A heap is used from one thread at a time.
+//
+// Samplers are few and never change, so a heap takes every one its shaders use up front and
+// bakes them into the layouts: static samplers s0 onwards in DX12 root signatures, immutable
+// samplers in the Vulkan set layout. Materials asking for the same sampler share one.
+
+enum class gaBindlessViewType
+{
+    BufferSrv,  // StructuredBuffer / ByteAddressBuffer, a readonly storage buffer
+    BufferUav,  // RWStructuredBuffer / RWByteAddressBuffer, a storage buffer
+    TextureSrv, // Every mip and layer, in the resource's format
+    TextureUav, // Mip 0
+};
+
+struct gaBindlessView
+{
+    gaBindlessViewType type;
+    // ID3D12Resource* on DX12. On Vulkan a VkBuffer for buffer views and a VkImageView for
+    // texture views, in SHADER_READ_ONLY_OPTIMAL layout for SRVs and GENERAL for UAVs.
+    void* resource;
+
+    // Buffer views only, in bytes. stride is the structure's size, or 0 for a raw view, which
+    // needs offset and size in multiples of 4. Vulkan also needs offset aligned to
+    // minStorageBufferOffsetAlignment.
+    uint64 offset = 0;
+    uint64 size = 0;
+    uint32 stride = 0;
+};
+
+// D3D12's limit for a shader-visible CBV/SRV/UAV heap on every binding tier
+constexpr uint32 kGaMaxBindlessCapacity = 1000000;
+
+// Vulkan's minimum maxPerStageDescriptorSamplers
+constexpr uint32 kGaMaxBindlessSamplers = 16;
+
+enum class gaCompareOp
+{
+    Never,
+    Less,
+    Equal,
+    LessEqual,
+    Greater,
+    NotEqual,
+    GreaterEqual,
+    Always,
+};
+
+enum class gaFilter
+{
+    Point,
+    Linear,
+    Anisotropic,
+};
+
+enum class gaAddressMode
+{
+    Wrap,
+    Mirror,
+    Clamp,
+};
+
+struct gaSamplerDesc
+{
+    gaFilter filter = gaFilter::Linear; // Minification, magnification and between mips alike
+    gaAddressMode addressU = gaAddressMode::Wrap;
+    gaAddressMode addressV = gaAddressMode::Wrap;
+    gaAddressMode addressW = gaAddressMode::Wrap;
+    uint32 maxAnisotropy = 16;                      // 1 to 16, Anisotropic only
+    bool compare = false;                           // A comparison sampler, for shadow maps
+    gaCompareOp compareOp = gaCompareOp::LessEqual; // Compare only
+    float mipBias = 0.0f;
+};
+
+struct gaBindlessHeapCreateInfo
+{
+    gaDevice* device;
+    uint32 capacity = 65536; // Indices, up to kGaMaxBindlessCapacity
+    // Duplicates are made once, up to kGaMaxBindlessSamplers distinct ones
+    ArrayView<const gaSamplerDesc> samplers;
+};
+
+struct gaBindlessHeap
+{
+    gaBackend backend;
+    void* internalHandle; // ID3D12DescriptorHeap* or VkDescriptorSet
+    void* setLayout;      // VkDescriptorSetLayout for pipeline layouts, null on DX12
+    gaDevice* device;
+    uint32 capacity;
+    uint32 registered; // Indices in use, counting released ones not reused yet
+    // The distinct samplers, in register/array order
+    ArrayView<const gaSamplerDesc> samplers;
+
+    virtual ~gaBindlessHeap() = default;
+};
+
+Result<gaBindlessHeap*> GaCreateBindlessHeap(const gaBindlessHeapCreateInfo& createInfo);
+
+// Once the GPU is done with every list it was bound to
+void GaDestroyBindlessHeap(gaBindlessHeap* heap);
+
+// Writes the view into the heap, returning the index shaders read it at. Fails when every index
+// is in use.
+Result<uint32> GaRegisterBindless(gaBindlessHeap* heap, const gaBindlessView& view);
+
+// The view stays readable by the frames in flight, its index is handed out again once they're
+// done. Release before destroying the resource, and destroy it no sooner than the index is
+// reused.
+void GaReleaseBindless(gaBindlessHeap* heap, uint32 index);
+
+// The sampler's register (DX12) or binding 3 array element (Vulkan). NotFound when the heap
+// wasn't made with it.
+Result<uint32> GaFindBindlessSampler(const gaBindlessHeap* heap, const gaSamplerDesc& desc);
+
+// Binds the heap to a recording graphics or compute list, for graphics and compute work where
+// the queue does both. DX12 ignores pipelineLayout; Vulkan binds the set as set 0 of it (a
+// VkPipelineLayout), which pipelines using the heap must be compatible with.
+Result<> GaBindBindlessHeap(gaCommandList* list, gaBindlessHeap* heap, void* pipelineLayout);
+
+// CPU descriptors, for DX12: views written on the CPU and used from there (render and depth
+// targets, clears) or copied into shader-visible heaps. A descriptor allocator owns every heap of
+// one type, so objects don't make small heaps of their own. Long-lived descriptors come from a
+// free list over heaps of pageSize descriptors, made as they fill and kept for reuse. Transient
+// descriptors, written for a frame and done with once its lists are, come from a linear region
+// per frame in flight, contiguous so they copy in one call, and reclaimed by the GaBeginFrame
+// that waits on the frame's fences. Vulkan writes views into descriptor sets instead and has no
+// allocators; the Null backend hands out handles to plain memory.
+
+enum class gaDescriptorType
+{
+    Resource,     // CBV/SRV/UAV
+    Sampler,
+    RenderTarget, // RTV
+    DepthStencil, // DSV
+    Count,
+};
+
+struct gaDescriptorAllocatorCreateInfo
+{
+    gaDevice* device;
+    gaDescriptorType type;
+    uint32 pageSize = 256;        // Descriptors per heap
+    uint32 transientPerFrame = 0; // Transient descriptors a frame can take
+};
+
+struct gaDescriptorAllocator
+{
+    gaBackend backend;
+    void* internalHandle; // The transient heap, ID3D12DescriptorHeap*
+    gaDevice* device;
+    gaDescriptorType type;
+    uint32 pageSize;
+    uint32 transientPerFrame;
+    uint32 increment; // Bytes from one descriptor's handle to the next
+    uint32 allocated; // Long-lived descriptors in use
+    uint32 pages;
+
+    virtual ~gaDescriptorAllocator() = default;
+};
+
+struct gaDescriptor
+{
+    uint64 cpuHandle; // D3D12_CPU_DESCRIPTOR_HANDLE::ptr
+    uint32 slot;      // For GaFreeDescriptor, long-lived descriptors only
+};
+
+Result<gaDescriptorAllocator*> GaCreateDescriptorAllocator(
+    const gaDescriptorAllocatorCreateInfo& createInfo);
+
+// Every long-lived descriptor must be freed first, and the GPU done with the transient ones
+void GaDestroyDescriptorAllocator(gaDescriptorAllocator* allocator);
+
+Result<gaDescriptor> GaAllocateDescriptor(gaDescriptorAllocator* allocator);
+
+// Lists recorded with it must be done on the GPU first
+void GaFreeDescriptor(gaDescriptorAllocator* allocator, const gaDescriptor& descriptor);
+
+// count contiguous descriptors, increment apart from the first, for the current frame only.
+// Fails when the frame has used up transientPerFrame.
+Result<gaDescriptor> GaAllocateTransientDescriptors(gaDescriptorAllocator* allocator,
+                                                    uint32 count);
+
+// Pipelines. Pipeline state objects are made through a pipeline cache, which keys each by a
+// stable hash of everything in its description (shader bytecode by content, vertex layout,
+// formats, blend, raster and depth state), so asking twice for the same state returns the same
+// pipeline. Underneath is an ID3D12PipelineLibrary or a VkPipelineCache, which lets the driver
+// skip compiling what it compiled in an earlier run.
+//
+// GaSerializePipelineCache saves both the driver's data and the recorded list of every pipeline
+// asked for, with its shaders. Created from that data in the next run, the cache compiles the
+// recorded pipelines with GaPrecompilePipelines, during loading rather than the first time each
+// is drawn with, which is where compile hitches come from. Data from another build or driver is
+// ignored, and the cache starts empty.
+//
+// Pipelines get a layout (root signature, VkPipelineLayout) from the cache: push constants at
+// b0 / push_constant, and the cache's bindless heap, if it has one, as set 0. Bind it with the
+// pipeline's layout. Shaders are DXIL or SPIR-V with main as the entry point. DX12 shaders read
+// vertex attribute N as ATTRIBUTE<N>; Vulkan's read it at location N.
+//
+// Mesh pipelines draw without vertex input, their mesh shaders reading whatever they draw, and
+// leave the primitive type to the mesh shader's output: topology only says whether it's
+// triangles, lines or points, and can't be a strip. On devices with mesh shaders, Vulkan
+// graphics layouts' push constants are for the task and mesh stages as well as
+// VK_SHADER_STAGE_ALL_GRAPHICS.
+//
+// With a scheduler set, GaRequestGraphicsPipeline / GaRequestComputePipeline never wait for the
+// driver: a pipeline that isn't made yet is compiled on a worker, and until it's done the call
+// returns the fallback given, a simpler pipeline to draw with or null to skip the draw. The
+// recorded pipelines GaPrecompilePipelines makes go to the workers too, so a whole run's worth
+// compiles in parallel in the background from the start, rather than on first use.
+
+enum class gaFormat
+{
+    Unknown,
+    R8G8B8A8Unorm,
+    R8G8B8A8Srgb,
+    B8G8R8A8Unorm,
+    B8G8R8A8Srgb,
+    R8G8B8A8Uint,
+    R10G10B10A2Unorm,
+    R11G11B10Float,
+    R16G16Float,
+    R16G16B16A16Float,
+    R16G16B16A16Unorm,
+    R32Float,
+    R32Uint,
+    R32G32Float,
+    R32G32B32Float,
+    R32G32B32A32Float,
+    D16Unorm,
+    D24UnormS8Uint,
+    D32Float,
+    Count,
+};
+
+enum class gaPrimitiveTopology
+{
+    TriangleList,
+    TriangleStrip,
+    LineList,
+    PointList,
+};
+
+enum class gaCullMode
+{
+    None,
+    Front,
+    Back,
+};
+
+enum class gaBlendMode
+{
+    Opaque,
+    AlphaBlend,    // src * a + dst * (1 - a)
+    Premultiplied, // src + dst * (1 - a)
+    Additive,      // src * a + dst
+};
+
+constexpr uint32 kGaMaxVertexAttributes = 16;
+constexpr uint32 kGaMaxVertexBuffers = 8;
+constexpr uint32 kGaMaxRenderTargets = 8;
+constexpr uint32 kGaMaxPushConstantBytes = 128;
+
+struct gaShaderBytecode
+{
+    const void* data = nullptr;
+    uint64 size = 0;
+};
+
+struct gaVertexAttribute
+{
+    uint32 location;
+    gaFormat format;
+    uint32 buffer = 0; // Index into the vertex buffers
+    uint32 offset = 0; // In bytes, into the buffer's vertex
+};
+
+struct gaVertexBuffer
+{
+    uint32 stride;
+    bool perInstance = false;
+};
+
+struct gaRasterState
+{
+    gaCullMode cull = gaCullMode::Back;
+    bool frontCounterClockwise = false;
+    bool wireframe = false;
+    bool depthClip = true;
+    int32 depthBias = 0;
+    float slopeScaledDepthBias = 0.0f;
+};
+
+struct gaDepthState
+{
+    bool test = false;
+    bool write = false;
+    gaCompareOp compare = gaCompareOp::Less;
+};
+
+struct gaGraphicsPipelineDesc
+{
+    gaShaderBytecode vertexShader;
+    gaShaderBytecode pixelShader; // Optional, depth-only passes have none
+    // A mesh pipeline has these in place of the vertex shader, and no attributes or vertex
+    // buffers. The amplification shader is optional. Needs gaDevice::meshShaders.
+    gaShaderBytecode amplificationShader;
+    gaShaderBytecode meshShader;
+    ArrayView<const gaVertexAttribute> attributes;
+    ArrayView<const gaVertexBuffer> vertexBuffers;
+    ArrayView<const gaFormat> renderTargetFormats;
+    ArrayView<const gaBlendMode> blendModes; // One per render target, or none for all opaque
+    gaFormat depthFormat = gaFormat::Unknown;
+    gaPrimitiveTopology topology = gaPrimitiveTopology::TriangleList;
+    gaRasterState raster;
+    gaDepthState depth;
+    uint32 pushConstantBytes = 0; // A multiple of 4, up to kGaMaxPushConstantBytes
+};
+
+struct gaComputePipelineDesc
+{
+    gaShaderBytecode shader;
+    uint32 pushConstantBytes = 0;
+};
+
+struct gaPipelineCacheCreateInfo
+{
+    gaDevice* device;
+    gaBindlessHeap* bindless = nullptr; // Made part of every pipeline's layout when set
+    ArrayView<const uint8> data;        // From GaSerializePipelineCache, or empty
+};
+
+struct gaPipelineCache
+{
+    gaBackend backend;
+    void* internalHandle; // ID3D12PipelineLibrary* or VkPipelineCache, null without one
+    gaDevice* device;
+    uint32 pipelines;  // Made so far
+    uint32 hits;       // Asked for again and returned from memory
+    uint32 precompile; // Recorded pipelines GaPrecompilePipelines hasn't made or scheduled yet
+    uint32 compiling;  // Requested and compiling in the background, or not yet picked up
+
+    virtual ~gaPipelineCache() = default;
+};
+
+struct gaPipeline
+{
+    gaBackend backend;
+    void* internalHandle; // ID3D12PipelineState* or VkPipeline
+    void* layout;         // ID3D12RootSignature* or VkPipelineLayout
+    uint64 key;           // The description's hash
+    uint32 pushConstantBytes;
+    bool compute;
+
+    virtual ~gaPipeline() = default;
+};
+
+Result<gaPipelineCache*> GaCreatePipelineCache(const gaPipelineCacheCreateInfo& createInfo);
+
+// Destroys its pipelines too, so only once the GPU is done with them
+void GaDestroyPipelineCache(gaPipelineCache* cache);
+
+// The cache's pipeline for the description, compiled now if it isn't made yet. Pipelines belong
+// to the cache. A cache is used from one thread at a time.
+Result<gaPipeline*> GaCreateGraphicsPipeline(gaPipelineCache* cache,
+                                             const gaGraphicsPipelineDesc& desc);
+Result<gaPipeline*> GaCreateComputePipeline(gaPipelineCache* cache,
+                                            const gaComputePipelineDesc& desc);
+
+// A compile to run on a worker thread. Compatible with rsbl-jobs' Job, so a scheduler can be
+// [&jobs](gaPipelineTask&& task) { jobs.Submit(rsblMove(task), nullptr, JobPriority::Low); }
+using gaPipelineTask = PooledFunction<void(), 48>;
+using gaPipelineScheduler = PooledFunction<void(gaPipelineTask&&), 32>;
+
+// Hands compiles for requested pipelines to scheduler from now on. The tasks must all have run
+// before the cache is destroyed, which waits for them.
+void GaSetPipelineScheduler(gaPipelineCache* cache, gaPipelineScheduler&& scheduler);
+
+// The cache's pipeline for the description if it's made, otherwise fallback (which may be null)
+// while it compiles in the background. Fails if the compile did, after which the next request
+// tries again. Without a scheduler the compile runs here, like GaCreateGraphicsPipeline.
+// GaCreate* for a pipeline that's compiling waits for it.
+Result<gaPipeline*> GaRequestGraphicsPipeline(gaPipelineCache* cache,
+                                              const gaGraphicsPipelineDesc& desc,
+                                              gaPipeline* fallback = nullptr);
+Result<gaPipeline*> GaRequestComputePipeline(gaPipelineCache* cache,
+                                             const gaComputePipelineDesc& desc,
+                                             gaPipeline* fallback = nullptr);
+
+// Compiles up to maxCount of the recorded pipelines, returning how many are left, so loading can
+// spread them over frames. With a scheduler set they're handed to it instead, to compile side by
+// side on its workers, and what's left counts the ones still compiling: call it again (a
+// maxCount of 0 hands over no more) until it's 0 to know they're all made.
+Result<uint32> GaPrecompilePipelines(gaPipelineCache* cache, uint32 maxCount = ~0u);
+
+// Everything to save for the next run, replacing data's contents
+Result<> GaSerializePipelineCache(gaPipelineCache* cache, DynamicArray<uint8>& data);
+
+// Writes size bytes of push constants, offset bytes in, for the pipeline's draws or dispatches
+// recorded after it. Per-draw data, an instance index and a material's bindless index say, goes
+// straight into the command list this way, with no constant buffer to allocate or descriptor to
+// write. SetGraphicsRoot32BitConstants / SetComputeRoot32BitConstants on DX12, vkCmdPushConstants
+// on Vulkan. The pipeline is bound on the list, or one sharing its layout; what was pushed
+// before a pipeline with another layout is bound is lost. offset and size are multiples of 4
+// within the pipeline's pushConstantBytes.
+//
+//     DrawConstants constants = {instance, materialIndex};
+//     GaCmdPushConstants(list, pipeline, 0, &constants, sizeof(constants));
+//     ... draw ...
+Result<> GaCmdPushConstants(gaCommandList* list,
+                            const gaPipeline* pipeline,
+                            uint32 offset,
+                            const void* data,
+                            uint32 size);
+
+// Compute skinning. A skinning pass keeps a skinned mesh's bind pose on the GPU and, once a frame,
+// skins every instance of it in one compute dispatch into a single output buffer. Every pass that
+// draws the mesh (depth prepass, shadow maps, the main pass) binds that buffer as its vertex
+// buffer, so the skinning is done once a frame however many passes draw it, and none of it on the
+// CPU. Available on DX12; the Null backend only checks the calls.
+
+// A bind pose vertex as the skinning shader reads it. weights are unorm16 and sum to 65535.
+struct gaSkinVertex
+{
+    float position[3];
+    float normal[3];
+    float tangent[4]; // xyz, w the bitangent sign
+    uint16 joints[4];
+    uint16 weights[4];
+};
+
+// A skinned vertex as the passes read it
+struct gaSkinnedVertex
+{
+    float position[3];
+    float normal[3];
+    float tangent[4];
+};
+
+// Floats per joint in a palette: the joint's world transform times its inverse bind matrix, the
+// top three rows of it, row-major
+constexpr uint32 kGaSkinningPaletteFloats = 12;
+
+struct gaSkinningPassCreateInfo
+{
+    gaDevice* device;
+    uint32 vertexCount;
+    uint32 jointCount;
+    uint32 instanceCount = 1; // Characters sharing the mesh, each with its own palette and output
+};
+
+struct gaSkinningPass
+{
+    gaBackend backend;
+    void* internalHandle; // The output buffer (ID3D12Resource*): instanceCount runs of vertexCount
+                          // gaSkinnedVertex, instance i's from i * vertexCount
+    uint32 vertexCount;
+    uint32 jointCount;
+    uint32 instanceCount;
+
+    virtual ~gaSkinningPass() = default;
+};
+
+// GPU-driven rendering. The arguments of indexed draws live in a buffer on the GPU, and one
+// GaCmdDrawIndexedIndirect draws all of them, with the count read from a buffer as well, so what
+// gets drawn is decided without the CPU and submitting it costs the same however many there
+// are. A culling pass fills those buffers: it tests every instance's bounding sphere against the
+// view frustum, then against a depth pyramid (HiZ) built from the previous frame's depth, and
+// appends the draws that survive both:
+//
+//     GaUploadCullInstances(pass, instances);   // Load time
+//     ... every frame ...
+//     GaDispatchCulling(pass, view);
+//     ... record a list on the graphics queue, binding the pipeline, vertex and index buffers ...
+//     GaCmdDrawIndexedIndirect(list, pass->arguments, 0, pass->instanceCount, pass->count, 0);
+//
+// Last frame's depth misses what's come into view since, and reprojecting it leaves holes. Two
+// phases cull by this frame's depth instead: the first draws what was visible last frame, which
+// is most of what's visible now, and the second builds the pyramid from the depth that leaves and
+// draws whatever it doesn't hide that the first didn't draw, keeping what's visible for the next
+// frame's first phase:
+//
+//     view.phase = gaCullPhase::LastVisible;
+//     GaDispatchCulling(pass, view);
+//     ... draw the arguments, into the depth ...
+//     view.phase = gaCullPhase::Disoccluded;
+//     view.depth = depth;                        // This frame's so far
+//     view.depthViewProjection = viewProjection; // This frame's
+//     GaDispatchCulling(pass, view);
+//     ... draw the arguments again ...
+//
+// The pyramid is built in one dispatch, each thread group taking a 64x64 tile down 6 levels and
+// the last group to finish taking the rest down to 1x1.
+//
+// The culling pass is on DX12; the Null backend only checks the calls. Indirect draws are on
+// every backend.
+
+// One indexed draw as the GPU reads it, D3D12_DRAW_INDEXED_ARGUMENTS and
+// VkDrawIndexedIndirectCommand alike
+struct gaDrawIndexedArguments
+{
+    uint32 indexCount;
+    uint32 instanceCount;
+    uint32 firstIndex;
+    int32 vertexOffset;
+    uint32 firstInstance; // Per-instance vertex data starts here, say the instance's transforms
+};
+
+struct gaCullInstance
+{
+    float center[3]; // World-space bounding sphere
+    float radius;
+    gaDrawIndexedArguments draw; // Appended as it is if any of the sphere may be visible
+};
+
+struct gaCullingPassCreateInfo
+{
+    gaDevice* device;
+    uint32 instanceCount;
+    // The depth buffer's size, in pixels, which occlusion culling reads. 0 by 0 for frustum
+    // culling only.
+    uint32 depthWidth = 0;
+    uint32 depthHeight = 0;
+};
+
+enum class gaCullPhase
+{
+    Single,      // Frustum, then the depth if there is one
+    LastVisible, // Frustum only, of the instances the last Disoccluded found visible
+    Disoccluded, // Frustum and depth, keeping which are visible, of the ones LastVisible skipped
+};
+
+struct gaCullView
+{
+    gaCullPhase phase = gaCullPhase::Single;
+
+    // Inward-facing planes, normal and distance, points p with dot(normal, p) + distance >= 0
+    // inside: the layout of rsbl::Frustum, FrustumFromViewProjection makes them
+    float frustum[6][4];
+
+    // The previous frame's depth, which the pyramid is built from: a buffer (ID3D12Resource*)
+    // of depthWidth * depthHeight floats, row by row from the top, 0 near and 1 far. Null skips
+    // occlusion culling, for the first frame or after a cut. Disoccluded needs it, this frame's
+    // as LastVisible's draws left it, and LastVisible ignores it.
+    void* depth = nullptr;
+
+    // The view projection the depth was rendered with, column-major as simd::Store4x4. Objects
+    // that moved since can be culled for a frame, where they were is what's tested.
+    float depthViewProjection[16];
+};
+
+struct gaCullingPass
+{
+    gaBackend backend;
+    void* arguments; // A gaDrawIndexedArguments per instance that survived, packed from the start
+    void* count;     // A uint32, how many survived. Both ID3D12Resource*.
+    uint32 instanceCount;
+    uint32 depthWidth;
+    uint32 depthHeight;
+
+    virtual ~gaCullingPass() = default;
+};
+
+// Clustered forward lighting. The view frustum is cut into a grid of clusters (froxels): tiles of
+// the screen, each cut into slices of depth spaced exponentially from near to far, so a cluster
+// is about as deep as it's wide. A light binning pass lists the lights that reach each cluster,
+// every frame, and a forward material shader only loops over the lights of its pixel's cluster,
+// rather than every light in the scene:
+//
+//     ... at creation, register pass->lights and pass->clusters as bindless BufferSrv views ...
+//     ... every frame ...
+//     GaDispatchLightBinning(pass, lights, view);
+//     ... record a list on the graphics queue, pushing pass->grid and the two bindless indices
+//         as the material's constants ...
+//
+// kGaClusteredLightingShader has the lookups for the material shader to include:
+//
+//     const uint cluster = ClusterIndex(grid, position.xy, viewDepth);
+//     const uint count = ClusterLightCount(clusters, grid, cluster);
+//     for (uint i = 0; i < count; ++i)
+//     {
+//         const PunctualLight light = lights[ClusterLight(clusters, grid, cluster, i)];
+//         const LightSample sample = SamplePunctualLight(light, worldPosition);
+//         color += sample.radiance * ... the BRDF, with sample.direction ...
+//     }
+//
+// A thread bins a cluster, testing the sphere each light reaches against the cluster's box in
+// view space, with the lights shared through group shared memory a batch at a time. Spot lights
+// are binned by their sphere, which is conservative. A cluster lists its lights in the order
+// they're given, up to maxLightsPerCluster; the ones past that are left out of it, so the ones
+// that matter most go first.
+//
+// The binning pass is on DX12; the Null backend only checks the calls.
+
+enum class gaLightType : uint32
+{
+    Point,
+    Spot,
+    Directional, // In every cluster
+};
+
+// A light as KHR_lights_punctual has it, in world space, as the GPU reads it
+struct gaPunctualLight
+{
+    float position[3]; // Point and spot
+    // How far the light reaches, where it falls off to nothing. 0 for KHR_lights_punctual's
+    // undefined, which reaches every cluster and falls off by the inverse square alone.
+    float range;
+    float color[3]; // Linear, times the intensity: candela, or lux for directional
+    gaLightType type;
+    float direction[3]; // Spot and directional, which way the light shines, normalized
+    // Cosines of the spot's innerConeAngle and outerConeAngle
+    float innerConeCos;
+    float outerConeCos;
+    float padding[3];
+};
+
+struct gaLightBinningPassCreateInfo
+{
+    gaDevice* device;
+    uint32 maxLights;
+    // Tiles across and down the screen, and slices of depth
+    uint32 clusterCountX = 16;
+    uint32 clusterCountY = 9;
+    uint32 clusterCountZ = 24;
+    uint32 maxLightsPerCluster = 64;
+};
+
+// The camera the lights are binned for. Left-handed, looking down +z, as the depth's view.
+struct gaLightBinningView
+{
+    float view[16]; // World to view, column-major as simd::Store4x4
+    // Tangents of half the horizontal and vertical fields of view
+    float tanHalfFovX;
+    float tanHalfFovY;
+    // The view depths the slices span: closer goes to the first, farther to the last
+    float nearZ;
+    float farZ;
+    // The render target's, in pixels, which the tiles divide
+    uint32 width;
+    uint32 height;
+};
+
+// What a material shader needs to find a pixel's cluster, kGaClusteredLightingShader's
+// ClusterGrid. Set by each dispatch, from its view.
+struct gaClusterGrid
+{
+    float tileScale[2]; // Pixels to tiles: clusterCountX / width and clusterCountY / height
+    // A view depth's slice is log2(depth) * depthScale + depthBias
+    float depthScale;
+    float depthBias;
+    uint32 clusterCountX;
+    uint32 clusterCountY;
+    uint32 clusterCountZ;
+    uint32 maxLightsPerCluster;
+};
+
+struct gaLightBinningPass
+{
+    gaBackend backend;
+    // The last dispatch's lights, a gaPunctualLight each as they were given
+    void* lights;
+    // For each cluster, x first then y then z, a uint32 count of its lights and then
+    // maxLightsPerCluster uint32 indices of them in lights. Both ID3D12Resource*.
+    void* clusters;
+    gaClusterGrid grid;
+    uint32 maxLights;
+
+    virtual ~gaLightBinningPass() = default;
+};
+
+// Temporal upscaling. The scene renders at a fraction of the output's size, with the projection
+// jittered a fraction of a pixel differently each frame, and an upscaler accumulates the frames
+// into the output through the motion vectors: each output pixel sees a different sample of its
+// area every frame, so a few frames together resolve more detail than any one rendered. The
+// quality modes render 67% down to 33% of the output's width and height:
+//
+//     gaUpscalerCreateInfo info = {device, gaUpscalerType::Dlss, width, height};
+//     Result<gaUpscaler*> upscaler = GaCreateUpscaler(info);
+//     if (!upscaler && upscaler.Category() == ErrorCategory::NotFound)
+//     {
+//         info.type = gaUpscalerType::Temporal; // Always there
+//         upscaler = GaCreateUpscaler(info);
+//     }
+//     ... render targets of renderWidth by renderHeight, samplers biased by mipBias ...
+//     ... every frame ...
+//     GaUpscalerJitter(upscaler, frame, inputs.jitter);
+//     ... shift the projection by the jitter, for a column-major P with w = z:
+//         P[8] += 2 * jitter[0] / renderWidth, P[9] -= 2 * jitter[1] / renderHeight ...
+//     ... render color, depth and motion vectors, and submit ...
+//     GaDispatchUpscale(upscaler, inputs);
+//     ... draw the UI over the output at full size ...
+//
+// Motion vectors are in render pixels, from where a pixel is this frame to where it was last
+// frame, both without their jitter; motionVectorScale converts others, renderWidth and
+// renderHeight for UV-space ones, negated for ones pointing from last frame to this. Render pixel
+// i has its sample at i + 0.5 - jitter in unjittered pixels.
+//
+// Temporal is the portable one, built in: a 3x3 filter of the nearest render pixels, history
+// reprojected along the motion of the nearest depth among them and clamped to their spread, and
+// blended by how near the nearest sample fell. FSR, DLSS and XeSS are the vendors' upscalers,
+// which need their SDKs; where the build has none, creating them is NotFound. The upscaler is
+// on DX12; the Null backend only checks the calls.
+
+enum class gaUpscalerType : uint32
+{
+    Temporal,
+    Fsr,  // Any GPU
+    Dlss, // NVIDIA
+    Xess, // Intel, and others through DP4a
+};
+
+// Output width over render width, and height over height: 1.5, 1.7, 2 and 3 for the modes after
+// Native, as FSR, DLSS and XeSS all have them
+enum class gaUpscaleQuality : uint32
+{
+    Native, // Antialiasing alone, at the output's size
+    Quality,
+    Balanced,
+    Performance,
+    UltraPerformance,
+};
+
+struct gaUpscalerCreateInfo
+{
+    gaDevice* device;
+    gaUpscalerType type = gaUpscalerType::Temporal;
+    uint32 outputWidth;
+    uint32 outputHeight;
+    gaUpscaleQuality quality = gaUpscaleQuality::Quality;
+    // Depth is 1 at the near plane and 0 at the far one
+    bool depthReversed = false;
+};
+
+// ID3D12Resource* textures, in gaResourceState::Common, left there
+struct gaUpscaleInputs
+{
+    void* color;         // renderWidth by renderHeight, linear, of any float or unorm format
+    void* depth;         // R32Float, or a D32Float depth buffer created R32 typeless
+    void* motionVectors; // R16G16Float or R32G32Float
+    // outputWidth by outputHeight, made with unordered access: R16G16B16A16Float,
+    // R11G11B10Float or R8G8B8A8Unorm, say
+    void* output;
+    float jitter[2]; // This frame's, in render pixels
+    float motionVectorScale[2] = {1.0f, 1.0f};
+    // The last frames don't lead to this one: a camera cut, or the first frame
+    bool reset = false;
+};
+
+struct gaUpscaler
+{
+    gaBackend backend;
+    gaUpscalerType type;
+    uint32 renderWidth;
+    uint32 renderHeight;
+    uint32 outputWidth;
+    uint32 outputHeight;
+    // Frames before the jitter repeats, enough for every output pixel to see a sample near it
+    uint32 jitterPhaseCount;
+    // For the samplers of the scene's textures, so they're as sharp as the output's mips
+    float mipBias;
+
+    virtual ~gaUpscaler() = default;
+};
+
+// Mip generation. Textures that arrive without mips, runtime-generated ones and glTF images
+// decoded at load time, get them on the GPU from mip 0 rather than on the CPU, so only mip 0 is
+// uploaded:
+//
+//     ... create the texture with every mip and unordered access, upload mip 0 ...
+//     GaGenerateMips(pass, {texture, gaFormat::R8G8B8A8Srgb, width, height, mipCount});
+//     ... sample it, viewed as R8G8B8A8Srgb ...
+//
+// The mips are what rsbl-asset's GenerateMips makes: each half the last rounding down, 2x2
+// texels averaged, an odd last row or column left out, and sRGB color averaged in linear light.
+// One dispatch makes every mip: a thread group takes a 64x64 tile of mip 0 down 6 mips through
+// group shared memory, and the last group to finish takes the rest from there, as the culling
+// pass's depth pyramid does. The mip generator is on DX12; the Null backend only checks the
+// calls. Block compressed textures come compressed with their mips from rsbl-asset.
+
+// Up to 16384 texels across
+constexpr uint32 kGaMaxGeneratedMips = 15;
+
+struct gaMipGenerationPassCreateInfo
+{
+    gaDevice* device;
+    // Mip 0 of the largest texture the pass generates mips for
+    uint32 maxWidth = 4096;
+    uint32 maxHeight = 4096;
+};
+
+// A texture to generate the mips of, created with unordered access and in
+// gaResourceState::Common, where it's left. Formats are the unorm and float color formats
+// without B8G8R8A8; the sRGB one needs the texture created R8G8B8A8 typeless, as unordered
+// access can't write sRGB, and mip 0's encoding is kept.
+struct gaMipGenerationTarget
+{
+    void* texture; // ID3D12Resource*
+    gaFormat format;
+    uint32 width; // Mip 0's
+    uint32 height;
+    uint32 mipCount; // Mip 0 included, up to GaMipCount's
+};
+
+struct gaMipGenerationPass
+{
+    gaBackend backend;
+    uint32 maxWidth;
+    uint32 maxHeight;
+
+    virtual ~gaMipGenerationPass() = default;
+};
+
+// Every adapter the backend can make a device on, one device each for work split across GPUs. The
+// order is the one GaCreateDevice breaks ties by for HighPerformance.
+Result<> GaEnumerateAdapters(gaBackend backend, DynamicArray<gaAdapterInfo>& adapters);
+
+Result<gaDevice*> GaCreateDevice(const gaDeviceCreateInfo& createInfo);
+void GaDestroyDevice(gaDevice* device);
+
+Result<gaSwapchain*> GaCreateSwapchain(const gaSwapchainCreateInfo& createInfo);
+void GaDestroySwapchain(gaSwapchain* swapchain);
+
+// Blocks until the swapchain can take another present without going over maxFrameLatency, and
+// the back buffer is free to render to. A frame loop calls it first, before sampling input, so
+// that the input it samples is as fresh as can be when the frame shows:
+//
+//     GaWaitForSwapchain(swapchain);
+//     ... sample input, update, GaBeginFrame, record and submit ...
+//     GaPresent(swapchain);
+//
+// The frame latency waitable object on DX12. On Vulkan, the back buffer's acquire, and
+// vkWaitForPresentKHR where the device has VK_KHR_present_wait. Timeout once timeoutMs is up.
+Result<> GaWaitForSwapchain(gaSwapchain* swapchain, uint32 timeoutMs = ~0u);
+
+// Resizes the back buffers, to the window's new client size say. The buffers are recreated by the
+// next GaWaitForSwapchain, before the frame renders to one, so a burst of resizes (a window edge
+// being dragged) is one recreate a frame at most. 0 by 0, a minimized window, keeps them as they
+// are until it's restored. Nothing waits for the device to go idle: DX12's ResizeBuffers waits
+// for the frames rendering to the old buffers, up to the last present, and Vulkan's old
+// swapchain is retired and left to finish while the new one renders.
+Result<> GaResizeSwapchain(gaSwapchain* swapchain, uint32 width, uint32 height);
+
+// Presents currentBuffer once everything submitted to the graphics queue before is done, and
+// moves currentBuffer on. Waits for the swapchain first if the frame loop didn't.
+Result<> GaPresent(gaSwapchain* swapchain);
+
+// Exclusive fullscreen: the swapchain takes over the output its window is mostly on, through
+// DXGI's SetFullscreenState, which resizes the window to it (resize the swapchain along, as for
+// any resize). A flip model swapchain in a borderless fullscreen window (WindowMode::Fullscreen)
+// gets independent flip anyway, which presents as directly without the mode switch, and
+// gaPresentStats::path says whether it has. DXGI leaves exclusive fullscreen when the window
+// loses focus; presents go on as they did in the window. Tearing presents (Immediate, Vrr) don't
+// tear while exclusive, as DXGI doesn't allow it; a sync interval of 0 tears there anyway.
+// InvalidArgument on Vulkan, which would need VK_EXT_full_screen_exclusive. The null backend
+// has no output and does nothing.
+Result<> GaSetExclusiveFullscreen(gaSwapchain* swapchain, bool exclusive);
+
+// Which present the display showed last, and when, for telling how long frames took to reach
+// the screen. DX12 reads the swapchain's frame statistics, which have the refresh it was shown
+// at. Vulkan only has VK_KHR_present_wait say whether a present has been shown, so it's timed
+// when that's found out, here or in GaWaitForSwapchain, and is late by up to a frame. NotFound
+// on Vulkan devices without present wait, and on DXGI until the swapchain has statistics (a
+// window that isn't composed through flip model has none). The null backend shows presents as
+// they're made.
+Result<gaPresentStats> GaGetPresentStats(gaSwapchain* swapchain);
+
+// Starts the next frame: waits for the GPU to finish the frame framesInFlight frames back, then
+// resets its command allocators for reuse. Call it before recording each frame, never while a
+// list is recording.
+Result<> GaBeginFrame(gaDevice* device);
+
+// Waits for the GPU to finish everything submitted to the device, then destroys everything
+// deferred. For loading screens and shutdown, GaDestroyDevice calls it.
+Result<> GaWaitForIdle(gaDevice* device);
+
+// Deferred destruction. Objects the GPU may still be using, a buffer the last frame drew with say,
+// are handed to GaDeferDestroy rather than destroyed, and destroyed once the frames submitted up to
+// then are done: by the GaBeginFrame framesInFlight frames on, after it has waited for them, with
+// no wait of its own. The frame's objects are destroyed together, with one call to each destroy
+// function for all of its objects:
+//
+//     GaDeferDestroy(device, buffer, [](ArrayView<void* const> buffers) {
+//         for (void* buffer : buffers) static_cast<ID3D12Resource*>(buffer)->Release();
+//     });
+//
+// Any thread can defer at any time, a lock-free push. Whatever is left is destroyed by
+// GaWaitForIdle and GaDestroyDevice.
+using gaDestroyFunction = void (*)(ArrayView<void* const> objects);
+
+Result<> GaDeferDestroy(gaDevice* device, void* object, gaDestroyFunction destroy);
+
+// Request queue. Most of rsbl-ga is called by the thread that owns the device (the one beginning
+// frames and submitting), and a loader on a job thread that wants a buffer filled, a pipeline
+// made or a resource gone posts the call here instead, to run on that thread. Posting is
+// lock-free, so loaders never wait on each other or on the frame. The owner drains the queue once
+// a frame, running what was posted in the order it was, as one batch: the uploads go out in a
+// single GaFlushUploads, and the destroys to GaDeferDestroy, together.
+//
+//     // On a job thread
+//     GaPostUpload(requests, vertexBuffer, 0, rsblMove(vertices));
+//     GaPostRequest(requests, [heap, index](gaRequestQueue*) -> Result<> {
+//         GaReleaseBindless(heap, index);
+//         return ResultCode::Success;
+//     });
+//
+//     // On the owner's thread, each frame
+//     GaBeginFrame(device);
+//     GaDrainRequests(requests);
+//
+// Requests are fixed-size records, a function with up to 48 bytes of captures inline (bigger
+// ones spill into a pool), kept in a ring of arenas. A post takes the next record in the arena
+// being filled, or moves on to the next arena once it's full; the drain gives arenas back as it
+// empties them. Posting fails with OutOfMemory when every arena is waiting to be drained.
+
+struct gaRequestQueue;
+using gaRequest = PooledFunction<Result<>(gaRequestQueue* queue), 48>;
+
+struct gaRequestQueueCreateInfo
+{
+    gaDevice* device;
+    gaUploadRing* uploads = nullptr; // Needed for GaPostUpload, and flushed by each drain
+    uint32 requestsPerArena = 256;
+    uint32 arenas = 16; // At least 2
+};
+
+struct gaRequestQueue
+{
+    gaDevice* device;
+    gaUploadRing* uploads;
+
+    virtual ~gaRequestQueue() = default;
+};
+
+Result<gaRequestQueue*> GaCreateRequestQueue(const gaRequestQueueCreateInfo& createInfo);
+
+// Runs what's still posted first, so nothing posted is lost. Nothing can be posting.
+void GaDestroyRequestQueue(gaRequestQueue* queue);
+
+// Any thread, any time
+Result<> GaPostRequest(gaRequestQueue* queue, gaRequest&& request);
+
+// Copies bytes into destination at destinationOffset through the queue's upload ring when
+// drained, then frees them
+Result<> GaPostUpload(gaRequestQueue* queue,
+                      void* destination,
+                      uint64 destinationOffset,
+                      DynamicArray<uint8>&& bytes);
+
+// GaDeferDestroy when drained, so after whatever was posted before it, an upload into the object
+// say
+Result<> GaPostDestroy(gaRequestQueue* queue, void* object, gaDestroyFunction destroy);
+
+// The owner's thread, in a frame (after GaBeginFrame). Runs everything posted before it was
+// called, then flushes the uploads, and returns how many requests ran. A request that's still
+// being posted when the drain reaches it waits, with everything posted after it, for the next
+// drain. A request that fails stops the drain there, and is the failure returned; the ones after
+// it run next time.
+Result<uint32> GaDrainRequests(gaRequestQueue* queue);
+
+// A command list for the current frame, recording on recorder, which must be below
+// commandRecorders and not recording another list. Call it from any thread; only one thread may
+// use a recorder at a time.
+Result<gaCommandList*> GaBeginCommandList(gaDevice* device, gaQueueType queue, uint32 recorder);
+Result<> GaEndCommandList(gaCommandList* list);
+
+// Runs the lists on the queue, in order, as one batch. All of them must be ended, from this frame,
+// and not submitted before. Submits from one thread at a time.
+Result<> GaSubmit(gaDevice* device, gaQueueType queue, ArrayView<gaCommandList* const> lists);
+
+Result<gaSkinningPass*> GaCreateSkinningPass(const gaSkinningPassCreateInfo& createInfo);
+void GaDestroySkinningPass(gaSkinningPass* pass);
+
+// One gaSkinVertex per vertex. Waits for the copy to finish, so it's for load time.
+Result<> GaUploadSkinVertices(gaSkinningPass* pass, ArrayView<const gaSkinVertex> vertices);
+
+// Skins the first palettes.Size() / (jointCount * kGaSkinningPaletteFloats) instances, instance
+// i with the jointCount palette entries from i * jointCount * kGaSkinningPaletteFloats. It's
+// queued on the device's graphics queue, so draws submitted after it read this frame's vertices.
+// The palettes are copied; a pass keeps up to 3 frames of them in flight and waits for the
+// oldest beyond that.
+Result<> GaDispatchSkinning(gaSkinningPass* pass, ArrayView<const float> palettes);
+
+// Draws up to maxDraws indexed draws, their gaDrawIndexedArguments packed from argumentOffset in
+// arguments, with the pipeline and buffers bound on the list. With a count buffer, the uint32 at
+// countOffset in it caps them. Buffers are ID3D12Resource* or VkBuffer, in IndirectArgument
+// (which buffers in Common promote to on DX12). ExecuteIndirect on DX12, and
+// vkCmdDrawIndexedIndirectCount on Vulkan. More than one draw, or a count, needs
+// gaDevice::drawIndirectCount.
+Result<> GaCmdDrawIndexedIndirect(gaCommandList* list,
+                                  void* arguments,
+                                  uint64 argumentOffset,
+                                  uint32 maxDraws,
+                                  void* count = nullptr,
+                                  uint64 countOffset = 0);
+
+Result<gaCullingPass*> GaCreateCullingPass(const gaCullingPassCreateInfo& createInfo);
+void GaDestroyCullingPass(gaCullingPass* pass);
+
+// One gaCullInstance per instance of the pass. Waits for the copy to finish, so it's for load
+// time; instances that move upload again.
+Result<> GaUploadCullInstances(gaCullingPass* pass, ArrayView<const gaCullInstance> instances);
+
+// Culls every instance against the view into arguments and count. It's queued on the device's
+// graphics queue, so draws submitted after it read this frame's, and lists submitted before
+// have written the depth. One thread group per 64 instances. Every instance counts as hidden
+// until a Disoccluded phase has seen it, so the first frame's LastVisible draws nothing.
+Result<> GaDispatchCulling(gaCullingPass* pass, const gaCullView& view);
+
+Result<gaLightBinningPass*> GaCreateLightBinningPass(
+    const gaLightBinningPassCreateInfo& createInfo);
+void GaDestroyLightBinningPass(gaLightBinningPass* pass);
+
+// Bins up to maxLights lights for the view into clusters, and sets grid. It's queued on the
+// device's graphics queue, so draws submitted after it read this frame's lists, and ones
+// submitted before have finished with the last frame's. The lights are copied; a pass keeps up
+// to 3 frames of them in flight and waits for the oldest beyond that.
+Result<> GaDispatchLightBinning(gaLightBinningPass* pass,
+                                ArrayView<const gaPunctualLight> lights,
+                                const gaLightBinningView& view);
+
+// HLSL source for forward material shaders to include: PunctualLight and ClusterGrid, matching
+// gaPunctualLight and gaClusterGrid, the cluster lookups, and SamplePunctualLight, a light's
+// direction and radiance at a point by KHR_lights_punctual's falloffs.
+extern const char kGaClusteredLightingShader[];
+
+// Output size over render size per axis, 1 for Native
+float GaUpscaleRatio(gaUpscaleQuality quality);
+
+// NotFound for a vendor's upscaler this build doesn't have, with the text saying why
+Result<gaUpscaler*> GaCreateUpscaler(const gaUpscalerCreateInfo& createInfo);
+void GaDestroyUpscaler(gaUpscaler* upscaler);
+
+// Frame's jitter in render pixels, -0.5 to 0.5 each way: the Halton (2, 3) sequence, restarting
+// every jitterPhaseCount frames
+void GaUpscalerJitter(const gaUpscaler* upscaler, uint64 frame, float jitter[2]);
+
+// Upscales the frame's color into output. It's queued on the device's graphics queue, so lists
+// submitted before have rendered the inputs, and ones after see the output. The upscaler keeps
+// its history between calls, and up to 3 frames in flight, waiting for the oldest beyond that.
+Result<> GaDispatchUpscale(gaUpscaler* upscaler, const gaUpscaleInputs& inputs);
+
+// Mips a width x height mip 0 has down to 1x1, itself included
+uint32 GaMipCount(uint32 width, uint32 height);
+
+Result<gaMipGenerationPass*> GaCreateMipGenerationPass(
+    const gaMipGenerationPassCreateInfo& createInfo);
+void GaDestroyMipGenerationPass(gaMipGenerationPass* pass);
+
+// Makes mips 1 onwards of the target from its mip 0. It's queued on the device's graphics queue,
+// so lists submitted before have written mip 0 and ones after sample the mips. A pass keeps up to
+// 3 textures in flight and waits for the oldest beyond that.
+Result<> GaGenerateMips(gaMipGenerationPass* pass, const gaMipGenerationTarget& target);
+
+// Mesh shaders. On devices with gaDevice::meshShaders, meshes are drawn straight from the
+// meshlets rsbl-asset cooks: the Meshlets, MeshletVertices and MeshletTriangles sections upload
+// as they are, and a mesh pipeline's shaders read them through the bindless heap. Culling moves
+// to the amplification shader, per meshlet rather than per instance. kGaMeshletCullingShader is
+// one that tests each meshlet's bounding sphere against the view frustum and its normal cone
+// against the camera, before any of its vertices are read, and launches a mesh shader group for
+// each that survives:
+//
+//     ... compile kGaMeshletCullingShader as ShaderStage::Amplification, with a mesh shader ...
+//     ... record a list on the graphics queue, binding the pipeline and the bindless heap ...
+//     GaCmdPushConstants(list, pipeline, 0, &constants, sizeof(gaMeshletCullConstants));
+//     GaCmdDispatchMesh(list, (submesh.meshletCount + 31) / 32, 1, 1);
+//
+// Devices without mesh shaders draw the same meshes with vertex shaders and the cooked index
+// buffers, culled per instance by a culling pass.
+
+// Meshlets kGaMeshletCullingShader culls per thread group
+constexpr uint32 kGaMeshletCullingGroupSize = 32;
+
+// kGaMeshletCullingShader's push constants. The mesh shader gets them too, and a payload of
+// struct { uint meshlets[kGaMeshletCullingGroupSize]; }, the indices of the meshlets that
+// survived: mesh shader group g draws meshlet payload.meshlets[g].
+struct gaMeshletCullConstants
+{
+    // The view's planes (see gaCullView) and camera position in the mesh's own space, where the
+    // meshlets' bounds are: each plane as a row vector times the instance's world matrix, and
+    // the position through its inverse. Holds for uniform scale.
+    float frustum[6][4];
+    float cameraPosition[3];
+    uint32 meshlets;     // Bindless index of the mesh's CookedMeshlets, as a structured buffer
+    uint32 firstMeshlet; // The submesh's meshletOffset
+    uint32 meshletCount;
+    uint32 user[2]; // For the mesh shader, say the bindless index of the instance's data
+};
+
+static_assert(sizeof(gaMeshletCullConstants) == kGaMaxPushConstantBytes,
+              "gaMeshletCullConstants fills the push constants");
+
+// HLSL source of the amplification shader, for rsbl-asset's shader compiler or any other DXC.
+// Its pipeline needs the cache's bindless heap and pushConstantBytes of
+// sizeof(gaMeshletCullConstants).
+extern const char kGaMeshletCullingShader[];
+
+// Launches groupsX * groupsY * groupsZ amplification shader groups, or mesh shader groups for
+// pipelines without one, with the mesh pipeline bound on the list. DispatchMesh on DX12 and
+// vkCmdDrawMeshTasksEXT on Vulkan. Needs gaDevice::meshShaders.
+Result<> GaCmdDispatchMesh(gaCommandList* list, uint32 groupsX, uint32 groupsY, uint32 groupsZ);
+
+// Command bundles. Most of a scene never changes, so rather than recording its draws into every
+// frame's list, they're recorded into a bundle once and the frame's list replays them with one
+// call. A D3D12 bundle on DX12, a secondary command buffer on Vulkan:
+//
+//     gaCommandList* recording = GaBeginCommandBundle(bundle).Value();
+//     ... bind the pipeline and bindless heap, push constants ...
+//     GaCmdDrawIndexedIndirect(recording, arguments, 0, drawCount, nullptr, 0);
+//     GaEndCommandBundle(bundle);
+//
+//     ... each frame, in the list's render pass ...
+//     GaCmdExecuteBundle(list, bundle);
+//
+// Bundles hold draws and what they bind: GaCmdDrawIndexedIndirect, GaCmdDispatchMesh and
+// GaBindBindlessHeap, no barriers, copies or timestamps. A DX12 bundle starts with no pipeline
+// and inherits the list's descriptor heaps and root arguments. On Vulkan, the list's
+// vkCmdBeginRendering needs VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT and the bundle's
+// formats.
+
+struct gaCommandBundleCreateInfo
+{
+    gaDevice* device;
+    // The render targets the bundle's draws go to, as in gaGraphicsPipelineDesc
+    ArrayView<const gaFormat> renderTargetFormats;
+    gaFormat depthFormat = gaFormat::Unknown;
+};
+
+struct gaCommandBundle
+{
+    gaBackend backend;
+    void* internalHandle; // A bundle ID3D12GraphicsCommandList* or a secondary VkCommandBuffer
+    gaDevice* device;
+    bool recorded; // Ended, and replayable until it's begun again
+
+    virtual ~gaCommandBundle() = default;
+};
+
+// Destroying a bundle, or beginning it again, while frames that replayed it are running is
+// an error: GaDeferDestroy it, or swap between two.
+Result<gaCommandBundle*> GaCreateCommandBundle(const gaCommandBundleCreateInfo& createInfo);
+void GaDestroyCommandBundle(gaCommandBundle* bundle);
+
+// Starts the bundle over, returning a graphics list recording into it, until GaEndCommandBundle.
+// One thread at a time.
+Result<gaCommandList*> GaBeginCommandBundle(gaCommandBundle* bundle);
+Result<> GaEndCommandBundle(gaCommandBundle* bundle);
+
+// Replays a recorded bundle in a graphics list. ExecuteBundle on DX12, vkCmdExecuteCommands on
+// Vulkan.
+Result<> GaCmdExecuteBundle(gaCommandList* list, gaCommandBundle* bundle);
+
+// Variable rate shading. A pixel shader invocation can shade a block of up to 4x4 pixels where
+// the detail wouldn't be seen anyway: flat areas, fast motion. The rate is set per draw, and a
+// rate image, a texel per gaDevice::shadingRateTileSize pixels a side, coarsens it further
+// across the screen: the coarser of the two is used. kGaShadingRateShader makes the image from
+// last frame's color and motion vectors:
+//
+//     ... dispatch kGaShadingRateShader, a group per tile, into the rate image ...
+//     ... barrier the rate image from UnorderedAccess to ShadingRateSource ...
+//     GaCmdSetShadingRate(list, gaShadingRate::Rate1x1, rateImage);
+//     ... draw the scene ...
+//     GaCmdSetShadingRate(list, gaShadingRate::Rate1x1, nullptr); // The UI at full rate
+//
+// Rate images are R8_UINT, each texel a gaShadingRate. DX12 binds them on the list; Vulkan
+// reads them as an attachment of the render pass, the app's VkRenderingInfo chaining a
+// VkRenderingFragmentShadingRateAttachmentInfoKHR with the image and shadingRateTileSize.
+// Needs gaDevice::variableRateShading.
+
+// The same bits on both APIs, in rate images too: log2 of the width in bits 2-3 and of the
+// height in bits 0-1
+enum class gaShadingRate : uint8
+{
+    Rate1x1 = 0x0,
+    Rate1x2 = 0x1,
+    Rate2x1 = 0x4,
+    Rate2x2 = 0x5,
+    Rate2x4 = 0x6, // The three 4s need gaDevice::largeShadingRates
+    Rate4x2 = 0x9,
+    Rate4x4 = 0xa,
+};
+
+// Sets the rate the list's following draws shade at, with the rate image in
+// gaResourceState::ShadingRateSource coarsening it, or at just the rate for a null image.
+// RSSetShadingRate and RSSetShadingRateImage on DX12, vkCmdSetFragmentShadingRateKHR on Vulkan,
+// where the image is the render pass's attachment and null only stops it being combined in.
+// Not for bundles, which draw at the rate of the list that replays them.
+Result<> GaCmdSetShadingRate(gaCommandList* list, gaShadingRate rate, void* rateImage);
+
+// Threads kGaShadingRateShader runs for a tile, in each direction; each covers
+// (shadingRateTileSize / 8)^2 of its pixels
+constexpr uint32 kGaShadingRateGroupSize = 8;
+
+// kGaShadingRateShader's push constants
+struct gaShadingRateConstants
+{
+    uint32 color;    // Bindless index of last frame's tone-mapped color, a Texture2D<float4>
+    uint32 velocity; // Of its motion vectors in pixels, a Texture2D<float2>, or ~0u for none
+    uint32 rates;    // Of the rate image, an RWTexture2D<uint>
+    uint32 width;    // The color's, in pixels
+    uint32 height;
+    uint32 tileSize; // gaDevice::shadingRateTileSize
+    uint32 maxRate;  // 4 with gaDevice::largeShadingRates, otherwise 2
+    // Luma difference between neighbouring pixels below which shading them as one isn't seen,
+    // a quarter of it for four as one. Around 0.02 on tone-mapped color.
+    float threshold;
+    // How much motion hides: the threshold grows by this much per pixel the tile moved
+    float velocityScale;
+};
+
+// HLSL source of the compute shader, for rsbl-asset's shader compiler or any other DXC. Its
+// pipeline needs the cache's bindless heap and pushConstantBytes of
+// sizeof(gaShadingRateConstants), dispatched with a group per rate image texel.
+extern const char kGaShadingRateShader[];
+
+// Reserved resources. A reserved resource has addresses but no memory of its own; memory is mapped
+// into it a 64 KB tile at a time, from the heaps of a tile pool. Streamed textures commit the
+// tiles of a mip that are needed rather than the whole mip, and streamed buffers the pages in use.
+// CreateReservedResource and UpdateTileMappings on DX12, sparse residency and vkQueueBindSparse
+// on Vulkan. Needs gaDevice::reservedResources.
+//
+//     gaTile tile = GaAllocateTile(pool).Value();
+//     gaTileMapping mapping = {texture, {mip, x, y}, tile};
+//     GaUpdateTileMappings(device, ArrayView<const gaTileMapping>(&mapping, 1));
+//     ... upload the tile's texels, then sample them ...
+//
+// Mappings change on the graphics queue, after everything submitted to it before and before
+// anything after, so a tile can be unmapped, freed and mapped elsewhere straight away as long as
+// only the graphics queue used it. Unmapped tiles read as zero, or on Vulkan devices without
+// residencyNonResidentStrict as anything; shaders shouldn't sample them.
+//
+// Textures tile in the standard shapes: 128x128 texels for 4 byte formats down to 64x64 for 16.
+// Mips smaller than a tile are packed together into the mip tail, mapped as a whole.
+
+constexpr uint64 kGaTileSize = 64 * 1024;
+
+struct gaReservedResourceCreateInfo
+{
+    gaDevice* device;
+    uint64 size = 0; // For a buffer, rounded up to whole tiles. 0 for a texture.
+    // For a 2D texture. Colour formats other than R32G32B32Float.
+    uint32 width = 0;
+    uint32 height = 0;
+    uint32 mips = 1;
+    gaFormat format = gaFormat::Unknown;
+};
+
+struct gaReservedResource
+{
+    gaBackend backend;
+    void* internalHandle; // ID3D12Resource*, or a VkBuffer or VkImage
+    gaDevice* device;
+    bool texture;
+    // As created. A buffer is a row of tiles: width is its tile count, height and mips 1.
+    uint32 width;
+    uint32 height;
+    uint32 mips;
+    // Texels a tile covers. A buffer's tiles are kGaTileSize bytes in a row.
+    uint32 tileWidth;
+    uint32 tileHeight;
+    uint32 standardMips; // Mips tiled on their own, the rest are in the mip tail
+    uint32 mipTailTiles;
+    uint32 tileCount; // In all
+
+    virtual ~gaReservedResource() = default;
+};
+
+// A tile of a reserved resource: a buffer's is x tiles in, a texture's is x, y tiles into mip,
+// and the mip tail's is mip standardMips and x tiles into it
+struct gaTileCoordinate
+{
+    uint32 mip;
+    uint32 x;
+    uint32 y;
+};
+
+struct gaTilePoolCreateInfo
+{
+    gaDevice* device;
+    uint32 tilesPerHeap = 256; // 16 MB heaps
+    // On DX12 resource heap tier 1 a heap holds buffers or textures, not both
+    bool textures = true;
+};
+
+struct gaTilePool
+{
+    gaDevice* device;
+    uint32 tilesPerHeap;
+    uint32 heaps;
+    uint32 allocatedTiles;
+
+    virtual ~gaTilePool() = default;
+};
+
+// A tile of memory, index * kGaTileSize into heap
+struct gaTile
+{
+    gaMemoryHeap* heap;
+    uint32 index;
+};
+
+// Maps tile of resource to memory, or unmaps it when memory.heap is null
+struct gaTileMapping
+{
+    gaReservedResource* resource;
+    gaTileCoordinate tile;
+    gaTile memory;
+};
+
+Result<gaReservedResource*> GaCreateReservedResource(
+    const gaReservedResourceCreateInfo& createInfo);
+void GaDestroyReservedResource(gaReservedResource* resource);
+
+// The heaps go with the pool, so it outlives what's mapped to its tiles
+Result<gaTilePool*> GaCreateTilePool(const gaTilePoolCreateInfo& createInfo);
+void GaDestroyTilePool(gaTilePool* pool);
+
+// A free tile, from a new heap when the pool's heaps are full. Heaps stay until the pool goes.
+Result<gaTile> GaAllocateTile(gaTilePool* pool);
+void GaFreeTile(gaTilePool* pool, const gaTile& tile);
+
+// Consecutive mappings of the same resource and heap go to the driver together
+Result<> GaUpdateTileMappings(gaDevice* device, ArrayView<const gaTileMapping> mappings);
+
+// The null backend's recording, for benchmarking and testing the CPU side on machines without
+// a GPU. Stats count what was submitted since the device was created or the stats reset; lists
+// that are never submitted don't count. Commands are kept per list, in the order they were
+// recorded, until the list's frame comes round again.
+
+enum class gaNullCommandType : uint8
+{
+    Barriers,
+    CopyBuffer,
+    Upload,   // A copy out of an upload ring, recorded by GaFlushUploads
+    Readback, // A copy into a readback ring, recorded by GaFlushReadbacks
+    DrawIndexedIndirect,
+    DispatchMesh,
+    WriteTimestamp,
+    ResolveTimestamps,
+    BindBindlessHeap,
+    ExecuteBundle,
+    PushConstants,
+    SetShadingRate,
+    WriteBreadcrumb,
+};
+
+struct gaNullCommand
+{
+    gaNullCommandType type;
+    // Barriers, maxDraws, mesh groups, timestamps resolved, bundle commands, the
+    // gaShadingRate or the breadcrumb's marker
+    uint32 count;
+    uint64 bytes; // Copied, uploaded, read back or pushed, or the breadcrumb's slot
+    // The copy's destination, the readback's source, the draws' arguments, the heap, the bundle,
+    // the rate image or the breadcrumbs
+    void* resource;
+};
+
+struct gaNullStats
+{
+    uint64 submits; // GaSubmit calls with lists in them
+    uint64 commandLists;
+    uint64 commands;
+    uint64 barriers;
+    uint64 draws; // Indirect draws count maxDraws each, as though the GPU drew them all
+    uint64 meshGroups;
+    uint64 copies;
+    uint64 copyBytes;
+    uint64 uploads;
+    uint64 uploadBytes;
+    uint64 readbacks;
+    uint64 readbackBytes;
+    uint64 timestamps;
+};
+
+// InvalidArgument for devices on other backends. All zero in Discard mode.
+Result<gaNullStats> GaGetNullStats(gaDevice* device);
+void GaResetNullStats(gaDevice* device);
+
+// The list's commands, in Record mode. Empty in the other modes.
+Result<ArrayView<const gaNullCommand>> GaGetNullCommands(const gaCommandList* list);
 
 } // namespace rsbl
\ No newline at end of file
@@ -13,6 +13,38 @@ namespace rsbl
 namespace backend
 {
 
+    // Devices keep command allocators, frame fences and so on per queue, indexed by gaQueueType
+    constexpr uint32 kQueueTypes = static_cast<uint32>(gaQueueType::Count);
+
+    // The index of the adapter createInfo asks for, as gaDeviceCreateInfo describes. ~0 when
+    // there are none, or createInfo.adapter isn't one of them.
+    uint32 SelectAdapter(ArrayView<const gaAdapterInfo> adapters,
+                         const gaDeviceCreateInfo& createInfo);
+
+    // A bundle and the list recording into it, which the dispatcher fills in like any other list
+    struct CommandBundle : public gaCommandBundle
+    {
+        gaCommandList* list = nullptr; // Owned by the bundle
+    };
+
+    // Called with the create info checked
+    Result<CommandBundle*> CreateNullCommandBundle(const gaCommandBundleCreateInfo& createInfo);
+    Result<CommandBundle*> CreateDX12CommandBundle(const gaCommandBundleCreateInfo& createInfo);
+    Result<CommandBundle*> CreateVulkanCommandBundle(const gaCommandBundleCreateInfo& createInfo);
+
+    // Called with the bundle not recording. Ending is EndDX12CommandList and so on.
+    void BeginNullCommandBundle(CommandBundle* bundle);
+    Result<> BeginDX12CommandBundle(CommandBundle* bundle);
+    Result<> BeginVulkanCommandBundle(CommandBundle* bundle);
+
+    void ExecuteNullBundle(gaCommandList* list, CommandBundle* bundle);
+    void ExecuteDX12Bundle(gaCommandList* list, CommandBundle* bundle);
+    void ExecuteVulkanBundle(gaCommandList* list, CommandBundle* bundle);
+
+    // Called with the list empty
+    Result<> EnumerateDX12Adapters(DynamicArray<gaAdapterInfo>& adapters);
+    Result<> EnumerateVulkanAdapters(DynamicArray<gaAdapterInfo>& adapters);
+
     Result<gaDevice*> CreateNullDevice(const gaDeviceCreateInfo& createInfo);
     Result<gaDevice*> CreateDX12Device(const gaDeviceCreateInfo& createInfo);
     Result<gaDevice*> CreateVulkanDevice(const gaDeviceCreateInfo& createInfo);
@@ -21,5 +53,472 @@ namespace backend
     Result<gaSwapchain*> CreateDX12Swapchain(const gaSwapchainCreateInfo& createInfo);
     Result<gaSwapchain*> CreateVulkanSwapchain(const gaSwapchainCreateInfo& createInfo);
 
+    Result<> WaitForDX12Swapchain(gaSwapchain* swapchain, uint32 timeoutMs);
+    Result<> WaitForVulkanSwapchain(gaSwapchain* swapchain, uint32 timeoutMs);
+
+    Result<> PresentNull(gaSwapchain* swapchain);
+    Result<> PresentDX12(gaSwapchain* swapchain);
+    Result<> PresentVulkan(gaSwapchain* swapchain);
+
+    Result<> SetDX12ExclusiveFullscreen(gaSwapchain* swapchain, bool exclusive);
+
+    // Called with presentStats.presentCount filled in
+    Result<> GetNullPresentStats(gaSwapchain* swapchain, gaPresentStats& presentStats);
+    Result<> GetDX12PresentStats(gaSwapchain* swapchain, gaPresentStats& presentStats);
+    Result<> GetVulkanPresentStats(gaSwapchain* swapchain, gaPresentStats& presentStats);
+
+    // Called with device->frame already counting the new frame
+    Result<> BeginNullFrame(gaDevice* device);
+    Result<> BeginDX12Frame(gaDevice* device);
+    Result<> BeginVulkanFrame(gaDevice* device);
+
+    Result<> WaitForDX12Idle(gaDevice* device);
+    Result<> WaitForVulkanIdle(gaDevice* device);
+
+    // GaDeferDestroy's queue. GaBeginFrame begins its frames, destroying what was deferred up to
+    // framesInFlight frames back, once it's waited for them.
+    gaDeferredDestroys* CreateDeferredDestroys();
+    void BeginDeferredFrame(gaDeferredDestroys* deferred, uint64 frame, uint32 framesInFlight);
+    void DestroyAllDeferred(gaDeferredDestroys* deferred);
+    void DestroyDeferredDestroys(gaDeferredDestroys* deferred);
+
+    // Called with the recorder and queue in range. The dispatcher fills in the list's common
+    // fields.
+    Result<gaCommandList*> BeginNullCommandList(gaDevice* device,
+                                                gaQueueType queue,
+                                                uint32 recorder);
+    Result<gaCommandList*> BeginDX12CommandList(gaDevice* device,
+                                                gaQueueType queue,
+                                                uint32 recorder);
+    Result<gaCommandList*> BeginVulkanCommandList(gaDevice* device,
+                                                  gaQueueType queue,
+                                                  uint32 recorder);
+
+    Result<> EndDX12CommandList(gaCommandList* list);
+    Result<> EndVulkanCommandList(gaCommandList* list);
+
+    // Called with every list checked as ready to submit
+    void SubmitNull(gaDevice* device, ArrayView<gaCommandList* const> lists);
+    Result<> SubmitDX12(gaDevice* device, gaQueueType queue, ArrayView<gaCommandList* const> lists);
+    Result<> SubmitVulkan(gaDevice* device,
+                          gaQueueType queue,
+                          ArrayView<gaCommandList* const> lists);
+
+    // Called in place of the real backends' recording, with the command checked
+    void RecordNullCommand(gaCommandList* list, const gaNullCommand& command);
+
+    // Called with a checked, non-empty batch
+    void RecordDX12Barriers(gaCommandList* list, ArrayView<const gaBarrier> barriers);
+    void RecordVulkanBarriers(gaCommandList* list, ArrayView<const gaBarrier> barriers);
+
+    // count timestamp queries for one queue, and on DX12 the readback buffer they resolve to
+    struct TimestampHeap
+    {
+        void* handle = nullptr; // ID3D12QueryHeap* or VkQueryPool
+        uint64 frequency = 0;   // Ticks a second
+
+        virtual ~TimestampHeap() = default;
+    };
+
+    Result<TimestampHeap*> CreateNullTimestampHeap(gaDevice* device,
+                                                   gaQueueType queue,
+                                                   uint32 count);
+    Result<TimestampHeap*> CreateDX12TimestampHeap(gaDevice* device,
+                                                   gaQueueType queue,
+                                                   uint32 count);
+    Result<TimestampHeap*> CreateVulkanTimestampHeap(gaDevice* device,
+                                                     gaQueueType queue,
+                                                     uint32 count);
+
+    // Called with a recording list on the heap's queue, and indices in range
+    void WriteDX12Timestamp(gaCommandList* list, TimestampHeap* heap, uint32 index);
+    void WriteVulkanTimestamp(gaCommandList* list, TimestampHeap* heap, uint32 index);
+    void ResolveDX12Timestamps(gaCommandList* list,
+                               TimestampHeap* heap,
+                               uint32 first,
+                               uint32 count);
+
+    // Called with resolved timestamps from a frame the GPU is done with
+    Result<> ReadDX12Timestamps(TimestampHeap* heap, uint32 first, uint32 count, uint64* out);
+    Result<> ReadVulkanTimestamps(TimestampHeap* heap, uint32 first, uint32 count, uint64* out);
+
+    // Called with every timestamp a frame the GPU is done with wrote, for the next to write again
+    void ResetVulkanTimestamps(TimestampHeap* heap, uint32 first, uint32 count);
+
+    // The slots, mapped from creation to destruction so they can be read after a loss too
+    struct Breadcrumbs : public gaBreadcrumbs
+    {
+        volatile uint32* markers = nullptr;
+    };
+
+    // Called with slots greater than zero. The markers start at zero.
+    Result<Breadcrumbs*> CreateNullBreadcrumbs(gaDevice* device, uint32 slots);
+    Result<Breadcrumbs*> CreateDX12Breadcrumbs(gaDevice* device, uint32 slots);
+    Result<Breadcrumbs*> CreateVulkanBreadcrumbs(gaDevice* device, uint32 slots);
+
+    // Called with a recording list that isn't a bundle, and the slot in range
+    void WriteDX12Breadcrumb(gaCommandList* list,
+                             Breadcrumbs* breadcrumbs,
+                             uint32 slot,
+                             uint32 marker);
+    void WriteVulkanBreadcrumb(gaCommandList* list,
+                               Breadcrumbs* breadcrumbs,
+                               uint32 slot,
+                               uint32 marker);
+
+    Result<> ReportDX12DeviceLost(gaDevice* device);
+
+    // Called with a graphics or compute queue
+    Result<gaClockCalibration> GetDX12ClockCalibration(gaDevice* device, gaQueueType queue);
+    Result<gaClockCalibration> GetVulkanClockCalibration(gaDevice* device, gaQueueType queue);
+
+    // Called with a recording list
+    void RecordDX12BufferCopy(gaCommandList* list,
+                              void* destination,
+                              uint64 destinationOffset,
+                              void* source,
+                              uint64 sourceOffset,
+                              uint64 size);
+    void RecordVulkanBufferCopy(gaCommandList* list,
+                                void* destination,
+                                uint64 destinationOffset,
+                                void* source,
+                                uint64 sourceOffset,
+                                uint64 size);
+    void RecordDX12IndirectDraws(gaCommandList* list,
+                                 void* arguments,
+                                 uint64 argumentOffset,
+                                 uint32 maxDraws,
+                                 void* count,
+                                 uint64 countOffset);
+    void RecordVulkanIndirectDraws(gaCommandList* list,
+                                   void* arguments,
+                                   uint64 argumentOffset,
+                                   uint32 maxDraws,
+                                   void* count,
+                                   uint64 countOffset);
+    void RecordDX12MeshDispatch(gaCommandList* list,
+                                uint32 groupsX,
+                                uint32 groupsY,
+                                uint32 groupsZ);
+    void RecordVulkanMeshDispatch(gaCommandList* list,
+                                  uint32 groupsX,
+                                  uint32 groupsY,
+                                  uint32 groupsZ);
+    // offset and size in bytes, checked against the pipeline's layout
+    void RecordDX12PushConstants(gaCommandList* list,
+                                 const gaPipeline* pipeline,
+                                 uint32 offset,
+                                 uint32 size,
+                                 const void* data);
+    void RecordVulkanPushConstants(gaCommandList* list,
+                                   const gaPipeline* pipeline,
+                                   uint32 offset,
+                                   uint32 size,
+                                   const void* data);
+    void RecordDX12ShadingRate(gaCommandList* list, gaShadingRate rate, void* rateImage);
+    void RecordVulkanShadingRate(gaCommandList* list, gaShadingRate rate, void* rateImage);
+
+    // Called with two devices of the backend. The dispatcher links the fences.
+    Result<gaSharedBuffer*> CreateNullSharedBuffer(const gaSharedBufferCreateInfo& createInfo);
+    Result<gaSharedBuffer*> CreateDX12SharedBuffer(const gaSharedBufferCreateInfo& createInfo);
+
+    Result<gaFence*> CreateNullFence(gaDevice* device, uint64 initialValue);
+    Result<gaFence*> CreateDX12Fence(gaDevice* device, uint64 initialValue);
+    Result<gaFence*> CreateVulkanFence(gaDevice* device, uint64 initialValue);
+
+    // Called with value above the fence's signalledValue
+    Result<> SignalDX12Fence(gaDevice* device, gaQueueType queue, gaFence* fence, uint64 value);
+    Result<> SignalVulkanFence(gaDevice* device, gaQueueType queue, gaFence* fence, uint64 value);
+
+    // Called with value already signalled
+    Result<> QueueWaitForDX12Fence(gaDevice* device,
+                                   gaQueueType queue,
+                                   gaFence* fence,
+                                   uint64 value);
+    Result<> QueueWaitForVulkanFence(gaDevice* device,
+                                     gaQueueType queue,
+                                     gaFence* fence,
+                                     uint64 value);
+
+    uint64 GetDX12FenceValue(gaFence* fence);
+    uint64 GetVulkanFenceValue(gaFence* fence);
+
+    Result<> WaitForDX12Fence(gaFence* fence, uint64 value);
+    Result<> WaitForVulkanFence(gaFence* fence, uint64 value);
+
+    // Called with size a multiple of alignment, which is 64KB or more. The dispatcher fills in the
+    // heap's common fields.
+    Result<gaMemoryHeap*> CreateNullMemoryHeap(gaDevice* device,
+                                               gaMemoryType type,
+                                               uint64 size,
+                                               uint64 alignment);
+    Result<gaMemoryHeap*> CreateDX12MemoryHeap(gaDevice* device,
+                                               gaMemoryType type,
+                                               uint64 size,
+                                               uint64 alignment);
+    Result<gaMemoryHeap*> CreateVulkanMemoryHeap(gaDevice* device,
+                                                 gaMemoryType type,
+                                                 uint64 size,
+                                                 uint64 alignment);
+
+    // Device-local and kGaTileSize aligned, on resource heap tier 1 for textures or for buffers
+    Result<gaMemoryHeap*> CreateDX12TileHeap(gaDevice* device, uint64 size, bool textures);
+
+    // Texels a tile covers in the format's standard 2D shape, false for formats with none
+    bool StandardTileShape(gaFormat format, uint32& width, uint32& height);
+
+    // Called with the create info checked. The backend fills in the tiling, the dispatcher the
+    // rest.
+    Result<gaReservedResource*> CreateNullReservedResource(
+        const gaReservedResourceCreateInfo& createInfo);
+    Result<gaReservedResource*> CreateDX12ReservedResource(
+        const gaReservedResourceCreateInfo& createInfo);
+    Result<gaReservedResource*> CreateVulkanReservedResource(
+        const gaReservedResourceCreateInfo& createInfo);
+
+    // Called with every mapping checked, and at least one
+    Result<> UpdateDX12TileMappings(gaDevice* device, ArrayView<const gaTileMapping> mappings);
+    Result<> UpdateVulkanTileMappings(gaDevice* device, ArrayView<const gaTileMapping> mappings);
+
+    Result<gaMemoryBudget> QueryDX12MemoryBudget(gaDevice* device);
+    Result<gaMemoryBudget> QueryVulkanMemoryBudget(gaDevice* device);
+
+    // A persistently mapped upload buffer, the upload ring's memory
+    struct UploadBuffer
+    {
+        void* handle = nullptr; // ID3D12Resource* or VkBuffer
+        uint8* data = nullptr;
+
+        virtual ~UploadBuffer() = default;
+    };
+
+    struct BufferCopy
+    {
+        void* destination;
+        uint64 destinationOffset;
+        uint64 sourceOffset;
+        uint64 size;
+    };
+
+    Result<UploadBuffer*> CreateNullUploadBuffer(gaDevice* device, uint64 size);
+    Result<UploadBuffer*> CreateDX12UploadBuffer(gaDevice* device, uint64 size);
+    Result<UploadBuffer*> CreateVulkanUploadBuffer(gaDevice* device, uint64 size);
+
+    // Called with a recording list and at least one copy
+    void RecordDX12BufferCopies(gaCommandList* list,
+                                UploadBuffer* source,
+                                ArrayView<const BufferCopy> copies);
+    void RecordVulkanBufferCopies(gaCommandList* list,
+                                  UploadBuffer* source,
+                                  ArrayView<const BufferCopy> copies);
+
+    // A persistently mapped readback buffer, the readback ring's memory
+    struct ReadbackBuffer
+    {
+        void* handle = nullptr; // ID3D12Resource* or VkBuffer
+        const uint8* data = nullptr;
+
+        virtual ~ReadbackBuffer() = default;
+    };
+
+    // Into the readback buffer at destinationOffset. A texture copy when width isn't 0: its mip
+    // 0 of layer 0, rows rowPitch apart (a multiple of 256 and the texel size), at an offset
+    // aligned to 512, in CopySource by the time it runs.
+    struct ReadbackCopy
+    {
+        void* source;
+        uint64 sourceOffset; // Buffers only
+        uint64 destinationOffset;
+        uint64 size;
+        gaFormat format;
+        uint32 width;
+        uint32 height;
+        uint32 rowPitch;
+        uint32 texelSize;
+    };
+
+    Result<ReadbackBuffer*> CreateNullReadbackBuffer(gaDevice* device, uint64 size);
+    Result<ReadbackBuffer*> CreateDX12ReadbackBuffer(gaDevice* device, uint64 size);
+    Result<ReadbackBuffer*> CreateVulkanReadbackBuffer(gaDevice* device, uint64 size);
+
+    // Called with a recording list and at least one copy
+    void RecordDX12ReadbackCopies(gaCommandList* list,
+                                  ReadbackBuffer* destination,
+                                  ArrayView<const ReadbackCopy> copies);
+    void RecordVulkanReadbackCopies(gaCommandList* list,
+                                    ReadbackBuffer* destination,
+                                    ArrayView<const ReadbackCopy> copies);
+
+    // A bindless heap's descriptors, capacity of each kind
+    struct BindlessTable
+    {
+        void* handle = nullptr;    // ID3D12DescriptorHeap* or VkDescriptorSet
+        void* setLayout = nullptr; // VkDescriptorSetLayout
+
+        virtual ~BindlessTable() = default;
+    };
+
+    // Called with the samplers checked and distinct
+    Result<BindlessTable*> CreateNullBindlessTable(gaDevice* device,
+                                                   uint32 capacity,
+                                                   ArrayView<const gaSamplerDesc> samplers);
+    Result<BindlessTable*> CreateDX12BindlessTable(gaDevice* device,
+                                                   uint32 capacity,
+                                                   ArrayView<const gaSamplerDesc> samplers);
+    Result<BindlessTable*> CreateVulkanBindlessTable(gaDevice* device,
+                                                     uint32 capacity,
+                                                     ArrayView<const gaSamplerDesc> samplers);
+
+    // Called with index below the capacity and the view checked
+    void WriteDX12BindlessDescriptor(gaDevice* device,
+                                     BindlessTable* table,
+                                     uint32 index,
+                                     const gaBindlessView& view);
+    void WriteVulkanBindlessDescriptor(gaDevice* device,
+                                       BindlessTable* table,
+                                       uint32 index,
+                                       const gaBindlessView& view);
+
+    // Called with a recording graphics or compute list
+    void BindDX12BindlessTable(gaCommandList* list, BindlessTable* table);
+    void BindVulkanBindlessTable(gaCommandList* list, BindlessTable* table, void* pipelineLayout);
+
+    // A CPU-only descriptor heap, count descriptors increment bytes apart from start
+    struct DescriptorPage
+    {
+        void* handle = nullptr; // ID3D12DescriptorHeap*
+        uint64 start = 0;
+        uint32 increment = 0;
+
+        virtual ~DescriptorPage() = default;
+    };
+
+    Result<DescriptorPage*> CreateNullDescriptorPage(gaDevice* device,
+                                                     gaDescriptorType type,
+                                                     uint32 count);
+    Result<DescriptorPage*> CreateDX12DescriptorPage(gaDevice* device,
+                                                     gaDescriptorType type,
+                                                     uint32 count);
+
+    // The driver's pipeline cache. data is from an earlier run and may be stale, in which case
+    // the library starts empty rather than failing.
+    struct PipelineLibrary
+    {
+        void* handle = nullptr; // ID3D12PipelineLibrary* or VkPipelineCache
+
+        virtual ~PipelineLibrary() = default;
+    };
+
+    // A root signature or pipeline layout, shared by the pipelines with the same push constants
+    struct PipelineLayout
+    {
+        void* handle = nullptr; // ID3D12RootSignature* or VkPipelineLayout
+
+        virtual ~PipelineLayout() = default;
+    };
+
+    Result<PipelineLibrary*> CreateNullPipelineLibrary(gaDevice* device,
+                                                       ArrayView<const uint8> data);
+    Result<PipelineLibrary*> CreateDX12PipelineLibrary(gaDevice* device,
+                                                       ArrayView<const uint8> data);
+    Result<PipelineLibrary*> CreateVulkanPipelineLibrary(gaDevice* device,
+                                                         ArrayView<const uint8> data);
+
+    // Appends the library's data
+    Result<> SerializeDX12PipelineLibrary(PipelineLibrary* library, DynamicArray<uint8>& data);
+    Result<> SerializeVulkanPipelineLibrary(gaDevice* device,
+                                            PipelineLibrary* library,
+                                            DynamicArray<uint8>& data);
+
+    // bindless is null for layouts without a bindless heap
+    Result<PipelineLayout*> CreateNullPipelineLayout(gaDevice* device,
+                                                     const gaBindlessHeap* bindless,
+                                                     bool compute,
+                                                     uint32 pushConstantBytes);
+    Result<PipelineLayout*> CreateDX12PipelineLayout(gaDevice* device,
+                                                     const gaBindlessHeap* bindless,
+                                                     bool compute,
+                                                     uint32 pushConstantBytes);
+    Result<PipelineLayout*> CreateVulkanPipelineLayout(gaDevice* device,
+                                                       const gaBindlessHeap* bindless,
+                                                       bool compute,
+                                                       uint32 pushConstantBytes);
+
+    // Called with the description checked. The dispatcher fills in the pipeline's common fields.
+    Result<gaPipeline*> CreateNullGraphicsPipeline(gaDevice* device,
+                                                   PipelineLibrary* library,
+                                                   PipelineLayout* layout,
+                                                   uint64 key,
+                                                   const gaGraphicsPipelineDesc& desc);
+    Result<gaPipeline*> CreateDX12GraphicsPipeline(gaDevice* device,
+                                                   PipelineLibrary* library,
+                                                   PipelineLayout* layout,
+                                                   uint64 key,
+                                                   const gaGraphicsPipelineDesc& desc);
+    Result<gaPipeline*> CreateVulkanGraphicsPipeline(gaDevice* device,
+                                                     PipelineLibrary* library,
+                                                     PipelineLayout* layout,
+                                                     uint64 key,
+                                                     const gaGraphicsPipelineDesc& desc);
+
+    Result<gaPipeline*> CreateNullComputePipeline(gaDevice* device,
+                                                  PipelineLibrary* library,
+                                                  PipelineLayout* layout,
+                                                  uint64 key,
+                                                  const gaComputePipelineDesc& desc);
+    Result<gaPipeline*> CreateDX12ComputePipeline(gaDevice* device,
+                                                  PipelineLibrary* library,
+                                                  PipelineLayout* layout,
+                                                  uint64 key,
+                                                  const gaComputePipelineDesc& desc);
+    Result<gaPipeline*> CreateVulkanComputePipeline(gaDevice* device,
+                                                    PipelineLibrary* library,
+                                                    PipelineLayout* layout,
+                                                    uint64 key,
+                                                    const gaComputePipelineDesc& desc);
+
+    // Called with the create info and the arguments already checked against the pass
+    Result<gaSkinningPass*> CreateNullSkinningPass(const gaSkinningPassCreateInfo& createInfo);
+    Result<gaSkinningPass*> CreateDX12SkinningPass(const gaSkinningPassCreateInfo& createInfo);
+    Result<gaSkinningPass*> CreateVulkanSkinningPass(const gaSkinningPassCreateInfo& createInfo);
+
+    Result<> UploadDX12SkinVertices(gaSkinningPass* pass, ArrayView<const gaSkinVertex> vertices);
+    Result<> DispatchDX12Skinning(gaSkinningPass* pass, ArrayView<const float> palettes);
+
+    Result<gaCullingPass*> CreateNullCullingPass(const gaCullingPassCreateInfo& createInfo);
+    Result<gaCullingPass*> CreateDX12CullingPass(const gaCullingPassCreateInfo& createInfo);
+    Result<gaCullingPass*> CreateVulkanCullingPass(const gaCullingPassCreateInfo& createInfo);
+
+    Result<> UploadDX12CullInstances(gaCullingPass* pass,
+                                     ArrayView<const gaCullInstance> instances);
+    Result<> DispatchDX12Culling(gaCullingPass* pass, const gaCullView& view);
+
+    Result<gaLightBinningPass*> CreateNullLightBinningPass(
+        const gaLightBinningPassCreateInfo& createInfo);
+    Result<gaLightBinningPass*> CreateDX12LightBinningPass(
+        const gaLightBinningPassCreateInfo& createInfo);
+    Result<gaLightBinningPass*> CreateVulkanLightBinningPass(
+        const gaLightBinningPassCreateInfo& createInfo);
+
+    Result<> DispatchDX12LightBinning(gaLightBinningPass* pass,
+                                      ArrayView<const gaPunctualLight> lights,
+                                      const gaLightBinningView& view);
+
+    Result<gaUpscaler*> CreateNullUpscaler(const gaUpscalerCreateInfo& createInfo);
+    Result<gaUpscaler*> CreateDX12Upscaler(const gaUpscalerCreateInfo& createInfo);
+    Result<gaUpscaler*> CreateVulkanUpscaler(const gaUpscalerCreateInfo& createInfo);
+
+    Result<> DispatchDX12Upscale(gaUpscaler* upscaler, const gaUpscaleInputs& inputs);
+
+    Result<gaMipGenerationPass*> CreateNullMipGenerationPass(
+        const gaMipGenerationPassCreateInfo& createInfo);
+    Result<gaMipGenerationPass*> CreateDX12MipGenerationPass(
+        const gaMipGenerationPassCreateInfo& createInfo);
+    Result<gaMipGenerationPass*> CreateVulkanMipGenerationPass(
+        const gaMipGenerationPassCreateInfo& createInfo);
+
+    Result<> GenerateDX12Mips(gaMipGenerationPass* pass, const gaMipGenerationTarget& target);
+
 } // namespace backend
 } // namespace rsbl
@@ -0,0 +1,293 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-hash-map.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+namespace rsbl
+{
+
+namespace
+{
+// Barriers that mean nothing, or that can't be split
+bool IsValidBarrier(const gaBarrier& barrier)
+{
+    if (barrier.resource == nullptr || barrier.before >= gaResourceState::Count ||
+        barrier.after >= gaResourceState::Count)
+    {
+        return false;
+    }
+
+    const bool transition = barrier.before != barrier.after;
+    if (barrier.split != gaBarrierSplit::None)
+    {
+        return transition && !barrier.discard;
+    }
+
+    // Keeping the state is a UAV barrier, or an aliasing one
+    return transition || barrier.discard || barrier.after == gaResourceState::UnorderedAccess;
+}
+
+struct TrackedState
+{
+    gaResourceState state; // As of the last use, queued or not
+    bool texture;
+    bool depth;
+    uint32 pending; // Its barrier in StateTracker::pending, kNotPending if it has none
+};
+
+constexpr uint32 kNotPending = ~0u;
+
+// One queued barrier a resource at most, from where it was before the batch to where it's used
+struct StateTracker : public gaStateTracker
+{
+    HashMap<void*, TrackedState> states;
+    DynamicArray<gaBarrier> pending;
+    gaCommandList* list = nullptr; // The pending barriers go in this one
+};
+
+// Used one way and then back the way it started, a resource needs nothing after all
+bool IsNeeded(const gaBarrier& barrier)
+{
+    return barrier.before != barrier.after || barrier.after == gaResourceState::UnorderedAccess;
+}
+} // namespace
+
+Result<> GaCmdBarriers(gaCommandList* list, ArrayView<const gaBarrier> barriers)
+{
+    if (list == nullptr)
+    {
+        return "Command list cannot be null";
+    }
+
+    if (!list->recording || list->queue == gaQueueType::Copy || list->bundle)
+    {
+        return "Barriers are recorded into recording graphics or compute lists, not bundles";
+    }
+
+    for (const gaBarrier& barrier : barriers)
+    {
+        if (!IsValidBarrier(barrier))
+        {
+            return {ErrorCategory::InvalidArgument,
+                    "Barriers need a resource and a change of state, and only transitions split"};
+        }
+    }
+
+    if (barriers.IsEmpty())
+    {
+        return ResultCode::Success;
+    }
+
+    switch (list->backend)
+    {
+    case gaBackend::Null:
+        backend::RecordNullCommand(
+            list, {gaNullCommandType::Barriers, static_cast<uint32>(barriers.Size()), 0, nullptr});
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        backend::RecordDX12Barriers(list, barriers);
+        return ResultCode::Success;
+
+    case gaBackend::Vulkan:
+        backend::RecordVulkanBarriers(list, barriers);
+        return ResultCode::Success;
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaStateTracker*> GaCreateStateTracker(gaDevice* device)
+{
+    if (device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    auto tracker = rsbl::UniquePtr(new StateTracker());
+    tracker->device = device;
+    tracker->resources = 0;
+    tracker->pendingBarriers = 0;
+    return tracker.Release();
+}
+
+void GaDestroyStateTracker(gaStateTracker* tracker)
+{
+    delete static_cast<StateTracker*>(tracker);
+}
+
+Result<> GaTrackResource(gaStateTracker* baseTracker, const gaTrackedResource& resource)
+{
+    if (baseTracker == nullptr || resource.resource == nullptr)
+    {
+        return "State tracker and resource cannot be null";
+    }
+
+    if (resource.state >= gaResourceState::Count)
+    {
+        return {ErrorCategory::InvalidArgument, "Unknown resource state"};
+    }
+
+    auto tracker = static_cast<StateTracker*>(baseTracker);
+    if (tracker->states.Contains(resource.resource))
+    {
+        return {ErrorCategory::InvalidArgument, "The resource is tracked already"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    tracker->states.Emplace(
+        resource.resource,
+        TrackedState{resource.state, resource.texture, resource.depth, kNotPending});
+    ++tracker->resources;
+    return ResultCode::Success;
+}
+
+void GaUntrackResource(gaStateTracker* baseTracker, void* resource)
+{
+    if (baseTracker == nullptr)
+    {
+        return;
+    }
+
+    auto tracker = static_cast<StateTracker*>(baseTracker);
+    if (tracker->states.Remove(resource))
+    {
+        --tracker->resources;
+    }
+}
+
+Result<> GaSetTrackedState(gaStateTracker* baseTracker, void* resource, gaResourceState state)
+{
+    if (baseTracker == nullptr)
+    {
+        return "State tracker cannot be null";
+    }
+
+    if (state >= gaResourceState::Count)
+    {
+        return {ErrorCategory::InvalidArgument, "Unknown resource state"};
+    }
+
+    auto tracker = static_cast<StateTracker*>(baseTracker);
+    TrackedState* tracked = tracker->states.Find(resource);
+    if (tracked == nullptr)
+    {
+        return {ErrorCategory::NotFound, "The resource isn't tracked"};
+    }
+
+    if (tracked->pending != kNotPending)
+    {
+        return "The resource has a barrier queued, flush it first";
+    }
+    tracked->state = state;
+    return ResultCode::Success;
+}
+
+Result<> GaUse(gaCommandList* list,
+               gaStateTracker* baseTracker,
+               void* resource,
+               gaResourceState state)
+{
+    if (list == nullptr || baseTracker == nullptr)
+    {
+        return "Command list and state tracker cannot be null";
+    }
+
+    if (!list->recording || list->queue == gaQueueType::Copy || list->bundle)
+    {
+        return "Barriers are recorded into recording graphics or compute lists, not bundles";
+    }
+
+    if (state >= gaResourceState::Count)
+    {
+        return {ErrorCategory::InvalidArgument, "Unknown resource state"};
+    }
+
+    auto tracker = static_cast<StateTracker*>(baseTracker);
+    if (tracker->list != nullptr && tracker->list != list)
+    {
+        return "The tracker's queued barriers go out before it's used with another list";
+    }
+
+    if (list->stateTracker != nullptr && list->stateTracker != baseTracker)
+    {
+        return "The list's queued barriers are another tracker's";
+    }
+
+    TrackedState* tracked = tracker->states.Find(resource);
+    if (tracked == nullptr)
+    {
+        return {ErrorCategory::NotFound, "The resource isn't tracked"};
+    }
+
+    const bool unorderedAccess = state == gaResourceState::UnorderedAccess;
+    if (tracked->pending != kNotPending)
+    {
+        // Still one barrier, to wherever it's used last
+        tracker->pending[tracked->pending].after = state;
+    }
+    else if (tracked->state != state || unorderedAccess)
+    {
+        MemoryTagScope memoryScope(MemoryTag::Ga);
+
+        gaBarrier barrier = {};
+        barrier.resource = resource;
+        barrier.before = tracked->state;
+        barrier.after = state;
+        barrier.texture = tracked->texture;
+        barrier.depth = tracked->depth;
+        tracked->pending = static_cast<uint32>(tracker->pending.Size());
+        tracker->pending.PushBack(barrier);
+        tracker->pendingBarriers = static_cast<uint32>(tracker->pending.Size());
+        tracker->list = list;
+        list->stateTracker = baseTracker;
+    }
+    tracked->state = state;
+    return ResultCode::Success;
+}
+
+Result<> GaFlushBarriers(gaCommandList* list)
+{
+    if (list == nullptr)
+    {
+        return "Command list cannot be null";
+    }
+
+    if (list->stateTracker == nullptr)
+    {
+        return ResultCode::Success;
+    }
+
+    auto tracker = static_cast<StateTracker*>(list->stateTracker);
+    list->stateTracker = nullptr;
+    tracker->list = nullptr;
+
+    // Compacted in place, dropping the ones that came back to where they started
+    uint64 needed = 0;
+    for (const gaBarrier& barrier : tracker->pending)
+    {
+        if (TrackedState* tracked = tracker->states.Find(barrier.resource))
+        {
+            tracked->pending = kNotPending;
+        }
+        if (IsNeeded(barrier))
+        {
+            tracker->pending[needed++] = barrier;
+        }
+    }
+
+    Result<> recorded = GaCmdBarriers(list, {tracker->pending.Data(), needed});
+    tracker->pending.Clear();
+    tracker->pendingBarriers = 0;
+    return recorded;
+}
+
+} // namespace rsbl
@@ -0,0 +1,305 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-hash-map.h>
+#include <rsbl-hash.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+// An index the GPU may still read, free again once frame is framesInFlight frames back
+struct ReleasedIndex
+{
+    uint32 index;
+    uint64 frame;
+};
+
+struct BindlessHeap : public gaBindlessHeap
+{
+    UniquePtr<backend::BindlessTable> table;
+
+    uint32 unused = 0; // Indices from here on have never been handed out
+    DynamicArray<uint32> freeIndices;
+    // In the order they were released, so in frame order
+    DynamicArray<ReleasedIndex> released;
+    uint64 reclaimed = 0; // released before this are in freeIndices
+
+    DynamicArray<gaSamplerDesc> samplerList;
+    HashMap<uint64, uint32> samplerIndices; // SamplerKey hash to its index in samplerList
+};
+
+// The fields a sampler is made from, with the ones it ignores zeroed so equal samplers hash equal
+struct SamplerKey
+{
+    uint32 filter;
+    uint32 address[3];
+    uint32 maxAnisotropy;
+    uint32 compareOp; // One past the op, 0 when not comparing
+    uint32 mipBias;
+};
+
+SamplerKey MakeSamplerKey(const gaSamplerDesc& desc)
+{
+    SamplerKey key = {};
+    key.filter = static_cast<uint32>(desc.filter);
+    key.address[0] = static_cast<uint32>(desc.addressU);
+    key.address[1] = static_cast<uint32>(desc.addressV);
+    key.address[2] = static_cast<uint32>(desc.addressW);
+    key.maxAnisotropy = desc.filter == gaFilter::Anisotropic ? desc.maxAnisotropy : 1;
+    key.compareOp = desc.compare ? static_cast<uint32>(desc.compareOp) + 1 : 0;
+    const float mipBias = desc.mipBias == 0.0f ? 0.0f : desc.mipBias; // -0 is 0
+    std::memcpy(&key.mipBias, &mipBias, sizeof(mipBias));
+    return key;
+}
+
+uint64 HashSampler(const gaSamplerDesc& desc)
+{
+    const SamplerKey key = MakeSamplerKey(desc);
+    return HashBytes(&key, sizeof(key));
+}
+
+bool IsValidSampler(const gaSamplerDesc& desc)
+{
+    return desc.filter <= gaFilter::Anisotropic && desc.addressU <= gaAddressMode::Clamp &&
+           desc.addressV <= gaAddressMode::Clamp && desc.addressW <= gaAddressMode::Clamp &&
+           (desc.filter != gaFilter::Anisotropic ||
+            (desc.maxAnisotropy >= 1 && desc.maxAnisotropy <= 16)) &&
+           (!desc.compare || desc.compareOp <= gaCompareOp::Always);
+}
+
+// Moves indices the GPU is done with to the free list
+void ReclaimIndices(BindlessHeap* heap)
+{
+    const gaDevice* device = heap->device;
+    while (heap->reclaimed < heap->released.Size() &&
+           heap->released[heap->reclaimed].frame + device->framesInFlight <= device->frame)
+    {
+        heap->freeIndices.PushBack(heap->released[heap->reclaimed++].index);
+    }
+
+    if (heap->reclaimed == heap->released.Size())
+    {
+        heap->released.Clear();
+        heap->reclaimed = 0;
+    }
+}
+
+Result<backend::BindlessTable*> CreateBindlessTable(gaDevice* device,
+                                                    uint32 capacity,
+                                                    ArrayView<const gaSamplerDesc> samplers)
+{
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullBindlessTable(device, capacity, samplers);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12BindlessTable(device, capacity, samplers);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanBindlessTable(device, capacity, samplers);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+bool IsBufferView(gaBindlessViewType type)
+{
+    return type == gaBindlessViewType::BufferSrv || type == gaBindlessViewType::BufferUav;
+}
+} // namespace
+
+Result<gaBindlessHeap*> GaCreateBindlessHeap(const gaBindlessHeapCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (!createInfo.device->bindless)
+    {
+        return {ErrorCategory::Graphics, "The device doesn't support bindless heaps"};
+    }
+
+    if (createInfo.capacity == 0 || createInfo.capacity > kGaMaxBindlessCapacity)
+    {
+        return "Bindless heap capacity must be between 1 and kGaMaxBindlessCapacity";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    // Each distinct sampler once, in the order first asked for
+    auto heap = rsbl::UniquePtr(new BindlessHeap());
+    for (const gaSamplerDesc& sampler : createInfo.samplers)
+    {
+        if (!IsValidSampler(sampler))
+        {
+            return {ErrorCategory::InvalidArgument, "Unknown sampler filter, address or compare"};
+        }
+
+        const uint64 hash = HashSampler(sampler);
+        if (heap->samplerIndices.Contains(hash))
+        {
+            continue;
+        }
+
+        if (heap->samplerList.Size() == kGaMaxBindlessSamplers)
+        {
+            return {ErrorCategory::InvalidArgument, "Too many distinct bindless heap samplers"};
+        }
+        heap->samplerIndices.Emplace(hash, static_cast<uint32>(heap->samplerList.Size()));
+        heap->samplerList.PushBack(sampler);
+    }
+
+    auto table = CreateBindlessTable(createInfo.device, createInfo.capacity, heap->samplerList);
+    if (!table)
+    {
+        return PendingFailure{table.Category()};
+    }
+
+    heap->table.Reset(table.Value());
+    heap->backend = createInfo.device->backend;
+    heap->internalHandle = table.Value()->handle;
+    heap->setLayout = table.Value()->setLayout;
+    heap->device = createInfo.device;
+    heap->capacity = createInfo.capacity;
+    heap->registered = 0;
+    heap->samplers = heap->samplerList;
+    return heap.Release();
+}
+
+void GaDestroyBindlessHeap(gaBindlessHeap* heap)
+{
+    delete static_cast<BindlessHeap*>(heap);
+}
+
+Result<uint32> GaRegisterBindless(gaBindlessHeap* baseHeap, const gaBindlessView& view)
+{
+    if (baseHeap == nullptr || view.resource == nullptr)
+    {
+        return "Bindless heap and view resource cannot be null";
+    }
+
+    if (IsBufferView(view.type))
+    {
+        const uint64 granularity = view.stride == 0 ? 4 : view.stride;
+        if (view.size == 0 || view.offset % granularity != 0 || view.size % granularity != 0)
+        {
+            return "Buffer view offset and size must be whole elements, and size above zero";
+        }
+    }
+
+    auto heap = static_cast<BindlessHeap*>(baseHeap);
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    ReclaimIndices(heap);
+
+    // Reused indices first, so the range the GPU looks at stays dense
+    uint32 index = 0;
+    if (!heap->freeIndices.IsEmpty())
+    {
+        index = heap->freeIndices[heap->freeIndices.Size() - 1];
+        heap->freeIndices.PopBack();
+    }
+    else if (heap->unused < heap->capacity)
+    {
+        index = heap->unused++;
+    }
+    else
+    {
+        return {ErrorCategory::OutOfMemory, "Bindless heap is full"};
+    }
+
+    switch (heap->backend)
+    {
+    case gaBackend::DX12:
+        backend::WriteDX12BindlessDescriptor(heap->device, heap->table.Get(), index, view);
+        break;
+
+    case gaBackend::Vulkan:
+        backend::WriteVulkanBindlessDescriptor(heap->device, heap->table.Get(), index, view);
+        break;
+
+    default:
+        break;
+    }
+
+    ++heap->registered;
+    return index;
+}
+
+void GaReleaseBindless(gaBindlessHeap* baseHeap, uint32 index)
+{
+    if (baseHeap == nullptr || index >= baseHeap->capacity)
+    {
+        return;
+    }
+
+    auto heap = static_cast<BindlessHeap*>(baseHeap);
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    heap->released.PushBack({index, heap->device->frame});
+    --heap->registered;
+}
+
+Result<uint32> GaFindBindlessSampler(const gaBindlessHeap* baseHeap, const gaSamplerDesc& desc)
+{
+    if (baseHeap == nullptr)
+    {
+        return "Bindless heap cannot be null";
+    }
+
+    auto heap = static_cast<const BindlessHeap*>(baseHeap);
+    const uint32* index = heap->samplerIndices.Find(HashSampler(desc));
+    if (index == nullptr)
+    {
+        return {ErrorCategory::NotFound, "The bindless heap has no such sampler"};
+    }
+    return *index;
+}
+
+Result<> GaBindBindlessHeap(gaCommandList* list, gaBindlessHeap* baseHeap, void* pipelineLayout)
+{
+    if (list == nullptr || baseHeap == nullptr)
+    {
+        return "Command list and bindless heap cannot be null";
+    }
+
+    if (!list->recording || list->queue == gaQueueType::Copy)
+    {
+        return "Bindless heaps are bound to recording graphics or compute lists";
+    }
+
+    auto heap = static_cast<BindlessHeap*>(baseHeap);
+    switch (heap->backend)
+    {
+    case gaBackend::Null:
+        backend::RecordNullCommand(list, {gaNullCommandType::BindBindlessHeap, 0, 0, baseHeap});
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        backend::BindDX12BindlessTable(list, heap->table.Get());
+        return ResultCode::Success;
+
+    case gaBackend::Vulkan:
+        if (pipelineLayout == nullptr)
+        {
+            return "Vulkan needs the pipeline layout to bind the bindless set to";
+        }
+        backend::BindVulkanBindlessTable(list, heap->table.Get(), pipelineLayout);
+        return ResultCode::Success;
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,148 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-memory-tracking.h>
+
+namespace rsbl
+{
+
+Result<gaBreadcrumbs*> GaCreateBreadcrumbs(const gaBreadcrumbsCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.slots == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Breadcrumbs need at least one slot"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    Result<backend::Breadcrumbs*> breadcrumbs = "Unknown graphics backend";
+    switch (createInfo.device->backend)
+    {
+    case gaBackend::Null:
+        breadcrumbs = backend::CreateNullBreadcrumbs(createInfo.device, createInfo.slots);
+        break;
+
+    case gaBackend::DX12:
+        breadcrumbs = backend::CreateDX12Breadcrumbs(createInfo.device, createInfo.slots);
+        break;
+
+    case gaBackend::Vulkan:
+        breadcrumbs = backend::CreateVulkanBreadcrumbs(createInfo.device, createInfo.slots);
+        break;
+
+    default:
+        break;
+    }
+    if (!breadcrumbs)
+    {
+        return PendingFailure{breadcrumbs.Category()};
+    }
+
+    backend::Breadcrumbs* created = breadcrumbs.Value();
+    created->backend = createInfo.device->backend;
+    created->device = createInfo.device;
+    created->slots = createInfo.slots;
+    return created;
+}
+
+void GaDestroyBreadcrumbs(gaBreadcrumbs* breadcrumbs)
+{
+    delete breadcrumbs;
+}
+
+Result<> GaCmdWriteBreadcrumb(gaCommandList* list,
+                              gaBreadcrumbs* baseBreadcrumbs,
+                              uint32 slot,
+                              uint32 marker)
+{
+    if (list == nullptr || baseBreadcrumbs == nullptr)
+    {
+        return "Command list and breadcrumbs cannot be null";
+    }
+
+    if (!list->recording || list->bundle)
+    {
+        return "Breadcrumbs are written in recording lists, not bundles";
+    }
+
+    if (baseBreadcrumbs->device != list->device)
+    {
+        return {ErrorCategory::InvalidArgument, "The breadcrumbs are another device's"};
+    }
+
+    if (slot >= baseBreadcrumbs->slots)
+    {
+        return {ErrorCategory::InvalidArgument, "The slot is past the breadcrumbs' slots"};
+    }
+
+    auto breadcrumbs = static_cast<backend::Breadcrumbs*>(baseBreadcrumbs);
+    switch (list->backend)
+    {
+    case gaBackend::Null:
+        // Nothing runs, so the GPU is always past everything recorded
+        breadcrumbs->markers[slot] = marker;
+        backend::RecordNullCommand(
+            list, {gaNullCommandType::WriteBreadcrumb, marker, slot, baseBreadcrumbs});
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        backend::WriteDX12Breadcrumb(list, breadcrumbs, slot, marker);
+        return ResultCode::Success;
+
+    case gaBackend::Vulkan:
+        backend::WriteVulkanBreadcrumb(list, breadcrumbs, slot, marker);
+        return ResultCode::Success;
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<> GaReadBreadcrumbs(const gaBreadcrumbs* baseBreadcrumbs, DynamicArray<uint32>& markers)
+{
+    if (baseBreadcrumbs == nullptr)
+    {
+        return "Breadcrumbs cannot be null";
+    }
+
+    // Slot by slot, each is a whole marker the GPU wrote
+    auto breadcrumbs = static_cast<const backend::Breadcrumbs*>(baseBreadcrumbs);
+    markers.Resize(breadcrumbs->slots);
+    for (uint32 slot = 0; slot < breadcrumbs->slots; ++slot)
+    {
+        markers[slot] = breadcrumbs->markers[slot];
+    }
+    return ResultCode::Success;
+}
+
+Result<> GaReportDeviceLost(gaDevice* device)
+{
+    if (device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return {ErrorCategory::NotFound, "Null devices are never lost"};
+
+    case gaBackend::DX12:
+        return backend::ReportDX12DeviceLost(device);
+
+    case gaBackend::Vulkan:
+        return {ErrorCategory::NotFound, "Vulkan has no device lost report, read breadcrumbs"};
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+} // namespace rsbl
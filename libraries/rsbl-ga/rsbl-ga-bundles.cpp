@@ -0,0 +1,208 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-memory-tracking.h>
+
+namespace rsbl
+{
+
+Result<gaCommandBundle*> GaCreateCommandBundle(const gaCommandBundleCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.renderTargetFormats.Size() > kGaMaxRenderTargets)
+    {
+        return {ErrorCategory::InvalidArgument, "Too many render targets"};
+    }
+
+    for (gaFormat format : createInfo.renderTargetFormats)
+    {
+        if (format >= gaFormat::Count)
+        {
+            return {ErrorCategory::InvalidArgument, "Unknown render target format"};
+        }
+    }
+
+    if (createInfo.depthFormat >= gaFormat::Count)
+    {
+        return {ErrorCategory::InvalidArgument, "Unknown depth format"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    Result<backend::CommandBundle*> bundle = "Unknown graphics backend";
+    switch (createInfo.device->backend)
+    {
+    case gaBackend::Null:
+        bundle = backend::CreateNullCommandBundle(createInfo);
+        break;
+
+    case gaBackend::DX12:
+        bundle = backend::CreateDX12CommandBundle(createInfo);
+        break;
+
+    case gaBackend::Vulkan:
+        bundle = backend::CreateVulkanCommandBundle(createInfo);
+        break;
+
+    default:
+        break;
+    }
+    if (!bundle)
+    {
+        return PendingFailure{bundle.Category()};
+    }
+
+    backend::CommandBundle* created = bundle.Value();
+    created->device = createInfo.device;
+    created->recorded = false;
+
+    gaCommandList* list = created->list;
+    list->device = createInfo.device;
+    list->queue = gaQueueType::Graphics;
+    list->recorder = 0;
+    list->frame = 0;
+    list->recording = false;
+    list->submitted = false;
+    list->bundle = true;
+    list->stateTracker = nullptr;
+    return created;
+}
+
+void GaDestroyCommandBundle(gaCommandBundle* bundle)
+{
+    delete bundle;
+}
+
+Result<gaCommandList*> GaBeginCommandBundle(gaCommandBundle* baseBundle)
+{
+    if (baseBundle == nullptr)
+    {
+        return "Command bundle cannot be null";
+    }
+
+    auto bundle = static_cast<backend::CommandBundle*>(baseBundle);
+    if (bundle->list->recording)
+    {
+        return "The bundle is already recording";
+    }
+
+    Result<> begun = ResultCode::Success;
+    switch (bundle->backend)
+    {
+    case gaBackend::Null:
+        backend::BeginNullCommandBundle(bundle);
+        break;
+
+    case gaBackend::DX12:
+        begun = backend::BeginDX12CommandBundle(bundle);
+        break;
+
+    case gaBackend::Vulkan:
+        begun = backend::BeginVulkanCommandBundle(bundle);
+        break;
+
+    default:
+        return "Unknown graphics backend";
+    }
+    if (!begun)
+    {
+        return PendingFailure{begun.Category()};
+    }
+
+    bundle->recorded = false;
+    bundle->list->recording = true;
+    return bundle->list;
+}
+
+Result<> GaEndCommandBundle(gaCommandBundle* baseBundle)
+{
+    if (baseBundle == nullptr)
+    {
+        return "Command bundle cannot be null";
+    }
+
+    auto bundle = static_cast<backend::CommandBundle*>(baseBundle);
+    if (!bundle->list->recording)
+    {
+        return "The bundle is not recording";
+    }
+
+    bundle->list->recording = false;
+
+    Result<> ended = ResultCode::Success;
+    switch (bundle->backend)
+    {
+    case gaBackend::Null:
+        break;
+
+    case gaBackend::DX12:
+        ended = backend::EndDX12CommandList(bundle->list);
+        break;
+
+    case gaBackend::Vulkan:
+        ended = backend::EndVulkanCommandList(bundle->list);
+        break;
+
+    default:
+        return "Unknown graphics backend";
+    }
+    if (!ended)
+    {
+        return ended;
+    }
+
+    bundle->recorded = true;
+    return ResultCode::Success;
+}
+
+Result<> GaCmdExecuteBundle(gaCommandList* list, gaCommandBundle* baseBundle)
+{
+    if (list == nullptr || baseBundle == nullptr)
+    {
+        return "Command list and bundle cannot be null";
+    }
+
+    // Neither API nests bundles
+    if (!list->recording || list->queue != gaQueueType::Graphics || list->bundle)
+    {
+        return "Bundles are replayed in recording lists on the graphics queue";
+    }
+
+    if (baseBundle->device != list->device || !baseBundle->recorded)
+    {
+        return "Bundles are replayed once recorded, in lists on their device";
+    }
+
+    // What GaUse queued for the bundle's draws goes first
+    if (auto flushed = GaFlushBarriers(list); !flushed)
+    {
+        return flushed;
+    }
+
+    auto bundle = static_cast<backend::CommandBundle*>(baseBundle);
+    switch (list->backend)
+    {
+    case gaBackend::Null:
+        backend::ExecuteNullBundle(list, bundle);
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        backend::ExecuteDX12Bundle(list, bundle);
+        return ResultCode::Success;
+
+    case gaBackend::Vulkan:
+        backend::ExecuteVulkanBundle(list, bundle);
+        return ResultCode::Success;
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,194 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-pool-allocator.h>
+
+#include <atomic>
+
+namespace rsbl
+{
+
+namespace
+{
+struct DeferredDestroy
+{
+    DeferredDestroy* next;
+    void* object;
+    gaDestroyFunction destroy;
+    uint64 frame; // The frame it was deferred in
+};
+} // namespace
+
+struct gaDeferredDestroys
+{
+    // Slots come from each thread's own magazine, so deferring rarely takes the pool's lock
+    FixedPoolAllocator nodes{sizeof(DeferredDestroy), alignof(DeferredDestroy), 256, true};
+
+    // Pushed by any thread, newest first. GaBeginFrame takes the lot in one exchange.
+    std::atomic<DeferredDestroy*> pushed{nullptr};
+
+    // The device's frame, for the threads that defer, which can't read gaDevice::frame
+    std::atomic<uint64> frame{0};
+
+    // Taken from pushed and not due yet, oldest first. Only touched by the thread beginning
+    // frames.
+    DeferredDestroy* waiting = nullptr;
+    DeferredDestroy* waitingTail = nullptr;
+
+    DynamicArray<DeferredDestroy*> due;
+    DynamicArray<void*> batch;
+};
+
+namespace
+{
+// Moves everything pushed so far onto the end of waiting, in the order it was pushed
+void TakePushed(gaDeferredDestroys* deferred)
+{
+    DeferredDestroy* newest = deferred->pushed.exchange(nullptr, std::memory_order_acquire);
+    DeferredDestroy* oldest = nullptr;
+    while (newest != nullptr)
+    {
+        DeferredDestroy* next = newest->next;
+        newest->next = oldest;
+        oldest = newest;
+        newest = next;
+    }
+    if (oldest == nullptr)
+    {
+        return;
+    }
+
+    if (deferred->waitingTail != nullptr)
+    {
+        deferred->waitingTail->next = oldest;
+    }
+    else
+    {
+        deferred->waiting = oldest;
+    }
+    for (deferred->waitingTail = oldest; deferred->waitingTail->next != nullptr;)
+    {
+        deferred->waitingTail = deferred->waitingTail->next;
+    }
+}
+
+// Destroys what was deferred up to and including lastFrame. A thread can read the frame, then
+// push after another thread pushed for the next one, so waiting is only mostly in frame order
+// and all of it is looked through.
+void DestroyUpTo(gaDeferredDestroys* deferred, uint64 lastFrame)
+{
+    TakePushed(deferred);
+
+    deferred->due.Clear();
+    DeferredDestroy* kept = nullptr;
+    DeferredDestroy* keptTail = nullptr;
+    for (DeferredDestroy* node = deferred->waiting; node != nullptr;)
+    {
+        DeferredDestroy* next = node->next;
+        if (node->frame <= lastFrame)
+        {
+            deferred->due.PushBack(node);
+        }
+        else
+        {
+            node->next = nullptr;
+            (keptTail != nullptr ? keptTail->next : kept) = node;
+            keptTail = node;
+        }
+        node = next;
+    }
+    deferred->waiting = kept;
+    deferred->waitingTail = keptTail;
+
+    // One call per destroy function, with its objects in the order they were deferred
+    for (uint64 i = 0; i < deferred->due.Size(); ++i)
+    {
+        if (deferred->due[i] == nullptr)
+        {
+            continue;
+        }
+
+        const gaDestroyFunction destroy = deferred->due[i]->destroy;
+        deferred->batch.Clear();
+        for (uint64 j = i; j < deferred->due.Size(); ++j)
+        {
+            DeferredDestroy* node = deferred->due[j];
+            if (node != nullptr && node->destroy == destroy)
+            {
+                deferred->batch.PushBack(node->object);
+                deferred->nodes.FreeSlot(node);
+                deferred->due[j] = nullptr;
+            }
+        }
+        destroy(deferred->batch);
+    }
+}
+} // namespace
+
+namespace backend
+{
+    gaDeferredDestroys* CreateDeferredDestroys()
+    {
+        return new gaDeferredDestroys();
+    }
+
+    void DestroyDeferredDestroys(gaDeferredDestroys* deferred)
+    {
+        if (deferred != nullptr)
+        {
+            DestroyUpTo(deferred, ~0ull);
+            delete deferred;
+        }
+    }
+
+    void BeginDeferredFrame(gaDeferredDestroys* deferred, uint64 frame, uint32 framesInFlight)
+    {
+        deferred->frame.store(frame, std::memory_order_release);
+        if (frame > framesInFlight)
+        {
+            DestroyUpTo(deferred, frame - framesInFlight);
+        }
+    }
+
+    void DestroyAllDeferred(gaDeferredDestroys* deferred)
+    {
+        DestroyUpTo(deferred, ~0ull);
+    }
+} // namespace backend
+
+Result<> GaDeferDestroy(gaDevice* device, void* object, gaDestroyFunction destroy)
+{
+    if (device == nullptr || destroy == nullptr)
+    {
+        return "Device and destroy function cannot be null";
+    }
+
+    if (object == nullptr)
+    {
+        return ResultCode::Success;
+    }
+
+    gaDeferredDestroys* deferred = device->deferredDestroys;
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    auto node = static_cast<DeferredDestroy*>(deferred->nodes.AllocateSlot());
+    if (node == nullptr)
+    {
+        return {ErrorCategory::OutOfMemory, "Out of memory for deferred destruction"};
+    }
+    node->object = object;
+    node->destroy = destroy;
+    node->frame = deferred->frame.load(std::memory_order_acquire);
+
+    node->next = deferred->pushed.load(std::memory_order_relaxed);
+    while (!deferred->pushed.compare_exchange_weak(
+        node->next, node, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+    return ResultCode::Success;
+}
+
+} // namespace rsbl
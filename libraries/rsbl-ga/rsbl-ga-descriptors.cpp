@@ -0,0 +1,200 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+namespace rsbl
+{
+
+namespace
+{
+// Long-lived slots number the pages' descriptors one after the other, slot / pageSize is the page
+struct DescriptorAllocator : public gaDescriptorAllocator
+{
+    DynamicArray<UniquePtr<backend::DescriptorPage>> heapPages;
+    DynamicArray<uint32> freeSlots;
+
+    // transientPerFrame descriptors per frame in flight, the device's frame slots in order
+    UniquePtr<backend::DescriptorPage> transientPage;
+    uint64 transientFrame = 0; // The frame transientUsed counts for
+    uint32 transientUsed = 0;
+};
+
+Result<backend::DescriptorPage*> CreateDescriptorPage(gaDevice* device,
+                                                      gaDescriptorType type,
+                                                      uint32 count)
+{
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullDescriptorPage(device, type, count);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12DescriptorPage(device, type, count);
+
+    case gaBackend::Vulkan:
+        return {ErrorCategory::InvalidArgument,
+                "Vulkan has no descriptor heaps, views are written into descriptor sets"};
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+// Adds a page and puts its slots on the free list, lowest on top
+Result<> AddPage(DescriptorAllocator* allocator)
+{
+    auto page = CreateDescriptorPage(allocator->device, allocator->type, allocator->pageSize);
+    if (!page)
+    {
+        return PendingFailure{page.Category()};
+    }
+
+    allocator->heapPages.PushBack(UniquePtr(page.Value()));
+    allocator->increment = page.Value()->increment;
+    allocator->pages = static_cast<uint32>(allocator->heapPages.Size());
+
+    const uint32 first = (allocator->pages - 1) * allocator->pageSize;
+    for (uint32 slot = first + allocator->pageSize; slot > first; --slot)
+    {
+        allocator->freeSlots.PushBack(slot - 1);
+    }
+    return ResultCode::Success;
+}
+} // namespace
+
+Result<gaDescriptorAllocator*> GaCreateDescriptorAllocator(
+    const gaDescriptorAllocatorCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.type >= gaDescriptorType::Count || createInfo.pageSize == 0)
+    {
+        return "Descriptor type must be valid, and page size greater than zero";
+    }
+
+    const uint64 transientCount =
+        uint64(createInfo.transientPerFrame) * createInfo.device->framesInFlight;
+    if (transientCount > ~0u)
+    {
+        return "Too many transient descriptors per frame";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    auto allocator = rsbl::UniquePtr(new DescriptorAllocator());
+    allocator->backend = createInfo.device->backend;
+    allocator->internalHandle = nullptr;
+    allocator->device = createInfo.device;
+    allocator->type = createInfo.type;
+    allocator->pageSize = createInfo.pageSize;
+    allocator->transientPerFrame = createInfo.transientPerFrame;
+    allocator->allocated = 0;
+
+    // The first page is made up front, which also gives the increment
+    if (auto added = AddPage(allocator.Get()); !added)
+    {
+        return PendingFailure{added.Category()};
+    }
+
+    if (transientCount > 0)
+    {
+        auto page = CreateDescriptorPage(
+            createInfo.device, createInfo.type, static_cast<uint32>(transientCount));
+        if (!page)
+        {
+            return PendingFailure{page.Category()};
+        }
+        allocator->transientPage.Reset(page.Value());
+        allocator->internalHandle = page.Value()->handle;
+    }
+    return allocator.Release();
+}
+
+void GaDestroyDescriptorAllocator(gaDescriptorAllocator* allocator)
+{
+    delete static_cast<DescriptorAllocator*>(allocator);
+}
+
+Result<gaDescriptor> GaAllocateDescriptor(gaDescriptorAllocator* baseAllocator)
+{
+    if (baseAllocator == nullptr)
+    {
+        return "Descriptor allocator cannot be null";
+    }
+
+    auto allocator = static_cast<DescriptorAllocator*>(baseAllocator);
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    if (allocator->freeSlots.IsEmpty())
+    {
+        if (auto added = AddPage(allocator); !added)
+        {
+            return PendingFailure{added.Category()};
+        }
+    }
+
+    const uint32 slot = allocator->freeSlots[allocator->freeSlots.Size() - 1];
+    allocator->freeSlots.PopBack();
+    ++allocator->allocated;
+
+    const backend::DescriptorPage* page = allocator->heapPages[slot / allocator->pageSize].Get();
+    return gaDescriptor{page->start + uint64(slot % allocator->pageSize) * page->increment, slot};
+}
+
+void GaFreeDescriptor(gaDescriptorAllocator* baseAllocator, const gaDescriptor& descriptor)
+{
+    if (baseAllocator == nullptr ||
+        descriptor.slot >= baseAllocator->pages * baseAllocator->pageSize)
+    {
+        return;
+    }
+
+    auto allocator = static_cast<DescriptorAllocator*>(baseAllocator);
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    allocator->freeSlots.PushBack(descriptor.slot);
+    --allocator->allocated;
+}
+
+Result<gaDescriptor> GaAllocateTransientDescriptors(gaDescriptorAllocator* baseAllocator,
+                                                    uint32 count)
+{
+    if (baseAllocator == nullptr)
+    {
+        return "Descriptor allocator cannot be null";
+    }
+
+    if (count == 0)
+    {
+        return "Transient descriptor count must be greater than zero";
+    }
+
+    // The frame slot's region is free again once GaBeginFrame has waited for its last use
+    auto allocator = static_cast<DescriptorAllocator*>(baseAllocator);
+    const gaDevice* device = allocator->device;
+    if (allocator->transientFrame != device->frame)
+    {
+        allocator->transientFrame = device->frame;
+        allocator->transientUsed = 0;
+    }
+
+    if (count > allocator->transientPerFrame - allocator->transientUsed)
+    {
+        return {ErrorCategory::OutOfMemory, "The frame is out of transient descriptors"};
+    }
+
+    const uint64 index = (device->frame % device->framesInFlight) * allocator->transientPerFrame +
+                         allocator->transientUsed;
+    allocator->transientUsed += count;
+
+    const backend::DescriptorPage* page = allocator->transientPage.Get();
+    return gaDescriptor{page->start + index * page->increment, 0};
+}
+
+} // namespace rsbl
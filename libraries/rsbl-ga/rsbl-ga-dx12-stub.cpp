@@ -18,5 +18,362 @@ Result<gaSwapchain*> CreateDX12Swapchain(const gaSwapchainCreateInfo& createInfo
 	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
 }
 
+Result<> WaitForDX12Swapchain(gaSwapchain* swapchain, uint32 timeoutMs)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> PresentDX12(gaSwapchain* swapchain)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> SetDX12ExclusiveFullscreen(gaSwapchain* swapchain, bool exclusive)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> GetDX12PresentStats(gaSwapchain* swapchain, gaPresentStats& presentStats)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> BeginDX12Frame(gaDevice* device)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> WaitForDX12Idle(gaDevice* device)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaCommandList*> BeginDX12CommandList(gaDevice* device, gaQueueType queue, uint32 recorder)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> EndDX12CommandList(gaCommandList* list)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> SubmitDX12(gaDevice* device, gaQueueType queue, ArrayView<gaCommandList* const> lists)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<TimestampHeap*> CreateDX12TimestampHeap(gaDevice* device,
+                                               gaQueueType queue,
+                                               uint32 count)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+void WriteDX12Timestamp(gaCommandList* list, TimestampHeap* heap, uint32 index)
+{
+}
+
+void ResolveDX12Timestamps(gaCommandList* list, TimestampHeap* heap, uint32 first, uint32 count)
+{
+}
+
+Result<> ReadDX12Timestamps(TimestampHeap* heap, uint32 first, uint32 count, uint64* out)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaClockCalibration> GetDX12ClockCalibration(gaDevice* device, gaQueueType queue)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> EnumerateDX12Adapters(DynamicArray<gaAdapterInfo>& adapters)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+void RecordDX12BufferCopy(gaCommandList* list,
+                          void* destination,
+                          uint64 destinationOffset,
+                          void* source,
+                          uint64 sourceOffset,
+                          uint64 size)
+{
+}
+
+void RecordDX12IndirectDraws(gaCommandList* list,
+                             void* arguments,
+                             uint64 argumentOffset,
+                             uint32 maxDraws,
+                             void* count,
+                             uint64 countOffset)
+{
+}
+
+void RecordDX12MeshDispatch(gaCommandList* list,
+                            uint32 groupsX,
+                            uint32 groupsY,
+                            uint32 groupsZ)
+{
+}
+
+void RecordDX12PushConstants(gaCommandList* list,
+                             const gaPipeline* pipeline,
+                             uint32 offset,
+                             uint32 size,
+                             const void* data)
+{
+}
+
+void RecordDX12ShadingRate(gaCommandList* list, gaShadingRate rate, void* rateImage)
+{
+}
+
+Result<Breadcrumbs*> CreateDX12Breadcrumbs(gaDevice* device, uint32 slots)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+void WriteDX12Breadcrumb(gaCommandList* list,
+                         Breadcrumbs* breadcrumbs,
+                         uint32 slot,
+                         uint32 marker)
+{
+}
+
+Result<> ReportDX12DeviceLost(gaDevice* device)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaSharedBuffer*> CreateDX12SharedBuffer(const gaSharedBufferCreateInfo& createInfo)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaFence*> CreateDX12Fence(gaDevice* device, uint64 initialValue)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> SignalDX12Fence(gaDevice* device, gaQueueType queue, gaFence* fence, uint64 value)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> QueueWaitForDX12Fence(gaDevice* device,
+                               gaQueueType queue,
+                               gaFence* fence,
+                               uint64 value)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+uint64 GetDX12FenceValue(gaFence* fence)
+{
+	return 0;
+}
+
+Result<> WaitForDX12Fence(gaFence* fence, uint64 value)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaMemoryHeap*> CreateDX12MemoryHeap(gaDevice* device,
+                                           gaMemoryType type,
+                                           uint64 size,
+                                           uint64 alignment)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaMemoryHeap*> CreateDX12TileHeap(gaDevice* device, uint64 size, bool textures)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaReservedResource*> CreateDX12ReservedResource(
+    const gaReservedResourceCreateInfo& createInfo)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> UpdateDX12TileMappings(gaDevice* device, ArrayView<const gaTileMapping> mappings)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaMemoryBudget> QueryDX12MemoryBudget(gaDevice* device)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<UploadBuffer*> CreateDX12UploadBuffer(gaDevice* device, uint64 size)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+void RecordDX12Barriers(gaCommandList* list, ArrayView<const gaBarrier> barriers)
+{
+}
+
+void RecordDX12BufferCopies(gaCommandList* list,
+                            UploadBuffer* source,
+                            ArrayView<const BufferCopy> copies)
+{
+}
+
+Result<ReadbackBuffer*> CreateDX12ReadbackBuffer(gaDevice* device, uint64 size)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+void RecordDX12ReadbackCopies(gaCommandList* list,
+                              ReadbackBuffer* destination,
+                              ArrayView<const ReadbackCopy> copies)
+{
+}
+
+Result<DescriptorPage*> CreateDX12DescriptorPage(gaDevice* device,
+                                                 gaDescriptorType type,
+                                                 uint32 count)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<BindlessTable*> CreateDX12BindlessTable(gaDevice* device,
+                                               uint32 capacity,
+                                               ArrayView<const gaSamplerDesc> samplers)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+void WriteDX12BindlessDescriptor(gaDevice* device,
+                                 BindlessTable* table,
+                                 uint32 index,
+                                 const gaBindlessView& view)
+{
+}
+
+void BindDX12BindlessTable(gaCommandList* list, BindlessTable* table)
+{
+}
+
+Result<PipelineLibrary*> CreateDX12PipelineLibrary(gaDevice* device,
+                                                   ArrayView<const uint8> data)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> SerializeDX12PipelineLibrary(PipelineLibrary* library, DynamicArray<uint8>& data)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<PipelineLayout*> CreateDX12PipelineLayout(gaDevice* device,
+                                                 const gaBindlessHeap* bindless,
+                                                 bool compute,
+                                                 uint32 pushConstantBytes)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaPipeline*> CreateDX12GraphicsPipeline(gaDevice* device,
+                                               PipelineLibrary* library,
+                                               PipelineLayout* layout,
+                                               uint64 key,
+                                               const gaGraphicsPipelineDesc& desc)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaPipeline*> CreateDX12ComputePipeline(gaDevice* device,
+                                              PipelineLibrary* library,
+                                              PipelineLayout* layout,
+                                              uint64 key,
+                                              const gaComputePipelineDesc& desc)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaSkinningPass*> CreateDX12SkinningPass(const gaSkinningPassCreateInfo& createInfo)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> UploadDX12SkinVertices(gaSkinningPass* pass, ArrayView<const gaSkinVertex> vertices)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> DispatchDX12Skinning(gaSkinningPass* pass, ArrayView<const float> palettes)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaCullingPass*> CreateDX12CullingPass(const gaCullingPassCreateInfo& createInfo)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> UploadDX12CullInstances(gaCullingPass* pass, ArrayView<const gaCullInstance> instances)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> DispatchDX12Culling(gaCullingPass* pass, const gaCullView& view)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaLightBinningPass*> CreateDX12LightBinningPass(
+	const gaLightBinningPassCreateInfo& createInfo)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> DispatchDX12LightBinning(gaLightBinningPass* pass,
+                                  ArrayView<const gaPunctualLight> lights,
+                                  const gaLightBinningView& view)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaUpscaler*> CreateDX12Upscaler(const gaUpscalerCreateInfo& createInfo)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> DispatchDX12Upscale(gaUpscaler* upscaler, const gaUpscaleInputs& inputs)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<gaMipGenerationPass*> CreateDX12MipGenerationPass(
+	const gaMipGenerationPassCreateInfo& createInfo)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> GenerateDX12Mips(gaMipGenerationPass* pass, const gaMipGenerationTarget& target)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<CommandBundle*> CreateDX12CommandBundle(const gaCommandBundleCreateInfo& createInfo)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+Result<> BeginDX12CommandBundle(CommandBundle* bundle)
+{
+	return "DX12 backend is not available. Build with MSVC to enable DX12 support";
+}
+
+void ExecuteDX12Bundle(gaCommandList* list, CommandBundle* bundle)
+{
+}
+
 } // namespace backend
 } // namespace rsbl
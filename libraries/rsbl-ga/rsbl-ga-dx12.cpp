@@ -3,13 +3,18 @@
 
 #include "rsbl-ga-backends.h"
 
+#include <rsbl-bits.h>
 #include <rsbl-log.h>
 #include <rsbl-ptr.h>
 #include <rsbl-dynamic-array.h>
+#include <rsbl-small-array.h>
 
 #include <d3d12.h>
+#include <d3dcompiler.h>
 #include <dxgi1_6.h>
 
+#include <cstring>
+
 // TODO: check for DX 12.2 (Ray Tracing)
 
 namespace rsbl
@@ -17,13 +22,97 @@ namespace rsbl
 namespace backend
 {
 
+    struct DX12Fence : public gaFence
+    {
+        RefPtr<ID3D12Fence> d3d12Fence;
+        HANDLE event = nullptr;
+
+        DX12Fence()
+        {
+            backend = gaBackend::DX12;
+            internalHandle = nullptr;
+            signalledValue = 0;
+        }
+
+        ~DX12Fence() override
+        {
+            if (event != nullptr)
+            {
+                CloseHandle(event);
+                event = nullptr;
+            }
+        }
+
+        bool Wait(uint64 value)
+        {
+            if (!d3d12Fence || d3d12Fence->GetCompletedValue() >= value)
+            {
+                return true;
+            }
+            if (FAILED(d3d12Fence->SetEventOnCompletion(value, event)))
+            {
+                return false;
+            }
+            WaitForSingleObject(event, INFINITE);
+            return true;
+        }
+    };
+
+    struct DX12CommandList : public gaCommandList
+    {
+        RefPtr<ID3D12GraphicsCommandList> commandList;
+        RefPtr<ID3D12GraphicsCommandList6> meshCommandList; // For DispatchMesh, with meshShaders
+        // For RSSetShadingRate, with variableRateShading
+        RefPtr<ID3D12GraphicsCommandList5> shadingRateCommandList;
+        RefPtr<ID3D12GraphicsCommandList2> markerCommandList; // For WriteBufferImmediate
+
+        DX12CommandList()
+        {
+            backend = gaBackend::DX12;
+            internalHandle = nullptr;
+        }
+    };
+
+    // A recorder's allocator for one queue in one frame slot, and the lists recorded with it. The
+    // lists are kept and reset onto the allocator again every time the slot comes back round.
+    struct DX12CommandRecorder
+    {
+        RefPtr<ID3D12CommandAllocator> allocator; // Made the first time it's recorded on
+        DynamicArray<UniquePtr<DX12CommandList>> lists;
+        uint32 used = 0; // Lists handed out this frame
+    };
+
+    struct DX12Frame
+    {
+        DynamicArray<DX12CommandRecorder> recorders[kQueueTypes];
+        // The queue's frame fence reaches it once the GPU is done with the frame's last submit
+        uint64 fenceValues[kQueueTypes] = {};
+    };
+
+    // Allocators and lists are made for the queue they're used on
+    constexpr D3D12_COMMAND_LIST_TYPE kCommandListTypes[kQueueTypes] = {
+        D3D12_COMMAND_LIST_TYPE_DIRECT,
+        D3D12_COMMAND_LIST_TYPE_COMPUTE,
+        D3D12_COMMAND_LIST_TYPE_COPY,
+    };
+
+    // COM objects are held in RefPtrs, so they're released when the device/swapchain is deleted.
+    // The destructors still reset them explicitly to keep the release order (and logging).
     struct DX12Device : public gaDevice
     {
-        ID3D12Device* d3d12Device = nullptr;
-        IDXGIFactory4* dxgiFactory = nullptr;
-        IDXGIAdapter1* adapter = nullptr;
-        DynamicArray<ID3D12CommandQueue*> commandQueues;
-        uint32 rtvDescriptorSize = 0;
+        RefPtr<ID3D12Device> d3d12Device;
+        RefPtr<IDXGIFactory4> dxgiFactory;
+        RefPtr<IDXGIAdapter1> adapter;
+        SmallArray<RefPtr<ID3D12CommandQueue>, 4> commandQueues; // Indexed by gaQueueType
+        // The swapchain's render target views, and any other the backend keeps
+        gaDescriptorAllocator* rtvAllocator = nullptr;
+        D3D12_RESOURCE_HEAP_TIER resourceHeapTier = D3D12_RESOURCE_HEAP_TIER_1;
+        // ExecuteIndirect's layout for GaCmdDrawIndexedIndirect, a gaDrawIndexedArguments each
+        RefPtr<ID3D12CommandSignature> drawIndexedSignature;
+
+        // Command allocators per frame in flight, and the fences counting each queue's submits
+        DynamicArray<DX12Frame> frames;
+        DX12Fence frameFences[kQueueTypes];
 
         DX12Device()
         {
@@ -35,83 +124,278 @@ namespace backend
         {
             RSBL_LOG_INFO("Destroying DX12 device...");
 
+            // Allocators can't be released while the GPU runs their lists
+            for (DX12Fence& frameFence : frameFences)
+            {
+                frameFence.Wait(frameFence.signalledValue);
+            }
+            frames.Clear();
+
+            GaDestroyDescriptorAllocator(rtvAllocator);
+            rtvAllocator = nullptr;
+
             // Release command queues first
             for (size_t i = 0; i < commandQueues.Size(); ++i)
             {
-                if (commandQueues[i])
-                {
-                    RSBL_LOG_INFO("Releasing ID3D12CommandQueue: {}", static_cast<void*>(commandQueues[i]));
-                    commandQueues[i]->Release();
-                }
+                RSBL_LOG_DEBUG("Releasing ID3D12CommandQueue: {}", static_cast<void*>(commandQueues[i].Get()));
             }
             commandQueues.Clear();
 
             if (d3d12Device)
             {
-                RSBL_LOG_INFO("Releasing ID3D12Device: {}", static_cast<void*>(d3d12Device));
-                d3d12Device->Release();
-                d3d12Device = nullptr;
+                RSBL_LOG_DEBUG("Releasing ID3D12Device: {}", static_cast<void*>(d3d12Device.Get()));
+                d3d12Device.Reset();
             }
 
             if (adapter)
             {
-                RSBL_LOG_INFO("Releasing DXGIAdapter: {}", static_cast<void*>(adapter));
-                adapter->Release();
-                adapter = nullptr;
+                RSBL_LOG_DEBUG("Releasing DXGIAdapter: {}", static_cast<void*>(adapter.Get()));
+                adapter.Reset();
             }
 
             if (dxgiFactory)
             {
-                RSBL_LOG_INFO("Releasing DXGIFactory: {}", static_cast<void*>(dxgiFactory));
-                dxgiFactory->Release();
-                dxgiFactory = nullptr;
+                RSBL_LOG_DEBUG("Releasing DXGIFactory: {}", static_cast<void*>(dxgiFactory.Get()));
+                dxgiFactory.Reset();
             }
         }
+
+        DX12Frame& CurrentFrame()
+        {
+            return frames[frame % frames.Size()];
+        }
     };
 
     struct DX12Swapchain : public gaSwapchain
     {
-        IDXGISwapChain3* dxgiSwapchain = nullptr;
-        DynamicArray<ID3D12Resource*> renderTargets;
-        ID3D12DescriptorHeap* rtvHeap = nullptr;
+        RefPtr<IDXGISwapChain3> dxgiSwapchain;
+        // For the composition mode in its frame statistics, null where DXGI doesn't have it
+        RefPtr<IDXGISwapChainMedia> media;
+        SmallArray<RefPtr<ID3D12Resource>, 4> renderTargets;
+        gaDescriptorAllocator* rtvAllocator = nullptr; // The device's
+        SmallArray<gaDescriptor, 4> rtvs;
+
+        // Signalled when the swapchain can take another present, see SetMaximumFrameLatency
+        HANDLE frameLatencyWaitable = nullptr;
+        bool waited = false; // On the waitable, since the last present
+
+        // What presentMode comes down to
+        UINT syncInterval = 1;
+        UINT presentFlags = 0;
+        UINT flags = 0; // As created, ResizeBuffers has to keep them
+        // Asked for by GaSetExclusiveFullscreen, and still so at the last present
+        bool exclusive = false;
+
+        // The frames rendering to the back buffers are done once the device's graphics frame
+        // fence reaches the value it had at the last present
+        DX12Device* device = nullptr;
+        uint64 lastFenceValue = 0;
+
+        // The last frame statistics read, kept for when DXGI says they're disjoint
+        uint64 displayedPresent = 0;
+        uint64 displayedTicks = 0;
+        gaPresentPath path = gaPresentPath::Unknown;
 
         DX12Swapchain()
         {
             backend = gaBackend::DX12;
             internalHandle = nullptr;
+            presentMode = gaPresentMode::Vsync;
+            currentBuffer = 0;
+            backBuffer = nullptr;
         }
 
         ~DX12Swapchain() override
         {
             RSBL_LOG_INFO("Destroying DX12 swapchain...");
 
+            if (frameLatencyWaitable != nullptr)
+            {
+                CloseHandle(frameLatencyWaitable);
+                frameLatencyWaitable = nullptr;
+            }
+
             // Release render targets first
             for (size_t i = 0; i < renderTargets.Size(); ++i)
             {
-                if (renderTargets[i])
-                {
-                    RSBL_LOG_INFO("Releasing render target {}: {}", i, static_cast<void*>(renderTargets[i]));
-                    renderTargets[i]->Release();
-                }
+                RSBL_LOG_DEBUG("Releasing render target {}: {}", i, static_cast<void*>(renderTargets[i].Get()));
             }
             renderTargets.Clear();
 
-            if (rtvHeap)
+            for (const gaDescriptor& rtv : rtvs)
             {
-                RSBL_LOG_INFO("Releasing RTV descriptor heap: {}", static_cast<void*>(rtvHeap));
-                rtvHeap->Release();
-                rtvHeap = nullptr;
+                GaFreeDescriptor(rtvAllocator, rtv);
             }
+            rtvs.Clear();
+
+            // DXGI won't release a swapchain that's still fullscreen
+            if (dxgiSwapchain && exclusive)
+            {
+                dxgiSwapchain->SetFullscreenState(FALSE, nullptr);
+            }
+            media.Reset();
 
             if (dxgiSwapchain)
             {
-                RSBL_LOG_INFO("Releasing IDXGISwapChain3: {}", static_cast<void*>(dxgiSwapchain));
-                dxgiSwapchain->Release();
-                dxgiSwapchain = nullptr;
+                RSBL_LOG_DEBUG("Releasing IDXGISwapChain3: {}", static_cast<void*>(dxgiSwapchain.Get()));
+                dxgiSwapchain.Reset();
+            }
+        }
+    };
+
+    // gaSwapchainCreateInfo::offscreen: render targets of its own, which nothing shows. Presents
+    // take the next one in turn without waiting for anything.
+    struct DX12OffscreenSwapchain : public gaSwapchain
+    {
+        SmallArray<RefPtr<ID3D12Resource>, 4> renderTargets;
+        gaDescriptorAllocator* rtvAllocator = nullptr; // The device's
+        SmallArray<gaDescriptor, 4> rtvs;
+
+        // As DX12Swapchain's, the frames rendering to the targets are done at this value
+        DX12Device* device = nullptr;
+        uint64 lastFenceValue = 0;
+
+        DX12OffscreenSwapchain()
+        {
+            backend = gaBackend::DX12;
+            internalHandle = nullptr;
+            presentMode = gaPresentMode::Immediate;
+            currentBuffer = 0;
+            backBuffer = nullptr;
+            offscreen = true;
+        }
+
+        ~DX12OffscreenSwapchain() override
+        {
+            renderTargets.Clear();
+            for (const gaDescriptor& rtv : rtvs)
+            {
+                GaFreeDescriptor(rtvAllocator, rtv);
             }
         }
     };
 
+    static Result<> InitFence(ID3D12Device* device,
+                              uint64 initialValue,
+                              DX12Fence& fence,
+                              D3D12_FENCE_FLAGS flags = D3D12_FENCE_FLAG_NONE)
+    {
+        if (FAILED(device->CreateFence(initialValue, flags,
+                                       IID_PPV_ARGS(fence.d3d12Fence.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create a fence";
+        }
+        fence.event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (fence.event == nullptr)
+        {
+            return "Failed to create a fence event";
+        }
+        fence.internalHandle = fence.d3d12Fence.Get();
+        fence.signalledValue = initialValue;
+        return ResultCode::Success;
+    }
+
+    // Bindless heaps need descriptors left unwritten (tier 2) and ResourceDescriptorHeap[]
+    static bool SupportsBindless(ID3D12Device* d3d12Device,
+                                 const D3D12_FEATURE_DATA_D3D12_OPTIONS& options)
+    {
+        D3D12_FEATURE_DATA_SHADER_MODEL shaderModel = {D3D_SHADER_MODEL_6_6};
+        return options.ResourceBindingTier >= D3D12_RESOURCE_BINDING_TIER_2 &&
+               SUCCEEDED(d3d12Device->CheckFeatureSupport(
+                   D3D12_FEATURE_SHADER_MODEL, &shaderModel, sizeof(shaderModel))) &&
+               shaderModel.HighestShaderModel >= D3D_SHADER_MODEL_6_6;
+    }
+
+    // The hardware adapters that make a 12_1 device, in DXGI's order for the power preference
+    // where it has one (Windows 10 1803 on). The devices made to check them come back too, so
+    // the one picked isn't created a second time.
+    static void ListDX12Adapters(IDXGIFactory4* factory,
+                                 gaPowerPreference preference,
+                                 DynamicArray<RefPtr<IDXGIAdapter1>>& adapters,
+                                 DynamicArray<RefPtr<ID3D12Device>>& devices,
+                                 DynamicArray<gaAdapterInfo>& candidates)
+    {
+        RefPtr<IDXGIFactory6> factory6;
+        const bool byPreference =
+            SUCCEEDED(factory->QueryInterface(IID_PPV_ARGS(factory6.ReleaseAndGetAddressOf())));
+        const DXGI_GPU_PREFERENCE gpuPreference = preference == gaPowerPreference::MinimumPower
+                                                      ? DXGI_GPU_PREFERENCE_MINIMUM_POWER
+                                                      : DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE;
+
+        // DXGI_ERROR_NOT_FOUND past the last one
+        RefPtr<IDXGIAdapter1> adapter;
+        for (UINT index = 0;
+             SUCCEEDED(byPreference ? factory6->EnumAdapterByGpuPreference(
+                                          index,
+                                          gpuPreference,
+                                          IID_PPV_ARGS(adapter.ReleaseAndGetAddressOf()))
+                                    : factory->EnumAdapters1(index,
+                                                             adapter.ReleaseAndGetAddressOf()));
+             ++index)
+        {
+            DXGI_ADAPTER_DESC1 desc;
+            adapter->GetDesc1(&desc);
+            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE)
+            {
+                continue;
+            }
+
+            RefPtr<ID3D12Device> probe;
+            if (FAILED(D3D12CreateDevice(adapter.Get(),
+                                         D3D_FEATURE_LEVEL_12_1,
+                                         IID_PPV_ARGS(probe.ReleaseAndGetAddressOf()))))
+            {
+                continue;
+            }
+
+            gaAdapterInfo candidate;
+            static_assert(sizeof(desc.AdapterLuid) <= sizeof(candidate.id));
+            memcpy(candidate.id, &desc.AdapterLuid, sizeof(desc.AdapterLuid));
+            WideCharToMultiByte(CP_UTF8,
+                                0,
+                                desc.Description,
+                                -1,
+                                candidate.name,
+                                sizeof(candidate.name) - 1,
+                                nullptr,
+                                nullptr);
+            candidate.name[sizeof(candidate.name) - 1] = '\0';
+
+            // Unified memory is an integrated GPU's, sharing system memory with the CPU
+            D3D12_FEATURE_DATA_ARCHITECTURE architecture = {};
+            const bool uma =
+                SUCCEEDED(probe->CheckFeatureSupport(
+                    D3D12_FEATURE_ARCHITECTURE, &architecture, sizeof(architecture))) &&
+                architecture.UMA;
+            candidate.type = uma ? gaAdapterType::Integrated : gaAdapterType::Discrete;
+            candidate.dedicatedMemory = desc.DedicatedVideoMemory;
+
+            D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+            candidate.bindless = SUCCEEDED(probe->CheckFeatureSupport(
+                                     D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))) &&
+                                 SupportsBindless(probe.Get(), options);
+
+            candidates.PushBack(candidate);
+            adapters.PushBack(rsblMove(adapter));
+            devices.PushBack(rsblMove(probe));
+        }
+    }
+
+    Result<> EnumerateDX12Adapters(DynamicArray<gaAdapterInfo>& adapters)
+    {
+        RefPtr<IDXGIFactory4> factory;
+        if (FAILED(CreateDXGIFactory2(0, IID_PPV_ARGS(factory.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create DXGI factory";
+        }
+
+        DynamicArray<RefPtr<IDXGIAdapter1>> dxgiAdapters;
+        DynamicArray<RefPtr<ID3D12Device>> devices;
+        ListDX12Adapters(
+            factory.Get(), gaPowerPreference::HighPerformance, dxgiAdapters, devices, adapters);
+        return ResultCode::Success;
+    }
+
     Result<gaDevice*> CreateDX12Device(const gaDeviceCreateInfo& createInfo)
     {
         RSBL_LOG_INFO("Creating DX12 device...");
@@ -121,11 +405,27 @@ namespace backend
         // Enable debug layer if validation is requested
         if (createInfo.enableValidation)
         {
-            ID3D12Debug* debugController = nullptr;
-            if (SUCCEEDED(D3D12GetDebugInterface(IID_PPV_ARGS(&debugController))))
+            RefPtr<ID3D12Debug> debugController;
+            if (SUCCEEDED(D3D12GetDebugInterface(
+                    IID_PPV_ARGS(debugController.ReleaseAndGetAddressOf()))))
             {
                 debugController->EnableDebugLayer();
-                debugController->Release();
+            }
+        }
+
+        // DRED is set up before any device is made, the adapter probes included
+        if (createInfo.enableDeviceLostReports)
+        {
+            RefPtr<ID3D12DeviceRemovedExtendedDataSettings> dredSettings;
+            if (SUCCEEDED(D3D12GetDebugInterface(
+                    IID_PPV_ARGS(dredSettings.ReleaseAndGetAddressOf()))))
+            {
+                dredSettings->SetAutoBreadcrumbsEnablement(D3D12_DRED_ENABLEMENT_FORCED_ON);
+                dredSettings->SetPageFaultEnablement(D3D12_DRED_ENABLEMENT_FORCED_ON);
+            }
+            else
+            {
+                RSBL_LOG_WARNING("DRED isn't available, lost devices won't be reported on");
             }
         }
 
@@ -136,84 +436,239 @@ namespace backend
             dxgiFactoryFlags |= DXGI_CREATE_FACTORY_DEBUG;
         }
 
-        HRESULT hr = CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&device->dxgiFactory));
+        HRESULT hr = CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(device->dxgiFactory.ReleaseAndGetAddressOf()));
         if (FAILED(hr))
         {
             return "Failed to create DXGI factory";
         }
 
-        RSBL_LOG_INFO("DXGI factory created: {}", static_cast<void*>(device->dxgiFactory));
+        RSBL_LOG_INFO("DXGI factory created: {}", static_cast<void*>(device->dxgiFactory.Get()));
 
-        // Find hardware adapter
-        IDXGIAdapter1* adapter = nullptr;
-        for (UINT adapterIndex = 0;
-             SUCCEEDED(device->dxgiFactory->EnumAdapters1(adapterIndex, &adapter));
-             ++adapterIndex)
+        // Pick a hardware adapter, a laptop's first one is often the integrated GPU
+        DynamicArray<RefPtr<IDXGIAdapter1>> adapters;
+        DynamicArray<RefPtr<ID3D12Device>> probes;
+        DynamicArray<gaAdapterInfo> candidates;
+        ListDX12Adapters(
+            device->dxgiFactory.Get(), createInfo.powerPreference, adapters, probes, candidates);
+        for (const gaAdapterInfo& candidate : candidates)
         {
-            DXGI_ADAPTER_DESC1 desc;
-            adapter->GetDesc1(&desc);
+            RSBL_LOG_INFO("Graphics adapter: {} ({} MiB dedicated)",
+                          candidate.name,
+                          candidate.dedicatedMemory >> 20);
+        }
 
-            // Skip software adapter
-            if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE)
+        const uint32 picked = SelectAdapter(candidates, createInfo);
+        if (picked == ~0u)
+        {
+            return {ErrorCategory::NotFound, "Failed to find suitable graphics adapter"};
+        }
+        device->adapter = rsblMove(adapters[picked]);
+        device->adapterInfo = candidates[picked];
+
+        RSBL_LOG_INFO("Picked graphics adapter: {}", device->adapterInfo.name);
+
+        // The device that checked the adapter is the one used, rather than tearing it down and
+        // creating it again
+        device->d3d12Device = rsblMove(probes[picked]);
+
+        RSBL_LOG_INFO("D3D12 device created: {}", static_cast<void*>(device->d3d12Device.Get()));
+
+        device->internalHandle = device->d3d12Device.Get();
+
+        // Tier 1 keeps buffers, textures and render targets in heaps of different kinds
+        D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+        if (SUCCEEDED(device->d3d12Device->CheckFeatureSupport(
+                D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))))
+        {
+            device->resourceHeapTier = options.ResourceHeapTier;
+        }
+
+        device->bindless = SupportsBindless(device->d3d12Device.Get(), options);
+
+        D3D12_INDIRECT_ARGUMENT_DESC drawIndexed = {};
+        drawIndexed.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+        D3D12_COMMAND_SIGNATURE_DESC signatureDesc = {};
+        signatureDesc.ByteStride = sizeof(gaDrawIndexedArguments);
+        signatureDesc.NumArgumentDescs = 1;
+        signatureDesc.pArgumentDescs = &drawIndexed;
+        if (FAILED(device->d3d12Device->CreateCommandSignature(
+                &signatureDesc,
+                nullptr,
+                IID_PPV_ARGS(device->drawIndexedSignature.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create the indirect draw command signature";
+        }
+        device->drawIndirectCount = true;
+
+        // Tier 1 is all there is. Shaders are built for 6.6, which bindless already checks for.
+        D3D12_FEATURE_DATA_D3D12_OPTIONS7 options7 = {};
+        device->meshShaders =
+            device->bindless &&
+            SUCCEEDED(device->d3d12Device->CheckFeatureSupport(
+                D3D12_FEATURE_D3D12_OPTIONS7, &options7, sizeof(options7))) &&
+            options7.MeshShaderTier >= D3D12_MESH_SHADER_TIER_1;
+
+        // Tier 2 reads unmapped tiles as zero, which tier 1 leaves undefined
+        device->reservedResources = options.TiledResourcesTier >= D3D12_TILED_RESOURCES_TIER_2;
+
+        // WriteBufferImmediate's MARKER_OUT waits for the work before it
+        device->bufferMarkers = true;
+
+        // Tier 1 has per-draw rates only, rate images are tier 2
+        D3D12_FEATURE_DATA_D3D12_OPTIONS6 options6 = {};
+        if (SUCCEEDED(device->d3d12Device->CheckFeatureSupport(
+                D3D12_FEATURE_D3D12_OPTIONS6, &options6, sizeof(options6))) &&
+            options6.VariableShadingRateTier >= D3D12_VARIABLE_SHADING_RATE_TIER_2)
+        {
+            device->variableRateShading = true;
+            device->largeShadingRates = options6.AdditionalShadingRatesSupported == TRUE;
+            device->shadingRateTileSize = options6.ShadingRateImageTileSize;
+        }
+
+        // A queue of each type. D3D12 always has them, whether the hardware runs them alongside
+        // each other or not is up to the driver.
+        for (uint32 queue = 0; queue < kQueueTypes; ++queue)
+        {
+            D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+            queueDesc.Type = kCommandListTypes[queue];
+            queueDesc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
+            queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+            queueDesc.NodeMask = 0;
+
+            RefPtr<ID3D12CommandQueue> commandQueue;
+            hr = device->d3d12Device->CreateCommandQueue(
+                &queueDesc, IID_PPV_ARGS(commandQueue.ReleaseAndGetAddressOf()));
+            if (FAILED(hr))
             {
-                adapter->Release();
-                continue;
+                return "Failed to create command queue";
             }
 
-            // Check if adapter supports D3D12
-            if (SUCCEEDED(D3D12CreateDevice(
-                    adapter, D3D_FEATURE_LEVEL_12_1, __uuidof(ID3D12Device), nullptr)))
+            RSBL_LOG_INFO("Command queue created: {}", static_cast<void*>(commandQueue.Get()));
+            device->commandQueues.PushBack(rsblMove(commandQueue));
+
+            if (auto fence = InitFence(device->d3d12Device.Get(), 0, device->frameFences[queue]);
+                !fence)
             {
-                device->adapter = adapter;
-                break;
+                return PendingFailure{fence.Category()};
             }
-
-            adapter->Release();
         }
+        device->asyncCompute = true;
+        device->dedicatedCopy = true;
 
-        if (device->adapter == nullptr)
+        // An allocator per recorder per queue per frame in flight, made along with the lists as
+        // they're first needed
+        device->commandRecorders = createInfo.commandRecorders;
+        device->framesInFlight = createInfo.framesInFlight;
+        device->frames.Resize(createInfo.framesInFlight);
+        for (DX12Frame& frame : device->frames)
         {
-            return "Failed to find suitable graphics adapter";
+            for (DynamicArray<DX12CommandRecorder>& recorders : frame.recorders)
+            {
+                recorders.Resize(createInfo.commandRecorders);
+            }
         }
 
-        RSBL_LOG_INFO("Found suitable graphics adapter: {}", static_cast<void*>(device->adapter));
+        RSBL_LOG_INFO("Command recorders set up: {} recorders, {} frames in flight",
+                      device->commandRecorders,
+                      device->framesInFlight);
 
-        // Create D3D12 device
-        hr = D3D12CreateDevice(
-            device->adapter, D3D_FEATURE_LEVEL_12_1, IID_PPV_ARGS(&device->d3d12Device));
-
-        if (FAILED(hr))
+        // A few views per swapchain, so small heaps
+        gaDescriptorAllocatorCreateInfo rtvAllocatorCreateInfo = {};
+        rtvAllocatorCreateInfo.device = device.Get();
+        rtvAllocatorCreateInfo.type = gaDescriptorType::RenderTarget;
+        rtvAllocatorCreateInfo.pageSize = 16;
+        auto rtvAllocator = GaCreateDescriptorAllocator(rtvAllocatorCreateInfo);
+        if (!rtvAllocator)
         {
-            return "Failed to create D3D12 device";
+            return PendingFailure{rtvAllocator.Category()};
         }
+        device->rtvAllocator = rtvAllocator.Value();
 
-        RSBL_LOG_INFO("D3D12 device created: {}", static_cast<void*>(device->d3d12Device));
+        return device.Release();
+    }
 
-        device->internalHandle = device->d3d12Device;
+    // Made in COMMON, which is PRESENT, as a window's back buffers start out. The views go in
+    // the descriptors the old targets' were in, when there were any.
+    static Result<> CreateOffscreenTargets(DX12OffscreenSwapchain& swapchain,
+                                           uint32 width,
+                                           uint32 height)
+    {
+        swapchain.renderTargets.Clear();
+        swapchain.backBuffer = nullptr;
 
-        // Cache RTV descriptor size for later use
-        device->rtvDescriptorSize =
-            device->d3d12Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-        RSBL_LOG_INFO("RTV descriptor size: {}", device->rtvDescriptorSize);
+        D3D12_HEAP_PROPERTIES heapProperties = {};
+        heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+        D3D12_RESOURCE_DESC desc = {};
+        desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        desc.Width = width;
+        desc.Height = height;
+        desc.DepthOrArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+        ID3D12Device* device = swapchain.device->d3d12Device.Get();
+        for (uint32 i = 0; i < swapchain.rtvs.Size(); ++i)
+        {
+            RefPtr<ID3D12Resource> renderTarget;
+            if (FAILED(device->CreateCommittedResource(
+                    &heapProperties, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_COMMON,
+                    nullptr, IID_PPV_ARGS(renderTarget.ReleaseAndGetAddressOf()))))
+            {
+                return {ErrorCategory::OutOfMemory, "Failed to create an offscreen render target"};
+            }
 
-        // Create command queue
-        D3D12_COMMAND_QUEUE_DESC queueDesc = {};
-        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
-        queueDesc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
-        queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
-        queueDesc.NodeMask = 0;
+            D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = {
+                static_cast<SIZE_T>(swapchain.rtvs[i].cpuHandle)};
+            device->CreateRenderTargetView(renderTarget.Get(), nullptr, rtvHandle);
+            swapchain.renderTargets.PushBack(rsblMove(renderTarget));
+        }
 
-        ID3D12CommandQueue* commandQueue = nullptr;
-        hr = device->d3d12Device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&commandQueue));
-        if (FAILED(hr))
+        swapchain.width = width;
+        swapchain.height = height;
+        swapchain.currentBuffer = 0;
+        swapchain.backBuffer = swapchain.renderTargets[0].Get();
+        return ResultCode::Success;
+    }
+
+    static Result<gaSwapchain*> CreateOffscreenSwapchain(DX12Device* device,
+                                                         const gaSwapchainCreateInfo& createInfo)
+    {
+        if (createInfo.width == 0 || createInfo.height == 0)
+        {
+            return {ErrorCategory::InvalidArgument, "Offscreen swapchains need a size"};
+        }
+        if (createInfo.bufferCount < 2 || createInfo.bufferCount > 4)
         {
-            return "Failed to create command queue";
+            return {ErrorCategory::InvalidArgument,
+                    "Swapchain buffer count must be between 2 and 4"};
         }
 
-        RSBL_LOG_INFO("Command queue created: {}", static_cast<void*>(commandQueue));
-        device->commandQueues.PushBack(commandQueue);
+        auto swapchain = rsbl::UniquePtr(new DX12OffscreenSwapchain());
+        swapchain->device = device;
+        swapchain->format = gaFormat::R8G8B8A8Unorm;
+        swapchain->rtvAllocator = device->rtvAllocator;
+        for (uint32 i = 0; i < createInfo.bufferCount; ++i)
+        {
+            auto rtv = GaAllocateDescriptor(device->rtvAllocator);
+            if (!rtv)
+            {
+                return PendingFailure{rtv.Category()};
+            }
+            swapchain->rtvs.PushBack(rtv.Value());
+        }
+        if (auto created = CreateOffscreenTargets(*swapchain, createInfo.width, createInfo.height);
+            !created)
+        {
+            return PendingFailure{created.Category()};
+        }
 
-        return device.Release();
+        RSBL_LOG_INFO("Offscreen swapchain created: {} targets of {}x{}",
+                      createInfo.bufferCount,
+                      createInfo.width,
+                      createInfo.height);
+        return swapchain.Release();
     }
 
     Result<gaSwapchain*> CreateDX12Swapchain(const gaSwapchainCreateInfo& createInfo)
@@ -227,6 +682,11 @@ namespace backend
             return "No command queues available on device";
         }
 
+        if (createInfo.offscreen)
+        {
+            return CreateOffscreenSwapchain(dx12Device, createInfo);
+        }
+
         // Decode platform handles
         HWND hwnd = static_cast<HWND>(createInfo.windowHandle);
         if (hwnd == nullptr)
@@ -236,6 +696,34 @@ namespace backend
 
         auto swapchain = rsbl::UniquePtr(new DX12Swapchain());
 
+        // Tearing presents need the flip model on Windows 10 1607 or later with a driver that
+        // allows it. Without it Immediate falls back to Mailbox, and VRR to Vsync.
+        BOOL allowTearing = FALSE;
+        RefPtr<IDXGIFactory5> factory5;
+        if (SUCCEEDED(dx12Device->dxgiFactory->QueryInterface(
+                IID_PPV_ARGS(factory5.ReleaseAndGetAddressOf()))) &&
+            FAILED(factory5->CheckFeatureSupport(
+                DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing))))
+        {
+            allowTearing = FALSE;
+        }
+
+        // Mailbox is a sync interval of 0 without tearing: in a window the compositor shows the
+        // newest present each refresh and drops the rest
+        swapchain->presentMode = createInfo.presentMode;
+        if (!allowTearing && createInfo.presentMode == gaPresentMode::Immediate)
+        {
+            swapchain->presentMode = gaPresentMode::Mailbox;
+        }
+        else if (!allowTearing && createInfo.presentMode == gaPresentMode::Vrr)
+        {
+            swapchain->presentMode = gaPresentMode::Vsync;
+        }
+        const bool tearing = swapchain->presentMode == gaPresentMode::Immediate ||
+                             swapchain->presentMode == gaPresentMode::Vrr;
+        swapchain->syncInterval = swapchain->presentMode == gaPresentMode::Vsync ? 1 : 0;
+        swapchain->presentFlags = tearing ? DXGI_PRESENT_ALLOW_TEARING : 0;
+
         // Create swapchain description
         DXGI_SWAP_CHAIN_DESC1 swapchainDesc = {};
         swapchainDesc.Width = createInfo.width;
@@ -249,17 +737,24 @@ namespace backend
         swapchainDesc.Scaling = DXGI_SCALING_STRETCH;
         swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
         swapchainDesc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
-        swapchainDesc.Flags = 0;
+        // The tearing flag is set whenever it's allowed, a swapchain can't gain it on resize
+        swapchainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT |
+                              (allowTearing ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0);
+        swapchain->flags = swapchainDesc.Flags;
+        swapchain->device = dx12Device;
+        swapchain->width = createInfo.width;
+        swapchain->height = createInfo.height;
+        swapchain->format = gaFormat::R8G8B8A8Unorm;
 
         // Create swapchain
-        IDXGISwapChain1* tempSwapchain = nullptr;
+        RefPtr<IDXGISwapChain1> tempSwapchain;
         HRESULT hr = dx12Device->dxgiFactory->CreateSwapChainForHwnd(
-            dx12Device->commandQueues[0], // Use first command queue
+            dx12Device->commandQueues[0].Get(), // Use first command queue
             hwnd,
             &swapchainDesc,
             nullptr, // Fullscreen desc
             nullptr, // Restrict output
-            &tempSwapchain);
+            tempSwapchain.ReleaseAndGetAddressOf());
 
         if (FAILED(hr))
         {
@@ -267,55 +762,4440 @@ namespace backend
         }
 
         // Query for IDXGISwapChain3 interface
-        hr = tempSwapchain->QueryInterface(IID_PPV_ARGS(&swapchain->dxgiSwapchain));
-        tempSwapchain->Release();
+        hr = tempSwapchain->QueryInterface(
+            IID_PPV_ARGS(swapchain->dxgiSwapchain.ReleaseAndGetAddressOf()));
+        tempSwapchain.Reset();
 
         if (FAILED(hr))
         {
             return "Failed to query IDXGISwapChain3 interface";
         }
 
-        RSBL_LOG_INFO("Swapchain created: {}", static_cast<void*>(swapchain->dxgiSwapchain));
+        RSBL_LOG_INFO("Swapchain created: {}", static_cast<void*>(swapchain->dxgiSwapchain.Get()));
 
-        swapchain->internalHandle = swapchain->dxgiSwapchain;
-
-        // Create RTV descriptor heap
-        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-        rtvHeapDesc.NumDescriptors = swapchainDesc.BufferCount;
-        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-        rtvHeapDesc.NodeMask = 0;
-
-        hr = dx12Device->d3d12Device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&swapchain->rtvHeap));
-        if (FAILED(hr))
+        swapchain->internalHandle = swapchain->dxgiSwapchain.Get();
+        if (FAILED(swapchain->dxgiSwapchain->QueryInterface(
+                IID_PPV_ARGS(swapchain->media.ReleaseAndGetAddressOf()))))
         {
-            return "Failed to create RTV descriptor heap";
+            swapchain->media.Reset();
         }
 
-        RSBL_LOG_INFO("RTV descriptor heap created: {}", static_cast<void*>(swapchain->rtvHeap));
+        // With the waitable object, the swapchain's own latency replaces the device's default of 3
+        if (FAILED(swapchain->dxgiSwapchain->SetMaximumFrameLatency(createInfo.maxFrameLatency)))
+        {
+            return "Failed to set the swapchain's frame latency";
+        }
+        swapchain->frameLatencyWaitable = swapchain->dxgiSwapchain->GetFrameLatencyWaitableObject();
+        if (swapchain->frameLatencyWaitable == nullptr)
+        {
+            return "Failed to get the swapchain's frame latency waitable object";
+        }
 
-        // Get render targets and create RTVs
-        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = swapchain->rtvHeap->GetCPUDescriptorHandleForHeapStart();
+        // The Windows alt+enter toggle resizes behind the app's back, and DXGI's fullscreen
+        // would stop tearing anyway
+        dx12Device->dxgiFactory->MakeWindowAssociation(hwnd, DXGI_MWA_NO_ALT_ENTER);
 
+        // Render target views come from the device's allocator rather than a heap of their own
+        swapchain->rtvAllocator = dx12Device->rtvAllocator;
         for (UINT i = 0; i < swapchainDesc.BufferCount; ++i)
         {
-            ID3D12Resource* renderTarget = nullptr;
-            hr = swapchain->dxgiSwapchain->GetBuffer(i, IID_PPV_ARGS(&renderTarget));
+            RefPtr<ID3D12Resource> renderTarget;
+            hr = swapchain->dxgiSwapchain->GetBuffer(
+                i, IID_PPV_ARGS(renderTarget.ReleaseAndGetAddressOf()));
             if (FAILED(hr))
             {
                 return "Failed to get swapchain buffer";
             }
 
-            dx12Device->d3d12Device->CreateRenderTargetView(renderTarget, nullptr, rtvHandle);
-            swapchain->renderTargets.PushBack(renderTarget);
+            auto rtv = GaAllocateDescriptor(dx12Device->rtvAllocator);
+            if (!rtv)
+            {
+                return PendingFailure{rtv.Category()};
+            }
+            swapchain->rtvs.PushBack(rtv.Value());
 
-            RSBL_LOG_INFO("Render target {} created: {}", i, static_cast<void*>(renderTarget));
+            D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = {static_cast<SIZE_T>(rtv.Value().cpuHandle)};
+            dx12Device->d3d12Device->CreateRenderTargetView(renderTarget.Get(), nullptr, rtvHandle);
 
-            rtvHandle.ptr += dx12Device->rtvDescriptorSize;
+            RSBL_LOG_INFO("Render target {} created: {}", i, static_cast<void*>(renderTarget.Get()));
+            swapchain->renderTargets.PushBack(rsblMove(renderTarget));
         }
+        swapchain->currentBuffer = swapchain->dxgiSwapchain->GetCurrentBackBufferIndex();
+        swapchain->backBuffer = swapchain->renderTargets[swapchain->currentBuffer].Get();
 
+        RSBL_LOG_INFO("Present mode: {}, frame latency: {}",
+                      static_cast<int>(swapchain->presentMode),
+                      createInfo.maxFrameLatency);
         return swapchain.Release();
     }
 
+    // Each present signals the waitable once, so a wait skipped is one owed
+    static Result<> WaitForFrameLatency(DX12Swapchain& swapchain, uint32 timeoutMs)
+    {
+        if (swapchain.waited)
+        {
+            return ResultCode::Success;
+        }
+
+        const DWORD waited = WaitForSingleObjectEx(swapchain.frameLatencyWaitable, timeoutMs, TRUE);
+        if (waited == WAIT_TIMEOUT)
+        {
+            return {ErrorCategory::Timeout, "Timed out waiting for the swapchain"};
+        }
+        if (waited != WAIT_OBJECT_0)
+        {
+            return {ErrorCategory::Platform, "Failed to wait for the swapchain"};
+        }
+        swapchain.waited = true;
+        return ResultCode::Success;
+    }
+
+    // ResizeBuffers needs every reference to the back buffers gone, on the GPU too. Only the
+    // graphics queue's frames up to the last present render to them, so only those are waited
+    // for, not the device.
+    static Result<> ResizeBackBuffers(DX12Swapchain& swapchain, uint32 width, uint32 height)
+    {
+        const uint32 graphics = static_cast<uint32>(gaQueueType::Graphics);
+        if (!swapchain.device->frameFences[graphics].Wait(swapchain.lastFenceValue))
+        {
+            return {ErrorCategory::Graphics, "Failed to wait on the back buffers' frames"};
+        }
+
+        swapchain.renderTargets.Clear();
+        swapchain.backBuffer = nullptr;
+        HRESULT hr = swapchain.dxgiSwapchain->ResizeBuffers(
+            0, width, height, DXGI_FORMAT_UNKNOWN, swapchain.flags);
+        if (FAILED(hr))
+        {
+            return {ErrorCategory::Graphics, "Failed to resize the swapchain's buffers"};
+        }
+
+        // The views go back in the descriptors the old buffers' were in
+        for (uint32 i = 0; i < swapchain.rtvs.Size(); ++i)
+        {
+            RefPtr<ID3D12Resource> renderTarget;
+            hr = swapchain.dxgiSwapchain->GetBuffer(
+                i, IID_PPV_ARGS(renderTarget.ReleaseAndGetAddressOf()));
+            if (FAILED(hr))
+            {
+                return {ErrorCategory::Graphics, "Failed to get swapchain buffer"};
+            }
+
+            D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = {
+                static_cast<SIZE_T>(swapchain.rtvs[i].cpuHandle)};
+            swapchain.device->d3d12Device->CreateRenderTargetView(
+                renderTarget.Get(), nullptr, rtvHandle);
+            swapchain.renderTargets.PushBack(rsblMove(renderTarget));
+        }
+
+        swapchain.width = width;
+        swapchain.height = height;
+        swapchain.currentBuffer = swapchain.dxgiSwapchain->GetCurrentBackBufferIndex();
+        swapchain.backBuffer = swapchain.renderTargets[swapchain.currentBuffer].Get();
+        return ResultCode::Success;
+    }
+
+    // Nothing to wait for but a resize, which waits for the frames using the old targets
+    static Result<> WaitForOffscreenSwapchain(DX12OffscreenSwapchain& swapchain)
+    {
+        const bool same = swapchain.resizeWidth == swapchain.width &&
+                          swapchain.resizeHeight == swapchain.height;
+        if (swapchain.resizeWidth == 0 || swapchain.resizeHeight == 0 || same)
+        {
+            return ResultCode::Success;
+        }
+
+        const uint32 graphics = static_cast<uint32>(gaQueueType::Graphics);
+        if (!swapchain.device->frameFences[graphics].Wait(swapchain.lastFenceValue))
+        {
+            return {ErrorCategory::Graphics, "Failed to wait on the render targets' frames"};
+        }
+        return CreateOffscreenTargets(swapchain, swapchain.resizeWidth, swapchain.resizeHeight);
+    }
+
+    Result<> WaitForDX12Swapchain(gaSwapchain* baseSwapchain, uint32 timeoutMs)
+    {
+        if (baseSwapchain->offscreen)
+        {
+            return WaitForOffscreenSwapchain(*static_cast<DX12OffscreenSwapchain*>(baseSwapchain));
+        }
+
+        auto swapchain = static_cast<DX12Swapchain*>(baseSwapchain);
+
+        // Before the frame renders to a back buffer, so a resize never drops one rendered
+        const bool resize = swapchain->resizeWidth != 0 && swapchain->resizeHeight != 0 &&
+                            (swapchain->resizeWidth != swapchain->width ||
+                             swapchain->resizeHeight != swapchain->height);
+        if (!swapchain->waited && resize)
+        {
+            if (auto resized = ResizeBackBuffers(
+                    *swapchain, swapchain->resizeWidth, swapchain->resizeHeight);
+                !resized)
+            {
+                return resized;
+            }
+        }
+        return WaitForFrameLatency(*swapchain, timeoutMs);
+    }
+
+    Result<> PresentDX12(gaSwapchain* baseSwapchain)
+    {
+        if (baseSwapchain->offscreen)
+        {
+            auto offscreen = static_cast<DX12OffscreenSwapchain*>(baseSwapchain);
+            offscreen->lastFenceValue =
+                offscreen->device->frameFences[static_cast<uint32>(gaQueueType::Graphics)]
+                    .signalledValue;
+            offscreen->currentBuffer = (offscreen->currentBuffer + 1) % offscreen->rtvs.Size();
+            offscreen->backBuffer = offscreen->renderTargets[offscreen->currentBuffer].Get();
+            return ResultCode::Success;
+        }
+
+        auto swapchain = static_cast<DX12Swapchain*>(baseSwapchain);
+
+        if (auto waited = WaitForFrameLatency(*swapchain, INFINITE); !waited)
+        {
+            return waited;
+        }
+
+        // Tearing presents fail while exclusive, and DXGI takes it away when focus goes
+        UINT presentFlags = swapchain->presentFlags;
+        if (swapchain->exclusive)
+        {
+            BOOL fullscreen = FALSE;
+            swapchain->exclusive =
+                SUCCEEDED(swapchain->dxgiSwapchain->GetFullscreenState(&fullscreen, nullptr)) &&
+                fullscreen;
+        }
+        if (swapchain->exclusive)
+        {
+            presentFlags &= ~static_cast<UINT>(DXGI_PRESENT_ALLOW_TEARING);
+        }
+
+        const HRESULT hr =
+            swapchain->dxgiSwapchain->Present(swapchain->syncInterval, presentFlags);
+        swapchain->waited = false;
+        swapchain->lastFenceValue =
+            swapchain->device->frameFences[static_cast<uint32>(gaQueueType::Graphics)]
+                .signalledValue;
+        if (hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET)
+        {
+            (void)ReportDX12DeviceLost(swapchain->device);
+            return {ErrorCategory::Graphics, "The device was lost while presenting"};
+        }
+        if (FAILED(hr))
+        {
+            return {ErrorCategory::Graphics, "Failed to present"};
+        }
+
+        // A success code, the present went through but nobody will see it
+        swapchain->occluded = hr == DXGI_STATUS_OCCLUDED;
+        swapchain->currentBuffer = swapchain->dxgiSwapchain->GetCurrentBackBufferIndex();
+        swapchain->backBuffer = swapchain->renderTargets[swapchain->currentBuffer].Get();
+        return ResultCode::Success;
+    }
+
+    Result<> SetDX12ExclusiveFullscreen(gaSwapchain* baseSwapchain, bool exclusive)
+    {
+        auto swapchain = static_cast<DX12Swapchain*>(baseSwapchain);
+
+        // Sends the window messages, which the thread pumping them answers
+        const HRESULT hr =
+            swapchain->dxgiSwapchain->SetFullscreenState(exclusive ? TRUE : FALSE, nullptr);
+        if (FAILED(hr))
+        {
+            // DXGI_ERROR_NOT_CURRENTLY_AVAILABLE, another app has the output or the window isn't
+            // in front
+            return {ErrorCategory::Graphics,
+                    exclusive ? "Failed to enter exclusive fullscreen"
+                              : "Failed to leave exclusive fullscreen"};
+        }
+        swapchain->exclusive = exclusive;
+        RSBL_LOG_INFO("Swapchain {} exclusive fullscreen", exclusive ? "entered" : "left");
+        return ResultCode::Success;
+    }
+
+    static gaPresentPath PresentPath(DXGI_FRAME_PRESENTATION_MODE mode)
+    {
+        switch (mode)
+        {
+        case DXGI_FRAME_PRESENTATION_MODE_COMPOSED:
+            return gaPresentPath::Composed;
+        case DXGI_FRAME_PRESENTATION_MODE_OVERLAY:
+            return gaPresentPath::Overlay;
+        case DXGI_FRAME_PRESENTATION_MODE_NONE:
+            return gaPresentPath::IndependentFlip;
+        default:
+            return gaPresentPath::Unknown;
+        }
+    }
+
+    Result<> GetDX12PresentStats(gaSwapchain* baseSwapchain, gaPresentStats& presentStats)
+    {
+        auto swapchain = static_cast<DX12Swapchain*>(baseSwapchain);
+
+        // The media statistics are the usual ones with the composition mode on top
+        DXGI_FRAME_STATISTICS statistics{};
+        HRESULT hr;
+        if (swapchain->media)
+        {
+            DXGI_FRAME_STATISTICS_MEDIA media{};
+            hr = swapchain->media->GetFrameStatisticsMedia(&media);
+            if (SUCCEEDED(hr))
+            {
+                statistics.PresentCount = media.PresentCount;
+                statistics.SyncQPCTime = media.SyncQPCTime;
+                swapchain->path = PresentPath(media.CompositionMode);
+            }
+        }
+        else
+        {
+            hr = swapchain->dxgiSwapchain->GetFrameStatistics(&statistics);
+        }
+        UINT lastPresentCount = 0;
+        if (SUCCEEDED(hr) &&
+            SUCCEEDED(swapchain->dxgiSwapchain->GetLastPresentCount(&lastPresentCount)))
+        {
+            // DXGI numbers presents its own way, but the latest one is ours too
+            const uint32 behind = lastPresentCount - statistics.PresentCount;
+            swapchain->displayedPresent = swapchain->presentCount - behind;
+            // SyncQPCTime is the refresh's QueryPerformanceCounter, Clock::NowTicks's clock
+            swapchain->displayedTicks = static_cast<uint64>(statistics.SyncQPCTime.QuadPart);
+        }
+        else if (hr != DXGI_ERROR_FRAME_STATISTICS_DISJOINT)
+        {
+            // Disjoint is a mode change or the like, which the next read gets past
+            return {ErrorCategory::NotFound, "The swapchain has no frame statistics"};
+        }
+
+        presentStats.displayedPresent = swapchain->displayedPresent;
+        presentStats.displayedTicks = swapchain->displayedTicks;
+        presentStats.exact = true;
+        presentStats.path = swapchain->path;
+        return ResultCode::Success;
+    }
+
+    Result<> BeginDX12Frame(gaDevice* baseDevice)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        DX12Frame& frame = device->CurrentFrame();
+        for (DynamicArray<DX12CommandRecorder>& recorders : frame.recorders)
+        {
+            for (DX12CommandRecorder& recorder : recorders)
+            {
+                if (recorder.used > 0 && recorder.lists[recorder.used - 1]->recording)
+                {
+                    return "A command list from framesInFlight frames back is still recording";
+                }
+            }
+        }
+
+        for (uint32 queue = 0; queue < kQueueTypes; ++queue)
+        {
+            if (!device->frameFences[queue].Wait(frame.fenceValues[queue]))
+            {
+                return "Failed to wait for a frame in flight";
+            }
+
+            for (DX12CommandRecorder& recorder : frame.recorders[queue])
+            {
+                if (recorder.used > 0 && FAILED(recorder.allocator->Reset()))
+                {
+                    return "Failed to reset a command allocator";
+                }
+                recorder.used = 0;
+            }
+        }
+        return ResultCode::Success;
+    }
+
+    Result<> WaitForDX12Idle(gaDevice* baseDevice)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+
+        // Signalled after everything on the queue, the frame fence covers upload and streaming
+        // work as well as frames
+        for (uint32 queue = 0; queue < kQueueTypes; ++queue)
+        {
+            DX12Fence& fence = device->frameFences[queue];
+            if (FAILED(device->commandQueues[queue]->Signal(fence.d3d12Fence.Get(),
+                                                            fence.signalledValue + 1)))
+            {
+                return "Failed to signal the frame fence";
+            }
+            if (!fence.Wait(++fence.signalledValue))
+            {
+                return "Failed to wait for the GPU to go idle";
+            }
+        }
+        return ResultCode::Success;
+    }
+
+    Result<gaCommandList*> BeginDX12CommandList(gaDevice* baseDevice,
+                                                gaQueueType queue,
+                                                uint32 recorderIndex)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        const D3D12_COMMAND_LIST_TYPE type = kCommandListTypes[static_cast<uint32>(queue)];
+        DX12CommandRecorder& recorder =
+            device->CurrentFrame().recorders[static_cast<uint32>(queue)][recorderIndex];
+
+        // An allocator takes one list's commands at a time
+        if (recorder.used > 0 && recorder.lists[recorder.used - 1]->recording)
+        {
+            return "The recorder is already recording a command list";
+        }
+
+        if (!recorder.allocator &&
+            FAILED(device->d3d12Device->CreateCommandAllocator(
+                type, IID_PPV_ARGS(recorder.allocator.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create a command allocator";
+        }
+
+        if (recorder.used < recorder.lists.Size())
+        {
+            DX12CommandList* list = recorder.lists[recorder.used].Get();
+            if (FAILED(list->commandList->Reset(recorder.allocator.Get(), nullptr)))
+            {
+                return "Failed to reset a command list";
+            }
+            ++recorder.used;
+            return list;
+        }
+
+        // Lists are created recording
+        auto list = rsbl::UniquePtr(new DX12CommandList());
+        if (FAILED(device->d3d12Device->CreateCommandList(
+                0, type, recorder.allocator.Get(), nullptr,
+                IID_PPV_ARGS(list->commandList.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create a command list";
+        }
+        if (device->meshShaders && type == D3D12_COMMAND_LIST_TYPE_DIRECT &&
+            FAILED(list->commandList->QueryInterface(
+                IID_PPV_ARGS(list->meshCommandList.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to get the command list's mesh shader interface";
+        }
+        if (FAILED(list->commandList->QueryInterface(
+                IID_PPV_ARGS(list->markerCommandList.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to get the command list's buffer marker interface";
+        }
+        if (device->variableRateShading && type == D3D12_COMMAND_LIST_TYPE_DIRECT &&
+            FAILED(list->commandList->QueryInterface(
+                IID_PPV_ARGS(list->shadingRateCommandList.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to get the command list's shading rate interface";
+        }
+        list->internalHandle = list->commandList.Get();
+        recorder.lists.PushBack(rsblMove(list));
+        return recorder.lists[recorder.used++].Get();
+    }
+
+    Result<> EndDX12CommandList(gaCommandList* list)
+    {
+        if (FAILED(static_cast<DX12CommandList*>(list)->commandList->Close()))
+        {
+            return "Failed to close the command list";
+        }
+        return ResultCode::Success;
+    }
+
+    Result<> SubmitDX12(gaDevice* baseDevice,
+                        gaQueueType queue,
+                        ArrayView<gaCommandList* const> lists)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+
+        // A frame submits a few dozen lists at most, usually
+        SmallArray<ID3D12CommandList*, 64> commandLists;
+        commandLists.Reserve(lists.Size());
+        for (gaCommandList* list : lists)
+        {
+            commandLists.PushBack(static_cast<DX12CommandList*>(list)->commandList.Get());
+        }
+
+        const uint32 queueIndex = static_cast<uint32>(queue);
+        ID3D12CommandQueue* commandQueue = device->commandQueues[queueIndex].Get();
+        commandQueue->ExecuteCommandLists(static_cast<UINT>(commandLists.Size()),
+                                          commandLists.Data());
+        DX12Fence& fence = device->frameFences[queueIndex];
+        if (FAILED(commandQueue->Signal(fence.d3d12Fence.Get(), fence.signalledValue + 1)))
+        {
+            return "Failed to signal the frame fence";
+        }
+        device->CurrentFrame().fenceValues[queueIndex] = ++fence.signalledValue;
+        return ResultCode::Success;
+    }
+
+    Result<gaFence*> CreateDX12Fence(gaDevice* baseDevice, uint64 initialValue)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        auto fence = rsbl::UniquePtr(new DX12Fence());
+        if (auto created = InitFence(device->d3d12Device.Get(), initialValue, *fence); !created)
+        {
+            return PendingFailure{created.Category()};
+        }
+        return fence.Release();
+    }
+
+    Result<> SignalDX12Fence(gaDevice* baseDevice, gaQueueType queue, gaFence* fence, uint64 value)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        if (FAILED(device->commandQueues[static_cast<uint32>(queue)]->Signal(
+                static_cast<DX12Fence*>(fence)->d3d12Fence.Get(), value)))
+        {
+            return "Failed to signal the fence";
+        }
+        return ResultCode::Success;
+    }
+
+    Result<> QueueWaitForDX12Fence(gaDevice* baseDevice,
+                                   gaQueueType queue,
+                                   gaFence* fence,
+                                   uint64 value)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        if (FAILED(device->commandQueues[static_cast<uint32>(queue)]->Wait(
+                static_cast<DX12Fence*>(fence)->d3d12Fence.Get(), value)))
+        {
+            return "Failed to make the queue wait for the fence";
+        }
+        return ResultCode::Success;
+    }
+
+    uint64 GetDX12FenceValue(gaFence* fence)
+    {
+        return static_cast<DX12Fence*>(fence)->d3d12Fence->GetCompletedValue();
+    }
+
+    Result<> WaitForDX12Fence(gaFence* fence, uint64 value)
+    {
+        if (!static_cast<DX12Fence*>(fence)->Wait(value))
+        {
+            return "Failed to wait for the fence";
+        }
+        return ResultCode::Success;
+    }
+
+    struct DX12MemoryHeap : public gaMemoryHeap
+    {
+        RefPtr<ID3D12Heap> d3d12Heap;
+
+        DX12MemoryHeap()
+        {
+            backend = gaBackend::DX12;
+            internalHandle = nullptr;
+        }
+    };
+
+    Result<gaMemoryHeap*> CreateDX12MemoryHeap(gaDevice* baseDevice,
+                                               gaMemoryType type,
+                                               uint64 size,
+                                               uint64 alignment)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+
+        D3D12_HEAP_DESC desc = {};
+        desc.SizeInBytes = size;
+        desc.Properties.Type = type == gaMemoryType::Upload     ? D3D12_HEAP_TYPE_UPLOAD
+                               : type == gaMemoryType::Readback ? D3D12_HEAP_TYPE_READBACK
+                                                                : D3D12_HEAP_TYPE_DEFAULT;
+        desc.Alignment = alignment;
+        // On tier 1 a heap holds one kind of resource. Buffers are what gets sub-allocated most,
+        // textures there stay committed until heaps are asked for by kind.
+        desc.Flags = device->resourceHeapTier == D3D12_RESOURCE_HEAP_TIER_1
+                         ? D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS
+                         : D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
+
+        auto heap = rsbl::UniquePtr(new DX12MemoryHeap());
+        if (FAILED(device->d3d12Device->CreateHeap(
+                &desc, IID_PPV_ARGS(heap->d3d12Heap.ReleaseAndGetAddressOf()))))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create a D3D12 heap"};
+        }
+        heap->internalHandle = heap->d3d12Heap.Get();
+        return heap.Release();
+    }
+
+    Result<gaMemoryHeap*> CreateDX12TileHeap(gaDevice* baseDevice, uint64 size, bool textures)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+
+        D3D12_HEAP_DESC desc = {};
+        desc.SizeInBytes = size;
+        desc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+        desc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        // Reserved textures are never render targets here, so tier 1 takes them in a texture heap
+        if (device->resourceHeapTier != D3D12_RESOURCE_HEAP_TIER_1)
+        {
+            desc.Flags = D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
+        }
+        else
+        {
+            desc.Flags = textures ? D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES
+                                  : D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+        }
+
+        auto heap = rsbl::UniquePtr(new DX12MemoryHeap());
+        if (FAILED(device->d3d12Device->CreateHeap(
+                &desc, IID_PPV_ARGS(heap->d3d12Heap.ReleaseAndGetAddressOf()))))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create a D3D12 tile heap"};
+        }
+        heap->internalHandle = heap->d3d12Heap.Get();
+        return heap.Release();
+    }
+
+    Result<gaMemoryBudget> QueryDX12MemoryBudget(gaDevice* baseDevice)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+
+        // Windows 10 has IDXGIAdapter3 everywhere D3D12 runs
+        RefPtr<IDXGIAdapter3> adapter;
+        if (FAILED(device->adapter->QueryInterface(IID_PPV_ARGS(adapter.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to get IDXGIAdapter3 for the memory budget";
+        }
+
+        DXGI_QUERY_VIDEO_MEMORY_INFO local = {};
+        DXGI_QUERY_VIDEO_MEMORY_INFO nonLocal = {};
+        if (FAILED(adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &local)) ||
+            FAILED(adapter->QueryVideoMemoryInfo(
+                0, DXGI_MEMORY_SEGMENT_GROUP_NON_LOCAL, &nonLocal)))
+        {
+            return "Failed to query video memory info";
+        }
+
+        gaMemoryBudget budget;
+        budget.localBudget = local.Budget;
+        budget.localUsage = local.CurrentUsage;
+        budget.nonLocalBudget = nonLocal.Budget;
+        budget.nonLocalUsage = nonLocal.CurrentUsage;
+        return budget;
+    }
+
+    // Compute skinning. The shader is compiled when a pass is created, and reads everything through
+    // root parameters, so there's no descriptor heap to manage:
+    //   0  root constants  vertexCount, jointCount
+    //   1  root SRV        bind pose, one SkinVertex per vertex
+    //   2  root SRV        this frame's palettes, three float4 rows per joint
+    //   3  root UAV        skinned vertices, instance i's from i * vertexCount
+    // Buffers decay to COMMON when the command list using them finishes and are promoted again on
+    // first use, so neither the dispatch nor the passes reading the output need barriers.
+
+    constexpr uint32 kSkinningFramesInFlight = 3;
+
+    // Structured buffers pack tightly, so these match the shader's structs
+    static_assert(sizeof(gaSkinVertex) == 56, "SkinVertex layout");
+    static_assert(sizeof(gaSkinnedVertex) == 40, "SkinnedVertex layout");
+
+    constexpr char kSkinningShader[] = R"(
+struct SkinVertex
+{
+    float3 position;
+    float3 normal;
+    float4 tangent;
+    uint2 joints;  // 4 x uint16
+    uint2 weights; // 4 x unorm16
+};
+
+struct SkinnedVertex
+{
+    float3 position;
+    float3 normal;
+    float4 tangent;
+};
+
+cbuffer Constants : register(b0)
+{
+    uint vertexCount;
+    uint jointCount;
+};
+
+StructuredBuffer<SkinVertex> bindPose : register(t0);
+StructuredBuffer<float4> palettes : register(t1);
+RWStructuredBuffer<SkinnedVertex> skinned : register(u0);
+
+float3 SafeNormalize(float3 v)
+{
+    const float lengthSquared = dot(v, v);
+    return lengthSquared > 0.0 ? v * rsqrt(lengthSquared) : v;
+}
+
+[numthreads(64, 1, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+    if (id.x >= vertexCount)
+    {
+        return;
+    }
+
+    const SkinVertex input = bindPose[id.x];
+    const uint joints[4] = {input.joints.x & 0xffff, input.joints.x >> 16,
+                            input.joints.y & 0xffff, input.joints.y >> 16};
+    const float4 weights = float4(input.weights.x & 0xffff, input.weights.x >> 16,
+                                  input.weights.y & 0xffff, input.weights.y >> 16) / 65535.0;
+
+    // The weighted sum of the joints' matrices, a row per float4
+    float4 rows[3] = {float4(0, 0, 0, 0), float4(0, 0, 0, 0), float4(0, 0, 0, 0)};
+    [unroll] for (uint i = 0; i < 4; ++i)
+    {
+        const uint entry = (id.y * jointCount + joints[i]) * 3;
+        rows[0] += weights[i] * palettes[entry];
+        rows[1] += weights[i] * palettes[entry + 1];
+        rows[2] += weights[i] * palettes[entry + 2];
+    }
+
+    const float4 position = float4(input.position, 1.0);
+    const float3x3 skin = float3x3(rows[0].xyz, rows[1].xyz, rows[2].xyz);
+
+    // Normals and tangents through the upper 3x3, right for rotations and uniform scale
+    SkinnedVertex output;
+    output.position =
+        float3(dot(rows[0], position), dot(rows[1], position), dot(rows[2], position));
+    output.normal = SafeNormalize(mul(skin, input.normal));
+    output.tangent = float4(SafeNormalize(mul(skin, input.tangent.xyz)), input.tangent.w);
+    skinned[id.y * vertexCount + id.x] = output;
+}
+)";
+
+    struct DX12SkinningPass : public gaSkinningPass
+    {
+        struct Frame
+        {
+            RefPtr<ID3D12CommandAllocator> allocator;
+            // Upload heap, mapped for the pass's lifetime
+            RefPtr<ID3D12Resource> palettes;
+            void* mappedPalettes = nullptr;
+            // Signalled once the frame's dispatch is done with its allocator and palettes
+            uint64 fenceValue = 0;
+        };
+
+        RefPtr<ID3D12CommandQueue> commandQueue;
+        RefPtr<ID3D12RootSignature> rootSignature;
+        RefPtr<ID3D12PipelineState> pipelineState;
+        RefPtr<ID3D12GraphicsCommandList> commandList;
+        RefPtr<ID3D12Resource> bindPose;
+        RefPtr<ID3D12Resource> output;
+        DX12Fence fence;
+
+        Frame frames[kSkinningFramesInFlight];
+        uint32 frameIndex = 0;
+
+        DX12SkinningPass()
+        {
+            backend = gaBackend::DX12;
+            internalHandle = nullptr;
+        }
+
+        ~DX12SkinningPass() override
+        {
+            RSBL_LOG_INFO("Destroying DX12 skinning pass...");
+
+            // The GPU may still be reading the palettes or writing the output
+            fence.Wait(fence.signalledValue);
+
+            for (Frame& frame : frames)
+            {
+                if (frame.mappedPalettes != nullptr)
+                {
+                    frame.palettes->Unmap(0, nullptr);
+                    frame.mappedPalettes = nullptr;
+                }
+            }
+        }
+
+        bool Submit(Frame& frame)
+        {
+            if (FAILED(commandList->Close()))
+            {
+                return false;
+            }
+            ID3D12CommandList* lists[] = {commandList.Get()};
+            commandQueue->ExecuteCommandLists(1, lists);
+            if (FAILED(commandQueue->Signal(fence.d3d12Fence.Get(), fence.signalledValue + 1)))
+            {
+                return false;
+            }
+            frame.fenceValue = ++fence.signalledValue;
+            return true;
+        }
+    };
+
+    static HRESULT CreateBuffer(ID3D12Device* device,
+                                uint64 size,
+                                D3D12_HEAP_TYPE heapType,
+                                D3D12_RESOURCE_FLAGS flags,
+                                D3D12_RESOURCE_STATES state,
+                                RefPtr<ID3D12Resource>& buffer)
+    {
+        D3D12_HEAP_PROPERTIES heapProperties = {};
+        heapProperties.Type = heapType;
+
+        D3D12_RESOURCE_DESC desc = {};
+        desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        desc.Width = size;
+        desc.Height = 1;
+        desc.DepthOrArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_UNKNOWN;
+        desc.SampleDesc.Count = 1;
+        desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        desc.Flags = flags;
+
+        return device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc, state,
+                                               nullptr,
+                                               IID_PPV_ARGS(buffer.ReleaseAndGetAddressOf()));
+    }
+
+    // A compute pipeline for an HLSL shader compiled here, with a root signature of parameters
+    static Result<> CreateComputePipeline(ID3D12Device* device,
+                                          const char* name,
+                                          const char* source,
+                                          uint64 sourceSize,
+                                          ArrayView<D3D12_ROOT_PARAMETER> parameters,
+                                          RefPtr<ID3D12RootSignature>& rootSignature,
+                                          RefPtr<ID3D12PipelineState>& pipelineState)
+    {
+        RefPtr<ID3DBlob> shader;
+        RefPtr<ID3DBlob> errors;
+        HRESULT hr = D3DCompile(source, sourceSize, name, nullptr, nullptr, "main", "cs_5_1",
+                                D3DCOMPILE_OPTIMIZATION_LEVEL3, 0,
+                                shader.ReleaseAndGetAddressOf(), errors.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            if (errors)
+            {
+                RSBL_LOG_ERROR("{}: {}", name,
+                               static_cast<const char*>(errors->GetBufferPointer()));
+            }
+            return "Failed to compile a compute shader";
+        }
+
+        for (D3D12_ROOT_PARAMETER& parameter : parameters)
+        {
+            parameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+        }
+
+        D3D12_ROOT_SIGNATURE_DESC rootDesc = {};
+        rootDesc.NumParameters = static_cast<UINT>(parameters.Size());
+        rootDesc.pParameters = parameters.Data();
+
+        RefPtr<ID3DBlob> serialized;
+        hr = D3D12SerializeRootSignature(&rootDesc, D3D_ROOT_SIGNATURE_VERSION_1,
+                                         serialized.ReleaseAndGetAddressOf(),
+                                         errors.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            return "Failed to serialize a compute root signature";
+        }
+
+        hr = device->CreateRootSignature(0, serialized->GetBufferPointer(),
+                                         serialized->GetBufferSize(),
+                                         IID_PPV_ARGS(rootSignature.ReleaseAndGetAddressOf()));
+        if (FAILED(hr))
+        {
+            return "Failed to create a compute root signature";
+        }
+
+        D3D12_COMPUTE_PIPELINE_STATE_DESC pipelineDesc = {};
+        pipelineDesc.pRootSignature = rootSignature.Get();
+        pipelineDesc.CS.pShaderBytecode = shader->GetBufferPointer();
+        pipelineDesc.CS.BytecodeLength = shader->GetBufferSize();
+        hr = device->CreateComputePipelineState(
+            &pipelineDesc, IID_PPV_ARGS(pipelineState.ReleaseAndGetAddressOf()));
+        if (FAILED(hr))
+        {
+            return "Failed to create a compute pipeline state";
+        }
+
+        return ResultCode::Success;
+    }
+
+    static Result<> CreateSkinningPipeline(ID3D12Device* device, DX12SkinningPass& pass)
+    {
+        D3D12_ROOT_PARAMETER parameters[4] = {};
+        parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        parameters[0].Constants.ShaderRegister = 0;
+        parameters[0].Constants.Num32BitValues = 2;
+        parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+        parameters[1].Descriptor.ShaderRegister = 0;
+        parameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+        parameters[2].Descriptor.ShaderRegister = 1;
+        parameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        parameters[3].Descriptor.ShaderRegister = 0;
+        return CreateComputePipeline(device, "rsbl-skinning", kSkinningShader,
+                                     sizeof(kSkinningShader) - 1, parameters,
+                                     pass.rootSignature, pass.pipelineState);
+    }
+
+    Result<gaSkinningPass*> CreateDX12SkinningPass(const gaSkinningPassCreateInfo& createInfo)
+    {
+        RSBL_LOG_INFO("Creating DX12 skinning pass...");
+
+        auto dx12Device = static_cast<DX12Device*>(createInfo.device);
+        if (dx12Device->commandQueues.Size() == 0)
+        {
+            return "No command queues available on device";
+        }
+        ID3D12Device* device = dx12Device->d3d12Device.Get();
+
+        auto pass = rsbl::UniquePtr(new DX12SkinningPass());
+        pass->vertexCount = createInfo.vertexCount;
+        pass->jointCount = createInfo.jointCount;
+        pass->instanceCount = createInfo.instanceCount;
+        // The graphics queue, so the passes drawing the output are ordered after the dispatch
+        pass->commandQueue = dx12Device->commandQueues[0];
+
+        if (auto pipeline = CreateSkinningPipeline(device, *pass); !pipeline)
+        {
+            return PendingFailure{pipeline.Category()};
+        }
+
+        const uint64 bindPoseSize = uint64(createInfo.vertexCount) * sizeof(gaSkinVertex);
+        const uint64 outputSize =
+            uint64(createInfo.vertexCount) * createInfo.instanceCount * sizeof(gaSkinnedVertex);
+        const uint64 paletteSize = uint64(createInfo.jointCount) * createInfo.instanceCount *
+                                   kGaSkinningPaletteFloats * sizeof(float);
+
+        if (FAILED(CreateBuffer(device, bindPoseSize, D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COMMON,
+                                pass->bindPose)) ||
+            FAILED(CreateBuffer(device, outputSize, D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+                                D3D12_RESOURCE_STATE_COMMON, pass->output)))
+        {
+            return "Failed to create the skinning buffers";
+        }
+        pass->internalHandle = pass->output.Get();
+
+        for (DX12SkinningPass::Frame& frame : pass->frames)
+        {
+            if (FAILED(device->CreateCommandAllocator(
+                    D3D12_COMMAND_LIST_TYPE_DIRECT,
+                    IID_PPV_ARGS(frame.allocator.ReleaseAndGetAddressOf()))))
+            {
+                return "Failed to create a skinning command allocator";
+            }
+            if (FAILED(CreateBuffer(device, paletteSize, D3D12_HEAP_TYPE_UPLOAD,
+                                    D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ,
+                                    frame.palettes)))
+            {
+                return "Failed to create a skinning palette buffer";
+            }
+            // Never read on the CPU
+            D3D12_RANGE noRead = {0, 0};
+            if (FAILED(frame.palettes->Map(0, &noRead, &frame.mappedPalettes)))
+            {
+                return "Failed to map a skinning palette buffer";
+            }
+        }
+
+        // Lists are created open, and Dispatch expects it closed
+        if (FAILED(device->CreateCommandList(
+                0, D3D12_COMMAND_LIST_TYPE_DIRECT, pass->frames[0].allocator.Get(),
+                pass->pipelineState.Get(),
+                IID_PPV_ARGS(pass->commandList.ReleaseAndGetAddressOf()))) ||
+            FAILED(pass->commandList->Close()))
+        {
+            return "Failed to create the skinning command list";
+        }
+
+        if (auto fence = InitFence(device, 0, pass->fence); !fence)
+        {
+            return PendingFailure{fence.Category()};
+        }
+
+        RSBL_LOG_INFO("Skinning pass created: {} vertices, {} joints, {} instances",
+                      pass->vertexCount,
+                      pass->jointCount,
+                      pass->instanceCount);
+        return pass.Release();
+    }
+
+    Result<> UploadDX12SkinVertices(gaSkinningPass* skinningPass,
+                                    ArrayView<const gaSkinVertex> vertices)
+    {
+        auto pass = static_cast<DX12SkinningPass*>(skinningPass);
+        RefPtr<ID3D12Device> device;
+        if (FAILED(pass->bindPose->GetDevice(IID_PPV_ARGS(device.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to get the skinning pass's device";
+        }
+
+        const uint64 size = vertices.Size() * sizeof(gaSkinVertex);
+        RefPtr<ID3D12Resource> staging;
+        void* mapped = nullptr;
+        if (FAILED(CreateBuffer(device.Get(), size, D3D12_HEAP_TYPE_UPLOAD,
+                                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ,
+                                staging)) ||
+            FAILED(staging->Map(0, nullptr, &mapped)))
+        {
+            return "Failed to create the skin vertex staging buffer";
+        }
+        memcpy(mapped, vertices.Data(), size);
+        staging->Unmap(0, nullptr);
+
+        // Everything in flight has to finish anyway, the old bind pose may be being read
+        if (!pass->fence.Wait(pass->fence.signalledValue))
+        {
+            return "Failed to wait for the skinning pass";
+        }
+
+        DX12SkinningPass::Frame& frame = pass->frames[pass->frameIndex];
+        if (FAILED(frame.allocator->Reset()) ||
+            FAILED(pass->commandList->Reset(frame.allocator.Get(), nullptr)))
+        {
+            return "Failed to reset the skinning command list";
+        }
+        pass->commandList->CopyBufferRegion(pass->bindPose.Get(), 0, staging.Get(), 0, size);
+        if (!pass->Submit(frame) || !pass->fence.Wait(pass->fence.signalledValue))
+        {
+            return "Failed to upload the skin vertices";
+        }
+        return ResultCode::Success;
+    }
+
+    Result<> DispatchDX12Skinning(gaSkinningPass* skinningPass, ArrayView<const float> palettes)
+    {
+        auto pass = static_cast<DX12SkinningPass*>(skinningPass);
+        const uint32 instances = static_cast<uint32>(
+            palettes.Size() / (uint64(pass->jointCount) * kGaSkinningPaletteFloats));
+
+        DX12SkinningPass::Frame& frame = pass->frames[pass->frameIndex];
+        pass->frameIndex = (pass->frameIndex + 1) % kSkinningFramesInFlight;
+
+        // The frame's palettes and allocator are free again once its last dispatch is done
+        if (!pass->fence.Wait(frame.fenceValue))
+        {
+            return "Failed to wait for the skinning pass";
+        }
+        memcpy(frame.mappedPalettes, palettes.Data(), palettes.Size() * sizeof(float));
+
+        ID3D12GraphicsCommandList* list = pass->commandList.Get();
+        if (FAILED(frame.allocator->Reset()) ||
+            FAILED(list->Reset(frame.allocator.Get(), pass->pipelineState.Get())))
+        {
+            return "Failed to reset the skinning command list";
+        }
+
+        const uint32 constants[2] = {pass->vertexCount, pass->jointCount};
+        list->SetComputeRootSignature(pass->rootSignature.Get());
+        list->SetComputeRoot32BitConstants(0, 2, constants, 0);
+        list->SetComputeRootShaderResourceView(1, pass->bindPose->GetGPUVirtualAddress());
+        list->SetComputeRootShaderResourceView(2, frame.palettes->GetGPUVirtualAddress());
+        list->SetComputeRootUnorderedAccessView(3, pass->output->GetGPUVirtualAddress());
+        list->Dispatch((pass->vertexCount + 63) / 64, instances, 1);
+
+        if (!pass->Submit(frame))
+        {
+            return "Failed to submit the skinning dispatch";
+        }
+        return ResultCode::Success;
+    }
+
+    // GPU culling. Two shaders, both reading everything through root parameters like skinning:
+    //
+    // The pyramid shader builds the depth pyramid in one dispatch, each texel the farthest of
+    // the up to 2x2 below it. Levels round their sizes up, so pixel p of the depth is in texel
+    // p >> level of every level, and all of them are packed in one buffer from level 0 (a copy
+    // of the depth). A thread group takes a 64x64 tile of the depth down to levels 1 to 6 in
+    // group shared memory, then the last group to finish, by a count of finished groups, takes
+    // level 6 the rest of the way:
+    //   0  root constants  depth width and height, levels, thread groups
+    //   1  root UAV        the pyramid
+    //   2  root UAV        finished groups, reset to 0 by a copy before the dispatch
+    //
+    // The cull shader tests an instance a thread, and appends the survivors' draws:
+    //   0  root constants  CullConstants
+    //   1  root SRV        instances, one CullInstance each
+    //   2  root SRV        the pyramid
+    //   3  root UAV        arguments
+    //   4  root UAV        count, reset to 0 by a copy before the dispatch
+    //   5  root UAV        visibility, a uint an instance, 1 where the last Disoccluded saw it
+    // Survivors take their slots with an atomic on the count, so their order changes from frame
+    // to frame.
+
+    constexpr uint32 kCullingFramesInFlight = 3;
+
+    // The depth a pyramid shader thread group takes down 6 levels
+    constexpr uint32 kPyramidTile = 64;
+
+    static_assert(sizeof(gaCullInstance) == 36, "CullInstance layout");
+
+    struct CullConstants
+    {
+        float frustum[6][4];
+        float viewProjection[16];
+        uint32 instanceCount;
+        uint32 depthWidth; // 0 without occlusion culling
+        uint32 depthHeight;
+        uint32 depthLevels;
+        uint32 phase; // gaCullPhase
+    };
+
+    constexpr char kPyramidShader[] = R"(
+cbuffer Constants : register(b0)
+{
+    uint depthWidth;
+    uint depthHeight;
+    uint depthLevels;
+    uint groupCount;
+};
+
+// Coherent, the last group reads what the others wrote
+globallycoherent RWStructuredBuffer<float> pyramid : register(u0);
+RWStructuredBuffer<uint> finishedGroups : register(u1);
+
+groupshared float levelA[256];
+groupshared float levelB[64];
+groupshared bool lastGroup;
+
+// Where a level starts in the pyramid, and its size
+uint LevelOffset(uint level, out uint width, out uint height)
+{
+    uint offset = 0;
+    width = depthWidth;
+    height = depthHeight;
+    for (uint l = 0; l < level; ++l)
+    {
+        offset += width * height;
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+    }
+    return offset;
+}
+
+// Past the edge is 0, which never wins against depth, so an odd edge is the farthest of the
+// texels it does have below
+float Load(uint offset, uint width, uint height, uint2 texel)
+{
+    return all(texel < uint2(width, height)) ? pyramid[offset + texel.y * width + texel.x] : 0;
+}
+
+float Farthest(uint offset, uint width, uint height, uint2 texel)
+{
+    const uint2 below = texel * 2;
+    return max(max(Load(offset, width, height, below),
+                   Load(offset, width, height, below + uint2(1, 0))),
+               max(Load(offset, width, height, below + uint2(0, 1)),
+                   Load(offset, width, height, below + uint2(1, 1))));
+}
+
+void Store(uint level, uint2 texel, float depth)
+{
+    uint width;
+    uint height;
+    const uint offset = LevelOffset(level, width, height);
+    if (level < depthLevels && all(texel < uint2(width, height)))
+    {
+        pyramid[offset + texel.y * width + texel.x] = depth;
+    }
+}
+
+float Farthest4(float a, float b, float c, float d)
+{
+    return max(max(a, b), max(c, d));
+}
+
+[numthreads(256, 1, 1)]
+void main(uint3 group : SV_GroupID, uint index : SV_GroupIndex)
+{
+    // A 4x4 block of the depth a thread, 16x16 of them, down to its level 2 texel
+    const uint2 block = group.xy * 16 + uint2(index % 16, index / 16);
+    float level1[4];
+    [unroll] for (uint i = 0; i < 4; ++i)
+    {
+        const uint2 texel = block * 2 + uint2(i & 1, i >> 1);
+        level1[i] = Farthest(0, depthWidth, depthHeight, texel);
+        Store(1, texel, level1[i]);
+    }
+    levelA[index] = Farthest4(level1[0], level1[1], level1[2], level1[3]);
+    Store(2, block, levelA[index]);
+    GroupMemoryBarrierWithGroupSync();
+
+    // Then a quarter of the threads each level, between the two shared arrays
+    if (index < 64)
+    {
+        const uint2 t = uint2(index % 8, index / 8) * 2;
+        levelB[index] = Farthest4(levelA[t.y * 16 + t.x], levelA[t.y * 16 + t.x + 1],
+                                  levelA[(t.y + 1) * 16 + t.x], levelA[(t.y + 1) * 16 + t.x + 1]);
+        Store(3, group.xy * 8 + t / 2, levelB[index]);
+    }
+    GroupMemoryBarrierWithGroupSync();
+    if (index < 16)
+    {
+        const uint2 t = uint2(index % 4, index / 4) * 2;
+        levelA[index] = Farthest4(levelB[t.y * 8 + t.x], levelB[t.y * 8 + t.x + 1],
+                                  levelB[(t.y + 1) * 8 + t.x], levelB[(t.y + 1) * 8 + t.x + 1]);
+        Store(4, group.xy * 4 + t / 2, levelA[index]);
+    }
+    GroupMemoryBarrierWithGroupSync();
+    if (index < 4)
+    {
+        const uint2 t = uint2(index % 2, index / 2) * 2;
+        levelB[index] = Farthest4(levelA[t.y * 4 + t.x], levelA[t.y * 4 + t.x + 1],
+                                  levelA[(t.y + 1) * 4 + t.x], levelA[(t.y + 1) * 4 + t.x + 1]);
+        Store(5, group.xy * 2 + t / 2, levelB[index]);
+    }
+    GroupMemoryBarrierWithGroupSync();
+    if (index == 0)
+    {
+        Store(6, group.xy, Farthest4(levelB[0], levelB[1], levelB[2], levelB[3]));
+    }
+
+    if (depthLevels <= 7)
+    {
+        return;
+    }
+
+    // The last group to finish has every group's level 6 to go on from
+    DeviceMemoryBarrierWithGroupSync();
+    if (index == 0)
+    {
+        uint finished;
+        InterlockedAdd(finishedGroups[0], 1, finished);
+        lastGroup = finished == groupCount - 1;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // Every group keeps to the syncs, which have to be in uniform flow control, the others just
+    // have nothing to write
+    const bool last = lastGroup;
+    for (uint level = 7; level < depthLevels; ++level)
+    {
+        if (last)
+        {
+            uint sourceWidth;
+            uint sourceHeight;
+            const uint source = LevelOffset(level - 1, sourceWidth, sourceHeight);
+            uint width;
+            uint height;
+            const uint destination = LevelOffset(level, width, height);
+            for (uint t = index; t < width * height; t += 256)
+            {
+                pyramid[destination + t] =
+                    Farthest(source, sourceWidth, sourceHeight, uint2(t % width, t / width));
+            }
+        }
+        DeviceMemoryBarrierWithGroupSync();
+    }
+}
+)";
+
+    constexpr char kCullShader[] = R"(
+struct DrawArguments
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+struct CullInstance
+{
+    float4 sphere; // Center, radius
+    DrawArguments draw;
+};
+
+cbuffer Constants : register(b0)
+{
+    float4 planes[6];
+    float4 viewProjection[4]; // Columns
+    uint instanceCount;
+    uint depthWidth;
+    uint depthHeight;
+    uint depthLevels;
+    uint phase;
+};
+
+// gaCullPhase
+static const uint kLastVisible = 1;
+static const uint kDisoccluded = 2;
+
+StructuredBuffer<CullInstance> instances : register(t0);
+StructuredBuffer<float> pyramid : register(t1);
+RWStructuredBuffer<DrawArguments> arguments : register(u0);
+RWStructuredBuffer<uint> drawCount : register(u1);
+RWStructuredBuffer<uint> visibility : register(u2);
+
+// Whether everything in the sphere's box is behind the depth, by the pyramid level where the
+// box covers at most 2x2 texels
+bool Occluded(float3 center, float radius)
+{
+    float2 minUv = float2(1, 1);
+    float2 maxUv = float2(0, 0);
+    float nearest = 1;
+    [unroll] for (uint i = 0; i < 8; ++i)
+    {
+        const float3 corner =
+            center + radius * float3(i & 1 ? 1 : -1, i & 2 ? 1 : -1, i & 4 ? 1 : -1);
+        const float4 clip = viewProjection[0] * corner.x + viewProjection[1] * corner.y +
+                            viewProjection[2] * corner.z + viewProjection[3];
+        if (clip.w <= 0)
+        {
+            return false; // Reaches behind the camera
+        }
+        const float3 ndc = clip.xyz / clip.w;
+        const float2 uv = float2(ndc.x * 0.5 + 0.5, 0.5 - ndc.y * 0.5);
+        minUv = min(minUv, uv);
+        maxUv = max(maxUv, uv);
+        nearest = min(nearest, ndc.z);
+    }
+
+    // Partly outside the depth, which knows nothing of what's there
+    if (any(minUv < 0) || any(maxUv > 1) || nearest < 0)
+    {
+        return false;
+    }
+
+    const uint2 size = uint2(depthWidth, depthHeight);
+    const uint2 p0 = min(uint2(minUv * size), size - 1);
+    const uint2 p1 = min(uint2(maxUv * size), size - 1);
+    const uint span = max(p1.x - p0.x, p1.y - p0.y);
+    const uint level = min(span > 1 ? firstbithigh(span - 1) + 1 : 0, depthLevels - 1);
+
+    uint offset = 0;
+    uint width = depthWidth;
+    uint height = depthHeight;
+    for (uint l = 0; l < level; ++l)
+    {
+        offset += width * height;
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+    }
+
+    const uint2 t0 = p0 >> level;
+    const uint2 t1 = p1 >> level;
+    const float farthest = max(max(pyramid[offset + t0.y * width + t0.x],
+                                   pyramid[offset + t0.y * width + t1.x]),
+                               max(pyramid[offset + t1.y * width + t0.x],
+                                   pyramid[offset + t1.y * width + t1.x]));
+    return nearest > farthest;
+}
+
+[numthreads(64, 1, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+    if (id.x >= instanceCount)
+    {
+        return;
+    }
+
+    const CullInstance instance = instances[id.x];
+    const float4 center = float4(instance.sphere.xyz, 1.0);
+    bool visible = true;
+    [unroll] for (uint i = 0; i < 6; ++i)
+    {
+        visible = visible && dot(planes[i], center) >= -instance.sphere.w;
+    }
+
+    if (phase == kLastVisible)
+    {
+        visible = visible && visibility[id.x] != 0;
+    }
+    else if (visible && depthWidth > 0)
+    {
+        visible = !Occluded(instance.sphere.xyz, instance.sphere.w);
+    }
+
+    // What LastVisible drew, when it's in view, needn't be drawn again
+    if (phase == kDisoccluded)
+    {
+        const bool drawn = visibility[id.x] != 0;
+        visibility[id.x] = visible ? 1 : 0;
+        visible = visible && !drawn;
+    }
+
+    if (!visible)
+    {
+        return;
+    }
+
+    uint slot;
+    InterlockedAdd(drawCount[0], 1, slot);
+    arguments[slot] = instance.draw;
+}
+)";
+
+    struct DX12CullingPass : public gaCullingPass
+    {
+        struct Frame
+        {
+            RefPtr<ID3D12CommandAllocator> allocator;
+            // Signalled once the frame's dispatch is done with its allocator
+            uint64 fenceValue = 0;
+        };
+
+        RefPtr<ID3D12CommandQueue> commandQueue;
+        RefPtr<ID3D12RootSignature> pyramidRootSignature;
+        RefPtr<ID3D12PipelineState> pyramidPipelineState;
+        RefPtr<ID3D12RootSignature> cullRootSignature;
+        RefPtr<ID3D12PipelineState> cullPipelineState;
+        RefPtr<ID3D12GraphicsCommandList> commandList;
+        RefPtr<ID3D12Resource> instances;
+        RefPtr<ID3D12Resource> pyramid; // Without occlusion culling, none
+        RefPtr<ID3D12Resource> finishedGroups; // The pyramid shader's, with the pyramid
+        RefPtr<ID3D12Resource> visibility;
+        RefPtr<ID3D12Resource> argumentBuffer;
+        RefPtr<ID3D12Resource> countBuffer;
+        RefPtr<ID3D12Resource> zero; // Upload heap, the uint32 count is reset from
+        DX12Fence fence;
+        uint32 depthLevels = 0;
+
+        Frame frames[kCullingFramesInFlight];
+        uint32 frameIndex = 0;
+
+        DX12CullingPass()
+        {
+            backend = gaBackend::DX12;
+            arguments = nullptr;
+            count = nullptr;
+        }
+
+        ~DX12CullingPass() override
+        {
+            RSBL_LOG_INFO("Destroying DX12 culling pass...");
+
+            // The GPU may still be culling
+            fence.Wait(fence.signalledValue);
+        }
+
+        bool Submit(Frame& frame)
+        {
+            if (FAILED(commandList->Close()))
+            {
+                return false;
+            }
+            ID3D12CommandList* lists[] = {commandList.Get()};
+            commandQueue->ExecuteCommandLists(1, lists);
+            if (FAILED(commandQueue->Signal(fence.d3d12Fence.Get(), fence.signalledValue + 1)))
+            {
+                return false;
+            }
+            frame.fenceValue = ++fence.signalledValue;
+            return true;
+        }
+    };
+
+    static Result<> CreateCullingPipelines(ID3D12Device* device, DX12CullingPass& pass)
+    {
+        D3D12_ROOT_PARAMETER pyramidParameters[3] = {};
+        pyramidParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        pyramidParameters[0].Constants.ShaderRegister = 0;
+        pyramidParameters[0].Constants.Num32BitValues = 4;
+        pyramidParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        pyramidParameters[1].Descriptor.ShaderRegister = 0;
+        pyramidParameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        pyramidParameters[2].Descriptor.ShaderRegister = 1;
+        if (auto pyramid = CreateComputePipeline(device, "rsbl-depth-pyramid", kPyramidShader,
+                                                 sizeof(kPyramidShader) - 1, pyramidParameters,
+                                                 pass.pyramidRootSignature,
+                                                 pass.pyramidPipelineState);
+            !pyramid)
+        {
+            return pyramid;
+        }
+
+        D3D12_ROOT_PARAMETER cullParameters[6] = {};
+        cullParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        cullParameters[0].Constants.ShaderRegister = 0;
+        cullParameters[0].Constants.Num32BitValues = sizeof(CullConstants) / sizeof(uint32);
+        cullParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+        cullParameters[1].Descriptor.ShaderRegister = 0;
+        cullParameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+        cullParameters[2].Descriptor.ShaderRegister = 1;
+        cullParameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        cullParameters[3].Descriptor.ShaderRegister = 0;
+        cullParameters[4].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        cullParameters[4].Descriptor.ShaderRegister = 1;
+        cullParameters[5].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        cullParameters[5].Descriptor.ShaderRegister = 2;
+        return CreateComputePipeline(device, "rsbl-culling", kCullShader, sizeof(kCullShader) - 1,
+                                     cullParameters, pass.cullRootSignature,
+                                     pass.cullPipelineState);
+    }
+
+    Result<gaCullingPass*> CreateDX12CullingPass(const gaCullingPassCreateInfo& createInfo)
+    {
+        RSBL_LOG_INFO("Creating DX12 culling pass...");
+
+        auto dx12Device = static_cast<DX12Device*>(createInfo.device);
+        if (dx12Device->commandQueues.Size() == 0)
+        {
+            return "No command queues available on device";
+        }
+        ID3D12Device* device = dx12Device->d3d12Device.Get();
+
+        auto pass = rsbl::UniquePtr(new DX12CullingPass());
+        pass->instanceCount = createInfo.instanceCount;
+        pass->depthWidth = createInfo.depthWidth;
+        pass->depthHeight = createInfo.depthHeight;
+        // The graphics queue, so the draws reading the arguments are ordered after the dispatch
+        pass->commandQueue = dx12Device->commandQueues[0];
+
+        if (auto pipelines = CreateCullingPipelines(device, *pass); !pipelines)
+        {
+            return PendingFailure{pipelines.Category()};
+        }
+
+        const uint64 instancesSize = uint64(createInfo.instanceCount) * sizeof(gaCullInstance);
+        const uint64 argumentsSize =
+            uint64(createInfo.instanceCount) * sizeof(gaDrawIndexedArguments);
+        if (FAILED(CreateBuffer(device, instancesSize, D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COMMON,
+                                pass->instances)) ||
+            FAILED(CreateBuffer(device, argumentsSize, D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+                                D3D12_RESOURCE_STATE_COMMON, pass->argumentBuffer)) ||
+            FAILED(CreateBuffer(device, sizeof(uint32), D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+                                D3D12_RESOURCE_STATE_COMMON, pass->countBuffer)) ||
+            // Committed, so zeroed: nothing's been seen yet
+            FAILED(CreateBuffer(device, uint64(createInfo.instanceCount) * sizeof(uint32),
+                                D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+                                D3D12_RESOURCE_STATE_COMMON, pass->visibility)) ||
+            FAILED(CreateBuffer(device, sizeof(uint32), D3D12_HEAP_TYPE_UPLOAD,
+                                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ,
+                                pass->zero)))
+        {
+            return "Failed to create the culling buffers";
+        }
+        pass->arguments = pass->argumentBuffer.Get();
+        pass->count = pass->countBuffer.Get();
+
+        void* mapped = nullptr;
+        if (FAILED(pass->zero->Map(0, nullptr, &mapped)))
+        {
+            return "Failed to map the culling count reset";
+        }
+        memset(mapped, 0, sizeof(uint32));
+        pass->zero->Unmap(0, nullptr);
+
+        if (createInfo.depthWidth > 0)
+        {
+            uint64 pyramidTexels = 0;
+            uint32 width = createInfo.depthWidth;
+            uint32 height = createInfo.depthHeight;
+            for (;;)
+            {
+                pyramidTexels += uint64(width) * height;
+                ++pass->depthLevels;
+                if (width == 1 && height == 1)
+                {
+                    break;
+                }
+                width = (width + 1) / 2;
+                height = (height + 1) / 2;
+            }
+            if (FAILED(CreateBuffer(device, pyramidTexels * sizeof(float),
+                                    D3D12_HEAP_TYPE_DEFAULT,
+                                    D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+                                    D3D12_RESOURCE_STATE_COMMON, pass->pyramid)) ||
+                FAILED(CreateBuffer(device, sizeof(uint32), D3D12_HEAP_TYPE_DEFAULT,
+                                    D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+                                    D3D12_RESOURCE_STATE_COMMON, pass->finishedGroups)))
+            {
+                return {ErrorCategory::OutOfMemory, "Failed to create the depth pyramid"};
+            }
+        }
+
+        for (DX12CullingPass::Frame& frame : pass->frames)
+        {
+            if (FAILED(device->CreateCommandAllocator(
+                    D3D12_COMMAND_LIST_TYPE_DIRECT,
+                    IID_PPV_ARGS(frame.allocator.ReleaseAndGetAddressOf()))))
+            {
+                return "Failed to create a culling command allocator";
+            }
+        }
+
+        // Lists are created open, and Dispatch expects it closed
+        if (FAILED(device->CreateCommandList(
+                0, D3D12_COMMAND_LIST_TYPE_DIRECT, pass->frames[0].allocator.Get(), nullptr,
+                IID_PPV_ARGS(pass->commandList.ReleaseAndGetAddressOf()))) ||
+            FAILED(pass->commandList->Close()))
+        {
+            return "Failed to create the culling command list";
+        }
+
+        if (auto fence = InitFence(device, 0, pass->fence); !fence)
+        {
+            return PendingFailure{fence.Category()};
+        }
+
+        RSBL_LOG_INFO("Culling pass created: {} instances, {} depth pyramid levels",
+                      pass->instanceCount,
+                      pass->depthLevels);
+        return pass.Release();
+    }
+
+    Result<> UploadDX12CullInstances(gaCullingPass* cullingPass,
+                                     ArrayView<const gaCullInstance> instances)
+    {
+        auto pass = static_cast<DX12CullingPass*>(cullingPass);
+        RefPtr<ID3D12Device> device;
+        if (FAILED(pass->instances->GetDevice(IID_PPV_ARGS(device.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to get the culling pass's device";
+        }
+
+        const uint64 size = instances.Size() * sizeof(gaCullInstance);
+        RefPtr<ID3D12Resource> staging;
+        void* mapped = nullptr;
+        if (FAILED(CreateBuffer(device.Get(), size, D3D12_HEAP_TYPE_UPLOAD,
+                                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ,
+                                staging)) ||
+            FAILED(staging->Map(0, nullptr, &mapped)))
+        {
+            return "Failed to create the cull instance staging buffer";
+        }
+        memcpy(mapped, instances.Data(), size);
+        staging->Unmap(0, nullptr);
+
+        // The old instances may be being read
+        if (!pass->fence.Wait(pass->fence.signalledValue))
+        {
+            return "Failed to wait for the culling pass";
+        }
+
+        DX12CullingPass::Frame& frame = pass->frames[pass->frameIndex];
+        if (FAILED(frame.allocator->Reset()) ||
+            FAILED(pass->commandList->Reset(frame.allocator.Get(), nullptr)))
+        {
+            return "Failed to reset the culling command list";
+        }
+        pass->commandList->CopyBufferRegion(pass->instances.Get(), 0, staging.Get(), 0, size);
+        if (!pass->Submit(frame) || !pass->fence.Wait(pass->fence.signalledValue))
+        {
+            return "Failed to upload the cull instances";
+        }
+        return ResultCode::Success;
+    }
+
+    static D3D12_RESOURCE_BARRIER Transition(ID3D12Resource* resource,
+                                             D3D12_RESOURCE_STATES before,
+                                             D3D12_RESOURCE_STATES after)
+    {
+        D3D12_RESOURCE_BARRIER barrier = {};
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Transition.pResource = resource;
+        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        barrier.Transition.StateBefore = before;
+        barrier.Transition.StateAfter = after;
+        return barrier;
+    }
+
+    // Builds the pyramid from the depth, which ends up in NON_PIXEL_SHADER_RESOURCE
+    static void RecordDepthPyramid(DX12CullingPass& pass, ID3D12Resource* depth)
+    {
+        ID3D12GraphicsCommandList* list = pass.commandList.Get();
+        ID3D12Resource* pyramid = pass.pyramid.Get();
+        ID3D12Resource* finishedGroups = pass.finishedGroups.Get();
+
+        // All promote from COMMON for the copies
+        list->CopyBufferRegion(
+            pyramid, 0, depth, 0, uint64(pass.depthWidth) * pass.depthHeight * sizeof(float));
+        list->CopyBufferRegion(finishedGroups, 0, pass.zero.Get(), 0, sizeof(uint32));
+        D3D12_RESOURCE_BARRIER toWrite[2] = {
+            Transition(
+                pyramid, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            Transition(finishedGroups,
+                       D3D12_RESOURCE_STATE_COPY_DEST,
+                       D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+        };
+        list->ResourceBarrier(2, toWrite);
+
+        const uint32 groupsX = (pass.depthWidth + kPyramidTile - 1) / kPyramidTile;
+        const uint32 groupsY = (pass.depthHeight + kPyramidTile - 1) / kPyramidTile;
+        const uint32 constants[4] = {
+            pass.depthWidth, pass.depthHeight, pass.depthLevels, groupsX * groupsY};
+        list->SetComputeRootSignature(pass.pyramidRootSignature.Get());
+        list->SetPipelineState(pass.pyramidPipelineState.Get());
+        list->SetComputeRoot32BitConstants(0, 4, constants, 0);
+        list->SetComputeRootUnorderedAccessView(1, pyramid->GetGPUVirtualAddress());
+        list->SetComputeRootUnorderedAccessView(2, finishedGroups->GetGPUVirtualAddress());
+        list->Dispatch(groupsX, groupsY, 1);
+
+        D3D12_RESOURCE_BARRIER toRead = Transition(pyramid,
+                                                   D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+                                                   D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        list->ResourceBarrier(1, &toRead);
+    }
+
+    Result<> DispatchDX12Culling(gaCullingPass* cullingPass, const gaCullView& view)
+    {
+        auto pass = static_cast<DX12CullingPass*>(cullingPass);
+
+        DX12CullingPass::Frame& frame = pass->frames[pass->frameIndex];
+        pass->frameIndex = (pass->frameIndex + 1) % kCullingFramesInFlight;
+
+        // The frame's allocator is free again once its last dispatch is done
+        if (!pass->fence.Wait(frame.fenceValue))
+        {
+            return "Failed to wait for the culling pass";
+        }
+
+        ID3D12GraphicsCommandList* list = pass->commandList.Get();
+        if (FAILED(frame.allocator->Reset()) || FAILED(list->Reset(frame.allocator.Get(), nullptr)))
+        {
+            return "Failed to reset the culling command list";
+        }
+
+        const bool occlusion = view.depth != nullptr && view.phase != gaCullPhase::LastVisible;
+        if (occlusion)
+        {
+            RecordDepthPyramid(*pass, static_cast<ID3D12Resource*>(view.depth));
+        }
+
+        // The count promotes from COMMON for the reset, the arguments to UNORDERED_ACCESS
+        list->CopyBufferRegion(pass->countBuffer.Get(), 0, pass->zero.Get(), 0, sizeof(uint32));
+        D3D12_RESOURCE_BARRIER toWrite = Transition(pass->countBuffer.Get(),
+                                                    D3D12_RESOURCE_STATE_COPY_DEST,
+                                                    D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        list->ResourceBarrier(1, &toWrite);
+
+        CullConstants constants = {};
+        memcpy(constants.frustum, view.frustum, sizeof(constants.frustum));
+        memcpy(constants.viewProjection, view.depthViewProjection,
+               sizeof(constants.viewProjection));
+        constants.instanceCount = pass->instanceCount;
+        constants.depthWidth = occlusion ? pass->depthWidth : 0;
+        constants.depthHeight = occlusion ? pass->depthHeight : 0;
+        constants.depthLevels = pass->depthLevels;
+        constants.phase = static_cast<uint32>(view.phase);
+
+        // Without a pyramid the shader never reads it, any buffer will do for the root SRV
+        ID3D12Resource* pyramid = occlusion ? pass->pyramid.Get() : pass->instances.Get();
+        list->SetComputeRootSignature(pass->cullRootSignature.Get());
+        list->SetPipelineState(pass->cullPipelineState.Get());
+        list->SetComputeRoot32BitConstants(
+            0, sizeof(CullConstants) / sizeof(uint32), &constants, 0);
+        list->SetComputeRootShaderResourceView(1, pass->instances->GetGPUVirtualAddress());
+        list->SetComputeRootShaderResourceView(2, pyramid->GetGPUVirtualAddress());
+        list->SetComputeRootUnorderedAccessView(3, pass->argumentBuffer->GetGPUVirtualAddress());
+        list->SetComputeRootUnorderedAccessView(4, pass->countBuffer->GetGPUVirtualAddress());
+        list->SetComputeRootUnorderedAccessView(5, pass->visibility->GetGPUVirtualAddress());
+        list->Dispatch((pass->instanceCount + 63) / 64, 1, 1);
+
+        if (!pass->Submit(frame))
+        {
+            return "Failed to submit the culling dispatch";
+        }
+        return ResultCode::Success;
+    }
+
+    // Light binning. A thread a cluster, reading everything through root parameters like
+    // skinning and culling:
+    //   0  root constants  LightBinningConstants
+    //   1  root SRV        lights, copied from the frame's upload buffer before the dispatch
+    //   2  root UAV        clusters, a count and maxLightsPerCluster light indices each
+    // A thread group turns 64 lights at a time into view-space spheres in group shared memory,
+    // and every thread tests its cluster against each of them in turn.
+
+    constexpr uint32 kLightBinningFramesInFlight = 3;
+
+    struct LightBinningConstants
+    {
+        float view[16];
+        uint32 lightCount;
+        uint32 clusterCountX;
+        uint32 clusterCountY;
+        uint32 clusterCountZ;
+        uint32 maxLightsPerCluster;
+        float nearZ;
+        float farZ;
+        float tanHalfFovX;
+        float tanHalfFovY;
+    };
+
+    constexpr char kLightBinningShader[] = R"(
+struct Light // gaPunctualLight
+{
+    float3 position;
+    float range;
+    float3 color;
+    uint type;
+    float3 direction;
+    float innerConeCos;
+    float outerConeCos;
+    float3 padding;
+};
+
+cbuffer Constants : register(b0)
+{
+    float4 view[4]; // Columns
+    uint lightCount;
+    uint clusterCountX;
+    uint clusterCountY;
+    uint clusterCountZ;
+    uint maxLightsPerCluster;
+    float nearZ;
+    float farZ;
+    float tanHalfFovX;
+    float tanHalfFovY;
+};
+
+// gaLightType
+static const uint kDirectional = 2;
+
+StructuredBuffer<Light> lights : register(t0);
+RWStructuredBuffer<uint> clusters : register(u0);
+
+// View-space center and range, a negative range for a light that reaches everywhere
+groupshared float4 spheres[64];
+
+[numthreads(64, 1, 1)]
+void main(uint3 id : SV_DispatchThreadID, uint3 thread : SV_GroupThreadID)
+{
+    // Threads past the last cluster still share the lights
+    const uint cluster = id.x;
+    const bool binning = cluster < clusterCountX * clusterCountY * clusterCountZ;
+    const uint x = cluster % clusterCountX;
+    const uint y = (cluster / clusterCountX) % clusterCountY;
+    const uint z = cluster / (clusterCountX * clusterCountY);
+
+    // The cluster's box in view space, around its corners at both ends. The first slice reaches
+    // back to the camera, for what's closer than nearZ, and tile row 0 is the top of the screen.
+    const float depthRatio = farZ / nearZ;
+    const float sliceNear = z == 0 ? 0.0 : nearZ * pow(depthRatio, float(z) / clusterCountZ);
+    const float sliceFar = nearZ * pow(depthRatio, float(z + 1) / clusterCountZ);
+    const float2 tanHalfFov = float2(tanHalfFovX, tanHalfFovY);
+    const float2 slopeMin =
+        (float2(float(x) / clusterCountX, 1.0 - float(y + 1) / clusterCountY) * 2 - 1) *
+        tanHalfFov;
+    const float2 slopeMax =
+        (float2(float(x + 1) / clusterCountX, 1.0 - float(y) / clusterCountY) * 2 - 1) *
+        tanHalfFov;
+    const float3 boxMin = float3(min(slopeMin * sliceNear, slopeMin * sliceFar), sliceNear);
+    const float3 boxMax = float3(max(slopeMax * sliceNear, slopeMax * sliceFar), sliceFar);
+
+    const uint list = cluster * (maxLightsPerCluster + 1);
+    uint count = 0;
+    for (uint first = 0; first < lightCount; first += 64)
+    {
+        // The last batch may still be being read
+        GroupMemoryBarrierWithGroupSync();
+        const uint index = first + thread.x;
+        if (index < lightCount)
+        {
+            const Light light = lights[index];
+            float4 sphere = float4(0, 0, 0, -1);
+            if (light.type != kDirectional && light.range > 0)
+            {
+                const float4 center = view[0] * light.position.x + view[1] * light.position.y +
+                                      view[2] * light.position.z + view[3];
+                sphere = float4(center.xyz, light.range);
+            }
+            spheres[thread.x] = sphere;
+        }
+        GroupMemoryBarrierWithGroupSync();
+
+        const uint batch = min(lightCount - first, 64);
+        for (uint i = 0; i < batch; ++i)
+        {
+            const float4 sphere = spheres[i];
+            const float3 offset = sphere.xyz - clamp(sphere.xyz, boxMin, boxMax);
+            const bool reaches = sphere.w < 0 || dot(offset, offset) <= sphere.w * sphere.w;
+            if (binning && reaches && count < maxLightsPerCluster)
+            {
+                clusters[list + 1 + count] = first + i;
+                ++count;
+            }
+        }
+    }
+
+    if (binning)
+    {
+        clusters[list] = count;
+    }
+}
+)";
+
+    struct DX12LightBinningPass : public gaLightBinningPass
+    {
+        struct Frame
+        {
+            RefPtr<ID3D12CommandAllocator> allocator;
+            // Upload heap, mapped for the pass's lifetime
+            RefPtr<ID3D12Resource> lights;
+            void* mappedLights = nullptr;
+            // Signalled once the frame's dispatch is done with its allocator and lights
+            uint64 fenceValue = 0;
+        };
+
+        RefPtr<ID3D12CommandQueue> commandQueue;
+        RefPtr<ID3D12RootSignature> rootSignature;
+        RefPtr<ID3D12PipelineState> pipelineState;
+        RefPtr<ID3D12GraphicsCommandList> commandList;
+        RefPtr<ID3D12Resource> lightBuffer;
+        RefPtr<ID3D12Resource> clusterBuffer;
+        DX12Fence fence;
+
+        Frame frames[kLightBinningFramesInFlight];
+        uint32 frameIndex = 0;
+
+        DX12LightBinningPass()
+        {
+            backend = gaBackend::DX12;
+            lights = nullptr;
+            clusters = nullptr;
+        }
+
+        ~DX12LightBinningPass() override
+        {
+            RSBL_LOG_INFO("Destroying DX12 light binning pass...");
+
+            // The GPU may still be reading the lights or writing the clusters
+            fence.Wait(fence.signalledValue);
+
+            for (Frame& frame : frames)
+            {
+                if (frame.mappedLights != nullptr)
+                {
+                    frame.lights->Unmap(0, nullptr);
+                    frame.mappedLights = nullptr;
+                }
+            }
+        }
+
+        bool Submit(Frame& frame)
+        {
+            if (FAILED(commandList->Close()))
+            {
+                return false;
+            }
+            ID3D12CommandList* lists[] = {commandList.Get()};
+            commandQueue->ExecuteCommandLists(1, lists);
+            if (FAILED(commandQueue->Signal(fence.d3d12Fence.Get(), fence.signalledValue + 1)))
+            {
+                return false;
+            }
+            frame.fenceValue = ++fence.signalledValue;
+            return true;
+        }
+    };
+
+    static Result<> CreateLightBinningPipeline(ID3D12Device* device, DX12LightBinningPass& pass)
+    {
+        D3D12_ROOT_PARAMETER parameters[3] = {};
+        parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        parameters[0].Constants.ShaderRegister = 0;
+        parameters[0].Constants.Num32BitValues = sizeof(LightBinningConstants) / sizeof(uint32);
+        parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+        parameters[1].Descriptor.ShaderRegister = 0;
+        parameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        parameters[2].Descriptor.ShaderRegister = 0;
+        return CreateComputePipeline(device, "rsbl-light-binning", kLightBinningShader,
+                                     sizeof(kLightBinningShader) - 1, parameters,
+                                     pass.rootSignature, pass.pipelineState);
+    }
+
+    Result<gaLightBinningPass*> CreateDX12LightBinningPass(
+        const gaLightBinningPassCreateInfo& createInfo)
+    {
+        RSBL_LOG_INFO("Creating DX12 light binning pass...");
+
+        auto dx12Device = static_cast<DX12Device*>(createInfo.device);
+        if (dx12Device->commandQueues.Size() == 0)
+        {
+            return "No command queues available on device";
+        }
+        ID3D12Device* device = dx12Device->d3d12Device.Get();
+
+        auto pass = rsbl::UniquePtr(new DX12LightBinningPass());
+        pass->maxLights = createInfo.maxLights;
+        pass->grid = {};
+        pass->grid.clusterCountX = createInfo.clusterCountX;
+        pass->grid.clusterCountY = createInfo.clusterCountY;
+        pass->grid.clusterCountZ = createInfo.clusterCountZ;
+        pass->grid.maxLightsPerCluster = createInfo.maxLightsPerCluster;
+        // The graphics queue, so the draws reading the clusters are ordered after the dispatch
+        pass->commandQueue = dx12Device->commandQueues[0];
+
+        if (auto pipeline = CreateLightBinningPipeline(device, *pass); !pipeline)
+        {
+            return PendingFailure{pipeline.Category()};
+        }
+
+        const uint64 lightsSize = uint64(createInfo.maxLights) * sizeof(gaPunctualLight);
+        const uint64 clustersSize = uint64(createInfo.clusterCountX) * createInfo.clusterCountY *
+                                    createInfo.clusterCountZ *
+                                    (uint64(createInfo.maxLightsPerCluster) + 1) * sizeof(uint32);
+        if (FAILED(CreateBuffer(device, lightsSize, D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COMMON,
+                                pass->lightBuffer)) ||
+            FAILED(CreateBuffer(device, clustersSize, D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+                                D3D12_RESOURCE_STATE_COMMON, pass->clusterBuffer)))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create the light binning buffers"};
+        }
+        pass->lights = pass->lightBuffer.Get();
+        pass->clusters = pass->clusterBuffer.Get();
+
+        for (DX12LightBinningPass::Frame& frame : pass->frames)
+        {
+            if (FAILED(device->CreateCommandAllocator(
+                    D3D12_COMMAND_LIST_TYPE_DIRECT,
+                    IID_PPV_ARGS(frame.allocator.ReleaseAndGetAddressOf()))))
+            {
+                return "Failed to create a light binning command allocator";
+            }
+            if (FAILED(CreateBuffer(device, lightsSize, D3D12_HEAP_TYPE_UPLOAD,
+                                    D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ,
+                                    frame.lights)))
+            {
+                return "Failed to create a light upload buffer";
+            }
+            // Never read on the CPU
+            D3D12_RANGE noRead = {0, 0};
+            if (FAILED(frame.lights->Map(0, &noRead, &frame.mappedLights)))
+            {
+                return "Failed to map a light upload buffer";
+            }
+        }
+
+        // Lists are created open, and Dispatch expects it closed
+        if (FAILED(device->CreateCommandList(
+                0, D3D12_COMMAND_LIST_TYPE_DIRECT, pass->frames[0].allocator.Get(),
+                pass->pipelineState.Get(),
+                IID_PPV_ARGS(pass->commandList.ReleaseAndGetAddressOf()))) ||
+            FAILED(pass->commandList->Close()))
+        {
+            return "Failed to create the light binning command list";
+        }
+
+        if (auto fence = InitFence(device, 0, pass->fence); !fence)
+        {
+            return PendingFailure{fence.Category()};
+        }
+
+        RSBL_LOG_INFO("Light binning pass created: {} lights, {}x{}x{} clusters of up to {}",
+                      pass->maxLights,
+                      createInfo.clusterCountX,
+                      createInfo.clusterCountY,
+                      createInfo.clusterCountZ,
+                      createInfo.maxLightsPerCluster);
+        return pass.Release();
+    }
+
+    Result<> DispatchDX12LightBinning(gaLightBinningPass* binningPass,
+                                      ArrayView<const gaPunctualLight> lights,
+                                      const gaLightBinningView& view)
+    {
+        auto pass = static_cast<DX12LightBinningPass*>(binningPass);
+
+        DX12LightBinningPass::Frame& frame = pass->frames[pass->frameIndex];
+        pass->frameIndex = (pass->frameIndex + 1) % kLightBinningFramesInFlight;
+
+        // The frame's lights and allocator are free again once its last dispatch is done
+        if (!pass->fence.Wait(frame.fenceValue))
+        {
+            return "Failed to wait for the light binning pass";
+        }
+
+        ID3D12GraphicsCommandList* list = pass->commandList.Get();
+        if (FAILED(frame.allocator->Reset()) ||
+            FAILED(list->Reset(frame.allocator.Get(), pass->pipelineState.Get())))
+        {
+            return "Failed to reset the light binning command list";
+        }
+
+        // The lights promote from COMMON for the copy, the clusters to UNORDERED_ACCESS
+        const uint64 lightsSize = lights.Size() * sizeof(gaPunctualLight);
+        if (lightsSize > 0)
+        {
+            memcpy(frame.mappedLights, lights.Data(), lightsSize);
+            list->CopyBufferRegion(pass->lightBuffer.Get(), 0, frame.lights.Get(), 0, lightsSize);
+            D3D12_RESOURCE_BARRIER toRead =
+                Transition(pass->lightBuffer.Get(),
+                           D3D12_RESOURCE_STATE_COPY_DEST,
+                           D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+            list->ResourceBarrier(1, &toRead);
+        }
+
+        const gaClusterGrid& grid = pass->grid;
+        LightBinningConstants constants = {};
+        memcpy(constants.view, view.view, sizeof(constants.view));
+        constants.lightCount = static_cast<uint32>(lights.Size());
+        constants.clusterCountX = grid.clusterCountX;
+        constants.clusterCountY = grid.clusterCountY;
+        constants.clusterCountZ = grid.clusterCountZ;
+        constants.maxLightsPerCluster = grid.maxLightsPerCluster;
+        constants.nearZ = view.nearZ;
+        constants.farZ = view.farZ;
+        constants.tanHalfFovX = view.tanHalfFovX;
+        constants.tanHalfFovY = view.tanHalfFovY;
+
+        const uint32 clusterCount = grid.clusterCountX * grid.clusterCountY * grid.clusterCountZ;
+        list->SetComputeRootSignature(pass->rootSignature.Get());
+        list->SetComputeRoot32BitConstants(
+            0, sizeof(LightBinningConstants) / sizeof(uint32), &constants, 0);
+        list->SetComputeRootShaderResourceView(1, pass->lightBuffer->GetGPUVirtualAddress());
+        list->SetComputeRootUnorderedAccessView(2, pass->clusterBuffer->GetGPUVirtualAddress());
+        list->Dispatch((clusterCount + 63) / 64, 1, 1);
+
+        if (!pass->Submit(frame))
+        {
+            return "Failed to submit the light binning dispatch";
+        }
+        return ResultCode::Success;
+    }
+
+    // Temporal upscaling. A thread an output pixel, with the textures through a descriptor
+    // table of the frame's slice of the pass's own shader-visible heap:
+    //   0  root constants     UpscaleConstants
+    //   1  descriptor table   t0-t3 color, depth, motion vectors, last history
+    //                         u0-u1 output, next history
+    // Two history textures take turns being read and written. Nothing is sampled, the shader
+    // filters with loads, so the root signature needs no samplers.
+
+    constexpr uint32 kUpscaleFramesInFlight = 3;
+    constexpr uint32 kUpscaleDescriptors = 6; // Per frame
+
+    struct UpscaleConstants
+    {
+        uint32 renderWidth;
+        uint32 renderHeight;
+        uint32 outputWidth;
+        uint32 outputHeight;
+        float jitter[2];
+        float motionVectorScale[2];
+        uint32 reset;
+        uint32 depthReversed;
+    };
+
+    constexpr char kUpscaleShader[] = R"(
+cbuffer Constants : register(b0)
+{
+    uint2 renderSize;
+    uint2 outputSize;
+    float2 jitter;
+    float2 motionVectorScale;
+    uint reset;
+    uint depthReversed;
+};
+
+Texture2D<float4> color : register(t0);
+Texture2D<float> depth : register(t1);
+Texture2D<float2> motionVectors : register(t2);
+Texture2D<float4> history : register(t3); // Color, and the weight of the frames in it
+RWTexture2D<float4> output : register(u0);
+RWTexture2D<float4> nextHistory : register(u1);
+
+// How much the history can outweigh a frame. More is steadier, less follows changes sooner.
+static const float kMaxHistoryWeight = 16.0;
+
+float3 ToYCoCg(float3 c)
+{
+    return float3(dot(c, float3(0.25, 0.5, 0.25)),
+                  dot(c, float3(0.5, 0.0, -0.5)),
+                  dot(c, float3(-0.25, 0.5, -0.25)));
+}
+
+float3 FromYCoCg(float3 c)
+{
+    return float3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+// Bilinear, clamped to the edges
+float4 LoadHistory(float2 position)
+{
+    const float2 texel = position - 0.5;
+    const int2 base = int2(floor(texel));
+    const float2 f = texel - float2(base);
+    const int2 last = int2(outputSize) - 1;
+    const float4 a = history.Load(int3(clamp(base, 0, last), 0));
+    const float4 b = history.Load(int3(clamp(base + int2(1, 0), 0, last), 0));
+    const float4 c = history.Load(int3(clamp(base + int2(0, 1), 0, last), 0));
+    const float4 d = history.Load(int3(clamp(base + int2(1, 1), 0, last), 0));
+    return lerp(lerp(a, b, f.x), lerp(c, d, f.x), f.y);
+}
+
+[numthreads(8, 8, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+    if (any(id.xy >= outputSize))
+    {
+        return;
+    }
+
+    // The output pixel's centre in unjittered render pixels, and the render pixel whose sample
+    // is nearest it
+    const float2 scale = float2(renderSize) / float2(outputSize);
+    const float2 position = (float2(id.xy) + 0.5) * scale;
+    const int2 nearest = int2(floor(position + jitter));
+    const int2 last = int2(renderSize) - 1;
+
+    float3 sum = 0.0;
+    float weightSum = 0.0;
+    float confidence = 0.0;
+    float3 moment1 = 0.0;
+    float3 moment2 = 0.0;
+    int2 closest = clamp(nearest, 0, last);
+    float closestDepth = depth.Load(int3(closest, 0));
+    [unroll] for (int y = -1; y <= 1; ++y)
+    {
+        [unroll] for (int x = -1; x <= 1; ++x)
+        {
+            const int2 texel = clamp(nearest + int2(x, y), 0, last);
+            const float3 value = ToYCoCg(color.Load(int3(texel, 0)).rgb);
+            const float2 offset = float2(nearest + int2(x, y)) + 0.5 - jitter - position;
+
+            // A Gaussian of render pixels, the bright samples weighed down so they don't flicker
+            const float weight = exp(-2.29 * dot(offset, offset)) / (1.0 + max(value.x, 0.0));
+            sum += value * weight;
+            weightSum += weight;
+            moment1 += value;
+            moment2 += value * value;
+
+            // How near the nearest sample is in output pixels is how much this frame counts
+            const float2 outputOffset = offset / scale;
+            confidence = max(confidence, exp(-2.29 * dot(outputOffset, outputOffset)));
+
+            const float sampleDepth = depth.Load(int3(texel, 0));
+            if (depthReversed != 0 ? sampleDepth > closestDepth : sampleDepth < closestDepth)
+            {
+                closestDepth = sampleDepth;
+                closest = texel;
+            }
+        }
+    }
+    const float3 current = sum / weightSum;
+
+    // The history is clamped to the spread of the neighbourhood, which keeps what was
+    // disoccluded or changed from ghosting
+    const float3 mean = moment1 / 9.0;
+    const float3 deviation = sqrt(abs(moment2 / 9.0 - mean * mean));
+    const float3 low = min(mean - 1.25 * deviation, current);
+    const float3 high = max(mean + 1.25 * deviation, current);
+
+    // Edges move with whatever is in front, so the motion is the nearest depth's
+    const float2 motion = motionVectors.Load(int3(closest, 0)) * motionVectorScale;
+    const float2 previous = (position + motion) / scale;
+
+    float3 result = current;
+    float historyWeight = 0.0;
+    if (reset == 0 && all(previous >= 0.0) && all(previous < float2(outputSize)))
+    {
+        const float4 lastFrame = LoadHistory(previous);
+        historyWeight = min(lastFrame.a, kMaxHistoryWeight);
+        const float3 clamped = clamp(ToYCoCg(lastFrame.rgb), low, high);
+        result = (clamped * historyWeight + current * confidence) /
+                 max(historyWeight + confidence, 1e-4);
+    }
+
+    const float3 rgb = max(FromYCoCg(result), 0.0);
+    output[id.xy] = float4(rgb, 1.0);
+    nextHistory[id.xy] = float4(rgb, historyWeight + confidence);
+}
+)";
+
+    struct DX12Upscaler : public gaUpscaler
+    {
+        struct Frame
+        {
+            RefPtr<ID3D12CommandAllocator> allocator;
+            // Signalled once the frame's dispatch is done with its allocator and descriptors
+            uint64 fenceValue = 0;
+        };
+
+        RefPtr<ID3D12CommandQueue> commandQueue;
+        RefPtr<ID3D12RootSignature> rootSignature;
+        RefPtr<ID3D12PipelineState> pipelineState;
+        RefPtr<ID3D12GraphicsCommandList> commandList;
+        RefPtr<ID3D12DescriptorHeap> descriptorHeap; // kUpscaleDescriptors a frame
+        uint32 descriptorSize = 0;
+        RefPtr<ID3D12Resource> histories[2];
+        uint32 historyIndex = 0; // The one the next dispatch reads
+        bool historyValid = false;
+        bool depthReversed = false;
+        DX12Fence fence;
+
+        Frame frames[kUpscaleFramesInFlight];
+        uint32 frameIndex = 0;
+
+        DX12Upscaler()
+        {
+            backend = gaBackend::DX12;
+        }
+
+        ~DX12Upscaler() override
+        {
+            RSBL_LOG_INFO("Destroying DX12 upscaler...");
+
+            // The GPU may still be writing the history
+            fence.Wait(fence.signalledValue);
+        }
+
+        bool Submit(Frame& frame)
+        {
+            if (FAILED(commandList->Close()))
+            {
+                return false;
+            }
+            ID3D12CommandList* lists[] = {commandList.Get()};
+            commandQueue->ExecuteCommandLists(1, lists);
+            if (FAILED(commandQueue->Signal(fence.d3d12Fence.Get(), fence.signalledValue + 1)))
+            {
+                return false;
+            }
+            frame.fenceValue = ++fence.signalledValue;
+            return true;
+        }
+    };
+
+    static Result<> CreateUpscalePipeline(ID3D12Device* device, DX12Upscaler& upscaler)
+    {
+        D3D12_DESCRIPTOR_RANGE ranges[2] = {};
+        ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+        ranges[0].NumDescriptors = 4;
+        ranges[0].OffsetInDescriptorsFromTableStart = 0;
+        ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+        ranges[1].NumDescriptors = 2;
+        ranges[1].OffsetInDescriptorsFromTableStart = 4;
+
+        D3D12_ROOT_PARAMETER parameters[2] = {};
+        parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        parameters[0].Constants.ShaderRegister = 0;
+        parameters[0].Constants.Num32BitValues = sizeof(UpscaleConstants) / sizeof(uint32);
+        parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+        parameters[1].DescriptorTable.NumDescriptorRanges = 2;
+        parameters[1].DescriptorTable.pDescriptorRanges = ranges;
+        return CreateComputePipeline(device, "rsbl-temporal-upscale", kUpscaleShader,
+                                     sizeof(kUpscaleShader) - 1, parameters,
+                                     upscaler.rootSignature, upscaler.pipelineState);
+    }
+
+    Result<gaUpscaler*> CreateDX12Upscaler(const gaUpscalerCreateInfo& createInfo)
+    {
+        RSBL_LOG_INFO("Creating DX12 upscaler...");
+
+        auto dx12Device = static_cast<DX12Device*>(createInfo.device);
+        if (dx12Device->commandQueues.Size() == 0)
+        {
+            return "No command queues available on device";
+        }
+        ID3D12Device* device = dx12Device->d3d12Device.Get();
+
+        auto upscaler = rsbl::UniquePtr(new DX12Upscaler());
+        upscaler->depthReversed = createInfo.depthReversed;
+        // The graphics queue, so the dispatch is ordered between the frame's lists
+        upscaler->commandQueue = dx12Device->commandQueues[0];
+
+        if (auto pipeline = CreateUpscalePipeline(device, *upscaler); !pipeline)
+        {
+            return PendingFailure{pipeline.Category()};
+        }
+
+        D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+        heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        heapDesc.NumDescriptors = kUpscaleDescriptors * kUpscaleFramesInFlight;
+        heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        if (FAILED(device->CreateDescriptorHeap(
+                &heapDesc, IID_PPV_ARGS(upscaler->descriptorHeap.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create the upscaler descriptor heap";
+        }
+        upscaler->descriptorSize =
+            device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+        // Half floats, so HDR color accumulates without banding
+        D3D12_HEAP_PROPERTIES heapProperties = {};
+        heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+        D3D12_RESOURCE_DESC historyDesc = {};
+        historyDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        historyDesc.Width = createInfo.outputWidth;
+        historyDesc.Height = createInfo.outputHeight;
+        historyDesc.DepthOrArraySize = 1;
+        historyDesc.MipLevels = 1;
+        historyDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+        historyDesc.SampleDesc.Count = 1;
+        historyDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+        historyDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        for (RefPtr<ID3D12Resource>& history : upscaler->histories)
+        {
+            if (FAILED(device->CreateCommittedResource(
+                    &heapProperties, D3D12_HEAP_FLAG_NONE, &historyDesc,
+                    D3D12_RESOURCE_STATE_COMMON, nullptr,
+                    IID_PPV_ARGS(history.ReleaseAndGetAddressOf()))))
+            {
+                return {ErrorCategory::OutOfMemory, "Failed to create the upscaler history"};
+            }
+        }
+
+        for (DX12Upscaler::Frame& frame : upscaler->frames)
+        {
+            if (FAILED(device->CreateCommandAllocator(
+                    D3D12_COMMAND_LIST_TYPE_DIRECT,
+                    IID_PPV_ARGS(frame.allocator.ReleaseAndGetAddressOf()))))
+            {
+                return "Failed to create an upscaler command allocator";
+            }
+        }
+
+        // Lists are created open, and Dispatch expects it closed
+        if (FAILED(device->CreateCommandList(
+                0, D3D12_COMMAND_LIST_TYPE_DIRECT, upscaler->frames[0].allocator.Get(),
+                upscaler->pipelineState.Get(),
+                IID_PPV_ARGS(upscaler->commandList.ReleaseAndGetAddressOf()))) ||
+            FAILED(upscaler->commandList->Close()))
+        {
+            return "Failed to create the upscaler command list";
+        }
+
+        if (auto fence = InitFence(device, 0, upscaler->fence); !fence)
+        {
+            return PendingFailure{fence.Category()};
+        }
+
+        RSBL_LOG_INFO("Upscaler created: {}x{} output", createInfo.outputWidth,
+                      createInfo.outputHeight);
+        return upscaler.Release();
+    }
+
+    Result<> DispatchDX12Upscale(gaUpscaler* baseUpscaler, const gaUpscaleInputs& inputs)
+    {
+        auto upscaler = static_cast<DX12Upscaler*>(baseUpscaler);
+
+        DX12Upscaler::Frame& frame = upscaler->frames[upscaler->frameIndex];
+        const uint32 firstDescriptor = upscaler->frameIndex * kUpscaleDescriptors;
+        upscaler->frameIndex = (upscaler->frameIndex + 1) % kUpscaleFramesInFlight;
+
+        // The frame's descriptors and allocator are free again once its last dispatch is done
+        if (!upscaler->fence.Wait(frame.fenceValue))
+        {
+            return "Failed to wait for the upscaler";
+        }
+
+        ID3D12GraphicsCommandList* list = upscaler->commandList.Get();
+        if (FAILED(frame.allocator->Reset()) ||
+            FAILED(list->Reset(frame.allocator.Get(), upscaler->pipelineState.Get())))
+        {
+            return "Failed to reset the upscaler command list";
+        }
+
+        ID3D12Resource* lastHistory = upscaler->histories[upscaler->historyIndex].Get();
+        ID3D12Resource* nextHistory = upscaler->histories[upscaler->historyIndex ^ 1].Get();
+        ID3D12Resource* output = static_cast<ID3D12Resource*>(inputs.output);
+
+        RefPtr<ID3D12Device> device;
+        if (FAILED(lastHistory->GetDevice(IID_PPV_ARGS(device.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to get the upscaler's device";
+        }
+        D3D12_CPU_DESCRIPTOR_HANDLE descriptor =
+            upscaler->descriptorHeap->GetCPUDescriptorHandleForHeapStart();
+        descriptor.ptr += uint64(firstDescriptor) * upscaler->descriptorSize;
+        const auto next = [&]() {
+            D3D12_CPU_DESCRIPTOR_HANDLE current = descriptor;
+            descriptor.ptr += upscaler->descriptorSize;
+            return current;
+        };
+
+        // Depth buffers are typeless, the rest are viewed in the format they were made with
+        D3D12_SHADER_RESOURCE_VIEW_DESC depthDesc = {};
+        depthDesc.Format = DXGI_FORMAT_R32_FLOAT;
+        depthDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        depthDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        depthDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(static_cast<ID3D12Resource*>(inputs.color), nullptr,
+                                         next());
+        device->CreateShaderResourceView(static_cast<ID3D12Resource*>(inputs.depth), &depthDesc,
+                                         next());
+        device->CreateShaderResourceView(
+            static_cast<ID3D12Resource*>(inputs.motionVectors), nullptr, next());
+        device->CreateShaderResourceView(lastHistory, nullptr, next());
+        device->CreateUnorderedAccessView(output, nullptr, nullptr, next());
+        device->CreateUnorderedAccessView(nextHistory, nullptr, nullptr, next());
+
+        // The inputs and the last history promote from COMMON and decay back after; textures
+        // don't promote to UNORDERED_ACCESS, so the outputs go there and back explicitly
+        D3D12_RESOURCE_BARRIER toWrite[2] = {
+            Transition(
+                output, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+            Transition(
+                nextHistory, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS),
+        };
+        list->ResourceBarrier(2, toWrite);
+
+        UpscaleConstants constants = {};
+        constants.renderWidth = upscaler->renderWidth;
+        constants.renderHeight = upscaler->renderHeight;
+        constants.outputWidth = upscaler->outputWidth;
+        constants.outputHeight = upscaler->outputHeight;
+        memcpy(constants.jitter, inputs.jitter, sizeof(constants.jitter));
+        memcpy(constants.motionVectorScale, inputs.motionVectorScale,
+               sizeof(constants.motionVectorScale));
+        constants.reset = inputs.reset || !upscaler->historyValid ? 1 : 0;
+        constants.depthReversed = upscaler->depthReversed ? 1 : 0;
+
+        D3D12_GPU_DESCRIPTOR_HANDLE table =
+            upscaler->descriptorHeap->GetGPUDescriptorHandleForHeapStart();
+        table.ptr += uint64(firstDescriptor) * upscaler->descriptorSize;
+        ID3D12DescriptorHeap* heaps[] = {upscaler->descriptorHeap.Get()};
+        list->SetDescriptorHeaps(1, heaps);
+        list->SetComputeRootSignature(upscaler->rootSignature.Get());
+        list->SetComputeRoot32BitConstants(
+            0, sizeof(UpscaleConstants) / sizeof(uint32), &constants, 0);
+        list->SetComputeRootDescriptorTable(1, table);
+        list->Dispatch((upscaler->outputWidth + 7) / 8, (upscaler->outputHeight + 7) / 8, 1);
+
+        D3D12_RESOURCE_BARRIER toCommon[2] = {
+            Transition(
+                output, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON),
+            Transition(
+                nextHistory, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON),
+        };
+        list->ResourceBarrier(2, toCommon);
+
+        if (!upscaler->Submit(frame))
+        {
+            return "Failed to submit the upscale dispatch";
+        }
+        upscaler->historyIndex ^= 1;
+        upscaler->historyValid = true;
+        return ResultCode::Success;
+    }
+
+    struct DX12UploadBuffer : public UploadBuffer
+    {
+        RefPtr<ID3D12Resource> resource;
+    };
+
+    Result<UploadBuffer*> CreateDX12UploadBuffer(gaDevice* baseDevice, uint64 size)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        auto buffer = rsbl::UniquePtr(new DX12UploadBuffer());
+        if (FAILED(CreateBuffer(device->d3d12Device.Get(), size, D3D12_HEAP_TYPE_UPLOAD,
+                                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ,
+                                buffer->resource)))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create the upload ring buffer"};
+        }
+
+        // Upload heaps can stay mapped while the GPU reads them. Nothing is read on the CPU.
+        const D3D12_RANGE noReads = {0, 0};
+        void* data = nullptr;
+        if (FAILED(buffer->resource->Map(0, &noReads, &data)))
+        {
+            return "Failed to map the upload ring buffer";
+        }
+        buffer->handle = buffer->resource.Get();
+        buffer->data = static_cast<uint8*>(data);
+        return buffer.Release();
+    }
+
+    void RecordDX12BufferCopies(gaCommandList* list,
+                                UploadBuffer* source,
+                                ArrayView<const BufferCopy> copies)
+    {
+        // Buffers are promoted from COMMON to COPY_DEST on their own, and decay back once the
+        // list is done, so copies need no barriers
+        ID3D12GraphicsCommandList* commandList =
+            static_cast<DX12CommandList*>(list)->commandList.Get();
+        ID3D12Resource* sourceResource = static_cast<DX12UploadBuffer*>(source)->resource.Get();
+        for (const BufferCopy& copy : copies)
+        {
+            commandList->CopyBufferRegion(static_cast<ID3D12Resource*>(copy.destination),
+                                          copy.destinationOffset,
+                                          sourceResource,
+                                          copy.sourceOffset,
+                                          copy.size);
+        }
+    }
+
+    void RecordDX12BufferCopy(gaCommandList* list,
+                              void* destination,
+                              uint64 destinationOffset,
+                              void* source,
+                              uint64 sourceOffset,
+                              uint64 size)
+    {
+        static_cast<DX12CommandList*>(list)->commandList->CopyBufferRegion(
+            static_cast<ID3D12Resource*>(destination),
+            destinationOffset,
+            static_cast<ID3D12Resource*>(source),
+            sourceOffset,
+            size);
+    }
+
+    static_assert(sizeof(gaDrawIndexedArguments) == sizeof(D3D12_DRAW_INDEXED_ARGUMENTS));
+
+    void RecordDX12IndirectDraws(gaCommandList* list,
+                                 void* arguments,
+                                 uint64 argumentOffset,
+                                 uint32 maxDraws,
+                                 void* count,
+                                 uint64 countOffset)
+    {
+        static_cast<DX12CommandList*>(list)->commandList->ExecuteIndirect(
+            static_cast<DX12Device*>(list->device)->drawIndexedSignature.Get(),
+            maxDraws,
+            static_cast<ID3D12Resource*>(arguments),
+            argumentOffset,
+            static_cast<ID3D12Resource*>(count),
+            countOffset);
+    }
+
+    void RecordDX12MeshDispatch(gaCommandList* list,
+                                uint32 groupsX,
+                                uint32 groupsY,
+                                uint32 groupsZ)
+    {
+        static_cast<DX12CommandList*>(list)->meshCommandList->DispatchMesh(
+            groupsX, groupsY, groupsZ);
+    }
+
+    // The layout's push constants are root parameter 0
+    void RecordDX12PushConstants(gaCommandList* list,
+                                 const gaPipeline* pipeline,
+                                 uint32 offset,
+                                 uint32 size,
+                                 const void* data)
+    {
+        auto commandList = static_cast<DX12CommandList*>(list)->commandList.Get();
+        if (pipeline->compute)
+        {
+            commandList->SetComputeRoot32BitConstants(0, size / 4, data, offset / 4);
+        }
+        else
+        {
+            commandList->SetGraphicsRoot32BitConstants(0, size / 4, data, offset / 4);
+        }
+    }
+
+    static_assert(static_cast<uint32>(gaShadingRate::Rate2x4) == D3D12_SHADING_RATE_2X4 &&
+                      static_cast<uint32>(gaShadingRate::Rate4x4) == D3D12_SHADING_RATE_4X4,
+                  "gaShadingRate is D3D12_SHADING_RATE");
+
+    // The image's rate wins where it's coarser. Per-primitive rates aren't used, so pass through.
+    void RecordDX12ShadingRate(gaCommandList* list, gaShadingRate rate, void* rateImage)
+    {
+        const D3D12_SHADING_RATE_COMBINER combiners[D3D12_RS_SET_SHADING_RATE_COMBINER_COUNT] = {
+            D3D12_SHADING_RATE_COMBINER_PASSTHROUGH,
+            rateImage != nullptr ? D3D12_SHADING_RATE_COMBINER_MAX
+                                 : D3D12_SHADING_RATE_COMBINER_PASSTHROUGH,
+        };
+        auto commandList = static_cast<DX12CommandList*>(list)->shadingRateCommandList.Get();
+        commandList->RSSetShadingRate(static_cast<D3D12_SHADING_RATE>(rate), combiners);
+        commandList->RSSetShadingRateImage(static_cast<ID3D12Resource*>(rateImage));
+    }
+
+    // The heap and fence are made on the device and opened on the peer through shared handles.
+    // Each has a placed buffer of its own over the whole heap.
+    struct DX12SharedBuffer : public gaSharedBuffer
+    {
+        RefPtr<ID3D12Heap> heap;
+        RefPtr<ID3D12Heap> peerHeap;
+        RefPtr<ID3D12Resource> buffer;
+        RefPtr<ID3D12Resource> peerBuffer;
+        DX12Fence sharedFence;
+        DX12Fence peerSharedFence;
+
+        DX12SharedBuffer()
+        {
+            backend = gaBackend::DX12;
+            resource = nullptr;
+            peerResource = nullptr;
+            fence = &sharedFence;
+            peerFence = &peerSharedFence;
+        }
+    };
+
+    // Opens what the device made on the peer. The handle is only needed until it's opened.
+    static Result<> OpenShared(ID3D12Device* device,
+                               ID3D12DeviceChild* object,
+                               ID3D12Device* peer,
+                               REFIID riid,
+                               void** opened)
+    {
+        HANDLE handle = nullptr;
+        if (FAILED(device->CreateSharedHandle(object, nullptr, GENERIC_ALL, nullptr, &handle)))
+        {
+            return {ErrorCategory::Graphics, "Failed to share across adapters"};
+        }
+        const HRESULT hr = peer->OpenSharedHandle(handle, riid, opened);
+        CloseHandle(handle);
+        if (FAILED(hr))
+        {
+            return {ErrorCategory::Graphics, "The peer failed to open what was shared"};
+        }
+        return ResultCode::Success;
+    }
+
+    static Result<> CreateSharedPlacedBuffer(ID3D12Device* device,
+                                             ID3D12Heap* heap,
+                                             uint64 size,
+                                             RefPtr<ID3D12Resource>& buffer)
+    {
+        D3D12_RESOURCE_DESC desc = {};
+        desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        desc.Width = size;
+        desc.Height = 1;
+        desc.DepthOrArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = DXGI_FORMAT_UNKNOWN;
+        desc.SampleDesc.Count = 1;
+        desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_CROSS_ADAPTER;
+        if (FAILED(device->CreatePlacedResource(heap,
+                                                0,
+                                                &desc,
+                                                D3D12_RESOURCE_STATE_COMMON,
+                                                nullptr,
+                                                IID_PPV_ARGS(buffer.ReleaseAndGetAddressOf()))))
+        {
+            return {ErrorCategory::Graphics, "Failed to create a cross-adapter buffer"};
+        }
+        return ResultCode::Success;
+    }
+
+    Result<gaSharedBuffer*> CreateDX12SharedBuffer(const gaSharedBufferCreateInfo& createInfo)
+    {
+        ID3D12Device* device = static_cast<DX12Device*>(createInfo.device)->d3d12Device.Get();
+        ID3D12Device* peer = static_cast<DX12Device*>(createInfo.peer)->d3d12Device.Get();
+
+        auto shared = rsbl::UniquePtr(new DX12SharedBuffer());
+        shared->device = createInfo.device;
+        shared->peer = createInfo.peer;
+        shared->size = createInfo.size;
+
+        D3D12_HEAP_DESC heapDesc = {};
+        heapDesc.SizeInBytes =
+            AlignUp(createInfo.size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+        heapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+        heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        heapDesc.Flags = D3D12_HEAP_FLAG_SHARED | D3D12_HEAP_FLAG_SHARED_CROSS_ADAPTER;
+        if (FAILED(device->CreateHeap(
+                &heapDesc, IID_PPV_ARGS(shared->heap.ReleaseAndGetAddressOf()))))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create a cross-adapter heap"};
+        }
+        if (auto opened = OpenShared(device,
+                                     shared->heap.Get(),
+                                     peer,
+                                     IID_PPV_ARGS(shared->peerHeap.ReleaseAndGetAddressOf()));
+            !opened)
+        {
+            return PendingFailure{opened.Category()};
+        }
+
+        if (auto created = CreateSharedPlacedBuffer(
+                device, shared->heap.Get(), createInfo.size, shared->buffer);
+            !created)
+        {
+            return PendingFailure{created.Category()};
+        }
+        if (auto created = CreateSharedPlacedBuffer(
+                peer, shared->peerHeap.Get(), createInfo.size, shared->peerBuffer);
+            !created)
+        {
+            return PendingFailure{created.Category()};
+        }
+        shared->resource = shared->buffer.Get();
+        shared->peerResource = shared->peerBuffer.Get();
+
+        // The peer's fence is the same one, opened
+        if (auto fence = InitFence(device,
+                                   0,
+                                   shared->sharedFence,
+                                   D3D12_FENCE_FLAG_SHARED | D3D12_FENCE_FLAG_SHARED_CROSS_ADAPTER);
+            !fence)
+        {
+            return PendingFailure{fence.Category()};
+        }
+        DX12Fence& peerFence = shared->peerSharedFence;
+        if (auto opened = OpenShared(device,
+                                     shared->sharedFence.d3d12Fence.Get(),
+                                     peer,
+                                     IID_PPV_ARGS(peerFence.d3d12Fence.ReleaseAndGetAddressOf()));
+            !opened)
+        {
+            return PendingFailure{opened.Category()};
+        }
+        peerFence.event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (peerFence.event == nullptr)
+        {
+            return "Failed to create a fence event";
+        }
+        peerFence.internalHandle = peerFence.d3d12Fence.Get();
+        return shared.Release();
+    }
+
+    // Indexed by gaResourceState. Reads are combined where a pass commonly does both, so the
+    // resource doesn't go back and forth between them.
+    constexpr D3D12_RESOURCE_STATES kResourceStates[] = {
+        D3D12_RESOURCE_STATE_COMMON,
+        D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,
+        D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+        D3D12_RESOURCE_STATE_RENDER_TARGET,
+        D3D12_RESOURCE_STATE_DEPTH_WRITE,
+        D3D12_RESOURCE_STATE_DEPTH_READ | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE |
+            D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,
+        D3D12_RESOURCE_STATE_COPY_SOURCE,
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT,
+        D3D12_RESOURCE_STATE_PRESENT,
+        D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE,
+    };
+    static_assert(sizeof(kResourceStates) / sizeof(kResourceStates[0]) ==
+                  static_cast<uint32>(gaResourceState::Count));
+
+    void RecordDX12Barriers(gaCommandList* list, ArrayView<const gaBarrier> barriers)
+    {
+        ID3D12GraphicsCommandList* commandList =
+            static_cast<DX12CommandList*>(list)->commandList.Get();
+
+        SmallArray<D3D12_RESOURCE_BARRIER, 64> dx12Barriers;
+        for (const gaBarrier& barrier : barriers)
+        {
+            auto resource = static_cast<ID3D12Resource*>(barrier.resource);
+
+            // Any resource in the same memory before, so no need to know which
+            if (barrier.discard)
+            {
+                D3D12_RESOURCE_BARRIER aliasing = {};
+                aliasing.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+                aliasing.Aliasing.pResourceBefore = nullptr;
+                aliasing.Aliasing.pResourceAfter = resource;
+                dx12Barriers.PushBack(aliasing);
+            }
+
+            D3D12_RESOURCE_BARRIER out = {};
+            if (barrier.before == barrier.after)
+            {
+                if (barrier.after != gaResourceState::UnorderedAccess)
+                {
+                    continue;
+                }
+                out.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+                out.UAV.pResource = resource;
+            }
+            else
+            {
+                out.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+                out.Transition.pResource = resource;
+                out.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+                out.Transition.StateBefore = kResourceStates[static_cast<uint32>(barrier.before)];
+                out.Transition.StateAfter = kResourceStates[static_cast<uint32>(barrier.after)];
+                if (barrier.split == gaBarrierSplit::Begin)
+                {
+                    out.Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+                }
+                else if (barrier.split == gaBarrierSplit::End)
+                {
+                    out.Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+                }
+            }
+            dx12Barriers.PushBack(out);
+        }
+
+        if (!dx12Barriers.IsEmpty())
+        {
+            commandList->ResourceBarrier(static_cast<UINT>(dx12Barriers.Size()),
+                                         dx12Barriers.Data());
+        }
+    }
+
+    struct DX12TimestampHeap : public TimestampHeap
+    {
+        RefPtr<ID3D12QueryHeap> queryHeap;
+        // A timestamp's 8 bytes resolve to its index in the heap, times 8
+        RefPtr<ID3D12Resource> readback;
+    };
+
+    Result<TimestampHeap*> CreateDX12TimestampHeap(gaDevice* baseDevice,
+                                                   gaQueueType queue,
+                                                   uint32 count)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        ID3D12CommandQueue* commandQueue =
+            device->commandQueues[static_cast<uint32>(queue)].Get();
+
+        auto heap = rsbl::UniquePtr(new DX12TimestampHeap());
+        UINT64 frequency = 0;
+        if (FAILED(commandQueue->GetTimestampFrequency(&frequency)))
+        {
+            return {ErrorCategory::Graphics, "The queue has no timestamp frequency"};
+        }
+        heap->frequency = frequency;
+
+        D3D12_QUERY_HEAP_DESC desc = {};
+        desc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+        desc.Count = count;
+        if (FAILED(device->d3d12Device->CreateQueryHeap(
+                &desc, IID_PPV_ARGS(heap->queryHeap.ReleaseAndGetAddressOf()))))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create a timestamp query heap"};
+        }
+
+        if (FAILED(CreateBuffer(device->d3d12Device.Get(), uint64(count) * sizeof(uint64),
+                                D3D12_HEAP_TYPE_READBACK, D3D12_RESOURCE_FLAG_NONE,
+                                D3D12_RESOURCE_STATE_COPY_DEST, heap->readback)))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create the timestamp readback buffer"};
+        }
+        heap->handle = heap->queryHeap.Get();
+        return heap.Release();
+    }
+
+    void WriteDX12Timestamp(gaCommandList* list, TimestampHeap* heap, uint32 index)
+    {
+        // A timestamp query has no begin, ending it writes the time
+        static_cast<DX12CommandList*>(list)->commandList->EndQuery(
+            static_cast<DX12TimestampHeap*>(heap)->queryHeap.Get(),
+            D3D12_QUERY_TYPE_TIMESTAMP,
+            index);
+    }
+
+    struct DX12Breadcrumbs : public Breadcrumbs
+    {
+        RefPtr<ID3D12Resource> buffer;
+    };
+
+    // A readback buffer: always in COPY_DEST, which WriteBufferImmediate writes in, and in
+    // memory the CPU keeps once the device is gone
+    Result<Breadcrumbs*> CreateDX12Breadcrumbs(gaDevice* baseDevice, uint32 slots)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        auto breadcrumbs = rsbl::UniquePtr(new DX12Breadcrumbs());
+        if (FAILED(CreateBuffer(device->d3d12Device.Get(), uint64(slots) * sizeof(uint32),
+                                D3D12_HEAP_TYPE_READBACK, D3D12_RESOURCE_FLAG_NONE,
+                                D3D12_RESOURCE_STATE_COPY_DEST, breadcrumbs->buffer)))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create the breadcrumb buffer"};
+        }
+
+        void* data = nullptr;
+        if (FAILED(breadcrumbs->buffer->Map(0, nullptr, &data)))
+        {
+            return "Failed to map the breadcrumb buffer";
+        }
+        memset(data, 0, uint64(slots) * sizeof(uint32));
+        breadcrumbs->markers = static_cast<uint32*>(data);
+        breadcrumbs->internalHandle = breadcrumbs->buffer.Get();
+        return breadcrumbs.Release();
+    }
+
+    void WriteDX12Breadcrumb(gaCommandList* list,
+                             Breadcrumbs* breadcrumbs,
+                             uint32 slot,
+                             uint32 marker)
+    {
+        const D3D12_WRITEBUFFERIMMEDIATE_PARAMETER parameter = {
+            static_cast<DX12Breadcrumbs*>(breadcrumbs)->buffer->GetGPUVirtualAddress() +
+                uint64(slot) * sizeof(uint32),
+            marker};
+        const D3D12_WRITEBUFFERIMMEDIATE_MODE mode = D3D12_WRITEBUFFERIMMEDIATE_MODE_MARKER_OUT;
+        static_cast<DX12CommandList*>(list)->markerCommandList->WriteBufferImmediate(
+            1, &parameter, &mode);
+    }
+
+    // DRED's breadcrumbs count the operations of each list the GPU has finished, so a list with
+    // fewer than it has is one the GPU stopped in
+    Result<> ReportDX12DeviceLost(gaDevice* baseDevice)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        const HRESULT reason = device->d3d12Device->GetDeviceRemovedReason();
+        if (reason == S_OK)
+        {
+            return {ErrorCategory::NotFound, "The device hasn't been lost"};
+        }
+        RSBL_LOG_ERROR("DX12 device lost, reason 0x{:08x}", static_cast<uint32>(reason));
+
+        RefPtr<ID3D12DeviceRemovedExtendedData> dred;
+        if (FAILED(device->d3d12Device->QueryInterface(
+                IID_PPV_ARGS(dred.ReleaseAndGetAddressOf()))))
+        {
+            return {ErrorCategory::NotFound, "DRED is off, see enableDeviceLostReports"};
+        }
+
+        D3D12_DRED_AUTO_BREADCRUMBS_OUTPUT breadcrumbs = {};
+        if (SUCCEEDED(dred->GetAutoBreadcrumbsOutput(&breadcrumbs)))
+        {
+            for (const D3D12_AUTO_BREADCRUMB_NODE* node = breadcrumbs.pHeadAutoBreadcrumbNode;
+                 node != nullptr;
+                 node = node->pNext)
+            {
+                const uint32 finished =
+                    node->pLastBreadcrumbValue != nullptr ? *node->pLastBreadcrumbValue : 0;
+                if (finished >= node->BreadcrumbCount)
+                {
+                    continue;
+                }
+                RSBL_LOG_ERROR("List {} on queue {} stopped at operation {} of {}, "
+                               "D3D12_AUTO_BREADCRUMB_OP {}",
+                               node->pCommandListDebugNameA != nullptr
+                                   ? node->pCommandListDebugNameA
+                                   : "(unnamed)",
+                               node->pCommandQueueDebugNameA != nullptr
+                                   ? node->pCommandQueueDebugNameA
+                                   : "(unnamed)",
+                               finished,
+                               node->BreadcrumbCount,
+                               static_cast<uint32>(node->pCommandHistory[finished]));
+            }
+        }
+
+        D3D12_DRED_PAGE_FAULT_OUTPUT pageFault = {};
+        if (SUCCEEDED(dred->GetPageFaultAllocationOutput(&pageFault)) &&
+            pageFault.PageFaultVA != 0)
+        {
+            RSBL_LOG_ERROR("Page fault at GPU address 0x{:x}", pageFault.PageFaultVA);
+            for (const D3D12_DRED_ALLOCATION_NODE* node = pageFault.pHeadExistingAllocationNode;
+                 node != nullptr;
+                 node = node->pNext)
+            {
+                RSBL_LOG_ERROR("  in allocation {}",
+                               node->ObjectNameA != nullptr ? node->ObjectNameA : "(unnamed)");
+            }
+            for (const D3D12_DRED_ALLOCATION_NODE* node = pageFault.pHeadRecentFreedAllocationNode;
+                 node != nullptr;
+                 node = node->pNext)
+            {
+                RSBL_LOG_ERROR("  in recently freed allocation {}",
+                               node->ObjectNameA != nullptr ? node->ObjectNameA : "(unnamed)");
+            }
+        }
+        return ResultCode::Success;
+    }
+
+    void ResolveDX12Timestamps(gaCommandList* list,
+                               TimestampHeap* heap,
+                               uint32 first,
+                               uint32 count)
+    {
+        auto timestamps = static_cast<DX12TimestampHeap*>(heap);
+        static_cast<DX12CommandList*>(list)->commandList->ResolveQueryData(
+            timestamps->queryHeap.Get(),
+            D3D12_QUERY_TYPE_TIMESTAMP,
+            first,
+            count,
+            timestamps->readback.Get(),
+            uint64(first) * sizeof(uint64));
+    }
+
+    Result<> ReadDX12Timestamps(TimestampHeap* heap, uint32 first, uint32 count, uint64* out)
+    {
+        // Mapped only to read, readback heaps are cached on the CPU so that's a copy from memory
+        ID3D12Resource* readback = static_cast<DX12TimestampHeap*>(heap)->readback.Get();
+        const D3D12_RANGE readRange = {uint64(first) * sizeof(uint64),
+                                       uint64(first + count) * sizeof(uint64)};
+        void* data = nullptr;
+        if (FAILED(readback->Map(0, &readRange, &data)))
+        {
+            return "Failed to map the timestamp readback buffer";
+        }
+        memcpy(out,
+               static_cast<const uint8*>(data) + readRange.Begin,
+               readRange.End - readRange.Begin);
+        const D3D12_RANGE noWrites = {0, 0};
+        readback->Unmap(0, &noWrites);
+        return ResultCode::Success;
+    }
+
+    Result<gaClockCalibration> GetDX12ClockCalibration(gaDevice* baseDevice, gaQueueType queue)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        ID3D12CommandQueue* commandQueue =
+            device->commandQueues[static_cast<uint32>(queue)].Get();
+
+        // The CPU side is QueryPerformanceCounter, Clock's ticks on Windows
+        UINT64 gpuTimestamp = 0;
+        UINT64 cpuTicks = 0;
+        UINT64 gpuFrequency = 0;
+        LARGE_INTEGER cpuFrequency = {};
+        if (FAILED(commandQueue->GetClockCalibration(&gpuTimestamp, &cpuTicks)) ||
+            FAILED(commandQueue->GetTimestampFrequency(&gpuFrequency)))
+        {
+            return {ErrorCategory::Graphics, "Failed to calibrate the queue's clock"};
+        }
+        QueryPerformanceFrequency(&cpuFrequency);
+        return gaClockCalibration{
+            gpuTimestamp, gpuFrequency, cpuTicks, static_cast<uint64>(cpuFrequency.QuadPart)};
+    }
+
+    constexpr D3D12_DESCRIPTOR_HEAP_TYPE kDescriptorHeapTypes[] = {
+        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+        D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER,
+        D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
+        D3D12_DESCRIPTOR_HEAP_TYPE_DSV,
+    };
+
+    struct DX12DescriptorPage : public DescriptorPage
+    {
+        RefPtr<ID3D12DescriptorHeap> heap;
+    };
+
+    Result<DescriptorPage*> CreateDX12DescriptorPage(gaDevice* baseDevice,
+                                                     gaDescriptorType type,
+                                                     uint32 count)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        const D3D12_DESCRIPTOR_HEAP_TYPE heapType = kDescriptorHeapTypes[static_cast<uint32>(type)];
+
+        // Not shader visible: CPU descriptors are cheap to write and copy from, and don't use
+        // up the one shader-visible heap's space
+        D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+        desc.Type = heapType;
+        desc.NumDescriptors = count;
+        desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+
+        auto page = rsbl::UniquePtr(new DX12DescriptorPage());
+        if (FAILED(device->d3d12Device->CreateDescriptorHeap(
+                &desc, IID_PPV_ARGS(page->heap.ReleaseAndGetAddressOf()))))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create a descriptor heap"};
+        }
+        page->handle = page->heap.Get();
+        page->start = page->heap->GetCPUDescriptorHandleForHeapStart().ptr;
+        page->increment = device->d3d12Device->GetDescriptorHandleIncrementSize(heapType);
+        return page.Release();
+    }
+
+    struct DX12BindlessTable : public BindlessTable
+    {
+        RefPtr<ID3D12DescriptorHeap> heap;
+        D3D12_CPU_DESCRIPTOR_HANDLE start = {};
+        uint32 descriptorSize = 0;
+    };
+
+    // The samplers go in the root signatures instead, see CreateDX12PipelineLayout
+    Result<BindlessTable*> CreateDX12BindlessTable(gaDevice* baseDevice,
+                                                   uint32 capacity,
+                                                   ArrayView<const gaSamplerDesc> samplers)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+        desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        desc.NumDescriptors = capacity;
+        desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+
+        auto table = rsbl::UniquePtr(new DX12BindlessTable());
+        if (FAILED(device->d3d12Device->CreateDescriptorHeap(
+                &desc, IID_PPV_ARGS(table->heap.ReleaseAndGetAddressOf()))))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create the bindless descriptor heap"};
+        }
+        table->start = table->heap->GetCPUDescriptorHandleForHeapStart();
+        table->descriptorSize = device->d3d12Device->GetDescriptorHandleIncrementSize(
+            D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        table->handle = table->heap.Get();
+        return table.Release();
+    }
+
+    void WriteDX12BindlessDescriptor(gaDevice* baseDevice,
+                                     BindlessTable* baseTable,
+                                     uint32 index,
+                                     const gaBindlessView& view)
+    {
+        ID3D12Device* device = static_cast<DX12Device*>(baseDevice)->d3d12Device.Get();
+        auto table = static_cast<DX12BindlessTable*>(baseTable);
+        auto resource = static_cast<ID3D12Resource*>(view.resource);
+        D3D12_CPU_DESCRIPTOR_HANDLE descriptor = table->start;
+        descriptor.ptr += static_cast<SIZE_T>(index) * table->descriptorSize;
+
+        // Raw views count 4 byte words, structured views count structures
+        const bool raw = view.stride == 0;
+        const uint64 elementSize = raw ? 4 : view.stride;
+        switch (view.type)
+        {
+        case gaBindlessViewType::BufferSrv:
+        {
+            D3D12_SHADER_RESOURCE_VIEW_DESC desc = {};
+            desc.Format = raw ? DXGI_FORMAT_R32_TYPELESS : DXGI_FORMAT_UNKNOWN;
+            desc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+            desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            desc.Buffer.FirstElement = view.offset / elementSize;
+            desc.Buffer.NumElements = static_cast<UINT>(view.size / elementSize);
+            desc.Buffer.StructureByteStride = view.stride;
+            desc.Buffer.Flags = raw ? D3D12_BUFFER_SRV_FLAG_RAW : D3D12_BUFFER_SRV_FLAG_NONE;
+            device->CreateShaderResourceView(resource, &desc, descriptor);
+            break;
+        }
+
+        case gaBindlessViewType::BufferUav:
+        {
+            D3D12_UNORDERED_ACCESS_VIEW_DESC desc = {};
+            desc.Format = raw ? DXGI_FORMAT_R32_TYPELESS : DXGI_FORMAT_UNKNOWN;
+            desc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+            desc.Buffer.FirstElement = view.offset / elementSize;
+            desc.Buffer.NumElements = static_cast<UINT>(view.size / elementSize);
+            desc.Buffer.StructureByteStride = view.stride;
+            desc.Buffer.Flags = raw ? D3D12_BUFFER_UAV_FLAG_RAW : D3D12_BUFFER_UAV_FLAG_NONE;
+            device->CreateUnorderedAccessView(resource, nullptr, &desc, descriptor);
+            break;
+        }
+
+        // The default views: the whole texture, and mip 0
+        case gaBindlessViewType::TextureSrv:
+            device->CreateShaderResourceView(resource, nullptr, descriptor);
+            break;
+
+        case gaBindlessViewType::TextureUav:
+            device->CreateUnorderedAccessView(resource, nullptr, nullptr, descriptor);
+            break;
+        }
+    }
+
+    void BindDX12BindlessTable(gaCommandList* list, BindlessTable* table)
+    {
+        ID3D12DescriptorHeap* heaps[] = {static_cast<DX12BindlessTable*>(table)->heap.Get()};
+        static_cast<DX12CommandList*>(list)->commandList->SetDescriptorHeaps(1, heaps);
+    }
+
+    constexpr DXGI_FORMAT kDxgiFormats[] = {
+        DXGI_FORMAT_UNKNOWN,
+        DXGI_FORMAT_R8G8B8A8_UNORM,
+        DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+        DXGI_FORMAT_B8G8R8A8_UNORM,
+        DXGI_FORMAT_B8G8R8A8_UNORM_SRGB,
+        DXGI_FORMAT_R8G8B8A8_UINT,
+        DXGI_FORMAT_R10G10B10A2_UNORM,
+        DXGI_FORMAT_R11G11B10_FLOAT,
+        DXGI_FORMAT_R16G16_FLOAT,
+        DXGI_FORMAT_R16G16B16A16_FLOAT,
+        DXGI_FORMAT_R16G16B16A16_UNORM,
+        DXGI_FORMAT_R32_FLOAT,
+        DXGI_FORMAT_R32_UINT,
+        DXGI_FORMAT_R32G32_FLOAT,
+        DXGI_FORMAT_R32G32B32_FLOAT,
+        DXGI_FORMAT_R32G32B32A32_FLOAT,
+        DXGI_FORMAT_D16_UNORM,
+        DXGI_FORMAT_D24_UNORM_S8_UINT,
+        DXGI_FORMAT_D32_FLOAT,
+    };
+    static_assert(sizeof(kDxgiFormats) / sizeof(kDxgiFormats[0]) ==
+                  static_cast<uint32>(gaFormat::Count));
+
+    struct DX12ReadbackBuffer : public ReadbackBuffer
+    {
+        RefPtr<ID3D12Resource> resource;
+    };
+
+    Result<ReadbackBuffer*> CreateDX12ReadbackBuffer(gaDevice* baseDevice, uint64 size)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        auto buffer = rsbl::UniquePtr(new DX12ReadbackBuffer());
+        if (FAILED(CreateBuffer(device->d3d12Device.Get(), size, D3D12_HEAP_TYPE_READBACK,
+                                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST,
+                                buffer->resource)))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create the readback ring buffer"};
+        }
+
+        // Readback heaps can stay mapped while the GPU writes them, and are cached on the CPU, so
+        // reading them is as fast as any memory once the fence says the copies are done
+        void* data = nullptr;
+        if (FAILED(buffer->resource->Map(0, nullptr, &data)))
+        {
+            return "Failed to map the readback ring buffer";
+        }
+        buffer->handle = buffer->resource.Get();
+        buffer->data = static_cast<const uint8*>(data);
+        return buffer.Release();
+    }
+
+    void RecordDX12ReadbackCopies(gaCommandList* list,
+                                  ReadbackBuffer* destination,
+                                  ArrayView<const ReadbackCopy> copies)
+    {
+        // Source buffers are promoted from COMMON to COPY_SOURCE on their own, textures were put
+        // there by the ring
+        ID3D12GraphicsCommandList* commandList =
+            static_cast<DX12CommandList*>(list)->commandList.Get();
+        ID3D12Resource* destinationResource =
+            static_cast<DX12ReadbackBuffer*>(destination)->resource.Get();
+        for (const ReadbackCopy& copy : copies)
+        {
+            auto source = static_cast<ID3D12Resource*>(copy.source);
+            if (copy.width == 0)
+            {
+                commandList->CopyBufferRegion(destinationResource,
+                                              copy.destinationOffset,
+                                              source,
+                                              copy.sourceOffset,
+                                              copy.size);
+                continue;
+            }
+
+            D3D12_TEXTURE_COPY_LOCATION to = {};
+            to.pResource = destinationResource;
+            to.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            to.PlacedFootprint.Offset = copy.destinationOffset;
+            to.PlacedFootprint.Footprint.Format = kDxgiFormats[static_cast<uint32>(copy.format)];
+            to.PlacedFootprint.Footprint.Width = copy.width;
+            to.PlacedFootprint.Footprint.Height = copy.height;
+            to.PlacedFootprint.Footprint.Depth = 1;
+            to.PlacedFootprint.Footprint.RowPitch = copy.rowPitch;
+
+            D3D12_TEXTURE_COPY_LOCATION from = {};
+            from.pResource = source;
+            from.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            from.SubresourceIndex = 0;
+            commandList->CopyTextureRegion(&to, 0, 0, 0, &from, nullptr);
+        }
+    }
+
+    constexpr D3D12_COMPARISON_FUNC kComparisonFuncs[] = {
+        D3D12_COMPARISON_FUNC_NEVER,
+        D3D12_COMPARISON_FUNC_LESS,
+        D3D12_COMPARISON_FUNC_EQUAL,
+        D3D12_COMPARISON_FUNC_LESS_EQUAL,
+        D3D12_COMPARISON_FUNC_GREATER,
+        D3D12_COMPARISON_FUNC_NOT_EQUAL,
+        D3D12_COMPARISON_FUNC_GREATER_EQUAL,
+        D3D12_COMPARISON_FUNC_ALWAYS,
+    };
+
+    constexpr D3D12_CULL_MODE kCullModes[] = {
+        D3D12_CULL_MODE_NONE,
+        D3D12_CULL_MODE_FRONT,
+        D3D12_CULL_MODE_BACK,
+    };
+
+    constexpr D3D12_PRIMITIVE_TOPOLOGY_TYPE kTopologyTypes[] = {
+        D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+        D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+        D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE,
+        D3D12_PRIMITIVE_TOPOLOGY_TYPE_POINT,
+    };
+
+    struct DX12ReservedResource : public gaReservedResource
+    {
+        RefPtr<ID3D12Resource> resource;
+
+        DX12ReservedResource()
+        {
+            backend = gaBackend::DX12;
+            internalHandle = nullptr;
+        }
+    };
+
+    Result<gaReservedResource*> CreateDX12ReservedResource(
+        const gaReservedResourceCreateInfo& createInfo)
+    {
+        auto device = static_cast<DX12Device*>(createInfo.device);
+
+        D3D12_RESOURCE_DESC desc = {};
+        desc.DepthOrArraySize = 1;
+        desc.SampleDesc.Count = 1;
+        if (createInfo.size != 0)
+        {
+            desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            desc.Width = (createInfo.size + kGaTileSize - 1) / kGaTileSize * kGaTileSize;
+            desc.Height = 1;
+            desc.MipLevels = 1;
+            desc.Format = DXGI_FORMAT_UNKNOWN;
+            desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        }
+        else
+        {
+            desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+            desc.Width = createInfo.width;
+            desc.Height = createInfo.height;
+            desc.MipLevels = static_cast<UINT16>(createInfo.mips);
+            desc.Format = kDxgiFormats[static_cast<uint32>(createInfo.format)];
+            desc.Layout = D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE;
+        }
+
+        auto resource = rsbl::UniquePtr(new DX12ReservedResource());
+        if (FAILED(device->d3d12Device->CreateReservedResource(
+                &desc,
+                D3D12_RESOURCE_STATE_COMMON,
+                nullptr,
+                IID_PPV_ARGS(resource->resource.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create a D3D12 reserved resource";
+        }
+        resource->internalHandle = resource->resource.Get();
+
+        UINT tileCount = 0;
+        D3D12_PACKED_MIP_INFO packedMips = {};
+        D3D12_TILE_SHAPE tileShape = {};
+        device->d3d12Device->GetResourceTiling(
+            resource->resource.Get(), &tileCount, &packedMips, &tileShape, nullptr, 0, nullptr);
+        resource->tileWidth = tileShape.WidthInTexels;
+        resource->tileHeight = tileShape.HeightInTexels;
+        resource->standardMips = packedMips.NumStandardMips;
+        resource->mipTailTiles = packedMips.NumTilesForPackedMips;
+        resource->tileCount = tileCount;
+        return resource.Release();
+    }
+
+    // A tile of the mip tail is its first mip's subresource and the tile's index in the tail,
+    // which is how the coordinates already have it
+    Result<> UpdateDX12TileMappings(gaDevice* baseDevice, ArrayView<const gaTileMapping> mappings)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        ID3D12CommandQueue* queue =
+            device->commandQueues[static_cast<uint32>(gaQueueType::Graphics)].Get();
+
+        DynamicArray<D3D12_TILED_RESOURCE_COORDINATE> coordinates;
+        DynamicArray<D3D12_TILE_REGION_SIZE> regionSizes;
+        DynamicArray<D3D12_TILE_RANGE_FLAGS> rangeFlags;
+        DynamicArray<UINT> heapOffsets;
+        DynamicArray<UINT> rangeTileCounts;
+
+        uint64 first = 0;
+        while (first < mappings.Size())
+        {
+            gaReservedResource* resource = mappings[first].resource;
+            gaMemoryHeap* heap = mappings[first].memory.heap;
+            uint64 end = first + 1;
+            while (end < mappings.Size() && mappings[end].resource == resource &&
+                   mappings[end].memory.heap == heap)
+            {
+                ++end;
+            }
+
+            coordinates.Clear();
+            regionSizes.Clear();
+            rangeFlags.Clear();
+            heapOffsets.Clear();
+            rangeTileCounts.Clear();
+            for (uint64 i = first; i < end; ++i)
+            {
+                const gaTileMapping& mapping = mappings[i];
+                D3D12_TILED_RESOURCE_COORDINATE coordinate = {};
+                coordinate.X = mapping.tile.x;
+                coordinate.Y = mapping.tile.y;
+                coordinate.Subresource = mapping.tile.mip;
+                coordinates.PushBack(coordinate);
+
+                D3D12_TILE_REGION_SIZE regionSize = {};
+                regionSize.NumTiles = 1;
+                regionSizes.PushBack(regionSize);
+
+                rangeFlags.PushBack(heap != nullptr ? D3D12_TILE_RANGE_FLAG_NONE
+                                                    : D3D12_TILE_RANGE_FLAG_NULL);
+                heapOffsets.PushBack(mapping.memory.index);
+                rangeTileCounts.PushBack(1);
+            }
+
+            const UINT count = static_cast<UINT>(end - first);
+            queue->UpdateTileMappings(
+                static_cast<DX12ReservedResource*>(resource)->resource.Get(),
+                count,
+                coordinates.Data(),
+                regionSizes.Data(),
+                heap != nullptr ? static_cast<DX12MemoryHeap*>(heap)->d3d12Heap.Get() : nullptr,
+                count,
+                rangeFlags.Data(),
+                heapOffsets.Data(),
+                rangeTileCounts.Data(),
+                D3D12_TILE_MAPPING_FLAG_NONE);
+            first = end;
+        }
+        return ResultCode::Success;
+    }
+
+    // Mip generation, a single dispatch like the depth pyramid's. A thread group takes a 64x64
+    // tile of mip 0 down to mip 6 in group shared memory, and the last group to finish takes
+    // mip 6 the rest of the way:
+    //   0  root constants     MipConstants
+    //   1  descriptor table   t0 mip 0, u0-u13 mips 1 onwards, null past the texture's
+    //   2  root UAV           scratch, mip 6 onwards in linear float4s, the last group's input
+    //   3  root UAV           finished groups, reset to 0 by a copy before the dispatch
+    // Mips are stored through unordered access, which never reads them back, so the shader needs
+    // typed stores only. sRGB is decoded and encoded in the shader, through unorm views.
+
+    constexpr uint32 kMipGenerationFramesInFlight = 3;
+    constexpr uint32 kMipGenerationDescriptors = kGaMaxGeneratedMips; // Per frame
+    constexpr uint32 kMipGenerationTile = 64; // Of mip 0, a thread group's
+
+    struct MipConstants
+    {
+        uint32 width;
+        uint32 height;
+        uint32 mipCount;
+        uint32 groupCount;
+        uint32 srgb;
+    };
+
+    constexpr char kMipGenerationShader[] = R"(
+cbuffer Constants : register(b0)
+{
+    uint width; // Mip 0's
+    uint height;
+    uint mipCount;
+    uint groupCount;
+    uint srgb;
+};
+
+Texture2D<float4> source : register(t0);
+RWTexture2D<float4> mips[14] : register(u0); // Mip 1 onwards
+// Coherent, the last group reads what the others wrote
+globallycoherent RWStructuredBuffer<float4> scratch : register(u0, space1);
+RWStructuredBuffer<uint> finishedGroups : register(u1, space1);
+
+// 16x16 texels of one mip and 8x8 of the next, taking turns
+groupshared float4 texels[320];
+groupshared bool lastGroup;
+
+// Each half the last rounding down, as rsbl-asset's GenerateMips
+uint2 MipSize(uint mip)
+{
+    return max(uint2(width, height) >> mip, 1);
+}
+
+float4 ToLinear(float4 c)
+{
+    if (srgb != 0)
+    {
+        c.rgb = c.rgb <= 0.04045 ? c.rgb / 12.92 : pow((c.rgb + 0.055) / 1.055, 2.4);
+    }
+    return c;
+}
+
+float4 FromLinear(float4 l)
+{
+    if (srgb != 0)
+    {
+        l.rgb = l.rgb <= 0.0031308 ? l.rgb * 12.92 : 1.055 * pow(l.rgb, 1.0 / 2.4) - 0.055;
+    }
+    return l;
+}
+
+void Store(uint mip, uint2 texel, float4 value)
+{
+    if (mip < mipCount && all(texel < MipSize(mip)))
+    {
+        mips[mip - 1][texel] = FromLinear(value);
+    }
+}
+
+// A 2x2 texel's offset
+uint2 Child(uint i)
+{
+    return uint2(i & 1, i >> 1);
+}
+
+// An odd last row or column is left out, and a side one texel wide repeats itself, by clamping
+// the texels below to the mip
+float4 ReduceSource(uint2 texel)
+{
+    const uint2 last = uint2(width, height) - 1;
+    float4 sum = 0;
+    [unroll] for (uint i = 0; i < 4; ++i)
+    {
+        sum += ToLinear(source.Load(int3(min(texel * 2 + Child(i), last), 0)));
+    }
+    return sum * 0.25;
+}
+
+// A texel of mip from mip - 1 in shared memory, side texels wide from base
+float4 ReduceShared(uint offset, uint side, uint2 base, uint mip, uint2 texel)
+{
+    if (any(texel >= MipSize(mip)))
+    {
+        return 0;
+    }
+    const uint2 last = MipSize(mip - 1) - 1;
+    float4 sum = 0;
+    [unroll] for (uint i = 0; i < 4; ++i)
+    {
+        const uint2 child = min(texel * 2 + Child(i), last) - base;
+        sum += texels[offset + child.y * side + child.x];
+    }
+    return sum * 0.25;
+}
+
+// Where a mip from 6 on starts in scratch
+uint ScratchOffset(uint mip)
+{
+    uint offset = 0;
+    for (uint m = 6; m < mip; ++m)
+    {
+        const uint2 size = MipSize(m);
+        offset += size.x * size.y;
+    }
+    return offset;
+}
+
+[numthreads(256, 1, 1)]
+void main(uint3 group : SV_GroupID, uint index : SV_GroupIndex)
+{
+    // A 4x4 block of mip 0 a thread, 16x16 of them, down to its mip 2 texel
+    const uint2 block = group.xy * 16 + uint2(index % 16, index / 16);
+    float4 mip1[4];
+    [unroll] for (uint i = 0; i < 4; ++i)
+    {
+        const uint2 texel = block * 2 + Child(i);
+        mip1[i] = ReduceSource(texel);
+        Store(1, texel, mip1[i]);
+    }
+    float4 mip2 = 0;
+    if (all(block < MipSize(2)))
+    {
+        const uint2 last = MipSize(1) - 1;
+        [unroll] for (uint j = 0; j < 4; ++j)
+        {
+            const uint2 child = min(block * 2 + Child(j), last) - block * 2;
+            mip2 += mip1[child.y * 2 + child.x];
+        }
+        mip2 *= 0.25;
+    }
+    texels[index] = mip2;
+    Store(2, block, mip2);
+    GroupMemoryBarrierWithGroupSync();
+
+    // Then a quarter of the threads each mip, between the two halves of shared memory
+    if (index < 64)
+    {
+        const uint2 texel = group.xy * 8 + uint2(index % 8, index / 8);
+        texels[256 + index] = ReduceShared(0, 16, group.xy * 16, 3, texel);
+        Store(3, texel, texels[256 + index]);
+    }
+    GroupMemoryBarrierWithGroupSync();
+    if (index < 16)
+    {
+        const uint2 texel = group.xy * 4 + uint2(index % 4, index / 4);
+        texels[index] = ReduceShared(256, 8, group.xy * 8, 4, texel);
+        Store(4, texel, texels[index]);
+    }
+    GroupMemoryBarrierWithGroupSync();
+    if (index < 4)
+    {
+        const uint2 texel = group.xy * 2 + uint2(index % 2, index / 2);
+        texels[256 + index] = ReduceShared(0, 4, group.xy * 4, 5, texel);
+        Store(5, texel, texels[256 + index]);
+    }
+    GroupMemoryBarrierWithGroupSync();
+    if (index == 0)
+    {
+        const float4 mip6 = ReduceShared(256, 2, group.xy * 2, 6, group.xy);
+        Store(6, group.xy, mip6);
+        const uint2 size = MipSize(6);
+        if (all(group.xy < size))
+        {
+            scratch[group.y * size.x + group.x] = mip6;
+        }
+    }
+
+    if (mipCount <= 7)
+    {
+        return;
+    }
+
+    // The last group to finish has every group's mip 6 to go on from
+    DeviceMemoryBarrierWithGroupSync();
+    if (index == 0)
+    {
+        uint finished;
+        InterlockedAdd(finishedGroups[0], 1, finished);
+        lastGroup = finished == groupCount - 1;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // Every group keeps to the syncs, which have to be in uniform flow control, the others just
+    // have nothing to write
+    const bool last = lastGroup;
+    for (uint mip = 7; mip < mipCount; ++mip)
+    {
+        if (last)
+        {
+            const uint sourceOffset = ScratchOffset(mip - 1);
+            const uint2 sourceSize = MipSize(mip - 1);
+            const uint offset = ScratchOffset(mip);
+            const uint2 size = MipSize(mip);
+            for (uint t = index; t < size.x * size.y; t += 256)
+            {
+                const uint2 texel = uint2(t % size.x, t / size.x);
+                float4 sum = 0;
+                [unroll] for (uint i = 0; i < 4; ++i)
+                {
+                    const uint2 child = min(texel * 2 + Child(i), sourceSize - 1);
+                    sum += scratch[sourceOffset + child.y * sourceSize.x + child.x];
+                }
+                scratch[offset + t] = sum * 0.25;
+                Store(mip, texel, sum * 0.25);
+            }
+        }
+        DeviceMemoryBarrierWithGroupSync();
+    }
+}
+)";
+
+    struct DX12MipGenerationPass : public gaMipGenerationPass
+    {
+        struct Frame
+        {
+            RefPtr<ID3D12CommandAllocator> allocator;
+            // Signalled once the frame's dispatch is done with its allocator and descriptors
+            uint64 fenceValue = 0;
+        };
+
+        RefPtr<ID3D12CommandQueue> commandQueue;
+        RefPtr<ID3D12RootSignature> rootSignature;
+        RefPtr<ID3D12PipelineState> pipelineState;
+        RefPtr<ID3D12GraphicsCommandList> commandList;
+        RefPtr<ID3D12DescriptorHeap> descriptorHeap; // kMipGenerationDescriptors a frame
+        uint32 descriptorSize = 0;
+        RefPtr<ID3D12Resource> scratch;
+        RefPtr<ID3D12Resource> finishedGroups;
+        RefPtr<ID3D12Resource> zero; // Upload heap, finishedGroups is reset from
+        DX12Fence fence;
+
+        Frame frames[kMipGenerationFramesInFlight];
+        uint32 frameIndex = 0;
+
+        DX12MipGenerationPass()
+        {
+            backend = gaBackend::DX12;
+        }
+
+        ~DX12MipGenerationPass() override
+        {
+            RSBL_LOG_INFO("Destroying DX12 mip generation pass...");
+
+            // The GPU may still be writing mips
+            fence.Wait(fence.signalledValue);
+        }
+
+        bool Submit(Frame& frame)
+        {
+            if (FAILED(commandList->Close()))
+            {
+                return false;
+            }
+            ID3D12CommandList* lists[] = {commandList.Get()};
+            commandQueue->ExecuteCommandLists(1, lists);
+            if (FAILED(commandQueue->Signal(fence.d3d12Fence.Get(), fence.signalledValue + 1)))
+            {
+                return false;
+            }
+            frame.fenceValue = ++fence.signalledValue;
+            return true;
+        }
+    };
+
+    static Result<> CreateMipGenerationPipeline(ID3D12Device* device, DX12MipGenerationPass& pass)
+    {
+        D3D12_DESCRIPTOR_RANGE ranges[2] = {};
+        ranges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+        ranges[0].NumDescriptors = 1;
+        ranges[0].OffsetInDescriptorsFromTableStart = 0;
+        ranges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_UAV;
+        ranges[1].NumDescriptors = kGaMaxGeneratedMips - 1;
+        ranges[1].OffsetInDescriptorsFromTableStart = 1;
+
+        D3D12_ROOT_PARAMETER parameters[4] = {};
+        parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        parameters[0].Constants.ShaderRegister = 0;
+        parameters[0].Constants.Num32BitValues = sizeof(MipConstants) / sizeof(uint32);
+        parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+        parameters[1].DescriptorTable.NumDescriptorRanges = 2;
+        parameters[1].DescriptorTable.pDescriptorRanges = ranges;
+        parameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        parameters[2].Descriptor.ShaderRegister = 0;
+        parameters[2].Descriptor.RegisterSpace = 1;
+        parameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+        parameters[3].Descriptor.ShaderRegister = 1;
+        parameters[3].Descriptor.RegisterSpace = 1;
+        return CreateComputePipeline(device, "rsbl-mip-generation", kMipGenerationShader,
+                                     sizeof(kMipGenerationShader) - 1, parameters,
+                                     pass.rootSignature, pass.pipelineState);
+    }
+
+    Result<gaMipGenerationPass*> CreateDX12MipGenerationPass(
+        const gaMipGenerationPassCreateInfo& createInfo)
+    {
+        RSBL_LOG_INFO("Creating DX12 mip generation pass...");
+
+        auto dx12Device = static_cast<DX12Device*>(createInfo.device);
+        if (dx12Device->commandQueues.Size() == 0)
+        {
+            return "No command queues available on device";
+        }
+        ID3D12Device* device = dx12Device->d3d12Device.Get();
+
+        auto pass = rsbl::UniquePtr(new DX12MipGenerationPass());
+        pass->maxWidth = createInfo.maxWidth;
+        pass->maxHeight = createInfo.maxHeight;
+        // The graphics queue, so the mips are ordered between the lists writing and sampling
+        pass->commandQueue = dx12Device->commandQueues[0];
+
+        if (auto pipeline = CreateMipGenerationPipeline(device, *pass); !pipeline)
+        {
+            return PendingFailure{pipeline.Category()};
+        }
+
+        D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+        heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+        heapDesc.NumDescriptors = kMipGenerationDescriptors * kMipGenerationFramesInFlight;
+        heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+        if (FAILED(device->CreateDescriptorHeap(
+                &heapDesc, IID_PPV_ARGS(pass->descriptorHeap.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create the mip generation descriptor heap";
+        }
+        pass->descriptorSize =
+            device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+        // Mip 6 onwards of the largest texture, as the shader's MipSize has them
+        uint64 scratchTexels = 0;
+        const uint32 mipCount = GaMipCount(createInfo.maxWidth, createInfo.maxHeight);
+        for (uint32 mip = 6; mip < mipCount; ++mip)
+        {
+            const uint32 width = createInfo.maxWidth >> mip;
+            const uint32 height = createInfo.maxHeight >> mip;
+            scratchTexels += uint64(width > 0 ? width : 1) * (height > 0 ? height : 1);
+        }
+        const uint64 scratchSize = (scratchTexels > 0 ? scratchTexels : 1) * 4 * sizeof(float);
+        if (FAILED(CreateBuffer(device, scratchSize, D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+                                D3D12_RESOURCE_STATE_COMMON, pass->scratch)) ||
+            FAILED(CreateBuffer(device, sizeof(uint32), D3D12_HEAP_TYPE_DEFAULT,
+                                D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
+                                D3D12_RESOURCE_STATE_COMMON, pass->finishedGroups)) ||
+            FAILED(CreateBuffer(device, sizeof(uint32), D3D12_HEAP_TYPE_UPLOAD,
+                                D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_GENERIC_READ,
+                                pass->zero)))
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create the mip generation buffers"};
+        }
+
+        void* zero = nullptr;
+        D3D12_RANGE noRead = {0, 0};
+        if (FAILED(pass->zero->Map(0, &noRead, &zero)))
+        {
+            return "Failed to map the mip generation reset buffer";
+        }
+        memset(zero, 0, sizeof(uint32));
+        pass->zero->Unmap(0, nullptr);
+
+        for (DX12MipGenerationPass::Frame& frame : pass->frames)
+        {
+            if (FAILED(device->CreateCommandAllocator(
+                    D3D12_COMMAND_LIST_TYPE_DIRECT,
+                    IID_PPV_ARGS(frame.allocator.ReleaseAndGetAddressOf()))))
+            {
+                return "Failed to create a mip generation command allocator";
+            }
+        }
+
+        // Lists are created open, and Generate expects it closed
+        if (FAILED(device->CreateCommandList(
+                0, D3D12_COMMAND_LIST_TYPE_DIRECT, pass->frames[0].allocator.Get(),
+                pass->pipelineState.Get(),
+                IID_PPV_ARGS(pass->commandList.ReleaseAndGetAddressOf()))) ||
+            FAILED(pass->commandList->Close()))
+        {
+            return "Failed to create the mip generation command list";
+        }
+
+        if (auto fence = InitFence(device, 0, pass->fence); !fence)
+        {
+            return PendingFailure{fence.Category()};
+        }
+
+        RSBL_LOG_INFO("Mip generation pass created: up to {}x{}", createInfo.maxWidth,
+                      createInfo.maxHeight);
+        return pass.Release();
+    }
+
+    Result<> GenerateDX12Mips(gaMipGenerationPass* basePass, const gaMipGenerationTarget& target)
+    {
+        auto pass = static_cast<DX12MipGenerationPass*>(basePass);
+
+        DX12MipGenerationPass::Frame& frame = pass->frames[pass->frameIndex];
+        const uint32 firstDescriptor = pass->frameIndex * kMipGenerationDescriptors;
+        pass->frameIndex = (pass->frameIndex + 1) % kMipGenerationFramesInFlight;
+
+        // The frame's descriptors and allocator are free again once its last dispatch is done
+        if (!pass->fence.Wait(frame.fenceValue))
+        {
+            return "Failed to wait for the mip generation pass";
+        }
+
+        ID3D12GraphicsCommandList* list = pass->commandList.Get();
+        if (FAILED(frame.allocator->Reset()) ||
+            FAILED(list->Reset(frame.allocator.Get(), pass->pipelineState.Get())))
+        {
+            return "Failed to reset the mip generation command list";
+        }
+
+        RefPtr<ID3D12Device> device;
+        if (FAILED(pass->scratch->GetDevice(IID_PPV_ARGS(device.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to get the mip generation pass's device";
+        }
+
+        // Unordered access has no sRGB, the shader encodes it through the unorm view
+        const bool srgb = target.format == gaFormat::R8G8B8A8Srgb;
+        const DXGI_FORMAT format = srgb ? DXGI_FORMAT_R8G8B8A8_UNORM
+                                        : kDxgiFormats[static_cast<uint32>(target.format)];
+        ID3D12Resource* texture = static_cast<ID3D12Resource*>(target.texture);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE descriptor =
+            pass->descriptorHeap->GetCPUDescriptorHandleForHeapStart();
+        descriptor.ptr += uint64(firstDescriptor) * pass->descriptorSize;
+
+        D3D12_SHADER_RESOURCE_VIEW_DESC sourceDesc = {};
+        sourceDesc.Format = format;
+        sourceDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        sourceDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+        sourceDesc.Texture2D.MipLevels = 1;
+        device->CreateShaderResourceView(texture, &sourceDesc, descriptor);
+
+        // Every descriptor of the table is written, the ones past the texture's mips null
+        for (uint32 mip = 1; mip < kGaMaxGeneratedMips; ++mip)
+        {
+            descriptor.ptr += pass->descriptorSize;
+            D3D12_UNORDERED_ACCESS_VIEW_DESC mipDesc = {};
+            mipDesc.Format = format;
+            mipDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+            mipDesc.Texture2D.MipSlice = mip < target.mipCount ? mip : 0;
+            device->CreateUnorderedAccessView(
+                mip < target.mipCount ? texture : nullptr, nullptr, &mipDesc, descriptor);
+        }
+
+        // Mip 0 promotes from COMMON to be read, and decays back after. Textures don't promote
+        // to UNORDERED_ACCESS, so the mips below go there and back explicitly.
+        D3D12_RESOURCE_BARRIER toWrite[kGaMaxGeneratedMips] = {};
+        toWrite[0] = Transition(pass->finishedGroups.Get(),
+                                D3D12_RESOURCE_STATE_COPY_DEST,
+                                D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        for (uint32 mip = 1; mip < target.mipCount; ++mip)
+        {
+            toWrite[mip] = Transition(
+                texture, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+            toWrite[mip].Transition.Subresource = mip;
+        }
+        list->CopyBufferRegion(pass->finishedGroups.Get(), 0, pass->zero.Get(), 0, sizeof(uint32));
+        list->ResourceBarrier(target.mipCount, toWrite);
+
+        const uint32 groupsX = (target.width + kMipGenerationTile - 1) / kMipGenerationTile;
+        const uint32 groupsY = (target.height + kMipGenerationTile - 1) / kMipGenerationTile;
+        MipConstants constants = {};
+        constants.width = target.width;
+        constants.height = target.height;
+        constants.mipCount = target.mipCount;
+        constants.groupCount = groupsX * groupsY;
+        constants.srgb = srgb ? 1 : 0;
+
+        D3D12_GPU_DESCRIPTOR_HANDLE table =
+            pass->descriptorHeap->GetGPUDescriptorHandleForHeapStart();
+        table.ptr += uint64(firstDescriptor) * pass->descriptorSize;
+        ID3D12DescriptorHeap* heaps[] = {pass->descriptorHeap.Get()};
+        list->SetDescriptorHeaps(1, heaps);
+        list->SetComputeRootSignature(pass->rootSignature.Get());
+        list->SetComputeRoot32BitConstants(
+            0, sizeof(MipConstants) / sizeof(uint32), &constants, 0);
+        list->SetComputeRootDescriptorTable(1, table);
+        list->SetComputeRootUnorderedAccessView(2, pass->scratch->GetGPUVirtualAddress());
+        list->SetComputeRootUnorderedAccessView(3, pass->finishedGroups->GetGPUVirtualAddress());
+        list->Dispatch(groupsX, groupsY, 1);
+
+        D3D12_RESOURCE_BARRIER toCommon[kGaMaxGeneratedMips] = {};
+        for (uint32 mip = 1; mip < target.mipCount; ++mip)
+        {
+            toCommon[mip - 1] = Transition(
+                texture, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_COMMON);
+            toCommon[mip - 1].Transition.Subresource = mip;
+        }
+        list->ResourceBarrier(target.mipCount - 1, toCommon);
+
+        if (!pass->Submit(frame))
+        {
+            return "Failed to submit the mip generation dispatch";
+        }
+        return ResultCode::Success;
+    }
+
+    struct DX12PipelineLibrary : public PipelineLibrary
+    {
+        RefPtr<ID3D12PipelineLibrary> library;
+        DynamicArray<uint8> data; // The library reads out of it for as long as it lives
+    };
+
+    struct DX12PipelineLayout : public PipelineLayout
+    {
+        RefPtr<ID3D12RootSignature> rootSignature;
+    };
+
+    struct DX12Pipeline : public gaPipeline
+    {
+        RefPtr<ID3D12PipelineState> pipelineState;
+    };
+
+    Result<PipelineLibrary*> CreateDX12PipelineLibrary(gaDevice* baseDevice,
+                                                       ArrayView<const uint8> data)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        auto library = rsbl::UniquePtr(new DX12PipelineLibrary());
+
+        // Without ID3D12Device1 there's no library, and every pipeline is compiled
+        RefPtr<ID3D12Device1> device1;
+        if (FAILED(device->d3d12Device->QueryInterface(
+                IID_PPV_ARGS(device1.ReleaseAndGetAddressOf()))))
+        {
+            return library.Release();
+        }
+
+        library->data.ResizeUninitialized(data.Size());
+        memcpy(library->data.Data(), data.Data(), data.Size());
+        HRESULT hr = device1->CreatePipelineLibrary(
+            library->data.Data(), library->data.Size(),
+            IID_PPV_ARGS(library->library.ReleaseAndGetAddressOf()));
+
+        // Data from another driver or adapter is of no use, start over
+        if (FAILED(hr) && !library->data.IsEmpty())
+        {
+            RSBL_LOG_INFO("Pipeline library data is stale, starting an empty library");
+            library->data.Clear();
+            hr = device1->CreatePipelineLibrary(
+                nullptr, 0, IID_PPV_ARGS(library->library.ReleaseAndGetAddressOf()));
+        }
+        if (FAILED(hr))
+        {
+            RSBL_LOG_WARNING("Pipeline libraries aren't supported, pipelines won't be kept");
+            return library.Release();
+        }
+        library->handle = library->library.Get();
+        return library.Release();
+    }
+
+    Result<> SerializeDX12PipelineLibrary(PipelineLibrary* baseLibrary, DynamicArray<uint8>& data)
+    {
+        auto library = static_cast<DX12PipelineLibrary*>(baseLibrary);
+        if (!library->library)
+        {
+            return ResultCode::Success;
+        }
+
+        const uint64 offset = data.Size();
+        const SIZE_T size = library->library->GetSerializedSize();
+        data.ResizeUninitialized(offset + size);
+        if (FAILED(library->library->Serialize(data.Data() + offset, size)))
+        {
+            data.Resize(offset);
+            return "Failed to serialize the pipeline library";
+        }
+        return ResultCode::Success;
+    }
+
+    static D3D12_STATIC_SAMPLER_DESC StaticSamplerDesc(const gaSamplerDesc& sampler, uint32 reg)
+    {
+        constexpr D3D12_FILTER kFilters[] = {
+            D3D12_FILTER_MIN_MAG_MIP_POINT,
+            D3D12_FILTER_MIN_MAG_MIP_LINEAR,
+            D3D12_FILTER_ANISOTROPIC,
+        };
+        constexpr D3D12_FILTER kComparisonFilters[] = {
+            D3D12_FILTER_COMPARISON_MIN_MAG_MIP_POINT,
+            D3D12_FILTER_COMPARISON_MIN_MAG_MIP_LINEAR,
+            D3D12_FILTER_COMPARISON_ANISOTROPIC,
+        };
+        constexpr D3D12_TEXTURE_ADDRESS_MODE kAddressModes[] = {
+            D3D12_TEXTURE_ADDRESS_MODE_WRAP,
+            D3D12_TEXTURE_ADDRESS_MODE_MIRROR,
+            D3D12_TEXTURE_ADDRESS_MODE_CLAMP,
+        };
+
+        const uint32 filter = static_cast<uint32>(sampler.filter);
+        D3D12_STATIC_SAMPLER_DESC desc = {};
+        desc.Filter = sampler.compare ? kComparisonFilters[filter] : kFilters[filter];
+        desc.AddressU = kAddressModes[static_cast<uint32>(sampler.addressU)];
+        desc.AddressV = kAddressModes[static_cast<uint32>(sampler.addressV)];
+        desc.AddressW = kAddressModes[static_cast<uint32>(sampler.addressW)];
+        desc.MipLODBias = sampler.mipBias;
+        desc.MaxAnisotropy = sampler.filter == gaFilter::Anisotropic ? sampler.maxAnisotropy : 1;
+        desc.ComparisonFunc = sampler.compare
+                                  ? kComparisonFuncs[static_cast<uint32>(sampler.compareOp)]
+                                  : D3D12_COMPARISON_FUNC_NEVER;
+        desc.BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_BLACK;
+        desc.MinLOD = 0.0f;
+        desc.MaxLOD = D3D12_FLOAT32_MAX;
+        desc.ShaderRegister = reg;
+        desc.RegisterSpace = 0;
+        desc.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+        return desc;
+    }
+
+    Result<PipelineLayout*> CreateDX12PipelineLayout(gaDevice* baseDevice,
+                                                     const gaBindlessHeap* bindless,
+                                                     bool compute,
+                                                     uint32 pushConstantBytes)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+
+        D3D12_ROOT_PARAMETER1 parameter = {};
+        parameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+        parameter.Constants.ShaderRegister = 0;
+        parameter.Constants.Num32BitValues = pushConstantBytes / 4;
+        parameter.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+        // Bindless shaders index ResourceDescriptorHeap directly, there's no table to declare
+        D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootDesc = {};
+        rootDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+        rootDesc.Desc_1_1.NumParameters = pushConstantBytes > 0 ? 1 : 0;
+        rootDesc.Desc_1_1.pParameters = &parameter;
+        if (!compute)
+        {
+            rootDesc.Desc_1_1.Flags |= D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+        }
+        D3D12_STATIC_SAMPLER_DESC samplers[kGaMaxBindlessSamplers] = {};
+        if (bindless != nullptr)
+        {
+            rootDesc.Desc_1_1.Flags |= D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED;
+
+            // The heap's samplers as s0 onwards, so no sampler heap is needed at all
+            for (uint32 index = 0; index < bindless->samplers.Size(); ++index)
+            {
+                samplers[index] = StaticSamplerDesc(bindless->samplers[index], index);
+            }
+            rootDesc.Desc_1_1.NumStaticSamplers = static_cast<UINT>(bindless->samplers.Size());
+            rootDesc.Desc_1_1.pStaticSamplers = samplers;
+        }
+
+        RefPtr<ID3DBlob> serialized;
+        RefPtr<ID3DBlob> errors;
+        if (FAILED(D3D12SerializeVersionedRootSignature(&rootDesc,
+                                                        serialized.ReleaseAndGetAddressOf(),
+                                                        errors.ReleaseAndGetAddressOf())))
+        {
+            if (errors)
+            {
+                RSBL_LOG_ERROR("Root signature: {}",
+                               static_cast<const char*>(errors->GetBufferPointer()));
+            }
+            return "Failed to serialize a pipeline root signature";
+        }
+
+        auto layout = rsbl::UniquePtr(new DX12PipelineLayout());
+        if (FAILED(device->d3d12Device->CreateRootSignature(
+                0, serialized->GetBufferPointer(), serialized->GetBufferSize(),
+                IID_PPV_ARGS(layout->rootSignature.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create a pipeline root signature";
+        }
+        layout->handle = layout->rootSignature.Get();
+        return layout.Release();
+    }
+
+    // Pipelines are stored in the library under their key, in hex
+    static void PipelineName(uint64 key, wchar_t (&name)[17])
+    {
+        for (int32 i = 15; i >= 0; --i, key >>= 4)
+        {
+            name[i] = L"0123456789abcdef"[key & 15];
+        }
+        name[16] = L'\0';
+    }
+
+    static D3D12_SHADER_BYTECODE ShaderBytecode(const gaShaderBytecode& shader)
+    {
+        return {shader.data, static_cast<SIZE_T>(shader.size)};
+    }
+
+    static D3D12_RENDER_TARGET_BLEND_DESC BlendDesc(gaBlendMode mode)
+    {
+        D3D12_RENDER_TARGET_BLEND_DESC blend = {};
+        blend.BlendEnable = mode != gaBlendMode::Opaque;
+        blend.SrcBlend = mode == gaBlendMode::Premultiplied ? D3D12_BLEND_ONE
+                                                             : D3D12_BLEND_SRC_ALPHA;
+        blend.DestBlend = mode == gaBlendMode::Additive ? D3D12_BLEND_ONE
+                                                        : D3D12_BLEND_INV_SRC_ALPHA;
+        blend.BlendOp = D3D12_BLEND_OP_ADD;
+        blend.SrcBlendAlpha = D3D12_BLEND_ONE;
+        blend.DestBlendAlpha = blend.DestBlend;
+        blend.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+        blend.LogicOp = D3D12_LOGIC_OP_NOOP;
+        blend.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+        return blend;
+    }
+
+    // A pipeline state stream subobject, its type then its value, each pointer aligned
+    template <D3D12_PIPELINE_STATE_SUBOBJECT_TYPE Type, typename T>
+    struct alignas(alignof(void*)) StreamSubobject
+    {
+        D3D12_PIPELINE_STATE_SUBOBJECT_TYPE type = Type;
+        T value = {};
+    };
+
+    // What a mesh pipeline is made from. Amplification and mesh shaders only come in streams.
+    struct MeshPipelineStream
+    {
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_ROOT_SIGNATURE, ID3D12RootSignature*>
+            rootSignature;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_AS, D3D12_SHADER_BYTECODE> as;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_MS, D3D12_SHADER_BYTECODE> ms;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PS, D3D12_SHADER_BYTECODE> ps;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_BLEND, D3D12_BLEND_DESC> blend;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_MASK, UINT> sampleMask;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RASTERIZER, D3D12_RASTERIZER_DESC>
+            rasterizer;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL, D3D12_DEPTH_STENCIL_DESC>
+            depthStencil;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_PRIMITIVE_TOPOLOGY,
+                        D3D12_PRIMITIVE_TOPOLOGY_TYPE>
+            topology;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_RENDER_TARGET_FORMATS,
+                        D3D12_RT_FORMAT_ARRAY>
+            renderTargetFormats;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_DEPTH_STENCIL_FORMAT, DXGI_FORMAT>
+            depthFormat;
+        StreamSubobject<D3D12_PIPELINE_STATE_SUBOBJECT_TYPE_SAMPLE_DESC, DXGI_SAMPLE_DESC>
+            sampleDesc;
+    };
+
+    // The graphics description's state with the amplification and mesh shaders in place of the
+    // vertex shader and input layout
+    static Result<gaPipeline*> CreateDX12MeshPipeline(
+        DX12Device* device,
+        DX12PipelineLibrary* library,
+        uint64 key,
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC& state,
+        const gaGraphicsPipelineDesc& desc)
+    {
+        MeshPipelineStream stream;
+        stream.rootSignature.value = state.pRootSignature;
+        stream.as.value = ShaderBytecode(desc.amplificationShader);
+        stream.ms.value = ShaderBytecode(desc.meshShader);
+        stream.ps.value = state.PS;
+        stream.blend.value = state.BlendState;
+        stream.sampleMask.value = state.SampleMask;
+        stream.rasterizer.value = state.RasterizerState;
+        stream.depthStencil.value = state.DepthStencilState;
+        stream.topology.value = state.PrimitiveTopologyType;
+        stream.renderTargetFormats.value.NumRenderTargets = state.NumRenderTargets;
+        for (uint32 i = 0; i < state.NumRenderTargets; ++i)
+        {
+            stream.renderTargetFormats.value.RTFormats[i] = state.RTVFormats[i];
+        }
+        stream.depthFormat.value = state.DSVFormat;
+        stream.sampleDesc.value = state.SampleDesc;
+        const D3D12_PIPELINE_STATE_STREAM_DESC streamDesc = {sizeof(stream), &stream};
+
+        auto pipeline = rsbl::UniquePtr(new DX12Pipeline());
+        wchar_t name[17];
+        PipelineName(key, name);
+        RefPtr<ID3D12PipelineLibrary1> library1;
+        if (library->library &&
+            SUCCEEDED(library->library->QueryInterface(
+                IID_PPV_ARGS(library1.ReleaseAndGetAddressOf()))) &&
+            SUCCEEDED(library1->LoadPipeline(
+                name, &streamDesc,
+                IID_PPV_ARGS(pipeline->pipelineState.ReleaseAndGetAddressOf()))))
+        {
+            pipeline->internalHandle = pipeline->pipelineState.Get();
+            return pipeline.Release();
+        }
+
+        RefPtr<ID3D12Device2> device2;
+        if (FAILED(device->d3d12Device->QueryInterface(
+                IID_PPV_ARGS(device2.ReleaseAndGetAddressOf()))) ||
+            FAILED(device2->CreatePipelineState(
+                &streamDesc, IID_PPV_ARGS(pipeline->pipelineState.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create a mesh pipeline state";
+        }
+        if (library->library)
+        {
+            (void)library->library->StorePipeline(name, pipeline->pipelineState.Get());
+        }
+        pipeline->internalHandle = pipeline->pipelineState.Get();
+        return pipeline.Release();
+    }
+
+    Result<gaPipeline*> CreateDX12GraphicsPipeline(gaDevice* baseDevice,
+                                                   PipelineLibrary* baseLibrary,
+                                                   PipelineLayout* layout,
+                                                   uint64 key,
+                                                   const gaGraphicsPipelineDesc& desc)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        auto library = static_cast<DX12PipelineLibrary*>(baseLibrary);
+
+        D3D12_INPUT_ELEMENT_DESC elements[kGaMaxVertexAttributes] = {};
+        for (uint32 i = 0; i < desc.attributes.Size(); ++i)
+        {
+            const gaVertexAttribute& attribute = desc.attributes[i];
+            const bool perInstance = desc.vertexBuffers[attribute.buffer].perInstance;
+            elements[i].SemanticName = "ATTRIBUTE";
+            elements[i].SemanticIndex = attribute.location;
+            elements[i].Format = kDxgiFormats[static_cast<uint32>(attribute.format)];
+            elements[i].InputSlot = attribute.buffer;
+            elements[i].AlignedByteOffset = attribute.offset;
+            elements[i].InputSlotClass = perInstance
+                                             ? D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA
+                                             : D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+            elements[i].InstanceDataStepRate = perInstance ? 1 : 0;
+        }
+
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC pipelineDesc = {};
+        pipelineDesc.pRootSignature = static_cast<DX12PipelineLayout*>(layout)->rootSignature.Get();
+        pipelineDesc.VS = ShaderBytecode(desc.vertexShader);
+        pipelineDesc.PS = ShaderBytecode(desc.pixelShader);
+        pipelineDesc.BlendState.IndependentBlendEnable = TRUE;
+        for (uint32 i = 0; i < desc.renderTargetFormats.Size(); ++i)
+        {
+            pipelineDesc.BlendState.RenderTarget[i] =
+                BlendDesc(desc.blendModes.IsEmpty() ? gaBlendMode::Opaque : desc.blendModes[i]);
+            pipelineDesc.RTVFormats[i] =
+                kDxgiFormats[static_cast<uint32>(desc.renderTargetFormats[i])];
+        }
+        pipelineDesc.NumRenderTargets = static_cast<UINT>(desc.renderTargetFormats.Size());
+        pipelineDesc.DSVFormat = kDxgiFormats[static_cast<uint32>(desc.depthFormat)];
+        pipelineDesc.SampleMask = UINT_MAX;
+
+        D3D12_RASTERIZER_DESC& raster = pipelineDesc.RasterizerState;
+        raster.FillMode = desc.raster.wireframe ? D3D12_FILL_MODE_WIREFRAME : D3D12_FILL_MODE_SOLID;
+        raster.CullMode = kCullModes[static_cast<uint32>(desc.raster.cull)];
+        raster.FrontCounterClockwise = desc.raster.frontCounterClockwise;
+        raster.DepthBias = desc.raster.depthBias;
+        raster.SlopeScaledDepthBias = desc.raster.slopeScaledDepthBias;
+        raster.DepthClipEnable = desc.raster.depthClip;
+
+        D3D12_DEPTH_STENCIL_DESC& depth = pipelineDesc.DepthStencilState;
+        depth.DepthEnable = desc.depth.test;
+        depth.DepthWriteMask =
+            desc.depth.write ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
+        depth.DepthFunc = kComparisonFuncs[static_cast<uint32>(desc.depth.compare)];
+
+        pipelineDesc.InputLayout = {elements, static_cast<UINT>(desc.attributes.Size())};
+        pipelineDesc.PrimitiveTopologyType = kTopologyTypes[static_cast<uint32>(desc.topology)];
+        pipelineDesc.SampleDesc.Count = 1;
+
+        if (desc.meshShader.size > 0)
+        {
+            return CreateDX12MeshPipeline(device, library, key, pipelineDesc, desc);
+        }
+
+        auto pipeline = rsbl::UniquePtr(new DX12Pipeline());
+        wchar_t name[17];
+        PipelineName(key, name);
+        if (library->library &&
+            SUCCEEDED(library->library->LoadGraphicsPipeline(
+                name, &pipelineDesc,
+                IID_PPV_ARGS(pipeline->pipelineState.ReleaseAndGetAddressOf()))))
+        {
+            pipeline->internalHandle = pipeline->pipelineState.Get();
+            return pipeline.Release();
+        }
+
+        if (FAILED(device->d3d12Device->CreateGraphicsPipelineState(
+                &pipelineDesc, IID_PPV_ARGS(pipeline->pipelineState.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create a graphics pipeline state";
+        }
+        if (library->library)
+        {
+            (void)library->library->StorePipeline(name, pipeline->pipelineState.Get());
+        }
+        pipeline->internalHandle = pipeline->pipelineState.Get();
+        return pipeline.Release();
+    }
+
+    Result<gaPipeline*> CreateDX12ComputePipeline(gaDevice* baseDevice,
+                                                  PipelineLibrary* baseLibrary,
+                                                  PipelineLayout* layout,
+                                                  uint64 key,
+                                                  const gaComputePipelineDesc& desc)
+    {
+        auto device = static_cast<DX12Device*>(baseDevice);
+        auto library = static_cast<DX12PipelineLibrary*>(baseLibrary);
+
+        D3D12_COMPUTE_PIPELINE_STATE_DESC pipelineDesc = {};
+        pipelineDesc.pRootSignature = static_cast<DX12PipelineLayout*>(layout)->rootSignature.Get();
+        pipelineDesc.CS = ShaderBytecode(desc.shader);
+
+        auto pipeline = rsbl::UniquePtr(new DX12Pipeline());
+        wchar_t name[17];
+        PipelineName(key, name);
+        if (library->library &&
+            SUCCEEDED(library->library->LoadComputePipeline(
+                name, &pipelineDesc,
+                IID_PPV_ARGS(pipeline->pipelineState.ReleaseAndGetAddressOf()))))
+        {
+            pipeline->internalHandle = pipeline->pipelineState.Get();
+            return pipeline.Release();
+        }
+
+        if (FAILED(device->d3d12Device->CreateComputePipelineState(
+                &pipelineDesc, IID_PPV_ARGS(pipeline->pipelineState.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create a compute pipeline state";
+        }
+        if (library->library)
+        {
+            (void)library->library->StorePipeline(name, pipeline->pipelineState.Get());
+        }
+        pipeline->internalHandle = pipeline->pipelineState.Get();
+        return pipeline.Release();
+    }
+
+    // A bundle list with an allocator of its own, both reset each time it's begun
+    struct DX12CommandBundle : public CommandBundle
+    {
+        RefPtr<ID3D12CommandAllocator> allocator;
+        DX12CommandList bundleList;
+
+        DX12CommandBundle()
+        {
+            backend = gaBackend::DX12;
+            internalHandle = nullptr;
+            list = &bundleList;
+        }
+    };
+
+    Result<CommandBundle*> CreateDX12CommandBundle(const gaCommandBundleCreateInfo& createInfo)
+    {
+        auto device = static_cast<DX12Device*>(createInfo.device);
+        auto bundle = rsbl::UniquePtr(new DX12CommandBundle());
+        if (FAILED(device->d3d12Device->CreateCommandAllocator(
+                D3D12_COMMAND_LIST_TYPE_BUNDLE,
+                IID_PPV_ARGS(bundle->allocator.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to create a bundle allocator";
+        }
+
+        // Lists are created recording, a bundle isn't until it's begun
+        DX12CommandList& list = bundle->bundleList;
+        if (FAILED(device->d3d12Device->CreateCommandList(
+                0, D3D12_COMMAND_LIST_TYPE_BUNDLE, bundle->allocator.Get(), nullptr,
+                IID_PPV_ARGS(list.commandList.ReleaseAndGetAddressOf()))) ||
+            FAILED(list.commandList->Close()))
+        {
+            return "Failed to create a bundle";
+        }
+        if (device->meshShaders &&
+            FAILED(list.commandList->QueryInterface(
+                IID_PPV_ARGS(list.meshCommandList.ReleaseAndGetAddressOf()))))
+        {
+            return "Failed to get the bundle's mesh shader interface";
+        }
+        list.internalHandle = list.commandList.Get();
+        bundle->internalHandle = list.commandList.Get();
+        return bundle.Release();
+    }
+
+    Result<> BeginDX12CommandBundle(CommandBundle* baseBundle)
+    {
+        auto bundle = static_cast<DX12CommandBundle*>(baseBundle);
+        if (FAILED(bundle->allocator->Reset()) ||
+            FAILED(bundle->bundleList.commandList->Reset(bundle->allocator.Get(), nullptr)))
+        {
+            return "Failed to reset the bundle";
+        }
+        return ResultCode::Success;
+    }
+
+    void ExecuteDX12Bundle(gaCommandList* list, CommandBundle* bundle)
+    {
+        static_cast<DX12CommandList*>(list)->commandList->ExecuteBundle(
+            static_cast<DX12CommandBundle*>(bundle)->bundleList.commandList.Get());
+    }
+
 } // namespace backend
 } // namespace rsbl
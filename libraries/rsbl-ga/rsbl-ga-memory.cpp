@@ -0,0 +1,517 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+#include <rsbl-range-allocator.h>
+
+namespace rsbl
+{
+
+namespace
+{
+// Placed resources' default alignment on both APIs, heaps are sized in multiples of it
+constexpr uint64 kHeapAlignment = 64 * 1024;
+
+constexpr uint32 kMemoryTypes = static_cast<uint32>(gaMemoryType::Count);
+
+struct MemoryAllocation;
+
+struct SharedHeap
+{
+    UniquePtr<gaMemoryHeap> heap;
+    RangeAllocator ranges;
+    DynamicArray<MemoryAllocation*> allocations;
+    bool evacuating = false; // The source of a defragmentation pass, nothing new goes in
+};
+
+struct MemoryAllocation : public gaMemoryAllocation
+{
+    SharedHeap* owner = nullptr;      // nullptr when the allocation has a heap of its own
+    UniquePtr<gaMemoryHeap> dedicated; // That heap
+    uint64 alignment = 1;
+    uint32 range = RangeAllocator::kInvalidRange;
+    uint32 index = 0; // In owner->allocations
+};
+
+// A range an allocation was moved out of, freed once the copy is done
+struct PendingFree
+{
+    SharedHeap* heap;
+    uint32 range;
+};
+
+struct MemoryAllocator : public gaMemoryAllocator
+{
+    DynamicArray<UniquePtr<SharedHeap>> heaps[kMemoryTypes];
+    uint32 dedicatedAllocations[kMemoryTypes] = {};
+    uint64 dedicatedBytes[kMemoryTypes] = {};
+
+    bool defragmenting = false;
+    DynamicArray<gaDefragmentMove> moves;
+    DynamicArray<PendingFree> pendingFrees;
+};
+
+Result<gaMemoryHeap*> CreateBackendHeap(gaDevice* device,
+                                        gaMemoryType type,
+                                        uint64 size,
+                                        uint64 alignment)
+{
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullMemoryHeap(device, type, size, alignment);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12MemoryHeap(device, type, size, alignment);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanMemoryHeap(device, type, size, alignment);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaMemoryHeap*> CreateHeap(gaDevice* device,
+                                 gaMemoryType type,
+                                 uint64 size,
+                                 uint64 alignment)
+{
+    Result<gaMemoryHeap*> heap = CreateBackendHeap(device, type, size, alignment);
+    if (heap)
+    {
+        heap.Value()->type = type;
+        heap.Value()->size = size;
+    }
+    return heap;
+}
+
+void Place(SharedHeap& heap, MemoryAllocation* allocation, RangeAllocator::Range range)
+{
+    allocation->owner = &heap;
+    allocation->heap = heap.heap.Get();
+    allocation->offset = range.offset;
+    allocation->range = range.id;
+    allocation->index = static_cast<uint32>(heap.allocations.Size());
+    heap.allocations.PushBack(allocation);
+}
+
+// Takes the allocation off its heap's list, leaving its range allocated
+void Unlist(MemoryAllocation* allocation)
+{
+    DynamicArray<MemoryAllocation*>& allocations = allocation->owner->allocations;
+    MemoryAllocation* last = allocations[allocations.Size() - 1];
+    allocations[allocation->index] = last;
+    last->index = allocation->index;
+    allocations.PopBack();
+}
+
+// Empty heaps are given back, except the last of a type, so one allocation coming and going
+// doesn't create and release a heap each time
+void ReleaseIfEmpty(MemoryAllocator* allocator, gaMemoryType type, SharedHeap* heap)
+{
+    DynamicArray<UniquePtr<SharedHeap>>& heaps = allocator->heaps[static_cast<uint32>(type)];
+    if (heap->evacuating || heap->ranges.AllocationCount() > 0 || heaps.Size() < 2)
+    {
+        return;
+    }
+
+    for (uint64 i = 0; i < heaps.Size(); ++i)
+    {
+        if (heaps[i].Get() == heap)
+        {
+            heaps[i] = rsblMove(heaps[heaps.Size() - 1]);
+            heaps.PopBack();
+            return;
+        }
+    }
+}
+
+// Alignments above 64KB, for MSAA render targets, only go in heaps of their own
+Result<gaMemoryAllocation*> AllocateDedicated(MemoryAllocator* allocator,
+                                              gaMemoryType type,
+                                              uint64 size,
+                                              uint64 alignment)
+{
+    alignment = alignment > kHeapAlignment ? alignment : kHeapAlignment;
+    auto allocation = rsbl::UniquePtr(new MemoryAllocation());
+    auto heap = CreateHeap(allocator->device, type, AlignUp(size, alignment), alignment);
+    if (!heap)
+    {
+        return PendingFailure{heap.Category()};
+    }
+    allocation->dedicated.Reset(heap.Value());
+    allocation->heap = heap.Value();
+    allocation->offset = 0;
+    allocation->size = size;
+
+    const uint32 typeIndex = static_cast<uint32>(type);
+    ++allocator->dedicatedAllocations[typeIndex];
+    allocator->dedicatedBytes[typeIndex] += heap.Value()->size;
+    return allocation.Release();
+}
+} // namespace
+
+Result<gaMemoryAllocator*> GaCreateMemoryAllocator(const gaMemoryAllocatorCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.heapSize < kHeapAlignment)
+    {
+        return "Memory allocator heap size must be at least 64KB";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    MemoryAllocator* allocator = new MemoryAllocator();
+    allocator->device = createInfo.device;
+    allocator->heapSize = AlignUp(createInfo.heapSize, kHeapAlignment);
+    allocator->dedicatedThreshold = createInfo.dedicatedThreshold != 0
+                                        ? createInfo.dedicatedThreshold
+                                        : allocator->heapSize / 4;
+    if (allocator->dedicatedThreshold > allocator->heapSize)
+    {
+        allocator->dedicatedThreshold = allocator->heapSize;
+    }
+    return allocator;
+}
+
+void GaDestroyMemoryAllocator(gaMemoryAllocator* allocator)
+{
+    if (allocator == nullptr)
+    {
+        return;
+    }
+
+    // Heaps go with it, along with anything still placed in them
+    delete static_cast<MemoryAllocator*>(allocator);
+}
+
+Result<gaMemoryAllocation*> GaAllocateMemory(gaMemoryAllocator* baseAllocator,
+                                             gaMemoryType type,
+                                             uint64 size,
+                                             uint64 alignment)
+{
+    if (baseAllocator == nullptr)
+    {
+        return "Memory allocator cannot be null";
+    }
+
+    if (static_cast<uint32>(type) >= kMemoryTypes)
+    {
+        return "Unknown memory type";
+    }
+
+    if (size == 0 || !IsPowerOfTwo(alignment))
+    {
+        return "Allocation size must be greater than zero, and alignment a power of two";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    auto allocator = static_cast<MemoryAllocator*>(baseAllocator);
+    if (size > allocator->dedicatedThreshold || alignment > kHeapAlignment)
+    {
+        return AllocateDedicated(allocator, type, size, alignment);
+    }
+
+    auto allocation = rsbl::UniquePtr(new MemoryAllocation());
+    allocation->size = size;
+    allocation->alignment = alignment;
+
+    // First fit over the heaps, each one's own fit is O(1)
+    DynamicArray<UniquePtr<SharedHeap>>& heaps = allocator->heaps[static_cast<uint32>(type)];
+    for (UniquePtr<SharedHeap>& heap : heaps)
+    {
+        if (heap->evacuating)
+        {
+            continue;
+        }
+        const RangeAllocator::Range range = heap->ranges.Allocate(size, alignment);
+        if (range.id != RangeAllocator::kInvalidRange)
+        {
+            Place(*heap, allocation.Get(), range);
+            return allocation.Release();
+        }
+    }
+
+    auto created = CreateHeap(allocator->device, type, allocator->heapSize, kHeapAlignment);
+    if (!created)
+    {
+        return PendingFailure{created.Category()};
+    }
+    auto heap = rsbl::UniquePtr(new SharedHeap());
+    heap->heap.Reset(created.Value());
+    heap->ranges.Reset(allocator->heapSize);
+
+    // Below the threshold and the heap alignment, so it fits in an empty heap
+    Place(*heap, allocation.Get(), heap->ranges.Allocate(size, alignment));
+    heaps.PushBack(rsblMove(heap));
+    return allocation.Release();
+}
+
+void GaFreeMemory(gaMemoryAllocator* baseAllocator, gaMemoryAllocation* baseAllocation)
+{
+    if (baseAllocator == nullptr || baseAllocation == nullptr)
+    {
+        return;
+    }
+
+    auto allocator = static_cast<MemoryAllocator*>(baseAllocator);
+    auto allocation = static_cast<MemoryAllocation*>(baseAllocation);
+    const gaMemoryType type = allocation->heap->type;
+
+    if (allocation->owner == nullptr)
+    {
+        const uint32 typeIndex = static_cast<uint32>(type);
+        --allocator->dedicatedAllocations[typeIndex];
+        allocator->dedicatedBytes[typeIndex] -= allocation->heap->size;
+        delete allocation;
+        return;
+    }
+
+    SharedHeap* heap = allocation->owner;
+    heap->ranges.Free(allocation->range);
+    Unlist(allocation);
+    delete allocation;
+    ReleaseIfEmpty(allocator, type, heap);
+}
+
+gaMemoryStats GaGetMemoryStats(gaMemoryAllocator* baseAllocator, gaMemoryType type)
+{
+    gaMemoryStats stats;
+    if (baseAllocator == nullptr || static_cast<uint32>(type) >= kMemoryTypes)
+    {
+        return stats;
+    }
+
+    auto allocator = static_cast<MemoryAllocator*>(baseAllocator);
+    const uint32 typeIndex = static_cast<uint32>(type);
+    for (const UniquePtr<SharedHeap>& heap : allocator->heaps[typeIndex])
+    {
+        ++stats.heaps;
+        stats.allocations += static_cast<uint32>(heap->allocations.Size());
+        stats.heapBytes += heap->ranges.Size();
+        // Ranges moved out of by a defragmentation pass count until it ends
+        stats.allocatedBytes += heap->ranges.Size() - heap->ranges.FreeBytes();
+        const uint64 largest = heap->ranges.LargestFreeRange();
+        if (largest > stats.largestFreeRange)
+        {
+            stats.largestFreeRange = largest;
+        }
+    }
+    stats.allocations += allocator->dedicatedAllocations[typeIndex];
+    stats.dedicatedAllocations = allocator->dedicatedAllocations[typeIndex];
+    stats.heapBytes += allocator->dedicatedBytes[typeIndex];
+    stats.allocatedBytes += allocator->dedicatedBytes[typeIndex];
+    return stats;
+}
+
+Result<gaMemoryBudget> GaQueryMemoryBudget(gaDevice* device)
+{
+    if (device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        // No memory behind it
+        return gaMemoryBudget{};
+
+    case gaBackend::DX12:
+        return backend::QueryDX12MemoryBudget(device);
+
+    case gaBackend::Vulkan:
+        return backend::QueryVulkanMemoryBudget(device);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaLinearPool*> GaCreateLinearPool(const gaLinearPoolCreateInfo& createInfo)
+{
+    if (createInfo.allocator == nullptr)
+    {
+        return "Memory allocator cannot be null";
+    }
+
+    if (static_cast<uint32>(createInfo.type) >= kMemoryTypes || createInfo.size == 0)
+    {
+        return "Linear pool needs a memory type and a size greater than zero";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    // A heap of its own, so defragmentation never moves it
+    auto memory = AllocateDedicated(static_cast<MemoryAllocator*>(createInfo.allocator),
+                                    createInfo.type,
+                                    createInfo.size,
+                                    kHeapAlignment);
+    if (!memory)
+    {
+        return PendingFailure{memory.Category()};
+    }
+
+    gaLinearPool* pool = new gaLinearPool();
+    pool->allocator = createInfo.allocator;
+    pool->memory = memory.Value();
+    pool->used = 0;
+    return pool;
+}
+
+void GaDestroyLinearPool(gaLinearPool* pool)
+{
+    if (pool == nullptr)
+    {
+        return;
+    }
+
+    GaFreeMemory(pool->allocator, pool->memory);
+    delete pool;
+}
+
+Result<gaMemoryAllocation> GaAllocateLinear(gaLinearPool* pool, uint64 size, uint64 alignment)
+{
+    if (pool == nullptr)
+    {
+        return "Linear pool cannot be null";
+    }
+
+    if (size == 0 || !IsPowerOfTwo(alignment))
+    {
+        return "Allocation size must be greater than zero, and alignment a power of two";
+    }
+
+    const uint64 offset = AlignUp(pool->used, alignment);
+    if (offset < pool->used || offset > pool->memory->size ||
+        size > pool->memory->size - offset)
+    {
+        return {ErrorCategory::OutOfMemory, "Linear pool is full"};
+    }
+
+    pool->used = offset + size;
+    return gaMemoryAllocation{pool->memory->heap, offset, size};
+}
+
+void GaResetLinearPool(gaLinearPool* pool)
+{
+    if (pool != nullptr)
+    {
+        pool->used = 0;
+    }
+}
+
+Result<ArrayView<const gaDefragmentMove>> GaBeginDefragmentation(
+    gaMemoryAllocator* baseAllocator,
+    uint64 maxBytes)
+{
+    if (baseAllocator == nullptr)
+    {
+        return "Memory allocator cannot be null";
+    }
+
+    auto allocator = static_cast<MemoryAllocator*>(baseAllocator);
+    if (allocator->defragmenting)
+    {
+        return "A defragmentation pass is already begun";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    allocator->defragmenting = true;
+    uint64 budget = maxBytes;
+    for (DynamicArray<UniquePtr<SharedHeap>>& heaps : allocator->heaps)
+    {
+        if (heaps.Size() < 2 || budget == 0)
+        {
+            continue;
+        }
+
+        // Empty the least used heap into the others, once it's empty it's released
+        SharedHeap* source = nullptr;
+        for (UniquePtr<SharedHeap>& heap : heaps)
+        {
+            if (source == nullptr || heap->ranges.FreeBytes() > source->ranges.FreeBytes())
+            {
+                source = heap.Get();
+            }
+        }
+        source->evacuating = true;
+
+        // Walking down the list, so taking one off only moves one already looked at into place
+        for (uint64 i = source->allocations.Size(); i-- > 0 && budget > 0;)
+        {
+            MemoryAllocation* allocation = source->allocations[i];
+            if (allocation->size > budget)
+            {
+                continue;
+            }
+
+            for (UniquePtr<SharedHeap>& heap : heaps)
+            {
+                if (heap.Get() == source)
+                {
+                    continue;
+                }
+                const RangeAllocator::Range range =
+                    heap->ranges.Allocate(allocation->size, allocation->alignment);
+                if (range.id == RangeAllocator::kInvalidRange)
+                {
+                    continue;
+                }
+
+                allocator->moves.PushBack({allocation, allocation->heap, allocation->offset});
+                allocator->pendingFrees.PushBack({source, allocation->range});
+                Unlist(allocation);
+                Place(*heap, allocation, range);
+                budget -= allocation->size;
+                break;
+            }
+        }
+    }
+    return ArrayView<const gaDefragmentMove>(allocator->moves);
+}
+
+void GaEndDefragmentation(gaMemoryAllocator* baseAllocator)
+{
+    auto allocator = static_cast<MemoryAllocator*>(baseAllocator);
+    if (allocator == nullptr || !allocator->defragmenting)
+    {
+        return;
+    }
+
+    for (const PendingFree& pending : allocator->pendingFrees)
+    {
+        pending.heap->ranges.Free(pending.range);
+    }
+    allocator->pendingFrees.Clear();
+    allocator->moves.Clear();
+    allocator->defragmenting = false;
+
+    for (uint32 type = 0; type < kMemoryTypes; ++type)
+    {
+        DynamicArray<UniquePtr<SharedHeap>>& heaps = allocator->heaps[type];
+        for (uint64 i = 0; i < heaps.Size(); ++i)
+        {
+            if (heaps[i]->evacuating)
+            {
+                heaps[i]->evacuating = false;
+                ReleaseIfEmpty(allocator, static_cast<gaMemoryType>(type), heaps[i].Get());
+                break;
+            }
+        }
+    }
+}
+
+} // namespace rsbl
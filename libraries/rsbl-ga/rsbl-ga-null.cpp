@@ -3,13 +3,69 @@
 
 #include "rsbl-ga-backends.h"
 
+#include <rsbl-clock.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+#include <atomic>
+#include <cstring>
+
 namespace rsbl
 {
 namespace backend
 {
 
+struct NullCommandList : public gaCommandList
+{
+	gaNullMode mode = gaNullMode::Count;
+	gaNullStats counts = {}; // Added to the device's when submitted
+	DynamicArray<gaNullCommand> commands;
+
+	NullCommandList()
+	{
+		backend = gaBackend::Null;
+		internalHandle = nullptr;
+	}
+};
+
+// gaNullStats, added to by whichever threads submit
+struct NullStats
+{
+	std::atomic<uint64> submits{0};
+	std::atomic<uint64> commandLists{0};
+	std::atomic<uint64> commands{0};
+	std::atomic<uint64> barriers{0};
+	std::atomic<uint64> draws{0};
+	std::atomic<uint64> meshGroups{0};
+	std::atomic<uint64> copies{0};
+	std::atomic<uint64> copyBytes{0};
+	std::atomic<uint64> uploads{0};
+	std::atomic<uint64> uploadBytes{0};
+	std::atomic<uint64> readbacks{0};
+	std::atomic<uint64> readbackBytes{0};
+	std::atomic<uint64> timestamps{0};
+};
+
+// Lists are pooled per recorder per frame like on the real backends, so a list handed out is
+// never reused before its frame comes back round
+struct NullCommandRecorder
+{
+	DynamicArray<UniquePtr<NullCommandList>> lists;
+	uint32 used = 0;
+};
+
+struct NullFrame
+{
+	DynamicArray<NullCommandRecorder> recorders[kQueueTypes];
+};
+
 struct NullDevice : public gaDevice
 {
+	DynamicArray<NullFrame> frames;
+	gaNullMode mode = gaNullMode::Count;
+	NullStats stats;
+
 	NullDevice()
 	{
 		backend = gaBackend::Null;
@@ -24,10 +80,16 @@ struct NullDevice : public gaDevice
 
 struct NullSwapchain : public gaSwapchain
 {
+	uint32 bufferCount = 0;
+	uint64 lastPresentTicks = 0; // Shown as soon as it's presented
+
 	NullSwapchain()
 	{
 		backend = gaBackend::Null;
 		internalHandle = nullptr;
+		presentMode = gaPresentMode::Vsync;
+		currentBuffer = 0;
+		backBuffer = nullptr;
 	}
 
 	~NullSwapchain() override
@@ -36,10 +98,182 @@ struct NullSwapchain : public gaSwapchain
 	}
 };
 
+// Nothing runs on the null backend, so a fence has reached every value as soon as it's signalled
+struct NullFence : public gaFence
+{
+	NullFence()
+	{
+		backend = gaBackend::Null;
+		internalHandle = nullptr;
+		signalledValue = 0;
+	}
+};
+
+// Both sides' resources are the buffer itself, nothing reads them
+struct NullSharedBuffer : public gaSharedBuffer
+{
+	NullFence sharedFence;
+	NullFence peerSharedFence;
+
+	NullSharedBuffer()
+	{
+		backend = gaBackend::Null;
+		resource = this;
+		peerResource = this;
+		fence = &sharedFence;
+		peerFence = &peerSharedFence;
+	}
+};
+
+// Heaps have no memory behind them, allocations are only bookkeeping
+struct NullMemoryHeap : public gaMemoryHeap
+{
+	NullMemoryHeap()
+	{
+		backend = gaBackend::Null;
+		internalHandle = nullptr;
+	}
+};
+
+// No memory either, only the tiling
+struct NullReservedResource : public gaReservedResource
+{
+	NullReservedResource()
+	{
+		backend = gaBackend::Null;
+		internalHandle = nullptr;
+	}
+};
+
+// Plain memory, so writes to the ring land somewhere
+struct NullUploadBuffer : public UploadBuffer
+{
+	DynamicArray<uint8> bytes;
+};
+
+// Zeroed, which is what every readback reads
+struct NullReadbackBuffer : public ReadbackBuffer
+{
+	DynamicArray<uint8> bytes;
+};
+
+// Plain memory, so handles are distinct and point somewhere
+struct NullDescriptorPage : public DescriptorPage
+{
+	DynamicArray<uint8> bytes;
+};
+
+struct NullBindlessTable : public BindlessTable
+{
+};
+
+struct NullTimestampHeap : public TimestampHeap
+{
+};
+
+struct NullBreadcrumbs : public Breadcrumbs
+{
+	DynamicArray<uint32> storage;
+};
+
+struct NullPipelineLibrary : public PipelineLibrary
+{
+};
+
+struct NullPipelineLayout : public PipelineLayout
+{
+};
+
+struct NullPipeline : public gaPipeline
+{
+	NullPipeline()
+	{
+		backend = gaBackend::Null;
+		internalHandle = nullptr;
+	}
+};
+
+struct NullSkinningPass : public gaSkinningPass
+{
+	NullSkinningPass()
+	{
+		backend = gaBackend::Null;
+		internalHandle = nullptr;
+	}
+};
+
+struct NullCommandBundle : public CommandBundle
+{
+	NullCommandList bundleList;
+
+	NullCommandBundle()
+	{
+		backend = gaBackend::Null;
+		internalHandle = nullptr;
+		list = &bundleList;
+	}
+};
+
+struct NullCullingPass : public gaCullingPass
+{
+	NullCullingPass()
+	{
+		backend = gaBackend::Null;
+		arguments = nullptr;
+		count = nullptr;
+	}
+};
+
+struct NullLightBinningPass : public gaLightBinningPass
+{
+	NullLightBinningPass()
+	{
+		backend = gaBackend::Null;
+		lights = nullptr;
+		clusters = nullptr;
+	}
+};
+
+struct NullUpscaler : public gaUpscaler
+{
+	NullUpscaler()
+	{
+		backend = gaBackend::Null;
+	}
+};
+
+struct NullMipGenerationPass : public gaMipGenerationPass
+{
+	NullMipGenerationPass()
+	{
+		backend = gaBackend::Null;
+	}
+};
+
 Result<gaDevice*> CreateNullDevice(const gaDeviceCreateInfo& createInfo)
 {
 	// Null backend always succeeds and validates API usage
 	NullDevice* device = new NullDevice();
+	device->bindless = true;
+	device->drawIndirectCount = true;
+	device->meshShaders = true;
+	device->reservedResources = true;
+	device->variableRateShading = true;
+	device->largeShadingRates = true;
+	device->shadingRateTileSize = 16;
+	memcpy(device->adapterInfo.name, "Null", sizeof("Null"));
+	device->adapterInfo.bindless = true;
+	device->commandRecorders = createInfo.commandRecorders;
+	device->framesInFlight = createInfo.framesInFlight;
+	device->mode = createInfo.nullMode;
+	device->frames.Resize(createInfo.framesInFlight);
+	for (NullFrame& frame : device->frames)
+	{
+		for (DynamicArray<NullCommandRecorder>& recorders : frame.recorders)
+		{
+			recorders.Resize(createInfo.commandRecorders);
+		}
+	}
 	return device;
 }
 
@@ -61,15 +295,471 @@ Result<gaSwapchain*> CreateNullSwapchain(const gaSwapchainCreateInfo& createInfo
 		return "Swapchain buffer count must be between 2 and 4";
 	}
 
-	if (createInfo.appHandle == nullptr && createInfo.windowHandle == nullptr)
+	if (!createInfo.offscreen && createInfo.appHandle == nullptr &&
+	    createInfo.windowHandle == nullptr)
 	{
 		return "At least one of appHandle or windowHandle must be non-null";
 	}
 
-	// Null backend always succeeds and validates API usage
+	// Null backend always succeeds and validates API usage, every present mode is there
 	NullSwapchain* swapchain = new NullSwapchain();
+	swapchain->bufferCount = createInfo.bufferCount;
+	swapchain->presentMode = createInfo.presentMode;
+	swapchain->width = createInfo.width;
+	swapchain->height = createInfo.height;
+	swapchain->format = gaFormat::R8G8B8A8Unorm;
+	if (createInfo.offscreen)
+	{
+		swapchain->presentMode = gaPresentMode::Immediate;
+		swapchain->offscreen = true;
+	}
 	return swapchain;
 }
 
+Result<> PresentNull(gaSwapchain* baseSwapchain)
+{
+	auto swapchain = static_cast<NullSwapchain*>(baseSwapchain);
+	swapchain->currentBuffer = (swapchain->currentBuffer + 1) % swapchain->bufferCount;
+	swapchain->lastPresentTicks = Clock::NowTicks();
+	return ResultCode::Success;
+}
+
+Result<> GetNullPresentStats(gaSwapchain* baseSwapchain, gaPresentStats& presentStats)
+{
+	auto swapchain = static_cast<NullSwapchain*>(baseSwapchain);
+	presentStats.displayedPresent = swapchain->presentCount;
+	presentStats.displayedTicks = swapchain->lastPresentTicks;
+	presentStats.exact = true;
+	return ResultCode::Success;
+}
+
+Result<> BeginNullFrame(gaDevice* baseDevice)
+{
+	auto device = static_cast<NullDevice*>(baseDevice);
+	for (DynamicArray<NullCommandRecorder>& recorders :
+	     device->frames[device->frame % device->frames.Size()].recorders)
+	{
+		for (NullCommandRecorder& recorder : recorders)
+		{
+			if (recorder.used > 0 && recorder.lists[recorder.used - 1]->recording)
+			{
+				return "A command list from framesInFlight frames back is still recording";
+			}
+			recorder.used = 0;
+		}
+	}
+	return ResultCode::Success;
+}
+
+Result<gaCommandList*> BeginNullCommandList(gaDevice* baseDevice,
+                                            gaQueueType queue,
+                                            uint32 recorderIndex)
+{
+	auto device = static_cast<NullDevice*>(baseDevice);
+	NullFrame& frame = device->frames[device->frame % device->frames.Size()];
+	NullCommandRecorder& recorder = frame.recorders[static_cast<uint32>(queue)][recorderIndex];
+	if (recorder.used > 0 && recorder.lists[recorder.used - 1]->recording)
+	{
+		return "The recorder is already recording a command list";
+	}
+
+	if (recorder.used == recorder.lists.Size())
+	{
+		recorder.lists.PushBack(UniquePtr(new NullCommandList()));
+	}
+
+	// Recycled lists keep their commands' memory
+	NullCommandList* list = recorder.lists[recorder.used++].Get();
+	list->mode = device->mode;
+	list->counts = {};
+	list->commands.Clear();
+	return list;
+}
+
+// Everything but submits and lists, which are counted as they're submitted
+void AddCounts(gaNullStats& counts, const gaNullStats& added)
+{
+	counts.commands += added.commands;
+	counts.barriers += added.barriers;
+	counts.draws += added.draws;
+	counts.meshGroups += added.meshGroups;
+	counts.copies += added.copies;
+	counts.copyBytes += added.copyBytes;
+	counts.uploads += added.uploads;
+	counts.uploadBytes += added.uploadBytes;
+	counts.readbacks += added.readbacks;
+	counts.readbackBytes += added.readbackBytes;
+	counts.timestamps += added.timestamps;
+}
+
+void RecordNullCommand(gaCommandList* baseList, const gaNullCommand& command)
+{
+	auto list = static_cast<NullCommandList*>(baseList);
+	if (list->mode == gaNullMode::Discard)
+	{
+		return;
+	}
+
+	gaNullStats& counts = list->counts;
+	++counts.commands;
+	switch (command.type)
+	{
+	case gaNullCommandType::Barriers:
+		counts.barriers += command.count;
+		break;
+
+	case gaNullCommandType::CopyBuffer:
+		++counts.copies;
+		counts.copyBytes += command.bytes;
+		break;
+
+	case gaNullCommandType::Upload:
+		++counts.uploads;
+		counts.uploadBytes += command.bytes;
+		break;
+
+	case gaNullCommandType::Readback:
+		++counts.readbacks;
+		counts.readbackBytes += command.bytes;
+		break;
+
+	case gaNullCommandType::DrawIndexedIndirect:
+		counts.draws += command.count;
+		break;
+
+	case gaNullCommandType::DispatchMesh:
+		counts.meshGroups += command.count;
+		break;
+
+	case gaNullCommandType::WriteTimestamp:
+		counts.timestamps += command.count;
+		break;
+
+	default:
+		break;
+	}
+
+	if (list->mode == gaNullMode::Record)
+	{
+		MemoryTagScope memoryScope(MemoryTag::Ga);
+		list->commands.PushBack(command);
+	}
+}
+
+void SubmitNull(gaDevice* baseDevice, ArrayView<gaCommandList* const> lists)
+{
+	auto device = static_cast<NullDevice*>(baseDevice);
+	if (device->mode == gaNullMode::Discard)
+	{
+		return;
+	}
+
+	// Summed first, so a submit is one add per stat however many lists it has
+	gaNullStats counts = {};
+	for (const gaCommandList* list : lists)
+	{
+		AddCounts(counts, static_cast<const NullCommandList*>(list)->counts);
+	}
+
+	NullStats& stats = device->stats;
+	stats.submits.fetch_add(1, std::memory_order_relaxed);
+	stats.commandLists.fetch_add(lists.Size(), std::memory_order_relaxed);
+	stats.commands.fetch_add(counts.commands, std::memory_order_relaxed);
+	stats.barriers.fetch_add(counts.barriers, std::memory_order_relaxed);
+	stats.draws.fetch_add(counts.draws, std::memory_order_relaxed);
+	stats.meshGroups.fetch_add(counts.meshGroups, std::memory_order_relaxed);
+	stats.copies.fetch_add(counts.copies, std::memory_order_relaxed);
+	stats.copyBytes.fetch_add(counts.copyBytes, std::memory_order_relaxed);
+	stats.uploads.fetch_add(counts.uploads, std::memory_order_relaxed);
+	stats.uploadBytes.fetch_add(counts.uploadBytes, std::memory_order_relaxed);
+	stats.readbacks.fetch_add(counts.readbacks, std::memory_order_relaxed);
+	stats.readbackBytes.fetch_add(counts.readbackBytes, std::memory_order_relaxed);
+	stats.timestamps.fetch_add(counts.timestamps, std::memory_order_relaxed);
+}
+
+Result<CommandBundle*> CreateNullCommandBundle(const gaCommandBundleCreateInfo& createInfo)
+{
+	return new NullCommandBundle();
+}
+
+void BeginNullCommandBundle(CommandBundle* baseBundle)
+{
+	NullCommandList& list = static_cast<NullCommandBundle*>(baseBundle)->bundleList;
+	list.mode = static_cast<NullDevice*>(baseBundle->device)->mode;
+	list.counts = {};
+	list.commands.Clear();
+}
+
+void ExecuteNullBundle(gaCommandList* baseList, CommandBundle* bundle)
+{
+	auto list = static_cast<NullCommandList*>(baseList);
+	const gaNullStats& replayed = static_cast<NullCommandBundle*>(bundle)->bundleList.counts;
+	RecordNullCommand(list,
+	                  {gaNullCommandType::ExecuteBundle,
+	                   static_cast<uint32>(replayed.commands),
+	                   0,
+	                   bundle});
+
+	// The GPU would run the bundle's commands again for every replay
+	if (list->mode != gaNullMode::Discard)
+	{
+		AddCounts(list->counts, replayed);
+	}
+}
+
+Result<gaFence*> CreateNullFence(gaDevice* device, uint64 initialValue)
+{
+	NullFence* fence = new NullFence();
+	fence->signalledValue = initialValue;
+	return fence;
+}
+
+Result<gaSharedBuffer*> CreateNullSharedBuffer(const gaSharedBufferCreateInfo& createInfo)
+{
+	NullSharedBuffer* buffer = new NullSharedBuffer();
+	buffer->device = createInfo.device;
+	buffer->peer = createInfo.peer;
+	buffer->size = createInfo.size;
+	return buffer;
+}
+
+Result<TimestampHeap*> CreateNullTimestampHeap(gaDevice* device, gaQueueType queue, uint32 count)
+{
+	// Nothing runs, so every timestamp reads back as 0, in nanoseconds
+	NullTimestampHeap* heap = new NullTimestampHeap();
+	heap->frequency = 1'000'000'000;
+	return heap;
+}
+
+Result<Breadcrumbs*> CreateNullBreadcrumbs(gaDevice* device, uint32 slots)
+{
+	NullBreadcrumbs* breadcrumbs = new NullBreadcrumbs();
+	breadcrumbs->storage.Resize(slots);
+	breadcrumbs->markers = breadcrumbs->storage.Data();
+	breadcrumbs->internalHandle = breadcrumbs->storage.Data();
+	return breadcrumbs;
+}
+
+Result<gaMemoryHeap*> CreateNullMemoryHeap(gaDevice* device,
+                                           gaMemoryType type,
+                                           uint64 size,
+                                           uint64 alignment)
+{
+	return new NullMemoryHeap();
+}
+
+// Tiled like DX12 packs mips: a mip smaller than a tile either way goes in the mip tail, which
+// takes one tile
+Result<gaReservedResource*> CreateNullReservedResource(
+    const gaReservedResourceCreateInfo& createInfo)
+{
+	NullReservedResource* resource = new NullReservedResource();
+	if (createInfo.size != 0)
+	{
+		return resource;
+	}
+
+	(void)StandardTileShape(createInfo.format, resource->tileWidth, resource->tileHeight);
+	resource->standardMips = 0;
+	resource->tileCount = 0;
+	for (uint32 mip = 0; mip < createInfo.mips; ++mip)
+	{
+		const uint32 width = createInfo.width >> mip;
+		const uint32 height = createInfo.height >> mip;
+		if (width < resource->tileWidth || height < resource->tileHeight)
+		{
+			break;
+		}
+		++resource->standardMips;
+		resource->tileCount += ((width + resource->tileWidth - 1) / resource->tileWidth) *
+		                       ((height + resource->tileHeight - 1) / resource->tileHeight);
+	}
+	resource->mipTailTiles = resource->standardMips < createInfo.mips ? 1 : 0;
+	resource->tileCount += resource->mipTailTiles;
+	return resource;
+}
+
+Result<UploadBuffer*> CreateNullUploadBuffer(gaDevice* device, uint64 size)
+{
+	NullUploadBuffer* buffer = new NullUploadBuffer();
+	buffer->bytes.ResizeUninitialized(size);
+	buffer->data = buffer->bytes.Data();
+	return buffer;
+}
+
+Result<ReadbackBuffer*> CreateNullReadbackBuffer(gaDevice* device, uint64 size)
+{
+	NullReadbackBuffer* buffer = new NullReadbackBuffer();
+	buffer->bytes.Resize(size);
+	buffer->data = buffer->bytes.Data();
+	return buffer;
+}
+
+Result<DescriptorPage*> CreateNullDescriptorPage(gaDevice* device,
+                                                 gaDescriptorType type,
+                                                 uint32 count)
+{
+	// A typical descriptor size
+	NullDescriptorPage* page = new NullDescriptorPage();
+	page->increment = 32;
+	page->bytes.ResizeUninitialized(uint64(count) * page->increment);
+	page->start = reinterpret_cast<uint64>(page->bytes.Data());
+	return page;
+}
+
+Result<BindlessTable*> CreateNullBindlessTable(gaDevice* device,
+                                               uint32 capacity,
+                                               ArrayView<const gaSamplerDesc> samplers)
+{
+	// Indices are still handed out and recycled, there's just nothing to write them to
+	return new NullBindlessTable();
+}
+
+Result<PipelineLibrary*> CreateNullPipelineLibrary(gaDevice* device, ArrayView<const uint8> data)
+{
+	// Nothing compiled to keep, the cache's own records are still saved and loaded
+	return new NullPipelineLibrary();
+}
+
+Result<PipelineLayout*> CreateNullPipelineLayout(gaDevice* device,
+                                                 const gaBindlessHeap* bindless,
+                                                 bool compute,
+                                                 uint32 pushConstantBytes)
+{
+	return new NullPipelineLayout();
+}
+
+Result<gaPipeline*> CreateNullGraphicsPipeline(gaDevice* device,
+                                               PipelineLibrary* library,
+                                               PipelineLayout* layout,
+                                               uint64 key,
+                                               const gaGraphicsPipelineDesc& desc)
+{
+	return new NullPipeline();
+}
+
+Result<gaPipeline*> CreateNullComputePipeline(gaDevice* device,
+                                              PipelineLibrary* library,
+                                              PipelineLayout* layout,
+                                              uint64 key,
+                                              const gaComputePipelineDesc& desc)
+{
+	return new NullPipeline();
+}
+
+Result<gaSkinningPass*> CreateNullSkinningPass(const gaSkinningPassCreateInfo& createInfo)
+{
+	// Null backend keeps the sizes so uploads and dispatches are checked, and skins nothing
+	NullSkinningPass* pass = new NullSkinningPass();
+	pass->vertexCount = createInfo.vertexCount;
+	pass->jointCount = createInfo.jointCount;
+	pass->instanceCount = createInfo.instanceCount;
+	return pass;
+}
+
+Result<gaCullingPass*> CreateNullCullingPass(const gaCullingPassCreateInfo& createInfo)
+{
+	// Null backend keeps the sizes so uploads are checked, and culls nothing
+	NullCullingPass* pass = new NullCullingPass();
+	pass->instanceCount = createInfo.instanceCount;
+	pass->depthWidth = createInfo.depthWidth;
+	pass->depthHeight = createInfo.depthHeight;
+	return pass;
+}
+
+Result<gaLightBinningPass*> CreateNullLightBinningPass(
+	const gaLightBinningPassCreateInfo& createInfo)
+{
+	// Null backend keeps the sizes so dispatches are checked and the grid is set, and bins nothing
+	NullLightBinningPass* pass = new NullLightBinningPass();
+	pass->maxLights = createInfo.maxLights;
+	pass->grid = {};
+	pass->grid.clusterCountX = createInfo.clusterCountX;
+	pass->grid.clusterCountY = createInfo.clusterCountY;
+	pass->grid.clusterCountZ = createInfo.clusterCountZ;
+	pass->grid.maxLightsPerCluster = createInfo.maxLightsPerCluster;
+	return pass;
+}
+
+Result<gaUpscaler*> CreateNullUpscaler(const gaUpscalerCreateInfo& createInfo)
+{
+	// Null backend keeps no history, GaCreateUpscaler sets the sizes dispatches are checked by
+	return new NullUpscaler();
+}
+
+Result<gaMipGenerationPass*> CreateNullMipGenerationPass(
+	const gaMipGenerationPassCreateInfo& createInfo)
+{
+	// Null backend keeps the sizes so the textures given are checked against them
+	NullMipGenerationPass* pass = new NullMipGenerationPass();
+	pass->maxWidth = createInfo.maxWidth;
+	pass->maxHeight = createInfo.maxHeight;
+	return pass;
+}
+
 } // namespace backend
+
+Result<gaNullStats> GaGetNullStats(gaDevice* baseDevice)
+{
+	if (baseDevice == nullptr)
+	{
+		return "Device cannot be null";
+	}
+
+	if (baseDevice->backend != gaBackend::Null)
+	{
+		return {ErrorCategory::InvalidArgument, "Only Null devices keep stats"};
+	}
+
+	const backend::NullStats& stats = static_cast<backend::NullDevice*>(baseDevice)->stats;
+	gaNullStats counts;
+	counts.submits = stats.submits.load(std::memory_order_relaxed);
+	counts.commandLists = stats.commandLists.load(std::memory_order_relaxed);
+	counts.commands = stats.commands.load(std::memory_order_relaxed);
+	counts.barriers = stats.barriers.load(std::memory_order_relaxed);
+	counts.draws = stats.draws.load(std::memory_order_relaxed);
+	counts.meshGroups = stats.meshGroups.load(std::memory_order_relaxed);
+	counts.copies = stats.copies.load(std::memory_order_relaxed);
+	counts.copyBytes = stats.copyBytes.load(std::memory_order_relaxed);
+	counts.uploads = stats.uploads.load(std::memory_order_relaxed);
+	counts.uploadBytes = stats.uploadBytes.load(std::memory_order_relaxed);
+	counts.readbacks = stats.readbacks.load(std::memory_order_relaxed);
+	counts.readbackBytes = stats.readbackBytes.load(std::memory_order_relaxed);
+	counts.timestamps = stats.timestamps.load(std::memory_order_relaxed);
+	return counts;
+}
+
+void GaResetNullStats(gaDevice* baseDevice)
+{
+	if (baseDevice == nullptr || baseDevice->backend != gaBackend::Null)
+	{
+		return;
+	}
+
+	backend::NullStats& stats = static_cast<backend::NullDevice*>(baseDevice)->stats;
+	for (std::atomic<uint64>* stat :
+	     {&stats.submits, &stats.commandLists, &stats.commands, &stats.barriers, &stats.draws,
+	      &stats.meshGroups, &stats.copies, &stats.copyBytes, &stats.uploads, &stats.uploadBytes,
+	      &stats.readbacks, &stats.readbackBytes, &stats.timestamps})
+	{
+		stat->store(0, std::memory_order_relaxed);
+	}
+}
+
+Result<ArrayView<const gaNullCommand>> GaGetNullCommands(const gaCommandList* list)
+{
+	if (list == nullptr)
+	{
+		return "Command list cannot be null";
+	}
+
+	if (list->backend != gaBackend::Null)
+	{
+		return {ErrorCategory::InvalidArgument, "Only Null command lists keep their commands"};
+	}
+
+	return ArrayView<const gaNullCommand>(
+	    static_cast<const backend::NullCommandList*>(list)->commands);
+}
+
 } // namespace rsbl
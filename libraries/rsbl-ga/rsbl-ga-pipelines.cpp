@@ -0,0 +1,1133 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-hash-map.h>
+#include <rsbl-hash.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-os-trace.h>
+#include <rsbl-ptr.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kCacheMagic = 0x4f535052; // "RPSO"
+// Bump whenever PipelineRecord or how it's filled in changes, it seeds the keys too
+constexpr uint32 kCacheVersion = 2;
+
+// A record's shaders: vertex or compute, pixel, amplification, mesh
+constexpr uint32 kRecordShaders = 4;
+
+// Everything a pipeline is made from, flattened so that its bytes are both its key and what's
+// saved. Only 4 and 8 byte fields, in an order that leaves no padding to hash.
+struct PipelineRecord
+{
+    uint64 shaders[kRecordShaders]; // Content hashes, 0 for none
+    uint32 compute;
+    uint32 pushConstantBytes;
+    uint32 attributeCount;
+    uint32 attributes[kGaMaxVertexAttributes][4]; // location, format, buffer, offset
+    uint32 vertexBufferCount;
+    uint32 vertexBuffers[kGaMaxVertexBuffers][2]; // stride, perInstance
+    uint32 renderTargetCount;
+    uint32 renderTargetFormats[kGaMaxRenderTargets];
+    uint32 blendModes[kGaMaxRenderTargets];
+    uint32 depthFormat;
+    uint32 topology;
+    uint32 cull;
+    uint32 frontCounterClockwise;
+    uint32 wireframe;
+    uint32 depthClip;
+    int32 depthBias;
+    float slopeScaledDepthBias;
+    uint32 depthTest;
+    uint32 depthWrite;
+    uint32 depthCompare;
+};
+static_assert(sizeof(PipelineRecord) % sizeof(uint64) == 0, "PipelineRecord has tail padding");
+
+// Serialized data: the header, each shader (its header and bytes, padded to 8), the records, then
+// the backend's library data
+struct CacheHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint32 backend;
+    uint32 shaderCount;
+    uint32 recordCount;
+    uint32 reserved;
+    uint64 libraryBytes;
+};
+
+struct ShaderHeader
+{
+    uint64 hash;
+    uint64 size;
+};
+
+// A pipeline compiling on a worker. The worker only reads this and what of the cache never
+// changes, the description is rebuilt from the record and shaders copied for it.
+struct PendingCompile
+{
+    PipelineRecord record;
+    uint64 key = 0;
+    backend::PipelineLayout* layout = nullptr;
+    DynamicArray<uint8> shaders[kRecordShaders];
+
+    // Written by the worker before done
+    gaPipeline* pipeline = nullptr;
+    bool failed = false;
+    ErrorCategory failure = ErrorCategory::Generic;
+    std::atomic<bool> done{false};
+};
+
+struct PipelineCache : public gaPipelineCache
+{
+    gaBindlessHeap* bindless = nullptr;
+    UniquePtr<backend::PipelineLibrary> library;
+    HashMap<uint64, UniquePtr<backend::PipelineLayout>> layouts;
+    HashMap<uint64, UniquePtr<gaPipeline>> pipelineMap;
+
+    // Shaders by content hash, and every pipeline asked for or loaded, for the next run
+    HashMap<uint64, DynamicArray<uint8>> shaders;
+    DynamicArray<PipelineRecord> records;
+    HashMap<uint64, uint32> recorded; // Key to index in records
+
+    // Loaded records from nextPrecompile up to loadedRecords are still to precompile
+    uint32 loadedRecords = 0;
+    uint32 nextPrecompile = 0;
+
+    gaPipelineScheduler scheduler;
+    HashMap<uint64, UniquePtr<PendingCompile>> compiles;
+    std::atomic<uint32> running{0};  // Tasks scheduled that haven't returned
+    std::atomic<uint32> finished{0}; // Compiles done, collected or not
+    uint32 collected = 0;            // finished when compiles was last looked through
+};
+
+uint64 ShaderHash(const gaShaderBytecode& shader)
+{
+    if (shader.size == 0)
+    {
+        return 0;
+    }
+    // 0 means no shader
+    const uint64 hash = HashBytes(shader.data, shader.size);
+    return hash == 0 ? 1 : hash;
+}
+
+bool IsDepthFormat(gaFormat format)
+{
+    return format >= gaFormat::D16Unorm && format < gaFormat::Count;
+}
+
+bool IsColorFormat(gaFormat format)
+{
+    return format > gaFormat::Unknown && format < gaFormat::D16Unorm;
+}
+
+Result<> CheckPushConstants(uint32 bytes)
+{
+    if (bytes % 4 != 0 || bytes > kGaMaxPushConstantBytes)
+    {
+        return "Push constants must be a multiple of 4 bytes, up to kGaMaxPushConstantBytes";
+    }
+    return ResultCode::Success;
+}
+
+bool HasBytecode(const gaShaderBytecode& shader)
+{
+    return shader.data != nullptr && shader.size > 0;
+}
+
+Result<> CheckMeshDesc(const gaDevice* device, const gaGraphicsPipelineDesc& desc)
+{
+    if (!device->meshShaders)
+    {
+        return {ErrorCategory::NotFound,
+                "The device has no mesh shaders, draw with vertex shaders"};
+    }
+
+    if (desc.vertexShader.size > 0 || !desc.attributes.IsEmpty() ||
+        !desc.vertexBuffers.IsEmpty() ||
+        (desc.amplificationShader.size > 0 && !HasBytecode(desc.amplificationShader)))
+    {
+        return "Mesh pipelines have no vertex shader or vertex input, and need an amplification "
+               "shader's bytecode when they have one";
+    }
+
+    if (desc.topology == gaPrimitiveTopology::TriangleStrip)
+    {
+        return "Mesh shaders output lists, not strips";
+    }
+    return ResultCode::Success;
+}
+
+Result<> CheckGraphicsDesc(const gaDevice* device, const gaGraphicsPipelineDesc& desc)
+{
+    if (desc.pixelShader.size > 0 && desc.pixelShader.data == nullptr)
+    {
+        return "Pixel shaders need their bytecode";
+    }
+
+    if (desc.meshShader.size > 0 || desc.amplificationShader.size > 0)
+    {
+        if (!HasBytecode(desc.meshShader))
+        {
+            return "Mesh pipelines need a mesh shader";
+        }
+        if (auto checked = CheckMeshDesc(device, desc); !checked)
+        {
+            return checked;
+        }
+    }
+    else if (!HasBytecode(desc.vertexShader))
+    {
+        return "Pipelines need a vertex shader, or a mesh shader";
+    }
+
+    if (desc.attributes.Size() > kGaMaxVertexAttributes ||
+        desc.vertexBuffers.Size() > kGaMaxVertexBuffers ||
+        desc.renderTargetFormats.Size() > kGaMaxRenderTargets)
+    {
+        return "Too many vertex attributes, vertex buffers or render targets";
+    }
+
+    for (const gaVertexAttribute& attribute : desc.attributes)
+    {
+        if (!IsColorFormat(attribute.format) || attribute.buffer >= desc.vertexBuffers.Size())
+        {
+            return "Vertex attributes need a color format and one of the vertex buffers";
+        }
+    }
+
+    for (gaFormat format : desc.renderTargetFormats)
+    {
+        if (!IsColorFormat(format))
+        {
+            return "Render target formats must be color formats";
+        }
+    }
+
+    if (!desc.blendModes.IsEmpty() && desc.blendModes.Size() != desc.renderTargetFormats.Size())
+    {
+        return "Blend modes must be one per render target, or none";
+    }
+
+    if (desc.depthFormat != gaFormat::Unknown && !IsDepthFormat(desc.depthFormat))
+    {
+        return "Depth format must be a depth format";
+    }
+
+    if (desc.topology > gaPrimitiveTopology::PointList || desc.raster.cull > gaCullMode::Back ||
+        desc.depth.compare > gaCompareOp::Always)
+    {
+        return "Invalid topology, cull mode or compare op";
+    }
+
+    for (gaBlendMode blendMode : desc.blendModes)
+    {
+        if (blendMode > gaBlendMode::Additive)
+        {
+            return "Invalid blend mode";
+        }
+    }
+
+    return CheckPushConstants(desc.pushConstantBytes);
+}
+
+Result<> CheckComputeDesc(const gaComputePipelineDesc& desc)
+{
+    if (desc.shader.data == nullptr || desc.shader.size == 0)
+    {
+        return "Compute pipelines need a shader";
+    }
+    return CheckPushConstants(desc.pushConstantBytes);
+}
+
+PipelineRecord MakeRecord(const gaGraphicsPipelineDesc& desc)
+{
+    PipelineRecord record;
+    memset(&record, 0, sizeof(record));
+    record.shaders[0] = ShaderHash(desc.vertexShader);
+    record.shaders[1] = ShaderHash(desc.pixelShader);
+    record.shaders[2] = ShaderHash(desc.amplificationShader);
+    record.shaders[3] = ShaderHash(desc.meshShader);
+    record.pushConstantBytes = desc.pushConstantBytes;
+
+    record.attributeCount = static_cast<uint32>(desc.attributes.Size());
+    for (uint32 i = 0; i < record.attributeCount; ++i)
+    {
+        const gaVertexAttribute& attribute = desc.attributes[i];
+        record.attributes[i][0] = attribute.location;
+        record.attributes[i][1] = static_cast<uint32>(attribute.format);
+        record.attributes[i][2] = attribute.buffer;
+        record.attributes[i][3] = attribute.offset;
+    }
+
+    record.vertexBufferCount = static_cast<uint32>(desc.vertexBuffers.Size());
+    for (uint32 i = 0; i < record.vertexBufferCount; ++i)
+    {
+        record.vertexBuffers[i][0] = desc.vertexBuffers[i].stride;
+        record.vertexBuffers[i][1] = desc.vertexBuffers[i].perInstance;
+    }
+
+    record.renderTargetCount = static_cast<uint32>(desc.renderTargetFormats.Size());
+    for (uint32 i = 0; i < record.renderTargetCount; ++i)
+    {
+        record.renderTargetFormats[i] = static_cast<uint32>(desc.renderTargetFormats[i]);
+        record.blendModes[i] =
+            desc.blendModes.IsEmpty() ? 0 : static_cast<uint32>(desc.blendModes[i]);
+    }
+
+    record.depthFormat = static_cast<uint32>(desc.depthFormat);
+    record.topology = static_cast<uint32>(desc.topology);
+    record.cull = static_cast<uint32>(desc.raster.cull);
+    record.frontCounterClockwise = desc.raster.frontCounterClockwise;
+    record.wireframe = desc.raster.wireframe;
+    record.depthClip = desc.raster.depthClip;
+    record.depthBias = desc.raster.depthBias;
+    record.slopeScaledDepthBias = desc.raster.slopeScaledDepthBias;
+    record.depthTest = desc.depth.test;
+    record.depthWrite = desc.depth.write;
+    record.depthCompare = static_cast<uint32>(desc.depth.compare);
+    return record;
+}
+
+PipelineRecord MakeRecord(const gaComputePipelineDesc& desc)
+{
+    PipelineRecord record;
+    memset(&record, 0, sizeof(record));
+    record.shaders[0] = ShaderHash(desc.shader);
+    record.compute = 1;
+    record.pushConstantBytes = desc.pushConstantBytes;
+    return record;
+}
+
+uint64 RecordKey(const PipelineRecord& record)
+{
+    return HashBytes(&record, sizeof(record), kCacheVersion);
+}
+
+// A graphics description pointing back into a record
+struct ExpandedGraphicsDesc
+{
+    gaGraphicsPipelineDesc desc;
+    gaVertexAttribute attributes[kGaMaxVertexAttributes];
+    gaVertexBuffer vertexBuffers[kGaMaxVertexBuffers];
+    gaFormat renderTargetFormats[kGaMaxRenderTargets];
+    gaBlendMode blendModes[kGaMaxRenderTargets];
+};
+
+gaShaderBytecode FindShader(PipelineCache* cache, uint64 hash)
+{
+    const DynamicArray<uint8>* bytes = hash != 0 ? cache->shaders.Find(hash) : nullptr;
+    return bytes != nullptr ? gaShaderBytecode{bytes->Data(), bytes->Size()} : gaShaderBytecode{};
+}
+
+// shaders are the record's, kRecordShaders of them
+void ExpandRecord(const PipelineRecord& record,
+                  const gaShaderBytecode* shaders,
+                  ExpandedGraphicsDesc& out)
+{
+    gaGraphicsPipelineDesc& desc = out.desc;
+    desc = {};
+    desc.vertexShader = shaders[0];
+    desc.pixelShader = shaders[1];
+    desc.amplificationShader = shaders[2];
+    desc.meshShader = shaders[3];
+
+    for (uint32 i = 0; i < record.attributeCount; ++i)
+    {
+        out.attributes[i] = {record.attributes[i][0],
+                             static_cast<gaFormat>(record.attributes[i][1]),
+                             record.attributes[i][2],
+                             record.attributes[i][3]};
+    }
+    desc.attributes = ArrayView<const gaVertexAttribute>(out.attributes, record.attributeCount);
+
+    for (uint32 i = 0; i < record.vertexBufferCount; ++i)
+    {
+        out.vertexBuffers[i] = {record.vertexBuffers[i][0], record.vertexBuffers[i][1] != 0};
+    }
+    desc.vertexBuffers =
+        ArrayView<const gaVertexBuffer>(out.vertexBuffers, record.vertexBufferCount);
+
+    for (uint32 i = 0; i < record.renderTargetCount; ++i)
+    {
+        out.renderTargetFormats[i] = static_cast<gaFormat>(record.renderTargetFormats[i]);
+        out.blendModes[i] = static_cast<gaBlendMode>(record.blendModes[i]);
+    }
+    desc.renderTargetFormats =
+        ArrayView<const gaFormat>(out.renderTargetFormats, record.renderTargetCount);
+    desc.blendModes = ArrayView<const gaBlendMode>(out.blendModes, record.renderTargetCount);
+
+    desc.depthFormat = static_cast<gaFormat>(record.depthFormat);
+    desc.topology = static_cast<gaPrimitiveTopology>(record.topology);
+    desc.raster.cull = static_cast<gaCullMode>(record.cull);
+    desc.raster.frontCounterClockwise = record.frontCounterClockwise != 0;
+    desc.raster.wireframe = record.wireframe != 0;
+    desc.raster.depthClip = record.depthClip != 0;
+    desc.raster.depthBias = record.depthBias;
+    desc.raster.slopeScaledDepthBias = record.slopeScaledDepthBias;
+    desc.depth.test = record.depthTest != 0;
+    desc.depth.write = record.depthWrite != 0;
+    desc.depth.compare = static_cast<gaCompareOp>(record.depthCompare);
+    desc.pushConstantBytes = record.pushConstantBytes;
+}
+
+void StoreShader(PipelineCache* cache, uint64 hash, const gaShaderBytecode& shader)
+{
+    if (hash == 0 || cache->shaders.Contains(hash))
+    {
+        return;
+    }
+    DynamicArray<uint8> bytes;
+    bytes.ResizeUninitialized(shader.size);
+    memcpy(bytes.Data(), shader.data, shader.size);
+    cache->shaders.Emplace(hash, rsblMove(bytes));
+}
+
+Result<backend::PipelineLayout*> FindLayout(PipelineCache* cache,
+                                            bool compute,
+                                            uint32 pushConstantBytes)
+{
+    const uint64 layoutKey = (uint64(compute) << 32) | pushConstantBytes;
+    if (UniquePtr<backend::PipelineLayout>* layout = cache->layouts.Find(layoutKey))
+    {
+        return layout->Get();
+    }
+
+    Result<backend::PipelineLayout*> layout = "Unknown graphics backend";
+    switch (cache->backend)
+    {
+    case gaBackend::Null:
+        layout = backend::CreateNullPipelineLayout(
+            cache->device, cache->bindless, compute, pushConstantBytes);
+        break;
+
+    case gaBackend::DX12:
+        layout = backend::CreateDX12PipelineLayout(
+            cache->device, cache->bindless, compute, pushConstantBytes);
+        break;
+
+    case gaBackend::Vulkan:
+        layout = backend::CreateVulkanPipelineLayout(
+            cache->device, cache->bindless, compute, pushConstantBytes);
+        break;
+
+    default:
+        break;
+    }
+    if (!layout)
+    {
+        return PendingFailure{layout.Category()};
+    }
+    cache->layouts.Emplace(layoutKey, layout.Value());
+    return layout.Value();
+}
+
+Result<gaPipeline*> CompilePipeline(PipelineCache* cache,
+                                    backend::PipelineLayout* layout,
+                                    uint64 key,
+                                    const gaGraphicsPipelineDesc& desc)
+{
+    OsTraceScope osTrace(OsTraceEvent::PipelineCompile, "Graphics", key);
+    switch (cache->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullGraphicsPipeline(
+            cache->device, cache->library.Get(), layout, key, desc);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12GraphicsPipeline(
+            cache->device, cache->library.Get(), layout, key, desc);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanGraphicsPipeline(
+            cache->device, cache->library.Get(), layout, key, desc);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaPipeline*> CompilePipeline(PipelineCache* cache,
+                                    backend::PipelineLayout* layout,
+                                    uint64 key,
+                                    const gaComputePipelineDesc& desc)
+{
+    OsTraceScope osTrace(OsTraceEvent::PipelineCompile, "Compute", key);
+    switch (cache->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullComputePipeline(
+            cache->device, cache->library.Get(), layout, key, desc);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12ComputePipeline(
+            cache->device, cache->library.Get(), layout, key, desc);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanComputePipeline(
+            cache->device, cache->library.Get(), layout, key, desc);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+// shaders are the record's, kRecordShaders of them
+Result<gaPipeline*> CompileRecord(PipelineCache* cache,
+                                  backend::PipelineLayout* layout,
+                                  uint64 key,
+                                  const PipelineRecord& record,
+                                  const gaShaderBytecode* shaders)
+{
+    if (record.compute != 0)
+    {
+        gaComputePipelineDesc desc;
+        desc.shader = shaders[0];
+        desc.pushConstantBytes = record.pushConstantBytes;
+        return CompilePipeline(cache, layout, key, desc);
+    }
+
+    ExpandedGraphicsDesc expanded;
+    ExpandRecord(record, shaders, expanded);
+    return CompilePipeline(cache, layout, key, expanded.desc);
+}
+
+void RecordPipeline(PipelineCache* cache, const PipelineRecord& record, uint64 key)
+{
+    if (!cache->recorded.Contains(key))
+    {
+        cache->recorded.Insert(key, static_cast<uint32>(cache->records.Size()));
+        cache->records.PushBack(record);
+    }
+}
+
+// Files a compiled pipeline under key
+gaPipeline* AddPipeline(PipelineCache* cache,
+                        const PipelineRecord& record,
+                        uint64 key,
+                        backend::PipelineLayout* layout,
+                        gaPipeline* pipeline)
+{
+    pipeline->backend = cache->backend;
+    pipeline->layout = layout->handle;
+    pipeline->key = key;
+    pipeline->pushConstantBytes = record.pushConstantBytes;
+    pipeline->compute = record.compute != 0;
+    cache->pipelineMap.Emplace(key, pipeline);
+    ++cache->pipelines;
+    RecordPipeline(cache, record, key);
+    return pipeline;
+}
+
+// Compiles the record's pipeline, from desc, and files it under key
+template <typename Desc>
+Result<gaPipeline*> MakePipeline(PipelineCache* cache,
+                                 const PipelineRecord& record,
+                                 uint64 key,
+                                 const Desc& desc)
+{
+    auto layout = FindLayout(cache, record.compute != 0, record.pushConstantBytes);
+    if (!layout)
+    {
+        return PendingFailure{layout.Category()};
+    }
+
+    Result<gaPipeline*> pipeline = CompilePipeline(cache, layout.Value(), key, desc);
+    if (!pipeline)
+    {
+        return PendingFailure{pipeline.Category()};
+    }
+    return AddPipeline(cache, record, key, layout.Value(), pipeline.Value());
+}
+
+// Runs on a worker
+void RunCompile(PipelineCache* cache, PendingCompile* compile)
+{
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    gaShaderBytecode shaders[kRecordShaders];
+    for (uint32 i = 0; i < kRecordShaders; ++i)
+    {
+        shaders[i] = {compile->shaders[i].Data(), compile->shaders[i].Size()};
+    }
+    Result<gaPipeline*> pipeline =
+        CompileRecord(cache, compile->layout, compile->key, compile->record, shaders);
+    if (pipeline)
+    {
+        compile->pipeline = pipeline.Value();
+    }
+    else
+    {
+        compile->failed = true;
+        compile->failure = pipeline.Category();
+    }
+    compile->done.store(true, std::memory_order_release);
+    cache->finished.fetch_add(1, std::memory_order_release);
+
+    // Last, the cache may be destroyed as soon as this is zero
+    cache->running.fetch_sub(1, std::memory_order_release);
+}
+
+// Takes a done compile out of compiles, filing its pipeline or returning its failure
+Result<gaPipeline*> FinishCompile(PipelineCache* cache, PendingCompile* compile)
+{
+    UniquePtr<PendingCompile> finished = rsblMove(*cache->compiles.Find(compile->key));
+    cache->compiles.Remove(compile->key);
+    cache->compiling = static_cast<uint32>(cache->compiles.Size());
+    if (compile->failed)
+    {
+        return PendingFailure{compile->failure};
+    }
+    return AddPipeline(cache, compile->record, compile->key, compile->layout, compile->pipeline);
+}
+
+// Files the pipelines workers have finished since the last look. Failed compiles stay until
+// they're requested again, so the request hears about it.
+void CollectCompiles(PipelineCache* cache)
+{
+    const uint32 finished = cache->finished.load(std::memory_order_acquire);
+    if (finished == cache->collected)
+    {
+        return;
+    }
+    cache->collected = finished;
+
+    DynamicArray<PendingCompile*> done;
+    for (auto& compile : cache->compiles)
+    {
+        PendingCompile* pending = compile.value.Get();
+        if (pending->done.load(std::memory_order_acquire) && !pending->failed)
+        {
+            done.PushBack(pending);
+        }
+    }
+    for (PendingCompile* pending : done)
+    {
+        (void)FinishCompile(cache, pending);
+    }
+}
+
+void WaitForCompile(const PendingCompile* compile)
+{
+    while (!compile->done.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void StoreShaders(PipelineCache* cache,
+                  const PipelineRecord& record,
+                  const gaComputePipelineDesc& desc)
+{
+    StoreShader(cache, record.shaders[0], desc.shader);
+}
+
+void StoreShaders(PipelineCache* cache,
+                  const PipelineRecord& record,
+                  const gaGraphicsPipelineDesc& desc)
+{
+    StoreShader(cache, record.shaders[0], desc.vertexShader);
+    StoreShader(cache, record.shaders[1], desc.pixelShader);
+    StoreShader(cache, record.shaders[2], desc.amplificationShader);
+    StoreShader(cache, record.shaders[3], desc.meshShader);
+}
+
+template <typename Desc>
+Result<gaPipeline*> FindOrMakePipeline(gaPipelineCache* baseCache, const Desc& desc)
+{
+    auto cache = static_cast<PipelineCache*>(baseCache);
+    const PipelineRecord record = MakeRecord(desc);
+    const uint64 key = RecordKey(record);
+    if (UniquePtr<gaPipeline>* pipeline = cache->pipelineMap.Find(key))
+    {
+        ++cache->hits;
+        return pipeline->Get();
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    if (UniquePtr<PendingCompile>* pending = cache->compiles.Find(key))
+    {
+        WaitForCompile(pending->Get());
+        return FinishCompile(cache, pending->Get());
+    }
+
+    StoreShaders(cache, record, desc);
+    return MakePipeline(cache, record, key, desc);
+}
+
+// Hands the record's pipeline to the scheduler, with copies of its shaders. They're in the cache
+// already, stored when it was asked for or loaded.
+void ScheduleCompile(PipelineCache* cache,
+                     const PipelineRecord& record,
+                     uint64 key,
+                     backend::PipelineLayout* layout)
+{
+    RecordPipeline(cache, record, key);
+
+    auto compile = rsbl::UniquePtr(new PendingCompile());
+    compile->record = record;
+    compile->key = key;
+    compile->layout = layout;
+    for (uint32 i = 0; i < kRecordShaders; ++i)
+    {
+        if (const DynamicArray<uint8>* shader =
+                record.shaders[i] != 0 ? cache->shaders.Find(record.shaders[i]) : nullptr)
+        {
+            compile->shaders[i].ResizeUninitialized(shader->Size());
+            memcpy(compile->shaders[i].Data(), shader->Data(), shader->Size());
+        }
+    }
+
+    PendingCompile* pending = compile.Get();
+    cache->compiles.Emplace(key, compile.Release());
+    cache->compiling = static_cast<uint32>(cache->compiles.Size());
+    cache->running.fetch_add(1, std::memory_order_relaxed);
+    cache->scheduler([cache, pending]() { RunCompile(cache, pending); });
+}
+
+template <typename Desc>
+Result<gaPipeline*> RequestPipeline(gaPipelineCache* baseCache,
+                                    const Desc& desc,
+                                    gaPipeline* fallback)
+{
+    auto cache = static_cast<PipelineCache*>(baseCache);
+    if (!cache->scheduler)
+    {
+        return FindOrMakePipeline(cache, desc);
+    }
+
+    CollectCompiles(cache);
+    const PipelineRecord record = MakeRecord(desc);
+    const uint64 key = RecordKey(record);
+    if (UniquePtr<gaPipeline>* pipeline = cache->pipelineMap.Find(key))
+    {
+        ++cache->hits;
+        return pipeline->Get();
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    if (UniquePtr<PendingCompile>* pending = cache->compiles.Find(key))
+    {
+        if ((*pending)->done.load(std::memory_order_acquire) && (*pending)->failed)
+        {
+            return FinishCompile(cache, pending->Get());
+        }
+        return fallback;
+    }
+
+    // Layouts are cheap, and made here so workers never change the cache
+    auto layout = FindLayout(cache, record.compute != 0, record.pushConstantBytes);
+    if (!layout)
+    {
+        return PendingFailure{layout.Category()};
+    }
+    StoreShaders(cache, record, desc);
+    ScheduleCompile(cache, record, key, layout.Value());
+    return fallback;
+}
+
+
+// Reads shaders and records out of data, returning the backend's part. Anything that doesn't
+// check out leaves the cache empty, and the backend starts from nothing.
+ArrayView<const uint8> LoadData(PipelineCache* cache, ArrayView<const uint8> data)
+{
+    CacheHeader header;
+    if (data.Size() < sizeof(header))
+    {
+        return {};
+    }
+    memcpy(&header, data.Data(), sizeof(header));
+    if (header.magic != kCacheMagic || header.version != kCacheVersion ||
+        header.backend != static_cast<uint32>(cache->backend))
+    {
+        return {};
+    }
+
+    uint64 offset = sizeof(header);
+    for (uint32 i = 0; i < header.shaderCount; ++i)
+    {
+        ShaderHeader shader;
+        if (data.Size() - offset < sizeof(shader))
+        {
+            cache->shaders.Clear();
+            return {};
+        }
+        memcpy(&shader, data.Data() + offset, sizeof(shader));
+        offset += sizeof(shader);
+
+        const uint64 padded = (shader.size + 7) & ~uint64(7);
+        if (padded < shader.size || data.Size() - offset < padded ||
+            HashBytes(data.Data() + offset, shader.size) != shader.hash)
+        {
+            cache->shaders.Clear();
+            return {};
+        }
+        StoreShader(cache, shader.hash, {data.Data() + offset, shader.size});
+        offset += padded;
+    }
+
+    if ((data.Size() - offset) / sizeof(PipelineRecord) < header.recordCount)
+    {
+        cache->shaders.Clear();
+        return {};
+    }
+    for (uint32 i = 0; i < header.recordCount; ++i)
+    {
+        PipelineRecord record;
+        memcpy(&record, data.Data() + offset, sizeof(record));
+        offset += sizeof(record);
+
+        // Records whose shaders didn't come along can't be compiled
+        bool complete = true;
+        for (uint64 shader : record.shaders)
+        {
+            complete = complete && (shader == 0 || cache->shaders.Contains(shader));
+        }
+        const uint64 key = RecordKey(record);
+        if (complete && !cache->recorded.Contains(key))
+        {
+            cache->recorded.Insert(key, static_cast<uint32>(cache->records.Size()));
+            cache->records.PushBack(record);
+        }
+    }
+    cache->loadedRecords = static_cast<uint32>(cache->records.Size());
+
+    if (data.Size() - offset < header.libraryBytes)
+    {
+        return {};
+    }
+    return data.Subview(offset, header.libraryBytes);
+}
+
+Result<backend::PipelineLibrary*> CreatePipelineLibrary(gaDevice* device,
+                                                        ArrayView<const uint8> data)
+{
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullPipelineLibrary(device, data);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12PipelineLibrary(device, data);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanPipelineLibrary(device, data);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+void AppendBytes(DynamicArray<uint8>& data, const void* bytes, uint64 size)
+{
+    const uint64 offset = data.Size();
+    data.ResizeUninitialized(offset + size);
+    memcpy(data.Data() + offset, bytes, size);
+}
+} // namespace
+
+Result<gaPipelineCache*> GaCreatePipelineCache(const gaPipelineCacheCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.bindless != nullptr && createInfo.bindless->device != createInfo.device)
+    {
+        return "The bindless heap must be the device's";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    auto cache = rsbl::UniquePtr(new PipelineCache());
+    cache->backend = createInfo.device->backend;
+    cache->device = createInfo.device;
+    cache->bindless = createInfo.bindless;
+
+    const ArrayView<const uint8> libraryData = LoadData(cache.Get(), createInfo.data);
+    auto library = CreatePipelineLibrary(createInfo.device, libraryData);
+    if (!library)
+    {
+        return PendingFailure{library.Category()};
+    }
+    cache->library.Reset(library.Value());
+    cache->internalHandle = library.Value()->handle;
+    cache->precompile = cache->loadedRecords;
+    return cache.Release();
+}
+
+void GaDestroyPipelineCache(gaPipelineCache* cache)
+{
+    if (cache == nullptr)
+    {
+        return;
+    }
+
+    // Workers still compiling use the layouts and the library
+    auto pipelineCache = static_cast<PipelineCache*>(cache);
+    while (pipelineCache->running.load(std::memory_order_acquire) != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    // Pipelines before the layouts and the library they were made with, finished compiles'
+    // included
+    for (auto& compile : pipelineCache->compiles)
+    {
+        delete compile.value->pipeline;
+    }
+    pipelineCache->compiles.Clear();
+    pipelineCache->pipelineMap.Clear();
+    pipelineCache->layouts.Clear();
+    delete pipelineCache;
+}
+
+Result<gaPipeline*> GaCreateGraphicsPipeline(gaPipelineCache* cache,
+                                             const gaGraphicsPipelineDesc& desc)
+{
+    if (cache == nullptr)
+    {
+        return "Pipeline cache cannot be null";
+    }
+
+    if (auto checked = CheckGraphicsDesc(cache->device, desc); !checked)
+    {
+        return PendingFailure{checked.Category()};
+    }
+    return FindOrMakePipeline(cache, desc);
+}
+
+Result<gaPipeline*> GaCreateComputePipeline(gaPipelineCache* cache,
+                                            const gaComputePipelineDesc& desc)
+{
+    if (cache == nullptr)
+    {
+        return "Pipeline cache cannot be null";
+    }
+
+    if (auto checked = CheckComputeDesc(desc); !checked)
+    {
+        return PendingFailure{checked.Category()};
+    }
+    return FindOrMakePipeline(cache, desc);
+}
+
+Result<uint32> GaPrecompilePipelines(gaPipelineCache* baseCache, uint32 maxCount)
+{
+    if (baseCache == nullptr)
+    {
+        return "Pipeline cache cannot be null";
+    }
+
+    auto cache = static_cast<PipelineCache*>(baseCache);
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    if (cache->scheduler)
+    {
+        CollectCompiles(cache);
+    }
+    for (uint32 compiled = 0;
+         compiled < maxCount && cache->nextPrecompile < cache->loadedRecords;
+         ++cache->nextPrecompile)
+    {
+        // Copied, AddPipeline may add to records
+        const PipelineRecord record = cache->records[cache->nextPrecompile];
+        const uint64 key = RecordKey(record);
+        if (cache->pipelineMap.Contains(key) || cache->compiles.Contains(key))
+        {
+            continue;
+        }
+
+        auto layout = FindLayout(cache, record.compute != 0, record.pushConstantBytes);
+        if (!layout)
+        {
+            return PendingFailure{layout.Category()};
+        }
+        if (cache->scheduler)
+        {
+            ScheduleCompile(cache, record, key, layout.Value());
+            ++compiled;
+            continue;
+        }
+        gaShaderBytecode shaders[kRecordShaders];
+        for (uint32 i = 0; i < kRecordShaders; ++i)
+        {
+            shaders[i] = FindShader(cache, record.shaders[i]);
+        }
+        Result<gaPipeline*> pipeline = CompileRecord(cache, layout.Value(), key, record, shaders);
+        if (!pipeline)
+        {
+            return PendingFailure{pipeline.Category()};
+        }
+        AddPipeline(cache, record, key, layout.Value(), pipeline.Value());
+        ++compiled;
+    }
+
+    // Handed to the scheduler counts as left until it's compiled
+    cache->precompile = cache->loadedRecords - cache->nextPrecompile;
+    return cache->precompile + cache->running.load(std::memory_order_acquire);
+}
+
+Result<> GaSerializePipelineCache(gaPipelineCache* baseCache, DynamicArray<uint8>& data)
+{
+    if (baseCache == nullptr)
+    {
+        return "Pipeline cache cannot be null";
+    }
+
+    auto cache = static_cast<PipelineCache*>(baseCache);
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    CacheHeader header = {};
+    header.magic = kCacheMagic;
+    header.version = kCacheVersion;
+    header.backend = static_cast<uint32>(cache->backend);
+    header.shaderCount = static_cast<uint32>(cache->shaders.Size());
+    header.recordCount = static_cast<uint32>(cache->records.Size());
+
+    data.Clear();
+    AppendBytes(data, &header, sizeof(header));
+    const uint8 padding[8] = {};
+    for (const auto& shader : cache->shaders)
+    {
+        const ShaderHeader shaderHeader = {shader.key, shader.value.Size()};
+        AppendBytes(data, &shaderHeader, sizeof(shaderHeader));
+        AppendBytes(data, shader.value.Data(), shader.value.Size());
+        AppendBytes(data, padding, (8 - shader.value.Size() % 8) % 8);
+    }
+    AppendBytes(data, cache->records.Data(), cache->records.Size() * sizeof(PipelineRecord));
+
+    const uint64 libraryOffset = data.Size();
+    Result<> serialized = ResultCode::Success;
+    switch (cache->backend)
+    {
+    case gaBackend::DX12:
+        serialized = backend::SerializeDX12PipelineLibrary(cache->library.Get(), data);
+        break;
+
+    case gaBackend::Vulkan:
+        serialized =
+            backend::SerializeVulkanPipelineLibrary(cache->device, cache->library.Get(), data);
+        break;
+
+    default:
+        break;
+    }
+    if (!serialized)
+    {
+        return PendingFailure{serialized.Category()};
+    }
+
+    header.libraryBytes = data.Size() - libraryOffset;
+    memcpy(data.Data(), &header, sizeof(header));
+    return ResultCode::Success;
+}
+
+void GaSetPipelineScheduler(gaPipelineCache* cache, gaPipelineScheduler&& scheduler)
+{
+    if (cache != nullptr)
+    {
+        static_cast<PipelineCache*>(cache)->scheduler = rsblMove(scheduler);
+    }
+}
+
+Result<gaPipeline*> GaRequestGraphicsPipeline(gaPipelineCache* cache,
+                                              const gaGraphicsPipelineDesc& desc,
+                                              gaPipeline* fallback)
+{
+    if (cache == nullptr)
+    {
+        return "Pipeline cache cannot be null";
+    }
+
+    if (auto checked = CheckGraphicsDesc(cache->device, desc); !checked)
+    {
+        return PendingFailure{checked.Category()};
+    }
+    return RequestPipeline(cache, desc, fallback);
+}
+
+Result<gaPipeline*> GaRequestComputePipeline(gaPipelineCache* cache,
+                                             const gaComputePipelineDesc& desc,
+                                             gaPipeline* fallback)
+{
+    if (cache == nullptr)
+    {
+        return "Pipeline cache cannot be null";
+    }
+
+    if (auto checked = CheckComputeDesc(desc); !checked)
+    {
+        return PendingFailure{checked.Category()};
+    }
+    return RequestPipeline(cache, desc, fallback);
+}
+
+Result<> GaCmdPushConstants(gaCommandList* list,
+                            const gaPipeline* pipeline,
+                            uint32 offset,
+                            const void* data,
+                            uint32 size)
+{
+    if (list == nullptr || pipeline == nullptr)
+    {
+        return "Command list and pipeline cannot be null";
+    }
+
+    if (!list->recording || list->queue == gaQueueType::Copy ||
+        (!pipeline->compute && list->queue != gaQueueType::Graphics))
+    {
+        return "Push constants are recorded into recording lists that can run the pipeline";
+    }
+
+    if (pipeline->backend != list->backend)
+    {
+        return {ErrorCategory::InvalidArgument, "The pipeline is from another backend"};
+    }
+
+    if ((offset | size) % 4 != 0 || uint64(offset) + size > pipeline->pushConstantBytes)
+    {
+        return {ErrorCategory::InvalidArgument,
+                "Push constants are whole 32-bit values within the pipeline's push constants"};
+    }
+
+    if (size == 0)
+    {
+        return ResultCode::Success;
+    }
+
+    if (data == nullptr)
+    {
+        return "Push constant data cannot be null";
+    }
+
+    switch (list->backend)
+    {
+    case gaBackend::Null:
+        backend::RecordNullCommand(list, {gaNullCommandType::PushConstants, 0, size, nullptr});
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        backend::RecordDX12PushConstants(list, pipeline, offset, size, data);
+        return ResultCode::Success;
+
+    case gaBackend::Vulkan:
+        backend::RecordVulkanPushConstants(list, pipeline, offset, size, data);
+        return ResultCode::Success;
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,353 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-clock.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+#include <atomic>
+
+namespace rsbl
+{
+
+namespace
+{
+// GaCreateDevice's limit
+constexpr uint32 kMaxFramesInFlight = 4;
+
+// Zones are timed on the graphics and compute queues, a pool each
+constexpr uint32 kZoneQueues = 2;
+
+constexpr uint32 kNoTimestamp = ~0u;
+
+// Indices of the zone's timestamps in its queue's pool, for the frame
+struct ZoneRecord
+{
+    const char* name = nullptr;
+    uint32 start = kNoTimestamp;
+    uint32 end = kNoTimestamp;
+    gaQueueType queue = gaQueueType::Graphics;
+};
+
+struct ZoneSlot
+{
+    uint64 frame = 0; // The frame timing them, 0 for a slot that's never been used
+    std::atomic<uint32> used{0}; // Counts past zonesPerFrame when the frame runs out
+    DynamicArray<ZoneRecord> records;
+};
+
+// A zone read back, with its timestamp indices to tell nesting by where times are equal
+struct ReadZone
+{
+    gaGpuZone zone;
+    uint32 start;
+    uint32 end;
+};
+
+struct GpuProfiler : public gaGpuProfiler
+{
+    gaQueryPool* pools[kZoneQueues] = {};
+    ZoneSlot slots[kMaxFramesInFlight];
+    DynamicArray<ReadZone> read;
+    DynamicArray<gaGpuZone> readback;
+    DynamicArray<uint32> open; // Zones containing the one being placed, outermost first
+
+    ~GpuProfiler() override
+    {
+        for (gaQueryPool* pool : pools)
+        {
+            GaDestroyQueryPool(pool);
+        }
+        if (device != nullptr && device->gpuProfiler == this)
+        {
+            device->gpuProfiler = nullptr;
+        }
+    }
+};
+
+uint64 ToCpuTicks(uint64 timestamp, const gaClockCalibration& calibration)
+{
+    // Timestamps are mostly from before the calibration, so the difference is signed
+    const int64 gpuTicks = static_cast<int64>(timestamp - calibration.gpuTimestamp);
+    const double seconds =
+        static_cast<double>(gpuTicks) / static_cast<double>(calibration.gpuFrequency);
+    return calibration.cpuTicks +
+           static_cast<uint64>(static_cast<int64>(
+               seconds * static_cast<double>(calibration.cpuFrequency)));
+}
+
+// By queue, then start, then the order they were begun in
+bool ZoneBefore(const ReadZone& a, const ReadZone& b)
+{
+    if (a.zone.queue != b.zone.queue)
+    {
+        return a.zone.queue < b.zone.queue;
+    }
+    if (a.zone.startTicks != b.zone.startTicks)
+    {
+        return a.zone.startTicks < b.zone.startTicks;
+    }
+    return a.start < b.start;
+}
+
+// Zones nest within one list, where their timestamps were written in order. Zones in lists
+// recorded at the same time can have indices inside each other's, but not times.
+bool Contains(const ReadZone& outer, const ReadZone& inner)
+{
+    return outer.zone.queue == inner.zone.queue && outer.start < inner.start &&
+           inner.end < outer.end && outer.zone.startTicks <= inner.zone.startTicks &&
+           inner.zone.endTicks <= outer.zone.endTicks;
+}
+
+// Reads the slot's zones back from the pools, which GaBeginTimestampFrame has just read
+void ReadZones(GpuProfiler* profiler, const ZoneSlot& slot)
+{
+    gaClockCalibration calibrations[kZoneQueues];
+    profiler->uncalibrated = false;
+    for (uint32 queue = 0; queue < kZoneQueues; ++queue)
+    {
+        auto calibration =
+            GaGetClockCalibration(profiler->device, static_cast<gaQueueType>(queue));
+        if (calibration)
+        {
+            calibrations[queue] = calibration.Value();
+        }
+        else
+        {
+            // Durations still come out right, from an arbitrary start
+            const uint64 gpuFrequency = profiler->pools[queue]->frequency;
+            calibrations[queue] = {0, gpuFrequency, 0, Clock::TicksPerSecond()};
+            profiler->uncalibrated = true;
+        }
+    }
+
+    profiler->read.Clear();
+    const uint32 used = slot.used.load(std::memory_order_relaxed);
+    const uint32 count = used < profiler->zonesPerFrame ? used : profiler->zonesPerFrame;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const ZoneRecord& record = slot.records[i];
+        const uint32 queue = static_cast<uint32>(record.queue);
+        const gaQueryPool* pool = profiler->pools[queue];
+        if (pool->resultFrame != slot.frame || record.end >= pool->resultCount ||
+            record.start >= pool->resultCount)
+        {
+            continue; // Never ended, or ended after the resolve
+        }
+
+        const uint64 startTicks = ToCpuTicks(pool->results[record.start], calibrations[queue]);
+        const uint64 endTicks = ToCpuTicks(pool->results[record.end], calibrations[queue]);
+        ReadZone zone;
+        zone.zone = {record.name, startTicks, endTicks < startTicks ? startTicks : endTicks,
+                     record.queue, 0};
+        zone.start = record.start;
+        zone.end = record.end;
+
+        // Insertion sort, zones are begun in nearly the order they run in
+        profiler->read.PushBack(zone);
+        for (uint64 j = profiler->read.Size() - 1; j > 0; --j)
+        {
+            if (!ZoneBefore(profiler->read[j], profiler->read[j - 1]))
+            {
+                break;
+            }
+            const ReadZone swapped = profiler->read[j];
+            profiler->read[j] = profiler->read[j - 1];
+            profiler->read[j - 1] = swapped;
+        }
+    }
+
+    profiler->readback.Clear();
+    profiler->open.Clear();
+    for (uint64 i = 0; i < profiler->read.Size(); ++i)
+    {
+        while (!profiler->open.IsEmpty() &&
+               !Contains(profiler->read[profiler->open[profiler->open.Size() - 1]],
+                         profiler->read[i]))
+        {
+            profiler->open.PopBack();
+        }
+        gaGpuZone zone = profiler->read[i].zone;
+        zone.depth = static_cast<uint32>(profiler->open.Size());
+        profiler->readback.PushBack(zone);
+        profiler->open.PushBack(static_cast<uint32>(i));
+    }
+}
+
+uint32 WriteTimestamp(gaCommandList* list, GpuProfiler* profiler)
+{
+    auto written = GaCmdWriteTimestamp(list, profiler->pools[static_cast<uint32>(list->queue)]);
+    return written ? written.Value() : kNoTimestamp;
+}
+} // namespace
+
+Result<gaGpuProfiler*> GaCreateGpuProfiler(const gaGpuProfilerCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.device->gpuProfiler != nullptr)
+    {
+        return {ErrorCategory::InvalidArgument, "The device already has a GPU profiler"};
+    }
+
+    if (createInfo.zonesPerFrame == 0 || createInfo.zonesPerFrame > (~0u >> 1))
+    {
+        return {ErrorCategory::InvalidArgument, "Zones per frame must be greater than zero"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    auto profiler = rsbl::UniquePtr(new GpuProfiler());
+    profiler->device = nullptr;
+    profiler->zonesPerFrame = createInfo.zonesPerFrame;
+    profiler->zones = nullptr;
+    profiler->zoneCount = 0;
+    profiler->zoneFrame = 0;
+    profiler->uncalibrated = false;
+
+    for (uint32 queue = 0; queue < kZoneQueues; ++queue)
+    {
+        gaQueryPoolCreateInfo poolInfo;
+        poolInfo.device = createInfo.device;
+        poolInfo.queue = static_cast<gaQueueType>(queue);
+        poolInfo.timestampsPerFrame = createInfo.zonesPerFrame * 2;
+        auto pool = GaCreateQueryPool(poolInfo);
+        if (!pool)
+        {
+            return PendingFailure{pool.Category()};
+        }
+        profiler->pools[queue] = pool.Value();
+    }
+
+    for (ZoneSlot& slot : profiler->slots)
+    {
+        slot.records.Resize(createInfo.zonesPerFrame);
+    }
+
+    profiler->device = createInfo.device;
+    createInfo.device->gpuProfiler = profiler.Get();
+    return profiler.Release();
+}
+
+void GaDestroyGpuProfiler(gaGpuProfiler* profiler)
+{
+    delete static_cast<GpuProfiler*>(profiler);
+}
+
+Result<> GaBeginGpuProfilerFrame(gaGpuProfiler* baseProfiler)
+{
+    if (baseProfiler == nullptr)
+    {
+        return "GPU profiler cannot be null";
+    }
+
+    auto profiler = static_cast<GpuProfiler*>(baseProfiler);
+    const gaDevice* device = profiler->device;
+    if (device->frame == 0)
+    {
+        return "GaBeginFrame must be called before GaBeginGpuProfilerFrame";
+    }
+
+    ZoneSlot& slot = profiler->slots[device->frame % device->framesInFlight];
+    if (slot.frame == device->frame)
+    {
+        return ResultCode::Success;
+    }
+
+    for (gaQueryPool* pool : profiler->pools)
+    {
+        if (auto begun = GaBeginTimestampFrame(pool); !begun)
+        {
+            return begun;
+        }
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    profiler->readback.Clear();
+    if (slot.frame != 0)
+    {
+        ReadZones(profiler, slot);
+    }
+    profiler->zones = profiler->readback.Data();
+    profiler->zoneCount = static_cast<uint32>(profiler->readback.Size());
+    profiler->zoneFrame = slot.frame;
+
+    slot.frame = device->frame;
+    slot.used.store(0, std::memory_order_relaxed);
+    return ResultCode::Success;
+}
+
+uint32 GaBeginGpuZone(gaCommandList* list, const char* name)
+{
+    if (list == nullptr || list->device == nullptr || list->device->gpuProfiler == nullptr ||
+        static_cast<uint32>(list->queue) >= kZoneQueues)
+    {
+        return kGaNoGpuZone;
+    }
+
+    auto profiler = static_cast<GpuProfiler*>(list->device->gpuProfiler);
+    ZoneSlot& slot = profiler->slots[list->frame % list->device->framesInFlight];
+    if (slot.frame != list->frame)
+    {
+        return kGaNoGpuZone; // GaBeginGpuProfilerFrame wasn't called for the frame
+    }
+
+    const uint32 start = WriteTimestamp(list, profiler);
+    if (start == kNoTimestamp)
+    {
+        return kGaNoGpuZone;
+    }
+
+    const uint32 zone = slot.used.fetch_add(1, std::memory_order_relaxed);
+    if (zone >= profiler->zonesPerFrame)
+    {
+        return kGaNoGpuZone;
+    }
+
+    ZoneRecord& record = slot.records[zone];
+    record.name = name;
+    record.start = start;
+    record.end = kNoTimestamp;
+    record.queue = list->queue;
+    return zone;
+}
+
+void GaEndGpuZone(gaCommandList* list, uint32 zone)
+{
+    if (zone == kGaNoGpuZone || list == nullptr || list->device->gpuProfiler == nullptr)
+    {
+        return;
+    }
+
+    auto profiler = static_cast<GpuProfiler*>(list->device->gpuProfiler);
+    ZoneSlot& slot = profiler->slots[list->frame % list->device->framesInFlight];
+    if (slot.frame == list->frame && zone < profiler->zonesPerFrame &&
+        slot.records[zone].queue == list->queue)
+    {
+        slot.records[zone].end = WriteTimestamp(list, profiler);
+    }
+}
+
+Result<> GaCmdResolveGpuZones(gaCommandList* list)
+{
+    if (list == nullptr)
+    {
+        return "Command list cannot be null";
+    }
+
+    if (list->device->gpuProfiler == nullptr || static_cast<uint32>(list->queue) >= kZoneQueues)
+    {
+        return ResultCode::Success;
+    }
+
+    auto profiler = static_cast<GpuProfiler*>(list->device->gpuProfiler);
+    return GaCmdResolveTimestamps(list, profiler->pools[static_cast<uint32>(list->queue)]);
+}
+
+} // namespace rsbl
@@ -0,0 +1,301 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+#include <atomic>
+
+namespace rsbl
+{
+
+namespace
+{
+// GaCreateDevice's limit
+constexpr uint32 kMaxFramesInFlight = 4;
+
+// A frame in flight's timestamps, timestampsPerFrame of them from slot * timestampsPerFrame
+struct TimestampSlot
+{
+    uint64 frame = 0; // The frame writing them, 0 for a slot that's never been used
+    std::atomic<uint32> written{0}; // Counts past timestampsPerFrame when the frame runs out
+    uint32 resolved = 0;
+};
+
+struct QueryPool : public gaQueryPool
+{
+    UniquePtr<backend::TimestampHeap> heap;
+    TimestampSlot slots[kMaxFramesInFlight];
+    DynamicArray<uint64> readback;
+};
+
+Result<backend::TimestampHeap*> CreateTimestampHeap(gaDevice* device,
+                                                    gaQueueType queue,
+                                                    uint32 count)
+{
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullTimestampHeap(device, queue, count);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12TimestampHeap(device, queue, count);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanTimestampHeap(device, queue, count);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+uint32 WrittenTimestamps(const QueryPool* pool, const TimestampSlot& slot)
+{
+    const uint32 written = slot.written.load(std::memory_order_relaxed);
+    return written < pool->timestampsPerFrame ? written : pool->timestampsPerFrame;
+}
+} // namespace
+
+Result<gaQueryPool*> GaCreateQueryPool(const gaQueryPoolCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.queue != gaQueueType::Graphics && createInfo.queue != gaQueueType::Compute)
+    {
+        return {ErrorCategory::InvalidArgument, "Timestamps are for graphics or compute queues"};
+    }
+
+    const uint64 count = uint64(createInfo.timestampsPerFrame) * createInfo.device->framesInFlight;
+    if (createInfo.timestampsPerFrame == 0 || count > ~0u)
+    {
+        return {ErrorCategory::InvalidArgument,
+                "Timestamps per frame must be greater than zero, and fit in a pool"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    auto heap =
+        CreateTimestampHeap(createInfo.device, createInfo.queue, static_cast<uint32>(count));
+    if (!heap)
+    {
+        return PendingFailure{heap.Category()};
+    }
+
+    auto pool = rsbl::UniquePtr(new QueryPool());
+    pool->heap.Reset(heap.Value());
+    pool->backend = createInfo.device->backend;
+    pool->internalHandle = heap.Value()->handle;
+    pool->device = createInfo.device;
+    pool->queue = createInfo.queue;
+    pool->timestampsPerFrame = createInfo.timestampsPerFrame;
+    pool->frequency = heap.Value()->frequency;
+    pool->readback.Resize(createInfo.timestampsPerFrame);
+    pool->results = pool->readback.Data();
+    pool->resultCount = 0;
+    pool->resultFrame = 0;
+    return pool.Release();
+}
+
+void GaDestroyQueryPool(gaQueryPool* pool)
+{
+    delete static_cast<QueryPool*>(pool);
+}
+
+Result<> GaBeginTimestampFrame(gaQueryPool* basePool)
+{
+    if (basePool == nullptr)
+    {
+        return "Query pool cannot be null";
+    }
+
+    auto pool = static_cast<QueryPool*>(basePool);
+    const gaDevice* device = pool->device;
+    if (device->frame == 0)
+    {
+        return "GaBeginFrame must be called before GaBeginTimestampFrame";
+    }
+
+    // The slot's last frame is framesInFlight or more back, which GaBeginFrame has waited for
+    const uint32 slotIndex = static_cast<uint32>(device->frame % device->framesInFlight);
+    TimestampSlot& slot = pool->slots[slotIndex];
+    if (slot.frame == device->frame)
+    {
+        return ResultCode::Success;
+    }
+
+    pool->resultCount = 0;
+    pool->resultFrame = 0;
+    if (slot.frame != 0)
+    {
+        const uint32 first = slotIndex * pool->timestampsPerFrame;
+        if (slot.resolved > 0)
+        {
+            Result<> read = ResultCode::Success;
+            switch (pool->backend)
+            {
+            case gaBackend::Null:
+                for (uint32 i = 0; i < slot.resolved; ++i)
+                {
+                    pool->readback[i] = 0;
+                }
+                break;
+
+            case gaBackend::DX12:
+                read = backend::ReadDX12Timestamps(
+                    pool->heap.Get(), first, slot.resolved, pool->readback.Data());
+                break;
+
+            case gaBackend::Vulkan:
+                read = backend::ReadVulkanTimestamps(
+                    pool->heap.Get(), first, slot.resolved, pool->readback.Data());
+                break;
+
+            default:
+                return "Unknown graphics backend";
+            }
+            if (!read)
+            {
+                return read;
+            }
+            pool->resultCount = slot.resolved;
+        }
+        pool->resultFrame = slot.frame;
+
+        const uint32 written = WrittenTimestamps(pool, slot);
+        if (pool->backend == gaBackend::Vulkan && written > 0)
+        {
+            backend::ResetVulkanTimestamps(pool->heap.Get(), first, written);
+        }
+    }
+
+    slot.frame = device->frame;
+    slot.written.store(0, std::memory_order_relaxed);
+    slot.resolved = 0;
+    return ResultCode::Success;
+}
+
+Result<uint32> GaCmdWriteTimestamp(gaCommandList* list, gaQueryPool* basePool)
+{
+    if (list == nullptr || basePool == nullptr)
+    {
+        return "Command list and query pool cannot be null";
+    }
+
+    if (!list->recording || list->queue != basePool->queue || list->bundle)
+    {
+        return "Timestamps are recorded into recording lists on the pool's queue";
+    }
+
+    auto pool = static_cast<QueryPool*>(basePool);
+    const gaDevice* device = pool->device;
+    const uint32 slotIndex = static_cast<uint32>(device->frame % device->framesInFlight);
+    TimestampSlot& slot = pool->slots[slotIndex];
+    if (slot.frame != device->frame)
+    {
+        return "GaBeginTimestampFrame must be called before the frame's timestamps";
+    }
+
+    const uint32 index = slot.written.fetch_add(1, std::memory_order_relaxed);
+    if (index >= pool->timestampsPerFrame)
+    {
+        return {ErrorCategory::OutOfMemory, "The frame is out of timestamps"};
+    }
+
+    const uint32 heapIndex = slotIndex * pool->timestampsPerFrame + index;
+    switch (pool->backend)
+    {
+    case gaBackend::Null:
+        backend::RecordNullCommand(list, {gaNullCommandType::WriteTimestamp, 1, 0, nullptr});
+        break;
+
+    case gaBackend::DX12:
+        backend::WriteDX12Timestamp(list, pool->heap.Get(), heapIndex);
+        break;
+
+    case gaBackend::Vulkan:
+        backend::WriteVulkanTimestamp(list, pool->heap.Get(), heapIndex);
+        break;
+
+    default:
+        return "Unknown graphics backend";
+    }
+    return index;
+}
+
+Result<> GaCmdResolveTimestamps(gaCommandList* list, gaQueryPool* basePool)
+{
+    if (list == nullptr || basePool == nullptr)
+    {
+        return "Command list and query pool cannot be null";
+    }
+
+    if (!list->recording || list->queue != basePool->queue || list->bundle)
+    {
+        return "Timestamps are resolved in recording lists on the pool's queue";
+    }
+
+    auto pool = static_cast<QueryPool*>(basePool);
+    const gaDevice* device = pool->device;
+    const uint32 slotIndex = static_cast<uint32>(device->frame % device->framesInFlight);
+    TimestampSlot& slot = pool->slots[slotIndex];
+    if (slot.frame != device->frame)
+    {
+        return "GaBeginTimestampFrame must be called before the frame's timestamps";
+    }
+
+    // Timestamps written since an earlier resolve are resolved along with the rest again
+    const uint32 written = WrittenTimestamps(pool, slot);
+    if (written == 0)
+    {
+        return ResultCode::Success;
+    }
+    slot.resolved = written;
+
+    if (pool->backend == gaBackend::DX12)
+    {
+        backend::ResolveDX12Timestamps(
+            list, pool->heap.Get(), slotIndex * pool->timestampsPerFrame, written);
+    }
+    else if (pool->backend == gaBackend::Null)
+    {
+        backend::RecordNullCommand(
+            list, {gaNullCommandType::ResolveTimestamps, written, 0, nullptr});
+    }
+    return ResultCode::Success;
+}
+
+Result<gaClockCalibration> GaGetClockCalibration(gaDevice* device, gaQueueType queue)
+{
+    if (device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (queue != gaQueueType::Graphics && queue != gaQueueType::Compute)
+    {
+        return {ErrorCategory::InvalidArgument, "Timestamps are for graphics or compute queues"};
+    }
+
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return gaClockCalibration{0, 1'000'000'000, 0, 1'000'000'000};
+
+    case gaBackend::DX12:
+        return backend::GetDX12ClockCalibration(device, queue);
+
+    case gaBackend::Vulkan:
+        return backend::GetVulkanClockCalibration(device, queue);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,493 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-counters.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+namespace rsbl
+{
+
+namespace
+{
+// D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, which suit
+// Vulkan as well
+constexpr uint32 kRowPitchAlignment = 256;
+constexpr uint64 kTextureOffsetAlignment = 512;
+constexpr uint64 kBufferOffsetAlignment = 16;
+
+// Once this many retired readbacks are at the front, and they're half of them, they're dropped
+constexpr uint64 kCompactAfter = 64;
+
+// A readback's space: it comes back once it's released and the GPU is done writing it
+struct ReadbackEntry
+{
+    uint64 end;
+    uint64 fenceValue; // 0 until flushed
+    bool released;
+};
+
+// Positions count bytes handed out since the ring was created, the offset in the buffer is the
+// position modulo its size. Readbacks are numbered from 0 in the order they're queued.
+struct ReadbackRing : public gaReadbackRing
+{
+    UniquePtr<backend::ReadbackBuffer> buffer;
+    UniquePtr<gaFence> ownedFence; // gaReadbackRing::fence
+    uint32 recorder = 0;
+
+    uint64 head = 0; // Handed out
+    uint64 tail = 0; // Free again before
+
+    DynamicArray<ReadbackEntry> entries;
+    uint64 retiredEntries = 0; // entries before this are free again
+    uint64 firstSerial = 0;    // entries[0]'s
+    uint64 flushedSerial = 0;  // Readbacks before this are flushed
+
+    DynamicArray<backend::ReadbackCopy> copies;
+    // Textures not already in CopySource, to put them there for the copies
+    DynamicArray<gaBarrier> barriers;
+};
+
+// Bytes per texel, 0 for formats whose texels can't be copied out as they are: D24UnormS8Uint
+// is two planes, and R32G32B32Float's 12 bytes don't divide the row and offset alignments
+uint32 TexelSize(gaFormat format)
+{
+    switch (format)
+    {
+    case gaFormat::D16Unorm:
+        return 2;
+
+    case gaFormat::R8G8B8A8Unorm:
+    case gaFormat::R8G8B8A8Srgb:
+    case gaFormat::B8G8R8A8Unorm:
+    case gaFormat::B8G8R8A8Srgb:
+    case gaFormat::R8G8B8A8Uint:
+    case gaFormat::R10G10B10A2Unorm:
+    case gaFormat::R11G11B10Float:
+    case gaFormat::R16G16Float:
+    case gaFormat::R32Float:
+    case gaFormat::R32Uint:
+    case gaFormat::D32Float:
+        return 4;
+
+    case gaFormat::R16G16B16A16Float:
+    case gaFormat::R16G16B16A16Unorm:
+    case gaFormat::R32G32Float:
+        return 8;
+
+    case gaFormat::R32G32B32A32Float:
+        return 16;
+
+    default:
+        return 0;
+    }
+}
+
+// Gives back the space of released readbacks at the front that the GPU is done with
+void RetireEntries(ReadbackRing* ring)
+{
+    const uint64 completed = GaGetFenceValue(ring->fence);
+    while (ring->retiredEntries < ring->entries.Size())
+    {
+        const ReadbackEntry& entry = ring->entries[ring->retiredEntries];
+        if (!entry.released || entry.fenceValue == 0 || entry.fenceValue > completed)
+        {
+            break;
+        }
+        ring->tail = entry.end;
+        ++ring->retiredEntries;
+    }
+
+    if (ring->retiredEntries == ring->entries.Size())
+    {
+        ring->firstSerial += ring->retiredEntries;
+        ring->entries.Clear();
+        ring->retiredEntries = 0;
+    }
+    else if (ring->retiredEntries >= kCompactAfter &&
+             ring->retiredEntries * 2 >= ring->entries.Size())
+    {
+        // A capture keeps a few readbacks in flight, so the array never empties on its own
+        const uint64 kept = ring->entries.Size() - ring->retiredEntries;
+        for (uint64 i = 0; i < kept; ++i)
+        {
+            ring->entries[i] = ring->entries[ring->retiredEntries + i];
+        }
+        ring->entries.Resize(kept);
+        ring->firstSerial += ring->retiredEntries;
+        ring->retiredEntries = 0;
+    }
+}
+
+// Space for size bytes at alignment, or an error when what's left is held by readbacks that
+// haven't been released
+Result<gaReadbackFuture> Allocate(ReadbackRing* ring, uint64 size, uint64 alignment)
+{
+    if (size > ring->size)
+    {
+        return "Readback is bigger than the ring";
+    }
+
+    // Allocations don't wrap: one that would run off the end starts over at the front
+    uint64 lap = ring->head - ring->head % ring->size;
+    uint64 offset = AlignUp(ring->head - lap, alignment);
+    if (offset > ring->size - size)
+    {
+        lap += ring->size;
+        offset = 0;
+    }
+    const uint64 end = lap + offset + size;
+
+    // Within a lap of the readbacks still held, when any are
+    if (ring->tail != ring->head && end - ring->tail > ring->size)
+    {
+        RetireEntries(ring);
+        if (ring->tail != ring->head && end - ring->tail > ring->size)
+        {
+            return "Readback ring is full of readbacks that haven't been released";
+        }
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    if (ring->tail == ring->head)
+    {
+        ring->tail = lap + offset;
+    }
+    ring->head = end;
+    const uint64 serial = ring->firstSerial + ring->entries.Size();
+    ring->entries.PushBack({end, 0, false});
+    return gaReadbackFuture{serial, offset, size, 0};
+}
+
+// The future's entry, null when it's been retired or was never handed out
+const ReadbackEntry* FindEntry(const ReadbackRing* ring, const gaReadbackFuture& future)
+{
+    if (future.serial < ring->firstSerial + ring->retiredEntries ||
+        future.serial >= ring->firstSerial + ring->entries.Size())
+    {
+        return nullptr;
+    }
+    return &ring->entries[future.serial - ring->firstSerial];
+}
+
+Result<backend::ReadbackBuffer*> CreateReadbackBuffer(gaDevice* device, uint64 size)
+{
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullReadbackBuffer(device, size);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12ReadbackBuffer(device, size);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanReadbackBuffer(device, size);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+} // namespace
+
+Result<gaReadbackRing*> GaCreateReadbackRing(const gaReadbackRingCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.size == 0)
+    {
+        return "Readback ring size must be greater than zero";
+    }
+
+    if (createInfo.recorder >= createInfo.device->commandRecorders)
+    {
+        return "Readback ring recorder is out of range";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    auto ring = rsbl::UniquePtr(new ReadbackRing());
+    ring->backend = createInfo.device->backend;
+    ring->device = createInfo.device;
+    ring->size = createInfo.size;
+    ring->recorder = createInfo.recorder;
+    ring->queue = createInfo.queue;
+
+    auto buffer = CreateReadbackBuffer(createInfo.device, createInfo.size);
+    if (!buffer)
+    {
+        return PendingFailure{buffer.Category()};
+    }
+    ring->buffer.Reset(buffer.Value());
+    ring->internalHandle = buffer.Value()->handle;
+
+    auto fence = GaCreateFence(createInfo.device);
+    if (!fence)
+    {
+        return PendingFailure{fence.Category()};
+    }
+    ring->ownedFence.Reset(fence.Value());
+    ring->fence = fence.Value();
+    return ring.Release();
+}
+
+void GaDestroyReadbackRing(gaReadbackRing* baseRing)
+{
+    if (baseRing == nullptr)
+    {
+        return;
+    }
+
+    // The buffer can't go while copies into it are running
+    auto ring = static_cast<ReadbackRing*>(baseRing);
+    (void)GaWaitForFence(ring->fence, ring->fence->signalledValue);
+    delete ring;
+}
+
+Result<gaReadbackFuture> GaReadbackAsync(gaReadbackRing* baseRing,
+                                         void* buffer,
+                                         uint64 offset,
+                                         uint64 size)
+{
+    if (baseRing == nullptr || buffer == nullptr)
+    {
+        return "Readback ring and buffer cannot be null";
+    }
+
+    if (size == 0)
+    {
+        return "Readback size must be greater than zero";
+    }
+
+    auto ring = static_cast<ReadbackRing*>(baseRing);
+    auto future = Allocate(ring, size, kBufferOffsetAlignment);
+    if (!future)
+    {
+        return PendingFailure{future.Category()};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    ring->copies.PushBack(
+        {buffer, offset, future.Value().offset, size, gaFormat::Unknown, 0, 0, 0, 0});
+    RSBL_COUNTER_ADD("ga.readbacks", 1);
+    RSBL_COUNTER_ADD("ga.readback_bytes", size);
+    return future;
+}
+
+Result<gaReadbackFuture> GaReadbackAsync(gaReadbackRing* baseRing,
+                                         const gaReadbackTexture& texture)
+{
+    if (baseRing == nullptr || texture.texture == nullptr)
+    {
+        return "Readback ring and texture cannot be null";
+    }
+
+    if (texture.width == 0 || texture.height == 0)
+    {
+        return "Readback texture size must be greater than zero";
+    }
+
+    const uint32 texelSize = TexelSize(texture.format);
+    if (texelSize == 0)
+    {
+        return "Readback texture format can't be read back";
+    }
+
+    auto ring = static_cast<ReadbackRing*>(baseRing);
+    const uint32 rowPitch =
+        static_cast<uint32>(AlignUp(uint64(texture.width) * texelSize, kRowPitchAlignment));
+    auto future = Allocate(ring, uint64(rowPitch) * texture.height, kTextureOffsetAlignment);
+    if (!future)
+    {
+        return PendingFailure{future.Category()};
+    }
+    future.Value().rowPitch = rowPitch;
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    ring->copies.PushBack({texture.texture,
+                           0,
+                           future.Value().offset,
+                           future.Value().size,
+                           texture.format,
+                           texture.width,
+                           texture.height,
+                           rowPitch,
+                           texelSize});
+    if (texture.state != gaResourceState::CopySource)
+    {
+        gaBarrier barrier{};
+        barrier.resource = texture.texture;
+        barrier.before = texture.state;
+        barrier.after = gaResourceState::CopySource;
+        barrier.depth = texture.format == gaFormat::D16Unorm ||
+                        texture.format == gaFormat::D32Float;
+        ring->barriers.PushBack(barrier);
+    }
+    RSBL_COUNTER_ADD("ga.readbacks", 1);
+    RSBL_COUNTER_ADD("ga.readback_bytes", future.Value().size);
+    return future;
+}
+
+Result<> GaFlushReadbacks(gaReadbackRing* baseRing)
+{
+    if (baseRing == nullptr)
+    {
+        return "Readback ring cannot be null";
+    }
+
+    auto ring = static_cast<ReadbackRing*>(baseRing);
+    if (ring->copies.IsEmpty())
+    {
+        return ResultCode::Success;
+    }
+
+    auto list = GaBeginCommandList(ring->device, ring->queue, ring->recorder);
+    if (!list)
+    {
+        return PendingFailure{list.Category()};
+    }
+
+    if (!ring->barriers.IsEmpty())
+    {
+        if (auto recorded = GaCmdBarriers(list.Value(), ring->barriers); !recorded)
+        {
+            return PendingFailure{recorded.Category()};
+        }
+    }
+
+    switch (ring->backend)
+    {
+    case gaBackend::Null:
+        for (const backend::ReadbackCopy& copy : ring->copies)
+        {
+            backend::RecordNullCommand(
+                list.Value(), {gaNullCommandType::Readback, 0, copy.size, copy.source});
+        }
+        break;
+
+    case gaBackend::DX12:
+        backend::RecordDX12ReadbackCopies(list.Value(), ring->buffer.Get(), ring->copies);
+        break;
+
+    case gaBackend::Vulkan:
+        backend::RecordVulkanReadbackCopies(list.Value(), ring->buffer.Get(), ring->copies);
+        break;
+
+    default:
+        break;
+    }
+
+    // And back to the states they were in
+    if (!ring->barriers.IsEmpty())
+    {
+        for (gaBarrier& barrier : ring->barriers)
+        {
+            barrier.after = barrier.before;
+            barrier.before = gaResourceState::CopySource;
+        }
+        if (auto recorded = GaCmdBarriers(list.Value(), ring->barriers); !recorded)
+        {
+            return PendingFailure{recorded.Category()};
+        }
+    }
+
+    gaCommandList* const lists[] = {list.Value()};
+    if (auto ended = GaEndCommandList(list.Value()); !ended)
+    {
+        return PendingFailure{ended.Category()};
+    }
+    if (auto submitted = GaSubmit(ring->device, ring->queue, lists); !submitted)
+    {
+        return PendingFailure{submitted.Category()};
+    }
+
+    gaFence* fence = ring->fence;
+    const uint64 fenceValue = fence->signalledValue + 1;
+    if (auto signalled = GaSignalFence(ring->device, ring->queue, fence, fenceValue);
+        !signalled)
+    {
+        return PendingFailure{signalled.Category()};
+    }
+
+    // Everything queued since the last flush went in this one
+    const uint64 queued = ring->firstSerial + ring->entries.Size();
+    for (uint64 serial = ring->flushedSerial; serial < queued; ++serial)
+    {
+        ring->entries[serial - ring->firstSerial].fenceValue = fenceValue;
+    }
+    ring->flushedSerial = queued;
+    ring->copies.Clear();
+    ring->barriers.Clear();
+    return ResultCode::Success;
+}
+
+bool GaIsReadbackReady(const gaReadbackRing* baseRing, const gaReadbackFuture& future)
+{
+    if (baseRing == nullptr)
+    {
+        return false;
+    }
+
+    auto ring = static_cast<const ReadbackRing*>(baseRing);
+    const ReadbackEntry* entry = FindEntry(ring, future);
+    return entry != nullptr && entry->fenceValue != 0 &&
+           GaGetFenceValue(ring->fence) >= entry->fenceValue;
+}
+
+Result<ByteView> GaGetReadbackData(gaReadbackRing* baseRing,
+                                   const gaReadbackFuture& future,
+                                   bool wait)
+{
+    if (baseRing == nullptr)
+    {
+        return "Readback ring cannot be null";
+    }
+
+    auto ring = static_cast<ReadbackRing*>(baseRing);
+    const ReadbackEntry* entry = FindEntry(ring, future);
+    if (entry == nullptr || entry->released)
+    {
+        return {ErrorCategory::InvalidArgument, "Readback has already been released"};
+    }
+
+    if (entry->fenceValue == 0)
+    {
+        return "Readback hasn't been flushed";
+    }
+
+    if (GaGetFenceValue(ring->fence) < entry->fenceValue)
+    {
+        if (!wait)
+        {
+            return {ErrorCategory::Timeout, "Readback isn't ready yet"};
+        }
+        if (auto waited = GaWaitForFence(ring->fence, entry->fenceValue); !waited)
+        {
+            return PendingFailure{waited.Category()};
+        }
+    }
+    return ByteView(ring->buffer->data + future.offset, future.size);
+}
+
+void GaReleaseReadback(gaReadbackRing* baseRing, const gaReadbackFuture& future)
+{
+    if (baseRing == nullptr)
+    {
+        return;
+    }
+
+    auto ring = static_cast<ReadbackRing*>(baseRing);
+    if (FindEntry(ring, future) != nullptr)
+    {
+        ring->entries[future.serial - ring->firstSerial].released = true;
+        RetireEntries(ring);
+    }
+}
+
+} // namespace rsbl
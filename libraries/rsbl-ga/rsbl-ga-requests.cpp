@@ -0,0 +1,336 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-concurrent-queue.h>
+#include <rsbl-counters.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-profile.h>
+#include <rsbl-ptr.h>
+
+#include <atomic>
+#include <new>
+
+namespace rsbl
+{
+
+namespace
+{
+// A request's record. ready is set once the request is in it, so the drain never runs one that
+// a poster has claimed but not finished writing.
+struct RequestSlot
+{
+    std::atomic<uint32> ready{0};
+    alignas(gaRequest) uint8 request[sizeof(gaRequest)];
+
+    gaRequest* Request()
+    {
+        return std::launder(reinterpret_cast<gaRequest*>(request));
+    }
+};
+
+// Arenas are filled in sequence, arena s being arenas[s & arenaMask]. state is the sequence it's
+// being filled as in the top half and how many of its records are claimed in the bottom half, in
+// one word so a claim can't land in an arena the drain has since given back for a later
+// sequence.
+struct RequestArena
+{
+    alignas(kCacheLineSize) std::atomic<uint64> state{0};
+    RequestSlot* slots = nullptr;
+};
+
+uint64 ArenaState(uint32 sequence, uint32 claimed)
+{
+    return (uint64(sequence) << 32) | claimed;
+}
+
+uint32 StateSequence(uint64 state)
+{
+    return static_cast<uint32>(state >> 32);
+}
+
+uint32 StateClaimed(uint64 state)
+{
+    return static_cast<uint32>(state);
+}
+
+struct RequestQueue : public gaRequestQueue
+{
+    uint32 requestsPerArena = 0;
+    uint32 arenaMask = 0;
+    RequestArena* arenas = nullptr;
+    RequestSlot* slots = nullptr;
+
+    // The sequence posts go to, moved on by the poster that finds its arena full, or the drain
+    // that empties it
+    alignas(kCacheLineSize) std::atomic<uint32> tail{0};
+
+    // The drain's place. Only touched by the owner's thread.
+    alignas(kCacheLineSize) uint32 head = 0;
+    uint32 position = 0;
+
+    RequestQueue() = default;
+    RequestQueue(const RequestQueue&) = delete;
+    RequestQueue& operator=(const RequestQueue&) = delete;
+
+    ~RequestQueue() override
+    {
+        delete[] slots;
+        delete[] arenas;
+    }
+};
+
+Result<> RunRequests(RequestQueue* queue, uint32& ran)
+{
+    // Only what was posted before the drain, so a request that posts another can't keep it going
+    const uint32 endSequence = queue->tail.load(std::memory_order_acquire);
+    const uint32 endPosition = StateClaimed(
+        queue->arenas[endSequence & queue->arenaMask].state.load(std::memory_order_acquire));
+
+    for (;;)
+    {
+        RequestArena& arena = queue->arenas[queue->head & queue->arenaMask];
+        const uint32 claimed = queue->head == endSequence
+                                   ? endPosition
+                                   : StateClaimed(arena.state.load(std::memory_order_acquire));
+        while (queue->position < claimed)
+        {
+            RequestSlot& slot = arena.slots[queue->position];
+            if (slot.ready.load(std::memory_order_acquire) == 0)
+            {
+                return ResultCode::Success;
+            }
+
+            ++queue->position;
+            ++ran;
+            Result<> result = (*slot.Request())(queue);
+            slot.Request()->~gaRequest();
+            slot.ready.store(0, std::memory_order_relaxed);
+            if (!result)
+            {
+                return PendingFailure{result.Category()};
+            }
+        }
+
+        // A full arena is given back once posts have moved on from it, as the sequence arenas
+        // from now, and the drain moves on with them
+        if (queue->position < queue->requestsPerArena)
+        {
+            return ResultCode::Success;
+        }
+
+        // Posts may still be on the last arena, full as it is, when nothing's been posted since.
+        // They're moved on as a full post would, or it would only be given back once they had,
+        // and until then counted as waiting to be drained. Nothing after it is run.
+        const bool last = queue->head == endSequence;
+        if (last && queue->tail.load(std::memory_order_acquire) == queue->head)
+        {
+            const uint32 nextSequence = queue->head + 1;
+            const RequestArena& next = queue->arenas[nextSequence & queue->arenaMask];
+            if (StateSequence(next.state.load(std::memory_order_acquire)) != nextSequence)
+            {
+                return ResultCode::Success;
+            }
+            uint32 expected = queue->head;
+            queue->tail.compare_exchange_strong(
+                expected, nextSequence, std::memory_order_acq_rel, std::memory_order_relaxed);
+        }
+
+        arena.state.store(ArenaState(queue->head + queue->arenaMask + 1, 0),
+                          std::memory_order_release);
+        ++queue->head;
+        queue->position = 0;
+        if (last)
+        {
+            return ResultCode::Success;
+        }
+    }
+}
+} // namespace
+
+Result<gaRequestQueue*> GaCreateRequestQueue(const gaRequestQueueCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.requestsPerArena == 0 || createInfo.arenas < 2 ||
+        createInfo.arenas > (1u << 16))
+    {
+        return "A request queue needs requests in its arenas, and 2 to 65536 arenas";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    // A power of two, so sequences wrapping round still map to the same arenas
+    const uint32 arenaCount = static_cast<uint32>(NextPowerOfTwo(createInfo.arenas));
+
+    auto queue = rsbl::UniquePtr(new RequestQueue());
+    queue->device = createInfo.device;
+    queue->uploads = createInfo.uploads;
+    queue->requestsPerArena = createInfo.requestsPerArena;
+    queue->arenaMask = arenaCount - 1;
+    queue->arenas = new RequestArena[arenaCount];
+    queue->slots = new RequestSlot[uint64(arenaCount) * createInfo.requestsPerArena];
+    for (uint32 i = 0; i < arenaCount; ++i)
+    {
+        queue->arenas[i].state.store(ArenaState(i, 0), std::memory_order_relaxed);
+        queue->arenas[i].slots = queue->slots + uint64(i) * createInfo.requestsPerArena;
+    }
+    return queue.Release();
+}
+
+void GaDestroyRequestQueue(gaRequestQueue* baseQueue)
+{
+    if (baseQueue == nullptr)
+    {
+        return;
+    }
+
+    // A failure only stops the drain it's in, so this gets through them all
+    auto queue = static_cast<RequestQueue*>(baseQueue);
+    for (uint32 ran = 1; ran > 0;)
+    {
+        ran = 0;
+        (void)RunRequests(queue, ran);
+    }
+    if (queue->uploads != nullptr)
+    {
+        (void)GaFlushUploads(queue->uploads);
+    }
+    delete queue;
+}
+
+Result<> GaPostRequest(gaRequestQueue* baseQueue, gaRequest&& request)
+{
+    if (baseQueue == nullptr)
+    {
+        return "Request queue cannot be null";
+    }
+
+    // Captures too big for a record spill into the function pool
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    auto queue = static_cast<RequestQueue*>(baseQueue);
+    for (;;)
+    {
+        const uint32 sequence = queue->tail.load(std::memory_order_acquire);
+        RequestArena& arena = queue->arenas[sequence & queue->arenaMask];
+        uint64 state = arena.state.load(std::memory_order_acquire);
+        if (StateSequence(state) != sequence)
+        {
+            // Drained and given back since tail was read, so tail has moved on
+            continue;
+        }
+
+        const uint32 claimed = StateClaimed(state);
+        if (claimed < queue->requestsPerArena)
+        {
+            if (arena.state.compare_exchange_weak(
+                    state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                RequestSlot& slot = arena.slots[claimed];
+                new (slot.request) gaRequest(rsblMove(request));
+                slot.ready.store(1, std::memory_order_release);
+                return ResultCode::Success;
+            }
+            continue;
+        }
+
+        // Full. The next arena can be filled once the drain has given it back for the sequence
+        // after this one.
+        const uint32 nextSequence = sequence + 1;
+        const uint64 nextState =
+            queue->arenas[nextSequence & queue->arenaMask].state.load(std::memory_order_acquire);
+        if (StateSequence(nextState) != nextSequence)
+        {
+            if (queue->tail.load(std::memory_order_acquire) != sequence)
+            {
+                continue;
+            }
+            return {ErrorCategory::OutOfMemory, "Request queue is full, every arena is waiting "
+                                                "to be drained"};
+        }
+        uint32 expected = sequence;
+        queue->tail.compare_exchange_strong(
+            expected, nextSequence, std::memory_order_acq_rel, std::memory_order_relaxed);
+    }
+}
+
+Result<> GaPostUpload(gaRequestQueue* queue,
+                      void* destination,
+                      uint64 destinationOffset,
+                      DynamicArray<uint8>&& bytes)
+{
+    if (queue == nullptr || destination == nullptr)
+    {
+        return "Request queue and destination cannot be null";
+    }
+
+    if (queue->uploads == nullptr)
+    {
+        return "Request queue has no upload ring";
+    }
+
+    if (bytes.IsEmpty())
+    {
+        return ResultCode::Success;
+    }
+
+    // The bytes go with the request, and are freed on the owner's thread along with it
+    return GaPostRequest(
+        queue,
+        [destination, destinationOffset, bytes = rsblMove(bytes)](gaRequestQueue* requests) {
+            return GaUploadBuffer(requests->uploads, destination, destinationOffset, bytes);
+        });
+}
+
+Result<> GaPostDestroy(gaRequestQueue* queue, void* object, gaDestroyFunction destroy)
+{
+    if (queue == nullptr || destroy == nullptr)
+    {
+        return "Request queue and destroy function cannot be null";
+    }
+
+    if (object == nullptr)
+    {
+        return ResultCode::Success;
+    }
+
+    return GaPostRequest(queue, [object, destroy](gaRequestQueue* requests) {
+        return GaDeferDestroy(requests->device, object, destroy);
+    });
+}
+
+Result<uint32> GaDrainRequests(gaRequestQueue* baseQueue)
+{
+    RSBL_PROFILE_ZONE("GaDrainRequests");
+    if (baseQueue == nullptr)
+    {
+        return "Request queue cannot be null";
+    }
+
+    auto queue = static_cast<RequestQueue*>(baseQueue);
+    uint32 ran = 0;
+    Result<> result = RunRequests(queue, ran);
+    RSBL_COUNTER_ADD("ga.requests", ran);
+
+    // What was uploaded before a failure still goes out
+    if (queue->uploads != nullptr)
+    {
+        if (auto flushed = GaFlushUploads(queue->uploads); !flushed && result)
+        {
+            return PendingFailure{flushed.Category()};
+        }
+    }
+    if (!result)
+    {
+        return PendingFailure{result.Category()};
+    }
+    return ran;
+}
+
+} // namespace rsbl
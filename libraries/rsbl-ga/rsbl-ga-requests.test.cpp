@@ -0,0 +1,239 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-ga.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint32 kThreadCount = 4;
+constexpr uint32 kPostsPerThread = 20000;
+
+// Small arenas, so a few posts are enough to fill them and wrap round
+struct Fixture
+{
+    gaDevice* device = nullptr;
+    gaRequestQueue* queue = nullptr;
+
+    Fixture()
+    {
+        device = GaCreateDevice({}).Value();
+        REQUIRE(GaBeginFrame(device));
+    }
+
+    ~Fixture()
+    {
+        GaDestroyRequestQueue(queue);
+        GaDestroyDevice(device);
+    }
+
+    void CreateQueue(uint32 requestsPerArena, uint32 arenas)
+    {
+        gaRequestQueueCreateInfo createInfo;
+        createInfo.device = device;
+        createInfo.requestsPerArena = requestsPerArena;
+        createInfo.arenas = arenas;
+        auto created = GaCreateRequestQueue(createInfo);
+        REQUIRE(created);
+        queue = created.Value();
+    }
+
+    // A request that adds value to order when it runs
+    Result<> PostOrdered(DynamicArray<uint32>& order, uint32 value)
+    {
+        return GaPostRequest(queue, [&order, value](gaRequestQueue*) -> Result<> {
+            order.PushBack(value);
+            return ResultCode::Success;
+        });
+    }
+
+    uint32 Drain()
+    {
+        auto drained = GaDrainRequests(queue);
+        REQUIRE(drained);
+        return drained.Value();
+    }
+};
+} // namespace
+
+TEST_SUITE("rsbl::gaRequestQueue")
+{
+    TEST_CASE_FIXTURE(Fixture, "Requests run in the order they were posted as the arenas wrap")
+    {
+        CreateQueue(4, 2);
+
+        // 6 at a time into 8 records, so drains stop partway through an arena and posts move on
+        // into arenas given back for later sequences
+        DynamicArray<uint32> order;
+        uint32 posted = 0;
+        for (uint32 round = 0; round < 10; ++round)
+        {
+            for (uint32 i = 0; i < 6; ++i)
+            {
+                REQUIRE(PostOrdered(order, posted++));
+            }
+            CHECK(Drain() == 6);
+        }
+
+        REQUIRE(order.Size() == posted);
+        for (uint32 i = 0; i < posted; ++i)
+        {
+            CHECK(order[i] == i);
+        }
+        CHECK(Drain() == 0);
+    }
+
+    TEST_CASE_FIXTURE(Fixture, "Posting fails with OutOfMemory while every arena waits for a drain")
+    {
+        CreateQueue(4, 2);
+
+        DynamicArray<uint32> order;
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            REQUIRE(PostOrdered(order, i));
+        }
+        Result<> full = PostOrdered(order, 8);
+        CHECK_FALSE(full);
+        CHECK(full.Category() == ErrorCategory::OutOfMemory);
+
+        // The request that didn't fit was never taken
+        CHECK(Drain() == 8);
+        CHECK(order.Size() == 8);
+
+        REQUIRE(PostOrdered(order, 8));
+        CHECK(Drain() == 1);
+        CHECK(order.Size() == 9);
+        CHECK(order[8] == 8);
+    }
+
+    TEST_CASE_FIXTURE(Fixture, "A request posted by a request runs in the next drain")
+    {
+        CreateQueue(4, 2);
+
+        // From the start of an arena, and from its last record, so the post lands in the next
+        DynamicArray<uint32> order;
+        for (uint32 before : {0u, 3u})
+        {
+            order.Clear();
+            for (uint32 i = 0; i < before; ++i)
+            {
+                REQUIRE(PostOrdered(order, i));
+            }
+            REQUIRE(GaPostRequest(queue, [&order](gaRequestQueue* requests) -> Result<> {
+                order.PushBack(100);
+                return GaPostRequest(requests, [&order](gaRequestQueue*) -> Result<> {
+                    order.PushBack(200);
+                    return ResultCode::Success;
+                });
+            }));
+
+            CHECK(Drain() == before + 1);
+            REQUIRE(order.Size() == before + 1);
+            CHECK(order[before] == 100);
+
+            CHECK(Drain() == 1);
+            REQUIRE(order.Size() == before + 2);
+            CHECK(order[before + 1] == 200);
+        }
+    }
+
+    TEST_CASE_FIXTURE(Fixture, "Requests from several threads at once each run exactly once")
+    {
+        CreateQueue(64, 4);
+
+        // Only the requests touch these, on the draining thread
+        DynamicArray<uint32> runs;
+        runs.Resize(kThreadCount * kPostsPerThread);
+        DynamicArray<uint32> lastRun;
+        lastRun.Resize(kThreadCount);
+        uint32 outOfOrder = 0;
+
+        std::atomic<uint32> finished{0};
+        std::atomic<uint32> failures{0};
+        std::thread threads[kThreadCount];
+        for (uint32 t = 0; t < kThreadCount; ++t)
+        {
+            threads[t] = std::thread([&, t]() {
+                for (uint32 i = 0; i < kPostsPerThread; ++i)
+                {
+                    auto request = [&runs, &lastRun, &outOfOrder, t, i](gaRequestQueue*) {
+                        ++runs[t * kPostsPerThread + i];
+                        outOfOrder += i > 0 && lastRun[t] != i - 1;
+                        lastRun[t] = i;
+                        return Result<>(ResultCode::Success);
+                    };
+                    // The queue is much smaller than what's posted, so it fills up and waits for
+                    // the drain
+                    Result<> posted = GaPostRequest(queue, request);
+                    while (!posted && posted.Category() == ErrorCategory::OutOfMemory)
+                    {
+                        std::this_thread::yield();
+                        posted = GaPostRequest(queue, request);
+                    }
+                    failures.fetch_add(!posted, std::memory_order_relaxed);
+                }
+                finished.fetch_add(1, std::memory_order_release);
+            });
+        }
+
+        uint64 ran = 0;
+        while (finished.load(std::memory_order_acquire) < kThreadCount)
+        {
+            ran += Drain();
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        ran += Drain();
+
+        CHECK(failures.load() == 0);
+        CHECK(ran == kThreadCount * kPostsPerThread);
+        CHECK(outOfOrder == 0);
+        uint32 wrong = 0;
+        for (const uint32 count : runs)
+        {
+            wrong += count != 1;
+        }
+        CHECK(wrong == 0);
+    }
+
+    TEST_CASE_FIXTURE(Fixture, "Destroying the queue runs what's still posted")
+    {
+        CreateQueue(4, 2);
+
+        // Through a failure, which only stops the drain it's in, and a request posting another
+        DynamicArray<uint32> order;
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            REQUIRE(PostOrdered(order, i));
+        }
+        REQUIRE(GaPostRequest(queue, [](gaRequestQueue*) -> Result<> {
+            return "Failed on purpose";
+        }));
+        REQUIRE(GaPostRequest(queue, [&order](gaRequestQueue* requests) -> Result<> {
+            order.PushBack(3);
+            return GaPostRequest(requests, [&order](gaRequestQueue*) -> Result<> {
+                order.PushBack(5);
+                return ResultCode::Success;
+            });
+        }));
+        REQUIRE(PostOrdered(order, 4));
+
+        GaDestroyRequestQueue(queue);
+        queue = nullptr;
+
+        REQUIRE(order.Size() == 6);
+        for (uint32 i = 0; i < 6; ++i)
+        {
+            CHECK(order[i] == i);
+        }
+    }
+}
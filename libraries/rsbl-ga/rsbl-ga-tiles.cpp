@@ -0,0 +1,328 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+namespace rsbl
+{
+
+namespace
+{
+// Free tiles are a stack, so the tiles freed last, in heaps already in use, go out first
+struct TilePool : public gaTilePool
+{
+    bool textures = true;
+    DynamicArray<UniquePtr<gaMemoryHeap>> heapList;
+    DynamicArray<gaTile> freeTiles;
+};
+
+Result<gaMemoryHeap*> CreateTileHeap(gaDevice* device, uint64 size, bool textures)
+{
+    Result<gaMemoryHeap*> heap = "Unknown graphics backend";
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        heap = backend::CreateNullMemoryHeap(device, gaMemoryType::DeviceLocal, size, kGaTileSize);
+        break;
+
+    case gaBackend::DX12:
+        heap = backend::CreateDX12TileHeap(device, size, textures);
+        break;
+
+    case gaBackend::Vulkan:
+        heap =
+            backend::CreateVulkanMemoryHeap(device, gaMemoryType::DeviceLocal, size, kGaTileSize);
+        break;
+
+    default:
+        break;
+    }
+    if (heap)
+    {
+        heap.Value()->type = gaMemoryType::DeviceLocal;
+        heap.Value()->size = size;
+    }
+    return heap;
+}
+
+uint32 TilesAcross(uint32 texels, uint32 tileTexels)
+{
+    return (texels + tileTexels - 1) / tileTexels;
+}
+
+bool IsValidTile(const gaReservedResource* resource, const gaTileCoordinate& tile)
+{
+    if (tile.mip == resource->standardMips)
+    {
+        return tile.x < resource->mipTailTiles && tile.y == 0;
+    }
+
+    if (tile.mip > resource->standardMips)
+    {
+        return false;
+    }
+
+    const uint32 width = resource->width >> tile.mip;
+    const uint32 height = resource->height >> tile.mip;
+    return tile.x < TilesAcross(width > 0 ? width : 1, resource->tileWidth) &&
+           tile.y < TilesAcross(height > 0 ? height : 1, resource->tileHeight);
+}
+} // namespace
+
+namespace backend
+{
+    bool StandardTileShape(gaFormat format, uint32& width, uint32& height)
+    {
+        // Both APIs' standard shapes, widest first as texels get bigger
+        switch (format)
+        {
+        case gaFormat::R8G8B8A8Unorm:
+        case gaFormat::R8G8B8A8Srgb:
+        case gaFormat::B8G8R8A8Unorm:
+        case gaFormat::B8G8R8A8Srgb:
+        case gaFormat::R8G8B8A8Uint:
+        case gaFormat::R10G10B10A2Unorm:
+        case gaFormat::R11G11B10Float:
+        case gaFormat::R16G16Float:
+        case gaFormat::R32Float:
+        case gaFormat::R32Uint:
+            width = 128;
+            height = 128;
+            return true;
+
+        case gaFormat::R16G16B16A16Float:
+        case gaFormat::R16G16B16A16Unorm:
+        case gaFormat::R32G32Float:
+            width = 128;
+            height = 64;
+            return true;
+
+        case gaFormat::R32G32B32A32Float:
+            width = 64;
+            height = 64;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+} // namespace backend
+
+Result<gaReservedResource*> GaCreateReservedResource(const gaReservedResourceCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (!createInfo.device->reservedResources)
+    {
+        return {ErrorCategory::NotFound, "The device has no reserved resources"};
+    }
+
+    const bool texture = createInfo.size == 0;
+    uint32 tileWidth = 0;
+    uint32 tileHeight = 0;
+    if (texture)
+    {
+        const uint32 largest = createInfo.width > createInfo.height ? createInfo.width
+                                                                      : createInfo.height;
+        if (createInfo.width == 0 || createInfo.height == 0 || createInfo.mips == 0 ||
+            createInfo.mips > 32 || largest >> (createInfo.mips - 1) == 0)
+        {
+            return {ErrorCategory::InvalidArgument,
+                    "Reserved textures need a size and mips down to no smaller than 1x1"};
+        }
+        if (!backend::StandardTileShape(createInfo.format, tileWidth, tileHeight))
+        {
+            return {ErrorCategory::InvalidArgument, "The format has no standard tile shape"};
+        }
+    }
+    else if ((createInfo.size + kGaTileSize - 1) / kGaTileSize > ~0u)
+    {
+        return {ErrorCategory::InvalidArgument, "Reserved buffers are up to 2^32 tiles"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    Result<gaReservedResource*> resource = "Unknown graphics backend";
+    switch (createInfo.device->backend)
+    {
+    case gaBackend::Null:
+        resource = backend::CreateNullReservedResource(createInfo);
+        break;
+
+    case gaBackend::DX12:
+        resource = backend::CreateDX12ReservedResource(createInfo);
+        break;
+
+    case gaBackend::Vulkan:
+        resource = backend::CreateVulkanReservedResource(createInfo);
+        break;
+
+    default:
+        break;
+    }
+    if (!resource)
+    {
+        return resource;
+    }
+
+    gaReservedResource* created = resource.Value();
+    created->device = createInfo.device;
+    created->texture = texture;
+    if (texture)
+    {
+        created->width = createInfo.width;
+        created->height = createInfo.height;
+        created->mips = createInfo.mips;
+    }
+    else
+    {
+        created->width = static_cast<uint32>((createInfo.size + kGaTileSize - 1) / kGaTileSize);
+        created->height = 1;
+        created->mips = 1;
+        created->tileWidth = 1;
+        created->tileHeight = 1;
+        created->standardMips = 1;
+        created->mipTailTiles = 0;
+        created->tileCount = created->width;
+    }
+    return created;
+}
+
+void GaDestroyReservedResource(gaReservedResource* resource)
+{
+    delete resource;
+}
+
+Result<gaTilePool*> GaCreateTilePool(const gaTilePoolCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.tilesPerHeap == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Tiles per heap must be greater than zero"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    auto pool = rsbl::UniquePtr(new TilePool());
+    pool->device = createInfo.device;
+    pool->tilesPerHeap = createInfo.tilesPerHeap;
+    pool->heaps = 0;
+    pool->allocatedTiles = 0;
+    pool->textures = createInfo.textures;
+    return pool.Release();
+}
+
+void GaDestroyTilePool(gaTilePool* pool)
+{
+    delete static_cast<TilePool*>(pool);
+}
+
+Result<gaTile> GaAllocateTile(gaTilePool* basePool)
+{
+    if (basePool == nullptr)
+    {
+        return "Tile pool cannot be null";
+    }
+
+    auto pool = static_cast<TilePool*>(basePool);
+    if (pool->freeTiles.IsEmpty())
+    {
+        MemoryTagScope memoryScope(MemoryTag::Ga);
+
+        auto heap = CreateTileHeap(pool->device, pool->tilesPerHeap * kGaTileSize, pool->textures);
+        if (!heap)
+        {
+            return PendingFailure{heap.Category()};
+        }
+        pool->heapList.PushBack(UniquePtr(heap.Value()));
+        ++pool->heaps;
+
+        // Backwards, so the heap's tiles go out front to back
+        pool->freeTiles.Reserve(pool->tilesPerHeap);
+        for (uint32 index = pool->tilesPerHeap; index > 0; --index)
+        {
+            pool->freeTiles.PushBack({heap.Value(), index - 1});
+        }
+    }
+
+    const gaTile tile = pool->freeTiles[pool->freeTiles.Size() - 1];
+    pool->freeTiles.PopBack();
+    ++pool->allocatedTiles;
+    return tile;
+}
+
+void GaFreeTile(gaTilePool* basePool, const gaTile& tile)
+{
+    if (basePool == nullptr || tile.heap == nullptr)
+    {
+        return;
+    }
+
+    auto pool = static_cast<TilePool*>(basePool);
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    pool->freeTiles.PushBack(tile);
+    --pool->allocatedTiles;
+}
+
+Result<> GaUpdateTileMappings(gaDevice* device, ArrayView<const gaTileMapping> mappings)
+{
+    if (device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    for (const gaTileMapping& mapping : mappings)
+    {
+        if (mapping.resource == nullptr || mapping.resource->device != device)
+        {
+            return {ErrorCategory::InvalidArgument, "Tiles are mapped in the device's resources"};
+        }
+
+        if (!IsValidTile(mapping.resource, mapping.tile))
+        {
+            return {ErrorCategory::InvalidArgument, "The tile is outside the resource"};
+        }
+
+        if (mapping.memory.heap != nullptr &&
+            (mapping.memory.heap->backend != device->backend ||
+             (mapping.memory.index + uint64(1)) * kGaTileSize > mapping.memory.heap->size))
+        {
+            return {ErrorCategory::InvalidArgument, "Tiles are mapped to tiles of tile pools"};
+        }
+    }
+
+    if (mappings.IsEmpty())
+    {
+        return ResultCode::Success;
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::UpdateDX12TileMappings(device, mappings);
+
+    case gaBackend::Vulkan:
+        return backend::UpdateVulkanTileMappings(device, mappings);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+} // namespace rsbl
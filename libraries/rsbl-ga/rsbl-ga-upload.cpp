@@ -0,0 +1,302 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-ga-backends.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-counters.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-ptr.h>
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+// A flush: the GPU is done with the ring up to end once the fence reaches fenceValue
+struct UploadBatch
+{
+    uint64 end;
+    uint64 fenceValue;
+};
+
+// Positions count bytes handed out since the ring was created, the offset in the buffer is the
+// position modulo its size
+struct UploadRing : public gaUploadRing
+{
+    UniquePtr<backend::UploadBuffer> buffer;
+    UniquePtr<gaFence> ownedFence; // gaUploadRing::fence
+    uint32 recorder = 0;
+
+    uint64 head = 0; // Handed out
+    uint64 tail = 0; // The GPU is done with everything before
+
+    DynamicArray<UploadBatch> batches;
+    uint64 retiredBatches = 0; // batches before this are done
+    DynamicArray<backend::BufferCopy> copies;
+};
+
+// Gives back the oldest flush's space, waiting for the GPU when wait is set. False when there's
+// nothing to give back.
+Result<bool> RetireBatch(UploadRing* ring, bool wait)
+{
+    if (ring->retiredBatches == ring->batches.Size())
+    {
+        return false;
+    }
+
+    const UploadBatch batch = ring->batches[ring->retiredBatches];
+    if (GaGetFenceValue(ring->fence) < batch.fenceValue)
+    {
+        if (!wait)
+        {
+            return false;
+        }
+        if (auto waited = GaWaitForFence(ring->fence, batch.fenceValue); !waited)
+        {
+            return PendingFailure{waited.Category()};
+        }
+    }
+
+    ring->tail = batch.end;
+    if (++ring->retiredBatches == ring->batches.Size())
+    {
+        ring->batches.Clear();
+        ring->retiredBatches = 0;
+    }
+    return true;
+}
+
+Result<backend::UploadBuffer*> CreateUploadBuffer(gaDevice* device, uint64 size)
+{
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullUploadBuffer(device, size);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12UploadBuffer(device, size);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanUploadBuffer(device, size);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+} // namespace
+
+Result<gaUploadRing*> GaCreateUploadRing(const gaUploadRingCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.size == 0)
+    {
+        return "Upload ring size must be greater than zero";
+    }
+
+    if (createInfo.recorder >= createInfo.device->commandRecorders)
+    {
+        return "Upload ring recorder is out of range";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    auto ring = rsbl::UniquePtr(new UploadRing());
+    ring->backend = createInfo.device->backend;
+    ring->device = createInfo.device;
+    ring->size = createInfo.size;
+    ring->recorder = createInfo.recorder;
+    ring->queue = createInfo.queue;
+
+    auto buffer = CreateUploadBuffer(createInfo.device, createInfo.size);
+    if (!buffer)
+    {
+        return PendingFailure{buffer.Category()};
+    }
+    ring->buffer.Reset(buffer.Value());
+    ring->internalHandle = buffer.Value()->handle;
+
+    auto fence = GaCreateFence(createInfo.device);
+    if (!fence)
+    {
+        return PendingFailure{fence.Category()};
+    }
+    ring->ownedFence.Reset(fence.Value());
+    ring->fence = fence.Value();
+    return ring.Release();
+}
+
+void GaDestroyUploadRing(gaUploadRing* baseRing)
+{
+    if (baseRing == nullptr)
+    {
+        return;
+    }
+
+    // The buffer can't go while copies out of it are running
+    auto ring = static_cast<UploadRing*>(baseRing);
+    (void)GaWaitForFence(ring->fence, ring->fence->signalledValue);
+    delete ring;
+}
+
+Result<gaUploadAllocation> GaAllocateUpload(gaUploadRing* baseRing, uint64 size, uint64 alignment)
+{
+    if (baseRing == nullptr)
+    {
+        return "Upload ring cannot be null";
+    }
+
+    if (size == 0 || !IsPowerOfTwo(alignment))
+    {
+        return "Upload size must be greater than zero, and alignment a power of two";
+    }
+
+    auto ring = static_cast<UploadRing*>(baseRing);
+    if (size > ring->size)
+    {
+        return "Upload is bigger than the ring";
+    }
+
+    // Allocations don't wrap: one that would run off the end starts over at the front
+    uint64 lap = ring->head - ring->head % ring->size;
+    uint64 offset = AlignUp(ring->head - lap, alignment);
+    if (offset > ring->size - size)
+    {
+        lap += ring->size;
+        offset = 0;
+    }
+    const uint64 end = lap + offset + size;
+
+    // Take back what the GPU is done with, and then wait for the rest
+    bool wait = false;
+    while (end - ring->tail > ring->size)
+    {
+        Result<bool> retired = RetireBatch(ring, wait);
+        if (!retired)
+        {
+            return PendingFailure{retired.Category()};
+        }
+        if (!retired.Value())
+        {
+            if (wait)
+            {
+                return "Upload ring is full of data that hasn't been flushed";
+            }
+            wait = true;
+        }
+    }
+
+    ring->head = end;
+    return gaUploadAllocation{ring->buffer->data + offset, offset, size};
+}
+
+Result<> GaQueueBufferUpload(gaUploadRing* baseRing,
+                             void* destination,
+                             uint64 destinationOffset,
+                             const gaUploadAllocation& source)
+{
+    if (baseRing == nullptr || destination == nullptr)
+    {
+        return "Upload ring and destination cannot be null";
+    }
+
+    auto ring = static_cast<UploadRing*>(baseRing);
+    if (source.offset > ring->size || source.size > ring->size - source.offset)
+    {
+        return "Upload source isn't in the ring";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    ring->copies.PushBack({destination, destinationOffset, source.offset, source.size});
+    RSBL_COUNTER_ADD("ga.uploads", 1);
+    RSBL_COUNTER_ADD("ga.upload_bytes", source.size);
+    return ResultCode::Success;
+}
+
+Result<> GaUploadBuffer(gaUploadRing* ring,
+                        void* destination,
+                        uint64 destinationOffset,
+                        ArrayView<const uint8> bytes)
+{
+    auto staging = GaAllocateUpload(ring, bytes.Size(), 16);
+    if (!staging)
+    {
+        return PendingFailure{staging.Category()};
+    }
+    memcpy(staging.Value().data, bytes.Data(), bytes.Size());
+    return GaQueueBufferUpload(ring, destination, destinationOffset, staging.Value());
+}
+
+Result<> GaFlushUploads(gaUploadRing* baseRing)
+{
+    if (baseRing == nullptr)
+    {
+        return "Upload ring cannot be null";
+    }
+
+    auto ring = static_cast<UploadRing*>(baseRing);
+    if (ring->copies.IsEmpty())
+    {
+        return ResultCode::Success;
+    }
+
+    auto list = GaBeginCommandList(ring->device, ring->queue, ring->recorder);
+    if (!list)
+    {
+        return PendingFailure{list.Category()};
+    }
+
+    switch (ring->backend)
+    {
+    case gaBackend::Null:
+        for (const backend::BufferCopy& copy : ring->copies)
+        {
+            backend::RecordNullCommand(
+                list.Value(), {gaNullCommandType::Upload, 0, copy.size, copy.destination});
+        }
+        break;
+
+    case gaBackend::DX12:
+        backend::RecordDX12BufferCopies(list.Value(), ring->buffer.Get(), ring->copies);
+        break;
+
+    case gaBackend::Vulkan:
+        backend::RecordVulkanBufferCopies(list.Value(), ring->buffer.Get(), ring->copies);
+        break;
+
+    default:
+        break;
+    }
+
+    gaCommandList* const lists[] = {list.Value()};
+    if (auto ended = GaEndCommandList(list.Value()); !ended)
+    {
+        return PendingFailure{ended.Category()};
+    }
+    if (auto submitted = GaSubmit(ring->device, ring->queue, lists); !submitted)
+    {
+        return PendingFailure{submitted.Category()};
+    }
+
+    gaFence* fence = ring->fence;
+    const uint64 fenceValue = fence->signalledValue + 1;
+    if (auto signalled = GaSignalFence(ring->device, ring->queue, fence, fenceValue);
+        !signalled)
+    {
+        return PendingFailure{signalled.Category()};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    ring->batches.PushBack({ring->head, fenceValue});
+    ring->copies.Clear();
+    return ResultCode::Success;
+}
+
+} // namespace rsbl
@@ -18,5 +18,300 @@ Result<gaSwapchain*> CreateVulkanSwapchain(const gaSwapchainCreateInfo& createIn
 	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
 }
 
+Result<> WaitForVulkanSwapchain(gaSwapchain* swapchain, uint32 timeoutMs)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> PresentVulkan(gaSwapchain* swapchain)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> GetVulkanPresentStats(gaSwapchain* swapchain, gaPresentStats& presentStats)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> BeginVulkanFrame(gaDevice* device)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> WaitForVulkanIdle(gaDevice* device)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaCommandList*> BeginVulkanCommandList(gaDevice* device, gaQueueType queue, uint32 recorder)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> EndVulkanCommandList(gaCommandList* list)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> SubmitVulkan(gaDevice* device, gaQueueType queue, ArrayView<gaCommandList* const> lists)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<TimestampHeap*> CreateVulkanTimestampHeap(gaDevice* device,
+                                                 gaQueueType queue,
+                                                 uint32 count)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+void WriteVulkanTimestamp(gaCommandList* list, TimestampHeap* heap, uint32 index)
+{
+}
+
+Result<> ReadVulkanTimestamps(TimestampHeap* heap, uint32 first, uint32 count, uint64* out)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+void ResetVulkanTimestamps(TimestampHeap* heap, uint32 first, uint32 count)
+{
+}
+
+Result<gaClockCalibration> GetVulkanClockCalibration(gaDevice* device, gaQueueType queue)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> EnumerateVulkanAdapters(DynamicArray<gaAdapterInfo>& adapters)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+void RecordVulkanBufferCopy(gaCommandList* list,
+                            void* destination,
+                            uint64 destinationOffset,
+                            void* source,
+                            uint64 sourceOffset,
+                            uint64 size)
+{
+}
+
+void RecordVulkanIndirectDraws(gaCommandList* list,
+                               void* arguments,
+                               uint64 argumentOffset,
+                               uint32 maxDraws,
+                               void* count,
+                               uint64 countOffset)
+{
+}
+
+void RecordVulkanMeshDispatch(gaCommandList* list,
+                              uint32 groupsX,
+                              uint32 groupsY,
+                              uint32 groupsZ)
+{
+}
+
+void RecordVulkanPushConstants(gaCommandList* list,
+                               const gaPipeline* pipeline,
+                               uint32 offset,
+                               uint32 size,
+                               const void* data)
+{
+}
+
+void RecordVulkanShadingRate(gaCommandList* list, gaShadingRate rate, void* rateImage)
+{
+}
+
+Result<Breadcrumbs*> CreateVulkanBreadcrumbs(gaDevice* device, uint32 slots)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+void WriteVulkanBreadcrumb(gaCommandList* list,
+                           Breadcrumbs* breadcrumbs,
+                           uint32 slot,
+                           uint32 marker)
+{
+}
+
+Result<gaFence*> CreateVulkanFence(gaDevice* device, uint64 initialValue)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> SignalVulkanFence(gaDevice* device, gaQueueType queue, gaFence* fence, uint64 value)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> QueueWaitForVulkanFence(gaDevice* device,
+                                 gaQueueType queue,
+                                 gaFence* fence,
+                                 uint64 value)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+uint64 GetVulkanFenceValue(gaFence* fence)
+{
+	return 0;
+}
+
+Result<> WaitForVulkanFence(gaFence* fence, uint64 value)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaMemoryHeap*> CreateVulkanMemoryHeap(gaDevice* device,
+                                             gaMemoryType type,
+                                             uint64 size,
+                                             uint64 alignment)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaReservedResource*> CreateVulkanReservedResource(
+    const gaReservedResourceCreateInfo& createInfo)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> UpdateVulkanTileMappings(gaDevice* device, ArrayView<const gaTileMapping> mappings)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaMemoryBudget> QueryVulkanMemoryBudget(gaDevice* device)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<UploadBuffer*> CreateVulkanUploadBuffer(gaDevice* device, uint64 size)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+void RecordVulkanBarriers(gaCommandList* list, ArrayView<const gaBarrier> barriers)
+{
+}
+
+void RecordVulkanBufferCopies(gaCommandList* list,
+                              UploadBuffer* source,
+                              ArrayView<const BufferCopy> copies)
+{
+}
+
+Result<ReadbackBuffer*> CreateVulkanReadbackBuffer(gaDevice* device, uint64 size)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+void RecordVulkanReadbackCopies(gaCommandList* list,
+                                ReadbackBuffer* destination,
+                                ArrayView<const ReadbackCopy> copies)
+{
+}
+
+Result<BindlessTable*> CreateVulkanBindlessTable(gaDevice* device,
+                                                 uint32 capacity,
+                                                 ArrayView<const gaSamplerDesc> samplers)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+void WriteVulkanBindlessDescriptor(gaDevice* device,
+                                   BindlessTable* table,
+                                   uint32 index,
+                                   const gaBindlessView& view)
+{
+}
+
+void BindVulkanBindlessTable(gaCommandList* list, BindlessTable* table, void* pipelineLayout)
+{
+}
+
+Result<PipelineLibrary*> CreateVulkanPipelineLibrary(gaDevice* device,
+                                                     ArrayView<const uint8> data)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> SerializeVulkanPipelineLibrary(gaDevice* device,
+                                        PipelineLibrary* library,
+                                        DynamicArray<uint8>& data)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<PipelineLayout*> CreateVulkanPipelineLayout(gaDevice* device,
+                                                   const gaBindlessHeap* bindless,
+                                                   bool compute,
+                                                   uint32 pushConstantBytes)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaPipeline*> CreateVulkanGraphicsPipeline(gaDevice* device,
+                                                 PipelineLibrary* library,
+                                                 PipelineLayout* layout,
+                                                 uint64 key,
+                                                 const gaGraphicsPipelineDesc& desc)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaPipeline*> CreateVulkanComputePipeline(gaDevice* device,
+                                                PipelineLibrary* library,
+                                                PipelineLayout* layout,
+                                                uint64 key,
+                                                const gaComputePipelineDesc& desc)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaSkinningPass*> CreateVulkanSkinningPass(const gaSkinningPassCreateInfo& createInfo)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaCullingPass*> CreateVulkanCullingPass(const gaCullingPassCreateInfo& createInfo)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaLightBinningPass*> CreateVulkanLightBinningPass(
+	const gaLightBinningPassCreateInfo& createInfo)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaUpscaler*> CreateVulkanUpscaler(const gaUpscalerCreateInfo& createInfo)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<gaMipGenerationPass*> CreateVulkanMipGenerationPass(
+	const gaMipGenerationPassCreateInfo& createInfo)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<CommandBundle*> CreateVulkanCommandBundle(const gaCommandBundleCreateInfo& createInfo)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+Result<> BeginVulkanCommandBundle(CommandBundle* bundle)
+{
+	return "Vulkan backend is not available. Install Vulkan SDK and reconfigure CMake";
+}
+
+void ExecuteVulkanBundle(gaCommandList* list, CommandBundle* bundle)
+{
+}
+
 } // namespace backend
 } // namespace rsbl
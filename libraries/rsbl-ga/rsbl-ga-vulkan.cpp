@@ -3,30 +3,109 @@
 
 #include "rsbl-ga-backends.h"
 
+#include <rsbl-allocator.h>
+#include <rsbl-array-view.h>
+#include <rsbl-clock.h>
 #include <rsbl-dynamic-array.h>
 #include <rsbl-fixed-array.h>
 #include <rsbl-log.h>
 #include <rsbl-ptr.h>
+#include <rsbl-small-array.h>
 
 #include <vulkan/vulkan.h>
 
+#include <cstring>
+
 #if defined(WIN32)
     #include <windows.h>
 
     #include <vulkan/vulkan_win32.h>
+#elif defined(VK_USE_PLATFORM_XLIB_KHR)
+    #include <X11/Xlib.h>
+
+    #include <vulkan/vulkan_xlib.h>
+
+    // Xlib's macros collide with rsbl names (ResultCode::Success, ErrorCategory::None)
+    #undef None
+    #undef Success
+    #undef Always
+    #undef Bool
+    #undef Status
+    #undef True
+    #undef False
 #endif
 
 // TODO: Convert gaDeviceCreateInfo::appVersion to engineVersion
 // TODO: Process to reasonably select device
 // TODO: set up VkDebugUtilsMessengerEXT
 // TODO: Query instance + device layers, check against requests
-// TODO: do I really need graphicsQueueFamilyIndex stored in VulkanDevice?
 
 namespace rsbl
 {
 namespace backend
 {
 
+    // A timeline semaphore, which counts up like a D3D12 fence
+    struct VulkanFence : public gaFence
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+
+        VulkanFence()
+        {
+            backend = gaBackend::Vulkan;
+            internalHandle = nullptr;
+            signalledValue = 0;
+        }
+
+        ~VulkanFence() override
+        {
+            if (semaphore != VK_NULL_HANDLE)
+            {
+                vkDestroySemaphore(device, semaphore, nullptr);
+                semaphore = VK_NULL_HANDLE;
+            }
+        }
+
+        bool Wait(uint64 value)
+        {
+            VkSemaphoreWaitInfo waitInfo{};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &semaphore;
+            waitInfo.pValues = &value;
+            return vkWaitSemaphores(device, &waitInfo, UINT64_MAX) == VK_SUCCESS;
+        }
+    };
+
+    struct VulkanCommandList : public gaCommandList
+    {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+        VulkanCommandList()
+        {
+            backend = gaBackend::Vulkan;
+            internalHandle = nullptr;
+        }
+    };
+
+    // A recorder's command pool for one queue in one frame slot. Its command buffers are allocated
+    // as they're first needed, and reset all at once with the pool every time the slot comes back
+    // round.
+    struct VulkanCommandRecorder
+    {
+        VkCommandPool pool = VK_NULL_HANDLE; // Made the first time it's recorded on
+        DynamicArray<UniquePtr<VulkanCommandList>> lists;
+        uint32 used = 0; // Lists handed out this frame
+    };
+
+    struct VulkanFrame
+    {
+        DynamicArray<VulkanCommandRecorder> recorders[kQueueTypes];
+        // The queue's frame fence reaches it once the GPU is done with the frame's last submit
+        uint64 fenceValues[kQueueTypes] = {};
+    };
+
     struct VulkanDevice : public gaDevice
     {
         VkInstance instance = VK_NULL_HANDLE;
@@ -35,6 +114,37 @@ namespace backend
         VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
 
         uint32 graphicsQueueFamilyIndex = 0;
+        // Indexed by gaQueueType. Without a family of its own a queue type shares the graphics
+        // queue.
+        uint32 queueFamilyIndices[kQueueTypes] = {};
+        VkQueue queues[kQueueTypes] = {};
+
+        VkPhysicalDeviceMemoryProperties memoryProperties{};
+        bool memoryBudget = false; // VK_EXT_memory_budget is enabled
+        // VK_KHR_present_wait, for swapchains to keep to their frame latency. Null without it.
+        PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+        VkPhysicalDeviceFeatures features{}; // The core features enabled
+
+        // Timestamp queries: nanoseconds a tick, and the bits each queue type's family writes
+        float timestampPeriod = 1.0f;
+        uint32 timestampValidBits[kQueueTypes] = {};
+        bool hostQueryReset = false; // Query pools are reset from the CPU, outside any list
+        // VK_EXT_calibrated_timestamps, against cpuTimeDomain, the clock rsbl-platform's is.
+        // Null without it.
+        PFN_vkGetCalibratedTimestampsEXT getCalibratedTimestamps = nullptr;
+        VkTimeDomainEXT cpuTimeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+        // VK_EXT_mesh_shader, null without it
+        PFN_vkCmdDrawMeshTasksEXT drawMeshTasks = nullptr;
+        // VK_KHR_fragment_shading_rate, null without it
+        PFN_vkCmdSetFragmentShadingRateKHR setFragmentShadingRate = nullptr;
+        // VK_AMD_buffer_marker, null without it
+        PFN_vkCmdWriteBufferMarkerAMD writeBufferMarker = nullptr;
+        // VK_KHR_maintenance5, pipelines take their shaders' SPIR-V without shader modules
+        bool maintenance5 = false;
+
+        // Command pools per frame in flight, and the fences counting each queue's submits
+        DynamicArray<VulkanFrame> frames;
+        UniquePtr<VulkanFence> frameFences[kQueueTypes];
 
         VulkanDevice()
         {
@@ -48,6 +158,28 @@ namespace backend
 
             if (logicalDevice != VK_NULL_HANDLE)
             {
+                // Pools can't go while the GPU runs their command buffers, which they free
+                vkDeviceWaitIdle(logicalDevice);
+                for (VulkanFrame& frame : frames)
+                {
+                    for (DynamicArray<VulkanCommandRecorder>& recorders : frame.recorders)
+                    {
+                        for (VulkanCommandRecorder& recorder : recorders)
+                        {
+                            if (recorder.pool != VK_NULL_HANDLE)
+                            {
+                                vkDestroyCommandPool(logicalDevice, recorder.pool, nullptr);
+                            }
+                        }
+                    }
+                }
+                frames.Clear();
+
+                for (UniquePtr<VulkanFence>& frameFence : frameFences)
+                {
+                    frameFence.Reset();
+                }
+
                 RSBL_LOG_INFO("Destroying VkDevice: {}", static_cast<void*>(logicalDevice));
                 vkDestroyDevice(logicalDevice, nullptr);
                 logicalDevice = VK_NULL_HANDLE;
@@ -72,27 +204,112 @@ namespace backend
                 instance = VK_NULL_HANDLE;
             }
         }
+
+        VulkanFrame& CurrentFrame()
+        {
+            return frames[frame % frames.Size()];
+        }
+    };
+
+    // A swapchain replaced on resize, passed as oldSwapchain to the new one. What it presented
+    // may still be on the GPU or on its way to the display.
+    struct RetiredVulkanSwapchain
+    {
+        VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+        SmallArray<VkImageView, 4> imageViews;
+        SmallArray<VkSemaphore, 4> presentSemaphores;
+        uint64 fenceValue = 0; // The graphics frame fence's value at its last present
+
+        void Destroy(VkDevice device)
+        {
+            for (VkImageView imageView : imageViews)
+            {
+                vkDestroyImageView(device, imageView, nullptr);
+            }
+            for (VkSemaphore semaphore : presentSemaphores)
+            {
+                vkDestroySemaphore(device, semaphore, nullptr);
+            }
+            vkDestroySwapchainKHR(device, swapchain, nullptr);
+        }
     };
 
     struct VulkanSwapchain : public gaSwapchain
     {
         VkSurfaceKHR surface = VK_NULL_HANDLE;
         VkSwapchainKHR swapchain = VK_NULL_HANDLE;
-        DynamicArray<VkImage> swapchainImages;
-        DynamicArray<VkImageView> swapchainImageViews;
+        // Swapchains have 2-4 images, so these never need the heap
+        SmallArray<VkImage, 4> swapchainImages;
+        SmallArray<VkImageView, 4> swapchainImageViews;
         VkDevice device = VK_NULL_HANDLE;
         VkInstance instance = VK_NULL_HANDLE;
+        VkQueue queue = VK_NULL_HANDLE; // The device's graphics queue, which presents
+        const VulkanDevice* vulkanDevice = nullptr;
+
+        // Images are acquired with a fence the CPU waits on, rather than a semaphore the frame's
+        // submits would need to wait on. Presents wait on the image's semaphore, signalled after
+        // everything submitted before.
+        VkFence acquireFence = VK_NULL_HANDLE;
+        SmallArray<VkSemaphore, 4> presentSemaphores;
+        bool acquired = false; // currentBuffer is acquired, its fence maybe not waited on yet
+        bool ready = false;    // And the fence is waited on, it's free to render to
+
+        PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+        uint64 presentId = 0;      // Presents so far, each one's id
+        uint64 firstPresentId = 1; // The current swapchain's first, ids go on across resizes
+        uint32 maxFrameLatency = 1;
+        // The latest present a wait found shown, and when it found out
+        uint64 displayedId = 0;
+        uint64 displayedTicks = 0;
+
+        // For recreating it on resize
+        uint32 bufferCount = 2;
+        gaPresentMode requestedMode = gaPresentMode::Vsync;
+
+        // The frames rendering to an image are done once the device's graphics frame fence
+        // reaches the value it had when the image was presented
+        VulkanFence* frameFence = nullptr;
+        uint64 lastFenceValue = 0;
+        SmallArray<RetiredVulkanSwapchain, 2> retired;
 
         VulkanSwapchain()
         {
             backend = gaBackend::Vulkan;
             internalHandle = nullptr;
+            presentMode = gaPresentMode::Vsync;
+            currentBuffer = 0;
+            backBuffer = nullptr;
         }
 
         ~VulkanSwapchain() override
         {
             RSBL_LOG_INFO("Destroying Vulkan swapchain...");
 
+            // Presents still waiting on their semaphores hold them
+            if (queue != VK_NULL_HANDLE)
+            {
+                vkQueueWaitIdle(queue);
+            }
+            if (acquired && !ready)
+            {
+                vkWaitForFences(device, 1, &acquireFence, VK_TRUE, UINT64_MAX);
+            }
+            for (VkSemaphore semaphore : presentSemaphores)
+            {
+                vkDestroySemaphore(device, semaphore, nullptr);
+            }
+            presentSemaphores.Clear();
+            for (RetiredVulkanSwapchain& old : retired)
+            {
+                old.Destroy(device);
+            }
+            retired.Clear();
+            if (acquireFence != VK_NULL_HANDLE)
+            {
+                vkDestroyFence(device, acquireFence, nullptr);
+                acquireFence = VK_NULL_HANDLE;
+            }
+
             // Destroy image views
             for (size_t i = 0; i < swapchainImageViews.Size(); ++i)
             {
@@ -123,6 +340,333 @@ namespace backend
         }
     };
 
+    // gaSwapchainCreateInfo::offscreen: images of its own, which nothing shows. Presents take
+    // the next one in turn without waiting for anything.
+    struct VulkanOffscreenSwapchain : public gaSwapchain
+    {
+        SmallArray<VkImage, 4> images;
+        SmallArray<VkImageView, 4> imageViews;
+        SmallArray<VkDeviceMemory, 4> memory;
+        const VulkanDevice* vulkanDevice = nullptr;
+        VkDevice device = VK_NULL_HANDLE;
+
+        // As VulkanSwapchain's, the frames rendering to the images are done at this value
+        VulkanFence* frameFence = nullptr;
+        uint64 lastFenceValue = 0;
+
+        VulkanOffscreenSwapchain()
+        {
+            backend = gaBackend::Vulkan;
+            internalHandle = nullptr;
+            presentMode = gaPresentMode::Immediate;
+            currentBuffer = 0;
+            backBuffer = nullptr;
+            offscreen = true;
+        }
+
+        ~VulkanOffscreenSwapchain() override
+        {
+            DestroyImages();
+        }
+
+        void DestroyImages()
+        {
+            for (VkImageView view : imageViews)
+            {
+                vkDestroyImageView(device, view, nullptr);
+            }
+            for (VkImage image : images)
+            {
+                vkDestroyImage(device, image, nullptr);
+            }
+            for (VkDeviceMemory allocation : memory)
+            {
+                vkFreeMemory(device, allocation, nullptr);
+            }
+            imageViews.Clear();
+            images.Clear();
+            memory.Clear();
+            backBuffer = nullptr;
+        }
+    };
+
+    // Selection helpers take views straight over the enumeration results
+
+    // Returns false if no family supports graphics
+    static bool FindGraphicsQueueFamily(ArrayView<const VkQueueFamilyProperties> queueFamilies,
+                                        uint32& outIndex)
+    {
+        for (uint64 i = 0; i < queueFamilies.Size(); i++)
+        {
+            if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+            {
+                outIndex = static_cast<uint32>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Returns false if no family has all of required and none of excluded, the way a dedicated
+    // compute or transfer family advertises itself
+    static bool FindDedicatedQueueFamily(ArrayView<const VkQueueFamilyProperties> queueFamilies,
+                                         VkQueueFlags required,
+                                         VkQueueFlags excluded,
+                                         uint32& outIndex)
+    {
+        for (uint64 i = 0; i < queueFamilies.Size(); i++)
+        {
+            const VkQueueFlags flags = queueFamilies[i].queueFlags;
+            if ((flags & required) == required && (flags & excluded) == 0)
+            {
+                outIndex = static_cast<uint32>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool HasDeviceExtension(VkPhysicalDevice physicalDevice,
+                                   const char* name,
+                                   LinearArena& scratchArena)
+    {
+        uint32 extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+
+        DynamicArray<VkExtensionProperties> extensions(&scratchArena);
+        extensions.Resize(extensionCount);
+        vkEnumerateDeviceExtensionProperties(
+            physicalDevice, nullptr, &extensionCount, extensions.Data());
+
+        for (const VkExtensionProperties& extension : extensions)
+        {
+            if (strcmp(extension.extensionName, name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Bindless heaps are one descriptor set of partially bound arrays, indexed with non-uniform
+    // indices and written while lists using it are in flight
+    static bool SupportsBindless(const VkPhysicalDeviceVulkan12Features& supported12)
+    {
+        return supported12.runtimeDescriptorArray &&
+               supported12.descriptorBindingPartiallyBound &&
+               supported12.descriptorBindingUpdateUnusedWhilePending &&
+               supported12.descriptorBindingStorageBufferUpdateAfterBind &&
+               supported12.descriptorBindingSampledImageUpdateAfterBind &&
+               supported12.descriptorBindingStorageImageUpdateAfterBind &&
+               supported12.shaderStorageBufferArrayNonUniformIndexing &&
+               supported12.shaderSampledImageArrayNonUniformIndexing &&
+               supported12.shaderStorageImageArrayNonUniformIndexing;
+    }
+
+    // Whether the device runs the backend (Vulkan 1.3, graphics and swapchains), and what
+    // SelectAdapter ranks it by
+    static bool DescribeVulkanDevice(VkPhysicalDevice physicalDevice,
+                                     LinearArena& scratchArena,
+                                     gaAdapterInfo& candidate)
+    {
+        VkPhysicalDeviceIDProperties idProperties{};
+        idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &idProperties;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+        const VkPhysicalDeviceProperties& properties = properties2.properties;
+        if (properties.apiVersion < VK_API_VERSION_1_3)
+        {
+            return false;
+        }
+
+        uint32 queueFamilyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+        DynamicArray<VkQueueFamilyProperties> queueFamilies(&scratchArena);
+        queueFamilies.Resize(queueFamilyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(
+            physicalDevice, &queueFamilyCount, queueFamilies.Data());
+        uint32 graphicsFamily = 0;
+        if (!FindGraphicsQueueFamily(queueFamilies, graphicsFamily))
+        {
+            return false;
+        }
+        for (const char* extension : {VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+                                      VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_EXTENSION_NAME,
+                                      VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME})
+        {
+            if (!HasDeviceExtension(physicalDevice, extension, scratchArena))
+            {
+                return false;
+            }
+        }
+
+        strncpy(candidate.name, properties.deviceName, sizeof(candidate.name) - 1);
+        static_assert(sizeof(idProperties.deviceUUID) == sizeof(candidate.id));
+        memcpy(candidate.id, idProperties.deviceUUID, sizeof(candidate.id));
+        switch (properties.deviceType)
+        {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            candidate.type = gaAdapterType::Discrete;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            candidate.type = gaAdapterType::Integrated;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            candidate.type = gaAdapterType::Virtual;
+            break;
+        default: // CPU implementations like llvmpipe come last
+            candidate.type = gaAdapterType::Other;
+            break;
+        }
+
+        VkPhysicalDeviceMemoryProperties memoryProperties{};
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+        for (uint32 heap = 0; heap < memoryProperties.memoryHeapCount; ++heap)
+        {
+            if (memoryProperties.memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+            {
+                candidate.dedicatedMemory += memoryProperties.memoryHeaps[heap].size;
+            }
+        }
+
+        VkPhysicalDeviceVulkan12Features supported12{};
+        supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        VkPhysicalDeviceFeatures2 supportedFeatures{};
+        supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supportedFeatures.pNext = &supported12;
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &supportedFeatures);
+        candidate.bindless = SupportsBindless(supported12);
+        return true;
+    }
+
+    // Prefer B8G8R8A8_UNORM with SRGB_NONLINEAR, otherwise take the first format
+    static VkSurfaceFormatKHR ChooseSurfaceFormat(ArrayView<const VkSurfaceFormat2KHR> formats)
+    {
+        for (const VkSurfaceFormat2KHR& format : formats)
+        {
+            if (format.surfaceFormat.format == VK_FORMAT_B8G8R8A8_UNORM &&
+                format.surfaceFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+            {
+                return format.surfaceFormat;
+            }
+        }
+        return formats.Front().surfaceFormat;
+    }
+
+    // What a swapchain's format is to rsbl-ga, Unknown for anything it has no gaFormat for
+    static gaFormat SwapchainFormat(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_B8G8R8A8_UNORM:
+            return gaFormat::B8G8R8A8Unorm;
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return gaFormat::B8G8R8A8Srgb;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+            return gaFormat::R8G8B8A8Unorm;
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return gaFormat::R8G8B8A8Srgb;
+        default:
+            return gaFormat::Unknown;
+        }
+    }
+
+    // The requested mode, or the next one up that the surface has, ending at FIFO which is always
+    // available. VRR is FIFO, the driver turns variable refresh on for it.
+    static VkPresentModeKHR ChoosePresentMode(ArrayView<const VkPresentModeKHR> presentModes,
+                                              gaPresentMode requested,
+                                              gaPresentMode& chosen)
+    {
+        const auto has = [presentModes](VkPresentModeKHR wanted) {
+            for (VkPresentModeKHR presentMode : presentModes)
+            {
+                if (presentMode == wanted)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        if (requested == gaPresentMode::Immediate && has(VK_PRESENT_MODE_IMMEDIATE_KHR))
+        {
+            chosen = gaPresentMode::Immediate;
+            return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        }
+        if ((requested == gaPresentMode::Immediate || requested == gaPresentMode::Mailbox) &&
+            has(VK_PRESENT_MODE_MAILBOX_KHR))
+        {
+            chosen = gaPresentMode::Mailbox;
+            return VK_PRESENT_MODE_MAILBOX_KHR;
+        }
+        chosen = requested == gaPresentMode::Vrr ? gaPresentMode::Vrr : gaPresentMode::Vsync;
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+
+    static Result<gaFence*> NewFence(VkDevice device, uint64 initialValue)
+    {
+        VkSemaphoreTypeCreateInfo timelineCreateInfo{};
+        timelineCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        timelineCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timelineCreateInfo.initialValue = initialValue;
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreCreateInfo.pNext = &timelineCreateInfo;
+
+        auto fence = rsbl::UniquePtr(new VulkanFence());
+        fence->device = device;
+        if (vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &fence->semaphore) !=
+            VK_SUCCESS)
+        {
+            return "Failed to create a timeline semaphore";
+        }
+        fence->internalHandle = fence->semaphore;
+        fence->signalledValue = initialValue;
+        return fence.Release();
+    }
+
+    Result<> EnumerateVulkanAdapters(DynamicArray<gaAdapterInfo>& adapters)
+    {
+        VkApplicationInfo appInfo{};
+        appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        appInfo.pEngineName = "rsbl";
+        appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
+        appInfo.apiVersion = VK_API_VERSION_1_3;
+
+        VkInstanceCreateInfo instanceCreateInfo{};
+        instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        instanceCreateInfo.pApplicationInfo = &appInfo;
+
+        VkInstance instance = VK_NULL_HANDLE;
+        if (vkCreateInstance(&instanceCreateInfo, nullptr, &instance) != VK_SUCCESS)
+        {
+            return "Failed to create Vulkan instance";
+        }
+
+        alignas(16) uint8 scratchBuffer[4096];
+        LinearArena scratchArena(scratchBuffer, sizeof(scratchBuffer));
+
+        uint32 deviceCount = 0;
+        vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+        DynamicArray<VkPhysicalDevice> physicalDevices(&scratchArena);
+        physicalDevices.Resize(deviceCount);
+        vkEnumeratePhysicalDevices(instance, &deviceCount, physicalDevices.Data());
+        for (VkPhysicalDevice physicalDevice : physicalDevices)
+        {
+            gaAdapterInfo adapter;
+            if (DescribeVulkanDevice(physicalDevice, scratchArena, adapter))
+            {
+                adapters.PushBack(adapter);
+            }
+        }
+
+        vkDestroyInstance(instance, nullptr);
+        return ResultCode::Success;
+    }
+
     Result<gaDevice*> CreateVulkanDevice(const gaDeviceCreateInfo& createInfo)
     {
         RSBL_LOG_INFO("Creating Vulkan device...");
@@ -138,8 +682,13 @@ namespace backend
         appInfo.apiVersion = VK_API_VERSION_1_3;
 
         // Instance extensions for surface support
+#if defined(VK_USE_PLATFORM_XLIB_KHR)
+        constexpr const char* kPlatformSurfaceExtension = VK_KHR_XLIB_SURFACE_EXTENSION_NAME;
+#else
+        constexpr const char* kPlatformSurfaceExtension = VK_KHR_WIN32_SURFACE_EXTENSION_NAME;
+#endif
         FixedArray instanceExtensions = {VK_KHR_SURFACE_EXTENSION_NAME,
-                                         VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
+                                         kPlatformSurfaceExtension,
                                          VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME};
 
         // Instance create info
@@ -177,34 +726,52 @@ namespace backend
 
         RSBL_LOG_INFO("Found {} GPUs with Vulkan support", deviceCount);
 
-        rsbl::DynamicArray<VkPhysicalDevice> physicalDevices(deviceCount);
+        // Enumeration temporaries live in stack scratch memory, instead of hitting the heap
+        alignas(16) uint8 scratchBuffer[4096];
+        LinearArena scratchArena(scratchBuffer, sizeof(scratchBuffer));
+
+        rsbl::DynamicArray<VkPhysicalDevice> physicalDevices(&scratchArena);
+        physicalDevices.Resize(deviceCount);
         vkEnumeratePhysicalDevices(device->instance, &deviceCount, physicalDevices.Data());
 
-        // For now, just pick the first device
-        device->physicalDevice = physicalDevices[0];
+        // A laptop's first device is often the integrated GPU
+        DynamicArray<gaAdapterInfo> candidates(&scratchArena);
+        DynamicArray<VkPhysicalDevice> candidateDevices(&scratchArena);
+        for (VkPhysicalDevice physicalDevice : physicalDevices)
+        {
+            gaAdapterInfo candidate;
+            if (DescribeVulkanDevice(physicalDevice, scratchArena, candidate))
+            {
+                RSBL_LOG_INFO("Graphics adapter: {} ({} MiB device local)",
+                              candidate.name,
+                              candidate.dedicatedMemory >> 20);
+                candidates.PushBack(candidate);
+                candidateDevices.PushBack(physicalDevice);
+            }
+        }
+
+        const uint32 picked = SelectAdapter(candidates, createInfo);
+        if (picked == ~0u)
+        {
+            return {ErrorCategory::NotFound,
+                    "Failed to find a GPU with Vulkan 1.3, graphics and swapchains"};
+        }
+        device->physicalDevice = candidateDevices[picked];
+        device->adapterInfo = candidates[picked];
+        RSBL_LOG_INFO("Picked graphics adapter: {}", device->adapterInfo.name);
 
         // Find queue family
         uint32 queueFamilyCount = 0;
         vkGetPhysicalDeviceQueueFamilyProperties(
             device->physicalDevice, &queueFamilyCount, nullptr);
 
-        rsbl::DynamicArray<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+        rsbl::DynamicArray<VkQueueFamilyProperties> queueFamilies(&scratchArena);
+        queueFamilies.Resize(queueFamilyCount);
         vkGetPhysicalDeviceQueueFamilyProperties(
             device->physicalDevice, &queueFamilyCount, queueFamilies.Data());
 
         uint32 graphicsQueueFamilyIndex = 0;
-        bool foundGraphicsQueue = false;
-        for (uint32 i = 0; i < queueFamilyCount; i++)
-        {
-            if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
-            {
-                graphicsQueueFamilyIndex = i;
-                foundGraphicsQueue = true;
-                break;
-            }
-        }
-
-        if (!foundGraphicsQueue)
+        if (!FindGraphicsQueueFamily(queueFamilies, graphicsQueueFamilyIndex))
         {
             return "Failed to find graphics queue family";
         }
@@ -212,108 +779,466 @@ namespace backend
         device->graphicsQueueFamilyIndex = graphicsQueueFamilyIndex;
         RSBL_LOG_INFO("Found graphics queue family {}", graphicsQueueFamilyIndex);
 
+        // Compute and copy get queues of their own when the hardware has families for them, so
+        // their work can overlap the graphics queue's. Otherwise they go on the graphics queue.
+        uint32* queueFamilyIndices = device->queueFamilyIndices;
+        queueFamilyIndices[static_cast<uint32>(gaQueueType::Graphics)] = graphicsQueueFamilyIndex;
+        uint32& computeFamily = queueFamilyIndices[static_cast<uint32>(gaQueueType::Compute)];
+        device->asyncCompute = FindDedicatedQueueFamily(
+            queueFamilies, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT, computeFamily);
+        if (!device->asyncCompute)
+        {
+            computeFamily = graphicsQueueFamilyIndex;
+        }
+        uint32& copyFamily = queueFamilyIndices[static_cast<uint32>(gaQueueType::Copy)];
+        device->dedicatedCopy =
+            FindDedicatedQueueFamily(queueFamilies,
+                                     VK_QUEUE_TRANSFER_BIT,
+                                     VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT,
+                                     copyFamily);
+        if (!device->dedicatedCopy)
+        {
+            copyFamily = graphicsQueueFamilyIndex;
+        }
+        RSBL_LOG_INFO("Queue families: compute {}{}, copy {}{}",
+                      computeFamily,
+                      device->asyncCompute ? "" : " (graphics)",
+                      copyFamily,
+                      device->dedicatedCopy ? "" : " (graphics)");
+
         // Device extensions for swapchain support
         // These extensions are expected to be available in Vulkan 1.3
-        FixedArray deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME,
-                                       VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_EXTENSION_NAME,
-                                       VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME};
-
-        // Create logical device
-        VkDeviceQueueCreateInfo queueCreateInfo{};
-        queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        queueCreateInfo.queueFamilyIndex = graphicsQueueFamilyIndex;
-        queueCreateInfo.queueCount = 1;
-        float queuePriority = 1.0f;
-        queueCreateInfo.pQueuePriorities = &queuePriority;
-
-        VkPhysicalDeviceFeatures deviceFeatures{};
-
-        VkDeviceCreateInfo deviceCreateInfo{};
-        deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-        deviceCreateInfo.pQueueCreateInfos = &queueCreateInfo;
-        deviceCreateInfo.queueCreateInfoCount = 1;
-        deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-        deviceCreateInfo.enabledExtensionCount = static_cast<uint32>(deviceExtensions.Size());
-        deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.Data();
-        // deviceCreateInfo.flags = 0; // flags not needed currently, according to spec
-
-        result = vkCreateDevice(
-            device->physicalDevice, &deviceCreateInfo, nullptr, &device->logicalDevice);
-        if (result != VK_SUCCESS)
+        SmallArray<const char*, 10> deviceExtensions;
+        deviceExtensions.PushBack(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        deviceExtensions.PushBack(VK_KHR_SWAPCHAIN_MUTABLE_FORMAT_EXTENSION_NAME);
+        deviceExtensions.PushBack(VK_KHR_IMAGE_FORMAT_LIST_EXTENSION_NAME);
+
+        // The OS's memory budget, most drivers have it
+        if (HasDeviceExtension(
+                device->physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, scratchArena))
         {
-            return "Failed to create Vulkan logical device";
+            deviceExtensions.PushBack(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            device->memoryBudget = true;
         }
+        vkGetPhysicalDeviceMemoryProperties(device->physicalDevice, &device->memoryProperties);
 
-        RSBL_LOG_INFO("Vulkan logical device created: {}",
-                      static_cast<void*>(device->logicalDevice));
-
-        device->internalHandle = device->logicalDevice;
-
-        return device.Release();
-    }
-
-    Result<gaSwapchain*> CreateVulkanSwapchain(const gaSwapchainCreateInfo& createInfo)
-    {
-        RSBL_LOG_INFO("Creating Vulkan swapchain...");
-
-        // Cast to Vulkan device
-        auto vulkanDevice = static_cast<VulkanDevice*>(createInfo.device);
-
-        // Decode platform handles
-        HWND hwnd = static_cast<HWND>(createInfo.windowHandle);
-        HINSTANCE hinstance = static_cast<HINSTANCE>(createInfo.appHandle);
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(device->physicalDevice, &properties);
+        device->timestampPeriod = properties.limits.timestampPeriod;
+        for (uint32 queue = 0; queue < kQueueTypes; ++queue)
+        {
+            device->timestampValidBits[queue] =
+                queueFamilies[queueFamilyIndices[queue]].timestampValidBits;
+        }
 
-        if (hwnd == nullptr)
+        // GPU timestamps on the CPU's clock, when the driver can read both at once
+#if defined(WIN32)
+        device->cpuTimeDomain = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+#else
+        device->cpuTimeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+#endif
+        bool calibratedTimestamps = false;
+        auto getTimeDomains = reinterpret_cast<PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT>(
+            vkGetInstanceProcAddr(device->instance,
+                                  "vkGetPhysicalDeviceCalibrateableTimeDomainsEXT"));
+        if (getTimeDomains != nullptr &&
+            HasDeviceExtension(
+                device->physicalDevice, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME, scratchArena))
         {
-            return "Invalid window handle";
+            uint32 domainCount = 0;
+            getTimeDomains(device->physicalDevice, &domainCount, nullptr);
+            DynamicArray<VkTimeDomainEXT> domains(&scratchArena);
+            domains.Resize(domainCount);
+            getTimeDomains(device->physicalDevice, &domainCount, domains.Data());
+
+            bool deviceDomain = false;
+            bool cpuDomain = false;
+            for (VkTimeDomainEXT domain : domains)
+            {
+                deviceDomain = deviceDomain || domain == VK_TIME_DOMAIN_DEVICE_EXT;
+                cpuDomain = cpuDomain || domain == device->cpuTimeDomain;
+            }
+            calibratedTimestamps = deviceDomain && cpuDomain;
+            if (calibratedTimestamps)
+            {
+                deviceExtensions.PushBack(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+            }
+        }
+        if (!calibratedTimestamps)
+        {
+            RSBL_LOG_INFO("VK_EXT_calibrated_timestamps not available, GPU zones are uncalibrated");
         }
 
-        if (hinstance == nullptr)
+        // The features of the extensions below that need turning on, chained together
+        void* deviceCreateNext = nullptr;
+
+        // Waiting on presents by id, which swapchains keep their frame latency with. Without it
+        // they only wait for a free image, as many frames ahead as there are images.
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+        presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+        presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        presentWaitFeatures.pNext = &presentIdFeatures;
+        bool presentWait = false;
+        if (HasDeviceExtension(
+                device->physicalDevice, VK_KHR_PRESENT_ID_EXTENSION_NAME, scratchArena) &&
+            HasDeviceExtension(
+                device->physicalDevice, VK_KHR_PRESENT_WAIT_EXTENSION_NAME, scratchArena))
         {
-            return "Invalid application handle";
+            VkPhysicalDeviceFeatures2 features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &presentWaitFeatures;
+            vkGetPhysicalDeviceFeatures2(device->physicalDevice, &features2);
+
+            presentWait = presentIdFeatures.presentId == VK_TRUE &&
+                          presentWaitFeatures.presentWait == VK_TRUE;
+            if (presentWait)
+            {
+                deviceExtensions.PushBack(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+                deviceExtensions.PushBack(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+                presentIdFeatures.pNext = deviceCreateNext;
+                deviceCreateNext = &presentWaitFeatures;
+            }
         }
 
-        auto swapchain = rsbl::UniquePtr(new VulkanSwapchain());
-        swapchain->device = vulkanDevice->logicalDevice;
-        swapchain->instance = vulkanDevice->instance;
+        // Mesh pipelines, with task shaders to cull ahead of them. Without them meshes are drawn
+        // with vertex shaders.
+        VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures{};
+        meshShaderFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT;
+        if (HasDeviceExtension(
+                device->physicalDevice, VK_EXT_MESH_SHADER_EXTENSION_NAME, scratchArena))
+        {
+            VkPhysicalDeviceFeatures2 features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &meshShaderFeatures;
+            vkGetPhysicalDeviceFeatures2(device->physicalDevice, &features2);
+
+            device->meshShaders = meshShaderFeatures.meshShader == VK_TRUE &&
+                                  meshShaderFeatures.taskShader == VK_TRUE;
+            if (device->meshShaders)
+            {
+                // Only the two, the rest need features of their own enabled too
+                meshShaderFeatures.multiviewMeshShader = VK_FALSE;
+                meshShaderFeatures.primitiveFragmentShadingRateMeshShader = VK_FALSE;
+                meshShaderFeatures.meshShaderQueries = VK_FALSE;
+                deviceExtensions.PushBack(VK_EXT_MESH_SHADER_EXTENSION_NAME);
+                meshShaderFeatures.pNext = deviceCreateNext;
+                deviceCreateNext = &meshShaderFeatures;
+            }
+        }
+        if (!device->meshShaders)
+        {
+            RSBL_LOG_INFO("VK_EXT_mesh_shader not available, meshes are drawn with vertex shaders");
+        }
 
-        // Create Win32 surface
-        VkWin32SurfaceCreateInfoKHR surfaceCreateInfo{};
-        surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
-        surfaceCreateInfo.hwnd = hwnd;
-        surfaceCreateInfo.hinstance = hinstance;
+        // Breadcrumbs written once the work before them has finished, rather than when it starts
+        if (HasDeviceExtension(
+                device->physicalDevice, VK_AMD_BUFFER_MARKER_EXTENSION_NAME, scratchArena))
+        {
+            deviceExtensions.PushBack(VK_AMD_BUFFER_MARKER_EXTENSION_NAME);
+            device->bufferMarkers = true;
+        }
 
-        VkResult result = vkCreateWin32SurfaceKHR(
-            vulkanDevice->instance, &surfaceCreateInfo, nullptr, &swapchain->surface);
+        // Per-draw rates and rate images, as DX12's tier 2. Per-primitive rates aren't used.
+        VkPhysicalDeviceFragmentShadingRateFeaturesKHR shadingRateFeatures{};
+        shadingRateFeatures.sType =
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR;
+        if (HasDeviceExtension(
+                device->physicalDevice, VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME, scratchArena))
+        {
+            VkPhysicalDeviceFeatures2 features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &shadingRateFeatures;
+            vkGetPhysicalDeviceFeatures2(device->physicalDevice, &features2);
+
+            VkPhysicalDeviceFragmentShadingRatePropertiesKHR shadingRateProperties{};
+            shadingRateProperties.sType =
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_PROPERTIES_KHR;
+            VkPhysicalDeviceProperties2 properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties2.pNext = &shadingRateProperties;
+            vkGetPhysicalDeviceProperties2(device->physicalDevice, &properties2);
+
+            device->variableRateShading =
+                shadingRateFeatures.pipelineFragmentShadingRate == VK_TRUE &&
+                shadingRateFeatures.attachmentFragmentShadingRate == VK_TRUE;
+            if (device->variableRateShading)
+            {
+                // 2x4, 4x2 and 4x4 come with a 4x4 largest fragment
+                device->largeShadingRates = shadingRateProperties.maxFragmentSize.width >= 4 &&
+                                            shadingRateProperties.maxFragmentSize.height >= 4;
+
+                // 16 pixel texels, as most DX12 hardware has, where the attachment takes them.
+                // Texel sizes are powers of two, so clamping keeps it one.
+                const VkExtent2D minTexel =
+                    shadingRateProperties.minFragmentShadingRateAttachmentTexelSize;
+                const VkExtent2D maxTexel =
+                    shadingRateProperties.maxFragmentShadingRateAttachmentTexelSize;
+                const uint32 low = minTexel.width > minTexel.height ? minTexel.width
+                                                                    : minTexel.height;
+                const uint32 high = maxTexel.width < maxTexel.height ? maxTexel.width
+                                                                     : maxTexel.height;
+                device->shadingRateTileSize = 16 < low ? low : (16 > high ? high : 16);
+
+                shadingRateFeatures.primitiveFragmentShadingRate = VK_FALSE;
+                deviceExtensions.PushBack(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
+                shadingRateFeatures.pNext = deviceCreateNext;
+                deviceCreateNext = &shadingRateFeatures;
+            }
+        }
+
+        // Shader modules only ever live for one pipeline's creation, maintenance5 skips them
+        VkPhysicalDeviceMaintenance5FeaturesKHR maintenance5Features{};
+        maintenance5Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR;
+        if (HasDeviceExtension(
+                device->physicalDevice, VK_KHR_MAINTENANCE_5_EXTENSION_NAME, scratchArena))
+        {
+            VkPhysicalDeviceFeatures2 features2{};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &maintenance5Features;
+            vkGetPhysicalDeviceFeatures2(device->physicalDevice, &features2);
+
+            device->maintenance5 = maintenance5Features.maintenance5 == VK_TRUE;
+            if (device->maintenance5)
+            {
+                deviceExtensions.PushBack(VK_KHR_MAINTENANCE_5_EXTENSION_NAME);
+                maintenance5Features.pNext = deviceCreateNext;
+                deviceCreateNext = &maintenance5Features;
+            }
+        }
+
+        // Create logical device, with one queue from each family in use
+        const float queuePriority = 1.0f;
+        SmallArray<VkDeviceQueueCreateInfo, kQueueTypes> queueCreateInfos;
+        for (uint32 queue = 0; queue < kQueueTypes; ++queue)
+        {
+            bool seen = false;
+            for (const VkDeviceQueueCreateInfo& queueCreateInfo : queueCreateInfos)
+            {
+                seen = seen || queueCreateInfo.queueFamilyIndex == queueFamilyIndices[queue];
+            }
+            if (seen)
+            {
+                continue;
+            }
+
+            VkDeviceQueueCreateInfo queueCreateInfo{};
+            queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueCreateInfo.queueFamilyIndex = queueFamilyIndices[queue];
+            queueCreateInfo.queueCount = 1;
+            queueCreateInfo.pQueuePriorities = &queuePriority;
+            queueCreateInfos.PushBack(queueCreateInfo);
+        }
+
+        VkPhysicalDeviceFeatures deviceFeatures{};
+
+        // Timeline semaphores (core since 1.2) count submits, frames in flight wait on them
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        vulkan12Features.pNext = deviceCreateNext;
+        vulkan12Features.timelineSemaphore = VK_TRUE;
+
+        // Bindless heaps, see SupportsBindless
+        VkPhysicalDeviceVulkan12Features supported12{};
+        supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        VkPhysicalDeviceFeatures2 supportedFeatures{};
+        supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supportedFeatures.pNext = &supported12;
+        vkGetPhysicalDeviceFeatures2(device->physicalDevice, &supportedFeatures);
+        device->bindless = SupportsBindless(supported12);
+        if (device->bindless)
+        {
+            vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+            vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+            vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+            vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+            vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            vulkan12Features.descriptorBindingStorageImageUpdateAfterBind = VK_TRUE;
+            vulkan12Features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+            vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+            vulkan12Features.shaderStorageImageArrayNonUniformIndexing = VK_TRUE;
+        }
+        else
+        {
+            RSBL_LOG_INFO("Descriptor indexing not available, bindless heaps disabled");
+        }
+
+        // Timestamp pools are reset as their frames come round, with no list to record it in
+        device->hostQueryReset = supported12.hostQueryReset == VK_TRUE;
+        vulkan12Features.hostQueryReset = supported12.hostQueryReset;
+
+        // Depth clamping and wireframe for pipelines that ask for them, where there's support
+        deviceFeatures.depthClamp = supportedFeatures.features.depthClamp;
+        deviceFeatures.fillModeNonSolid = supportedFeatures.features.fillModeNonSolid;
+        // Anisotropic samplers, which fall back to linear without it
+        deviceFeatures.samplerAnisotropy = supportedFeatures.features.samplerAnisotropy;
+
+        // GPU-driven draws, many from one call with the count in a buffer
+        device->drawIndirectCount =
+            supportedFeatures.features.multiDrawIndirect && supported12.drawIndirectCount;
+        if (device->drawIndirectCount)
+        {
+            deviceFeatures.multiDrawIndirect = VK_TRUE;
+            vulkan12Features.drawIndirectCount = VK_TRUE;
+        }
+
+        // Reserved resources tile like DX12's when images have the standard block shapes. Binds
+        // go on the graphics queue, ordered with its submits, so it has to take them.
+        device->reservedResources =
+            supportedFeatures.features.sparseBinding &&
+            supportedFeatures.features.sparseResidencyBuffer &&
+            supportedFeatures.features.sparseResidencyImage2D &&
+            properties.sparseProperties.residencyStandard2DBlockShape &&
+            (queueFamilies[graphicsQueueFamilyIndex].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) != 0;
+        if (device->reservedResources)
+        {
+            deviceFeatures.sparseBinding = VK_TRUE;
+            deviceFeatures.sparseResidencyBuffer = VK_TRUE;
+            deviceFeatures.sparseResidencyImage2D = VK_TRUE;
+        }
+        device->features = deviceFeatures;
+
+        // Pipelines are made for dynamic rendering (core since 1.3), there are no render passes
+        // or framebuffers. Barriers and submits are synchronization2's only, core in 1.3 too, as
+        // is maintenance4, which lets pipeline layouts go before their pipelines.
+        VkPhysicalDeviceVulkan13Features vulkan13Features{};
+        vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        vulkan13Features.pNext = &vulkan12Features;
+        vulkan13Features.dynamicRendering = VK_TRUE;
+        vulkan13Features.synchronization2 = VK_TRUE;
+        vulkan13Features.maintenance4 = VK_TRUE;
+
+        VkDeviceCreateInfo deviceCreateInfo{};
+        deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        deviceCreateInfo.pNext = &vulkan13Features;
+        deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.Data();
+        deviceCreateInfo.queueCreateInfoCount = static_cast<uint32>(queueCreateInfos.Size());
+        deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
+        deviceCreateInfo.enabledExtensionCount = static_cast<uint32>(deviceExtensions.Size());
+        deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.Data();
+        // deviceCreateInfo.flags = 0; // flags not needed currently, according to spec
+
+        result = vkCreateDevice(
+            device->physicalDevice, &deviceCreateInfo, nullptr, &device->logicalDevice);
         if (result != VK_SUCCESS)
         {
-            return "Failed to create Win32 surface";
+            return "Failed to create Vulkan logical device";
         }
 
-        RSBL_LOG_INFO("Win32 surface created: {}", static_cast<void*>(swapchain->surface));
+        RSBL_LOG_INFO("Vulkan logical device created: {}",
+                      static_cast<void*>(device->logicalDevice));
 
-        // Check if queue family supports presentation
-        VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(vulkanDevice->physicalDevice,
-                                             vulkanDevice->graphicsQueueFamilyIndex,
-                                             swapchain->surface,
-                                             &presentSupport);
+        device->internalHandle = device->logicalDevice;
 
-        if (!presentSupport)
+        if (presentWait)
         {
-            return "Graphics queue family does not support presentation";
+            device->waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+                vkGetDeviceProcAddr(device->logicalDevice, "vkWaitForPresentKHR"));
+        }
+        if (calibratedTimestamps)
+        {
+            device->getCalibratedTimestamps = reinterpret_cast<PFN_vkGetCalibratedTimestampsEXT>(
+                vkGetDeviceProcAddr(device->logicalDevice, "vkGetCalibratedTimestampsEXT"));
+        }
+        if (device->meshShaders)
+        {
+            device->drawMeshTasks = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(
+                vkGetDeviceProcAddr(device->logicalDevice, "vkCmdDrawMeshTasksEXT"));
+        }
+        if (device->bufferMarkers)
+        {
+            device->writeBufferMarker = reinterpret_cast<PFN_vkCmdWriteBufferMarkerAMD>(
+                vkGetDeviceProcAddr(device->logicalDevice, "vkCmdWriteBufferMarkerAMD"));
+        }
+        if (device->variableRateShading)
+        {
+            device->setFragmentShadingRate = reinterpret_cast<PFN_vkCmdSetFragmentShadingRateKHR>(
+                vkGetDeviceProcAddr(device->logicalDevice, "vkCmdSetFragmentShadingRateKHR"));
+        }
+
+        // Queue types sharing a family share its queue, and then submit in order with each other
+        for (uint32 queue = 0; queue < kQueueTypes; ++queue)
+        {
+            vkGetDeviceQueue(
+                device->logicalDevice, queueFamilyIndices[queue], 0, &device->queues[queue]);
+
+            if (auto fence = NewFence(device->logicalDevice, 0); fence)
+            {
+                device->frameFences[queue].Reset(static_cast<VulkanFence*>(fence.Value()));
+            }
+            else
+            {
+                return PendingFailure{fence.Category()};
+            }
+        }
+
+        // A pool per recorder per queue per frame in flight, made as they're first needed
+        device->commandRecorders = createInfo.commandRecorders;
+        device->framesInFlight = createInfo.framesInFlight;
+        device->frames.Resize(createInfo.framesInFlight);
+        for (VulkanFrame& frame : device->frames)
+        {
+            for (DynamicArray<VulkanCommandRecorder>& recorders : frame.recorders)
+            {
+                recorders.Resize(createInfo.commandRecorders);
+            }
+        }
+
+        RSBL_LOG_INFO("Command recorders set up: {} recorders, {} frames in flight",
+                      device->commandRecorders,
+                      device->framesInFlight);
+
+        return device.Release();
+    }
+
+    // The first of memoryTypeBits' memory types with all of required, preferring one with
+    // preferred too
+    static bool FindMemoryType(const VkPhysicalDeviceMemoryProperties& properties,
+                               uint32 memoryTypeBits,
+                               VkMemoryPropertyFlags required,
+                               VkMemoryPropertyFlags preferred,
+                               uint32& memoryTypeIndex)
+    {
+        bool found = false;
+        for (uint32 i = 0; i < properties.memoryTypeCount; ++i)
+        {
+            const VkMemoryPropertyFlags flags = properties.memoryTypes[i].propertyFlags;
+            if ((memoryTypeBits & (1u << i)) == 0 || (flags & required) != required)
+            {
+                continue;
+            }
+            if ((flags & preferred) == preferred)
+            {
+                memoryTypeIndex = i;
+                return true;
+            }
+            if (!found)
+            {
+                memoryTypeIndex = i;
+                found = true;
+            }
         }
+        return found;
+    }
 
+    // Makes the swapchain, images and what goes with them for the surface at its current size, or
+    // width by height where the surface leaves it to the swapchain. The swapchain's current ones
+    // are retired, see RetireVulkanSwapchains.
+    static Result<> CreateSwapchainImages(const VulkanDevice& device,
+                                          VulkanSwapchain& swapchain,
+                                          uint32 width,
+                                          uint32 height)
+    {
         // Query surface capabilities using VK_KHR_get_surface_capabilities2
         VkPhysicalDeviceSurfaceInfo2KHR surfaceInfo{};
         surfaceInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SURFACE_INFO_2_KHR;
-        surfaceInfo.surface = swapchain->surface;
+        surfaceInfo.surface = swapchain.surface;
 
         VkSurfaceCapabilities2KHR capabilities2{};
         capabilities2.sType = VK_STRUCTURE_TYPE_SURFACE_CAPABILITIES_2_KHR;
 
-        result = vkGetPhysicalDeviceSurfaceCapabilities2KHR(
-            vulkanDevice->physicalDevice, &surfaceInfo, &capabilities2);
+        VkResult result = vkGetPhysicalDeviceSurfaceCapabilities2KHR(
+            device.physicalDevice, &surfaceInfo, &capabilities2);
         if (result != VK_SUCCESS)
         {
             return "Failed to get surface capabilities";
@@ -324,13 +1249,17 @@ namespace backend
         // Query surface formats using VK_KHR_get_surface_capabilities2
         uint32 formatCount;
         result = vkGetPhysicalDeviceSurfaceFormats2KHR(
-            vulkanDevice->physicalDevice, &surfaceInfo, &formatCount, nullptr);
+            device.physicalDevice, &surfaceInfo, &formatCount, nullptr);
         if (result != VK_SUCCESS || formatCount == 0)
         {
             return "No surface formats available";
         }
 
-        DynamicArray<VkSurfaceFormat2KHR> formats2(formatCount);
+        alignas(16) uint8 scratchBuffer[4096];
+        LinearArena scratchArena(scratchBuffer, sizeof(scratchBuffer));
+
+        DynamicArray<VkSurfaceFormat2KHR> formats2(&scratchArena);
+        formats2.Resize(formatCount);
         for (uint32 i = 0; i < formatCount; ++i)
         {
             formats2[i].sType = VK_STRUCTURE_TYPE_SURFACE_FORMAT_2_KHR;
@@ -338,56 +1267,41 @@ namespace backend
         }
 
         result = vkGetPhysicalDeviceSurfaceFormats2KHR(
-            vulkanDevice->physicalDevice, &surfaceInfo, &formatCount, formats2.Data());
+            device.physicalDevice, &surfaceInfo, &formatCount, formats2.Data());
         if (result != VK_SUCCESS)
         {
             return "Failed to get surface formats";
         }
 
-        // Choose format (prefer B8G8R8A8_UNORM with SRGB_NONLINEAR)
-        VkSurfaceFormatKHR surfaceFormat = formats2[0].surfaceFormat;
-        for (uint32 i = 0; i < formatCount; ++i)
-        {
-            if (formats2[i].surfaceFormat.format == VK_FORMAT_B8G8R8A8_UNORM &&
-                formats2[i].surfaceFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
-            {
-                surfaceFormat = formats2[i].surfaceFormat;
-                break;
-            }
-        }
+        const VkSurfaceFormatKHR surfaceFormat = ChooseSurfaceFormat(formats2);
 
         RSBL_LOG_INFO("Selected surface format: {}", static_cast<int>(surfaceFormat.format));
 
         // Query present modes
         uint32 presentModeCount;
         vkGetPhysicalDeviceSurfacePresentModesKHR(
-            vulkanDevice->physicalDevice, swapchain->surface, &presentModeCount, nullptr);
+            device.physicalDevice, swapchain.surface, &presentModeCount, nullptr);
 
         if (presentModeCount == 0)
         {
             return "No present modes available";
         }
 
-        DynamicArray<VkPresentModeKHR> presentModes(presentModeCount);
-        vkGetPhysicalDeviceSurfacePresentModesKHR(vulkanDevice->physicalDevice,
-                                                  swapchain->surface,
+        DynamicArray<VkPresentModeKHR> presentModes(&scratchArena);
+        presentModes.Resize(presentModeCount);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(device.physicalDevice,
+                                                  swapchain.surface,
                                                   &presentModeCount,
                                                   presentModes.Data());
 
-        // Choose present mode (prefer MAILBOX, fallback to FIFO which is always available)
-        VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
-        for (uint32 i = 0; i < presentModeCount; ++i)
-        {
-            if (presentModes[i] == VK_PRESENT_MODE_MAILBOX_KHR)
-            {
-                presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
-                break;
-            }
-        }
+        const VkPresentModeKHR presentMode =
+            ChoosePresentMode(presentModes, swapchain.requestedMode, swapchain.presentMode);
 
         RSBL_LOG_INFO("Selected present mode: {}", static_cast<int>(presentMode));
 
         // Determine swap extent
+        // TODO: VK_EXT_swapchain_maintenance1's present scaling, so a size below the window's is
+        // stretched over it as DXGI does, instead of being replaced by currentExtent
         VkExtent2D extent;
         if (capabilities.currentExtent.width != UINT32_MAX)
         {
@@ -395,8 +1309,8 @@ namespace backend
         }
         else
         {
-            extent.width = createInfo.width;
-            extent.height = createInfo.height;
+            extent.width = width;
+            extent.height = height;
 
             // Clamp to supported range
             extent.width = extent.width < capabilities.minImageExtent.width
@@ -412,18 +1326,18 @@ namespace backend
         }
 
         // Determine image count (use requested count, but respect surface capabilities)
-        uint32 imageCount = createInfo.bufferCount;
+        uint32 imageCount = swapchain.bufferCount;
         if (imageCount < capabilities.minImageCount)
         {
             RSBL_LOG_WARNING("Requested buffer count {} is less than minimum {}, using minimum",
-                             createInfo.bufferCount,
+                             swapchain.bufferCount,
                              capabilities.minImageCount);
             imageCount = capabilities.minImageCount;
         }
         if (capabilities.maxImageCount > 0 && imageCount > capabilities.maxImageCount)
         {
             RSBL_LOG_WARNING("Requested buffer count {} exceeds maximum {}, using maximum",
-                             createInfo.bufferCount,
+                             swapchain.bufferCount,
                              capabilities.maxImageCount);
             imageCount = capabilities.maxImageCount;
         }
@@ -432,11 +1346,11 @@ namespace backend
             "Swapchain extent: {}x{}, image count: {}", extent.width, extent.height, imageCount);
 
         // Create swapchain
-        FixedArray queueFamilyIndices = {vulkanDevice->graphicsQueueFamilyIndex};
+        FixedArray queueFamilyIndices = {device.graphicsQueueFamilyIndex};
 
         VkSwapchainCreateInfoKHR swapchainCreateInfo{};
         swapchainCreateInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-        swapchainCreateInfo.surface = swapchain->surface;
+        swapchainCreateInfo.surface = swapchain.surface;
         swapchainCreateInfo.minImageCount = imageCount;
         swapchainCreateInfo.imageFormat = surfaceFormat.format;
         swapchainCreateInfo.imageColorSpace = surfaceFormat.colorSpace;
@@ -450,39 +1364,61 @@ namespace backend
         swapchainCreateInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         swapchainCreateInfo.presentMode = presentMode;
         swapchainCreateInfo.clipped = VK_TRUE;
-        swapchainCreateInfo.oldSwapchain = VK_NULL_HANDLE;
-
-        result = vkCreateSwapchainKHR(
-            vulkanDevice->logicalDevice, &swapchainCreateInfo, nullptr, &swapchain->swapchain);
+        // The old one is retired by this, even if it fails. Its images already presented are
+        // still shown, so it's kept until the GPU and the display are done with them.
+        swapchainCreateInfo.oldSwapchain = swapchain.swapchain;
+
+        VkSwapchainKHR created = VK_NULL_HANDLE;
+        result =
+            vkCreateSwapchainKHR(device.logicalDevice, &swapchainCreateInfo, nullptr, &created);
+        if (swapchain.swapchain != VK_NULL_HANDLE)
+        {
+            RetiredVulkanSwapchain retired;
+            retired.swapchain = swapchain.swapchain;
+            retired.imageViews = rsblMove(swapchain.swapchainImageViews);
+            retired.presentSemaphores = rsblMove(swapchain.presentSemaphores);
+            retired.fenceValue = swapchain.lastFenceValue;
+            swapchain.retired.PushBack(rsblMove(retired));
+
+            swapchain.swapchain = VK_NULL_HANDLE;
+            swapchain.swapchainImages.Clear();
+            swapchain.swapchainImageViews.Clear();
+            swapchain.presentSemaphores.Clear();
+        }
         if (result != VK_SUCCESS)
         {
-            return "Failed to create swapchain";
+            return {ErrorCategory::Graphics, "Failed to create swapchain"};
         }
 
-        RSBL_LOG_INFO("Swapchain created: {}", static_cast<void*>(swapchain->swapchain));
+        RSBL_LOG_INFO("Swapchain created: {}", static_cast<void*>(created));
 
-        swapchain->internalHandle = swapchain->swapchain;
+        swapchain.swapchain = created;
+        swapchain.internalHandle = created;
+        swapchain.width = extent.width;
+        swapchain.height = extent.height;
+        swapchain.format = SwapchainFormat(surfaceFormat.format);
+        swapchain.firstPresentId = swapchain.presentId + 1;
 
         // Get swapchain images
         uint32 actualImageCount;
         vkGetSwapchainImagesKHR(
-            vulkanDevice->logicalDevice, swapchain->swapchain, &actualImageCount, nullptr);
+            device.logicalDevice, swapchain.swapchain, &actualImageCount, nullptr);
 
-        swapchain->swapchainImages.Resize(actualImageCount);
-        vkGetSwapchainImagesKHR(vulkanDevice->logicalDevice,
-                                swapchain->swapchain,
+        swapchain.swapchainImages.Resize(actualImageCount);
+        vkGetSwapchainImagesKHR(device.logicalDevice,
+                                swapchain.swapchain,
                                 &actualImageCount,
-                                swapchain->swapchainImages.Data());
+                                swapchain.swapchainImages.Data());
 
         RSBL_LOG_INFO("Retrieved {} swapchain images", actualImageCount);
 
         // Create image views
-        swapchain->swapchainImageViews.Resize(actualImageCount);
+        swapchain.swapchainImageViews.Resize(actualImageCount);
         for (uint32 i = 0; i < actualImageCount; ++i)
         {
             VkImageViewCreateInfo imageViewCreateInfo{};
             imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-            imageViewCreateInfo.image = swapchain->swapchainImages[i];
+            imageViewCreateInfo.image = swapchain.swapchainImages[i];
             imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
             imageViewCreateInfo.format = surfaceFormat.format;
             imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
@@ -495,10 +1431,10 @@ namespace backend
             imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
             imageViewCreateInfo.subresourceRange.layerCount = 1;
 
-            result = vkCreateImageView(vulkanDevice->logicalDevice,
+            result = vkCreateImageView(device.logicalDevice,
                                        &imageViewCreateInfo,
                                        nullptr,
-                                       &swapchain->swapchainImageViews[i]);
+                                       &swapchain.swapchainImageViews[i]);
 
             if (result != VK_SUCCESS)
             {
@@ -507,11 +1443,2649 @@ namespace backend
 
             RSBL_LOG_INFO("Image view {} created: {}",
                           i,
-                          static_cast<void*>(swapchain->swapchainImageViews[i]));
+                          static_cast<void*>(swapchain.swapchainImageViews[i]));
+        }
+
+        // One per image, reused once it's acquired again
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        for (uint32 i = 0; i < actualImageCount; ++i)
+        {
+            VkSemaphore semaphore = VK_NULL_HANDLE;
+            if (vkCreateSemaphore(
+                    device.logicalDevice, &semaphoreCreateInfo, nullptr, &semaphore) != VK_SUCCESS)
+            {
+                return "Failed to create the swapchain's present semaphores";
+            }
+            swapchain.presentSemaphores.PushBack(semaphore);
+        }
+
+        return ResultCode::Success;
+    }
+
+    // In UNDEFINED, as a swapchain's images start out: the frame's first barrier discards them
+    static Result<> CreateOffscreenImages(VulkanOffscreenSwapchain& swapchain,
+                                          uint32 bufferCount,
+                                          uint32 width,
+                                          uint32 height)
+    {
+        swapchain.DestroyImages();
+
+        VkImageCreateInfo imageCreateInfo{};
+        imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageCreateInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
+        imageCreateInfo.extent = {width, height, 1};
+        imageCreateInfo.mipLevels = 1;
+        imageCreateInfo.arrayLayers = 1;
+        imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        const VkDevice device = swapchain.device;
+        for (uint32 i = 0; i < bufferCount; ++i)
+        {
+            VkImage image = VK_NULL_HANDLE;
+            if (vkCreateImage(device, &imageCreateInfo, nullptr, &image) != VK_SUCCESS)
+            {
+                return "Failed to create an offscreen swapchain image";
+            }
+            swapchain.images.PushBack(image);
+
+            VkMemoryRequirements requirements;
+            vkGetImageMemoryRequirements(device, image, &requirements);
+            uint32 memoryTypeIndex = 0;
+            if (!FindMemoryType(swapchain.vulkanDevice->memoryProperties,
+                                requirements.memoryTypeBits,
+                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                0,
+                                memoryTypeIndex))
+            {
+                return "No Vulkan memory type for the offscreen swapchain";
+            }
+            VkMemoryAllocateInfo allocateInfo{};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocateInfo.allocationSize = requirements.size;
+            allocateInfo.memoryTypeIndex = memoryTypeIndex;
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            if (vkAllocateMemory(device, &allocateInfo, nullptr, &memory) != VK_SUCCESS)
+            {
+                return {ErrorCategory::OutOfMemory,
+                        "Failed to allocate the offscreen swapchain's memory"};
+            }
+            swapchain.memory.PushBack(memory);
+            if (vkBindImageMemory(device, image, memory, 0) != VK_SUCCESS)
+            {
+                return "Failed to bind the offscreen swapchain's memory";
+            }
+
+            VkImageViewCreateInfo imageViewCreateInfo{};
+            imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            imageViewCreateInfo.image = image;
+            imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            imageViewCreateInfo.format = imageCreateInfo.format;
+            imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            imageViewCreateInfo.subresourceRange.levelCount = 1;
+            imageViewCreateInfo.subresourceRange.layerCount = 1;
+            VkImageView view = VK_NULL_HANDLE;
+            if (vkCreateImageView(device, &imageViewCreateInfo, nullptr, &view) != VK_SUCCESS)
+            {
+                return "Failed to create image view";
+            }
+            swapchain.imageViews.PushBack(view);
+        }
+
+        swapchain.width = width;
+        swapchain.height = height;
+        swapchain.currentBuffer = 0;
+        swapchain.backBuffer = swapchain.images[0];
+        return ResultCode::Success;
+    }
+
+    static Result<gaSwapchain*> CreateOffscreenSwapchain(VulkanDevice* vulkanDevice,
+                                                         const gaSwapchainCreateInfo& createInfo)
+    {
+        if (createInfo.width == 0 || createInfo.height == 0)
+        {
+            return {ErrorCategory::InvalidArgument, "Offscreen swapchains need a size"};
+        }
+        if (createInfo.bufferCount < 2 || createInfo.bufferCount > 4)
+        {
+            return {ErrorCategory::InvalidArgument,
+                    "Swapchain buffer count must be between 2 and 4"};
+        }
+
+        auto swapchain = rsbl::UniquePtr(new VulkanOffscreenSwapchain());
+        swapchain->vulkanDevice = vulkanDevice;
+        swapchain->device = vulkanDevice->logicalDevice;
+        swapchain->format = gaFormat::R8G8B8A8Unorm;
+        swapchain->frameFence =
+            vulkanDevice->frameFences[static_cast<uint32>(gaQueueType::Graphics)].Get();
+        if (auto created = CreateOffscreenImages(
+                *swapchain, createInfo.bufferCount, createInfo.width, createInfo.height);
+            !created)
+        {
+            return PendingFailure{created.Category()};
+        }
+
+        RSBL_LOG_INFO("Offscreen swapchain created: {} images of {}x{}",
+                      createInfo.bufferCount,
+                      createInfo.width,
+                      createInfo.height);
+        return swapchain.Release();
+    }
+
+    Result<gaSwapchain*> CreateVulkanSwapchain(const gaSwapchainCreateInfo& createInfo)
+    {
+        RSBL_LOG_INFO("Creating Vulkan swapchain...");
+
+        // Cast to Vulkan device
+        auto vulkanDevice = static_cast<VulkanDevice*>(createInfo.device);
+
+        if (createInfo.offscreen)
+        {
+            return CreateOffscreenSwapchain(vulkanDevice, createInfo);
+        }
+
+        if (createInfo.windowHandle == nullptr)
+        {
+            return "Invalid window handle";
+        }
+
+        if (createInfo.appHandle == nullptr)
+        {
+            return "Invalid application handle";
+        }
+
+        auto swapchain = rsbl::UniquePtr(new VulkanSwapchain());
+        swapchain->device = vulkanDevice->logicalDevice;
+        swapchain->instance = vulkanDevice->instance;
+        swapchain->waitForPresent = vulkanDevice->waitForPresent;
+        swapchain->maxFrameLatency = createInfo.maxFrameLatency;
+
+#if defined(VK_USE_PLATFORM_XLIB_KHR)
+        // Create Xlib surface, the window is an XID rather than a pointer
+        VkXlibSurfaceCreateInfoKHR surfaceCreateInfo{};
+        surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_XLIB_SURFACE_CREATE_INFO_KHR;
+        surfaceCreateInfo.dpy = static_cast<Display*>(createInfo.appHandle);
+        surfaceCreateInfo.window = reinterpret_cast<::Window>(createInfo.windowHandle);
+
+        VkResult result = vkCreateXlibSurfaceKHR(
+            vulkanDevice->instance, &surfaceCreateInfo, nullptr, &swapchain->surface);
+        if (result != VK_SUCCESS)
+        {
+            return "Failed to create Xlib surface";
+        }
+
+        RSBL_LOG_INFO("Xlib surface created: {}", static_cast<void*>(swapchain->surface));
+#else
+        // Create Win32 surface
+        VkWin32SurfaceCreateInfoKHR surfaceCreateInfo{};
+        surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
+        surfaceCreateInfo.hwnd = static_cast<HWND>(createInfo.windowHandle);
+        surfaceCreateInfo.hinstance = static_cast<HINSTANCE>(createInfo.appHandle);
+
+        VkResult result = vkCreateWin32SurfaceKHR(
+            vulkanDevice->instance, &surfaceCreateInfo, nullptr, &swapchain->surface);
+        if (result != VK_SUCCESS)
+        {
+            return "Failed to create Win32 surface";
+        }
+
+        RSBL_LOG_INFO("Win32 surface created: {}", static_cast<void*>(swapchain->surface));
+#endif
+
+        // Check if queue family supports presentation
+        VkBool32 presentSupport = false;
+        vkGetPhysicalDeviceSurfaceSupportKHR(vulkanDevice->physicalDevice,
+                                             vulkanDevice->graphicsQueueFamilyIndex,
+                                             swapchain->surface,
+                                             &presentSupport);
+
+        if (!presentSupport)
+        {
+            return "Graphics queue family does not support presentation";
+        }
+
+        swapchain->bufferCount = createInfo.bufferCount;
+        swapchain->requestedMode = createInfo.presentMode;
+        if (auto created = CreateSwapchainImages(
+                *vulkanDevice, *swapchain, createInfo.width, createInfo.height);
+            !created)
+        {
+            return PendingFailure{created.Category()};
+        }
+
+        VkFenceCreateInfo fenceCreateInfo{};
+        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(vulkanDevice->logicalDevice,
+                          &fenceCreateInfo,
+                          nullptr,
+                          &swapchain->acquireFence) != VK_SUCCESS)
+        {
+            return "Failed to create the swapchain's acquire fence";
         }
 
+        swapchain->queue = vulkanDevice->queues[static_cast<uint32>(gaQueueType::Graphics)];
+        swapchain->frameFence =
+            vulkanDevice->frameFences[static_cast<uint32>(gaQueueType::Graphics)].Get();
+        swapchain->vulkanDevice = vulkanDevice;
+
         return swapchain.Release();
     }
 
+    // Destroys the retired swapchains the GPU is done rendering to, and the display done showing:
+    // once the current swapchain has presented, the display has moved on to it
+    static void DestroyRetiredSwapchains(VulkanSwapchain& swapchain)
+    {
+        uint64 reached = 0;
+        vkGetSemaphoreCounterValue(swapchain.device, swapchain.frameFence->semaphore, &reached);
+        for (uint64 i = swapchain.retired.Size(); i > 0; --i)
+        {
+            RetiredVulkanSwapchain& old = swapchain.retired[i - 1];
+            if (old.fenceValue <= reached && swapchain.presentId >= swapchain.firstPresentId)
+            {
+                old.Destroy(swapchain.device);
+                if (i < swapchain.retired.Size())
+                {
+                    old = rsblMove(swapchain.retired[swapchain.retired.Size() - 1]);
+                }
+                swapchain.retired.PopBack();
+            }
+        }
+    }
+
+    static Result<> AcquireImage(VulkanSwapchain* swapchain, uint32 timeoutMs)
+    {
+        if (swapchain->ready)
+        {
+            return ResultCode::Success;
+        }
+
+        const uint64 timeoutNs = timeoutMs == ~0u ? UINT64_MAX : timeoutMs * 1'000'000ull;
+        if (!swapchain->acquired)
+        {
+            // Until no more than maxFrameLatency presents are still waiting to be shown. Ids
+            // from before a resize are the old swapchain's, which the new one never reaches.
+            const uint64 latency = swapchain->maxFrameLatency;
+            if (swapchain->waitForPresent != nullptr &&
+                swapchain->presentId >= swapchain->firstPresentId + latency)
+            {
+                const VkResult waited = swapchain->waitForPresent(swapchain->device,
+                                                                  swapchain->swapchain,
+                                                                  swapchain->presentId - latency,
+                                                                  timeoutNs);
+                if (waited == VK_TIMEOUT)
+                {
+                    return {ErrorCategory::Timeout, "Timed out waiting for the swapchain"};
+                }
+                if (waited != VK_SUCCESS && waited != VK_SUBOPTIMAL_KHR)
+                {
+                    return {ErrorCategory::Graphics, "Failed to wait for a present"};
+                }
+                if (swapchain->presentId - latency > swapchain->displayedId)
+                {
+                    swapchain->displayedId = swapchain->presentId - latency;
+                    swapchain->displayedTicks = Clock::NowTicks();
+                }
+            }
+
+            uint32 imageIndex = 0;
+            const VkResult acquired = vkAcquireNextImageKHR(swapchain->device,
+                                                            swapchain->swapchain,
+                                                            timeoutNs,
+                                                            VK_NULL_HANDLE,
+                                                            swapchain->acquireFence,
+                                                            &imageIndex);
+            if (acquired == VK_TIMEOUT || acquired == VK_NOT_READY)
+            {
+                return {ErrorCategory::Timeout, "Timed out waiting for the swapchain"};
+            }
+            if (acquired == VK_ERROR_OUT_OF_DATE_KHR)
+            {
+                return {ErrorCategory::Graphics, "The swapchain no longer matches its window"};
+            }
+            if (acquired != VK_SUCCESS && acquired != VK_SUBOPTIMAL_KHR)
+            {
+                return {ErrorCategory::Graphics, "Failed to acquire a swapchain image"};
+            }
+            swapchain->acquired = true;
+            swapchain->currentBuffer = imageIndex;
+            swapchain->backBuffer = swapchain->swapchainImages[imageIndex];
+        }
+
+        // Signalled once the presentation engine is done with the image
+        const VkResult waited =
+            vkWaitForFences(swapchain->device, 1, &swapchain->acquireFence, VK_TRUE, timeoutNs);
+        if (waited == VK_TIMEOUT)
+        {
+            return {ErrorCategory::Timeout, "Timed out waiting for the swapchain"};
+        }
+        if (waited != VK_SUCCESS ||
+            vkResetFences(swapchain->device, 1, &swapchain->acquireFence) != VK_SUCCESS)
+        {
+            return {ErrorCategory::Graphics, "Failed to wait for a swapchain image"};
+        }
+        swapchain->ready = true;
+        return ResultCode::Success;
+    }
+
+    // Nothing to acquire, only a resize, which waits for the frames rendering to the old images
+    static Result<> WaitForOffscreenSwapchain(VulkanOffscreenSwapchain& swapchain)
+    {
+        const bool same = swapchain.resizeWidth == swapchain.width &&
+                          swapchain.resizeHeight == swapchain.height;
+        if (swapchain.resizeWidth == 0 || swapchain.resizeHeight == 0 || same)
+        {
+            return ResultCode::Success;
+        }
+
+        if (!swapchain.frameFence->Wait(swapchain.lastFenceValue))
+        {
+            return {ErrorCategory::Graphics, "Failed to wait on the offscreen images' frames"};
+        }
+        return CreateOffscreenImages(swapchain,
+                                     static_cast<uint32>(swapchain.images.Size()),
+                                     swapchain.resizeWidth,
+                                     swapchain.resizeHeight);
+    }
+
+    Result<> WaitForVulkanSwapchain(gaSwapchain* baseSwapchain, uint32 timeoutMs)
+    {
+        if (baseSwapchain->offscreen)
+        {
+            return WaitForOffscreenSwapchain(
+                *static_cast<VulkanOffscreenSwapchain*>(baseSwapchain));
+        }
+
+        auto swapchain = static_cast<VulkanSwapchain*>(baseSwapchain);
+        if (!swapchain->acquired)
+        {
+            DestroyRetiredSwapchains(*swapchain);
+
+            // A new swapchain straight away, before the frame renders, with the old one's images
+            // left to finish. Nothing waits for the GPU, the old one's frames run on while the
+            // new one's are recorded.
+            const bool resize = swapchain->resizeWidth != 0 && swapchain->resizeHeight != 0 &&
+                                (swapchain->resizeWidth != swapchain->width ||
+                                 swapchain->resizeHeight != swapchain->height);
+            if (resize)
+            {
+                if (auto created = CreateSwapchainImages(*swapchain->vulkanDevice,
+                                                         *swapchain,
+                                                         swapchain->resizeWidth,
+                                                         swapchain->resizeHeight);
+                    !created)
+                {
+                    return created;
+                }
+            }
+        }
+        return AcquireImage(swapchain, timeoutMs);
+    }
+
+    Result<> PresentVulkan(gaSwapchain* baseSwapchain)
+    {
+        if (baseSwapchain->offscreen)
+        {
+            auto offscreen = static_cast<VulkanOffscreenSwapchain*>(baseSwapchain);
+            offscreen->lastFenceValue = offscreen->frameFence->signalledValue;
+            offscreen->currentBuffer = (offscreen->currentBuffer + 1) % offscreen->images.Size();
+            offscreen->backBuffer = offscreen->images[offscreen->currentBuffer];
+            return ResultCode::Success;
+        }
+
+        auto swapchain = static_cast<VulkanSwapchain*>(baseSwapchain);
+        if (auto acquired = AcquireImage(swapchain, ~0u); !acquired)
+        {
+            return acquired;
+        }
+
+        // A submit with no command buffers, only the signal, which comes after everything
+        // submitted to the queue before it
+        VkSemaphoreSubmitInfo signalInfo{};
+        signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        signalInfo.semaphore = swapchain->presentSemaphores[swapchain->currentBuffer];
+        signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        VkSubmitInfo2 submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        submitInfo.signalSemaphoreInfoCount = 1;
+        submitInfo.pSignalSemaphoreInfos = &signalInfo;
+        if (vkQueueSubmit2(swapchain->queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            return {ErrorCategory::Graphics, "Failed to submit the present's signal"};
+        }
+
+        const uint64 presentId = swapchain->presentId + 1;
+        VkPresentIdKHR presentIdInfo{};
+        presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        presentIdInfo.swapchainCount = 1;
+        presentIdInfo.pPresentIds = &presentId;
+
+        const uint32 imageIndex = swapchain->currentBuffer;
+        VkPresentInfoKHR presentInfo{};
+        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+        presentInfo.pNext = swapchain->waitForPresent != nullptr ? &presentIdInfo : nullptr;
+        presentInfo.waitSemaphoreCount = 1;
+        presentInfo.pWaitSemaphores = &semaphore;
+        presentInfo.swapchainCount = 1;
+        presentInfo.pSwapchains = &swapchain->swapchain;
+        presentInfo.pImageIndices = &imageIndex;
+
+        const VkResult presented = vkQueuePresentKHR(swapchain->queue, &presentInfo);
+        swapchain->acquired = false;
+        swapchain->ready = false;
+        swapchain->presentId = presentId;
+        swapchain->lastFenceValue = swapchain->frameFence->signalledValue;
+        if (presented == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            return {ErrorCategory::Graphics, "The swapchain no longer matches its window"};
+        }
+        if (presented != VK_SUCCESS && presented != VK_SUBOPTIMAL_KHR)
+        {
+            return {ErrorCategory::Graphics, "Failed to present"};
+        }
+        return ResultCode::Success;
+    }
+
+    Result<> GetVulkanPresentStats(gaSwapchain* baseSwapchain, gaPresentStats& presentStats)
+    {
+        auto swapchain = static_cast<VulkanSwapchain*>(baseSwapchain);
+        if (swapchain->waitForPresent == nullptr)
+        {
+            return {ErrorCategory::NotFound, "Present stats need VK_KHR_present_wait"};
+        }
+
+        // Newest first, once one's shown so is everything before it. Ids from before a resize
+        // are the old swapchain's, which the new one never reaches.
+        const uint64 oldest = swapchain->displayedId + 1 > swapchain->firstPresentId
+                                  ? swapchain->displayedId + 1
+                                  : swapchain->firstPresentId;
+        for (uint64 id = swapchain->presentId; id >= oldest; --id)
+        {
+            const VkResult waited =
+                swapchain->waitForPresent(swapchain->device, swapchain->swapchain, id, 0);
+            if (waited == VK_SUCCESS || waited == VK_SUBOPTIMAL_KHR)
+            {
+                swapchain->displayedId = id;
+                swapchain->displayedTicks = Clock::NowTicks();
+                break;
+            }
+            if (waited != VK_TIMEOUT)
+            {
+                return {ErrorCategory::Graphics, "Failed to check on a present"};
+            }
+        }
+
+        // Present ids only count the presents that got as far as the queue
+        const uint64 behind = swapchain->presentId - swapchain->displayedId;
+        presentStats.displayedPresent =
+            swapchain->displayedId != 0 ? swapchain->presentCount - behind : 0;
+        presentStats.displayedTicks = swapchain->displayedTicks;
+        presentStats.exact = false;
+        return ResultCode::Success;
+    }
+
+    Result<> BeginVulkanFrame(gaDevice* baseDevice)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        VulkanFrame& frame = device->CurrentFrame();
+        for (DynamicArray<VulkanCommandRecorder>& recorders : frame.recorders)
+        {
+            for (VulkanCommandRecorder& recorder : recorders)
+            {
+                if (recorder.used > 0 && recorder.lists[recorder.used - 1]->recording)
+                {
+                    return "A command list from framesInFlight frames back is still recording";
+                }
+            }
+        }
+
+        for (uint32 queue = 0; queue < kQueueTypes; ++queue)
+        {
+            if (!device->frameFences[queue]->Wait(frame.fenceValues[queue]))
+            {
+                return "Failed to wait for a frame in flight";
+            }
+
+            for (VulkanCommandRecorder& recorder : frame.recorders[queue])
+            {
+                if (recorder.used > 0 &&
+                    vkResetCommandPool(device->logicalDevice, recorder.pool, 0) != VK_SUCCESS)
+                {
+                    return "Failed to reset a command pool";
+                }
+                recorder.used = 0;
+            }
+        }
+        return ResultCode::Success;
+    }
+
+    Result<> WaitForVulkanIdle(gaDevice* baseDevice)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        if (vkDeviceWaitIdle(device->logicalDevice) != VK_SUCCESS)
+        {
+            return "Failed to wait for the GPU to go idle";
+        }
+        return ResultCode::Success;
+    }
+
+    Result<gaCommandList*> BeginVulkanCommandList(gaDevice* baseDevice,
+                                                  gaQueueType queue,
+                                                  uint32 recorderIndex)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        const uint32 queueIndex = static_cast<uint32>(queue);
+        VulkanCommandRecorder& recorder =
+            device->CurrentFrame().recorders[queueIndex][recorderIndex];
+
+        // A pool is only ever used from one thread at a time
+        if (recorder.used > 0 && recorder.lists[recorder.used - 1]->recording)
+        {
+            return "The recorder is already recording a command list";
+        }
+
+        // Transient since it's reset every frame, and its buffers only go to its queue's family
+        if (recorder.pool == VK_NULL_HANDLE)
+        {
+            VkCommandPoolCreateInfo poolCreateInfo{};
+            poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolCreateInfo.queueFamilyIndex = device->queueFamilyIndices[queueIndex];
+            if (vkCreateCommandPool(
+                    device->logicalDevice, &poolCreateInfo, nullptr, &recorder.pool) != VK_SUCCESS)
+            {
+                return "Failed to create a command pool";
+            }
+        }
+
+        if (recorder.used == recorder.lists.Size())
+        {
+            auto list = rsbl::UniquePtr(new VulkanCommandList());
+
+            VkCommandBufferAllocateInfo allocateInfo{};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.commandPool = recorder.pool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 1;
+            VkResult result = vkAllocateCommandBuffers(
+                device->logicalDevice, &allocateInfo, &list->commandBuffer);
+            if (result != VK_SUCCESS)
+            {
+                return "Failed to allocate a command buffer";
+            }
+            list->internalHandle = list->commandBuffer;
+            recorder.lists.PushBack(rsblMove(list));
+        }
+
+        VulkanCommandList* list = recorder.lists[recorder.used].Get();
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vkBeginCommandBuffer(list->commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            return "Failed to begin the command buffer";
+        }
+        ++recorder.used;
+        return list;
+    }
+
+    Result<> EndVulkanCommandList(gaCommandList* list)
+    {
+        if (vkEndCommandBuffer(static_cast<VulkanCommandList*>(list)->commandBuffer) != VK_SUCCESS)
+        {
+            return "Failed to end the command buffer";
+        }
+        return ResultCode::Success;
+    }
+
+    Result<> SubmitVulkan(gaDevice* baseDevice,
+                          gaQueueType queue,
+                          ArrayView<gaCommandList* const> lists)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+
+        // A frame submits a few dozen lists at most, usually
+        SmallArray<VkCommandBufferSubmitInfo, 64> commandBuffers;
+        commandBuffers.Reserve(lists.Size());
+        for (gaCommandList* list : lists)
+        {
+            VkCommandBufferSubmitInfo commandBufferInfo{};
+            commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+            commandBufferInfo.commandBuffer = static_cast<VulkanCommandList*>(list)->commandBuffer;
+            commandBuffers.PushBack(commandBufferInfo);
+        }
+
+        const uint32 queueIndex = static_cast<uint32>(queue);
+        VulkanFence& fence = *device->frameFences[queueIndex];
+        const uint64 signalValue = fence.signalledValue + 1;
+        VkSemaphoreSubmitInfo signalInfo{};
+        signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        signalInfo.semaphore = fence.semaphore;
+        signalInfo.value = signalValue;
+        signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+        VkSubmitInfo2 submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        submitInfo.commandBufferInfoCount = static_cast<uint32>(commandBuffers.Size());
+        submitInfo.pCommandBufferInfos = commandBuffers.Data();
+        submitInfo.signalSemaphoreInfoCount = 1;
+        submitInfo.pSignalSemaphoreInfos = &signalInfo;
+
+        if (vkQueueSubmit2(device->queues[queueIndex], 1, &submitInfo, VK_NULL_HANDLE) !=
+            VK_SUCCESS)
+        {
+            return "Failed to submit the command lists";
+        }
+        fence.signalledValue = signalValue;
+        device->CurrentFrame().fenceValues[queueIndex] = signalValue;
+        return ResultCode::Success;
+    }
+
+    Result<gaFence*> CreateVulkanFence(gaDevice* baseDevice, uint64 initialValue)
+    {
+        return NewFence(static_cast<VulkanDevice*>(baseDevice)->logicalDevice, initialValue);
+    }
+
+    // A submit with no command buffers, only the signal
+    Result<> SignalVulkanFence(gaDevice* baseDevice,
+                               gaQueueType queue,
+                               gaFence* fence,
+                               uint64 value)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        VkSemaphoreSubmitInfo signalInfo{};
+        signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        signalInfo.semaphore = static_cast<VulkanFence*>(fence)->semaphore;
+        signalInfo.value = value;
+        signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+        VkSubmitInfo2 submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        submitInfo.signalSemaphoreInfoCount = 1;
+        submitInfo.pSignalSemaphoreInfos = &signalInfo;
+
+        if (vkQueueSubmit2(device->queues[static_cast<uint32>(queue)],
+                          1,
+                          &submitInfo,
+                          VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            return "Failed to signal the fence";
+        }
+        return ResultCode::Success;
+    }
+
+    // A submit with no command buffers, only the wait, which holds back everything submitted to
+    // the queue after it
+    Result<> QueueWaitForVulkanFence(gaDevice* baseDevice,
+                                     gaQueueType queue,
+                                     gaFence* fence,
+                                     uint64 value)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        VkSemaphoreSubmitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        waitInfo.semaphore = static_cast<VulkanFence*>(fence)->semaphore;
+        waitInfo.value = value;
+        waitInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+        VkSubmitInfo2 submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        submitInfo.waitSemaphoreInfoCount = 1;
+        submitInfo.pWaitSemaphoreInfos = &waitInfo;
+
+        if (vkQueueSubmit2(device->queues[static_cast<uint32>(queue)],
+                          1,
+                          &submitInfo,
+                          VK_NULL_HANDLE) != VK_SUCCESS)
+        {
+            return "Failed to make the queue wait for the fence";
+        }
+        return ResultCode::Success;
+    }
+
+    uint64 GetVulkanFenceValue(gaFence* fence)
+    {
+        auto vulkanFence = static_cast<VulkanFence*>(fence);
+        uint64 value = 0;
+        vkGetSemaphoreCounterValue(vulkanFence->device, vulkanFence->semaphore, &value);
+        return value;
+    }
+
+    Result<> WaitForVulkanFence(gaFence* fence, uint64 value)
+    {
+        if (!static_cast<VulkanFence*>(fence)->Wait(value))
+        {
+            return "Failed to wait for the fence";
+        }
+        return ResultCode::Success;
+    }
+
+    struct VulkanMemoryHeap : public gaMemoryHeap
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+
+        VulkanMemoryHeap()
+        {
+            backend = gaBackend::Vulkan;
+            internalHandle = nullptr;
+        }
+
+        ~VulkanMemoryHeap() override
+        {
+            if (memory != VK_NULL_HANDLE)
+            {
+                vkFreeMemory(device, memory, nullptr);
+                memory = VK_NULL_HANDLE;
+            }
+        }
+    };
+
+    Result<gaMemoryHeap*> CreateVulkanMemoryHeap(gaDevice* baseDevice,
+                                                 gaMemoryType type,
+                                                 uint64 size,
+                                                 uint64 alignment)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+
+        // Upload is written through a coherent mapping, readback is read through a cached one
+        VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        VkMemoryPropertyFlags preferred = 0;
+        if (type == gaMemoryType::Upload)
+        {
+            required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        }
+        else if (type == gaMemoryType::Readback)
+        {
+            required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+            preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        }
+
+        // Heaps are created before the resources placed in them, so there are no memoryTypeBits
+        // to go by. Every driver allows buffers and images the usual types for each.
+        uint32 memoryTypeIndex = 0;
+        if (!FindMemoryType(device->memoryProperties, ~0u, required, preferred, memoryTypeIndex))
+        {
+            return "No Vulkan memory type for the heap";
+        }
+
+        // vkAllocateMemory aligns to anything a resource asks for
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = size;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+        auto heap = rsbl::UniquePtr(new VulkanMemoryHeap());
+        heap->device = device->logicalDevice;
+        if (vkAllocateMemory(device->logicalDevice, &allocateInfo, nullptr, &heap->memory) !=
+            VK_SUCCESS)
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to allocate Vulkan device memory"};
+        }
+        heap->internalHandle = heap->memory;
+        return heap.Release();
+    }
+
+    Result<gaMemoryBudget> QueryVulkanMemoryBudget(gaDevice* baseDevice)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        const VkPhysicalDeviceMemoryProperties& properties = device->memoryProperties;
+
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+        if (device->memoryBudget)
+        {
+            VkPhysicalDeviceMemoryProperties2 properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+            properties2.pNext = &budgetProperties;
+            vkGetPhysicalDeviceMemoryProperties2(device->physicalDevice, &properties2);
+        }
+
+        gaMemoryBudget budget;
+        for (uint32 i = 0; i < properties.memoryHeapCount; ++i)
+        {
+            // Without the extension there's no usage to report, and the budget is taken to be
+            // most of the heap, since other processes and the driver want some
+            const uint64 heapBudget = device->memoryBudget
+                                          ? budgetProperties.heapBudget[i]
+                                          : properties.memoryHeaps[i].size / 10 * 8;
+            const uint64 heapUsage = device->memoryBudget ? budgetProperties.heapUsage[i] : 0;
+            if (properties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+            {
+                budget.localBudget += heapBudget;
+                budget.localUsage += heapUsage;
+            }
+            else
+            {
+                budget.nonLocalBudget += heapBudget;
+                budget.nonLocalUsage += heapUsage;
+            }
+        }
+        return budget;
+    }
+
+    // The skinning shader is HLSL compiled at runtime, which DX12 can do through d3dcompiler.
+    // Vulkan needs it as SPIR-V, and there's no shader compiler in the build to make that yet.
+    Result<gaSkinningPass*> CreateVulkanSkinningPass(const gaSkinningPassCreateInfo& createInfo)
+    {
+        return "Compute skinning is not available on the Vulkan backend yet";
+    }
+
+    // The same goes for the culling shaders
+    Result<gaCullingPass*> CreateVulkanCullingPass(const gaCullingPassCreateInfo& createInfo)
+    {
+        return "GPU culling is not available on the Vulkan backend yet";
+    }
+
+    // And the light binning shader
+    Result<gaLightBinningPass*> CreateVulkanLightBinningPass(
+        const gaLightBinningPassCreateInfo& createInfo)
+    {
+        return "Light binning is not available on the Vulkan backend yet";
+    }
+
+    // And the upscaler's shader
+    Result<gaUpscaler*> CreateVulkanUpscaler(const gaUpscalerCreateInfo& createInfo)
+    {
+        return "Upscaling is not available on the Vulkan backend yet";
+    }
+
+    // And the mip generation shader
+    Result<gaMipGenerationPass*> CreateVulkanMipGenerationPass(
+        const gaMipGenerationPassCreateInfo& createInfo)
+    {
+        return "Mip generation is not available on the Vulkan backend yet";
+    }
+
+    struct VulkanUploadBuffer : public UploadBuffer
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+
+        ~VulkanUploadBuffer() override
+        {
+            if (buffer != VK_NULL_HANDLE)
+            {
+                vkDestroyBuffer(device, buffer, nullptr);
+            }
+            if (memory != VK_NULL_HANDLE)
+            {
+                // Freeing mapped memory unmaps it
+                vkFreeMemory(device, memory, nullptr);
+            }
+        }
+    };
+
+    Result<UploadBuffer*> CreateVulkanUploadBuffer(gaDevice* baseDevice, uint64 size)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        auto buffer = rsbl::UniquePtr(new VulkanUploadBuffer());
+        buffer->device = device->logicalDevice;
+
+        VkBufferCreateInfo bufferCreateInfo{};
+        bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferCreateInfo.size = size;
+        bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &buffer->buffer) !=
+            VK_SUCCESS)
+        {
+            return "Failed to create the upload ring buffer";
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device->logicalDevice, buffer->buffer, &requirements);
+
+        // Coherent, so writes need no flush before the copies read them
+        uint32 memoryTypeIndex = 0;
+        if (!FindMemoryType(device->memoryProperties,
+                            requirements.memoryTypeBits,
+                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            0,
+                            memoryTypeIndex))
+        {
+            return "No Vulkan memory type for the upload ring";
+        }
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex;
+        if (vkAllocateMemory(device->logicalDevice, &allocateInfo, nullptr, &buffer->memory) !=
+            VK_SUCCESS)
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to allocate the upload ring's memory"};
+        }
+
+        void* data = nullptr;
+        if (vkBindBufferMemory(device->logicalDevice, buffer->buffer, buffer->memory, 0) !=
+                VK_SUCCESS ||
+            vkMapMemory(device->logicalDevice, buffer->memory, 0, VK_WHOLE_SIZE, 0, &data) !=
+                VK_SUCCESS)
+        {
+            return "Failed to map the upload ring buffer";
+        }
+        buffer->handle = buffer->buffer;
+        buffer->data = static_cast<uint8*>(data);
+        return buffer.Release();
+    }
+
+    void RecordVulkanBufferCopies(gaCommandList* list,
+                                  UploadBuffer* source,
+                                  ArrayView<const BufferCopy> copies)
+    {
+        VkCommandBuffer commandBuffer = static_cast<VulkanCommandList*>(list)->commandBuffer;
+        VkBuffer sourceBuffer = static_cast<VulkanUploadBuffer*>(source)->buffer;
+
+        // One vkCmdCopyBuffer per run of copies to the same buffer
+        SmallArray<VkBufferCopy, 64> regions;
+        for (uint64 i = 0; i < copies.Size(); ++i)
+        {
+            regions.PushBack({copies[i].sourceOffset, copies[i].destinationOffset, copies[i].size});
+            if (i + 1 == copies.Size() || copies[i + 1].destination != copies[i].destination)
+            {
+                vkCmdCopyBuffer(commandBuffer,
+                                sourceBuffer,
+                                static_cast<VkBuffer>(copies[i].destination),
+                                static_cast<uint32>(regions.Size()),
+                                regions.Data());
+                regions.Clear();
+            }
+        }
+
+        // Whatever is submitted after reads the copied data
+        VkMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+        VkDependencyInfo dependency{};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.memoryBarrierCount = 1;
+        dependency.pMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(commandBuffer, &dependency);
+    }
+
+    struct VulkanReadbackBuffer : public ReadbackBuffer
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+
+        ~VulkanReadbackBuffer() override
+        {
+            if (buffer != VK_NULL_HANDLE)
+            {
+                vkDestroyBuffer(device, buffer, nullptr);
+            }
+            if (memory != VK_NULL_HANDLE)
+            {
+                vkFreeMemory(device, memory, nullptr);
+            }
+        }
+    };
+
+    Result<ReadbackBuffer*> CreateVulkanReadbackBuffer(gaDevice* baseDevice, uint64 size)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        auto buffer = rsbl::UniquePtr(new VulkanReadbackBuffer());
+        buffer->device = device->logicalDevice;
+
+        VkBufferCreateInfo bufferCreateInfo{};
+        bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferCreateInfo.size = size;
+        bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &buffer->buffer) !=
+            VK_SUCCESS)
+        {
+            return "Failed to create the readback ring buffer";
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device->logicalDevice, buffer->buffer, &requirements);
+
+        // Coherent, so the copies need no invalidate before they're read, and cached where
+        // there's a type that's both, as uncached reads are very slow
+        uint32 memoryTypeIndex = 0;
+        if (!FindMemoryType(device->memoryProperties,
+                            requirements.memoryTypeBits,
+                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+                            memoryTypeIndex))
+        {
+            return "No Vulkan memory type for the readback ring";
+        }
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex;
+        if (vkAllocateMemory(device->logicalDevice, &allocateInfo, nullptr, &buffer->memory) !=
+            VK_SUCCESS)
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to allocate the readback ring's memory"};
+        }
+
+        void* data = nullptr;
+        if (vkBindBufferMemory(device->logicalDevice, buffer->buffer, buffer->memory, 0) !=
+                VK_SUCCESS ||
+            vkMapMemory(device->logicalDevice, buffer->memory, 0, VK_WHOLE_SIZE, 0, &data) !=
+                VK_SUCCESS)
+        {
+            return "Failed to map the readback ring buffer";
+        }
+        buffer->handle = buffer->buffer;
+        buffer->data = static_cast<const uint8*>(data);
+        return buffer.Release();
+    }
+
+    void RecordVulkanReadbackCopies(gaCommandList* list,
+                                    ReadbackBuffer* destination,
+                                    ArrayView<const ReadbackCopy> copies)
+    {
+        VkCommandBuffer commandBuffer = static_cast<VulkanCommandList*>(list)->commandBuffer;
+        VkBuffer destinationBuffer = static_cast<VulkanReadbackBuffer*>(destination)->buffer;
+
+        // Whatever was submitted before wrote the sources
+        VkMemoryBarrier2 before{};
+        before.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        before.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        before.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+        before.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        before.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+        VkDependencyInfo dependency{};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.memoryBarrierCount = 1;
+        dependency.pMemoryBarriers = &before;
+        vkCmdPipelineBarrier2(commandBuffer, &dependency);
+
+        for (const ReadbackCopy& copy : copies)
+        {
+            if (copy.width == 0)
+            {
+                VkBufferCopy region{};
+                region.srcOffset = copy.sourceOffset;
+                region.dstOffset = copy.destinationOffset;
+                region.size = copy.size;
+                vkCmdCopyBuffer(commandBuffer,
+                                static_cast<VkBuffer>(copy.source),
+                                destinationBuffer,
+                                1,
+                                &region);
+                continue;
+            }
+
+            const bool depth = copy.format == gaFormat::D16Unorm ||
+                               copy.format == gaFormat::D32Float;
+            VkBufferImageCopy region{};
+            region.bufferOffset = copy.destinationOffset;
+            region.bufferRowLength = copy.rowPitch / copy.texelSize;
+            region.bufferImageHeight = copy.height;
+            region.imageSubresource.aspectMask =
+                depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.layerCount = 1;
+            region.imageExtent = {copy.width, copy.height, 1};
+            vkCmdCopyImageToBuffer(commandBuffer,
+                                   static_cast<VkImage>(copy.source),
+                                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                   destinationBuffer,
+                                   1,
+                                   &region);
+        }
+
+        // The host reads the copies once the ring's fence says they're done
+        VkMemoryBarrier2 after{};
+        after.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        after.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        after.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        after.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+        after.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+        dependency.pMemoryBarriers = &after;
+        vkCmdPipelineBarrier2(commandBuffer, &dependency);
+    }
+
+    // What a resource in a gaResourceState is used by, and how
+    struct VulkanResourceState
+    {
+        VkPipelineStageFlags2 stages;
+        VkAccessFlags2 access;
+        VkImageLayout layout;
+    };
+
+    constexpr VkPipelineStageFlags2 kShaderStages = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT |
+                                                    VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT |
+                                                    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    constexpr VkPipelineStageFlags2 kDepthStages = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT |
+                                                   VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+
+    // Indexed by gaResourceState
+    constexpr VulkanResourceState kResourceStates[] = {
+        {VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+         VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+         VK_IMAGE_LAYOUT_GENERAL},
+        {kShaderStages, VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        {kShaderStages,
+         VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+         VK_IMAGE_LAYOUT_GENERAL},
+        {VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+         VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+         VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+        {kDepthStages,
+         VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+             VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+         VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL},
+        {kDepthStages | kShaderStages,
+         VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT,
+         VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL},
+        {VK_PIPELINE_STAGE_2_COPY_BIT,
+         VK_ACCESS_2_TRANSFER_READ_BIT,
+         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL},
+        {VK_PIPELINE_STAGE_2_COPY_BIT,
+         VK_ACCESS_2_TRANSFER_WRITE_BIT,
+         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL},
+        {VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+         VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+         VK_IMAGE_LAYOUT_GENERAL},
+        {VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR},
+        {VK_PIPELINE_STAGE_2_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR,
+         VK_ACCESS_2_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR,
+         VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR},
+    };
+    static_assert(sizeof(kResourceStates) / sizeof(kResourceStates[0]) ==
+                  static_cast<uint32>(gaResourceState::Count));
+
+    void RecordVulkanBufferCopy(gaCommandList* list,
+                                void* destination,
+                                uint64 destinationOffset,
+                                void* source,
+                                uint64 sourceOffset,
+                                uint64 size)
+    {
+        VkBufferCopy region{};
+        region.srcOffset = sourceOffset;
+        region.dstOffset = destinationOffset;
+        region.size = size;
+        vkCmdCopyBuffer(static_cast<VulkanCommandList*>(list)->commandBuffer,
+                        static_cast<VkBuffer>(source),
+                        static_cast<VkBuffer>(destination),
+                        1,
+                        &region);
+    }
+
+    static_assert(sizeof(gaDrawIndexedArguments) == sizeof(VkDrawIndexedIndirectCommand));
+
+    void RecordVulkanIndirectDraws(gaCommandList* list,
+                                   void* arguments,
+                                   uint64 argumentOffset,
+                                   uint32 maxDraws,
+                                   void* count,
+                                   uint64 countOffset)
+    {
+        VkCommandBuffer commandBuffer = static_cast<VulkanCommandList*>(list)->commandBuffer;
+        if (count == nullptr)
+        {
+            vkCmdDrawIndexedIndirect(commandBuffer,
+                                     static_cast<VkBuffer>(arguments),
+                                     argumentOffset,
+                                     maxDraws,
+                                     sizeof(gaDrawIndexedArguments));
+            return;
+        }
+        vkCmdDrawIndexedIndirectCount(commandBuffer,
+                                      static_cast<VkBuffer>(arguments),
+                                      argumentOffset,
+                                      static_cast<VkBuffer>(count),
+                                      countOffset,
+                                      maxDraws,
+                                      sizeof(gaDrawIndexedArguments));
+    }
+
+    void RecordVulkanMeshDispatch(gaCommandList* list,
+                                  uint32 groupsX,
+                                  uint32 groupsY,
+                                  uint32 groupsZ)
+    {
+        static_cast<VulkanDevice*>(list->device)
+            ->drawMeshTasks(static_cast<VulkanCommandList*>(list)->commandBuffer,
+                            groupsX,
+                            groupsY,
+                            groupsZ);
+    }
+
+    // With the stages the layout's push constant range has, see CreateVulkanPipelineLayout
+    void RecordVulkanPushConstants(gaCommandList* list,
+                                   const gaPipeline* pipeline,
+                                   uint32 offset,
+                                   uint32 size,
+                                   const void* data)
+    {
+        VkShaderStageFlags stages = VK_SHADER_STAGE_COMPUTE_BIT;
+        if (!pipeline->compute)
+        {
+            stages = VK_SHADER_STAGE_ALL_GRAPHICS;
+            if (list->device->meshShaders)
+            {
+                stages |= VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+            }
+        }
+        vkCmdPushConstants(static_cast<VulkanCommandList*>(list)->commandBuffer,
+                           static_cast<VkPipelineLayout>(pipeline->layout),
+                           stages,
+                           offset,
+                           size,
+                           data);
+    }
+
+    // The attachment's rate wins where it's coarser, when there is one
+    void RecordVulkanShadingRate(gaCommandList* list, gaShadingRate rate, void* rateImage)
+    {
+        const uint32 bits = static_cast<uint32>(rate);
+        const VkExtent2D fragmentSize = {1u << (bits >> 2), 1u << (bits & 3)};
+        const VkFragmentShadingRateCombinerOpKHR combinerOps[2] = {
+            VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR,
+            rateImage != nullptr ? VK_FRAGMENT_SHADING_RATE_COMBINER_OP_MAX_KHR
+                                 : VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR,
+        };
+        static_cast<VulkanDevice*>(list->device)
+            ->setFragmentShadingRate(
+                static_cast<VulkanCommandList*>(list)->commandBuffer, &fragmentSize, combinerOps);
+    }
+
+    // Shader reads and writes before or after a draw reach the mesh pipelines' stages too, on
+    // devices that have them
+    static VkPipelineStageFlags2 WithMeshStages(VkPipelineStageFlags2 stages, bool meshShaders)
+    {
+        if (!meshShaders || (stages & VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT) == 0)
+        {
+            return stages;
+        }
+        return stages | VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT |
+               VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT;
+    }
+
+    void RecordVulkanBarriers(gaCommandList* list, ArrayView<const gaBarrier> barriers)
+    {
+        VkCommandBuffer commandBuffer = static_cast<VulkanCommandList*>(list)->commandBuffer;
+        const bool meshShaders = list->device->meshShaders;
+
+        SmallArray<VkImageMemoryBarrier2, 32> imageBarriers;
+        SmallArray<VkBufferMemoryBarrier2, 32> bufferBarriers;
+        for (const gaBarrier& barrier : barriers)
+        {
+            // There's no half a barrier without events, the end does all of it
+            if (barrier.split == gaBarrierSplit::Begin)
+            {
+                continue;
+            }
+
+            const auto& before = kResourceStates[static_cast<uint32>(barrier.before)];
+            const auto& after = kResourceStates[static_cast<uint32>(barrier.after)];
+            if (barrier.texture)
+            {
+                VkImageMemoryBarrier2 out{};
+                out.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+                out.srcStageMask = WithMeshStages(before.stages, meshShaders);
+                out.srcAccessMask = before.access;
+                out.dstStageMask = WithMeshStages(after.stages, meshShaders);
+                out.dstAccessMask = after.access;
+                out.oldLayout = barrier.discard ? VK_IMAGE_LAYOUT_UNDEFINED : before.layout;
+                out.newLayout = after.layout;
+                out.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                out.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                out.image = static_cast<VkImage>(barrier.resource);
+                out.subresourceRange.aspectMask =
+                    barrier.depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+                out.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+                out.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+                imageBarriers.PushBack(out);
+            }
+            else
+            {
+                VkBufferMemoryBarrier2 out{};
+                out.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+                out.srcStageMask = WithMeshStages(before.stages, meshShaders);
+                out.srcAccessMask = before.access;
+                out.dstStageMask = WithMeshStages(after.stages, meshShaders);
+                out.dstAccessMask = after.access;
+                out.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                out.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                out.buffer = static_cast<VkBuffer>(barrier.resource);
+                out.size = VK_WHOLE_SIZE;
+                bufferBarriers.PushBack(out);
+            }
+        }
+
+        if (imageBarriers.IsEmpty() && bufferBarriers.IsEmpty())
+        {
+            return;
+        }
+
+        VkDependencyInfo dependency{};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.imageMemoryBarrierCount = static_cast<uint32>(imageBarriers.Size());
+        dependency.pImageMemoryBarriers = imageBarriers.Data();
+        dependency.bufferMemoryBarrierCount = static_cast<uint32>(bufferBarriers.Size());
+        dependency.pBufferMemoryBarriers = bufferBarriers.Data();
+        vkCmdPipelineBarrier2(commandBuffer, &dependency);
+    }
+
+    // Ticks a second from the nanoseconds a tick the device reports
+    static uint64 TimestampFrequency(const VulkanDevice& device)
+    {
+        return static_cast<uint64>(1'000'000'000.0 / device.timestampPeriod + 0.5);
+    }
+
+    struct VulkanTimestampHeap : public TimestampHeap
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkQueryPool pool = VK_NULL_HANDLE;
+        uint64 validMask = ~0ull; // The bits the queue writes, the rest are undefined
+
+        ~VulkanTimestampHeap() override
+        {
+            if (pool != VK_NULL_HANDLE)
+            {
+                vkDestroyQueryPool(device, pool, nullptr);
+            }
+        }
+    };
+
+    Result<TimestampHeap*> CreateVulkanTimestampHeap(gaDevice* baseDevice,
+                                                     gaQueueType queue,
+                                                     uint32 count)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        const uint32 validBits = device->timestampValidBits[static_cast<uint32>(queue)];
+        if (validBits == 0 || !device->hostQueryReset)
+        {
+            return {ErrorCategory::NotFound,
+                    "Timestamps need a queue family that writes them, and hostQueryReset"};
+        }
+
+        auto heap = rsbl::UniquePtr(new VulkanTimestampHeap());
+        heap->device = device->logicalDevice;
+        heap->validMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+        heap->frequency = TimestampFrequency(*device);
+
+        VkQueryPoolCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        createInfo.queryCount = count;
+        if (vkCreateQueryPool(device->logicalDevice, &createInfo, nullptr, &heap->pool) !=
+            VK_SUCCESS)
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create a timestamp query pool"};
+        }
+
+        // Queries start out undefined, and have to be reset before they're written
+        vkResetQueryPool(device->logicalDevice, heap->pool, 0, count);
+        heap->handle = heap->pool;
+        return heap.Release();
+    }
+
+    struct VulkanBreadcrumbs : public Breadcrumbs
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+
+        ~VulkanBreadcrumbs() override
+        {
+            if (buffer != VK_NULL_HANDLE)
+            {
+                vkDestroyBuffer(device, buffer, nullptr);
+            }
+            if (memory != VK_NULL_HANDLE)
+            {
+                // Freeing mapped memory unmaps it
+                vkFreeMemory(device, memory, nullptr);
+            }
+        }
+    };
+
+    Result<Breadcrumbs*> CreateVulkanBreadcrumbs(gaDevice* baseDevice, uint32 slots)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        auto breadcrumbs = rsbl::UniquePtr(new VulkanBreadcrumbs());
+        breadcrumbs->device = device->logicalDevice;
+
+        VkBufferCreateInfo bufferCreateInfo{};
+        bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferCreateInfo.size = uint64(slots) * sizeof(uint32);
+        bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateBuffer(
+                device->logicalDevice, &bufferCreateInfo, nullptr, &breadcrumbs->buffer) !=
+            VK_SUCCESS)
+        {
+            return "Failed to create the breadcrumb buffer";
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device->logicalDevice, breadcrumbs->buffer, &requirements);
+
+        // Coherent, so the GPU's writes are there to read without an invalidate, which a lost
+        // device couldn't do
+        uint32 memoryTypeIndex = 0;
+        if (!FindMemoryType(device->memoryProperties,
+                            requirements.memoryTypeBits,
+                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+                            memoryTypeIndex))
+        {
+            return "No Vulkan memory type for the breadcrumbs";
+        }
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = memoryTypeIndex;
+        if (vkAllocateMemory(
+                device->logicalDevice, &allocateInfo, nullptr, &breadcrumbs->memory) !=
+            VK_SUCCESS)
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to allocate the breadcrumbs' memory"};
+        }
+
+        void* data = nullptr;
+        if (vkBindBufferMemory(
+                device->logicalDevice, breadcrumbs->buffer, breadcrumbs->memory, 0) !=
+                VK_SUCCESS ||
+            vkMapMemory(device->logicalDevice, breadcrumbs->memory, 0, VK_WHOLE_SIZE, 0, &data) !=
+                VK_SUCCESS)
+        {
+            return "Failed to map the breadcrumb buffer";
+        }
+        memset(data, 0, bufferCreateInfo.size);
+        breadcrumbs->markers = static_cast<uint32*>(data);
+        breadcrumbs->internalHandle = breadcrumbs->buffer;
+        return breadcrumbs.Release();
+    }
+
+    void WriteVulkanBreadcrumb(gaCommandList* list,
+                               Breadcrumbs* breadcrumbs,
+                               uint32 slot,
+                               uint32 marker)
+    {
+        auto device = static_cast<VulkanDevice*>(list->device);
+        VkCommandBuffer commandBuffer = static_cast<VulkanCommandList*>(list)->commandBuffer;
+        VkBuffer buffer = static_cast<VulkanBreadcrumbs*>(breadcrumbs)->buffer;
+        const VkDeviceSize offset = uint64(slot) * sizeof(uint32);
+        if (device->writeBufferMarker != nullptr)
+        {
+            device->writeBufferMarker(
+                commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, buffer, offset, marker);
+            return;
+        }
+        vkCmdFillBuffer(commandBuffer, buffer, offset, sizeof(uint32), marker);
+    }
+
+    void WriteVulkanTimestamp(gaCommandList* list, TimestampHeap* heap, uint32 index)
+    {
+        // Once everything before is done, like a DX12 timestamp
+        vkCmdWriteTimestamp2(static_cast<VulkanCommandList*>(list)->commandBuffer,
+                             VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                             static_cast<VulkanTimestampHeap*>(heap)->pool,
+                             index);
+    }
+
+    Result<> ReadVulkanTimestamps(TimestampHeap* baseHeap, uint32 first, uint32 count, uint64* out)
+    {
+        // Without VK_QUERY_RESULT_WAIT_BIT, it never blocks. The frame is done, so they're there.
+        auto heap = static_cast<VulkanTimestampHeap*>(baseHeap);
+        const VkResult result = vkGetQueryPoolResults(heap->device,
+                                                      heap->pool,
+                                                      first,
+                                                      count,
+                                                      uint64(count) * sizeof(uint64),
+                                                      out,
+                                                      sizeof(uint64),
+                                                      VK_QUERY_RESULT_64_BIT);
+        if (result != VK_SUCCESS)
+        {
+            return "Failed to read the frame's timestamps back";
+        }
+        for (uint32 i = 0; i < count; ++i)
+        {
+            out[i] &= heap->validMask;
+        }
+        return ResultCode::Success;
+    }
+
+    void ResetVulkanTimestamps(TimestampHeap* baseHeap, uint32 first, uint32 count)
+    {
+        auto heap = static_cast<VulkanTimestampHeap*>(baseHeap);
+        vkResetQueryPool(heap->device, heap->pool, first, count);
+    }
+
+    Result<gaClockCalibration> GetVulkanClockCalibration(gaDevice* baseDevice, gaQueueType queue)
+    {
+        // The device's timestamps are the same clock on every queue
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        if (device->getCalibratedTimestamps == nullptr)
+        {
+            return {ErrorCategory::NotFound, "VK_EXT_calibrated_timestamps isn't available"};
+        }
+
+        VkCalibratedTimestampInfoEXT infos[2] = {};
+        infos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+        infos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+        infos[1].timeDomain = device->cpuTimeDomain;
+        uint64 timestamps[2] = {};
+        uint64 maxDeviation = 0;
+        if (device->getCalibratedTimestamps(
+                device->logicalDevice, 2, infos, timestamps, &maxDeviation) != VK_SUCCESS)
+        {
+            return {ErrorCategory::Graphics, "Failed to calibrate the device's clock"};
+        }
+
+#if defined(WIN32)
+        LARGE_INTEGER cpuFrequency = {};
+        QueryPerformanceFrequency(&cpuFrequency);
+        const uint64 cpuTicksPerSecond = static_cast<uint64>(cpuFrequency.QuadPart);
+#else
+        const uint64 cpuTicksPerSecond = 1'000'000'000; // CLOCK_MONOTONIC counts nanoseconds
+#endif
+        const uint32 validBits = device->timestampValidBits[static_cast<uint32>(queue)];
+        const uint64 validMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+        return gaClockCalibration{
+            timestamps[0] & validMask,
+            TimestampFrequency(*device),
+            timestamps[1],
+            cpuTicksPerSecond};
+    }
+
+    // The bindless heap's set layout, one array per kind of descriptor sharing the indices, then
+    // the immutable samplers
+    constexpr uint32 kBindlessStorageBuffers = 0;
+    constexpr uint32 kBindlessSampledImages = 1;
+    constexpr uint32 kBindlessStorageImages = 2;
+    constexpr VkDescriptorType kBindlessDescriptorTypes[] = {
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+    };
+    constexpr uint32 kBindlessBindings = 3;
+    constexpr uint32 kBindlessSamplers = kBindlessBindings;
+
+    constexpr VkCompareOp kCompareOps[] = {
+        VK_COMPARE_OP_NEVER,
+        VK_COMPARE_OP_LESS,
+        VK_COMPARE_OP_EQUAL,
+        VK_COMPARE_OP_LESS_OR_EQUAL,
+        VK_COMPARE_OP_GREATER,
+        VK_COMPARE_OP_NOT_EQUAL,
+        VK_COMPARE_OP_GREATER_OR_EQUAL,
+        VK_COMPARE_OP_ALWAYS,
+    };
+
+    struct VulkanBindlessTable : public BindlessTable
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        VkDescriptorSet set = VK_NULL_HANDLE; // Freed with the pool
+        VkSampler samplers[kGaMaxBindlessSamplers] = {};
+        uint32 samplerCount = 0;
+
+        ~VulkanBindlessTable() override
+        {
+            for (uint32 index = 0; index < samplerCount; ++index)
+            {
+                vkDestroySampler(device, samplers[index], nullptr);
+            }
+            if (pool != VK_NULL_HANDLE)
+            {
+                vkDestroyDescriptorPool(device, pool, nullptr);
+            }
+            if (layout != VK_NULL_HANDLE)
+            {
+                vkDestroyDescriptorSetLayout(device, layout, nullptr);
+            }
+        }
+    };
+
+    static VkSamplerCreateInfo SamplerCreateInfo(const VulkanDevice* device,
+                                                 const gaSamplerDesc& sampler)
+    {
+        constexpr VkSamplerAddressMode kAddressModes[] = {
+            VK_SAMPLER_ADDRESS_MODE_REPEAT,
+            VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT,
+            VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        };
+
+        const bool point = sampler.filter == gaFilter::Point;
+        VkSamplerCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        createInfo.magFilter = point ? VK_FILTER_NEAREST : VK_FILTER_LINEAR;
+        createInfo.minFilter = createInfo.magFilter;
+        createInfo.mipmapMode =
+            point ? VK_SAMPLER_MIPMAP_MODE_NEAREST : VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        createInfo.addressModeU = kAddressModes[static_cast<uint32>(sampler.addressU)];
+        createInfo.addressModeV = kAddressModes[static_cast<uint32>(sampler.addressV)];
+        createInfo.addressModeW = kAddressModes[static_cast<uint32>(sampler.addressW)];
+        createInfo.mipLodBias = sampler.mipBias;
+        createInfo.anisotropyEnable =
+            sampler.filter == gaFilter::Anisotropic && device->features.samplerAnisotropy;
+        createInfo.maxAnisotropy = static_cast<float>(sampler.maxAnisotropy);
+        createInfo.compareEnable = sampler.compare;
+        createInfo.compareOp = kCompareOps[static_cast<uint32>(sampler.compareOp)];
+        createInfo.minLod = 0.0f;
+        createInfo.maxLod = VK_LOD_CLAMP_NONE;
+        createInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+        return createInfo;
+    }
+
+    Result<BindlessTable*> CreateVulkanBindlessTable(gaDevice* baseDevice,
+                                                     uint32 capacity,
+                                                     ArrayView<const gaSamplerDesc> samplers)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+
+        // Update-after-bind sets have limits of their own, far above the usual ones
+        VkPhysicalDeviceVulkan12Properties properties12{};
+        properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &properties12;
+        vkGetPhysicalDeviceProperties2(device->physicalDevice, &properties);
+        if (capacity > properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers ||
+            capacity > properties12.maxPerStageDescriptorUpdateAfterBindSampledImages ||
+            capacity > properties12.maxPerStageDescriptorUpdateAfterBindStorageImages ||
+            capacity > properties12.maxPerStageUpdateAfterBindResources / kBindlessBindings)
+        {
+            return {ErrorCategory::InvalidArgument,
+                    "Bindless heap capacity is above the device's descriptor limits"};
+        }
+
+        auto table = rsbl::UniquePtr(new VulkanBindlessTable());
+        table->device = device->logicalDevice;
+        for (const gaSamplerDesc& sampler : samplers)
+        {
+            const VkSamplerCreateInfo samplerCreateInfo = SamplerCreateInfo(device, sampler);
+            if (vkCreateSampler(device->logicalDevice,
+                                &samplerCreateInfo,
+                                nullptr,
+                                &table->samplers[table->samplerCount]) != VK_SUCCESS)
+            {
+                return "Failed to create a bindless heap sampler";
+            }
+            ++table->samplerCount;
+        }
+
+        VkDescriptorSetLayoutBinding bindings[kBindlessBindings + 1] = {};
+        VkDescriptorBindingFlags bindingFlags[kBindlessBindings + 1] = {};
+        VkDescriptorPoolSize poolSizes[kBindlessBindings + 1] = {};
+        for (uint32 binding = 0; binding < kBindlessBindings; ++binding)
+        {
+            bindings[binding].binding = binding;
+            bindings[binding].descriptorType = kBindlessDescriptorTypes[binding];
+            bindings[binding].descriptorCount = capacity;
+            bindings[binding].stageFlags = VK_SHADER_STAGE_ALL;
+            bindingFlags[binding] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                    VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                    VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+            poolSizes[binding].type = kBindlessDescriptorTypes[binding];
+            poolSizes[binding].descriptorCount = capacity;
+        }
+
+        // Immutable, so never written and not update-after-bind
+        uint32 bindingCount = kBindlessBindings;
+        if (table->samplerCount > 0)
+        {
+            bindings[kBindlessSamplers].binding = kBindlessSamplers;
+            bindings[kBindlessSamplers].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+            bindings[kBindlessSamplers].descriptorCount = table->samplerCount;
+            bindings[kBindlessSamplers].stageFlags = VK_SHADER_STAGE_ALL;
+            bindings[kBindlessSamplers].pImmutableSamplers = table->samplers;
+            poolSizes[kBindlessSamplers].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+            poolSizes[kBindlessSamplers].descriptorCount = table->samplerCount;
+            ++bindingCount;
+        }
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        bindingFlagsInfo.bindingCount = bindingCount;
+        bindingFlagsInfo.pBindingFlags = bindingFlags;
+
+        VkDescriptorSetLayoutCreateInfo layoutCreateInfo{};
+        layoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutCreateInfo.pNext = &bindingFlagsInfo;
+        layoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layoutCreateInfo.bindingCount = bindingCount;
+        layoutCreateInfo.pBindings = bindings;
+
+        if (vkCreateDescriptorSetLayout(
+                device->logicalDevice, &layoutCreateInfo, nullptr, &table->layout) != VK_SUCCESS)
+        {
+            return "Failed to create the bindless descriptor set layout";
+        }
+
+        VkDescriptorPoolCreateInfo poolCreateInfo{};
+        poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        poolCreateInfo.maxSets = 1;
+        poolCreateInfo.poolSizeCount = bindingCount;
+        poolCreateInfo.pPoolSizes = poolSizes;
+        if (vkCreateDescriptorPool(
+                device->logicalDevice, &poolCreateInfo, nullptr, &table->pool) != VK_SUCCESS)
+        {
+            return {ErrorCategory::OutOfMemory, "Failed to create the bindless descriptor pool"};
+        }
+
+        VkDescriptorSetAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorPool = table->pool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &table->layout;
+        if (vkAllocateDescriptorSets(device->logicalDevice, &allocateInfo, &table->set) !=
+            VK_SUCCESS)
+        {
+            return "Failed to allocate the bindless descriptor set";
+        }
+
+        table->handle = table->set;
+        table->setLayout = table->layout;
+        return table.Release();
+    }
+
+    void WriteVulkanBindlessDescriptor(gaDevice* baseDevice,
+                                       BindlessTable* table,
+                                       uint32 index,
+                                       const gaBindlessView& view)
+    {
+        VkDescriptorBufferInfo bufferInfo{};
+        VkDescriptorImageInfo imageInfo{};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = static_cast<VulkanBindlessTable*>(table)->set;
+        write.dstArrayElement = index;
+        write.descriptorCount = 1;
+
+        // Structured and raw views are both plain storage buffers, the shader decides the layout
+        switch (view.type)
+        {
+        case gaBindlessViewType::BufferSrv:
+        case gaBindlessViewType::BufferUav:
+            bufferInfo.buffer = static_cast<VkBuffer>(view.resource);
+            bufferInfo.offset = view.offset;
+            bufferInfo.range = view.size;
+            write.dstBinding = kBindlessStorageBuffers;
+            write.pBufferInfo = &bufferInfo;
+            break;
+
+        case gaBindlessViewType::TextureSrv:
+            imageInfo.imageView = static_cast<VkImageView>(view.resource);
+            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            write.dstBinding = kBindlessSampledImages;
+            write.pImageInfo = &imageInfo;
+            break;
+
+        case gaBindlessViewType::TextureUav:
+            imageInfo.imageView = static_cast<VkImageView>(view.resource);
+            imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            write.dstBinding = kBindlessStorageImages;
+            write.pImageInfo = &imageInfo;
+            break;
+        }
+        write.descriptorType = kBindlessDescriptorTypes[write.dstBinding];
+
+        vkUpdateDescriptorSets(
+            static_cast<VulkanDevice*>(baseDevice)->logicalDevice, 1, &write, 0, nullptr);
+    }
+
+    void BindVulkanBindlessTable(gaCommandList* list, BindlessTable* table, void* pipelineLayout)
+    {
+        VkCommandBuffer commandBuffer = static_cast<VulkanCommandList*>(list)->commandBuffer;
+        auto layout = static_cast<VkPipelineLayout>(pipelineLayout);
+        VkDescriptorSet set = static_cast<VulkanBindlessTable*>(table)->set;
+        if (list->queue == gaQueueType::Graphics)
+        {
+            vkCmdBindDescriptorSets(
+                commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &set, 0, nullptr);
+        }
+        vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &set, 0, nullptr);
+    }
+
+    constexpr VkFormat kVulkanFormats[] = {
+        VK_FORMAT_UNDEFINED,
+        VK_FORMAT_R8G8B8A8_UNORM,
+        VK_FORMAT_R8G8B8A8_SRGB,
+        VK_FORMAT_B8G8R8A8_UNORM,
+        VK_FORMAT_B8G8R8A8_SRGB,
+        VK_FORMAT_R8G8B8A8_UINT,
+        VK_FORMAT_A2B10G10R10_UNORM_PACK32,
+        VK_FORMAT_B10G11R11_UFLOAT_PACK32,
+        VK_FORMAT_R16G16_SFLOAT,
+        VK_FORMAT_R16G16B16A16_SFLOAT,
+        VK_FORMAT_R16G16B16A16_UNORM,
+        VK_FORMAT_R32_SFLOAT,
+        VK_FORMAT_R32_UINT,
+        VK_FORMAT_R32G32_SFLOAT,
+        VK_FORMAT_R32G32B32_SFLOAT,
+        VK_FORMAT_R32G32B32A32_SFLOAT,
+        VK_FORMAT_D16_UNORM,
+        VK_FORMAT_D24_UNORM_S8_UINT,
+        VK_FORMAT_D32_SFLOAT,
+    };
+    static_assert(sizeof(kVulkanFormats) / sizeof(kVulkanFormats[0]) ==
+                  static_cast<uint32>(gaFormat::Count));
+
+    constexpr VkCullModeFlags kCullModes[] = {
+        VK_CULL_MODE_NONE,
+        VK_CULL_MODE_FRONT_BIT,
+        VK_CULL_MODE_BACK_BIT,
+    };
+
+    constexpr VkPrimitiveTopology kTopologies[] = {
+        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+        VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,
+        VK_PRIMITIVE_TOPOLOGY_LINE_LIST,
+        VK_PRIMITIVE_TOPOLOGY_POINT_LIST,
+    };
+
+    struct VulkanReservedResource : public gaReservedResource
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkImage image = VK_NULL_HANDLE;
+        VkDeviceSize mipTailOffset = 0; // Where the mip tail starts, in the image's opaque range
+
+        VulkanReservedResource()
+        {
+            backend = gaBackend::Vulkan;
+            internalHandle = nullptr;
+        }
+
+        ~VulkanReservedResource() override
+        {
+            if (buffer != VK_NULL_HANDLE)
+            {
+                vkDestroyBuffer(device, buffer, nullptr);
+            }
+            if (image != VK_NULL_HANDLE)
+            {
+                vkDestroyImage(device, image, nullptr);
+            }
+        }
+    };
+
+    // Tiles are kGaTileSize bytes of memory, so the resource's own alignment has to fit in one
+    static Result<gaReservedResource*> CreateSparseBuffer(VulkanDevice* device, uint64 size)
+    {
+        VkBufferCreateInfo bufferCreateInfo{};
+        bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferCreateInfo.flags =
+            VK_BUFFER_CREATE_SPARSE_BINDING_BIT | VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT;
+        bufferCreateInfo.size = (size + kGaTileSize - 1) / kGaTileSize * kGaTileSize;
+        bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                 VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        auto resource = rsbl::UniquePtr(new VulkanReservedResource());
+        resource->device = device->logicalDevice;
+        if (vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &resource->buffer) !=
+            VK_SUCCESS)
+        {
+            return "Failed to create a sparse Vulkan buffer";
+        }
+        resource->internalHandle = resource->buffer;
+
+        VkMemoryRequirements requirements{};
+        vkGetBufferMemoryRequirements(device->logicalDevice, resource->buffer, &requirements);
+        if (kGaTileSize % requirements.alignment != 0)
+        {
+            return {ErrorCategory::NotFound, "The sparse buffer's pages are not 64 KB tiles"};
+        }
+        return resource.Release();
+    }
+
+    static Result<gaReservedResource*> CreateSparseImage(
+        VulkanDevice* device, const gaReservedResourceCreateInfo& createInfo)
+    {
+        VkImageCreateInfo imageCreateInfo{};
+        imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageCreateInfo.flags =
+            VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
+        imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageCreateInfo.format = kVulkanFormats[static_cast<uint32>(createInfo.format)];
+        imageCreateInfo.extent = {createInfo.width, createInfo.height, 1};
+        imageCreateInfo.mipLevels = createInfo.mips;
+        imageCreateInfo.arrayLayers = 1;
+        imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        auto resource = rsbl::UniquePtr(new VulkanReservedResource());
+        resource->device = device->logicalDevice;
+        if (vkCreateImage(device->logicalDevice, &imageCreateInfo, nullptr, &resource->image) !=
+            VK_SUCCESS)
+        {
+            return "Failed to create a sparse Vulkan image";
+        }
+        resource->internalHandle = resource->image;
+
+        VkMemoryRequirements requirements{};
+        vkGetImageMemoryRequirements(device->logicalDevice, resource->image, &requirements);
+        if (kGaTileSize % requirements.alignment != 0)
+        {
+            return {ErrorCategory::NotFound, "The sparse image's blocks are not 64 KB tiles"};
+        }
+
+        // Colour formats only, so there's one aspect and one set of requirements
+        uint32 requirementCount = 1;
+        VkSparseImageMemoryRequirements sparse{};
+        vkGetImageSparseMemoryRequirements(
+            device->logicalDevice, resource->image, &requirementCount, &sparse);
+        if (requirementCount == 0)
+        {
+            return "The sparse image has no sparse memory requirements";
+        }
+
+        const VkExtent3D granularity = sparse.formatProperties.imageGranularity;
+        resource->tileWidth = granularity.width;
+        resource->tileHeight = granularity.height;
+        resource->standardMips =
+            sparse.imageMipTailFirstLod < createInfo.mips ? sparse.imageMipTailFirstLod
+                                                          : createInfo.mips;
+        resource->mipTailTiles = resource->standardMips < createInfo.mips
+                                     ? static_cast<uint32>(sparse.imageMipTailSize / kGaTileSize)
+                                     : 0;
+        resource->mipTailOffset = sparse.imageMipTailOffset;
+
+        resource->tileCount = resource->mipTailTiles;
+        for (uint32 mip = 0; mip < resource->standardMips; ++mip)
+        {
+            const uint32 width = createInfo.width >> mip > 0 ? createInfo.width >> mip : 1;
+            const uint32 height = createInfo.height >> mip > 0 ? createInfo.height >> mip : 1;
+            resource->tileCount += ((width + granularity.width - 1) / granularity.width) *
+                                   ((height + granularity.height - 1) / granularity.height);
+        }
+        return resource.Release();
+    }
+
+    Result<gaReservedResource*> CreateVulkanReservedResource(
+        const gaReservedResourceCreateInfo& createInfo)
+    {
+        auto device = static_cast<VulkanDevice*>(createInfo.device);
+        if (createInfo.size != 0)
+        {
+            return CreateSparseBuffer(device, createInfo.size);
+        }
+        return CreateSparseImage(device, createInfo);
+    }
+
+    // One vkQueueBindSparse for the lot, a bind info per run of mappings to the same resource.
+    // Binds aren't ordered with the queue's submits, so they wait for the frame fence and the
+    // queue waits for them.
+    Result<> UpdateVulkanTileMappings(gaDevice* baseDevice,
+                                      ArrayView<const gaTileMapping> mappings)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+
+        DynamicArray<VkSparseMemoryBind> memoryBinds;
+        DynamicArray<VkSparseImageMemoryBind> imageBinds;
+        DynamicArray<VkSparseBufferMemoryBindInfo> bufferInfos;
+        DynamicArray<VkSparseImageOpaqueMemoryBindInfo> opaqueInfos;
+        DynamicArray<VkSparseImageMemoryBindInfo> imageInfos;
+
+        // Reserved for every mapping, so the infos can point into them as they fill
+        memoryBinds.Reserve(mappings.Size());
+        imageBinds.Reserve(mappings.Size());
+        for (uint64 first = 0; first < mappings.Size();)
+        {
+            auto resource = static_cast<VulkanReservedResource*>(mappings[first].resource);
+            uint64 end = first + 1;
+            while (end < mappings.Size() && mappings[end].resource == resource)
+            {
+                ++end;
+            }
+
+            const uint64 firstMemoryBind = memoryBinds.Size();
+            const uint64 firstImageBind = imageBinds.Size();
+            for (uint64 i = first; i < end; ++i)
+            {
+                const gaTileMapping& mapping = mappings[i];
+                const VkDeviceMemory memory =
+                    mapping.memory.heap != nullptr
+                        ? static_cast<VulkanMemoryHeap*>(mapping.memory.heap)->memory
+                        : VK_NULL_HANDLE;
+                const VkDeviceSize memoryOffset = uint64(mapping.memory.index) * kGaTileSize;
+
+                if (resource->buffer != VK_NULL_HANDLE ||
+                    mapping.tile.mip == resource->standardMips)
+                {
+                    VkSparseMemoryBind bind{};
+                    bind.resourceOffset = uint64(mapping.tile.x) * kGaTileSize;
+                    if (resource->image != VK_NULL_HANDLE)
+                    {
+                        bind.resourceOffset += resource->mipTailOffset;
+                    }
+                    bind.size = kGaTileSize;
+                    bind.memory = memory;
+                    bind.memoryOffset = memoryOffset;
+                    memoryBinds.PushBack(bind);
+                    continue;
+                }
+
+                // Edge tiles stop at the edge of the mip
+                const uint32 x = mapping.tile.x * resource->tileWidth;
+                const uint32 y = mapping.tile.y * resource->tileHeight;
+                const uint32 mip = mapping.tile.mip;
+                const uint32 width = resource->width >> mip > 0 ? resource->width >> mip : 1;
+                const uint32 height = resource->height >> mip > 0 ? resource->height >> mip : 1;
+
+                VkSparseImageMemoryBind bind{};
+                bind.subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                bind.subresource.mipLevel = mapping.tile.mip;
+                bind.offset = {static_cast<int32>(x), static_cast<int32>(y), 0};
+                const uint32 right =
+                    x + resource->tileWidth < width ? x + resource->tileWidth : width;
+                const uint32 bottom =
+                    y + resource->tileHeight < height ? y + resource->tileHeight : height;
+                bind.extent = {right - x, bottom - y, 1};
+                bind.memory = memory;
+                bind.memoryOffset = memoryOffset;
+                imageBinds.PushBack(bind);
+            }
+
+            const uint32 memoryBindCount =
+                static_cast<uint32>(memoryBinds.Size() - firstMemoryBind);
+            const uint32 imageBindCount = static_cast<uint32>(imageBinds.Size() - firstImageBind);
+            if (resource->buffer != VK_NULL_HANDLE)
+            {
+                bufferInfos.PushBack({resource->buffer,
+                                      memoryBindCount,
+                                      memoryBinds.Data() + firstMemoryBind});
+            }
+            else
+            {
+                if (memoryBindCount > 0)
+                {
+                    opaqueInfos.PushBack(
+                        {resource->image,
+                         memoryBindCount,
+                         memoryBinds.Data() + firstMemoryBind});
+                }
+                if (imageBindCount > 0)
+                {
+                    imageInfos.PushBack(
+                        {resource->image,
+                         imageBindCount,
+                         imageBinds.Data() + firstImageBind});
+                }
+            }
+            first = end;
+        }
+
+        const uint32 queueIndex = static_cast<uint32>(gaQueueType::Graphics);
+        VulkanFence& fence = *device->frameFences[queueIndex];
+        const uint64 waitValue = fence.signalledValue;
+        const uint64 signalValue = fence.signalledValue + 1;
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.waitSemaphoreValueCount = 1;
+        timelineInfo.pWaitSemaphoreValues = &waitValue;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+        VkBindSparseInfo bindInfo{};
+        bindInfo.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+        bindInfo.pNext = &timelineInfo;
+        bindInfo.waitSemaphoreCount = 1;
+        bindInfo.pWaitSemaphores = &fence.semaphore;
+        bindInfo.bufferBindCount = static_cast<uint32>(bufferInfos.Size());
+        bindInfo.pBufferBinds = bufferInfos.Data();
+        bindInfo.imageOpaqueBindCount = static_cast<uint32>(opaqueInfos.Size());
+        bindInfo.pImageOpaqueBinds = opaqueInfos.Data();
+        bindInfo.imageBindCount = static_cast<uint32>(imageInfos.Size());
+        bindInfo.pImageBinds = imageInfos.Data();
+        bindInfo.signalSemaphoreCount = 1;
+        bindInfo.pSignalSemaphores = &fence.semaphore;
+
+        if (vkQueueBindSparse(device->queues[queueIndex], 1, &bindInfo, VK_NULL_HANDLE) !=
+            VK_SUCCESS)
+        {
+            return "Failed to bind the sparse memory";
+        }
+        fence.signalledValue = signalValue;
+        device->CurrentFrame().fenceValues[queueIndex] = signalValue;
+        return QueueWaitForVulkanFence(device, gaQueueType::Graphics, &fence, signalValue);
+    }
+
+    struct VulkanPipelineLibrary : public PipelineLibrary
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkPipelineCache cache = VK_NULL_HANDLE;
+
+        ~VulkanPipelineLibrary() override
+        {
+            if (cache != VK_NULL_HANDLE)
+            {
+                vkDestroyPipelineCache(device, cache, nullptr);
+            }
+        }
+    };
+
+    struct VulkanPipelineLayout : public PipelineLayout
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+
+        ~VulkanPipelineLayout() override
+        {
+            if (layout != VK_NULL_HANDLE)
+            {
+                vkDestroyPipelineLayout(device, layout, nullptr);
+            }
+        }
+    };
+
+    struct VulkanPipeline : public gaPipeline
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+
+        ~VulkanPipeline() override
+        {
+            if (pipeline != VK_NULL_HANDLE)
+            {
+                vkDestroyPipeline(device, pipeline, nullptr);
+            }
+        }
+    };
+
+    Result<PipelineLibrary*> CreateVulkanPipelineLibrary(gaDevice* baseDevice,
+                                                         ArrayView<const uint8> data)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+
+        // The driver checks the data's header itself, and starts empty if it's from elsewhere
+        VkPipelineCacheCreateInfo cacheCreateInfo{};
+        cacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        cacheCreateInfo.initialDataSize = data.Size();
+        cacheCreateInfo.pInitialData = data.Data();
+
+        auto library = rsbl::UniquePtr(new VulkanPipelineLibrary());
+        library->device = device->logicalDevice;
+        VkResult result = vkCreatePipelineCache(
+            device->logicalDevice, &cacheCreateInfo, nullptr, &library->cache);
+        if (result != VK_SUCCESS && !data.IsEmpty())
+        {
+            RSBL_LOG_INFO("Pipeline cache data was rejected, starting an empty cache");
+            cacheCreateInfo.initialDataSize = 0;
+            cacheCreateInfo.pInitialData = nullptr;
+            result = vkCreatePipelineCache(
+                device->logicalDevice, &cacheCreateInfo, nullptr, &library->cache);
+        }
+        if (result != VK_SUCCESS)
+        {
+            return "Failed to create a pipeline cache";
+        }
+        library->handle = library->cache;
+        return library.Release();
+    }
+
+    Result<> SerializeVulkanPipelineLibrary(gaDevice* baseDevice,
+                                            PipelineLibrary* library,
+                                            DynamicArray<uint8>& data)
+    {
+        VkDevice device = static_cast<VulkanDevice*>(baseDevice)->logicalDevice;
+        VkPipelineCache cache = static_cast<VulkanPipelineLibrary*>(library)->cache;
+
+        size_t size = 0;
+        if (vkGetPipelineCacheData(device, cache, &size, nullptr) != VK_SUCCESS)
+        {
+            return "Failed to get the pipeline cache's size";
+        }
+
+        const uint64 offset = data.Size();
+        data.ResizeUninitialized(offset + size);
+        if (vkGetPipelineCacheData(device, cache, &size, data.Data() + offset) != VK_SUCCESS)
+        {
+            data.Resize(offset);
+            return "Failed to get the pipeline cache's data";
+        }
+        data.Resize(offset + size);
+        return ResultCode::Success;
+    }
+
+    Result<PipelineLayout*> CreateVulkanPipelineLayout(gaDevice* baseDevice,
+                                                       const gaBindlessHeap* bindless,
+                                                       bool compute,
+                                                       uint32 pushConstantBytes)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+
+        VkPushConstantRange pushConstants{};
+        pushConstants.stageFlags =
+            compute ? VK_SHADER_STAGE_COMPUTE_BIT : VK_SHADER_STAGE_ALL_GRAPHICS;
+        if (!compute && device->meshShaders)
+        {
+            pushConstants.stageFlags |= VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT;
+        }
+        pushConstants.offset = 0;
+        pushConstants.size = pushConstantBytes;
+
+        VkDescriptorSetLayout setLayout =
+            bindless != nullptr ? static_cast<VkDescriptorSetLayout>(bindless->setLayout)
+                                : VK_NULL_HANDLE;
+
+        VkPipelineLayoutCreateInfo layoutCreateInfo{};
+        layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutCreateInfo.setLayoutCount = bindless != nullptr ? 1 : 0;
+        layoutCreateInfo.pSetLayouts = &setLayout;
+        layoutCreateInfo.pushConstantRangeCount = pushConstantBytes > 0 ? 1 : 0;
+        layoutCreateInfo.pPushConstantRanges = &pushConstants;
+
+        auto layout = rsbl::UniquePtr(new VulkanPipelineLayout());
+        layout->device = device->logicalDevice;
+        if (vkCreatePipelineLayout(
+                device->logicalDevice, &layoutCreateInfo, nullptr, &layout->layout) != VK_SUCCESS)
+        {
+            return "Failed to create a pipeline layout";
+        }
+        layout->handle = layout->layout;
+        return layout.Release();
+    }
+
+    // With maintenance5 the stage takes the SPIR-V itself, through moduleCreateInfo chained on,
+    // otherwise it gets a module for the caller to destroy once the pipeline is made
+    static bool SetShaderStage(const VulkanDevice* device,
+                               const gaShaderBytecode& shader,
+                               VkShaderStageFlagBits shaderStage,
+                               VkShaderModuleCreateInfo& moduleCreateInfo,
+                               VkPipelineShaderStageCreateInfo& stage)
+    {
+        moduleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleCreateInfo.codeSize = shader.size;
+        moduleCreateInfo.pCode = static_cast<const uint32_t*>(shader.data);
+
+        stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stage.stage = shaderStage;
+        stage.pName = "main";
+        if (device->maintenance5)
+        {
+            stage.pNext = &moduleCreateInfo;
+            return true;
+        }
+        return vkCreateShaderModule(
+                   device->logicalDevice, &moduleCreateInfo, nullptr, &stage.module) ==
+               VK_SUCCESS;
+    }
+
+    static VkPipelineColorBlendAttachmentState BlendAttachment(gaBlendMode mode)
+    {
+        VkPipelineColorBlendAttachmentState blend{};
+        blend.blendEnable = mode != gaBlendMode::Opaque;
+        blend.srcColorBlendFactor = mode == gaBlendMode::Premultiplied
+                                        ? VK_BLEND_FACTOR_ONE
+                                        : VK_BLEND_FACTOR_SRC_ALPHA;
+        blend.dstColorBlendFactor = mode == gaBlendMode::Additive
+                                        ? VK_BLEND_FACTOR_ONE
+                                        : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blend.colorBlendOp = VK_BLEND_OP_ADD;
+        blend.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        blend.dstAlphaBlendFactor = blend.dstColorBlendFactor;
+        blend.alphaBlendOp = VK_BLEND_OP_ADD;
+        blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                               VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        return blend;
+    }
+
+    Result<gaPipeline*> CreateVulkanGraphicsPipeline(gaDevice* baseDevice,
+                                                     PipelineLibrary* library,
+                                                     PipelineLayout* layout,
+                                                     uint64 key,
+                                                     const gaGraphicsPipelineDesc& desc)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        VkDevice logicalDevice = device->logicalDevice;
+
+        // Modules are only needed while the pipeline is made. Mesh pipelines have task and mesh
+        // shaders where the others have a vertex shader.
+        VkShaderModuleCreateInfo moduleCreateInfos[4] = {};
+        VkPipelineShaderStageCreateInfo stages[4] = {};
+        uint32 stageCount = 0;
+        const gaShaderBytecode* shaders[] = {
+            &desc.vertexShader, &desc.amplificationShader, &desc.meshShader, &desc.pixelShader};
+        const VkShaderStageFlagBits shaderStages[] = {VK_SHADER_STAGE_VERTEX_BIT,
+                                                      VK_SHADER_STAGE_TASK_BIT_EXT,
+                                                      VK_SHADER_STAGE_MESH_BIT_EXT,
+                                                      VK_SHADER_STAGE_FRAGMENT_BIT};
+        bool modulesCreated = true;
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            if (shaders[i]->size == 0)
+            {
+                continue;
+            }
+            modulesCreated = SetShaderStage(device,
+                                            *shaders[i],
+                                            shaderStages[i],
+                                            moduleCreateInfos[stageCount],
+                                            stages[stageCount]) &&
+                             modulesCreated;
+            ++stageCount;
+        }
+
+        VkVertexInputBindingDescription bindings[kGaMaxVertexBuffers] = {};
+        for (uint32 i = 0; i < desc.vertexBuffers.Size(); ++i)
+        {
+            bindings[i].binding = i;
+            bindings[i].stride = desc.vertexBuffers[i].stride;
+            bindings[i].inputRate = desc.vertexBuffers[i].perInstance
+                                        ? VK_VERTEX_INPUT_RATE_INSTANCE
+                                        : VK_VERTEX_INPUT_RATE_VERTEX;
+        }
+
+        VkVertexInputAttributeDescription attributes[kGaMaxVertexAttributes] = {};
+        for (uint32 i = 0; i < desc.attributes.Size(); ++i)
+        {
+            attributes[i].location = desc.attributes[i].location;
+            attributes[i].binding = desc.attributes[i].buffer;
+            attributes[i].format = kVulkanFormats[static_cast<uint32>(desc.attributes[i].format)];
+            attributes[i].offset = desc.attributes[i].offset;
+        }
+
+        VkPipelineVertexInputStateCreateInfo vertexInput{};
+        vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInput.vertexBindingDescriptionCount = static_cast<uint32>(desc.vertexBuffers.Size());
+        vertexInput.pVertexBindingDescriptions = bindings;
+        vertexInput.vertexAttributeDescriptionCount = static_cast<uint32>(desc.attributes.Size());
+        vertexInput.pVertexAttributeDescriptions = attributes;
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = kTopologies[static_cast<uint32>(desc.topology)];
+
+        // Viewport and scissor are set while recording
+        VkPipelineViewportStateCreateInfo viewport{};
+        viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewport.viewportCount = 1;
+        viewport.scissorCount = 1;
+
+        // And the shading rate, on devices with variable rate shading
+        const VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT,
+                                                VK_DYNAMIC_STATE_SCISSOR,
+                                                VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR};
+        VkPipelineDynamicStateCreateInfo dynamic{};
+        dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamic.dynamicStateCount = device->variableRateShading ? 3 : 2;
+        dynamic.pDynamicStates = dynamicStates;
+
+        VkPipelineRasterizationStateCreateInfo raster{};
+        raster.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        raster.depthClampEnable = !desc.raster.depthClip && device->features.depthClamp;
+        raster.polygonMode = desc.raster.wireframe && device->features.fillModeNonSolid
+                                 ? VK_POLYGON_MODE_LINE
+                                 : VK_POLYGON_MODE_FILL;
+        raster.cullMode = kCullModes[static_cast<uint32>(desc.raster.cull)];
+        raster.frontFace = desc.raster.frontCounterClockwise ? VK_FRONT_FACE_COUNTER_CLOCKWISE
+                                                             : VK_FRONT_FACE_CLOCKWISE;
+        raster.depthBiasEnable =
+            desc.raster.depthBias != 0 || desc.raster.slopeScaledDepthBias != 0.0f;
+        raster.depthBiasConstantFactor = static_cast<float>(desc.raster.depthBias);
+        raster.depthBiasSlopeFactor = desc.raster.slopeScaledDepthBias;
+        raster.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisample{};
+        multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineDepthStencilStateCreateInfo depth{};
+        depth.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depth.depthTestEnable = desc.depth.test;
+        depth.depthWriteEnable = desc.depth.write;
+        depth.depthCompareOp = kCompareOps[static_cast<uint32>(desc.depth.compare)];
+
+        VkPipelineColorBlendAttachmentState blends[kGaMaxRenderTargets] = {};
+        VkFormat colorFormats[kGaMaxRenderTargets] = {};
+        for (uint32 i = 0; i < desc.renderTargetFormats.Size(); ++i)
+        {
+            const gaBlendMode mode =
+                desc.blendModes.IsEmpty() ? gaBlendMode::Opaque : desc.blendModes[i];
+            blends[i] = BlendAttachment(mode);
+            colorFormats[i] = kVulkanFormats[static_cast<uint32>(desc.renderTargetFormats[i])];
+        }
+
+        VkPipelineColorBlendStateCreateInfo blend{};
+        blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        blend.attachmentCount = static_cast<uint32>(desc.renderTargetFormats.Size());
+        blend.pAttachments = blends;
+
+        // Dynamic rendering, the formats stand in for a render pass
+        VkPipelineRenderingCreateInfo rendering{};
+        rendering.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        rendering.colorAttachmentCount = static_cast<uint32>(desc.renderTargetFormats.Size());
+        rendering.pColorAttachmentFormats = colorFormats;
+        rendering.depthAttachmentFormat = kVulkanFormats[static_cast<uint32>(desc.depthFormat)];
+        rendering.stencilAttachmentFormat = desc.depthFormat == gaFormat::D24UnormS8Uint
+                                                ? VK_FORMAT_D24_UNORM_S8_UINT
+                                                : VK_FORMAT_UNDEFINED;
+
+        VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.pNext = &rendering;
+        if (device->variableRateShading)
+        {
+            // Any render pass may have a rate image attached, see GaCmdSetShadingRate
+            pipelineCreateInfo.flags =
+                VK_PIPELINE_CREATE_RENDERING_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR;
+        }
+        pipelineCreateInfo.stageCount = stageCount;
+        pipelineCreateInfo.pStages = stages;
+        const bool mesh = desc.meshShader.size > 0;
+        pipelineCreateInfo.pVertexInputState = mesh ? nullptr : &vertexInput;
+        pipelineCreateInfo.pInputAssemblyState = mesh ? nullptr : &inputAssembly;
+        pipelineCreateInfo.pViewportState = &viewport;
+        pipelineCreateInfo.pRasterizationState = &raster;
+        pipelineCreateInfo.pMultisampleState = &multisample;
+        pipelineCreateInfo.pDepthStencilState = &depth;
+        pipelineCreateInfo.pColorBlendState = &blend;
+        pipelineCreateInfo.pDynamicState = &dynamic;
+        pipelineCreateInfo.layout = static_cast<VulkanPipelineLayout*>(layout)->layout;
+
+        auto pipeline = rsbl::UniquePtr(new VulkanPipeline());
+        pipeline->device = logicalDevice;
+        VkResult result = VK_ERROR_INITIALIZATION_FAILED;
+        if (modulesCreated)
+        {
+            result = vkCreateGraphicsPipelines(logicalDevice,
+                                               static_cast<VulkanPipelineLibrary*>(library)->cache,
+                                               1,
+                                               &pipelineCreateInfo,
+                                               nullptr,
+                                               &pipeline->pipeline);
+        }
+        for (uint32 i = 0; i < stageCount; ++i)
+        {
+            if (stages[i].module != VK_NULL_HANDLE)
+            {
+                vkDestroyShaderModule(logicalDevice, stages[i].module, nullptr);
+            }
+        }
+        if (result != VK_SUCCESS)
+        {
+            return "Failed to create a graphics pipeline";
+        }
+        pipeline->internalHandle = pipeline->pipeline;
+        return pipeline.Release();
+    }
+
+    Result<gaPipeline*> CreateVulkanComputePipeline(gaDevice* baseDevice,
+                                                    PipelineLibrary* library,
+                                                    PipelineLayout* layout,
+                                                    uint64 key,
+                                                    const gaComputePipelineDesc& desc)
+    {
+        auto device = static_cast<VulkanDevice*>(baseDevice);
+        VkDevice logicalDevice = device->logicalDevice;
+
+        VkComputePipelineCreateInfo pipelineCreateInfo{};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        VkShaderModuleCreateInfo moduleCreateInfo{};
+        if (!SetShaderStage(device,
+                            desc.shader,
+                            VK_SHADER_STAGE_COMPUTE_BIT,
+                            moduleCreateInfo,
+                            pipelineCreateInfo.stage))
+        {
+            return "Failed to create a compute shader module";
+        }
+        VkShaderModule module = pipelineCreateInfo.stage.module;
+        pipelineCreateInfo.layout = static_cast<VulkanPipelineLayout*>(layout)->layout;
+
+        auto pipeline = rsbl::UniquePtr(new VulkanPipeline());
+        pipeline->device = logicalDevice;
+        const VkResult result =
+            vkCreateComputePipelines(logicalDevice,
+                                     static_cast<VulkanPipelineLibrary*>(library)->cache,
+                                     1,
+                                     &pipelineCreateInfo,
+                                     nullptr,
+                                     &pipeline->pipeline);
+        if (module != VK_NULL_HANDLE)
+        {
+            vkDestroyShaderModule(logicalDevice, module, nullptr);
+        }
+        if (result != VK_SUCCESS)
+        {
+            return "Failed to create a compute pipeline";
+        }
+        pipeline->internalHandle = pipeline->pipeline;
+        return pipeline.Release();
+    }
+
+    // A secondary command buffer from a pool of its own, reset each time it's begun. The formats
+    // are what it inherits from the render pass it's replayed in.
+    struct VulkanCommandBundle : public CommandBundle
+    {
+        VkDevice device = VK_NULL_HANDLE;
+        VkCommandPool pool = VK_NULL_HANDLE;
+        VulkanCommandList bundleList;
+        VkFormat colorFormats[kGaMaxRenderTargets] = {};
+        uint32 colorFormatCount = 0;
+        VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+        VkFormat stencilFormat = VK_FORMAT_UNDEFINED;
+
+        VulkanCommandBundle()
+        {
+            backend = gaBackend::Vulkan;
+            internalHandle = nullptr;
+            list = &bundleList;
+        }
+
+        ~VulkanCommandBundle() override
+        {
+            // Frees the buffer along with it
+            if (pool != VK_NULL_HANDLE)
+            {
+                vkDestroyCommandPool(device, pool, nullptr);
+            }
+        }
+    };
+
+    Result<CommandBundle*> CreateVulkanCommandBundle(const gaCommandBundleCreateInfo& createInfo)
+    {
+        auto device = static_cast<VulkanDevice*>(createInfo.device);
+        auto bundle = rsbl::UniquePtr(new VulkanCommandBundle());
+        bundle->device = device->logicalDevice;
+
+        VkCommandPoolCreateInfo poolCreateInfo{};
+        poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolCreateInfo.queueFamilyIndex =
+            device->queueFamilyIndices[static_cast<uint32>(gaQueueType::Graphics)];
+        if (vkCreateCommandPool(device->logicalDevice, &poolCreateInfo, nullptr, &bundle->pool) !=
+            VK_SUCCESS)
+        {
+            return "Failed to create a command pool";
+        }
+
+        VkCommandBufferAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocateInfo.commandPool = bundle->pool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocateInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(
+                device->logicalDevice, &allocateInfo, &bundle->bundleList.commandBuffer) !=
+            VK_SUCCESS)
+        {
+            return "Failed to allocate a command buffer";
+        }
+        bundle->bundleList.internalHandle = bundle->bundleList.commandBuffer;
+        bundle->internalHandle = bundle->bundleList.commandBuffer;
+
+        bundle->colorFormatCount = static_cast<uint32>(createInfo.renderTargetFormats.Size());
+        for (uint32 i = 0; i < bundle->colorFormatCount; ++i)
+        {
+            bundle->colorFormats[i] =
+                kVulkanFormats[static_cast<uint32>(createInfo.renderTargetFormats[i])];
+        }
+        bundle->depthFormat = kVulkanFormats[static_cast<uint32>(createInfo.depthFormat)];
+        bundle->stencilFormat = createInfo.depthFormat == gaFormat::D24UnormS8Uint
+                                    ? VK_FORMAT_D24_UNORM_S8_UINT
+                                    : VK_FORMAT_UNDEFINED;
+        return bundle.Release();
+    }
+
+    Result<> BeginVulkanCommandBundle(CommandBundle* baseBundle)
+    {
+        auto bundle = static_cast<VulkanCommandBundle*>(baseBundle);
+        if (vkResetCommandPool(bundle->device, bundle->pool, 0) != VK_SUCCESS)
+        {
+            return "Failed to reset the bundle's command pool";
+        }
+
+        VkCommandBufferInheritanceRenderingInfo rendering{};
+        rendering.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+        rendering.colorAttachmentCount = bundle->colorFormatCount;
+        rendering.pColorAttachmentFormats = bundle->colorFormats;
+        rendering.depthAttachmentFormat = bundle->depthFormat;
+        rendering.stencilAttachmentFormat = bundle->stencilFormat;
+        rendering.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkCommandBufferInheritanceInfo inheritance{};
+        inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance.pNext = &rendering;
+
+        // Replayed by every frame in flight at once
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                          VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+        beginInfo.pInheritanceInfo = &inheritance;
+        if (vkBeginCommandBuffer(bundle->bundleList.commandBuffer, &beginInfo) != VK_SUCCESS)
+        {
+            return "Failed to begin the command buffer";
+        }
+        return ResultCode::Success;
+    }
+
+    void ExecuteVulkanBundle(gaCommandList* list, CommandBundle* bundle)
+    {
+        vkCmdExecuteCommands(static_cast<VulkanCommandList*>(list)->commandBuffer,
+                             1,
+                             &static_cast<VulkanCommandBundle*>(bundle)->bundleList.commandBuffer);
+    }
+
 } // namespace backend
 } // namespace rsbl
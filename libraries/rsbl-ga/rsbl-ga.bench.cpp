@@ -0,0 +1,455 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// What recording and submitting costs the CPU on each backend the machine can make a device on:
+// per draw, per barrier, per bindless descriptor write and per submit, recording from one
+// thread up to one per recorder, and posting to a request queue from as many. The null backend
+// in Discard mode does nothing with what it's given, so its numbers are rsbl-ga's own overhead;
+// in Count mode they add its bookkeeping, and the difference to DX12 and Vulkan is the driver's.
+//
+// Draws need a pipeline, and a real backend's needs compiled shaders, so they run on the null
+// backend only. Barriers and descriptor writes go to a reserved buffer, which needs no memory
+// behind it.
+
+#include "include/rsbl-ga.h"
+
+#include <rsbl-bench.h>
+
+#include <atomic>
+#include <cstdio>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint32 kCommandsPerList = 1000; // Even, so barriers leave the buffer as they found it
+constexpr uint32 kViewsPerFrame = 256;
+constexpr uint32 kMaxRecorders = 8;
+constexpr uint32 kRequestsPerThread = 1000;
+
+// A null device takes any bytes as a shader
+constexpr uint8 kFakeShader[4] = {};
+
+struct DrawConstants
+{
+    uint32 instance;
+    uint32 material;
+};
+
+// What a backend's benchmarks share
+struct BenchDevice
+{
+    gaDevice* device = nullptr;
+    gaReservedResource* buffer = nullptr;
+    void* resource = nullptr; // The buffer's, for barriers, views and draw arguments
+    gaBindlessHeap* heap = nullptr;
+    gaPipelineCache* cache = nullptr;
+    gaPipeline* pipeline = nullptr; // Null backend only
+
+    BenchDevice() = default;
+    BenchDevice(const BenchDevice&) = delete;
+    BenchDevice& operator=(const BenchDevice&) = delete;
+
+    ~BenchDevice()
+    {
+        if (cache != nullptr)
+        {
+            GaDestroyPipelineCache(cache);
+        }
+        if (heap != nullptr)
+        {
+            GaDestroyBindlessHeap(heap);
+        }
+        if (buffer != nullptr)
+        {
+            GaDestroyReservedResource(buffer);
+        }
+        if (device != nullptr)
+        {
+            GaDestroyDevice(device);
+        }
+    }
+};
+
+// Null when the backend isn't there, or is missing what the benchmarks need
+const char* OpenDevice(BenchDevice& bench, gaBackend backend, gaNullMode nullMode)
+{
+    gaDeviceCreateInfo createInfo;
+    createInfo.backend = backend;
+    createInfo.appName = "rsbl-ga-bench";
+    createInfo.commandRecorders = kMaxRecorders;
+    createInfo.nullMode = nullMode;
+    auto device = GaCreateDevice(createInfo);
+    if (!device)
+    {
+        return device.FailureText();
+    }
+    bench.device = device.Value();
+    if (!bench.device->reservedResources || !bench.device->bindless)
+    {
+        return "The device has no reserved resources or bindless heaps";
+    }
+
+    gaReservedResourceCreateInfo bufferInfo;
+    bufferInfo.device = bench.device;
+    bufferInfo.size = 64 * 1024;
+    auto buffer = GaCreateReservedResource(bufferInfo);
+    if (!buffer)
+    {
+        return buffer.FailureText();
+    }
+    bench.buffer = buffer.Value();
+    // A null device's resources have no handle, and only a resource being given is checked
+    bench.resource = bench.buffer->internalHandle != nullptr ? bench.buffer->internalHandle
+                                                             : bench.buffer;
+
+    gaBindlessHeapCreateInfo heapInfo;
+    heapInfo.device = bench.device;
+    heapInfo.capacity = kViewsPerFrame * 8;
+    auto heap = GaCreateBindlessHeap(heapInfo);
+    if (!heap)
+    {
+        return heap.FailureText();
+    }
+    bench.heap = heap.Value();
+
+    if (backend == gaBackend::Null)
+    {
+        gaPipelineCacheCreateInfo cacheInfo;
+        cacheInfo.device = bench.device;
+        cacheInfo.bindless = bench.heap;
+        auto cache = GaCreatePipelineCache(cacheInfo);
+        if (!cache)
+        {
+            return cache.FailureText();
+        }
+        bench.cache = cache.Value();
+
+        gaGraphicsPipelineDesc desc;
+        desc.vertexShader = {kFakeShader, sizeof(kFakeShader)};
+        desc.pushConstantBytes = sizeof(DrawConstants);
+        auto pipeline = GaCreateGraphicsPipeline(bench.cache, desc);
+        if (!pipeline)
+        {
+            return pipeline.FailureText();
+        }
+        bench.pipeline = pipeline.Value();
+    }
+    return nullptr;
+}
+
+enum class Command
+{
+    Draw,    // Push constants and a single indirect draw, the usual per-object pair
+    Barrier, // One buffer transition per GaCmdBarriers
+};
+
+// Failures are counted rather than checked, which would be timed too
+uint32 Record(gaCommandList* list, const BenchDevice& bench, Command command, uint32 count)
+{
+    uint32 failures = 0;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (command == Command::Draw)
+        {
+            const DrawConstants constants = {i, i & 63};
+            failures += !GaCmdPushConstants(list, bench.pipeline, 0, &constants, sizeof(constants));
+            failures += !GaCmdDrawIndexedIndirect(list, bench.resource, 0, 1);
+        }
+        else
+        {
+            gaBarrier barrier;
+            barrier.resource = bench.resource;
+            barrier.before = i % 2 == 0 ? gaResourceState::Common : gaResourceState::CopyDest;
+            barrier.after = i % 2 == 0 ? gaResourceState::CopyDest : gaResourceState::Common;
+            barrier.texture = false;
+            failures += !GaCmdBarriers(list, {&barrier, 1});
+        }
+    }
+    return failures;
+}
+
+// A new frame and a list recording on recorder 0. Ends and submits the last one first, if any.
+uint32 NextList(const BenchDevice& bench, gaCommandList*& list)
+{
+    uint32 failures = 0;
+    if (list != nullptr)
+    {
+        failures += !GaEndCommandList(list);
+        failures += !GaSubmit(bench.device, gaQueueType::Graphics, {&list, 1});
+        list = nullptr;
+    }
+    failures += !GaBeginFrame(bench.device);
+    auto begun = GaBeginCommandList(bench.device, gaQueueType::Graphics, 0);
+    if (!begun)
+    {
+        return failures + 1;
+    }
+    list = begun.Value();
+    return failures;
+}
+
+void RecordRun(Bench& bench, const BenchDevice& device, const char* name, Command command)
+{
+    gaCommandList* list = nullptr;
+    uint32 failures = 0;
+    bench.Run(name, [&]() { failures += NextList(device, list); }, [&]() {
+        failures += Record(list, device, command, kCommandsPerList);
+    }, {.items = kCommandsPerList});
+    if (list != nullptr)
+    {
+        failures += !GaEndCommandList(list);
+        failures += !GaSubmit(device.device, gaQueueType::Graphics, {&list, 1});
+    }
+    if (failures > 0)
+    {
+        printf("  %s: %u calls failed\n", name, failures);
+    }
+}
+
+void SubmitRuns(Bench& bench, const BenchDevice& device)
+{
+    uint32 failures = 0;
+    bench.Run("Begin + end list", [&]() { failures += !GaBeginFrame(device.device); }, [&]() {
+        auto list = GaBeginCommandList(device.device, gaQueueType::Graphics, 0);
+        failures += !list || !GaEndCommandList(list.Value());
+    });
+
+    // Submits of ready lists, one and then one from each recorder
+    for (uint32 count : {1u, kMaxRecorders})
+    {
+        gaCommandList* lists[kMaxRecorders] = {};
+        char name[64];
+        snprintf(name, sizeof(name), "Submit, %u empty list%s", count, count > 1 ? "s" : "");
+        bench.Run(name, [&]() {
+            failures += !GaBeginFrame(device.device);
+            for (uint32 i = 0; i < count; ++i)
+            {
+                auto list = GaBeginCommandList(device.device, gaQueueType::Graphics, i);
+                failures += !list || !GaEndCommandList(list.Value());
+                lists[i] = list ? list.Value() : nullptr;
+            }
+        }, [&]() {
+            failures += !GaSubmit(device.device, gaQueueType::Graphics, {lists, count});
+        });
+    }
+    if (failures > 0)
+    {
+        printf("  Submits: %u calls failed\n", failures);
+    }
+}
+
+// Writes of a buffer view into the bindless heap. A frame's indices are released the next
+// frame, and handed out again once the frames in flight are done with them.
+void DescriptorRun(Bench& bench, const BenchDevice& device)
+{
+    uint32 indices[kViewsPerFrame];
+    uint32 registered = 0;
+    uint32 failures = 0;
+    gaBindlessView view;
+    view.type = gaBindlessViewType::BufferSrv;
+    view.resource = device.resource;
+    view.size = 4096;
+
+    const auto release = [&]() {
+        for (uint32 i = 0; i < registered; ++i)
+        {
+            GaReleaseBindless(device.heap, indices[i]);
+        }
+        registered = 0;
+    };
+    bench.Run("Bindless descriptor write", [&]() {
+        release();
+        failures += !GaBeginFrame(device.device);
+    }, [&]() {
+        for (uint32 i = 0; i < kViewsPerFrame; ++i)
+        {
+            auto index = GaRegisterBindless(device.heap, view);
+            failures += !index;
+            indices[registered] = index ? index.Value() : 0;
+            registered += index ? 1 : 0;
+        }
+    }, {.items = kViewsPerFrame});
+    release();
+    if (failures > 0)
+    {
+        printf("  Bindless descriptor write: %u calls failed\n", failures);
+    }
+}
+
+// threadCount threads each record kCommandsPerList commands into a list of their own recorder,
+// then the lists go in one submit
+void ThreadedRun(Bench& bench, const BenchDevice& device, Command command, uint32 threadCount)
+{
+    struct Shared
+    {
+        const BenchDevice* device;
+        Command command;
+        gaCommandList* lists[kMaxRecorders];
+        std::atomic<uint32> failures{0};
+    };
+    Shared shared;
+    shared.device = &device;
+    shared.command = command;
+
+    char name[64];
+    snprintf(name,
+             sizeof(name),
+             "%s, %u thread%s",
+             command == Command::Draw ? "Draws" : "Barriers",
+             threadCount,
+             threadCount > 1 ? "s" : "");
+
+    UniquePtr<BenchThreads> threads;
+    bench.Run(name, [&]() {
+        shared.failures.fetch_add(!GaBeginFrame(device.device), std::memory_order_relaxed);
+        threads = MakeUnique<BenchThreads>(threadCount);
+        for (uint32 i = 0; i < threadCount; ++i)
+        {
+            shared.lists[i] = nullptr;
+            threads->Add([&shared, i]() {
+                auto list = GaBeginCommandList(shared.device->device, gaQueueType::Graphics, i);
+                if (!list)
+                {
+                    shared.failures.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                uint32 failures = Record(list.Value(), *shared.device, shared.command,
+                                         kCommandsPerList);
+                failures += !GaEndCommandList(list.Value());
+                shared.failures.fetch_add(failures, std::memory_order_relaxed);
+                shared.lists[i] = list.Value();
+            });
+        }
+    }, [&]() {
+        threads->Start();
+        threads->Join();
+        shared.failures.fetch_add(
+            !GaSubmit(device.device, gaQueueType::Graphics, {shared.lists, threadCount}),
+            std::memory_order_relaxed);
+    }, {.items = uint64(kCommandsPerList) * threadCount});
+    threads = UniquePtr<BenchThreads>();
+
+    if (shared.failures.load() > 0)
+    {
+        printf("  %s: %u calls failed\n", name, shared.failures.load());
+    }
+}
+
+// threadCount threads each post kRequestsPerThread requests to a request queue at once, then the
+// owner drains them in one go. The requests do nothing, so this is the queue's own cost.
+void RequestRun(Bench& bench, const BenchDevice& device, uint32 threadCount)
+{
+    gaRequestQueueCreateInfo createInfo;
+    createInfo.device = device.device;
+    createInfo.arenas = kMaxRecorders * kRequestsPerThread / createInfo.requestsPerArena + 2;
+    auto queue = GaCreateRequestQueue(createInfo);
+    if (!queue)
+    {
+        printf("  Requests skipped: %s\n", queue.FailureText());
+        return;
+    }
+
+    struct Shared
+    {
+        gaRequestQueue* queue;
+        std::atomic<uint32> failures{0};
+    };
+    Shared shared;
+    shared.queue = queue.Value();
+
+    char name[64];
+    snprintf(name,
+             sizeof(name),
+             "Post + drain requests, %u thread%s",
+             threadCount,
+             threadCount > 1 ? "s" : "");
+
+    UniquePtr<BenchThreads> threads;
+    bench.Run(name, [&]() {
+        shared.failures.fetch_add(!GaBeginFrame(device.device), std::memory_order_relaxed);
+        threads = MakeUnique<BenchThreads>(threadCount);
+        for (uint32 i = 0; i < threadCount; ++i)
+        {
+            threads->Add([&shared]() {
+                uint32 failures = 0;
+                for (uint32 j = 0; j < kRequestsPerThread; ++j)
+                {
+                    failures += !GaPostRequest(shared.queue, [](gaRequestQueue*) -> Result<> {
+                        return ResultCode::Success;
+                    });
+                }
+                shared.failures.fetch_add(failures, std::memory_order_relaxed);
+            });
+        }
+    }, [&]() {
+        threads->Start();
+        threads->Join();
+        auto drained = GaDrainRequests(shared.queue);
+        shared.failures.fetch_add(!drained || drained.Value() != kRequestsPerThread * threadCount,
+                                  std::memory_order_relaxed);
+    }, {.items = uint64(kRequestsPerThread) * threadCount});
+    threads = UniquePtr<BenchThreads>();
+    GaDestroyRequestQueue(shared.queue);
+
+    if (shared.failures.load() > 0)
+    {
+        printf("  %s: %u calls failed\n", name, shared.failures.load());
+    }
+}
+
+void RunBackend(Bench& bench, const BenchDevice& device, uint32 maxThreads)
+{
+    const bool draws = device.pipeline != nullptr;
+    if (draws)
+    {
+        RecordRun(bench, device, "Draw: push constants + indirect draw", Command::Draw);
+    }
+    RecordRun(bench, device, "Barrier", Command::Barrier);
+    DescriptorRun(bench, device);
+    SubmitRuns(bench, device);
+
+    for (uint32 threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ThreadedRun(bench, device, draws ? Command::Draw : Command::Barrier, threads);
+    }
+    for (uint32 threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        RequestRun(bench, device, threads);
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Bench bench("rsbl-ga", argc, argv);
+    const uint32 hardwareThreads = Thread::GetHardwareThreadCount();
+    const uint32 maxThreads = hardwareThreads < kMaxRecorders ? hardwareThreads : kMaxRecorders;
+    printf("%u commands per list, %u hardware threads\n", kCommandsPerList, hardwareThreads);
+
+    struct Backend
+    {
+        const char* name;
+        gaBackend backend;
+        gaNullMode nullMode;
+    };
+    const Backend backends[] = {
+        {"Null, discard", gaBackend::Null, gaNullMode::Discard},
+        {"Null, count", gaBackend::Null, gaNullMode::Count},
+        {"DX12", gaBackend::DX12, gaNullMode::Count},
+        {"Vulkan", gaBackend::Vulkan, gaNullMode::Count},
+    };
+    for (const Backend& backend : backends)
+    {
+        BenchDevice device;
+        if (const char* failure = OpenDevice(device, backend.backend, backend.nullMode))
+        {
+            printf("%s skipped: %s\n", backend.name, failure);
+            continue;
+        }
+        bench.Section(backend.name);
+        RunBackend(bench, device, maxThreads);
+    }
+
+    return bench.Finish();
+}
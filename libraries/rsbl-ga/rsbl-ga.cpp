@@ -3,25 +3,200 @@
 
 #include "rsbl-ga-backends.h"
 
+#include <rsbl-counters.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-os-trace.h>
+#include <rsbl-profile.h>
+
+#include <cmath>
+#include <cstring>
+
 namespace rsbl
 {
 
+namespace
+{
+bool ContainsIgnoringCase(const char* text, const char* part)
+{
+    const auto lower = [](char c) { return c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c; };
+    for (; *text != '\0'; ++text)
+    {
+        uint32 i = 0;
+        while (part[i] != '\0' && lower(text[i]) == lower(part[i]))
+        {
+            ++i;
+        }
+        if (part[i] == '\0')
+        {
+            return true;
+        }
+    }
+    return part[0] == '\0';
+}
+
+// Lower is better
+uint32 TypeRank(gaAdapterType type, gaPowerPreference preference)
+{
+    switch (type)
+    {
+    case gaAdapterType::Discrete:
+        return preference == gaPowerPreference::HighPerformance ? 0 : 1;
+    case gaAdapterType::Integrated:
+        return preference == gaPowerPreference::HighPerformance ? 1 : 0;
+    case gaAdapterType::Virtual:
+        return 2;
+    default:
+        return 3;
+    }
+}
+
+Result<gaSharedBuffer*> CreateSharedBuffer(const gaSharedBufferCreateInfo& createInfo)
+{
+    switch (createInfo.device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullSharedBuffer(createInfo);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12SharedBuffer(createInfo);
+
+    case gaBackend::Vulkan:
+        return {ErrorCategory::NotFound,
+                "Vulkan can't share memory between devices, shared buffers are DX12 only"};
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+} // namespace
+
+namespace backend
+{
+    uint32 SelectAdapter(ArrayView<const gaAdapterInfo> candidates,
+                         const gaDeviceCreateInfo& createInfo)
+    {
+        if (createInfo.adapter != nullptr)
+        {
+            for (uint32 i = 0; i < candidates.Size(); ++i)
+            {
+                if (memcmp(candidates[i].id, createInfo.adapter->id, sizeof(gaAdapterInfo::id)) ==
+                    0)
+                {
+                    return i;
+                }
+            }
+            return ~0u;
+        }
+
+        if (createInfo.preferredAdapter != nullptr && createInfo.preferredAdapter[0] != '\0')
+        {
+            for (uint32 i = 0; i < candidates.Size(); ++i)
+            {
+                if (ContainsIgnoringCase(candidates[i].name, createInfo.preferredAdapter))
+                {
+                    return i;
+                }
+            }
+        }
+
+        uint32 best = ~0u;
+        for (uint32 i = 0; i < candidates.Size(); ++i)
+        {
+            if (best == ~0u)
+            {
+                best = i;
+                continue;
+            }
+
+            const gaAdapterInfo& candidate = candidates[i];
+            const gaAdapterInfo& current = candidates[best];
+            const uint32 rank = TypeRank(candidate.type, createInfo.powerPreference);
+            const uint32 currentRank = TypeRank(current.type, createInfo.powerPreference);
+            if (rank != currentRank)
+            {
+                best = rank < currentRank ? i : best;
+            }
+            else if (candidate.bindless != current.bindless)
+            {
+                best = candidate.bindless ? i : best;
+            }
+            else if (candidate.dedicatedMemory > current.dedicatedMemory)
+            {
+                best = i;
+            }
+        }
+        return best;
+    }
+} // namespace backend
+
+Result<> GaEnumerateAdapters(gaBackend backend, DynamicArray<gaAdapterInfo>& adapters)
+{
+    adapters.Clear();
+    switch (backend)
+    {
+    case gaBackend::Null:
+    {
+        gaAdapterInfo adapter;
+        memcpy(adapter.name, "Null", sizeof("Null"));
+        adapter.bindless = true;
+        adapters.PushBack(adapter);
+        return ResultCode::Success;
+    }
+
+    case gaBackend::DX12:
+        return backend::EnumerateDX12Adapters(adapters);
+
+    case gaBackend::Vulkan:
+        return backend::EnumerateVulkanAdapters(adapters);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
 Result<gaDevice*> GaCreateDevice(const gaDeviceCreateInfo& createInfo)
 {
+    if (createInfo.commandRecorders == 0 || createInfo.commandRecorders > 256)
+    {
+        return "Command recorders must be between 1 and 256";
+    }
+
+    if (createInfo.framesInFlight == 0 || createInfo.framesInFlight > 4)
+    {
+        return "Frames in flight must be between 1 and 4";
+    }
+
+    if (createInfo.powerPreference >= gaPowerPreference::Count)
+    {
+        return {ErrorCategory::InvalidArgument, "Unknown power preference"};
+    }
+
+    // Backend objects (and anything they allocate while being set up) are charged to Ga
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    Result<gaDevice*> device = "Unknown graphics backend";
     switch (createInfo.backend)
     {
     case gaBackend::Null:
-        return backend::CreateNullDevice(createInfo);
+        device = backend::CreateNullDevice(createInfo);
+        break;
 
     case gaBackend::DX12:
-        return backend::CreateDX12Device(createInfo);
+        device = backend::CreateDX12Device(createInfo);
+        break;
 
     case gaBackend::Vulkan:
-        return backend::CreateVulkanDevice(createInfo);
+        device = backend::CreateVulkanDevice(createInfo);
+        break;
 
     default:
-        return "Unknown graphics backend";
+        break;
+    }
+    if (device)
+    {
+        device.Value()->deferredDestroys = backend::CreateDeferredDestroys();
     }
+    return device;
 }
 
 void GaDestroyDevice(gaDevice* device)
@@ -31,6 +206,11 @@ void GaDestroyDevice(gaDevice* device)
         return;
     }
 
+    // Deferred objects can hold on to the device's, so they go first, once the GPU is done
+    (void)GaWaitForIdle(device);
+    backend::DestroyDeferredDestroys(device->deferredDestroys);
+    device->deferredDestroys = nullptr;
+
     // Virtual destructor will call the appropriate backend-specific destructor
     delete device;
 }
@@ -42,6 +222,19 @@ Result<gaSwapchain*> GaCreateSwapchain(const gaSwapchainCreateInfo& createInfo)
         return "Device cannot be null";
     }
 
+    if (createInfo.presentMode >= gaPresentMode::Count)
+    {
+        return {ErrorCategory::InvalidArgument, "Unknown present mode"};
+    }
+
+    if (createInfo.maxFrameLatency == 0 || createInfo.maxFrameLatency > createInfo.bufferCount)
+    {
+        return {ErrorCategory::InvalidArgument,
+                "Swapchain frame latency must be between 1 and the buffer count"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
     switch (createInfo.device->backend)
     {
     case gaBackend::Null:
@@ -69,4 +262,1751 @@ void GaDestroySwapchain(gaSwapchain* swapchain)
     delete swapchain;
 }
 
+Result<> GaWaitForSwapchain(gaSwapchain* swapchain, uint32 timeoutMs)
+{
+    if (swapchain == nullptr)
+    {
+        return "Swapchain cannot be null";
+    }
+
+    switch (swapchain->backend)
+    {
+    case gaBackend::Null:
+        // Nothing to recreate
+        if (swapchain->resizeWidth != 0 && swapchain->resizeHeight != 0)
+        {
+            swapchain->width = swapchain->resizeWidth;
+            swapchain->height = swapchain->resizeHeight;
+        }
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::WaitForDX12Swapchain(swapchain, timeoutMs);
+
+    case gaBackend::Vulkan:
+        return backend::WaitForVulkanSwapchain(swapchain, timeoutMs);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<> GaResizeSwapchain(gaSwapchain* swapchain, uint32 width, uint32 height)
+{
+    if (swapchain == nullptr)
+    {
+        return "Swapchain cannot be null";
+    }
+
+    swapchain->resizeWidth = width;
+    swapchain->resizeHeight = height;
+    return ResultCode::Success;
+}
+
+Result<> GaPresent(gaSwapchain* swapchain)
+{
+    RSBL_PROFILE_ZONE("GaPresent");
+    if (swapchain == nullptr)
+    {
+        return "Swapchain cannot be null";
+    }
+    OsTraceMark(OsTraceEvent::Present, "GaPresent", reinterpret_cast<uint64>(swapchain));
+
+    // Counted whether or not it works out, as DXGI and present ids count them
+    ++swapchain->presentCount;
+    switch (swapchain->backend)
+    {
+    case gaBackend::Null:
+        return backend::PresentNull(swapchain);
+
+    case gaBackend::DX12:
+        return backend::PresentDX12(swapchain);
+
+    case gaBackend::Vulkan:
+        return backend::PresentVulkan(swapchain);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<> GaSetExclusiveFullscreen(gaSwapchain* swapchain, bool exclusive)
+{
+    if (swapchain == nullptr)
+    {
+        return "Swapchain cannot be null";
+    }
+
+    if (swapchain->offscreen)
+    {
+        return {ErrorCategory::InvalidArgument, "Offscreen swapchains have no window to fill"};
+    }
+
+    switch (swapchain->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::SetDX12ExclusiveFullscreen(swapchain, exclusive);
+
+    case gaBackend::Vulkan:
+        return {ErrorCategory::InvalidArgument,
+                "Exclusive fullscreen isn't supported on Vulkan, use a borderless window"};
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaPresentStats> GaGetPresentStats(gaSwapchain* swapchain)
+{
+    if (swapchain == nullptr)
+    {
+        return "Swapchain cannot be null";
+    }
+
+    gaPresentStats presentStats;
+    presentStats.presentCount = swapchain->presentCount;
+    if (swapchain->offscreen)
+    {
+        // Nothing's ever displayed
+        return presentStats;
+    }
+
+    Result<> read = "Unknown graphics backend";
+    switch (swapchain->backend)
+    {
+    case gaBackend::Null:
+        read = backend::GetNullPresentStats(swapchain, presentStats);
+        break;
+
+    case gaBackend::DX12:
+        read = backend::GetDX12PresentStats(swapchain, presentStats);
+        break;
+
+    case gaBackend::Vulkan:
+        read = backend::GetVulkanPresentStats(swapchain, presentStats);
+        break;
+
+    default:
+        break;
+    }
+    if (!read)
+    {
+        return PendingFailure{read.Category()};
+    }
+    return presentStats;
+}
+
+static Result<gaCommandList*> BeginBackendCommandList(gaDevice* device,
+                                                     gaQueueType queue,
+                                                     uint32 recorder)
+{
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return backend::BeginNullCommandList(device, queue, recorder);
+
+    case gaBackend::DX12:
+        return backend::BeginDX12CommandList(device, queue, recorder);
+
+    case gaBackend::Vulkan:
+        return backend::BeginVulkanCommandList(device, queue, recorder);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<> GaBeginFrame(gaDevice* device)
+{
+    if (device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    ++device->frame;
+
+    Result<> begun = "Unknown graphics backend";
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        begun = backend::BeginNullFrame(device);
+        break;
+
+    case gaBackend::DX12:
+        begun = backend::BeginDX12Frame(device);
+        break;
+
+    case gaBackend::Vulkan:
+        begun = backend::BeginVulkanFrame(device);
+        break;
+
+    default:
+        break;
+    }
+
+    // Frames framesInFlight back are done once the backend has begun the frame
+    if (begun)
+    {
+        backend::BeginDeferredFrame(
+            device->deferredDestroys, device->frame, device->framesInFlight);
+    }
+    return begun;
+}
+
+Result<> GaWaitForIdle(gaDevice* device)
+{
+    if (device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    Result<> idle = ResultCode::Success;
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        break;
+
+    case gaBackend::DX12:
+        idle = backend::WaitForDX12Idle(device);
+        break;
+
+    case gaBackend::Vulkan:
+        idle = backend::WaitForVulkanIdle(device);
+        break;
+
+    default:
+        return "Unknown graphics backend";
+    }
+    if (!idle)
+    {
+        return idle;
+    }
+
+    backend::DestroyAllDeferred(device->deferredDestroys);
+    return ResultCode::Success;
+}
+
+Result<gaCommandList*> GaBeginCommandList(gaDevice* device, gaQueueType queue, uint32 recorder)
+{
+    if (device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (device->frame == 0)
+    {
+        return "GaBeginFrame must be called before recording";
+    }
+
+    if (recorder >= device->commandRecorders)
+    {
+        return "Command recorder is out of range";
+    }
+
+    if (static_cast<uint32>(queue) >= static_cast<uint32>(gaQueueType::Count))
+    {
+        return "Unknown queue type";
+    }
+
+    // Lists are kept for reuse, a new one is charged to Ga like the rest of the device
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    Result<gaCommandList*> list = BeginBackendCommandList(device, queue, recorder);
+    if (list)
+    {
+        gaCommandList* begun = list.Value();
+        begun->device = device;
+        begun->queue = queue;
+        begun->recorder = recorder;
+        begun->frame = device->frame;
+        begun->recording = true;
+        begun->submitted = false;
+        begun->bundle = false;
+        begun->stateTracker = nullptr;
+    }
+    return list;
+}
+
+Result<> GaEndCommandList(gaCommandList* list)
+{
+    if (list == nullptr)
+    {
+        return "Command list cannot be null";
+    }
+
+    if (!list->recording)
+    {
+        return "Command list is not recording";
+    }
+
+    if (list->bundle)
+    {
+        return "Bundles are ended with GaEndCommandBundle";
+    }
+
+    // Transitions queued after the last draw, like a back buffer's to Present
+    if (auto flushed = GaFlushBarriers(list); !flushed)
+    {
+        return flushed;
+    }
+
+    list->recording = false;
+
+    switch (list->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::EndDX12CommandList(list);
+
+    case gaBackend::Vulkan:
+        return backend::EndVulkanCommandList(list);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<> GaSubmit(gaDevice* device, gaQueueType queue, ArrayView<gaCommandList* const> lists)
+{
+    RSBL_PROFILE_ZONE("GaSubmit");
+    if (device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (static_cast<uint32>(queue) >= static_cast<uint32>(gaQueueType::Count))
+    {
+        return "Unknown queue type";
+    }
+
+    for (const gaCommandList* list : lists)
+    {
+        if (list == nullptr)
+        {
+            return "Command list cannot be null";
+        }
+
+        if (list->recording)
+        {
+            return "Command lists must be ended before they're submitted";
+        }
+
+        if (list->bundle)
+        {
+            return "Bundles are replayed with GaCmdExecuteBundle, not submitted";
+        }
+
+        // An older frame's list may have been recycled already
+        if (list->frame != device->frame || list->submitted)
+        {
+            return "Command lists must be from this frame and not submitted already";
+        }
+
+        if (list->queue != queue || list->backend != device->backend)
+        {
+            return "Command lists must be for the queue they're submitted to";
+        }
+    }
+
+    if (lists.IsEmpty())
+    {
+        return ResultCode::Success;
+    }
+
+    for (gaCommandList* list : lists)
+    {
+        list->submitted = true;
+    }
+
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        backend::SubmitNull(device, lists);
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::SubmitDX12(device, queue, lists);
+
+    case gaBackend::Vulkan:
+        return backend::SubmitVulkan(device, queue, lists);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaFence*> GaCreateFence(gaDevice* device, uint64 initialValue)
+{
+    if (device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullFence(device, initialValue);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12Fence(device, initialValue);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanFence(device, initialValue);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+void GaDestroyFence(gaFence* fence)
+{
+    if (fence == nullptr)
+    {
+        return;
+    }
+
+    // Virtual destructor will call the appropriate backend-specific destructor
+    delete fence;
+}
+
+Result<> GaSignalFence(gaDevice* device, gaQueueType queue, gaFence* fence, uint64 value)
+{
+    if (device == nullptr || fence == nullptr)
+    {
+        return "Device and fence cannot be null";
+    }
+
+    if (fence->backend != device->backend)
+    {
+        return "Fence is from another backend";
+    }
+
+    if (static_cast<uint32>(queue) >= static_cast<uint32>(gaQueueType::Count))
+    {
+        return "Unknown queue type";
+    }
+
+    // Both APIs need fences to only ever go up
+    if (value <= fence->signalledValue)
+    {
+        return "Fence values must increase with every signal";
+    }
+
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        // Nothing runs, so everything is done as soon as it's submitted
+        break;
+
+    case gaBackend::DX12:
+        if (auto signalled = backend::SignalDX12Fence(device, queue, fence, value); !signalled)
+        {
+            return PendingFailure{signalled.Category()};
+        }
+        break;
+
+    case gaBackend::Vulkan:
+        if (auto signalled = backend::SignalVulkanFence(device, queue, fence, value); !signalled)
+        {
+            return PendingFailure{signalled.Category()};
+        }
+        break;
+
+    default:
+        return "Unknown graphics backend";
+    }
+
+    fence->signalledValue = value;
+    if (fence->shared != nullptr)
+    {
+        fence->shared->signalledValue = value;
+    }
+    return ResultCode::Success;
+}
+
+Result<> GaCmdCopyBuffer(gaCommandList* list,
+                         void* destination,
+                         uint64 destinationOffset,
+                         void* source,
+                         uint64 sourceOffset,
+                         uint64 size)
+{
+    if (list == nullptr || destination == nullptr || source == nullptr)
+    {
+        return "Command list, destination and source cannot be null";
+    }
+
+    if (!list->recording || list->bundle)
+    {
+        return "Copies are recorded into recording lists, not bundles";
+    }
+
+    if (size == 0)
+    {
+        return ResultCode::Success;
+    }
+
+    // What GaUse queued for the copy goes first
+    if (auto flushed = GaFlushBarriers(list); !flushed)
+    {
+        return flushed;
+    }
+
+    switch (list->backend)
+    {
+    case gaBackend::Null:
+        backend::RecordNullCommand(list, {gaNullCommandType::CopyBuffer, 0, size, destination});
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        backend::RecordDX12BufferCopy(
+            list, destination, destinationOffset, source, sourceOffset, size);
+        return ResultCode::Success;
+
+    case gaBackend::Vulkan:
+        backend::RecordVulkanBufferCopy(
+            list, destination, destinationOffset, source, sourceOffset, size);
+        return ResultCode::Success;
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<> GaCmdDrawIndexedIndirect(gaCommandList* list,
+                                  void* arguments,
+                                  uint64 argumentOffset,
+                                  uint32 maxDraws,
+                                  void* count,
+                                  uint64 countOffset)
+{
+    if (list == nullptr || arguments == nullptr)
+    {
+        return "Command list and arguments cannot be null";
+    }
+
+    if (!list->recording || list->queue != gaQueueType::Graphics)
+    {
+        return "Draws are recorded into recording lists on the graphics queue";
+    }
+
+    // Vulkan wants both offsets 4 byte aligned
+    if (argumentOffset % 4 != 0 || countOffset % 4 != 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Indirect offsets must be multiples of 4"};
+    }
+
+    if ((maxDraws > 1 || count != nullptr) && !list->device->drawIndirectCount)
+    {
+        return {ErrorCategory::NotFound, "The device draws one indirect draw at a time"};
+    }
+
+    if (maxDraws == 0)
+    {
+        return ResultCode::Success;
+    }
+
+    // What GaUse queued for the draw goes first
+    if (auto flushed = GaFlushBarriers(list); !flushed)
+    {
+        return flushed;
+    }
+    // With a count buffer, how many run is up to the GPU, this is the most that can
+    RSBL_COUNTER_ADD("ga.draws", maxDraws);
+
+    switch (list->backend)
+    {
+    case gaBackend::Null:
+        backend::RecordNullCommand(
+            list, {gaNullCommandType::DrawIndexedIndirect, maxDraws, 0, arguments});
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        backend::RecordDX12IndirectDraws(
+            list, arguments, argumentOffset, maxDraws, count, countOffset);
+        return ResultCode::Success;
+
+    case gaBackend::Vulkan:
+        backend::RecordVulkanIndirectDraws(
+            list, arguments, argumentOffset, maxDraws, count, countOffset);
+        return ResultCode::Success;
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<> GaCmdDispatchMesh(gaCommandList* list, uint32 groupsX, uint32 groupsY, uint32 groupsZ)
+{
+    if (list == nullptr)
+    {
+        return "Command list cannot be null";
+    }
+
+    if (!list->recording || list->queue != gaQueueType::Graphics)
+    {
+        return "Draws are recorded into recording lists on the graphics queue";
+    }
+
+    if (!list->device->meshShaders)
+    {
+        return {ErrorCategory::NotFound,
+                "The device has no mesh shaders, draw with vertex shaders"};
+    }
+
+    // D3D12's limits, which Vulkan's minimums match
+    constexpr uint32 kMaxGroupsPerSide = 65535;
+    constexpr uint64 kMaxGroups = uint64(1) << 22;
+    if (groupsX > kMaxGroupsPerSide || groupsY > kMaxGroupsPerSide ||
+        groupsZ > kMaxGroupsPerSide || uint64(groupsX) * groupsY * groupsZ > kMaxGroups)
+    {
+        return {ErrorCategory::InvalidArgument,
+                "Mesh dispatches are up to 65535 groups a side and 2^22 in all"};
+    }
+
+    if (groupsX == 0 || groupsY == 0 || groupsZ == 0)
+    {
+        return ResultCode::Success;
+    }
+
+    // What GaUse queued for the dispatch goes first
+    if (auto flushed = GaFlushBarriers(list); !flushed)
+    {
+        return flushed;
+    }
+    RSBL_COUNTER_ADD("ga.draws", 1);
+    RSBL_COUNTER_ADD("ga.mesh_groups", uint64(groupsX) * groupsY * groupsZ);
+
+    switch (list->backend)
+    {
+    case gaBackend::Null:
+        backend::RecordNullCommand(
+            list, {gaNullCommandType::DispatchMesh, groupsX * groupsY * groupsZ, 0, nullptr});
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        backend::RecordDX12MeshDispatch(list, groupsX, groupsY, groupsZ);
+        return ResultCode::Success;
+
+    case gaBackend::Vulkan:
+        backend::RecordVulkanMeshDispatch(list, groupsX, groupsY, groupsZ);
+        return ResultCode::Success;
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<> GaCmdSetShadingRate(gaCommandList* list, gaShadingRate rate, void* rateImage)
+{
+    if (list == nullptr)
+    {
+        return "Command list cannot be null";
+    }
+
+    if (!list->recording || list->queue != gaQueueType::Graphics || list->bundle)
+    {
+        return "Shading rates are set in recording lists on the graphics queue, not bundles";
+    }
+
+    if (!list->device->variableRateShading)
+    {
+        return {ErrorCategory::NotFound, "The device has no variable rate shading"};
+    }
+
+    switch (rate)
+    {
+    case gaShadingRate::Rate1x1:
+    case gaShadingRate::Rate1x2:
+    case gaShadingRate::Rate2x1:
+    case gaShadingRate::Rate2x2:
+        break;
+
+    case gaShadingRate::Rate2x4:
+    case gaShadingRate::Rate4x2:
+    case gaShadingRate::Rate4x4:
+        if (!list->device->largeShadingRates)
+        {
+            return {ErrorCategory::NotFound, "The device shades at up to 2x2"};
+        }
+        break;
+
+    default:
+        return {ErrorCategory::InvalidArgument, "Unknown shading rate"};
+    }
+
+    switch (list->backend)
+    {
+    case gaBackend::Null:
+        backend::RecordNullCommand(
+            list, {gaNullCommandType::SetShadingRate, static_cast<uint32>(rate), 0, rateImage});
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        backend::RecordDX12ShadingRate(list, rate, rateImage);
+        return ResultCode::Success;
+
+    case gaBackend::Vulkan:
+        backend::RecordVulkanShadingRate(list, rate, rateImage);
+        return ResultCode::Success;
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaSharedBuffer*> GaCreateSharedBuffer(const gaSharedBufferCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr || createInfo.peer == nullptr)
+    {
+        return "Device and peer cannot be null";
+    }
+
+    if (createInfo.device == createInfo.peer ||
+        createInfo.device->backend != createInfo.peer->backend)
+    {
+        return {ErrorCategory::InvalidArgument, "The peer must be another device of the backend"};
+    }
+
+    if (createInfo.size == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Shared buffer size must be greater than zero"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    Result<gaSharedBuffer*> created = CreateSharedBuffer(createInfo);
+    if (!created)
+    {
+        return created;
+    }
+
+    gaSharedBuffer* shared = created.Value();
+    shared->fence->shared = shared->peerFence;
+    shared->peerFence->shared = shared->fence;
+    return shared;
+}
+
+void GaDestroySharedBuffer(gaSharedBuffer* buffer)
+{
+    delete buffer;
+}
+
+Result<> GaQueueWaitForFence(gaDevice* device, gaQueueType queue, gaFence* fence, uint64 value)
+{
+    if (device == nullptr || fence == nullptr)
+    {
+        return "Device and fence cannot be null";
+    }
+
+    if (fence->backend != device->backend)
+    {
+        return "Fence is from another backend";
+    }
+
+    if (static_cast<uint32>(queue) >= static_cast<uint32>(gaQueueType::Count))
+    {
+        return "Unknown queue type";
+    }
+
+    // A queue waiting on a value that's never signalled hangs the device
+    if (value > fence->signalledValue)
+    {
+        return "Fence value hasn't been signalled";
+    }
+
+    switch (device->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::QueueWaitForDX12Fence(device, queue, fence, value);
+
+    case gaBackend::Vulkan:
+        return backend::QueueWaitForVulkanFence(device, queue, fence, value);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+uint64 GaGetFenceValue(gaFence* fence)
+{
+    if (fence == nullptr)
+    {
+        return 0;
+    }
+
+    switch (fence->backend)
+    {
+    case gaBackend::DX12:
+        return backend::GetDX12FenceValue(fence);
+
+    case gaBackend::Vulkan:
+        return backend::GetVulkanFenceValue(fence);
+
+    default:
+        return fence->signalledValue;
+    }
+}
+
+Result<> GaWaitForFence(gaFence* fence, uint64 value)
+{
+    if (fence == nullptr)
+    {
+        return "Fence cannot be null";
+    }
+
+    // Nothing would ever signal it
+    if (value > fence->signalledValue)
+    {
+        return "Fence value hasn't been signalled";
+    }
+
+    switch (fence->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::WaitForDX12Fence(fence, value);
+
+    case gaBackend::Vulkan:
+        return backend::WaitForVulkanFence(fence, value);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaSkinningPass*> GaCreateSkinningPass(const gaSkinningPassCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.vertexCount == 0 || createInfo.jointCount == 0 || createInfo.instanceCount == 0)
+    {
+        return "Skinning pass vertex, joint and instance counts must be greater than zero";
+    }
+
+    // Joint indices are 16 bit, a dispatch is a thread group per 64 vertices by one per instance
+    // (at most 65535 of either), and the shader addresses the output with 32 bit offsets
+    if (createInfo.jointCount > 65536 || createInfo.vertexCount > 65535u * 64 ||
+        createInfo.instanceCount > 65535 ||
+        uint64(createInfo.vertexCount) * createInfo.instanceCount * sizeof(gaSkinnedVertex) >
+            0xffffffffull)
+    {
+        return "Skinning pass is too large";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    switch (createInfo.device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullSkinningPass(createInfo);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12SkinningPass(createInfo);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanSkinningPass(createInfo);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+void GaDestroySkinningPass(gaSkinningPass* pass)
+{
+    if (pass == nullptr)
+    {
+        return;
+    }
+
+    // Virtual destructor will call the appropriate backend-specific destructor
+    delete pass;
+}
+
+Result<> GaUploadSkinVertices(gaSkinningPass* pass, ArrayView<const gaSkinVertex> vertices)
+{
+    if (pass == nullptr)
+    {
+        return "Skinning pass cannot be null";
+    }
+
+    if (vertices.Size() != pass->vertexCount)
+    {
+        return "Skin vertex count doesn't match the skinning pass";
+    }
+
+    for (const gaSkinVertex& vertex : vertices)
+    {
+        for (uint16 joint : vertex.joints)
+        {
+            if (joint >= pass->jointCount)
+            {
+                return "Skin vertex joint index is out of range";
+            }
+        }
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    switch (pass->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::UploadDX12SkinVertices(pass, vertices);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<> GaDispatchSkinning(gaSkinningPass* pass, ArrayView<const float> palettes)
+{
+    if (pass == nullptr)
+    {
+        return "Skinning pass cannot be null";
+    }
+
+    const uint64 instanceFloats = uint64(pass->jointCount) * kGaSkinningPaletteFloats;
+    if (palettes.Size() % instanceFloats != 0 ||
+        palettes.Size() / instanceFloats > pass->instanceCount)
+    {
+        return "Palettes must be whole instances, no more than the skinning pass has";
+    }
+
+    if (palettes.IsEmpty())
+    {
+        return ResultCode::Success;
+    }
+
+    switch (pass->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::DispatchDX12Skinning(pass, palettes);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaCullingPass*> GaCreateCullingPass(const gaCullingPassCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.instanceCount == 0)
+    {
+        return "Culling pass instance count must be greater than zero";
+    }
+
+    // A dispatch is a thread group per 64 instances, at most 65535 of them. The pyramid is for
+    // depth buffers a texture could be.
+    if (createInfo.instanceCount > 65535u * 64 || createInfo.depthWidth > 16384 ||
+        createInfo.depthHeight > 16384)
+    {
+        return "Culling pass is too large";
+    }
+
+    if ((createInfo.depthWidth == 0) != (createInfo.depthHeight == 0))
+    {
+        return "Culling pass depth must be both sizes or neither";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    switch (createInfo.device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullCullingPass(createInfo);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12CullingPass(createInfo);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanCullingPass(createInfo);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+void GaDestroyCullingPass(gaCullingPass* pass)
+{
+    if (pass == nullptr)
+    {
+        return;
+    }
+
+    // Virtual destructor will call the appropriate backend-specific destructor
+    delete pass;
+}
+
+Result<> GaUploadCullInstances(gaCullingPass* pass, ArrayView<const gaCullInstance> instances)
+{
+    if (pass == nullptr)
+    {
+        return "Culling pass cannot be null";
+    }
+
+    if (instances.Size() != pass->instanceCount)
+    {
+        return "Cull instance count doesn't match the culling pass";
+    }
+
+    for (const gaCullInstance& instance : instances)
+    {
+        // Also false for NaN, which would fail every plane
+        if (!(instance.radius >= 0.0f))
+        {
+            return "Cull instance radius must not be negative";
+        }
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    switch (pass->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::UploadDX12CullInstances(pass, instances);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<> GaDispatchCulling(gaCullingPass* pass, const gaCullView& view)
+{
+    if (pass == nullptr)
+    {
+        return "Culling pass cannot be null";
+    }
+
+    if (view.depth != nullptr && pass->depthWidth == 0)
+    {
+        return "Culling pass was created without a depth size to cull by";
+    }
+
+    if (view.phase > gaCullPhase::Disoccluded)
+    {
+        return {ErrorCategory::InvalidArgument, "Unknown culling phase"};
+    }
+
+    if (view.phase == gaCullPhase::Disoccluded && view.depth == nullptr)
+    {
+        return {ErrorCategory::InvalidArgument, "Disoccluded culls by this frame's depth"};
+    }
+
+    switch (pass->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::DispatchDX12Culling(pass, view);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaLightBinningPass*> GaCreateLightBinningPass(
+    const gaLightBinningPassCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.maxLights == 0 || createInfo.maxLightsPerCluster == 0)
+    {
+        return "Light binning pass light counts must be greater than zero";
+    }
+
+    if (createInfo.clusterCountX == 0 || createInfo.clusterCountY == 0 ||
+        createInfo.clusterCountZ == 0)
+    {
+        return "Light binning pass cluster counts must be greater than zero";
+    }
+
+    // A dispatch is a thread group per 64 clusters, at most 65535 of them, and the cluster lists
+    // stay within what a structured buffer view can index
+    const uint64 clusterCount = uint64(createInfo.clusterCountX) * createInfo.clusterCountY *
+                                createInfo.clusterCountZ;
+    if (clusterCount > 65535u * 64 || createInfo.maxLights > (1u << 20) ||
+        clusterCount * (uint64(createInfo.maxLightsPerCluster) + 1) > (1ull << 29))
+    {
+        return "Light binning pass is too large";
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    switch (createInfo.device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullLightBinningPass(createInfo);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12LightBinningPass(createInfo);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanLightBinningPass(createInfo);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+void GaDestroyLightBinningPass(gaLightBinningPass* pass)
+{
+    if (pass == nullptr)
+    {
+        return;
+    }
+
+    // Virtual destructor will call the appropriate backend-specific destructor
+    delete pass;
+}
+
+Result<> GaDispatchLightBinning(gaLightBinningPass* pass,
+                                ArrayView<const gaPunctualLight> lights,
+                                const gaLightBinningView& view)
+{
+    if (pass == nullptr)
+    {
+        return "Light binning pass cannot be null";
+    }
+
+    if (lights.Size() > pass->maxLights)
+    {
+        return "More lights than the light binning pass was made for";
+    }
+
+    // Also false for NaN
+    if (!(view.nearZ > 0.0f) || !(view.farZ > view.nearZ) || !(view.tanHalfFovX > 0.0f) ||
+        !(view.tanHalfFovY > 0.0f))
+    {
+        return {ErrorCategory::InvalidArgument, "Light binning view needs a perspective"};
+    }
+
+    if (view.width == 0 || view.height == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Light binning view size must not be zero"};
+    }
+
+    for (const gaPunctualLight& light : lights)
+    {
+        if (light.type > gaLightType::Directional)
+        {
+            return {ErrorCategory::InvalidArgument, "Unknown light type"};
+        }
+        if (!(light.range >= 0.0f))
+        {
+            return {ErrorCategory::InvalidArgument, "Light range must not be negative"};
+        }
+    }
+
+    // Slice k starts at nearZ * (farZ / nearZ)^(k / clusterCountZ)
+    gaClusterGrid& grid = pass->grid;
+    grid.tileScale[0] = float(grid.clusterCountX) / float(view.width);
+    grid.tileScale[1] = float(grid.clusterCountY) / float(view.height);
+    grid.depthScale = float(grid.clusterCountZ) / log2f(view.farZ / view.nearZ);
+    grid.depthBias = -log2f(view.nearZ) * grid.depthScale;
+
+    switch (pass->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::DispatchDX12LightBinning(pass, lights, view);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+static_assert(sizeof(gaPunctualLight) == 64, "PunctualLight layout");
+static_assert(sizeof(gaClusterGrid) == 32, "ClusterGrid layout");
+
+// Structured buffers pack tightly, so the structs match gaPunctualLight and gaClusterGrid
+const char kGaClusteredLightingShader[] = R"(
+struct PunctualLight // gaPunctualLight
+{
+    float3 position;
+    float range;
+    float3 color;
+    uint type;
+    float3 direction;
+    float innerConeCos;
+    float outerConeCos;
+    float3 padding;
+};
+
+struct ClusterGrid // gaClusterGrid
+{
+    float2 tileScale;
+    float depthScale;
+    float depthBias;
+    uint clusterCountX;
+    uint clusterCountY;
+    uint clusterCountZ;
+    uint maxLightsPerCluster;
+};
+
+// gaLightType
+static const uint kPointLight = 0;
+static const uint kSpotLight = 1;
+static const uint kDirectionalLight = 2;
+
+// The cluster of a pixel, by its position in pixels (SV_Position.xy) and its view depth
+// (SV_Position.w, for a perspective projection)
+uint ClusterIndex(ClusterGrid grid, float2 pixel, float viewDepth)
+{
+    const uint x = min(uint(pixel.x * grid.tileScale.x), grid.clusterCountX - 1);
+    const uint y = min(uint(pixel.y * grid.tileScale.y), grid.clusterCountY - 1);
+    const float slice = log2(max(viewDepth, 1e-6)) * grid.depthScale + grid.depthBias;
+    const uint z = uint(clamp(slice, 0.0, float(grid.clusterCountZ - 1)));
+    return (z * grid.clusterCountY + y) * grid.clusterCountX + x;
+}
+
+uint ClusterLightCount(StructuredBuffer<uint> clusters, ClusterGrid grid, uint cluster)
+{
+    return clusters[cluster * (grid.maxLightsPerCluster + 1)];
+}
+
+// The index in the lights of the cluster's ith light
+uint ClusterLight(StructuredBuffer<uint> clusters, ClusterGrid grid, uint cluster, uint i)
+{
+    return clusters[cluster * (grid.maxLightsPerCluster + 1) + 1 + i];
+}
+
+struct LightSample
+{
+    float3 direction; // From the point to the light, normalized
+    float3 radiance;  // Arriving at the point
+};
+
+// KHR_lights_punctual's falloffs: the inverse square windowed to nothing at the range, and a
+// spot's smoothed between its cones
+LightSample SamplePunctualLight(PunctualLight light, float3 position)
+{
+    LightSample result;
+    if (light.type == kDirectionalLight)
+    {
+        result.direction = -light.direction;
+        result.radiance = light.color;
+        return result;
+    }
+
+    const float3 toLight = light.position - position;
+    const float distanceSquared = max(dot(toLight, toLight), 1e-8);
+    result.direction = toLight * rsqrt(distanceSquared);
+
+    float attenuation = 1.0 / distanceSquared;
+    if (light.range > 0)
+    {
+        const float ratioSquared = distanceSquared / (light.range * light.range);
+        attenuation *= saturate(1.0 - ratioSquared * ratioSquared);
+    }
+    if (light.type == kSpotLight)
+    {
+        const float scale = 1.0 / max(light.innerConeCos - light.outerConeCos, 0.001);
+        const float angular =
+            saturate((dot(light.direction, -result.direction) - light.outerConeCos) * scale);
+        attenuation *= angular * angular;
+    }
+    result.radiance = light.color * attenuation;
+    return result;
+}
+)";
+
+float GaUpscaleRatio(gaUpscaleQuality quality)
+{
+    switch (quality)
+    {
+    case gaUpscaleQuality::Quality:
+        return 1.5f;
+    case gaUpscaleQuality::Balanced:
+        return 1.7f;
+    case gaUpscaleQuality::Performance:
+        return 2.0f;
+    case gaUpscaleQuality::UltraPerformance:
+        return 3.0f;
+    default:
+        return 1.0f;
+    }
+}
+
+static Result<gaUpscaler*> CreateBackendUpscaler(const gaUpscalerCreateInfo& createInfo)
+{
+    switch (createInfo.device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullUpscaler(createInfo);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12Upscaler(createInfo);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanUpscaler(createInfo);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+Result<gaUpscaler*> GaCreateUpscaler(const gaUpscalerCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.outputWidth == 0 || createInfo.outputHeight == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Upscaler output size must not be zero"};
+    }
+
+    if (createInfo.quality > gaUpscaleQuality::UltraPerformance)
+    {
+        return {ErrorCategory::InvalidArgument, "Unknown upscale quality"};
+    }
+
+    // None of the vendors' SDKs are part of the build yet
+    switch (createInfo.type)
+    {
+    case gaUpscalerType::Temporal:
+        break;
+    case gaUpscalerType::Fsr:
+        return {ErrorCategory::NotFound, "FSR is not available, the build has no FidelityFX SDK"};
+    case gaUpscalerType::Dlss:
+        return {ErrorCategory::NotFound, "DLSS is not available, the build has no Streamline SDK"};
+    case gaUpscalerType::Xess:
+        return {ErrorCategory::NotFound, "XeSS is not available, the build has no XeSS SDK"};
+    default:
+        return {ErrorCategory::InvalidArgument, "Unknown upscaler type"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    Result<gaUpscaler*> upscaler = CreateBackendUpscaler(createInfo);
+    if (!upscaler)
+    {
+        return upscaler;
+    }
+
+    // Render sizes round down, as the vendors' do. The jitter needs 8 phases per render pixel
+    // an output pixel has, for the samples to land near each of them.
+    const float ratio = GaUpscaleRatio(createInfo.quality);
+    gaUpscaler* created = upscaler.Value();
+    created->type = createInfo.type;
+    created->outputWidth = createInfo.outputWidth;
+    created->outputHeight = createInfo.outputHeight;
+    created->renderWidth = static_cast<uint32>(float(createInfo.outputWidth) / ratio);
+    created->renderHeight = static_cast<uint32>(float(createInfo.outputHeight) / ratio);
+    created->renderWidth = created->renderWidth > 0 ? created->renderWidth : 1;
+    created->renderHeight = created->renderHeight > 0 ? created->renderHeight : 1;
+    const float scale = float(created->outputWidth) / float(created->renderWidth);
+    created->jitterPhaseCount = static_cast<uint32>(ceilf(8.0f * scale * scale));
+    created->mipBias = log2f(float(created->renderWidth) / float(created->outputWidth)) - 1.0f;
+    return created;
+}
+
+void GaDestroyUpscaler(gaUpscaler* upscaler)
+{
+    if (upscaler == nullptr)
+    {
+        return;
+    }
+
+    // Virtual destructor will call the appropriate backend-specific destructor
+    delete upscaler;
+}
+
+// Radical inverse of index in base
+static float Halton(uint32 index, uint32 base)
+{
+    float result = 0.0f;
+    float fraction = 1.0f;
+    while (index > 0)
+    {
+        fraction /= float(base);
+        result += fraction * float(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+void GaUpscalerJitter(const gaUpscaler* upscaler, uint64 frame, float jitter[2])
+{
+    // Index 0 is the corner of both sequences, so they start from 1
+    const uint32 phases = upscaler != nullptr && upscaler->jitterPhaseCount > 0
+                              ? upscaler->jitterPhaseCount
+                              : 1;
+    const uint32 index = static_cast<uint32>(frame % phases) + 1;
+    jitter[0] = Halton(index, 2) - 0.5f;
+    jitter[1] = Halton(index, 3) - 0.5f;
+}
+
+Result<> GaDispatchUpscale(gaUpscaler* upscaler, const gaUpscaleInputs& inputs)
+{
+    if (upscaler == nullptr)
+    {
+        return "Upscaler cannot be null";
+    }
+
+    if (inputs.color == nullptr || inputs.depth == nullptr || inputs.motionVectors == nullptr ||
+        inputs.output == nullptr)
+    {
+        return {ErrorCategory::InvalidArgument, "Upscale inputs cannot be null"};
+    }
+
+    // Also false for NaN
+    if (!(inputs.jitter[0] >= -0.5f && inputs.jitter[0] <= 0.5f) ||
+        !(inputs.jitter[1] >= -0.5f && inputs.jitter[1] <= 0.5f))
+    {
+        return {ErrorCategory::InvalidArgument, "Upscale jitter must be within half a pixel"};
+    }
+
+    switch (upscaler->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::DispatchDX12Upscale(upscaler, inputs);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+uint32 GaMipCount(uint32 width, uint32 height)
+{
+    uint32 count = 1;
+    for (uint32 size = width > height ? width : height; size > 1; size /= 2)
+    {
+        ++count;
+    }
+    return count;
+}
+
+Result<gaMipGenerationPass*> GaCreateMipGenerationPass(
+    const gaMipGenerationPassCreateInfo& createInfo)
+{
+    if (createInfo.device == nullptr)
+    {
+        return "Device cannot be null";
+    }
+
+    if (createInfo.maxWidth == 0 || createInfo.maxHeight == 0 ||
+        GaMipCount(createInfo.maxWidth, createInfo.maxHeight) > kGaMaxGeneratedMips)
+    {
+        return {ErrorCategory::InvalidArgument, "Mip generation pass size is out of range"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    switch (createInfo.device->backend)
+    {
+    case gaBackend::Null:
+        return backend::CreateNullMipGenerationPass(createInfo);
+
+    case gaBackend::DX12:
+        return backend::CreateDX12MipGenerationPass(createInfo);
+
+    case gaBackend::Vulkan:
+        return backend::CreateVulkanMipGenerationPass(createInfo);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+void GaDestroyMipGenerationPass(gaMipGenerationPass* pass)
+{
+    if (pass == nullptr)
+    {
+        return;
+    }
+
+    // Virtual destructor will call the appropriate backend-specific destructor
+    delete pass;
+}
+
+Result<> GaGenerateMips(gaMipGenerationPass* pass, const gaMipGenerationTarget& target)
+{
+    if (pass == nullptr)
+    {
+        return "Mip generation pass cannot be null";
+    }
+
+    if (target.texture == nullptr)
+    {
+        return {ErrorCategory::InvalidArgument, "Mip generation texture cannot be null"};
+    }
+
+    if (target.width == 0 || target.height == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Texture size must not be zero"};
+    }
+
+    if (target.width > pass->maxWidth || target.height > pass->maxHeight)
+    {
+        return {ErrorCategory::InvalidArgument, "Texture is larger than the mip generation pass"};
+    }
+
+    if (target.mipCount == 0 || target.mipCount > GaMipCount(target.width, target.height))
+    {
+        return {ErrorCategory::InvalidArgument, "Texture mip count is out of range"};
+    }
+
+    // What typed unordered access can store on every device
+    switch (target.format)
+    {
+    case gaFormat::R8G8B8A8Unorm:
+    case gaFormat::R8G8B8A8Srgb:
+    case gaFormat::R10G10B10A2Unorm:
+    case gaFormat::R11G11B10Float:
+    case gaFormat::R16G16Float:
+    case gaFormat::R16G16B16A16Float:
+    case gaFormat::R16G16B16A16Unorm:
+    case gaFormat::R32Float:
+    case gaFormat::R32G32Float:
+    case gaFormat::R32G32B32A32Float:
+        break;
+    default:
+        return {ErrorCategory::InvalidArgument, "Mips can't be generated for the texture's format"};
+    }
+
+    if (target.mipCount == 1)
+    {
+        return ResultCode::Success;
+    }
+
+    switch (pass->backend)
+    {
+    case gaBackend::Null:
+        return ResultCode::Success;
+
+    case gaBackend::DX12:
+        return backend::GenerateDX12Mips(pass, target);
+
+    default:
+        return "Unknown graphics backend";
+    }
+}
+
+static_assert(kGaMeshletCullingGroupSize == 32, "The shader's numthreads and payload are 32");
+
+// A submesh's meshlets, kGaMeshletCullingGroupSize to a group. Both tests are the ones
+// rsbl-asset runs on the CPU, IsMeshletBackfacing's included.
+const char kGaMeshletCullingShader[] = R"(
+struct Meshlet // CookedMeshlet
+{
+    uint vertexOffset;
+    uint triangleOffset;
+    uint vertexCount;
+    uint triangleCount;
+    float4 sphere; // Center, radius
+    float4 cone;   // Axis, cutoff
+};
+
+struct CullConstants // gaMeshletCullConstants
+{
+    float4 frustum[6];
+    float3 cameraPosition;
+    uint meshlets;
+    uint firstMeshlet;
+    uint meshletCount;
+    uint2 user;
+};
+
+struct Payload
+{
+    uint meshlets[32];
+};
+
+[[vk::push_constant]] ConstantBuffer<CullConstants> constants : register(b0);
+
+groupshared Payload payload;
+groupshared uint survivors;
+
+bool Visible(Meshlet meshlet)
+{
+    // Planes through a scaled world matrix are scaled with it, and so is the radius against them
+    const float3 center = meshlet.sphere.xyz;
+    const float radius = meshlet.sphere.w;
+    [unroll] for (uint i = 0; i < 6; ++i)
+    {
+        const float4 plane = constants.frustum[i];
+        if (dot(plane.xyz, center) + plane.w < -radius * length(plane.xyz))
+        {
+            return false;
+        }
+    }
+
+    // Whether any triangle can face the camera. A cutoff of 1 never culls.
+    const float3 toCenter = center - constants.cameraPosition;
+    return dot(toCenter, meshlet.cone.xyz) < meshlet.cone.w * length(toCenter) + radius;
+}
+
+[numthreads(32, 1, 1)]
+void main(uint thread : SV_GroupIndex, uint group : SV_GroupID)
+{
+    if (thread == 0)
+    {
+        survivors = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint index = group * 32 + thread;
+    if (index < constants.meshletCount)
+    {
+        const uint meshlet = constants.firstMeshlet + index;
+        StructuredBuffer<Meshlet> meshlets = ResourceDescriptorHeap[constants.meshlets];
+        if (Visible(meshlets[meshlet]))
+        {
+            uint slot;
+            InterlockedAdd(survivors, 1, slot);
+            payload.meshlets[slot] = meshlet;
+        }
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    DispatchMesh(survivors, 1, 1, payload);
+}
+)";
+
+static_assert(kGaShadingRateGroupSize == 8, "The shader's numthreads and loops step by 8");
+
+const char kGaShadingRateShader[] = R"(
+struct RateConstants // gaShadingRateConstants
+{
+    uint color;
+    uint velocity;
+    uint rates;
+    uint width;
+    uint height;
+    uint tileSize;
+    uint maxRate;
+    float threshold;
+    float velocityScale;
+};
+
+[[vk::push_constant]] ConstantBuffer<RateConstants> constants : register(b0);
+
+// Non-negative floats order the same as their bits
+groupshared uint maxDx;
+groupshared uint maxDy;
+groupshared uint maxSpeed;
+
+float Luma(Texture2D<float4> color, uint2 pixel)
+{
+    return dot(color.Load(int3(pixel, 0)).rgb, float3(0.2126, 0.7152, 0.0722));
+}
+
+// 1, 2 or 4 pixels shaded as one along a direction, by the largest difference along it
+uint Rate(float difference, float threshold)
+{
+    if (difference < threshold * 0.25 && constants.maxRate >= 4)
+    {
+        return 4;
+    }
+    return difference < threshold ? 2 : 1;
+}
+
+[numthreads(8, 8, 1)]
+void main(uint2 thread : SV_GroupThreadID, uint2 tile : SV_GroupID)
+{
+    if (all(thread == 0))
+    {
+        maxDx = 0;
+        maxDy = 0;
+        maxSpeed = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    Texture2D<float4> color = ResourceDescriptorHeap[constants.color];
+    float dx = 0;
+    float dy = 0;
+    float speed = 0;
+    for (uint y = thread.y; y < constants.tileSize; y += 8)
+    {
+        for (uint x = thread.x; x < constants.tileSize; x += 8)
+        {
+            const uint2 pixel = tile * constants.tileSize + uint2(x, y);
+            if (pixel.x >= constants.width || pixel.y >= constants.height)
+            {
+                continue;
+            }
+
+            const float luma = Luma(color, pixel);
+            if (pixel.x + 1 < constants.width)
+            {
+                dx = max(dx, abs(Luma(color, pixel + uint2(1, 0)) - luma));
+            }
+            if (pixel.y + 1 < constants.height)
+            {
+                dy = max(dy, abs(Luma(color, pixel + uint2(0, 1)) - luma));
+            }
+            if (constants.velocity != ~0u)
+            {
+                Texture2D<float2> velocity = ResourceDescriptorHeap[constants.velocity];
+                speed = max(speed, length(velocity.Load(int3(pixel, 0))));
+            }
+        }
+    }
+    InterlockedMax(maxDx, asuint(dx));
+    InterlockedMax(maxDy, asuint(dy));
+    InterlockedMax(maxSpeed, asuint(speed));
+    GroupMemoryBarrierWithGroupSync();
+
+    if (all(thread == 0))
+    {
+        const float threshold =
+            constants.threshold * (1 + asfloat(maxSpeed) * constants.velocityScale);
+        uint width = Rate(asfloat(maxDx), threshold);
+        uint height = Rate(asfloat(maxDy), threshold);
+
+        // There's no 4x1 or 1x4
+        if (width == 4 && height == 1)
+        {
+            width = 2;
+        }
+        if (height == 4 && width == 1)
+        {
+            height = 2;
+        }
+
+        RWTexture2D<uint> rates = ResourceDescriptorHeap[constants.rates];
+        rates[tile] = (firstbitlow(width) << 2) | firstbitlow(height);
+    }
+}
+)";
+
 } // namespace rsbl
@@ -0,0 +1,119 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-job-graph.h"
+#include "rsbl-jobs.h"
+
+#include <rsbl-array-view.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-result.h>
+#include <rsbl-string.h>
+
+// Start-up as steps that say which others they need, run on the job system so that everything
+// independent overlaps and a cold start takes as long as its slowest chain of steps, not all of
+// them end to end. A step that fails skips everything that needs it, and Run reports the first
+// failure. The timeline of the run says what each step took and which chain bounded it:
+//
+//     Bootstrap startup;
+//     const uint32 device = startup.AddStep("device", [&]() { return CreateDevice(); });
+//     const uint32 window = startup.AddStep("window", [&]() { return CreateWindow(); });
+//     const uint32 swapchain = startup.AddStep("swapchain", [&]() { return CreateSwapchain(); });
+//     startup.AddDependency(device, swapchain);
+//     startup.AddDependency(window, swapchain);
+//     Result<> started = startup.Run(*jobs);
+//
+// While the job system is tracing, every step is a region on the track of the thread it ran on.
+
+namespace rsbl
+{
+
+// Fails the start-up, with text that's kept even though it was set on a worker thread
+using BootstrapStepFunction = PooledFunction<Result<>(), 48>;
+
+enum class BootstrapStepStatus : uint8
+{
+    NotRun,
+    Succeeded,
+    Failed,
+    // Something it needed failed or was skipped
+    Skipped,
+};
+
+struct BootstrapStep
+{
+    const char* name = nullptr;
+    BootstrapStepStatus status = BootstrapStepStatus::NotRun;
+    // From the start of Run, both when it was skipped
+    uint64 startNs = 0;
+    uint64 endNs = 0;
+};
+
+class Bootstrap
+{
+  public:
+    Bootstrap() = default;
+
+    // Running steps point into it, it can't move
+    Bootstrap(Bootstrap&&) = delete;
+    Bootstrap& operator=(Bootstrap&&) = delete;
+    Bootstrap(const Bootstrap&) = delete;
+    Bootstrap& operator=(const Bootstrap&) = delete;
+
+    // Returns the step's index, for AddDependency. name has to outlive the bootstrap and any job
+    // trace capture, string literals do. Start-up is what everything waits on, so steps run at
+    // high priority unless told otherwise.
+    uint32 AddStep(const char* name,
+                   BootstrapStepFunction&& step,
+                   JobPriority priority = JobPriority::High);
+
+    // before succeeds before after starts
+    void AddDependency(uint32 before, uint32 after);
+
+    // Runs every step once and waits for them, the calling thread running steps too meanwhile.
+    // Fails if the dependencies make a cycle, or with the first step (by index) that failed.
+    Result<> Run(JobSystem& jobs);
+
+    // Every step as of the end of Run, in the order they were added
+    ArrayView<const BootstrapStep> Steps() const
+    {
+        return ArrayView<const BootstrapStep>(m_steps.Data(), m_steps.Size());
+    }
+
+    // How long Run took
+    uint64 TotalNs() const
+    {
+        return m_totalNs;
+    }
+    // The chain of steps, each needing the one before, that took longest end to end
+    uint64 CriticalPathNs() const;
+
+    // A line for the run as a whole and its slowest chain, then one per step, in order of when
+    // they started
+    void BuildTimeline(String& text) const;
+
+  private:
+    // Runs the step unless something it needs didn't succeed
+    void RunStep(uint32 step);
+    // The longest chain ending at each step, and the step before it on the chain (~0u for none)
+    void LongestChains(DynamicArray<uint64>& chainNs, DynamicArray<uint32>& previous) const;
+
+    DynamicArray<BootstrapStep> m_steps{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<BootstrapStepFunction> m_functions{GetTaggedAllocator(MemoryTag::Jobs)};
+    // Why each step failed, copied off the thread that ran it
+    DynamicArray<String> m_failures{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<ErrorCategory> m_categories{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<JobPriority> m_priorities{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<uint32> m_edgeBefore{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<uint32> m_edgeAfter{GetTaggedAllocator(MemoryTag::Jobs)};
+
+    JobSystem* m_jobs = nullptr;
+    uint64 m_startTicks = 0;
+    uint64 m_totalNs = 0;
+};
+
+} // namespace rsbl
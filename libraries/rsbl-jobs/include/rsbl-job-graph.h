@@ -0,0 +1,91 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-jobs.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-result.h>
+
+#include <atomic>
+
+// Static task graph, for work with the same shape every frame. The tasks and the dependencies
+// between them are set up once, and Build lays the edges out flat. Every Run after that resets a
+// count per task and submits the tasks with no dependencies. A task finishing submits each
+// successor it was the last dependency of, so stages overlap wherever the edges allow, with no
+// barrier between them and nothing blocked but the caller's Wait.
+//
+//     JobGraph frame;
+//     const uint32 cull = frame.AddTask([&]() { Cull(scene, view); });
+//     const uint32 shadows = frame.AddTask([&]() { RecordShadows(scene); });
+//     const uint32 mainPass = frame.AddTask([&]() { RecordMain(view); });
+//     frame.AddDependency(cull, mainPass);
+//     frame.Build();
+//
+//     // Every frame
+//     JobCounter done;
+//     frame.Run(*jobs, done);
+//     jobs->Wait(done);
+
+namespace rsbl
+{
+
+class JobGraph
+{
+  public:
+    JobGraph() = default;
+    ~JobGraph();
+
+    // Running jobs point into the graph, it can't move
+    JobGraph(JobGraph&&) = delete;
+    JobGraph& operator=(JobGraph&&) = delete;
+    JobGraph(const JobGraph&) = delete;
+    JobGraph& operator=(const JobGraph&) = delete;
+
+    // Returns the task's index, for AddDependency. The task runs once per Run.
+    uint32 AddTask(Job&& task, JobPriority priority = JobPriority::Medium);
+
+    // before finishes before after starts
+    void AddDependency(uint32 before, uint32 after);
+
+    // Fails if the dependencies make a cycle. The graph can't change after this.
+    Result<> Build();
+
+    // Submits the graph, counter gets to zero once every task has run. A graph only runs once at
+    // a time, the last Run's counter must be zero before the next.
+    void Run(JobSystem& jobs, JobCounter& counter);
+
+    uint32 TaskCount() const
+    {
+        return static_cast<uint32>(m_tasks.Size());
+    }
+
+  private:
+    void RunTask(uint32 task);
+
+    DynamicArray<Job> m_tasks{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<JobPriority> m_priorities{GetTaggedAllocator(MemoryTag::Jobs)};
+
+    // Edges as added, then flattened by Build into each task's successors, at
+    // m_successors[m_successorStart[task]] up to m_successorStart[task + 1]
+    DynamicArray<uint32> m_edgeBefore{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<uint32> m_edgeAfter{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<uint32> m_successorStart{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<uint32> m_successors{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<uint32> m_dependencyCounts{GetTaggedAllocator(MemoryTag::Jobs)};
+    DynamicArray<uint32> m_roots{GetTaggedAllocator(MemoryTag::Jobs)};
+
+    // Dependencies each task is still waiting on during a Run
+    std::atomic<uint32>* m_remaining = nullptr;
+
+    // Set by Run for the tasks to submit their successors with
+    JobSystem* m_jobs = nullptr;
+    JobCounter* m_counter = nullptr;
+
+    bool m_built = false;
+};
+
+} // namespace rsbl
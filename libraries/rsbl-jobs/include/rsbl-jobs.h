@@ -0,0 +1,292 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-assert.h>
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+
+#include <atomic>
+
+// Work-stealing job system. Each worker thread owns a Chase-Lev deque: jobs a worker submits go
+// to the bottom of its own deque, and it pops from there newest first, while idle workers steal
+// the oldest jobs from the top of someone else's. Jobs submitted from outside the workers go
+// through one shared queue that every worker drains. There's a deque and a shared queue per
+// priority, and every look for work goes through them most urgent first.
+//
+//     JobCounter counter;
+//     for (Asset& asset : assets)
+//     {
+//         jobs->Submit([&asset]() { asset.Decode(); }, &counter);
+//     }
+//     jobs->Wait(counter); // Runs jobs itself until every decode is done
+//
+// Jobs don't return anything, and can't fail. They write their results somewhere the submitter
+// reads after the wait, or hand them on to a continuation:
+//
+//     JobCounter decoded;
+//     ... submit the decodes with &decoded ...
+//     jobs->SubmitAfter(decoded, [&]() { UploadAll(assets); }, &uploaded);
+//
+// For work with the same shape every frame, JobGraph (rsbl-job-graph.h) builds the dependencies
+// once and replays them. Chains that wait on IO along the way are easier to write as coroutines,
+// see Task and Future (rsbl-task.h).
+
+namespace rsbl
+{
+
+class String;
+
+namespace Internal
+{
+    struct QueuedJob;
+} // namespace Internal
+
+// Jobs are picked most urgent first. A running job is never interrupted, but a worker that's
+// done with one always takes the highest priority job it can find next, so frame work gets
+// ahead of background work within a job's length.
+enum class JobPriority : uint8
+{
+    // Frame critical: culling, command recording
+    High,
+    Medium,
+    // Background: texture decode, shader compiles, streaming
+    Low,
+
+    Count,
+};
+
+// A job is a move-only callable. Captures that don't fit the inline buffer spill into the
+// Function pools, so big captures don't hit the heap either. Every job runs in a ScratchScope
+// (rsbl-thread-local.h), scratch memory it allocates is handed back when it returns.
+using Job = PooledFunction<void(), 48>;
+
+// Counts unfinished jobs. Submitting a job with a counter adds one, the job finishing takes it
+// back off, and Wait returns once it's down to zero. Jobs queued with SubmitAfter wait on the
+// counter without anything blocking, they're queued by whichever job takes it to zero.
+// A counter can be reused once it's zero, and freed as soon as Wait returns.
+class JobCounter
+{
+  public:
+    JobCounter() = default;
+
+    // Jobs point at the counter, it can't move
+    JobCounter(JobCounter&&) = delete;
+    JobCounter& operator=(JobCounter&&) = delete;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const
+    {
+        return m_pending.load(std::memory_order_acquire) == 0;
+    }
+
+    // Only a snapshot, jobs can be finishing as this returns
+    uint32 PendingApprox() const
+    {
+        return m_pending.load(std::memory_order_relaxed);
+    }
+
+  private:
+    friend class JobSystem;
+
+    std::atomic<uint32> m_pending{0};
+
+    // Jobs to queue when m_pending gets to zero, an intrusive stack
+    std::atomic<Internal::QueuedJob*> m_continuations{nullptr};
+};
+
+struct JobSystemOptions
+{
+    // Worker threads. 0 means one per physical core, minus one for the thread that runs the
+    // frame and helps out in Wait. SMT siblings share a core's execution units, so workers on
+    // both mostly just contend for them.
+    uint32 workerCount = 0;
+
+    // Pins each worker to its own physical core, leaving the first core to the frame thread.
+    // Pinned workers try to steal from workers sharing their L3 first, then from workers on
+    // their NUMA node, then the others, which keeps stolen work on warm caches and near memory
+    // on CPUs with several L3s (multi-CCD, multi-socket).
+    bool pinWorkers = false;
+
+    // With pinned workers on several NUMA nodes, puts each worker's deques and scratch arena in
+    // its own node's memory rather than wherever the thread creating the system first touched.
+    bool numaLocalMemory = true;
+
+    // Jobs each worker's deque holds, and the jobs the shared queue holds. When one is full,
+    // Submit runs the job right away instead of queueing it.
+    uint32 queueCapacity = 4096;
+
+    // Workers that only ever run high priority jobs, so frame work always finds a thread free no
+    // matter how much background work is queued. Has to leave at least one worker for the rest.
+    uint32 highPriorityWorkers = 0;
+
+    // Runs jobs on fibers. A job that waits on a counter then parks, and its worker goes on to
+    // other jobs on another fiber, rather than running them on top of the waiting job's stack.
+    // The parked job carries on once the counter gets to zero, on whichever worker is free.
+    bool useFibers = false;
+
+    // Fibers in the pool, at least one per worker. Every parked job holds one, and once they're
+    // all taken, waits go back to running jobs in place.
+    uint32 fiberCount = 128;
+
+    // Jobs on fibers run on stacks this big, rather than the worker thread's
+    uint64 fiberStackSize = 64 * 1024;
+
+    // Events each worker's trace ring holds, for StartTrace. 0 leaves tracing out, and costs
+    // nothing. Rings overwrite their oldest events, so this bounds the memory, not how long a
+    // capture can run: a long one keeps its most recent stretch.
+    uint32 traceEventsPerWorker = 0;
+};
+
+class JobSystem
+{
+  public:
+    // Starts the workers. Fails if highPriorityWorkers doesn't leave a worker for the rest, or
+    // there are fewer fibers than workers.
+    static Result<UniquePtr<JobSystem>> Create(const JobSystemOptions& options = {});
+
+    // Stops and joins the workers. Every submitted job must have been waited on by then.
+    ~JobSystem();
+
+    // Workers hold on to the system, it can't move
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Queues a job, from any thread, jobs included. The counter (optional) must stay alive until
+    // it's been waited on.
+    void Submit(Job&& job,
+                JobCounter* counter = nullptr,
+                JobPriority priority = JobPriority::Medium);
+
+    // Queues a job once dependency gets to zero, right away if it's zero already. The job counts
+    // against counter (optional) from now, so waiting on counter covers it. Jobs added to
+    // dependency while it's still above zero hold the continuation back too.
+    void SubmitAfter(JobCounter& dependency,
+                     Job&& job,
+                     JobCounter* counter = nullptr,
+                     JobPriority priority = JobPriority::Medium);
+
+    // Runs queued jobs until the counter is zero, then returns. Call it from any thread, jobs
+    // included, a job waiting on its children keeps its worker busy rather than blocking it.
+    // High priority workers only help with high priority jobs here too. With fibers, a job parks
+    // instead and may carry on on another worker, so it mustn't hold thread-bound state (locks,
+    // thread_local pointers) across the wait.
+    void Wait(JobCounter& counter);
+
+    // Runs body(chunkBegin, chunkEnd) over [begin, end) in chunks of up to grain indices, and
+    // waits for all of them. The range is split lazily: the caller works through it a chunk at a
+    // time, and only hands off half of what's left when its queue is empty, meaning idle workers
+    // have taken everything else. A loop that fits in one grain never makes a job, and a big one
+    // splits about as often as there are thieves to take the halves.
+    void ParallelFor(uint64 begin,
+                     uint64 end,
+                     uint64 grain,
+                     FunctionRef<void(uint64, uint64)> body,
+                     JobPriority priority = JobPriority::Medium);
+
+    // ParallelFor that folds the chunks into one value. body(chunkBegin, chunkEnd) returns a T,
+    // and combine(T, T) has to be associative with identity as its identity. Chunks are combined
+    // in index order, so combine doesn't have to commute.
+    //
+    //     const float total = jobs->ParallelReduce(0, count, 1024, 0.0f,
+    //         [&](uint64 begin, uint64 end) { return Sum(weights + begin, end - begin); },
+    //         [](float a, float b) { return a + b; });
+    template <typename T, typename BodyType, typename CombineType>
+    T ParallelReduce(uint64 begin,
+                     uint64 end,
+                     uint64 grain,
+                     const T& identity,
+                     const BodyType& body,
+                     const CombineType& combine,
+                     JobPriority priority = JobPriority::Medium);
+
+    uint32 WorkerCount() const;
+
+    // Keeps only the first limit workers that take any job running, the rest sleep between jobs
+    // until the limit takes them back. For holding back on battery or while the CPU runs hot
+    // (see PowerMonitor). Clamped to at least one, and no more than there are; high priority
+    // workers are never held back. Takes effect as each worker finishes its current job.
+    void SetActiveWorkerLimit(uint32 limit);
+    // How many of the workers that take any job are running, all of them unless limited
+    uint32 ActiveWorkerLimit() const;
+
+    // Starts recording job runs, waits, sleeps, steals and fiber switches into the trace rings,
+    // from every thread. Fails if the system was created without them (traceEventsPerWorker).
+    // Until a capture is started, recording is a relaxed load per event.
+    Result<> StartTrace();
+    void StopTrace();
+
+    // What the calling thread is doing besides running jobs, on its track in the capture: a
+    // named slice from startTicks (Clock::NowTicks) to now, and a named value drawn as a graph
+    // over time. name has to outlive the capture, string literals do. Outside a capture these
+    // are a relaxed load.
+    void TraceRegion(const char* name, uint64 startTicks);
+    void TraceCounter(const char* name, uint64 value);
+
+    // A slice of GPU work on a track of its own, from any thread. The ticks are the CPU's clock,
+    // as rsbl-ga's GPU zones read back, and usually from frames before the one being recorded.
+    void TraceGpuZone(const char* name, uint64 startTicks, uint64 endTicks);
+
+    // The capture so far as Chrome trace event JSON, one track per worker plus one per outside
+    // thread that ran or waited on jobs, and one for the GPU. Opens in chrome://tracing and
+    // ui.perfetto.dev.
+    void BuildChromeTrace(String& json) const;
+    Result<> WriteChromeTrace(const char* path) const;
+
+  private:
+    struct State;
+
+    JobSystem() = default;
+
+    // True when the calling thread has nothing queued at this priority for thieves to take, so
+    // a parallel loop should hand some of its range off
+    bool ShouldSplit(JobPriority priority) const;
+
+    State* m_state = nullptr;
+};
+
+template <typename T, typename BodyType, typename CombineType>
+T JobSystem::ParallelReduce(uint64 begin,
+                            uint64 end,
+                            uint64 grain,
+                            const T& identity,
+                            const BodyType& body,
+                            const CombineType& combine,
+                            JobPriority priority)
+{
+    rsblAssert(grain > 0);
+
+    T result = identity;
+    while (begin < end)
+    {
+        if (end - begin > grain && ShouldSplit(priority))
+        {
+            // Someone takes the upper half while this thread carries on with the lower one
+            const uint64 middle = begin + (end - begin) / 2;
+            T upper = identity;
+            JobCounter counter;
+            Submit(
+                [&]() {
+                    upper = ParallelReduce(middle, end, grain, identity, body, combine, priority);
+                },
+                &counter,
+                priority);
+            const T lower = ParallelReduce(begin, middle, grain, identity, body, combine, priority);
+            Wait(counter);
+            return combine(combine(result, lower), upper);
+        }
+
+        const uint64 chunk_end = end - begin > grain ? begin + grain : end;
+        result = combine(result, body(begin, chunk_end));
+        begin = chunk_end;
+    }
+    return result;
+}
+
+} // namespace rsbl
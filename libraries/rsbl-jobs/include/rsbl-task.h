@@ -0,0 +1,566 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-assert.h>
+#include <rsbl-int-types.h>
+#include <rsbl-jobs.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-result.h>
+#include <rsbl-thread-pool.h>
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+
+// Coroutines on top of the job system. A Task<T> is a coroutine that co_returns a Result<T>, and
+// a Future<T> is a Result<T> that somebody else fills in later. Both can be co_awaited from a
+// task. Awaiting a Future suspends the task without holding a thread, and whoever fills the
+// future in queues the task back onto the job system:
+//
+//     Task<Texture> LoadTexture(JobSystem& jobs, ThreadPool& io, const char* path)
+//     {
+//         Result<uint64> read = co_await ReadFileAsync(io, path, staging);  // IO thread
+//         if (!read)
+//         {
+//             co_return read.FailureText();
+//         }
+//         Result<Texture> texture = co_await Decode(staging, read.Value());  // Job worker
+//         ...
+//     }
+//
+//     Future<Texture> texture = Spawn(jobs, LoadTexture(jobs, io, "brick.png"));
+//
+// Tasks start suspended. Spawn starts one on a job worker, co_await starts a child task on the
+// parent's thread and resumes the parent right when it's done. Nothing here throws, failures
+// travel in the Results, failure text included.
+
+namespace rsbl
+{
+
+template <typename T = Internal::DefaultReturnType>
+class Task;
+
+template <typename T = Internal::DefaultReturnType>
+class Future;
+
+template <typename T = Internal::DefaultReturnType>
+class Promise;
+
+template <typename T>
+Future<T> Spawn(JobSystem& jobs, Task<T>&& task, JobPriority priority = JobPriority::Medium);
+
+namespace Internal
+{
+    // How a suspended coroutine gets going again: queued on a job system when it came from a
+    // task, or resumed right there on the thread that woke it otherwise
+    struct Resumer
+    {
+        std::coroutine_handle<> handle;
+        JobSystem* jobs = nullptr;
+        JobPriority priority = JobPriority::Medium;
+
+        void Resume() const
+        {
+            if (jobs != nullptr)
+            {
+                jobs->Submit([handle = handle]() { handle.resume(); }, nullptr, priority);
+            }
+            else
+            {
+                handle.resume();
+            }
+        }
+
+        // Tasks carry their job system in the promise, other coroutines don't
+        template <typename PromiseType>
+        static Resumer For(std::coroutine_handle<PromiseType> handle)
+        {
+            Resumer resumer;
+            resumer.handle = handle;
+            if constexpr (requires { handle.promise().jobs; })
+            {
+                resumer.jobs = handle.promise().jobs;
+                resumer.priority = handle.promise().priority;
+            }
+            return resumer;
+        }
+    };
+
+    // Shared by a Promise and its Future, freed by whichever lets go last
+    template <typename T>
+    struct FutureState
+    {
+        static constexpr uint32 kMaxFailureTextLength = 256;
+
+        // Set in place of the waiter once the result is in, so a late waiter doesn't suspend
+        static inline Resumer* const kFulfilled = reinterpret_cast<Resumer*>(uintptr_t(1));
+
+        void Fulfil(Result<T>&& value)
+        {
+            // Failure text is thread local, it has to be copied for the thread that takes it
+            if (!value)
+            {
+                snprintf(failureText, sizeof(failureText), "%s", value.FailureText());
+            }
+            result = rsblMove(value);
+            ready.store(1, std::memory_order_release);
+            ready.notify_all();
+
+            Resumer* waiter = waiters.exchange(kFulfilled, std::memory_order_acq_rel);
+            if (waiter != nullptr)
+            {
+                waiter->Resume();
+            }
+        }
+
+        Result<T> Take()
+        {
+            if (result)
+            {
+                return rsblMove(result);
+            }
+            return Result<T>(result.Category(), failureText);
+        }
+
+        void Release()
+        {
+            if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                MemoryTagScope memory_scope(MemoryTag::Jobs);
+                delete this;
+            }
+        }
+
+        std::atomic<uint32> refs{2};
+        std::atomic<uint32> ready{0};
+        std::atomic<Resumer*> waiters{nullptr};
+        Result<T> result{ResultCode::Failure};
+        char failureText[kMaxFailureTextLength] = {};
+    };
+} // namespace Internal
+
+// The read side of an asynchronous Result. Move-only, and the result can be taken once, by Get
+// or by co_await.
+template <typename T>
+class Future
+{
+  public:
+    Future() = default;
+    ~Future()
+    {
+        if (m_state != nullptr)
+        {
+            m_state->Release();
+        }
+    }
+
+    Future(Future&& other)
+        : m_state(other.m_state)
+    {
+        other.m_state = nullptr;
+    }
+
+    Future& operator=(Future&& other)
+    {
+        if (this != &other)
+        {
+            if (m_state != nullptr)
+            {
+                m_state->Release();
+            }
+            m_state = other.m_state;
+            other.m_state = nullptr;
+        }
+        return *this;
+    }
+
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+
+    bool IsValid() const
+    {
+        return m_state != nullptr;
+    }
+
+    bool IsReady() const
+    {
+        return m_state->ready.load(std::memory_order_acquire) != 0;
+    }
+
+    // Blocks the calling thread until the result is in. Tasks co_await instead, and jobs
+    // shouldn't block on a future at all, the job that fills it in may be queued behind them.
+    Result<T> Get()
+    {
+        rsblAssert(IsValid());
+        m_state->ready.wait(0, std::memory_order_acquire);
+        return m_state->Take();
+    }
+
+    struct Awaiter
+    {
+        Internal::FutureState<T>* state;
+        Internal::Resumer resumer;
+
+        bool await_ready() const
+        {
+            return state->ready.load(std::memory_order_acquire) != 0;
+        }
+
+        // Registers the resumer, unless the result got in first and there's no need to suspend
+        // at all
+        template <typename PromiseType>
+        bool await_suspend(std::coroutine_handle<PromiseType> handle)
+        {
+            resumer = Internal::Resumer::For(handle);
+            Internal::Resumer* expected = nullptr;
+            return state->waiters.compare_exchange_strong(
+                expected, &resumer, std::memory_order_acq_rel, std::memory_order_acquire);
+        }
+
+        Result<T> await_resume()
+        {
+            return state->Take();
+        }
+    };
+
+    Awaiter operator co_await()
+    {
+        rsblAssert(IsValid());
+        return Awaiter{m_state, {}};
+    }
+
+  private:
+    friend class Promise<T>;
+
+    template <typename U>
+    friend Future<U> Spawn(JobSystem& jobs, Task<U>&& task, JobPriority priority);
+
+    explicit Future(Internal::FutureState<T>* state)
+        : m_state(state)
+    {
+    }
+
+    Internal::FutureState<T>* m_state = nullptr;
+};
+
+// The write side. SetResult once, from any thread. A promise dropped without a result fails
+// its future, so nobody waits forever.
+template <typename T>
+class Promise
+{
+  public:
+    Promise()
+    {
+        MemoryTagScope memory_scope(MemoryTag::Jobs);
+        m_state = new Internal::FutureState<T>();
+    }
+
+    ~Promise()
+    {
+        if (m_state != nullptr)
+        {
+            if (!m_fulfilled)
+            {
+                m_state->Fulfil(
+                    Result<T>(ErrorCategory::Generic, "Promise dropped without a result"));
+            }
+            m_state->Release();
+        }
+    }
+
+    Promise(Promise&& other)
+        : m_state(other.m_state)
+        , m_futureTaken(other.m_futureTaken)
+        , m_fulfilled(other.m_fulfilled)
+    {
+        other.m_state = nullptr;
+    }
+
+    Promise& operator=(Promise&&) = delete;
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+
+    // Only once
+    Future<T> GetFuture()
+    {
+        rsblAssertMsg(!m_futureTaken, "GetFuture called twice");
+        m_futureTaken = true;
+        return Future<T>(m_state);
+    }
+
+    void SetResult(Result<T>&& value)
+    {
+        rsblAssertMsg(!m_fulfilled, "SetResult called twice");
+        m_fulfilled = true;
+        m_state->Fulfil(rsblMove(value));
+    }
+
+  private:
+    Internal::FutureState<T>* m_state = nullptr;
+    bool m_futureTaken = false;
+    bool m_fulfilled = false;
+};
+
+// A coroutine that co_returns a Result<T>. Lazy: it does nothing until it's co_awaited or
+// handed to Spawn. Move-only, and dropping one that never started just frees it.
+template <typename T>
+class [[nodiscard]] Task
+{
+  public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        // Hands straight over to whoever awaited the task. A spawned task has nobody waiting in
+        // a coroutine, so its result goes to the future and the frame frees itself.
+        std::coroutine_handle<> await_suspend(Handle handle) noexcept
+        {
+            promise_type& promise = handle.promise();
+            if (promise.spawned != nullptr)
+            {
+                Internal::FutureState<T>* state = promise.spawned;
+                state->Fulfil(rsblMove(promise.result));
+                handle.destroy();
+                state->Release();
+                return std::noop_coroutine();
+            }
+            if (promise.continuation)
+            {
+                return promise.continuation;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    struct promise_type
+    {
+        // Frames are Jobs memory
+        static void* operator new(std::size_t size)
+        {
+            return GetTaggedAllocator(MemoryTag::Jobs)->Allocate(size, alignof(std::max_align_t));
+        }
+
+        static void operator delete(void* ptr, std::size_t size)
+        {
+            GetTaggedAllocator(MemoryTag::Jobs)->Free(ptr, size, alignof(std::max_align_t));
+        }
+
+        Task get_return_object()
+        {
+            return Task(Handle::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        // Plain values, failure text and FailureFormat all convert to the Result
+        void return_value(Result<T>&& value)
+        {
+            result = rsblMove(value);
+        }
+
+        void unhandled_exception()
+        {
+            rsblAssertMsg(false, "Tasks can't throw");
+        }
+
+        Result<T> result{ResultCode::Failure};
+        std::coroutine_handle<> continuation;
+
+        // Where the task resumes after waiting on a future, nullptr to resume on whichever
+        // thread fills the future in
+        JobSystem* jobs = nullptr;
+        JobPriority priority = JobPriority::Medium;
+
+        // Only for spawned tasks
+        Internal::FutureState<T>* spawned = nullptr;
+    };
+
+    Task() = default;
+    ~Task()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    Task(Task&& other)
+        : m_handle(other.m_handle)
+    {
+        other.m_handle = nullptr;
+    }
+
+    Task& operator=(Task&& other)
+    {
+        if (this != &other)
+        {
+            if (m_handle)
+            {
+                m_handle.destroy();
+            }
+            m_handle = other.m_handle;
+            other.m_handle = nullptr;
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool IsValid() const
+    {
+        return static_cast<bool>(m_handle);
+    }
+
+    // Runs the task until it's done or first suspends, then carries on in the awaiting task once
+    // it finishes. The child resumes on the parent's job system unless it was given its own.
+    struct Awaiter
+    {
+        Handle child;
+
+        bool await_ready() const
+        {
+            return false;
+        }
+
+        template <typename PromiseType>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<PromiseType> parent)
+        {
+            promise_type& promise = child.promise();
+            promise.continuation = parent;
+            if (promise.jobs == nullptr)
+            {
+                const Internal::Resumer resumer = Internal::Resumer::For(parent);
+                promise.jobs = resumer.jobs;
+                promise.priority = resumer.priority;
+            }
+            return child;
+        }
+
+        Result<T> await_resume()
+        {
+            return rsblMove(child.promise().result);
+        }
+    };
+
+    Awaiter operator co_await() &&
+    {
+        rsblAssert(IsValid());
+        return Awaiter{m_handle};
+    }
+
+  private:
+    template <typename U>
+    friend Future<U> Spawn(JobSystem& jobs, Task<U>&& task, JobPriority priority);
+
+    explicit Task(Handle handle)
+        : m_handle(handle)
+    {
+    }
+
+    Handle m_handle;
+};
+
+// Starts the task on a job worker. The task owns itself from here, its frame is freed once it's
+// done, and its result goes to the returned future.
+template <typename T>
+Future<T> Spawn(JobSystem& jobs, Task<T>&& task, JobPriority priority)
+{
+    rsblAssert(task.IsValid());
+
+    typename Task<T>::Handle handle = task.m_handle;
+    task.m_handle = nullptr;
+
+    // The task holds the promise side's reference, and fills the future in when it finishes
+    Internal::FutureState<T>* state = nullptr;
+    {
+        MemoryTagScope memory_scope(MemoryTag::Jobs);
+        state = new Internal::FutureState<T>();
+    }
+
+    typename Task<T>::promise_type& task_promise = handle.promise();
+    task_promise.jobs = &jobs;
+    task_promise.priority = priority;
+    task_promise.spawned = state;
+
+    jobs.Submit([handle]() { handle.resume(); }, nullptr, priority);
+    return Future<T>(state);
+}
+
+namespace Internal
+{
+    struct ScheduleAwaiter
+    {
+        JobSystem& jobs;
+        JobPriority priority;
+
+        bool await_ready() const
+        {
+            return false;
+        }
+
+        template <typename PromiseType>
+        void await_suspend(std::coroutine_handle<PromiseType> handle)
+        {
+            if constexpr (requires { handle.promise().jobs; })
+            {
+                handle.promise().jobs = &jobs;
+                handle.promise().priority = priority;
+            }
+            jobs.Submit([handle]() { handle.resume(); }, nullptr, priority);
+        }
+
+        void await_resume() const
+        {
+        }
+    };
+} // namespace Internal
+
+// co_await to move the rest of a coroutine onto a job worker. A task also keeps resuming on
+// that job system from then on.
+inline Internal::ScheduleAwaiter ScheduleOn(JobSystem& jobs,
+                                            JobPriority priority = JobPriority::Medium)
+{
+    return Internal::ScheduleAwaiter{jobs, priority};
+}
+
+// Runs func() on a pool thread, for blocking work a task shouldn't do on a job worker. func
+// returns a Result<T> (or anything that converts to one), which goes to the future.
+template <typename T, typename FuncType>
+Future<T> Async(ThreadPool& pool, FuncType&& func)
+{
+    Promise<T> promise;
+    Future<T> future = promise.GetFuture();
+    pool.Submit([promise = rsblMove(promise), func = rsblForward(func)]() mutable {
+        promise.SetResult(func());
+    });
+    return future;
+}
+
+// Reads the whole file into buffer on a pool thread, the future gets the bytes read. path and
+// buffer must stay alive until then.
+Future<uint64> ReadFileAsync(ThreadPool& pool, const char* path, MutableByteView buffer);
+
+} // namespace rsbl
@@ -0,0 +1,236 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-bootstrap.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-clock.h>
+
+#include <cstdio>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kNoStep = ~0u;
+
+double NsToMs(uint64 ns)
+{
+    return static_cast<double>(ns) / 1'000'000.0;
+}
+} // namespace
+
+uint32 Bootstrap::AddStep(const char* name, BootstrapStepFunction&& step, JobPriority priority)
+{
+    BootstrapStep& added = m_steps.EmplaceBack();
+    added.name = name;
+    m_functions.PushBack(rsblMove(step));
+    m_failures.EmplaceBack(GetTaggedAllocator(MemoryTag::Jobs));
+    m_categories.PushBack(ErrorCategory::None);
+    m_priorities.PushBack(priority);
+    return static_cast<uint32>(m_steps.Size() - 1);
+}
+
+void Bootstrap::AddDependency(uint32 before, uint32 after)
+{
+    rsblAssert(before < m_steps.Size() && after < m_steps.Size());
+    m_edgeBefore.PushBack(before);
+    m_edgeAfter.PushBack(after);
+}
+
+Result<> Bootstrap::Run(JobSystem& jobs)
+{
+    // A graph of its own every run, start-up only runs once
+    JobGraph graph;
+    const uint32 step_count = static_cast<uint32>(m_steps.Size());
+    for (uint32 step = 0; step < step_count; ++step)
+    {
+        graph.AddTask([this, step]() { RunStep(step); }, m_priorities[step]);
+        m_steps[step].status = BootstrapStepStatus::NotRun;
+        m_steps[step].startNs = 0;
+        m_steps[step].endNs = 0;
+    }
+    for (uint64 edge = 0; edge < m_edgeBefore.Size(); ++edge)
+    {
+        graph.AddDependency(m_edgeBefore[edge], m_edgeAfter[edge]);
+    }
+    if (Result<> built = graph.Build(); !built)
+    {
+        return PendingFailure{built.Category()};
+    }
+
+    m_jobs = &jobs;
+    m_startTicks = Clock::NowTicks();
+    JobCounter done;
+    graph.Run(jobs, done);
+    jobs.Wait(done);
+    m_totalNs = Clock::TicksToNs(Clock::NowTicks() - m_startTicks);
+
+    for (uint32 step = 0; step < step_count; ++step)
+    {
+        if (m_steps[step].status == BootstrapStepStatus::Failed)
+        {
+            char text[512];
+            snprintf(text, sizeof(text), "%s: %s", m_steps[step].name, m_failures[step].CStr());
+            return FailureCopy(m_categories[step], text);
+        }
+    }
+    return ResultCode::Success;
+}
+
+void Bootstrap::RunStep(uint32 step)
+{
+    BootstrapStep& record = m_steps[step];
+    const uint64 start = Clock::NowTicks();
+    record.startNs = Clock::TicksToNs(start - m_startTicks);
+
+    // Start-up is a handful of steps, a scan of the edges is all it takes. The graph only runs
+    // a step once everything before it is done, so their status is settled.
+    for (uint64 edge = 0; edge < m_edgeAfter.Size(); ++edge)
+    {
+        if (m_edgeAfter[edge] == step &&
+            m_steps[m_edgeBefore[edge]].status != BootstrapStepStatus::Succeeded)
+        {
+            record.status = BootstrapStepStatus::Skipped;
+            record.endNs = record.startNs;
+            return;
+        }
+    }
+
+    const Result<> result = m_functions[step]();
+    record.endNs = Clock::TicksToNs(Clock::NowTicks() - m_startTicks);
+    if (result)
+    {
+        record.status = BootstrapStepStatus::Succeeded;
+    }
+    else
+    {
+        // The text is this thread's, gone by the time Run looks
+        record.status = BootstrapStepStatus::Failed;
+        m_categories[step] = result.Category();
+        m_failures[step] = String(result.FailureText(), GetTaggedAllocator(MemoryTag::Jobs));
+    }
+    m_jobs->TraceRegion(record.name, start);
+}
+
+void Bootstrap::LongestChains(DynamicArray<uint64>& chainNs, DynamicArray<uint32>& previous) const
+{
+    const uint32 step_count = static_cast<uint32>(m_steps.Size());
+    chainNs.Resize(step_count);
+    previous.Resize(step_count);
+    for (uint32 step = 0; step < step_count; ++step)
+    {
+        chainNs[step] = m_steps[step].endNs - m_steps[step].startNs;
+        previous[step] = kNoStep;
+    }
+
+    // Relaxing every edge once per step settles every chain, there's no cycle or Run would
+    // have failed
+    for (uint32 pass = 0; pass < step_count; ++pass)
+    {
+        bool changed = false;
+        for (uint64 edge = 0; edge < m_edgeBefore.Size(); ++edge)
+        {
+            const uint32 before = m_edgeBefore[edge];
+            const uint32 after = m_edgeAfter[edge];
+            const uint64 through =
+                chainNs[before] + (m_steps[after].endNs - m_steps[after].startNs);
+            if (through > chainNs[after])
+            {
+                chainNs[after] = through;
+                previous[after] = before;
+                changed = true;
+            }
+        }
+        if (!changed)
+        {
+            break;
+        }
+    }
+}
+
+uint64 Bootstrap::CriticalPathNs() const
+{
+    DynamicArray<uint64> chain_ns(GetTaggedAllocator(MemoryTag::Jobs));
+    DynamicArray<uint32> previous(GetTaggedAllocator(MemoryTag::Jobs));
+    LongestChains(chain_ns, previous);
+    uint64 longest = 0;
+    for (const uint64 ns : chain_ns)
+    {
+        longest = ns > longest ? ns : longest;
+    }
+    return longest;
+}
+
+void Bootstrap::BuildTimeline(String& text) const
+{
+    DynamicArray<uint64> chain_ns(GetTaggedAllocator(MemoryTag::Jobs));
+    DynamicArray<uint32> previous(GetTaggedAllocator(MemoryTag::Jobs));
+    LongestChains(chain_ns, previous);
+    const uint32 step_count = static_cast<uint32>(m_steps.Size());
+    uint32 last = kNoStep;
+    uint64 step_sum_ns = 0;
+    for (uint32 step = 0; step < step_count; ++step)
+    {
+        if (last == kNoStep || chain_ns[step] > chain_ns[last])
+        {
+            last = step;
+        }
+        step_sum_ns += m_steps[step].endNs - m_steps[step].startNs;
+    }
+
+    char line[256];
+    snprintf(line,
+             sizeof(line),
+             "Start-up took %.2f ms, its steps %.2f ms end to end; the slowest chain %.2f ms:",
+             NsToMs(m_totalNs),
+             NsToMs(step_sum_ns),
+             last != kNoStep ? NsToMs(chain_ns[last]) : 0.0);
+    text.Append(line);
+
+    // The chain comes out last step first
+    DynamicArray<uint32> chain(GetTaggedAllocator(MemoryTag::Jobs));
+    for (uint32 step = last; step != kNoStep; step = previous[step])
+    {
+        chain.PushBack(step);
+    }
+    for (uint64 i = chain.Size(); i > 0; --i)
+    {
+        text.Append(i == chain.Size() ? " " : " > ");
+        text.Append(m_steps[chain[i - 1]].name);
+    }
+
+    // Insertion sorted by start, there are only a handful
+    DynamicArray<uint32> order(GetTaggedAllocator(MemoryTag::Jobs));
+    for (uint32 step = 0; step < step_count; ++step)
+    {
+        uint64 at = order.Size();
+        order.PushBack(step);
+        while (at > 0 && m_steps[order[at - 1]].startNs > m_steps[step].startNs)
+        {
+            order[at] = order[at - 1];
+            --at;
+        }
+        order[at] = step;
+    }
+    for (const uint32 step : order)
+    {
+        const BootstrapStep& record = m_steps[step];
+        const char* status = record.status == BootstrapStepStatus::Failed    ? " failed"
+                             : record.status == BootstrapStepStatus::Skipped ? " skipped"
+                             : record.status == BootstrapStepStatus::NotRun  ? " not run"
+                                                                             : "";
+        snprintf(line,
+                 sizeof(line),
+                 "\n  %-24s %9.2f .. %9.2f ms %9.2f ms%s",
+                 record.name,
+                 NsToMs(record.startNs),
+                 NsToMs(record.endNs),
+                 NsToMs(record.endNs - record.startNs),
+                 status);
+        text.Append(line);
+    }
+}
+
+} // namespace rsbl
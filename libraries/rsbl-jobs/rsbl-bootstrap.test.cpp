@@ -0,0 +1,147 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-bootstrap.h"
+
+#include <rsbl-thread.h>
+
+#include <atomic>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+UniquePtr<JobSystem> MakeJobSystem(uint32 workerCount)
+{
+    JobSystemOptions options;
+    options.workerCount = workerCount;
+    Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+    REQUIRE(result);
+    return rsblMove(result.Value());
+}
+} // namespace
+
+TEST_SUITE("rsbl::Bootstrap")
+{
+    TEST_CASE("Independent steps overlap")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(3);
+        Bootstrap startup;
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            startup.AddStep("sleep", []() -> Result<> {
+                Thread::ThreadSleep(30);
+                return ResultCode::Success;
+            });
+        }
+        REQUIRE(startup.Run(*jobs));
+
+        uint64 step_sum_ns = 0;
+        for (const BootstrapStep& step : startup.Steps())
+        {
+            CHECK(step.status == BootstrapStepStatus::Succeeded);
+            step_sum_ns += step.endNs - step.startNs;
+        }
+        // Sleeping, so they overlap even on one core
+        CHECK(startup.TotalNs() < step_sum_ns);
+        CHECK(startup.CriticalPathNs() < step_sum_ns);
+    }
+
+    TEST_CASE("Steps start after what they need")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        std::atomic<uint32> next{0};
+        uint32 ticket[3] = {};
+        Bootstrap startup;
+        const uint32 device = startup.AddStep("device", [&]() -> Result<> {
+            Thread::ThreadSleep(5);
+            ticket[0] = next.fetch_add(1);
+            return ResultCode::Success;
+        });
+        const uint32 window = startup.AddStep("window", [&]() -> Result<> {
+            ticket[1] = next.fetch_add(1);
+            return ResultCode::Success;
+        });
+        const uint32 swapchain = startup.AddStep("swapchain", [&]() -> Result<> {
+            ticket[2] = next.fetch_add(1);
+            return ResultCode::Success;
+        });
+        startup.AddDependency(device, swapchain);
+        startup.AddDependency(window, swapchain);
+        REQUIRE(startup.Run(*jobs));
+
+        CHECK(ticket[2] == 2);
+        const ArrayView<const BootstrapStep> steps = startup.Steps();
+        CHECK(steps[swapchain].startNs >= steps[device].endNs);
+        CHECK(steps[swapchain].startNs >= steps[window].endNs);
+
+        // The device is the slow way to the swapchain
+        String timeline;
+        startup.BuildTimeline(timeline);
+        CHECK(strstr(timeline.CStr(), "device > swapchain") != nullptr);
+    }
+
+    TEST_CASE("A failed step skips what needs it, and fails the run")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        std::atomic<bool> dependent_ran{false};
+        std::atomic<bool> independent_ran{false};
+        Bootstrap startup;
+        const uint32 device = startup.AddStep("device", []() -> Result<> {
+            return FailureFormat(ErrorCategory::Platform, "No adapter with %u MB", 4096u);
+        });
+        const uint32 swapchain = startup.AddStep("swapchain", [&]() -> Result<> {
+            dependent_ran.store(true);
+            return ResultCode::Success;
+        });
+        const uint32 present = startup.AddStep("present", [&]() -> Result<> {
+            dependent_ran.store(true);
+            return ResultCode::Success;
+        });
+        const uint32 cache = startup.AddStep("cache", [&]() -> Result<> {
+            independent_ran.store(true);
+            return ResultCode::Success;
+        });
+        startup.AddDependency(device, swapchain);
+        startup.AddDependency(swapchain, present);
+
+        const Result<> started = startup.Run(*jobs);
+        REQUIRE_FALSE(started);
+        CHECK(started.Category() == ErrorCategory::Platform);
+        CHECK(strcmp(started.FailureText(), "device: No adapter with 4096 MB") == 0);
+
+        CHECK_FALSE(dependent_ran.load());
+        CHECK(independent_ran.load());
+        const ArrayView<const BootstrapStep> steps = startup.Steps();
+        CHECK(steps[device].status == BootstrapStepStatus::Failed);
+        CHECK(steps[swapchain].status == BootstrapStepStatus::Skipped);
+        CHECK(steps[present].status == BootstrapStepStatus::Skipped);
+        CHECK(steps[cache].status == BootstrapStepStatus::Succeeded);
+    }
+
+    TEST_CASE("Cycles fail before anything runs")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(1);
+        std::atomic<bool> ran{false};
+        Bootstrap startup;
+        const uint32 a = startup.AddStep("a", [&]() -> Result<> {
+            ran.store(true);
+            return ResultCode::Success;
+        });
+        const uint32 b = startup.AddStep("b", [&]() -> Result<> {
+            ran.store(true);
+            return ResultCode::Success;
+        });
+        startup.AddDependency(a, b);
+        startup.AddDependency(b, a);
+
+        const Result<> started = startup.Run(*jobs);
+        CHECK_FALSE(started);
+        CHECK(started.Category() == ErrorCategory::InvalidArgument);
+        CHECK_FALSE(ran.load());
+    }
+}
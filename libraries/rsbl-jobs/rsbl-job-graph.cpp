@@ -0,0 +1,162 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-job-graph.h"
+
+#include <rsbl-assert.h>
+
+#include <new>
+
+namespace rsbl
+{
+
+JobGraph::~JobGraph()
+{
+    if (m_remaining != nullptr)
+    {
+        GetTaggedAllocator(MemoryTag::Jobs)
+            ->Free(m_remaining, m_tasks.Size() * sizeof(std::atomic<uint32>),
+                   alignof(std::atomic<uint32>));
+    }
+}
+
+uint32 JobGraph::AddTask(Job&& task, JobPriority priority)
+{
+    rsblAssertMsg(!m_built, "JobGraph can't change after Build");
+    m_tasks.PushBack(rsblMove(task));
+    m_priorities.PushBack(priority);
+    return static_cast<uint32>(m_tasks.Size() - 1);
+}
+
+void JobGraph::AddDependency(uint32 before, uint32 after)
+{
+    rsblAssertMsg(!m_built, "JobGraph can't change after Build");
+    rsblAssert(before < m_tasks.Size() && after < m_tasks.Size());
+    m_edgeBefore.PushBack(before);
+    m_edgeAfter.PushBack(after);
+}
+
+Result<> JobGraph::Build()
+{
+    rsblAssertMsg(!m_built, "JobGraph is already built");
+
+    const uint32 task_count = TaskCount();
+    const uint64 edge_count = m_edgeBefore.Size();
+
+    // Successors grouped by task, a counting sort on the edges' first task
+    m_successorStart.Resize(task_count + 1);
+    m_dependencyCounts.Resize(task_count);
+    for (uint64 edge = 0; edge < edge_count; ++edge)
+    {
+        m_successorStart[m_edgeBefore[edge] + 1]++;
+        m_dependencyCounts[m_edgeAfter[edge]]++;
+    }
+    for (uint32 task = 0; task < task_count; ++task)
+    {
+        m_successorStart[task + 1] += m_successorStart[task];
+    }
+
+    DynamicArray<uint32> cursor(GetTaggedAllocator(MemoryTag::Jobs));
+    cursor.Resize(task_count);
+    m_successors.Resize(edge_count);
+    for (uint64 edge = 0; edge < edge_count; ++edge)
+    {
+        const uint32 before = m_edgeBefore[edge];
+        m_successors[m_successorStart[before] + cursor[before]++] = m_edgeAfter[edge];
+    }
+
+    // Kahn's algorithm: if peeling off tasks with no dependencies left doesn't reach them all,
+    // the rest are on a cycle
+    DynamicArray<uint32> remaining(GetTaggedAllocator(MemoryTag::Jobs));
+    DynamicArray<uint32> ready(GetTaggedAllocator(MemoryTag::Jobs));
+    remaining.Resize(task_count);
+    for (uint32 task = 0; task < task_count; ++task)
+    {
+        remaining[task] = m_dependencyCounts[task];
+        if (remaining[task] == 0)
+        {
+            ready.PushBack(task);
+            m_roots.PushBack(task);
+        }
+    }
+    uint32 visited = 0;
+    while (!ready.IsEmpty())
+    {
+        const uint32 task = ready[ready.Size() - 1];
+        ready.PopBack();
+        ++visited;
+        for (uint32 i = m_successorStart[task]; i < m_successorStart[task + 1]; ++i)
+        {
+            if (--remaining[m_successors[i]] == 0)
+            {
+                ready.PushBack(m_successors[i]);
+            }
+        }
+    }
+    if (visited != task_count)
+    {
+        m_roots.Clear();
+        return {ErrorCategory::InvalidArgument, "JobGraph dependencies make a cycle"};
+    }
+
+    m_edgeBefore.Clear();
+    m_edgeAfter.Clear();
+
+    if (task_count > 0)
+    {
+        void* memory = GetTaggedAllocator(MemoryTag::Jobs)
+                           ->Allocate(task_count * sizeof(std::atomic<uint32>),
+                                      alignof(std::atomic<uint32>));
+        if (memory == nullptr)
+        {
+            m_roots.Clear();
+            return {ErrorCategory::OutOfMemory, "Failed to allocate JobGraph counts"};
+        }
+        m_remaining = static_cast<std::atomic<uint32>*>(memory);
+        for (uint32 task = 0; task < task_count; ++task)
+        {
+            new (&m_remaining[task]) std::atomic<uint32>(0);
+        }
+    }
+
+    m_built = true;
+    return ResultCode::Success;
+}
+
+void JobGraph::Run(JobSystem& jobs, JobCounter& counter)
+{
+    rsblAssertMsg(m_built, "JobGraph has to be built before it runs");
+
+    m_jobs = &jobs;
+    m_counter = &counter;
+    const uint32 task_count = TaskCount();
+    for (uint32 task = 0; task < task_count; ++task)
+    {
+        m_remaining[task].store(m_dependencyCounts[task], std::memory_order_relaxed);
+    }
+
+    // Submitting publishes the counts to whichever threads run the tasks
+    for (const uint32 root : m_roots)
+    {
+        jobs.Submit([this, root]() { RunTask(root); }, &counter, m_priorities[root]);
+    }
+}
+
+void JobGraph::RunTask(uint32 task)
+{
+    m_tasks[task]();
+
+    // This job still counts against m_counter, so it can't reach zero before the successors are
+    // submitted. The last dependency in submits, its decrement orders every other one before.
+    for (uint32 i = m_successorStart[task]; i < m_successorStart[task + 1]; ++i)
+    {
+        const uint32 successor = m_successors[i];
+        if (m_remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            m_jobs->Submit(
+                [this, successor]() { RunTask(successor); }, m_counter, m_priorities[successor]);
+        }
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,148 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-job-graph.h"
+
+#include <atomic>
+
+using namespace rsbl;
+
+namespace
+{
+UniquePtr<JobSystem> MakeJobSystem(uint32 workerCount)
+{
+    JobSystemOptions options;
+    options.workerCount = workerCount;
+    Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+    REQUIRE(result);
+    return rsblMove(result.Value());
+}
+
+// Every task takes the next ticket when it runs, so edges can be checked against the order
+struct Tickets
+{
+    std::atomic<uint32> next{0};
+    DynamicArray<uint32> taken;
+
+    explicit Tickets(uint32 count)
+    {
+        taken.Resize(count);
+    }
+
+    void Reset()
+    {
+        next.store(0);
+        for (uint32& ticket : taken)
+        {
+            ticket = ~0u;
+        }
+    }
+};
+} // namespace
+
+TEST_SUITE("rsbl::JobGraph")
+{
+    TEST_CASE("An empty graph runs")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(1);
+        JobGraph graph;
+        REQUIRE(graph.Build());
+        JobCounter done;
+        graph.Run(*jobs, done);
+        jobs->Wait(done);
+        CHECK(done.IsDone());
+    }
+
+    TEST_CASE("Cycles fail to build")
+    {
+        JobGraph graph;
+        const uint32 a = graph.AddTask([]() {});
+        const uint32 b = graph.AddTask([]() {});
+        const uint32 c = graph.AddTask([]() {});
+        graph.AddDependency(a, b);
+        graph.AddDependency(b, c);
+        graph.AddDependency(c, b);
+        const Result<> built = graph.Build();
+        CHECK_FALSE(built);
+        CHECK(built.Category() == ErrorCategory::InvalidArgument);
+    }
+
+    TEST_CASE("Replays respect every dependency, every time")
+    {
+        // Layers of tasks, each depending on a few from the layer before, plus some long edges
+        constexpr uint32 kLayers = 6;
+        constexpr uint32 kWidth = 20;
+        constexpr uint32 kTasks = kLayers * kWidth;
+
+        Tickets tickets(kTasks);
+        JobGraph graph;
+        for (uint32 task = 0; task < kTasks; ++task)
+        {
+            graph.AddTask([&tickets, task]() { tickets.taken[task] = tickets.next.fetch_add(1); });
+        }
+
+        DynamicArray<uint32> before;
+        DynamicArray<uint32> after;
+        uint32 state = 12345;
+        for (uint32 layer = 1; layer < kLayers; ++layer)
+        {
+            for (uint32 i = 0; i < kWidth; ++i)
+            {
+                for (uint32 edge = 0; edge < 3; ++edge)
+                {
+                    state = state * 1664525u + 1013904223u;
+                    const uint32 from_layer = edge == 2 ? (state >> 8) % layer : layer - 1;
+                    before.PushBack(from_layer * kWidth + (state >> 20) % kWidth);
+                    after.PushBack(layer * kWidth + i);
+                    graph.AddDependency(before[before.Size() - 1], after[after.Size() - 1]);
+                }
+            }
+        }
+        REQUIRE(graph.Build());
+        CHECK(graph.TaskCount() == kTasks);
+
+        UniquePtr<JobSystem> jobs = MakeJobSystem(3);
+        for (uint32 frame = 0; frame < 100; ++frame)
+        {
+            tickets.Reset();
+            JobCounter done;
+            graph.Run(*jobs, done);
+            jobs->Wait(done);
+
+            REQUIRE(tickets.next.load() == kTasks);
+            uint32 violations = 0;
+            for (uint64 edge = 0; edge < before.Size(); ++edge)
+            {
+                violations += tickets.taken[before[edge]] < tickets.taken[after[edge]] ? 0 : 1;
+            }
+            REQUIRE(violations == 0);
+        }
+    }
+
+    TEST_CASE("A graph can run from inside a job")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        std::atomic<uint32> ran{0};
+        JobGraph graph;
+        const uint32 root = graph.AddTask([&ran]() { ran.fetch_add(1); });
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            graph.AddDependency(root, graph.AddTask([&ran]() { ran.fetch_add(1); }));
+        }
+        REQUIRE(graph.Build());
+
+        JobCounter outer;
+        jobs->Submit(
+            [&jobs, &graph]() {
+                JobCounter done;
+                graph.Run(*jobs, done);
+                jobs->Wait(done);
+            },
+            &outer);
+        jobs->Wait(outer);
+        CHECK(ran.load() == 11);
+    }
+}
@@ -0,0 +1,186 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-job-trace.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-bits.h>
+#include <rsbl-clock.h>
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace rsbl::Internal
+{
+
+namespace
+{
+const char* const kPriorityNames[] = {"High", "Medium", "Low"};
+const char* const kFiberSwitchNames[] = {"start", "release", "park"};
+
+// Events can have started before the capture did, they're clamped to its start
+double ToMicroseconds(uint64 ticks, uint64 startTicks)
+{
+    if (ticks <= startTicks)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(Clock::TicksToNs(ticks - startTicks)) / 1000.0;
+}
+
+void AppendFormat(String& json, const char* format, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    rsblAssert(length >= 0 && length < static_cast<int>(sizeof(buffer)));
+    json.Append(StringView(buffer, static_cast<uint64>(length)));
+}
+
+void AppendEvent(String& json, const JobTraceEvent& event, uint32 threadId, uint64 startTicks)
+{
+    const double ts = ToMicroseconds(event.start, startTicks);
+    switch (event.type)
+    {
+    case JobTraceType::Job:
+        AppendFormat(json,
+                     ",\n{\"name\":\"Job\",\"cat\":\"job\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                     "\"pid\":1,\"tid\":%u,\"args\":{\"priority\":\"%s\"}}",
+                     ts,
+                     ToMicroseconds(event.end, startTicks) - ts,
+                     threadId,
+                     kPriorityNames[event.priority < 3 ? event.priority : 1]);
+        break;
+    case JobTraceType::Wait:
+        AppendFormat(json,
+                     ",\n{\"name\":\"Wait\",\"cat\":\"wait\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                     "\"pid\":1,\"tid\":%u,\"args\":{\"counter\":\"0x%llx\"}}",
+                     ts,
+                     ToMicroseconds(event.end, startTicks) - ts,
+                     threadId,
+                     static_cast<unsigned long long>(event.arg));
+        break;
+    case JobTraceType::Sleep:
+        AppendFormat(json,
+                     ",\n{\"name\":\"Sleep\",\"cat\":\"idle\",\"ph\":\"X\",\"ts\":%.3f,"
+                     "\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                     ts,
+                     ToMicroseconds(event.end, startTicks) - ts,
+                     threadId);
+        break;
+    case JobTraceType::Region:
+        AppendFormat(json,
+                     ",\n{\"name\":\"%s\",\"cat\":\"region\",\"ph\":\"X\",\"ts\":%.3f,"
+                     "\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                     reinterpret_cast<const char*>(event.arg),
+                     ts,
+                     ToMicroseconds(event.end, startTicks) - ts,
+                     threadId);
+        break;
+    case JobTraceType::Steal:
+        AppendFormat(json,
+                     ",\n{\"name\":\"Steal\",\"cat\":\"steal\",\"ph\":\"i\",\"s\":\"t\","
+                     "\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"victim\":%llu}}",
+                     ts,
+                     threadId,
+                     static_cast<unsigned long long>(event.arg));
+        break;
+    case JobTraceType::FiberSwitch:
+        AppendFormat(json,
+                     ",\n{\"name\":\"Fiber switch\",\"cat\":\"fiber\",\"ph\":\"i\",\"s\":\"t\","
+                     "\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"previous\":\"%s\"}}",
+                     ts,
+                     threadId,
+                     kFiberSwitchNames[event.arg < 3 ? event.arg : 0]);
+        break;
+    case JobTraceType::Counter:
+        // Counters belong to the process rather than a thread in Chrome's format
+        AppendFormat(json,
+                     ",\n{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,"
+                     "\"args\":{\"value\":%llu}}",
+                     reinterpret_cast<const char*>(event.arg),
+                     ts,
+                     static_cast<unsigned long long>(event.end));
+        break;
+    }
+}
+} // namespace
+
+JobTraceRing::JobTraceRing(uint32 capacity, Allocator* allocator)
+    : m_events(allocator)
+{
+    rsblAssert(capacity > 0);
+    const uint64 size = NextPowerOfTwo(capacity);
+    m_events.Resize(size);
+    m_mask = size - 1;
+}
+
+void JobTraceRing::Snapshot(DynamicArray<JobTraceEvent>& out) const
+{
+    const uint64 head = m_head.load(std::memory_order_acquire);
+    const uint64 size = m_mask + 1;
+    const uint64 first = head > size ? head - size + 1 : 0;
+    out.Reserve(out.Size() + (head - first));
+    for (uint64 i = first; i < head; ++i)
+    {
+        out.PushBack(m_events[i & m_mask]);
+    }
+}
+
+void BuildChromeTraceJson(const JobTraceTrack* tracks,
+                          uint32 trackCount,
+                          uint64 startTicks,
+                          String& json)
+{
+    json.Append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    json.Append("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                "\"args\":{\"name\":\"rsbl jobs\"}}");
+
+    DynamicArray<JobTraceEvent> events;
+    DynamicArray<uint32> named_threads;
+    for (uint32 t = 0; t < trackCount; ++t)
+    {
+        const JobTraceTrack& track = tracks[t];
+        events.Clear();
+        track.ring->Snapshot(events);
+
+        if (track.name != nullptr)
+        {
+            AppendFormat(json,
+                         ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                         "\"args\":{\"name\":\"%s\"}}",
+                         track.threadId,
+                         track.name);
+        }
+
+        for (const JobTraceEvent& event : events)
+        {
+            // Tracks without a name mix several threads, each event says which
+            const uint32 thread_id = track.name != nullptr ? track.threadId : event.threadId;
+            if (track.name == nullptr)
+            {
+                bool named = false;
+                for (uint32 id : named_threads)
+                {
+                    named = named || id == thread_id;
+                }
+                if (!named)
+                {
+                    named_threads.PushBack(thread_id);
+                    AppendFormat(json,
+                                 ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                                 "\"args\":{\"name\":\"Thread %u\"}}",
+                                 thread_id,
+                                 thread_id);
+                }
+            }
+            AppendEvent(json, event, thread_id, startTicks);
+        }
+    }
+
+    json.Append("\n]}\n");
+}
+
+} // namespace rsbl::Internal
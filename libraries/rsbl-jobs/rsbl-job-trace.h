@@ -0,0 +1,92 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-allocator.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-string.h>
+
+#include <atomic>
+
+// Trace recording for the job system. Each worker writes its own ring, so recording an event is
+// a few stores and a release, no locks and no shared lines. Rings overwrite their oldest events,
+// so a long capture keeps the most recent stretch, like a flight recorder.
+
+namespace rsbl::Internal
+{
+
+enum class JobTraceType : uint8
+{
+    // Slices, start to end
+    Job,
+    Wait,
+    Sleep,
+    Region,
+
+    // Instants, only start is used
+    Steal,
+    FiberSwitch,
+    Counter,
+};
+
+struct JobTraceEvent
+{
+    uint64 start = 0;
+    uint64 end = 0;
+    // Steal: the victim worker. Wait: the counter's address, to match up waits on the same one.
+    // FiberSwitch: what happened to the fiber switched away from. Region and Counter: the
+    // name's address, a Counter's value going in end.
+    uint64 arg = 0;
+    // Only for events from threads that aren't workers
+    uint32 threadId = 0;
+    JobTraceType type = JobTraceType::Job;
+    uint8 priority = 0;
+};
+
+// One writer at a time, any number of readers
+class JobTraceRing
+{
+  public:
+    JobTraceRing(uint32 capacity, Allocator* allocator);
+
+    void Record(const JobTraceEvent& event)
+    {
+        const uint64 head = m_head.load(std::memory_order_relaxed);
+        m_events[head & m_mask] = event;
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    // Copies the recorded events out, oldest first. Once the ring has wrapped, the oldest slot
+    // is left out, a writer may be overwriting it.
+    void Snapshot(DynamicArray<JobTraceEvent>& out) const;
+
+    void Clear()
+    {
+        m_head.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+    DynamicArray<JobTraceEvent> m_events;
+    uint64 m_mask = 0;
+    std::atomic<uint64> m_head{0};
+};
+
+struct JobTraceTrack
+{
+    const JobTraceRing* ring = nullptr;
+    // Chrome trace tid, and the name shown on the track. Workers get their index, events from
+    // other threads carry their own id.
+    uint32 threadId = 0;
+    const char* name = nullptr;
+};
+
+// Chrome trace event JSON (chrome://tracing, ui.perfetto.dev), timestamps in microseconds from
+// startTicks
+void BuildChromeTraceJson(const JobTraceTrack* tracks,
+                          uint32 trackCount,
+                          uint64 startTicks,
+                          String& json);
+
+} // namespace rsbl::Internal
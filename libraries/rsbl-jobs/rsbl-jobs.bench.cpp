@@ -0,0 +1,178 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Job system overhead and scaling: the cost of an empty job submitted from outside and from
+// inside the workers, how long a job submitted to idle workers takes to start, then a
+// compute-bound ParallelFor at every worker count up to the machine's.
+
+#include "include/rsbl-jobs.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-thread.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint32 kEmptyJobs = 1000000;
+constexpr uint32 kWakeRounds = 1000;
+constexpr uint64 kItems = 1ull << 22;
+
+// Stop the optimizer from folding the loops away
+volatile uint64 s_sink = 0;
+
+UniquePtr<JobSystem> MakeJobSystem(uint32 workerCount)
+{
+    JobSystemOptions options;
+    options.workerCount = workerCount;
+    Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+    if (!result)
+    {
+        printf("JobSystem::Create failed: %s\n", result.FailureText());
+        return UniquePtr<JobSystem>();
+    }
+    return rsblMove(result.Value());
+}
+
+template <typename F>
+double Milliseconds(F&& f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// A few hundred cycles of dependent integer math per item
+uint64 Work(uint64 value)
+{
+    for (uint32 i = 0; i < 64; ++i)
+    {
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+        value ^= value >> 29;
+    }
+    return value;
+}
+} // namespace
+
+int main()
+{
+    const uint32 hardware_threads = Thread::GetHardwareThreadCount();
+    printf("%u hardware threads\n", hardware_threads);
+
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(0);
+        if (!jobs)
+        {
+            return 1;
+        }
+
+        std::atomic<uint32> ran{0};
+        const double outside_ms = Milliseconds([&]() {
+            JobCounter counter;
+            for (uint32 i = 0; i < kEmptyJobs; ++i)
+            {
+                jobs->Submit([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }
+            jobs->Wait(counter);
+        });
+        printf("  %-36s %8.1f ns/job\n", "Empty jobs, submitted outside",
+               outside_ms * 1e6 / kEmptyJobs);
+
+        // One job fans the rest out, so they go through the worker's own deque and get stolen
+        const double inside_ms = Milliseconds([&]() {
+            JobCounter counter;
+            jobs->Submit(
+                [&jobs, &ran]() {
+                    JobCounter children;
+                    for (uint32 i = 0; i < kEmptyJobs; ++i)
+                    {
+                        jobs->Submit([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); },
+                                     &children);
+                    }
+                    jobs->Wait(children);
+                },
+                &counter);
+            jobs->Wait(counter);
+        });
+        printf("  %-36s %8.1f ns/job\n", "Empty jobs, submitted by a worker",
+               inside_ms * 1e6 / kEmptyJobs);
+
+        // One job at a time, spinning on it rather than helping in Wait, so a worker has to pick
+        // it up. Back to back the workers may still be spinning, after a millisecond idle they
+        // have gone to sleep and the time includes waking one.
+        for (uint32 idleMs : {0u, 1u})
+        {
+            double totalMs = 0.0;
+            for (uint32 i = 0; i < kWakeRounds; ++i)
+            {
+                if (idleMs > 0)
+                {
+                    Thread::ThreadSleep(idleMs);
+                }
+                std::atomic<bool> started{false};
+                JobCounter counter;
+                totalMs += Milliseconds([&]() {
+                    jobs->Submit([&started]() { started.store(true, std::memory_order_release); },
+                                 &counter);
+                    // Yielding once the spin runs long, in case the worker needs this core
+                    for (uint32 spins = 0; !started.load(std::memory_order_acquire); ++spins)
+                    {
+                        if (spins < 1024)
+                        {
+                            Thread::SpinPause();
+                        }
+                        else
+                        {
+                            Thread::ThreadYield();
+                        }
+                    }
+                });
+                jobs->Wait(counter);
+            }
+            printf("  %-36s %8.1f ns/job\n",
+                   idleMs > 0 ? "One job, submitted after 1 ms idle" : "One job, back to back",
+                   totalMs * 1e6 / kWakeRounds);
+        }
+        s_sink = ran.load();
+    }
+
+    DynamicArray<uint64> values;
+    values.Resize(kItems);
+    const double serial_ms = Milliseconds([&]() {
+        for (uint64 i = 0; i < kItems; ++i)
+        {
+            values[i] = Work(i);
+        }
+    });
+    printf("ParallelFor over %llu items\n", static_cast<unsigned long long>(kItems));
+    printf("  %-36s %8.2f ms\n", "Serial", serial_ms);
+
+    for (uint32 workers = 1; workers < hardware_threads || workers == 1; workers *= 2)
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(workers);
+        if (!jobs)
+        {
+            return 1;
+        }
+
+        const double ms = Milliseconds([&]() {
+            jobs->ParallelFor(0, kItems, 4096, [&values](uint64 begin, uint64 end) {
+                for (uint64 i = begin; i < end; ++i)
+                {
+                    values[i] = Work(i);
+                }
+            });
+        });
+        char name[64];
+        snprintf(name, sizeof(name), "%u workers + caller", workers);
+        printf("  %-36s %8.2f ms  (%.2fx)\n", name, ms, serial_ms / ms);
+    }
+    s_sink = values[kItems / 2];
+
+    return 0;
+}
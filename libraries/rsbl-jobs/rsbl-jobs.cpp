@@ -0,0 +1,1323 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-jobs.h"
+#include "rsbl-job-trace.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-clock.h>
+#include <rsbl-concurrent-queue.h>
+#include <rsbl-counters.h>
+#include <rsbl-cpu-topology.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-fiber.h>
+#include <rsbl-file.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-pool-allocator.h>
+#include <rsbl-profile.h>
+#include <rsbl-sync.h>
+#include <rsbl-thread-local.h>
+#include <rsbl-thread.h>
+#include <rsbl-virtual-memory.h>
+
+#include <cstdio>
+
+// Idle threads (workers with nothing to do, and threads blocked in Wait) sleep on an epoch
+// counter, high priority workers on their own so a background job never wakes one for nothing.
+// Anything they could be waiting for, a job being queued, a waited-on counter reaching zero, or
+// shutdown, bumps the epoch and notifies, but only when someone is sleeping, so the busy path
+// never makes a syscall. A sleeper counts itself in before its last look at the queues, and
+// a waker publishes its change before checking the count, with a fence on both sides, so either
+// the sleeper sees the change or the waker sees the sleeper.
+// Counters are only decremented, never waited on directly, which is what makes it safe to free a
+// counter as soon as Wait returns. That rules out touching a counter after taking it to zero, so
+// the last job out takes the continuations while its own count still holds the counter open, and
+// only then lets it go to zero. Registering a continuation holds the counter open the same way,
+// so one can't slip in after the last job has looked.
+// With fibers, every worker runs jobs on a pool fiber. A job that waits parks its fiber as a
+// continuation on the counter and the worker carries on on a fresh fiber, and whichever job takes
+// the counter to zero queues the parked fiber to be resumed, on any worker. Parking is finished
+// by the fiber switched to, never the one switching away, so nobody can resume a fiber that's
+// still running. Fibers carry on on whichever thread resumes them, so worker lookups after a
+// switch always go through CurrentWorker, which is never inlined and can't reuse a stale
+// thread_local.
+// Every job runs in a ScratchScope. With fibers each fiber has a scratch arena of its own, put in
+// place on every switch, so a job that parks keeps its scratch memory wherever it resumes.
+// Pinned workers on a machine with several NUMA nodes keep their deques and their thread's
+// scratch arena in their own node's memory. Pool fibers move between workers, so theirs can't.
+
+namespace rsbl
+{
+
+namespace
+{
+// Failed looks for work before an idle thread goes to sleep. Jobs tend to arrive in bursts, and
+// spinning a little is much cheaper than a wake up.
+constexpr uint32 kSpinRounds = 64;
+
+constexpr uint32 kPriorityCount = static_cast<uint32>(JobPriority::Count);
+static_assert(kPriorityCount == 3, "The lanes below are spelled out per priority");
+
+// Sleep groups: everyone, the high priority workers, and the workers SetActiveWorkerLimit holds
+// back, which no job wakes
+constexpr uint32 kGeneralGroup = 0;
+constexpr uint32 kHighOnlyGroup = 1;
+constexpr uint32 kSuspendedGroup = 2;
+constexpr uint32 kGroupCount = 3;
+
+#if defined(_MSC_VER)
+    #define RSBL_JOBS_NOINLINE __declspec(noinline)
+#else
+    #define RSBL_JOBS_NOINLINE __attribute__((noinline))
+#endif
+
+// Steal victims are picked with a xorshift, seeded differently on every worker
+uint32 NextRandom(uint32& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+} // namespace
+
+namespace Internal
+{
+    struct FiberSlot
+    {
+        UniquePtr<Fiber> fiber;
+        // The priority of the job running on it, which a parked fiber gets resumed at
+        JobPriority priority = JobPriority::Medium;
+        // While tracing, when the job running on it started, or last resumed. Parking ends the
+        // slice on the worker it parked on, the one it resumes on starts a new one.
+        uint64 traceStart = 0;
+        // Scratch memory for the jobs on it, blocks only come once something's allocated
+        LinearArena scratch{kScratchBlockSize, GetTaggedAllocator(MemoryTag::Jobs)};
+        // What profilers that follow fibers call it
+        char profileName[24] = {};
+    };
+
+    struct QueuedJob
+    {
+        Job job;
+        JobCounter* counter = nullptr;
+        JobPriority priority = JobPriority::Medium;
+        // Next continuation on the same counter
+        QueuedJob* next = nullptr;
+        // Set on the continuation that resumes a parked fiber, which has no job of its own
+        FiberSlot* parked = nullptr;
+    };
+} // namespace Internal
+
+using Internal::FiberSlot;
+using Internal::JobTraceEvent;
+using Internal::JobTraceRing;
+using Internal::JobTraceType;
+using Internal::QueuedJob;
+
+struct JobSystem::State
+{
+    enum class AfterSwitch : uint8
+    {
+        Nothing,
+        // Back to the free pool
+        Release,
+        // Resumed once the counter gets to zero
+        Park,
+    };
+
+    struct PendingSwitch
+    {
+        AfterSwitch action = AfterSwitch::Nothing;
+        FiberSlot* fiber = nullptr;
+        JobCounter* counter = nullptr;
+    };
+
+    struct Worker
+    {
+        Worker(State* owner,
+               uint32 workerIndex,
+               bool onlyHigh,
+               uint64 capacity,
+               Allocator* allocator)
+            : deques{WorkStealingDeque<QueuedJob*>(capacity, allocator),
+                     WorkStealingDeque<QueuedJob*>(capacity, allocator),
+                     WorkStealingDeque<QueuedJob*>(capacity, allocator)}
+            , state(owner)
+            , index(workerIndex)
+            , random(0x9e3779b9u * (workerIndex + 1))
+            , highOnly(onlyHigh)
+        {
+        }
+
+        // One per priority
+        WorkStealingDeque<QueuedJob*> deques[kPriorityCount];
+        State* state = nullptr;
+        uint32 index = 0;
+        uint32 random = 0;
+        bool highOnly = false;
+
+        // Where it's pinned, 0 for unpinned workers. Unpinned workers all count as one L3 group
+        // and one node.
+        uint64 affinityMask = 0;
+        uint32 l3Group = 0;
+        uint32 numaNode = 0;
+
+        // Scratch for jobs run on the thread's own stack, from its node's memory. Null when the
+        // thread's default scratch does.
+        UniquePtr<LinearArena> scratch;
+
+        // With fibers: the thread's own fiber, the one it's running now (nullptr without fibers),
+        // and what the next fiber to run on this thread has to do about the one it took over from
+        FiberSlot threadFiber;
+        FiberSlot* currentFiber = nullptr;
+        PendingSwitch pending;
+
+        // Its thread's name, and its trace track's
+        char name[32] = {};
+        // Only written by whoever is this worker right now, nullptr without tracing
+        UniquePtr<JobTraceRing> trace;
+    };
+
+    struct SleepGroup
+    {
+        // Kept off the queues' lines, and each other's
+        alignas(kCacheLineSize) std::atomic<uint32> epoch{0};
+        std::atomic<uint32> sleepers{0};
+    };
+
+    State(const JobSystemOptions& options, uint32 workerCount);
+
+    // The calling thread's worker if it's one of ours, nullptr on any other thread
+    RSBL_JOBS_NOINLINE Worker* CurrentWorker();
+
+    // Per priority, most urgent first: own deque, then parked fibers that are ready, then the
+    // shared queue, then the other workers'. High priority workers stop after the first. Fibers
+    // are only picked up when resume isn't nullptr, and come back through it.
+    QueuedJob* FindJob(Worker* self, FiberSlot** resume = nullptr);
+    // Which of FindJob's passes steals from victim: 0 on the same L3 (and for threads that
+    // aren't workers, which have no place), 1 on the same node, 2 on another. Always 0 when
+    // there's only the one pass.
+    uint32 StealDistance(const Worker* self, const Worker* victim) const;
+    bool HasQueuedWork(uint32 laneCount, bool withFibers) const;
+
+    void Enqueue(QueuedJob* queued);
+    void Run(QueuedJob* queued);
+    void RunTraced(QueuedJob* queued, uint64 start);
+    void Finish(JobCounter* counter);
+    void PushContinuations(JobCounter* counter, QueuedJob* first);
+
+    // Sleeps until the next wake up, unless there's work or the wait is already over. Blocked
+    // waiters pass the counter they're waiting on, workers pass nullptr.
+    void Sleep(Worker* self, const JobCounter* counter);
+    void WakeOne(JobPriority priority);
+    void WakeAll();
+
+    // Past the active worker limit, and not shutting down
+    bool IsHeldBack(const Worker* self) const;
+    // Sleeps for as long as self is held back. Whatever is left in its deques gets stolen.
+    void SuspendWhileHeldBack(Worker* self);
+
+    // True when self is running a pool fiber, which a Wait can park
+    bool CanPark(const Worker* self) const;
+    // traceWaitStart is the Wait's trace slice so far, and where it picks up after resuming
+    bool Park(Worker& self, JobCounter& counter, uint64& traceWaitStart);
+
+    // Switches self's thread to the fiber, and has it do action about the current one
+    void SwitchFiber(Worker& self, FiberSlot& to, AfterSwitch action, JobCounter* counter);
+    // First thing after every switch, on the fiber switched to
+    void FinishSwitch();
+
+    // Now, while tracing, and 0 otherwise, which is what the events recorded below check for
+    uint64 TraceNow() const
+    {
+        return tracing.load(std::memory_order_relaxed) ? Clock::NowTicks() : 0;
+    }
+    // Into self's ring, or the shared one for threads that aren't workers. Dropped if the
+    // capture stopped in the meantime.
+    void Trace(Worker* self, const JobTraceEvent& event);
+    void TraceSlice(
+        Worker* self, JobTraceType type, uint64 start, uint64 arg, JobPriority priority);
+    void TraceInstant(Worker* self, JobTraceType type, uint64 arg);
+
+    Result<> WorkerMain(Worker& self);
+    // The worker loop when fibers are on. Runs on pool fibers and never returns, it switches
+    // back to the thread's own fiber at shutdown.
+    void FiberMain();
+    static void FiberEntry(void* state);
+
+    static thread_local Worker* s_currentWorker;
+
+    Allocator* allocator = GetTaggedAllocator(MemoryTag::Jobs);
+    PoolAllocator<QueuedJob> jobPool;
+    // One per priority
+    MpmcQueue<QueuedJob*> injected[kPriorityCount];
+    // One per NUMA node when workers keep their memory on theirs, outliving the workers
+    DynamicArray<UniquePtr<NumaAllocator>> nodeAllocators{allocator};
+    DynamicArray<UniquePtr<Worker>> workers{allocator};
+    // How far FindJob looks for victims: its own L3, its own node, everywhere
+    uint32 stealPasses = 1;
+    DynamicArray<UniquePtr<Thread>> threads{allocator};
+    std::atomic<bool> running{true};
+
+    SleepGroup sleepGroups[kGroupCount];
+    std::atomic<uint32> blockedWaiters{0};
+
+    // Workers that take any job come after the high priority ones, the limit counts from there
+    uint32 highPriorityWorkers = 0;
+    std::atomic<uint32> activeWorkerLimit{~0u};
+
+    // Empty without fibers
+    DynamicArray<UniquePtr<FiberSlot>> fibers{allocator};
+    MpmcQueue<FiberSlot*> freeFibers;
+    // Parked fibers whose counter got to zero, one queue per priority. Each has room for every
+    // fiber, so pushing never fails.
+    MpmcQueue<FiberSlot*> readyFibers[kPriorityCount];
+
+    std::atomic<bool> tracing{false};
+    uint64 traceStartTicks = 0;
+    // Events from threads that aren't workers, Waits and jobs run as back pressure
+    UniquePtr<JobTraceRing> outsideTrace;
+    SpinLock outsideTraceLock;
+    // GPU zones, as slices on the CPU's clock
+    UniquePtr<JobTraceRing> gpuTrace;
+    SpinLock gpuTraceLock;
+};
+
+thread_local JobSystem::State::Worker* JobSystem::State::s_currentWorker = nullptr;
+
+JobSystem::State::State(const JobSystemOptions& options, uint32 workerCount)
+    : jobPool(256, true, allocator)
+    , injected{MpmcQueue<QueuedJob*>(options.queueCapacity, allocator),
+               MpmcQueue<QueuedJob*>(options.queueCapacity, allocator),
+               MpmcQueue<QueuedJob*>(options.queueCapacity, allocator)}
+    , highPriorityWorkers(options.highPriorityWorkers)
+    , freeFibers(options.useFibers ? options.fiberCount : 1, allocator)
+    , readyFibers{MpmcQueue<FiberSlot*>(options.useFibers ? options.fiberCount : 1, allocator),
+                  MpmcQueue<FiberSlot*>(options.useFibers ? options.fiberCount : 1, allocator),
+                  MpmcQueue<FiberSlot*>(options.useFibers ? options.fiberCount : 1, allocator)}
+{
+    // Where each worker goes is worked out first, so its memory can go there with it
+    struct Placement
+    {
+        uint64 affinityMask = 0;
+        uint32 l3Group = 0;
+        uint32 numaNode = 0;
+    };
+    DynamicArray<Placement> placements{allocator};
+    placements.Resize(workerCount);
+
+    const CpuTopology& topology = GetCpuTopology();
+    if (options.pinWorkers)
+    {
+        // One worker per physical core, on its first logical processor so SMT siblings stay
+        // free. Core 0 is left for the thread that runs the frame, until the workers wrap around.
+        const uint32 core_count = static_cast<uint32>(topology.cores.Size());
+        for (uint32 i = 0; i < workerCount; ++i)
+        {
+            const PhysicalCore& core = topology.cores[(i + 1) % core_count];
+            if (core.firstLogicalId >= 64)
+            {
+                continue; // Past what an affinity mask covers
+            }
+            placements[i].affinityMask = 1ull << core.firstLogicalId;
+            for (const LogicalProcessor& processor : topology.logical)
+            {
+                if (processor.id == core.firstLogicalId)
+                {
+                    placements[i].l3Group = processor.l3Group;
+                    placements[i].numaNode = processor.numaNode;
+                    break;
+                }
+            }
+        }
+        stealPasses = topology.numaNodeCount > 1 ? 3 : 2;
+    }
+
+    const bool node_local = options.pinWorkers && options.numaLocalMemory &&
+                            topology.numaNodeCount > 1;
+    if (node_local)
+    {
+        nodeAllocators.Reserve(topology.numaNodeCount);
+        for (uint32 node = 0; node < topology.numaNodeCount; ++node)
+        {
+            nodeAllocators.PushBack(MakeUnique<NumaAllocator>(node, MemoryTag::Jobs));
+        }
+    }
+
+    workers.Reserve(workerCount);
+    for (uint32 i = 0; i < workerCount; ++i)
+    {
+        const bool high_only = i < options.highPriorityWorkers;
+        const Placement& placement = placements[i];
+        Allocator* worker_allocator =
+            node_local ? nodeAllocators[placement.numaNode].Get() : allocator;
+        workers.PushBack(
+            MakeUnique<Worker>(this, i, high_only, options.queueCapacity, worker_allocator));
+
+        Worker& worker = *workers[i];
+        worker.affinityMask = placement.affinityMask;
+        worker.l3Group = placement.l3Group;
+        worker.numaNode = placement.numaNode;
+        if (node_local)
+        {
+            worker.scratch = MakeUnique<LinearArena>(kScratchBlockSize, worker_allocator);
+        }
+    }
+}
+
+JobSystem::State::Worker* JobSystem::State::CurrentWorker()
+{
+    Worker* worker = s_currentWorker;
+    return worker != nullptr && worker->state == this ? worker : nullptr;
+}
+
+uint32 JobSystem::State::StealDistance(const Worker* self, const Worker* victim) const
+{
+    if (self == nullptr || stealPasses == 1 || victim->l3Group == self->l3Group)
+    {
+        return 0;
+    }
+    return victim->numaNode == self->numaNode || stealPasses == 2 ? 1 : 2;
+}
+
+QueuedJob* JobSystem::State::FindJob(Worker* self, FiberSlot** resume)
+{
+    // Start stealing somewhere random, so thieves spread out over the victims
+    const uint32 worker_count = static_cast<uint32>(workers.Size());
+    static thread_local uint32 s_outsideRandom = 0x2545f491u;
+    const uint32 start = NextRandom(self != nullptr ? self->random : s_outsideRandom);
+
+    const uint32 lane_count = self != nullptr && self->highOnly ? 1 : kPriorityCount;
+    QueuedJob* queued = nullptr;
+    for (uint32 lane = 0; lane < lane_count; ++lane)
+    {
+        if (self != nullptr && self->deques[lane].TryPop(queued))
+        {
+            return queued;
+        }
+        if (resume != nullptr && readyFibers[lane].TryPop(*resume))
+        {
+            return nullptr;
+        }
+        if (injected[lane].TryPop(queued))
+        {
+            return queued;
+        }
+        // Thieves look on their own L3 first, where the job's data is more likely to be warm,
+        // then on their own NUMA node, where it's at least in memory close by
+        for (uint32 pass = 0; pass < stealPasses; ++pass)
+        {
+            for (uint32 i = 0; i < worker_count; ++i)
+            {
+                Worker* victim = workers[(start + i) % worker_count].Get();
+                if (victim != self && StealDistance(self, victim) == pass &&
+                    victim->deques[lane].TrySteal(queued))
+                {
+                    TraceInstant(self, JobTraceType::Steal, victim->index);
+                    return queued;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool JobSystem::State::HasQueuedWork(uint32 laneCount, bool withFibers) const
+{
+    for (uint32 lane = 0; lane < laneCount; ++lane)
+    {
+        if (!injected[lane].IsEmptyApprox() || (withFibers && !readyFibers[lane].IsEmptyApprox()))
+        {
+            return true;
+        }
+        for (const UniquePtr<Worker>& worker : workers)
+        {
+            if (!worker->deques[lane].IsEmptyApprox())
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void JobSystem::State::Enqueue(QueuedJob* queued)
+{
+    if (FiberSlot* parked = queued->parked)
+    {
+        const JobPriority priority = queued->priority;
+        jobPool.Delete(queued);
+        const bool pushed = readyFibers[static_cast<uint32>(priority)].TryPush(parked);
+        rsblAssert(pushed);
+
+        // A blocked Wait could take the only wake up and leave the fiber for nobody
+        WakeAll();
+        return;
+    }
+
+    // Even a high priority worker keeps what it submits, anyone can steal it from there
+    Worker* self = CurrentWorker();
+    const uint32 lane = static_cast<uint32>(queued->priority);
+    const bool pushed = self != nullptr ? self->deques[lane].TryPush(queued)
+                                        : injected[lane].TryPush(queued);
+    if (!pushed)
+    {
+        // Out of room, running it here is the back pressure
+        Run(queued);
+        return;
+    }
+    WakeOne(queued->priority);
+}
+
+void JobSystem::State::Run(QueuedJob* queued)
+{
+    RSBL_COUNTER_ADD("jobs.run", 1);
+    {
+        ScratchScope scratch;
+        const uint64 trace_start = TraceNow();
+        if (trace_start != 0)
+        {
+            RunTraced(queued, trace_start);
+        }
+        else
+        {
+            RSBL_PROFILE_ZONE("Job");
+            queued->job();
+        }
+    }
+    JobCounter* counter = queued->counter;
+    jobPool.Delete(queued);
+    if (counter != nullptr)
+    {
+        Finish(counter);
+    }
+}
+
+void JobSystem::State::RunTraced(QueuedJob* queued, uint64 start)
+{
+    // Jobs nest when a Wait runs other jobs, the fiber's slice is the innermost one's
+    Worker* self = CurrentWorker();
+    FiberSlot* slot = self != nullptr ? self->currentFiber : nullptr;
+    uint64 outer_start = 0;
+    if (slot != nullptr)
+    {
+        outer_start = slot->traceStart;
+        slot->traceStart = start;
+    }
+
+    {
+        RSBL_PROFILE_ZONE("Job");
+        queued->job();
+    }
+
+    // The job may have parked and carried on somewhere else, on the same fiber
+    self = CurrentWorker();
+    slot = self != nullptr ? self->currentFiber : nullptr;
+    if (slot != nullptr)
+    {
+        start = slot->traceStart;
+        slot->traceStart = outer_start;
+    }
+    if (start != 0)
+    {
+        TraceSlice(self, JobTraceType::Job, start, 0, queued->priority);
+    }
+}
+
+void JobSystem::State::Trace(Worker* self, const JobTraceEvent& event)
+{
+    if (!tracing.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    if (self != nullptr)
+    {
+        self->trace->Record(event);
+        return;
+    }
+
+    JobTraceEvent outside = event;
+    outside.threadId = static_cast<uint32>(Thread::GetCurrentThreadId());
+    LockGuard<SpinLock> lock(outsideTraceLock);
+    outsideTrace->Record(outside);
+}
+
+void JobSystem::State::TraceSlice(
+    Worker* self, JobTraceType type, uint64 start, uint64 arg, JobPriority priority)
+{
+    JobTraceEvent event;
+    event.start = start;
+    event.end = Clock::NowTicks();
+    event.arg = arg;
+    event.type = type;
+    event.priority = static_cast<uint8>(priority);
+    Trace(self, event);
+}
+
+void JobSystem::State::TraceInstant(Worker* self, JobTraceType type, uint64 arg)
+{
+    if (!tracing.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    JobTraceEvent event;
+    event.start = Clock::NowTicks();
+    event.arg = arg;
+    event.type = type;
+    Trace(self, event);
+}
+
+void JobSystem::State::Finish(JobCounter* counter)
+{
+    uint32 pending = counter->m_pending.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        rsblAssert(pending > 0);
+        if (pending > 1)
+        {
+            if (counter->m_pending.compare_exchange_weak(
+                    pending, pending - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                return;
+            }
+            continue;
+        }
+
+        // Probably the last one out. Take the continuations before letting go, after that the
+        // counter can be freed at any moment.
+        QueuedJob* continuations =
+            counter->m_continuations.exchange(nullptr, std::memory_order_acquire);
+        if (counter->m_pending.compare_exchange_strong(
+                pending, 0, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            while (continuations != nullptr)
+            {
+                QueuedJob* next = continuations->next;
+                continuations->next = nullptr;
+                Enqueue(continuations);
+                continuations = next;
+            }
+            break;
+        }
+
+        // More jobs were added in the meantime, so it isn't done yet. Our count is still held, so
+        // the counter is too.
+        PushContinuations(counter, continuations);
+    }
+
+    // A spinning waiter may have returned already, from here on only the State is safe to use
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (blockedWaiters.load(std::memory_order_relaxed) > 0)
+    {
+        WakeAll();
+    }
+}
+
+void JobSystem::State::PushContinuations(JobCounter* counter, QueuedJob* first)
+{
+    if (first == nullptr)
+    {
+        return;
+    }
+
+    QueuedJob* last = first;
+    while (last->next != nullptr)
+    {
+        last = last->next;
+    }
+
+    QueuedJob* head = counter->m_continuations.load(std::memory_order_relaxed);
+    do
+    {
+        last->next = head;
+    } while (!counter->m_continuations.compare_exchange_weak(
+        head, first, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void JobSystem::State::Sleep(Worker* self, const JobCounter* counter)
+{
+    const bool high_only = self != nullptr && self->highOnly;
+    SleepGroup& group = sleepGroups[high_only ? kHighOnlyGroup : kGeneralGroup];
+
+    group.sleepers.fetch_add(1, std::memory_order_relaxed);
+    if (counter != nullptr)
+    {
+        blockedWaiters.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const uint32 epoch = group.epoch.load(std::memory_order_seq_cst);
+    const bool over = counter != nullptr ? counter->IsDone()
+                                         : !running.load(std::memory_order_seq_cst);
+    const bool with_fibers = counter == nullptr && CanPark(self);
+    if (!over && !HasQueuedWork(high_only ? 1 : kPriorityCount, with_fibers))
+    {
+        const uint64 trace_start = TraceNow();
+        group.epoch.wait(epoch, std::memory_order_seq_cst);
+        if (trace_start != 0)
+        {
+            TraceSlice(self, JobTraceType::Sleep, trace_start, 0, JobPriority::Medium);
+        }
+    }
+
+    if (counter != nullptr)
+    {
+        blockedWaiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+    group.sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void JobSystem::State::WakeOne(JobPriority priority)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // High priority jobs go to the workers kept for them first, everything else can only go to
+    // the general group
+    SleepGroup& high_only = sleepGroups[kHighOnlyGroup];
+    SleepGroup& general = sleepGroups[kGeneralGroup];
+    SleepGroup* group = nullptr;
+    if (priority == JobPriority::High && high_only.sleepers.load(std::memory_order_relaxed) > 0)
+    {
+        group = &high_only;
+    }
+    else if (general.sleepers.load(std::memory_order_relaxed) > 0)
+    {
+        group = &general;
+    }
+
+    if (group != nullptr)
+    {
+        group->epoch.fetch_add(1, std::memory_order_seq_cst);
+        group->epoch.notify_one();
+    }
+}
+
+void JobSystem::State::WakeAll()
+{
+    for (SleepGroup& group : sleepGroups)
+    {
+        group.epoch.fetch_add(1, std::memory_order_seq_cst);
+        group.epoch.notify_all();
+    }
+}
+
+bool JobSystem::State::IsHeldBack(const Worker* self) const
+{
+    return !self->highOnly &&
+           self->index - highPriorityWorkers >= activeWorkerLimit.load(std::memory_order_seq_cst) &&
+           running.load(std::memory_order_seq_cst);
+}
+
+void JobSystem::State::SuspendWhileHeldBack(Worker* self)
+{
+    SleepGroup& group = sleepGroups[kSuspendedGroup];
+    bool passed_on = false;
+    for (;;)
+    {
+        // Read before the check, so a limit raised in between still wakes it
+        const uint32 epoch = group.epoch.load(std::memory_order_seq_cst);
+        if (!IsHeldBack(self))
+        {
+            return;
+        }
+        if (!passed_on)
+        {
+            // It may have been woken for a job from the general group, which a worker still
+            // running should have instead
+            WakeOne(JobPriority::Medium);
+            passed_on = true;
+        }
+        const uint64 trace_start = TraceNow();
+        group.epoch.wait(epoch, std::memory_order_seq_cst);
+        if (trace_start != 0)
+        {
+            TraceSlice(self, JobTraceType::Sleep, trace_start, 0, JobPriority::Medium);
+        }
+    }
+}
+
+bool JobSystem::State::CanPark(const Worker* self) const
+{
+    return self != nullptr && self->currentFiber != nullptr &&
+           self->currentFiber != &self->threadFiber;
+}
+
+bool JobSystem::State::Park(Worker& self, JobCounter& counter, uint64& traceWaitStart)
+{
+    FiberSlot* next = nullptr;
+    if (!freeFibers.TryPop(next))
+    {
+        // Every fiber is parked or running, Wait runs jobs on this one instead
+        return false;
+    }
+
+    // The wait and the job so far end up on this worker's track, the rest on the next one's
+    FiberSlot* from = self.currentFiber;
+    if (traceWaitStart != 0)
+    {
+        const uint64 counter_address = reinterpret_cast<uintptr_t>(&counter);
+        TraceSlice(&self, JobTraceType::Wait, traceWaitStart, counter_address, from->priority);
+        if (from->traceStart != 0)
+        {
+            TraceSlice(&self, JobTraceType::Job, from->traceStart, 0, from->priority);
+        }
+    }
+
+    SwitchFiber(self, *next, AfterSwitch::Park, &counter);
+
+    if (traceWaitStart != 0)
+    {
+        traceWaitStart = Clock::NowTicks();
+        if (from->traceStart != 0)
+        {
+            from->traceStart = traceWaitStart;
+        }
+    }
+    return true;
+}
+
+void JobSystem::State::SwitchFiber(Worker& self,
+                                   FiberSlot& to,
+                                   AfterSwitch action,
+                                   JobCounter* counter)
+{
+    FiberSlot* from = self.currentFiber;
+    TraceInstant(&self, JobTraceType::FiberSwitch, static_cast<uint64>(action));
+    self.pending = {action, from, counter};
+    self.currentFiber = &to;
+    from->fiber->SwitchTo(*to.fiber);
+
+    // Resumed, maybe on another thread
+    FinishSwitch();
+}
+
+void JobSystem::State::FinishSwitch()
+{
+    Worker* self = CurrentWorker();
+    const PendingSwitch pending = self->pending;
+    self->pending = {};
+
+    FiberSlot* current = self->currentFiber;
+    SetScratchArena(current != &self->threadFiber ? &current->scratch : self->scratch.Get());
+    if (current != &self->threadFiber)
+    {
+        RSBL_PROFILE_FIBER_ENTER(current->profileName);
+    }
+    else
+    {
+        RSBL_PROFILE_FIBER_LEAVE();
+    }
+
+    switch (pending.action)
+    {
+    case AfterSwitch::Nothing:
+        break;
+    case AfterSwitch::Release:
+    {
+        const bool pushed = freeFibers.TryPush(pending.fiber);
+        rsblAssert(pushed);
+        break;
+    }
+    case AfterSwitch::Park:
+    {
+        QueuedJob* resume = jobPool.New(Job(), nullptr, pending.fiber->priority);
+        if (resume == nullptr)
+        {
+            // No room to wait as a continuation, so it goes straight back in line and checks
+            // the counter again when it's resumed
+            const bool pushed =
+                readyFibers[static_cast<uint32>(pending.fiber->priority)].TryPush(pending.fiber);
+            rsblAssert(pushed);
+            WakeAll();
+            break;
+        }
+        resume->parked = pending.fiber;
+
+        // Held open while registering, like SubmitAfter
+        pending.counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+        PushContinuations(pending.counter, resume);
+        Finish(pending.counter);
+        break;
+    }
+    }
+}
+
+void JobSystem::State::FiberEntry(void* state)
+{
+    static_cast<State*>(state)->FiberMain();
+}
+
+void JobSystem::State::FiberMain()
+{
+    FinishSwitch();
+
+    uint32 idle_rounds = 0;
+    for (;;)
+    {
+        Worker* self = CurrentWorker();
+        SuspendWhileHeldBack(self);
+        FiberSlot* resume = nullptr;
+        if (QueuedJob* queued = FindJob(self, &resume))
+        {
+            self->currentFiber->priority = queued->priority;
+            Run(queued);
+            idle_rounds = 0;
+        }
+        else if (resume != nullptr)
+        {
+            // This fiber goes back to the pool, and picks up from here when it's next used
+            SwitchFiber(*self, *resume, AfterSwitch::Release, nullptr);
+            idle_rounds = 0;
+        }
+        else if (!running.load(std::memory_order_acquire))
+        {
+            SwitchFiber(*self, self->threadFiber, AfterSwitch::Release, nullptr);
+        }
+        else if (++idle_rounds < kSpinRounds)
+        {
+            Thread::SpinPause();
+        }
+        else
+        {
+            Sleep(self, nullptr);
+            idle_rounds = 0;
+        }
+    }
+}
+
+Result<> JobSystem::State::WorkerMain(Worker& self)
+{
+    s_currentWorker = &self;
+    SetScratchArena(self.scratch.Get());
+
+    if (!fibers.IsEmpty())
+    {
+        Result<UniquePtr<Fiber>> thread_fiber = Fiber::FromCurrentThread();
+        FiberSlot* first = nullptr;
+        if (thread_fiber && freeFibers.TryPop(first))
+        {
+            self.threadFiber.fiber = rsblMove(thread_fiber.Value());
+            self.currentFiber = &self.threadFiber;
+
+            // Comes back here once the pool fiber sees shutdown
+            SwitchFiber(self, *first, AfterSwitch::Nothing, nullptr);
+
+            self.currentFiber = nullptr;
+            self.threadFiber.fiber.Reset();
+            SetScratchArena(nullptr);
+            s_currentWorker = nullptr;
+            return ResultCode::Success;
+        }
+        // Without a fiber of its own this worker runs jobs plainly, they can still park on
+        // the others
+    }
+
+    // Keeps going until shutdown finds nothing left queued, so fire-and-forget jobs still run
+    uint32 idle_rounds = 0;
+    for (;;)
+    {
+        SuspendWhileHeldBack(&self);
+        if (QueuedJob* queued = FindJob(&self))
+        {
+            Run(queued);
+            idle_rounds = 0;
+        }
+        else if (!running.load(std::memory_order_acquire))
+        {
+            break;
+        }
+        else if (++idle_rounds < kSpinRounds)
+        {
+            Thread::SpinPause();
+        }
+        else
+        {
+            Sleep(&self, nullptr);
+            idle_rounds = 0;
+        }
+    }
+
+    SetScratchArena(nullptr);
+    s_currentWorker = nullptr;
+    return ResultCode::Success;
+}
+
+Result<UniquePtr<JobSystem>> JobSystem::Create(const JobSystemOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Jobs);
+
+    uint32 worker_count = options.workerCount;
+    if (worker_count == 0)
+    {
+        const uint32 core_count = static_cast<uint32>(GetCpuTopology().cores.Size());
+        worker_count = core_count > 1 ? core_count - 1 : 1;
+    }
+    if (options.highPriorityWorkers >= worker_count)
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "%u high priority workers leave none of %u for other jobs",
+                             options.highPriorityWorkers,
+                             worker_count);
+    }
+
+    if (options.useFibers && options.fiberCount < worker_count)
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "%u fibers aren't enough for %u workers",
+                             options.fiberCount,
+                             worker_count);
+    }
+
+    UniquePtr<JobSystem> system(new JobSystem());
+    system->m_state = new State(options, worker_count);
+
+    // The State is complete before any worker starts, every worker can steal from every other
+    State* state = system->m_state;
+    if (options.traceEventsPerWorker > 0)
+    {
+        for (const UniquePtr<State::Worker>& worker : state->workers)
+        {
+            worker->trace =
+                MakeUnique<JobTraceRing>(options.traceEventsPerWorker, state->allocator);
+        }
+        state->outsideTrace =
+            MakeUnique<JobTraceRing>(options.traceEventsPerWorker, state->allocator);
+        state->gpuTrace = MakeUnique<JobTraceRing>(options.traceEventsPerWorker, state->allocator);
+    }
+    if (options.useFibers)
+    {
+        state->fibers.Reserve(options.fiberCount);
+        for (uint32 i = 0; i < options.fiberCount; ++i)
+        {
+            Result<UniquePtr<Fiber>> fiber =
+                Fiber::Create(options.fiberStackSize, &State::FiberEntry, state);
+            if (!fiber)
+            {
+                return fiber.FailureText();
+            }
+            UniquePtr<FiberSlot> slot = MakeUnique<FiberSlot>();
+            slot->fiber = rsblMove(fiber.Value());
+            snprintf(slot->profileName, sizeof(slot->profileName), "rsbl-job-fiber-%u", i);
+            state->freeFibers.TryPush(slot.Get());
+            state->fibers.PushBack(rsblMove(slot));
+        }
+    }
+    for (const UniquePtr<State::Worker>& worker : state->workers)
+    {
+        State::Worker* self = worker.Get();
+        snprintf(self->name, sizeof(self->name), "rsbl-job-%u", self->index);
+        ThreadCreateInfo info;
+        info.name = self->name;
+        info.affinityMask = self->affinityMask;
+        Result<UniquePtr<Thread>> thread = Thread::Create(
+            info, [state, self]() -> Result<> { return state->WorkerMain(*self); });
+        if (!thread)
+        {
+            // The destructor stops the workers that did start
+            return thread.FailureText();
+        }
+        state->threads.PushBack(rsblMove(thread.Value()));
+    }
+
+    return rsblMove(system);
+}
+
+JobSystem::~JobSystem()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+
+    m_state->running.store(false, std::memory_order_seq_cst);
+    m_state->WakeAll();
+    for (UniquePtr<Thread>& thread : m_state->threads)
+    {
+        const Result<> joined = thread->Join();
+        rsblAssert(joined);
+    }
+
+    // Only jobs submitted after shutdown started could still be queued, and by now there's
+    // nobody left to run them
+    rsblAssertMsg(!m_state->HasQueuedWork(kPriorityCount, true),
+                  "Jobs submitted while the JobSystem shut down");
+    delete m_state;
+}
+
+void JobSystem::Submit(Job&& job, JobCounter* counter, JobPriority priority)
+{
+    if (counter != nullptr)
+    {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    QueuedJob* queued = m_state->jobPool.New(rsblMove(job), counter, priority);
+    if (queued == nullptr)
+    {
+        // The pool couldn't grow, New leaves the job alone then
+        job();
+        if (counter != nullptr)
+        {
+            m_state->Finish(counter);
+        }
+        return;
+    }
+    m_state->Enqueue(queued);
+}
+
+void JobSystem::SubmitAfter(JobCounter& dependency,
+                            Job&& job,
+                            JobCounter* counter,
+                            JobPriority priority)
+{
+    if (counter != nullptr)
+    {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    QueuedJob* queued = m_state->jobPool.New(rsblMove(job), counter, priority);
+    if (queued == nullptr)
+    {
+        Wait(dependency);
+        job();
+        if (counter != nullptr)
+        {
+            m_state->Finish(counter);
+        }
+        return;
+    }
+
+    // Hold the dependency open while registering, then let go. If everything else finished in
+    // the meantime, letting go is what queues the continuation.
+    dependency.m_pending.fetch_add(1, std::memory_order_relaxed);
+    m_state->PushContinuations(&dependency, queued);
+    m_state->Finish(&dependency);
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    if (counter.IsDone())
+    {
+        return;
+    }
+
+    RSBL_PROFILE_ZONE("JobSystem::Wait");
+    State::Worker* self = m_state->CurrentWorker();
+    uint64 trace_start = m_state->TraceNow();
+    uint32 idle_rounds = 0;
+    while (!counter.IsDone())
+    {
+        if (m_state->CanPark(self) && m_state->Park(*self, counter, trace_start))
+        {
+            // Resumed, likely on another worker
+            self = m_state->CurrentWorker();
+            idle_rounds = 0;
+        }
+        else if (QueuedJob* queued = m_state->FindJob(self))
+        {
+            m_state->Run(queued);
+            idle_rounds = 0;
+        }
+        else if (++idle_rounds < kSpinRounds)
+        {
+            Thread::SpinPause();
+        }
+        else
+        {
+            m_state->Sleep(self, &counter);
+            idle_rounds = 0;
+        }
+    }
+
+    if (trace_start != 0)
+    {
+        // Only the address, the counter may be gone already
+        const uint64 counter_address = reinterpret_cast<uintptr_t>(&counter);
+        const JobPriority priority =
+            self != nullptr && self->currentFiber != nullptr ? self->currentFiber->priority
+                                                             : JobPriority::Medium;
+        m_state->TraceSlice(self, JobTraceType::Wait, trace_start, counter_address, priority);
+    }
+}
+
+void JobSystem::ParallelFor(uint64 begin,
+                            uint64 end,
+                            uint64 grain,
+                            FunctionRef<void(uint64, uint64)> body,
+                            JobPriority priority)
+{
+    rsblAssert(grain > 0);
+
+    while (begin < end)
+    {
+        if (end - begin > grain && ShouldSplit(priority))
+        {
+            // Someone takes the upper half while this thread carries on with the lower one
+            const uint64 middle = begin + (end - begin) / 2;
+            JobCounter counter;
+            Submit(
+                [this, middle, end, grain, body, priority]() {
+                    ParallelFor(middle, end, grain, body, priority);
+                },
+                &counter,
+                priority);
+            ParallelFor(begin, middle, grain, body, priority);
+            Wait(counter);
+            return;
+        }
+
+        const uint64 chunk_end = end - begin > grain ? begin + grain : end;
+        body(begin, chunk_end);
+        begin = chunk_end;
+    }
+}
+
+bool JobSystem::ShouldSplit(JobPriority priority) const
+{
+    const uint32 lane = static_cast<uint32>(priority);
+    const State::Worker* self = m_state->CurrentWorker();
+    return self != nullptr ? self->deques[lane].IsEmptyApprox()
+                           : m_state->injected[lane].IsEmptyApprox();
+}
+
+uint32 JobSystem::WorkerCount() const
+{
+    return static_cast<uint32>(m_state->workers.Size());
+}
+
+void JobSystem::SetActiveWorkerLimit(uint32 limit)
+{
+    const uint32 general = WorkerCount() - m_state->highPriorityWorkers;
+    limit = limit < 1 ? 1 : limit;
+    limit = limit > general ? general : limit;
+    if (m_state->activeWorkerLimit.exchange(limit, std::memory_order_seq_cst) == limit)
+    {
+        return;
+    }
+
+    // Whoever the new limit lets go, the rest go back to sleep
+    State::SleepGroup& group = m_state->sleepGroups[kSuspendedGroup];
+    group.epoch.fetch_add(1, std::memory_order_seq_cst);
+    group.epoch.notify_all();
+}
+
+uint32 JobSystem::ActiveWorkerLimit() const
+{
+    const uint32 general = WorkerCount() - m_state->highPriorityWorkers;
+    const uint32 limit = m_state->activeWorkerLimit.load(std::memory_order_relaxed);
+    return limit < general ? limit : general;
+}
+
+Result<> JobSystem::StartTrace()
+{
+    if (!m_state->outsideTrace)
+    {
+        return {ErrorCategory::InvalidArgument,
+                "The JobSystem was created without trace rings, see traceEventsPerWorker"};
+    }
+
+    // Stops first so nobody's writing while the rings are cleared. A worker that read the flag
+    // just before can still get one last event in, which is harmless.
+    m_state->tracing.store(false, std::memory_order_relaxed);
+    for (const UniquePtr<State::Worker>& worker : m_state->workers)
+    {
+        worker->trace->Clear();
+    }
+    {
+        LockGuard<SpinLock> lock(m_state->outsideTraceLock);
+        m_state->outsideTrace->Clear();
+    }
+    {
+        LockGuard<SpinLock> lock(m_state->gpuTraceLock);
+        m_state->gpuTrace->Clear();
+    }
+    m_state->traceStartTicks = Clock::NowTicks();
+    m_state->tracing.store(true, std::memory_order_release);
+    return ResultCode::Success;
+}
+
+void JobSystem::StopTrace()
+{
+    m_state->tracing.store(false, std::memory_order_release);
+}
+
+void JobSystem::TraceRegion(const char* name, uint64 startTicks)
+{
+    if (!m_state->tracing.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    m_state->TraceSlice(m_state->CurrentWorker(),
+                        JobTraceType::Region,
+                        startTicks,
+                        reinterpret_cast<uint64>(name),
+                        JobPriority::Medium);
+}
+
+void JobSystem::TraceCounter(const char* name, uint64 value)
+{
+    if (!m_state->tracing.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    JobTraceEvent event;
+    event.start = Clock::NowTicks();
+    event.end = value;
+    event.arg = reinterpret_cast<uint64>(name);
+    event.type = JobTraceType::Counter;
+    m_state->Trace(m_state->CurrentWorker(), event);
+}
+
+void JobSystem::TraceGpuZone(const char* name, uint64 startTicks, uint64 endTicks)
+{
+    if (!m_state->tracing.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    JobTraceEvent event;
+    event.start = startTicks;
+    event.end = endTicks;
+    event.arg = reinterpret_cast<uint64>(name);
+    event.type = JobTraceType::Region;
+    LockGuard<SpinLock> lock(m_state->gpuTraceLock);
+    m_state->gpuTrace->Record(event);
+}
+
+void JobSystem::BuildChromeTrace(String& json) const
+{
+    DynamicArray<Internal::JobTraceTrack> tracks;
+    if (m_state->outsideTrace)
+    {
+        for (const UniquePtr<State::Worker>& worker : m_state->workers)
+        {
+            tracks.PushBack({worker->trace.Get(), worker->index, worker->name});
+        }
+        tracks.PushBack({m_state->outsideTrace.Get(), 0, nullptr});
+        // A tid no worker index or thread id is likely to be
+        tracks.PushBack({m_state->gpuTrace.Get(), ~0u, "GPU"});
+    }
+    Internal::BuildChromeTraceJson(
+        tracks.Data(), static_cast<uint32>(tracks.Size()), m_state->traceStartTicks, json);
+}
+
+Result<> JobSystem::WriteChromeTrace(const char* path) const
+{
+    String json;
+    BuildChromeTrace(json);
+
+    Result<FileHandle> file = OpenFile(path, FileOpenMode::Write);
+    if (!file)
+    {
+        return file.FailureText();
+    }
+    Result<uint64> written = WriteFile(file.Value(), AsBytes(json.Data(), json.Size()));
+    Result<> closed = CloseFile(file.Value());
+    if (!written)
+    {
+        return {written.Category(), written.FailureText()};
+    }
+    return closed;
+}
+
+} // namespace rsbl
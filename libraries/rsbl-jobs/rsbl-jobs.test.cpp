@@ -0,0 +1,774 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-jobs.h"
+
+#include <rsbl-clock.h>
+#include <rsbl-cpu-topology.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-string.h>
+#include <rsbl-thread-local.h>
+#include <rsbl-thread.h>
+
+#include <atomic>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+UniquePtr<JobSystem> MakeJobSystem(uint32 workerCount, uint32 queueCapacity = 4096)
+{
+    JobSystemOptions options;
+    options.workerCount = workerCount;
+    options.queueCapacity = queueCapacity;
+    Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+    REQUIRE(result);
+    return rsblMove(result.Value());
+}
+
+// Splits [begin, end) in half until it's small, summing the leaves from the jobs
+void SumRange(JobSystem& jobs, uint64 begin, uint64 end, std::atomic<uint64>& sum)
+{
+    if (end - begin <= 64)
+    {
+        uint64 local_sum = 0;
+        for (uint64 i = begin; i < end; ++i)
+        {
+            local_sum += i;
+        }
+        sum.fetch_add(local_sum, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint64 middle = begin + (end - begin) / 2;
+    JobCounter counter;
+    jobs.Submit([&jobs, begin, middle, &sum]() { SumRange(jobs, begin, middle, sum); }, &counter);
+    jobs.Submit([&jobs, middle, end, &sum]() { SumRange(jobs, middle, end, sum); }, &counter);
+    jobs.Wait(counter);
+}
+} // namespace
+
+TEST_SUITE("rsbl::JobSystem")
+{
+    TEST_CASE("Defaults to a worker per physical core, less the caller's")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(0);
+        const uint32 core_count = static_cast<uint32>(GetCpuTopology().cores.Size());
+        CHECK(jobs->WorkerCount() == (core_count > 1 ? core_count - 1 : 1));
+    }
+
+    TEST_CASE("Pinned workers still run everything")
+    {
+        JobSystemOptions options;
+        options.workerCount = 3;
+        options.pinWorkers = true;
+        Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        REQUIRE(result);
+        UniquePtr<JobSystem> jobs = rsblMove(result.Value());
+
+        std::atomic<uint64> sum{0};
+        JobCounter counter;
+        jobs->Submit([&jobs, &sum]() { SumRange(*jobs, 0, 100000, sum); }, &counter);
+        jobs->Wait(counter);
+        CHECK(sum.load() == 100000ull * 99999 / 2);
+    }
+
+    TEST_CASE("Wait returns once every job has run")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(4);
+
+        DynamicArray<uint32> ran;
+        ran.Resize(10000);
+        JobCounter counter;
+        for (uint32 i = 0; i < ran.Size(); ++i)
+        {
+            jobs->Submit([&ran, i]() { ran[i]++; }, &counter);
+        }
+        jobs->Wait(counter);
+
+        CHECK(counter.IsDone());
+        uint32 wrong = 0;
+        for (const uint32 count : ran)
+        {
+            wrong += count != 1 ? 1 : 0;
+        }
+        CHECK(wrong == 0);
+    }
+
+    TEST_CASE("Waiting on a counter with nothing pending returns right away")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(1);
+        JobCounter counter;
+        jobs->Wait(counter);
+        CHECK(counter.IsDone());
+    }
+
+    TEST_CASE("A counter can be reused")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        std::atomic<uint32> total{0};
+        JobCounter counter;
+        for (uint32 round = 0; round < 100; ++round)
+        {
+            for (uint32 i = 0; i < 10; ++i)
+            {
+                jobs->Submit([&total]() { total.fetch_add(1, std::memory_order_relaxed); },
+                             &counter);
+            }
+            jobs->Wait(counter);
+            REQUIRE(total.load() == (round + 1) * 10);
+        }
+    }
+
+    TEST_CASE("Jobs can submit and wait on their own jobs")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(3);
+        std::atomic<uint64> sum{0};
+        JobCounter counter;
+        jobs->Submit([&jobs, &sum]() { SumRange(*jobs, 0, 100000, sum); }, &counter);
+        jobs->Wait(counter);
+        CHECK(sum.load() == 100000ull * 99999 / 2);
+    }
+
+    TEST_CASE("Full queues run the job on the submitting thread")
+    {
+        // Nothing gets lost or run twice when most submits overflow
+        UniquePtr<JobSystem> jobs = MakeJobSystem(1, 2);
+        std::atomic<uint32> ran{0};
+        JobCounter counter;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            jobs->Submit([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+        }
+        jobs->Wait(counter);
+        CHECK(ran.load() == 1000);
+    }
+
+    TEST_CASE("Captures too big for the buffer still run")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        uint64 values[16] = {};
+        for (uint64 i = 0; i < 16; ++i)
+        {
+            values[i] = i + 1;
+        }
+
+        std::atomic<uint64> sum{0};
+        JobCounter counter;
+        for (uint32 i = 0; i < 100; ++i)
+        {
+            jobs->Submit(
+                [values, &sum]() {
+                    uint64 local_sum = 0;
+                    for (const uint64 value : values)
+                    {
+                        local_sum += value;
+                    }
+                    sum.fetch_add(local_sum, std::memory_order_relaxed);
+                },
+                &counter);
+        }
+        jobs->Wait(counter);
+        CHECK(sum.load() == 100 * 136);
+    }
+
+    TEST_CASE("Jobs without a counter still run before shutdown")
+    {
+        std::atomic<uint32> ran{0};
+        {
+            UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+            for (uint32 i = 0; i < 1000; ++i)
+            {
+                jobs->Submit([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); });
+            }
+        }
+        CHECK(ran.load() == 1000);
+    }
+
+    TEST_CASE("Submitting from many threads at once")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        std::atomic<uint32> ran{0};
+
+        DynamicArray<UniquePtr<Thread>> submitters;
+        for (uint32 t = 0; t < 4; ++t)
+        {
+            auto result = Thread::Create([&jobs, &ran]() -> Result<> {
+                JobCounter counter;
+                for (uint32 i = 0; i < 2000; ++i)
+                {
+                    jobs->Submit([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); },
+                                 &counter);
+                }
+                jobs->Wait(counter);
+                return ResultCode::Success;
+            });
+            REQUIRE(result);
+            submitters.PushBack(rsblMove(result.Value()));
+        }
+        for (UniquePtr<Thread>& thread : submitters)
+        {
+            CHECK(thread->Join());
+        }
+        CHECK(ran.load() == 8000);
+    }
+
+    TEST_CASE("ParallelFor covers every index once")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(3);
+        for (const uint64 count : {0ull, 1ull, 63ull, 64ull, 65ull, 10000ull})
+        {
+            CAPTURE(count);
+            DynamicArray<uint32> hits;
+            hits.Resize(count);
+            jobs->ParallelFor(0, count, 64, [&hits](uint64 begin, uint64 end) {
+                for (uint64 i = begin; i < end; ++i)
+                {
+                    hits[i]++;
+                }
+            });
+
+            uint32 wrong = 0;
+            for (const uint32 hit : hits)
+            {
+                wrong += hit != 1 ? 1 : 0;
+            }
+            CHECK(wrong == 0);
+        }
+    }
+
+    TEST_CASE("ParallelFor chunks are never bigger than the grain")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(3);
+        std::atomic<uint64> covered{0};
+        std::atomic<uint32> oversized{0};
+        jobs->ParallelFor(100, 10100, 7, [&](uint64 begin, uint64 end) {
+            covered.fetch_add(end - begin);
+            oversized.fetch_add(end - begin > 7 || begin < 100 || end > 10100 ? 1 : 0);
+        });
+        CHECK(covered.load() == 10000);
+        CHECK(oversized.load() == 0);
+    }
+
+    TEST_CASE("ParallelReduce combines in index order")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(3);
+
+        // Summing is order independent, but a min/max pair of the chunks seen isn't if they're
+        // combined out of order
+        struct Span
+        {
+            uint64 first = ~0ull;
+            uint64 last = 0;
+            bool ordered = true;
+        };
+        const Span span = jobs->ParallelReduce(
+            0,
+            100000,
+            100,
+            Span(),
+            [](uint64 begin, uint64 end) { return Span{begin, end, true}; },
+            [](const Span& a, const Span& b) {
+                if (a.first == ~0ull)
+                {
+                    return b;
+                }
+                if (b.first == ~0ull)
+                {
+                    return a;
+                }
+                return Span{a.first, b.last, a.ordered && b.ordered && a.last == b.first};
+            });
+        CHECK(span.first == 0);
+        CHECK(span.last == 100000);
+        CHECK(span.ordered);
+
+        const uint64 sum = jobs->ParallelReduce(
+            0,
+            100000,
+            64,
+            0ull,
+            [](uint64 begin, uint64 end) {
+                uint64 partial = 0;
+                for (uint64 i = begin; i < end; ++i)
+                {
+                    partial += i;
+                }
+                return partial;
+            },
+            [](uint64 a, uint64 b) { return a + b; });
+        CHECK(sum == 100000ull * 99999 / 2);
+    }
+
+    TEST_CASE("A loop within one grain runs on the caller")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        const uint64 caller = Thread::GetCurrentThreadId();
+        uint64 ran_on = 0;
+        jobs->ParallelFor(
+            0, 50, 64, [&ran_on](uint64, uint64) { ran_on = Thread::GetCurrentThreadId(); });
+        CHECK(ran_on == caller);
+    }
+
+    TEST_CASE("A continuation runs after everything it depends on")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(3);
+        for (uint32 round = 0; round < 50; ++round)
+        {
+            std::atomic<uint32> ran{0};
+            std::atomic<uint32> seen{~0u};
+            JobCounter dependency;
+            JobCounter done;
+            for (uint32 i = 0; i < 100; ++i)
+            {
+                jobs->Submit([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); },
+                             &dependency);
+            }
+            jobs->SubmitAfter(
+                dependency, [&ran, &seen]() { seen.store(ran.load()); }, &done);
+            jobs->Wait(done);
+            REQUIRE(seen.load() == 100);
+        }
+    }
+
+    TEST_CASE("A continuation on a finished counter runs right away")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(1);
+        JobCounter dependency;
+        JobCounter done;
+        std::atomic<bool> ran{false};
+        jobs->SubmitAfter(dependency, [&ran]() { ran.store(true); }, &done);
+        jobs->Wait(done);
+        CHECK(ran.load());
+        CHECK(dependency.IsDone());
+    }
+
+    TEST_CASE("Continuations chain, and each counter can have several")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+
+        // first -> (a, b) -> c, with c waiting on a counter a and b both count against
+        std::atomic<uint32> order{0};
+        uint32 first_at = 0, a_at = 0, b_at = 0, c_at = 0;
+        JobCounter first;
+        JobCounter middle;
+        JobCounter done;
+        jobs->Submit([&]() { first_at = order.fetch_add(1); }, &first);
+        jobs->SubmitAfter(first, [&]() { a_at = order.fetch_add(1); }, &middle);
+        jobs->SubmitAfter(first, [&]() { b_at = order.fetch_add(1); }, &middle);
+        jobs->SubmitAfter(middle, [&]() { c_at = order.fetch_add(1); }, &done);
+        jobs->Wait(done);
+
+        CHECK(first_at == 0);
+        CHECK(a_at > first_at);
+        CHECK(b_at > first_at);
+        CHECK(c_at == 3);
+    }
+
+    TEST_CASE("Racing continuations onto a counter that's finishing")
+    {
+        // Jobs finish while other threads register continuations on the same counter, none of
+        // them may be lost or run early
+        UniquePtr<JobSystem> jobs = MakeJobSystem(3);
+        std::atomic<uint32> continuations{0};
+        JobCounter done;
+        for (uint32 round = 0; round < 200; ++round)
+        {
+            JobCounter dependency;
+            std::atomic<uint32> ran{0};
+            std::atomic<uint32> early{0};
+            for (uint32 i = 0; i < 8; ++i)
+            {
+                jobs->Submit([&ran]() { ran.fetch_add(1, std::memory_order_relaxed); },
+                             &dependency);
+                jobs->SubmitAfter(
+                    dependency,
+                    [&ran, &early, &continuations]() {
+                        early.fetch_add(ran.load() == 0 ? 1 : 0);
+                        continuations.fetch_add(1);
+                    },
+                    &done);
+            }
+            jobs->Wait(done);
+            REQUIRE(early.load() == 0);
+        }
+        CHECK(continuations.load() == 200 * 8);
+    }
+
+    TEST_CASE("Higher priority jobs go first")
+    {
+        // One worker, held up while every job gets queued, so the order it picks them in is all
+        // down to priority
+        UniquePtr<JobSystem> jobs = MakeJobSystem(1);
+        std::atomic<bool> started{false};
+        std::atomic<bool> gate{false};
+        JobCounter counter;
+        jobs->Submit(
+            [&started, &gate]() {
+                started.store(true);
+                while (!gate.load())
+                {
+                    Thread::ThreadYield();
+                }
+            },
+            &counter, JobPriority::High);
+        // Let the worker take the gate before anything else is queued
+        while (!started.load())
+        {
+            Thread::ThreadYield();
+        }
+
+        std::atomic<uint32> next{0};
+        uint32 tickets[3][20];
+        for (uint32 i = 0; i < 20; ++i)
+        {
+            for (const JobPriority priority : {JobPriority::Low, JobPriority::Medium,
+                                               JobPriority::High})
+            {
+                uint32* ticket = &tickets[static_cast<uint32>(priority)][i];
+                jobs->Submit([&next, ticket]() { *ticket = next.fetch_add(1); }, &counter,
+                             priority);
+            }
+        }
+        gate.store(true);
+
+        // Not Wait, which would run jobs on this thread too
+        while (!counter.IsDone())
+        {
+            Thread::ThreadYield();
+        }
+        for (uint32 i = 0; i < 20; ++i)
+        {
+            CHECK(tickets[0][i] < 20);
+            CHECK(tickets[1][i] >= 20);
+            CHECK(tickets[1][i] < 40);
+            CHECK(tickets[2][i] >= 40);
+        }
+    }
+
+    TEST_CASE("High priority workers keep to high priority jobs")
+    {
+        JobSystemOptions options;
+        options.workerCount = 2;
+        options.highPriorityWorkers = 1;
+        Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        REQUIRE(result);
+        UniquePtr<JobSystem> jobs = rsblMove(result.Value());
+
+        // Only the general worker can take this, and it holds on to it
+        std::atomic<bool> gate{false};
+        JobCounter gated;
+        jobs->Submit(
+            [&gate]() {
+                while (!gate.load())
+                {
+                    Thread::ThreadYield();
+                }
+            },
+            &gated, JobPriority::Low);
+
+        // Background work stays queued...
+        std::atomic<uint32> background{0};
+        JobCounter background_done;
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            jobs->Submit([&background]() { background.fetch_add(1); }, &background_done,
+                         JobPriority::Low);
+        }
+
+        // ...while frame work still gets done
+        std::atomic<bool> frame{false};
+        JobCounter frame_done;
+        jobs->Submit([&frame]() { frame.store(true); }, &frame_done, JobPriority::High);
+        while (!frame_done.IsDone())
+        {
+            Thread::ThreadYield();
+        }
+        CHECK(frame.load());
+
+        Thread::ThreadSleep(10);
+        CHECK(background.load() == 0);
+
+        gate.store(true);
+        jobs->Wait(gated);
+        jobs->Wait(background_done);
+        CHECK(background.load() == 10);
+    }
+
+    TEST_CASE("Workers past the active limit hold back until it's raised")
+    {
+        JobSystemOptions options;
+        options.workerCount = 4;
+        options.highPriorityWorkers = 1;
+        Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        REQUIRE(result);
+        UniquePtr<JobSystem> jobs = rsblMove(result.Value());
+        CHECK(jobs->ActiveWorkerLimit() == 3);
+
+        jobs->SetActiveWorkerLimit(0);
+        CHECK(jobs->ActiveWorkerLimit() == 1);
+
+        // Jobs long enough that any other worker free to take one would
+        std::atomic<uint32> running{0};
+        std::atomic<uint32> most_running{0};
+        auto run_batch = [&]() {
+            running.store(0);
+            most_running.store(0);
+            JobCounter counter;
+            for (uint32 i = 0; i < 12; ++i)
+            {
+                jobs->Submit(
+                    [&]() {
+                        const uint32 now = running.fetch_add(1) + 1;
+                        uint32 most = most_running.load();
+                        while (now > most && !most_running.compare_exchange_weak(most, now))
+                        {
+                        }
+                        Thread::ThreadSleep(2);
+                        running.fetch_sub(1);
+                    },
+                    &counter);
+            }
+            // Polled rather than waited on, a Wait would run jobs on this thread too
+            while (!counter.IsDone())
+            {
+                Thread::ThreadYield();
+            }
+        };
+
+        run_batch();
+        CHECK(most_running.load() == 1);
+
+        jobs->SetActiveWorkerLimit(~0u);
+        CHECK(jobs->ActiveWorkerLimit() == 3);
+        run_batch();
+        CHECK(most_running.load() > 1);
+        CHECK(most_running.load() <= 3);
+    }
+
+    TEST_CASE("Reserving every worker for high priority fails")
+    {
+        JobSystemOptions options;
+        options.workerCount = 2;
+        options.highPriorityWorkers = 2;
+        const Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        CHECK_FALSE(result);
+        CHECK(result.Category() == ErrorCategory::InvalidArgument);
+    }
+
+    TEST_CASE("Waiting jobs park on fibers")
+    {
+        JobSystemOptions options;
+        options.workerCount = 3;
+        options.useFibers = true;
+        Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        REQUIRE(result);
+        UniquePtr<JobSystem> jobs = rsblMove(result.Value());
+
+        for (uint32 round = 0; round < 4; ++round)
+        {
+            std::atomic<uint64> sum{0};
+            JobCounter counter;
+            jobs->Submit([&jobs, &sum]() { SumRange(*jobs, 0, 100000, sum); }, &counter);
+            jobs->Wait(counter);
+            CHECK(sum.load() == 100000ull * 99999 / 2);
+        }
+    }
+
+    TEST_CASE("With every fiber parked, waits run jobs in place")
+    {
+        // SumRange nests far deeper than there are fibers
+        JobSystemOptions options;
+        options.workerCount = 2;
+        options.useFibers = true;
+        options.fiberCount = 4;
+        Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        REQUIRE(result);
+        UniquePtr<JobSystem> jobs = rsblMove(result.Value());
+
+        std::atomic<uint64> sum{0};
+        JobCounter counter;
+        jobs->Submit([&jobs, &sum]() { SumRange(*jobs, 0, 100000, sum); }, &counter);
+        jobs->Wait(counter);
+        CHECK(sum.load() == 100000ull * 99999 / 2);
+    }
+
+    TEST_CASE("A parked job resumes after its continuation's dependencies")
+    {
+        JobSystemOptions options;
+        options.workerCount = 2;
+        options.useFibers = true;
+        Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        REQUIRE(result);
+        UniquePtr<JobSystem> jobs = rsblMove(result.Value());
+
+        std::atomic<uint32> children{0};
+        uint32 seen = 0;
+        JobCounter counter;
+        jobs->Submit(
+            [&jobs, &children, &seen]() {
+                JobCounter inner;
+                for (uint32 i = 0; i < 100; ++i)
+                {
+                    jobs->Submit([&children]() { children.fetch_add(1); }, &inner);
+                }
+                jobs->Wait(inner);
+                seen = children.load();
+            },
+            &counter);
+        jobs->Wait(counter);
+        CHECK(seen == 100);
+    }
+
+    TEST_CASE("Fewer fibers than workers fails")
+    {
+        JobSystemOptions options;
+        options.workerCount = 4;
+        options.useFibers = true;
+        options.fiberCount = 3;
+        const Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        CHECK_FALSE(result);
+        CHECK(result.Category() == ErrorCategory::InvalidArgument);
+    }
+
+    TEST_CASE("Scratch memory is handed back after every job")
+    {
+        JobSystemOptions options;
+        options.workerCount = 2;
+        options.useFibers = true;
+        Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        REQUIRE(result);
+        UniquePtr<JobSystem> jobs = rsblMove(result.Value());
+
+        // Each job checks nothing is left from the one before, across a wait that can park it
+        std::atomic<uint32> clean{0};
+        JobCounter counter;
+        for (uint32 i = 0; i < 64; ++i)
+        {
+            jobs->Submit(
+                [&jobs, &clean]() {
+                    LinearArena& arena = GetScratchArena();
+                    const uint64 before = arena.BytesUsed();
+                    uint32* values = arena.AllocateArray<uint32>(1024);
+                    values[0] = 7;
+
+                    JobCounter inner;
+                    jobs->Submit([]() { GetScratchArena().Allocate(256, 16); }, &inner);
+                    jobs->Wait(inner);
+
+                    if (&GetScratchArena() == &arena && values[0] == 7 &&
+                        arena.BytesUsed() == before + 1024 * sizeof(uint32))
+                    {
+                        clean.fetch_add(1, std::memory_order_relaxed);
+                    }
+                },
+                &counter);
+        }
+        jobs->Wait(counter);
+        CHECK(clean.load() == 64);
+    }
+
+    TEST_CASE("Tracing records jobs and waits per worker")
+    {
+        JobSystemOptions options;
+        options.workerCount = 2;
+        options.useFibers = true;
+        options.traceEventsPerWorker = 1024;
+        Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        REQUIRE(result);
+        UniquePtr<JobSystem> jobs = rsblMove(result.Value());
+
+        REQUIRE(jobs->StartTrace());
+        std::atomic<uint64> sum{0};
+        JobCounter counter;
+        jobs->Submit([&jobs, &sum]() { SumRange(*jobs, 0, 10000, sum); }, &counter);
+        jobs->Wait(counter);
+        jobs->StopTrace();
+        CHECK(sum.load() == 10000ull * 9999 / 2);
+
+        String json;
+        jobs->BuildChromeTrace(json);
+        const char* text = json.CStr();
+        CHECK(std::strstr(text, "\"traceEvents\"") != nullptr);
+        CHECK(std::strstr(text, "\"name\":\"rsbl-job-0\"") != nullptr);
+        CHECK(std::strstr(text, "\"name\":\"Job\"") != nullptr);
+        // The outside thread's Wait
+        CHECK(std::strstr(text, "\"name\":\"Wait\"") != nullptr);
+    }
+
+    TEST_CASE("Regions and counters land on the thread that recorded them")
+    {
+        JobSystemOptions options;
+        options.workerCount = 2;
+        options.traceEventsPerWorker = 256;
+        Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        REQUIRE(result);
+        UniquePtr<JobSystem> jobs = rsblMove(result.Value());
+
+        // Not recorded, no capture yet
+        jobs->TraceCounter("Before", 1);
+
+        REQUIRE(jobs->StartTrace());
+        const uint64 start = Clock::NowTicks();
+        JobCounter counter;
+        jobs->Submit(
+            [&jobs]()
+            {
+                const uint64 region_start = Clock::NowTicks();
+                jobs->TraceCounter("Bytes read", 4096);
+                jobs->TraceRegion("Decode", region_start);
+            },
+            &counter);
+        jobs->Wait(counter);
+        jobs->TraceRegion("Outside", start);
+        jobs->StopTrace();
+        jobs->TraceCounter("After", 1);
+
+        String json;
+        jobs->BuildChromeTrace(json);
+        const char* text = json.CStr();
+        CHECK(std::strstr(text, "\"name\":\"Decode\",\"cat\":\"region\",\"ph\":\"X\"") != nullptr);
+        CHECK(std::strstr(text, "\"name\":\"Outside\"") != nullptr);
+        CHECK(std::strstr(text, "\"name\":\"Bytes read\",\"ph\":\"C\"") != nullptr);
+        CHECK(std::strstr(text, "\"value\":4096") != nullptr);
+        CHECK(std::strstr(text, "Before") == nullptr);
+        CHECK(std::strstr(text, "After") == nullptr);
+    }
+
+    TEST_CASE("GPU zones land on a GPU track of their own")
+    {
+        JobSystemOptions options;
+        options.workerCount = 1;
+        options.traceEventsPerWorker = 64;
+        Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+        REQUIRE(result);
+        UniquePtr<JobSystem> jobs = rsblMove(result.Value());
+
+        jobs->TraceGpuZone("Before", 1, 2);
+        REQUIRE(jobs->StartTrace());
+        const uint64 start = Clock::NowTicks();
+        jobs->TraceGpuZone("Shadows", start, start + Clock::TicksPerSecond() / 1000);
+        jobs->StopTrace();
+
+        String json;
+        jobs->BuildChromeTrace(json);
+        const char* text = json.CStr();
+        CHECK(std::strstr(text, "\"tid\":4294967295,\"args\":{\"name\":\"GPU\"}") != nullptr);
+        const char* zone = std::strstr(text, "\"name\":\"Shadows\",\"cat\":\"region\"");
+        REQUIRE(zone != nullptr);
+        const char* zone_end = std::strchr(zone, '}');
+        const char* tid = std::strstr(zone, "\"tid\":4294967295");
+        CHECK((tid != nullptr && tid < zone_end));
+        CHECK(std::strstr(text, "Before") == nullptr);
+    }
+
+    TEST_CASE("Tracing without trace rings fails")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(1);
+        CHECK_FALSE(jobs->StartTrace());
+    }
+}
@@ -0,0 +1,16 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-task.h"
+
+#include <rsbl-file.h>
+
+namespace rsbl
+{
+
+Future<uint64> ReadFileAsync(ThreadPool& pool, const char* path, MutableByteView buffer)
+{
+    return Async<uint64>(pool, [path, buffer]() { return OpenAndReadFile(path, buffer); });
+}
+
+} // namespace rsbl
@@ -0,0 +1,199 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-task.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-file.h>
+#include <rsbl-thread.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+UniquePtr<JobSystem> MakeJobSystem(uint32 workerCount)
+{
+    JobSystemOptions options;
+    options.workerCount = workerCount;
+    Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+    REQUIRE(result);
+    return rsblMove(result.Value());
+}
+
+UniquePtr<ThreadPool> MakeThreadPool()
+{
+    Result<UniquePtr<ThreadPool>> result = ThreadPool::Create();
+    REQUIRE(result);
+    return rsblMove(result.Value());
+}
+
+Task<uint32> Square(uint32 value)
+{
+    co_return value * value;
+}
+
+Task<uint32> SumOfSquares(uint32 count)
+{
+    uint32 sum = 0;
+    for (uint32 i = 1; i <= count; ++i)
+    {
+        Result<uint32> square = co_await Square(i);
+        sum += square.Value();
+    }
+    co_return sum;
+}
+
+Task<uint32> Fails()
+{
+    co_return FailureFormat(ErrorCategory::NotFound, "No asset %u", 7u);
+}
+
+Task<uint32> PassesFailureOn()
+{
+    Result<uint32> value = co_await Fails();
+    if (!value)
+    {
+        co_return {value.Category(), value.FailureText()};
+    }
+    co_return value.Value() + 1;
+}
+
+// Sleeps on an IO thread, then carries on on a job worker
+Task<uint64> WaitForIo(ThreadPool& io, std::atomic<uint64>& resumedOn)
+{
+    Result<uint32> slept = co_await Async<uint32>(io, []() -> Result<uint32> {
+        Thread::ThreadSleep(5);
+        return 42u;
+    });
+    resumedOn.store(Thread::GetCurrentThreadId(), std::memory_order_relaxed);
+    co_return static_cast<uint64>(slept.Value());
+}
+
+Task<> LoadFile(ThreadPool& io, const char* path, MutableByteView buffer, uint64& bytes)
+{
+    Result<uint64> read = co_await ReadFileAsync(io, path, buffer);
+    if (!read)
+    {
+        co_return read.FailureText();
+    }
+    bytes = read.Value();
+    co_return ResultCode::Success;
+}
+} // namespace
+
+TEST_SUITE("rsbl::Task")
+{
+    TEST_CASE("Spawned tasks fill in their future")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        Future<uint32> future = Spawn(*jobs, SumOfSquares(10));
+        Result<uint32> sum = future.Get();
+        REQUIRE(sum);
+        CHECK(sum.Value() == 385);
+    }
+
+    TEST_CASE("Failures come through with their text")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        Result<uint32> value = Spawn(*jobs, PassesFailureOn()).Get();
+        REQUIRE_FALSE(value);
+        CHECK(value.Category() == ErrorCategory::NotFound);
+        CHECK(std::strcmp(value.FailureText(), "No asset 7") == 0);
+    }
+
+    TEST_CASE("Awaiting a future doesn't hold a worker")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(1);
+        UniquePtr<ThreadPool> io = MakeThreadPool();
+
+        // One worker, and several tasks waiting on IO at the same time
+        std::atomic<uint64> resumed_on[4] = {};
+        DynamicArray<Future<uint64>> futures;
+        for (std::atomic<uint64>& resumed : resumed_on)
+        {
+            futures.PushBack(Spawn(*jobs, WaitForIo(*io, resumed)));
+        }
+        for (Future<uint64>& future : futures)
+        {
+            Result<uint64> value = future.Get();
+            REQUIRE(value);
+            CHECK(value.Value() == 42);
+        }
+
+        // Every task carried on on the job worker, not on the IO thread that woke it
+        const uint64 worker = resumed_on[0].load();
+        for (std::atomic<uint64>& resumed : resumed_on)
+        {
+            CHECK(resumed.load() == worker);
+        }
+    }
+
+    TEST_CASE("Promises and futures")
+    {
+        Promise<uint32> promise;
+        Future<uint32> future = promise.GetFuture();
+        CHECK_FALSE(future.IsReady());
+        promise.SetResult(7u);
+        CHECK(future.IsReady());
+        Result<uint32> value = future.Get();
+        REQUIRE(value);
+        CHECK(value.Value() == 7);
+
+        // A dropped promise fails its future rather than leaving it hanging
+        Future<uint32> orphan;
+        {
+            Promise<uint32> dropped;
+            orphan = dropped.GetFuture();
+        }
+        CHECK_FALSE(orphan.Get());
+    }
+
+    TEST_CASE("Reading a file asynchronously")
+    {
+        const char* path = "rsbl-task-test.bin";
+        {
+            Result<FileHandle> file = OpenFile(path, FileOpenMode::Write);
+            REQUIRE(file);
+            REQUIRE(WriteFile(file.Value(), AsBytes("coroutines", 10)));
+            REQUIRE(CloseFile(file.Value()));
+        }
+
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        UniquePtr<ThreadPool> io = MakeThreadPool();
+        char buffer[32] = {};
+        uint64 bytes = 0;
+        Result<> loaded =
+            Spawn(*jobs, LoadFile(*io, path, AsWritableBytes(buffer, sizeof(buffer)), bytes)).Get();
+        REQUIRE(loaded);
+        CHECK(bytes == 10);
+        CHECK(std::memcmp(buffer, "coroutines", 10) == 0);
+
+        Result<> missing =
+            Spawn(*jobs, LoadFile(*io, "rsbl-task-missing.bin", AsWritableBytes(buffer, 1), bytes))
+                .Get();
+        CHECK_FALSE(missing);
+
+        std::remove(path);
+    }
+
+    TEST_CASE("ScheduleOn moves a task to another job system")
+    {
+        UniquePtr<JobSystem> first = MakeJobSystem(1);
+        UniquePtr<JobSystem> second = MakeJobSystem(1);
+
+        auto hop = [](JobSystem& target) -> Task<bool> {
+            const uint64 before = Thread::GetCurrentThreadId();
+            co_await ScheduleOn(target);
+            co_return Thread::GetCurrentThreadId() != before;
+        };
+        Result<bool> moved = Spawn(*first, hop(*second)).Get();
+        REQUIRE(moved);
+        CHECK(moved.Value());
+    }
+}
@@ -0,0 +1,197 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-log.h"
+
+#include "quill/BinaryDataDeferredFormatCodec.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Binary logging, for telemetry logged every frame. RSBL_LOG_BINARY takes the same format strings
+ * as the other macros, but nothing is formatted: the call site's arguments are copied raw through
+ * quill's queue, and the backend writes them to the binary log beside a number for the call site,
+ * whose format string and location go in the file once. Decode with LogBinaryDecode, or the
+ * rsbl-log-decode tool.
+ *
+ *     RSBL_LOG_BINARY("Frame {} took {:.2f}ms, {} draws", frame, ms, draws);
+ *
+ * Arguments can be integers, enums, floats, bools and strings, at most kLogBinaryMaxArgs of them.
+ * Strings past kLogBinaryMaxString bytes are cut short. Calls before LogBinaryInit, or without
+ * it, do nothing.
+ */
+
+namespace rsbl
+{
+
+// The call site's part of a record, one per RSBL_LOG_BINARY
+struct LogBinaryFormat
+{
+    const char* format;
+    const char* file;
+    uint32_t line;
+};
+
+enum class LogBinaryArgType : uint8_t
+{
+    Int,
+    UInt,
+    Double,
+    Bool,
+    String,
+};
+
+struct LogBinaryTag
+{
+};
+using LogBinaryPayload = quill::BinaryData<LogBinaryTag>;
+
+constexpr uint32_t kLogBinaryMaxArgs = 8;
+constexpr uint32_t kLogBinaryMaxString = 96;
+
+/**
+ * @brief Starts writing RSBL_LOG_BINARY records to path, starting the log backend if LogInit
+ * hasn't.
+ *
+ * Only the first call does anything.
+ */
+void LogBinaryInit(const char* path);
+
+/**
+ * @brief Writes a binary log out as text, a line per record with its time in nanoseconds, thread
+ * and location before the formatted message.
+ *
+ * @return false if path isn't a binary log, or ends partway through a record
+ */
+bool LogBinaryDecode(const char* path, FILE* out);
+
+/**
+ * @brief The binary log's logger, null until LogBinaryInit.
+ */
+extern Logger* g_binaryLogger;
+
+namespace Internal
+{
+    // A record's arguments, packed on the calling thread: the call site, a count, then each
+    // argument's type and bytes
+    class LogBinaryRecord
+    {
+      public:
+        template <typename... Args>
+        explicit LogBinaryRecord(const LogBinaryFormat* format, const Args&... args)
+        {
+            static_assert(sizeof...(Args) <= kLogBinaryMaxArgs, "Too many binary log arguments");
+            Put(&format, sizeof(format));
+            const uint8_t count = sizeof...(Args);
+            Put(&count, sizeof(count));
+            (Add(args), ...);
+        }
+
+        LogBinaryPayload Payload() const
+        {
+            return LogBinaryPayload(m_bytes, m_size);
+        }
+
+      private:
+        template <typename T>
+        void Add(const T& value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                AddValue(LogBinaryArgType::Bool, static_cast<uint8_t>(value));
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                Add(static_cast<std::underlying_type_t<T>>(value));
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                AddValue(LogBinaryArgType::Double, static_cast<double>(value));
+            }
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            {
+                AddValue(LogBinaryArgType::Int, static_cast<int64_t>(value));
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                AddValue(LogBinaryArgType::UInt, static_cast<uint64_t>(value));
+            }
+            else
+            {
+                static_assert(std::is_convertible_v<const T&, std::string_view>,
+                              "Binary log arguments are numbers, bools and strings");
+                const std::string_view text(value);
+                const uint16_t size =
+                    static_cast<uint16_t>(std::min<size_t>(text.size(), kLogBinaryMaxString));
+                const LogBinaryArgType type = LogBinaryArgType::String;
+                Put(&type, sizeof(type));
+                Put(&size, sizeof(size));
+                Put(text.data(), size);
+            }
+        }
+
+        template <typename T>
+        void AddValue(LogBinaryArgType type, T value)
+        {
+            Put(&type, sizeof(type));
+            Put(&value, sizeof(value));
+        }
+
+        void Put(const void* data, size_t size)
+        {
+            std::memcpy(m_bytes + m_size, data, size);
+            m_size += size;
+        }
+
+        // Every argument a string at its longest
+        static constexpr size_t kCapacity = sizeof(const LogBinaryFormat*) + 1 +
+                                            kLogBinaryMaxArgs * (1 + 2 + kLogBinaryMaxString);
+
+        uint8_t m_bytes[kCapacity];
+        size_t m_size = 0;
+    };
+} // namespace Internal
+
+} // namespace rsbl
+
+// The payload goes through quill's queue as raw bytes, and comes out of the backend's formatting
+// as the same bytes for the binary sink
+template <>
+struct quill::Codec<rsbl::LogBinaryPayload>
+    : quill::BinaryDataDeferredFormatCodec<rsbl::LogBinaryPayload>
+{
+};
+
+template <>
+struct fmtquill::formatter<rsbl::LogBinaryPayload>
+{
+    constexpr auto parse(format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+
+    auto format(const rsbl::LogBinaryPayload& payload, format_context& ctx) const
+    {
+        const char* bytes = reinterpret_cast<const char*>(payload.data());
+        return std::copy(bytes, bytes + payload.size(), ctx.out());
+    }
+};
+
+#define RSBL_LOG_BINARY(fmt, ...)                                                                  \
+    do                                                                                             \
+    {                                                                                              \
+        static constexpr ::rsbl::LogBinaryFormat rsblBinaryFormat{fmt, __FILE__, __LINE__};        \
+        ::rsbl::Logger* rsblBinaryLogger = ::rsbl::g_binaryLogger;                                 \
+        if (rsblBinaryLogger != nullptr)                                                           \
+        {                                                                                          \
+            const ::rsbl::Internal::LogBinaryRecord rsblBinaryRecord(&rsblBinaryFormat,            \
+                                                                     ##__VA_ARGS__);               \
+            QUILL_LOG_INFO(rsblBinaryLogger, "{}", rsblBinaryRecord.Payload());                    \
+        }                                                                                          \
+    } while (0)
@@ -14,9 +14,71 @@
 #include "quill/LogMacros.h"
 #include "quill/Logger.h"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Each thread that logs gets its own queue to the backend thread. quill only takes the queue's
+ * type and size at compile time, so they come from the RSBL_LOG_QUEUE_TYPE (UnboundedBlocking,
+ * UnboundedDropping, BoundedBlocking or BoundedDropping) and RSBL_LOG_QUEUE_CAPACITY CMake
+ * options. Dropping queues never hold a thread up, blocking ones never lose a message, bounded
+ * ones never allocate after the first message.
+ */
+#ifndef RSBL_LOG_QUEUE_TYPE
+    #define RSBL_LOG_QUEUE_TYPE UnboundedBlocking
+#endif
+
+#ifndef RSBL_LOG_QUEUE_CAPACITY
+    #define RSBL_LOG_QUEUE_CAPACITY (128u * 1024u)
+#endif
+
 namespace rsbl
 {
 
+struct LogFrontendOptions
+{
+    static constexpr quill::QueueType queue_type = quill::QueueType::RSBL_LOG_QUEUE_TYPE;
+    static constexpr size_t initial_queue_capacity = RSBL_LOG_QUEUE_CAPACITY;
+    static constexpr uint32_t blocking_queue_retry_interval_ns = 800;
+    static constexpr size_t unbounded_queue_max_capacity = 2ull * 1024u * 1024u * 1024u;
+    static constexpr quill::HugePagesPolicy huge_pages_policy = quill::HugePagesPolicy::Never;
+};
+
+using Logger = quill::LoggerImpl<LogFrontendOptions>;
+
+// For LogConfig::backendCpu, the OS picks
+constexpr uint16_t kLogAnyCpu = 0xffff;
+
+struct LogConfig
+{
+    // Rotating file sink, none if null
+    const char* filePath = nullptr;
+    size_t rotationBytes = 10 * 1024 * 1024;
+    uint32_t maxBackupFiles = 5;
+
+    // Console sink, worth turning off in shipping builds, writing to a console can be slow
+    bool console = true;
+
+    // Pins the backend thread, which formats and writes everything, to one CPU. Best somewhere
+    // the job workers aren't, see CpuTopology.
+    uint16_t backendCpu = kLogAnyCpu;
+    // How long the backend sleeps once the queues are empty. Longer costs less CPU, and a
+    // little more memory for the messages that queue up in the meantime.
+    uint32_t backendSleepUs = 100;
+    // Yield instead of sleeping, for when the backend has a CPU to itself
+    bool backendYieldWhenIdle = false;
+
+    quill::LogLevel level = quill::LogLevel::Info;
+};
+
+/**
+ * @brief Initialize the rsbl logging system with the sinks and backend thread in config.
+ *
+ * Only the first call does anything, the backend and logger are process wide.
+ */
+void LogInit(const LogConfig& config);
+
 /**
  * @brief Initialize the rsbl logging system with console and rotating file sinks.
  *
@@ -27,22 +89,142 @@ namespace rsbl
  */
 void LogInit(const char* log_file_path);
 
+/**
+ * @brief Allocates the calling thread's log queue now, rather than with its first message.
+ *
+ * For threads that log during frames, call once when they start.
+ */
+void LogPreallocateThread();
+
 /**
  * @brief Global logger instance for convenient logging throughout the application.
  *
- * This logger is initialized by LogInit() and configured with both console
- * and rotating file sinks.
+ * This logger is initialized by LogInit() with the sinks it was configured with.
  */
-extern quill::Logger* g_logger;
+extern Logger* g_logger;
 
 } // namespace rsbl
 
-// Convenience macros that use the global logger to simplify usage
-#define RSBL_LOG_TRACE_L3(fmt, ...) QUILL_LOG_TRACE_L3(rsbl::g_logger, fmt, __VA_ARGS__)
-#define RSBL_LOG_TRACE_L2(fmt, ...) QUILL_LOG_TRACE_L2(rsbl::g_logger, fmt, __VA_ARGS__)
-#define RSBL_LOG_TRACE_L1(fmt, ...) QUILL_LOG_TRACE_L1(rsbl::g_logger, fmt, __VA_ARGS__)
-#define RSBL_LOG_DEBUG(fmt, ...) QUILL_LOG_DEBUG(rsbl::g_logger, fmt, __VA_ARGS__)
-#define RSBL_LOG_INFO(fmt, ...) QUILL_LOG_INFO(rsbl::g_logger, fmt, __VA_ARGS__)
-#define RSBL_LOG_WARNING(fmt, ...) QUILL_LOG_WARNING(rsbl::g_logger, fmt, __VA_ARGS__)
-#define RSBL_LOG_ERROR(fmt, ...) QUILL_LOG_ERROR(rsbl::g_logger, fmt, __VA_ARGS__)
-#define RSBL_LOG_CRITICAL(fmt, ...) QUILL_LOG_CRITICAL(rsbl::g_logger, fmt, __VA_ARGS__)
+// Log levels for RSBL_LOG_MIN_LEVEL, in quill's order
+#define RSBL_LOG_LEVEL_TRACE_L3 0
+#define RSBL_LOG_LEVEL_TRACE_L2 1
+#define RSBL_LOG_LEVEL_TRACE_L1 2
+#define RSBL_LOG_LEVEL_DEBUG 3
+#define RSBL_LOG_LEVEL_INFO 4
+#define RSBL_LOG_LEVEL_WARNING 5
+#define RSBL_LOG_LEVEL_ERROR 6
+#define RSBL_LOG_LEVEL_CRITICAL 7
+
+/**
+ * Levels below RSBL_LOG_MIN_LEVEL are compiled out, the call and its arguments disappear. Set
+ * from the RSBL_LOG_MIN_LEVEL CMake option, which defaults to keeping everything. Levels that are
+ * compiled in still go through the logger's own runtime level.
+ */
+#ifndef RSBL_LOG_MIN_LEVEL
+    #define RSBL_LOG_MIN_LEVEL RSBL_LOG_LEVEL_TRACE_L3
+#endif
+
+namespace rsbl::Internal
+{
+// Takes a compiled out call's arguments, only ever inside sizeof, so they aren't evaluated but
+// still count as used
+template <typename... Args>
+constexpr int LogDiscard(const Args&...)
+{
+    return 0;
+}
+} // namespace rsbl::Internal
+
+#define RSBL_LOG_DISCARD(fmt, ...) ((void)sizeof(::rsbl::Internal::LogDiscard(fmt, ##__VA_ARGS__)))
+
+// Logs the first time it's reached, by any thread, and never again
+#define RSBL_LOG_ONCE_IMPL(log, fmt, ...)                                                          \
+    do                                                                                             \
+    {                                                                                              \
+        static std::atomic<bool> rsblLogged{false};                                                \
+        if (!rsblLogged.load(std::memory_order_relaxed) &&                                         \
+            !rsblLogged.exchange(true, std::memory_order_relaxed))                                 \
+        {                                                                                          \
+            log(fmt, ##__VA_ARGS__);                                                               \
+        }                                                                                          \
+    } while (0)
+
+/**
+ * Convenience macros that use the global logger to simplify usage.
+ *
+ * For hot paths, _EVERY_N logs the first of every n calls, counted per thread, and _ONCE logs
+ * the first call in the process. Both cost a load and a branch when they don't log.
+ */
+#if RSBL_LOG_MIN_LEVEL <= RSBL_LOG_LEVEL_TRACE_L3
+    #define RSBL_LOG_TRACE_L3(fmt, ...) QUILL_LOG_TRACE_L3(rsbl::g_logger, fmt, ##__VA_ARGS__)
+#else
+    #define RSBL_LOG_TRACE_L3(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#if RSBL_LOG_MIN_LEVEL <= RSBL_LOG_LEVEL_TRACE_L2
+    #define RSBL_LOG_TRACE_L2(fmt, ...) QUILL_LOG_TRACE_L2(rsbl::g_logger, fmt, ##__VA_ARGS__)
+#else
+    #define RSBL_LOG_TRACE_L2(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#if RSBL_LOG_MIN_LEVEL <= RSBL_LOG_LEVEL_TRACE_L1
+    #define RSBL_LOG_TRACE_L1(fmt, ...) QUILL_LOG_TRACE_L1(rsbl::g_logger, fmt, ##__VA_ARGS__)
+#else
+    #define RSBL_LOG_TRACE_L1(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#if RSBL_LOG_MIN_LEVEL <= RSBL_LOG_LEVEL_DEBUG
+    #define RSBL_LOG_DEBUG(fmt, ...) QUILL_LOG_DEBUG(rsbl::g_logger, fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_DEBUG_EVERY_N(n, fmt, ...)                                                    \
+        QUILL_LOG_DEBUG_LIMIT_EVERY_N(n, rsbl::g_logger, fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_DEBUG_ONCE(fmt, ...) RSBL_LOG_ONCE_IMPL(RSBL_LOG_DEBUG, fmt, ##__VA_ARGS__)
+#else
+    #define RSBL_LOG_DEBUG(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_DEBUG_EVERY_N(n, fmt, ...) ((void)(n), RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__))
+    #define RSBL_LOG_DEBUG_ONCE(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#if RSBL_LOG_MIN_LEVEL <= RSBL_LOG_LEVEL_INFO
+    #define RSBL_LOG_INFO(fmt, ...) QUILL_LOG_INFO(rsbl::g_logger, fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_INFO_EVERY_N(n, fmt, ...)                                                     \
+        QUILL_LOG_INFO_LIMIT_EVERY_N(n, rsbl::g_logger, fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_INFO_ONCE(fmt, ...) RSBL_LOG_ONCE_IMPL(RSBL_LOG_INFO, fmt, ##__VA_ARGS__)
+#else
+    #define RSBL_LOG_INFO(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_INFO_EVERY_N(n, fmt, ...) ((void)(n), RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__))
+    #define RSBL_LOG_INFO_ONCE(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#if RSBL_LOG_MIN_LEVEL <= RSBL_LOG_LEVEL_WARNING
+    #define RSBL_LOG_WARNING(fmt, ...) QUILL_LOG_WARNING(rsbl::g_logger, fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_WARNING_EVERY_N(n, fmt, ...)                                                  \
+        QUILL_LOG_WARNING_LIMIT_EVERY_N(n, rsbl::g_logger, fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_WARNING_ONCE(fmt, ...) RSBL_LOG_ONCE_IMPL(RSBL_LOG_WARNING, fmt, ##__VA_ARGS__)
+#else
+    #define RSBL_LOG_WARNING(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_WARNING_EVERY_N(n, fmt, ...) ((void)(n), RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__))
+    #define RSBL_LOG_WARNING_ONCE(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#if RSBL_LOG_MIN_LEVEL <= RSBL_LOG_LEVEL_ERROR
+    #define RSBL_LOG_ERROR(fmt, ...) QUILL_LOG_ERROR(rsbl::g_logger, fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_ERROR_EVERY_N(n, fmt, ...)                                                    \
+        QUILL_LOG_ERROR_LIMIT_EVERY_N(n, rsbl::g_logger, fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_ERROR_ONCE(fmt, ...) RSBL_LOG_ONCE_IMPL(RSBL_LOG_ERROR, fmt, ##__VA_ARGS__)
+#else
+    #define RSBL_LOG_ERROR(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_ERROR_EVERY_N(n, fmt, ...) ((void)(n), RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__))
+    #define RSBL_LOG_ERROR_ONCE(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#if RSBL_LOG_MIN_LEVEL <= RSBL_LOG_LEVEL_CRITICAL
+    #define RSBL_LOG_CRITICAL(fmt, ...) QUILL_LOG_CRITICAL(rsbl::g_logger, fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_CRITICAL_EVERY_N(n, fmt, ...)                                                 \
+        QUILL_LOG_CRITICAL_LIMIT_EVERY_N(n, rsbl::g_logger, fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_CRITICAL_ONCE(fmt, ...)                                                       \
+        RSBL_LOG_ONCE_IMPL(RSBL_LOG_CRITICAL, fmt, ##__VA_ARGS__)
+#else
+    #define RSBL_LOG_CRITICAL(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+    #define RSBL_LOG_CRITICAL_EVERY_N(n, fmt, ...) ((void)(n), RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__))
+    #define RSBL_LOG_CRITICAL_ONCE(fmt, ...) RSBL_LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
@@ -0,0 +1,373 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-log-binary.h"
+
+#include "quill/Backend.h"
+#include "quill/Frontend.h"
+#include "quill/bundled/fmt/args.h"
+#include "quill/sinks/Sink.h"
+
+#include <charconv>
+#include <exception>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rsbl
+{
+
+Logger* g_binaryLogger = nullptr;
+
+namespace
+{
+using LogFrontend = quill::FrontendImpl<LogFrontendOptions>;
+
+// File layout: the magic and version, then records, each starting with its kind. A call site's
+// Format record always comes before its first Event.
+//   Format: u32 id, u32 line, u16 file length, file, u16 format length, format
+//   Event:  u64 nanoseconds since the epoch, u32 thread, u32 format id, u16 argument bytes,
+//           u8 argument count, then each argument's type and bytes
+constexpr char kMagic[8] = {'R', 'S', 'B', 'L', 'B', 'L', 'O', 'G'};
+constexpr uint32_t kVersion = 1;
+
+enum class RecordKind : uint8_t
+{
+    Format = 1,
+    Event = 2,
+};
+
+class BinaryFileSink final : public quill::Sink
+{
+  public:
+    explicit BinaryFileSink(const char* path)
+        : m_file(std::fopen(path, "wb"))
+    {
+        if (m_file != nullptr)
+        {
+            std::fwrite(kMagic, sizeof(kMagic), 1, m_file);
+            std::fwrite(&kVersion, sizeof(kVersion), 1, m_file);
+        }
+    }
+
+    ~BinaryFileSink() override
+    {
+        if (m_file != nullptr)
+        {
+            std::fclose(m_file);
+        }
+    }
+
+    void write_log(quill::MacroMetadata const*,
+                   uint64_t log_timestamp,
+                   std::string_view thread_id,
+                   std::string_view,
+                   std::string const&,
+                   std::string_view,
+                   quill::LogLevel,
+                   std::string_view,
+                   std::string_view,
+                   std::vector<std::pair<std::string, std::string>> const*,
+                   std::string_view log_message,
+                   std::string_view) override
+    {
+        // The message is LogBinaryRecord's bytes, untouched
+        const LogBinaryFormat* format = nullptr;
+        if (m_file == nullptr || log_message.size() <= sizeof(format))
+        {
+            return;
+        }
+        std::memcpy(&format, log_message.data(), sizeof(format));
+        const std::string_view args = log_message.substr(sizeof(format));
+
+        auto [found, inserted] =
+            m_formatIds.try_emplace(format, static_cast<uint32_t>(m_formatIds.size()));
+        const uint32_t format_id = found->second;
+        if (inserted)
+        {
+            WriteFormat(format_id, *format);
+        }
+
+        uint32_t thread = 0;
+        std::from_chars(thread_id.data(), thread_id.data() + thread_id.size(), thread);
+        const uint16_t arg_bytes = static_cast<uint16_t>(args.size());
+
+        Put(RecordKind::Event);
+        Put(log_timestamp);
+        Put(thread);
+        Put(format_id);
+        Put(arg_bytes);
+        std::fwrite(args.data(), 1, args.size(), m_file);
+    }
+
+    void flush_sink() override
+    {
+        if (m_file != nullptr)
+        {
+            std::fflush(m_file);
+        }
+    }
+
+  private:
+    template <typename T>
+    void Put(const T& value)
+    {
+        std::fwrite(&value, sizeof(value), 1, m_file);
+    }
+
+    void PutString(const char* text)
+    {
+        const uint16_t size = static_cast<uint16_t>(std::strlen(text));
+        Put(size);
+        std::fwrite(text, 1, size, m_file);
+    }
+
+    void WriteFormat(uint32_t id, const LogBinaryFormat& format)
+    {
+        Put(RecordKind::Format);
+        Put(id);
+        Put(format.line);
+        PutString(format.file);
+        PutString(format.format);
+    }
+
+    FILE* m_file = nullptr;
+    // Call sites are statics, so their addresses stay put for the life of the process
+    std::unordered_map<const LogBinaryFormat*, uint32_t> m_formatIds;
+};
+
+class Reader
+{
+  public:
+    explicit Reader(FILE* file)
+        : m_file(file)
+    {
+    }
+
+    template <typename T>
+    bool Get(T& value)
+    {
+        return std::fread(&value, sizeof(value), 1, m_file) == 1;
+    }
+
+    bool GetString(std::string& text)
+    {
+        uint16_t size = 0;
+        if (!Get(size))
+        {
+            return false;
+        }
+        text.resize(size);
+        return size == 0 || std::fread(text.data(), 1, size, m_file) == size;
+    }
+
+  private:
+    FILE* m_file;
+};
+
+struct DecodedFormat
+{
+    uint32_t line = 0;
+    std::string file;
+    std::string format;
+};
+
+using DecodedArgs = fmtquill::dynamic_format_arg_store<fmtquill::format_context>;
+
+// Decodes one event's arguments into args, false if they run past the record
+bool DecodeArgs(std::string_view bytes, DecodedArgs& args)
+{
+    if (bytes.empty())
+    {
+        return false;
+    }
+    const uint8_t count = static_cast<uint8_t>(bytes[0]);
+    size_t at = 1;
+    auto take = [&bytes, &at](void* out, size_t size) {
+        if (at + size > bytes.size())
+        {
+            return false;
+        }
+        std::memcpy(out, bytes.data() + at, size);
+        at += size;
+        return true;
+    };
+
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        LogBinaryArgType type;
+        if (!take(&type, sizeof(type)))
+        {
+            return false;
+        }
+        switch (type)
+        {
+        case LogBinaryArgType::Int:
+        {
+            int64_t value;
+            if (!take(&value, sizeof(value)))
+            {
+                return false;
+            }
+            args.push_back(value);
+            break;
+        }
+        case LogBinaryArgType::UInt:
+        {
+            uint64_t value;
+            if (!take(&value, sizeof(value)))
+            {
+                return false;
+            }
+            args.push_back(value);
+            break;
+        }
+        case LogBinaryArgType::Double:
+        {
+            double value;
+            if (!take(&value, sizeof(value)))
+            {
+                return false;
+            }
+            args.push_back(value);
+            break;
+        }
+        case LogBinaryArgType::Bool:
+        {
+            uint8_t value;
+            if (!take(&value, sizeof(value)))
+            {
+                return false;
+            }
+            args.push_back(value != 0);
+            break;
+        }
+        case LogBinaryArgType::String:
+        {
+            uint16_t size;
+            if (!take(&size, sizeof(size)) || at + size > bytes.size())
+            {
+                return false;
+            }
+            args.push_back(std::string(bytes.substr(at, size)));
+            at += size;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+void LogBinaryInit(const char* path)
+{
+    if (g_binaryLogger != nullptr)
+    {
+        return;
+    }
+
+    if (!quill::Backend::is_running())
+    {
+        // As LogInit's, records have to reach the sink as the bytes they were logged as
+        quill::BackendOptions backend_options;
+        backend_options.thread_name = "rsbl-log";
+        backend_options.check_printable_char = {};
+        quill::Backend::start(backend_options);
+    }
+
+    std::shared_ptr<quill::Sink> sink = LogFrontend::create_or_get_sink<BinaryFileSink>(path, path);
+
+    // No pattern, so the backend doesn't format a text line for each record
+    g_binaryLogger = LogFrontend::create_or_get_logger(
+        "rsbl_binary", std::move(sink), quill::PatternFormatterOptions{"", "%H:%M:%S.%Qns"});
+}
+
+bool LogBinaryDecode(const char* path, FILE* out)
+{
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    std::unique_ptr<FILE, int (*)(FILE*)> closer(file, &std::fclose);
+    Reader reader(file);
+
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0;
+    if (!reader.Get(magic) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !reader.Get(version) || version != kVersion)
+    {
+        return false;
+    }
+
+    std::vector<DecodedFormat> formats;
+    std::string args_bytes;
+    std::string message;
+    RecordKind kind;
+    while (reader.Get(kind))
+    {
+        if (kind == RecordKind::Format)
+        {
+            uint32_t id = 0;
+            DecodedFormat format;
+            if (!reader.Get(id) || !reader.Get(format.line) || !reader.GetString(format.file) ||
+                !reader.GetString(format.format))
+            {
+                return false;
+            }
+            if (id >= formats.size())
+            {
+                formats.resize(id + 1);
+            }
+            formats[id] = std::move(format);
+            continue;
+        }
+        if (kind != RecordKind::Event)
+        {
+            return false;
+        }
+
+        uint64_t timestamp = 0;
+        uint32_t thread = 0;
+        uint32_t format_id = 0;
+        uint16_t arg_size = 0;
+        if (!reader.Get(timestamp) || !reader.Get(thread) || !reader.Get(format_id) ||
+            !reader.Get(arg_size) || format_id >= formats.size())
+        {
+            return false;
+        }
+        args_bytes.resize(arg_size);
+        if (arg_size > 0 && std::fread(args_bytes.data(), 1, arg_size, file) != arg_size)
+        {
+            return false;
+        }
+
+        DecodedArgs args;
+        if (!DecodeArgs(args_bytes, args))
+        {
+            return false;
+        }
+        const DecodedFormat& format = formats[format_id];
+        try
+        {
+            message = fmtquill::vformat(format.format, args);
+        }
+        catch (const std::exception& e)
+        {
+            message = "[Couldn't format \"" + format.format + "\": " + e.what() + "]";
+        }
+        std::fprintf(out,
+                     "%llu %u %s:%u %s\n",
+                     static_cast<unsigned long long>(timestamp),
+                     thread,
+                     format.file.c_str(),
+                     format.line,
+                     message.c_str());
+    }
+    return std::feof(file) != 0;
+}
+
+} // namespace rsbl
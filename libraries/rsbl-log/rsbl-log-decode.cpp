@@ -0,0 +1,23 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Prints a binary log (LogBinaryInit) as text: rsbl-log-decode <binary log>
+
+#include "rsbl-log-binary.h"
+
+#include <cstdio>
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "Usage: rsbl-log-decode <binary log>\n");
+        return 1;
+    }
+    if (!rsbl::LogBinaryDecode(argv[1], stdout))
+    {
+        std::fprintf(stderr, "%s isn't a binary log, or it's cut short\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -9,49 +9,91 @@
 #include "quill/sinks/ConsoleSink.h"
 #include "quill/sinks/RotatingFileSink.h"
 
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace rsbl
 {
 
 // Global static logger instance owned by wrapper library
-quill::Logger* g_logger = nullptr;
+Logger* g_logger = nullptr;
 
-void LogInit(const char* log_file_path)
+namespace
+{
+using LogFrontend = quill::FrontendImpl<LogFrontendOptions>;
+}
+
+void LogInit(const LogConfig& config)
 {
+    if (g_logger != nullptr)
+    {
+        return;
+    }
+
     // Start the backend thread
-    quill::Backend::start();
+    quill::BackendOptions backend_options;
+    backend_options.thread_name = "rsbl-log";
+    backend_options.cpu_affinity = config.backendCpu;
+    backend_options.sleep_duration = std::chrono::microseconds{config.backendSleepUs};
+    backend_options.enable_yield_when_idle = config.backendYieldWhenIdle;
+    // Binary log records are raw bytes, which escaping unprintable chars would mangle
+    backend_options.check_printable_char = {};
+    quill::Backend::start(backend_options);
+
+    std::vector<std::shared_ptr<quill::Sink>> sinks;
 
     // Create console sink with custom pattern format
-    auto console_sink = quill::Frontend::create_or_get_sink<quill::ConsoleSink>(
-        "rsbl_console_sink",
-        []()
-        {
-            quill::ConsoleSinkConfig cfg;
-            cfg.set_override_pattern_formatter_options(
-                quill::PatternFormatterOptions{
-                    "%(time) %(thread_id) %(file_name):%(line_number) %(message)",
-                    "%H:%M:%S.%Qns",
-                    quill::Timezone::LocalTime});
-            return cfg;
-        }());
+    if (config.console)
+    {
+        sinks.push_back(LogFrontend::create_or_get_sink<quill::ConsoleSink>(
+            "rsbl_console_sink",
+            []()
+            {
+                quill::ConsoleSinkConfig cfg;
+                cfg.set_override_pattern_formatter_options(
+                    quill::PatternFormatterOptions{
+                        "%(time) %(thread_id) %(file_name):%(line_number) %(message)",
+                        "%H:%M:%S.%Qns",
+                        quill::Timezone::LocalTime});
+                return cfg;
+            }()));
+    }
 
     // Create rotating file sink
-    auto rotating_file_sink = quill::Frontend::create_or_get_sink<quill::RotatingFileSink>(
-        log_file_path,
-        []()
-        {
-            quill::RotatingFileSinkConfig cfg;
-            cfg.set_open_mode('w');
-            cfg.set_rotation_max_file_size(1024 * 1024 * 10);  // 10 MB rotation size
-            cfg.set_max_backup_files(5);                        // Keep up to 5 backup files
-            cfg.set_overwrite_rolled_files(true);               // Overwrite old files when limit reached
-            cfg.set_filename_append_option(quill::FilenameAppendOption::StartDateTime);
-            return cfg;
-        }());
-
-    // Create logger with both console and rotating file sinks
-    g_logger = quill::Frontend::create_or_get_logger(
-        "rsbl_root",
-        {console_sink, rotating_file_sink});
+    if (config.filePath != nullptr)
+    {
+        sinks.push_back(LogFrontend::create_or_get_sink<quill::RotatingFileSink>(
+            config.filePath,
+            [&config]()
+            {
+                quill::RotatingFileSinkConfig cfg;
+                cfg.set_open_mode('w');
+                cfg.set_rotation_max_file_size(config.rotationBytes);
+                cfg.set_max_backup_files(config.maxBackupFiles);
+                cfg.set_overwrite_rolled_files(true);  // Overwrite old files when limit reached
+                cfg.set_filename_append_option(quill::FilenameAppendOption::StartDateTime);
+                return cfg;
+            }()));
+    }
+
+    // Create logger with the configured sinks
+    Logger* logger = LogFrontend::create_or_get_logger("rsbl_root", std::move(sinks));
+    logger->set_log_level(config.level);
+    g_logger = logger;
+}
+
+void LogInit(const char* log_file_path)
+{
+    LogConfig config;
+    config.filePath = log_file_path;
+    LogInit(config);
+}
+
+void LogPreallocateThread()
+{
+    LogFrontend::preallocate();
 }
 
 } // namespace rsbl
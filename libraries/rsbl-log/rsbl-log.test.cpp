@@ -5,6 +5,11 @@
 #include <doctest/doctest.h>
 
 #include "rsbl-log.h"
+#include "rsbl-log-binary.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
 
 // Helper functions to test logging outside of constexpr context
 static void test_logging_macros()
@@ -62,3 +67,140 @@ TEST_CASE("rsbl-log initialization and basic logging")
         CHECK(true);
     }
 }
+
+static int CountCall(int& calls)
+{
+    return ++calls;
+}
+
+TEST_CASE("rsbl-log hot path macros")
+{
+    // Runs after the initialization test case above
+    REQUIRE(rsbl::g_logger != nullptr);
+    rsbl::g_logger->set_log_level(quill::LogLevel::Info);
+
+    SUBCASE("Once only evaluates its arguments the first time")
+    {
+        int calls = 0;
+        for (int i = 0; i < 10; ++i)
+        {
+            RSBL_LOG_INFO_ONCE("Logged once: {}", CountCall(calls));
+        }
+        CHECK(calls == 1);
+    }
+
+    SUBCASE("Every N logs the first of every n calls")
+    {
+        int calls = 0;
+        for (int i = 0; i < 10; ++i)
+        {
+            RSBL_LOG_INFO_EVERY_N(4, "Logged every 4: {}", CountCall(calls));
+        }
+        // Calls 0, 4 and 8
+        CHECK(calls == 3);
+    }
+
+    SUBCASE("Runtime filtered levels don't count")
+    {
+        rsbl::g_logger->set_log_level(quill::LogLevel::Error);
+        int calls = 0;
+        for (int i = 0; i < 10; ++i)
+        {
+            RSBL_LOG_INFO_EVERY_N(4, "Filtered: {}", CountCall(calls));
+        }
+        CHECK(calls == 0);
+    }
+
+    SUBCASE("Compiled out calls don't evaluate their arguments")
+    {
+        int calls = 0;
+        RSBL_LOG_DISCARD("Discarded: {}", CountCall(calls));
+        RSBL_LOG_DISCARD("Discarded without arguments");
+        CHECK(calls == 0);
+    }
+}
+
+TEST_CASE("rsbl-log configuration")
+{
+    SUBCASE("Only the first LogInit sets the logger up")
+    {
+        REQUIRE(rsbl::g_logger != nullptr);
+        rsbl::Logger* logger = rsbl::g_logger;
+
+        rsbl::LogConfig config;
+        config.console = false;
+        config.level = quill::LogLevel::Critical;
+        rsbl::LogInit(config);
+        CHECK(rsbl::g_logger == logger);
+    }
+
+    SUBCASE("Threads can allocate their queue up front")
+    {
+        std::thread thread([]() {
+            rsbl::LogPreallocateThread();
+            RSBL_LOG_INFO("Logged from a preallocated thread");
+        });
+        thread.join();
+        CHECK(true);
+    }
+}
+
+namespace
+{
+enum class TestStage : uint8_t
+{
+    Cull = 3,
+};
+
+std::string DecodeToText(const char* path, bool& decoded)
+{
+    FILE* out = std::tmpfile();
+    REQUIRE(out != nullptr);
+    decoded = rsbl::LogBinaryDecode(path, out);
+    std::string text;
+    std::rewind(out);
+    char buffer[256];
+    while (std::fgets(buffer, sizeof(buffer), out) != nullptr)
+    {
+        text += buffer;
+    }
+    std::fclose(out);
+    return text;
+}
+} // namespace
+
+TEST_CASE("rsbl-log binary records")
+{
+    rsbl::LogBinaryInit("test_log.binlog");
+    REQUIRE(rsbl::g_binaryLogger != nullptr);
+
+    const std::string long_name(200, 'x');
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        RSBL_LOG_BINARY("Frame {} took {:.2f}ms", frame, 16.5 + frame);
+    }
+    RSBL_LOG_BINARY("Stage {} of {}, culled {}", TestStage::Cull, 7u, true);
+    RSBL_LOG_BINARY("Mesh '{}'", "teapot");
+    RSBL_LOG_BINARY("Long '{}'", long_name);
+    RSBL_LOG_BINARY("No arguments");
+    rsbl::g_binaryLogger->flush_log();
+
+    bool decoded = false;
+    const std::string text = DecodeToText("test_log.binlog", decoded);
+    CHECK(decoded);
+    CHECK(text.find("Frame 0 took 16.50ms\n") != std::string::npos);
+    CHECK(text.find("Frame 2 took 18.50ms\n") != std::string::npos);
+    CHECK(text.find("Stage 3 of 7, culled true\n") != std::string::npos);
+    CHECK(text.find("Mesh 'teapot'\n") != std::string::npos);
+    CHECK(text.find("Long '" + std::string(rsbl::kLogBinaryMaxString, 'x') + "'\n") !=
+          std::string::npos);
+    CHECK(text.find("No arguments\n") != std::string::npos);
+    CHECK(text.find("rsbl-log.test.cpp:") != std::string::npos);
+
+    SUBCASE("Anything else isn't decoded")
+    {
+        bool text_decoded = true;
+        DecodeToText("test_log.log", text_decoded);
+        CHECK_FALSE(text_decoded);
+    }
+}
@@ -0,0 +1,137 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-file.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+
+// Asynchronous file reads through a submission and a completion queue. Reads are queued up,
+// handed to the OS in one go by Submit, and come back in whatever order they finish, tagged with
+// the caller's userData. Keeping many reads in flight is what gets an NVMe drive anywhere near
+// its rated throughput; one blocking read at a time leaves it mostly idle.
+//
+//     for (Chunk& chunk : chunks)
+//     {
+//         io->QueueRead({file, chunk.offset, chunk.buffer, chunk.id});
+//     }
+//     io->Submit();
+//     AsyncIoCompletion done[32];
+//     while (io->InFlight() > 0)
+//     {
+//         const uint32 count = io->WaitCompletions(done, 32);
+//         ... hand done[0, count) on ...
+//     }
+//
+// Backends, best first: IoRing on Windows 11, otherwise an IO completion port, and io_uring on
+// Linux, otherwise blocking reads on a few threads. An AsyncIo is driven by one thread at a
+// time, the one queueing, submitting and reaping; the reads themselves run concurrently.
+
+namespace rsbl
+{
+
+enum class AsyncIoBackend : uint8
+{
+    IoRing,
+    CompletionPort,
+    IoUring,
+    // Blocking positional reads on a thread pool, where there's no kernel queue to use
+    Threads,
+};
+
+const char* AsyncIoBackendName(AsyncIoBackend backend);
+
+struct AsyncIoOptions
+{
+    // Reads queued or in flight at once, QueueRead refuses more. 32 to 128 keeps an NVMe drive
+    // busy.
+    uint32 queueDepth = 128;
+
+    // Threads for the Threads backend
+    uint32 fallbackThreads = 4;
+
+    // Skips IoRing and io_uring, mostly for testing the fallbacks
+    bool allowKernelQueues = true;
+};
+
+// Biggest single read, what every backend can do in one go. Bigger ones go in as several.
+constexpr uint64 kMaxAsyncReadSize = 1ull << 30;
+
+struct AsyncRead
+{
+    // From AsyncIo::OpenForRead
+    FileHandle file = 0;
+    uint64 offset = 0;
+    // Has to stay valid until the read's completion is reaped
+    MutableByteView buffer;
+    uint64 userData = 0;
+};
+
+struct AsyncIoCompletion
+{
+    uint64 userData = 0;
+    // Fewer than asked for only at the end of the file
+    uint64 bytesRead = 0;
+    bool succeeded = false;
+};
+
+class AsyncIo
+{
+  public:
+    static Result<UniquePtr<AsyncIo>> Create(const AsyncIoOptions& options = {});
+
+    // Waits for the reads still in flight, their buffers may be in use until then
+    ~AsyncIo();
+
+    AsyncIo(AsyncIo&&) = delete;
+    AsyncIo& operator=(AsyncIo&&) = delete;
+    AsyncIo(const AsyncIo&) = delete;
+    AsyncIo& operator=(const AsyncIo&) = delete;
+
+    // Opens a file the way this backend wants to read it (overlapped on Windows). Close it with
+    // CloseFile once its reads are done. Only for this AsyncIo's reads, not ReadFile. With
+    // FileOpenFlags::Unbuffered, reads have to follow its alignment rules.
+    Result<FileHandle> OpenForRead(const char* path, FileOpenFlags flags = FileOpenFlags::None);
+
+    // Queues a read for the next Submit. False when queueDepth reads are already queued or in
+    // flight, reap some completions first.
+    bool QueueRead(const AsyncRead& read);
+
+    // Hands everything queued to the OS, in one call where the backend allows it
+    Result<> Submit();
+
+    // Reaps up to maxCount finished reads without blocking, returns how many
+    uint32 PollCompletions(AsyncIoCompletion* completions, uint32 maxCount);
+
+    // Same, but blocks until at least one read finishes. Returns 0 right away when nothing is in
+    // flight.
+    uint32 WaitCompletions(AsyncIoCompletion* completions, uint32 maxCount);
+
+    // Submitted and not reaped yet
+    uint32 InFlight() const;
+
+    AsyncIoBackend Backend() const;
+
+  private:
+    struct State;
+
+    AsyncIo() = default;
+
+    State* m_state = nullptr;
+};
+
+// Reads a big range as chunkSize pieces, as many in flight at once as the queue takes, so one
+// large read keeps the device as busy as many small ones. Pieces after the first start on a
+// multiple of chunkSize, a power of two of at least 4 KB, which keeps them sector aligned.
+// Blocks until it's all in and returns the bytes read, short only at the end of the file.
+// Takes over io for the duration, nothing else can be queued or in flight on it.
+Result<uint64> ReadFileParallel(AsyncIo& io,
+                                FileHandle file,
+                                MutableByteView buffer,
+                                uint64 offset,
+                                uint64 chunkSize = 1024 * 1024);
+
+} // namespace rsbl
@@ -0,0 +1,112 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-int-types.h>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+namespace rsbl
+{
+
+// Monotonic high-resolution time. Ticks come from QueryPerformanceCounter on Windows and
+// CLOCK_MONOTONIC elsewhere, and only mean something relative to each other. Convert durations
+// with TicksToNs, never absolute values.
+class Clock
+{
+  public:
+    static uint64 NowTicks();
+
+    // Fixed for the life of the process
+    static uint64 TicksPerSecond();
+
+    static uint64 TicksToNs(uint64 ticks);
+
+    static double TicksToMs(uint64 ticks)
+    {
+        return static_cast<double>(TicksToNs(ticks)) / 1'000'000.0;
+    }
+
+    static double TicksToSeconds(uint64 ticks)
+    {
+        return static_cast<double>(TicksToNs(ticks)) / 1'000'000'000.0;
+    }
+
+    static uint64 NowNs()
+    {
+        return TicksToNs(NowTicks());
+    }
+
+    // CPU time the calling thread has used, user and kernel, in nanoseconds. Set against a wall
+    // clock interval it tells computing from waiting. Windows counts it in 100ns units.
+    static uint64 ThreadCpuNs();
+
+    // Raw CPU timestamp counter, for very short measurements where the cost of NowTicks shows up.
+    // The rate is not tied to nanoseconds, and isn't guaranteed to match across cores, so only
+    // compare cycle counts taken on the same thread. Falls back to NowTicks on CPUs without one.
+    static uint64 Cycles()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+        return static_cast<uint64>(_ReadStatusReg(ARM64_CNTVCT));
+#elif defined(__aarch64__)
+        uint64 value;
+        __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return NowTicks();
+#endif
+    }
+};
+
+// Measures the time between construction and destruction. If given a target, the elapsed
+// nanoseconds are written to it when the timer goes out of scope.
+class ScopedTimer
+{
+  public:
+    explicit ScopedTimer(uint64* elapsed_ns = nullptr)
+        : m_start(Clock::NowTicks())
+        , m_target(elapsed_ns)
+    {
+    }
+
+    ~ScopedTimer()
+    {
+        if (m_target != nullptr)
+        {
+            *m_target = ElapsedNs();
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    uint64 ElapsedTicks() const
+    {
+        return Clock::NowTicks() - m_start;
+    }
+
+    uint64 ElapsedNs() const
+    {
+        return Clock::TicksToNs(ElapsedTicks());
+    }
+
+    double ElapsedMs() const
+    {
+        return Clock::TicksToMs(ElapsedTicks());
+    }
+
+  private:
+    uint64 m_start;
+    uint64* m_target;
+};
+
+} // namespace rsbl
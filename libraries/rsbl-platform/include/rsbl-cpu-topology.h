@@ -0,0 +1,89 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+
+// How the logical processors map onto physical cores, shared caches and NUMA nodes. Read once
+// from GetLogicalProcessorInformationEx on Windows and /sys/devices/system/cpu on Linux, then
+// cached. Elsewhere, or when the OS won't say, every logical processor is reported as its own
+// core in one cache group and one node.
+//
+// Groups (cores, L2/L3 groups, NUMA nodes) are numbered densely from 0 in the order their first
+// logical processor comes up, so they index arrays directly.
+
+namespace rsbl
+{
+
+struct LogicalProcessor
+{
+    // The OS's number for it, and the bit that stands for it in affinity masks (within its
+    // processor group on Windows, ids past 63 are in later groups)
+    uint32 id = 0;
+
+    // Index into CpuTopology::cores. Logical processors on the same core are SMT siblings.
+    uint32 core = 0;
+
+    // Processors with the same group share that cache
+    uint32 l2Group = 0;
+    uint32 l3Group = 0;
+
+    uint32 numaNode = 0;
+};
+
+struct PhysicalCore
+{
+    // Logical processors on the core, 1 without SMT
+    uint32 logicalCount = 0;
+
+    // Lowest id of its logical processors
+    uint32 firstLogicalId = 0;
+
+    // Higher is faster. On hybrid CPUs the P-cores have a higher class than the E-cores,
+    // elsewhere every core is 0.
+    uint8 efficiencyClass = 0;
+};
+
+struct CpuTopology
+{
+    // Sorted by id
+    DynamicArray<LogicalProcessor> logical;
+    DynamicArray<PhysicalCore> cores;
+
+    uint32 l2GroupCount = 1;
+    uint32 l3GroupCount = 1;
+    uint32 numaNodeCount = 1;
+
+    // The OS's number for each node, which isn't always dense (a node without processors)
+    DynamicArray<uint32> numaNodeIds;
+
+    // Per group, 0 when unknown
+    uint64 l2Bytes = 0;
+    uint64 l3Bytes = 0;
+    uint32 cacheLineBytes = 64;
+
+    // Highest efficiencyClass of any core
+    uint8 maxEfficiencyClass = 0;
+
+    bool IsHybrid() const
+    {
+        return maxEfficiencyClass > 0;
+    }
+
+    // Cores of the fastest class, all of them on CPUs that aren't hybrid
+    uint32 PerformanceCoreCount() const
+    {
+        uint32 count = 0;
+        for (const PhysicalCore& core : cores)
+        {
+            count += core.efficiencyClass == maxEfficiencyClass ? 1 : 0;
+        }
+        return count;
+    }
+};
+
+const CpuTopology& GetCpuTopology();
+
+} // namespace rsbl
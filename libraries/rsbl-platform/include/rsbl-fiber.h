@@ -0,0 +1,56 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+
+namespace rsbl
+{
+
+// A fiber is a stack plus saved registers. It only runs when something switches to it, on the
+// thread that did the switching, so one fiber can start on one thread and carry on on another.
+// Win32 fibers on Windows, ucontext elsewhere. A thread has to become a fiber itself
+// (FromCurrentThread) before it can switch to any other.
+//
+// Compilers may keep a thread_local's address across a call, so code that can come back on a
+// different thread should only reach thread_locals through functions that aren't inlined across
+// the switch.
+class Fiber
+{
+  public:
+    // Runs on the fiber's own stack. It must never return, switch away for good instead.
+    using EntryPoint = void (*)(void* userData);
+
+    // The fiber starts in entry the first time something switches to it. stackSize is rounded up
+    // to whole pages.
+    static Result<UniquePtr<Fiber>> Create(uint64 stackSize, EntryPoint entry, void* userData);
+
+    // Turns the calling thread into a fiber. Destroying that fiber turns the thread back, which
+    // has to happen on the same thread while it's running the fiber.
+    static Result<UniquePtr<Fiber>> FromCurrentThread();
+
+    // A fiber can't be destroyed while it's running, or while it's suspended in the middle of
+    // work somebody still expects to finish
+    ~Fiber();
+
+    // Switches hold on to the fiber, it can't move
+    Fiber(Fiber&&) = delete;
+    Fiber& operator=(Fiber&&) = delete;
+    Fiber(const Fiber&) = delete;
+    Fiber& operator=(const Fiber&) = delete;
+
+    // Suspends this fiber, which has to be the one running, and resumes target on the calling
+    // thread. Returns once something switches back to this fiber, maybe on another thread.
+    void SwitchTo(Fiber& target);
+
+  private:
+    Fiber() = default;
+
+    void* m_platformData = nullptr;
+    bool m_isThread = false;
+};
+
+} // namespace rsbl
@@ -0,0 +1,87 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+#include <rsbl-string.h>
+
+// Watches a directory tree for changed files, for hot-reloading assets and shaders. A thread of
+// the watcher's own blocks on the OS (ReadDirectoryChangesW on Windows, inotify on Linux), folds
+// the burst of events a single save makes into one change per file, and hands them over once
+// the tree has been quiet for a moment. The handler runs on that thread, so anything more than
+// queueing the reload belongs in a job:
+//
+//     watcher = FileWatcher::Create("assets", [&](DynamicArray<FileChange>&& changes) {
+//         jobs->Submit([&, changes = rsblMove(changes)]() { ReloadChanged(changes); },
+//                      nullptr, JobPriority::Low);
+//     });
+
+namespace rsbl
+{
+
+enum class FileChangeKind : uint8
+{
+    Added,
+    Modified,
+    // Can name a directory, its files don't always get their own removals
+    Removed,
+    // The OS dropped events, path is empty. Anything under the root may have changed.
+    Rescan,
+};
+
+struct FileChange
+{
+    // Relative to the watched directory, with '/' separators
+    String path;
+    FileChangeKind kind = FileChangeKind::Modified;
+};
+
+// Called with a batch of changes, at most one per path
+using FileChangeHandler = PooledFunction<void(DynamicArray<FileChange>&&), 48>;
+
+struct FileWatcherOptions
+{
+    // Watches subdirectories too, including ones created later
+    bool recursive = true;
+
+    // A batch goes out once nothing has changed for this long. Editors and exporters write a file
+    // in several steps, and this keeps them from being seen halfway.
+    uint32 debounceMs = 100;
+
+    // A steady stream of changes still goes out this often
+    uint32 maxDelayMs = 1000;
+};
+
+class FileWatcher
+{
+  public:
+    // Starts watching. Fails if the directory doesn't exist, or the platform can't watch it
+    // (inotify is Linux only among the POSIX systems).
+    static Result<UniquePtr<FileWatcher>> Create(const char* directory,
+                                                 FileChangeHandler&& handler,
+                                                 const FileWatcherOptions& options = {});
+
+    // Stops the thread. Changes still waiting out the debounce are dropped, and the handler
+    // isn't called again once this returns.
+    ~FileWatcher();
+
+    // The thread holds on to the watcher, it can't move
+    FileWatcher(FileWatcher&&) = delete;
+    FileWatcher& operator=(FileWatcher&&) = delete;
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+  private:
+    struct State;
+
+    FileWatcher() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
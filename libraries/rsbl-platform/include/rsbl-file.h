@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <rsbl-allocator.h>
+#include <rsbl-array-view.h>
 #include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
 #include <rsbl-result.h>
 
 namespace rsbl
@@ -21,18 +24,236 @@ enum class FileOpenMode : uint8
     ReadWriteAppend, // Does not tructate file, modif + read
 };
 
+// How the OS should cache a file, combined with |
+enum class FileOpenFlags : uint8
+{
+    None = 0,
+
+    // Skips the OS file cache (FILE_FLAG_NO_BUFFERING, O_DIRECT), so streaming a big file once
+    // doesn't push everything else out of it. Every read and write then has to start at an
+    // offset, cover a size and use a buffer that are all multiples of kDirectIoAlignment, see
+    // GetSectorAlignedAllocator. Writes can't end a file mid-sector, pad the last one. Where
+    // the file system can't do this, the file opens cached instead.
+    Unbuffered = 1 << 0,
+
+    // Read front to back: the OS reads further ahead
+    SequentialScan = 1 << 1,
+
+    // Read all over the place: the OS doesn't read ahead
+    RandomAccess = 1 << 2,
+};
+
+constexpr FileOpenFlags operator|(FileOpenFlags a, FileOpenFlags b)
+{
+    return static_cast<FileOpenFlags>(static_cast<uint8>(a) | static_cast<uint8>(b));
+}
+
+constexpr bool HasFlag(FileOpenFlags flags, FileOpenFlags flag)
+{
+    return (static_cast<uint8>(flags) & static_cast<uint8>(flag)) != 0;
+}
+
+// Offsets, sizes and buffers of FileOpenFlags::Unbuffered reads and writes are multiples of
+// this. Sectors are 512 bytes or 4 KB, so 4 KB suits either.
+constexpr uint64 kDirectIoAlignment = 4096;
+
+// Allocations aligned to kDirectIoAlignment and padded to a multiple of it, for unbuffered IO
+// buffers. Charged to MemoryTag::Platform.
+Allocator* GetSectorAlignedAllocator();
+
 // TODO: worth considering returning something more complex instead of just handles
 using FileHandle = uint64_t;
 
-rsbl::Result<FileHandle> OpenFile(const char* path, FileOpenMode mode);
+rsbl::Result<FileHandle> OpenFile(const char* path,
+                                  FileOpenMode mode,
+                                  FileOpenFlags flags = FileOpenFlags::None);
 rsbl::Result<> CloseFile(FileHandle handle);
-rsbl::Result<uint64> WriteFile(FileHandle handle, const void* buffer, uint64 num_bytes_to_write);
-rsbl::Result<uint64> ReadFile(FileHandle handle,
-                              void* buffer,
-                              uint64 num_bytes_to_read,
-                              uint64 offset = 0);
+// Writes all of data, returns the number of bytes written
+rsbl::Result<uint64> WriteFile(FileHandle handle, ByteView data);
+
+// Writes the buffers one after the other as if they were one, without copying them together
+// first: a header and its payload go out in one system call (writev) where the OS allows it.
+// Returns the number of bytes written, all of them.
+rsbl::Result<uint64> WriteFileGather(FileHandle handle, ArrayView<const ByteView> buffers);
+
+// Reads from the file position into the buffers in order, filling each before the next (readv).
+// Returns the number of bytes read, short only when the file ends first.
+rsbl::Result<uint64> ReadFileScatter(FileHandle handle, ArrayView<const MutableByteView> buffers);
+
+// Reads up to buffer.Size() bytes, returns the number of bytes read. A non-zero offset seeks
+// there first, 0 carries on from the file position, which makes it unsafe to share a handle
+// between threads. ReadFileAt is for that.
+rsbl::Result<uint64> ReadFile(FileHandle handle, MutableByteView buffer, uint64 offset = 0);
+
+// Reads from offset without going through the file position, so any number of threads can read
+// different parts of one handle (from OpenFile) at once. Fills the buffer unless the file ends
+// first, returns the number of bytes read.
+rsbl::Result<uint64> ReadFileAt(FileHandle handle, MutableByteView buffer, uint64 offset);
+
+// Writes all of data at offset without going through the file position, the write side of
+// ReadFileAt. Writing past the end grows the file. Returns the number of bytes written.
+rsbl::Result<uint64> WriteFileAt(FileHandle handle, ByteView data, uint64 offset);
 
 // convenience functions
-rsbl::Result<uint64> OpenAndReadFile(const char* path, void* buffer, uint64 num_bytes_to_read);
+rsbl::Result<uint64> OpenAndReadFile(const char* path, MutableByteView buffer);
+
+// The size of an open file, for sizing the buffer before reading it
+rsbl::Result<uint64> GetFileSize(FileHandle handle);
+
+// Cuts the file short or grows it to size. What it grows by reads as zeros and, on file systems
+// that can (ext4, APFS, NTFS once marked sparse), takes no disk space until written.
+rsbl::Result<> SetFileSize(FileHandle handle, uint64 size);
+
+struct FileInfo
+{
+    uint64 size = 0;
+    // Last write, in nanoseconds since the Unix epoch
+    int64 modifiedTime = 0;
+    bool isDirectory = false;
+};
+
+// Size and modified time without opening the file. NotFound when there's nothing at path.
+rsbl::Result<FileInfo> GetFileInfo(const char* path);
+
+// Creates the directory, and any parents missing from its path. Success if it's already there.
+rsbl::Result<> MakeDirectory(const char* path);
+
+// Moves a file to a new path in one step, replacing whatever was there: readers of new_path see
+// either the old file or the whole new one. Both paths have to be on the same volume.
+rsbl::Result<> RenameFile(const char* old_path, const char* new_path);
+
+// NotFound when there's nothing at path
+rsbl::Result<> RemoveFile(const char* path);
+
+// Writes back and drops the file's pages from the OS file cache, so the next read comes from the
+// device: what a cold start reads like, for benchmarks. Pages something still has mapped stay.
+rsbl::Result<> DropFileCache(const char* path);
+
+struct DirectoryEntry
+{
+    // Points into the iterator, valid until its next Next
+    const char* name = nullptr;
+    bool isDirectory = false;
+};
+
+// Walks the entries of one directory, skipping "." and "..", in whatever order the file system
+// keeps them. Entries are read from the OS many at a time (getdents64, FindFirstFileEx with a
+// large fetch) into one buffer, so scanning a big directory costs a few system calls and no
+// allocations per entry.
+//
+//     Result<UniquePtr<DirectoryIterator>> dir = DirectoryIterator::Open("assets");
+//     DirectoryEntry entry;
+//     while (dir.Value()->Next(entry))
+//     {
+//         ... entry.name ...
+//     }
+class DirectoryIterator
+{
+  public:
+    static Result<UniquePtr<DirectoryIterator>> Open(const char* path);
+
+    ~DirectoryIterator();
+
+    DirectoryIterator(DirectoryIterator&&) = delete;
+    DirectoryIterator& operator=(DirectoryIterator&&) = delete;
+    DirectoryIterator(const DirectoryIterator&) = delete;
+    DirectoryIterator& operator=(const DirectoryIterator&) = delete;
+
+    // The next entry, false once there are no more or reading the directory failed
+    bool Next(DirectoryEntry& entry);
+
+    // Size and modified time of the entry Next last returned. Free on Windows, where the
+    // directory listing has them, a stat relative to the open directory elsewhere, still
+    // cheaper than GetFileInfo on a full path.
+    Result<FileInfo> CurrentInfo() const;
+
+  private:
+    struct State;
+
+    DirectoryIterator() = default;
+
+    State* m_state = nullptr;
+};
+
+enum class FileMapAccess : uint8
+{
+    Read,
+    ReadWrite, // Writes through the view land in the file, the size stays as it is
+};
+
+// A whole file mapped into memory. Pages are read in on first touch and shared with the OS file
+// cache, so nothing is copied and the size doesn't need to be known up front. Unmapped when it
+// goes away. The file shouldn't change size while it's mapped, touching pages past its new end
+// faults.
+class MappedFile
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile()
+    {
+        Unmap();
+    }
+
+    MappedFile(MappedFile&& other)
+        : m_data(other.m_data)
+        , m_size(other.m_size)
+        , m_writable(other.m_writable)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& other)
+    {
+        if (this != &other)
+        {
+            Unmap();
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_writable = other.m_writable;
+            other.m_data = nullptr;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ByteView View() const
+    {
+        return ByteView(m_data, m_size);
+    }
+
+    // Only for FileMapAccess::ReadWrite mappings, writing to a read only one faults
+    MutableByteView MutableView()
+    {
+        return MutableByteView(m_writable ? m_data : nullptr, m_writable ? m_size : 0);
+    }
+
+    uint64 Size() const
+    {
+        return m_size;
+    }
+
+    // Asks the OS to start reading [offset, offset + size) in now, so touching it later doesn't
+    // stall on a page fault per page. Only a hint, the range is clamped to the file.
+    void Prefetch(uint64 offset = 0, uint64 size = ~0ull) const;
+
+    // Writes dirty pages back to the file, rather than whenever the OS gets round to it
+    rsbl::Result<> Flush();
+
+    void Unmap();
+
+  private:
+    friend rsbl::Result<MappedFile> MapFile(const char* path, FileMapAccess access);
+
+    // nullptr for an empty file, which maps to an empty view
+    uint8* m_data = nullptr;
+    uint64 m_size = 0;
+    bool m_writable = false;
+};
+
+rsbl::Result<MappedFile> MapFile(const char* path, FileMapAccess access = FileMapAccess::Read);
 
 } // namespace rsbl
\ No newline at end of file
@@ -0,0 +1,82 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+
+// Holds a frame loop to a rate of its own, for when vsync isn't there (the null backend,
+// immediate presents) or isn't wanted. Thread::ThreadSleep is whole milliseconds, and more like
+// a scheduler tick on Windows, which is most of a 240 Hz frame. WaitForNextFrame instead sleeps
+// on a high resolution timer (a waitable timer created with
+// CREATE_WAITABLE_TIMER_HIGH_RESOLUTION on Windows, clock_nanosleep elsewhere) until shortly
+// before the frame is due, and spins the rest, which lands within microseconds of it:
+//
+//     limiter = FrameLimiter::Create(144.0);
+//     while (running)
+//     {
+//         limiter->WaitForNextFrame();
+//         ... sample input, update, render ...
+//     }
+//
+// How long it spins follows how far the sleeps have been overshooting, so it's as short as the
+// timer allows. Frames are due on a fixed grid, so one that starts late doesn't push back the
+// ones after it; one a whole frame late or more starts the grid over instead of rushing the
+// frames after it to catch up.
+
+namespace rsbl
+{
+
+class FrameLimiter
+{
+  public:
+    // 0 frames a second doesn't limit them, WaitForNextFrame returns straight away
+    static Result<UniquePtr<FrameLimiter>> Create(double framesPerSecond);
+
+    ~FrameLimiter();
+
+    FrameLimiter(const FrameLimiter&) = delete;
+    FrameLimiter& operator=(const FrameLimiter&) = delete;
+
+    // Takes effect from the next frame
+    void SetFrameRate(double framesPerSecond);
+    double FrameRate() const
+    {
+        return m_framesPerSecond;
+    }
+
+    // Blocks until the next frame is due, and returns how many ticks it waited
+    uint64 WaitForNextFrame();
+
+    // How long before a frame is due the sleep gives way to spinning
+    uint64 SpinNs() const
+    {
+        return m_spinNs;
+    }
+
+  private:
+    FrameLimiter() = default;
+
+    // Platform-specific. The timer is created once, each wait reuses it.
+    Result<> CreatePlatformTimer();
+    void DestroyPlatformTimer();
+    // Sleeps at least ns, give or take the timer's resolution
+    void SleepFor(uint64 ns);
+
+    double m_framesPerSecond = 0.0;
+    uint64 m_periodTicks = 0;
+    // When the next frame is due, 0 before the first
+    uint64 m_dueTicks = 0;
+
+    // What the platform's sleeps overshoot by at first, and the least spun
+    uint64 m_minSpinNs = 0;
+    uint64 m_spinNs = 0;
+    // The worst recent overshoot, decaying so one bad wake doesn't spin for good
+    uint64 m_overshootNs = 0;
+
+    void* m_timer = nullptr;
+};
+
+} // namespace rsbl
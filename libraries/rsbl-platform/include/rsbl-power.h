@@ -0,0 +1,112 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+
+// What the machine's power supply and cooling allow right now: whether it runs on a battery,
+// the power mode the user or OS picked, and how far heat or power limits hold the CPU back. A
+// laptop on battery or running hot is better served by fewer busy workers and a capped frame
+// rate than by the same work finishing slower at the same power:
+//
+//     monitor = PowerMonitor::Create([&](const PowerState& state) {
+//         constrained.store(IsPowerConstrained(state));
+//     });
+//     ...
+//     jobs->SetActiveWorkerLimit(constrained.load() ? jobs->WorkerCount() / 2 : ~0u);
+//     limiter->SetFrameRate(constrained.load() ? 30.0 : 0.0);
+//
+// GetSystemPowerStatus and CallNtPowerInformation on Windows, with the power mode from
+// PowerRegisterForEffectivePowerModeNotifications. /sys/class/power_supply, the ACPI platform
+// profile and cpufreq on Linux. Anything the OS won't say is left Unknown.
+
+namespace rsbl
+{
+
+enum class PowerSource : uint8
+{
+    Unknown,
+    // Plugged in, or a desktop without a battery
+    Mains,
+    Battery,
+};
+
+// From saving the most power to spending the most
+enum class PowerMode : uint8
+{
+    Unknown,
+    BatterySaver,
+    BetterBattery,
+    Balanced,
+    HighPerformance,
+    MaxPerformance,
+    // Windows' game mode, Balanced with the foreground game favoured
+    GameMode,
+};
+
+struct PowerState
+{
+    PowerSource source = PowerSource::Unknown;
+    PowerMode mode = PowerMode::Unknown;
+
+    // How full the battery is, -1 without one
+    int32 batteryPercent = -1;
+
+    // The fastest the CPU may run as a percentage of its rated maximum. 100 unthrottled, less
+    // while heat or a power limit holds it back, 0 if the OS won't say.
+    uint32 cpuSpeedPercent = 0;
+
+    bool operator==(const PowerState&) const = default;
+};
+
+// Reads it all now. Windows only says the power mode through notifications, so it's Unknown
+// there unless battery saver is on; PowerMonitor has it.
+PowerState QueryPowerState();
+
+// True on battery, in a power saving mode, or with the CPU held below throttledPercent of its
+// maximum
+bool IsPowerConstrained(const PowerState& state, uint32 throttledPercent = 90);
+
+// Called with the state as it first is, then whenever it changes
+using PowerChangeHandler = PooledFunction<void(const PowerState&), 48>;
+
+struct PowerMonitorOptions
+{
+    // How often what the OS doesn't notify about is read again. Thermal limits and battery
+    // levels change over seconds, not frames.
+    uint32 pollMs = 2000;
+};
+
+class PowerMonitor
+{
+  public:
+    // Starts a thread of the monitor's own, which the handler runs on. Keep it short, storing
+    // what the frame or job loop should do next time round.
+    static Result<UniquePtr<PowerMonitor>> Create(PowerChangeHandler&& handler,
+                                                  const PowerMonitorOptions& options = {});
+
+    // Stops the thread, the handler isn't called again once this returns
+    ~PowerMonitor();
+
+    // The thread holds on to the monitor, it can't move
+    PowerMonitor(PowerMonitor&&) = delete;
+    PowerMonitor& operator=(PowerMonitor&&) = delete;
+    PowerMonitor(const PowerMonitor&) = delete;
+    PowerMonitor& operator=(const PowerMonitor&) = delete;
+
+    // What the handler was last called with, from any thread
+    PowerState Latest() const;
+
+  private:
+    struct State;
+
+    PowerMonitor() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
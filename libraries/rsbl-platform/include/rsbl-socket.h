@@ -0,0 +1,53 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-int-types.h>
+#include <rsbl-result.h>
+
+// Blocking TCP sockets, one thread driving each, for talking to tools and cache servers rather
+// than for game traffic. Connections have Nagle turned off: requests go out as soon as they're
+// sent, and the ones here are small.
+//
+//     Result<SocketHandle> socket = ConnectSocket("cache.local", 8080);
+//     SendSocket(socket.Value(), request);
+//     Result<uint64> received = ReceiveSocket(socket.Value(), buffer);
+//     CloseSocket(socket.Value());
+
+namespace rsbl
+{
+
+using SocketHandle = uint64_t;
+
+// Resolves host, a name or an address, and connects to the first of its addresses that answers.
+// Connecting gives up after timeout_ms, and so does every send or receive on the socket after
+// that, failing with ErrorCategory::Timeout.
+Result<SocketHandle> ConnectSocket(const char* host, uint16 port, uint32 timeout_ms = 10000);
+
+// Listens for connections on port, 0 for any free one (GetSocketPort says which). Only on the
+// loopback address unless all_interfaces, for tests and local tools.
+Result<SocketHandle> ListenSocket(uint16 port, bool all_interfaces = false);
+
+// Waits for the next connection on a listening socket. Sends and receives on it don't time out.
+Result<SocketHandle> AcceptSocket(SocketHandle listener);
+
+// The local port a socket is bound to
+Result<uint16> GetSocketPort(SocketHandle socket);
+
+// Sends all of data
+Result<> SendSocket(SocketHandle socket, ByteView data);
+
+// Waits for at least one byte, then returns what has arrived, up to buffer.Size(). 0 once the
+// other end has closed the connection and everything it sent has been received.
+Result<uint64> ReceiveSocket(SocketHandle socket, MutableByteView buffer);
+
+// Ends a connection both ways. A thread blocked in ReceiveSocket on it wakes up and sees it
+// closed, the way to stop one before closing the socket. Doesn't wake AcceptSocket everywhere:
+// stop a listening thread by connecting to it.
+void ShutdownSocket(SocketHandle socket);
+
+Result<> CloseSocket(SocketHandle socket);
+
+} // namespace rsbl
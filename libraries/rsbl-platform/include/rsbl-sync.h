@@ -0,0 +1,189 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-int-types.h>
+#include <rsbl-thread.h>
+
+#include <atomic>
+
+// Locks and wait primitives. Everything here handles the uncontended case with a single atomic
+// in user space and only goes to the kernel to sleep, through WaitOnAddress on Windows and futex
+// on Linux. None of them are recursive, and none can be copied or moved while in use.
+
+namespace rsbl
+{
+
+constexpr uint32 kWaitInfinite = ~0u;
+
+// Sleeps while value still holds expected, until a Wake on the same atomic, the timeout, or a
+// spurious wake up. Returns false only when the timeout ran out, so callers recheck their
+// condition in a loop either way.
+bool AddressWait(const std::atomic<uint32>& value,
+                 uint32 expected,
+                 uint32 timeout_ms = kWaitInfinite);
+void AddressWakeOne(std::atomic<uint32>& value);
+void AddressWakeAll(std::atomic<uint32>& value);
+
+// Busy waits, never sleeps. Only for critical sections a few instructions long, where even a
+// futex round trip costs more than the work. Backs off exponentially with SpinPause and gives up
+// the time slice once it has spun for a while, so a preempted owner can still finish.
+class SpinLock
+{
+  public:
+    SpinLock() = default;
+    SpinLock(const SpinLock&) = delete;
+    SpinLock& operator=(const SpinLock&) = delete;
+
+    bool TryLock()
+    {
+        return !m_locked.load(std::memory_order_relaxed) &&
+               !m_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void Lock()
+    {
+        uint32 backoff = 1;
+        while (!TryLock())
+        {
+            // Spin on a plain load so the cache line stays shared until the owner lets go
+            while (m_locked.load(std::memory_order_relaxed))
+            {
+                if (backoff <= kMaxBackoff)
+                {
+                    for (uint32 i = 0; i < backoff; ++i)
+                    {
+                        Thread::SpinPause();
+                    }
+                    backoff *= 2;
+                }
+                else
+                {
+                    Thread::ThreadYield();
+                }
+            }
+        }
+    }
+
+    void Unlock()
+    {
+        m_locked.store(false, std::memory_order_release);
+    }
+
+  private:
+    static constexpr uint32 kMaxBackoff = 64;
+
+    std::atomic<bool> m_locked{false};
+};
+
+// Sleeping lock for anything longer than a SpinLock critical section. An SRWLOCK on Windows and
+// a three state futex lock on Linux, neither of which is fair.
+class Mutex
+{
+  public:
+    Mutex() = default;
+    ~Mutex();
+    Mutex(const Mutex&) = delete;
+    Mutex& operator=(const Mutex&) = delete;
+
+    void Lock();
+    bool TryLock();
+    void Unlock();
+
+  private:
+#if defined(_WIN32)
+    // SRWLOCK, all zero is unlocked
+    void* m_native = nullptr;
+#else
+    // 0 unlocked, 1 locked, 2 locked with (maybe) sleepers
+    std::atomic<uint32> m_state{0};
+#endif
+};
+
+// Counting semaphore that spins briefly before sleeping, so a Signal that lands within a few
+// hundred cycles of the Wait never reaches the kernel. Signal only wakes when someone sleeps.
+class LightweightSemaphore
+{
+  public:
+    explicit LightweightSemaphore(uint32 initialCount = 0);
+    LightweightSemaphore(const LightweightSemaphore&) = delete;
+    LightweightSemaphore& operator=(const LightweightSemaphore&) = delete;
+
+    void Signal(uint32 count = 1);
+
+    // Takes one count, blocking until there is one
+    void Wait();
+    bool TryWait();
+    // Returns false if no count came within the timeout
+    bool WaitTimeout(uint32 timeout_ms);
+
+    // Only a snapshot, other threads may change it right away
+    uint32 GetCount() const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<uint32> m_count;
+    std::atomic<uint32> m_sleepers{0};
+};
+
+// One-shot or latching signal between threads. An auto reset event lets one waiter through per
+// Set and resets itself; a manual reset event stays set, letting everybody through, until Reset.
+class Event
+{
+  public:
+    enum class ResetMode : uint8
+    {
+        Auto,
+        Manual,
+    };
+
+    explicit Event(ResetMode mode = ResetMode::Auto, bool initiallySet = false);
+    Event(const Event&) = delete;
+    Event& operator=(const Event&) = delete;
+
+    void Set();
+    void Reset();
+    bool IsSet() const
+    {
+        return m_state.load(std::memory_order_acquire) != 0;
+    }
+
+    void Wait();
+    // Returns false if the event wasn't set within the timeout
+    bool WaitTimeout(uint32 timeout_ms);
+
+  private:
+    bool TryConsume();
+
+    std::atomic<uint32> m_state;
+    std::atomic<uint32> m_sleepers{0};
+    ResetMode m_mode;
+};
+
+// Holds a lock for the rest of the scope, works with anything that has Lock and Unlock
+template <typename LockType>
+class LockGuard
+{
+  public:
+    explicit LockGuard(LockType& lock)
+        : m_lock(lock)
+    {
+        m_lock.Lock();
+    }
+
+    ~LockGuard()
+    {
+        m_lock.Unlock();
+    }
+
+    LockGuard(const LockGuard&) = delete;
+    LockGuard& operator=(const LockGuard&) = delete;
+
+  private:
+    LockType& m_lock;
+};
+
+} // namespace rsbl
@@ -0,0 +1,127 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-allocator.h>
+#include <rsbl-assert.h>
+#include <rsbl-concurrent-queue.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+
+// Per-thread data without a thread_local per use. Every thread gets a small dense index the
+// first time it asks, and hands it back when it exits, so a ThreadLocal is just an array indexed
+// by it: one slot per thread, each on its own cache line, no locks and no sharing.
+//
+// Scratch memory is the other half: every thread has a LinearArena for temporary allocations,
+// and ScratchScope hands back everything allocated under it. Job and thread pool workers open
+// one around every job, so a job can allocate freely and never frees anything.
+//
+//     ScratchScope scratch;
+//     float* weights = scratch.Arena().AllocateArray<float>(count);
+//
+// Scratch memory doesn't survive a co_await: a task can carry on on another thread, and the
+// arena it allocated from gets reset under it.
+
+namespace rsbl
+{
+
+// Thread indices handed out at once. More threads than this alive at the same time is a bug.
+constexpr uint32 kMaxThreadIndices = 256;
+
+// The calling thread's index, below kMaxThreadIndices. An exited thread's index goes to the next
+// thread that asks.
+uint32 GetThreadIndex();
+
+// One T per thread, default constructed up front. Slots outlive their threads, so a thread
+// reusing an index finds the last one's value, which suits accumulators and caches. Reading the
+// other threads' slots with ForEach is only safe once they're done writing.
+template <typename T>
+class ThreadLocal
+{
+  public:
+    explicit ThreadLocal(uint32 slotCount = kMaxThreadIndices,
+                         Allocator* allocator = GetDefaultAllocator())
+        : m_slots(allocator)
+    {
+        m_slots.Resize(slotCount);
+    }
+
+    ThreadLocal(ThreadLocal&&) = delete;
+    ThreadLocal& operator=(ThreadLocal&&) = delete;
+    ThreadLocal(const ThreadLocal&) = delete;
+    ThreadLocal& operator=(const ThreadLocal&) = delete;
+
+    T& Get()
+    {
+        const uint32 index = GetThreadIndex();
+        rsblAssertMsg(index < m_slots.Size(), "More threads than the ThreadLocal has slots");
+        return m_slots[index].value;
+    }
+
+    template <typename Func>
+    void ForEach(Func&& func)
+    {
+        for (Slot& slot : m_slots)
+        {
+            func(slot.value);
+        }
+    }
+
+    uint32 SlotCount() const
+    {
+        return static_cast<uint32>(m_slots.Size());
+    }
+
+  private:
+    struct alignas(kCacheLineSize) Slot
+    {
+        T value{};
+    };
+
+    DynamicArray<Slot> m_slots;
+};
+
+// Blocks scratch arenas grow by
+constexpr uint64 kScratchBlockSize = 64 * 1024;
+
+// The arena scratch memory comes from on this thread. That's the thread's own, unless a fiber
+// scheduler put the running fiber's in its place.
+LinearArena& GetScratchArena();
+
+// For fiber schedulers: the arena GetScratchArena returns on this thread from now on, nullptr
+// for the thread's own again
+void SetScratchArena(LinearArena* arena);
+
+// Everything allocated from the arena while this is alive is handed back when it goes. Scopes
+// nest, and have to end in the order they started.
+class ScratchScope
+{
+  public:
+    ScratchScope()
+        : m_arena(GetScratchArena())
+        , m_marker(m_arena.GetMarker())
+    {
+    }
+
+    ~ScratchScope()
+    {
+        m_arena.ResetToMarker(m_marker);
+    }
+
+    ScratchScope(ScratchScope&&) = delete;
+    ScratchScope& operator=(ScratchScope&&) = delete;
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    LinearArena& Arena()
+    {
+        return m_arena;
+    }
+
+  private:
+    LinearArena& m_arena;
+    LinearArena::Marker m_marker;
+};
+
+} // namespace rsbl
@@ -0,0 +1,99 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+#include <rsbl-thread.h>
+
+// A fixed set of threads that park on a semaphore and take tasks off one shared queue, for work
+// that blocks: file reads, decompression behind a read, anything waiting on the OS. Creating the
+// threads once means a Submit costs a queue push and, if a thread is asleep, one wake up, where
+// Thread::Create costs an allocation, a thread creation and a log line every time.
+//
+// Compute work belongs in the JobSystem (rsbl-jobs.h) instead. Its workers expect jobs that
+// never block, and a task sleeping on IO there holds a core other jobs could be using.
+//
+//     ThreadPool& io = *pool;
+//     for (Buffer& buffer : buffers)
+//     {
+//         io.Submit([&buffer]() { buffer.Load(); });
+//     }
+//     io.WaitIdle();
+
+namespace rsbl
+{
+
+// Move-only, captures that don't fit inline spill into the Function pools
+using PoolTask = PooledFunction<void(), 48>;
+
+struct ThreadPoolOptions
+{
+    // Blocking tasks mostly wait, so this can be well above the core count
+    uint32 threadCount = 4;
+
+    // Tasks the queue holds. When it's full, Submit runs the task right away instead.
+    uint32 queueCapacity = 1024;
+
+    // Threads are named "<name>-N"
+    const char* name = "rsbl-pool";
+    ThreadPriority priority = ThreadPriority::Normal;
+    uint64 stackSize = 0;
+};
+
+struct ThreadPoolStats
+{
+    uint64 tasksRun = 0;
+
+    // Tasks a thread had to be woken up for, and how long from their Submit until a thread
+    // started on them. Tasks picked up by a thread that was still busy don't count, their delay
+    // is queueing rather than wake up.
+    uint64 wakeups = 0;
+    uint64 totalWakeLatencyNs = 0;
+    uint64 maxWakeLatencyNs = 0;
+
+    uint64 AverageWakeLatencyNs() const
+    {
+        return wakeups > 0 ? totalWakeLatencyNs / wakeups : 0;
+    }
+};
+
+class ThreadPool
+{
+  public:
+    // Starts the threads, fails if any of them can't be created
+    static Result<UniquePtr<ThreadPool>> Create(const ThreadPoolOptions& options = {});
+
+    // Runs whatever is still queued, then joins the threads. Tasks can't Submit from here on.
+    ~ThreadPool();
+
+    // Threads hold on to the pool, it can't move
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queues a task, from any thread, tasks included
+    void Submit(PoolTask&& task);
+
+    // Blocks until every task submitted so far has finished. Tasks submitted meanwhile (by other
+    // threads, or by the tasks) are waited for too. Never from a task, it would wait on itself.
+    void WaitIdle();
+
+    uint32 ThreadCount() const;
+
+    ThreadPoolStats GetStats() const;
+    void ResetStats();
+
+  private:
+    struct State;
+
+    ThreadPool() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
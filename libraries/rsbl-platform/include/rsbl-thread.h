@@ -10,14 +10,44 @@
 
 #include <atomic>
 
-// TODO: Support thread priorities
-// TODO: Thread-local storage helpers
-// TODO: Thread naming for debugger
-// TODO: CPU affinity control
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+#endif
+
+// Per-thread data and scratch memory are in rsbl-thread-local.h
 
 namespace rsbl
 {
 
+// Scheduling priority relative to the rest of the process. Above Normal can need privileges
+// outside Windows (CAP_SYS_NICE on Linux), without them the thread stays at Normal.
+enum class ThreadPriority : uint8
+{
+    Lowest,
+    BelowNormal,
+    Normal,
+    AboveNormal,
+    Highest,
+};
+
+struct ThreadCreateInfo
+{
+    // Shows up in debuggers and profilers. Copied, and cut down to what the platform takes
+    // (15 characters on Linux).
+    const char* name = nullptr;
+
+    // Logical processors the thread may run on, bit i for processor i of the creating thread's
+    // processor group. 0 leaves it to the OS.
+    uint64 affinityMask = 0;
+
+    ThreadPriority priority = ThreadPriority::Normal;
+
+    // Bytes of stack, 0 for the platform default
+    uint64 stackSize = 0;
+};
+
 // Opaque handle to platform-specific thread data
 struct ThreadNativeData
 {
@@ -33,6 +63,12 @@ class Thread
     // Returns a UniquePtr to keep the thread object at a fixed memory location
     static Result<UniquePtr<Thread>> Create(Function<Result<>()>&& thread_func);
 
+    // Same, with a name, affinity, priority and stack size. The settings are in place before
+    // thread_func starts. Fails if the thread can't be created, or the affinity mask doesn't
+    // cover any processor; a priority the process isn't allowed is logged and skipped instead.
+    static Result<UniquePtr<Thread>> Create(const ThreadCreateInfo& info,
+                                            Function<Result<>()>&& thread_func);
+
     // Destructor - will join if not already joined
     ~Thread();
 
@@ -71,9 +107,33 @@ class Thread
     // Yield current thread's time slice to other threads
     static void ThreadYield();
 
+    // Hint for the body of a spin-wait loop: pause on x86, yield on ARM. Keeps the thread on its
+    // core, unlike ThreadYield, but lets an SMT sibling run and saves power while it waits.
+    static void SpinPause()
+    {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(_M_ARM64)
+        __yield();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+
     // Get the current thread's ID as a uint64
     static uint64 GetCurrentThreadId();
 
+    // Number of hardware threads (logical processors) across all processor groups, at least 1
+    static uint32 GetHardwareThreadCount();
+
+    // The same controls as ThreadCreateInfo, for threads rsbl didn't create (the main thread)
+    static Result<> SetCurrentThreadName(const char* name);
+    static Result<> SetCurrentThreadAffinity(uint64 affinityMask);
+    static Result<> SetCurrentThreadPriority(ThreadPriority priority);
+
+    // Copies the calling thread's name into buffer, empty if it has none
+    static Result<> GetCurrentThreadName(char* buffer, uint32 bufferSize);
+
   private:
     // Private constructor - use Create() factory method
     Thread();
@@ -84,6 +144,13 @@ class Thread
     // Platform-specific thread creation
     static Result<ThreadNativeData> CreatePlatformThread(Thread* thread_obj);
 
+    // Settings from the ThreadCreateInfo, applied by the platform before the function runs
+    static constexpr uint32 kMaxNameLength = 64;
+    char m_name[kMaxNameLength];
+    uint64 m_affinityMask = 0;
+    ThreadPriority m_priority = ThreadPriority::Normal;
+    uint64 m_stackSize = 0;
+
     // The user's function to execute on the thread
     Function<Result<>()> m_threadFunc;
 
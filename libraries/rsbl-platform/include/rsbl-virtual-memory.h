@@ -0,0 +1,94 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-allocator.h>
+#include <rsbl-int-types.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-result.h>
+
+// Address space and the memory behind it, handled apart. An arena or a big array can reserve
+// all the addresses it could ever need up front and commit pages as it grows into them, so it
+// never moves and nothing pointing into it goes stale:
+//
+//     void* base = ReserveVirtual(64ull << 30).Value();   // 64 GB of addresses, no memory
+//     CommitPages(base, 16 * GetPageInfo().pageSize);      // the first 16 pages, read/write
+//     ...
+//     ReleaseVirtual(base, 64ull << 30);
+//
+// VirtualAlloc on Windows, mmap and mprotect elsewhere. None of it goes through an rsbl
+// allocator, so callers charge what they commit to a tag with RecordAllocation themselves.
+
+namespace rsbl
+{
+
+struct PageInfo
+{
+    // What CommitPages and DecommitPages work in
+    uint64 pageSize = 0;
+    // What ReserveVirtual rounds to and aligns at, 64 KB on Windows, a page elsewhere
+    uint64 reserveGranularity = 0;
+    // What AllocLargePages works in, 2 MB on x64. 0 if the system has none.
+    uint64 largePageSize = 0;
+};
+
+// Queried once, the same for the life of the process
+const PageInfo& GetPageInfo();
+
+// Reserves size bytes of addresses, rounded up to reserveGranularity, with no memory behind
+// them. Touching them before CommitPages faults.
+Result<void*> ReserveVirtual(uint64 size);
+
+// Gives address the size bytes of a reservation back, both as ReserveVirtual was given them
+void ReleaseVirtual(void* address, uint64 size);
+
+// Backs pages of a reservation with memory, read/write and zeroed. address and size are whole
+// pages. Committing pages that already are is fine and leaves what's in them.
+Result<> CommitPages(void* address, uint64 size);
+
+// CommitPages, with the memory on a NUMA node (CpuTopology's index for it) where it can be, so
+// threads on that node's processors don't reach across to another socket for it. The OS falls
+// back to other nodes when the node runs out. VirtualAllocExNuma on Windows, mbind on Linux;
+// elsewhere, or with one node, it's CommitPages.
+Result<> CommitPagesOnNode(void* address, uint64 size, uint32 numaNode);
+
+// Hands the memory behind whole pages back to the OS, keeping the addresses reserved. Their
+// contents are gone; committed again, they read as zeroes.
+void DecommitPages(void* address, uint64 size);
+
+// Committed read/write memory on large pages, which cover 512 times what a page does with a
+// single TLB entry, for big long-lived heaps that are walked all over (asset heaps, scene
+// arrays). size is rounded up to largePageSize. Large pages can't be paged out, so the OS only
+// gives them to those allowed: on Windows the user needs the "Lock pages in memory" right
+// (SeLockMemoryPrivilege, which this enables for the process), on Linux huge pages have to be
+// set aside beforehand (vm.nr_hugepages). Fails otherwise, and callers fall back to
+// ReserveVirtual and CommitPages.
+Result<void*> AllocLargePages(uint64 size);
+
+// address and size as AllocLargePages was given them
+void FreeLargePages(void* address, uint64 size);
+
+// Allocator for the big blocks a worker keeps to itself (arena blocks, queues) on its NUMA
+// node. Every allocation is pages of its own, committed with CommitPagesOnNode, so it's for
+// sizes of a page or more, not small objects. Alignment up to reserveGranularity. Any thread,
+// and what's committed is charged to tag.
+class NumaAllocator : public Allocator
+{
+  public:
+    NumaAllocator(uint32 numaNode, MemoryTag tag);
+
+    void* Allocate(uint64 size, uint64 alignment) override;
+    void Free(void* ptr, uint64 size, uint64 alignment) override;
+
+    uint32 NumaNode() const
+    {
+        return m_numaNode;
+    }
+
+  private:
+    uint32 m_numaNode = 0;
+    MemoryTag m_tag;
+};
+
+} // namespace rsbl
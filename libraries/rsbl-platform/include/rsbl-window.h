@@ -3,14 +3,13 @@
 
 #pragma once
 
+#include <rsbl-array-view.h>
 #include <rsbl-math-types.h>
 #include <rsbl-ptr.h>
 #include <rsbl-result.h>
 
-// TODO: capture input state
 // TODO: Handle Window callback (for imgui stuff)
 // TODO: Cursor management?
-// TODO: handle fullscreen, esp relevant for mobile
 // TODO: Surface the window and client regions thru Window API?
 // TODO: add window tests? Not sure how they'd actually look
 // TODO: hook into imgui window management
@@ -25,10 +24,78 @@ enum class WindowMessageResult
     Quit,     // Quit message received
 };
 
+// Which thread pumps the window's OS messages
+enum class WindowThreading : uint8
+{
+    // ProcessMessages does, on the thread that created the window. While the window is dragged
+    // or resized the OS keeps that thread in a loop of its own, so nothing else runs on it.
+    CallerThread,
+    // A thread of the window's own does, queueing what changed for ProcessMessages to pick up. A
+    // render loop calling ProcessMessages keeps going while the window is dragged or resized.
+    MessageThread,
+};
+
+enum class WindowMode : uint8
+{
+    Windowed,
+    // Borderless, covering the whole of the monitor the window is mostly on. With nothing else
+    // over it, a flip model swapchain's presents go straight to the screen (independent flip)
+    // rather than through the compositor, which saves a frame. Exclusive fullscreen is the
+    // swapchain's to take, see GaSetExclusiveFullscreen.
+    Fullscreen,
+};
+
+struct WindowCreateInfo
+{
+    // Of the client area in physical pixels, what gets rendered to
+    uint2 size = {640, 480};
+    // -1 leaves it to the OS
+    int2 position = {-1, -1};
+    WindowThreading threading = WindowThreading::CallerThread;
+    // Read mouse and keyboard as raw input, for PopInputEvent. The window's usual mouse and key
+    // messages keep coming either way.
+    bool rawInput = false;
+};
+
+enum class InputEventType : uint8
+{
+    MouseMove,   // dx, dy in the mouse's own counts, unaccelerated
+    MouseButton, // button, pressed
+    MouseWheel,  // dy vertical, dx horizontal, 120 to a notch
+    Key,         // key, scanCode, pressed
+};
+
+enum class MouseButton : uint8
+{
+    Left,
+    Right,
+    Middle,
+    X1,
+    X2,
+};
+
+struct InputEvent
+{
+    // Clock::NowTicks when it was read from the OS. Input read in one batch shares one.
+    uint64 timestampTicks = 0;
+    InputEventType type = InputEventType::MouseMove;
+    MouseButton button = MouseButton::Left;
+    bool pressed = false;
+    // Virtual key code, VK_* on Windows
+    uint16 key = 0;
+    // Where the key is on the keyboard, whatever the layout. Extended keys have 0xE000 set.
+    uint16 scanCode = 0;
+    int32 dx = 0;
+    int32 dy = 0;
+};
+
 // Opaque handle to platform-specific window data
 struct WindowNativeData
 {
-    void* platform_handle;
+    // HWND on Windows, the X11 Window (an XID) on Linux
+    void* platform_handle = nullptr;
+    // What the window belongs to: the HINSTANCE on Windows, the X11 Display* on Linux
+    void* display_handle = nullptr;
 };
 
 class Window
@@ -36,13 +103,14 @@ class Window
   public:
     // Factory method to create a window
     static Result<UniquePtr<Window>> Create(uint2 size, int2 position = {-1, -1});
+    static Result<UniquePtr<Window>> Create(const WindowCreateInfo& info);
 
     // Destructor
     ~Window();
 
-    // Moveable, not copyable
-    Window(Window&&) noexcept = default;
-    Window& operator=(Window&&) noexcept = default;
+    // Not moveable or copyable, the OS and the message thread hold on to it
+    Window(Window&&) = delete;
+    Window& operator=(Window&&) = delete;
     Window(const Window&) = delete;
     Window& operator=(const Window&) = delete;
 
@@ -52,10 +120,48 @@ class Window
     void Show();
     void Hide();
     bool IsVisible() const;
+    // Nothing of it shows, so there's no point rendering to it
+    bool IsMinimized() const;
 
-    // Process pending OS messages (non-blocking)
+    // Process pending OS messages (non-blocking). With WindowThreading::MessageThread this only
+    // takes what the message thread queued since the last call; size, position and quit only
+    // change in here either way, so the caller sees them at the same point of its loop.
     WindowMessageResult ProcessMessages();
 
+    // ProcessMessages, once there's something to process: blocks until a message comes in (or,
+    // with WindowThreading::MessageThread, the message thread queues something), one of
+    // extraWaitHandles is signalled, or timeoutMs is up, without using any CPU meanwhile. For a
+    // loop with nothing to render, a minimized window say, instead of spinning on
+    // ProcessMessages. It can return early with nothing new, a loop just calls it again.
+    //
+    // extraWaitHandles are the platform's waitable handles, at most 62 of them: HANDLEs on
+    // Windows, file descriptors cast to pointers on Linux, which wake it by being readable.
+    // Waiting takes an auto-reset handle's signal, so signalledHandle gets the index of the one
+    // that woke the wait, or ~0u if none did.
+    WindowMessageResult WaitForEvents(uint32 timeoutMs,
+                                      ArrayView<void* const> extraWaitHandles = {},
+                                      uint32* signalledHandle = nullptr);
+
+    // The oldest raw input event not yet taken, false once there are none. Call it from the
+    // thread that calls ProcessMessages; with WindowThreading::CallerThread nothing new arrives
+    // until ProcessMessages runs. Meant to be drained right before the input is used, so what's
+    // simulated and rendered is as recent as it can be.
+    bool PopInputEvent(InputEvent& event);
+
+    // Raw input events that were read while the queue was full, and so lost
+    uint64 DroppedInputEvents() const;
+
+    // Copied, the title can go once it's set. Doesn't wait on the message thread.
+    void SetTitle(const char* title);
+
+    // Going fullscreen and back resizes the window, which CheckResize reports once it has.
+    // Doesn't wait on the message thread.
+    void SetMode(WindowMode mode);
+    WindowMode Mode() const
+    {
+        return m_mode;
+    }
+
     // Dimension and position accessors
     uint32 Width() const
     {
@@ -74,6 +180,7 @@ class Window
         return m_position.y;
     }
 
+    // Of the client area in physical pixels, what a swapchain covering it is sized at
     uint2 Size() const
     {
         return m_size;
@@ -83,6 +190,13 @@ class Window
         return m_position;
     }
 
+    // The monitor's DPI over 96, what anything sized for 96 DPI (text, UI) is scaled by to look
+    // the same size on it. Changes when the window moves to another monitor, along with a resize.
+    float DpiScale() const
+    {
+        return m_dpiScale;
+    }
+
     bool CheckResize()
     {
         const bool state = m_resizeFlagged;
@@ -90,27 +204,26 @@ class Window
         return state;
     }
 
-    // Unfortunate to leak some platform-specific bits into header, but this is simpler than doing
-    // some PIMPL thing
-#ifdef _WIN32
-    // Platform-specific window procedure
-    static long long WindowProc(void* handle,
-                                unsigned int uMsg,
-                                unsigned long long wParam,
-                                long long lParam);
-
-#endif
+    // Platform-specific: what the window procedure hands over to ProcessMessages on Windows, the
+    // display connection on X11
+    struct MessageState;
 
   protected:
     // Private constructor - use Create() factory method
     Window(uint2 size, int2 position);
+
+    // Applies what's come in since the last call, returns Quit if the window went away
+    WindowMessageResult DrainEvents();
     uint2 m_size;
     int2 m_position;
+    float m_dpiScale = 1.0f;
+    WindowMode m_mode = WindowMode::Windowed;
 
     bool m_resizeFlagged = false;
 
     // Platform-specific implementation data
     WindowNativeData m_platformData;
+    MessageState* m_messages = nullptr;
 };
 
 } // namespace rsbl
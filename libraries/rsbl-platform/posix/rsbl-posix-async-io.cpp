@@ -0,0 +1,473 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-async-io.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-concurrent-queue.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-os-trace.h>
+#include <rsbl-sync.h>
+#include <rsbl-thread-pool.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+    #include <linux/io_uring.h>
+    #include <sys/syscall.h>
+#endif
+
+// io_uring goes through the raw syscalls rather than liburing, it's only three of them. The
+// rings are shared with the kernel: we write submissions and the submission tail, and read
+// completions up to the completion tail, with acquire and release on the indices the other
+// side writes.
+
+namespace rsbl
+{
+
+namespace
+{
+// Fills the buffer unless the file ends first, like the kernel queues do
+AsyncIoCompletion BlockingRead(const AsyncRead& read)
+{
+    Result<uint64> bytes = ReadFileAt(read.file, read.buffer, read.offset);
+    return {read.userData, bytes ? bytes.Value() : 0, static_cast<bool>(bytes)};
+}
+
+#if defined(__linux__)
+int IoUringSetup(uint32 entries, io_uring_params* params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int fd, uint32 toSubmit, uint32 minComplete, uint32 flags)
+{
+    return static_cast<int>(
+        ::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int fd, uint32 opcode, void* arg, uint32 count)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+template <typename T>
+T* RingField(void* ring, uint32 offset)
+{
+    return reinterpret_cast<T*>(static_cast<uint8*>(ring) + offset);
+}
+#endif
+} // namespace
+
+struct AsyncIo::State
+{
+    explicit State(const AsyncIoOptions& options)
+        : queueDepth(options.queueDepth)
+        , completions(options.queueDepth, GetTaggedAllocator(MemoryTag::Platform))
+    {
+        queued.Reserve(options.queueDepth);
+    }
+
+    ~State();
+
+    bool SetUpIoUring();
+    Result<> SubmitIoUring();
+    // Submits whatever's still in the ring too, and waits for minComplete completions
+    bool EnterIoUring(uint32 minComplete);
+    uint32 PollIoUring(AsyncIoCompletion* out, uint32 maxCount);
+
+    AsyncIoBackend backend = AsyncIoBackend::Threads;
+    uint32 queueDepth = 0;
+    uint32 inFlight = 0;
+    DynamicArray<AsyncRead> queued{GetTaggedAllocator(MemoryTag::Platform)};
+
+    // io_uring
+    int ringFd = -1;
+    void* sqRing = nullptr;
+    uint64 sqRingSize = 0;
+    void* cqRing = nullptr;
+    uint64 cqRingSize = 0;
+    void* sqes = nullptr;
+    uint64 sqesSize = 0;
+    // In the ring but not taken by the kernel yet, after a failed or interrupted enter
+    uint32 unsubmitted = 0;
+    uint32* sqTail = nullptr;
+    uint32 sqMask = 0;
+    uint32* sqArray = nullptr;
+    uint32* cqHead = nullptr;
+    uint32* cqTail = nullptr;
+    uint32 cqMask = 0;
+    void* cqes = nullptr;
+
+    // Threads, which push completions from the pool and count them in the semaphore
+    UniquePtr<ThreadPool> pool;
+    MpmcQueue<AsyncIoCompletion> completions;
+    LightweightSemaphore finished;
+};
+
+AsyncIo::State::~State()
+{
+    // The pool joins first, its tasks push into the queue
+    pool.Reset();
+
+#if defined(__linux__)
+    if (sqes != nullptr)
+    {
+        ::munmap(sqes, sqesSize);
+    }
+    if (cqRing != nullptr && cqRing != sqRing)
+    {
+        ::munmap(cqRing, cqRingSize);
+    }
+    if (sqRing != nullptr)
+    {
+        ::munmap(sqRing, sqRingSize);
+    }
+    if (ringFd >= 0)
+    {
+        ::close(ringFd);
+    }
+#endif
+}
+
+bool AsyncIo::State::SetUpIoUring()
+{
+#if defined(__linux__)
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringFd = IoUringSetup(queueDepth, &params);
+    if (ringFd < 0)
+    {
+        // Old kernel, or turned off (kernel.io_uring_disabled, seccomp in containers)
+        return false;
+    }
+
+    // IORING_OP_READ came with 5.6, the same release as probing for it
+    alignas(io_uring_probe) uint8 storage[sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op)];
+    memset(storage, 0, sizeof(storage));
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage);
+    if (IoUringRegister(ringFd, IORING_REGISTER_PROBE, probe, 256) < 0 ||
+        probe->ops_len <= IORING_OP_READ ||
+        (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) == 0)
+    {
+        return false;
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap)
+    {
+        sqRingSize = sqRingSize > cqRingSize ? sqRingSize : cqRingSize;
+    }
+
+    const int protection = PROT_READ | PROT_WRITE;
+    const int flags = MAP_SHARED | MAP_POPULATE;
+    void* sq_ring = ::mmap(nullptr, sqRingSize, protection, flags, ringFd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED)
+    {
+        return false;
+    }
+    sqRing = sq_ring;
+
+    if (single_mmap)
+    {
+        cqRing = sqRing;
+    }
+    else
+    {
+        void* cq_ring =
+            ::mmap(nullptr, cqRingSize, protection, flags, ringFd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED)
+        {
+            return false;
+        }
+        cqRing = cq_ring;
+    }
+
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqe_array = ::mmap(nullptr, sqesSize, protection, flags, ringFd, IORING_OFF_SQES);
+    if (sqe_array == MAP_FAILED)
+    {
+        return false;
+    }
+    sqes = sqe_array;
+
+    sqTail = RingField<uint32>(sqRing, params.sq_off.tail);
+    sqMask = *RingField<uint32>(sqRing, params.sq_off.ring_mask);
+    sqArray = RingField<uint32>(sqRing, params.sq_off.array);
+    cqHead = RingField<uint32>(cqRing, params.cq_off.head);
+    cqTail = RingField<uint32>(cqRing, params.cq_off.tail);
+    cqMask = *RingField<uint32>(cqRing, params.cq_off.ring_mask);
+    cqes = RingField<void>(cqRing, params.cq_off.cqes);
+
+    backend = AsyncIoBackend::IoUring;
+    return true;
+#else
+    return false;
+#endif
+}
+
+Result<> AsyncIo::State::SubmitIoUring()
+{
+#if defined(__linux__)
+    // Only we write the tail, the kernel only reads it
+    uint32 tail = *sqTail;
+    for (const AsyncRead& read : queued)
+    {
+        const uint32 index = tail & sqMask;
+        io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes) + index;
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = static_cast<int>(read.file);
+        sqe->addr = reinterpret_cast<uint64>(read.buffer.Data());
+        sqe->len = static_cast<uint32>(read.buffer.Size());
+        sqe->off = read.offset;
+        sqe->user_data = read.userData;
+        sqArray[index] = index;
+        ++tail;
+    }
+    __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+    unsubmitted += static_cast<uint32>(queued.Size());
+
+    while (unsubmitted > 0)
+    {
+        if (!EnterIoUring(0))
+        {
+            // Whatever wasn't taken stays in the ring, and goes with the next enter
+            return {ErrorCategory::Io, "io_uring_enter failed to submit reads"};
+        }
+    }
+    return ResultCode::Success;
+#else
+    return {ErrorCategory::Platform, "No io_uring on this platform"};
+#endif
+}
+
+bool AsyncIo::State::EnterIoUring(uint32 minComplete)
+{
+#if defined(__linux__)
+    const uint32 flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int submitted = 0;
+    do
+    {
+        submitted = IoUringEnter(ringFd, unsubmitted, minComplete, flags);
+    } while (submitted < 0 && errno == EINTR);
+
+    if (submitted < 0)
+    {
+        return false;
+    }
+    unsubmitted -= static_cast<uint32>(submitted);
+    return true;
+#else
+    rsblUnused(minComplete);
+    return false;
+#endif
+}
+
+uint32 AsyncIo::State::PollIoUring(AsyncIoCompletion* out, uint32 maxCount)
+{
+#if defined(__linux__)
+    uint32 head = *cqHead;
+    const uint32 tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    uint32 count = 0;
+    while (head != tail && count < maxCount)
+    {
+        const io_uring_cqe& cqe = static_cast<const io_uring_cqe*>(cqes)[head & cqMask];
+        const bool succeeded = cqe.res >= 0;
+        out[count++] = {cqe.user_data, succeeded ? static_cast<uint64>(cqe.res) : 0, succeeded};
+        ++head;
+    }
+    // Hands the slots back to the kernel
+    __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    return count;
+#else
+    rsblUnused(out);
+    rsblUnused(maxCount);
+    return 0;
+#endif
+}
+
+Result<UniquePtr<AsyncIo>> AsyncIo::Create(const AsyncIoOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    if (options.queueDepth == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "AsyncIo needs a queue depth of at least 1"};
+    }
+
+    UniquePtr<AsyncIo> io(new AsyncIo());
+    io->m_state = new State(options);
+    State* state = io->m_state;
+
+    if (options.allowKernelQueues && state->SetUpIoUring())
+    {
+        return rsblMove(io);
+    }
+
+    // Half set up rings are cleaned up with the State, along with everything else
+    ThreadPoolOptions pool_options;
+    pool_options.threadCount = options.fallbackThreads > 0 ? options.fallbackThreads : 1;
+    pool_options.queueCapacity = options.queueDepth;
+    pool_options.name = "rsbl-io";
+    Result<UniquePtr<ThreadPool>> pool = ThreadPool::Create(pool_options);
+    if (!pool)
+    {
+        return pool.FailureText();
+    }
+    state->pool = rsblMove(pool.Value());
+    state->backend = AsyncIoBackend::Threads;
+    return rsblMove(io);
+}
+
+AsyncIo::~AsyncIo()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+
+    AsyncIoCompletion drained[32];
+    while (m_state->inFlight > 0)
+    {
+        WaitCompletions(drained, 32);
+    }
+    delete m_state;
+}
+
+Result<FileHandle> AsyncIo::OpenForRead(const char* path, FileOpenFlags flags)
+{
+    return OpenFile(path, FileOpenMode::Read, flags);
+}
+
+bool AsyncIo::QueueRead(const AsyncRead& read)
+{
+    rsblAssertMsg(read.buffer.Size() <= kMaxAsyncReadSize, "Split reads over kMaxAsyncReadSize");
+    if (m_state->queued.Size() + m_state->inFlight >= m_state->queueDepth)
+    {
+        return false;
+    }
+    m_state->queued.PushBack(read);
+    return true;
+}
+
+Result<> AsyncIo::Submit()
+{
+    State* state = m_state;
+    if (state->queued.IsEmpty())
+    {
+        return ResultCode::Success;
+    }
+
+    if (OsTraceEnabled(OsTraceEvent::IoSubmit)) [[unlikely]]
+    {
+        for (const AsyncRead& read : state->queued)
+        {
+            OsTraceMark(OsTraceEvent::IoSubmit,
+                        AsyncIoBackendName(state->backend),
+                        read.userData,
+                        read.buffer.Size());
+        }
+    }
+
+    const uint32 count = static_cast<uint32>(state->queued.Size());
+    if (state->backend == AsyncIoBackend::IoUring)
+    {
+        Result<> submitted = state->SubmitIoUring();
+        state->inFlight += count;
+        state->queued.Clear();
+        return submitted;
+    }
+
+    for (const AsyncRead& read : state->queued)
+    {
+        state->pool->Submit([state, read]() {
+            const bool pushed = state->completions.TryPush(BlockingRead(read));
+            rsblAssert(pushed);
+            state->finished.Signal();
+        });
+    }
+    state->inFlight += count;
+    state->queued.Clear();
+    return ResultCode::Success;
+}
+
+uint32 AsyncIo::PollCompletions(AsyncIoCompletion* completions, uint32 maxCount)
+{
+    State* state = m_state;
+    uint32 count = 0;
+    if (state->backend == AsyncIoBackend::IoUring)
+    {
+        count = state->PollIoUring(completions, maxCount);
+    }
+    else
+    {
+        // Every signal comes after its push, so a taken count always has a completion behind it
+        while (count < maxCount && state->finished.TryWait())
+        {
+            const bool popped = state->completions.TryPop(completions[count]);
+            rsblAssert(popped);
+            ++count;
+        }
+    }
+    if (OsTraceEnabled(OsTraceEvent::IoComplete)) [[unlikely]]
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            OsTraceMark(OsTraceEvent::IoComplete,
+                        AsyncIoBackendName(state->backend),
+                        completions[i].userData,
+                        completions[i].bytesRead);
+        }
+    }
+    state->inFlight -= count;
+    return count;
+}
+
+uint32 AsyncIo::WaitCompletions(AsyncIoCompletion* completions, uint32 maxCount)
+{
+    State* state = m_state;
+    if (state->inFlight == 0 || maxCount == 0)
+    {
+        return 0;
+    }
+
+    for (;;)
+    {
+        const uint32 count = PollCompletions(completions, maxCount);
+        if (count > 0)
+        {
+            return count;
+        }
+
+        if (state->backend == AsyncIoBackend::IoUring)
+        {
+            const bool entered = state->EnterIoUring(1);
+            rsblAssertMsg(entered, "io_uring_enter failed to wait");
+        }
+        else
+        {
+            // Put back for the poll to take again
+            state->finished.Wait();
+            state->finished.Signal();
+        }
+    }
+}
+
+uint32 AsyncIo::InFlight() const
+{
+    return m_state->inFlight;
+}
+
+AsyncIoBackend AsyncIo::Backend() const
+{
+    return m_state->backend;
+}
+
+} // namespace rsbl
@@ -0,0 +1,36 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-clock.h"
+
+#include <time.h>
+
+namespace rsbl
+{
+
+// CLOCK_MONOTONIC already counts nanoseconds, so a tick is a nanosecond
+uint64 Clock::NowTicks()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64>(now.tv_sec) * 1'000'000'000ull + static_cast<uint64>(now.tv_nsec);
+}
+
+uint64 Clock::TicksPerSecond()
+{
+    return 1'000'000'000ull;
+}
+
+uint64 Clock::TicksToNs(uint64 ticks)
+{
+    return ticks;
+}
+
+uint64 Clock::ThreadCpuNs()
+{
+    timespec used;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &used);
+    return static_cast<uint64>(used.tv_sec) * 1'000'000'000ull + static_cast<uint64>(used.tv_nsec);
+}
+
+} // namespace rsbl
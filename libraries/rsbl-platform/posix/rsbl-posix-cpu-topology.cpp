@@ -0,0 +1,261 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "../rsbl-cpu-topology-internal.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-function.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace rsbl::Internal
+{
+
+#if defined(__linux__)
+
+namespace
+{
+// Sysfs files are tiny, one read gets all of it
+bool ReadSysFile(const char* path, char* buffer, uint32 bufferSize)
+{
+    const int file = open(path, O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        return false;
+    }
+    const ssize_t length = read(file, buffer, bufferSize - 1);
+    close(file);
+    if (length <= 0)
+    {
+        return false;
+    }
+    buffer[length] = '\0';
+    return true;
+}
+
+// Visits every id in a cpu list like "0-3,8,10-11"
+void ForEachInCpuList(const char* list, FunctionRef<void(uint32)> visit)
+{
+    const char* cursor = list;
+    while (*cursor >= '0' && *cursor <= '9')
+    {
+        char* end = nullptr;
+        const uint32 first = static_cast<uint32>(strtoul(cursor, &end, 10));
+        uint32 last = first;
+        if (*end == '-')
+        {
+            last = static_cast<uint32>(strtoul(end + 1, &end, 10));
+        }
+        for (uint32 id = first; id <= last; ++id)
+        {
+            visit(id);
+        }
+        cursor = *end == ',' ? end + 1 : end;
+    }
+}
+
+// Groups are keyed by the first processor in their shared list
+bool ReadListKey(const char* path, uint32& key)
+{
+    char text[1024];
+    if (!ReadSysFile(path, text, sizeof(text)) || text[0] < '0' || text[0] > '9')
+    {
+        return false;
+    }
+    key = static_cast<uint32>(strtoul(text, nullptr, 10));
+    return true;
+}
+
+uint64 ParseCacheSize(const char* text)
+{
+    char* end = nullptr;
+    uint64 size = strtoull(text, &end, 10);
+    if (*end == 'K')
+    {
+        size *= 1024;
+    }
+    else if (*end == 'M')
+    {
+        size *= 1024 * 1024;
+    }
+    return size;
+}
+
+void ReadCaches(RawCpuTopology& raw, RawLogicalProcessor& processor)
+{
+    // Without cache info, assume a private L2 and one shared L3
+    processor.l2Key = processor.coreKey;
+    processor.l3Key = 0;
+
+    for (uint32 index = 0; index < 16; ++index)
+    {
+        char path[128];
+        char text[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/level",
+                 processor.id, index);
+        if (!ReadSysFile(path, text, sizeof(text)))
+        {
+            break;
+        }
+        const uint32 level = static_cast<uint32>(strtoul(text, nullptr, 10));
+        if (level != 2 && level != 3)
+        {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/type",
+                 processor.id, index);
+        if (!ReadSysFile(path, text, sizeof(text)) || text[0] == 'I')
+        {
+            continue; // Instruction caches don't hold data
+        }
+
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu%u/cache/index%u/shared_cpu_list", processor.id,
+                 index);
+        ReadListKey(path, level == 2 ? processor.l2Key : processor.l3Key);
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/size",
+                 processor.id, index);
+        if (ReadSysFile(path, text, sizeof(text)))
+        {
+            (level == 2 ? raw.l2Bytes : raw.l3Bytes) = ParseCacheSize(text);
+        }
+
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu%u/cache/index%u/coherency_line_size", processor.id,
+                 index);
+        if (ReadSysFile(path, text, sizeof(text)))
+        {
+            raw.cacheLineBytes = static_cast<uint32>(strtoul(text, nullptr, 10));
+        }
+    }
+}
+
+// Slot per processor id, for filling in what's listed per node or per core type
+RawLogicalProcessor* FindProcessor(RawCpuTopology& raw, uint32 id)
+{
+    for (RawLogicalProcessor& processor : raw.logical)
+    {
+        if (processor.id == id)
+        {
+            return &processor;
+        }
+    }
+    return nullptr;
+}
+
+void ReadNumaNodes(RawCpuTopology& raw)
+{
+    // Node numbers can have gaps, so look a little past the last one found
+    uint32 misses = 0;
+    for (uint32 node = 0; misses < 64; ++node)
+    {
+        char path[96];
+        char list[1024];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+        if (!ReadSysFile(path, list, sizeof(list)))
+        {
+            ++misses;
+            continue;
+        }
+        misses = 0;
+        ForEachInCpuList(list, [&raw, node](uint32 id) {
+            if (RawLogicalProcessor* processor = FindProcessor(raw, id))
+            {
+                processor->numaNode = node;
+            }
+        });
+    }
+}
+
+void ReadEfficiencyClasses(RawCpuTopology& raw)
+{
+    // Intel hybrid parts list their E-cores under cpu_atom
+    char list[1024];
+    if (ReadSysFile("/sys/devices/cpu_atom/cpus", list, sizeof(list)))
+    {
+        for (RawLogicalProcessor& processor : raw.logical)
+        {
+            processor.efficiencyClass = 1;
+        }
+        ForEachInCpuList(list, [&raw](uint32 id) {
+            if (RawLogicalProcessor* processor = FindProcessor(raw, id))
+            {
+                processor->efficiencyClass = 0;
+            }
+        });
+        return;
+    }
+
+    // ARM big.LITTLE reports a relative capacity per processor, 1024 for the biggest
+    for (RawLogicalProcessor& processor : raw.logical)
+    {
+        char path[96];
+        char text[32];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpu_capacity", processor.id);
+        if (!ReadSysFile(path, text, sizeof(text)))
+        {
+            return;
+        }
+        processor.efficiencyClass = static_cast<uint8>(strtoul(text, nullptr, 10) >> 8);
+    }
+    uint8 lowest = 255;
+    for (const RawLogicalProcessor& processor : raw.logical)
+    {
+        lowest = processor.efficiencyClass < lowest ? processor.efficiencyClass : lowest;
+    }
+    for (RawLogicalProcessor& processor : raw.logical)
+    {
+        processor.efficiencyClass -= lowest;
+    }
+}
+} // namespace
+
+bool QueryCpuTopology(RawCpuTopology& raw)
+{
+    char online[1024];
+    if (!ReadSysFile("/sys/devices/system/cpu/online", online, sizeof(online)))
+    {
+        return false;
+    }
+
+    ForEachInCpuList(online, [&raw](uint32 id) {
+        RawLogicalProcessor processor;
+        processor.id = id;
+        processor.coreKey = id;
+
+        char path[96];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/core_cpus_list", id);
+        if (!ReadListKey(path, processor.coreKey))
+        {
+            // Older kernels
+            snprintf(path, sizeof(path),
+                     "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", id);
+            ReadListKey(path, processor.coreKey);
+        }
+        ReadCaches(raw, processor);
+        raw.logical.PushBack(processor);
+    });
+
+    ReadNumaNodes(raw);
+    ReadEfficiencyClasses(raw);
+    return !raw.logical.IsEmpty();
+}
+
+#else
+
+bool QueryCpuTopology(RawCpuTopology& raw)
+{
+    // No topology query here yet, the caller falls back to a flat layout
+    rsblUnused(raw);
+    return false;
+}
+
+#endif
+
+} // namespace rsbl::Internal
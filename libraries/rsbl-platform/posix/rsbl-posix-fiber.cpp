@@ -0,0 +1,127 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-fiber.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-memory-tracking.h>
+
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+// ucontext is deprecated by POSIX but still the only portable way in. swapcontext saves and
+// restores the signal mask, a syscall per switch, which is fine for parking a waiting job but
+// wouldn't be for switching every job.
+
+namespace rsbl
+{
+
+namespace
+{
+struct PosixFiber
+{
+    ucontext_t context;
+    // Stack mapping, with a guard page at the bottom. nullptr for thread fibers.
+    void* mapping = nullptr;
+    uint64 mappingSize = 0;
+    Fiber::EntryPoint entry = nullptr;
+    void* userData = nullptr;
+};
+
+// makecontext only passes ints, so the pointer comes through in two halves
+void FiberEntry(uint32 low, uint32 high)
+{
+    const uintptr_t address = (static_cast<uintptr_t>(high) << 32) | low;
+    const PosixFiber* fiber = reinterpret_cast<const PosixFiber*>(address);
+    fiber->entry(fiber->userData);
+
+    // There's no uc_link, returning would end the thread
+    rsblAssertMsg(false, "Fiber entry points must never return");
+}
+} // namespace
+
+Result<UniquePtr<Fiber>> Fiber::Create(uint64 stackSize, EntryPoint entry, void* userData)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    const uint64 page_size = static_cast<uint64>(sysconf(_SC_PAGESIZE));
+    const uint64 stack_size = (stackSize + page_size - 1) / page_size * page_size;
+    const uint64 mapping_size = stack_size + page_size;
+
+    void* mapping = mmap(nullptr,
+                         mapping_size,
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS,
+                         -1,
+                         0);
+    if (mapping == MAP_FAILED)
+    {
+        return {ErrorCategory::OutOfMemory, "Failed to map a fiber stack"};
+    }
+
+    // Stacks grow down, so an overflow runs into the guard page and faults
+    mprotect(mapping, page_size, PROT_NONE);
+
+    PosixFiber* data = new PosixFiber();
+    data->mapping = mapping;
+    data->mappingSize = mapping_size;
+    data->entry = entry;
+    data->userData = userData;
+    if (getcontext(&data->context) != 0)
+    {
+        munmap(mapping, mapping_size);
+        delete data;
+        return {ErrorCategory::Platform, "getcontext failed"};
+    }
+    data->context.uc_stack.ss_sp = static_cast<uint8*>(mapping) + page_size;
+    data->context.uc_stack.ss_size = stack_size;
+    data->context.uc_link = nullptr;
+
+    const uintptr_t address = reinterpret_cast<uintptr_t>(data);
+    makecontext(&data->context,
+                reinterpret_cast<void (*)()>(FiberEntry),
+                2,
+                static_cast<uint32>(address),
+                static_cast<uint32>(static_cast<uint64>(address) >> 32));
+
+    UniquePtr<Fiber> fiber(new Fiber());
+    fiber->m_platformData = data;
+    return rsblMove(fiber);
+}
+
+Result<UniquePtr<Fiber>> Fiber::FromCurrentThread()
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    // Nothing to convert, the context is filled in by the first switch away
+    UniquePtr<Fiber> fiber(new Fiber());
+    fiber->m_platformData = new PosixFiber();
+    fiber->m_isThread = true;
+    return rsblMove(fiber);
+}
+
+Fiber::~Fiber()
+{
+    PosixFiber* data = static_cast<PosixFiber*>(m_platformData);
+    if (data == nullptr)
+    {
+        return;
+    }
+
+    if (data->mapping != nullptr)
+    {
+        munmap(data->mapping, data->mappingSize);
+    }
+    delete data;
+}
+
+void Fiber::SwitchTo(Fiber& target)
+{
+    PosixFiber* data = static_cast<PosixFiber*>(m_platformData);
+    PosixFiber* target_data = static_cast<PosixFiber*>(target.m_platformData);
+    const int switched = swapcontext(&data->context, &target_data->context);
+    rsblAssert(switched == 0);
+}
+
+} // namespace rsbl
@@ -0,0 +1,289 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "../rsbl-file-watcher-internal.h"
+
+#include <rsbl-file.h>
+#include <rsbl-hash-map.h>
+#include <rsbl-memory-tracking.h>
+
+#if defined(__linux__)
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace rsbl::Internal
+{
+
+#if defined(__linux__)
+
+namespace
+{
+// Every directory gets its own watch, inotify doesn't do trees
+constexpr uint32 kWatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM |
+                              IN_MOVED_TO | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+// Room for a few hundred events per read
+constexpr uint64 kEventBufferSize = 64 * 1024;
+} // namespace
+
+struct FileWatchSource::State
+{
+    int inotifyFd = -1;
+    int stopFd = -1;
+    bool recursive = false;
+    String root;
+
+    // Watch descriptor to its directory, relative to the root, empty for the root itself
+    HashMap<int32, String> directories{GetTaggedAllocator(MemoryTag::Platform)};
+
+    alignas(inotify_event) char events[kEventBufferSize];
+
+    // Watches relativeDir, and with recursive its subdirectories. reportFiles is for directories
+    // that appeared after the watch started: files written into them before their watch was in
+    // place have no events of their own, so they're reported as added from the listing.
+    void AddDirectory(StringView relativeDir,
+                      bool reportFiles,
+                      FunctionRef<void(RawFileEvent, StringView)> sink)
+    {
+        String path(root.View(), GetTaggedAllocator(MemoryTag::Platform));
+        if (!relativeDir.IsEmpty())
+        {
+            path.Append('/');
+            path.Append(relativeDir);
+        }
+
+        const int wd = ::inotify_add_watch(inotifyFd, path.CStr(), kWatchMask);
+        if (wd < 0)
+        {
+            // Gone already, or out of watches (fs.inotify.max_user_watches)
+            return;
+        }
+        directories.InsertOrAssign(wd,
+                                   String(relativeDir, GetTaggedAllocator(MemoryTag::Platform)));
+
+        if (!recursive && !reportFiles)
+        {
+            return;
+        }
+
+        Result<UniquePtr<DirectoryIterator>> dir = DirectoryIterator::Open(path.CStr());
+        if (!dir)
+        {
+            return;
+        }
+
+        String child(GetTaggedAllocator(MemoryTag::Platform));
+        DirectoryEntry entry;
+        while (dir.Value()->Next(entry))
+        {
+            child = relativeDir;
+            if (!child.IsEmpty())
+            {
+                child.Append('/');
+            }
+            child.Append(entry.name);
+
+            if (entry.isDirectory)
+            {
+                if (recursive)
+                {
+                    AddDirectory(child, reportFiles, sink);
+                }
+            }
+            else if (reportFiles)
+            {
+                sink(RawFileEvent::Added, child);
+            }
+        }
+    }
+
+    void Dispatch(const inotify_event& event, FunctionRef<void(RawFileEvent, StringView)> sink)
+    {
+        if ((event.mask & IN_Q_OVERFLOW) != 0)
+        {
+            sink(RawFileEvent::Overflow, StringView());
+            return;
+        }
+        if ((event.mask & IN_IGNORED) != 0)
+        {
+            // The directory went away, or was moved off
+            directories.Remove(event.wd);
+            return;
+        }
+
+        const String* dir = directories.Find(event.wd);
+        if (dir == nullptr || event.len == 0)
+        {
+            return;
+        }
+
+        String path(dir->View(), GetTaggedAllocator(MemoryTag::Platform));
+        if (!path.IsEmpty())
+        {
+            path.Append('/');
+        }
+        path.Append(StringView(event.name));
+
+        const bool isDirectory = (event.mask & IN_ISDIR) != 0;
+        if ((event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+        {
+            sink(RawFileEvent::Removed, path);
+        }
+        else if ((event.mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+        {
+            if (isDirectory)
+            {
+                if (recursive)
+                {
+                    AddDirectory(path, true, sink);
+                }
+            }
+            else
+            {
+                sink(RawFileEvent::Added, path);
+            }
+        }
+        else if (!isDirectory)
+        {
+            sink(RawFileEvent::Modified, path);
+        }
+    }
+};
+
+Result<UniquePtr<FileWatchSource>> FileWatchSource::Open(const char* directory, bool recursive)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    Result<FileInfo> info = GetFileInfo(directory);
+    if (!info)
+    {
+        return PendingFailure{info.Category()};
+    }
+    if (!info.Value().isDirectory)
+    {
+        return {ErrorCategory::InvalidArgument, "Path isn't a directory"};
+    }
+
+    UniquePtr<FileWatchSource> source(new FileWatchSource());
+    source->m_state = new State();
+
+    State* state = source->m_state;
+    state->inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    state->stopFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (state->inotifyFd < 0 || state->stopFd < 0)
+    {
+        return {ErrorCategory::Platform, "Failed to create inotify instance"};
+    }
+
+    state->recursive = recursive;
+    state->root = directory;
+    state->AddDirectory(StringView(), false, [](RawFileEvent, StringView) {});
+    if (state->directories.IsEmpty())
+    {
+        return {ErrorCategory::Platform, "Failed to watch directory"};
+    }
+
+    return rsblMove(source);
+}
+
+FileWatchSource::~FileWatchSource()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+    if (m_state->inotifyFd >= 0)
+    {
+        ::close(m_state->inotifyFd);
+    }
+    if (m_state->stopFd >= 0)
+    {
+        ::close(m_state->stopFd);
+    }
+    delete m_state;
+}
+
+bool FileWatchSource::Wait(uint32 timeoutMs, FunctionRef<void(RawFileEvent, StringView)> sink)
+{
+    State* state = m_state;
+
+    pollfd fds[2] = {};
+    fds[0].fd = state->stopFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = state->inotifyFd;
+    fds[1].events = POLLIN;
+
+    const int timeout = timeoutMs == kWaitForever ? -1 : static_cast<int>(timeoutMs);
+    const int ready = ::poll(fds, 2, timeout);
+    if (ready < 0)
+    {
+        return errno == EINTR;
+    }
+    if ((fds[0].revents & POLLIN) != 0)
+    {
+        return false;
+    }
+    if ((fds[1].revents & POLLIN) == 0)
+    {
+        return true;
+    }
+
+    // Drains everything queued, the fd is non-blocking
+    for (;;)
+    {
+        const ssize_t bytes = ::read(state->inotifyFd, state->events, sizeof(state->events));
+        if (bytes <= 0)
+        {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < bytes;)
+        {
+            const inotify_event& event =
+                *reinterpret_cast<const inotify_event*>(state->events + offset);
+            state->Dispatch(event, sink);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event.len);
+        }
+    }
+    return true;
+}
+
+void FileWatchSource::Stop()
+{
+    const uint64 one = 1;
+    [[maybe_unused]] const ssize_t written = ::write(m_state->stopFd, &one, sizeof(one));
+}
+
+#else
+
+// kqueue needs an open descriptor per file and FSEvents a run loop, neither is wired up yet
+struct FileWatchSource::State
+{
+};
+
+Result<UniquePtr<FileWatchSource>> FileWatchSource::Open(const char*, bool)
+{
+    return {ErrorCategory::Platform, "FileWatcher isn't supported on this platform"};
+}
+
+FileWatchSource::~FileWatchSource()
+{
+    delete m_state;
+}
+
+bool FileWatchSource::Wait(uint32, FunctionRef<void(RawFileEvent, StringView)>)
+{
+    return false;
+}
+
+void FileWatchSource::Stop()
+{
+}
+
+#endif
+
+} // namespace rsbl::Internal
@@ -0,0 +1,787 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-file.h"
+
+#include <rsbl-counters.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-profile.h>
+#include <rsbl-string.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace rsbl
+{
+
+namespace
+{
+// Biggest transfer handed to the OS in one call. Linux stops at just under 2 GB anyway; a round
+// 1 GB keeps every piece after the first aligned to whatever the first one was.
+constexpr uint64 kMaxTransfer = 1ull << 30;
+
+size_t ClampTransfer(uint64 size)
+{
+    return static_cast<size_t>(size < kMaxTransfer ? size : kMaxTransfer);
+}
+
+FileInfo ToFileInfo(const struct stat& info)
+{
+#if defined(__APPLE__)
+    const struct timespec& modified = info.st_mtimespec;
+#else
+    const struct timespec& modified = info.st_mtim;
+#endif
+    FileInfo result;
+    result.size = static_cast<uint64>(info.st_size);
+    result.modifiedTime =
+        static_cast<int64>(modified.tv_sec) * 1000000000 + static_cast<int64>(modified.tv_nsec);
+    result.isDirectory = S_ISDIR(info.st_mode);
+    return result;
+}
+
+// iovecs handed to one readv or writev, well under any IOV_MAX
+constexpr int kMaxVectors = 64;
+
+// Runs transfer (readv or writev) until every buffer is done, picking up mid-buffer after a short
+// transfer. With stop_at_zero, a transfer of nothing is the end of the file.
+template <typename View, typename Transfer>
+Result<uint64> TransferVectored(ArrayView<const View> buffers,
+                                bool stop_at_zero,
+                                Transfer&& transfer)
+{
+    uint64 total = 0;
+    uint64 index = 0;
+    // Bytes of buffers[index] already done
+    uint64 done = 0;
+    for (;;)
+    {
+        while (index < buffers.Size() && done == buffers[index].Size())
+        {
+            ++index;
+            done = 0;
+        }
+        if (index == buffers.Size())
+        {
+            return total;
+        }
+
+        iovec vectors[kMaxVectors];
+        int vector_count = 0;
+        for (uint64 i = index; i < buffers.Size() && vector_count < kMaxVectors; ++i)
+        {
+            const uint64 start = i == index ? done : 0;
+            if (buffers[i].Size() > start)
+            {
+                vectors[vector_count].iov_base =
+                    const_cast<uint8*>(buffers[i].Data() + start);
+                vectors[vector_count].iov_len = ClampTransfer(buffers[i].Size() - start);
+                ++vector_count;
+            }
+        }
+
+        const ssize_t count = transfer(vectors, vector_count);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return {ErrorCategory::Io, "Failed to transfer file data"};
+        }
+        if (count == 0 && stop_at_zero)
+        {
+            return total;
+        }
+
+        total += static_cast<uint64>(count);
+        uint64 remaining = static_cast<uint64>(count);
+        while (remaining > 0)
+        {
+            const uint64 left = buffers[index].Size() - done;
+            if (remaining < left)
+            {
+                done += remaining;
+                break;
+            }
+            remaining -= left;
+            ++index;
+            done = 0;
+        }
+    }
+}
+
+bool IsDotOrDotDot(const char* name)
+{
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+} // namespace
+
+Result<FileHandle> OpenFile(const char* path, FileOpenMode mode, FileOpenFlags open_flags)
+{
+    RSBL_PROFILE_ZONE("OpenFile");
+    int flags = 0;
+
+    // Same create and truncate behaviour as the Windows backend
+    switch (mode)
+    {
+    case FileOpenMode::Read:
+        flags = O_RDONLY;
+        break;
+    case FileOpenMode::Write:
+        flags = O_WRONLY | O_CREAT | O_TRUNC;
+        break;
+    case FileOpenMode::WriteAppend:
+        flags = O_WRONLY | O_CREAT; // Does not truncate
+        break;
+    case FileOpenMode::ReadWrite:
+        flags = O_RDWR | O_CREAT | O_TRUNC;
+        break;
+    case FileOpenMode::ReadWriteAppend:
+        flags = O_RDWR | O_CREAT; // Does not truncate
+        break;
+    }
+
+    // Don't leak the descriptor into child processes
+    flags |= O_CLOEXEC;
+
+#ifdef O_DIRECT
+    if (HasFlag(open_flags, FileOpenFlags::Unbuffered))
+    {
+        flags |= O_DIRECT;
+    }
+#endif
+
+    int fd = -1;
+    do
+    {
+        fd = ::open(path, flags, 0644);
+    } while (fd < 0 && errno == EINTR);
+
+#ifdef O_DIRECT
+    // Some file systems (tmpfs on older kernels) refuse O_DIRECT, open those cached instead
+    if (fd < 0 && errno == EINVAL && (flags & O_DIRECT) != 0)
+    {
+        do
+        {
+            fd = ::open(path, flags & ~O_DIRECT, 0644);
+        } while (fd < 0 && errno == EINTR);
+    }
+#endif
+
+    if (fd < 0)
+    {
+        if (errno == ENOENT || errno == ENOTDIR)
+        {
+            return {ErrorCategory::NotFound, "Failed to open file"};
+        }
+        return {ErrorCategory::Io, "Failed to open file"};
+    }
+
+#if defined(F_NOCACHE)
+    // macOS has no O_DIRECT, this is its equivalent
+    if (HasFlag(open_flags, FileOpenFlags::Unbuffered))
+    {
+        ::fcntl(fd, F_NOCACHE, 1);
+    }
+#endif
+
+    // Only hints, nothing to do if they're not taken
+#if defined(POSIX_FADV_SEQUENTIAL)
+    if (HasFlag(open_flags, FileOpenFlags::SequentialScan))
+    {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+    if (HasFlag(open_flags, FileOpenFlags::RandomAccess))
+    {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+    }
+#elif defined(F_RDAHEAD)
+    if (HasFlag(open_flags, FileOpenFlags::RandomAccess))
+    {
+        ::fcntl(fd, F_RDAHEAD, 0);
+    }
+#endif
+
+    return static_cast<FileHandle>(fd);
+}
+
+Result<> CloseFile(FileHandle handle)
+{
+    // No retry on EINTR, Linux has already released the descriptor by then
+    if (::close(static_cast<int>(handle)) != 0 && errno != EINTR)
+    {
+        return {ErrorCategory::Io, "Failed to close file"};
+    }
+
+    return ResultCode::Success;
+}
+
+Result<uint64> WriteFile(FileHandle handle, ByteView data)
+{
+    RSBL_PROFILE_ZONE("WriteFile");
+    const int fd = static_cast<int>(handle);
+
+    // write can stop short (signals, pipes, quotas, and Linux's 2 GB cap per call), keep going
+    // until it's all out
+    uint64 written = 0;
+    while (written < data.Size())
+    {
+        const ssize_t count =
+            ::write(fd, data.Data() + written, ClampTransfer(data.Size() - written));
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return {ErrorCategory::Io, "Failed to write to file"};
+        }
+        written += static_cast<uint64>(count);
+    }
+
+    RSBL_COUNTER_ADD("io.write_bytes", written);
+    return written;
+}
+
+Result<uint64> WriteFileGather(FileHandle handle, ArrayView<const ByteView> buffers)
+{
+    RSBL_PROFILE_ZONE("WriteFileGather");
+    const int fd = static_cast<int>(handle);
+    Result<uint64> written =
+        TransferVectored(buffers, false, [fd](const iovec* vectors, int count) {
+            return ::writev(fd, vectors, count);
+        });
+    if (written)
+    {
+        RSBL_COUNTER_ADD("io.write_bytes", written.Value());
+    }
+    return written;
+}
+
+Result<uint64> ReadFileScatter(FileHandle handle, ArrayView<const MutableByteView> buffers)
+{
+    RSBL_PROFILE_ZONE("ReadFileScatter");
+    const int fd = static_cast<int>(handle);
+    Result<uint64> read = TransferVectored(buffers, true, [fd](const iovec* vectors, int count) {
+        return ::readv(fd, vectors, count);
+    });
+    if (read)
+    {
+        RSBL_COUNTER_ADD("io.read_bytes", read.Value());
+    }
+    return read;
+}
+
+Result<uint64> ReadFile(FileHandle handle, MutableByteView buffer, uint64 offset)
+{
+    RSBL_PROFILE_ZONE("ReadFile");
+    const int fd = static_cast<int>(handle);
+
+    // Matches Windows: an offset reads from there, 0 carries on from the file position. pread
+    // doesn't move the file position, which differs from the Windows seek, but nothing relies on
+    // mixing the two. Big reads go in pieces until the buffer is full or the file ends.
+    uint64 total = 0;
+    while (total < buffer.Size())
+    {
+        uint8* destination = buffer.Data() + total;
+        const size_t size = ClampTransfer(buffer.Size() - total);
+        const ssize_t count =
+            offset != 0 ? ::pread(fd, destination, size, static_cast<off_t>(offset + total))
+                        : ::read(fd, destination, size);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return {ErrorCategory::Io, "Failed to read from file"};
+        }
+        if (count == 0)
+        {
+            break;
+        }
+        total += static_cast<uint64>(count);
+    }
+
+    RSBL_COUNTER_ADD("io.read_bytes", total);
+    return total;
+}
+
+Result<uint64> ReadFileAt(FileHandle handle, MutableByteView buffer, uint64 offset)
+{
+    RSBL_PROFILE_ZONE("ReadFileAt");
+    const int fd = static_cast<int>(handle);
+
+    // pread never touches the file position, and can come back short before the end
+    uint64 total = 0;
+    while (total < buffer.Size())
+    {
+        const ssize_t count = ::pread(fd,
+                                      buffer.Data() + total,
+                                      ClampTransfer(buffer.Size() - total),
+                                      static_cast<off_t>(offset + total));
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return {ErrorCategory::Io, "Failed to read from file"};
+        }
+        if (count == 0)
+        {
+            break;
+        }
+        total += static_cast<uint64>(count);
+    }
+
+    RSBL_COUNTER_ADD("io.read_bytes", total);
+    return total;
+}
+
+Result<uint64> WriteFileAt(FileHandle handle, ByteView data, uint64 offset)
+{
+    RSBL_PROFILE_ZONE("WriteFileAt");
+    const int fd = static_cast<int>(handle);
+
+    uint64 written = 0;
+    while (written < data.Size())
+    {
+        const ssize_t count = ::pwrite(fd,
+                                       data.Data() + written,
+                                       ClampTransfer(data.Size() - written),
+                                       static_cast<off_t>(offset + written));
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return {ErrorCategory::Io, "Failed to write to file"};
+        }
+        written += static_cast<uint64>(count);
+    }
+
+    RSBL_COUNTER_ADD("io.write_bytes", written);
+    return written;
+}
+
+Result<uint64> OpenAndReadFile(const char* path, MutableByteView buffer)
+{
+    auto openResult = rsbl::OpenFile(path, FileOpenMode::Read);
+    if (openResult.Code() != ResultCode::Success)
+    {
+        return {openResult.Category(), "Failed to open file for reading"};
+    }
+
+    FileHandle handle = openResult.Value();
+
+    // ReadFile fills as much of the buffer as the file has
+    Result<uint64> readResult = rsbl::ReadFile(handle, buffer);
+
+    // Always try to close, even if read failed
+    auto closeResult = rsbl::CloseFile(handle);
+
+    if (readResult.Code() != ResultCode::Success)
+    {
+        return readResult;
+    }
+
+    if (closeResult.Code() != ResultCode::Success)
+    {
+        return {ErrorCategory::Io, "Read succeeded but failed to close file"};
+    }
+
+    return readResult;
+}
+
+Result<uint64> GetFileSize(FileHandle handle)
+{
+    struct stat info = {};
+    if (::fstat(static_cast<int>(handle), &info) != 0)
+    {
+        return {ErrorCategory::Io, "Failed to get file size"};
+    }
+    return static_cast<uint64>(info.st_size);
+}
+
+Result<> SetFileSize(FileHandle handle, uint64 size)
+{
+    // ftruncate leaves a hole where the file grows, sparse on every file system that has them
+    int result;
+    do
+    {
+        result = ::ftruncate(static_cast<int>(handle), static_cast<off_t>(size));
+    } while (result != 0 && errno == EINTR);
+    if (result != 0)
+    {
+        return {ErrorCategory::Io, "Failed to set file size"};
+    }
+    return ResultCode::Success;
+}
+
+Result<FileInfo> GetFileInfo(const char* path)
+{
+    struct stat info = {};
+    if (::stat(path, &info) != 0)
+    {
+        if (errno == ENOENT || errno == ENOTDIR)
+        {
+            return {ErrorCategory::NotFound, "No file at path"};
+        }
+        return {ErrorCategory::Io, "Failed to get file info"};
+    }
+    return ToFileInfo(info);
+}
+
+Result<> MakeDirectory(const char* path)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    // Each parent in turn, cutting the path short at its separators
+    String prefix(path);
+    for (uint64 i = 1; i < prefix.Size(); ++i)
+    {
+        if (prefix[i] != '/')
+        {
+            continue;
+        }
+        prefix[i] = '\0';
+        const bool made = ::mkdir(prefix.CStr(), 0755) == 0 || errno == EEXIST;
+        prefix[i] = '/';
+        if (!made)
+        {
+            return {ErrorCategory::Io, "Failed to create directory"};
+        }
+    }
+    if (::mkdir(path, 0755) != 0 && errno != EEXIST)
+    {
+        return {ErrorCategory::Io, "Failed to create directory"};
+    }
+
+    struct stat info = {};
+    if (::stat(path, &info) != 0 || !S_ISDIR(info.st_mode))
+    {
+        return {ErrorCategory::Io, "Path exists and isn't a directory"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> RenameFile(const char* old_path, const char* new_path)
+{
+    if (::rename(old_path, new_path) != 0)
+    {
+        if (errno == ENOENT)
+        {
+            return {ErrorCategory::NotFound, "No file at path"};
+        }
+        return {ErrorCategory::Io, "Failed to rename file"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> RemoveFile(const char* path)
+{
+    if (::unlink(path) != 0)
+    {
+        if (errno == ENOENT)
+        {
+            return {ErrorCategory::NotFound, "No file at path"};
+        }
+        return {ErrorCategory::Io, "Failed to remove file"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> DropFileCache(const char* path)
+{
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        if (errno == ENOENT)
+        {
+            return {ErrorCategory::NotFound, "No file at path"};
+        }
+        return {ErrorCategory::Io, "Failed to open file"};
+    }
+
+    // Dirty pages aren't dropped, write them back first
+    ::fdatasync(fd);
+    const int advised = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+    if (advised != 0)
+    {
+        return {ErrorCategory::Io, "Failed to drop file from the cache"};
+    }
+    return ResultCode::Success;
+}
+
+struct DirectoryIterator::State
+{
+#if defined(__linux__)
+    // getdents64 fills this with records laid out like LinuxDirent64, each 8 byte aligned
+    static constexpr uint32 kBufferSize = 32 * 1024;
+
+    struct LinuxDirent64
+    {
+        uint64 inode;
+        int64 offset;
+        uint16 recordLength;
+        uint8 type;
+        char name[1];
+    };
+
+    int fd = -1;
+    alignas(8) uint8 buffer[kBufferSize];
+    uint32 position = 0;
+    uint32 filled = 0;
+#else
+    // readdir reads in batches too, and reuses its one entry
+    DIR* dir = nullptr;
+#endif
+
+    const char* current = nullptr;
+
+    int DirectoryFd() const
+    {
+#if defined(__linux__)
+        return fd;
+#else
+        return ::dirfd(dir);
+#endif
+    }
+};
+
+Result<UniquePtr<DirectoryIterator>> DirectoryIterator::Open(const char* path)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    int fd = -1;
+    do
+    {
+        fd = ::open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+
+    if (fd < 0)
+    {
+        if (errno == ENOENT)
+        {
+            return {ErrorCategory::NotFound, "Failed to open directory"};
+        }
+        if (errno == ENOTDIR)
+        {
+            return {ErrorCategory::InvalidArgument, "Path isn't a directory"};
+        }
+        return {ErrorCategory::Io, "Failed to open directory"};
+    }
+
+    UniquePtr<DirectoryIterator> iterator(new DirectoryIterator());
+    iterator->m_state = new State();
+#if defined(__linux__)
+    iterator->m_state->fd = fd;
+#else
+    // Takes over the descriptor
+    iterator->m_state->dir = ::fdopendir(fd);
+    if (iterator->m_state->dir == nullptr)
+    {
+        ::close(fd);
+        return {ErrorCategory::Io, "Failed to open directory"};
+    }
+#endif
+    return rsblMove(iterator);
+}
+
+DirectoryIterator::~DirectoryIterator()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+#if defined(__linux__)
+    ::close(m_state->fd);
+#else
+    if (m_state->dir != nullptr)
+    {
+        ::closedir(m_state->dir);
+    }
+#endif
+    delete m_state;
+}
+
+bool DirectoryIterator::Next(DirectoryEntry& entry)
+{
+    State* state = m_state;
+    for (;;)
+    {
+        const char* name = nullptr;
+        uint8 type = DT_UNKNOWN;
+
+#if defined(__linux__)
+        if (state->position >= state->filled)
+        {
+            long count = 0;
+            do
+            {
+                count = ::syscall(SYS_getdents64, state->fd, state->buffer, State::kBufferSize);
+            } while (count < 0 && errno == EINTR);
+            if (count <= 0)
+            {
+                state->current = nullptr;
+                return false;
+            }
+            state->position = 0;
+            state->filled = static_cast<uint32>(count);
+        }
+        const auto* record =
+            reinterpret_cast<const State::LinuxDirent64*>(state->buffer + state->position);
+        state->position += record->recordLength;
+        name = record->name;
+        type = record->type;
+#else
+        const struct dirent* record = ::readdir(state->dir);
+        if (record == nullptr)
+        {
+            state->current = nullptr;
+            return false;
+        }
+        name = record->d_name;
+        type = record->d_type;
+#endif
+
+        if (IsDotOrDotDot(name))
+        {
+            continue;
+        }
+
+        state->current = name;
+        entry.name = name;
+        entry.isDirectory = type == DT_DIR;
+
+        // Some file systems don't fill in the type, and links are whatever they point at
+        if (type == DT_UNKNOWN || type == DT_LNK)
+        {
+            struct stat info = {};
+            entry.isDirectory =
+                ::fstatat(state->DirectoryFd(), name, &info, 0) == 0 && S_ISDIR(info.st_mode);
+        }
+        return true;
+    }
+}
+
+Result<FileInfo> DirectoryIterator::CurrentInfo() const
+{
+    if (m_state->current == nullptr)
+    {
+        return {ErrorCategory::InvalidArgument, "No current directory entry"};
+    }
+
+    struct stat info = {};
+    if (::fstatat(m_state->DirectoryFd(), m_state->current, &info, 0) != 0)
+    {
+        if (errno == ENOENT)
+        {
+            return {ErrorCategory::NotFound, "Directory entry no longer exists"};
+        }
+        return {ErrorCategory::Io, "Failed to get directory entry info"};
+    }
+    return ToFileInfo(info);
+}
+
+Result<MappedFile> MapFile(const char* path, FileMapAccess access)
+{
+    RSBL_PROFILE_ZONE("MapFile");
+    const bool writable = access == FileMapAccess::ReadWrite;
+    int fd = -1;
+    do
+    {
+        fd = ::open(path, (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+
+    if (fd < 0)
+    {
+        if (errno == ENOENT || errno == ENOTDIR)
+        {
+            return {ErrorCategory::NotFound, "Failed to open file for mapping"};
+        }
+        return {ErrorCategory::Io, "Failed to open file for mapping"};
+    }
+
+    struct stat info = {};
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return {ErrorCategory::Io, "Failed to get the size of the file to map"};
+    }
+
+    MappedFile mapped;
+    mapped.m_writable = writable;
+
+    // mmap refuses empty files, they get an empty view instead
+    if (info.st_size > 0)
+    {
+        const int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void* data = ::mmap(
+            nullptr, static_cast<size_t>(info.st_size), protection, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            return {ErrorCategory::Io, "Failed to map file"};
+        }
+        mapped.m_data = static_cast<uint8*>(data);
+        mapped.m_size = static_cast<uint64>(info.st_size);
+    }
+
+    // The mapping holds its own reference to the file
+    ::close(fd);
+    return mapped;
+}
+
+void MappedFile::Prefetch(uint64 offset, uint64 size) const
+{
+    if (offset >= m_size)
+    {
+        return;
+    }
+    if (size > m_size - offset)
+    {
+        size = m_size - offset;
+    }
+
+    // madvise wants a page aligned start, the mapping itself is
+    const uint64 page_size = static_cast<uint64>(::sysconf(_SC_PAGESIZE));
+    const uint64 start = offset & ~(page_size - 1);
+    ::madvise(m_data + start, static_cast<size_t>(offset + size - start), MADV_WILLNEED);
+}
+
+Result<> MappedFile::Flush()
+{
+    if (m_data != nullptr && m_writable && ::msync(m_data, m_size, MS_SYNC) != 0)
+    {
+        return {ErrorCategory::Io, "Failed to flush mapped file"};
+    }
+    return ResultCode::Success;
+}
+
+void MappedFile::Unmap()
+{
+    if (m_data != nullptr)
+    {
+        ::munmap(m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+} // namespace rsbl
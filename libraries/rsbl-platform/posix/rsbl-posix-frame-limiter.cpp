@@ -0,0 +1,41 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-frame-limiter.h"
+
+#include <errno.h>
+#include <time.h>
+
+namespace rsbl
+{
+
+namespace
+{
+// Linux's high resolution timers wake within tens of microseconds, on top of the timer slack
+// (50us by default) that a normal thread's sleeps are given
+constexpr uint64 kMinSpinNs = 100'000;
+} // namespace
+
+// clock_nanosleep needs no timer of its own
+Result<> FrameLimiter::CreatePlatformTimer()
+{
+    m_minSpinNs = kMinSpinNs;
+    return ResultCode::Success;
+}
+
+void FrameLimiter::DestroyPlatformTimer()
+{
+}
+
+void FrameLimiter::SleepFor(uint64 ns)
+{
+    timespec duration;
+    duration.tv_sec = static_cast<time_t>(ns / 1'000'000'000ull);
+    duration.tv_nsec = static_cast<long>(ns % 1'000'000'000ull);
+    // Relative, and returns what's left when a signal interrupts it
+    while (clock_nanosleep(CLOCK_MONOTONIC, 0, &duration, &duration) == EINTR)
+    {
+    }
+}
+
+} // namespace rsbl
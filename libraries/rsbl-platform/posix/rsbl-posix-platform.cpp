@@ -0,0 +1,15 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-platform.h"
+
+namespace rsbl
+{
+
+void* GetApplicationHandle()
+{
+    // Nothing like an HINSTANCE outside Windows
+    return nullptr;
+}
+
+} // namespace rsbl
@@ -0,0 +1,223 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "../rsbl-power-internal.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <dirent.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace rsbl::Internal
+{
+
+#if defined(__linux__)
+
+namespace
+{
+// Sysfs files are tiny, one read gets all of it. The trailing newline is cut off.
+bool ReadSysFile(const char* path, char* buffer, uint32 bufferSize)
+{
+    const int file = open(path, O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        return false;
+    }
+    ssize_t length = read(file, buffer, bufferSize - 1);
+    close(file);
+    if (length <= 0)
+    {
+        return false;
+    }
+    while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == ' '))
+    {
+        --length;
+    }
+    buffer[length] = '\0';
+    return true;
+}
+
+bool ReadSysNumber(const char* path, uint64& value)
+{
+    char text[32];
+    if (!ReadSysFile(path, text, sizeof(text)) || text[0] < '0' || text[0] > '9')
+    {
+        return false;
+    }
+    value = strtoull(text, nullptr, 10);
+    return true;
+}
+
+// Mains supplies say whether they're online, batteries how full they are. A machine with a
+// battery and no online supply is running on it.
+void ReadPowerSupplies(PowerState& state)
+{
+    DIR* supplies = opendir("/sys/class/power_supply");
+    if (supplies == nullptr)
+    {
+        return;
+    }
+
+    bool any_supply = false;
+    bool mains_online = false;
+    bool battery = false;
+    uint64 capacity_sum = 0;
+    uint32 capacity_count = 0;
+    while (const dirent* entry = readdir(supplies))
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+        char path[512];
+        char type[32];
+        snprintf(path, sizeof(path), "/sys/class/power_supply/%s/type", entry->d_name);
+        if (!ReadSysFile(path, type, sizeof(type)))
+        {
+            continue;
+        }
+
+        if (strcmp(type, "Mains") == 0 || strcmp(type, "USB") == 0)
+        {
+            any_supply = true;
+            uint64 online = 0;
+            snprintf(path, sizeof(path), "/sys/class/power_supply/%s/online", entry->d_name);
+            mains_online = mains_online || (ReadSysNumber(path, online) && online != 0);
+        }
+        else if (strcmp(type, "Battery") == 0)
+        {
+            // Peripherals' batteries (mice, headsets) say they're not the system's
+            char scope[32];
+            snprintf(path, sizeof(path), "/sys/class/power_supply/%s/scope", entry->d_name);
+            if (ReadSysFile(path, scope, sizeof(scope)) && strcmp(scope, "Device") == 0)
+            {
+                continue;
+            }
+            battery = true;
+            uint64 capacity = 0;
+            snprintf(path, sizeof(path), "/sys/class/power_supply/%s/capacity", entry->d_name);
+            if (ReadSysNumber(path, capacity))
+            {
+                capacity_sum += capacity;
+                ++capacity_count;
+            }
+        }
+    }
+    closedir(supplies);
+
+    if (battery)
+    {
+        state.source = mains_online ? PowerSource::Mains : PowerSource::Battery;
+        if (capacity_count > 0)
+        {
+            state.batteryPercent = static_cast<int32>(capacity_sum / capacity_count);
+        }
+    }
+    else if (any_supply)
+    {
+        state.source = PowerSource::Mains;
+    }
+}
+
+// The ACPI platform profile, which power-profiles-daemon and the desktops' power menus set
+PowerMode ReadPlatformProfile()
+{
+    char profile[64];
+    if (!ReadSysFile("/sys/firmware/acpi/platform_profile", profile, sizeof(profile)))
+    {
+        return PowerMode::Unknown;
+    }
+    if (strcmp(profile, "low-power") == 0)
+    {
+        return PowerMode::BatterySaver;
+    }
+    if (strcmp(profile, "quiet") == 0 || strcmp(profile, "cool") == 0)
+    {
+        return PowerMode::BetterBattery;
+    }
+    if (strcmp(profile, "balanced") == 0)
+    {
+        return PowerMode::Balanced;
+    }
+    if (strcmp(profile, "balanced-performance") == 0)
+    {
+        return PowerMode::HighPerformance;
+    }
+    if (strcmp(profile, "performance") == 0)
+    {
+        return PowerMode::MaxPerformance;
+    }
+    return PowerMode::Unknown;
+}
+
+// The slowest cpufreq policy's ceiling against its hardware maximum. Thermal and power limits
+// lower scaling_max_freq; the governor's current frequency says nothing about them.
+uint32 ReadCpuSpeedPercent()
+{
+    uint32 slowest = 0;
+    for (uint32 policy = 0; policy < 1024; ++policy)
+    {
+        char path[128];
+        uint64 hardware_max = 0;
+        snprintf(path,
+                 sizeof(path),
+                 "/sys/devices/system/cpu/cpufreq/policy%u/cpuinfo_max_freq",
+                 policy);
+        if (!ReadSysNumber(path, hardware_max))
+        {
+            // Policies are numbered by their first CPU, so there are gaps
+            continue;
+        }
+        uint64 limit = 0;
+        snprintf(path,
+                 sizeof(path),
+                 "/sys/devices/system/cpu/cpufreq/policy%u/scaling_max_freq",
+                 policy);
+        if (hardware_max == 0 || !ReadSysNumber(path, limit))
+        {
+            continue;
+        }
+        uint32 percent = static_cast<uint32>(limit * 100 / hardware_max);
+        percent = percent > 100 ? 100 : percent;
+        slowest = slowest == 0 || percent < slowest ? percent : slowest;
+    }
+    return slowest;
+}
+} // namespace
+
+PowerState ReadPowerState()
+{
+    PowerState state;
+    ReadPowerSupplies(state);
+    state.mode = ReadPlatformProfile();
+    state.cpuSpeedPercent = ReadCpuSpeedPercent();
+    return state;
+}
+
+#else
+
+// Nothing read yet on the other POSIX systems
+PowerState ReadPowerState()
+{
+    return {};
+}
+
+#endif
+
+// Every mode Linux has is read with the rest
+void* StartPowerModeNotifications(PowerModeSink&)
+{
+    return nullptr;
+}
+
+void StopPowerModeNotifications(void*)
+{
+}
+
+} // namespace rsbl::Internal
@@ -0,0 +1,255 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-socket.h"
+
+#include <rsbl-counters.h>
+#include <rsbl-profile.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+namespace rsbl
+{
+
+namespace
+{
+// Sending to a connection the other end closed raises SIGPIPE, which ends the process. Linux
+// turns it off per send, macOS per socket.
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+int ToFd(SocketHandle socket)
+{
+    return static_cast<int>(socket);
+}
+
+void SetTimeouts(int fd, uint32 timeout_ms)
+{
+    timeval timeout = {};
+    timeout.tv_sec = static_cast<time_t>(timeout_ms / 1000);
+    timeout.tv_usec = static_cast<suseconds_t>((timeout_ms % 1000) * 1000);
+    (void)setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    (void)setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+// Not inherited by processes started from here (like files), no Nagle, and no SIGPIPE
+void SetOptions(int fd)
+{
+    (void)fcntl(fd, F_SETFD, FD_CLOEXEC);
+    const int on = 1;
+    (void)setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+#if defined(SO_NOSIGPIPE)
+    (void)setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+}
+
+// Connects without blocking so the wait can time out, then puts the socket back to blocking
+bool ConnectWithTimeout(int fd, const sockaddr* address, socklen_t size, uint32 timeout_ms)
+{
+    const int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0)
+    {
+        return false;
+    }
+
+    if (::connect(fd, address, size) != 0)
+    {
+        if (errno != EINPROGRESS)
+        {
+            return false;
+        }
+        pollfd poll_fd = {fd, POLLOUT, 0};
+        int ready;
+        do
+        {
+            ready = ::poll(&poll_fd, 1, static_cast<int>(timeout_ms));
+        } while (ready < 0 && errno == EINTR);
+        if (ready <= 0)
+        {
+            return false;
+        }
+        int error = 0;
+        socklen_t error_size = sizeof(error);
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_size) != 0 || error != 0)
+        {
+            return false;
+        }
+    }
+
+    return fcntl(fd, F_SETFL, flags) == 0;
+}
+} // namespace
+
+Result<SocketHandle> ConnectSocket(const char* host, uint16 port, uint32 timeout_ms)
+{
+    RSBL_PROFILE_ZONE("ConnectSocket");
+
+    char service[8];
+    std::snprintf(service, sizeof(service), "%u", static_cast<unsigned>(port));
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host, service, &hints, &addresses) != 0)
+    {
+        return {ErrorCategory::NotFound, "Failed to resolve host"};
+    }
+
+    int fd = -1;
+    for (addrinfo* address = addresses; address != nullptr; address = address->ai_next)
+    {
+        fd = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0)
+        {
+            continue;
+        }
+        if (ConnectWithTimeout(fd, address->ai_addr, address->ai_addrlen, timeout_ms))
+        {
+            break;
+        }
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (fd < 0)
+    {
+        return {ErrorCategory::Io, "Failed to connect"};
+    }
+    SetOptions(fd);
+    SetTimeouts(fd, timeout_ms);
+    return static_cast<SocketHandle>(fd);
+}
+
+Result<SocketHandle> ListenSocket(uint16 port, bool all_interfaces)
+{
+    const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd < 0)
+    {
+        return {ErrorCategory::Io, "Failed to create socket"};
+    }
+    (void)fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    // A server restarted on the same port doesn't have to wait out the old connections
+    const int on = 1;
+    (void)setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(all_interfaces ? INADDR_ANY : INADDR_LOOPBACK);
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0)
+    {
+        ::close(fd);
+        return {ErrorCategory::Io, "Failed to listen on port"};
+    }
+    return static_cast<SocketHandle>(fd);
+}
+
+Result<SocketHandle> AcceptSocket(SocketHandle listener)
+{
+    int fd;
+    do
+    {
+        fd = ::accept(ToFd(listener), nullptr, nullptr);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0)
+    {
+        return {ErrorCategory::Io, "Failed to accept connection"};
+    }
+    SetOptions(fd);
+    return static_cast<SocketHandle>(fd);
+}
+
+Result<uint16> GetSocketPort(SocketHandle socket)
+{
+    sockaddr_storage address = {};
+    socklen_t size = sizeof(address);
+    if (getsockname(ToFd(socket), reinterpret_cast<sockaddr*>(&address), &size) != 0)
+    {
+        return {ErrorCategory::Io, "Failed to get socket address"};
+    }
+    if (address.ss_family == AF_INET6)
+    {
+        return ntohs(reinterpret_cast<const sockaddr_in6*>(&address)->sin6_port);
+    }
+    return ntohs(reinterpret_cast<const sockaddr_in*>(&address)->sin_port);
+}
+
+Result<> SendSocket(SocketHandle socket, ByteView data)
+{
+    RSBL_PROFILE_ZONE("SendSocket");
+    uint64 sent = 0;
+    while (sent < data.Size())
+    {
+        const ssize_t count =
+            ::send(ToFd(socket), data.Data() + sent, data.Size() - sent, kSendFlags);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return {ErrorCategory::Timeout, "Timed out sending"};
+            }
+            return {ErrorCategory::Io, "Failed to send"};
+        }
+        sent += static_cast<uint64>(count);
+    }
+
+    RSBL_COUNTER_ADD("net.sent_bytes", sent);
+    return ResultCode::Success;
+}
+
+Result<uint64> ReceiveSocket(SocketHandle socket, MutableByteView buffer)
+{
+    ssize_t count;
+    do
+    {
+        count = ::recv(ToFd(socket), buffer.Data(), buffer.Size(), 0);
+    } while (count < 0 && errno == EINTR);
+    if (count < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return {ErrorCategory::Timeout, "Timed out receiving"};
+        }
+        return {ErrorCategory::Io, "Failed to receive"};
+    }
+
+    RSBL_COUNTER_ADD("net.received_bytes", static_cast<uint64>(count));
+    return static_cast<uint64>(count);
+}
+
+void ShutdownSocket(SocketHandle socket)
+{
+    (void)::shutdown(ToFd(socket), SHUT_RDWR);
+}
+
+Result<> CloseSocket(SocketHandle socket)
+{
+    if (::close(ToFd(socket)) != 0 && errno != EINTR)
+    {
+        return {ErrorCategory::Io, "Failed to close socket"};
+    }
+    return ResultCode::Success;
+}
+
+} // namespace rsbl
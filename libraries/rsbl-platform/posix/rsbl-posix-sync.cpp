@@ -0,0 +1,150 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-sync.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-clock.h>
+
+#include <errno.h>
+#include <time.h>
+
+#if defined(__linux__)
+    #include <linux/futex.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace rsbl
+{
+
+static_assert(sizeof(std::atomic<uint32>) == sizeof(uint32),
+              "The futex word is the atomic's storage");
+
+#if defined(__linux__)
+
+bool AddressWait(const std::atomic<uint32>& value, uint32 expected, uint32 timeout_ms)
+{
+    // FUTEX_WAIT takes a relative timeout, on CLOCK_MONOTONIC
+    timespec timeout;
+    timespec* timeout_ptr = nullptr;
+    if (timeout_ms != kWaitInfinite)
+    {
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1'000'000;
+        timeout_ptr = &timeout;
+    }
+
+    const long result = syscall(SYS_futex,
+                                reinterpret_cast<const uint32*>(&value),
+                                FUTEX_WAIT_PRIVATE,
+                                expected,
+                                timeout_ptr,
+                                nullptr,
+                                0);
+    return result == 0 || errno != ETIMEDOUT;
+}
+
+void AddressWakeOne(std::atomic<uint32>& value)
+{
+    syscall(SYS_futex,
+            reinterpret_cast<uint32*>(&value),
+            FUTEX_WAKE_PRIVATE,
+            1,
+            nullptr,
+            nullptr,
+            0);
+}
+
+void AddressWakeAll(std::atomic<uint32>& value)
+{
+    syscall(SYS_futex,
+            reinterpret_cast<uint32*>(&value),
+            FUTEX_WAKE_PRIVATE,
+            INT32_MAX,
+            nullptr,
+            nullptr,
+            0);
+}
+
+#else
+
+// No futex, the standard library's atomic wait is the closest thing. It has no timeout, so timed
+// waits poll instead.
+bool AddressWait(const std::atomic<uint32>& value, uint32 expected, uint32 timeout_ms)
+{
+    if (timeout_ms == kWaitInfinite)
+    {
+        value.wait(expected, std::memory_order_seq_cst);
+        return true;
+    }
+
+    const uint64 deadline = Clock::NowTicks() + timeout_ms * Clock::TicksPerSecond() / 1000;
+    while (value.load(std::memory_order_seq_cst) == expected)
+    {
+        if (Clock::NowTicks() >= deadline)
+        {
+            return false;
+        }
+        Thread::ThreadSleep(1);
+    }
+    return true;
+}
+
+void AddressWakeOne(std::atomic<uint32>& value)
+{
+    value.notify_one();
+}
+
+void AddressWakeAll(std::atomic<uint32>& value)
+{
+    value.notify_all();
+}
+
+#endif
+
+// Drepper's "Futexes Are Tricky" mutex. Unlock only makes the wake syscall when the state says a
+// thread may be sleeping.
+
+Mutex::~Mutex()
+{
+    rsblAssertMsg(m_state.load(std::memory_order_relaxed) == 0, "Destroying a locked Mutex");
+}
+
+void Mutex::Lock()
+{
+    uint32 state = 0;
+    if (m_state.compare_exchange_strong(
+            state, 1, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // Contended, mark it so the owner knows to wake someone, then sleep until it's free
+    if (state != 2)
+    {
+        state = m_state.exchange(2, std::memory_order_acquire);
+    }
+    while (state != 0)
+    {
+        AddressWait(m_state, 2);
+        state = m_state.exchange(2, std::memory_order_acquire);
+    }
+}
+
+bool Mutex::TryLock()
+{
+    uint32 state = 0;
+    return m_state.compare_exchange_strong(
+        state, 1, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+void Mutex::Unlock()
+{
+    if (m_state.exchange(0, std::memory_order_release) == 2)
+    {
+        AddressWakeOne(m_state);
+    }
+}
+
+} // namespace rsbl
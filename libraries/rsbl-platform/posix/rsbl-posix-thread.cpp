@@ -0,0 +1,418 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-thread.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-profile.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+    #include <sys/syscall.h>
+#endif
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+// Linux thread names are 15 characters and a terminator
+constexpr uint32 kPlatformNameLength = 16;
+
+// Threads share one scheduling class outside real time, so priorities are per-thread nice values
+int ToNice(ThreadPriority priority)
+{
+    switch (priority)
+    {
+    case ThreadPriority::Lowest:
+        return 10;
+    case ThreadPriority::BelowNormal:
+        return 5;
+    case ThreadPriority::Normal:
+        return 0;
+    case ThreadPriority::AboveNormal:
+        return -5;
+    case ThreadPriority::Highest:
+        return -10;
+    }
+    return 0;
+}
+
+bool AffinityIsUsable(uint64 affinityMask)
+{
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    {
+        return true;
+    }
+    for (uint32 cpu = 0; cpu < 64; ++cpu)
+    {
+        if ((affinityMask & (1ull << cpu)) != 0 && CPU_ISSET(cpu, &allowed))
+        {
+            return true;
+        }
+    }
+    return false;
+#else
+    rsblUnused(affinityMask);
+    return true;
+#endif
+}
+} // namespace
+
+Thread::Thread()
+    : m_name{0}
+    , m_threadFunc()
+    , m_result(ResultCode::Success)
+    , m_failureText{0}
+    , m_isActive(false)
+    , m_joined(false)
+    , m_platformData{nullptr}
+{
+}
+
+Result<UniquePtr<Thread>> Thread::Create(Function<Result<>()>&& thread_func)
+{
+    return Create(ThreadCreateInfo{}, rsblMove(thread_func));
+}
+
+Result<UniquePtr<Thread>> Thread::Create(const ThreadCreateInfo& info,
+                                         Function<Result<>()>&& thread_func)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    if (info.affinityMask != 0 && !AffinityIsUsable(info.affinityMask))
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "Affinity mask 0x%llx has none of the process's processors",
+                             static_cast<unsigned long long>(info.affinityMask));
+    }
+
+    // Allocate thread object on the heap so it stays at a fixed memory location
+    auto thread = UniquePtr<Thread>(new Thread);
+    if (info.name != nullptr)
+    {
+        std::strncpy(thread->m_name, info.name, kMaxNameLength - 1);
+        thread->m_name[kMaxNameLength - 1] = '\0';
+    }
+    thread->m_affinityMask = info.affinityMask;
+    thread->m_priority = info.priority;
+    thread->m_stackSize = info.stackSize;
+    thread->m_threadFunc = rsblMove(thread_func);
+    thread->m_isActive.store(true, std::memory_order_release);
+
+    auto platform_result = CreatePlatformThread(thread.Get());
+    if (!platform_result)
+    {
+        thread->m_isActive.store(false, std::memory_order_release);
+        return platform_result.FailureText();
+    }
+
+    thread->m_platformData = platform_result.Value();
+    return rsblMove(thread);
+}
+
+Thread::~Thread()
+{
+    // Join if not already joined to ensure thread completes
+    if (!m_joined && m_platformData.platform_handle != nullptr)
+    {
+        auto join_result = Join();
+        rsblUnused(join_result);
+    }
+
+    delete static_cast<pthread_t*>(m_platformData.platform_handle);
+}
+
+bool Thread::IsActive() const
+{
+    return m_isActive.load(std::memory_order_acquire);
+}
+
+Result<> Thread::Join()
+{
+    if (m_joined)
+    {
+        return "Thread already joined";
+    }
+
+    if (m_platformData.platform_handle == nullptr)
+    {
+        return "Invalid thread handle";
+    }
+
+    if (pthread_join(*static_cast<pthread_t*>(m_platformData.platform_handle), nullptr) != 0)
+    {
+        return "Failed to join thread";
+    }
+
+    m_joined = true;
+    return ResultCode::Success;
+}
+
+Result<> Thread::JoinTimeout(uint32 timeout_ms)
+{
+    if (m_joined)
+    {
+        return "Thread already joined";
+    }
+
+    if (m_platformData.platform_handle == nullptr)
+    {
+        return "Invalid thread handle";
+    }
+
+    pthread_t handle = *static_cast<pthread_t*>(m_platformData.platform_handle);
+#if defined(__linux__)
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += static_cast<long>(timeout_ms % 1000) * 1'000'000;
+    if (deadline.tv_nsec >= 1'000'000'000)
+    {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1'000'000'000;
+    }
+
+    const int joined = pthread_timedjoin_np(handle, nullptr, &deadline);
+    if (joined == ETIMEDOUT)
+    {
+        return "Thread join timeout";
+    }
+    if (joined != 0)
+    {
+        return "Failed to join thread";
+    }
+#else
+    // No timed join, so poll the active flag, then join for real
+    for (uint32 waited = 0; IsActive(); ++waited)
+    {
+        if (waited >= timeout_ms)
+        {
+            return "Thread join timeout";
+        }
+        ThreadSleep(1);
+    }
+    if (pthread_join(handle, nullptr) != 0)
+    {
+        return "Failed to join thread";
+    }
+#endif
+
+    m_joined = true;
+    return ResultCode::Success;
+}
+
+const Result<>& Thread::GetFunctionResult() const
+{
+    return m_result;
+}
+
+const char* Thread::GetResultText() const
+{
+    return m_failureText;
+}
+
+void Thread::ThreadSleep(uint32 milliseconds)
+{
+    timespec duration;
+    duration.tv_sec = milliseconds / 1000;
+    duration.tv_nsec = static_cast<long>(milliseconds % 1000) * 1'000'000;
+    while (nanosleep(&duration, &duration) != 0 && errno == EINTR)
+    {
+    }
+}
+
+void Thread::ThreadYield()
+{
+    sched_yield();
+}
+
+uint64 Thread::GetCurrentThreadId()
+{
+#if defined(__linux__)
+    return static_cast<uint64>(syscall(SYS_gettid));
+#else
+    uint64 id = 0;
+    pthread_threadid_np(nullptr, &id);
+    return id;
+#endif
+}
+
+uint32 Thread::GetHardwareThreadCount()
+{
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<uint32>(count) : 1;
+}
+
+Result<> Thread::SetCurrentThreadName(const char* name)
+{
+    char truncated[kPlatformNameLength];
+    std::strncpy(truncated, name, kPlatformNameLength - 1);
+    truncated[kPlatformNameLength - 1] = '\0';
+
+#if defined(__APPLE__)
+    const int named = pthread_setname_np(truncated);
+#else
+    const int named = pthread_setname_np(pthread_self(), truncated);
+#endif
+    if (named != 0)
+    {
+        return {ErrorCategory::Platform, "pthread_setname_np failed"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> Thread::SetCurrentThreadAffinity(uint64 affinityMask)
+{
+#if defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (uint32 cpu = 0; cpu < 64; ++cpu)
+    {
+        if ((affinityMask & (1ull << cpu)) != 0)
+        {
+            CPU_SET(cpu, &cpus);
+        }
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+    {
+        return {ErrorCategory::InvalidArgument, "pthread_setaffinity_np failed"};
+    }
+    return ResultCode::Success;
+#else
+    // macOS only takes affinity hints between threads, not processors
+    rsblUnused(affinityMask);
+    return {ErrorCategory::Platform, "Thread affinity isn't supported on this platform"};
+#endif
+}
+
+Result<> Thread::SetCurrentThreadPriority(ThreadPriority priority)
+{
+#if defined(__linux__)
+    // On Linux, PRIO_PROCESS with a thread id sets just that thread's nice value
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), ToNice(priority)) != 0)
+    {
+        return FailureFormat(ErrorCategory::Platform, "setpriority failed: errno %d", errno);
+    }
+    return ResultCode::Success;
+#else
+    rsblUnused(priority);
+    return {ErrorCategory::Platform, "Thread priority isn't supported on this platform"};
+#endif
+}
+
+Result<> Thread::GetCurrentThreadName(char* buffer, uint32 bufferSize)
+{
+    rsblAssert(buffer != nullptr && bufferSize > 0);
+
+    if (pthread_getname_np(pthread_self(), buffer, bufferSize) != 0)
+    {
+        buffer[0] = '\0';
+        return {ErrorCategory::InvalidArgument, "Thread name doesn't fit the buffer"};
+    }
+    return ResultCode::Success;
+}
+
+void Thread::ThreadEntry()
+{
+    // Some platforms only let a thread name itself, so everything is set from in here, before
+    // the function runs. None of it stops the thread, and it's only logged once logging is up.
+    if (m_name[0] != '\0')
+    {
+        const Result<> named = SetCurrentThreadName(m_name);
+        if (!named && g_logger != nullptr)
+        {
+            RSBL_LOG_WARNING("rsbl::Thread couldn't be named: {}", named.FailureText());
+        }
+        RSBL_PROFILE_THREAD(m_name);
+    }
+    if (m_affinityMask != 0)
+    {
+        const Result<> pinned = SetCurrentThreadAffinity(m_affinityMask);
+        if (!pinned && g_logger != nullptr)
+        {
+            RSBL_LOG_WARNING("rsbl::Thread affinity not set: {}", pinned.FailureText());
+        }
+    }
+    if (m_priority != ThreadPriority::Normal)
+    {
+        const Result<> prioritized = SetCurrentThreadPriority(m_priority);
+        if (!prioritized && g_logger != nullptr)
+        {
+            RSBL_LOG_WARNING("rsbl::Thread priority not set: {}", prioritized.FailureText());
+        }
+    }
+
+    // Execute the user's function and store the result
+    {
+        RSBL_PROFILE_ZONE("Thread");
+        m_result = m_threadFunc();
+    }
+
+    // Capture failure text if the result failed
+    // We need to copy it because it's stored in thread-local storage
+    if (!m_result)
+    {
+        const char* failure_text = m_result.FailureText();
+        if (failure_text != nullptr)
+        {
+            std::strncpy(m_failureText, failure_text, kMaxFailureTextLength - 1);
+            m_failureText[kMaxFailureTextLength - 1] = '\0';
+        }
+    }
+
+    // Mark thread as no longer active
+    m_isActive.store(false, std::memory_order_release);
+}
+
+Result<ThreadNativeData> Thread::CreatePlatformThread(Thread* thread_obj)
+{
+    auto PlatformThreadFunction = [](void* parameter) -> void* {
+        Thread* thread_obj = static_cast<Thread*>(parameter);
+        thread_obj->ThreadEntry();
+        return nullptr;
+    };
+
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    if (thread_obj->m_stackSize != 0)
+    {
+        const uint64 minimum = static_cast<uint64>(PTHREAD_STACK_MIN);
+        const uint64 stack_size =
+            thread_obj->m_stackSize > minimum ? thread_obj->m_stackSize : minimum;
+        pthread_attr_setstacksize(&attributes, static_cast<size_t>(stack_size));
+    }
+
+    pthread_t* handle = new pthread_t();
+    const int created = pthread_create(handle, &attributes, PlatformThreadFunction, thread_obj);
+    pthread_attr_destroy(&attributes);
+    if (created != 0)
+    {
+        delete handle;
+        return "Failed to create thread";
+    }
+
+    if (g_logger != nullptr)
+    {
+        RSBL_LOG_DEBUG("rsbl::Thread created: '{}'", thread_obj->m_name);
+    }
+
+    ThreadNativeData data;
+    data.platform_handle = handle;
+    return data;
+}
+
+} // namespace rsbl
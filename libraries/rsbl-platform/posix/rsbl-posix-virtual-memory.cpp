@@ -0,0 +1,176 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-virtual-memory.h"
+
+#include "rsbl-cpu-topology.h"
+
+#include <rsbl-assert.h>
+
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+    #include <sys/syscall.h>
+#endif
+
+namespace rsbl
+{
+
+namespace
+{
+uint64 RoundUp(uint64 size, uint64 granularity)
+{
+    return (size + granularity - 1) / granularity * granularity;
+}
+
+// The default huge page size, from /proc/meminfo's "Hugepagesize: 2048 kB". 0 if there isn't
+// one, which doesn't mean any are set aside.
+uint64 QueryHugePageSize()
+{
+    FILE* meminfo = fopen("/proc/meminfo", "r");
+    if (meminfo == nullptr)
+    {
+        return 0;
+    }
+    uint64 size_kb = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), meminfo) != nullptr)
+    {
+        unsigned long long kb = 0;
+        if (sscanf(line, "Hugepagesize: %llu kB", &kb) == 1)
+        {
+            size_kb = kb;
+            break;
+        }
+    }
+    fclose(meminfo);
+    return size_kb * 1024;
+}
+
+PageInfo QueryPageInfo()
+{
+    PageInfo info;
+    info.pageSize = static_cast<uint64>(sysconf(_SC_PAGESIZE));
+    info.reserveGranularity = info.pageSize;
+    info.largePageSize = QueryHugePageSize();
+    return info;
+}
+
+bool IsPageAligned(const void* address, uint64 size)
+{
+    const uint64 page_size = GetPageInfo().pageSize;
+    return reinterpret_cast<uintptr_t>(address) % page_size == 0 && size % page_size == 0;
+}
+} // namespace
+
+const PageInfo& GetPageInfo()
+{
+    static const PageInfo info = QueryPageInfo();
+    return info;
+}
+
+Result<void*> ReserveVirtual(uint64 size)
+{
+    // MAP_NORESERVE keeps the reservation from counting against overcommit until it's used
+    const uint64 reserve_size = RoundUp(size, GetPageInfo().reserveGranularity);
+    void* address = mmap(nullptr,
+                         reserve_size,
+                         PROT_NONE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                         -1,
+                         0);
+    if (address == MAP_FAILED)
+    {
+        return {ErrorCategory::OutOfMemory, "Failed to reserve address space"};
+    }
+    return address;
+}
+
+void ReleaseVirtual(void* address, uint64 size)
+{
+    if (address != nullptr)
+    {
+        munmap(address, RoundUp(size, GetPageInfo().reserveGranularity));
+    }
+}
+
+Result<> CommitPages(void* address, uint64 size)
+{
+    rsblAssertMsg(IsPageAligned(address, size), "CommitPages takes whole pages");
+    // Linux hands out the memory as the pages are first touched
+    if (mprotect(address, size, PROT_READ | PROT_WRITE) != 0)
+    {
+        return {ErrorCategory::OutOfMemory, "Failed to commit pages"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> CommitPagesOnNode(void* address, uint64 size, uint32 numaNode)
+{
+#if defined(__linux__)
+    // mbind straight from the syscall, rather than linking libnuma for it. The policy is set
+    // before the pages are touched, which is when Linux places them.
+    const CpuTopology& topology = GetCpuTopology();
+    if (topology.numaNodeCount > 1 && numaNode < topology.numaNodeIds.Size())
+    {
+        rsblAssertMsg(IsPageAligned(address, size), "CommitPagesOnNode takes whole pages");
+        constexpr int kMpolPreferred = 1; // MPOL_PREFERRED, from linux/mempolicy.h
+        constexpr uint64 kBitsPerWord = sizeof(unsigned long) * 8;
+        unsigned long node_mask[16] = {};
+        const uint32 node_id = topology.numaNodeIds[numaNode];
+        if (node_id < sizeof(node_mask) * 8)
+        {
+            node_mask[node_id / kBitsPerWord] = 1ul << (node_id % kBitsPerWord);
+            // Best effort: without mbind (seccomp, old kernels) the pages go where they're
+            // touched first
+            (void)syscall(
+                SYS_mbind, address, size, kMpolPreferred, node_mask, sizeof(node_mask) * 8, 0);
+        }
+    }
+#else
+    (void)numaNode;
+#endif
+    return CommitPages(address, size);
+}
+
+void DecommitPages(void* address, uint64 size)
+{
+    rsblAssertMsg(IsPageAligned(address, size), "DecommitPages takes whole pages");
+    // MADV_DONTNEED frees the memory, and private anonymous pages read as zeroes after; the
+    // protection makes touching them before a commit fault, as on Windows
+    madvise(address, size, MADV_DONTNEED);
+    mprotect(address, size, PROT_NONE);
+}
+
+Result<void*> AllocLargePages(uint64 size)
+{
+    const uint64 large_page_size = GetPageInfo().largePageSize;
+    if (large_page_size == 0)
+    {
+        return {ErrorCategory::NotFound, "The system has no huge pages"};
+    }
+    void* address = mmap(nullptr,
+                         RoundUp(size, large_page_size),
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                         -1,
+                         0);
+    if (address == MAP_FAILED)
+    {
+        return {ErrorCategory::OutOfMemory,
+                "Failed to map huge pages, are enough set aside (vm.nr_hugepages)?"};
+    }
+    return address;
+}
+
+void FreeLargePages(void* address, uint64 size)
+{
+    if (address != nullptr)
+    {
+        munmap(address, RoundUp(size, GetPageInfo().largePageSize));
+    }
+}
+
+} // namespace rsbl
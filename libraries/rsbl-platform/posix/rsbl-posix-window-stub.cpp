@@ -0,0 +1,101 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-window.h"
+
+// Built when there's no X11 to build rsbl-x11-window.cpp against. Windows can't be created, so
+// nothing past Create is ever called on one.
+
+namespace rsbl
+{
+
+struct Window::MessageState
+{
+};
+
+Result<UniquePtr<Window>> Window::Create(uint2 size, int2 position)
+{
+    WindowCreateInfo info;
+    info.size = size;
+    info.position = position;
+    return Create(info);
+}
+
+Result<UniquePtr<Window>> Window::Create(const WindowCreateInfo&)
+{
+    return {ErrorCategory::Platform, "No window system, rsbl-platform was built without X11"};
+}
+
+Window::Window(uint2 size, int2 position)
+    : m_size(size)
+    , m_position(position)
+    , m_platformData{nullptr}
+{
+}
+
+Window::~Window()
+{
+    delete m_messages;
+}
+
+WindowNativeData Window::GetNativeData() const
+{
+    return m_platformData;
+}
+
+void Window::Show()
+{
+}
+
+void Window::Hide()
+{
+}
+
+bool Window::IsVisible() const
+{
+    return false;
+}
+
+bool Window::IsMinimized() const
+{
+    return false;
+}
+
+void Window::SetTitle(const char*)
+{
+}
+
+void Window::SetMode(WindowMode)
+{
+}
+
+bool Window::PopInputEvent(InputEvent&)
+{
+    return false;
+}
+
+uint64 Window::DroppedInputEvents() const
+{
+    return 0;
+}
+
+WindowMessageResult Window::ProcessMessages()
+{
+    return WindowMessageResult::Quit;
+}
+
+WindowMessageResult Window::WaitForEvents(uint32, ArrayView<void* const>, uint32* signalledHandle)
+{
+    if (signalledHandle != nullptr)
+    {
+        *signalledHandle = ~0u;
+    }
+    return WindowMessageResult::Quit;
+}
+
+WindowMessageResult Window::DrainEvents()
+{
+    return WindowMessageResult::Quit;
+}
+
+} // namespace rsbl
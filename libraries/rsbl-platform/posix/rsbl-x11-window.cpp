@@ -0,0 +1,354 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-window.h"
+
+#include <rsbl-concurrent-queue.h>
+#include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-profile.h>
+
+#include <cstdlib>
+
+#include <poll.h>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+
+// Xlib's macros collide with rsbl names (ResultCode::Success, ErrorCategory::None)
+#undef None
+#undef Success
+#undef Always
+#undef Bool
+#undef Status
+#undef True
+#undef False
+
+// Xlib on its own, which Wayland desktops run through XWayland. Xlib pumps nothing the caller
+// doesn't ask it to and has no modal loops to escape, so WindowThreading::MessageThread pumps on
+// the caller's thread like CallerThread does.
+// TODO: Native Wayland, once the build can generate the xdg-shell protocol's bindings
+// TODO: Raw input through XInput2 (XI_RawMotion and friends)
+
+namespace rsbl
+{
+
+namespace
+{
+// The structure and focus changes the window is told about
+constexpr long kEventMask = StructureNotifyMask | ExposureMask | FocusChangeMask;
+
+// Extra wait handles, as on Windows. The display connection takes one more slot.
+constexpr uint32 kMaxWaitHandles = 62;
+
+// The window's top left in root window coordinates. ConfigureNotify's coordinates are relative
+// to whatever the window manager reparented it into.
+int2 QueryPosition(Display* display, ::Window window, int2 fallback)
+{
+    int x = 0;
+    int y = 0;
+    ::Window child = 0;
+    if (!XTranslateCoordinates(
+            display, window, DefaultRootWindow(display), 0, 0, &x, &y, &child))
+    {
+        return fallback;
+    }
+    return int2(x, y);
+}
+
+// Desktops set Xft.dpi for their scaling, one for every monitor. 1 if there's none.
+float QueryDpiScale(Display* display)
+{
+    const char* dpi = XGetDefault(display, "Xft", "dpi");
+    const double value = dpi != nullptr ? std::strtod(dpi, nullptr) : 0.0;
+    return value > 0.0 ? static_cast<float>(value / 96.0) : 1.0f;
+}
+} // namespace
+
+struct Window::MessageState
+{
+    Display* display = nullptr;
+    ::Window window = 0;
+    Atom deleteWindow = 0;
+
+    bool quit = false;
+    // Shown by the caller, and mapped by the server. Shown and unmapped is iconified.
+    bool shown = false;
+    bool mapped = false;
+
+    // Never filled, there's no raw input here yet
+    SpscRing<InputEvent> input{1};
+};
+
+Result<UniquePtr<Window>> Window::Create(uint2 size, int2 position)
+{
+    WindowCreateInfo info;
+    info.size = size;
+    info.position = position;
+    return Create(info);
+}
+
+Result<UniquePtr<Window>> Window::Create(const WindowCreateInfo& info)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    // DISPLAY picks the server
+    Display* display = XOpenDisplay(nullptr);
+    if (display == nullptr)
+    {
+        return {ErrorCategory::Platform, "Failed to open X display"};
+    }
+
+    const int screen = DefaultScreen(display);
+    const int pos_x = info.position.x == -1 ? 0 : info.position.x;
+    const int pos_y = info.position.y == -1 ? 0 : info.position.y;
+    const ::Window window = XCreateSimpleWindow(display,
+                                                RootWindow(display, screen),
+                                                pos_x,
+                                                pos_y,
+                                                info.size.x,
+                                                info.size.y,
+                                                0,
+                                                BlackPixel(display, screen),
+                                                BlackPixel(display, screen));
+    if (window == 0)
+    {
+        XCloseDisplay(display);
+        return {ErrorCategory::Platform, "Failed to create window"};
+    }
+
+    // Without a position hint the window manager places it wherever it likes
+    if (info.position.x != -1 || info.position.y != -1)
+    {
+        XSizeHints hints = {};
+        hints.flags = USPosition;
+        hints.x = pos_x;
+        hints.y = pos_y;
+        XSetWMNormalHints(display, window, &hints);
+    }
+
+    XSelectInput(display, window, kEventMask);
+    XStoreName(display, window, "RSBL Window");
+
+    // Closing the window asks instead of killing the connection
+    Atom delete_window = XInternAtom(display, "WM_DELETE_WINDOW", 0);
+    XSetWMProtocols(display, window, &delete_window, 1);
+
+    if (info.rawInput)
+    {
+        RSBL_LOG_WARNING("Raw input isn't supported on X11, PopInputEvent won't return any");
+    }
+
+    UniquePtr<Window> created(new Window(info.size, info.position));
+    MessageState* state = new MessageState();
+    state->display = display;
+    state->window = window;
+    state->deleteWindow = delete_window;
+    created->m_messages = state;
+    created->m_platformData.platform_handle = reinterpret_cast<void*>(window);
+    created->m_platformData.display_handle = display;
+
+    created->Show();
+    created->m_position = QueryPosition(display, window, info.position);
+    created->m_dpiScale = QueryDpiScale(display);
+
+    RSBL_LOG_INFO("rsbl::Window created with X11 window {:#x}", static_cast<uint64>(window));
+
+    return rsblMove(created);
+}
+
+Window::Window(uint2 size, int2 position)
+    : m_size(size)
+    , m_position(position)
+    , m_platformData{nullptr}
+{
+}
+
+Window::~Window()
+{
+    if (m_messages != nullptr)
+    {
+        RSBL_LOG_INFO("rsbl::Window torn down - X11 window {:#x}",
+                      static_cast<uint64>(m_messages->window));
+        XDestroyWindow(m_messages->display, m_messages->window);
+        XCloseDisplay(m_messages->display);
+        delete m_messages;
+    }
+}
+
+WindowNativeData Window::GetNativeData() const
+{
+    return m_platformData;
+}
+
+void Window::Show()
+{
+    if (m_messages != nullptr)
+    {
+        XMapWindow(m_messages->display, m_messages->window);
+        XFlush(m_messages->display);
+        m_messages->shown = true;
+        // Until the server says otherwise, so it doesn't look iconified in the meantime
+        m_messages->mapped = true;
+    }
+}
+
+void Window::Hide()
+{
+    if (m_messages != nullptr)
+    {
+        XUnmapWindow(m_messages->display, m_messages->window);
+        XFlush(m_messages->display);
+        m_messages->shown = false;
+    }
+}
+
+bool Window::IsVisible() const
+{
+    return m_messages != nullptr && m_messages->shown;
+}
+
+bool Window::IsMinimized() const
+{
+    return m_messages != nullptr && m_messages->shown && !m_messages->mapped;
+}
+
+void Window::SetTitle(const char* title)
+{
+    if (m_messages != nullptr)
+    {
+        XStoreName(m_messages->display, m_messages->window, title);
+        XFlush(m_messages->display);
+    }
+}
+
+void Window::SetMode(WindowMode mode)
+{
+    if (m_messages == nullptr || mode == m_mode)
+    {
+        return;
+    }
+
+    // Asked of the window manager through _NET_WM_STATE, which does the rest
+    Display* display = m_messages->display;
+    XEvent event = {};
+    event.xclient.type = ClientMessage;
+    event.xclient.window = m_messages->window;
+    event.xclient.message_type = XInternAtom(display, "_NET_WM_STATE", 0);
+    event.xclient.format = 32;
+    event.xclient.data.l[0] = mode == WindowMode::Fullscreen ? 1 : 0; // Add or remove
+    event.xclient.data.l[1] =
+        static_cast<long>(XInternAtom(display, "_NET_WM_STATE_FULLSCREEN", 0));
+    event.xclient.data.l[3] = 1; // From an application
+    XSendEvent(display,
+               DefaultRootWindow(display),
+               0,
+               SubstructureRedirectMask | SubstructureNotifyMask,
+               &event);
+    XFlush(display);
+    m_mode = mode;
+}
+
+bool Window::PopInputEvent(InputEvent& event)
+{
+    return m_messages->input.TryPop(event);
+}
+
+uint64 Window::DroppedInputEvents() const
+{
+    return 0;
+}
+
+WindowMessageResult Window::ProcessMessages()
+{
+    RSBL_PROFILE_ZONE("Window::ProcessMessages");
+    return DrainEvents();
+}
+
+WindowMessageResult Window::WaitForEvents(uint32 timeoutMs,
+                                          ArrayView<void* const> extraWaitHandles,
+                                          uint32* signalledHandle)
+{
+    RSBL_PROFILE_ZONE("Window::WaitForEvents");
+
+    rsblAssertMsg(extraWaitHandles.Size() <= kMaxWaitHandles, "Too many wait handles");
+    const uint32 extra_count = static_cast<uint32>(extraWaitHandles.Size());
+
+    // Events already read off the connection won't make it readable
+    Display* display = m_messages->display;
+    XFlush(display);
+    uint32 signalled = ~0u;
+    if (XPending(display) == 0)
+    {
+        pollfd fds[kMaxWaitHandles + 1];
+        for (uint32 i = 0; i < extra_count; ++i)
+        {
+            fds[i].fd = static_cast<int>(reinterpret_cast<intptr_t>(extraWaitHandles[i]));
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+        fds[extra_count].fd = ConnectionNumber(display);
+        fds[extra_count].events = POLLIN;
+        fds[extra_count].revents = 0;
+
+        if (poll(fds, extra_count + 1, static_cast<int>(timeoutMs)) > 0)
+        {
+            for (uint32 i = 0; i < extra_count && signalled == ~0u; ++i)
+            {
+                signalled = (fds[i].revents & POLLIN) != 0 ? i : ~0u;
+            }
+        }
+    }
+
+    if (signalledHandle != nullptr)
+    {
+        *signalledHandle = signalled;
+    }
+    return ProcessMessages();
+}
+
+WindowMessageResult Window::DrainEvents()
+{
+    Display* display = m_messages->display;
+    while (XPending(display) > 0)
+    {
+        XEvent event;
+        XNextEvent(display, &event);
+        switch (event.type)
+        {
+        case ConfigureNotify:
+        {
+            const uint2 size(static_cast<uint32>(event.xconfigure.width),
+                             static_cast<uint32>(event.xconfigure.height));
+            if (size.x != m_size.x || size.y != m_size.y)
+            {
+                m_size = size;
+                m_resizeFlagged = true;
+            }
+            m_position = QueryPosition(display, m_messages->window, m_position);
+            break;
+        }
+        case MapNotify:
+            m_messages->mapped = true;
+            break;
+        case UnmapNotify:
+            m_messages->mapped = false;
+            break;
+        case ClientMessage:
+            if (static_cast<Atom>(event.xclient.data.l[0]) == m_messages->deleteWindow)
+            {
+                m_messages->quit = true;
+            }
+            break;
+        case DestroyNotify:
+            m_messages->quit = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return m_messages->quit ? WindowMessageResult::Quit : WindowMessageResult::Continue;
+}
+
+} // namespace rsbl
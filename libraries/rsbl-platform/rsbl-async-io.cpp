@@ -0,0 +1,92 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-async-io.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-bits.h>
+
+namespace rsbl
+{
+
+const char* AsyncIoBackendName(AsyncIoBackend backend)
+{
+    switch (backend)
+    {
+    case AsyncIoBackend::IoRing:
+        return "IoRing";
+    case AsyncIoBackend::CompletionPort:
+        return "CompletionPort";
+    case AsyncIoBackend::IoUring:
+        return "io_uring";
+    case AsyncIoBackend::Threads:
+        return "Threads";
+    }
+    return "Unknown";
+}
+
+Result<uint64> ReadFileParallel(
+    AsyncIo& io, FileHandle file, MutableByteView buffer, uint64 offset, uint64 chunkSize)
+{
+    rsblAssertMsg(IsPowerOfTwo(chunkSize) && chunkSize >= 4096 && chunkSize <= kMaxAsyncReadSize,
+                  "Chunks are a power of two between 4 KB and kMaxAsyncReadSize");
+    rsblAssertMsg(io.InFlight() == 0, "ReadFileParallel needs the AsyncIo to itself");
+
+    // Every piece but the last ends on a chunk boundary in the file. userData is the piece's
+    // place in the buffer, so a short piece tells where the file ended.
+    uint64 next = 0;
+    uint64 file_end = buffer.Size();
+    bool failed = false;
+    AsyncIoCompletion completions[32];
+    for (;;)
+    {
+        // Nothing more goes in past a failure or the end of the file
+        while (!failed && next < file_end)
+        {
+            const uint64 position = offset + next;
+            const uint64 boundary = AlignUp(position + 1, chunkSize) - offset;
+            const uint64 end = boundary < buffer.Size() ? boundary : buffer.Size();
+            if (!io.QueueRead({file, position, buffer.Subview(next, end - next), next}))
+            {
+                break;
+            }
+            next = end;
+        }
+
+        // What's in flight still has to come back before its buffers can go
+        if (!io.Submit())
+        {
+            failed = true;
+        }
+        if (io.InFlight() == 0)
+        {
+            break;
+        }
+
+        const uint32 count = io.WaitCompletions(completions, 32);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            const AsyncIoCompletion& done = completions[i];
+            if (!done.succeeded)
+            {
+                failed = true;
+                continue;
+            }
+            const uint64 piece_end = AlignUp(offset + done.userData + 1, chunkSize) - offset;
+            const uint64 expected = (piece_end < buffer.Size() ? piece_end : buffer.Size()) -
+                                    done.userData;
+            if (done.bytesRead < expected && done.userData + done.bytesRead < file_end)
+            {
+                file_end = done.userData + done.bytesRead;
+            }
+        }
+    }
+
+    if (failed)
+    {
+        return {ErrorCategory::Io, "Failed to read part of the file"};
+    }
+    return file_end;
+}
+
+} // namespace rsbl
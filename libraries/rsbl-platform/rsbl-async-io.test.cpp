@@ -0,0 +1,209 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-async-io.h"
+
+#include <rsbl-dynamic-array.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kTestPath = "rsbl-async-io-test.bin";
+constexpr uint32 kFileSize = 1024 * 1024 + 100;
+
+uint8 ByteAt(uint64 offset)
+{
+    return static_cast<uint8>((offset * 31) ^ (offset >> 8));
+}
+
+void WriteTestFile()
+{
+    DynamicArray<uint8> data;
+    data.Resize(kFileSize);
+    for (uint32 i = 0; i < kFileSize; ++i)
+    {
+        data[i] = ByteAt(i);
+    }
+    Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Write);
+    REQUIRE(file);
+    REQUIRE(WriteFile(file.Value(), AsBytes(data.Data(), data.Size())));
+    REQUIRE(CloseFile(file.Value()));
+}
+
+UniquePtr<AsyncIo> MakeAsyncIo(bool allowKernelQueues, uint32 queueDepth = 128)
+{
+    AsyncIoOptions options;
+    options.queueDepth = queueDepth;
+    options.allowKernelQueues = allowKernelQueues;
+    Result<UniquePtr<AsyncIo>> io = AsyncIo::Create(options);
+    REQUIRE(io);
+    return rsblMove(io.Value());
+}
+} // namespace
+
+TEST_SUITE("rsbl::AsyncIo")
+{
+    TEST_CASE("Many reads in flight come back with the right data")
+    {
+        WriteTestFile();
+
+        for (bool kernel_queues : {true, false})
+        {
+            UniquePtr<AsyncIo> io = MakeAsyncIo(kernel_queues);
+            INFO("Backend: ", AsyncIoBackendName(io->Backend()));
+            if (!kernel_queues)
+            {
+                CHECK(io->Backend() == AsyncIoBackend::Threads);
+            }
+
+            Result<FileHandle> file = io->OpenForRead(kTestPath);
+            REQUIRE(file);
+
+            // 64 chunks of 16 KB, the last one running into the end of the file
+            constexpr uint32 kChunkSize = 16 * 1024;
+            constexpr uint32 kChunkCount = 65;
+            DynamicArray<uint8> buffer;
+            buffer.Resize(kChunkCount * kChunkSize);
+            for (uint32 i = 0; i < kChunkCount; ++i)
+            {
+                AsyncRead read;
+                read.file = file.Value();
+                read.offset = static_cast<uint64>(i) * kChunkSize;
+                read.buffer = MutableByteView(buffer.Data() + i * kChunkSize, kChunkSize);
+                read.userData = i;
+                REQUIRE(io->QueueRead(read));
+            }
+            REQUIRE(io->Submit());
+            CHECK(io->InFlight() == kChunkCount);
+
+            bool seen[kChunkCount] = {};
+            uint32 completed = 0;
+            AsyncIoCompletion completions[16];
+            while (io->InFlight() > 0)
+            {
+                const uint32 count = io->WaitCompletions(completions, 16);
+                REQUIRE(count > 0);
+                for (uint32 c = 0; c < count; ++c)
+                {
+                    const AsyncIoCompletion& done = completions[c];
+                    REQUIRE(done.succeeded);
+                    REQUIRE(done.userData < kChunkCount);
+                    CHECK_FALSE(seen[done.userData]);
+                    seen[done.userData] = true;
+
+                    const uint64 start = done.userData * kChunkSize;
+                    const uint64 expected = start + kChunkSize <= kFileSize ? kChunkSize
+                                                                            : kFileSize - start;
+                    CHECK(done.bytesRead == expected);
+                    ++completed;
+                }
+            }
+            CHECK(completed == kChunkCount);
+
+            bool matches = true;
+            for (uint32 i = 0; i < kFileSize; ++i)
+            {
+                matches = matches && buffer[i] == ByteAt(i);
+            }
+            CHECK(matches);
+
+            CHECK(CloseFile(file.Value()));
+        }
+
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("The queue depth is a limit")
+    {
+        WriteTestFile();
+        UniquePtr<AsyncIo> io = MakeAsyncIo(true, 4);
+        Result<FileHandle> file = io->OpenForRead(kTestPath);
+        REQUIRE(file);
+
+        uint8 buffer[4][64];
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            CHECK(io->QueueRead({file.Value(), i * 64ull, MutableByteView(buffer[i], 64), i}));
+        }
+        CHECK_FALSE(io->QueueRead({file.Value(), 0, MutableByteView(buffer[0], 64), 9}));
+        REQUIRE(io->Submit());
+
+        // Room again once something's reaped
+        AsyncIoCompletion completion;
+        REQUIRE(io->WaitCompletions(&completion, 1) == 1);
+        MutableByteView reused(buffer[completion.userData], 64);
+        CHECK(io->QueueRead({file.Value(), 0, reused, 9}));
+        REQUIRE(io->Submit());
+
+        // The rest are waited for on the way out
+        io.Reset();
+        CHECK(CloseFile(file.Value()));
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Reading past the end reads nothing")
+    {
+        WriteTestFile();
+        for (bool kernel_queues : {true, false})
+        {
+            UniquePtr<AsyncIo> io = MakeAsyncIo(kernel_queues);
+            Result<FileHandle> file = io->OpenForRead(kTestPath);
+            REQUIRE(file);
+
+            uint8 buffer[64];
+            REQUIRE(io->QueueRead({file.Value(), kFileSize + 1000ull, MutableByteView(buffer), 1}));
+            REQUIRE(io->Submit());
+            AsyncIoCompletion completion;
+            REQUIRE(io->WaitCompletions(&completion, 1) == 1);
+            CHECK(completion.succeeded);
+            CHECK(completion.bytesRead == 0);
+            CHECK(io->WaitCompletions(&completion, 1) == 0);
+
+            CHECK(CloseFile(file.Value()));
+        }
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Large reads go in parallel pieces")
+    {
+        WriteTestFile();
+        UniquePtr<AsyncIo> io = MakeAsyncIo(true, 8);
+        Result<FileHandle> file = io->OpenForRead(kTestPath);
+        REQUIRE(file);
+
+        // Starts off a chunk boundary, and runs past the end of the file
+        const uint64 offset = 1000;
+        DynamicArray<uint8> buffer;
+        buffer.Resize(kFileSize);
+        Result<uint64> read =
+            ReadFileParallel(*io, file.Value(), MutableByteView(buffer), offset, 64 * 1024);
+        REQUIRE(read);
+        CHECK(read.Value() == kFileSize - offset);
+        CHECK(io->InFlight() == 0);
+
+        bool matches = true;
+        for (uint64 i = 0; i < read.Value(); ++i)
+        {
+            matches = matches && buffer[i] == ByteAt(offset + i);
+        }
+        CHECK(matches);
+
+        CHECK(CloseFile(file.Value()));
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Missing files")
+    {
+        UniquePtr<AsyncIo> io = MakeAsyncIo(true);
+        Result<FileHandle> file = io->OpenForRead("rsbl-async-io-missing.bin");
+        CHECK_FALSE(file);
+        CHECK(file.Category() == ErrorCategory::NotFound);
+    }
+}
@@ -0,0 +1,100 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-clock.h"
+#include "include/rsbl-thread.h"
+
+using namespace rsbl;
+
+TEST_SUITE("rsbl::Clock")
+{
+    TEST_CASE("Ticks are monotonic")
+    {
+        uint64 previous = Clock::NowTicks();
+        for (uint32 i = 0; i < 10000; ++i)
+        {
+            const uint64 now = Clock::NowTicks();
+            CHECK(now >= previous);
+            previous = now;
+        }
+    }
+
+    TEST_CASE("Tick conversion")
+    {
+        const uint64 frequency = Clock::TicksPerSecond();
+        REQUIRE(frequency > 0);
+        CHECK(Clock::TicksToNs(0) == 0);
+        CHECK(Clock::TicksToNs(frequency) == 1'000'000'000ull);
+        CHECK(Clock::TicksToNs(frequency / 2) == 500'000'000ull);
+        CHECK(Clock::TicksToSeconds(frequency * 3) == doctest::Approx(3.0));
+        CHECK(Clock::TicksToMs(frequency) == doctest::Approx(1000.0));
+
+        // Hours worth of ticks don't overflow the conversion
+        CHECK(Clock::TicksToNs(frequency * 3600 * 24) == 86'400'000'000'000ull);
+    }
+
+    TEST_CASE("Sleep is measurable")
+    {
+        const uint64 start = Clock::NowTicks();
+        Thread::ThreadSleep(20);
+        const uint64 elapsed_ns = Clock::TicksToNs(Clock::NowTicks() - start);
+
+        // Sleeps can overshoot by a lot on a busy machine, but never undershoot by much
+        CHECK(elapsed_ns >= 15'000'000ull);
+        CHECK(elapsed_ns < 5'000'000'000ull);
+    }
+
+    TEST_CASE("Thread CPU time counts work, not sleep")
+    {
+        // Spin until the CPU clock has clearly moved, it can be coarse
+        const uint64 start = Clock::ThreadCpuNs();
+        const uint64 wall_start = Clock::NowNs();
+        volatile uint64 sink = 0;
+        while (Clock::ThreadCpuNs() - start < 30'000'000ull &&
+               Clock::NowNs() - wall_start < 5'000'000'000ull)
+        {
+            for (uint32 i = 0; i < 10000; ++i)
+            {
+                sink = sink + i;
+            }
+        }
+        const uint64 worked = Clock::ThreadCpuNs() - start;
+        CHECK(worked >= 30'000'000ull);
+        // Never more than the wall time it took, the thread ran on one core at a time
+        CHECK(worked <= Clock::NowNs() - wall_start + 20'000'000ull);
+
+        const uint64 before_sleep = Clock::ThreadCpuNs();
+        Thread::ThreadSleep(50);
+        CHECK(Clock::ThreadCpuNs() - before_sleep < 25'000'000ull);
+    }
+
+    TEST_CASE("Cycles advance")
+    {
+        const uint64 start = Clock::Cycles();
+        volatile uint64 sink = 0;
+        for (uint32 i = 0; i < 100000; ++i)
+        {
+            sink = sink + i;
+        }
+        CHECK(Clock::Cycles() > start);
+    }
+
+    TEST_CASE("ScopedTimer")
+    {
+        uint64 elapsed_ns = 0;
+        {
+            ScopedTimer timer(&elapsed_ns);
+            Thread::ThreadSleep(10);
+            CHECK(timer.ElapsedNs() >= 5'000'000ull);
+            CHECK(timer.ElapsedMs() >= 5.0);
+        }
+        CHECK(elapsed_ns >= 5'000'000ull);
+
+        // Without a target it's just a stopwatch
+        ScopedTimer stopwatch;
+        CHECK(stopwatch.ElapsedTicks() < Clock::TicksPerSecond() * 5);
+    }
+}
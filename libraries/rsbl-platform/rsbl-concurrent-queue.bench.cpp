@@ -0,0 +1,174 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Throughput of SpscRing and MpmcQueue across producer/consumer counts up to the hardware's,
+// single item and batched. A run moves the same number of items whatever the thread count,
+// split between the producers; consumers drain until everything has arrived.
+
+#include "include/rsbl-thread.h"
+
+#include <rsbl-bench.h>
+#include <rsbl-concurrent-queue.h>
+
+#include <atomic>
+#include <cstdio>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint64 kItemsPerRun = 1 << 20;
+constexpr uint64 kCapacity = 1024;
+constexpr uint64 kBatchSize = 32;
+
+// Stop the optimizer from folding the consumer loops away
+std::atomic<uint64> s_sink{0};
+
+template <typename Queue>
+void Produce(Queue& queue, uint64 count, bool batched)
+{
+    uint64 batch[kBatchSize];
+    uint64 next = 0;
+    while (next < count)
+    {
+        if (batched)
+        {
+            uint64 size = count - next;
+            size = size < kBatchSize ? size : kBatchSize;
+            for (uint64 i = 0; i < size; ++i)
+            {
+                batch[i] = next + i;
+            }
+            const uint64 pushed = queue.TryPushBatch(batch, size);
+            next += pushed;
+            if (pushed == 0)
+            {
+                Thread::ThreadYield();
+            }
+        }
+        else if (queue.TryPush(next))
+        {
+            ++next;
+        }
+        else
+        {
+            Thread::ThreadYield();
+        }
+    }
+}
+
+template <typename Queue>
+void Consume(Queue& queue, std::atomic<uint64>& consumed, uint64 total, bool batched)
+{
+    uint64 sum = 0;
+    uint64 batch[kBatchSize];
+    while (consumed.load(std::memory_order_relaxed) < total)
+    {
+        uint64 popped = 0;
+        if (batched)
+        {
+            popped = queue.TryPopBatch(batch, kBatchSize);
+            for (uint64 i = 0; i < popped; ++i)
+            {
+                sum += batch[i];
+            }
+        }
+        else if (queue.TryPop(batch[0]))
+        {
+            sum += batch[0];
+            popped = 1;
+        }
+
+        if (popped > 0)
+        {
+            consumed.fetch_add(popped, std::memory_order_relaxed);
+        }
+        else
+        {
+            Thread::ThreadYield();
+        }
+    }
+    s_sink.fetch_add(sum, std::memory_order_relaxed);
+}
+
+template <typename Queue>
+void Run(Bench& bench, const char* name, uint32 producerCount, uint32 consumerCount, bool batched)
+{
+    // Grouped so the thread lambdas fit in a BenchThreads::Body
+    struct Shared
+    {
+        UniquePtr<Queue> queue;
+        std::atomic<uint64> consumed{0};
+        uint64 total = 0;
+    };
+    Shared shared;
+    const uint64 perProducer = kItemsPerRun / producerCount;
+    shared.total = perProducer * producerCount;
+
+    char fullName[96];
+    snprintf(fullName,
+             sizeof(fullName),
+             "%s %u:%u %s",
+             name,
+             producerCount,
+             consumerCount,
+             batched ? "batch" : "single");
+
+    UniquePtr<BenchThreads> threads;
+    bench.Run(fullName, [&]() {
+        shared.queue = MakeUnique<Queue>(kCapacity);
+        shared.consumed.store(0, std::memory_order_relaxed);
+        threads = MakeUnique<BenchThreads>(producerCount + consumerCount);
+        for (uint32 p = 0; p < producerCount; ++p)
+        {
+            threads->Add([&shared, perProducer, batched]() {
+                Produce(*shared.queue, perProducer, batched);
+            });
+        }
+        for (uint32 c = 0; c < consumerCount; ++c)
+        {
+            threads->Add([&shared, batched]() {
+                Consume(*shared.queue, shared.consumed, shared.total, batched);
+            });
+        }
+    }, [&]() {
+        threads->Start();
+        threads->Join();
+    }, {.items = shared.total});
+    threads = UniquePtr<BenchThreads>();
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Bench bench("rsbl-concurrent-queue", argc, argv);
+    const uint32 hardwareThreads = Thread::GetHardwareThreadCount();
+    printf("Capacity %llu, batch %llu, %u hardware threads\n",
+           static_cast<unsigned long long>(kCapacity),
+           static_cast<unsigned long long>(kBatchSize),
+           hardwareThreads);
+
+    bench.Section("SpscRing");
+    for (bool batched : {false, true})
+    {
+        Run<SpscRing<uint64>>(bench, "SpscRing", 1, 1, batched);
+    }
+
+    // As many producers as consumers, then many producers into one consumer, the way workers
+    // feed a render or IO thread. Up to 64 threads in all, or the hardware's.
+    const uint32 maxThreads = hardwareThreads < 64 ? hardwareThreads : 64;
+    for (bool batched : {false, true})
+    {
+        bench.Section(batched ? "MpmcQueue, batched" : "MpmcQueue");
+        for (uint32 producers = 1; producers * 2 <= maxThreads || producers == 1; producers *= 2)
+        {
+            Run<MpmcQueue<uint64>>(bench, "MpmcQueue", producers, producers, batched);
+        }
+        for (uint32 producers = 2; producers + 1 <= maxThreads; producers *= 2)
+        {
+            Run<MpmcQueue<uint64>>(bench, "MpmcQueue", producers, 1, batched);
+        }
+    }
+
+    return bench.Finish();
+}
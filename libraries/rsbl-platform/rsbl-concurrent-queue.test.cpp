@@ -0,0 +1,434 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-thread.h"
+
+#include <rsbl-concurrent-queue.h>
+#include <rsbl-dynamic-array.h>
+
+#include <atomic>
+
+using namespace rsbl;
+
+namespace
+{
+// Counts live instances, to check the queues destroy exactly what they constructed
+struct Tracked
+{
+    static inline std::atomic<int> s_live{0};
+    int value = 0;
+
+    Tracked()
+    {
+        s_live++;
+    }
+    Tracked(int v)
+        : value(v)
+    {
+        s_live++;
+    }
+    Tracked(const Tracked& other)
+        : value(other.value)
+    {
+        s_live++;
+    }
+    Tracked(Tracked&& other) noexcept
+        : value(other.value)
+    {
+        s_live++;
+    }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) noexcept = default;
+    ~Tracked()
+    {
+        s_live--;
+    }
+};
+
+// Every producer pushes [0, count) tagged with its index, every consumer sums what it pops
+template <typename Queue>
+void RunProducersConsumers(Queue& queue,
+                           uint32 producer_count,
+                           uint32 consumer_count,
+                           uint64 count_per_producer)
+{
+    std::atomic<uint64> consumed{0};
+    std::atomic<uint64> sum{0};
+    const uint64 total = producer_count * count_per_producer;
+
+    DynamicArray<UniquePtr<Thread>> threads;
+    for (uint32 p = 0; p < producer_count; ++p)
+    {
+        auto result = Thread::Create([&queue, count_per_producer]() -> Result<> {
+            for (uint64 i = 0; i < count_per_producer; ++i)
+            {
+                while (!queue.TryPush(i + 1))
+                {
+                    Thread::ThreadYield();
+                }
+            }
+            return ResultCode::Success;
+        });
+        REQUIRE(result);
+        threads.PushBack(rsblMove(result.Value()));
+    }
+
+    for (uint32 c = 0; c < consumer_count; ++c)
+    {
+        auto result = Thread::Create([&queue, &consumed, &sum, total]() -> Result<> {
+            uint64 local_sum = 0;
+            uint64 batch[16];
+            while (consumed.load(std::memory_order_relaxed) < total)
+            {
+                const uint64 popped = queue.TryPopBatch(batch, 16);
+                for (uint64 i = 0; i < popped; ++i)
+                {
+                    local_sum += batch[i];
+                }
+                if (popped == 0)
+                {
+                    Thread::ThreadYield();
+                }
+                consumed.fetch_add(popped, std::memory_order_relaxed);
+            }
+            sum.fetch_add(local_sum, std::memory_order_relaxed);
+            return ResultCode::Success;
+        });
+        REQUIRE(result);
+        threads.PushBack(rsblMove(result.Value()));
+    }
+
+    for (UniquePtr<Thread>& thread : threads)
+    {
+        CHECK(thread->Join());
+    }
+
+    CHECK(consumed.load() == total);
+    CHECK(sum.load() == producer_count * (count_per_producer * (count_per_producer + 1) / 2));
+    CHECK(queue.SizeApprox() == 0);
+}
+} // namespace
+
+TEST_SUITE("rsbl::SpscRing")
+{
+    TEST_CASE("Capacity rounds up to a power of two")
+    {
+        SpscRing<int> ring(100);
+        CHECK(ring.Capacity() == 128);
+        CHECK(ring.IsEmptyApprox());
+    }
+
+    TEST_CASE("Push and pop in order")
+    {
+        SpscRing<int> ring(4);
+        CHECK(ring.TryPush(1));
+        CHECK(ring.TryPush(2));
+        CHECK(ring.TryPush(3));
+        CHECK(ring.TryPush(4));
+        CHECK_FALSE(ring.TryPush(5));
+        CHECK(ring.SizeApprox() == 4);
+
+        int value = 0;
+        for (int expected = 1; expected <= 4; ++expected)
+        {
+            REQUIRE(ring.TryPop(value));
+            CHECK(value == expected);
+        }
+        CHECK_FALSE(ring.TryPop(value));
+    }
+
+    TEST_CASE("Wraps around")
+    {
+        SpscRing<int> ring(4);
+        int value = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            REQUIRE(ring.TryPush(i));
+            REQUIRE(ring.TryPush(i + 1000));
+            REQUIRE(ring.TryPop(value));
+            CHECK(value == i);
+            REQUIRE(ring.TryPop(value));
+            CHECK(value == i + 1000);
+        }
+    }
+
+    TEST_CASE("Batches are clipped to what fits")
+    {
+        SpscRing<int> ring(8);
+        int values[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+        CHECK(ring.TryPushBatch(values, 12) == 8);
+        CHECK(ring.TryPushBatch(values, 1) == 0);
+
+        int out[12] = {};
+        CHECK(ring.TryPopBatch(out, 5) == 5);
+        CHECK(out[0] == 0);
+        CHECK(out[4] == 4);
+
+        CHECK(ring.TryPushBatch(values + 8, 4) == 4);
+        CHECK(ring.TryPopBatch(out, 12) == 7);
+        CHECK(out[0] == 5);
+        CHECK(out[2] == 7);
+        CHECK(out[3] == 8);
+        CHECK(out[6] == 11);
+        CHECK(ring.TryPopBatch(out, 12) == 0);
+    }
+
+    TEST_CASE("Destroys what's left")
+    {
+        Tracked::s_live = 0;
+        {
+            SpscRing<Tracked> ring(8);
+            ring.TryEmplace(1);
+            ring.TryEmplace(2);
+            ring.TryEmplace(3);
+
+            Tracked out;
+            CHECK(ring.TryPop(out));
+            CHECK(out.value == 1);
+            CHECK(Tracked::s_live == 3);
+        }
+        CHECK(Tracked::s_live == 0);
+    }
+
+    TEST_CASE("One producer, one consumer")
+    {
+        SpscRing<uint64> ring(64);
+        RunProducersConsumers(ring, 1, 1, 100000);
+    }
+}
+
+TEST_SUITE("rsbl::MpmcQueue")
+{
+    TEST_CASE("Capacity rounds up to a power of two")
+    {
+        MpmcQueue<int> queue(3);
+        CHECK(queue.Capacity() == 4);
+    }
+
+    TEST_CASE("Push and pop in order")
+    {
+        MpmcQueue<int> queue(4);
+        for (int i = 0; i < 4; ++i)
+        {
+            CHECK(queue.TryPush(i));
+        }
+        CHECK_FALSE(queue.TryPush(4));
+
+        int value = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            REQUIRE(queue.TryPop(value));
+            CHECK(value == i);
+        }
+        CHECK_FALSE(queue.TryPop(value));
+    }
+
+    TEST_CASE("Wraps around")
+    {
+        MpmcQueue<int> queue(2);
+        int value = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            REQUIRE(queue.TryPush(i));
+            REQUIRE(queue.TryPop(value));
+            CHECK(value == i);
+        }
+    }
+
+    TEST_CASE("Batches are clipped to what fits")
+    {
+        MpmcQueue<int> queue(8);
+        int values[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+        CHECK(queue.TryPushBatch(values, 12) == 8);
+        CHECK(queue.TryPushBatch(values, 1) == 0);
+
+        int out[12] = {};
+        CHECK(queue.TryPopBatch(out, 5) == 5);
+        CHECK(out[0] == 0);
+        CHECK(out[4] == 4);
+
+        CHECK(queue.TryPushBatch(values + 8, 4) == 4);
+        CHECK(queue.TryPopBatch(out, 12) == 7);
+        CHECK(out[0] == 5);
+        CHECK(out[3] == 8);
+        CHECK(out[6] == 11);
+        CHECK(queue.TryPopBatch(out, 12) == 0);
+    }
+
+    TEST_CASE("Destroys what's left")
+    {
+        Tracked::s_live = 0;
+        {
+            MpmcQueue<Tracked> queue(8);
+            queue.TryEmplace(1);
+            queue.TryEmplace(2);
+
+            Tracked batch[2] = {Tracked(3), Tracked(4)};
+            CHECK(queue.TryPushBatch(batch, 2) == 2);
+            CHECK(Tracked::s_live == 6);
+        }
+        CHECK(Tracked::s_live == 0);
+    }
+
+    TEST_CASE("One producer, one consumer")
+    {
+        MpmcQueue<uint64> queue(64);
+        RunProducersConsumers(queue, 1, 1, 100000);
+    }
+
+    TEST_CASE("Many producers, one consumer")
+    {
+        MpmcQueue<uint64> queue(64);
+        RunProducersConsumers(queue, 4, 1, 25000);
+    }
+
+    TEST_CASE("One producer, many consumers")
+    {
+        MpmcQueue<uint64> queue(64);
+        RunProducersConsumers(queue, 1, 4, 100000);
+    }
+
+    TEST_CASE("Many producers, many consumers")
+    {
+        MpmcQueue<uint64> queue(256);
+        RunProducersConsumers(queue, 4, 4, 25000);
+    }
+}
+
+TEST_SUITE("rsbl::WorkStealingDeque")
+{
+    TEST_CASE("Capacity rounds up to a power of two")
+    {
+        WorkStealingDeque<uint32> deque(100);
+        CHECK(deque.Capacity() == 128);
+    }
+
+    TEST_CASE("The owner pops newest first, thieves steal oldest first")
+    {
+        WorkStealingDeque<uint32> deque(8);
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            REQUIRE(deque.TryPush(i));
+        }
+        CHECK(deque.SizeApprox() == 4);
+
+        uint32 value = 0;
+        REQUIRE(deque.TrySteal(value));
+        CHECK(value == 0);
+        REQUIRE(deque.TryPop(value));
+        CHECK(value == 3);
+        REQUIRE(deque.TrySteal(value));
+        CHECK(value == 1);
+        REQUIRE(deque.TryPop(value));
+        CHECK(value == 2);
+
+        CHECK_FALSE(deque.TryPop(value));
+        CHECK_FALSE(deque.TrySteal(value));
+        CHECK(deque.IsEmptyApprox());
+    }
+
+    TEST_CASE("Push fails when full, and wraps around after")
+    {
+        WorkStealingDeque<uint32> deque(4);
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            REQUIRE(deque.TryPush(i));
+        }
+        CHECK_FALSE(deque.TryPush(4));
+
+        uint32 value = 0;
+        for (uint32 lap = 0; lap < 10; ++lap)
+        {
+            REQUIRE(deque.TrySteal(value));
+            CHECK(value == lap);
+            REQUIRE(deque.TryPush(lap + 4));
+        }
+        CHECK(deque.SizeApprox() == 4);
+    }
+
+    TEST_CASE("The owner and the thieves take every value exactly once")
+    {
+        constexpr uint32 kThieves = 3;
+        constexpr uint32 kValues = 100000;
+
+        WorkStealingDeque<uint32> deque(256);
+        std::atomic<bool> done{false};
+
+        // Each thread keeps a list of what it took, one list per thief plus the owner's at the end
+        DynamicArray<DynamicArray<uint32>> taken;
+        taken.Resize(kThieves + 1);
+
+        DynamicArray<UniquePtr<Thread>> thieves;
+        for (uint32 t = 0; t < kThieves; ++t)
+        {
+            DynamicArray<uint32>& mine = taken[t];
+            auto result = Thread::Create([&deque, &mine, &done]() -> Result<> {
+                uint32 value = 0;
+                while (!done.load(std::memory_order_acquire) || !deque.IsEmptyApprox())
+                {
+                    if (deque.TrySteal(value))
+                    {
+                        mine.PushBack(value);
+                    }
+                    else
+                    {
+                        Thread::ThreadYield();
+                    }
+                }
+                return ResultCode::Success;
+            });
+            REQUIRE(result);
+            thieves.PushBack(rsblMove(result.Value()));
+        }
+
+        // Bursts of pushes, then popping some back, so the two ends keep meeting
+        DynamicArray<uint32>& owned = taken[kThieves];
+        uint32 value = 0;
+        for (uint32 next = 0; next < kValues;)
+        {
+            for (uint32 i = 0; i < 7 && next < kValues; ++i)
+            {
+                if (deque.TryPush(next))
+                {
+                    ++next;
+                }
+            }
+            for (uint32 i = 0; i < 5; ++i)
+            {
+                if (deque.TryPop(value))
+                {
+                    owned.PushBack(value);
+                }
+            }
+        }
+        while (deque.TryPop(value))
+        {
+            owned.PushBack(value);
+        }
+        done.store(true, std::memory_order_release);
+
+        for (UniquePtr<Thread>& thread : thieves)
+        {
+            CHECK(thread->Join());
+        }
+
+        DynamicArray<uint32> counts;
+        counts.Resize(kValues);
+        for (const DynamicArray<uint32>& list : taken)
+        {
+            for (const uint32 taken_value : list)
+            {
+                counts[taken_value]++;
+            }
+        }
+        uint32 wrong = 0;
+        for (const uint32 count : counts)
+        {
+            wrong += count != 1 ? 1 : 0;
+        }
+        CHECK(wrong == 0);
+    }
+}
@@ -0,0 +1,40 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+
+// What each platform reads from its OS, before rsbl-cpu-topology.cpp numbers the groups densely
+
+namespace rsbl::Internal
+{
+
+struct RawLogicalProcessor
+{
+    uint32 id = 0;
+
+    // Any value that's equal for processors in the same group and differs between groups
+    uint32 coreKey = 0;
+    uint32 l2Key = 0;
+    uint32 l3Key = 0;
+    uint32 numaNode = 0;
+
+    uint8 efficiencyClass = 0;
+};
+
+struct RawCpuTopology
+{
+    // Sorted by id
+    DynamicArray<RawLogicalProcessor> logical;
+
+    uint64 l2Bytes = 0;
+    uint64 l3Bytes = 0;
+    uint32 cacheLineBytes = 64;
+};
+
+// False when the OS won't say, raw is left empty then
+bool QueryCpuTopology(RawCpuTopology& raw);
+
+} // namespace rsbl::Internal
@@ -0,0 +1,103 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-cpu-topology.h"
+
+#include "rsbl-cpu-topology-internal.h"
+#include "include/rsbl-thread.h"
+
+#include <rsbl-memory-tracking.h>
+
+namespace rsbl
+{
+
+namespace
+{
+// Dense index for key, in order of first appearance. Group counts are small, a scan is fine.
+uint32 DenseIndex(DynamicArray<uint32>& keys, uint32 key)
+{
+    for (uint64 i = 0; i < keys.Size(); ++i)
+    {
+        if (keys[i] == key)
+        {
+            return static_cast<uint32>(i);
+        }
+    }
+    keys.PushBack(key);
+    return static_cast<uint32>(keys.Size() - 1);
+}
+
+// Every logical processor its own core, sharing one cache group and node
+void FillFlat(Internal::RawCpuTopology& raw)
+{
+    const uint32 count = Thread::GetHardwareThreadCount();
+    raw.logical.Clear();
+    raw.logical.Reserve(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Internal::RawLogicalProcessor processor;
+        processor.id = i;
+        processor.coreKey = i;
+        processor.l2Key = i;
+        raw.logical.PushBack(processor);
+    }
+}
+
+CpuTopology BuildTopology()
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    Internal::RawCpuTopology raw;
+    if (!Internal::QueryCpuTopology(raw) || raw.logical.IsEmpty())
+    {
+        FillFlat(raw);
+    }
+
+    CpuTopology topology;
+    topology.l2Bytes = raw.l2Bytes;
+    topology.l3Bytes = raw.l3Bytes;
+    topology.cacheLineBytes = raw.cacheLineBytes;
+
+    DynamicArray<uint32> core_keys;
+    DynamicArray<uint32> l2_keys;
+    DynamicArray<uint32> l3_keys;
+    DynamicArray<uint32> numa_keys;
+    topology.logical.Reserve(raw.logical.Size());
+    for (const Internal::RawLogicalProcessor& source : raw.logical)
+    {
+        LogicalProcessor processor;
+        processor.id = source.id;
+        processor.core = DenseIndex(core_keys, source.coreKey);
+        processor.l2Group = DenseIndex(l2_keys, source.l2Key);
+        processor.l3Group = DenseIndex(l3_keys, source.l3Key);
+        processor.numaNode = DenseIndex(numa_keys, source.numaNode);
+        topology.logical.PushBack(processor);
+
+        if (processor.core == topology.cores.Size())
+        {
+            PhysicalCore core;
+            core.firstLogicalId = source.id;
+            core.efficiencyClass = source.efficiencyClass;
+            topology.cores.PushBack(core);
+        }
+        topology.cores[processor.core].logicalCount++;
+        if (source.efficiencyClass > topology.maxEfficiencyClass)
+        {
+            topology.maxEfficiencyClass = source.efficiencyClass;
+        }
+    }
+    topology.l2GroupCount = static_cast<uint32>(l2_keys.Size());
+    topology.l3GroupCount = static_cast<uint32>(l3_keys.Size());
+    topology.numaNodeCount = static_cast<uint32>(numa_keys.Size());
+    topology.numaNodeIds = rsblMove(numa_keys);
+    return topology;
+}
+} // namespace
+
+const CpuTopology& GetCpuTopology()
+{
+    static const CpuTopology s_topology = BuildTopology();
+    return s_topology;
+}
+
+} // namespace rsbl
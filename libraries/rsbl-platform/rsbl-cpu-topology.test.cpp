@@ -0,0 +1,63 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-cpu-topology.h"
+#include "include/rsbl-thread.h"
+
+using namespace rsbl;
+
+TEST_SUITE("rsbl::CpuTopology")
+{
+    TEST_CASE("Every logical processor is accounted for")
+    {
+        const CpuTopology& topology = GetCpuTopology();
+        CHECK(topology.logical.Size() == Thread::GetHardwareThreadCount());
+        REQUIRE(!topology.cores.IsEmpty());
+
+        uint32 logical_on_cores = 0;
+        for (const PhysicalCore& core : topology.cores)
+        {
+            CHECK(core.logicalCount > 0);
+            CHECK(core.efficiencyClass <= topology.maxEfficiencyClass);
+            logical_on_cores += core.logicalCount;
+        }
+        CHECK(logical_on_cores == topology.logical.Size());
+        CHECK(topology.PerformanceCoreCount() > 0);
+        CHECK(topology.PerformanceCoreCount() <= topology.cores.Size());
+    }
+
+    TEST_CASE("Group indices are dense and in range")
+    {
+        const CpuTopology& topology = GetCpuTopology();
+        uint32 previous_id = 0;
+        for (uint64 i = 0; i < topology.logical.Size(); ++i)
+        {
+            const LogicalProcessor& processor = topology.logical[i];
+            if (i > 0)
+            {
+                CHECK(processor.id > previous_id);
+            }
+            previous_id = processor.id;
+
+            CHECK(processor.core < topology.cores.Size());
+            CHECK(processor.l2Group < topology.l2GroupCount);
+            CHECK(processor.l3Group < topology.l3GroupCount);
+            CHECK(processor.numaNode < topology.numaNodeCount);
+            CHECK(topology.cores[processor.core].firstLogicalId <= processor.id);
+        }
+
+        // Caches are shared at least as widely as cores
+        CHECK(topology.l2GroupCount <= topology.cores.Size());
+        CHECK(topology.l3GroupCount <= topology.l2GroupCount);
+        CHECK(topology.cacheLineBytes >= 16);
+        CHECK(topology.numaNodeIds.Size() == topology.numaNodeCount);
+    }
+
+    TEST_CASE("The topology is cached")
+    {
+        CHECK(&GetCpuTopology() == &GetCpuTopology());
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-fiber.h"
+
+using namespace rsbl;
+
+namespace
+{
+struct PingPong
+{
+    Fiber* main = nullptr;
+    Fiber* worker = nullptr;
+    uint32 steps = 0;
+};
+
+void PingPongEntry(void* userData)
+{
+    PingPong* game = static_cast<PingPong*>(userData);
+    for (;;)
+    {
+        ++game->steps;
+        game->worker->SwitchTo(*game->main);
+    }
+}
+
+void DeepEntry(void* userData)
+{
+    PingPong* game = static_cast<PingPong*>(userData);
+
+    // Locals live on the fiber's own stack, and survive the switches
+    uint32 values[1024];
+    for (uint32 i = 0; i < 1024; ++i)
+    {
+        values[i] = i * 3;
+    }
+    game->worker->SwitchTo(*game->main);
+
+    uint32 sum = 0;
+    for (uint32 i = 0; i < 1024; ++i)
+    {
+        sum += values[i];
+    }
+    game->steps = sum;
+    game->worker->SwitchTo(*game->main);
+    for (;;)
+    {
+        game->worker->SwitchTo(*game->main);
+    }
+}
+} // namespace
+
+TEST_SUITE("rsbl::Fiber")
+{
+    TEST_CASE("Switching back and forth")
+    {
+        Result<UniquePtr<Fiber>> main = Fiber::FromCurrentThread();
+        REQUIRE(main);
+
+        PingPong game;
+        Result<UniquePtr<Fiber>> worker = Fiber::Create(64 * 1024, PingPongEntry, &game);
+        REQUIRE(worker);
+        game.main = main.Value().Get();
+        game.worker = worker.Value().Get();
+
+        for (uint32 i = 1; i <= 100; ++i)
+        {
+            game.main->SwitchTo(*game.worker);
+            CHECK(game.steps == i);
+        }
+    }
+
+    TEST_CASE("Fiber stacks keep their locals")
+    {
+        Result<UniquePtr<Fiber>> main = Fiber::FromCurrentThread();
+        REQUIRE(main);
+
+        PingPong game;
+        Result<UniquePtr<Fiber>> worker = Fiber::Create(64 * 1024, DeepEntry, &game);
+        REQUIRE(worker);
+        game.main = main.Value().Get();
+        game.worker = worker.Value().Get();
+
+        game.main->SwitchTo(*game.worker);
+        CHECK(game.steps == 0);
+        game.main->SwitchTo(*game.worker);
+        CHECK(game.steps == 3 * (1023 * 1024 / 2));
+    }
+}
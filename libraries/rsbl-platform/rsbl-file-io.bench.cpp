@@ -0,0 +1,473 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Reading a file every way rsbl can, to pick an IO strategy by: ReadFileAt, a mapping copied out
+// of, unbuffered reads, and AsyncIo at queue depths 1 to 128, sequentially and at random offsets,
+// 4 KB to 64 MB at a time, from a cold cache and a warm one. Each case is two results: time per
+// read over whole passes, so GB/s and 1 / IOPS, and every read's own latency, whose percentiles
+// --json writes out. Cold passes drop the file from the OS cache first, so each one reads what
+// the device does. The file is written to the working directory and removed at the end.
+
+#include "include/rsbl-async-io.h"
+#include "include/rsbl-clock.h"
+#include "include/rsbl-file.h"
+
+#include <rsbl-bench.h>
+#include <rsbl-dynamic-array.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kPath = "rsbl-file-io-bench.bin";
+constexpr uint64 kKb = 1024;
+constexpr uint64 kMb = 1024 * 1024;
+constexpr uint64 kFileSize = 256 * kMb;
+// A pass reads this much, or four reads if they're bigger, so small reads add up to a time the
+// clock can resolve and big ones still give a few latencies
+constexpr uint64 kPassBytes = 64 * kMb;
+constexpr uint32 kPasses = 3;
+constexpr uint32 kMaxDepth = 128;
+
+enum class Pattern : uint8
+{
+    Sequential,
+    Random,
+};
+
+enum class Cache : uint8
+{
+    Cold,
+    Warm,
+};
+
+struct Plan
+{
+    uint64 fileSize = kFileSize;
+    uint64 passBytes = kPassBytes;
+    uint32 passes = kPasses;
+};
+
+// A case's reads over all its passes, and how long they took
+struct PassTimes
+{
+    DynamicArray<double> nsPerRead; // One per pass, the pass's time over its reads
+    DynamicArray<double> latencies; // One per read
+};
+
+uint64 NextRandom(uint64& state)
+{
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return state ^ (state >> 29);
+}
+
+double TicksToNs(uint64 ticks)
+{
+    return static_cast<double>(ticks) * 1e9 / static_cast<double>(Clock::TicksPerSecond());
+}
+
+uint64 ReadsPerPass(const Plan& plan, uint64 size)
+{
+    const uint64 reads = plan.passBytes / size;
+    return reads > 4 ? reads : 4;
+}
+
+// Read offsets of a pass, all multiples of size, so unbuffered reads stay aligned
+void MakeOffsets(const Plan& plan, Pattern pattern, uint64 size, DynamicArray<uint64>& offsets)
+{
+    const uint64 slots = plan.fileSize / size;
+    const uint64 reads = ReadsPerPass(plan, size);
+    uint64 state = size;
+    offsets.Clear();
+    for (uint64 i = 0; i < reads; ++i)
+    {
+        const uint64 slot = pattern == Pattern::Sequential ? i % slots : NextRandom(state) % slots;
+        offsets.PushBack(slot * size);
+    }
+}
+
+bool WriteTestFile(uint64 size)
+{
+    auto file = OpenFile(kPath, FileOpenMode::Write);
+    if (!file)
+    {
+        fprintf(stderr, "Failed to create %s: %s\n", kPath, file.FailureText());
+        return false;
+    }
+
+    // Random, so nothing between here and the device can compress it away
+    DynamicArray<uint64> chunk;
+    chunk.Resize(4 * kMb / sizeof(uint64));
+    uint64 state = 1;
+    bool written = true;
+    for (uint64 offset = 0; offset < size && written; offset += 4 * kMb)
+    {
+        for (uint64& word : chunk)
+        {
+            word = NextRandom(state);
+        }
+        written = static_cast<bool>(
+            WriteFile(file.Value(), AsBytes(chunk.Data(), chunk.Size() * sizeof(uint64))));
+    }
+    Result<> closed = CloseFile(file.Value());
+    return written && closed;
+}
+
+// Before a cold pass: nothing of the file in the cache. Before a warm one: all of it.
+bool PrepareCache(Cache cache, uint64 fileSize)
+{
+    Result<> dropped = DropFileCache(kPath);
+    if (!dropped)
+    {
+        fprintf(stderr, "Failed to drop %s from the cache: %s\n", kPath, dropped.FailureText());
+        return false;
+    }
+    if (cache == Cache::Warm)
+    {
+        auto mapped = MapFile(kPath);
+        if (!mapped)
+        {
+            return false;
+        }
+        uint64 sum = 0;
+        const ByteView view = mapped.Value().View();
+        for (uint64 i = 0; i < fileSize; i += 4 * kKb)
+        {
+            sum += view[i];
+        }
+        DoNotOptimize(sum);
+    }
+    return true;
+}
+
+// Times one pass of blocking reads, read(offset, buffer) doing one of them
+template <typename F>
+bool TimeBlockingPass(ArrayView<const uint64> offsets,
+                      MutableByteView buffer,
+                      PassTimes& times,
+                      F&& read)
+{
+    const uint64 start = Clock::NowTicks();
+    for (const uint64 offset : offsets)
+    {
+        const uint64 readStart = Clock::NowTicks();
+        if (!read(offset, buffer))
+        {
+            return false;
+        }
+        times.latencies.PushBack(TicksToNs(Clock::NowTicks() - readStart));
+    }
+    const double passNs = TicksToNs(Clock::NowTicks() - start);
+    times.nsPerRead.PushBack(passNs / static_cast<double>(offsets.Size()));
+    return true;
+}
+
+// A pass through AsyncIo, keeping depth reads in flight, each into its own part of buffer
+bool TimeAsyncPass(AsyncIo& io,
+                   FileHandle file,
+                   uint32 depth,
+                   uint64 size,
+                   ArrayView<const uint64> offsets,
+                   MutableByteView buffer,
+                   PassTimes& times)
+{
+    uint64 submitted[kMaxDepth];
+    uint32 freeSlots[kMaxDepth];
+    uint32 freeCount = depth;
+    for (uint32 i = 0; i < depth; ++i)
+    {
+        freeSlots[i] = i;
+    }
+
+    uint64 next = 0;
+    uint64 done = 0;
+    const uint64 start = Clock::NowTicks();
+    while (done < offsets.Size())
+    {
+        if (freeCount > 0 && next < offsets.Size())
+        {
+            const uint64 now = Clock::NowTicks();
+            while (freeCount > 0 && next < offsets.Size())
+            {
+                const uint32 slot = freeSlots[--freeCount];
+                submitted[slot] = now;
+                io.QueueRead({file, offsets[next++], buffer.Subview(slot * size, size), slot});
+            }
+            if (!io.Submit())
+            {
+                return false;
+            }
+        }
+
+        AsyncIoCompletion completions[kMaxDepth];
+        const uint32 count = io.WaitCompletions(completions, depth);
+        const uint64 now = Clock::NowTicks();
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (!completions[i].succeeded)
+            {
+                return false;
+            }
+            const uint32 slot = static_cast<uint32>(completions[i].userData);
+            times.latencies.PushBack(TicksToNs(now - submitted[slot]));
+            freeSlots[freeCount++] = slot;
+        }
+        done += count;
+    }
+    const double passNs = TicksToNs(Clock::NowTicks() - start);
+    times.nsPerRead.PushBack(passNs / static_cast<double>(offsets.Size()));
+    return true;
+}
+
+void FormatSize(char (&text)[16], uint64 size)
+{
+    if (size >= kMb)
+    {
+        snprintf(text, sizeof(text), "%llu MB", static_cast<unsigned long long>(size / kMb));
+    }
+    else
+    {
+        snprintf(text, sizeof(text), "%llu KB", static_cast<unsigned long long>(size / kKb));
+    }
+}
+
+void RecordCase(Bench& bench, const char* name, uint64 size, PassTimes& times)
+{
+    char latencyName[96];
+    snprintf(latencyName, sizeof(latencyName), "%s latency", name);
+    bench.Record(name, {.bytes = size, .items = 1}, times.nsPerRead);
+    bench.Record(latencyName, {}, times.latencies);
+}
+
+enum class Method : uint8
+{
+    ReadFileAt,
+    Mapped,
+    Unbuffered,
+};
+
+const char* MethodName(Method method)
+{
+    switch (method)
+    {
+    case Method::Mapped:
+        return "MapFile";
+    case Method::Unbuffered:
+        return "ReadFileAt unbuffered";
+    default:
+        return "ReadFileAt";
+    }
+}
+
+void BlockingCase(
+    Bench& bench, const Plan& plan, Method method, Pattern pattern, Cache cache, uint64 size)
+{
+    char sizeText[16];
+    FormatSize(sizeText, size);
+    char name[96];
+    snprintf(name,
+             sizeof(name),
+             "%s %s %s",
+             MethodName(method),
+             sizeText,
+             pattern == Pattern::Sequential ? "sequential" : "random");
+    if (!bench.Selected(name))
+    {
+        return;
+    }
+
+    DynamicArray<uint64> offsets;
+    MakeOffsets(plan, pattern, size, offsets);
+    DynamicArray<uint8> buffer(GetSectorAlignedAllocator());
+    buffer.Resize(size);
+    const MutableByteView target(buffer.Data(), size);
+
+    PassTimes times;
+    for (uint32 pass = 0; pass < plan.passes; ++pass)
+    {
+        if (!PrepareCache(cache, plan.fileSize))
+        {
+            return;
+        }
+
+        bool ok = false;
+        if (method == Method::Mapped)
+        {
+            // Mapped after the cache is prepared: pages something has mapped can't be dropped
+            auto mapped = MapFile(kPath);
+            if (!mapped)
+            {
+                return;
+            }
+            const ByteView view = mapped.Value().View();
+            ok = TimeBlockingPass(offsets, target, times, [&](uint64 offset, MutableByteView to) {
+                memcpy(to.Data(), view.Data() + offset, to.Size());
+                DoNotOptimize(to.Data());
+                return true;
+            });
+        }
+        else
+        {
+            const FileOpenFlags flags = method == Method::Unbuffered
+                                            ? FileOpenFlags::Unbuffered
+                                            : FileOpenFlags::None;
+            auto file = OpenFile(kPath, FileOpenMode::Read, flags);
+            if (!file)
+            {
+                return;
+            }
+            ok = TimeBlockingPass(offsets, target, times, [&](uint64 offset, MutableByteView to) {
+                auto read = ReadFileAt(file.Value(), to, offset);
+                return read && read.Value() == to.Size();
+            });
+            Result<> closed = CloseFile(file.Value());
+            rsblUnused(closed);
+        }
+        if (!ok)
+        {
+            fprintf(stderr, "%s: a read failed\n", name);
+            return;
+        }
+    }
+    RecordCase(bench, name, size, times);
+}
+
+void AsyncCase(Bench& bench,
+               const Plan& plan,
+               AsyncIo& io,
+               uint32 depth,
+               Pattern pattern,
+               Cache cache,
+               uint64 size)
+{
+    char sizeText[16];
+    FormatSize(sizeText, size);
+    char name[96];
+    snprintf(name,
+             sizeof(name),
+             "AsyncIo depth %u %s %s",
+             depth,
+             sizeText,
+             pattern == Pattern::Sequential ? "sequential" : "random");
+    if (!bench.Selected(name))
+    {
+        return;
+    }
+
+    DynamicArray<uint64> offsets;
+    MakeOffsets(plan, pattern, size, offsets);
+    DynamicArray<uint8> buffer(GetSectorAlignedAllocator());
+    buffer.Resize(size * depth);
+    const MutableByteView target(buffer.Data(), buffer.Size());
+
+    PassTimes times;
+    for (uint32 pass = 0; pass < plan.passes; ++pass)
+    {
+        if (!PrepareCache(cache, plan.fileSize))
+        {
+            return;
+        }
+        auto file = io.OpenForRead(kPath);
+        if (!file)
+        {
+            return;
+        }
+        const bool ok = TimeAsyncPass(io, file.Value(), depth, size, offsets, target, times);
+        Result<> closed = CloseFile(file.Value());
+        rsblUnused(closed);
+        if (!ok)
+        {
+            fprintf(stderr, "%s: a read failed\n", name);
+            return;
+        }
+    }
+    RecordCase(bench, name, size, times);
+}
+
+void CacheSuite(Bench& bench, const Plan& plan, AsyncIo* io, Cache cache)
+{
+    bench.Section(cache == Cache::Cold ? "Cold cache" : "Warm cache");
+    const uint64 sizes[] = {4 * kKb, 64 * kKb, kMb, 64 * kMb};
+    for (const Pattern pattern : {Pattern::Sequential, Pattern::Random})
+    {
+        for (const uint64 size : sizes)
+        {
+            BlockingCase(bench, plan, Method::ReadFileAt, pattern, cache, size);
+            BlockingCase(bench, plan, Method::Mapped, pattern, cache, size);
+        }
+    }
+
+    // Small reads are where queue depth matters, big ones already keep the device busy
+    if (io == nullptr)
+    {
+        return;
+    }
+    for (const Pattern pattern : {Pattern::Sequential, Pattern::Random})
+    {
+        for (const uint64 size : {4 * kKb, 64 * kKb})
+        {
+            for (uint32 depth = 1; depth <= kMaxDepth; depth *= 2)
+            {
+                AsyncCase(bench, plan, *io, depth, pattern, cache, size);
+            }
+        }
+    }
+}
+
+// Unbuffered reads skip the cache, so cold and warm are the same to them
+void UnbufferedSuite(Bench& bench, const Plan& plan)
+{
+    bench.Section("Unbuffered");
+    for (const Pattern pattern : {Pattern::Sequential, Pattern::Random})
+    {
+        for (const uint64 size : {4 * kKb, 64 * kKb, kMb, 64 * kMb})
+        {
+            BlockingCase(bench, plan, Method::Unbuffered, pattern, Cache::Cold, size);
+        }
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Bench bench("rsbl-file-io", argc, argv);
+    bench.SetKind("io");
+
+    // A smoke run only checks every path still works: one short pass each over a file just big
+    // enough for the biggest read
+    Plan plan;
+    if (bench.Smoke())
+    {
+        plan.fileSize = 64 * kMb;
+        plan.passBytes = 256 * kKb;
+        plan.passes = 1;
+    }
+    if (!WriteTestFile(plan.fileSize))
+    {
+        return 1;
+    }
+
+    AsyncIoOptions options;
+    options.queueDepth = kMaxDepth;
+    auto io = AsyncIo::Create(options);
+    if (io)
+    {
+        printf("AsyncIo backend: %s\n", AsyncIoBackendName(io.Value()->Backend()));
+    }
+    else
+    {
+        fprintf(stderr, "AsyncIo::Create failed, skipping it: %s\n", io.FailureText());
+    }
+    AsyncIo* asyncIo = io ? io.Value().Get() : nullptr;
+
+    CacheSuite(bench, plan, asyncIo, Cache::Cold);
+    CacheSuite(bench, plan, asyncIo, Cache::Warm);
+    UnbufferedSuite(bench, plan);
+
+    Result<> removed = RemoveFile(kPath);
+    rsblUnused(removed);
+    return bench.Finish();
+}
@@ -0,0 +1,56 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+#include <rsbl-string.h>
+
+// What each platform reads from its OS, before rsbl-file-watcher.cpp coalesces and debounces it
+
+namespace rsbl::Internal
+{
+
+enum class RawFileEvent : uint8
+{
+    Added,
+    Modified,
+    Removed,
+    Overflow,
+};
+
+// For Wait, blocks until there are events or Stop is called
+constexpr uint32 kWaitForever = ~0u;
+
+// One watched directory tree's OS handles
+class FileWatchSource
+{
+  public:
+    static Result<UniquePtr<FileWatchSource>> Open(const char* directory, bool recursive);
+
+    ~FileWatchSource();
+
+    FileWatchSource(FileWatchSource&&) = delete;
+    FileWatchSource& operator=(FileWatchSource&&) = delete;
+    FileWatchSource(const FileWatchSource&) = delete;
+    FileWatchSource& operator=(const FileWatchSource&) = delete;
+
+    // Waits up to timeoutMs for events and passes each one to sink, path relative to the root
+    // with '/' separators. Returns early once anything arrived, and false once Stop was called.
+    bool Wait(uint32 timeoutMs, FunctionRef<void(RawFileEvent, StringView)> sink);
+
+    // Wakes Wait up for good, from any thread
+    void Stop();
+
+  private:
+    struct State;
+
+    FileWatchSource() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl::Internal
@@ -0,0 +1,215 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-file-watcher.h"
+
+#include "include/rsbl-clock.h"
+#include "include/rsbl-thread.h"
+#include "rsbl-file-watcher-internal.h"
+
+#include <rsbl-hash-map.h>
+#include <rsbl-memory-tracking.h>
+
+namespace rsbl
+{
+
+namespace
+{
+// A path whose events cancelled out, added and removed again within one batch
+constexpr uint8 kNoChange = 0xFF;
+
+// Folds the next event for a path into what the batch has for it so far
+uint8 Combine(uint8 previous, Internal::RawFileEvent event)
+{
+    const uint8 added = static_cast<uint8>(FileChangeKind::Added);
+    const uint8 modified = static_cast<uint8>(FileChangeKind::Modified);
+    const uint8 removed = static_cast<uint8>(FileChangeKind::Removed);
+
+    switch (event)
+    {
+    case Internal::RawFileEvent::Added:
+        // Saving through a temporary and renaming it over the original removes, then adds
+        if (previous == removed)
+        {
+            return modified;
+        }
+        return previous == kNoChange ? added : previous;
+    case Internal::RawFileEvent::Modified:
+        if (previous == removed || previous == kNoChange)
+        {
+            return modified;
+        }
+        return previous;
+    case Internal::RawFileEvent::Removed:
+        // Never there as far as the handler knows
+        return previous == added ? kNoChange : removed;
+    case Internal::RawFileEvent::Overflow:
+        break;
+    }
+    return previous;
+}
+} // namespace
+
+struct FileWatcher::State
+{
+    UniquePtr<Internal::FileWatchSource> source;
+    UniquePtr<Thread> thread;
+    FileChangeHandler handler;
+    FileWatcherOptions options;
+
+    // The batch being collected, a kind per path, kNoChange where they cancelled out
+    DynamicArray<String> paths{GetTaggedAllocator(MemoryTag::Platform)};
+    DynamicArray<uint8> kinds{GetTaggedAllocator(MemoryTag::Platform)};
+    HashMap<String, uint32> indices{GetTaggedAllocator(MemoryTag::Platform)};
+    bool overflowed = false;
+
+    uint64 firstEventNs = 0;
+    uint64 lastEventNs = 0;
+
+    bool HasPending() const
+    {
+        return overflowed || !paths.IsEmpty();
+    }
+
+    void Add(Internal::RawFileEvent event, StringView path)
+    {
+        const uint64 now = Clock::NowNs();
+        if (!HasPending())
+        {
+            firstEventNs = now;
+        }
+        lastEventNs = now;
+
+        if (event == Internal::RawFileEvent::Overflow)
+        {
+            overflowed = true;
+            return;
+        }
+
+        String key(path, GetTaggedAllocator(MemoryTag::Platform));
+        if (uint32* index = indices.Find(key))
+        {
+            kinds[*index] = Combine(kinds[*index], event);
+            return;
+        }
+        indices.Insert(key, static_cast<uint32>(paths.Size()));
+        paths.PushBack(rsblMove(key));
+        kinds.PushBack(Combine(kNoChange, event));
+    }
+
+    // Milliseconds until the batch is due, 0 once it is
+    uint32 MsUntilDue() const
+    {
+        const uint64 now = Clock::NowNs();
+        const uint64 quietUntil = lastEventNs + uint64(options.debounceMs) * 1'000'000;
+        const uint64 latest = firstEventNs + uint64(options.maxDelayMs) * 1'000'000;
+        const uint64 due = quietUntil < latest ? quietUntil : latest;
+        if (now >= due)
+        {
+            return 0;
+        }
+        // Rounded up, waking a little late beats spinning on a wait of 0
+        return static_cast<uint32>((due - now + 999'999) / 1'000'000);
+    }
+
+    void Deliver()
+    {
+        MemoryTagScope memory_scope(MemoryTag::Platform);
+
+        DynamicArray<FileChange> changes;
+        changes.Reserve(paths.Size() + (overflowed ? 1 : 0));
+        if (overflowed)
+        {
+            FileChange& rescan = changes.EmplaceBack();
+            rescan.kind = FileChangeKind::Rescan;
+        }
+        for (uint64 i = 0; i < paths.Size(); ++i)
+        {
+            if (kinds[i] != kNoChange)
+            {
+                FileChange& change = changes.EmplaceBack();
+                change.path = rsblMove(paths[i]);
+                change.kind = static_cast<FileChangeKind>(kinds[i]);
+            }
+        }
+
+        paths.Clear();
+        kinds.Clear();
+        indices.Clear();
+        overflowed = false;
+
+        if (!changes.IsEmpty())
+        {
+            handler(rsblMove(changes));
+        }
+    }
+
+    Result<> ThreadMain()
+    {
+        auto sink = [this](Internal::RawFileEvent event, StringView path) { Add(event, path); };
+        for (;;)
+        {
+            const uint32 timeout = HasPending() ? MsUntilDue() : Internal::kWaitForever;
+            if (!source->Wait(timeout, sink))
+            {
+                return ResultCode::Success;
+            }
+            if (HasPending() && MsUntilDue() == 0)
+            {
+                Deliver();
+            }
+        }
+    }
+};
+
+Result<UniquePtr<FileWatcher>> FileWatcher::Create(const char* directory,
+                                                   FileChangeHandler&& handler,
+                                                   const FileWatcherOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    Result<UniquePtr<Internal::FileWatchSource>> source =
+        Internal::FileWatchSource::Open(directory, options.recursive);
+    if (!source)
+    {
+        return PendingFailure{source.Category()};
+    }
+
+    UniquePtr<FileWatcher> watcher(new FileWatcher());
+    watcher->m_state = new State();
+
+    State* state = watcher->m_state;
+    state->source = rsblMove(source.Value());
+    state->handler = rsblMove(handler);
+    state->options = options;
+
+    ThreadCreateInfo info;
+    info.name = "rsbl-file-watch";
+    Result<UniquePtr<Thread>> thread =
+        Thread::Create(info, [state]() -> Result<> { return state->ThreadMain(); });
+    if (!thread)
+    {
+        return thread.FailureText();
+    }
+    state->thread = rsblMove(thread.Value());
+
+    return rsblMove(watcher);
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+
+    if (m_state->thread)
+    {
+        m_state->source->Stop();
+        const Result<> joined = m_state->thread->Join();
+        rsblAssert(joined);
+    }
+    delete m_state;
+}
+
+} // namespace rsbl
@@ -0,0 +1,221 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-file-watcher.h"
+#include "include/rsbl-sync.h"
+#include "include/rsbl-thread.h"
+
+#include <cstdio>
+#include <filesystem>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr const char* kTestDir = "rsbl-file-watcher-test";
+
+// Batches as the watcher delivered them
+struct Collector
+{
+    Mutex mutex;
+    DynamicArray<DynamicArray<FileChange>> batches;
+
+    FileChangeHandler Handler()
+    {
+        return [this](DynamicArray<FileChange>&& changes) {
+            LockGuard lock(mutex);
+            batches.PushBack(rsblMove(changes));
+        };
+    }
+
+    // Every change delivered so far, in order
+    DynamicArray<FileChange> All()
+    {
+        LockGuard lock(mutex);
+        DynamicArray<FileChange> all;
+        for (const DynamicArray<FileChange>& batch : batches)
+        {
+            for (const FileChange& change : batch)
+            {
+                all.PushBack(change);
+            }
+        }
+        return all;
+    }
+
+    // Waits for a change to path, up to a few seconds
+    bool WaitFor(StringView path)
+    {
+        for (uint32 i = 0; i < 500; ++i)
+        {
+            for (const FileChange& change : All())
+            {
+                if (change.path == path)
+                {
+                    return true;
+                }
+            }
+            Thread::ThreadSleep(10);
+        }
+        return false;
+    }
+};
+
+void WriteText(const std::filesystem::path& path, const char* text)
+{
+    FILE* file = std::fopen(path.string().c_str(), "wb");
+    REQUIRE(file != nullptr);
+    std::fputs(text, file);
+    std::fclose(file);
+}
+
+const FileChange* FindChange(const DynamicArray<FileChange>& changes, StringView path)
+{
+    for (const FileChange& change : changes)
+    {
+        if (change.path == path)
+        {
+            return &change;
+        }
+    }
+    return nullptr;
+}
+
+struct TestDirectory
+{
+    TestDirectory()
+    {
+        std::filesystem::remove_all(kTestDir);
+        std::filesystem::create_directory(kTestDir);
+    }
+
+    ~TestDirectory()
+    {
+        std::filesystem::remove_all(kTestDir);
+    }
+};
+} // namespace
+
+TEST_SUITE("rsbl::FileWatcher")
+{
+    TEST_CASE("Repeated writes come out as one change")
+    {
+        TestDirectory dir;
+        Collector collector;
+        FileWatcherOptions options;
+        options.debounceMs = 50;
+        Result<UniquePtr<FileWatcher>> watcher =
+            FileWatcher::Create(kTestDir, collector.Handler(), options);
+        REQUIRE(watcher);
+
+        const std::filesystem::path path = std::filesystem::path(kTestDir) / "shader.hlsl";
+        for (int i = 0; i < 5; ++i)
+        {
+            WriteText(path, "float4 main() : SV_Target { return 1; }");
+        }
+
+        REQUIRE(collector.WaitFor("shader.hlsl"));
+        DynamicArray<FileChange> all = collector.All();
+        CHECK(all.Size() == 1);
+        CHECK(all[0].kind == FileChangeKind::Added);
+    }
+
+    TEST_CASE("Modified and removed files")
+    {
+        TestDirectory dir;
+        const std::filesystem::path path = std::filesystem::path(kTestDir) / "mesh.bin";
+        WriteText(path, "old");
+
+        Collector collector;
+        FileWatcherOptions options;
+        options.debounceMs = 50;
+        Result<UniquePtr<FileWatcher>> watcher =
+            FileWatcher::Create(kTestDir, collector.Handler(), options);
+        REQUIRE(watcher);
+
+        WriteText(path, "new");
+        REQUIRE(collector.WaitFor("mesh.bin"));
+        CHECK(collector.All()[0].kind == FileChangeKind::Modified);
+
+        std::filesystem::remove(path);
+        for (uint32 i = 0; i < 500 && collector.All().Size() < 2; ++i)
+        {
+            Thread::ThreadSleep(10);
+        }
+        DynamicArray<FileChange> all = collector.All();
+        REQUIRE(all.Size() == 2);
+        CHECK(all[1].path == "mesh.bin");
+        CHECK(all[1].kind == FileChangeKind::Removed);
+    }
+
+    TEST_CASE("A file added and removed within a batch isn't reported")
+    {
+        TestDirectory dir;
+        Collector collector;
+        FileWatcherOptions options;
+        options.debounceMs = 200;
+        Result<UniquePtr<FileWatcher>> watcher =
+            FileWatcher::Create(kTestDir, collector.Handler(), options);
+        REQUIRE(watcher);
+
+        const std::filesystem::path temp = std::filesystem::path(kTestDir) / "temp.tmp";
+        WriteText(temp, "scratch");
+        std::filesystem::remove(temp);
+        WriteText(std::filesystem::path(kTestDir) / "marker.txt", "done");
+
+        REQUIRE(collector.WaitFor("marker.txt"));
+        CHECK(FindChange(collector.All(), "temp.tmp") == nullptr);
+    }
+
+    TEST_CASE("Subdirectories created after the watch started")
+    {
+        TestDirectory dir;
+        Collector collector;
+        FileWatcherOptions options;
+        options.debounceMs = 50;
+        Result<UniquePtr<FileWatcher>> watcher =
+            FileWatcher::Create(kTestDir, collector.Handler(), options);
+        REQUIRE(watcher);
+
+        const std::filesystem::path sub = std::filesystem::path(kTestDir) / "textures" / "rock";
+        std::filesystem::create_directories(sub);
+        WriteText(sub / "albedo.png", "png");
+
+        REQUIRE(collector.WaitFor("textures/rock/albedo.png"));
+        const FileChange* change = FindChange(collector.All(), "textures/rock/albedo.png");
+        REQUIRE(change != nullptr);
+        CHECK(change->kind == FileChangeKind::Added);
+    }
+
+    TEST_CASE("Non-recursive watches skip subdirectories")
+    {
+        TestDirectory dir;
+        std::filesystem::create_directory(std::filesystem::path(kTestDir) / "sub");
+
+        Collector collector;
+        FileWatcherOptions options;
+        options.debounceMs = 50;
+        options.recursive = false;
+        Result<UniquePtr<FileWatcher>> watcher =
+            FileWatcher::Create(kTestDir, collector.Handler(), options);
+        REQUIRE(watcher);
+
+        WriteText(std::filesystem::path(kTestDir) / "sub" / "ignored.txt", "x");
+        WriteText(std::filesystem::path(kTestDir) / "seen.txt", "x");
+
+        REQUIRE(collector.WaitFor("seen.txt"));
+        CHECK(FindChange(collector.All(), "sub/ignored.txt") == nullptr);
+    }
+
+    TEST_CASE("Missing directories fail")
+    {
+        Collector collector;
+        Result<UniquePtr<FileWatcher>> watcher =
+            FileWatcher::Create("rsbl-file-watcher-missing", collector.Handler());
+        CHECK(!watcher);
+        CHECK(watcher.Category() == ErrorCategory::NotFound);
+    }
+}
@@ -0,0 +1,50 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-file.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-memory-tracking.h>
+
+namespace rsbl
+{
+
+namespace
+{
+// Rounds every request up the same way on Allocate and Free, so the backing allocator sees
+// matching sizes
+class SectorAlignedAllocator : public Allocator
+{
+  public:
+    explicit SectorAlignedAllocator(Allocator* backing)
+        : m_backing(backing)
+    {
+    }
+
+    void* Allocate(uint64 size, uint64 alignment) override
+    {
+        return m_backing->Allocate(AlignUp(size, kDirectIoAlignment), Alignment(alignment));
+    }
+
+    void Free(void* ptr, uint64 size, uint64 alignment) override
+    {
+        m_backing->Free(ptr, AlignUp(size, kDirectIoAlignment), Alignment(alignment));
+    }
+
+  private:
+    static uint64 Alignment(uint64 alignment)
+    {
+        return alignment > kDirectIoAlignment ? alignment : kDirectIoAlignment;
+    }
+
+    Allocator* m_backing;
+};
+} // namespace
+
+Allocator* GetSectorAlignedAllocator()
+{
+    static SectorAlignedAllocator s_allocator(GetTaggedAllocator(MemoryTag::Platform));
+    return &s_allocator;
+}
+
+} // namespace rsbl
@@ -0,0 +1,581 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-file.h"
+#include "include/rsbl-thread.h"
+
+#include <rsbl-dynamic-array.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+using namespace rsbl;
+
+namespace
+{
+// Relative to wherever the test runs, removed again by each case
+constexpr const char* kTestPath = "rsbl-file-test.bin";
+} // namespace
+
+TEST_SUITE("rsbl::File")
+{
+    TEST_CASE("Write then read back")
+    {
+        const char text[] = "The quick brown fox";
+        {
+            Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Write);
+            REQUIRE(file);
+            Result<uint64> written =
+                WriteFile(file.Value(), AsBytes(text, sizeof(text)));
+            REQUIRE(written);
+            CHECK(written.Value() == sizeof(text));
+            CHECK(CloseFile(file.Value()));
+        }
+
+        char buffer[64] = {};
+        Result<uint64> read = OpenAndReadFile(kTestPath, AsWritableBytes(buffer, sizeof(buffer)));
+        REQUIRE(read);
+        CHECK(read.Value() == sizeof(text));
+        CHECK(std::strcmp(buffer, text) == 0);
+
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Reading at an offset")
+    {
+        const char text[] = "0123456789";
+        Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::ReadWrite);
+        REQUIRE(file);
+        REQUIRE(WriteFile(file.Value(), AsBytes(text, 10)));
+
+        char buffer[4] = {};
+        Result<uint64> read = ReadFile(file.Value(), AsWritableBytes(buffer, 4), 6);
+        REQUIRE(read);
+        CHECK(read.Value() == 4);
+        CHECK(std::memcmp(buffer, "6789", 4) == 0);
+
+        CHECK(CloseFile(file.Value()));
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Writing at an offset and sizing the file")
+    {
+        Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::ReadWrite);
+        REQUIRE(file);
+
+        // Grown with a hole, then filled in out of order
+        REQUIRE(SetFileSize(file.Value(), 1 << 20));
+        Result<uint64> size = GetFileSize(file.Value());
+        REQUIRE(size);
+        CHECK(size.Value() == 1 << 20);
+
+        Result<uint64> written = WriteFileAt(file.Value(), AsBytes("tail", 4), (1 << 20) - 4);
+        REQUIRE(written);
+        CHECK(written.Value() == 4);
+        REQUIRE(WriteFileAt(file.Value(), AsBytes("middle", 6), 4096));
+
+        char buffer[8] = {};
+        REQUIRE(ReadFileAt(file.Value(), AsWritableBytes(buffer, 8), 4094));
+        CHECK(std::memcmp(buffer, "\0\0middle", 8) == 0);
+        REQUIRE(ReadFileAt(file.Value(), AsWritableBytes(buffer, 4), (1 << 20) - 4));
+        CHECK(std::memcmp(buffer, "tail", 4) == 0);
+
+        // Past the end grows it, and the file position never moved
+        REQUIRE(WriteFileAt(file.Value(), AsBytes("more", 4), 1 << 20));
+        CHECK(GetFileSize(file.Value()).Value() == (1 << 20) + 4);
+        REQUIRE(WriteFile(file.Value(), AsBytes("head", 4)));
+        REQUIRE(ReadFileAt(file.Value(), AsWritableBytes(buffer, 4), 0));
+        CHECK(std::memcmp(buffer, "head", 4) == 0);
+
+        REQUIRE(SetFileSize(file.Value(), 2));
+        CHECK(GetFileSize(file.Value()).Value() == 2);
+
+        CHECK(CloseFile(file.Value()));
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Positional reads from several threads on one handle")
+    {
+        constexpr uint32 kChunkSize = 4096;
+        constexpr uint32 kChunkCount = 64;
+        DynamicArray<uint8> data;
+        data.Resize(kChunkSize * kChunkCount);
+        for (uint32 i = 0; i < data.Size(); ++i)
+        {
+            data[i] = static_cast<uint8>(i * 13 + (i >> 12));
+        }
+        {
+            Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Write);
+            REQUIRE(file);
+            REQUIRE(WriteFile(file.Value(), AsBytes(data.Data(), data.Size())));
+            CHECK(CloseFile(file.Value()));
+        }
+
+        Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Read);
+        REQUIRE(file);
+        const FileHandle handle = file.Value();
+
+        // Each thread reads every fourth chunk, over and over, in a different order
+        std::atomic<uint32> mismatches{0};
+        DynamicArray<UniquePtr<Thread>> threads;
+        for (uint32 t = 0; t < 4; ++t)
+        {
+            Result<UniquePtr<Thread>> thread =
+                Thread::Create([t, handle, &data, &mismatches]() -> Result<> {
+                    uint8 buffer[kChunkSize];
+                    for (uint32 round = 0; round < 20; ++round)
+                    {
+                        for (uint32 i = 0; i < kChunkCount / 4; ++i)
+                        {
+                            const uint32 chunk = ((i + round) % (kChunkCount / 4)) * 4 + t;
+                            Result<uint64> read = ReadFileAt(handle,
+                                                             MutableByteView(buffer),
+                                                             uint64(chunk) * kChunkSize);
+                            if (!read || read.Value() != kChunkSize ||
+                                std::memcmp(buffer, data.Data() + chunk * kChunkSize, kChunkSize))
+                            {
+                                mismatches.fetch_add(1, std::memory_order_relaxed);
+                            }
+                        }
+                    }
+                    return ResultCode::Success;
+                });
+            REQUIRE(thread);
+            threads.PushBack(rsblMove(thread.Value()));
+        }
+        for (UniquePtr<Thread>& thread : threads)
+        {
+            CHECK(thread->Join());
+        }
+        CHECK(mismatches.load() == 0);
+
+        // Offset 0 is the start of the file, not the file position, and the end comes back short
+        uint8 start[8] = {};
+        Result<uint64> read = ReadFileAt(handle, MutableByteView(start), 0);
+        REQUIRE(read);
+        CHECK(std::memcmp(start, data.Data(), sizeof(start)) == 0);
+        read = ReadFileAt(handle, MutableByteView(start), data.Size() - 3);
+        REQUIRE(read);
+        CHECK(read.Value() == 3);
+
+        CHECK(CloseFile(handle));
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Gathered writes and scattered reads")
+    {
+        const char header[] = "HDR";
+        const char payload[] = "payload bytes";
+        const ByteView parts[] = {
+            AsBytes(header, 3), ByteView(), AsBytes(payload, sizeof(payload))};
+
+        Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::ReadWrite);
+        REQUIRE(file);
+        Result<uint64> written = WriteFileGather(file.Value(), parts);
+        REQUIRE(written);
+        CHECK(written.Value() == 3 + sizeof(payload));
+        CHECK(CloseFile(file.Value()));
+
+        char read_header[3] = {};
+        char read_payload[sizeof(payload)] = {};
+        char past_end[8] = {};
+        const MutableByteView targets[] = {AsWritableBytes(read_header, 3),
+                                           AsWritableBytes(read_payload, sizeof(read_payload)),
+                                           AsWritableBytes(past_end, sizeof(past_end))};
+        file = OpenFile(kTestPath, FileOpenMode::Read);
+        REQUIRE(file);
+        Result<uint64> read = ReadFileScatter(file.Value(), targets);
+        REQUIRE(read);
+        CHECK(read.Value() == 3 + sizeof(payload));
+        CHECK(std::memcmp(read_header, "HDR", 3) == 0);
+        CHECK(std::strcmp(read_payload, payload) == 0);
+        CHECK(CloseFile(file.Value()));
+
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Gathering more buffers than one call takes")
+    {
+        // Past the number of buffers handed to the OS at once, so it picks up mid-list
+        constexpr uint32 kCount = 200;
+        uint8 bytes[kCount];
+        ByteView parts[kCount];
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            bytes[i] = static_cast<uint8>(i);
+            parts[i] = ByteView(&bytes[i], 1);
+        }
+
+        Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Write);
+        REQUIRE(file);
+        Result<uint64> written = WriteFileGather(file.Value(), parts);
+        REQUIRE(written);
+        CHECK(written.Value() == kCount);
+        CHECK(CloseFile(file.Value()));
+
+        uint8 read_back[kCount] = {};
+        MutableByteView targets[kCount];
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            targets[i] = MutableByteView(&read_back[kCount - 1 - i], 1);
+        }
+        file = OpenFile(kTestPath, FileOpenMode::Read);
+        REQUIRE(file);
+        Result<uint64> read = ReadFileScatter(file.Value(), targets);
+        REQUIRE(read);
+        CHECK(read.Value() == kCount);
+        for (uint32 i = 0; i < kCount; ++i)
+        {
+            CHECK(read_back[kCount - 1 - i] == i);
+        }
+        CHECK(CloseFile(file.Value()));
+
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Write truncates, WriteAppend doesn't")
+    {
+        {
+            Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Write);
+            REQUIRE(file);
+            REQUIRE(WriteFile(file.Value(), AsBytes("abcdef", 6)));
+            CHECK(CloseFile(file.Value()));
+        }
+        {
+            // Writes from the start, over what's there
+            Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::WriteAppend);
+            REQUIRE(file);
+            REQUIRE(WriteFile(file.Value(), AsBytes("XY", 2)));
+            CHECK(CloseFile(file.Value()));
+        }
+
+        char buffer[16] = {};
+        Result<uint64> read = OpenAndReadFile(kTestPath, AsWritableBytes(buffer, sizeof(buffer)));
+        REQUIRE(read);
+        CHECK(read.Value() == 6);
+        CHECK(std::memcmp(buffer, "XYcdef", 6) == 0);
+
+        {
+            Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Write);
+            REQUIRE(file);
+            CHECK(CloseFile(file.Value()));
+        }
+        read = OpenAndReadFile(kTestPath, AsWritableBytes(buffer, sizeof(buffer)));
+        REQUIRE(read);
+        CHECK(read.Value() == 0);
+
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Unbuffered reads and writes")
+    {
+        Allocator* allocator = GetSectorAlignedAllocator();
+        constexpr uint64 kSize = 3 * kDirectIoAlignment;
+        uint8* data = static_cast<uint8*>(allocator->Allocate(kSize, 1));
+        uint8* buffer = static_cast<uint8*>(allocator->Allocate(kSize, 1));
+        REQUIRE(data != nullptr);
+        REQUIRE(buffer != nullptr);
+        CHECK(reinterpret_cast<uintptr_t>(data) % kDirectIoAlignment == 0);
+        CHECK(reinterpret_cast<uintptr_t>(buffer) % kDirectIoAlignment == 0);
+        for (uint64 i = 0; i < kSize; ++i)
+        {
+            data[i] = static_cast<uint8>(i * 13);
+        }
+
+        {
+            Result<FileHandle> file =
+                OpenFile(kTestPath, FileOpenMode::Write, FileOpenFlags::Unbuffered);
+            REQUIRE(file);
+            Result<uint64> written = WriteFile(file.Value(), ByteView(data, kSize));
+            REQUIRE(written);
+            CHECK(written.Value() == kSize);
+            CHECK(CloseFile(file.Value()));
+        }
+
+        const FileOpenFlags flags = FileOpenFlags::Unbuffered | FileOpenFlags::SequentialScan;
+        Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Read, flags);
+        REQUIRE(file);
+        Result<uint64> read = ReadFileAt(file.Value(), MutableByteView(buffer, kSize), 0);
+        REQUIRE(read);
+        CHECK(read.Value() == kSize);
+        CHECK(std::memcmp(buffer, data, kSize) == 0);
+
+        // A sector aligned read past the end comes back short
+        read = ReadFileAt(file.Value(), MutableByteView(buffer, kSize), 2 * kDirectIoAlignment);
+        REQUIRE(read);
+        CHECK(read.Value() == kDirectIoAlignment);
+        CHECK(CloseFile(file.Value()));
+
+        allocator->Free(data, kSize, 1);
+        allocator->Free(buffer, kSize, 1);
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Open hints don't change what's read")
+    {
+        const char text[] = "hinted";
+        {
+            Result<FileHandle> file =
+                OpenFile(kTestPath, FileOpenMode::Write, FileOpenFlags::SequentialScan);
+            REQUIRE(file);
+            REQUIRE(WriteFile(file.Value(), AsBytes(text, sizeof(text))));
+            CHECK(CloseFile(file.Value()));
+        }
+        Result<FileHandle> file =
+            OpenFile(kTestPath, FileOpenMode::Read, FileOpenFlags::RandomAccess);
+        REQUIRE(file);
+        char buffer[sizeof(text)] = {};
+        Result<uint64> read = ReadFileAt(file.Value(), AsWritableBytes(buffer, sizeof(buffer)), 0);
+        REQUIRE(read);
+        CHECK(std::strcmp(buffer, text) == 0);
+        CHECK(CloseFile(file.Value()));
+
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Sector aligned allocations")
+    {
+        Allocator* allocator = GetSectorAlignedAllocator();
+        void* small = allocator->Allocate(10, 8);
+        void* over_aligned = allocator->Allocate(100, 2 * kDirectIoAlignment);
+        CHECK(reinterpret_cast<uintptr_t>(small) % kDirectIoAlignment == 0);
+        CHECK(reinterpret_cast<uintptr_t>(over_aligned) % (2 * kDirectIoAlignment) == 0);
+
+        // Padded to a whole sector, so all of it can be read into
+        std::memset(small, 0xAB, kDirectIoAlignment);
+
+        allocator->Free(small, 10, 8);
+        allocator->Free(over_aligned, 100, 2 * kDirectIoAlignment);
+    }
+
+    TEST_CASE("File size and info")
+    {
+        const char text[] = "Sized up";
+        Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::ReadWrite);
+        REQUIRE(file);
+        Result<uint64> size = GetFileSize(file.Value());
+        REQUIRE(size);
+        CHECK(size.Value() == 0);
+
+        REQUIRE(WriteFile(file.Value(), AsBytes(text, sizeof(text))));
+        size = GetFileSize(file.Value());
+        REQUIRE(size);
+        CHECK(size.Value() == sizeof(text));
+        CHECK(CloseFile(file.Value()));
+
+        Result<FileInfo> info = GetFileInfo(kTestPath);
+        REQUIRE(info);
+        CHECK(info.Value().size == sizeof(text));
+        CHECK_FALSE(info.Value().isDirectory);
+        // Written just now, so some time after 2020
+        CHECK(info.Value().modifiedTime > 1577836800ll * 1000000000);
+
+        info = GetFileInfo(".");
+        REQUIRE(info);
+        CHECK(info.Value().isDirectory);
+
+        info = GetFileInfo("rsbl-file-test-missing.bin");
+        CHECK_FALSE(info);
+        CHECK(info.Category() == ErrorCategory::NotFound);
+
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Enumerating a directory")
+    {
+        constexpr const char* kDirectory = "rsbl-file-test-dir";
+        constexpr const char* kNested = "rsbl-file-test-dir/nested";
+        constexpr uint32 kFileCount = 700;
+        std::filesystem::remove_all(kDirectory);
+        std::filesystem::create_directory(kDirectory);
+        std::filesystem::create_directory(kNested);
+
+        // Enough entries to take more than one batch from the OS
+        char path[128];
+        for (uint32 i = 0; i < kFileCount; ++i)
+        {
+            std::snprintf(
+                path, sizeof(path), "%s/file-with-a-longish-name-%03u.bin", kDirectory, i);
+            Result<FileHandle> file = OpenFile(path, FileOpenMode::Write);
+            REQUIRE(file);
+            REQUIRE(WriteFile(file.Value(), AsBytes(path, i)));
+            CHECK(CloseFile(file.Value()));
+        }
+
+        Result<UniquePtr<DirectoryIterator>> dir = DirectoryIterator::Open(kDirectory);
+        REQUIRE(dir);
+
+        bool seen[kFileCount] = {};
+        uint32 files = 0;
+        uint32 directories = 0;
+        DirectoryEntry entry;
+        while (dir.Value()->Next(entry))
+        {
+            Result<FileInfo> info = dir.Value()->CurrentInfo();
+            REQUIRE(info);
+            CHECK(info.Value().isDirectory == entry.isDirectory);
+            if (entry.isDirectory)
+            {
+                CHECK(std::strcmp(entry.name, "nested") == 0);
+                ++directories;
+                continue;
+            }
+
+            unsigned index = kFileCount;
+            REQUIRE(std::sscanf(entry.name, "file-with-a-longish-name-%03u.bin", &index) == 1);
+            REQUIRE(index < kFileCount);
+            CHECK_FALSE(seen[index]);
+            seen[index] = true;
+            CHECK(info.Value().size == index);
+            ++files;
+        }
+        CHECK(files == kFileCount);
+        CHECK(directories == 1);
+        CHECK_FALSE(dir.Value()->Next(entry));
+        dir.Value().Reset();
+
+        Result<UniquePtr<DirectoryIterator>> empty = DirectoryIterator::Open(kNested);
+        REQUIRE(empty);
+        CHECK_FALSE(empty.Value()->Next(entry));
+        CHECK_FALSE(empty.Value()->CurrentInfo());
+
+        Result<UniquePtr<DirectoryIterator>> missing =
+            DirectoryIterator::Open("rsbl-file-test-missing");
+        CHECK_FALSE(missing);
+        CHECK(missing.Category() == ErrorCategory::NotFound);
+
+        std::filesystem::remove_all(kDirectory);
+    }
+
+    TEST_CASE("Making directories, renaming and removing files")
+    {
+        constexpr const char* kDirectory = "rsbl-file-test-make";
+        constexpr const char* kNested = "rsbl-file-test-make/a/b/c";
+        constexpr const char* kMoved = "rsbl-file-test-make/a/b/c/moved.bin";
+        std::filesystem::remove_all(kDirectory);
+
+        REQUIRE(MakeDirectory(kNested));
+        CHECK(std::filesystem::is_directory(kNested));
+        // Already there is fine
+        CHECK(MakeDirectory(kNested));
+        CHECK(MakeDirectory("rsbl-file-test-make/a/"));
+
+        const char text[] = "moved";
+        {
+            Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Write);
+            REQUIRE(file);
+            REQUIRE(WriteFile(file.Value(), AsBytes(text, sizeof(text))));
+            CHECK(CloseFile(file.Value()));
+        }
+        // A file in the way isn't a directory
+        CHECK_FALSE(MakeDirectory(kTestPath));
+
+        // Onto a fresh path, then over the top of an existing file
+        REQUIRE(RenameFile(kTestPath, kMoved));
+        CHECK(GetFileInfo(kTestPath).Category() == ErrorCategory::NotFound);
+        {
+            Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Write);
+            REQUIRE(file);
+            REQUIRE(WriteFile(file.Value(), AsBytes("replaced", 9)));
+            CHECK(CloseFile(file.Value()));
+        }
+        REQUIRE(RenameFile(kTestPath, kMoved));
+        char buffer[16] = {};
+        Result<uint64> read = OpenAndReadFile(kMoved, AsWritableBytes(buffer, sizeof(buffer)));
+        REQUIRE(read);
+        CHECK(std::strcmp(buffer, "replaced") == 0);
+
+        // Out of the cache, reads come back the same from the disk
+        REQUIRE(DropFileCache(kMoved));
+        char reread[16] = {};
+        REQUIRE(OpenAndReadFile(kMoved, AsWritableBytes(reread, sizeof(reread))));
+        CHECK(std::strcmp(reread, "replaced") == 0);
+
+        CHECK(RenameFile(kTestPath, kMoved).Category() == ErrorCategory::NotFound);
+        CHECK(RemoveFile(kMoved));
+        CHECK(RemoveFile(kMoved).Category() == ErrorCategory::NotFound);
+
+        std::filesystem::remove_all(kDirectory);
+    }
+
+    TEST_CASE("Missing files")
+    {
+        Result<FileHandle> file = OpenFile("rsbl-file-test-missing.bin", FileOpenMode::Read);
+        CHECK_FALSE(file);
+        CHECK(file.Category() == ErrorCategory::NotFound);
+
+        Result<MappedFile> mapped = MapFile("rsbl-file-test-missing.bin");
+        CHECK_FALSE(mapped);
+        CHECK(mapped.Category() == ErrorCategory::NotFound);
+
+        CHECK(DropFileCache("rsbl-file-test-missing.bin").Category() == ErrorCategory::NotFound);
+    }
+
+    TEST_CASE("Mapping a file")
+    {
+        // Bigger than a page, so prefetching covers more than one
+        uint8 data[10000];
+        for (uint32 i = 0; i < sizeof(data); ++i)
+        {
+            data[i] = static_cast<uint8>(i * 7);
+        }
+        {
+            Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Write);
+            REQUIRE(file);
+            REQUIRE(WriteFile(file.Value(), AsBytes(data, sizeof(data))));
+            CHECK(CloseFile(file.Value()));
+        }
+
+        {
+            Result<MappedFile> mapped = MapFile(kTestPath);
+            REQUIRE(mapped);
+            CHECK(mapped.Value().Size() == sizeof(data));
+            CHECK(mapped.Value().MutableView().Size() == 0);
+
+            mapped.Value().Prefetch();
+            mapped.Value().Prefetch(5000, 100);
+            mapped.Value().Prefetch(sizeof(data) + 1);
+
+            // Moving hands the mapping over, only the last owner unmaps
+            MappedFile moved = rsblMove(mapped.Value());
+            CHECK(mapped.Value().Size() == 0);
+            CHECK(std::memcmp(moved.View().Data(), data, sizeof(data)) == 0);
+        }
+
+        // Writes through a writable mapping end up in the file
+        {
+            Result<MappedFile> mapped = MapFile(kTestPath, FileMapAccess::ReadWrite);
+            REQUIRE(mapped);
+            MutableByteView view = mapped.Value().MutableView();
+            REQUIRE(view.Size() == sizeof(data));
+            std::memcpy(view.Data(), "mapped", 6);
+            CHECK(mapped.Value().Flush());
+        }
+        char buffer[6] = {};
+        REQUIRE(OpenAndReadFile(kTestPath, AsWritableBytes(buffer, sizeof(buffer))));
+        CHECK(std::memcmp(buffer, "mapped", 6) == 0);
+
+        std::remove(kTestPath);
+    }
+
+    TEST_CASE("Mapping an empty file")
+    {
+        {
+            Result<FileHandle> file = OpenFile(kTestPath, FileOpenMode::Write);
+            REQUIRE(file);
+            CHECK(CloseFile(file.Value()));
+        }
+        Result<MappedFile> mapped = MapFile(kTestPath);
+        REQUIRE(mapped);
+        CHECK(mapped.Value().Size() == 0);
+        CHECK(mapped.Value().View().Size() == 0);
+        mapped.Value().Unmap();
+
+        std::remove(kTestPath);
+    }
+}
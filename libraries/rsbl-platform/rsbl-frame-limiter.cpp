@@ -0,0 +1,103 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-frame-limiter.h"
+
+#include "include/rsbl-clock.h"
+#include "include/rsbl-thread.h"
+
+#include <rsbl-profile.h>
+
+namespace rsbl
+{
+
+namespace
+{
+// Spun on top of the worst overshoot, for the wake itself and what it varies by
+constexpr uint64 kSpinSlackNs = 50'000;
+
+// How fast the worst overshoot is forgotten, a sixteenth of it a frame
+constexpr uint64 kOvershootDecayShift = 4;
+} // namespace
+
+Result<UniquePtr<FrameLimiter>> FrameLimiter::Create(double framesPerSecond)
+{
+    UniquePtr<FrameLimiter> limiter(new FrameLimiter());
+    if (auto created = limiter->CreatePlatformTimer(); !created)
+    {
+        return created.FailureText();
+    }
+    limiter->m_spinNs = limiter->m_minSpinNs;
+    limiter->SetFrameRate(framesPerSecond);
+    return rsblMove(limiter);
+}
+
+FrameLimiter::~FrameLimiter()
+{
+    DestroyPlatformTimer();
+}
+
+void FrameLimiter::SetFrameRate(double framesPerSecond)
+{
+    m_framesPerSecond = framesPerSecond > 0.0 ? framesPerSecond : 0.0;
+    m_periodTicks =
+        m_framesPerSecond > 0.0
+            ? static_cast<uint64>(static_cast<double>(Clock::TicksPerSecond()) / m_framesPerSecond +
+                                  0.5)
+            : 0;
+    // The grid starts over at the new rate
+    m_dueTicks = 0;
+}
+
+uint64 FrameLimiter::WaitForNextFrame()
+{
+    const uint64 start = Clock::NowTicks();
+    if (m_periodTicks == 0)
+    {
+        return 0;
+    }
+
+    if (m_dueTicks == 0 || start >= m_dueTicks + m_periodTicks)
+    {
+        // The first frame, or one a whole frame late, which the grid starts over from
+        m_dueTicks = start + m_periodTicks;
+        return 0;
+    }
+    const uint64 due = m_dueTicks;
+    m_dueTicks += m_periodTicks;
+    if (start >= due)
+    {
+        // Late, but the next is still due on time
+        return 0;
+    }
+
+    RSBL_PROFILE_ZONE("FrameLimiter::WaitForNextFrame");
+
+    const uint64 remaining_ns = Clock::TicksToNs(due - start);
+    if (remaining_ns > m_spinNs)
+    {
+        const uint64 sleep_ns = remaining_ns - m_spinNs;
+        SleepFor(sleep_ns);
+
+        const uint64 slept_ns = Clock::TicksToNs(Clock::NowTicks() - start);
+        const uint64 overshoot_ns = slept_ns > sleep_ns ? slept_ns - sleep_ns : 0;
+        const uint64 decayed_ns = m_overshootNs - (m_overshootNs >> kOvershootDecayShift);
+        m_overshootNs = overshoot_ns > decayed_ns ? overshoot_ns : decayed_ns;
+
+        // Never so much of the frame that the spinning is most of it
+        const uint64 max_spin_ns = Clock::TicksToNs(m_periodTicks) / 2;
+        const uint64 spin_ns = m_overshootNs + kSpinSlackNs;
+        m_spinNs = spin_ns < m_minSpinNs ? m_minSpinNs : spin_ns;
+        m_spinNs = m_spinNs > max_spin_ns ? max_spin_ns : m_spinNs;
+    }
+
+    uint64 now = Clock::NowTicks();
+    while (now < due)
+    {
+        Thread::SpinPause();
+        now = Clock::NowTicks();
+    }
+    return now - start;
+}
+
+} // namespace rsbl
@@ -0,0 +1,83 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-clock.h"
+#include "include/rsbl-frame-limiter.h"
+#include "include/rsbl-thread.h"
+
+using namespace rsbl;
+
+TEST_SUITE("FrameLimiter")
+{
+    TEST_CASE("Unlimited never waits")
+    {
+        auto limiter = FrameLimiter::Create(0.0);
+        REQUIRE(limiter);
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            CHECK(limiter.Value()->WaitForNextFrame() == 0);
+        }
+    }
+
+    TEST_CASE("Frames start a period apart")
+    {
+        constexpr double kFps = 200.0;
+        constexpr uint32 kFrames = 20;
+        auto created = FrameLimiter::Create(kFps);
+        REQUIRE(created);
+        FrameLimiter& limiter = *created.Value();
+
+        const uint64 period_ticks =
+            static_cast<uint64>(static_cast<double>(Clock::TicksPerSecond()) / kFps + 0.5);
+        limiter.WaitForNextFrame();
+        const uint64 first = Clock::NowTicks();
+        for (uint32 i = 1; i < kFrames; ++i)
+        {
+            limiter.WaitForNextFrame();
+        }
+        const uint64 last = Clock::NowTicks();
+
+        // Never early. How late depends on what else the machine is running, so the upper bound
+        // only catches a limiter that's far off.
+        const double elapsed_ms = Clock::TicksToMs(last - first);
+        const double expected_ms = (kFrames - 1) * 1000.0 / kFps;
+        CHECK(elapsed_ms >= expected_ms - 0.05);
+        CHECK(elapsed_ms < expected_ms * 4);
+        // The spin follows the sleeps, and never takes over the frame
+        CHECK(limiter.SpinNs() <= Clock::TicksToNs(period_ticks) / 2);
+    }
+
+    TEST_CASE("A frame a whole period late starts the grid over")
+    {
+        auto created = FrameLimiter::Create(100.0);
+        REQUIRE(created);
+        FrameLimiter& limiter = *created.Value();
+
+        limiter.WaitForNextFrame();
+        Thread::ThreadSleep(35);
+        // Starts again from here instead of three frames back to back, so the frame after is a
+        // whole period on
+        const uint64 late = Clock::NowTicks();
+        CHECK(limiter.WaitForNextFrame() == 0);
+        limiter.WaitForNextFrame();
+        CHECK(Clock::TicksToMs(Clock::NowTicks() - late) >= 10.0 - 0.05);
+    }
+
+    TEST_CASE("Changing the rate takes effect on the next frame")
+    {
+        auto created = FrameLimiter::Create(1000.0);
+        REQUIRE(created);
+        FrameLimiter& limiter = *created.Value();
+        limiter.WaitForNextFrame();
+        limiter.SetFrameRate(50.0);
+        CHECK(limiter.FrameRate() == 50.0);
+        // The grid starts over, then the next frame is 20ms on
+        const uint64 changed = Clock::NowTicks();
+        CHECK(limiter.WaitForNextFrame() == 0);
+        limiter.WaitForNextFrame();
+        CHECK(Clock::TicksToMs(Clock::NowTicks() - changed) >= 20.0 - 0.05);
+    }
+}
@@ -0,0 +1,33 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "include/rsbl-power.h"
+#include "include/rsbl-sync.h"
+
+#include <atomic>
+
+// What each platform reads from its OS, before rsbl-power.cpp watches it for changes
+
+namespace rsbl::Internal
+{
+
+// Everything that can be read on demand
+PowerState ReadPowerState();
+
+// Where the OS only tells the power mode in notifications, they land here
+struct PowerModeSink
+{
+    std::atomic<PowerMode> mode{PowerMode::Unknown};
+    // Set with every notification
+    Event changed{Event::ResetMode::Auto};
+};
+
+// Has the OS notify sink of the power mode, the current one first, until
+// StopPowerModeNotifications. nullptr where ReadPowerState reads the mode itself, or the OS
+// can't notify.
+void* StartPowerModeNotifications(PowerModeSink& sink);
+void StopPowerModeNotifications(void* registration);
+
+} // namespace rsbl::Internal
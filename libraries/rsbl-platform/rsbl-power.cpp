@@ -0,0 +1,126 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-power.h"
+
+#include "include/rsbl-thread.h"
+#include "rsbl-power-internal.h"
+
+#include <rsbl-memory-tracking.h>
+
+namespace rsbl
+{
+
+PowerState QueryPowerState()
+{
+    return Internal::ReadPowerState();
+}
+
+bool IsPowerConstrained(const PowerState& state, uint32 throttledPercent)
+{
+    if (state.source == PowerSource::Battery || state.mode == PowerMode::BatterySaver ||
+        state.mode == PowerMode::BetterBattery)
+    {
+        return true;
+    }
+    return state.cpuSpeedPercent != 0 && state.cpuSpeedPercent < throttledPercent;
+}
+
+struct PowerMonitor::State
+{
+    UniquePtr<Thread> thread;
+    PowerChangeHandler handler;
+    PowerMonitorOptions options;
+
+    // Wakes the thread early for a notified mode, or to stop
+    Internal::PowerModeSink sink;
+    void* registration = nullptr;
+    std::atomic<bool> running{true};
+
+    mutable SpinLock lock;
+    PowerState latest;
+
+    PowerState Read() const
+    {
+        PowerState state = Internal::ReadPowerState();
+        const PowerMode notified = sink.mode.load(std::memory_order_acquire);
+        if (notified != PowerMode::Unknown)
+        {
+            state.mode = notified;
+        }
+        return state;
+    }
+
+    Result<> ThreadMain()
+    {
+        bool first = true;
+        while (running.load(std::memory_order_acquire))
+        {
+            const PowerState state = Read();
+            if (first || state != latest)
+            {
+                {
+                    LockGuard guard(lock);
+                    latest = state;
+                }
+                handler(state);
+                first = false;
+            }
+            sink.changed.WaitTimeout(options.pollMs);
+        }
+        return ResultCode::Success;
+    }
+};
+
+Result<UniquePtr<PowerMonitor>> PowerMonitor::Create(PowerChangeHandler&& handler,
+                                                     const PowerMonitorOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    UniquePtr<PowerMonitor> monitor(new PowerMonitor());
+    monitor->m_state = new State();
+
+    State* state = monitor->m_state;
+    state->handler = rsblMove(handler);
+    state->options = options;
+    state->registration = Internal::StartPowerModeNotifications(state->sink);
+
+    ThreadCreateInfo info;
+    info.name = "rsbl-power";
+    Result<UniquePtr<Thread>> thread =
+        Thread::Create(info, [state]() -> Result<> { return state->ThreadMain(); });
+    if (!thread)
+    {
+        return thread.FailureText();
+    }
+    state->thread = rsblMove(thread.Value());
+
+    return rsblMove(monitor);
+}
+
+PowerMonitor::~PowerMonitor()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+
+    // Notifications stop first, they'd set an event that's about to go
+    Internal::StopPowerModeNotifications(m_state->registration);
+    if (m_state->thread)
+    {
+        m_state->running.store(false, std::memory_order_release);
+        m_state->sink.changed.Set();
+        const Result<> joined = m_state->thread->Join();
+        rsblAssert(joined);
+    }
+    delete m_state;
+}
+
+PowerState PowerMonitor::Latest() const
+{
+    LockGuard guard(m_state->lock);
+    return m_state->latest;
+}
+
+} // namespace rsbl
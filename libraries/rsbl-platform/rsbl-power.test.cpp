@@ -0,0 +1,69 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-power.h"
+#include "include/rsbl-sync.h"
+
+#include <atomic>
+
+using namespace rsbl;
+
+TEST_SUITE("Power")
+{
+    TEST_CASE("What's read is in range")
+    {
+        // Whatever this machine runs on, Unknown included
+        const PowerState state = QueryPowerState();
+        CHECK(state.batteryPercent >= -1);
+        CHECK(state.batteryPercent <= 100);
+        CHECK(state.cpuSpeedPercent <= 100);
+    }
+
+    TEST_CASE("Battery, saving modes and throttling are constrained")
+    {
+        PowerState state;
+        state.source = PowerSource::Mains;
+        state.mode = PowerMode::Balanced;
+        state.cpuSpeedPercent = 100;
+        CHECK_FALSE(IsPowerConstrained(state));
+
+        PowerState battery = state;
+        battery.source = PowerSource::Battery;
+        CHECK(IsPowerConstrained(battery));
+
+        PowerState saver = state;
+        saver.mode = PowerMode::BatterySaver;
+        CHECK(IsPowerConstrained(saver));
+
+        PowerState throttled = state;
+        throttled.cpuSpeedPercent = 60;
+        CHECK(IsPowerConstrained(throttled));
+        CHECK_FALSE(IsPowerConstrained(throttled, 50));
+
+        // Not knowing isn't a reason to hold back
+        CHECK_FALSE(IsPowerConstrained(PowerState{}));
+    }
+
+    TEST_CASE("The monitor reports the state it starts with")
+    {
+        Event reported;
+        std::atomic<uint32> calls{0};
+        auto monitor = PowerMonitor::Create([&](const PowerState&) {
+            calls.fetch_add(1);
+            reported.Set();
+        });
+        REQUIRE(monitor);
+        REQUIRE(reported.WaitTimeout(5000));
+        CHECK(calls.load() >= 1);
+
+        const PowerState latest = monitor.Value()->Latest();
+        CHECK(latest.batteryPercent <= 100);
+        CHECK(latest.cpuSpeedPercent <= 100);
+
+        // Joins without waiting out the poll
+        monitor.Value().Reset();
+    }
+}
@@ -0,0 +1,133 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-socket.h"
+#include "include/rsbl-thread.h"
+
+#include <cstring>
+
+using namespace rsbl;
+
+TEST_SUITE("rsbl::Socket")
+{
+    TEST_CASE("Connecting to a local listener and echoing")
+    {
+        Result<SocketHandle> listener = ListenSocket(0);
+        REQUIRE(listener);
+        Result<uint16> port = GetSocketPort(listener.Value());
+        REQUIRE(port);
+        CHECK(port.Value() != 0);
+
+        // Echoes everything back until the client closes its side
+        Result<UniquePtr<Thread>> server = Thread::Create([&]() -> Result<> {
+            Result<SocketHandle> connection = AcceptSocket(listener.Value());
+            if (!connection)
+            {
+                return PendingFailure{connection.Category()};
+            }
+            uint8 buffer[256];
+            for (;;)
+            {
+                Result<uint64> received =
+                    ReceiveSocket(connection.Value(), MutableByteView(buffer, sizeof(buffer)));
+                if (!received || received.Value() == 0)
+                {
+                    break;
+                }
+                (void)SendSocket(connection.Value(), ByteView(buffer, received.Value()));
+            }
+            return CloseSocket(connection.Value());
+        });
+        REQUIRE(server);
+
+        Result<SocketHandle> client = ConnectSocket("127.0.0.1", port.Value());
+        REQUIRE(client);
+
+        // Bigger than one receive, so it comes back in pieces
+        uint8 sent[4096];
+        for (uint32 i = 0; i < sizeof(sent); ++i)
+        {
+            sent[i] = static_cast<uint8>(i * 7);
+        }
+        REQUIRE(SendSocket(client.Value(), ByteView(sent, sizeof(sent))));
+
+        uint8 received[sizeof(sent)] = {};
+        uint64 total = 0;
+        while (total < sizeof(received))
+        {
+            Result<uint64> count = ReceiveSocket(
+                client.Value(), MutableByteView(received + total, sizeof(received) - total));
+            REQUIRE(count);
+            REQUIRE(count.Value() > 0);
+            total += count.Value();
+        }
+        CHECK(std::memcmp(sent, received, sizeof(sent)) == 0);
+
+        // The server sees the close, finishes, and closes its end, which the client then sees
+        ShutdownSocket(client.Value());
+        CHECK(server.Value()->Join());
+        Result<uint64> closed = ReceiveSocket(client.Value(), MutableByteView(received, 16));
+        REQUIRE(closed);
+        CHECK(closed.Value() == 0);
+
+        CHECK(CloseSocket(client.Value()));
+        CHECK(CloseSocket(listener.Value()));
+    }
+
+    TEST_CASE("Host names resolve")
+    {
+        Result<SocketHandle> listener = ListenSocket(0);
+        REQUIRE(listener);
+        const uint16 port = GetSocketPort(listener.Value()).Value();
+
+        // Accepted from the backlog later, the connect completes without it
+        Result<SocketHandle> client = ConnectSocket("localhost", port);
+        REQUIRE(client);
+        Result<SocketHandle> connection = AcceptSocket(listener.Value());
+        REQUIRE(connection);
+
+        CHECK(CloseSocket(connection.Value()));
+        CHECK(CloseSocket(client.Value()));
+        CHECK(CloseSocket(listener.Value()));
+    }
+
+    TEST_CASE("Receives time out")
+    {
+        Result<SocketHandle> listener = ListenSocket(0);
+        REQUIRE(listener);
+        const uint16 port = GetSocketPort(listener.Value()).Value();
+
+        Result<SocketHandle> client = ConnectSocket("127.0.0.1", port, 50);
+        REQUIRE(client);
+        Result<SocketHandle> connection = AcceptSocket(listener.Value());
+        REQUIRE(connection);
+
+        // Nothing is ever sent
+        uint8 buffer[16];
+        Result<uint64> received = ReceiveSocket(client.Value(), MutableByteView(buffer, 16));
+        CHECK_FALSE(received);
+        CHECK(received.Category() == ErrorCategory::Timeout);
+
+        CHECK(CloseSocket(connection.Value()));
+        CHECK(CloseSocket(client.Value()));
+        CHECK(CloseSocket(listener.Value()));
+    }
+
+    TEST_CASE("Nothing listening")
+    {
+        // A port that was just free, and still is once its listener closes
+        Result<SocketHandle> listener = ListenSocket(0);
+        REQUIRE(listener);
+        const uint16 port = GetSocketPort(listener.Value()).Value();
+        CHECK(CloseSocket(listener.Value()));
+
+        Result<SocketHandle> client = ConnectSocket("127.0.0.1", port, 1000);
+        CHECK_FALSE(client);
+        CHECK(client.Category() == ErrorCategory::Io);
+
+        CHECK(ConnectSocket("rsbl-socket-test.invalid", 80).Category() == ErrorCategory::NotFound);
+    }
+}
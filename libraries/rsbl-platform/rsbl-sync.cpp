@@ -0,0 +1,188 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-sync.h"
+
+#include <rsbl-clock.h>
+
+// The semaphore and event only need AddressWait/Wake, so they're shared by every platform
+
+namespace rsbl
+{
+
+namespace
+{
+// Failed tries before a waiter goes to sleep. A few microseconds, about what a futex wait and
+// wake up cost anyway.
+constexpr uint32 kSpinCount = 256;
+
+uint64 DeadlineFor(uint32 timeout_ms)
+{
+    if (timeout_ms == kWaitInfinite)
+    {
+        return 0;
+    }
+    return Clock::NowTicks() + timeout_ms * Clock::TicksPerSecond() / 1000;
+}
+
+// Milliseconds left until deadline, rounded up so a short wait doesn't become a busy loop
+uint32 RemainingMs(uint64 deadline)
+{
+    if (deadline == 0)
+    {
+        return kWaitInfinite;
+    }
+    const uint64 now = Clock::NowTicks();
+    if (now >= deadline)
+    {
+        return 0;
+    }
+    const uint64 ns = Clock::TicksToNs(deadline - now);
+    return static_cast<uint32>((ns + 999'999) / 1'000'000);
+}
+
+// Spins on try, then sleeps on word while it reads 0, until try succeeds or the time is up
+template <typename TryFunc>
+bool SpinThenWait(std::atomic<uint32>& word,
+                  std::atomic<uint32>& sleepers,
+                  uint32 timeout_ms,
+                  TryFunc&& try_func)
+{
+    for (uint32 i = 0; i < kSpinCount; ++i)
+    {
+        if (try_func())
+        {
+            return true;
+        }
+        Thread::SpinPause();
+    }
+
+    const uint64 deadline = DeadlineFor(timeout_ms);
+    for (;;)
+    {
+        if (try_func())
+        {
+            return true;
+        }
+
+        const uint32 remaining = RemainingMs(deadline);
+        if (remaining == 0)
+        {
+            return false;
+        }
+
+        // Either the signaller sees the sleeper count, or this thread sees the new value and
+        // AddressWait returns straight away
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        if (word.load(std::memory_order_seq_cst) == 0)
+        {
+            AddressWait(word, 0, remaining);
+        }
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+} // namespace
+
+LightweightSemaphore::LightweightSemaphore(uint32 initialCount)
+    : m_count(initialCount)
+{
+}
+
+void LightweightSemaphore::Signal(uint32 count)
+{
+    m_count.fetch_add(count, std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_seq_cst) == 0)
+    {
+        return;
+    }
+
+    if (count == 1)
+    {
+        AddressWakeOne(m_count);
+    }
+    else
+    {
+        AddressWakeAll(m_count);
+    }
+}
+
+bool LightweightSemaphore::TryWait()
+{
+    uint32 count = m_count.load(std::memory_order_relaxed);
+    while (count > 0)
+    {
+        if (m_count.compare_exchange_weak(
+                count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void LightweightSemaphore::Wait()
+{
+    SpinThenWait(m_count, m_sleepers, kWaitInfinite, [this]() { return TryWait(); });
+}
+
+bool LightweightSemaphore::WaitTimeout(uint32 timeout_ms)
+{
+    return SpinThenWait(m_count, m_sleepers, timeout_ms, [this]() { return TryWait(); });
+}
+
+Event::Event(ResetMode mode, bool initiallySet)
+    : m_state(initiallySet ? 1 : 0)
+    , m_mode(mode)
+{
+}
+
+void Event::Set()
+{
+    if (m_state.exchange(1, std::memory_order_seq_cst) == 1)
+    {
+        // Already set, whoever set it woke the sleepers
+        return;
+    }
+    if (m_sleepers.load(std::memory_order_seq_cst) == 0)
+    {
+        return;
+    }
+
+    if (m_mode == ResetMode::Auto)
+    {
+        AddressWakeOne(m_state);
+    }
+    else
+    {
+        AddressWakeAll(m_state);
+    }
+}
+
+void Event::Reset()
+{
+    m_state.store(0, std::memory_order_relaxed);
+}
+
+bool Event::TryConsume()
+{
+    if (m_mode == ResetMode::Manual)
+    {
+        return m_state.load(std::memory_order_acquire) != 0;
+    }
+
+    uint32 expected = 1;
+    return m_state.compare_exchange_strong(
+        expected, 0, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+void Event::Wait()
+{
+    SpinThenWait(m_state, m_sleepers, kWaitInfinite, [this]() { return TryConsume(); });
+}
+
+bool Event::WaitTimeout(uint32 timeout_ms)
+{
+    return SpinThenWait(m_state, m_sleepers, timeout_ms, [this]() { return TryConsume(); });
+}
+
+} // namespace rsbl
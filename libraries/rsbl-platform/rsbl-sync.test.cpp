@@ -0,0 +1,187 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-clock.h"
+#include "include/rsbl-sync.h"
+#include "include/rsbl-thread.h"
+
+#include <rsbl-dynamic-array.h>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint32 kThreadCount = 4;
+constexpr uint32 kIterations = 20000;
+
+// Bumps a plain counter under the lock from several threads, any lost update shows up as a
+// short count
+template <typename LockType>
+uint32 CountUnderLock()
+{
+    LockType lock;
+    uint32 counter = 0;
+
+    DynamicArray<UniquePtr<Thread>> threads;
+    for (uint32 t = 0; t < kThreadCount; ++t)
+    {
+        auto thread = Thread::Create([&lock, &counter]() -> Result<> {
+            for (uint32 i = 0; i < kIterations; ++i)
+            {
+                LockGuard<LockType> guard(lock);
+                ++counter;
+            }
+            return ResultCode::Success;
+        });
+        REQUIRE(thread);
+        threads.PushBack(rsblMove(thread.Value()));
+    }
+    for (UniquePtr<Thread>& thread : threads)
+    {
+        REQUIRE(thread->Join());
+    }
+    return counter;
+}
+} // namespace
+
+TEST_SUITE("rsbl::Sync")
+{
+    TEST_CASE("SpinLock excludes")
+    {
+        CHECK(CountUnderLock<SpinLock>() == kThreadCount * kIterations);
+    }
+
+    TEST_CASE("Mutex excludes")
+    {
+        CHECK(CountUnderLock<Mutex>() == kThreadCount * kIterations);
+    }
+
+    TEST_CASE("TryLock fails while held")
+    {
+        Mutex mutex;
+        CHECK(mutex.TryLock());
+        CHECK_FALSE(mutex.TryLock());
+        mutex.Unlock();
+        CHECK(mutex.TryLock());
+        mutex.Unlock();
+
+        SpinLock spin;
+        CHECK(spin.TryLock());
+        CHECK_FALSE(spin.TryLock());
+        spin.Unlock();
+    }
+
+    TEST_CASE("Semaphore counts")
+    {
+        LightweightSemaphore semaphore(2);
+        CHECK(semaphore.TryWait());
+        CHECK(semaphore.TryWait());
+        CHECK_FALSE(semaphore.TryWait());
+
+        semaphore.Signal(3);
+        CHECK(semaphore.GetCount() == 3);
+        semaphore.Wait();
+        CHECK(semaphore.GetCount() == 2);
+    }
+
+    TEST_CASE("Semaphore hands items between threads")
+    {
+        constexpr uint32 kItems = 1000;
+        LightweightSemaphore items;
+        std::atomic<uint32> consumed{0};
+
+        auto consumer = Thread::Create([&items, &consumed]() -> Result<> {
+            for (uint32 i = 0; i < kItems; ++i)
+            {
+                items.Wait();
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+            return ResultCode::Success;
+        });
+        REQUIRE(consumer);
+
+        for (uint32 i = 0; i < kItems; ++i)
+        {
+            items.Signal();
+            if (i % 100 == 0)
+            {
+                // Give the consumer a chance to run dry and go to sleep
+                Thread::ThreadSleep(1);
+            }
+        }
+        REQUIRE(consumer.Value()->Join());
+        CHECK(consumed.load() == kItems);
+        CHECK(items.GetCount() == 0);
+    }
+
+    TEST_CASE("Semaphore wait times out")
+    {
+        LightweightSemaphore semaphore;
+        const uint64 start = Clock::NowTicks();
+        CHECK_FALSE(semaphore.WaitTimeout(20));
+        CHECK(Clock::TicksToMs(Clock::NowTicks() - start) >= 15.0);
+    }
+
+    TEST_CASE("Auto reset event lets one waiter through")
+    {
+        Event event;
+        CHECK_FALSE(event.WaitTimeout(0));
+        event.Set();
+        CHECK(event.IsSet());
+        CHECK(event.WaitTimeout(0));
+        CHECK_FALSE(event.IsSet());
+        CHECK_FALSE(event.WaitTimeout(1));
+    }
+
+    TEST_CASE("Manual reset event stays set")
+    {
+        Event event(Event::ResetMode::Manual);
+        std::atomic<uint32> released{0};
+
+        DynamicArray<UniquePtr<Thread>> threads;
+        for (uint32 t = 0; t < kThreadCount; ++t)
+        {
+            auto thread = Thread::Create([&event, &released]() -> Result<> {
+                event.Wait();
+                released.fetch_add(1, std::memory_order_relaxed);
+                return ResultCode::Success;
+            });
+            REQUIRE(thread);
+            threads.PushBack(rsblMove(thread.Value()));
+        }
+
+        Thread::ThreadSleep(10);
+        CHECK(released.load() == 0);
+        event.Set();
+        for (UniquePtr<Thread>& thread : threads)
+        {
+            REQUIRE(thread->Join());
+        }
+        CHECK(released.load() == kThreadCount);
+        CHECK(event.IsSet());
+
+        event.Reset();
+        CHECK_FALSE(event.WaitTimeout(1));
+    }
+
+    TEST_CASE("Event wakes a sleeping waiter")
+    {
+        Event event;
+        auto waiter = Thread::Create([&event]() -> Result<> {
+            if (!event.WaitTimeout(5000))
+            {
+                return "Event never arrived";
+            }
+            return ResultCode::Success;
+        });
+        REQUIRE(waiter);
+
+        Thread::ThreadSleep(10);
+        event.Set();
+        REQUIRE(waiter.Value()->Join());
+        CHECK(waiter.Value()->GetFunctionResult());
+    }
+}
@@ -0,0 +1,84 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-thread-local.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-memory-tracking.h>
+
+#include <atomic>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kIndexWordCount = kMaxThreadIndices / 64;
+
+// A bit per index, set while a thread holds it. Plain atomics, so it's still there for threads
+// exiting after static destructors ran.
+std::atomic<uint64> s_usedIndices[kIndexWordCount];
+
+uint32 ClaimIndex()
+{
+    for (uint32 word = 0; word < kIndexWordCount; ++word)
+    {
+        uint64 used = s_usedIndices[word].load(std::memory_order_relaxed);
+        while (used != ~0ull)
+        {
+            const uint32 bit = CountTrailingZeros64(~used);
+            if (s_usedIndices[word].compare_exchange_weak(
+                    used, used | (1ull << bit), std::memory_order_relaxed))
+            {
+                return word * 64 + bit;
+            }
+        }
+    }
+    rsblAssertMsg(false, "More than kMaxThreadIndices threads alive");
+    return kMaxThreadIndices;
+}
+
+struct ThreadIndex
+{
+    ThreadIndex()
+        : index(ClaimIndex())
+    {
+    }
+
+    ~ThreadIndex()
+    {
+        if (index < kMaxThreadIndices)
+        {
+            s_usedIndices[index / 64].fetch_and(~(1ull << (index % 64)), std::memory_order_relaxed);
+        }
+    }
+
+    uint32 index;
+};
+
+thread_local LinearArena* s_scratchOverride = nullptr;
+} // namespace
+
+uint32 GetThreadIndex()
+{
+    static thread_local ThreadIndex s_index;
+    return s_index.index;
+}
+
+LinearArena& GetScratchArena()
+{
+    if (s_scratchOverride != nullptr)
+    {
+        return *s_scratchOverride;
+    }
+    static thread_local LinearArena s_threadScratch(kScratchBlockSize,
+                                                    GetTaggedAllocator(MemoryTag::Platform));
+    return s_threadScratch;
+}
+
+void SetScratchArena(LinearArena* arena)
+{
+    s_scratchOverride = arena;
+}
+
+} // namespace rsbl
@@ -0,0 +1,107 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-thread-local.h"
+#include "include/rsbl-thread-pool.h"
+#include "include/rsbl-thread.h"
+
+#include <atomic>
+
+using namespace rsbl;
+
+TEST_SUITE("rsbl::ThreadLocal")
+{
+    TEST_CASE("Threads get different indices")
+    {
+        const uint32 main_index = GetThreadIndex();
+        CHECK(main_index < kMaxThreadIndices);
+        CHECK(GetThreadIndex() == main_index);
+
+        uint32 other_index = main_index;
+        Result<UniquePtr<Thread>> thread = Thread::Create([&other_index]() -> Result<> {
+            other_index = GetThreadIndex();
+            return ResultCode::Success;
+        });
+        REQUIRE(thread);
+        REQUIRE(thread.Value()->Join());
+        CHECK(other_index != main_index);
+        CHECK(other_index < kMaxThreadIndices);
+    }
+
+    TEST_CASE("Exited threads hand their index back")
+    {
+        // Run one after another, so the same index can go round
+        uint32 first = 0;
+        uint32 second = 0;
+        for (uint32* index : {&first, &second})
+        {
+            Result<UniquePtr<Thread>> thread = Thread::Create([index]() -> Result<> {
+                *index = GetThreadIndex();
+                return ResultCode::Success;
+            });
+            REQUIRE(thread);
+            REQUIRE(thread.Value()->Join());
+        }
+        CHECK(first == second);
+    }
+
+    TEST_CASE("Slots sum up per thread")
+    {
+        ThreadLocal<uint64> counts;
+        ThreadPoolOptions options;
+        options.threadCount = 4;
+        Result<UniquePtr<ThreadPool>> pool = ThreadPool::Create(options);
+        REQUIRE(pool);
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            pool.Value()->Submit([&counts]() { counts.Get() += 1; });
+        }
+        pool.Value()->WaitIdle();
+
+        uint64 total = 0;
+        counts.ForEach([&total](uint64 count) { total += count; });
+        CHECK(total == 1000);
+    }
+
+    TEST_CASE("Scratch scopes hand their memory back")
+    {
+        LinearArena& arena = GetScratchArena();
+        const uint64 before = arena.BytesUsed();
+        {
+            ScratchScope outer;
+            outer.Arena().Allocate(128, 16);
+            const uint64 after_outer = arena.BytesUsed();
+            {
+                // Past the block, so the inner scope chains another
+                ScratchScope inner;
+                inner.Arena().AllocateArray<float>(100000);
+                CHECK(arena.BytesUsed() > after_outer);
+            }
+            CHECK(arena.BytesUsed() == after_outer);
+        }
+        CHECK(arena.BytesUsed() == before);
+    }
+
+    TEST_CASE("Threads have their own scratch arena")
+    {
+        LinearArena* main_arena = &GetScratchArena();
+        LinearArena* other_arena = main_arena;
+        Result<UniquePtr<Thread>> thread = Thread::Create([&other_arena]() -> Result<> {
+            other_arena = &GetScratchArena();
+            return ResultCode::Success;
+        });
+        REQUIRE(thread);
+        REQUIRE(thread.Value()->Join());
+        CHECK(other_arena != main_arena);
+
+        // Swapped out for a fiber's, then back
+        LinearArena fiber_arena(1024);
+        SetScratchArena(&fiber_arena);
+        CHECK(&GetScratchArena() == &fiber_arena);
+        SetScratchArena(nullptr);
+        CHECK(&GetScratchArena() == main_arena);
+    }
+}
@@ -0,0 +1,231 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-thread-pool.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-clock.h>
+#include <rsbl-concurrent-queue.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-sync.h>
+#include <rsbl-thread-local.h>
+
+#include <cstdio>
+
+namespace rsbl
+{
+
+namespace
+{
+struct QueuedTask
+{
+    PoolTask task;
+    uint64 submitTicks = 0;
+};
+} // namespace
+
+struct ThreadPool::State
+{
+    explicit State(const ThreadPoolOptions& options)
+        : queue(options.queueCapacity, GetTaggedAllocator(MemoryTag::Platform))
+    {
+    }
+
+    Result<> ThreadMain();
+    void Finish();
+
+    MpmcQueue<QueuedTask> queue;
+
+    // One count per queued task, plus one per thread at shutdown
+    LightweightSemaphore available;
+
+    // Submitted and not yet finished, what WaitIdle sleeps on
+    std::atomic<uint32> pending{0};
+    std::atomic<uint32> idleWaiters{0};
+
+    std::atomic<bool> stopping{false};
+
+    std::atomic<uint64> tasksRun{0};
+    std::atomic<uint64> wakeups{0};
+    std::atomic<uint64> totalWakeLatencyNs{0};
+    std::atomic<uint64> maxWakeLatencyNs{0};
+
+    DynamicArray<UniquePtr<Thread>> threads;
+};
+
+Result<> ThreadPool::State::ThreadMain()
+{
+    for (;;)
+    {
+        // A failed TryWait means this thread is about to spin and probably sleep, so whatever
+        // it gets next is what the wake up latency measures
+        const bool waited = !available.TryWait();
+        if (waited)
+        {
+            available.Wait();
+        }
+
+        QueuedTask queued;
+        while (!queue.TryPop(queued))
+        {
+            // Every task count comes with a task, but its push can still be finishing on
+            // another thread. Only shutdown counts come with nothing.
+            if (stopping.load(std::memory_order_acquire))
+            {
+                return ResultCode::Success;
+            }
+            Thread::SpinPause();
+        }
+
+        if (waited)
+        {
+            const uint64 latency = Clock::TicksToNs(Clock::NowTicks() - queued.submitTicks);
+            wakeups.fetch_add(1, std::memory_order_relaxed);
+            totalWakeLatencyNs.fetch_add(latency, std::memory_order_relaxed);
+            uint64 max = maxWakeLatencyNs.load(std::memory_order_relaxed);
+            while (latency > max &&
+                   !maxWakeLatencyNs.compare_exchange_weak(max, latency, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        {
+            ScratchScope scratch;
+            queued.task();
+        }
+        queued.task = PoolTask();
+        tasksRun.fetch_add(1, std::memory_order_relaxed);
+        Finish();
+    }
+}
+
+void ThreadPool::State::Finish()
+{
+    if (pending.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+        idleWaiters.load(std::memory_order_seq_cst) > 0)
+    {
+        AddressWakeAll(pending);
+    }
+}
+
+Result<UniquePtr<ThreadPool>> ThreadPool::Create(const ThreadPoolOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    if (options.threadCount == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "A thread pool needs at least one thread"};
+    }
+
+    UniquePtr<ThreadPool> pool(new ThreadPool());
+    pool->m_state = new State(options);
+
+    State* state = pool->m_state;
+    state->threads.Reserve(options.threadCount);
+    for (uint32 i = 0; i < options.threadCount; ++i)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%s-%u", options.name != nullptr ? options.name : "pool", i);
+        ThreadCreateInfo info;
+        info.name = name;
+        info.priority = options.priority;
+        info.stackSize = options.stackSize;
+        Result<UniquePtr<Thread>> thread =
+            Thread::Create(info, [state]() -> Result<> { return state->ThreadMain(); });
+        if (!thread)
+        {
+            // The destructor stops the threads that did start
+            return thread.FailureText();
+        }
+        state->threads.PushBack(rsblMove(thread.Value()));
+    }
+
+    return rsblMove(pool);
+}
+
+ThreadPool::~ThreadPool()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+
+    // The shutdown counts queue up behind the tasks' counts, so every queued task still runs
+    m_state->stopping.store(true, std::memory_order_release);
+    m_state->available.Signal(static_cast<uint32>(m_state->threads.Size()));
+    for (UniquePtr<Thread>& thread : m_state->threads)
+    {
+        const Result<> joined = thread->Join();
+        rsblAssert(joined);
+    }
+
+    rsblAssertMsg(m_state->pending.load(std::memory_order_relaxed) == 0,
+                  "Tasks submitted while the ThreadPool shut down");
+    delete m_state;
+}
+
+void ThreadPool::Submit(PoolTask&& task)
+{
+    rsblAssertMsg(!m_state->stopping.load(std::memory_order_relaxed),
+                  "Submit on a ThreadPool that's shutting down");
+
+    m_state->pending.fetch_add(1, std::memory_order_relaxed);
+
+    QueuedTask queued;
+    queued.task = rsblMove(task);
+    queued.submitTicks = Clock::NowTicks();
+    if (!m_state->queue.TryPush(rsblMove(queued)))
+    {
+        // Out of room, running it here is the back pressure
+        queued.task();
+        m_state->tasksRun.fetch_add(1, std::memory_order_relaxed);
+        m_state->Finish();
+        return;
+    }
+    m_state->available.Signal();
+}
+
+void ThreadPool::WaitIdle()
+{
+    for (;;)
+    {
+        m_state->idleWaiters.fetch_add(1, std::memory_order_seq_cst);
+        const uint32 pending = m_state->pending.load(std::memory_order_seq_cst);
+        if (pending != 0)
+        {
+            AddressWait(m_state->pending, pending);
+        }
+        m_state->idleWaiters.fetch_sub(1, std::memory_order_relaxed);
+
+        if (pending == 0)
+        {
+            return;
+        }
+    }
+}
+
+uint32 ThreadPool::ThreadCount() const
+{
+    return static_cast<uint32>(m_state->threads.Size());
+}
+
+ThreadPoolStats ThreadPool::GetStats() const
+{
+    ThreadPoolStats stats;
+    stats.tasksRun = m_state->tasksRun.load(std::memory_order_relaxed);
+    stats.wakeups = m_state->wakeups.load(std::memory_order_relaxed);
+    stats.totalWakeLatencyNs = m_state->totalWakeLatencyNs.load(std::memory_order_relaxed);
+    stats.maxWakeLatencyNs = m_state->maxWakeLatencyNs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void ThreadPool::ResetStats()
+{
+    m_state->tasksRun.store(0, std::memory_order_relaxed);
+    m_state->wakeups.store(0, std::memory_order_relaxed);
+    m_state->totalWakeLatencyNs.store(0, std::memory_order_relaxed);
+    m_state->maxWakeLatencyNs.store(0, std::memory_order_relaxed);
+}
+
+} // namespace rsbl
@@ -0,0 +1,148 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-clock.h"
+#include "include/rsbl-thread-pool.h"
+
+#include <atomic>
+
+using namespace rsbl;
+
+TEST_SUITE("rsbl::ThreadPool")
+{
+    TEST_CASE("Runs every task")
+    {
+        Result<UniquePtr<ThreadPool>> pool = ThreadPool::Create();
+        REQUIRE(pool);
+        CHECK(pool.Value()->ThreadCount() == 4);
+
+        std::atomic<uint32> sum{0};
+        for (uint32 i = 1; i <= 1000; ++i)
+        {
+            pool.Value()->Submit([&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); });
+        }
+        pool.Value()->WaitIdle();
+        CHECK(sum.load() == 1000 * 1001 / 2);
+        CHECK(pool.Value()->GetStats().tasksRun == 1000);
+    }
+
+    TEST_CASE("Blocking tasks overlap")
+    {
+        ThreadPoolOptions options;
+        options.threadCount = 8;
+        Result<UniquePtr<ThreadPool>> pool = ThreadPool::Create(options);
+        REQUIRE(pool);
+
+        // Eight 20ms sleeps on eight threads take about 20ms, not 160
+        std::atomic<uint32> done{0};
+        const uint64 start = Clock::NowTicks();
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            pool.Value()->Submit([&done]() {
+                Thread::ThreadSleep(20);
+                done.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        pool.Value()->WaitIdle();
+        CHECK(done.load() == 8);
+        CHECK(Clock::TicksToMs(Clock::NowTicks() - start) < 120.0);
+    }
+
+    TEST_CASE("Tasks can submit tasks")
+    {
+        Result<UniquePtr<ThreadPool>> pool = ThreadPool::Create();
+        REQUIRE(pool);
+        ThreadPool* io = pool.Value().Get();
+
+        std::atomic<uint32> leaves{0};
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            io->Submit([io, &leaves]() {
+                for (uint32 j = 0; j < 10; ++j)
+                {
+                    io->Submit([&leaves]() { leaves.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        io->WaitIdle();
+        CHECK(leaves.load() == 100);
+    }
+
+    TEST_CASE("A full queue runs tasks on the submitter")
+    {
+        ThreadPoolOptions options;
+        options.threadCount = 1;
+        options.queueCapacity = 2;
+        Result<UniquePtr<ThreadPool>> pool = ThreadPool::Create(options);
+        REQUIRE(pool);
+
+        std::atomic<bool> release{false};
+        std::atomic<uint32> count{0};
+        pool.Value()->Submit([&release]() {
+            while (!release.load(std::memory_order_acquire))
+            {
+                Thread::ThreadYield();
+            }
+        });
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            pool.Value()->Submit([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+        }
+        release.store(true, std::memory_order_release);
+        pool.Value()->WaitIdle();
+        CHECK(count.load() == 10);
+    }
+
+    TEST_CASE("Shutdown runs what's still queued")
+    {
+        std::atomic<uint32> count{0};
+        {
+            ThreadPoolOptions options;
+            options.threadCount = 2;
+            Result<UniquePtr<ThreadPool>> pool = ThreadPool::Create(options);
+            REQUIRE(pool);
+            for (uint32 i = 0; i < 100; ++i)
+            {
+                pool.Value()->Submit([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+            }
+        }
+        CHECK(count.load() == 100);
+    }
+
+    TEST_CASE("Wake up latency is measured")
+    {
+        ThreadPoolOptions options;
+        options.threadCount = 2;
+        Result<UniquePtr<ThreadPool>> pool = ThreadPool::Create(options);
+        REQUIRE(pool);
+
+        // Long enough between tasks for the threads to go to sleep each time
+        for (uint32 i = 0; i < 5; ++i)
+        {
+            Thread::ThreadSleep(5);
+            pool.Value()->Submit([]() {});
+            pool.Value()->WaitIdle();
+        }
+
+        const ThreadPoolStats stats = pool.Value()->GetStats();
+        CHECK(stats.tasksRun == 5);
+        CHECK(stats.wakeups == 5);
+        CHECK(stats.maxWakeLatencyNs > 0);
+        CHECK(stats.AverageWakeLatencyNs() <= stats.maxWakeLatencyNs);
+
+        pool.Value()->ResetStats();
+        CHECK(pool.Value()->GetStats().wakeups == 0);
+    }
+
+    TEST_CASE("No threads is an error")
+    {
+        ThreadPoolOptions options;
+        options.threadCount = 0;
+        Result<UniquePtr<ThreadPool>> pool = ThreadPool::Create(options);
+        CHECK_FALSE(pool);
+        CHECK(pool.Category() == ErrorCategory::InvalidArgument);
+    }
+}
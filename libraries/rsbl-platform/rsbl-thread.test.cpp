@@ -7,6 +7,7 @@
 #include "include/rsbl-thread.h"
 
 #include <atomic>
+#include <cstring>
 
 using namespace rsbl;
 
@@ -15,8 +16,14 @@ TEST_SUITE("rsbl::Thread")
     TEST_CASE("Create and execute simple thread that succeeds")
     {
         std::atomic<bool> executed{false};
+        std::atomic<bool> release{false};
 
-        auto thread_result = Thread::Create([&executed]() -> Result<> {
+        // Held until released, so it can't have finished by the time IsActive is checked
+        auto thread_result = Thread::Create([&executed, &release]() -> Result<> {
+            while (!release.load(std::memory_order_acquire))
+            {
+                Thread::ThreadSleep(1);
+            }
             executed.store(true, std::memory_order_release);
             return ResultCode::Success;
         });
@@ -27,6 +34,7 @@ TEST_SUITE("rsbl::Thread")
 
         // Thread should be active initially
         CHECK(thread->IsActive());
+        release.store(true, std::memory_order_release);
 
         // Join the thread
         auto join_result = thread->Join();
@@ -94,13 +102,17 @@ TEST_SUITE("rsbl::Thread")
         CHECK(func_result);
     }
 
-    TEST_CASE("Thread with sleep to test IsActive")
+    TEST_CASE("Thread that's running is active")
     {
         std::atomic<bool> started{false};
+        std::atomic<bool> release{false};
 
-        auto thread_result = Thread::Create([&started]() -> Result<> {
+        auto thread_result = Thread::Create([&started, &release]() -> Result<> {
             started.store(true, std::memory_order_release);
-            Thread::ThreadSleep(100); // Sleep for 100ms
+            while (!release.load(std::memory_order_acquire))
+            {
+                Thread::ThreadSleep(1);
+            }
             return ResultCode::Success;
         });
 
@@ -110,12 +122,14 @@ TEST_SUITE("rsbl::Thread")
         // Thread should be active
         CHECK(thread->IsActive());
 
-        // Wait a bit to ensure thread has started
-        Thread::ThreadSleep(10);
-        CHECK(started.load(std::memory_order_acquire));
+        while (!started.load(std::memory_order_acquire))
+        {
+            Thread::ThreadSleep(1);
+        }
 
-        // Thread should still be active (sleeping)
+        // Thread should still be active (waiting to be released)
         CHECK(thread->IsActive());
+        release.store(true, std::memory_order_release);
 
         // Join and verify completion
         auto join_result = thread->Join();
@@ -133,8 +147,8 @@ TEST_SUITE("rsbl::Thread")
         REQUIRE(thread_result);
         auto thread = rsblMove(thread_result.Value());
 
-        // Join with a timeout longer than the sleep
-        auto join_result = thread->JoinTimeout(500); // 500ms timeout
+        // Join with a timeout far longer than the sleep, so a loaded machine still makes it
+        auto join_result = thread->JoinTimeout(5000); // 5s timeout
         CHECK(join_result);
         CHECK_FALSE(thread->IsActive());
 
@@ -144,21 +158,27 @@ TEST_SUITE("rsbl::Thread")
 
     TEST_CASE("JoinTimeout with timeout expiration")
     {
-        auto thread_result = Thread::Create([]() -> Result<> {
-            Thread::ThreadSleep(500); // Sleep for 500ms
+        std::atomic<bool> release{false};
+
+        // Held until released, so the join can only time out
+        auto thread_result = Thread::Create([&release]() -> Result<> {
+            while (!release.load(std::memory_order_acquire))
+            {
+                Thread::ThreadSleep(1);
+            }
             return ResultCode::Success;
         });
 
         REQUIRE(thread_result);
         auto thread = rsblMove(thread_result.Value());
 
-        // Join with a timeout shorter than the sleep
         auto join_result = thread->JoinTimeout(50); // 50ms timeout
         CHECK_FALSE(join_result);
         CHECK(std::string(join_result.FailureText()) == "Thread join timeout");
 
         // Thread should still be active
         CHECK(thread->IsActive());
+        release.store(true, std::memory_order_release);
 
         // Now join properly to clean up
         auto final_join = thread->Join();
@@ -321,4 +341,50 @@ TEST_SUITE("rsbl::Thread")
         CHECK(join2);
         CHECK(counter.load(std::memory_order_relaxed) == 200);
     }
+
+    TEST_CASE("Create info names the thread before it runs")
+    {
+        char name[64] = {};
+        ThreadCreateInfo info;
+        info.name = "rsbl-test";
+        info.priority = ThreadPriority::BelowNormal;
+        info.stackSize = 256 * 1024;
+        auto thread_result = Thread::Create(info, [&name]() -> Result<> {
+            return Thread::GetCurrentThreadName(name, sizeof(name));
+        });
+        REQUIRE(thread_result);
+
+        auto thread = rsblMove(thread_result.Value());
+        REQUIRE(thread->Join());
+        CHECK(thread->GetFunctionResult());
+        CHECK(strcmp(name, "rsbl-test") == 0);
+    }
+
+    TEST_CASE("Affinity to the first processor")
+    {
+        std::atomic<bool> executed{false};
+        ThreadCreateInfo info;
+        info.affinityMask = 1;
+        auto thread_result = Thread::Create(info, [&executed]() -> Result<> {
+            executed.store(true, std::memory_order_release);
+            return ResultCode::Success;
+        });
+        REQUIRE(thread_result);
+        REQUIRE(thread_result.Value()->Join());
+        CHECK(executed.load(std::memory_order_acquire));
+    }
+
+    TEST_CASE("An affinity mask with no usable processor fails")
+    {
+        if (Thread::GetHardwareThreadCount() >= 64)
+        {
+            return;
+        }
+
+        ThreadCreateInfo info;
+        info.affinityMask = 1ull << 63;
+        auto thread_result = Thread::Create(info, []() -> Result<> { return ResultCode::Success; });
+        CHECK_FALSE(thread_result);
+        CHECK(thread_result.Category() == ErrorCategory::InvalidArgument);
+    }
 }
@@ -0,0 +1,248 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// What threads cost on this machine, to size worker counts by: creating and joining one, the
+// pause and yield spin loops are built on, waking a sleeping thread through each primitive, the
+// thread pool's Submit to an idle thread, and locks with and without contention at every thread
+// count up to the hardware's.
+
+#include "include/rsbl-sync.h"
+#include "include/rsbl-thread-pool.h"
+#include "include/rsbl-thread.h"
+
+#include <rsbl-bench.h>
+
+#include <atomic>
+#include <cstdio>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint64 kLocksPerRun = 1'000'000;
+
+void LifetimeSuite(Bench& bench)
+{
+    bench.Section("Threads");
+    bench.Run("Create + Join, empty thread", [&]() {
+        auto thread = Thread::Create([]() -> Result<> { return ResultCode::Success; });
+        if (thread)
+        {
+            Result<> joined = thread.Value()->Join();
+            rsblUnused(joined);
+        }
+    });
+    bench.Run("SpinPause", []() { Thread::SpinPause(); });
+    bench.Run("ThreadYield", []() { Thread::ThreadYield(); });
+}
+
+// The main thread wakes a partner, which wakes it back: a round trip is two wakes. Each side
+// waits in Wait, so when it isn't spinning any more it sleeps in the kernel.
+template <typename Signal>
+void PingPong(Bench& bench, const char* name)
+{
+    struct Shared
+    {
+        Signal ping;
+        Signal pong;
+        std::atomic<bool> stop{false};
+    };
+    Shared shared;
+
+    BenchThreads partner(1);
+    partner.Add([&shared]() {
+        for (;;)
+        {
+            shared.ping.Wait();
+            if (shared.stop.load(std::memory_order_acquire))
+            {
+                return;
+            }
+            shared.pong.Signal();
+        }
+    });
+    partner.Start();
+
+    bench.Run(name, [&]() {
+        shared.ping.Signal();
+        shared.pong.Wait();
+    });
+
+    shared.stop.store(true, std::memory_order_release);
+    shared.ping.Signal();
+    partner.Join();
+}
+
+// Each primitive behind the same Signal and Wait, for PingPong
+struct EventSignal
+{
+    Event event;
+
+    void Signal()
+    {
+        event.Set();
+    }
+    void Wait()
+    {
+        event.Wait();
+    }
+};
+
+struct AddressSignal
+{
+    std::atomic<uint32> count{0};
+
+    void Signal()
+    {
+        count.fetch_add(1, std::memory_order_release);
+        AddressWakeOne(count);
+    }
+    void Wait()
+    {
+        for (;;)
+        {
+            uint32 current = count.load(std::memory_order_acquire);
+            if (current > 0 && count.compare_exchange_weak(current, current - 1))
+            {
+                return;
+            }
+            if (current == 0)
+            {
+                AddressWait(count, 0);
+            }
+        }
+    }
+};
+
+struct SemaphoreSignal
+{
+    LightweightSemaphore semaphore;
+
+    void Signal()
+    {
+        semaphore.Signal();
+    }
+    void Wait()
+    {
+        semaphore.Wait();
+    }
+};
+
+void WakeSuite(Bench& bench)
+{
+    bench.Section("Wake round trip between two threads");
+    PingPong<SemaphoreSignal>(bench, "LightweightSemaphore");
+    PingPong<EventSignal>(bench, "Event");
+    PingPong<AddressSignal>(bench, "AddressWait / AddressWakeOne");
+}
+
+// A task submitted to a pool that has nothing to do, until it has run. Back to back the thread
+// may still be spinning; after a millisecond idle it's asleep.
+void PoolSuite(Bench& bench)
+{
+    ThreadPoolOptions options;
+    options.threadCount = 1;
+    options.name = "bench-pool";
+    auto pool = ThreadPool::Create(options);
+    if (!pool)
+    {
+        fprintf(stderr, "ThreadPool::Create failed: %s\n", pool.FailureText());
+        return;
+    }
+
+    bench.Section("ThreadPool, one thread");
+    std::atomic<uint32> ran{0};
+    const auto submitAndWait = [&]() {
+        const uint32 before = ran.load(std::memory_order_relaxed);
+        pool.Value()->Submit([&ran]() { ran.fetch_add(1, std::memory_order_release); });
+        while (ran.load(std::memory_order_acquire) == before)
+        {
+            Thread::SpinPause();
+        }
+    };
+
+    pool.Value()->ResetStats();
+    bench.Run("Submit until run, back to back", submitAndWait);
+    bench.Run("Submit until run, idle 1 ms", []() { Thread::ThreadSleep(1); }, submitAndWait);
+
+    const ThreadPoolStats stats = pool.Value()->GetStats();
+    printf("  pool's own wake latency: average %llu ns, max %llu ns over %llu wakeups\n",
+           static_cast<unsigned long long>(stats.AverageWakeLatencyNs()),
+           static_cast<unsigned long long>(stats.maxWakeLatencyNs),
+           static_cast<unsigned long long>(stats.wakeups));
+}
+
+// kLocksPerRun lock, increment, unlock, split between threads all after the same lock
+template <typename Lock>
+void LockRun(Bench& bench, const char* name, uint32 threadCount)
+{
+    struct Shared
+    {
+        Lock lock;
+        uint64 counter = 0;
+    };
+    Shared shared;
+    const uint64 perThread = kLocksPerRun / threadCount;
+
+    UniquePtr<BenchThreads> threads;
+    bench.Run(name, [&]() {
+        threads = MakeUnique<BenchThreads>(threadCount);
+        for (uint32 i = 0; i < threadCount; ++i)
+        {
+            threads->Add([&shared, perThread]() {
+                for (uint64 n = 0; n < perThread; ++n)
+                {
+                    shared.lock.Lock();
+                    ++shared.counter;
+                    shared.lock.Unlock();
+                }
+            });
+        }
+    }, [&]() {
+        threads->Start();
+        threads->Join();
+    }, {.items = perThread * threadCount});
+    threads = UniquePtr<BenchThreads>();
+    DoNotOptimize(shared.counter);
+}
+
+void LockSuite(Bench& bench, uint32 maxThreads)
+{
+    bench.Section("Uncontended, one thread");
+    Mutex mutex;
+    bench.Run("Mutex", [&]() {
+        mutex.Lock();
+        ClobberMemory();
+        mutex.Unlock();
+    });
+    SpinLock spinLock;
+    bench.Run("SpinLock", [&]() {
+        spinLock.Lock();
+        ClobberMemory();
+        spinLock.Unlock();
+    });
+
+    for (uint32 threads = 2; threads <= maxThreads; threads *= 2)
+    {
+        char section[64];
+        snprintf(section, sizeof(section), "Contended, %u threads", threads);
+        bench.Section(section);
+        LockRun<Mutex>(bench, "Mutex", threads);
+        LockRun<SpinLock>(bench, "SpinLock", threads);
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Bench bench("rsbl-threading", argc, argv);
+    const uint32 hardwareThreads = Thread::GetHardwareThreadCount();
+    printf("%u hardware threads\n", hardwareThreads);
+
+    LifetimeSuite(bench);
+    WakeSuite(bench);
+    PoolSuite(bench);
+    LockSuite(bench, hardwareThreads < 64 ? hardwareThreads : 64);
+
+    return bench.Finish();
+}
@@ -0,0 +1,60 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-virtual-memory.h"
+
+#include <rsbl-assert.h>
+
+namespace rsbl
+{
+
+namespace
+{
+uint64 RoundUp(uint64 size, uint64 granularity)
+{
+    return (size + granularity - 1) / granularity * granularity;
+}
+} // namespace
+
+NumaAllocator::NumaAllocator(uint32 numaNode, MemoryTag tag)
+    : m_numaNode(numaNode)
+    , m_tag(tag)
+{
+}
+
+void* NumaAllocator::Allocate(uint64 size, uint64 alignment)
+{
+    const PageInfo& info = GetPageInfo();
+    rsblAssertMsg(alignment <= info.reserveGranularity,
+                  "NumaAllocator aligns to reserveGranularity at most");
+    (void)alignment;
+
+    // Reservations start on reserveGranularity, and pages are committed whole
+    const uint64 committed = RoundUp(size > 0 ? size : 1, info.pageSize);
+    Result<void*> reserved = ReserveVirtual(committed);
+    if (!reserved)
+    {
+        return nullptr;
+    }
+    if (!CommitPagesOnNode(reserved.Value(), committed, m_numaNode))
+    {
+        ReleaseVirtual(reserved.Value(), committed);
+        return nullptr;
+    }
+    RecordAllocation(m_tag, committed);
+    return reserved.Value();
+}
+
+void NumaAllocator::Free(void* ptr, uint64 size, uint64 alignment)
+{
+    (void)alignment;
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    const uint64 committed = RoundUp(size > 0 ? size : 1, GetPageInfo().pageSize);
+    ReleaseVirtual(ptr, committed);
+    RecordFree(m_tag, committed);
+}
+
+} // namespace rsbl
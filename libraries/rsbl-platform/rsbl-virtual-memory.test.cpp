@@ -0,0 +1,116 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-cpu-topology.h"
+#include "include/rsbl-virtual-memory.h"
+
+#include <cstring>
+
+using namespace rsbl;
+
+TEST_SUITE("VirtualMemory")
+{
+    TEST_CASE("Page sizes")
+    {
+        const PageInfo& info = GetPageInfo();
+        CHECK(info.pageSize >= 4096);
+        CHECK((info.pageSize & (info.pageSize - 1)) == 0);
+        CHECK(info.reserveGranularity % info.pageSize == 0);
+        CHECK(info.largePageSize % info.pageSize == 0);
+    }
+
+    TEST_CASE("Reserve a lot, commit a little")
+    {
+        const uint64 page_size = GetPageInfo().pageSize;
+        constexpr uint64 kReserveSize = 16ull << 30;
+
+        auto reserved = ReserveVirtual(kReserveSize);
+        REQUIRE(reserved);
+        uint8* base = static_cast<uint8*>(reserved.Value());
+        CHECK(reinterpret_cast<uintptr_t>(base) % GetPageInfo().reserveGranularity == 0);
+
+        // The start, and pages far into the reservation, without the ones in between
+        uint8* far = base + (8ull << 30);
+        REQUIRE(CommitPages(base, 4 * page_size));
+        REQUIRE(CommitPages(far, page_size));
+        CHECK(base[0] == 0);
+        CHECK(base[4 * page_size - 1] == 0);
+        memset(base, 0xAB, 4 * page_size);
+        far[page_size - 1] = 7;
+        CHECK(base[3 * page_size] == 0xAB);
+        CHECK(far[page_size - 1] == 7);
+
+        // Committing again keeps what's there
+        REQUIRE(CommitPages(base, page_size));
+        CHECK(base[10] == 0xAB);
+
+        // Decommitted and committed again, they're zeroes
+        DecommitPages(base + page_size, 2 * page_size);
+        REQUIRE(CommitPages(base + page_size, 2 * page_size));
+        CHECK(base[page_size] == 0);
+        CHECK(base[3 * page_size - 1] == 0);
+        CHECK(base[0] == 0xAB);
+        CHECK(base[3 * page_size] == 0xAB);
+
+        ReleaseVirtual(base, kReserveSize);
+    }
+
+    TEST_CASE("Large pages, where the system gives them")
+    {
+        const uint64 large_page_size = GetPageInfo().largePageSize;
+        auto allocated = AllocLargePages(large_page_size + 1);
+        if (!allocated)
+        {
+            // Most machines don't set any aside, or let a normal user have them
+            MESSAGE("No large pages here: " << doctest::String(allocated.FailureText()));
+            return;
+        }
+        uint8* memory = static_cast<uint8*>(allocated.Value());
+        CHECK(reinterpret_cast<uintptr_t>(memory) % large_page_size == 0);
+        // Rounded up to two large pages, all of it usable
+        memset(memory, 1, 2 * large_page_size);
+        CHECK(memory[2 * large_page_size - 1] == 1);
+        FreeLargePages(memory, large_page_size + 1);
+    }
+
+    TEST_CASE("Committing on each NUMA node")
+    {
+        // Where the pages end up is the OS's call, what's checked is that they're usable
+        const uint64 page_size = GetPageInfo().pageSize;
+        for (uint32 node = 0; node < GetCpuTopology().numaNodeCount; ++node)
+        {
+            auto reserved = ReserveVirtual(4 * page_size);
+            REQUIRE(reserved);
+            uint8* base = static_cast<uint8*>(reserved.Value());
+            REQUIRE(CommitPagesOnNode(base, 4 * page_size, node));
+            CHECK(base[0] == 0);
+            memset(base, 0x5A, 4 * page_size);
+            CHECK(base[4 * page_size - 1] == 0x5A);
+            ReleaseVirtual(base, 4 * page_size);
+        }
+    }
+
+    TEST_CASE("A NUMA allocator hands out whole zeroed pages and charges its tag")
+    {
+        NumaAllocator allocator(GetCpuTopology().numaNodeCount - 1, MemoryTag::Platform);
+        const uint64 page_size = GetPageInfo().pageSize;
+        const uint64 before = GetMemoryStats(MemoryTag::Platform).liveBytes;
+
+        uint8* block = static_cast<uint8*>(allocator.Allocate(page_size + 1, 64));
+        REQUIRE(block != nullptr);
+        CHECK(reinterpret_cast<uintptr_t>(block) % 64 == 0);
+        CHECK(block[0] == 0);
+        // Rounded up to two pages, all of it usable
+        memset(block, 3, 2 * page_size);
+        CHECK(block[2 * page_size - 1] == 3);
+#if defined(RSBL_MEMORY_TRACKING_ENABLED)
+        CHECK(GetMemoryStats(MemoryTag::Platform).liveBytes == before + 2 * page_size);
+#endif
+
+        allocator.Free(block, page_size + 1, 64);
+        CHECK(GetMemoryStats(MemoryTag::Platform).liveBytes == before);
+    }
+}
@@ -0,0 +1,455 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-async-io.h"
+
+#include "rsbl-win-file-internal.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-os-trace.h>
+
+#include <windows.h>
+
+#if __has_include(<ioringapi.h>)
+    #include <ioringapi.h>
+    #define RSBL_HAS_IORING 1
+#else
+    #define RSBL_HAS_IORING 0
+#endif
+
+// IoRing is Windows 11 only, so its functions are looked up at runtime rather than imported,
+// which would keep the program from starting on Windows 10. Everywhere else reads go through an
+// IO completion port, one OVERLAPPED per read in flight. Files are opened overlapped either way.
+
+namespace rsbl
+{
+
+namespace
+{
+// Completion keys for reads that failed or hit the end of the file before they were queued,
+// posted to the port by hand so they're reaped like the rest
+constexpr ULONG_PTR kReadKey = 0;
+constexpr ULONG_PTR kFailedKey = 1;
+constexpr ULONG_PTR kEndOfFileKey = 2;
+
+// NTSTATUS a read past the end of the file completes with
+constexpr ULONG_PTR kStatusEndOfFile = 0xC0000011;
+
+struct ReadSlot
+{
+    OVERLAPPED overlapped;
+    uint64 userData;
+};
+
+#if RSBL_HAS_IORING
+using QueryIoRingCapabilitiesFn = HRESULT(WINAPI*)(IORING_CAPABILITIES*);
+using CreateIoRingFn = HRESULT(WINAPI*)(
+    IORING_VERSION, IORING_CREATE_FLAGS, UINT32, UINT32, HIORING*);
+using BuildIoRingReadFileFn = HRESULT(WINAPI*)(
+    HIORING, IORING_HANDLE_REF, IORING_BUFFER_REF, UINT32, UINT64, UINT_PTR, IORING_SQE_FLAGS);
+using SubmitIoRingFn = HRESULT(WINAPI*)(HIORING, UINT32, UINT32, UINT32*);
+using PopIoRingCompletionFn = HRESULT(WINAPI*)(HIORING, IORING_CQE*);
+using CloseIoRingFn = HRESULT(WINAPI*)(HIORING);
+
+struct IoRingApi
+{
+    QueryIoRingCapabilitiesFn queryCapabilities = nullptr;
+    CreateIoRingFn create = nullptr;
+    BuildIoRingReadFileFn buildReadFile = nullptr;
+    SubmitIoRingFn submit = nullptr;
+    PopIoRingCompletionFn popCompletion = nullptr;
+    CloseIoRingFn close = nullptr;
+
+    bool Load()
+    {
+        HMODULE module = GetModuleHandleA("kernelbase.dll");
+        if (module == nullptr)
+        {
+            return false;
+        }
+        queryCapabilities = reinterpret_cast<QueryIoRingCapabilitiesFn>(
+            GetProcAddress(module, "QueryIoRingCapabilities"));
+        create = reinterpret_cast<CreateIoRingFn>(GetProcAddress(module, "CreateIoRing"));
+        buildReadFile =
+            reinterpret_cast<BuildIoRingReadFileFn>(GetProcAddress(module, "BuildIoRingReadFile"));
+        submit = reinterpret_cast<SubmitIoRingFn>(GetProcAddress(module, "SubmitIoRing"));
+        popCompletion =
+            reinterpret_cast<PopIoRingCompletionFn>(GetProcAddress(module, "PopIoRingCompletion"));
+        close = reinterpret_cast<CloseIoRingFn>(GetProcAddress(module, "CloseIoRing"));
+        return queryCapabilities != nullptr && create != nullptr && buildReadFile != nullptr &&
+               submit != nullptr && popCompletion != nullptr && close != nullptr;
+    }
+};
+#endif
+
+void TraceCompletions(AsyncIoBackend backend, const AsyncIoCompletion* completions, uint32 count)
+{
+    if (OsTraceEnabled(OsTraceEvent::IoComplete)) [[unlikely]]
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            OsTraceMark(OsTraceEvent::IoComplete,
+                        AsyncIoBackendName(backend),
+                        completions[i].userData,
+                        completions[i].bytesRead);
+        }
+    }
+}
+} // namespace
+
+struct AsyncIo::State
+{
+    explicit State(const AsyncIoOptions& options)
+        : queueDepth(options.queueDepth)
+    {
+        queued.Reserve(options.queueDepth);
+    }
+
+    ~State();
+
+    bool SetUpIoRing();
+    Result<> SubmitIoRing();
+    uint32 PollIoRing(AsyncIoCompletion* out, uint32 maxCount);
+
+    Result<> SubmitCompletionPort();
+    uint32 PollCompletionPort(AsyncIoCompletion* out, uint32 maxCount, DWORD timeoutMs);
+
+    AsyncIoBackend backend = AsyncIoBackend::CompletionPort;
+    uint32 queueDepth = 0;
+    uint32 inFlight = 0;
+    DynamicArray<AsyncRead> queued{GetTaggedAllocator(MemoryTag::Platform)};
+
+#if RSBL_HAS_IORING
+    IoRingApi ioRingApi;
+    HIORING ioRing = nullptr;
+#endif
+
+    HANDLE port = nullptr;
+    DynamicArray<ReadSlot> slots{GetTaggedAllocator(MemoryTag::Platform)};
+    DynamicArray<ReadSlot*> freeSlots{GetTaggedAllocator(MemoryTag::Platform)};
+};
+
+AsyncIo::State::~State()
+{
+#if RSBL_HAS_IORING
+    if (ioRing != nullptr)
+    {
+        ioRingApi.close(ioRing);
+    }
+#endif
+    if (port != nullptr)
+    {
+        CloseHandle(port);
+    }
+}
+
+bool AsyncIo::State::SetUpIoRing()
+{
+#if RSBL_HAS_IORING
+    if (!ioRingApi.Load())
+    {
+        return false;
+    }
+
+    IORING_CAPABILITIES capabilities = {};
+    if (FAILED(ioRingApi.queryCapabilities(&capabilities)))
+    {
+        return false;
+    }
+
+    IORING_CREATE_FLAGS flags = {};
+    flags.Required = IORING_CREATE_REQUIRED_FLAGS_NONE;
+    flags.Advisory = IORING_CREATE_ADVISORY_FLAGS_NONE;
+    if (FAILED(ioRingApi.create(
+            capabilities.MaxVersion, flags, queueDepth, queueDepth * 2, &ioRing)))
+    {
+        ioRing = nullptr;
+        return false;
+    }
+
+    backend = AsyncIoBackend::IoRing;
+    return true;
+#else
+    return false;
+#endif
+}
+
+Result<> AsyncIo::State::SubmitIoRing()
+{
+#if RSBL_HAS_IORING
+    for (const AsyncRead& read : queued)
+    {
+        const HRESULT built = ioRingApi.buildReadFile(
+            ioRing,
+            IoRingHandleRefFromHandle(reinterpret_cast<HANDLE>(read.file)),
+            IoRingBufferRefFromPointer(read.buffer.Data()),
+            static_cast<UINT32>(read.buffer.Size()),
+            read.offset,
+            static_cast<UINT_PTR>(read.userData),
+            IOSQE_FLAGS_NONE);
+        rsblAssertMsg(SUCCEEDED(built), "The IoRing submission queue overflowed");
+    }
+
+    UINT32 submitted = 0;
+    if (FAILED(ioRingApi.submit(ioRing, 0, 0, &submitted)))
+    {
+        return {ErrorCategory::Io, "SubmitIoRing failed"};
+    }
+    return ResultCode::Success;
+#else
+    return {ErrorCategory::Platform, "Built without IoRing"};
+#endif
+}
+
+uint32 AsyncIo::State::PollIoRing(AsyncIoCompletion* out, uint32 maxCount)
+{
+#if RSBL_HAS_IORING
+    uint32 count = 0;
+    IORING_CQE cqe;
+    while (count < maxCount && ioRingApi.popCompletion(ioRing, &cqe) == S_OK)
+    {
+        // Reading at or past the end of the file isn't an error, just nothing read
+        const bool end_of_file = cqe.ResultCode == HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+        const bool succeeded = SUCCEEDED(cqe.ResultCode) || end_of_file;
+        out[count++] = {static_cast<uint64>(cqe.UserData),
+                        succeeded ? static_cast<uint64>(cqe.Information) : 0,
+                        succeeded};
+    }
+    return count;
+#else
+    rsblUnused(out);
+    rsblUnused(maxCount);
+    return 0;
+#endif
+}
+
+Result<> AsyncIo::State::SubmitCompletionPort()
+{
+    for (const AsyncRead& read : queued)
+    {
+        ReadSlot* slot = freeSlots[freeSlots.Size() - 1];
+        freeSlots.Resize(freeSlots.Size() - 1);
+
+        memset(&slot->overlapped, 0, sizeof(slot->overlapped));
+        slot->overlapped.Offset = static_cast<DWORD>(read.offset);
+        slot->overlapped.OffsetHigh = static_cast<DWORD>(read.offset >> 32);
+        slot->userData = read.userData;
+
+        if (!::ReadFile(reinterpret_cast<HANDLE>(read.file),
+                        read.buffer.Data(),
+                        static_cast<DWORD>(read.buffer.Size()),
+                        nullptr,
+                        &slot->overlapped))
+        {
+            const DWORD error = GetLastError();
+            if (error != ERROR_IO_PENDING)
+            {
+                const ULONG_PTR key = error == ERROR_HANDLE_EOF ? kEndOfFileKey : kFailedKey;
+                PostQueuedCompletionStatus(port, 0, key, &slot->overlapped);
+            }
+        }
+    }
+    return ResultCode::Success;
+}
+
+uint32 AsyncIo::State::PollCompletionPort(AsyncIoCompletion* out,
+                                          uint32 maxCount,
+                                          DWORD timeoutMs)
+{
+    OVERLAPPED_ENTRY entries[64];
+    const ULONG wanted = maxCount < 64 ? maxCount : 64;
+    ULONG removed = 0;
+    if (!GetQueuedCompletionStatusEx(port, entries, wanted, &removed, timeoutMs, FALSE))
+    {
+        return 0;
+    }
+
+    for (ULONG i = 0; i < removed; ++i)
+    {
+        const OVERLAPPED_ENTRY& entry = entries[i];
+        ReadSlot* slot = CONTAINING_RECORD(entry.lpOverlapped, ReadSlot, overlapped);
+
+        // Internal holds the read's NTSTATUS, for the ones that went through the kernel
+        bool succeeded = entry.lpCompletionKey == kEndOfFileKey;
+        if (entry.lpCompletionKey == kReadKey)
+        {
+            const ULONG_PTR status = entry.lpOverlapped->Internal;
+            succeeded = status == 0 || status == kStatusEndOfFile;
+        }
+        out[i] = {slot->userData,
+                  succeeded ? static_cast<uint64>(entry.dwNumberOfBytesTransferred) : 0,
+                  succeeded};
+        freeSlots.PushBack(slot);
+    }
+    return static_cast<uint32>(removed);
+}
+
+Result<UniquePtr<AsyncIo>> AsyncIo::Create(const AsyncIoOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    if (options.queueDepth == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "AsyncIo needs a queue depth of at least 1"};
+    }
+
+    UniquePtr<AsyncIo> io(new AsyncIo());
+    io->m_state = new State(options);
+    State* state = io->m_state;
+
+    if (options.allowKernelQueues && state->SetUpIoRing())
+    {
+        return rsblMove(io);
+    }
+
+    state->port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (state->port == nullptr)
+    {
+        return {ErrorCategory::Platform, "Failed to create an IO completion port"};
+    }
+    state->slots.Resize(options.queueDepth);
+    state->freeSlots.Reserve(options.queueDepth);
+    for (ReadSlot& slot : state->slots)
+    {
+        state->freeSlots.PushBack(&slot);
+    }
+    state->backend = AsyncIoBackend::CompletionPort;
+    return rsblMove(io);
+}
+
+AsyncIo::~AsyncIo()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+
+    AsyncIoCompletion drained[32];
+    while (m_state->inFlight > 0)
+    {
+        WaitCompletions(drained, 32);
+    }
+    delete m_state;
+}
+
+Result<FileHandle> AsyncIo::OpenForRead(const char* path, FileOpenFlags flags)
+{
+    HANDLE file = CreateFileA(path,
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              Internal::ToFlagsAndAttributes(flags) | FILE_FLAG_OVERLAPPED,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        const DWORD error = GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+        {
+            return {ErrorCategory::NotFound, "Failed to open file for async reads"};
+        }
+        return {ErrorCategory::Io, "Failed to open file for async reads"};
+    }
+
+    if (m_state->backend == AsyncIoBackend::CompletionPort &&
+        CreateIoCompletionPort(file, m_state->port, kReadKey, 0) == nullptr)
+    {
+        CloseHandle(file);
+        return {ErrorCategory::Io, "Failed to add file to the IO completion port"};
+    }
+
+    return reinterpret_cast<FileHandle>(file);
+}
+
+bool AsyncIo::QueueRead(const AsyncRead& read)
+{
+    rsblAssertMsg(read.buffer.Size() <= kMaxAsyncReadSize, "Split reads over kMaxAsyncReadSize");
+    if (m_state->queued.Size() + m_state->inFlight >= m_state->queueDepth)
+    {
+        return false;
+    }
+    m_state->queued.PushBack(read);
+    return true;
+}
+
+Result<> AsyncIo::Submit()
+{
+    State* state = m_state;
+    if (state->queued.IsEmpty())
+    {
+        return ResultCode::Success;
+    }
+
+    if (OsTraceEnabled(OsTraceEvent::IoSubmit)) [[unlikely]]
+    {
+        for (const AsyncRead& read : state->queued)
+        {
+            OsTraceMark(OsTraceEvent::IoSubmit,
+                        AsyncIoBackendName(state->backend),
+                        read.userData,
+                        read.buffer.Size());
+        }
+    }
+
+    Result<> submitted = state->backend == AsyncIoBackend::IoRing ? state->SubmitIoRing()
+                                                                    : state->SubmitCompletionPort();
+    state->inFlight += static_cast<uint32>(state->queued.Size());
+    state->queued.Clear();
+    return submitted;
+}
+
+uint32 AsyncIo::PollCompletions(AsyncIoCompletion* completions, uint32 maxCount)
+{
+    State* state = m_state;
+    const uint32 count = state->backend == AsyncIoBackend::IoRing
+                             ? state->PollIoRing(completions, maxCount)
+                             : state->PollCompletionPort(completions, maxCount, 0);
+    TraceCompletions(state->backend, completions, count);
+    state->inFlight -= count;
+    return count;
+}
+
+uint32 AsyncIo::WaitCompletions(AsyncIoCompletion* completions, uint32 maxCount)
+{
+    State* state = m_state;
+    if (state->inFlight == 0 || maxCount == 0)
+    {
+        return 0;
+    }
+
+    if (state->backend == AsyncIoBackend::CompletionPort)
+    {
+        const uint32 count = state->PollCompletionPort(completions, maxCount, INFINITE);
+        TraceCompletions(state->backend, completions, count);
+        state->inFlight -= count;
+        return count;
+    }
+
+    for (;;)
+    {
+        const uint32 count = PollCompletions(completions, maxCount);
+        if (count > 0)
+        {
+            return count;
+        }
+#if RSBL_HAS_IORING
+        // Submits nothing new, and waits for one completion
+        UINT32 submitted = 0;
+        state->ioRingApi.submit(state->ioRing, 1, INFINITE, &submitted);
+#endif
+    }
+}
+
+uint32 AsyncIo::InFlight() const
+{
+    return m_state->inFlight;
+}
+
+AsyncIoBackend AsyncIo::Backend() const
+{
+    return m_state->backend;
+}
+
+} // namespace rsbl
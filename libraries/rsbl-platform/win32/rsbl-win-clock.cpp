@@ -0,0 +1,58 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-clock.h"
+
+#include <windows.h>
+
+namespace
+{
+uint64 QueryFrequency()
+{
+    LARGE_INTEGER frequency;
+    ::QueryPerformanceFrequency(&frequency);
+    return static_cast<uint64>(frequency.QuadPart);
+}
+} // namespace
+
+namespace rsbl
+{
+
+uint64 Clock::NowTicks()
+{
+    LARGE_INTEGER counter;
+    ::QueryPerformanceCounter(&counter);
+    return static_cast<uint64>(counter.QuadPart);
+}
+
+uint64 Clock::TicksPerSecond()
+{
+    // Can't fail on anything since XP, and never changes while the system is running. Local
+    // static so timers in other static initializers still see it.
+    static const uint64 s_ticksPerSecond = QueryFrequency();
+    return s_ticksPerSecond;
+}
+
+uint64 Clock::TicksToNs(uint64 ticks)
+{
+    // Split so ticks * 1e9 can't overflow on long durations
+    const uint64 ticks_per_second = TicksPerSecond();
+    const uint64 seconds = ticks / ticks_per_second;
+    const uint64 remainder = ticks % ticks_per_second;
+    return seconds * 1'000'000'000ull + (remainder * 1'000'000'000ull) / ticks_per_second;
+}
+
+uint64 Clock::ThreadCpuNs()
+{
+    FILETIME creation, exit, kernel, user;
+    if (!::GetThreadTimes(::GetCurrentThread(), &creation, &exit, &kernel, &user))
+    {
+        return 0;
+    }
+    const uint64 kernel_100ns = (static_cast<uint64>(kernel.dwHighDateTime) << 32) |
+                                kernel.dwLowDateTime;
+    const uint64 user_100ns = (static_cast<uint64>(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return (kernel_100ns + user_100ns) * 100;
+}
+
+} // namespace rsbl
@@ -0,0 +1,146 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "../rsbl-cpu-topology-internal.h"
+
+#include <rsbl-dynamic-array.h>
+
+#include <windows.h>
+
+namespace rsbl::Internal
+{
+
+namespace
+{
+// Processor groups hold up to 64 processors, ids run on from one group to the next
+constexpr uint32 kGroupSize = 64;
+
+template <typename F>
+void ForEachInGroupMask(const GROUP_AFFINITY& mask, const F& visit)
+{
+    for (uint32 bit = 0; bit < kGroupSize; ++bit)
+    {
+        if ((static_cast<uint64>(mask.Mask) >> bit) & 1)
+        {
+            visit(static_cast<uint32>(mask.Group) * kGroupSize + bit);
+        }
+    }
+}
+
+constexpr uint32 kUnset = ~0u;
+} // namespace
+
+bool QueryCpuTopology(RawCpuTopology& raw)
+{
+    DWORD length = 0;
+    ::GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+    if (::GetLastError() != ERROR_INSUFFICIENT_BUFFER || length == 0)
+    {
+        return false;
+    }
+
+    DynamicArray<uint8> buffer;
+    buffer.Resize(length);
+    if (!::GetLogicalProcessorInformationEx(
+            RelationAll,
+            reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.Data()),
+            &length))
+    {
+        return false;
+    }
+
+    // Entries come by relation, not by processor, so collect per id first
+    const uint32 max_ids = static_cast<uint32>(::GetMaximumProcessorGroupCount()) * kGroupSize;
+    DynamicArray<RawLogicalProcessor> by_id;
+    by_id.Resize(max_ids);
+    DynamicArray<bool> present;
+    present.Resize(max_ids);
+    for (uint32 id = 0; id < max_ids; ++id)
+    {
+        by_id[id].id = id;
+        by_id[id].l2Key = kUnset;
+        by_id[id].l3Key = kUnset;
+        present[id] = false;
+    }
+
+    uint32 core_count = 0;
+    uint32 cache_count = 0;
+    for (DWORD offset = 0; offset < length;)
+    {
+        const auto* info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(
+            buffer.Data() + offset);
+        switch (info->Relationship)
+        {
+        case RelationProcessorCore:
+        {
+            const uint32 core = core_count++;
+            for (WORD group = 0; group < info->Processor.GroupCount; ++group)
+            {
+                ForEachInGroupMask(info->Processor.GroupMask[group], [&](uint32 id) {
+                    if (id < max_ids)
+                    {
+                        present[id] = true;
+                        by_id[id].coreKey = core;
+                        by_id[id].efficiencyClass = info->Processor.EfficiencyClass;
+                    }
+                });
+            }
+            break;
+        }
+        case RelationCache:
+        {
+            const CACHE_RELATIONSHIP& cache = info->Cache;
+            if ((cache.Level != 2 && cache.Level != 3) || cache.Type == CacheInstruction)
+            {
+                break;
+            }
+            const uint32 key = cache_count++;
+            ForEachInGroupMask(cache.GroupMask, [&](uint32 id) {
+                if (id < max_ids)
+                {
+                    (cache.Level == 2 ? by_id[id].l2Key : by_id[id].l3Key) = key;
+                }
+            });
+            (cache.Level == 2 ? raw.l2Bytes : raw.l3Bytes) = cache.CacheSize;
+            raw.cacheLineBytes = cache.LineSize;
+            break;
+        }
+        case RelationNumaNode:
+        {
+            const uint32 node = info->NumaNode.NodeNumber;
+            ForEachInGroupMask(info->NumaNode.GroupMask, [&](uint32 id) {
+                if (id < max_ids)
+                {
+                    by_id[id].numaNode = node;
+                }
+            });
+            break;
+        }
+        default:
+            break;
+        }
+        offset += info->Size;
+    }
+
+    for (uint32 id = 0; id < max_ids; ++id)
+    {
+        if (!present[id])
+        {
+            continue;
+        }
+        RawLogicalProcessor& processor = by_id[id];
+        // Cores with no cache entry get a private L2, the rest share one L3
+        if (processor.l2Key == kUnset)
+        {
+            processor.l2Key = kGroupSize * kGroupSize + processor.coreKey;
+        }
+        if (processor.l3Key == kUnset)
+        {
+            processor.l3Key = 0;
+        }
+        raw.logical.PushBack(processor);
+    }
+    return !raw.logical.IsEmpty();
+}
+
+} // namespace rsbl::Internal
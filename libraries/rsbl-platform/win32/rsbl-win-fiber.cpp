@@ -0,0 +1,105 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-fiber.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-memory-tracking.h>
+
+#include <windows.h>
+
+namespace rsbl
+{
+
+namespace
+{
+struct WinFiber
+{
+    void* handle = nullptr;
+    Fiber::EntryPoint entry = nullptr;
+    void* userData = nullptr;
+};
+
+void WINAPI FiberEntry(void* parameter)
+{
+    const WinFiber* fiber = static_cast<const WinFiber*>(parameter);
+    fiber->entry(fiber->userData);
+
+    // Returning from a fiber's start routine ends the whole thread
+    rsblAssertMsg(false, "Fiber entry points must never return");
+}
+} // namespace
+
+Result<UniquePtr<Fiber>> Fiber::Create(uint64 stackSize, EntryPoint entry, void* userData)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    WinFiber* data = new WinFiber{nullptr, entry, userData};
+    data->handle = ::CreateFiberEx(
+        static_cast<SIZE_T>(stackSize), static_cast<SIZE_T>(stackSize), 0, FiberEntry, data);
+    if (data->handle == nullptr)
+    {
+        const DWORD error = ::GetLastError();
+        delete data;
+        return FailureFormat(ErrorCategory::Platform, "CreateFiberEx failed: error %lu", error);
+    }
+
+    UniquePtr<Fiber> fiber(new Fiber());
+    fiber->m_platformData = data;
+    return rsblMove(fiber);
+}
+
+Result<UniquePtr<Fiber>> Fiber::FromCurrentThread()
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    if (::IsThreadAFiber())
+    {
+        return {ErrorCategory::InvalidArgument, "Thread is already a fiber"};
+    }
+
+    void* handle = ::ConvertThreadToFiberEx(nullptr, 0);
+    if (handle == nullptr)
+    {
+        return FailureFormat(
+            ErrorCategory::Platform, "ConvertThreadToFiberEx failed: error %lu", ::GetLastError());
+    }
+
+    UniquePtr<Fiber> fiber(new Fiber());
+    fiber->m_platformData = new WinFiber{handle, nullptr, nullptr};
+    fiber->m_isThread = true;
+    return rsblMove(fiber);
+}
+
+Fiber::~Fiber()
+{
+    WinFiber* data = static_cast<WinFiber*>(m_platformData);
+    if (data == nullptr)
+    {
+        return;
+    }
+
+    if (m_isThread)
+    {
+        rsblAssertMsg(::GetCurrentFiber() == data->handle, "Thread fibers end on their own thread");
+        const BOOL converted = ::ConvertFiberToThread();
+        rsblAssert(converted);
+    }
+    else
+    {
+        rsblAssertMsg(::GetCurrentFiber() != data->handle, "A fiber can't delete itself");
+        ::DeleteFiber(data->handle);
+    }
+    delete data;
+}
+
+void Fiber::SwitchTo(Fiber& target)
+{
+    const WinFiber* data = static_cast<const WinFiber*>(m_platformData);
+    const WinFiber* target_data = static_cast<const WinFiber*>(target.m_platformData);
+    rsblAssertMsg(::GetCurrentFiber() == data->handle,
+                  "SwitchTo has to come from the running fiber");
+    ::SwitchToFiber(target_data->handle);
+}
+
+} // namespace rsbl
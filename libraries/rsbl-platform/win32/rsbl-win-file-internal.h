@@ -0,0 +1,34 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-file.h"
+
+#include <windows.h>
+
+// Shared between OpenFile and AsyncIo::OpenForRead
+
+namespace rsbl::Internal
+{
+
+// The CreateFile flags and attributes for FileOpenFlags
+inline DWORD ToFlagsAndAttributes(FileOpenFlags flags)
+{
+    DWORD result = FILE_ATTRIBUTE_NORMAL;
+    if (HasFlag(flags, FileOpenFlags::Unbuffered))
+    {
+        result |= FILE_FLAG_NO_BUFFERING;
+    }
+    if (HasFlag(flags, FileOpenFlags::SequentialScan))
+    {
+        result |= FILE_FLAG_SEQUENTIAL_SCAN;
+    }
+    if (HasFlag(flags, FileOpenFlags::RandomAccess))
+    {
+        result |= FILE_FLAG_RANDOM_ACCESS;
+    }
+    return result;
+}
+
+} // namespace rsbl::Internal
@@ -0,0 +1,235 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "../rsbl-file-watcher-internal.h"
+
+#include <rsbl-memory-tracking.h>
+
+#include <windows.h>
+
+namespace rsbl::Internal
+{
+
+namespace
+{
+constexpr DWORD kNotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                                FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+// Past 64 KB, ReadDirectoryChangesW fails on network shares
+constexpr DWORD kNotifyBufferSize = 64 * 1024;
+
+// The longest path ReadDirectoryChangesW reports, in UTF-8
+constexpr int kMaxPathBytes = 4 * 32768;
+} // namespace
+
+struct FileWatchSource::State
+{
+    HANDLE directory = INVALID_HANDLE_VALUE;
+    HANDLE stopEvent = nullptr;
+    OVERLAPPED overlapped = {};
+    bool recursive = false;
+    bool pending = false;
+    String root;
+
+    // FILE_NOTIFY_INFORMATION records are DWORD aligned
+    alignas(DWORD) uint8 buffer[kNotifyBufferSize];
+    char path[kMaxPathBytes];
+
+    bool Issue()
+    {
+        pending = ReadDirectoryChangesW(directory,
+                                        buffer,
+                                        sizeof(buffer),
+                                        recursive ? TRUE : FALSE,
+                                        kNotifyFilter,
+                                        nullptr,
+                                        &overlapped,
+                                        nullptr) != FALSE;
+        return pending;
+    }
+
+    // MODIFIED also fires for a directory whose contents changed, only files matter here
+    bool IsDirectory(StringView relative)
+    {
+        String full(root.View(), GetTaggedAllocator(MemoryTag::Platform));
+        full.Append('/');
+        full.Append(relative);
+        const DWORD attributes = GetFileAttributesA(full.CStr());
+        return attributes != INVALID_FILE_ATTRIBUTES &&
+               (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    }
+
+    void Dispatch(const FILE_NOTIFY_INFORMATION& info,
+                  FunctionRef<void(RawFileEvent, StringView)> sink)
+    {
+        const int size = WideCharToMultiByte(CP_UTF8,
+                                             0,
+                                             info.FileName,
+                                             static_cast<int>(info.FileNameLength / sizeof(WCHAR)),
+                                             path,
+                                             sizeof(path),
+                                             nullptr,
+                                             nullptr);
+        if (size <= 0)
+        {
+            return;
+        }
+        for (int i = 0; i < size; ++i)
+        {
+            if (path[i] == '\\')
+            {
+                path[i] = '/';
+            }
+        }
+        const StringView relative(path, static_cast<uint64>(size));
+
+        switch (info.Action)
+        {
+        case FILE_ACTION_ADDED:
+        case FILE_ACTION_RENAMED_NEW_NAME:
+            if (!IsDirectory(relative))
+            {
+                sink(RawFileEvent::Added, relative);
+            }
+            break;
+        case FILE_ACTION_REMOVED:
+        case FILE_ACTION_RENAMED_OLD_NAME:
+            sink(RawFileEvent::Removed, relative);
+            break;
+        case FILE_ACTION_MODIFIED:
+            if (!IsDirectory(relative))
+            {
+                sink(RawFileEvent::Modified, relative);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+};
+
+Result<UniquePtr<FileWatchSource>> FileWatchSource::Open(const char* directory, bool recursive)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    const HANDLE handle = CreateFileA(directory,
+                                      FILE_LIST_DIRECTORY,
+                                      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                      nullptr,
+                                      OPEN_EXISTING,
+                                      FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                                      nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        const DWORD error = GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+        {
+            return {ErrorCategory::NotFound, "Failed to open directory"};
+        }
+        return {ErrorCategory::Io, "Failed to open directory"};
+    }
+
+    UniquePtr<FileWatchSource> source(new FileWatchSource());
+    source->m_state = new State();
+
+    State* state = source->m_state;
+    state->directory = handle;
+    state->recursive = recursive;
+    state->root = directory;
+    state->stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    state->overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (state->stopEvent == nullptr || state->overlapped.hEvent == nullptr)
+    {
+        return {ErrorCategory::Platform, "Failed to create watch events"};
+    }
+
+    // Fails on a path that isn't a directory
+    if (!state->Issue())
+    {
+        return {ErrorCategory::InvalidArgument, "Failed to watch directory"};
+    }
+
+    return rsblMove(source);
+}
+
+FileWatchSource::~FileWatchSource()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+
+    State* state = m_state;
+    if (state->pending)
+    {
+        // The kernel writes into the buffer until the cancelled read completes
+        CancelIoEx(state->directory, &state->overlapped);
+        DWORD bytes = 0;
+        GetOverlappedResult(state->directory, &state->overlapped, &bytes, TRUE);
+    }
+    if (state->directory != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(state->directory);
+    }
+    if (state->overlapped.hEvent != nullptr)
+    {
+        CloseHandle(state->overlapped.hEvent);
+    }
+    if (state->stopEvent != nullptr)
+    {
+        CloseHandle(state->stopEvent);
+    }
+    delete state;
+}
+
+bool FileWatchSource::Wait(uint32 timeoutMs, FunctionRef<void(RawFileEvent, StringView)> sink)
+{
+    State* state = m_state;
+
+    const HANDLE handles[2] = {state->stopEvent, state->overlapped.hEvent};
+    const DWORD timeout = timeoutMs == kWaitForever ? INFINITE : timeoutMs;
+    const DWORD signalled = WaitForMultipleObjects(2, handles, FALSE, timeout);
+    if (signalled == WAIT_OBJECT_0)
+    {
+        return false;
+    }
+    if (signalled != WAIT_OBJECT_0 + 1)
+    {
+        return signalled == WAIT_TIMEOUT;
+    }
+
+    DWORD bytes = 0;
+    const BOOL succeeded = GetOverlappedResult(state->directory, &state->overlapped, &bytes, FALSE);
+    state->pending = false;
+    ResetEvent(state->overlapped.hEvent);
+
+    if (!succeeded || bytes == 0)
+    {
+        // The buffer overflowed and the OS threw the events away
+        sink(RawFileEvent::Overflow, StringView());
+    }
+    else
+    {
+        for (DWORD offset = 0;;)
+        {
+            const FILE_NOTIFY_INFORMATION& info =
+                *reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(state->buffer + offset);
+            state->Dispatch(info, sink);
+            if (info.NextEntryOffset == 0)
+            {
+                break;
+            }
+            offset += info.NextEntryOffset;
+        }
+    }
+
+    // Events between the last read and this one queue up in the kernel meanwhile
+    return state->Issue();
+}
+
+void FileWatchSource::Stop()
+{
+    SetEvent(m_state->stopEvent);
+}
+
+} // namespace rsbl::Internal
@@ -3,13 +3,54 @@
 
 #include "rsbl-file.h"
 
+#include "rsbl-win-file-internal.h"
+
+#include <rsbl-counters.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-profile.h>
+#include <rsbl-string.h>
+
 #include <windows.h>
 
+#include <winioctl.h>
+
 namespace rsbl
 {
 
-Result<FileHandle> OpenFile(const char* path, FileOpenMode mode)
+namespace
 {
+// Biggest transfer handed to Windows in one call. It takes a DWORD, but a round 1 GB keeps
+// every piece sector aligned, which unbuffered handles need.
+constexpr uint64 kMaxTransfer = 1ull << 30;
+
+DWORD ClampTransfer(uint64 size)
+{
+    return static_cast<DWORD>(size < kMaxTransfer ? size : kMaxTransfer);
+}
+
+uint64 CombineHighLow(DWORD high, DWORD low)
+{
+    return (static_cast<uint64>(high) << 32) | low;
+}
+
+// FILETIMEs count 100ns from 1601
+int64 ToUnixNanoseconds(const FILETIME& time)
+{
+    constexpr int64 kUnixEpoch = 116444736000000000;
+    const int64 ticks =
+        static_cast<int64>(CombineHighLow(time.dwHighDateTime, time.dwLowDateTime));
+    return (ticks - kUnixEpoch) * 100;
+}
+
+bool IsDotOrDotDot(const char* name)
+{
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+} // namespace
+
+Result<FileHandle> OpenFile(const char* path, FileOpenMode mode, FileOpenFlags flags)
+{
+    RSBL_PROFILE_ZONE("OpenFile");
     DWORD desiredAccess = 0;
     DWORD creationDisposition = 0;
 
@@ -42,12 +83,17 @@ Result<FileHandle> OpenFile(const char* path, FileOpenMode mode)
                                 FILE_SHARE_READ, // Allow other processes to read
                                 nullptr,         // Default security
                                 creationDisposition,
-                                FILE_ATTRIBUTE_NORMAL,
+                                Internal::ToFlagsAndAttributes(flags),
                                 nullptr); // No template file
 
     if (handle == INVALID_HANDLE_VALUE)
     {
-        return "Failed to open file";
+        const DWORD error = GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+        {
+            return {ErrorCategory::NotFound, "Failed to open file"};
+        }
+        return {ErrorCategory::Io, "Failed to open file"};
     }
 
     // return Result<FileHandle>(reinterpret_cast<FileHandle>(handle));
@@ -60,39 +106,81 @@ Result<> CloseFile(FileHandle handle)
 
     if (!::CloseHandle(win_handle))
     {
-        return "Failed to close file";
+        return {ErrorCategory::Io, "Failed to close file"};
     }
 
     return ResultCode::Success;
 }
 
-Result<uint64> WriteFile(FileHandle handle, const void* buffer, uint64 num_bytes_to_write)
+Result<uint64> WriteFile(FileHandle handle, ByteView data)
 {
+    RSBL_PROFILE_ZONE("WriteFile");
     HANDLE winHandle = reinterpret_cast<HANDLE>(handle);
-    DWORD bytesWritten = 0;
 
-    // Windows API uses DWORD (32-bit) for write size
-    if (num_bytes_to_write > MAXDWORD)
+    // Windows API uses DWORD (32-bit) for write size, bigger writes go in pieces
+    uint64 written = 0;
+    while (written < data.Size())
     {
-        return "Write size exceeds maximum supported by Windows API";
+        DWORD bytesWritten = 0;
+        const BOOL success = ::WriteFile(winHandle,
+                                         data.Data() + written,
+                                         ClampTransfer(data.Size() - written),
+                                         &bytesWritten,
+                                         nullptr); // Not using overlapped I/O
+
+        if (!success)
+        {
+            return {ErrorCategory::Io, "Failed to write to file"};
+        }
+        written += bytesWritten;
     }
 
-    BOOL success = ::WriteFile(winHandle,
-                               buffer,
-                               static_cast<DWORD>(num_bytes_to_write),
-                               &bytesWritten,
-                               nullptr); // Not using overlapped I/O
+    RSBL_COUNTER_ADD("io.write_bytes", written);
+    return written;
+}
 
-    if (!success)
+// Windows' WriteFileGather and ReadFileScatter only take unbuffered, overlapped handles and one
+// page per buffer, which rules out ordinary files. One call per buffer still copies nothing, and
+// counts the bytes.
+Result<uint64> WriteFileGather(FileHandle handle, ArrayView<const ByteView> buffers)
+{
+    RSBL_PROFILE_ZONE("WriteFileGather");
+    uint64 total = 0;
+    for (const ByteView& buffer : buffers)
     {
-        return "Failed to write to file";
+        Result<uint64> written = WriteFile(handle, buffer);
+        if (!written)
+        {
+            return written;
+        }
+        total += written.Value();
     }
+    return total;
+}
 
-    return Result<uint64>(static_cast<uint64>(bytesWritten));
+Result<uint64> ReadFileScatter(FileHandle handle, ArrayView<const MutableByteView> buffers)
+{
+    RSBL_PROFILE_ZONE("ReadFileScatter");
+    uint64 total = 0;
+    for (const MutableByteView& buffer : buffers)
+    {
+        Result<uint64> read = ReadFile(handle, buffer);
+        if (!read)
+        {
+            return read;
+        }
+        total += read.Value();
+        if (read.Value() < buffer.Size())
+        {
+            break;
+        }
+    }
+    return total;
 }
 
-Result<uint64> ReadFile(FileHandle handle, void* buffer, uint64 num_bytes_to_read, uint64 offset)
+Result<uint64> ReadFile(FileHandle handle, MutableByteView buffer, uint64 offset)
 {
+    RSBL_PROFILE_ZONE("ReadFile");
     HANDLE win_handle = reinterpret_cast<HANDLE>(handle);
 
     // Interestingly, Spectre mitigation cares if this is range checked (> 0)
@@ -106,43 +194,115 @@ Result<uint64> ReadFile(FileHandle handle, void* buffer, uint64 num_bytes_to_rea
 
         if (!SetFilePointerEx(win_handle, liOffset, nullptr, FILE_BEGIN))
         {
-            return "Failed to seek to offset";
+            return {ErrorCategory::Io, "Failed to seek to offset"};
         }
     }
 
-    DWORD bytesRead = 0;
+    // Windows API uses DWORD (32-bit) for read size, so large reads go in pieces until the
+    // buffer is full or the file ends
+    uint64 total = 0;
+    while (total < buffer.Size())
+    {
+        DWORD bytesRead = 0;
+        const BOOL success = ::ReadFile(win_handle,
+                                        buffer.Data() + total,
+                                        ClampTransfer(buffer.Size() - total),
+                                        &bytesRead,
+                                        nullptr); // Not using overlapped I/O
+
+        if (!success)
+        {
+            return {ErrorCategory::Io, "Failed to read from file"};
+        }
+        if (bytesRead == 0)
+        {
+            break;
+        }
+        total += bytesRead;
+    }
+
+    RSBL_COUNTER_ADD("io.read_bytes", total);
+    return total;
+}
+
+Result<uint64> ReadFileAt(FileHandle handle, MutableByteView buffer, uint64 offset)
+{
+    RSBL_PROFILE_ZONE("ReadFileAt");
+    HANDLE win_handle = reinterpret_cast<HANDLE>(handle);
 
-    // Windows API uses DWORD (32-bit) for read size, so we need to handle large reads
-    if (num_bytes_to_read > MAXDWORD)
+    // An OVERLAPPED with an offset reads from there on a synchronous handle too, and the I/O
+    // manager serializes the calls on it, so nothing depends on a shared seek.
+    uint64 total = 0;
+    while (total < buffer.Size())
     {
-        return "Read size exceeds maximum supported by Windows API";
+        const DWORD chunk = ClampTransfer(buffer.Size() - total);
+        const uint64 position = offset + total;
+
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(position);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+        DWORD bytes_read = 0;
+        if (!::ReadFile(win_handle, buffer.Data() + total, chunk, &bytes_read, &overlapped))
+        {
+            if (GetLastError() == ERROR_HANDLE_EOF)
+            {
+                break;
+            }
+            return {ErrorCategory::Io, "Failed to read from file"};
+        }
+        if (bytes_read == 0)
+        {
+            break;
+        }
+        total += bytes_read;
     }
 
-    const BOOL success = ::ReadFile(win_handle,
-                                    buffer,
-                                    static_cast<DWORD>(num_bytes_to_read),
-                                    &bytesRead,
-                                    nullptr); // Not using overlapped I/O
+    RSBL_COUNTER_ADD("io.read_bytes", total);
+    return total;
+}
+
+Result<uint64> WriteFileAt(FileHandle handle, ByteView data, uint64 offset)
+{
+    RSBL_PROFILE_ZONE("WriteFileAt");
+    HANDLE win_handle = reinterpret_cast<HANDLE>(handle);
 
-    if (!success)
+    uint64 written = 0;
+    while (written < data.Size())
     {
-        return "Failed to read from file";
+        const uint64 position = offset + written;
+
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(position);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+        DWORD bytes_written = 0;
+        if (!::WriteFile(win_handle,
+                         data.Data() + written,
+                         ClampTransfer(data.Size() - written),
+                         &bytes_written,
+                         &overlapped))
+        {
+            return {ErrorCategory::Io, "Failed to write to file"};
+        }
+        written += bytes_written;
     }
 
-    return static_cast<uint64>(bytesRead);
+    RSBL_COUNTER_ADD("io.write_bytes", written);
+    return written;
 }
 
-Result<uint64> OpenAndReadFile(const char* path, void* buffer, uint64 num_bytes_to_read)
+Result<uint64> OpenAndReadFile(const char* path, MutableByteView buffer)
 {
     auto openResult = rsbl::OpenFile(path, FileOpenMode::Read);
     if (openResult.Code() != ResultCode::Success)
     {
-        return "Failed to open file for reading";
+        return {openResult.Category(), "Failed to open file for reading"};
     }
 
     FileHandle handle = openResult.Value();
 
-    auto readResult = rsbl::ReadFile(handle, buffer, num_bytes_to_read);
+    auto readResult = rsbl::ReadFile(handle, buffer);
 
     // Always try to close, even if read failed
     auto closeResult = rsbl::CloseFile(handle);
@@ -155,10 +315,347 @@ Result<uint64> OpenAndReadFile(const char* path, void* buffer, uint64 num_bytes_
 
     if (closeResult.Code() != ResultCode::Success)
     {
-        return "Read succeeded but failed to close file";
+        return {ErrorCategory::Io, "Read succeeded but failed to close file"};
     }
 
     return readResult;
 }
 
+Result<uint64> GetFileSize(FileHandle handle)
+{
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(reinterpret_cast<HANDLE>(handle), &size))
+    {
+        return {ErrorCategory::Io, "Failed to get file size"};
+    }
+    return static_cast<uint64>(size.QuadPart);
+}
+
+Result<> SetFileSize(FileHandle handle, uint64 size)
+{
+    HANDLE win_handle = reinterpret_cast<HANDLE>(handle);
+
+    // Without the sparse flag NTFS writes out zeros for everything the file grows by. Not every
+    // file system has it (FAT), the file then just isn't sparse.
+    DWORD returned = 0;
+    (void)DeviceIoControl(
+        win_handle, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &returned, nullptr);
+
+    FILE_END_OF_FILE_INFO end = {};
+    end.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFileInformationByHandle(win_handle, FileEndOfFileInfo, &end, sizeof(end)))
+    {
+        return {ErrorCategory::Io, "Failed to set file size"};
+    }
+    return ResultCode::Success;
+}
+
+Result<FileInfo> GetFileInfo(const char* path)
+{
+    WIN32_FILE_ATTRIBUTE_DATA data = {};
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data))
+    {
+        const DWORD error = GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+        {
+            return {ErrorCategory::NotFound, "No file at path"};
+        }
+        return {ErrorCategory::Io, "Failed to get file info"};
+    }
+
+    FileInfo info;
+    info.size = CombineHighLow(data.nFileSizeHigh, data.nFileSizeLow);
+    info.modifiedTime = ToUnixNanoseconds(data.ftLastWriteTime);
+    info.isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    return info;
+}
+
+Result<> MakeDirectory(const char* path)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    // Each parent in turn, cutting the path short at its separators. A drive ("C:") already
+    // exists, so failing on it with ERROR_ACCESS_DENIED is fine as long as the end succeeds.
+    String prefix(path);
+    for (uint64 i = 1; i < prefix.Size(); ++i)
+    {
+        const char separator = prefix[i];
+        if (separator != '/' && separator != '\\')
+        {
+            continue;
+        }
+        prefix[i] = '\0';
+        CreateDirectoryA(prefix.CStr(), nullptr);
+        prefix[i] = separator;
+    }
+    if (!CreateDirectoryA(path, nullptr) && GetLastError() != ERROR_ALREADY_EXISTS)
+    {
+        return {ErrorCategory::Io, "Failed to create directory"};
+    }
+
+    const DWORD attributes = GetFileAttributesA(path);
+    if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        return {ErrorCategory::Io, "Path exists and isn't a directory"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> RenameFile(const char* old_path, const char* new_path)
+{
+    if (!MoveFileExA(old_path, new_path, MOVEFILE_REPLACE_EXISTING))
+    {
+        const DWORD error = GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+        {
+            return {ErrorCategory::NotFound, "No file at path"};
+        }
+        return {ErrorCategory::Io, "Failed to rename file"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> RemoveFile(const char* path)
+{
+    if (!DeleteFileA(path))
+    {
+        const DWORD error = GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+        {
+            return {ErrorCategory::NotFound, "No file at path"};
+        }
+        return {ErrorCategory::Io, "Failed to remove file"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> DropFileCache(const char* path)
+{
+    // There's no call for it, but a non-cached open has the cache manager flush and purge the
+    // file's pages, so its reads stay coherent with the cached ones
+    HANDLE file = CreateFileA(path,
+                              GENERIC_READ,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_FLAG_NO_BUFFERING,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        const DWORD error = GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+        {
+            return {ErrorCategory::NotFound, "No file at path"};
+        }
+        return {ErrorCategory::Io, "Failed to open file"};
+    }
+    CloseHandle(file);
+    return ResultCode::Success;
+}
+
+struct DirectoryIterator::State
+{
+    // INVALID_HANDLE_VALUE for a directory with nothing in it
+    HANDLE find = INVALID_HANDLE_VALUE;
+    WIN32_FIND_DATAA data = {};
+    // FindFirstFileEx already returned the first entry, Next hands it out before moving on
+    bool firstPending = false;
+    bool hasCurrent = false;
+};
+
+Result<UniquePtr<DirectoryIterator>> DirectoryIterator::Open(const char* path)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    String pattern(path);
+    if (!pattern.IsEmpty() && pattern[pattern.Size() - 1] != '\\' &&
+        pattern[pattern.Size() - 1] != '/')
+    {
+        pattern.Append('\\');
+    }
+    pattern.Append('*');
+
+    UniquePtr<DirectoryIterator> iterator(new DirectoryIterator());
+    iterator->m_state = new State();
+    State* state = iterator->m_state;
+
+    // Basic info skips the 8.3 short names, the large fetch asks for bigger batches
+    state->find = FindFirstFileExA(pattern.CStr(),
+                                   FindExInfoBasic,
+                                   &state->data,
+                                   FindExSearchNameMatch,
+                                   nullptr,
+                                   FIND_FIRST_EX_LARGE_FETCH);
+    if (state->find == INVALID_HANDLE_VALUE)
+    {
+        const DWORD error = GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND)
+        {
+            // Nothing matched, not even "." (only the root of a drive has no dot entries)
+            return rsblMove(iterator);
+        }
+        if (error == ERROR_PATH_NOT_FOUND)
+        {
+            return {ErrorCategory::NotFound, "Failed to open directory"};
+        }
+        if (error == ERROR_DIRECTORY)
+        {
+            return {ErrorCategory::InvalidArgument, "Path isn't a directory"};
+        }
+        return {ErrorCategory::Io, "Failed to open directory"};
+    }
+    state->firstPending = true;
+    return rsblMove(iterator);
+}
+
+DirectoryIterator::~DirectoryIterator()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+    if (m_state->find != INVALID_HANDLE_VALUE)
+    {
+        FindClose(m_state->find);
+    }
+    delete m_state;
+}
+
+bool DirectoryIterator::Next(DirectoryEntry& entry)
+{
+    State* state = m_state;
+    state->hasCurrent = false;
+    if (state->find == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    for (;;)
+    {
+        if (state->firstPending)
+        {
+            state->firstPending = false;
+        }
+        else if (!FindNextFileA(state->find, &state->data))
+        {
+            return false;
+        }
+
+        if (IsDotOrDotDot(state->data.cFileName))
+        {
+            continue;
+        }
+
+        state->hasCurrent = true;
+        entry.name = state->data.cFileName;
+        entry.isDirectory = (state->data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        return true;
+    }
+}
+
+Result<FileInfo> DirectoryIterator::CurrentInfo() const
+{
+    if (!m_state->hasCurrent)
+    {
+        return {ErrorCategory::InvalidArgument, "No current directory entry"};
+    }
+
+    const WIN32_FIND_DATAA& data = m_state->data;
+    FileInfo info;
+    info.size = CombineHighLow(data.nFileSizeHigh, data.nFileSizeLow);
+    info.modifiedTime = ToUnixNanoseconds(data.ftLastWriteTime);
+    info.isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    return info;
+}
+
+Result<MappedFile> MapFile(const char* path, FileMapAccess access)
+{
+    RSBL_PROFILE_ZONE("MapFile");
+    const bool writable = access == FileMapAccess::ReadWrite;
+    HANDLE file = CreateFileA(path,
+                              writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        const DWORD error = GetLastError();
+        if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND)
+        {
+            return {ErrorCategory::NotFound, "Failed to open file for mapping"};
+        }
+        return {ErrorCategory::Io, "Failed to open file for mapping"};
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return {ErrorCategory::Io, "Failed to get the size of the file to map"};
+    }
+
+    MappedFile mapped;
+    mapped.m_writable = writable;
+
+    // CreateFileMapping refuses empty files, they get an empty view instead
+    if (size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(
+            file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return {ErrorCategory::Io, "Failed to create file mapping"};
+        }
+
+        // The view keeps the mapping and the file open, neither handle is needed after this
+        void* data = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (data == nullptr)
+        {
+            CloseHandle(file);
+            return {ErrorCategory::Io, "Failed to map file"};
+        }
+        mapped.m_data = static_cast<uint8*>(data);
+        mapped.m_size = static_cast<uint64>(size.QuadPart);
+    }
+
+    CloseHandle(file);
+    return mapped;
+}
+
+void MappedFile::Prefetch(uint64 offset, uint64 size) const
+{
+    if (offset >= m_size)
+    {
+        return;
+    }
+
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = m_data + offset;
+    range.NumberOfBytes = static_cast<SIZE_T>(size > m_size - offset ? m_size - offset : size);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+Result<> MappedFile::Flush()
+{
+    if (m_data != nullptr && m_writable && !FlushViewOfFile(m_data, 0))
+    {
+        return {ErrorCategory::Io, "Failed to flush mapped file"};
+    }
+    return ResultCode::Success;
+}
+
+void MappedFile::Unmap()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
 } // namespace rsbl
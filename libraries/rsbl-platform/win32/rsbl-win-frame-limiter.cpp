@@ -0,0 +1,67 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-frame-limiter.h"
+
+#include <rsbl-log.h>
+
+#include <windows.h>
+
+// Windows 10 1803 on, older SDKs don't have it
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+    #define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace rsbl
+{
+
+namespace
+{
+// A high resolution timer wakes within a few hundred microseconds
+constexpr uint64 kHighResolutionMinSpinNs = 300'000;
+// Anything else wakes on the scheduler's tick, 15.6ms unless someone has raised the timer
+// resolution. Spinning starts at 2ms and grows to what the sleeps really overshoot by.
+constexpr uint64 kTickMinSpinNs = 2'000'000;
+} // namespace
+
+Result<> FrameLimiter::CreatePlatformTimer()
+{
+    HANDLE timer = CreateWaitableTimerExW(
+        nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    m_minSpinNs = kHighResolutionMinSpinNs;
+    if (timer == nullptr)
+    {
+        RSBL_LOG_WARNING("No high resolution timer, frame limiting will spin more");
+        timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+        m_minSpinNs = kTickMinSpinNs;
+    }
+    if (timer == nullptr)
+    {
+        return {ErrorCategory::Platform, "Failed to create a waitable timer"};
+    }
+    m_timer = timer;
+    return ResultCode::Success;
+}
+
+void FrameLimiter::DestroyPlatformTimer()
+{
+    if (m_timer != nullptr)
+    {
+        CloseHandle(static_cast<HANDLE>(m_timer));
+        m_timer = nullptr;
+    }
+}
+
+void FrameLimiter::SleepFor(uint64 ns)
+{
+    // Negative is relative, in 100ns units
+    LARGE_INTEGER due;
+    due.QuadPart = -static_cast<LONGLONG>(ns / 100);
+    HANDLE timer = static_cast<HANDLE>(m_timer);
+    if (SetWaitableTimerEx(timer, &due, 0, nullptr, nullptr, nullptr, 0))
+    {
+        WaitForSingleObject(timer, INFINITE);
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,143 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "../rsbl-power-internal.h"
+
+#include <rsbl-dynamic-array.h>
+
+#include <windows.h>
+
+#include <powerbase.h>
+#include <powersetting.h>
+
+namespace rsbl::Internal
+{
+
+namespace
+{
+// BatteryFlag with no system battery
+constexpr BYTE kNoSystemBattery = 128;
+
+// What CallNtPowerInformation's ProcessorInformation fills one of per processor. The SDK
+// documents it but doesn't declare it.
+struct ProcessorPowerInformation
+{
+    ULONG number;
+    ULONG maxMhz;
+    ULONG currentMhz;
+    ULONG mhzLimit;
+    ULONG maxIdleState;
+    ULONG currentIdleState;
+};
+
+// The lowest limit among the processors against their rated maximum. mhzLimit drops while
+// the processor is held back by heat or a power cap.
+uint32 ReadCpuSpeedPercent()
+{
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    DynamicArray<ProcessorPowerInformation> processors;
+    processors.Resize(info.dwNumberOfProcessors);
+    const ULONG bytes =
+        static_cast<ULONG>(processors.Size() * sizeof(ProcessorPowerInformation));
+    if (::CallNtPowerInformation(ProcessorInformation, nullptr, 0, processors.Data(), bytes) !=
+        0)
+    {
+        return 0;
+    }
+
+    uint32 slowest = 0;
+    for (const ProcessorPowerInformation& processor : processors)
+    {
+        if (processor.maxMhz == 0)
+        {
+            continue;
+        }
+        uint32 percent = static_cast<uint32>(uint64(processor.mhzLimit) * 100 / processor.maxMhz);
+        percent = percent > 100 ? 100 : percent;
+        slowest = slowest == 0 || percent < slowest ? percent : slowest;
+    }
+    return slowest;
+}
+
+PowerMode ToPowerMode(EFFECTIVE_POWER_MODE mode)
+{
+    switch (mode)
+    {
+    case EffectivePowerModeBatterySaver:
+        return PowerMode::BatterySaver;
+    case EffectivePowerModeBetterBattery:
+        return PowerMode::BetterBattery;
+    case EffectivePowerModeBalanced:
+        return PowerMode::Balanced;
+    case EffectivePowerModeHighPerformance:
+        return PowerMode::HighPerformance;
+    case EffectivePowerModeMaxPerformance:
+        return PowerMode::MaxPerformance;
+    case EffectivePowerModeGameMode:
+        return PowerMode::GameMode;
+    default:
+        return PowerMode::Unknown;
+    }
+}
+
+VOID WINAPI OnEffectivePowerMode(EFFECTIVE_POWER_MODE mode, VOID* context)
+{
+    PowerModeSink* sink = static_cast<PowerModeSink*>(context);
+    sink->mode.store(ToPowerMode(mode), std::memory_order_release);
+    sink->changed.Set();
+}
+} // namespace
+
+PowerState ReadPowerState()
+{
+    PowerState state;
+
+    SYSTEM_POWER_STATUS status;
+    if (::GetSystemPowerStatus(&status))
+    {
+        const bool has_battery = (status.BatteryFlag & kNoSystemBattery) == 0;
+        if (status.ACLineStatus == 1 || (status.ACLineStatus != 255 && !has_battery))
+        {
+            state.source = PowerSource::Mains;
+        }
+        else if (status.ACLineStatus == 0)
+        {
+            state.source = PowerSource::Battery;
+        }
+        if (has_battery && status.BatteryLifePercent <= 100)
+        {
+            state.batteryPercent = status.BatteryLifePercent;
+        }
+        // The only mode it tells, the rest come through the notifications
+        if (status.SystemStatusFlag == 1)
+        {
+            state.mode = PowerMode::BatterySaver;
+        }
+    }
+
+    state.cpuSpeedPercent = ReadCpuSpeedPercent();
+    return state;
+}
+
+void* StartPowerModeNotifications(PowerModeSink& sink)
+{
+    // Windows 10 1809 and later. V2 adds game mode.
+    void* registration = nullptr;
+    if (FAILED(::PowerRegisterForEffectivePowerModeNotifications(
+            EFFECTIVE_POWER_MODE_V2, &OnEffectivePowerMode, &sink, &registration)))
+    {
+        return nullptr;
+    }
+    return registration;
+}
+
+void StopPowerModeNotifications(void* registration)
+{
+    if (registration != nullptr)
+    {
+        ::PowerUnregisterFromEffectivePowerModeNotifications(registration);
+    }
+}
+
+} // namespace rsbl::Internal
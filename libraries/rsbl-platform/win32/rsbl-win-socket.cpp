@@ -0,0 +1,254 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-socket.h"
+
+#include <rsbl-counters.h>
+#include <rsbl-profile.h>
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+#include <cstdio>
+
+namespace rsbl
+{
+
+namespace
+{
+// Winsock needs starting once per process before anything else, and is left running
+bool StartWinsock()
+{
+    static const bool started = []() {
+        WSADATA data = {};
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+
+SOCKET ToSocket(SocketHandle socket)
+{
+    return static_cast<SOCKET>(socket);
+}
+
+// send and recv take an int
+int ClampTransfer(uint64 size)
+{
+    constexpr uint64 kMaxTransfer = 1ull << 30;
+    return static_cast<int>(size < kMaxTransfer ? size : kMaxTransfer);
+}
+
+void SetOptions(SOCKET socket)
+{
+    const BOOL on = TRUE;
+    (void)setsockopt(
+        socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+}
+
+void SetTimeouts(SOCKET socket, uint32 timeout_ms)
+{
+    const DWORD timeout = timeout_ms;
+    const char* value = reinterpret_cast<const char*>(&timeout);
+    (void)setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, value, sizeof(timeout));
+    (void)setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, value, sizeof(timeout));
+}
+
+// Connects without blocking so the wait can time out, then puts the socket back to blocking
+bool ConnectWithTimeout(SOCKET socket, const sockaddr* address, int size, uint32 timeout_ms)
+{
+    u_long non_blocking = 1;
+    if (ioctlsocket(socket, FIONBIO, &non_blocking) != 0)
+    {
+        return false;
+    }
+
+    if (::connect(socket, address, size) != 0)
+    {
+        if (WSAGetLastError() != WSAEWOULDBLOCK)
+        {
+            return false;
+        }
+        WSAPOLLFD poll_fd = {socket, POLLWRNORM, 0};
+        if (WSAPoll(&poll_fd, 1, static_cast<INT>(timeout_ms)) <= 0 ||
+            (poll_fd.revents & (POLLERR | POLLHUP)) != 0)
+        {
+            return false;
+        }
+    }
+
+    non_blocking = 0;
+    return ioctlsocket(socket, FIONBIO, &non_blocking) == 0;
+}
+} // namespace
+
+Result<SocketHandle> ConnectSocket(const char* host, uint16 port, uint32 timeout_ms)
+{
+    RSBL_PROFILE_ZONE("ConnectSocket");
+    if (!StartWinsock())
+    {
+        return {ErrorCategory::Platform, "Failed to start Winsock"};
+    }
+
+    char service[8];
+    std::snprintf(service, sizeof(service), "%u", static_cast<unsigned>(port));
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host, service, &hints, &addresses) != 0)
+    {
+        return {ErrorCategory::NotFound, "Failed to resolve host"};
+    }
+
+    SOCKET socket = INVALID_SOCKET;
+    for (addrinfo* address = addresses; address != nullptr; address = address->ai_next)
+    {
+        // Not inherited by processes started from here, like files
+        socket = WSASocketW(address->ai_family,
+                            address->ai_socktype,
+                            address->ai_protocol,
+                            nullptr,
+                            0,
+                            WSA_FLAG_OVERLAPPED | WSA_FLAG_NO_HANDLE_INHERIT);
+        if (socket == INVALID_SOCKET)
+        {
+            continue;
+        }
+        if (ConnectWithTimeout(
+                socket, address->ai_addr, static_cast<int>(address->ai_addrlen), timeout_ms))
+        {
+            break;
+        }
+        closesocket(socket);
+        socket = INVALID_SOCKET;
+    }
+    freeaddrinfo(addresses);
+
+    if (socket == INVALID_SOCKET)
+    {
+        return {ErrorCategory::Io, "Failed to connect"};
+    }
+    SetOptions(socket);
+    SetTimeouts(socket, timeout_ms);
+    return static_cast<SocketHandle>(socket);
+}
+
+Result<SocketHandle> ListenSocket(uint16 port, bool all_interfaces)
+{
+    if (!StartWinsock())
+    {
+        return {ErrorCategory::Platform, "Failed to start Winsock"};
+    }
+
+    const SOCKET socket = WSASocketW(AF_INET,
+                                     SOCK_STREAM,
+                                     IPPROTO_TCP,
+                                     nullptr,
+                                     0,
+                                     WSA_FLAG_OVERLAPPED | WSA_FLAG_NO_HANDLE_INHERIT);
+    if (socket == INVALID_SOCKET)
+    {
+        return {ErrorCategory::Io, "Failed to create socket"};
+    }
+
+    // SO_REUSEADDR means something else on Windows (stealing a port in use), so it's left off:
+    // Windows doesn't hold a closed server's port anyway.
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(all_interfaces ? INADDR_ANY : INADDR_LOOPBACK);
+    if (::bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(socket, SOMAXCONN) != 0)
+    {
+        closesocket(socket);
+        return {ErrorCategory::Io, "Failed to listen on port"};
+    }
+    return static_cast<SocketHandle>(socket);
+}
+
+Result<SocketHandle> AcceptSocket(SocketHandle listener)
+{
+    const SOCKET socket = ::accept(ToSocket(listener), nullptr, nullptr);
+    if (socket == INVALID_SOCKET)
+    {
+        return {ErrorCategory::Io, "Failed to accept connection"};
+    }
+    SetOptions(socket);
+    return static_cast<SocketHandle>(socket);
+}
+
+Result<uint16> GetSocketPort(SocketHandle socket)
+{
+    sockaddr_storage address = {};
+    int size = sizeof(address);
+    if (getsockname(ToSocket(socket), reinterpret_cast<sockaddr*>(&address), &size) != 0)
+    {
+        return {ErrorCategory::Io, "Failed to get socket address"};
+    }
+    if (address.ss_family == AF_INET6)
+    {
+        return ntohs(reinterpret_cast<const sockaddr_in6*>(&address)->sin6_port);
+    }
+    return ntohs(reinterpret_cast<const sockaddr_in*>(&address)->sin_port);
+}
+
+Result<> SendSocket(SocketHandle socket, ByteView data)
+{
+    RSBL_PROFILE_ZONE("SendSocket");
+    uint64 sent = 0;
+    while (sent < data.Size())
+    {
+        const int count = ::send(ToSocket(socket),
+                                 reinterpret_cast<const char*>(data.Data() + sent),
+                                 ClampTransfer(data.Size() - sent),
+                                 0);
+        if (count == SOCKET_ERROR)
+        {
+            if (WSAGetLastError() == WSAETIMEDOUT)
+            {
+                return {ErrorCategory::Timeout, "Timed out sending"};
+            }
+            return {ErrorCategory::Io, "Failed to send"};
+        }
+        sent += static_cast<uint64>(count);
+    }
+
+    RSBL_COUNTER_ADD("net.sent_bytes", sent);
+    return ResultCode::Success;
+}
+
+Result<uint64> ReceiveSocket(SocketHandle socket, MutableByteView buffer)
+{
+    const int count = ::recv(ToSocket(socket),
+                             reinterpret_cast<char*>(buffer.Data()),
+                             ClampTransfer(buffer.Size()),
+                             0);
+    if (count == SOCKET_ERROR)
+    {
+        if (WSAGetLastError() == WSAETIMEDOUT)
+        {
+            return {ErrorCategory::Timeout, "Timed out receiving"};
+        }
+        return {ErrorCategory::Io, "Failed to receive"};
+    }
+
+    RSBL_COUNTER_ADD("net.received_bytes", static_cast<uint64>(count));
+    return static_cast<uint64>(count);
+}
+
+void ShutdownSocket(SocketHandle socket)
+{
+    (void)::shutdown(ToSocket(socket), SD_BOTH);
+}
+
+Result<> CloseSocket(SocketHandle socket)
+{
+    if (closesocket(ToSocket(socket)) != 0)
+    {
+        return {ErrorCategory::Io, "Failed to close socket"};
+    }
+    return ResultCode::Success;
+}
+
+} // namespace rsbl
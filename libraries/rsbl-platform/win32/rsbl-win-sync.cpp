@@ -0,0 +1,65 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-sync.h"
+
+#include <rsbl-assert.h>
+
+#include <windows.h>
+
+namespace rsbl
+{
+
+static_assert(sizeof(SRWLOCK) == sizeof(void*), "Mutex keeps the SRWLOCK in a pointer");
+static_assert(kWaitInfinite == INFINITE);
+
+namespace
+{
+SRWLOCK* NativeLock(void*& storage)
+{
+    return reinterpret_cast<SRWLOCK*>(&storage);
+}
+} // namespace
+
+bool AddressWait(const std::atomic<uint32>& value, uint32 expected, uint32 timeout_ms)
+{
+    // WaitOnAddress compares the bytes itself, so it wants a non-const pointer
+    void* address = const_cast<std::atomic<uint32>*>(&value);
+    if (!::WaitOnAddress(address, &expected, sizeof(uint32), static_cast<DWORD>(timeout_ms)))
+    {
+        return ::GetLastError() != ERROR_TIMEOUT;
+    }
+    return true;
+}
+
+void AddressWakeOne(std::atomic<uint32>& value)
+{
+    ::WakeByAddressSingle(&value);
+}
+
+void AddressWakeAll(std::atomic<uint32>& value)
+{
+    ::WakeByAddressAll(&value);
+}
+
+Mutex::~Mutex()
+{
+    rsblAssertMsg(m_native == nullptr, "Destroying a locked Mutex");
+}
+
+void Mutex::Lock()
+{
+    ::AcquireSRWLockExclusive(NativeLock(m_native));
+}
+
+bool Mutex::TryLock()
+{
+    return ::TryAcquireSRWLockExclusive(NativeLock(m_native)) != 0;
+}
+
+void Mutex::Unlock()
+{
+    ::ReleaseSRWLockExclusive(NativeLock(m_native));
+}
+
+} // namespace rsbl
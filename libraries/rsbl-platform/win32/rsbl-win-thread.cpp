@@ -3,7 +3,10 @@
 
 #include "rsbl-thread.h"
 
+#include <rsbl-assert.h>
 #include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-profile.h>
 
 #include <windows.h>
 
@@ -12,8 +15,78 @@
 namespace rsbl
 {
 
+namespace
+{
+int ToWinPriority(ThreadPriority priority)
+{
+    switch (priority)
+    {
+    case ThreadPriority::Lowest:
+        return THREAD_PRIORITY_LOWEST;
+    case ThreadPriority::BelowNormal:
+        return THREAD_PRIORITY_BELOW_NORMAL;
+    case ThreadPriority::Normal:
+        return THREAD_PRIORITY_NORMAL;
+    case ThreadPriority::AboveNormal:
+        return THREAD_PRIORITY_ABOVE_NORMAL;
+    case ThreadPriority::Highest:
+        return THREAD_PRIORITY_HIGHEST;
+    }
+    return THREAD_PRIORITY_NORMAL;
+}
+
+Result<> ApplyName(HANDLE handle, const char* name)
+{
+    // SetThreadDescription only takes UTF-16
+    wchar_t wide_name[64];
+    if (::MultiByteToWideChar(CP_UTF8, 0, name, -1, wide_name, 64) == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Thread name doesn't convert to UTF-16"};
+    }
+    if (FAILED(::SetThreadDescription(handle, wide_name)))
+    {
+        return {ErrorCategory::Platform, "SetThreadDescription failed"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> ApplyAffinity(HANDLE handle, uint64 affinityMask)
+{
+    if (::SetThreadAffinityMask(handle, static_cast<DWORD_PTR>(affinityMask)) == 0)
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "SetThreadAffinityMask failed: error %lu",
+                             ::GetLastError());
+    }
+    return ResultCode::Success;
+}
+
+Result<> ApplyPriority(HANDLE handle, ThreadPriority priority)
+{
+    if (!::SetThreadPriority(handle, ToWinPriority(priority)))
+    {
+        return FailureFormat(
+            ErrorCategory::Platform, "SetThreadPriority failed: error %lu", ::GetLastError());
+    }
+    return ResultCode::Success;
+}
+
+// Only the processors the process may use, a mask outside them can never be applied
+bool AffinityIsUsable(uint64 affinityMask)
+{
+    DWORD_PTR process_mask = 0;
+    DWORD_PTR system_mask = 0;
+    if (!::GetProcessAffinityMask(::GetCurrentProcess(), &process_mask, &system_mask))
+    {
+        return true;
+    }
+    return (static_cast<uint64>(process_mask) & affinityMask) != 0;
+}
+} // namespace
+
 Thread::Thread()
-    : m_threadFunc()
+    : m_name{0}
+    , m_threadFunc()
     , m_result(ResultCode::Success)
     , m_failureText{0}
     , m_isActive(false)
@@ -24,8 +97,30 @@ Thread::Thread()
 
 Result<UniquePtr<Thread>> Thread::Create(Function<Result<>()>&& thread_func)
 {
+    return Create(ThreadCreateInfo{}, rsblMove(thread_func));
+}
+
+Result<UniquePtr<Thread>> Thread::Create(const ThreadCreateInfo& info,
+                                         Function<Result<>()>&& thread_func)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    if (info.affinityMask != 0 && !AffinityIsUsable(info.affinityMask))
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "Affinity mask 0x%llx has none of the process's processors",
+                             static_cast<unsigned long long>(info.affinityMask));
+    }
+
     // Allocate thread object on the heap so it stays at a fixed memory location
     auto thread = UniquePtr<Thread>(new Thread);
+    if (info.name != nullptr)
+    {
+        strncpy_s(thread->m_name, kMaxNameLength, info.name, _TRUNCATE);
+    }
+    thread->m_affinityMask = info.affinityMask;
+    thread->m_priority = info.priority;
+    thread->m_stackSize = info.stackSize;
     thread->m_threadFunc = rsblMove(thread_func);
     thread->m_isActive.store(true, std::memory_order_release);
 
@@ -132,8 +227,7 @@ void Thread::ThreadSleep(uint32 milliseconds)
 // Don't call this Yield, will collide with winbase macro
 void Thread::ThreadYield()
 {
-    // ::SwitchToThread();
-    _mm_pause();
+    ::SwitchToThread();
 }
 
 uint64 Thread::GetCurrentThreadId()
@@ -141,10 +235,61 @@ uint64 Thread::GetCurrentThreadId()
     return static_cast<uint64>(::GetCurrentThreadId());
 }
 
+uint32 Thread::GetHardwareThreadCount()
+{
+    // GetSystemInfo only sees the calling thread's processor group, at most 64 processors
+    const DWORD count = ::GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    return count > 0 ? static_cast<uint32>(count) : 1;
+}
+
+Result<> Thread::SetCurrentThreadName(const char* name)
+{
+    return ApplyName(::GetCurrentThread(), name);
+}
+
+Result<> Thread::SetCurrentThreadAffinity(uint64 affinityMask)
+{
+    return ApplyAffinity(::GetCurrentThread(), affinityMask);
+}
+
+Result<> Thread::SetCurrentThreadPriority(ThreadPriority priority)
+{
+    return ApplyPriority(::GetCurrentThread(), priority);
+}
+
+Result<> Thread::GetCurrentThreadName(char* buffer, uint32 bufferSize)
+{
+    rsblAssert(buffer != nullptr && bufferSize > 0);
+
+    wchar_t* wide_name = nullptr;
+    if (FAILED(::GetThreadDescription(::GetCurrentThread(), &wide_name)))
+    {
+        return {ErrorCategory::Platform, "GetThreadDescription failed"};
+    }
+    const int written = ::WideCharToMultiByte(
+        CP_UTF8, 0, wide_name, -1, buffer, static_cast<int>(bufferSize), nullptr, nullptr);
+    ::LocalFree(wide_name);
+    if (written == 0)
+    {
+        buffer[0] = '\0';
+        return {ErrorCategory::InvalidArgument, "Thread name doesn't fit the buffer"};
+    }
+    return ResultCode::Success;
+}
+
 void Thread::ThreadEntry()
 {
+    // The OS name is set by the creating thread, the profiler's has to come from this one
+    if (m_name[0] != '\0')
+    {
+        RSBL_PROFILE_THREAD(m_name);
+    }
+
     // Execute the user's function and store the result
-    m_result = m_threadFunc();
+    {
+        RSBL_PROFILE_ZONE("Thread");
+        m_result = m_threadFunc();
+    }
 
     // Capture failure text if the result failed
     // We need to copy it because it's stored in thread-local storage
@@ -176,20 +321,52 @@ Result<ThreadNativeData> Thread::CreatePlatformThread(Thread* thread_obj)
         return 0;
     };
 
+    // Suspended until the settings are in, so the function never runs without them. The stack
+    // size is the reservation, the default commit is left alone.
+    const DWORD flags =
+        CREATE_SUSPENDED | (thread_obj->m_stackSize != 0 ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0);
     DWORD thread_id = 0;
-    HANDLE handle = ::CreateThread(nullptr,                // Default security attributes
-                                   0,                      // Default stack size
+    HANDLE handle = ::CreateThread(nullptr, // Default security attributes
+                                   static_cast<SIZE_T>(thread_obj->m_stackSize),
                                    PlatformThreadFunction, // Thread function
                                    thread_obj,             // Thread parameter
-                                   0,                      // Creation flags (0 = run immediately)
-                                   &thread_id);            // Thread ID output
+                                   flags,
+                                   &thread_id); // Thread ID output
 
     if (handle == nullptr)
     {
         return "Failed to create thread";
     }
 
-    RSBL_LOG_INFO("rsbl::Thread created with thread_id {}", thread_id);
+    // None of these stop the thread, it runs either way once it's been created. Failures are
+    // only logged once logging is up.
+    if (thread_obj->m_name[0] != '\0')
+    {
+        const Result<> named = ApplyName(handle, thread_obj->m_name);
+        if (!named && g_logger != nullptr)
+        {
+            RSBL_LOG_WARNING("rsbl::Thread couldn't be named: {}", named.FailureText());
+        }
+    }
+    if (thread_obj->m_affinityMask != 0)
+    {
+        const Result<> pinned = ApplyAffinity(handle, thread_obj->m_affinityMask);
+        if (!pinned && g_logger != nullptr)
+        {
+            RSBL_LOG_WARNING("rsbl::Thread affinity not set: {}", pinned.FailureText());
+        }
+    }
+    if (thread_obj->m_priority != ThreadPriority::Normal)
+    {
+        const Result<> prioritized = ApplyPriority(handle, thread_obj->m_priority);
+        if (!prioritized && g_logger != nullptr)
+        {
+            RSBL_LOG_WARNING("rsbl::Thread priority not set: {}", prioritized.FailureText());
+        }
+    }
+    ::ResumeThread(handle);
+
+    RSBL_LOG_DEBUG("rsbl::Thread created with thread_id {}", thread_id);
 
     ThreadNativeData data;
     data.platform_handle = handle;
@@ -0,0 +1,171 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-virtual-memory.h"
+
+#include "rsbl-cpu-topology.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-log.h>
+
+#include <windows.h>
+
+namespace rsbl
+{
+
+namespace
+{
+uint64 RoundUp(uint64 size, uint64 granularity)
+{
+    return (size + granularity - 1) / granularity * granularity;
+}
+
+PageInfo QueryPageInfo()
+{
+    SYSTEM_INFO system_info;
+    ::GetSystemInfo(&system_info);
+    PageInfo info;
+    info.pageSize = system_info.dwPageSize;
+    info.reserveGranularity = system_info.dwAllocationGranularity;
+    info.largePageSize = ::GetLargePageMinimum();
+    return info;
+}
+
+bool IsPageAligned(const void* address, uint64 size)
+{
+    const uint64 page_size = GetPageInfo().pageSize;
+    return reinterpret_cast<uintptr_t>(address) % page_size == 0 && size % page_size == 0;
+}
+
+// MEM_LARGE_PAGES needs SeLockMemoryPrivilege enabled in the process token, and having it
+// granted to the user isn't enough until it is. Only tried once.
+bool EnableLockMemoryPrivilege()
+{
+    HANDLE token = nullptr;
+    if (!::OpenProcessToken(::GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+    {
+        return false;
+    }
+
+    TOKEN_PRIVILEGES privileges{};
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    bool enabled = false;
+    if (::LookupPrivilegeValueA(nullptr, "SeLockMemoryPrivilege", &privileges.Privileges[0].Luid))
+    {
+        // Succeeds without enabling anything when the user hasn't got the right, which only
+        // GetLastError says
+        enabled = ::AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+                  ::GetLastError() == ERROR_SUCCESS;
+    }
+    ::CloseHandle(token);
+    if (!enabled)
+    {
+        RSBL_LOG_WARNING("No large pages: the user doesn't have the \"Lock pages in memory\" "
+                         "right");
+    }
+    return enabled;
+}
+} // namespace
+
+const PageInfo& GetPageInfo()
+{
+    static const PageInfo info = QueryPageInfo();
+    return info;
+}
+
+Result<void*> ReserveVirtual(uint64 size)
+{
+    void* address = ::VirtualAlloc(nullptr,
+                                   RoundUp(size, GetPageInfo().reserveGranularity),
+                                   MEM_RESERVE,
+                                   PAGE_NOACCESS);
+    if (address == nullptr)
+    {
+        return {ErrorCategory::OutOfMemory, "Failed to reserve address space"};
+    }
+    return address;
+}
+
+void ReleaseVirtual(void* address, [[maybe_unused]] uint64 size)
+{
+    // MEM_RELEASE takes the whole reservation, and a size of 0
+    if (address != nullptr)
+    {
+        ::VirtualFree(address, 0, MEM_RELEASE);
+    }
+}
+
+Result<> CommitPages(void* address, uint64 size)
+{
+    rsblAssertMsg(IsPageAligned(address, size), "CommitPages takes whole pages");
+    if (::VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+    {
+        return {ErrorCategory::OutOfMemory, "Failed to commit pages"};
+    }
+    return ResultCode::Success;
+}
+
+Result<> CommitPagesOnNode(void* address, uint64 size, uint32 numaNode)
+{
+    const CpuTopology& topology = GetCpuTopology();
+    if (topology.numaNodeCount <= 1 || numaNode >= topology.numaNodeIds.Size())
+    {
+        return CommitPages(address, size);
+    }
+
+    // The node is preferred, not required: Windows takes pages from others once it's out
+    rsblAssertMsg(IsPageAligned(address, size), "CommitPagesOnNode takes whole pages");
+    if (::VirtualAllocExNuma(::GetCurrentProcess(),
+                             address,
+                             size,
+                             MEM_COMMIT,
+                             PAGE_READWRITE,
+                             topology.numaNodeIds[numaNode]) == nullptr)
+    {
+        return {ErrorCategory::OutOfMemory, "Failed to commit pages"};
+    }
+    return ResultCode::Success;
+}
+
+void DecommitPages(void* address, uint64 size)
+{
+    rsblAssertMsg(IsPageAligned(address, size), "DecommitPages takes whole pages");
+    ::VirtualFree(address, size, MEM_DECOMMIT);
+}
+
+Result<void*> AllocLargePages(uint64 size)
+{
+    const uint64 large_page_size = GetPageInfo().largePageSize;
+    if (large_page_size == 0)
+    {
+        return {ErrorCategory::NotFound, "The system has no large pages"};
+    }
+    static const bool s_privilegeEnabled = EnableLockMemoryPrivilege();
+    if (!s_privilegeEnabled)
+    {
+        return {ErrorCategory::Platform, "Large pages need the \"Lock pages in memory\" right"};
+    }
+
+    // Large pages are committed with the reservation, and have to be physically contiguous, so
+    // this can fail on a machine that's been up a while with plenty of memory free
+    void* address = ::VirtualAlloc(nullptr,
+                                   RoundUp(size, large_page_size),
+                                   MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                   PAGE_READWRITE);
+    if (address == nullptr)
+    {
+        return {ErrorCategory::OutOfMemory, "Failed to allocate large pages"};
+    }
+    return address;
+}
+
+void FreeLargePages(void* address, [[maybe_unused]] uint64 size)
+{
+    if (address != nullptr)
+    {
+        ::VirtualFree(address, 0, MEM_RELEASE);
+    }
+}
+
+} // namespace rsbl
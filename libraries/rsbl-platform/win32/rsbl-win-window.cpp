@@ -3,7 +3,16 @@
 
 #include "rsbl-window.h"
 
+#include <rsbl-clock.h>
+#include <rsbl-concurrent-queue.h>
 #include <rsbl-log.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-profile.h>
+#include <rsbl-string.h>
+#include <rsbl-sync.h>
+#include <rsbl-thread.h>
+
+#include <atomic>
 
 #include <windows.h>
 
@@ -18,6 +27,8 @@ namespace rsbl
 static const char* s_windowClassName = "RSBLWindowClass";
 static bool s_windowClassRegistered = false;
 
+static LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+
 // Register the window class (only needs to happen once)
 static Result<> RegisterWindowClass()
 {
@@ -26,12 +37,23 @@ static Result<> RegisterWindowClass()
         return ResultCode::Success;
     }
 
+    // Per-monitor v2: sizes and positions are physical pixels on every monitor, instead of the
+    // system scaling up a blurry 96 DPI rendering, and WM_DPICHANGED comes when the window moves
+    // to a monitor of another DPI. Fails if a manifest or an earlier call set it already.
+    if (!SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2) &&
+        !AreDpiAwarenessContextsEqual(GetThreadDpiAwarenessContext(),
+                                      DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2))
+    {
+        RSBL_LOG_WARNING("Failed to make the process per-monitor DPI aware, error {}",
+                         GetLastError());
+    }
+
     WNDCLASSEXA wc;
     wc.cbSize = sizeof(WNDCLASSEXA);
     wc.style = CS_HREDRAW | CS_VREDRAW;
-    wc.lpfnWndProc = reinterpret_cast<WNDPROC>(Window::WindowProc);
+    wc.lpfnWndProc = WindowProc;
     wc.cbClsExtra = 0;
-    wc.cbWndExtra = sizeof(Window*); // Allocate space for Window pointer
+    wc.cbWndExtra = sizeof(Window::MessageState*); // Allocate space for the state pointer
     wc.hInstance = GetModuleHandle(nullptr);
     wc.hIcon = nullptr;
     wc.hCursor = LoadCursor(nullptr, IDC_ARROW);
@@ -54,96 +76,323 @@ static Result<> RegisterWindowClass()
     return ResultCode::Success;
 }
 
-// We can expect WM_CLOSE -> WM_DESTROY -> WM_QUIT. Some of it is explained here:
-// https://stackoverflow.com/questions/3155782/what-is-the-difference-between-wm-quit-wm-close-and-wm-destroy-in-a-windows-pr
-// I'm just going to handle DESTROY, and let windows handle CLOSE and QUIT (though I'm kinda
-// invoking QUIT by calling PostQuitMessage).
-// Update: I'm actually posting quit, and then catching it in my message processing loop!
-long long Window::WindowProc(void* handle,
-                             unsigned int uMsg,
-                             unsigned long long wParam,
-                             long long lParam)
+namespace
 {
+// What WindowProc saw change, for ProcessMessages to apply
+struct WindowEvent
+{
+    enum class Type : uint8
+    {
+        Resized,
+        Moved,
+        DpiChanged,
+    };
 
-    auto hwnd = static_cast<HWND>(handle);
+    Type type;
+    uint2 size;
+    int2 position;
+    uint32 dpi = 0;
+};
 
-    // Retrieve the Window pointer stored in the window's user data
-    // Before we call SetWindowLongPtrA, this will be nullptr. So make we check if window is valid
-    // first!
-    auto* window = reinterpret_cast<Window*>(GetWindowLongPtrA(hwnd, 0));
-    const uint2 cached_size = (window != nullptr) ? window->m_size : uint2(0, 0);
+// Plenty for a few frames of a drag. Each event carries the whole size or position, so one that
+// doesn't fit is dropped and the window is read back instead of waiting for room.
+constexpr uint64 kWindowEventCapacity = 256;
+
+// A quarter of a second of an 8 kHz mouse, for a consumer that stalls for a frame or few
+constexpr uint64 kInputEventCapacity = 2048;
+
+// What a DPI scale of 1 is
+constexpr float kDefaultDpi = 96.0f;
+
+// Raw input read per GetRawInputBuffer call
+constexpr uint32 kRawInputBatch = 64;
+
+// Posted to the window, so the message thread handles them even inside a modal drag loop, which
+// drops thread messages
+constexpr UINT kDestroyMessage = WM_APP + 1;
+constexpr UINT kSetTitleMessage = WM_APP + 2;
+constexpr UINT kSetModeMessage = WM_APP + 3;
+
+uint2 QueryClientSize(HWND hwnd, uint2 fallback)
+{
+    RECT client_rect;
+    if (!GetClientRect(hwnd, &client_rect))
+    {
+        return fallback;
+    }
+    return uint2(static_cast<uint32>(client_rect.right - client_rect.left),
+                 static_cast<uint32>(client_rect.bottom - client_rect.top));
+}
+
+int2 QueryPosition(HWND hwnd, int2 fallback)
+{
+    RECT window_rect;
+    if (!GetWindowRect(hwnd, &window_rect))
+    {
+        return fallback;
+    }
+    return int2(window_rect.left, window_rect.top);
+}
+} // namespace
 
-    auto UpdateClientSize = [window, hwnd, cached_size]() {
-        RECT client_rect;
-        if (GetClientRect(hwnd, &client_rect))
+struct Window::MessageState
+{
+    explicit MessageState(const WindowCreateInfo& info)
+        : rawInput(info.rawInput)
+        , input(info.rawInput ? kInputEventCapacity : 1)
+        , ownThread(info.threading == WindowThreading::MessageThread)
+        , wake(ownThread ? CreateEventA(nullptr, FALSE, FALSE, nullptr) : nullptr)
+    {
+    }
+
+    ~MessageState()
+    {
+        if (wake != nullptr)
         {
-            window->m_size.x = static_cast<uint32>(client_rect.right - client_rect.left);
-            window->m_size.y = static_cast<uint32>(client_rect.bottom - client_rect.top);
+            CloseHandle(wake);
+        }
+    }
 
-            if (cached_size.x != window->m_size.x || cached_size.y != window->m_size.y)
-            {
-                window->m_resizeFlagged = true;
-            }
+    // Filled by WindowProc on whichever thread pumps messages, emptied by ProcessMessages
+    SpscRing<WindowEvent> events{kWindowEventCapacity};
+    // An event didn't fit, ProcessMessages reads the size and position from the window instead
+    std::atomic<bool> dropped{false};
+    std::atomic<bool> quit{false};
+
+    // What WindowProc last queued, so it only queues changes. Message pumping thread only.
+    uint2 queuedSize{0, 0};
+    int2 queuedPosition{0, 0};
+
+    const bool rawInput;
+    // Filled by WindowProc, emptied by PopInputEvent
+    SpscRing<InputEvent> input;
+    std::atomic<uint64> droppedInput{0};
+    // Where GetRawInputBuffer reads to. Message pumping thread only.
+    RAWINPUT rawBatch[kRawInputBatch];
+
+    // The rest is only used with WindowThreading::MessageThread
+    const bool ownThread;
+    UniquePtr<Thread> thread;
+    // Set once the thread has created the window, or failed to
+    Event created;
+    HWND hwnd = nullptr;
+
+    SpinLock titleLock;
+    String pendingTitle;
+    bool titlePosted = false;
+
+    // What the window was before it went fullscreen, to go back to. Message pumping thread only.
+    WindowMode appliedMode = WindowMode::Windowed;
+    LONG_PTR windowedStyle = 0;
+    RECT windowedRect = {};
+    // Auto-reset, set after anything is queued, for WaitForEvents. It can be left set by what a
+    // ProcessMessages has already taken, which only makes the next wait return early.
+    HANDLE wake;
+
+    void Queue(const WindowEvent& event)
+    {
+        if (!events.TryPush(event))
+        {
+            dropped.store(true, std::memory_order_release);
         }
-    };
+        Wake();
+    }
 
-    switch (uMsg)
+    void Wake()
     {
-    case WM_SIZE:
-        // Window has been resized - update the client area size
-        if (window != nullptr)
+        if (wake != nullptr)
         {
-            UpdateClientSize();
+            SetEvent(wake);
         }
-        return 0;
+    }
 
-    case WM_WINDOWPOSCHANGED:
-        // Window position or size has changed
-        if (window != nullptr)
+    void QueueInput(const InputEvent& event)
+    {
+        if (!input.TryPush(event))
         {
-            // Update position from window rect (screen coordinates)
-            RECT window_rect;
-            if (GetWindowRect(hwnd, &window_rect))
+            droppedInput.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+};
+
+namespace
+{
+struct RawMouseButton
+{
+    USHORT downFlag;
+    USHORT upFlag;
+    MouseButton button;
+};
+
+constexpr RawMouseButton kRawMouseButtons[] = {
+    {RI_MOUSE_LEFT_BUTTON_DOWN, RI_MOUSE_LEFT_BUTTON_UP, MouseButton::Left},
+    {RI_MOUSE_RIGHT_BUTTON_DOWN, RI_MOUSE_RIGHT_BUTTON_UP, MouseButton::Right},
+    {RI_MOUSE_MIDDLE_BUTTON_DOWN, RI_MOUSE_MIDDLE_BUTTON_UP, MouseButton::Middle},
+    {RI_MOUSE_BUTTON_4_DOWN, RI_MOUSE_BUTTON_4_UP, MouseButton::X1},
+    {RI_MOUSE_BUTTON_5_DOWN, RI_MOUSE_BUTTON_5_UP, MouseButton::X2},
+};
+
+// One RAWINPUT can be a move, some buttons and the wheel at once, each its own event
+void QueueRawInput(Window::MessageState* state, const RAWINPUT& raw, uint64 now)
+{
+    InputEvent event;
+    event.timestampTicks = now;
+
+    if (raw.header.dwType == RIM_TYPEMOUSE)
+    {
+        const RAWMOUSE& mouse = raw.data.mouse;
+        // Absolute positions come from tablets and remote desktop, and aren't motion to add up
+        if ((mouse.usFlags & MOUSE_MOVE_ABSOLUTE) == 0 && (mouse.lLastX != 0 || mouse.lLastY != 0))
+        {
+            event.type = InputEventType::MouseMove;
+            event.dx = mouse.lLastX;
+            event.dy = mouse.lLastY;
+            state->QueueInput(event);
+        }
+
+        event.dx = 0;
+        event.dy = 0;
+        for (const RawMouseButton& button : kRawMouseButtons)
+        {
+            if ((mouse.usButtonFlags & (button.downFlag | button.upFlag)) != 0)
             {
-                window->m_position.x = window_rect.left;
-                window->m_position.y = window_rect.top;
+                event.type = InputEventType::MouseButton;
+                event.button = button.button;
+                event.pressed = (mouse.usButtonFlags & button.downFlag) != 0;
+                state->QueueInput(event);
             }
+        }
 
-            // Update size from client rect (what we actually care about for rendering)
-            UpdateClientSize();
+        // The wheel's delta is signed, in an unsigned field
+        const int32 wheel = static_cast<SHORT>(mouse.usButtonData);
+        if ((mouse.usButtonFlags & (RI_MOUSE_WHEEL | RI_MOUSE_HWHEEL)) != 0)
+        {
+            event.type = InputEventType::MouseWheel;
+            event.pressed = false;
+            event.dx = (mouse.usButtonFlags & RI_MOUSE_HWHEEL) != 0 ? wheel : 0;
+            event.dy = (mouse.usButtonFlags & RI_MOUSE_WHEEL) != 0 ? wheel : 0;
+            state->QueueInput(event);
         }
-        return 0;
+    }
+    else if (raw.header.dwType == RIM_TYPEKEYBOARD)
+    {
+        const RAWKEYBOARD& keyboard = raw.data.keyboard;
+        // Fake keys some keyboards send as part of escape sequences
+        if (keyboard.VKey == 0xFF)
+        {
+            return;
+        }
+        event.type = InputEventType::Key;
+        event.key = keyboard.VKey;
+        event.scanCode = static_cast<uint16>(keyboard.MakeCode |
+                                             ((keyboard.Flags & RI_KEY_E0) != 0 ? 0xE000 : 0));
+        event.pressed = (keyboard.Flags & RI_KEY_BREAK) == 0;
+        state->QueueInput(event);
+    }
+}
 
-    case WM_DESTROY:
-        ::PostQuitMessage(0);
-        return 0;
+// Reads the WM_INPUT being handled, then whatever raw input has arrived since in batches. The
+// batches take their WM_INPUT messages off the queue, so a fast mouse costs a message per batch
+// rather than one per report.
+void ReadRawInput(Window::MessageState* state, HRAWINPUT handle)
+{
+    const uint64 now = Clock::NowTicks();
 
-    default:
-        return DefWindowProcA(hwnd, uMsg, wParam, lParam);
+    RAWINPUT raw;
+    UINT size = sizeof(raw);
+    if (GetRawInputData(handle, RID_INPUT, &raw, &size, sizeof(RAWINPUTHEADER)) !=
+        static_cast<UINT>(-1))
+    {
+        QueueRawInput(state, raw, now);
     }
+
+    for (;;)
+    {
+        UINT batch_size = sizeof(state->rawBatch);
+        const UINT count = GetRawInputBuffer(state->rawBatch, &batch_size, sizeof(RAWINPUTHEADER));
+        if (count == 0 || count == static_cast<UINT>(-1))
+        {
+            break;
+        }
+        const RAWINPUT* block = state->rawBatch;
+        for (UINT i = 0; i < count; ++i)
+        {
+            QueueRawInput(state, *block, now);
+            block = NEXTRAWINPUTBLOCK(block);
+        }
+    }
+    state->Wake();
 }
 
-Result<UniquePtr<Window>> Window::Create(uint2 size, int2 position)
+// On the thread the window belongs to, which SetWindowPos would otherwise wait on
+void ApplyWindowMode(HWND hwnd, Window::MessageState* state, WindowMode mode)
 {
-    // Ensure window class is registered
-    if (auto register_result = RegisterWindowClass(); register_result.Code() != ResultCode::Success)
+    if (mode == state->appliedMode)
     {
-        return "Failed to register window class";
+        return;
+    }
+
+    if (mode == WindowMode::Fullscreen)
+    {
+        MONITORINFO monitor = {};
+        monitor.cbSize = sizeof(monitor);
+        if (!GetWindowRect(hwnd, &state->windowedRect) ||
+            !GetMonitorInfoA(MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST), &monitor))
+        {
+            RSBL_LOG_WARNING("Failed to find the window's monitor, error {}", GetLastError());
+            return;
+        }
+        state->windowedStyle = GetWindowLongPtrA(hwnd, GWL_STYLE);
+        // WS_VISIBLE and the rest carry over, only the borders go
+        const LONG_PTR style = (state->windowedStyle & ~WS_OVERLAPPEDWINDOW) | WS_POPUP;
+        SetWindowLongPtrA(hwnd, GWL_STYLE, style);
+        const RECT& area = monitor.rcMonitor;
+        SetWindowPos(hwnd,
+                     HWND_TOP,
+                     area.left,
+                     area.top,
+                     area.right - area.left,
+                     area.bottom - area.top,
+                     SWP_FRAMECHANGED | SWP_NOOWNERZORDER);
     }
+    else
+    {
+        SetWindowLongPtrA(hwnd, GWL_STYLE, state->windowedStyle);
+        const RECT& area = state->windowedRect;
+        SetWindowPos(hwnd,
+                     nullptr,
+                     area.left,
+                     area.top,
+                     area.right - area.left,
+                     area.bottom - area.top,
+                     SWP_FRAMECHANGED | SWP_NOZORDER | SWP_NOOWNERZORDER);
+    }
+    state->appliedMode = mode;
+}
+
+// Creates the window on the calling thread, which is the one that has to pump its messages
+HWND CreateNativeWindow(const WindowCreateInfo& info, Window::MessageState* state)
+{
+    const uint2 size = info.size;
+    const int2 position = info.position;
 
     // If position is -1, use default positioning
     const int pos_x = (position.x == -1) ? CW_USEDEFAULT : position.x;
     const int pos_y = (position.y == -1) ? CW_USEDEFAULT : position.y;
 
     // Adjust the window size to account for borders, title bar, etc.
-    // We want 'width' and 'height' to represent the client area size
+    // We want 'width' and 'height' to represent the client area size. The borders are as wide as
+    // the monitor's DPI makes them, which isn't known until the window is on one.
     RECT client_to_window_rect = {0, 0, static_cast<LONG>(size.x), static_cast<LONG>(size.y)};
     const DWORD window_style = WS_OVERLAPPEDWINDOW;
     const DWORD window_ex_style = 0;
+    const UINT system_dpi = GetDpiForSystem();
 
-    if (!AdjustWindowRectEx(&client_to_window_rect, window_style, FALSE, window_ex_style))
+    if (!AdjustWindowRectExForDpi(
+            &client_to_window_rect, window_style, FALSE, window_ex_style, system_dpi))
     {
-        return "Failed to adjust window rectangle";
+        RSBL_LOG_ERROR("Failed to adjust window rectangle");
+        return nullptr;
     }
 
     const int adjusted_width = client_to_window_rect.right - client_to_window_rect.left;
@@ -165,44 +414,258 @@ Result<UniquePtr<Window>> Window::Create(uint2 size, int2 position)
 
     if (hwnd == nullptr)
     {
+        RSBL_LOG_ERROR("Failed to create window");
+        return nullptr;
+    }
+
+    // Created on a monitor whose DPI isn't the system's, the borders are redone for it
+    if (const UINT dpi = GetDpiForWindow(hwnd); dpi != system_dpi)
+    {
+        RECT rect = {0, 0, static_cast<LONG>(size.x), static_cast<LONG>(size.y)};
+        if (AdjustWindowRectExForDpi(&rect, window_style, FALSE, window_ex_style, dpi))
+        {
+            SetWindowPos(hwnd,
+                         nullptr,
+                         0,
+                         0,
+                         rect.right - rect.left,
+                         rect.bottom - rect.top,
+                         SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+        }
+    }
+
+    // What the window starts out as isn't a change, showing it doesn't queue anything
+    state->queuedSize = QueryClientSize(hwnd, size);
+    state->queuedPosition = QueryPosition(hwnd, position);
+
+    // Store the state in the window's user data for access in WindowProc
+    SetWindowLongPtrA(hwnd, 0, reinterpret_cast<LONG_PTR>(state));
+
+    if (info.rawInput)
+    {
+        // Generic desktop mouse and keyboard. No RIDEV_NOLEGACY, the window still needs its
+        // usual mouse messages to be dragged and resized, and key messages for text.
+        RAWINPUTDEVICE devices[2] = {};
+        devices[0].usUsagePage = 0x01;
+        devices[0].usUsage = 0x02;
+        devices[0].hwndTarget = hwnd;
+        devices[1].usUsagePage = 0x01;
+        devices[1].usUsage = 0x06;
+        devices[1].hwndTarget = hwnd;
+        if (!RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE)))
+        {
+            RSBL_LOG_WARNING("Failed to register for raw input, error {}", GetLastError());
+        }
+    }
+
+    ShowWindow(hwnd, SW_SHOW);
+    UpdateWindow(hwnd);
+    return hwnd;
+}
+
+Result<> RunMessageThread(const WindowCreateInfo& info, Window::MessageState* state)
+{
+    state->hwnd = CreateNativeWindow(info, state);
+    state->created.Set();
+    if (state->hwnd == nullptr)
+    {
+        state->quit.store(true, std::memory_order_release);
         return "Failed to create window";
     }
 
-    // Allocate and initialize the Window object
-    Window* window = new Window(size, position);
-    window->m_platformData.platform_handle = hwnd;
+    // Blocks until there's a message, and keeps pumping through modal drag and resize loops,
+    // which is the point of the thread. WM_QUIT, from WM_DESTROY, ends it.
+    MSG msg;
+    BOOL got;
+    while ((got = ::GetMessageA(&msg, nullptr, 0, 0)) > 0)
+    {
+        ::TranslateMessage(&msg);
+        ::DispatchMessageA(&msg);
+    }
 
-    // Store the Window pointer in the window's user data for access in WindowProc
-    SetWindowLongPtrA(hwnd, 0, reinterpret_cast<LONG_PTR>(window));
+    state->quit.store(true, std::memory_order_release);
+    state->Wake();
+    if (got < 0)
+    {
+        return "GetMessage failed";
+    }
+    return ResultCode::Success;
+}
+} // namespace
 
-    // Query the actual window position and size from Windows, but retain the expected 'client' area
-    RECT created_window_rect;
-    if (GetWindowRect(hwnd, &created_window_rect))
+// We can expect WM_CLOSE -> WM_DESTROY -> WM_QUIT. Some of it is explained here:
+// https://stackoverflow.com/questions/3155782/what-is-the-difference-between-wm-quit-wm-close-and-wm-destroy-in-a-windows-pr
+// I'm just going to handle DESTROY, and let windows handle CLOSE and QUIT (though I'm kinda
+// invoking QUIT by calling PostQuitMessage).
+// Update: I'm actually posting quit, and then catching it in my message processing loop!
+// Runs on whichever thread pumps messages, so it only queues what changed, and ProcessMessages
+// applies it to the Window.
+static LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+{
+    // Retrieve the state stored in the window's user data
+    // Before we call SetWindowLongPtrA, this will be nullptr. So make we check if state is valid
+    // first!
+    auto* state = reinterpret_cast<Window::MessageState*>(GetWindowLongPtrA(hwnd, 0));
+
+    auto QueueClientSize = [state, hwnd]() {
+        const uint2 size = QueryClientSize(hwnd, state->queuedSize);
+        if (size.x != state->queuedSize.x || size.y != state->queuedSize.y)
+        {
+            state->queuedSize = size;
+            state->Queue(WindowEvent{WindowEvent::Type::Resized, size, int2(0, 0)});
+        }
+    };
+
+    switch (uMsg)
     {
-        window->m_position.x = created_window_rect.left;
-        window->m_position.y = created_window_rect.top;
+    case WM_SIZE:
+        // Window has been resized - update the client area size
+        if (state != nullptr)
+        {
+            QueueClientSize();
+        }
+        return 0;
+
+    case WM_WINDOWPOSCHANGED:
+        // Window position or size has changed
+        if (state != nullptr)
+        {
+            // Update position from window rect (screen coordinates)
+            const int2 position = QueryPosition(hwnd, state->queuedPosition);
+            if (position.x != state->queuedPosition.x || position.y != state->queuedPosition.y)
+            {
+                state->queuedPosition = position;
+                state->Queue(WindowEvent{WindowEvent::Type::Moved, uint2(0, 0), position});
+            }
+
+            // Update size from client rect (what we actually care about for rendering)
+            QueueClientSize();
+        }
+        return 0;
+
+    case WM_DPICHANGED:
+        // Moved to a monitor of another DPI. The suggested rect keeps the window where it was
+        // under the cursor and about the same size to look at, its WM_SIZE brings the resize.
+        if (state != nullptr)
+        {
+            const RECT* suggested = reinterpret_cast<const RECT*>(lParam);
+            SetWindowPos(hwnd,
+                         nullptr,
+                         suggested->left,
+                         suggested->top,
+                         suggested->right - suggested->left,
+                         suggested->bottom - suggested->top,
+                         SWP_NOZORDER | SWP_NOACTIVATE);
+            WindowEvent event{WindowEvent::Type::DpiChanged, uint2(0, 0), int2(0, 0)};
+            event.dpi = LOWORD(wParam);
+            state->Queue(event);
+        }
+        return 0;
+
+    case WM_INPUT:
+        if (state != nullptr && state->rawInput)
+        {
+            ReadRawInput(state, reinterpret_cast<HRAWINPUT>(lParam));
+        }
+        // Lets the system free what it kept for the message
+        return DefWindowProcA(hwnd, uMsg, wParam, lParam);
+
+    case WM_DESTROY:
+        ::PostQuitMessage(0);
+        return 0;
+
+    case kDestroyMessage:
+        // Only the thread that created a window can destroy it
+        DestroyWindow(hwnd);
+        return 0;
+
+    case kSetTitleMessage:
+        if (state != nullptr)
+        {
+            String title;
+            state->titleLock.Lock();
+            title = rsblMove(state->pendingTitle);
+            state->titlePosted = false;
+            state->titleLock.Unlock();
+            SetWindowTextA(hwnd, title.CStr());
+        }
+        return 0;
+
+    case kSetModeMessage:
+        if (state != nullptr)
+        {
+            ApplyWindowMode(hwnd, state, static_cast<WindowMode>(wParam));
+        }
+        return 0;
+
+    default:
+        return DefWindowProcA(hwnd, uMsg, wParam, lParam);
+    }
+}
+
+Result<UniquePtr<Window>> Window::Create(uint2 size, int2 position)
+{
+    WindowCreateInfo info;
+    info.size = size;
+    info.position = position;
+    return Create(info);
+}
+
+Result<UniquePtr<Window>> Window::Create(const WindowCreateInfo& info)
+{
+    MemoryTagScope memory_scope(MemoryTag::Platform);
+
+    // Ensure window class is registered. Done here rather than on the message thread, so two
+    // windows' threads don't race to do it.
+    if (auto register_result = RegisterWindowClass(); register_result.Code() != ResultCode::Success)
+    {
+        return "Failed to register window class";
+    }
+
+    // Allocate and initialize the Window object
+    UniquePtr<Window> window(new Window(info.size, info.position));
+    MessageState* state = new MessageState(info);
+    window->m_messages = state;
+
+    HWND hwnd = nullptr;
+    if (info.threading == WindowThreading::MessageThread)
+    {
+        ThreadCreateInfo thread_info;
+        thread_info.name = "rsbl-window";
+        // Input goes through it, so it shouldn't wait behind workers
+        thread_info.priority = ThreadPriority::AboveNormal;
+        Result<UniquePtr<Thread>> thread = Thread::Create(
+            thread_info, [state, info]() -> Result<> { return RunMessageThread(info, state); });
+        if (!thread)
+        {
+            return thread.FailureText();
+        }
+        state->thread = rsblMove(thread.Value());
+        state->created.Wait();
+        hwnd = state->hwnd;
     }
     else
     {
-        // TODO: log warning? We can't do much, but failing GetWindowRect sems bad.
+        hwnd = CreateNativeWindow(info, state);
     }
 
-    // Now get the correct width + height for the _client_ area of the window, which is what we
-    // care about for the renderer
-    RECT created_client_rect;
-    if (GetClientRect(hwnd, &created_client_rect))
+    if (hwnd == nullptr)
     {
-        window->m_size.x =
-            static_cast<uint32>(created_client_rect.right - created_client_rect.left);
-        window->m_size.y =
-            static_cast<uint32>(created_client_rect.bottom - created_client_rect.top);
+        return "Failed to create window";
     }
+    window->m_platformData.platform_handle = hwnd;
+    window->m_platformData.display_handle = GetModuleHandle(nullptr);
 
-    window->Show();
+    // Query the actual window position and size from Windows, but retain the expected 'client' area
+    window->m_position = QueryPosition(hwnd, info.position);
+    window->m_size = QueryClientSize(hwnd, info.size);
+    window->m_dpiScale = static_cast<float>(GetDpiForWindow(hwnd)) / kDefaultDpi;
 
-    RSBL_LOG_INFO("rsbl::Window created with HWND {}", static_cast<void*>(hwnd));
+    RSBL_LOG_INFO("rsbl::Window created with HWND {}{}",
+                  static_cast<void*>(hwnd),
+                  state->thread ? " on its own message thread" : "");
 
-    return UniquePtr(window);
+    return rsblMove(window);
 }
 
 Window::Window(uint2 size, int2 position)
@@ -217,10 +680,29 @@ Window::~Window()
     if (m_platformData.platform_handle != nullptr)
     {
         HWND hwnd = static_cast<HWND>(m_platformData.platform_handle);
-        DestroyWindow(hwnd);
+        if (m_messages->thread)
+        {
+            // Fails harmlessly if the window was closed and the thread is already on its way out
+            PostMessageA(hwnd, kDestroyMessage, 0, 0);
+        }
+        else
+        {
+            DestroyWindow(hwnd);
+        }
         m_platformData.platform_handle = nullptr;
         RSBL_LOG_INFO("rsbl::Window torn down - HWND {}", static_cast<void*>(hwnd));
     }
+
+    if (m_messages != nullptr)
+    {
+        // WindowProc can't run past the join, the state can go
+        if (m_messages->thread)
+        {
+            const Result<> joined = m_messages->thread->Join();
+            rsblAssert(joined);
+        }
+        delete m_messages;
+    }
 }
 
 WindowNativeData Window::GetNativeData() const
@@ -228,13 +710,21 @@ WindowNativeData Window::GetNativeData() const
     return m_platformData;
 }
 
+// ShowWindow waits on the thread the window belongs to, the Async version doesn't
 void Window::Show()
 {
     if (m_platformData.platform_handle != nullptr)
     {
         HWND hwnd = static_cast<HWND>(m_platformData.platform_handle);
-        ShowWindow(hwnd, SW_SHOW);
-        UpdateWindow(hwnd);
+        if (m_messages->thread)
+        {
+            ShowWindowAsync(hwnd, SW_SHOW);
+        }
+        else
+        {
+            ShowWindow(hwnd, SW_SHOW);
+            UpdateWindow(hwnd);
+        }
     }
 }
 
@@ -243,7 +733,14 @@ void Window::Hide()
     if (m_platformData.platform_handle != nullptr)
     {
         HWND hwnd = static_cast<HWND>(m_platformData.platform_handle);
-        ShowWindow(hwnd, SW_HIDE);
+        if (m_messages->thread)
+        {
+            ShowWindowAsync(hwnd, SW_HIDE);
+        }
+        else
+        {
+            ShowWindow(hwnd, SW_HIDE);
+        }
     }
 }
 
@@ -257,28 +754,175 @@ bool Window::IsVisible() const
     return false;
 }
 
+bool Window::IsMinimized() const
+{
+    if (m_platformData.platform_handle != nullptr)
+    {
+        HWND hwnd = static_cast<HWND>(m_platformData.platform_handle);
+        return IsIconic(hwnd) != 0;
+    }
+    return false;
+}
+
+void Window::SetTitle(const char* title)
+{
+    if (m_platformData.platform_handle != nullptr)
+    {
+        HWND hwnd = static_cast<HWND>(m_platformData.platform_handle);
+        if (m_messages->thread)
+        {
+            // SetWindowTextA would wait for the message thread to get to it. Only the latest
+            // title matters, so one posted message covers any number of calls before it's handled.
+            m_messages->titleLock.Lock();
+            m_messages->pendingTitle = StringView(title);
+            const bool post = !m_messages->titlePosted;
+            m_messages->titlePosted = true;
+            m_messages->titleLock.Unlock();
+            if (post)
+            {
+                PostMessageA(hwnd, kSetTitleMessage, 0, 0);
+            }
+        }
+        else
+        {
+            SetWindowTextA(hwnd, title);
+        }
+    }
+}
+
+void Window::SetMode(WindowMode mode)
+{
+    if (m_platformData.platform_handle != nullptr && mode != m_mode)
+    {
+        HWND hwnd = static_cast<HWND>(m_platformData.platform_handle);
+        if (m_messages->thread)
+        {
+            PostMessageA(hwnd, kSetModeMessage, static_cast<WPARAM>(mode), 0);
+        }
+        else
+        {
+            ApplyWindowMode(hwnd, m_messages, mode);
+        }
+        m_mode = mode;
+    }
+}
+
+bool Window::PopInputEvent(InputEvent& event)
+{
+    return m_messages->input.TryPop(event);
+}
+
+uint64 Window::DroppedInputEvents() const
+{
+    return m_messages->droppedInput.load(std::memory_order_relaxed);
+}
+
 WindowMessageResult Window::ProcessMessages()
 {
-    MSG msg;
+    RSBL_PROFILE_ZONE("Window::ProcessMessages");
 
-    // Process all pending messages (non-blocking with PM_REMOVE)
-    // NOTE: Shouldn't we be passing in our hwnd in?
-    while (::PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
+    if (!m_messages->thread)
     {
-        // Check if it's a quit message
-        if (msg.message == WM_QUIT)
+        MSG msg;
+
+        // Process all pending messages (non-blocking with PM_REMOVE)
+        // NOTE: Shouldn't we be passing in our hwnd in?
+        while (::PeekMessageA(&msg, nullptr, 0, 0, PM_REMOVE))
         {
-            return WindowMessageResult::Quit;
+            // Check if it's a quit message
+            if (msg.message == WM_QUIT)
+            {
+                m_messages->quit.store(true, std::memory_order_release);
+                break;
+            }
+
+            // Translate virtual-key messages into character messages
+            ::TranslateMessage(&msg);
+
+            // Dispatch message to WindowProc
+            ::DispatchMessageA(&msg);
         }
+    }
 
-        // Translate virtual-key messages into character messages
-        ::TranslateMessage(&msg);
+    return DrainEvents();
+}
 
-        // Dispatch message to WindowProc
-        ::DispatchMessageA(&msg);
+WindowMessageResult Window::WaitForEvents(uint32 timeoutMs,
+                                          ArrayView<void* const> extraWaitHandles,
+                                          uint32* signalledHandle)
+{
+    RSBL_PROFILE_ZONE("Window::WaitForEvents");
+
+    // One slot is left for the message thread's wake event
+    HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+    rsblAssertMsg(extraWaitHandles.Size() < MAXIMUM_WAIT_OBJECTS - 1, "Too many wait handles");
+    const DWORD extra_count = static_cast<DWORD>(extraWaitHandles.Size());
+    for (DWORD i = 0; i < extra_count; ++i)
+    {
+        handles[i] = static_cast<HANDLE>(extraWaitHandles[i]);
+    }
+
+    DWORD woke;
+    if (m_messages->thread)
+    {
+        // Whatever the message thread queued since the last call is waiting already
+        handles[extra_count] = m_messages->wake;
+        woke = WaitForMultipleObjects(extra_count + 1, handles, FALSE, timeoutMs);
+    }
+    else
+    {
+        // MWMO_INPUTAVAILABLE wakes for messages already in the queue too, not just new ones
+        woke = MsgWaitForMultipleObjectsEx(
+            extra_count, handles, timeoutMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    }
+
+    if (signalledHandle != nullptr)
+    {
+        // Timeouts and failures are well past the handles' range
+        const DWORD index = woke - WAIT_OBJECT_0;
+        *signalledHandle = index < extra_count ? index : ~0u;
+    }
+    return ProcessMessages();
+}
+
+WindowMessageResult Window::DrainEvents()
+{
+    WindowEvent event;
+    while (m_messages->events.TryPop(event))
+    {
+        switch (event.type)
+        {
+        case WindowEvent::Type::Resized:
+            if (event.size.x != m_size.x || event.size.y != m_size.y)
+            {
+                m_size = event.size;
+                m_resizeFlagged = true;
+            }
+            break;
+        case WindowEvent::Type::Moved:
+            m_position = event.position;
+            break;
+        case WindowEvent::Type::DpiChanged:
+            m_dpiScale = static_cast<float>(event.dpi) / kDefaultDpi;
+            break;
+        }
+    }
+
+    // Reading it after the ring is empty means nothing newer than the window itself is lost
+    HWND hwnd = static_cast<HWND>(m_platformData.platform_handle);
+    if (m_messages->dropped.exchange(false, std::memory_order_acquire) && hwnd != nullptr)
+    {
+        const uint2 size = QueryClientSize(hwnd, m_size);
+        if (size.x != m_size.x || size.y != m_size.y)
+        {
+            m_size = size;
+            m_resizeFlagged = true;
+        }
+        m_position = QueryPosition(hwnd, m_position);
     }
 
-    return WindowMessageResult::Continue;
+    return m_messages->quit.load(std::memory_order_acquire) ? WindowMessageResult::Quit
+                                                             : WindowMessageResult::Continue;
 }
 
 } // namespace rsbl
@@ -0,0 +1,137 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-profile.h>
+
+#include <atomic>
+
+// Per-frame counters and gauges, for watching what a frame does while tuning a scene:
+//
+//     RSBL_COUNTER_ADD("ga.draws", draw_count);   // Summed over the frame, then starts over
+//     RSBL_GAUGE_SET("scene.nodes", node_count);  // Holds its last value across frames
+//
+//     ... once a frame, on the main thread ...
+//     Counters::EndFrame();
+//
+// Each call site looks its counter up once, after that adding is a relaxed atomic add, from any
+// thread. EndFrame snapshots every counter into a rolling history of kCounterHistoryFrames, which
+// the stats, the overlay text and the CSV or JSON dumps read. Names are only kept as pointers, so
+// they're string literals. Compiled out with RSBL_PROFILER=Off, like the zones.
+
+#if RSBL_PROFILE_BACKEND != RSBL_PROFILE_BACKEND_OFF
+    #define RSBL_COUNTER_ADD(name, n)                                                              \
+        do                                                                                         \
+        {                                                                                          \
+            static ::rsbl::Counter* const rsblCounter =                                            \
+                ::rsbl::Counters::Get(name, ::rsbl::CounterKind::Counter);                         \
+            rsblCounter->Add(static_cast<int64>(n));                                               \
+        } while (0)
+    #define RSBL_GAUGE_SET(name, value)                                                            \
+        do                                                                                         \
+        {                                                                                          \
+            static ::rsbl::Counter* const rsblGauge =                                              \
+                ::rsbl::Counters::Get(name, ::rsbl::CounterKind::Gauge);                           \
+            rsblGauge->Set(static_cast<int64>(value));                                             \
+        } while (0)
+#else
+    #define RSBL_COUNTER_ADD(name, n) ((void)0)
+    #define RSBL_GAUGE_SET(name, value) ((void)0)
+#endif
+
+namespace rsbl
+{
+
+// Counters there's room for, registering more asserts
+constexpr uint32 kMaxCounters = 256;
+
+// Frames of history each counter keeps
+constexpr uint32 kCounterHistoryFrames = 256;
+
+enum class CounterKind : uint8
+{
+    Counter, // Reset by each EndFrame, so its history is per frame
+    Gauge,   // Kept as last set
+};
+
+enum class CounterDumpFormat : uint8
+{
+    Csv,  // A row per frame of history, a column per counter
+    Json, // Each counter's stats and history
+};
+
+// Its own cache line, so counters hit from different threads don't share one
+struct alignas(64) Counter
+{
+    std::atomic<int64> value{0};
+    const char* name = nullptr;
+    CounterKind kind = CounterKind::Counter;
+
+    void Add(int64 n)
+    {
+        value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void Set(int64 n)
+    {
+        value.store(n, std::memory_order_relaxed);
+    }
+};
+
+// Over the frames in the history
+struct CounterStats
+{
+    const char* name = nullptr;
+    CounterKind kind = CounterKind::Counter;
+    int64 last = 0; // The most recent frame's
+    int64 min = 0;
+    int64 max = 0;
+    double average = 0.0;
+    uint32 frames = 0; // Frames of history so far, up to kCounterHistoryFrames
+};
+
+// Only Get and the counters themselves are for any thread. The rest belong to the thread that
+// calls EndFrame.
+class Counters
+{
+  public:
+    // The counter called name, registered as kind the first time it's asked for
+    static Counter* Get(const char* name, CounterKind kind);
+
+    // Snapshots every counter into the history, resets the counters, and writes the dump if one
+    // is due
+    static void EndFrame();
+
+    // Frames ended so far
+    static uint64 FrameCount();
+
+    // Registered so far, indexed from 0 in the order they were
+    static uint32 Count();
+
+    // The counter's index, or kMaxCounters if nothing has registered it
+    static uint32 Find(const char* name);
+
+    static CounterStats Stats(uint32 index);
+
+    // The counter's history, oldest frame first
+    static void History(uint32 index, DynamicArray<int64>& out);
+
+    // A line per counter with its last value, average and max, separated by separator, say " | "
+    // for a window title
+    static void BuildOverlay(String& text, const char* separator = "\n");
+
+    static void BuildCsv(String& csv);
+    static void BuildJson(String& json);
+
+    // Writes the dump to path every interval EndFrames, replacing the last one. The CSV holds
+    // the history's frames, so an interval up to kCounterHistoryFrames misses none. An interval
+    // of 0 stops the dumps.
+    static void SetDump(const char* path, CounterDumpFormat format, uint32 interval);
+
+    // Forgets the history and zeroes the counters, which stay registered
+    static void Clear();
+};
+
+} // namespace rsbl
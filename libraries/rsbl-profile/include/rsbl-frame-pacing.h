@@ -0,0 +1,106 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-string.h>
+
+// Where each frame's time goes between sampling input and showing up on screen, and how evenly
+// frames arrive. A frame loop marks each stage as the frame gets to it, and the stages that are
+// only known later, GPU completion and display, once they're read back:
+//
+//     FramePacing pacing(Clock::TicksPerSecond());
+//     ... each frame ...
+//     pacing.Mark(frame, FrameStage::Input, Clock::NowTicks());
+//     ... update ...
+//     pacing.Mark(frame, FrameStage::Submit, Clock::NowTicks());
+//     ... frames later, from GPU timestamps and present statistics ...
+//     pacing.Mark(gpuFrame, FrameStage::GpuDone, gpuEndTicks);
+//     pacing.Mark(shownFrame, FrameStage::Displayed, displayedTicks);
+//
+//     String text;
+//     AppendFramePacingReport(text, pacing.Report());
+//
+// Ticks are whatever clock the caller uses throughout, at the rate it's constructed with.
+
+namespace rsbl
+{
+
+enum class FrameStage : uint8
+{
+    Input,      // Input sampled, the start of the frame's latency
+    Simulation, // Update starts
+    Submit,     // The frame's work handed to the GPU
+    Present,    // Present called
+    GpuDone,    // The GPU finished the frame's work
+    Displayed,  // The frame reached the screen
+
+    Count,
+};
+
+constexpr uint32 kFrameStageCount = static_cast<uint32>(FrameStage::Count);
+
+const char* FrameStageName(FrameStage stage);
+
+struct FrameTimeDistribution
+{
+    uint32 samples = 0;
+    double meanMs = 0.0;
+    double stdDevMs = 0.0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0; // Nearest rank, a time that was measured
+    double maxMs = 0.0;
+};
+
+struct FramePacingReport
+{
+    uint32 frames = 0; // Frames in the history with any stages marked
+
+    // From each stage to the next one marked, e.g. Input to Simulation, over frames that
+    // marked both. stages[i] starts at FrameStage i.
+    FrameTimeDistribution stages[kFrameStageCount - 1];
+
+    // Input to Displayed, or to Present for frames whose display isn't known
+    FrameTimeDistribution latency;
+
+    // Between consecutive frames' presents, what the CPU paced, and their displays, what the
+    // player saw. Tight distributions are smooth; a p99 far over the median is a hitch.
+    FrameTimeDistribution presentInterval;
+    FrameTimeDistribution displayInterval;
+
+    // Frames shown more than half as late again as the median display interval
+    uint32 hitches = 0;
+};
+
+class FramePacing
+{
+  public:
+    explicit FramePacing(uint64 ticksPerSecond, uint32 historyFrames = 256);
+
+    // Stages can be marked in any order, and frames late, as long as it's within historyFrames
+    // of the newest frame marked. Older marks are dropped.
+    void Mark(uint64 frame, FrameStage stage, uint64 ticks);
+
+    // The frames in the history
+    FramePacingReport Report() const;
+
+    void Clear();
+
+  private:
+    struct FrameRecord
+    {
+        uint64 frame = ~0ull;
+        uint64 ticks[kFrameStageCount] = {}; // 0 until marked
+    };
+
+    double m_msPerTick;
+    DynamicArray<FrameRecord> m_frames; // By frame, modulo the history
+    uint64 m_newest = 0;
+};
+
+// A line per stage, then the latency, intervals and hitches
+void AppendFramePacingReport(String& text, const FramePacingReport& report);
+
+} // namespace rsbl
@@ -0,0 +1,128 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-profile.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+#include <rsbl-string.h>
+
+// CPU performance counters, for when wall clock time isn't enough to tell whether a layout change
+// helped. Counts the calling thread, in user mode only:
+//
+//     HwCounterSample sort_counters;
+//     {
+//         HwZone zone("Sort", sort_counters);
+//         RadixSort(keys);
+//     }
+//     String text;
+//     AppendHwCounters(text, sort_counters, keys.Size()); // "ipc 2.41, 0.02 llc misses, ..."
+//
+// Linux reads them through perf_event_open, which needs kernel.perf_event_paranoid at 2 or below,
+// and a CPU that exposes its PMU (VMs often don't). Elsewhere, Windows included, there's no
+// user mode way in yet and HwCounters::Create fails, zones then just time.
+
+namespace rsbl
+{
+
+enum class HwEvent : uint8
+{
+    Cycles,
+    Instructions,
+    LlcMisses, // Last level cache misses
+    BranchMisses,
+
+    Count,
+};
+
+constexpr uint32 kHwEventCount = static_cast<uint32>(HwEvent::Count);
+
+const char* HwEventName(HwEvent event);
+
+struct HwCounterSample
+{
+    uint64 values[kHwEventCount] = {};
+    uint32 available = 0; // A bit per HwEvent the CPU counted
+
+    bool Has(HwEvent event) const
+    {
+        return (available & (1u << static_cast<uint32>(event))) != 0;
+    }
+
+    uint64 Get(HwEvent event) const
+    {
+        return values[static_cast<uint32>(event)];
+    }
+
+    // Instructions per cycle, 0 without both
+    double Ipc() const
+    {
+        return Has(HwEvent::Cycles) && Has(HwEvent::Instructions) && Get(HwEvent::Cycles) != 0
+                   ? static_cast<double>(Get(HwEvent::Instructions)) / Get(HwEvent::Cycles)
+                   : 0.0;
+    }
+
+    HwCounterSample& operator+=(const HwCounterSample& other)
+    {
+        for (uint32 i = 0; i < kHwEventCount; ++i)
+        {
+            values[i] += other.values[i];
+        }
+        available |= other.available;
+        return *this;
+    }
+};
+
+// One thread's counters, which only that thread reads
+class HwCounters
+{
+  public:
+    // Opens the counters for the calling thread. Events the CPU can't count are left out, and
+    // it fails if it can't count any.
+    static Result<UniquePtr<HwCounters>> Create();
+
+    ~HwCounters();
+
+    HwCounters(const HwCounters&) = delete;
+    HwCounters& operator=(const HwCounters&) = delete;
+
+    // Totals since Create. Scaled up if the kernel had to share the PMU with other counters.
+    HwCounterSample Read() const;
+
+    // The calling thread's, opened on first use. Null where there are no counters.
+    static HwCounters* ForThread();
+
+  private:
+    HwCounters() = default;
+
+    int m_group = -1; // The group leader, which reads all of them
+    int m_fds[kHwEventCount] = {-1, -1, -1, -1};
+    uint8 m_order[kHwEventCount] = {}; // The event each group slot holds
+    uint32 m_count = 0;
+    uint32 m_available = 0;
+};
+
+// Adds the counters over its scope to total, and records it as a profile zone too. Counts on the
+// thread it's created on, so not for scopes that can move fibers between threads.
+class HwZone
+{
+  public:
+    HwZone(const char* name, HwCounterSample& total);
+    ~HwZone();
+
+    HwZone(const HwZone&) = delete;
+    HwZone& operator=(const HwZone&) = delete;
+
+  private:
+    ProfileZone m_zone;
+    HwCounterSample& m_total;
+    HwCounters* m_counters;
+    HwCounterSample m_start;
+};
+
+// "ipc 2.41, 120.5 cycles, 0.02 llc misses, 0.10 branch misses", each count divided by per,
+// e.g. per item. Only what was counted, and "no counters" if nothing was.
+void AppendHwCounters(String& text, const HwCounterSample& sample, uint64 per = 1);
+
+} // namespace rsbl
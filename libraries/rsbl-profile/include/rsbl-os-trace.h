@@ -0,0 +1,137 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-int-types.h>
+
+// Profile zones and a few key events, handed to the OS tracer so they line up with what the
+// scheduler, disks and GPU driver were doing at the time:
+//   Windows: ETW events from the TraceLogging provider "rsbl", for WPR and WPA. Each kind of
+//     event has its own keyword, see OsTraceKeyword.
+//       xperf -on Base -start rsbl -on 137cd118-9375-462a-9c0f-feb8fab270e9
+//       ... xperf -stop rsbl -stop -d trace.etl
+//   Linux: USDT probes, provider rsbl, for perf and bpftrace. Needs sys/sdt.h (systemtap-sdt-dev
+//     or systemtap-sdt-devel) when building, without it the probes aren't compiled in.
+//       perf buildid-cache --add ./app && perf record -e 'sdt_rsbl:*' ./app
+//
+// Each kind is only sent while a session listens for it. Until then the cost is a load and a
+// branch not taken: on Linux the load is the probe's semaphore, which perf and bpftrace raise as
+// they attach, and on Windows a flag ETW's enable callback sets.
+//
+// Zones and frames go out with the built-in profiler backend, from ProfileZone and MarkFrame.
+// Times are Profiler::Now ticks.
+
+namespace rsbl
+{
+
+enum class OsTraceEvent : uint8
+{
+    Zone,            // A profile zone, over start to end
+    Frame,           // From one frame mark to the next, id is the frame's number
+    Present,         // A swapchain present, id is the swapchain
+    IoSubmit,        // An async read going to the OS, id is its userData, value its size
+    IoComplete,      // An async read reaped, id is its userData, value the bytes read
+    PipelineCompile, // A pipeline compiled, over start to end, id is the pipeline's key
+
+    Count,
+};
+
+constexpr uint32 kOsTraceEventCount = static_cast<uint32>(OsTraceEvent::Count);
+
+// The ETW keyword each kind is sent under, to pick which ones a session records
+constexpr uint64 OsTraceKeyword(OsTraceEvent event)
+{
+    return 1ull << static_cast<uint32>(event);
+}
+
+} // namespace rsbl
+
+// Nonzero while a session listens for the kind. The USDT semaphores on Linux, where their names
+// are what sys/sdt.h expects for provider rsbl, and set by the enable callback on Windows.
+extern "C"
+{
+    extern volatile uint16 rsbl_zone_semaphore;
+    extern volatile uint16 rsbl_frame_semaphore;
+    extern volatile uint16 rsbl_present_semaphore;
+    extern volatile uint16 rsbl_io_submit_semaphore;
+    extern volatile uint16 rsbl_io_complete_semaphore;
+    extern volatile uint16 rsbl_pipeline_compile_semaphore;
+}
+
+namespace rsbl
+{
+
+inline bool OsTraceEnabled(OsTraceEvent event)
+{
+    switch (event)
+    {
+    case OsTraceEvent::Zone:
+        return rsbl_zone_semaphore != 0;
+    case OsTraceEvent::Frame:
+        return rsbl_frame_semaphore != 0;
+    case OsTraceEvent::Present:
+        return rsbl_present_semaphore != 0;
+    case OsTraceEvent::IoSubmit:
+        return rsbl_io_submit_semaphore != 0;
+    case OsTraceEvent::IoComplete:
+        return rsbl_io_complete_semaphore != 0;
+    case OsTraceEvent::PipelineCompile:
+        return rsbl_pipeline_compile_semaphore != 0;
+    default:
+        return false;
+    }
+}
+
+// Sends an event, whether or not anything listens, so check OsTraceEnabled first. name is any
+// string, only read during the call.
+void OsTraceEmit(
+    OsTraceEvent event, const char* name, uint64 id, uint64 value, uint64 start, uint64 end);
+
+// Profiler::Now, out of line
+uint64 OsTraceNow();
+
+// An event at a point in time, if anything listens
+inline void OsTraceMark(OsTraceEvent event, const char* name, uint64 id, uint64 value = 0)
+{
+    if (OsTraceEnabled(event)) [[unlikely]]
+    {
+        const uint64 now = OsTraceNow();
+        OsTraceEmit(event, name, id, value, now, now);
+    }
+}
+
+// An event over its scope, if anything was listening as it began
+class OsTraceScope
+{
+  public:
+    OsTraceScope(OsTraceEvent event, const char* name, uint64 id)
+        : m_name(name)
+        , m_id(id)
+        , m_event(event)
+    {
+        if (OsTraceEnabled(event)) [[unlikely]]
+        {
+            m_start = OsTraceNow();
+        }
+    }
+
+    ~OsTraceScope()
+    {
+        if (m_start != 0) [[unlikely]]
+        {
+            OsTraceEmit(m_event, m_name, m_id, 0, m_start, OsTraceNow());
+        }
+    }
+
+    OsTraceScope(const OsTraceScope&) = delete;
+    OsTraceScope& operator=(const OsTraceScope&) = delete;
+
+  private:
+    const char* m_name;
+    uint64 m_id;
+    uint64 m_start = 0; // 0 when nothing was listening
+    OsTraceEvent m_event;
+};
+
+} // namespace rsbl
@@ -0,0 +1,193 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-int-types.h>
+#include <rsbl-os-trace.h>
+#include <rsbl-string.h>
+
+#include <atomic>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+// CPU profiling. A zone times the rest of its scope on the thread running it, and frame marks
+// split the timeline into frames:
+//
+//     void UpdateScene()
+//     {
+//         RSBL_PROFILE_ZONE("UpdateScene");
+//         ...
+//     }
+//
+//     ... once a frame, on the main thread ...
+//     RSBL_PROFILE_FRAME();
+//
+// What's behind the macros is picked when configuring, with RSBL_PROFILER:
+//   Builtin, the default: each thread records into a ring of its own, a couple of timestamps and
+//     a few stores a zone, no locks. Rings overwrite their oldest zones, so Profiler's Chrome
+//     trace is the most recent stretch, like the job system's traces. Cheap enough to leave on.
+//   Tracy: Tracy's zones and frame marks, for its profiler to watch live. external/tracy, see
+//     external_deps.toml.
+//   Off: compiled out.
+// With the built-in backend, zones and frames also go to ETW or perf while they're tracing, see
+// rsbl-os-trace.h.
+// Names are only kept as pointers, so they're string literals, or last as long as the capture.
+
+#define RSBL_PROFILE_BACKEND_OFF 0
+#define RSBL_PROFILE_BACKEND_BUILTIN 1
+#define RSBL_PROFILE_BACKEND_TRACY 2
+
+#ifndef RSBL_PROFILE_BACKEND
+    #define RSBL_PROFILE_BACKEND RSBL_PROFILE_BACKEND_BUILTIN
+#endif
+
+#define RSBL_PROFILE_CONCAT_INNER(a, b) a##b
+#define RSBL_PROFILE_CONCAT(a, b) RSBL_PROFILE_CONCAT_INNER(a, b)
+
+#if RSBL_PROFILE_BACKEND == RSBL_PROFILE_BACKEND_TRACY
+    #include <tracy/Tracy.hpp>
+
+    #define RSBL_PROFILE_ZONE(name) ZoneScopedN(name)
+    #define RSBL_PROFILE_FRAME() FrameMark
+    // Copied, the name can go once it's set
+    #define RSBL_PROFILE_THREAD(name) ::tracy::SetThreadName(name)
+    // Zones on fibers that move between threads belong to the fiber. name is the fiber's own,
+    // for as long as it runs.
+    #define RSBL_PROFILE_FIBER_ENTER(name) TracyFiberEnter(name)
+    #define RSBL_PROFILE_FIBER_LEAVE() TracyFiberLeave
+#elif RSBL_PROFILE_BACKEND == RSBL_PROFILE_BACKEND_BUILTIN
+    #define RSBL_PROFILE_ZONE(name)                                                               \
+        ::rsbl::ProfileZone RSBL_PROFILE_CONCAT(profileZone, __LINE__)(name)
+    #define RSBL_PROFILE_FRAME() ::rsbl::Profiler::MarkFrame()
+    #define RSBL_PROFILE_THREAD(name) ::rsbl::Profiler::SetThreadName(name)
+    // A zone is recorded whole as it ends, on the thread it ends on, so fibers need nothing
+    #define RSBL_PROFILE_FIBER_ENTER(name) ((void)0)
+    #define RSBL_PROFILE_FIBER_LEAVE() ((void)0)
+#else
+    #define RSBL_PROFILE_ZONE(name) ((void)0)
+    #define RSBL_PROFILE_FRAME() ((void)0)
+    #define RSBL_PROFILE_THREAD(name) ((void)0)
+    #define RSBL_PROFILE_FIBER_ENTER(name) ((void)0)
+    #define RSBL_PROFILE_FIBER_LEAVE() ((void)0)
+#endif
+
+namespace rsbl
+{
+
+// Zones each thread's ring holds
+constexpr uint32 kProfileRingEvents = 1u << 14;
+
+struct ProfileEvent
+{
+    uint64 start = 0;
+    uint64 end = 0;              // For a frame mark, the frame's number
+    const char* name = nullptr; // Null for a frame mark
+};
+
+namespace Internal
+{
+    // One writer, the thread it belongs to, and any number of readers
+    struct ProfileRing
+    {
+        ProfileEvent* events = nullptr;
+        std::atomic<uint64> head{0};
+        uint32 threadId = 0; // From 1, in the order threads first recorded
+        char threadName[32] = {};
+    };
+
+    extern thread_local ProfileRing* t_profileRing;
+
+    // Gives the calling thread a ring, one a finished thread left if there is one
+    ProfileRing* CreateProfileRing();
+} // namespace Internal
+
+// The built-in backend, which the macros use with RSBL_PROFILER=Builtin. Usable directly under
+// any backend.
+class Profiler
+{
+  public:
+    // Raw CPU timestamp, as Clock::Cycles. BuildChromeTrace converts them to time against the
+    // steady clock, so they need a constant rate, which every x64 and ARM64 CPU in use has.
+    static uint64 Now()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+        return static_cast<uint64>(_ReadStatusReg(ARM64_CNTVCT));
+#elif defined(__aarch64__)
+        uint64 value;
+        __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return SteadyNs();
+#endif
+    }
+
+    static void RecordZone(const char* name, uint64 start, uint64 end)
+    {
+        Internal::ProfileRing* ring = Internal::t_profileRing;
+        if (ring == nullptr)
+        {
+            ring = Internal::CreateProfileRing();
+        }
+        const uint64 head = ring->head.load(std::memory_order_relaxed);
+        ring->events[head & (kProfileRingEvents - 1)] = {start, end, name};
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    // Ends a frame and starts the next, on the calling thread's track
+    static void MarkFrame();
+
+    // Frames marked so far
+    static uint64 FrameCount();
+
+    // Names the calling thread's track, copying up to 31 chars
+    static void SetThreadName(const char* name);
+
+    // Chrome trace event JSON (chrome://tracing, ui.perfetto.dev) of every ring, a track per
+    // thread, in microseconds since the process started. Once a ring has wrapped, its oldest slot
+    // is left out, its thread may be overwriting it.
+    static void BuildChromeTrace(String& json);
+
+    // Forgets what's recorded. Only while no thread is recording.
+    static void Clear();
+
+  private:
+    static uint64 SteadyNs();
+};
+
+class ProfileZone
+{
+  public:
+    explicit ProfileZone(const char* name)
+        : m_name(name)
+        , m_start(Profiler::Now())
+    {
+    }
+
+    ~ProfileZone()
+    {
+        const uint64 end = Profiler::Now();
+        Profiler::RecordZone(m_name, m_start, end);
+        if (OsTraceEnabled(OsTraceEvent::Zone)) [[unlikely]]
+        {
+            OsTraceEmit(OsTraceEvent::Zone, m_name, 0, 0, m_start, end);
+        }
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+  private:
+    const char* m_name;
+    uint64 m_start;
+};
+
+} // namespace rsbl
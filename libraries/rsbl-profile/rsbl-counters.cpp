@@ -0,0 +1,310 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include <rsbl-counters.h>
+
+#include "rsbl-profile-internal.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-memory-tracking.h>
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace rsbl
+{
+
+namespace
+{
+using Internal::AppendFormat;
+
+struct Registry
+{
+    std::mutex mutex; // Registering only
+    Counter counters[kMaxCounters];
+    std::atomic<uint32> count{0};
+
+    // The EndFrame thread's from here down
+    std::atomic<uint64> frames{0}; // Read by Get too
+    uint64 firstFrame[kMaxCounters] = {}; // The frame each counter's history starts at
+    int64 history[kMaxCounters][kCounterHistoryFrames] = {};
+
+    String dumpPath;
+    CounterDumpFormat dumpFormat = CounterDumpFormat::Csv;
+    uint32 dumpInterval = 0;
+};
+
+// Never destroyed, threads can count while statics are going away
+Registry& GetRegistry()
+{
+    static Registry* registry = [] {
+        MemoryTagScope memoryScope(MemoryTag::Core);
+        return new Registry();
+    }();
+    return *registry;
+}
+
+uint32 HistoryFrames(const Registry& registry, uint32 index)
+{
+    const uint64 frames =
+        registry.frames.load(std::memory_order_relaxed) - registry.firstFrame[index];
+    return frames < kCounterHistoryFrames ? static_cast<uint32>(frames) : kCounterHistoryFrames;
+}
+
+// The history's frame back frames before the most recent
+int64 HistoryAt(const Registry& registry, uint32 index, uint32 back)
+{
+    const uint64 frame = registry.frames.load(std::memory_order_relaxed) - 1 - back;
+    return registry.history[index][frame % kCounterHistoryFrames];
+}
+
+void WriteDump(const Registry& registry)
+{
+    String text;
+    if (registry.dumpFormat == CounterDumpFormat::Csv)
+    {
+        Counters::BuildCsv(text);
+    }
+    else
+    {
+        Counters::BuildJson(text);
+    }
+
+    FILE* file = std::fopen(registry.dumpPath.CStr(), "wb");
+    if (file == nullptr)
+    {
+        return;
+    }
+    std::fwrite(text.Data(), 1, text.Size(), file);
+    std::fclose(file);
+}
+} // namespace
+
+Counter* Counters::Get(const char* name, CounterKind kind)
+{
+    Registry& registry = GetRegistry();
+    std::lock_guard lock(registry.mutex);
+    const uint32 count = registry.count.load(std::memory_order_relaxed);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        // Call sites in different libraries can have their own copies of a literal
+        if (std::strcmp(registry.counters[i].name, name) == 0)
+        {
+            rsblAssert(registry.counters[i].kind == kind);
+            return &registry.counters[i];
+        }
+    }
+
+    rsblAssertMsg(count < kMaxCounters, "Out of counters, raise kMaxCounters");
+    Counter& counter = registry.counters[count];
+    counter.name = name;
+    counter.kind = kind;
+    // Its history starts at the next EndFrame. Written here, and read on the EndFrame thread
+    // after the count's acquire.
+    registry.firstFrame[count] = registry.frames.load(std::memory_order_relaxed);
+    registry.count.store(count + 1, std::memory_order_release);
+    return &counter;
+}
+
+void Counters::EndFrame()
+{
+    Registry& registry = GetRegistry();
+    const uint32 count = registry.count.load(std::memory_order_acquire);
+    const uint64 frame = registry.frames.load(std::memory_order_relaxed);
+    const uint64 slot = frame % kCounterHistoryFrames;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        Counter& counter = registry.counters[i];
+        registry.history[i][slot] = counter.kind == CounterKind::Counter
+                                        ? counter.value.exchange(0, std::memory_order_relaxed)
+                                        : counter.value.load(std::memory_order_relaxed);
+    }
+    registry.frames.store(frame + 1, std::memory_order_relaxed);
+
+    if (registry.dumpInterval != 0 && (frame + 1) % registry.dumpInterval == 0)
+    {
+        WriteDump(registry);
+    }
+}
+
+uint64 Counters::FrameCount()
+{
+    return GetRegistry().frames.load(std::memory_order_relaxed);
+}
+
+uint32 Counters::Count()
+{
+    return GetRegistry().count.load(std::memory_order_acquire);
+}
+
+uint32 Counters::Find(const char* name)
+{
+    const Registry& registry = GetRegistry();
+    const uint32 count = registry.count.load(std::memory_order_acquire);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (std::strcmp(registry.counters[i].name, name) == 0)
+        {
+            return i;
+        }
+    }
+    return kMaxCounters;
+}
+
+CounterStats Counters::Stats(uint32 index)
+{
+    const Registry& registry = GetRegistry();
+    rsblAssert(index < registry.count.load(std::memory_order_acquire));
+
+    CounterStats stats;
+    stats.name = registry.counters[index].name;
+    stats.kind = registry.counters[index].kind;
+    stats.frames = HistoryFrames(registry, index);
+    if (stats.frames == 0)
+    {
+        return stats;
+    }
+
+    stats.last = HistoryAt(registry, index, 0);
+    stats.min = stats.last;
+    stats.max = stats.last;
+    double sum = 0.0;
+    for (uint32 back = 0; back < stats.frames; ++back)
+    {
+        const int64 value = HistoryAt(registry, index, back);
+        stats.min = value < stats.min ? value : stats.min;
+        stats.max = value > stats.max ? value : stats.max;
+        sum += static_cast<double>(value);
+    }
+    stats.average = sum / stats.frames;
+    return stats;
+}
+
+void Counters::History(uint32 index, DynamicArray<int64>& out)
+{
+    const Registry& registry = GetRegistry();
+    rsblAssert(index < registry.count.load(std::memory_order_acquire));
+
+    const uint32 frames = HistoryFrames(registry, index);
+    out.Clear();
+    out.Reserve(frames);
+    for (uint32 back = frames; back > 0; --back)
+    {
+        out.PushBack(HistoryAt(registry, index, back - 1));
+    }
+}
+
+void Counters::BuildOverlay(String& text, const char* separator)
+{
+    const uint32 count = Count();
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const CounterStats stats = Stats(i);
+        if (i > 0)
+        {
+            text.Append(separator);
+        }
+        if (stats.kind == CounterKind::Gauge)
+        {
+            AppendFormat(text, "%.128s %lld", stats.name, static_cast<long long>(stats.last));
+            continue;
+        }
+        AppendFormat(text,
+                     "%.128s %lld (avg %.1f, max %lld)",
+                     stats.name,
+                     static_cast<long long>(stats.last),
+                     stats.average,
+                     static_cast<long long>(stats.max));
+    }
+}
+
+void Counters::BuildCsv(String& csv)
+{
+    const Registry& registry = GetRegistry();
+    const uint32 count = registry.count.load(std::memory_order_acquire);
+    const uint64 frames_ended = registry.frames.load(std::memory_order_relaxed);
+
+    csv.Append("frame");
+    for (uint32 i = 0; i < count; ++i)
+    {
+        csv.Append(',');
+        csv.Append(registry.counters[i].name);
+    }
+    csv.Append('\n');
+
+    // Counters registered partway through the history are empty for the frames before theirs
+    const uint32 frames = static_cast<uint32>(
+        frames_ended < kCounterHistoryFrames ? frames_ended : kCounterHistoryFrames);
+    for (uint32 back = frames; back > 0; --back)
+    {
+        const uint64 frame = frames_ended - back;
+        AppendFormat(csv, "%llu", static_cast<unsigned long long>(frame));
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (frame < registry.firstFrame[i])
+            {
+                csv.Append(',');
+                continue;
+            }
+            AppendFormat(csv, ",%lld", static_cast<long long>(HistoryAt(registry, i, back - 1)));
+        }
+        csv.Append('\n');
+    }
+}
+
+void Counters::BuildJson(String& json)
+{
+    const Registry& registry = GetRegistry();
+    const uint32 count = registry.count.load(std::memory_order_acquire);
+
+    AppendFormat(json,
+                 "{\"frames\":%llu,\"counters\":[",
+                 static_cast<unsigned long long>(FrameCount()));
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const CounterStats stats = Stats(i);
+        AppendFormat(json,
+                     "%s\n{\"name\":\"%.128s\",\"kind\":\"%s\",",
+                     i > 0 ? "," : "",
+                     stats.name,
+                     stats.kind == CounterKind::Gauge ? "gauge" : "counter");
+        AppendFormat(json,
+                     "\"last\":%lld,\"min\":%lld,\"max\":%lld,\"average\":%.3f,\"history\":[",
+                     static_cast<long long>(stats.last),
+                     static_cast<long long>(stats.min),
+                     static_cast<long long>(stats.max),
+                     stats.average);
+        for (uint32 back = stats.frames; back > 0; --back)
+        {
+            AppendFormat(json,
+                         back < stats.frames ? ",%lld" : "%lld",
+                         static_cast<long long>(HistoryAt(registry, i, back - 1)));
+        }
+        json.Append("]}");
+    }
+    json.Append("\n]}\n");
+}
+
+void Counters::SetDump(const char* path, CounterDumpFormat format, uint32 interval)
+{
+    Registry& registry = GetRegistry();
+    registry.dumpPath = path != nullptr ? path : "";
+    registry.dumpFormat = format;
+    registry.dumpInterval = path != nullptr ? interval : 0;
+}
+
+void Counters::Clear()
+{
+    Registry& registry = GetRegistry();
+    std::lock_guard lock(registry.mutex);
+    const uint32 count = registry.count.load(std::memory_order_relaxed);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        registry.counters[i].value.store(0, std::memory_order_relaxed);
+        registry.firstFrame[i] = 0;
+    }
+    registry.frames.store(0, std::memory_order_relaxed);
+}
+
+} // namespace rsbl
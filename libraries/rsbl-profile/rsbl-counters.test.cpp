@@ -0,0 +1,168 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-counters.h"
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+using namespace rsbl;
+
+TEST_SUITE("Counters")
+{
+    TEST_CASE("Counters sum over a frame and start over")
+    {
+        Counters::Clear();
+        for (int frame = 1; frame <= 3; ++frame)
+        {
+            for (int i = 0; i < frame; ++i)
+            {
+                RSBL_COUNTER_ADD("test.draws", 10);
+            }
+            Counters::EndFrame();
+        }
+
+        const uint32 index = Counters::Find("test.draws");
+        REQUIRE(index < Counters::Count());
+        const CounterStats stats = Counters::Stats(index);
+        CHECK(std::strcmp(stats.name, "test.draws") == 0);
+        CHECK(stats.frames == 3);
+        CHECK(stats.last == 30);
+        CHECK(stats.min == 10);
+        CHECK(stats.max == 30);
+        CHECK(stats.average == doctest::Approx(20.0));
+
+        DynamicArray<int64> history;
+        Counters::History(index, history);
+        REQUIRE(history.Size() == 3);
+        CHECK(history[0] == 10);
+        CHECK(history[1] == 20);
+        CHECK(history[2] == 30);
+    }
+
+    TEST_CASE("Gauges hold their value across frames")
+    {
+        Counters::Clear();
+        RSBL_GAUGE_SET("test.nodes", 5);
+        Counters::EndFrame();
+        Counters::EndFrame();
+
+        const CounterStats stats = Counters::Stats(Counters::Find("test.nodes"));
+        CHECK(stats.kind == CounterKind::Gauge);
+        CHECK(stats.frames == 2);
+        CHECK(stats.min == 5);
+        CHECK(stats.last == 5);
+    }
+
+    TEST_CASE("Call sites with the same name share a counter")
+    {
+        Counters::Clear();
+        Counter* first = Counters::Get("test.shared", CounterKind::Counter);
+        char copy[] = "test.shared";
+        CHECK(Counters::Get(copy, CounterKind::Counter) == first);
+        CHECK(Counters::Find("test.missing") == kMaxCounters);
+    }
+
+    TEST_CASE("Threads add to the same counter")
+    {
+        Counters::Clear();
+        constexpr int kThreads = 4;
+        constexpr int kAdds = 10000;
+        std::thread threads[kThreads];
+        for (std::thread& thread : threads)
+        {
+            thread = std::thread([] {
+                for (int i = 0; i < kAdds; ++i)
+                {
+                    RSBL_COUNTER_ADD("test.jobs", 1);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        Counters::EndFrame();
+        CHECK(Counters::Stats(Counters::Find("test.jobs")).last == kThreads * kAdds);
+    }
+
+    TEST_CASE("The history keeps the most recent frames")
+    {
+        Counters::Clear();
+        for (uint32 frame = 0; frame < kCounterHistoryFrames + 10; ++frame)
+        {
+            RSBL_COUNTER_ADD("test.uploads", frame);
+            Counters::EndFrame();
+        }
+
+        DynamicArray<int64> history;
+        Counters::History(Counters::Find("test.uploads"), history);
+        REQUIRE(history.Size() == kCounterHistoryFrames);
+        CHECK(history[0] == 10);
+        CHECK(history[kCounterHistoryFrames - 1] == kCounterHistoryFrames + 9);
+    }
+
+    TEST_CASE("Overlay, CSV and JSON list each counter")
+    {
+        Counters::Clear();
+        RSBL_COUNTER_ADD("test.bytes", 7);
+        Counters::EndFrame();
+        RSBL_COUNTER_ADD("test.bytes", 9);
+        Counters::EndFrame();
+
+        String overlay;
+        Counters::BuildOverlay(overlay, " | ");
+        CHECK(strstr(overlay.CStr(), "test.bytes 9 (avg 8.0, max 9)") != nullptr);
+        CHECK(strstr(overlay.CStr(), "\n") == nullptr);
+
+        String csv;
+        Counters::BuildCsv(csv);
+        CHECK(std::strncmp(csv.CStr(), "frame,", 6) == 0);
+        CHECK(strstr(csv.CStr(), "test.bytes") != nullptr);
+        // Two frames, a row each after the header
+        uint32 rows = 0;
+        for (const char c : csv.View())
+        {
+            rows += c == '\n' ? 1 : 0;
+        }
+        CHECK(rows == 3);
+
+        String json;
+        Counters::BuildJson(json);
+        CHECK(strstr(json.CStr(), "\"frames\":2") != nullptr);
+        CHECK(strstr(json.CStr(),
+                     "\"name\":\"test.bytes\",\"kind\":\"counter\",\"last\":9,\"min\":7,"
+                     "\"max\":9,\"average\":8.000,\"history\":[7,9]") != nullptr);
+    }
+
+    TEST_CASE("Dumps are written every interval")
+    {
+        Counters::Clear();
+        const char* path = "rsbl-counters-test.csv";
+        std::remove(path);
+        Counters::SetDump(path, CounterDumpFormat::Csv, 2);
+        RSBL_COUNTER_ADD("test.io", 1);
+        Counters::EndFrame();
+        FILE* file = std::fopen(path, "rb");
+        CHECK(file == nullptr);
+        if (file != nullptr)
+        {
+            std::fclose(file);
+        }
+
+        Counters::EndFrame();
+        file = std::fopen(path, "rb");
+        REQUIRE(file != nullptr);
+        char header[6] = {};
+        CHECK(std::fread(header, 1, sizeof(header), file) == sizeof(header));
+        CHECK(std::memcmp(header, "frame,", sizeof(header)) == 0);
+        std::fclose(file);
+
+        Counters::SetDump(nullptr, CounterDumpFormat::Csv, 0);
+        std::remove(path);
+    }
+}
@@ -0,0 +1,243 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include <rsbl-frame-pacing.h>
+
+#include "rsbl-profile-internal.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-sort.h>
+
+#include <cmath>
+#include <cstdio>
+
+namespace rsbl
+{
+
+namespace
+{
+using Internal::AppendFormat;
+
+FrameTimeDistribution Distribution(DynamicArray<uint64>& ticks, double msPerTick)
+{
+    FrameTimeDistribution distribution;
+    if (ticks.IsEmpty())
+    {
+        return distribution;
+    }
+
+    RadixSort(ticks);
+    const uint64 count = ticks.Size();
+    double sum = 0.0;
+    for (uint64 value : ticks)
+    {
+        sum += static_cast<double>(value);
+    }
+    const double mean = sum / static_cast<double>(count);
+    double squares = 0.0;
+    for (uint64 value : ticks)
+    {
+        const double difference = static_cast<double>(value) - mean;
+        squares += difference * difference;
+    }
+
+    // Nearest rank
+    const auto percentile = [&](double fraction) {
+        const uint64 rank = static_cast<uint64>(std::ceil(fraction * static_cast<double>(count)));
+        return static_cast<double>(ticks[rank > 0 ? rank - 1 : 0]) * msPerTick;
+    };
+
+    distribution.samples = static_cast<uint32>(count);
+    distribution.meanMs = mean * msPerTick;
+    distribution.stdDevMs = std::sqrt(squares / static_cast<double>(count)) * msPerTick;
+    distribution.p50Ms = percentile(0.5);
+    distribution.p99Ms = percentile(0.99);
+    distribution.maxMs = static_cast<double>(ticks[count - 1]) * msPerTick;
+    return distribution;
+}
+
+void AppendDistribution(String& text, const char* name, const FrameTimeDistribution& distribution)
+{
+    if (distribution.samples == 0)
+    {
+        AppendFormat(text, "%-22s -\n", name);
+        return;
+    }
+    AppendFormat(text,
+                 "%-22s mean %7.2f ms, sd %6.2f, p50 %7.2f, p99 %7.2f, max %7.2f (%u frames)\n",
+                 name,
+                 distribution.meanMs,
+                 distribution.stdDevMs,
+                 distribution.p50Ms,
+                 distribution.p99Ms,
+                 distribution.maxMs,
+                 distribution.samples);
+}
+} // namespace
+
+const char* FrameStageName(FrameStage stage)
+{
+    switch (stage)
+    {
+    case FrameStage::Input:
+        return "Input";
+    case FrameStage::Simulation:
+        return "Simulation";
+    case FrameStage::Submit:
+        return "Submit";
+    case FrameStage::Present:
+        return "Present";
+    case FrameStage::GpuDone:
+        return "GpuDone";
+    case FrameStage::Displayed:
+        return "Displayed";
+    default:
+        return "Unknown";
+    }
+}
+
+FramePacing::FramePacing(uint64 ticksPerSecond, uint32 historyFrames)
+    : m_msPerTick(1000.0 / static_cast<double>(ticksPerSecond))
+{
+    rsblAssert(ticksPerSecond > 0 && historyFrames > 1);
+    MemoryTagScope memoryScope(MemoryTag::Core);
+    m_frames.Resize(historyFrames);
+}
+
+void FramePacing::Mark(uint64 frame, FrameStage stage, uint64 ticks)
+{
+    rsblAssert(stage < FrameStage::Count);
+    if (frame + m_frames.Size() <= m_newest)
+    {
+        return;
+    }
+    m_newest = frame > m_newest ? frame : m_newest;
+
+    FrameRecord& record = m_frames[frame % m_frames.Size()];
+    if (record.frame != frame)
+    {
+        record = FrameRecord{};
+        record.frame = frame;
+    }
+    record.ticks[static_cast<uint32>(stage)] = ticks;
+}
+
+FramePacingReport FramePacing::Report() const
+{
+    FramePacingReport report;
+    const uint32 history = static_cast<uint32>(m_frames.Size());
+
+    MemoryTagScope memoryScope(MemoryTag::Core);
+    DynamicArray<uint64> samples;
+    samples.Reserve(history);
+
+    // Slots newer frames haven't reached yet still hold frames from too long ago
+    const auto live = [&](const FrameRecord& record) {
+        return record.frame != ~0ull && record.frame + history > m_newest;
+    };
+
+    const auto collect = [&](auto&& sample) {
+        samples.Clear();
+        for (const FrameRecord& record : m_frames)
+        {
+            uint64 ticks = 0;
+            if (live(record) && sample(record, ticks))
+            {
+                samples.PushBack(ticks);
+            }
+        }
+        return Distribution(samples, m_msPerTick);
+    };
+
+    // The record for the frame before, if the history still has it
+    const auto previous = [&](const FrameRecord& record) -> const FrameRecord* {
+        const FrameRecord& before = m_frames[(record.frame + history - 1) % history];
+        return record.frame > 0 && before.frame == record.frame - 1 ? &before : nullptr;
+    };
+
+    const auto between = [](uint64 from, uint64 to, uint64& ticks) {
+        ticks = to - from;
+        return from != 0 && to != 0 && to >= from;
+    };
+
+    for (const FrameRecord& record : m_frames)
+    {
+        report.frames += live(record) ? 1 : 0;
+    }
+
+    for (uint32 stage = 0; stage + 1 < kFrameStageCount; ++stage)
+    {
+        report.stages[stage] = collect([&](const FrameRecord& record, uint64& ticks) {
+            // To the next stage the frame marked
+            for (uint32 next = stage + 1; next < kFrameStageCount; ++next)
+            {
+                if (record.ticks[next] != 0)
+                {
+                    return between(record.ticks[stage], record.ticks[next], ticks);
+                }
+            }
+            return false;
+        });
+    }
+
+    constexpr uint32 kInput = static_cast<uint32>(FrameStage::Input);
+    constexpr uint32 kPresent = static_cast<uint32>(FrameStage::Present);
+    constexpr uint32 kDisplayed = static_cast<uint32>(FrameStage::Displayed);
+    report.latency = collect([&](const FrameRecord& record, uint64& ticks) {
+        const uint64 end =
+            record.ticks[kDisplayed] != 0 ? record.ticks[kDisplayed] : record.ticks[kPresent];
+        return between(record.ticks[kInput], end, ticks);
+    });
+
+    const auto interval = [&](uint32 stage) {
+        return collect([&](const FrameRecord& record, uint64& ticks) {
+            const FrameRecord* before = previous(record);
+            return before != nullptr && between(before->ticks[stage], record.ticks[stage], ticks);
+        });
+    };
+    report.presentInterval = interval(kPresent);
+    report.displayInterval = interval(kDisplayed);
+
+    // Against displays where they're known, presents otherwise
+    const bool displays = report.displayInterval.samples > 0;
+    const FrameTimeDistribution& paced = displays ? report.displayInterval : report.presentInterval;
+    const uint32 stage = displays ? kDisplayed : kPresent;
+    for (const FrameRecord& record : m_frames)
+    {
+        const FrameRecord* before = live(record) ? previous(record) : nullptr;
+        uint64 ticks = 0;
+        if (before != nullptr && between(before->ticks[stage], record.ticks[stage], ticks) &&
+            static_cast<double>(ticks) * m_msPerTick > paced.p50Ms * 1.5)
+        {
+            ++report.hitches;
+        }
+    }
+    return report;
+}
+
+void FramePacing::Clear()
+{
+    for (FrameRecord& record : m_frames)
+    {
+        record = FrameRecord{};
+    }
+    m_newest = 0;
+}
+
+void AppendFramePacingReport(String& text, const FramePacingReport& report)
+{
+    AppendFormat(text, "Frame pacing over %u frames\n", report.frames);
+    for (uint32 stage = 0; stage + 1 < kFrameStageCount; ++stage)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%s to next", FrameStageName(static_cast<FrameStage>(stage)));
+        AppendDistribution(text, name, report.stages[stage]);
+    }
+    AppendDistribution(text, "Latency", report.latency);
+    AppendDistribution(text, "Present interval", report.presentInterval);
+    AppendDistribution(text, "Display interval", report.displayInterval);
+    AppendFormat(text, "Hitches: %u\n", report.hitches);
+}
+
+} // namespace rsbl
@@ -0,0 +1,100 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-frame-pacing.h"
+
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+// A tick a microsecond, frames every 16 ms from 1 s in
+constexpr uint64 kTicksPerSecond = 1'000'000;
+constexpr uint64 kFrameTicks = 16'000;
+
+void MarkSteadyFrame(FramePacing& pacing, uint64 frame, uint64 extraDisplayTicks = 0)
+{
+    const uint64 input = 1'000'000 + frame * kFrameTicks;
+    pacing.Mark(frame, FrameStage::Input, input);
+    pacing.Mark(frame, FrameStage::Simulation, input + 1'000);
+    pacing.Mark(frame, FrameStage::Submit, input + 5'000);
+    pacing.Mark(frame, FrameStage::Present, input + 6'000);
+    pacing.Mark(frame, FrameStage::GpuDone, input + 12'000);
+    pacing.Mark(frame, FrameStage::Displayed, input + 20'000 + extraDisplayTicks);
+}
+} // namespace
+
+TEST_SUITE("FramePacing")
+{
+    TEST_CASE("Steady frames break down stage by stage")
+    {
+        FramePacing pacing(kTicksPerSecond, 64);
+        for (uint64 frame = 1; frame <= 32; ++frame)
+        {
+            MarkSteadyFrame(pacing, frame);
+        }
+
+        const FramePacingReport report = pacing.Report();
+        CHECK(report.frames == 32);
+        CHECK(report.stages[static_cast<uint32>(FrameStage::Input)].meanMs ==
+              doctest::Approx(1.0));
+        CHECK(report.stages[static_cast<uint32>(FrameStage::Simulation)].p99Ms ==
+              doctest::Approx(4.0));
+        CHECK(report.stages[static_cast<uint32>(FrameStage::GpuDone)].maxMs ==
+              doctest::Approx(8.0));
+        CHECK(report.latency.p50Ms == doctest::Approx(20.0));
+        CHECK(report.latency.samples == 32);
+        // 31 pairs of consecutive frames
+        CHECK(report.presentInterval.samples == 31);
+        CHECK(report.displayInterval.meanMs == doctest::Approx(16.0));
+        CHECK(report.displayInterval.stdDevMs == doctest::Approx(0.0));
+        CHECK(report.hitches == 0);
+
+        String text;
+        AppendFramePacingReport(text, report);
+        CHECK(strstr(text.CStr(), "Frame pacing over 32 frames") != nullptr);
+        CHECK(strstr(text.CStr(), "Hitches: 0") != nullptr);
+    }
+
+    TEST_CASE("A late display is a hitch and spreads the intervals")
+    {
+        FramePacing pacing(kTicksPerSecond, 64);
+        for (uint64 frame = 1; frame <= 20; ++frame)
+        {
+            MarkSteadyFrame(pacing, frame, frame == 10 ? 16'000 : 0);
+        }
+        const FramePacingReport report = pacing.Report();
+        CHECK(report.hitches == 1);
+        CHECK(report.displayInterval.maxMs == doctest::Approx(32.0));
+        CHECK(report.displayInterval.stdDevMs > 1.0);
+        CHECK(report.presentInterval.stdDevMs == doctest::Approx(0.0));
+    }
+
+    TEST_CASE("Late marks land on their frame, too late ones are dropped")
+    {
+        FramePacing pacing(kTicksPerSecond, 8);
+        for (uint64 frame = 1; frame <= 8; ++frame)
+        {
+            pacing.Mark(frame, FrameStage::Input, frame * 1000);
+            pacing.Mark(frame, FrameStage::Present, frame * 1000 + 500);
+        }
+        // Displays come back a couple of frames on
+        pacing.Mark(6, FrameStage::Displayed, 6 * 1000 + 900);
+        pacing.Mark(12, FrameStage::Input, 12 * 1000);
+        pacing.Mark(3, FrameStage::Displayed, 3 * 1000 + 900);
+
+        const FramePacingReport report = pacing.Report();
+        // Frames 5 to 8 and 12, frames 1 to 4 went to make room
+        CHECK(report.frames == 5);
+        CHECK(report.stages[static_cast<uint32>(FrameStage::Present)].samples == 1);
+        CHECK(report.latency.samples == 4);
+        CHECK(report.latency.maxMs == doctest::Approx(0.9));
+
+        pacing.Clear();
+        CHECK(pacing.Report().frames == 0);
+    }
+}
@@ -0,0 +1,222 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include <rsbl-hw-counters.h>
+
+#include "rsbl-profile-internal.h"
+
+#include <rsbl-memory-tracking.h>
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+    #include <cstring>
+#endif
+
+namespace rsbl
+{
+
+namespace
+{
+thread_local UniquePtr<HwCounters> t_counters;
+thread_local bool t_countersTried = false;
+
+#if defined(__linux__)
+uint64 PerfConfig(HwEvent event)
+{
+    switch (event)
+    {
+    case HwEvent::Cycles:
+        return PERF_COUNT_HW_CPU_CYCLES;
+    case HwEvent::Instructions:
+        return PERF_COUNT_HW_INSTRUCTIONS;
+    case HwEvent::LlcMisses:
+        return PERF_COUNT_HW_CACHE_MISSES;
+    case HwEvent::BranchMisses:
+        return PERF_COUNT_HW_BRANCH_MISSES;
+    default:
+        return 0;
+    }
+}
+
+int OpenEvent(HwEvent event, int group)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PerfConfig(event);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // This thread, on whichever CPU it runs
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+#endif
+} // namespace
+
+const char* HwEventName(HwEvent event)
+{
+    switch (event)
+    {
+    case HwEvent::Cycles:
+        return "cycles";
+    case HwEvent::Instructions:
+        return "instructions";
+    case HwEvent::LlcMisses:
+        return "llc misses";
+    case HwEvent::BranchMisses:
+        return "branch misses";
+    default:
+        return "unknown";
+    }
+}
+
+Result<UniquePtr<HwCounters>> HwCounters::Create()
+{
+#if defined(__linux__)
+    MemoryTagScope memoryScope(MemoryTag::Platform);
+    UniquePtr<HwCounters> counters(new HwCounters());
+    for (uint32 i = 0; i < kHwEventCount; ++i)
+    {
+        // Whatever opens first leads the group, the rest join it so one read gets them all
+        const int fd = OpenEvent(static_cast<HwEvent>(i), counters->m_group);
+        if (fd < 0)
+        {
+            continue;
+        }
+        if (counters->m_group < 0)
+        {
+            counters->m_group = fd;
+        }
+        counters->m_fds[i] = fd;
+        counters->m_order[counters->m_count++] = static_cast<uint8>(i);
+        counters->m_available |= 1u << i;
+    }
+    if (counters->m_count == 0)
+    {
+        return {ErrorCategory::NotFound,
+                "No CPU performance counters, the PMU isn't exposed or perf_event_paranoid is "
+                "above 2"};
+    }
+    return counters;
+#else
+    return {ErrorCategory::NotFound, "No CPU performance counters on this platform"};
+#endif
+}
+
+HwCounters::~HwCounters()
+{
+#if defined(__linux__)
+    for (int fd : m_fds)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+#endif
+}
+
+HwCounterSample HwCounters::Read() const
+{
+    HwCounterSample sample;
+#if defined(__linux__)
+    // PERF_FORMAT_GROUP with the times: count, time enabled, time running, then the values
+    uint64 data[3 + kHwEventCount] = {};
+    const ssize_t size = read(m_group, data, sizeof(data));
+    if (size < static_cast<ssize_t>(3 * sizeof(uint64)) || data[0] != m_count)
+    {
+        return sample;
+    }
+    const uint64 enabled = data[1];
+    const uint64 running = data[2];
+    if (running == 0)
+    {
+        return sample;
+    }
+    const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+    for (uint32 i = 0; i < m_count; ++i)
+    {
+        const uint64 value = data[3 + i];
+        sample.values[m_order[i]] =
+            running < enabled ? static_cast<uint64>(static_cast<double>(value) * scale) : value;
+    }
+    sample.available = m_available;
+#endif
+    return sample;
+}
+
+HwCounters* HwCounters::ForThread()
+{
+    if (!t_countersTried)
+    {
+        t_countersTried = true;
+        if (Result<UniquePtr<HwCounters>> created = Create())
+        {
+            t_counters = rsblMove(created.Value());
+        }
+    }
+    return t_counters.Get();
+}
+
+HwZone::HwZone(const char* name, HwCounterSample& total)
+    : m_zone(name)
+    , m_total(total)
+    , m_counters(HwCounters::ForThread())
+{
+    if (m_counters != nullptr)
+    {
+        m_start = m_counters->Read();
+    }
+}
+
+HwZone::~HwZone()
+{
+    if (m_counters == nullptr)
+    {
+        return;
+    }
+    HwCounterSample delta = m_counters->Read();
+    for (uint32 i = 0; i < kHwEventCount; ++i)
+    {
+        delta.values[i] -= m_start.values[i];
+    }
+    m_total += delta;
+}
+
+void AppendHwCounters(String& text, const HwCounterSample& sample, uint64 per)
+{
+    if (sample.available == 0)
+    {
+        text.Append("no counters");
+        return;
+    }
+
+    const double divisor = per > 0 ? static_cast<double>(per) : 1.0;
+    bool first = true;
+    if (sample.Has(HwEvent::Cycles) && sample.Has(HwEvent::Instructions))
+    {
+        Internal::AppendFormat(text, "ipc %.2f", sample.Ipc());
+        first = false;
+    }
+    for (uint32 i = 0; i < kHwEventCount; ++i)
+    {
+        const HwEvent event = static_cast<HwEvent>(i);
+        if (!sample.Has(event))
+        {
+            continue;
+        }
+        Internal::AppendFormat(text,
+                               "%s%.2f %s",
+                               first ? "" : ", ",
+                               static_cast<double>(sample.Get(event)) / divisor,
+                               HwEventName(event));
+        first = false;
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,84 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-hw-counters.h"
+
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+// Enough work to count, kept from being folded away
+[[gnu::noinline]] uint64 Busy(uint64 iterations)
+{
+    volatile uint64 sum = 0;
+    for (uint64 i = 0; i < iterations; ++i)
+    {
+        sum = sum + i * 3;
+    }
+    return sum;
+}
+} // namespace
+
+TEST_SUITE("HwCounters")
+{
+    TEST_CASE("Samples add up and format what was counted")
+    {
+        HwCounterSample total;
+        HwCounterSample sample;
+        sample.values[static_cast<uint32>(HwEvent::Cycles)] = 400;
+        sample.values[static_cast<uint32>(HwEvent::Instructions)] = 1000;
+        sample.available = (1u << static_cast<uint32>(HwEvent::Cycles)) |
+                           (1u << static_cast<uint32>(HwEvent::Instructions));
+        total += sample;
+        total += sample;
+        CHECK(total.Get(HwEvent::Cycles) == 800);
+        CHECK(total.Ipc() == doctest::Approx(2.5));
+        CHECK_FALSE(total.Has(HwEvent::LlcMisses));
+
+        String text;
+        AppendHwCounters(text, total, 100);
+        CHECK(strcmp(text.CStr(), "ipc 2.50, 8.00 cycles, 20.00 instructions") == 0);
+
+        String none;
+        AppendHwCounters(none, HwCounterSample{});
+        CHECK(strcmp(none.CStr(), "no counters") == 0);
+    }
+
+    TEST_CASE("Zones count the work in them, where the CPU lets us")
+    {
+        Result<UniquePtr<HwCounters>> counters = HwCounters::Create();
+        HwCounterSample total;
+        {
+            HwZone zone("Busy", total);
+            Busy(1000000);
+        }
+
+        if (!counters)
+        {
+            // No PMU, as in most VMs, zones still run and just time
+            MESSAGE("No hardware counters here: " << doctest::String(counters.FailureText()));
+            CHECK(HwCounters::ForThread() == nullptr);
+            CHECK(total.available == 0);
+            return;
+        }
+
+        CHECK(HwCounters::ForThread() != nullptr);
+        if (total.Has(HwEvent::Instructions))
+        {
+            CHECK(total.Get(HwEvent::Instructions) > 1000000);
+        }
+        const HwCounterSample before = counters.Value()->Read();
+        Busy(100000);
+        const HwCounterSample after = counters.Value()->Read();
+        CHECK(after.available == before.available);
+        for (uint32 i = 0; i < kHwEventCount; ++i)
+        {
+            CHECK(after.values[i] >= before.values[i]);
+        }
+    }
+}
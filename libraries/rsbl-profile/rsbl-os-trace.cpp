@@ -0,0 +1,188 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include <rsbl-os-trace.h>
+
+#include <rsbl-profile.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+
+    #include <TraceLoggingProvider.h>
+    #include <evntrace.h>
+#elif defined(__linux__) && __has_include(<sys/sdt.h>)
+    #define RSBL_OS_TRACE_USDT 1
+    // The probes check the semaphores defined below, and perf raises them as it attaches
+    #define _SDT_HAS_SEMAPHORES 1
+    #include <sys/sdt.h>
+#endif
+
+#if defined(RSBL_OS_TRACE_USDT)
+    #define RSBL_OS_TRACE_SEMAPHORE __attribute__((section(".probes")))
+#else
+    #define RSBL_OS_TRACE_SEMAPHORE
+#endif
+
+extern "C"
+{
+    volatile uint16 rsbl_zone_semaphore RSBL_OS_TRACE_SEMAPHORE = 0;
+    volatile uint16 rsbl_frame_semaphore RSBL_OS_TRACE_SEMAPHORE = 0;
+    volatile uint16 rsbl_present_semaphore RSBL_OS_TRACE_SEMAPHORE = 0;
+    volatile uint16 rsbl_io_submit_semaphore RSBL_OS_TRACE_SEMAPHORE = 0;
+    volatile uint16 rsbl_io_complete_semaphore RSBL_OS_TRACE_SEMAPHORE = 0;
+    volatile uint16 rsbl_pipeline_compile_semaphore RSBL_OS_TRACE_SEMAPHORE = 0;
+}
+
+#if defined(_WIN32)
+// {137cd118-9375-462a-9c0f-feb8fab270e9}
+TRACELOGGING_DEFINE_PROVIDER(g_rsblTraceProvider,
+                             "rsbl",
+                             (0x137cd118,
+                              0x9375,
+                              0x462a,
+                              0x9c,
+                              0x0f,
+                              0xfe,
+                              0xb8,
+                              0xfa,
+                              0xb2,
+                              0x70,
+                              0xe9));
+#endif
+
+namespace rsbl
+{
+
+namespace
+{
+#if defined(_WIN32)
+volatile uint16* const kSemaphores[kOsTraceEventCount] = {
+    &rsbl_zone_semaphore,
+    &rsbl_frame_semaphore,
+    &rsbl_present_semaphore,
+    &rsbl_io_submit_semaphore,
+    &rsbl_io_complete_semaphore,
+    &rsbl_pipeline_compile_semaphore,
+};
+
+// Called as sessions enable and disable the provider, with the keywords of every session
+// listening combined
+void NTAPI EnableCallback(LPCGUID /*sourceId*/,
+                          ULONG controlCode,
+                          UCHAR /*level*/,
+                          ULONGLONG matchAnyKeyword,
+                          ULONGLONG /*matchAllKeyword*/,
+                          PEVENT_FILTER_DESCRIPTOR /*filter*/,
+                          PVOID /*context*/)
+{
+    if (controlCode == EVENT_CONTROL_CODE_CAPTURE_STATE)
+    {
+        return;
+    }
+    const bool enabled = controlCode == EVENT_CONTROL_CODE_ENABLE_PROVIDER;
+    for (uint32 i = 0; i < kOsTraceEventCount; ++i)
+    {
+        // No keywords asks for everything
+        const uint64 keyword = OsTraceKeyword(static_cast<OsTraceEvent>(i));
+        const bool wanted = matchAnyKeyword == 0 || (matchAnyKeyword & keyword) != 0;
+        *kSemaphores[i] = enabled && wanted ? 1 : 0;
+    }
+}
+
+// Registered for as long as the process runs, events are only written while it is
+struct ProviderRegistration
+{
+    ProviderRegistration()
+    {
+        TraceLoggingRegisterEx(g_rsblTraceProvider, &EnableCallback, nullptr);
+    }
+
+    ~ProviderRegistration()
+    {
+        TraceLoggingUnregister(g_rsblTraceProvider);
+    }
+};
+
+ProviderRegistration s_providerRegistration;
+
+    // Event names and keywords have to be constants, so a write per kind
+    #define RSBL_OS_TRACE_WRITE(eventName, event)                                                 \
+        TraceLoggingWrite(g_rsblTraceProvider,                                                    \
+                          eventName,                                                              \
+                          TraceLoggingKeyword(OsTraceKeyword(event)),                             \
+                          TraceLoggingString(name, "Name"),                                       \
+                          TraceLoggingUInt64(id, "Id"),                                           \
+                          TraceLoggingUInt64(value, "Value"),                                     \
+                          TraceLoggingUInt64(start, "Start"),                                     \
+                          TraceLoggingUInt64(end, "End"))
+#endif
+} // namespace
+
+void OsTraceEmit(
+    OsTraceEvent event, const char* name, uint64 id, uint64 value, uint64 start, uint64 end)
+{
+    name = name != nullptr ? name : "";
+#if defined(_WIN32)
+    switch (event)
+    {
+    case OsTraceEvent::Zone:
+        RSBL_OS_TRACE_WRITE("Zone", OsTraceEvent::Zone);
+        break;
+    case OsTraceEvent::Frame:
+        RSBL_OS_TRACE_WRITE("Frame", OsTraceEvent::Frame);
+        break;
+    case OsTraceEvent::Present:
+        RSBL_OS_TRACE_WRITE("Present", OsTraceEvent::Present);
+        break;
+    case OsTraceEvent::IoSubmit:
+        RSBL_OS_TRACE_WRITE("IoSubmit", OsTraceEvent::IoSubmit);
+        break;
+    case OsTraceEvent::IoComplete:
+        RSBL_OS_TRACE_WRITE("IoComplete", OsTraceEvent::IoComplete);
+        break;
+    case OsTraceEvent::PipelineCompile:
+        RSBL_OS_TRACE_WRITE("PipelineCompile", OsTraceEvent::PipelineCompile);
+        break;
+    default:
+        break;
+    }
+#elif defined(RSBL_OS_TRACE_USDT)
+    // Probe names are part of the symbol, so a probe per kind too
+    switch (event)
+    {
+    case OsTraceEvent::Zone:
+        STAP_PROBE5(rsbl, zone, name, id, value, start, end);
+        break;
+    case OsTraceEvent::Frame:
+        STAP_PROBE5(rsbl, frame, name, id, value, start, end);
+        break;
+    case OsTraceEvent::Present:
+        STAP_PROBE5(rsbl, present, name, id, value, start, end);
+        break;
+    case OsTraceEvent::IoSubmit:
+        STAP_PROBE5(rsbl, io_submit, name, id, value, start, end);
+        break;
+    case OsTraceEvent::IoComplete:
+        STAP_PROBE5(rsbl, io_complete, name, id, value, start, end);
+        break;
+    case OsTraceEvent::PipelineCompile:
+        STAP_PROBE5(rsbl, pipeline_compile, name, id, value, start, end);
+        break;
+    default:
+        break;
+    }
+#else
+    (void)event;
+    (void)id;
+    (void)value;
+    (void)start;
+    (void)end;
+#endif
+}
+
+uint64 OsTraceNow()
+{
+    return Profiler::Now();
+}
+
+} // namespace rsbl
@@ -0,0 +1,45 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-os-trace.h"
+#include "include/rsbl-profile.h"
+
+using namespace rsbl;
+
+TEST_SUITE("OsTrace")
+{
+    TEST_CASE("Nothing is enabled until a session listens")
+    {
+        for (uint32 i = 0; i < kOsTraceEventCount; ++i)
+        {
+            CHECK_FALSE(OsTraceEnabled(static_cast<OsTraceEvent>(i)));
+        }
+        CHECK_FALSE(OsTraceEnabled(OsTraceEvent::Count));
+        CHECK(OsTraceKeyword(OsTraceEvent::Zone) == 1);
+        CHECK(OsTraceKeyword(OsTraceEvent::PipelineCompile) == 32);
+    }
+
+    TEST_CASE("Events go out while their semaphore is raised")
+    {
+        // As perf would, emitting without a tracer attached is harmless
+        rsbl_zone_semaphore = 1;
+        rsbl_frame_semaphore = 1;
+        rsbl_pipeline_compile_semaphore = 1;
+        CHECK(OsTraceEnabled(OsTraceEvent::Zone));
+        CHECK_FALSE(OsTraceEnabled(OsTraceEvent::Present));
+        {
+            RSBL_PROFILE_ZONE("Traced");
+            OsTraceScope compile(OsTraceEvent::PipelineCompile, "Graphics", 42);
+            OsTraceMark(OsTraceEvent::Present, "Present", 1);
+        }
+        Profiler::MarkFrame();
+        Profiler::MarkFrame();
+        rsbl_zone_semaphore = 0;
+        rsbl_frame_semaphore = 0;
+        rsbl_pipeline_compile_semaphore = 0;
+        CHECK_FALSE(OsTraceEnabled(OsTraceEvent::Zone));
+    }
+}
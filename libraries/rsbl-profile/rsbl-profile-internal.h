@@ -0,0 +1,14 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-string.h>
+
+namespace rsbl::Internal
+{
+
+// printf into json, for the trace and the counter dumps. Each call is one short record.
+void AppendFormat(String& json, const char* format, ...);
+
+} // namespace rsbl::Internal
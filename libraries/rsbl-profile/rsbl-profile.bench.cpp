@@ -0,0 +1,63 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// What a zone costs: an empty one through ProfileZone, and the timestamp it takes twice, against
+// the same loop with nothing in it.
+// Zones are meant to be left in hot paths, so this should stay in the tens of nanoseconds.
+
+#include "include/rsbl-profile.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint32 kZones = 10000000;
+
+// Stop the optimizer from folding the loops away
+volatile uint64 s_sink = 0;
+
+template <typename F>
+double Milliseconds(F&& f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+} // namespace
+
+int main()
+{
+    const double empty_ms = Milliseconds([]() {
+        for (uint32 i = 0; i < kZones; ++i)
+        {
+            s_sink = i;
+        }
+    });
+
+    // The first zone creates the thread's ring, keep that out of the loop
+    {
+        ProfileZone warm("Warm up");
+    }
+    const double zone_ms = Milliseconds([]() {
+        for (uint32 i = 0; i < kZones; ++i)
+        {
+            ProfileZone zone("Bench zone");
+            s_sink = i;
+        }
+    });
+
+    const double now_ms = Milliseconds([]() {
+        for (uint32 i = 0; i < kZones; ++i)
+        {
+            s_sink = Profiler::Now();
+        }
+    });
+
+    printf("  %-36s %8.1f ns/zone\n", "Empty zone", (zone_ms - empty_ms) * 1e6 / kZones);
+    printf("  %-36s %8.1f ns/call\n", "Profiler::Now", (now_ms - empty_ms) * 1e6 / kZones);
+    return 0;
+}
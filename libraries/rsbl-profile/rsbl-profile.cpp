@@ -0,0 +1,261 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include <rsbl-profile.h>
+
+#include "rsbl-profile-internal.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+
+namespace rsbl
+{
+
+namespace Internal
+{
+thread_local ProfileRing* t_profileRing = nullptr;
+}
+
+namespace
+{
+using Internal::AppendFormat;
+using Internal::ProfileRing;
+
+struct RingStorage
+{
+    ProfileRing ring;
+    DynamicArray<ProfileEvent> events;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    DynamicArray<RingStorage*> rings;
+    DynamicArray<ProfileRing*> freeRings;
+    uint32 nextThreadId = 1;
+    std::atomic<uint64> frames{0};
+    std::atomic<uint64> lastFrameMark{0};
+
+    // Timestamps are tied to the steady clock from here to each capture
+    uint64 epochCycles = Profiler::Now();
+    std::chrono::steady_clock::time_point epochTime = std::chrono::steady_clock::now();
+};
+
+// Never destroyed, threads can record while statics are going away
+Registry& GetRegistry()
+{
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+// Starts the epoch with the process rather than the first zone, which has already begun by then
+[[maybe_unused]] const Registry& s_registryAtStartup = GetRegistry();
+
+// Hands the thread's ring on when the thread finishes. Only constructed once a thread records,
+// so t_profileRing stays a plain pointer for the fast path.
+struct RingOwner
+{
+    ProfileRing* ring = nullptr;
+
+    ~RingOwner()
+    {
+        if (ring == nullptr)
+        {
+            return;
+        }
+        Internal::t_profileRing = nullptr;
+        Registry& registry = GetRegistry();
+        std::lock_guard lock(registry.mutex);
+        registry.freeRings.PushBack(ring);
+    }
+};
+
+thread_local RingOwner t_ringOwner;
+
+// Once a ring has wrapped its oldest slot is left out, the writer may be overwriting it
+void Snapshot(const ProfileRing& ring, DynamicArray<ProfileEvent>& out)
+{
+    const uint64 head = ring.head.load(std::memory_order_acquire);
+    const uint64 first = head > kProfileRingEvents ? head - kProfileRingEvents + 1 : 0;
+    out.Reserve(out.Size() + (head - first));
+    for (uint64 i = first; i < head; ++i)
+    {
+        out.PushBack(ring.events[i & (kProfileRingEvents - 1)]);
+    }
+}
+} // namespace
+
+void Internal::AppendFormat(String& json, const char* format, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    rsblAssert(length >= 0 && length < static_cast<int>(sizeof(buffer)));
+    json.Append(StringView(buffer, static_cast<uint64>(length)));
+}
+
+Internal::ProfileRing* Internal::CreateProfileRing()
+{
+    Registry& registry = GetRegistry();
+    ProfileRing* ring = nullptr;
+    {
+        std::lock_guard lock(registry.mutex);
+        if (!registry.freeRings.IsEmpty())
+        {
+            // A new thread starts the ring over, and gets a track of its own
+            ring = registry.freeRings[registry.freeRings.Size() - 1];
+            registry.freeRings.PopBack();
+            ring->head.store(0, std::memory_order_relaxed);
+            ring->threadName[0] = '\0';
+        }
+        else
+        {
+            MemoryTagScope memoryScope(MemoryTag::Core);
+            RingStorage* storage = new RingStorage();
+            storage->events.Resize(kProfileRingEvents);
+            storage->ring.events = storage->events.Data();
+            registry.rings.PushBack(storage);
+            ring = &storage->ring;
+        }
+        ring->threadId = registry.nextThreadId++;
+    }
+    t_profileRing = ring;
+    t_ringOwner.ring = ring;
+    return ring;
+}
+
+void Profiler::MarkFrame()
+{
+    Registry& registry = GetRegistry();
+    const uint64 frame = registry.frames.fetch_add(1, std::memory_order_relaxed);
+    const uint64 now = Now();
+    RecordZone(nullptr, now, frame);
+
+    const uint64 previous = registry.lastFrameMark.exchange(now, std::memory_order_relaxed);
+    if (OsTraceEnabled(OsTraceEvent::Frame) && previous != 0) [[unlikely]]
+    {
+        OsTraceEmit(OsTraceEvent::Frame, "Frame", frame, 0, previous, now);
+    }
+}
+
+uint64 Profiler::FrameCount()
+{
+    return GetRegistry().frames.load(std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    ProfileRing* ring = Internal::t_profileRing;
+    if (ring == nullptr)
+    {
+        ring = Internal::CreateProfileRing();
+    }
+    snprintf(ring->threadName, sizeof(ring->threadName), "%s", name);
+}
+
+void Profiler::BuildChromeTrace(String& json)
+{
+    Registry& registry = GetRegistry();
+
+    // How fast the timestamps ran, from the epoch to now
+    const uint64 now_cycles = Now();
+    const auto now_time = std::chrono::steady_clock::now();
+    const uint64 elapsed_ns = static_cast<uint64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now_time - registry.epochTime)
+            .count());
+    const uint64 elapsed_cycles = now_cycles - registry.epochCycles;
+    const double us_per_cycle =
+        elapsed_cycles > 0 ? static_cast<double>(elapsed_ns) / 1000.0 / elapsed_cycles : 0.001;
+
+    json.Append("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    json.Append("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+                "\"args\":{\"name\":\"rsbl\"}}");
+
+    std::lock_guard lock(registry.mutex);
+    DynamicArray<ProfileEvent> events;
+    for (const RingStorage* storage : registry.rings)
+    {
+        const ProfileRing& ring = storage->ring;
+        events.Clear();
+        Snapshot(ring, events);
+        if (events.IsEmpty())
+        {
+            continue;
+        }
+
+        if (ring.threadName[0] != '\0')
+        {
+            AppendFormat(json,
+                         ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                         "\"args\":{\"name\":\"%s\"}}",
+                         ring.threadId,
+                         ring.threadName);
+        }
+        else
+        {
+            AppendFormat(json,
+                         ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                         "\"args\":{\"name\":\"Thread %u\"}}",
+                         ring.threadId,
+                         ring.threadId);
+        }
+
+        for (const ProfileEvent& event : events)
+        {
+            // Zones can have started before the epoch, they're clamped to it
+            const uint64 start = event.start > registry.epochCycles
+                                     ? event.start - registry.epochCycles
+                                     : 0;
+            const double ts = static_cast<double>(start) * us_per_cycle;
+            if (event.name == nullptr)
+            {
+                // Frames belong to the whole process
+                AppendFormat(json,
+                             ",\n{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"i\",\"s\":\"g\","
+                             "\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"frame\":%llu}}",
+                             ts,
+                             ring.threadId,
+                             static_cast<unsigned long long>(event.end));
+                continue;
+            }
+            const uint64 duration = event.end > event.start ? event.end - event.start : 0;
+            AppendFormat(json,
+                         ",\n{\"name\":\"%.128s\",\"cat\":\"zone\",\"ph\":\"X\",\"ts\":%.3f,"
+                         "\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                         event.name,
+                         ts,
+                         static_cast<double>(duration) * us_per_cycle,
+                         ring.threadId);
+        }
+    }
+
+    json.Append("\n]}\n");
+}
+
+void Profiler::Clear()
+{
+    Registry& registry = GetRegistry();
+    std::lock_guard lock(registry.mutex);
+    for (RingStorage* storage : registry.rings)
+    {
+        storage->ring.head.store(0, std::memory_order_relaxed);
+    }
+    registry.frames.store(0, std::memory_order_relaxed);
+}
+
+uint64 Profiler::SteadyNs()
+{
+    return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+
+} // namespace rsbl
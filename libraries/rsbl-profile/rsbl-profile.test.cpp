@@ -0,0 +1,142 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-profile.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using namespace rsbl;
+
+namespace
+{
+uint32 CountOf(const String& json, const char* text)
+{
+    uint32 count = 0;
+    for (const char* at = strstr(json.CStr(), text); at != nullptr; at = strstr(at + 1, text))
+    {
+        ++count;
+    }
+    return count;
+}
+} // namespace
+
+TEST_SUITE("Profile")
+{
+    TEST_CASE("Zones nest on the thread's track")
+    {
+        Profiler::Clear();
+        {
+            ProfileZone outer("Outer zone");
+            {
+                ProfileZone inner("Inner zone");
+            }
+        }
+
+        String json;
+        Profiler::BuildChromeTrace(json);
+        CHECK(CountOf(json, "\"name\":\"Outer zone\",\"cat\":\"zone\",\"ph\":\"X\"") == 1);
+        CHECK(CountOf(json, "\"name\":\"Inner zone\",\"cat\":\"zone\",\"ph\":\"X\"") == 1);
+        // The inner zone ends first, so it's recorded first
+        CHECK(strstr(json.CStr(), "Inner zone") < strstr(json.CStr(), "Outer zone"));
+    }
+
+    TEST_CASE("Frames are counted and marked")
+    {
+        Profiler::Clear();
+        Profiler::MarkFrame();
+        Profiler::MarkFrame();
+        Profiler::MarkFrame();
+        CHECK(Profiler::FrameCount() == 3);
+
+        String json;
+        Profiler::BuildChromeTrace(json);
+        CHECK(CountOf(json, "\"name\":\"Frame\"") == 3);
+        CHECK(CountOf(json, "\"args\":{\"frame\":2}") == 1);
+    }
+
+    TEST_CASE("Other threads get a named track")
+    {
+        Profiler::Clear();
+        std::thread thread([]() {
+            Profiler::SetThreadName("Profile worker");
+            ProfileZone zone("Worker zone");
+        });
+        thread.join();
+
+        String json;
+        Profiler::BuildChromeTrace(json);
+        CHECK(CountOf(json, "\"args\":{\"name\":\"Profile worker\"}") == 1);
+        CHECK(CountOf(json, "Worker zone") == 1);
+    }
+
+    TEST_CASE("A finished thread's ring goes to the next one")
+    {
+        Profiler::Clear();
+        std::thread first([]() {
+            Profiler::SetThreadName("First thread");
+            ProfileZone zone("First zone");
+        });
+        first.join();
+        std::thread second([]() { ProfileZone zone("Second zone"); });
+        second.join();
+
+        String json;
+        Profiler::BuildChromeTrace(json);
+        CHECK(CountOf(json, "First") == 0);
+        CHECK(CountOf(json, "Second zone") == 1);
+    }
+
+    TEST_CASE("Rings keep the most recent zones")
+    {
+        Profiler::Clear();
+        const uint32 zones = kProfileRingEvents + 100;
+        for (uint32 i = 0; i < zones; ++i)
+        {
+            ProfileZone zone(i < 100 ? "Overwritten zone" : "Kept zone");
+        }
+
+        String json;
+        Profiler::BuildChromeTrace(json);
+        CHECK(CountOf(json, "Overwritten zone") == 0);
+        // The oldest slot is left out once a ring wraps
+        CHECK(CountOf(json, "Kept zone") == kProfileRingEvents - 1);
+    }
+
+    TEST_CASE("Durations are in microseconds")
+    {
+        Profiler::Clear();
+        {
+            ProfileZone zone("Sleeping zone");
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+
+        String json;
+        Profiler::BuildChromeTrace(json);
+        const char* dur = strstr(strstr(json.CStr(), "Sleeping zone"), "\"dur\":");
+        REQUIRE(dur != nullptr);
+        const double us = atof(dur + 6);
+        CHECK(us >= 15000.0);
+        CHECK(us < 1000000.0);
+    }
+
+    TEST_CASE("Clear forgets everything")
+    {
+        {
+            ProfileZone zone("Cleared zone");
+        }
+        Profiler::MarkFrame();
+        Profiler::Clear();
+        CHECK(Profiler::FrameCount() == 0);
+
+        String json;
+        Profiler::BuildChromeTrace(json);
+        CHECK(CountOf(json, "Cleared zone") == 0);
+        CHECK(CountOf(json, "\"ph\":\"X\"") == 0);
+    }
+}
@@ -0,0 +1,116 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-allocator.h>
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+
+// Simulation and rendering on threads of their own, a frame apart: while a render thread records
+// and submits frame N, the calling thread simulates frame N+1, so a frame takes as long as the
+// slower of the two rather than both. What rendering needs of a frame goes in a packet: the
+// simulation fills it with a copy of the frame's state and hands it over, and never touches the
+// state the render thread reads.
+//
+//     pipeline = FramePipeline::Create([&](const FramePacket& packet) -> Result<> {
+//         const FrameView& view = *static_cast<const FrameView*>(packet.data);
+//         ... record the GPU work for view, submit, present ...
+//     });
+//     while (running)
+//     {
+//         FramePacket& packet = pipeline->BeginFrame();
+//         ... simulate ...
+//         FrameView* view = new (packet.memory->Allocate(sizeof(FrameView), alignof(FrameView)))
+//             FrameView(...);
+//         packet.data = view;
+//         pipeline->Submit(packet);
+//     }
+//
+// Packets are double or triple buffered, each with an arena of a FrameArena that's reset when the
+// packet comes round again, which is once its frame has been rendered. Nothing in a packet is
+// ever freed or destroyed, so it's plain data and views of arena memory.
+
+namespace rsbl
+{
+
+struct FramePacket
+{
+    // Counts up from 0
+    uint64 frame = 0;
+
+    // What the render function reads of the frame, set by the simulation. nullptr at BeginFrame.
+    void* data = nullptr;
+
+    // The packet's memory, empty at BeginFrame. Only the simulation allocates, between BeginFrame
+    // and Submit; the render thread only reads what's in it.
+    Allocator* memory = nullptr;
+};
+
+// Runs on the render thread, one packet after another in frame order. A failure stops the
+// pipeline rendering, Submit reports it.
+using FrameRenderFunction = PooledFunction<Result<>(const FramePacket&), 48>;
+
+struct FramePipelineOptions
+{
+    // 2 lets the simulation run a frame ahead of rendering, 3 lets it queue one more so a frame
+    // that's slow to simulate doesn't leave the render thread idle. Up to
+    // FrameArena::kMaxFrameCount.
+    uint32 packetCount = 2;
+
+    // The packets' arenas grow in blocks this big
+    uint64 arenaBlockSize = 256 * 1024;
+};
+
+struct FramePipelineStats
+{
+    uint64 framesRendered = 0;
+    // Time the simulation spent in BeginFrame waiting for a packet, when rendering is the slower
+    uint64 simulationWaitNs = 0;
+    // Time the render thread spent waiting for a packet, when simulation is the slower
+    uint64 renderWaitNs = 0;
+};
+
+class FramePipeline
+{
+  public:
+    static Result<UniquePtr<FramePipeline>> Create(FrameRenderFunction&& render,
+                                                   const FramePipelineOptions& options = {});
+
+    // Renders what was submitted, then stops the render thread
+    ~FramePipeline();
+
+    // The render thread holds on to the pipeline, it can't move
+    FramePipeline(FramePipeline&&) = delete;
+    FramePipeline& operator=(FramePipeline&&) = delete;
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // The next frame's packet, once the frame that last had it has been rendered. Blocks while
+    // every packet is submitted and not yet rendered.
+    FramePacket& BeginFrame();
+
+    // Hands the packet from BeginFrame to the render thread. Fails from the first frame the
+    // render function failed on, with its failure; nothing's rendered after that, but the
+    // pipeline keeps taking packets.
+    Result<> Submit(FramePacket& packet);
+
+    // Blocks until everything submitted has been rendered. Before anything the render thread
+    // uses changes from under it: a swapchain resize, a device going away.
+    void Flush();
+
+    // From the simulation's thread
+    uint64 FramesSubmitted() const;
+    FramePipelineStats Stats() const;
+
+  private:
+    struct State;
+
+    FramePipeline() = default;
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
@@ -0,0 +1,233 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-ga.h>
+#include <rsbl-int-types.h>
+#include <rsbl-math-types.h>
+
+// Materials as the GPU reads them: every material's parameters packed into one structured buffer,
+// a GpuMaterial each, which a draw finds by its material id (pushed as a constant, or in its
+// instance data). Textures are bindless view indices in it, so nothing a draw binds depends on
+// its material, and materials don't each need their own pipeline.
+//
+// What does need a pipeline of its own is only what changes fixed-function state or early depth:
+// the alpha mode, an alpha-tested pixel shader being one that discards, and blending being a
+// different blend state and no depth writes, and double-sidedness, which is the cull mode. That's
+// kMaterialPipelineCount pipelines per pass however many materials there are, from one uber
+// shader compiled once per alpha mode. Everything else, which textures a material samples and
+// whether it's lit, is the material's feature flags, branched on in the shader: a branch every
+// pixel of a draw takes the same way.
+//
+// A variant is also compiled knowing which features any of its materials use, MATERIAL_FEATURES,
+// so a scene with no emissive textures doesn't carry their sampling in its shaders. This stands
+// in for specialization constants, which the GA pipelines don't have:
+//
+//     MaterialTable materials;
+//     ... for each glTF material, materials.Add(desc) ...
+//     ... upload materials.Materials() to a BufferSrv of stride sizeof(GpuMaterial) ...
+//     for (uint32 pipeline = 0; pipeline < kMaterialPipelineCount; ++pipeline)
+//     {
+//         if (materials.PipelineUseCount(pipeline) == 0) continue;
+//         ... compile the pixel shader with MATERIAL_ALPHA_MODE and MATERIAL_FEATURES from
+//             MaterialPipelineAlphaMode(pipeline) and materials.VariantFeatures(...) ...
+//         ApplyMaterialPipelineState(pipeline, desc);
+//     }
+//     ... every frame, for each draw, a MaterialDraw ...
+//     materials.SortDraws(draws);
+//     ... bind a draw's pipeline when MaterialPipeline(draw.material) changes ...
+//
+// kMaterialShader has the Material struct and the lookups for the uber shader to include.
+
+namespace rsbl
+{
+
+// A GpuMaterial texture without one
+constexpr uint32 kNoMaterialTexture = ~0u;
+
+// glTF's alphaMode
+enum class MaterialAlphaMode : uint8
+{
+    Opaque,
+    Mask, // Discarded below alphaCutoff
+    Blend,
+};
+
+// Which of its optional parts a material uses, GpuMaterial::features
+enum class MaterialFeatures : uint32
+{
+    None = 0,
+    BaseColorTexture = 1 << 0,
+    MetallicRoughnessTexture = 1 << 1,
+    NormalTexture = 1 << 2,
+    OcclusionTexture = 1 << 3,
+    EmissiveTexture = 1 << 4,
+    // KHR_materials_unlit: the base color is the color, no lighting
+    Unlit = 1 << 5,
+    // Back faces are shaded with their normals flipped
+    DoubleSided = 1 << 6,
+};
+
+constexpr MaterialFeatures operator|(MaterialFeatures a, MaterialFeatures b)
+{
+    return static_cast<MaterialFeatures>(static_cast<uint32>(a) | static_cast<uint32>(b));
+}
+
+constexpr bool HasFlag(MaterialFeatures flags, MaterialFeatures flag)
+{
+    return (static_cast<uint32>(flags) & static_cast<uint32>(flag)) != 0;
+}
+
+// A glTF metallic-roughness material
+struct MaterialDesc
+{
+    float4 baseColorFactor = float4(1.0f);
+    // Times KHR_materials_emissive_strength's
+    float3 emissiveFactor = float3(0.0f);
+    float metallicFactor = 1.0f;
+    float roughnessFactor = 1.0f;
+    float normalScale = 1.0f;
+    float occlusionStrength = 1.0f;
+    float alphaCutoff = 0.5f;
+
+    // Bindless indices of the textures' views, kNoMaterialTexture for none
+    uint32 baseColorTexture = kNoMaterialTexture;
+    uint32 metallicRoughnessTexture = kNoMaterialTexture;
+    uint32 normalTexture = kNoMaterialTexture;
+    uint32 occlusionTexture = kNoMaterialTexture;
+    uint32 emissiveTexture = kNoMaterialTexture;
+
+    MaterialAlphaMode alphaMode = MaterialAlphaMode::Opaque;
+    bool doubleSided = false;
+    bool unlit = false;
+};
+
+// A material as the GPU reads it, kMaterialShader's Material
+struct GpuMaterial
+{
+    float baseColorFactor[4];
+    float emissiveFactor[3];
+    float metallicFactor;
+    float roughnessFactor;
+    float normalScale;
+    float occlusionStrength;
+    float alphaCutoff;
+    uint32 baseColorTexture;
+    uint32 metallicRoughnessTexture;
+    uint32 normalTexture;
+    uint32 occlusionTexture;
+    uint32 emissiveTexture;
+    MaterialFeatures features;
+    uint32 padding[2];
+};
+
+static_assert(sizeof(GpuMaterial) == 80, "GpuMaterial is read by shaders as laid out");
+
+// A pipeline per alpha mode, single and double-sided. A material's is
+// alphaMode * 2 + doubleSided, so sorting by it draws opaque, then masked, then blended.
+constexpr uint32 kMaterialPipelineCount = 6;
+
+inline MaterialAlphaMode MaterialPipelineAlphaMode(uint32 pipeline)
+{
+    return static_cast<MaterialAlphaMode>(pipeline / 2);
+}
+
+inline bool MaterialPipelineDoubleSided(uint32 pipeline)
+{
+    return (pipeline & 1) != 0;
+}
+
+// Sets what a material pipeline has of its own on desc: the cull mode, and for blending the
+// blend modes of desc's render targets and no depth writes. The rest of desc is the caller's.
+void ApplyMaterialPipelineState(uint32 pipeline, gaGraphicsPipelineDesc& desc);
+
+// A draw to sort, the caller's own index in it to find the rest of the draw by
+struct MaterialDraw
+{
+    uint32 material = 0;
+    // Distance along the view direction, for the order within a pipeline
+    float viewDepth = 0.0f;
+    uint32 draw = 0;
+};
+
+struct MaterialSortStats
+{
+    // Changes to the next draw's pipeline or material, counting the first draw's
+    uint32 pipelineChanges = 0;
+    uint32 materialChanges = 0;
+};
+
+class MaterialTable
+{
+  public:
+    // The material's id, its index in Materials()
+    uint32 Add(const MaterialDesc& desc);
+
+    // Replaces a material's parameters. It can move to another pipeline.
+    void Update(uint32 material, const MaterialDesc& desc);
+
+    uint32 Count() const
+    {
+        return static_cast<uint32>(m_materials.Size());
+    }
+
+    // What goes in the structured buffer, indexed by material id
+    ArrayView<const GpuMaterial> Materials() const
+    {
+        return m_materials;
+    }
+
+    // The range of materials Add or Update changed since ClearDirty, to upload again
+    uint32 FirstDirty() const
+    {
+        return m_firstDirty;
+    }
+    uint32 DirtyCount() const
+    {
+        return m_dirtyEnd > m_firstDirty ? m_dirtyEnd - m_firstDirty : 0;
+    }
+    void ClearDirty();
+
+    uint32 MaterialPipeline(uint32 material) const
+    {
+        return m_pipelines[material];
+    }
+
+    // Materials in each pipeline, for leaving out the ones nothing uses
+    uint32 PipelineUseCount(uint32 pipeline) const
+    {
+        return m_pipelineUses[pipeline];
+    }
+
+    // Every feature any material of the alpha mode has had, for its shader's MATERIAL_FEATURES.
+    // It only grows, a feature no material uses any more stays compiled in.
+    MaterialFeatures VariantFeatures(MaterialAlphaMode alphaMode) const
+    {
+        return m_variantFeatures[static_cast<uint32>(alphaMode)];
+    }
+
+    // Orders draws for the fewest state changes: by pipeline, then by material within one, then
+    // front to back, except blended draws, which go last and back to front whatever their
+    // pipeline or material, as blending needs
+    MaterialSortStats SortDraws(ArrayView<MaterialDraw> draws);
+
+  private:
+    DynamicArray<GpuMaterial> m_materials;
+    DynamicArray<uint8> m_pipelines;
+    uint32 m_pipelineUses[kMaterialPipelineCount] = {};
+    MaterialFeatures m_variantFeatures[3] = {};
+    uint32 m_firstDirty = 0;
+    uint32 m_dirtyEnd = 0;
+    DynamicArray<uint64> m_sortKeys;
+};
+
+// HLSL source for the uber shader to include: Material, matching GpuMaterial, the feature flags,
+// and HasFeature, which is false for features outside MATERIAL_FEATURES so the compiler drops
+// what no material of the variant uses. MATERIAL_ALPHA_MODE is the variant's MaterialAlphaMode,
+// 0 to 2, and MATERIAL_FEATURES its VariantFeatures; without them every feature is in.
+extern const char kMaterialShader[];
+
+} // namespace rsbl
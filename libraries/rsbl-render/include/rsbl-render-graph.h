@@ -0,0 +1,198 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-function.h>
+#include <rsbl-ga.h>
+#include <rsbl-int-types.h>
+#include <rsbl-ptr.h>
+#include <rsbl-result.h>
+
+// A frame's GPU work as passes that say which resources they read and write, and in what state,
+// rather than placing barriers by hand. Barriers placed by hand are either missing somewhere or
+// more than needed, and the extra ones are where the GPU sits idle. The graph is declared afresh
+// every frame, and compiling it:
+//
+//  - culls passes whose output nothing reads: nothing imported, nothing a kept pass reads
+//  - works out every barrier, once per change of state, all of a pass's in one batch. A
+//    transition with passes between the last use and the next is split across them.
+//  - places transient resources (render targets and buffers that live within the frame) in one
+//    block of memory, where resources whose lifetimes don't overlap share the same bytes
+//
+// Transient resources are made by a function the graph is given, placed in its memory, and kept
+// from frame to frame while their description and placement stay the same:
+//
+//     graph->Reset();
+//     RenderResource back_buffer = graph->Import({image, gaResourceState::Present});
+//     RenderResource depth = graph->CreateTransient({depth_size, kAlignment, true, true, key});
+//     graph->AddPass([](const RenderPassContext& context) { ... }, "Opaque")
+//         .Write(depth, gaResourceState::DepthWrite)
+//         .Write(back_buffer, gaResourceState::ColorTarget);
+//     graph->Compile();
+//     graph->Execute(list);
+//
+// Everything runs on one command list, in the order passes were added.
+
+namespace rsbl
+{
+
+class RenderGraph;
+
+struct RenderResource
+{
+    static constexpr uint32 kInvalid = ~0u;
+
+    uint32 index = kInvalid;
+
+    bool IsValid() const
+    {
+        return index != kInvalid;
+    }
+};
+
+// A resource made outside the graph: the back buffer, or anything kept across frames
+struct RenderImportDesc
+{
+    void* resource = nullptr; // As in gaBarrier
+    gaResourceState state = gaResourceState::Common; // What it's in now
+    gaResourceState finalState = gaResourceState::Common; // What it's left in after the frame
+    bool texture = true;
+    bool depth = false;
+};
+
+struct RenderTransientDesc
+{
+    // The resource's memory requirements (GetResourceAllocationInfo, vkGetImageMemoryRequirements)
+    uint64 size = 0;
+    uint64 alignment = 64 * 1024;
+    bool texture = true;
+    bool depth = false;
+    // Which resource to make, a hash of its description usually. A resource is kept for the next
+    // frame's transient with the same key and size placed at the same offset.
+    uint64 key = 0;
+};
+
+struct RenderPassContext
+{
+    gaCommandList* list;
+    const RenderGraph* graph;
+};
+
+using RenderPassFunction = PooledFunction<void(const RenderPassContext&), 48>;
+
+// Makes the resource described, placed in memory, in gaResourceState::Common
+using RenderTransientCreateFunction =
+    PooledFunction<Result<void*>(const RenderTransientDesc& desc, const gaMemoryAllocation& memory),
+                   32>;
+using RenderTransientDestroyFunction = PooledFunction<void(void* resource), 32>;
+
+struct RenderGraphCreateInfo
+{
+    gaDevice* device = nullptr;
+    // Where the transient memory comes from, device local
+    gaMemoryAllocator* allocator = nullptr;
+    RenderTransientCreateFunction createTransient;
+    RenderTransientDestroyFunction destroyTransient;
+};
+
+// Of the last Compile
+struct RenderGraphStats
+{
+    uint32 passes = 0;
+    uint32 culledPasses = 0;
+    uint32 barriers = 0;
+    uint32 splitBarriers = 0; // Counted once, not once for each half
+    uint32 barrierBatches = 0;
+    uint32 transients = 0;
+    uint32 transientsCreated = 0; // Rather than kept from an earlier frame
+    uint64 transientBytes = 0;    // With aliasing
+    uint64 unaliasedBytes = 0;    // What they'd take each in memory of their own
+};
+
+class RenderPassBuilder
+{
+  public:
+    // A pass only has one state per resource. Write alone means what was there is overwritten, so
+    // passes before that only wrote it can be culled; a depth test or a blend reads it as well.
+    RenderPassBuilder& Read(RenderResource resource, gaResourceState state);
+    RenderPassBuilder& Write(RenderResource resource, gaResourceState state);
+
+    // Never culled, for passes with effects the graph can't see, like readbacks and queries
+    RenderPassBuilder& KeepAlive();
+
+  private:
+    friend class RenderGraph;
+
+    RenderPassBuilder(RenderGraph* graph, uint32 pass)
+        : m_graph(graph)
+        , m_pass(pass)
+    {
+    }
+
+    RenderGraph* m_graph;
+    uint32 m_pass;
+};
+
+class RenderGraph
+{
+  public:
+    static Result<UniquePtr<RenderGraph>> Create(RenderGraphCreateInfo&& createInfo);
+
+    // Destroys the transient resources and frees their memory, so only once the GPU is idle
+    ~RenderGraph();
+
+    RenderGraph(RenderGraph&&) = delete;
+    RenderGraph& operator=(RenderGraph&&) = delete;
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // Forgets the last frame's passes and resources, to declare the next frame's
+    void Reset();
+
+    RenderResource Import(const RenderImportDesc& desc);
+    RenderResource CreateTransient(const RenderTransientDesc& desc);
+
+    // Passes run in the order they're added, culled ones not at all. A named pass is a GPU zone
+    // along with its barriers, while the device has a GPU profiler; the name has to outlive the
+    // profiler reading it back, a string literal usually.
+    RenderPassBuilder AddPass(RenderPassFunction&& execute, const char* name = nullptr);
+
+    // Culls, places and makes transients, and works out the barriers. InvalidArgument for a pass
+    // using a resource that isn't the frame's, or one resource in two states. Once the device has
+    // begun the frame: transient resources are kept around by frame.
+    Result<> Compile();
+
+    // Records the compiled frame into a recording graphics or compute list
+    Result<> Execute(gaCommandList* list);
+
+    // Valid once compiled. Null for a transient no kept pass uses.
+    void* Resource(RenderResource resource) const;
+
+    // Where a compiled transient sits in the graph's memory, ~0 for one that isn't placed
+    uint64 TransientOffset(RenderResource resource) const;
+
+    // The batch recorded before a pass, pass numbered in the order added. Empty for a culled one.
+    ArrayView<const gaBarrier> BarriersBefore(uint32 pass) const;
+
+    // The batch after the last pass: imported resources into their final states
+    ArrayView<const gaBarrier> FinalBarriers() const;
+
+    bool IsCulled(uint32 pass) const;
+
+    RenderGraphStats Stats() const;
+
+  private:
+    friend class RenderPassBuilder;
+
+    struct State;
+
+    RenderGraph() = default;
+
+    void AddAccess(uint32 pass, RenderResource resource, gaResourceState state, bool write);
+
+    State* m_state = nullptr;
+};
+
+} // namespace rsbl
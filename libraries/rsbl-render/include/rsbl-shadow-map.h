@@ -0,0 +1,204 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-bounds.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-hash-map.h>
+#include <rsbl-int-types.h>
+#include <rsbl-math-types.h>
+#include <rsbl-matrix.h>
+#include <rsbl-result.h>
+
+// Cached shadow maps for a directional light. The shadow map is cut into cascades, levels each
+// twice the size of the one before and all centred on the camera, and every level into square
+// pages on a grid fixed in the light's space rather than to the camera. A page keeps what it
+// rendered while the camera moves, so static geometry is rendered into a page once and again only
+// when the light turns or a static object in it moves. Dynamic objects are rendered on top of a
+// copy of it, in the frames they touch the page.
+//
+// Pages are virtual: only the ones something on screen needs get one of the atlas's physical
+// pages, and physical pages no longer needed keep their static contents for when they're needed
+// again, until the least recently needed are taken for others. Each physical page has a slot in
+// two atlases, the static cache and the one shaders sample:
+//
+//     shadows.BeginFrame(lightDirection, cameraPosition);
+//     ... for each static object that moved, shadows.InvalidateStatic(before), (after) ...
+//     ... for each dynamic object, shadows.AddDynamicCaster(bounds) ...
+//     ... for each visible object, shadows.Request(bounds) ...
+//     shadows.Update();
+//     for (const ShadowPageUpdate& update : shadows.Updates())
+//     {
+//         ... renderStatic: clear the page's static slot, draw the static casters into it ...
+//         ... copy the static slot to the sampled one ...
+//         ... renderDynamic: draw the dynamic casters into the sampled slot ...
+//     }
+//     ... upload shadows.PageTable() for the shaders to find pages with ...
+//
+// Pages not in Updates() are already right, and are left alone. A shader picks the first level
+// whose grid around the camera (ShadowLevel::firstPageX and Y) has the point, and finds its page
+// at (pageX mod pagesPerSide, pageY mod pagesPerSide) in the level's part of the page table.
+//
+// Depth covers depthRange around the camera along the light, snapped to a quarter of it, so the
+// camera moving that far along the light starts every page again, as a light turning does.
+
+namespace rsbl
+{
+
+// The most levels a shadow map can have
+constexpr uint32 kMaxShadowLevels = 16;
+
+// A page table entry without a physical page
+constexpr uint32 kNoShadowPage = ~0u;
+
+struct ShadowMapDesc
+{
+    uint32 levelCount = 6;
+    // Of each level's grid of pages around the camera, a power of two
+    uint32 pagesPerSide = 16;
+    // Level 0's side in world units; each level after is twice the last
+    float firstLevelSize = 16.0f;
+    // Light-space depth the pages cover, centred on the camera
+    float depthRange = 512.0f;
+    // Pages the atlases have room for
+    uint32 physicalPageCount = 1024;
+};
+
+// Page x, y of a level's grid, counted from the light space origin
+struct ShadowPageKey
+{
+    uint32 level = 0;
+    int32 x = 0;
+    int32 y = 0;
+};
+
+struct ShadowPageUpdate
+{
+    ShadowPageKey key;
+    uint32 physicalPage = 0;
+    // World to the page's clip space, x and y -1 to 1 across it and depth 0 to 1 along the light
+    simd::float4x4 viewProjection;
+    // The static slot is new or stale, its static casters are drawn again
+    bool renderStatic = false;
+    // Dynamic casters touch the page this frame
+    bool renderDynamic = false;
+};
+
+// Where a level's grid is this frame, in its pages. Its part of the page table starts at
+// level * pagesPerSide * pagesPerSide.
+struct ShadowLevel
+{
+    int32 firstPageX = 0;
+    int32 firstPageY = 0;
+    float pageSize = 0.0f; // In world units
+};
+
+struct ShadowMapStats
+{
+    uint32 pagesNeeded = 0;
+    uint32 staticRenders = 0;
+    uint32 dynamicRenders = 0;
+    // Needed with every physical page needed too, left out of the page table
+    uint32 pagesDropped = 0;
+};
+
+class VirtualShadowMap
+{
+  public:
+    // InvalidArgument for a desc out of range, leaving the map as it was
+    Result<> Init(const ShadowMapDesc& desc);
+
+    // Starts a frame, dropping every page when the light turned or the depth range moved. The
+    // direction is the one the light shines in.
+    void BeginFrame(float3 lightDirection, float3 cameraPosition);
+
+    // A static object's bounds, where it was or is now. Pages it overlaps in any level draw
+    // their static casters again when next needed.
+    void InvalidateStatic(const Aabb& bounds);
+
+    // A dynamic object's bounds this frame
+    void AddDynamicCaster(const Aabb& bounds);
+
+    // The pages of one level that shadows on bounds need: the finest level whose grid reaches the
+    // point of bounds nearest the camera, as far as that grid goes
+    void Request(const Aabb& bounds);
+
+    // A page, from GPU feedback say. Ignored outside the level's grid.
+    void RequestPage(const ShadowPageKey& key);
+
+    // Gives the needed pages physical pages, and lists the ones to render
+    void Update();
+
+    ArrayView<const ShadowPageUpdate> Updates() const
+    {
+        return m_updates;
+    }
+
+    // A physical page or kNoShadowPage per page of each level's grid, levels one after the other
+    ArrayView<const uint32> PageTable() const
+    {
+        return m_pageTable;
+    }
+
+    ArrayView<const ShadowLevel> Levels() const
+    {
+        return ArrayView<const ShadowLevel>(m_levels, m_desc.levelCount);
+    }
+
+    // World to light space, before any page's projection
+    const simd::float4x4& LightView() const
+    {
+        return m_lightView;
+    }
+
+    ShadowMapStats Stats() const
+    {
+        return m_stats;
+    }
+
+  private:
+    struct PhysicalPage
+    {
+        ShadowPageKey key;
+        uint64 lastNeeded = 0;
+        bool used = false;
+        bool staticValid = false;
+        // The sampled slot has dynamic casters drawn in it
+        bool dynamicDrawn = false;
+    };
+
+    // Bounds' light-space extent across the light: min x, min y, max x, max y
+    float4 Footprint(const Aabb& bounds) const;
+    uint32 AllocatePhysicalPage();
+    void DropAllPages();
+
+    ShadowMapDesc m_desc;
+    float3 m_lightDirection = float3(0.0f);
+    float3 m_camera = float3(0.0f);
+    float3 m_lightCamera = float3(0.0f); // The camera in light space
+    float m_depthCenter = 0.0f;
+    simd::float4x4 m_lightView = simd::Identity4x4();
+    ShadowLevel m_levels[kMaxShadowLevels] = {};
+    uint64 m_frame = 0;
+
+    DynamicArray<PhysicalPage> m_physicalPages;
+    DynamicArray<uint32> m_freePages;
+    // Oldest first, (lastNeeded << 32) | page of the ones no longer needed, made as needed
+    DynamicArray<uint64> m_evictable;
+    uint32 m_nextEvictable = 0;
+    bool m_evictableBuilt = false;
+    HashMap<uint64, uint32> m_cached;
+
+    // Per page of each level's grid, like the page table
+    DynamicArray<uint32> m_pageTable;
+    DynamicArray<uint8> m_needed;
+    DynamicArray<uint8> m_dynamic;
+    // Light-space footprints, min x, min y, max x, max y
+    DynamicArray<float4> m_dynamicCasters;
+    DynamicArray<ShadowPageUpdate> m_updates;
+    ShadowMapStats m_stats;
+};
+
+} // namespace rsbl
@@ -0,0 +1,147 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-bounds.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-ga.h>
+#include <rsbl-int-types.h>
+#include <rsbl-math-types.h>
+
+// Vertex pulling: rather than an input layout feeding the vertex shader its attributes, the
+// shader loads them itself from a ByteAddressBuffer in the bindless heap, by vertex index, and
+// decodes them however they were packed. The pipelines have no attributes or vertex buffers, so
+// one pipeline draws every vertex format instead of a permutation per layout, attributes can be
+// packed in ways no gaFormat describes, and a mesh shader reads the same buffer as a vertex
+// shader does, meshlets and index buffers sharing the vertices.
+//
+// GpuVertexStreams says where each attribute is and how it's packed: interleaved like the cooked
+// meshes' 20 byte CookedVertex (CookedVertexStreams), or each attribute in its own tightly packed
+// range (SplitVertexStreams), so a pass that only needs positions, a depth prepass or a shadow
+// map, reads 8 bytes a vertex instead of 20:
+//
+//     ... upload the mesh's vertices, register them as a raw bindless BufferSrv (stride 0) ...
+//     GpuVertexStreams streams = CookedVertexStreams(vertices_index, 0, submesh.bounds);
+//     streams.baseVertex = submesh.vertexOffset;
+//     ... push streams with the draw's constants, the pipeline made with
+//         ApplyVertexPullingPipelineState, and draw ...
+//
+// kVertexPullingShader has the HLSL side, PullVertex, and PullVertex below is the same decode on
+// the CPU.
+
+namespace rsbl
+{
+
+// What a vertex shader gets from PullVertex. Each is optional in a layout.
+enum class VertexAttribute : uint32
+{
+    Position,
+    // A QTangent, the normal, tangent and bitangent sign as one quaternion (rsbl-packing.h)
+    TangentFrame,
+    Uv,
+    Color,
+
+    Count,
+};
+
+constexpr uint32 kVertexAttributeCount = static_cast<uint32>(VertexAttribute::Count);
+
+// How an attribute is packed, little endian, x first. Every one is a multiple of 4 bytes, which
+// raw buffer loads need.
+enum class VertexStreamFormat : uint16
+{
+    None, // Not in the layout, PullVertex gives the attribute's default
+    Float32x2,
+    Float32x3,
+    Float32x4,
+    Half16x2,
+    Half16x4,
+    Unorm16x4,
+    Snorm16x4,
+    Unorm8x4,
+    Snorm8x4,
+};
+
+uint32 VertexStreamFormatSize(VertexStreamFormat format);
+
+// Where one attribute is: vertex v's at byte offset + v * stride of the buffer. Both a multiple
+// of 4.
+struct GpuVertexStream
+{
+    uint32 offset = 0;
+    uint16 stride = 0;
+    VertexStreamFormat format = VertexStreamFormat::None;
+};
+
+// A mesh's vertices as kVertexPullingShader reads them, small enough for push constants. The
+// vertex index a draw or meshlet gives is relative to baseVertex, so submeshes, and every
+// meshlet of one, share a buffer.
+struct GpuVertexStreams
+{
+    // Positions decode to positionMin + position * positionScale, so unorm16s over a submesh's
+    // bounds come back in its space. 0 and 1 for float positions.
+    float positionMin[3] = {0.0f, 0.0f, 0.0f};
+    // Bindless index of the vertices, a raw BufferSrv
+    uint32 buffer = 0;
+    float positionScale[3] = {1.0f, 1.0f, 1.0f};
+    uint32 baseVertex = 0;
+    GpuVertexStream streams[kVertexAttributeCount];
+
+    GpuVertexStream& operator[](VertexAttribute attribute)
+    {
+        return streams[static_cast<uint32>(attribute)];
+    }
+    const GpuVertexStream& operator[](VertexAttribute attribute) const
+    {
+        return streams[static_cast<uint32>(attribute)];
+    }
+};
+
+static_assert(sizeof(GpuVertexStreams) == 64, "GpuVertexStreams is read by shaders as laid out");
+
+// The cooked meshes' interleaved CookedVertex (rsbl-cooked-mesh.h) starting offset bytes into
+// the buffer: positions as unorm16s over bounds, QTangents as snorm16s and UVs as halves
+struct CookedVertexLayout
+{
+    static constexpr uint32 kStride = 20;
+    static constexpr uint32 kPositionOffset = 0;
+    static constexpr uint32 kTangentFrameOffset = 8;
+    static constexpr uint32 kUvOffset = 16;
+};
+
+GpuVertexStreams CookedVertexStreams(uint32 buffer, uint32 offset, const Aabb& bounds);
+
+// Copies vertexCount vertices from baseVertex on of source's layout in data into packed, each
+// attribute in a range of its own at its format's size, 16 byte aligned, and returns their
+// layout, with baseVertex 0. The buffer and position transform carry over.
+GpuVertexStreams SplitVertexStreams(const GpuVertexStreams& source,
+                                    ByteView data,
+                                    uint32 vertexCount,
+                                    DynamicArray<uint8>& packed);
+
+// A vertex as kVertexPullingShader's PullVertex decodes it
+struct PulledVertex
+{
+    float3 position = float3(0.0f);
+    float3 normal = float3(0.0f, 0.0f, 1.0f);
+    // w is the bitangent's sign
+    float4 tangent = float4(1.0f, 0.0f, 0.0f, 1.0f);
+    float2 uv = float2(0.0f);
+    float4 color = float4(1.0f);
+};
+
+// The vertex at index (relative to streams.baseVertex) of data, which stands in for the buffer
+PulledVertex PullVertex(const GpuVertexStreams& streams, ByteView data, uint32 index);
+
+// Takes the attributes and vertex buffers off desc, leaving the rest of it as it was, and makes
+// room for a GpuVertexStreams at the start of the push constants
+void ApplyVertexPullingPipelineState(gaGraphicsPipelineDesc& desc);
+
+// HLSL source for vertex and mesh shaders to include: VertexStreams, matching GpuVertexStreams,
+// and PullVertex(streams, index), which loads and decodes a vertex from the bindless heap. Its
+// pipelines need the cache's bindless heap.
+extern const char kVertexPullingShader[];
+
+} // namespace rsbl
@@ -0,0 +1,204 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-frame-pipeline.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-clock.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-sync.h>
+#include <rsbl-thread.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace rsbl
+{
+
+struct FramePipeline::State
+{
+    State(FrameRenderFunction&& renderFunction, const FramePipelineOptions& options)
+        : render(rsblMove(renderFunction))
+        , packetCount(options.packetCount)
+        , arena(options.arenaBlockSize, options.packetCount, GetTaggedAllocator(MemoryTag::Scene))
+    {
+    }
+
+    FrameRenderFunction render;
+    uint32 packetCount = 2;
+    // One arena per packet, rotated along with them
+    FrameArena arena;
+    FramePacket packets[FrameArena::kMaxFrameCount];
+
+    // Frames handed over and rendered so far. The simulation waits on packetFree for rendered to
+    // catch up, the render thread on workReady for submitted to move on.
+    std::atomic<uint64> submitted{0};
+    std::atomic<uint64> rendered{0};
+    Event workReady{Event::ResetMode::Auto};
+    Event packetFree{Event::ResetMode::Auto};
+    std::atomic<bool> stopping{false};
+
+    // Between BeginFrame and Submit
+    bool filling = false;
+
+    // The first failure, copied off the render thread before failed is set
+    std::atomic<bool> failed{false};
+    ErrorCategory failureCategory = ErrorCategory::None;
+    char failureText[256] = {};
+
+    uint64 simulationWaitNs = 0;
+    std::atomic<uint64> renderWaitNs{0};
+
+    UniquePtr<Thread> thread;
+
+    Result<> RenderMain()
+    {
+        uint64 frame = 0;
+        for (;;)
+        {
+            while (submitted.load(std::memory_order_acquire) == frame)
+            {
+                if (stopping.load(std::memory_order_acquire))
+                {
+                    return ResultCode::Success;
+                }
+                const uint64 start = Clock::NowTicks();
+                workReady.Wait();
+                renderWaitNs.fetch_add(Clock::TicksToNs(Clock::NowTicks() - start),
+                                       std::memory_order_relaxed);
+            }
+
+            // After a failure packets still go round, so the simulation never waits on one
+            const FramePacket& packet = packets[frame % packetCount];
+            if (!failed.load(std::memory_order_relaxed))
+            {
+                if (const Result<> rendered_frame = render(packet); !rendered_frame)
+                {
+                    failureCategory = rendered_frame.Category();
+                    strncpy(failureText, rendered_frame.FailureText(), sizeof(failureText) - 1);
+                    failed.store(true, std::memory_order_release);
+                }
+            }
+
+            ++frame;
+            rendered.store(frame, std::memory_order_release);
+            packetFree.Set();
+        }
+    }
+};
+
+Result<UniquePtr<FramePipeline>> FramePipeline::Create(FrameRenderFunction&& render,
+                                                       const FramePipelineOptions& options)
+{
+    if (options.packetCount < 2 || options.packetCount > FrameArena::kMaxFrameCount)
+    {
+        return FailureFormat(ErrorCategory::InvalidArgument,
+                             "%u packets, a frame pipeline takes 2 to %u",
+                             options.packetCount,
+                             FrameArena::kMaxFrameCount);
+    }
+
+    MemoryTagScope memory_scope(MemoryTag::Scene);
+
+    UniquePtr<FramePipeline> pipeline(new FramePipeline());
+    pipeline->m_state = new State(rsblMove(render), options);
+
+    State* state = pipeline->m_state;
+    ThreadCreateInfo info;
+    info.name = "rsbl-render";
+    Result<UniquePtr<Thread>> thread =
+        Thread::Create(info, [state]() -> Result<> { return state->RenderMain(); });
+    if (!thread)
+    {
+        return thread.FailureText();
+    }
+    state->thread = rsblMove(thread.Value());
+
+    return rsblMove(pipeline);
+}
+
+FramePipeline::~FramePipeline()
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+
+    if (m_state->thread)
+    {
+        m_state->stopping.store(true, std::memory_order_release);
+        m_state->workReady.Set();
+        const Result<> joined = m_state->thread->Join();
+        rsblAssert(joined);
+    }
+    delete m_state;
+}
+
+FramePacket& FramePipeline::BeginFrame()
+{
+    State& state = *m_state;
+    rsblAssertMsg(!state.filling, "BeginFrame twice without a Submit");
+
+    const uint64 frame = state.submitted.load(std::memory_order_relaxed);
+    if (frame - state.rendered.load(std::memory_order_acquire) >= state.packetCount)
+    {
+        const uint64 start = Clock::NowTicks();
+        while (frame - state.rendered.load(std::memory_order_acquire) >= state.packetCount)
+        {
+            state.packetFree.Wait();
+        }
+        state.simulationWaitNs += Clock::TicksToNs(Clock::NowTicks() - start);
+    }
+
+    // The arena this moves on to is the one the packet's last frame was in, rendered by now
+    state.arena.BeginFrame();
+    FramePacket& packet = state.packets[frame % state.packetCount];
+    packet.frame = frame;
+    packet.data = nullptr;
+    packet.memory = &state.arena;
+    state.filling = true;
+    return packet;
+}
+
+Result<> FramePipeline::Submit(FramePacket& packet)
+{
+    State& state = *m_state;
+    rsblAssertMsg(state.filling && &packet == &state.packets[packet.frame % state.packetCount],
+                  "Submit takes the packet from the last BeginFrame");
+    state.filling = false;
+
+    state.submitted.store(packet.frame + 1, std::memory_order_release);
+    state.workReady.Set();
+
+    if (state.failed.load(std::memory_order_acquire))
+    {
+        return FailureCopy(state.failureCategory, state.failureText);
+    }
+    return ResultCode::Success;
+}
+
+void FramePipeline::Flush()
+{
+    State& state = *m_state;
+    const uint64 submitted = state.submitted.load(std::memory_order_relaxed);
+    while (state.rendered.load(std::memory_order_acquire) < submitted)
+    {
+        state.packetFree.Wait();
+    }
+}
+
+uint64 FramePipeline::FramesSubmitted() const
+{
+    return m_state->submitted.load(std::memory_order_relaxed);
+}
+
+FramePipelineStats FramePipeline::Stats() const
+{
+    FramePipelineStats stats;
+    stats.framesRendered = m_state->rendered.load(std::memory_order_acquire);
+    stats.simulationWaitNs = m_state->simulationWaitNs;
+    stats.renderWaitNs = m_state->renderWaitNs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace rsbl
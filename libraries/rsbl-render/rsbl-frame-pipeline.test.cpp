@@ -0,0 +1,155 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-frame-pipeline.h"
+
+#include <rsbl-thread.h>
+
+#include <atomic>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+// What the simulation hands over each frame, some of it behind a pointer into the packet's memory
+struct FrameView
+{
+    uint64 frame = 0;
+    uint32* values = nullptr;
+    uint32 valueCount = 0;
+};
+
+constexpr uint32 kValueCount = 64;
+
+FrameView* FillPacket(FramePacket& packet)
+{
+    FrameView* view = static_cast<FrameView*>(
+        packet.memory->Allocate(sizeof(FrameView), alignof(FrameView)));
+    view->frame = packet.frame;
+    view->values = static_cast<uint32*>(
+        packet.memory->Allocate(kValueCount * sizeof(uint32), alignof(uint32)));
+    view->valueCount = kValueCount;
+    for (uint32 i = 0; i < kValueCount; ++i)
+    {
+        view->values[i] = static_cast<uint32>(packet.frame) * 1000 + i;
+    }
+    packet.data = view;
+    return view;
+}
+} // namespace
+
+TEST_SUITE("rsbl::FramePipeline")
+{
+    TEST_CASE("Packets render in order, with what the simulation put in them")
+    {
+        for (const uint32 packet_count : {2u, 3u})
+        {
+            std::atomic<uint64> next{0};
+            std::atomic<bool> intact{true};
+            FramePipelineOptions options;
+            options.packetCount = packet_count;
+            auto created = FramePipeline::Create(
+                [&](const FramePacket& packet) -> Result<> {
+                    const FrameView& view = *static_cast<const FrameView*>(packet.data);
+                    bool ok = view.frame == packet.frame && packet.frame == next.load();
+                    for (uint32 i = 0; i < view.valueCount; ++i)
+                    {
+                        ok = ok && view.values[i] == static_cast<uint32>(view.frame) * 1000 + i;
+                    }
+                    if (!ok)
+                    {
+                        intact.store(false);
+                    }
+                    next.fetch_add(1);
+                    return ResultCode::Success;
+                },
+                options);
+            REQUIRE(created);
+            FramePipeline& pipeline = *created.Value();
+
+            for (uint32 frame = 0; frame < 200; ++frame)
+            {
+                FramePacket& packet = pipeline.BeginFrame();
+                CHECK(packet.frame == frame);
+                CHECK(packet.data == nullptr);
+                FillPacket(packet);
+                REQUIRE(pipeline.Submit(packet));
+            }
+            pipeline.Flush();
+            CHECK(next.load() == 200);
+            CHECK(pipeline.Stats().framesRendered == 200);
+            CHECK(intact.load());
+        }
+    }
+
+    TEST_CASE("The simulation stays no more than the packets ahead")
+    {
+        FramePipelineOptions options;
+        options.packetCount = 3;
+        auto created = FramePipeline::Create(
+            [](const FramePacket&) -> Result<> {
+                Thread::ThreadSleep(2);
+                return ResultCode::Success;
+            },
+            options);
+        REQUIRE(created);
+        FramePipeline& pipeline = *created.Value();
+
+        for (uint32 frame = 0; frame < 20; ++frame)
+        {
+            FramePacket& packet = pipeline.BeginFrame();
+            // Whatever isn't rendered yet, this one included, has a packet of its own
+            CHECK(packet.frame - pipeline.Stats().framesRendered < options.packetCount);
+            CHECK(pipeline.Submit(packet));
+        }
+        // Rendering is the slow side here
+        CHECK(pipeline.Stats().simulationWaitNs > 0);
+    }
+
+    TEST_CASE("A failed frame fails the submits after it, and packets keep going round")
+    {
+        auto created = FramePipeline::Create([](const FramePacket& packet) -> Result<> {
+            if (packet.frame == 3)
+            {
+                return FailureFormat(ErrorCategory::Platform, "Device lost on frame %llu",
+                                     static_cast<unsigned long long>(packet.frame));
+            }
+            return ResultCode::Success;
+        });
+        REQUIRE(created);
+        FramePipeline& pipeline = *created.Value();
+
+        bool failed = false;
+        for (uint32 frame = 0; frame < 20; ++frame)
+        {
+            FramePacket& packet = pipeline.BeginFrame();
+            const Result<> submitted = pipeline.Submit(packet);
+            if (!submitted)
+            {
+                failed = true;
+                CHECK(submitted.Category() == ErrorCategory::Platform);
+                CHECK(strcmp(submitted.FailureText(), "Device lost on frame 3") == 0);
+            }
+        }
+        pipeline.Flush();
+        CHECK(failed);
+        CHECK(pipeline.Stats().framesRendered == 20);
+    }
+
+    TEST_CASE("Packet counts outside 2 to 4 fail")
+    {
+        FramePipelineOptions options;
+        options.packetCount = 1;
+        CHECK_FALSE(FramePipeline::Create(
+            [](const FramePacket&) -> Result<> { return ResultCode::Success; }, options));
+        options.packetCount = FrameArena::kMaxFrameCount + 1;
+        const auto created = FramePipeline::Create(
+            [](const FramePacket&) -> Result<> { return ResultCode::Success; }, options);
+        CHECK_FALSE(created);
+        CHECK(created.Category() == ErrorCategory::InvalidArgument);
+    }
+}
@@ -0,0 +1,310 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-material.h"
+
+#include <rsbl-sort.h>
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+// Material ids in a sort key
+constexpr uint32 kMaterialBits = 29;
+constexpr uint64 kMaterialMask = (uint64(1) << kMaterialBits) - 1;
+
+const gaBlendMode kBlended[kGaMaxRenderTargets] = {
+    gaBlendMode::AlphaBlend,
+    gaBlendMode::AlphaBlend,
+    gaBlendMode::AlphaBlend,
+    gaBlendMode::AlphaBlend,
+    gaBlendMode::AlphaBlend,
+    gaBlendMode::AlphaBlend,
+    gaBlendMode::AlphaBlend,
+    gaBlendMode::AlphaBlend,
+};
+
+uint32 PipelineOf(const MaterialDesc& desc)
+{
+    return static_cast<uint32>(desc.alphaMode) * 2 + (desc.doubleSided ? 1 : 0);
+}
+
+GpuMaterial Pack(const MaterialDesc& desc)
+{
+    GpuMaterial packed = {};
+    packed.baseColorFactor[0] = desc.baseColorFactor.x;
+    packed.baseColorFactor[1] = desc.baseColorFactor.y;
+    packed.baseColorFactor[2] = desc.baseColorFactor.z;
+    packed.baseColorFactor[3] = desc.baseColorFactor.w;
+    packed.emissiveFactor[0] = desc.emissiveFactor.x;
+    packed.emissiveFactor[1] = desc.emissiveFactor.y;
+    packed.emissiveFactor[2] = desc.emissiveFactor.z;
+    packed.metallicFactor = desc.metallicFactor;
+    packed.roughnessFactor = desc.roughnessFactor;
+    packed.normalScale = desc.normalScale;
+    packed.occlusionStrength = desc.occlusionStrength;
+    packed.alphaCutoff = desc.alphaCutoff;
+    packed.baseColorTexture = desc.baseColorTexture;
+    packed.metallicRoughnessTexture = desc.metallicRoughnessTexture;
+    packed.normalTexture = desc.normalTexture;
+    packed.occlusionTexture = desc.occlusionTexture;
+    packed.emissiveTexture = desc.emissiveTexture;
+
+    MaterialFeatures features = MaterialFeatures::None;
+    const auto feature = [&features](uint32 texture, MaterialFeatures flag)
+    {
+        if (texture != kNoMaterialTexture)
+        {
+            features = features | flag;
+        }
+    };
+    feature(desc.baseColorTexture, MaterialFeatures::BaseColorTexture);
+    feature(desc.metallicRoughnessTexture, MaterialFeatures::MetallicRoughnessTexture);
+    feature(desc.normalTexture, MaterialFeatures::NormalTexture);
+    feature(desc.occlusionTexture, MaterialFeatures::OcclusionTexture);
+    feature(desc.emissiveTexture, MaterialFeatures::EmissiveTexture);
+    if (desc.unlit)
+    {
+        features = features | MaterialFeatures::Unlit;
+    }
+    if (desc.doubleSided)
+    {
+        features = features | MaterialFeatures::DoubleSided;
+    }
+    packed.features = features;
+    return packed;
+}
+
+// Positive floats order as their bits do. Behind the camera counts as at it.
+uint32 DepthBits(float viewDepth)
+{
+    const float depth = viewDepth > 0.0f ? viewDepth : 0.0f;
+    uint32 bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    return bits;
+}
+} // namespace
+
+void ApplyMaterialPipelineState(uint32 pipeline, gaGraphicsPipelineDesc& desc)
+{
+    rsblAssert(pipeline < kMaterialPipelineCount);
+    desc.raster.cull = MaterialPipelineDoubleSided(pipeline) ? gaCullMode::None : gaCullMode::Back;
+    if (MaterialPipelineAlphaMode(pipeline) == MaterialAlphaMode::Blend)
+    {
+        desc.blendModes = ArrayView<const gaBlendMode>(kBlended, desc.renderTargetFormats.Size());
+        desc.depth.write = false;
+    }
+    else
+    {
+        desc.blendModes = {};
+        desc.depth.write = desc.depth.test;
+    }
+}
+
+uint32 MaterialTable::Add(const MaterialDesc& desc)
+{
+    const uint32 material = Count();
+    rsblAssert(material <= kMaterialMask);
+    m_materials.PushBack(GpuMaterial{});
+    m_pipelines.PushBack(0);
+    ++m_pipelineUses[0];
+    Update(material, desc);
+    return material;
+}
+
+void MaterialTable::Update(uint32 material, const MaterialDesc& desc)
+{
+    rsblAssert(material < Count());
+    m_materials[material] = Pack(desc);
+
+    const uint32 pipeline = PipelineOf(desc);
+    --m_pipelineUses[m_pipelines[material]];
+    ++m_pipelineUses[pipeline];
+    m_pipelines[material] = static_cast<uint8>(pipeline);
+
+    MaterialFeatures& variant = m_variantFeatures[static_cast<uint32>(desc.alphaMode)];
+    variant = variant | m_materials[material].features;
+
+    if (DirtyCount() == 0)
+    {
+        m_firstDirty = material;
+        m_dirtyEnd = material + 1;
+    }
+    else
+    {
+        m_firstDirty = material < m_firstDirty ? material : m_firstDirty;
+        m_dirtyEnd = material + 1 > m_dirtyEnd ? material + 1 : m_dirtyEnd;
+    }
+}
+
+void MaterialTable::ClearDirty()
+{
+    m_firstDirty = 0;
+    m_dirtyEnd = 0;
+}
+
+MaterialSortStats MaterialTable::SortDraws(ArrayView<MaterialDraw> draws)
+{
+    // Opaque and masked: alpha mode, double-sided, material, depth. Blended: alpha mode, depth
+    // farthest first, double-sided, material.
+    m_sortKeys.ResizeUninitialized(draws.Size());
+    for (uint64 i = 0; i < draws.Size(); ++i)
+    {
+        const MaterialDraw& draw = draws[i];
+        rsblAssert(draw.material < Count());
+        const uint32 pipeline = m_pipelines[draw.material];
+        const uint64 alphaMode = pipeline / 2;
+        const uint64 doubleSided = pipeline & 1;
+        const uint64 depth = DepthBits(draw.viewDepth);
+        if (MaterialPipelineAlphaMode(pipeline) == MaterialAlphaMode::Blend)
+        {
+            m_sortKeys[i] = (alphaMode << 62) | ((~depth & 0xffffffffu) << 30) |
+                            (doubleSided << kMaterialBits) | draw.material;
+        }
+        else
+        {
+            m_sortKeys[i] = (alphaMode << 62) | (doubleSided << 61) |
+                            (uint64(draw.material) << 32) | depth;
+        }
+    }
+    RadixSort(ArrayView<uint64>(m_sortKeys.Data(), draws.Size()), draws);
+
+    MaterialSortStats stats;
+    uint32 pipeline = kMaterialPipelineCount;
+    uint32 material = ~0u;
+    for (const MaterialDraw& draw : draws)
+    {
+        stats.pipelineChanges += m_pipelines[draw.material] != pipeline ? 1 : 0;
+        stats.materialChanges += draw.material != material ? 1 : 0;
+        pipeline = m_pipelines[draw.material];
+        material = draw.material;
+    }
+    return stats;
+}
+
+// Structured buffers pack tightly, so Material matches GpuMaterial
+const char kMaterialShader[] = R"(
+struct Material // GpuMaterial
+{
+    float4 baseColorFactor;
+    float3 emissiveFactor;
+    float metallicFactor;
+    float roughnessFactor;
+    float normalScale;
+    float occlusionStrength;
+    float alphaCutoff;
+    uint baseColorTexture;
+    uint metallicRoughnessTexture;
+    uint normalTexture;
+    uint occlusionTexture;
+    uint emissiveTexture;
+    uint features;
+    uint2 padding;
+};
+
+// MaterialFeatures
+static const uint kBaseColorTexture = 1 << 0;
+static const uint kMetallicRoughnessTexture = 1 << 1;
+static const uint kNormalTexture = 1 << 2;
+static const uint kOcclusionTexture = 1 << 3;
+static const uint kEmissiveTexture = 1 << 4;
+static const uint kUnlit = 1 << 5;
+static const uint kDoubleSided = 1 << 6;
+
+// MaterialAlphaMode
+static const uint kAlphaOpaque = 0;
+static const uint kAlphaMask = 1;
+static const uint kAlphaBlend = 2;
+
+#ifndef MATERIAL_ALPHA_MODE
+#define MATERIAL_ALPHA_MODE 0
+#endif
+#ifndef MATERIAL_FEATURES
+#define MATERIAL_FEATURES 0xffffffff
+#endif
+
+// Folds to false at compile time for a feature no material of the variant has
+bool HasFeature(Material material, uint feature)
+{
+    return (MATERIAL_FEATURES & feature) != 0 && (material.features & feature) != 0;
+}
+
+struct MaterialSample
+{
+    float4 baseColor; // Linear, alpha in w
+    float metallic;
+    float roughness;
+    float occlusion;
+    float3 emissive;
+    float3 normal; // World space, normalized, facing the viewer on double-sided back faces
+    bool unlit;
+};
+
+// The material at a pixel, from its interpolated uv, normal and tangent (w the bitangent's
+// sign). The mask variant discards below the cutoff here.
+MaterialSample SampleMaterial(Material material,
+                              SamplerState textureSampler,
+                              float2 uv,
+                              float3 normal,
+                              float4 tangent,
+                              bool frontFace)
+{
+    MaterialSample result;
+    result.baseColor = material.baseColorFactor;
+    if (HasFeature(material, kBaseColorTexture))
+    {
+        Texture2D<float4> texture = ResourceDescriptorHeap[material.baseColorTexture];
+        result.baseColor *= texture.Sample(textureSampler, uv);
+    }
+#if MATERIAL_ALPHA_MODE == 1
+    clip(result.baseColor.a - material.alphaCutoff);
+#endif
+
+    result.metallic = material.metallicFactor;
+    result.roughness = material.roughnessFactor;
+    if (HasFeature(material, kMetallicRoughnessTexture))
+    {
+        Texture2D<float4> texture = ResourceDescriptorHeap[material.metallicRoughnessTexture];
+        const float4 texel = texture.Sample(textureSampler, uv);
+        result.metallic *= texel.b;
+        result.roughness *= texel.g;
+    }
+
+    result.occlusion = 1.0;
+    if (HasFeature(material, kOcclusionTexture))
+    {
+        Texture2D<float4> texture = ResourceDescriptorHeap[material.occlusionTexture];
+        const float texel = texture.Sample(textureSampler, uv).r;
+        result.occlusion = 1.0 + material.occlusionStrength * (texel - 1.0);
+    }
+
+    result.emissive = material.emissiveFactor;
+    if (HasFeature(material, kEmissiveTexture))
+    {
+        Texture2D<float4> texture = ResourceDescriptorHeap[material.emissiveTexture];
+        result.emissive *= texture.Sample(textureSampler, uv).rgb;
+    }
+
+    const float side = HasFeature(material, kDoubleSided) && !frontFace ? -1.0 : 1.0;
+    result.normal = normalize(normal) * side;
+    if (HasFeature(material, kNormalTexture))
+    {
+        // BC5, two channels, z rebuilt
+        Texture2D<float2> texture = ResourceDescriptorHeap[material.normalTexture];
+        float3 texel;
+        texel.xy = (texture.Sample(textureSampler, uv) * 2.0 - 1.0) * material.normalScale;
+        texel.z = sqrt(saturate(1.0 - dot(texel.xy, texel.xy)));
+        const float3 t = normalize(tangent.xyz) * side;
+        const float3 b = cross(result.normal, t) * tangent.w;
+        result.normal = normalize(texel.x * t + texel.y * b + texel.z * result.normal);
+    }
+
+    result.unlit = HasFeature(material, kUnlit);
+    return result;
+}
+)";
+
+} // namespace rsbl
@@ -0,0 +1,161 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-material.h"
+
+using namespace rsbl;
+
+namespace
+{
+MaterialDesc Desc(MaterialAlphaMode alphaMode, bool doubleSided = false)
+{
+    MaterialDesc desc;
+    desc.alphaMode = alphaMode;
+    desc.doubleSided = doubleSided;
+    return desc;
+}
+} // namespace
+
+TEST_SUITE("rsbl::MaterialTable")
+{
+    TEST_CASE("Materials pack as the shader reads them")
+    {
+        MaterialTable materials;
+        MaterialDesc desc;
+        desc.baseColorFactor = float4(0.5f, 0.25f, 1.0f, 0.75f);
+        desc.emissiveFactor = float3(2.0f, 0.0f, 1.0f);
+        desc.metallicFactor = 0.0f;
+        desc.roughnessFactor = 0.3f;
+        desc.alphaCutoff = 0.25f;
+        desc.baseColorTexture = 7;
+        desc.normalTexture = 9;
+        desc.unlit = true;
+        const uint32 id = materials.Add(desc);
+        const uint32 plain = materials.Add(MaterialDesc{});
+        CHECK(id == 0);
+        CHECK(plain == 1);
+        REQUIRE(materials.Materials().Size() == 2);
+
+        const GpuMaterial& packed = materials.Materials()[id];
+        CHECK(packed.baseColorFactor[1] == 0.25f);
+        CHECK(packed.baseColorFactor[3] == 0.75f);
+        CHECK(packed.emissiveFactor[0] == 2.0f);
+        CHECK(packed.roughnessFactor == 0.3f);
+        CHECK(packed.alphaCutoff == 0.25f);
+        CHECK(packed.baseColorTexture == 7);
+        CHECK(packed.normalTexture == 9);
+        CHECK(packed.emissiveTexture == kNoMaterialTexture);
+        CHECK(HasFlag(packed.features, MaterialFeatures::BaseColorTexture));
+        CHECK(HasFlag(packed.features, MaterialFeatures::NormalTexture));
+        CHECK(HasFlag(packed.features, MaterialFeatures::Unlit));
+        CHECK_FALSE(HasFlag(packed.features, MaterialFeatures::EmissiveTexture));
+        CHECK(materials.Materials()[plain].features == MaterialFeatures::None);
+
+        CHECK(materials.FirstDirty() == 0);
+        CHECK(materials.DirtyCount() == 2);
+        materials.ClearDirty();
+        CHECK(materials.DirtyCount() == 0);
+        materials.Update(plain, desc);
+        CHECK(materials.FirstDirty() == plain);
+        CHECK(materials.DirtyCount() == 1);
+        CHECK(materials.Materials()[plain].baseColorTexture == 7);
+    }
+
+    TEST_CASE("Many materials share a handful of pipelines")
+    {
+        MaterialTable materials;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            MaterialDesc desc = Desc(static_cast<MaterialAlphaMode>(i % 3), i % 7 == 0);
+            desc.baseColorFactor = float4(float(i) / 1000.0f);
+            desc.baseColorTexture = i;
+            if (i % 3 == 1)
+            {
+                desc.emissiveTexture = i;
+            }
+            materials.Add(desc);
+        }
+        CHECK(materials.Count() == 1000);
+
+        uint32 used = 0;
+        uint32 total = 0;
+        for (uint32 pipeline = 0; pipeline < kMaterialPipelineCount; ++pipeline)
+        {
+            used += materials.PipelineUseCount(pipeline) > 0 ? 1 : 0;
+            total += materials.PipelineUseCount(pipeline);
+        }
+        CHECK(used == kMaterialPipelineCount);
+        CHECK(total == 1000);
+
+        CHECK(materials.MaterialPipeline(0) == 1);
+        CHECK(materials.MaterialPipeline(1) == 2);
+        CHECK(materials.MaterialPipeline(5) == 4);
+
+        // Only the masked materials have emissive textures, the other variants leave them out
+        CHECK(HasFlag(materials.VariantFeatures(MaterialAlphaMode::Mask),
+                      MaterialFeatures::EmissiveTexture));
+        CHECK_FALSE(HasFlag(materials.VariantFeatures(MaterialAlphaMode::Opaque),
+                            MaterialFeatures::EmissiveTexture));
+        CHECK(HasFlag(materials.VariantFeatures(MaterialAlphaMode::Opaque),
+                      MaterialFeatures::BaseColorTexture));
+
+        // Moving a material moves its count
+        materials.Update(0, Desc(MaterialAlphaMode::Opaque));
+        CHECK(materials.MaterialPipeline(0) == 0);
+        CHECK(materials.PipelineUseCount(0) + materials.PipelineUseCount(1) == 334);
+    }
+
+    TEST_CASE("Draws sort by pipeline and material, blending last and back to front")
+    {
+        MaterialTable materials;
+        const uint32 opaqueA = materials.Add(Desc(MaterialAlphaMode::Opaque));
+        const uint32 opaqueB = materials.Add(Desc(MaterialAlphaMode::Opaque));
+        const uint32 masked = materials.Add(Desc(MaterialAlphaMode::Mask, true));
+        const uint32 glass = materials.Add(Desc(MaterialAlphaMode::Blend));
+        const uint32 leaves = materials.Add(Desc(MaterialAlphaMode::Blend, true));
+
+        DynamicArray<MaterialDraw> draws;
+        const uint32 order[] = {glass, opaqueB, masked, leaves, opaqueA, opaqueB, glass, opaqueA};
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            draws.PushBack(MaterialDraw{order[i], float(i + 1), i});
+        }
+        // Behind the camera sorts as at it
+        draws.PushBack(MaterialDraw{opaqueA, -5.0f, 8});
+
+        const MaterialSortStats stats = materials.SortDraws(draws);
+
+        // Opaque A near to far, opaque B, masked, then the blended ones farthest first
+        const uint32 expected[] = {8, 4, 7, 1, 5, 2, 6, 3, 0};
+        REQUIRE(draws.Size() == 9);
+        for (uint32 i = 0; i < 9; ++i)
+        {
+            CHECK(draws[i].draw == expected[i]);
+        }
+        // Opaque, masked double-sided, blended, blended double-sided, blended
+        CHECK(stats.pipelineChanges == 5);
+        CHECK(stats.materialChanges == 6);
+    }
+
+    TEST_CASE("Pipeline state follows the alpha mode and sidedness")
+    {
+        const gaFormat targets[] = {gaFormat::R8G8B8A8Unorm, gaFormat::R16G16B16A16Float};
+        gaGraphicsPipelineDesc desc;
+        desc.renderTargetFormats = targets;
+        desc.depth.test = true;
+
+        ApplyMaterialPipelineState(5, desc);
+        CHECK(desc.raster.cull == gaCullMode::None);
+        CHECK(desc.blendModes.Size() == 2);
+        CHECK(desc.blendModes[1] == gaBlendMode::AlphaBlend);
+        CHECK_FALSE(desc.depth.write);
+
+        ApplyMaterialPipelineState(0, desc);
+        CHECK(desc.raster.cull == gaCullMode::Back);
+        CHECK(desc.blendModes.IsEmpty());
+        CHECK(desc.depth.write);
+    }
+}
@@ -0,0 +1,800 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-render-graph.h"
+
+#include <rsbl-dynamic-array.h>
+#include <rsbl-memory-tracking.h>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kNone = ~0u;
+constexpr uint64 kNotPlaced = ~0ull;
+
+struct Access
+{
+    uint32 resource;
+    gaResourceState state;
+    bool write;
+};
+
+struct Pass
+{
+    RenderPassFunction execute;
+    const char* name = nullptr;
+    DynamicArray<Access> accesses{GetTaggedAllocator(MemoryTag::Ga)};
+    bool keepAlive = false;
+    bool culled = false;
+    // The batch before it in State::barriers, [firstBarrier, endBarrier)
+    uint32 firstBarrier = 0;
+    uint32 endBarrier = 0;
+};
+
+// A transient made in an earlier frame, kept while it's being asked for again
+struct TransientEntry
+{
+    void* resource;
+    uint64 key;
+    uint64 size;
+    uint64 offset;
+    gaMemoryAllocation* memory; // The block it's placed in
+    gaResourceState state;      // What the last frame left it in
+    uint64 lastFrame;           // The device frame it was last used in
+    bool claimed;               // By a resource in the frame being compiled
+};
+
+struct FrameResource
+{
+    RenderImportDesc import;
+    RenderTransientDesc transient;
+    bool imported = false;
+
+    // Filled in by Compile
+    uint32 firstPass = kNone; // Kept passes, in the order they run
+    uint32 lastPass = kNone;
+    uint64 offset = kNotPlaced;
+    uint32 entry = kNone; // In State::entries
+};
+
+// A barrier and the batch it goes in: before kept pass slot, or after them all
+struct SlottedBarrier
+{
+    uint32 slot;
+    gaBarrier barrier;
+};
+
+// Blocks replaced by a bigger one, freed once the GPU is done with the frames that used them
+struct RetiredMemory
+{
+    gaMemoryAllocation* memory;
+    uint64 frame;
+};
+
+bool Overlaps(const FrameResource& a, const FrameResource& b)
+{
+    return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+}
+
+uint64 AlignUp(uint64 value, uint64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+struct RenderGraph::State
+{
+    gaDevice* device = nullptr;
+    gaMemoryAllocator* allocator = nullptr;
+    RenderTransientCreateFunction createTransient;
+    RenderTransientDestroyFunction destroyTransient;
+
+    // The frame being declared
+    DynamicArray<FrameResource> resources{GetTaggedAllocator(MemoryTag::Ga)};
+    DynamicArray<Pass> passes{GetTaggedAllocator(MemoryTag::Ga)};
+    bool compiled = false;
+
+    // The compiled frame
+    DynamicArray<uint32> keptPasses{GetTaggedAllocator(MemoryTag::Ga)};
+    DynamicArray<gaBarrier> barriers{GetTaggedAllocator(MemoryTag::Ga)};
+    uint32 firstFinalBarrier = 0;
+    RenderGraphStats stats;
+
+    // Transients and their memory, across frames
+    DynamicArray<TransientEntry> entries{GetTaggedAllocator(MemoryTag::Ga)};
+    gaMemoryAllocation* memory = nullptr;
+    DynamicArray<RetiredMemory> retired{GetTaggedAllocator(MemoryTag::Ga)};
+
+    // Walking back from the last pass, a pass is needed when it writes something a later needed
+    // pass reads, or something imported, whose contents outlive the frame
+    void Cull()
+    {
+        DynamicArray<bool> live(GetTaggedAllocator(MemoryTag::Ga));
+        live.Resize(resources.Size());
+        for (uint64 i = 0; i < resources.Size(); ++i)
+        {
+            live[i] = resources[i].imported;
+        }
+
+        for (uint64 p = passes.Size(); p > 0; --p)
+        {
+            Pass& pass = passes[p - 1];
+            bool needed = pass.keepAlive;
+            for (const Access& access : pass.accesses)
+            {
+                needed = needed || (access.write && live[access.resource]);
+            }
+
+            pass.culled = !needed;
+            if (pass.culled)
+            {
+                continue;
+            }
+
+            // What it writes, nothing before it needs to have; what it reads, something does
+            for (const Access& access : pass.accesses)
+            {
+                if (access.write)
+                {
+                    live[access.resource] = false;
+                }
+            }
+            for (const Access& access : pass.accesses)
+            {
+                if (!access.write)
+                {
+                    live[access.resource] = true;
+                }
+            }
+        }
+
+        for (uint32 p = 0; p < passes.Size(); ++p)
+        {
+            if (!passes[p].culled)
+            {
+                keptPasses.PushBack(p);
+            }
+        }
+    }
+
+    // Biggest first, each at the lowest offset clear of everything placed whose lifetime it
+    // overlaps. Returns the bytes the lot needs.
+    uint64 PlaceTransients(uint64& alignment)
+    {
+        DynamicArray<uint32> order(GetTaggedAllocator(MemoryTag::Ga));
+        for (uint32 i = 0; i < resources.Size(); ++i)
+        {
+            const FrameResource& resource = resources[i];
+            if (!resource.imported && resource.firstPass != kNone)
+            {
+                order.PushBack(i);
+            }
+        }
+        for (uint64 i = 1; i < order.Size(); ++i)
+        {
+            const uint32 index = order[i];
+            const uint64 size = resources[index].transient.size;
+            uint64 j = i;
+            for (; j > 0 && resources[order[j - 1]].transient.size < size; --j)
+            {
+                order[j] = order[j - 1];
+            }
+            order[j] = index;
+        }
+
+        uint64 total = 0;
+        alignment = 1;
+        for (uint64 i = 0; i < order.Size(); ++i)
+        {
+            FrameResource& resource = resources[order[i]];
+            const uint64 size = resource.transient.size;
+            const uint64 align = resource.transient.alignment;
+            alignment = align > alignment ? align : alignment;
+
+            // Candidates are the start, and the end of everything it can't share bytes with
+            uint64 best = kNotPlaced;
+            for (uint64 c = 0; c <= i; ++c)
+            {
+                uint64 candidate = 0;
+                if (c < i)
+                {
+                    const FrameResource& other = resources[order[c]];
+                    if (!Overlaps(resource, other))
+                    {
+                        continue;
+                    }
+                    candidate = AlignUp(other.offset + other.transient.size, align);
+                }
+
+                bool fits = candidate < best;
+                for (uint64 o = 0; o < i && fits; ++o)
+                {
+                    const FrameResource& other = resources[order[o]];
+                    fits = !Overlaps(resource, other) || candidate + size <= other.offset ||
+                           other.offset + other.transient.size <= candidate;
+                }
+                if (fits)
+                {
+                    best = candidate;
+                }
+            }
+
+            resource.offset = best;
+            total = best + size > total ? best + size : total;
+            stats.unaliasedBytes += size;
+        }
+        return total;
+    }
+
+    // A block big enough for this frame's transients. The one it replaces, and everything in it,
+    // goes once the frames using it are done.
+    Result<> ReserveMemory(uint64 size, uint64 alignment)
+    {
+        if (size == 0 || (memory != nullptr && memory->size >= size))
+        {
+            return ResultCode::Success;
+        }
+
+        auto allocated = GaAllocateMemory(allocator, gaMemoryType::DeviceLocal, size, alignment);
+        if (!allocated)
+        {
+            return PendingFailure{allocated.Category()};
+        }
+        if (memory != nullptr)
+        {
+            retired.PushBack({memory, device->frame});
+        }
+        memory = allocated.Value();
+        return ResultCode::Success;
+    }
+
+    // The entry kept from an earlier frame, or a new resource
+    Result<uint32> FindOrCreateEntry(const FrameResource& resource)
+    {
+        const RenderTransientDesc& desc = resource.transient;
+        for (uint32 i = 0; i < entries.Size(); ++i)
+        {
+            const TransientEntry& entry = entries[i];
+            if (!entry.claimed && entry.memory == memory && entry.key == desc.key &&
+                entry.size == desc.size && entry.offset == resource.offset)
+            {
+                entries[i].lastFrame = device->frame;
+                entries[i].claimed = true;
+                return i;
+            }
+        }
+
+        const gaMemoryAllocation placement{
+            memory->heap, memory->offset + resource.offset, desc.size};
+        Result<void*> created = createTransient(desc, placement);
+        if (!created)
+        {
+            return PendingFailure{created.Category()};
+        }
+        ++stats.transientsCreated;
+        entries.PushBack({created.Value(),
+                          desc.key,
+                          desc.size,
+                          resource.offset,
+                          memory,
+                          gaResourceState::Common,
+                          device->frame,
+                          true});
+        return static_cast<uint32>(entries.Size() - 1);
+    }
+
+    // Transients not asked for since the frames that could still be using them, and blocks
+    // nothing is placed in any more. Entries left keep their order, the frame's found again.
+    void ReleaseUnused()
+    {
+        const uint64 frame = device->frame;
+        DynamicArray<uint32> moved(GetTaggedAllocator(MemoryTag::Ga));
+        moved.Resize(entries.Size());
+        uint32 kept = 0;
+        for (uint32 i = 0; i < entries.Size(); ++i)
+        {
+            const TransientEntry& entry = entries[i];
+            if (!entry.claimed && entry.lastFrame + device->framesInFlight <= frame)
+            {
+                destroyTransient(entry.resource);
+                moved[i] = kNone;
+                continue;
+            }
+            moved[i] = kept;
+            entries[kept++] = entry;
+        }
+        while (entries.Size() > kept)
+        {
+            entries.PopBack();
+        }
+        for (FrameResource& resource : resources)
+        {
+            resource.entry = resource.entry != kNone ? moved[resource.entry] : kNone;
+        }
+
+        for (uint64 i = retired.Size(); i > 0; --i)
+        {
+            if (retired[i - 1].frame + device->framesInFlight > frame)
+            {
+                continue;
+            }
+
+            bool used = false;
+            for (const TransientEntry& entry : entries)
+            {
+                used = used || entry.memory == retired[i - 1].memory;
+            }
+            if (!used)
+            {
+                GaFreeMemory(allocator, retired[i - 1].memory);
+                retired[i - 1] = retired[retired.Size() - 1];
+                retired.PopBack();
+            }
+        }
+    }
+
+    gaBarrier MakeBarrier(const FrameResource& resource,
+                          gaResourceState before,
+                          gaResourceState after)
+    {
+        gaBarrier barrier{};
+        barrier.resource = resource.imported ? resource.import.resource
+                                             : entries[resource.entry].resource;
+        barrier.before = before;
+        barrier.after = after;
+        barrier.texture = resource.imported ? resource.import.texture : resource.transient.texture;
+        barrier.depth = resource.imported ? resource.import.depth : resource.transient.depth;
+        return barrier;
+    }
+
+    // A transition from after the last use to before the next, split when there are passes
+    // between. slot is the batch before kept pass slot, or the final batch.
+    void AddTransition(DynamicArray<SlottedBarrier>& out,
+                       gaBarrier barrier,
+                       uint32 lastUse,
+                       uint32 slot)
+    {
+        ++stats.barriers;
+        if (lastUse == kNone || lastUse + 1 >= slot)
+        {
+            out.PushBack({slot, barrier});
+            return;
+        }
+
+        ++stats.splitBarriers;
+        barrier.split = gaBarrierSplit::Begin;
+        out.PushBack({lastUse + 1, barrier});
+        barrier.split = gaBarrierSplit::End;
+        out.PushBack({slot, barrier});
+    }
+
+    // Walks the kept passes tracking each resource's state, then lays the barriers out a batch
+    // per pass
+    void PlanBarriers()
+    {
+        const uint32 keptCount = static_cast<uint32>(keptPasses.Size());
+
+        DynamicArray<gaResourceState> states(GetTaggedAllocator(MemoryTag::Ga));
+        DynamicArray<uint32> lastUse(GetTaggedAllocator(MemoryTag::Ga));
+        DynamicArray<bool> lastWrote(GetTaggedAllocator(MemoryTag::Ga));
+        states.Resize(resources.Size());
+        lastUse.Resize(resources.Size());
+        lastWrote.Resize(resources.Size());
+        for (uint64 i = 0; i < resources.Size(); ++i)
+        {
+            const FrameResource& resource = resources[i];
+            states[i] = resource.imported ? resource.import.state
+                        : resource.entry != kNone ? entries[resource.entry].state
+                                                  : gaResourceState::Common;
+            lastUse[i] = kNone;
+            lastWrote[i] = false;
+        }
+
+        DynamicArray<SlottedBarrier> planned(GetTaggedAllocator(MemoryTag::Ga));
+        for (uint32 slot = 0; slot < keptCount; ++slot)
+        {
+            const Pass& pass = passes[keptPasses[slot]];
+            for (uint64 a = 0; a < pass.accesses.Size(); ++a)
+            {
+                const Access& access = pass.accesses[a];
+
+                // Once per resource per pass, writing if any of its accesses does
+                bool seen = false;
+                bool write = false;
+                for (uint64 b = 0; b < pass.accesses.Size(); ++b)
+                {
+                    seen = seen || (b < a && pass.accesses[b].resource == access.resource);
+                    write = write || (pass.accesses[b].resource == access.resource &&
+                                      pass.accesses[b].write);
+                }
+                if (seen)
+                {
+                    continue;
+                }
+
+                const uint32 r = access.resource;
+                const FrameResource& resource = resources[r];
+                gaBarrier barrier = MakeBarrier(resource, states[r], access.state);
+                if (!resource.imported && resource.firstPass == slot)
+                {
+                    // Whatever else was in its memory, its contents start undefined
+                    barrier.discard = true;
+                    ++stats.barriers;
+                    planned.PushBack({slot, barrier});
+                }
+                else if (states[r] != access.state)
+                {
+                    AddTransition(planned, barrier, lastUse[r], slot);
+                }
+                else if (access.state == gaResourceState::UnorderedAccess &&
+                         (write || lastWrote[r]))
+                {
+                    ++stats.barriers;
+                    planned.PushBack({slot, barrier});
+                }
+
+                states[r] = access.state;
+                lastUse[r] = slot;
+                lastWrote[r] = write;
+            }
+        }
+
+        for (uint32 r = 0; r < resources.Size(); ++r)
+        {
+            const FrameResource& resource = resources[r];
+            if (resource.imported && states[r] != resource.import.finalState)
+            {
+                AddTransition(planned,
+                              MakeBarrier(resource, states[r], resource.import.finalState),
+                              lastUse[r],
+                              keptCount);
+            }
+            else if (!resource.imported && resource.entry != kNone)
+            {
+                entries[resource.entry].state = states[r];
+            }
+        }
+
+        // Batches in slot order, each in the order planned
+        DynamicArray<uint32> slotStarts(GetTaggedAllocator(MemoryTag::Ga));
+        slotStarts.Resize(keptCount + 2);
+        for (uint32& start : slotStarts)
+        {
+            start = 0;
+        }
+        for (const SlottedBarrier& slotted : planned)
+        {
+            ++slotStarts[slotted.slot + 2];
+        }
+        for (uint32 s = 2; s < slotStarts.Size(); ++s)
+        {
+            slotStarts[s] += slotStarts[s - 1];
+        }
+
+        barriers.Resize(planned.Size());
+        for (const SlottedBarrier& slotted : planned)
+        {
+            barriers[slotStarts[slotted.slot + 1]++] = slotted.barrier;
+        }
+
+        for (uint32 slot = 0; slot < keptCount; ++slot)
+        {
+            Pass& pass = passes[keptPasses[slot]];
+            pass.firstBarrier = slotStarts[slot];
+            pass.endBarrier = slotStarts[slot + 1];
+            stats.barrierBatches += pass.endBarrier > pass.firstBarrier ? 1 : 0;
+        }
+        firstFinalBarrier = slotStarts[keptCount];
+        stats.barrierBatches += barriers.Size() > firstFinalBarrier ? 1 : 0;
+    }
+
+    void FreeAll()
+    {
+        for (const TransientEntry& entry : entries)
+        {
+            destroyTransient(entry.resource);
+        }
+        entries.Clear();
+        for (const RetiredMemory& block : retired)
+        {
+            GaFreeMemory(allocator, block.memory);
+        }
+        retired.Clear();
+        if (memory != nullptr)
+        {
+            GaFreeMemory(allocator, memory);
+            memory = nullptr;
+        }
+    }
+};
+
+RenderPassBuilder& RenderPassBuilder::Read(RenderResource resource, gaResourceState state)
+{
+    m_graph->AddAccess(m_pass, resource, state, false);
+    return *this;
+}
+
+RenderPassBuilder& RenderPassBuilder::Write(RenderResource resource, gaResourceState state)
+{
+    m_graph->AddAccess(m_pass, resource, state, true);
+    return *this;
+}
+
+RenderPassBuilder& RenderPassBuilder::KeepAlive()
+{
+    m_graph->m_state->passes[m_pass].keepAlive = true;
+    return *this;
+}
+
+Result<UniquePtr<RenderGraph>> RenderGraph::Create(RenderGraphCreateInfo&& createInfo)
+{
+    if (createInfo.device == nullptr || createInfo.allocator == nullptr)
+    {
+        return {ErrorCategory::InvalidArgument, "Render graphs need a device and an allocator"};
+    }
+
+    if (!createInfo.createTransient || !createInfo.destroyTransient)
+    {
+        return {ErrorCategory::InvalidArgument,
+                "Render graphs need functions to create and destroy transients with"};
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+
+    UniquePtr<RenderGraph> graph(new RenderGraph());
+    graph->m_state = new State();
+    State& state = *graph->m_state;
+    state.device = createInfo.device;
+    state.allocator = createInfo.allocator;
+    state.createTransient = rsblMove(createInfo.createTransient);
+    state.destroyTransient = rsblMove(createInfo.destroyTransient);
+    return graph;
+}
+
+RenderGraph::~RenderGraph()
+{
+    if (m_state != nullptr)
+    {
+        m_state->FreeAll();
+    }
+    delete m_state;
+}
+
+void RenderGraph::Reset()
+{
+    m_state->resources.Clear();
+    m_state->passes.Clear();
+    m_state->keptPasses.Clear();
+    m_state->barriers.Clear();
+    m_state->firstFinalBarrier = 0;
+    m_state->compiled = false;
+}
+
+RenderResource RenderGraph::Import(const RenderImportDesc& desc)
+{
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    FrameResource resource;
+    resource.import = desc;
+    resource.imported = true;
+    m_state->resources.PushBack(resource);
+    m_state->compiled = false;
+    return {static_cast<uint32>(m_state->resources.Size() - 1)};
+}
+
+RenderResource RenderGraph::CreateTransient(const RenderTransientDesc& desc)
+{
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    FrameResource resource;
+    resource.transient = desc;
+    m_state->resources.PushBack(resource);
+    m_state->compiled = false;
+    return {static_cast<uint32>(m_state->resources.Size() - 1)};
+}
+
+RenderPassBuilder RenderGraph::AddPass(RenderPassFunction&& execute, const char* name)
+{
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    Pass pass;
+    pass.execute = rsblMove(execute);
+    pass.name = name;
+    m_state->passes.PushBack(rsblMove(pass));
+    m_state->compiled = false;
+    return RenderPassBuilder(this, static_cast<uint32>(m_state->passes.Size() - 1));
+}
+
+void RenderGraph::AddAccess(uint32 pass, RenderResource resource, gaResourceState state, bool write)
+{
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    m_state->passes[pass].accesses.PushBack({resource.index, state, write});
+    m_state->compiled = false;
+}
+
+Result<> RenderGraph::Compile()
+{
+    State& state = *m_state;
+    if (state.device->frame == 0)
+    {
+        return "GaBeginFrame must be called before compiling";
+    }
+
+    for (const Pass& pass : state.passes)
+    {
+        for (const Access& access : pass.accesses)
+        {
+            if (access.resource >= state.resources.Size() ||
+                access.state >= gaResourceState::Count)
+            {
+                return {ErrorCategory::InvalidArgument, "A pass uses a resource not in the frame"};
+            }
+            for (const Access& other : pass.accesses)
+            {
+                if (other.resource == access.resource && other.state != access.state)
+                {
+                    return {ErrorCategory::InvalidArgument,
+                            "A pass uses a resource in two different states"};
+                }
+            }
+        }
+    }
+
+    for (const FrameResource& resource : state.resources)
+    {
+        const uint64 alignment = resource.transient.alignment;
+        if (!resource.imported &&
+            (resource.transient.size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0))
+        {
+            return {ErrorCategory::InvalidArgument,
+                    "Transients need a size, and a power of two alignment"};
+        }
+    }
+
+    MemoryTagScope memoryScope(MemoryTag::Ga);
+    state.keptPasses.Clear();
+    state.barriers.Clear();
+    state.stats = {};
+    state.stats.passes = static_cast<uint32>(state.passes.Size());
+
+    state.Cull();
+    state.stats.culledPasses = state.stats.passes - static_cast<uint32>(state.keptPasses.Size());
+
+    for (FrameResource& resource : state.resources)
+    {
+        resource.firstPass = kNone;
+        resource.lastPass = kNone;
+        resource.offset = kNotPlaced;
+        resource.entry = kNone;
+    }
+    for (uint32 slot = 0; slot < state.keptPasses.Size(); ++slot)
+    {
+        for (const Access& access : state.passes[state.keptPasses[slot]].accesses)
+        {
+            FrameResource& resource = state.resources[access.resource];
+            resource.firstPass = resource.firstPass == kNone ? slot : resource.firstPass;
+            resource.lastPass = slot;
+        }
+    }
+
+    for (TransientEntry& entry : state.entries)
+    {
+        entry.claimed = false;
+    }
+
+    uint64 alignment = 1;
+    const uint64 bytes = state.PlaceTransients(alignment);
+    state.stats.transientBytes = bytes;
+    if (Result<> reserved = state.ReserveMemory(bytes, alignment); !reserved)
+    {
+        return reserved;
+    }
+
+    for (FrameResource& resource : state.resources)
+    {
+        if (resource.imported || resource.offset == kNotPlaced)
+        {
+            continue;
+        }
+        Result<uint32> entry = state.FindOrCreateEntry(resource);
+        if (!entry)
+        {
+            return PendingFailure{entry.Category()};
+        }
+        resource.entry = entry.Value();
+        ++state.stats.transients;
+    }
+
+    state.PlanBarriers();
+    state.ReleaseUnused();
+
+    state.compiled = true;
+    return ResultCode::Success;
+}
+
+Result<> RenderGraph::Execute(gaCommandList* list)
+{
+    if (list == nullptr)
+    {
+        return "Command list cannot be null";
+    }
+
+    if (!m_state->compiled)
+    {
+        return "The render graph must be compiled after the last change to it";
+    }
+
+    const State& state = *m_state;
+    const RenderPassContext context{list, this};
+    for (uint32 p : state.keptPasses)
+    {
+        const Pass& pass = state.passes[p];
+        const uint32 zone = pass.name != nullptr ? GaBeginGpuZone(list, pass.name) : kGaNoGpuZone;
+        if (auto recorded = GaCmdBarriers(list, BarriersBefore(p)); !recorded)
+        {
+            GaEndGpuZone(list, zone);
+            return recorded;
+        }
+        pass.execute(context);
+        GaEndGpuZone(list, zone);
+    }
+    return GaCmdBarriers(list, FinalBarriers());
+}
+
+void* RenderGraph::Resource(RenderResource resource) const
+{
+    if (resource.index >= m_state->resources.Size())
+    {
+        return nullptr;
+    }
+
+    const FrameResource& frameResource = m_state->resources[resource.index];
+    if (frameResource.imported)
+    {
+        return frameResource.import.resource;
+    }
+    return frameResource.entry != kNone ? m_state->entries[frameResource.entry].resource
+                                        : nullptr;
+}
+
+uint64 RenderGraph::TransientOffset(RenderResource resource) const
+{
+    if (resource.index >= m_state->resources.Size())
+    {
+        return kNotPlaced;
+    }
+    return m_state->resources[resource.index].offset;
+}
+
+ArrayView<const gaBarrier> RenderGraph::BarriersBefore(uint32 pass) const
+{
+    if (!m_state->compiled || pass >= m_state->passes.Size() || m_state->passes[pass].culled)
+    {
+        return {};
+    }
+
+    const Pass& compiled = m_state->passes[pass];
+    return ArrayView<const gaBarrier>(m_state->barriers.Data() + compiled.firstBarrier,
+                                      compiled.endBarrier - compiled.firstBarrier);
+}
+
+ArrayView<const gaBarrier> RenderGraph::FinalBarriers() const
+{
+    if (!m_state->compiled)
+    {
+        return {};
+    }
+    return ArrayView<const gaBarrier>(m_state->barriers.Data() + m_state->firstFinalBarrier,
+                                      m_state->barriers.Size() - m_state->firstFinalBarrier);
+}
+
+bool RenderGraph::IsCulled(uint32 pass) const
+{
+    return pass < m_state->passes.Size() && m_state->passes[pass].culled;
+}
+
+RenderGraphStats RenderGraph::Stats() const
+{
+    return m_state->stats;
+}
+
+} // namespace rsbl
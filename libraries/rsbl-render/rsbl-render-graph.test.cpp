@@ -0,0 +1,377 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-render-graph.h"
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint64 kMiB = 1024 * 1024;
+
+// Transients are counters with the placement they were made with, nothing the null backend reads
+struct FakeTransient
+{
+    uint64 offset;
+    uint64 size;
+};
+
+int g_created = 0;
+int g_destroyed = 0;
+
+Result<void*> CreateFake(const RenderTransientDesc& desc, const gaMemoryAllocation& memory)
+{
+    ++g_created;
+    return static_cast<void*>(new FakeTransient{memory.offset, desc.size});
+}
+
+void DestroyFake(void* resource)
+{
+    ++g_destroyed;
+    delete static_cast<FakeTransient*>(resource);
+}
+
+void Nothing(const RenderPassContext&)
+{
+}
+
+struct Fixture
+{
+    gaDevice* device = nullptr;
+    gaMemoryAllocator* allocator = nullptr;
+    UniquePtr<RenderGraph> graph;
+
+    Fixture()
+    {
+        g_created = 0;
+        g_destroyed = 0;
+        device = GaCreateDevice({}).Value();
+        allocator = GaCreateMemoryAllocator({device}).Value();
+        auto created = RenderGraph::Create({device, allocator, &CreateFake, &DestroyFake});
+        REQUIRE(created);
+        graph = rsblMove(created.Value());
+        REQUIRE(GaBeginFrame(device));
+    }
+
+    ~Fixture()
+    {
+        graph = {};
+        GaDestroyMemoryAllocator(allocator);
+        GaDestroyDevice(device);
+    }
+};
+
+int g_image = 0;
+void* const kBackBuffer = &g_image;
+} // namespace
+
+TEST_SUITE("rsbl::RenderGraph")
+{
+    TEST_CASE("Passes nothing reads are culled and the rest run in order")
+    {
+        Fixture fixture;
+        RenderGraph& graph = *fixture.graph;
+
+        static int order[4];
+        static int ran;
+        ran = 0;
+
+        RenderResource back_buffer = graph.Import(
+            {kBackBuffer, gaResourceState::Present, gaResourceState::Present});
+        RenderResource scene = graph.CreateTransient({4 * kMiB});
+        RenderResource unused = graph.CreateTransient({4 * kMiB});
+
+        graph.AddPass([](const RenderPassContext&) { order[ran++] = 0; })
+            .Write(scene, gaResourceState::ColorTarget);
+        graph.AddPass([](const RenderPassContext&) { order[ran++] = 1; })
+            .Write(unused, gaResourceState::ColorTarget);
+        graph.AddPass([](const RenderPassContext&) { order[ran++] = 2; })
+            .Read(scene, gaResourceState::ShaderRead)
+            .Write(back_buffer, gaResourceState::ColorTarget);
+        graph.AddPass([](const RenderPassContext&) { order[ran++] = 3; }).KeepAlive();
+
+        REQUIRE(graph.Compile());
+        CHECK(!graph.IsCulled(0));
+        CHECK(graph.IsCulled(1));
+        CHECK(!graph.IsCulled(2));
+        CHECK(!graph.IsCulled(3));
+        CHECK(graph.Stats().passes == 4);
+        CHECK(graph.Stats().culledPasses == 1);
+        CHECK(graph.Stats().transients == 1);
+        CHECK(graph.Resource(unused) == nullptr);
+        CHECK(graph.Resource(scene) != nullptr);
+        CHECK(graph.Resource(back_buffer) == kBackBuffer);
+
+        auto list = GaBeginCommandList(fixture.device, gaQueueType::Graphics, 0);
+        REQUIRE(list);
+        REQUIRE(graph.Execute(list.Value()));
+        REQUIRE(ran == 3);
+        CHECK(order[0] == 0);
+        CHECK(order[1] == 2);
+        CHECK(order[2] == 3);
+        CHECK(GaEndCommandList(list.Value()));
+    }
+
+    TEST_CASE("Imports transition into the passes' states and back to their final state")
+    {
+        Fixture fixture;
+        RenderGraph& graph = *fixture.graph;
+
+        RenderResource back_buffer = graph.Import(
+            {kBackBuffer, gaResourceState::Present, gaResourceState::Present});
+        graph.AddPass(&Nothing).Write(back_buffer, gaResourceState::ColorTarget);
+        REQUIRE(graph.Compile());
+
+        ArrayView<const gaBarrier> before = graph.BarriersBefore(0);
+        REQUIRE(before.Size() == 1);
+        CHECK(before[0].resource == kBackBuffer);
+        CHECK(before[0].before == gaResourceState::Present);
+        CHECK(before[0].after == gaResourceState::ColorTarget);
+        CHECK(before[0].split == gaBarrierSplit::None);
+        CHECK(!before[0].discard);
+
+        ArrayView<const gaBarrier> after = graph.FinalBarriers();
+        REQUIRE(after.Size() == 1);
+        CHECK(after[0].before == gaResourceState::ColorTarget);
+        CHECK(after[0].after == gaResourceState::Present);
+        CHECK(graph.Stats().barriers == 2);
+        CHECK(graph.Stats().barrierBatches == 2);
+    }
+
+    TEST_CASE("A transient's first use discards, and later uses in the same state need nothing")
+    {
+        Fixture fixture;
+        RenderGraph& graph = *fixture.graph;
+
+        RenderResource depth = graph.CreateTransient({8 * kMiB, 64 * 1024, true, true});
+        graph.AddPass(&Nothing).Write(depth, gaResourceState::DepthWrite);
+        graph.AddPass(&Nothing)
+            .Read(depth, gaResourceState::DepthWrite)
+            .Write(depth, gaResourceState::DepthWrite);
+        graph.AddPass(&Nothing).Read(depth, gaResourceState::DepthRead).KeepAlive();
+        REQUIRE(graph.Compile());
+
+        ArrayView<const gaBarrier> first = graph.BarriersBefore(0);
+        REQUIRE(first.Size() == 1);
+        CHECK(first[0].discard);
+        CHECK(first[0].depth);
+        CHECK(first[0].before == gaResourceState::Common);
+        CHECK(first[0].after == gaResourceState::DepthWrite);
+        CHECK(graph.BarriersBefore(1).IsEmpty());
+
+        ArrayView<const gaBarrier> read = graph.BarriersBefore(2);
+        REQUIRE(read.Size() == 1);
+        CHECK(!read[0].discard);
+        CHECK(read[0].before == gaResourceState::DepthWrite);
+        CHECK(read[0].after == gaResourceState::DepthRead);
+        CHECK(graph.FinalBarriers().IsEmpty());
+    }
+
+    TEST_CASE("Transitions with passes between uses are split across them")
+    {
+        Fixture fixture;
+        RenderGraph& graph = *fixture.graph;
+
+        RenderResource shadow = graph.CreateTransient({4 * kMiB, 64 * 1024, true, true});
+        RenderResource other = graph.CreateTransient({4 * kMiB});
+        graph.AddPass(&Nothing).Write(shadow, gaResourceState::DepthWrite);
+        graph.AddPass(&Nothing).Write(other, gaResourceState::ColorTarget);
+        graph.AddPass(&Nothing).Read(other, gaResourceState::ShaderRead).KeepAlive();
+        graph.AddPass(&Nothing).Read(shadow, gaResourceState::ShaderRead).KeepAlive();
+        REQUIRE(graph.Compile());
+
+        // Begun once the shadow pass is done, ended before the pass reading it
+        ArrayView<const gaBarrier> begin = graph.BarriersBefore(1);
+        REQUIRE(begin.Size() == 2);
+        CHECK(begin[0].resource == graph.Resource(other));
+        CHECK(begin[0].discard);
+        CHECK(begin[1].resource == graph.Resource(shadow));
+        CHECK(begin[1].split == gaBarrierSplit::Begin);
+        CHECK(begin[1].before == gaResourceState::DepthWrite);
+        CHECK(begin[1].after == gaResourceState::ShaderRead);
+
+        ArrayView<const gaBarrier> adjacent = graph.BarriersBefore(2);
+        REQUIRE(adjacent.Size() == 1);
+        CHECK(adjacent[0].split == gaBarrierSplit::None);
+
+        ArrayView<const gaBarrier> end = graph.BarriersBefore(3);
+        REQUIRE(end.Size() == 1);
+        CHECK(end[0].split == gaBarrierSplit::End);
+        CHECK(end[0].before == gaResourceState::DepthWrite);
+        CHECK(end[0].after == gaResourceState::ShaderRead);
+        CHECK(graph.Stats().splitBarriers == 1);
+        CHECK(graph.Stats().barriers == 4);
+
+        auto list = GaBeginCommandList(fixture.device, gaQueueType::Graphics, 0);
+        REQUIRE(list);
+        CHECK(graph.Execute(list.Value()));
+        CHECK(GaEndCommandList(list.Value()));
+    }
+
+    TEST_CASE("Unordered access between passes gets a barrier only around writes")
+    {
+        Fixture fixture;
+        RenderGraph& graph = *fixture.graph;
+
+        RenderResource buffer = graph.CreateTransient({kMiB, 64 * 1024, false});
+        graph.AddPass(&Nothing).Write(buffer, gaResourceState::UnorderedAccess);
+        graph.AddPass(&Nothing)
+            .Read(buffer, gaResourceState::UnorderedAccess)
+            .Write(buffer, gaResourceState::UnorderedAccess);
+        graph.AddPass(&Nothing).Read(buffer, gaResourceState::UnorderedAccess).KeepAlive();
+        graph.AddPass(&Nothing).Read(buffer, gaResourceState::UnorderedAccess).KeepAlive();
+        REQUIRE(graph.Compile());
+
+        CHECK(graph.BarriersBefore(0).Size() == 1);
+        REQUIRE(graph.BarriersBefore(1).Size() == 1);
+        CHECK(!graph.BarriersBefore(1)[0].texture);
+        CHECK(graph.BarriersBefore(1)[0].before == gaResourceState::UnorderedAccess);
+        CHECK(graph.BarriersBefore(1)[0].after == gaResourceState::UnorderedAccess);
+        CHECK(graph.BarriersBefore(2).Size() == 1);
+        CHECK(graph.BarriersBefore(3).IsEmpty());
+    }
+
+    TEST_CASE("Transients with disjoint lifetimes share memory")
+    {
+        Fixture fixture;
+        RenderGraph& graph = *fixture.graph;
+
+        RenderResource back_buffer = graph.Import(
+            {kBackBuffer, gaResourceState::ColorTarget, gaResourceState::ColorTarget});
+        RenderResource a = graph.CreateTransient({8 * kMiB});
+        RenderResource b = graph.CreateTransient({4 * kMiB});
+        RenderResource c = graph.CreateTransient({6 * kMiB});
+
+        // a lives over passes 0-1, b over 1-2, c over 2-3: a and c can share
+        graph.AddPass(&Nothing).Write(a, gaResourceState::ColorTarget);
+        graph.AddPass(&Nothing)
+            .Read(a, gaResourceState::ShaderRead)
+            .Write(b, gaResourceState::ColorTarget);
+        graph.AddPass(&Nothing)
+            .Read(b, gaResourceState::ShaderRead)
+            .Write(c, gaResourceState::ColorTarget);
+        graph.AddPass(&Nothing)
+            .Read(c, gaResourceState::ShaderRead)
+            .Write(back_buffer, gaResourceState::ColorTarget);
+        REQUIRE(graph.Compile());
+
+        CHECK(graph.TransientOffset(a) == 0);
+        CHECK(graph.TransientOffset(c) == 0);
+        CHECK(graph.TransientOffset(b) == 8 * kMiB);
+        CHECK(graph.Stats().transientBytes == 12 * kMiB);
+        CHECK(graph.Stats().unaliasedBytes == 18 * kMiB);
+        CHECK(static_cast<FakeTransient*>(graph.Resource(c))->offset ==
+              static_cast<FakeTransient*>(graph.Resource(a))->offset);
+
+        // c reuses a's bytes, so its first use discards them
+        REQUIRE(graph.BarriersBefore(2).Size() == 2);
+        CHECK(graph.BarriersBefore(2)[1].discard);
+    }
+
+    TEST_CASE("Transients are kept across frames and destroyed once nothing asks for them")
+    {
+        Fixture fixture;
+        RenderGraph& graph = *fixture.graph;
+
+        const auto declare = [&graph](uint64 key) {
+            graph.Reset();
+            RenderResource target = graph.CreateTransient({4 * kMiB, 64 * 1024, true, false, key});
+            graph.AddPass(&Nothing).Write(target, gaResourceState::ColorTarget).KeepAlive();
+            return target;
+        };
+
+        RenderResource first = declare(1);
+        REQUIRE(graph.Compile());
+        CHECK(graph.Stats().transientsCreated == 1);
+        void* const resource = graph.Resource(first);
+
+        // The next frame leaves it in ColorTarget, where the discard starts from
+        REQUIRE(GaBeginFrame(fixture.device));
+        RenderResource second = declare(1);
+        REQUIRE(graph.Compile());
+        CHECK(graph.Stats().transientsCreated == 0);
+        CHECK(graph.Resource(second) == resource);
+        REQUIRE(graph.BarriersBefore(0).Size() == 1);
+        CHECK(graph.BarriersBefore(0)[0].before == gaResourceState::ColorTarget);
+
+        // Another key makes another, the old one goes once the frames in flight are done
+        for (uint32 frame = 0; frame < fixture.device->framesInFlight; ++frame)
+        {
+            REQUIRE(GaBeginFrame(fixture.device));
+            declare(2);
+            REQUIRE(graph.Compile());
+        }
+        CHECK(g_created == 2);
+        CHECK(g_destroyed == 1);
+
+        fixture.graph = {};
+        CHECK(g_destroyed == 2);
+    }
+
+    TEST_CASE("A pass using a resource in two states is rejected")
+    {
+        Fixture fixture;
+        RenderGraph& graph = *fixture.graph;
+
+        RenderResource target = graph.CreateTransient({kMiB});
+        graph.AddPass(&Nothing)
+            .Read(target, gaResourceState::ShaderRead)
+            .Write(target, gaResourceState::ColorTarget)
+            .KeepAlive();
+        auto compiled = graph.Compile();
+        REQUIRE(!compiled);
+        CHECK(compiled.Category() == ErrorCategory::InvalidArgument);
+
+        auto list = GaBeginCommandList(fixture.device, gaQueueType::Graphics, 0);
+        REQUIRE(list);
+        CHECK(!graph.Execute(list.Value()));
+        CHECK(GaEndCommandList(list.Value()));
+    }
+
+    TEST_CASE("Named passes that run are GPU zones, read back once their frame is done")
+    {
+        Fixture fixture;
+        RenderGraph& graph = *fixture.graph;
+        auto profiler = GaCreateGpuProfiler({fixture.device});
+        REQUIRE(profiler);
+
+        for (uint32 frame = 0; frame <= fixture.device->framesInFlight; ++frame)
+        {
+            if (frame > 0)
+            {
+                REQUIRE(GaBeginFrame(fixture.device));
+            }
+            REQUIRE(GaBeginGpuProfilerFrame(profiler.Value()));
+
+            graph.Reset();
+            RenderResource unused = graph.CreateTransient({kMiB});
+            graph.AddPass(&Nothing, "Shadows").KeepAlive();
+            graph.AddPass(&Nothing, "Unused").Write(unused, gaResourceState::ColorTarget);
+            graph.AddPass(&Nothing).KeepAlive();
+            graph.AddPass(&Nothing, "Lighting").KeepAlive();
+            REQUIRE(graph.Compile());
+
+            auto list = GaBeginCommandList(fixture.device, gaQueueType::Graphics, 0);
+            REQUIRE(list);
+            REQUIRE(graph.Execute(list.Value()));
+            REQUIRE(GaCmdResolveGpuZones(list.Value()));
+            REQUIRE(GaEndCommandList(list.Value()));
+        }
+
+        // The first frame's, the only one done with
+        const gaGpuProfiler& read = *profiler.Value();
+        CHECK(read.zoneFrame == fixture.device->frame - fixture.device->framesInFlight);
+        CHECK(!read.uncalibrated);
+        REQUIRE(read.zoneCount == 2);
+        CHECK(read.zones[0].name == doctest::String("Shadows"));
+        CHECK(read.zones[1].name == doctest::String("Lighting"));
+        CHECK(read.zones[0].depth == 0);
+        CHECK(read.zones[1].depth == 0);
+
+        GaDestroyGpuProfiler(profiler.Value());
+        CHECK(fixture.device->gpuProfiler == nullptr);
+    }
+}
@@ -0,0 +1,403 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-shadow-map.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-sort.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+// The light counts as turned past about a quarter of a degree
+constexpr float kTurnedCosine = 0.99999f;
+
+float Dot(float3 a, float3 b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+float3 Cross(float3 a, float3 b)
+{
+    return float3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+float3 Normalize(float3 v)
+{
+    const float length = sqrtf(Dot(v, v));
+    return length > 0.0f ? float3(v.x / length, v.y / length, v.z / length) : v;
+}
+
+// Level, then x and y as 29 bit two's complement
+uint64 PackKey(const ShadowPageKey& key)
+{
+    constexpr uint64 kMask = (uint64(1) << 29) - 1;
+    return (uint64(key.level) << 58) | ((uint64(uint32(key.x)) & kMask) << 29) |
+           (uint64(uint32(key.y)) & kMask);
+}
+
+int32 PageOf(float coordinate, float pageSize)
+{
+    return static_cast<int32>(floorf(coordinate / pageSize));
+}
+
+// The pages of a level's grid a light-space footprint (min x, min y, max x, max y) overlaps
+bool FootprintPages(const float4& footprint,
+                    const ShadowLevel& grid,
+                    uint32 pagesPerSide,
+                    int32& x0,
+                    int32& y0,
+                    int32& x1,
+                    int32& y1)
+{
+    const int32 last = static_cast<int32>(pagesPerSide) - 1;
+    x0 = PageOf(footprint.x, grid.pageSize);
+    y0 = PageOf(footprint.y, grid.pageSize);
+    x1 = PageOf(footprint.z, grid.pageSize);
+    y1 = PageOf(footprint.w, grid.pageSize);
+    x0 = x0 > grid.firstPageX ? x0 : grid.firstPageX;
+    y0 = y0 > grid.firstPageY ? y0 : grid.firstPageY;
+    x1 = x1 < grid.firstPageX + last ? x1 : grid.firstPageX + last;
+    y1 = y1 < grid.firstPageY + last ? y1 : grid.firstPageY + last;
+    return x0 <= x1 && y0 <= y1;
+}
+} // namespace
+
+Result<> VirtualShadowMap::Init(const ShadowMapDesc& desc)
+{
+    if (desc.levelCount == 0 || desc.levelCount > kMaxShadowLevels ||
+        !IsPowerOfTwo(desc.pagesPerSide) || desc.pagesPerSide > 256 ||
+        !(desc.firstLevelSize > 0.0f) || !(desc.depthRange > 0.0f) ||
+        desc.physicalPageCount == 0)
+    {
+        return {ErrorCategory::InvalidArgument, "Shadow map desc is out of range"};
+    }
+
+    m_desc = desc;
+    m_lightDirection = float3(0.0f);
+    m_lightView = simd::Identity4x4();
+    m_frame = 0;
+
+    const uint64 tableSize = uint64(desc.levelCount) * desc.pagesPerSide * desc.pagesPerSide;
+    m_pageTable.Resize(tableSize);
+    m_needed.Resize(tableSize);
+    m_dynamic.Resize(tableSize);
+    for (uint32& entry : m_pageTable)
+    {
+        entry = kNoShadowPage;
+    }
+    m_physicalPages.Clear();
+    m_physicalPages.Resize(desc.physicalPageCount);
+    DropAllPages();
+    m_dynamicCasters.Clear();
+    m_updates.Clear();
+    m_stats = {};
+    return ResultCode::Success;
+}
+
+void VirtualShadowMap::DropAllPages()
+{
+    m_cached.Clear();
+    m_freePages.Clear();
+    // Handed out from the back, so page 0 first
+    for (uint32 i = static_cast<uint32>(m_physicalPages.Size()); i > 0; --i)
+    {
+        m_physicalPages[i - 1] = PhysicalPage{};
+        m_freePages.PushBack(i - 1);
+    }
+}
+
+void VirtualShadowMap::BeginFrame(float3 lightDirection, float3 cameraPosition)
+{
+    rsblAssertMsg(!m_physicalPages.IsEmpty(), "Init the shadow map first");
+
+    const float3 z = Normalize(lightDirection);
+    bool drop = false;
+    if (Dot(z, m_lightDirection) < kTurnedCosine)
+    {
+        // Any axis across the light will do, as long as it only changes with the light
+        const float3 up = fabsf(z.y) < 0.99f ? float3(0.0f, 1.0f, 0.0f) : float3(1.0f, 0.0f, 0.0f);
+        const float3 x = Normalize(Cross(up, z));
+        const float3 y = Cross(z, x);
+        m_lightView = simd::float4x4(simd::float4(x.x, y.x, z.x, 0.0f),
+                                     simd::float4(x.y, y.y, z.y, 0.0f),
+                                     simd::float4(x.z, y.z, z.z, 0.0f),
+                                     simd::float4(0.0f, 0.0f, 0.0f, 1.0f));
+        m_lightDirection = z;
+        drop = true;
+    }
+
+    const simd::float4 camera = simd::TransformPoint(
+        m_lightView, simd::float4(cameraPosition.x, cameraPosition.y, cameraPosition.z, 1.0f));
+    m_camera = cameraPosition;
+    m_lightCamera = float3(camera.X(), camera.Y(), camera.Z());
+    const float depthStep = m_desc.depthRange * 0.25f;
+    const float depthCenter = roundf(m_lightCamera.z / depthStep) * depthStep;
+    if (depthCenter != m_depthCenter)
+    {
+        m_depthCenter = depthCenter;
+        drop = true;
+    }
+    if (drop)
+    {
+        DropAllPages();
+    }
+
+    const int32 half = static_cast<int32>(m_desc.pagesPerSide / 2);
+    for (uint32 level = 0; level < m_desc.levelCount; ++level)
+    {
+        ShadowLevel& grid = m_levels[level];
+        grid.pageSize = m_desc.firstLevelSize * static_cast<float>(1u << level) /
+                        static_cast<float>(m_desc.pagesPerSide);
+        grid.firstPageX = PageOf(m_lightCamera.x, grid.pageSize) - half;
+        grid.firstPageY = PageOf(m_lightCamera.y, grid.pageSize) - half;
+    }
+
+    ++m_frame;
+    memset(m_needed.Data(), 0, m_needed.Size());
+    memset(m_dynamic.Data(), 0, m_dynamic.Size());
+    m_dynamicCasters.Clear();
+    m_updates.Clear();
+    m_evictableBuilt = false;
+    m_stats = {};
+}
+
+float4 VirtualShadowMap::Footprint(const Aabb& bounds) const
+{
+    const Aabb box = TransformAabb(bounds, m_lightView);
+    return float4(box.min.x, box.min.y, box.max.x, box.max.y);
+}
+
+void VirtualShadowMap::InvalidateStatic(const Aabb& bounds)
+{
+    // Cached pages outside this frame's grids count too, so it's by the physical pages
+    const float4 footprint = Footprint(bounds);
+    for (PhysicalPage& page : m_physicalPages)
+    {
+        if (!page.used || !page.staticValid)
+        {
+            continue;
+        }
+        const float pageSize = m_levels[page.key.level].pageSize;
+        const float x = static_cast<float>(page.key.x) * pageSize;
+        const float y = static_cast<float>(page.key.y) * pageSize;
+        if (footprint.z >= x && footprint.x <= x + pageSize && footprint.w >= y &&
+            footprint.y <= y + pageSize)
+        {
+            page.staticValid = false;
+        }
+    }
+}
+
+void VirtualShadowMap::AddDynamicCaster(const Aabb& bounds)
+{
+    m_dynamicCasters.PushBack(Footprint(bounds));
+}
+
+void VirtualShadowMap::Request(const Aabb& bounds)
+{
+    const float3 nearest(fminf(fmaxf(m_camera.x, bounds.min.x), bounds.max.x),
+                         fminf(fmaxf(m_camera.y, bounds.min.y), bounds.max.y),
+                         fminf(fmaxf(m_camera.z, bounds.min.z), bounds.max.z));
+    const simd::float4 point =
+        simd::TransformPoint(m_lightView, simd::float4(nearest.x, nearest.y, nearest.z, 1.0f));
+
+    const int32 count = static_cast<int32>(m_desc.pagesPerSide);
+    for (uint32 level = 0; level < m_desc.levelCount; ++level)
+    {
+        const ShadowLevel& grid = m_levels[level];
+        const int32 x = PageOf(point.X(), grid.pageSize) - grid.firstPageX;
+        const int32 y = PageOf(point.Y(), grid.pageSize) - grid.firstPageY;
+        if (x < 0 || y < 0 || x >= count || y >= count)
+        {
+            continue;
+        }
+
+        int32 x0, y0, x1, y1;
+        if (FootprintPages(Footprint(bounds), grid, m_desc.pagesPerSide, x0, y0, x1, y1))
+        {
+            for (int32 py = y0; py <= y1; ++py)
+            {
+                for (int32 px = x0; px <= x1; ++px)
+                {
+                    RequestPage(ShadowPageKey{level, px, py});
+                }
+            }
+        }
+        return;
+    }
+}
+
+void VirtualShadowMap::RequestPage(const ShadowPageKey& key)
+{
+    if (key.level >= m_desc.levelCount)
+    {
+        return;
+    }
+    const ShadowLevel& grid = m_levels[key.level];
+    const int32 count = static_cast<int32>(m_desc.pagesPerSide);
+    if (key.x < grid.firstPageX || key.y < grid.firstPageY || key.x >= grid.firstPageX + count ||
+        key.y >= grid.firstPageY + count)
+    {
+        return;
+    }
+    const uint32 mask = m_desc.pagesPerSide - 1;
+    const uint32 slot = (uint32(key.y) & mask) * m_desc.pagesPerSide + (uint32(key.x) & mask);
+    m_needed[uint64(key.level) * m_desc.pagesPerSide * m_desc.pagesPerSide + slot] = 1;
+}
+
+uint32 VirtualShadowMap::AllocatePhysicalPage()
+{
+    if (!m_freePages.IsEmpty())
+    {
+        const uint32 page = m_freePages[m_freePages.Size() - 1];
+        m_freePages.PopBack();
+        return page;
+    }
+
+    // Everything's been handed out, so the least recently needed go, once per frame sorted
+    if (!m_evictableBuilt)
+    {
+        m_evictable.Clear();
+        for (uint32 i = 0; i < m_physicalPages.Size(); ++i)
+        {
+            if (m_physicalPages[i].lastNeeded < m_frame)
+            {
+                m_evictable.PushBack((m_physicalPages[i].lastNeeded << 32) | i);
+            }
+        }
+        RadixSort(ArrayView<uint64>(m_evictable));
+        m_nextEvictable = 0;
+        m_evictableBuilt = true;
+    }
+    if (m_nextEvictable == m_evictable.Size())
+    {
+        return kNoShadowPage;
+    }
+
+    const uint32 page = static_cast<uint32>(m_evictable[m_nextEvictable++]);
+    m_cached.Remove(PackKey(m_physicalPages[page].key));
+    m_physicalPages[page] = PhysicalPage{};
+    return page;
+}
+
+void VirtualShadowMap::Update()
+{
+    const uint32 count = m_desc.pagesPerSide;
+    const uint32 mask = count - 1;
+    const uint64 levelSize = uint64(count) * count;
+
+    for (const float4& caster : m_dynamicCasters)
+    {
+        for (uint32 level = 0; level < m_desc.levelCount; ++level)
+        {
+            int32 x0, y0, x1, y1;
+            if (!FootprintPages(caster, m_levels[level], count, x0, y0, x1, y1))
+            {
+                continue;
+            }
+            for (int32 y = y0; y <= y1; ++y)
+            {
+                for (int32 x = x0; x <= x1; ++x)
+                {
+                    m_dynamic[level * levelSize + (uint32(y) & mask) * count + (uint32(x) & mask)] =
+                        1;
+                }
+            }
+        }
+    }
+
+    // Pages cached from before are marked needed first, so making room for new ones never takes
+    // them
+    for (uint64 slot = 0; slot < m_pageTable.Size(); ++slot)
+    {
+        m_pageTable[slot] = kNoShadowPage;
+    }
+    for (uint32 pass = 0; pass < 2; ++pass)
+    {
+        for (uint32 level = 0; level < m_desc.levelCount; ++level)
+        {
+            const ShadowLevel& grid = m_levels[level];
+            for (uint32 j = 0; j < count; ++j)
+            {
+                for (uint32 i = 0; i < count; ++i)
+                {
+                    const ShadowPageKey key{level,
+                                            grid.firstPageX + static_cast<int32>(i),
+                                            grid.firstPageY + static_cast<int32>(j)};
+                    const uint64 slot =
+                        level * levelSize + (uint32(key.y) & mask) * count + (uint32(key.x) & mask);
+                    if (m_needed[slot] == 0 || m_pageTable[slot] != kNoShadowPage)
+                    {
+                        continue;
+                    }
+
+                    uint32 page = kNoShadowPage;
+                    if (const uint32* cached = m_cached.Find(PackKey(key)))
+                    {
+                        page = *cached;
+                    }
+                    else if (pass == 1)
+                    {
+                        page = AllocatePhysicalPage();
+                        if (page == kNoShadowPage)
+                        {
+                            ++m_stats.pagesDropped;
+                            continue;
+                        }
+                        m_physicalPages[page].key = key;
+                        m_physicalPages[page].used = true;
+                        m_cached.Insert(PackKey(key), page);
+                    }
+                    if (page == kNoShadowPage)
+                    {
+                        continue;
+                    }
+
+                    PhysicalPage& physical = m_physicalPages[page];
+                    physical.lastNeeded = m_frame;
+                    m_pageTable[slot] = page;
+                    ++m_stats.pagesNeeded;
+
+                    // A page without dynamic casters that had some drawn is copied clean again
+                    const bool renderStatic = !physical.staticValid;
+                    const bool renderDynamic = m_dynamic[slot] != 0;
+                    if (!renderStatic && !renderDynamic && !physical.dynamicDrawn)
+                    {
+                        continue;
+                    }
+                    physical.staticValid = true;
+                    physical.dynamicDrawn = renderDynamic;
+                    m_stats.staticRenders += renderStatic ? 1 : 0;
+                    m_stats.dynamicRenders += renderDynamic ? 1 : 0;
+
+                    // Light space onto the page, then its depth range onto 0 to 1
+                    const float scale = 2.0f / grid.pageSize;
+                    const float near = m_depthCenter - m_desc.depthRange * 0.5f;
+                    const simd::float4x4 projection(
+                        simd::float4(scale, 0.0f, 0.0f, 0.0f),
+                        simd::float4(0.0f, scale, 0.0f, 0.0f),
+                        simd::float4(0.0f, 0.0f, 1.0f / m_desc.depthRange, 0.0f),
+                        simd::float4(-2.0f * static_cast<float>(key.x) - 1.0f,
+                                     -2.0f * static_cast<float>(key.y) - 1.0f,
+                                     -near / m_desc.depthRange,
+                                     1.0f));
+
+                    ShadowPageUpdate& update = m_updates.EmplaceBack();
+                    update.key = key;
+                    update.physicalPage = page;
+                    update.viewProjection = projection * m_lightView;
+                    update.renderStatic = renderStatic;
+                    update.renderDynamic = renderDynamic;
+                }
+            }
+        }
+    }
+}
+
+} // namespace rsbl
@@ -0,0 +1,256 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-shadow-map.h"
+
+using namespace rsbl;
+
+namespace
+{
+const float3 kDown(0.0f, -1.0f, 0.0f);
+
+// Level 0 pages a unit across, level 1 two units, 4 by 4 of them
+ShadowMapDesc SmallDesc(uint32 physicalPageCount = 64)
+{
+    ShadowMapDesc desc;
+    desc.levelCount = 2;
+    desc.pagesPerSide = 4;
+    desc.firstLevelSize = 4.0f;
+    desc.depthRange = 100.0f;
+    desc.physicalPageCount = physicalPageCount;
+    return desc;
+}
+
+Aabb Box(float x, float z, float half)
+{
+    return Aabb{float3(x - half, -0.5f, z - half), float3(x + half, 0.5f, z + half)};
+}
+
+uint32 MappedPages(const VirtualShadowMap& shadows)
+{
+    uint32 mapped = 0;
+    for (const uint32 page : shadows.PageTable())
+    {
+        mapped += page != kNoShadowPage ? 1 : 0;
+    }
+    return mapped;
+}
+} // namespace
+
+TEST_SUITE("rsbl::VirtualShadowMap")
+{
+    TEST_CASE("Static pages render once and stay as the camera moves")
+    {
+        VirtualShadowMap shadows;
+        REQUIRE(shadows.Init(SmallDesc()));
+
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.25f, 0.25f, 0.2f));
+        shadows.Update();
+        REQUIRE(shadows.Updates().Size() == 1);
+        CHECK(shadows.Updates()[0].key.level == 0);
+        CHECK(shadows.Updates()[0].renderStatic);
+        CHECK_FALSE(shadows.Updates()[0].renderDynamic);
+        CHECK(MappedPages(shadows) == 1);
+        const uint32 page = shadows.Updates()[0].physicalPage;
+
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.25f, 0.25f, 0.2f));
+        shadows.Update();
+        CHECK(shadows.Updates().IsEmpty());
+        CHECK(shadows.Stats().pagesNeeded == 1);
+
+        // The grid follows the camera a page at a time, the page it had stays the page's
+        shadows.BeginFrame(kDown, float3(1.5f, 10.0f, -1.5f));
+        shadows.Request(Box(0.25f, 0.25f, 0.2f));
+        shadows.Update();
+        CHECK(shadows.Updates().IsEmpty());
+        bool found = false;
+        for (const uint32 mapped : shadows.PageTable())
+        {
+            found = found || mapped == page;
+        }
+        CHECK(found);
+    }
+
+    TEST_CASE("Requests take the finest level that reaches them")
+    {
+        VirtualShadowMap shadows;
+        REQUIRE(shadows.Init(SmallDesc()));
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+
+        // Level 0 reaches a page or two from the camera, level 1 twice as far
+        shadows.Request(Box(0.5f, 0.5f, 0.1f));
+        shadows.Request(Box(3.0f, 3.0f, 0.1f));
+        shadows.Request(Box(50.0f, 50.0f, 0.1f));
+        shadows.Update();
+        REQUIRE(shadows.Updates().Size() == 2);
+        CHECK(shadows.Updates()[0].key.level == 0);
+        CHECK(shadows.Updates()[1].key.level == 1);
+
+        // A box across the whole grid needs all of the level's pages, no more
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.0f, 0.0f, 40.0f));
+        shadows.Update();
+        CHECK(shadows.Stats().pagesNeeded == 16);
+    }
+
+    TEST_CASE("Moving static objects redraw only the pages under them")
+    {
+        VirtualShadowMap shadows;
+        REQUIRE(shadows.Init(SmallDesc()));
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.0f, 0.0f, 1.5f));
+        shadows.Update();
+        CHECK(shadows.Stats().staticRenders == 16);
+
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.InvalidateStatic(Box(0.5f, 0.5f, 0.1f));
+        shadows.Request(Box(0.0f, 0.0f, 1.5f));
+        shadows.Update();
+        REQUIRE(shadows.Updates().Size() == 1);
+        CHECK(shadows.Updates()[0].renderStatic);
+        CHECK(shadows.Stats().pagesNeeded == 16);
+
+        // Anywhere along the light is the same column of pages
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.InvalidateStatic(Aabb{float3(0.4f, -30.0f, 0.4f), float3(0.6f, -20.0f, 0.6f)});
+        shadows.Request(Box(0.0f, 0.0f, 1.5f));
+        shadows.Update();
+        CHECK(shadows.Updates().Size() == 1);
+    }
+
+    TEST_CASE("Dynamic casters are drawn over a copy of the static pages")
+    {
+        VirtualShadowMap shadows;
+        REQUIRE(shadows.Init(SmallDesc()));
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.0f, 0.0f, 1.5f));
+        shadows.Update();
+
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.AddDynamicCaster(Box(0.5f, 0.5f, 0.1f));
+        shadows.Request(Box(0.0f, 0.0f, 1.5f));
+        shadows.Update();
+        REQUIRE(shadows.Updates().Size() == 1);
+        CHECK_FALSE(shadows.Updates()[0].renderStatic);
+        CHECK(shadows.Updates()[0].renderDynamic);
+        const uint32 page = shadows.Updates()[0].physicalPage;
+
+        // Gone again, its page is copied clean once
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.0f, 0.0f, 1.5f));
+        shadows.Update();
+        REQUIRE(shadows.Updates().Size() == 1);
+        CHECK(shadows.Updates()[0].physicalPage == page);
+        CHECK_FALSE(shadows.Updates()[0].renderStatic);
+        CHECK_FALSE(shadows.Updates()[0].renderDynamic);
+
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.0f, 0.0f, 1.5f));
+        shadows.Update();
+        CHECK(shadows.Updates().IsEmpty());
+    }
+
+    TEST_CASE("Turning the light starts every page again")
+    {
+        VirtualShadowMap shadows;
+        REQUIRE(shadows.Init(SmallDesc()));
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.0f, 0.0f, 1.5f));
+        shadows.Update();
+
+        shadows.BeginFrame(float3(0.3f, -1.0f, 0.0f), float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.0f, 0.0f, 1.5f));
+        shadows.Update();
+        CHECK(shadows.Stats().staticRenders == shadows.Stats().pagesNeeded);
+        CHECK(shadows.Stats().staticRenders > 0);
+
+        // As does moving a quarter of the depth range along it
+        shadows.BeginFrame(float3(0.3f, -1.0f, 0.0f), float3(0.0f, -20.0f, 0.0f));
+        shadows.Request(Box(0.0f, 0.0f, 1.5f));
+        shadows.Update();
+        CHECK(shadows.Stats().staticRenders == shadows.Stats().pagesNeeded);
+    }
+
+    TEST_CASE("The least recently needed pages make room, and the rest are dropped")
+    {
+        VirtualShadowMap shadows;
+        REQUIRE(shadows.Init(SmallDesc(4)));
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(-0.5f, -0.5f, 0.1f));
+        shadows.Update();
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.5f, 0.5f, 0.1f));
+        shadows.Request(Box(0.5f, -0.5f, 0.1f));
+        shadows.Request(Box(-0.5f, 0.5f, 0.1f));
+        shadows.Update();
+        CHECK(shadows.Stats().staticRenders == 3);
+
+        // Two new pages: the first frame's is the only one not needed since, then none's left
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(0.5f, 0.5f, 0.1f));
+        shadows.Request(Box(0.5f, -0.5f, 0.1f));
+        shadows.Request(Box(-0.5f, 0.5f, 0.1f));
+        shadows.Request(Box(1.5f, 1.5f, 0.1f));
+        shadows.Request(Box(1.5f, -1.5f, 0.1f));
+        shadows.Update();
+        CHECK(shadows.Stats().staticRenders == 1);
+        CHECK(shadows.Stats().pagesDropped == 1);
+        CHECK(MappedPages(shadows) == 4);
+
+        // The evicted page draws again
+        shadows.BeginFrame(kDown, float3(0.0f, 10.0f, 0.0f));
+        shadows.Request(Box(-0.5f, -0.5f, 0.1f));
+        shadows.Update();
+        CHECK(shadows.Stats().staticRenders == 1);
+    }
+
+    TEST_CASE("A page's projection covers it")
+    {
+        VirtualShadowMap shadows;
+        REQUIRE(shadows.Init(SmallDesc()));
+        shadows.BeginFrame(float3(0.2f, -1.0f, 0.4f), float3(3.0f, 10.0f, -2.0f));
+        shadows.Request(Box(3.0f, -2.0f, 0.5f));
+        shadows.Update();
+        REQUIRE_FALSE(shadows.Updates().IsEmpty());
+
+        const ShadowPageUpdate& update = shadows.Updates()[0];
+        const float pageSize = shadows.Levels()[update.key.level].pageSize;
+        const simd::float4x4 toWorld = Inverse(shadows.LightView());
+        const float corners[2] = {0.0f, 1.0f};
+        for (const float u : corners)
+        {
+            for (const float v : corners)
+            {
+                const simd::float4 light((static_cast<float>(update.key.x) + u) * pageSize,
+                                         (static_cast<float>(update.key.y) + v) * pageSize,
+                                         0.0f,
+                                         1.0f);
+                const simd::float4 world = simd::TransformPoint(toWorld, light);
+                const simd::float4 clip = simd::TransformPoint(update.viewProjection, world);
+                CHECK(clip.X() == doctest::Approx(u * 2.0f - 1.0f).epsilon(0.001));
+                CHECK(clip.Y() == doctest::Approx(v * 2.0f - 1.0f).epsilon(0.001));
+                CHECK(clip.Z() >= 0.0f);
+                CHECK(clip.Z() <= 1.0f);
+            }
+        }
+    }
+
+    TEST_CASE("Descs out of range are refused")
+    {
+        VirtualShadowMap shadows;
+        ShadowMapDesc desc = SmallDesc();
+        desc.pagesPerSide = 6;
+        CHECK(shadows.Init(desc).Category() == ErrorCategory::InvalidArgument);
+        desc = SmallDesc();
+        desc.levelCount = kMaxShadowLevels + 1;
+        CHECK_FALSE(shadows.Init(desc));
+        desc = SmallDesc();
+        desc.firstLevelSize = 0.0f;
+        CHECK_FALSE(shadows.Init(desc));
+    }
+}
@@ -0,0 +1,358 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-vertex-pulling.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-matrix.h>
+#include <rsbl-packing.h>
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kSplitAlignment = 16;
+
+template <typename T>
+T Read(const uint8* bytes, uint32 index)
+{
+    T value;
+    std::memcpy(&value, bytes + index * sizeof(T), sizeof(T));
+    return value;
+}
+
+// An attribute's components, the missing ones 0 but w, which is 1
+float4 Decode(VertexStreamFormat format, const uint8* bytes)
+{
+    float4 value(0.0f, 0.0f, 0.0f, 1.0f);
+    float* components = &value.x;
+    switch (format)
+    {
+    case VertexStreamFormat::None:
+        break;
+    case VertexStreamFormat::Float32x2:
+    case VertexStreamFormat::Float32x3:
+    case VertexStreamFormat::Float32x4:
+        std::memcpy(components, bytes, VertexStreamFormatSize(format));
+        break;
+    case VertexStreamFormat::Half16x2:
+    case VertexStreamFormat::Half16x4:
+        for (uint32 i = 0; i < VertexStreamFormatSize(format) / 2; ++i)
+        {
+            components[i] = HalfToFloat(Read<uint16>(bytes, i));
+        }
+        break;
+    case VertexStreamFormat::Unorm16x4:
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            components[i] = UnpackUnorm16(Read<uint16>(bytes, i));
+        }
+        break;
+    case VertexStreamFormat::Snorm16x4:
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            components[i] = UnpackSnorm16(Read<int16>(bytes, i));
+        }
+        break;
+    case VertexStreamFormat::Unorm8x4:
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            components[i] = UnpackUnorm8(Read<uint8>(bytes, i));
+        }
+        break;
+    case VertexStreamFormat::Snorm8x4:
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            components[i] = UnpackSnorm8(Read<int8>(bytes, i));
+        }
+        break;
+    }
+    return value;
+}
+
+uint32 AlignUp(uint32 value, uint32 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+uint32 VertexStreamFormatSize(VertexStreamFormat format)
+{
+    switch (format)
+    {
+    case VertexStreamFormat::None:
+        return 0;
+    case VertexStreamFormat::Float32x2:
+        return 8;
+    case VertexStreamFormat::Float32x3:
+        return 12;
+    case VertexStreamFormat::Float32x4:
+        return 16;
+    case VertexStreamFormat::Half16x2:
+        return 4;
+    case VertexStreamFormat::Half16x4:
+    case VertexStreamFormat::Unorm16x4:
+    case VertexStreamFormat::Snorm16x4:
+        return 8;
+    case VertexStreamFormat::Unorm8x4:
+    case VertexStreamFormat::Snorm8x4:
+        return 4;
+    }
+    return 0;
+}
+
+GpuVertexStreams CookedVertexStreams(uint32 buffer, uint32 offset, const Aabb& bounds)
+{
+    rsblAssert(offset % 4 == 0);
+
+    GpuVertexStreams streams;
+    streams.buffer = buffer;
+    streams.positionMin[0] = bounds.min.x;
+    streams.positionMin[1] = bounds.min.y;
+    streams.positionMin[2] = bounds.min.z;
+    streams.positionScale[0] = bounds.max.x - bounds.min.x;
+    streams.positionScale[1] = bounds.max.y - bounds.min.y;
+    streams.positionScale[2] = bounds.max.z - bounds.min.z;
+    streams[VertexAttribute::Position] = {offset + CookedVertexLayout::kPositionOffset,
+                                          CookedVertexLayout::kStride,
+                                          VertexStreamFormat::Unorm16x4};
+    streams[VertexAttribute::TangentFrame] = {offset + CookedVertexLayout::kTangentFrameOffset,
+                                              CookedVertexLayout::kStride,
+                                              VertexStreamFormat::Snorm16x4};
+    streams[VertexAttribute::Uv] = {offset + CookedVertexLayout::kUvOffset,
+                                    CookedVertexLayout::kStride,
+                                    VertexStreamFormat::Half16x2};
+    return streams;
+}
+
+GpuVertexStreams SplitVertexStreams(const GpuVertexStreams& source,
+                                    ByteView data,
+                                    uint32 vertexCount,
+                                    DynamicArray<uint8>& packed)
+{
+    GpuVertexStreams split = source;
+    split.baseVertex = 0;
+
+    uint32 offset = 0;
+    for (uint32 attribute = 0; attribute < kVertexAttributeCount; ++attribute)
+    {
+        const GpuVertexStream& from = source.streams[attribute];
+        const uint32 size = VertexStreamFormatSize(from.format);
+        if (size == 0)
+        {
+            split.streams[attribute] = GpuVertexStream{};
+            continue;
+        }
+
+        const uint64 last = uint64(source.baseVertex) + vertexCount - 1;
+        rsblAssert(vertexCount == 0 || from.offset + last * from.stride + size <= data.Size());
+        offset = AlignUp(offset, kSplitAlignment);
+        split.streams[attribute] = {offset, static_cast<uint16>(size), from.format};
+        packed.Resize(offset + uint64(size) * vertexCount);
+
+        const uint8* in = data.Data() + from.offset + uint64(source.baseVertex) * from.stride;
+        uint8* out = packed.Data() + offset;
+        for (uint32 vertex = 0; vertex < vertexCount; ++vertex)
+        {
+            std::memcpy(out + uint64(vertex) * size, in + uint64(vertex) * from.stride, size);
+        }
+        offset += size * vertexCount;
+    }
+    return split;
+}
+
+PulledVertex PullVertex(const GpuVertexStreams& streams, ByteView data, uint32 index)
+{
+    const uint64 vertex = uint64(streams.baseVertex) + index;
+    auto decode = [&](VertexAttribute attribute) {
+        const GpuVertexStream& stream = streams[attribute];
+        const uint64 at = stream.offset + vertex * stream.stride;
+        rsblAssert(at + VertexStreamFormatSize(stream.format) <= data.Size());
+        return Decode(stream.format, data.Data() + at);
+    };
+
+    PulledVertex pulled;
+    if (streams[VertexAttribute::Position].format != VertexStreamFormat::None)
+    {
+        const float4 position = decode(VertexAttribute::Position);
+        pulled.position = float3(streams.positionMin[0] + position.x * streams.positionScale[0],
+                                 streams.positionMin[1] + position.y * streams.positionScale[1],
+                                 streams.positionMin[2] + position.z * streams.positionScale[2]);
+    }
+    if (streams[VertexAttribute::TangentFrame].format != VertexStreamFormat::None)
+    {
+        const float4 q = decode(VertexAttribute::TangentFrame);
+        float3 tangent;
+        float handedness;
+        QTangentToFrame(
+            simd::Normalize(simd::quat(q.x, q.y, q.z, q.w)), pulled.normal, tangent, handedness);
+        pulled.tangent = float4(tangent.x, tangent.y, tangent.z, handedness);
+    }
+    if (streams[VertexAttribute::Uv].format != VertexStreamFormat::None)
+    {
+        const float4 uv = decode(VertexAttribute::Uv);
+        pulled.uv = float2(uv.x, uv.y);
+    }
+    if (streams[VertexAttribute::Color].format != VertexStreamFormat::None)
+    {
+        pulled.color = decode(VertexAttribute::Color);
+    }
+    return pulled;
+}
+
+void ApplyVertexPullingPipelineState(gaGraphicsPipelineDesc& desc)
+{
+    desc.attributes = {};
+    desc.vertexBuffers = {};
+    if (desc.pushConstantBytes < sizeof(GpuVertexStreams))
+    {
+        desc.pushConstantBytes = sizeof(GpuVertexStreams);
+    }
+}
+
+const char kVertexPullingShader[] = R"(
+struct VertexStreams // GpuVertexStreams
+{
+    float3 positionMin;
+    uint buffer;
+    float3 positionScale;
+    uint baseVertex;
+    uint2 streams[4]; // Offset, then stride in the low 16 bits and format in the high 16
+};
+
+// VertexAttribute
+static const uint kVertexPosition = 0;
+static const uint kVertexTangentFrame = 1;
+static const uint kVertexUv = 2;
+static const uint kVertexColor = 3;
+
+// VertexStreamFormat
+static const uint kStreamNone = 0;
+static const uint kStreamFloat32x2 = 1;
+static const uint kStreamFloat32x3 = 2;
+static const uint kStreamFloat32x4 = 3;
+static const uint kStreamHalf16x2 = 4;
+static const uint kStreamHalf16x4 = 5;
+static const uint kStreamUnorm16x4 = 6;
+static const uint kStreamSnorm16x4 = 7;
+static const uint kStreamUnorm8x4 = 8;
+static const uint kStreamSnorm8x4 = 9;
+
+struct PulledVertex
+{
+    float3 position;
+    float3 normal;
+    float4 tangent; // w is the bitangent's sign
+    float2 uv;
+    float4 color;
+};
+
+uint StreamFormat(VertexStreams streams, uint attribute)
+{
+    return streams.streams[attribute].y >> 16;
+}
+
+float SnormToFloat(int value, float scale)
+{
+    return max(float(value) * scale, -1.0);
+}
+
+// An attribute's components, the missing ones 0 but w, which is 1. Formats are the same for
+// every vertex of a draw, so the branches go the same way across a wave.
+float4 LoadStream(ByteAddressBuffer buffer, VertexStreams streams, uint attribute, uint vertex)
+{
+    const uint2 stream = streams.streams[attribute];
+    const uint at = stream.x + vertex * (stream.y & 0xffff);
+    switch (stream.y >> 16)
+    {
+    case kStreamFloat32x2:
+        return float4(asfloat(buffer.Load2(at)), 0.0, 1.0);
+    case kStreamFloat32x3:
+        return float4(asfloat(buffer.Load3(at)), 1.0);
+    case kStreamFloat32x4:
+        return asfloat(buffer.Load4(at));
+    case kStreamHalf16x2:
+    {
+        const uint packed = buffer.Load(at);
+        return float4(f16tof32(packed), f16tof32(packed >> 16), 0.0, 1.0);
+    }
+    case kStreamHalf16x4:
+    {
+        const uint2 packed = buffer.Load2(at);
+        return float4(f16tof32(packed), f16tof32(packed >> 16)).xzyw;
+    }
+    case kStreamUnorm16x4:
+    {
+        const uint2 packed = buffer.Load2(at);
+        return float4(packed & 0xffff, packed >> 16).xzyw / 65535.0;
+    }
+    case kStreamSnorm16x4:
+    {
+        const int2 packed = asint(buffer.Load2(at));
+        const int4 values = int4(packed << 16, packed).xzyw >> 16;
+        return float4(SnormToFloat(values.x, 1.0 / 32767.0),
+                      SnormToFloat(values.y, 1.0 / 32767.0),
+                      SnormToFloat(values.z, 1.0 / 32767.0),
+                      SnormToFloat(values.w, 1.0 / 32767.0));
+    }
+    case kStreamUnorm8x4:
+        return unpack_u8u32(buffer.Load(at)) / 255.0;
+    case kStreamSnorm8x4:
+    {
+        const int4 values = unpack_s8s32(buffer.Load(at));
+        return float4(SnormToFloat(values.x, 1.0 / 127.0),
+                      SnormToFloat(values.y, 1.0 / 127.0),
+                      SnormToFloat(values.z, 1.0 / 127.0),
+                      SnormToFloat(values.w, 1.0 / 127.0));
+    }
+    default:
+        return float4(0.0, 0.0, 0.0, 1.0);
+    }
+}
+
+float3 RotateByQuaternion(float4 q, float3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+// The vertex at index, relative to streams.baseVertex: SV_VertexID with the draw's base vertex
+// left at 0, or a meshlet's MeshletVertices entry
+PulledVertex PullVertex(VertexStreams streams, uint index)
+{
+    ByteAddressBuffer buffer = ResourceDescriptorHeap[streams.buffer];
+    const uint vertex = streams.baseVertex + index;
+
+    PulledVertex pulled;
+    pulled.position = 0.0;
+    pulled.normal = float3(0.0, 0.0, 1.0);
+    pulled.tangent = float4(1.0, 0.0, 0.0, 1.0);
+    pulled.uv = 0.0;
+    pulled.color = 1.0;
+    if (StreamFormat(streams, kVertexPosition) != kStreamNone)
+    {
+        const float3 position = LoadStream(buffer, streams, kVertexPosition, vertex).xyz;
+        pulled.position = streams.positionMin + position * streams.positionScale;
+    }
+    if (StreamFormat(streams, kVertexTangentFrame) != kStreamNone)
+    {
+        const float4 q = normalize(LoadStream(buffer, streams, kVertexTangentFrame, vertex));
+        pulled.normal = RotateByQuaternion(q, float3(0.0, 0.0, 1.0));
+        const float handedness = q.w < 0.0 ? -1.0 : 1.0;
+        pulled.tangent = float4(RotateByQuaternion(q, float3(1.0, 0.0, 0.0)), handedness);
+    }
+    if (StreamFormat(streams, kVertexUv) != kStreamNone)
+    {
+        pulled.uv = LoadStream(buffer, streams, kVertexUv, vertex).xy;
+    }
+    if (StreamFormat(streams, kVertexColor) != kStreamNone)
+    {
+        pulled.color = LoadStream(buffer, streams, kVertexColor, vertex);
+    }
+    return pulled;
+}
+)";
+
+} // namespace rsbl
@@ -0,0 +1,219 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-vertex-pulling.h"
+
+#include <rsbl-matrix.h>
+#include <rsbl-packing.h>
+
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+struct SourceVertex
+{
+    float3 position;
+    float3 normal;
+    float3 tangent;
+    float handedness;
+    float2 uv;
+};
+
+SourceVertex Source(uint32 i)
+{
+    const float f = static_cast<float>(i);
+    SourceVertex vertex;
+    vertex.position = float3(-2.0f + f * 0.125f, 1.0f + f * 0.25f, 3.0f - f * 0.5f);
+    vertex.normal = float3(0.0f, 0.0f, 1.0f);
+    vertex.tangent = i % 2 == 0 ? float3(1.0f, 0.0f, 0.0f) : float3(0.0f, 1.0f, 0.0f);
+    vertex.handedness = i % 3 == 0 ? -1.0f : 1.0f;
+    vertex.uv = float2(f / 8.0f, 1.0f - f / 16.0f);
+    return vertex;
+}
+
+// Vertices as the cooker writes them, CookedVertex's 20 bytes, over bounds
+void WriteCooked(const SourceVertex& source, const Aabb& bounds, uint8* out)
+{
+    const uint16 position[4] = {
+        PackUnorm16((source.position.x - bounds.min.x) / (bounds.max.x - bounds.min.x)),
+        PackUnorm16((source.position.y - bounds.min.y) / (bounds.max.y - bounds.min.y)),
+        PackUnorm16((source.position.z - bounds.min.z) / (bounds.max.z - bounds.min.z)),
+        0};
+    const uint64 qtangent =
+        PackQTangent16(QTangentFromFrame(source.normal, source.tangent, source.handedness));
+    const uint16 uv[2] = {FloatToHalf(source.uv.x), FloatToHalf(source.uv.y)};
+    std::memcpy(out + CookedVertexLayout::kPositionOffset, position, sizeof(position));
+    std::memcpy(out + CookedVertexLayout::kTangentFrameOffset, &qtangent, sizeof(qtangent));
+    std::memcpy(out + CookedVertexLayout::kUvOffset, uv, sizeof(uv));
+}
+
+void CheckVertex(const PulledVertex& pulled, const SourceVertex& source)
+{
+    CHECK(pulled.position.x == doctest::Approx(source.position.x).epsilon(1e-4));
+    CHECK(pulled.position.y == doctest::Approx(source.position.y).epsilon(1e-4));
+    CHECK(pulled.position.z == doctest::Approx(source.position.z).epsilon(1e-4));
+    CHECK(pulled.normal.z == doctest::Approx(1.0f).epsilon(1e-3));
+    CHECK(pulled.tangent.x == doctest::Approx(source.tangent.x).epsilon(1e-3));
+    CHECK(pulled.tangent.y == doctest::Approx(source.tangent.y).epsilon(1e-3));
+    CHECK(pulled.tangent.w == source.handedness);
+    CHECK(pulled.uv.x == doctest::Approx(source.uv.x).epsilon(1e-3));
+    CHECK(pulled.uv.y == doctest::Approx(source.uv.y).epsilon(1e-3));
+    CHECK(pulled.color.x == 1.0f);
+    CHECK(pulled.color.w == 1.0f);
+}
+} // namespace
+
+TEST_SUITE("rsbl::VertexPulling")
+{
+    TEST_CASE("Cooked vertices pull back to what was cooked")
+    {
+        constexpr uint32 kVertexCount = 16;
+        const Aabb bounds = {float3(-2.0f, 1.0f, -5.0f), float3(0.0f, 5.0f, 3.0f)};
+
+        // Two submeshes' worth in one buffer, after 12 bytes of something else
+        constexpr uint32 kOffset = 12;
+        DynamicArray<uint8> buffer;
+        buffer.Resize(kOffset + kVertexCount * CookedVertexLayout::kStride);
+        for (uint32 i = 0; i < kVertexCount; ++i)
+        {
+            uint8* out = buffer.Data() + kOffset + i * CookedVertexLayout::kStride;
+            WriteCooked(Source(i), bounds, out);
+        }
+
+        GpuVertexStreams streams = CookedVertexStreams(7, kOffset, bounds);
+        CHECK(streams.buffer == 7);
+        CHECK(streams[VertexAttribute::Position].stride == 20);
+        CHECK(streams[VertexAttribute::Color].format == VertexStreamFormat::None);
+        for (uint32 i = 0; i < kVertexCount; ++i)
+        {
+            CheckVertex(PullVertex(streams, buffer, i), Source(i));
+        }
+
+        // The second submesh starts at vertex 10, its indices from 0
+        streams.baseVertex = 10;
+        CheckVertex(PullVertex(streams, buffer, 3), Source(13));
+    }
+
+    TEST_CASE("Split streams pack each attribute on its own")
+    {
+        constexpr uint32 kVertexCount = 11;
+        const Aabb bounds = {float3(-2.0f, 1.0f, -5.0f), float3(0.0f, 5.0f, 3.0f)};
+        DynamicArray<uint8> interleaved;
+        interleaved.Resize(kVertexCount * CookedVertexLayout::kStride);
+        for (uint32 i = 0; i < kVertexCount; ++i)
+        {
+            WriteCooked(Source(i), bounds, interleaved.Data() + i * CookedVertexLayout::kStride);
+        }
+        GpuVertexStreams interleaved_streams = CookedVertexStreams(3, 0, bounds);
+        interleaved_streams.baseVertex = 2;
+
+        DynamicArray<uint8> split;
+        const GpuVertexStreams split_streams =
+            SplitVertexStreams(interleaved_streams, interleaved, kVertexCount - 2, split);
+        CHECK(split_streams.buffer == 3);
+        CHECK(split_streams.baseVertex == 0);
+        CHECK(split_streams.positionScale[1] == interleaved_streams.positionScale[1]);
+
+        // Positions alone are 8 bytes a vertex, the depth-only passes' whole read
+        const GpuVertexStream& position = split_streams[VertexAttribute::Position];
+        const GpuVertexStream& tangent_frame = split_streams[VertexAttribute::TangentFrame];
+        const GpuVertexStream& uv = split_streams[VertexAttribute::Uv];
+        CHECK(position.offset == 0);
+        CHECK(position.stride == 8);
+        CHECK(tangent_frame.offset == 80);
+        CHECK(tangent_frame.stride == 8);
+        CHECK(uv.offset == 160);
+        CHECK(uv.stride == 4);
+        CHECK(split_streams[VertexAttribute::Color].format == VertexStreamFormat::None);
+        CHECK(split.Size() == 160 + 4 * (kVertexCount - 2));
+
+        for (uint32 i = 0; i < kVertexCount - 2; ++i)
+        {
+            const PulledVertex from_split = PullVertex(split_streams, split, i);
+            const PulledVertex from_interleaved = PullVertex(interleaved_streams, interleaved, i);
+            CHECK(std::memcmp(&from_split, &from_interleaved, sizeof(PulledVertex)) == 0);
+        }
+    }
+
+    TEST_CASE("Every format decodes like the shader's")
+    {
+        struct Vertex
+        {
+            float position[3];
+            int8 qtangent[4];
+            uint16 uv[4];
+            uint8 color[4];
+        };
+        static_assert(sizeof(Vertex) == 28);
+
+        Vertex vertex;
+        vertex.position[0] = 1.5f;
+        vertex.position[1] = -2.0f;
+        vertex.position[2] = 0.25f;
+        // A quarter turn about z, the tangent going to +y, and a negative w for handedness
+        vertex.qtangent[0] = 0;
+        vertex.qtangent[1] = 0;
+        vertex.qtangent[2] = -90;
+        vertex.qtangent[3] = -90;
+        vertex.uv[0] = FloatToHalf(0.5f);
+        vertex.uv[1] = FloatToHalf(2.0f);
+        vertex.uv[2] = FloatToHalf(-1.0f);
+        vertex.uv[3] = FloatToHalf(3.0f);
+        vertex.color[0] = 255;
+        vertex.color[1] = 0;
+        vertex.color[2] = 51;
+        vertex.color[3] = 102;
+
+        GpuVertexStreams streams;
+        streams[VertexAttribute::Position] = {0, sizeof(Vertex), VertexStreamFormat::Float32x3};
+        streams[VertexAttribute::TangentFrame] = {
+            12, sizeof(Vertex), VertexStreamFormat::Snorm8x4};
+        streams[VertexAttribute::Uv] = {16, sizeof(Vertex), VertexStreamFormat::Half16x4};
+        streams[VertexAttribute::Color] = {24, sizeof(Vertex), VertexStreamFormat::Unorm8x4};
+
+        const PulledVertex pulled = PullVertex(streams, AsBytes(&vertex, sizeof(vertex)), 0);
+        CHECK(pulled.position.x == 1.5f);
+        CHECK(pulled.position.y == -2.0f);
+        CHECK(pulled.position.z == 0.25f);
+        CHECK(pulled.normal.z == doctest::Approx(1.0f).epsilon(1e-3));
+        CHECK(pulled.tangent.x == doctest::Approx(0.0f).epsilon(1e-3));
+        CHECK(pulled.tangent.y == doctest::Approx(1.0f).epsilon(1e-3));
+        CHECK(pulled.tangent.w == -1.0f);
+        CHECK(pulled.uv.x == 0.5f);
+        CHECK(pulled.uv.y == 2.0f);
+        CHECK(pulled.color.x == 1.0f);
+        CHECK(pulled.color.y == 0.0f);
+        CHECK(pulled.color.z == doctest::Approx(0.2f));
+        CHECK(pulled.color.w == doctest::Approx(0.4f));
+
+        CHECK(VertexStreamFormatSize(VertexStreamFormat::None) == 0);
+        CHECK(VertexStreamFormatSize(VertexStreamFormat::Float32x3) == 12);
+        CHECK(VertexStreamFormatSize(VertexStreamFormat::Half16x2) == 4);
+        CHECK(VertexStreamFormatSize(VertexStreamFormat::Snorm16x4) == 8);
+    }
+
+    TEST_CASE("Pulling pipelines have no input layout")
+    {
+        const gaVertexAttribute attributes[] = {{0, gaFormat::R32G32B32Float}};
+        const gaVertexBuffer vertex_buffers[] = {{12}};
+        gaGraphicsPipelineDesc desc;
+        desc.attributes = attributes;
+        desc.vertexBuffers = vertex_buffers;
+        desc.depth.test = true;
+
+        ApplyVertexPullingPipelineState(desc);
+        CHECK(desc.attributes.IsEmpty());
+        CHECK(desc.vertexBuffers.IsEmpty());
+        CHECK(desc.pushConstantBytes == sizeof(GpuVertexStreams));
+        CHECK(desc.depth.test);
+
+        desc.pushConstantBytes = 96;
+        ApplyVertexPullingPipelineState(desc);
+        CHECK(desc.pushConstantBytes == 96);
+    }
+}
@@ -0,0 +1,191 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include "rsbl-scene-graph.h"
+
+#include <rsbl-array-view.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-result.h>
+
+// Keyframe animation. A clip is built from glTF style channels, each animating one node's
+// translation, rotation or scale with its own key times, and stores them resampled at a fixed
+// rate and quantized to 16 bits per component against each component's range. Every track is
+// padded to 4 components, and a frame is one row of every track's codes, padded out to whole cache
+// lines, so sampling is two row reads and no key search: the rows are lerped and dequantized a
+// SIMD register of components at a time (LerpDequantize16, rsbl-packing.h), then written out a
+// track at a time.
+//
+// A pose is a SceneTransform per node the clip was built for. Sampling writes only the animated
+// parts, so a pose starts out as the rest transforms, and layering a second clip with a weight
+// blends it over whatever the first wrote.
+//
+//     AnimationClip walk;
+//     walk.Build(channels, skeleton_node_count);
+//     ... every frame ...
+//     walk.Sample(std::fmod(time, walk.Duration()), pose);
+//     run.Sample(std::fmod(time, run.Duration()), pose, run_weight);
+//     for (const uint32 node : walk.AnimatedNodes()) { graph.SetLocal(..., pose[node]); }
+//
+// AnimationSampler does the same for a crowd, across the job system under a time budget.
+
+namespace rsbl
+{
+
+class JobSystem;
+
+enum class AnimationPath : uint8
+{
+    Translation,
+    Rotation,
+    Scale,
+};
+
+// As glTF samplers have them
+enum class AnimationInterpolation : uint8
+{
+    Step,
+    Linear,
+    CubicSpline,
+};
+
+// One glTF channel with its sampler. values holds 3 floats a key for translation and scale, 4 for
+// rotation (xyzw); cubic splines have an in tangent, the value and an out tangent per key, in that
+// order. Linear rotations are slerped, as glTF specifies.
+struct AnimationChannel
+{
+    uint32 node = 0;
+    AnimationPath path = AnimationPath::Translation;
+    AnimationInterpolation interpolation = AnimationInterpolation::Linear;
+    ArrayView<const float> times;
+    ArrayView<const float> values;
+};
+
+struct AnimationClipOptions
+{
+    // Frames a second the channels are resampled at. Keys between frames are lost, so this is a
+    // trade between memory and fidelity.
+    float sampleRate = 30.0f;
+};
+
+class AnimationClip
+{
+  public:
+    // node_count is the size of the poses this clip samples into, every channel's node below it.
+    // InvalidArgument for a channel without keys, with times that go backwards or a values count
+    // that doesn't match, leaving the clip empty.
+    Result<> Build(ArrayView<const AnimationChannel> channels, uint32 node_count,
+                   const AnimationClipOptions& options = {});
+
+    // From 0 to the last key of any channel
+    float Duration() const
+    {
+        return m_duration;
+    }
+
+    uint32 NodeCount() const
+    {
+        return m_nodeCount;
+    }
+    uint32 FrameCount() const
+    {
+        return m_frameCount;
+    }
+    uint32 TrackCount() const
+    {
+        return static_cast<uint32>(m_tracks.Size());
+    }
+
+    // Each node with at least one track, ascending
+    ArrayView<const uint32> AnimatedNodes() const
+    {
+        return m_animatedNodes;
+    }
+
+    // Memory the clip's frames and ranges take
+    uint64 ByteSize() const;
+
+    // Writes the clip at time, clamped to [0, Duration()], into pose's animated parts. Below a
+    // weight of 1 they're blended over what's already there instead, rotations along the shorter
+    // arc. Step channels change on the frame at or after their key.
+    void Sample(float time, ArrayView<SceneTransform> pose, float weight = 1.0f) const;
+
+  private:
+    // A frame row's codes come in whole cache lines
+    struct alignas(64) CodeLine
+    {
+        uint16 codes[32];
+    };
+    static constexpr uint32 kCodesPerLine = 32;
+
+    struct Track
+    {
+        uint32 node;
+        AnimationPath path;
+    };
+
+    DynamicArray<Track> m_tracks{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicArray<uint32> m_animatedNodes{GetTaggedAllocator(MemoryTag::Scene)};
+    // Per component, 4 per track and padded to a row: value = offset + scale * code
+    DynamicArray<float> m_offsets{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicArray<float> m_scales{GetTaggedAllocator(MemoryTag::Scene)};
+    // m_frameCount rows of m_linesPerFrame lines
+    DynamicArray<CodeLine> m_frames{GetTaggedAllocator(MemoryTag::Scene)};
+
+    // Step tracks come first, they sample their frames without lerping
+    uint32 m_stepTrackCount = 0;
+    uint32 m_linesPerFrame = 0;
+    uint32 m_frameCount = 0;
+    uint32 m_nodeCount = 0;
+    float m_duration = 0.0f;
+    float m_framesPerSecond = 0.0f;
+};
+
+// One clip's contribution to an instance's pose, weighted over the layers before it
+struct AnimationLayer
+{
+    const AnimationClip* clip = nullptr;
+    float time = 0.0f;
+    float weight = 1.0f;
+};
+
+// A character: its layers, sampled in order into its pose. Everything pointed at has to stay
+// alive and unchanged through the sampling.
+struct AnimationInstance
+{
+    ArrayView<const AnimationLayer> layers;
+    ArrayView<SceneTransform> pose;
+};
+
+struct AnimationSamplerStats
+{
+    uint32 sampled = 0;
+    // Left with last frame's pose, the budget having run out before their group started
+    uint32 skipped = 0;
+    uint64 elapsedNs = 0;
+};
+
+// Samples many instances a frame, a job per group of them. Past the budget, the groups not
+// started yet are skipped, and the next frame starts with the first of them, so under load every
+// instance still updates, just not every frame.
+class AnimationSampler
+{
+  public:
+    static constexpr uint32 kDefaultGroupSize = 32;
+
+    // The budget is checked before each group starts, so a frame overshoots it by up to a group
+    // per worker. The first group always goes, whatever the budget. Instances can share clips
+    // but not poses.
+    AnimationSamplerStats Sample(JobSystem& jobs, ArrayView<const AnimationInstance> instances,
+                                 uint64 budget_ns, uint32 group_size = kDefaultGroupSize);
+
+  private:
+    // The group sampling starts from, rotated on by the skips
+    uint64 m_firstGroup = 0;
+    DynamicArray<uint8> m_groupSampled{GetTaggedAllocator(MemoryTag::Scene)};
+};
+
+} // namespace rsbl
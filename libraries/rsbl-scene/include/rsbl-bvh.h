@@ -0,0 +1,135 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-bit-set.h>
+#include <rsbl-bounds.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-function.h>
+#include <rsbl-int-types.h>
+#include <rsbl-math-types.h>
+#include <rsbl-memory-tracking.h>
+
+// Linear BVH over object bounds, for scene queries: frustum culling, ray picking and overlaps.
+// Objects are sorted by the Morton code of their box center (Karras, "Maximizing Parallelism in
+// the Construction of BVHs, Octrees, and k-d Trees", 2012), then every leaf climbs towards the
+// root merging with its closest neighbour in code order (Apetrei, 2014). Leaves climb
+// independently, so the build splits across threads. Trees are worse than a SAH build, but a
+// build costs a few tens of ns per object, cheap enough to redo every frame or two.
+// For moving objects Refit recomputes the boxes over the existing tree. The tree keeps the order
+// the objects were built in, so queries slow down as objects drift; rebuild every so often.
+
+// TODO: Wider nodes (4 children) so one SIMD test covers a node's children
+
+namespace rsbl
+{
+
+struct Ray
+{
+    float3 origin;
+    float3 direction; // Needn't be unit length, hit distances are in multiples of it
+};
+
+// Rays Bvh::RaycastPacket walks the tree with at once, a SIMD register's worth
+constexpr uint32 kRayPacketWidth = 4;
+
+struct BvhBuildOptions
+{
+    // Threads working on the build, counting the calling one. Work is split in chunks of a few
+    // thousand objects, so small scenes stay on the calling thread.
+    uint32 threadCount = 1;
+};
+
+class Bvh
+{
+  public:
+    static constexpr uint32 kNoObject = ~0u;
+
+    // Objects are identified by their index in bounds
+    void Build(ArrayView<const Aabb> bounds, const BvhBuildOptions& options = {});
+
+    // New bounds for the objects given to Build, same count and order
+    void Refit(ArrayView<const Aabb> bounds, uint32 threadCount = 1);
+
+    uint64 ObjectCount() const
+    {
+        return m_leafObjects.Size();
+    }
+
+    // Box around every object, EmptyAabb() without any
+    Aabb Bounds() const
+    {
+        return m_bounds;
+    }
+
+    // Same result as Intersects(frustum, box) on every object box: visible is resized to the
+    // object count and bit i is set when object i may be visible. Subtrees that are fully inside
+    // or outside the frustum are decided without visiting their objects.
+    void CullFrustum(const Frustum& frustum, DynamicBitSet& visible) const;
+
+    // Appends the objects whose box meets the segment origin + t * direction, 0 <= t <= tMax
+    void QueryRay(const Ray& ray, float tMax, DynamicArray<uint32>& objects) const;
+
+    // Closest hit. Visits the objects whose box the ray meets, nearest box first, and calls
+    // hit(object, tMax), which tests the object itself and returns its hit distance, or anything
+    // >= tMax for a miss. Hits shorten the ray for the rest of the walk, so far subtrees are
+    // skipped. Returns the closest object hit, or kNoObject, and tMax is its distance.
+    uint32 Raycast(const Ray& ray, float& tMax,
+                   const Function<float(uint32 object, float tMax)>& hit) const;
+
+    // Raycast for up to kRayPacketWidth rays at once, walking the tree once for all of them: a
+    // subtree is visited when any ray still looking meets its box, so rays that start close
+    // together and point about the same way (a screen tile's, a probe's) share most of the walk
+    // and test boxes four at a time. hit(object, lanes, tMax) tests the object against the rays
+    // in lanes, bit i for rays[i], and lowers tMax[i] to the distance of each it hits. objects[i]
+    // is left as the object that last lowered tMax[i], so as ray i's closest hit, or kNoObject.
+    void RaycastPacket(const Ray* rays,
+                       uint32 count,
+                       float* tMax,
+                       uint32* objects,
+                       const Function<void(uint32 object, uint32 lanes, float* tMax)>& hit) const;
+
+    // Append the objects whose box overlaps the volume
+    void QueryOverlap(const Aabb& box, DynamicArray<uint32>& objects) const;
+    void QueryOverlap(const Sphere& sphere, DynamicArray<uint32>& objects) const;
+
+  private:
+    // Children refer to internal nodes by index, leaves by index with kLeafBit set. Leaves are
+    // the objects in Morton order.
+    static constexpr uint32 kLeafBit = 0x80000000u;
+
+    // The children's boxes live in their parent, so a walk tests both children with the one
+    // cache line it already loaded
+    struct alignas(64) Node
+    {
+        Aabb childBounds[2];
+        uint32 children[2];
+        // Every node covers a contiguous range of leaves
+        uint32 firstLeaf;
+        uint32 leafCount;
+    };
+    static_assert(sizeof(Node) == 64);
+
+    // Appends the objects whose box test accepts, skipping the subtrees it rejects
+    template <typename Test>
+    void Collect(const Test& test, DynamicArray<uint32>& objects) const;
+
+    // Internal node, or leaf 0 when there's a single object
+    uint32 m_root = kLeafBit;
+    Aabb m_bounds = EmptyAabb();
+
+    DynamicArray<Node> m_nodes{GetTaggedAllocator(MemoryTag::Scene)};
+
+    // Parent of each internal node, then of each leaf
+    DynamicArray<uint32> m_parents{GetTaggedAllocator(MemoryTag::Scene)};
+
+    // Object of each leaf
+    DynamicArray<uint32> m_leafObjects{GetTaggedAllocator(MemoryTag::Scene)};
+
+    // Build and refit scratch, per internal node
+    DynamicArray<uint32> m_visits{GetTaggedAllocator(MemoryTag::Scene)};
+};
+
+} // namespace rsbl
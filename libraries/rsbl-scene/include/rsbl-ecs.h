@@ -0,0 +1,384 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-assert.h>
+#include <rsbl-bounds.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-function.h>
+#include <rsbl-hash-map.h>
+#include <rsbl-int-types.h>
+#include <rsbl-matrix.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-slot-map.h>
+
+#include "rsbl-scene-graph.h"
+
+// Entities as rows of components, grouped by archetype: every entity with the same set of
+// components lives in the same 16 KB chunks, each component in a column of its own, as an
+// SoaArray would lay them out. A system walks the chunks its query matches and streams through
+// just the columns it reads, with no per-entity lookups or pointers to chase, and chunks are the
+// unit work is split across the job system in.
+//
+//     EntityWorld world;
+//     const Entity crate = world.Create(SceneTransform{}, WorldTransform{}, MeshRef{mesh});
+//     world.Add(crate, MaterialRef{material});
+//
+//     EntityQuery moving(world, ComponentMaskOf<SceneTransform, WorldTransform>());
+//     moving.ParallelForEachChunk(*jobs, [&](const EntityChunk& chunk) {
+//         const ArrayView<SceneTransform> locals = chunk.Field<SceneTransform>();
+//         const ArrayView<WorldTransform> worlds = chunk.Field<WorldTransform>();
+//         ...
+//     });
+//
+// Components are plain data: trivially copyable, up to kSoaAlignment aligned, and moved around
+// with memcpy when an entity gains or loses one, or another entity's removal fills a hole. Up to
+// kMaxComponentTypes types can be used in one program. Node hierarchies stay in SceneGraph; an
+// entity here is flat, its world transform computed from its own local transform.
+
+namespace rsbl
+{
+
+class JobSystem;
+class AnimationClip;
+
+// A generational handle, stale once the entity's destroyed
+using Entity = SlotHandle;
+
+constexpr uint32 kMaxComponentTypes = 64;
+
+// The component types an archetype has, or a query wants, a bit per type ID
+struct ComponentMask
+{
+    uint64 bits = 0;
+
+    bool Contains(const ComponentMask& other) const
+    {
+        return (bits & other.bits) == other.bits;
+    }
+
+    bool Overlaps(const ComponentMask& other) const
+    {
+        return (bits & other.bits) != 0;
+    }
+
+    bool Test(uint32 type) const
+    {
+        return (bits >> type) & 1;
+    }
+
+    bool operator==(const ComponentMask&) const = default;
+};
+
+namespace Internal
+{
+    // Hands out component type IDs, in the order types are first used
+    uint32 RegisterComponentType(uint32 size);
+} // namespace Internal
+
+// The same for a type everywhere in the program, though not from one run to the next
+template <typename T>
+uint32 ComponentTypeOf()
+{
+    static_assert(__is_trivially_copyable(T), "Components are moved with memcpy");
+    static_assert(alignof(T) <= kSoaAlignment, "Components are aligned to chunk columns");
+    static const uint32 type = Internal::RegisterComponentType(sizeof(T));
+    return type;
+}
+
+template <typename... Components>
+ComponentMask ComponentMaskOf()
+{
+    ComponentMask mask;
+    ((mask.bits |= uint64(1) << ComponentTypeOf<Components>()), ...);
+    return mask;
+}
+
+// Built in components, what the scene systems below read and write. SceneTransform is the
+// local transform.
+
+struct WorldTransform
+{
+    simd::float4x4 matrix = simd::Identity4x4();
+};
+
+struct MeshRef
+{
+    uint32 mesh = 0;
+};
+
+struct MaterialRef
+{
+    uint32 material = 0;
+};
+
+// The mesh's box, in the entity's own space
+struct LocalBounds
+{
+    Aabb box;
+};
+
+// LocalBounds through WorldTransform
+struct WorldBounds
+{
+    Aabb box;
+};
+
+struct AnimationState
+{
+    const AnimationClip* clip = nullptr;
+    float time = 0.0f;
+    float speed = 1.0f;
+    bool loop = true;
+};
+
+namespace Internal
+{
+    // Where an entity's row is: row / capacity is the chunk, row % capacity the row in it
+    struct EntityLocation
+    {
+        uint32 archetype = 0;
+        uint32 row = 0;
+    };
+
+    struct EntityArchetype
+    {
+        static constexpr uint16 kNoColumn = 0xffff;
+
+        ComponentMask mask;
+        // Rows per chunk
+        uint32 capacity = 0;
+        // Byte offset of each type's column in a chunk, kNoColumn for the types it doesn't have.
+        // The entity column is at 0.
+        uint16 columns[kMaxComponentTypes] = {};
+        // Every chunk is full but the last
+        DynamicArray<uint8*> chunks{GetTaggedAllocator(MemoryTag::Scene)};
+        uint64 count = 0;
+
+        uint32 ChunkCount(uint32 chunk) const
+        {
+            const uint64 left = count - uint64(chunk) * capacity;
+            return left < capacity ? static_cast<uint32>(left) : capacity;
+        }
+    };
+} // namespace Internal
+
+// One chunk's rows, as a query hands them out
+class EntityChunk
+{
+  public:
+    EntityChunk(const Internal::EntityArchetype* archetype, uint8* data, uint32 count)
+        : m_archetype(archetype)
+        , m_data(data)
+        , m_count(count)
+    {
+    }
+
+    uint32 Count() const
+    {
+        return m_count;
+    }
+
+    ArrayView<const Entity> Entities() const
+    {
+        return ArrayView<const Entity>(reinterpret_cast<const Entity*>(m_data), m_count);
+    }
+
+    // nullptr for a type the chunk doesn't have, for components a query takes if they're there
+    template <typename T>
+    T* Data() const
+    {
+        const uint16 column = m_archetype->columns[ComponentTypeOf<T>()];
+        if (column == Internal::EntityArchetype::kNoColumn)
+        {
+            return nullptr;
+        }
+        return reinterpret_cast<T*>(m_data + column);
+    }
+
+    // For the types the query asked for
+    template <typename T>
+    ArrayView<T> Field() const
+    {
+        T* data = Data<T>();
+        rsblDebugAssert(data != nullptr);
+        return ArrayView<T>(data, m_count);
+    }
+
+    ComponentMask Mask() const
+    {
+        return m_archetype->mask;
+    }
+
+  private:
+    const Internal::EntityArchetype* m_archetype;
+    uint8* m_data;
+    uint32 m_count;
+};
+
+class EntityWorld
+{
+  public:
+    static constexpr uint64 kChunkSize = 16 * 1024;
+
+    EntityWorld();
+    ~EntityWorld();
+
+    EntityWorld(const EntityWorld&) = delete;
+    EntityWorld& operator=(const EntityWorld&) = delete;
+
+    // A new entity with these components, one of each type
+    template <typename... Components>
+    Entity Create(const Components&... components)
+    {
+        const Entity entity = CreateEntity(ComponentMaskOf<Components...>());
+        const Internal::EntityLocation location = *m_entities.Get(entity);
+        ((*static_cast<Components*>(ComponentData(location, ComponentTypeOf<Components>())) =
+              components),
+         ...);
+        return entity;
+    }
+
+    // Its components with it. False for a stale handle.
+    bool Destroy(Entity entity);
+
+    bool IsAlive(Entity entity) const
+    {
+        return m_entities.Contains(entity);
+    }
+
+    // nullptr for a stale handle or an entity without one. Only valid until the next structural
+    // change: a Create, Destroy, Add or Remove.
+    template <typename T>
+    T* Get(Entity entity)
+    {
+        const Internal::EntityLocation* location = m_entities.Get(entity);
+        if (location == nullptr)
+        {
+            return nullptr;
+        }
+        return static_cast<T*>(ComponentData(*location, ComponentTypeOf<T>()));
+    }
+
+    template <typename T>
+    const T* Get(Entity entity) const
+    {
+        return const_cast<EntityWorld*>(this)->Get<T>(entity);
+    }
+
+    template <typename T>
+    bool Has(Entity entity) const
+    {
+        const Internal::EntityLocation* location = m_entities.Get(entity);
+        return location != nullptr &&
+               m_archetypes[location->archetype].mask.Test(ComponentTypeOf<T>());
+    }
+
+    // Moves the entity to the archetype with T too, or overwrites the T it has. False for a
+    // stale handle.
+    template <typename T>
+    bool Add(Entity entity, const T& component)
+    {
+        const uint32 type = ComponentTypeOf<T>();
+        if (!ChangeComponents(entity, ComponentMask{uint64(1) << type}, ComponentMask{}))
+        {
+            return false;
+        }
+        *static_cast<T*>(ComponentData(*m_entities.Get(entity), type)) = component;
+        return true;
+    }
+
+    // Moves the entity to the archetype without T. False for a stale handle.
+    template <typename T>
+    bool Remove(Entity entity)
+    {
+        return ChangeComponents(entity, ComponentMask{}, ComponentMaskOf<T>());
+    }
+
+    uint64 EntityCount() const
+    {
+        return m_entities.Size();
+    }
+
+    uint32 ArchetypeCount() const
+    {
+        return static_cast<uint32>(m_archetypes.Size());
+    }
+
+    const Internal::EntityArchetype& Archetype(uint32 archetype) const
+    {
+        return m_archetypes[archetype];
+    }
+
+  private:
+    friend class EntityQuery;
+
+    Entity CreateEntity(ComponentMask mask);
+    bool ChangeComponents(Entity entity, ComponentMask add, ComponentMask remove);
+    uint32 FindOrCreateArchetype(ComponentMask mask);
+
+    // A zeroed row at the end of the archetype
+    Internal::EntityLocation AppendRow(uint32 archetype, Entity entity);
+    // Fills the hole with the archetype's last row
+    void RemoveRow(const Internal::EntityLocation& location);
+
+    uint8* RowChunk(const Internal::EntityLocation& location) const;
+    void* ComponentData(const Internal::EntityLocation& location, uint32 type) const;
+
+    SlotMap<Internal::EntityLocation> m_entities{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicArray<Internal::EntityArchetype> m_archetypes{GetTaggedAllocator(MemoryTag::Scene)};
+    HashMap<uint64, uint32> m_archetypeOfMask{GetTaggedAllocator(MemoryTag::Scene)};
+
+    // Structural changes move rows between chunks, so they're off while a query walks them
+    uint32 m_iterating = 0;
+};
+
+// The chunks of every archetype with all of the with types and none of the without ones. The
+// archetypes that match are remembered, and only archetypes made since are checked the next time.
+// Any structural change to the world while a query walks it asserts.
+class EntityQuery
+{
+  public:
+    EntityQuery(EntityWorld& world, ComponentMask with, ComponentMask without = {});
+
+    // Chunk by chunk on the calling thread
+    void ForEachChunk(FunctionRef<void(const EntityChunk&)> body);
+
+    // Chunks split across the jobs, grain chunks per job, and waits for them. Bodies run at the
+    // same time on different chunks, so they write only to the chunk they're given.
+    void ParallelForEachChunk(JobSystem& jobs,
+                              FunctionRef<void(const EntityChunk&)> body,
+                              uint64 grain = 1);
+
+    uint64 EntityCount();
+
+  private:
+    struct ChunkRef
+    {
+        uint32 archetype;
+        uint32 chunk;
+    };
+
+    void Refresh();
+
+    EntityWorld* m_world;
+    ComponentMask m_with;
+    ComponentMask m_without;
+    uint32 m_archetypesChecked = 0;
+    DynamicArray<uint32> m_archetypes{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicArray<ChunkRef> m_chunks{GetTaggedAllocator(MemoryTag::Scene)};
+};
+
+// Scene systems over the built in components
+
+// WorldTransform from SceneTransform for every entity with both, and WorldBounds from
+// LocalBounds for those of them with both of those too
+void UpdateEntityTransforms(EntityWorld& world, JobSystem& jobs);
+
+// Moves every AnimationState with a clip on by seconds times its speed, wrapping looping clips
+// and stopping the others at their end
+void AdvanceAnimations(EntityWorld& world, JobSystem& jobs, float seconds);
+
+} // namespace rsbl
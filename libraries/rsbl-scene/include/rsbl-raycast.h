@@ -0,0 +1,131 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-bounds.h>
+#include <rsbl-bvh.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-math-types.h>
+#include <rsbl-matrix.h>
+#include <rsbl-memory-tracking.h>
+
+// Ray casts against triangles, for picking, visibility probes and tools. Each mesh gets a
+// TriangleBvh, a Bvh (rsbl-bvh.h) over its triangles, and the scene's Bvh over its instances'
+// world bounds finds which meshes a ray goes near; the ray then goes into each one's local space
+// and down its triangle BVH. A pick on a mesh of tens of thousands of triangles tests a few dozen
+// boxes and a handful of triangles, rather than every one of them.
+//
+// Batches go through in packets of kRayPacketWidth rays, which walk both levels together and
+// test each triangle against the whole packet at once. Packets work best with rays that start
+// together and spread little, as a tile of the screen's do; a batch's rays go into packets in
+// the order given.
+//
+//     meshes[m].Build(positions, indices);
+//     ... instances[i] = {&meshes[mesh of i], InverseAffine(world of i)} ...
+//     sceneBvh.Build(instance world bounds);
+//     ... hits[r].t = how far ray r looks ...
+//     RaycastScene(sceneBvh, instances, rays, hits);
+//     if (hits[r].object != Bvh::kNoObject) { ... instance, triangle and barycentrics ... }
+//
+// Triangles are hit from either side. Hit distances are in multiples of the ray's direction, the
+// same in every instance's space.
+
+namespace rsbl
+{
+
+class JobSystem;
+
+struct RayHit
+{
+    // Going in, how far the ray looks. Coming out, how far it went to the closest hit.
+    float t = 1e30f;
+    // The instance, for RaycastScene
+    uint32 object = Bvh::kNoObject;
+    uint32 triangle = Bvh::kNoObject;
+    // Barycentrics of the triangle's second and third vertices at the hit
+    float u = 0.0f;
+    float v = 0.0f;
+};
+
+// Positions as unorm16s over bounds, the way cooked meshes keep them (CookedVertex): x, y and z
+// at the start of every stride bytes
+struct Unorm16Positions
+{
+    const void* data = nullptr;
+    uint32 stride = 0;
+    uint32 count = 0;
+    Aabb bounds;
+};
+
+class TriangleBvh
+{
+  public:
+    // Three indices a triangle. Degenerate triangles are kept, no ray hits them.
+    void Build(ArrayView<const float3> positions,
+               ArrayView<const uint32> indices,
+               const BvhBuildOptions& options = {});
+    void Build(const Unorm16Positions& positions,
+               ArrayView<const uint32> indices,
+               const BvhBuildOptions& options = {});
+
+    uint32 TriangleCount() const
+    {
+        return static_cast<uint32>(m_triangles.Size());
+    }
+
+    Aabb Bounds() const
+    {
+        return m_bvh.Bounds();
+    }
+
+    // The closest hit closer than hit.t. Fills hit's triangle, barycentrics and t and returns
+    // true, or leaves it as it was and returns false.
+    bool Raycast(const Ray& ray, RayHit& hit) const;
+
+    // Raycast on up to kRayPacketWidth rays at once
+    void RaycastPacket(const Ray* rays, uint32 count, RayHit* hits) const;
+
+    // Raycast on every ray, in packets
+    void RaycastBatch(ArrayView<const Ray> rays, ArrayView<RayHit> hits) const;
+
+  private:
+    // Edges from the first vertex, ready for Möller-Trumbore
+    struct Triangle
+    {
+        float3 v0;
+        float3 e1;
+        float3 e2;
+    };
+
+    void BuildBvh(const BvhBuildOptions& options);
+
+    Bvh m_bvh;
+    DynamicArray<Triangle> m_triangles{GetTaggedAllocator(MemoryTag::Scene)};
+};
+
+struct RayInstance
+{
+    const TriangleBvh* mesh = nullptr;
+    // World to the mesh's space, the inverse of the instance's world transform
+    simd::float4x4 worldToLocal = simd::Identity4x4();
+};
+
+// Each ray's closest hit among the instances, the objects of scene being instances' world
+// bounds in the same order. Rays go in packets of kRayPacketWidth.
+void RaycastScene(const Bvh& scene,
+                  ArrayView<const RayInstance> instances,
+                  ArrayView<const Ray> rays,
+                  ArrayView<RayHit> hits);
+
+// The same with the batch's packets split over the job system, grain rays a job
+void RaycastScene(JobSystem& jobs,
+                  const Bvh& scene,
+                  ArrayView<const RayInstance> instances,
+                  ArrayView<const Ray> rays,
+                  ArrayView<RayHit> hits,
+                  uint64 grain = 256);
+
+} // namespace rsbl
@@ -0,0 +1,92 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-bit-set.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-matrix.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-result.h>
+
+// Automatic instancing. glTF scenes reference the same mesh from many nodes, and drawing each
+// node on its own makes the draw count grow with the node count. A render list sorts the scene's
+// draws by mesh and material and merges each run of the same pair into one instanced draw, so it
+// grows with the unique pairs instead. Every instance's transform goes in one array, a draw's
+// instances being a contiguous range of it: upload it as a structured buffer, and the vertex
+// shader finds its transform at the draw's first instance plus its instance ID.
+//
+// The grouping only changes with the set of draws, so it's built once and the transforms are
+// refreshed every frame, only for the nodes the scene graph's update touched:
+//
+//     RenderList list;
+//     list.Build(items, graph.WorldTransforms());
+//     ... every frame ...
+//     graph.UpdateWorldTransforms(*jobs);
+//     list.UpdateTransforms(graph.WorldTransforms(), graph.Updated());
+//     ... upload list.InstanceTransforms(), then for each of list.Draws() ...
+
+namespace rsbl
+{
+
+// One mesh drawn with one material at one scene graph node. A glTF mesh with several primitives
+// is an item per primitive, each with its own mesh ID.
+struct RenderItem
+{
+    uint32 mesh = 0;
+    uint32 material = 0;
+    uint32 node = 0;
+};
+
+// instanceCount instances of a mesh, whose transforms are InstanceTransforms()[firstInstance] on
+struct InstancedDraw
+{
+    uint32 mesh = 0;
+    uint32 material = 0;
+    uint32 firstInstance = 0;
+    uint32 instanceCount = 0;
+};
+
+class RenderList
+{
+  public:
+    // Groups items into draws, ordered by mesh then material, a draw's instances in item order,
+    // and copies their transforms from worlds, which is indexed by node as
+    // SceneGraph::WorldTransforms. InvalidArgument for a node out of worlds' range, leaving the
+    // list empty.
+    Result<> Build(ArrayView<const RenderItem> items, ArrayView<const simd::float4x4> worlds);
+
+    ArrayView<const InstancedDraw> Draws() const
+    {
+        return m_draws;
+    }
+
+    // One per item, in draw order. The top three rows of each world transform, which is what the
+    // vertex shader needs of an affine transform, in 48 bytes rather than 64.
+    ArrayView<const simd::float3x4> InstanceTransforms() const
+    {
+        return m_transforms;
+    }
+
+    // The node each instance transform comes from
+    ArrayView<const uint32> InstanceNodes() const
+    {
+        return m_nodes;
+    }
+
+    // Copies every instance's transform from worlds again
+    void UpdateTransforms(ArrayView<const simd::float4x4> worlds);
+
+    // Only for the instances whose nodes are set in updated, as SceneGraph::Updated. Returns how
+    // many changed, nothing needing an upload when none did.
+    uint64 UpdateTransforms(ArrayView<const simd::float4x4> worlds, const DynamicBitSet& updated);
+
+  private:
+    DynamicArray<InstancedDraw> m_draws{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicArray<simd::float3x4> m_transforms{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicArray<uint32> m_nodes{GetTaggedAllocator(MemoryTag::Scene)};
+};
+
+} // namespace rsbl
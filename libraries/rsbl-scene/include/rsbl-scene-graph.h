@@ -0,0 +1,140 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-bit-set.h>
+#include <rsbl-dynamic-array.h>
+#include <rsbl-int-types.h>
+#include <rsbl-matrix.h>
+#include <rsbl-memory-tracking.h>
+#include <rsbl-result.h>
+#include <rsbl-soa-array.h>
+
+// Flat node hierarchy for transform propagation. Nodes live in structure-of-arrays columns sorted
+// by depth, so every parent comes before its children and each depth level is a contiguous range
+// of nodes. World transforms then update front to back in one pass, with no pointers to chase and
+// no recursion, or a level at a time across the job system.
+//
+// Changing a local transform marks the node dirty, and an update only recomputes dirty nodes and
+// everything below them. Which nodes it recomputed stays readable until the next update, for
+// whatever mirrors the world transforms (BVH refits, GPU instance buffers) to copy only those.
+//
+//     SceneGraph graph;
+//     graph.Build(parents, locals);
+//     ... every frame ...
+//     graph.SetLocal(graph.NodeOf(animated), transform);
+//     graph.UpdateWorldTransforms(*jobs);
+//     for (const uint64 node : graph.Updated()) { ... graph.WorldTransforms()[node] ... }
+
+namespace rsbl
+{
+
+class JobSystem;
+
+// Scale, then rotate, then translate, as glTF nodes do it. w of translation and scale is unused.
+struct SceneTransform
+{
+    simd::float4 translation = simd::float4(0.0f, 0.0f, 0.0f, 0.0f);
+    simd::quat rotation = simd::QuatIdentity();
+    simd::float4 scale = simd::float4(1.0f, 1.0f, 1.0f, 0.0f);
+};
+
+class SceneGraph
+{
+  public:
+    static constexpr uint32 kNoParent = simd::kNoParent;
+
+    // parents[i] is the index of node i's parent among the inputs, or kNoParent for a root, in any
+    // order. Nodes get new indices, depth first then input order; NodeOf maps between the two.
+    // Every node starts dirty. InvalidArgument for a parent out of range or a cycle, leaving the
+    // graph empty.
+    Result<> Build(ArrayView<const uint32> parents, ArrayView<const SceneTransform> locals);
+
+    uint64 NodeCount() const
+    {
+        return m_nodes.Size();
+    }
+
+    // A node's index from its index among Build's inputs, and back
+    uint32 NodeOf(uint32 input) const
+    {
+        return m_nodeOfInput[input];
+    }
+    uint32 InputOf(uint32 node) const
+    {
+        return m_nodes.Get<kInput>(node);
+    }
+
+    // Below each node's own index, kNoParent for roots
+    ArrayView<const uint32> Parents() const
+    {
+        return m_nodes.Field<kParent>();
+    }
+
+    // Level d is the nodes [LevelOffsets()[d], LevelOffsets()[d + 1]), roots being level 0
+    uint32 LevelCount() const
+    {
+        return m_levelOffsets.IsEmpty() ? 0 : static_cast<uint32>(m_levelOffsets.Size() - 1);
+    }
+    ArrayView<const uint32> LevelOffsets() const
+    {
+        return m_levelOffsets;
+    }
+
+    const SceneTransform& Local(uint32 node) const
+    {
+        return m_nodes.Get<kLocal>(node);
+    }
+
+    // Takes effect on the next update
+    void SetLocal(uint32 node, const SceneTransform& local)
+    {
+        m_nodes.Get<kLocal>(node) = local;
+        m_dirty.Set(node);
+    }
+
+    // Recomputes the world transforms of the dirty nodes and their descendants, in one pass
+    void UpdateWorldTransforms();
+
+    // Same result, a level at a time, each level split across the jobs in chunks of about grain
+    // nodes. Levels smaller than grain run on the calling thread.
+    void UpdateWorldTransforms(JobSystem& jobs, uint64 grain = 4096);
+
+    // Every node's world transform as of the last update
+    ArrayView<const simd::float4x4> WorldTransforms() const
+    {
+        return m_nodes.Field<kWorld>();
+    }
+
+    // The nodes the last update recomputed
+    const DynamicBitSet& Updated() const
+    {
+        return m_updated;
+    }
+
+  private:
+    enum NodeField : uint32
+    {
+        kParent,
+        kLocal,
+        kWorld,
+        kInput,
+    };
+
+    // Updates the nodes [begin, end), whose parents come before them. Of m_updated, it only sets
+    // the range's bits and reads the parents' ones.
+    void UpdateRange(uint64 begin, uint64 end);
+
+    SoaArray<uint32, SceneTransform, simd::float4x4, uint32> m_nodes{
+        GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicArray<uint32> m_nodeOfInput{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicArray<uint32> m_levelOffsets{GetTaggedAllocator(MemoryTag::Scene)};
+
+    // Locals changed since the last update
+    DynamicBitSet m_dirty{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicBitSet m_updated{GetTaggedAllocator(MemoryTag::Scene)};
+};
+
+} // namespace rsbl
@@ -0,0 +1,30 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-int-types.h>
+#include <rsbl-matrix.h>
+
+// The CPU side of skinning: the joint palettes GaDispatchSkinning (rsbl-ga.h) takes every frame,
+// built from the scene graph's world transforms, and the packed weights of its bind pose vertices.
+// As glTF has it, a joint's matrix is its world transform times its inverse bind matrix, and the
+// transform of the node the skinned mesh hangs off doesn't apply.
+
+namespace rsbl
+{
+
+// Floats per joint: the top three rows of its matrix, row-major
+constexpr uint32 kSkinningPaletteFloats = 12;
+
+// Writes joints.Size() entries to palette: worlds[joints[j]] * inverse_binds[j], j being the
+// joint's index in the skin. worlds is indexed by node, as SceneGraph::WorldTransforms.
+void BuildSkinningPalette(ArrayView<const simd::float4x4> worlds, ArrayView<const uint32> joints,
+                          ArrayView<const simd::float4x4> inverse_binds, ArrayView<float> palette);
+
+// Four joint weights normalized and quantized to unorm16 codes that sum to exactly 65535, the
+// rounding left over going to the heaviest joint. All zero weights go to the first joint.
+void PackSkinWeights(const float weights[4], uint16 codes[4]);
+
+} // namespace rsbl
@@ -0,0 +1,90 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#pragma once
+
+#include <rsbl-array-view.h>
+#include <rsbl-bit-set.h>
+#include <rsbl-bounds.h>
+#include <rsbl-int-types.h>
+#include <rsbl-memory-tracking.h>
+
+// Per-object visibility kept from frame to frame, so a view that doesn't move doesn't cull the
+// whole scene again every frame. The frustum test of each object is cached, and an update only
+// tests the objects that moved since the last one, unless the frustum changed too, when every
+// object is tested again (through the scene's BVH when there is one). What occlusion culling
+// found visible is kept as well, for two-phase occlusion: the objects that were visible last
+// frame are drawn first, and make the depth the rest are tested against.
+//
+//     VisibilityCache cache;
+//     ... every frame ...
+//     cache.Update(FrustumFromViewProjection(viewProjection), bounds, moved, &bvh);
+//     ... draw cache.LastVisible(), then test cache.Disoccluded() against the depth it left ...
+//     cache.SetVisible(visible); // What both phases drew
+//
+// Cull with the view projection before any TAA jitter, which moves the frustum every frame.
+
+namespace rsbl
+{
+
+class Bvh;
+
+struct VisibilityUpdate
+{
+    uint64 tested = 0;        // Objects whose frustum test ran
+    bool viewChanged = false; // Every object was tested
+};
+
+class VisibilityCache
+{
+  public:
+    // Forgets everything, so the next update tests every object and nothing was visible last
+    // frame
+    void Reset();
+
+    // Brings the frustum tests up to date. bounds are every object's, and moved has a bit set
+    // for each object whose bounds changed since the last update (bits past its size count as
+    // clear, so it can be empty when nothing moved). Only moved objects are tested when frustum
+    // is the same as last time, bit for bit, and bounds the same size; otherwise every object
+    // is, with bvh when it's given and built or refitted over bounds. Then works out the two
+    // phases from what SetVisible was last told.
+    VisibilityUpdate Update(const Frustum& frustum,
+                            ArrayView<const Aabb> bounds,
+                            const DynamicBitSet& moved,
+                            const Bvh* bvh = nullptr);
+
+    // Objects that may be in the frustum, as of the last update
+    const DynamicBitSet& InFrustum() const
+    {
+        return m_inFrustum;
+    }
+
+    // Phase one: in the frustum and visible last frame, drawn without an occlusion test
+    const DynamicBitSet& LastVisible() const
+    {
+        return m_lastVisible;
+    }
+
+    // Phase two: in the frustum and not visible last frame, come into view or out from behind
+    // something, to test against the depth phase one left
+    const DynamicBitSet& Disoccluded() const
+    {
+        return m_disoccluded;
+    }
+
+    // What the occlusion tests found visible this frame, one bit per object, for the next
+    // update's phases. Objects out of the frustum, and bits past visible's size, count as not
+    // visible.
+    void SetVisible(const DynamicBitSet& visible);
+
+  private:
+    Frustum m_frustum = {};
+    bool m_tested = false; // m_frustum and m_inFrustum are from an update
+
+    DynamicBitSet m_inFrustum{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicBitSet m_visible{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicBitSet m_lastVisible{GetTaggedAllocator(MemoryTag::Scene)};
+    DynamicBitSet m_disoccluded{GetTaggedAllocator(MemoryTag::Scene)};
+};
+
+} // namespace rsbl
@@ -0,0 +1,382 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-animation.h"
+
+#include <rsbl-clock.h>
+#include <rsbl-jobs.h>
+#include <rsbl-packing.h>
+#include <rsbl-sort.h>
+
+#include <cmath>
+
+namespace rsbl
+{
+
+namespace
+{
+// Tracks decoded per pass of Sample, into a buffer on the stack
+constexpr uint32 kBlockTracks = 64;
+
+uint32 ComponentsOf(AnimationPath path)
+{
+    return path == AnimationPath::Rotation ? 4 : 3;
+}
+
+// Key key's value, or with which 0 and 2 its in and out tangents for a cubic spline
+simd::float4 KeyValue(const AnimationChannel& channel, uint64 key, uint32 which = 1)
+{
+    const uint32 components = ComponentsOf(channel.path);
+    const bool cubic = channel.interpolation == AnimationInterpolation::CubicSpline;
+    const float* v = channel.values.Data() + (cubic ? key * 3 + which : key) * components;
+    return simd::float4(v[0], v[1], v[2], components == 4 ? v[3] : 0.0f);
+}
+
+// The channel at time, key being the last one at or before it
+simd::float4 Evaluate(const AnimationChannel& channel, uint64 key, float time)
+{
+    const uint64 last = channel.times.Size() - 1;
+    if (key == last || time <= channel.times[0])
+    {
+        return KeyValue(channel, time <= channel.times[0] ? 0 : last);
+    }
+
+    const float dt = channel.times[key + 1] - channel.times[key];
+    const float s = dt > 0.0f ? (time - channel.times[key]) / dt : 0.0f;
+    const bool rotation = channel.path == AnimationPath::Rotation;
+    switch (channel.interpolation)
+    {
+    case AnimationInterpolation::Step:
+        return KeyValue(channel, key);
+    case AnimationInterpolation::Linear:
+        if (rotation)
+        {
+            return simd::Slerp(simd::quat(KeyValue(channel, key)),
+                               simd::quat(KeyValue(channel, key + 1)),
+                               s)
+                .xyzw;
+        }
+        return simd::Lerp(KeyValue(channel, key), KeyValue(channel, key + 1), s);
+    case AnimationInterpolation::CubicSpline:
+    {
+        // Hermite, the tangents scaled by the key interval as glTF has it
+        const float s2 = s * s;
+        const float s3 = s2 * s;
+        const simd::float4 value = (2.0f * s3 - 3.0f * s2 + 1.0f) * KeyValue(channel, key) +
+                                   (s3 - 2.0f * s2 + s) * dt * KeyValue(channel, key, 2) +
+                                   (-2.0f * s3 + 3.0f * s2) * KeyValue(channel, key + 1) +
+                                   (s3 - s2) * dt * KeyValue(channel, key + 1, 0);
+        return rotation ? simd::Normalize(simd::quat(value)).xyzw : value;
+    }
+    }
+    return KeyValue(channel, key);
+}
+
+void Apply(SceneTransform& transform, AnimationPath path, simd::float4 value, float weight)
+{
+    switch (path)
+    {
+    case AnimationPath::Translation:
+        value = simd::SetW(value, 0.0f);
+        transform.translation =
+            weight >= 1.0f ? value : simd::Lerp(transform.translation, value, weight);
+        break;
+    case AnimationPath::Rotation:
+    {
+        const simd::quat rotation = simd::Normalize(simd::quat(value));
+        transform.rotation =
+            weight >= 1.0f ? rotation : simd::Nlerp(transform.rotation, rotation, weight);
+        break;
+    }
+    case AnimationPath::Scale:
+        value = simd::SetW(value, 0.0f);
+        transform.scale = weight >= 1.0f ? value : simd::Lerp(transform.scale, value, weight);
+        break;
+    }
+}
+} // namespace
+
+Result<> AnimationClip::Build(ArrayView<const AnimationChannel> channels, uint32 node_count,
+                              const AnimationClipOptions& options)
+{
+    MemoryTagScope memory_scope(MemoryTag::Scene);
+
+    m_tracks.Clear();
+    m_animatedNodes.Clear();
+    m_offsets.Clear();
+    m_scales.Clear();
+    m_frames.Clear();
+    m_stepTrackCount = 0;
+    m_linesPerFrame = 0;
+    m_frameCount = 0;
+    m_nodeCount = 0;
+    m_duration = 0.0f;
+    m_framesPerSecond = 0.0f;
+
+    if (!(options.sampleRate > 0.0f))
+    {
+        return {ErrorCategory::InvalidArgument, "The sample rate has to be positive"};
+    }
+
+    float duration = 0.0f;
+    for (const AnimationChannel& channel : channels)
+    {
+        const uint64 keys = channel.times.Size();
+        const bool cubic = channel.interpolation == AnimationInterpolation::CubicSpline;
+        const uint64 per_key = cubic ? 3 : 1;
+        if (channel.node >= node_count)
+        {
+            return {ErrorCategory::InvalidArgument, "A channel's node is out of range"};
+        }
+        if (keys == 0 || channel.values.Size() != keys * per_key * ComponentsOf(channel.path))
+        {
+            return {ErrorCategory::InvalidArgument, "A channel's values don't match its keys"};
+        }
+        for (uint64 k = 0; k < keys; ++k)
+        {
+            const float time = channel.times[k];
+            if (!std::isfinite(time) || (k > 0 && time < channel.times[k - 1]))
+            {
+                return {ErrorCategory::InvalidArgument, "A channel's key times go backwards"};
+            }
+        }
+        duration = channel.times[keys - 1] > duration ? channel.times[keys - 1] : duration;
+    }
+
+    const uint32 frame_count =
+        duration > 0.0f ? static_cast<uint32>(std::ceil(duration * options.sampleRate)) + 1 : 1;
+    const uint32 track_count = static_cast<uint32>(channels.Size());
+    const uint32 lines = (track_count * 4 + kCodesPerLine - 1) / kCodesPerLine;
+
+    // Step tracks first, otherwise in channel order
+    DynamicArray<uint32> order(GetTaggedAllocator(MemoryTag::Scene));
+    for (uint32 pass = 0; pass < 2; ++pass)
+    {
+        for (uint32 c = 0; c < track_count; ++c)
+        {
+            const bool step = channels[c].interpolation == AnimationInterpolation::Step;
+            if (step == (pass == 0))
+            {
+                order.PushBack(c);
+                m_stepTrackCount += step ? 1 : 0;
+            }
+        }
+    }
+
+    m_nodeCount = node_count;
+    m_frameCount = frame_count;
+    m_linesPerFrame = lines;
+    m_duration = duration;
+    m_framesPerSecond = frame_count > 1 ? static_cast<float>(frame_count - 1) / duration : 0.0f;
+    m_offsets.Resize(uint64(lines) * kCodesPerLine);
+    m_scales.Resize(uint64(lines) * kCodesPerLine);
+    m_frames.Resize(uint64(frame_count) * lines);
+
+    // A track's frames, 4 floats each
+    DynamicArray<float> samples(GetTaggedAllocator(MemoryTag::Scene));
+    samples.Resize(uint64(frame_count) * 4);
+    for (uint32 t = 0; t < track_count; ++t)
+    {
+        const AnimationChannel& channel = channels[order[t]];
+        m_tracks.PushBack({channel.node, channel.path});
+
+        // Frames are at even steps, the last one exactly on the duration
+        uint64 key = 0;
+        simd::float4 previous(0.0f);
+        for (uint32 f = 0; f < frame_count; ++f)
+        {
+            const float time =
+                f + 1 == frame_count ? duration : static_cast<float>(f) / m_framesPerSecond;
+            while (key + 1 < channel.times.Size() && channel.times[key + 1] <= time)
+            {
+                ++key;
+            }
+            simd::float4 sample = Evaluate(channel, key, time);
+            // Neighbouring rotations on the same side, so lerping between them takes the short way
+            if (channel.path == AnimationPath::Rotation && simd::Dot4(sample, previous) < 0.0f)
+            {
+                sample = -sample;
+            }
+            simd::StoreUnaligned(sample, samples.Data() + uint64(f) * 4);
+            previous = sample;
+        }
+
+        for (uint32 c = 0; c < 4; ++c)
+        {
+            float low = samples[c];
+            float high = low;
+            for (uint32 f = 1; f < frame_count; ++f)
+            {
+                const float value = samples[uint64(f) * 4 + c];
+                low = value < low ? value : low;
+                high = value > high ? value : high;
+            }
+            const uint32 component = t * 4 + c;
+            const float scale = (high - low) / 65535.0f;
+            m_offsets[component] = low;
+            m_scales[component] = scale;
+            for (uint32 f = 0; f < frame_count; ++f)
+            {
+                const float value = samples[uint64(f) * 4 + c];
+                const float code = scale > 0.0f ? (value - low) / scale : 0.0f;
+                CodeLine& line = m_frames[uint64(f) * lines + component / kCodesPerLine];
+                line.codes[component % kCodesPerLine] =
+                    static_cast<uint16>(lrintf(code < 65535.0f ? code : 65535.0f));
+            }
+        }
+    }
+
+    for (const Track& track : m_tracks)
+    {
+        m_animatedNodes.PushBack(track.node);
+    }
+    RadixSort(ArrayView<uint32>(m_animatedNodes), GetTaggedAllocator(MemoryTag::Scene));
+    uint64 unique = 0;
+    for (uint64 i = 0; i < m_animatedNodes.Size(); ++i)
+    {
+        if (unique == 0 || m_animatedNodes[unique - 1] != m_animatedNodes[i])
+        {
+            m_animatedNodes[unique++] = m_animatedNodes[i];
+        }
+    }
+    m_animatedNodes.Resize(unique);
+    return ResultCode::Success;
+}
+
+uint64 AnimationClip::ByteSize() const
+{
+    return m_frames.Size() * sizeof(CodeLine) + m_offsets.Size() * sizeof(float) * 2 +
+           m_tracks.Size() * sizeof(Track) + m_animatedNodes.Size() * sizeof(uint32);
+}
+
+void AnimationClip::Sample(float time, ArrayView<SceneTransform> pose, float weight) const
+{
+    rsblAssert(pose.Size() >= m_nodeCount);
+    if (m_tracks.IsEmpty() || weight <= 0.0f)
+    {
+        return;
+    }
+
+    const float clamped = time < 0.0f ? 0.0f : (time > m_duration ? m_duration : time);
+    const float frame = clamped * m_framesPerSecond;
+    uint32 first = static_cast<uint32>(frame);
+    first = first + 1 < m_frameCount ? first : (m_frameCount > 1 ? m_frameCount - 2 : 0);
+    const uint32 second = first + 1 < m_frameCount ? first + 1 : first;
+    const float t = frame - static_cast<float>(first) < 1.0f ? frame - static_cast<float>(first)
+                                                             : 1.0f;
+    // Steps hold a frame until the next one starts
+    const float step_t = t >= 1.0f ? 1.0f : 0.0f;
+
+    const uint16* a = m_frames[uint64(first) * m_linesPerFrame].codes;
+    const uint16* b = m_frames[uint64(second) * m_linesPerFrame].codes;
+    const uint64 step_components = uint64(m_stepTrackCount) * 4;
+
+    alignas(64) float values[kBlockTracks * 4];
+    for (uint64 begin = 0; begin < m_tracks.Size(); begin += kBlockTracks)
+    {
+        const uint64 end = begin + kBlockTracks < m_tracks.Size() ? begin + kBlockTracks
+                                                                  : m_tracks.Size();
+        const uint64 c0 = begin * 4;
+        const uint64 c1 = end * 4;
+        const uint64 split =
+            step_components < c0 ? c0 : (step_components > c1 ? c1 : step_components);
+        const auto decode = [&](uint64 from, uint64 to, float weight_b) {
+            if (to > from)
+            {
+                LerpDequantize16(ArrayView<const uint16>(a + from, to - from),
+                                 ArrayView<const uint16>(b + from, to - from),
+                                 weight_b,
+                                 ArrayView<const float>(m_offsets.Data() + from, to - from),
+                                 ArrayView<const float>(m_scales.Data() + from, to - from),
+                                 ArrayView<float>(values + (from - c0), to - from));
+            }
+        };
+        decode(c0, split, step_t);
+        decode(split, c1, t);
+
+        for (uint64 track = begin; track < end; ++track)
+        {
+            const Track& target = m_tracks[track];
+            Apply(pose[target.node], target.path, simd::LoadAligned(values + (track - begin) * 4),
+                  weight);
+        }
+    }
+}
+
+AnimationSamplerStats AnimationSampler::Sample(JobSystem& jobs,
+                                               ArrayView<const AnimationInstance> instances,
+                                               uint64 budget_ns, uint32 group_size)
+{
+    rsblAssert(group_size > 0);
+    MemoryTagScope memory_scope(MemoryTag::Scene);
+
+    AnimationSamplerStats stats;
+    const uint64 start = Clock::NowNs();
+    const uint64 count = instances.Size();
+    if (count == 0)
+    {
+        return stats;
+    }
+
+    const uint64 groups = (count + group_size - 1) / group_size;
+    const uint64 first_group = m_firstGroup < groups ? m_firstGroup : 0;
+    const uint64 deadline = start + budget_ns;
+    m_groupSampled.Resize(groups);
+
+    // Groups in order from first_group on, wrapping around. Each group's flag is written by the
+    // one job that gets to it, and read once they've all finished.
+    jobs.ParallelFor(
+        0,
+        groups,
+        1,
+        [&](uint64 begin, uint64 end) {
+            for (uint64 i = begin; i < end; ++i)
+            {
+                // The first group always goes, so a frame over budget still makes progress
+                const uint64 group = (first_group + i) % groups;
+                if (i > 0 && Clock::NowNs() > deadline)
+                {
+                    m_groupSampled[group] = 0;
+                    continue;
+                }
+                const uint64 last = (group + 1) * group_size < count ? (group + 1) * group_size
+                                                                     : count;
+                for (uint64 instance = group * group_size; instance < last; ++instance)
+                {
+                    for (const AnimationLayer& layer : instances[instance].layers)
+                    {
+                        layer.clip->Sample(layer.time, instances[instance].pose, layer.weight);
+                    }
+                }
+                m_groupSampled[group] = 1;
+            }
+        },
+        JobPriority::High);
+
+    // Next frame starts at the first group skipped, in this frame's order
+    for (uint64 i = 0; i < groups; ++i)
+    {
+        const uint64 group = (first_group + i) % groups;
+        if (m_groupSampled[group] == 0)
+        {
+            m_firstGroup = group;
+            break;
+        }
+    }
+    for (uint64 group = 0; group < groups; ++group)
+    {
+        const uint64 size = group + 1 < groups ? group_size : count - group * group_size;
+        if (m_groupSampled[group] != 0)
+        {
+            stats.sampled += static_cast<uint32>(size);
+        }
+        else
+        {
+            stats.skipped += static_cast<uint32>(size);
+        }
+    }
+    stats.elapsedNs = Clock::NowNs() - start;
+    return stats;
+}
+
+} // namespace rsbl
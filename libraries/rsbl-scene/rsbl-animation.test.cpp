@@ -0,0 +1,277 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-animation.h"
+
+#include <rsbl-jobs.h>
+
+#include <cmath>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr float kHalfPi = 1.5707963f;
+
+bool NearlyEqual(simd::float4 a, simd::float4 b, float tolerance = 1e-3f)
+{
+    const simd::float4 difference = a - b;
+    return simd::Dot4(difference, difference) <= tolerance * tolerance;
+}
+
+// Same rotation, either sign
+bool SameRotation(simd::quat a, simd::quat b)
+{
+    return std::fabs(simd::Dot4(a.xyzw, b.xyzw)) > 1.0f - 1e-5f;
+}
+
+// A node walking along x and turning about y, keys on frame boundaries
+struct Walk
+{
+    const float translationTimes[3] = {0.0f, 0.5f, 1.0f};
+    const float translations[9] = {0.0f, 0.0f, 0.0f, 5.0f, -2.0f, 1.0f, 10.0f, 0.0f, 2.0f};
+    const float rotationTimes[2] = {0.0f, 1.0f};
+    float rotations[8] = {};
+    AnimationChannel channels[2];
+
+    Walk()
+    {
+        const simd::quat end = simd::QuatFromAxisAngle(simd::float4(0, 1, 0, 0), kHalfPi);
+        rotations[3] = 1.0f;
+        simd::StoreUnaligned(end.xyzw, rotations + 4);
+
+        channels[0].node = 1;
+        channels[0].path = AnimationPath::Translation;
+        channels[0].times = translationTimes;
+        channels[0].values = translations;
+        channels[1].node = 1;
+        channels[1].path = AnimationPath::Rotation;
+        channels[1].times = rotationTimes;
+        channels[1].values = rotations;
+    }
+};
+
+simd::float4 WalkTranslation(float time)
+{
+    return time < 0.5f ? simd::float4(time * 10.0f, time * -4.0f, time * 2.0f, 0.0f)
+                       : simd::float4(time * 10.0f, (time - 1.0f) * 4.0f, time * 2.0f, 0.0f);
+}
+
+simd::quat WalkRotation(float time)
+{
+    return simd::QuatFromAxisAngle(simd::float4(0, 1, 0, 0), kHalfPi * time);
+}
+
+// Rest poses with a telltale translation, to see what sampling left alone
+void ResetPose(ArrayView<SceneTransform> pose)
+{
+    for (SceneTransform& transform : pose)
+    {
+        transform = SceneTransform();
+        transform.translation = simd::float4(-7.0f, -7.0f, -7.0f, 0.0f);
+    }
+}
+} // namespace
+
+TEST_SUITE("rsbl::Animation")
+{
+    TEST_CASE("Resampled, quantized tracks sample back close to the channels")
+    {
+        Walk walk;
+        AnimationClip clip;
+        REQUIRE(clip.Build(walk.channels, 3));
+        CHECK(clip.Duration() == 1.0f);
+        CHECK(clip.FrameCount() == 31);
+        CHECK(clip.TrackCount() == 2);
+        REQUIRE(clip.AnimatedNodes().Size() == 1);
+        CHECK(clip.AnimatedNodes()[0] == 1);
+        // 8 components a frame fit in one cache line
+        CHECK(clip.ByteSize() < 31 * 64 + 1024);
+
+        SceneTransform pose[3];
+        for (const float time : {0.0f, 0.1f, 0.25f, 0.49f, 0.5f, 0.77f, 1.0f})
+        {
+            CAPTURE(time);
+            ResetPose(pose);
+            clip.Sample(time, pose);
+            CHECK(NearlyEqual(pose[1].translation, WalkTranslation(time)));
+            CHECK(SameRotation(pose[1].rotation, WalkRotation(time)));
+            CHECK(NearlyEqual(pose[1].scale, simd::float4(1.0f, 1.0f, 1.0f, 0.0f)));
+            // Nothing animates the others
+            CHECK(pose[0].translation.X() == -7.0f);
+            CHECK(pose[2].translation.X() == -7.0f);
+        }
+
+        // Outside the clip, its ends
+        ResetPose(pose);
+        clip.Sample(-1.0f, pose);
+        CHECK(NearlyEqual(pose[1].translation, WalkTranslation(0.0f)));
+        clip.Sample(3.0f, pose);
+        CHECK(NearlyEqual(pose[1].translation, WalkTranslation(1.0f)));
+    }
+
+    TEST_CASE("Steps hold and cubic splines pass through their keys")
+    {
+        // Scale steps from 1 to 3 at 0.5, translation is a spline with flat tangents
+        const float step_times[2] = {0.0f, 0.5f};
+        const float steps[6] = {1.0f, 1.0f, 1.0f, 3.0f, 3.0f, 3.0f};
+        const float spline_times[2] = {0.0f, 2.0f};
+        const float spline[18] = {
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, // in, value, out
+            0.0f, 0.0f, 0.0f, 4.0f, 8.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+        };
+        AnimationChannel channels[2];
+        channels[0].path = AnimationPath::Translation;
+        channels[0].interpolation = AnimationInterpolation::CubicSpline;
+        channels[0].times = spline_times;
+        channels[0].values = spline;
+        channels[1].path = AnimationPath::Scale;
+        channels[1].interpolation = AnimationInterpolation::Step;
+        channels[1].times = step_times;
+        channels[1].values = steps;
+
+        AnimationClip clip;
+        REQUIRE(clip.Build(channels, 1));
+        CHECK(clip.Duration() == 2.0f);
+
+        SceneTransform pose[1];
+        clip.Sample(0.45f, pose);
+        CHECK(NearlyEqual(pose[0].scale, simd::float4(1.0f, 1.0f, 1.0f, 0.0f)));
+        clip.Sample(0.5f, pose);
+        CHECK(NearlyEqual(pose[0].scale, simd::float4(3.0f, 3.0f, 3.0f, 0.0f)));
+        clip.Sample(2.0f, pose);
+        CHECK(NearlyEqual(pose[0].scale, simd::float4(3.0f, 3.0f, 3.0f, 0.0f)));
+        CHECK(NearlyEqual(pose[0].translation, simd::float4(4.0f, 8.0f, 0.0f, 0.0f)));
+
+        // Flat tangents ease in and out: halfway is halfway, a quarter in is well short of it
+        clip.Sample(1.0f, pose);
+        CHECK(NearlyEqual(pose[0].translation, simd::float4(2.0f, 4.0f, 0.0f, 0.0f)));
+        clip.Sample(0.5f, pose);
+        CHECK(pose[0].translation.X() == doctest::Approx(4.0f * 0.15625f).epsilon(1e-3));
+    }
+
+    TEST_CASE("Weights blend a clip over the pose")
+    {
+        Walk walk;
+        AnimationClip clip;
+        REQUIRE(clip.Build(walk.channels, 2));
+
+        SceneTransform pose[2];
+        ResetPose(pose);
+        pose[1].translation = simd::float4(0.0f, 0.0f, 0.0f, 0.0f);
+        clip.Sample(1.0f, pose, 0.5f);
+        CHECK(NearlyEqual(pose[1].translation, simd::float4(5.0f, 0.0f, 1.0f, 0.0f)));
+        CHECK(SameRotation(pose[1].rotation, WalkRotation(0.5f)));
+
+        // No weight, no change
+        const SceneTransform before = pose[1];
+        clip.Sample(0.3f, pose, 0.0f);
+        CHECK(NearlyEqual(pose[1].translation, before.translation, 0.0f));
+    }
+
+    TEST_CASE("Bad channels are rejected")
+    {
+        const float times[2] = {0.0f, 1.0f};
+        const float backwards[2] = {1.0f, 0.5f};
+        const float values[6] = {};
+        AnimationChannel channel;
+        channel.times = times;
+        channel.values = values;
+
+        AnimationClip clip;
+        REQUIRE(clip.Build(ArrayView<const AnimationChannel>(&channel, 1), 1));
+        CHECK(clip.TrackCount() == 1);
+
+        channel.node = 1;
+        CHECK(clip.Build(ArrayView<const AnimationChannel>(&channel, 1), 1).Category() ==
+              ErrorCategory::InvalidArgument);
+        CHECK(clip.TrackCount() == 0);
+        channel.node = 0;
+
+        channel.path = AnimationPath::Rotation;
+        CHECK_FALSE(clip.Build(ArrayView<const AnimationChannel>(&channel, 1), 1));
+        channel.path = AnimationPath::Scale;
+        channel.times = backwards;
+        CHECK_FALSE(clip.Build(ArrayView<const AnimationChannel>(&channel, 1), 1));
+        channel.times = ArrayView<const float>();
+        channel.values = ArrayView<const float>();
+        CHECK_FALSE(clip.Build(ArrayView<const AnimationChannel>(&channel, 1), 1));
+
+        // No channels is an empty clip
+        REQUIRE(clip.Build(ArrayView<const AnimationChannel>(), 4));
+        SceneTransform pose[4];
+        clip.Sample(0.0f, pose);
+    }
+
+    TEST_CASE("The sampler covers every instance, within the budget or over a few frames")
+    {
+        // Enough tracks that a row is several cache lines and a sample several blocks
+        constexpr uint32 kNodes = 100;
+        Walk walk;
+        DynamicArray<AnimationChannel> channels;
+        for (uint32 node = 0; node < kNodes; ++node)
+        {
+            for (AnimationChannel channel : walk.channels)
+            {
+                channel.node = node;
+                channels.PushBack(channel);
+            }
+        }
+        AnimationClip clip;
+        REQUIRE(clip.Build(channels, kNodes));
+
+        constexpr uint32 kInstances = 500;
+        DynamicArray<SceneTransform> poses;
+        poses.Resize(uint64(kInstances) * kNodes);
+        DynamicArray<AnimationLayer> layers;
+        DynamicArray<AnimationInstance> instances;
+        for (uint32 i = 0; i < kInstances; ++i)
+        {
+            layers.PushBack({&clip, float(i % 30) / 30.0f, 1.0f});
+        }
+        for (uint32 i = 0; i < kInstances; ++i)
+        {
+            instances.PushBack({ArrayView<const AnimationLayer>(&layers[i], 1),
+                                ArrayView<SceneTransform>(&poses[uint64(i) * kNodes], kNodes)});
+        }
+        const auto all_sampled = [&]() {
+            for (uint32 i = 0; i < kInstances; ++i)
+            {
+                for (uint32 node = 0; node < kNodes; node += 33)
+                {
+                    const SceneTransform& transform = poses[uint64(i) * kNodes + node];
+                    if (!NearlyEqual(transform.translation, WalkTranslation(layers[i].time)))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+
+        JobSystemOptions options;
+        options.workerCount = 3;
+        Result<UniquePtr<JobSystem>> jobs = JobSystem::Create(options);
+        REQUIRE(jobs);
+
+        AnimationSampler sampler;
+        AnimationSamplerStats stats = sampler.Sample(*jobs.Value(), instances, ~0ull >> 1, 16);
+        CHECK(stats.sampled == kInstances);
+        CHECK(stats.skipped == 0);
+        CHECK(all_sampled());
+
+        // No budget at all still gets through a group a frame, picking up where it left off
+        ResetPose(poses);
+        uint32 frames = 0;
+        for (; frames < 32 && !all_sampled(); ++frames)
+        {
+            stats = sampler.Sample(*jobs.Value(), instances, 0, 16);
+            CHECK(stats.sampled > 0);
+            CHECK(stats.sampled + stats.skipped == kInstances);
+        }
+        CHECK(all_sampled());
+    }
+}
@@ -0,0 +1,117 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Scene sizes from a small glTF to a large open world: BVH build (one and four threads) and
+// refit, then frustum culling through the BVH against brute force over every object, both one
+// Intersects call per object and the batched CullAabbs kernel. Where the CPU exposes its
+// performance counters, each line is followed by them per object.
+
+#include "include/rsbl-bvh.h"
+
+#include <rsbl-hw-counters.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint32 kRepeats = 20;
+
+// Stop the optimizer from folding the loops away
+volatile uint64 s_sink = 0;
+
+template <typename F>
+void Time(const char* name, uint32 objectCount, F&& f)
+{
+    HwCounterSample counters;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        HwZone zone(name, counters);
+        for (uint32 repeat = 0; repeat < kRepeats; ++repeat)
+        {
+            f();
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double us = std::chrono::duration<double, std::micro>(end - start).count() / kRepeats;
+    printf("  %-40s %9.1f us  (%5.2f ns/object)\n", name, us, us * 1000.0 / objectCount);
+    if (counters.available != 0)
+    {
+        String text;
+        AppendHwCounters(text, counters, static_cast<uint64>(objectCount) * kRepeats);
+        printf("  %-40s %s per object\n", "", text.CStr());
+    }
+}
+} // namespace
+
+int main()
+{
+    // Camera at the origin looking down +z, 90 degree vertical fov, aspect 16:9, depth 0 to 1
+    const float near_z = 0.1f;
+    const float far_z = 250.0f;
+    const float z_scale = far_z / (far_z - near_z);
+    const simd::float4x4 projection(simd::float4(9.0f / 16.0f, 0.0f, 0.0f, 0.0f),
+                                    simd::float4(0.0f, 1.0f, 0.0f, 0.0f),
+                                    simd::float4(0.0f, 0.0f, z_scale, 1.0f),
+                                    simd::float4(0.0f, 0.0f, -near_z * z_scale, 0.0f));
+    const Frustum frustum = FrustumFromViewProjection(projection);
+
+    for (const uint32 object_count : {1'000u, 10'000u, 100'000u, 1'000'000u})
+    {
+        // The world grows with the object count, so the frustum sees a shrinking share of it
+        const float world_size = 4.0f * sqrtf(static_cast<float>(object_count));
+        DynamicArray<Aabb> boxes;
+        DynamicArray<float> xs;
+        DynamicArray<float> ys;
+        DynamicArray<float> zs;
+        DynamicArray<float> extents;
+        uint64 state = 1;
+        auto next = [&state]() {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<float>(state >> 40) / static_cast<float>(1 << 24);
+        };
+        for (uint32 i = 0; i < object_count; ++i)
+        {
+            const float x = (next() - 0.5f) * world_size;
+            const float y = next() * 20.0f - 5.0f;
+            const float z = (next() - 0.5f) * world_size;
+            const float e = 0.5f + next() * 2.0f;
+            boxes.PushBack(Aabb{float3(x - e, y - e, z - e), float3(x + e, y + e, z + e)});
+            xs.PushBack(x);
+            ys.PushBack(y);
+            zs.PushBack(z);
+            extents.PushBack(e);
+        }
+
+        printf("%u objects\n", object_count);
+        Bvh bvh;
+        Time("Build", object_count, [&]() { bvh.Build(boxes); });
+        Time("Build, 4 threads", object_count, [&]() { bvh.Build(boxes, BvhBuildOptions{4}); });
+        Time("Refit", object_count, [&]() { bvh.Refit(boxes); });
+
+        DynamicBitSet visible;
+        Time("Intersects(Aabb) loop", object_count, [&]() {
+            uint64 count = 0;
+            for (const Aabb& box : boxes)
+            {
+                count += Intersects(frustum, box) ? 1 : 0;
+            }
+            s_sink = count;
+        });
+        Time("CullAabbs", object_count, [&]() {
+            CullAabbs(frustum, xs, ys, zs, extents, extents, extents, visible);
+            s_sink = visible.Words()[0];
+        });
+        Time("Bvh::CullFrustum", object_count, [&]() {
+            bvh.CullFrustum(frustum, visible);
+            s_sink = visible.Words()[0];
+        });
+        printf("  %llu visible\n", static_cast<unsigned long long>(visible.Count()));
+    }
+
+    return 0;
+}
@@ -0,0 +1,712 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-bvh.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-bits.h>
+#include <rsbl-morton.h>
+#include <rsbl-ptr.h>
+#include <rsbl-simd-wide.h>
+#include <rsbl-sort.h>
+#include <rsbl-thread.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+constexpr uint32 kNoParent = ~0u;
+
+// Walk stack, deep enough for any tree: a path down splits on at most 30 key bits and 32 index
+// bits, and holds one pending sibling per level
+constexpr uint32 kStackSize = 128;
+
+// Work is handed out to threads in chunks this many items long
+constexpr uint64 kChunkSize = 2048;
+
+// Runs body(begin, end) over [0, count) in chunks, on up to threadCount threads counting the
+// calling one. Threads that fail to start leave more chunks for the others.
+template <typename Body>
+void ParallelFor(uint64 count, uint32 threadCount, const Body& body)
+{
+    const uint64 chunk_count = (count + kChunkSize - 1) / kChunkSize;
+    std::atomic<uint64> next_chunk{0};
+    auto work = [&]() {
+        for (;;)
+        {
+            const uint64 chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunk_count)
+            {
+                return;
+            }
+            const uint64 begin = chunk * kChunkSize;
+            body(begin, begin + kChunkSize < count ? begin + kChunkSize : count);
+        }
+    };
+
+    DynamicArray<UniquePtr<Thread>> helpers;
+    for (uint64 i = 1; i < threadCount && i < chunk_count; ++i)
+    {
+        Result<UniquePtr<Thread>> thread = Thread::Create([&work]() -> Result<> {
+            work();
+            return ResultCode::Success;
+        });
+        if (!thread)
+        {
+            break;
+        }
+        helpers.PushBack(rsblMove(thread.Value()));
+    }
+
+    work();
+    for (UniquePtr<Thread>& helper : helpers)
+    {
+        const Result<> joined = helper->Join();
+        rsblAssert(joined);
+    }
+}
+
+// How far apart neighbouring leaves k and k + 1 are, smaller is closer: the differing key bits,
+// then the differing index bits so equal keys still split
+uint64 LeafDistance(const uint32* keys, uint64 k)
+{
+    return (static_cast<uint64>(keys[k] ^ keys[k + 1]) << 32) | (k ^ (k + 1));
+}
+
+constexpr uint32 kAllPlanes = (1u << Frustum::kPlaneCount) - 1;
+
+// Frustum planes transposed, four per register so one pass tests a box against all of them. The
+// lanes past the sixth plane hold 0x + 0y + 0z + 1, which every box is inside of.
+struct CullPlanes
+{
+    static constexpr uint32 kGroups = 2;
+
+    simd::FloatxN<4> x[kGroups];
+    simd::FloatxN<4> y[kGroups];
+    simd::FloatxN<4> z[kGroups];
+    simd::FloatxN<4> w[kGroups];
+    simd::FloatxN<4> absX[kGroups];
+    simd::FloatxN<4> absY[kGroups];
+    simd::FloatxN<4> absZ[kGroups];
+};
+
+CullPlanes SetupPlanes(const Frustum& frustum)
+{
+    float lanes[4][CullPlanes::kGroups * 4];
+    for (uint32 i = 0; i < CullPlanes::kGroups * 4; ++i)
+    {
+        const bool real = i < Frustum::kPlaneCount;
+        lanes[0][i] = real ? frustum.planes[i].normal.x : 0.0f;
+        lanes[1][i] = real ? frustum.planes[i].normal.y : 0.0f;
+        lanes[2][i] = real ? frustum.planes[i].normal.z : 0.0f;
+        lanes[3][i] = real ? frustum.planes[i].distance : 1.0f;
+    }
+
+    CullPlanes planes;
+    for (uint32 group = 0; group < CullPlanes::kGroups; ++group)
+    {
+        planes.x[group] = simd::FloatxN<4>::LoadUnaligned(&lanes[0][group * 4]);
+        planes.y[group] = simd::FloatxN<4>::LoadUnaligned(&lanes[1][group * 4]);
+        planes.z[group] = simd::FloatxN<4>::LoadUnaligned(&lanes[2][group * 4]);
+        planes.w[group] = simd::FloatxN<4>::LoadUnaligned(&lanes[3][group * 4]);
+        planes.absX[group] = simd::Abs(planes.x[group]);
+        planes.absY[group] = simd::Abs(planes.y[group]);
+        planes.absZ[group] = simd::Abs(planes.z[group]);
+    }
+    return planes;
+}
+
+// False when the box is outside a plane. Otherwise clears the planes in mask the box is fully
+// inside of; once none are left, everything below the box is visible.
+bool TestPlanes(const CullPlanes& planes, const Aabb& box, uint32& mask)
+{
+    // One plane per lane, summed in the order of the Dot4 and Dot3 in Intersects(Frustum, Aabb)
+    // so both agree exactly
+    const float3 center = Center(box);
+    const float3 extents = Extents(box);
+    const simd::FloatxN<4> cx(center.x);
+    const simd::FloatxN<4> cy(center.y);
+    const simd::FloatxN<4> cz(center.z);
+    const simd::FloatxN<4> ex(extents.x);
+    const simd::FloatxN<4> ey(extents.y);
+    const simd::FloatxN<4> ez(extents.z);
+
+    uint32 inside = 0;
+    for (uint32 group = 0; group < CullPlanes::kGroups; ++group)
+    {
+        const simd::FloatxN<4> distance = (planes.x[group] * cx + planes.y[group] * cy) +
+                                          (planes.z[group] * cz + planes.w[group]);
+        const simd::FloatxN<4> reach =
+            planes.absX[group] * ex + planes.absY[group] * ey + planes.absZ[group] * ez;
+        if (simd::Any(distance < -reach))
+        {
+            return false;
+        }
+        inside |= simd::ToBits(distance >= reach) << (group * 4);
+    }
+    mask &= ~inside;
+    return true;
+}
+
+// Ray with the reciprocal direction, ready for slab tests
+struct RaySetup
+{
+    float3 origin;
+    float3 inverseDirection;
+};
+
+RaySetup SetupRay(const Ray& ray)
+{
+    return RaySetup{ray.origin, float3(1.0f / ray.direction.x, 1.0f / ray.direction.y,
+                                       1.0f / ray.direction.z)};
+}
+
+void Slab(float origin, float inverseDirection, float min, float max, float& entry, float& exit)
+{
+    float near = (min - origin) * inverseDirection;
+    float far = (max - origin) * inverseDirection;
+    if (near > far)
+    {
+        const float swap = near;
+        near = far;
+        far = swap;
+    }
+    // Written so a NaN (origin on a slab plane of an axis the ray runs along) keeps the bound
+    entry = near > entry ? near : entry;
+    exit = far < exit ? far : exit;
+}
+
+// Where the ray enters the box, when it does within [0, tMax]
+bool RayHitsBox(const RaySetup& ray, const Aabb& box, float tMax, float& entry)
+{
+    entry = 0.0f;
+    float exit = tMax;
+    Slab(ray.origin.x, ray.inverseDirection.x, box.min.x, box.max.x, entry, exit);
+    Slab(ray.origin.y, ray.inverseDirection.y, box.min.y, box.max.y, entry, exit);
+    Slab(ray.origin.z, ray.inverseDirection.z, box.min.z, box.max.z, entry, exit);
+    return entry <= exit;
+}
+
+using RayLanes = simd::FloatxN<kRayPacketWidth>;
+
+// A packet's rays, one per lane, ready for slab tests
+struct PacketSetup
+{
+    simd::Vec3xN<kRayPacketWidth> origin;
+    simd::Vec3xN<kRayPacketWidth> inverseDirection;
+};
+
+// Kept finite, so an axis a ray runs along gives huge distances rather than 0 * inf NaNs, which
+// the lanes' min and max don't treat alike on every instruction set
+float PacketInverse(float direction)
+{
+    constexpr float kHuge = 1e20f;
+    if (direction > 1.0f / kHuge || direction < -1.0f / kHuge)
+    {
+        return 1.0f / direction;
+    }
+    return direction < 0.0f ? -kHuge : kHuge;
+}
+
+// Where each ray enters the box, and a bit for each that does within [0, tMax]
+uint32 PacketHitsBox(const PacketSetup& rays, const Aabb& box, RayLanes tMax, RayLanes& entry)
+{
+    const RayLanes x0 = (RayLanes(box.min.x) - rays.origin.x) * rays.inverseDirection.x;
+    const RayLanes x1 = (RayLanes(box.max.x) - rays.origin.x) * rays.inverseDirection.x;
+    const RayLanes y0 = (RayLanes(box.min.y) - rays.origin.y) * rays.inverseDirection.y;
+    const RayLanes y1 = (RayLanes(box.max.y) - rays.origin.y) * rays.inverseDirection.y;
+    const RayLanes z0 = (RayLanes(box.min.z) - rays.origin.z) * rays.inverseDirection.z;
+    const RayLanes z1 = (RayLanes(box.max.z) - rays.origin.z) * rays.inverseDirection.z;
+    entry = simd::Max(simd::Max(simd::Min(x0, x1), simd::Min(y0, y1)),
+                      simd::Max(simd::Min(z0, z1), RayLanes(0.0f)));
+    const RayLanes exit = simd::Min(simd::Min(simd::Max(x0, x1), simd::Max(y0, y1)),
+                                    simd::Min(simd::Max(z0, z1), tMax));
+    return simd::ToBits(entry <= exit);
+}
+
+bool BoxesOverlap(const Aabb& a, const Aabb& b)
+{
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y &&
+           b.min.y <= a.max.y && a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+bool SphereOverlapsBox(const Sphere& sphere, const Aabb& box)
+{
+    const simd::float4 center = simd::Load(sphere.center);
+    const simd::float4 closest = simd::Clamp(center, simd::Load(box.min), simd::Load(box.max));
+    const simd::float4 offset = center - closest;
+    return simd::Dot3(offset, offset) <= sphere.radius * sphere.radius;
+}
+} // namespace
+
+void Bvh::Build(ArrayView<const Aabb> bounds, const BvhBuildOptions& options)
+{
+    const uint64 count = bounds.Size();
+    rsblAssert(count < kLeafBit);
+    const uint32 thread_count = options.threadCount;
+    Allocator* allocator = GetTaggedAllocator(MemoryTag::Scene);
+
+    m_nodes.Resize(count > 0 ? count - 1 : 0);
+    m_parents.Resize(count > 0 ? (count - 1) + count : 0);
+    m_visits.Resize(m_nodes.Size());
+    m_leafObjects.Resize(count);
+    m_root = kLeafBit;
+    m_bounds = EmptyAabb();
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Box centers, and the box around them to quantize over
+    DynamicArray<float3> centers(allocator);
+    centers.Resize(count);
+    simd::float4 center_min = simd::Load(Center(bounds[0]));
+    simd::float4 center_max = center_min;
+    for (uint64 i = 0; i < count; ++i)
+    {
+        const simd::float4 center =
+            (simd::Load(bounds[i].min) + simd::Load(bounds[i].max)) * 0.5f;
+        simd::Store(center, centers[i]);
+        center_min = simd::Min(center_min, center);
+        center_max = simd::Max(center_max, center);
+    }
+    const Aabb center_bounds{simd::ToFloat3(center_min), simd::ToFloat3(center_max)};
+
+    // The top 30 bits of the Morton codes, 10 per axis as in Karras. That's as fine as the tree
+    // needs to be and sorts in 4 passes; objects sharing a cell split on their index.
+    DynamicArray<uint32> keys(allocator);
+    keys.Resize(count);
+    ParallelFor(count, thread_count, [&](uint64 begin, uint64 end) {
+        uint64 codes[kChunkSize];
+        MortonEncode3(ArrayView<const float3>(centers).Subview(begin, end - begin), center_bounds,
+                      ArrayView<uint64>(codes, end - begin));
+        for (uint64 i = begin; i < end; ++i)
+        {
+            keys[i] = static_cast<uint32>(codes[i - begin] >> 33);
+            m_leafObjects[i] = static_cast<uint32>(i);
+        }
+    });
+    RadixSort(ArrayView<uint32>(keys), m_leafObjects, allocator);
+
+    if (count == 1)
+    {
+        m_bounds = bounds[0];
+        return;
+    }
+
+    // Agglomerative build (Apetrei, "Fast and Simple Agglomerative LBVH Construction", 2014).
+    // Internal node k sits between leaves k and k + 1. Each leaf climbs towards the root: a node
+    // covering leaves [first, last] joins whichever of its outside neighbours is closer. The
+    // first child to reach a parent leaves its box and its end of the range there and stops, the
+    // second picks them up and carries on, so every node is built exactly once.
+    for (uint32& visits : m_visits)
+    {
+        visits = kNoParent;
+    }
+    const uint64 internal_count = count - 1;
+    ParallelFor(count, thread_count, [&](uint64 begin, uint64 end) {
+        for (uint64 leaf = begin; leaf < end; ++leaf)
+        {
+            const Aabb& leaf_bounds = bounds[m_leafObjects[leaf]];
+            simd::float4 min = simd::Load(leaf_bounds.min);
+            simd::float4 max = simd::Load(leaf_bounds.max);
+
+            uint32 current = static_cast<uint32>(leaf) | kLeafBit;
+            uint64 parent_slot = internal_count + leaf;
+            uint64 first = leaf;
+            uint64 last = leaf;
+            for (;;)
+            {
+                const bool join_right =
+                    first == 0 ||
+                    (last != count - 1 &&
+                     LeafDistance(keys.Data(), last) < LeafDistance(keys.Data(), first - 1));
+                const uint32 parent = static_cast<uint32>(join_right ? last : first - 1);
+                const uint32 side = join_right ? 0 : 1;
+                Node& node = m_nodes[parent];
+                node.children[side] = current;
+                node.childBounds[side] = Aabb{simd::ToFloat3(min), simd::ToFloat3(max)};
+                m_parents[parent_slot] = parent;
+
+                std::atomic_ref<uint32> other_end(m_visits[parent]);
+                const uint32 other =
+                    other_end.exchange(static_cast<uint32>(join_right ? first : last),
+                                       std::memory_order_acq_rel);
+                if (other == kNoParent)
+                {
+                    break;
+                }
+                (join_right ? last : first) = other;
+
+                const Aabb& sibling = node.childBounds[side ^ 1];
+                min = simd::Min(min, simd::Load(sibling.min));
+                max = simd::Max(max, simd::Load(sibling.max));
+                node.firstLeaf = static_cast<uint32>(first);
+                node.leafCount = static_cast<uint32>(last - first + 1);
+
+                current = parent;
+                parent_slot = parent;
+                if (first == 0 && last == count - 1)
+                {
+                    m_root = parent;
+                    m_parents[parent] = kNoParent;
+                    m_bounds = Aabb{simd::ToFloat3(min), simd::ToFloat3(max)};
+                    break;
+                }
+            }
+        }
+    });
+}
+
+void Bvh::Refit(ArrayView<const Aabb> bounds, uint32 threadCount)
+{
+    rsblAssert(bounds.Size() == m_leafObjects.Size());
+    const uint64 leaf_count = m_leafObjects.Size();
+    const uint64 internal_count = m_nodes.Size();
+    if (internal_count == 0)
+    {
+        m_bounds = leaf_count > 0 ? bounds[0] : EmptyAabb();
+        return;
+    }
+    for (uint32& visits : m_visits)
+    {
+        visits = 0;
+    }
+
+    // Same climb as the build over the existing tree: the first child to reach a node stores
+    // its box and stops, the second has both boxes ready
+    ParallelFor(leaf_count, threadCount, [&](uint64 begin, uint64 end) {
+        for (uint64 leaf = begin; leaf < end; ++leaf)
+        {
+            const Aabb& leaf_bounds = bounds[m_leafObjects[leaf]];
+            simd::float4 min = simd::Load(leaf_bounds.min);
+            simd::float4 max = simd::Load(leaf_bounds.max);
+
+            uint32 current = static_cast<uint32>(leaf) | kLeafBit;
+            uint32 node_index = m_parents[internal_count + leaf];
+            while (node_index != kNoParent)
+            {
+                Node& node = m_nodes[node_index];
+                const uint32 side = node.children[0] == current ? 0 : 1;
+                node.childBounds[side] = Aabb{simd::ToFloat3(min), simd::ToFloat3(max)};
+
+                std::atomic_ref<uint32> visits(m_visits[node_index]);
+                if (visits.fetch_add(1, std::memory_order_acq_rel) == 0)
+                {
+                    break;
+                }
+                const Aabb& sibling = node.childBounds[side ^ 1];
+                min = simd::Min(min, simd::Load(sibling.min));
+                max = simd::Max(max, simd::Load(sibling.max));
+
+                current = node_index;
+                node_index = m_parents[node_index];
+            }
+            if (node_index == kNoParent)
+            {
+                m_bounds = Aabb{simd::ToFloat3(min), simd::ToFloat3(max)};
+            }
+        }
+    });
+}
+
+void Bvh::CullFrustum(const Frustum& frustum, DynamicBitSet& visible) const
+{
+    visible.Resize(m_leafObjects.Size());
+    visible.ResetAll();
+    const CullPlanes planes = SetupPlanes(frustum);
+    uint32 root_mask = kAllPlanes;
+    if (m_leafObjects.IsEmpty() || !TestPlanes(planes, m_bounds, root_mask))
+    {
+        return;
+    }
+    if ((m_root & kLeafBit) != 0 || root_mask == 0)
+    {
+        visible.SetAll();
+        return;
+    }
+
+    struct Entry
+    {
+        uint32 node;
+        uint32 planeMask;
+    };
+    Entry stack[kStackSize];
+    uint32 stack_size = 0;
+    stack[stack_size++] = Entry{m_root, root_mask};
+
+    while (stack_size > 0)
+    {
+        const Entry entry = stack[--stack_size];
+        const Node& node = m_nodes[entry.node];
+        for (uint32 side = 0; side < 2; ++side)
+        {
+            uint32 mask = entry.planeMask;
+            if (!TestPlanes(planes, node.childBounds[side], mask))
+            {
+                continue;
+            }
+
+            const uint32 child = node.children[side];
+            if ((child & kLeafBit) != 0)
+            {
+                visible.Set(m_leafObjects[child & ~kLeafBit]);
+            }
+            else if (mask == 0)
+            {
+                // Inside every plane, so is everything below
+                const Node& inside = m_nodes[child];
+                for (uint32 leaf = inside.firstLeaf; leaf < inside.firstLeaf + inside.leafCount;
+                     ++leaf)
+                {
+                    visible.Set(m_leafObjects[leaf]);
+                }
+            }
+            else
+            {
+                rsblAssert(stack_size < kStackSize);
+                stack[stack_size++] = Entry{child, mask};
+            }
+        }
+    }
+}
+
+template <typename Test>
+void Bvh::Collect(const Test& test, DynamicArray<uint32>& objects) const
+{
+    if (m_leafObjects.IsEmpty() || !test(m_bounds))
+    {
+        return;
+    }
+    if ((m_root & kLeafBit) != 0)
+    {
+        objects.PushBack(m_leafObjects[0]);
+        return;
+    }
+
+    uint32 stack[kStackSize];
+    uint32 stack_size = 0;
+    stack[stack_size++] = m_root;
+
+    while (stack_size > 0)
+    {
+        const Node& node = m_nodes[stack[--stack_size]];
+        for (uint32 side = 0; side < 2; ++side)
+        {
+            if (!test(node.childBounds[side]))
+            {
+                continue;
+            }
+
+            const uint32 child = node.children[side];
+            if ((child & kLeafBit) != 0)
+            {
+                objects.PushBack(m_leafObjects[child & ~kLeafBit]);
+            }
+            else
+            {
+                rsblAssert(stack_size < kStackSize);
+                stack[stack_size++] = child;
+            }
+        }
+    }
+}
+
+void Bvh::QueryRay(const Ray& ray, float tMax, DynamicArray<uint32>& objects) const
+{
+    const RaySetup setup = SetupRay(ray);
+    Collect(
+        [&setup, tMax](const Aabb& box) {
+            float entry = 0.0f;
+            return RayHitsBox(setup, box, tMax, entry);
+        },
+        objects);
+}
+
+uint32 Bvh::Raycast(const Ray& ray, float& tMax,
+                    const Function<float(uint32 object, float tMax)>& hit) const
+{
+    uint32 closest = kNoObject;
+    const RaySetup setup = SetupRay(ray);
+    float root_entry = 0.0f;
+    if (m_leafObjects.IsEmpty() || !RayHitsBox(setup, m_bounds, tMax, root_entry))
+    {
+        return closest;
+    }
+
+    // Children are pushed far one first, so the near one is walked first
+    struct Entry
+    {
+        uint32 child;
+        float entry;
+    };
+    Entry stack[kStackSize];
+    uint32 stack_size = 0;
+    stack[stack_size++] = Entry{m_root, root_entry};
+
+    while (stack_size > 0)
+    {
+        const Entry entry = stack[--stack_size];
+        if (entry.entry > tMax)
+        {
+            // A closer hit turned up since this was pushed
+            continue;
+        }
+
+        if ((entry.child & kLeafBit) != 0)
+        {
+            const uint32 object = m_leafObjects[entry.child & ~kLeafBit];
+            const float distance = hit(object, tMax);
+            if (distance < tMax)
+            {
+                tMax = distance;
+                closest = object;
+            }
+            continue;
+        }
+
+        const Node& node = m_nodes[entry.child];
+        float entries[2];
+        const bool hits[2] = {
+            RayHitsBox(setup, node.childBounds[0], tMax, entries[0]),
+            RayHitsBox(setup, node.childBounds[1], tMax, entries[1]),
+        };
+        const uint32 near = !hits[0] || (hits[1] && entries[1] < entries[0]) ? 1 : 0;
+        const uint32 far = near ^ 1;
+        rsblAssert(stack_size + 2 <= kStackSize);
+        if (hits[far])
+        {
+            stack[stack_size++] = Entry{node.children[far], entries[far]};
+        }
+        if (hits[near])
+        {
+            stack[stack_size++] = Entry{node.children[near], entries[near]};
+        }
+    }
+    return closest;
+}
+
+void Bvh::RaycastPacket(const Ray* rays,
+                        uint32 count,
+                        float* tMax,
+                        uint32* objects,
+                        const Function<void(uint32 object, uint32 lanes, float* tMax)>& hit) const
+{
+    rsblAssert(count >= 1 && count <= kRayPacketWidth);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        objects[i] = kNoObject;
+    }
+    if (m_leafObjects.IsEmpty())
+    {
+        return;
+    }
+
+    // Lanes past count repeat the first ray with a tMax nothing passes
+    float lanes[7][kRayPacketWidth];
+    for (uint32 i = 0; i < kRayPacketWidth; ++i)
+    {
+        const Ray& ray = rays[i < count ? i : 0];
+        lanes[0][i] = ray.origin.x;
+        lanes[1][i] = ray.origin.y;
+        lanes[2][i] = ray.origin.z;
+        lanes[3][i] = PacketInverse(ray.direction.x);
+        lanes[4][i] = PacketInverse(ray.direction.y);
+        lanes[5][i] = PacketInverse(ray.direction.z);
+        lanes[6][i] = i < count ? tMax[i] : -1.0f;
+    }
+    PacketSetup setup;
+    setup.origin = simd::Vec3xN<kRayPacketWidth>::LoadUnaligned(lanes[0], lanes[1], lanes[2]);
+    setup.inverseDirection =
+        simd::Vec3xN<kRayPacketWidth>::LoadUnaligned(lanes[3], lanes[4], lanes[5]);
+    float* limits = lanes[6];
+    RayLanes limit = RayLanes::LoadUnaligned(limits);
+
+    // Children are pushed far one first, with the rays that meet them and where
+    struct Entry
+    {
+        RayLanes entry;
+        uint32 child;
+        uint32 lanes;
+    };
+    Entry stack[kStackSize];
+    uint32 stack_size = 0;
+    RayLanes root_entry;
+    const uint32 root_lanes = PacketHitsBox(setup, m_bounds, limit, root_entry);
+    if (root_lanes == 0)
+    {
+        return;
+    }
+    stack[stack_size++] = Entry{root_entry, m_root, root_lanes};
+
+    while (stack_size > 0)
+    {
+        const Entry entry = stack[--stack_size];
+        // Rays with a closer hit since this was pushed drop out
+        const uint32 active = entry.lanes & simd::ToBits(entry.entry <= limit);
+        if (active == 0)
+        {
+            continue;
+        }
+
+        if ((entry.child & kLeafBit) != 0)
+        {
+            const uint32 object = m_leafObjects[entry.child & ~kLeafBit];
+            float before[kRayPacketWidth];
+            memcpy(before, limits, sizeof(before));
+            hit(object, active, limits);
+            for (uint32 i = 0; i < count; ++i)
+            {
+                if (limits[i] < before[i])
+                {
+                    objects[i] = object;
+                }
+            }
+            limit = RayLanes::LoadUnaligned(limits);
+            continue;
+        }
+
+        const Node& node = m_nodes[entry.child];
+        RayLanes entries[2];
+        const uint32 hits[2] = {
+            PacketHitsBox(setup, node.childBounds[0], limit, entries[0]) & active,
+            PacketHitsBox(setup, node.childBounds[1], limit, entries[1]) & active,
+        };
+        // Nearer for the first ray that meets both
+        const uint32 both = hits[0] & hits[1];
+        const uint32 lane = CountTrailingZeros32(both != 0 ? both : 1);
+        const uint32 near =
+            hits[0] == 0 || (both != 0 && entries[1].Lane(lane) < entries[0].Lane(lane)) ? 1 : 0;
+        const uint32 far = near ^ 1;
+        rsblAssert(stack_size + 2 <= kStackSize);
+        if (hits[far] != 0)
+        {
+            stack[stack_size++] = Entry{entries[far], node.children[far], hits[far]};
+        }
+        if (hits[near] != 0)
+        {
+            stack[stack_size++] = Entry{entries[near], node.children[near], hits[near]};
+        }
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        tMax[i] = limits[i];
+    }
+}
+
+void Bvh::QueryOverlap(const Aabb& box, DynamicArray<uint32>& objects) const
+{
+    Collect([&box](const Aabb& node) { return BoxesOverlap(box, node); }, objects);
+}
+
+void Bvh::QueryOverlap(const Sphere& sphere, DynamicArray<uint32>& objects) const
+{
+    Collect([&sphere](const Aabb& node) { return SphereOverlapsBox(sphere, node); }, objects);
+}
+
+} // namespace rsbl
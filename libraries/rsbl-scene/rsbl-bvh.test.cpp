@@ -0,0 +1,450 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-bvh.h"
+
+#include <rsbl-sort.h>
+
+#include <cmath>
+
+using namespace rsbl;
+
+namespace
+{
+// Left-handed perspective looking down +z, 90 degree vertical fov, aspect 2
+simd::float4x4 MakePerspective(float nearZ, float farZ)
+{
+    const float aspect = 2.0f;
+    const float z_scale = farZ / (farZ - nearZ);
+    const float z_offset = -nearZ * farZ / (farZ - nearZ);
+    return simd::float4x4(simd::float4(1.0f / aspect, 0.0f, 0.0f, 0.0f),
+                          simd::float4(0.0f, 1.0f, 0.0f, 0.0f),
+                          simd::float4(0.0f, 0.0f, z_scale, 1.0f),
+                          simd::float4(0.0f, 0.0f, z_offset, 0.0f));
+}
+
+struct Random
+{
+    uint64 state = 1;
+
+    // [0, 1)
+    float Next()
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<float>(state >> 40) / static_cast<float>(1 << 24);
+    }
+};
+
+// Boxes scattered around the origin, some overlapping, a few duplicates
+DynamicArray<Aabb> MakeScene(uint32 count, uint64 seed)
+{
+    Random random{seed};
+    DynamicArray<Aabb> boxes;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (i % 50 == 7)
+        {
+            // Same box as an earlier object, so Morton codes collide
+            const Aabb duplicate = boxes[i / 2];
+            boxes.PushBack(duplicate);
+            continue;
+        }
+        const simd::float4 center(random.Next() * 200.0f - 100.0f, random.Next() * 100.0f - 50.0f,
+                                  random.Next() * 200.0f - 50.0f, 0.0f);
+        const simd::float4 extents(random.Next() * 3.0f, random.Next() * 3.0f,
+                                   random.Next() * 3.0f, 0.0f);
+        boxes.PushBack(Aabb{simd::ToFloat3(center - extents), simd::ToFloat3(center + extents)});
+    }
+    return boxes;
+}
+
+void MoveScene(DynamicArray<Aabb>& boxes, float offset)
+{
+    for (uint32 i = 0; i < boxes.Size(); ++i)
+    {
+        const float shift = (i % 3 == 0) ? offset : -offset * 0.5f;
+        boxes[i].min.x += shift;
+        boxes[i].max.x += shift;
+        boxes[i].min.z -= shift;
+        boxes[i].max.z -= shift;
+    }
+}
+
+bool BruteForceRayHit(const Ray& ray, const Aabb& box, float tMax)
+{
+    float entry = 0.0f;
+    float exit = tMax;
+    const float origin[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+    const float direction[3] = {ray.direction.x, ray.direction.y, ray.direction.z};
+    const float min[3] = {box.min.x, box.min.y, box.min.z};
+    const float max[3] = {box.max.x, box.max.y, box.max.z};
+    for (uint32 axis = 0; axis < 3; ++axis)
+    {
+        if (direction[axis] == 0.0f)
+        {
+            if (origin[axis] < min[axis] || origin[axis] > max[axis])
+            {
+                return false;
+            }
+            continue;
+        }
+        float near = (min[axis] - origin[axis]) / direction[axis];
+        float far = (max[axis] - origin[axis]) / direction[axis];
+        if (near > far)
+        {
+            const float swap = near;
+            near = far;
+            far = swap;
+        }
+        entry = near > entry ? near : entry;
+        exit = far < exit ? far : exit;
+    }
+    return entry <= exit;
+}
+
+// Sorted, so results from different walks compare directly
+DynamicArray<uint32> Sorted(DynamicArray<uint32> objects)
+{
+    RadixSort(ArrayView<uint32>(objects));
+    return objects;
+}
+
+// Every leaf is reached once, and every node box holds its children
+void CheckTree(const Bvh& bvh, ArrayView<const Aabb> boxes)
+{
+    DynamicArray<uint32> everything;
+    bvh.QueryOverlap(Aabb{float3(-1e30f), float3(1e30f)}, everything);
+    REQUIRE(everything.Size() == boxes.Size());
+    everything = Sorted(rsblMove(everything));
+    for (uint32 i = 0; i < everything.Size(); ++i)
+    {
+        REQUIRE(everything[i] == i);
+    }
+
+    const Aabb root = bvh.Bounds();
+    for (const Aabb& box : boxes)
+    {
+        REQUIRE(root.min.x <= box.min.x);
+        REQUIRE(root.min.y <= box.min.y);
+        REQUIRE(root.min.z <= box.min.z);
+        REQUIRE(root.max.x >= box.max.x);
+        REQUIRE(root.max.y >= box.max.y);
+        REQUIRE(root.max.z >= box.max.z);
+    }
+}
+
+void CheckQueries(const Bvh& bvh, ArrayView<const Aabb> boxes)
+{
+    // Frustum: exactly the boxes Intersects accepts
+    const Frustum frustum = FrustumFromViewProjection(MakePerspective(1.0f, 80.0f));
+    DynamicBitSet visible;
+    bvh.CullFrustum(frustum, visible);
+    REQUIRE(visible.Size() == boxes.Size());
+    uint64 visible_count = 0;
+    for (uint32 i = 0; i < boxes.Size(); ++i)
+    {
+        CAPTURE(i);
+        REQUIRE(visible.Test(i) == Intersects(frustum, boxes[i]));
+        visible_count += visible.Test(i) ? 1 : 0;
+    }
+    // The scene is set up with some of each
+    CHECK(visible_count > 0);
+    CHECK(visible_count < boxes.Size());
+
+    // Overlaps
+    const Aabb query_box{float3(-20.0f, -10.0f, 0.0f), float3(15.0f, 10.0f, 30.0f)};
+    const Sphere query_sphere{float3(10.0f, 0.0f, 40.0f), 25.0f};
+    DynamicArray<uint32> box_hits;
+    DynamicArray<uint32> sphere_hits;
+    bvh.QueryOverlap(query_box, box_hits);
+    bvh.QueryOverlap(query_sphere, sphere_hits);
+    DynamicArray<uint32> expected_box;
+    DynamicArray<uint32> expected_sphere;
+    for (uint32 i = 0; i < boxes.Size(); ++i)
+    {
+        const Aabb& b = boxes[i];
+        if (b.min.x <= query_box.max.x && query_box.min.x <= b.max.x &&
+            b.min.y <= query_box.max.y && query_box.min.y <= b.max.y &&
+            b.min.z <= query_box.max.z && query_box.min.z <= b.max.z)
+        {
+            expected_box.PushBack(i);
+        }
+        const float dx = fmaxf(fmaxf(b.min.x - query_sphere.center.x, 0.0f),
+                               query_sphere.center.x - b.max.x);
+        const float dy = fmaxf(fmaxf(b.min.y - query_sphere.center.y, 0.0f),
+                               query_sphere.center.y - b.max.y);
+        const float dz = fmaxf(fmaxf(b.min.z - query_sphere.center.z, 0.0f),
+                               query_sphere.center.z - b.max.z);
+        if (dx * dx + dy * dy + dz * dz <= query_sphere.radius * query_sphere.radius)
+        {
+            expected_sphere.PushBack(i);
+        }
+    }
+    CHECK(expected_box.Size() > 0);
+    CHECK(expected_sphere.Size() > 0);
+    box_hits = Sorted(rsblMove(box_hits));
+    sphere_hits = Sorted(rsblMove(sphere_hits));
+    REQUIRE(box_hits.Size() == expected_box.Size());
+    REQUIRE(sphere_hits.Size() == expected_sphere.Size());
+    for (uint32 i = 0; i < box_hits.Size(); ++i)
+    {
+        REQUIRE(box_hits[i] == expected_box[i]);
+    }
+    for (uint32 i = 0; i < sphere_hits.Size(); ++i)
+    {
+        REQUIRE(sphere_hits[i] == expected_sphere[i]);
+    }
+
+    // Rays, including ones along an axis
+    const Ray rays[] = {
+        Ray{float3(-120.0f, 0.0f, 50.0f), float3(1.0f, 0.0f, 0.0f)},
+        Ray{float3(0.0f, 0.0f, -60.0f), float3(0.1f, 0.05f, 1.0f)},
+        Ray{float3(30.0f, 60.0f, 30.0f), float3(0.0f, -1.0f, 0.0f)},
+        Ray{float3(100.0f, 50.0f, 150.0f), float3(-1.0f, -0.5f, -1.0f)},
+    };
+    for (const Ray& ray : rays)
+    {
+        const float t_max = 300.0f;
+        DynamicArray<uint32> hits;
+        bvh.QueryRay(ray, t_max, hits);
+        hits = Sorted(rsblMove(hits));
+
+        DynamicArray<uint32> expected;
+        for (uint32 i = 0; i < boxes.Size(); ++i)
+        {
+            if (BruteForceRayHit(ray, boxes[i], t_max))
+            {
+                expected.PushBack(i);
+            }
+        }
+        REQUIRE(hits.Size() == expected.Size());
+        for (uint32 i = 0; i < hits.Size(); ++i)
+        {
+            REQUIRE(hits[i] == expected[i]);
+        }
+
+        // Closest hit against the boxes themselves, each with a distinct entry distance
+        auto box_entry = [&](uint32 object, float tMax) {
+            const Aabb& box = boxes[object];
+            for (float t = 0.0f; t < tMax; t += 0.01f)
+            {
+                const float x = ray.origin.x + ray.direction.x * t;
+                const float y = ray.origin.y + ray.direction.y * t;
+                const float z = ray.origin.z + ray.direction.z * t;
+                if (x >= box.min.x && x <= box.max.x && y >= box.min.y && y <= box.max.y &&
+                    z >= box.min.z && z <= box.max.z)
+                {
+                    return t;
+                }
+            }
+            return tMax;
+        };
+        uint32 expected_closest = Bvh::kNoObject;
+        float expected_t = t_max;
+        for (const uint32 object : expected)
+        {
+            const float t = box_entry(object, expected_t);
+            if (t < expected_t)
+            {
+                expected_t = t;
+                expected_closest = object;
+            }
+        }
+
+        uint32 calls = 0;
+        float t = t_max;
+        const uint32 closest = bvh.Raycast(ray, t, [&](uint32 object, float tMax) {
+            calls++;
+            return box_entry(object, tMax);
+        });
+        // Duplicate boxes tie, so compare distances rather than objects
+        CHECK(t == expected_t);
+        CHECK((closest == Bvh::kNoObject) == (expected_closest == Bvh::kNoObject));
+        if (closest != Bvh::kNoObject)
+        {
+            CHECK(box_entry(closest, t_max) == t);
+        }
+        // Nearest first means far boxes are mostly skipped
+        CHECK(calls <= expected.Size());
+    }
+
+    // The rays walked as packets find the boxes one at a time does
+    const auto box_entry = [&boxes](const Ray& ray, uint32 object, float tMax) {
+        const float origin[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+        const float direction[3] = {ray.direction.x, ray.direction.y, ray.direction.z};
+        const float min[3] = {boxes[object].min.x, boxes[object].min.y, boxes[object].min.z};
+        const float max[3] = {boxes[object].max.x, boxes[object].max.y, boxes[object].max.z};
+        float entry = 0.0f;
+        float exit = tMax;
+        for (uint32 axis = 0; axis < 3; ++axis)
+        {
+            if (direction[axis] == 0.0f)
+            {
+                if (origin[axis] < min[axis] || origin[axis] > max[axis])
+                {
+                    return tMax;
+                }
+                continue;
+            }
+            float near = (min[axis] - origin[axis]) / direction[axis];
+            float far = (max[axis] - origin[axis]) / direction[axis];
+            if (near > far)
+            {
+                const float swap = near;
+                near = far;
+                far = swap;
+            }
+            entry = near > entry ? near : entry;
+            exit = far < exit ? far : exit;
+        }
+        return entry <= exit ? entry : tMax;
+    };
+    for (uint32 count = 1; count <= kRayPacketWidth; ++count)
+    {
+        float t_max[kRayPacketWidth];
+        uint32 closest[kRayPacketWidth];
+        for (uint32 i = 0; i < count; ++i)
+        {
+            t_max[i] = 300.0f;
+        }
+        bvh.RaycastPacket(rays, count, t_max, closest, [&](uint32 object, uint32 lanes, float* t) {
+            CHECK(lanes != 0);
+            CHECK(lanes < (1u << count));
+            for (uint32 i = 0; i < count; ++i)
+            {
+                if ((lanes & (1u << i)) != 0)
+                {
+                    const float entry = box_entry(rays[i], object, t[i]);
+                    t[i] = entry < t[i] ? entry : t[i];
+                }
+            }
+        });
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float t = 300.0f;
+            const uint32 expected = bvh.Raycast(rays[i], t, [&](uint32 object, float tMax) {
+                return box_entry(rays[i], object, tMax);
+            });
+            CHECK(t_max[i] == t);
+            CHECK((closest[i] == Bvh::kNoObject) == (expected == Bvh::kNoObject));
+        }
+    }
+}
+} // namespace
+
+TEST_SUITE("rsbl::Bvh")
+{
+    TEST_CASE("Empty and single object")
+    {
+        Bvh bvh;
+        bvh.Build(ArrayView<const Aabb>());
+        CHECK(bvh.ObjectCount() == 0);
+        CHECK(bvh.Bounds().min.x > bvh.Bounds().max.x);
+
+        DynamicBitSet visible(3, true);
+        const Frustum frustum = FrustumFromViewProjection(MakePerspective(1.0f, 80.0f));
+        bvh.CullFrustum(frustum, visible);
+        CHECK(visible.Size() == 0);
+        DynamicArray<uint32> hits;
+        bvh.QueryOverlap(Sphere{float3(0.0f), 1e30f}, hits);
+        CHECK(hits.IsEmpty());
+        float t = 100.0f;
+        CHECK(bvh.Raycast(Ray{float3(0.0f), float3(0.0f, 0.0f, 1.0f)}, t,
+                          [](uint32, float) { return 0.0f; }) == Bvh::kNoObject);
+
+        const Aabb box{float3(-1.0f, -1.0f, 10.0f), float3(1.0f, 1.0f, 12.0f)};
+        bvh.Build(ArrayView<const Aabb>(&box, 1));
+        CHECK(bvh.ObjectCount() == 1);
+        CHECK(bvh.Bounds().max.z == 12.0f);
+        bvh.CullFrustum(frustum, visible);
+        CHECK(visible.Size() == 1);
+        CHECK(visible.Test(0));
+        bvh.QueryRay(Ray{float3(0.0f), float3(0.0f, 0.0f, 1.0f)}, 100.0f, hits);
+        CHECK(hits.Size() == 1);
+
+        // Moves behind the camera
+        const Aabb moved{float3(-1.0f, -1.0f, -12.0f), float3(1.0f, 1.0f, -10.0f)};
+        bvh.Refit(ArrayView<const Aabb>(&moved, 1));
+        bvh.CullFrustum(frustum, visible);
+        CHECK_FALSE(visible.Test(0));
+    }
+
+    TEST_CASE("Queries match brute force")
+    {
+        for (const uint32 count : {2u, 3u, 17u, 1000u, 5000u})
+        {
+            CAPTURE(count);
+            const DynamicArray<Aabb> boxes = MakeScene(count, count);
+            Bvh bvh;
+            bvh.Build(boxes);
+            CHECK(bvh.ObjectCount() == count);
+            CheckTree(bvh, boxes);
+            if (count >= 1000)
+            {
+                CheckQueries(bvh, boxes);
+            }
+        }
+    }
+
+    TEST_CASE("Identical boxes")
+    {
+        // Every Morton code is the same, the tree splits on the object index alone
+        DynamicArray<Aabb> boxes;
+        for (uint32 i = 0; i < 300; ++i)
+        {
+            boxes.PushBack(Aabb{float3(1.0f, 2.0f, 3.0f), float3(2.0f, 3.0f, 4.0f)});
+        }
+        Bvh bvh;
+        bvh.Build(boxes);
+        CheckTree(bvh, boxes);
+
+        DynamicArray<uint32> hits;
+        bvh.QueryOverlap(Aabb{float3(1.5f, 2.5f, 3.5f), float3(1.6f, 2.6f, 3.6f)}, hits);
+        CHECK(hits.Size() == 300);
+    }
+
+    TEST_CASE("Refit after objects move")
+    {
+        DynamicArray<Aabb> boxes = MakeScene(5000, 11);
+        Bvh bvh;
+        bvh.Build(boxes);
+
+        for (uint32 frame = 1; frame <= 3; ++frame)
+        {
+            MoveScene(boxes, 5.0f * static_cast<float>(frame));
+            bvh.Refit(boxes);
+            CheckTree(bvh, boxes);
+            CheckQueries(bvh, boxes);
+        }
+    }
+
+    TEST_CASE("Threaded build and refit match the single threaded ones")
+    {
+        DynamicArray<Aabb> boxes = MakeScene(20000, 5);
+        Bvh single;
+        single.Build(boxes);
+        Bvh threaded;
+        threaded.Build(boxes, BvhBuildOptions{4});
+        CheckTree(threaded, boxes);
+
+        const Aabb query{float3(-30.0f, -20.0f, 0.0f), float3(30.0f, 20.0f, 50.0f)};
+        DynamicArray<uint32> single_hits;
+        DynamicArray<uint32> threaded_hits;
+        single.QueryOverlap(query, single_hits);
+        threaded.QueryOverlap(query, threaded_hits);
+        REQUIRE(single_hits.Size() == threaded_hits.Size());
+        for (uint32 i = 0; i < single_hits.Size(); ++i)
+        {
+            // Same tree, so the same walk order
+            REQUIRE(single_hits[i] == threaded_hits[i]);
+        }
+
+        MoveScene(boxes, 3.0f);
+        threaded.Refit(boxes, 4);
+        CheckTree(threaded, boxes);
+        CheckQueries(threaded, boxes);
+    }
+}
@@ -0,0 +1,371 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-ecs.h"
+
+#include "include/rsbl-animation.h"
+
+#include <rsbl-bits.h>
+#include <rsbl-jobs.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+// Written once each, before the type's ID is handed out
+uint32 g_componentSizes[kMaxComponentTypes];
+std::atomic<uint32> g_componentTypeCount{0};
+
+constexpr uint16 kNoColumn = Internal::EntityArchetype::kNoColumn;
+
+// Calls func(type) for every type in the mask, lowest ID first
+template <typename Func>
+void ForEachType(ComponentMask mask, const Func& func)
+{
+    for (uint64 bits = mask.bits; bits != 0; bits &= bits - 1)
+    {
+        func(CountTrailingZeros64(bits));
+    }
+}
+
+// Bytes a chunk of capacity rows takes, filling in where each column starts
+uint64 ChunkLayout(ComponentMask mask, uint32 capacity, uint16 (&columns)[kMaxComponentTypes])
+{
+    for (uint16& column : columns)
+    {
+        column = kNoColumn;
+    }
+    uint64 size = sizeof(Entity) * uint64(capacity);
+    ForEachType(mask, [&](uint32 type) {
+        size = AlignUp(size, kSoaAlignment);
+        columns[type] = static_cast<uint16>(size < kNoColumn ? size : kNoColumn);
+        size += uint64(g_componentSizes[type]) * capacity;
+    });
+    return size;
+}
+
+// Copies a row's components of the types in mask, and its entity, from one chunk to another
+void CopyRow(ComponentMask mask,
+             const uint16 (&columns)[kMaxComponentTypes],
+             uint8* dst,
+             uint32 dstIndex,
+             const uint8* src,
+             uint32 srcIndex)
+{
+    memcpy(dst + sizeof(Entity) * dstIndex, src + sizeof(Entity) * srcIndex, sizeof(Entity));
+    ForEachType(mask, [&](uint32 type) {
+        const uint32 size = g_componentSizes[type];
+        memcpy(dst + columns[type] + size * dstIndex, src + columns[type] + size * srcIndex, size);
+    });
+}
+} // namespace
+
+uint32 Internal::RegisterComponentType(uint32 size)
+{
+    const uint32 type = g_componentTypeCount.fetch_add(1, std::memory_order_relaxed);
+    rsblVerifyMsg(type < kMaxComponentTypes, "Too many component types");
+    g_componentSizes[type] = size;
+    return type;
+}
+
+EntityWorld::EntityWorld()
+{
+    // The archetype with nothing, for Create()
+    FindOrCreateArchetype(ComponentMask{});
+}
+
+EntityWorld::~EntityWorld()
+{
+    Allocator* allocator = GetTaggedAllocator(MemoryTag::Scene);
+    for (Internal::EntityArchetype& archetype : m_archetypes)
+    {
+        for (uint8* chunk : archetype.chunks)
+        {
+            allocator->Free(chunk, kChunkSize, kSoaAlignment);
+        }
+    }
+}
+
+Entity EntityWorld::CreateEntity(ComponentMask mask)
+{
+    rsblAssertMsg(m_iterating == 0, "Entities can't be created while a query walks the world");
+    const uint32 archetype = FindOrCreateArchetype(mask);
+    const Entity entity = m_entities.Emplace();
+    *m_entities.Get(entity) = AppendRow(archetype, entity);
+    return entity;
+}
+
+bool EntityWorld::Destroy(Entity entity)
+{
+    const Internal::EntityLocation* location = m_entities.Get(entity);
+    if (location == nullptr)
+    {
+        return false;
+    }
+    rsblAssertMsg(m_iterating == 0, "Entities can't be destroyed while a query walks the world");
+    RemoveRow(*location);
+    m_entities.Remove(entity);
+    return true;
+}
+
+bool EntityWorld::ChangeComponents(Entity entity, ComponentMask add, ComponentMask remove)
+{
+    const Internal::EntityLocation* location = m_entities.Get(entity);
+    if (location == nullptr)
+    {
+        return false;
+    }
+
+    const Internal::EntityLocation from = *location;
+    const ComponentMask from_mask = m_archetypes[from.archetype].mask;
+    const ComponentMask to_mask{(from_mask.bits | add.bits) & ~remove.bits};
+    if (to_mask == from_mask)
+    {
+        return true;
+    }
+    rsblAssertMsg(m_iterating == 0, "Components can't be added or removed while a query walks");
+
+    // Whatever the two have in common moves over, the column offsets differ between them
+    const Internal::EntityLocation to = AppendRow(FindOrCreateArchetype(to_mask), entity);
+    const Internal::EntityArchetype& source = m_archetypes[from.archetype];
+    const Internal::EntityArchetype& target = m_archetypes[to.archetype];
+    const uint8* src = RowChunk(from);
+    uint8* dst = RowChunk(to);
+    const uint32 src_index = from.row % source.capacity;
+    const uint32 dst_index = to.row % target.capacity;
+    ForEachType(ComponentMask{from_mask.bits & to_mask.bits}, [&](uint32 type) {
+        const uint32 size = g_componentSizes[type];
+        memcpy(dst + target.columns[type] + size * dst_index,
+               src + source.columns[type] + size * src_index,
+               size);
+    });
+
+    RemoveRow(from);
+    *m_entities.Get(entity) = to;
+    return true;
+}
+
+uint32 EntityWorld::FindOrCreateArchetype(ComponentMask mask)
+{
+    if (const uint32* found = m_archetypeOfMask.Find(mask.bits))
+    {
+        return *found;
+    }
+
+    Internal::EntityArchetype& archetype = m_archetypes.EmplaceBack();
+    archetype.mask = mask;
+
+    // As many rows as fit, less what aligning the columns takes
+    uint64 row_size = sizeof(Entity);
+    ForEachType(mask, [&](uint32 type) { row_size += g_componentSizes[type]; });
+    uint32 capacity = static_cast<uint32>(kChunkSize / row_size);
+    while (capacity > 0 && ChunkLayout(mask, capacity, archetype.columns) > kChunkSize)
+    {
+        --capacity;
+    }
+    rsblVerifyMsg(capacity > 0, "An entity's components don't fit in a chunk");
+    archetype.capacity = capacity;
+
+    const uint32 index = static_cast<uint32>(m_archetypes.Size() - 1);
+    m_archetypeOfMask.Insert(mask.bits, index);
+    return index;
+}
+
+Internal::EntityLocation EntityWorld::AppendRow(uint32 archetype, Entity entity)
+{
+    Internal::EntityArchetype& target = m_archetypes[archetype];
+    if (target.count == target.chunks.Size() * target.capacity)
+    {
+        uint8* chunk = static_cast<uint8*>(
+            GetTaggedAllocator(MemoryTag::Scene)->Allocate(kChunkSize, kSoaAlignment));
+        rsblVerifyMsg(chunk != nullptr, "Failed to allocate an entity chunk");
+        target.chunks.PushBack(chunk);
+    }
+
+    const Internal::EntityLocation location{archetype, static_cast<uint32>(target.count++)};
+    memcpy(RowChunk(location) + sizeof(Entity) * (location.row % target.capacity),
+           &entity,
+           sizeof(Entity));
+    return location;
+}
+
+void EntityWorld::RemoveRow(const Internal::EntityLocation& location)
+{
+    Internal::EntityArchetype& source = m_archetypes[location.archetype];
+    const uint32 last = static_cast<uint32>(source.count - 1);
+    if (location.row != last)
+    {
+        const Internal::EntityLocation last_location{location.archetype, last};
+        uint8* hole = RowChunk(location);
+        const uint8* moved = RowChunk(last_location);
+        CopyRow(source.mask,
+                source.columns,
+                hole,
+                location.row % source.capacity,
+                moved,
+                last % source.capacity);
+
+        Entity moved_entity;
+        memcpy(&moved_entity,
+               hole + sizeof(Entity) * (location.row % source.capacity),
+               sizeof(Entity));
+        m_entities.Get(moved_entity)->row = location.row;
+    }
+
+    --source.count;
+    if (source.count == (source.chunks.Size() - 1) * source.capacity)
+    {
+        GetTaggedAllocator(MemoryTag::Scene)
+            ->Free(source.chunks[source.chunks.Size() - 1], kChunkSize, kSoaAlignment);
+        source.chunks.PopBack();
+    }
+}
+
+uint8* EntityWorld::RowChunk(const Internal::EntityLocation& location) const
+{
+    const Internal::EntityArchetype& archetype = m_archetypes[location.archetype];
+    return archetype.chunks[location.row / archetype.capacity];
+}
+
+void* EntityWorld::ComponentData(const Internal::EntityLocation& location, uint32 type) const
+{
+    const Internal::EntityArchetype& archetype = m_archetypes[location.archetype];
+    const uint16 column = archetype.columns[type];
+    if (column == kNoColumn)
+    {
+        return nullptr;
+    }
+    return RowChunk(location) + column +
+           uint64(g_componentSizes[type]) * (location.row % archetype.capacity);
+}
+
+EntityQuery::EntityQuery(EntityWorld& world, ComponentMask with, ComponentMask without)
+    : m_world(&world)
+    , m_with(with)
+    , m_without(without)
+{
+}
+
+void EntityQuery::Refresh()
+{
+    // Archetypes are never removed, so the ones checked already stay matched or not
+    const uint32 archetype_count = m_world->ArchetypeCount();
+    for (; m_archetypesChecked < archetype_count; ++m_archetypesChecked)
+    {
+        const ComponentMask mask = m_world->Archetype(m_archetypesChecked).mask;
+        if (mask.Contains(m_with) && !mask.Overlaps(m_without))
+        {
+            m_archetypes.PushBack(m_archetypesChecked);
+        }
+    }
+}
+
+void EntityQuery::ForEachChunk(FunctionRef<void(const EntityChunk&)> body)
+{
+    Refresh();
+    ++m_world->m_iterating;
+    for (const uint32 index : m_archetypes)
+    {
+        const Internal::EntityArchetype& archetype = m_world->Archetype(index);
+        for (uint32 chunk = 0; chunk < archetype.chunks.Size(); ++chunk)
+        {
+            body(EntityChunk(&archetype, archetype.chunks[chunk], archetype.ChunkCount(chunk)));
+        }
+    }
+    --m_world->m_iterating;
+}
+
+void EntityQuery::ParallelForEachChunk(JobSystem& jobs,
+                                       FunctionRef<void(const EntityChunk&)> body,
+                                       uint64 grain)
+{
+    Refresh();
+    m_chunks.Clear();
+    for (const uint32 index : m_archetypes)
+    {
+        const uint32 chunk_count = static_cast<uint32>(m_world->Archetype(index).chunks.Size());
+        for (uint32 chunk = 0; chunk < chunk_count; ++chunk)
+        {
+            m_chunks.PushBack(ChunkRef{index, chunk});
+        }
+    }
+
+    ++m_world->m_iterating;
+    jobs.ParallelFor(0, m_chunks.Size(), grain, [this, body](uint64 begin, uint64 end) {
+        for (uint64 i = begin; i < end; ++i)
+        {
+            const Internal::EntityArchetype& archetype = m_world->Archetype(m_chunks[i].archetype);
+            const uint32 chunk = m_chunks[i].chunk;
+            body(EntityChunk(&archetype, archetype.chunks[chunk], archetype.ChunkCount(chunk)));
+        }
+    });
+    --m_world->m_iterating;
+}
+
+uint64 EntityQuery::EntityCount()
+{
+    Refresh();
+    uint64 count = 0;
+    for (const uint32 index : m_archetypes)
+    {
+        count += m_world->Archetype(index).count;
+    }
+    return count;
+}
+
+void UpdateEntityTransforms(EntityWorld& world, JobSystem& jobs)
+{
+    EntityQuery query(world, ComponentMaskOf<SceneTransform, WorldTransform>());
+    query.ParallelForEachChunk(jobs, [](const EntityChunk& chunk) {
+        const SceneTransform* locals = chunk.Field<SceneTransform>().Data();
+        WorldTransform* worlds = chunk.Field<WorldTransform>().Data();
+        for (uint32 i = 0; i < chunk.Count(); ++i)
+        {
+            worlds[i].matrix =
+                simd::ComposeTrs(locals[i].translation, locals[i].rotation, locals[i].scale);
+        }
+
+        const LocalBounds* local_bounds = chunk.Data<LocalBounds>();
+        WorldBounds* world_bounds = chunk.Data<WorldBounds>();
+        if (local_bounds != nullptr && world_bounds != nullptr)
+        {
+            for (uint32 i = 0; i < chunk.Count(); ++i)
+            {
+                world_bounds[i].box = TransformAabb(local_bounds[i].box, worlds[i].matrix);
+            }
+        }
+    });
+}
+
+void AdvanceAnimations(EntityWorld& world, JobSystem& jobs, float seconds)
+{
+    EntityQuery query(world, ComponentMaskOf<AnimationState>());
+    query.ParallelForEachChunk(jobs, [seconds](const EntityChunk& chunk) {
+        for (AnimationState& state : chunk.Field<AnimationState>())
+        {
+            if (state.clip == nullptr)
+            {
+                continue;
+            }
+
+            const float duration = state.clip->Duration();
+            const float time = state.time + seconds * state.speed;
+            if (state.loop && duration > 0.0f)
+            {
+                const float wrapped = std::fmod(time, duration);
+                state.time = wrapped < 0.0f ? wrapped + duration : wrapped;
+            }
+            else
+            {
+                state.time = time < 0.0f ? 0.0f : (time > duration ? duration : time);
+            }
+        }
+    });
+}
+
+} // namespace rsbl
@@ -0,0 +1,250 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-animation.h"
+#include "include/rsbl-ecs.h"
+
+#include <rsbl-jobs.h>
+
+#include <atomic>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+struct Health
+{
+    int32 points = 0;
+};
+
+// Big enough that a chunk holds only a few dozen
+struct Inventory
+{
+    uint32 items[96] = {};
+};
+
+UniquePtr<JobSystem> MakeJobSystem(uint32 workerCount)
+{
+    JobSystemOptions options;
+    options.workerCount = workerCount;
+    Result<UniquePtr<JobSystem>> result = JobSystem::Create(options);
+    REQUIRE(result);
+    return rsblMove(result.Value());
+}
+
+SceneTransform Translation(float x, float y, float z)
+{
+    SceneTransform transform;
+    transform.translation = simd::float4(x, y, z, 0.0f);
+    return transform;
+}
+} // namespace
+
+TEST_SUITE("rsbl::EntityWorld")
+{
+    TEST_CASE("Entities keep their components while others come and go")
+    {
+        EntityWorld world;
+        DynamicArray<Entity> entities;
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            Inventory inventory;
+            inventory.items[95] = i;
+            entities.PushBack(world.Create(MeshRef{i}, Health{static_cast<int32>(i)}, inventory));
+        }
+        CHECK(world.EntityCount() == 1000);
+
+        // Every third one goes, from chunks all over, each hole filled from the end
+        for (uint32 i = 0; i < 1000; i += 3)
+        {
+            CHECK(world.Destroy(entities[i]));
+        }
+        for (uint32 i = 0; i < 1000; ++i)
+        {
+            if (i % 3 == 0)
+            {
+                CHECK_FALSE(world.IsAlive(entities[i]));
+                CHECK(world.Get<MeshRef>(entities[i]) == nullptr);
+                CHECK_FALSE(world.Destroy(entities[i]));
+                continue;
+            }
+            REQUIRE(world.Get<MeshRef>(entities[i]) != nullptr);
+            CHECK(world.Get<MeshRef>(entities[i])->mesh == i);
+            CHECK(world.Get<Health>(entities[i])->points == static_cast<int32>(i));
+            CHECK(world.Get<Inventory>(entities[i])->items[95] == i);
+            CHECK(world.Get<MaterialRef>(entities[i]) == nullptr);
+        }
+        CHECK(world.EntityCount() == 666);
+    }
+
+    TEST_CASE("Adding and removing components moves entities between archetypes")
+    {
+        EntityWorld world;
+        const Entity a = world.Create(MeshRef{1});
+        const Entity b = world.Create(MeshRef{2});
+        const uint32 archetypes = world.ArchetypeCount();
+
+        CHECK(world.Add(a, MaterialRef{7}));
+        CHECK(world.ArchetypeCount() == archetypes + 1);
+        CHECK(world.Has<MaterialRef>(a));
+        CHECK_FALSE(world.Has<MaterialRef>(b));
+        CHECK(world.Get<MeshRef>(a)->mesh == 1);
+        CHECK(world.Get<MaterialRef>(a)->material == 7);
+        // b filled a's old row
+        CHECK(world.Get<MeshRef>(b)->mesh == 2);
+
+        // Adding what it has only overwrites it
+        CHECK(world.Add(a, MaterialRef{8}));
+        CHECK(world.ArchetypeCount() == archetypes + 1);
+        CHECK(world.Get<MaterialRef>(a)->material == 8);
+
+        CHECK(world.Remove<MeshRef>(a));
+        CHECK_FALSE(world.Has<MeshRef>(a));
+        CHECK(world.Get<MaterialRef>(a)->material == 8);
+        // Removing what it doesn't have changes nothing
+        CHECK(world.Remove<MeshRef>(a));
+
+        CHECK(world.Destroy(b));
+        CHECK_FALSE(world.Add(b, MaterialRef{1}));
+        CHECK_FALSE(world.Remove<MeshRef>(b));
+        CHECK(world.EntityCount() == 1);
+    }
+
+    TEST_CASE("Queries see the archetypes that match, including ones made after")
+    {
+        EntityWorld world;
+        world.Create(MeshRef{0});
+        world.Create(MeshRef{1}, MaterialRef{0});
+        world.Create(MeshRef{2}, MaterialRef{0}, Health{5});
+
+        EntityQuery meshes(world, ComponentMaskOf<MeshRef>());
+        EntityQuery drawable(world, ComponentMaskOf<MeshRef, MaterialRef>());
+        EntityQuery unhurt(world, ComponentMaskOf<MeshRef>(), ComponentMaskOf<Health>());
+        CHECK(meshes.EntityCount() == 3);
+        CHECK(drawable.EntityCount() == 2);
+        CHECK(unhurt.EntityCount() == 2);
+
+        const Entity later = world.Create(MeshRef{3}, MaterialRef{1}, LocalBounds{});
+        CHECK(meshes.EntityCount() == 4);
+        CHECK(drawable.EntityCount() == 3);
+        CHECK(unhurt.EntityCount() == 3);
+
+        uint32 mesh_sum = 0;
+        uint32 seen = 0;
+        drawable.ForEachChunk([&](const EntityChunk& chunk) {
+            CHECK(chunk.Mask().Contains(ComponentMaskOf<MeshRef, MaterialRef>()));
+            for (const MeshRef& mesh : chunk.Field<MeshRef>())
+            {
+                mesh_sum += mesh.mesh;
+            }
+            for (const Entity entity : chunk.Entities())
+            {
+                seen += entity == later ? 1 : 0;
+            }
+        });
+        CHECK(mesh_sum == 6);
+        CHECK(seen == 1);
+    }
+
+    TEST_CASE("Chunks split across the jobs cover every entity once")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(4);
+        EntityWorld world;
+        for (uint32 i = 0; i < 20000; ++i)
+        {
+            if (i % 2 == 0)
+            {
+                world.Create(Health{0}, MeshRef{i});
+            }
+            else
+            {
+                world.Create(Health{0}, Inventory{});
+            }
+        }
+
+        EntityQuery query(world, ComponentMaskOf<Health>());
+        std::atomic<uint32> empty_chunks{0};
+        for (uint32 pass = 0; pass < 3; ++pass)
+        {
+            query.ParallelForEachChunk(*jobs, [&](const EntityChunk& chunk) {
+                empty_chunks.fetch_add(chunk.Count() == 0 ? 1 : 0);
+                for (Health& health : chunk.Field<Health>())
+                {
+                    ++health.points;
+                }
+            });
+        }
+
+        uint32 wrong = 0;
+        query.ForEachChunk([&](const EntityChunk& chunk) {
+            for (const Health& health : chunk.Field<Health>())
+            {
+                wrong += health.points == 3 ? 0 : 1;
+            }
+        });
+        CHECK(wrong == 0);
+        CHECK(empty_chunks.load() == 0);
+        CHECK(query.EntityCount() == 20000);
+    }
+
+    TEST_CASE("World transforms and bounds follow the local ones")
+    {
+        UniquePtr<JobSystem> jobs = MakeJobSystem(2);
+        EntityWorld world;
+        const Aabb unit{float3{-1.0f, -1.0f, -1.0f}, float3{1.0f, 1.0f, 1.0f}};
+        DynamicArray<Entity> bounded;
+        for (uint32 i = 0; i < 3000; ++i)
+        {
+            bounded.PushBack(world.Create(Translation(static_cast<float>(i), 0.0f, 0.0f),
+                                          WorldTransform{},
+                                          LocalBounds{unit},
+                                          WorldBounds{}));
+        }
+        const Entity unbounded = world.Create(Translation(0.0f, 5.0f, 0.0f), WorldTransform{});
+
+        UpdateEntityTransforms(world, *jobs);
+
+        for (uint32 i = 0; i < 3000; ++i)
+        {
+            const Aabb& box = world.Get<WorldBounds>(bounded[i])->box;
+            CHECK(box.min.x == doctest::Approx(static_cast<float>(i) - 1.0f));
+            CHECK(box.max.x == doctest::Approx(static_cast<float>(i) + 1.0f));
+            CHECK(box.max.y == doctest::Approx(1.0f));
+        }
+        const simd::float4x4& matrix = world.Get<WorldTransform>(unbounded)->matrix;
+        const simd::float4x4 expected = simd::ComposeTrs(
+            simd::float4(0.0f, 5.0f, 0.0f, 0.0f), simd::QuatIdentity(),
+            simd::float4(1.0f, 1.0f, 1.0f, 0.0f));
+        CHECK(memcmp(&matrix, &expected, sizeof(matrix)) == 0);
+    }
+
+    TEST_CASE("Animations advance, wrapping when they loop")
+    {
+        const float times[] = {0.0f, 2.0f};
+        const float values[] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+        AnimationChannel channel;
+        channel.times = times;
+        channel.values = values;
+        AnimationClip clip;
+        REQUIRE(clip.Build(ArrayView<const AnimationChannel>(&channel, 1), 1));
+        REQUIRE(clip.Duration() == doctest::Approx(2.0f));
+
+        UniquePtr<JobSystem> jobs = MakeJobSystem(1);
+        EntityWorld world;
+        const Entity looping = world.Create(AnimationState{&clip, 1.5f, 1.0f, true});
+        const Entity once = world.Create(AnimationState{&clip, 1.5f, 1.0f, false});
+        const Entity fast = world.Create(AnimationState{&clip, 0.0f, 3.0f, true});
+        const Entity idle = world.Create(AnimationState{nullptr, 0.25f, 1.0f, true});
+
+        AdvanceAnimations(world, *jobs, 1.0f);
+
+        CHECK(world.Get<AnimationState>(looping)->time == doctest::Approx(0.5f));
+        CHECK(world.Get<AnimationState>(once)->time == doctest::Approx(2.0f));
+        CHECK(world.Get<AnimationState>(fast)->time == doctest::Approx(1.0f));
+        CHECK(world.Get<AnimationState>(idle)->time == 0.25f);
+    }
+}
@@ -0,0 +1,194 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+// Picking against a mesh the size of a detailed glTF (DamagedHelmet is 46k triangles, the
+// sponzas a few hundred thousand): every triangle per ray, against the triangle BVH one ray at a
+// time, and in packets, for a camera's worth of coherent rays and for scattered ones.
+
+#include "include/rsbl-raycast.h"
+
+#include <rsbl-hw-counters.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+using namespace rsbl;
+
+namespace
+{
+constexpr uint32 kRepeats = 5;
+
+// Stop the optimizer from folding the loops away
+volatile float s_sink = 0.0f;
+
+template <typename F>
+void Time(const char* name, uint32 rayCount, F&& f)
+{
+    HwCounterSample counters;
+    const auto start = std::chrono::steady_clock::now();
+    {
+        HwZone zone(name, counters);
+        for (uint32 repeat = 0; repeat < kRepeats; ++repeat)
+        {
+            f();
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double us = std::chrono::duration<double, std::micro>(end - start).count() / kRepeats;
+    printf("  %-40s %11.1f us  (%8.1f ns/ray)\n", name, us, us * 1000.0 / rayCount);
+    if (counters.available != 0)
+    {
+        String text;
+        AppendHwCounters(text, counters, static_cast<uint64>(rayCount) * kRepeats);
+        printf("  %-40s %s per ray\n", "", text.CStr());
+    }
+}
+
+// A bumpy sphere of rings by segments, two triangles a quad
+void MakeMesh(uint32 rings,
+              uint32 segments,
+              DynamicArray<float3>& positions,
+              DynamicArray<uint32>& indices)
+{
+    for (uint32 ring = 0; ring <= rings; ++ring)
+    {
+        const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(rings);
+        for (uint32 segment = 0; segment <= segments; ++segment)
+        {
+            const float phi =
+                6.2831853f * static_cast<float>(segment) / static_cast<float>(segments);
+            const float radius = 1.0f + 0.05f * sinf(theta * 40.0f) * cosf(phi * 30.0f);
+            positions.PushBack(float3(radius * sinf(theta) * cosf(phi),
+                                      radius * cosf(theta),
+                                      radius * sinf(theta) * sinf(phi)));
+        }
+    }
+    for (uint32 ring = 0; ring < rings; ++ring)
+    {
+        for (uint32 segment = 0; segment < segments; ++segment)
+        {
+            const uint32 a = ring * (segments + 1) + segment;
+            const uint32 b = a + segments + 1;
+            const uint32 quad[6] = {a, b, a + 1, a + 1, b, b + 1};
+            for (const uint32 index : quad)
+            {
+                indices.PushBack(index);
+            }
+        }
+    }
+}
+
+// The closest t over every triangle
+float BruteForce(const Ray& ray, ArrayView<const float3> positions, ArrayView<const uint32> indices)
+{
+    float closest = 1e30f;
+    for (uint64 i = 0; i < indices.Size(); i += 3)
+    {
+        const float3 v0 = positions[indices[i]];
+        const float3 v1 = positions[indices[i + 1]];
+        const float3 v2 = positions[indices[i + 2]];
+        const float3 e1(v1.x - v0.x, v1.y - v0.y, v1.z - v0.z);
+        const float3 e2(v2.x - v0.x, v2.y - v0.y, v2.z - v0.z);
+        const float3 d = ray.direction;
+        const float3 p(d.y * e2.z - d.z * e2.y, d.z * e2.x - d.x * e2.z, d.x * e2.y - d.y * e2.x);
+        const float inverse = 1.0f / (e1.x * p.x + e1.y * p.y + e1.z * p.z);
+        const float3 s(ray.origin.x - v0.x, ray.origin.y - v0.y, ray.origin.z - v0.z);
+        const float u = (s.x * p.x + s.y * p.y + s.z * p.z) * inverse;
+        const float3 q(s.y * e1.z - s.z * e1.y, s.z * e1.x - s.x * e1.z, s.x * e1.y - s.y * e1.x);
+        const float v = (d.x * q.x + d.y * q.y + d.z * q.z) * inverse;
+        const float t = (e2.x * q.x + e2.y * q.y + e2.z * q.z) * inverse;
+        if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t < closest)
+        {
+            closest = t;
+        }
+    }
+    return closest;
+}
+} // namespace
+
+int main()
+{
+    for (const uint32 rings : {96u, 160u, 384u})
+    {
+        DynamicArray<float3> positions;
+        DynamicArray<uint32> indices;
+        MakeMesh(rings, rings * 2, positions, indices);
+        const uint32 triangle_count = static_cast<uint32>(indices.Size() / 3);
+        printf("%u triangles\n", triangle_count);
+
+        TriangleBvh bvh;
+        Time("TriangleBvh::Build", 1, [&]() { bvh.Build(positions, indices); });
+
+        // A 128 x 128 tile looking at the mesh, then as many rays from all around
+        DynamicArray<Ray> coherent;
+        DynamicArray<Ray> scattered;
+        uint64 state = 1;
+        auto next = [&state]() {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<float>(state >> 40) / static_cast<float>(1 << 24);
+        };
+        for (uint32 y = 0; y < 128; ++y)
+        {
+            for (uint32 x = 0; x < 128; ++x)
+            {
+                coherent.PushBack(Ray{float3(0.0f, 0.0f, -4.0f),
+                                      float3((float(x) - 64.0f) / 192.0f,
+                                             (float(y) - 64.0f) / 192.0f,
+                                             1.0f)});
+                const float3 origin(next() * 8.0f - 4.0f, next() * 8.0f - 4.0f, -4.0f);
+                scattered.PushBack(Ray{origin,
+                                       float3(next() - 0.5f - origin.x * 0.25f,
+                                              next() - 0.5f - origin.y * 0.25f,
+                                              1.0f)});
+            }
+        }
+        DynamicArray<RayHit> hits;
+        hits.Resize(coherent.Size());
+
+        // Brute force is slow enough that a few hundred rays make the point
+        const uint32 brute_count = 256;
+        Time("Every triangle", brute_count, [&]() {
+            float sum = 0.0f;
+            for (uint32 i = 0; i < brute_count; ++i)
+            {
+                sum += BruteForce(coherent[i * 61], positions, indices);
+            }
+            s_sink = sum;
+        });
+        struct RaySet
+        {
+            const char* name;
+            const DynamicArray<Ray>* rays;
+        };
+        for (const RaySet& set : {RaySet{"coherent", &coherent}, RaySet{"scattered", &scattered}})
+        {
+            const char* name = set.name;
+            const DynamicArray<Ray>* rays = set.rays;
+            char label[64];
+            snprintf(label, sizeof(label), "TriangleBvh::Raycast, %s", name);
+            Time(label, static_cast<uint32>(rays->Size()), [&]() {
+                float sum = 0.0f;
+                for (const Ray& ray : *rays)
+                {
+                    RayHit hit;
+                    bvh.Raycast(ray, hit);
+                    sum += hit.t;
+                }
+                s_sink = sum;
+            });
+            snprintf(label, sizeof(label), "TriangleBvh::RaycastBatch, %s", name);
+            Time(label, static_cast<uint32>(rays->Size()), [&]() {
+                for (RayHit& hit : hits)
+                {
+                    hit = RayHit{};
+                }
+                bvh.RaycastBatch(*rays, hits);
+                s_sink = hits[0].t;
+            });
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,359 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-raycast.h"
+
+#include <rsbl-assert.h>
+#include <rsbl-jobs.h>
+#include <rsbl-simd-wide.h>
+
+#include <cstring>
+
+namespace rsbl
+{
+
+namespace
+{
+using RayLanes = simd::FloatxN<kRayPacketWidth>;
+using RayVectors = simd::Vec3xN<kRayPacketWidth>;
+
+float3 Subtract(float3 a, float3 b)
+{
+    return float3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+float Dot(float3 a, float3 b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+float3 Cross(float3 a, float3 b)
+{
+    return float3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+// Möller-Trumbore, from either side. A degenerate triangle or a ray in its plane divides by a
+// determinant of 0, and the NaNs and infinities that gives fail the tests.
+bool RayHitsTriangle(const Ray& ray,
+                     float3 v0,
+                     float3 e1,
+                     float3 e2,
+                     float tMax,
+                     float& t,
+                     float& u,
+                     float& v)
+{
+    const float3 p = Cross(ray.direction, e2);
+    const float inverse = 1.0f / Dot(e1, p);
+    const float3 s = Subtract(ray.origin, v0);
+    u = Dot(s, p) * inverse;
+    const float3 q = Cross(s, e1);
+    v = Dot(ray.direction, q) * inverse;
+    t = Dot(e2, q) * inverse;
+    return u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t < tMax;
+}
+
+// The same for a packet's rays, one per lane, and a bit for each that hits
+uint32 PacketHitsTriangle(const RayVectors& origin,
+                          const RayVectors& direction,
+                          float3 v0,
+                          float3 e1,
+                          float3 e2,
+                          RayLanes tMax,
+                          RayLanes& t,
+                          RayLanes& u,
+                          RayLanes& v)
+{
+    const RayVectors edge1(e1.x, e1.y, e1.z);
+    const RayVectors edge2(e2.x, e2.y, e2.z);
+    const RayVectors p = simd::Cross(direction, edge2);
+    const RayLanes inverse = RayLanes(1.0f) / simd::Dot(edge1, p);
+    const RayVectors s = origin - RayVectors(v0.x, v0.y, v0.z);
+    u = simd::Dot(s, p) * inverse;
+    const RayVectors q = simd::Cross(s, edge1);
+    v = simd::Dot(direction, q) * inverse;
+    t = simd::Dot(edge2, q) * inverse;
+    const RayLanes zero(0.0f);
+    return simd::ToBits((u >= zero) & (v >= zero) & (u + v <= RayLanes(1.0f)) & (t >= zero) &
+                        (t < tMax));
+}
+
+Ray TransformRay(const simd::float4x4& m, const Ray& ray)
+{
+    const simd::float4 origin = simd::TransformPoint(m, simd::Load(ray.origin, 1.0f));
+    const simd::float4 direction = simd::TransformVector(m, simd::Load(ray.direction));
+    return Ray{simd::ToFloat3(origin), simd::ToFloat3(direction)};
+}
+
+void RaycastScenePacket(const Bvh& scene,
+                        ArrayView<const RayInstance> instances,
+                        const Ray* rays,
+                        uint32 count,
+                        RayHit* hits)
+{
+    float tMax[kRayPacketWidth];
+    uint32 objects[kRayPacketWidth];
+    for (uint32 i = 0; i < count; ++i)
+    {
+        tMax[i] = hits[i].t;
+    }
+
+    scene.RaycastPacket(
+        rays, count, tMax, objects, [&](uint32 object, uint32 lanes, float* limits) {
+            const RayInstance& instance = instances[object];
+            // An affine map keeps distances in multiples of the direction, so t carries over
+            Ray local_rays[kRayPacketWidth];
+            RayHit local_hits[kRayPacketWidth];
+            for (uint32 i = 0; i < count; ++i)
+            {
+                local_rays[i] = TransformRay(instance.worldToLocal, rays[i]);
+                // Rays outside lanes look no distance at all
+                local_hits[i].t = (lanes & (1u << i)) != 0 ? limits[i] : -1.0f;
+            }
+            instance.mesh->RaycastPacket(local_rays, count, local_hits);
+            for (uint32 i = 0; i < count; ++i)
+            {
+                if ((lanes & (1u << i)) != 0 && local_hits[i].t < limits[i])
+                {
+                    limits[i] = local_hits[i].t;
+                    hits[i].triangle = local_hits[i].triangle;
+                    hits[i].u = local_hits[i].u;
+                    hits[i].v = local_hits[i].v;
+                }
+            }
+        });
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        hits[i].t = tMax[i];
+        if (objects[i] != Bvh::kNoObject)
+        {
+            hits[i].object = objects[i];
+        }
+    }
+}
+
+void RaycastSceneRange(const Bvh& scene,
+                       ArrayView<const RayInstance> instances,
+                       ArrayView<const Ray> rays,
+                       ArrayView<RayHit> hits,
+                       uint64 begin,
+                       uint64 end)
+{
+    for (uint64 first = begin; first < end; first += kRayPacketWidth)
+    {
+        const uint64 left = end - first;
+        const uint32 count = left < kRayPacketWidth ? static_cast<uint32>(left) : kRayPacketWidth;
+        RaycastScenePacket(scene, instances, &rays[first], count, &hits[first]);
+    }
+}
+} // namespace
+
+void TriangleBvh::Build(ArrayView<const float3> positions,
+                        ArrayView<const uint32> indices,
+                        const BvhBuildOptions& options)
+{
+    rsblAssert(indices.Size() % 3 == 0);
+    m_triangles.ResizeUninitialized(indices.Size() / 3);
+    for (uint64 i = 0; i < m_triangles.Size(); ++i)
+    {
+        const float3 v0 = positions[indices[i * 3]];
+        m_triangles[i] = Triangle{v0,
+                                  Subtract(positions[indices[i * 3 + 1]], v0),
+                                  Subtract(positions[indices[i * 3 + 2]], v0)};
+    }
+    BuildBvh(options);
+}
+
+void TriangleBvh::Build(const Unorm16Positions& positions,
+                        ArrayView<const uint32> indices,
+                        const BvhBuildOptions& options)
+{
+    const float3 scale((positions.bounds.max.x - positions.bounds.min.x) / 65535.0f,
+                       (positions.bounds.max.y - positions.bounds.min.y) / 65535.0f,
+                       (positions.bounds.max.z - positions.bounds.min.z) / 65535.0f);
+    DynamicArray<float3> dequantized;
+    dequantized.ResizeUninitialized(positions.count);
+    const uint8* bytes = static_cast<const uint8*>(positions.data);
+    for (uint32 i = 0; i < positions.count; ++i)
+    {
+        uint16 quantized[3];
+        memcpy(quantized, bytes + static_cast<uint64>(i) * positions.stride, sizeof(quantized));
+        dequantized[i] = float3(positions.bounds.min.x + quantized[0] * scale.x,
+                                positions.bounds.min.y + quantized[1] * scale.y,
+                                positions.bounds.min.z + quantized[2] * scale.z);
+    }
+    Build(dequantized, indices, options);
+}
+
+void TriangleBvh::BuildBvh(const BvhBuildOptions& options)
+{
+    DynamicArray<Aabb> bounds;
+    bounds.ResizeUninitialized(m_triangles.Size());
+    for (uint64 i = 0; i < m_triangles.Size(); ++i)
+    {
+        const Triangle& triangle = m_triangles[i];
+        const float3 v1(triangle.v0.x + triangle.e1.x,
+                        triangle.v0.y + triangle.e1.y,
+                        triangle.v0.z + triangle.e1.z);
+        const float3 v2(triangle.v0.x + triangle.e2.x,
+                        triangle.v0.y + triangle.e2.y,
+                        triangle.v0.z + triangle.e2.z);
+        const float3 corners[3] = {triangle.v0, v1, v2};
+        bounds[i] = AabbFromPoints(corners);
+    }
+    m_bvh.Build(bounds, options);
+}
+
+bool TriangleBvh::Raycast(const Ray& ray, RayHit& hit) const
+{
+    float t = hit.t;
+    float u = 0.0f;
+    float v = 0.0f;
+    const uint32 triangle = m_bvh.Raycast(ray, t, [&](uint32 object, float tMax) {
+        const Triangle& candidate = m_triangles[object];
+        float distance;
+        float hit_u;
+        float hit_v;
+        if (!RayHitsTriangle(
+                ray, candidate.v0, candidate.e1, candidate.e2, tMax, distance, hit_u, hit_v))
+        {
+            return tMax;
+        }
+        u = hit_u;
+        v = hit_v;
+        return distance;
+    });
+    if (triangle == Bvh::kNoObject)
+    {
+        return false;
+    }
+    hit.t = t;
+    hit.triangle = triangle;
+    hit.u = u;
+    hit.v = v;
+    return true;
+}
+
+void TriangleBvh::RaycastPacket(const Ray* rays, uint32 count, RayHit* hits) const
+{
+    rsblAssert(count >= 1 && count <= kRayPacketWidth);
+    float lanes[6][kRayPacketWidth];
+    float tMax[kRayPacketWidth];
+    for (uint32 i = 0; i < kRayPacketWidth; ++i)
+    {
+        const Ray& ray = rays[i < count ? i : 0];
+        lanes[0][i] = ray.origin.x;
+        lanes[1][i] = ray.origin.y;
+        lanes[2][i] = ray.origin.z;
+        lanes[3][i] = ray.direction.x;
+        lanes[4][i] = ray.direction.y;
+        lanes[5][i] = ray.direction.z;
+        tMax[i] = i < count ? hits[i].t : -1.0f;
+    }
+    // One capture, the hit function's storage only has room for two
+    struct Packet
+    {
+        RayVectors origin;
+        RayVectors direction;
+        float u[kRayPacketWidth];
+        float v[kRayPacketWidth];
+    };
+    Packet packet;
+    packet.origin = RayVectors::LoadUnaligned(lanes[0], lanes[1], lanes[2]);
+    packet.direction = RayVectors::LoadUnaligned(lanes[3], lanes[4], lanes[5]);
+
+    uint32 triangles[kRayPacketWidth];
+    m_bvh.RaycastPacket(
+        rays, count, tMax, triangles, [this, &packet](uint32 object, uint32 active, float* limits) {
+            const Triangle& triangle = m_triangles[object];
+            RayLanes t_lanes;
+            RayLanes u_lanes;
+            RayLanes v_lanes;
+            const uint32 hit = active & PacketHitsTriangle(packet.origin,
+                                                           packet.direction,
+                                                           triangle.v0,
+                                                           triangle.e1,
+                                                           triangle.e2,
+                                                           RayLanes::LoadUnaligned(limits),
+                                                           t_lanes,
+                                                           u_lanes,
+                                                           v_lanes);
+            if (hit == 0)
+            {
+                return;
+            }
+            float t_out[kRayPacketWidth];
+            float u_out[kRayPacketWidth];
+            float v_out[kRayPacketWidth];
+            simd::StoreUnaligned(t_lanes, t_out);
+            simd::StoreUnaligned(u_lanes, u_out);
+            simd::StoreUnaligned(v_lanes, v_out);
+            for (uint32 i = 0; i < kRayPacketWidth; ++i)
+            {
+                if ((hit & (1u << i)) != 0)
+                {
+                    limits[i] = t_out[i];
+                    packet.u[i] = u_out[i];
+                    packet.v[i] = v_out[i];
+                }
+            }
+        });
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (triangles[i] != Bvh::kNoObject)
+        {
+            hits[i].t = tMax[i];
+            hits[i].triangle = triangles[i];
+            hits[i].u = packet.u[i];
+            hits[i].v = packet.v[i];
+        }
+    }
+}
+
+void TriangleBvh::RaycastBatch(ArrayView<const Ray> rays, ArrayView<RayHit> hits) const
+{
+    rsblAssert(rays.Size() == hits.Size());
+    for (uint64 first = 0; first < rays.Size(); first += kRayPacketWidth)
+    {
+        const uint64 left = rays.Size() - first;
+        const uint32 count = left < kRayPacketWidth ? static_cast<uint32>(left) : kRayPacketWidth;
+        RaycastPacket(&rays[first], count, &hits[first]);
+    }
+}
+
+void RaycastScene(const Bvh& scene,
+                  ArrayView<const RayInstance> instances,
+                  ArrayView<const Ray> rays,
+                  ArrayView<RayHit> hits)
+{
+    rsblAssert(rays.Size() == hits.Size());
+    rsblAssert(scene.ObjectCount() == instances.Size());
+    RaycastSceneRange(scene, instances, rays, hits, 0, rays.Size());
+}
+
+void RaycastScene(JobSystem& jobs,
+                  const Bvh& scene,
+                  ArrayView<const RayInstance> instances,
+                  ArrayView<const Ray> rays,
+                  ArrayView<RayHit> hits,
+                  uint64 grain)
+{
+    rsblAssert(rays.Size() == hits.Size());
+    rsblAssert(scene.ObjectCount() == instances.Size());
+    // In whole packets, so chunks never split one
+    const uint64 packets = (rays.Size() + kRayPacketWidth - 1) / kRayPacketWidth;
+    const uint64 grain_packets = grain > kRayPacketWidth ? grain / kRayPacketWidth : 1;
+    jobs.ParallelFor(0, packets, grain_packets, [&](uint64 begin, uint64 end) {
+        const uint64 last = end * kRayPacketWidth;
+        RaycastSceneRange(scene,
+                          instances,
+                          rays,
+                          hits,
+                          begin * kRayPacketWidth,
+                          last < rays.Size() ? last : rays.Size());
+    });
+}
+
+} // namespace rsbl
@@ -0,0 +1,398 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-raycast.h"
+
+#include <rsbl-jobs.h>
+
+#include <cmath>
+#include <cstring>
+
+using namespace rsbl;
+
+namespace
+{
+struct Random
+{
+    uint64 state = 1;
+
+    // [0, 1)
+    float Next()
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<float>(state >> 40) / static_cast<float>(1 << 24);
+    }
+};
+
+struct Mesh
+{
+    DynamicArray<float3> positions;
+    DynamicArray<uint32> indices;
+};
+
+// A unit sphere of rings by segments
+Mesh MakeSphere(uint32 rings, uint32 segments)
+{
+    Mesh mesh;
+    for (uint32 ring = 0; ring <= rings; ++ring)
+    {
+        const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(rings);
+        for (uint32 segment = 0; segment <= segments; ++segment)
+        {
+            const float phi =
+                6.2831853f * static_cast<float>(segment) / static_cast<float>(segments);
+            mesh.positions.PushBack(
+                float3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi)));
+        }
+    }
+    for (uint32 ring = 0; ring < rings; ++ring)
+    {
+        for (uint32 segment = 0; segment < segments; ++segment)
+        {
+            const uint32 a = ring * (segments + 1) + segment;
+            const uint32 b = a + segments + 1;
+            const uint32 quad[6] = {a, b, a + 1, a + 1, b, b + 1};
+            for (const uint32 index : quad)
+            {
+                mesh.indices.PushBack(index);
+            }
+        }
+    }
+    return mesh;
+}
+
+// Small triangles scattered through a box of side 10 around the origin
+Mesh MakeSoup(uint32 count, uint64 seed)
+{
+    Random random{seed};
+    Mesh mesh;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        const float3 center(random.Next() * 10.0f - 5.0f,
+                            random.Next() * 10.0f - 5.0f,
+                            random.Next() * 10.0f - 5.0f);
+        for (uint32 corner = 0; corner < 3; ++corner)
+        {
+            mesh.indices.PushBack(static_cast<uint32>(mesh.positions.Size()));
+            mesh.positions.PushBack(float3(center.x + random.Next() - 0.5f,
+                                           center.y + random.Next() - 0.5f,
+                                           center.z + random.Next() - 0.5f));
+        }
+    }
+    return mesh;
+}
+
+float3 Sub(float3 a, float3 b)
+{
+    return float3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+float3 Cross3(float3 a, float3 b)
+{
+    return float3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+double Dot3d(float3 a, float3 b)
+{
+    return double(a.x) * b.x + double(a.y) * b.y + double(a.z) * b.z;
+}
+
+// Every triangle, in doubles where it counts. The closest t, or tMax.
+float BruteForce(const Ray& ray,
+                 ArrayView<const float3> positions,
+                 ArrayView<const uint32> indices,
+                 float tMax,
+                 uint32& triangle)
+{
+    float closest = tMax;
+    triangle = Bvh::kNoObject;
+    for (uint32 i = 0; i < indices.Size() / 3; ++i)
+    {
+        const float3 v0 = positions[indices[i * 3]];
+        const float3 e1 = Sub(positions[indices[i * 3 + 1]], v0);
+        const float3 e2 = Sub(positions[indices[i * 3 + 2]], v0);
+        const float3 p = Cross3(ray.direction, e2);
+        const double det = Dot3d(e1, p);
+        if (det == 0.0)
+        {
+            continue;
+        }
+        const float3 s = Sub(ray.origin, v0);
+        const double u = Dot3d(s, p) / det;
+        const float3 q = Cross3(s, e1);
+        const double v = Dot3d(ray.direction, q) / det;
+        const double t = Dot3d(e2, q) / det;
+        if (u >= 0.0 && v >= 0.0 && u + v <= 1.0 && t >= 0.0 && t < closest)
+        {
+            closest = static_cast<float>(t);
+            triangle = i;
+        }
+    }
+    return closest;
+}
+
+DynamicArray<Ray> MakeRays(uint32 count, uint64 seed)
+{
+    Random random{seed};
+    DynamicArray<Ray> rays;
+    // A camera's tile of coherent rays, then scattered ones
+    for (uint32 y = 0; y < 16; ++y)
+    {
+        for (uint32 x = 0; x < count / 32; ++x)
+        {
+            rays.PushBack(Ray{float3(0.3f, 0.2f, -12.0f),
+                              float3((float(x) - float(count / 64)) * 0.02f,
+                                     (float(y) - 8.0f) * 0.04f,
+                                     1.0f)});
+        }
+    }
+    while (rays.Size() < count)
+    {
+        const float3 origin(random.Next() * 30.0f - 15.0f,
+                            random.Next() * 30.0f - 15.0f,
+                            random.Next() * 30.0f - 15.0f);
+        const float3 target(random.Next() * 24.0f - 12.0f,
+                            random.Next() * 24.0f - 12.0f,
+                            random.Next() * 24.0f - 12.0f);
+        rays.PushBack(Ray{origin, Sub(target, origin)});
+    }
+    return rays;
+}
+
+void CheckHit(const RayHit& hit, float expected, uint32 expectedTriangle, float tMax)
+{
+    CHECK((hit.t < tMax) == (expected < tMax));
+    CHECK(hit.t == doctest::Approx(expected).epsilon(1e-4));
+    CHECK((hit.triangle == Bvh::kNoObject) == (expectedTriangle == Bvh::kNoObject));
+}
+} // namespace
+
+TEST_SUITE("rsbl::TriangleBvh")
+{
+    TEST_CASE("Single rays and packets match brute force")
+    {
+        // A scattering of triangles around a stretched sphere
+        Mesh mesh = MakeSoup(3000, 7);
+        const Mesh sphere = MakeSphere(24, 48);
+        const uint32 base = static_cast<uint32>(mesh.positions.Size());
+        for (const float3& position : sphere.positions)
+        {
+            mesh.positions.PushBack(float3(position.x * 3.0f, position.y * 3.0f, position.z));
+        }
+        for (const uint32 index : sphere.indices)
+        {
+            mesh.indices.PushBack(base + index);
+        }
+
+        TriangleBvh bvh;
+        bvh.Build(mesh.positions, mesh.indices);
+        CHECK(bvh.TriangleCount() == mesh.indices.Size() / 3);
+
+        const DynamicArray<Ray> rays = MakeRays(512, 3);
+        const float t_max = 100.0f;
+        DynamicArray<RayHit> hits;
+        hits.Resize(rays.Size());
+        for (RayHit& hit : hits)
+        {
+            hit.t = t_max;
+        }
+        bvh.RaycastBatch(rays, hits);
+
+        uint32 hit_count = 0;
+        for (uint32 i = 0; i < rays.Size(); ++i)
+        {
+            uint32 expected_triangle;
+            const float expected =
+                BruteForce(rays[i], mesh.positions, mesh.indices, t_max, expected_triangle);
+            hit_count += expected < t_max ? 1 : 0;
+
+            RayHit single;
+            single.t = t_max;
+            CHECK(bvh.Raycast(rays[i], single) == (expected < t_max));
+            CheckHit(single, expected, expected_triangle, t_max);
+            CheckHit(hits[i], expected, expected_triangle, t_max);
+            if (hits[i].triangle != Bvh::kNoObject)
+            {
+                CHECK(hits[i].u >= 0.0f);
+                CHECK(hits[i].v >= 0.0f);
+                CHECK(hits[i].u + hits[i].v <= 1.0001f);
+            }
+        }
+        // Enough of both to mean something
+        CHECK(hit_count > 100);
+        CHECK(hit_count < rays.Size() - 50);
+    }
+
+    TEST_CASE("Hits land where the barycentrics say")
+    {
+        const float3 positions[] = {
+            float3(0.0f, 0.0f, 5.0f), float3(2.0f, 0.0f, 5.0f), float3(0.0f, 2.0f, 5.0f)};
+        const uint32 indices[] = {0, 1, 2};
+        TriangleBvh bvh;
+        bvh.Build(positions, indices);
+
+        RayHit hit;
+        REQUIRE(bvh.Raycast(Ray{float3(0.5f, 1.0f, 0.0f), float3(0.0f, 0.0f, 1.0f)}, hit));
+        CHECK(hit.t == doctest::Approx(5.0f));
+        CHECK(hit.triangle == 0);
+        CHECK(hit.u == doctest::Approx(0.25f));
+        CHECK(hit.v == doctest::Approx(0.5f));
+
+        // From behind, and with a direction twice as long
+        hit = RayHit{};
+        REQUIRE(bvh.Raycast(Ray{float3(0.5f, 1.0f, 9.0f), float3(0.0f, 0.0f, -2.0f)}, hit));
+        CHECK(hit.t == doctest::Approx(2.0f));
+
+        // Not far enough, past the edge, and an empty mesh
+        hit = RayHit{};
+        hit.t = 4.0f;
+        CHECK_FALSE(bvh.Raycast(Ray{float3(0.5f, 1.0f, 0.0f), float3(0.0f, 0.0f, 1.0f)}, hit));
+        CHECK(hit.t == 4.0f);
+        hit = RayHit{};
+        CHECK_FALSE(bvh.Raycast(Ray{float3(1.5f, 1.5f, 0.0f), float3(0.0f, 0.0f, 1.0f)}, hit));
+        TriangleBvh empty;
+        empty.Build(ArrayView<const float3>(), ArrayView<const uint32>());
+        CHECK_FALSE(empty.Raycast(Ray{float3(0.0f), float3(0.0f, 0.0f, 1.0f)}, hit));
+    }
+
+    TEST_CASE("Quantized positions build the same tree as their floats")
+    {
+        const Mesh sphere = MakeSphere(8, 16);
+        const Aabb bounds{float3(-1.0f), float3(1.0f)};
+        struct Vertex
+        {
+            uint16 position[4];
+            uint16 other[6];
+        };
+        DynamicArray<Vertex> vertices;
+        DynamicArray<float3> dequantized;
+        for (const float3& position : sphere.positions)
+        {
+            Vertex vertex = {};
+            const float p[3] = {position.x, position.y, position.z};
+            for (uint32 axis = 0; axis < 3; ++axis)
+            {
+                vertex.position[axis] =
+                    static_cast<uint16>(lroundf((p[axis] + 1.0f) * 0.5f * 65535));
+            }
+            vertices.PushBack(vertex);
+            dequantized.PushBack(float3(-1.0f + vertex.position[0] * (2.0f / 65535.0f),
+                                        -1.0f + vertex.position[1] * (2.0f / 65535.0f),
+                                        -1.0f + vertex.position[2] * (2.0f / 65535.0f)));
+        }
+
+        TriangleBvh bvh;
+        bvh.Build(Unorm16Positions{vertices.Data(),
+                                   sizeof(Vertex),
+                                   static_cast<uint32>(vertices.Size()),
+                                   bounds},
+                  sphere.indices);
+        const DynamicArray<Ray> rays = MakeRays(128, 11);
+        for (const Ray& ray : rays)
+        {
+            RayHit hit;
+            hit.t = 100.0f;
+            bvh.Raycast(ray, hit);
+            uint32 triangle;
+            const float expected = BruteForce(ray, dequantized, sphere.indices, 100.0f, triangle);
+            CheckHit(hit, expected, triangle, 100.0f);
+        }
+    }
+}
+
+TEST_SUITE("rsbl::RaycastScene")
+{
+    TEST_CASE("Instances are hit in their own space")
+    {
+        const Mesh sphere = MakeSphere(16, 32);
+        const Mesh soup = MakeSoup(500, 5);
+        TriangleBvh meshes[2];
+        meshes[0].Build(sphere.positions, sphere.indices);
+        meshes[1].Build(soup.positions, soup.indices);
+
+        // Scaled, moved and rotated instances of both
+        const simd::float4x4 worlds[] = {
+            simd::ComposeTrs(simd::float4(0.0f, 0.0f, 0.0f, 1.0f),
+                             simd::QuatFromAxisAngle(simd::float4(0.0f, 1.0f, 0.0f, 0.0f), 0.0f),
+                             simd::float4(2.0f, 2.0f, 2.0f, 0.0f)),
+            simd::ComposeTrs(simd::float4(6.0f, 1.0f, 3.0f, 1.0f),
+                             simd::QuatFromAxisAngle(simd::float4(0.0f, 0.0f, 1.0f, 0.0f), 0.7f),
+                             simd::float4(1.0f, 3.0f, 1.0f, 0.0f)),
+            simd::ComposeTrs(simd::float4(-5.0f, 0.0f, 2.0f, 1.0f),
+                             simd::QuatFromAxisAngle(simd::float4(1.0f, 0.0f, 0.0f, 0.0f), 1.1f),
+                             simd::float4(0.5f, 0.5f, 0.5f, 0.0f)),
+        };
+        const Mesh* sources[] = {&sphere, &soup, &soup};
+        const uint32 mesh_of[] = {0, 1, 1};
+
+        DynamicArray<RayInstance> instances;
+        DynamicArray<Aabb> bounds;
+        DynamicArray<float3> world_positions[3];
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            instances.PushBack(RayInstance{&meshes[mesh_of[i]], simd::InverseAffine(worlds[i])});
+            bounds.PushBack(TransformAabb(meshes[mesh_of[i]].Bounds(), worlds[i]));
+            for (const float3& position : sources[i]->positions)
+            {
+                world_positions[i].PushBack(simd::ToFloat3(
+                    simd::TransformPoint(worlds[i], simd::Load(position, 1.0f))));
+            }
+        }
+        Bvh scene;
+        scene.Build(bounds);
+
+        const DynamicArray<Ray> rays = MakeRays(300, 17);
+        const float t_max = 80.0f;
+        DynamicArray<RayHit> hits;
+        hits.Resize(rays.Size());
+        for (RayHit& hit : hits)
+        {
+            hit.t = t_max;
+        }
+        RaycastScene(scene, instances, rays, hits);
+
+        uint32 hit_count = 0;
+        for (uint32 r = 0; r < rays.Size(); ++r)
+        {
+            float expected = t_max;
+            uint32 expected_object = Bvh::kNoObject;
+            for (uint32 i = 0; i < 3; ++i)
+            {
+                uint32 triangle;
+                const float t = BruteForce(
+                    rays[r], world_positions[i], sources[i]->indices, expected, triangle);
+                if (t < expected)
+                {
+                    expected = t;
+                    expected_object = i;
+                }
+            }
+            hit_count += expected_object != Bvh::kNoObject ? 1 : 0;
+            CHECK(hits[r].t == doctest::Approx(expected).epsilon(1e-3));
+            CHECK((hits[r].object == Bvh::kNoObject) == (expected_object == Bvh::kNoObject));
+        }
+        CHECK(hit_count > 50);
+
+        // Split over jobs, the same hits
+        JobSystemOptions options;
+        options.workerCount = 3;
+        Result<UniquePtr<JobSystem>> jobs = JobSystem::Create(options);
+        REQUIRE(jobs);
+        DynamicArray<RayHit> threaded;
+        threaded.Resize(rays.Size());
+        for (RayHit& hit : threaded)
+        {
+            hit.t = t_max;
+        }
+        RaycastScene(*jobs.Value(), scene, instances, rays, threaded, 16);
+        for (uint32 r = 0; r < rays.Size(); ++r)
+        {
+            CHECK(threaded[r].t == hits[r].t);
+            CHECK(threaded[r].object == hits[r].object);
+            CHECK(threaded[r].triangle == hits[r].triangle);
+        }
+    }
+}
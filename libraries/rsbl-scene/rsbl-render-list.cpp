@@ -0,0 +1,87 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-render-list.h"
+
+#include <rsbl-sort.h>
+
+namespace rsbl
+{
+
+Result<> RenderList::Build(ArrayView<const RenderItem> items,
+                           ArrayView<const simd::float4x4> worlds)
+{
+    MemoryTagScope memory_scope(MemoryTag::Scene);
+
+    m_draws.Clear();
+    m_transforms.Clear();
+    m_nodes.Clear();
+
+    const uint64 count = items.Size();
+    if (count > ~0u)
+    {
+        return {ErrorCategory::InvalidArgument, "Too many render items"};
+    }
+    for (const RenderItem& item : items)
+    {
+        if (item.node >= worlds.Size())
+        {
+            return {ErrorCategory::InvalidArgument, "A render item's node is out of range"};
+        }
+    }
+
+    // Mesh in the high half, so the sort groups by mesh first and by material within a mesh.
+    // Stable, so a draw's instances keep their item order.
+    DynamicArray<uint64> keys(GetTaggedAllocator(MemoryTag::Scene));
+    DynamicArray<uint32> order(GetTaggedAllocator(MemoryTag::Scene));
+    keys.ResizeUninitialized(count);
+    order.ResizeUninitialized(count);
+    for (uint64 i = 0; i < count; ++i)
+    {
+        keys[i] = (uint64(items[i].mesh) << 32) | items[i].material;
+        order[i] = static_cast<uint32>(i);
+    }
+    RadixSort(ArrayView<uint64>(keys), order, GetTaggedAllocator(MemoryTag::Scene));
+
+    m_nodes.ResizeUninitialized(count);
+    for (uint64 i = 0; i < count; ++i)
+    {
+        const RenderItem& item = items[order[i]];
+        m_nodes[i] = item.node;
+        if (i == 0 || keys[i] != keys[i - 1])
+        {
+            m_draws.PushBack({item.mesh, item.material, static_cast<uint32>(i), 0});
+        }
+        ++m_draws[m_draws.Size() - 1].instanceCount;
+    }
+
+    m_transforms.ResizeUninitialized(count);
+    UpdateTransforms(worlds);
+    return ResultCode::Success;
+}
+
+void RenderList::UpdateTransforms(ArrayView<const simd::float4x4> worlds)
+{
+    for (uint64 i = 0; i < m_nodes.Size(); ++i)
+    {
+        m_transforms[i] = simd::ToFloat3x4(worlds[m_nodes[i]]);
+    }
+}
+
+uint64 RenderList::UpdateTransforms(ArrayView<const simd::float4x4> worlds,
+                                    const DynamicBitSet& updated)
+{
+    uint64 changed = 0;
+    for (uint64 i = 0; i < m_nodes.Size(); ++i)
+    {
+        const uint32 node = m_nodes[i];
+        if (updated.Test(node))
+        {
+            m_transforms[i] = simd::ToFloat3x4(worlds[node]);
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+} // namespace rsbl
@@ -0,0 +1,117 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-render-list.h"
+#include "include/rsbl-scene-graph.h"
+
+using namespace rsbl;
+
+namespace
+{
+// A transform telling nodes apart by its translation
+simd::float4x4 Translated(float x)
+{
+    simd::float4x4 world = simd::Identity4x4();
+    world.columns[3] = simd::float4(x, 0.0f, 0.0f, 1.0f);
+    return world;
+}
+} // namespace
+
+TEST_SUITE("rsbl::RenderList")
+{
+    TEST_CASE("Items with the same mesh and material become one instanced draw")
+    {
+        simd::float4x4 worlds[6];
+        for (uint32 node = 0; node < 6; ++node)
+        {
+            worlds[node] = Translated(float(node));
+        }
+        // Mesh 4 twice with material 1 and once with 0, mesh 2 three times
+        const RenderItem items[6] = {
+            {4, 1, 0}, {2, 0, 1}, {4, 0, 2}, {2, 0, 3}, {4, 1, 4}, {2, 0, 5},
+        };
+
+        RenderList list;
+        REQUIRE(list.Build(items, worlds));
+        REQUIRE(list.Draws().Size() == 3);
+        REQUIRE(list.InstanceTransforms().Size() == 6);
+
+        // By mesh, then material, instances in item order
+        const InstancedDraw expected[3] = {{2, 0, 0, 3}, {4, 0, 3, 1}, {4, 1, 4, 2}};
+        const uint32 nodes[6] = {1, 3, 5, 2, 0, 4};
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            CHECK(list.Draws()[i].mesh == expected[i].mesh);
+            CHECK(list.Draws()[i].material == expected[i].material);
+            CHECK(list.Draws()[i].firstInstance == expected[i].firstInstance);
+            CHECK(list.Draws()[i].instanceCount == expected[i].instanceCount);
+        }
+        for (uint32 i = 0; i < 6; ++i)
+        {
+            CHECK(list.InstanceNodes()[i] == nodes[i]);
+            // Translation is the rows' w
+            CHECK(list.InstanceTransforms()[i].rows[0].W() == float(nodes[i]));
+        }
+    }
+
+    TEST_CASE("Transforms refresh from the scene graph's updates")
+    {
+        // A root with two children, each drawn with the same mesh, and the root with another
+        const uint32 parents[3] = {SceneGraph::kNoParent, 0, 0};
+        SceneTransform locals[3];
+        locals[1].translation = simd::float4(1.0f, 0.0f, 0.0f, 0.0f);
+        locals[2].translation = simd::float4(0.0f, 2.0f, 0.0f, 0.0f);
+        SceneGraph graph;
+        REQUIRE(graph.Build(parents, locals));
+        graph.UpdateWorldTransforms();
+
+        const RenderItem items[3] = {{7, 0, graph.NodeOf(1)},
+                                     {7, 0, graph.NodeOf(2)},
+                                     {3, 0, graph.NodeOf(0)}};
+        RenderList list;
+        REQUIRE(list.Build(items, graph.WorldTransforms()));
+        REQUIRE(list.Draws().Size() == 2);
+        CHECK(list.Draws()[1].instanceCount == 2);
+
+        // Nothing moved
+        graph.UpdateWorldTransforms();
+        CHECK(list.UpdateTransforms(graph.WorldTransforms(), graph.Updated()) == 0);
+
+        // Moving a child changes its instance alone, moving the root all three
+        SceneTransform moved = locals[2];
+        moved.translation = simd::float4(0.0f, 5.0f, 0.0f, 0.0f);
+        graph.SetLocal(graph.NodeOf(2), moved);
+        graph.UpdateWorldTransforms();
+        CHECK(list.UpdateTransforms(graph.WorldTransforms(), graph.Updated()) == 1);
+        CHECK(list.InstanceTransforms()[2].rows[1].W() == 5.0f);
+
+        SceneTransform root;
+        root.translation = simd::float4(0.0f, 0.0f, 10.0f, 0.0f);
+        graph.SetLocal(graph.NodeOf(0), root);
+        graph.UpdateWorldTransforms();
+        CHECK(list.UpdateTransforms(graph.WorldTransforms(), graph.Updated()) == 3);
+        for (const simd::float3x4& transform : list.InstanceTransforms())
+        {
+            CHECK(transform.rows[2].W() == 10.0f);
+        }
+        CHECK(list.InstanceTransforms()[1].rows[0].W() == 1.0f);
+    }
+
+    TEST_CASE("Nodes out of range are rejected")
+    {
+        const simd::float4x4 worlds[2] = {simd::Identity4x4(), simd::Identity4x4()};
+        const RenderItem items[2] = {{0, 0, 1}, {0, 0, 2}};
+
+        RenderList list;
+        CHECK(list.Build(items, worlds).Category() == ErrorCategory::InvalidArgument);
+        CHECK(list.Draws().IsEmpty());
+        CHECK(list.InstanceTransforms().IsEmpty());
+
+        // Empty is fine
+        REQUIRE(list.Build(ArrayView<const RenderItem>(), worlds));
+        CHECK(list.Draws().IsEmpty());
+    }
+}
@@ -0,0 +1,199 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-scene-graph.h"
+
+#include <rsbl-jobs.h>
+#include <rsbl-sort.h>
+
+#include <atomic>
+
+namespace rsbl
+{
+
+namespace
+{
+// Depths while Build works them out
+constexpr uint32 kDepthUnknown = ~0u;
+constexpr uint32 kDepthVisiting = ~0u - 1;
+} // namespace
+
+Result<> SceneGraph::Build(ArrayView<const uint32> parents, ArrayView<const SceneTransform> locals)
+{
+    MemoryTagScope memory_scope(MemoryTag::Scene);
+
+    m_nodes.Clear();
+    m_nodeOfInput.Clear();
+    m_levelOffsets.Clear();
+    m_dirty.Resize(0);
+    m_updated.Resize(0);
+
+    const uint64 count = parents.Size();
+    if (locals.Size() != count || count >= kNoParent)
+    {
+        return {ErrorCategory::InvalidArgument, "Need one local transform per parent"};
+    }
+
+    // Each node's depth, walking up from it to the first node whose depth is known and then
+    // back down, so every node is walked once. Meeting a node on the current walk is a cycle.
+    DynamicArray<uint32> depths(GetTaggedAllocator(MemoryTag::Scene));
+    depths.Resize(count);
+    for (uint32& depth : depths)
+    {
+        depth = kDepthUnknown;
+    }
+    DynamicArray<uint32> walk(GetTaggedAllocator(MemoryTag::Scene));
+    for (uint64 i = 0; i < count; ++i)
+    {
+        uint32 node = static_cast<uint32>(i);
+        while (node != kNoParent && depths[node] == kDepthUnknown)
+        {
+            depths[node] = kDepthVisiting;
+            walk.PushBack(node);
+            node = parents[node];
+            if (node != kNoParent && node >= count)
+            {
+                return {ErrorCategory::InvalidArgument, "A node's parent is out of range"};
+            }
+        }
+        if (node != kNoParent && depths[node] == kDepthVisiting)
+        {
+            return {ErrorCategory::InvalidArgument, "The nodes' parents make a cycle"};
+        }
+
+        uint32 depth = node == kNoParent ? 0 : depths[node] + 1;
+        for (uint64 j = walk.Size(); j > 0; --j)
+        {
+            depths[walk[j - 1]] = depth++;
+        }
+        walk.Clear();
+    }
+
+    // Stable, so nodes keep their input order within a level
+    DynamicArray<uint32> order(GetTaggedAllocator(MemoryTag::Scene));
+    order.ResizeUninitialized(count);
+    for (uint64 i = 0; i < count; ++i)
+    {
+        order[i] = static_cast<uint32>(i);
+    }
+    DynamicArray<uint32> sorted_depths = depths;
+    RadixSort(ArrayView<uint32>(sorted_depths), order, GetTaggedAllocator(MemoryTag::Scene));
+
+    m_nodeOfInput.ResizeUninitialized(count);
+    for (uint64 node = 0; node < count; ++node)
+    {
+        m_nodeOfInput[order[node]] = static_cast<uint32>(node);
+    }
+
+    m_nodes.Reserve(count);
+    for (uint64 node = 0; node < count; ++node)
+    {
+        const uint32 input = order[node];
+        const uint32 parent =
+            parents[input] == kNoParent ? kNoParent : m_nodeOfInput[parents[input]];
+        m_nodes.PushBack(parent, locals[input], simd::Identity4x4(), input);
+
+        if (node == 0 || sorted_depths[node] != sorted_depths[node - 1])
+        {
+            m_levelOffsets.PushBack(static_cast<uint32>(node));
+        }
+    }
+    m_levelOffsets.PushBack(static_cast<uint32>(count));
+
+    m_dirty.Resize(count, true);
+    m_updated.Resize(count);
+    return ResultCode::Success;
+}
+
+void SceneGraph::UpdateRange(uint64 begin, uint64 end)
+{
+    const uint32* parents = m_nodes.Data<kParent>();
+    const SceneTransform* locals = m_nodes.Data<kLocal>();
+    simd::float4x4* worlds = m_nodes.Data<kWorld>();
+    uint64* updated = m_updated.Words();
+
+    // The word the range starts in can hold the level before's last bits, which other chunks
+    // read, so words are read and written atomically. New bits gather here and go out a word
+    // at a time.
+    constexpr uint64 kWordBits = Internal::kBitsPerWord;
+    uint64 word = begin / kWordBits;
+    uint64 pending = 0;
+    for (uint64 node = begin; node < end; ++node)
+    {
+        if (node / kWordBits != word)
+        {
+            if (pending != 0)
+            {
+                std::atomic_ref<uint64>(updated[word]).fetch_or(pending, std::memory_order_relaxed);
+                pending = 0;
+            }
+            word = node / kWordBits;
+        }
+
+        const uint32 parent = parents[node];
+        bool parent_updated = false;
+        if (parent != kNoParent)
+        {
+            const uint64 parent_index = parent / kWordBits;
+            uint64 parent_word =
+                std::atomic_ref<uint64>(updated[parent_index]).load(std::memory_order_relaxed);
+            if (parent_index == word)
+            {
+                parent_word |= pending;
+            }
+            parent_updated = (parent_word >> (parent % kWordBits)) & 1;
+        }
+        if (!parent_updated && !m_dirty.Test(node))
+        {
+            continue;
+        }
+
+        const SceneTransform& local = locals[node];
+        const simd::float4x4 matrix =
+            simd::ComposeTrs(local.translation, local.rotation, local.scale);
+        worlds[node] = parent == kNoParent ? matrix : worlds[parent] * matrix;
+        pending |= uint64(1) << (node % kWordBits);
+    }
+    if (pending != 0)
+    {
+        std::atomic_ref<uint64>(updated[word]).fetch_or(pending, std::memory_order_relaxed);
+    }
+}
+
+void SceneGraph::UpdateWorldTransforms()
+{
+    m_updated.ResetAll();
+    UpdateRange(0, m_nodes.Size());
+    m_dirty.ResetAll();
+}
+
+void SceneGraph::UpdateWorldTransforms(JobSystem& jobs, uint64 grain)
+{
+    // Chunks are split on whole words of m_updated, so threads only ever share the word where
+    // a level starts. The levels before are done by then, ParallelFor waits for its chunks.
+    const uint64 grain_words = grain > Internal::kBitsPerWord ? grain / Internal::kBitsPerWord : 1;
+
+    m_updated.ResetAll();
+    for (uint32 level = 0; level < LevelCount(); ++level)
+    {
+        const uint64 begin = m_levelOffsets[level];
+        const uint64 end = m_levelOffsets[level + 1];
+        if (end - begin <= grain)
+        {
+            UpdateRange(begin, end);
+            continue;
+        }
+
+        jobs.ParallelFor(begin / Internal::kBitsPerWord,
+                         (end + Internal::kBitsPerWord - 1) / Internal::kBitsPerWord,
+                         grain_words,
+                         [this, begin, end](uint64 first_word, uint64 end_word) {
+                             const uint64 first = first_word * Internal::kBitsPerWord;
+                             const uint64 last = end_word * Internal::kBitsPerWord;
+                             UpdateRange(first > begin ? first : begin, last < end ? last : end);
+                         });
+    }
+    m_dirty.ResetAll();
+}
+
+} // namespace rsbl
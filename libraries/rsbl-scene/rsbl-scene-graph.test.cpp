@@ -0,0 +1,260 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-scene-graph.h"
+
+#include <rsbl-jobs.h>
+
+#include <cmath>
+
+using namespace rsbl;
+
+namespace
+{
+struct Random
+{
+    uint64 state = 1;
+
+    // [0, 1)
+    float Next()
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<float>(state >> 40) / static_cast<float>(1 << 24);
+    }
+};
+
+SceneTransform RandomTransform(Random& random)
+{
+    SceneTransform transform;
+    const float x = random.Next() * 4.0f - 2.0f;
+    const float y = random.Next() * 4.0f - 2.0f;
+    transform.translation = simd::float4(x, y, random.Next(), 0.0f);
+    const simd::float4 axis = simd::Normalize3(
+        simd::float4(random.Next() - 0.5f, random.Next() - 0.5f, random.Next() + 0.1f, 0.0f));
+    transform.rotation = simd::QuatFromAxisAngle(axis, random.Next() * 3.0f);
+    const float scale = 0.5f + random.Next();
+    transform.scale = simd::float4(scale, scale, scale, 0.0f);
+    return transform;
+}
+
+// A random forest with parents anywhere in the inputs, before or after their children
+void MakeForest(uint32 count, uint64 seed, DynamicArray<uint32>& parents,
+                DynamicArray<SceneTransform>& locals)
+{
+    Random random{seed};
+    // Built with parents first, then shuffled so they aren't
+    DynamicArray<uint32> ordered;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        ordered.PushBack(i < 4 || random.Next() < 0.01f ? SceneGraph::kNoParent
+                                                        : uint32(random.Next() * float(i)));
+    }
+    DynamicArray<uint32> position;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        position.PushBack(i);
+    }
+    for (uint32 i = count - 1; i > 0; --i)
+    {
+        const uint32 j = uint32(random.Next() * float(i + 1));
+        const uint32 swap = position[i];
+        position[i] = position[j];
+        position[j] = swap;
+    }
+
+    parents.Resize(count);
+    locals.Resize(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        parents[position[i]] =
+            ordered[i] == SceneGraph::kNoParent ? SceneGraph::kNoParent : position[ordered[i]];
+        locals[position[i]] = RandomTransform(random);
+    }
+}
+
+// The world transform of an input node, the slow way up its ancestors
+simd::float4x4 ReferenceWorld(ArrayView<const uint32> parents,
+                              ArrayView<const SceneTransform> locals, uint32 input)
+{
+    simd::float4x4 world = simd::Identity4x4();
+    for (uint32 node = input; node != SceneGraph::kNoParent; node = parents[node])
+    {
+        const SceneTransform& local = locals[node];
+        world = simd::ComposeTrs(local.translation, local.rotation, local.scale) * world;
+    }
+    return world;
+}
+
+bool NearlyEqual(const simd::float4x4& a, const simd::float4x4& b)
+{
+    for (uint32 c = 0; c < 4; ++c)
+    {
+        const simd::float4 difference = a.columns[c] - b.columns[c];
+        if (simd::Dot4(difference, difference) > 1e-6f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every node's world transform matches the reference
+bool MatchesReference(const SceneGraph& graph, ArrayView<const uint32> parents,
+                      ArrayView<const SceneTransform> locals)
+{
+    for (uint32 input = 0; input < parents.Size(); ++input)
+    {
+        const simd::float4x4& world = graph.WorldTransforms()[graph.NodeOf(input)];
+        if (!NearlyEqual(world, ReferenceWorld(parents, locals, input)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+TEST_SUITE("rsbl::SceneGraph")
+{
+    TEST_CASE("Nodes are sorted by depth, parents first")
+    {
+        // 0 <- 3 <- 1, 2 a root, 4 <- 0
+        const uint32 parents[5] = {4, 3, SceneGraph::kNoParent, 0, SceneGraph::kNoParent};
+        SceneTransform locals[5];
+        for (uint32 i = 0; i < 5; ++i)
+        {
+            locals[i].translation = simd::float4(float(i + 1), 0.0f, 0.0f, 0.0f);
+        }
+
+        SceneGraph graph;
+        REQUIRE(graph.Build(parents, locals));
+        CHECK(graph.NodeCount() == 5);
+
+        // Roots in input order, then a level per depth
+        REQUIRE(graph.LevelCount() == 4);
+        const uint32 offsets[5] = {0, 2, 3, 4, 5};
+        for (uint32 i = 0; i < 5; ++i)
+        {
+            CHECK(graph.LevelOffsets()[i] == offsets[i]);
+        }
+        const uint32 inputs[5] = {2, 4, 0, 3, 1};
+        for (uint32 node = 0; node < 5; ++node)
+        {
+            CHECK(graph.InputOf(node) == inputs[node]);
+            CHECK(graph.NodeOf(inputs[node]) == node);
+            const uint32 parent = graph.Parents()[node];
+            CHECK((parent == SceneGraph::kNoParent || parent < node));
+        }
+        CHECK(graph.Parents()[graph.NodeOf(1)] == graph.NodeOf(3));
+
+        graph.UpdateWorldTransforms();
+        CHECK(graph.Updated().Count() == 5);
+        // Translations add up the chain: 1 is under 3, 0 and 4
+        const simd::float4x4& world = graph.WorldTransforms()[graph.NodeOf(1)];
+        CHECK(world.columns[3].X() == doctest::Approx(2.0f + 4.0f + 1.0f + 5.0f));
+        CHECK(MatchesReference(graph, parents, locals));
+    }
+
+    TEST_CASE("Only dirty nodes and what's under them update")
+    {
+        DynamicArray<uint32> parents;
+        DynamicArray<SceneTransform> locals;
+        MakeForest(500, 3, parents, locals);
+
+        SceneGraph graph;
+        REQUIRE(graph.Build(parents, locals));
+        graph.UpdateWorldTransforms();
+        CHECK(graph.Updated().Count() == 500);
+        CHECK(MatchesReference(graph, parents, locals));
+
+        // Nothing changed, nothing to do
+        graph.UpdateWorldTransforms();
+        CHECK(graph.Updated().None());
+
+        // A node with children, found in the inputs
+        uint32 moved = 0;
+        while (parents[moved] == SceneGraph::kNoParent)
+        {
+            ++moved;
+        }
+        moved = parents[moved];
+        Random random{7};
+        locals[moved] = RandomTransform(random);
+        graph.SetLocal(graph.NodeOf(moved), locals[moved]);
+        graph.UpdateWorldTransforms();
+        CHECK(MatchesReference(graph, parents, locals));
+
+        // Exactly the node and its descendants
+        for (uint32 input = 0; input < 500; ++input)
+        {
+            bool below = false;
+            for (uint32 node = input; node != SceneGraph::kNoParent; node = parents[node])
+            {
+                below = below || node == moved;
+            }
+            CHECK(graph.Updated().Test(graph.NodeOf(input)) == below);
+        }
+        CHECK(graph.Updated().Count() > 1);
+    }
+
+    TEST_CASE("Updating level by level on jobs gives the same transforms")
+    {
+        DynamicArray<uint32> parents;
+        DynamicArray<SceneTransform> locals;
+        MakeForest(20000, 11, parents, locals);
+
+        JobSystemOptions options;
+        options.workerCount = 3;
+        Result<UniquePtr<JobSystem>> jobs = JobSystem::Create(options);
+        REQUIRE(jobs);
+
+        SceneGraph graph;
+        REQUIRE(graph.Build(parents, locals));
+        // A small grain so even the narrow levels split, with chunks not starting on a word
+        graph.UpdateWorldTransforms(*jobs.Value(), 100);
+        CHECK(graph.Updated().Count() == 20000);
+        CHECK(MatchesReference(graph, parents, locals));
+
+        // A scattering of changes, compared against the single threaded update
+        SceneGraph serial;
+        REQUIRE(serial.Build(parents, locals));
+        serial.UpdateWorldTransforms();
+        Random random{5};
+        for (uint32 i = 0; i < 40; ++i)
+        {
+            const uint32 input = uint32(random.Next() * 20000.0f);
+            locals[input] = RandomTransform(random);
+            graph.SetLocal(graph.NodeOf(input), locals[input]);
+            serial.SetLocal(serial.NodeOf(input), locals[input]);
+        }
+        graph.UpdateWorldTransforms(*jobs.Value(), 100);
+        serial.UpdateWorldTransforms();
+        CHECK(graph.Updated() == serial.Updated());
+        CHECK(MatchesReference(graph, parents, locals));
+    }
+
+    TEST_CASE("Bad hierarchies are rejected")
+    {
+        SceneTransform locals[3];
+        SceneGraph graph;
+
+        const uint32 out_of_range[3] = {SceneGraph::kNoParent, 5, 0};
+        CHECK(graph.Build(out_of_range, locals).Category() == ErrorCategory::InvalidArgument);
+        CHECK(graph.NodeCount() == 0);
+
+        const uint32 cycle[3] = {SceneGraph::kNoParent, 2, 1};
+        CHECK_FALSE(graph.Build(cycle, locals));
+        const uint32 own_parent[3] = {0, SceneGraph::kNoParent, SceneGraph::kNoParent};
+        CHECK_FALSE(graph.Build(own_parent, locals));
+
+        CHECK_FALSE(graph.Build(ArrayView<const uint32>(cycle, 2), locals));
+
+        // Empty is fine
+        REQUIRE(graph.Build(ArrayView<const uint32>(), ArrayView<const SceneTransform>()));
+        CHECK(graph.LevelCount() == 0);
+        graph.UpdateWorldTransforms();
+    }
+}
@@ -0,0 +1,58 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "include/rsbl-skin.h"
+
+#include <rsbl-assert.h>
+
+#include <cmath>
+
+namespace rsbl
+{
+
+void BuildSkinningPalette(ArrayView<const simd::float4x4> worlds, ArrayView<const uint32> joints,
+                          ArrayView<const simd::float4x4> inverse_binds, ArrayView<float> palette)
+{
+    rsblAssert(joints.Size() == inverse_binds.Size());
+    rsblAssert(palette.Size() == joints.Size() * kSkinningPaletteFloats);
+
+    float* out = palette.Data();
+    for (uint64 j = 0; j < joints.Size(); ++j)
+    {
+        // Rows are the transpose's columns
+        const simd::float4x4 rows = simd::Transpose(worlds[joints[j]] * inverse_binds[j]);
+        simd::StoreUnaligned(rows.columns[0], out);
+        simd::StoreUnaligned(rows.columns[1], out + 4);
+        simd::StoreUnaligned(rows.columns[2], out + 8);
+        out += kSkinningPaletteFloats;
+    }
+}
+
+void PackSkinWeights(const float weights[4], uint16 codes[4])
+{
+    float sum = 0.0f;
+    uint32 heaviest = 0;
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        sum += weights[i] > 0.0f ? weights[i] : 0.0f;
+        heaviest = weights[i] > weights[heaviest] ? i : heaviest;
+    }
+    if (!(sum > 0.0f))
+    {
+        codes[0] = 65535;
+        codes[1] = codes[2] = codes[3] = 0;
+        return;
+    }
+
+    int32 total = 0;
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        const float weight = weights[i] > 0.0f ? weights[i] / sum : 0.0f;
+        codes[i] = static_cast<uint16>(lrintf(weight * 65535.0f));
+        total += codes[i];
+    }
+    // Rounding is off by a code or two at most, which the heaviest joint can always take
+    codes[heaviest] = static_cast<uint16>(codes[heaviest] + (65535 - total));
+}
+
+} // namespace rsbl
@@ -0,0 +1,110 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-skin.h"
+
+using namespace rsbl;
+
+namespace
+{
+// A point skinned the way the skinning shader does it: the weighted sum of the joints' rows
+simd::float4 SkinPoint(ArrayView<const float> palette, const uint16 joints[4],
+                       const uint16 codes[4], simd::float4 point)
+{
+    simd::float4 rows[3] = {simd::float4(0.0f), simd::float4(0.0f), simd::float4(0.0f)};
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        const float weight = static_cast<float>(codes[i]) / 65535.0f;
+        const float* entry = palette.Data() + joints[i] * kSkinningPaletteFloats;
+        for (uint32 r = 0; r < 3; ++r)
+        {
+            rows[r] = rows[r] + weight * simd::LoadUnaligned(entry + r * 4);
+        }
+    }
+    const simd::float4 p = simd::SetW(point, 1.0f);
+    return simd::float4(simd::Dot4(rows[0], p), simd::Dot4(rows[1], p), simd::Dot4(rows[2], p),
+                        0.0f);
+}
+} // namespace
+
+TEST_SUITE("rsbl::Skin")
+{
+    TEST_CASE("Palette entries are world times inverse bind, as rows")
+    {
+        const simd::float4 y_axis(0.0f, 1.0f, 0.0f, 0.0f);
+        simd::float4x4 worlds[3];
+        worlds[0] = simd::Identity4x4();
+        worlds[1] = simd::ComposeTrs(simd::float4(1.0f, 2.0f, 3.0f, 0.0f),
+                                     simd::QuatFromAxisAngle(y_axis, 0.5f),
+                                     simd::float4(2.0f, 2.0f, 2.0f, 0.0f));
+        worlds[2] = simd::ComposeTrs(simd::float4(0.0f, 5.0f, 0.0f, 0.0f), simd::QuatIdentity(),
+                                     simd::float4(1.0f, 1.0f, 1.0f, 0.0f));
+
+        // Joint 0 is node 2, joint 1 is node 1
+        const uint32 joints[2] = {2, 1};
+        simd::float4x4 inverse_binds[2];
+        inverse_binds[0] = simd::InverseAffine(worlds[2]);
+        inverse_binds[1] = simd::Identity4x4();
+
+        float palette[2 * kSkinningPaletteFloats];
+        BuildSkinningPalette(worlds, joints, inverse_binds, palette);
+
+        // Joint 0 is still at its bind pose, so its matrix is the identity
+        for (uint32 r = 0; r < 3; ++r)
+        {
+            for (uint32 c = 0; c < 4; ++c)
+            {
+                CHECK(palette[r * 4 + c] == doctest::Approx(r == c ? 1.0f : 0.0f));
+            }
+        }
+        // Joint 1's rows are node 1's world matrix
+        const simd::float4 point(0.5f, -1.0f, 2.0f, 1.0f);
+        const simd::float4 expected = simd::TransformPoint(worlds[1], point);
+        const float* rows = palette + kSkinningPaletteFloats;
+        CHECK(simd::Dot4(simd::LoadUnaligned(rows), point) == doctest::Approx(expected.X()));
+        CHECK(simd::Dot4(simd::LoadUnaligned(rows + 4), point) == doctest::Approx(expected.Y()));
+        CHECK(simd::Dot4(simd::LoadUnaligned(rows + 8), point) == doctest::Approx(expected.Z()));
+
+        // Half on each joint lands halfway between where each would put it
+        const uint16 both[4] = {0, 1, 0, 0};
+        const float halves[4] = {1.0f, 1.0f, 0.0f, 0.0f};
+        uint16 codes[4];
+        PackSkinWeights(halves, codes);
+        const simd::float4 skinned = SkinPoint(palette, both, codes, point);
+        const simd::float4 midpoint = 0.5f * (point + expected);
+        CHECK(skinned.X() == doctest::Approx(midpoint.X()).epsilon(1e-4));
+        CHECK(skinned.Y() == doctest::Approx(midpoint.Y()).epsilon(1e-4));
+        CHECK(skinned.Z() == doctest::Approx(midpoint.Z()).epsilon(1e-4));
+    }
+
+    TEST_CASE("Packed weights always sum to one")
+    {
+        const float cases[][4] = {
+            {1.0f, 0.0f, 0.0f, 0.0f},
+            {1.0f, 1.0f, 1.0f, 0.0f},
+            {0.1f, 0.2f, 0.3f, 0.4f},
+            {3.0f, 3.0f, 3.0f, 3.0f},
+            {0.7f, 0.0f, -0.2f, 0.6f},
+            {0.0f, 0.0f, 0.0f, 0.0f},
+        };
+        for (const auto& weights : cases)
+        {
+            uint16 codes[4];
+            PackSkinWeights(weights, codes);
+            CHECK(codes[0] + codes[1] + codes[2] + codes[3] == 65535);
+        }
+
+        uint16 codes[4];
+        PackSkinWeights(cases[1], codes);
+        CHECK(codes[0] == 21845);
+        CHECK(codes[3] == 0);
+        PackSkinWeights(cases[4], codes);
+        CHECK(codes[2] == 0);
+        CHECK(codes[0] > codes[3]);
+        PackSkinWeights(cases[5], codes);
+        CHECK(codes[0] == 65535);
+    }
+}
@@ -0,0 +1,79 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#include "rsbl-visibility-cache.h"
+
+#include "rsbl-bvh.h"
+
+#include <cstring>
+
+namespace rsbl
+{
+
+void VisibilityCache::Reset()
+{
+    m_tested = false;
+    m_inFrustum.Clear();
+    m_visible.Clear();
+    m_lastVisible.Clear();
+    m_disoccluded.Clear();
+}
+
+VisibilityUpdate VisibilityCache::Update(const Frustum& frustum,
+                                         ArrayView<const Aabb> bounds,
+                                         const DynamicBitSet& moved,
+                                         const Bvh* bvh)
+{
+    VisibilityUpdate update;
+    const uint64 count = bounds.Size();
+    update.viewChanged = !m_tested || m_inFrustum.Size() != count ||
+                         std::memcmp(&frustum, &m_frustum, sizeof(Frustum)) != 0;
+
+    if (update.viewChanged)
+    {
+        if (bvh != nullptr && bvh->ObjectCount() == count)
+        {
+            bvh->CullFrustum(frustum, m_inFrustum);
+        }
+        else
+        {
+            m_inFrustum.Resize(count);
+            for (uint64 i = 0; i < count; ++i)
+            {
+                m_inFrustum.Set(i, Intersects(frustum, bounds[i]));
+            }
+        }
+        update.tested = count;
+        m_frustum = frustum;
+        m_tested = true;
+    }
+    else
+    {
+        for (const uint64 object : moved.SetBits())
+        {
+            if (object >= count)
+            {
+                break;
+            }
+            m_inFrustum.Set(object, Intersects(frustum, bounds[object]));
+            ++update.tested;
+        }
+    }
+
+    // Objects added since SetVisible weren't visible
+    m_visible.Resize(count);
+    m_lastVisible = m_inFrustum;
+    m_lastVisible.And(m_visible);
+    m_disoccluded = m_inFrustum;
+    m_disoccluded.AndNot(m_visible);
+    return update;
+}
+
+void VisibilityCache::SetVisible(const DynamicBitSet& visible)
+{
+    m_visible = visible;
+    m_visible.Resize(m_inFrustum.Size());
+    m_visible.And(m_inFrustum);
+}
+
+} // namespace rsbl
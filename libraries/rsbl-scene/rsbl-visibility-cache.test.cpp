@@ -0,0 +1,176 @@
+// Copyright 2025 Robert Srinivasiah
+// Licensed under the MIT License, see the LICENSE file for more info
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "include/rsbl-bvh.h"
+#include "include/rsbl-visibility-cache.h"
+
+using namespace rsbl;
+
+namespace
+{
+// The box from minX to maxX on x, and -10 to 10 on y and z
+Frustum BoxFrustum(float minX, float maxX)
+{
+    Frustum frustum;
+    frustum.planes[Frustum::kLeft] = {float3{1.0f, 0.0f, 0.0f}, -minX};
+    frustum.planes[Frustum::kRight] = {float3{-1.0f, 0.0f, 0.0f}, maxX};
+    frustum.planes[Frustum::kBottom] = {float3{0.0f, 1.0f, 0.0f}, 10.0f};
+    frustum.planes[Frustum::kTop] = {float3{0.0f, -1.0f, 0.0f}, 10.0f};
+    frustum.planes[Frustum::kNear] = {float3{0.0f, 0.0f, 1.0f}, 10.0f};
+    frustum.planes[Frustum::kFar] = {float3{0.0f, 0.0f, -1.0f}, 10.0f};
+    return frustum;
+}
+
+// A unit box centered at x on the x axis
+Aabb BoxAt(float x)
+{
+    return Aabb{float3{x - 0.5f, -0.5f, -0.5f}, float3{x + 0.5f, 0.5f, 0.5f}};
+}
+
+// Objects every 4 units from x = 0
+DynamicArray<Aabb> Row(uint32 count)
+{
+    DynamicArray<Aabb> bounds;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        bounds.PushBack(BoxAt(4.0f * float(i)));
+    }
+    return bounds;
+}
+} // namespace
+
+TEST_SUITE("rsbl::VisibilityCache")
+{
+    TEST_CASE("A view that doesn't change only tests what moved")
+    {
+        DynamicArray<Aabb> bounds = Row(10); // x = 0 to 36
+        const Frustum frustum = BoxFrustum(-10.0f, 10.0f);
+        DynamicBitSet moved;
+
+        VisibilityCache cache;
+        VisibilityUpdate update = cache.Update(frustum, bounds, moved);
+        CHECK(update.viewChanged);
+        CHECK(update.tested == 10);
+        CHECK(cache.InFrustum().Count() == 3); // 0, 4 and 8
+
+        update = cache.Update(frustum, bounds, moved);
+        CHECK_FALSE(update.viewChanged);
+        CHECK(update.tested == 0);
+        CHECK(cache.InFrustum().Count() == 3);
+
+        // Object 1 leaves, object 9 comes in
+        bounds[1] = BoxAt(50.0f);
+        bounds[9] = BoxAt(-4.0f);
+        moved.Resize(10);
+        moved.Set(1);
+        moved.Set(9);
+        update = cache.Update(frustum, bounds, moved);
+        CHECK_FALSE(update.viewChanged);
+        CHECK(update.tested == 2);
+        CHECK(cache.InFrustum().Test(0));
+        CHECK_FALSE(cache.InFrustum().Test(1));
+        CHECK(cache.InFrustum().Test(2));
+        CHECK(cache.InFrustum().Test(9));
+        CHECK(cache.InFrustum().Count() == 3);
+    }
+
+    TEST_CASE("A view that changes tests everything, with or without a BVH")
+    {
+        const DynamicArray<Aabb> bounds = Row(200);
+        Bvh bvh;
+        bvh.Build(bounds);
+        DynamicBitSet moved;
+
+        VisibilityCache cache;
+        VisibilityCache withBvh;
+        for (float x = 0.0f; x < 600.0f; x += 37.0f)
+        {
+            const Frustum frustum = BoxFrustum(x, x + 50.0f);
+            const VisibilityUpdate update = cache.Update(frustum, bounds, moved);
+            const VisibilityUpdate bvhUpdate = withBvh.Update(frustum, bounds, moved, &bvh);
+            CHECK(update.viewChanged);
+            CHECK(update.tested == 200);
+            CHECK(bvhUpdate.tested == 200);
+            CHECK(cache.InFrustum() == withBvh.InFrustum());
+            for (uint32 i = 0; i < 200; ++i)
+            {
+                CHECK(cache.InFrustum().Test(i) == Intersects(frustum, bounds[i]));
+            }
+        }
+    }
+
+    TEST_CASE("Last frame's visible objects are phase one, the rest in the frustum phase two")
+    {
+        DynamicArray<Aabb> bounds = Row(5); // x = 0 to 16
+        const Frustum frustum = BoxFrustum(-10.0f, 10.0f);
+        DynamicBitSet moved;
+
+        // Nothing's been seen yet, so the first frame is all phase two
+        VisibilityCache cache;
+        cache.Update(frustum, bounds, moved);
+        CHECK(cache.LastVisible().None());
+        CHECK(cache.Disoccluded().Count() == 3);
+
+        // Object 1 was hidden behind object 0. Object 4 is out of the frustum, so it doesn't
+        // count however visible it's said to be.
+        DynamicBitSet visible(5);
+        visible.Set(0);
+        visible.Set(2);
+        visible.Set(4);
+        cache.SetVisible(visible);
+
+        cache.Update(frustum, bounds, moved);
+        CHECK(cache.LastVisible().Count() == 2);
+        CHECK(cache.LastVisible().Test(0));
+        CHECK(cache.LastVisible().Test(2));
+        CHECK(cache.Disoccluded().Count() == 1);
+        CHECK(cache.Disoccluded().Test(1));
+
+        // Object 4 comes into view, and is tested against the depth
+        bounds[4] = BoxAt(6.0f);
+        moved.Resize(5);
+        moved.Set(4);
+        cache.Update(frustum, bounds, moved);
+        CHECK(cache.LastVisible().Count() == 2);
+        CHECK(cache.Disoccluded().Count() == 2);
+        CHECK(cache.Disoccluded().Test(4));
+
+        // Object 2 leaves the frustum, and with it both phases
+        bounds[2] = BoxAt(-50.0f);
+        moved.ResetAll();
+        moved.Set(2);
+        cache.Update(frustum, bounds, moved);
+        CHECK(cache.LastVisible().Count() == 1);
+        CHECK_FALSE(cache.Disoccluded().Test(2));
+    }
+
+    TEST_CASE("New objects and Reset test everything again")
+    {
+        DynamicArray<Aabb> bounds = Row(3);
+        const Frustum frustum = BoxFrustum(-10.0f, 10.0f);
+        DynamicBitSet moved;
+
+        VisibilityCache cache;
+        cache.Update(frustum, bounds, moved);
+        cache.SetVisible(cache.InFrustum());
+
+        // The new object wasn't seen last frame
+        bounds.PushBack(BoxAt(2.0f));
+        VisibilityUpdate update = cache.Update(frustum, bounds, moved);
+        CHECK(update.viewChanged);
+        CHECK(update.tested == 4);
+        CHECK(cache.LastVisible().Count() == 3);
+        CHECK(cache.Disoccluded().Count() == 1);
+        CHECK(cache.Disoccluded().Test(3));
+
+        cache.Reset();
+        update = cache.Update(frustum, bounds, moved);
+        CHECK(update.viewChanged);
+        CHECK(update.tested == 4);
+        CHECK(cache.LastVisible().None());
+        CHECK(cache.Disoccluded().Count() == 4);
+    }
+}
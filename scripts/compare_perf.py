@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+# Copyright 2025 Robert Srinivasiah
+# Licensed under the MIT License, see the LICENSE file for more info
+
+"""
+Compare two runs of a benchmark and flag the metrics that got worse.
+
+Reads the JSON every rsbl benchmark writes (see libraries/rsbl-bench/include/rsbl-perf-report.h):
+micro-benchmarks with --json, gltf-load-bench with --report and gltf-viewer --benchmark with
+--report. Each side is a report, or a directory of reports of the same suite, whose samples are
+pooled: several runs of the baseline make its noise easier to tell from a change.
+
+A metric regressed when its median moved the wrong way by more than --threshold percent and a
+Mann-Whitney U test on the samples says the move is significant at --alpha. Metrics with a single
+value, like peak bytes, have nothing to test and only go by the threshold.
+
+    python scripts/compare_perf.py main.json branch.json
+    python scripts/compare_perf.py runs/main/ runs/branch/ --threshold 2 --alpha 0.05
+
+Exits 1 when anything regressed, 2 when the reports can't be compared.
+"""
+
+import argparse
+import json
+import math
+import sys
+from pathlib import Path
+
+SCHEMA_PREFIX = "rsbl-perf/"
+SCHEMA_VERSION = 1
+
+# Below this many samples on both sides with no ties, p-values are exact rather than the normal
+# approximation's
+EXACT_LIMIT = 30
+
+
+# ANSI color codes, off when the output isn't a terminal
+class Colors:
+    CYAN = '\033[0;36m'
+    GREEN = '\033[0;32m'
+    YELLOW = '\033[0;33m'
+    RED = '\033[0;31m'
+    GRAY = '\033[0;90m'
+    NC = '\033[0m'  # No Color
+
+
+if not sys.stdout.isatty():
+    for name in ('CYAN', 'GREEN', 'YELLOW', 'RED', 'GRAY', 'NC'):
+        setattr(Colors, name, '')
+
+
+class CompareError(Exception):
+    pass
+
+
+def load_report(path):
+    """Load one report, checking it's a schema this script knows."""
+    try:
+        with open(path, encoding='utf-8') as file:
+            report = json.load(file)
+    except (OSError, json.JSONDecodeError) as e:
+        raise CompareError(f"{path}: {e}")
+
+    schema = report.get('schema', '')
+    if not schema.startswith(SCHEMA_PREFIX):
+        raise CompareError(f"{path}: not an rsbl benchmark report")
+    version = int(schema[len(SCHEMA_PREFIX):])
+    if version > SCHEMA_VERSION:
+        raise CompareError(f"{path}: schema {schema} is newer than this script")
+    return report
+
+
+def load_side(path):
+    """A report, or every report in a directory, with their metrics' samples pooled."""
+    path = Path(path)
+    paths = sorted(path.glob('*.json')) if path.is_dir() else [path]
+    if not paths:
+        raise CompareError(f"{path}: no reports in it")
+
+    reports = [load_report(p) for p in paths]
+    suites = {r['suite'] for r in reports}
+    if len(suites) > 1:
+        raise CompareError(f"{path}: reports of more than one suite: {', '.join(sorted(suites))}")
+
+    metrics = {}
+    for report in reports:
+        for metric in report['metrics']:
+            pooled = metrics.get(metric['name'])
+            if pooled is None:
+                pooled = metrics[metric['name']] = dict(metric, samples=[], values=[])
+            pooled['samples'].extend(metric['samples'])
+            pooled['values'].append(metric['value'])
+
+    return {
+        'suite': reports[0]['suite'],
+        'kind': reports[0].get('kind', ''),
+        'machine': reports[0].get('machine', {}),
+        'smoke': any(r.get('config', {}).get('smoke', False) for r in reports),
+        'runs': len(reports),
+        'metrics': metrics,
+    }
+
+
+def median(values):
+    ordered = sorted(values)
+    middle = len(ordered) // 2
+    if len(ordered) % 2 == 1:
+        return ordered[middle]
+    return (ordered[middle - 1] + ordered[middle]) / 2
+
+
+def ranks(values):
+    """Ranks from 1, ties sharing the mean of theirs. Returns the ranks and each tie's size."""
+    order = sorted(range(len(values)), key=lambda i: values[i])
+    result = [0.0] * len(values)
+    ties = []
+    i = 0
+    while i < len(order):
+        j = i
+        while j + 1 < len(order) and values[order[j + 1]] == values[order[i]]:
+            j += 1
+        for k in range(i, j + 1):
+            result[order[k]] = (i + j) / 2 + 1
+        if j > i:
+            ties.append(j - i + 1)
+        i = j + 1
+    return result, ties
+
+
+def exact_u_distribution(n1, n2):
+    """How many of the orderings of n1 and n2 samples give each U, with no ties."""
+    # counts[m][u] for the first m of sample one against all n2, built up one sample at a time
+    counts = [[1] + [0] * (n1 * n2) for _ in range(n2 + 1)]
+    for m in range(1, n1 + 1):
+        previous = counts
+        counts = [[0] * (n1 * n2 + 1) for _ in range(n2 + 1)]
+        counts[0][0] = 1
+        for n in range(1, n2 + 1):
+            for u in range(m * n + 1):
+                below = previous[n][u - n] if u >= n else 0
+                counts[n][u] = below + counts[n - 1][u]
+    return counts[n2]
+
+
+def mann_whitney_p(a, b):
+    """Two-sided p-value of a Mann-Whitney U test that a and b come from the same distribution."""
+    n1, n2 = len(a), len(b)
+    all_ranks, ties = ranks(list(a) + list(b))
+    u1 = sum(all_ranks[:n1]) - n1 * (n1 + 1) / 2
+
+    if not ties and n1 + n2 <= EXACT_LIMIT:
+        distribution = exact_u_distribution(n1, n2)
+        total = sum(distribution)
+        u = int(round(u1))
+        lower = sum(distribution[:u + 1]) / total
+        upper = sum(distribution[u:]) / total
+        return min(1.0, 2 * min(lower, upper))
+
+    n = n1 + n2
+    mean = n1 * n2 / 2
+    tie_term = sum(t ** 3 - t for t in ties) / (n * (n - 1))
+    variance = n1 * n2 / 12 * ((n + 1) - tie_term)
+    if variance <= 0:
+        return 1.0
+    # Continuity corrected
+    z = (abs(u1 - mean) - 0.5) / math.sqrt(variance)
+    return min(1.0, math.erfc(max(z, 0.0) / math.sqrt(2)))
+
+
+def format_value(value, unit):
+    if unit == 'bytes':
+        for scale, suffix in ((1 << 30, 'GB'), (1 << 20, 'MB'), (1 << 10, 'KB')):
+            if abs(value) >= scale:
+                return f"{value / scale:.2f} {suffix}"
+        return f"{value:.0f} B"
+    if unit == 'ns':
+        for scale, suffix in ((1e6, 'ms'), (1e3, 'us')):
+            if abs(value) >= scale:
+                return f"{value / scale:.2f} {suffix}"
+        return f"{value:.2f} ns"
+    if unit == 'ms':
+        return f"{value:.3f} ms"
+    return f"{value:g}"
+
+
+def compare_metric(base, new, threshold, alpha):
+    """The verdict on one metric: regressed, improved, unchanged or noise, and its numbers."""
+    base_value = median(base['samples']) if base['samples'] else base['value']
+    new_value = median(new['samples']) if new['samples'] else new['value']
+    if base_value != 0:
+        change = (new_value - base_value) / abs(base_value) * 100
+    else:
+        change = 0.0 if new_value == 0 else math.inf
+    worse = change > 0 if base.get('better', 'lower') == 'lower' else change < 0
+
+    testable = len(base['samples']) > 1 and len(new['samples']) > 1
+    p = mann_whitney_p(base['samples'], new['samples']) if testable else None
+
+    if abs(change) <= threshold:
+        verdict = 'unchanged'
+    elif p is not None and p >= alpha:
+        verdict = 'noise'
+    else:
+        verdict = 'regressed' if worse else 'improved'
+    return verdict, base_value, new_value, change, p
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare two runs of an rsbl benchmark and flag regressions")
+    parser.add_argument('base', help="Baseline report, or a directory of them")
+    parser.add_argument('new', help="Report to check, or a directory of them")
+    parser.add_argument('--threshold', type=float, default=5.0,
+                        help="Percent a median has to move by to count (default 5)")
+    parser.add_argument('--alpha', type=float, default=0.01,
+                        help="Significance level of the rank test (default 0.01)")
+    parser.add_argument('--filter', default='',
+                        help="Only compare metrics whose names contain this")
+    parser.add_argument('--all', action='store_true',
+                        help="List unchanged metrics and noise too, not just what moved")
+    args = parser.parse_args()
+
+    try:
+        base = load_side(args.base)
+        new = load_side(args.new)
+    except CompareError as e:
+        print(f"{Colors.RED}[ERROR] {e}{Colors.NC}")
+        return 2
+
+    if base['suite'] != new['suite']:
+        print(f"{Colors.RED}[ERROR] Comparing {base['suite']} with {new['suite']}{Colors.NC}")
+        return 2
+
+    print(f"{Colors.CYAN}{base['suite']} ({base['kind']}): {base['runs']} baseline run(s), "
+          f"{new['runs']} new run(s){Colors.NC}")
+    if base['machine'] != new['machine']:
+        print(f"{Colors.YELLOW}Runs are from different machines, expect differences that "
+              f"aren't the code's:{Colors.NC}")
+        print(f"{Colors.GRAY}  base {base['machine']}{Colors.NC}")
+        print(f"{Colors.GRAY}  new  {new['machine']}{Colors.NC}")
+    if base['smoke'] or new['smoke']:
+        print(f"{Colors.YELLOW}Smoke runs time one iteration, their numbers mean "
+              f"little{Colors.NC}")
+    print()
+
+    counts = {'regressed': 0, 'improved': 0, 'unchanged': 0, 'noise': 0}
+    colors = {'regressed': Colors.RED, 'improved': Colors.GREEN,
+              'unchanged': Colors.GRAY, 'noise': Colors.GRAY}
+    width = max([len(name) for name in base['metrics']] + [6])
+    print(f"{'Metric':<{width}}  {'Base':>12}  {'New':>12}  {'Change':>8}  {'p':>7}")
+    for name, base_metric in base['metrics'].items():
+        if args.filter not in name:
+            continue
+        new_metric = new['metrics'].get(name)
+        if new_metric is None:
+            print(f"{Colors.YELLOW}{name:<{width}}  missing from the new run{Colors.NC}")
+            continue
+
+        verdict, base_value, new_value, change, p = compare_metric(
+            base_metric, new_metric, args.threshold, args.alpha)
+        counts[verdict] += 1
+        if not args.all and verdict in ('unchanged', 'noise'):
+            continue
+        unit = base_metric.get('unit', '')
+        p_text = f"{p:.4f}" if p is not None else '-'
+        print(f"{colors[verdict]}{name:<{width}}  {format_value(base_value, unit):>12}  "
+              f"{format_value(new_value, unit):>12}  {change:>+7.1f}%  {p_text:>7}  "
+              f"{verdict.upper() if verdict == 'regressed' else verdict}{Colors.NC}")
+
+    for name in new['metrics']:
+        if args.filter in name and name not in base['metrics']:
+            print(f"{Colors.GRAY}{name:<{width}}  new, nothing to compare with{Colors.NC}")
+
+    print()
+    print(f"{counts['regressed']} regressed, {counts['improved']} improved, "
+          f"{counts['unchanged']} unchanged, {counts['noise']} within the noise "
+          f"(threshold {args.threshold:g}%, alpha {args.alpha:g})")
+    return 1 if counts['regressed'] else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())